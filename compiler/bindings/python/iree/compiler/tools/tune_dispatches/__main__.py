@@ -0,0 +1,407 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""Console tool for tuning the codegen configuration of each dispatch.
+
+Each dispatch of the input program is dumped as a standalone benchmark module
+with the configuration picked by the compiler heuristics. Candidate
+`lowering_config`/`translation_info` pairs from a search space file are then
+substituted into the benchmark, compiled and benchmarked on the target device,
+and the fastest configuration of each dispatch is written out as a transform
+dialect library that can be passed back to the compiler:
+
+  iree-tune-dispatches model.mlir --space=space.json -o tuned_spec.mlir \\
+      --compile-flag=--iree-hal-target-backends=cuda \\
+      --compile-flag=--iree-hal-cuda-llvm-target-arch=sm_80 \\
+      --benchmark-flag=--device=cuda
+  iree-compile model.mlir \\
+      --iree-codegen-transform-dialect-library=tuned_spec.mlir ...
+
+The search space is a JSON file listing, per root op name, templates of the
+two attributes and the values to substitute for their `$parameters`:
+
+  {
+    "spaces": [{
+      "op": "linalg.matmul",
+      "lowering_config":
+          "#iree_codegen.lowering_config<tile_sizes = [[$m, $n, $k]]>",
+      "translation_info":
+          "#iree_codegen.translation_info<LLVMGPUMatmulSimt ...>",
+      "parameters": {"m": [32, 64], "n": [64, 128], "k": [16, 32]}
+    }]
+  }
+
+Or from Python:
+
+  python -m iree.compiler.tools.tune_dispatches ...
+"""
+import argparse
+import itertools
+import json
+import logging
+import os
+from pathlib import Path
+import shutil
+import string
+import subprocess
+import sys
+from typing import Dict, Iterator, List, Optional, Sequence, Tuple
+
+from ..binaries import find_tool
+from ...ir import Attribute, Context, Module
+
+logger = logging.getLogger(__name__)
+
+_TIME_UNIT_SCALES_NS = {"ns": 1.0, "us": 1e3, "ms": 1e6, "s": 1e9}
+
+
+###############################################################################
+# Search spaces
+###############################################################################
+
+
+class Candidate:
+    """A configuration to try on a dispatch."""
+
+    def __init__(self, lowering_config: str, translation_info: str):
+        self.lowering_config = lowering_config
+        self.translation_info = translation_info
+
+    def compilation_info(self) -> str:
+        return (
+            f"#iree_codegen.compilation_info<"
+            f"lowering_config = {self.lowering_config}, "
+            f"translation_info = {self.translation_info}>"
+        )
+
+
+def expand_space(space: dict) -> Iterator[Candidate]:
+    """Yields a candidate for each combination of the space parameters."""
+    lowering_config = string.Template(space["lowering_config"])
+    translation_info = string.Template(space["translation_info"])
+    parameters = space.get("parameters", {})
+    names = list(parameters.keys())
+    for values in itertools.product(*(parameters[name] for name in names)):
+        mapping = dict(zip(names, (str(value) for value in values)))
+        yield Candidate(
+            lowering_config.substitute(mapping),
+            translation_info.substitute(mapping),
+        )
+
+
+def load_spaces(path: str) -> Dict[str, List[Candidate]]:
+    """Returns the candidates of the search space file keyed by op name."""
+    with open(path, "rt") as f:
+        contents = json.load(f)
+    candidates: Dict[str, List[Candidate]] = {}
+    for space in contents["spaces"]:
+        candidates.setdefault(space["op"], []).extend(expand_space(space))
+    return candidates
+
+
+###############################################################################
+# Benchmark modules
+###############################################################################
+
+
+def _walk(operation) -> Iterator:
+    yield operation
+    for region in operation.regions:
+        for block in region:
+            for op in block:
+                yield from _walk(op.operation)
+
+
+class Dispatch:
+    """A dumped benchmark module and the configured root op it contains."""
+
+    def __init__(self, path: Path, root_op_name: str, operand_types: List[str]):
+        self.path = path
+        self.root_op_name = root_op_name
+        self.operand_types = operand_types
+
+    @property
+    def name(self) -> str:
+        return self.path.stem
+
+
+def find_root_op(module, op_names: Sequence[str]):
+    """Returns the configured op of |module| with a name in |op_names|."""
+    for op in _walk(module.operation):
+        if op.name in op_names and "lowering_config" in op.attributes:
+            return op
+    return None
+
+
+def substitute_candidate(module, root_op, candidate: Candidate):
+    """Replaces the configuration of the dispatch in |module| in place."""
+    old_config = root_op.attributes["lowering_config"]
+    lowering_config = Attribute.parse(candidate.lowering_config)
+    translation_info = Attribute.parse(candidate.translation_info)
+    for op in _walk(module.operation):
+        attributes = op.attributes
+        # Ops fused with the root op share its configuration.
+        if "lowering_config" in attributes and (
+            attributes["lowering_config"] == old_config
+        ):
+            attributes["lowering_config"] = lowering_config
+        if "translation_info" in attributes:
+            attributes["translation_info"] = translation_info
+
+
+###############################################################################
+# Tool invocation
+###############################################################################
+
+
+def run_tool(command: List[str]) -> Optional[str]:
+    """Runs |command| and returns its stdout or None if it failed."""
+    logger.debug("Running: %s", " ".join(command))
+    process = subprocess.run(command, capture_output=True, text=True)
+    if process.returncode != 0:
+        logger.debug("Failed with:\n%s", process.stderr)
+        return None
+    return process.stdout
+
+
+def parse_benchmark_time_ns(output: str) -> Optional[float]:
+    """Returns the total time of the benchmarks in JSON |output|.
+
+    Each benchmark function in a module runs one of the dispatch sites of the
+    executable; the fastest repetition of each is used.
+    """
+    best_times: Dict[str, float] = {}
+    for benchmark in json.loads(output).get("benchmarks", []):
+        if benchmark.get("run_type") == "aggregate":
+            continue
+        if benchmark.get("error_occurred"):
+            continue
+        scale = _TIME_UNIT_SCALES_NS[benchmark.get("time_unit", "ns")]
+        time_ns = benchmark["real_time"] * scale
+        name = benchmark.get("run_name", benchmark["name"])
+        best_times[name] = min(time_ns, best_times.get(name, time_ns))
+    if not best_times:
+        return None
+    return sum(best_times.values())
+
+
+class Tuner:
+    def __init__(self, args):
+        self.args = args
+        self.work_dir = Path(args.work_dir)
+        self.compile_tool = args.compile_tool or find_tool("iree-compile")
+        self.benchmark_tool = args.benchmark_tool or shutil.which(
+            "iree-benchmark-module"
+        )
+        if not self.benchmark_tool:
+            raise ValueError(
+                "iree-benchmark-module was not found; pass --benchmark-tool"
+            )
+
+    def dump_benchmarks(self) -> List[Path]:
+        benchmarks_dir = self.work_dir / "benchmarks"
+        benchmarks_dir.mkdir(parents=True, exist_ok=True)
+        command = [
+            self.compile_tool,
+            self.args.input_file,
+            f"--iree-hal-dump-executable-benchmarks-to={benchmarks_dir}",
+            "--compile-to=executable-configurations",
+            "-o",
+            os.devnull,
+        ] + self.args.compile_flags
+        if run_tool(command) is None:
+            raise RuntimeError(f"Failed to compile {self.args.input_file}")
+        return sorted(benchmarks_dir.glob("*_benchmark.mlir"))
+
+    def benchmark(self, source_path: Path) -> Optional[float]:
+        """Compiles and benchmarks the module at |source_path|."""
+        vmfb_path = source_path.with_suffix(".vmfb")
+        command = [self.compile_tool, str(source_path), "-o", str(vmfb_path)]
+        command += self.args.benchmark_compile_flags
+        if run_tool(command) is None:
+            return None
+        command = [
+            self.benchmark_tool,
+            f"--module={vmfb_path}",
+            "--benchmark_format=json",
+            f"--benchmark_repetitions={self.args.repetitions}",
+        ] + self.args.benchmark_flags
+        output = run_tool(command)
+        return parse_benchmark_time_ns(output) if output is not None else None
+
+    def tune(
+        self, path: Path, candidates: Dict[str, List[Candidate]]
+    ) -> Optional[Tuple[Dispatch, Candidate]]:
+        """Returns the fastest candidate for the dispatch benchmarked in |path|
+        if it beats the configuration chosen by the compiler."""
+        with Context():
+            module = Module.parse(path.read_text())
+            root_op = find_root_op(module, list(candidates.keys()))
+            if root_op is None:
+                logger.info("%s: no tunable op", path.name)
+                return None
+            dispatch = Dispatch(
+                path, root_op.name, [str(v.type) for v in root_op.operands]
+            )
+            best_time = self.benchmark(path)
+            if best_time is None:
+                logger.warning("%s: default configuration failed", dispatch.name)
+                return None
+            logger.info("%s: default %.0f ns", dispatch.name, best_time)
+
+            candidates_dir = self.work_dir / dispatch.name
+            candidates_dir.mkdir(parents=True, exist_ok=True)
+            best_candidate = None
+            for index, candidate in enumerate(candidates[dispatch.root_op_name]):
+                candidate_module = Module.parse(path.read_text())
+                substitute_candidate(
+                    candidate_module,
+                    find_root_op(candidate_module, [dispatch.root_op_name]),
+                    candidate,
+                )
+                candidate_path = candidates_dir / f"candidate_{index}.mlir"
+                candidate_path.write_text(str(candidate_module))
+                time = self.benchmark(candidate_path)
+                if time is None:
+                    logger.debug("%s: candidate %d failed", dispatch.name, index)
+                    continue
+                logger.debug("%s: candidate %d %.0f ns", dispatch.name, index, time)
+                if time < best_time:
+                    best_time, best_candidate = time, candidate
+        if best_candidate is None:
+            return None
+        logger.info("%s: tuned %.0f ns", dispatch.name, best_time)
+        return dispatch, best_candidate
+
+
+###############################################################################
+# Transform library emission
+###############################################################################
+
+
+def emit_transform_library(winners: List[Tuple[Dispatch, Candidate]]) -> str:
+    """Returns a transform library annotating the root op of each dispatch with
+    its tuned configuration when run as the `__kernel_config` sequence."""
+    lines = ["module attributes { transform.with_named_sequence } {"]
+    actions = []
+    for index, (dispatch, candidate) in enumerate(winners):
+        match_name = f"match_{index}"
+        apply_name = f"apply_{index}"
+        actions.append(f"@{match_name} -> @{apply_name}")
+        lines += [
+            f"  // {dispatch.name}",
+            f"  transform.named_sequence @{match_name}(%op: !transform.any_op "
+            "{transform.readonly}) -> !transform.any_op {",
+            f'    transform.match.operation_name %op ["{dispatch.root_op_name}"] '
+            ": !transform.any_op",
+        ]
+        for operand_index, operand_type in enumerate(dispatch.operand_types):
+            lines += [
+                f"    %operand{operand_index} = transform.get_operand "
+                f"%op[{operand_index}] : (!transform.any_op) -> "
+                "!transform.any_value",
+                "    transform.iree.match.cast_compatible_type "
+                f"%operand{operand_index} = {operand_type} : "
+                "!transform.any_value",
+            ]
+        lines += [
+            "    transform.yield %op : !transform.any_op",
+            "  }",
+            f"  transform.named_sequence @{apply_name}(%op: !transform.any_op "
+            "{transform.readonly}) {",
+            f"    %config = transform.param.constant "
+            f"{candidate.compilation_info()} -> !transform.any_param",
+            '    transform.annotate %op "compilation_info" = %config : '
+            "!transform.any_op, !transform.any_param",
+            "    transform.yield",
+            "  }",
+        ]
+    lines.append(
+        "  transform.named_sequence @__kernel_config(%variant_op: "
+        "!transform.any_op {transform.consumed}) {"
+    )
+    if actions:
+        lines.append("    transform.foreach_match in %variant_op")
+        lines.append("        " + ",\n        ".join(actions))
+        lines.append("      : (!transform.any_op) -> (!transform.any_op)")
+    lines += ["    transform.yield", "  }", "}"]
+    return "\n".join(lines) + "\n"
+
+
+###############################################################################
+# CLI handling
+###############################################################################
+
+
+def parse_arguments(argv=None):
+    parser = argparse.ArgumentParser(description="IREE dispatch tuner")
+    parser.add_argument("input_file", help="Program to tune")
+    parser.add_argument(
+        "-o", required=True, dest="output_file", help="Output transform library"
+    )
+    parser.add_argument(
+        "--space", required=True, help="JSON file with the search space"
+    )
+    parser.add_argument(
+        "--work-dir",
+        default="iree-tune-dispatches",
+        help="Directory for the benchmark modules of the candidates",
+    )
+    parser.add_argument(
+        "--compile-flag",
+        action="append",
+        default=[],
+        dest="compile_flags",
+        help="Flag used to compile the input program (repeatable)",
+    )
+    parser.add_argument(
+        "--benchmark-compile-flag",
+        action="append",
+        default=[],
+        dest="benchmark_compile_flags",
+        help="Flag used to compile the benchmark modules (repeatable)",
+    )
+    parser.add_argument(
+        "--benchmark-flag",
+        action="append",
+        default=[],
+        dest="benchmark_flags",
+        help="Flag passed to iree-benchmark-module, e.g. --device (repeatable)",
+    )
+    parser.add_argument(
+        "--repetitions",
+        type=int,
+        default=3,
+        help="Number of times each benchmark is repeated",
+    )
+    parser.add_argument("--compile-tool", help="Path to iree-compile")
+    parser.add_argument("--benchmark-tool", help="Path to iree-benchmark-module")
+    parser.add_argument("-v", "--verbose", action="store_true")
+    args = parser.parse_args(argv)
+    return args
+
+
+def main(args) -> int:
+    logging.basicConfig(level=logging.DEBUG if args.verbose else logging.INFO)
+    candidates = load_spaces(args.space)
+    tuner = Tuner(args)
+    winners = []
+    for path in tuner.dump_benchmarks():
+        winner = tuner.tune(path, candidates)
+        if winner:
+            winners.append(winner)
+    with open(args.output_file, "wt") as f:
+        f.write(emit_transform_library(winners))
+    logger.info("Tuned %d dispatches", len(winners))
+    return 0
+
+
+def _cli_main():
+    sys.exit(main(parse_arguments()))
+
+
+if __name__ == "__main__":
+    _cli_main()
@@ -0,0 +1,92 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from iree.compiler import ir
+from iree.compiler.tools.tune_dispatches import __main__
+
+import json
+from pathlib import Path
+import unittest
+
+MATMUL_SPACE = {
+    "op": "linalg.matmul",
+    "lowering_config": "#iree_codegen.lowering_config<tile_sizes = [[$m, $n, 4]]>",
+    "translation_info": "#iree_codegen.translation_info<LLVMGPUMatmulSimt workgroup_size = [$m, 1, 1]>",
+    "parameters": {"m": [16, 32], "n": [64, 128]},
+}
+
+CONFIGURED_MATMUL = r"""
+#config = #iree_codegen.lowering_config<tile_sizes = [[8, 8, 4]]>
+#translation = #iree_codegen.translation_info<LLVMGPUMatmulSimt workgroup_size = [8, 1, 1]>
+func.func @matmul(%lhs: tensor<64x32xf32>, %rhs: tensor<32x128xf32>) -> tensor<64x128xf32>
+    attributes {translation_info = #translation} {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<64x128xf32>
+  %fill = linalg.fill {lowering_config = #config} ins(%cst : f32) outs(%empty : tensor<64x128xf32>) -> tensor<64x128xf32>
+  %0 = linalg.matmul {lowering_config = #config} ins(%lhs, %rhs : tensor<64x32xf32>, tensor<32x128xf32>) outs(%fill : tensor<64x128xf32>) -> tensor<64x128xf32>
+  return %0 : tensor<64x128xf32>
+}
+"""
+
+
+class TuneDispatchesTest(unittest.TestCase):
+    def testExpandSpace(self):
+        candidates = list(__main__.expand_space(MATMUL_SPACE))
+        self.assertEqual(len(candidates), 4)
+        self.assertIn("[[32, 128, 4]]", candidates[3].lowering_config)
+        self.assertIn("workgroup_size = [32, 1, 1]", candidates[3].translation_info)
+
+    def testSubstituteCandidate(self):
+        candidate = list(__main__.expand_space(MATMUL_SPACE))[0]
+        with ir.Context():
+            module = ir.Module.parse(CONFIGURED_MATMUL)
+            root_op = __main__.find_root_op(module, ["linalg.matmul"])
+            self.assertEqual(root_op.name, "linalg.matmul")
+            __main__.substitute_candidate(module, root_op, candidate)
+            asm = str(module)
+        # The fill shares the config of the matmul and is updated with it.
+        self.assertNotIn("[[8, 8, 4]]", asm)
+        self.assertIn("[[16, 64, 4]]", asm)
+        self.assertIn("workgroup_size = [16, 1, 1]", asm)
+
+    def testParseBenchmarkTime(self):
+        def result(name, run_type, real_time, time_unit):
+            return {
+                "name": name,
+                "run_type": run_type,
+                "real_time": real_time,
+                "time_unit": time_unit,
+            }
+
+        output = json.dumps(
+            {
+                "benchmarks": [
+                    result("a", "iteration", 3.0, "us"),
+                    result("a", "iteration", 2.0, "us"),
+                    result("a_mean", "aggregate", 2.5, "us"),
+                    result("b", "iteration", 500.0, "ns"),
+                ]
+            }
+        )
+        self.assertEqual(__main__.parse_benchmark_time_ns(output), 2500.0)
+        self.assertIsNone(__main__.parse_benchmark_time_ns('{"benchmarks": []}'))
+
+    def testEmitTransformLibrary(self):
+        candidate = list(__main__.expand_space(MATMUL_SPACE))[0]
+        dispatch = __main__.Dispatch(
+            Path("module_matmul_dispatch_0_benchmark.mlir"),
+            "linalg.matmul",
+            ["tensor<64x32xf32>", "tensor<32x128xf32>", "tensor<64x128xf32>"],
+        )
+        library = __main__.emit_transform_library([(dispatch, candidate)])
+        self.assertIn("@match_0 -> @apply_0", library)
+        self.assertIn('transform.match.operation_name %op ["linalg.matmul"]', library)
+        self.assertIn("%operand1 = tensor<32x128xf32>", library)
+        self.assertIn("#iree_codegen.compilation_info<", library)
+
+
+if __name__ == "__main__":
+    unittest.main()
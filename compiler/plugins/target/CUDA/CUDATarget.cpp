@@ -16,6 +16,7 @@
 #include "iree/compiler/Utils/ToolUtils.h"
 #include "iree/schemas/cuda_executable_def_builder.h"
 #include "iree_cuda/libdevice_embedded.h"
+#include "llvm/ADT/StringSwitch.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/Bitcode/BitcodeWriter.h"
@@ -58,6 +59,8 @@ struct CUDAOptions {
   bool clUsePtxas = false;
   std::string clUsePtxasFrom;
   std::string clUsePtxasParams;
+  int clSharedMemoryCarveout = -1;
+  int clMultiprocessorCount = 0;
 
   void bindOptions(OptionsBinder &binder) {
     static llvm::cl::OptionCategory category("CUDA HAL Target");
@@ -100,12 +103,59 @@ struct CUDAOptions {
         "iree-hal-cuda-use-ptxas-params", clUsePtxasParams,
         llvm::cl::cat(category),
         llvm::cl::desc("Passes the given additional parameters to ptxas."));
+
+    binder.opt<int>(
+        "iree-hal-cuda-shared-memory-carveout", clSharedMemoryCarveout,
+        llvm::cl::cat(category),
+        llvm::cl::desc(
+            "Preferred shared memory carveout (0-100, as a percentage of the "
+            "maximum shared memory per multiprocessor) for kernels using "
+            "workgroup local memory. -1 prefers the maximum carveout only for "
+            "kernels needing more than the default 48KB of shared memory."));
+
+    binder.opt<int>(
+        "iree-hal-cuda-multiprocessor-count", clMultiprocessorCount,
+        llvm::cl::cat(category),
+        llvm::cl::desc(
+            "Number of streaming multiprocessors of the target device used by "
+            "heuristics; 0 uses the count of the largest known part for the "
+            "target arch."));
   }
 };
 } // namespace
 
 static constexpr char kPtxasCompilerName[] = "ptxas";
 
+// Shared memory available to a block without opting in to a larger carveout.
+static constexpr uint32_t kDefaultSharedMemoryBytes = 48 * 1024;
+
+/// Returns the preferred shared memory carveout for a kernel using
+/// |workgroupLocalMemory| bytes of shared memory or -1 for no preference.
+static int32_t getSharedMemoryCarveout(const CUDAOptions &options,
+                                       uint32_t workgroupLocalMemory) {
+  if (workgroupLocalMemory == 0)
+    return -1;
+  if (options.clSharedMemoryCarveout >= 0)
+    return std::min(options.clSharedMemoryCarveout, 100);
+  // Kernels exceeding the default limit are typically occupancy bound on
+  // shared memory; trading L1 for shared memory lets more blocks reside on
+  // each multiprocessor.
+  return workgroupLocalMemory > kDefaultSharedMemoryBytes ? 100 : -1;
+}
+
+/// Returns the number of streaming multiprocessors of the target device or 0
+/// if unknown.
+static int64_t getMultiprocessorCount(const CUDAOptions &options) {
+  if (options.clMultiprocessorCount > 0)
+    return options.clMultiprocessorCount;
+  return llvm::StringSwitch<int64_t>(options.clTargetChip)
+      .Case("sm_70", 80)  // V100
+      .Case("sm_80", 108) // A100
+      .Case("sm_89", 128) // RTX 4090
+      .Case("sm_90", 132) // H100 SXM
+      .Default(0);
+}
+
 /// Attempts to find ptxas compiler
 static FailureOr<std::string> findPtxasCompiler(const CUDAOptions &options,
                                                 std::string *message) {
@@ -411,6 +461,8 @@ public:
     };
 
     addConfig("target_arch", b.getStringAttr(options.clTargetChip));
+    if (int64_t multiprocessorCount = getMultiprocessorCount(options))
+      addConfig("compute_unit_count", b.getI64IntegerAttr(multiprocessorCount));
 
     return b.getAttr<IREE::HAL::ExecutableTargetAttr>(
         b.getStringAttr("cuda"), b.getStringAttr("cuda-nvptx-fb"),
@@ -459,6 +511,7 @@ public:
     // Collect all the entry point parameters.
     SmallVector<std::array<int32_t, 3>> workgroupSizes;
     SmallVector<uint32_t> workgroupLocalMemories;
+    SmallVector<int32_t> sharedMemoryCarveouts;
     for (auto exportOp : variantOp.getExportOps()) {
       std::array<int32_t, 3> workgroupSize;
       if (std::optional<ArrayAttr> workgroupSizeAttr =
@@ -476,6 +529,8 @@ public:
         workgroupLocalMemory = workgroupLocalMemoryAttr->getSExtValue();
       }
       workgroupLocalMemories.push_back(workgroupLocalMemory);
+      sharedMemoryCarveouts.push_back(
+          getSharedMemoryCarveout(options, workgroupLocalMemory));
     }
 
     FlatbufferBuilder builder;
@@ -639,12 +694,16 @@ public:
     auto blockSizesRef = iree_hal_cuda_BlockSizeDef_vec_end(builder);
     auto workgroupLocalMemoriesRef =
         builder.createInt32Vec(workgroupLocalMemories);
+    auto sharedMemoryCarveoutsRef =
+        builder.createInt32Vec(sharedMemoryCarveouts);
     auto entryPointsRef = builder.createStringVec(entryPointNames);
 
     iree_hal_cuda_ExecutableDef_entry_points_add(builder, entryPointsRef);
     iree_hal_cuda_ExecutableDef_block_sizes_add(builder, blockSizesRef);
     iree_hal_cuda_ExecutableDef_shared_memory_size_add(
         builder, workgroupLocalMemoriesRef);
+    iree_hal_cuda_ExecutableDef_shared_memory_carveout_add(
+        builder, sharedMemoryCarveoutsRef);
     iree_hal_cuda_ExecutableDef_ptx_image_add(builder, gpuImageRef);
     if (!sourceLocationRefs.empty()) {
       auto sourceLocationsRef =
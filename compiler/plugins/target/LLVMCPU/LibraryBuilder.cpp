@@ -513,7 +513,7 @@ LibraryBuilder::buildLibraryV0ExportTable(std::string libraryName) {
                   i16Type, roundUpToAlignment(dispatch.attrs.localMemorySize,
                                               kWorkgroupLocalMemoryPageSize) /
                                kWorkgroupLocalMemoryPageSize),
-              // reserved=
+              // flags=
               llvm::ConstantInt::get(i16Type, 0),
           }));
     }
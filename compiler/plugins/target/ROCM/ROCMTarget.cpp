@@ -54,7 +54,9 @@ namespace {
 struct ROCmOptions {
   std::string targetChip = "gfx908";
   std::string bitcodeDirectory = getDefaultBitcodeDirectory();
+  std::string ukernelBitcodeDirectory;
   int wavesPerEu = 0;
+  int computeUnitCount = 0;
   std::string enableROCMUkernels = "none";
 
   void bindOptions(OptionsBinder &binder) {
@@ -65,9 +67,19 @@ struct ROCmOptions {
     binder.opt<std::string>("iree-rocm-bc-dir", bitcodeDirectory,
                             cl::cat(category),
                             cl::desc("Directory of ROCm Bitcode."));
+    binder.opt<std::string>(
+        "iree-rocm-ukernel-bc-dir", ukernelBitcodeDirectory, cl::cat(category),
+        cl::desc("Directory of ROCm ukernel bitcode overriding the ukernels "
+                 "shipped in --iree-rocm-bc-dir. Allows updated ukernels to "
+                 "be picked up without rebuilding the compiler."));
     binder.opt<int>("iree-rocm-waves-per-eu", wavesPerEu, cl::cat(category),
                     cl::desc("Optimization hint specifying minimum "
                              "number of waves per execution unit."));
+    binder.opt<int>("iree-rocm-target-compute-units", computeUnitCount,
+                    cl::cat(category),
+                    cl::desc("Number of compute units of the target device "
+                             "used by heuristics; 0 uses the count of the "
+                             "largest known part for the target chip."));
     binder.opt<std::string>(
         "iree-rocm-enable-ukernels", enableROCMUkernels, cl::cat(category),
         cl::desc("Enables microkernels in the rocm compiler backend. May be "
@@ -192,6 +204,12 @@ public:
     if (mmaAttrs)
       addConfig("mma_intrinsics", mmaAttrs);
 
+    int64_t computeUnitCount = options.computeUnitCount;
+    if (computeUnitCount <= 0)
+      computeUnitCount = getROCMComputeUnitCount(options.targetChip);
+    if (computeUnitCount > 0)
+      addConfig("compute_unit_count", b.getI64IntegerAttr(computeUnitCount));
+
     return b.getAttr<IREE::HAL::ExecutableTargetAttr>(
         b.getStringAttr("rocm"), b.getStringAttr("rocm-hsaco-fb"),
         b.getDictionaryAttr(configItems));
@@ -436,14 +454,18 @@ public:
 
       // Link module to any enabled ukernels.
       StringRef bitcodeDirectory = options.bitcodeDirectory;
+      StringRef ukernelBitcodeDirectory =
+          options.ukernelBitcodeDirectory.empty()
+              ? bitcodeDirectory
+              : StringRef(options.ukernelBitcodeDirectory);
       StringRef enabledUkernels;
       if (auto attr = getConfigStringAttr(targetAttr, "ukernels"))
         enabledUkernels = attr->getValue();
       if (!enabledUkernels.empty() && enabledUkernels != "none") {
         if (failed(linkUkernelBitcodeFiles(
                 variantOp.getLoc(), llvmModule.get(), enabledUkernels,
-                targetArch, bitcodeDirectory, llvm::Linker::OverrideFromSrc,
-                *targetMachine))) {
+                targetArch, ukernelBitcodeDirectory,
+                llvm::Linker::OverrideFromSrc, *targetMachine))) {
           return failure();
         }
       }
@@ -36,4 +36,14 @@ ArrayAttr getROCMSupportedMmaAttrs(MLIRContext *context, StringRef targetArch) {
   return ArrayAttr();
 }
 
+int64_t getROCMComputeUnitCount(StringRef targetArch) {
+  return llvm::StringSwitch<int64_t>(targetArch)
+      .Case("gfx942", 304) // MI300X
+      .Case("gfx940", 228) // MI300A
+      .Case("gfx90a", 104) // MI210
+      .Case("gfx908", 120) // MI100
+      .Case("gfx1100", 96) // RX 7900 XTX
+      .Default(0);
+}
+
 } // namespace mlir::iree_compiler::IREE::HAL
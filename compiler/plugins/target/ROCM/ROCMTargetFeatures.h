@@ -16,6 +16,10 @@ namespace mlir::iree_compiler::IREE::HAL {
 // Returns the list of supported mma types (mfma/wmma).
 ArrayAttr getROCMSupportedMmaAttrs(MLIRContext *context, StringRef targetArch);
 
+// Returns the number of compute units of the largest known part with the
+// given target architecture or 0 if unknown.
+int64_t getROCMComputeUnitCount(StringRef targetArch);
+
 } // namespace mlir::iree_compiler::IREE::HAL
 
 #endif // IREE_COMPILER_PLUGINS_TARGET_ROCM_ROCMTARGETFEATURES_H_
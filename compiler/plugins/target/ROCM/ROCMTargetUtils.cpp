@@ -125,7 +125,7 @@ static std::vector<std::string> getUkernelPaths(StringRef enabledUkernelsStr,
                                                 StringRef bitcodePath) {
   std::vector<std::string> selectedUkernelNames;
   if (enabledUkernelsStr == "all") {
-    const char *allUkernelNames[] = {"argmax"};
+    const char *allUkernelNames[] = {"argmax", "matmul"};
     size_t numUkernels = sizeof(allUkernelNames) / sizeof(allUkernelNames[0]);
     for (int i = 0; i < numUkernels; i++) {
       selectedUkernelNames.push_back(allUkernelNames[i]);
@@ -0,0 +1,121 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <hip/hip_runtime.h>
+
+typedef _Float16 half4_t __attribute__((ext_vector_type(4)));
+typedef short short4_t __attribute__((ext_vector_type(4)));
+typedef float float4_t __attribute__((ext_vector_type(4)));
+
+/*
+Constraint/Tiling note:
+Each workgroup computes one MxN tile of the output with the full K dimension
+using a single wave of 64 lanes. On CDNA chips the tile is walked in 16x16
+blocks with the 16x16x16 MFMA instructions and M, N, and K must all be
+multiples of 16; the tile sizes and shape constraints are set during tiling in
+KernelConfig. Other chips fall back to a scalar loop that handles any shape.
+
+The MFMA operand layout is (with lane = 16 * group + index):
+  lhs: lane holds lhs[index][4 * group + 0..3]
+  rhs: lane holds rhs[4 * group + 0..3][index]
+  out: lane holds out[4 * group + 0..3][index]
+The ukernel accumulates into the existing contents of the output tile.
+*/
+
+#if defined(__gfx90a__) || defined(__gfx940__)
+#define IREE_UK_ROCM_HAS_MFMA 1
+#endif
+
+static __device__ float bf16_to_f32(uint16_t value) {
+  return __uint_as_float((uint32_t)value << 16);
+}
+
+extern "C" __device__ void __iree_uk_rocm_matmul_F16F16F32(
+    const _Float16 *lhs, size_t lhs_offset, size_t lhs_stride,
+    const _Float16 *rhs, size_t rhs_offset, size_t rhs_stride, float *out,
+    size_t out_offset, size_t out_stride, size_t M, size_t N, size_t K) {
+  lhs += lhs_offset;
+  rhs += rhs_offset;
+  out += out_offset;
+#if defined(IREE_UK_ROCM_HAS_MFMA)
+  uint laneID = __builtin_amdgcn_workitem_id_x();
+  uint index = laneID % 16;
+  uint group = laneID / 16;
+  for (size_t m = 0; m < M; m += 16) {
+    for (size_t n = 0; n < N; n += 16) {
+      float4_t acc;
+      for (int i = 0; i < 4; ++i) {
+        acc[i] = out[(m + 4 * group + i) * out_stride + n + index];
+      }
+      for (size_t k = 0; k < K; k += 16) {
+        half4_t a, b;
+        for (int i = 0; i < 4; ++i) {
+          a[i] = lhs[(m + index) * lhs_stride + k + 4 * group + i];
+          b[i] = rhs[(k + 4 * group + i) * rhs_stride + n + index];
+        }
+        acc = __builtin_amdgcn_mfma_f32_16x16x16f16(a, b, acc, 0, 0, 0);
+      }
+      for (int i = 0; i < 4; ++i) {
+        out[(m + 4 * group + i) * out_stride + n + index] = acc[i];
+      }
+    }
+  }
+#else
+  for (size_t idx = threadIdx.x; idx < M * N; idx += blockDim.x) {
+    size_t m = idx / N;
+    size_t n = idx % N;
+    float acc = out[m * out_stride + n];
+    for (size_t k = 0; k < K; ++k) {
+      acc += (float)lhs[m * lhs_stride + k] * (float)rhs[k * rhs_stride + n];
+    }
+    out[m * out_stride + n] = acc;
+  }
+#endif  // IREE_UK_ROCM_HAS_MFMA
+}
+
+extern "C" __device__ void __iree_uk_rocm_matmul_BF16BF16F32(
+    const uint16_t *lhs, size_t lhs_offset, size_t lhs_stride,
+    const uint16_t *rhs, size_t rhs_offset, size_t rhs_stride, float *out,
+    size_t out_offset, size_t out_stride, size_t M, size_t N, size_t K) {
+  lhs += lhs_offset;
+  rhs += rhs_offset;
+  out += out_offset;
+#if defined(IREE_UK_ROCM_HAS_MFMA)
+  uint laneID = __builtin_amdgcn_workitem_id_x();
+  uint index = laneID % 16;
+  uint group = laneID / 16;
+  for (size_t m = 0; m < M; m += 16) {
+    for (size_t n = 0; n < N; n += 16) {
+      float4_t acc;
+      for (int i = 0; i < 4; ++i) {
+        acc[i] = out[(m + 4 * group + i) * out_stride + n + index];
+      }
+      for (size_t k = 0; k < K; k += 16) {
+        short4_t a, b;
+        for (int i = 0; i < 4; ++i) {
+          a[i] = lhs[(m + index) * lhs_stride + k + 4 * group + i];
+          b[i] = rhs[(k + 4 * group + i) * rhs_stride + n + index];
+        }
+        acc = __builtin_amdgcn_mfma_f32_16x16x16bf16_1k(a, b, acc, 0, 0, 0);
+      }
+      for (int i = 0; i < 4; ++i) {
+        out[(m + 4 * group + i) * out_stride + n + index] = acc[i];
+      }
+    }
+  }
+#else
+  for (size_t idx = threadIdx.x; idx < M * N; idx += blockDim.x) {
+    size_t m = idx / N;
+    size_t n = idx % N;
+    float acc = out[m * out_stride + n];
+    for (size_t k = 0; k < K; ++k) {
+      acc += bf16_to_f32(lhs[m * lhs_stride + k]) *
+             bf16_to_f32(rhs[k * rhs_stride + n]);
+    }
+    out[m * out_stride + n] = acc;
+  }
+#endif  // IREE_UK_ROCM_HAS_MFMA
+}
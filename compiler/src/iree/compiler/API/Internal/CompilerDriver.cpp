@@ -50,6 +50,7 @@
 #include "iree/compiler/Tools/init_passes.h"
 #include "iree/compiler/Tools/version.h"
 #include "iree/compiler/Utils/ModuleUtils.h"
+#include "iree/compiler/Utils/ProfilingUtils.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "iree/compiler/embedding_api.h"
 #include "iree/compiler/mlir_interop.h"
@@ -274,6 +275,7 @@ void GlobalInit::registerCommandLineOptions() {
   // Register pass manager command-line options like -mlir-print-ir-*.
   mlir::registerPassManagerCLOptions();
   mlir::registerDefaultTimingManagerCLOptions();
+  registerPassProfilingCLOptions();
 
   // Bind session options to the command line environment.
   clPluginManagerOptions = &PluginManagerOptions::FromFlags::get();
@@ -664,6 +666,17 @@ void Output::keep() {
     outputFile->keep();
 }
 
+// Returns the name of |phase| as accepted by --compile-to.
+static std::string getPhaseName(IREEVMPipelinePhase phase) {
+  std::string phaseName;
+  enumerateIREEVMPipelinePhases(
+      [&](IREEVMPipelinePhase enumeratedPhase, StringRef name, StringRef desc) {
+        if (enumeratedPhase == phase)
+          phaseName = name;
+      });
+  return phaseName;
+}
+
 // Invocation corresponds to iree_compiler_invocation_t
 struct Invocation {
   using PassManagerInitializer = std::function<void(PassManager &pm)>;
@@ -724,10 +737,21 @@ Invocation::Invocation(Session &session) : session(session) {
         pm.addPass(ConstEval::createJitGlobalsPass({&targetRegistry}));
       };
 
+  // Mark compilation phases in the compile profile if one was requested.
+  pipelineHooks.beforePhase = [](IREEVMPipelinePhase phase,
+                                 OpPassManager &passManager) {
+    if (isPassProfilingEnabled()) {
+      addPassProfilingPhaseBegin(passManager, getPhaseName(phase));
+    }
+  };
+
   // Dump compilation phase results if the option is set.
   pipelineHooks.afterPhase = [this](IREEVMPipelinePhase phase,
                                     OpPassManager &passManager) {
     dumpCompilationPhase(phase, passManager);
+    if (isPassProfilingEnabled()) {
+      addPassProfilingPhaseEnd(passManager, getPhaseName(phase));
+    }
   };
 
   // The PluginSession implements PipelineExtensions and delegates it to
@@ -749,6 +773,7 @@ std::unique_ptr<PassManager> Invocation::createPassManager() {
           << "Failed to apply pass manager CL options";
     }
     mlir::applyDefaultTimingPassManagerCLOptions(*passManager);
+    applyPassProfilingCLOptions(*passManager);
   }
   passManager->addInstrumentation(std::make_unique<PassTracing>());
   passManager->enableVerifier(enableVerifier);
@@ -906,13 +931,7 @@ void Invocation::dumpCompilationPhase(IREEVMPipelinePhase phase,
   if (!parsedModule || dumpCompilationPhasesTo.empty())
     return;
 
-  std::string phaseName;
-  enumerateIREEVMPipelinePhases(
-      [&](IREEVMPipelinePhase enumeratedPhase, StringRef name, StringRef desc) {
-        if (enumeratedPhase == phase)
-          phaseName = name;
-      });
-
+  std::string phaseName = getPhaseName(phase);
   std::string fileName =
       guessModuleName(cast<ModuleOp>(parsedModule), "module") + "." +
       std::to_string(static_cast<int>(phase)) + "." + phaseName + ".mlir";
@@ -13,6 +13,7 @@
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/UKernelOps.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
 #include "iree/compiler/Dialect/Encoding/IR/EncodingOps.h"
+#include "iree/compiler/Dialect/LinalgExt/IR/LinalgExtOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
@@ -518,6 +519,232 @@ static uint32_t getFlagForRole(IREE::Encoding::EncodingRole role) {
   }
 }
 
+/// Matches an iree_linalg_ext.attention op on 3-D operands sharing one element
+/// type and converts it into a call to the `attention` microkernel, which
+/// computes the softmax online instead of going through the matmul + softmax +
+/// matmul decomposition.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchDAGForUKernel(RewriterBase &rewriter, IREE::LinalgExt::AttentionOp op,
+                   bool /*skipIntermediateRoundings*/) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "attention";
+  if (!hasUkernel(targetAttr, ukernelName)) {
+    return failure();
+  }
+  if (op.getNumResults() != 1) {
+    return rewriter.notifyMatchFailure(
+        op, "the max and sum results are not produced by the ukernel");
+  }
+  Value query = op.getQuery();
+  Value key = op.getKey();
+  Value value = op.getValue();
+  Value out = op.getOutput();
+  auto outType = llvm::cast<ShapedType>(out.getType());
+  Type elemType = op.getQueryType().getElementType();
+  for (Value operand : {query, key, value, out}) {
+    auto operandType = llvm::cast<ShapedType>(operand.getType());
+    if (operandType.getRank() != 3 ||
+        operandType.getElementType() != elemType) {
+      return rewriter.notifyMatchFailure(
+          op, "expected 3-D operands with the same element type");
+    }
+  }
+  uint32_t flags = 0;
+  if (elemType.isF32()) {
+    flags = IREE_UK_FLAG_ATTENTION_TYPE_F32;
+  } else if (elemType.isF16()) {
+    flags = IREE_UK_FLAG_ATTENTION_TYPE_F16;
+  } else if (elemType.isBF16()) {
+    flags = IREE_UK_FLAG_ATTENTION_TYPE_BF16;
+  } else {
+    return rewriter.notifyMatchFailure(op, "unsupported element type");
+  }
+  if (op.getTransposeV()) {
+    flags |= IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  }
+
+  Location loc = op.getLoc();
+  Value batch = rewriter.create<tensor::DimOp>(loc, query, 0);
+  Value m = rewriter.create<tensor::DimOp>(loc, query, 1);
+  Value k1 = rewriter.create<tensor::DimOp>(loc, query, 2);
+  Value k2 = rewriter.create<tensor::DimOp>(loc, key, 1);
+  Value n = rewriter.create<tensor::DimOp>(loc, out, 2);
+  // The ukernel takes the scale as a f32 regardless of the element type.
+  Value scale = op.getScale();
+  Type f32Type = rewriter.getF32Type();
+  if (scale.getType().getIntOrFloatBitWidth() < 32) {
+    scale = rewriter.create<arith::ExtFOp>(loc, f32Type, scale);
+  } else if (scale.getType().getIntOrFloatBitWidth() > 32) {
+    scale = rewriter.create<arith::TruncFOp>(loc, f32Type, scale);
+  }
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  SmallVector<Type> returnTypes{outType};
+  if (!isVMVXBackend(targetAttr)) {
+    // Hack to avoid issues with void-returning functions in llvm-cpu.
+    // Note that the first return value, of tensor type, disappears in
+    // bufferization.
+    returnTypes.push_back(rewriter.getI32Type());
+  }
+  // The inner dimension of each operand must be contiguous; the batch and row
+  // strides are passed, so that e.g. K and V can be slices of a KV cache.
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, returnTypes, fn.name, ValueRange{query, key, value}, out,
+      ValueRange{batch, m, k1, k2, n, scale, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(2));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
+/// Matches a linalg.softmax along the innermost dimension and converts it into
+/// a call to the `softmax` microkernel, which works on a 2-D tensor of rows.
+/// The outer dimensions before the rows dimension must be unit, as they are
+/// once tiled by the CPULinalgExtTileAndVectorize pipeline, and are collapsed
+/// around the microkernel. Returns the value replacing the softmax result.
+static FailureOr<Value> lowerSoftmaxToUKernel(RewriterBase &rewriter,
+                                              linalg::SoftmaxOp op) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "softmax";
+  if (!hasUkernel(targetAttr, ukernelName)) {
+    return failure();
+  }
+  if (!op.hasPureTensorSemantics()) {
+    return rewriter.notifyMatchFailure(op, "expected tensor semantics");
+  }
+  ShapedType inputType = op.getInputOperandType();
+  ShapedType outType = op.getOutputOperandType();
+  int64_t rank = inputType.getRank();
+  if (rank < 2 || static_cast<int64_t>(op.getDimension()) != rank - 1) {
+    return rewriter.notifyMatchFailure(
+        op, "expected a softmax along the innermost dimension");
+  }
+  if (llvm::any_of(inputType.getShape().drop_back(2),
+                   [](int64_t size) { return size != 1; })) {
+    return rewriter.notifyMatchFailure(op, "expected unit outer dimensions");
+  }
+  Type elemType = inputType.getElementType();
+  if (outType.getElementType() != elemType) {
+    return rewriter.notifyMatchFailure(op, "mismatched element types");
+  }
+  uint32_t flags = 0;
+  if (elemType.isF32()) {
+    flags = IREE_UK_FLAG_SOFTMAX_TYPE_F32;
+  } else if (elemType.isF16()) {
+    flags = IREE_UK_FLAG_SOFTMAX_TYPE_F16;
+  } else if (elemType.isBF16()) {
+    flags = IREE_UK_FLAG_SOFTMAX_TYPE_BF16;
+  } else {
+    return rewriter.notifyMatchFailure(op, "unsupported element type");
+  }
+
+  Location loc = op.getLoc();
+  Value input = op.getInput();
+  Value out = op.getOutput();
+  SmallVector<ReassociationIndices> reassociation;
+  if (rank > 2) {
+    reassociation.push_back(llvm::to_vector(llvm::seq<int64_t>(0, rank - 1)));
+    reassociation.push_back({rank - 1});
+    input = rewriter.create<tensor::CollapseShapeOp>(loc, input, reassociation);
+    out = rewriter.create<tensor::CollapseShapeOp>(loc, out, reassociation);
+  }
+  Value rows = rewriter.create<tensor::DimOp>(loc, input, 0);
+  Value cols = rewriter.create<tensor::DimOp>(loc, input, 1);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  SmallVector<Type> returnTypes{out.getType()};
+  if (!isVMVXBackend(targetAttr)) {
+    // Hack to avoid issues with void-returning functions in llvm-cpu.
+    // Note that the first return value, of tensor type, disappears in
+    // bufferization.
+    returnTypes.push_back(rewriter.getI32Type());
+  }
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, returnTypes, fn.name, ValueRange{input}, out,
+      ValueRange{rows, cols, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  Value result = genericMicroKernelOp.getResult(0);
+  if (rank > 2) {
+    result = rewriter.create<tensor::ExpandShapeOp>(loc, outType, result,
+                                                    reassociation);
+  }
+  return result;
+}
+
+/// Matches a linalg.generic computing the argmax of each row of a 2-D tensor,
+/// starting from -inf and index 0 as checked by isArgmaxOp, and converts it
+/// into a call to the `argmax` microkernel. Only the index result is produced
+/// by the microkernel; returns the value replacing it.
+static FailureOr<Value> lowerArgmaxToUKernel(RewriterBase &rewriter,
+                                             linalg::GenericOp op) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "argmax";
+  if (!hasUkernel(targetAttr, ukernelName) || failed(isArgmaxOp(op)) ||
+      !op.hasPureTensorSemantics()) {
+    return failure();
+  }
+  OpOperand *indexOperand = op.getDpsInitOperand(1);
+  Value input = op.getDpsInputOperand(0)->get();
+  Value index = indexOperand->get();
+  auto inputType = llvm::cast<ShapedType>(input.getType());
+  auto indexType = llvm::cast<ShapedType>(index.getType());
+  // isArgmaxOp checks for an identity input map and a single reduction loop,
+  // which has to be the innermost one for the rows to be contiguous.
+  AffineMap indexMap = op.getMatchingIndexingMap(indexOperand);
+  if (inputType.getRank() != 2 ||
+      !linalg::isReductionIterator(op.getIteratorTypesArray()[1]) ||
+      indexMap.getNumResults() != 1 || !indexMap.isProjectedPermutation() ||
+      indexMap.getDimPosition(0) != 0) {
+    return rewriter.notifyMatchFailure(
+        op, "expected a 2-D argmax along the innermost dimension");
+  }
+  // The microkernel leaves the index untouched for empty rows, like the
+  // generic op, which then returns its initial value.
+  if (!isInitializedToZero(index)) {
+    return rewriter.notifyMatchFailure(op, "expected a zero initial index");
+  }
+  Type inputElemType = inputType.getElementType();
+  Type indexElemType = indexType.getElementType();
+  uint32_t flags = 0;
+  if (inputElemType.isF32()) {
+    flags = IREE_UK_FLAG_ARGMAX_TYPE_F32;
+  } else if (inputElemType.isF16()) {
+    flags = IREE_UK_FLAG_ARGMAX_TYPE_F16;
+  } else if (inputElemType.isBF16()) {
+    flags = IREE_UK_FLAG_ARGMAX_TYPE_BF16;
+  } else {
+    return rewriter.notifyMatchFailure(op, "unsupported input element type");
+  }
+  if (indexElemType.isInteger(64)) {
+    flags |= IREE_UK_FLAG_ARGMAX_INDEX_I64;
+  } else if (!indexElemType.isInteger(32)) {
+    return rewriter.notifyMatchFailure(op, "unsupported index element type");
+  }
+
+  Location loc = op.getLoc();
+  Value rows = rewriter.create<tensor::DimOp>(loc, input, 0);
+  Value cols = rewriter.create<tensor::DimOp>(loc, input, 1);
+  Value flagsVal = rewriter.create<arith::ConstantOp>(
+      loc, rewriter.getI32IntegerAttr(flags));
+  auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
+  SmallVector<Type> returnTypes{indexType};
+  if (!isVMVXBackend(targetAttr)) {
+    // Hack to avoid issues with void-returning functions in llvm-cpu.
+    // Note that the first return value, of tensor type, disappears in
+    // bufferization.
+    returnTypes.push_back(rewriter.getI32Type());
+  }
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, returnTypes, fn.name, ValueRange{input}, index,
+      ValueRange{rows, cols, flagsVal},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return genericMicroKernelOp.getResult(0);
+}
+
 static FailureOr<IREE::Codegen::UKernelOpInterface>
 matchDAGForUKernel(RewriterBase &rewriter, IREE::Codegen::QueryTileSizesOp op,
                    bool /*skipIntermediateRoundings*/) {
@@ -551,8 +778,18 @@ matchDAGForUKernel(RewriterBase &rewriter, IREE::Codegen::QueryTileSizesOp op,
   if (!flagForUserAndOperandTypes || !flagForRole) {
     return rewriter.notifyMatchFailure(op, "unhandled encoding");
   }
+  // Forward the narrow-M hint, which is the same on the encodings of all the
+  // operands of a matmul, so the runtime picks consistent narrow tile sizes.
+  uint32_t flagForNarrowM = 0;
+  int64_t matmulNarrowM = getIntOrZero(encoding.getMatmulNarrow_M());
+  if (matmulNarrowM > 0 &&
+      matmulNarrowM <= (IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_MASK >>
+                        IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_SHIFT)) {
+    flagForNarrowM = matmulNarrowM
+                     << IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_SHIFT;
+  }
   inputValues.push_back(rewriter.create<arith::ConstantIntOp>(
-      loc, flagForUserAndOperandTypes | flagForRole, 32));
+      loc, flagForUserAndOperandTypes | flagForRole | flagForNarrowM, 32));
   auto fn = getFnNameAndDefAttrs(ukernelName, rewriter, targetAttr);
   auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
       loc, resultTypes, fn.name, inputValues, /*outs=*/ValueRange{},
@@ -596,6 +833,58 @@ struct LowerToUKernelPattern : OpRewritePattern<OpType> {
   bool skipIntermediateRoundings;
 };
 
+/// Converts a linalg.softmax into the `softmax` microkernel. This is separate
+/// from LowerToUKernelPattern as the microkernel result may need reshaping.
+struct LowerSoftmaxToUKernelPattern : OpRewritePattern<linalg::SoftmaxOp> {
+  LowerSoftmaxToUKernelPattern(MLIRContext *context,
+                               TargetPredicate targetPredicate)
+      : OpRewritePattern<linalg::SoftmaxOp>(context),
+        targetPredicate(targetPredicate) {}
+
+  LogicalResult matchAndRewrite(linalg::SoftmaxOp op,
+                                PatternRewriter &rewriter) const override {
+    if (targetPredicate &&
+        !targetPredicate(IREE::HAL::ExecutableTargetAttr::lookup(op))) {
+      return failure();
+    }
+    FailureOr<Value> result = lowerSoftmaxToUKernel(rewriter, op);
+    if (failed(result)) {
+      return rewriter.notifyMatchFailure(
+          op, "failed to find microkernel op to replace with");
+    }
+    rewriter.replaceOp(op, *result);
+    return success();
+  }
+
+  TargetPredicate targetPredicate;
+};
+
+/// Converts an argmax linalg.generic into the `argmax` microkernel. Only the
+/// index result of the generic op is replaced, its value result is unused.
+struct LowerArgmaxToUKernelPattern : OpRewritePattern<linalg::GenericOp> {
+  LowerArgmaxToUKernelPattern(MLIRContext *context,
+                              TargetPredicate targetPredicate)
+      : OpRewritePattern<linalg::GenericOp>(context),
+        targetPredicate(targetPredicate) {}
+
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    if (targetPredicate &&
+        !targetPredicate(IREE::HAL::ExecutableTargetAttr::lookup(op))) {
+      return failure();
+    }
+    FailureOr<Value> result = lowerArgmaxToUKernel(rewriter, op);
+    if (failed(result)) {
+      return rewriter.notifyMatchFailure(
+          op, "failed to find microkernel op to replace with");
+    }
+    rewriter.replaceAllUsesWith(op.getResult(1), *result);
+    return success();
+  }
+
+  TargetPredicate targetPredicate;
+};
+
 } // namespace
 
 void CPULowerToUKernelsPass::runOnOperation() {
@@ -631,6 +920,20 @@ void CPULowerToUKernelsPass::runOnOperation() {
   // These patterns are inherently specific to the VMVX backend.
   patterns.insert<LowerToUKernelPattern<IREE::Codegen::QueryTileSizesOp>>(
       context, isVMVXBackend);
+  // The attention ukernel is only exposed on LLVMCPU for now, where it replaces
+  // the decomposition into matmul + softmax + matmul. It is still gated on
+  // hasUkernel(target, "attention"), so this only applies when requested.
+  patterns.insert<LowerToUKernelPattern<IREE::LinalgExt::AttentionOp>>(
+      context, [](IREE::HAL::ExecutableTargetAttr target) {
+        return !isVMVXBackend(target);
+      });
+  // Same for the softmax and argmax ukernels. linalg.softmax ops are only left
+  // undecomposed for the softmax ukernel when it is enabled, see
+  // DecomposeSoftmax.
+  patterns.insert<LowerSoftmaxToUKernelPattern, LowerArgmaxToUKernelPattern>(
+      context, [](IREE::HAL::ExecutableTargetAttr target) {
+        return !isVMVXBackend(target);
+      });
   if (failed(
           applyPatternsAndFoldGreedily(getOperation(), std::move(patterns)))) {
     return signalPassFailure();
@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/compiler/Codegen/Common/CPU/CPUTuningDatabase.h"
 #include "iree/compiler/Codegen/Common/CPU/PassDetail.h"
 #include "iree/compiler/Codegen/Common/CPU/Passes.h"
 #include "iree/compiler/Codegen/Common/EncodingUtils.h"
@@ -72,21 +73,86 @@ enumerateMatmulTileRiscv32(ExecutableTargetAttr target) {
   return {};
 }
 
-// Enumerate tile sizes to choose from on arm64.
+// Enumerate tile sizes to choose from on riscv64.
 // For narrow-{M,N} cases, this only enumerates on narrow M. The narrow-N cases
 // are handled by transposition in chooseMatmulTile.
 static SmallVector<TileMxNxK>
-enumerateMatmulTileArm64(TypeRange elementTypes, ExecutableTargetAttr target) {
-  // Data-tiling for SVE is not implemented yet.
-  if (hasFeature(target, "+sve") || hasFeature(target, "+sve2")) {
+enumerateMatmulTileRiscv64(TypeRange elementTypes,
+                           ExecutableTargetAttr target) {
+  assert(elementTypes.size() == 3);
+  Type lhs = elementTypes[0];
+  Type rhs = elementTypes[1];
+  Type out = elementTypes[2];
+
+  // The RVV ukernels are VLEN-agnostic: N0=16 is strip-mined in the kernel.
+  if (!hasUkernel(target) || !hasFeature(target, "+v")) {
+    // Fallback - no architecture-optimized tile size for this case.
     return {};
   }
+  bool isF32 = lhs.isF32() && rhs.isF32() && out.isF32();
+  bool isF16 = lhs.isF16() && rhs.isF16() && out.isF32() &&
+               hasFeature(target, "+zvfh");
+  bool isI8 = lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
+              out.isSignlessInteger(32);
+  if (isF32 || isF16 || isI8) {
+    return {
+        TileMxNxK{8, 16, 1}, // Aim to use vfmacc / vfwmacc / vwmacc.
+        TileMxNxK{4, 16, 1}, // Truncation of the above.
+        TileMxNxK{2, 16, 1}, // Truncation of the above.
+        TileMxNxK{1, 16, 1}, // Truncation of the above.
+    };
+  }
+  // Fallback - no architecture-optimized tile size for this case.
+  return {};
+}
 
+// Enumerate tile sizes to choose from on arm64.
+// For narrow-{M,N} cases, this only enumerates on narrow M. The narrow-N cases
+// are handled by transposition in chooseMatmulTile.
+static SmallVector<TileMxNxK>
+enumerateMatmulTileArm64(TypeRange elementTypes, ExecutableTargetAttr target) {
   assert(elementTypes.size() == 3);
   Type lhs = elementTypes[0];
   Type rhs = elementTypes[1];
   Type out = elementTypes[2];
 
+  // SME outer products are only reachable through ukernels. The tiles match a
+  // 512-bit streaming vector length; the ukernel falls back to generic code on
+  // narrower implementations.
+  if (hasUkernel(target) && hasFeature(target, "+sme") && out.isF32()) {
+    int64_t tileK = 0;
+    if (lhs.isF32() && rhs.isF32()) {
+      tileK = 1; // Aim to use FMOPA (single precision).
+    } else if ((lhs.isF16() && rhs.isF16()) || (lhs.isBF16() && rhs.isBF16())) {
+      tileK = 2; // Aim to use FMOPA / BFMOPA (widening).
+    }
+    if (tileK) {
+      return {
+          TileMxNxK{16, 16, tileK}, // Aim to use SME outer products.
+          TileMxNxK{8, 16, tileK},  // Truncation of the above.
+          TileMxNxK{4, 16, tileK},  // Truncation of the above.
+          TileMxNxK{2, 16, tileK},  // Truncation of the above.
+          TileMxNxK{1, 16, tileK},  // Truncation of the above.
+      };
+    }
+  }
+  if (hasUkernel(target) && hasFeature(target, "+sme") &&
+      lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8) &&
+      out.isSignlessInteger(32)) {
+    return {
+        TileMxNxK{16, 16, 4}, // Aim to use SMOPA.
+        TileMxNxK{8, 16, 4},  // Truncation of the above.
+        TileMxNxK{4, 16, 4},  // Truncation of the above.
+        TileMxNxK{2, 16, 4},  // Truncation of the above.
+        TileMxNxK{1, 16, 4},  // Truncation of the above.
+    };
+  }
+
+  // Data-tiling for SVE is not implemented yet.
+  if (hasFeature(target, "+sve") || hasFeature(target, "+sve2")) {
+    return {};
+  }
+
   if (out.isF32() || out.isF16() || out.isBF16()) {
     if (lhs.isBF16() && rhs.isBF16() && (out.isBF16() || out.isF32()) &&
         hasFeature(target, "+bf16")) {
@@ -273,6 +339,18 @@ enumerateMatmulTileX86_64(TypeRange elementTypes, ExecutableTargetAttr target) {
   if (out.isSignlessInteger(32) &&
       ((lhs.isSignlessInteger(8) && rhs.isSignlessInteger(8)) ||
        (lhs.isSignlessInteger(16) && rhs.isSignlessInteger(16)))) {
+    if (lhs.isSignlessInteger(8) && hasFeature(target, "+amx-int8") &&
+        hasUkernel(target)) {
+      // Only the ukernels make use of AMX tiles, which consume 16 K0=4 steps
+      // per TDPBSSD. The RHS tile layout is then directly the AMX B layout.
+      return {
+          TileMxNxK{16, 16, 4}, // Aim to use TDPBSSD.
+          TileMxNxK{8, 16, 4},  // Truncation of the above.
+          TileMxNxK{4, 16, 4},  // Truncation of the above.
+          TileMxNxK{2, 16, 4},  // Truncation of the above.
+          TileMxNxK{1, 16, 4},  // Truncation of the above.
+      };
+    }
     if (hasFeature(target, "+avx512vnni")) {
       // This is the same tile size as with VPMADDWD as the only difference
       // is that VPDPWSSD accumulates. VPDPBUSD would call for {16, 16, 4} but
@@ -425,6 +503,35 @@ chooseMatmulTile(ArrayRef<TileMxNxK> enumeratedTiles, int64_t matmulNarrowM,
   return bestRatedTile;
 }
 
+/// Returns the tile from the mmt4d tuning database (see CPUTuningDatabase.h)
+/// for this matmul, if there is one within `hostDefinedUpperBound`. Narrow-N
+/// cases are looked up as narrow-M and transposed, like in chooseMatmulTile.
+static std::optional<TileMxNxK>
+chooseTunedMatmulTile(ExecutableTargetAttr target, TypeRange elementTypes,
+                      int64_t matmulNarrowM, int64_t matmulNarrowN,
+                      ArrayRef<int64_t> hostDefinedUpperBound) {
+  bool transpose =
+      matmulNarrowN && (!matmulNarrowM || matmulNarrowN < matmulNarrowM);
+  std::optional<Mmt4dTuningEntry> entry = lookupMmt4dTuningEntry(
+      target, elementTypes, transpose ? matmulNarrowN : matmulNarrowM);
+  if (!entry) {
+    return std::nullopt;
+  }
+  TileMxNxK tile = {entry->M0, entry->N0, entry->K0};
+  if (transpose) {
+    std::swap(tile.M, tile.N);
+  }
+  if (!hostDefinedUpperBound.empty() &&
+      (tile.M > hostDefinedUpperBound[0] || tile.N > hostDefinedUpperBound[1] ||
+       tile.K > hostDefinedUpperBound[2])) {
+    LLVM_DEBUG(llvm::dbgs() << "[" << DEBUG_TYPE
+                            << "]: tuned tile is skipped because it is not "
+                               "valid for upper_bound\n");
+    return std::nullopt;
+  }
+  return tile;
+}
+
 SmallVector<TileMxNxK>
 enumerateMatmulTileMxNxK(linalg::ContractionDimensions cDims,
                          TypeRange elementTypes, ExecutableTargetAttr target) {
@@ -440,6 +547,9 @@ enumerateMatmulTileMxNxK(linalg::ContractionDimensions cDims,
   if (isRISCV32(target)) {
     return enumerateMatmulTileRiscv32(target);
   }
+  if (isRISCV64(target)) {
+    return enumerateMatmulTileRiscv64(elementTypes, target);
+  }
   return {};
 }
 
@@ -513,10 +623,16 @@ materializeEncodingForTarget(RankedTensorType tensorType,
                               ? 0
                               : getIntOrZero(encoding.getMatmulNarrow_N());
   // Choose a final matmul TileMxNxK from the above-enumarated tile shapes,
-  // taking narrow dimensions into account.
+  // taking narrow dimensions into account, unless a tuning database measured
+  // on the target CPU says otherwise.
+  std::optional<TileMxNxK> tunedTileMxNxK =
+      chooseTunedMatmulTile(targetAttr, elementTypes, matmulNarrowM,
+                            matmulNarrowN, encoding.getRoundDimsToArray());
   TileMxNxK chosenTileMxNxK =
-      chooseMatmulTile(enumeratedTileMxNxK, matmulNarrowM, matmulNarrowN,
-                       encoding.getRoundDimsToArray());
+      tunedTileMxNxK
+          ? *tunedTileMxNxK
+          : chooseMatmulTile(enumeratedTileMxNxK, matmulNarrowM, matmulNarrowN,
+                             encoding.getRoundDimsToArray());
 
   // Map the matmul TileMxNxK to an actual tile shape for the tensor at hand,
   // based on its role in the matmul.
@@ -607,6 +723,7 @@ void CPUMaterializeEncodingPass::runOnOperation() {
   RewritePatternSet materializeEncodingPattern(context);
   if (!targetAttr)
     targetAttr = ExecutableTargetAttr::lookup(operation);
+  checkMmt4dTuningDatabase(operation, targetAttr);
   auto materializeEncodingFn = getMaterializeEncodingFn(targetAttr);
   if (!materializeEncodingFn) {
     return signalPassFailure();
@@ -0,0 +1,198 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/Common/CPU/CPUTuningDatabase.h"
+
+#include <mutex>
+
+#include "iree/compiler/Codegen/Utils/Utils.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/raw_ostream.h"
+
+namespace mlir::iree_compiler {
+
+static llvm::cl::opt<std::string> clMmt4dTuningDatabase(
+    "iree-llvmcpu-mmt4d-tuning-database",
+    llvm::cl::desc(
+        "Path to a mmt4d tuning database written by the mmt4d_autotune tool. "
+        "On LLVMCPU targets whose CPU has entries in it, these entries decide "
+        "the mmt4d tile sizes and workgroup sizes instead of the default "
+        "tables."),
+    llvm::cl::init(""));
+
+namespace {
+
+struct TuningDatabaseEntry {
+  std::string cpu;
+  std::string types;
+  int64_t narrowM = 0;
+  Mmt4dTuningEntry tuning;
+};
+
+struct TuningDatabase {
+  SmallVector<TuningDatabaseEntry> entries;
+  // Why the database can't be used, in which case it has no entries.
+  std::string error;
+};
+
+} // namespace
+
+static std::optional<TuningDatabaseEntry>
+parseTuningDatabaseEntry(const llvm::json::Value &value) {
+  const llvm::json::Object *object = value.getAsObject();
+  if (!object) {
+    return std::nullopt;
+  }
+  std::optional<StringRef> cpu = object->getString("cpu");
+  std::optional<StringRef> types = object->getString("type");
+  std::optional<int64_t> narrowM = object->getInteger("narrow_m");
+  std::optional<int64_t> M0 = object->getInteger("M0");
+  std::optional<int64_t> N0 = object->getInteger("N0");
+  std::optional<int64_t> K0 = object->getInteger("K0");
+  std::optional<int64_t> workgroupM = object->getInteger("workgroup_M");
+  std::optional<int64_t> workgroupN = object->getInteger("workgroup_N");
+  if (!cpu || !types || !narrowM || !M0 || !N0 || !K0 || !workgroupM ||
+      !workgroupN || *M0 <= 0 || *N0 <= 0 || *K0 <= 0 || *workgroupM <= 0 ||
+      *workgroupN <= 0) {
+    return std::nullopt;
+  }
+  TuningDatabaseEntry entry;
+  entry.cpu = cpu->str();
+  entry.types = types->str();
+  entry.narrowM = *narrowM;
+  entry.tuning = {*M0, *N0, *K0, *workgroupM, *workgroupN};
+  return entry;
+}
+
+static TuningDatabase makeInvalidTuningDatabase(const Twine &error) {
+  TuningDatabase database;
+  database.error = error.str();
+  return database;
+}
+
+static TuningDatabase parseTuningDatabase(StringRef path) {
+  auto fileOrErr = llvm::MemoryBuffer::getFile(path);
+  if (!fileOrErr) {
+    return makeInvalidTuningDatabase(fileOrErr.getError().message());
+  }
+  llvm::Expected<llvm::json::Value> json =
+      llvm::json::parse((*fileOrErr)->getBuffer());
+  if (!json) {
+    return makeInvalidTuningDatabase(llvm::toString(json.takeError()));
+  }
+  const llvm::json::Object *root = json->getAsObject();
+  if (!root || root->getInteger("version") != 1) {
+    return makeInvalidTuningDatabase("expected an object with \"version\": 1");
+  }
+  const llvm::json::Array *entries = root->getArray("entries");
+  if (!entries) {
+    return makeInvalidTuningDatabase("expected an \"entries\" array");
+  }
+  TuningDatabase database;
+  for (auto [index, value] : llvm::enumerate(*entries)) {
+    std::optional<TuningDatabaseEntry> entry = parseTuningDatabaseEntry(value);
+    if (!entry) {
+      return makeInvalidTuningDatabase("malformed entry " + Twine(index));
+    }
+    database.entries.push_back(std::move(*entry));
+  }
+  return database;
+}
+
+/// Returns the database at `path`, parsing it on first use. The cache is keyed
+/// on the path as the flag may change between compilations in one process.
+static const TuningDatabase &getTuningDatabase(StringRef path) {
+  static std::mutex mutex;
+  static llvm::StringMap<TuningDatabase> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto [it, inserted] = cache.try_emplace(path);
+  if (inserted) {
+    it->second = parseTuningDatabase(path);
+  }
+  return it->second;
+}
+
+/// Returns the database entries for the CPU of `targetAttr` and the given
+/// element types.
+static SmallVector<const TuningDatabaseEntry *>
+getMatchingEntries(IREE::HAL::ExecutableTargetAttr targetAttr,
+                   TypeRange elementTypes) {
+  if (clMmt4dTuningDatabase.empty() || !isLLVMCPUBackend(targetAttr)) {
+    return {};
+  }
+  std::optional<StringAttr> cpu = getConfigStringAttr(targetAttr, "cpu");
+  if (!cpu || cpu->getValue().empty()) {
+    return {};
+  }
+  // Element types are spelled like in the IR, e.g. "f32f32f32" or "i8i8i32".
+  std::string types;
+  llvm::raw_string_ostream os(types);
+  for (Type type : elementTypes) {
+    os << type;
+  }
+  os.flush();
+  SmallVector<const TuningDatabaseEntry *> result;
+  for (const TuningDatabaseEntry &entry :
+       getTuningDatabase(clMmt4dTuningDatabase).entries) {
+    if (entry.cpu == cpu->getValue() && entry.types == types) {
+      result.push_back(&entry);
+    }
+  }
+  return result;
+}
+
+void checkMmt4dTuningDatabase(Operation *op,
+                              IREE::HAL::ExecutableTargetAttr targetAttr) {
+  if (clMmt4dTuningDatabase.empty() || !isLLVMCPUBackend(targetAttr)) {
+    return;
+  }
+  const TuningDatabase &database = getTuningDatabase(clMmt4dTuningDatabase);
+  if (!database.error.empty()) {
+    op->emitWarning() << "ignoring mmt4d tuning database '"
+                      << clMmt4dTuningDatabase << "': " << database.error;
+  }
+}
+
+std::optional<Mmt4dTuningEntry>
+lookupMmt4dTuningEntry(IREE::HAL::ExecutableTargetAttr targetAttr,
+                       TypeRange elementTypes, int64_t narrowM) {
+  int64_t narrowMBucket = narrowM ? llvm::PowerOf2Ceil(narrowM) : 0;
+  for (const TuningDatabaseEntry *entry :
+       getMatchingEntries(targetAttr, elementTypes)) {
+    if (entry->narrowM == narrowMBucket) {
+      return entry->tuning;
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<Mmt4dTuningEntry>
+lookupMmt4dTuningEntryForTile(IREE::HAL::ExecutableTargetAttr targetAttr,
+                              TypeRange elementTypes, int64_t M0, int64_t N0,
+                              int64_t K0) {
+  std::optional<Mmt4dTuningEntry> result;
+  for (const TuningDatabaseEntry *entry :
+       getMatchingEntries(targetAttr, elementTypes)) {
+    const Mmt4dTuningEntry &tuning = entry->tuning;
+    if (tuning.M0 != M0 || tuning.N0 != N0 || tuning.K0 != K0) {
+      continue;
+    }
+    if (entry->narrowM == 0) {
+      return tuning;
+    }
+    if (!result) {
+      result = tuning;
+    }
+  }
+  return result;
+}
+
+} // namespace mlir::iree_compiler
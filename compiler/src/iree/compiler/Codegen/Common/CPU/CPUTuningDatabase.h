@@ -0,0 +1,55 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_CODEGEN_COMMON_CPU_CPUTUNINGDATABASE_H_
+#define IREE_COMPILER_CODEGEN_COMMON_CPU_CPUTUNINGDATABASE_H_
+
+#include <optional>
+
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "mlir/IR/Operation.h"
+#include "mlir/IR/TypeRange.h"
+
+namespace mlir::iree_compiler {
+
+/// One entry of a mmt4d tuning database, as written by the
+/// runtime/src/iree/builtins/ukernel/tools/mmt4d_autotune tool: the fastest
+/// M0xN0xK0 tile measured on a given CPU for given element types and narrow-M
+/// size, and the fastest workgroup sizes (in elements) for that tile.
+struct Mmt4dTuningEntry {
+  int64_t M0 = 0;
+  int64_t N0 = 0;
+  int64_t K0 = 0;
+  int64_t workgroupM = 0;
+  int64_t workgroupN = 0;
+};
+
+/// Emits a warning at `op` if the database given by
+/// --iree-llvmcpu-mmt4d-tuning-database applies to `targetAttr` but can't be
+/// read or parsed. Lookups then behave as if no database was given.
+void checkMmt4dTuningDatabase(Operation *op,
+                              IREE::HAL::ExecutableTargetAttr targetAttr);
+
+/// Returns the entry of the database given by
+/// --iree-llvmcpu-mmt4d-tuning-database for the "cpu" of `targetAttr`, the
+/// matmul `elementTypes` (LHS, RHS, OUT) and `narrowM`. A non-zero `narrowM`
+/// is rounded up to a power of two, which is how the tool tunes narrow cases.
+/// Returns std::nullopt if no database is given or if it has no such entry.
+std::optional<Mmt4dTuningEntry>
+lookupMmt4dTuningEntry(IREE::HAL::ExecutableTargetAttr targetAttr,
+                       TypeRange elementTypes, int64_t narrowM);
+
+/// Like lookupMmt4dTuningEntry, but looking up the entry for a given tile,
+/// which is what is known about a linalg.mmt4d op after encodings are
+/// materialized. Prefers the non-narrow entry if several match.
+std::optional<Mmt4dTuningEntry>
+lookupMmt4dTuningEntryForTile(IREE::HAL::ExecutableTargetAttr targetAttr,
+                              TypeRange elementTypes, int64_t M0, int64_t N0,
+                              int64_t K0);
+
+} // namespace mlir::iree_compiler
+
+#endif // IREE_COMPILER_CODEGEN_COMMON_CPU_CPUTUNINGDATABASE_H_
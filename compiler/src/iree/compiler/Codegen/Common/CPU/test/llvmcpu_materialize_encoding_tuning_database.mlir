@@ -0,0 +1,108 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-cpu-materialize-encoding))" \
+// RUN:   --iree-llvmcpu-mmt4d-tuning-database=%p/mmt4d_tuning_database.json \
+// RUN:   --split-input-file %s | FileCheck %s
+
+// The tuned tile for the matching CPU replaces the default 16x16x1 tile.
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+func.func @set_encoding_LHS_tuned_cpu() attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {target_triple="x86_64-xyz-xyz", cpu="znver4", cpu_features="+avx512f"}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x64xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x64xf32>> -> tensor<64x64xf32>
+  %3 = iree_encoding.set_encoding %2 : tensor<64x64xf32> -> tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>> -> !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  return
+}
+// CHECK-LABEL: func.func @set_encoding_LHS_tuned_cpu
+// CHECK:         tensor.pack
+// CHECK-SAME:      inner_tiles = [8, 1]
+// CHECK-SAME:      -> tensor<8x64x8x1xf32>
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+func.func @set_encoding_RHS_tuned_cpu() attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {target_triple="x86_64-xyz-xyz", cpu="znver4", cpu_features="+avx512f"}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x64xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x64xf32>> -> tensor<64x64xf32>
+  %3 = iree_encoding.set_encoding %2 : tensor<64x64xf32> -> tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>> -> !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  return
+}
+// CHECK-LABEL: func.func @set_encoding_RHS_tuned_cpu
+// CHECK:         tensor.pack
+// CHECK-SAME:      inner_tiles = [32, 1]
+// CHECK-SAME:      -> tensor<2x64x32x1xf32>
+
+// -----
+// Other CPUs keep the default tile.
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+func.func @set_encoding_RHS_untuned_cpu() attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {target_triple="x86_64-xyz-xyz", cpu="skylake-avx512", cpu_features="+avx512f"}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x64xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x64xf32>> -> tensor<64x64xf32>
+  %3 = iree_encoding.set_encoding %2 : tensor<64x64xf32> -> tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>> -> !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  return
+}
+// CHECK-LABEL: func.func @set_encoding_RHS_untuned_cpu
+// CHECK:         tensor.pack
+// CHECK-SAME:      inner_tiles = [16, 1]
+// CHECK-SAME:      -> tensor<4x64x16x1xf32>
+
+// -----
+// Narrow-M matmuls use the entry for their narrow M size.
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+func.func @set_encoding_RHS_narrow_M_tuned_cpu() attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {target_triple="x86_64-xyz-xyz", cpu="znver4", cpu_features="+avx512f"}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x64xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, matmul_narrow_M = 1 : index, user_indexing_maps = [#map, #map1, #map2]>>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x64xf32>> -> tensor<64x64xf32>
+  %3 = iree_encoding.set_encoding %2 : tensor<64x64xf32> -> tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, matmul_narrow_M = 1 : index, user_indexing_maps = [#map, #map1, #map2]>>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, matmul_narrow_M = 1 : index, user_indexing_maps = [#map, #map1, #map2]>> -> !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, matmul_narrow_M = 1 : index, user_indexing_maps = [#map, #map1, #map2]>>>
+  return
+}
+// CHECK-LABEL: func.func @set_encoding_RHS_narrow_M_tuned_cpu
+// CHECK:         tensor.pack
+// CHECK-SAME:      inner_tiles = [32, 1]
+// CHECK-SAME:      -> tensor<2x64x32x1xf32>
+
+// -----
+// Tuned tiles beyond round_dims_to are ignored, falling back to the default
+// tile.
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+func.func @set_encoding_RHS_tuned_cpu_upper_bound() attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {target_triple="x86_64-xyz-xyz", cpu="znver4", cpu_features="+avx512f"}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x64xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2], round_dims_to = array<i64: 16, 16, 16>>>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x64xf32>> -> tensor<64x64xf32>
+  %3 = iree_encoding.set_encoding %2 : tensor<64x64xf32> -> tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2], round_dims_to = array<i64: 16, 16, 16>>>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2], round_dims_to = array<i64: 16, 16, 16>>> -> !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = RHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2], round_dims_to = array<i64: 16, 16, 16>>>>
+  return
+}
+// CHECK-LABEL: func.func @set_encoding_RHS_tuned_cpu_upper_bound
+// CHECK:         tensor.pack
+// CHECK-SAME:      inner_tiles = [16, 1]
+// CHECK-SAME:      -> tensor<4x64x16x1xf32>
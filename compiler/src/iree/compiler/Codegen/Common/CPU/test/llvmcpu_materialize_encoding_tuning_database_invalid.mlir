@@ -0,0 +1,24 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-cpu-materialize-encoding))" \
+// RUN:   --iree-llvmcpu-mmt4d-tuning-database=%p/mmt4d_tuning_database_invalid.json \
+// RUN:   --verify-diagnostics %s | FileCheck %s
+
+// A malformed database is reported and ignored: the default tile is used.
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+// expected-warning @+1 {{ignoring mmt4d tuning database '{{.*}}mmt4d_tuning_database_invalid.json': malformed entry 0}}
+func.func @set_encoding_LHS_invalid_database() attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {target_triple="x86_64-xyz-xyz", cpu="znver4", cpu_features="+avx512f"}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<64x64xf32>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<64x64xf32>> -> tensor<64x64xf32>
+  %3 = iree_encoding.set_encoding %2 : tensor<64x64xf32> -> tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [64, 64], strides = [1, 1] : tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>> -> !flow.dispatch.tensor<writeonly:tensor<64x64xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], original_type = tensor<64x64xf32>, user_indexing_maps = [#map, #map1, #map2]>>>
+  return
+}
+// CHECK-LABEL: func.func @set_encoding_LHS_invalid_database
+// CHECK:         tensor.pack
+// CHECK-SAME:      inner_tiles = [16, 1]
+// CHECK-SAME:      -> tensor<4x64x16x1xf32>
@@ -519,6 +519,26 @@ func.func @query_tile_sizes_2d() -> (index, index)  attributes {
 
 // -----
 
+// Flags: NARROW_M = 1 (0x10000) | MATMUL_F32F32F32 (0x100) | ROLE_LHS (0x1).
+//     CHECK: func @query_tile_sizes_2d_narrow_m(
+// CHECK-DAG: %[[SIZE0:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[DYNAMIC:.+]] = arith.constant -9223372036854775808 : index
+// CHECK-DAG: %[[FLAGS:.+]] = arith.constant 65793 : i32
+// CHECK:     %[[RESULT:.+]]:2 = iree_codegen.ukernel.generic "vmvx.query_tile_sizes.2d"
+// CHECK-SAME: ins(%[[SIZE0]], %[[DYNAMIC]], %[[FLAGS]] : index, index, i32)
+// CHECK:     return %[[RESULT]]#0, %[[RESULT]]#1 : index, index
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+func.func @query_tile_sizes_2d_narrow_m() -> (index, index)  attributes {
+  hal.executable.target = #hal.executable.target<"vmvx", "vmvx-bytecode-fb", {ukernels = "all"}>
+} {
+  %result:2 = iree_codegen.query_tile_sizes tensor<1x?xf32, #iree_encoding.encoding<role = LHS, element_types = [f32, f32, f32], matmul_narrow_M = 1 : index, user_indexing_maps = [#map, #map1, #map2]>> -> index, index
+  return %result#0, %result#1 : index, index
+}
+
+// -----
+
 func.func @mmt4d_i16u4i32_extend_producers(%arg0: tensor<10x10x1x8xi16>, %arg1: tensor<10x10x32x8xi4>, %arg2: tensor<10x10x1x32xi32>) -> tensor<10x10x1x32xi32> attributes {
   hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features="+avx512vnni"}>
 } {
@@ -551,3 +571,142 @@ func.func @mmt4d_i16u4i32_extend_producers(%arg0: tensor<10x10x1x8xi16>, %arg1:
 // CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]] :
 // CHECK-SAME:       outs(%[[ARG2]] :
 //      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @attention_f16(%arg0: tensor<4x32x64xf16>, %arg1: tensor<4x128x64xf16>, %arg2: tensor<4x128x64xf16>, %arg3: f16) -> tensor<4x32x64xf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features=""}>
+} {
+  %0 = tensor.empty() : tensor<4x32x64xf16>
+  %1 = iree_linalg_ext.attention ins(%arg0, %arg1, %arg2, %arg3 : tensor<4x32x64xf16>, tensor<4x128x64xf16>, tensor<4x128x64xf16>, f16) outs(%0 : tensor<4x32x64xf16>) -> tensor<4x32x64xf16>
+  return %1 : tensor<4x32x64xf16>
+}
+// CHECK-LABEL: func @attention_f16(
+// CHECK-SAME:     %[[Q:[a-zA-Z0-9]+]]: tensor<4x32x64xf16>
+// CHECK-SAME:     %[[K:[a-zA-Z0-9]+]]: tensor<4x128x64xf16>
+// CHECK-SAME:     %[[V:[a-zA-Z0-9]+]]: tensor<4x128x64xf16>
+// CHECK-SAME:     %[[SCALE:[a-zA-Z0-9]+]]: f16
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 2 : i32
+//  CHECK-DAG:   %[[C4:.+]] = arith.constant 4 : index
+//  CHECK-DAG:   %[[C32:.+]] = arith.constant 32 : index
+//  CHECK-DAG:   %[[C64:.+]] = arith.constant 64 : index
+//  CHECK-DAG:   %[[C128:.+]] = arith.constant 128 : index
+//  CHECK-DAG:   %[[EMPTY:.+]] = tensor.empty() : tensor<4x32x64xf16>
+//  CHECK-DAG:   %[[SCALE_F32:.+]] = arith.extf %[[SCALE]] : f16 to f32
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_attention"
+// CHECK-SAME:       ins(%[[Q]], %[[K]], %[[V]] :
+// CHECK-SAME:       outs(%[[EMPTY]] :
+// CHECK-SAME:       (%[[C4]], %[[C32]], %[[C64]], %[[C128]], %[[C64]], %[[SCALE_F32]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(2)
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @attention_f32_transpose_v_with_only_mmt4d_ukernel_enabled(%arg0: tensor<?x?x64xf32>, %arg1: tensor<?x?x64xf32>, %arg2: tensor<?x64x?xf32>, %arg3: f32, %arg4: tensor<?x?x64xf32>) -> tensor<?x?x64xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "mmt4d", target_triple="x86_64-xyz-xyz", cpu_features=""}>
+} {
+  %0 = iree_linalg_ext.attention {transpose_v = true} ins(%arg0, %arg1, %arg2, %arg3 : tensor<?x?x64xf32>, tensor<?x?x64xf32>, tensor<?x64x?xf32>, f32) outs(%arg4 : tensor<?x?x64xf32>) -> tensor<?x?x64xf32>
+  return %0 : tensor<?x?x64xf32>
+}
+// CHECK-LABEL: func @attention_f32_transpose_v_with_only_mmt4d_ukernel_enabled(
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+//      CHECK:   iree_linalg_ext.attention
+
+// -----
+
+func.func @softmax_f32(%arg0: tensor<?x?xf32>, %arg1: tensor<?x?xf32>) -> tensor<?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features=""}>
+} {
+  %0 = linalg.softmax dimension(1) ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+// CHECK-LABEL: func @softmax_f32(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 1 : i32
+//  CHECK-DAG:   %[[ROWS:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[COLS:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[ARG1]] :
+// CHECK-SAME:       (%[[ROWS]], %[[COLS]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]#0
+
+// -----
+
+func.func @softmax_bf16_unit_outer_dims(%arg0: tensor<1x1x?x128xbf16>, %arg1: tensor<1x1x?x128xbf16>) -> tensor<1x1x?x128xbf16> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features=""}>
+} {
+  %0 = linalg.softmax dimension(3) ins(%arg0 : tensor<1x1x?x128xbf16>) outs(%arg1 : tensor<1x1x?x128xbf16>) -> tensor<1x1x?x128xbf16>
+  return %0 : tensor<1x1x?x128xbf16>
+}
+// CHECK-LABEL: func @softmax_bf16_unit_outer_dims(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<1x1x?x128xbf16>
+// CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<1x1x?x128xbf16>
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 3 : i32
+//  CHECK-DAG:   %[[C128:.+]] = arith.constant 128 : index
+//  CHECK-DAG:   %[[IN:.+]] = tensor.collapse_shape %[[ARG0]] {{\[}}[0, 1, 2], [3]]
+//  CHECK-DAG:   %[[OUT:.+]] = tensor.collapse_shape %[[ARG1]] {{\[}}[0, 1, 2], [3]]
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_softmax"
+// CHECK-SAME:       ins(%[[IN]] :
+// CHECK-SAME:       outs(%[[OUT]] :
+// CHECK-SAME:       %[[C128]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   %[[RESULT:.+]] = tensor.expand_shape %[[MICRO_KERNEL]]#0 {{\[}}[0, 1, 2], [3]]
+//      CHECK:   return %[[RESULT]]
+
+// -----
+
+func.func @softmax_f32_with_only_mmt4d_ukernel_enabled(%arg0: tensor<?x?xf32>, %arg1: tensor<?x?xf32>) -> tensor<?x?xf32> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "mmt4d", target_triple="x86_64-xyz-xyz", cpu_features=""}>
+} {
+  %0 = linalg.softmax dimension(1) ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+// CHECK-LABEL: func @softmax_f32_with_only_mmt4d_ukernel_enabled(
+//  CHECK-NOT:   iree_codegen.ukernel.generic
+//      CHECK:   linalg.softmax
+
+// -----
+
+func.func @argmax_f32i64(%arg0 : tensor<?x?xf32>) -> tensor<?xi64> attributes {
+  hal.executable.target = #hal.executable.target<"llvm-cpu", "xyz", {ukernels = "all", target_triple="x86_64-xyz-xyz", cpu_features=""}>
+} {
+  %c0 = arith.constant 0 : index
+  %c0_i64 = arith.constant 0 : i64
+  %cst = arith.constant 0xFF800000 : f32
+  %d0 = tensor.dim %arg0, %c0 : tensor<?x?xf32>
+  %0 = tensor.empty(%d0) : tensor<?xi64>
+  %1 = linalg.fill ins(%c0_i64 : i64) outs(%0 : tensor<?xi64>) -> tensor<?xi64>
+  %2 = tensor.empty(%d0) : tensor<?xf32>
+  %3 = linalg.fill ins(%cst : f32) outs(%2 : tensor<?xf32>) -> tensor<?xf32>
+  %4:2 = linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>, affine_map<(d0, d1) -> (d0)>], iterator_types = ["parallel", "reduction"]} ins(%arg0 : tensor<?x?xf32>) outs(%3, %1 : tensor<?xf32>, tensor<?xi64>) {
+  ^bb0(%in: f32, %out: f32, %out_0: i64):
+    %5 = linalg.index 1 : index
+    %6 = arith.index_cast %5 : index to i64
+    %7 = arith.maximumf %in, %out : f32
+    %8 = arith.cmpf ogt, %in, %out : f32
+    %9 = arith.select %8, %6, %out_0 : i64
+    linalg.yield %7, %9 : f32, i64
+  } -> (tensor<?xf32>, tensor<?xi64>)
+  return %4#1 : tensor<?xi64>
+}
+// CHECK-LABEL: func @argmax_f32i64(
+// CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<?x?xf32>
+//  CHECK-DAG:   %[[C0:.+]] = arith.constant 0 : index
+//  CHECK-DAG:   %[[C1:.+]] = arith.constant 1 : index
+//  CHECK-DAG:   %[[FLAGS:.+]] = arith.constant 257 : i32
+//  CHECK-DAG:   %[[ROWS:.+]] = tensor.dim %[[ARG0]], %[[C0]]
+//  CHECK-DAG:   %[[COLS:.+]] = tensor.dim %[[ARG0]], %[[C1]]
+//  CHECK-DAG:   %[[FILL:.+]] = linalg.fill
+// CHECK-SAME:       -> tensor<?xi64>
+//      CHECK:   %[[MICRO_KERNEL:.+]]:2 = iree_codegen.ukernel.generic "iree_uk_argmax"
+// CHECK-SAME:       ins(%[[ARG0]] :
+// CHECK-SAME:       outs(%[[FILL]] :
+// CHECK-SAME:       (%[[ROWS]], %[[COLS]], %[[FLAGS]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//  CHECK-NOT:   linalg.generic
+//      CHECK:   return %[[MICRO_KERNEL]]#0
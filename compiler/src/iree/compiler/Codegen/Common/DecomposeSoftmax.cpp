@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Codegen/Common/PassDetail.h"
 #include "iree/compiler/Codegen/Common/Passes.h"
+#include "iree/compiler/Codegen/Utils/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
@@ -16,6 +17,24 @@
 namespace mlir::iree_compiler {
 
 namespace {
+
+/// Returns true if `softmaxOp` is left for CPULowerToUKernels to convert into
+/// a call to the `softmax` ukernel: on LLVMCPU when that ukernel is enabled,
+/// for a softmax along the innermost dimension of a f32, f16 or bf16 tensor of
+/// rank at least 2.
+static bool isLoweredToSoftmaxUKernel(linalg::SoftmaxOp softmaxOp) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(softmaxOp);
+  if (!isLLVMCPUBackend(targetAttr) || !hasUkernel(targetAttr, "softmax")) {
+    return false;
+  }
+  ShapedType inputType = softmaxOp.getInputOperandType();
+  Type elemType = inputType.getElementType();
+  return inputType.getRank() >= 2 &&
+         static_cast<int64_t>(softmaxOp.getDimension()) ==
+             inputType.getRank() - 1 &&
+         (elemType.isF32() || elemType.isF16() || elemType.isBF16());
+}
+
 /// Given an N-dimensional tensor x, this op converts
 /// softmax(x) to the following sequence of operations:
 ///
@@ -40,6 +59,9 @@ static LogicalResult convertSoftmaxToGenerics(mlir::FunctionOpInterface funcOp,
   SmallVector<Operation *> toDelete;
   SmallVector<Operation *> softmaxOpsToDecompose;
   funcOp.walk([&](linalg::SoftmaxOp softmaxOp) {
+    if (isLoweredToSoftmaxUKernel(softmaxOp)) {
+      return;
+    }
     softmaxOpsToDecompose.push_back(softmaxOp);
   });
 
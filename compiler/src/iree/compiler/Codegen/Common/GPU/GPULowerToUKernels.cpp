@@ -9,6 +9,7 @@
 #include "iree/compiler/Codegen/Dialect/Codegen/IR/UKernelOps.h"
 #include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Codegen/Utils/Utils.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -126,6 +127,40 @@ matchArgmaxDAGForUKernel(RewriterBase &rewriter, linalg::GenericOp op) {
       genericMicroKernelOp.getOperation());
 }
 
+/// Matches a matmul workgroup tile that the MFMA matmul ukernel can compute
+/// and converts it into an iree_codegen.ukernel.generic operation. The
+/// ukernel accumulates into the output so the fill producing the init operand
+/// is preserved.
+static FailureOr<IREE::Codegen::UKernelOpInterface>
+matchMatmulDAGForUKernel(RewriterBase &rewriter, linalg::MatmulOp op) {
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  const char ukernelName[] = "matmul";
+  std::optional<StringRef> typeSuffix =
+      getRocmMatmulUkernelTypeSuffix(op, targetAttr);
+  if (!typeSuffix) {
+    return rewriter.notifyMatchFailure(op, "no matching matmul ukernel");
+  }
+
+  Location loc = op.getLoc();
+  Value lhs = op.getDpsInputOperand(0)->get();
+  Value rhs = op.getDpsInputOperand(1)->get();
+  Value out = op.getDpsInitOperand(0)->get();
+  SmallVector<int64_t, 4> bounds = op.getStaticLoopRanges();
+  Value m = rewriter.create<arith::ConstantIndexOp>(loc, bounds[0]);
+  Value n = rewriter.create<arith::ConstantIndexOp>(loc, bounds[1]);
+  Value k = rewriter.create<arith::ConstantIndexOp>(loc, bounds[2]);
+  std::string typeSuffixID = typeSuffix->str();
+  auto fn =
+      getFnNameAndDefAttrs(ukernelName, typeSuffixID, rewriter, targetAttr);
+  auto genericMicroKernelOp = rewriter.create<IREE::Codegen::UKernelGenericOp>(
+      loc, out.getType(), fn.name, ValueRange{lhs, rhs}, out,
+      ValueRange{m, n, k},
+      /*fn_def_attrs=*/rewriter.getDictionaryAttr(fn.defAttrs),
+      /*strided_outer_dims=*/rewriter.getIndexAttr(1));
+  return cast<IREE::Codegen::UKernelOpInterface>(
+      genericMicroKernelOp.getOperation());
+}
+
 using TargetPredicate = std::function<bool(IREE::HAL::ExecutableTargetAttr)>;
 
 struct LowerArgmaxToUKernelPattern : OpRewritePattern<linalg::GenericOp> {
@@ -157,6 +192,31 @@ struct LowerArgmaxToUKernelPattern : OpRewritePattern<linalg::GenericOp> {
   TargetPredicate targetPredicate;
 };
 
+struct LowerMatmulToUKernelPattern : OpRewritePattern<linalg::MatmulOp> {
+  LowerMatmulToUKernelPattern(MLIRContext *context,
+                              TargetPredicate targetPredicate)
+      : OpRewritePattern<linalg::MatmulOp>(context),
+        targetPredicate(targetPredicate) {}
+
+  LogicalResult matchAndRewrite(linalg::MatmulOp op,
+                                PatternRewriter &rewriter) const override {
+    if (targetPredicate &&
+        !targetPredicate(IREE::HAL::ExecutableTargetAttr::lookup(op))) {
+      return failure();
+    }
+    FailureOr<IREE::Codegen::UKernelOpInterface> ukernelOp =
+        matchMatmulDAGForUKernel(rewriter, op);
+    if (failed(ukernelOp)) {
+      return rewriter.notifyMatchFailure(
+          op, "failed to find microkernel op to replace with");
+    }
+    rewriter.replaceOp(op, ukernelOp.value()->getResults());
+    return success();
+  }
+
+  TargetPredicate targetPredicate;
+};
+
 struct GPULowerToUKernelsPass final
     : impl::GPULowerToUKernelsPassBase<GPULowerToUKernelsPass> {
   void runOnOperation() override {
@@ -175,6 +235,9 @@ struct GPULowerToUKernelsPass final
     // microkernels performance, and that consideration overrides the benefit of
     // fusions for these ops.
     patterns.insert<LowerArgmaxToUKernelPattern>(context, isROCMBackend);
+    // The matmul ukernel is only selected for shapes and chips where it is
+    // known to beat codegen; see getRocmMatmulUkernelTypeSuffix.
+    patterns.insert<LowerMatmulToUKernelPattern>(context, isROCMBackend);
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
@@ -0,0 +1,184 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Codegen/Common/EncodingUtils.h"
+#include "iree/compiler/Codegen/Common/GPU/Passes.h"
+#include "iree/compiler/Codegen/Dialect/GPU/IR/IREEGPUAttrs.h"
+#include "iree/compiler/Codegen/Utils/GPUUtils.h"
+#include "iree/compiler/Dialect/Encoding/IR/EncodingOps.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/Dialect/MemRef/Transforms/Transforms.h"
+#include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/Dialect/Tensor/Transforms/Transforms.h"
+#include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/GreedyPatternRewriteDriver.h"
+
+#define DEBUG_TYPE "iree-codegen-gpu-materialize-device-encoding"
+
+namespace mlir::iree_compiler {
+
+#define GEN_PASS_DEF_GPUMATERIALIZEDEVICEENCODINGPASS
+#include "iree/compiler/Codegen/Common/GPU/Passes.h.inc"
+
+using IREE::HAL::ExecutableTargetAttr;
+
+/// Returns the tile of the MMA intrinsic supported by |targetAttr| that best
+/// matches a matmul on |elementTypes|. Tiled tensors then hold whole operand
+/// fragments of the intrinsic contiguously so that kernels can load them
+/// without reshuffling through shared memory. Narrow matmuls that would only
+/// fill part of a fragment are not tiled.
+static FailureOr<TileMxNxK>
+chooseMatmulTile(ExecutableTargetAttr targetAttr, TypeRange elementTypes,
+                 int64_t matmulNarrowM, int64_t matmulNarrowN,
+                 ArrayRef<int64_t> hostDefinedUpperBound) {
+  FailureOr<ArrayAttr> mmaKinds =
+      getSupportedMmaTypes(targetAttr.getConfiguration());
+  if (failed(mmaKinds)) {
+    return failure();
+  }
+  std::optional<TileMxNxK> bestTile;
+  for (auto mmaAttr : mmaKinds->getAsRange<IREE::GPU::MMAAttr>()) {
+    auto [aType, bType, cType] = mmaAttr.getABCElementTypes();
+    if (aType != elementTypes[0] || bType != elementTypes[1] ||
+        cType != elementTypes[2]) {
+      continue;
+    }
+    auto [m, n, k] = mmaAttr.getMNKShape();
+    if ((matmulNarrowM && matmulNarrowM < m) ||
+        (matmulNarrowN && matmulNarrowN < n)) {
+      continue;
+    }
+    if (!hostDefinedUpperBound.empty() &&
+        (m > hostDefinedUpperBound[0] || n > hostDefinedUpperBound[1] ||
+         k > hostDefinedUpperBound[2])) {
+      continue;
+    }
+    // Larger fragments take fewer instructions per tile; on ties keep the
+    // intrinsic the target lists first.
+    if (!bestTile || bestTile->M * bestTile->N * bestTile->K < m * n * k) {
+      bestTile = TileMxNxK{m, n, k};
+    }
+  }
+  if (!bestTile) {
+    return failure();
+  }
+  LLVM_DEBUG(llvm::dbgs() << "[" << DEBUG_TYPE << "]: chose tile ("
+                          << bestTile->M << ", " << bestTile->N << ", "
+                          << bestTile->K << ")\n");
+  return *bestTile;
+}
+
+static FailureOr<MaterializeEncodingInfo>
+materializeEncodingForTarget(RankedTensorType tensorType,
+                             ExecutableTargetAttr targetAttr) {
+  auto encoding =
+      dyn_cast_or_null<IREE::Encoding::EncodingAttr>(tensorType.getEncoding());
+  if (!encoding) {
+    return failure();
+  }
+  // Only plain and batch matmuls map onto a single intrinsic for now.
+  auto cDims = IREE::Encoding::getEncodingContractionDims(encoding);
+  if (failed(cDims) || cDims->batch.size() > 1 || cDims->m.size() != 1 ||
+      cDims->n.size() != 1 || cDims->k.size() != 1) {
+    return failure();
+  }
+  auto elementTypes = llvm::to_vector(
+      llvm::map_range(encoding.getElementTypes().getValue(), [](Attribute a) {
+        return cast<TypeAttr>(a).getValue();
+      }));
+  FailureOr<TileMxNxK> tile = chooseMatmulTile(
+      targetAttr, elementTypes, getIntOrZero(encoding.getMatmulNarrow_M()),
+      getIntOrZero(encoding.getMatmulNarrow_N()),
+      encoding.getRoundDimsToArray());
+  if (failed(tile)) {
+    return failure();
+  }
+  return getEncodingInfoForMatmul(encoding, tensorType.getRank(), *tile);
+}
+
+namespace {
+
+struct GPUMaterializeDeviceEncodingPass final
+    : impl::GPUMaterializeDeviceEncodingPassBase<
+          GPUMaterializeDeviceEncodingPass> {
+  GPUMaterializeDeviceEncodingPass() = default;
+  explicit GPUMaterializeDeviceEncodingPass(ExecutableTargetAttr attr)
+      : targetAttr(attr) {}
+  void getDependentDialects(DialectRegistry &registry) const override {
+    registry.insert<arith::ArithDialect, linalg::LinalgDialect,
+                    tensor::TensorDialect>();
+  }
+  void runOnOperation() override;
+
+private:
+  ExecutableTargetAttr targetAttr;
+};
+
+} // namespace
+
+void GPUMaterializeDeviceEncodingPass::runOnOperation() {
+  MLIRContext *context = &getContext();
+  FunctionOpInterface funcOp = getOperation();
+  if (!targetAttr) {
+    targetAttr = ExecutableTargetAttr::lookup(funcOp);
+  }
+
+  // Encodings the target has no intrinsic for fall back to their original
+  // layout, the same as when materializing them into nops.
+  MaterializeEncodingFn materializeEncodingFn =
+      [targetAttr = targetAttr](
+          RankedTensorType tensorType) -> FailureOr<MaterializeEncodingInfo> {
+    if (!targetAttr) {
+      return failure();
+    }
+    return materializeEncodingForTarget(tensorType, targetAttr);
+  };
+
+  {
+    RewritePatternSet patterns(context);
+    MaterializeEncodingTypeConverter typeConverter(materializeEncodingFn);
+    MaterializeEncodingConversionTarget target(*context);
+    populateMaterializeEncodingIntoPackUnPackPatterns(
+        patterns, target, typeConverter,
+        /*materializeEncodingValueFn=*/{});
+    if (failed(applyPartialConversion(funcOp, target, std::move(patterns)))) {
+      funcOp.emitOpError("materialization failed");
+      return signalPassFailure();
+    }
+  }
+
+  {
+    RewritePatternSet patterns(context);
+    populateMaterializeUpperBoundTileSizePatterns(patterns,
+                                                  materializeEncodingFn);
+    if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
+      funcOp.emitOpError(
+          "encoding padding sizes materialization pattern failed");
+      return signalPassFailure();
+    }
+  }
+
+  // Fold pack/unpack ops with pad/extract_slice ops and resolve dims ops.
+  {
+    RewritePatternSet patterns(context);
+    tensor::populateFoldIntoPackAndUnpackPatterns(patterns);
+    memref::populateResolveRankedShapedTypeResultDimsPatterns(patterns);
+    if (failed(applyPatternsAndFoldGreedily(funcOp, std::move(patterns)))) {
+      funcOp.emitOpError("folding patterns failed");
+      return signalPassFailure();
+    }
+  }
+}
+
+std::unique_ptr<InterfacePass<FunctionOpInterface>>
+createGPUMaterializeDeviceEncodingPass(ExecutableTargetAttr targetAttr) {
+  return std::make_unique<GPUMaterializeDeviceEncodingPass>(targetAttr);
+}
+
+} // namespace mlir::iree_compiler
@@ -16,6 +16,8 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Affine/Utils.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Utils/IndexingUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/AffineExpr.h"
@@ -416,22 +418,46 @@ static int64_t getShuffleWidth(NestedLayoutAttr layout, int64_t dim) {
   return layout.getThreadsPerOuter()[dim];
 }
 
-/// The lowering for multi_reduction is done in two steps:
+/// Returns the identity of |kind| for kinds where combining a value more than
+/// once changes the result (e.g. add), or nullptr for idempotent kinds (e.g.
+/// max) where that is harmless.
+static TypedAttr getNonIdempotentIdentityAttr(Builder &builder,
+                                              vector::CombiningKind kind,
+                                              Type elementType) {
+  switch (kind) {
+  case vector::CombiningKind::ADD:
+  case vector::CombiningKind::XOR:
+    return builder.getZeroAttr(elementType);
+  case vector::CombiningKind::MUL:
+    if (isa<FloatType>(elementType))
+      return builder.getFloatAttr(elementType, 1.0);
+    return builder.getIntegerAttr(elementType, 1);
+  default:
+    return nullptr;
+  }
+}
+
+/// The lowering for multi_reduction is done in three steps:
 ///   1. Local Reduce: Each thread reduces all elements carried by it along
 ///      the reduction dimensions. This is the batch, outer and element dims.
 ///   2. Thread Reduce: Each thread reduces result of step 1 across threads
 ///      by doing a butterfly shuffle.
+///   3. Subgroup Reduce: If the reduction dimensions are distributed over
+///      multiple subgroups, each subgroup writes the result of step 2 to
+///      shared memory and every thread combines the partial results of all
+///      subgroups after a barrier.
 ///
-/// Currently, reduction across warps is not supported, but it would just add
-/// another step, Warp Reduce, where threads do an atomic addition on a buffer.
+/// For kinds like add where combining the accumulator more than once is wrong,
+/// steps 1-3 start from the identity and the accumulator is combined last.
 struct DistributeMultiReduction final
     : OpDistributionPattern<vector::MultiDimReductionOp> {
   using OpDistributionPattern::OpDistributionPattern;
 
-  DistributeMultiReduction(MLIRContext *context, int64_t subgroupSize,
-                           int64_t maxBitsPerShuffle, int64_t benefit = 1)
-      : OpDistributionPattern(context, benefit), subgroupSize(subgroupSize),
-        maxBitsPerShuffle(maxBitsPerShuffle) {}
+  DistributeMultiReduction(MLIRContext *context, Value threadId,
+                           int64_t subgroupSize, int64_t maxBitsPerShuffle,
+                           int64_t benefit = 1)
+      : OpDistributionPattern(context, benefit), threadId(threadId),
+        subgroupSize(subgroupSize), maxBitsPerShuffle(maxBitsPerShuffle) {}
 
   LogicalResult matchAndRewrite(vector::MultiDimReductionOp multiReduceOp,
                                 DistributionSignature &signature,
@@ -449,7 +475,8 @@ struct DistributeMultiReduction final
     }
 
     auto srcLayout = dyn_cast_or_null<NestedLayoutAttr>(signature[srcVector]);
-    if (!srcLayout) {
+    auto resLayout = dyn_cast_or_null<NestedLayoutAttr>(signature[resVector]);
+    if (!srcLayout || !resLayout) {
       return rewriter.notifyMatchFailure(multiReduceOp,
                                          "expected nested layout attr");
     }
@@ -471,6 +498,30 @@ struct DistributeMultiReduction final
 
     SmallVector<bool> reducedDims = multiReduceOp.getReductionMask();
     int64_t rank = srcVector.getType().getRank();
+    vector::CombiningKind kind = multiReduceOp.getKind();
+
+    bool needsSubgroupReduction = false;
+    for (auto [dim, reduced] : llvm::enumerate(reducedDims)) {
+      if (reduced && srcLayout.getSubgroupsPerWorkgroup()[dim] > 1)
+        needsSubgroupReduction = true;
+    }
+    bool needsThreadReduction = false;
+    for (auto [dim, reduced] : llvm::enumerate(reducedDims)) {
+      if (reduced && srcLayout.getThreadsPerOuter()[dim] > 1)
+        needsThreadReduction = true;
+    }
+
+    // The accumulator is replicated across all threads taking part in the
+    // reduction, so only fold it into the per-thread reduction if doing so
+    // repeatedly is harmless.
+    Value localAcc = disAcc;
+    TypedAttr identityAttr =
+        getNonIdempotentIdentityAttr(rewriter, kind, elemTy);
+    if (identityAttr && (needsThreadReduction || needsSubgroupReduction)) {
+      localAcc = rewriter.create<arith::ConstantOp>(
+          loc, DenseElementsAttr::get(disAcc.getType(),
+                                      ArrayRef<Attribute>{identityAttr}));
+    }
 
     // Do thread local reduce.
 
@@ -483,7 +534,7 @@ struct DistributeMultiReduction final
     }
 
     auto localReduction = rewriter.create<vector::MultiDimReductionOp>(
-        loc, disSrc, disAcc, distributedReductionMask, multiReduceOp.getKind());
+        loc, disSrc, localAcc, distributedReductionMask, kind);
     auto locallyReduced = dyn_cast<VectorValue>(localReduction.getResult());
 
     assert(locallyReduced && "result should have been a vector");
@@ -496,17 +547,27 @@ struct DistributeMultiReduction final
     VectorValue flat =
         rewriter.create<vector::ShapeCastOp>(loc, flatVecType, locallyReduced);
 
-    FailureOr<VectorValue> threadReduced = doThreadReduction(
-        rewriter, srcLayout, flat, multiReduceOp.getKind(), reducedDims);
+    FailureOr<VectorValue> threadReduced =
+        doThreadReduction(rewriter, srcLayout, flat, kind, reducedDims);
     if (failed(threadReduced)) {
       return failure();
     }
 
     VectorValue unflattened = rewriter.create<vector::ShapeCastOp>(
         loc, shaped, threadReduced.value());
+
+    if (needsSubgroupReduction) {
+      unflattened = doSubgroupReduction(rewriter, loc, srcLayout, resLayout,
+                                        resVector.getType(), unflattened, kind,
+                                        reducedDims);
+    }
+    if (localAcc != disAcc) {
+      unflattened = cast<VectorValue>(makeArithReduction(
+          rewriter, loc, kind, unflattened, disAcc, nullptr, nullptr));
+    }
     replaceOpWithDistributedValues(rewriter, multiReduceOp, unflattened);
 
-    return failure();
+    return success();
   }
 
   FailureOr<VectorValue> doThreadReduction(RewriterBase &rewriter,
@@ -558,6 +619,115 @@ struct DistributeMultiReduction final
     return val;
   }
 
+  /// Combines the per-subgroup partial results in |partial|, distributed with
+  /// |resLayout|, across the subgroups that the reduced dimensions of
+  /// |srcLayout| are distributed over. Each subgroup writes its partial result
+  /// to its own slot of a shared memory buffer holding the whole reduced
+  /// vector of type |resType|. After a barrier, every thread reads back all
+  /// partial results for the elements it owns and combines them as a tree.
+  VectorValue doSubgroupReduction(RewriterBase &rewriter, Location loc,
+                                  NestedLayoutAttr srcLayout,
+                                  NestedLayoutAttr resLayout,
+                                  VectorType resType, VectorValue partial,
+                                  vector::CombiningKind kind,
+                                  ArrayRef<bool> reductionMask) const {
+    SmallVector<Value> srcWarpIndices, srcThreadIndices;
+    populateWarpAndThreadIndices(rewriter, threadId, srcLayout, srcWarpIndices,
+                                 srcThreadIndices);
+    SmallVector<Value> resWarpIndices, resThreadIndices;
+    populateWarpAndThreadIndices(rewriter, threadId, resLayout, resWarpIndices,
+                                 resThreadIndices);
+
+    // The slot of a subgroup is its linearized position along the reduced
+    // dimensions.
+    SmallVector<OpFoldResult> slotIds;
+    SmallVector<int64_t> slotSizes;
+    for (auto [dim, reduced] : llvm::enumerate(reductionMask)) {
+      int64_t subgroupCount = srcLayout.getSubgroupsPerWorkgroup()[dim];
+      if (reduced && subgroupCount > 1) {
+        slotIds.push_back(srcWarpIndices[dim]);
+        slotSizes.push_back(subgroupCount);
+      }
+    }
+    int64_t numSlots = ShapedType::getNumElements(slotSizes);
+    Value zero = rewriter.create<arith::ConstantIndexOp>(loc, 0);
+    Value slot = linearizeIndex(rewriter, zero, slotIds, slotSizes,
+                                /*elementCount=*/1);
+
+    SmallVector<int64_t> bufferShape = {numSlots};
+    llvm::append_range(bufferShape, resType.getShape());
+    auto addressSpaceAttr = gpu::AddressSpaceAttr::get(
+        rewriter.getContext(), gpu::GPUDialect::getWorkgroupAddressSpace());
+    auto bufferType =
+        MemRefType::get(bufferShape, resType.getElementType(),
+                        MemRefLayoutAttrInterface{}, addressSpaceAttr);
+    Value buffer = rewriter.create<memref::AllocOp>(loc, bufferType);
+
+    int64_t resRank = resLayout.getRank();
+    SmallVector<int64_t> distShape = resLayout.getDistributedShape();
+    SmallVector<int64_t> tileShape = getElementVectorTileShape(resLayout);
+    auto innerVectorType = VectorType::get(resLayout.getElementsPerThread(),
+                                           resType.getElementType());
+    SmallVector<Value> baseIndices(resRank, zero);
+    AffineMap identityMap = rewriter.getMultiDimIdentityMap(resRank);
+    SmallVector<bool> inBounds(resRank, true);
+    auto getBufferIndices = [&](Value slotIndex, ArrayRef<int64_t> offsets) {
+      SmallVector<Value> indices = {slotIndex};
+      llvm::append_range(indices, getTransferIndicesFromNestedLayout(
+                                      rewriter, baseIndices, offsets,
+                                      resLayout, identityMap, resWarpIndices,
+                                      resThreadIndices));
+      return indices;
+    };
+
+    // Threads that only differ along the reduced dimensions hold the same
+    // values after the thread reduction, so their writes are redundant but
+    // benign.
+    for (SmallVector<int64_t> offsets :
+         StaticTileOffsetRange(distShape, tileShape)) {
+      ArrayRef<int64_t> offsetArray(offsets);
+      Value slice = rewriter.create<vector::ExtractOp>(
+          loc, partial, offsetArray.take_front(resRank * 2));
+      rewriter.create<vector::TransferWriteOp>(
+          loc, slice, buffer, getBufferIndices(slot, offsets), inBounds);
+    }
+    rewriter.create<gpu::BarrierOp>(loc);
+
+    SmallVector<Value> partials;
+    SmallVector<int64_t> strides(resRank, 1);
+    for (int64_t i = 0; i < numSlots; ++i) {
+      Value slotIndex = rewriter.create<arith::ConstantIndexOp>(loc, i);
+      Value acc = rewriter.create<arith::ConstantOp>(
+          loc, partial.getType(), rewriter.getZeroAttr(partial.getType()));
+      for (SmallVector<int64_t> offsets :
+           StaticTileOffsetRange(distShape, tileShape)) {
+        Value slice = rewriter.create<vector::TransferReadOp>(
+            loc, innerVectorType, buffer, getBufferIndices(slotIndex, offsets),
+            inBounds);
+        acc = rewriter.create<vector::InsertStridedSliceOp>(loc, slice, acc,
+                                                            offsets, strides);
+      }
+      partials.push_back(acc);
+    }
+    // Make sure all reads are done before the buffer can be written again,
+    // e.g. by the next iteration of an enclosing loop.
+    rewriter.create<gpu::BarrierOp>(loc);
+
+    while (partials.size() > 1) {
+      SmallVector<Value> combined;
+      for (size_t i = 0; i + 1 < partials.size(); i += 2) {
+        combined.push_back(makeArithReduction(rewriter, loc, kind, partials[i],
+                                              partials[i + 1], nullptr,
+                                              nullptr));
+      }
+      if (partials.size() % 2 != 0)
+        combined.push_back(partials.back());
+      partials = std::move(combined);
+    }
+    return cast<VectorValue>(partials.front());
+  }
+
+  Value threadId;
   int64_t subgroupSize;
   int64_t maxBitsPerShuffle;
 };
@@ -625,8 +795,8 @@ void populateGPUDistributeNestedLayoutAttrPatterns(RewritePatternSet &patterns,
   patterns.add<DistributeTransferRead, DistributeTransferWrite>(
       patterns.getContext(), threadId);
   patterns.add<DistributeBroadcast, DistributeTranspose>(patterns.getContext());
-  patterns.add<DistributeMultiReduction>(patterns.getContext(), subgroupSize,
-                                         maxBitsPerShuffle);
+  patterns.add<DistributeMultiReduction>(patterns.getContext(), threadId,
+                                         subgroupSize, maxBitsPerShuffle);
 }
 
 }; // namespace mlir::iree_compiler
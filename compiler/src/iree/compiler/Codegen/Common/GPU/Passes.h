@@ -9,6 +9,7 @@
 #define IREE_COMPILER_CODEGEN_COMMON_GPU_PASSES_H_
 
 #include <cstdint>
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/Interfaces/FunctionInterfaces.h"
 #include "mlir/Pass/Pass.h"
@@ -90,6 +91,12 @@ createGPUCheckResourceUsagePass(
     std::function<unsigned(mlir::FunctionOpInterface)> getIndexBitwidth =
         nullptr);
 
+/// Materializes encodings into tiled layouts matching the MMA intrinsics of
+/// `targetAttr`, or of the enclosing executable target if null.
+std::unique_ptr<InterfacePass<FunctionOpInterface>>
+createGPUMaterializeDeviceEncodingPass(
+    IREE::HAL::ExecutableTargetAttr targetAttr = nullptr);
+
 // Creates a pass to create allocations for some tensor values to use GPU
 // shared memory.
 std::unique_ptr<InterfacePass<mlir::FunctionOpInterface>>
@@ -280,3 +280,65 @@ func.func @argmax_ukernel_unsupported_arch(%arg0 : tensor<1x?xf32>) -> tensor<1x
 //      CHECK: func @argmax_ukernel_unsupported_arch(
 //      CHECK-NOT: iree_codegen.ukernel.generic
 //      CHECK: linalg.generic
+
+// -----
+
+func.func @matmul_f16f16f32(%lhs : tensor<32x64xf16>, %rhs : tensor<64x32xf16>) -> tensor<32x32xf32> attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {target_arch = "gfx940", ukernels = "matmul"}>
+} {
+  %cst = arith.constant 0.0 : f32
+  %0 = tensor.empty() : tensor<32x32xf32>
+  %1 = linalg.fill ins(%cst : f32) outs(%0 : tensor<32x32xf32>) -> tensor<32x32xf32>
+  %2 = linalg.matmul ins(%lhs, %rhs : tensor<32x64xf16>, tensor<64x32xf16>) outs(%1 : tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %2 : tensor<32x32xf32>
+}
+
+//      CHECK: func @matmul_f16f16f32(
+// CHECK-SAME:     %[[LHS:[a-zA-Z0-9]+]]: tensor<32x64xf16>
+// CHECK-SAME:     %[[RHS:[a-zA-Z0-9]+]]: tensor<64x32xf16>
+//  CHECK-DAG:   %[[C32:.+]] = arith.constant 32 : index
+//  CHECK-DAG:   %[[C64:.+]] = arith.constant 64 : index
+//      CHECK:   %[[FILL:.+]] = linalg.fill
+//      CHECK:   %[[MICRO_KERNEL:.+]] = iree_codegen.ukernel.generic "__iree_uk_rocm_matmul_F16F16F32"
+// CHECK-SAME:       ins(%[[LHS]], %[[RHS]] :
+// CHECK-SAME:       outs(%[[FILL]] :
+// CHECK-SAME:       (%[[C32]], %[[C32]], %[[C64]] :
+// CHECK-SAME:       strided_outer_dims(1)
+//      CHECK:   return %[[MICRO_KERNEL]]
+
+// -----
+
+func.func @matmul_bf16bf16f32(%lhs : tensor<16x16xbf16>, %rhs : tensor<16x16xbf16>, %init : tensor<16x16xf32>) -> tensor<16x16xf32> attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {target_arch = "gfx90a", ukernels = "all"}>
+} {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<16x16xbf16>, tensor<16x16xbf16>) outs(%init : tensor<16x16xf32>) -> tensor<16x16xf32>
+  return %0 : tensor<16x16xf32>
+}
+
+// CHECK-LABEL: func @matmul_bf16bf16f32(
+//       CHECK:   iree_codegen.ukernel.generic "__iree_uk_rocm_matmul_BF16BF16F32"
+
+// -----
+
+// Tests that shapes the MFMA tile does not divide and chips without MFMA
+// instructions are left to codegen.
+
+func.func @matmul_unaligned(%lhs : tensor<32x60xf16>, %rhs : tensor<60x32xf16>, %init : tensor<32x32xf32>) -> tensor<32x32xf32> attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {target_arch = "gfx940", ukernels = "all"}>
+} {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<32x60xf16>, tensor<60x32xf16>) outs(%init : tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %0 : tensor<32x32xf32>
+}
+func.func @matmul_no_mfma(%lhs : tensor<32x64xf16>, %rhs : tensor<64x32xf16>, %init : tensor<32x32xf32>) -> tensor<32x32xf32> attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {target_arch = "gfx1100", ukernels = "all"}>
+} {
+  %0 = linalg.matmul ins(%lhs, %rhs : tensor<32x64xf16>, tensor<64x32xf16>) outs(%init : tensor<32x32xf32>) -> tensor<32x32xf32>
+  return %0 : tensor<32x32xf32>
+}
+
+// CHECK-LABEL: func @matmul_unaligned(
+//   CHECK-NOT:   iree_codegen.ukernel.generic
+//       CHECK:   linalg.matmul
+// CHECK-LABEL: func @matmul_no_mfma(
+//   CHECK-NOT:   iree_codegen.ukernel.generic
+//       CHECK:   linalg.matmul
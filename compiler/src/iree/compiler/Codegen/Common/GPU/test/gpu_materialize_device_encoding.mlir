@@ -0,0 +1,76 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-gpu-materialize-device-encoding),canonicalize,cse)" --split-input-file %s | FileCheck %s
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+#encoding = #iree_encoding.encoding<role = LHS, element_types = [f16, f16, f32], original_type = tensor<255x513xf16>, user_indexing_maps = [#map, #map1, #map2]>
+func.func @set_encoding_LHS() attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {mma_intrinsics = [#iree_gpu.mma_layout<MFMA_F16_16x16x16_F32>, #iree_gpu.mma_layout<MFMA_F16_32x32x8_F32>]}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<255x513xf16>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<255x513xf16, #encoding>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [255, 513], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<255x513xf16>> -> tensor<255x513xf16>
+  %3 = iree_encoding.set_encoding %2 : tensor<255x513xf16> -> tensor<255x513xf16, #encoding>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [255, 513], strides = [1, 1] : tensor<255x513xf16, #encoding> -> !flow.dispatch.tensor<writeonly:tensor<255x513xf16, #encoding>>
+  return
+}
+// Tests that the LHS is packed into fragments of the largest intrinsic.
+// CHECK-LABEL: func.func @set_encoding_LHS
+// CHECK-DAG:     %[[PAD:.+]] = arith.constant 0.000000e+00 : f16
+// CHECK-DAG:     %[[OUT_BINDING:.+]] = hal.interface.binding.subspan {{.+}} : !flow.dispatch.tensor<writeonly:tensor<8x65x32x8xf16>>
+// CHECK:         %[[SRC:.+]] = flow.dispatch.tensor.load
+// CHECK:         %[[PACK:.+]] = tensor.pack %[[SRC]] padding_value(%[[PAD]] : f16)
+// CHECK-SAME:      outer_dims_perm = [0, 1]
+// CHECK-SAME:      inner_dims_pos = [0, 1]
+// CHECK-SAME:      inner_tiles = [32, 8]
+// CHECK-SAME:      : tensor<255x513xf16> -> tensor<8x65x32x8xf16>
+// CHECK:         flow.dispatch.tensor.store %[[PACK]], %[[OUT_BINDING]]
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+#encoding = #iree_encoding.encoding<role = RHS, element_types = [f16, f16, f32], original_type = tensor<513x255xf16>, user_indexing_maps = [#map, #map1, #map2]>
+func.func @set_encoding_RHS() attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {mma_intrinsics = [#iree_gpu.mma_layout<WMMA_F16_16x16x16_F32>]}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<513x255xf16>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<513x255xf16, #encoding>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [513, 255], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<513x255xf16>> -> tensor<513x255xf16>
+  %3 = iree_encoding.set_encoding %2 : tensor<513x255xf16> -> tensor<513x255xf16, #encoding>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [513, 255], strides = [1, 1] : tensor<513x255xf16, #encoding> -> !flow.dispatch.tensor<writeonly:tensor<513x255xf16, #encoding>>
+  return
+}
+// Tests that the RHS is transposed so that each fragment is contiguous along K.
+// CHECK-LABEL: func.func @set_encoding_RHS
+// CHECK:         tensor.pack
+// CHECK-SAME:      outer_dims_perm = [1, 0]
+// CHECK-SAME:      inner_dims_pos = [1, 0]
+// CHECK-SAME:      inner_tiles = [16, 16]
+// CHECK-SAME:      : tensor<513x255xf16> -> tensor<16x33x16x16xf16>
+
+// -----
+
+#map = affine_map<(d0, d1, d2) -> (d0, d2)>
+#map1 = affine_map<(d0, d1, d2) -> (d2, d1)>
+#map2 = affine_map<(d0, d1, d2) -> (d0, d1)>
+#encoding = #iree_encoding.encoding<role = LHS, element_types = [f16, f16, f32], original_type = tensor<1x513xf16>, matmul_narrow_M = 1 : index, user_indexing_maps = [#map, #map1, #map2]>
+func.func @set_encoding_narrow_LHS() attributes {
+  hal.executable.target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {mma_intrinsics = [#iree_gpu.mma_layout<MFMA_F16_16x16x16_F32>]}>
+} {
+  %c0 = arith.constant 0 : index
+  %0 = hal.interface.binding.subspan set(0) binding(0) type(storage_buffer) alignment(64) offset(%c0) flags(ReadOnly) : !flow.dispatch.tensor<readonly:tensor<1x513xf16>>
+  %1 = hal.interface.binding.subspan set(0) binding(1) type(storage_buffer) alignment(64) offset(%c0) : !flow.dispatch.tensor<writeonly:tensor<1x513xf16, #encoding>>
+  %2 = flow.dispatch.tensor.load %0, offsets = [0, 0], sizes = [1, 513], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<1x513xf16>> -> tensor<1x513xf16>
+  %3 = iree_encoding.set_encoding %2 : tensor<1x513xf16> -> tensor<1x513xf16, #encoding>
+  flow.dispatch.tensor.store %3, %1, offsets = [0, 0], sizes = [1, 513], strides = [1, 1] : tensor<1x513xf16, #encoding> -> !flow.dispatch.tensor<writeonly:tensor<1x513xf16, #encoding>>
+  return
+}
+// Tests that matmuls too narrow to fill a fragment keep their layout.
+// CHECK-LABEL: func.func @set_encoding_narrow_LHS
+// CHECK:         hal.interface.binding.subspan {{.+}} : !flow.dispatch.tensor<writeonly:tensor<1x513xf16>>
+// CHECK-NOT:     tensor.pack
+// CHECK:         return
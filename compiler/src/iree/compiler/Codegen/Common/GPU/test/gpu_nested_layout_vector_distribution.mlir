@@ -1029,3 +1029,53 @@ builtin.module attributes { transform.with_named_sequence } {
 // CHECK: vector.multi_reduction <maximumf>, %{{.*}}, %{{.*}} [1, 3, 5] : vector<1x4x1x1x1x4xf32> to vector<1x1x1xf32>
 // Global reduction
 // CHECK: gpu.shuffle  xor %{{.*}}, %[[C32]], %[[C64]] : f32
+
+// -----
+
+#nested = #iree_vector_ext.nested_layout<
+  // The reduced dim=1 is distributed over 2 subgroups, so partial results
+  // are combined through shared memory after the thread reduction.
+  subgroups_per_workgroup = [1, 2],
+  batches_per_subgroup    = [1, 2],
+  outers_per_batch        = [1, 1],
+  threads_per_outer       = [1, 64],
+  elements_per_thread     = [1, 2],
+
+  subgroup_basis          = [1, 2],
+  thread_basis            = [1, 64]
+>
+
+func.func @reduction_across_subgroups(%arg0: vector<1x512xf32>, %arg1: vector<1xf32>) -> vector<1xf32> {
+  %0 = vector.multi_reduction <add>, %arg0, %arg1
+  {
+    __vector_layout_test_anchor_operand_0 = #nested
+  } [1] : vector<1x512xf32> to vector<1xf32>
+  return %0 : vector<1xf32>
+}
+
+builtin.module attributes { transform.with_named_sequence } {
+  transform.named_sequence @__transform_main(%variant_op: !transform.any_op {transform.readonly}) {
+    %top_level_func = transform.structured.match ops{["func.func"]} in %variant_op : (!transform.any_op) -> !transform.any_op
+    transform.iree.test_gpu_vector_distribution %top_level_func : !transform.any_op
+    transform.yield
+  }
+}
+
+// CHECK-LABEL: func @reduction_across_subgroups
+// CHECK-DAG: %[[ZERO:.*]] = arith.constant dense<0.000000e+00> : vector<1x1x1xf32>
+// CHECK-DAG: %[[DARG1:.*]] = iree_vector_ext.to_simt %{{.*}} : vector<1xf32> -> vector<1x1x1xf32>
+// Local reduction starts from the identity as the accumulator must only be
+// added once.
+// CHECK: vector.multi_reduction <add>, %{{.*}}, %[[ZERO]] [1, 3, 5] : vector<1x2x1x1x1x2xf32> to vector<1x1x1xf32>
+// Thread reduction
+// CHECK: gpu.shuffle  xor
+// Subgroup reduction
+// CHECK: %[[ALLOC:.*]] = memref.alloc() : memref<2x1xf32, #gpu.address_space<workgroup>>
+// CHECK: vector.transfer_write %{{.*}}, %[[ALLOC]]
+// CHECK: gpu.barrier
+// CHECK: vector.transfer_read %[[ALLOC]]
+// CHECK: vector.transfer_read %[[ALLOC]]
+// CHECK: gpu.barrier
+// CHECK: %[[SUM:.*]] = arith.addf
+// CHECK: arith.addf %[[SUM]], %[[DARG1]]
+// CHECK: iree_vector_ext.to_simd %{{.*}} : vector<1x1x1xf32> -> vector<1xf32>
@@ -38,9 +38,12 @@ static std::optional<VectorizationTileSizes> inferSizesFromIR(Value val);
 
 /// Tries to infer the vector sizes from an IR using ValueBounds analysis. If
 /// `opResult` is provided, it stores the bounded result shapes to destShape.
-/// Returns std::nullopt if vector sizes can't be inferred.
+/// Dimensions without a constant upper bound use their size in
+/// `tileSizeBounds`, if non-zero. Returns std::nullopt if vector sizes can't be
+/// inferred.
 static std::optional<VectorizationTileSizes>
-inferSizesFromIR(linalg::LinalgOp linalgOp, std::optional<OpResult> opResult) {
+inferSizesFromIR(linalg::LinalgOp linalgOp, std::optional<OpResult> opResult,
+                 ArrayRef<int64_t> tileSizeBounds = {}) {
   LLVM_DEBUG(VEC_DBGS() << "Inferring sizes for:\n"
                         << linalgOp << " with OpResult.resultNumber="
                         << opResult->getResultNumber() << "\n");
@@ -85,7 +88,13 @@ inferSizesFromIR(linalg::LinalgOp linalgOp, std::optional<OpResult> opResult) {
     }
 
     if (failed(maybeDimBound)) {
-      return std::nullopt;
+      if (dim >= tileSizeBounds.size() || tileSizeBounds[dim] == 0) {
+        return std::nullopt;
+      }
+      // The analysis can't always see through the bounds of the tiled loops
+      // when the problem size is dynamic but the tile is never larger than its
+      // tile size. Masking covers the partial tiles.
+      maybeDimBound = tileSizeBounds[dim];
     }
 
     dimSize = maybeDimBound.value();
@@ -230,7 +239,8 @@ static std::optional<VectorizationTileSizes> inferSizesFromIR(Value val) {
 // Returns the vector sizes from the local lowering config or try to infer them
 // from the tensor shapes and tiled loops in the IR.
 static std::optional<SizesAndScalableFlags>
-getVectorSizes(Operation *op, bool useConfiguredVectorSizes) {
+getVectorSizes(Operation *op, bool useConfiguredVectorSizes,
+               bool boundDynamicDimsByConfig) {
   // Get vector sizes from the lowering config, if available in the op itself.
   IREE::Codegen::LoweringConfigAttr loweringConfig = getLoweringConfig(op);
   if (useConfiguredVectorSizes && loweringConfig) {
@@ -245,8 +255,20 @@ getVectorSizes(Operation *op, bool useConfiguredVectorSizes) {
   std::optional<SmallVector<int64_t>> vectorSizes;
   TypeSwitch<Operation *, void>(op)
       .Case<linalg::LinalgOp>([&](linalg::LinalgOp linalgOp) {
-        std::optional<VectorizationTileSizes> result =
-            inferSizesFromIR(linalgOp, /*opResult=*/std::nullopt);
+        // The configured vector tile sizes bound the dimensions that were
+        // tiled for vectorization. Scalable sizes can't be used as the
+        // inferred sizes are all fixed.
+        SmallVector<int64_t> tileSizeBounds;
+        if (boundDynamicDimsByConfig && loweringConfig) {
+          TilingConfig tilingConfig(loweringConfig);
+          auto [sizes, scalableFlags] = tilingConfig.getVectorTileSizes();
+          for (auto [size, isScalable] :
+               llvm::zip_equal(sizes, scalableFlags)) {
+            tileSizeBounds.push_back(isScalable ? 0 : size);
+          }
+        }
+        std::optional<VectorizationTileSizes> result = inferSizesFromIR(
+            linalgOp, /*opResult=*/std::nullopt, tileSizeBounds);
         if (result) {
           vectorSizes = result->vectorSizes;
         }
@@ -296,6 +318,7 @@ public:
   GenericVectorizationPass(const GenericVectorizationPassOptions &options) {
     this->enableVectorMasking.setValue(options.enableVectorMasking);
     this->useConfiguredVectorSizes.setValue(options.useConfiguredVectorSizes);
+    this->boundDynamicDimsByConfig.setValue(options.boundDynamicDimsByConfig);
     this->vectorizePadding.setValue(options.vectorizePadding);
     this->vectorizeGatherAccesses.setValue(options.vectorizeGatherAccesses);
     this->enableCleanup.setValue(options.enableCleanup);
@@ -337,7 +360,8 @@ void GenericVectorizationPass::runOnOperation() {
     SmallVector<bool> scalableVecDims;
     if (enableVectorMasking) {
       std::optional<SizesAndScalableFlags> vectorSizesAndScalableDims =
-          getVectorSizes(op, useConfiguredVectorSizes);
+          getVectorSizes(op, useConfiguredVectorSizes,
+                         boundDynamicDimsByConfig);
       if (vectorSizesAndScalableDims) {
         auto [sizes, scalableDims] = *vectorSizesAndScalableDims;
         vectorSizes.append(sizes.begin(), sizes.end());
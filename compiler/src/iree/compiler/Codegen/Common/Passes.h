@@ -164,6 +164,10 @@ struct GenericVectorizationPassOptions {
   // Controls whether the op lowering configuration (if present) should be used
   // to specify the masked vector sizes.
   bool useConfiguredVectorSizes = true;
+  // Controls whether the vector tile sizes of the op lowering configuration
+  // (if present) bound the dynamic dimensions that can't be inferred from the
+  // IR when not using them as the masked vector sizes.
+  bool boundDynamicDimsByConfig = false;
   bool vectorizePadding = false;
   bool vectorizeGatherAccesses = false;
   // The flag controls whether it touches the structure generated from tiling,
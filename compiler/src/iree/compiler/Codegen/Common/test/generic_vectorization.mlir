@@ -1,6 +1,7 @@
 // RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-generic-vectorization))" --split-input-file %s | FileCheck %s
 // RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-generic-vectorization{enable-vector-masking=true}))" --split-input-file %s | FileCheck %s -check-prefix=CHECK-MASK
 // RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-generic-vectorization{fold-cast-into-contract=true}))" --split-input-file %s | FileCheck %s -check-prefix=CHECK-FOLD
+// RUN: iree-opt --pass-pipeline="builtin.module(func.func(iree-codegen-generic-vectorization{enable-vector-masking=true use-configured-vector-sizes=false bound-dynamic-dims-by-config=true}))" --split-input-file %s | FileCheck %s -check-prefix=CHECK-BOUND
 
 func.func @matmul(%lhs: tensor<3x4xf16>, %rhs: tensor<4x5xf16>, %acc: tensor<3x5xf32>) -> tensor<3x5xf32> {
   %result = linalg.matmul ins(%lhs, %rhs: tensor<3x4xf16>, tensor<4x5xf16>) outs(%acc: tensor<3x5xf32>) -> tensor<3x5xf32>
@@ -366,3 +367,24 @@ func.func @generic_unpack_infer_vector_size(%arg0: tensor<?x?x16x16xf32>, %arg1:
 // CHECK-MASK:           %[[GENERIC_SRC:.+]] = vector.transfer_read %[[UNPACK_WRITE]]{{.+}}, %[[GENERIC_MASK]]
 // CHECK-MASK:           %[[EXP:.+]] = math.exp %[[GENERIC_SRC]]
 // CHECK-MASK:           vector.transfer_write %[[EXP]]{{.+}}, %[[GENERIC_MASK]]
+
+// -----
+
+#config = #iree_codegen.lowering_config<tile_sizes = [[64, 64], [8, 16], [0, 0]]>
+#map = affine_map<(d0, d1) -> (d0, d1)>
+func.func @dynamic_generic_bounded_by_config(%arg0: tensor<?x?xf32>, %arg1: tensor<?x?xf32>) -> tensor<?x?xf32> {
+  %0 = linalg.generic {indexing_maps = [#map, #map], iterator_types = ["parallel", "parallel"]} ins(%arg0 : tensor<?x?xf32>) outs(%arg1 : tensor<?x?xf32>) attrs = {lowering_config = #config} {
+  ^bb0(%in: f32, %out: f32):
+    %1 = math.exp %in : f32
+    linalg.yield %1 : f32
+  } -> tensor<?x?xf32>
+  return %0 : tensor<?x?xf32>
+}
+// The dimensions have no upper bound in the IR; the vector tile sizes are used
+// as the masked vector sizes instead of leaving the op scalar.
+// CHECK-BOUND-LABEL: func.func @dynamic_generic_bounded_by_config
+// CHECK-BOUND-SAME:    %[[SRC:[a-zA-Z0-9]+]]
+// CHECK-BOUND:         %[[MASK:.+]] = vector.create_mask %{{.+}}, %{{.+}} : vector<8x16xi1>
+// CHECK-BOUND:         %[[READ:.+]] = vector.transfer_read %[[SRC]]{{.+}}, %[[MASK]]
+// CHECK-BOUND:         %[[EXP:.+]] = math.exp %[[READ]] : vector<8x16xf32>
+// CHECK-BOUND:         vector.transfer_write %[[EXP]]{{.+}}, %[[MASK]]
@@ -378,6 +378,69 @@ static InstrumentationEntry appendInstrumentationEntry(
   return entry;
 }
 
+// Workgroup key produced by sampled hal.instrument.workgroup ops when the
+// workgroup was not selected for recording. Real keys always have their low
+// 24 bits clear and can never collide with it.
+static constexpr int64_t kUnsampledWorkgroupKey = -1;
+
+// Returns true if |workgroupKey| was produced by a sampled
+// hal.instrument.workgroup and may be kUnsampledWorkgroupKey at runtime.
+static bool isSampledWorkgroupKey(Value workgroupKey) {
+  auto workgroupOp =
+      workgroupKey.getDefiningOp<IREE::HAL::InstrumentWorkgroupOp>();
+  return workgroupOp && workgroupOp.getSampled();
+}
+
+// Emits the ops produced by |thenBuilder| in a block only executed when
+// |condition| is true and returns values that are either the results of
+// |thenBuilder| or |elseValues| when the condition is false.
+// The rewriter is left positioned at the start of the merged continuation.
+static SmallVector<Value>
+createIfThen(Location loc, Value condition, ValueRange elseValues,
+             function_ref<SmallVector<Value>(OpBuilder &)> thenBuilder,
+             ConversionPatternRewriter &rewriter) {
+  Block *currentBlock = rewriter.getInsertionBlock();
+  Block *continueBlock =
+      rewriter.splitBlock(currentBlock, rewriter.getInsertionPoint());
+  SmallVector<Value> results;
+  for (Value elseValue : elseValues) {
+    results.push_back(continueBlock->addArgument(elseValue.getType(), loc));
+  }
+  Block *thenBlock = rewriter.createBlock(continueBlock);
+  rewriter.setInsertionPointToEnd(currentBlock);
+  rewriter.create<LLVM::CondBrOp>(loc, condition, thenBlock, ValueRange{},
+                                  continueBlock, elseValues);
+  rewriter.setInsertionPointToStart(thenBlock);
+  SmallVector<Value> thenValues = thenBuilder(rewriter);
+  rewriter.create<LLVM::BrOp>(loc, thenValues, continueBlock);
+  rewriter.setInsertionPointToStart(continueBlock);
+  return results;
+}
+
+// Emits the entry produced by |entryBuilder| and skips it when |workgroupKey|
+// comes from a workgroup that was not sampled.
+static void
+appendKeyedInstrumentationEntry(Location loc, Value originalWorkgroupKey,
+                                Value workgroupKey,
+                                function_ref<void(OpBuilder &)> entryBuilder,
+                                ConversionPatternRewriter &rewriter) {
+  if (!isSampledWorkgroupKey(originalWorkgroupKey)) {
+    entryBuilder(rewriter);
+    return;
+  }
+  Value isSampled = rewriter.create<LLVM::ICmpOp>(
+      loc, LLVM::ICmpPredicate::ne, workgroupKey,
+      rewriter.create<LLVM::ConstantOp>(loc, workgroupKey.getType(),
+                                        kUnsampledWorkgroupKey));
+  createIfThen(
+      loc, isSampled, ValueRange{},
+      [&](OpBuilder &builder) {
+        entryBuilder(builder);
+        return SmallVector<Value>{};
+      },
+      rewriter);
+}
+
 static int64_t getMemoryAccessByteSize(Type type) {
   if (auto vectorType = llvm::dyn_cast<VectorType>(type)) {
     return (vectorType.getNumElements() * vectorType.getElementTypeBitWidth()) /
@@ -420,33 +483,100 @@ struct ConvertHALInstrumentWorkgroupOp
         loc, i32Type, rawDispatchId,
         rewriter.create<LLVM::ConstantOp>(loc, i32Type, 8)); // | 8bit tag
 
-    auto entry = appendInstrumentationEntry(
-        loc, instrumentOp.getBuffer(), operands.getBuffer(), entryType,
-        {
-            header,
-            abi.loadWorkgroupID(instrumentOp, 0, i32Type, rewriter),
-            abi.loadWorkgroupID(instrumentOp, 1, i32Type, rewriter),
-            abi.loadWorkgroupID(instrumentOp, 2, i32Type, rewriter),
-            abi.loadWorkgroupCount(instrumentOp, 0, i32Type, rewriter),
-            abi.loadWorkgroupCount(instrumentOp, 1, i32Type, rewriter),
-            abi.loadWorkgroupCount(instrumentOp, 2, i32Type, rewriter),
-            abi.loadProcessorID(instrumentOp, rewriter),
-        },
-        dataLayout, rewriter);
-
-    // Prepare the 40-bit key used by all accesses - we do this once so that we
-    // can ensure it's hoisted.
-    // Consumers expect 40 bits of offset << 24 bits.
-    Value workgroupKey = rewriter.create<LLVM::ShlOp>(
-        loc,
-        rewriter.create<LLVM::AndOp>(
-            loc, entry.offset,
-            rewriter.create<LLVM::ConstantOp>(loc, i64Type, 0xFFFFFFFFFFll)),
-        rewriter.create<LLVM::ConstantOp>(loc, i64Type, 24));
+    auto buildWorkgroupEntry = [&](OpBuilder &builder) {
+      auto entry = appendInstrumentationEntry(
+          loc, instrumentOp.getBuffer(), operands.getBuffer(), entryType,
+          {
+              header,
+              abi.loadWorkgroupID(instrumentOp, 0, i32Type, builder),
+              abi.loadWorkgroupID(instrumentOp, 1, i32Type, builder),
+              abi.loadWorkgroupID(instrumentOp, 2, i32Type, builder),
+              abi.loadWorkgroupCount(instrumentOp, 0, i32Type, builder),
+              abi.loadWorkgroupCount(instrumentOp, 1, i32Type, builder),
+              abi.loadWorkgroupCount(instrumentOp, 2, i32Type, builder),
+              abi.loadProcessorID(instrumentOp, builder),
+          },
+          dataLayout, builder);
+
+      // Prepare the 40-bit key used by all accesses - we do this once so that
+      // we can ensure it's hoisted.
+      // Consumers expect 40 bits of offset << 24 bits.
+      return SmallVector<Value>{builder.create<LLVM::ShlOp>(
+          loc,
+          builder.create<LLVM::AndOp>(
+              loc, entry.offset,
+              builder.create<LLVM::ConstantOp>(loc, i64Type, 0xFFFFFFFFFFll)),
+          builder.create<LLVM::ConstantOp>(loc, i64Type, 24))};
+    };
+
+    if (!instrumentOp.getSampled()) {
+      rewriter.replaceOp(instrumentOp, buildWorkgroupEntry(rewriter));
+      return success();
+    }
+
+    // Sampled workgroups only record when their linearized workgroup ID is a
+    // multiple of the period the host stores in the buffer footer. A period of
+    // 0 disables recording entirely.
+    Value isSampled =
+        isWorkgroupSampled(loc, instrumentOp, operands.getBuffer(), rewriter);
+    Value unsampledKey = rewriter.create<LLVM::ConstantOp>(
+        loc, i64Type, kUnsampledWorkgroupKey);
+    Value workgroupKey = createIfThen(loc, isSampled, unsampledKey,
+                                      buildWorkgroupEntry, rewriter).front();
 
     rewriter.replaceOp(instrumentOp, workgroupKey);
     return success();
   }
+
+private:
+  // Returns an i1 indicating whether the current workgroup should record.
+  Value isWorkgroupSampled(Location loc,
+                           IREE::HAL::InstrumentWorkgroupOp instrumentOp,
+                           Value bufferPtr,
+                           ConversionPatternRewriter &rewriter) const {
+    auto i8Type = rewriter.getI8Type();
+    auto i32Type = rewriter.getI32Type();
+    auto bufferType =
+        llvm::cast<MemRefType>(instrumentOp.getBuffer().getType());
+    int64_t totalBufferSize =
+        (bufferType.getNumElements() * bufferType.getElementTypeBitWidth()) / 8;
+    Value basePtr = MemRefDescriptor(bufferPtr).alignedPtr(rewriter, loc);
+    Value periodPtr = rewriter.create<LLVM::GEPOp>(
+        loc, basePtr.getType(), i8Type, basePtr,
+        rewriter.create<LLVM::ConstantOp>(
+            loc, rewriter.getI64Type(),
+            totalBufferSize - IREE_INSTRUMENT_DISPATCH_SAMPLING_PERIOD_OFFSET),
+        /*inbounds=*/true);
+    // The host may change the period at any time so it must not be cached
+    // across workgroups.
+    Value period = rewriter.create<LLVM::LoadOp>(loc, i32Type, periodPtr,
+                                                 /*alignment=*/4,
+                                                 /*isVolatile=*/true);
+
+    // linear_id = x + count_x * (y + count_y * z)
+    Value linearId = rewriter.create<LLVM::AddOp>(
+        loc, abi.loadWorkgroupID(instrumentOp, 0, i32Type, rewriter),
+        rewriter.create<LLVM::MulOp>(
+            loc, abi.loadWorkgroupCount(instrumentOp, 0, i32Type, rewriter),
+            rewriter.create<LLVM::AddOp>(
+                loc, abi.loadWorkgroupID(instrumentOp, 1, i32Type, rewriter),
+                rewriter.create<LLVM::MulOp>(
+                    loc,
+                    abi.loadWorkgroupCount(instrumentOp, 1, i32Type, rewriter),
+                    abi.loadWorkgroupID(instrumentOp, 2, i32Type, rewriter)))));
+
+    // Avoid the division by zero when disabled; the result is discarded.
+    Value zero = rewriter.create<LLVM::ConstantOp>(loc, i32Type, 0);
+    Value one = rewriter.create<LLVM::ConstantOp>(loc, i32Type, 1);
+    Value isEnabled = rewriter.create<LLVM::ICmpOp>(
+        loc, LLVM::ICmpPredicate::ne, period, zero);
+    Value divisor =
+        rewriter.create<LLVM::SelectOp>(loc, isEnabled, period, one);
+    Value isMultiple = rewriter.create<LLVM::ICmpOp>(
+        loc, LLVM::ICmpPredicate::eq,
+        rewriter.create<LLVM::URemOp>(loc, linearId, divisor), zero);
+    return rewriter.create<LLVM::AndOp>(loc, isEnabled, isMultiple);
+  }
 };
 
 static std::optional<uint64_t> mapValueType(Type type) {
@@ -555,13 +685,18 @@ struct ConvertHALInstrumentValueOp
                 instrumentOp.getType().getIntOrFloatBitWidth()),
             operands.getOperand()));
 
-    appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
-                               operands.getBuffer(), entryType,
-                               {
-                                   header,
-                                   bits,
-                               },
-                               dataLayout, rewriter);
+    appendKeyedInstrumentationEntry(
+        loc, instrumentOp.getWorkgroupKey(), operands.getWorkgroupKey(),
+        [&](OpBuilder &builder) {
+          appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
+                                     operands.getBuffer(), entryType,
+                                     {
+                                         header,
+                                         bits,
+                                     },
+                                     dataLayout, builder);
+        },
+        rewriter);
 
     rewriter.replaceOp(instrumentOp, operands.getOperand());
     return success();
@@ -602,13 +737,18 @@ struct ConvertHALInstrumentMemoryLoadOp
         operands.getBase(), operands.getIndices(), rewriter);
     Value addressI64 = rewriter.create<LLVM::PtrToIntOp>(loc, i64Type, loadPtr);
 
-    appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
-                               operands.getBuffer(), entryType,
-                               {
-                                   header,
-                                   addressI64,
-                               },
-                               dataLayout, rewriter);
+    appendKeyedInstrumentationEntry(
+        loc, instrumentOp.getWorkgroupKey(), operands.getWorkgroupKey(),
+        [&](OpBuilder &builder) {
+          appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
+                                     operands.getBuffer(), entryType,
+                                     {
+                                         header,
+                                         addressI64,
+                                     },
+                                     dataLayout, builder);
+        },
+        rewriter);
 
     rewriter.replaceOp(instrumentOp, operands.getLoadValue());
     return success();
@@ -650,13 +790,18 @@ struct ConvertHALInstrumentMemoryStoreOp
     Value addressI64 =
         rewriter.create<LLVM::PtrToIntOp>(loc, i64Type, storePtr);
 
-    appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
-                               operands.getBuffer(), entryType,
-                               {
-                                   header,
-                                   addressI64,
-                               },
-                               dataLayout, rewriter);
+    appendKeyedInstrumentationEntry(
+        loc, instrumentOp.getWorkgroupKey(), operands.getWorkgroupKey(),
+        [&](OpBuilder &builder) {
+          appendInstrumentationEntry(loc, instrumentOp.getBuffer(),
+                                     operands.getBuffer(), entryType,
+                                     {
+                                         header,
+                                         addressI64,
+                                     },
+                                     dataLayout, builder);
+        },
+        rewriter);
 
     rewriter.replaceOp(instrumentOp, operands.getStoreValue());
     return success();
@@ -294,7 +294,7 @@ LLVM::DIDerivedTypeAttr ExecutableLibraryDI::getWorkgroupStateV0T() {
           /*recId=*/{},
           builder.getStringAttr("iree_hal_executable_workgroup_state_v0_t"),
           fileAttr, /*line=*/321, fileAttr,
-          /*baseType=*/nullptr, LLVM::DIFlags::Zero, /*sizeInBits=*/256,
+          /*baseType=*/nullptr, LLVM::DIFlags::Zero, /*sizeInBits=*/448,
           /*alignInBits=*/0,
           {
               getMemberOf("workgroup_id_x", getUint32T(), &offsetInBits),
@@ -304,6 +304,15 @@ LLVM::DIDerivedTypeAttr ExecutableLibraryDI::getWorkgroupStateV0T() {
               getMemberOf("processor_id", getUint32T(), &offsetInBits),
               getMemberOf("local_memory", getVoidPtr(), &offsetInBits),
               getMemberOf("local_memory_size", getUint32T(), &offsetInBits),
+              getMemberOf("workgroup_range_count", getUint32T(),
+                          &offsetInBits),
+              getMemberOf("next_workgroup_id_x", getUint32T(), &offsetInBits),
+              getMemberOf("next_workgroup_id_y", getUint32T(), &offsetInBits),
+              getMemberOf("next_workgroup_id_z", getUint16T(), &offsetInBits),
+              getMemberOf("processor_cluster_id", getUint16T(),
+                          &offsetInBits),
+              getMemberOf("l1_data_cache_size", getUint32T(), &offsetInBits),
+              getMemberOf("l2_data_cache_size", getUint32T(), &offsetInBits),
           }));
 }
 
@@ -461,6 +470,24 @@ HALDispatchABI::getWorkgroupStateType(MLIRContext *context,
   fieldTypes.push_back(opaquePtrType);
   fieldTypes.push_back(uint32Type);
 
+  // uint32_t workgroup_range_count;
+  fieldTypes.push_back(uint32Type);
+
+  // uint32_t next_workgroup_id_x;
+  // uint32_t next_workgroup_id_y;
+  // uint16_t next_workgroup_id_z;
+  fieldTypes.push_back(uint32Type);
+  fieldTypes.push_back(uint32Type);
+  fieldTypes.push_back(uint16Type);
+
+  // uint16_t processor_cluster_id;
+  fieldTypes.push_back(uint16Type);
+
+  // uint32_t l1_data_cache_size;
+  // uint32_t l2_data_cache_size;
+  fieldTypes.push_back(uint32Type);
+  fieldTypes.push_back(uint32Type);
+
   LogicalResult bodySet = structType.setBody(fieldTypes, /*isPacked=*/false);
   assert(succeeded(bodySet) &&
          "could not set the body of an identified struct");
@@ -183,6 +183,13 @@ public:
     /*uint32_t*/ processor_id,
     /*intptr_t*/ local_memory,
     /*uint32_t*/ local_memory_size,
+    /*uint32_t*/ workgroup_range_count,
+    /*uint32_t*/ next_workgroup_id_x,
+    /*uint32_t*/ next_workgroup_id_y,
+    /*uint16_t*/ next_workgroup_id_z,
+    /*uint16_t*/ processor_cluster_id,
+    /*uint32_t*/ l1_data_cache_size,
+    /*uint32_t*/ l2_data_cache_size,
   };
   friend WorkgroupStateField operator+(WorkgroupStateField lhs, int32_t rhs) {
     return static_cast<WorkgroupStateField>(static_cast<int32_t>(lhs) + rhs);
@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Codegen/LLVMCPU/KernelDispatch.h"
 
+#include "iree/compiler/Codegen/Common/CPU/CPUTuningDatabase.h"
 #include "iree/compiler/Codegen/Common/TileSizeSelection.h"
 #include "iree/compiler/Codegen/Interfaces/PartitionableLoopsInterface.h"
 #include "iree/compiler/Codegen/LLVMCPU/TargetMLTransformInfo.h"
@@ -1541,6 +1542,24 @@ static TileSizesListType getMmt4dTileSizes(linalg::LinalgOp op) {
       N1 == 1 ? 1
               : getMatmulTileSize(tileBytes, rhsType.getElementTypeBitWidth(),
                                   reductionSize, N0);
+  // A tuning database measured on the target CPU may have the fastest
+  // workgroup sizes for this tile, in which case they replace the above guess.
+  SmallVector<Type> elementTypes = {
+      lhsType.getElementType(), rhsType.getElementType(),
+      getElementTypeOrSelf(op.getDpsInits()[0].getType())};
+  auto targetAttr = IREE::HAL::ExecutableTargetAttr::lookup(op);
+  checkMmt4dTuningDatabase(op, targetAttr);
+  if (std::optional<Mmt4dTuningEntry> tuning = lookupMmt4dTuningEntryForTile(
+          targetAttr, elementTypes, M0, N0, K0)) {
+    if (M1 != 1) {
+      distConfig.maxTileSizes[mmt4dDimBase + 0] =
+          llvm::divideCeil(tuning->workgroupM, M0);
+    }
+    if (N1 != 1) {
+      distConfig.maxTileSizes[mmt4dDimBase + 1] =
+          llvm::divideCeil(tuning->workgroupN, N0);
+    }
+  }
 
   SmallVector<int64_t> distTileSizes =
       getDefaultDistributedLevelTileSizes(op, distConfig);
@@ -1702,6 +1721,29 @@ static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
       DispatchLoweringPassPipeline::CPULinalgExtTileAndVectorize);
 }
 
+/// Sets the lowering configuration for a linalg.softmax op. These only reach
+/// here when they are left for the `softmax` ukernel by DecomposeSoftmax. The
+/// ukernel processes whole rows, so the softmax dimension is not tiled, and
+/// the vector level tiles the dimensions before the rows to 1 so that tiles
+/// are 2-D.
+static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
+                                   linalg::SoftmaxOp softmaxOp) {
+  int64_t rank = softmaxOp.getInputOperandRank();
+  int64_t dim = softmaxOp.getDimension();
+  SmallVector<int64_t> distTileSizes = getDefaultDistributedLevelTileSizes(
+      softmaxOp, DistributionHeuristicConfig{});
+  distTileSizes[dim] = 0;
+  SmallVector<int64_t> vecTileSizes(rank, 1);
+  vecTileSizes[dim] = 0;
+  if (rank >= 2) {
+    vecTileSizes[rank - 2] = 0;
+  }
+  TileSizesListType tileSizes = {distTileSizes, vecTileSizes};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPointFn, softmaxOp, tileSizes,
+      DispatchLoweringPassPipeline::CPULinalgExtTileAndVectorize);
+}
+
 /// Sets the lowering configuration for dispatch region for linalg_ext.fft
 /// root op.
 static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
@@ -2336,7 +2378,7 @@ setRootConfigImpl(mlir::FunctionOpInterface entryPointFn, Operation *op,
         })
         .Case<IREE::LinalgExt::AttentionOp, IREE::LinalgExt::FftOp,
               tensor::PackOp, tensor::PadOp, tensor::UnPackOp, linalg::Mmt4DOp,
-              linalg::BatchMmt4DOp>(
+              linalg::BatchMmt4DOp, linalg::SoftmaxOp>(
             [&](auto op) { return setRootConfig(entryPointFn, op); })
         .Case<IREE::LinalgExt::WinogradFilterTransformOp,
               IREE::LinalgExt::WinogradInputTransformOp,
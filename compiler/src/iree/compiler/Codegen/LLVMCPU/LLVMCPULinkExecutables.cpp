@@ -9,12 +9,58 @@
 #include "iree/compiler/Codegen/Utils/LinkingUtils.h"
 #include "iree/compiler/Utils/ModuleUtils.h"
 #include "llvm/Support/FormatVariadic.h"
+#include "mlir/Dialect/LLVMIR/LLVMDialect.h"
 #include "mlir/Pass/Pass.h"
 
 namespace mlir::iree_compiler {
 
 namespace {
 
+// Deduplicates constant globals with identical contents in |moduleOp|.
+// Each source executable carries its own copy of any constants it uses
+// (lookup tables, packed weights, strings, etc) and after linking they all end
+// up in the same library. Only constants that are not visible outside of the
+// module are merged and all uses are redirected to the first definition. Code
+// generated from dispatches never compares the addresses of constants so it's
+// safe to merge them even if they aren't marked unnamed_addr.
+static void deduplicateConstantGlobals(mlir::ModuleOp moduleOp) {
+  DenseMap<Attribute, LLVM::GlobalOp> canonicalGlobals;
+  DenseMap<StringRef, StringRef> replacements;
+  SmallVector<LLVM::GlobalOp> deadGlobals;
+  for (auto globalOp : moduleOp.getOps<LLVM::GlobalOp>()) {
+    if (!globalOp.getConstant() || !globalOp.getValueAttr() ||
+        !globalOp.getInitializerRegion().empty()) {
+      continue;
+    }
+    if (globalOp.getLinkage() != LLVM::Linkage::Private &&
+        globalOp.getLinkage() != LLVM::Linkage::Internal) {
+      continue;
+    }
+    // Key on everything but the symbol name: type, value, alignment, section,
+    // address space, etc must all match for the globals to be interchangeable.
+    NamedAttrList keyAttrs(globalOp->getAttrDictionary());
+    keyAttrs.erase(SymbolTable::getSymbolAttrName());
+    auto keyAttr = keyAttrs.getDictionary(globalOp.getContext());
+    auto [it, inserted] = canonicalGlobals.try_emplace(keyAttr, globalOp);
+    if (inserted)
+      continue;
+    replacements[globalOp.getSymName()] = it->second.getSymName();
+    deadGlobals.push_back(globalOp);
+  }
+  if (replacements.empty())
+    return;
+
+  // Globals are only referenced by address so we can avoid walking all
+  // symbol uses in what may be a very large module.
+  moduleOp.walk([&](LLVM::AddressOfOp addressOfOp) {
+    auto it = replacements.find(addressOfOp.getGlobalName());
+    if (it != replacements.end())
+      addressOfOp.setGlobalName(it->second);
+  });
+  for (auto globalOp : deadGlobals)
+    globalOp.erase();
+}
+
 struct LLVMCPULinkExecutablesPass
     : public LLVMCPULinkExecutablesBase<LLVMCPULinkExecutablesPass> {
   LLVMCPULinkExecutablesPass() = default;
@@ -67,6 +113,19 @@ struct LLVMCPULinkExecutablesPass
         return signalPassFailure();
       }
     }
+
+    // Executables are commonly specialized copies of one another and share
+    // constant data that would otherwise be emitted once per executable.
+    if (auto linkedExecutableOp =
+            moduleOp.lookupSymbol<IREE::HAL::ExecutableOp>(
+                linkedExecutableName)) {
+      for (auto variantOp :
+           linkedExecutableOp.getOps<IREE::HAL::ExecutableVariantOp>()) {
+        if (auto innerModuleOp = variantOp.getInnerModule()) {
+          deduplicateConstantGlobals(innerModuleOp);
+        }
+      }
+    }
   }
 };
 
@@ -323,6 +323,7 @@ void addCPUBufferOpsTileAndVectorizePipeline(
   {
     GenericVectorizationPassOptions options;
     options.useConfiguredVectorSizes = pipelineOpt.useConfiguredVectorSizes;
+    options.boundDynamicDimsByConfig = true;
     options.enableVectorMasking = pipelineOpt.enableVectorMasking;
     options.vectorizeGatherAccesses = true;
     funcPassManager.addPass(createGenericVectorizationPass(options));
@@ -351,6 +352,12 @@ void addMultiTilingExpertPassPipeline(OpPassManager &funcPassManager,
                                       TilingConfig &tilingConfig,
                                       LLVMCPUPipelineOptions &pipelineOpt) {
   addTileAndDistributePasses(funcPassManager);
+  // Row reductions such as argmax are converted to ukernels on the distributed
+  // tiles, which hold whole rows.
+  if (pipelineOpt.enableUkernels) {
+    funcPassManager.addPass(
+        createCPULowerToUKernelsPass(clSkipIntermediateRoundings));
+  }
 
   SmallVector<int64_t> allFusableLevels(tilingConfig.getFusableLevels());
   // Apply tile and fuse to all the non-distribution fusable levels. Skip
@@ -397,6 +404,7 @@ void addMultiTilingExpertPassPipeline(OpPassManager &funcPassManager,
 
     GenericVectorizationPassOptions options;
     options.useConfiguredVectorSizes = pipelineOpt.useConfiguredVectorSizes;
+    options.boundDynamicDimsByConfig = true;
     options.enableVectorMasking = pipelineOpt.enableVectorMasking;
     options.vectorizePadding = true;
     options.vectorizeGatherAccesses = true;
@@ -456,6 +464,7 @@ void addConvTileAndDecomposeExpertPassPipeline(
     funcPassManager.addPass(createVectorizePadPass());
     GenericVectorizationPassOptions options;
     options.useConfiguredVectorSizes = pipelineOpt.useConfiguredVectorSizes;
+    options.boundDynamicDimsByConfig = true;
     options.enableVectorMasking = pipelineOpt.enableVectorMasking;
     options.vectorizePadding = true;
     options.vectorizeGatherAccesses = true;
@@ -568,6 +577,7 @@ void addCPUDataTilingPipeline(OpPassManager &funcPassManager,
   {
     GenericVectorizationPassOptions options;
     options.useConfiguredVectorSizes = pipelineOpt.useConfiguredVectorSizes;
+    options.boundDynamicDimsByConfig = true;
     options.vectorizePadding = true;
     options.enableVectorMasking = pipelineOpt.enableVectorMasking;
     funcPassManager.addPass(createGenericVectorizationPass(options));
@@ -593,6 +603,12 @@ void addCPULinalgExtTileAndVectorizePipeline(
   addTileAndDistributePasses(funcPassManager);
   funcPassManager.addPass(
       createLLVMCPUTilePass(tilingConfig.getVectorCommonParallelLevel()));
+  // Attention ops converted to the `attention` ukernel are left alone by the
+  // decomposition below.
+  if (pipelineOpt.enableUkernels) {
+    funcPassManager.addPass(
+        createCPULowerToUKernelsPass(clSkipIntermediateRoundings));
+  }
   // TODO: Should only apply decomposition here?
   funcPassManager.addPass(
       IREE::LinalgExt::createTileAndDecomposeAttentionPass());
@@ -602,6 +618,7 @@ void addCPULinalgExtTileAndVectorizePipeline(
   {
     GenericVectorizationPassOptions options;
     options.useConfiguredVectorSizes = pipelineOpt.useConfiguredVectorSizes;
+    options.boundDynamicDimsByConfig = true;
     options.enableVectorMasking = pipelineOpt.enableVectorMasking;
     funcPassManager.addPass(createGenericVectorizationPass(options));
     funcPassManager.addPass(createOptimizeTensorInsertExtractSlicesPass());
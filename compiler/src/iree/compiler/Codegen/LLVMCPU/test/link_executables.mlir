@@ -0,0 +1,57 @@
+// RUN: iree-opt --split-input-file --iree-llvmcpu-link-executables %s | FileCheck %s
+
+// Tests that constants with identical contents are deduplicated when linking
+// executables while those that differ or are externally visible are retained.
+
+#executable_target = #hal.executable.target<"llvm-cpu", "embedded-elf-x86_64">
+#pipeline_layout = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>
+  ]>
+]>
+
+hal.executable private @dispatch_0 {
+  hal.executable.variant @variant target(#executable_target) {
+    hal.executable.export @dispatch_0 ordinal(0) layout(#pipeline_layout)
+    builtin.module {
+      llvm.mlir.global private constant @__constant_4xi32(dense<[1, 2, 3, 4]> : tensor<4xi32>) {addr_space = 0 : i32, alignment = 64 : i64} : !llvm.array<4 x i32>
+      llvm.func @dispatch_0() -> !llvm.ptr {
+        %0 = llvm.mlir.addressof @__constant_4xi32 : !llvm.ptr
+        llvm.return %0 : !llvm.ptr
+      }
+    }
+  }
+}
+hal.executable private @dispatch_1 {
+  hal.executable.variant @variant target(#executable_target) {
+    hal.executable.export @dispatch_1 ordinal(0) layout(#pipeline_layout)
+    builtin.module {
+      llvm.mlir.global private constant @__constant_4xi32_table(dense<[1, 2, 3, 4]> : tensor<4xi32>) {addr_space = 0 : i32, alignment = 64 : i64} : !llvm.array<4 x i32>
+      llvm.mlir.global private constant @__constant_4xi32_other(dense<[5, 6, 7, 8]> : tensor<4xi32>) {addr_space = 0 : i32, alignment = 64 : i64} : !llvm.array<4 x i32>
+      llvm.mlir.global private constant @__constant_4xi32_aligned(dense<[1, 2, 3, 4]> : tensor<4xi32>) {addr_space = 0 : i32, alignment = 128 : i64} : !llvm.array<4 x i32>
+      llvm.mlir.global external constant @__constant_4xi32_public(dense<[1, 2, 3, 4]> : tensor<4xi32>) {addr_space = 0 : i32, alignment = 64 : i64} : !llvm.array<4 x i32>
+      llvm.func @dispatch_1() -> !llvm.ptr {
+        %0 = llvm.mlir.addressof @__constant_4xi32_table : !llvm.ptr
+        %1 = llvm.mlir.addressof @__constant_4xi32_other : !llvm.ptr
+        %2 = llvm.mlir.addressof @__constant_4xi32_aligned : !llvm.ptr
+        %3 = llvm.mlir.addressof @__constant_4xi32_public : !llvm.ptr
+        llvm.return %0 : !llvm.ptr
+      }
+    }
+  }
+}
+
+// CHECK: hal.executable private @link_executables_linked_llvm_cpu
+// CHECK:   builtin.module
+// CHECK:     llvm.mlir.global private constant @__constant_4xi32(dense<[1, 2, 3, 4]>
+// CHECK-NOT: llvm.mlir.global private constant @__constant_4xi32_table
+// CHECK:     llvm.mlir.global private constant @__constant_4xi32_other(dense<[5, 6, 7, 8]>
+// CHECK:     llvm.mlir.global private constant @__constant_4xi32_aligned(dense<[1, 2, 3, 4]>
+// CHECK:     llvm.mlir.global external constant @__constant_4xi32_public(dense<[1, 2, 3, 4]>
+// CHECK:     llvm.func @dispatch_0()
+// CHECK:       llvm.mlir.addressof @__constant_4xi32 :
+// CHECK:     llvm.func @dispatch_1()
+// CHECK-NEXT:  llvm.mlir.addressof @__constant_4xi32 :
+// CHECK-NEXT:  llvm.mlir.addressof @__constant_4xi32_other :
+// CHECK-NEXT:  llvm.mlir.addressof @__constant_4xi32_aligned :
+// CHECK-NEXT:  llvm.mlir.addressof @__constant_4xi32_public :
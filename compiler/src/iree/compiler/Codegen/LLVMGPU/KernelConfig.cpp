@@ -45,6 +45,12 @@ llvm::cl::opt<bool> clGPUEnableVectorDistribution(
     llvm::cl::desc("enable the usage of the vector distribution pipeline"),
     llvm::cl::init(true));
 
+llvm::cl::opt<bool> clGPUEnableReductionVectorDistribution(
+    "iree-codegen-llvmgpu-use-reduction-vector-distribution",
+    llvm::cl::desc("enable the usage of the vector distribution pipeline for "
+                   "reductions"),
+    llvm::cl::init(false));
+
 llvm::cl::opt<bool> clGPUEnableTransformDialectJit(
     "iree-codegen-llvmgpu-enable-transform-dialect-jit",
     llvm::cl::desc("enable the usage of the transform dialect JIT"),
@@ -83,6 +89,9 @@ struct TargetInfo {
   bool hasTF32TensorCore = false;
   bool hasWarpShuffle = false;
   bool hasMmaSync = false;
+  // Whether large tensor core tiles should keep more stages of asynchronous
+  // copies in flight to hide the latency of global memory loads.
+  bool hasDeepMatmulPipelines = false;
   // These are listed in the order of preference, not necessarily monotonically.
   SmallVector<int64_t, 2> supportedSubgroupSizes = {32};
   int64_t sharedMemoryLimitInBytes = 65536;
@@ -135,24 +144,28 @@ getMatmulConfig(const TargetInfo &targetInfo) {
 /// operations.
 static void
 getTensorCoreConfig(SmallVectorImpl<TileWorkgroupSizePair> &tileSizes,
-                    Type elementType, int64_t M, int64_t N, int64_t K) {
+                    Type elementType, int64_t M, int64_t N, int64_t K,
+                    const TargetInfo &targetInfo) {
   // Based on early analysis we found that 128x256x32_3 gives acceptable
   // performance across many of the large matrix sizes for f16 and fp32. This
   // needs to be refined into a better startegy based on empircal data but this
   // gives us a quick solution to achieve performance in the right order of
   // magnitude for large square like cases.
+  // A stage of either tile takes 24KB of shared memory so targets with deep
+  // pipelines fit two more stages in flight.
   int64_t parallelDim = M * N;
   static constexpr int64_t kLargDimThreashold = 1536;
+  int64_t extraStages = targetInfo.hasDeepMatmulPipelines ? 2 : 0;
   if (elementType.isF16()) {
     if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
-      tileSizes.push_back(
-          TileWorkgroupSizePair({{128, 256, 32}, {128, 2, 1}, 3}));
+      tileSizes.push_back(TileWorkgroupSizePair(
+          {{128, 256, 32}, {128, 2, 1}, 3 + extraStages}));
     }
     tileSizes.push_back(TileWorkgroupSizePair({{32, 32, 32}, {64, 2, 1}, 4}));
   } else {
     if (parallelDim >= kLargDimThreashold * kLargDimThreashold) {
-      tileSizes.push_back(
-          TileWorkgroupSizePair({{128, 256, 16}, {128, 2, 1}, 4}));
+      tileSizes.push_back(TileWorkgroupSizePair(
+          {{128, 256, 16}, {128, 2, 1}, 4 + extraStages}));
     }
     llvm::append_values(tileSizes,
                         TileWorkgroupSizePair({{32, 32, 16}, {64, 2, 1}, 4}),
@@ -216,6 +229,12 @@ static TargetInfo getCudaTargetInfo(mlir::FunctionOpInterface entryPoint) {
     info.hasTF32TensorCore = true;
     info.hasMmaSync = true;
   }
+  // Hopper raises the shared memory available to a workgroup to 227KB, which
+  // leaves room for deeper cp.async pipelines on the mma.sync path.
+  if (smVersion >= 90) {
+    info.sharedMemoryLimitInBytes = 227 * 1024;
+    info.hasDeepMatmulPipelines = true;
+  }
   return info;
 }
 
@@ -649,6 +668,80 @@ setMatmulVectorDistributionConfig(mlir::FunctionOpInterface entryPoint,
                                                targetSubgroupSize, configDict);
 }
 
+/// Sets the configuration for reductions along the innermost dimension that
+/// are lowered with vector distribution. Each workgroup reduces one row with
+/// every thread holding a contiguous vector of the row; partial results are
+/// combined with subgroup shuffles and then across subgroups through shared
+/// memory.
+static LogicalResult
+setReductionVectorDistributionConfig(mlir::FunctionOpInterface entryPoint,
+                                     linalg::LinalgOp op,
+                                     const TargetInfo &targetInfo) {
+  if (!clGPUEnableReductionVectorDistribution) {
+    LDBG("reduction vector distribution not enabled, skipping...\n");
+    return failure();
+  }
+  if (!targetInfo.hasWarpShuffle || targetInfo.supportedSubgroupSizes.empty())
+    return failure();
+  const int64_t subgroupSize = targetInfo.supportedSubgroupSizes.front();
+
+  SmallVector<unsigned> reductionDims;
+  op.getReductionDims(reductionDims);
+  if (reductionDims.size() != 1 || reductionDims[0] != op.getNumLoops() - 1)
+    return failure();
+
+  SmallVector<int64_t, 4> bounds = op.getStaticLoopRanges();
+  if (llvm::any_of(bounds, ShapedType::isDynamic))
+    return failure();
+
+  if (op.getRegionOutputArgs().size() != 1)
+    return failure();
+  if (llvm::any_of(op.getDpsInputOperands(), [&](OpOperand *input) {
+        return !op.getMatchingIndexingMap(input).isProjectedPermutation();
+      }))
+    return failure();
+  SmallVector<Operation *> combinerOps;
+  if (!matchReduction(op.getRegionOutputArgs(), 0, combinerOps) ||
+      combinerOps.size() != 1)
+    return failure();
+
+  Type elementType = getElementTypeOrSelf(op.getDpsInitOperand(0)->get());
+  if (!elementType.isIntOrFloat() || elementType.getIntOrFloatBitWidth() != 32)
+    return failure();
+
+  // Each thread reads 128-bit vectors of the row.
+  const int64_t vectorSize = 4;
+  int64_t reductionSize = bounds[reductionDims[0]];
+  if (reductionSize % (subgroupSize * vectorSize) != 0)
+    return failure();
+
+  // Use as many subgroups as evenly divide the row, up to the workgroup size
+  // limit. Anything past that is held by each thread as extra batches.
+  const int64_t maxWorkgroupSize = 256;
+  int64_t numVectors = reductionSize / vectorSize;
+  int64_t groupSize = std::min(numVectors, maxWorkgroupSize);
+  while (numVectors % groupSize != 0)
+    groupSize -= subgroupSize;
+
+  // The whole row is vectorized at once so keep the per-thread register
+  // footprint bounded.
+  const int64_t maxVectorsPerThread = 8;
+  if (numVectors / groupSize > maxVectorsPerThread)
+    return failure();
+
+  // Tile all the parallel dimensions to 1 and keep the reduction whole.
+  SmallVector<int64_t> workgroupTileSizes(op.getNumLoops(), 1);
+  workgroupTileSizes[reductionDims[0]] = 0;
+  TileSizesListType tileSizes;
+  tileSizes.push_back(workgroupTileSizes);
+
+  std::array<int64_t, 3> workgroupSize = {groupSize, 1, 1};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPoint, op, tileSizes,
+      IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUVectorDistribute,
+      workgroupSize, subgroupSize);
+}
+
 static LogicalResult
 setVectorDistributionConfig(mlir::FunctionOpInterface entryPoint,
                             Operation *computeOp,
@@ -674,6 +767,11 @@ setVectorDistributionConfig(mlir::FunctionOpInterface entryPoint,
       return setConvolutionVectorDistributionConfig(entryPoint, linalgOp,
                                                     targetInfo);
     }
+    if (linalgOp.getNumReductionLoops() > 0) {
+      LDBG("VectorDistribution: trying to find a suitable reduction config\n");
+      return setReductionVectorDistributionConfig(entryPoint, linalgOp,
+                                                  targetInfo);
+    }
   }
 
   LDBG("VectorDistribution: failed to find a suitable config");
@@ -824,7 +922,8 @@ static LogicalResult setContractConfig(mlir::FunctionOpInterface entryPoint,
                              op.getDpsInputOperand(0)->get().getType())
                              .getElementType();
 
-      getTensorCoreConfig(TCtileSizeConfig, elementType, sizeM, sizeN, sizeK);
+      getTensorCoreConfig(TCtileSizeConfig, elementType, sizeM, sizeN, sizeK,
+                          targetInfo);
       // Pick the best configuration where the original shape is aligned on the
       // tile size.
       for (TileWorkgroupSizePair &config : TCtileSizeConfig) {
@@ -1595,6 +1694,39 @@ setArgmaxUkernelConfig(mlir::FunctionOpInterface entryPoint,
   return success();
 }
 
+/// Set the configuration for matmuls that can be mapped to the MFMA matmul
+/// uKernel. Each workgroup computes one output tile with the full reduction
+/// dimension using a single subgroup.
+static LogicalResult
+setMatmulUkernelConfig(mlir::FunctionOpInterface entryPoint,
+                       linalg::LinalgOp op, const TargetInfo &targetInfo) {
+  auto target = IREE::HAL::ExecutableTargetAttr::lookup(entryPoint);
+  if (!getRocmMatmulUkernelTypeSuffix(op, target))
+    return failure();
+
+  // The workgroup tiles must keep static shapes that are still multiples of
+  // the MFMA tile for the uKernel to be selected after tiling.
+  const int64_t kWorkgroupTileSize = 32;
+  SmallVector<int64_t, 4> bounds = op.getStaticLoopRanges();
+  if (bounds[0] % kWorkgroupTileSize != 0 ||
+      bounds[1] % kWorkgroupTileSize != 0) {
+    return failure();
+  }
+
+  // The uKernel is written for 64-wide subgroups.
+  const int64_t kSubgroupSize = 64;
+  if (!llvm::is_contained(targetInfo.supportedSubgroupSizes, kSubgroupSize))
+    return failure();
+
+  TileSizesListType tileSizes;
+  tileSizes.push_back({kWorkgroupTileSize, kWorkgroupTileSize, 0});
+  std::array<int64_t, 3> workgroupSize = {kSubgroupSize, 1, 1};
+  return setOpConfigAndEntryPointFnTranslation(
+      entryPoint, op, tileSizes,
+      IREE::Codegen::DispatchLoweringPassPipeline::LLVMGPUDefault,
+      workgroupSize, kSubgroupSize);
+}
+
 /// Make UKernels take the LLVMGPUDefault lowering pipeline.
 static LogicalResult
 setUKernelConfig(mlir::FunctionOpInterface entryPoint,
@@ -1789,6 +1921,12 @@ static LogicalResult setRootConfig(mlir::FunctionOpInterface entryPointFn,
     LDBG("Transform Dialect Config");
     return success();
   }
+  if (auto linalgOp = dyn_cast<linalg::LinalgOp>(computeOp)) {
+    if (succeeded(setMatmulUkernelConfig(entryPointFn, linalgOp, targetInfo))) {
+      LDBG("Matmul Ukernel Config");
+      return success();
+    }
+  }
   if (succeeded(
           setVectorDistributionConfig(entryPointFn, computeOp, targetInfo))) {
     return success();
@@ -25,6 +25,7 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/Utils/IndexingUtils.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinTypes.h"
@@ -49,8 +50,9 @@ namespace {
 // anchors for two types of operations; vector.contract and vector.transfer_read
 // from non-shared memory. The assumption in this case is that all IR input to
 // this pass has a leaf rooted on a transfer_read or includes a contraction in
-// the program slice, meaning all operations should receive layouts. Layout
-// setting for other problems like reductions is TODO.
+// the program slice, meaning all operations should receive layouts. Reads
+// feeding reductions are anchored such that the reduction can be distributed
+// with subgroup shuffles and a shared memory exchange between subgroups.
 class ContractionVectorLayoutOptions : public VectorLayoutOptions {
 public:
   ContractionVectorLayoutOptions(Operation *root,
@@ -60,7 +62,8 @@ public:
                                  bool printLayout)
       : VectorLayoutOptions(root, /*fullConversion=*/!printLayout),
         workgroupSize(workgroupSize), schedule(schedule),
-        printLayout(printLayout), patterns(root->getContext()) {
+        subgroupSize(subgroupSize), printLayout(printLayout),
+        patterns(root->getContext()) {
     populateGPUDistributionPatterns(patterns);
     populateGPUDistributionLayoutAttrPatterns(laneId, patterns);
     populateGPUDistributeNestedLayoutAttrPatterns(patterns, laneId,
@@ -281,13 +284,25 @@ private:
     int64_t residualThreads = flatNumThreads;
     int64_t residualElements = numElementsPerThread;
 
+    // Threads can only exchange values with shuffles within a subgroup. When
+    // the read feeds a reduction, limit the threads to a single subgroup and
+    // distribute the remaining ones as subgroups so that reducing across them
+    // goes through shared memory.
+    int64_t residualSubgroups = 1;
+    if (llvm::any_of(slice, llvm::IsaPred<vector::MultiDimReductionOp>) &&
+        flatNumThreads > subgroupSize && flatNumThreads % subgroupSize == 0) {
+      residualThreads = subgroupSize;
+      residualSubgroups = flatNumThreads / subgroupSize;
+    }
+
     SmallVector<int64_t> order(vectorDimDistributionOrder.rbegin(),
                                vectorDimDistributionOrder.rend());
 
     // Distribute all threads in the workgroup to the "threads" dimension,
     // meaning subgroup counts is unit here, even though the read is being
     // distributed to multiple subgroups. This is in an attempt to do a
-    // workgroup contiguous load.
+    // workgroup contiguous load. Reads feeding reductions are the exception,
+    // see above.
     SmallVector<int64_t> subgroupCounts(transferRank, 1);
     SmallVector<int64_t> batchSizes(transferRank, 1);
     SmallVector<int64_t> outerSizes(transferRank, 1);
@@ -316,13 +331,28 @@ private:
         vectorSize = 1;
       }
 
+      assert((residualSubgroups % vectorSize == 0 ||
+              vectorSize % residualSubgroups == 0) &&
+             "dividing subgroups to incompatible vector");
+      if (residualSubgroups <= vectorSize) {
+        vectorSize /= residualSubgroups;
+        subgroupCounts[dim] = residualSubgroups;
+        residualSubgroups = 1;
+      } else {
+        residualSubgroups /= vectorSize;
+        subgroupCounts[dim] = vectorSize;
+        vectorSize = 1;
+      }
+
       batchSizes[dim] = vectorSize;
     }
 
     // Note that the layout setting logic here necessarily uses all threads in
     // the workgroup to perform the read. As a result we can always directly
     // use the counts as the basis for computing the subgroup/thread indices.
-    SmallVector<int64_t> subgroupBasis = subgroupCounts;
+    // The subgroup basis goes from slowest to fastest varying subgroup id.
+    SmallVector<int64_t> subgroupBasis =
+        applyPermutation(subgroupCounts, order);
     SmallVector<int64_t> threadBasis = threadCounts;
 
     auto layout = IREE::VectorExt::NestedLayoutAttr::get(
@@ -342,6 +372,7 @@ private:
 
   SmallVector<int64_t, 3> workgroupSize;
   IREE::GPU::MMAScheduleAttr schedule;
+  int64_t subgroupSize;
   // Whether to print the chosen layout for testing purposes
   bool printLayout;
 
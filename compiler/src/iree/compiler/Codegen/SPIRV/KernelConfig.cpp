@@ -1050,10 +1050,63 @@ static LogicalResult setWinogradOpConfig(spirv::ResourceLimitsAttr limits,
       workgroupSize);
 }
 
+//===----------------------------------------------------------------------===//
+// Attention Default Configuration
+//===----------------------------------------------------------------------===//
+
+static LogicalResult setAttentionOpConfig(spirv::ResourceLimitsAttr limits,
+                                          IREE::LinalgExt::AttentionOp op) {
+  LLVM_DEBUG(llvm::dbgs() << "trying to deduce config as attention...\n");
+  // The iteration domain is (batch, query row). Each invocation handles one
+  // query row so that the whole decomposed softmax of the row stays in its
+  // registers; a workgroup handles a subgroup worth of rows.
+  ArrayRef<int64_t> queryShape = op.getQueryType().getShape();
+  if (op.getQueryRank() != 3 || ShapedType::isDynamic(queryShape[1]))
+    return failure();
+
+  int64_t subgroupSize = limits.getSubgroupSize();
+  int64_t rowsPerWorkgroup = 1;
+  while (rowsPerWorkgroup < subgroupSize &&
+         queryShape[1] % (rowsPerWorkgroup * 2) == 0) {
+    rowsPerWorkgroup *= 2;
+  }
+
+  auto pipeline = CodeGenPipeline::SPIRVAttentionVectorize;
+  std::array<int64_t, 3> workgroupSize = {rowsPerWorkgroup, 1, 1};
+  TileSizesListType tileSizes = {{1, rowsPerWorkgroup}, {1, 1}};
+  return setOpConfigAndEntryPointFnTranslation(
+      op->getParentOfType<mlir::FunctionOpInterface>(), op, tileSizes, pipeline,
+      workgroupSize);
+}
+
 //===----------------------------------------------------------------------===//
 // Reduction Default Configuration
 //===----------------------------------------------------------------------===//
 
+/// Returns the subgroup size to require for a reduction over |reductionSize|
+/// elements where each invocation reads |vectorSize| elements at a time, or
+/// std::nullopt if the target doesn't allow choosing it. The smallest size that
+/// covers the whole reduction in one subgroup avoids combining partial results
+/// through shared memory; otherwise the largest size leaves the fewest
+/// subgroups to combine.
+static std::optional<int64_t>
+getReductionSubgroupSize(spirv::ResourceLimitsAttr limits,
+                         int64_t reductionSize, int64_t vectorSize) {
+  std::optional<int> minSize = limits.getMinSubgroupSize();
+  std::optional<int> maxSize = limits.getMaxSubgroupSize();
+  if (!minSize || !maxSize || *minSize <= 0 || *minSize == *maxSize)
+    return std::nullopt;
+  std::optional<int64_t> subgroupSize;
+  for (int64_t size = *minSize; size <= *maxSize; size *= 2) {
+    if (reductionSize % size != 0)
+      continue;
+    subgroupSize = size;
+    if (size * vectorSize >= reductionSize)
+      break;
+  }
+  return subgroupSize;
+}
+
 /// Set the configuration for reductions that can be mapped to warp reductions.
 static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
                                         linalg::LinalgOp op) {
@@ -1122,7 +1175,7 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   if (!foundSingleReductionOutput)
     return failure();
 
-  const int subgroupSize = targetEnv.getResourceLimits().getSubgroupSize();
+  int subgroupSize = targetEnv.getResourceLimits().getSubgroupSize();
 
   // Tile all the parallel dimension to 1.
   SmallVector<unsigned> partitionedLoops =
@@ -1160,8 +1213,6 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   int64_t reductionSize = 1;
   for (int64_t dim : reductionDims)
     reductionSize *= bounds[dim];
-  if (reductionSize % subgroupSize != 0)
-    return failure();
 
   const Type elementType =
       llvm::cast<ShapedType>(op.getDpsInits()[0].getType()).getElementType();
@@ -1174,6 +1225,16 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
 
   // Let each thread handle `vectorSize` elements.
   unsigned vectorSize = kMaxVectorNumBits / bitWidth;
+
+  // With subgroup size control, specialize the subgroup size to the reduction
+  // shape. The chosen size ends up in the entry point ABI for the runtime to
+  // request when creating the pipeline.
+  std::optional<int64_t> requiredSubgroupSize = getReductionSubgroupSize(
+      targetEnv.getResourceLimits(), reductionSize, vectorSize);
+  if (requiredSubgroupSize)
+    subgroupSize = *requiredSubgroupSize;
+  if (reductionSize % subgroupSize != 0)
+    return failure();
   while ((reductionSize / vectorSize) % subgroupSize != 0)
     vectorSize /= 2;
 
@@ -1246,7 +1307,8 @@ static LogicalResult setReductionConfig(const spirv::TargetEnv &targetEnv,
   tileSizes.emplace_back(std::move(reductionTileSizes)); // reduction level
   if (failed(setOpConfigAndEntryPointFnTranslation(
           op->getParentOfType<mlir::FunctionOpInterface>(), op, tileSizes,
-          CodeGenPipeline::SPIRVSubgroupReduce, workgroupSize))) {
+          CodeGenPipeline::SPIRVSubgroupReduce, workgroupSize,
+          requiredSubgroupSize))) {
     return failure();
   }
 
@@ -1678,6 +1740,8 @@ static LogicalResult setSPIRVOpConfig(const spirv::TargetEnv &targetEnv,
       .Case<IREE::LinalgExt::WinogradInputTransformOp,
             IREE::LinalgExt::WinogradOutputTransformOp>(
           [&](auto op) { return setWinogradOpConfig(limits, op); })
+      .Case<IREE::LinalgExt::AttentionOp>(
+          [&](auto op) { return setAttentionOpConfig(limits, op); })
       .Default([](Operation *) { return failure(); });
 };
 
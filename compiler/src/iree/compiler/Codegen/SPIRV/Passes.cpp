@@ -380,6 +380,41 @@ void addSPIRVWinogradVectorizePassPipeline(OpPassManager &funcPassManager) {
   funcPassManager.addPass(createOptimizeVectorTransferPass());
 }
 
+void addSPIRVAttentionVectorizePassPipeline(OpPassManager &funcPassManager) {
+  addTileAndDistributeToWorkgroupsPasses(funcPassManager);
+
+  funcPassManager.addPass(createFoldAffineMinInDistributedLoopsPass());
+  funcPassManager.addPass(memref::createResolveShapedTypeResultDimsPass());
+
+  funcPassManager.addPass(createCanonicalizerPass());
+  funcPassManager.addPass(createCSEPass());
+
+  // Distribute query rows to invocations and then decompose each row into the
+  // online softmax loop over key/value blocks.
+  funcPassManager.addPass(createGPUTilePass());
+  funcPassManager.addPass(
+      IREE::LinalgExt::createTileAndDecomposeAttentionPass());
+  funcPassManager.addPass(createCanonicalizerPass());
+  funcPassManager.addPass(createCSEPass());
+  {
+    GenericVectorizationPassOptions options;
+    options.enableCleanup = true;
+    funcPassManager.addPass(createGenericVectorizationPass(options));
+  }
+  addSPIRVVectorLoweringPasses(funcPassManager);
+  funcPassManager.addPass(createForOpCanonicalizationPass());
+  funcPassManager.addPass(createCanonicalizerPass());
+  funcPassManager.addPass(createCSEPass());
+
+  // Bufferize and distribute.
+  addSPIRVBufferizePasses(funcPassManager, gpuAllocateFunctionMemoryFn);
+
+  // Generate loop nests for all remaining ops and remove trivial loops.
+  addLoopMaterializationPasses(funcPassManager);
+
+  funcPassManager.addPass(createOptimizeVectorTransferPass());
+}
+
 void addSPIRVCooperativeMatrixVectorizePassPipeline(
     OpPassManager &funcPassManager, unsigned pipelineDepth,
     unsigned storeStage) {
@@ -53,6 +53,11 @@ void addSPIRVSubgroupReducePassPipeline(OpPassManager &funcPassManager);
 ///
 void addSPIRVWinogradVectorizePassPipeline(OpPassManager &funcPassManager);
 
+/// Pass pipeline to lower attention ops in a single dispatch. Each invocation
+/// computes whole rows of the output with the flash attention decomposition
+/// so that the attention scores stay in registers.
+void addSPIRVAttentionVectorizePassPipeline(OpPassManager &funcPassManager);
+
 /// Populates passes needed to preprocess the input variant before lowering
 /// and select lowering strategies.
 void buildSPIRVCodegenConfigurationPassPipeline(
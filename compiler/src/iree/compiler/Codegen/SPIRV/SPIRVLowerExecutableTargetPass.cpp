@@ -121,6 +121,9 @@ void SPIRVLowerExecutableTargetPass::runOnOperation() {
   case CodeGenPipeline::SPIRVWinogradVectorize:
     addSPIRVWinogradVectorizePassPipeline(pipeline);
     break;
+  case CodeGenPipeline::SPIRVAttentionVectorize:
+    addSPIRVAttentionVectorizePassPipeline(pipeline);
+    break;
   // No pipeline specified, nothing to do.
   case CodeGenPipeline::None:
     return;
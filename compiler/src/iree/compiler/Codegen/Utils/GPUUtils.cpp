@@ -17,6 +17,7 @@
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/GPU/IR/GPUDialect.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/Dialect/Vector/IR/VectorOps.h"
 #include "mlir/IR/BuiltinTypes.h"
@@ -945,6 +946,44 @@ bool hasUkernelSupportedGpuArch(IREE::HAL::ExecutableTargetAttr targetAttr) {
   return false;
 }
 
+std::optional<StringRef>
+getRocmMatmulUkernelTypeSuffix(linalg::LinalgOp op,
+                               IREE::HAL::ExecutableTargetAttr targetAttr) {
+  if (!isa<linalg::MatmulOp>(op) || !hasUkernel(targetAttr, "matmul") ||
+      !isROCMBackend(targetAttr) || !hasUkernelSupportedRocmArch(targetAttr)) {
+    return std::nullopt;
+  }
+
+  // Only CDNA chips have the MFMA instructions the ukernel is built around.
+  auto targetArch = getConfigStringAttr(targetAttr, "target_arch");
+  if (!targetArch || !targetArch->getValue().starts_with("gfx9")) {
+    return std::nullopt;
+  }
+
+  // The ukernel walks the output in 16x16 blocks and the reduction in steps of
+  // 16 without any masking.
+  const int64_t kMfmaTileSize = 16;
+  for (int64_t bound : op.getStaticLoopRanges()) {
+    if (ShapedType::isDynamic(bound) || bound % kMfmaTileSize != 0) {
+      return std::nullopt;
+    }
+  }
+
+  Type lhsType = getElementTypeOrSelf(op.getDpsInputOperand(0)->get());
+  Type rhsType = getElementTypeOrSelf(op.getDpsInputOperand(1)->get());
+  Type outType = getElementTypeOrSelf(op.getDpsInitOperand(0)->get());
+  if (lhsType != rhsType || !outType.isF32()) {
+    return std::nullopt;
+  }
+  if (lhsType.isF16()) {
+    return StringRef("F16F16F32");
+  }
+  if (lhsType.isBF16()) {
+    return StringRef("BF16BF16F32");
+  }
+  return std::nullopt;
+}
+
 //===----------------------------------------------------------------------===//
 // GPU Target Information
 //===----------------------------------------------------------------------===//
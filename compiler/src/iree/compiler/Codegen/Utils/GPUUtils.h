@@ -138,6 +138,15 @@ bool hasUkernelSupportedRocmArch(StringRef targetChip);
 /// Checks if targetAttr's GPU target has UKernel support.
 bool hasUkernelSupportedGpuArch(IREE::HAL::ExecutableTargetAttr targetAttr);
 
+/// Returns the type suffix of the ROCm matmul ukernel that can compute `op` on
+/// the target described by `targetAttr` or std::nullopt if there is none.
+/// The ukernel is only selected for static shapes that are multiples of the
+/// MFMA tile on chips with MFMA instructions, as generic codegen handles the
+/// other cases just as well.
+std::optional<StringRef>
+getRocmMatmulUkernelTypeSuffix(linalg::LinalgOp op,
+                               IREE::HAL::ExecutableTargetAttr targetAttr);
+
 //===----------------------------------------------------------------------===//
 // GPU Target Information
 //===----------------------------------------------------------------------===//
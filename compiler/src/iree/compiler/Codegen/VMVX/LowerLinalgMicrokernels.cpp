@@ -428,6 +428,77 @@ struct UnaryEmitter {
   }
 };
 
+/// Emits a vmvx reduction op accumulating into the result buffer.
+struct ReductionEmitter {
+  struct Descriptor {
+    Value buffer;
+    AffineMap indexingMap;
+    StridedBufferAnalysis bufferAnal;
+    StridedBufferDescriptor *bufferDesc = nullptr;
+    Descriptor(Value buffer, AffineMap indexingMap)
+        : buffer(buffer), indexingMap(indexingMap), bufferAnal(buffer) {}
+    unsigned getRank() { return indexingMap.getNumDims(); }
+  };
+  Descriptor operand;
+  Descriptor result;
+  // Lower-cased opcode suffix of the ukernel reduction op.
+  StringRef opcode;
+
+  ReductionEmitter(Descriptor operand, Descriptor result, StringRef opcode)
+      : operand(operand), result(result), opcode(opcode) {}
+
+  LogicalResult initialize(Location loc, PatternRewriter &rewriter) {
+    // The operand has to cover the whole iteration space for its sizes to
+    // give the loop bounds.
+    if (!operand.indexingMap.isPermutation() ||
+        !result.indexingMap.isProjectedPermutation()) {
+      return rewriter.notifyMatchFailure(loc, "not projected permutation");
+    }
+    if (operand.getRank() > 2)
+      return rewriter.notifyMatchFailure(loc, "rank > 2");
+    if (!operand.bufferAnal.isValid() || !result.bufferAnal.isValid()) {
+      return rewriter.notifyMatchFailure(loc,
+                                         "could not compute buffer descriptor");
+    }
+
+    // All pre-conditions pass. Mutate IR.
+    operand.bufferDesc = &operand.bufferAnal.getDesc(rewriter);
+    result.bufferDesc = &result.bufferAnal.getDesc(rewriter);
+    return success();
+  }
+
+  void emit(Location loc, PatternRewriter &rewriter) {
+    SmallVector<Value> inStrides = permuteStrides(
+        loc, operand.indexingMap, operand.bufferDesc->strides, rewriter);
+    // Reduced dimensions are absent from the result map and get a zero
+    // stride, accumulating all of their elements into the same result.
+    SmallVector<Value> outStrides = permuteStrides(
+        loc, result.indexingMap, result.bufferDesc->strides, rewriter);
+    SmallVector<Value> sizes(operand.getRank());
+    for (auto [resultPos, size] : llvm::enumerate(operand.bufferDesc->sizes)) {
+      sizes[operand.indexingMap.getDimPosition(resultPos)] = size;
+    }
+    Value inBuffer = operand.bufferDesc->castToLinear(loc, rewriter);
+    Value outBuffer = result.bufferDesc->castToLinear(loc, rewriter);
+
+    // Reductions support minimum of 2d indexing. Pad.
+    leftPadToRank(loc, inStrides, 2, 0, rewriter);
+    leftPadToRank(loc, outStrides, 2, 0, rewriter);
+    leftPadToRank(loc, sizes, 2, 1, rewriter);
+
+    rewriter.create<IREE::VMVX::ReduceOp>(
+        loc, rewriter.getStringAttr(opcode),
+        // IN
+        inBuffer, operand.bufferDesc->offset, inStrides,
+        // OUT
+        outBuffer, result.bufferDesc->offset, outStrides,
+        // Sizes
+        sizes,
+        // Attributes
+        operand.bufferDesc->getElementTypeAttr());
+  }
+};
+
 /// Emits a vmvx.copy op from/to a buffer/indexingMap pair.
 /// Only projected permutations are supported.
 struct CopyEmitter {
@@ -822,6 +893,71 @@ struct LinalgUnaryGenericConversion
   }
 };
 
+/// Matches a generic reducing its single input into its init with an
+/// expressible combiner, emitting as a vmvx op.
+struct LinalgReductionGenericConversion
+    : public OpRewritePattern<linalg::GenericOp> {
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::GenericOp op,
+                                PatternRewriter &rewriter) const override {
+    auto &children = op.getBlock()->getOperations();
+    // Only match two children (op + yield).
+    if (children.size() != 2)
+      return failure();
+    if (op.getNumReductionLoops() == 0 || op.getNumDpsInputs() != 1 ||
+        op.getNumDpsInits() != 1) {
+      return failure();
+    }
+
+    // Match:
+    //   %0 = someop %out, %in
+    //   yield %0
+    Operation *combinerOp = &children.front();
+    Operation *yieldOp = op.getBlock()->getTerminator();
+    if (combinerOp->getNumOperands() != 2 ||
+        yieldOp->getOperand(0) != combinerOp->getResult(0)) {
+      return failure();
+    }
+    Value in = op.getBlock()->getArgument(0);
+    Value out = op.getBlock()->getArgument(1);
+    if (!llvm::is_contained(combinerOp->getOperands(), in) ||
+        !llvm::is_contained(combinerOp->getOperands(), out)) {
+      return failure();
+    }
+
+    // Select the op to lower to. All combiners are commutative so the order
+    // of the operands doesn't matter.
+    Type resultType = combinerOp->getResult(0).getType();
+    if (!resultType.isIntOrFloat() || resultType.getIntOrFloatBitWidth() != 32)
+      return failure();
+    std::optional<StringRef> opcode =
+        TypeSwitch<Operation *, std::optional<StringRef>>(combinerOp)
+            .Case([](arith::AddFOp) { return StringRef("add"); })
+            .Case([](arith::AddIOp) { return StringRef("add"); })
+            .Case([](arith::MaximumFOp) { return StringRef("max"); })
+            .Case([](arith::MinimumFOp) { return StringRef("min"); })
+            .Default([](Operation *) { return std::nullopt; });
+    if (!opcode) {
+      return rewriter.notifyMatchFailure(op, "unrecognized reduction op");
+    }
+
+    OpOperand *input = op.getDpsInputOperand(0);
+    OpOperand *result = op.getDpsInitOperand(0);
+    ReductionEmitter emitter(
+        ReductionEmitter::Descriptor(input->get(),
+                                     op.getMatchingIndexingMap(input)),
+        ReductionEmitter::Descriptor(result->get(),
+                                     op.getMatchingIndexingMap(result)),
+        *opcode);
+    if (failed(emitter.initialize(op.getLoc(), rewriter)))
+      return failure();
+
+    emitter.emit(op.getLoc(), rewriter);
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 /// Matches a "trivial" generic which only yields, emitting as copy
 /// operation(s).
 struct LinalgTrivialGenericConversion
@@ -864,6 +1000,27 @@ struct LinalgTrivialGenericConversion
   }
 };
 
+/// Matches a linalg.transpose, emitting as a copy with permuted strides.
+struct LinalgTransposeConversion
+    : public OpRewritePattern<linalg::TransposeOp> {
+  using OpRewritePattern::OpRewritePattern;
+  LogicalResult matchAndRewrite(linalg::TransposeOp op,
+                                PatternRewriter &rewriter) const override {
+    CopyEmitter emitter;
+    OpOperand *input = op.getDpsInputOperand(0);
+    OpOperand *output = op.getDpsInitOperand(0);
+    emitter.copies.emplace_back(
+        CopyEmitter::Descriptor{input->get(), op.getMatchingIndexingMap(input)},
+        CopyEmitter::Descriptor{output->get(),
+                                op.getMatchingIndexingMap(output)});
+    if (failed(emitter.initialize(op.getLoc(), rewriter)))
+      return failure();
+    emitter.emit(op.getLoc(), rewriter);
+    rewriter.eraseOp(op);
+    return success();
+  }
+};
+
 struct LinalgFillConversion : public OpRewritePattern<linalg::FillOp> {
   using OpRewritePattern::OpRewritePattern;
   struct OpInfo {
@@ -926,10 +1083,10 @@ class VMVXLowerLinalgMicrokernelsPass
 
   void runOnOperation() override {
     RewritePatternSet patterns(&getContext());
-    patterns
-        .insert<LinalgBinaryGenericConversion, LinalgFillConversion,
-                LinalgTrivialGenericConversion, LinalgUnaryGenericConversion>(
-            &getContext());
+    patterns.insert<LinalgBinaryGenericConversion, LinalgFillConversion,
+                    LinalgReductionGenericConversion,
+                    LinalgTransposeConversion, LinalgTrivialGenericConversion,
+                    LinalgUnaryGenericConversion>(&getContext());
 
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
@@ -340,3 +340,60 @@ func.func @rsqrt(%arg0 : memref<64x64xf32>, %arg1 : memref<64xf32>) {
   }
   func.return
 }
+
+// Reductions.
+// CHECK-LABEL: @addf_row_reduction
+//   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG: %[[BB0:.*]], %[[OFFSET0:.*]], %[[SIZES0:.*]]:2, %[[STRIDES0:.*]]:2 = vmvx.get_buffer_descriptor %arg0
+//   CHECK-DAG: %[[BB1:.*]], %[[OFFSET1:.*]], %[[SIZE1:.*]], %[[STRIDE1:.*]] = vmvx.get_buffer_descriptor %arg1
+//       CHECK: vmvx.reduce op("add" : f32) in(%[[BB0]] offset %[[OFFSET0]] strides[%[[STRIDES0]]#0, %[[STRIDES0]]#1] : !util.buffer)
+//  CHECK-SAME:   out(%[[BB1]] offset %[[OFFSET1]] strides[%[[STRIDE1]], %[[C0]]] : !util.buffer)
+//  CHECK-SAME:   sizes(%[[SIZES0]]#0, %[[SIZES0]]#1)
+func.func @addf_row_reduction(%arg0 : memref<64x128xf32>, %arg1 : memref<64xf32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>], iterator_types = ["parallel", "reduction"]}
+    ins(%arg0 : memref<64x128xf32>) outs(%arg1 : memref<64xf32>) {
+  ^bb0(%arg2: f32, %arg3: f32):
+    %12 = arith.addf %arg3, %arg2 : f32
+    linalg.yield %12 : f32
+  }
+  func.return
+}
+
+// CHECK-LABEL: @maximumf_column_reduction
+//   CHECK-DAG: %[[C0:.*]] = arith.constant 0 : index
+//   CHECK-DAG: %[[BB0:.*]], %[[OFFSET0:.*]], %[[SIZES0:.*]]:2, %[[STRIDES0:.*]]:2 = vmvx.get_buffer_descriptor %arg0
+//   CHECK-DAG: %[[BB1:.*]], %[[OFFSET1:.*]], %[[SIZE1:.*]], %[[STRIDE1:.*]] = vmvx.get_buffer_descriptor %arg1
+//       CHECK: vmvx.reduce op("max" : f32) in(%[[BB0]] offset %[[OFFSET0]] strides[%[[STRIDES0]]#0, %[[STRIDES0]]#1] : !util.buffer)
+//  CHECK-SAME:   out(%[[BB1]] offset %[[OFFSET1]] strides[%[[C0]], %[[STRIDE1]]] : !util.buffer)
+//  CHECK-SAME:   sizes(%[[SIZES0]]#0, %[[SIZES0]]#1)
+func.func @maximumf_column_reduction(%arg0 : memref<64x128xf32>, %arg1 : memref<128xf32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>], iterator_types = ["reduction", "parallel"]}
+    ins(%arg0 : memref<64x128xf32>) outs(%arg1 : memref<128xf32>) {
+  ^bb0(%arg2: f32, %arg3: f32):
+    %12 = arith.maximumf %arg2, %arg3 : f32
+    linalg.yield %12 : f32
+  }
+  func.return
+}
+
+// CHECK-LABEL: @addi_full_reduction
+// CHECK: vmvx.reduce op("add" : i32)
+func.func @addi_full_reduction(%arg0 : memref<128xi32>, %arg1 : memref<i32>) {
+  linalg.generic {indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> ()>], iterator_types = ["reduction"]}
+    ins(%arg0 : memref<128xi32>) outs(%arg1 : memref<i32>) {
+  ^bb0(%arg2: i32, %arg3: i32):
+    %12 = arith.addi %arg2, %arg3 : i32
+    linalg.yield %12 : i32
+  }
+  func.return
+}
+
+// CHECK-LABEL: @transpose_to_copy
+//   CHECK-DAG: %[[BB0:.*]], %[[OFFSET0:.*]], %[[SIZES0:.*]]:2, %[[STRIDES0:.*]]:2 = vmvx.get_buffer_descriptor %arg0
+//   CHECK-DAG: %[[BB1:.*]], %[[OFFSET1:.*]], %[[SIZES1:.*]]:2, %[[STRIDES1:.*]]:2 = vmvx.get_buffer_descriptor %arg1
+//       CHECK: vmvx.copy in(%[[BB0]] offset %[[OFFSET0]] strides[%[[STRIDES0]]#1, %[[STRIDES0]]#0] : !util.buffer)
+//  CHECK-SAME:   out(%[[BB1]] offset %[[OFFSET1]] strides[%[[STRIDES1]]#0, %[[STRIDES1]]#1] : !util.buffer)
+func.func @transpose_to_copy(%arg0 : memref<64x128xf32>, %arg1 : memref<128x64xf32>) {
+  linalg.transpose ins(%arg0 : memref<64x128xf32>) outs(%arg1 : memref<128x64xf32>) permutation = [1, 0]
+  func.return
+}
@@ -12,17 +12,25 @@
 #include "iree/compiler/Dialect/Util/Analysis/Constant/OpOracle.h"
 #include "iree/compiler/Dialect/Util/IR/UtilOps.h"
 #include "iree/compiler/Pipelines/Pipelines.h"
+#include "iree/compiler/Tools/version.h"
 #include "iree/compiler/Utils/PassUtils.h"
 #include "llvm/ADT/DenseSet.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
 #include "llvm/Support/Timer.h"
 #include "llvm/Support/raw_ostream.h"
+#include "mlir/Bytecode/BytecodeWriter.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/IRMapping.h"
 #include "mlir/IR/SymbolTable.h"
+#include "mlir/Parser/Parser.h"
 
 #include <cstdlib>
 
@@ -43,6 +51,14 @@ static llvm::cl::opt<bool> clEnableDebug(
         "don't want to run a debug compiler)."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<std::string> clJitCachePath(
+    "iree-consteval-jit-cache-path",
+    llvm::cl::desc(
+        "Path to a cache of evaluated initializers keyed by their contents. "
+        "Initializers unchanged since a prior compilation reuse its results "
+        "and are neither compiled nor evaluated again."),
+    llvm::cl::init(""));
+
 namespace {
 
 static bool isDebugEnabled() {
@@ -405,8 +421,186 @@ struct JitFunctionDesc {
   std::string name;
   llvm::SmallVector<ArgumentBinding> argumentBindings;
   llvm::SmallVector<ResultBinding> resultBindings;
+  // Key of the function in the result cache or empty if it can't be cached.
+  std::string cacheKey;
+  // True if the results were loaded from the cache.
+  bool isCached = false;
 };
 
+//===----------------------------------------------------------------------===//
+// Result cache
+//===----------------------------------------------------------------------===//
+
+static constexpr StringLiteral kCachedResultsAttr = "iree.consteval.results";
+
+// Hashes the contents of |attr| without printing large dense data.
+static void hashAttr(llvm::SHA256 &hasher, Attribute attr) {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  if (auto typedAttr = dyn_cast<TypedAttr>(attr)) {
+    os << typedAttr.getType();
+  }
+  if (auto denseAttr = dyn_cast<DenseIntOrFPElementsAttr>(attr)) {
+    hasher.update(os.str());
+    ArrayRef<char> data = denseAttr.getRawData();
+    hasher.update(StringRef(data.data(), data.size()));
+    return;
+  }
+  if (auto resourceAttr = dyn_cast<DenseResourceElementsAttr>(attr)) {
+    if (AsmResourceBlob *blob = resourceAttr.getRawHandle().getBlob()) {
+      hasher.update(os.str());
+      ArrayRef<char> data = blob->getData();
+      hasher.update(StringRef(data.data(), data.size()));
+      return;
+    }
+  }
+  os << attr;
+  hasher.update(os.str());
+}
+
+// Computes the cache key of each function in |jitFunctions| from its IR, the
+// objects it references and its arguments. Arguments produced by other
+// functions are identified by the key of their producer so that keys can be
+// computed before anything is evaluated.
+static void computeCacheKeys(ModuleOp targetModuleOp, StringRef targetDevice,
+                             MutableArrayRef<JitFunctionDesc> jitFunctions) {
+  SymbolTable targetSymbolTable(targetModuleOp);
+  DenseMap<Operation *, std::string> producedGlobals;
+  OpPrintingFlags flags;
+  flags.useLocalScope();
+  for (JitFunctionDesc &jitFunction : jitFunctions) {
+    auto funcOp =
+        targetSymbolTable.lookup<IREE::Util::FuncOp>(jitFunction.name);
+    llvm::SHA256 hasher;
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    os << getIreeRevision() << "\n" << targetDevice << "\n";
+
+    // Function names depend on how many initializers precede them so they are
+    // left out of the key.
+    funcOp.setName("jit_eval");
+    funcOp->print(os, flags);
+    funcOp.setName(jitFunction.name);
+    DenseSet<Operation *> objectOps;
+    if (auto uses = SymbolTable::getSymbolUses(funcOp)) {
+      for (auto use : *uses) {
+        Operation *objectOp =
+            targetSymbolTable.lookup(use.getSymbolRef().getRootReference());
+        if (objectOp && objectOps.insert(objectOp).second) {
+          objectOp->print(os, flags);
+        }
+      }
+    }
+    hasher.update(os.str());
+
+    bool isCacheable = true;
+    for (ArgumentBinding &arg : jitFunction.argumentBindings) {
+      switch (arg.getType()) {
+      case ArgumentBinding::Type::ElementsAttr:
+        hashAttr(hasher, arg.getElementsAttr());
+        break;
+      case ArgumentBinding::Type::GlobalOp: {
+        auto globalOp = arg.getGlobalOp();
+        auto it = producedGlobals.find(globalOp);
+        if (it != producedGlobals.end()) {
+          hasher.update(it->second);
+        } else if (auto initialValue = globalOp.getGlobalInitialValue()) {
+          hashAttr(hasher, initialValue);
+        } else {
+          isCacheable = false;
+        }
+        break;
+      }
+      }
+    }
+    if (!isCacheable) {
+      continue;
+    }
+
+    jitFunction.cacheKey = llvm::toHex(hasher.result(), /*LowerCase=*/true);
+    for (auto it : llvm::enumerate(jitFunction.resultBindings)) {
+      producedGlobals[it.value().getGlobalOp()] =
+          jitFunction.cacheKey + ":" + std::to_string(it.index());
+    }
+  }
+}
+
+static std::string getCacheEntryPath(StringRef cachePath, StringRef key) {
+  SmallString<256> entryPath(cachePath);
+  llvm::sys::path::append(entryPath, key + ".mlirbc");
+  return entryPath.str().str();
+}
+
+// Sets the globals produced by |jitFunction| to the values cached by a prior
+// compilation. Returns false if there are none.
+static bool loadCachedResults(MLIRContext *context, StringRef cachePath,
+                              JitFunctionDesc &jitFunction) {
+  std::string entryPath = getCacheEntryPath(cachePath, jitFunction.cacheKey);
+  if (!llvm::sys::fs::exists(entryPath)) {
+    return false;
+  }
+  ParserConfig config(context);
+  auto entryOp = parseSourceFile<ModuleOp>(entryPath, config);
+  if (!entryOp) {
+    return false;
+  }
+  auto resultsAttr =
+      entryOp.get()->getAttrOfType<ArrayAttr>(kCachedResultsAttr);
+  if (!resultsAttr ||
+      resultsAttr.size() != jitFunction.resultBindings.size()) {
+    return false;
+  }
+  SmallVector<TypedAttr> results;
+  for (auto [resultBinding, attr] :
+       llvm::zip_equal(jitFunction.resultBindings, resultsAttr)) {
+    auto typedAttr = dyn_cast<TypedAttr>(attr);
+    if (!typedAttr ||
+        typedAttr.getType() != resultBinding.getGlobalOp().getGlobalType()) {
+      return false;
+    }
+    results.push_back(typedAttr);
+  }
+  for (auto [resultBinding, attr] :
+       llvm::zip_equal(jitFunction.resultBindings, results)) {
+    resultBinding.getGlobalOp().setGlobalInitialValue(attr);
+  }
+  return true;
+}
+
+// Stores the values |jitFunction| produced for its globals in the cache.
+// Entries are renamed into place so concurrent compilations never observe
+// partial ones. Failures are ignored as the cache is only an optimization.
+static void storeCachedResults(MLIRContext *context, StringRef cachePath,
+                               JitFunctionDesc &jitFunction) {
+  if (llvm::sys::fs::create_directories(cachePath)) {
+    return;
+  }
+  SmallVector<Attribute> results;
+  for (ResultBinding &resultBinding : jitFunction.resultBindings) {
+    results.push_back(resultBinding.getGlobalOp().getGlobalInitialValue());
+  }
+  OwningOpRef<ModuleOp> entryOp = ModuleOp::create(UnknownLoc::get(context));
+  entryOp.get()->setAttr(kCachedResultsAttr, ArrayAttr::get(context, results));
+
+  std::string entryPath = getCacheEntryPath(cachePath, jitFunction.cacheKey);
+  int fd = 0;
+  SmallString<256> tempPath;
+  if (llvm::sys::fs::createUniqueFile(entryPath + ".%%%%%%%%", fd, tempPath)) {
+    return;
+  }
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  bool failedToWrite = failed(writeBytecodeToFile(*entryOp, os));
+  os.close();
+  if (failedToWrite || os.has_error()) {
+    os.clear_error();
+    llvm::sys::fs::remove(tempPath);
+    return;
+  }
+  if (llvm::sys::fs::rename(tempPath, entryPath)) {
+    llvm::sys::fs::remove(tempPath);
+  }
+}
+
 // Clones all object-like symbols used within the function.
 // Objects are only cloned once if used by multiple functions.
 // All object contents are cloned and symbol DCE is relied on to remove any
@@ -697,6 +891,8 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
                    ModuleOp module, llvm::TimerGroup &tg) {
     // Process each function through the runtime.
     for (JitFunctionDesc &jitFunction : jitFunctions) {
+      if (jitFunction.isCached)
+        continue;
       std::optional<llvm::Timer> invokeTimer;
       if (debugEnabled) {
         std::string timerName("Invoke ");
@@ -823,6 +1019,41 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       return;
     }
 
+    // Reuse the results of functions evaluated by prior compilations and drop
+    // them from the program. If all were cached nothing needs to be compiled.
+    bool hasUncachedFunctions = true;
+    if (!clJitCachePath.empty()) {
+      computeCacheKeys(programBuilder.getTargetModule(), requestedTargetDevice,
+                       programBuilder.getJitFunctions());
+      hasUncachedFunctions = false;
+      for (JitFunctionDesc &jitFunction : programBuilder.getJitFunctions()) {
+        if (!jitFunction.cacheKey.empty() &&
+            loadCachedResults(&getContext(), clJitCachePath, jitFunction)) {
+          jitFunction.isCached = true;
+          SymbolTable::lookupSymbolIn(programBuilder.getTargetModule(),
+                                      jitFunction.name)
+              ->erase();
+        } else {
+          hasUncachedFunctions = true;
+        }
+      }
+      if (debugEnabled) {
+        llvm::dbgs() << "::: Loaded "
+                     << llvm::count_if(programBuilder.getJitFunctions(),
+                                       [](JitFunctionDesc &jitFunction) {
+                                         return jitFunction.isCached;
+                                       })
+                     << " consteval results from " << clJitCachePath << "\n";
+      }
+    }
+    if (!hasUncachedFunctions) {
+      programBuilder.getTargetModule()->erase();
+      for (auto deadOp : deadInitOps) {
+        deadOp.erase();
+      }
+      return;
+    }
+
     std::optional<llvm::Timer> compileTimer;
     if (debugEnabled) {
       llvm::dbgs() << "::: COMPILING JIT (" << requestedTargetDevice
@@ -852,6 +1083,13 @@ struct JitGlobalsPass : public JitGlobalsBase<JitGlobalsPass> {
       signalPassFailure();
       return;
     }
+    if (!clJitCachePath.empty()) {
+      for (JitFunctionDesc &jitFunction : programBuilder.getJitFunctions()) {
+        if (!jitFunction.isCached && !jitFunction.cacheKey.empty()) {
+          storeCachedResults(&getContext(), clJitCachePath, jitFunction);
+        }
+      }
+    }
 
     // Cleanup any initializers we replaced.
     // We do this after running the JIT-ed functions because we have deep
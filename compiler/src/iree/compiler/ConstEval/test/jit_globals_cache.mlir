@@ -0,0 +1,34 @@
+// RUN: rm -rf %t
+// RUN: iree-opt --iree-consteval-jit-globals --iree-consteval-jit-cache-path=%t %s | FileCheck %s
+// RUN: iree-opt --iree-consteval-jit-globals --iree-consteval-jit-cache-path=%t --iree-consteval-jit-debug %s 2>&1 | FileCheck %s --check-prefixes=CACHED,CHECK
+
+// Tests that the second compilation reuses the results of the first one
+// without compiling or evaluating anything.
+
+// CACHED: ::: Loaded 2 consteval results
+// CACHED-NOT: COMPILING JIT
+// CHECK-LABEL: @cached
+module @cached {
+  // CHECK: util.global private @hoisted = dense<4.000000e+02> : tensor<4xf32>
+  util.global private @hoisted : tensor<4xf32>
+  // CHECK: util.global private @dependent = dense<8.000000e+02> : tensor<4xf32>
+  util.global private @dependent : tensor<4xf32>
+  // CHECK-NOT: util.initializer
+  util.initializer {
+    %cst = arith.constant dense<2.0e+02> : tensor<4xf32>
+    %0 = arith.addf %cst, %cst : tensor<4xf32>
+    util.global.store %0, @hoisted : tensor<4xf32>
+    util.return
+  }
+  util.initializer {
+    %0 = util.global.load @hoisted : tensor<4xf32>
+    %1 = arith.addf %0, %0 : tensor<4xf32>
+    util.global.store %1, @dependent : tensor<4xf32>
+    util.return
+  }
+  util.func public @main() -> (tensor<4xf32>, tensor<4xf32>) {
+    %0 = util.global.load @hoisted : tensor<4xf32>
+    %1 = util.global.load @dependent : tensor<4xf32>
+    util.return %0, %1 : tensor<4xf32>, tensor<4xf32>
+  }
+}
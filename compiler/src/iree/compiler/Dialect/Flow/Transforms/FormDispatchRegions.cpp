@@ -702,6 +702,68 @@ fuseRootsWithConsumers(MLIRContext *context, ArrayRef<Operation *> roots,
   }
 }
 
+/// Returns true if the contraction producing |operand| can be fused into the
+/// consumer reducing the rows of its result, e.g. the max and sum of a softmax
+/// or the mean of a layer norm following a matmul. The reduced dimensions have
+/// to be the innermost parallel dimensions of the contraction and hold at most
+/// |maxReductionSize| elements so that a whole row fits in one tile.
+static bool isFusableRowReductionOfContraction(OpOperand &operand,
+                                               int64_t maxReductionSize) {
+  auto producer = operand.get().getDefiningOp<linalg::LinalgOp>();
+  if (maxReductionSize <= 0 || !producer || producer->getNumResults() != 1 ||
+      !linalg::isaContractionOpInterface(producer)) {
+    return false;
+  }
+  auto resultType = dyn_cast<RankedTensorType>(operand.get().getType());
+  if (!resultType || !resultType.hasStaticShape()) {
+    return false;
+  }
+
+  // The result must not be transposed so that the trailing dimensions of the
+  // result are the innermost parallel loops of the contraction.
+  AffineMap resultMap =
+      producer.getIndexingMapMatchingResult(cast<OpResult>(operand.get()));
+  if (!resultMap.isProjectedPermutation() ||
+      !llvm::is_sorted(resultMap.getResults(), [](AffineExpr a, AffineExpr b) {
+        return cast<AffineDimExpr>(a).getPosition() <
+               cast<AffineDimExpr>(b).getPosition();
+      })) {
+    return false;
+  }
+
+  // Find the dimensions of the result reduced by the consumer.
+  int64_t rank = resultType.getRank();
+  SmallVector<int64_t> reducedDims;
+  Operation *consumer = operand.getOwner();
+  if (auto softmaxOp = dyn_cast<linalg::SoftmaxOp>(consumer)) {
+    reducedDims.push_back(softmaxOp.getDimension());
+  } else if (auto genericOp = dyn_cast<linalg::GenericOp>(consumer)) {
+    if (genericOp.isDpsInit(&operand) ||
+        !genericOp.getMatchingIndexingMap(&operand).isIdentity()) {
+      return false;
+    }
+    for (auto [dim, iteratorType] :
+         llvm::enumerate(genericOp.getIteratorTypesArray())) {
+      if (linalg::isReductionIterator(iteratorType)) {
+        reducedDims.push_back(dim);
+      }
+    }
+  }
+  if (reducedDims.empty()) {
+    return false;
+  }
+
+  // Only rows (trailing dimensions) of the result may be reduced.
+  int64_t reductionSize = 1;
+  for (auto [index, dim] : llvm::enumerate(reducedDims)) {
+    if (dim != rank - static_cast<int64_t>(reducedDims.size() - index)) {
+      return false;
+    }
+    reductionSize *= resultType.getDimSize(dim);
+  }
+  return reductionSize <= maxReductionSize;
+}
+
 /// Method to check if the consumer of a use can be fused with its producer.
 static bool
 isFusableWithProducer(OpOperand &operand,
@@ -744,6 +806,11 @@ isFusableWithProducer(OpOperand &operand,
         .Default([](Operation *) { return false; });
   }
 
+  if (isFusableRowReductionOfContraction(operand,
+                                         options.maxFusedRowReductionSize)) {
+    return true;
+  }
+
   if (!isa<linalg::LinalgOp>(consumer) || !isa<linalg::LinalgOp>(producer)) {
     return false;
   }
@@ -984,7 +1051,8 @@ void FormDispatchRegionsPass::runOnOperation() {
   DominanceInfo const &dominanceInfo = getAnalysis<DominanceInfo>();
   TensorDimTrackingRewriter rewriter(funcOp);
   FormDispatchRegionsPassOptions options{aggressiveFusion, fusePadWithConsumers,
-                                         fusePadWithProducers};
+                                         fusePadWithProducers,
+                                         maxFusedRowReductionSize};
   if (failed(createFusionGroups(rewriter, funcOp, dominanceInfo, options))) {
     funcOp->emitOpError("failed to create fusion groups");
     return signalPassFailure();
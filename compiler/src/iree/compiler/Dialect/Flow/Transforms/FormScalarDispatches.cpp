@@ -9,9 +9,12 @@
 #include "llvm/Support/Debug.h"
 #include "mlir/Analysis/SliceAnalysis.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
+#include "mlir/IR/IRMapping.h"
 #include "mlir/IR/Iterators.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
 #include "mlir/Transforms/TopologicalSortUtils.h"
 
@@ -129,6 +132,118 @@ static bool isSliceRoot(int workload, Operation *op) {
          isScalarOperation(workload, op);
 }
 
+/// Returns the scalar value of the single element in |tensor| if it is
+/// available on the host without reading back from the device. Creates a
+/// constant at the current insertion point of |builder| if needed.
+static Value getHostAvailableScalar(OpBuilder &builder, Value tensor) {
+  auto tensorType = dyn_cast<RankedTensorType>(tensor.getType());
+  if (!tensorType || !tensorType.hasStaticShape() ||
+      tensorType.getNumElements() != 1) {
+    return {};
+  }
+  Operation *definingOp = tensor.getDefiningOp();
+  if (!definingOp) {
+    return {};
+  }
+  if (auto fromElementsOp = dyn_cast<tensor::FromElementsOp>(definingOp)) {
+    return fromElementsOp.getElements().front();
+  }
+  if (auto splatOp = dyn_cast<tensor::SplatOp>(definingOp)) {
+    return splatOp.getInput();
+  }
+  if (auto splatOp = dyn_cast<IREE::Flow::TensorSplatOp>(definingOp)) {
+    return splatOp.getValue();
+  }
+  SplatElementsAttr splatAttr;
+  if (matchPattern(tensor, m_Constant(&splatAttr))) {
+    return builder.create<arith::ConstantOp>(
+        definingOp->getLoc(), splatAttr.getSplatValue<TypedAttr>());
+  }
+  return {};
+}
+
+/// Returns `true` if |genericOp| operates on a single element and its body can
+/// be evaluated as scalar code outside of a dispatch.
+static bool isHostEvaluableGenericOp(linalg::GenericOp genericOp) {
+  if (!genericOp.hasPureTensorSemantics() ||
+      !isOperationWorkloadLessThanSizeN(1, genericOp)) {
+    return false;
+  }
+  for (Type resultType : genericOp->getResultTypes()) {
+    auto tensorType = dyn_cast<RankedTensorType>(resultType);
+    if (!tensorType || tensorType.getNumElements() != 1) {
+      return false;
+    }
+  }
+  for (Operation &bodyOp : genericOp.getBody()->without_terminator()) {
+    if (bodyOp.getNumRegions() != 0 || !isMemoryEffectFree(&bodyOp) ||
+        isa<linalg::IndexOp>(bodyOp)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/// Evaluates single element linalg.generic ops whose operands are all available
+/// on the host as scalar code on the host. These are commonly shape and control
+/// flow computations that would otherwise require a dispatch and a readback
+/// of the result before the host could continue. Results are rewrapped as
+/// tensors so that any device consumers see an upload of the value instead.
+static void evaluateHostScalarOps(RewriterBase &rewriter,
+                                  mlir::FunctionOpInterface funcOp) {
+  // Walk in order so that host evaluated producers make their consumers
+  // eligible as well.
+  SmallVector<linalg::GenericOp> candidateOps;
+  for (Block &block : funcOp.getFunctionBody()) {
+    for (auto genericOp : block.getOps<linalg::GenericOp>()) {
+      candidateOps.push_back(genericOp);
+    }
+  }
+  for (auto genericOp : candidateOps) {
+    if (!isHostEvaluableGenericOp(genericOp)) {
+      continue;
+    }
+
+    OpBuilder::InsertionGuard g(rewriter);
+    rewriter.setInsertionPoint(genericOp);
+    IRMapping mapping;
+    bool allHostAvailable = true;
+    for (OpOperand &operand : genericOp->getOpOperands()) {
+      BlockArgument blockArg = genericOp.getMatchingBlockArgument(&operand);
+      if (blockArg.use_empty()) {
+        continue; // e.g. unused outs
+      }
+      Value scalar = getHostAvailableScalar(rewriter, operand.get());
+      if (!scalar) {
+        allHostAvailable = false;
+        break;
+      }
+      mapping.map(blockArg, scalar);
+    }
+    if (!allHostAvailable) {
+      continue;
+    }
+
+    LLVM_DEBUG({
+      llvm::dbgs() << "Evaluating on host : ";
+      genericOp->print(llvm::dbgs());
+      llvm::dbgs() << "\n";
+    });
+    for (Operation &bodyOp : genericOp.getBody()->without_terminator()) {
+      rewriter.clone(bodyOp, mapping);
+    }
+    auto yieldOp = cast<linalg::YieldOp>(genericOp.getBody()->getTerminator());
+    SmallVector<Value> results;
+    for (auto [yieldedValue, resultType] :
+         llvm::zip_equal(yieldOp.getValues(), genericOp->getResultTypes())) {
+      results.push_back(rewriter.create<tensor::FromElementsOp>(
+          genericOp.getLoc(), resultType,
+          mapping.lookupOrDefault(yieldedValue)));
+    }
+    rewriter.replaceOp(genericOp, results);
+  }
+}
+
 // Form dispatch regions from slice of the operation.
 static FailureOr<DispatchRegionOp>
 formDispatchRegionFromSlice(RewriterBase &rewriter, Operation *rootOp,
@@ -154,6 +269,13 @@ void FormScalarDispatchesPass::runOnOperation() {
   mlir::FunctionOpInterface funcOp = getOperation();
   MLIRContext *context = &getContext();
 
+  // Keep scalar work whose inputs are already on the host there instead of
+  // round tripping through the device.
+  {
+    IRRewriter rewriter(context);
+    evaluateHostScalarOps(rewriter, funcOp);
+  }
+
   int scalarWorkloadLimit = 1;
   // Convenient struct to hold all operations that need to be moved into a
   // descriptor.
@@ -0,0 +1,215 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+//===--------------- FuseHorizontalElementwise.cpp ------------------------===//
+//
+// Batches independent small elementwise operations with the same iteration
+// space into a single multi-result operation so that they form one dispatch.
+//
+//===----------------------------------------------------------------------===//
+
+#include <limits>
+#include <map>
+
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Flow/Transforms/RegionOpUtils.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Linalg/IR/Linalg.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/PatternMatch.h"
+
+#define DEBUG_TYPE "iree-flow-fuse-horizontal-elementwise"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+#define GEN_PASS_DEF_FUSEHORIZONTALELEMENTWISEPASS
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h.inc"
+
+namespace {
+
+/// Elementwise ops that are to be fused, in block order.
+struct HorizontalFusionGroup {
+  SmallVector<linalg::GenericOp> ops;
+  // Position in the block of the first user of any of the ops. Ops may only
+  // be added to the group if they come before it as the fused op replaces all
+  // of them at the position of the last one.
+  size_t firstUsePosition = std::numeric_limits<size_t>::max();
+};
+
+} // namespace
+
+/// Returns the static iteration space of |genericOp| if it is an elementwise
+/// op on tensors with at most |maxElements| iterations.
+static std::optional<SmallVector<int64_t>>
+getFusableIterationSpace(linalg::GenericOp genericOp, int64_t maxElements) {
+  if (!genericOp.hasPureTensorSemantics() ||
+      genericOp.getNumParallelLoops() != genericOp.getNumLoops() ||
+      !isNonNullAndOutsideDispatch(genericOp)) {
+    return std::nullopt;
+  }
+  SmallVector<int64_t> loopRanges = genericOp.getStaticLoopRanges();
+  int64_t elementCount = 1;
+  for (int64_t range : loopRanges) {
+    if (ShapedType::isDynamic(range)) {
+      return std::nullopt;
+    }
+    elementCount *= range;
+  }
+  if (elementCount > maxElements) {
+    return std::nullopt;
+  }
+  return loopRanges;
+}
+
+/// Returns the position of the first user of the results of |op| within
+/// |block| given the |positions| of the ops in it. Users outside of the block
+/// are dominated by the whole block and don't constrain the fusion.
+static size_t
+getFirstUsePosition(Operation *op, Block &block,
+                    const DenseMap<Operation *, size_t> &positions) {
+  size_t firstUsePosition = std::numeric_limits<size_t>::max();
+  for (Operation *user : op->getUsers()) {
+    if (Operation *ancestor = block.findAncestorOpInBlock(*user)) {
+      firstUsePosition =
+          std::min(firstUsePosition, positions.lookup(ancestor));
+    }
+  }
+  return firstUsePosition;
+}
+
+/// Collects groups of independent fusable elementwise ops in |block|.
+static SmallVector<HorizontalFusionGroup>
+collectFusionGroups(Block &block, int64_t maxElements) {
+  DenseMap<Operation *, size_t> positions;
+  for (auto [position, op] : llvm::enumerate(block)) {
+    positions[&op] = position;
+  }
+
+  SmallVector<HorizontalFusionGroup> fusionGroups;
+  std::map<SmallVector<int64_t>, HorizontalFusionGroup> openGroups;
+  auto closeGroup = [&](HorizontalFusionGroup &group) {
+    if (group.ops.size() > 1) {
+      fusionGroups.push_back(std::move(group));
+    }
+    group = HorizontalFusionGroup{};
+  };
+  for (auto &op : block) {
+    auto genericOp = dyn_cast<linalg::GenericOp>(op);
+    if (!genericOp) {
+      continue;
+    }
+    auto iterationSpace = getFusableIterationSpace(genericOp, maxElements);
+    if (!iterationSpace) {
+      continue;
+    }
+    // An op can't join a group if any member's results are used before it,
+    // either directly or through other ops it depends on.
+    auto &group = openGroups[*iterationSpace];
+    if (group.firstUsePosition <= positions[&op]) {
+      closeGroup(group);
+    }
+    group.ops.push_back(genericOp);
+    group.firstUsePosition = std::min(
+        group.firstUsePosition, getFirstUsePosition(&op, block, positions));
+  }
+  for (auto &[iterationSpace, group] : openGroups) {
+    closeGroup(group);
+  }
+  return fusionGroups;
+}
+
+/// Replaces the ops in |group| with a single generic op at the position of the
+/// last one that takes all of their inputs and produces all of their results.
+static void fuseGroup(RewriterBase &rewriter, HorizontalFusionGroup &group) {
+  linalg::GenericOp lastOp = group.ops.back();
+  rewriter.setInsertionPoint(lastOp);
+
+  SmallVector<Value> inputs;
+  SmallVector<Value> inits;
+  SmallVector<AffineMap> inputMaps;
+  SmallVector<AffineMap> initMaps;
+  SmallVector<Type> resultTypes;
+  SmallVector<Location> locs;
+  for (auto genericOp : group.ops) {
+    for (OpOperand *operand : genericOp.getDpsInputOperands()) {
+      inputs.push_back(operand->get());
+      inputMaps.push_back(genericOp.getMatchingIndexingMap(operand));
+    }
+    for (OpOperand &operand : genericOp.getDpsInitsMutable()) {
+      inits.push_back(operand.get());
+      initMaps.push_back(genericOp.getMatchingIndexingMap(&operand));
+    }
+    llvm::append_range(resultTypes, genericOp->getResultTypes());
+    locs.push_back(genericOp.getLoc());
+  }
+  SmallVector<AffineMap> indexingMaps = std::move(inputMaps);
+  llvm::append_range(indexingMaps, initMaps);
+  SmallVector<utils::IteratorType> iteratorTypes(
+      lastOp.getNumLoops(), utils::IteratorType::parallel);
+
+  auto fusedOp = rewriter.create<linalg::GenericOp>(
+      rewriter.getFusedLoc(locs), resultTypes, inputs, inits, indexingMaps,
+      iteratorTypes,
+      [&](OpBuilder &builder, Location loc, ValueRange args) {
+        IRMapping mapping;
+        SmallVector<Value> yieldedValues;
+        size_t inputOffset = 0;
+        size_t initOffset = inputs.size();
+        for (auto genericOp : group.ops) {
+          Block *body = genericOp.getBody();
+          for (OpOperand *operand : genericOp.getDpsInputOperands()) {
+            mapping.map(genericOp.getMatchingBlockArgument(operand),
+                        args[inputOffset++]);
+          }
+          for (OpOperand &operand : genericOp.getDpsInitsMutable()) {
+            mapping.map(genericOp.getMatchingBlockArgument(&operand),
+                        args[initOffset++]);
+          }
+          for (auto &bodyOp : body->without_terminator()) {
+            builder.clone(bodyOp, mapping);
+          }
+          for (Value yielded : body->getTerminator()->getOperands()) {
+            yieldedValues.push_back(mapping.lookupOrDefault(yielded));
+          }
+        }
+        builder.create<linalg::YieldOp>(loc, yieldedValues);
+      });
+
+  unsigned resultOffset = 0;
+  for (auto genericOp : group.ops) {
+    unsigned resultCount = genericOp->getNumResults();
+    rewriter.replaceOp(genericOp,
+                       fusedOp->getResults().slice(resultOffset, resultCount));
+    resultOffset += resultCount;
+  }
+}
+
+namespace {
+
+struct FuseHorizontalElementwisePass
+    : public IREE::Flow::impl::FuseHorizontalElementwisePassBase<
+          FuseHorizontalElementwisePass> {
+  using IREE::Flow::impl::FuseHorizontalElementwisePassBase<
+      FuseHorizontalElementwisePass>::FuseHorizontalElementwisePassBase;
+  void runOnOperation() override {
+    SmallVector<HorizontalFusionGroup> fusionGroups;
+    getOperation()->walk([&](Block *block) {
+      llvm::append_range(fusionGroups,
+                         collectFusionGroups(*block, maxElements));
+    });
+    LLVM_DEBUG(llvm::dbgs() << "fusing " << fusionGroups.size()
+                            << " groups of elementwise ops\n");
+
+    IRRewriter rewriter(&getContext());
+    for (auto &group : fusionGroups) {
+      fuseGroup(rewriter, group);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Flow
@@ -0,0 +1,217 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Utils/EquivalenceUtils.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/FunctionInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-flow-parameterize-executable-constants"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+#define GEN_PASS_DEF_PARAMETERIZEEXECUTABLECONSTANTSPASS
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h.inc"
+
+namespace {
+
+// An executable with a single export and function that is only dispatched
+// directly and may have its scalar constants promoted to operands.
+struct ExecutableInfo {
+  ExecutableOp executableOp;
+  mlir::FunctionOpInterface funcOp;
+  // Scalar integer and floating-point constants in walk order.
+  SmallVector<arith::ConstantOp> constantOps;
+  // Original values of |constantOps| while they are masked for comparison.
+  SmallVector<TypedAttr> constantValues;
+  // All dispatch sites of the export.
+  SmallVector<DispatchOp> dispatchOps;
+};
+
+} // namespace
+
+static bool isPromotableConstant(arith::ConstantOp constantOp) {
+  return isa<IntegerType, FloatType>(constantOp.getType());
+}
+
+// Gathers executables whose dispatch sites can all be updated with new
+// operands. Executables referenced by multi-entry-point dispatches or through
+// more than one export are skipped.
+static SmallVector<ExecutableInfo> gatherExecutables(mlir::ModuleOp moduleOp) {
+  DenseMap<StringRef, SmallVector<DispatchOp>> dispatchMap;
+  DenseSet<StringRef> ineligibleExecutables;
+  moduleOp.walk([&](DispatchOp dispatchOp) {
+    for (SymbolRefAttr entryPointAttr : dispatchOp.getEntryPointRefs()) {
+      StringRef executableName = entryPointAttr.getRootReference().getValue();
+      if (dispatchOp.getEntryPoints().size() != 1) {
+        ineligibleExecutables.insert(executableName);
+      } else {
+        dispatchMap[executableName].push_back(dispatchOp);
+      }
+    }
+  });
+
+  SmallVector<ExecutableInfo> executables;
+  for (auto executableOp : moduleOp.getOps<ExecutableOp>()) {
+    auto it = dispatchMap.find(executableOp.getSymName());
+    if (it == dispatchMap.end() ||
+        ineligibleExecutables.contains(executableOp.getSymName())) {
+      continue;
+    }
+    auto exportOps = llvm::to_vector(executableOp.getOps<ExecutableExportOp>());
+    auto innerModuleOp = executableOp.getInnerModule();
+    if (exportOps.size() != 1 || !innerModuleOp) {
+      continue;
+    }
+    auto funcOp = innerModuleOp.lookupSymbol<mlir::FunctionOpInterface>(
+        exportOps.front().getFunctionRef());
+    if (!funcOp || funcOp.isExternal()) {
+      continue;
+    }
+    ExecutableInfo info;
+    info.executableOp = executableOp;
+    info.funcOp = funcOp;
+    info.dispatchOps = it->second;
+    funcOp.walk([&](arith::ConstantOp constantOp) {
+      if (isPromotableConstant(constantOp)) {
+        info.constantOps.push_back(constantOp);
+      }
+    });
+    if (info.constantOps.empty()) {
+      continue;
+    }
+    executables.push_back(std::move(info));
+  }
+  return executables;
+}
+
+// Promotes the constants at |positions| in each of |executables| to trailing
+// function arguments and passes their original values from every dispatch
+// site.
+static void promoteConstants(ArrayRef<ExecutableInfo *> executables,
+                             ArrayRef<unsigned> positions) {
+  for (ExecutableInfo *info : executables) {
+    // Function arguments match the dispatch arguments followed by any result
+    // bindings so the new arguments go directly after the existing operands.
+    unsigned argIndex = info->dispatchOps.front().getArguments().size();
+    for (unsigned position : positions) {
+      arith::ConstantOp constantOp = info->constantOps[position];
+      TypedAttr value = info->constantValues[position];
+      info->funcOp.insertArgument(argIndex, constantOp.getType(),
+                                  /*argAttrs=*/nullptr, constantOp.getLoc());
+      constantOp.getResult().replaceAllUsesWith(
+          info->funcOp.getArgument(argIndex));
+      constantOp.erase();
+      ++argIndex;
+      for (DispatchOp dispatchOp : info->dispatchOps) {
+        OpBuilder builder(dispatchOp);
+        Value operand =
+            builder.create<arith::ConstantOp>(dispatchOp.getLoc(), value);
+        dispatchOp.getArgumentsMutable().append(operand);
+      }
+    }
+  }
+}
+
+namespace {
+
+struct ParameterizeExecutableConstantsPass
+    : public IREE::Flow::impl::ParameterizeExecutableConstantsPassBase<
+          ParameterizeExecutableConstantsPass> {
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    SmallVector<ExecutableInfo> executables = gatherExecutables(moduleOp);
+    if (executables.size() < 2) {
+      return;
+    }
+
+    // Mask all candidate constants so that executables only differing in
+    // their values compare as equivalent.
+    for (ExecutableInfo &info : executables) {
+      for (arith::ConstantOp constantOp : info.constantOps) {
+        info.constantValues.push_back(constantOp.getValue());
+        OpBuilder builder(constantOp);
+        constantOp.setValueAttr(
+            cast<TypedAttr>(builder.getZeroAttr(constantOp.getType())));
+      }
+    }
+
+    // Bucket like DeduplicateExecutables does so that only plausible pairs
+    // are compared structurally.
+    llvm::MapVector<uint32_t, SmallVector<ExecutableInfo *>> bucketMap;
+    for (ExecutableInfo &info : executables) {
+      int count = 0;
+      llvm::hash_code hash(1);
+      info.funcOp->walk([&](Operation *op) {
+        hash = llvm::hash_combine(hash, op->getName());
+        return ++count >= 5 ? WalkResult::interrupt() : WalkResult::advance();
+      });
+      bucketMap[hash_value(hash)].push_back(&info);
+    }
+    SmallVector<SmallVector<ExecutableInfo *>> groups;
+    OperationEquivalenceCache equivalenceCache(moduleOp.getContext());
+    for (auto &[key, bucket] : bucketMap) {
+      (void)key;
+      SmallVector<SmallVector<ExecutableInfo *>> bucketGroups;
+      for (ExecutableInfo *info : bucket) {
+        auto groupIt = llvm::find_if(bucketGroups, [&](auto &group) {
+          return isStructurallyEquivalentTo(equivalenceCache,
+                                            *group.front()->executableOp,
+                                            *info->executableOp);
+        });
+        if (groupIt == bucketGroups.end()) {
+          bucketGroups.push_back({info});
+        } else {
+          groupIt->push_back(info);
+        }
+      }
+      for (auto &group : bucketGroups) {
+        if (group.size() > 1) {
+          groups.push_back(std::move(group));
+        }
+      }
+    }
+
+    // Restore the original values before rewriting anything.
+    for (ExecutableInfo &info : executables) {
+      for (auto [constantOp, value] :
+           llvm::zip_equal(info.constantOps, info.constantValues)) {
+        constantOp.setValueAttr(value);
+      }
+    }
+
+    // Only constants that differ within a group are promoted; those that are
+    // the same everywhere stay inline in the executable.
+    for (auto &group : groups) {
+      SmallVector<unsigned> positions;
+      ExecutableInfo *referenceInfo = group.front();
+      for (unsigned i = 0, e = referenceInfo->constantOps.size(); i < e; ++i) {
+        if (llvm::any_of(group, [&](ExecutableInfo *info) {
+              return info->constantValues[i] !=
+                     referenceInfo->constantValues[i];
+            })) {
+          positions.push_back(i);
+        }
+      }
+      if (positions.empty()) {
+        continue; // already identical; left to DeduplicateExecutables
+      }
+      LLVM_DEBUG(llvm::dbgs()
+                 << "[" DEBUG_TYPE "] promoting " << positions.size()
+                 << " constant(s) in " << group.size() << " executables\n");
+      promoteConstants(group, positions);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Flow
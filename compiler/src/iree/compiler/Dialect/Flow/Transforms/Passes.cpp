@@ -31,6 +31,13 @@ static llvm::cl::opt<bool> clExportBenchmarkFuncs(
         "unique flow.executable that dispatches with dummy arguments."),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clParameterizeExecutableConstants(
+    "iree-flow-parameterize-executable-constants",
+    llvm::cl::desc("Promotes scalar constants that are the only difference "
+                   "between executables to dispatch operands so that the "
+                   "executables can be deduplicated."),
+    llvm::cl::init(false));
+
 // TODO(ravishankarm): Change to a pipeline option.
 static llvm::cl::opt<bool> clTraceDispatchTensors(
     "iree-flow-trace-dispatch-tensors",
@@ -94,6 +101,19 @@ static llvm::cl::opt<bool> clEnableAggressiveFusion(
                    "since all backends dont support it yet"),
     llvm::cl::init(false));
 
+static llvm::cl::opt<bool> clEnableHorizontalElementwiseFusion(
+    "iree-flow-enable-horizontal-elementwise-fusion",
+    llvm::cl::desc("Fuse independent small elementwise ops with the same "
+                   "iteration space into one dispatch."),
+    llvm::cl::init(false));
+
+static llvm::cl::opt<int64_t> clMaxFusedRowReductionSize(
+    "iree-flow-max-fused-row-reduction-size",
+    llvm::cl::desc("Fuse contractions (matmuls) with consumers reducing rows "
+                   "of their result (softmax, layer norm) when a row has at "
+                   "most this many elements; 0 to disable."),
+    llvm::cl::init(0));
+
 static llvm::cl::opt<bool>
     clDumpDispatchGraph("iree-flow-dump-dispatch-graph",
                         llvm::cl::desc("Dump a dot graph for dispatches."),
@@ -218,6 +238,10 @@ void addDispatchRegionCreationPasses(OpPassManager &passManager,
       // identity. This helps fusing named linalg op with a generic op with
       // transpose.
       .addPass(IREE::Flow::createInterchangeTransposeGenericOpsPass)
+      // Batch the remaining small independent elementwise ops so that they
+      // form a single dispatch.
+      .addPredicatedPass(clEnableHorizontalElementwiseFusion,
+                         IREE::Flow::createFuseHorizontalElementwisePass)
 
       // Only want use the transform dialect for some dispatch regions and let
       // the FormDispatchRegions handle the rest. This only moves the root
@@ -237,7 +261,8 @@ void addDispatchRegionCreationPasses(OpPassManager &passManager,
             FormDispatchRegionsPassOptions{
                 clEnableAggressiveFusion,
                 clEnableFusePaddingIntoLinalgConsumerOps,
-                clEnableFusePaddingIntoLinalgProducerOps});
+                clEnableFusePaddingIntoLinalgProducerOps,
+                clMaxFusedRowReductionSize});
       })
       // Clone all producers into the dispatch region to perpare for being
       // isolated from above. This enables running additional transformations
@@ -307,6 +332,11 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
   // runtime profiling/tracing.
   passManager.addPass(IREE::Flow::createAnnotateDispatchesPass());
 
+  // Specialize annotated dispatches for their common workloads. This must run
+  // before deduplication so that variants of different dispatches with the
+  // same contents can be merged.
+  passManager.addPass(IREE::Flow::createSpecializeDispatchWorkloadsPass());
+
   // Trace/break dispatches by ordinal in the specified region. There is a
   // similar version of the pass run both before and after deduplication
   // depending on if the target is specified by ordinal or by symbol.
@@ -332,6 +362,14 @@ void buildFlowTransformPassPipeline(OpPassManager &passManager,
   // Cleanup identity ops that clutter up the IR and canonicalize.
   FunctionLikeNest(passManager).addPass(mlir::createCanonicalizerPass);
 
+  // Generalize executables that differ only in scalar constants by passing the
+  // constants as operands. Operands that end up uniform across all dispatch
+  // sites are folded back in by the stream dialect.
+  if (clParameterizeExecutableConstants) {
+    passManager.addPass(
+        IREE::Flow::createParameterizeExecutableConstantsPass());
+  }
+
   // Deduplicate executables created from dispatch regions.
   // Note: this only deduplicates equivalent executables. We could in addition
   // generalize executables to prune further (e.g. by promoting a dimension to
@@ -0,0 +1,227 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <functional>
+#include <string>
+
+#include "iree/compiler/Dialect/Flow/IR/FlowOps.h"
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-flow-specialize-dispatch-workloads"
+
+namespace mlir::iree_compiler::IREE::Flow {
+
+#define GEN_PASS_DEF_SPECIALIZEDISPATCHWORKLOADSPASS
+#include "iree/compiler/Dialect/Flow/Transforms/Passes.h.inc"
+
+// Attribute on dispatches listing the workloads to specialize them for.
+static constexpr StringLiteral kWorkloadBucketsAttr = "flow.workload_buckets";
+
+namespace {
+
+// Specialized exports keyed on the original export and the workload bucket so
+// that dispatches of the same export share their variants.
+using SpecializationMap =
+    DenseMap<std::pair<Operation *, Attribute>, SymbolRefAttr>;
+
+} // namespace
+
+// Returns the buckets in |attr| if each has one entry per workload value.
+static FailureOr<SmallVector<DenseI64ArrayAttr>>
+getWorkloadBuckets(IREE::Flow::DispatchOp dispatchOp, ArrayAttr attr) {
+  SmallVector<DenseI64ArrayAttr> buckets;
+  for (auto bucketAttr : attr) {
+    auto bucket = dyn_cast<DenseI64ArrayAttr>(bucketAttr);
+    if (!bucket || bucket.size() != dispatchOp.getWorkload().size()) {
+      return dispatchOp.emitOpError()
+             << "expected " << kWorkloadBucketsAttr
+             << " to contain arrays with one entry per workload value";
+    }
+    buckets.push_back(bucket);
+  }
+  return buckets;
+}
+
+// Clones the executable containing |exportOp| with the workload values in
+// |bucket| made constant in its body and returns the cloned export.
+static SymbolRefAttr
+createSpecializedExport(IREE::Flow::ExecutableExportOp exportOp,
+                        DenseI64ArrayAttr bucket, SymbolTable &symbolTable) {
+  auto executableOp = exportOp->getParentOfType<IREE::Flow::ExecutableOp>();
+  std::string name = executableOp.getSymName().str() + "_workload";
+  for (int64_t value : bucket.asArrayRef()) {
+    name += value < 0 ? std::string("_any") : "_" + std::to_string(value);
+  }
+  auto specializedOp = executableOp.clone();
+  specializedOp.setName(name);
+  symbolTable.insert(specializedOp, std::next(Block::iterator(executableOp)));
+
+  // Workload ordinals mark the values the workload was derived from; the ones
+  // known in this variant are replaced so that shapes become static.
+  specializedOp.walk([&](IREE::Flow::DispatchWorkloadOrdinalOp ordinalOp) {
+    int64_t value = bucket[ordinalOp.getOrdinal().getZExtValue()];
+    if (value < 0) {
+      return;
+    }
+    OpBuilder builder(ordinalOp);
+    Value constantOp =
+        builder.create<arith::ConstantIndexOp>(ordinalOp.getLoc(), value);
+    ordinalOp.replaceAllUsesWith(constantOp);
+    ordinalOp.erase();
+  });
+
+  auto exportRefAttr = FlatSymbolRefAttr::get(exportOp.getSymNameAttr());
+  return SymbolRefAttr::get(specializedOp.getSymNameAttr(), {exportRefAttr});
+}
+
+// Returns the condition under which |workload| matches |bucket| or nullptr if
+// the bucket matches any workload.
+static Value buildBucketCondition(OpBuilder &builder, Location loc,
+                                  ValueRange workload,
+                                  DenseI64ArrayAttr bucket) {
+  Value condition;
+  for (auto [value, bucketValue] : llvm::zip_equal(workload, bucket)) {
+    if (bucketValue < 0) {
+      continue;
+    }
+    Value bucketConstant =
+        builder.create<arith::ConstantIndexOp>(loc, bucketValue);
+    Value isEqual = builder.create<arith::CmpIOp>(
+        loc, arith::CmpIPredicate::eq, value, bucketConstant);
+    condition = condition
+                    ? builder.create<arith::AndIOp>(loc, condition, isEqual)
+                    : isEqual;
+  }
+  return condition;
+}
+
+// Replaces |dispatchOp| with a chain of conditions selecting the variant
+// specialized for the workload bucket matching at runtime, if any, and the
+// original generic dispatch otherwise.
+static LogicalResult specializeDispatch(IREE::Flow::DispatchOp dispatchOp,
+                                        SymbolTable &symbolTable,
+                                        SpecializationMap &specializations) {
+  auto bucketsAttr = dispatchOp->getAttrOfType<ArrayAttr>(kWorkloadBucketsAttr);
+  dispatchOp->removeAttr(kWorkloadBucketsAttr);
+  auto buckets = getWorkloadBuckets(dispatchOp, bucketsAttr);
+  if (failed(buckets)) {
+    return failure();
+  }
+  auto entryPoints = dispatchOp.getEntryPointRefs();
+  if (entryPoints.size() != 1) {
+    // Dispatches with multiple entry points select one at runtime already.
+    return success();
+  }
+  auto exportOp =
+      SymbolTable::lookupNearestSymbolFrom<IREE::Flow::ExecutableExportOp>(
+          dispatchOp, entryPoints.front());
+  if (!exportOp) {
+    return dispatchOp.emitOpError() << "entry point not found";
+  }
+
+  OpBuilder builder(dispatchOp);
+  Location loc = dispatchOp.getLoc();
+  SmallVector<std::pair<Value, SymbolRefAttr>> variants;
+  for (auto bucket : *buckets) {
+    Value condition =
+        buildBucketCondition(builder, loc, dispatchOp.getWorkload(), bucket);
+    if (!condition) {
+      continue;
+    }
+    auto &entryPoint = specializations[{exportOp, bucket}];
+    if (!entryPoint) {
+      entryPoint = createSpecializedExport(exportOp, bucket, symbolTable);
+    }
+    variants.push_back({condition, entryPoint});
+  }
+  if (variants.empty()) {
+    return success();
+  }
+
+  // Builds the dispatch of the variant at |index| or the generic dispatch if
+  // there are no more variants, nesting the remaining ones in its else branch.
+  std::function<ValueRange(OpBuilder &, unsigned)> buildVariant =
+      [&](OpBuilder &builder, unsigned index) -> ValueRange {
+    if (index == variants.size()) {
+      return builder.clone(*dispatchOp)->getResults();
+    }
+    Value condition = variants[index].first;
+    SymbolRefAttr entryPoint = variants[index].second;
+    auto ifOp = builder.create<scf::IfOp>(
+        loc, condition,
+        [&](OpBuilder &thenBuilder, Location loc) {
+          auto variantOp =
+              cast<IREE::Flow::DispatchOp>(thenBuilder.clone(*dispatchOp));
+          variantOp.setEntryPointsAttr(builder.getArrayAttr({entryPoint}));
+          thenBuilder.create<scf::YieldOp>(loc, variantOp.getResults());
+        },
+        [&](OpBuilder &elseBuilder, Location loc) {
+          elseBuilder.create<scf::YieldOp>(
+              loc, buildVariant(elseBuilder, index + 1));
+        });
+    return ifOp.getResults();
+  };
+  SmallVector<Value> results = llvm::to_vector(buildVariant(builder, 0));
+
+  // Results leaving the conditions lose their association with the dynamic
+  // dimensions of the dispatch results so make it explicit again.
+  for (auto [index, result] : llvm::enumerate(results)) {
+    ValueRange dynamicDims = dispatchOp.getResultDynamicDims(index);
+    if (!dynamicDims.empty()) {
+      result = builder.create<IREE::Flow::TensorTieShapeOp>(loc, result,
+                                                            dynamicDims);
+    }
+  }
+  dispatchOp.replaceAllUsesWith(results);
+  dispatchOp.erase();
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// --iree-flow-specialize-dispatch-workloads
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct SpecializeDispatchWorkloadsPass
+    : public IREE::Flow::impl::SpecializeDispatchWorkloadsPassBase<
+          SpecializeDispatchWorkloadsPass> {
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+    SmallVector<IREE::Flow::DispatchOp> dispatchOps;
+    moduleOp.walk([&](IREE::Flow::DispatchOp dispatchOp) {
+      if (dispatchOp->hasAttr(kWorkloadBucketsAttr)) {
+        dispatchOps.push_back(dispatchOp);
+      }
+    });
+    if (dispatchOps.empty()) {
+      return;
+    }
+
+    SymbolTable symbolTable(moduleOp);
+    SpecializationMap specializations;
+    for (auto dispatchOp : dispatchOps) {
+      if (failed(
+              specializeDispatch(dispatchOp, symbolTable, specializations))) {
+        return signalPassFailure();
+      }
+    }
+    LLVM_DEBUG(llvm::dbgs() << "created " << specializations.size()
+                            << " specialized dispatch variants\n");
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Flow
@@ -11,7 +11,9 @@
 //===----------------------------------------------------------------------===//
 
 #include "iree/compiler/Dialect/Flow/Transforms/Passes.h"
+#include "iree/compiler/Dialect/HAL/IR/HALTypes.h"
 #include "iree/compiler/Dialect/LinalgExt/Transforms/Passes.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Linalg/Transforms/Transforms.h"
@@ -27,11 +29,67 @@ static llvm::cl::opt<int64_t>
     splitReductionRatio("iree-flow-split-matmul-reduction",
                         llvm::cl::desc("split ratio"), llvm::cl::init(1));
 
+static llvm::cl::opt<bool> splitMatmulReductionForGPU(
+    "iree-flow-split-matmul-reduction-for-gpu",
+    llvm::cl::desc("Splits the reduction of matmuls with too few output tiles "
+                   "to occupy the compute units of GPU targets. Partial "
+                   "products are reduced in a second dispatch."),
+    llvm::cl::init(false));
+
 static llvm::cl::list<int64_t> topkSplitReductionRatio(
     "iree-flow-topk-split-reduction",
     llvm::cl::desc("comma separated list of split ratios"),
     llvm::cl::CommaSeparated);
 
+// Output tile size assumed for a workgroup of the GPU matmul pipelines.
+static constexpr int64_t kGPUWorkgroupTileSize = 64;
+// Smallest reduction size worth giving to a split.
+static constexpr int64_t kGPUMinSplitReductionSize = 512;
+
+// Returns the smallest number of compute units of the executable targets |op|
+// may run on or 0 if any of them doesn't specify one.
+static int64_t getGPUComputeUnitCount(Operation *op) {
+  int64_t computeUnitCount = 0;
+  for (auto targetAttr :
+       IREE::HAL::DeviceTargetAttr::lookupExecutableTargets(op)) {
+    auto config = targetAttr.getConfiguration();
+    auto countAttr =
+        config ? config.getAs<IntegerAttr>("compute_unit_count") : nullptr;
+    if (!countAttr) {
+      return 0;
+    }
+    int64_t count = countAttr.getInt();
+    computeUnitCount = computeUnitCount ? std::min(computeUnitCount, count)
+                                        : count;
+  }
+  return computeUnitCount;
+}
+
+// Returns the split ratio that lets |op| occupy |computeUnitCount| compute
+// units when its output alone has too few workgroup tiles, or 1 if it should
+// not be split. Tall-skinny matmuls with large reductions such as those of
+// decoding steps are the main beneficiaries.
+static int64_t getGPUSplitReductionRatio(linalg::MatmulOp op,
+                                         int64_t computeUnitCount) {
+  auto lhsType = cast<ShapedType>(op.getDpsInputs()[0].getType());
+  auto rhsType = cast<ShapedType>(op.getDpsInputs()[1].getType());
+  if (!lhsType.hasStaticShape() || !rhsType.hasStaticShape()) {
+    return 1;
+  }
+  int64_t m = lhsType.getDimSize(0);
+  int64_t k = lhsType.getDimSize(1);
+  int64_t n = rhsType.getDimSize(1);
+  int64_t workgroupCount = llvm::divideCeil(m, kGPUWorkgroupTileSize) *
+                           llvm::divideCeil(n, kGPUWorkgroupTileSize);
+  int64_t ratio = 1;
+  while (workgroupCount * ratio * 2 <= computeUnitCount &&
+         k % (ratio * 2) == 0 &&
+         k / (ratio * 2) >= kGPUMinSplitReductionSize) {
+    ratio *= 2;
+  }
+  return ratio;
+}
+
 static LogicalResult splitReductionOnMatmul(
     RewriterBase &rewriter, linalg::MatmulOp op,
     linalg::ControlSplitReductionFn controlSplitReductionFn) {
@@ -54,7 +112,7 @@ namespace {
 struct SplitReductionPass
     : public IREE::Flow::impl::SplitReductionPassBase<SplitReductionPass> {
   void runOnOperation() override {
-    if (splitReductionRatio.getValue() <= 1 &&
+    if (splitReductionRatio.getValue() <= 1 && !splitMatmulReductionForGPU &&
         topkSplitReductionRatio.empty()) {
       return;
     }
@@ -62,17 +120,36 @@ struct SplitReductionPass
     MLIRContext *context = &getContext();
     auto funcOp = getOperation();
 
-    auto matmulSplitReductionControlFn =
-        [&](linalg::LinalgOp op) -> linalg::SplitReductionOptions {
-      // For matmul make the new parallel dimension first so that it looks
-      // like a batch_matmul and can follow the same codegen.
-      return {int64_t(splitReductionRatio), 0, /*innerParallel=*/false};
+    // An explicit ratio applies to all matmuls; otherwise the ratio is chosen
+    // per matmul from its shape and the GPU targets.
+    int64_t computeUnitCount = 0;
+    if (splitReductionRatio.getValue() <= 1 && splitMatmulReductionForGPU) {
+      computeUnitCount = getGPUComputeUnitCount(funcOp);
+    }
+    auto getMatmulSplitReductionRatio = [&](linalg::MatmulOp op) -> int64_t {
+      if (splitReductionRatio.getValue() > 1) {
+        return splitReductionRatio;
+      }
+      if (computeUnitCount > 0) {
+        return getGPUSplitReductionRatio(op, computeUnitCount);
+      }
+      return 1;
     };
 
     SmallVector<linalg::MatmulOp> matmulCandidates;
     IRRewriter rewriter(context);
     funcOp->walk([&](linalg::MatmulOp op) { matmulCandidates.push_back(op); });
     for (auto op : matmulCandidates) {
+      int64_t ratio = getMatmulSplitReductionRatio(op);
+      if (ratio <= 1) {
+        continue;
+      }
+      auto matmulSplitReductionControlFn =
+          [&](linalg::LinalgOp) -> linalg::SplitReductionOptions {
+        // For matmul make the new parallel dimension first so that it looks
+        // like a batch_matmul and can follow the same codegen.
+        return {ratio, 0, /*innerParallel=*/false};
+      };
       (void)splitReductionOnMatmul(rewriter, op, matmulSplitReductionControlFn);
     }
 
@@ -0,0 +1,78 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(util.func(iree-flow-form-dispatch-regions{max-fused-row-reduction-size=256}))" --split-input-file %s | FileCheck %s
+
+util.func public @matmul_softmax(%arg0 : tensor<64x32xf32>, %arg1 : tensor<32x128xf32>) -> tensor<64x128xf32> {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<64x128xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<64x128xf32>) -> tensor<64x128xf32>
+  %matmul = linalg.matmul ins(%arg0, %arg1 : tensor<64x32xf32>, tensor<32x128xf32>)
+      outs(%fill : tensor<64x128xf32>) -> tensor<64x128xf32>
+  %softmax = linalg.softmax dimension(1) ins(%matmul : tensor<64x128xf32>)
+      outs(%empty : tensor<64x128xf32>) -> tensor<64x128xf32>
+  util.return %softmax : tensor<64x128xf32>
+}
+// CHECK-LABEL: util.func public @matmul_softmax
+//       CHECK:   %[[RESULT:.+]] = flow.dispatch.region
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//       CHECK:     %[[SOFTMAX:.+]] = linalg.softmax dimension(1) ins(%[[MATMUL]] :
+//       CHECK:     flow.return %[[SOFTMAX]]
+//   CHECK-NOT:   flow.dispatch.region
+//       CHECK:   util.return %[[RESULT]]
+
+// -----
+
+util.func public @matmul_row_sum(%arg0 : tensor<64x32xf32>, %arg1 : tensor<32x128xf32>) -> tensor<64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<64x128xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<64x128xf32>) -> tensor<64x128xf32>
+  %matmul = linalg.matmul ins(%arg0, %arg1 : tensor<64x32xf32>, tensor<32x128xf32>)
+      outs(%fill : tensor<64x128xf32>) -> tensor<64x128xf32>
+  %empty1 = tensor.empty() : tensor<64xf32>
+  %fill1 = linalg.fill ins(%cst : f32) outs(%empty1 : tensor<64xf32>) -> tensor<64xf32>
+  %sum = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%matmul : tensor<64x128xf32>) outs(%fill1 : tensor<64xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %add = arith.addf %b0, %b1 : f32
+      linalg.yield %add : f32
+  } -> tensor<64xf32>
+  util.return %sum : tensor<64xf32>
+}
+// CHECK-LABEL: util.func public @matmul_row_sum
+//       CHECK:   %[[RESULT:.+]] = flow.dispatch.region
+//       CHECK:     %[[MATMUL:.+]] = linalg.matmul
+//       CHECK:     %[[SUM:.+]] = linalg.generic
+//  CHECK-SAME:         ins(%[[MATMUL]] :
+//       CHECK:     flow.return %[[SUM]]
+//   CHECK-NOT:   flow.dispatch.region
+//       CHECK:   util.return %[[RESULT]]
+
+// -----
+
+// Rows larger than the limit are not fused.
+
+util.func public @matmul_wide_row_sum(%arg0 : tensor<64x32xf32>, %arg1 : tensor<32x512xf32>) -> tensor<64xf32> {
+  %cst = arith.constant 0.0 : f32
+  %empty = tensor.empty() : tensor<64x512xf32>
+  %fill = linalg.fill ins(%cst : f32) outs(%empty : tensor<64x512xf32>) -> tensor<64x512xf32>
+  %matmul = linalg.matmul ins(%arg0, %arg1 : tensor<64x32xf32>, tensor<32x512xf32>)
+      outs(%fill : tensor<64x512xf32>) -> tensor<64x512xf32>
+  %empty1 = tensor.empty() : tensor<64xf32>
+  %fill1 = linalg.fill ins(%cst : f32) outs(%empty1 : tensor<64xf32>) -> tensor<64xf32>
+  %sum = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0)>],
+      iterator_types = ["parallel", "reduction"]}
+      ins(%matmul : tensor<64x512xf32>) outs(%fill1 : tensor<64xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %add = arith.addf %b0, %b1 : f32
+      linalg.yield %add : f32
+  } -> tensor<64xf32>
+  util.return %sum : tensor<64xf32>
+}
+// CHECK-LABEL: util.func public @matmul_wide_row_sum
+//       CHECK:   %[[MATMUL:.+]] = flow.dispatch.region
+//       CHECK:     linalg.matmul
+//       CHECK:   %[[SUM:.+]] = flow.dispatch.region
+//       CHECK:     linalg.generic
+//  CHECK-SAME:         ins(%[[MATMUL]] :
+//       CHECK:   util.return %[[SUM]]
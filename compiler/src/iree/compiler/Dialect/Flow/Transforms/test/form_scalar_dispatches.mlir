@@ -157,3 +157,49 @@ util.func public @interleaving(
 //  CHECK-SAME:         outs(%[[EMPTY1]] :
 //       CHECK:    flow.return %[[GENERIC3]], %[[GENERIC2]]
 //       CHECK:  util.return %[[DISPATCH1]]#0, %[[DISPATCH1]]#1
+
+// -----
+
+#map = affine_map<() -> ()>
+util.func public @hostEvaluated(%arg0 : index, %arg1 : tensor<f32>) -> (index, tensor<f32>) {
+  %cst = arith.constant dense<2> : tensor<i64>
+  %0 = tensor.from_elements %arg0 : tensor<index>
+  %1 = tensor.empty() : tensor<i64>
+  %2 = linalg.generic {indexing_maps = [#map, #map, #map], iterator_types = []}
+      ins(%0, %cst : tensor<index>, tensor<i64>) outs(%1 : tensor<i64>) {
+    ^bb0(%b0: index, %b1 : i64, %b2 : i64) :
+      %3 = arith.index_cast %b0 : index to i64
+      %4 = arith.muli %3, %b1 : i64
+      linalg.yield %4 : i64
+    } -> tensor<i64>
+  %5 = tensor.empty() : tensor<index>
+  %6 = linalg.generic {indexing_maps = [#map, #map], iterator_types = []}
+      ins(%2 : tensor<i64>) outs(%5 : tensor<index>) {
+    ^bb0(%b0: i64, %b1 : index) :
+      %7 = arith.index_cast %b0 : i64 to index
+      linalg.yield %7 : index
+    } -> tensor<index>
+  %8 = tensor.extract %6[] : tensor<index>
+  %9 = tensor.empty() : tensor<f32>
+  %10 = linalg.generic {indexing_maps = [#map, #map], iterator_types = []}
+      ins(%arg1 : tensor<f32>) outs(%9 : tensor<f32>) {
+    ^bb0(%b0: f32, %b1 : f32) :
+      %11 = arith.negf %b0 : f32
+      linalg.yield %11 : f32
+    } -> tensor<f32>
+  util.return %8, %10 : index, tensor<f32>
+}
+// CHECK-LABEL: util.func public @hostEvaluated(
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: index
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<f32>
+//   CHECK-DAG:   %[[C2:.+]] = arith.constant 2 : i64
+//       CHECK:   %[[CAST0:.+]] = arith.index_cast %[[ARG0]] : index to i64
+//       CHECK:   %[[MUL:.+]] = arith.muli %[[CAST0]], %[[C2]] : i64
+//       CHECK:   %[[CAST1:.+]] = arith.index_cast %[[MUL]] : i64 to index
+//       CHECK:   %[[TENSOR:.+]] = tensor.from_elements %[[CAST1]] : tensor<index>
+//       CHECK:   %[[EXTRACT:.+]] = tensor.extract %[[TENSOR]][]
+//   CHECK-NOT:   linalg.generic
+//       CHECK:   %[[DISPATCH:.+]] = flow.dispatch.region
+//       CHECK:     linalg.generic
+//  CHECK-SAME:         ins(%[[ARG1]] :
+//       CHECK:   util.return %[[EXTRACT]], %[[DISPATCH]]
@@ -0,0 +1,118 @@
+// RUN: iree-opt --split-input-file --pass-pipeline="builtin.module(util.func(iree-flow-fuse-horizontal-elementwise{max-elements=1024}))" --mlir-print-local-scope %s | FileCheck %s
+
+util.func public @independent_bias_adds(%arg0 : tensor<4x32xf32>, %arg1 : tensor<32xf32>, %arg2 : tensor<4x32xf16>, %arg3 : tensor<32xf16>) -> (tensor<4x32xf32>, tensor<4x32xf16>) {
+  %empty0 = tensor.empty() : tensor<4x32xf32>
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg0, %arg1 : tensor<4x32xf32>, tensor<32xf32>) outs(%empty0 : tensor<4x32xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32, %b2 : f32):
+      %add = arith.addf %b0, %b1 : f32
+      linalg.yield %add : f32
+  } -> tensor<4x32xf32>
+  %empty1 = tensor.empty() : tensor<4x32xf16>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%arg2, %arg3 : tensor<4x32xf16>, tensor<32xf16>) outs(%empty1 : tensor<4x32xf16>) {
+    ^bb0(%b0 : f16, %b1 : f16, %b2 : f16):
+      %add = arith.addf %b0, %b1 : f16
+      linalg.yield %add : f16
+  } -> tensor<4x32xf16>
+  util.return %0, %1 : tensor<4x32xf32>, tensor<4x32xf16>
+}
+// CHECK-LABEL: util.func public @independent_bias_adds
+//  CHECK-SAME:     %[[ARG0:[a-zA-Z0-9]+]]: tensor<4x32xf32>
+//  CHECK-SAME:     %[[ARG1:[a-zA-Z0-9]+]]: tensor<32xf32>
+//  CHECK-SAME:     %[[ARG2:[a-zA-Z0-9]+]]: tensor<4x32xf16>
+//  CHECK-SAME:     %[[ARG3:[a-zA-Z0-9]+]]: tensor<32xf16>
+//   CHECK-DAG:   %[[EMPTY0:.+]] = tensor.empty() : tensor<4x32xf32>
+//   CHECK-DAG:   %[[EMPTY1:.+]] = tensor.empty() : tensor<4x32xf16>
+//       CHECK:   %[[FUSED:.+]]:2 = linalg.generic
+//  CHECK-SAME:       indexing_maps = [affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0, d1)>, affine_map<(d0, d1) -> (d0, d1)>]
+//  CHECK-SAME:       ins(%[[ARG0]], %[[ARG1]], %[[ARG2]], %[[ARG3]] :
+//  CHECK-SAME:       outs(%[[EMPTY0]], %[[EMPTY1]] :
+//  CHECK-NEXT:   ^bb0(%[[B0:.+]]: f32, %[[B1:.+]]: f32, %[[B2:.+]]: f16, %[[B3:.+]]: f16, %{{.+}}: f32, %{{.+}}: f16):
+//   CHECK-DAG:     %[[ADD0:.+]] = arith.addf %[[B0]], %[[B1]] : f32
+//   CHECK-DAG:     %[[ADD1:.+]] = arith.addf %[[B2]], %[[B3]] : f16
+//       CHECK:     linalg.yield %[[ADD0]], %[[ADD1]] : f32, f16
+//   CHECK-NOT:   linalg.generic
+//       CHECK:   util.return %[[FUSED]]#0, %[[FUSED]]#1
+
+// -----
+
+util.func public @dependent_ops(%arg0 : tensor<64xf32>) -> tensor<64xf32> {
+  %empty = tensor.empty() : tensor<64xf32>
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%arg0 : tensor<64xf32>) outs(%empty : tensor<64xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %neg = arith.negf %b0 : f32
+      linalg.yield %neg : f32
+  } -> tensor<64xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%0 : tensor<64xf32>) outs(%empty : tensor<64xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %exp = math.exp %b0 : f32
+      linalg.yield %exp : f32
+  } -> tensor<64xf32>
+  util.return %1 : tensor<64xf32>
+}
+// CHECK-LABEL: util.func public @dependent_ops
+//       CHECK:   %[[NEG:.+]] = linalg.generic
+//       CHECK:   %[[EXP:.+]] = linalg.generic
+//  CHECK-SAME:       ins(%[[NEG]] :
+//       CHECK:   util.return %[[EXP]]
+
+// -----
+
+util.func public @mismatched_or_large(%arg0 : tensor<64xf32>, %arg1 : tensor<32xf32>, %arg2 : tensor<2048xf32>, %arg3 : tensor<2048xf32>) -> (tensor<64xf32>, tensor<32xf32>, tensor<2048xf32>, tensor<2048xf32>) {
+  %empty0 = tensor.empty() : tensor<64xf32>
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%arg0 : tensor<64xf32>) outs(%empty0 : tensor<64xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %neg = arith.negf %b0 : f32
+      linalg.yield %neg : f32
+  } -> tensor<64xf32>
+  %empty1 = tensor.empty() : tensor<32xf32>
+  %1 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%arg1 : tensor<32xf32>) outs(%empty1 : tensor<32xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %neg = arith.negf %b0 : f32
+      linalg.yield %neg : f32
+  } -> tensor<32xf32>
+  %empty2 = tensor.empty() : tensor<2048xf32>
+  %2 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%arg2 : tensor<2048xf32>) outs(%empty2 : tensor<2048xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %neg = arith.negf %b0 : f32
+      linalg.yield %neg : f32
+  } -> tensor<2048xf32>
+  %3 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%arg3 : tensor<2048xf32>) outs(%empty2 : tensor<2048xf32>) {
+    ^bb0(%b0 : f32, %b1 : f32):
+      %neg = arith.negf %b0 : f32
+      linalg.yield %neg : f32
+  } -> tensor<2048xf32>
+  util.return %0, %1, %2, %3 : tensor<64xf32>, tensor<32xf32>, tensor<2048xf32>, tensor<2048xf32>
+}
+// CHECK-LABEL: util.func public @mismatched_or_large
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       ins(%{{.+}} : tensor<64xf32>)
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       ins(%{{.+}} : tensor<32xf32>)
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       ins(%{{.+}} : tensor<2048xf32>)
+//       CHECK:   linalg.generic
+//  CHECK-SAME:       ins(%{{.+}} : tensor<2048xf32>)
@@ -0,0 +1,133 @@
+// RUN: iree-opt --split-input-file --iree-flow-parameterize-executable-constants %s | FileCheck %s
+// RUN: iree-opt --split-input-file --iree-flow-parameterize-executable-constants --iree-flow-deduplicate-executables %s | FileCheck %s --check-prefix=DEDUP
+
+// CHECK-LABEL: flow.executable public @clamp_ex_0
+flow.executable public @clamp_ex_0 {
+  flow.executable.export @clamp_entry_0
+  builtin.module {
+    // CHECK: func.func @clamp_entry_0(%[[ARG0:.+]]: tensor<4xf32>, %[[LO:.+]]: f32, %[[HI:.+]]: f32)
+    func.func @clamp_entry_0(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      // CHECK-NOT: arith.constant
+      %lo = arith.constant 0.0 : f32
+      %hi = arith.constant 6.0 : f32
+      %0 = tensor.empty() : tensor<4xf32>
+      // CHECK: linalg.generic
+      %1 = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]
+      } ins(%arg0 : tensor<4xf32>) outs(%0 : tensor<4xf32>) {
+      ^bb0(%in: f32, %out: f32):
+        // CHECK: arith.maximumf %{{.+}}, %[[LO]]
+        // CHECK: arith.minimumf %{{.+}}, %[[HI]]
+        %2 = arith.maximumf %in, %lo : f32
+        %3 = arith.minimumf %2, %hi : f32
+        linalg.yield %3 : f32
+      } -> tensor<4xf32>
+      return %1 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @clamp_ex_1
+flow.executable public @clamp_ex_1 {
+  flow.executable.export @clamp_entry_1
+  builtin.module {
+    // CHECK: func.func @clamp_entry_1(%{{.+}}: tensor<4xf32>, %{{.+}}: f32, %{{.+}}: f32)
+    func.func @clamp_entry_1(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      %lo = arith.constant 0.0 : f32
+      %hi = arith.constant 1.0 : f32
+      %0 = tensor.empty() : tensor<4xf32>
+      %1 = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]
+      } ins(%arg0 : tensor<4xf32>) outs(%0 : tensor<4xf32>) {
+      ^bb0(%in: f32, %out: f32):
+        %2 = arith.maximumf %in, %lo : f32
+        %3 = arith.minimumf %2, %hi : f32
+        linalg.yield %3 : f32
+      } -> tensor<4xf32>
+      return %1 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @clamp_ex_2
+flow.executable public @clamp_ex_2 {
+  flow.executable.export @clamp_entry_2
+  builtin.module {
+    // CHECK: func.func @clamp_entry_2(%{{.+}}: tensor<4xf32>) -> tensor<4xf32>
+    func.func @clamp_entry_2(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      %cst = arith.constant 2.0 : f32
+      %0 = tensor.empty() : tensor<4xf32>
+      %1 = linalg.generic {
+        indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+        iterator_types = ["parallel"]
+      } ins(%arg0 : tensor<4xf32>) outs(%0 : tensor<4xf32>) {
+      ^bb0(%in: f32, %out: f32):
+        %2 = arith.mulf %in, %cst : f32
+        linalg.yield %2 : f32
+      } -> tensor<4xf32>
+      return %1 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: util.func public @clamp
+util.func public @clamp(%arg0: tensor<4xf32>) -> (tensor<4xf32>, tensor<4xf32>, tensor<4xf32>) {
+  %c4 = arith.constant 4 : index
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0.000000e+00 : f32
+  // CHECK-DAG: %[[C6:.+]] = arith.constant 6.000000e+00 : f32
+  // CHECK: flow.dispatch @clamp_ex_0::@clamp_entry_0[%c4](%arg0, %[[C0]], %[[C6]]) : (tensor<4xf32>, f32, f32) -> tensor<4xf32>
+  %0 = flow.dispatch @clamp_ex_0::@clamp_entry_0[%c4](%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  // CHECK-DAG: %[[C0_1:.+]] = arith.constant 0.000000e+00 : f32
+  // CHECK-DAG: %[[C1:.+]] = arith.constant 1.000000e+00 : f32
+  // CHECK: flow.dispatch @clamp_ex_1::@clamp_entry_1[%c4](%arg0, %[[C0_1]], %[[C1]]) : (tensor<4xf32>, f32, f32) -> tensor<4xf32>
+  %1 = flow.dispatch @clamp_ex_1::@clamp_entry_1[%c4](%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  // CHECK: flow.dispatch @clamp_ex_2::@clamp_entry_2[%c4](%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  %2 = flow.dispatch @clamp_ex_2::@clamp_entry_2[%c4](%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  util.return %0, %1, %2 : tensor<4xf32>, tensor<4xf32>, tensor<4xf32>
+}
+
+// DEDUP-LABEL: flow.executable public @clamp_ex_0
+// DEDUP-NOT: flow.executable public @clamp_ex_1
+// DEDUP-LABEL: flow.executable public @clamp_ex_2
+// DEDUP-LABEL: util.func public @clamp
+// DEDUP: flow.dispatch @clamp_ex_0::@clamp_entry_0
+// DEDUP: flow.dispatch @clamp_ex_0::@clamp_entry_0
+// DEDUP: flow.dispatch @clamp_ex_2::@clamp_entry_2
+
+// -----
+
+// Executables reached through multi-entry-point dispatches keep their
+// constants as their operand lists can't be changed independently.
+
+// CHECK-LABEL: flow.executable public @multi_entry_ex_0
+flow.executable public @multi_entry_ex_0 {
+  flow.executable.export @multi_entry_entry_0
+  builtin.module {
+    // CHECK: func.func @multi_entry_entry_0(%{{.+}}: tensor<4xf32>) -> tensor<4xf32>
+    func.func @multi_entry_entry_0(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      // CHECK: arith.constant dense<1.000000e+00>
+      %cst = arith.constant dense<1.0> : tensor<4xf32>
+      %c = arith.constant 1.0 : f32
+      %0 = arith.addf %arg0, %cst : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+// CHECK-LABEL: flow.executable public @multi_entry_ex_1
+flow.executable public @multi_entry_ex_1 {
+  flow.executable.export @multi_entry_entry_1
+  builtin.module {
+    // CHECK: func.func @multi_entry_entry_1(%{{.+}}: tensor<4xf32>) -> tensor<4xf32>
+    func.func @multi_entry_entry_1(%arg0: tensor<4xf32>) -> tensor<4xf32> {
+      %cst = arith.constant dense<1.0> : tensor<4xf32>
+      %c = arith.constant 2.0 : f32
+      %0 = arith.addf %arg0, %cst : tensor<4xf32>
+      return %0 : tensor<4xf32>
+    }
+  }
+}
+util.func public @multi_entry(%arg0: tensor<4xf32>) -> (tensor<4xf32>, tensor<4xf32>) {
+  %c4 = arith.constant 4 : index
+  %0 = flow.dispatch {@multi_entry_ex_0::@multi_entry_entry_0, @multi_entry_ex_1::@multi_entry_entry_1}[%c4](%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  %1 = flow.dispatch @multi_entry_ex_1::@multi_entry_entry_1[%c4](%arg0) : (tensor<4xf32>) -> tensor<4xf32>
+  util.return %0, %1 : tensor<4xf32>, tensor<4xf32>
+}
@@ -0,0 +1,62 @@
+// RUN: iree-opt --split-input-file --iree-flow-specialize-dispatch-workloads %s | FileCheck %s
+
+// CHECK-LABEL: flow.executable private @ex
+flow.executable private @ex {
+  flow.executable.export public @entry workgroups(%arg0: index, %arg1: index) -> (index, index, index) {
+    %x, %y, %z = flow.dispatch.workgroup_count_from_slice %arg0, %arg1
+    flow.return %x, %y, %z : index, index, index
+  }
+  builtin.module {
+    // CHECK: func.func @entry
+    func.func @entry(%arg0: !flow.dispatch.tensor<readonly:tensor<?x?xf32>>, %arg1: index, %arg2: index, %arg3: !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>) {
+      // CHECK-COUNT-2: flow.dispatch.workload.ordinal
+      %0 = flow.dispatch.workload.ordinal %arg1, 0 : index
+      %1 = flow.dispatch.workload.ordinal %arg2, 1 : index
+      %2 = flow.dispatch.tensor.load %arg0, offsets = [0, 0], sizes = [%0, %1], strides = [1, 1] : !flow.dispatch.tensor<readonly:tensor<?x?xf32>>{%0, %1} -> tensor<?x?xf32>
+      flow.dispatch.tensor.store %2, %arg3, offsets = [0, 0], sizes = [%0, %1], strides = [1, 1] : tensor<?x?xf32> -> !flow.dispatch.tensor<writeonly:tensor<?x?xf32>>{%0, %1}
+      return
+    }
+  }
+}
+
+// Variants are inserted after the original executable so the last bucket comes
+// first. It keeps the first workload value dynamic.
+// CHECK-LABEL: flow.executable private @ex_workload_any_128
+// CHECK: func.func @entry
+// CHECK: %[[DIM0:.+]] = flow.dispatch.workload.ordinal %{{.+}}, 0 : index
+// CHECK: %[[C128:.+]] = arith.constant 128 : index
+// CHECK-NOT: flow.dispatch.workload.ordinal
+// CHECK: flow.dispatch.tensor.load %{{.+}}, offsets = [0, 0], sizes = [%[[DIM0]], %[[C128]]]
+
+// CHECK-LABEL: flow.executable private @ex_workload_1_4096
+// CHECK: func.func @entry
+// CHECK-DAG: %[[C1:.+]] = arith.constant 1 : index
+// CHECK-DAG: %[[C4096:.+]] = arith.constant 4096 : index
+// CHECK-NOT: flow.dispatch.workload.ordinal
+// CHECK: flow.dispatch.tensor.load %{{.+}}, offsets = [0, 0], sizes = [%[[C1]], %[[C4096]]]
+
+// CHECK-LABEL: util.func public @specialized
+// CHECK-SAME: (%[[ARG0:.+]]: tensor<?x?xf32>, %[[DIM0:.+]]: index, %[[DIM1:.+]]: index)
+util.func public @specialized(%arg0: tensor<?x?xf32>, %dim0: index, %dim1: index) -> tensor<?x?xf32> {
+  // CHECK-DAG: %[[IS_1:.+]] = arith.cmpi eq, %[[DIM0]], %c1
+  // CHECK-DAG: %[[IS_4096:.+]] = arith.cmpi eq, %[[DIM1]], %c4096
+  // CHECK: %[[IS_BUCKET0:.+]] = arith.andi %[[IS_1]], %[[IS_4096]]
+  // CHECK: %[[IS_BUCKET1:.+]] = arith.cmpi eq, %[[DIM1]], %c128
+  // CHECK: %[[RESULT:.+]] = scf.if %[[IS_BUCKET0]]
+  // CHECK-NEXT: %[[VARIANT0:.+]] = flow.dispatch @ex_workload_1_4096::@entry[%[[DIM0]], %[[DIM1]]](%[[ARG0]], %[[DIM0]], %[[DIM1]])
+  // CHECK-NEXT: scf.yield %[[VARIANT0]]
+  // CHECK-NEXT: } else {
+  // CHECK-NEXT: %[[NESTED:.+]] = scf.if %[[IS_BUCKET1]]
+  // CHECK-NEXT: %[[VARIANT1:.+]] = flow.dispatch @ex_workload_any_128::@entry
+  // CHECK-NEXT: scf.yield %[[VARIANT1]]
+  // CHECK-NEXT: } else {
+  // CHECK-NEXT: %[[GENERIC:.+]] = flow.dispatch @ex::@entry
+  // CHECK-NEXT: scf.yield %[[GENERIC]]
+  // CHECK: scf.yield %[[NESTED]]
+  // CHECK: %[[TIED:.+]] = flow.tensor.tie_shape %[[RESULT]] : tensor<?x?xf32>{%[[DIM0]], %[[DIM1]]}
+  %0 = flow.dispatch @ex::@entry[%dim0, %dim1](%arg0, %dim0, %dim1) {
+    flow.workload_buckets = [array<i64: 1, 4096>, array<i64: -1, 128>]
+  } : (tensor<?x?xf32>{%dim0, %dim1}, index, index) -> tensor<?x?xf32>{%dim0, %dim1}
+  // CHECK: util.return %[[TIED]]
+  util.return %0 : tensor<?x?xf32>
+}
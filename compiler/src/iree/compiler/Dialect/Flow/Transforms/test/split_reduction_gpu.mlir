@@ -0,0 +1,29 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(util.func(iree-flow-split-reduction-ops))' --iree-flow-split-matmul-reduction-for-gpu %s | FileCheck %s
+
+// Tests that the split ratio is chosen to fill the compute units of the target
+// when the matmul output alone has too few workgroup tiles.
+
+#executable_target = #hal.executable.target<"rocm", "rocm-hsaco-fb", {compute_unit_count = 304 : i64}>
+module attributes {hal.device.targets = [#hal.device.target<"rocm", [#executable_target]>]} {
+
+// CHECK-LABEL: util.func public @decode_matmul
+util.func public @decode_matmul(%arg0: tensor<1x4096xf16>, %arg1: tensor<4096x4096xf16>, %arg2: tensor<1x4096xf16>) -> tensor<1x4096xf16> {
+  // CHECK-DAG: tensor.expand_shape {{.+}} : tensor<1x4096xf16> into tensor<1x4x1024xf16>
+  // CHECK-DAG: tensor.expand_shape {{.+}} : tensor<4096x4096xf16> into tensor<4x1024x4096xf16>
+  // CHECK:     linalg.generic
+  // CHECK-SAME:  outs({{.+}} : tensor<4x1x4096xf16>)
+  // CHECK:     linalg.generic
+  // CHECK-SAME:  iterator_types = ["reduction", "parallel", "parallel"]
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<1x4096xf16>, tensor<4096x4096xf16>) outs(%arg2 : tensor<1x4096xf16>) -> tensor<1x4096xf16>
+  util.return %0 : tensor<1x4096xf16>
+}
+
+// CHECK-LABEL: util.func public @prefill_matmul
+util.func public @prefill_matmul(%arg0: tensor<256x4096xf16>, %arg1: tensor<4096x4096xf16>, %arg2: tensor<256x4096xf16>) -> tensor<256x4096xf16> {
+  // CHECK-NOT: tensor.expand_shape
+  // CHECK:     linalg.matmul
+  %0 = linalg.matmul ins(%arg0, %arg1 : tensor<256x4096xf16>, tensor<4096x4096xf16>) outs(%arg2 : tensor<256x4096xf16>) -> tensor<256x4096xf16>
+  util.return %0 : tensor<256x4096xf16>
+}
+
+}
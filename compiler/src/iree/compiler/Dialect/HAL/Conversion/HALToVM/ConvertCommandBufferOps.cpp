@@ -305,6 +305,99 @@ private:
   mutable IREE::VM::ImportOp importOp;
 };
 
+class CommandBufferDispatchPackedOpConversion
+    : public OpConversionPattern<IREE::HAL::CommandBufferDispatchPackedOp> {
+public:
+  CommandBufferDispatchPackedOpConversion(MLIRContext *context,
+                                          SymbolTable &importSymbols,
+                                          TypeConverter &typeConverter,
+                                          StringRef importName)
+      : OpConversionPattern(context) {
+    importOp = importSymbols.lookup<IREE::VM::ImportOp>(importName);
+    assert(importOp);
+  }
+
+  LogicalResult
+  matchAndRewrite(IREE::HAL::CommandBufferDispatchPackedOp op,
+                  OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto importType = importOp.getFunctionType();
+
+    // Memoized zeros/nulls; see CommandBufferPushDescriptorSetOpConversion.
+    Value zero;
+    auto getI32Zero = [&]() {
+      if (!zero) {
+        zero = rewriter.create<IREE::VM::ConstI32ZeroOp>(op.getLoc());
+      }
+      return zero;
+    };
+    Value null;
+    auto getNull = [&]() {
+      if (!null) {
+        null = rewriter.create<IREE::VM::ConstRefZeroOp>(
+            op.getLoc(),
+            IREE::VM::RefType::get(rewriter.getType<IREE::HAL::BufferType>()));
+      }
+      return null;
+    };
+    auto i32Type = rewriter.getI32Type();
+    auto i64Type = rewriter.getI64Type();
+
+    SmallVector<Value, 8> callOperands = {
+        adaptor.getCommandBuffer(),
+        adaptor.getPipelineLayout(),
+        adaptor.getExecutable(),
+        castToImportType(adaptor.getEntryPoint(), i32Type, rewriter),
+        castToImportType(adaptor.getWorkgroupX(), i32Type, rewriter),
+        castToImportType(adaptor.getWorkgroupY(), i32Type, rewriter),
+        castToImportType(adaptor.getWorkgroupZ(), i32Type, rewriter),
+    };
+    SmallVector<int16_t, 10> segmentSizes = {
+        /*command_buffer=*/-1,
+        /*pipeline_layout=*/-1,
+        /*executable=*/-1,
+        /*entry_point=*/-1,
+        /*workgroup_x=*/-1,
+        /*workgroup_y=*/-1,
+        /*workgroup_z=*/-1,
+        /*constants=*/static_cast<int16_t>(adaptor.getConstants().size()),
+        /*set=*/-1,
+        /*bindings=*/
+        static_cast<int16_t>(adaptor.getBindingOrdinals().size()),
+    };
+    llvm::append_range(callOperands, adaptor.getConstants());
+    callOperands.push_back(
+        castToImportType(adaptor.getSet(), i32Type, rewriter));
+    for (size_t i = 0; i < adaptor.getBindingOrdinals().size(); ++i) {
+      callOperands.push_back(
+          castToImportType(adaptor.getBindingOrdinals()[i], i32Type, rewriter));
+      auto bindingBuffer = adaptor.getBindingBuffers()[i];
+      if (llvm::isa<IREE::VM::RefType>(bindingBuffer.getType())) {
+        // Buffer binding; pass 0 for table slot.
+        callOperands.push_back(getI32Zero());
+        callOperands.push_back(bindingBuffer);
+      } else {
+        // Binding table reference; pass null for the buffer.
+        callOperands.push_back(bindingBuffer);
+        callOperands.push_back(getNull());
+      }
+      callOperands.push_back(
+          castToImportType(adaptor.getBindingOffsets()[i], i64Type, rewriter));
+      callOperands.push_back(
+          castToImportType(adaptor.getBindingLengths()[i], i64Type, rewriter));
+    }
+
+    auto callOp = rewriter.replaceOpWithNewOp<IREE::VM::CallVariadicOp>(
+        op, SymbolRefAttr::get(importOp), importType.getResults(), segmentSizes,
+        importType.getInputs(), callOperands);
+    copyImportAttrs(importOp, callOp);
+    return success();
+  }
+
+private:
+  mutable IREE::VM::ImportOp importOp;
+};
+
 } // namespace
 
 void populateHALCommandBufferToVMPatterns(MLIRContext *context,
@@ -346,6 +439,9 @@ void populateHALCommandBufferToVMPatterns(MLIRContext *context,
       .insert<VMImportOpConversion<IREE::HAL::CommandBufferDispatchIndirectOp>>(
           context, importSymbols, typeConverter,
           "hal.command_buffer.dispatch.indirect");
+  patterns.insert<CommandBufferDispatchPackedOpConversion>(
+      context, importSymbols, typeConverter,
+      "hal.command_buffer.dispatch.packed");
 }
 
 } // namespace mlir::iree_compiler
@@ -6,6 +6,7 @@
 
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/Dialect/VM/Conversion/ImportUtils.h"
+#include "iree/compiler/Dialect/VM/IR/VMOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Transforms/DialectConversion.h"
 
@@ -115,6 +116,63 @@ private:
   mutable IREE::VM::ImportOp importOp;
 };
 
+// Rewrites a hal.device.queue.execute.indirect to a variadic call taking the
+// binding table as a list of <buffer, offset, length> tuples.
+class DeviceQueueExecuteIndirectOpConversion
+    : public OpConversionPattern<IREE::HAL::DeviceQueueExecuteIndirectOp> {
+public:
+  DeviceQueueExecuteIndirectOpConversion(MLIRContext *context,
+                                         SymbolTable &importSymbols,
+                                         TypeConverter &typeConverter,
+                                         StringRef importName)
+      : OpConversionPattern(typeConverter, context) {
+    importOp = importSymbols.lookup<IREE::VM::ImportOp>(importName);
+    assert(importOp);
+  }
+
+  LogicalResult
+  matchAndRewrite(IREE::HAL::DeviceQueueExecuteIndirectOp op,
+                  OpAdaptor adaptor,
+                  ConversionPatternRewriter &rewriter) const override {
+    auto importType = importOp.getFunctionType();
+    auto i64Type = rewriter.getI64Type();
+
+    SmallVector<Value, 8> callOperands = {
+        adaptor.getDevice(),
+        castToImportType(adaptor.getQueueAffinity(), i64Type, rewriter),
+        adaptor.getWaitFence(),
+        adaptor.getSignalFence(),
+        adaptor.getCommandBuffer(),
+    };
+    SmallVector<int16_t, 6> segmentSizes = {
+        /*device=*/-1,
+        /*queue_affinity=*/-1,
+        /*wait_fence=*/-1,
+        /*signal_fence=*/-1,
+        /*command_buffer=*/-1,
+        /*bindings=*/
+        static_cast<int16_t>(adaptor.getBindingBuffers().size()),
+    };
+    for (auto [buffer, offset, length] :
+         llvm::zip_equal(adaptor.getBindingBuffers(),
+                         adaptor.getBindingOffsets(),
+                         adaptor.getBindingLengths())) {
+      callOperands.push_back(buffer);
+      callOperands.push_back(castToImportType(offset, i64Type, rewriter));
+      callOperands.push_back(castToImportType(length, i64Type, rewriter));
+    }
+
+    auto callOp = rewriter.replaceOpWithNewOp<IREE::VM::CallVariadicOp>(
+        op, SymbolRefAttr::get(importOp), importType.getResults(), segmentSizes,
+        importType.getInputs(), callOperands);
+    copyImportAttrs(importOp, callOp);
+    return success();
+  }
+
+private:
+  mutable IREE::VM::ImportOp importOp;
+};
+
 void populateHALDeviceToVMPatterns(MLIRContext *context,
                                    SymbolTable &importSymbols,
                                    TypeConverter &typeConverter,
@@ -136,6 +194,9 @@ void populateHALDeviceToVMPatterns(MLIRContext *context,
       context, importSymbols, typeConverter, "hal.device.queue.write");
   patterns.insert<VMImportOpConversion<IREE::HAL::DeviceQueueExecuteOp>>(
       context, importSymbols, typeConverter, "hal.device.queue.execute");
+  patterns.insert<DeviceQueueExecuteIndirectOpConversion>(
+      context, importSymbols, typeConverter,
+      "hal.device.queue.execute.indirect");
   patterns.insert<VMImportOpConversion<IREE::HAL::DeviceQueueFlushOp>>(
       context, importSymbols, typeConverter, "hal.device.queue.flush");
 }
@@ -253,3 +253,42 @@ util.func public @command_buffer_dispatch_indirect(
       workgroups(%arg2 : !hal.buffer)[%c100]
   util.return
 }
+
+// -----
+
+// CHECK-LABEL: @command_buffer_dispatch_packed
+//  CHECK-SAME: %[[CMD:[a-z0-9]+]]: !vm.ref<!hal.command_buffer>,
+//  CHECK-SAME: %[[LAYOUT:[a-z0-9]+]]: !vm.ref<!hal.pipeline_layout>,
+//  CHECK-SAME: %[[EXECUTABLE:[a-z0-9]+]]: !vm.ref<!hal.executable>,
+//  CHECK-SAME: %[[BUFFER:[a-z0-9]+]]: !vm.ref<!hal.buffer>,
+//  CHECK-SAME: %[[CONSTANT0:[a-z0-9]+]]: i32, %[[CONSTANT1:[a-z0-9]+]]: i32
+util.func public @command_buffer_dispatch_packed(
+    %cmd: !hal.command_buffer,
+    %layout: !hal.pipeline_layout,
+    %executable: !hal.executable,
+    %buffer: !hal.buffer,
+    %constant0: i32,
+    %constant1: i32
+  ) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c100 = arith.constant 100 : index
+  %c4096 = arith.constant 4096 : index
+  %c8000 = arith.constant 8000 : index
+  // CHECK-DAG: %[[C0:.+]] = vm.const.i32.zero
+  // CHECK-DAG: %[[C1:.+]] = vm.const.i32 1
+  // CHECK: vm.call.variadic @hal.command_buffer.dispatch.packed
+  // CHECK-SAME: (%[[CMD]], %[[LAYOUT]], %[[EXECUTABLE]], %[[C1]], %c100, %[[C1]], %[[C1]],
+  // CHECK-SAME:  [%[[CONSTANT0]], %[[CONSTANT1]]], %[[C0]], [
+  // CHECK-SAME:   (%[[C1]], %[[C0]], %[[BUFFER]], %c4096, %c8000)
+  // CHECK-SAME: ]) : (!vm.ref<!hal.command_buffer>, !vm.ref<!hal.pipeline_layout>, !vm.ref<!hal.executable>, i32, i32, i32, i32, i32 ..., i32, tuple<i32, i32, !vm.ref<!hal.buffer>, i64, i64> ...)
+  hal.command_buffer.dispatch.packed<%cmd : !hal.command_buffer>
+      layout(%layout : !hal.pipeline_layout)
+      target(%executable : !hal.executable)[%c1]
+      workgroups([%c100, %c1, %c1])
+      constants([%constant0, %constant1] : i32, i32)
+      bindings([%c0][
+        %c1 = (%buffer : !hal.buffer)[%c4096, %c8000]
+      ])
+  util.return
+}
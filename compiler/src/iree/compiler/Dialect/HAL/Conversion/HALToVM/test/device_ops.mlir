@@ -197,6 +197,37 @@ util.func public @device_queue_execute(
 
 // -----
 
+// CHECK-LABEL: @device_queue_execute_indirect
+util.func public @device_queue_execute_indirect(
+    // CHECK-SAME: (%[[DEVICE:.+]]: !vm.ref<!hal.device>, %[[AFFINITY:.+]]: i64,
+    %device: !hal.device, %affinity: i64,
+    // CHECK-SAME:  %[[WAIT_FENCE:.+]]: !vm.ref<!hal.fence>, %[[SIGNAL_FENCE:.+]]: !vm.ref<!hal.fence>,
+    %wait_fence: !hal.fence, %signal_fence: !hal.fence,
+    // CHECK-SAME: %[[CMD:.+]]: !vm.ref<!hal.command_buffer>,
+    %cmd: !hal.command_buffer,
+    // CHECK-SAME: %[[BUFFER0:.+]]: !vm.ref<!hal.buffer>, %[[BUFFER1:.+]]: !vm.ref<!hal.buffer>)
+    %buffer0: !hal.buffer, %buffer1: !hal.buffer) {
+  %c100 = arith.constant 100 : index
+  %c200 = arith.constant 200 : index
+  // CHECK: vm.call.variadic @hal.device.queue.execute.indirect(
+  // CHECK-SAME: %[[DEVICE]], %[[AFFINITY]],
+  // CHECK-SAME: %[[WAIT_FENCE]], %[[SIGNAL_FENCE]], %[[CMD]], [
+  // CHECK-SAME:   (%[[BUFFER0]], %c100, %c200),
+  // CHECK-SAME:   (%[[BUFFER1]], %c100, %c200)
+  // CHECK-SAME: ]) : (!vm.ref<!hal.device>, i64, !vm.ref<!hal.fence>, !vm.ref<!hal.fence>, !vm.ref<!hal.command_buffer>, tuple<!vm.ref<!hal.buffer>, i64, i64> ...)
+  hal.device.queue.execute.indirect<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait_fence) signal(%signal_fence)
+      commands(%cmd)
+      bindings([
+        (%buffer0 : !hal.buffer)[%c100, %c200],
+        (%buffer1 : !hal.buffer)[%c100, %c200]
+      ])
+  util.return
+}
+
+// -----
+
 // CHECK-LABEL: @device_queue_flush
 util.func public @device_queue_flush(
     // CHECK-SAME: (%[[DEVICE:.+]]: !vm.ref<!hal.device>, %[[AFFINITY:.+]]: i64)
@@ -61,14 +61,23 @@ static ParseResult parseDescriptorSetBindings(
     SmallVectorImpl<Type> &bufferTypes,
     SmallVectorImpl<OpAsmParser::UnresolvedOperand> &bufferOffsets,
     SmallVectorImpl<OpAsmParser::UnresolvedOperand> &bufferLengths) {
+  // Binding lists may be empty on ops that don't require bindings.
+  OpAsmParser::UnresolvedOperand firstOrdinal;
+  auto firstResult = parser.parseOptionalOperand(firstOrdinal);
+  if (!firstResult.has_value())
+    return success();
+  if (failed(*firstResult))
+    return failure();
+  bool isFirst = true;
   do {
-    OpAsmParser::UnresolvedOperand ordinal;
+    OpAsmParser::UnresolvedOperand ordinal = firstOrdinal;
     OpAsmParser::UnresolvedOperand buffer;
     Type bufferType;
     OpAsmParser::UnresolvedOperand bufferOffset;
     OpAsmParser::UnresolvedOperand bufferLength;
-    if (failed(parser.parseOperand(ordinal)) || failed(parser.parseEqual()) ||
-        failed(parser.parseLParen()) || failed(parser.parseOperand(buffer)) ||
+    if ((!isFirst && failed(parser.parseOperand(ordinal))) ||
+        failed(parser.parseEqual()) || failed(parser.parseLParen()) ||
+        failed(parser.parseOperand(buffer)) ||
         failed(parser.parseColonType(bufferType)) ||
         failed(parser.parseRParen()) || failed(parser.parseLSquare()) ||
         failed(parser.parseOperand(bufferOffset)) ||
@@ -82,6 +91,7 @@ static ParseResult parseDescriptorSetBindings(
     bufferTypes.push_back(bufferType);
     bufferOffsets.push_back(bufferOffset);
     bufferLengths.push_back(bufferLength);
+    isFirst = false;
   } while (succeeded(parser.parseOptionalComma()));
   return success();
 }
@@ -111,6 +121,69 @@ static void printDescriptorSetBindings(OpAsmPrinter &p, Operation *op,
   p.printNewline();
 }
 
+//===----------------------------------------------------------------------===//
+// custom<BindingTable>($binding_buffers,
+//                      type($binding_buffers),
+//                      $binding_offsets,
+//                      $binding_lengths)
+//===----------------------------------------------------------------------===//
+
+static ParseResult parseBindingTable(
+    OpAsmParser &parser,
+    SmallVectorImpl<OpAsmParser::UnresolvedOperand> &buffers,
+    SmallVectorImpl<Type> &bufferTypes,
+    SmallVectorImpl<OpAsmParser::UnresolvedOperand> &bufferOffsets,
+    SmallVectorImpl<OpAsmParser::UnresolvedOperand> &bufferLengths) {
+  if (failed(parser.parseOptionalLParen())) {
+    return success(); // empty table
+  }
+  do {
+    OpAsmParser::UnresolvedOperand buffer;
+    Type bufferType;
+    OpAsmParser::UnresolvedOperand bufferOffset;
+    OpAsmParser::UnresolvedOperand bufferLength;
+    if (failed(parser.parseOperand(buffer)) ||
+        failed(parser.parseColonType(bufferType)) ||
+        failed(parser.parseRParen()) || failed(parser.parseLSquare()) ||
+        failed(parser.parseOperand(bufferOffset)) ||
+        failed(parser.parseComma()) ||
+        failed(parser.parseOperand(bufferLength)) ||
+        failed(parser.parseRSquare())) {
+      return failure();
+    }
+    buffers.push_back(buffer);
+    bufferTypes.push_back(bufferType);
+    bufferOffsets.push_back(bufferOffset);
+    bufferLengths.push_back(bufferLength);
+  } while (succeeded(parser.parseOptionalComma()) &&
+           succeeded(parser.parseLParen()));
+  return success();
+}
+
+static void printBindingTable(OpAsmPrinter &p, Operation *op,
+                              ValueRange buffers, TypeRange bufferTypes,
+                              ValueRange bufferOffsets,
+                              ValueRange bufferLengths) {
+  if (buffers.empty()) {
+    return;
+  }
+  llvm::interleaveComma(
+      llvm::zip_equal(buffers, bufferTypes, bufferOffsets, bufferLengths), p,
+      [&](std::tuple<Value, Type, Value, Value> it) {
+        p.printNewline();
+        p << "  (";
+        p.printOperand(std::get<0>(it));
+        p << " : ";
+        p.printType(std::get<1>(it));
+        p << ")[";
+        p.printOperand(std::get<2>(it));
+        p << ", ";
+        p.printOperand(std::get<3>(it));
+        p << "]";
+      });
+  p.printNewline();
+}
+
 //===----------------------------------------------------------------------===//
 // custom<TargetConditionRegion>($body)
 //===----------------------------------------------------------------------===//
@@ -966,6 +1039,22 @@ void CommandBufferPushDescriptorSetOp::build(
   state.addOperands(bindingLengths);
 }
 
+//===----------------------------------------------------------------------===//
+// hal.command_buffer.dispatch.packed
+//===----------------------------------------------------------------------===//
+
+LogicalResult CommandBufferDispatchPackedOp::verify() {
+  CommandBufferDispatchPackedOp op = *this;
+  size_t bindingCount = op.getBindingOrdinals().size();
+  if (op.getBindingBuffers().size() != bindingCount ||
+      op.getBindingOffsets().size() != bindingCount ||
+      op.getBindingLengths().size() != bindingCount) {
+    return op.emitOpError()
+           << "binding ordinals, buffers, offsets, and lengths must match";
+  }
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // hal.descriptor_set_layout.create
 //===----------------------------------------------------------------------===//
@@ -1056,6 +1145,10 @@ LogicalResult DeviceQueueExecuteOp::verify() {
   return verifyDeviceQueueFences(*this, getWaitFence(), getSignalFence());
 }
 
+LogicalResult DeviceQueueExecuteIndirectOp::verify() {
+  return verifyDeviceQueueFences(*this, getWaitFence(), getSignalFence());
+}
+
 //===----------------------------------------------------------------------===//
 // hal.devices.*
 //===----------------------------------------------------------------------===//
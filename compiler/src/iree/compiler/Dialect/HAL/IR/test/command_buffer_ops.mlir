@@ -247,3 +247,51 @@ util.func public @command_buffer_dispatch_indirect(
       workgroups(%buffer : !hal.buffer)[%offset]
   util.return
 }
+
+// -----
+
+// CHECK-LABEL: @command_buffer_dispatch_packed
+//  CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer,
+//  CHECK-SAME:  %[[LAYOUT:.+]]: !hal.pipeline_layout,
+//  CHECK-SAME:  %[[EXECUTABLE:.+]]: !hal.executable, %[[ORDINAL:.+]]: index,
+//  CHECK-SAME:  %[[BUFFER:.+]]: !hal.buffer, %[[CONSTANT:.+]]: i32)
+util.func public @command_buffer_dispatch_packed(
+    %cmd: !hal.command_buffer,
+    %layout: !hal.pipeline_layout,
+    %executable: !hal.executable, %ordinal: index,
+    %buffer: !hal.buffer, %constant: i32) {
+  // CHECK-DAG: %[[C0:.+]] = arith.constant 0
+  %c0 = arith.constant 0 : index
+  // CHECK-DAG: %[[C1:.+]] = arith.constant 1
+  %c1 = arith.constant 1 : index
+  // CHECK-DAG: %[[C4:.+]] = arith.constant 4
+  %c4 = arith.constant 4 : index
+  // CHECK-DAG: %[[C4096:.+]] = arith.constant 4096
+  %c4096 = arith.constant 4096 : index
+  //      CHECK: hal.command_buffer.dispatch.packed<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME:   layout(%[[LAYOUT]] : !hal.pipeline_layout)
+  // CHECK-SAME:   target(%[[EXECUTABLE]] : !hal.executable)[%[[ORDINAL]]
+  // CHECK-SAME:   workgroups([%[[C4]], %[[C1]], %[[C1]]])
+  // CHECK-SAME:   constants([%[[CONSTANT]]] : i32)
+  // CHECK-SAME:   bindings([%[[C0]]][
+  // CHECK-NEXT:     %[[C1]] = (%[[BUFFER]] : !hal.buffer)[%[[C4]], %[[C4096]]]
+  // CHECK-NEXT:   ])
+  hal.command_buffer.dispatch.packed<%cmd : !hal.command_buffer>
+      layout(%layout : !hal.pipeline_layout)
+      target(%executable : !hal.executable)[%ordinal]
+      workgroups([%c4, %c1, %c1])
+      constants([%constant] : i32)
+      bindings([%c0][
+        %c1 = (%buffer : !hal.buffer)[%c4, %c4096]
+      ])
+  // Constants and bindings are optional.
+  //      CHECK: hal.command_buffer.dispatch.packed<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME:   workgroups([%[[C4]], %[[C1]], %[[C1]]])
+  // CHECK-SAME:   bindings([%[[C0]]][])
+  hal.command_buffer.dispatch.packed<%cmd : !hal.command_buffer>
+      layout(%layout : !hal.pipeline_layout)
+      target(%executable : !hal.executable)[%ordinal]
+      workgroups([%c4, %c1, %c1])
+      bindings([%c0][])
+  util.return
+}
@@ -158,6 +158,41 @@ util.func public @device_queue_execute(
 
 // -----
 
+// CHECK-LABEL: @device_queue_execute_indirect
+util.func public @device_queue_execute_indirect(
+    // CHECK-SAME: (%[[DEVICE:.+]]: !hal.device, %[[AFFINITY:.+]]: i64,
+    %device: !hal.device, %affinity: i64,
+    // CHECK-SAME:  %[[WAIT_FENCE:.+]]: !hal.fence, %[[SIGNAL_FENCE:.+]]: !hal.fence,
+    %wait_fence: !hal.fence, %signal_fence: !hal.fence,
+    // CHECK-SAME:  %[[CMD:.+]]: !hal.command_buffer,
+    %cmd: !hal.command_buffer,
+    // CHECK-SAME:  %[[BUFFER0:.+]]: !hal.buffer, %[[BUFFER1:.+]]: !hal.buffer)
+    %buffer0: !hal.buffer, %buffer1: !hal.buffer) {
+  // CHECK-DAG: %[[OFFSET:.+]] = arith.constant 100
+  %offset = arith.constant 100 : index
+  // CHECK-DAG: %[[LENGTH:.+]] = arith.constant 200
+  %length = arith.constant 200 : index
+  // CHECK: hal.device.queue.execute.indirect<%[[DEVICE]] : !hal.device>
+  hal.device.queue.execute.indirect<%device : !hal.device>
+      // CHECK-SAME: affinity(%[[AFFINITY]])
+      affinity(%affinity)
+      // CHECK-SAME: wait(%[[WAIT_FENCE]]) signal(%[[SIGNAL_FENCE]])
+      wait(%wait_fence) signal(%signal_fence)
+      // CHECK-SAME: commands(%[[CMD]])
+      commands(%cmd)
+      // CHECK-SAME: bindings([
+      // CHECK-NEXT:   (%[[BUFFER0]] : !hal.buffer)[%[[OFFSET]], %[[LENGTH]]],
+      // CHECK-NEXT:   (%[[BUFFER1]] : !hal.buffer)[%[[OFFSET]], %[[LENGTH]]]
+      // CHECK-NEXT: ])
+      bindings([
+        (%buffer0 : !hal.buffer)[%offset, %length],
+        (%buffer1 : !hal.buffer)[%offset, %length]
+      ])
+  util.return
+}
+
+// -----
+
 // CHECK-LABEL: @device_queue_flush
 util.func public @device_queue_flush(
     // CHECK-SAME: (%[[DEVICE:.+]]: !hal.device, %[[AFFINITY:.+]]: i64)
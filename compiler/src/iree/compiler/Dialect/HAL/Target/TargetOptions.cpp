@@ -82,6 +82,21 @@ void TargetOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Path to write translated and serialized executable binaries into."),
       llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<std::string>(
+      "iree-hal-executable-cache-path", executableCachePath,
+      llvm::cl::desc(
+          "Path to a cache of translated and serialized executables keyed by "
+          "their contents. Executables unchanged since a prior compilation "
+          "reuse its results. The cache must be cleared when changing flags "
+          "that affect code generation."),
+      llvm::cl::cat(halTargetOptionsCategory));
+
+  binder.opt<bool>(
+      "iree-hal-executable-compile-timing", executableCompileTiming,
+      llvm::cl::desc("Reports the time taken to translate and serialize each "
+                     "executable as a remark on it."),
+      llvm::cl::cat(halTargetOptionsCategory));
 }
 
 } // namespace mlir::iree_compiler::IREE::HAL
@@ -49,6 +49,14 @@ struct TargetOptions {
   // A path to write translated and serialized executable binaries into.
   std::string executableBinariesPath;
 
+  // A path to a cache of translated and serialized executables reused across
+  // compilations.
+  std::string executableCachePath;
+
+  // Emits a remark with the time taken to translate and serialize each
+  // executable.
+  bool executableCompileTiming = false;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<TargetOptions>;
 };
@@ -175,6 +175,10 @@ struct FixupLegacySyncPass
             .Case([&](IREE::HAL::DeviceQueueExecuteOp op) {
               insertWaitIfNeeded(op, op.getWaitFenceMutable(),
                                  op.getSignalFence());
+            })
+            .Case([&](IREE::HAL::DeviceQueueExecuteIndirectOp op) {
+              insertWaitIfNeeded(op, op.getWaitFenceMutable(),
+                                 op.getSignalFence());
             });
       });
     }
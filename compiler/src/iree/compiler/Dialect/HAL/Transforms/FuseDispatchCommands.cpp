@@ -0,0 +1,128 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+#define GEN_PASS_DEF_FUSEDISPATCHCOMMANDSPASS
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h.inc"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// --iree-hal-fuse-dispatch-commands
+//===----------------------------------------------------------------------===//
+
+// Returns true if command buffer recording ops can be moved across |op|.
+// Only ops that can't observe or change command buffer state are allowed: the
+// lookups, constants, and workgroup count math that sit between the state
+// pushes and the dispatch they are for.
+static bool isReorderableWithCommands(Operation *op) {
+  if (op->getNumRegions() > 0)
+    return false;
+  if (isMemoryEffectFree(op))
+    return true;
+  auto effectOp = dyn_cast<MemoryEffectOpInterface>(op);
+  return effectOp && effectOp.onlyHasEffect<MemoryEffects::Read>();
+}
+
+// Fuses the push_constants and push_descriptor_set ops recorded immediately
+// before |dispatchOp| into a single hal.command_buffer.dispatch.packed op.
+// Pushes that were elided as redundant are fine: the fused op only updates the
+// state it is given and otherwise inherits what was previously recorded.
+static void fuseDispatch(IREE::HAL::CommandBufferDispatchOp dispatchOp) {
+  Value commandBuffer = dispatchOp.getCommandBuffer();
+  IREE::HAL::CommandBufferPushConstantsOp pushConstantsOp;
+  IREE::HAL::CommandBufferPushDescriptorSetOp pushDescriptorSetOp;
+  for (Operation *op = dispatchOp->getPrevNode(); op; op = op->getPrevNode()) {
+    if (auto constantsOp =
+            dyn_cast<IREE::HAL::CommandBufferPushConstantsOp>(op)) {
+      if (pushConstantsOp || constantsOp.getCommandBuffer() != commandBuffer)
+        break;
+      pushConstantsOp = constantsOp;
+    } else if (auto setOp =
+                   dyn_cast<IREE::HAL::CommandBufferPushDescriptorSetOp>(op)) {
+      // Only the descriptor set pushed last is fused; any others are left in
+      // place as the order of set updates does not matter.
+      if (pushDescriptorSetOp || setOp.getCommandBuffer() != commandBuffer)
+        break;
+      pushDescriptorSetOp = setOp;
+    } else if (!isReorderableWithCommands(op)) {
+      break;
+    }
+  }
+  if (!pushConstantsOp && !pushDescriptorSetOp)
+    return; // nothing to fuse
+
+  // Packed constants always start at offset 0.
+  if (pushConstantsOp && pushConstantsOp.getOffset() != 0)
+    pushConstantsOp = {};
+
+  // Both pushes must use the same layout as only one is passed.
+  Value pipelineLayout;
+  if (pushConstantsOp && pushDescriptorSetOp &&
+      pushConstantsOp.getPipelineLayout() !=
+          pushDescriptorSetOp.getPipelineLayout()) {
+    pushConstantsOp = {};
+  }
+  if (pushConstantsOp) {
+    pipelineLayout = pushConstantsOp.getPipelineLayout();
+  } else if (pushDescriptorSetOp) {
+    pipelineLayout = pushDescriptorSetOp.getPipelineLayout();
+  } else {
+    return; // nothing to fuse
+  }
+
+  OpBuilder builder(dispatchOp);
+  Value set = pushDescriptorSetOp
+                  ? pushDescriptorSetOp.getSet()
+                  : builder.create<arith::ConstantIndexOp>(dispatchOp.getLoc(),
+                                                           0);
+  builder.create<IREE::HAL::CommandBufferDispatchPackedOp>(
+      dispatchOp.getLoc(), commandBuffer, pipelineLayout,
+      dispatchOp.getExecutable(), dispatchOp.getEntryPoint(),
+      dispatchOp.getWorkgroupX(), dispatchOp.getWorkgroupY(),
+      dispatchOp.getWorkgroupZ(),
+      pushConstantsOp ? pushConstantsOp.getValues() : ValueRange{}, set,
+      pushDescriptorSetOp ? pushDescriptorSetOp.getBindingOrdinals()
+                          : ValueRange{},
+      pushDescriptorSetOp ? pushDescriptorSetOp.getBindingBuffers()
+                          : ValueRange{},
+      pushDescriptorSetOp ? pushDescriptorSetOp.getBindingOffsets()
+                          : ValueRange{},
+      pushDescriptorSetOp ? pushDescriptorSetOp.getBindingLengths()
+                          : ValueRange{});
+  dispatchOp.erase();
+  if (pushConstantsOp)
+    pushConstantsOp.erase();
+  if (pushDescriptorSetOp)
+    pushDescriptorSetOp.erase();
+}
+
+struct FuseDispatchCommandsPass
+    : public IREE::HAL::impl::FuseDispatchCommandsPassBase<
+          FuseDispatchCommandsPass> {
+  void runOnOperation() override {
+    SmallVector<IREE::HAL::CommandBufferDispatchOp> dispatchOps;
+    getOperation()->walk([&](IREE::HAL::CommandBufferDispatchOp dispatchOp) {
+      dispatchOps.push_back(dispatchOp);
+    });
+    for (auto dispatchOp : dispatchOps) {
+      fuseDispatch(dispatchOp);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::HAL
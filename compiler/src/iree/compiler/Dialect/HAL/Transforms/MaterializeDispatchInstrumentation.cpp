@@ -149,6 +149,10 @@ struct MaterializeDispatchInstrumentationPass
       Value buffer = initializerBuilder.create<IREE::Stream::ResourceAllocOp>(
           loc, globalOp.getType(), bufferSize,
           /*uninitialized=*/true, /*affinity=*/nullptr);
+      if (samplingPeriod) {
+        buffer = initializeSamplingPeriod(loc, buffer, bufferSize,
+                                          totalBufferSize, initializerBuilder);
+      }
       globalOp.createStoreOp(loc, buffer, initializerBuilder);
       initializerBuilder.create<IREE::Util::ReturnOp>(loc);
     }
@@ -203,7 +207,8 @@ struct MaterializeDispatchInstrumentationPass
         auto subspanOp = funcBuilder.create<IREE::Stream::BindingSubspanOp>(
             loc, bufferType, bindingArg, /*byteOffset=*/zero, ValueRange{});
         funcBuilder.create<IREE::HAL::InstrumentWorkgroupOp>(
-            loc, indexType, subspanOp.getResult(), dispatchIdArg);
+            loc, indexType, subspanOp.getResult(), dispatchIdArg,
+            /*sampled=*/samplingPeriod != 0);
 
         // Build function metadata.
         auto nameRef = metadataBuilder.createString(exportOp.getName());
@@ -361,6 +366,38 @@ struct MaterializeDispatchInstrumentationPass
       queryBuilder.create<IREE::Util::ReturnOp>(loc);
     }
   }
+
+  // Stores the sampling period into the footer of the otherwise uninitialized
+  // instrumentation |buffer| and returns the buffer once the store completes.
+  // Applications may overwrite the value at runtime to change the rate.
+  Value initializeSamplingPeriod(Location loc, Value buffer, Value bufferSize,
+                                 int64_t totalBufferSize, OpBuilder &builder) {
+    Value periodOffset = builder.create<arith::ConstantIndexOp>(
+        loc,
+        totalBufferSize - IREE_INSTRUMENT_DISPATCH_SAMPLING_PERIOD_OFFSET);
+    Value periodLength =
+        builder.create<arith::ConstantIndexOp>(loc, sizeof(uint32_t));
+    Value periodValue =
+        builder.create<arith::ConstantIntOp>(loc, samplingPeriod, 32);
+    auto executeOp = builder.create<IREE::Stream::CmdExecuteOp>(
+        loc, /*awaitTimepoint=*/Value{}, ValueRange{buffer},
+        ValueRange{bufferSize});
+    {
+      OpBuilder::InsertionGuard guard(builder);
+      Block *entryBlock = builder.createBlock(
+          &executeOp.getBody(), executeOp.getBody().end(),
+          TypeRange{buffer.getType()}, {loc});
+      builder.create<IREE::Stream::CmdFillOp>(
+          loc, entryBlock->getArgument(0), bufferSize, periodOffset,
+          periodLength, periodValue);
+      builder.create<IREE::Stream::YieldOp>(loc);
+    }
+    return builder
+        .create<IREE::Stream::TimepointAwaitOp>(
+            loc, buffer, bufferSize, executeOp.getResultTimepoint())
+        .getResults()
+        .front();
+  }
 };
 
 } // namespace
@@ -31,6 +31,9 @@ namespace {
 struct MaterializeResourceCachesPass
     : public IREE::HAL::impl::MaterializeResourceCachesPassBase<
           MaterializeResourceCachesPass> {
+  using IREE::HAL::impl::MaterializeResourceCachesPassBase<
+      MaterializeResourceCachesPass>::MaterializeResourceCachesPassBase;
+
   void runOnOperation() override {
     auto moduleOp = getOperation();
     if (moduleOp.getBody()->empty())
@@ -183,15 +186,65 @@ private:
 
     auto executableType = ExecutableType::get(executableOp.getContext());
     auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
-        loc, symbolName, /*isMutable=*/false, executableType);
+        loc, symbolName, /*isMutable=*/lazyExecutables, executableType);
     globalOp.setPrivate();
     executableCache_.try_emplace(executableOp.getSymName(), globalOp);
 
+    if (lazyExecutables) {
+      defineLazyExecutableOp(executableOp, globalOp);
+      return;
+    }
+
     auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
     OpBuilder blockBuilder =
         OpBuilder::atBlockEnd(initializerOp.addEntryBlock());
+    Value executableValue = buildExecutableCreate(executableOp, blockBuilder);
+    globalOp.createStoreOp(loc, executableValue, blockBuilder);
+    blockBuilder.create<IREE::Util::ReturnOp>(loc);
+  }
+
+  // Defines a function that creates the executable on first use and caches it
+  // in |globalOp| for subsequent calls. Lookups of the executable are replaced
+  // with calls to the function such that only executables that are used are
+  // ever created.
+  void defineLazyExecutableOp(ExecutableOp executableOp,
+                              IREE::Util::GlobalOp globalOp) {
+    auto loc = executableOp.getLoc();
+    auto executableType = ExecutableType::get(executableOp.getContext());
+    auto funcOp = moduleBuilder.create<IREE::Util::FuncOp>(
+        loc, (globalOp.getSymName() + "_get").str(),
+        moduleBuilder.getFunctionType({}, {executableType}));
+    funcOp.setPrivate();
+    lazyExecutableCache_.try_emplace(executableOp.getSymName(), funcOp);
+
+    auto funcBuilder = OpBuilder::atBlockBegin(funcOp.addEntryBlock());
+    Value cachedValue =
+        globalOp.createLoadOp(loc, funcBuilder).getLoadedGlobalValue();
+    Value nullValue =
+        funcBuilder.create<IREE::Util::NullOp>(loc, executableType);
+    Value isNull =
+        funcBuilder.create<IREE::Util::CmpEQOp>(loc, cachedValue, nullValue);
+    auto ifOp =
+        funcBuilder.create<scf::IfOp>(loc, executableType, isNull,
+                                      /*addThenBlock=*/true,
+                                      /*addElseBlock=*/true);
+    auto thenBuilder = ifOp.getThenBodyBuilder();
+    Value executableValue = buildExecutableCreate(executableOp, thenBuilder);
+    globalOp.createStoreOp(loc, executableValue, thenBuilder);
+    thenBuilder.create<scf::YieldOp>(loc, executableValue);
+    auto elseBuilder = ifOp.getElseBodyBuilder();
+    elseBuilder.create<scf::YieldOp>(loc, cachedValue);
+    funcBuilder.create<IREE::Util::ReturnOp>(loc, ifOp.getResults());
+  }
+
+  // Builds the selection of a supported variant of |executableOp| and its
+  // creation at the insertion point of |builder|.
+  Value buildExecutableCreate(ExecutableOp executableOp, OpBuilder &builder) {
+    auto loc = executableOp.getLoc();
+    auto executableType = ExecutableType::get(executableOp.getContext());
+
     // TODO(multi-device): pass in resolve info to the call and reuse.
-    Value device = IREE::HAL::DeviceType::resolveAny(loc, blockBuilder);
+    Value device = IREE::HAL::DeviceType::resolveAny(loc, builder);
 
     // Create a switch statement with a case for each variant.
     // Each case should then cache only executables which contain a matching
@@ -211,10 +264,10 @@ private:
         [&](Location loc, size_t i, OpBuilder &builder) {
           return caseVariantOps[i].buildCondition(device, builder);
         },
-        blockBuilder);
+        builder);
 
     // Allow each variant to define how it is loaded and what pipeline it has.
-    auto switchOp = blockBuilder.create<scf::IndexSwitchOp>(
+    auto switchOp = builder.create<scf::IndexSwitchOp>(
         loc, executableType, selectedIndex, caseIndices, caseIndices.size());
     for (auto [i, variantOp] : llvm::enumerate(caseVariantOps)) {
       auto &caseBlock = switchOp.getCaseRegions()[i].emplaceBlock();
@@ -264,9 +317,7 @@ private:
         defaultBuilder.createOrFold<IREE::Util::NullOp>(loc, executableType);
     defaultBuilder.create<scf::YieldOp>(loc, nullValue);
 
-    auto executableValue = switchOp.getResult(0);
-    globalOp.createStoreOp(loc, executableValue, blockBuilder);
-    blockBuilder.create<IREE::Util::ReturnOp>(loc);
+    return switchOp.getResult(0);
   }
 
   // Inlines a constant block as a function in |moduleBuilder| and then inserts
@@ -319,6 +370,14 @@ private:
     auto executableIt = executableCache_.find(lookupOp.getExecutable());
     assert(executableIt != executableCache_.end() &&
            "executable must have been cached");
+    auto lazyIt = lazyExecutableCache_.find(lookupOp.getExecutable());
+    if (lazyIt != lazyExecutableCache_.end()) {
+      auto callOp = builder.create<IREE::Util::CallOp>(
+          lookupOp.getLoc(), lazyIt->second, ValueRange{});
+      lookupOp.replaceAllUsesWith(callOp.getResult(0));
+      lookupOp.erase();
+      return;
+    }
     auto globalOp = executableIt->second;
     auto loadedValue = globalOp.createLoadOp(lookupOp.getLoc(), builder)
                            .getLoadedGlobalValue();
@@ -332,6 +391,7 @@ private:
       descriptorSetLayoutCache_;
   DenseMap<Attribute, IREE::Util::GlobalOp> pipelineLayoutCache_;
   DenseMap<StringRef, IREE::Util::GlobalOp> executableCache_;
+  DenseMap<StringRef, IREE::Util::FuncOp> lazyExecutableCache_;
 
   int nextUniqueConstantBlockId = 0;
   int nextUniquePipelineLayoutId = 0;
@@ -0,0 +1,336 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
+#include "iree/compiler/Dialect/HAL/IR/HALOps.h"
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilDialect.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/ADT/SetVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/IRMapping.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-hal-memoize-command-buffers"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+#define GEN_PASS_DEF_MEMOIZECOMMANDBUFFERSPASS
+#include "iree/compiler/Dialect/HAL/Transforms/Passes.h.inc"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// --iree-hal-memoize-command-buffers
+//===----------------------------------------------------------------------===//
+
+// A one-shot command buffer recorded in a function along with everything
+// needed to record it again elsewhere.
+struct MemoizableCommandBuffer {
+  IREE::HAL::CommandBufferCreateOp createOp;
+  // Recording ops in program order, including the finalize.
+  SmallVector<Operation *> recordingOps;
+  // Ops producing the values the recording depends on in program order.
+  SmallVector<Operation *> invariantOps;
+  // Per-call (buffer, offset, length) bindings recorded as binding table
+  // slots when memoizing with indirect bindings. The slot of each binding is
+  // its index in the map.
+  llvm::MapVector<std::tuple<Value, Value, Value>, unsigned> bindingSlots;
+};
+
+// Returns true if |value| is the same every time the function runs: it is
+// derived only from constants and immutable globals through pure ops.
+// Defining ops are appended to |invariantOps| on success.
+static bool isInvariant(Value value, llvm::SetVector<Operation *> &invariantOps,
+                        DenseSet<Operation *> &visitedOps) {
+  Operation *op = value.getDefiningOp();
+  if (!op || op->getNumRegions() != 0) {
+    return false;
+  }
+  if (invariantOps.contains(op)) {
+    return true;
+  }
+  if (!visitedOps.insert(op).second) {
+    return false;
+  }
+  if (auto loadOp = dyn_cast<IREE::Util::GlobalLoadOpInterface>(op)) {
+    if (!loadOp.isGlobalImmutable()) {
+      return false;
+    }
+  } else if (!isMemoryEffectFree(op)) {
+    return false;
+  }
+  for (Value operand : op->getOperands()) {
+    if (!isInvariant(operand, invariantOps, visitedOps)) {
+      return false;
+    }
+  }
+  invariantOps.insert(op);
+  return true;
+}
+
+// Matches a command buffer whose recording is the same on every invocation:
+// it is created and recorded in one block, only submitted afterward, and every
+// operand of every recording op is invariant. When |indirectBindings| is set
+// descriptor set bindings may reference per-call buffers and offsets as long
+// as their lengths are invariant; those are recorded as binding table slots
+// and must be provided on each submission.
+static std::optional<MemoizableCommandBuffer>
+matchMemoizableCommandBuffer(IREE::HAL::CommandBufferCreateOp createOp,
+                             bool indirectBindings) {
+  if (!bitEnumContainsAll(createOp.getModes(),
+                          IREE::HAL::CommandBufferModeBitfield::OneShot) ||
+      createOp.getBindingCapacity()) {
+    return std::nullopt;
+  }
+  Block *block = createOp->getBlock();
+  Value commandBuffer = createOp.getResult();
+  IREE::HAL::CommandBufferFinalizeOp finalizeOp;
+  for (Operation *user : commandBuffer.getUsers()) {
+    if (user->getBlock() != block) {
+      return std::nullopt;
+    }
+    if (auto userFinalizeOp =
+            dyn_cast<IREE::HAL::CommandBufferFinalizeOp>(user)) {
+      if (finalizeOp) {
+        return std::nullopt;
+      }
+      finalizeOp = userFinalizeOp;
+    }
+  }
+  if (!finalizeOp) {
+    return std::nullopt;
+  }
+
+  MemoizableCommandBuffer result;
+  result.createOp = createOp;
+  llvm::SetVector<Operation *> invariantOps;
+  DenseSet<Operation *> visitedOps;
+  for (Value operand : createOp->getOperands()) {
+    if (!isInvariant(operand, invariantOps, visitedOps)) {
+      return std::nullopt;
+    }
+  }
+  for (Operation *user : commandBuffer.getUsers()) {
+    if (user == finalizeOp) {
+      continue;
+    }
+    if (auto executeOp = dyn_cast<IREE::HAL::DeviceQueueExecuteOp>(user)) {
+      // Submissions must happen after recording has completed. Indirect
+      // submissions take a single command buffer.
+      if (!finalizeOp->isBeforeInBlock(user) ||
+          (indirectBindings && executeOp.getCommandBuffers().size() != 1)) {
+        return std::nullopt;
+      }
+      continue;
+    }
+    // Only the command buffer recording ops are moved; anything else using
+    // the command buffer (calls, returns, etc) can't be tracked.
+    if (!isa_and_nonnull<IREE::HAL::HALDialect>(user->getDialect()) ||
+        user->getNumResults() != 0 || user->getNumRegions() != 0 ||
+        !createOp->isBeforeInBlock(user) ||
+        !user->isBeforeInBlock(finalizeOp)) {
+      return std::nullopt;
+    }
+    DenseSet<Value> indirectOperands;
+    if (auto pushOp =
+            dyn_cast<IREE::HAL::CommandBufferPushDescriptorSetOp>(user);
+        pushOp && indirectBindings) {
+      for (auto [buffer, offset, length] :
+           llvm::zip_equal(pushOp.getBindingBuffers(),
+                           pushOp.getBindingOffsets(),
+                           pushOp.getBindingLengths())) {
+        if (!isa<IREE::HAL::BufferType>(buffer.getType()) ||
+            (isInvariant(buffer, invariantOps, visitedOps) &&
+             isInvariant(offset, invariantOps, visitedOps))) {
+          continue;
+        }
+        if (!isInvariant(length, invariantOps, visitedOps)) {
+          return std::nullopt;
+        }
+        auto key = std::make_tuple(buffer, offset, length);
+        result.bindingSlots.insert({key, result.bindingSlots.size()});
+        indirectOperands.insert(buffer);
+        indirectOperands.insert(offset);
+      }
+    }
+    for (Value operand : user->getOperands()) {
+      if (operand != commandBuffer && !indirectOperands.contains(operand) &&
+          !isInvariant(operand, invariantOps, visitedOps)) {
+        return std::nullopt;
+      }
+    }
+    result.recordingOps.push_back(user);
+  }
+  result.recordingOps.push_back(finalizeOp);
+  llvm::sort(result.recordingOps, [](Operation *lhs, Operation *rhs) {
+    return lhs->isBeforeInBlock(rhs);
+  });
+
+  // Invariant values may be defined in parent blocks so they are ordered by
+  // discovery, which always visits operands before their users.
+  result.invariantOps = invariantOps.takeVector();
+  return result;
+}
+
+// Rewrites the per-call bindings of |pushOp| cloned into an initializer to
+// reference their binding table slots instead.
+static void
+rewriteIndirectBindings(IREE::HAL::CommandBufferPushDescriptorSetOp pushOp,
+                        IREE::HAL::CommandBufferPushDescriptorSetOp newPushOp,
+                        const MemoizableCommandBuffer &commandBuffer,
+                        OpBuilder &builder) {
+  for (auto [i, binding] : llvm::enumerate(llvm::zip_equal(
+           pushOp.getBindingBuffers(), pushOp.getBindingOffsets(),
+           pushOp.getBindingLengths()))) {
+    auto it = commandBuffer.bindingSlots.find(binding);
+    if (it == commandBuffer.bindingSlots.end()) {
+      continue;
+    }
+    // The binding table entry carries the offset so the recorded binding
+    // starts at the beginning of the slot.
+    auto loc = pushOp.getLoc();
+    newPushOp.getBindingBuffersMutable()[i].set(
+        builder.create<arith::ConstantIndexOp>(loc, it->second));
+    newPushOp.getBindingOffsetsMutable()[i].set(
+        builder.create<arith::ConstantIndexOp>(loc, 0));
+  }
+}
+
+struct MemoizeCommandBuffersPass
+    : public IREE::HAL::impl::MemoizeCommandBuffersPassBase<
+          MemoizeCommandBuffersPass> {
+  void runOnOperation() override {
+    auto moduleOp = getOperation();
+
+    // Only functions that are never called from within the program are
+    // considered so that no initializer can observe the globals before they
+    // are recorded.
+    SmallVector<MemoizableCommandBuffer> commandBuffers;
+    for (auto funcOp : moduleOp.getOps<IREE::Util::FuncOp>()) {
+      if (funcOp.isExternal() ||
+          !SymbolTable::symbolKnownUseEmpty(funcOp, moduleOp)) {
+        continue;
+      }
+      funcOp.walk([&](IREE::HAL::CommandBufferCreateOp createOp) {
+        if (auto commandBuffer =
+                matchMemoizableCommandBuffer(createOp, indirectBindings)) {
+          commandBuffers.push_back(std::move(*commandBuffer));
+        }
+      });
+    }
+    if (commandBuffers.empty()) {
+      return;
+    }
+
+    // Initializers are appended so they run after those that initialize the
+    // globals the recording depends on.
+    SymbolTable symbolTable(moduleOp);
+    auto moduleBuilder = OpBuilder::atBlockEnd(moduleOp.getBody());
+    auto commandBufferType =
+        moduleBuilder.getType<IREE::HAL::CommandBufferType>();
+    for (auto [index, commandBuffer] : llvm::enumerate(commandBuffers)) {
+      auto createOp = commandBuffer.createOp;
+      auto loc = createOp.getLoc();
+      LLVM_DEBUG(llvm::dbgs() << "[" DEBUG_TYPE "] memoizing " << createOp
+                              << "\n");
+
+      auto globalOp = moduleBuilder.create<IREE::Util::GlobalOp>(
+          loc, "_command_buffer_" + std::to_string(index),
+          /*isMutable=*/false, commandBufferType);
+      symbolTable.insert(globalOp);
+      globalOp.setPrivate();
+
+      // Record the command buffer once at startup. It may be submitted many
+      // times so it can no longer be one-shot or execute inline. Command
+      // buffers with per-call bindings are executed indirectly and must be
+      // nested.
+      auto initializerOp = moduleBuilder.create<IREE::Util::InitializerOp>(loc);
+      auto initializerBuilder =
+          OpBuilder::atBlockBegin(initializerOp.addEntryBlock());
+      IRMapping mapping;
+      for (Operation *op : commandBuffer.invariantOps) {
+        initializerBuilder.clone(*op, mapping);
+      }
+      auto newCreateOp = cast<IREE::HAL::CommandBufferCreateOp>(
+          initializerBuilder.clone(*createOp, mapping));
+      if (commandBuffer.bindingSlots.empty()) {
+        newCreateOp.setModes(IREE::HAL::CommandBufferModeBitfield::None);
+      } else {
+        newCreateOp.setModes(IREE::HAL::CommandBufferModeBitfield::Nested);
+        OpBuilder capacityBuilder(newCreateOp);
+        newCreateOp.getBindingCapacityMutable().assign(
+            capacityBuilder.create<arith::ConstantIndexOp>(
+                loc, commandBuffer.bindingSlots.size()));
+      }
+      for (Operation *op : commandBuffer.recordingOps) {
+        auto *newOp = initializerBuilder.clone(*op, mapping);
+        if (auto pushOp =
+                dyn_cast<IREE::HAL::CommandBufferPushDescriptorSetOp>(op)) {
+          OpBuilder slotBuilder(newOp);
+          rewriteIndirectBindings(
+              pushOp, cast<IREE::HAL::CommandBufferPushDescriptorSetOp>(newOp),
+              commandBuffer, slotBuilder);
+        }
+      }
+      globalOp.createStoreOp(loc, newCreateOp.getResult(), initializerBuilder);
+      initializerBuilder.create<IREE::Util::ReturnOp>(loc);
+
+      // Each invocation now only submits the recorded command buffer.
+      for (Operation *op : llvm::reverse(commandBuffer.recordingOps)) {
+        op->erase();
+      }
+      OpBuilder replaceBuilder(createOp);
+      auto loadOp = globalOp.createLoadOp(loc, replaceBuilder);
+      createOp.getResult().replaceAllUsesWith(loadOp.getLoadedGlobalValue());
+      createOp.erase();
+
+      // Submissions provide the per-call bindings in the binding table.
+      if (!commandBuffer.bindingSlots.empty()) {
+        replaceWithIndirectExecutes(loadOp.getLoadedGlobalValue(),
+                                    commandBuffer);
+      }
+    }
+  }
+
+  // Replaces each submission of |commandBuffer| with an indirect execution
+  // that passes the per-call bindings in slot order.
+  void replaceWithIndirectExecutes(
+      Value loadedCommandBuffer, const MemoizableCommandBuffer &commandBuffer) {
+    SmallVector<Value> bindingBuffers;
+    SmallVector<Value> bindingOffsets;
+    SmallVector<Value> bindingLengths;
+    for (auto &[binding, slot] : commandBuffer.bindingSlots) {
+      auto [buffer, offset, length] = binding;
+      bindingBuffers.push_back(buffer);
+      bindingOffsets.push_back(offset);
+      bindingLengths.push_back(length);
+    }
+    for (Operation *user :
+         llvm::make_early_inc_range(loadedCommandBuffer.getUsers())) {
+      auto executeOp = dyn_cast<IREE::HAL::DeviceQueueExecuteOp>(user);
+      if (!executeOp) {
+        continue;
+      }
+      OpBuilder builder(executeOp);
+      builder.create<IREE::HAL::DeviceQueueExecuteIndirectOp>(
+          executeOp.getLoc(), executeOp.getDevice(),
+          executeOp.getQueueAffinity(), executeOp.getWaitFence(),
+          executeOp.getSignalFence(), loadedCommandBuffer, bindingBuffers,
+          bindingOffsets, bindingLengths);
+      executeOp.erase();
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::HAL
@@ -55,6 +55,33 @@ static llvm::cl::opt<unsigned> clBenchmarkDispatchRepeatCount{
     llvm::cl::init(1),
 };
 
+static llvm::cl::opt<bool> clMemoizeCommandBuffers{
+    "iree-hal-memoize-command-buffers",
+    llvm::cl::desc(
+        "Records command buffers that are the same on every invocation once "
+        "at startup and reuses them instead of recording them per call."),
+    llvm::cl::init(false),
+};
+
+static llvm::cl::opt<bool> clMemoizeIndirectCommandBuffers{
+    "iree-hal-memoize-indirect-command-buffers",
+    llvm::cl::desc(
+        "Also memoizes command buffers that only differ per invocation in the "
+        "buffers they bind by recording them with indirect bindings and "
+        "passing the per-call buffers on submission. Not supported by the "
+        "local-task HAL driver."),
+    llvm::cl::init(false),
+};
+
+static llvm::cl::opt<bool> clFuseDispatchCommands{
+    "iree-hal-fuse-dispatch-commands",
+    llvm::cl::desc(
+        "Fuses push constants and descriptor set updates into the dispatch "
+        "they precede so that each dispatch is recorded with a single runtime "
+        "call. Requires a runtime HAL module version 4 or newer."),
+    llvm::cl::init(false),
+};
+
 static llvm::cl::opt<llvm::cl::PowerOf2ByteSize> clInstrumentDispatchBufferSize{
     "iree-hal-instrument-dispatches",
     llvm::cl::desc("Enables dispatch instrumentation with a power-of-two byte "
@@ -62,6 +89,24 @@ static llvm::cl::opt<llvm::cl::PowerOf2ByteSize> clInstrumentDispatchBufferSize{
     llvm::cl::init(llvm::cl::PowerOf2ByteSize(0)),
 };
 
+static llvm::cl::opt<uint32_t> clInstrumentDispatchSamplingPeriod{
+    "iree-hal-instrument-dispatches-sampling-period",
+    llvm::cl::desc("Instruments only 1 in N workgroups of each dispatch when "
+                   "dispatch instrumentation is enabled. The period can be "
+                   "changed at runtime and 0 pauses recording."),
+    llvm::cl::init(0),
+};
+
+static llvm::cl::opt<bool> clLazyExecutables{
+    "iree-hal-lazy-executables",
+    llvm::cl::desc(
+        "Creates executables on first use instead of when the module is "
+        "initialized. Reduces startup time and memory usage of programs that "
+        "only call a subset of their functions at the cost of first-call "
+        "latency."),
+    llvm::cl::init(false),
+};
+
 static llvm::cl::list<std::string> clSubstituteExecutableSource{
     "iree-hal-substitute-executable-source",
     llvm::cl::desc(
@@ -218,7 +263,7 @@ void buildHALConfigurationPassPipeline(OpPassManager &passManager,
   // more easily mutate the stream dispatch ops and exports.
   if (auto bufferSize = clInstrumentDispatchBufferSize.getValue()) {
     passManager.addPass(IREE::HAL::createMaterializeDispatchInstrumentationPass(
-        {bufferSize.value}));
+        {bufferSize.value, clInstrumentDispatchSamplingPeriod.getValue()}));
   }
 
   // Each executable needs a hal.interface to specify how the host and
@@ -364,7 +409,9 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
 
   if (compileFrom < PipelinePhase::ExecutableTargets) {
     passManager.addNestedPass<IREE::HAL::ExecutableOp>(
-        IREE::HAL::createTranslateExecutablesPass({targetRegistry}));
+        IREE::HAL::createTranslateExecutablesPass(
+            {targetRegistry, targetOptions.executableCompileTiming,
+             targetOptions.executableCachePath}));
   }
 
   // If debug information is requested capture the translated MLIR source text
@@ -428,8 +475,10 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   passManager.addPass(IREE::HAL::createResolveExportOrdinalsPass());
 
   // Gather cacheable resources such as executables and descriptor sets and
-  // cache them at initialization-time.
-  passManager.addPass(IREE::HAL::createMaterializeResourceCachesPass());
+  // cache them at initialization-time (or on first use with
+  // --iree-hal-lazy-executables).
+  passManager.addPass(
+      IREE::HAL::createMaterializeResourceCachesPass({clLazyExecutables}));
 
   //----------------------------------------------------------------------------
   // Device management and specialization
@@ -456,6 +505,22 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
   FunctionLikeNest(passManager)
       .addPass(IREE::HAL::createElideRedundantCommandsPass);
 
+  // Hoist command buffers that don't change across invocations into globals
+  // recorded at startup. This runs after command elision so that the recorded
+  // commands are already minimal.
+  if (clMemoizeCommandBuffers) {
+    passManager.addPass(IREE::HAL::createMemoizeCommandBuffersPass(
+        {clMemoizeIndirectCommandBuffers}));
+  }
+
+  // Fold the state pushes preceding each dispatch into the dispatch itself to
+  // reduce the number of runtime calls made per dispatch. This runs after
+  // command elision so that only state that changed is pushed.
+  if (clFuseDispatchCommands) {
+    FunctionLikeNest(passManager)
+        .addPass(IREE::HAL::createFuseDispatchCommandsPass);
+  }
+
   // TODO: Maybe this should be a part of Affine lowering pass.
   // Remove if it is added there.
   // https://github.com/llvm/llvm-project/issues/78458
@@ -483,7 +548,9 @@ void buildHALTransformPassPipeline(OpPassManager &passManager,
         IREE::HAL::createSerializeExecutablesPass(
             {&targetRegistry, targetOptions.debugLevel,
              targetOptions.executableIntermediatesPath,
-             targetOptions.executableBinariesPath}));
+             targetOptions.executableBinariesPath,
+             targetOptions.executableCompileTiming,
+             targetOptions.executableCachePath}));
 
     // NOTE: symbol DCE will destroy executable target contents, so only run
     // it if we serialized things.
@@ -4,7 +4,10 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
 #include <memory>
+#include <optional>
+#include <string>
 #include <utility>
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
@@ -12,9 +15,12 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "llvm/ADT/StringSet.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
+#include "llvm/Support/TimeProfiler.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
 #include "mlir/IR/Diagnostics.h"
@@ -75,21 +81,55 @@ struct SerializeTargetExecutablesPass
       llvm::sys::fs::create_directories(dumpBinariesPath);
     }
 
+    // Cached binaries would skip writing the requested dumps.
+    std::optional<ExecutableCache> cache;
+    if (!cachePath.empty() && dumpIntermediatesPath.empty() &&
+        dumpBinariesPath.empty()) {
+      cache.emplace(cachePath);
+    }
+
     auto variantOps = llvm::to_vector(
         executableOp.getBlock().getOps<IREE::HAL::ExecutableVariantOp>());
     for (auto variantOp : variantOps) {
       if (variantOp.getTarget().getBackend().getValue() != target)
         continue;
+      std::string cacheKey;
+      if (cache) {
+        std::string stage = "serialize-" + std::to_string(debugLevel);
+        cacheKey = cache->getKey(variantOp, stage,
+                                 /*includeLocations=*/debugLevel > 0);
+        Block block;
+        if (cache->load(cacheKey, block, variantOp.getContext())) {
+          for (auto &op : llvm::make_early_inc_range(block)) {
+            op.moveBefore(variantOp);
+          }
+          variantOp.erase();
+          continue;
+        }
+      }
+      Operation *prevOp = variantOp->getPrevNode();
       OpBuilder executableBuilder(variantOp);
       // Ask the target backend to serialize the executable. Note that it
       // may create one or more hal.executable.binary ops in the case of
       // multi-architecture binaries.
+      // The compile profile totals serialization time per target backend.
+      llvm::TimeTraceScope serializeScope("serialize " + target,
+                                          variantOp.getSymName());
       if (failed(targetBackend->serializeExecutable(
               serializationOptions, variantOp, executableBuilder))) {
         variantOp.emitError()
             << "failed to serialize executable for target backend " << target;
         return signalPassFailure();
       }
+      if (cache) {
+        SmallVector<Operation *> binaryOps;
+        for (Operation *op = prevOp ? prevOp->getNextNode()
+                                    : &executableOp.getBlock().front();
+             op != variantOp; op = op->getNextNode()) {
+          binaryOps.push_back(op);
+        }
+        cache->store(cacheKey, binaryOps);
+      }
       variantOp.erase();
     }
   }
@@ -110,15 +150,23 @@ struct SerializeExecutablesPass
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addPass(IREE::HAL::createSerializeTargetExecutablesPass(
           {targetRegistry, targetName, debugLevel, dumpIntermediatesPath,
-           dumpBinariesPath}));
+           dumpBinariesPath, cachePath}));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
 
+    auto startTime = std::chrono::steady_clock::now();
     if (failed(runPipeline(passManager, executableOp))) {
       executableOp.emitError() << "failed to serialize executables";
       return signalPassFailure();
     }
+
+    if (reportTiming) {
+      std::chrono::duration<double, std::milli> duration =
+          std::chrono::steady_clock::now() - startTime;
+      executableOp.emitRemark()
+          << "serialized in " << llvm::format("%.2f", duration.count()) << "ms";
+    }
   }
 };
 
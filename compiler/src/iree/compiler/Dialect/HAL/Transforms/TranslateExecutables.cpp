@@ -4,7 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <chrono>
 #include <memory>
+#include <optional>
 #include <utility>
 
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
@@ -12,8 +14,10 @@
 #include "iree/compiler/Dialect/HAL/Target/TargetBackend.h"
 #include "iree/compiler/Dialect/HAL/Target/TargetRegistry.h"
 #include "iree/compiler/Dialect/HAL/Transforms/Passes.h"
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
 #include "iree/compiler/Utils/TracingUtils.h"
 #include "llvm/ADT/StringSet.h"
+#include "llvm/Support/Format.h"
 #include "mlir/Dialect/Bufferization/IR/Bufferization.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -29,6 +33,24 @@ namespace mlir::iree_compiler::IREE::HAL {
 
 namespace {
 
+// Replaces the contents of |variantOp| with the translated variant cached
+// under |key|, if any. The variant itself can't be replaced as this pass is
+// anchored on it.
+static bool loadCachedVariant(const ExecutableCache &cache, StringRef key,
+                              IREE::HAL::ExecutableVariantOp variantOp) {
+  Block block;
+  if (!cache.load(key, block, variantOp.getContext()) || block.empty()) {
+    return false;
+  }
+  auto cachedOp = dyn_cast<IREE::HAL::ExecutableVariantOp>(block.front());
+  if (!cachedOp || cachedOp.getSymName() != variantOp.getSymName()) {
+    return false;
+  }
+  variantOp->setAttrs(cachedOp->getAttrDictionary());
+  variantOp.getBody().takeBody(cachedOp.getBody());
+  return true;
+}
+
 //===----------------------------------------------------------------------===//
 // --iree-hal-translate-target-executable-variants
 //===----------------------------------------------------------------------===//
@@ -62,6 +84,17 @@ struct TranslateTargetExecutableVariantsPass
       return signalPassFailure();
     }
 
+    std::optional<ExecutableCache> cache;
+    std::string cacheKey;
+    if (!cachePath.empty()) {
+      cache.emplace(cachePath);
+      cacheKey = cache->getKey(variantOp, "translate",
+                               /*includeLocations=*/true);
+      if (loadCachedVariant(*cache, cacheKey, variantOp)) {
+        return;
+      }
+    }
+
     OpPassManager passManager(variantOp.getOperationName());
     targetBackend->buildTranslationPassPipeline(variantOp.getTargetAttr(),
                                                 passManager);
@@ -71,6 +104,10 @@ struct TranslateTargetExecutableVariantsPass
                             << variantOp.getTarget();
       return signalPassFailure();
     }
+
+    if (cache) {
+      cache->store(cacheKey, {variantOp.getOperation()});
+    }
   }
 };
 
@@ -100,15 +137,25 @@ struct TranslateExecutablesPass
     for (const auto &targetName : gatherExecutableTargetNames(executableOp)) {
       passManager.addNestedPass<IREE::HAL::ExecutableVariantOp>(
           IREE::HAL::createTranslateTargetExecutableVariantsPass(
-              {targetRegistry, targetName}));
+              {targetRegistry, targetName, cachePath}));
     }
 
     IREE_COMPILER_TRACE_MESSAGE_DYNAMIC(INFO, executableOp.getSymName().str());
 
+    auto startTime = std::chrono::steady_clock::now();
     if (failed(runPipeline(passManager, executableOp))) {
       llvm::errs() << "failed to translate executables\n";
       return signalPassFailure();
     }
+
+    // Executables are processed in parallel and the pass manager orders their
+    // diagnostics so the remarks are reported in a deterministic order.
+    if (reportTiming) {
+      std::chrono::duration<double, std::milli> duration =
+          std::chrono::steady_clock::now() - startTime;
+      executableOp.emitRemark()
+          << "translated in " << llvm::format("%.2f", duration.count()) << "ms";
+    }
   }
 };
 
@@ -0,0 +1,85 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(util.func(iree-hal-fuse-dispatch-commands))' %s | FileCheck %s
+
+// Tests that constants and bindings pushed before a dispatch are fused into it.
+
+// CHECK-LABEL: @fuseDispatch
+// CHECK-SAME: (%[[CMD:.+]]: !hal.command_buffer, %[[LAYOUT:.+]]: !hal.pipeline_layout, %[[EXECUTABLE:.+]]: !hal.executable, %[[BUFFER:.+]]: !hal.buffer)
+util.func public @fuseDispatch(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %executable: !hal.executable, %buffer: !hal.buffer) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c4096 = arith.constant 4096 : index
+  %c42_i32 = arith.constant 42 : i32
+  // CHECK-NOT: hal.command_buffer.push_constants
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout) offset(0) values([%c42_i32]) : i32
+  // CHECK-NOT: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c1 = (%buffer : !hal.buffer)[%c4, %c4096]
+  ])
+  // Ops that don't touch the command buffer can be reordered.
+  %x = arith.addi %c1, %c1 : index
+  //      CHECK: hal.command_buffer.dispatch.packed<%[[CMD]] : !hal.command_buffer>
+  // CHECK-SAME:   layout(%[[LAYOUT]] : !hal.pipeline_layout)
+  // CHECK-SAME:   target(%[[EXECUTABLE]] : !hal.executable)
+  // CHECK-SAME:   constants([%{{.+}}] : i32)
+  // CHECK-SAME:   bindings([%{{.+}}][
+  // CHECK-NEXT:     = (%[[BUFFER]] : !hal.buffer)
+  // CHECK-NOT: hal.command_buffer.dispatch<
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%x, %c1, %c1])
+  // CHECK: util.return
+  util.return
+}
+
+// -----
+
+// Tests that a dispatch with only bindings (constants elided as redundant) is
+// fused without constants.
+
+// CHECK-LABEL: @fuseDispatchBindingsOnly
+util.func public @fuseDispatchBindingsOnly(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %executable: !hal.executable, %buffer: !hal.buffer) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4096 = arith.constant 4096 : index
+  // CHECK-NOT: hal.command_buffer.push_descriptor_set
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %c4096]
+  ])
+  // CHECK: hal.command_buffer.dispatch.packed
+  // CHECK-SAME: workgroups([%{{.+}}, %{{.+}}, %{{.+}}]) bindings(
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  util.return
+}
+
+// -----
+
+// Tests that constants pushed at a non-zero offset are left as-is.
+
+// CHECK-LABEL: @skipOffsetConstants
+util.func public @skipOffsetConstants(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %executable: !hal.executable) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c42_i32 = arith.constant 42 : i32
+  // CHECK: hal.command_buffer.push_constants{{.+}} offset(1)
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout) offset(1) values([%c42_i32]) : i32
+  // CHECK: hal.command_buffer.dispatch<
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  util.return
+}
+
+// -----
+
+// Tests that pushes are not fused across other commands.
+
+// CHECK-LABEL: @skipAcrossCommands
+util.func public @skipAcrossCommands(%cmd: !hal.command_buffer, %pipeline_layout: !hal.pipeline_layout, %executable: !hal.executable) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c42_i32 = arith.constant 42 : i32
+  // CHECK: hal.command_buffer.push_constants
+  hal.command_buffer.push_constants<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout) offset(0) values([%c42_i32]) : i32
+  // CHECK: hal.command_buffer.execution_barrier
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|Transfer|CommandRetire") target("CommandIssue|Dispatch|Transfer") flags("None")
+  // CHECK: hal.command_buffer.dispatch<
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  util.return
+}
@@ -1,4 +1,5 @@
 // RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-hal-materialize-dispatch-instrumentation{buffer-size=64mib})' %s | FileCheck %s
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-hal-materialize-dispatch-instrumentation{buffer-size=64mib sampling-period=16})' %s | FileCheck %s --check-prefix=SAMPLED
 
 module attributes {hal.device.targets = [
   #hal.device.target<"llvm-cpu", [
@@ -14,6 +15,17 @@ module attributes {hal.device.targets = [
   // CHECK:   %[[ALLOC_BUFFER:.+]] = stream.resource.alloc uninitialized : !stream.resource<external>{%[[DEFAULT_SIZE]]}
   // CHECK:   util.global.store %[[ALLOC_BUFFER]], @__dispatch_instrumentation
 
+  // Sampling stores the initial period in the buffer footer:
+  // SAMPLED: util.initializer
+  // SAMPLED:   %[[SAMPLED_SIZE:.+]] = arith.constant 67112960
+  // SAMPLED:   %[[SAMPLED_ALLOC:.+]] = stream.resource.alloc uninitialized
+  // SAMPLED-DAG: %[[PERIOD_OFFSET:.+]] = arith.constant 67112944 : index
+  // SAMPLED-DAG: %[[PERIOD:.+]] = arith.constant 16 : i32
+  // SAMPLED:   %[[FILL_TIMEPOINT:.+]] = stream.cmd.execute with(%[[SAMPLED_ALLOC]] as %[[FILL_CAPTURE:.+]]: !stream.resource<external>{%[[SAMPLED_SIZE]]})
+  // SAMPLED:     stream.cmd.fill %[[PERIOD]], %[[FILL_CAPTURE]][%[[PERIOD_OFFSET]] for {{.+}}] : i32
+  // SAMPLED:   %[[SAMPLED_BUFFER:.+]] = stream.timepoint.await %[[FILL_TIMEPOINT]] => %[[SAMPLED_ALLOC]]
+  // SAMPLED:   util.global.store %[[SAMPLED_BUFFER]], @__dispatch_instrumentation
+
   // Query function used by tools to get the buffers and metadata:
   // CHECK: util.func public @__query_instruments(%[[LIST:.+]]: !util.list<?>)
   // CHECK:   %[[INTERNAL_BUFFER:.+]] = util.global.load @__dispatch_instrumentation
@@ -38,6 +50,7 @@ module attributes {hal.device.targets = [
         // Subsequent dispatch instruments will use the workgroup key.
         // CHECK: %[[INSTR_BUFFER:.+]] = stream.binding.subspan %[[INSTR_BINDING]]
         // CHECK: %[[WORKGROUP_KEY:.+]] = hal.instrument.workgroup[%[[INSTR_BUFFER]] : memref<67112960xi8>] dispatch(%[[SITE_ID]]) : index
+        // SAMPLED: hal.instrument.workgroup[{{.+}} : memref<67112960xi8>] dispatch({{.+}}) sampled : index
         %c0 = arith.constant 0 : index
         %cst = arith.constant 2.000000e+00 : f32
         %0 = stream.binding.subspan %arg0[%c0] : !stream.binding -> !flow.dispatch.tensor<readonly:tensor<f32>>
@@ -0,0 +1,64 @@
+// RUN: iree-opt --pass-pipeline='builtin.module(iree-hal-materialize-resource-caches{lazy-executables=true})' %s | FileCheck %s
+
+#pipeline_layout_0 = #hal.pipeline.layout<push_constants = 0, sets = [
+  #hal.descriptor_set.layout<0, bindings = [
+    #hal.descriptor_set.binding<0, storage_buffer>,
+    #hal.descriptor_set.binding<1, storage_buffer>
+  ]>
+]>
+
+hal.executable @exe {
+  hal.executable.variant @vmvx target(<"vmvx", "vmvx-bytecode-fb">) {
+    hal.executable.export @entry0 ordinal(0) layout(#pipeline_layout_0) attributes {
+      workgroup_size = [32 : index, 1 : index, 1 : index]
+    }
+    hal.executable.constant.block() -> i32 as "foo" {
+      %c123 = arith.constant 123 : i32
+      hal.return %c123 : i32
+    }
+  }
+}
+
+// Layouts are still created during initialization.
+// CHECK: util.global private @_pipeline_layout_0 : !hal.pipeline_layout
+// CHECK-NEXT: util.initializer {
+
+// Executables are stored in mutable globals without initializers.
+// CHECK: util.global private mutable @_executable_exe : !hal.executable
+// CHECK-NOT: util.initializer
+
+// The getter creates the executable on first use and memoizes it.
+// CHECK: util.func private @_executable_exe_get() -> !hal.executable
+// CHECK:   %[[CACHED:.+]] = util.global.load @_executable_exe : !hal.executable
+// CHECK:   %[[NULL:.+]] = util.null : !hal.executable
+// CHECK:   %[[IS_NULL:.+]] = util.cmp.eq %[[CACHED]], %[[NULL]] : !hal.executable
+// CHECK:   %[[RESULT:.+]] = scf.if %[[IS_NULL]] -> (!hal.executable) {
+// CHECK:     %[[DEVICE:.+]] = hal.devices.get %{{.+}}
+// CHECK:     %[[RET:.+]] = scf.index_switch
+// CHECK:     case 0 {
+// CHECK:       %[[LAYOUT0:.+]] = util.global.load @_pipeline_layout_0 : !hal.pipeline_layout
+// CHECK:       %[[CONST:.+]] = util.call @__constant_block_0()
+// CHECK:       %[[EXE:.+]] = hal.executable.create
+// CHECK-SAME:    device(%[[DEVICE]] : !hal.device)
+// CHECK-SAME:    target(@exe::@vmvx)
+// CHECK-SAME:    layouts([%[[LAYOUT0]]])
+// CHECK-SAME:    constants([%[[CONST]]])
+// CHECK:       scf.yield %[[EXE]] : !hal.executable
+// CHECK:     }
+// CHECK:     util.global.store %[[RET]], @_executable_exe : !hal.executable
+// CHECK:     scf.yield %[[RET]] : !hal.executable
+// CHECK:   } else {
+// CHECK:     scf.yield %[[CACHED]] : !hal.executable
+// CHECK:   }
+// CHECK:   util.return %[[RESULT]] : !hal.executable
+
+// CHECK: util.func private @__constant_block_0() -> i32
+
+// CHECK-LABEL: @exeLookup
+util.func public @exeLookup(%device : !hal.device) -> !hal.executable {
+  // CHECK: %[[EXE:.+]] = util.call @_executable_exe_get() : () -> !hal.executable
+  %0 = hal.executable.lookup device(%device : !hal.device)
+                             executable(@exe) : !hal.executable
+  // CHECK-NEXT: util.return %[[EXE]]
+  util.return %0 : !hal.executable
+}
@@ -0,0 +1,121 @@
+// RUN: iree-opt --split-input-file --iree-hal-memoize-command-buffers %s | FileCheck %s
+
+// Tests that a command buffer recorded only from constants and immutable
+// globals is recorded once in an initializer and reused on each call.
+
+util.global private @device : !hal.device
+util.global private @executable : !hal.executable
+util.global private @pipeline_layout : !hal.pipeline_layout
+util.global private @buffer : !hal.buffer
+
+// CHECK-LABEL: util.func public @invariant
+util.func public @invariant(%wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c4 = arith.constant 4 : index
+  %c128 = arith.constant 128 : index
+  %affinity = arith.constant -1 : i64
+  // CHECK: %[[DEVICE:.+]] = util.global.load @device
+  %device = util.global.load @device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  %pipeline_layout = util.global.load @pipeline_layout : !hal.pipeline_layout
+  %buffer = util.global.load @buffer : !hal.buffer
+  // CHECK-NOT: hal.command_buffer.create
+  // CHECK-NOT: hal.command_buffer.dispatch
+  // CHECK: %[[CMD:.+]] = util.global.load @_command_buffer_0 : !hal.command_buffer
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %c128]
+  ])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c4, %c1, %c1])
+  hal.command_buffer.execution_barrier<%cmd : !hal.command_buffer> source("Dispatch|CommandRetire") target("CommandIssue|Dispatch") flags("None")
+  // CHECK-NOT: hal.command_buffer.finalize
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  // CHECK: hal.device.queue.execute<%[[DEVICE]] : !hal.device>
+  // CHECK-SAME: commands([%[[CMD]]])
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  util.return
+}
+
+// CHECK: util.global private @_command_buffer_0 : !hal.command_buffer
+// CHECK-NEXT: util.initializer {
+// CHECK-DAG:   %[[INIT_DEVICE:.+]] = util.global.load @device
+// CHECK-DAG:   %[[INIT_EXECUTABLE:.+]] = util.global.load @executable
+// CHECK-DAG:   %[[INIT_BUFFER:.+]] = util.global.load @buffer
+// CHECK:       %[[INIT_CMD:.+]] = hal.command_buffer.create device(%[[INIT_DEVICE]] : !hal.device) mode("None")
+// CHECK-NEXT:  hal.command_buffer.push_descriptor_set<%[[INIT_CMD]]
+// CHECK-NEXT:    (%[[INIT_BUFFER]] : !hal.buffer)
+// CHECK:       hal.command_buffer.dispatch<%[[INIT_CMD]] : !hal.command_buffer> target(%[[INIT_EXECUTABLE]] : !hal.executable)
+// CHECK-NEXT:  hal.command_buffer.execution_barrier<%[[INIT_CMD]]
+// CHECK-NEXT:  hal.command_buffer.finalize<%[[INIT_CMD]]
+// CHECK-NEXT:  util.global.store %[[INIT_CMD]], @_command_buffer_0 : !hal.command_buffer
+// CHECK-NEXT:  util.return
+
+// -----
+
+// Tests that command buffers binding per-call buffers are still recorded on
+// each call unless indirect bindings are enabled (see
+// memoize_indirect_command_buffers.mlir).
+
+util.global private @device : !hal.device
+util.global private @executable : !hal.executable
+util.global private @pipeline_layout : !hal.pipeline_layout
+
+// CHECK-LABEL: util.func public @per_call_binding
+util.func public @per_call_binding(%buffer: !hal.buffer, %wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %affinity = arith.constant -1 : i64
+  %device = util.global.load @device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  %pipeline_layout = util.global.load @pipeline_layout : !hal.pipeline_layout
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %c128]
+  ])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  // CHECK: hal.command_buffer.finalize
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  util.return
+}
+
+// CHECK-NOT: util.initializer
+
+// -----
+
+// Tests that command buffers recorded from mutable globals are not memoized
+// as the recorded values may change between calls.
+
+util.global private @device : !hal.device
+util.global private @executable : !hal.executable
+util.global private mutable @workgroup_count : index
+
+// CHECK-LABEL: util.func public @mutable_global
+util.func public @mutable_global(%wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %affinity = arith.constant -1 : i64
+  %device = util.global.load @device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  %x = util.global.load @workgroup_count : index
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%x, %c1, %c1])
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  util.return
+}
+
+// CHECK-NOT: util.initializer
@@ -0,0 +1,107 @@
+// RUN: iree-opt --split-input-file --iree-hal-memoize-command-buffers{indirect-bindings=true} %s | FileCheck %s
+
+// Tests that a command buffer binding per-call buffers is recorded once with
+// binding table slots and submitted indirectly with the per-call bindings.
+
+util.global private @device : !hal.device
+util.global private @executable : !hal.executable
+util.global private @pipeline_layout : !hal.pipeline_layout
+util.global private @constant_buffer : !hal.buffer
+
+// CHECK-LABEL: util.func public @per_call_bindings
+// CHECK-SAME: (%[[ARG0:.+]]: !hal.buffer, %[[ARG1:.+]]: !hal.buffer, %[[OFFSET:.+]]: index, %[[WAIT:.+]]: !hal.fence, %[[SIGNAL:.+]]: !hal.fence)
+util.func public @per_call_bindings(%arg0: !hal.buffer, %arg1: !hal.buffer, %offset: index, %wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c2 = arith.constant 2 : index
+  %c128 = arith.constant 128 : index
+  %c256 = arith.constant 256 : index
+  %affinity = arith.constant -1 : i64
+  // CHECK-DAG: %[[C128:.+]] = arith.constant 128
+  // CHECK-DAG: %[[C256:.+]] = arith.constant 256
+  // CHECK: %[[DEVICE:.+]] = util.global.load @device
+  %device = util.global.load @device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  %pipeline_layout = util.global.load @pipeline_layout : !hal.pipeline_layout
+  %constant_buffer = util.global.load @constant_buffer : !hal.buffer
+  // CHECK-NOT: hal.command_buffer.create
+  // CHECK: %[[CMD:.+]] = util.global.load @_command_buffer_0 : !hal.command_buffer
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%constant_buffer : !hal.buffer)[%c0, %c128],
+    %c1 = (%arg0 : !hal.buffer)[%c0, %c128],
+    %c2 = (%arg1 : !hal.buffer)[%offset, %c256]
+  ])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%arg0 : !hal.buffer)[%c0, %c128]
+  ])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  // CHECK-NOT: hal.command_buffer.finalize
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  //      CHECK: hal.device.queue.execute.indirect<%[[DEVICE]] : !hal.device>
+  // CHECK-SAME:   wait(%[[WAIT]]) signal(%[[SIGNAL]])
+  // CHECK-SAME:   commands(%[[CMD]])
+  // CHECK-SAME:   bindings([
+  // CHECK-NEXT:     (%[[ARG0]] : !hal.buffer)[%{{.+}}, %[[C128]]],
+  // CHECK-NEXT:     (%[[ARG1]] : !hal.buffer)[%[[OFFSET]], %[[C256]]]
+  // CHECK-NEXT:   ])
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  util.return
+}
+
+// CHECK: util.global private @_command_buffer_0 : !hal.command_buffer
+// CHECK-NEXT: util.initializer {
+// CHECK-DAG:   %[[INIT_DEVICE:.+]] = util.global.load @device
+// CHECK-DAG:   %[[INIT_CONSTANT_BUFFER:.+]] = util.global.load @constant_buffer
+// CHECK:       %[[INIT_CMD:.+]] = hal.command_buffer.create device(%[[INIT_DEVICE]] : !hal.device) mode({{"?}}Nested{{"?}}) categories("Transfer|Dispatch") bindings(%{{.+}})
+// CHECK-DAG:   %[[SLOT0:.+]] = arith.constant 0 : index
+// CHECK-DAG:   %[[SLOT1:.+]] = arith.constant 1 : index
+// CHECK:       hal.command_buffer.push_descriptor_set<%[[INIT_CMD]]
+// CHECK-NEXT:    (%[[INIT_CONSTANT_BUFFER]] : !hal.buffer)
+// CHECK-NEXT:    (%[[SLOT0]] : index)
+// CHECK-NEXT:    (%[[SLOT1]] : index)
+// CHECK:       hal.command_buffer.dispatch<%[[INIT_CMD]]
+// CHECK:       hal.command_buffer.push_descriptor_set<%[[INIT_CMD]]
+// CHECK-NEXT:    (%{{.+}} : index)
+// CHECK:       hal.command_buffer.dispatch<%[[INIT_CMD]]
+// CHECK-NEXT:  hal.command_buffer.finalize<%[[INIT_CMD]]
+// CHECK-NEXT:  util.global.store %[[INIT_CMD]], @_command_buffer_0 : !hal.command_buffer
+
+// -----
+
+// Tests that per-call binding lengths still prevent memoization as the
+// recorded ranges must be fixed.
+
+util.global private @device : !hal.device
+util.global private @executable : !hal.executable
+util.global private @pipeline_layout : !hal.pipeline_layout
+
+// CHECK-LABEL: util.func public @per_call_length
+util.func public @per_call_length(%buffer: !hal.buffer, %length: index, %wait: !hal.fence, %signal: !hal.fence) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %affinity = arith.constant -1 : i64
+  %device = util.global.load @device : !hal.device
+  %executable = util.global.load @executable : !hal.executable
+  %pipeline_layout = util.global.load @pipeline_layout : !hal.pipeline_layout
+  // CHECK: hal.command_buffer.create
+  %cmd = hal.command_buffer.create device(%device : !hal.device) mode("OneShot|AllowInlineExecution") categories("Transfer|Dispatch") : !hal.command_buffer
+  hal.command_buffer.push_descriptor_set<%cmd : !hal.command_buffer> layout(%pipeline_layout : !hal.pipeline_layout)[%c0] bindings([
+    %c0 = (%buffer : !hal.buffer)[%c0, %length]
+  ])
+  hal.command_buffer.dispatch<%cmd : !hal.command_buffer> target(%executable : !hal.executable)[%c0] workgroups([%c1, %c1, %c1])
+  // CHECK: hal.command_buffer.finalize
+  hal.command_buffer.finalize<%cmd : !hal.command_buffer>
+  // CHECK: hal.device.queue.execute<
+  hal.device.queue.execute<%device : !hal.device>
+      affinity(%affinity)
+      wait(%wait) signal(%signal)
+      commands([%cmd])
+  util.return
+}
+
+// CHECK-NOT: util.initializer
@@ -0,0 +1,80 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
+
+#include "iree/compiler/Tools/version.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/SHA256.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/Block.h"
+#include "mlir/Parser/Parser.h"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+std::string ExecutableCache::getKey(Operation *op, StringRef stage,
+                                    bool includeLocations) const {
+  std::string str;
+  llvm::raw_string_ostream os(str);
+  os << getIreeRevision() << "\n" << stage << "\n";
+  OpPrintingFlags flags;
+  flags.useLocalScope().enableDebugInfo(includeLocations);
+  op->print(os, flags);
+  llvm::SHA256 hasher;
+  hasher.update(os.str());
+  return llvm::toHex(hasher.result(), /*LowerCase=*/true);
+}
+
+std::string ExecutableCache::getEntryPath(StringRef key) const {
+  SmallString<256> entryPath(path);
+  llvm::sys::path::append(entryPath, key + ".mlir");
+  return entryPath.str().str();
+}
+
+bool ExecutableCache::load(StringRef key, Block &block,
+                           MLIRContext *context) const {
+  std::string entryPath = getEntryPath(key);
+  if (!llvm::sys::fs::exists(entryPath)) {
+    return false;
+  }
+  ParserConfig config(context);
+  return succeeded(parseSourceFile(entryPath, &block, config));
+}
+
+void ExecutableCache::store(StringRef key, ArrayRef<Operation *> ops) const {
+  if (llvm::sys::fs::create_directories(path)) {
+    return;
+  }
+
+  // Entries are written to a unique file first and renamed into place so that
+  // concurrent readers never observe partial entries.
+  std::string entryPath = getEntryPath(key);
+  int fd = 0;
+  SmallString<256> tempPath;
+  if (llvm::sys::fs::createUniqueFile(entryPath + ".%%%%%%%%", fd, tempPath)) {
+    return;
+  }
+  llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+  OpPrintingFlags flags;
+  flags.useLocalScope().printGenericOpForm().enableDebugInfo();
+  for (Operation *op : ops) {
+    op->print(os, flags);
+    os << "\n";
+  }
+  os.close();
+  if (os.has_error()) {
+    os.clear_error();
+    llvm::sys::fs::remove(tempPath);
+    return;
+  }
+  if (llvm::sys::fs::rename(tempPath, entryPath)) {
+    llvm::sys::fs::remove(tempPath);
+  }
+}
+
+} // namespace mlir::iree_compiler::IREE::HAL
@@ -0,0 +1,49 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_HAL_UTILS_EXECUTABLECACHE_H_
+#define IREE_COMPILER_DIALECT_HAL_UTILS_EXECUTABLECACHE_H_
+
+#include <string>
+
+#include "mlir/IR/Operation.h"
+
+namespace mlir::iree_compiler::IREE::HAL {
+
+// A content-addressed on-disk cache of executable compilation results.
+// Entries are keyed by the IR being compiled and the compiler revision and
+// hold the ops produced from it. Compiler flags are not part of the key and
+// the cache must be cleared when changing those affecting code generation.
+//
+// Entries are written atomically and the cache may be shared by concurrent
+// compilations.
+class ExecutableCache {
+public:
+  explicit ExecutableCache(StringRef path) : path(path) {}
+
+  // Returns the key for compiling |op| in |stage| (e.g. `serialize`).
+  // Locations are only included if |includeLocations| is set as they only
+  // matter when debug information is emitted.
+  std::string getKey(Operation *op, StringRef stage,
+                     bool includeLocations) const;
+
+  // Parses the ops stored under |key| into |block|.
+  // Returns false if the entry is missing or could not be parsed.
+  bool load(StringRef key, Block &block, MLIRContext *context) const;
+
+  // Stores |ops| under |key|. Failures are ignored as the cache is only an
+  // optimization.
+  void store(StringRef key, ArrayRef<Operation *> ops) const;
+
+private:
+  std::string getEntryPath(StringRef key) const;
+
+  std::string path;
+};
+
+} // namespace mlir::iree_compiler::IREE::HAL
+
+#endif // IREE_COMPILER_DIALECT_HAL_UTILS_EXECUTABLECACHE_H_
@@ -0,0 +1,145 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <gtest/gtest.h>
+
+#include "iree/compiler/Dialect/HAL/Utils/ExecutableCache.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/Block.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/IR/MLIRContext.h"
+#include "mlir/IR/OwningOpRef.h"
+#include "mlir/Parser/Parser.h"
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
+
+namespace mlir::iree_compiler::IREE::HAL {
+namespace {
+
+class ExecutableCacheTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    ASSERT_FALSE(
+        llvm::sys::fs::createUniqueDirectory("executable-cache", tempPath));
+    // The cache directory is created on the first store.
+    cachePath = tempPath;
+    llvm::sys::path::append(cachePath, "cache");
+  }
+
+  void TearDown() override { llvm::sys::fs::remove_directories(tempPath); }
+
+  OwningOpRef<ModuleOp> parse(StringRef source) {
+    return parseSourceString<ModuleOp>(source, &context);
+  }
+
+  // Prints |op| without locations for comparison.
+  static std::string print(Operation *op) {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    op->print(os, OpPrintingFlags().printGenericOpForm());
+    return os.str();
+  }
+
+  // Returns the names of all files in the cache directory.
+  std::vector<std::string> listCacheFiles() {
+    std::vector<std::string> names;
+    std::error_code ec;
+    for (llvm::sys::fs::directory_iterator it(cachePath, ec), end;
+         it != end && !ec; it.increment(ec)) {
+      names.push_back(llvm::sys::path::filename(it->path()).str());
+    }
+    return names;
+  }
+
+  MLIRContext context;
+  SmallString<128> tempPath;
+  SmallString<128> cachePath;
+};
+
+TEST_F(ExecutableCacheTest, KeyDependsOnContentsAndStage) {
+  auto a = parse("module attributes {test.value = 1 : i32} {}");
+  auto b = parse("module attributes {test.value = 2 : i32} {}");
+  ASSERT_TRUE(a && b);
+  ExecutableCache cache(cachePath);
+  std::string key = cache.getKey(*a, "translate", /*includeLocations=*/false);
+  EXPECT_EQ(key.size(), 64u);
+  EXPECT_EQ(key, cache.getKey(*a, "translate", /*includeLocations=*/false));
+  EXPECT_NE(key, cache.getKey(*b, "translate", /*includeLocations=*/false));
+  EXPECT_NE(key, cache.getKey(*a, "serialize-0", /*includeLocations=*/false));
+}
+
+TEST_F(ExecutableCacheTest, KeyOnlyIncludesLocationsWhenRequested) {
+  auto a = parse(R"(module {} loc("a.mlir":1:1))");
+  auto b = parse(R"(module {} loc("b.mlir":1:1))");
+  ASSERT_TRUE(a && b);
+  ExecutableCache cache(cachePath);
+  EXPECT_EQ(cache.getKey(*a, "translate", /*includeLocations=*/false),
+            cache.getKey(*b, "translate", /*includeLocations=*/false));
+  EXPECT_NE(cache.getKey(*a, "translate", /*includeLocations=*/true),
+            cache.getKey(*b, "translate", /*includeLocations=*/true));
+}
+
+TEST_F(ExecutableCacheTest, StoreAndLoad) {
+  auto a = parse(R"(module attributes {test.value = 1 : i32} {} loc("a"))");
+  auto b = parse(R"(module attributes {test.value = 2 : i32} {} loc("b"))");
+  ASSERT_TRUE(a && b);
+  ExecutableCache cache(cachePath);
+  std::string key = cache.getKey(*a, "serialize-0", /*includeLocations=*/false);
+  cache.store(key, {a->getOperation(), b->getOperation()});
+
+  // Entries are renamed into place so no temporary files remain.
+  std::vector<std::string> files = listCacheFiles();
+  ASSERT_EQ(files.size(), 1u);
+  EXPECT_EQ(files[0], key + ".mlir");
+
+  Block block;
+  ASSERT_TRUE(cache.load(key, block, &context));
+  ASSERT_EQ(block.getOperations().size(), 2u);
+  EXPECT_EQ(print(&block.front()), print(*a));
+  EXPECT_EQ(print(&block.back()), print(*b));
+  // Locations are preserved for debug information.
+  EXPECT_EQ(block.front().getLoc(), a->getLoc());
+  EXPECT_EQ(block.back().getLoc(), b->getLoc());
+}
+
+TEST_F(ExecutableCacheTest, LoadMissingEntry) {
+  ExecutableCache cache(cachePath);
+  Block block;
+  EXPECT_FALSE(cache.load("0123456789abcdef", block, &context));
+  EXPECT_TRUE(block.empty());
+}
+
+TEST_F(ExecutableCacheTest, LoadCorruptEntry) {
+  auto a = parse("module {}");
+  ASSERT_TRUE(a);
+  ExecutableCache cache(cachePath);
+  std::string key = cache.getKey(*a, "translate", /*includeLocations=*/false);
+  cache.store(key, {a->getOperation()});
+
+  SmallString<128> entryPath(cachePath);
+  llvm::sys::path::append(entryPath, key + ".mlir");
+  {
+    std::error_code ec;
+    llvm::raw_fd_ostream os(entryPath, ec);
+    ASSERT_FALSE(ec);
+    os << "module {";
+  }
+
+  // Corrupt entries are treated as misses.
+  ScopedDiagnosticHandler diagnosticHandler(
+      &context, [](Diagnostic &) { return success(); });
+  Block block;
+  EXPECT_FALSE(cache.load(key, block, &context));
+}
+
+} // namespace
+} // namespace mlir::iree_compiler::IREE::HAL
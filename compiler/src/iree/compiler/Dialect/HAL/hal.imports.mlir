@@ -302,6 +302,25 @@ vm.import private @command_buffer.dispatch.indirect(
   %workgroups_offset : i64
 )
 
+// Pushes constants and a descriptor set and dispatches an execution request.
+// Equivalent to push_constants (at offset 0), push_descriptor_set, and dispatch
+// but in a single call. Either the constants or bindings may be empty to skip
+// updating the respective state.
+vm.import private @command_buffer.dispatch.packed(
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  %pipeline_layout : !vm.ref<!hal.pipeline_layout>,
+  %executable : !vm.ref<!hal.executable>,
+  %entry_point : i32,
+  %workgroup_x : i32,
+  %workgroup_y : i32,
+  %workgroup_z : i32,
+  %constants : i32 ...,
+  %set : i32,
+  // <binding, slot, buffer, offset, length>
+  %bindings : tuple<i32, i32, !vm.ref<!hal.buffer>, i64, i64>...
+)
+attributes {minimum_version = 4 : i32}
+
 // Executes a secondary command buffer with the given binding table.
 vm.import private @command_buffer.execute.commands(
   %command_buffer : !vm.ref<!hal.command_buffer>,
@@ -407,6 +426,21 @@ vm.import private @device.queue.execute(
   %command_buffers : !vm.ref<!hal.command_buffer>...
 )
 
+// Executes a reusable command buffer on a device queue using the given binding
+// table to resolve indirect bindings recorded as table slots.
+// No commands will execute until the wait fence has been reached and the signal
+// fence will be signaled when all commands have completed.
+vm.import private @device.queue.execute.indirect(
+  %device : !vm.ref<!hal.device>,
+  %queue_affinity : i64,
+  %wait_fence : !vm.ref<!hal.fence>,
+  %signal_fence : !vm.ref<!hal.fence>,
+  %command_buffer : !vm.ref<!hal.command_buffer>,
+  // <buffer, offset, length>
+  %bindings : tuple<!vm.ref<!hal.buffer>, i64, i64>...
+)
+attributes {minimum_version = 3 : i32}
+
 // Flushes any locally-pending submissions in the queue.
 // When submitting many queue operations this can be used to eagerly flush
 // earlier submissions while later ones are still being constructed.
@@ -40,10 +40,6 @@ static bool hasAllOneValues(DenseIntElementsAttr attr) {
   return llvm::all_of(attr, [](APInt element) { return element.isOne(); });
 }
 
-// TODO: Make this a user-settable parameter once we have support
-// for more tile sizes
-static constexpr int64_t outputTileSize = 6;
-
 template <typename T>
 static bool hasValidStridesAndDilations(Operation *op) {
   auto convOp = dyn_cast<T>(op);
@@ -160,7 +156,8 @@ namespace {
 template <typename ConvOp>
 class ConvertConvToWinograd final : public OpRewritePattern<ConvOp> {
 public:
-  using OpRewritePattern<ConvOp>::OpRewritePattern;
+  ConvertConvToWinograd(MLIRContext *context, int64_t outputTileSize)
+      : OpRewritePattern<ConvOp>(context), outputTileSize(outputTileSize) {}
 
   LogicalResult matchAndRewrite(ConvOp convOp,
                                 PatternRewriter &rewriter) const override {
@@ -334,6 +331,9 @@ public:
     rewriter.replaceOp(convOp, winogradOutput);
     return success();
   }
+
+private:
+  int64_t outputTileSize;
 };
 
 struct ConvertConv2DToWinogradPass
@@ -344,9 +344,16 @@ struct ConvertConv2DToWinogradPass
   }
   void runOnOperation() override {
     MLIRContext *context = &getContext();
+    // Only F(4, 3) and F(6, 3) have constant matrices to decompose into.
+    if (outputTileSize != 4 && outputTileSize != 6) {
+      getOperation()->emitError("unsupported Winograd output tile size ")
+          << outputTileSize;
+      return signalPassFailure();
+    }
     RewritePatternSet patterns(&getContext());
     patterns.insert<ConvertConvToWinograd<linalg::Conv2DNhwcHwcfOp>,
-                    ConvertConvToWinograd<linalg::Conv2DNchwFchwOp>>(context);
+                    ConvertConvToWinograd<linalg::Conv2DNchwFchwOp>>(
+        context, outputTileSize);
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
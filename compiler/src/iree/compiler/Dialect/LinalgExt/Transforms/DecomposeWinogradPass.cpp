@@ -26,6 +26,35 @@
 namespace mlir::iree_compiler::IREE::LinalgExt {
 namespace {
 
+/// Constant matrices of one Winograd variant, stored as in
+/// WinogradConstants.h.
+struct WinogradMatrices {
+  const float *G, *GT;
+  const float *B, *BT;
+  const float *A, *AT;
+};
+
+/// Returns the constant matrices for F(outputTileSize, kernelSize), or
+/// std::nullopt if there are none for these sizes.
+static std::optional<WinogradMatrices>
+getWinogradMatrices(int64_t outputTileSize, int64_t kernelSize) {
+  if (kernelSize != 3) {
+    return std::nullopt;
+  }
+  switch (outputTileSize) {
+  case 4:
+    return WinogradMatrices{Winograd::G_4x4_3x3, Winograd::GT_4x4_3x3,
+                            Winograd::B_4x4_3x3, Winograd::BT_4x4_3x3,
+                            Winograd::A_4x4_3x3, Winograd::AT_4x4_3x3};
+  case 6:
+    return WinogradMatrices{Winograd::G_6x6_3x3, Winograd::GT_6x6_3x3,
+                            Winograd::B_6x6_3x3, Winograd::BT_6x6_3x3,
+                            Winograd::A_6x6_3x3, Winograd::AT_6x6_3x3};
+  default:
+    return std::nullopt;
+  }
+}
+
 /// Pattern to remove unit dims from winograd ops after tililng. Tiling is
 /// expected to tile most dimensions to 1, so the winograd op is only a small
 /// tile of rank 2 for decomposition.
@@ -123,6 +152,12 @@ struct DecomposeWinogradFilterTransform
     }
     const int64_t inputTileSize = transformOp.getInputTileSize();
     const int64_t kernelSize = transformOp.getKernelSize();
+    std::optional<WinogradMatrices> matrices =
+        getWinogradMatrices(transformOp.getOutputTileSize(), kernelSize);
+    if (!matrices) {
+      return rewriter.notifyMatchFailure(transformOp,
+                                         "unsupported Winograd tile size");
+    }
     ArrayRef<int64_t> kernelDims = transformOp.getKernelDimensions();
     llvm::SmallSetVector<int64_t, 2> kernelDimsSet(kernelDims.begin(),
                                                    kernelDims.end());
@@ -133,11 +168,9 @@ struct DecomposeWinogradFilterTransform
     /// and G [G] constant matrices that convert the filter
     /// tile from the original domain to the Winograd domain.
     Value GT = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::GT_6x6_3x3, kernelSize, inputTileSize, loc,
-        rewriter);
+        matrices->GT, kernelSize, inputTileSize, loc, rewriter);
     Value G = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::G_6x6_3x3, inputTileSize, kernelSize, loc,
-        rewriter);
+        matrices->G, inputTileSize, kernelSize, loc, rewriter);
 
     // Create matmul(input, GT)
     SmallVector<int64_t> initShape(kernelDims.size(), inputTileSize);
@@ -207,12 +240,16 @@ struct DecomposeWinogradInputTransform
     /// tile from the original domain to the Winograd domain.
     Location loc = transformOp.getLoc();
     const int64_t inputTileSize = transformOp.getInputTileSize();
+    std::optional<WinogradMatrices> matrices = getWinogradMatrices(
+        transformOp.getOutputTileSize(), transformOp.getKernelSize());
+    if (!matrices) {
+      return rewriter.notifyMatchFailure(transformOp,
+                                         "unsupported Winograd tile size");
+    }
     Value BT = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::BT_6x6_3x3, inputTileSize, inputTileSize,
-        loc, rewriter);
+        matrices->BT, inputTileSize, inputTileSize, loc, rewriter);
     Value B = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::B_6x6_3x3, inputTileSize, inputTileSize, loc,
-        rewriter);
+        matrices->B, inputTileSize, inputTileSize, loc, rewriter);
 
     // Pad the input slice.
     Value dynamicSlice = transformOp.getInput();
@@ -291,15 +328,19 @@ struct DecomposeWinogradOutputTransform
     Type elementType = outputType.getElementType();
     const int64_t inputTileSize = transformOp.getInputTileSize();
     const int64_t outputTileSize = transformOp.getOutputTileSize();
+    std::optional<WinogradMatrices> matrices =
+        getWinogradMatrices(outputTileSize, transformOp.getKernelSize());
+    if (!matrices) {
+      return rewriter.notifyMatchFailure(transformOp,
+                                         "unsupported Winograd tile size");
+    }
     /// The two values below are the transpose(A) [AT]
     /// and A [A] constant matrices that convert the output
     /// tile from the Winograd domain to the original domain.
     Value AT = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::AT_6x6_3x3, outputTileSize, inputTileSize,
-        loc, rewriter);
+        matrices->AT, outputTileSize, inputTileSize, loc, rewriter);
     Value A = IREE::LinalgExt::createValueFrom2DConstant(
-        IREE::LinalgExt::Winograd::A_6x6_3x3, inputTileSize, outputTileSize,
-        loc, rewriter);
+        matrices->A, inputTileSize, outputTileSize, loc, rewriter);
     Value zeroF32 = rewriter.create<arith::ConstantOp>(
         loc, rewriter.getZeroAttr(elementType));
     SmallVector<int64_t> scratchShape = {inputTileSize, outputTileSize};
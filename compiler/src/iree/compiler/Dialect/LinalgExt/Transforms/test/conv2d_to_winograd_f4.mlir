@@ -0,0 +1,32 @@
+// RUN: iree-opt --split-input-file --iree-linalg-ext-convert-conv2d-to-winograd="output-tile-size=4" -mlir-elide-elementsattrs-if-larger=4 %s | FileCheck %s
+
+func.func @conv_16433136_f16(%arg0: tensor<1x16x16x4xf16>, %arg1: tensor<3x3x4x16xf16>, %arg2: tensor<1x14x14x16xf16>) -> tensor<1x14x14x16xf16> {
+  %0 = linalg.conv_2d_nhwc_hwcf
+    {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64> }
+     ins(%arg0, %arg1: tensor<1x16x16x4xf16>, tensor<3x3x4x16xf16>)
+    outs(%arg2: tensor<1x14x14x16xf16>) -> tensor<1x14x14x16xf16>
+  return %0 : tensor<1x14x14x16xf16>
+}
+// CHECK:      func.func @conv_16433136_f16(
+// CHECK-SAME:   %[[ARG0:[a-zA-Z0-9_]+]]: tensor<1x16x16x4xf16>
+// CHECK-SAME:   %[[ARG1:[a-zA-Z0-9_]+]]: tensor<3x3x4x16xf16>
+// CHECK:        %[[FILTER_TF:.+]] = iree_linalg_ext.winograd.filter_transform output_tile_size(4) kernel_size(3)
+// CHECK-SAME:     kernel_dimensions([0, 1]) ins(%[[ARG1]] : tensor<3x3x4x16xf16>)
+// CHECK-SAME:     -> tensor<6x6x4x16xf16>
+// CHECK:        %[[COLLAPSED_FILTER:.+]] = tensor.collapse_shape %[[FILTER_TF]]
+// CHECK-SAME:           tensor<6x6x4x16xf16> into tensor<36x4x16xf16>
+// CHECK:        %[[INPUT_TF:.+]] = iree_linalg_ext.winograd.input_transform output_tile_size(4) kernel_size(3)
+// CHECK-SAME:     image_dimensions([1, 2]) ins(%[[ARG0]] : tensor<1x16x16x4xf16>)
+// CHECK-SAME:     -> tensor<6x6x1x4x4x4xf16>
+// CHECK:        %[[COLLAPSED_INPUT:.+]] = tensor.collapse_shape %[[INPUT_TF]]
+// CHECK-SAME:           tensor<6x6x1x4x4x4xf16> into tensor<36x16x4xf16>
+// CHECK:        %[[BMM:.+]] = linalg.batch_matmul ins(%[[COLLAPSED_INPUT]], %[[COLLAPSED_FILTER]] : tensor<36x16x4xf16>,
+// CHECK-SAME:     tensor<36x4x16xf16>) {{.*}} -> tensor<36x16x16xf16>
+// CHECK:        %[[EXPANDED:.+]] = tensor.expand_shape %[[BMM]]
+// CHECK-SAME:          tensor<36x16x16xf16> into tensor<6x6x1x4x4x16xf16>
+// CHECK:        %[[OUTPUT_TF:.+]] = iree_linalg_ext.winograd.output_transform output_tile_size(4) kernel_size(3)
+// CHECK-SAME:     image_dimensions([1, 2]) ins(%[[EXPANDED]] : tensor<6x6x1x4x4x16xf16>)
+// CHECK-SAME:     -> tensor<1x16x16x16xf16>
+// CHECK:        %[[EXTRACTED_SLICE:.+]] = tensor.extract_slice %[[OUTPUT_TF]][0, 0, 0, 0] [1, 14, 14, 16] [1, 1, 1, 1] :
+// CHECK-SAME:     tensor<1x16x16x16xf16> to tensor<1x14x14x16xf16>
+// CHECK:        return %[[EXTRACTED_SLICE]] : tensor<1x14x14x16xf16>
@@ -203,3 +203,21 @@ module {
 // CHECK:        %[[INSERTED_SLICE_0:.+]] = tensor.insert_slice %[[MATMUL_1]] into %[[OUTPUT_TILE]]
 // CHECK:        %[[INSERTED_SLICE_1:.+]] = tensor.insert_slice %[[INSERTED_SLICE_0]] into %[[ARG1]]
 // CHECK:        return %[[INSERTED_SLICE_1]] : tensor<1x32x36x36xf16>
+
+// -----
+
+module {
+  func.func @winograd_filter_transform_f4(%arg0: tensor<3x3x64x128xf32>, %arg1: tensor<6x6x64x128xf32>) -> tensor<6x6x64x128xf32> {
+    %extracted_slice = tensor.extract_slice %arg0[0, 0, 0, 0] [3, 3, 1, 1] [1, 1, 1, 1] : tensor<3x3x64x128xf32> to tensor<3x3x1x1xf32>
+    %extracted_slice_0 = tensor.extract_slice %arg1[0, 0, 0, 0] [6, 6, 1, 1] [1, 1, 1, 1] : tensor<6x6x64x128xf32> to tensor<6x6x1x1xf32>
+    %14 = iree_linalg_ext.winograd.filter_transform output_tile_size(4) kernel_size(3) kernel_dimensions([0, 1]) ins(%extracted_slice : tensor<3x3x1x1xf32>) outs(%extracted_slice_0 : tensor<6x6x1x1xf32>) -> tensor<6x6x1x1xf32>
+    %inserted_slice = tensor.insert_slice %14 into %arg1[0, 0, 0, 0] [6, 6, 1, 1] [1, 1, 1, 1] : tensor<6x6x1x1xf32> into tensor<6x6x64x128xf32>
+    return %inserted_slice : tensor<6x6x64x128xf32>
+  }
+}
+// CHECK:      func.func @winograd_filter_transform_f4(
+// CHECK-DAG:    %[[GT:.+]] = arith.constant dense<{{\[\[}}2.500000e-01, -0.166666672,{{.*}} : tensor<3x6xf32>
+// CHECK-DAG:    %[[G:.+]] = arith.constant dense<{{\[\[}}2.500000e-01, 0.000000e+00,{{.*}} : tensor<6x3xf32>
+// CHECK:        %[[MATMUL_0:.+]] = linalg.matmul ins(%{{.+}}, %[[GT]]
+// CHECK:        %[[MATMUL_1:.+]] = linalg.matmul ins(%[[G]], %[[MATMUL_0]]
+// CHECK-SAME:     -> tensor<6x6xf32>
@@ -12,6 +12,71 @@ namespace mlir::iree_compiler::IREE::LinalgExt::Winograd {
 // This file contains the Winograd constant matrices for different
 // output tile sizes
 
+//===----------------------------------------------------------------------===//
+// Output tile size = 4, Kernel size = 3
+//===----------------------------------------------------------------------===//
+// These constants were obtained from this paper:
+//
+// Lavin, A. and Gray, S. (2016) Fast Algorithms for Convolutional Neural
+// Networks. https://arxiv.org/abs/1509.09308
+//
+// The smaller tile trades some of the arithmetic savings of F(6, 3) for better
+// numerical accuracy, which matters most for f16 convolutions.
+//
+
+// clang-format off
+
+const float BT_4x4_3x3[] = {
+  4.0f,  0.0f, -5.0f,  0.0f, 1.0f, 0.0f,
+  0.0f, -4.0f, -4.0f,  1.0f, 1.0f, 0.0f,
+  0.0f,  4.0f, -4.0f, -1.0f, 1.0f, 0.0f,
+  0.0f, -2.0f, -1.0f,  2.0f, 1.0f, 0.0f,
+  0.0f,  2.0f, -1.0f, -2.0f, 1.0f, 0.0f,
+  0.0f,  4.0f,  0.0f, -5.0f, 0.0f, 1.0f
+};
+
+const float B_4x4_3x3[] = {
+   4.0f,  0.0f,  0.0f,  0.0f,  0.0f,  0.0f,
+   0.0f, -4.0f,  4.0f, -2.0f,  2.0f,  4.0f,
+  -5.0f, -4.0f, -4.0f, -1.0f, -1.0f,  0.0f,
+   0.0f,  1.0f, -1.0f,  2.0f, -2.0f, -5.0f,
+   1.0f,  1.0f,  1.0f,  1.0f,  1.0f,  0.0f,
+   0.0f,  0.0f,  0.0f,  0.0f,  0.0f,  1.0f
+};
+
+const float GT_4x4_3x3[] = {
+  1.0f/4.0f, -1.0f/6.0f, -1.0f/6.0f, 1.0f/24.0f,  1.0f/24.0f, 0.0f,
+       0.0f, -1.0f/6.0f,  1.0f/6.0f, 1.0f/12.0f, -1.0f/12.0f, 0.0f,
+       0.0f, -1.0f/6.0f, -1.0f/6.0f,  1.0f/6.0f,   1.0f/6.0f, 1.0f
+};
+
+const float G_4x4_3x3[] = {
+   1.0f/4.0f,        0.0f,       0.0f,
+  -1.0f/6.0f,  -1.0f/6.0f, -1.0f/6.0f,
+  -1.0f/6.0f,   1.0f/6.0f, -1.0f/6.0f,
+  1.0f/24.0f,  1.0f/12.0f,  1.0f/6.0f,
+  1.0f/24.0f, -1.0f/12.0f,  1.0f/6.0f,
+        0.0f,        0.0f,       1.0f
+};
+
+const float AT_4x4_3x3[] = {
+  1.0f, 1.0f,  1.0f, 1.0f,  1.0f, 0.0f,
+  0.0f, 1.0f, -1.0f, 2.0f, -2.0f, 0.0f,
+  0.0f, 1.0f,  1.0f, 4.0f,  4.0f, 0.0f,
+  0.0f, 1.0f, -1.0f, 8.0f, -8.0f, 1.0f
+};
+
+const float A_4x4_3x3[] = {
+  1.0f,  0.0f, 0.0f,  0.0f,
+  1.0f,  1.0f, 1.0f,  1.0f,
+  1.0f, -1.0f, 1.0f, -1.0f,
+  1.0f,  2.0f, 4.0f,  8.0f,
+  1.0f, -2.0f, 4.0f, -8.0f,
+  0.0f,  0.0f, 0.0f,  1.0f
+};
+
+// clang-format on
+
 //===----------------------------------------------------------------------===//
 // Output tile size = 6, Kernel size = 3
 //===----------------------------------------------------------------------===//
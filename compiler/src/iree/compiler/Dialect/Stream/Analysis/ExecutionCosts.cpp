@@ -0,0 +1,207 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/Analysis/ExecutionCosts.h"
+
+#include <mutex>
+#include <string>
+
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "llvm/ADT/SmallVector.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/JSON.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/SymbolTable.h"
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+static llvm::cl::opt<std::string> clCostProfile(
+    "iree-stream-cost-profile",
+    llvm::cl::desc("Path to a JSON file of measured execution costs of "
+                   "executable exports used when scheduling concurrency."),
+    llvm::cl::init(""));
+
+//===----------------------------------------------------------------------===//
+// Cost attributes
+//===----------------------------------------------------------------------===//
+
+static std::optional<double> getNumber(Attribute attr) {
+  if (auto floatAttr = dyn_cast_if_present<FloatAttr>(attr)) {
+    return floatAttr.getValueAsDouble();
+  } else if (auto integerAttr = dyn_cast_if_present<IntegerAttr>(attr)) {
+    return static_cast<double>(integerAttr.getInt());
+  }
+  return std::nullopt;
+}
+
+// Returns the cost in the `stream.cost` attribute of |op|, if any.
+static std::optional<ExecutionCost> getCostAttr(Operation *op) {
+  auto costAttr = op->getAttrOfType<DictionaryAttr>("stream.cost");
+  if (!costAttr) {
+    return std::nullopt;
+  }
+  auto compute = getNumber(costAttr.get("compute"));
+  auto memory = getNumber(costAttr.get("memory"));
+  if (!compute && !memory) {
+    return std::nullopt;
+  }
+  ExecutionCost cost;
+  cost.compute = compute.value_or(0.0);
+  cost.memory = memory.value_or(0.0);
+  return cost;
+}
+
+//===----------------------------------------------------------------------===//
+// Cost profiles
+//===----------------------------------------------------------------------===//
+
+struct CostProfile {
+  llvm::StringMap<ExecutionCost> costs;
+  // Set if the profile could not be used. Parsing happens outside of any pass
+  // so the error is reported by the first op that would have consulted it.
+  std::string error;
+};
+
+static CostProfile makeInvalidCostProfile(const Twine &message) {
+  CostProfile profile;
+  profile.error = message.str();
+  return profile;
+}
+
+static CostProfile parseCostProfile(StringRef path) {
+  auto fileOrErr = llvm::MemoryBuffer::getFile(path);
+  if (!fileOrErr) {
+    return makeInvalidCostProfile(fileOrErr.getError().message());
+  }
+  llvm::Expected<llvm::json::Value> json =
+      llvm::json::parse((*fileOrErr)->getBuffer());
+  if (!json) {
+    return makeInvalidCostProfile(llvm::toString(json.takeError()));
+  }
+  const llvm::json::Object *root = json->getAsObject();
+  if (!root || root->getInteger("version") != 1) {
+    return makeInvalidCostProfile("expected an object with \"version\": 1");
+  }
+  const llvm::json::Object *exports = root->getObject("exports");
+  if (!exports) {
+    return makeInvalidCostProfile("expected an \"exports\" object");
+  }
+  CostProfile profile;
+  struct MeasuredEntry {
+    std::string name;
+    double duration;
+    double bytes;
+  };
+  SmallVector<MeasuredEntry> measuredEntries;
+  for (const auto &[name, value] : *exports) {
+    const llvm::json::Object *entry = value.getAsObject();
+    if (!entry) {
+      return makeInvalidCostProfile("malformed entry for " + name.str());
+    }
+    std::optional<double> compute = entry->getNumber("compute");
+    std::optional<double> memory = entry->getNumber("memory");
+    if (compute || memory) {
+      ExecutionCost cost;
+      cost.compute = compute.value_or(0.0);
+      cost.memory = memory.value_or(0.0);
+      profile.costs[name.str()] = cost;
+      continue;
+    }
+    std::optional<double> duration = entry->getNumber("duration_ns");
+    if (!duration) {
+      return makeInvalidCostProfile("malformed entry for " + name.str());
+    }
+    measuredEntries.push_back(
+        {name.str(), *duration, entry->getNumber("bytes").value_or(0.0)});
+  }
+
+  // Measured entries only know how long a dispatch took and how many bytes it
+  // accessed. We assume the dispatch with the highest bandwidth was limited by
+  // memory and split the duration of the others into the time needed to move
+  // their bytes at that bandwidth and the remainder spent computing.
+  double peakBandwidth = 0.0;
+  for (auto &entry : measuredEntries) {
+    if (entry.duration > 0.0) {
+      peakBandwidth = std::max(peakBandwidth, entry.bytes / entry.duration);
+    }
+  }
+  for (auto &entry : measuredEntries) {
+    ExecutionCost cost;
+    cost.memory = peakBandwidth > 0.0
+                      ? std::min(entry.bytes / peakBandwidth, entry.duration)
+                      : 0.0;
+    cost.compute = std::max(entry.duration - cost.memory, 0.0);
+    profile.costs[entry.name] = cost;
+  }
+  return profile;
+}
+
+// Returns the profile at |path|, parsing it on first use. The cache is keyed
+// on the path as the flag may change between compilations in one process.
+static const CostProfile &getCostProfile(StringRef path) {
+  static std::mutex mutex;
+  static llvm::StringMap<CostProfile> cache;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto [it, inserted] = cache.try_emplace(path);
+  if (inserted) {
+    it->second = parseCostProfile(path);
+  }
+  return it->second;
+}
+
+//===----------------------------------------------------------------------===//
+// ExecutionCostModel
+//===----------------------------------------------------------------------===//
+
+std::optional<ExecutionCost> ExecutionCostModel::estimate(Operation *op) {
+  if (auto cost = getCostAttr(op)) {
+    return cost;
+  }
+  auto dispatchOp = dyn_cast<IREE::Stream::AsyncDispatchOp>(op);
+  if (!dispatchOp) {
+    return std::nullopt;
+  }
+
+  // Only one of the entry points runs on any given device so use the most
+  // expensive one we know about.
+  std::optional<ExecutionCost> dispatchCost;
+  auto updateCost = [&](const ExecutionCost &cost) {
+    if (!dispatchCost || dispatchCost->getTime() < cost.getTime()) {
+      dispatchCost = cost;
+    }
+  };
+  const CostProfile *profile =
+      clCostProfile.empty() ? nullptr : &getCostProfile(clCostProfile);
+  if (profile && !profile->error.empty()) {
+    if (!reportedInvalidProfile) {
+      op->emitWarning() << "ignoring stream cost profile '" << clCostProfile
+                        << "': " << profile->error;
+      reportedInvalidProfile = true;
+    }
+    profile = nullptr;
+  }
+  dispatchOp.forEachEntryPointAttr([&](SymbolRefAttr entryPointAttr) {
+    if (auto *exportOp =
+            SymbolTable::lookupNearestSymbolFrom(op, entryPointAttr)) {
+      if (auto cost = getCostAttr(exportOp)) {
+        updateCost(*cost);
+        return;
+      }
+    }
+    if (profile) {
+      auto it =
+          profile->costs.find(entryPointAttr.getLeafReference().getValue());
+      if (it != profile->costs.end()) {
+        updateCost(it->second);
+      }
+    }
+  });
+  return dispatchCost;
+}
+
+} // namespace mlir::iree_compiler::IREE::Stream
@@ -0,0 +1,74 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_DIALECT_STREAM_ANALYSIS_EXECUTION_COSTS_H_
+#define IREE_COMPILER_DIALECT_STREAM_ANALYSIS_EXECUTION_COSTS_H_
+
+#include <algorithm>
+#include <optional>
+
+#include "mlir/IR/Operation.h"
+#include "mlir/Support/LLVM.h"
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+//===----------------------------------------------------------------------===//
+// Execution cost model
+//===----------------------------------------------------------------------===//
+
+// Estimated cost of executing an op split into the time it keeps compute units
+// busy and the time it keeps memory busy. Units are arbitrary (nanoseconds are
+// a good choice) but must be the same for all estimates used together.
+//
+// Ops executing concurrently share both the compute units and the memory
+// bandwidth of a device so a set of concurrent ops is modeled as taking the
+// larger of their summed compute time and their summed memory time.
+struct ExecutionCost {
+  double compute = 0.0;
+  double memory = 0.0;
+
+  // Returns the modeled time of executing with the given cost.
+  double getTime() const { return std::max(compute, memory); }
+
+  ExecutionCost &operator+=(const ExecutionCost &rhs) {
+    compute += rhs.compute;
+    memory += rhs.memory;
+    return *this;
+  }
+};
+
+// Estimates the execution cost of stream ops for scheduling.
+//
+// The default implementation uses, in order of precedence:
+//   * a `stream.cost = {compute = N, memory = M}` attribute on the op;
+//   * the same attribute on the executable export a dispatch references, as
+//     can be attached by earlier analysis of the dispatch;
+//   * the profile given by --iree-stream-cost-profile=, a JSON file of the
+//     form `{"version": 1, "exports": {"name": {"compute": N, "memory": M}}}`
+//     keyed by the name of the executable export. Entries may instead hold
+//     the `"duration_ns"` and `"bytes"` measured by the runtime (as written
+//     by the local-sync HAL device when profiling dispatches) in which case
+//     the duration is split into compute and memory time based on the
+//     highest bandwidth any export in the profile achieved. A profile that
+//     cannot be parsed is ignored with a warning on the first dispatch that
+//     would have used it.
+// Subclasses may override estimate() to provide their own costs.
+class ExecutionCostModel {
+public:
+  virtual ~ExecutionCostModel() = default;
+
+  // Returns the estimated cost of |op| or std::nullopt if unknown.
+  virtual std::optional<ExecutionCost> estimate(Operation *op);
+
+private:
+  // Set once a warning about an unusable cost profile has been emitted so
+  // that it is reported once per model instead of once per dispatch.
+  bool reportedInvalidProfile = false;
+};
+
+} // namespace mlir::iree_compiler::IREE::Stream
+
+#endif // IREE_COMPILER_DIALECT_STREAM_ANALYSIS_EXECUTION_COSTS_H_
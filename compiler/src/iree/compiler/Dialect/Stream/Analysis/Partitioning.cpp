@@ -174,9 +174,9 @@ PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
 
 PartitionSet
 partitionRegionConcurrency(IREE::Stream::PartitioningConfigAttr config,
-                           Block *block) {
+                           Block *block, ExecutionCostModel *costModel) {
   // Only one algorithm today.
-  return partitionRegionConcurrencyReference(config, block);
+  return partitionRegionConcurrencyReference(config, block, costModel);
 }
 
 } // namespace mlir::iree_compiler::IREE::Stream
@@ -13,6 +13,8 @@
 
 namespace mlir::iree_compiler::IREE::Stream {
 
+class ExecutionCostModel;
+
 //===----------------------------------------------------------------------===//
 // Data structures
 //===----------------------------------------------------------------------===//
@@ -105,9 +107,13 @@ struct PartitionSet {
 // ops in the block will be covered by a partition.
 PartitionSet partitionStreamableOps(IREE::Stream::PartitioningConfigAttr config,
                                     Block *block);
+// Partitions the ops in |block| into waves of concurrently executable work.
+// If |costModel| has estimates for the ops then they are used to balance the
+// compute and memory costs of each wave.
 PartitionSet
 partitionRegionConcurrency(IREE::Stream::PartitioningConfigAttr config,
-                           Block *block);
+                           Block *block,
+                           ExecutionCostModel *costModel = nullptr);
 
 //===----------------------------------------------------------------------===//
 // Reference partitioning
@@ -121,9 +127,12 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
 
 // Similarly poor algorithm to partitionStreamableOpsReference but for use
 // within partitioned streams to produce waves of concurrently executable work.
+// Among the waves an op can join it picks the one whose modeled time grows
+// the least under |costModel|, if any.
 PartitionSet
 partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
-                                    Block *block);
+                                    Block *block,
+                                    ExecutionCostModel *costModel = nullptr);
 
 } // namespace mlir::iree_compiler::IREE::Stream
 
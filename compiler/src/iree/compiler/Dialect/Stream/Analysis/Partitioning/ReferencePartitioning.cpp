@@ -4,6 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <limits>
+
+#include "iree/compiler/Dialect/Stream/Analysis/ExecutionCosts.h"
 #include "iree/compiler/Dialect/Stream/Analysis/Partitioning.h"
 #include "iree/compiler/Dialect/Stream/Analysis/ResourceHazards.h"
 #include "llvm/ADT/BitVector.h"
@@ -52,6 +55,8 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
     SetVector<Operation *> ops;
     // Ops that were cloned and are known not to have their values escape.
     DenseSet<Operation *> clonedOps;
+    // Isolated partitions that depend on the ops in this partition.
+    llvm::BitVector isolatedDependents;
     void insert(Operation *op) {
       if (auto affinityOp = dyn_cast<IREE::Stream::AffinityOpInterface>(op)) {
         affinity = affinity ? affinity.joinAND(affinityOp.getAffinity())
@@ -62,6 +67,7 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
   };
   SmallVector<std::unique_ptr<PartitionBuilder>> builders;
   llvm::BitVector usableBuilders;
+  llvm::BitVector isolatedBuilders;
 
   struct OpInfo {
     // Which partitions the op is contained within.
@@ -165,6 +171,40 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
       continue;
     }
 
+    // Collectives may be isolated in partitions of their own so that work
+    // independent of them can execute while communicating instead of waiting
+    // in the same execution region for the collective to complete. Frozen
+    // partitions depending on the collective can no longer be joined and ops
+    // only join partitions that the same isolated partitions depend on so that
+    // independent work neither delays nor waits on them.
+    bool isolateOp = config.getAsyncCollectives() &&
+                     isa<IREE::Stream::AsyncCollectiveOp>(op);
+    llvm::BitVector isolatedDependents = opInfo.hazards;
+    isolatedDependents &= isolatedBuilders;
+    if (isolateOp) {
+      LLVM_DEBUG(llvm::dbgs() << "Isolating collective\n");
+      usableBuilders.reset(opInfo.hazards);
+      candidates.reset();
+      consumers.reset();
+    } else if (isolatedBuilders.any()) {
+      // Allocations and cheap clonable ops may still go into the isolated
+      // partitions consuming them.
+      bool canJoinIsolated = isa<IREE::Stream::AsyncAllocaOp>(op) ||
+                             streamableOp.preferCloneToConsumers();
+      for (auto ordinal : candidates.set_bits()) {
+        bool isCompatible =
+            isolatedBuilders.test(ordinal)
+                ? canJoinIsolated && consumers.test(ordinal)
+                : llvm::equal(builders[ordinal]->isolatedDependents.set_bits(),
+                              isolatedDependents.set_bits());
+        if (!isCompatible) {
+          LLVM_DEBUG(llvm::dbgs() << "Candidate partition " << ordinal
+                                  << " incompatible with isolation\n");
+          candidates.reset(ordinal);
+        }
+      }
+    }
+
     // First see which partitions are consuming this that we can also safely
     // move in to.
     consumers &= candidates;
@@ -220,11 +260,13 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
     auto builder = std::make_unique<PartitionBuilder>();
     builder->ordinal = builders.size();
     builder->affinity = affinityAttr;
+    builder->isolatedDependents = isolatedDependents;
     builder->insert(&op);
     LLVM_DEBUG(llvm::dbgs()
                << "Created partition " << builder->ordinal << "\n");
     builders.push_back(std::move(builder));
     usableBuilders.resize(builders.size(), /*t=*/true);
+    isolatedBuilders.resize(builders.size(), /*t=*/isolateOp);
   }
 
   // Ops cloned into multiple partitions may still escape if there are
@@ -293,7 +335,8 @@ partitionStreamableOpsReference(IREE::Stream::PartitioningConfigAttr config,
 // dividing the block to identify both serial and concurrent regions.
 PartitionSet
 partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
-                                    Block *block) {
+                                    Block *block,
+                                    ExecutionCostModel *costModel) {
   PartitionSet waveSet;
 
   auto favor = config.getFavor().getValue();
@@ -306,9 +349,26 @@ partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
     unsigned ordinal;
     // Ops present in the wave; ops may be present in multiple waves.
     SetVector<Operation *> ops;
+    // Number of ops in the wave that execute work.
+    int64_t width = 0;
+    // Total estimated cost of the ops in the wave.
+    ExecutionCost cost;
   };
   SmallVector<std::unique_ptr<PartitionBuilder>> builders;
 
+  // Gather the cost estimates of the ops in the block. Waves are only
+  // balanced by cost if there's at least one estimate as otherwise all waves
+  // look the same.
+  DenseMap<Operation *, ExecutionCost> opCosts;
+  if (costModel) {
+    for (auto &op : *block) {
+      if (auto cost = costModel->estimate(&op)) {
+        opCosts[&op] = *cost;
+      }
+    }
+  }
+  int64_t maxWaveWidth = config.getMaxWaveWidth();
+
   struct OpInfo {
     // Which waves the op is contained within.
     llvm::BitVector membership;
@@ -436,6 +496,16 @@ partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
       continue;
     }
 
+    // Waves already running as many ops as the device can run concurrently
+    // can't take any more.
+    if (maxWaveWidth > 0) {
+      for (auto ordinal : candidates.set_bits()) {
+        if (builders[ordinal]->width >= maxWaveWidth) {
+          candidates.reset(ordinal);
+        }
+      }
+    }
+
     opInfo.membership.reserve(builders.size() + 1);
     opInfo.membership.resize(builders.size(), /*t=*/false);
 
@@ -443,10 +513,30 @@ partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
     int firstCandidateOrdinal = favor == IREE::Stream::Favor::MaxConcurrency
                                     ? candidates.find_first()
                                     : candidates.find_last();
+    auto opCost = opCosts.lookup(&op);
+    if (firstCandidateOrdinal != -1 && !opCosts.empty()) {
+      // Pick the wave whose modeled time grows the least by adding the op,
+      // such as a compute-bound wave for a memory-bound op. Ties go to the
+      // wave preferred by the favor as above.
+      bool preferFirst = favor == IREE::Stream::Favor::MaxConcurrency;
+      double bestGrowth = std::numeric_limits<double>::infinity();
+      for (auto ordinal : candidates.set_bits()) {
+        auto waveCost = builders[ordinal]->cost;
+        double oldTime = waveCost.getTime();
+        waveCost += opCost;
+        double growth = waveCost.getTime() - oldTime;
+        if (growth < bestGrowth || (!preferFirst && growth == bestGrowth)) {
+          bestGrowth = growth;
+          firstCandidateOrdinal = ordinal;
+        }
+      }
+    }
     if (firstCandidateOrdinal != -1) {
       LLVM_DEBUG(llvm::dbgs() << "Moving to last candidate wave "
                               << firstCandidateOrdinal << " (continue)\n");
       builders[firstCandidateOrdinal]->ops.insert(&op);
+      builders[firstCandidateOrdinal]->width += 1;
+      builders[firstCandidateOrdinal]->cost += opCost;
       opInfo.membership.set(firstCandidateOrdinal);
       opInfo.hazards.set(0, firstCandidateOrdinal);
       opInfo.hazards.reset(firstCandidateOrdinal);
@@ -461,6 +551,8 @@ partitionRegionConcurrencyReference(IREE::Stream::PartitioningConfigAttr config,
     auto builder = std::make_unique<PartitionBuilder>();
     builder->ordinal = builders.size();
     builder->ops.insert(&op);
+    builder->width = 1;
+    builder->cost = opCost;
     LLVM_DEBUG(llvm::dbgs() << "Created wave " << builder->ordinal << "\n");
     builders.push_back(std::move(builder));
   }
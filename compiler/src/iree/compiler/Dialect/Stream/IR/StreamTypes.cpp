@@ -36,6 +36,18 @@ static llvm::cl::opt<Favor> clPartitioningFavor(
                    "Favor maximizing concurrency at the cost of additional "
                    "memory consumption.")));
 
+static llvm::cl::opt<int64_t> clPartitioningMaxWaveWidth(
+    "iree-stream-partitioning-max-wave-width",
+    llvm::cl::desc("Default maximum number of ops scheduled to execute "
+                   "concurrently in one wave; 0 for unlimited."),
+    llvm::cl::init(0));
+
+static llvm::cl::opt<bool> clPartitioningAsyncCollectives(
+    "iree-stream-partitioning-async-collectives",
+    llvm::cl::desc("Places collectives in execution regions of their own so "
+                   "that independent work can overlap with communication."),
+    llvm::cl::init(false));
+
 // TODO(#8042): properly choose this value based on target devices. We don't
 // yet have the device information up in stream and thus for targets that have
 // high alignment requirements (128/256/etc) we are not picking the right
@@ -386,6 +398,16 @@ Attribute PartitioningConfigAttr::parse(AsmParser &p, Type type) {
   } else if (failed(p.parseString(&favorStr))) {
     return {};
   }
+  int64_t maxWaveWidth = 0;
+  bool asyncCollectives = false;
+  while (succeeded(p.parseOptionalComma())) {
+    if (succeeded(p.parseOptionalKeyword("async_collectives"))) {
+      asyncCollectives = true;
+    } else if (failed(p.parseKeyword("max_wave_width")) ||
+               failed(p.parseEqual()) || failed(p.parseInteger(maxWaveWidth))) {
+      return {};
+    }
+  }
   if (failed(p.parseGreater()))
     return {};
   auto favor = symbolizeFavor(favorStr);
@@ -394,13 +416,20 @@ Attribute PartitioningConfigAttr::parse(AsmParser &p, Type type) {
     return {};
   }
   return PartitioningConfigAttr::get(
-      FavorAttr::get(p.getContext(), favor.value()));
+      FavorAttr::get(p.getContext(), favor.value()), maxWaveWidth,
+      asyncCollectives);
 }
 
 void PartitioningConfigAttr::print(AsmPrinter &p) const {
   p << "<";
   p << "favor-";
   p << stringifyFavor(getFavor().getValue());
+  if (getMaxWaveWidth() > 0) {
+    p << ", max_wave_width = " << getMaxWaveWidth();
+  }
+  if (getAsyncCollectives()) {
+    p << ", async_collectives";
+  }
   p << ">";
 }
 
@@ -414,7 +443,8 @@ PartitioningConfigAttr PartitioningConfigAttr::lookup(Operation *op) {
   }
   // No config found; use defaults.
   auto favorAttr = FavorAttr::get(attrId.getContext(), clPartitioningFavor);
-  return PartitioningConfigAttr::get(favorAttr);
+  return PartitioningConfigAttr::get(favorAttr, clPartitioningMaxWaveWidth,
+                                     clPartitioningAsyncCollectives);
 }
 
 //===----------------------------------------------------------------------===//
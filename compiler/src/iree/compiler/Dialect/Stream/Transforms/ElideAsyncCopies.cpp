@@ -18,6 +18,7 @@
 #include "llvm/ADT/TypeSwitch.h"
 #include "llvm/Support/Debug.h"
 #include "mlir/Analysis/Liveness.h"
+#include "mlir/Dialect/SCF/IR/SCF.h"
 #include "mlir/IR/AsmState.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -235,20 +236,96 @@ private:
     }
   }
 
+  // Updates the element state based on the predecessors of the region entry
+  // argument |arg| of |regionOp|: the operand the parent op passes on entry
+  // (scf.for iter_args, etc) and the operands the region terminators pass
+  // back along loop edges (scf.yield, etc).
+  TraversalResult updateFromRegionPredecessors(RegionBranchOpInterface regionOp,
+                                               BlockArgument arg,
+                                               DFX::Solver &solver) {
+    Region *targetRegion = arg.getParentRegion();
+    auto findInputIndex =
+        [&](ArrayRef<RegionSuccessor> successors) -> std::optional<unsigned> {
+      for (auto &successor : successors) {
+        if (successor.getSuccessor() != targetRegion)
+          continue;
+        auto inputs = successor.getSuccessorInputs();
+        auto it = llvm::find(inputs, arg);
+        if (it != inputs.end())
+          return std::distance(inputs.begin(), it);
+      }
+      return std::nullopt;
+    };
+
+    // Entry from the parent op. The source value is live across the region so
+    // any use of it from within the region (such as an implicit capture) means
+    // the argument may alias it.
+    SmallVector<RegionSuccessor> successors;
+    regionOp.getSuccessorRegions(RegionBranchPoint::parent(), successors);
+    if (auto inputIndex = findInputIndex(successors)) {
+      auto operands = regionOp.getEntrySuccessorOperands(targetRegion);
+      auto &sourceOperand = regionOp->getOpOperand(
+          operands.getBeginOperandIndex() + inputIndex.value());
+      for (auto *user : sourceOperand.get().getUsers()) {
+        if (user != regionOp && regionOp->isProperAncestor(user)) {
+          LLVM_DEBUG(llvm::dbgs() << "  region entry operand captured\n");
+          removeAssumedBits(NOT_BY_REFERENCE | NOT_MUTATED);
+          break;
+        }
+      }
+      updateFromPredecessorUse(sourceOperand, solver);
+    }
+
+    // Loop edges from terminators within the regions. Only values produced
+    // within the region can be moved along the edge: values from outside of it
+    // remain live for subsequent iterations.
+    for (auto &region : regionOp->getRegions()) {
+      successors.clear();
+      regionOp.getSuccessorRegions(RegionBranchPoint(&region), successors);
+      auto inputIndex = findInputIndex(successors);
+      if (!inputIndex)
+        continue;
+      for (auto &block : region) {
+        auto terminatorOp =
+            dyn_cast<RegionBranchTerminatorOpInterface>(block.getTerminator());
+        if (!terminatorOp)
+          continue;
+        auto operands = terminatorOp.getSuccessorOperands(targetRegion);
+        auto &sourceOperand = operands[inputIndex.value()];
+        Operation *sourceScopeOp =
+            sourceOperand.get().getParentRegion()->getParentOp();
+        if (!regionOp->isAncestor(sourceScopeOp)) {
+          LLVM_DEBUG(llvm::dbgs() << "  loop edge carries outer value\n");
+          removeAssumedBits(NOT_BY_REFERENCE | NOT_MUTATED);
+          continue;
+        }
+        updateFromPredecessorUse(sourceOperand, solver);
+      }
+    }
+    return TraversalResult::COMPLETE;
+  }
+
   // Updates the semantics of |value| by walking all predecessors/callers (up
-  // through function arguments, branch arguments, and tied results) and all
-  // transitive uses (down through function calls, branches, and tied operands)
-  // by way of usage analysis.
+  // through function arguments, branch arguments, region arguments, and tied
+  // results) and all transitive uses (down through function calls, branches,
+  // and tied operands) by way of usage analysis.
   ChangeStatus updateValue(Value value, DFX::Solver &solver) override {
     auto assumedBits = getAssumed();
     auto traversalResult = TraversalResult::COMPLETE;
 
     auto arg = llvm::cast<BlockArgument>(value);
     bool isEntryArg = arg.getParentBlock()->isEntryBlock();
-    if (isEntryArg) {
+    Operation *parentOp = arg.getParentBlock()->getParentOp();
+    if (isEntryArg && !isa<mlir::CallableOpInterface>(parentOp)) {
+      // Region argument (scf.for iter_args, etc).
+      if (auto regionOp = dyn_cast<RegionBranchOpInterface>(parentOp)) {
+        traversalResult |= updateFromRegionPredecessors(regionOp, arg, solver);
+      } else {
+        traversalResult |= TraversalResult::INCOMPLETE;
+      }
+    } else if (isEntryArg) {
       // Call argument.
-      auto callableOp =
-          cast<mlir::CallableOpInterface>(arg.getParentBlock()->getParentOp());
+      auto callableOp = cast<mlir::CallableOpInterface>(parentOp);
       traversalResult |= solver.getExplorer().walkIncomingCalls(
           callableOp, [&](mlir::CallOpInterface callOp) -> WalkResult {
             unsigned baseIdx = callOp.getArgOperands().getBeginOperandIndex();
@@ -295,6 +372,9 @@ public:
         solver(explorer, allocator) {
     explorer.setOpInterfaceAction<mlir::FunctionOpInterface>(
         TraversalAction::RECURSE);
+    explorer.setOpAction<mlir::scf::IfOp>(TraversalAction::RECURSE);
+    explorer.setOpAction<mlir::scf::ForOp>(TraversalAction::RECURSE);
+    explorer.setOpAction<mlir::scf::WhileOp>(TraversalAction::RECURSE);
     explorer.setDialectAction<IREE::Stream::StreamDialect>(
         TraversalAction::RECURSE);
     // Ignore the contents of executables (linalg goo, etc).
@@ -311,18 +391,23 @@ public:
   // Runs analysis and populates the state cache.
   // May fail if analysis cannot be completed due to unsupported or unknown IR.
   LogicalResult run() {
-    // Seed all block arguments throughout the program.
+    // Seed all block arguments throughout the program, including those of
+    // structured control flow regions nested within functions.
     for (auto callableOp : getTopLevelOps()) {
       auto *region = callableOp.getCallableRegion();
       if (!region)
         continue;
-      for (auto &block : *region) {
-        for (auto arg : block.getArguments()) {
+      auto seedBlock = [&](Block *block) {
+        for (auto arg : block->getArguments()) {
           if (llvm::isa<IREE::Stream::ResourceType>(arg.getType())) {
             solver.getOrCreateElementFor<ArgumentSemantics>(
                 Position::forValue(arg));
           }
         }
+      };
+      for (auto &block : *region) {
+        seedBlock(&block);
+        block.walk(seedBlock);
       }
     }
 
@@ -0,0 +1,311 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <limits>
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/IR/AsmState.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-fit-memory-budget"
+
+static llvm::cl::opt<int64_t> clMemoryBudget(
+    "iree-stream-memory-budget",
+    llvm::cl::desc("Maximum number of bytes of resources that may be live at "
+                   "once within a block. Cheap producers are rematerialized "
+                   "to stay under it. 0 disables the budget."),
+    llvm::cl::init(0));
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+#define GEN_PASS_DEF_FITMEMORYBUDGETPASS
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h.inc"
+
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Liveness
+//===----------------------------------------------------------------------===//
+
+// Storage of a statically-sized resource produced in a block along with all
+// of the resources tied to it.
+struct LiveResource {
+  // Resource owning the storage.
+  Value value;
+  int64_t size = 0;
+  // Positions of the producer of |value| and of the last use of the storage.
+  int64_t start = 0;
+  int64_t end = 0;
+  // Position of the first op producing a resource tied to the storage.
+  int64_t firstAliasStart = std::numeric_limits<int64_t>::max();
+  // True if the storage is used outside of the block.
+  bool escapes = false;
+};
+
+// Resources live at each op of a block in program order. This is the order
+// partitioning schedules execution in so it's our best approximation of the
+// timeline before execution regions are formed.
+struct BlockLiveness {
+  SmallVector<Operation *> ops;
+  DenseMap<Operation *, int64_t> positions;
+  SmallVector<LiveResource> resources;
+  // Bytes of all resources live at each op.
+  SmallVector<int64_t> liveBytes;
+};
+
+static BlockLiveness computeBlockLiveness(Block &block) {
+  BlockLiveness liveness;
+  for (auto &op : block) {
+    liveness.positions[&op] = static_cast<int64_t>(liveness.ops.size());
+    liveness.ops.push_back(&op);
+  }
+
+  // Gather the storage produced in the block. Staging resources are in host
+  // memory and don't count against the budget.
+  DenseMap<Value, size_t> storageIndices;
+  for (auto [position, op] : llvm::enumerate(liveness.ops)) {
+    for (auto result : op->getResults()) {
+      auto resourceType =
+          dyn_cast<IREE::Stream::ResourceType>(result.getType());
+      if (!resourceType ||
+          resourceType.getLifetime() == IREE::Stream::Lifetime::Staging) {
+        continue;
+      }
+      if (auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(op)) {
+        if (auto tiedOperand = tiedOp.getTiedResultOperand(result)) {
+          auto it = storageIndices.find(tiedOperand);
+          if (it != storageIndices.end()) {
+            auto &resource = liveness.resources[it->second];
+            resource.firstAliasStart = std::min(
+                resource.firstAliasStart, static_cast<int64_t>(position));
+            storageIndices[result] = it->second;
+          }
+          continue;
+        }
+      }
+      auto sizeAwareOp = dyn_cast<IREE::Util::SizeAwareOpInterface>(op);
+      if (!sizeAwareOp) {
+        continue;
+      }
+      APInt size;
+      if (!matchPattern(sizeAwareOp.getResultSize(result.getResultNumber()),
+                        m_ConstantInt(&size))) {
+        continue;
+      }
+      storageIndices[result] = liveness.resources.size();
+      LiveResource resource;
+      resource.value = result;
+      resource.size = size.getSExtValue();
+      resource.start = resource.end = static_cast<int64_t>(position);
+      liveness.resources.push_back(resource);
+    }
+  }
+
+  // Extend the storage to the last use of any of the resources using it.
+  int64_t lastPosition = static_cast<int64_t>(liveness.ops.size()) - 1;
+  for (auto [value, index] : storageIndices) {
+    auto &resource = liveness.resources[index];
+    for (auto *user : value.getUsers()) {
+      auto *userOp = block.findAncestorOpInBlock(*user);
+      if (!userOp) {
+        resource.escapes = true;
+        resource.end = lastPosition;
+        continue;
+      }
+      resource.end = std::max(resource.end, liveness.positions[userOp]);
+    }
+  }
+
+  liveness.liveBytes.resize(liveness.ops.size(), 0);
+  for (auto &resource : liveness.resources) {
+    for (int64_t i = resource.start; i <= resource.end; ++i) {
+      liveness.liveBytes[i] += resource.size;
+    }
+  }
+  return liveness;
+}
+
+// Returns the position of the last op in the block using |value|, or -1 if
+// not used in the block.
+static int64_t getLastUsePosition(Value value, const BlockLiveness &liveness,
+                                  Block &block) {
+  int64_t lastUse = -1;
+  for (auto *user : value.getUsers()) {
+    if (auto *userOp = block.findAncestorOpInBlock(*user)) {
+      lastUse = std::max(lastUse, liveness.positions.lookup(userOp));
+    }
+  }
+  return lastUse;
+}
+
+//===----------------------------------------------------------------------===//
+// Rematerialization
+//===----------------------------------------------------------------------===//
+
+// Returns true if |producerOp| can be cloned right before the op at position
+// |clonePosition| without extending the lifetime of its operands.
+static bool isRematerializable(Operation *producerOp, int64_t clonePosition,
+                               const BlockLiveness &liveness, Block &block) {
+  if (producerOp->getNumResults() != 1 || producerOp->getNumRegions() != 0) {
+    return false;
+  }
+  auto streamableOp = dyn_cast<IREE::Stream::StreamableOpInterface>(producerOp);
+  if (!isa<IREE::Stream::AsyncDispatchOp>(producerOp) &&
+      (!streamableOp || !streamableOp.preferCloneToConsumers())) {
+    return false;
+  }
+  if (auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(producerOp)) {
+    if (tiedOp.getTiedResultOperand(producerOp->getResult(0))) {
+      return false;
+    }
+  }
+  for (auto operand : producerOp->getOperands()) {
+    auto resourceType = dyn_cast<IREE::Stream::ResourceType>(operand.getType());
+    if (!resourceType ||
+        resourceType.getLifetime() == IREE::Stream::Lifetime::Constant) {
+      continue;
+    }
+    // The operand must hold the same contents at the clone and be live there
+    // anyway. Resources consumed in-place by a tied op may be overwritten.
+    for (auto &use : operand.getUses()) {
+      auto tiedOp = dyn_cast<IREE::Util::TiedOpInterface>(use.getOwner());
+      if (use.getOwner()->getBlock() != &block ||
+          (tiedOp && tiedOp.isOperandTied(use.getOperandNumber()))) {
+        return false;
+      }
+    }
+    if (getLastUsePosition(operand, liveness, block) < clonePosition) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the position of the first use of |resource| after |position| if its
+// producer can be rematerialized there such that it is no longer live at
+// |position|.
+static std::optional<int64_t>
+findRematerializationPosition(const LiveResource &resource, int64_t position,
+                              const BlockLiveness &liveness, Block &block) {
+  if (resource.escapes || resource.start >= position ||
+      resource.end <= position || resource.firstAliasStart <= position) {
+    return std::nullopt;
+  }
+  int64_t nextUse = std::numeric_limits<int64_t>::max();
+  for (auto *user : resource.value.getUsers()) {
+    auto *userOp = block.findAncestorOpInBlock(*user);
+    int64_t userPosition = liveness.positions.lookup(userOp);
+    if (userPosition == position) {
+      return std::nullopt;
+    } else if (userPosition > position) {
+      nextUse = std::min(nextUse, userPosition);
+    }
+  }
+  if (!isRematerializable(resource.value.getDefiningOp(), nextUse, liveness,
+                          block)) {
+    return std::nullopt;
+  }
+  return nextUse;
+}
+
+// Rematerializes resources live across ops in |block| at which more than
+// |budget| bytes are live. Warns at the peak if the budget can't be met.
+static void fitBlockToBudget(Block &block, int64_t budget) {
+  int64_t searchPosition = 0;
+  while (true) {
+    auto liveness = computeBlockLiveness(block);
+    auto it = llvm::find_if(
+        llvm::drop_begin(liveness.liveBytes, searchPosition),
+        [&](int64_t liveBytes) { return liveBytes > budget; });
+    if (it == liveness.liveBytes.end()) {
+      auto peakIt = llvm::max_element(liveness.liveBytes);
+      if (*peakIt > budget) {
+        auto *peakOp =
+            liveness.ops[std::distance(liveness.liveBytes.begin(), peakIt)];
+        peakOp->emitWarning()
+            << "resources live here need " << *peakIt
+            << " bytes, more than the memory budget of " << budget
+            << " bytes, and no producer can be rematerialized to fit";
+      }
+      return;
+    }
+    int64_t position = std::distance(liveness.liveBytes.begin(), it);
+
+    // Pick the largest resource we can stop keeping live here.
+    const LiveResource *bestResource = nullptr;
+    int64_t bestPosition = 0;
+    for (auto &resource : liveness.resources) {
+      if (bestResource && bestResource->size >= resource.size) {
+        continue;
+      }
+      if (auto clonePosition = findRematerializationPosition(
+              resource, position, liveness, block)) {
+        bestResource = &resource;
+        bestPosition = *clonePosition;
+      }
+    }
+    if (!bestResource) {
+      // Nothing we can do here; try the next point over budget.
+      searchPosition = position + 1;
+      continue;
+    }
+
+    LLVM_DEBUG({
+      AsmState asmState(block.getParentOp());
+      llvm::dbgs() << "rematerializing ";
+      bestResource->value.printAsOperand(llvm::dbgs(), asmState);
+      llvm::dbgs() << " (" << bestResource->size << " bytes) as "
+                   << liveness.liveBytes[position] << " bytes are live at "
+                   << *liveness.ops[position] << "\n";
+    });
+    OpBuilder builder(liveness.ops[bestPosition]);
+    auto *cloneOp = builder.clone(*bestResource->value.getDefiningOp());
+    bestResource->value.replaceUsesWithIf(
+        cloneOp->getResult(0), [&](OpOperand &use) {
+          auto *userOp = block.findAncestorOpInBlock(*use.getOwner());
+          return liveness.positions.lookup(userOp) > position;
+        });
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// --iree-stream-fit-memory-budget
+//===----------------------------------------------------------------------===//
+
+struct FitMemoryBudgetPass
+    : public IREE::Stream::impl::FitMemoryBudgetPassBase<FitMemoryBudgetPass> {
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    if (clMemoryBudget <= 0 || !parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+
+    // NOTE: each block is handled on its own and only resources produced in
+    // the block are counted. Resources captured from parent blocks or passed
+    // across calls are live regardless of what we do here.
+    SmallVector<Block *> blocks;
+    parentOp->walk([&](Block *block) { blocks.push_back(block); });
+    for (auto *block : blocks) {
+      if (block->empty()) {
+        continue;
+      }
+      fitBlockToBudget(*block, clMemoryBudget);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Stream
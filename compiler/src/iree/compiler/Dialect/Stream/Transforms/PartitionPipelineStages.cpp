@@ -0,0 +1,175 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/Analysis/ExecutionCosts.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-partition-pipeline-stages"
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+#define GEN_PASS_DEF_PARTITIONPIPELINESTAGESPASS
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h.inc"
+
+// Returns the affinities of the pipeline stages |op| is to be partitioned into
+// as specified by the `stream.pipeline_stages` attribute on it or its parents.
+static SmallVector<IREE::Stream::AffinityAttr>
+lookupStageAffinities(Operation *op) {
+  auto attrId = StringAttr::get(op->getContext(), "stream.pipeline_stages");
+  for (; op; op = op->getParentOp()) {
+    auto stagesAttr = op->getAttrOfType<ArrayAttr>(attrId);
+    if (!stagesAttr) {
+      continue;
+    }
+    SmallVector<IREE::Stream::AffinityAttr> affinityAttrs;
+    for (auto attr : stagesAttr) {
+      if (auto affinityAttr = dyn_cast<IREE::Stream::AffinityAttr>(attr)) {
+        affinityAttrs.push_back(affinityAttr);
+      }
+    }
+    return affinityAttrs;
+  }
+  return {};
+}
+
+// Returns true if |op| should be assigned to a pipeline stage. Ops that
+// already have an affinity keep it and transfers are left for the stages they
+// connect.
+static bool isStageable(Operation &op) {
+  if (!isa<IREE::Stream::StreamableOpInterface>(op) ||
+      isa<IREE::Stream::AsyncTransferOp>(op)) {
+    return false;
+  }
+  auto affinityOp = dyn_cast<IREE::Stream::AffinityOpInterface>(op);
+  return affinityOp && affinityOp.requiresAffinity() &&
+         !affinityOp.getAffinity();
+}
+
+// Splits the stageable ops of |block| into contiguous pipeline stages of
+// roughly equal estimated cost and assigns each the affinity of its stage.
+static void assignStages(Block &block,
+                         ArrayRef<IREE::Stream::AffinityAttr> stages,
+                         ExecutionCostModel &costModel) {
+  SmallVector<Operation *> ops;
+  SmallVector<double> costs;
+  double totalCost = 0.0;
+  for (auto &op : block) {
+    if (!isStageable(op)) {
+      continue;
+    }
+    // Dispatches without an estimate are assumed to cost the same and other
+    // ops are assumed to be free; they are placed with their neighbors.
+    double cost = 0.0;
+    if (auto estimate = costModel.estimate(&op)) {
+      cost = estimate->getTime();
+    } else if (isa<IREE::Stream::AsyncDispatchOp>(op)) {
+      cost = 1.0;
+    }
+    ops.push_back(&op);
+    costs.push_back(cost);
+    totalCost += cost;
+  }
+  if (ops.empty()) {
+    return;
+  }
+  if (totalCost <= 0.0) {
+    // Nothing is known about the cost of the ops so split them evenly.
+    costs.assign(ops.size(), 1.0);
+    totalCost = static_cast<double>(ops.size());
+  }
+
+  // Each op is assigned the stage containing the midpoint of its cost in the
+  // running total so that stages are contiguous and balanced.
+  size_t stageCount = stages.size();
+  double costBefore = 0.0;
+  for (auto [op, cost] : llvm::zip_equal(ops, costs)) {
+    double midpoint = costBefore + cost / 2.0;
+    size_t stage = std::min(
+        stageCount - 1, static_cast<size_t>(midpoint * stageCount / totalCost));
+    cast<IREE::Stream::AffinityOpInterface>(op).setAffinity(stages[stage]);
+    costBefore += cost;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "assigned " << ops.size() << " ops to "
+                          << stageCount << " pipeline stages\n");
+}
+
+// Inserts transfers for all resources consumed by ops in |block| from a
+// producer with a different affinity. Transfers are shared by all consumers
+// on the same affinity and placed before the first of them.
+static void insertStageTransfers(Block &block) {
+  DenseMap<std::pair<Value, Attribute>, Value> transfers;
+  for (auto &op : block) {
+    auto consumerOp = dyn_cast<IREE::Stream::AffinityOpInterface>(op);
+    auto affinityAttr = consumerOp ? consumerOp.getAffinity() : nullptr;
+    if (!affinityAttr) {
+      continue;
+    }
+    for (auto &operand : op.getOpOperands()) {
+      Value value = operand.get();
+      if (!isa<IREE::Stream::ResourceType>(value.getType())) {
+        continue;
+      }
+      auto producerOp =
+          value.getDefiningOp<IREE::Stream::AffinityOpInterface>();
+      if (!producerOp || !producerOp.getAffinity() ||
+          producerOp.getAffinity() == affinityAttr) {
+        continue;
+      }
+      auto &transfer = transfers[{value, affinityAttr}];
+      if (!transfer) {
+        OpBuilder builder(&op);
+        Value size = IREE::Util::SizeAwareTypeInterface::queryValueSize(
+            op.getLoc(), value, builder);
+        transfer = builder.create<IREE::Stream::AsyncTransferOp>(
+            op.getLoc(), value.getType(), value, size, size,
+            producerOp.getAffinity(), affinityAttr);
+      }
+      operand.set(transfer);
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// --iree-stream-partition-pipeline-stages
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct PartitionPipelineStagesPass
+    : public IREE::Stream::impl::PartitionPipelineStagesPassBase<
+          PartitionPipelineStagesPass> {
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    if (!parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+    auto stages = lookupStageAffinities(parentOp);
+    if (stages.size() < 2) {
+      return;
+    }
+
+    // NOTE: stages are formed per block. Control flow splits the program into
+    // pieces we can't balance against each other without knowing how often
+    // each runs.
+    ExecutionCostModel costModel;
+    for (auto &block : *parentOp.getCallableRegion()) {
+      assignStages(block, stages, costModel);
+      insertStageTransfers(block);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Stream
@@ -156,11 +156,27 @@ void buildStreamAsyncPassPipeline(OpPassManager &passManager,
   //----------------------------------------------------------------------------
 
   FunctionLikeNest(passManager)
+      // Split the program into pipeline stages on different affinities if
+      // requested with a `stream.pipeline_stages` attribute.
+      .addPass(IREE::Stream::createPartitionPipelineStagesPass)
+      // Rematerialize cheap producers if the program needs more memory than
+      // --iree-stream-memory-budget= allows. No-op without a budget.
+      .addPass(IREE::Stream::createFitMemoryBudgetPass)
       // Combine async work into execution regions.
       .addPass(IREE::Stream::createScheduleExecutionPass)
       // Group concurrently executable work into waves.
       .addPass(IREE::Stream::createScheduleConcurrencyPass);
 
+  // Read parameters into a ring of device buffers right before each use
+  // instead of keeping all of them resident. This must run before timepoints
+  // are propagated so the initializers loading the parameters can be dropped.
+  if (transformOptions.weightStreamingDepth > 0) {
+    ScheduleWeightStreamingPassOptions weightStreamingOptions;
+    weightStreamingOptions.depth = transformOptions.weightStreamingDepth;
+    passManager.addPass(IREE::Stream::createScheduleWeightStreamingPass(
+        weightStreamingOptions));
+  }
+
   // Materialize timepoints across the entire module. This simplifies scheduling
   // of the timeline as we can shake the IR and see what timepoints we still
   // have left.
@@ -201,6 +217,16 @@ void buildStreamCmdPassPipeline(OpPassManager &passManager,
       // below.
       .addPass(IREE::Stream::createLayoutSlicesPass);
 
+  // Suballocate the transients of execution regions from a shared arena so
+  // that regions with disjoint lifetimes reuse the same memory. This runs after
+  // the layout above so that the per-region transient sizes are known and
+  // needs another layout for the arena packs it produces.
+  if (transformOptions.reuseTransientAllocations) {
+    FunctionLikeNest(passManager)
+        .addPass(IREE::Stream::createReuseTransientAllocationsPass)
+        .addPass(IREE::Stream::createLayoutSlicesPass);
+  }
+
   // Propagate subviews throughout the program to unify resource storage access.
   // After propagation many resource SSA values can be deduped or folded by the
   // cleanup patterns.
@@ -50,6 +50,23 @@ struct TransformOptions : public PassPipelineOptions<TransformOptions> {
       llvm::cl::init(true),
   };
 
+  Option<bool> reuseTransientAllocations{
+      *this,
+      "reuse-transient-allocations",
+      llvm::cl::desc("Suballocates the transients of execution regions with "
+                     "disjoint lifetimes from a single reusable arena."),
+      llvm::cl::init(false),
+  };
+
+  Option<int64_t> weightStreamingDepth{
+      *this,
+      "weight-streaming-depth",
+      llvm::cl::desc("Streams parameters through a ring of this many device "
+                     "buffers instead of keeping them all resident. 0 "
+                     "disables weight streaming."),
+      llvm::cl::init(0),
+  };
+
   Option<DumpOutputFormat> dumpStatisticsFormat{
       *this,
       "dump-statistics-format",
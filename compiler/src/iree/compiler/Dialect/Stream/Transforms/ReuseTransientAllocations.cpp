@@ -0,0 +1,266 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Utils/IndexSet.h"
+#include "llvm/ADT/MapVector.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Dominance.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-reuse-transient-allocations"
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+#define GEN_PASS_DEF_REUSETRANSIENTALLOCATIONSPASS
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h.inc"
+
+namespace {
+
+// A transient allocation that can be suballocated from an arena.
+struct TransientAllocation {
+  IREE::Stream::ResourceAllocaOp allocaOp;
+  IREE::Stream::ResourceDeallocaOp deallocaOp;
+  // Positions of the alloca and the dealloca in their block.
+  int64_t lifetimeStart = 0;
+  int64_t lifetimeEnd = 0;
+  // Returns true if this allocation may reuse the memory of |previous|.
+  bool canReuse(const TransientAllocation &previous) const {
+    return previous.lifetimeEnd < lifetimeStart;
+  }
+};
+
+} // namespace
+
+// Returns the dealloca of the transient allocated by |allocaOp| if that
+// transient is only used by execution regions and the dealloca, all in the
+// block of |allocaOp|.
+static IREE::Stream::ResourceDeallocaOp
+findLocalDealloca(IREE::Stream::ResourceAllocaOp allocaOp) {
+  auto resourceType =
+      dyn_cast<IREE::Stream::ResourceType>(allocaOp.getResult().getType());
+  if (!resourceType ||
+      resourceType.getLifetime() != IREE::Stream::Lifetime::Transient) {
+    return {};
+  }
+  IREE::Stream::ResourceDeallocaOp deallocaOp;
+  for (auto *user : allocaOp.getResult().getUsers()) {
+    if (user->getBlock() != allocaOp->getBlock()) {
+      return {};
+    }
+    if (auto userDeallocaOp =
+            dyn_cast<IREE::Stream::ResourceDeallocaOp>(user)) {
+      if (deallocaOp) {
+        return {};
+      }
+      deallocaOp = userDeallocaOp;
+    } else if (!isa<IREE::Stream::CmdExecuteOp>(user)) {
+      return {};
+    }
+  }
+  if (!deallocaOp || !deallocaOp.getAwaitTimepoint() ||
+      deallocaOp.getAffinityAttr() != allocaOp.getAffinityAttr()) {
+    return {};
+  }
+  return deallocaOp;
+}
+
+// Returns true if the size of |allocation| is a constant or is defined before
+// |insertionPoint|.
+static bool isSizeKnownBefore(const TransientAllocation &allocation,
+                              Operation *insertionPoint,
+                              DominanceInfo &domInfo) {
+  Value size = allocation.allocaOp.getStorageSize();
+  return matchPattern(size, m_Constant()) ||
+         domInfo.properlyDominates(size, insertionPoint);
+}
+
+// Replaces |allocations|, all with the same affinity and in block order, with
+// subviews of a single arena.
+static void suballocateFromArena(ArrayRef<TransientAllocation> allocations,
+                                 DominanceInfo &domInfo) {
+  auto firstAllocaOp = allocations.front().allocaOp;
+
+  // Only allocations whose sizes are known at the first alloca can be part of
+  // the arena. The first one always is.
+  SmallVector<TransientAllocation> members;
+  for (auto &allocation : allocations) {
+    if (isSizeKnownBefore(allocation, firstAllocaOp, domInfo)) {
+      members.push_back(allocation);
+    }
+  }
+
+  // The arena only helps if some memory can be reused.
+  bool anyReuse = false;
+  for (size_t i = 1; i < members.size() && !anyReuse; ++i) {
+    for (size_t j = 0; j < i && !anyReuse; ++j) {
+      anyReuse = members[i].canReuse(members[j]);
+    }
+  }
+  if (!anyReuse) {
+    return;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "suballocating " << members.size()
+                          << " transient allocations from an arena\n");
+
+  // Pack all allocations as slices alive between their alloca and dealloca.
+  // Layout will assign the same offsets to slices whose lifetimes are
+  // disjoint.
+  OpBuilder arenaBuilder(firstAllocaOp);
+  IndexSet indexSet(firstAllocaOp.getLoc(), arenaBuilder);
+  SmallVector<Location> locs;
+  SmallVector<Value> memberSizes;
+  SmallVector<int64_t> lifetimeIntervals;
+  for (auto &member : members) {
+    locs.push_back(member.allocaOp.getLoc());
+    Value size = member.allocaOp.getStorageSize();
+    APInt constantSize;
+    if (matchPattern(size, m_ConstantInt(&constantSize))) {
+      size = indexSet.get(constantSize.getSExtValue());
+    }
+    memberSizes.push_back(size);
+    lifetimeIntervals.push_back(member.lifetimeStart);
+    lifetimeIntervals.push_back(member.lifetimeEnd);
+  }
+  auto fusedLoc = arenaBuilder.getFusedLoc(locs);
+  auto indexType = arenaBuilder.getIndexType();
+  auto affinityAttr = firstAllocaOp.getAffinityAttr();
+  SmallVector<Type> packedOffsetTypes(members.size(), indexType);
+  auto packOp = arenaBuilder.create<IREE::Stream::ResourcePackOp>(
+      fusedLoc, indexType, packedOffsetTypes, /*offset=*/nullptr,
+      arenaBuilder.getIndexArrayAttr(lifetimeIntervals), memberSizes,
+      affinityAttr);
+  auto timepointType = arenaBuilder.getType<IREE::Stream::TimepointType>();
+  auto arenaOp = arenaBuilder.create<IREE::Stream::ResourceAllocaOp>(
+      fusedLoc, firstAllocaOp.getResult().getType(), timepointType,
+      packOp.getTotalLength(), /*await_timepoint=*/nullptr, affinityAttr);
+  Value arena = arenaOp.getResult();
+  Value arenaSize = arenaOp.getStorageSize();
+
+  // Replace each alloca with a subview of the arena that is ready once the
+  // original alloca would have been and once all earlier allocations whose
+  // memory it may reuse have been released.
+  for (auto [member, offset] :
+       llvm::zip_equal(members, packOp.getPackedOffsets())) {
+    auto allocaOp = member.allocaOp;
+    OpBuilder builder(allocaOp);
+    SmallVector<Value> readyTimepoints;
+    if (auto awaitTimepoint = allocaOp.getAwaitTimepoint()) {
+      readyTimepoints.push_back(awaitTimepoint);
+    }
+    readyTimepoints.push_back(arenaOp.getResultTimepoint());
+    for (auto &previous : members) {
+      if (member.canReuse(previous)) {
+        readyTimepoints.push_back(previous.deallocaOp.getAwaitTimepoint());
+      }
+    }
+    auto readyTimepoint = IREE::Stream::TimepointJoinOp::join(
+        allocaOp.getLoc(), readyTimepoints, builder);
+    auto subviewOp = builder.create<IREE::Stream::ResourceSubviewOp>(
+        allocaOp.getLoc(), arena, arenaSize, offset, allocaOp.getStorageSize());
+    allocaOp.getResultTimepoint().replaceAllUsesWith(readyTimepoint);
+    allocaOp.getResult().replaceAllUsesWith(subviewOp.getResult());
+    allocaOp.erase();
+  }
+
+  // Release the arena once all allocations would have been. This replaces
+  // the last dealloca and the others complete as soon as their allocations
+  // are no longer used.
+  auto lastMember = llvm::max_element(
+      members, [](const TransientAllocation &lhs,
+                  const TransientAllocation &rhs) {
+        return lhs.lifetimeEnd < rhs.lifetimeEnd;
+      });
+  auto lastDeallocaOp = lastMember->deallocaOp;
+  OpBuilder builder(lastDeallocaOp);
+  SmallVector<Value> releaseTimepoints;
+  for (auto &member : members) {
+    releaseTimepoints.push_back(member.deallocaOp.getAwaitTimepoint());
+  }
+  auto arenaDeallocaOp = builder.create<IREE::Stream::ResourceDeallocaOp>(
+      lastDeallocaOp.getLoc(), arena, arenaSize,
+      IREE::Stream::TimepointJoinOp::join(lastDeallocaOp.getLoc(),
+                                          releaseTimepoints, builder),
+      affinityAttr);
+  for (auto &member : members) {
+    auto deallocaOp = member.deallocaOp;
+    if (deallocaOp == lastDeallocaOp) {
+      deallocaOp.getResultTimepoint().replaceAllUsesWith(
+          arenaDeallocaOp.getResultTimepoint());
+    } else {
+      deallocaOp.getResultTimepoint().replaceAllUsesWith(
+          deallocaOp.getAwaitTimepoint());
+    }
+    deallocaOp.erase();
+  }
+}
+
+// Suballocates the transients allocated and deallocated in |block| from
+// arenas, one per affinity.
+static void reuseTransientAllocations(Block &block, DominanceInfo &domInfo) {
+  DenseMap<Operation *, int64_t> positions;
+  for (auto &op : block) {
+    positions[&op] = static_cast<int64_t>(positions.size());
+  }
+  llvm::MapVector<Attribute, SmallVector<TransientAllocation>>
+      allocationsByAffinity;
+  for (auto allocaOp : block.getOps<IREE::Stream::ResourceAllocaOp>()) {
+    auto deallocaOp = findLocalDealloca(allocaOp);
+    if (!deallocaOp) {
+      continue;
+    }
+    TransientAllocation allocation;
+    allocation.allocaOp = allocaOp;
+    allocation.deallocaOp = deallocaOp;
+    allocation.lifetimeStart = positions[allocaOp];
+    allocation.lifetimeEnd = positions[deallocaOp];
+    allocationsByAffinity[allocaOp.getAffinityAttr()].push_back(allocation);
+  }
+  for (auto &[affinityAttr, allocations] : allocationsByAffinity) {
+    if (allocations.size() > 1) {
+      suballocateFromArena(allocations, domInfo);
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// --iree-stream-reuse-transient-allocations
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct ReuseTransientAllocationsPass
+    : public IREE::Stream::impl::ReuseTransientAllocationsPassBase<
+          ReuseTransientAllocationsPass> {
+  void runOnOperation() override {
+    auto parentOp = getOperation();
+    if (!parentOp.getCallableRegion() ||
+        parentOp.getCallableRegion()->empty()) {
+      return;
+    }
+
+    // NOTE: transients are only reused within a block as that's where
+    // ScheduleAllocation places the allocas and deallocas of the execution
+    // regions. Reuse across blocks and calls would need the lifetimes to be
+    // threaded through branches and function boundaries.
+    SmallVector<Block *> blocks;
+    parentOp->walk([&](Block *block) { blocks.push_back(block); });
+    DominanceInfo domInfo(parentOp);
+    for (auto *block : blocks) {
+      reuseTransientAllocations(*block, domInfo);
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Stream
@@ -4,6 +4,7 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include "iree/compiler/Dialect/Stream/Analysis/ExecutionCosts.h"
 #include "iree/compiler/Dialect/Stream/Analysis/Partitioning.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
 #include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
@@ -203,8 +204,10 @@ struct ScheduleConcurrencyPass
     auto configAttr = IREE::Stream::PartitioningConfigAttr::lookup(parentOp);
 
     // Compute a set of partitions covering all of the streamable ops in the
-    // execution region.
-    auto waveSet = partitionRegionConcurrency(configAttr, block);
+    // execution region. Waves are balanced using the estimated costs of the
+    // ops, if any are known.
+    IREE::Stream::ExecutionCostModel costModel;
+    auto waveSet = partitionRegionConcurrency(configAttr, block, &costModel);
     if (waveSet.empty())
       return success();
     if (failed(waveSet.verify(parentOp.getLoc())))
@@ -0,0 +1,336 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Dialect/Stream/IR/StreamDialect.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamOps.h"
+#include "iree/compiler/Dialect/Stream/IR/StreamTypes.h"
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h"
+#include "iree/compiler/Dialect/Util/Analysis/Explorer.h"
+#include "iree/compiler/Dialect/Util/IR/UtilOps.h"
+#include "llvm/Support/Debug.h"
+#include "mlir/Dialect/Arith/IR/Arith.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/Matchers.h"
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Pass/Pass.h"
+
+#define DEBUG_TYPE "iree-stream-schedule-weight-streaming"
+
+namespace mlir::iree_compiler::IREE::Stream {
+
+#define GEN_PASS_DEF_SCHEDULEWEIGHTSTREAMINGPASS
+#include "iree/compiler/Dialect/Stream/Transforms/Passes.h.inc"
+
+namespace {
+
+// A global initialized with the contents of a parameter that can instead be
+// read from the parameter each time it is used.
+struct StreamedParameter {
+  IREE::Util::GlobalOpInterface globalOp;
+  IREE::Stream::NamedParameterAttr parameterAttr;
+  IREE::Stream::AffinityAttr affinityAttr;
+  // Size of the resource the parameter is loaded into.
+  int64_t resourceSize = 0;
+  // Range of the parameter that is loaded.
+  int64_t sourceOffset = 0;
+  int64_t sourceLength = 0;
+};
+
+// A load of a streamed parameter and the execution regions consuming it.
+struct ParameterUse {
+  const StreamedParameter *parameter = nullptr;
+  IREE::Util::GlobalLoadOpInterface loadOp;
+  // Consumers in block order.
+  SmallVector<IREE::Stream::AsyncExecuteOp> consumers;
+  // Positions of the first and last consumer in the block.
+  int64_t firstUse = 0;
+  int64_t lastUse = 0;
+  // Timepoint the ring slot holding the parameter is released with.
+  Value releaseTimepoint;
+};
+
+} // namespace
+
+// Returns the parameter |globalOp| is initialized with if it is only ever
+// stored once by an initializer with the result of a `stream.async.constant`
+// of a parameter.
+static std::optional<StreamedParameter>
+findStreamedParameter(const Explorer::GlobalInfo *globalInfo) {
+  if (!globalInfo || globalInfo->isIndirect ||
+      !globalInfo->op.isGlobalPrivate()) {
+    return std::nullopt;
+  }
+  auto resourceType =
+      dyn_cast<IREE::Stream::ResourceType>(globalInfo->op.getGlobalType());
+  if (!resourceType ||
+      resourceType.getLifetime() != IREE::Stream::Lifetime::Constant) {
+    return std::nullopt;
+  }
+  auto stores = llvm::to_vector(globalInfo->getStores());
+  if (stores.size() != 1 ||
+      !isa<IREE::Util::InitializerOp>(stores.front()->getParentOp())) {
+    return std::nullopt;
+  }
+
+  // The initializer awaits the execution region loading the parameter before
+  // storing it: trace back through the await and the region yield.
+  Value storedValue = stores.front().getStoredGlobalValue();
+  auto awaitOp = storedValue.getDefiningOp<IREE::Stream::TimepointAwaitOp>();
+  if (!awaitOp) {
+    return std::nullopt;
+  }
+  unsigned awaitIndex = cast<OpResult>(storedValue).getResultNumber();
+  Value awaitedValue = awaitOp.getResourceOperands()[awaitIndex];
+  auto executeOp = awaitedValue.getDefiningOp<IREE::Stream::AsyncExecuteOp>();
+  if (!executeOp) {
+    return std::nullopt;
+  }
+  auto yieldOp = cast<IREE::Stream::YieldOp>(
+      executeOp.getBody().front().getTerminator());
+  unsigned resultIndex = cast<OpResult>(awaitedValue).getResultNumber();
+  Value yieldedValue = yieldOp.getResourceOperands()[resultIndex];
+  auto constantOp = yieldedValue.getDefiningOp<IREE::Stream::AsyncConstantOp>();
+  if (!constantOp) {
+    return std::nullopt;
+  }
+  auto parameterAttr =
+      dyn_cast<IREE::Stream::NamedParameterAttr>(constantOp.getValue());
+  APInt resourceSize;
+  if (!parameterAttr ||
+      !matchPattern(constantOp.getResultSize(), m_ConstantInt(&resourceSize))) {
+    return std::nullopt;
+  }
+
+  StreamedParameter parameter;
+  parameter.globalOp = globalInfo->op;
+  parameter.parameterAttr = parameterAttr;
+  parameter.affinityAttr = executeOp.getAffinityAttr();
+  parameter.resourceSize = resourceSize.getSExtValue();
+  parameter.sourceLength = parameterAttr.getStorageSize();
+  if (auto configAttr = parameterAttr.getConfig()) {
+    if (auto offsetAttr = configAttr.getAs<IntegerAttr>("offset")) {
+      parameter.sourceOffset = offsetAttr.getInt();
+    }
+  }
+  if (parameter.sourceLength > parameter.resourceSize) {
+    return std::nullopt;
+  }
+  return parameter;
+}
+
+// Returns the execution regions in |block| consuming |loadOp| or an empty list
+// if it has any other use. Regions may not tie the parameter to their results
+// as the ring slot is released once they complete.
+static SmallVector<IREE::Stream::AsyncExecuteOp>
+findConsumers(IREE::Util::GlobalLoadOpInterface loadOp, Block &block,
+              DenseMap<Operation *, int64_t> &positions) {
+  SmallVector<IREE::Stream::AsyncExecuteOp> consumers;
+  for (auto &use : loadOp.getLoadedGlobalValue().getUses()) {
+    auto executeOp = dyn_cast<IREE::Stream::AsyncExecuteOp>(use.getOwner());
+    if (!executeOp || executeOp->getBlock() != &block ||
+        executeOp.isOperandTied(use.getOperandNumber())) {
+      return {};
+    }
+    if (!llvm::is_contained(consumers, executeOp)) {
+      consumers.push_back(executeOp);
+    }
+  }
+  llvm::sort(consumers, [&](IREE::Stream::AsyncExecuteOp lhs,
+                            IREE::Stream::AsyncExecuteOp rhs) {
+    return positions[lhs] < positions[rhs];
+  });
+  return consumers;
+}
+
+// Reads the parameter of |use| into a new ring slot, waiting for |gateUse| to
+// release its slot if given, and makes the consumers use the slot.
+static void streamParameterUse(ParameterUse &use, ParameterUse *gateUse) {
+  auto *parameter = use.parameter;
+  auto loc = use.loadOp.getLoc();
+
+  // Slots are allocated as soon as the one they replace in the ring is
+  // released so that the read overlaps with the execution in between.
+  // Without a slot to wait on the read is issued where the global was loaded.
+  OpBuilder builder(use.loadOp);
+  Value gateTimepoint;
+  if (gateUse) {
+    gateTimepoint = gateUse->releaseTimepoint;
+    builder.setInsertionPointAfterValue(gateTimepoint);
+  }
+  auto resourceType = cast<IREE::Stream::ResourceType>(
+      parameter->globalOp.getGlobalType());
+  auto timepointType = builder.getType<IREE::Stream::TimepointType>();
+  Value resourceSize =
+      builder.create<arith::ConstantIndexOp>(loc, parameter->resourceSize);
+  auto allocaOp = builder.create<IREE::Stream::ResourceAllocaOp>(
+      loc, resourceType, timepointType, resourceSize, gateTimepoint,
+      parameter->affinityAttr);
+  Value sourceOffset = builder.create<arith::ConstantIntOp>(
+      loc, parameter->sourceOffset, 64);
+  Value targetOffset = builder.create<arith::ConstantIndexOp>(loc, 0);
+  Value targetLength =
+      builder.create<arith::ConstantIndexOp>(loc, parameter->sourceLength);
+  auto readOp = builder.create<IREE::Stream::ParameterReadOp>(
+      loc, timepointType, parameter->parameterAttr.getScope(),
+      parameter->parameterAttr.getKey(), sourceOffset, allocaOp.getResult(),
+      resourceSize, targetOffset, targetLength, allocaOp.getResultTimepoint(),
+      parameter->affinityAttr);
+
+  // Consumers use the slot once the read completes.
+  Value loadedValue = use.loadOp.getLoadedGlobalValue();
+  SmallVector<Value> resultTimepoints;
+  for (auto executeOp : use.consumers) {
+    OpBuilder consumerBuilder(executeOp);
+    SmallVector<Value> awaitTimepoints = {readOp.getResultTimepoint()};
+    if (auto awaitTimepoint = executeOp.getAwaitTimepoint()) {
+      awaitTimepoints.insert(awaitTimepoints.begin(), awaitTimepoint);
+    }
+    executeOp.getAwaitTimepointMutable().assign(
+        IREE::Stream::TimepointJoinOp::join(executeOp.getLoc(),
+                                            awaitTimepoints, consumerBuilder));
+    executeOp->replaceUsesOfWith(loadedValue, allocaOp.getResult());
+    resultTimepoints.push_back(executeOp.getResultTimepoint());
+  }
+
+  // Release the slot once all consumers complete.
+  OpBuilder releaseBuilder(use.consumers.back());
+  releaseBuilder.setInsertionPointAfter(use.consumers.back());
+  auto deallocaOp = releaseBuilder.create<IREE::Stream::ResourceDeallocaOp>(
+      loc, allocaOp.getResult(), resourceSize,
+      IREE::Stream::TimepointJoinOp::join(loc, resultTimepoints,
+                                          releaseBuilder),
+      parameter->affinityAttr);
+  use.releaseTimepoint = deallocaOp.getResultTimepoint();
+}
+
+// Streams the parameters loaded in |block| through a ring of |depth| slots.
+static void
+streamParametersInBlock(Block &block,
+                        DenseMap<StringRef, StreamedParameter> &parameters,
+                        int64_t depth) {
+  DenseMap<Operation *, int64_t> positions;
+  for (auto &op : block) {
+    positions[&op] = static_cast<int64_t>(positions.size());
+  }
+  SmallVector<ParameterUse> uses;
+  for (auto loadOp : block.getOps<IREE::Util::GlobalLoadOpInterface>()) {
+    auto it = parameters.find(loadOp.getGlobalName());
+    if (it == parameters.end()) {
+      continue;
+    }
+    ParameterUse use;
+    use.parameter = &it->second;
+    use.loadOp = loadOp;
+    use.consumers = findConsumers(loadOp, block, positions);
+    if (use.consumers.empty()) {
+      continue;
+    }
+    use.firstUse = positions[use.consumers.front()];
+    use.lastUse = positions[use.consumers.back()];
+    uses.push_back(std::move(use));
+  }
+  if (uses.empty()) {
+    return;
+  }
+  LLVM_DEBUG(llvm::dbgs() << "streaming " << uses.size()
+                          << " parameter uses through a ring of " << depth
+                          << " slots\n");
+
+  // Uses are streamed in the order they are needed. A use takes over the slot
+  // of the use |depth| before it once all of its consumers have completed.
+  // If the consumers of the two overlap the use gets its own slot instead.
+  llvm::stable_sort(uses, [](const ParameterUse &lhs, const ParameterUse &rhs) {
+    return lhs.firstUse < rhs.firstUse;
+  });
+  for (size_t i = 0; i < uses.size(); ++i) {
+    ParameterUse *gateUse = nullptr;
+    if (i >= static_cast<size_t>(depth) &&
+        uses[i - depth].lastUse < uses[i].firstUse) {
+      gateUse = &uses[i - depth];
+    }
+    streamParameterUse(uses[i], gateUse);
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// --iree-stream-schedule-weight-streaming
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct ScheduleWeightStreamingPass
+    : public IREE::Stream::impl::ScheduleWeightStreamingPassBase<
+          ScheduleWeightStreamingPass> {
+  using IREE::Stream::impl::ScheduleWeightStreamingPassBase<
+      ScheduleWeightStreamingPass>::ScheduleWeightStreamingPassBase;
+
+  void runOnOperation() override {
+    if (depth <= 0) {
+      return;
+    }
+    auto moduleOp = getOperation();
+
+    // Find all globals holding parameters loaded at initialization.
+    Explorer explorer(moduleOp, TraversalAction::SHALLOW);
+    explorer.initialize();
+    DenseMap<StringRef, StreamedParameter> parameters;
+    explorer.forEachGlobal([&](const Explorer::GlobalInfo *globalInfo) {
+      if (auto parameter = findStreamedParameter(globalInfo)) {
+        parameters[parameter->globalOp.getGlobalName().getValue()] =
+            *parameter;
+      }
+    });
+    if (parameters.empty()) {
+      return;
+    }
+
+    // Stream the uses in each block of the program. Initializers may run
+    // before the parameters are available and are left alone.
+    // NOTE: the ring is per block as the timepoints releasing slots would
+    // otherwise need to be threaded through branches and calls.
+    for (auto callableOp : moduleOp.getOps<mlir::CallableOpInterface>()) {
+      if (isa<IREE::Util::InitializerOp>(callableOp) ||
+          !callableOp.getCallableRegion()) {
+        continue;
+      }
+      SmallVector<Block *> blocks;
+      callableOp->walk([&](Block *block) { blocks.push_back(block); });
+      for (auto *block : blocks) {
+        streamParametersInBlock(*block, parameters, depth);
+      }
+    }
+
+    // Drop loads that are no longer used and the globals (and the loads of
+    // the parameters in the initializers) if nothing else needs them.
+    SmallVector<Operation *> deadOps;
+    moduleOp.walk([&](IREE::Util::GlobalLoadOpInterface loadOp) {
+      if (parameters.contains(loadOp.getGlobalName()) &&
+          loadOp->use_empty()) {
+        deadOps.push_back(loadOp);
+      }
+    });
+    for (auto *deadOp : deadOps) {
+      deadOp->erase();
+    }
+    for (auto &[name, parameter] : parameters) {
+      auto globalOp = parameter.globalOp;
+      auto uses = SymbolTable::getSymbolUses(globalOp, moduleOp);
+      if (!uses || llvm::any_of(*uses, [](const SymbolTable::SymbolUse &use) {
+            return !isa<IREE::Util::GlobalStoreOpInterface>(use.getUser());
+          })) {
+        continue;
+      }
+      for (auto &use : *uses) {
+        use.getUser()->erase();
+      }
+      globalOp.erase();
+    }
+  }
+};
+
+} // namespace
+
+} // namespace mlir::iree_compiler::IREE::Stream
@@ -257,3 +257,74 @@ util.func private @slice_dispatch_fold(%producer: !stream.resource<*>) -> !strea
   %consumer = stream.async.dispatch @ex::@dispatch(%c123_i32, %slice[%c10 to %c30 for %c20]) : (i32, !stream.resource<*>{%c100}) -> !stream.resource<*>{%c100}
   util.return %consumer : !stream.resource<*>
 }
+
+// -----
+
+// Tests that a copy of a loop-carried resource is elided when the loop passes
+// the last use along both the entry and back edges. This is the common
+// KV-cache update pattern where a global is updated in-place every step.
+
+util.global private mutable @cache : !stream.resource<variable>
+
+// CHECK-LABEL: @loopCarriedUpdate
+util.func public @loopCarriedUpdate(%update: !stream.resource<*>, %size: index, %count: index) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  // CHECK: %[[CACHE:.+]] = util.global.load @cache
+  %cache = util.global.load @cache : !stream.resource<variable>
+  // CHECK: %[[RESULT:.+]] = scf.for {{.+}} iter_args(%[[ARG:.+]] = %[[CACHE]])
+  %result = scf.for %i = %c0 to %count step %c1 iter_args(%arg = %cache) -> !stream.resource<variable> {
+    // CHECK-NOT: stream.async.clone
+    %clone = stream.async.clone %arg : !stream.resource<variable>{%size} -> !stream.resource<variable>{%size}
+    // CHECK: %[[UPDATED:.+]] = stream.async.update %{{.+}}, %[[ARG]]
+    %updated = stream.async.update %update, %clone[%c0 to %c128] : !stream.resource<*>{%c128} -> %clone as !stream.resource<variable>{%size}
+    // CHECK: scf.yield %[[UPDATED]]
+    scf.yield %updated : !stream.resource<variable>
+  }
+  // CHECK: util.global.store %[[RESULT]], @cache
+  util.global.store %result, @cache : !stream.resource<variable>
+  util.return
+}
+
+// -----
+
+// Tests that a copy of a loop-carried resource is preserved when the value
+// entering the loop is still used after the loop.
+
+// CHECK-LABEL: @loopCarriedUpdateLiveIn
+util.func public @loopCarriedUpdateLiveIn(%initial: !stream.resource<*>, %update: !stream.resource<*>, %size: index, %count: index) -> (!stream.resource<*>, !stream.resource<*>) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %c123_i32 = arith.constant 123 : i32
+  %splat = stream.async.splat %c123_i32 : i32 -> !stream.resource<*>{%size}
+  %result = scf.for %i = %c0 to %count step %c1 iter_args(%arg = %splat) -> !stream.resource<*> {
+    // CHECK: stream.async.clone
+    %clone = stream.async.clone %arg : !stream.resource<*>{%size} -> !stream.resource<*>{%size}
+    %updated = stream.async.update %update, %clone[%c0 to %c128] : !stream.resource<*>{%c128} -> %clone as !stream.resource<*>{%size}
+    scf.yield %updated : !stream.resource<*>
+  }
+  util.return %splat, %result : !stream.resource<*>, !stream.resource<*>
+}
+
+// -----
+
+// Tests that a copy of a loop-carried resource is preserved when the loop body
+// also captures the value entering the loop.
+
+// CHECK-LABEL: @loopCarriedUpdateCaptured
+util.func public @loopCarriedUpdateCaptured(%count: index) -> !stream.resource<*> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %c123_i32 = arith.constant 123 : i32
+  %splat = stream.async.splat %c123_i32 : i32 -> !stream.resource<*>{%c128}
+  %result = scf.for %i = %c0 to %count step %c1 iter_args(%arg = %splat) -> !stream.resource<*> {
+    // CHECK: stream.async.clone
+    %clone = stream.async.clone %arg : !stream.resource<*>{%c128} -> !stream.resource<*>{%c128}
+    %updated = stream.async.update %splat, %clone[%c0 to %c128] : !stream.resource<*>{%c128} -> %clone as !stream.resource<*>{%c128}
+    scf.yield %updated : !stream.resource<*>
+  }
+  util.return %result : !stream.resource<*>
+}
@@ -0,0 +1,50 @@
+// RUN: iree-opt --split-input-file --iree-stream-memory-budget=3584 --pass-pipeline='builtin.module(util.func(iree-stream-fit-memory-budget))' --verify-diagnostics %s | FileCheck %s
+
+// Tests that a dispatch reading only constants is recomputed before its last
+// use instead of being kept live while 4096 bytes would be live at once.
+
+// CHECK-LABEL: @rematerializeDispatch
+// CHECK-SAME: (%[[CONSTANT:.+]]: !stream.resource<constant>)
+util.func public @rematerializeDispatch(%constant: !stream.resource<constant>) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c256 = arith.constant 256 : index
+  %c1024 = arith.constant 1024 : index
+  %c2048 = arith.constant 2048 : index
+  // CHECK: %[[DECODE0:.+]] = stream.async.dispatch @ex::@decode[%c1](%[[CONSTANT]]
+  %decode = stream.async.dispatch @ex::@decode[%c1](%constant[%c0 to %c2048 for %c2048]) : (!stream.resource<constant>{%c2048}) -> !stream.resource<transient>{%c2048}
+  // CHECK: %[[USE0:.+]] = stream.async.dispatch @ex::@use0[%c1](%[[DECODE0]]
+  %use0 = stream.async.dispatch @ex::@use0[%c1](%decode[%c0 to %c2048 for %c2048]) : (!stream.resource<transient>{%c2048}) -> !stream.resource<transient>{%c1024}
+  // CHECK: %[[USE1:.+]] = stream.async.dispatch @ex::@use1[%c1](%[[USE0]]
+  %use1 = stream.async.dispatch @ex::@use1[%c1](%use0[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}) -> !stream.resource<transient>{%c1024}
+  // CHECK: %[[DECODE1:.+]] = stream.async.dispatch @ex::@decode[%c1](%[[CONSTANT]]
+  // CHECK: %[[USE2:.+]] = stream.async.dispatch @ex::@use2[%c1](%[[DECODE1]][{{.+}}], %[[USE1]]
+  %use2 = stream.async.dispatch @ex::@use2[%c1](%decode[%c0 to %c2048 for %c2048], %use1[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c2048}, !stream.resource<transient>{%c1024}) -> !stream.resource<external>{%c256}
+  // CHECK: util.return %[[USE2]]
+  util.return %use2 : !stream.resource<external>
+}
+
+// -----
+
+// Tests that producers reading resources that would otherwise be dead at the
+// next use are not rematerialized and that we warn about the budget.
+
+// CHECK-LABEL: @extendedOperand
+util.func public @extendedOperand(%input: !stream.resource<external>) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c256 = arith.constant 256 : index
+  %c1024 = arith.constant 1024 : index
+  %c2048 = arith.constant 2048 : index
+  %c4096 = arith.constant 4096 : index
+  // CHECK: stream.async.dispatch @ex::@produce
+  %produce = stream.async.dispatch @ex::@produce[%c1](%input[%c0 to %c256 for %c256]) : (!stream.resource<external>{%c256}) -> !stream.resource<transient>{%c1024}
+  // CHECK: stream.async.dispatch @ex::@decode
+  %decode = stream.async.dispatch @ex::@decode[%c1](%produce[%c0 to %c1024 for %c1024]) : (!stream.resource<transient>{%c1024}) -> !stream.resource<transient>{%c2048}
+  %large = stream.async.dispatch @ex::@large[%c1](%input[%c0 to %c256 for %c256]) : (!stream.resource<external>{%c256}) -> !stream.resource<transient>{%c4096}
+  // CHECK-NOT: stream.async.dispatch @ex::@decode
+  // CHECK: stream.async.dispatch @ex::@use
+  // expected-warning @+1 {{resources live here need 6400 bytes, more than the memory budget of 3584 bytes}}
+  %use = stream.async.dispatch @ex::@use[%c1](%decode[%c0 to %c2048 for %c2048], %large[%c0 to %c4096 for %c4096]) : (!stream.resource<transient>{%c2048}, !stream.resource<transient>{%c4096}) -> !stream.resource<external>{%c256}
+  util.return %use : !stream.resource<external>
+}
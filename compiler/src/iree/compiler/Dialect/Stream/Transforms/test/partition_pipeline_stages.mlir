@@ -0,0 +1,67 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(util.func(iree-stream-partition-pipeline-stages))' %s | FileCheck %s
+
+// Tests that stages are balanced by estimated cost: the first dispatch costs as
+// much as the rest together and gets a stage of its own. Its result is
+// transferred to the second stage.
+
+// CHECK-LABEL: @balancedByCost
+// CHECK-SAME: (%[[ARG:.+]]: !stream.resource<external>)
+util.func public @balancedByCost(%arg0: !stream.resource<external>) -> !stream.resource<external> attributes {
+  stream.pipeline_stages = [#hal.affinity.queue<[0]>, #hal.affinity.queue<[1]>]
+} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  // CHECK: %[[D0:.+]] = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_0
+  %0 = stream.async.dispatch @ex::@dispatch_0[%c1](%arg0[%c0 to %c64 for %c64]) {stream.cost = {compute = 6}} : (!stream.resource<external>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[T0:.+]] = stream.async.transfer %[[D0]] : !stream.resource<transient>{%c64} from(#hal.affinity.queue<[0]>) -> to(#hal.affinity.queue<[1]>) !stream.resource<transient>{%c64}
+  // CHECK: %[[D1:.+]] = stream.async.dispatch on(#hal.affinity.queue<[1]>) @ex::@dispatch_1[%c1](%[[T0]]
+  %1 = stream.async.dispatch @ex::@dispatch_1[%c1](%0[%c0 to %c64 for %c64]) {stream.cost = {compute = 1}} : (!stream.resource<transient>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[D2:.+]] = stream.async.dispatch on(#hal.affinity.queue<[1]>) @ex::@dispatch_2[%c1](%[[D1]]
+  %2 = stream.async.dispatch @ex::@dispatch_2[%c1](%1[%c0 to %c64 for %c64]) {stream.cost = {compute = 1}} : (!stream.resource<transient>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[D3:.+]] = stream.async.dispatch on(#hal.affinity.queue<[1]>) @ex::@dispatch_3[%c1](%[[D2]]
+  %3 = stream.async.dispatch @ex::@dispatch_3[%c1](%2[%c0 to %c64 for %c64]) {stream.cost = {compute = 1}} : (!stream.resource<transient>{%c64}) -> !stream.resource<external>{%c64}
+  // CHECK: util.return %[[D3]]
+  util.return %3 : !stream.resource<external>
+}
+
+// -----
+
+// Tests that without cost estimates the dispatches are split evenly, that ops
+// with an explicit affinity keep it and that functions without stages are left
+// alone.
+
+// CHECK-LABEL: @evenSplit
+util.func public @evenSplit(%arg0: !stream.resource<external>) -> !stream.resource<external> attributes {
+  stream.pipeline_stages = [#hal.affinity.queue<[0]>, #hal.affinity.queue<[1]>]
+} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  // CHECK: %[[D0:.+]] = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_0
+  %0 = stream.async.dispatch @ex::@dispatch_0[%c1](%arg0[%c0 to %c64 for %c64]) : (!stream.resource<external>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[T0:.+]] = stream.async.transfer %[[D0]] {{.+}} from(#hal.affinity.queue<[0]>) -> to(#hal.affinity.queue<[2]>)
+  // CHECK: %[[D1:.+]] = stream.async.dispatch on(#hal.affinity.queue<[2]>) @ex::@dispatch_1[%c1](%[[T0]]
+  %1 = stream.async.dispatch on(#hal.affinity.queue<[2]>) @ex::@dispatch_1[%c1](%0[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[T1:.+]] = stream.async.transfer %[[D1]] {{.+}} from(#hal.affinity.queue<[2]>) -> to(#hal.affinity.queue<[0]>)
+  // CHECK: %[[D2:.+]] = stream.async.dispatch on(#hal.affinity.queue<[0]>) @ex::@dispatch_2[%c1](%[[T1]]
+  %2 = stream.async.dispatch @ex::@dispatch_2[%c1](%1[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[T2:.+]] = stream.async.transfer %[[D2]] {{.+}} from(#hal.affinity.queue<[0]>) -> to(#hal.affinity.queue<[1]>)
+  // CHECK: %[[D3:.+]] = stream.async.dispatch on(#hal.affinity.queue<[1]>) @ex::@dispatch_3[%c1](%[[T2]]
+  %3 = stream.async.dispatch @ex::@dispatch_3[%c1](%2[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}) -> !stream.resource<transient>{%c64}
+  // CHECK: %[[D4:.+]] = stream.async.dispatch on(#hal.affinity.queue<[1]>) @ex::@dispatch_4[%c1](%[[D3]]
+  %4 = stream.async.dispatch @ex::@dispatch_4[%c1](%3[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}) -> !stream.resource<external>{%c64}
+  // CHECK: util.return %[[D4]]
+  util.return %4 : !stream.resource<external>
+}
+
+// CHECK-LABEL: @noStages
+util.func public @noStages(%arg0: !stream.resource<external>) -> !stream.resource<external> {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  // CHECK-NOT: stream.async.transfer
+  // CHECK: stream.async.dispatch @ex::@dispatch_0
+  %0 = stream.async.dispatch @ex::@dispatch_0[%c1](%arg0[%c0 to %c64 for %c64]) : (!stream.resource<external>{%c64}) -> !stream.resource<external>{%c64}
+  util.return %0 : !stream.resource<external>
+}
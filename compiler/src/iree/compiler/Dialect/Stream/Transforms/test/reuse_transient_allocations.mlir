@@ -0,0 +1,74 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(util.func(iree-stream-reuse-transient-allocations))' %s | FileCheck %s
+
+// Tests that the transients of two regions that are never live at the same
+// time are suballocated from one arena and that the second region waits for
+// the first to release the memory it may reuse.
+
+// CHECK-LABEL: @sequentialRegions
+// CHECK-SAME: (%[[AWAIT:.+]]: !stream.timepoint)
+util.func public @sequentialRegions(%await: !stream.timepoint) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c1024 = arith.constant 1024 : index
+  %c2048 = arith.constant 2048 : index
+  %c255_i32 = arith.constant 255 : i32
+  //     CHECK: arith.constant 255 : i32
+  // CHECK-DAG: %[[SIZE0:.+]] = arith.constant 1024 : index
+  // CHECK-DAG: %[[SIZE1:.+]] = arith.constant 2048 : index
+  //     CHECK: %[[PACK:.+]]:3 = stream.resource.pack slices({
+  // CHECK-NEXT:   [4, 6] = %[[SIZE0]],
+  // CHECK-NEXT:   [8, 10] = %[[SIZE1]]
+  // CHECK-NEXT: }) : index
+  //      CHECK: %[[ARENA:.+]], %[[ARENA_TIMEPOINT:.+]] = stream.resource.alloca uninitialized : !stream.resource<transient>{%[[PACK]]#0} => !stream.timepoint
+  //      CHECK: %[[READY0:.+]] = stream.timepoint.join max(%[[AWAIT]], %[[ARENA_TIMEPOINT]])
+  //      CHECK: %[[SUBVIEW0:.+]] = stream.resource.subview %[[ARENA]][%[[PACK]]#1] : !stream.resource<transient>{%[[PACK]]#0} -> !stream.resource<transient>{%c1024}
+  %alloca0:2 = stream.resource.alloca uninitialized await(%await) => !stream.resource<transient>{%c1024} => !stream.timepoint
+  // CHECK: %[[EXEC0:.+]] = stream.cmd.execute await(%[[READY0]]) => with(%[[SUBVIEW0]] as
+  %exec0 = stream.cmd.execute await(%alloca0#1) => with(%alloca0#0 as %capture0: !stream.resource<transient>{%c1024}) {
+    stream.cmd.fill %c255_i32, %capture0[%c0 for %c1024] : i32 -> !stream.resource<transient>{%c1024}
+  } => !stream.timepoint
+  // CHECK-NOT: stream.resource.dealloca
+  %dealloca0 = stream.resource.dealloca await(%exec0) => %alloca0#0 : !stream.resource<transient>{%c1024} => !stream.timepoint
+  // CHECK: %[[JOIN0:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC0]])
+  %join0 = stream.timepoint.join max(%dealloca0, %exec0) => !stream.timepoint
+  // CHECK: %[[READY1:.+]] = stream.timepoint.join max(%[[JOIN0]], %[[ARENA_TIMEPOINT]], %[[EXEC0]])
+  // CHECK: %[[SUBVIEW1:.+]] = stream.resource.subview %[[ARENA]][%[[PACK]]#2] : !stream.resource<transient>{%[[PACK]]#0} -> !stream.resource<transient>{%c2048}
+  %alloca1:2 = stream.resource.alloca uninitialized await(%join0) => !stream.resource<transient>{%c2048} => !stream.timepoint
+  // CHECK: %[[EXEC1:.+]] = stream.cmd.execute await(%[[READY1]]) => with(%[[SUBVIEW1]] as
+  %exec1 = stream.cmd.execute await(%alloca1#1) => with(%alloca1#0 as %capture1: !stream.resource<transient>{%c2048}) {
+    stream.cmd.fill %c255_i32, %capture1[%c0 for %c2048] : i32 -> !stream.resource<transient>{%c2048}
+  } => !stream.timepoint
+  // CHECK: %[[RELEASE:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[EXEC1]])
+  // CHECK: %[[DEALLOCA:.+]] = stream.resource.dealloca await(%[[RELEASE]]) => %[[ARENA]] : !stream.resource<transient>{%[[PACK]]#0} => !stream.timepoint
+  %dealloca1 = stream.resource.dealloca await(%exec1) => %alloca1#0 : !stream.resource<transient>{%c2048} => !stream.timepoint
+  // CHECK: %[[JOIN1:.+]] = stream.timepoint.join max(%[[DEALLOCA]], %[[EXEC1]])
+  %join1 = stream.timepoint.join max(%dealloca1, %exec1) => !stream.timepoint
+  // CHECK: util.return %[[JOIN1]]
+  util.return %join1 : !stream.timepoint
+}
+
+// -----
+
+// Tests that transients that are all live at the same time are left alone as
+// an arena would not reuse any memory.
+
+// CHECK-LABEL: @overlappingRegions
+util.func public @overlappingRegions(%await: !stream.timepoint) -> !stream.timepoint {
+  %c0 = arith.constant 0 : index
+  %c1024 = arith.constant 1024 : index
+  %c255_i32 = arith.constant 255 : i32
+  // CHECK-NOT: stream.resource.pack
+  // CHECK: stream.resource.alloca uninitialized await
+  %alloca0:2 = stream.resource.alloca uninitialized await(%await) => !stream.resource<transient>{%c1024} => !stream.timepoint
+  // CHECK: stream.resource.alloca uninitialized await
+  %alloca1:2 = stream.resource.alloca uninitialized await(%await) => !stream.resource<transient>{%c1024} => !stream.timepoint
+  %ready = stream.timepoint.join max(%alloca0#1, %alloca1#1) => !stream.timepoint
+  %exec = stream.cmd.execute await(%ready) => with(%alloca0#0 as %capture0: !stream.resource<transient>{%c1024}, %alloca1#0 as %capture1: !stream.resource<transient>{%c1024}) {
+    stream.cmd.copy %capture0[%c0], %capture1[%c0], %c1024 : !stream.resource<transient>{%c1024} -> !stream.resource<transient>{%c1024}
+  } => !stream.timepoint
+  // CHECK: stream.resource.dealloca
+  %dealloca0 = stream.resource.dealloca await(%exec) => %alloca0#0 : !stream.resource<transient>{%c1024} => !stream.timepoint
+  // CHECK: stream.resource.dealloca
+  %dealloca1 = stream.resource.dealloca await(%exec) => %alloca1#0 : !stream.resource<transient>{%c1024} => !stream.timepoint
+  %join = stream.timepoint.join max(%dealloca0, %dealloca1) => !stream.timepoint
+  util.return %join : !stream.timepoint
+}
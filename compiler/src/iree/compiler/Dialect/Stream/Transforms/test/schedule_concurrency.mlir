@@ -186,3 +186,60 @@ util.func public @groupCollectiveOps(%channel: !stream.channel, %send0: !stream.
   util.optimization_barrier %result#1 : !stream.resource<transient>
   util.return
 }
+
+// -----
+
+// Tests that waves are limited to max_wave_width ops and that the ops that
+// don't fit are placed in their own wave.
+
+// CHECK-LABEL: @partitioningWithMaxWaveWidth
+util.func public @partitioningWithMaxWaveWidth(%arg0: !stream.resource<external>) -> (!stream.resource<external>, !stream.resource<external>, !stream.resource<external>)
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency", max_wave_width = 2>} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  // CHECK: stream.async.execute
+  %results:3, %result_timepoint = stream.async.execute with(%arg0 as %arg1: !stream.resource<external>{%c20}) -> (!stream.resource<external>{%c20}, !stream.resource<external>{%c20}, !stream.resource<external>{%c20}) {
+    // CHECK-NOT: stream.async.concurrent
+    // CHECK: %[[DISPATCH0:.+]] = stream.async.dispatch @ex::@dispatch_0
+    %0 = stream.async.dispatch @ex::@dispatch_0[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK: %[[CON0:.+]]:2 = stream.async.concurrent
+    // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_1
+    %1 = stream.async.dispatch @ex::@dispatch_1[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK-NEXT: stream.async.dispatch @ex::@dispatch_2
+    %2 = stream.async.dispatch @ex::@dispatch_2[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK: stream.yield %[[DISPATCH0]], %[[CON0]]#0, %[[CON0]]#1
+    stream.yield %0, %1, %2 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %ready:3 = stream.timepoint.await %result_timepoint => %results#0, %results#1, %results#2 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  util.return %ready#0, %ready#1, %ready#2 : !stream.resource<external>, !stream.resource<external>, !stream.resource<external>
+}
+
+// -----
+
+// Tests that ops with estimated costs are placed into the wave they slow down
+// the least. Without costs the memory-bound @load would be sunk into the last
+// wave with the memory-bound @store; with them it runs alongside the
+// compute-bound @compute instead.
+
+// CHECK-LABEL: @partitioningWithCosts
+util.func public @partitioningWithCosts(%arg0: !stream.resource<external>) -> (!stream.resource<external>, !stream.resource<external>)
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  // CHECK: stream.async.execute
+  %results:2, %result_timepoint = stream.async.execute with(%arg0 as %arg1: !stream.resource<external>{%c20}) -> (!stream.resource<external>{%c20}, !stream.resource<external>{%c20}) {
+    // CHECK: %[[CON0:.+]]:2 = stream.async.concurrent
+    // CHECK-NEXT: stream.async.dispatch @ex::@load
+    %0 = stream.async.dispatch @ex::@load[%c1](%arg1[%c0 to %c20 for %c20]) {stream.cost = {compute = 1, memory = 10}} : (!stream.resource<external>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK-NEXT: stream.async.dispatch @ex::@compute
+    %1 = stream.async.dispatch @ex::@compute[%c1](%arg1[%c0 to %c20 for %c20]) {stream.cost = {compute = 10, memory = 1}} : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+    // CHECK: stream.async.dispatch @ex::@store[%c1](%[[CON0]]#1
+    %2 = stream.async.dispatch @ex::@store[%c1](%1[%c0 to %c20 for %c20]) {stream.cost = {compute = 1, memory = 10}} : (!stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK: stream.yield %[[CON0]]#0
+    stream.yield %0, %2 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %ready:2 = stream.timepoint.await %result_timepoint => %results#0, %results#1 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  util.return %ready#0, %ready#1 : !stream.resource<external>, !stream.resource<external>
+}
@@ -0,0 +1,29 @@
+// RUN: echo '{"version": 1, "exports": {"load": {"count": 1, "duration_ns": 100, "bytes": 1000}, "compute": {"count": 1, "duration_ns": 100, "bytes": 10}, "store": {"count": 1, "duration_ns": 100, "bytes": 1000}}}' > %t.json
+// RUN: iree-opt --iree-stream-cost-profile=%t.json --pass-pipeline="builtin.module(util.func(iree-stream-schedule-concurrency))" %s | FileCheck %s
+
+// Tests that dispatch durations measured by the runtime are used to balance
+// waves. @load and @store move the most bytes in the same time and are treated
+// as memory-bound so @load runs alongside the compute-bound @compute instead
+// of being sunk into the last wave with @store.
+
+// CHECK-LABEL: @partitioningWithProfile
+util.func public @partitioningWithProfile(%arg0: !stream.resource<external>) -> (!stream.resource<external>, !stream.resource<external>)
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  // CHECK: stream.async.execute
+  %results:2, %result_timepoint = stream.async.execute with(%arg0 as %arg1: !stream.resource<external>{%c20}) -> (!stream.resource<external>{%c20}, !stream.resource<external>{%c20}) {
+    // CHECK: %[[CON0:.+]]:2 = stream.async.concurrent
+    // CHECK-NEXT: stream.async.dispatch @ex::@load
+    %0 = stream.async.dispatch @ex::@load[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK-NEXT: stream.async.dispatch @ex::@compute
+    %1 = stream.async.dispatch @ex::@compute[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+    // CHECK: stream.async.dispatch @ex::@store[%c1](%[[CON0]]#1
+    %2 = stream.async.dispatch @ex::@store[%c1](%1[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+    // CHECK: stream.yield %[[CON0]]#0
+    stream.yield %0, %2 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %ready:2 = stream.timepoint.await %result_timepoint => %results#0, %results#1 : !stream.resource<external>{%c20}, !stream.resource<external>{%c20}
+  util.return %ready#0, %ready#1 : !stream.resource<external>, !stream.resource<external>
+}
@@ -0,0 +1,27 @@
+// RUN: echo '{"version": 1, "exports": {"compute": 1}}' > %t.json
+// RUN: iree-opt --iree-stream-cost-profile=%t.json --pass-pipeline="builtin.module(util.func(iree-stream-schedule-concurrency))" --verify-diagnostics %s | FileCheck %s
+
+// Tests that a malformed profile is reported on the first dispatch that would
+// have used it and that scheduling falls back to not knowing any costs.
+
+// CHECK-LABEL: @partitioningWithInvalidProfile
+util.func public @partitioningWithInvalidProfile(%arg0: !stream.resource<external>) -> !stream.resource<external>
+    attributes {stream.partitioning = #stream.partitioning_config<"max-concurrency">} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c20 = arith.constant 20 : index
+  // CHECK: stream.async.execute
+  %results, %result_timepoint = stream.async.execute with(%arg0 as %arg1: !stream.resource<external>{%c20}) -> !stream.resource<external>{%c20} {
+    // CHECK: stream.async.concurrent
+    // CHECK-NEXT: stream.async.dispatch @ex::@compute
+    // expected-warning @+1 {{ignoring stream cost profile}}
+    %0 = stream.async.dispatch @ex::@compute[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+    // CHECK-NEXT: stream.async.dispatch @ex::@compute
+    %1 = stream.async.dispatch @ex::@compute[%c1](%arg1[%c0 to %c20 for %c20]) : (!stream.resource<external>{%c20}) -> !stream.resource<transient>{%c20}
+    // CHECK: stream.async.dispatch @ex::@store
+    %2 = stream.async.dispatch @ex::@store[%c1](%0[%c0 to %c20 for %c20], %1[%c0 to %c20 for %c20]) : (!stream.resource<transient>{%c20}, !stream.resource<transient>{%c20}) -> !stream.resource<external>{%c20}
+    stream.yield %2 : !stream.resource<external>{%c20}
+  } => !stream.timepoint
+  %ready = stream.timepoint.await %result_timepoint => %results : !stream.resource<external>{%c20}
+  util.return %ready : !stream.resource<external>
+}
@@ -356,3 +356,44 @@ util.func public @scfRecurse(%arg0: !stream.resource<*>, %arg1: index, %arg2: in
   }
   util.return %sum, %arg1 : !stream.resource<*>, index
 }
+
+// -----
+
+// Tests that with async collectives the collective gets an execution region of
+// its own and that the independent dispatch is placed in a region that neither
+// the collective nor its producer waits on so that it can run while
+// communicating.
+
+// CHECK-LABEL: @asyncCollectives
+util.func public @asyncCollectives(%channel: !stream.channel, %arg0: !stream.resource<external>, %arg1: !stream.resource<external>) -> !stream.resource<external>
+    attributes {stream.partitioning = #stream.partitioning_config<"min-peak-memory", async_collectives>} {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c128 = arith.constant 128 : index
+  %c256 = arith.constant 256 : index
+  // CHECK: %[[SEND:.+]], %[[SEND_TP:.+]] = stream.async.execute
+  // CHECK-NEXT: stream.async.dispatch @ex::@producer
+  // CHECK-NOT: stream.async.dispatch
+  // CHECK: stream.yield
+  %send = stream.async.dispatch @ex::@producer[%c1, %c1, %c1](%arg0[%c0 to %c128 for %c128]) : (!stream.resource<external>{%c128}) -> !stream.resource<transient>{%c128}
+  // CHECK: %[[INDEPENDENT:.+]], %[[INDEPENDENT_TP:.+]] = stream.async.execute with(
+  // CHECK-NEXT: stream.async.dispatch @ex::@independent
+  // CHECK-NOT: stream.async.collective
+  // CHECK: stream.yield
+  %independent = stream.async.dispatch @ex::@independent[%c1, %c1, %c1](%arg1[%c0 to %c128 for %c128]) : (!stream.resource<external>{%c128}) -> !stream.resource<transient>{%c128}
+  // CHECK: %[[RECV:.+]], %[[RECV_TP:.+]] = stream.async.execute await(%[[SEND_TP]])
+  // CHECK-NEXT: stream.async.alloca
+  // CHECK-NEXT: stream.async.collective<all_gather : f32>
+  // CHECK-NOT: stream.async.dispatch
+  // CHECK: stream.yield
+  %recv_alloca = stream.async.alloca : !stream.resource<transient>{%c256}
+  %recv = stream.async.collective<all_gather : f32>[%c128] channel(%channel)
+      %send[%c0 to %c128 for %c128],
+      %recv_alloca[%c0 to %c256 for %c256] :
+      !stream.resource<transient>{%c128} -> %recv_alloca as !stream.resource<transient>{%c256}
+  // CHECK: %[[JOIN:.+]] = stream.timepoint.join max(%[[INDEPENDENT_TP]], %[[RECV_TP]])
+  // CHECK: stream.async.execute await(%[[JOIN]])
+  // CHECK-NEXT: stream.async.dispatch @ex::@consumer
+  %result = stream.async.dispatch @ex::@consumer[%c1, %c1, %c1](%recv[%c0 to %c256 for %c256], %independent[%c0 to %c128 for %c128]) : (!stream.resource<transient>{%c256}, !stream.resource<transient>{%c128}) -> !stream.resource<external>{%c128}
+  util.return %result : !stream.resource<external>
+}
@@ -0,0 +1,95 @@
+// RUN: iree-opt --split-input-file --pass-pipeline='builtin.module(iree-stream-schedule-weight-streaming{depth=2})' %s | FileCheck %s
+
+// Tests that the parameters of three layers are read into a ring of two
+// buffers right before they are used and that the third layer waits for the
+// buffer of the first to be released. The globals are dropped along with their
+// stores and the now unused initialization is left for cleanup.
+
+// CHECK-NOT: util.global private @layer
+util.global private @layer0 : !stream.resource<constant>
+util.global private @layer1 : !stream.resource<constant>
+util.global private @layer2 : !stream.resource<constant>
+// CHECK: util.initializer
+util.initializer {
+  %c64 = arith.constant 64 : index
+  %results:3, %result_timepoint = stream.async.execute with() -> (!stream.resource<constant>{%c64}, !stream.resource<constant>{%c64}, !stream.resource<constant>{%c64}) {
+    %0 = stream.async.constant : !stream.resource<constant>{%c64} = #stream.parameter.named<"model"::"layer0"> : tensor<16xf32>
+    %1 = stream.async.constant : !stream.resource<constant>{%c64} = #stream.parameter.named<"model"::"layer1"> : tensor<16xf32>
+    %2 = stream.async.constant : !stream.resource<constant>{%c64} = #stream.parameter.named<"model"::"layer2"> : tensor<16xf32>
+    stream.yield %0, %1, %2 : !stream.resource<constant>{%c64}, !stream.resource<constant>{%c64}, !stream.resource<constant>{%c64}
+  } => !stream.timepoint
+  %ready:3 = stream.timepoint.await %result_timepoint => %results#0, %results#1, %results#2 : !stream.resource<constant>{%c64}, !stream.resource<constant>{%c64}, !stream.resource<constant>{%c64}
+  // CHECK-NOT: util.global.store
+  util.global.store %ready#0, @layer0 : !stream.resource<constant>
+  util.global.store %ready#1, @layer1 : !stream.resource<constant>
+  util.global.store %ready#2, @layer2 : !stream.resource<constant>
+  util.return
+}
+
+// CHECK-LABEL: @layers
+// CHECK-SAME: (%[[INPUT:.+]]: !stream.resource<external>, %[[AWAIT:.+]]: !stream.timepoint)
+util.func public @layers(%input: !stream.resource<external>, %await: !stream.timepoint) -> (!stream.resource<transient>, !stream.timepoint) {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c64 = arith.constant 64 : index
+  // CHECK: %[[SLOT0:.+]], %[[ALLOCA0:.+]] = stream.resource.alloca uninitialized : !stream.resource<constant>{{.+}} => !stream.timepoint
+  // CHECK: %[[READ0:.+]] = stream.parameter.read await(%[[ALLOCA0]]) => "model"::"layer0"[%{{.+}}] -> %[[SLOT0]][%{{.+}} for %{{.+}}] : !stream.resource<constant>{{.+}} => !stream.timepoint
+  %layer0 = util.global.load @layer0 : !stream.resource<constant>
+  // CHECK: %[[SLOT1:.+]], %[[ALLOCA1:.+]] = stream.resource.alloca uninitialized : !stream.resource<constant>{{.+}} => !stream.timepoint
+  // CHECK: %[[READ1:.+]] = stream.parameter.read await(%[[ALLOCA1]]) => "model"::"layer1"
+  %layer1 = util.global.load @layer1 : !stream.resource<constant>
+  %layer2 = util.global.load @layer2 : !stream.resource<constant>
+  // CHECK-NOT: util.global.load
+  // CHECK: %[[WAIT0:.+]] = stream.timepoint.join max(%[[AWAIT]], %[[READ0]])
+  // CHECK: %[[RESULT0:.+]], %[[EXEC0:.+]] = stream.async.execute await(%[[WAIT0]]) => with(%[[INPUT]] as %{{.+}}: !stream.resource<external>{%c64}, %[[SLOT0]] as
+  %result0, %exec0 = stream.async.execute await(%await) => with(%input as %arg0: !stream.resource<external>{%c64}, %layer0 as %arg1: !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64} {
+    %0 = stream.async.dispatch @ex::@layer[%c1, %c1, %c1](%arg0[%c0 to %c64 for %c64], %arg1[%c0 to %c64 for %c64]) : (!stream.resource<external>{%c64}, !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64}
+    stream.yield %0 : !stream.resource<transient>{%c64}
+  } => !stream.timepoint
+  // CHECK: %[[RELEASE0:.+]] = stream.resource.dealloca await(%[[EXEC0]]) => %[[SLOT0]]
+  // CHECK: %[[SLOT2:.+]], %[[ALLOCA2:.+]] = stream.resource.alloca uninitialized await(%[[RELEASE0]]) => !stream.resource<constant>
+  // CHECK: %[[READ2:.+]] = stream.parameter.read await(%[[ALLOCA2]]) => "model"::"layer2"
+  // CHECK: %[[WAIT1:.+]] = stream.timepoint.join max(%[[EXEC0]], %[[READ1]])
+  // CHECK: %[[RESULT1:.+]], %[[EXEC1:.+]] = stream.async.execute await(%[[WAIT1]]) => with(%[[RESULT0]] as %{{.+}}: !stream.resource<transient>{%c64}, %[[SLOT1]] as
+  %result1, %exec1 = stream.async.execute await(%exec0) => with(%result0 as %arg0: !stream.resource<transient>{%c64}, %layer1 as %arg1: !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64} {
+    %0 = stream.async.dispatch @ex::@layer[%c1, %c1, %c1](%arg0[%c0 to %c64 for %c64], %arg1[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}, !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64}
+    stream.yield %0 : !stream.resource<transient>{%c64}
+  } => !stream.timepoint
+  // CHECK: stream.resource.dealloca await(%[[EXEC1]]) => %[[SLOT1]]
+  // CHECK: %[[WAIT2:.+]] = stream.timepoint.join max(%[[EXEC1]], %[[READ2]])
+  // CHECK: %[[RESULT2:.+]], %[[EXEC2:.+]] = stream.async.execute await(%[[WAIT2]]) => with(%[[RESULT1]] as %{{.+}}: !stream.resource<transient>{%c64}, %[[SLOT2]] as
+  %result2, %exec2 = stream.async.execute await(%exec1) => with(%result1 as %arg0: !stream.resource<transient>{%c64}, %layer2 as %arg1: !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64} {
+    %0 = stream.async.dispatch @ex::@layer[%c1, %c1, %c1](%arg0[%c0 to %c64 for %c64], %arg1[%c0 to %c64 for %c64]) : (!stream.resource<transient>{%c64}, !stream.resource<constant>{%c64}) -> !stream.resource<transient>{%c64}
+    stream.yield %0 : !stream.resource<transient>{%c64}
+  } => !stream.timepoint
+  // CHECK: stream.resource.dealloca await(%[[EXEC2]]) => %[[SLOT2]]
+  // CHECK: util.return %[[RESULT2]], %[[EXEC2]]
+  util.return %result2, %exec2 : !stream.resource<transient>, !stream.timepoint
+}
+
+// -----
+
+// Tests that parameters with uses other than execution regions stay resident.
+
+// CHECK: util.global private @weight
+util.global private @weight : !stream.resource<constant>
+util.initializer {
+  %c64 = arith.constant 64 : index
+  %result, %result_timepoint = stream.async.execute with() -> !stream.resource<constant>{%c64} {
+    %0 = stream.async.constant : !stream.resource<constant>{%c64} = #stream.parameter.named<"model"::"weight"> : tensor<16xf32>
+    stream.yield %0 : !stream.resource<constant>{%c64}
+  } => !stream.timepoint
+  %ready = stream.timepoint.await %result_timepoint => %result : !stream.resource<constant>{%c64}
+  // CHECK: util.global.store
+  util.global.store %ready, @weight : !stream.resource<constant>
+  util.return
+}
+
+// CHECK-LABEL: @escapingUse
+util.func public @escapingUse() -> !stream.resource<constant> {
+  // CHECK-NOT: stream.parameter.read
+  // CHECK: %[[WEIGHT:.+]] = util.global.load @weight
+  %weight = util.global.load @weight : !stream.resource<constant>
+  // CHECK: util.return %[[WEIGHT]]
+  util.return %weight : !stream.resource<constant>
+}
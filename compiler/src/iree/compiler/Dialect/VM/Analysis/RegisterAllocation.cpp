@@ -159,6 +159,22 @@ struct RegisterUsage {
     }
   }
 
+  // Allocates the specific register |reg| if all of its ordinals are unused.
+  // Returns false if the register is unavailable.
+  bool tryAllocateRegister(Register reg) {
+    int ordinalStart = reg.ordinal();
+    if (reg.isRef()) {
+      if (refRegisters.test(ordinalStart))
+        return false;
+    } else {
+      unsigned int ordinalEnd = ordinalStart + (reg.byteWidth() / 4) - 1;
+      if (intRegisters.find_first_in(ordinalStart, ordinalEnd + 1) != -1)
+        return false;
+    }
+    markRegisterUsed(reg);
+    return true;
+  }
+
   void releaseRegister(Register reg) {
     int ordinalStart = reg.ordinal();
     if (reg.isRef()) {
@@ -203,6 +219,45 @@ sortBlocksInDominanceOrder(IREE::VM::FuncOp funcOp) {
   return orderedBlocks;
 }
 
+// Returns true if |reg| is in the bank and of the width required by |type|.
+static bool isRegisterCompatible(Register reg, Type type) {
+  if (!type.isIntOrFloat())
+    return reg.isRef();
+  return reg.isValue() &&
+         reg.byteWidth() == IREE::Util::getRoundedElementByteWidth(type);
+}
+
+// Returns the values passed to |blockArg| by the branches of all predecessors.
+static SmallVector<Value> getIncomingValues(BlockArgument blockArg) {
+  SmallVector<Value> values;
+  Block *block = blockArg.getOwner();
+  for (auto it = block->pred_begin(); it != block->pred_end(); ++it) {
+    auto branchOp = dyn_cast<BranchOpInterface>((*it)->getTerminator());
+    if (!branchOp)
+      continue;
+    Value value = branchOp.getSuccessorOperands(
+        it.getSuccessorIndex())[blockArg.getArgNumber()];
+    if (value)
+      values.push_back(value);
+  }
+  return values;
+}
+
+// Returns the block arguments that |value| is passed to by branches.
+static SmallVector<BlockArgument> getOutgoingBlockArgs(Value value) {
+  SmallVector<BlockArgument> blockArgs;
+  for (auto &use : value.getUses()) {
+    auto branchOp = dyn_cast<BranchOpInterface>(use.getOwner());
+    if (!branchOp)
+      continue;
+    if (auto blockArg =
+            branchOp.getSuccessorBlockArgument(use.getOperandNumber())) {
+      blockArgs.push_back(*blockArg);
+    }
+  }
+  return blockArgs;
+}
+
 // NOTE: this is not a good algorithm, nor is it a good allocator. If you're
 // looking at this and have ideas of how to do this for real please feel
 // free to rip it all apart :)
@@ -212,6 +267,13 @@ sortBlocksInDominanceOrder(IREE::VM::FuncOp funcOp) {
 // ensure we are avoiding as many moves as possible. The special case we need to
 // handle is when values are not defined within the current block (as values in
 // dominators are allowed to cross block boundaries outside of arguments).
+//
+// To avoid most of the moves on branches block arguments and the values passed
+// to them are coalesced when possible: block arguments prefer the register of
+// a value passed by an already allocated predecessor and values passed to an
+// already allocated block argument (such as loop-carried values on back edges)
+// prefer the register of that argument. Both only apply if the register is free
+// so coalescing never extends the live range of any register.
 LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
   map_.clear();
 
@@ -238,8 +300,26 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
       registerUsage.markRegisterUsed(mapToRegister(liveInValue));
     }
 
-    // Allocate arguments first from left-to-right.
+    // Allocate arguments first from left-to-right. Arguments that can be
+    // coalesced with the register of an incoming value are allocated first so
+    // that arguments without a preference don't take the register.
     for (auto blockArg : block->getArguments()) {
+      for (auto incomingValue : getIncomingValues(blockArg)) {
+        auto it = map_.find(incomingValue);
+        if (it == map_.end() ||
+            !isRegisterCompatible(it->second, blockArg.getType())) {
+          continue;
+        }
+        auto reg = it->second.asBaseRegister();
+        if (registerUsage.tryAllocateRegister(reg)) {
+          map_[blockArg] = reg;
+          break;
+        }
+      }
+    }
+    for (auto blockArg : block->getArguments()) {
+      if (map_.count(blockArg))
+        continue;
       auto reg = registerUsage.allocateRegister(blockArg.getType());
       if (!reg.has_value()) {
         return funcOp.emitError() << "register allocation failed for block arg "
@@ -274,7 +354,23 @@ LogicalResult RegisterAllocation::recalculate(IREE::VM::FuncOp funcOp) {
         }
       }
       for (auto result : op.getResults()) {
-        auto reg = registerUsage.allocateRegister(result.getType());
+        // Prefer the register of an allocated block argument the result is
+        // passed to so that the branch doesn't need to move it.
+        std::optional<Register> reg;
+        for (auto blockArg : getOutgoingBlockArgs(result)) {
+          auto it = map_.find(blockArg);
+          if (it == map_.end() ||
+              !isRegisterCompatible(it->second, result.getType())) {
+            continue;
+          }
+          if (registerUsage.tryAllocateRegister(it->second)) {
+            reg = it->second;
+            break;
+          }
+        }
+        if (!reg.has_value()) {
+          reg = registerUsage.allocateRegister(result.getType());
+        }
         if (!reg.has_value()) {
           return op.emitError()
                  << "register allocation failed for result "
@@ -69,31 +69,53 @@ vm.module @module {
     vm.return %0 : i32
   }
 
-  // CHECK-LABEL: @branch_args_cycle
-  vm.func @branch_args_cycle(%arg0 : i32, %arg1 : i32) -> i32 {
+  // CHECK-LABEL: @branch_args_coalesced
+  vm.func @branch_args_coalesced(%arg0 : i32, %arg1 : i32) -> i32 {
     // CHECK: vm.br
     // CHECK-SAME: block_registers = ["i0", "i1"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i0->i2", "i1->i0", "i2->i1"]
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.br ^bb1(%arg1, %arg0 : i32, i32)
   ^bb1(%0 : i32, %1 : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0", "i1"]
+    // CHECK-SAME: block_registers = ["i1", "i0"]
     vm.return %0 : i32
   }
 
-  // CHECK-LABEL: @branch_args_cycle_64
-  vm.func @branch_args_cycle_64(%arg0 : i64, %arg1 : i64) -> i64 {
+  // CHECK-LABEL: @branch_args_cycle
+  vm.func @branch_args_cycle(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: vm.br
+    // CHECK-SAME: block_registers = ["i0", "i1"]
+    // CHECK-SAME: remap_registers = [
+    // CHECK-SAME:   []
+    // CHECK-SAME: ]
+    vm.br ^bb1(%arg0, %arg1 : i32, i32)
+  ^bb1(%0 : i32, %1 : i32):
+    // CHECK: vm.cond_br
+    // CHECK-SAME: block_registers = ["i0", "i1"]
+    // CHECK-SAME: remap_registers = [
+    // CHECK-SAME:   ["i0->i2", "i1->i0", "i2->i1"],
+    // CHECK-SAME:   []
+    // CHECK-SAME: ]
+    vm.cond_br %0, ^bb1(%1, %0 : i32, i32), ^bb2(%0 : i32)
+  ^bb2(%2 : i32):
+    // CHECK: vm.return
+    // CHECK-SAME: block_registers = ["i0"]
+    vm.return %2 : i32
+  }
+
+  // CHECK-LABEL: @branch_args_coalesced_64
+  vm.func @branch_args_coalesced_64(%arg0 : i64, %arg1 : i64) -> i64 {
     // CHECK: vm.br
     // CHECK-SAME: block_registers = ["i0+1", "i2+3"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i0+1->i4+5", "i2+3->i0+1", "i4+5->i2+3"]
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.br ^bb1(%arg1, %arg0 : i64, i64)
   ^bb1(%0 : i64, %1 : i64):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0+1", "i2+3"]
+    // CHECK-SAME: block_registers = ["i2+3", "i0+1"]
     vm.return %0 : i64
   }
 
@@ -102,26 +124,26 @@ vm.module @module {
     // CHECK: vm.br
     // CHECK-SAME: block_registers = ["i0", "i1", "i2"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i2->i3", "i0->i2", "i1->i0", "i3->i1"]
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.br ^bb1(%arg1, %arg2, %arg0 : i32, i32, i32)
   ^bb1(%0 : i32, %1 : i32, %2 : i32):
     // CHECK: vm.br
-    // CHECK-SAME: block_registers = ["i0", "i1", "i2"]
+    // CHECK-SAME: block_registers = ["i1", "i2", "i0"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i0->i3", "i2->i0", "i3->i2"]
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.br ^bb2(%2, %1, %0 : i32, i32, i32)
   ^bb2(%3 : i32, %4 : i32, %5 : i32):
     // CHECK: vm.br
-    // CHECK-SAME: block_registers = ["i0", "i1", "i2"]
+    // CHECK-SAME: block_registers = ["i0", "i2", "i1"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i0->i2", "i1->i0"]
+    // CHECK-SAME:   ["i2->i1"]
     // CHECK-SAME: ]
     vm.br ^bb3(%4, %4, %3 : i32, i32, i32)
   ^bb3(%6 : i32, %7 : i32, %8 : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0", "i1", "i2"]
+    // CHECK-SAME: block_registers = ["i2", "i1", "i0"]
     vm.return %6 : i32
   }
 
@@ -130,17 +152,17 @@ vm.module @module {
     // CHECK: vm.cond_br
     // CHECK-SAME: block_registers = ["i0", "i1", "i2"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i1->i0"],
-    // CHECK-SAME:   ["i2->i0"]
+    // CHECK-SAME:   [],
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.cond_br %arg0, ^bb1(%arg1 : i32), ^bb2(%arg2 : i32)
   ^bb1(%0 : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0"]
+    // CHECK-SAME: block_registers = ["i1"]
     vm.return %0 : i32
   ^bb2(%1 : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0"]
+    // CHECK-SAME: block_registers = ["i2"]
     vm.return %1 : i32
   }
 
@@ -149,17 +171,17 @@ vm.module @module {
     // CHECK: vm.cond_br
     // CHECK-SAME: block_registers = ["i0", "i1", "i2"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i1->i0", "i2->i1"],
-    // CHECK-SAME:   ["i0->i3", "i1->i0", "i3->i1"]
+    // CHECK-SAME:   [],
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.cond_br %arg0, ^bb1(%arg1, %arg2 : i32, i32), ^bb2(%arg1, %arg0 : i32, i32)
   ^bb1(%0 : i32, %1 : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0", "i1"]
+    // CHECK-SAME: block_registers = ["i1", "i2"]
     vm.return %0 : i32
   ^bb2(%2 : i32, %3 : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0", "i1"]
+    // CHECK-SAME: block_registers = ["i1", "i0"]
     vm.return %3 : i32
   }
 
@@ -168,17 +190,17 @@ vm.module @module {
     // CHECK: vm.cond_br
     // CHECK-SAME: block_registers = ["i0", "i2+3", "i4+5"]
     // CHECK-SAME: remap_registers = [
-    // CHECK-SAME:   ["i2+3->i0+1", "i4+5->i2+3"],
+    // CHECK-SAME:   [],
     // CHECK-SAME:   ["i2+3->i0+1"]
     // CHECK-SAME: ]
     vm.cond_br %arg0, ^bb1(%arg1, %arg2 : i64, i64), ^bb2(%arg1, %arg1 : i64, i64)
   ^bb1(%0 : i64, %1 : i64):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0+1", "i2+3"]
+    // CHECK-SAME: block_registers = ["i2+3", "i4+5"]
     vm.return %0 : i64
   ^bb2(%2 : i64, %3 : i64):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0+1", "i2+3"]
+    // CHECK-SAME: block_registers = ["i2+3", "i0+1"]
     vm.return %3 : i64
   }
 
@@ -210,12 +232,43 @@ vm.module @module {
     // CHECK: vm.cond_br
     // CHECK-SAME: remap_registers = [
     // CHECK-SAME:   [],
-    // CHECK-SAME:   ["i2->i0"]
+    // CHECK-SAME:   []
     // CHECK-SAME: ]
     vm.cond_br %cmp, ^loop(%in : i32), ^loop_exit(%in : i32)
   ^loop_exit(%ie : i32):
     // CHECK: vm.return
-    // CHECK-SAME: block_registers = ["i0"]
+    // CHECK-SAME: block_registers = ["i2"]
+    vm.return %ie : i32
+  }
+
+  // CHECK-LABEL: @loop_carried
+  vm.func @loop_carried(%arg0 : i32, %arg1 : i32) -> i32 {
+    // CHECK: vm.const.i32
+    // CHECK-SAME: block_registers = ["i0", "i1"]
+    // CHECK-SAME: result_registers = ["i2"]
+    %c1 = vm.const.i32 1
+    // CHECK: vm.br
+    // CHECK-SAME: remap_registers = [
+    // CHECK-SAME:   []
+    // CHECK-SAME: ]
+    vm.br ^loop(%arg1 : i32)
+  ^loop(%i : i32):
+    // CHECK: vm.add.i32
+    // CHECK-SAME: block_registers = ["i1"]
+    // CHECK-SAME: result_registers = ["i1"]
+    %in = vm.add.i32 %i, %c1 : i32
+    // CHECK: vm.cmp.lt.i32.s
+    // CHECK-SAME: result_registers = ["i0"]
+    %cmp = vm.cmp.lt.i32.s %in, %c1 : i32
+    // CHECK: vm.cond_br
+    // CHECK-SAME: remap_registers = [
+    // CHECK-SAME:   [],
+    // CHECK-SAME:   []
+    // CHECK-SAME: ]
+    vm.cond_br %cmp, ^loop(%in : i32), ^loop_exit(%in : i32)
+  ^loop_exit(%ie : i32):
+    // CHECK: vm.return
+    // CHECK-SAME: block_registers = ["i1"]
     vm.return %ie : i32
   }
 }
@@ -25,6 +25,7 @@
 #include "mlir/IR/Matchers.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/DialectConversion.h"
+#include "mlir/Transforms/RegionUtils.h"
 
 namespace mlir::iree_compiler {
 
@@ -4680,6 +4681,93 @@ namespace {
 //   (iir) -> (ri) => (iree_vm_stack_t*, module_t*, module_state_t*, int32_t,
 //                      int32_t, iree_vm_ref_t*, iree_vm_ref_t*, int32_t*) ->
 //                      iree_status_t
+/// Returns true if every return in |funcOp| yields `iree_ok_status()`.
+bool isInfallible(mlir::emitc::FuncOp funcOp) {
+  if (funcOp.isExternal() || funcOp.getFunctionType().getNumResults() != 1) {
+    return false;
+  }
+  WalkResult result = funcOp.walk([](mlir::emitc::ReturnOp returnOp) {
+    Value status = returnOp.getOperand();
+    auto statusOp =
+        status ? status.getDefiningOp<emitc::CallOpaqueOp>() : nullptr;
+    if (!statusOp || statusOp.getCallee() != "iree_ok_status") {
+      return WalkResult::interrupt();
+    }
+    return WalkResult::advance();
+  });
+  return !result.wasInterrupted();
+}
+
+/// Replaces the status check emitted by `returnIfError` after |callOp| with an
+/// unconditional branch to the continuation block. Returns false if the call
+/// result is not used in that form.
+bool elideStatusCheck(mlir::emitc::CallOp callOp) {
+  if (callOp.getNumResults() != 1 || !callOp.getResult(0).hasOneUse()) {
+    return false;
+  }
+  auto castOp =
+      dyn_cast<emitc::CastOp>(*callOp.getResult(0).getUsers().begin());
+  if (!castOp || !castOp.getResult().hasOneUse()) {
+    return false;
+  }
+  auto condBranchOp = dyn_cast<mlir::cf::CondBranchOp>(
+      *castOp.getResult().getUsers().begin());
+  if (!condBranchOp || condBranchOp.getCondition() != castOp.getResult()) {
+    return false;
+  }
+
+  // The condition is the negated status so the false destination is the
+  // continuation.
+  OpBuilder builder(condBranchOp);
+  builder.create<mlir::cf::BranchOp>(condBranchOp.getLoc(),
+                                     condBranchOp.getFalseDest(),
+                                     condBranchOp.getFalseDestOperands());
+  condBranchOp.erase();
+  castOp.erase();
+  return true;
+}
+
+/// Removes the status checks and failure paths of calls to internal functions
+/// that can only ever return `iree_ok_status()`. Leaf functions doing only
+/// arithmetic and control flow fall into this category and as their callers
+/// may in turn become infallible this iterates to a fixed point. The calling
+/// convention is left unchanged so that export shims keep working.
+void elideInfallibleCallChecks(IREE::VM::ModuleOp moduleOp) {
+  IRRewriter rewriter(moduleOp.getContext());
+  DenseSet<Operation *> infallibleFuncs;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    for (auto funcOp : moduleOp.getOps<mlir::emitc::FuncOp>()) {
+      if (!infallibleFuncs.contains(funcOp) && isInfallible(funcOp)) {
+        infallibleFuncs.insert(funcOp);
+        changed = true;
+      }
+    }
+
+    for (auto funcOp : moduleOp.getOps<mlir::emitc::FuncOp>()) {
+      SmallVector<mlir::emitc::CallOp> callOps;
+      funcOp.walk([&](mlir::emitc::CallOp callOp) {
+        auto calleeOp =
+            moduleOp.lookupSymbol<mlir::emitc::FuncOp>(callOp.getCallee());
+        if (calleeOp && infallibleFuncs.contains(calleeOp)) {
+          callOps.push_back(callOp);
+        }
+      });
+      bool funcChanged = false;
+      for (auto callOp : callOps) {
+        funcChanged |= elideStatusCheck(callOp);
+      }
+      if (funcChanged) {
+        // Drop the now unreachable failure blocks so that their returns don't
+        // keep the function from being considered infallible.
+        (void)eraseUnreachableBlocks(rewriter, funcOp->getRegions());
+        changed = true;
+      }
+    }
+  }
+}
+
 class ConvertVMToEmitCPass
     : public PassWrapper<ConvertVMToEmitCPass,
                          OperationPass<IREE::VM::ModuleOp>> {
@@ -4778,6 +4866,8 @@ public:
     if (failed(createModuleStructure(module, typeConverter))) {
       return signalPassFailure();
     }
+
+    elideInfallibleCallChecks(module);
   }
 };
 
@@ -141,6 +141,42 @@ vm.module @my_module {
 
 // -----
 
+// Test that status checks are elided on calls to internal functions that can't
+// fail and kept on calls to functions that can.
+vm.module @my_module {
+  vm.import private @imported_fn(%arg0 : i32) -> i32
+
+  vm.func @infallible_fn(%arg0 : i32) -> i32 {
+    vm.return %arg0 : i32
+  }
+
+  vm.func @fallible_fn(%arg0 : i32) -> i32 {
+    %0 = vm.call @imported_fn(%arg0) : (i32) -> i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: emitc.func private @my_module_call_infallible_fn
+  vm.func @call_infallible_fn(%arg0 : i32) -> i32 {
+    // CHECK: emitc.call @my_module_infallible_fn
+    // CHECK-NOT: cf.cond_br
+    // CHECK: %[[OK:.+]] = emitc.call_opaque "iree_ok_status"()
+    // CHECK-NEXT: return %[[OK]]
+    %0 = vm.call @infallible_fn(%arg0) : (i32) -> i32
+    vm.return %0 : i32
+  }
+
+  // CHECK-LABEL: emitc.func private @my_module_call_fallible_fn
+  vm.func @call_fallible_fn(%arg0 : i32) -> i32 {
+    // CHECK: %[[STATUS:.+]] = emitc.call @my_module_fallible_fn
+    // CHECK: %[[FAILED:.+]] = emitc.cast %[[STATUS]]
+    // CHECK-NEXT: cf.cond_br %[[FAILED]]
+    %0 = vm.call @fallible_fn(%arg0) : (i32) -> i32
+    vm.return %0 : i32
+  }
+}
+
+// -----
+
 // Test vm.call.variadic conversion on an imported function.
 vm.module @my_module {
   // CHECK: emitc.func private @my_module_call_[[VARIADICFN:[^\(]+]]
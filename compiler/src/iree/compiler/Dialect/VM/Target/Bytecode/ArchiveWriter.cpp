@@ -6,6 +6,8 @@
 
 #include "iree/compiler/Dialect/VM/Target/Bytecode/ArchiveWriter.h"
 
+#include <algorithm>
+
 #include "iree/compiler/Dialect/Util/IR/UtilTypes.h"
 #include "iree/schemas/bytecode_module_def_json_printer.h"
 #include "llvm/Support/CRC.h"
@@ -57,8 +59,9 @@ LogicalResult JSONArchiveWriter::flush(FlatbufferBuilder &fbb) {
 // FlatArchiveWriter
 //====---------------------------------------------------------------------===//
 
-FlatArchiveWriter::FlatArchiveWriter(Location loc, llvm::raw_ostream &os)
-    : loc(loc), os(os) {}
+FlatArchiveWriter::FlatArchiveWriter(Location loc, llvm::raw_ostream &os,
+                                     uint64_t pageAlignment)
+    : loc(loc), os(os), pageAlignment(pageAlignment) {}
 
 FlatArchiveWriter::~FlatArchiveWriter() { os.flush(); }
 
@@ -67,7 +70,8 @@ ArchiveWriter::File FlatArchiveWriter::declareFile(
     std::function<LogicalResult(llvm::raw_ostream &os)> write) {
   File file;
   file.fileName = std::move(fileName);
-  file.relativeOffset = IREE::Util::align(tailFileOffset, fileAlignment);
+  file.relativeOffset = IREE::Util::align(
+      tailFileOffset, std::max(fileAlignment, pageAlignment));
   tailFileOffset = file.relativeOffset + fileLength;
   file.fileLength = fileLength;
   file.write = std::move(write);
@@ -76,11 +80,36 @@ ArchiveWriter::File FlatArchiveWriter::declareFile(
 }
 
 LogicalResult FlatArchiveWriter::flush(FlatbufferBuilder &fbb) {
-  // Write the FlatBuffer contents out.
-  if (failed(fbb.copyToStream(os))) {
-    return mlir::emitError(loc)
-           << "failed to copy FlatBuffer emitter contents to the output stream "
-              "- possibly out of memory or storage";
+  if (pageAlignment > kArchiveSegmentAlignment) {
+    // Serialize the module FlatBuffer to memory so that we can extend its
+    // length prefix to end on a page boundary. The runtime places the rodata
+    // base immediately after the FlatBuffer and the relative file offsets are
+    // only page-aligned in the file if the base is.
+    std::string moduleData;
+    {
+      llvm::raw_string_ostream moduleStream(moduleData);
+      if (failed(fbb.copyToStream(moduleStream))) {
+        return mlir::emitError(loc)
+               << "failed to serialize FlatBuffer emitter "
+                  "contents to memory - possibly out of memory";
+      }
+      moduleStream.flush();
+    }
+    uint64_t bodyOffset = os.tell() + sizeof(flatbuffers_uoffset_t);
+    uint64_t bodyLength = moduleData.size() - sizeof(flatbuffers_uoffset_t);
+    auto paddedBodyLength = static_cast<flatbuffers_uoffset_t>(
+        IREE::Util::align(bodyOffset + bodyLength, pageAlignment) - bodyOffset);
+    os.write(reinterpret_cast<char *>(&paddedBodyLength),
+             sizeof(flatbuffers_uoffset_t));
+    os.write(moduleData.data() + sizeof(flatbuffers_uoffset_t), bodyLength);
+    os.write_zeros(paddedBodyLength - bodyLength);
+  } else {
+    // Write the FlatBuffer contents out.
+    if (failed(fbb.copyToStream(os))) {
+      return mlir::emitError(loc) << "failed to copy FlatBuffer emitter "
+                                     "contents to the output stream "
+                                     "- possibly out of memory or storage";
+    }
   }
 
   // Pad out to the start of the external rodata segment.
@@ -559,8 +588,9 @@ static void appendZIPCentralDirectory(ArrayRef<ZIPFileRef> fileRefs,
   os.write(reinterpret_cast<const char *>(&endOfCDR), sizeof(endOfCDR));
 }
 
-ZIPArchiveWriter::ZIPArchiveWriter(Location loc, llvm::raw_ostream &os)
-    : loc(loc), os(os) {}
+ZIPArchiveWriter::ZIPArchiveWriter(Location loc, llvm::raw_ostream &os,
+                                   uint64_t pageAlignment)
+    : loc(loc), os(os), pageAlignment(pageAlignment) {}
 
 ZIPArchiveWriter::~ZIPArchiveWriter() { os.flush(); }
 
@@ -579,8 +609,8 @@ ArchiveWriter::File ZIPArchiveWriter::declareFile(
   // Align the file offset; the header will be prepended.
   uint64_t headerOffset = tailFileOffset;
   uint64_t headerLength = computeMinHeaderLength(fileName);
-  uint64_t fileOffset =
-      IREE::Util::align(headerOffset + headerLength, fileAlignment);
+  uint64_t fileOffset = IREE::Util::align(
+      headerOffset + headerLength, std::max(fileAlignment, pageAlignment));
   tailFileOffset = fileOffset + fileLength;
 
   File file;
@@ -624,16 +654,27 @@ LogicalResult ZIPArchiveWriter::flush(FlatbufferBuilder &fbb) {
       IREE::Util::align(sizeof(flatbuffers_uoffset_t) + moduleData.size(),
                         kArchiveSegmentAlignment) -
       sizeof(flatbuffers_uoffset_t));
+  uint64_t moduleFileLength = paddedModuleLength;
+  if (pageAlignment > kArchiveSegmentAlignment) {
+    // Extend the length prefix so that the FlatBuffer ends on a page boundary
+    // and the rodata base that immediately follows it is page-aligned.
+    uint64_t bodyOffset =
+        startOffset + modulePadding + sizeof(flatbuffers_uoffset_t);
+    uint64_t bodyLength = moduleData.size() - sizeof(flatbuffers_uoffset_t);
+    paddedModuleLength = static_cast<flatbuffers_uoffset_t>(
+        IREE::Util::align(bodyOffset + bodyLength, pageAlignment) - bodyOffset);
+    moduleFileLength = sizeof(flatbuffers_uoffset_t) + paddedModuleLength;
+  }
 
   // Stream out the FlatBuffer contents.
   auto zipFile = appendZIPFile(
-      moduleName, modulePadding, paddedModuleLength,
+      moduleName, modulePadding, moduleFileLength,
       [&](llvm::raw_ostream &os) -> LogicalResult {
         os.write(reinterpret_cast<char *>(&paddedModuleLength),
                  sizeof(flatbuffers_uoffset_t));
         os.write(moduleData.data() + sizeof(flatbuffers_uoffset_t),
                  moduleData.size() - sizeof(flatbuffers_uoffset_t));
-        os.write_zeros(paddedModuleLength - moduleData.size());
+        os.write_zeros(moduleFileLength - moduleData.size());
         return success();
       },
       os);
@@ -77,18 +77,25 @@ private:
 // Flat file archive containing the FlatBuffer and trailing embedded files.
 // No additional metadata beyond that in the FlatBuffer is emitted.
 //
+// If a |pageAlignment| is provided the base of the rodata segment and every
+// declared file are aligned to it such that the files can be mapped directly
+// and have their pages shared between processes. The FlatBuffer length is
+// padded to cover the alignment as the runtime locates the rodata base
+// immediately following it.
+//
 // Archive structure:
 //   [4b flatbuffers_uoffset_t defining module FlatBuffer length]
 //   [module FlatBuffer contents]
-//   [zero padding to 64b alignment]
+//   [zero padding to 64b alignment (or page alignment)]
 //   <<rodata base offset>>
 //   [declared file 0]
-//   [zero padding to 64b alignment]
+//   [zero padding to 64b alignment (or page alignment)]
 //   [declared file 1]
 //   ...
 class FlatArchiveWriter : public ArchiveWriter {
 public:
-  explicit FlatArchiveWriter(Location loc, llvm::raw_ostream &os);
+  explicit FlatArchiveWriter(Location loc, llvm::raw_ostream &os,
+                             uint64_t pageAlignment = 0);
   ~FlatArchiveWriter() override;
   bool supportsFiles() override { return true; }
   File declareFile(
@@ -99,6 +106,7 @@ public:
 private:
   Location loc;
   llvm::raw_ostream &os;
+  uint64_t pageAlignment = 0;
   uint64_t tailFileOffset = 0; // unpadded
   SmallVector<File> files;
 };
@@ -109,6 +117,9 @@ private:
 // alignment requirements) and is mostly useful for debugging. Nothing in the
 // runtime requires this information.
 //
+// |pageAlignment| behaves as with FlatArchiveWriter and applies to the file
+// contents; the ZIP local file headers are placed in the padding before each.
+//
 // Archive structure:
 //  - [zip local file header for module]
 //    [4b flatbuffers_uoffset_t defining module FlatBuffer length]
@@ -123,7 +134,8 @@ private:
 //    [zip locators]
 class ZIPArchiveWriter : public ArchiveWriter {
 public:
-  explicit ZIPArchiveWriter(Location loc, llvm::raw_ostream &os);
+  explicit ZIPArchiveWriter(Location loc, llvm::raw_ostream &os,
+                            uint64_t pageAlignment = 0);
   ~ZIPArchiveWriter() override;
   bool supportsFiles() override { return true; }
   File declareFile(
@@ -134,6 +146,7 @@ public:
 private:
   Location loc;
   llvm::raw_ostream &os;
+  uint64_t pageAlignment = 0;
   uint64_t tailFileOffset = 0; // unpadded
   SmallVector<File> files;
 };
@@ -11,6 +11,7 @@
 #include "iree/compiler/Dialect/VM/IR/VMDialect.h"
 #include "iree/compiler/Dialect/VM/IR/VMTypes.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/TypeSwitch.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Diagnostics.h"
 
@@ -268,6 +269,33 @@ public:
     return success();
   }
 
+  // Encodes |cmpOp| and the |condBranchOp| consuming its result as a single
+  // fused |opcode|. The comparison result is not written to a register as the
+  // branch is its only user.
+  LogicalResult encodeFusedCondBranch(Operation *cmpOp,
+                                      IREE::VM::CondBranchOp condBranchOp,
+                                      Opcode opcode) {
+    if (failed(beginOp(cmpOp)) ||
+        failed(encodeOpcode("fused", static_cast<int>(opcode)))) {
+      return failure();
+    }
+    for (auto [ordinal, operand] : llvm::enumerate(cmpOp->getOperands())) {
+      if (failed(encodeOperand(operand, ordinal))) {
+        return failure();
+      }
+    }
+    if (failed(endOp(cmpOp)) || failed(beginOp(condBranchOp))) {
+      return failure();
+    }
+    if (failed(encodeBranch(condBranchOp.getTrueDest(),
+                            condBranchOp.getTrueDestOperands(), 0)) ||
+        failed(encodeBranch(condBranchOp.getFalseDest(),
+                            condBranchOp.getFalseDestOperands(), 1))) {
+      return failure();
+    }
+    return endOp(condBranchOp);
+  }
+
   std::optional<std::vector<uint8_t>> finish() {
     if (failed(fixupOffsets())) {
       return std::nullopt;
@@ -352,12 +380,35 @@ private:
   std::vector<std::pair<Block *, size_t>> blockOffsetFixups_;
 };
 
+// Returns the fused superinstruction opcode for |op| and the vm.cond_br
+// immediately following it if |op| is a comparison used only as the branch
+// condition.
+static std::optional<Opcode>
+matchFusedCondBranch(Operation &op, IREE::VM::CondBranchOp &condBranchOp) {
+  condBranchOp = dyn_cast_or_null<IREE::VM::CondBranchOp>(op.getNextNode());
+  if (!condBranchOp || op.getNumResults() != 1 ||
+      condBranchOp.getCondition() != op.getResult(0) ||
+      !op.getResult(0).hasOneUse()) {
+    return std::nullopt;
+  }
+  return llvm::TypeSwitch<Operation *, std::optional<Opcode>>(&op)
+      .Case([](IREE::VM::CmpEQI32Op) { return Opcode::CmpEQI32CondBranch; })
+      .Case([](IREE::VM::CmpNEI32Op) { return Opcode::CmpNEI32CondBranch; })
+      .Case(
+          [](IREE::VM::CmpLTI32SOp) { return Opcode::CmpLTI32SCondBranch; })
+      .Case(
+          [](IREE::VM::CmpLTI32UOp) { return Opcode::CmpLTI32UCondBranch; })
+      .Case([](IREE::VM::CmpNZRefOp) { return Opcode::CmpNZRefCondBranch; })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
 } // namespace
 
 // static
 std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
     IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase) {
+    SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+    bool emitFusedOps) {
   EncodedBytecodeFunction result;
 
   // Perform register allocation first so that we can quickly lookup values as
@@ -380,7 +431,24 @@ std::optional<EncodedBytecodeFunction> BytecodeEncoder::encodeFunction(
       return std::nullopt;
     }
 
-    for (auto &op : block.getOperations()) {
+    for (auto opIt = block.begin(); opIt != block.end(); ++opIt) {
+      Operation &op = *opIt;
+      IREE::VM::CondBranchOp condBranchOp;
+      if (emitFusedOps) {
+        if (auto opcode = matchFusedCondBranch(op, condBranchOp)) {
+          sourceMap.locations.push_back(
+              {static_cast<int32_t>(encoder.getOffset()), op.getLoc()});
+          if (failed(encoder.encodeFusedCondBranch(&op, condBranchOp,
+                                                   opcode.value()))) {
+            op.emitOpError() << "failed to encode fused with vm.cond_br";
+            return std::nullopt;
+          }
+          result.usesFusedOps = true;
+          ++opIt; // skip the fused vm.cond_br
+          continue;
+        }
+      }
+
       auto serializableOp = dyn_cast<IREE::VM::VMSerializableOp>(op);
       if (!serializableOp) {
         if (op.hasTrait<OpTrait::IREE::VM::AssignmentOp>()) {
@@ -28,6 +28,10 @@ struct EncodedBytecodeFunction {
   uint16_t i32RegisterCount = 0;
   // Total vm.ref register slots required for execution.
   uint16_t refRegisterCount = 0;
+
+  // True if any fused superinstructions were emitted requiring the runtime to
+  // support the FUSED_OPS feature.
+  bool usesFusedOps = false;
 };
 
 // Abstract encoder used for function bytecode encoding.
@@ -40,10 +44,13 @@ public:
   static constexpr uint32_t kVersion = (kVersionMajor << 16) | kVersionMinor;
 
   // Encodes a vm.func to bytecode and returns the result.
+  // When |emitFusedOps| is set common op sequences are encoded as fused
+  // superinstructions.
   // Returns None on failure.
   static std::optional<EncodedBytecodeFunction>
   encodeFunction(IREE::VM::FuncOp funcOp, llvm::DenseMap<Type, int> &typeTable,
-                 SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase);
+                 SymbolTable &symbolTable, DebugDatabaseBuilder &debugDatabase,
+                 bool emitFusedOps);
 
   BytecodeEncoder() = default;
   ~BytecodeEncoder() = default;
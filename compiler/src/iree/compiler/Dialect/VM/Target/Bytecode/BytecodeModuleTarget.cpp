@@ -28,6 +28,7 @@
 #include "llvm/Support/CRC.h"
 #include "llvm/Support/Endian.h"
 #include "llvm/Support/ErrorHandling.h"
+#include "llvm/Support/MathExtras.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/BuiltinOps.h"
 #include "mlir/IR/Diagnostics.h"
@@ -90,6 +91,41 @@ static StringRef mimeTypeToFileExtension(StringRef mimeType) {
       .Default(".bin");
 }
 
+// Returns all rodata referenced by the module initializer and the functions it
+// calls. This is the data (executables, initial constant values, etc) that is
+// touched while the module is being loaded.
+static DenseSet<Operation *>
+findInitializerRodataOps(IREE::VM::ModuleOp moduleOp) {
+  DenseSet<Operation *> rodataOps;
+  SymbolTable symbolTable(moduleOp);
+  auto initFuncOp = symbolTable.lookup<IREE::VM::FuncOp>("__init");
+  if (!initFuncOp) {
+    return rodataOps;
+  }
+  SmallVector<IREE::VM::FuncOp> worklist = {initFuncOp};
+  DenseSet<Operation *> visitedFuncOps;
+  while (!worklist.empty()) {
+    auto funcOp = worklist.pop_back_val();
+    if (!visitedFuncOps.insert(funcOp).second) {
+      continue;
+    }
+    funcOp.walk([&](Operation *op) {
+      if (auto rodataRefOp = dyn_cast<IREE::VM::ConstRefRodataOp>(op)) {
+        if (auto rodataOp = symbolTable.lookup<IREE::VM::RodataOp>(
+                rodataRefOp.getRodata())) {
+          rodataOps.insert(rodataOp);
+        }
+      } else if (auto callOp = dyn_cast<IREE::VM::CallOp>(op)) {
+        if (auto calleeOp =
+                symbolTable.lookup<IREE::VM::FuncOp>(callOp.getCallee())) {
+          worklist.push_back(calleeOp);
+        }
+      }
+    });
+  }
+  return rodataOps;
+}
+
 // Serializes a constant attribute to the FlatBuffer as a binary blob.
 // Returns the size in bytes of the serialized value and the FlatBuffers offset
 // to the uint8 vec containing the data.
@@ -348,11 +384,15 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
   size_t totalBytecodeLength = 0;
   for (auto [i, funcOp] : llvm::enumerate(internalFuncOps)) {
     auto encodedFunction = BytecodeEncoder::encodeFunction(
-        funcOp, typeOrdinalMap, symbolTable, debugDatabase);
+        funcOp, typeOrdinalMap, symbolTable, debugDatabase,
+        bytecodeOptions.emitFusedOps);
     if (!encodedFunction) {
       return funcOp.emitError() << "failed to encode function bytecode";
     }
     auto funcRequirements = findRequiredFeatures(funcOp);
+    if (encodedFunction->usesFusedOps) {
+      funcRequirements |= iree_vm_FeatureBits_FUSED_OPS;
+    }
     moduleRequirements |= funcRequirements;
     iree_vm_FunctionDescriptor_assign(
         &functionDescriptors[i], totalBytecodeLength,
@@ -525,6 +565,8 @@ buildFlatBufferModule(IREE::VM::TargetOptions vmOptions,
     allowedFeatures |= iree_vm_FeatureBits_EXT_F32;
   if (vmOptions.f64Extension)
     allowedFeatures |= iree_vm_FeatureBits_EXT_F64;
+  if (bytecodeOptions.emitFusedOps)
+    allowedFeatures |= iree_vm_FeatureBits_FUSED_OPS;
   if ((moduleRequirements & allowedFeatures) != moduleRequirements) {
     return moduleOp.emitError()
            << "module uses features not allowed by flags (requires "
@@ -603,16 +645,33 @@ translateModuleToBytecode(IREE::VM::ModuleOp moduleOp,
     return success();
   }
 
+  // Page alignment must be a power of two and when emitting ZIP files fit in
+  // the 16-bit extra field we use to pad local file headers.
+  if (bytecodeOptions.pageAlignment < 0 ||
+      (bytecodeOptions.pageAlignment &&
+       !llvm::isPowerOf2_64(bytecodeOptions.pageAlignment))) {
+    return moduleOp.emitError()
+           << "page alignment must be a power of two (got "
+           << bytecodeOptions.pageAlignment << ")";
+  }
+  uint64_t pageAlignment = static_cast<uint64_t>(bytecodeOptions.pageAlignment);
+  if (bytecodeOptions.emitPolyglotZip && pageAlignment > 32 * 1024) {
+    return moduleOp.emitError()
+           << "page alignment " << pageAlignment
+           << " exceeds the maximum of 32768 supported by polyglot ZIP "
+              "output; use --iree-vm-emit-polyglot-zip=false";
+  }
+
   // Set up the output archive builder based on output format.
   std::unique_ptr<ArchiveWriter> archiveWriter;
   if (bytecodeOptions.emitPolyglotZip &&
       bytecodeOptions.outputFormat == BytecodeOutputFormat::kFlatBufferBinary) {
-    archiveWriter =
-        std::make_unique<ZIPArchiveWriter>(moduleOp.getLoc(), output);
+    archiveWriter = std::make_unique<ZIPArchiveWriter>(moduleOp.getLoc(),
+                                                       output, pageAlignment);
   } else if (bytecodeOptions.outputFormat ==
              BytecodeOutputFormat::kFlatBufferBinary) {
-    archiveWriter =
-        std::make_unique<FlatArchiveWriter>(moduleOp.getLoc(), output);
+    archiveWriter = std::make_unique<FlatArchiveWriter>(moduleOp.getLoc(),
+                                                        output, pageAlignment);
   } else if (bytecodeOptions.outputFormat ==
              BytecodeOutputFormat::kFlatBufferText) {
     archiveWriter =
@@ -631,6 +690,16 @@ translateModuleToBytecode(IREE::VM::ModuleOp moduleOp,
   for (auto rodataOp : moduleOp.getOps<IREE::VM::RodataOp>()) {
     rodataOps[rodataOp.getOrdinal()->getLimitedValue()] = rodataOp;
   }
+  if (pageAlignment) {
+    // Files are laid out in declaration order so declaring the data used
+    // during initialization first keeps it together at the front of the file.
+    // Ordinals are unaffected.
+    auto initializerRodataOps = findInitializerRodataOps(moduleOp);
+    std::stable_partition(rodataOps.begin(), rodataOps.end(),
+                          [&](IREE::VM::RodataOp rodataOp) {
+                            return initializerRodataOps.contains(rodataOp);
+                          });
+  }
   SmallVector<RodataRef> rodataRefs;
   rodataRefs.resize(rodataOps.size());
   for (auto &rodataOp : rodataOps) {
@@ -732,12 +801,25 @@ void BytecodeTargetOptions::bindOptions(OptionsBinder &binder) {
   binder.opt<bool>("iree-vm-bytecode-module-strip-debug-ops", stripDebugOps,
                    llvm::cl::cat(vmBytecodeOptionsCategory),
                    llvm::cl::desc("Strips debug-only ops from the module"));
+  binder.opt<bool>(
+      "iree-vm-bytecode-module-emit-fused-ops", emitFusedOps,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc("Encodes common op sequences as fused superinstructions "
+                     "requiring runtime support for the FUSED_OPS feature"));
   binder.opt<bool>(
       "iree-vm-emit-polyglot-zip", emitPolyglotZip,
       llvm::cl::cat(vmBytecodeOptionsCategory),
       llvm::cl::desc(
           "Enables output files to be viewed as zip files for debugging "
           "(only applies to binary targets)"));
+  binder.opt<int64_t>(
+      "iree-vm-bytecode-module-page-alignment", pageAlignment,
+      llvm::cl::cat(vmBytecodeOptionsCategory),
+      llvm::cl::desc(
+          "Aligns embedded executables and large rodata to the given page "
+          "size in bytes (e.g. 4096) and places data used during module "
+          "initialization first so that mapped files can share pages between "
+          "processes (0 to disable)"));
 }
 
 } // namespace mlir::iree_compiler::IREE::VM
@@ -47,6 +47,10 @@ struct BytecodeTargetOptions {
   bool stripSourceMap = false;
   // Strips vm ops with the VM_DebugOnly trait.
   bool stripDebugOps = false;
+  // Encodes common op sequences (compare-and-branch, etc) as fused
+  // superinstructions. Modules using them require runtimes supporting the
+  // FUSED_OPS feature.
+  bool emitFusedOps = true;
 
   // Enables the output .vmfb to be inspected as a ZIP file.
   // This is useful for debugging/diagnosing issues as embedded executables can
@@ -54,6 +58,13 @@ struct BytecodeTargetOptions {
   // should be disabled in release builds.
   bool emitPolyglotZip = true;
 
+  // Aligns the embedded file segment and every embedded file (executables,
+  // large rodata, etc) to this many bytes and places data required during
+  // module initialization first. When the module is mapped from a file this
+  // allows pages to be shared between processes and keeps cold data out of
+  // the pages touched at startup. 0 uses the minimum archive alignment.
+  int64_t pageAlignment = 0;
+
   void bindOptions(OptionsBinder &binder);
   using FromFlags = OptionsFromFlags<BytecodeTargetOptions>;
 };
@@ -159,6 +159,23 @@ public:
   }
 };
 
+// Converts the vmvx.reduce op to an appropriate typed import.
+class ReduceOpConversion : public VMVXImportOpConversion<IREE::VMVX::ReduceOp> {
+public:
+  using VMVXImportOpConversion::VMVXImportOpConversion;
+
+  std::string getImportFqName(IREE::VMVX::ReduceOp op) const override {
+    int rank = op.getInStrides().size();
+    std::string name("vmvx.reduce.");
+    name.append(op.getOpcode().begin(), op.getOpcode().end());
+    name.append(".");
+    name.append(std::to_string(rank));
+    name.append("d.");
+    name.append(getTypedTypeStr(op.getElementType()));
+    return name;
+  }
+};
+
 class UnaryOpConversion : public VMVXImportOpConversion<IREE::VMVX::UnaryOp> {
 public:
   using VMVXImportOpConversion::VMVXImportOpConversion;
@@ -183,7 +200,8 @@ void populateVMVXToVMPatterns(MLIRContext *context,
                               SymbolTable &importSymbols,
                               RewritePatternSet &patterns) {
   patterns.insert<BinaryOpConversion, CopyOpConversion, Fill2DOpConversion,
-                  UnaryOpConversion>(context, importSymbols, typeConverter);
+                  ReduceOpConversion, UnaryOpConversion>(context, importSymbols,
+                                                         typeConverter);
 }
 
 } // namespace mlir::iree_compiler
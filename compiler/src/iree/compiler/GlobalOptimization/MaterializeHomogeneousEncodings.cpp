@@ -5,13 +5,16 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include "iree/compiler/Codegen/Common/CPU/Passes.h"
+#include "iree/compiler/Codegen/Common/GPU/Passes.h"
 #include "iree/compiler/Codegen/Common/Passes.h"
+#include "iree/compiler/Codegen/Utils/GPUUtils.h"
 #include "iree/compiler/Dialect/HAL/IR/HALDialect.h"
 #include "iree/compiler/Dialect/HAL/IR/HALOps.h"
 #include "iree/compiler/GlobalOptimization/PassDetail.h"
 #include "iree/compiler/GlobalOptimization/Passes.h"
 #include "iree/compiler/Utils/PassUtils.h"
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/Support/CommandLine.h"
 #include "llvm/Support/raw_ostream.h"
 #include "mlir/IR/Attributes.h"
 #include "mlir/IR/Builders.h"
@@ -25,6 +28,12 @@ namespace mlir::iree_compiler::GlobalOptimization {
 using FunctionLikeNest =
     MultiOpNest<IREE::Util::InitializerOp, IREE::Util::FuncOp>;
 
+static llvm::cl::opt<bool> clEnableGPUDataTiling(
+    "iree-global-opt-enable-gpu-data-tiling",
+    llvm::cl::desc("Materializes encodings into layouts matching the MMA "
+                   "intrinsics of GPU targets instead of dropping them."),
+    llvm::cl::init(false));
+
 class MaterializeHomogeneousEncodingsPass
     : public MaterializeHomogeneousEncodingsBase<
           MaterializeHomogeneousEncodingsPass> {
@@ -44,6 +53,18 @@ public:
     }
   }
 
+  void runGPUPipeline(ModuleOp &moduleOp,
+                      IREE::HAL::ExecutableTargetAttr executableTarget) {
+    OpPassManager passManager(moduleOp.getOperationName());
+    FunctionLikeNest(passManager).addPass([&]() {
+      return createGPUMaterializeDeviceEncodingPass(executableTarget);
+    });
+    FunctionLikeNest(passManager).addPass(createCanonicalizerPass);
+    if (failed(runPipeline(passManager, moduleOp))) {
+      return signalPassFailure();
+    }
+  }
+
   void runOnOperation() override {
     auto moduleOp = getOperation();
     auto executableTargets =
@@ -59,6 +80,12 @@ public:
       return;
     }
 
+    // GPU targets tile for the MMA intrinsics they list, if any.
+    if (clEnableGPUDataTiling &&
+        succeeded(getSupportedMmaTypes(executableTarget.getConfiguration()))) {
+      return runGPUPipeline(moduleOp, executableTarget);
+    }
+
     // Only llvm-cpu backends handle encodings for now, others just go with nop.
     if (executableTarget.getBackend() != "llvm-cpu") {
       return runNopPipeline(moduleOp);
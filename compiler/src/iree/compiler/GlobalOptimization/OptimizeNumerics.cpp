@@ -157,6 +157,88 @@ struct LinalgFillCast
   }
 };
 
+// Low precision operand and accumulator types selected for a contraction
+// whose operands carry narrowing annotations.
+struct LowPContractionTypes {
+  bool isSigned;
+  Type lhsType;
+  Type rhsType;
+  Type accumType;
+};
+
+// Selects the integer types that a floating point contraction on |lhsParams|
+// and |rhsParams| accumulating into |accumParams| can be performed in. When
+// |requireSigned| is set, unsigned operands are widened so that the
+// contraction can be done entirely in signed arithmetic (for ops like
+// convolutions which have no unsigned variant).
+FailureOr<LowPContractionTypes>
+selectLowPContractionTypes(Operation *op, NarrowParams &lhsParams,
+                           NarrowParams &rhsParams, NarrowParams &accumParams,
+                           bool requireSigned, PatternRewriter &rewriter) {
+  // TODO(#7987): This could be more flexible, allowing mix and match
+  // integer/float types.
+  if (!lhsParams.isFromFloat() || !rhsParams.isFromFloat()) {
+    return rewriter.notifyMatchFailure(op, "not from floating point");
+  }
+
+  // TODO(#7987): Could support partial conversion to integer.
+  if (!lhsParams.isToInteger() || !rhsParams.isToInteger() ||
+      !accumParams.isToInteger()) {
+    return rewriter.notifyMatchFailure(op, "not to an integer type");
+  }
+
+  int lhsBitWidth = lhsParams.getToBitWidth();
+  int rhsBitWidth = rhsParams.getToBitWidth();
+
+  // Handle signed/unsigned mismatch.
+  // TODO(#7987): Implement a proper unsigned->signed widening.
+  bool isSigned;
+  if (requireSigned || lhsParams.isToSigned() != rhsParams.isToSigned()) {
+    // Mixed signed/unsigned. Promote to signed.
+    isSigned = true;
+    if (!lhsParams.isToSigned()) {
+      lhsBitWidth += 1;
+    }
+    if (!rhsParams.isToSigned()) {
+      rhsBitWidth += 1;
+    }
+  } else {
+    // Uniform signed/unsigned.
+    isSigned = lhsParams.isToSigned();
+  }
+
+  // Round up to a suitable POT width.
+  lhsBitWidth = getNextPotBitWidth(lhsBitWidth);
+  rhsBitWidth = getNextPotBitWidth(rhsBitWidth);
+
+  // Promote accumulator to match signedness.
+  int accumBitWidth = accumParams.getToBitWidth();
+  if (isSigned && !accumParams.isToSigned()) {
+    // TODO(#7987): A proper unsigned widening based on range.
+    accumBitWidth += 1;
+  }
+
+  // Determine an appropriate accumulator size.
+  // TODO(#7987): Apply the clamp of:
+  // lhsBitWidth + rhsBitWidth + log2_ceil(contraction_dim + 1) to determine
+  // the accumulator size. Note: Can drop the +1 if one of lhs/rhs is signed
+  // and symmetric (i.e. does not use the asymmetric lower bound).
+  if (lhsBitWidth > 8 || rhsBitWidth > 8) {
+    return rewriter.notifyMatchFailure(op, "outside of low-p range");
+  }
+  accumBitWidth = getNextPotBitWidth(accumBitWidth, 32);
+  if (accumBitWidth > 32) {
+    return rewriter.notifyMatchFailure(op, "accumulator > 32 bits");
+  }
+
+  LowPContractionTypes types;
+  types.isSigned = isSigned;
+  types.lhsType = makeLowPType(lhsParams.fromType, lhsBitWidth);
+  types.rhsType = makeLowPType(rhsParams.fromType, rhsBitWidth);
+  types.accumType = makeLowPType(accumParams.fromType, accumBitWidth);
+  return types;
+}
+
 // For narrowable inputs, selects
 struct LinalgFpMatmulToLowP : public OpRewritePattern<linalg::MatmulOp> {
   using OpRewritePattern::OpRewritePattern;
@@ -171,74 +253,21 @@ struct LinalgFpMatmulToLowP : public OpRewritePattern<linalg::MatmulOp> {
     if (!lhsParams || !rhsParams || !accumParams) {
       return rewriter.notifyMatchFailure(matmulOp, "no narrowing annotations");
     }
-
-    // TODO(#7987): This could be more flexible, allowing mix and match
-    // integer/float types.
-    if (!lhsParams->isFromFloat() || !rhsParams->isFromFloat()) {
-      return rewriter.notifyMatchFailure(matmulOp, "not from floating point");
-    }
-
-    // TODO(#7987): Could support partial conversion to integer.
-    if (!lhsParams->isToInteger() || !rhsParams->isToInteger() ||
-        !accumParams->isToInteger()) {
-      return rewriter.notifyMatchFailure(matmulOp, "not to an integer type");
-    }
-
-    int lhsBitWidth = lhsParams->getToBitWidth();
-    int rhsBitWidth = rhsParams->getToBitWidth();
-
-    // Handle signed/unsigned mismatch.
-    // TODO(#7987): Implement a proper unsigned->signed widening.
-    bool isSigned;
-    if (lhsParams->isToSigned() != rhsParams->isToSigned()) {
-      // Mixed signed/unsigned. Promote to signed.
-      isSigned = true;
-      if (!lhsParams->isToSigned()) {
-        lhsBitWidth += 1;
-      }
-      if (!rhsParams->isToSigned()) {
-        rhsBitWidth += 1;
-      }
-    } else {
-      // Uniform signed/unsigned.
-      isSigned = lhsParams->isToSigned();
-    }
-
-    // Round up to a suitable POT width.
-    lhsBitWidth = getNextPotBitWidth(lhsBitWidth);
-    rhsBitWidth = getNextPotBitWidth(rhsBitWidth);
-
-    // Promote accumulator to match signedness.
-    int accumBitWidth = accumParams->getToBitWidth();
-    if (isSigned && !accumParams->isToSigned()) {
-      // TODO(#7987): A proper unsigned widening based on range.
-      accumBitWidth += 1;
-    }
-
-    // Determine an appropriate accumulator size.
-    // TODO(#7987): Apply the clamp of:
-    // lhsBitWidth + rhsBitWidth + log2_ceil(contraction_dim + 1) to determine
-    // the accumulator size. Note: Can drop the +1 if one of lhs/rhs is signed
-    // and symmetric (i.e. does not use the asymmetric lower bound).
-    if (lhsBitWidth > 8 || rhsBitWidth > 8) {
-      return rewriter.notifyMatchFailure(matmulOp, "outside of low-p range");
-    }
-    accumBitWidth = getNextPotBitWidth(accumBitWidth, 32);
-    if (accumBitWidth > 32) {
-      return rewriter.notifyMatchFailure(matmulOp, "accumulator > 32 bits");
+    FailureOr<LowPContractionTypes> types = selectLowPContractionTypes(
+        matmulOp, *lhsParams, *rhsParams, *accumParams,
+        /*requireSigned=*/false, rewriter);
+    if (failed(types)) {
+      return failure();
     }
-
-    Type lhsLowPType = makeLowPType(lhsParams->fromType, lhsBitWidth);
-    Type rhsLowPType = makeLowPType(rhsParams->fromType, rhsBitWidth);
-    Type accumLowPType = makeLowPType(accumParams->fromType, accumBitWidth);
+    bool isSigned = types->isSigned;
 
     // Replace the matmul op.
     Value newLhs =
-        castNumeric(lhsParams->producer, lhsLowPType, isSigned, rewriter);
+        castNumeric(lhsParams->producer, types->lhsType, isSigned, rewriter);
     Value newRhs =
-        castNumeric(rhsParams->producer, rhsLowPType, isSigned, rewriter);
-    Value newAccum =
-        castNumeric(accumParams->producer, accumLowPType, isSigned, rewriter);
+        castNumeric(rhsParams->producer, types->rhsType, isSigned, rewriter);
+    Value newAccum = castNumeric(accumParams->producer, types->accumType,
+                                 isSigned, rewriter);
     Value newResult;
 
     if (isSigned) {
@@ -261,6 +290,50 @@ struct LinalgFpMatmulToLowP : public OpRewritePattern<linalg::MatmulOp> {
   }
 };
 
+// Same as LinalgFpMatmulToLowP but for 2-D convolutions. Named convolutions
+// always sign extend their operands so the contraction is done in signed
+// integers.
+template <typename ConvOpTy>
+struct LinalgFpConvToLowP : public OpRewritePattern<ConvOpTy> {
+  using OpRewritePattern<ConvOpTy>::OpRewritePattern;
+
+  LogicalResult matchAndRewrite(ConvOpTy convOp,
+                                PatternRewriter &rewriter) const override {
+    Location loc = convOp.getLoc();
+    Type origResultType = convOp.getResult(0).getType();
+    auto lhsParams = NarrowParams::forValue(convOp.getInputs()[0]);
+    auto rhsParams = NarrowParams::forValue(convOp.getInputs()[1]);
+    auto accumParams = NarrowParams::forValue(convOp.getOutputs()[0]);
+    if (!lhsParams || !rhsParams || !accumParams) {
+      return rewriter.notifyMatchFailure(convOp, "no narrowing annotations");
+    }
+    FailureOr<LowPContractionTypes> types = selectLowPContractionTypes(
+        convOp, *lhsParams, *rhsParams, *accumParams,
+        /*requireSigned=*/true, rewriter);
+    if (failed(types)) {
+      return failure();
+    }
+
+    Value newLhs = castNumeric(lhsParams->producer, types->lhsType,
+                               /*isSigned=*/true, rewriter);
+    Value newRhs = castNumeric(rhsParams->producer, types->rhsType,
+                               /*isSigned=*/true, rewriter);
+    Value newAccum = castNumeric(accumParams->producer, types->accumType,
+                                 /*isSigned=*/true, rewriter);
+    Value newResult =
+        rewriter
+            .create<ConvOpTy>(loc, types->accumType,
+                              ValueRange{newLhs, newRhs}, ValueRange{newAccum},
+                              convOp.getStrides(), convOp.getDilations())
+            .getResult(0);
+
+    newResult =
+        castNumeric(newResult, origResultType, /*isSigned=*/true, rewriter);
+    rewriter.replaceOp(convOp, ValueRange{newResult});
+    return success();
+  }
+};
+
 class OptimizeNumericsPass : public OptimizeNumericsBase<OptimizeNumericsPass> {
   void runOnOperation() override {
     MLIRContext *context = &getContext();
@@ -268,6 +341,8 @@ class OptimizeNumericsPass : public OptimizeNumericsBase<OptimizeNumericsPass> {
 
     // Precision reduction.
     patterns.insert<LinalgFpMatmulToLowP>(context);
+    patterns.insert<LinalgFpConvToLowP<linalg::Conv2DNhwcHwcfOp>,
+                    LinalgFpConvToLowP<linalg::Conv2DNchwFchwOp>>(context);
 
     // Cast propagation.
     patterns.insert<TensorEmptyCast>(context);
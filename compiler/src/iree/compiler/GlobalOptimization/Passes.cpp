@@ -79,6 +79,9 @@ void buildGlobalOptimizationPassPipeline(
     importParametersOptions.keys = transformOptions.options.parameterImportKeys;
     importParametersOptions.maximumSize =
         transformOptions.options.parameterImportMaximumSize;
+    importParametersOptions.retainReferences =
+        transformOptions.options.parameterExportDerived &&
+        !transformOptions.options.parameterExportPath.empty();
     mainPassManager.addPass(IREE::IO::Parameters::createImportParametersPass(
         importParametersOptions));
   }
@@ -24,6 +24,7 @@
 #include "mlir/Dialect/Linalg/Utils/Utils.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
 #include "mlir/Dialect/Utils/IndexingUtils.h"
+#include "mlir/IR/Matchers.h"
 #include "mlir/IR/PatternMatch.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Transforms/GreedyPatternRewriteDriver.h"
@@ -632,24 +633,53 @@ private:
   bool allowGeneralizing = false;
 };
 
-bool isUnaryElementwiseGeneric(linalg::GenericOp genericOp) {
-  if (genericOp.getNumDpsInputs() != 1 || genericOp.getNumDpsInputs() != 1 ||
+// Returns true if transposing |value| has no runtime cost because the
+// transpose is folded into a constant or hoisted into an initializer along
+// with the load of an immutable global (e.g. a weight).
+static bool isFreeToTranspose(Value value) {
+  if (matchPattern(value, m_Constant())) {
+    return true;
+  }
+  auto loadOp = value.getDefiningOp<IREE::Util::GlobalLoadOpInterface>();
+  return loadOp && loadOp.isGlobalImmutable();
+}
+
+// Returns the input of an elementwise generic through which a transpose can be
+// propagated, or nullptr if there is none. All inputs must share the indexing
+// map of the single result, and all inputs other than the returned one must
+// be free to transpose so that propagating does not add any runtime
+// transposes. For unary elementwise ops this is the only input.
+static OpOperand *getPropagatableElementwiseInput(linalg::GenericOp genericOp) {
+  if (genericOp.getNumDpsInputs() < 1 || genericOp.getNumDpsInits() != 1 ||
       !linalg::isElementwise(genericOp)) {
-    return false;
+    return nullptr;
   }
 
   // Skip transposes and broadcasts. Transposes make more sense to fuse
   // rather than propagate through, and broadcasts are cheaper to transpose
   // before broadcasting.
-  if (genericOp.getMatchingIndexingMap(genericOp.getDpsInputOperand(0)) !=
-      genericOp.getMatchingIndexingMap(genericOp.getDpsInitOperand(0))) {
-    return false;
+  AffineMap initMap =
+      genericOp.getMatchingIndexingMap(genericOp.getDpsInitOperand(0));
+  OpOperand *propagatableInput = nullptr;
+  for (OpOperand *input : genericOp.getDpsInputOperands()) {
+    if (genericOp.getMatchingIndexingMap(input) != initMap) {
+      return nullptr;
+    }
+    if (genericOp.getNumDpsInputs() > 1 && isFreeToTranspose(input->get())) {
+      continue;
+    }
+    if (propagatableInput) {
+      return nullptr;
+    }
+    propagatableInput = input;
   }
-  return true;
+  return propagatableInput;
 }
 
-// Sinks a transpose through the input of a unary elementwise operation.
-class SinkTransposeThroughUnaryElementwiseInput
+// Sinks a transpose through the input of an elementwise operation. Any other
+// inputs are constant and are transposed into the layout of the transpose
+// input.
+class SinkTransposeThroughElementwiseInput
     : public OpRewritePattern<linalg::GenericOp> {
 public:
   using OpRewritePattern<linalg::GenericOp>::OpRewritePattern;
@@ -660,12 +690,12 @@ public:
       return failure();
     }
 
-    if (!isUnaryElementwiseGeneric(genericOp)) {
-      return rewriter.notifyMatchFailure(genericOp, "not unary elementwise");
+    OpOperand *input = getPropagatableElementwiseInput(genericOp);
+    if (!input) {
+      return rewriter.notifyMatchFailure(genericOp, "not elementwise");
     }
 
-    auto transposeOp =
-        genericOp.getDpsInputs()[0].getDefiningOp<linalg::TransposeOp>();
+    auto transposeOp = input->get().getDefiningOp<linalg::TransposeOp>();
     if (!transposeOp) {
       return rewriter.notifyMatchFailure(genericOp, "no transpose operand");
     }
@@ -682,19 +712,27 @@ public:
     Value newInit =
         createTransposeInit(rewriter, genericOp.getDpsInits()[0], invPerm);
 
-    // We do not need to update indexing maps because this is a unary
-    // elementwise op where the input and output maps are the same. Just
-    // replace the operands with transposed variants.
-    auto newGenericOp = mlir::clone(rewriter, genericOp, newInit.getType(),
-                                    {transposeOp.getInput(), newInit});
+    // We do not need to update indexing maps because all inputs and the output
+    // share the same map. Just replace the operands with transposed variants.
+    SmallVector<Value> newOperands;
+    for (OpOperand *operand : genericOp.getDpsInputOperands()) {
+      newOperands.push_back(
+          operand == input
+              ? transposeOp.getInput()
+              : createTranspose(rewriter, operand->get(), invPerm));
+    }
+    newOperands.push_back(newInit);
+    auto newGenericOp =
+        mlir::clone(rewriter, genericOp, newInit.getType(), newOperands);
     rewriter.replaceOp(
         genericOp, createTranspose(rewriter, newGenericOp->getResult(0), perm));
     return success();
   }
 };
 
-// Bubbles a transpose through the init of a unary elementwise operation.
-class BubbleTransposeThroughUnaryElementwiseDpsInit
+// Bubbles a transpose through the init of an elementwise operation. Any
+// constant inputs are transposed along with the propagated input.
+class BubbleTransposeThroughElementwiseDpsInit
     : public OpRewritePattern<linalg::TransposeOp> {
 public:
   using OpRewritePattern<linalg::TransposeOp>::OpRewritePattern;
@@ -709,8 +747,8 @@ public:
       return failure();
     }
 
-    if (!isUnaryElementwiseGeneric(genericOp)) {
-      return rewriter.notifyMatchFailure(genericOp, "not unary elementwise");
+    if (!getPropagatableElementwiseInput(genericOp)) {
+      return rewriter.notifyMatchFailure(genericOp, "not elementwise");
     }
 
     if (!genericOp->hasOneUse()) {
@@ -718,18 +756,19 @@ public:
     }
 
     ArrayRef<int64_t> perm = transposeOp.getPermutation();
-    Value newTranspose =
-        createTranspose(rewriter, genericOp.getOperand(0), perm);
+    SmallVector<Value> newOperands;
+    for (Value input : genericOp.getDpsInputs()) {
+      newOperands.push_back(createTranspose(rewriter, input, perm));
+    }
 
     // Create a new empty init for the transposed generic.
-    Value newInit =
-        createTransposeInit(rewriter, genericOp.getDpsInits()[0], perm);
+    newOperands.push_back(
+        createTransposeInit(rewriter, genericOp.getDpsInits()[0], perm));
 
-    // We do not need to update indexing maps because this is a unary
-    // elementwise op where the input and output maps are the same. Just
-    // replace the operands with transposed variants.
-    auto newGenericOp = mlir::clone(rewriter, genericOp, newInit.getType(),
-                                    {newTranspose, newInit});
+    // We do not need to update indexing maps because all inputs and the output
+    // share the same map. Just replace the operands with transposed variants.
+    auto newGenericOp = mlir::clone(rewriter, genericOp,
+                                    newOperands.back().getType(), newOperands);
     rewriter.replaceOp(transposeOp, newGenericOp);
     return success();
   }
@@ -895,7 +934,7 @@ void PropagateLinalgTransposePass::runOnOperation() {
     sinkingPatterns.insert<SinkTransposeThroughExtractSlice>(context);
     sinkingPatterns.insert<SinkTransposeThroughExpandShape>(context);
     populateNamedOpSinkingPatterns(context, sinkingPatterns);
-    sinkingPatterns.add<SinkTransposeThroughUnaryElementwiseInput>(
+    sinkingPatterns.add<SinkTransposeThroughElementwiseInput>(
         context, /*benefit=*/2);
     if (failed(
             applyPatternsAndFoldGreedily(funcOp, std::move(sinkingPatterns)))) {
@@ -949,7 +988,7 @@ void PropagateLinalgTransposePass::runOnOperation() {
     bubblingPatterns.insert<FuseTransposeWithProducerLinalgOp>(
         context, enableAggressivePropagation);
     bubblingPatterns.insert<BubbleTransposeThroughCollapseShape>(context);
-    bubblingPatterns.add<BubbleTransposeThroughUnaryElementwiseDpsInit>(
+    bubblingPatterns.add<BubbleTransposeThroughElementwiseDpsInit>(
         context, /*benefit=*/2);
     bubblingPatterns.insert<ComposeTransposes>(context);
     if (failed(applyPatternsAndFoldGreedily(funcOp,
@@ -1003,7 +1042,7 @@ void PropagateLinalgTransposePass::runOnOperation() {
         context, enableAggressivePropagation);
     sinkingPatterns.insert<ComposeTransposes>(context);
     populateNamedOpSinkingPatterns(context, sinkingPatterns);
-    sinkingPatterns.add<SinkTransposeThroughUnaryElementwiseInput>(
+    sinkingPatterns.add<SinkTransposeThroughElementwiseInput>(
         context, /*benefit=*/2);
     if (failed(
             applyPatternsAndFoldGreedily(funcOp, std::move(sinkingPatterns)))) {
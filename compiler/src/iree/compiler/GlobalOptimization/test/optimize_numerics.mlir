@@ -56,6 +56,34 @@ util.func public @matmul_reject_gt_8bit(%arg0 : tensor<5x3xf32>, %arg1 : tensor<
   util.return %2 : tensor<5x1xf32>
 }
 
+// CHECK-LABEL: @conv_i8_i8_i32_signed
+// Convolutions have no unsigned form: the unsigned input is widened to signed.
+util.func public @conv_i8_i8_i32_signed(%arg0 : tensor<1x4x4x3xf32>, %arg1 : tensor<2x2x3x8xf32>, %arg2 : tensor<1x3x3x8xf32>) -> tensor<1x3x3x8xf32> {
+  // CHECK: %[[LHS:.*]] = arith.fptosi %arg0 : tensor<1x4x4x3xf32> to tensor<1x4x4x3xi8>
+  // CHECK: %[[RHS:.*]] = arith.fptosi %arg1 : tensor<2x2x3x8xf32> to tensor<2x2x3x8xi8>
+  // CHECK: %[[INIT:.*]] = arith.fptosi %arg2 : tensor<1x3x3x8xf32> to tensor<1x3x3x8xi32>
+  %lhs = util.numeric.optional_narrow %arg0 : tensor<1x4x4x3xf32> as ui7 {max_value = 127 : ui7, min_value = 0 : ui7}
+  %rhs = util.numeric.optional_narrow %arg1 : tensor<2x2x3x8xf32> as si8 {max_value = 127 : si8, min_value = -127 : si8}
+  %init = util.numeric.optional_narrow %arg2 : tensor<1x3x3x8xf32> as ui0
+  // CHECK: %[[RESULT:.*]] = linalg.conv_2d_nhwc_hwcf
+  // CHECK-SAME: ins(%[[LHS]], %[[RHS]] : tensor<1x4x4x3xi8>, tensor<2x2x3x8xi8>) outs(%[[INIT]] : tensor<1x3x3x8xi32>)
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} ins(%lhs, %rhs : tensor<1x4x4x3xf32>, tensor<2x2x3x8xf32>) outs(%init : tensor<1x3x3x8xf32>) -> tensor<1x3x3x8xf32>
+  // CHECK: arith.sitofp %[[RESULT]] : tensor<1x3x3x8xi32> to tensor<1x3x3x8xf32>
+  util.return %0 : tensor<1x3x3x8xf32>
+}
+
+// CHECK-LABEL: @conv_reject_ui8
+// A full ui8 range does not fit in i8 once widened to signed.
+// CHECK-NOT: fptosi
+util.func public @conv_reject_ui8(%arg0 : tensor<1x4x4x3xf32>, %arg1 : tensor<2x2x3x8xf32>, %arg2 : tensor<1x3x3x8xf32>) -> tensor<1x3x3x8xf32> {
+  %lhs = util.numeric.optional_narrow %arg0 : tensor<1x4x4x3xf32> as ui8 {max_value = 255 : ui8, min_value = 0 : ui8}
+  %rhs = util.numeric.optional_narrow %arg1 : tensor<2x2x3x8xf32> as si8 {max_value = 127 : si8, min_value = -127 : si8}
+  %init = util.numeric.optional_narrow %arg2 : tensor<1x3x3x8xf32> as ui0
+  // CHECK: linalg.conv_2d_nhwc_hwcf {{.*}} -> tensor<1x3x3x8xf32>
+  %0 = linalg.conv_2d_nhwc_hwcf {dilations = dense<1> : tensor<2xi64>, strides = dense<1> : tensor<2xi64>} ins(%lhs, %rhs : tensor<1x4x4x3xf32>, tensor<2x2x3x8xf32>) outs(%init : tensor<1x3x3x8xf32>) -> tensor<1x3x3x8xf32>
+  util.return %0 : tensor<1x3x3x8xf32>
+}
+
 // CHECK-LABEL: @cast_fill
 util.func public @cast_fill(%arg0 : f32, %arg1 : tensor<3xf32>) -> tensor<3xi8> {
   // CHECK: %[[SCALAR:.*]] = arith.fptosi %arg0 : f32 to i8
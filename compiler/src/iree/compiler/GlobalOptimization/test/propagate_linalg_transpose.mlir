@@ -468,3 +468,91 @@ util.func public @bubble_through_matmul(%lhs: tensor<16x16xf32>,
 //       APROP:   %[[MATMUL:.+]] = linalg.generic
 //       APROP:     indexing_maps = [#[[MAP]], #[[MAP1]], #[[MAP2]]]
 //       APROP:   util.return %[[MATMUL]]
+
+// -----
+
+util.global private @bias = dense<1.0> : tensor<3x4x2xf32>
+util.func public @sink_transpose_through_add_of_immutable_global(%arg0 : tensor<2x3x4xf32>) -> tensor<3x4x2xf32> {
+  %empty = tensor.empty(): tensor<3x4x2xf32>
+  %transposed = linalg.transpose ins(%arg0 : tensor<2x3x4xf32>)
+      outs(%empty : tensor<3x4x2xf32>) permutation = [1, 2, 0]
+  %bias = util.global.load @bias : tensor<3x4x2xf32>
+  %0 = linalg.generic {indexing_maps = [
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+                iterator_types = ["parallel", "parallel", "parallel"]}
+                ins(%transposed, %bias : tensor<3x4x2xf32>, tensor<3x4x2xf32>)
+                outs(%empty : tensor<3x4x2xf32>) {
+                  ^bb0(%in: f32, %b: f32, %out: f32):
+                    %add = arith.addf %in, %b : f32
+                    linalg.yield %add : f32
+                  } -> tensor<3x4x2xf32>
+  util.return %0 : tensor<3x4x2xf32>
+}
+// SINK-LABEL: util.func public @sink_transpose_through_add_of_immutable_global
+//  SINK-SAME:   %[[ARG0:[A-Za-z0-9]+]]: tensor<2x3x4xf32>
+//       SINK:   %[[BIAS:.+]] = util.global.load @bias
+//       SINK:   %[[ADD:.+]] = linalg.generic {{.*}} ins(%[[ARG0]], %{{.+}} : tensor<2x3x4xf32>
+//  SINK-SAME:     outs(%{{.+}} : tensor<2x3x4xf32>)
+//       SINK:     arith.addf
+//       SINK:   %[[RES:.+]] = linalg.transpose ins(%[[ADD]] : tensor<2x3x4xf32>
+//  SINK-SAME:                    permutation = [1, 2, 0]
+//       SINK:   util.return %[[RES]] : tensor<3x4x2xf32>
+
+// -----
+
+util.func public @bubble_transpose_through_add_of_constant(%arg0 : tensor<2x3x4xf32>) -> tensor<3x4x2xf32> {
+  %cst = arith.constant dense<1.0> : tensor<2x3x4xf32>
+  %empty = tensor.empty(): tensor<2x3x4xf32>
+  %0 = linalg.generic {indexing_maps = [
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+                iterator_types = ["parallel", "parallel", "parallel"]}
+                ins(%arg0, %cst : tensor<2x3x4xf32>, tensor<2x3x4xf32>)
+                outs(%empty : tensor<2x3x4xf32>) {
+                  ^bb0(%in: f32, %c: f32, %out: f32):
+                    %add = arith.addf %in, %c : f32
+                    linalg.yield %add : f32
+                  } -> tensor<2x3x4xf32>
+  %empty1 = tensor.empty(): tensor<3x4x2xf32>
+  %transposed = linalg.transpose ins(%0 : tensor<2x3x4xf32>)
+      outs(%empty1 : tensor<3x4x2xf32>) permutation = [1, 2, 0]
+  util.return %transposed : tensor<3x4x2xf32>
+}
+// BUBBLE-LABEL: util.func public @bubble_transpose_through_add_of_constant
+//  BUBBLE-SAME:   %[[ARG0:[A-Za-z0-9]+]]: tensor<2x3x4xf32>
+//   BUBBLE-DAG:   %[[T:.+]] = linalg.transpose ins(%[[ARG0]] : tensor<2x3x4xf32>
+//       BUBBLE:   %[[ADD:.+]] = linalg.generic {{.*}} ins(%[[T]], %{{.+}} : tensor<3x4x2xf32>, tensor<3x4x2xf32>)
+//       BUBBLE:     arith.addf
+//       BUBBLE:   util.return %[[ADD]] : tensor<3x4x2xf32>
+
+// -----
+
+util.global private mutable @state : tensor<3x4x2xf32>
+util.func public @do_not_sink_transpose_through_add_of_mutable_global(%arg0 : tensor<2x3x4xf32>) -> tensor<3x4x2xf32> {
+  %empty = tensor.empty(): tensor<3x4x2xf32>
+  %transposed = linalg.transpose ins(%arg0 : tensor<2x3x4xf32>)
+      outs(%empty : tensor<3x4x2xf32>) permutation = [1, 2, 0]
+  %state = util.global.load @state : tensor<3x4x2xf32>
+  %0 = linalg.generic {indexing_maps = [
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>,
+                    affine_map<(d0, d1, d2) -> (d0, d1, d2)>],
+                iterator_types = ["parallel", "parallel", "parallel"]}
+                ins(%transposed, %state : tensor<3x4x2xf32>, tensor<3x4x2xf32>)
+                outs(%empty : tensor<3x4x2xf32>) {
+                  ^bb0(%in: f32, %b: f32, %out: f32):
+                    %add = arith.addf %in, %b : f32
+                    linalg.yield %add : f32
+                  } -> tensor<3x4x2xf32>
+  util.return %0 : tensor<3x4x2xf32>
+}
+// SINK-LABEL: util.func public @do_not_sink_transpose_through_add_of_mutable_global
+//  SINK-SAME:   %[[ARG0:[A-Za-z0-9]+]]: tensor<2x3x4xf32>
+//   SINK-NOT:   linalg.transpose
+//       SINK:   %[[ADD:.+]] = linalg.generic {{.*}} ins(%[[ARG0]], %{{.+}} : tensor<2x3x4xf32>, tensor<3x4x2xf32>)
+//  SINK-SAME:     outs(%{{.+}} : tensor<3x4x2xf32>)
+//   SINK-NOT:   linalg.transpose
+//       SINK:   util.return %[[ADD]] : tensor<3x4x2xf32>
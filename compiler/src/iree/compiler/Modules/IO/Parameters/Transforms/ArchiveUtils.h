@@ -46,6 +46,11 @@ private:
   iree_io_stream_t *stream = NULL;
 };
 
+// Attribute recording the parameter an imported global was loaded from so
+// that exports can reference it again instead of duplicating its contents.
+static constexpr StringLiteral kImportedParameterAttrName =
+    "iree.io.imported_parameter";
+
 using ScopePath = std::pair<StringRef, StringRef>;
 
 // Splits a `scope=path` string into two strings.
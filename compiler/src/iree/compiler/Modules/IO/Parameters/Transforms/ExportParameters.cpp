@@ -104,6 +104,17 @@ struct ExportParametersPass
     // Accumulate globals that match the pass options and add them to the index.
     SmallVector<IREE::Util::GlobalOpInterface> constantGlobalOps;
     for (auto globalOp : moduleOp.getOps<IREE::Util::GlobalOpInterface>()) {
+      // Globals that were imported and left untouched still match the original
+      // parameter so we reference it instead of writing a copy.
+      if (auto importedAttr =
+              globalOp->getAttrOfType<IREE::Flow::NamedParameterAttr>(
+                  kImportedParameterAttrName)) {
+        globalOp->removeAttr(kImportedParameterAttrName);
+        if (globalOp.getGlobalInitialValue())
+          globalOp.setGlobalInitialValue(importedAttr);
+        continue;
+      }
+
       // Only globals initialized with serializable initial values can be
       // parameterized.
       auto serializableAttr =
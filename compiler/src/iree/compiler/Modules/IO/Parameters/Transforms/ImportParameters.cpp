@@ -354,6 +354,8 @@ struct ImportParametersPass
 
         // Replace the initial value with the constant.
         globalOp.setGlobalInitialValue(*valueOr);
+        if (retainReferences)
+          globalOp->setAttr(kImportedParameterAttrName, parameterAttr);
       }
     }
   }
@@ -0,0 +1,15 @@
+// RUN: iree-opt --pass-pipeline="builtin.module(iree-io-export-parameters{path="opt=%t.irpa" minimum-size=8},iree-io-import-parameters{paths="opt=%t.irpa" retain-references=true},iree-io-export-parameters{path="derived=%t.derived.irpa" minimum-size=0})" %s | FileCheck %s
+// RUN: iree-dump-parameters --parameters=%t.derived.irpa | FileCheck %s --check-prefix=DUMP
+
+// Tests that imported parameters are referenced from their original archive
+// when exported again and only the constants that did not come from it (such
+// as those produced by const-eval) are written to the new archive.
+
+// CHECK: util.global private @weight = #flow.parameter.named<"opt"::"weight"> : tensor<2xf32>
+// CHECK-NOT: iree.io.imported_parameter
+util.global private @weight = dense<[1.100000e+01, 1.200000e+01]> : tensor<2xf32>
+
+// CHECK: util.global private @weight_derived = #flow.parameter.named<"derived"::"weight_derived"> : tensor<1xf32>
+// DUMP-NOT: `weight`
+// DUMP: `weight_derived`
+util.global private @weight_derived = dense<2.300000e+01> : tensor<1xf32>
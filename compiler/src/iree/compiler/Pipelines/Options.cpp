@@ -188,6 +188,13 @@ void GlobalOptimizationOptions::bindOptions(OptionsBinder &binder) {
           "Minimum size of constants to export to the archive created in "
           "`iree-opt-export-parameter-archive-export-file`."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-opt-export-derived-parameters", parameterExportDerived,
+      llvm::cl::desc(
+          "Keeps parameters imported with `iree-opt-import-parameters` "
+          "referencing their original archive so that only the constants "
+          "const-eval derives from them are exported."),
+      llvm::cl::cat(category));
 
   binder.opt<std::string>(
       "iree-opt-splat-parameters", parameterSplatExportFile,
@@ -246,6 +253,20 @@ void SchedulingOptions::bindOptions(OptionsBinder &binder) {
       llvm::cl::desc(
           "Enables binding fusion and dispatch site specialization."),
       llvm::cl::cat(category));
+  binder.opt<bool>(
+      "iree-scheduling-reuse-transients", reuseTransientAllocations,
+      llvm::cl::desc("Suballocates the transients of execution regions with "
+                     "disjoint lifetimes from a single reusable arena. Lowers "
+                     "peak transient memory at the cost of ordering regions "
+                     "that reuse memory after the regions they reuse it from."),
+      llvm::cl::cat(category));
+  binder.opt<int64_t>(
+      "iree-scheduling-weight-streaming-depth", weightStreamingDepth,
+      llvm::cl::desc("Reads parameters into a ring of this many device buffers "
+                     "right before they are used instead of keeping them all "
+                     "resident, allowing programs with more parameters than "
+                     "device memory to run. 0 disables weight streaming."),
+      llvm::cl::cat(category));
 }
 
 } // namespace mlir::iree_compiler
@@ -122,6 +122,10 @@ struct GlobalOptimizationOptions {
   std::string parameterExportPath;
   // Minimum size of constants to export as parameters.
   int64_t parameterExportMinimumSize = 0;
+  // Only exports constants derived from imported parameters at compile time.
+  // Imported parameters that are not transformed keep referencing their
+  // original archive.
+  bool parameterExportDerived = false;
 
   // File path to create a splat parameter archive out of all parameters in the
   // module.
@@ -177,6 +181,11 @@ struct SchedulingOptions {
   std::string dumpStatisticsFile = "";
   // Enables fusing bindings with the same underlying storage.
   bool optimizeBindings = true;
+  // Suballocates the transients of execution regions from a reusable arena.
+  bool reuseTransientAllocations = false;
+  // Streams parameters through a ring of this many device buffers; 0 keeps
+  // all parameters resident.
+  int64_t weightStreamingDepth = 0;
 
   // TODO(benvanik): favor size/speed/etc for partitioning.
   // TODO(benvanik): execution model to optimize for (unified/discrete memory,
@@ -257,6 +257,9 @@ void buildIREEVMTransformPassPipeline(
       (IREE::Stream::DumpOutputFormat)schedulingOptions.dumpStatisticsFormat;
   streamOptions.dumpStatisticsFile = schedulingOptions.dumpStatisticsFile;
   streamOptions.optimizeBindings = schedulingOptions.optimizeBindings;
+  streamOptions.reuseTransientAllocations =
+      schedulingOptions.reuseTransientAllocations;
+  streamOptions.weightStreamingDepth = schedulingOptions.weightStreamingDepth;
 
   switch (schedulingOptions.executionModel) {
   case SchedulingOptions::ExecutionModel::HostOnly:
@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include "iree/compiler/Preprocessing/Common/Passes.h"
+#include "mlir/Dialect/Affine/IR/AffineOps.h"
 #include "mlir/Dialect/Arith/IR/Arith.h"
 #include "mlir/Dialect/Linalg/IR/Linalg.h"
 #include "mlir/Dialect/Tensor/IR/Tensor.h"
@@ -42,6 +43,55 @@ static Value createMul(Location loc, Value x, Value y, bool isInt,
   return builder.create<arith::MulFOp>(loc, x, y);
 }
 
+// Creates the im2col matrix of an NHWC |input| directly in its collapsed
+// ((N x) Ho * Wo, Kh * Kw * C) shape. Each element is gathered from the input
+// with a `tensor.extract`, so the op has an identity indexing map and can be
+// fused with a consumer `set_encoding` (i.e. a pack) instead of being
+// materialized in its unpacked layout.
+static Value createGatherIm2Col(Location loc, Value input,
+                                RankedTensorType colType, int64_t ow,
+                                int64_t fw, int64_t ic, int64_t sh, int64_t sw,
+                                OpBuilder &builder) {
+  MLIRContext *context = builder.getContext();
+  const int64_t rank = colType.getRank();
+  Value colTensor = builder.create<tensor::EmptyOp>(
+      loc, colType.getShape(), colType.getElementType());
+
+  AffineExpr mDim, kDim;
+  bindDims(context, mDim, kDim);
+  SmallVector<AffineMap> inputIndexMaps = {
+      AffineMap::get(2, 0, mDim.floorDiv(ow) * sh + kDim.floorDiv(fw * ic)),
+      AffineMap::get(2, 0, (mDim % ow) * sw + (kDim % (fw * ic)).floorDiv(ic)),
+      AffineMap::get(2, 0, kDim % ic)};
+
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::getMultiDimIdentityMap(rank, context)};
+  SmallVector<utils::IteratorType> iterators(rank,
+                                             utils::IteratorType::parallel);
+  auto genericOp = builder.create<linalg::GenericOp>(
+      loc, colType, /*inputs=*/ValueRange{}, /*outputs=*/colTensor,
+      indexingMaps, iterators,
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        Value batch =
+            rank == 3
+                ? nestedBuilder.create<linalg::IndexOp>(nestedLoc, 0)
+                      .getResult()
+                : nestedBuilder.create<arith::ConstantIndexOp>(nestedLoc, 0)
+                      .getResult();
+        Value m = nestedBuilder.create<linalg::IndexOp>(nestedLoc, rank - 2);
+        Value k = nestedBuilder.create<linalg::IndexOp>(nestedLoc, rank - 1);
+        SmallVector<Value> indices = {batch};
+        for (AffineMap map : inputIndexMaps) {
+          indices.push_back(nestedBuilder.create<affine::AffineApplyOp>(
+              nestedLoc, map, ValueRange{m, k}));
+        }
+        Value element =
+            nestedBuilder.create<tensor::ExtractOp>(nestedLoc, input, indices);
+        nestedBuilder.create<linalg::YieldOp>(nestedLoc, element);
+      });
+  return genericOp.getResult(0);
+}
+
 namespace {
 
 // Convert linalg.conv_2d_nhwc_hwcf into linalg.generic (for img2col packing)
@@ -77,10 +127,16 @@ namespace {
 // multiplication (Ho x Wo, Kh x Kw x C) * (Kh x Kw x C, D) for each input in
 // the N input. For the case where N > 1 its a batched matrxi-matrix
 // multplication.
+//
+// With |useGatherIm2Col| the img2col matrix is gathered directly in its
+// collapsed shape (see createGatherIm2Col). Under data tiling the gather is
+// then fused into the pack of the matmul LHS, giving an implicit GEMM that
+// never writes the unpacked img2col matrix to memory.
 class ConvertConv2DNhwcHwcf final
     : public OpRewritePattern<linalg::Conv2DNhwcHwcfOp> {
 public:
-  using OpRewritePattern::OpRewritePattern;
+  ConvertConv2DNhwcHwcf(MLIRContext *context, bool useGatherIm2Col)
+      : OpRewritePattern(context), useGatherIm2Col(useGatherIm2Col) {}
 
   LogicalResult matchAndRewrite(linalg::Conv2DNhwcHwcfOp convOp,
                                 PatternRewriter &rewriter) const override {
@@ -120,40 +176,6 @@ public:
 
     auto loc = convOp.getLoc();
 
-    SmallVector<int64_t> colTensorShape = {n, oh, ow, fh, fw, ic};
-
-    Value colTensor = rewriter.create<tensor::EmptyOp>(
-        loc, colTensorShape, inputType.getElementType());
-
-    AffineExpr nDim, ohDim, owDim, khDim, kwDim, icDim;
-    bindDims(getContext(), nDim, ohDim, owDim, khDim, kwDim, icDim);
-
-    auto shSym = rewriter.getAffineConstantExpr(
-        convOp.getStrides().getValues<int64_t>()[0]);
-    auto swSym = rewriter.getAffineConstantExpr(
-        convOp.getStrides().getValues<int64_t>()[1]);
-
-    SmallVector<AffineExpr> inputExprs = {nDim, ohDim * shSym + khDim,
-                                          owDim * swSym + kwDim, icDim};
-
-    auto nloops = colTensorShape.size();
-
-    auto parallel = utils::IteratorType::parallel;
-    auto reduction = utils::IteratorType::reduction;
-    SmallVector<utils::IteratorType, 3> img2colIterators(nloops, parallel);
-
-    SmallVector<AffineMap> img2colIndexingMaps = {
-        AffineMap::get(nloops, 0, inputExprs, rewriter.getContext()),
-        AffineMap::getMultiDimIdentityMap(nloops, rewriter.getContext())};
-
-    auto img2ColTensor = rewriter.create<linalg::GenericOp>(
-        loc, colTensor.getType(),
-        /*inputs=*/input, /*outputs=*/colTensor, img2colIndexingMaps,
-        img2colIterators,
-        [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
-          nestedBuilder.create<linalg::YieldOp>(nestedLoc, args[0]);
-        });
-
     SmallVector<ReassociationIndices> img2ColTensorReassocIndices;
     SmallVector<ReassociationIndices> outputReassocIndices;
     RankedTensorType reshapedImg2ColTensorType, reshapedOutputType;
@@ -179,9 +201,49 @@ public:
     auto reshapedFilterType =
         RankedTensorType::get({fh * fw * ic, oc}, inputType.getElementType());
 
-    Value reshapedImg2ColTensor = rewriter.create<tensor::CollapseShapeOp>(
-        loc, reshapedImg2ColTensorType, img2ColTensor.getResult(0),
-        img2ColTensorReassocIndices);
+    auto parallel = utils::IteratorType::parallel;
+    auto reduction = utils::IteratorType::reduction;
+    const int64_t sh = convOp.getStrides().getValues<int64_t>()[0];
+    const int64_t sw = convOp.getStrides().getValues<int64_t>()[1];
+    Value reshapedImg2ColTensor;
+    if (useGatherIm2Col) {
+      reshapedImg2ColTensor =
+          createGatherIm2Col(loc, input, reshapedImg2ColTensorType, ow, fw, ic,
+                             sh, sw, rewriter);
+    } else {
+      SmallVector<int64_t> colTensorShape = {n, oh, ow, fh, fw, ic};
+
+      Value colTensor = rewriter.create<tensor::EmptyOp>(
+          loc, colTensorShape, inputType.getElementType());
+
+      AffineExpr nDim, ohDim, owDim, khDim, kwDim, icDim;
+      bindDims(getContext(), nDim, ohDim, owDim, khDim, kwDim, icDim);
+
+      auto shSym = rewriter.getAffineConstantExpr(sh);
+      auto swSym = rewriter.getAffineConstantExpr(sw);
+
+      SmallVector<AffineExpr> inputExprs = {nDim, ohDim * shSym + khDim,
+                                            owDim * swSym + kwDim, icDim};
+
+      auto nloops = colTensorShape.size();
+
+      SmallVector<utils::IteratorType, 3> img2colIterators(nloops, parallel);
+
+      SmallVector<AffineMap> img2colIndexingMaps = {
+          AffineMap::get(nloops, 0, inputExprs, rewriter.getContext()),
+          AffineMap::getMultiDimIdentityMap(nloops, rewriter.getContext())};
+
+      auto img2ColTensor = rewriter.create<linalg::GenericOp>(
+          loc, colTensor.getType(),
+          /*inputs=*/input, /*outputs=*/colTensor, img2colIndexingMaps,
+          img2colIterators,
+          [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+            nestedBuilder.create<linalg::YieldOp>(nestedLoc, args[0]);
+          });
+      reshapedImg2ColTensor = rewriter.create<tensor::CollapseShapeOp>(
+          loc, reshapedImg2ColTensorType, img2ColTensor.getResult(0),
+          img2ColTensorReassocIndices);
+    }
 
     Value reshapedFilter = rewriter.create<tensor::CollapseShapeOp>(
         loc, reshapedFilterType, filter, filterReassocIndices);
@@ -230,6 +292,9 @@ public:
 
     return success();
   }
+
+private:
+  bool useGatherIm2Col;
 };
 
 // Similar to the conv pattern above except there is no reduction among the
@@ -555,11 +620,14 @@ public:
 class ConvertConv2DToImg2ColPass
     : public iree_compiler::Preprocessing::impl::ConvertConv2DToImg2ColPassBase<
           ConvertConv2DToImg2ColPass> {
+  using Base::Base;
+
   void runOnOperation() override {
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(&getContext());
-    patterns.insert<ConvertConv2DNhwcHwcf, ConvertDepthwiseConv2DNhwcHwc,
-                    ConvertConv2DNchwFchw>(context);
+    patterns.insert<ConvertConv2DNhwcHwcf>(context, useGatherIm2Col);
+    patterns.insert<ConvertDepthwiseConv2DNhwcHwc, ConvertConv2DNchwFchw>(
+        context);
     if (failed(applyPatternsAndFoldGreedily(getOperation(),
                                             std::move(patterns)))) {
       return signalPassFailure();
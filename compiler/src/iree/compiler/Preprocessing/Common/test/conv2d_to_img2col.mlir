@@ -1,4 +1,5 @@
 // RUN: iree-opt --split-input-file -iree-preprocessing-convert-conv2d-to-img2col %s | FileCheck %s
+// RUN: iree-opt --split-input-file -iree-preprocessing-convert-conv2d-to-img2col="use-gather-im2col=true" %s | FileCheck %s --check-prefix=GATHER
 
 func.func @conv_16433136(%arg0: tensor<1x16x16x4xf32>, %arg1: tensor<3x3x4x16xf32>, %arg2: tensor<1x14x14x16xf32>) -> tensor<1x14x14x16xf32> {
     %0 = linalg.conv_2d_nhwc_hwcf
@@ -31,6 +32,25 @@ func.func @conv_16433136(%arg0: tensor<1x16x16x4xf32>, %arg1: tensor<3x3x4x16xf3
 //      CHECK: %[[RESULT:.+]] = tensor.expand_shape %[[MATMUL_RESULT]] {{\[}}[0, 1, 2], [3]] output_shape [1, 14, 14, 16] : tensor<196x16xf32> into tensor<1x14x14x16xf32>
 //      CHECK: return %[[RESULT]]
 
+// GATHER-DAG: #[[IH_MAP:.+]] = affine_map<(d0, d1) -> (d0 floordiv 14 + d1 floordiv 12)>
+// GATHER-DAG: #[[IW_MAP:.+]] = affine_map<(d0, d1) -> (d0 mod 14 + (d1 mod 12) floordiv 4)>
+// GATHER-DAG: #[[IC_MAP:.+]] = affine_map<(d0, d1) -> (d1 mod 4)>
+// GATHER-DAG: #[[ID_MAP:.+]] = affine_map<(d0, d1) -> (d0, d1)>
+//      GATHER: @conv_16433136
+// GATHER-SAME: %[[INPUT:[a-zA-Z0-9_]+]]: tensor<1x16x16x4xf32>
+//      GATHER: %[[INIT:.+]] = tensor.empty() : tensor<196x36xf32>
+//      GATHER: %[[COL:.+]] = linalg.generic
+// GATHER-SAME:   indexing_maps = [#[[ID_MAP]]]
+// GATHER-SAME:   outs(%[[INIT]] : tensor<196x36xf32>)
+//  GATHER-DAG:   %[[M:.+]] = linalg.index 0 : index
+//  GATHER-DAG:   %[[K:.+]] = linalg.index 1 : index
+//  GATHER-DAG:   %[[IH:.+]] = affine.apply #[[IH_MAP]](%[[M]], %[[K]])
+//  GATHER-DAG:   %[[IW:.+]] = affine.apply #[[IW_MAP]](%[[M]], %[[K]])
+//  GATHER-DAG:   %[[IC:.+]] = affine.apply #[[IC_MAP]](%[[M]], %[[K]])
+//      GATHER:   %[[ELEM:.+]] = tensor.extract %[[INPUT]][%{{.+}}, %[[IH]], %[[IW]], %[[IC]]] : tensor<1x16x16x4xf32>
+//      GATHER:   linalg.yield %[[ELEM]] : f32
+//      GATHER: linalg.matmul ins(%[[COL]], %{{.+}} : tensor<196x36xf32>, tensor<36x16xf32>)
+
 // -----
 
 func.func @depthwise_conv_hwc_114x16x3(%input: tensor<1x114x114x16xf32>, %filter: tensor<3x3x16xf32>, %output: tensor<1x112x112x16xf32>) -> tensor<1x112x112x16xf32> {
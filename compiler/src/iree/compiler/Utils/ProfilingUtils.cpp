@@ -0,0 +1,195 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/compiler/Utils/ProfilingUtils.h"
+
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/ManagedStatic.h"
+#include "llvm/Support/TimeProfiler.h"
+#include "llvm/Support/raw_ostream.h"
+#include "mlir/IR/SymbolTable.h"
+
+namespace mlir::iree_compiler {
+
+//===----------------------------------------------------------------------===//
+// Phase markers
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+class PassProfilingPhasePass
+    : public PassWrapper<PassProfilingPhasePass, OperationPass<>> {
+public:
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(PassProfilingPhasePass);
+
+  PassProfilingPhasePass(StringRef name, bool isBegin)
+      : name(name), isBegin(isBegin) {}
+
+  StringRef getArgument() const override {
+    return "iree-pass-profiling-phase";
+  }
+
+  // Handled by PassProfiling before the pass runs.
+  void runOnOperation() override {}
+
+  std::string name;
+  bool isBegin;
+};
+
+} // namespace
+
+void addPassProfilingPhaseBegin(OpPassManager &passManager, StringRef name) {
+  passManager.addPass(
+      std::make_unique<PassProfilingPhasePass>(name, /*isBegin=*/true));
+}
+
+void addPassProfilingPhaseEnd(OpPassManager &passManager, StringRef name) {
+  passManager.addPass(
+      std::make_unique<PassProfilingPhasePass>(name, /*isBegin=*/false));
+}
+
+//===----------------------------------------------------------------------===//
+// PassProfiling (PassInstrumentation)
+//===----------------------------------------------------------------------===//
+
+namespace {
+// Whether each pass running on the current thread opened a symbol event in
+// addition to its own.
+thread_local SmallVector<bool, 8> passProfileSymbolStack;
+} // namespace
+
+PassProfiling::PassProfiling(std::string path, unsigned granularityUs)
+    : path(std::move(path)), granularityUs(granularityUs),
+      ownerThreadId(std::this_thread::get_id()) {
+  if (!llvm::getTimeTraceProfilerInstance()) {
+    llvm::timeTraceProfilerInitialize(granularityUs, "iree-compile");
+    ownsProfiler = true;
+  }
+}
+
+PassProfiling::~PassProfiling() {
+  while (!phaseStack.empty()) {
+    endPhase(phaseStack.front());
+  }
+  if (!ownsProfiler) {
+    return;
+  }
+  if (auto error = llvm::timeTraceProfilerWrite(path, "-")) {
+    llvm::errs() << "failed to write compile profile to '" << path
+                 << "': " << llvm::toString(std::move(error)) << "\n";
+  }
+  llvm::timeTraceProfilerCleanup();
+}
+
+void PassProfiling::beginPhase(StringRef name) {
+  phaseStack.push_back(name.str());
+  llvm::timeTraceProfilerBegin("phase " + name.str(), "");
+}
+
+void PassProfiling::endPhase(StringRef name) {
+  // Phases ending without their nested phases having ended close those too.
+  auto it = llvm::find(phaseStack, name);
+  if (it == phaseStack.end()) {
+    return;
+  }
+  for (size_t i = std::distance(it, phaseStack.end()); i > 0; --i) {
+    llvm::timeTraceProfilerEnd();
+  }
+  phaseStack.erase(it, phaseStack.end());
+}
+
+void PassProfiling::runBeforePass(Pass *pass, Operation *op) {
+  if (pass->getTypeID() == TypeID::get<PassProfilingPhasePass>()) {
+    auto *phasePass = static_cast<PassProfilingPhasePass *>(pass);
+    if (phasePass->isBegin) {
+      beginPhase(phasePass->name);
+    } else {
+      endPhase(phasePass->name);
+    }
+    return;
+  }
+
+  // Worker threads get their own profiler that is handed over when they are
+  // done. Anything LLVM runs on the thread in between lands in it too.
+  if (!llvm::getTimeTraceProfilerInstance()) {
+    llvm::timeTraceProfilerInitialize(granularityUs, "iree-compile");
+  }
+
+  std::string opName;
+  llvm::raw_string_ostream os(opName);
+  os << op->getName();
+  auto symbolOp = dyn_cast<SymbolOpInterface>(op);
+  bool isSymbol = symbolOp && !isa<ModuleOp>(op);
+  if (isSymbol) {
+    os << " @" << symbolOp.getName();
+    llvm::timeTraceProfilerBegin(os.str(), "");
+  }
+  passProfileSymbolStack.push_back(isSymbol);
+
+  StringRef passName = pass->getArgument();
+  if (passName.empty()) {
+    passName = pass->getName();
+  }
+  llvm::timeTraceProfilerBegin(passName, os.str());
+}
+
+void PassProfiling::runAfterPass(Pass *pass, Operation *op) {
+  if (pass->getTypeID() == TypeID::get<PassProfilingPhasePass>()) {
+    return;
+  }
+  llvm::timeTraceProfilerEnd();
+  if (passProfileSymbolStack.pop_back_val()) {
+    llvm::timeTraceProfilerEnd();
+  }
+  if (passProfileSymbolStack.empty() &&
+      std::this_thread::get_id() != ownerThreadId) {
+    llvm::timeTraceProfilerFinishThread();
+  }
+}
+
+void PassProfiling::runAfterPassFailed(Pass *pass, Operation *op) {
+  runAfterPass(pass, op);
+}
+
+//===----------------------------------------------------------------------===//
+// Command line options
+//===----------------------------------------------------------------------===//
+
+namespace {
+
+struct PassProfilingCLOptions {
+  llvm::cl::opt<std::string> path{
+      "iree-compile-profile",
+      llvm::cl::desc("Writes a Chrome trace of the time spent in each pipeline "
+                     "phase, pass, executable and target backend to the given "
+                     "path (- for stdout)."),
+      llvm::cl::init("")};
+  llvm::cl::opt<unsigned> granularityUs{
+      "iree-compile-profile-granularity",
+      llvm::cl::desc("Minimum duration in microseconds of the events recorded "
+                     "in the compile profile. Totals include all events."),
+      llvm::cl::init(500)};
+};
+
+} // namespace
+
+static llvm::ManagedStatic<PassProfilingCLOptions> clOptions;
+
+void registerPassProfilingCLOptions() { *clOptions; }
+
+bool isPassProfilingEnabled() {
+  return clOptions.isConstructed() && !clOptions->path.empty();
+}
+
+void applyPassProfilingCLOptions(PassManager &passManager) {
+  if (!isPassProfilingEnabled()) {
+    return;
+  }
+  passManager.addInstrumentation(std::make_unique<PassProfiling>(
+      clOptions->path.getValue(), clOptions->granularityUs.getValue()));
+}
+
+} // namespace mlir::iree_compiler
@@ -0,0 +1,71 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_COMPILER_UTILS_PROFILINGUTILS_H_
+#define IREE_COMPILER_UTILS_PROFILINGUTILS_H_
+
+#include <string>
+#include <thread>
+
+#include "mlir/Pass/PassInstrumentation.h"
+#include "mlir/Pass/PassManager.h"
+
+namespace mlir::iree_compiler {
+
+// Records a compile profile using LLVM's time trace profiler and writes it as
+// a Chrome trace (chrome://tracing, Perfetto) to |path| when destroyed.
+//
+// Each pass is recorded along with the op it ran on. Passes on symbols such as
+// executables and their variants are additionally wrapped in an event named
+// after the symbol so that the totals at the end of the trace give the time
+// spent per executable and per target variant. LLVM passes run as part of
+// codegen record themselves into the same trace. Events from all threads are
+// merged and totals are rolled up across them.
+//
+// Usage:
+//   passManager.addInstrumentation(
+//       std::make_unique<PassProfiling>("profile.json"));
+class PassProfiling : public PassInstrumentation {
+public:
+  explicit PassProfiling(std::string path, unsigned granularityUs = 500);
+  ~PassProfiling() override;
+
+  void runBeforePass(Pass *pass, Operation *op) override;
+  void runAfterPass(Pass *pass, Operation *op) override;
+  void runAfterPassFailed(Pass *pass, Operation *op) override;
+
+private:
+  void beginPhase(StringRef name);
+  void endPhase(StringRef name);
+
+  std::string path;
+  unsigned granularityUs;
+  // Thread owning the profile. Other threads hand their events over to it
+  // whenever they finish running passes.
+  std::thread::id ownerThreadId;
+  // True if the profiler was initialized by this instrumentation.
+  bool ownsProfiler = false;
+  // Pipeline phases open on the owning thread, outermost first.
+  SmallVector<std::string> phaseStack;
+};
+
+// Adds passes to |passManager| marking the beginning and end of the pipeline
+// phase |name| in the profile. They have no effect without PassProfiling.
+void addPassProfilingPhaseBegin(OpPassManager &passManager, StringRef name);
+void addPassProfilingPhaseEnd(OpPassManager &passManager, StringRef name);
+
+// Registers the --iree-compile-profile* command line options.
+void registerPassProfilingCLOptions();
+
+// Returns true if a profile was requested on the command line.
+bool isPassProfilingEnabled();
+
+// Adds PassProfiling to |passManager| if requested on the command line.
+void applyPassProfilingCLOptions(PassManager &passManager);
+
+} // namespace mlir::iree_compiler
+
+#endif // IREE_COMPILER_UTILS_PROFILINGUTILS_H_
@@ -0,0 +1,54 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from pathlib import Path
+
+from ireers import configure_benchmarks
+
+
+def pytest_addoption(parser):
+    group = parser.getgroup("ireers", "IREE regression suite benchmarks")
+    group.addoption(
+        "--benchmark-history",
+        type=Path,
+        default=None,
+        help="JSON lines file benchmark results are compared against and "
+        "appended to (default: artifacts/benchmark_history.jsonl)",
+    )
+    group.addoption(
+        "--regression-threshold",
+        action="append",
+        default=[],
+        metavar="METRIC=FRACTION",
+        help="Maximum relative regression of a metric (latency_ms, throughput, "
+        "peak_memory_bytes, compile_time_s), e.g. latency_ms=0.1. Repeatable.",
+    )
+    group.addoption(
+        "--baseline-window",
+        type=int,
+        default=None,
+        help="Number of most recent history entries the baseline is the "
+        "median of",
+    )
+    group.addoption(
+        "--no-regression-check",
+        action="store_true",
+        default=False,
+        help="Record benchmark results without failing on regressions",
+    )
+
+
+def pytest_configure(config):
+    thresholds = {}
+    for spec in config.getoption("regression_threshold"):
+        metric, _, fraction = spec.partition("=")
+        thresholds[metric] = float(fraction)
+    configure_benchmarks(
+        history_path=config.getoption("benchmark_history"),
+        thresholds=thresholds,
+        baseline_window=config.getoption("baseline_window"),
+        check_regressions=not config.getoption("no_regression_check"),
+    )
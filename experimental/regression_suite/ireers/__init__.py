@@ -10,3 +10,8 @@ from .fixtures import (
     iree_benchmark_module,
     iree_run_module,
 )
+from .benchmarks import (
+    BenchmarkRegression,
+    BenchmarkResult,
+    configure_benchmarks,
+)
@@ -0,0 +1,263 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+"""Performance results and their history.
+
+Each benchmark run produces a `BenchmarkResult` which is compared against the
+recent history of the same benchmark and then appended to it. The history is a
+JSON lines file so that it can be concatenated across runs and machines and
+consumed by other tools.
+"""
+
+from typing import Dict, List, Optional, Sequence
+import dataclasses
+import json
+import os
+import platform
+import re
+import statistics
+import time
+from pathlib import Path
+
+from .artifacts import Artifact, get_artifact_root_dir
+
+# Metrics tracked for each benchmark mapped to whether higher values are
+# better.
+METRICS: Dict[str, bool] = {
+    "latency_ms": False,
+    "throughput": True,
+    "peak_memory_bytes": False,
+    "compile_time_s": False,
+}
+
+# Maximum relative change in the bad direction before a metric is considered
+# regressed. Compile times are noisier than steady-state execution.
+DEFAULT_THRESHOLDS: Dict[str, float] = {
+    "latency_ms": 0.05,
+    "throughput": 0.05,
+    "peak_memory_bytes": 0.02,
+    "compile_time_s": 0.10,
+}
+
+
+@dataclasses.dataclass
+class BenchmarkConfig:
+    history_path: Optional[Path] = None
+    thresholds: Dict[str, float] = dataclasses.field(
+        default_factory=lambda: dict(DEFAULT_THRESHOLDS)
+    )
+    # Number of most recent matching results the baseline is the median of.
+    baseline_window: int = 5
+    check_regressions: bool = True
+
+    def get_history_path(self) -> Path:
+        if self.history_path:
+            return self.history_path
+        return get_artifact_root_dir() / "benchmark_history.jsonl"
+
+
+_CONFIG = BenchmarkConfig()
+
+
+def get_benchmark_config() -> BenchmarkConfig:
+    return _CONFIG
+
+
+def configure_benchmarks(
+    *,
+    history_path: Optional[Path] = None,
+    thresholds: Optional[Dict[str, float]] = None,
+    baseline_window: Optional[int] = None,
+    check_regressions: Optional[bool] = None,
+):
+    if history_path is not None:
+        _CONFIG.history_path = Path(history_path)
+    if thresholds:
+        for metric, threshold in thresholds.items():
+            if metric not in METRICS:
+                raise ValueError(f"Unknown benchmark metric '{metric}'")
+            _CONFIG.thresholds[metric] = threshold
+    if baseline_window is not None:
+        _CONFIG.baseline_window = baseline_window
+    if check_regressions is not None:
+        _CONFIG.check_regressions = check_regressions
+
+
+@dataclasses.dataclass
+class BenchmarkResult:
+    model: str
+    target: str
+    device: str
+    function: str
+    latency_ms: Optional[float] = None
+    throughput: Optional[float] = None
+    peak_memory_bytes: Optional[int] = None
+    compile_time_s: Optional[float] = None
+    test: str = ""
+    host: str = dataclasses.field(default_factory=platform.node)
+    timestamp: float = dataclasses.field(default_factory=time.time)
+
+    @property
+    def key(self) -> tuple:
+        """Identifies runs of the same benchmark across history entries."""
+        return (self.model, self.target, self.device, self.function)
+
+    def to_json(self) -> str:
+        return json.dumps(dataclasses.asdict(self), sort_keys=True)
+
+    @staticmethod
+    def from_json(line: str) -> "BenchmarkResult":
+        fields = {f.name for f in dataclasses.fields(BenchmarkResult)}
+        values = json.loads(line)
+        return BenchmarkResult(**{k: v for k, v in values.items() if k in fields})
+
+
+class BenchmarkRegression(AssertionError):
+    pass
+
+
+###############################################################################
+# Parsing tool output
+###############################################################################
+
+_TIME_UNIT_TO_MS = {
+    "ns": 1e-6,
+    "us": 1e-3,
+    "ms": 1.0,
+    "s": 1e3,
+}
+
+_PEAK_MEMORY_RE = re.compile(r"^\s*(HOST_LOCAL|DEVICE_LOCAL):\s+(\d+)B peak", re.M)
+
+
+def parse_benchmark_json(output: str) -> Dict[str, Optional[float]]:
+    """Parses iree-benchmark-module --benchmark_format=json output.
+
+    Prefers the mean aggregate when repetitions were requested and otherwise
+    uses the first (only) iteration entry.
+    """
+    benchmarks = json.loads(output).get("benchmarks", [])
+    if not benchmarks:
+        return {"latency_ms": None, "throughput": None}
+    entry = next(
+        (b for b in benchmarks if b.get("aggregate_name") == "mean"),
+        benchmarks[0],
+    )
+    scale = _TIME_UNIT_TO_MS[entry.get("time_unit", "ns")]
+    return {
+        "latency_ms": entry["real_time"] * scale,
+        "throughput": entry.get("items_per_second"),
+    }
+
+
+def parse_peak_memory(output: str) -> Optional[int]:
+    """Parses the total peak bytes from --print_statistics output.
+
+    Returns None if the runtime was built without statistics.
+    """
+    peaks = [int(m.group(2)) for m in _PEAK_MEMORY_RE.finditer(output)]
+    return sum(peaks) if peaks else None
+
+
+###############################################################################
+# Compile times
+###############################################################################
+
+
+def _compile_time_path(vmfb: Artifact) -> Path:
+    return vmfb.path.with_suffix(vmfb.path.suffix + ".compile_time")
+
+
+def write_compile_time(vmfb: Artifact, seconds: float):
+    # Stored next to the artifact so that it survives cached compilations.
+    _compile_time_path(vmfb).write_text(f"{seconds}\n")
+
+
+def read_compile_time(vmfb: Artifact) -> Optional[float]:
+    try:
+        return float(_compile_time_path(vmfb).read_text())
+    except (FileNotFoundError, ValueError):
+        return None
+
+
+###############################################################################
+# History
+###############################################################################
+
+
+def load_history(path: Optional[Path] = None) -> List[BenchmarkResult]:
+    path = path or _CONFIG.get_history_path()
+    if not path.exists():
+        return []
+    with open(path, "r") as f:
+        return [BenchmarkResult.from_json(line) for line in f if line.strip()]
+
+
+def append_history(result: BenchmarkResult, path: Optional[Path] = None):
+    path = path or _CONFIG.get_history_path()
+    path.parent.mkdir(parents=True, exist_ok=True)
+    with open(path, "a") as f:
+        f.write(result.to_json() + "\n")
+
+
+def find_regressions(
+    result: BenchmarkResult,
+    history: Sequence[BenchmarkResult],
+    *,
+    thresholds: Optional[Dict[str, float]] = None,
+    baseline_window: Optional[int] = None,
+) -> List[str]:
+    """Returns a description of each metric of |result| that regressed.
+
+    The baseline of each metric is the median of the most recent matching
+    history entries, which keeps a single noisy run from moving it.
+    """
+    thresholds = thresholds or _CONFIG.thresholds
+    baseline_window = baseline_window or _CONFIG.baseline_window
+    matching = [h for h in history if h.key == result.key]
+    matching = matching[-baseline_window:]
+    regressions = []
+    for metric, higher_is_better in METRICS.items():
+        value = getattr(result, metric)
+        samples = [getattr(h, metric) for h in matching]
+        samples = [s for s in samples if s is not None]
+        if value is None or not samples or metric not in thresholds:
+            continue
+        baseline = statistics.median(samples)
+        if baseline == 0:
+            continue
+        change = (value - baseline) / baseline
+        if higher_is_better:
+            change = -change
+        if change > thresholds[metric]:
+            regressions.append(
+                f"{metric}: {value:.6g} vs baseline {baseline:.6g} "
+                f"({change * 100:.1f}% worse, threshold "
+                f"{thresholds[metric] * 100:.1f}%)"
+            )
+    return regressions
+
+
+def record_benchmark(result: BenchmarkResult):
+    """Checks |result| against the history and then appends it.
+
+    Raises BenchmarkRegression if any metric regressed beyond its threshold.
+    The result is recorded either way so that the history reflects every run.
+    """
+    history = load_history()
+    regressions = find_regressions(result, history)
+    append_history(result)
+    print(f"Benchmark result: {result.to_json()}")
+    if regressions and _CONFIG.check_regressions:
+        raise BenchmarkRegression(
+            f"Performance regression in {result.model} ({result.target}, "
+            f"{result.device}) @{result.function}:\n  " + "\n  ".join(regressions)
+        )
+
+
+def get_current_test_name() -> str:
+    # Set by pytest while a test is running: "path::name (call)".
+    return os.environ.get("PYTEST_CURRENT_TEST", "").split(" ")[0]
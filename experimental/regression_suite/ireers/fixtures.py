@@ -16,6 +16,15 @@ from .artifacts import (
     FetchedArtifact,
     ProducedArtifact,
 )
+from .benchmarks import (
+    BenchmarkResult,
+    get_current_test_name,
+    parse_benchmark_json,
+    parse_peak_memory,
+    read_compile_time,
+    record_benchmark,
+    write_compile_time,
+)
 
 
 IREE_COMPILE_QOL_FLAGS = [
@@ -58,6 +67,7 @@ def iree_compile(source: Artifact, compiled_variant: str, flags: Sequence[str]):
             exec_args, check=True, capture_output=True, cwd=source.group.directory
         )
         run_time = time.time() - start_time
+        write_compile_time(vmfb_artifact, run_time)
         print(f"Compilation succeeded in {run_time}s")
         print("**************************************************************")
 
@@ -80,15 +90,40 @@ def iree_run_module(vmfb: Artifact, *, device, function, args: Sequence[str] = (
 
 def iree_benchmark_module(
     vmfb: Artifact, *, device, function, args: Sequence[str] = ()
-):
+) -> BenchmarkResult:
+    """Benchmarks |function| and records the result in the benchmark history.
+
+    Raises BenchmarkRegression if the result regressed relative to the history.
+    """
     vmfb.join()
     exec_args = [
         "iree-benchmark-module",
         f"--device={device}",
         f"--module={vmfb.path}",
         f"--function={function}",
+        "--benchmark_format=json",
+        "--print_statistics",
     ]
     exec_args.extend(args)
     print("**************************************************************")
     print("Exec:", " ".join(exec_args))
-    subprocess.check_call(exec_args, cwd=vmfb.group.directory)
+    proc = subprocess.run(
+        exec_args, check=True, capture_output=True, text=True, cwd=vmfb.group.directory
+    )
+    print(proc.stdout)
+    print(proc.stderr)
+
+    # Artifacts are named <source>.<compiled_variant>.vmfb by iree_compile.
+    vmfb_name = Path(vmfb.name).with_suffix("")
+    result = BenchmarkResult(
+        model=vmfb_name.stem,
+        target=vmfb_name.suffix.lstrip("."),
+        device=device,
+        function=function,
+        peak_memory_bytes=parse_peak_memory(proc.stderr),
+        compile_time_s=read_compile_time(vmfb),
+        test=get_current_test_name(),
+        **parse_benchmark_json(proc.stdout),
+    )
+    record_benchmark(result)
+    return result
@@ -677,7 +677,8 @@ static iree_status_t allocate_mappable_device_buffer(
       target_params.access, target_params.usage, data_length,
       /*byte_offset=*/0,
       /*byte_length=*/data_length, device_buffer_handle,
-      iree_allocator_system(), out_buffer);
+      iree_hal_buffer_release_callback_null(), iree_allocator_system(),
+      out_buffer);
 }
 
 // Processes outputs from a completed function invocation.
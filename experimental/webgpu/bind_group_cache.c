@@ -47,10 +47,39 @@ void iree_hal_webgpu_bind_group_cache_trim(
     if (entry->handle) iree_wgpuBindGroupDrop(entry->handle);
   }
   memset(cache->entries, 0, sizeof(cache->entries));
+  cache->eviction_cursor = 0;
 
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Hashes the binding tuple identifying a bind group using FNV-1a.
+// Only bindings set in |binding_mask| contribute.
+static uint32_t iree_hal_webgpu_bind_group_hash(
+    WGPUBindGroupLayout group_layout,
+    const iree_hal_webgpu_bind_group_binding_t* bindings,
+    iree_hal_webgpu_binding_mask_t binding_mask) {
+  uint32_t hash = 2166136261u;
+#define IREE_HAL_WEBGPU_HASH_VALUE(value)     \
+  do {                                        \
+    uint64_t v = (uint64_t)(value);           \
+    for (int b = 0; b < 8; ++b, v >>= 8) {    \
+      hash = (hash ^ (uint8_t)v) * 16777619u; \
+    }                                         \
+  } while (0)
+  IREE_HAL_WEBGPU_HASH_VALUE((uintptr_t)group_layout);
+  IREE_HAL_WEBGPU_HASH_VALUE(binding_mask);
+  for (iree_host_size_t i = 0;
+       i < IREE_HAL_WEBGPU_MAX_DESCRIPTOR_SET_BINDING_COUNT; ++i) {
+    if (!(binding_mask & (1u << i))) continue;
+    IREE_HAL_WEBGPU_HASH_VALUE(bindings[i].type);
+    IREE_HAL_WEBGPU_HASH_VALUE((uintptr_t)bindings[i].buffer);
+    IREE_HAL_WEBGPU_HASH_VALUE(bindings[i].offset);
+    IREE_HAL_WEBGPU_HASH_VALUE(bindings[i].length);
+  }
+#undef IREE_HAL_WEBGPU_HASH_VALUE
+  return hash;
+}
+
 WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     iree_hal_webgpu_bind_group_cache_t* cache, WGPUBindGroupLayout group_layout,
     const iree_hal_webgpu_bind_group_binding_t* bindings,
@@ -59,25 +88,25 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
   IREE_ASSERT_ARGUMENT(bindings);
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // This is not a good algorithm :)
-  // We should probably have a split index and a mechanism to partition it such
-  // that lookups don't need to perform a full scan. This is cheaper than the
-  // cost of creating a new bind group per dispatch (no need to call out to
-  // WebGPU, allocate new objects, track those new objects lifetimes, etc) but
-  // not cheap. Ideally we'd be relying on this for 4-5 bind groups per command
-  // buffer at which point it doesn't matter but the compiler still needs to
-  // improve a bit there.
+  // Scanning the cache is much cheaper than creating a new bind group per
+  // dispatch (no need to call out to WebGPU, allocate new objects, track those
+  // new objects lifetimes, etc). Entries are keyed by a hash of the binding
+  // tuple so that misses only cost a compare per entry and the full bindings
+  // are only compared on a likely hit.
+  uint32_t hash =
+      iree_hal_webgpu_bind_group_hash(group_layout, bindings, binding_mask);
 
   // Scan the cache for entries with a matching group layout and binding mask.
   // These should be the same today but in the future we may want to allow for
   // subsetting as defined by bind group compatibility.
-  iree_host_size_t insertion_slot = cache->entry_count - 1;
+  iree_host_size_t insertion_slot = IREE_HOST_SIZE_MAX;
   for (iree_host_size_t i = 0; i < cache->entry_count; ++i) {
     iree_hal_webgpu_bind_group_cache_entry_t* entry = &cache->entries[i];
     if (!entry->handle) {
       insertion_slot = iree_min(insertion_slot, i);
       continue;
     }
+    if (entry->hash != hash) continue;
     if (entry->group_layout != group_layout) continue;
     if (entry->binding_mask != binding_mask) continue;
 
@@ -87,13 +116,18 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     // faster than what we'd have to do for that comparison.
     if (memcmp(bindings, entry->bindings, sizeof(entry->bindings)) == 0) {
       // Same exact bindings - cache hit!
-      // TODO(benvanik): a real LRU that rearranges this to the front/back.
       IREE_TRACE_ZONE_END(z0);
       return entry->handle;
     }
   }
 
-  // Evict an existing entry to store this new one or use the last unused slot.
+  // Use the first unused slot or evict an existing entry round-robin. Always
+  // evicting the same slot would thrash when a command buffer uses more bind
+  // groups than the cache can hold.
+  if (insertion_slot == IREE_HOST_SIZE_MAX) {
+    insertion_slot = cache->eviction_cursor;
+    cache->eviction_cursor = (cache->eviction_cursor + 1) % cache->entry_count;
+  }
   iree_hal_webgpu_bind_group_cache_entry_t* entry =
       &cache->entries[insertion_slot];
   if (entry->handle) {
@@ -103,6 +137,7 @@ WGPUBindGroup iree_hal_webgpu_bind_group_cache_acquire(
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
   }
   entry->group_layout = group_layout;
+  entry->hash = hash;
   entry->binding_mask = binding_mask;
   memcpy(entry->bindings, bindings, sizeof(entry->bindings));
 
@@ -16,11 +16,11 @@
 extern "C" {
 #endif  // __cplusplus
 
-// NOTE: this is probably too small, but this is all a hack anyway.
-// TODO(benvanik): build a real cache - today this is assuming the compiler does
-// a much better job than it currently does as reducing the number of push
-// descriptor sets.
-#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY 32
+// Maximum number of bind groups retained by the cache.
+// Lookups only compare full bindings for entries whose hash matches so this
+// can be larger than the handful of bind groups a typical command buffer uses
+// such that repeated submissions of the same program always hit.
+#define IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY 64
 
 // A subset of WGPUBindGroupEntry containing only what we need.
 // WGPUBindGroupEntry is quite large (has sampler and texture information).
@@ -39,6 +39,8 @@ typedef struct iree_hal_webgpu_bind_group_cache_entry_t {
   WGPUBindGroupLayout group_layout;
   // Cached WebGPU bind group containing the bindings.
   WGPUBindGroup handle;
+  // Hash of the group layout, binding mask, and used bindings.
+  uint32_t hash;
   // Each bit indicates a populated binding at the respective ordinal.
   iree_hal_webgpu_binding_mask_t binding_mask;
   // Each source binding to use for cache equality comparison.
@@ -52,6 +54,8 @@ typedef struct iree_hal_webgpu_bind_group_cache_entry_t {
 typedef struct iree_hal_webgpu_bind_group_cache_t {
   WGPUDevice device;
   iree_host_size_t entry_count;
+  // Next entry to evict when the cache is full.
+  iree_host_size_t eviction_cursor;
   iree_hal_webgpu_bind_group_cache_entry_t
       entries[IREE_HAL_WEBGPU_BIND_GROUP_CACHE_CAPACITY];
 } iree_hal_webgpu_bind_group_cache_t;
@@ -21,6 +21,7 @@ typedef struct iree_hal_webgpu_buffer_t {
   iree_hal_buffer_t base;
   iree_hal_device_t* device;  // unowned
   WGPUBuffer handle;
+  iree_hal_buffer_release_callback_t release_callback;
   bool is_mapped;
 } iree_hal_webgpu_buffer_t;
 
@@ -37,8 +38,8 @@ iree_status_t iree_hal_webgpu_buffer_wrap(
     iree_hal_memory_type_t memory_type, iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
-    WGPUBuffer handle, iree_allocator_t host_allocator,
-    iree_hal_buffer_t** out_buffer) {
+    WGPUBuffer handle, iree_hal_buffer_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(device_allocator);
   IREE_ASSERT_ARGUMENT(handle);
@@ -56,6 +57,7 @@ iree_status_t iree_hal_webgpu_buffer_wrap(
                                &iree_hal_webgpu_buffer_vtable, &buffer->base);
     buffer->device = device;
     buffer->handle = handle;
+    buffer->release_callback = release_callback;
     *out_buffer = &buffer->base;
   }
 
@@ -72,9 +74,15 @@ static void iree_hal_webgpu_buffer_destroy(iree_hal_buffer_t* base_buffer) {
     wgpuBufferUnmap(buffer->handle);
   }
 
-  // NOTE: this immediately destroys the buffer (in theory) and it must not be
-  // in use. That's ok because we also have that requirement in the HAL.
-  wgpuBufferDestroy(buffer->handle);
+  if (buffer->release_callback.fn) {
+    // The callback takes ownership of the handle.
+    buffer->release_callback.fn(buffer->release_callback.user_data,
+                                base_buffer);
+  } else {
+    // NOTE: this immediately destroys the buffer (in theory) and it must not be
+    // in use. That's ok because we also have that requirement in the HAL.
+    wgpuBufferDestroy(buffer->handle);
+  }
 
   iree_allocator_free(host_allocator, buffer);
 
@@ -129,6 +137,7 @@ static iree_status_t iree_hal_webgpu_buffer_flush_range(
 }
 
 const iree_hal_buffer_vtable_t iree_hal_webgpu_buffer_vtable = {
+    .recycle = iree_hal_buffer_recycle,
     .destroy = iree_hal_webgpu_buffer_destroy,
     .map_range = iree_hal_webgpu_buffer_map_range,
     .unmap_range = iree_hal_webgpu_buffer_unmap_range,
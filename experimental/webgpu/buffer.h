@@ -15,16 +15,17 @@
 extern "C" {
 #endif  // __cplusplus
 
-// TODO(benvanik): callback for releasing the buffer back to the allocator if
-// we start to support pooling.
-
+// Wraps a WGPUBuffer |handle| in a HAL buffer.
+// If |release_callback| is provided it is called when the buffer is destroyed
+// and takes ownership of |handle| (such as to return it to a pool); otherwise
+// the handle is destroyed along with the buffer.
 iree_status_t iree_hal_webgpu_buffer_wrap(
     iree_hal_device_t* device, iree_hal_allocator_t* device_allocator,
     iree_hal_memory_type_t memory_type, iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
-    WGPUBuffer handle, iree_allocator_t host_allocator,
-    iree_hal_buffer_t** out_buffer);
+    WGPUBuffer handle, iree_hal_buffer_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer);
 
 WGPUBuffer iree_hal_webgpu_buffer_handle(const iree_hal_buffer_t* buffer);
 
@@ -155,12 +155,23 @@ static void iree_hal_webgpu_make_entry_name(uint32_t entry_ordinal,
   }
 }
 
-// TODO(benvanik): switch to async compilation using
-// wgpuDeviceCreateComputePipelineAsync. We pack all pipelines into a single
-// executable (usually) and can batch compilation of all of them and only
-// join at the end. Technically we could extend the join point until first use
-// but it's harder to reason about lifetime that way. Today we just compile
-// them all synchronously.
+static void iree_hal_webgpu_make_pipeline_descriptor(
+    WGPUShaderModule shader_module, const char* entry_name,
+    iree_hal_pipeline_layout_t* pipeline_layout,
+    WGPUComputePipelineDescriptor* out_descriptor) {
+  *out_descriptor = (WGPUComputePipelineDescriptor){
+      .nextInChain = NULL,
+      .label = WGPU_DEBUG_LABEL(entry_name),
+      .layout = iree_hal_webgpu_pipeline_layout_handle(pipeline_layout),
+      .compute =
+          {
+              .nextInChain = NULL,
+              .module = shader_module,
+              .entryPoint = entry_name,
+          },
+  };
+}
+
 static iree_status_t iree_hal_webgpu_create_pipeline(
     WGPUDevice device, WGPUShaderModule shader_module, uint32_t entry_ordinal,
     iree_hal_pipeline_layout_t* pipeline_layout,
@@ -173,17 +184,10 @@ static iree_status_t iree_hal_webgpu_create_pipeline(
   char entry_name[IREE_HAL_WEBGPU_MAX_ENTRY_NAME_LENGTH] = {0};
   iree_hal_webgpu_make_entry_name(entry_ordinal, entry_name);
 
-  const WGPUComputePipelineDescriptor pipeline_descriptor = {
-      .nextInChain = NULL,
-      .label = WGPU_DEBUG_LABEL(entry_name),
-      .layout = iree_hal_webgpu_pipeline_layout_handle(pipeline_layout),
-      .compute =
-          {
-              .nextInChain = NULL,
-              .module = shader_module,
-              .entryPoint = entry_name,
-          },
-  };
+  WGPUComputePipelineDescriptor pipeline_descriptor;
+  iree_hal_webgpu_make_pipeline_descriptor(shader_module, entry_name,
+                                           pipeline_layout,
+                                           &pipeline_descriptor);
 
   WGPUComputePipeline pipeline =
       wgpuDeviceCreateComputePipeline(device, &pipeline_descriptor);
@@ -204,6 +208,115 @@ static iree_status_t iree_hal_webgpu_create_pipeline(
   return status;
 }
 
+// A batch of pipelines being created with wgpuDeviceCreateComputePipelineAsync.
+// All pipelines of an executable are issued together so that implementations
+// can compile them in parallel and we only join once all have completed.
+typedef struct iree_hal_webgpu_pipeline_batch_t {
+  // Number of issued pipelines that have not yet had their callback called.
+  iree_host_size_t pending_count;
+  // First failure reported by a callback, if any.
+  iree_status_t status;
+} iree_hal_webgpu_pipeline_batch_t;
+
+// User data for a single pipeline callback in a batch.
+typedef struct iree_hal_webgpu_pipeline_request_t {
+  iree_hal_webgpu_pipeline_batch_t* batch;
+  iree_hal_webgpu_entry_point_t* entry_point;
+  uint32_t entry_ordinal;
+} iree_hal_webgpu_pipeline_request_t;
+
+static void iree_hal_webgpu_pipeline_batch_callback(
+    WGPUCreatePipelineAsyncStatus status, WGPUComputePipeline pipeline,
+    char const* message, void* userdata) {
+  iree_hal_webgpu_pipeline_request_t* request =
+      (iree_hal_webgpu_pipeline_request_t*)userdata;
+  if (status == WGPUCreatePipelineAsyncStatus_Success && pipeline) {
+    request->entry_point->pipeline = pipeline;
+  } else if (iree_status_is_ok(request->batch->status)) {
+    request->batch->status = iree_make_status(
+        IREE_STATUS_INTERNAL,
+        "wgpuDeviceCreateComputePipelineAsync failed for entry point %u: %s",
+        request->entry_ordinal, message ? message : "(no message)");
+  }
+  --request->batch->pending_count;
+}
+
+// Creates the pipelines for all |entry_point_count| entry points in parallel
+// and waits for all of them to complete.
+// Falls back to synchronous creation if the implementation is unable to
+// process callbacks from within this call.
+static iree_status_t iree_hal_webgpu_create_pipelines(
+    WGPUDevice device, iree_hal_wgsl_ExecutableDef_table_t executable_def,
+    const WGPUShaderModule* shader_modules,
+    iree_hal_pipeline_layout_t* const* pipeline_layouts,
+    iree_host_size_t entry_point_count,
+    iree_hal_webgpu_entry_point_t* entry_points,
+    iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)entry_point_count);
+
+  flatbuffers_uint32_vec_t entry_points_vec =
+      iree_hal_wgsl_ExecutableDef_entry_points_get(executable_def);
+
+  // If we can't wait for callbacks then create the pipelines one at a time.
+  if (!iree_wgpuDeviceProcessEvents(device)) {
+    iree_status_t status = iree_ok_status();
+    for (iree_host_size_t i = 0; i < entry_point_count; ++i) {
+      uint32_t module_ordinal = flatbuffers_uint32_vec_at(entry_points_vec, i);
+      status = iree_hal_webgpu_create_pipeline(
+          device, shader_modules[module_ordinal], i, pipeline_layouts[i],
+          &entry_points[i]);
+      if (!iree_status_is_ok(status)) break;
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_hal_webgpu_pipeline_batch_t batch = {
+      .pending_count = 0,
+      .status = iree_ok_status(),
+  };
+  iree_inline_array(iree_hal_webgpu_pipeline_request_t, requests,
+                    entry_point_count, host_allocator);
+
+  // Issue all pipelines. The entry point takes ownership of the layout
+  // reference immediately so that cleanup on failure is uniform.
+  for (iree_host_size_t i = 0; i < entry_point_count; ++i) {
+    uint32_t module_ordinal = flatbuffers_uint32_vec_at(entry_points_vec, i);
+    entry_points[i].layout = pipeline_layouts[i];
+    iree_hal_pipeline_layout_retain(pipeline_layouts[i]);
+
+    iree_hal_webgpu_pipeline_request_t* request =
+        iree_inline_array_at(requests, i);
+    request->batch = &batch;
+    request->entry_point = &entry_points[i];
+    request->entry_ordinal = (uint32_t)i;
+
+    // The descriptor (including the entry name) only needs to live for the
+    // duration of the call.
+    char entry_name[IREE_HAL_WEBGPU_MAX_ENTRY_NAME_LENGTH] = {0};
+    iree_hal_webgpu_make_entry_name(i, entry_name);
+    WGPUComputePipelineDescriptor pipeline_descriptor;
+    iree_hal_webgpu_make_pipeline_descriptor(shader_modules[module_ordinal],
+                                             entry_name, pipeline_layouts[i],
+                                             &pipeline_descriptor);
+    ++batch.pending_count;
+    wgpuDeviceCreateComputePipelineAsync(
+        device, &pipeline_descriptor, iree_hal_webgpu_pipeline_batch_callback,
+        request);
+  }
+
+  // Join. The requests live on our stack so we must wait for every callback
+  // even if one has already failed.
+  while (batch.pending_count > 0) {
+    iree_wgpuDeviceProcessEvents(device);
+  }
+
+  iree_inline_array_deinitialize(requests);
+  IREE_TRACE_ZONE_END(z0);
+  return batch.status;
+}
+
 iree_status_t iree_hal_webgpu_executable_create(
     WGPUDevice device, const iree_hal_executable_params_t* executable_params,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
@@ -269,15 +382,10 @@ iree_status_t iree_hal_webgpu_executable_create(
     executable->entry_point_count = executable_params->pipeline_layout_count;
 
     // Create one pipeline per entry point.
-    flatbuffers_uint32_vec_t entry_points_vec =
-        iree_hal_wgsl_ExecutableDef_entry_points_get(executable_def);
-    for (iree_host_size_t i = 0; i < executable->entry_point_count; i++) {
-      uint32_t module_ordinal = flatbuffers_uint32_vec_at(entry_points_vec, i);
-      status = iree_hal_webgpu_create_pipeline(
-          device, *iree_inline_array_at(shader_modules, module_ordinal), i,
-          executable_params->pipeline_layouts[i], &executable->entry_points[i]);
-      if (!iree_status_is_ok(status)) break;
-    }
+    status = iree_hal_webgpu_create_pipelines(
+        device, executable_def, iree_inline_array_data(shader_modules),
+        executable_params->pipeline_layouts, executable->entry_point_count,
+        executable->entry_points, host_allocator);
   }
 
   for (size_t i = 0; i < shader_module_count; ++i) {
@@ -304,7 +412,9 @@ static void iree_hal_webgpu_executable_destroy(
   for (iree_host_size_t i = 0; i < executable->entry_point_count; i++) {
     iree_hal_webgpu_entry_point_t* entry_point = &executable->entry_points[i];
     iree_hal_pipeline_layout_release(entry_point->layout);
-    iree_wgpuComputePipelineDrop(entry_point->pipeline);
+    if (entry_point->pipeline) {
+      iree_wgpuComputePipelineDrop(entry_point->pipeline);
+    }
   }
   iree_allocator_free(host_allocator, executable);
 
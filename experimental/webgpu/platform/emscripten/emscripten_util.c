@@ -6,6 +6,8 @@
 
 #include "experimental/webgpu/platform/webgpu.h"
 
+#include <emscripten.h>
+
 //===----------------------------------------------------------------------===//
 // Implementation compatibility layer
 //===----------------------------------------------------------------------===//
@@ -52,3 +54,14 @@ void iree_wgpuQuerySetDrop(WGPUQuerySet querySet) {
 void iree_wgpuShaderModuleDrop(WGPUShaderModule shaderModule) {
   // Not implemented on the web / Emscripten.
 }
+
+bool iree_wgpuDeviceProcessEvents(WGPUDevice device) {
+#ifdef EM_ASYNC_JS
+  // Callbacks are only delivered once control returns to the browser.
+  emscripten_sleep(0);
+  return true;
+#else
+  // Without Asyncify we are unable to return to the event loop.
+  return false;
+#endif  // EM_ASYNC_JS
+}
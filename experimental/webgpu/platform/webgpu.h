@@ -54,6 +54,13 @@ void iree_wgpuPipelineLayoutDrop(WGPUPipelineLayout pipelineLayout);
 void iree_wgpuQuerySetDrop(WGPUQuerySet querySet);
 void iree_wgpuShaderModuleDrop(WGPUShaderModule shaderModule);
 
+// Processes pending asynchronous callbacks issued on |device|, such as those
+// from wgpuDeviceCreateComputePipelineAsync. In the browser this yields to the
+// event loop and requires Asyncify. Returns false if the implementation is
+// unable to process events synchronously, in which case callers must not block
+// waiting on callbacks.
+bool iree_wgpuDeviceProcessEvents(WGPUDevice device);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
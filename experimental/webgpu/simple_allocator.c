@@ -11,6 +11,38 @@
 #include "experimental/webgpu/buffer.h"
 #include "experimental/webgpu/webgpu_device.h"
 #include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+
+// Range of allocation sizes that are served from the buffer pool.
+// Allocations in this range are rounded up to the next power of two (the size
+// class) so that released buffers can be reused by any later allocation in the
+// same class with the same usage. Larger allocations are not pooled as the
+// waste from rounding starts to dominate.
+#define IREE_HAL_WEBGPU_BUFFER_POOL_MIN_SIZE_LOG2 8   // 256B
+#define IREE_HAL_WEBGPU_BUFFER_POOL_MAX_SIZE_LOG2 26  // 64MB
+#define IREE_HAL_WEBGPU_BUFFER_POOL_CLASS_COUNT   \
+  (IREE_HAL_WEBGPU_BUFFER_POOL_MAX_SIZE_LOG2 -    \
+   IREE_HAL_WEBGPU_BUFFER_POOL_MIN_SIZE_LOG2 + 1)
+
+// Maximum number of released buffers retained per size class.
+#define IREE_HAL_WEBGPU_BUFFER_POOL_CLASS_CAPACITY 8
+
+// Maximum total size of released buffers retained across all size classes.
+#define IREE_HAL_WEBGPU_BUFFER_POOL_MAX_RETAINED_SIZE (256 * 1024 * 1024)
+
+// A released WGPUBuffer available for reuse.
+typedef struct iree_hal_webgpu_pooled_buffer_t {
+  WGPUBufferUsageFlags usage;
+  WGPUBuffer handle;
+} iree_hal_webgpu_pooled_buffer_t;
+
+// Released buffers of a single size class.
+typedef struct iree_hal_webgpu_buffer_pool_class_t {
+  iree_host_size_t count;
+  iree_hal_webgpu_pooled_buffer_t
+      buffers[IREE_HAL_WEBGPU_BUFFER_POOL_CLASS_CAPACITY];
+} iree_hal_webgpu_buffer_pool_class_t;
 
 typedef struct iree_hal_webgpu_simple_allocator_t {
   iree_hal_resource_t resource;
@@ -18,6 +50,15 @@ typedef struct iree_hal_webgpu_simple_allocator_t {
   iree_hal_device_t* device;
   iree_string_view_t identifier;
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
+
+  // Pool of released buffers keyed by size class and usage. Creating and
+  // destroying GPUBuffers crosses into JavaScript in the browser and is much
+  // more expensive than the bookkeeping here.
+  iree_slim_mutex_t pool_mutex;
+  iree_device_size_t pool_retained_size IREE_GUARDED_BY(pool_mutex);
+  iree_hal_webgpu_buffer_pool_class_t
+      pool_classes[IREE_HAL_WEBGPU_BUFFER_POOL_CLASS_COUNT] IREE_GUARDED_BY(
+          pool_mutex);
 } iree_hal_webgpu_simple_allocator_t;
 
 extern const iree_hal_allocator_vtable_t
@@ -47,6 +88,7 @@ iree_status_t iree_hal_webgpu_simple_allocator_create(
                                  &allocator->resource);
     allocator->host_allocator = host_allocator;
     allocator->device = device;
+    iree_slim_mutex_initialize(&allocator->pool_mutex);
     iree_string_view_append_to_buffer(identifier, &allocator->identifier,
                                       (char*)allocator + struct_size);
     *out_allocator = (iree_hal_allocator_t*)allocator;
@@ -56,6 +98,9 @@ iree_status_t iree_hal_webgpu_simple_allocator_create(
   return status;
 }
 
+static iree_status_t iree_hal_webgpu_simple_allocator_trim(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator);
+
 static void iree_hal_webgpu_simple_allocator_destroy(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   iree_hal_webgpu_simple_allocator_t* allocator =
@@ -63,6 +108,8 @@ static void iree_hal_webgpu_simple_allocator_destroy(
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_webgpu_simple_allocator_trim(base_allocator);
+  iree_slim_mutex_deinitialize(&allocator->pool_mutex);
   iree_allocator_free(host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
@@ -77,6 +124,24 @@ static iree_allocator_t iree_hal_webgpu_simple_allocator_host_allocator(
 
 static iree_status_t iree_hal_webgpu_simple_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_webgpu_simple_allocator_t* allocator =
+      iree_hal_webgpu_simple_allocator_cast(base_allocator);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&allocator->pool_mutex);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(allocator->pool_classes);
+       ++i) {
+    iree_hal_webgpu_buffer_pool_class_t* pool_class =
+        &allocator->pool_classes[i];
+    for (iree_host_size_t j = 0; j < pool_class->count; ++j) {
+      wgpuBufferDestroy(pool_class->buffers[j].handle);
+    }
+    pool_class->count = 0;
+  }
+  allocator->pool_retained_size = 0;
+  iree_slim_mutex_unlock(&allocator->pool_mutex);
+
+  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
@@ -125,29 +190,15 @@ iree_hal_webgpu_simple_allocator_query_buffer_compatibility(
   return compatibility;
 }
 
-static iree_status_t iree_hal_webgpu_simple_allocator_allocate_buffer(
-    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
-    const iree_hal_buffer_params_t* IREE_RESTRICT params,
-    iree_device_size_t allocation_size,
-    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  IREE_ASSERT_ARGUMENT(base_allocator);
-  IREE_ASSERT_ARGUMENT(params);
-  IREE_ASSERT_ARGUMENT(out_buffer);
-  *out_buffer = NULL;
-  iree_hal_webgpu_simple_allocator_t* allocator =
-      iree_hal_webgpu_simple_allocator_cast(base_allocator);
-
-  // Guard against the corner case where the requested buffer size is 0. The
-  // application is unlikely to do anything when requesting a 0-byte buffer; but
-  // it can happen in real world use cases. So we should at least not crash.
-  if (allocation_size == 0) allocation_size = 4;
-
+// Returns the WGPUBufferUsageFlags required for a buffer with HAL |usage|.
+static WGPUBufferUsageFlags iree_hal_webgpu_select_buffer_usage(
+    iree_hal_buffer_usage_t usage) {
   WGPUBufferUsageFlags usage_flags = WGPUBufferUsage_None;
-  if (iree_all_bits_set(params->usage, IREE_HAL_BUFFER_USAGE_TRANSFER)) {
+  if (iree_all_bits_set(usage, IREE_HAL_BUFFER_USAGE_TRANSFER)) {
     usage_flags |= WGPUBufferUsage_CopySrc;
     usage_flags |= WGPUBufferUsage_CopyDst;
   }
-  if (iree_all_bits_set(params->usage, IREE_HAL_BUFFER_USAGE_MAPPING)) {
+  if (iree_all_bits_set(usage, IREE_HAL_BUFFER_USAGE_MAPPING)) {
     // Requirements from https://gpuweb.github.io/gpuweb/#buffer-usage:
     //   * MAP_WRITE can only be combined with COPY_SRC
     //   * MAP_READ  can only be combined with COPY_DST
@@ -161,49 +212,152 @@ static iree_status_t iree_hal_webgpu_simple_allocator_allocate_buffer(
     //     };
     //     buffer = wgpuDeviceCreateBuffer(device, descriptor);
     //     iree_hal_webgpu_buffer_wrap(..., buffer, ...);
-    if (iree_all_bits_set(params->usage, IREE_HAL_BUFFER_USAGE_TRANSFER) &&
-        !iree_any_bit_set(params->usage,
-                          IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE)) {
+    if (iree_all_bits_set(usage, IREE_HAL_BUFFER_USAGE_TRANSFER) &&
+        !iree_any_bit_set(usage, IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE)) {
       usage_flags |= WGPUBufferUsage_MapWrite;
       usage_flags &= ~(WGPUBufferUsage_CopyDst);  // Clear CopyDst
     }
   }
-  if (iree_any_bit_set(params->usage, IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE)) {
+  if (iree_any_bit_set(usage, IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE)) {
     usage_flags |= WGPUBufferUsage_Storage;
   }
-  if (iree_any_bit_set(params->usage,
-                       IREE_HAL_BUFFER_USAGE_DISPATCH_UNIFORM_READ)) {
+  if (iree_any_bit_set(usage, IREE_HAL_BUFFER_USAGE_DISPATCH_UNIFORM_READ)) {
     usage_flags |= WGPUBufferUsage_Uniform;
   }
-  if (iree_any_bit_set(params->usage,
-                       IREE_HAL_BUFFER_USAGE_DISPATCH_INDIRECT_PARAMS)) {
+  if (iree_any_bit_set(usage, IREE_HAL_BUFFER_USAGE_DISPATCH_INDIRECT_PARAMS)) {
     usage_flags |= WGPUBufferUsage_Indirect;
   }
+  return usage_flags;
+}
+
+// Returns the size class index for |allocation_size| and rounds it up to the
+// class size, or returns -1 if the allocation is too large to be pooled.
+static int iree_hal_webgpu_select_buffer_pool_class(
+    iree_device_size_t* allocation_size) {
+  if (*allocation_size > (1ull << IREE_HAL_WEBGPU_BUFFER_POOL_MAX_SIZE_LOG2)) {
+    return -1;
+  }
+  uint64_t class_size = iree_max(
+      iree_math_round_up_to_pow2_u64((uint64_t)*allocation_size),
+      1ull << IREE_HAL_WEBGPU_BUFFER_POOL_MIN_SIZE_LOG2);
+  *allocation_size = (iree_device_size_t)class_size;
+  return (63 - iree_math_count_leading_zeros_u64(class_size)) -
+         IREE_HAL_WEBGPU_BUFFER_POOL_MIN_SIZE_LOG2;
+}
+
+// Tries to acquire a released buffer of |class_index| with exactly |usage|.
+// Returns NULL if none are available.
+static WGPUBuffer iree_hal_webgpu_simple_allocator_acquire_pooled(
+    iree_hal_webgpu_simple_allocator_t* allocator, int class_index,
+    WGPUBufferUsageFlags usage) {
+  WGPUBuffer handle = NULL;
+  iree_slim_mutex_lock(&allocator->pool_mutex);
+  iree_hal_webgpu_buffer_pool_class_t* pool_class =
+      &allocator->pool_classes[class_index];
+  for (iree_host_size_t i = 0; i < pool_class->count; ++i) {
+    if (pool_class->buffers[i].usage != usage) continue;
+    handle = pool_class->buffers[i].handle;
+    pool_class->buffers[i] = pool_class->buffers[--pool_class->count];
+    allocator->pool_retained_size -=
+        1ull << (class_index + IREE_HAL_WEBGPU_BUFFER_POOL_MIN_SIZE_LOG2);
+    break;
+  }
+  iree_slim_mutex_unlock(&allocator->pool_mutex);
+  return handle;
+}
+
+// Called when a pooled buffer is destroyed to return its handle to the pool.
+// The handle is destroyed if the pool is full.
+static void iree_hal_webgpu_simple_allocator_release_pooled(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_webgpu_simple_allocator_t* allocator =
+      (iree_hal_webgpu_simple_allocator_t*)user_data;
+  WGPUBuffer handle = iree_hal_webgpu_buffer_handle(buffer);
+  iree_device_size_t class_size = iree_hal_buffer_allocation_size(buffer);
+  int class_index = iree_hal_webgpu_select_buffer_pool_class(&class_size);
+  IREE_ASSERT(class_index >= 0);
+
+  bool retained = false;
+  iree_slim_mutex_lock(&allocator->pool_mutex);
+  iree_hal_webgpu_buffer_pool_class_t* pool_class =
+      &allocator->pool_classes[class_index];
+  if (pool_class->count < IREE_ARRAYSIZE(pool_class->buffers) &&
+      allocator->pool_retained_size + class_size <=
+          IREE_HAL_WEBGPU_BUFFER_POOL_MAX_RETAINED_SIZE) {
+    iree_hal_webgpu_pooled_buffer_t* entry =
+        &pool_class->buffers[pool_class->count++];
+    entry->usage = iree_hal_webgpu_select_buffer_usage(
+        iree_hal_buffer_allowed_usage(buffer));
+    entry->handle = handle;
+    allocator->pool_retained_size += class_size;
+    retained = true;
+  }
+  iree_slim_mutex_unlock(&allocator->pool_mutex);
+
+  if (!retained) wgpuBufferDestroy(handle);
+}
+
+static iree_status_t iree_hal_webgpu_simple_allocator_allocate_buffer(
+    iree_hal_allocator_t* IREE_RESTRICT base_allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  IREE_ASSERT_ARGUMENT(base_allocator);
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  iree_hal_webgpu_simple_allocator_t* allocator =
+      iree_hal_webgpu_simple_allocator_cast(base_allocator);
+
+  // Guard against the corner case where the requested buffer size is 0. The
+  // application is unlikely to do anything when requesting a 0-byte buffer; but
+  // it can happen in real world use cases. So we should at least not crash.
+  if (allocation_size == 0) allocation_size = 4;
+
+  WGPUBufferUsageFlags usage_flags =
+      iree_hal_webgpu_select_buffer_usage(params->usage);
+
+  // Round up to the size class and try to reuse a released buffer.
+  iree_device_size_t class_size = allocation_size;
+  int class_index = iree_hal_webgpu_select_buffer_pool_class(&class_size);
+  WGPUBuffer buffer_handle = NULL;
+  iree_hal_buffer_release_callback_t release_callback =
+      iree_hal_buffer_release_callback_null();
+  if (class_index >= 0) {
+    buffer_handle = iree_hal_webgpu_simple_allocator_acquire_pooled(
+        allocator, class_index, usage_flags);
+    release_callback.fn = iree_hal_webgpu_simple_allocator_release_pooled;
+    release_callback.user_data = allocator;
+  } else {
+    class_size = allocation_size;
+  }
 
-  WGPUBufferDescriptor descriptor = {
-      .nextInChain = NULL,
-      .label = NULL,
-      .usage = usage_flags,
-      .size = allocation_size,
-      .mappedAtCreation = false,
-  };
-  WGPUBuffer buffer_handle = wgpuDeviceCreateBuffer(
-      iree_hal_webgpu_device_handle(allocator->device), &descriptor);
   if (!buffer_handle) {
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                            "unable to allocate buffer of size %" PRIdsz,
-                            allocation_size);
+    WGPUBufferDescriptor descriptor = {
+        .nextInChain = NULL,
+        .label = NULL,
+        .usage = usage_flags,
+        .size = class_size,
+        .mappedAtCreation = false,
+    };
+    buffer_handle = wgpuDeviceCreateBuffer(
+        iree_hal_webgpu_device_handle(allocator->device), &descriptor);
+    if (!buffer_handle) {
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "unable to allocate buffer of size %" PRIdsz,
+                              class_size);
+    }
   }
 
   iree_status_t status = iree_hal_webgpu_buffer_wrap(
       allocator->device, base_allocator, params->type, params->access,
-      params->usage, allocation_size,
+      params->usage, class_size,
       /*byte_offset=*/0,
-      /*byte_length=*/allocation_size, buffer_handle, allocator->host_allocator,
-      out_buffer);
+      /*byte_length=*/allocation_size, buffer_handle, release_callback,
+      allocator->host_allocator, out_buffer);
   if (iree_status_is_ok(status)) {
     IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
-        &allocator->statistics, params->type, allocation_size));
+        &allocator->statistics, params->type, class_size));
   } else {
     wgpuBufferDestroy(buffer_handle);
   }
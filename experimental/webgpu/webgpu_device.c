@@ -204,6 +204,8 @@ WGPUDevice iree_hal_webgpu_device_handle(iree_hal_device_t* base_device) {
 static iree_status_t iree_hal_webgpu_device_trim(
     iree_hal_device_t* base_device) {
   iree_hal_webgpu_device_t* device = iree_hal_webgpu_device_cast(base_device);
+  // Bind groups may reference pooled buffers that the allocator trim destroys.
+  iree_hal_webgpu_bind_group_cache_trim(&device->bind_group_cache);
   iree_arena_block_pool_trim(&device->small_block_pool);
   iree_arena_block_pool_trim(&device->large_block_pool);
   return iree_hal_allocator_trim(device->device_allocator);
@@ -260,6 +260,87 @@ HalBuffer HalAllocator::AllocateHostStagingBufferCopy(HalDevice& device,
   return HalBuffer::StealFromRawPtr(hal_buffer);
 }
 
+py::object HalAllocator::ImportHostBuffer(
+    int memory_type, int allowed_usage, py::object buffer,
+    std::optional<iree_hal_element_types_t> element_type) {
+  IREE_TRACE_SCOPE_NAMED("HalAllocator::ImportHostBuffer");
+  // The Py_buffer is kept alive (and with it the exporting object) until the
+  // HAL buffer is released. Only C-Contiguous ND-arrays can be imported.
+  auto py_view = std::make_unique<Py_buffer>();
+  int flags = PyBUF_FORMAT | PyBUF_ND;
+  if (PyObject_GetBuffer(buffer.ptr(), py_view.get(), flags) != 0) {
+    // The GetBuffer call is required to set an appropriate error.
+    throw py::python_error();
+  }
+  std::vector<iree_hal_dim_t> dims(py_view->ndim);
+  std::copy(py_view->shape, py_view->shape + py_view->ndim, dims.begin());
+
+  iree_hal_buffer_params_t params = {0};
+  params.type = memory_type;
+  params.usage = allowed_usage;
+  params.access = py_view->readonly ? IREE_HAL_MEMORY_ACCESS_READ
+                                    : IREE_HAL_MEMORY_ACCESS_ALL;
+  iree_device_size_t allocation_size = py_view->len;
+  // Codegen assumes bindings are aligned as if they were allocated by the
+  // device; unaligned host memory must be copied instead.
+  if (reinterpret_cast<uintptr_t>(py_view->buf) %
+              IREE_HAL_HEAP_BUFFER_ALIGNMENT !=
+          0 ||
+      !iree_all_bits_set(
+          iree_hal_allocator_query_buffer_compatibility(
+              raw_ptr(), params, allocation_size, &params, &allocation_size),
+          IREE_HAL_BUFFER_COMPATIBILITY_IMPORTABLE)) {
+    PyBuffer_Release(py_view.get());
+    return py::none();
+  }
+
+  iree_hal_external_buffer_t external_buffer;
+  memset(&external_buffer, 0, sizeof(external_buffer));
+  external_buffer.type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION;
+  external_buffer.size = py_view->len;
+  external_buffer.handle.host_allocation.ptr = py_view->buf;
+  iree_hal_buffer_release_callback_t release_callback = {
+      +[](void* user_data, struct iree_hal_buffer_t* buffer) {
+        auto* released_view = static_cast<Py_buffer*>(user_data);
+        // Buffers may be released from any thread and during interpreter
+        // shutdown, after which the exporter no longer exists.
+        if (Py_IsInitialized()) {
+          py::gil_scoped_acquire acquire;
+          PyBuffer_Release(released_view);
+        }
+        delete released_view;
+      },
+      py_view.get(),
+  };
+  iree_hal_buffer_t* hal_buffer = nullptr;
+  iree_status_t status = iree_hal_allocator_import_buffer(
+      raw_ptr(), params, &external_buffer, release_callback, &hal_buffer);
+  if (!iree_status_is_ok(status)) {
+    // Not all memory can be imported (for example when a device cannot
+    // register pageable host memory) and callers fall back to copying.
+    iree_status_ignore(status);
+    PyBuffer_Release(py_view.get());
+    return py::none();
+  }
+  // Ownership of the view transferred to the release callback.
+  py_view.release();
+
+  if (!element_type) {
+    return py::cast(HalBuffer::StealFromRawPtr(hal_buffer),
+                    py::rv_policy::move);
+  }
+
+  iree_hal_buffer_view_t* hal_buffer_view;
+  status = iree_hal_buffer_view_create(
+      hal_buffer, dims.size(), dims.data(), *element_type,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      iree_hal_allocator_host_allocator(raw_ptr()), &hal_buffer_view);
+  iree_hal_buffer_release(hal_buffer);
+  CheckApiStatus(status, "Error allocating buffer_view");
+  return py::cast(HalBufferView::StealFromRawPtr(hal_buffer_view),
+                  py::rv_policy::move);
+}
+
 //------------------------------------------------------------------------------
 // HalBuffer
 //------------------------------------------------------------------------------
@@ -1346,7 +1427,19 @@ void SetupHalBindings(nanobind::module_ m) {
            "object. The buffer is configured as optimal for use on the device "
            "as a transfer buffer. For buffers of unknown providence, this is a "
            "last resort method for making them compatible for transfer to "
-           "arbitrary devices.");
+           "arbitrary devices.")
+      .def("import_host_buffer", &HalAllocator::ImportHostBuffer,
+           py::arg("memory_type"), py::arg("allowed_usage"), py::arg("buffer"),
+           py::arg("element_type") = py::none(), py::keep_alive<0, 1>(),
+           "Imports a Python buffer object without copying it. The returned "
+           "buffer (or BufferView if an element type is specified) aliases "
+           "the host memory and keeps the object alive for as long as it is "
+           "in use; the contents must not be modified while the device may "
+           "be accessing them. Returns None if the allocator cannot import "
+           "the memory with the requested characteristics (such as when it "
+           "is not suitably aligned), in which case callers should fall back "
+           "to allocate_buffer_copy. On devices with discrete memory, "
+           "HOST_LOCAL | DEVICE_VISIBLE imports pin the host memory.");
 
   auto hal_buffer = py::class_<HalBuffer>(m, "HalBuffer");
   VmRef::BindRefProtocol(hal_buffer, iree_hal_buffer_type,
@@ -36,6 +36,22 @@ class InvokeContext {
   HalDevice device_;
 };
 
+// Wraps a C-contiguous host array in a buffer view for use on the device of
+// |c|. Devices that can access host memory import the array without copying
+// and others (or unaligned arrays) get a device copy.
+py::object ImportOrCopyHostArray(InvokeContext &c, py::object host_array,
+                                 iree_hal_element_types_t element_type) {
+  const int memory_type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  const int allowed_usage =
+      IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+  HalAllocator allocator = c.allocator();
+  py::object imported_bv = allocator.ImportHostBuffer(
+      memory_type, allowed_usage, host_array, element_type);
+  if (!imported_bv.is_none()) return imported_bv;
+  return allocator.AllocateBufferCopy(memory_type, allowed_usage, c.device(),
+                                      host_array, element_type);
+}
+
 using PackCallback =
     std::function<void(InvokeContext &, iree_vm_list_t *, py::handle)>;
 
@@ -197,10 +213,8 @@ class InvokeStatics {
               throw std::invalid_argument(std::move(msg));
             }
 
-            retained_bv = c.allocator().AllocateBufferCopy(
-                IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
-                IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING,
-                c.device(), host_array, hal_element_type);
+            retained_bv = ImportOrCopyHostArray(c, host_array,
+                                                hal_element_type);
             bv = py::cast<HalBufferView *>(retained_bv);
           }
 
@@ -402,10 +416,8 @@ class InvokeStatics {
           MapDtypeToElementType(host_array.attr(kDtypeAttr));
 
       // Put it on the device.
-      py::object retained_bv = c.allocator().AllocateBufferCopy(
-          IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
-          IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING,
-          c.device(), host_array, hal_element_type);
+      py::object retained_bv =
+          ImportOrCopyHostArray(c, host_array, hal_element_type);
       HalBufferView *bv = py::cast<HalBufferView *>(retained_bv);
 
       // TODO: If adding further manipulation here, please make this common
@@ -17,6 +17,7 @@
 #include "iree/io/formats/irpa/irpa_builder.h"
 #include "iree/io/formats/parser_registry.h"
 #include "iree/io/parameter_index_provider.h"
+#include "iree/modules/io/outputs/module.h"
 #include "iree/modules/io/parameters/module.h"
 #include "iree/schemas/parameter_archive.h"
 
@@ -40,6 +41,45 @@ VmModule CreateIoParametersModule(VmInstance &instance, py::args providers) {
   return VmModule::StealFromRawPtr(module);
 }
 
+VmModule CreateIoOutputsModule(VmInstance &instance, py::args channels) {
+  iree_vm_module_t *module = nullptr;
+  std::vector<iree_io_output_channel_t *> c_channels;
+  iree_host_size_t size = channels.size();
+  c_channels.resize(size);
+  for (iree_host_size_t i = 0; i < size; ++i) {
+    OutputChannel *channel = py::cast<OutputChannel *>(channels[i]);
+    c_channels[i] = channel->raw_ptr();
+  }
+  CheckApiStatus(iree_io_outputs_module_create(
+                     instance.raw_ptr(), size, c_channels.data(),
+                     iree_allocator_system(), &module),
+                 "Error creating io_outputs module");
+  return VmModule::StealFromRawPtr(module);
+}
+
+// Reads the next item from |channel| or returns None if the channel has been
+// closed and all items have been read. The GIL is released while waiting so
+// that the producing invocation can make progress on other threads.
+py::object OutputChannelRead(OutputChannel &self,
+                             std::optional<iree_duration_t> timeout) {
+  std::string item(iree_io_output_channel_item_capacity(self.raw_ptr()), '\0');
+  iree_host_size_t item_length = 0;
+  iree_status_t status;
+  {
+    py::gil_scoped_release release;
+    status = iree_io_output_channel_read(
+        self.raw_ptr(),
+        timeout ? iree_make_timeout_ns(*timeout) : iree_infinite_timeout(),
+        iree_make_byte_span(item.data(), item.size()), &item_length);
+  }
+  if (iree_status_is_out_of_range(status)) {
+    iree_status_ignore(status);
+    return py::none();
+  }
+  CheckApiStatus(status, "Error reading from output channel");
+  return py::bytes(item.data(), item_length);
+}
+
 FileHandle FileHandleWrapMemory(py::object host_buffer, bool readable,
                                 bool writable, size_t &out_buffer_size) {
   struct Retained {
@@ -189,6 +229,7 @@ int FileHandle::HandleBufferProtocol(Py_buffer *view, int flags) {
 
 void SetupIoBindings(py::module_ &m) {
   m.def("create_io_parameters_module", &CreateIoParametersModule);
+  m.def("create_io_outputs_module", &CreateIoOutputsModule);
 
   auto file_handle = py::class_<FileHandle>(m, "FileHandle");
   BindBufferProtocol<FileHandle>(file_handle);
@@ -222,6 +263,43 @@ void SetupIoBindings(py::module_ &m) {
         }
       });
 
+  py::class_<OutputChannel>(m, "OutputChannel")
+      .def(
+          "__init__",
+          [](OutputChannel *new_self, iree_host_size_t slot_count,
+             iree_host_size_t item_capacity, HalSemaphore *semaphore) {
+            iree_io_output_channel_t *created = nullptr;
+            CheckApiStatus(iree_io_output_channel_create(
+                               slot_count, item_capacity,
+                               semaphore ? semaphore->raw_ptr() : nullptr,
+                               iree_allocator_system(), &created),
+                           "Could not create output channel");
+            new (new_self) OutputChannel();
+            *new_self = OutputChannel::StealFromRawPtr(created);
+          },
+          py::arg("slot_count"), py::arg("item_capacity"),
+          py::arg("semaphore") = nullptr)
+      .def_prop_ro("item_capacity",
+                   [](OutputChannel &self) {
+                     return iree_io_output_channel_item_capacity(
+                         self.raw_ptr());
+                   })
+      .def(
+          "publish",
+          [](OutputChannel &self, py::bytes contents) {
+            CheckApiStatus(
+                iree_io_output_channel_publish(
+                    self.raw_ptr(),
+                    iree_make_const_byte_span(contents.c_str(),
+                                              contents.size()),
+                    iree_immediate_timeout()),
+                "Error publishing to output channel");
+          },
+          py::arg("contents"))
+      .def("read", OutputChannelRead, py::arg("timeout") = py::none())
+      .def("close", [](OutputChannel &self) {
+        iree_io_output_channel_close(self.raw_ptr());
+      });
   py::class_<ParameterProvider>(m, "ParameterProvider");
   py::class_<ParameterIndexEntryWrapper>(m, "ParameterIndexEntry")
       .def_prop_ro("key",
@@ -10,7 +10,9 @@
 #include <vector>
 
 #include "./binding.h"
+#include "./hal.h"
 #include "iree/io/file_handle.h"
+#include "iree/io/output_channel.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/parameter_provider.h"
 
@@ -26,6 +28,16 @@ struct ApiPtrAdapter<iree_io_file_handle_t> {
   }
 };
 
+template <>
+struct ApiPtrAdapter<iree_io_output_channel_t> {
+  static void Retain(iree_io_output_channel_t *v) {
+    iree_io_output_channel_retain(v);
+  }
+  static void Release(iree_io_output_channel_t *v) {
+    iree_io_output_channel_release(v);
+  }
+};
+
 template <>
 struct ApiPtrAdapter<iree_io_parameter_provider_t> {
   static void Retain(iree_io_parameter_provider_t *v) {
@@ -51,6 +63,9 @@ class FileHandle : public ApiRefCounted<FileHandle, iree_io_file_handle_t> {
   int HandleBufferProtocol(Py_buffer *view, int flags);
 };
 
+class OutputChannel
+    : public ApiRefCounted<OutputChannel, iree_io_output_channel_t> {};
+
 class ParameterProvider
     : public ApiRefCounted<ParameterProvider, iree_io_parameter_provider_t> {};
 
@@ -16,9 +16,11 @@ from . import _binding
 # Io imports
 from ._binding import (
     FileHandle,
+    OutputChannel,
     ParameterIndex,
     ParameterIndexEntry,
     ParameterProvider,
+    create_io_outputs_module,
     create_io_parameters_module,
 )
 
@@ -57,6 +59,7 @@ from ._binding import (
 )
 
 from .array_interop import *
+from .batching import *
 from .benchmark import *
 from .system_api import *
 from .system_setup import (
@@ -67,5 +70,6 @@ from .system_setup import (
 )
 from .function import *
 from .io import *
+from .kv_cache import *
 
 from . import flags
@@ -5,6 +5,9 @@ from typing import overload
 import asyncio
 
 def create_hal_module(instance: VmInstance, device: HalDevice) -> VmModule: ...
+def create_io_outputs_module(
+    instance: VmInstance, *channels: OutputChannel
+) -> VmModule: ...
 def create_io_parameters_module(
     instance: VmInstance, *providers: ParameterProvider
 ) -> VmModule: ...
@@ -84,6 +87,13 @@ class HalAllocator:
     def allocate_host_staging_buffer_copy(
         self, device: HalDevice, initial_contents: object
     ) -> HalBuffer: ...
+    def import_host_buffer(
+        self,
+        memory_type: Union[MemoryType, int],
+        allowed_usage: Union[BufferUsage, int],
+        buffer: object,
+        element_type: Optional[HalElementType] = ...,
+    ) -> Optional[Union[HalBuffer, HalBufferView]]: ...
     def query_buffer_compatibility(
         self,
         memory_type: Union[MemoryType, int],
@@ -433,6 +443,24 @@ class ParameterIndex:
         """
         ...
 
+class OutputChannel:
+    def __init__(
+        self,
+        slot_count: int,
+        item_capacity: int,
+        semaphore: Optional[HalSemaphore] = None,
+    ) -> None: ...
+    @property
+    def item_capacity(self) -> int: ...
+    def publish(self, contents: bytes) -> None: ...
+    def read(self, timeout: Optional[int] = None) -> Optional[bytes]:
+        """Reads the next item or returns None once closed and drained.
+
+        The timeout is in nanoseconds and waits forever if not specified.
+        """
+        ...
+    def close(self) -> None: ...
+
 class ParameterProvider: ...
 
 class PyModuleInterface:
@@ -241,6 +241,7 @@ def asdevicearray(
     memory_type=MemoryType.DEVICE_LOCAL,
     allowed_usage=(BufferUsage.DEFAULT | BufferUsage.MAPPING),
     element_type: Optional[HalElementType] = None,
+    copy: Optional[bool] = True,
 ) -> DeviceArray:
     """Helper to create a DeviceArray from an arbitrary array like.
 
@@ -254,6 +255,12 @@ def asdevicearray(
     Note that additional flags `memory_type`, `allowed_usage` and `element_type`
     are only hints if creating a new DeviceArray. If `a` is already a DeviceArray,
     they are ignored.
+
+    If `copy` is None the host memory is imported without copying when the
+    device allocator supports it (and the memory is suitably aligned), falling
+    back to a copy otherwise. If `copy` is False a ValueError is raised instead
+    of copying. Imported arrays alias the host array, which is kept alive with
+    the DeviceArray and must not be modified while the device is using it.
     """
     if isinstance(a, DeviceArray):
         if dtype is None:
@@ -268,13 +275,26 @@ def asdevicearray(
     element_type = map_dtype_to_element_type(a.dtype)
     if element_type is None:
         raise ValueError(f"Could not map dtype {a.dtype} to IREE element type")
-    buffer_view = device.allocator.allocate_buffer_copy(
-        memory_type=memory_type,
-        allowed_usage=allowed_usage,
-        device=device,
-        buffer=a,
-        element_type=element_type,
-    )
+    buffer_view = None
+    if copy is not True:
+        buffer_view = device.allocator.import_host_buffer(
+            memory_type=memory_type,
+            allowed_usage=allowed_usage,
+            buffer=a,
+            element_type=element_type,
+        )
+        if buffer_view is None and copy is False:
+            raise ValueError(
+                f"Device {device} cannot import the host array without a copy"
+            )
+    if buffer_view is None:
+        buffer_view = device.allocator.allocate_buffer_copy(
+            memory_type=memory_type,
+            allowed_usage=allowed_usage,
+            device=device,
+            buffer=a,
+            element_type=element_type,
+        )
     return DeviceArray(
         device,
         buffer_view,
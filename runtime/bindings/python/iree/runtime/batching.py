@@ -0,0 +1,373 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Request batching for serving IREE modules.
+
+Provides a scheduler that gathers individually submitted requests into batches
+bounded by a maximum size and a latency deadline and hands them to a user
+provided batch function, typically one invoking a batched module function.
+Continuous batching is supported by resubmitting each step of a long running
+sequence: requests that hold a slot (such as a row of a KV cache kept in
+device memory) are batched together with newly admitted ones on every step.
+
+Example:
+  slots = SlotAllocator(capacity=16)
+
+  def run_batch(requests):
+      ...  # stack inputs, invoke the module function asynchronously
+      return PendingBatch(signal_fence, results)
+
+  with BatchScheduler(run_batch, max_batch_size=16, max_latency_ms=5,
+                      slots=slots) as scheduler:
+      future = scheduler.submit(inputs)
+      print(future.result(), future.slot)
+
+Only the Python scheduler exists; there is no C API for the serving loop yet.
+C hosts still have to form batches themselves around iree_runtime_call_t.
+"""
+
+from collections import deque
+from concurrent.futures import Future
+from typing import Any, Callable, List, Optional, Sequence
+import threading
+import time
+
+__all__ = [
+    "BatchFuture",
+    "BatchRequest",
+    "BatchScheduler",
+    "PendingBatch",
+    "SlotAllocator",
+]
+
+
+class SlotAllocator:
+    """Hands out indices into a fixed capacity resource.
+
+    Slots usually identify per-request state that lives in device memory across
+    batches, such as KV cache rows. A slot stays owned by the caller until
+    released.
+    """
+
+    def __init__(self, capacity: int):
+        if capacity <= 0:
+            raise ValueError(f"slot capacity must be positive, got {capacity}")
+        self._capacity = capacity
+        self._free = deque(range(capacity))
+        self._cond = threading.Condition()
+        self._listeners: List[Callable[[], None]] = []
+
+    @property
+    def capacity(self) -> int:
+        return self._capacity
+
+    @property
+    def available(self) -> int:
+        with self._cond:
+            return len(self._free)
+
+    def try_acquire(self) -> Optional[int]:
+        """Returns a free slot or None if all slots are in use."""
+        with self._cond:
+            return self._free.popleft() if self._free else None
+
+    def acquire(self, timeout: Optional[float] = None) -> int:
+        """Blocks until a slot is free and returns it."""
+        with self._cond:
+            if not self._cond.wait_for(lambda: self._free, timeout=timeout):
+                raise TimeoutError("timed out waiting for a free slot")
+            return self._free.popleft()
+
+    def release(self, slot: int):
+        """Returns |slot| to the allocator."""
+        with self._cond:
+            if slot < 0 or slot >= self._capacity or slot in self._free:
+                raise ValueError(f"slot {slot} is not currently allocated")
+            self._free.append(slot)
+            self._cond.notify_all()
+        # Let any scheduler waiting on slots re-evaluate its queue.
+        for listener in self._listeners:
+            listener()
+
+    def _add_listener(self, listener: Callable[[], None]):
+        self._listeners.append(listener)
+
+
+class BatchFuture(Future):
+    """Future for the result of a request submitted to a `BatchScheduler`.
+
+    |slot| is the slot the request was given once it has been admitted into a
+    batch, or None before then. On success the slot stays owned by the caller,
+    who either resubmits with it to continue the sequence or releases it. If
+    the request fails the scheduler releases the slot and resets |slot|.
+    """
+
+    def __init__(self, slot: Optional[int] = None):
+        super().__init__()
+        self.slot = slot
+
+
+class BatchRequest:
+    """A single submitted request as seen by the batch function."""
+
+    __slots__ = ["inputs", "slot", "arrival_time", "future"]
+
+    def __init__(self, inputs: Any, slot: Optional[int], future: BatchFuture):
+        self.inputs = inputs
+        self.slot = slot
+        self.arrival_time = time.monotonic()
+        self.future = future
+
+
+class PendingBatch:
+    """Results of a batch whose execution completes asynchronously.
+
+    The batch function may return this instead of the results themselves to
+    let the scheduler form the next batch while the device is still executing.
+    |fence| is any object with a `wait()` method, usually the `HalFence`
+    signaled by the asynchronous invocation. |results| is either the sequence
+    of per-request results or a callable producing it once the fence has been
+    reached.
+    """
+
+    def __init__(self, fence: Any, results: Any):
+        self.fence = fence
+        self.results = results
+
+    def resolve(self) -> Sequence[Any]:
+        self.fence.wait()
+        return self.results() if callable(self.results) else self.results
+
+
+class BatchScheduler:
+    """Forms batches from individually submitted requests.
+
+    A batch is dispatched once it holds |max_batch_size| requests or the oldest
+    request in it has waited |max_latency_ms|. If |slots| is provided every
+    request is assigned a slot before being batched, either the one it was
+    submitted with or a newly acquired one; requests that cannot get a slot
+    stay queued until one is released. When a batch fails the slots of all of
+    its requests are returned to |slots|.
+
+    |batch_fn| is called on a scheduler thread with the list of `BatchRequest`s
+    in the batch and returns one result per request, in order, or a
+    `PendingBatch`. At most |max_inflight_batches| pending batches are
+    outstanding at a time.
+    """
+
+    def __init__(
+        self,
+        batch_fn: Callable[[List[BatchRequest]], Any],
+        *,
+        max_batch_size: int,
+        max_latency_ms: float = 1.0,
+        slots: Optional[SlotAllocator] = None,
+        max_inflight_batches: int = 2,
+    ):
+        if max_batch_size <= 0:
+            raise ValueError(
+                f"max_batch_size must be positive, got {max_batch_size}"
+            )
+        if max_inflight_batches <= 0:
+            raise ValueError(
+                f"max_inflight_batches must be positive, got {max_inflight_batches}"
+            )
+        self._batch_fn = batch_fn
+        self._max_batch_size = max_batch_size
+        self._max_latency = max_latency_ms / 1000.0
+        self._slots = slots
+        self._queue = deque()
+        self._cond = threading.Condition()
+        self._closed = False
+        self._inflight = deque()
+        self._inflight_cond = threading.Condition()
+        self._max_inflight_batches = max_inflight_batches
+        if slots is not None:
+            slots._add_listener(self._notify)
+        self._batch_thread = threading.Thread(
+            target=self._batch_loop, name="iree-batch-scheduler", daemon=True
+        )
+        self._completion_thread = threading.Thread(
+            target=self._completion_loop, name="iree-batch-completion", daemon=True
+        )
+        self._batch_thread.start()
+        self._completion_thread.start()
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *args):
+        self.close()
+
+    @property
+    def slots(self) -> Optional[SlotAllocator]:
+        return self._slots
+
+    def submit(self, inputs: Any, *, slot: Optional[int] = None) -> BatchFuture:
+        """Queues a request and returns a future for its result.
+
+        Pass the |slot| of a previous step to continue a sequence with the
+        state it holds.
+        """
+        future = BatchFuture(slot)
+        with self._cond:
+            if self._closed:
+                raise RuntimeError("cannot submit to a closed BatchScheduler")
+            self._queue.append(BatchRequest(inputs, slot, future))
+            self._cond.notify_all()
+        return future
+
+    def close(self, wait: bool = True):
+        """Stops accepting requests.
+
+        Queued requests are still processed as long as they can be admitted.
+        Requests that are still waiting for a slot once nothing else can run
+        fail with a RuntimeError.
+        """
+        with self._cond:
+            self._closed = True
+            self._cond.notify_all()
+        if wait:
+            self._batch_thread.join()
+            self._completion_thread.join()
+
+    def _notify(self):
+        with self._cond:
+            self._cond.notify_all()
+
+    def _admit(self, request: BatchRequest) -> bool:
+        if self._slots is None or request.slot is not None:
+            return True
+        request.slot = self._slots.try_acquire()
+        request.future.slot = request.slot
+        return request.slot is not None
+
+    def _release_slots(self, batch: List[BatchRequest]):
+        if self._slots is None:
+            return
+        for request in batch:
+            if request.slot is None:
+                continue
+            try:
+                self._slots.release(request.slot)
+            except ValueError:
+                # The caller already released the slot of a continued sequence.
+                pass
+            request.slot = None
+            request.future.slot = None
+
+    def _fail_batch(self, batch: List[BatchRequest], e: BaseException):
+        for request in batch:
+            request.future.set_exception(e)
+
+    def _take_batch(self) -> Optional[List[BatchRequest]]:
+        """Blocks until a batch is ready; returns None once closed and drained."""
+        with self._cond:
+            batch = []
+            while True:
+                # Move admissible requests into the batch in arrival order.
+                # Requests waiting on a slot keep their place in the queue.
+                waiting = deque()
+                while self._queue and len(batch) < self._max_batch_size:
+                    request = self._queue.popleft()
+                    if self._admit(request):
+                        batch.append(request)
+                    else:
+                        waiting.append(request)
+                self._queue.extendleft(reversed(waiting))
+
+                if len(batch) >= self._max_batch_size:
+                    return batch
+                if batch:
+                    remaining = (
+                        batch[0].arrival_time + self._max_latency - time.monotonic()
+                    )
+                    if remaining <= 0 or self._closed:
+                        return batch
+                    self._cond.wait(timeout=remaining)
+                elif self._closed and not self._queue:
+                    return None
+                elif self._closed and not self._has_inflight():
+                    # Nothing in flight can fail and release a slot and no
+                    # new requests will arrive: the queued requests would
+                    # otherwise wait forever.
+                    waiting = list(self._queue)
+                    self._queue.clear()
+                    e = RuntimeError("BatchScheduler closed before a slot was free")
+                    for request in waiting:
+                        request.future.set_exception(e)
+                    return None
+                else:
+                    self._cond.wait()
+
+    def _has_inflight(self) -> bool:
+        with self._inflight_cond:
+            return bool(self._inflight)
+
+    def _batch_loop(self):
+        while True:
+            batch = self._take_batch()
+            if batch is None:
+                break
+            with self._inflight_cond:
+                self._inflight_cond.wait_for(
+                    lambda: len(self._inflight) < self._max_inflight_batches
+                )
+            queued = False
+            error = None
+            try:
+                results = self._batch_fn(batch)
+                with self._inflight_cond:
+                    self._inflight.append((batch, results))
+                    self._inflight_cond.notify_all()
+                queued = True
+            except BaseException as e:
+                error = e
+            finally:
+                # Slots are released before the futures fail so that a caller
+                # retrying from a done callback can be admitted again.
+                if not queued:
+                    self._release_slots(batch)
+            if error is not None:
+                self._fail_batch(batch, error)
+        with self._inflight_cond:
+            self._inflight.append(None)
+            self._inflight_cond.notify_all()
+
+    def _completion_loop(self):
+        while True:
+            with self._inflight_cond:
+                self._inflight_cond.wait_for(lambda: self._inflight)
+                entry = self._inflight[0]
+            if entry is None:
+                break
+            batch, results = entry
+            resolved = False
+            error = None
+            try:
+                if isinstance(results, PendingBatch):
+                    results = results.resolve()
+                results = list(results)
+                if len(results) != len(batch):
+                    raise ValueError(
+                        f"batch function returned {len(results)} results for "
+                        f"{len(batch)} requests"
+                    )
+                resolved = True
+            except BaseException as e:
+                error = e
+            finally:
+                if not resolved:
+                    self._release_slots(batch)
+                with self._inflight_cond:
+                    self._inflight.popleft()
+                    self._inflight_cond.notify_all()
+                # A drained queue may have been waiting on this batch.
+                self._notify()
+            if error is not None:
+                self._fail_batch(batch, error)
+            else:
+                for request, result in zip(batch, results):
+                    request.future.set_result(result)
@@ -6,6 +6,7 @@
 
 from typing import Dict, Optional
 
+import asyncio
 import json
 import logging
 
@@ -17,6 +18,8 @@ from ._binding import (
     BufferUsage,
     HalBufferView,
     HalDevice,
+    HalDeviceLoopBridge,
+    HalFence,
     InvokeContext,
     MemoryType,
     VmContext,
@@ -88,6 +91,7 @@ class FunctionInvoker:
         "_arg_packer",
         "_ret_descs",
         "_has_inlined_results",
+        "_is_coarse_fences",
     ]
 
     def __init__(
@@ -106,6 +110,9 @@ class FunctionInvoker:
         self._arg_descs = None
         self._ret_descs = None
         self._has_inlined_results = False
+        self._is_coarse_fences = (
+            vm_function.reflection.get("iree.abi.model") == "coarse-fences"
+        )
         self._parse_abi_dict(vm_function)
         self._arg_packer = ArgumentPacker(_invoke_statics, self._arg_descs)
 
@@ -125,7 +132,42 @@ class FunctionInvoker:
 
         ret_list = VmVariantList(len(ret_descs) if ret_descs is not None else 1)
         self._invoke(arg_list, ret_list)
+        return self._unpack_results(inv, ret_list)
+
+    async def call_async(self, bridge: HalDeviceLoopBridge, *args, **kwargs):
+        """Invokes the function without blocking the asyncio event loop.
+
+        Functions compiled with the `coarse-fences` invocation model are
+        scheduled on the calling thread, which only blocks for as long as it
+        takes to enqueue the device work, and the returned coroutine completes
+        when `bridge` observes the signal fence. Many invocations can be in
+        flight from a single event loop this way. The bridge must have been
+        created for the same device and event loop.
+
+        Other functions block until their results are ready and are run on the
+        event loop's default executor instead.
+        """
+        if not self._is_coarse_fences:
+            return await asyncio.get_running_loop().run_in_executor(
+                None, lambda: self(*args, **kwargs)
+            )
+
+        invoke_context = InvokeContext(self._device)
+        arg_list = self._arg_packer.pack(invoke_context, args, kwargs)
+        # Work may begin immediately and signals a fresh semaphore when done.
+        semaphore = self._device.create_semaphore(0)
+        arg_list.push_ref(HalFence(0))
+        arg_list.push_ref(HalFence.create_at(semaphore, 1))
 
+        inv = Invocation(self._device)
+        ret_descs = self._ret_descs
+        ret_list = VmVariantList(len(ret_descs) if ret_descs is not None else 1)
+        self._invoke(arg_list, ret_list)
+        await bridge.on_semaphore(semaphore, 1, None)
+        return self._unpack_results(inv, ret_list)
+
+    def _unpack_results(self, inv: Invocation, ret_list: VmVariantList):
+        ret_descs = self._ret_descs
         # Un-inline the results to align with reflection, as needed.
         reflection_aligned_ret_list = ret_list
         if self._has_inlined_results:
@@ -0,0 +1,214 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+"""Paged key/value caches for autoregressive decoding.
+
+Instead of reserving a maximum length cache per sequence, token state is
+stored in fixed size pages taken from one device resident pool shared by all
+sequences. Each sequence owns an ordered list of pages and a page table maps
+its logical token positions to pool pages. Batched decode functions take the
+pool and the page tables of the batch as operands and gather the pages they
+attend over:
+
+  pool:        [num_pages, page_size, *token_shape]
+  page_table:  [batch, max_pages_per_sequence] (int32 page indices)
+  lengths:     [batch] (int32 token counts)
+
+Token `t` of batch entry `b` lives at `pool[page_table[b, t // page_size],
+t % page_size]`.
+
+This module only does the host-side page bookkeeping. The compiler has no
+dedicated paged attention op, so decode functions have to gather the pages
+themselves (for example with a linalg.generic of tensor.extract feeding
+iree_linalg_ext.attention), and the pool is a plain HAL buffer rather than a
+block pool managed by the C runtime.
+"""
+
+from typing import Dict, Hashable, List, Optional, Sequence, Tuple
+import numpy as np
+
+from ._binding import (
+    BufferUsage,
+    HalBufferView,
+    HalDevice,
+    HalElementType,
+    MemoryType,
+)
+from .array_interop import DeviceArray
+
+__all__ = [
+    "PagedKVCache",
+    "PageTable",
+]
+
+
+class PageTable:
+    """Host side bookkeeping of which pool pages each sequence owns.
+
+    Pages are allocated as sequences grow and returned to the pool when they
+    are released, so sequences of very different lengths can share a pool
+    without fragmenting it.
+    """
+
+    def __init__(
+        self,
+        num_pages: int,
+        page_size: int,
+        max_pages_per_sequence: Optional[int] = None,
+    ):
+        if num_pages <= 0 or page_size <= 0:
+            raise ValueError(
+                f"num_pages ({num_pages}) and page_size ({page_size}) must be "
+                f"positive"
+            )
+        self._num_pages = num_pages
+        self._page_size = page_size
+        self._max_pages_per_sequence = max_pages_per_sequence or num_pages
+        # Reversed so pages are handed out in ascending order.
+        self._free_pages = list(reversed(range(num_pages)))
+        self._sequence_pages: Dict[Hashable, List[int]] = {}
+        self._sequence_lengths: Dict[Hashable, int] = {}
+
+    @property
+    def num_pages(self) -> int:
+        return self._num_pages
+
+    @property
+    def page_size(self) -> int:
+        return self._page_size
+
+    @property
+    def max_pages_per_sequence(self) -> int:
+        return self._max_pages_per_sequence
+
+    @property
+    def free_pages(self) -> int:
+        return len(self._free_pages)
+
+    def __contains__(self, sequence: Hashable) -> bool:
+        return sequence in self._sequence_pages
+
+    def add_sequence(self, sequence: Hashable):
+        """Starts tracking an empty |sequence|."""
+        if sequence in self._sequence_pages:
+            raise ValueError(f"sequence {sequence!r} already exists")
+        self._sequence_pages[sequence] = []
+        self._sequence_lengths[sequence] = 0
+
+    def release_sequence(self, sequence: Hashable):
+        """Returns all pages of |sequence| to the pool."""
+        pages = self._sequence_pages.pop(sequence)
+        del self._sequence_lengths[sequence]
+        self._free_pages.extend(reversed(pages))
+
+    def sequence_length(self, sequence: Hashable) -> int:
+        return self._sequence_lengths[sequence]
+
+    def sequence_pages(self, sequence: Hashable) -> Sequence[int]:
+        return tuple(self._sequence_pages[sequence])
+
+    def _pages_needed(self, sequence: Hashable, num_tokens: int) -> int:
+        length = self._sequence_lengths[sequence] + num_tokens
+        required = -(-length // self._page_size)
+        return required - len(self._sequence_pages[sequence])
+
+    def can_extend(self, sequence: Hashable, num_tokens: int) -> bool:
+        """Returns true if |sequence| can grow by |num_tokens| tokens."""
+        needed = self._pages_needed(sequence, num_tokens)
+        total = len(self._sequence_pages[sequence]) + needed
+        return (
+            needed <= len(self._free_pages)
+            and total <= self._max_pages_per_sequence
+        )
+
+    def extend(self, sequence: Hashable, num_tokens: int) -> Tuple[int, int]:
+        """Grows |sequence| by |num_tokens| tokens, allocating pages as needed.
+
+        Returns the `[start, end)` token positions the new tokens occupy. The
+        sequence is left unchanged if there aren't enough free pages.
+        """
+        if not self.can_extend(sequence, num_tokens):
+            raise MemoryError(
+                f"cannot extend sequence {sequence!r} by {num_tokens} tokens: "
+                f"{self.free_pages} free pages"
+            )
+        needed = self._pages_needed(sequence, num_tokens)
+        pages = self._sequence_pages[sequence]
+        for _ in range(needed):
+            pages.append(self._free_pages.pop())
+        start = self._sequence_lengths[sequence]
+        self._sequence_lengths[sequence] = start + num_tokens
+        return start, start + num_tokens
+
+    def build(
+        self, sequences: Sequence[Hashable], pad_page: int = 0
+    ) -> Tuple[np.ndarray, np.ndarray]:
+        """Returns the page table and lengths of a batch of |sequences|.
+
+        Unused page table entries are set to |pad_page| so that gathers stay
+        in bounds; kernels mask them using the lengths.
+        """
+        table = np.full(
+            (len(sequences), self._max_pages_per_sequence), pad_page, np.int32
+        )
+        lengths = np.zeros((len(sequences),), np.int32)
+        for i, sequence in enumerate(sequences):
+            pages = self._sequence_pages[sequence]
+            table[i, : len(pages)] = pages
+            lengths[i] = self._sequence_lengths[sequence]
+        return table, lengths
+
+
+class PagedKVCache:
+    """A page pool allocated on a device together with its page table.
+
+    |token_shape| is the shape of the state stored per token, for example
+    `(2, num_layers, num_heads, head_dim)` for the keys and values of all
+    layers. The pool is allocated once and is expected to be updated in
+    place by the functions it is passed to.
+    """
+
+    def __init__(
+        self,
+        device: HalDevice,
+        *,
+        num_pages: int,
+        page_size: int,
+        token_shape: Sequence[int],
+        element_type: HalElementType = HalElementType.FLOAT_16,
+        max_pages_per_sequence: Optional[int] = None,
+    ):
+        self._device = device
+        self._page_table = PageTable(num_pages, page_size, max_pages_per_sequence)
+        self._shape = [num_pages, page_size] + list(token_shape)
+        element_size = HalElementType.dense_byte_count(element_type)
+        buffer = device.allocator.allocate_buffer(
+            memory_type=MemoryType.DEVICE_LOCAL,
+            allowed_usage=BufferUsage.DEFAULT,
+            allocation_size=int(np.prod(self._shape)) * element_size,
+        )
+        self._pool = DeviceArray(
+            device, HalBufferView(buffer, self._shape, element_type)
+        )
+
+    @property
+    def device(self) -> HalDevice:
+        return self._device
+
+    @property
+    def pool(self) -> DeviceArray:
+        """The device resident pool of shape `[num_pages, page_size, *token_shape]`."""
+        return self._pool
+
+    @property
+    def page_table(self) -> PageTable:
+        return self._page_table
+
+    def batch_operands(
+        self, sequences: Sequence[Hashable]
+    ) -> Tuple[DeviceArray, np.ndarray, np.ndarray]:
+        """Returns the (pool, page table, lengths) operands for a batch."""
+        table, lengths = self._page_table.build(sequences)
+        return self._pool, table, lengths
@@ -0,0 +1,209 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+from iree import runtime as rt
+import threading
+import unittest
+
+
+class FakeFence:
+    def __init__(self):
+        self.event = threading.Event()
+
+    def wait(self):
+        self.event.wait()
+
+
+class SlotAllocatorTest(unittest.TestCase):
+    def testAcquireRelease(self):
+        slots = rt.SlotAllocator(2)
+        a = slots.acquire()
+        b = slots.try_acquire()
+        self.assertEqual({a, b}, {0, 1})
+        self.assertIsNone(slots.try_acquire())
+        slots.release(a)
+        self.assertEqual(slots.available, 1)
+        self.assertEqual(slots.acquire(), a)
+
+    def testDoubleRelease(self):
+        slots = rt.SlotAllocator(1)
+        with self.assertRaises(ValueError):
+            slots.release(0)
+
+    def testAcquireTimeout(self):
+        slots = rt.SlotAllocator(1)
+        slots.acquire()
+        with self.assertRaises(TimeoutError):
+            slots.acquire(timeout=0.01)
+
+
+class BatchSchedulerTest(unittest.TestCase):
+    def testResultsRouted(self):
+        batch_sizes = []
+
+        def batch_fn(requests):
+            batch_sizes.append(len(requests))
+            return [r.inputs * 2 for r in requests]
+
+        with rt.BatchScheduler(batch_fn, max_batch_size=3) as scheduler:
+            futures = [scheduler.submit(i) for i in range(10)]
+            self.assertEqual([f.result() for f in futures], [i * 2 for i in range(10)])
+        self.assertEqual(sum(batch_sizes), 10)
+        self.assertTrue(all(size <= 3 for size in batch_sizes))
+
+    def testFillsBatchBeforeDeadline(self):
+        batch_sizes = []
+
+        def batch_fn(requests):
+            batch_sizes.append(len(requests))
+            return [None] * len(requests)
+
+        with rt.BatchScheduler(
+            batch_fn, max_batch_size=4, max_latency_ms=60000
+        ) as scheduler:
+            futures = [scheduler.submit(i) for i in range(4)]
+            for f in futures:
+                f.result()
+        self.assertEqual(batch_sizes, [4])
+
+    def testDeadlineFlushesPartialBatch(self):
+        with rt.BatchScheduler(
+            lambda requests: [r.inputs for r in requests],
+            max_batch_size=8,
+            max_latency_ms=1,
+        ) as scheduler:
+            self.assertEqual(scheduler.submit(42).result(timeout=10), 42)
+
+    def testBatchFnException(self):
+        def batch_fn(requests):
+            raise RuntimeError("boom")
+
+        with rt.BatchScheduler(batch_fn, max_batch_size=2) as scheduler:
+            future = scheduler.submit(0)
+            with self.assertRaisesRegex(RuntimeError, "boom"):
+                future.result(timeout=10)
+
+    def testResultCountMismatch(self):
+        with rt.BatchScheduler(lambda requests: [], max_batch_size=1) as scheduler:
+            with self.assertRaises(ValueError):
+                scheduler.submit(0).result(timeout=10)
+
+    def testPendingBatch(self):
+        fence = FakeFence()
+
+        def batch_fn(requests):
+            return rt.PendingBatch(fence, lambda: [r.inputs + 1 for r in requests])
+
+        with rt.BatchScheduler(batch_fn, max_batch_size=1) as scheduler:
+            future = scheduler.submit(1)
+            self.assertFalse(future.done())
+            fence.event.set()
+            self.assertEqual(future.result(timeout=10), 2)
+
+    def testSlotsLimitAdmission(self):
+        slots = rt.SlotAllocator(2)
+        batches = []
+
+        def batch_fn(requests):
+            batches.append([r.slot for r in requests])
+            return [r.slot for r in requests]
+
+        with rt.BatchScheduler(
+            batch_fn, max_batch_size=4, max_latency_ms=1, slots=slots
+        ) as scheduler:
+            futures = [scheduler.submit(i) for i in range(3)]
+            first_slots = {f.result(timeout=10) for f in futures[:2]}
+            self.assertEqual(first_slots, {0, 1})
+            self.assertFalse(futures[2].done())
+            # Finishing a sequence frees its slot for the waiting request.
+            slot = futures[0].result()
+            slots.release(slot)
+            self.assertEqual(futures[2].result(timeout=10), slot)
+
+    def testContinuedSequenceKeepsSlot(self):
+        slots = rt.SlotAllocator(1)
+
+        with rt.BatchScheduler(
+            lambda requests: [r.slot for r in requests],
+            max_batch_size=2,
+            max_latency_ms=1,
+            slots=slots,
+        ) as scheduler:
+            slot = scheduler.submit("prefill").result(timeout=10)
+            future = scheduler.submit("decode", slot=slot)
+            self.assertEqual(future.result(timeout=10), slot)
+
+    def testFutureReportsSlot(self):
+        slots = rt.SlotAllocator(2)
+        with rt.BatchScheduler(
+            lambda requests: [r.inputs for r in requests],
+            max_batch_size=2,
+            max_latency_ms=1,
+            slots=slots,
+        ) as scheduler:
+            future = scheduler.submit(7)
+            self.assertEqual(future.result(timeout=10), 7)
+            self.assertIn(future.slot, {0, 1})
+            self.assertEqual(slots.available, 1)
+            continued = scheduler.submit(8, slot=future.slot)
+            self.assertEqual(continued.slot, future.slot)
+            continued.result(timeout=10)
+
+    def testBatchFnExceptionReleasesSlots(self):
+        slots = rt.SlotAllocator(2)
+
+        def batch_fn(requests):
+            raise RuntimeError("boom")
+
+        with rt.BatchScheduler(
+            batch_fn, max_batch_size=2, max_latency_ms=1, slots=slots
+        ) as scheduler:
+            for i in range(4):
+                future = scheduler.submit(i)
+                with self.assertRaisesRegex(RuntimeError, "boom"):
+                    future.result(timeout=10)
+                self.assertIsNone(future.slot)
+            self.assertEqual(slots.available, 2)
+
+    def testResultCountMismatchReleasesSlots(self):
+        slots = rt.SlotAllocator(1)
+        fence = FakeFence()
+        fence.event.set()
+        with rt.BatchScheduler(
+            lambda requests: rt.PendingBatch(fence, []),
+            max_batch_size=1,
+            slots=slots,
+        ) as scheduler:
+            for i in range(3):
+                with self.assertRaises(ValueError):
+                    scheduler.submit(i).result(timeout=10)
+            self.assertEqual(slots.available, 1)
+
+    def testCloseFailsRequestsWaitingOnSlots(self):
+        slots = rt.SlotAllocator(1)
+        scheduler = rt.BatchScheduler(
+            lambda requests: [r.slot for r in requests],
+            max_batch_size=1,
+            slots=slots,
+        )
+        held = scheduler.submit(0)
+        held.result(timeout=10)
+        waiting = scheduler.submit(1)
+        scheduler.close()
+        with self.assertRaises(RuntimeError):
+            waiting.result(timeout=10)
+        self.assertIsNone(waiting.slot)
+        slots.release(held.slot)
+
+    def testSubmitAfterClose(self):
+        scheduler = rt.BatchScheduler(lambda requests: requests, max_batch_size=1)
+        scheduler.close()
+        with self.assertRaises(RuntimeError):
+            scheduler.submit(0)
+
+
+if __name__ == "__main__":
+    unittest.main()
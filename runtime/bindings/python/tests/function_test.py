@@ -4,6 +4,7 @@
 # See https://llvm.org/LICENSE.txt for license information.
 # SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+import asyncio
 import json
 import numpy as np
 import unittest
@@ -685,6 +686,47 @@ class FunctionTest(unittest.TestCase):
         result = invoker()
         self.assertEqual("[1, 2]", repr(result))
 
+    def testCallAsyncCoarseFences(self):
+        def invoke(arg_list, ret_list):
+            # Arguments are followed by the (wait, signal) fences.
+            self.assertEqual(3, len(arg_list))
+            signal_fence = arg_list.get_as_object(2, rt.HalFence)
+            ret_list.push_int(4)
+            signal_fence.signal()
+
+        vm_context = MockVmContext(invoke)
+        vm_function = MockVmFunction(
+            reflection={
+                "iree.abi.model": "coarse-fences",
+                "iree.abi": json.dumps({"a": ["i32"], "r": ["i32"]}),
+            }
+        )
+        invoker = FunctionInvoker(vm_context, self.device, vm_function)
+        loop = asyncio.new_event_loop()
+        bridge = rt.HalDeviceLoopBridge(self.device, loop)
+        try:
+            result = loop.run_until_complete(invoker.call_async(bridge, 1))
+        finally:
+            bridge.stop()
+            loop.close()
+        self.assertEqual(4, result)
+
+    def testCallAsyncSynchronous(self):
+        def invoke(arg_list, ret_list):
+            ret_list.push_int(4)
+
+        vm_context = MockVmContext(invoke)
+        vm_function = MockVmFunction(reflection={})
+        invoker = FunctionInvoker(vm_context, self.device, vm_function)
+        loop = asyncio.new_event_loop()
+        bridge = rt.HalDeviceLoopBridge(self.device, loop)
+        try:
+            result = loop.run_until_complete(invoker.call_async(bridge, 1))
+        finally:
+            bridge.stop()
+            loop.close()
+        self.assertEqual(4, result)
+
 
 if __name__ == "__main__":
     unittest.main()
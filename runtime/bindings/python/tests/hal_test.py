@@ -192,6 +192,36 @@ class DeviceHalTest(unittest.TestCase):
             "<HalBufferView (3, 4), element_type=0x20000011, 48 bytes (at offset 0 into 48), memory_type=DEVICE_LOCAL|HOST_VISIBLE, allowed_access=ALL, allowed_usage=TRANSFER|DISPATCH_STORAGE|MAPPING|MAPPING_PERSISTENT>",
         )
 
+    def testImportHostBuffer(self):
+        # Imports require device-compatible alignment so carve an aligned
+        # array out of a larger allocation.
+        storage = np.zeros([64 + 48], dtype=np.uint8)
+        offset = -storage.ctypes.data % 64
+        ary = storage[offset : offset + 48].view(np.int32).reshape([3, 4])
+        bv = self.allocator.import_host_buffer(
+            memory_type=iree.runtime.MemoryType.DEVICE_LOCAL,
+            allowed_usage=iree.runtime.BufferUsage.DEFAULT,
+            buffer=ary,
+            element_type=iree.runtime.HalElementType.SINT_32,
+        )
+        self.assertIsInstance(bv, iree.runtime.HalBufferView)
+        # The buffer aliases the host array.
+        ary[1, 2] = 7
+        mapped = bv.map().asarray(ary.shape, ary.dtype)
+        self.assertEqual(mapped[1, 2], 7)
+
+    def testImportHostBufferUnaligned(self):
+        storage = np.zeros([64 + 48], dtype=np.uint8)
+        offset = -storage.ctypes.data % 64 + 4
+        ary = storage[offset : offset + 48].view(np.int32)
+        bv = self.allocator.import_host_buffer(
+            memory_type=iree.runtime.MemoryType.DEVICE_LOCAL,
+            allowed_usage=iree.runtime.BufferUsage.DEFAULT,
+            buffer=ary,
+            element_type=iree.runtime.HalElementType.SINT_32,
+        )
+        self.assertIsNone(bv)
+
     def testAllocateHostStagingBufferCopy(self):
         buffer = self.allocator.allocate_host_staging_buffer_copy(
             self.device, np.int32(0)
@@ -0,0 +1,92 @@
+# Copyright 2024 The IREE Authors
+#
+# Licensed under the Apache License v2.0 with LLVM Exceptions.
+# See https://llvm.org/LICENSE.txt for license information.
+# SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+import iree.runtime
+import numpy as np
+import unittest
+
+
+class PageTableTest(unittest.TestCase):
+    def testExtendAllocatesPages(self):
+        pages = iree.runtime.PageTable(num_pages=8, page_size=4)
+        pages.add_sequence("a")
+        self.assertEqual(pages.extend("a", 5), (0, 5))
+        self.assertEqual(pages.sequence_pages("a"), (0, 1))
+        # Filling the partially used page doesn't allocate.
+        self.assertEqual(pages.extend("a", 3), (5, 8))
+        self.assertEqual(pages.sequence_pages("a"), (0, 1))
+        pages.extend("a", 1)
+        self.assertEqual(pages.sequence_pages("a"), (0, 1, 2))
+        self.assertEqual(pages.free_pages, 5)
+
+    def testReleaseReusesPages(self):
+        pages = iree.runtime.PageTable(num_pages=4, page_size=2)
+        pages.add_sequence("a")
+        pages.add_sequence("b")
+        pages.extend("a", 4)
+        pages.extend("b", 2)
+        pages.release_sequence("a")
+        self.assertNotIn("a", pages)
+        self.assertEqual(pages.free_pages, 3)
+        pages.extend("b", 6)
+        self.assertEqual(pages.sequence_pages("b"), (2, 0, 1, 3))
+
+    def testOutOfPages(self):
+        pages = iree.runtime.PageTable(num_pages=2, page_size=2)
+        pages.add_sequence("a")
+        self.assertFalse(pages.can_extend("a", 5))
+        with self.assertRaises(MemoryError):
+            pages.extend("a", 5)
+        self.assertEqual(pages.sequence_length("a"), 0)
+        self.assertEqual(pages.free_pages, 2)
+
+    def testMaxPagesPerSequence(self):
+        pages = iree.runtime.PageTable(
+            num_pages=8, page_size=2, max_pages_per_sequence=2
+        )
+        pages.add_sequence("a")
+        self.assertTrue(pages.can_extend("a", 4))
+        self.assertFalse(pages.can_extend("a", 5))
+
+    def testBuild(self):
+        pages = iree.runtime.PageTable(
+            num_pages=8, page_size=2, max_pages_per_sequence=3
+        )
+        pages.add_sequence("a")
+        pages.add_sequence("b")
+        pages.extend("a", 3)
+        pages.extend("b", 1)
+        table, lengths = pages.build(["b", "a"])
+        np.testing.assert_array_equal(table, [[2, 0, 0], [0, 1, 0]])
+        np.testing.assert_array_equal(lengths, [1, 3])
+        self.assertEqual(table.dtype, np.int32)
+
+
+class PagedKVCacheTest(unittest.TestCase):
+    def setUp(self):
+        super().setUp()
+        self.device = iree.runtime.get_device("local-task")
+
+    def testPoolShape(self):
+        cache = iree.runtime.PagedKVCache(
+            self.device,
+            num_pages=4,
+            page_size=16,
+            token_shape=(2, 8),
+            element_type=iree.runtime.HalElementType.FLOAT_32,
+        )
+        self.assertEqual(tuple(cache.pool.shape), (4, 16, 2, 8))
+        self.assertEqual(cache.pool.dtype, np.float32)
+        cache.page_table.add_sequence(0)
+        cache.page_table.extend(0, 20)
+        pool, table, lengths = cache.batch_operands([0])
+        self.assertIs(pool, cache.pool)
+        np.testing.assert_array_equal(table, [[0, 1, 0, 0]])
+        np.testing.assert_array_equal(lengths, [20])
+
+
+if __name__ == "__main__":
+    unittest.main()
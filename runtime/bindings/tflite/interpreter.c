@@ -222,6 +222,35 @@ static iree_status_t _TfLiteInterpreterRefreshIOShapes(
   return status;
 }
 
+// Refreshes only the output tensor shapes by querying the module.
+// Input shapes only change via TfLiteInterpreterResizeInputTensor and are
+// refreshed in TfLiteInterpreterAllocateTensors.
+static iree_status_t _TfLiteInterpreterRefreshOutputShapesOnly(
+    TfLiteInterpreter* interpreter) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  _TfLiteInterpreterShapeFrame frame;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, _TfLiteInterpreterShapeFrameInitialize(&frame));
+  iree_status_t status =
+      _TfLiteInterpreterRefreshOutputShapes(interpreter, &frame);
+  _TfLiteInterpreterShapeFrameDeinitialize(&frame);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns true if any output tensor has a dimension that is unknown until the
+// model has been invoked.
+static bool _TfLiteInterpreterHasDynamicOutputShapes(
+    const TfLiteInterpreter* interpreter) {
+  for (int32_t i = 0; i < interpreter->model->output_count; ++i) {
+    const TfLiteTensor* tensor = &interpreter->output_tensors[i];
+    for (int32_t j = 0; j < tensor->shape_rank; ++j) {
+      if (tensor->shape_dims[j] < 0) return true;
+    }
+  }
+  return false;
+}
+
 //===----------------------------------------------------------------------===//
 // Creation and static initialization
 //===----------------------------------------------------------------------===//
@@ -231,16 +260,8 @@ static iree_host_size_t _TfLiteInterpreterCalculateSize(
     const TfLiteModel* model) {
   iree_host_size_t total_size =
       iree_host_align(sizeof(TfLiteInterpreter), iree_max_align_t);
-
-  iree_vm_type_def_t buffer_view_type_def =
-      iree_vm_make_ref_type_def(iree_hal_buffer_type());
-  total_size +=
-      iree_vm_list_storage_size(&buffer_view_type_def, model->input_count);
-  total_size +=
-      iree_vm_list_storage_size(&buffer_view_type_def, model->output_count);
   total_size += sizeof(TfLiteTensor) * model->input_count;
   total_size += sizeof(TfLiteTensor) * model->output_count;
-
   return total_size;
 }
 
@@ -262,24 +283,6 @@ static iree_status_t _TfLiteInterpreterAllocate(
 
   uint8_t* p = (uint8_t*)interpreter +
                iree_host_align(sizeof(*interpreter), iree_max_align_t);
-
-  iree_vm_type_def_t buffer_view_type_def =
-      iree_vm_make_ref_type_def(iree_hal_buffer_type());
-
-  iree_byte_span_t input_list_storage = iree_make_byte_span(
-      p, iree_vm_list_storage_size(&buffer_view_type_def, model->input_count));
-  IREE_RETURN_IF_ERROR(
-      iree_vm_list_initialize(input_list_storage, &buffer_view_type_def,
-                              model->input_count, &interpreter->input_list));
-  p += input_list_storage.data_length;
-
-  iree_byte_span_t output_list_storage = iree_make_byte_span(
-      p, iree_vm_list_storage_size(&buffer_view_type_def, model->output_count));
-  IREE_RETURN_IF_ERROR(
-      iree_vm_list_initialize(output_list_storage, &buffer_view_type_def,
-                              model->output_count, &interpreter->output_list));
-  p += output_list_storage.data_length;
-
   interpreter->input_tensors = (TfLiteTensor*)p;
   p += sizeof(TfLiteTensor) * model->input_count;
   interpreter->output_tensors = (TfLiteTensor*)p;
@@ -330,13 +333,12 @@ static iree_status_t _TfLiteInterpreterPopulateIO(
     IREE_RETURN_IF_ERROR(_TfLiteTensorParseQuantAttr(tensor, io_quant_part));
   }
 
-  // Prepare the IO lists we use when calling into the model.
-  // The actual contents of these cannot be set until
+  // Prepare the invoker we use when calling into the model. Its IO lists are
+  // sized to the function signature and the inputs cannot be set until
   // TfLiteInterpreterAllocateTensors has been called.
-  IREE_RETURN_IF_ERROR(iree_vm_list_reserve(interpreter->input_list,
-                                            interpreter->model->input_count));
-  IREE_RETURN_IF_ERROR(iree_vm_list_reserve(interpreter->output_list,
-                                            interpreter->model->output_count));
+  IREE_RETURN_IF_ERROR(iree_vm_invoker_create(
+      interpreter->context, main_fn, IREE_VM_INVOCATION_FLAG_NONE,
+      /*stack_size=*/0, interpreter->allocator, &interpreter->main_invoker));
 
   return iree_ok_status();
 }
@@ -421,8 +423,7 @@ TFL_CAPI_EXPORT extern void TfLiteInterpreterDelete(
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
     _TfLiteTensorReset(&interpreter->output_tensors[i], interpreter->allocator);
   }
-  iree_vm_list_deinitialize(interpreter->input_list);
-  iree_vm_list_deinitialize(interpreter->output_list);
+  iree_vm_invoker_release(interpreter->main_invoker);
 
   iree_vm_context_release(interpreter->context);
   iree_vm_module_release(interpreter->hal_module);
@@ -527,24 +528,31 @@ static iree_status_t _TfLiteInterpreterAllocateTensors(
   // non-data-dependent output shapes.
   IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapes(interpreter));
 
+  // Output shapes that depend on more than the input shapes need to be queried
+  // after each invocation; all others remain valid until the next resize.
+  interpreter->has_dynamic_output_shapes =
+      _TfLiteInterpreterHasDynamicOutputShapes(interpreter);
+
   // Drop all input tensors we hang on to in the input list. This way we aren't
   // double-allocating during the resize.
-  IREE_RETURN_IF_ERROR(iree_vm_list_resize(interpreter->input_list, 0));
+  iree_vm_list_t* input_list =
+      iree_vm_invoker_inputs(interpreter->main_invoker);
+  IREE_RETURN_IF_ERROR(iree_vm_list_resize(input_list, 0));
 
-  // Reallocate input tensors (if needed).
+  // Reallocate input tensors (if needed) and bind them to the invoker once.
+  // The buffers stay mapped so that TfLiteTensorData/TfLiteTensorCopyFromBuffer
+  // write directly into the memory passed to each invocation.
   for (iree_host_size_t i = 0; i < interpreter->model->input_count; ++i) {
     TfLiteTensor* tensor = &interpreter->input_tensors[i];
     IREE_RETURN_IF_ERROR(_TfLiteTensorReallocateIfNeeded(
         tensor, iree_hal_device_allocator(interpreter->device),
         interpreter->allocator));
     iree_vm_ref_t buffer_ref = iree_hal_buffer_retain_ref(tensor->buffer);
-    IREE_RETURN_IF_ERROR(
-        iree_vm_list_push_ref_move(interpreter->input_list, &buffer_ref));
+    IREE_RETURN_IF_ERROR(iree_vm_list_push_ref_move(input_list, &buffer_ref));
   }
 
   // TODO(benvanik): preallocate outputs when we support using them.
-  // We could stash the buffer views in interpreter->output_list.
-  // For now we just drop them all.
+  // The model returns its own output buffers so for now we just drop them all.
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
     _TfLiteTensorDiscardBuffer(&interpreter->output_tensors[i]);
   }
@@ -573,24 +581,27 @@ TFL_CAPI_EXPORT extern TfLiteStatus TfLiteInterpreterAllocateTensors(
 
 static iree_status_t _TfLiteInterpreterInvoke(TfLiteInterpreter* interpreter) {
   // tflite models only have a single entry point and the IREE converter
-  // emits it as '_main'.
+  // emits it as '_main'. The invoker reuses the inputs bound during
+  // TfLiteInterpreterAllocateTensors.
   IREE_RETURN_IF_ERROR(
-      iree_vm_invoke(interpreter->context, interpreter->model->exports._main,
-                     IREE_VM_INVOCATION_FLAG_NONE,
-                     /*policy=*/NULL, interpreter->input_list,
-                     interpreter->output_list, interpreter->allocator));
+      iree_vm_invoker_invoke(interpreter->main_invoker, /*policy=*/NULL));
 
-  // Refresh output shapes.
-  // TODO(#3975): just use buffer view results or at least just refresh outputs.
-  IREE_RETURN_IF_ERROR(_TfLiteInterpreterRefreshIOShapes(interpreter));
+  // Refresh output shapes if they may have changed.
+  // TODO(#3975): just use buffer view results.
+  if (interpreter->has_dynamic_output_shapes) {
+    IREE_RETURN_IF_ERROR(
+        _TfLiteInterpreterRefreshOutputShapesOnly(interpreter));
+  }
 
-  // Map the output buffers.
-  // NOTE: we could defer the mapping unless requested and ensure state buffers
-  // remain where they currently are for the next invocation.
+  // Map the output buffers. Models that return the same buffers each
+  // invocation (such as those with persistent state) keep their existing
+  // mappings.
+  iree_vm_list_t* output_list =
+      iree_vm_invoker_outputs(interpreter->main_invoker);
   for (iree_host_size_t i = 0; i < interpreter->model->output_count; ++i) {
-    iree_hal_buffer_t* buffer =
-        iree_vm_list_get_buffer_assign(interpreter->output_list, i);
+    iree_hal_buffer_t* buffer = iree_vm_list_get_buffer_assign(output_list, i);
     TfLiteTensor* tensor = &interpreter->output_tensors[i];
+    if (buffer && buffer == tensor->buffer) continue;
     IREE_RETURN_IF_ERROR(_TfLiteTensorBind(tensor, buffer));
   }
 
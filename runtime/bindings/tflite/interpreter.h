@@ -39,8 +39,15 @@ struct TfLiteInterpreter {
   };
   iree_vm_context_t* context;
 
-  iree_vm_list_t* input_list;
-  iree_vm_list_t* output_list;
+  // Reusable invoker of the model entry point. Its input list holds the
+  // input tensor buffers bound by TfLiteInterpreterAllocateTensors so that
+  // each TfLiteInterpreterInvoke only needs to run the function.
+  iree_vm_invoker_t* main_invoker;
+
+  // True if any output shape could not be determined from the input shapes
+  // alone and must be queried again after each invocation.
+  bool has_dynamic_output_shapes;
+
   TfLiteTensor* input_tensors;
   TfLiteTensor* output_tensors;
 };
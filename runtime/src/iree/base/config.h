@@ -219,6 +219,14 @@ typedef IREE_DEVICE_SIZE_T iree_device_size_t;
 #define IREE_HAL_HEAP_BUFFER_ALIGNMENT 64
 #endif  // IREE_HAL_HEAP_BUFFER_ALIGNMENT
 
+#if !defined(IREE_HAL_HEAP_BUFFER_POOL_ENABLE)
+// Enables thread-caching pools of buffer storage in heap allocators. Pools
+// retain a bounded amount of freed storage for reuse and trade some memory
+// consumption for avoiding the system allocator on every buffer allocation.
+// Disabling can make it easier to track down use-after-free issues.
+#define IREE_HAL_HEAP_BUFFER_POOL_ENABLE 1
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_ENABLE
+
 #if !defined(IREE_HAL_COMMAND_BUFFER_VALIDATION_ENABLE)
 // Enables additional validation of commands issued against command buffers.
 // This adds small amounts of per-command overhead but in all but the most
@@ -281,6 +289,13 @@ typedef IREE_DEVICE_SIZE_T iree_device_size_t;
 #define IREE_VM_EXECUTION_TRACING_SRC_LOC_ENABLE 0
 #endif  // !IREE_VM_EXECUTION_TRACING_SRC_LOC_ENABLE
 
+#if !defined(IREE_VM_SAMPLING_PROFILER_ENABLE)
+// Enables the VM sampling profiler (iree_vm_sampling_profiler_t). When enabled
+// but no profiler is active each VM function entry performs a single relaxed
+// atomic load.
+#define IREE_VM_SAMPLING_PROFILER_ENABLE 1
+#endif  // !IREE_VM_SAMPLING_PROFILER_ENABLE
+
 #if !defined(IREE_VM_BYTECODE_DISPATCH_COMPUTED_GOTO_ENABLE)
 // Enables the use of compute goto for bytecode dispatch. This can have a
 // moderate performance improvement (~10-20%) on very heavy VMVX workloads but
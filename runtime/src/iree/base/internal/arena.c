@@ -26,6 +26,14 @@ void iree_arena_block_pool_initialize(iree_host_size_t total_block_size,
       total_block_size - sizeof(iree_arena_block_t);
   out_block_pool->block_allocator = block_allocator;
   iree_atomic_arena_block_slist_initialize(&out_block_pool->available_slist);
+  IREE_STATISTICS({
+    iree_atomic_store_int64(&out_block_pool->acquire_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&out_block_pool->allocation_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&out_block_pool->live_block_count, 0,
+                            iree_memory_order_relaxed);
+  });
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -52,6 +60,8 @@ void iree_arena_block_pool_trim(iree_arena_block_pool_t* block_pool) {
     void* ptr = (uint8_t*)head - block_pool->usable_block_size;
     head = head->next;
     iree_allocator_free(block_pool->block_allocator, ptr);
+    IREE_STATISTICS(iree_atomic_fetch_sub_int64(
+        &block_pool->live_block_count, 1, iree_memory_order_relaxed));
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -64,6 +74,8 @@ iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
 
   iree_arena_block_t* block =
       iree_atomic_arena_block_slist_pop(&block_pool->available_slist);
+  IREE_STATISTICS(iree_atomic_fetch_add_int64(&block_pool->acquire_count, 1,
+                                              iree_memory_order_relaxed));
 
   if (!block) {
     // No blocks available; allocate one now.
@@ -79,6 +91,12 @@ iree_status_t iree_arena_block_pool_acquire(iree_arena_block_pool_t* block_pool,
                                                 (void**)&block_base));
     block = iree_arena_block_trailer(block_pool, block_base);
     *out_ptr = block_base;
+    IREE_STATISTICS({
+      iree_atomic_fetch_add_int64(&block_pool->allocation_count, 1,
+                                  iree_memory_order_relaxed);
+      iree_atomic_fetch_add_int64(&block_pool->live_block_count, 1,
+                                  iree_memory_order_relaxed);
+    });
   } else {
     *out_ptr = iree_arena_block_ptr(block_pool, block);
   }
@@ -99,6 +117,20 @@ void iree_arena_block_pool_release(iree_arena_block_pool_t* block_pool,
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_arena_block_pool_query_statistics(
+    iree_arena_block_pool_t* block_pool,
+    iree_arena_block_pool_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  IREE_STATISTICS({
+    out_statistics->acquire_count = iree_atomic_load_int64(
+        &block_pool->acquire_count, iree_memory_order_relaxed);
+    out_statistics->allocation_count = iree_atomic_load_int64(
+        &block_pool->allocation_count, iree_memory_order_relaxed);
+    out_statistics->live_block_count = iree_atomic_load_int64(
+        &block_pool->live_block_count, iree_memory_order_relaxed);
+  });
+}
+
 //===----------------------------------------------------------------------===//
 // iree_arena_allocator_t
 //===----------------------------------------------------------------------===//
@@ -140,6 +172,7 @@ void iree_arena_reset(iree_arena_allocator_t* arena) {
     arena->block_head = NULL;
     arena->block_tail = NULL;
   }
+  memset(arena->free_lists, 0, sizeof(arena->free_lists));
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -177,6 +210,20 @@ iree_status_t iree_arena_allocate(iree_arena_allocator_t* arena,
   iree_host_size_t aligned_length =
       iree_host_align(byte_length, iree_max_align_t);
 
+  // Reuse a previously freed allocation of the same size class, if any.
+  if (aligned_length && aligned_length <= IREE_ARENA_MAX_SIZE_CLASS_SIZE) {
+    iree_arena_free_allocation_t** free_list =
+        &arena->free_lists[aligned_length / iree_max_align_t - 1];
+    iree_arena_free_allocation_t* allocation = *free_list;
+    if (allocation) {
+      IREE_ASAN_UNPOISON_MEMORY_REGION(allocation, aligned_length);
+      *free_list = allocation->next;
+      arena->used_allocation_size += aligned_length;
+      *out_ptr = allocation;
+      return iree_ok_status();
+    }
+  }
+
   // Check to see if the current block (if any) has space - if not, get another.
   if (arena->block_head == NULL ||
       arena->block_bytes_remaining < aligned_length) {
@@ -205,6 +252,40 @@ iree_status_t iree_arena_allocate(iree_arena_allocator_t* arena,
   return iree_ok_status();
 }
 
+void iree_arena_free(iree_arena_allocator_t* arena,
+                     iree_host_size_t byte_length, void* ptr) {
+  if (!ptr) return;
+
+  // Oversized allocations are owned by the arena until reset.
+  if (byte_length > arena->block_pool->usable_block_size) return;
+  iree_host_size_t aligned_length =
+      iree_host_align(byte_length, iree_max_align_t);
+  if (!aligned_length) return;
+
+  // If this was the most recent allocation from the current block we can just
+  // return it to the block. This is common with scoped temporary allocations.
+  if (arena->block_head &&
+      (uint8_t*)ptr + aligned_length ==
+          (uint8_t*)arena->block_head - arena->block_bytes_remaining) {
+    IREE_ASAN_POISON_MEMORY_REGION(ptr, aligned_length);
+    arena->block_bytes_remaining += aligned_length;
+    arena->used_allocation_size -= aligned_length;
+    return;
+  }
+
+  // Small allocations are kept for reuse by their size class. Larger ones are
+  // dropped and their storage is reclaimed when the arena is reset.
+  if (aligned_length > IREE_ARENA_MAX_SIZE_CLASS_SIZE) return;
+  iree_arena_free_allocation_t** free_list =
+      &arena->free_lists[aligned_length / iree_max_align_t - 1];
+  iree_arena_free_allocation_t* allocation =
+      (iree_arena_free_allocation_t*)ptr;
+  allocation->next = *free_list;
+  *free_list = allocation;
+  arena->used_allocation_size -= aligned_length;
+  IREE_ASAN_POISON_MEMORY_REGION(ptr, aligned_length);
+}
+
 static iree_status_t iree_arena_allocator_ctl(void* self,
                                               iree_allocator_command_t command,
                                               const void* params,
@@ -62,8 +62,25 @@ typedef struct iree_arena_block_pool_t {
   iree_allocator_t block_allocator;
   // Linked list of free blocks (LIFO).
   iree_atomic_arena_block_slist_t available_slist;
+#if IREE_STATISTICS_ENABLE
+  // Counters queried with iree_arena_block_pool_query_statistics.
+  iree_atomic_int64_t acquire_count;
+  iree_atomic_int64_t allocation_count;
+  iree_atomic_int64_t live_block_count;
+#endif  // IREE_STATISTICS_ENABLE
 } iree_arena_block_pool_t;
 
+// Aggregate statistics of a block pool.
+typedef struct iree_arena_block_pool_statistics_t {
+  // Total number of blocks acquired from the pool.
+  int64_t acquire_count;
+  // Number of acquisitions that had to allocate a new block from the system
+  // because no free blocks were available.
+  int64_t allocation_count;
+  // Number of blocks currently allocated by the pool, including free ones.
+  int64_t live_block_count;
+} iree_arena_block_pool_statistics_t;
+
 // Initializes a new block pool in |out_block_pool|.
 // |block_allocator| will be used to allocate and free blocks for the pool.
 // Each block allocated will be |total_block_size| but have a slightly smaller
@@ -96,6 +113,13 @@ void iree_arena_block_pool_release(iree_arena_block_pool_t* block_pool,
                                    iree_arena_block_t* block_head,
                                    iree_arena_block_t* block_tail);
 
+// Queries aggregate statistics of the |block_pool|. Counters are updated with
+// relaxed atomics and may be slightly stale when blocks are being acquired
+// concurrently. All values are zero if IREE_STATISTICS_ENABLE is 0.
+void iree_arena_block_pool_query_statistics(
+    iree_arena_block_pool_t* block_pool,
+    iree_arena_block_pool_statistics_t* out_statistics);
+
 //===----------------------------------------------------------------------===//
 // iree_arena_allocator_t
 //===----------------------------------------------------------------------===//
@@ -104,6 +128,19 @@ typedef struct iree_arena_oversized_allocation_t {
   struct iree_arena_oversized_allocation_t* next;
 } iree_arena_oversized_allocation_t;
 
+// Number of small-object size classes tracked by each arena. Size class i
+// holds freed allocations of (i + 1) * iree_max_align_t bytes.
+#define IREE_ARENA_SIZE_CLASS_COUNT 8
+
+// Largest allocation size, in bytes, reused by arena size classes.
+#define IREE_ARENA_MAX_SIZE_CLASS_SIZE \
+  (IREE_ARENA_SIZE_CLASS_COUNT * iree_max_align_t)
+
+// An allocation freed to an arena size class free list.
+typedef struct iree_arena_free_allocation_t {
+  struct iree_arena_free_allocation_t* next;
+} iree_arena_free_allocation_t;
+
 // A lightweight bump-pointer arena allocator using a shared block pool.
 // As allocations are made from the arena and block capacity is exhausted new
 // blocks will be acquired from the pool. Upon being reset all blocks will be
@@ -115,6 +152,13 @@ typedef struct iree_arena_oversized_allocation_t {
 // incur additional allocation overhead as the block pool is bypassed and the
 // system allocator is directly used to service the request.
 //
+// Small allocations may be explicitly returned to the arena with
+// iree_arena_free to make them available to future allocations of the same
+// size class prior to the arena being reset. This allows code that churns
+// through many similarly sized objects while recording (command buffer
+// commands, temporary lists, etc) to keep its footprint in the block pool
+// bounded.
+//
 // Thread-compatible; the shared block pool is thread-safe and may be used by
 // arenas on multiple threads but each arena must only be used by a single
 // thread.
@@ -134,6 +178,8 @@ typedef struct iree_arena_allocator_t {
   iree_arena_block_t* block_tail;
   // The number of bytes remaining in the block pointed to by block_head.
   iree_host_size_t block_bytes_remaining;
+  // Free lists of allocations returned with iree_arena_free by size class.
+  iree_arena_free_allocation_t* free_lists[IREE_ARENA_SIZE_CLASS_COUNT];
 } iree_arena_allocator_t;
 
 // Initializes an arena that will use |block_pool| for allocating blocks as
@@ -153,6 +199,14 @@ void iree_arena_reset(iree_arena_allocator_t* arena);
 iree_status_t iree_arena_allocate(iree_arena_allocator_t* arena,
                                   iree_host_size_t byte_length, void** out_ptr);
 
+// Returns an allocation of |byte_length| bytes at |ptr| made with
+// iree_arena_allocate to the arena. The most recent allocation is returned to
+// the current block and allocations up to IREE_ARENA_MAX_SIZE_CLASS_SIZE are
+// reused by future allocations of the same size class. Other allocations
+// remain reserved until the arena is reset.
+void iree_arena_free(iree_arena_allocator_t* arena,
+                     iree_host_size_t byte_length, void* ptr);
+
 // Returns an iree_allocator_t that allocates from the given |arena|.
 // Frees are ignored as arenas can only be reset as a whole.
 iree_allocator_t iree_arena_allocator(iree_arena_allocator_t* arena);
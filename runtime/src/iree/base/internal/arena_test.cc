@@ -0,0 +1,101 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/arena.h"
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class ArenaTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_arena_block_pool_initialize(4096, iree_allocator_system(),
+                                     &block_pool_);
+    iree_arena_initialize(&block_pool_, &arena_);
+  }
+
+  void TearDown() override {
+    iree_arena_deinitialize(&arena_);
+    iree_arena_block_pool_deinitialize(&block_pool_);
+  }
+
+  iree_arena_block_pool_t block_pool_;
+  iree_arena_allocator_t arena_;
+};
+
+TEST_F(ArenaTest, FreeMostRecent) {
+  void* ptr_a = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 100, &ptr_a));
+  void* ptr_b = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 1000, &ptr_b));
+  iree_host_size_t used_size = arena_.used_allocation_size;
+
+  // Freeing the most recent allocation returns it to the block even though it
+  // is larger than any size class.
+  iree_arena_free(&arena_, 1000, ptr_b);
+  EXPECT_LT(arena_.used_allocation_size, used_size);
+  void* ptr_c = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 1000, &ptr_c));
+  EXPECT_EQ(ptr_b, ptr_c);
+}
+
+TEST_F(ArenaTest, ReuseSizeClasses) {
+  void* ptrs[4] = {NULL};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(ptrs); ++i) {
+    IREE_ASSERT_OK(iree_arena_allocate(&arena_, 24, &ptrs[i]));
+  }
+  void* ptr_tail = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 64, &ptr_tail));
+
+  // Free out of order so that the allocations go to the size class list.
+  iree_arena_free(&arena_, 24, ptrs[1]);
+  iree_arena_free(&arena_, 24, ptrs[2]);
+
+  // Different size classes must not be reused.
+  void* ptr_other = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 48, &ptr_other));
+  EXPECT_NE(ptr_other, ptrs[1]);
+  EXPECT_NE(ptr_other, ptrs[2]);
+
+  // Sizes rounding to the same class reuse the freed allocations (LIFO).
+  void* ptr_reuse_0 = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 20, &ptr_reuse_0));
+  EXPECT_EQ(ptr_reuse_0, ptrs[2]);
+  void* ptr_reuse_1 = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 24, &ptr_reuse_1));
+  EXPECT_EQ(ptr_reuse_1, ptrs[1]);
+
+  // Resetting drops the free lists.
+  iree_arena_free(&arena_, 24, ptrs[0]);
+  iree_arena_reset(&arena_);
+  EXPECT_EQ(arena_.used_allocation_size, 0);
+  void* ptr_new = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 24, &ptr_new));
+  EXPECT_NE(ptr_new, nullptr);
+}
+
+TEST_F(ArenaTest, BlockPoolStatistics) {
+  // Allocate enough to require two blocks.
+  void* ptr = NULL;
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 3000, &ptr));
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 3000, &ptr));
+  iree_arena_reset(&arena_);
+  IREE_ASSERT_OK(iree_arena_allocate(&arena_, 3000, &ptr));
+
+  iree_arena_block_pool_statistics_t statistics;
+  iree_arena_block_pool_query_statistics(&block_pool_, &statistics);
+#if IREE_STATISTICS_ENABLE
+  EXPECT_EQ(statistics.acquire_count, 3);
+  EXPECT_EQ(statistics.allocation_count, 2);
+  EXPECT_EQ(statistics.live_block_count, 2);
+#else
+  EXPECT_EQ(statistics.acquire_count, 0);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+}  // namespace
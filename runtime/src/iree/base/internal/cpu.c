@@ -150,6 +150,16 @@ static void iree_cpu_initialize_from_platform_arm_64(uint64_t* out_fields) {
           .out_field_index = 0,
           .out_field_bits = IREE_CPU_DATA0_ARM_64_BF16,
       },
+      {
+          .sysctl_key = "hw.optional.arm.FEAT_SME",
+          .out_field_index = 0,
+          .out_field_bits = IREE_CPU_DATA0_ARM_64_SME,
+      },
+      {
+          .sysctl_key = "hw.optional.arm.FEAT_SME2",
+          .out_field_index = 0,
+          .out_field_bits = IREE_CPU_DATA0_ARM_64_SME2,
+      },
   };
   for (int i = 0; i < IREE_ARRAYSIZE(features); ++i) {
     const feature_t* f = &features[i];
@@ -248,6 +258,33 @@ static iree_cpuid_regs_t iree_cpuid_or_zero(uint32_t eax, uint32_t ecx,
   return iree_cpuid_raw(eax, ecx);
 }
 
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// From asm/prctl.h and asm/fpu/types.h (Linux 5.16+); defined here as older
+// system headers may not have them.
+#define IREE_ARCH_REQ_XCOMP_PERM 0x1023
+#define IREE_XFEATURE_XTILEDATA 18
+
+// Requests permission to use the AMX tile data state. Linux only enables the
+// large (8KB) tile state for processes that request it so that it need not be
+// saved/restored on context switches otherwise: without the permission any
+// AMX instruction will raise SIGILL. The permission applies to all threads in
+// the process, including ones already running.
+static bool iree_cpu_request_amx_permission(void) {
+  return syscall(SYS_arch_prctl, IREE_ARCH_REQ_XCOMP_PERM,
+                 IREE_XFEATURE_XTILEDATA) == 0;
+}
+
+#else
+
+// Other platforms enable the tile state for all processes when supported.
+static bool iree_cpu_request_amx_permission(void) { return true; }
+
+#endif  // IREE_PLATFORM_*
+
 static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
   iree_cpuid_bounds_t bounds = iree_cpuid_query_bounds();
   iree_cpuid_regs_t leaf1 = iree_cpuid_or_zero(1, 0, bounds);
@@ -300,8 +337,11 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
                    1 << 23);
   }
 
-  // Features that depend on AMX TILE state being enabled by the OS.
-  if (iree_all_bits_set(leafD.eax, 0x60000)) {
+  // Features that depend on AMX TILE state being enabled by the OS and the
+  // process having permission to use it.
+  if (iree_all_bits_set(leafD.eax, 0x60000) &&
+      iree_all_bits_set(leaf7_0.edx, 1 << 24) &&
+      iree_cpu_request_amx_permission()) {
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXTILE, leaf7_0.edx, 1 << 24);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXINT8, leaf7_0.edx, 1 << 25);
     IREE_COPY_BITS(out0, IREE_CPU_DATA0_X86_64_AMXBF16, leaf7_0.edx, 1 << 22);
@@ -317,13 +357,46 @@ static void iree_cpu_initialize_from_platform_x86_64(uint64_t* out_fields) {
 // that, and as we are OK with requiring a sufficiently recent linux kernel to
 // expose the features that we need, we can just rely on the basic HWCAP way.
 #include <sys/auxv.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 #define IREE_HWCAP_ISA_V (1 << ('V' - 'A'))
 
+// Multi-letter extensions are not in HWCAP. They are reported by the
+// riscv_hwprobe syscall (Linux 6.4+). These match asm/hwprobe.h, which older
+// toolchains do not ship.
+#define IREE_RISCV_HWPROBE_KEY_IMA_EXT_0 4
+#define IREE_RISCV_HWPROBE_IMA_V (1ull << 2)
+#define IREE_RISCV_HWPROBE_EXT_ZVFH (1ull << 30)
+
+typedef struct iree_riscv_hwprobe_t {
+  int64_t key;
+  uint64_t value;
+} iree_riscv_hwprobe_t;
+
+static uint64_t iree_cpu_query_riscv_hwprobe_ima_ext_0(void) {
+#if defined(__NR_riscv_hwprobe)
+  iree_riscv_hwprobe_t pair = {IREE_RISCV_HWPROBE_KEY_IMA_EXT_0, 0};
+  if (syscall(__NR_riscv_hwprobe, &pair, 1, 0, NULL, 0) == 0 &&
+      pair.key == IREE_RISCV_HWPROBE_KEY_IMA_EXT_0) {
+    return pair.value;
+  }
+#endif  // defined(__NR_riscv_hwprobe)
+  return 0;
+}
+
 static void iree_cpu_initialize_from_platform_riscv_64(uint64_t* out_fields) {
   unsigned long hwcap = getauxval(AT_HWCAP);
   IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_RISCV_64_RVV, hwcap,
                  IREE_HWCAP_ISA_V);
+  uint64_t ext0 = iree_cpu_query_riscv_hwprobe_ima_ext_0();
+  IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_RISCV_64_RVV, ext0,
+                 IREE_RISCV_HWPROBE_IMA_V);
+  // Zvfh is only usable when the vector unit itself is.
+  if (out_fields[0] & IREE_CPU_DATA0_RISCV_64_RVV) {
+    IREE_COPY_BITS(out_fields[0], IREE_CPU_DATA0_RISCV_64_ZVFH, ext0,
+                   IREE_RISCV_HWPROBE_EXT_ZVFH);
+  }
 }
 
 #endif  // IREE_PLATFORM_*
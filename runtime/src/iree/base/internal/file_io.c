@@ -39,6 +39,10 @@
 static iree_status_t iree_file_map_contents_readonly_platform(
     const char* path, iree_file_contents_t* contents);
 static void iree_file_contents_free_platform(iree_file_contents_t* contents);
+static void iree_file_contents_advise_platform(iree_file_contents_t* contents,
+                                              iree_host_size_t offset,
+                                              iree_host_size_t length,
+                                              iree_file_advice_t advice);
 
 iree_status_t iree_file_exists(const char* path) {
   IREE_ASSERT_ARGUMENT(path);
@@ -122,6 +126,16 @@ void iree_file_contents_free(iree_file_contents_t* contents) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_file_contents_advise(iree_file_contents_t* contents,
+                               iree_host_size_t offset, iree_host_size_t length,
+                               iree_file_advice_t advice) {
+  if (!contents || !contents->mapping || !contents->buffer.data) return;
+  if (offset >= contents->buffer.data_length) return;
+  length = iree_min(length, contents->buffer.data_length - offset);
+  if (!length) return;
+  iree_file_contents_advise_platform(contents, offset, length, advice);
+}
+
 iree_status_t iree_file_read_contents(const char* path,
                                       iree_file_read_flags_t flags,
                                       iree_allocator_t allocator,
@@ -317,6 +331,35 @@ static void iree_file_contents_free_platform(iree_file_contents_t* contents) {
   }
 }
 
+static void iree_file_contents_advise_platform(iree_file_contents_t* contents,
+                                              iree_host_size_t offset,
+                                              iree_host_size_t length,
+                                              iree_file_advice_t advice) {
+  int posix_advice = MADV_NORMAL;
+  switch (advice) {
+    default:
+    case IREE_FILE_ADVICE_NORMAL:
+      posix_advice = MADV_NORMAL;
+      break;
+    case IREE_FILE_ADVICE_RANDOM:
+      posix_advice = MADV_RANDOM;
+      break;
+    case IREE_FILE_ADVICE_SEQUENTIAL:
+      posix_advice = MADV_SEQUENTIAL;
+      break;
+    case IREE_FILE_ADVICE_WILLNEED:
+      posix_advice = MADV_WILLNEED;
+      break;
+  }
+  // madvise requires a page-aligned base address. Mappings are always page
+  // aligned so the range will never extend outside of the mapping.
+  uintptr_t page_size = (uintptr_t)sysconf(_SC_PAGESIZE);
+  uintptr_t range_start = (uintptr_t)contents->buffer.data + offset;
+  uintptr_t range_end = range_start + length;
+  range_start &= ~(page_size - 1);
+  madvise((void*)range_start, (size_t)(range_end - range_start), posix_advice);
+}
+
 #elif defined(IREE_PLATFORM_WINDOWS)
 
 static iree_status_t iree_file_map_contents_readonly_platform(
@@ -437,6 +480,15 @@ static void iree_file_contents_free_platform(iree_file_contents_t* contents) {
   }
 }
 
+static void iree_file_contents_advise_platform(iree_file_contents_t* contents,
+                                              iree_host_size_t offset,
+                                              iree_host_size_t length,
+                                              iree_file_advice_t advice) {
+  // NOTE: PrefetchVirtualMemory could be used for IREE_FILE_ADVICE_WILLNEED
+  // but is not available on all Windows versions we support. Random access is
+  // requested for the whole file when it is opened for mapping.
+}
+
 #else
 
 static iree_status_t iree_file_map_contents_readonly_platform(
@@ -454,6 +506,11 @@ static iree_status_t iree_file_create_mapped_platform(
 
 static void iree_file_contents_free_platform(iree_file_contents_t* contents) {}
 
+static void iree_file_contents_advise_platform(iree_file_contents_t* contents,
+                                              iree_host_size_t offset,
+                                              iree_host_size_t length,
+                                              iree_file_advice_t advice) {}
+
 #endif  // IREE_PLATFORM_*
 
 iree_status_t iree_file_create_mapped(const char* path, uint64_t file_size,
@@ -586,6 +643,10 @@ iree_allocator_t iree_file_contents_deallocator(
 
 void iree_file_contents_free(iree_file_contents_t* contents) {}
 
+void iree_file_contents_advise(iree_file_contents_t* contents,
+                               iree_host_size_t offset, iree_host_size_t length,
+                               iree_file_advice_t advice) {}
+
 iree_status_t iree_file_read_contents(const char* path,
                                       iree_file_read_flags_t flags,
                                       iree_allocator_t allocator,
@@ -46,6 +46,29 @@ iree_allocator_t iree_file_contents_deallocator(iree_file_contents_t* contents);
 // Frees memory associated with |contents|.
 void iree_file_contents_free(iree_file_contents_t* contents);
 
+// Describes how a range of mapped file contents is expected to be accessed.
+typedef enum iree_file_advice_e {
+  // No special treatment; the platform default read-ahead is used.
+  IREE_FILE_ADVICE_NORMAL = 0,
+  // Pages are accessed in random order and read-ahead should be disabled.
+  // Useful for large constant data that is only sparsely referenced.
+  IREE_FILE_ADVICE_RANDOM,
+  // Pages are accessed in sequential order and may be aggressively read ahead.
+  IREE_FILE_ADVICE_SEQUENTIAL,
+  // Pages will be accessed soon and should be read ahead asynchronously.
+  IREE_FILE_ADVICE_WILLNEED,
+} iree_file_advice_t;
+
+// Advises the platform how the |offset| to |offset|+|length| byte range of
+// |contents| will be accessed. The range is expanded to page boundaries.
+// Only contents mapped with iree_file_map_contents_readonly or
+// iree_file_create_mapped are affected; advice on contents read into memory
+// and on platforms without support is ignored. Advice is only a hint and
+// failures are ignored.
+void iree_file_contents_advise(iree_file_contents_t* contents,
+                               iree_host_size_t offset, iree_host_size_t length,
+                               iree_file_advice_t advice);
+
 typedef enum iree_file_read_flag_bits_t {
   IREE_FILE_READ_FLAG_PRELOAD = (1u << 0),
   IREE_FILE_READ_FLAG_MMAP = (1u << 1),
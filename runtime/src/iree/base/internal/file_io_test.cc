@@ -130,6 +130,48 @@ TEST(FileIO, ReadWriteContentsMmap) {
   iree_file_contents_free(read_contents);
 }
 
+TEST(FileIO, AdviseMappedContents) {
+  constexpr const char* kUniqueName = "AdviseMappedContents";
+  auto path = GetUniquePath(kUniqueName);
+
+  // Generate file contents spanning multiple pages.
+  auto write_contents = GetUniqueContents(kUniqueName, 3 * 4096 + 123);
+  IREE_ASSERT_OK(iree_file_write_contents(
+      path.c_str(),
+      iree_make_const_byte_span(write_contents.data(), write_contents.size())));
+
+  iree_file_contents_t* read_contents = NULL;
+  IREE_ASSERT_OK(iree_file_read_contents(path.c_str(), IREE_FILE_READ_FLAG_MMAP,
+                                         iree_allocator_system(),
+                                         &read_contents));
+
+  // Advice is only a hint and must never change the contents, including on
+  // unaligned and out of bounds ranges.
+  iree_file_contents_advise(read_contents, 0, SIZE_MAX,
+                            IREE_FILE_ADVICE_RANDOM);
+  iree_file_contents_advise(read_contents, 17, 4096, IREE_FILE_ADVICE_WILLNEED);
+  iree_file_contents_advise(read_contents, 4096 + 1, 64,
+                            IREE_FILE_ADVICE_SEQUENTIAL);
+  iree_file_contents_advise(read_contents, write_contents.size(), 1,
+                            IREE_FILE_ADVICE_NORMAL);
+  EXPECT_EQ(write_contents.size(), read_contents->const_buffer.data_length);
+  EXPECT_EQ(memcmp(write_contents.data(), read_contents->const_buffer.data,
+                   read_contents->const_buffer.data_length),
+            0);
+  iree_file_contents_free(read_contents);
+
+  // Advice on preloaded contents is ignored.
+  IREE_ASSERT_OK(iree_file_read_contents(
+      path.c_str(), IREE_FILE_READ_FLAG_PRELOAD, iree_allocator_system(),
+      &read_contents));
+  iree_file_contents_advise(read_contents, 0, SIZE_MAX,
+                            IREE_FILE_ADVICE_WILLNEED);
+  EXPECT_EQ(memcmp(write_contents.data(), read_contents->const_buffer.data,
+                   read_contents->const_buffer.data_length),
+            0);
+  iree_file_contents_free(read_contents);
+}
+
 }  // namespace
 }  // namespace file_io
 }  // namespace iree
@@ -26,21 +26,33 @@ iree_memory_info_t iree_memory_query_info(void) {
 
 #elif defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
 
+#include <fcntl.h>
+#include <stdlib.h>
 #include <unistd.h>
 
+// Returns the transparent huge page size reported by the kernel or 0 if THP is
+// not supported.
+static iree_host_size_t iree_memory_query_transparent_large_page_size(void) {
+  int fd = open("/sys/kernel/mm/transparent_hugepage/hpage_pmd_size",
+                O_RDONLY | O_CLOEXEC);
+  if (fd < 0) return 0;
+  char buffer[32] = {0};
+  ssize_t read_length = read(fd, buffer, sizeof(buffer) - 1);
+  close(fd);
+  if (read_length <= 0) return 0;
+  return (iree_host_size_t)strtoull(buffer, NULL, 10);
+}
+
 iree_memory_info_t iree_memory_query_info(void) {
   const int page_size = sysconf(_SC_PAGESIZE);
+  const iree_host_size_t large_page_size =
+      iree_memory_query_transparent_large_page_size();
   return (iree_memory_info_t){
       .normal_page_size = page_size,
       .normal_page_granularity = page_size,
-      // Large pages arent't currently used so we aren't introducing the build
-      // goo to detect and use them yet.
-      // https://linux.die.net/man/3/gethugepagesizes
-      // http://manpages.ubuntu.com/manpages/bionic/man3/gethugepagesize.3.html
-      // Would be:
-      //   #include <hugetlbfs.h>
-      //   out_info->large_page_granularity = gethugepagesize();
-      .large_page_granularity = page_size,
+      // Explicit hugetlbfs pages of other sizes may also be available but
+      // require the system to have reserved them ahead of time.
+      .large_page_granularity = large_page_size ? large_page_size : page_size,
       .supported_features = IREE_MEMORY_FEATURE_ALLOCATABLE_EXECUTABLE_PAGES,
   };
 }
@@ -159,3 +171,296 @@ void iree_memory_flush_icache(void* base_address, iree_host_size_t length) {
 }
 
 #endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// Large page allocation
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_memory_large_page_mode_parse(
+    iree_string_view_t value, iree_memory_large_page_mode_t* out_mode) {
+  if (iree_string_view_is_empty(value) ||
+      iree_string_view_equal(value, IREE_SV("none"))) {
+    *out_mode = IREE_MEMORY_LARGE_PAGE_MODE_NONE;
+  } else if (iree_string_view_equal(value, IREE_SV("transparent"))) {
+    *out_mode = IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT;
+  } else if (iree_string_view_equal(value, IREE_SV("2mb"))) {
+    *out_mode = IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB;
+  } else if (iree_string_view_equal(value, IREE_SV("1gb"))) {
+    *out_mode = IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_1GB;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown large page mode '%.*s'; expected one of "
+                            "`none`, `transparent`, `2mb`, or `1gb`",
+                            (int)value.size, value.data);
+  }
+  return iree_ok_status();
+}
+
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_LINUX)
+
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+
+#if !defined(MAP_HUGE_SHIFT)
+#define MAP_HUGE_SHIFT 26
+#endif  // !MAP_HUGE_SHIFT
+
+iree_host_size_t iree_memory_large_page_size(
+    iree_memory_large_page_mode_t mode) {
+  switch (mode) {
+    case IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT:
+      return iree_memory_query_transparent_large_page_size();
+    case IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB:
+      return 2 * 1024 * 1024;
+    case IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_1GB:
+      return 1024 * 1024 * 1024;
+    default:
+      return 0;
+  }
+}
+
+// Header stored immediately prior to each large page allocation.
+// Sized to preserve the natural SIMD alignment of the allocation.
+typedef struct iree_memory_large_page_header_t {
+  // Total length of the mapping including the header or 0 if the allocation was
+  // made from the system allocator.
+  iree_host_size_t mapping_length;
+  // Requested allocation length excluding the header.
+  iree_host_size_t byte_length;
+} iree_memory_large_page_header_t;
+#define IREE_MEMORY_LARGE_PAGE_HEADER_SIZE 64
+static_assert(sizeof(iree_memory_large_page_header_t) <=
+                  IREE_MEMORY_LARGE_PAGE_HEADER_SIZE,
+              "header must fit in the reserved prefix");
+
+static iree_memory_large_page_header_t* iree_memory_large_page_header(
+    void* ptr) {
+  return (iree_memory_large_page_header_t*)((uint8_t*)ptr -
+                                            IREE_MEMORY_LARGE_PAGE_HEADER_SIZE);
+}
+
+// Maps |mapping_length| bytes aligned to |page_size| and requests transparent
+// large pages for it. The mapping is over-reserved and trimmed to ensure the
+// base address is large page aligned as otherwise the kernel is unable to use
+// large pages for the head of the mapping.
+static void* iree_memory_map_transparent_large_pages(
+    iree_host_size_t mapping_length, iree_host_size_t page_size) {
+  const iree_host_size_t reserve_length = mapping_length + page_size;
+  uint8_t* reserve_base = (uint8_t*)mmap(NULL, reserve_length,
+                                         PROT_READ | PROT_WRITE,
+                                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (reserve_base == MAP_FAILED) return NULL;
+  uint8_t* base = (uint8_t*)iree_host_align((uintptr_t)reserve_base, page_size);
+  const iree_host_size_t head_length = base - reserve_base;
+  const iree_host_size_t tail_length =
+      reserve_length - head_length - mapping_length;
+  if (head_length) munmap(reserve_base, head_length);
+  if (tail_length) munmap(base + mapping_length, tail_length);
+  // NOTE: failure is ignored; the kernel may have THP disabled and the
+  // allocation will use normal pages.
+  madvise(base, mapping_length, MADV_HUGEPAGE);
+  return base;
+}
+
+// Maps |mapping_length| bytes backed by large pages per |mode|.
+static void* iree_memory_map_large_pages(iree_memory_large_page_mode_t mode,
+                                         iree_host_size_t mapping_length,
+                                         iree_host_size_t page_size) {
+#if defined(MAP_HUGETLB)
+  if (mode == IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB ||
+      mode == IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_1GB) {
+    const int page_shift =
+        mode == IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB ? 21 : 30;
+    void* base = mmap(NULL, mapping_length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB |
+                          (page_shift << MAP_HUGE_SHIFT),
+                      -1, 0);
+    if (base != MAP_FAILED) return base;
+    // Pool exhausted or not configured; fall back to transparent pages.
+  }
+#endif  // MAP_HUGETLB
+  return iree_memory_map_transparent_large_pages(
+      mapping_length,
+      iree_max(page_size, iree_memory_query_transparent_large_page_size()));
+}
+
+static iree_status_t iree_allocator_large_pages_alloc(
+    iree_memory_large_page_mode_t mode, iree_allocator_command_t command,
+    const iree_allocator_alloc_params_t* params, void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(params);
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  const iree_host_size_t byte_length = params->byte_length;
+  if (IREE_UNLIKELY(byte_length == 0)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "allocations must be >0 bytes");
+  }
+
+  // Reuse the existing allocation if it is large enough.
+  void* existing_ptr =
+      command == IREE_ALLOCATOR_COMMAND_REALLOC ? *inout_ptr : NULL;
+  iree_memory_large_page_header_t* existing_header =
+      existing_ptr ? iree_memory_large_page_header(existing_ptr) : NULL;
+  if (existing_header && existing_header->mapping_length &&
+      existing_header->mapping_length - IREE_MEMORY_LARGE_PAGE_HEADER_SIZE >=
+          byte_length) {
+    existing_header->byte_length = byte_length;
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, byte_length);
+
+  const iree_host_size_t page_size = iree_memory_large_page_size(mode);
+  const iree_host_size_t total_length =
+      byte_length + IREE_MEMORY_LARGE_PAGE_HEADER_SIZE;
+  uint8_t* base = NULL;
+  iree_host_size_t mapping_length = 0;
+  if (page_size && byte_length >= page_size) {
+    mapping_length = iree_host_align(total_length, page_size);
+    base = (uint8_t*)iree_memory_map_large_pages(mode, mapping_length,
+                                                 page_size);
+    if (!base) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "large page mapping of %" PRIhsz " bytes failed",
+                              mapping_length);
+    }
+  } else if (existing_header && !existing_header->mapping_length) {
+    // Small reallocation of a small allocation; reuse the system realloc.
+    base = (uint8_t*)realloc(existing_header, total_length);
+    if (!base) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "system realloc failed");
+    }
+    existing_header = NULL;
+    existing_ptr = NULL;
+  } else {
+    base = (uint8_t*)(command == IREE_ALLOCATOR_COMMAND_CALLOC
+                          ? calloc(1, total_length)
+                          : malloc(total_length));
+    if (!base) {
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                              "system allocation failed");
+    }
+  }
+  // NOTE: fresh anonymous mappings are always zeroed.
+
+  iree_memory_large_page_header_t* header =
+      (iree_memory_large_page_header_t*)base;
+  header->mapping_length = mapping_length;
+  header->byte_length = byte_length;
+  void* ptr = base + IREE_MEMORY_LARGE_PAGE_HEADER_SIZE;
+
+  // Copy over and release the existing allocation if it was moved.
+  if (existing_header) {
+    memcpy(ptr, existing_ptr, iree_min(existing_header->byte_length,
+                                       byte_length));
+    if (existing_header->mapping_length) {
+      munmap(existing_header, existing_header->mapping_length);
+    } else {
+      free(existing_header);
+    }
+  }
+
+  *inout_ptr = ptr;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_allocator_large_pages_free(void** inout_ptr) {
+  IREE_ASSERT_ARGUMENT(inout_ptr);
+  void* ptr = *inout_ptr;
+  if (IREE_LIKELY(ptr != NULL)) {
+    iree_memory_large_page_header_t* header =
+        iree_memory_large_page_header(ptr);
+    if (header->mapping_length) {
+      munmap(header, header->mapping_length);
+    } else {
+      free(header);
+    }
+    *inout_ptr = NULL;
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_allocator_large_pages_ctl(
+    void* self, iree_allocator_command_t command, const void* params,
+    void** inout_ptr) {
+  iree_memory_large_page_mode_t mode =
+      (iree_memory_large_page_mode_t)(uintptr_t)self;
+  switch (command) {
+    case IREE_ALLOCATOR_COMMAND_MALLOC:
+    case IREE_ALLOCATOR_COMMAND_CALLOC:
+    case IREE_ALLOCATOR_COMMAND_REALLOC:
+      return iree_allocator_large_pages_alloc(
+          mode, command, (const iree_allocator_alloc_params_t*)params,
+          inout_ptr);
+    case IREE_ALLOCATOR_COMMAND_FREE:
+      return iree_allocator_large_pages_free(inout_ptr);
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported large page allocator command");
+  }
+}
+
+iree_allocator_t iree_allocator_large_pages(
+    iree_memory_large_page_mode_t mode) {
+  if (!iree_memory_large_page_size(mode)) return iree_allocator_system();
+  iree_allocator_t allocator = {
+      .self = (void*)(uintptr_t)mode,
+      .ctl = iree_allocator_large_pages_ctl,
+  };
+  return allocator;
+}
+
+// mbind(2) constants; <numaif.h> is part of libnuma and may not be installed.
+#define IREE_MEMORY_MPOL_PREFERRED 1
+#define IREE_MEMORY_MPOL_INTERLEAVE 3
+#define IREE_MEMORY_MPOL_MF_MOVE (1 << 1)
+
+void iree_memory_bind_numa_nodes(void* ptr, iree_host_size_t length,
+                                 uint64_t node_mask) {
+#if defined(SYS_mbind)
+  if (!node_mask) return;
+  const iree_host_size_t page_size = sysconf(_SC_PAGESIZE);
+  const uintptr_t start = iree_host_align((uintptr_t)ptr, page_size);
+  const uintptr_t end = ((uintptr_t)ptr + length) & ~(page_size - 1);
+  if (end <= start) return;
+  const int mode = (node_mask & (node_mask - 1)) == 0
+                       ? IREE_MEMORY_MPOL_PREFERRED
+                       : IREE_MEMORY_MPOL_INTERLEAVE;
+  unsigned long mask = (unsigned long)node_mask;
+  // NOTE: the kernel only reads maxnode - 1 bits of the mask.
+  // NOTE: failure is ignored; the system may not have the requested nodes or
+  // NUMA support may be disabled.
+  syscall(SYS_mbind, (void*)start, (unsigned long)(end - start), mode, &mask,
+          sizeof(mask) * 8 + 1, IREE_MEMORY_MPOL_MF_MOVE);
+#endif  // SYS_mbind
+}
+
+#else
+
+iree_host_size_t iree_memory_large_page_size(
+    iree_memory_large_page_mode_t mode) {
+  return 0;
+}
+
+iree_allocator_t iree_allocator_large_pages(
+    iree_memory_large_page_mode_t mode) {
+  // NOTE: Windows large pages (VirtualAlloc with MEM_LARGE_PAGES) require
+  // SeLockMemoryPrivilege and must be committed on reservation; they are not
+  // used today.
+  return iree_allocator_system();
+}
+
+void iree_memory_bind_numa_nodes(void* ptr, iree_host_size_t length,
+                                 uint64_t node_mask) {
+  // NOTE: Windows NUMA placement requires allocating with VirtualAllocExNuma
+  // and can't be applied to existing allocations.
+}
+
+#endif  // IREE_PLATFORM_*
@@ -68,6 +68,59 @@ void iree_memory_jit_context_end(void);
 // executing code from any pages that have been written during load.
 void iree_memory_flush_icache(void* base_address, iree_host_size_t length);
 
+//===----------------------------------------------------------------------===//
+// Large page allocation
+//===----------------------------------------------------------------------===//
+
+// Controls whether and how large pages are used to back allocations.
+// Large pages reduce TLB pressure when touching large working sets but may
+// increase memory consumption as allocations are rounded up to the large page
+// size.
+typedef enum iree_memory_large_page_mode_e {
+  // Large pages are not used.
+  IREE_MEMORY_LARGE_PAGE_MODE_NONE = 0,
+  // Transparent large pages are requested from the kernel (such as Linux THP
+  // via madvise). The kernel may ignore the request.
+  IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT,
+  // Explicit 2MB pages from the reserved system pool (such as Linux hugetlbfs).
+  // Falls back to transparent large pages if the pool has been exhausted.
+  IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB,
+  // Explicit 1GB pages from the reserved system pool (such as Linux hugetlbfs).
+  // Falls back to transparent large pages if the pool has been exhausted.
+  IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_1GB,
+} iree_memory_large_page_mode_t;
+
+// Parses a large page |mode| from a string: `none`, `transparent`, `2mb`, or
+// `1gb`.
+iree_status_t iree_memory_large_page_mode_parse(
+    iree_string_view_t value, iree_memory_large_page_mode_t* out_mode);
+
+// Returns the size of the large pages used by |mode| or 0 if large pages are
+// not used or not available on the platform.
+iree_host_size_t iree_memory_large_page_size(
+    iree_memory_large_page_mode_t mode);
+
+// Returns an allocator that backs allocations with large pages as requested by
+// |mode|. Only allocations of at least the large page size are backed by large
+// pages; smaller allocations (or all allocations on platforms without large
+// page support) are routed to iree_allocator_system.
+iree_allocator_t iree_allocator_large_pages(iree_memory_large_page_mode_t mode);
+
+//===----------------------------------------------------------------------===//
+// NUMA memory placement
+//===----------------------------------------------------------------------===//
+
+// Binds the pages fully contained within |ptr| and |length| to the NUMA nodes
+// set in |node_mask| (bit N indicating node N). When one node is set the pages
+// are preferentially placed on it and when multiple are set the pages are
+// interleaved across them. Pages that have already been touched are migrated
+// if possible.
+//
+// Placement is a hint: failures are ignored and this is a no-op on platforms
+// without NUMA support. Only the first 64 nodes can be bound to.
+void iree_memory_bind_numa_nodes(void* ptr, iree_host_size_t length,
+                                 uint64_t node_mask);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
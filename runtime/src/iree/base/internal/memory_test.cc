@@ -0,0 +1,71 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/internal/memory.h"
+
+#include <cstdint>
+#include <cstring>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+TEST(LargePageModeTest, Parse) {
+  iree_memory_large_page_mode_t mode = IREE_MEMORY_LARGE_PAGE_MODE_NONE;
+  IREE_EXPECT_OK(iree_memory_large_page_mode_parse(IREE_SV("transparent"),
+                                                   &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT);
+  IREE_EXPECT_OK(iree_memory_large_page_mode_parse(IREE_SV("2mb"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB);
+  IREE_EXPECT_OK(iree_memory_large_page_mode_parse(IREE_SV("1gb"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_1GB);
+  IREE_EXPECT_OK(iree_memory_large_page_mode_parse(IREE_SV("none"), &mode));
+  EXPECT_EQ(mode, IREE_MEMORY_LARGE_PAGE_MODE_NONE);
+  iree_status_t status =
+      iree_memory_large_page_mode_parse(IREE_SV("huge"), &mode);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT, status);
+  iree_status_free(status);
+}
+
+// Allocations below the large page size should route to the system allocator
+// and work regardless of platform support.
+TEST(LargePageAllocatorTest, SmallAllocations) {
+  iree_allocator_t allocator =
+      iree_allocator_large_pages(IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT);
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 128, (void**)&ptr));
+  memset(ptr, 0xCD, 128);
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, 256, (void**)&ptr));
+  EXPECT_EQ(ptr[127], 0xCD);
+  iree_allocator_free(allocator, ptr);
+}
+
+// Large allocations (and reallocations across the large page threshold) must
+// preserve their contents. Whether or not the kernel actually provides large
+// pages is not observable here.
+TEST(LargePageAllocatorTest, LargeAllocations) {
+  iree_allocator_t allocator =
+      iree_allocator_large_pages(IREE_MEMORY_LARGE_PAGE_MODE_EXPLICIT_2MB);
+  const iree_host_size_t byte_length = 4 * 1024 * 1024;
+  uint8_t* ptr = NULL;
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, 1024, (void**)&ptr));
+  memset(ptr, 0xAB, 1024);
+  IREE_ASSERT_OK(iree_allocator_realloc(allocator, byte_length, (void**)&ptr));
+  EXPECT_EQ(ptr[0], 0xAB);
+  EXPECT_EQ(ptr[1023], 0xAB);
+  memset(ptr, 0xEF, byte_length);
+  IREE_ASSERT_OK(
+      iree_allocator_realloc(allocator, byte_length * 2, (void**)&ptr));
+  EXPECT_EQ(ptr[byte_length - 1], 0xEF);
+  iree_allocator_free(allocator, ptr);
+
+  IREE_ASSERT_OK(iree_allocator_malloc(allocator, byte_length, (void**)&ptr));
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) % iree_max_align_t, 0);
+  iree_allocator_free(allocator, ptr);
+}
+
+}  // namespace
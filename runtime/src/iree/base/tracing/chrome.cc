@@ -0,0 +1,743 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <algorithm>
+#include <atomic>
+#include <cinttypes>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+#include "iree/base/time.h"
+#include "iree/base/tracing.h"
+
+#if IREE_TRACING_FEATURES
+
+static_assert((IREE_TRACING_CHROME_BUFFER_CAPACITY &
+               (IREE_TRACING_CHROME_BUFFER_CAPACITY - 1)) == 0,
+              "IREE_TRACING_CHROME_BUFFER_CAPACITY must be a power of two");
+
+namespace {
+
+constexpr uint64_t kBufferCapacity = IREE_TRACING_CHROME_BUFFER_CAPACITY;
+constexpr uint64_t kBufferMask = kBufferCapacity - 1;
+
+// Dynamic strings are copied into events and truncated to this length.
+constexpr size_t kInlineStringCapacity = 36;
+
+// GPU context tracks are placed after all host thread IDs.
+constexpr uint32_t kGpuTrackBase = 1u << 20;
+
+// Maximum GPU zone nesting depth per context.
+constexpr size_t kMaxGpuZoneDepth = 64;
+
+enum class EventType : uint8_t {
+  kZoneBegin,
+  kZoneEnd,
+  kZoneValue,
+  kZoneText,
+  kMessage,
+  kPlotI64,
+  kPlotF64,
+  kFrame,
+  kGpuZone,
+};
+
+// A single recorded event. Sized to a cache line.
+struct Event {
+  int64_t timestamp_ns;
+  union {
+    // Zones with a static source location.
+    const iree_tracing_location_t* location;
+    // Plots and frames.
+    const char* literal;
+  };
+  union {
+    int64_t i64;
+    double f64;
+    // GPU zones.
+    int64_t duration_ns;
+  } value;
+  EventType type;
+  // Length of |inline_string|, 0 if the event has no dynamic string.
+  uint8_t inline_string_length;
+  // GPU context the event belongs to, if a kGpuZone.
+  uint8_t gpu_context_id;
+  uint8_t reserved;
+  char inline_string[kInlineStringCapacity];
+};
+static_assert(sizeof(Event) == 64, "events should fill a cache line");
+
+// Per-thread event ringbuffer. Only the owning thread writes events; the
+// thread flushing the trace reads them concurrently. Buffers are never freed
+// so that events of exited threads still show up in later traces.
+struct ThreadBuffer {
+  ThreadBuffer* next = nullptr;
+  uint32_t track_id = 0;
+  // Number of zones currently open on the thread.
+  uint32_t depth = 0;
+  // Total number of events ever written; the ringbuffer holds the last
+  // kBufferCapacity of them.
+  std::atomic<uint64_t> write_index{0};
+  std::atomic<uint8_t> name_length{0};
+  char name[kInlineStringCapacity];
+  Event events[kBufferCapacity];
+};
+
+// Host-side state of a GPU query used to pair zone begins with their ends.
+struct GpuQuery {
+  // Static source location or NULL if |inline_string| should be used.
+  const iree_tracing_location_t* location;
+  // Host time the query completed at or INT64_MIN if not yet notified.
+  int64_t timestamp_ns;
+  // For the query ending a zone, the query that began it.
+  uint16_t begin_query_id;
+  uint8_t is_end;
+  uint8_t inline_string_length;
+  char inline_string[kInlineStringCapacity];
+};
+
+struct GpuContext {
+  std::mutex mutex;
+  char name[kInlineStringCapacity];
+  uint8_t name_length = 0;
+  // Calibration mapping GPU timestamps onto the host clock.
+  int64_t cpu_base_ns = 0;
+  int64_t gpu_base = 0;
+  double timestamp_period = 1.0;
+  // Stack of zones opened by iree_tracing_gpu_zone_begin and not yet ended.
+  uint16_t open_queries[kMaxGpuZoneDepth];
+  size_t open_depth = 0;
+  // Indexed by query ID. Drivers allocate query IDs in a ring no larger than
+  // the ID space so entries are only reused after their zone resolved.
+  GpuQuery queries[UINT16_MAX + 1];
+};
+
+struct Provider {
+  // Lock-free list of all registered thread buffers.
+  std::atomic<ThreadBuffer*> threads{nullptr};
+  std::atomic<uint32_t> next_track_id{1};
+  // Excludes concurrent flushes from each other.
+  std::mutex flush_mutex;
+  // Allocated GPU contexts indexed by ID.
+  std::atomic<uint32_t> next_gpu_context_id{0};
+  std::atomic<GpuContext*> gpu_contexts[UINT8_MAX];
+};
+
+Provider& GetProvider() {
+  static Provider* provider = new Provider();
+  return *provider;
+}
+
+// All timestamps in the trace are relative to the first use of the provider.
+int64_t GetBaseTimestamp() {
+  static const int64_t base_ns = iree_time_now();
+  return base_ns;
+}
+
+ThreadBuffer* RegisterThread() {
+  void* storage = std::calloc(1, sizeof(ThreadBuffer));
+  if (!storage) return nullptr;
+  ThreadBuffer* buffer = new (storage) ThreadBuffer();
+  Provider& provider = GetProvider();
+  GetBaseTimestamp();
+  buffer->track_id =
+      provider.next_track_id.fetch_add(1, std::memory_order_relaxed);
+  ThreadBuffer* head = provider.threads.load(std::memory_order_relaxed);
+  do {
+    buffer->next = head;
+  } while (!provider.threads.compare_exchange_weak(
+      head, buffer, std::memory_order_release, std::memory_order_relaxed));
+  return buffer;
+}
+
+// Returns the buffer of the calling thread or NULL if it could not be
+// allocated, in which case events of the thread are dropped.
+ThreadBuffer* GetThreadBuffer() {
+  static thread_local ThreadBuffer* buffer = nullptr;
+  if (IREE_UNLIKELY(!buffer)) buffer = RegisterThread();
+  return buffer;
+}
+
+// Returns the next event slot of |buffer|. The event becomes visible to
+// flushes once passed to CommitEvent.
+Event* AppendEvent(ThreadBuffer* buffer, EventType type) {
+  uint64_t index = buffer->write_index.load(std::memory_order_relaxed);
+  Event* event = &buffer->events[index & kBufferMask];
+  event->type = type;
+  event->inline_string_length = 0;
+  return event;
+}
+
+void CommitEvent(ThreadBuffer* buffer) {
+  uint64_t index = buffer->write_index.load(std::memory_order_relaxed);
+  buffer->write_index.store(index + 1, std::memory_order_release);
+}
+
+uint8_t CopyInlineString(char* target, const char* value, size_t length) {
+  length = std::min(length, kInlineStringCapacity);
+  memcpy(target, value, length);
+  return (uint8_t)length;
+}
+
+//===----------------------------------------------------------------------===//
+// JSON writing
+//===----------------------------------------------------------------------===//
+
+class TraceWriter {
+ public:
+  explicit TraceWriter(FILE* file) : file_(file) {}
+
+  void BeginEvent(const char* phase, uint32_t track_id) {
+    fputs(first_event_ ? "\n" : ",\n", file_);
+    first_event_ = false;
+    fprintf(file_, "{\"ph\":\"%s\",\"pid\":1,\"tid\":%u", phase, track_id);
+  }
+  void EndEvent() { fputc('}', file_); }
+
+  void WriteTimestamp(const char* key, int64_t timestamp_ns) {
+    fprintf(file_, ",\"%s\":%.3f", key,
+            (double)(timestamp_ns - GetBaseTimestamp()) / 1000.0);
+  }
+  void WriteDuration(int64_t duration_ns) {
+    fprintf(file_, ",\"dur\":%.3f", (double)duration_ns / 1000.0);
+  }
+
+  void WriteName(const char* value, size_t length) {
+    fputs(",\"name\":", file_);
+    WriteString(value, length);
+  }
+
+  void WriteString(const char* value, size_t length) {
+    fputc('"', file_);
+    for (size_t i = 0; i < length; ++i) {
+      unsigned char c = (unsigned char)value[i];
+      if (c == '"' || c == '\\') {
+        fputc('\\', file_);
+        fputc(c, file_);
+      } else if (c < 0x20) {
+        fprintf(file_, "\\u%04x", c);
+      } else {
+        fputc(c, file_);
+      }
+    }
+    fputc('"', file_);
+  }
+
+  void WriteTrackName(uint32_t track_id, const char* name, size_t length) {
+    BeginEvent("M", track_id);
+    fputs(",\"name\":\"thread_name\",\"args\":{\"name\":", file_);
+    WriteString(name, length);
+    fputc('}', file_);
+    EndEvent();
+  }
+
+  // Writes all events in |events| recorded by the thread on |track_id|.
+  void WriteThreadEvents(uint32_t track_id, const Event* events,
+                         size_t event_count);
+
+ private:
+  void WriteZoneName(const Event& event);
+
+  FILE* file_;
+  bool first_event_ = true;
+};
+
+void TraceWriter::WriteZoneName(const Event& event) {
+  if (event.inline_string_length) {
+    WriteName(event.inline_string, event.inline_string_length);
+  } else if (event.location && event.location->name) {
+    WriteName(event.location->name, event.location->name_length);
+  } else if (event.location) {
+    WriteName(event.location->function_name,
+              event.location->function_name_length);
+  } else {
+    WriteName("", 0);
+  }
+}
+
+void TraceWriter::WriteThreadEvents(uint32_t track_id, const Event* events,
+                                    size_t event_count) {
+  // Values appended to each open zone; written as args on the zone end so
+  // that viewers merge them into the slice.
+  struct ZoneArgs {
+    std::string json;
+    size_t count = 0;
+  };
+  std::vector<ZoneArgs> zone_args;
+  char scratch[64];
+  for (size_t i = 0; i < event_count; ++i) {
+    const Event& event = events[i];
+    switch (event.type) {
+      case EventType::kZoneBegin: {
+        BeginEvent("B", track_id);
+        WriteTimestamp("ts", event.timestamp_ns);
+        WriteZoneName(event);
+        if (event.location) {
+          const char* file_name = event.location->file_name;
+          size_t file_name_length = event.location->file_name_length;
+          for (size_t j = file_name_length; j > 0; --j) {
+            if (file_name[j - 1] == '/' || file_name[j - 1] == '\\') {
+              file_name += j;
+              file_name_length -= j;
+              break;
+            }
+          }
+          fputs(",\"args\":{\"file\":", file_);
+          WriteString(file_name, file_name_length);
+          fprintf(file_, ",\"line\":%u}", event.location->line);
+        }
+        EndEvent();
+        zone_args.emplace_back();
+        break;
+      }
+      case EventType::kZoneEnd: {
+        // The begin may have been overwritten when the ringbuffer wrapped.
+        if (zone_args.empty()) break;
+        BeginEvent("E", track_id);
+        WriteTimestamp("ts", event.timestamp_ns);
+        if (zone_args.back().count) {
+          fprintf(file_, ",\"args\":{%s}", zone_args.back().json.c_str());
+        }
+        EndEvent();
+        zone_args.pop_back();
+        break;
+      }
+      case EventType::kZoneValue:
+      case EventType::kZoneText: {
+        if (zone_args.empty()) break;
+        ZoneArgs& zone = zone_args.back();
+        std::string& args = zone.json;
+        snprintf(scratch, sizeof(scratch), "%s\"%zu\":",
+                 zone.count ? "," : "", zone.count);
+        ++zone.count;
+        args += scratch;
+        if (event.type == EventType::kZoneValue) {
+          snprintf(scratch, sizeof(scratch), "%" PRId64, event.value.i64);
+          args += scratch;
+        } else {
+          args += '"';
+          for (size_t j = 0; j < event.inline_string_length; ++j) {
+            char c = event.inline_string[j];
+            if (c == '"' || c == '\\') args += '\\';
+            args += ((unsigned char)c < 0x20) ? ' ' : c;
+          }
+          args += '"';
+        }
+        break;
+      }
+      case EventType::kMessage: {
+        BeginEvent("i", track_id);
+        WriteTimestamp("ts", event.timestamp_ns);
+        fputs(",\"s\":\"t\"", file_);
+        WriteName(event.inline_string, event.inline_string_length);
+        EndEvent();
+        break;
+      }
+      case EventType::kPlotI64:
+      case EventType::kPlotF64: {
+        BeginEvent("C", track_id);
+        WriteTimestamp("ts", event.timestamp_ns);
+        WriteName(event.literal, strlen(event.literal));
+        if (event.type == EventType::kPlotI64) {
+          fprintf(file_, ",\"args\":{\"value\":%" PRId64 "}", event.value.i64);
+        } else {
+          fprintf(file_, ",\"args\":{\"value\":%.17g}", event.value.f64);
+        }
+        EndEvent();
+        break;
+      }
+      case EventType::kFrame: {
+        BeginEvent("i", track_id);
+        WriteTimestamp("ts", event.timestamp_ns);
+        fputs(",\"s\":\"g\"", file_);
+        const char* name = event.literal ? event.literal : "frame";
+        WriteName(name, strlen(name));
+        EndEvent();
+        break;
+      }
+      case EventType::kGpuZone: {
+        BeginEvent("X", kGpuTrackBase + event.gpu_context_id);
+        WriteTimestamp("ts", event.timestamp_ns);
+        WriteDuration(event.value.duration_ns);
+        WriteZoneName(event);
+        EndEvent();
+        break;
+      }
+    }
+  }
+}
+
+// Copies the events currently held by |buffer| into |out_events| and returns
+// how many were copied. Events the owning thread overwrote while they were
+// being copied are discarded.
+size_t SnapshotThreadEvents(const ThreadBuffer* buffer, Event* out_events) {
+  uint64_t end = buffer->write_index.load(std::memory_order_acquire);
+  uint64_t begin = end > kBufferCapacity ? end - kBufferCapacity : 0;
+  for (uint64_t i = begin; i < end; ++i) {
+    memcpy(&out_events[i - begin], &buffer->events[i & kBufferMask],
+           sizeof(Event));
+  }
+  std::atomic_thread_fence(std::memory_order_acquire);
+  uint64_t end_after = buffer->write_index.load(std::memory_order_relaxed);
+  uint64_t valid_begin =
+      end_after > kBufferCapacity ? end_after - kBufferCapacity : 0;
+  if (valid_begin <= begin) return (size_t)(end - begin);
+  if (valid_begin >= end) return 0;
+  size_t dropped = (size_t)(valid_begin - begin);
+  memmove(out_events, out_events + dropped,
+          (size_t)(end - valid_begin) * sizeof(Event));
+  return (size_t)(end - valid_begin);
+}
+
+}  // namespace
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+void iree_tracing_chrome_initialize(void) {
+  GetProvider();
+  GetBaseTimestamp();
+}
+
+void iree_tracing_chrome_deinitialize(void) {
+  if (!iree_tracing_chrome_flush(NULL)) {
+    fprintf(stderr, "failed to write chrome trace\n");
+  }
+}
+
+bool iree_tracing_chrome_flush(const char* path) {
+  if (!path) path = getenv("IREE_TRACING_CHROME_FILE");
+  if (!path || !path[0]) path = IREE_TRACING_CHROME_FILE;
+
+  Provider& provider = GetProvider();
+  std::lock_guard<std::mutex> lock(provider.flush_mutex);
+
+  Event* events = (Event*)std::malloc(kBufferCapacity * sizeof(Event));
+  if (!events) return false;
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    std::free(events);
+    return false;
+  }
+
+  fputs("{\"displayTimeUnit\":\"ns\",\"traceEvents\":[", file);
+  TraceWriter writer(file);
+  for (ThreadBuffer* buffer =
+           provider.threads.load(std::memory_order_acquire);
+       buffer; buffer = buffer->next) {
+    uint8_t name_length = buffer->name_length.load(std::memory_order_acquire);
+    if (name_length) {
+      writer.WriteTrackName(buffer->track_id, buffer->name, name_length);
+    }
+    size_t event_count = SnapshotThreadEvents(buffer, events);
+    writer.WriteThreadEvents(buffer->track_id, events, event_count);
+  }
+  uint32_t gpu_context_count = std::min<uint32_t>(
+      provider.next_gpu_context_id.load(std::memory_order_acquire),
+      UINT8_MAX);
+  for (uint32_t i = 0; i < gpu_context_count; ++i) {
+    GpuContext* context =
+        provider.gpu_contexts[i].load(std::memory_order_acquire);
+    if (!context) continue;
+    writer.WriteTrackName(kGpuTrackBase + i, context->name,
+                          context->name_length);
+  }
+  fputs("\n]}\n", file);
+
+  bool succeeded = !ferror(file);
+  succeeded = fclose(file) == 0 && succeeded;
+  std::free(events);
+  return succeeded;
+}
+
+void iree_tracing_set_thread_name(const char* name) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  uint8_t length = CopyInlineString(buffer->name, name, strlen(name));
+  buffer->name_length.store(length, std::memory_order_release);
+}
+
+IREE_MUST_USE_RESULT iree_zone_id_t
+iree_tracing_zone_begin_impl(const iree_tracing_location_t* src_loc,
+                             const char* name, size_t name_length) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return 0;
+  Event* event = AppendEvent(buffer, EventType::kZoneBegin);
+  event->location = src_loc;
+  if (name) {
+    event->inline_string_length =
+        CopyInlineString(event->inline_string, name, name_length);
+  }
+  event->timestamp_ns = iree_time_now();
+  CommitEvent(buffer);
+  return ++buffer->depth;
+}
+
+IREE_MUST_USE_RESULT iree_zone_id_t iree_tracing_zone_begin_external_impl(
+    const char* file_name, size_t file_name_length, uint32_t line,
+    const char* function_name, size_t function_name_length, const char* name,
+    size_t name_length) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return 0;
+  // External locations are transient so only the name is retained.
+  Event* event = AppendEvent(buffer, EventType::kZoneBegin);
+  event->location = NULL;
+  if (name && name_length) {
+    event->inline_string_length =
+        CopyInlineString(event->inline_string, name, name_length);
+  } else {
+    event->inline_string_length = CopyInlineString(
+        event->inline_string, function_name, function_name_length);
+  }
+  event->timestamp_ns = iree_time_now();
+  CommitEvent(buffer);
+  return ++buffer->depth;
+}
+
+void iree_tracing_zone_end(iree_zone_id_t zone_id) {
+  if (!zone_id) return;
+  // Capture the timestamp first so that we don't measure too much of ourselves.
+  int64_t timestamp_ns = iree_time_now();
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kZoneEnd);
+  event->location = NULL;
+  event->timestamp_ns = timestamp_ns;
+  CommitEvent(buffer);
+  --buffer->depth;
+}
+
+void iree_tracing_zone_append_value_i64(iree_zone_id_t zone_id,
+                                        int64_t value) {
+  if (!zone_id) return;
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kZoneValue);
+  event->location = NULL;
+  event->value.i64 = value;
+  event->timestamp_ns = 0;
+  CommitEvent(buffer);
+}
+
+void iree_tracing_zone_append_text(iree_zone_id_t zone_id, const char* value,
+                                   size_t value_length) {
+  if (!zone_id) return;
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kZoneText);
+  event->location = NULL;
+  event->inline_string_length =
+      CopyInlineString(event->inline_string, value, value_length);
+  event->timestamp_ns = 0;
+  CommitEvent(buffer);
+}
+
+void iree_tracing_plot_value_i64_impl(const char* name_literal,
+                                      int64_t value) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kPlotI64);
+  event->literal = name_literal;
+  event->value.i64 = value;
+  event->timestamp_ns = iree_time_now();
+  CommitEvent(buffer);
+}
+
+void iree_tracing_plot_value_f64_impl(const char* name_literal, double value) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kPlotF64);
+  event->literal = name_literal;
+  event->value.f64 = value;
+  event->timestamp_ns = iree_time_now();
+  CommitEvent(buffer);
+}
+
+void iree_tracing_frame_mark_impl(const char* name_literal) {
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kFrame);
+  event->literal = name_literal;
+  event->timestamp_ns = iree_time_now();
+  CommitEvent(buffer);
+}
+
+void iree_tracing_message_string_view(const char* value, size_t value_length,
+                                      uint32_t color) {
+  (void)color;
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kMessage);
+  event->location = NULL;
+  event->inline_string_length =
+      CopyInlineString(event->inline_string, value, value_length);
+  event->timestamp_ns = iree_time_now();
+  CommitEvent(buffer);
+}
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+
+int64_t iree_tracing_time(void) { return iree_time_now(); }
+
+int64_t iree_tracing_frequency(void) { return 1000000000ll; }
+
+uint8_t iree_tracing_gpu_context_allocate(iree_tracing_gpu_context_type_t type,
+                                          const char* name, size_t name_length,
+                                          bool is_calibrated,
+                                          uint64_t cpu_timestamp,
+                                          uint64_t gpu_timestamp,
+                                          float timestamp_period) {
+  (void)type;
+  (void)is_calibrated;
+  Provider& provider = GetProvider();
+  // Contexts are never released so that their zones can be written out after
+  // the device is destroyed. Creating more than 255 contexts wraps around and
+  // reuses the state of old contexts.
+  uint32_t context_id =
+      provider.next_gpu_context_id.fetch_add(1, std::memory_order_relaxed) %
+      UINT8_MAX;
+  GpuContext* context =
+      provider.gpu_contexts[context_id].load(std::memory_order_acquire);
+  if (!context) {
+    context = new (std::nothrow) GpuContext();
+    if (!context) return (uint8_t)context_id;
+    for (GpuQuery& query : context->queries) {
+      query.timestamp_ns = INT64_MIN;
+    }
+  }
+  {
+    std::lock_guard<std::mutex> lock(context->mutex);
+    context->name_length =
+        CopyInlineString(context->name, name, name_length);
+    context->cpu_base_ns = (int64_t)cpu_timestamp;
+    context->gpu_base = (int64_t)gpu_timestamp;
+    context->timestamp_period = timestamp_period;
+    context->open_depth = 0;
+  }
+  provider.gpu_contexts[context_id].store(context, std::memory_order_release);
+  return (uint8_t)context_id;
+}
+
+static GpuContext* iree_tracing_gpu_context_lookup(uint8_t context_id) {
+  if (context_id >= UINT8_MAX) return nullptr;
+  return GetProvider().gpu_contexts[context_id].load(
+      std::memory_order_acquire);
+}
+
+void iree_tracing_gpu_context_calibrate(uint8_t context_id, int64_t cpu_delta,
+                                        int64_t cpu_timestamp,
+                                        int64_t gpu_timestamp) {
+  (void)cpu_delta;
+  GpuContext* context = iree_tracing_gpu_context_lookup(context_id);
+  if (!context) return;
+  std::lock_guard<std::mutex> lock(context->mutex);
+  context->cpu_base_ns = cpu_timestamp;
+  context->gpu_base = gpu_timestamp;
+}
+
+static GpuQuery* iree_tracing_gpu_zone_begin_query(GpuContext* context,
+                                                   uint16_t query_id) {
+  GpuQuery* query = &context->queries[query_id];
+  query->timestamp_ns = INT64_MIN;
+  query->is_end = 0;
+  query->inline_string_length = 0;
+  if (context->open_depth < kMaxGpuZoneDepth) {
+    context->open_queries[context->open_depth] = query_id;
+  }
+  ++context->open_depth;
+  return query;
+}
+
+void iree_tracing_gpu_zone_begin(uint8_t context_id, uint16_t query_id,
+                                 const iree_tracing_location_t* src_loc) {
+  GpuContext* context = iree_tracing_gpu_context_lookup(context_id);
+  if (!context) return;
+  std::lock_guard<std::mutex> lock(context->mutex);
+  GpuQuery* query = iree_tracing_gpu_zone_begin_query(context, query_id);
+  query->location = src_loc;
+}
+
+void iree_tracing_gpu_zone_begin_external(
+    uint8_t context_id, uint16_t query_id, const char* file_name,
+    size_t file_name_length, uint32_t line, const char* function_name,
+    size_t function_name_length, const char* name, size_t name_length) {
+  (void)file_name;
+  (void)file_name_length;
+  (void)line;
+  GpuContext* context = iree_tracing_gpu_context_lookup(context_id);
+  if (!context) return;
+  std::lock_guard<std::mutex> lock(context->mutex);
+  GpuQuery* query = iree_tracing_gpu_zone_begin_query(context, query_id);
+  query->location = NULL;
+  if (name && name_length) {
+    query->inline_string_length =
+        CopyInlineString(query->inline_string, name, name_length);
+  } else {
+    query->inline_string_length = CopyInlineString(
+        query->inline_string, function_name, function_name_length);
+  }
+}
+
+void iree_tracing_gpu_zone_end(uint8_t context_id, uint16_t query_id) {
+  GpuContext* context = iree_tracing_gpu_context_lookup(context_id);
+  if (!context) return;
+  std::lock_guard<std::mutex> lock(context->mutex);
+  if (context->open_depth == 0) return;
+  --context->open_depth;
+  GpuQuery* query = &context->queries[query_id];
+  query->timestamp_ns = INT64_MIN;
+  query->is_end = 1;
+  query->location = NULL;
+  query->inline_string_length = 0;
+  // Zones nested deeper than we track are dropped by never pairing their end.
+  query->begin_query_id =
+      context->open_depth < kMaxGpuZoneDepth
+          ? context->open_queries[context->open_depth]
+          : query_id;
+}
+
+void iree_tracing_gpu_zone_notify(uint8_t context_id, uint16_t query_id,
+                                  int64_t gpu_timestamp) {
+  GpuContext* context = iree_tracing_gpu_context_lookup(context_id);
+  if (!context) return;
+  std::lock_guard<std::mutex> lock(context->mutex);
+  GpuQuery* query = &context->queries[query_id];
+  query->timestamp_ns =
+      context->cpu_base_ns +
+      (int64_t)((double)(gpu_timestamp - context->gpu_base) *
+                context->timestamp_period);
+  if (!query->is_end || query->begin_query_id == query_id) return;
+  const GpuQuery* begin_query = &context->queries[query->begin_query_id];
+  if (begin_query->timestamp_ns == INT64_MIN || begin_query->is_end) return;
+
+  // Both ends of the zone are known; record it on the notifying thread.
+  ThreadBuffer* buffer = GetThreadBuffer();
+  if (!buffer) return;
+  Event* event = AppendEvent(buffer, EventType::kGpuZone);
+  event->location = begin_query->location;
+  event->inline_string_length = CopyInlineString(
+      event->inline_string, begin_query->inline_string,
+      begin_query->inline_string_length);
+  event->gpu_context_id = context_id;
+  event->timestamp_ns = begin_query->timestamp_ns;
+  event->value.duration_ns =
+      std::max<int64_t>(0, query->timestamp_ns - begin_query->timestamp_ns);
+  CommitEvent(buffer);
+}
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TRACING_FEATURES
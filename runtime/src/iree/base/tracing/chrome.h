@@ -0,0 +1,346 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tracing provider writing the Chrome trace event JSON format.
+//
+// Events are recorded into fixed-size per-thread ringbuffers without taking
+// any locks and are only formatted when the trace is written out. Because the
+// buffers wrap the provider acts as a flight recorder: a trace contains the
+// most recent IREE_TRACING_CHROME_BUFFER_CAPACITY events of each thread. This
+// makes it usable on hosts where a Tracy server can't be run and traces are
+// only wanted after something interesting happened.
+//
+// The trace is written on IREE_TRACE_APP_EXIT and whenever the application
+// calls iree_tracing_chrome_flush. The output can be loaded in
+// https://ui.perfetto.dev or chrome://tracing. GPU zones from the HAL tracing
+// contexts (CUDA, Vulkan, etc) are shown on one track per device queue.
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/attributes.h"
+#include "iree/base/config.h"
+
+#ifndef IREE_BASE_TRACING_CHROME_H_
+#define IREE_BASE_TRACING_CHROME_H_
+
+//===----------------------------------------------------------------------===//
+// Chrome tracing configuration
+//===----------------------------------------------------------------------===//
+
+// Filter to only supported features.
+#if !defined(IREE_TRACING_FEATURES)
+#define IREE_TRACING_FEATURES                          \
+  ((IREE_TRACING_FEATURES_REQUESTED) &                 \
+   (IREE_TRACING_FEATURE_INSTRUMENTATION |             \
+    IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE |      \
+    IREE_TRACING_FEATURE_LOG_MESSAGES))
+#endif  // !IREE_TRACING_FEATURES
+
+// Number of events retained per thread. Must be a power of two. Each event
+// takes 64 bytes and buffers are allocated on the first event of a thread.
+#if !defined(IREE_TRACING_CHROME_BUFFER_CAPACITY)
+#define IREE_TRACING_CHROME_BUFFER_CAPACITY (16 * 1024)
+#endif  // !IREE_TRACING_CHROME_BUFFER_CAPACITY
+
+// Path the trace is written to when no path is passed to
+// iree_tracing_chrome_flush. The IREE_TRACING_CHROME_FILE environment variable
+// overrides this at runtime.
+#if !defined(IREE_TRACING_CHROME_FILE)
+#define IREE_TRACING_CHROME_FILE "iree-trace.json"
+#endif  // !IREE_TRACING_CHROME_FILE
+
+//===----------------------------------------------------------------------===//
+// C API used for tracing control
+//===----------------------------------------------------------------------===//
+// These functions are implementation details and should not be called directly.
+// Always use the macros (or C++ RAII types). iree_tracing_chrome_flush is the
+// exception and may be called by applications wanting a trace on demand.
+
+// Local zone ID used for the C IREE_TRACE_ZONE_* macros.
+typedef uint32_t iree_zone_id_t;
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+#if IREE_TRACING_FEATURES
+
+#define IREE_TRACE_IMPL_CONCAT(x, y) IREE_TRACE_IMPL_CONCAT2(x, y)
+#define IREE_TRACE_IMPL_CONCAT2(x, y) x##y
+
+#define IREE_TRACE_STRLEN(literal) (sizeof(literal) - 1)
+
+typedef struct iree_tracing_location_t {
+  const char* name;
+  size_t name_length;
+  const char* function_name;
+  size_t function_name_length;
+  const char* file_name;
+  size_t file_name_length;
+  uint32_t line;
+  uint32_t color;
+} iree_tracing_location_t;
+
+#define iree_tracing_make_zone_ctx(zone_id) (zone_id)
+
+void iree_tracing_chrome_initialize(void);
+void iree_tracing_chrome_deinitialize(void);
+
+// Writes the events currently buffered by all threads to |path| (or the
+// default path if NULL). Events are not consumed and threads may continue
+// recording while the trace is written; events overwritten during the write
+// are dropped. Returns false if the file could not be written.
+bool iree_tracing_chrome_flush(const char* path);
+
+void iree_tracing_set_thread_name(const char* name);
+
+IREE_MUST_USE_RESULT iree_zone_id_t
+iree_tracing_zone_begin_impl(const iree_tracing_location_t* src_loc,
+                             const char* name, size_t name_length);
+IREE_MUST_USE_RESULT iree_zone_id_t iree_tracing_zone_begin_external_impl(
+    const char* file_name, size_t file_name_length, uint32_t line,
+    const char* function_name, size_t function_name_length, const char* name,
+    size_t name_length);
+void iree_tracing_zone_end(iree_zone_id_t zone_id);
+
+void iree_tracing_zone_append_value_i64(iree_zone_id_t zone_id, int64_t value);
+void iree_tracing_zone_append_text(iree_zone_id_t zone_id, const char* value,
+                                   size_t value_length);
+
+void iree_tracing_plot_value_i64_impl(const char* name_literal, int64_t value);
+void iree_tracing_plot_value_f64_impl(const char* name_literal, double value);
+
+void iree_tracing_frame_mark_impl(const char* name_literal);
+
+void iree_tracing_message_string_view(const char* value, size_t value_length,
+                                      uint32_t color);
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+
+// Host timestamps in nanoseconds on the same clock as iree_time_now.
+int64_t iree_tracing_time(void);
+int64_t iree_tracing_frequency(void);
+
+// Matches the tracy provider; the type is only informational here.
+typedef enum iree_tracing_gpu_context_type_e {
+  IREE_TRACING_GPU_CONTEXT_TYPE_INVALID = 0,
+  IREE_TRACING_GPU_CONTEXT_TYPE_OPENGL,
+  IREE_TRACING_GPU_CONTEXT_TYPE_VULKAN,
+  IREE_TRACING_GPU_CONTEXT_TYPE_OPENCL,
+  IREE_TRACING_GPU_CONTEXT_TYPE_DIRECT3D12,
+  IREE_TRACING_GPU_CONTEXT_TYPE_DIRECT3D11,
+} iree_tracing_gpu_context_type_t;
+
+uint8_t iree_tracing_gpu_context_allocate(iree_tracing_gpu_context_type_t type,
+                                          const char* name, size_t name_length,
+                                          bool is_calibrated,
+                                          uint64_t cpu_timestamp,
+                                          uint64_t gpu_timestamp,
+                                          float timestamp_period);
+void iree_tracing_gpu_context_calibrate(uint8_t context_id, int64_t cpu_delta,
+                                        int64_t cpu_timestamp,
+                                        int64_t gpu_timestamp);
+void iree_tracing_gpu_zone_begin(uint8_t context_id, uint16_t query_id,
+                                 const iree_tracing_location_t* src_loc);
+void iree_tracing_gpu_zone_begin_external(
+    uint8_t context_id, uint16_t query_id, const char* file_name,
+    size_t file_name_length, uint32_t line, const char* function_name,
+    size_t function_name_length, const char* name, size_t name_length);
+void iree_tracing_gpu_zone_end(uint8_t context_id, uint16_t query_id);
+void iree_tracing_gpu_zone_notify(uint8_t context_id, uint16_t query_id,
+                                  int64_t gpu_timestamp);
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+
+#endif  // IREE_TRACING_FEATURES
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Instrumentation macros (C)
+//===----------------------------------------------------------------------===//
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#define IREE_TRACE(expr) expr
+
+#define IREE_TRACE_APP_ENTER() iree_tracing_chrome_initialize()
+#define IREE_TRACE_APP_EXIT(exit_code) iree_tracing_chrome_deinitialize()
+#define IREE_TRACE_SET_APP_INFO(value, value_length)
+#define IREE_TRACE_SET_THREAD_NAME(name) iree_tracing_set_thread_name(name)
+
+#define IREE_TRACE_PUBLISH_SOURCE_FILE(filename, filename_length, content, \
+                                       content_length)                     \
+  (void)filename;                                                          \
+  (void)filename_length;                                                   \
+  (void)content;                                                           \
+  (void)content_length;
+
+// TODO(benvanik): chrome tracing fiber support via flow events.
+#define IREE_TRACE_FIBER_ENTER(fiber)
+#define IREE_TRACE_FIBER_LEAVE()
+
+#define IREE_TRACE_ZONE_BEGIN(zone_id) \
+  IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, NULL)
+
+#define IREE_TRACE_ZONE_BEGIN_NAMED(zone_id, name_literal)                     \
+  static const iree_tracing_location_t IREE_TRACE_IMPL_CONCAT(                 \
+      __iree_tracing_source_location, __LINE__) = {                            \
+      name_literal,       IREE_TRACE_STRLEN(name_literal),                     \
+      __FUNCTION__,       IREE_TRACE_STRLEN(__FUNCTION__),                     \
+      __FILE__,           IREE_TRACE_STRLEN(__FILE__),                         \
+      (uint32_t)__LINE__, 0};                                                  \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_impl(                       \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__), NULL, \
+      0)
+
+#define IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(zone_id, name, name_length)  \
+  static const iree_tracing_location_t IREE_TRACE_IMPL_CONCAT(           \
+      __iree_tracing_source_location, __LINE__) = {                      \
+      NULL,                                                              \
+      0,                                                                 \
+      __FUNCTION__,                                                      \
+      IREE_TRACE_STRLEN(__FUNCTION__),                                   \
+      __FILE__,                                                          \
+      IREE_TRACE_STRLEN(__FILE__),                                       \
+      (uint32_t)__LINE__,                                                \
+      0};                                                                \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_impl(                 \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__), \
+      (name), (name_length))
+
+#define IREE_TRACE_ZONE_BEGIN_EXTERNAL(                                       \
+    zone_id, file_name, file_name_length, line, function_name,                \
+    function_name_length, name, name_length)                                  \
+  iree_zone_id_t zone_id = iree_tracing_zone_begin_external_impl(             \
+      file_name, file_name_length, line, function_name, function_name_length, \
+      name, name_length)
+
+#define IREE_TRACE_ZONE_END(zone_id) iree_tracing_zone_end(zone_id)
+
+#define IREE_RETURN_AND_END_ZONE_IF_ERROR(zone_id, ...) \
+  IREE_RETURN_AND_EVAL_IF_ERROR(IREE_TRACE_ZONE_END(zone_id), __VA_ARGS__)
+
+// Colors are chosen by the trace viewer.
+#define IREE_TRACE_ZONE_SET_COLOR(zone_id, color_xbgr)
+
+#define IREE_TRACE_ZONE_APPEND_VALUE_I64(zone_id, value) \
+  iree_tracing_zone_append_value_i64(zone_id, (int64_t)(value))
+#define IREE_TRACE_ZONE_APPEND_TEXT(...)                                  \
+  IREE_TRACE_IMPL_GET_VARIADIC_((__VA_ARGS__,                             \
+                                 IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW, \
+                                 IREE_TRACE_ZONE_APPEND_TEXT_CSTRING))    \
+  (__VA_ARGS__)
+#define IREE_TRACE_ZONE_APPEND_TEXT_CSTRING(zone_id, value) \
+  iree_tracing_zone_append_text(zone_id, value, strlen(value))
+#define IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(zone_id, value, value_length) \
+  iree_tracing_zone_append_text(zone_id, value, value_length)
+
+// Plots are written as counter tracks; the viewer picks the presentation.
+#define IREE_TRACE_SET_PLOT_TYPE(name_literal, plot_type, step, fill, color) \
+  (void)(name_literal), (void)(plot_type), (void)(step), (void)(fill),       \
+      (void)(color)
+#define IREE_TRACE_PLOT_VALUE_I64(name_literal, value) \
+  iree_tracing_plot_value_i64_impl(name_literal, value)
+#define IREE_TRACE_PLOT_VALUE_F32(name_literal, value) \
+  iree_tracing_plot_value_f64_impl(name_literal, (double)(value))
+#define IREE_TRACE_PLOT_VALUE_F64(name_literal, value) \
+  iree_tracing_plot_value_f64_impl(name_literal, value)
+
+// Frames are written as global instant events.
+#define IREE_TRACE_FRAME_MARK() iree_tracing_frame_mark_impl(NULL)
+#define IREE_TRACE_FRAME_MARK_NAMED(name_literal) \
+  iree_tracing_frame_mark_impl(name_literal)
+#define IREE_TRACE_FRAME_MARK_BEGIN_NAMED(name_literal) \
+  iree_tracing_frame_mark_impl(name_literal)
+#define IREE_TRACE_FRAME_MARK_END_NAMED(name_literal)
+
+#define IREE_TRACE_MESSAGE(level, value_literal)                    \
+  iree_tracing_message_string_view(value_literal,                   \
+                                   IREE_TRACE_STRLEN(value_literal), \
+                                   IREE_TRACING_MESSAGE_LEVEL_##level)
+#define IREE_TRACE_MESSAGE_COLORED(color, value_literal) \
+  iree_tracing_message_string_view(                      \
+      value_literal, IREE_TRACE_STRLEN(value_literal), color)
+#define IREE_TRACE_MESSAGE_DYNAMIC(level, value, value_length) \
+  iree_tracing_message_string_view(value, value_length,        \
+                                   IREE_TRACING_MESSAGE_LEVEL_##level)
+#define IREE_TRACE_MESSAGE_DYNAMIC_COLORED(color, value, value_length) \
+  iree_tracing_message_string_view(value, value_length, color)
+
+// Utilities:
+#define IREE_TRACE_IMPL_GET_VARIADIC_HELPER_(_1, _2, _3, NAME, ...) NAME
+#define IREE_TRACE_IMPL_GET_VARIADIC_(args) \
+  IREE_TRACE_IMPL_GET_VARIADIC_HELPER_ args
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+//===----------------------------------------------------------------------===//
+// Instrumentation C++ RAII types, wrappers, and macros
+//===----------------------------------------------------------------------===//
+
+#ifdef __cplusplus
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+namespace iree {
+
+class ScopedZone {
+ public:
+  ScopedZone(const ScopedZone&) = delete;
+  ScopedZone(ScopedZone&&) = delete;
+  ScopedZone& operator=(const ScopedZone&) = delete;
+  ScopedZone& operator=(ScopedZone&&) = delete;
+
+  IREE_ATTRIBUTE_ALWAYS_INLINE ScopedZone(
+      const iree_tracing_location_t* src_loc) {
+    zone_id_ = iree_tracing_zone_begin_impl(src_loc, NULL, 0);
+  }
+  IREE_ATTRIBUTE_ALWAYS_INLINE ~ScopedZone() { IREE_TRACE_ZONE_END(zone_id_); }
+
+  operator iree_zone_id_t() const noexcept { return zone_id_; }
+
+ private:
+  iree_zone_id_t zone_id_;
+};
+
+}  // namespace iree
+
+#define IREE_TRACE_SCOPE()                                         \
+  static constexpr iree_tracing_location_t IREE_TRACE_IMPL_CONCAT( \
+      __iree_tracing_source_location, __LINE__){                   \
+      nullptr,                                                     \
+      0,                                                           \
+      __FUNCTION__,                                                \
+      IREE_TRACE_STRLEN(__FUNCTION__),                             \
+      __FILE__,                                                    \
+      IREE_TRACE_STRLEN(__FILE__),                                 \
+      (uint32_t)__LINE__,                                          \
+      0};                                                          \
+  ::iree::ScopedZone ___iree_tracing_scoped_zone(                  \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__))
+#define IREE_TRACE_SCOPE_NAMED(name_literal)                       \
+  static constexpr iree_tracing_location_t IREE_TRACE_IMPL_CONCAT( \
+      __iree_tracing_source_location, __LINE__){                   \
+      name_literal,       IREE_TRACE_STRLEN(name_literal),         \
+      __FUNCTION__,       IREE_TRACE_STRLEN(__FUNCTION__),         \
+      __FILE__,           IREE_TRACE_STRLEN(__FILE__),             \
+      (uint32_t)__LINE__, 0};                                      \
+  ::iree::ScopedZone ___iree_tracing_scoped_zone(                  \
+      &IREE_TRACE_IMPL_CONCAT(__iree_tracing_source_location, __LINE__))
+#define IREE_TRACE_SCOPE_ID ___iree_tracing_scoped_zone
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION
+
+#endif  // __cplusplus
+
+#endif  // IREE_BASE_TRACING_CHROME_H_
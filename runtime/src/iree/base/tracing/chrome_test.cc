@@ -0,0 +1,138 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+// The provider header is included through iree/base/tracing.h, which selects
+// the requested tracing features before the provider filters them.
+#include "iree/base/tracing.h"
+#include "iree/testing/gtest.h"
+
+namespace {
+
+using ::testing::HasSubstr;
+using ::testing::Not;
+
+// Writes the trace to a temporary file and returns its contents.
+std::string FlushTrace() {
+  std::string path = ::testing::TempDir() + "/chrome_test.json";
+  EXPECT_TRUE(iree_tracing_chrome_flush(path.c_str()));
+  std::ifstream file(path, std::ios::binary);
+  std::stringstream contents;
+  contents << file.rdbuf();
+  std::remove(path.c_str());
+  return contents.str();
+}
+
+// Runs |fn| on a new thread so that it records into its own ringbuffer.
+template <typename T>
+void RunOnThread(T fn) {
+  std::thread thread(fn);
+  thread.join();
+}
+
+TEST(ChromeTracingTest, FlushEmpty) {
+  iree_tracing_chrome_initialize();
+  std::string trace = FlushTrace();
+  EXPECT_THAT(trace, HasSubstr("\"traceEvents\":["));
+  EXPECT_THAT(trace, HasSubstr("]}"));
+}
+
+TEST(ChromeTracingTest, FlushInvalidPath) {
+  EXPECT_FALSE(iree_tracing_chrome_flush("/nonexistent-dir/trace.json"));
+}
+
+TEST(ChromeTracingTest, Zones) {
+  RunOnThread([]() {
+    IREE_TRACE_SET_THREAD_NAME("chrome-test-zones");
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "chrome_test_outer");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, 123);
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "hello");
+    const char inner_name[] = "chrome_test_inner";
+    IREE_TRACE_ZONE_BEGIN_NAMED_DYNAMIC(z1, inner_name,
+                                        sizeof(inner_name) - 1);
+    IREE_TRACE_ZONE_END(z1);
+    IREE_TRACE_ZONE_END(z0);
+  });
+  std::string trace = FlushTrace();
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"thread_name\",\"args\":{\"name\":"
+                               "\"chrome-test-zones\"}"));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"chrome_test_outer\",\"args\":{"
+                               "\"file\":\"chrome_test.cc\""));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"chrome_test_inner\""));
+  // Appended values are attached to the end of their zone.
+  EXPECT_THAT(trace, HasSubstr("\"args\":{\"0\":123,\"1\":\"hello\"}}"));
+}
+
+TEST(ChromeTracingTest, MessagesPlotsAndFrames) {
+  RunOnThread([]() {
+    IREE_TRACE_MESSAGE(INFO, "chrome test \"message\"\n");
+    IREE_TRACE_PLOT_VALUE_I64("chrome_test_plot_i64", 42);
+    IREE_TRACE_PLOT_VALUE_F64("chrome_test_plot_f64", 0.5);
+    IREE_TRACE_FRAME_MARK_NAMED("chrome_test_frame");
+  });
+  std::string trace = FlushTrace();
+  EXPECT_THAT(trace, HasSubstr("\"s\":\"t\",\"name\":"
+                               "\"chrome test \\\"message\\\"\\u000a\""));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"chrome_test_plot_i64\","
+                               "\"args\":{\"value\":42}"));
+  EXPECT_THAT(trace, HasSubstr("\"name\":\"chrome_test_plot_f64\","
+                               "\"args\":{\"value\":0.5}"));
+  EXPECT_THAT(trace, HasSubstr("\"s\":\"g\",\"name\":\"chrome_test_frame\""));
+}
+
+TEST(ChromeTracingTest, RingbufferWraps) {
+  RunOnThread([]() {
+    IREE_TRACE_MESSAGE(INFO, "chrome_test_overwritten");
+    // Zones whose begin was overwritten are dropped along with their end.
+    IREE_TRACE_ZONE_BEGIN_NAMED(z0, "chrome_test_wrapped_zone");
+    for (int i = 0; i < IREE_TRACING_CHROME_BUFFER_CAPACITY; ++i) {
+      IREE_TRACE_PLOT_VALUE_I64("chrome_test_wrap", i);
+    }
+    IREE_TRACE_ZONE_END(z0);
+  });
+  std::string trace = FlushTrace();
+  EXPECT_THAT(trace, Not(HasSubstr("chrome_test_overwritten")));
+  EXPECT_THAT(trace, Not(HasSubstr("chrome_test_wrapped_zone")));
+  EXPECT_THAT(trace, Not(HasSubstr("\"name\":\"chrome_test_wrap\","
+                                   "\"args\":{\"value\":0}")));
+  EXPECT_THAT(trace,
+              HasSubstr("\"name\":\"chrome_test_wrap\",\"args\":{\"value\":" +
+                        std::to_string(IREE_TRACING_CHROME_BUFFER_CAPACITY -
+                                       1) +
+                        "}"));
+}
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+
+TEST(ChromeTracingTest, GpuZones) {
+  static const char kContextName[] = "chrome_test_gpu";
+  uint8_t context_id = iree_tracing_gpu_context_allocate(
+      IREE_TRACING_GPU_CONTEXT_TYPE_VULKAN, kContextName,
+      sizeof(kContextName) - 1, /*is_calibrated=*/false,
+      /*cpu_timestamp=*/iree_tracing_time(), /*gpu_timestamp=*/0,
+      /*timestamp_period=*/1.0f);
+  static const char kZoneName[] = "chrome_test_gpu_zone";
+  iree_tracing_gpu_zone_begin_external(context_id, /*query_id=*/0, NULL, 0, 0,
+                                       NULL, 0, kZoneName,
+                                       sizeof(kZoneName) - 1);
+  iree_tracing_gpu_zone_end(context_id, /*query_id=*/1);
+  // Zones are recorded once both of their queries have resolved.
+  iree_tracing_gpu_zone_notify(context_id, /*query_id=*/0, 1000);
+  iree_tracing_gpu_zone_notify(context_id, /*query_id=*/1, 3000);
+  std::string trace = FlushTrace();
+  EXPECT_THAT(trace,
+              HasSubstr("\"dur\":2.000,\"name\":\"chrome_test_gpu_zone\""));
+  EXPECT_THAT(trace, HasSubstr("\"args\":{\"name\":\"chrome_test_gpu\"}"));
+}
+
+#endif  // IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
+
+}  // namespace
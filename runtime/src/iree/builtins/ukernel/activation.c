@@ -0,0 +1,142 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/activation_internal.h"
+#include "iree/builtins/ukernel/elementwise_internal.h"
+
+static void iree_uk_activation_validate(
+    const iree_uk_activation_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags = IREE_UK_FLAG_ACTIVATION_TYPE_MASK |
+                                    IREE_UK_FLAG_ACTIVATION_OP_MASK |
+                                    IREE_UK_FLAG_ACTIVATION_FAST_MATH;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type =
+      params->flags & IREE_UK_FLAG_ACTIVATION_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_ACTIVATION_TYPE_F32 ||
+                 flags_type == IREE_UK_FLAG_ACTIVATION_TYPE_F16 ||
+                 flags_type == IREE_UK_FLAG_ACTIVATION_TYPE_BF16);
+  iree_uk_uint32_t flags_op = params->flags & IREE_UK_FLAG_ACTIVATION_OP_MASK;
+  IREE_UK_ASSERT(flags_op == IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF ||
+                 flags_op == IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH ||
+                 flags_op == IREE_UK_FLAG_ACTIVATION_OP_SILU);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= 0);
+  IREE_UK_ASSERT(params->out_stride0 >= 0);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_activation_early(
+    const iree_uk_activation_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_activation_eval(
+    float x, iree_uk_uint32_t op, bool fast) {
+  if (op == IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF) {
+    return 0.5f * x * (1.0f + iree_uk_erf_f32(x * 0.70710678f, fast));
+  } else if (op == IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH) {
+    float inner = 0.79788456f * (x + 0.044715f * x * x * x);
+    return 0.5f * x * (1.0f + iree_uk_tanh_f32(inner, fast));
+  } else {
+    // exp is clamped, so this goes to -0 rather than NaN for very negative x.
+    return x / (1.0f + iree_uk_exp_f32(-x, fast));
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_activation_impl(
+    const iree_uk_activation_params_t* params, iree_uk_type_t type,
+    iree_uk_uint32_t op, bool fast) {
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    const iree_uk_index_t in_base = params->in_offset + i * params->in_stride0;
+    const iree_uk_index_t out_base =
+        params->out_offset + i * params->out_stride0;
+    for (iree_uk_index_t j = 0; j < params->size1; ++j) {
+      float x = iree_uk_elementwise_load(params->in_buffer, in_base + j, type);
+      iree_uk_elementwise_store(params->out_buffer, out_base + j,
+                                iree_uk_activation_eval(x, op, fast), type);
+    }
+  }
+}
+
+#define IREE_UK_ACTIVATION_IMPL_FOR_TYPE_AND_OP(SUFFIX, TYPE, OP) \
+  static void iree_uk_activation_##SUFFIX(                        \
+      const iree_uk_activation_params_t* params) {                \
+    if (params->flags & IREE_UK_FLAG_ACTIVATION_FAST_MATH) {      \
+      iree_uk_activation_impl(params, TYPE, OP, /*fast=*/true);   \
+    } else {                                                      \
+      iree_uk_activation_impl(params, TYPE, OP, /*fast=*/false);  \
+    }                                                             \
+  }
+
+#define IREE_UK_ACTIVATION_IMPL_FOR_TYPE(SUFFIX, TYPE)                \
+  IREE_UK_ACTIVATION_IMPL_FOR_TYPE_AND_OP(                            \
+      gelu_erf_##SUFFIX, TYPE, IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF)   \
+  IREE_UK_ACTIVATION_IMPL_FOR_TYPE_AND_OP(                            \
+      gelu_tanh_##SUFFIX, TYPE, IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH) \
+  IREE_UK_ACTIVATION_IMPL_FOR_TYPE_AND_OP(                            \
+      silu_##SUFFIX, TYPE, IREE_UK_FLAG_ACTIVATION_OP_SILU)           \
+  static void iree_uk_activation_##SUFFIX(                            \
+      const iree_uk_activation_params_t* params) {                    \
+    switch (params->flags & IREE_UK_FLAG_ACTIVATION_OP_MASK) {        \
+      case IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF:                       \
+        iree_uk_activation_gelu_erf_##SUFFIX(params);                 \
+        break;                                                        \
+      case IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH:                      \
+        iree_uk_activation_gelu_tanh_##SUFFIX(params);                \
+        break;                                                        \
+      default:                                                        \
+        iree_uk_activation_silu_##SUFFIX(params);                     \
+        break;                                                        \
+    }                                                                 \
+  }
+
+IREE_UK_ACTIVATION_IMPL_FOR_TYPE(f32, IREE_UK_TYPE_FLOAT_32)
+IREE_UK_ACTIVATION_IMPL_FOR_TYPE(f16, IREE_UK_TYPE_FLOAT_16)
+IREE_UK_ACTIVATION_IMPL_FOR_TYPE(bf16, IREE_UK_TYPE_BFLOAT_16)
+
+void iree_uk_activation_p(const iree_uk_activation_params_t* params) {
+  iree_uk_activation_validate(params);
+
+  if (iree_uk_activation_early(params)) return;
+
+  switch (iree_uk_activation_type(params->flags)) {
+    case IREE_UK_TYPE_FLOAT_32:
+      iree_uk_activation_f32(params);
+      break;
+    case IREE_UK_TYPE_FLOAT_16:
+      iree_uk_activation_f16(params);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      iree_uk_activation_bf16(params);
+      break;
+    default:
+      // Shouldn't happen, validated earlier.
+      IREE_UK_ASSERT(false);
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_activation(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_activation_params_t params = {
+      .in_buffer = in_buffer,
+      .in_offset = in_offset,
+      .in_stride0 = in_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .size0 = size0,
+      .size1 = size1,
+      .flags = flags,
+      .cpu_data = cpu_data,
+  };
+  iree_uk_activation_p(&params);
+}
@@ -0,0 +1,22 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ACTIVATION_H_
+#define IREE_BUILTINS_UKERNEL_ACTIVATION_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `activation` microkernel, applying the elementwise function selected by
+// IREE_UK_FLAG_ACTIVATION_OP_* (GELU or SiLU) to a [size0][size1] input.
+// Rows must be contiguous; `stride0` is the row stride, in elements. The input
+// and output may be the same buffer.
+IREE_UK_EXPORT void iree_uk_activation(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_ACTIVATION_H_
@@ -0,0 +1,41 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ACTIVATION_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ACTIVATION_INTERNAL_H_
+
+#include "iree/builtins/ukernel/activation.h"
+
+typedef struct iree_uk_activation_params_t {
+  const void* in_buffer;
+  iree_uk_index_t in_offset;
+  iree_uk_index_t in_stride0;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t size0;
+  iree_uk_index_t size1;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_activation_params_t;
+
+void iree_uk_activation_p(const iree_uk_activation_params_t* params);
+
+static inline iree_uk_type_t iree_uk_activation_type(iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_ACTIVATION_TYPE_MASK) {
+    case IREE_UK_FLAG_ACTIVATION_TYPE_F32:
+      return IREE_UK_TYPE_FLOAT_32;
+    case IREE_UK_FLAG_ACTIVATION_TYPE_F16:
+      return IREE_UK_TYPE_FLOAT_16;
+    case IREE_UK_FLAG_ACTIVATION_TYPE_BF16:
+      return IREE_UK_TYPE_BFLOAT_16;
+    default:
+      // Shouldn't happen, validated earlier.
+      return (iree_uk_type_t)0;
+  }
+}
+
+#endif  // IREE_BUILTINS_UKERNEL_ACTIVATION_INTERNAL_H_
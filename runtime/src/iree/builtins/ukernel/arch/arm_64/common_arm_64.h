@@ -19,6 +19,7 @@
 #define IREE_UK_BUILD_ARM_64_BF16
 #define IREE_UK_BUILD_ARM_64_DOTPROD
 #define IREE_UK_BUILD_ARM_64_I8MM
+#define IREE_UK_BUILD_ARM_64_SME
 #else
 // Compiling with the system toolchain. Include the configured header.
 #include "iree/builtins/ukernel/arch/arm_64/config_arm_64.h"
@@ -52,6 +53,21 @@ static inline bool iree_uk_cpu_arm_64_i8mm(const iree_uk_uint64_t* cpu_data) {
   return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_ARM_64_I8MM);
 }
 
+#if defined(IREE_UK_BUILD_ARM_64_SME)
+
+// Returns the streaming SVE vector length in bytes. Must only be called when
+// SME is supported. Defined in mmt4d_arm_64_sme.c as it needs SME codegen.
+iree_uk_index_t iree_uk_arm_64_sme_vector_length_bytes(void);
+
+// The SME kernels require N0=16 32-bit accumulators to fit in a ZA32 tile row,
+// i.e. a streaming vector length of at least 512 bits.
+static inline bool iree_uk_cpu_arm_64_sme(const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_ARM_64_SME) &&
+         iree_uk_arm_64_sme_vector_length_bytes() >= 64;
+}
+
+#endif  // defined(IREE_UK_BUILD_ARM_64_SME)
+
 static inline int8x16x2_t iree_uk_neon_load_8x4xi8_strided(
     const iree_uk_int8_t* src, iree_uk_index_t stride) {
   int32x4_t v0_i32 = vdupq_n_s32(0);
@@ -189,6 +205,24 @@ static inline void iree_uk_neon_copy_8x32xi8_strided_to_strided(
   }
 }
 
+// Copies 32 bytes with a non-temporal store (STNP), hinting that the data is
+// not going to be read again soon so it should not allocate in the caches.
+// There is no intrinsic for STNP, hence the inline asm, with a fallback to
+// regular stores for toolchains without GNU-style inline asm.
+static inline void iree_uk_neon_stnp_32xi8(void* out_ptr, const void* in_ptr) {
+  int8x16_t v0 = vld1q_s8((const iree_uk_int8_t*)in_ptr);
+  int8x16_t v1 = vld1q_s8((const iree_uk_int8_t*)in_ptr + 16);
+#if defined(__GNUC__)
+  __asm__ volatile("stnp %q[v0], %q[v1], [%[out_ptr]]"
+                   :
+                   : [v0] "w"(v0), [v1] "w"(v1), [out_ptr] "r"(out_ptr)
+                   : "memory");
+#else
+  vst1q_s8((iree_uk_int8_t*)out_ptr, v0);
+  vst1q_s8((iree_uk_int8_t*)out_ptr + 16, v1);
+#endif
+}
+
 static inline void iree_uk_neon_copy_8x8xi8_transpose_strided_to_strided(
     iree_uk_int8_t* IREE_UK_RESTRICT out_ptr,
     const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr, iree_uk_index_t out_stride,
@@ -73,9 +73,55 @@ iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64(
   }
 }
 
-IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
-    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64,
-    iree_uk_mmt4d_tile_f32f32f32_1x8x1_arm_64, 1)
+// Dedicated matrix-vector kernel for M0 == 1. With a single LHS row, the
+// kernel above would carry only 2 accumulators through the whole K loop,
+// making it bound by FMA latency instead of by the bandwidth of streaming the
+// RHS panel. Here the K loop is unrolled 4x, for 8 independent accumulators.
+// They are initialized to -0.0f, the additive identity preserving the sign of
+// an accumulated zero.
+void iree_uk_mmt4d_tile_f32f32f32_1x8x1_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  float32x4_t acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    acc[0] = vld1q_f32(out_ptr);
+    acc[1] = vld1q_f32(out_ptr + 4);
+  } else {
+    acc[0] = vdupq_n_f32(0);
+    acc[1] = vdupq_n_f32(0);
+  }
+  IREE_UK_UNROLL for (int i = 2; i < 8; ++i) { acc[i] = vdupq_n_f32(-0.0f); }
+  int k = 0;
+  for (; k + 4 <= params->K; k += 4) {
+    float32x4_t lhs = vld1q_f32(lhs_ptr);
+    lhs_ptr += 4;
+    acc[0] = vfmaq_laneq_f32(acc[0], vld1q_f32(rhs_ptr + 0), lhs, 0);
+    acc[1] = vfmaq_laneq_f32(acc[1], vld1q_f32(rhs_ptr + 4), lhs, 0);
+    acc[2] = vfmaq_laneq_f32(acc[2], vld1q_f32(rhs_ptr + 8), lhs, 1);
+    acc[3] = vfmaq_laneq_f32(acc[3], vld1q_f32(rhs_ptr + 12), lhs, 1);
+    acc[4] = vfmaq_laneq_f32(acc[4], vld1q_f32(rhs_ptr + 16), lhs, 2);
+    acc[5] = vfmaq_laneq_f32(acc[5], vld1q_f32(rhs_ptr + 20), lhs, 2);
+    acc[6] = vfmaq_laneq_f32(acc[6], vld1q_f32(rhs_ptr + 24), lhs, 3);
+    acc[7] = vfmaq_laneq_f32(acc[7], vld1q_f32(rhs_ptr + 28), lhs, 3);
+    rhs_ptr += 32;
+  }
+  for (; k < params->K; ++k) {
+    float lhs = *lhs_ptr++;
+    acc[0] = vfmaq_n_f32(acc[0], vld1q_f32(rhs_ptr), lhs);
+    acc[1] = vfmaq_n_f32(acc[1], vld1q_f32(rhs_ptr + 4), lhs);
+    rhs_ptr += 8;
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+    float32x4_t sum = vaddq_f32(vaddq_f32(acc[i], acc[i + 2]),
+                                vaddq_f32(acc[i + 4], acc[i + 6]));
+    vst1q_f32(out_ptr + 4 * i, sum);
+  }
+}
+
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_arm_64,
     iree_uk_mmt4d_tile_f32f32f32_2x8x1_arm_64, 2)
@@ -431,3 +477,129 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s8s4s32_1x16x2_to_4x16x2_arm_64,
     iree_uk_mmt4d_tile_s8s4s32_4x16x2_arm_64, 4)
+
+// Converts 4 f16 or bf16 values, given as their bit patterns, to f32.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float32x4_t
+iree_uk_arm_64_xf16_to_f32(uint16x4_t value, iree_uk_type_t type) {
+  return type == IREE_UK_TYPE_FLOAT_16
+             ? vcvt_f32_f16(vreinterpret_f16_u16(value))
+             : vreinterpretq_f32_u32(vshll_n_u16(value, 16));
+}
+
+// Shared implementation for f16u4f32 and bf16u4f32. Same scheme as the
+// x86_64 avx2_fma kernel: each RHS byte holds the two K0 nibbles of one N0
+// row, dequantized as q * scale + bias with bias = -zero_point * scale.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_xxu4f32_1x8x2_to_8x8x2_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t lhs_type, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  float32x4_t acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+      acc[i] = vld1q_f32(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) { acc[i] = vdupq_n_f32(0); }
+  }
+  const uint8x8_t nibble_mask = vdup_n_u8(0xF);
+  for (int k = 0; k < params->K; k += params->group_size) {
+    float32x4_t scale[2], bias[2];
+    IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+      scale[i] = vld1q_f32(scales_panel + 4 * i);
+      bias[i] = vnegq_f32(vmulq_f32(vld1q_f32(scales_panel + 8 + 4 * i),
+                                    scale[i]));
+    }
+    scales_panel += 16;
+    int k_end = iree_uk_index_min(params->K, k + params->group_size);
+    for (int kk = k; kk < k_end; ++kk) {
+      uint8x8_t rhs_u8 = vld1_u8(rhs_ptr);
+      rhs_ptr += 8;
+      uint16x8_t rhs_u16[2] = {vmovl_u8(vand_u8(rhs_u8, nibble_mask)),
+                               vmovl_u8(vshr_n_u8(rhs_u8, 4))};
+      // rhs[2 * k0 + j] holds columns 4 * j .. 4 * j + 3 of k0-slice k0.
+      float32x4_t rhs[4];
+      IREE_UK_UNROLL for (int i = 0; i < 2; ++i) {
+        rhs[2 * i + 0] = vfmaq_f32(
+            bias[0], vcvtq_f32_u32(vmovl_u16(vget_low_u16(rhs_u16[i]))),
+            scale[0]);
+        rhs[2 * i + 1] = vfmaq_f32(
+            bias[1], vcvtq_f32_u32(vmovl_u16(vget_high_u16(rhs_u16[i]))),
+            scale[1]);
+      }
+      float lhs[16];
+      if (M0 == 1) {
+        uint16x4_t lhs_u16 = vld1_dup_u16(lhs_ptr);
+        lhs_u16 = vld1_lane_u16(lhs_ptr + 1, lhs_u16, 1);
+        vst1q_f32(lhs, iree_uk_arm_64_xf16_to_f32(lhs_u16, lhs_type));
+      } else {
+        IREE_UK_UNROLL for (int i = 0; i < M0 / 2; ++i) {
+          vst1q_f32(lhs + 4 * i, iree_uk_arm_64_xf16_to_f32(
+                                     vld1_u16(lhs_ptr + 4 * i), lhs_type));
+        }
+      }
+      lhs_ptr += 2 * M0;
+      IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+        IREE_UK_UNROLL for (int j = 0; j < 2; ++j) {
+          acc[2 * i + j] = vfmaq_n_f32(acc[2 * i + j], rhs[j], lhs[2 * i]);
+          acc[2 * i + j] =
+              vfmaq_n_f32(acc[2 * i + j], rhs[2 + j], lhs[2 * i + 1]);
+        }
+      }
+    }
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 2 * M0; ++i) {
+    vst1q_f32(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_1x8x2_to_8x8x2_arm_64(
+      out_tile, lhs_panel, rhs_panel, scales_panel, params,
+      IREE_UK_TYPE_FLOAT_16, M0);
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_arm_64(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_1x8x2_to_8x8x2_arm_64(
+      out_tile, lhs_panel, rhs_panel, scales_panel, params,
+      IREE_UK_TYPE_BFLOAT_16, M0);
+}
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_arm_64, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_2x8x2_arm_64, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_4x8x2_arm_64, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_8x8x2_arm_64, 8)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_arm_64, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_2x8x2_arm_64, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_4x8x2_arm_64, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_arm_64,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_8x8x2_arm_64, 8)
@@ -0,0 +1,16 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Tile functions of iree_uk_mmt4d_dequant. Same ordering rules as
+// mmt4d_arm_64_tiles.inl.
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, f16, u4, f32, 1, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, f16, u4, f32, 2, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, f16, u4, f32, 4, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, f16, u4, f32, 8, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, bf16, u4, f32, 1, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, bf16, u4, f32, 2, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, bf16, u4, f32, 4, 8, 2, )
+IREE_UK_MMT4D_DEQUANT_TILE(arm_64, bf16, u4, f32, 8, 8, 2, )
@@ -66,3 +66,32 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
 
   return tile_func;
 }
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+  IREE_UK_ATTRIBUTE_UNUSED iree_uk_mmt4d_type_t mmt4d_type =
+      iree_uk_mmt4d_type(params->flags);
+  iree_uk_mmt4d_dequant_tile_func_t tile_func = 0;
+
+#define IREE_UK_MMT4D_DEQUANT_TILE(arch, lhs, rhs, out, m0, n0, k0, suffix)               \
+  if (mmt4d_type == iree_uk_mmt4d_type_##lhs##rhs##out && params->M0 == m0 &&             \
+      params->N0 == n0 && params->K0 == k0 &&                                             \
+      iree_uk_cpu_arm_64##suffix(params->cpu_data)) {                                     \
+    tile_func =                                                                           \
+        iree_uk_mmt4d_dequant_tile_##lhs##rhs##out##_##m0##x##n0##x##k0##_arm_64##suffix; \
+  }
+
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64_dequant_tiles.inl"
+
+  return tile_func;
+}
+
+iree_uk_mmt4d_loop_func_t iree_uk_mmt4d_select_loop_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SME
+  if (iree_uk_cpu_arm_64_sme(params->cpu_data)) {
+    return iree_uk_mmt4d_select_loop_func_arm_64_sme(params);
+  }
+#endif
+  return 0;
+}
@@ -17,4 +17,17 @@
 
 #undef IREE_UK_MMT4D_TILE
 
+#define IREE_UK_MMT4D_DEQUANT_TILE(ARCH, LHS, RHS, OUT, M0, N0, K0, SUFFIX) \
+  IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(                                     \
+      iree_uk_mmt4d_dequant_tile_##LHS##RHS##OUT##_##M0##x##N0##x##K0##_##ARCH##SUFFIX)
+
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64_dequant_tiles.inl"
+
+#undef IREE_UK_MMT4D_DEQUANT_TILE
+
+// Returns the SME loop function for the given params, if any. Must only be
+// called when iree_uk_cpu_arm_64_sme() is true.
+iree_uk_mmt4d_loop_func_t iree_uk_mmt4d_select_loop_func_arm_64_sme(
+    const iree_uk_mmt4d_params_t* params);
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_ARM_64_MMT4D_ARM_64_INTERNAL_H_
@@ -0,0 +1,227 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <arm_sme.h>
+
+#include "iree/builtins/ukernel/arch/arm_64/common_arm_64.h"
+#include "iree/builtins/ukernel/arch/arm_64/mmt4d_arm_64_internal.h"
+
+// Kernels using SME outer products into the ZA array. All supported cases have
+// 32-bit accumulators and 32 bits of LHS/RHS data per K0 group:
+//   f32f32f32 (K0=1, FMOPA), f16f16f32 and bf16bf16f32 (K0=2, widening
+//   FMOPA/BFMOPA), s8s8s32 (K0=4, SMOPA).
+// In each case, one K-step of the mmt4d LHS (M0 x K0) and RHS (N0 x K0) tiles
+// is exactly one SVE vector operand of the outer product instruction, with
+// N0=16 filling a ZA32 tile at a 512-bit streaming vector length. Narrower M0
+// are handled by predicated loads leaving the extra ZA rows unused.
+//
+// Entering and exiting streaming mode is expensive and discards the SVE/NEON
+// register state, so it happens once per ukernel call, around the entire loop
+// nest, rather than per tile. That is why these are loop functions rather than
+// tile functions.
+
+iree_uk_index_t iree_uk_arm_64_sme_vector_length_bytes(void) {
+  return svcntsb();
+}
+
+// Arguments of the streaming-mode loop nest. Computed by the non-streaming
+// entry point so that the streaming code only contains the loop itself.
+typedef struct iree_uk_mmt4d_loop_arm_64_sme_t {
+  const char* lhs_panel;
+  const char* rhs_panel_start;
+  char* out_tile_row;
+  iree_uk_index_t lhs_panel_stride;
+  iree_uk_index_t rhs_panel_stride;
+  iree_uk_index_t out_stride;
+  iree_uk_index_t M;
+  iree_uk_index_t N;
+  iree_uk_index_t K;
+  int M0;
+  bool accumulate;
+} iree_uk_mmt4d_loop_arm_64_sme_t;
+
+// Accumulates the outer product of one K-step of LHS and RHS into ZA32 tile
+// TILE. A macro, not a function, as TILE must be an immediate.
+#define IREE_UK_MMT4D_SME_MOPA(TILE, MMT4D_TYPE, LHS_PTR, RHS_PTR, PM, PN)   \
+  do {                                                                       \
+    svuint32_t lhs = svld1_u32(PM, LHS_PTR);                                 \
+    svuint32_t rhs = svld1_u32(PN, RHS_PTR);                                 \
+    svbool_t all = svptrue_b8();                                             \
+    if (MMT4D_TYPE == iree_uk_mmt4d_type_f32f32f32) {                        \
+      svmopa_za32_f32_m(TILE, all, all, svreinterpret_f32_u32(lhs),          \
+                        svreinterpret_f32_u32(rhs));                         \
+    } else if (MMT4D_TYPE == iree_uk_mmt4d_type_f16f16f32) {                 \
+      svmopa_za32_f16_m(TILE, all, all, svreinterpret_f16_u32(lhs),          \
+                        svreinterpret_f16_u32(rhs));                         \
+    } else if (MMT4D_TYPE == iree_uk_mmt4d_type_bf16bf16f32) {               \
+      svmopa_za32_bf16_m(TILE, all, all, svreinterpret_bf16_u32(lhs),        \
+                         svreinterpret_bf16_u32(rhs));                       \
+    } else {                                                                 \
+      svmopa_za32_s8_m(TILE, all, all, svreinterpret_s8_u32(lhs),            \
+                       svreinterpret_s8_u32(rhs));                           \
+    }                                                                        \
+  } while (0)
+
+// Computes one M0 x 16 tile. Consecutive K-steps accumulate into the 4 ZA32
+// tiles in turn so that the outer products do not wait on each other, and the
+// 4 partial sums are added when storing the result.
+static inline void iree_uk_mmt4d_tile_x32_arm_64_sme(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_loop_arm_64_sme_t* loop,
+    iree_uk_mmt4d_type_t mmt4d_type) __arm_streaming __arm_inout("za") {
+  const iree_uk_uint32_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint32_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  const int M0 = loop->M0;
+  const iree_uk_index_t K = loop->K;
+  svbool_t pm = svwhilelt_b32_s32(0, M0);
+  svbool_t pn = svwhilelt_b32_s32(0, 16);
+
+  svzero_za();
+  if (loop->accumulate) {
+    const iree_uk_uint32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+    for (int i = 0; i < M0; ++i) {
+      svld1_hor_za32(0, i, pn, out_ptr + i * 16);
+    }
+  }
+
+  iree_uk_index_t k = 0;
+  for (; k + 4 <= K; k += 4) {
+    IREE_UK_MMT4D_SME_MOPA(0, mmt4d_type, lhs_ptr + 0 * M0, rhs_ptr + 0 * 16,
+                           pm, pn);
+    IREE_UK_MMT4D_SME_MOPA(1, mmt4d_type, lhs_ptr + 1 * M0, rhs_ptr + 1 * 16,
+                           pm, pn);
+    IREE_UK_MMT4D_SME_MOPA(2, mmt4d_type, lhs_ptr + 2 * M0, rhs_ptr + 2 * 16,
+                           pm, pn);
+    IREE_UK_MMT4D_SME_MOPA(3, mmt4d_type, lhs_ptr + 3 * M0, rhs_ptr + 3 * 16,
+                           pm, pn);
+    lhs_ptr += 4 * M0;
+    rhs_ptr += 4 * 16;
+  }
+  for (; k < K; ++k) {
+    IREE_UK_MMT4D_SME_MOPA(0, mmt4d_type, lhs_ptr, rhs_ptr, pm, pn);
+    lhs_ptr += M0;
+    rhs_ptr += 16;
+  }
+
+  svbool_t all = svptrue_b32();
+  if (mmt4d_type == iree_uk_mmt4d_type_s8s8s32) {
+    iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+    for (int i = 0; i < M0; ++i) {
+      svint32_t acc0 = svread_hor_za32_s32_m(svundef_s32(), all, 0, i);
+      svint32_t acc1 = svread_hor_za32_s32_m(svundef_s32(), all, 1, i);
+      svint32_t acc2 = svread_hor_za32_s32_m(svundef_s32(), all, 2, i);
+      svint32_t acc3 = svread_hor_za32_s32_m(svundef_s32(), all, 3, i);
+      svint32_t acc = svadd_s32_x(all, svadd_s32_x(all, acc0, acc1),
+                                  svadd_s32_x(all, acc2, acc3));
+      svst1_s32(pn, out_ptr + i * 16, acc);
+    }
+  } else {
+    float* IREE_UK_RESTRICT out_ptr = out_tile;
+    for (int i = 0; i < M0; ++i) {
+      svfloat32_t acc0 = svread_hor_za32_f32_m(svundef_f32(), all, 0, i);
+      svfloat32_t acc1 = svread_hor_za32_f32_m(svundef_f32(), all, 1, i);
+      svfloat32_t acc2 = svread_hor_za32_f32_m(svundef_f32(), all, 2, i);
+      svfloat32_t acc3 = svread_hor_za32_f32_m(svundef_f32(), all, 3, i);
+      svfloat32_t acc = svadd_f32_x(all, svadd_f32_x(all, acc0, acc1),
+                                    svadd_f32_x(all, acc2, acc3));
+      svst1_f32(pn, out_ptr + i * 16, acc);
+    }
+  }
+}
+
+static inline void iree_uk_mmt4d_loop_x32_arm_64_sme(
+    const iree_uk_mmt4d_loop_arm_64_sme_t* loop,
+    iree_uk_mmt4d_type_t mmt4d_type) __arm_streaming __arm_inout("za") {
+  const char* lhs_panel = loop->lhs_panel;
+  char* out_tile_row = loop->out_tile_row;
+  const iree_uk_index_t out_tile_size = loop->M0 * 16 * sizeof(iree_uk_int32_t);
+  for (iree_uk_index_t i = 0; i < loop->M; ++i) {
+    char* out_tile = out_tile_row;
+    const char* rhs_panel = loop->rhs_panel_start;
+    for (iree_uk_index_t j = 0; j < loop->N; ++j) {
+      iree_uk_mmt4d_tile_x32_arm_64_sme(out_tile, lhs_panel, rhs_panel, loop,
+                                        mmt4d_type);
+      out_tile += out_tile_size;
+      rhs_panel += loop->rhs_panel_stride;
+    }
+    out_tile_row += loop->out_stride;
+    lhs_panel += loop->lhs_panel_stride;
+  }
+}
+
+static iree_uk_mmt4d_loop_arm_64_sme_t iree_uk_mmt4d_loop_arm_64_sme_init(
+    const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const int lhs_elem_bits_log2 =
+      iree_uk_type_bit_count_log2(iree_uk_mmt4d_lhs_type(mmt4d_type));
+  const int rhs_elem_bits_log2 =
+      iree_uk_type_bit_count_log2(iree_uk_mmt4d_rhs_type(mmt4d_type));
+  const int out_elem_size_log2 =
+      iree_uk_type_size_log2(iree_uk_mmt4d_out_type(mmt4d_type));
+  iree_uk_mmt4d_loop_arm_64_sme_t loop = {
+      .lhs_panel = (const char*)params->lhs_buffer +
+                   iree_uk_bits_to_bytes_exact(params->lhs_offset
+                                               << lhs_elem_bits_log2),
+      .rhs_panel_start = (const char*)params->rhs_buffer +
+                         iree_uk_bits_to_bytes_exact(params->rhs_offset
+                                                     << rhs_elem_bits_log2),
+      .out_tile_row = (char*)params->out_buffer +
+                      (params->out_offset << out_elem_size_log2),
+      .lhs_panel_stride = iree_uk_bits_to_bytes_exact(params->lhs_stride0
+                                                      << lhs_elem_bits_log2),
+      .rhs_panel_stride = iree_uk_bits_to_bytes_exact(params->rhs_stride0
+                                                      << rhs_elem_bits_log2),
+      .out_stride = params->out_stride0 << out_elem_size_log2,
+      .M = params->M,
+      .N = params->N,
+      .K = params->K,
+      .M0 = params->M0,
+      .accumulate = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) != 0,
+  };
+  return loop;
+}
+
+// Defines the loop function for TYPE: a streaming function running the loop
+// nest, called from a non-streaming function matching iree_uk_mmt4d_loop_func_t
+// that computes the loop arguments.
+#define IREE_UK_MMT4D_LOOP_FUNC_ARM_64_SME(TYPE)                       \
+  __arm_locally_streaming __arm_new("za") static void                 \
+      iree_uk_mmt4d_loop_##TYPE##_arm_64_sme_streaming(                \
+          const iree_uk_mmt4d_loop_arm_64_sme_t* loop) {               \
+    iree_uk_mmt4d_loop_x32_arm_64_sme(loop, iree_uk_mmt4d_type_##TYPE); \
+  }                                                                    \
+  static void iree_uk_mmt4d_loop_##TYPE##_arm_64_sme(                  \
+      const iree_uk_mmt4d_params_t* params) {                          \
+    iree_uk_mmt4d_loop_arm_64_sme_t loop =                             \
+        iree_uk_mmt4d_loop_arm_64_sme_init(params);                    \
+    iree_uk_mmt4d_loop_##TYPE##_arm_64_sme_streaming(&loop);           \
+  }
+
+IREE_UK_MMT4D_LOOP_FUNC_ARM_64_SME(f32f32f32)
+IREE_UK_MMT4D_LOOP_FUNC_ARM_64_SME(f16f16f32)
+IREE_UK_MMT4D_LOOP_FUNC_ARM_64_SME(bf16bf16f32)
+IREE_UK_MMT4D_LOOP_FUNC_ARM_64_SME(s8s8s32)
+
+iree_uk_mmt4d_loop_func_t iree_uk_mmt4d_select_loop_func_arm_64_sme(
+    const iree_uk_mmt4d_params_t* params) {
+  if (params->N0 != 16 || params->M0 < 1 || params->M0 > 16 ||
+      !iree_uk_is_po2_u32(params->M0)) {
+    return 0;
+  }
+  switch (iree_uk_mmt4d_type(params->flags)) {
+    case iree_uk_mmt4d_type_f32f32f32:
+      return params->K0 == 1 ? iree_uk_mmt4d_loop_f32f32f32_arm_64_sme : 0;
+    case iree_uk_mmt4d_type_f16f16f32:
+      return params->K0 == 2 ? iree_uk_mmt4d_loop_f16f16f32_arm_64_sme : 0;
+    case iree_uk_mmt4d_type_bf16bf16f32:
+      return params->K0 == 2 ? iree_uk_mmt4d_loop_bf16bf16f32_arm_64_sme : 0;
+    case iree_uk_mmt4d_type_s8s8s32:
+      return params->K0 == 4 ? iree_uk_mmt4d_loop_s8s8s32_arm_64_sme : 0;
+    default:
+      return 0;
+  }
+}
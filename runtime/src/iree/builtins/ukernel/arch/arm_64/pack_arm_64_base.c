@@ -72,6 +72,36 @@ void iree_uk_pack_tile_8x1_x32_arm_64_direct(
                                          4);
 }
 
+void iree_uk_pack_tile_8x1_x32_arm_64_direct_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  // Transpose 2 tiles at a time into a local buffer that stays in L1, then
+  // stream it out.
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_int8_t tmp[2 * 32];
+  for (; outer_size1 >= 2; outer_size1 -= 2) {
+    iree_uk_neon_copy_8x8xi8_tiled_1x4_transpose_strided_to_strided(
+        tmp, in_ptr, 32, 4 * in_stride0);
+    iree_uk_neon_stnp_32xi8(out_ptr, tmp);
+    iree_uk_neon_stnp_32xi8(out_ptr + 4 * out_stride1, tmp + 32);
+    out_ptr += 8 * out_stride1;
+    in_ptr += 8;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_copy_8x4xi8_strided_to_unstrided(tmp, in_ptr, 4 * in_stride0);
+    iree_uk_neon_stnp_32xi8(out_ptr, tmp);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 4;
+  }
+}
+
 void iree_uk_pack_tile_8x8_x8_arm_64_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -108,6 +138,24 @@ void iree_uk_pack_tile_8x1_x32_arm_64_transpose(
   }
 }
 
+void iree_uk_pack_tile_8x1_x32_arm_64_transpose_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_tile_ptr_i32 = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_tile_i32_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_neon_stnp_32xi8(out_tile_i32_ptr, in_tile_ptr_i32);
+    out_tile_i32_ptr += out_stride1;
+    in_tile_ptr_i32 += 8;
+  }
+}
+
 void iree_uk_pack_tile_8x1_x8_arm_64_transpose(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -199,3 +247,23 @@ void iree_uk_pack_tile_8x8_x32_arm_64_direct(
     in_ptr += 32;
   }
 }
+
+void iree_uk_pack_tile_8x8_x32_arm_64_direct_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 8; ++i) {
+      iree_uk_neon_stnp_32xi8(out_ptr + i * 32, in_ptr + i * 4 * in_stride0);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 32;
+  }
+}
@@ -15,10 +15,19 @@ iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
   iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
   int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
   bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+  // STNP has no alignment requirement beyond that of regular stores, so the
+  // size threshold is the only condition for using streaming stores.
+  bool streaming = iree_uk_pack_prefer_streaming_stores(params);
   if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 8) {
     // Currently only used for accumulators, which are never transposed.
-    return transpose ? 0 : iree_uk_pack_tile_8x8_x32_arm_64_direct;
+    if (transpose) return 0;
+    return streaming ? iree_uk_pack_tile_8x8_x32_arm_64_direct_streaming
+                     : iree_uk_pack_tile_8x8_x32_arm_64_direct;
   } else if (esize == 4 && params->out_size2 == 8 && params->out_size3 == 1) {
+    if (streaming) {
+      return transpose ? iree_uk_pack_tile_8x1_x32_arm_64_transpose_streaming
+                       : iree_uk_pack_tile_8x1_x32_arm_64_direct_streaming;
+    }
     return transpose ? iree_uk_pack_tile_8x1_x32_arm_64_transpose
                      : iree_uk_pack_tile_8x1_x32_arm_64_direct;
   } else if (esize == 1 && params->out_size2 == 8 && params->out_size3 == 1) {
@@ -10,12 +10,22 @@
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_arm_64_f32f32f32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SME
+  if (iree_uk_cpu_arm_64_sme(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 1, .N = 16};
+  }
+#endif
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
 }
 
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+#ifdef IREE_UK_BUILD_ARM_64_SME
+  if (iree_uk_cpu_arm_64_sme(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 4, .N = 16};
+  }
+#endif
 #ifdef IREE_UK_BUILD_ARM_64_I8MM
   if (iree_uk_cpu_arm_64_i8mm(params->cpu_data)) {
     return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 8, .N = 8};
@@ -29,6 +39,20 @@ iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 1, .N = 8};
 }
 
+static bool iree_uk_query_matmul_tile_sizes_arm_64_bf16bf16f32(
+    const iree_uk_query_tile_sizes_2d_params_t* params,
+    iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+#ifdef IREE_UK_BUILD_ARM_64_SME
+  if (iree_uk_cpu_arm_64_sme(params->cpu_data)) {
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
+    return true;
+  }
+#endif
+  // No fast path, use the generic tile sizes.
+  return false;
+}
+
 bool iree_uk_query_matmul_tile_sizes_arch(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
@@ -41,6 +65,9 @@ bool iree_uk_query_matmul_tile_sizes_arch(
     *out_matmul_tile_sizes =
         iree_uk_query_matmul_tile_sizes_arm_64_i8i8i32(params);
     return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32) {
+    return iree_uk_query_matmul_tile_sizes_arm_64_bf16bf16f32(
+        params, out_matmul_tile_sizes);
   } else {
     // Shouldn't happen, validated earlier.
     return false;
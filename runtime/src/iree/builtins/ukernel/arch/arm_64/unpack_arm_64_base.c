@@ -25,3 +25,23 @@ void iree_uk_unpack_tile_8x8_x32_arm_64_direct(
     in_ptr += 4 * in_stride1;
   }
 }
+
+void iree_uk_unpack_tile_8x8_x32_arm_64_direct_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 8);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 8; ++i) {
+      iree_uk_neon_stnp_32xi8(out_ptr + i * 4 * out_stride0, in_ptr + i * 32);
+    }
+    out_ptr += 32;
+    in_ptr += 4 * in_stride1;
+  }
+}
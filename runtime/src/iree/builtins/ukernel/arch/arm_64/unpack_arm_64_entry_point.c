@@ -15,7 +15,9 @@ iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_arch(
   // Unpack is currently only used in practice with esize==4 and non-transpose.
   if (esize != 4 || transpose) return 0;
   if (params->in_size2 == 8 && params->in_size3 == 8) {
-    return iree_uk_unpack_tile_8x8_x32_arm_64_direct;
+    return iree_uk_unpack_prefer_streaming_stores(params)
+               ? iree_uk_unpack_tile_8x8_x32_arm_64_direct_streaming
+               : iree_uk_unpack_tile_8x8_x32_arm_64_direct;
   }
   return 0;
 }
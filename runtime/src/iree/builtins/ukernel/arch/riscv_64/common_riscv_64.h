@@ -0,0 +1,104 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_COMMON_RISCV_64_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_COMMON_RISCV_64_H_
+
+#include "iree/builtins/ukernel/common.h"
+#include "iree/schemas/cpu_data.h"
+
+// Unlike on other architectures, the vector extension is not part of the
+// baseline ISA, so only code compiled with it enabled gets the intrinsics.
+#if defined(__riscv_vector)
+#include <riscv_vector.h>
+#endif  // defined(__riscv_vector)
+
+#if defined(IREE_DEVICE_STANDALONE)
+// Standalone builds (e.g. bitcode) use our own Clang, supporting everything.
+#define IREE_UK_BUILD_RISCV_64_V
+#define IREE_UK_BUILD_RISCV_64_ZVFH
+#else  // IREE_DEVICE_STANDALONE
+// Compiling with the system toolchain. Include the configured header.
+#include "iree/builtins/ukernel/arch/riscv_64/config_riscv_64.h"
+#endif  // IREE_DEVICE_STANDALONE
+
+static inline bool iree_uk_cpu_riscv_64_v(const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_RISCV_64_RVV);
+}
+
+static inline bool iree_uk_cpu_riscv_64_zvfh(
+    const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_all_bits_set(
+      cpu_data[0], IREE_CPU_DATA0_RISCV_64_RVV | IREE_CPU_DATA0_RISCV_64_ZVFH);
+}
+
+// RVV register types are sizeless, so they can't be held in arrays the way
+// other architectures' kernels hold accumulator tiles. Kernels instead use
+// one variable per row and expand per-row code with this macro.
+#define IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(X) \
+  X(0) X(1) X(2) X(3) X(4) X(5) X(6) X(7)
+
+#if defined(__riscv_vector)
+
+// Copies `count` elements of `elem_size` bytes (1, 2, 4 or 8) from `in` to
+// `out`. Strides are in bytes between consecutive elements; when a stride
+// equals `elem_size`, unit-stride accesses are used as they are typically
+// faster than strided ones. Both sides must be aligned to `elem_size`.
+static inline void iree_uk_riscv_64_v_copy_strided(
+    void* IREE_UK_RESTRICT out, iree_uk_index_t out_stride,
+    const void* IREE_UK_RESTRICT in, iree_uk_index_t in_stride,
+    iree_uk_index_t count, iree_uk_index_t elem_size) {
+  char* IREE_UK_RESTRICT out_ptr = out;
+  const char* IREE_UK_RESTRICT in_ptr = in;
+#define IREE_UK_RVV_COPY_STRIDED(BITS)                                       \
+  while (count > 0) {                                                        \
+    size_t vl = __riscv_vsetvl_e##BITS##m8(count);                           \
+    vuint##BITS##m8_t v =                                                    \
+        in_stride == elem_size                                               \
+            ? __riscv_vle##BITS##_v_u##BITS##m8((const void*)in_ptr, vl)     \
+            : __riscv_vlse##BITS##_v_u##BITS##m8((const void*)in_ptr,        \
+                                                 in_stride, vl);             \
+    if (out_stride == elem_size) {                                           \
+      __riscv_vse##BITS##_v_u##BITS##m8((void*)out_ptr, v, vl);              \
+    } else {                                                                 \
+      __riscv_vsse##BITS##_v_u##BITS##m8((void*)out_ptr, out_stride, v, vl); \
+    }                                                                        \
+    in_ptr += vl * in_stride;                                                \
+    out_ptr += vl * out_stride;                                              \
+    count -= vl;                                                             \
+  }
+  switch (elem_size) {
+    case 1:
+      IREE_UK_RVV_COPY_STRIDED(8)
+      break;
+    case 2:
+      IREE_UK_RVV_COPY_STRIDED(16)
+      break;
+    case 4:
+      IREE_UK_RVV_COPY_STRIDED(32)
+      break;
+    case 8:
+      IREE_UK_RVV_COPY_STRIDED(64)
+      break;
+    default:
+      IREE_UK_ASSERT(0 && "unhandled element size");
+  }
+#undef IREE_UK_RVV_COPY_STRIDED
+}
+
+// Returns true if contiguous runs of `size` bytes at `ptr` + i * `stride` can
+// be accessed as single naturally aligned elements of at most 64 bits.
+static inline bool iree_uk_riscv_64_v_is_element_sized(const void* ptr,
+                                                       iree_uk_index_t stride,
+                                                       iree_uk_index_t size) {
+  if (size != 1 && size != 2 && size != 4 && size != 8) return false;
+  return (((iree_uk_uint64_t)ptr | (iree_uk_uint64_t)stride) & (size - 1)) ==
+         0;
+}
+
+#endif  // defined(__riscv_vector)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_COMMON_RISCV_64_H_
@@ -0,0 +1,25 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Ordering matters when multiple lines have the same types and tile shape and
+// are supported by the CPU. In that case, the last-enumerated line overrides
+// preceding lines. Always go from oldest to shiniest code path.
+//
+// All tiles have N0=16: the kernels strip-mine over N0 with vsetvl, so they
+// work for any VLEN, and N0=16 fills two LMUL=2 strips of 32-bit accumulators
+// at the minimum VLEN=128 of the V extension.
+IREE_UK_MMT4D_TILE(riscv_64, f32, f32, f32, 1, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, f32, f32, f32, 2, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, f32, f32, f32, 4, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, f32, f32, f32, 8, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, s8, s8, s32, 1, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, s8, s8, s32, 2, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, s8, s8, s32, 4, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, s8, s8, s32, 8, 16, 1, _v)
+IREE_UK_MMT4D_TILE(riscv_64, f16, f16, f32, 1, 16, 1, _zvfh)
+IREE_UK_MMT4D_TILE(riscv_64, f16, f16, f32, 2, 16, 1, _zvfh)
+IREE_UK_MMT4D_TILE(riscv_64, f16, f16, f32, 4, 16, 1, _zvfh)
+IREE_UK_MMT4D_TILE(riscv_64, f16, f16, f32, 8, 16, 1, _zvfh)
@@ -0,0 +1,122 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/mmt4d_riscv_64_internal.h"
+
+// The kernels below are VLEN-agnostic: the N0=16 columns of the tile are
+// strip-mined in chunks of vl = vsetvl(remaining columns) elements, which is
+// 2 chunks at VLEN=128 and a single chunk at VLEN>=256.
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_8x16x1_riscv_64_v(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const int N0 = 16;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  bool accumulate = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE;
+  for (int n = 0; n < N0;) {
+    size_t vl = __riscv_vsetvl_e32m2(N0 - n);
+#define IREE_UK_RVV_ACC_INIT(i)                               \
+  vfloat32m2_t acc##i = __riscv_vfmv_v_f_f32m2(0.0f, vl);     \
+  if (M0 > i && accumulate) {                                 \
+    acc##i = __riscv_vle32_v_f32m2(out_ptr + i * N0 + n, vl); \
+  }
+    IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_INIT)
+#undef IREE_UK_RVV_ACC_INIT
+    const float* IREE_UK_RESTRICT lhs_k = lhs_ptr;
+    const float* IREE_UK_RESTRICT rhs_k = rhs_ptr + n;
+    for (int k = 0; k < params->K; ++k) {
+      vfloat32m2_t rhs = __riscv_vle32_v_f32m2(rhs_k, vl);
+#define IREE_UK_RVV_ACC_FMA(i)                                             \
+  if (M0 > i) acc##i = __riscv_vfmacc_vf_f32m2(acc##i, lhs_k[i], rhs, vl);
+      IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_FMA)
+#undef IREE_UK_RVV_ACC_FMA
+      lhs_k += M0;
+      rhs_k += N0;
+    }
+#define IREE_UK_RVV_ACC_STORE(i)                                       \
+  if (M0 > i) __riscv_vse32_v_f32m2(out_ptr + i * N0 + n, acc##i, vl);
+    IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_STORE)
+#undef IREE_UK_RVV_ACC_STORE
+    n += vl;
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_f32f32f32_1x16x1_riscv_64_v, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_f32f32f32_2x16x1_riscv_64_v, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_f32f32f32_4x16x1_riscv_64_v, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_f32f32f32_8x16x1_riscv_64_v, 8)
+
+// The RHS is sign-extended to 16 bits once per k-step so that a single
+// widening multiply-accumulate (vwmacc.vx, i16 x i16 -> i32) does the work for
+// each LHS row.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s8s32_1x16x1_to_8x16x1_riscv_64_v(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const int N0 = 16;
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  bool accumulate = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE;
+  for (int n = 0; n < N0;) {
+    size_t vl = __riscv_vsetvl_e32m2(N0 - n);
+#define IREE_UK_RVV_ACC_INIT(i)                               \
+  vint32m2_t acc##i = __riscv_vmv_v_x_i32m2(0, vl);           \
+  if (M0 > i && accumulate) {                                 \
+    acc##i = __riscv_vle32_v_i32m2(out_ptr + i * N0 + n, vl); \
+  }
+    IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_INIT)
+#undef IREE_UK_RVV_ACC_INIT
+    const iree_uk_int8_t* IREE_UK_RESTRICT lhs_k = lhs_ptr;
+    const iree_uk_int8_t* IREE_UK_RESTRICT rhs_k = rhs_ptr + n;
+    for (int k = 0; k < params->K; ++k) {
+      vint16m1_t rhs =
+          __riscv_vsext_vf2_i16m1(__riscv_vle8_v_i8mf2(rhs_k, vl), vl);
+#define IREE_UK_RVV_ACC_MAC(i)                                   \
+  if (M0 > i) {                                                  \
+    acc##i = __riscv_vwmacc_vx_i32m2(acc##i, lhs_k[i], rhs, vl); \
+  }
+      IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_MAC)
+#undef IREE_UK_RVV_ACC_MAC
+      lhs_k += M0;
+      rhs_k += N0;
+    }
+#define IREE_UK_RVV_ACC_STORE(i)                                       \
+  if (M0 > i) __riscv_vse32_v_i32m2(out_ptr + i * N0 + n, acc##i, vl);
+    IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_STORE)
+#undef IREE_UK_RVV_ACC_STORE
+    n += vl;
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_s8s8s32_1x16x1_riscv_64_v, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_s8s8s32_2x16x1_riscv_64_v, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_s8s8s32_4x16x1_riscv_64_v, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x1_to_8x16x1_riscv_64_v,
+    iree_uk_mmt4d_tile_s8s8s32_8x16x1_riscv_64_v, 8)
@@ -0,0 +1,64 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/mmt4d_riscv_64_internal.h"
+
+// Same structure as the f32 kernel in mmt4d_riscv_64_v.c, using the widening
+// vfwmacc.vf (f16 x f16 -> f32) from Zvfh so no separate conversion is needed.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f16f16f32_1x16x1_to_8x16x1_riscv_64_zvfh(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const int N0 = 16;
+  const _Float16* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const _Float16* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  bool accumulate = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE;
+  for (int n = 0; n < N0;) {
+    size_t vl = __riscv_vsetvl_e32m2(N0 - n);
+#define IREE_UK_RVV_ACC_INIT(i)                               \
+  vfloat32m2_t acc##i = __riscv_vfmv_v_f_f32m2(0.0f, vl);     \
+  if (M0 > i && accumulate) {                                 \
+    acc##i = __riscv_vle32_v_f32m2(out_ptr + i * N0 + n, vl); \
+  }
+    IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_INIT)
+#undef IREE_UK_RVV_ACC_INIT
+    const _Float16* IREE_UK_RESTRICT lhs_k = lhs_ptr;
+    const _Float16* IREE_UK_RESTRICT rhs_k = rhs_ptr + n;
+    for (int k = 0; k < params->K; ++k) {
+      vfloat16m1_t rhs = __riscv_vle16_v_f16m1(rhs_k, vl);
+#define IREE_UK_RVV_ACC_FMA(i)                                    \
+  if (M0 > i) {                                                   \
+    acc##i = __riscv_vfwmacc_vf_f32m2(acc##i, lhs_k[i], rhs, vl); \
+  }
+      IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_FMA)
+#undef IREE_UK_RVV_ACC_FMA
+      lhs_k += M0;
+      rhs_k += N0;
+    }
+#define IREE_UK_RVV_ACC_STORE(i)                                       \
+  if (M0 > i) __riscv_vse32_v_f32m2(out_ptr + i * N0 + n, acc##i, vl);
+    IREE_UK_RISCV_64_FOREACH_ROW_UP_TO_8(IREE_UK_RVV_ACC_STORE)
+#undef IREE_UK_RVV_ACC_STORE
+    n += vl;
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f32_1x16x1_to_8x16x1_riscv_64_zvfh,
+    iree_uk_mmt4d_tile_f16f16f32_1x16x1_riscv_64_zvfh, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f32_1x16x1_to_8x16x1_riscv_64_zvfh,
+    iree_uk_mmt4d_tile_f16f16f32_2x16x1_riscv_64_zvfh, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f32_1x16x1_to_8x16x1_riscv_64_zvfh,
+    iree_uk_mmt4d_tile_f16f16f32_4x16x1_riscv_64_zvfh, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f16f16f32_1x16x1_to_8x16x1_riscv_64_zvfh,
+    iree_uk_mmt4d_tile_f16f16f32_8x16x1_riscv_64_zvfh, 8)
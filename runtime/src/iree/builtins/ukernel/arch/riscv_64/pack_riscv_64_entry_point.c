@@ -0,0 +1,26 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/pack_riscv_64_internal.h"
+
+iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
+    const iree_uk_pack_params_t* params) {
+#ifdef IREE_UK_BUILD_RISCV_64_V
+  // The RVV tile functions are shape-agnostic, so only the element size
+  // matters, as with other architectures.
+  if (iree_uk_cpu_riscv_64_v(params->cpu_data)) {
+    iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
+    int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
+    bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+    if (esize == 1 || esize == 2 || esize == 4) {
+      return transpose ? iree_uk_pack_tile_riscv_64_v_transpose
+                       : iree_uk_pack_tile_riscv_64_v_direct;
+    }
+  }
+#endif  // IREE_UK_BUILD_RISCV_64_V
+  return 0;
+}
@@ -0,0 +1,75 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/pack_riscv_64_internal.h"
+
+void iree_uk_pack_tile_riscv_64_v_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  char* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const char* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_index_t row_size = tile_size1 * elem_size;
+  iree_uk_index_t in_row_stride = in_stride0 * elem_size;
+  iree_uk_index_t out_tile_stride = out_stride1 * elem_size;
+  if (iree_uk_riscv_64_v_is_element_sized(in_ptr, in_row_stride, row_size) &&
+      iree_uk_riscv_64_v_is_element_sized(out_ptr, out_tile_stride,
+                                          row_size)) {
+    // Each tile row is a single wide element: one strided load gathers the
+    // whole tile, e.g. 8x1xf32 LHS tiles or 8x4xi8 tiles.
+    for (; outer_size1 > 0; --outer_size1) {
+      iree_uk_riscv_64_v_copy_strided(out_ptr, row_size, in_ptr, in_row_stride,
+                                      tile_size0, row_size);
+      out_ptr += out_tile_stride;
+      in_ptr += row_size;
+    }
+    return;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    for (iree_uk_index_t i0 = 0; i0 < tile_size0; ++i0) {
+      iree_uk_riscv_64_v_copy_strided(out_ptr + i0 * row_size, elem_size,
+                                      in_ptr + i0 * in_row_stride, elem_size,
+                                      tile_size1, elem_size);
+    }
+    out_ptr += out_tile_stride;
+    in_ptr += row_size;
+  }
+}
+
+void iree_uk_pack_tile_riscv_64_v_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  char* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const char* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_index_t in_row_stride = in_stride0 * elem_size;
+  iree_uk_index_t out_row_stride = tile_size0 * elem_size;
+  for (; outer_size1 > 0; --outer_size1) {
+    // out[i1][i0] = in[i0][i1]. Iterate along whichever dimension leaves the
+    // longer vectors: a strided store per input row, or a strided load per
+    // output row.
+    if (tile_size1 >= tile_size0) {
+      for (iree_uk_index_t i0 = 0; i0 < tile_size0; ++i0) {
+        iree_uk_riscv_64_v_copy_strided(
+            out_ptr + i0 * elem_size, out_row_stride,
+            in_ptr + i0 * in_row_stride, elem_size, tile_size1, elem_size);
+      }
+    } else {
+      for (iree_uk_index_t i1 = 0; i1 < tile_size1; ++i1) {
+        iree_uk_riscv_64_v_copy_strided(
+            out_ptr + i1 * out_row_stride, elem_size, in_ptr + i1 * elem_size,
+            in_row_stride, tile_size0, elem_size);
+      }
+    }
+    out_ptr += out_stride1 * elem_size;
+    in_ptr += tile_size1 * elem_size;
+  }
+}
@@ -0,0 +1,17 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_UNPACK_RISCV_64_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_UNPACK_RISCV_64_INTERNAL_H_
+
+#include "iree/builtins/ukernel/unpack_internal.h"
+
+// VLEN-agnostic tile functions handling any tile shape and element size up to
+// 8 bytes.
+IREE_UK_UNPACK_TILE_FUNC_DECL(iree_uk_unpack_tile_riscv_64_v_direct)
+IREE_UK_UNPACK_TILE_FUNC_DECL(iree_uk_unpack_tile_riscv_64_v_transpose)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_RISCV_64_UNPACK_RISCV_64_INTERNAL_H_
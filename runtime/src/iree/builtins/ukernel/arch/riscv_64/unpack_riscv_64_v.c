@@ -0,0 +1,73 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/riscv_64/common_riscv_64.h"
+#include "iree/builtins/ukernel/arch/riscv_64/unpack_riscv_64_internal.h"
+
+void iree_uk_unpack_tile_riscv_64_v_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  char* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const char* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_index_t row_size = tile_size1 * elem_size;
+  iree_uk_index_t out_row_stride = out_stride0 * elem_size;
+  iree_uk_index_t in_tile_stride = in_stride1 * elem_size;
+  if (iree_uk_riscv_64_v_is_element_sized(in_ptr, in_tile_stride, row_size) &&
+      iree_uk_riscv_64_v_is_element_sized(out_ptr, out_row_stride,
+                                          row_size)) {
+    // Each tile row is a single wide element: one strided store scatters the
+    // whole tile.
+    for (; outer_size1 > 0; --outer_size1) {
+      iree_uk_riscv_64_v_copy_strided(out_ptr, out_row_stride, in_ptr,
+                                      row_size, tile_size0, row_size);
+      out_ptr += row_size;
+      in_ptr += in_tile_stride;
+    }
+    return;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    for (iree_uk_index_t i0 = 0; i0 < tile_size0; ++i0) {
+      iree_uk_riscv_64_v_copy_strided(out_ptr + i0 * out_row_stride, elem_size,
+                                      in_ptr + i0 * row_size, elem_size,
+                                      tile_size1, elem_size);
+    }
+    out_ptr += row_size;
+    in_ptr += in_tile_stride;
+  }
+}
+
+void iree_uk_unpack_tile_riscv_64_v_transpose(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  char* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const char* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_index_t out_row_stride = out_stride0 * elem_size;
+  iree_uk_index_t in_row_stride = tile_size0 * elem_size;
+  for (; outer_size1 > 0; --outer_size1) {
+    // out[i0][i1] = in[i1][i0]. See the comment in the pack counterpart.
+    if (tile_size1 >= tile_size0) {
+      for (iree_uk_index_t i0 = 0; i0 < tile_size0; ++i0) {
+        iree_uk_riscv_64_v_copy_strided(
+            out_ptr + i0 * out_row_stride, elem_size, in_ptr + i0 * elem_size,
+            in_row_stride, tile_size1, elem_size);
+      }
+    } else {
+      for (iree_uk_index_t i1 = 0; i1 < tile_size1; ++i1) {
+        iree_uk_riscv_64_v_copy_strided(
+            out_ptr + i1 * elem_size, out_row_stride,
+            in_ptr + i1 * in_row_stride, elem_size, tile_size0, elem_size);
+      }
+    }
+    out_ptr += tile_size1 * elem_size;
+    in_ptr += in_stride1 * elem_size;
+  }
+}
@@ -0,0 +1,21 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// WebAssembly has no runtime feature detection: a module using SIMD128
+// instructions fails validation on engines without it. So unlike on other
+// architectures, the SIMD128 code paths are only built when the whole build
+// targets SIMD128 (-msimd128), in which case they are always usable.
+#if defined(__wasm_simd128__)
+#define IREE_UK_BUILD_WASM_32_SIMD128
+#include <wasm_simd128.h>
+#endif  // defined(__wasm_simd128__)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_WASM_32_COMMON_WASM_32_H_
@@ -0,0 +1,123 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/mmt4d_wasm_32_internal.h"
+
+#if defined(IREE_UK_BUILD_WASM_32_SIMD128)
+
+// SIMD128 has 4 lanes of f32/i32, so tiles are 4 columns wide. Rows use one
+// accumulator each: with M0 = 8 that is 8 accumulators plus one RHS vector and
+// one broadcast LHS value, which fits in the 16 vector registers of x86-64
+// hosts without spilling once the engine compiles the module.
+//
+// Baseline SIMD128 has no fused multiply-add (that is in relaxed-simd), so the
+// f32 kernel uses separate multiplies and adds.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_f32f32f32_1x4x1_to_8x4x1_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  v128_t acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = wasm_v128_load(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = wasm_f32x4_const_splat(0.0f);
+    }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    v128_t rhs = wasm_v128_load(rhs_ptr);
+    rhs_ptr += 4;
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      v128_t lhs = wasm_v128_load32_splat(lhs_ptr + i);
+      acc[i] = wasm_f32x4_add(acc[i], wasm_f32x4_mul(lhs, rhs));
+    }
+    lhs_ptr += M0;
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    wasm_v128_store(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x4x1_to_8x4x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_1x4x1_wasm_32_simd128, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x4x1_to_8x4x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_2x4x1_wasm_32_simd128, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x4x1_to_8x4x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_4x4x1_wasm_32_simd128, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_f32f32f32_1x4x1_to_8x4x1_wasm_32_simd128,
+    iree_uk_mmt4d_tile_f32f32f32_8x4x1_wasm_32_simd128, 8)
+
+// The s8 kernel sign-extends to 16 bits and uses i32x4.dot_i16x8_s, which
+// multiplies pairs of adjacent 16-bit lanes and adds each pair into a 32-bit
+// lane. With K0 = 2, one pair is one (n, k0..1) RHS column, so each LHS row
+// contributes its two K values broadcast to all 4 lanes.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_tile_s8s8s32_1x4x2_to_8x4x2_wasm_32_simd128(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int8_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile;
+  v128_t acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = wasm_v128_load(out_ptr + 4 * i);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = wasm_i32x4_const_splat(0);
+    }
+  }
+  for (int k = 0; k < params->K; ++k) {
+    // 4x2 RHS tile: 8 bytes, widened to 8 i16 lanes.
+    v128_t rhs = wasm_i16x8_load8x8(rhs_ptr);
+    rhs_ptr += 8;
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      // Both K values of LHS row i widened to i16 and packed into one i32,
+      // then broadcast to all lanes.
+      iree_uk_uint32_t lhs_pair =
+          (iree_uk_uint16_t)(iree_uk_int16_t)lhs_ptr[2 * i] |
+          ((iree_uk_uint32_t)(iree_uk_uint16_t)(iree_uk_int16_t)
+               lhs_ptr[2 * i + 1]
+           << 16);
+      v128_t lhs = wasm_i32x4_splat((iree_uk_int32_t)lhs_pair);
+      acc[i] = wasm_i32x4_add(acc[i], wasm_i32x4_dot_i16x8(lhs, rhs));
+    }
+    lhs_ptr += 2 * M0;
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    wasm_v128_store(out_ptr + 4 * i, acc[i]);
+  }
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x4x2_to_8x4x2_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_1x4x2_wasm_32_simd128, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x4x2_to_8x4x2_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_2x4x2_wasm_32_simd128, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x4x2_to_8x4x2_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_4x4x2_wasm_32_simd128, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x4x2_to_8x4x2_wasm_32_simd128,
+    iree_uk_mmt4d_tile_s8s8s32_8x4x2_wasm_32_simd128, 8)
+
+#endif  // defined(IREE_UK_BUILD_WASM_32_SIMD128)
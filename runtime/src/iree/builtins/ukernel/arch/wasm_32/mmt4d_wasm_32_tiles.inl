@@ -0,0 +1,17 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Ordering matters when multiple lines have the same types and tile shape and
+// are supported by the CPU. In that case, the last-enumerated line overrides
+// preceding lines. Always go from oldest to shiniest code path.
+IREE_UK_MMT4D_TILE(wasm_32, f32, f32, f32, 1, 4, 1, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, f32, f32, f32, 2, 4, 1, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, f32, f32, f32, 4, 4, 1, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, f32, f32, f32, 8, 4, 1, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, s8, s8, s32, 1, 4, 2, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, s8, s8, s32, 2, 4, 2, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, s8, s8, s32, 4, 4, 2, _simd128)
+IREE_UK_MMT4D_TILE(wasm_32, s8, s8, s32, 8, 4, 2, _simd128)
@@ -0,0 +1,25 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/pack_wasm_32_internal.h"
+
+iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
+    const iree_uk_pack_params_t* params) {
+#ifdef IREE_UK_BUILD_WASM_32_SIMD128
+  iree_uk_pack_type_t pack_type = iree_uk_pack_type(params->flags);
+  int esize = iree_uk_type_size(iree_uk_pack_out_type(pack_type));
+  bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+  if (esize == 4 && !transpose && params->out_size3 == 1) {
+    if (params->out_size2 == 4) {
+      return iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct;
+    } else if (params->out_size2 == 8) {
+      return iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct;
+    }
+  }
+#endif  // IREE_UK_BUILD_WASM_32_SIMD128
+  return 0;
+}
@@ -0,0 +1,16 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARCH_WASM_32_PACK_WASM_32_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ARCH_WASM_32_PACK_WASM_32_INTERNAL_H_
+
+#include "iree/builtins/ukernel/pack_internal.h"
+
+// 4x1 and 8x1 tiles of 32-bit elements, as used by the f32 matmul LHS and RHS.
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct)
+
+#endif  // IREE_BUILTINS_UKERNEL_ARCH_WASM_32_PACK_WASM_32_INTERNAL_H_
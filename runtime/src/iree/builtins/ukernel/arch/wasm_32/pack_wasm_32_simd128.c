@@ -0,0 +1,82 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/wasm_32/common_wasm_32.h"
+#include "iree/builtins/ukernel/arch/wasm_32/pack_wasm_32_internal.h"
+
+#if defined(IREE_UK_BUILD_WASM_32_SIMD128)
+
+// Packs |tile_size0|x1 tiles of 32-bit elements. Each tile is a column of the
+// input, so 4 consecutive tiles are a 4-wide slice of |tile_size0| rows: load
+// the slice 4 rows at a time and transpose it in registers so that each tile
+// is written with a single store.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t tile_size0) {
+  iree_uk_int32_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_index_t outer_i1 = 0;
+  for (; outer_i1 + 4 <= outer_size1; outer_i1 += 4) {
+    for (iree_uk_index_t i0 = 0; i0 < tile_size0; i0 += 4) {
+      v128_t r0 = wasm_v128_load(in_ptr + (i0 + 0) * in_stride0);
+      v128_t r1 = wasm_v128_load(in_ptr + (i0 + 1) * in_stride0);
+      v128_t r2 = wasm_v128_load(in_ptr + (i0 + 2) * in_stride0);
+      v128_t r3 = wasm_v128_load(in_ptr + (i0 + 3) * in_stride0);
+      v128_t t0 = wasm_i32x4_shuffle(r0, r1, 0, 4, 1, 5);
+      v128_t t1 = wasm_i32x4_shuffle(r0, r1, 2, 6, 3, 7);
+      v128_t t2 = wasm_i32x4_shuffle(r2, r3, 0, 4, 1, 5);
+      v128_t t3 = wasm_i32x4_shuffle(r2, r3, 2, 6, 3, 7);
+      wasm_v128_store(out_ptr + 0 * out_stride1 + i0,
+                      wasm_i32x4_shuffle(t0, t2, 0, 1, 4, 5));
+      wasm_v128_store(out_ptr + 1 * out_stride1 + i0,
+                      wasm_i32x4_shuffle(t0, t2, 2, 3, 6, 7));
+      wasm_v128_store(out_ptr + 2 * out_stride1 + i0,
+                      wasm_i32x4_shuffle(t1, t3, 0, 1, 4, 5));
+      wasm_v128_store(out_ptr + 3 * out_stride1 + i0,
+                      wasm_i32x4_shuffle(t1, t3, 2, 3, 6, 7));
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 4;
+  }
+  for (; outer_i1 < outer_size1; ++outer_i1) {
+    for (iree_uk_index_t i0 = 0; i0 < tile_size0; ++i0) {
+      out_ptr[i0] = in_ptr[i0 * in_stride0];
+    }
+    out_ptr += out_stride1;
+    in_ptr += 1;
+  }
+}
+
+void iree_uk_pack_tile_4x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 4);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 4);
+}
+
+void iree_uk_pack_tile_8x1_x32_wasm_32_simd128_direct(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 8);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_pack_tile_Nx1_x32_wasm_32_simd128_direct(
+      out_tile_ptr, in_tile_ptr, outer_size1, out_stride1, in_stride0, 8);
+}
+
+#endif  // defined(IREE_UK_BUILD_WASM_32_SIMD128)
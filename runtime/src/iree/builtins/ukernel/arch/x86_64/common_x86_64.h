@@ -18,6 +18,7 @@
 #define IREE_UK_BUILD_X86_64_AVX512_BASE
 #define IREE_UK_BUILD_X86_64_AVX512_VNNI
 #define IREE_UK_BUILD_X86_64_AVX512_BF16
+#define IREE_UK_BUILD_X86_64_AMX
 #else  // IREE_DEVICE_STANDALONE
 // Compiling with the system toolchain. Include the configured header.
 #include "iree/builtins/ukernel/arch/x86_64/config_x86_64.h"
@@ -52,6 +53,13 @@ static inline bool iree_uk_cpu_x86_64_avx512_bf16(
          iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AVX512BF16);
 }
 
+static inline bool iree_uk_cpu_x86_64_amx(const iree_uk_uint64_t* cpu_data) {
+  return iree_uk_cpu_x86_64_avx512_base(cpu_data) &&
+         iree_uk_all_bits_set(cpu_data[0], IREE_CPU_DATA0_X86_64_AMXTILE |
+                                               IREE_CPU_DATA0_X86_64_AMXINT8 |
+                                               IREE_CPU_DATA0_X86_64_AMXBF16);
+}
+
 #if defined(__AVX2__)
 
 static inline __m256i iree_uk_avx_loadu_2x128(const void* src0,
@@ -295,6 +303,15 @@ static inline void iree_uk_avx512_storeu_4x128(void* dst0, void* dst1,
   _mm_storeu_si128((__m128i*)dst3, v128_3);
 }
 
+// Copies 64 bytes with a non-temporal (streaming) store, bypassing the caches.
+// `out_ptr` must be 64-byte aligned. Streaming stores are weakly ordered: an
+// _mm_sfence() is needed before other threads may consume the written data.
+static inline void iree_uk_avx512_stream_64xi8(void* out_ptr,
+                                               const void* in_ptr) {
+  _mm512_stream_si512((__m512i*)out_ptr,
+                      _mm512_loadu_si512((const __m512i*)in_ptr));
+}
+
 static inline __m512i iree_uk_avx512_loadu_4x128_from_16x16xi32(
     const iree_uk_int32_t* src, int i0, int j0, int i1, int j1, int i2, int j2,
     int i3, int j3) {
@@ -0,0 +1,200 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_internal.h"
+
+// Tile kernels using AMX tile matrix multiplication (Intel Sapphire Rapids and
+// newer). Both the s8s8s32 (K0=4) and bf16bf16f32 (K0=2) tiles have 32 bits of
+// LHS/RHS data per K0 group, so they share the same code, differing only in
+// the TDP* instruction. One tile instruction consumes 16 K-steps:
+//   * The RHS layout for 16 consecutive K-steps (16 rows of N0=16 x 32 bits)
+//     is exactly the "VNNI" layout expected for AMX B tiles, so it is loaded
+//     directly from the panel.
+//   * AMX A tiles need K contiguous along each row, so the LHS for 16 K-steps
+//     (16 rows of M0 x 32 bits) is transposed into a M0 x 16 x 32 bit buffer.
+// The last K % 16 steps are staged into zero-padded buffers.
+
+// Tile configuration loaded with LDTILECFG, see the Intel SDM, section
+// "Intel AMX Instruction Set Reference": palette 1 has 8 tiles of up to 16 rows
+// of 64 bytes.
+typedef struct iree_uk_amx_tilecfg_t {
+  iree_uk_uint8_t palette_id;
+  iree_uk_uint8_t start_row;
+  iree_uk_uint8_t reserved[14];
+  iree_uk_uint16_t colsb[16];
+  iree_uk_uint8_t rows[16];
+} iree_uk_amx_tilecfg_t;
+
+// Tile registers used by the kernels below.
+#define IREE_UK_AMX_TILE_ACC 0
+#define IREE_UK_AMX_TILE_LHS 1
+#define IREE_UK_AMX_TILE_RHS 2
+
+// Transposes the |k_count| <= 16 K-steps of |M0| 32-bit values at |in| into
+// |M0| rows of 16 32-bit values at |out|. Rows past |k_count| are zero-filled.
+static inline void iree_uk_amx_transpose_lhs_16xM0_x32(
+    iree_uk_int32_t* IREE_UK_RESTRICT out,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in, int M0, int k_count) {
+  if (M0 == 1) {
+    __mmask16 mask = (__mmask16)((1u << k_count) - 1);
+    _mm512_store_si512((__m512i*)out, _mm512_maskz_loadu_epi32(mask, in));
+    return;
+  }
+  __mmask16 mask = (__mmask16)((1u << M0) - 1);
+  __m512i r[16];
+  IREE_UK_UNROLL for (int i = 0; i < 16; ++i) {
+    r[i] = i < k_count ? _mm512_maskz_loadu_epi32(mask, in + i * M0)
+                       : _mm512_setzero_si512();
+  }
+  // Standard 16x16 32-bit transpose. After the 2 unpack steps, 128-bit lane l
+  // of t[4 * i + j] holds column 4 * l + j of rows 4 * i ... 4 * i + 3.
+  __m512i t[16];
+  IREE_UK_UNROLL for (int i = 0; i < 8; ++i) {
+    t[2 * i + 0] = _mm512_unpacklo_epi32(r[2 * i], r[2 * i + 1]);
+    t[2 * i + 1] = _mm512_unpackhi_epi32(r[2 * i], r[2 * i + 1]);
+  }
+  IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+    r[4 * i + 0] = _mm512_unpacklo_epi64(t[4 * i + 0], t[4 * i + 2]);
+    r[4 * i + 1] = _mm512_unpackhi_epi64(t[4 * i + 0], t[4 * i + 2]);
+    r[4 * i + 2] = _mm512_unpacklo_epi64(t[4 * i + 1], t[4 * i + 3]);
+    r[4 * i + 3] = _mm512_unpackhi_epi64(t[4 * i + 1], t[4 * i + 3]);
+  }
+  IREE_UK_UNROLL for (int j = 0; j < 4; ++j) {
+    t[4 * j + 0] = _mm512_shuffle_i32x4(r[j], r[4 + j], 0x44);
+    t[4 * j + 1] = _mm512_shuffle_i32x4(r[j], r[4 + j], 0xEE);
+    t[4 * j + 2] = _mm512_shuffle_i32x4(r[8 + j], r[12 + j], 0x44);
+    t[4 * j + 3] = _mm512_shuffle_i32x4(r[8 + j], r[12 + j], 0xEE);
+  }
+  IREE_UK_UNROLL for (int j = 0; j < 4; ++j) {
+    r[j + 0] = _mm512_shuffle_i32x4(t[4 * j + 0], t[4 * j + 2], 0x88);
+    r[j + 4] = _mm512_shuffle_i32x4(t[4 * j + 0], t[4 * j + 2], 0xDD);
+    r[j + 8] = _mm512_shuffle_i32x4(t[4 * j + 1], t[4 * j + 3], 0x88);
+    r[j + 12] = _mm512_shuffle_i32x4(t[4 * j + 1], t[4 * j + 3], 0xDD);
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm512_store_si512((__m512i*)(out + i * 16), r[i]);
+  }
+}
+
+// Copies the |k_count| < 16 K-steps of 16 32-bit values at |in| to |out|,
+// zero-filling the remaining rows.
+static inline void iree_uk_amx_copy_rhs_tail_16x16_x32(
+    iree_uk_int32_t* IREE_UK_RESTRICT out,
+    const iree_uk_int32_t* IREE_UK_RESTRICT in, int k_count) {
+  for (int i = 0; i < 16; ++i) {
+    __m512i row = i < k_count
+                      ? _mm512_loadu_si512((const __m512i*)(in + i * 16))
+                      : _mm512_setzero_si512();
+    _mm512_store_si512((__m512i*)(out + i * 16), row);
+  }
+}
+
+static inline void iree_uk_mmt4d_tile_x32_1x16xX_to_16x16xX_x86_64_amx(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, iree_uk_mmt4d_type_t mmt4d_type,
+    int M0) {
+  IREE_UK_ASSERT(mmt4d_type == iree_uk_mmt4d_type_s8s8s32 ||
+                 mmt4d_type == iree_uk_mmt4d_type_bf16bf16f32);
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  const iree_uk_int32_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_int32_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_int32_t lhs_buf[16 * 16];
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_int32_t rhs_buf[16 * 16];
+
+  iree_uk_amx_tilecfg_t config = {0};
+  config.palette_id = 1;
+  config.rows[IREE_UK_AMX_TILE_ACC] = M0;
+  config.colsb[IREE_UK_AMX_TILE_ACC] = 64;
+  config.rows[IREE_UK_AMX_TILE_LHS] = M0;
+  config.colsb[IREE_UK_AMX_TILE_LHS] = 64;
+  config.rows[IREE_UK_AMX_TILE_RHS] = 16;
+  config.colsb[IREE_UK_AMX_TILE_RHS] = 64;
+  _tile_loadconfig(&config);
+
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    _tile_loadd(IREE_UK_AMX_TILE_ACC, out_tile, 64);
+  } else {
+    _tile_zero(IREE_UK_AMX_TILE_ACC);
+  }
+
+  for (iree_uk_index_t k = 0; k < params->K; k += 16) {
+    int k_count = (int)iree_uk_index_min(16, params->K - k);
+    iree_uk_amx_transpose_lhs_16xM0_x32(lhs_buf, lhs_ptr, M0, k_count);
+    _tile_loadd(IREE_UK_AMX_TILE_LHS, lhs_buf, 64);
+    if (k_count == 16) {
+      _tile_loadd(IREE_UK_AMX_TILE_RHS, rhs_ptr, 64);
+    } else {
+      iree_uk_amx_copy_rhs_tail_16x16_x32(rhs_buf, rhs_ptr, k_count);
+      _tile_loadd(IREE_UK_AMX_TILE_RHS, rhs_buf, 64);
+    }
+    if (mmt4d_type == iree_uk_mmt4d_type_s8s8s32) {
+      _tile_dpbssd(IREE_UK_AMX_TILE_ACC, IREE_UK_AMX_TILE_LHS,
+                   IREE_UK_AMX_TILE_RHS);
+    } else {
+      _tile_dpbf16ps(IREE_UK_AMX_TILE_ACC, IREE_UK_AMX_TILE_LHS,
+                     IREE_UK_AMX_TILE_RHS);
+    }
+    lhs_ptr += 16 * M0;
+    rhs_ptr += 16 * 16;
+  }
+
+  _tile_stored(IREE_UK_AMX_TILE_ACC, out_tile, 64);
+  // Release the tile state so that it does not need to be saved and restored
+  // on context switches between kernel invocations.
+  _tile_release();
+}
+
+static inline void iree_uk_mmt4d_tile_s8s8s32_1x16x4_to_16x16x4_x86_64_amx(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_tile_x32_1x16xX_to_16x16xX_x86_64_amx(
+      out_tile, lhs_panel, rhs_panel, params, iree_uk_mmt4d_type_s8s8s32, M0);
+}
+
+static inline void
+iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_to_16x16x2_x86_64_amx(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_tile_x32_1x16xX_to_16x16xX_x86_64_amx(
+      out_tile, lhs_panel, rhs_panel, params, iree_uk_mmt4d_type_bf16bf16f32,
+      M0);
+}
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x4_to_16x16x4_x86_64_amx,
+    iree_uk_mmt4d_tile_s8s8s32_1x16x4_x86_64_amx, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x4_to_16x16x4_x86_64_amx,
+    iree_uk_mmt4d_tile_s8s8s32_2x16x4_x86_64_amx, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x4_to_16x16x4_x86_64_amx,
+    iree_uk_mmt4d_tile_s8s8s32_4x16x4_x86_64_amx, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x4_to_16x16x4_x86_64_amx,
+    iree_uk_mmt4d_tile_s8s8s32_8x16x4_x86_64_amx, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_s8s8s32_1x16x4_to_16x16x4_x86_64_amx,
+    iree_uk_mmt4d_tile_s8s8s32_16x16x4_x86_64_amx, 16)
+
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_to_16x16x2_x86_64_amx,
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_x86_64_amx, 1)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_to_16x16x2_x86_64_amx,
+    iree_uk_mmt4d_tile_bf16bf16f32_2x16x2_x86_64_amx, 2)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_to_16x16x2_x86_64_amx,
+    iree_uk_mmt4d_tile_bf16bf16f32_4x16x2_x86_64_amx, 4)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_to_16x16x2_x86_64_amx,
+    iree_uk_mmt4d_tile_bf16bf16f32_8x16x2_x86_64_amx, 8)
+IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_tile_bf16bf16f32_1x16x2_to_16x16x2_x86_64_amx,
+    iree_uk_mmt4d_tile_bf16bf16f32_16x16x2_x86_64_amx, 16)
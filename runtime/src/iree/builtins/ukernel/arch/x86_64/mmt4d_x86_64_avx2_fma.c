@@ -39,9 +39,42 @@ iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_x86_64_avx2_fma(
   }
 }
 
-IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
-    iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_x86_64_avx2_fma,
-    iree_uk_mmt4d_tile_f32f32f32_1x8x1_x86_64_avx2_fma, 1)
+// Dedicated matrix-vector kernel for M0 == 1, see the comment on the
+// avx512_base one: the K loop is unrolled into 4 independent accumulators so
+// that it is not bound by FMA latency.
+void iree_uk_mmt4d_tile_f32f32f32_1x8x1_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  __m256 acc[4];
+  acc[0] = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+               ? _mm256_loadu_ps(out_ptr)
+               : _mm256_setzero_ps();
+  IREE_UK_UNROLL for (int i = 1; i < 4; ++i) {
+    acc[i] = _mm256_set1_ps(-0.0f);
+  }
+  int k = 0;
+  for (; k + 4 <= params->K; k += 4) {
+    IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+      acc[i] = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_ptr + i),
+                               _mm256_loadu_ps(rhs_ptr + 8 * i), acc[i]);
+    }
+    rhs_ptr += 32;
+    lhs_ptr += 4;
+  }
+  for (; k < params->K; ++k) {
+    acc[0] = _mm256_fmadd_ps(_mm256_broadcast_ss(lhs_ptr),
+                             _mm256_loadu_ps(rhs_ptr), acc[0]);
+    rhs_ptr += 8;
+    lhs_ptr += 1;
+  }
+  _mm256_storeu_ps(out_ptr, _mm256_add_ps(_mm256_add_ps(acc[0], acc[1]),
+                                          _mm256_add_ps(acc[2], acc[3])));
+}
+
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_f32f32f32_1x8x1_to_8x8x1_x86_64_avx2_fma,
     iree_uk_mmt4d_tile_f32f32f32_2x8x1_x86_64_avx2_fma, 2)
@@ -315,3 +348,118 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s16s16s32_1x8x2_to_8x8x2_x86_64_avx2_fma,
     iree_uk_mmt4d_tile_s16s16s32_8x8x2_x86_64_avx2_fma, 8)
+
+// Broadcasts one f16 or bf16 LHS element to all lanes as f32.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline __m256
+iree_uk_avx2_fma_broadcast_xf16_to_f32(iree_uk_uint16_t value,
+                                       iree_uk_type_t type) {
+  return type == IREE_UK_TYPE_FLOAT_16
+             ? _mm256_cvtph_ps(_mm_set1_epi16(value))
+             : _mm256_castsi256_ps(_mm256_set1_epi32((iree_uk_int32_t)value
+                                                     << 16));
+}
+
+// Shared implementation for f16u4f32 and bf16u4f32. The RHS bytes hold the
+// two K0 nibbles of one N0 row, so one 8-byte load yields both k0 slices of
+// the tile once split into low and high nibbles. Each nibble is dequantized
+// as q * scale + bias with bias = -zero_point * scale, i.e. a single FMA,
+// amortized across the M0 rows of the LHS.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_xxu4f32_1x8x2_to_8x8x2_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t lhs_type, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 8 && iree_uk_is_po2_u32(M0));
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  __m256 acc[8];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm256_loadu_ps(out_ptr + i * 8);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm256_setzero_ps();
+    }
+  }
+  const __m256i nibble_mask = _mm256_set1_epi32(0xF);
+  for (int k = 0; k < params->K; k += params->group_size) {
+    __m256 scale = _mm256_loadu_ps(scales_panel);
+    __m256 bias = _mm256_fnmadd_ps(_mm256_loadu_ps(scales_panel + 8), scale,
+                                   _mm256_setzero_ps());
+    scales_panel += 16;
+    int k_end = iree_uk_index_min(params->K, k + params->group_size);
+    for (int kk = k; kk < k_end; ++kk) {
+      __m256i rhs_u8 =
+          _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)rhs_ptr));
+      rhs_ptr += 8;
+      __m256 rhs_0 = _mm256_fmadd_ps(
+          _mm256_cvtepi32_ps(_mm256_and_si256(rhs_u8, nibble_mask)), scale,
+          bias);
+      __m256 rhs_1 = _mm256_fmadd_ps(
+          _mm256_cvtepi32_ps(_mm256_srli_epi32(rhs_u8, 4)), scale, bias);
+      IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+        acc[i] = _mm256_fmadd_ps(
+            iree_uk_avx2_fma_broadcast_xf16_to_f32(lhs_ptr[2 * i], lhs_type),
+            rhs_0, acc[i]);
+        acc[i] = _mm256_fmadd_ps(
+            iree_uk_avx2_fma_broadcast_xf16_to_f32(lhs_ptr[2 * i + 1],
+                                                   lhs_type),
+            rhs_1, acc[i]);
+      }
+      lhs_ptr += 2 * M0;
+    }
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm256_storeu_ps(out_ptr + i * 8, acc[i]);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_1x8x2_to_8x8x2_x86_64_avx2_fma(
+      out_tile, lhs_panel, rhs_panel, scales_panel, params,
+      IREE_UK_TYPE_FLOAT_16, M0);
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_1x8x2_to_8x8x2_x86_64_avx2_fma(
+      out_tile, lhs_panel, rhs_panel, scales_panel, params,
+      IREE_UK_TYPE_BFLOAT_16, M0);
+}
+
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_x86_64_avx2_fma, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_2x8x2_x86_64_avx2_fma, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_4x8x2_x86_64_avx2_fma, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_8x8x2_x86_64_avx2_fma, 8)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_x86_64_avx2_fma, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_2x8x2_x86_64_avx2_fma, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_4x8x2_x86_64_avx2_fma, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x8x2_to_8x8x2_x86_64_avx2_fma,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_8x8x2_x86_64_avx2_fma, 8)
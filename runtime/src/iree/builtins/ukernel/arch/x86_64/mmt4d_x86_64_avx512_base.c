@@ -50,9 +50,47 @@ iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_16x16x1_x86_64_avx512_base(
   }
 }
 
-IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
-    iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_16x16x1_x86_64_avx512_base,
-    iree_uk_mmt4d_tile_f32f32f32_1x16x1_x86_64_avx512_base, 1)
+// Dedicated matrix-vector kernel for M0 == 1. With a single LHS row, the
+// kernel above would carry a single accumulator through the whole K loop,
+// making it bound by FMA latency instead of by the bandwidth of streaming the
+// RHS panel. Here the K loop is unrolled into 4 independent accumulators.
+// They are initialized to -0.0f, the additive identity preserving the sign of
+// an accumulated zero.
+void iree_uk_mmt4d_tile_f32f32f32_1x16x1_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const iree_uk_mmt4d_params_t* params) {
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  const float* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const float* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  _mm_prefetch((const char*)rhs_ptr, _MM_HINT_T0);
+  __m512 acc[4];
+  acc[0] = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+               ? _mm512_loadu_ps(out_ptr)
+               : _mm512_setzero_ps();
+  IREE_UK_UNROLL for (int i = 1; i < 4; ++i) {
+    acc[i] = _mm512_set1_ps(-0.0f);
+  }
+  int k = 0;
+  for (; k + 4 <= params->K; k += 4) {
+    IREE_UK_UNROLL for (int i = 0; i < 4; ++i) {
+      _mm_prefetch((const char*)(rhs_ptr + 128 + 16 * i), _MM_HINT_T0);
+      acc[i] = _mm512_fmadd_ps(_mm512_loadu_ps(rhs_ptr + 16 * i),
+                               _mm512_set1_ps(lhs_ptr[i]), acc[i]);
+    }
+    rhs_ptr += 64;
+    lhs_ptr += 4;
+  }
+  for (; k < params->K; ++k) {
+    acc[0] = _mm512_fmadd_ps(_mm512_loadu_ps(rhs_ptr),
+                             _mm512_set1_ps(*lhs_ptr), acc[0]);
+    rhs_ptr += 16;
+    lhs_ptr += 1;
+  }
+  _mm512_storeu_ps(out_ptr, _mm512_add_ps(_mm512_add_ps(acc[0], acc[1]),
+                                          _mm512_add_ps(acc[2], acc[3])));
+}
+
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_f32f32f32_1x16x1_to_16x16x1_x86_64_avx512_base,
     iree_uk_mmt4d_tile_f32f32f32_2x16x1_x86_64_avx512_base, 2)
@@ -360,3 +398,125 @@ IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
 IREE_UK_MMT4D_TILE_FUNC_IMPL_FOR_M0(
     iree_uk_mmt4d_tile_s16s16s32_1x16x2_to_16x16x2_x86_64_avx512_base,
     iree_uk_mmt4d_tile_s16s16s32_16x16x2_x86_64_avx512_base, 16)
+
+// Broadcasts one f16 or bf16 LHS element to all lanes as f32.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline __m512
+iree_uk_avx512_base_broadcast_xf16_to_f32(iree_uk_uint16_t value,
+                                          iree_uk_type_t type) {
+  return type == IREE_UK_TYPE_FLOAT_16
+             ? _mm512_cvtph_ps(_mm256_set1_epi16(value))
+             : _mm512_castsi512_ps(_mm512_set1_epi32((iree_uk_int32_t)value
+                                                     << 16));
+}
+
+// Shared implementation for f16u4f32 and bf16u4f32, see the avx2_fma variant
+// for the data layout. Here a 16-byte load covers the 16 RHS rows of a k-step.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_xxu4f32_1x16x2_to_16x16x2_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t lhs_type, int M0) {
+  IREE_UK_ASSERT(M0 >= 1 && M0 <= 16 && iree_uk_is_po2_u32(M0));
+  const iree_uk_uint16_t* IREE_UK_RESTRICT lhs_ptr = lhs_panel;
+  const iree_uk_uint8_t* IREE_UK_RESTRICT rhs_ptr = rhs_panel;
+  float* IREE_UK_RESTRICT out_ptr = out_tile;
+  _mm_prefetch((const char*)lhs_ptr, _MM_HINT_T0);
+  _mm_prefetch((const char*)rhs_ptr, _MM_HINT_T0);
+  __m512 acc[16];
+  if (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_loadu_ps(out_ptr + i * 16);
+    }
+  } else {
+    IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+      acc[i] = _mm512_setzero_ps();
+    }
+  }
+  const __m512i nibble_mask = _mm512_set1_epi32(0xF);
+  for (int k = 0; k < params->K; k += params->group_size) {
+    __m512 scale = _mm512_loadu_ps(scales_panel);
+    __m512 bias = _mm512_fnmadd_ps(_mm512_loadu_ps(scales_panel + 16), scale,
+                                   _mm512_setzero_ps());
+    scales_panel += 32;
+    int k_end = iree_uk_index_min(params->K, k + params->group_size);
+    for (int kk = k; kk < k_end; ++kk) {
+      __m512i rhs_u8 =
+          _mm512_cvtepu8_epi32(_mm_loadu_si128((const __m128i*)rhs_ptr));
+      _mm_prefetch((const char*)(rhs_ptr + 256), _MM_HINT_T0);
+      rhs_ptr += 16;
+      __m512 rhs_0 = _mm512_fmadd_ps(
+          _mm512_cvtepi32_ps(_mm512_and_si512(rhs_u8, nibble_mask)), scale,
+          bias);
+      __m512 rhs_1 = _mm512_fmadd_ps(
+          _mm512_cvtepi32_ps(_mm512_srli_epi32(rhs_u8, 4)), scale, bias);
+      IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+        acc[i] = _mm512_fmadd_ps(
+            iree_uk_avx512_base_broadcast_xf16_to_f32(lhs_ptr[2 * i],
+                                                      lhs_type),
+            rhs_0, acc[i]);
+        acc[i] = _mm512_fmadd_ps(
+            iree_uk_avx512_base_broadcast_xf16_to_f32(lhs_ptr[2 * i + 1],
+                                                      lhs_type),
+            rhs_1, acc[i]);
+      }
+      lhs_ptr += 2 * M0;
+    }
+  }
+  IREE_UK_UNROLL for (int i = 0; i < M0; ++i) {
+    _mm512_storeu_ps(out_ptr + i * 16, acc[i]);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_1x16x2_to_16x16x2_x86_64_avx512_base(
+      out_tile, lhs_panel, rhs_panel, scales_panel, params,
+      IREE_UK_TYPE_FLOAT_16, M0);
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params, int M0) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_1x16x2_to_16x16x2_x86_64_avx512_base(
+      out_tile, lhs_panel, rhs_panel, scales_panel, params,
+      IREE_UK_TYPE_BFLOAT_16, M0);
+}
+
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_x86_64_avx512_base, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_2x16x2_x86_64_avx512_base, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_4x16x2_x86_64_avx512_base, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_8x16x2_x86_64_avx512_base, 8)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_f16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_f16u4f32_16x16x2_x86_64_avx512_base, 16)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_x86_64_avx512_base, 1)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_2x16x2_x86_64_avx512_base, 2)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_4x16x2_x86_64_avx512_base, 4)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_8x16x2_x86_64_avx512_base, 8)
+IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_1x16x2_to_16x16x2_x86_64_avx512_base,
+    iree_uk_mmt4d_dequant_tile_bf16u4f32_16x16x2_x86_64_avx512_base, 16)
@@ -17,4 +17,12 @@
 
 #undef IREE_UK_MMT4D_TILE
 
+#define IREE_UK_MMT4D_DEQUANT_TILE(ARCH, LHS, RHS, OUT, M0, N0, K0, SUFFIX) \
+  IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(                                     \
+      iree_uk_mmt4d_dequant_tile_##LHS##RHS##OUT##_##M0##x##N0##x##K0##_##ARCH##SUFFIX)
+
+#include "iree/builtins/ukernel/arch/x86_64/mmt4d_x86_64_dequant_tiles.inl"
+
+#undef IREE_UK_MMT4D_DEQUANT_TILE
+
 #endif  // IREE_BUILTINS_UKERNEL_ARCH_X86_64_MMT4D_X86_64_INTERNAL_H_
@@ -73,3 +73,13 @@ IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 4, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 8, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, s16, s32, 16, 16, 2, _avx512_vnni)
 IREE_UK_MMT4D_TILE(x86_64, s16, u4, s32, 1, 32, 8, _avx512_vnni)
+IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 1, 16, 4, _amx)
+IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 2, 16, 4, _amx)
+IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 4, 16, 4, _amx)
+IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 8, 16, 4, _amx)
+IREE_UK_MMT4D_TILE(x86_64, s8, s8, s32, 16, 16, 4, _amx)
+IREE_UK_MMT4D_TILE(x86_64, bf16, bf16, f32, 1, 16, 2, _amx)
+IREE_UK_MMT4D_TILE(x86_64, bf16, bf16, f32, 2, 16, 2, _amx)
+IREE_UK_MMT4D_TILE(x86_64, bf16, bf16, f32, 4, 16, 2, _amx)
+IREE_UK_MMT4D_TILE(x86_64, bf16, bf16, f32, 8, 16, 2, _amx)
+IREE_UK_MMT4D_TILE(x86_64, bf16, bf16, f32, 16, 16, 2, _amx)
@@ -26,6 +26,28 @@ void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct(
   }
 }
 
+void iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 16; ++i) {
+      iree_uk_avx512_stream_64xi8(out_ptr + i * 64,
+                                  in_ptr + i * 4 * in_stride0);
+    }
+    out_ptr += 4 * out_stride1;
+    in_ptr += 64;
+  }
+  _mm_sfence();
+}
+
 static void iree_uk_pack_tile_16x4_x8_x86_64_avx512_base_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -65,6 +87,38 @@ void iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_direct(
       1, 16, 4);
 }
 
+void iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_direct_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 1);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  // Transpose 4 tiles at a time into a local buffer that stays in L1, then
+  // stream it out.
+  IREE_UK_ATTRIBUTE_ALIGNED(64) iree_uk_int8_t tmp[4 * 64];
+  for (; outer_size1 >= 4; outer_size1 -= 4) {
+    iree_uk_avx512_copy_16x16xi8_tiled_1x4_transpose_strided_to_strided(
+        tmp, in_ptr, 64, 4 * in_stride0);
+    for (int i = 0; i < 4; ++i) {
+      iree_uk_avx512_stream_64xi8(out_ptr + i * 4 * out_stride1, tmp + i * 64);
+    }
+    out_ptr += 16 * out_stride1;
+    in_ptr += 16;
+  }
+  for (; outer_size1 > 0; --outer_size1) {
+    __m512i in = iree_uk_avx512_load_16x4xi8_strided(in_ptr, 4 * in_stride0);
+    _mm512_stream_si512((__m512i*)out_ptr, in);
+    out_ptr += 4 * out_stride1;
+    in_ptr += 4;
+  }
+  _mm_sfence();
+}
+
 void iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -83,6 +137,25 @@ void iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose(
   }
 }
 
+void iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride1, iree_uk_index_t in_stride0,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 1);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  const iree_uk_int32_t* IREE_UK_RESTRICT in_tile_ptr_i32 = in_tile_ptr;
+  iree_uk_int32_t* IREE_UK_RESTRICT out_tile_i32_ptr = out_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    iree_uk_avx512_stream_64xi8(out_tile_i32_ptr, in_tile_ptr_i32);
+    out_tile_i32_ptr += out_stride1;
+    in_tile_ptr_i32 += 16;
+  }
+  _mm_sfence();
+}
+
 void iree_uk_pack_tile_16x2_x8_x86_64_avx512_base_direct(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
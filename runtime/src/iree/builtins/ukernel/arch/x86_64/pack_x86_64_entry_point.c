@@ -7,6 +7,19 @@
 #include "iree/builtins/ukernel/arch/x86_64/common_x86_64.h"
 #include "iree/builtins/ukernel/arch/x86_64/pack_x86_64_internal.h"
 
+// Returns true if tile functions writing the output with _mm512_stream_si512
+// should be selected: the output must be large enough, and every 64-byte tile
+// row written must be 64-byte aligned, which holds for the 16x16 and 16x1 x32
+// tiles when the base pointer and the outer stride are.
+static bool iree_uk_pack_x86_64_use_streaming_stores(
+    const iree_uk_pack_params_t* params, int esize) {
+  if (!iree_uk_pack_prefer_streaming_stores(params)) return false;
+  const char* out_ptr =
+      (const char*)params->out_buffer + params->out_offset * esize;
+  return (((iree_uk_uint64_t)out_ptr | (params->out_stride0 * esize)) & 63) ==
+         0;
+}
+
 static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_8x8_x32(
     const iree_uk_pack_params_t* params) {
 #if defined(IREE_UK_BUILD_X86_64_AVX2_FMA)
@@ -23,8 +36,10 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x16_x32(
 #if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
   if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
-    return transpose ? 0
-                     : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
+    if (transpose) return 0;
+    return iree_uk_pack_x86_64_use_streaming_stores(params, 4)
+               ? iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_streaming
+               : iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct;
   }
 #endif
   return 0;
@@ -47,6 +62,11 @@ static iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_x86_64_16x1_x32(
 #if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
   if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
     bool transpose = params->flags & IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+    if (iree_uk_pack_x86_64_use_streaming_stores(params, 4)) {
+      return transpose
+                 ? iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose_streaming
+                 : iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_direct_streaming;
+    }
     return transpose ? iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose
                      : iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_direct;
   }
@@ -12,12 +12,18 @@
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x8_x32_x86_64_avx2_fma_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x16_x32_x86_64_avx512_base_direct_streaming)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_x86_64_avx2_fma_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x1_x32_x86_64_avx2_fma_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(
     iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_direct_streaming)
+IREE_UK_PACK_TILE_FUNC_DECL(
+    iree_uk_pack_tile_16x1_x32_x86_64_avx512_base_transpose_streaming)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x2_x8_x86_64_avx2_fma_direct)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_8x2_x8_x86_64_avx2_fma_transpose)
 IREE_UK_PACK_TILE_FUNC_DECL(iree_uk_pack_tile_16x2_x8_x86_64_avx512_base_direct)
@@ -27,6 +27,11 @@ iree_uk_query_matmul_tile_sizes_x86_64_f32f32f32(
 static iree_uk_matmul_tile_sizes_t
 iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(
     const iree_uk_query_tile_sizes_2d_params_t* params) {
+#if defined(IREE_UK_BUILD_X86_64_AMX)
+  if (iree_uk_cpu_x86_64_amx(params->cpu_data)) {
+    return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 4, .N = 16};
+  }
+#endif
 #if defined(IREE_UK_BUILD_X86_64_AVX512_VNNI)
   if (iree_uk_cpu_x86_64_avx512_vnni(params->cpu_data)) {
     return (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
@@ -41,6 +46,27 @@ iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(
   return (iree_uk_matmul_tile_sizes_t){.M = 8, .K = 2, .N = 4};
 }
 
+static bool iree_uk_query_matmul_tile_sizes_x86_64_bf16bf16f32(
+    const iree_uk_query_tile_sizes_2d_params_t* params,
+    iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
+#if defined(IREE_UK_BUILD_X86_64_AMX)
+  if (iree_uk_cpu_x86_64_amx(params->cpu_data)) {
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
+    return true;
+  }
+#endif
+#if defined(IREE_UK_BUILD_X86_64_AVX512_BF16)
+  if (iree_uk_cpu_x86_64_avx512_bf16(params->cpu_data)) {
+    *out_matmul_tile_sizes =
+        (iree_uk_matmul_tile_sizes_t){.M = 16, .K = 2, .N = 16};
+    return true;
+  }
+#endif
+  // No fast path, use the generic tile sizes.
+  return false;
+}
+
 bool iree_uk_query_matmul_tile_sizes_arch(
     const iree_uk_query_tile_sizes_2d_params_t* params,
     iree_uk_matmul_tile_sizes_t* out_matmul_tile_sizes) {
@@ -53,6 +79,9 @@ bool iree_uk_query_matmul_tile_sizes_arch(
     *out_matmul_tile_sizes =
         iree_uk_query_matmul_tile_sizes_x86_64_i8i8i32(params);
     return true;
+  } else if (op == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32) {
+    return iree_uk_query_matmul_tile_sizes_x86_64_bf16bf16f32(
+        params, out_matmul_tile_sizes);
   } else {
     // Shouldn't happen, validated earlier.
     return false;
@@ -25,3 +25,25 @@ void iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct(
     in_ptr += 4 * in_stride1;
   }
 }
+
+void iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct_streaming(
+    void* IREE_UK_RESTRICT out_tile_ptr,
+    const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
+    iree_uk_index_t out_stride0, iree_uk_index_t in_stride1,
+    iree_uk_index_t elem_size, iree_uk_index_t tile_size0,
+    iree_uk_index_t tile_size1) {
+  IREE_UK_ASSERT(elem_size == 4);
+  IREE_UK_ASSERT(tile_size0 == 16);
+  IREE_UK_ASSERT(tile_size1 == 16);
+  iree_uk_int8_t* IREE_UK_RESTRICT out_ptr = out_tile_ptr;
+  const iree_uk_int8_t* IREE_UK_RESTRICT in_ptr = in_tile_ptr;
+  for (; outer_size1 > 0; --outer_size1) {
+    for (int i = 0; i < 16; ++i) {
+      iree_uk_avx512_stream_64xi8(out_ptr + i * 4 * out_stride0,
+                                  in_ptr + i * 64);
+    }
+    out_ptr += 64;
+    in_ptr += 4 * in_stride1;
+  }
+  _mm_sfence();
+}
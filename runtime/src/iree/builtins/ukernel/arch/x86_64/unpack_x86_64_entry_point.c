@@ -28,6 +28,16 @@ iree_uk_unpack_tile_func_t iree_uk_unpack_select_tile_func_arch(
   } else if (params->in_size2 == 16 && params->in_size3 == 16) {
 #if defined(IREE_UK_BUILD_X86_64_AVX512_BASE)
     if (iree_uk_cpu_x86_64_avx512_base(params->cpu_data)) {
+      // Streaming stores need every 64-byte tile row written to be 64-byte
+      // aligned, so check the base pointer and the output row stride.
+      const char* out_ptr =
+          (const char*)params->out_buffer + params->out_offset * esize;
+      bool aligned =
+          (((iree_uk_uint64_t)out_ptr | (params->out_stride0 * esize)) & 63) ==
+          0;
+      if (aligned && iree_uk_unpack_prefer_streaming_stores(params)) {
+        return iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct_streaming;
+      }
       return iree_uk_unpack_tile_16x16_x32_x86_64_avx512_base_direct;
     }
 #endif
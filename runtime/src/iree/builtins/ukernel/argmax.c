@@ -0,0 +1,148 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/argmax_internal.h"
+#include "iree/builtins/ukernel/elementwise_internal.h"
+
+static void iree_uk_argmax_validate(const iree_uk_argmax_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_ARGMAX_TYPE_MASK | IREE_UK_FLAG_ARGMAX_INDEX_I64;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_ARGMAX_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_ARGMAX_TYPE_F32 ||
+                 flags_type == IREE_UK_FLAG_ARGMAX_TYPE_F16 ||
+                 flags_type == IREE_UK_FLAG_ARGMAX_TYPE_BF16);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= 0);
+  IREE_UK_ASSERT(params->out_stride0 >= 0);
+  // i32 indices must be able to represent all the indices of a row.
+  IREE_UK_ASSERT((params->flags & IREE_UK_FLAG_ARGMAX_INDEX_I64) ||
+                 params->size1 <= IREE_UK_INT32_MAX);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_argmax_early(const iree_uk_argmax_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+// Returns the index of the first maximum of a row. Each of `lanes` partial
+// maxima tracks the first index at which it was reached, so ties between lanes
+// are resolved by taking the lowest index.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline iree_uk_index_t
+iree_uk_argmax_row(const void* in_buffer, iree_uk_index_t in_base,
+                   iree_uk_index_t size1, iree_uk_type_t type) {
+  enum { lanes = iree_uk_elementwise_lanes };
+  const iree_uk_index_t size1_main = size1 & ~(iree_uk_index_t)(lanes - 1);
+  const float neg_inf = iree_uk_f32_from_bits(0xff800000u);
+  float lane_max[lanes];
+  iree_uk_index_t lane_index[lanes];
+  for (int l = 0; l < lanes; ++l) {
+    lane_max[l] = neg_inf;
+    lane_index[l] = 0;
+  }
+  // Strict comparisons, as in the argmax linalg.generic: the first maximum of
+  // each lane wins, and NaNs never compare greater.
+  for (iree_uk_index_t j0 = 0; j0 < size1_main; j0 += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      float x = iree_uk_elementwise_load(in_buffer, in_base + j0 + l, type);
+      bool greater = x > lane_max[l];
+      lane_max[l] = greater ? x : lane_max[l];
+      lane_index[l] = greater ? j0 + l : lane_index[l];
+    }
+  }
+  float max = lane_max[0];
+  iree_uk_index_t index = lane_index[0];
+  for (int l = 1; l < lanes; ++l) {
+    if (lane_max[l] > max || (lane_max[l] == max && lane_index[l] < index)) {
+      max = lane_max[l];
+      index = lane_index[l];
+    }
+  }
+  for (iree_uk_index_t j = size1_main; j < size1; ++j) {
+    float x = iree_uk_elementwise_load(in_buffer, in_base + j, type);
+    if (x > max) {
+      max = x;
+      index = j;
+    }
+  }
+  return index;
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_argmax_impl(
+    const iree_uk_argmax_params_t* params, iree_uk_type_t type,
+    bool index_i64) {
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    iree_uk_index_t index =
+        iree_uk_argmax_row(params->in_buffer,
+                           params->in_offset + i * params->in_stride0,
+                           params->size1, type);
+    iree_uk_index_t out_index = params->out_offset + i * params->out_stride0;
+    if (index_i64) {
+      ((iree_uk_int64_t*)params->out_buffer)[out_index] = index;
+    } else {
+      ((iree_uk_int32_t*)params->out_buffer)[out_index] =
+          (iree_uk_int32_t)index;
+    }
+  }
+}
+
+#define IREE_UK_ARGMAX_IMPL_FOR_TYPE(SUFFIX, TYPE)            \
+  static void iree_uk_argmax_##SUFFIX(                        \
+      const iree_uk_argmax_params_t* params) {                \
+    if (params->flags & IREE_UK_FLAG_ARGMAX_INDEX_I64) {      \
+      iree_uk_argmax_impl(params, TYPE, /*index_i64=*/true);  \
+    } else {                                                  \
+      iree_uk_argmax_impl(params, TYPE, /*index_i64=*/false); \
+    }                                                         \
+  }
+
+IREE_UK_ARGMAX_IMPL_FOR_TYPE(f32, IREE_UK_TYPE_FLOAT_32)
+IREE_UK_ARGMAX_IMPL_FOR_TYPE(f16, IREE_UK_TYPE_FLOAT_16)
+IREE_UK_ARGMAX_IMPL_FOR_TYPE(bf16, IREE_UK_TYPE_BFLOAT_16)
+
+void iree_uk_argmax_p(const iree_uk_argmax_params_t* params) {
+  iree_uk_argmax_validate(params);
+
+  if (iree_uk_argmax_early(params)) return;
+
+  switch (iree_uk_argmax_type(params->flags)) {
+    case IREE_UK_TYPE_FLOAT_32:
+      iree_uk_argmax_f32(params);
+      break;
+    case IREE_UK_TYPE_FLOAT_16:
+      iree_uk_argmax_f16(params);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      iree_uk_argmax_bf16(params);
+      break;
+    default:
+      // Shouldn't happen, validated earlier.
+      IREE_UK_ASSERT(false);
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_argmax(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_argmax_params_t params = {
+      .in_buffer = in_buffer,
+      .in_offset = in_offset,
+      .in_stride0 = in_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .size0 = size0,
+      .size1 = size1,
+      .flags = flags,
+      .cpu_data = cpu_data,
+  };
+  iree_uk_argmax_p(&params);
+}
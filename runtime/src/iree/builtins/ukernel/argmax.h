@@ -0,0 +1,26 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ARGMAX_H_
+#define IREE_BUILTINS_UKERNEL_ARGMAX_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `argmax` microkernel, writing to out[i] the index of the maximum of row i of
+// a [size0][size1] input, as i32 or, with IREE_UK_FLAG_ARGMAX_INDEX_I64, i64.
+//
+// This has the semantics of the argmax linalg.generic starting from a -inf
+// maximum and a 0 index: the first index wins in case of ties, NaNs are
+// ignored, and a row with no element greater than -inf gets index 0. Nothing
+// is written when size1 == 0. Rows must be contiguous; `in_stride0` and
+// `out_stride0` are the row strides, in elements.
+IREE_UK_EXPORT void iree_uk_argmax(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_ARGMAX_H_
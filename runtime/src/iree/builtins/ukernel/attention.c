@@ -0,0 +1,312 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/attention_internal.h"
+
+// Block sizes. A block of query rows is processed against one block of keys at
+// a time, so that each K and V row is loaded once per block_m query rows. The
+// f32 accumulator for the [block_m][block_n] output block and the staging
+// buffers live on the stack, so these are kept small. When N > block_n, the
+// scores are recomputed for each block of output columns.
+enum {
+  iree_uk_attention_block_m = 8,
+  iree_uk_attention_block_n = 64,
+  iree_uk_attention_block_k1 = 64,
+  iree_uk_attention_block_k2 = 32,
+};
+
+// Initial value of the running maximum of a row. Any score exceeds it, and
+// exp(it - score) underflows to 0, without the NaNs that -inf would produce.
+static const float iree_uk_attention_no_max = -3.0e38f;
+
+static void iree_uk_attention_validate(
+    const iree_uk_attention_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags = IREE_UK_FLAG_ATTENTION_TYPE_MASK |
+                                    IREE_UK_FLAG_ATTENTION_CAUSAL |
+                                    IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type =
+      params->flags & IREE_UK_FLAG_ATTENTION_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_ATTENTION_TYPE_F32 ||
+                 flags_type == IREE_UK_FLAG_ATTENTION_TYPE_F16 ||
+                 flags_type == IREE_UK_FLAG_ATTENTION_TYPE_BF16);
+  IREE_UK_ASSERT(params->batch >= 0);
+  IREE_UK_ASSERT(params->M >= 0);
+  IREE_UK_ASSERT(params->K1 >= 0);
+  IREE_UK_ASSERT(params->K2 >= 0);
+  IREE_UK_ASSERT(params->N >= 0);
+  IREE_UK_ASSERT(params->q_stride0 >= 0 && params->q_stride1 >= 0);
+  IREE_UK_ASSERT(params->k_stride0 >= 0 && params->k_stride1 >= 0);
+  IREE_UK_ASSERT(params->v_stride0 >= 0 && params->v_stride1 >= 0);
+  IREE_UK_ASSERT(params->out_stride0 >= 0 && params->out_stride1 >= 0);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_attention_early(const iree_uk_attention_params_t* params) {
+  return params->batch == 0 || params->M == 0 || params->N == 0;
+}
+
+// Returns exp(x) for x <= 0, which is all that the softmax needs as scores are
+// offset by their running maximum. Ukernels can't call into libm, so this uses
+// the usual range reduction x = n * ln(2) + r, |r| <= ln(2) / 2, and a
+// degree-6 Taylor polynomial for exp(r), accurate to about 1 ulp.
+static inline float iree_uk_attention_exp_nonpositive(float x) {
+  // exp(x) is below the smallest normal float. Also catches very negative x
+  // that would overflow the exponent arithmetic below.
+  if (x < -87.0f) return 0.0f;
+  // Round to nearest, given that x <= 0.
+  iree_uk_int32_t n = (iree_uk_int32_t)(x * 1.44269504f - 0.5f);
+  // Subtract n * ln(2) in two steps (Cody-Waite) to keep r accurate.
+  float r = x - (float)n * 0.693145751953125f;
+  r = r - (float)n * 1.428606765330187e-06f;
+  float p = 1.0f / 720.0f;
+  p = p * r + 1.0f / 120.0f;
+  p = p * r + 1.0f / 24.0f;
+  p = p * r + 1.0f / 6.0f;
+  p = p * r + 0.5f;
+  p = p * r + 1.0f;
+  p = p * r + 1.0f;
+  // Scale by 2^n by building the float directly. n >= -126 here.
+  iree_uk_uint32_t scale_bits = (iree_uk_uint32_t)(n + 127) << 23;
+  float scale;
+  iree_uk_memcpy(&scale, &scale_bits, sizeof scale);
+  return p * scale;
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_attention_load(
+    const void* buffer, iree_uk_index_t index, iree_uk_type_t type) {
+  if (type == IREE_UK_TYPE_FLOAT_32) {
+    return ((const float*)buffer)[index];
+  } else if (type == IREE_UK_TYPE_FLOAT_16) {
+    return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+  } else {
+    return iree_uk_bf16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_attention_store(
+    void* buffer, iree_uk_index_t index, float value, iree_uk_type_t type) {
+  if (type == IREE_UK_TYPE_FLOAT_32) {
+    ((float*)buffer)[index] = value;
+  } else if (type == IREE_UK_TYPE_FLOAT_16) {
+    ((iree_uk_uint16_t*)buffer)[index] = iree_uk_f32_to_f16(value);
+  } else {
+    ((iree_uk_uint16_t*)buffer)[index] = iree_uk_f32_to_bf16(value);
+  }
+}
+
+// Computes rows [i0, i0 + bm) and columns [n0, n0 + bn) of the output of batch
+// `b`, with an online softmax over blocks of keys: for each block, the running
+// row maximum is updated, the previously accumulated sum and output are
+// rescaled by exp(old_max - new_max), and the new block's contribution is
+// added. The output is only divided by the sum at the end.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_attention_block(
+    const iree_uk_attention_params_t* params, iree_uk_index_t b,
+    iree_uk_index_t i0, int bm, iree_uk_index_t n0, int bn,
+    iree_uk_type_t type, bool transpose_v) {
+  enum {
+    block_m = iree_uk_attention_block_m,
+    block_n = iree_uk_attention_block_n,
+    block_k1 = iree_uk_attention_block_k1,
+    block_k2 = iree_uk_attention_block_k2,
+  };
+  const iree_uk_index_t q_base =
+      params->q_offset + b * params->q_stride0 + i0 * params->q_stride1;
+  const iree_uk_index_t k_base = params->k_offset + b * params->k_stride0;
+  const iree_uk_index_t v_base = params->v_offset + b * params->v_stride0;
+  const iree_uk_index_t out_base = params->out_offset +
+                                   b * params->out_stride0 +
+                                   i0 * params->out_stride1 + n0;
+  // Number of keys visible to each row. With a causal mask, the last query row
+  // is aligned with the last key, so row i sees keys [0, i + K2 - M].
+  iree_uk_index_t key_limit[block_m];
+  iree_uk_index_t k2_end = 0;
+  for (int r = 0; r < bm; ++r) {
+    key_limit[r] = params->K2;
+    if (params->flags & IREE_UK_FLAG_ATTENTION_CAUSAL) {
+      key_limit[r] = iree_uk_index_clamp(i0 + r + params->K2 - params->M + 1,
+                                         0, params->K2);
+    }
+    k2_end = iree_uk_index_max(k2_end, key_limit[r]);
+  }
+
+  float row_max[block_m];
+  float row_sum[block_m];
+  float acc[block_m][block_n];
+  for (int r = 0; r < block_m; ++r) {
+    row_max[r] = iree_uk_attention_no_max;
+    row_sum[r] = 0.0f;
+    for (int n = 0; n < block_n; ++n) acc[r][n] = 0.0f;
+  }
+  // Staging buffers. `q_tile` and `scores` are stored transposed, so that the
+  // innermost loop of the Q * K^T product runs over block_m contiguous rows.
+  float q_tile[block_k1][block_m];
+  float scores[block_k2][block_m];
+  float v_row[block_n];
+
+  for (iree_uk_index_t j0 = 0; j0 < k2_end; j0 += block_k2) {
+    int bk2 = iree_uk_index_min(block_k2, k2_end - j0);
+    for (int j = 0; j < bk2; ++j) {
+      for (int r = 0; r < block_m; ++r) scores[j][r] = 0.0f;
+    }
+    // scores = Q * K^T for this block of keys, in chunks of block_k1.
+    for (iree_uk_index_t k0 = 0; k0 < params->K1; k0 += block_k1) {
+      int bk1 = iree_uk_index_min(block_k1, params->K1 - k0);
+      for (int r = 0; r < block_m; ++r) {
+        for (int k = 0; k < bk1; ++k) {
+          q_tile[k][r] = r < bm ? iree_uk_attention_load(
+                                      params->q_buffer,
+                                      q_base + r * params->q_stride1 + k0 + k,
+                                      type)
+                                : 0.0f;
+        }
+      }
+      for (int j = 0; j < bk2; ++j) {
+        iree_uk_index_t k_row = k_base + (j0 + j) * params->k_stride1 + k0;
+        for (int k = 0; k < bk1; ++k) {
+          float key = iree_uk_attention_load(params->k_buffer, k_row + k, type);
+          for (int r = 0; r < block_m; ++r) scores[j][r] += q_tile[k][r] * key;
+        }
+      }
+    }
+    // Online softmax update. Masked keys get probability 0.
+    for (int r = 0; r < bm; ++r) {
+      int visible = iree_uk_index_clamp(key_limit[r] - j0, 0, bk2);
+      float new_max = row_max[r];
+      for (int j = 0; j < visible; ++j) {
+        scores[j][r] *= params->scale;
+        if (scores[j][r] > new_max) new_max = scores[j][r];
+      }
+      float sum = 0.0f;
+      for (int j = 0; j < visible; ++j) {
+        float p = iree_uk_attention_exp_nonpositive(scores[j][r] - new_max);
+        scores[j][r] = p;
+        sum += p;
+      }
+      for (int j = visible; j < bk2; ++j) scores[j][r] = 0.0f;
+      if (!visible) continue;
+      float alpha = iree_uk_attention_exp_nonpositive(row_max[r] - new_max);
+      row_sum[r] = row_sum[r] * alpha + sum;
+      row_max[r] = new_max;
+      if (alpha != 1.0f) {
+        for (int n = 0; n < bn; ++n) acc[r][n] *= alpha;
+      }
+    }
+    // acc += P * V.
+    for (int j = 0; j < bk2; ++j) {
+      for (int n = 0; n < bn; ++n) {
+        iree_uk_index_t v_index =
+            transpose_v ? v_base + (n0 + n) * params->v_stride1 + j0 + j
+                        : v_base + (j0 + j) * params->v_stride1 + n0 + n;
+        v_row[n] = iree_uk_attention_load(params->v_buffer, v_index, type);
+      }
+      for (int r = 0; r < bm; ++r) {
+        float p = scores[j][r];
+        for (int n = 0; n < bn; ++n) acc[r][n] += p * v_row[n];
+      }
+    }
+  }
+
+  // A row with no visible key gets a zero output.
+  for (int r = 0; r < bm; ++r) {
+    float inv_sum = row_sum[r] > 0.0f ? 1.0f / row_sum[r] : 0.0f;
+    for (int n = 0; n < bn; ++n) {
+      iree_uk_attention_store(params->out_buffer,
+                              out_base + r * params->out_stride1 + n,
+                              acc[r][n] * inv_sum, type);
+    }
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_attention_impl(
+    const iree_uk_attention_params_t* params, iree_uk_type_t type,
+    bool transpose_v) {
+  for (iree_uk_index_t b = 0; b < params->batch; ++b) {
+    for (iree_uk_index_t i0 = 0; i0 < params->M;
+         i0 += iree_uk_attention_block_m) {
+      int bm = iree_uk_index_min(iree_uk_attention_block_m, params->M - i0);
+      for (iree_uk_index_t n0 = 0; n0 < params->N;
+           n0 += iree_uk_attention_block_n) {
+        int bn = iree_uk_index_min(iree_uk_attention_block_n, params->N - n0);
+        iree_uk_attention_block(params, b, i0, bm, n0, bn, type, transpose_v);
+      }
+    }
+  }
+}
+
+#define IREE_UK_ATTENTION_IMPL_FOR_TYPE(SUFFIX, TYPE)              \
+  static void iree_uk_attention_##SUFFIX(                          \
+      const iree_uk_attention_params_t* params) {                  \
+    if (params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V) {      \
+      iree_uk_attention_impl(params, TYPE, /*transpose_v=*/true);  \
+    } else {                                                       \
+      iree_uk_attention_impl(params, TYPE, /*transpose_v=*/false); \
+    }                                                              \
+  }
+
+IREE_UK_ATTENTION_IMPL_FOR_TYPE(f32, IREE_UK_TYPE_FLOAT_32)
+IREE_UK_ATTENTION_IMPL_FOR_TYPE(f16, IREE_UK_TYPE_FLOAT_16)
+IREE_UK_ATTENTION_IMPL_FOR_TYPE(bf16, IREE_UK_TYPE_BFLOAT_16)
+
+void iree_uk_attention_p(const iree_uk_attention_params_t* params) {
+  iree_uk_attention_validate(params);
+
+  if (iree_uk_attention_early(params)) return;
+
+  switch (iree_uk_attention_type(params->flags)) {
+    case IREE_UK_TYPE_FLOAT_32:
+      iree_uk_attention_f32(params);
+      break;
+    case IREE_UK_TYPE_FLOAT_16:
+      iree_uk_attention_f16(params);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      iree_uk_attention_bf16(params);
+      break;
+    default:
+      // Shouldn't happen, validated earlier.
+      IREE_UK_ASSERT(false);
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_attention(
+    const void* q_buffer, iree_uk_index_t q_offset, iree_uk_index_t q_stride0,
+    iree_uk_index_t q_stride1, const void* k_buffer, iree_uk_index_t k_offset,
+    iree_uk_index_t k_stride0, iree_uk_index_t k_stride1,
+    const void* v_buffer, iree_uk_index_t v_offset, iree_uk_index_t v_stride0,
+    iree_uk_index_t v_stride1, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t batch, iree_uk_index_t M, iree_uk_index_t K1,
+    iree_uk_index_t K2, iree_uk_index_t N, float scale, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_uk_attention_params_t params = {.q_buffer = q_buffer,
+                                       .q_offset = q_offset,
+                                       .q_stride0 = q_stride0,
+                                       .q_stride1 = q_stride1,
+                                       .k_buffer = k_buffer,
+                                       .k_offset = k_offset,
+                                       .k_stride0 = k_stride0,
+                                       .k_stride1 = k_stride1,
+                                       .v_buffer = v_buffer,
+                                       .v_offset = v_offset,
+                                       .v_stride0 = v_stride0,
+                                       .v_stride1 = v_stride1,
+                                       .out_buffer = out_buffer,
+                                       .out_offset = out_offset,
+                                       .out_stride0 = out_stride0,
+                                       .out_stride1 = out_stride1,
+                                       .batch = batch,
+                                       .M = M,
+                                       .K1 = K1,
+                                       .K2 = K2,
+                                       .N = N,
+                                       .scale = scale,
+                                       .flags = flags,
+                                       .cpu_data = cpu_data};
+  iree_uk_attention_p(&params);
+}
@@ -0,0 +1,35 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ATTENTION_H_
+#define IREE_BUILTINS_UKERNEL_ATTENTION_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `attention` microkernel, computing for each batch b:
+//
+//   out[b] = softmax(scale * q[b] * transpose(k[b])) * v[b]
+//
+// with shapes q: [batch][M][K1], k: [batch][K2][K1], v: [batch][K2][N] (or
+// [batch][N][K2] with IREE_UK_FLAG_ATTENTION_TRANSPOSE_V), out: [batch][M][N].
+//
+// The softmax is computed online, one block of keys at a time, so the full
+// [M][K2] score matrix is never materialized. The innermost dimension of each
+// buffer must be contiguous; `stride0` is the batch stride and `stride1` the
+// row stride, in elements, which allows reading directly from a KV cache that
+// is larger than the K2 rows being attended to.
+IREE_UK_EXPORT void iree_uk_attention(
+    const void* q_buffer, iree_uk_index_t q_offset, iree_uk_index_t q_stride0,
+    iree_uk_index_t q_stride1, const void* k_buffer, iree_uk_index_t k_offset,
+    iree_uk_index_t k_stride0, iree_uk_index_t k_stride1,
+    const void* v_buffer, iree_uk_index_t v_offset, iree_uk_index_t v_stride0,
+    iree_uk_index_t v_stride1, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    iree_uk_index_t batch, iree_uk_index_t M, iree_uk_index_t K1,
+    iree_uk_index_t K2, iree_uk_index_t N, float scale, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_ATTENTION_H_
@@ -0,0 +1,55 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ATTENTION_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ATTENTION_INTERNAL_H_
+
+#include "iree/builtins/ukernel/attention.h"
+
+typedef struct iree_uk_attention_params_t {
+  const void* q_buffer;
+  iree_uk_index_t q_offset;
+  iree_uk_index_t q_stride0;
+  iree_uk_index_t q_stride1;
+  const void* k_buffer;
+  iree_uk_index_t k_offset;
+  iree_uk_index_t k_stride0;
+  iree_uk_index_t k_stride1;
+  const void* v_buffer;
+  iree_uk_index_t v_offset;
+  iree_uk_index_t v_stride0;
+  iree_uk_index_t v_stride1;
+  void* out_buffer;
+  iree_uk_index_t out_offset;
+  iree_uk_index_t out_stride0;
+  iree_uk_index_t out_stride1;
+  iree_uk_index_t batch;
+  iree_uk_index_t M;
+  iree_uk_index_t K1;
+  iree_uk_index_t K2;
+  iree_uk_index_t N;
+  float scale;
+  iree_uk_uint32_t flags;
+  const iree_uk_uint64_t* cpu_data;
+} iree_uk_attention_params_t;
+
+void iree_uk_attention_p(const iree_uk_attention_params_t* params);
+
+static inline iree_uk_type_t iree_uk_attention_type(iree_uk_uint32_t flags) {
+  switch (flags & IREE_UK_FLAG_ATTENTION_TYPE_MASK) {
+    case IREE_UK_FLAG_ATTENTION_TYPE_F32:
+      return IREE_UK_TYPE_FLOAT_32;
+    case IREE_UK_FLAG_ATTENTION_TYPE_F16:
+      return IREE_UK_TYPE_FLOAT_16;
+    case IREE_UK_FLAG_ATTENTION_TYPE_BF16:
+      return IREE_UK_TYPE_BFLOAT_16;
+    default:
+      // Shouldn't happen, validated earlier.
+      return (iree_uk_type_t)0;
+  }
+}
+
+#endif  // IREE_BUILTINS_UKERNEL_ATTENTION_INTERNAL_H_
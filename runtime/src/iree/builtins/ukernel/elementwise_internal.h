@@ -0,0 +1,148 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_ELEMENTWISE_INTERNAL_H_
+#define IREE_BUILTINS_UKERNEL_ELEMENTWISE_INTERNAL_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// Helpers shared by the elementwise and row-reduction ukernels: activation,
+// argmax, norm and softmax.
+//
+// Ukernels can't call into libm, so the transcendental functions are written
+// here with plain arithmetic and selects, without data-dependent branches, so
+// that the loops calling them get auto-vectorized. Each takes a `fast`
+// argument that is a compile-time constant at every call site once inlined:
+// the fast variants trade accuracy for fewer operations, and implement the
+// FAST_MATH flags of these ukernels.
+
+// Number of independent partial accumulators used by row reductions. Float
+// reductions are not reassociated by the compiler, so accumulating into this
+// many lanes is what allows vectorizing them.
+enum { iree_uk_elementwise_lanes = 16 };
+
+// Bit casts between f32 and u32. These use a union rather than
+// iree_uk_memcpy, whose byte loop gets in the way of vectorizing the loops
+// calling them.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_f32_from_bits(
+    iree_uk_uint32_t bits) {
+  union {
+    iree_uk_uint32_t u;
+    float f;
+  } value = {.u = bits};
+  return value.f;
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline iree_uk_uint32_t
+iree_uk_f32_to_bits(float f) {
+  union {
+    iree_uk_uint32_t u;
+    float f;
+  } value = {.f = f};
+  return value.u;
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_elementwise_load(
+    const void* buffer, iree_uk_index_t index, iree_uk_type_t type) {
+  if (type == IREE_UK_TYPE_FLOAT_32) {
+    return ((const float*)buffer)[index];
+  } else if (type == IREE_UK_TYPE_FLOAT_16) {
+    return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+  } else {
+    return iree_uk_bf16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_elementwise_store(
+    void* buffer, iree_uk_index_t index, float value, iree_uk_type_t type) {
+  if (type == IREE_UK_TYPE_FLOAT_32) {
+    ((float*)buffer)[index] = value;
+  } else if (type == IREE_UK_TYPE_FLOAT_16) {
+    ((iree_uk_uint16_t*)buffer)[index] = iree_uk_f32_to_f16(value);
+  } else {
+    ((iree_uk_uint16_t*)buffer)[index] = iree_uk_f32_to_bf16(value);
+  }
+}
+
+// Returns exp(x). Uses the range reduction x = n * ln(2) + r, |r| <= ln(2) / 2,
+// and a Taylor polynomial for exp(r): degree 6, accurate to about 2 ulp, or
+// degree 4 with `fast`, accurate to about 6e-5 relative error. Inputs are
+// clamped to [-87, 88] so that the result stays a finite normal float: exp(x)
+// for x < -87 comes out as about 1.6e-38 instead of a denormal or 0.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_exp_f32(float x,
+                                                                   bool fast) {
+  x = x < -87.0f ? -87.0f : x;
+  x = x > 88.0f ? 88.0f : x;
+  // Round x / ln(2) to an integer by adding and subtracting 1.5 * 2^23.
+  float n = (x * 1.44269504f + 12582912.0f) - 12582912.0f;
+  // Subtract n * ln(2) in two steps (Cody-Waite) to keep r accurate.
+  float r = x - n * 0.693145751953125f;
+  r = r - n * 1.428606765330187e-06f;
+  float p;
+  if (fast) {
+    p = 1.0f / 24.0f;
+  } else {
+    p = 1.0f / 720.0f;
+    p = p * r + 1.0f / 120.0f;
+    p = p * r + 1.0f / 24.0f;
+  }
+  p = p * r + 1.0f / 6.0f;
+  p = p * r + 0.5f;
+  p = p * r + 1.0f;
+  p = p * r + 1.0f;
+  // Scale by 2^n by building the float directly, -126 <= n <= 127 here.
+  iree_uk_int32_t biased_exponent = (iree_uk_int32_t)n + 127;
+  return p * iree_uk_f32_from_bits((iree_uk_uint32_t)biased_exponent << 23);
+}
+
+// Returns 1 / sqrt(x) for x > 0, by Newton-Raphson iterations from the usual
+// bit-level initial estimate, which is within 3.5% of the result. Each
+// iteration about squares the relative error: 3 iterations are accurate to a
+// few ulp, and the 2 iterations of `fast` to about 5e-6.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_rsqrt_f32(
+    float x, bool fast) {
+  float y = iree_uk_f32_from_bits(0x5f375a86u - (iree_uk_f32_to_bits(x) >> 1));
+  y = y * (1.5f - 0.5f * x * y * y);
+  y = y * (1.5f - 0.5f * x * y * y);
+  if (!fast) y = y * (1.5f - 0.5f * x * y * y);
+  return y;
+}
+
+// Returns tanh(x), accurate to about 2e-7 absolute error, or 3e-5 with `fast`.
+// Absolute rather than relative error is what matters for its use in GELU.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_tanh_f32(
+    float x, bool fast) {
+  float abs_x = x < 0.0f ? -x : x;
+  // tanh(|x|) = 1 - 2 / (exp(2|x|) + 1). exp is clamped, so this is exactly 1
+  // for large |x|.
+  float y = 1.0f - 2.0f / (iree_uk_exp_f32(2.0f * abs_x, fast) + 1.0f);
+  if (!fast) {
+    // Near 0 the above cancels out, use a Taylor polynomial instead.
+    float x2 = abs_x * abs_x;
+    float small = abs_x * (1.0f + x2 * (-1.0f / 3.0f + x2 * (2.0f / 15.0f)));
+    y = abs_x < 0.0625f ? small : y;
+  }
+  return x < 0.0f ? -y : y;
+}
+
+// Returns erf(x), using formula 7.1.26 of Abramowitz and Stegun. That is
+// accurate to 1.5e-7, which comes out as about 5e-7 absolute error in f32
+// arithmetic, or 3e-5 with `fast`.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline float iree_uk_erf_f32(float x,
+                                                                   bool fast) {
+  float abs_x = x < 0.0f ? -x : x;
+  float t = 1.0f / (1.0f + 0.3275911f * abs_x);
+  float p = 1.061405429f;
+  p = p * t - 1.453152027f;
+  p = p * t + 1.421413741f;
+  p = p * t - 0.284496736f;
+  p = p * t + 0.254829592f;
+  p = p * t;
+  float y = 1.0f - p * iree_uk_exp_f32(-abs_x * abs_x, fast);
+  return x < 0.0f ? -y : y;
+}
+
+#endif  // IREE_BUILTINS_UKERNEL_ELEMENTWISE_INTERNAL_H_
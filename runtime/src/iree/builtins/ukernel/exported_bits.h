@@ -38,7 +38,10 @@
 #define IREE_UK_FLAG_MMT4D_TYPE_S16U4S32 0x08
 #define IREE_UK_FLAG_MMT4D_TYPE_S16S8S32 0x09
 #define IREE_UK_FLAG_MMT4D_TYPE_S8S4S32 0x0A
-#define IREE_UK_FLAG_MMT4D_TYPE_END 0x0B
+// Types with a quantized RHS, only accepted by iree_uk_mmt4d_dequant.
+#define IREE_UK_FLAG_MMT4D_TYPE_F16U4F32 0x0B
+#define IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32 0x0C
+#define IREE_UK_FLAG_MMT4D_TYPE_END 0x0D
 
 // bit flags
 #define IREE_UK_FLAG_MMT4D_ACCUMULATE 0x100
@@ -105,4 +108,110 @@
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16F32 0x0500
 #define IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MATMUL_BF16BF16BF16 0x0600
 
+// NARROW_M is an optional hint that the M dimension of the matmul is known to
+// be small, e.g. 1 for a matrix-vector product. Zero means no hint. It must be
+// the same for all operand roles of a given matmul, so that the LHS and RESULT
+// tile sizes agree.
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_MASK 0xFF0000
+#define IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_SHIFT 16
+
+//===----------------------------------------------------------------------===//
+// attention
+//===----------------------------------------------------------------------===//
+
+// TYPE is the element type of all of Q, K, V and the output. Accumulation is
+// always done in f32.
+#define IREE_UK_FLAG_ATTENTION_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_ATTENTION_TYPE_NONE 0x00
+#define IREE_UK_FLAG_ATTENTION_TYPE_F32 0x01
+#define IREE_UK_FLAG_ATTENTION_TYPE_F16 0x02
+#define IREE_UK_FLAG_ATTENTION_TYPE_BF16 0x03
+
+// Bit flags.
+// CAUSAL masks out key positions after the query position, with the last query
+// row aligned with the last key row, so that a decode step (M=1) attends to the
+// whole KV cache.
+#define IREE_UK_FLAG_ATTENTION_CAUSAL 0x100
+// TRANSPOSE_V means that V is laid out as [batch][N][K2] instead of
+// [batch][K2][N].
+#define IREE_UK_FLAG_ATTENTION_TRANSPOSE_V 0x200
+
+//===----------------------------------------------------------------------===//
+// softmax
+//===----------------------------------------------------------------------===//
+
+// TYPE is the element type of both the input and the output. Computations are
+// always done in f32.
+#define IREE_UK_FLAG_SOFTMAX_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_SOFTMAX_TYPE_NONE 0x00
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F32 0x01
+#define IREE_UK_FLAG_SOFTMAX_TYPE_F16 0x02
+#define IREE_UK_FLAG_SOFTMAX_TYPE_BF16 0x03
+
+// Bit flags.
+// FAST_MATH uses a cheaper, less accurate exp approximation.
+#define IREE_UK_FLAG_SOFTMAX_FAST_MATH 0x100
+
+//===----------------------------------------------------------------------===//
+// norm
+//===----------------------------------------------------------------------===//
+
+// TYPE is the element type of the input, output, weight and bias. Computations
+// are always done in f32.
+#define IREE_UK_FLAG_NORM_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_NORM_TYPE_NONE 0x00
+#define IREE_UK_FLAG_NORM_TYPE_F32 0x01
+#define IREE_UK_FLAG_NORM_TYPE_F16 0x02
+#define IREE_UK_FLAG_NORM_TYPE_BF16 0x03
+
+// Bit flags.
+// RMS selects RMS normalization (no mean subtraction) over layer normalization.
+#define IREE_UK_FLAG_NORM_RMS 0x100
+// FAST_MATH computes the variance in a single pass and uses a cheaper rsqrt.
+#define IREE_UK_FLAG_NORM_FAST_MATH 0x200
+// HAS_WEIGHT and HAS_BIAS tell whether the weight and bias vectors are passed.
+#define IREE_UK_FLAG_NORM_HAS_WEIGHT 0x400
+#define IREE_UK_FLAG_NORM_HAS_BIAS 0x800
+
+//===----------------------------------------------------------------------===//
+// activation
+//===----------------------------------------------------------------------===//
+
+// TYPE is the element type of both the input and the output. Computations are
+// always done in f32.
+#define IREE_UK_FLAG_ACTIVATION_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_ACTIVATION_TYPE_NONE 0x00
+#define IREE_UK_FLAG_ACTIVATION_TYPE_F32 0x01
+#define IREE_UK_FLAG_ACTIVATION_TYPE_F16 0x02
+#define IREE_UK_FLAG_ACTIVATION_TYPE_BF16 0x03
+
+// OP is the activation function.
+// GELU_ERF is x * (1 + erf(x / sqrt(2))) / 2.
+// GELU_TANH is the usual tanh approximation of GELU.
+// SILU is x / (1 + exp(-x)).
+#define IREE_UK_FLAG_ACTIVATION_OP_MASK 0xFF00
+#define IREE_UK_FLAG_ACTIVATION_OP_NONE 0x0000
+#define IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF 0x0100
+#define IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH 0x0200
+#define IREE_UK_FLAG_ACTIVATION_OP_SILU 0x0300
+
+// Bit flags.
+// FAST_MATH uses cheaper, less accurate exp, erf and tanh approximations.
+#define IREE_UK_FLAG_ACTIVATION_FAST_MATH 0x10000
+
+//===----------------------------------------------------------------------===//
+// argmax
+//===----------------------------------------------------------------------===//
+
+// TYPE is the element type of the input.
+#define IREE_UK_FLAG_ARGMAX_TYPE_MASK 0xFF
+#define IREE_UK_FLAG_ARGMAX_TYPE_NONE 0x00
+#define IREE_UK_FLAG_ARGMAX_TYPE_F32 0x01
+#define IREE_UK_FLAG_ARGMAX_TYPE_F16 0x02
+#define IREE_UK_FLAG_ARGMAX_TYPE_BF16 0x03
+
+// Bit flags.
+// INDEX_I64 selects i64 output indices, the default being i32.
+#define IREE_UK_FLAG_ARGMAX_INDEX_I64 0x100
+
 #endif  // IREE_BUILTINS_UKERNEL_EXPORTED_BITS_H_
@@ -14,6 +14,16 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
   return 0;
 }
 
+iree_uk_mmt4d_loop_func_t iree_uk_mmt4d_select_loop_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+  return 0;
+}
+
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params) {
+  return 0;
+}
+
 iree_uk_pack_tile_func_t iree_uk_pack_select_tile_func_arch(
     const iree_uk_pack_params_t* params) {
   return 0;
@@ -98,6 +98,58 @@ static void iree_uk_mmt4d_using_tile_func(const iree_uk_mmt4d_params_t* params,
   }
 }
 
+// Same as iree_uk_mmt4d_using_tile_func, additionally passing to each tile
+// function the scales panel of the current N-tile.
+static void iree_uk_mmt4d_dequant_using_tile_func(
+    const iree_uk_mmt4d_params_t* params,
+    iree_uk_mmt4d_dequant_tile_func_t tile_func) {
+  const iree_uk_int32_t M = params->M;
+  const iree_uk_int32_t N = params->N;
+  const iree_uk_int16_t M0 = params->M0;
+  const iree_uk_int16_t N0 = params->N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  const iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  const iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  const iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  const iree_uk_int16_t lhs_elem_bits_log2 =
+      iree_uk_type_bit_count_log2(lhs_type);
+  const iree_uk_int16_t rhs_elem_bits_log2 =
+      iree_uk_type_bit_count_log2(rhs_type);
+  const iree_uk_int16_t out_elem_size_log2 = iree_uk_type_size_log2(out_type);
+  char* out_tile_row =
+      (char*)params->out_buffer + (params->out_offset << out_elem_size_log2);
+  const char* lhs_panel =
+      (const char*)params->lhs_buffer +
+      iree_uk_bits_to_bytes_exact(params->lhs_offset << lhs_elem_bits_log2);
+  const char* rhs_panel_start =
+      (const char*)params->rhs_buffer +
+      iree_uk_bits_to_bytes_exact(params->rhs_offset << rhs_elem_bits_log2);
+  const float* scales_panel_start =
+      (const float*)params->scales_buffer + params->scales_offset;
+  iree_uk_int32_t out_tile_size = (M0 * N0) << out_elem_size_log2;
+  iree_uk_index_t lhs_panel_stride =
+      iree_uk_bits_to_bytes_exact(params->lhs_stride0 << lhs_elem_bits_log2);
+  iree_uk_index_t rhs_panel_stride =
+      iree_uk_bits_to_bytes_exact(params->rhs_stride0 << rhs_elem_bits_log2);
+  iree_uk_index_t out_stride = params->out_stride0 << out_elem_size_log2;
+  for (iree_uk_int32_t i = 0; i < M; ++i) {
+    char* out_tile = out_tile_row;
+    const char* rhs_panel = rhs_panel_start;
+    const float* scales_panel = scales_panel_start;
+    IREE_UK_PREFETCH_RW(out_tile_row, IREE_UK_PREFETCH_LOCALITY_L3);
+    IREE_UK_PREFETCH_RO(lhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+    IREE_UK_PREFETCH_RO(rhs_panel, IREE_UK_PREFETCH_LOCALITY_L1);
+    for (iree_uk_int32_t j = 0; j < N; ++j) {
+      tile_func(out_tile, lhs_panel, rhs_panel, scales_panel, params);
+      out_tile += out_tile_size;
+      rhs_panel += rhs_panel_stride;
+      scales_panel += params->scales_stride0;
+    }
+    out_tile_row += out_stride;
+    lhs_panel += lhs_panel_stride;
+  }
+}
+
 // Early-return code paths, including trivial or near-trivial cases (when one
 // of the dimensions is 0) and in the future, hardware ports that specialize
 // the entire loop nest.
@@ -109,11 +161,19 @@ static bool iree_uk_mmt4d_early(const iree_uk_mmt4d_params_t* params) {
     return true;
   }
   // Targets that want to specialize the entire loop nest can do so here.
+  iree_uk_mmt4d_loop_func_t loop_func =
+      iree_uk_mmt4d_select_loop_func_arch(params);
+  if (loop_func) {
+    loop_func(params);
+    return true;
+  }
   return false;
 }
 
 void iree_uk_mmt4d_p(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_validate(params);
+  // Quantized-RHS types need the scales operand of iree_uk_mmt4d_dequant.
+  IREE_UK_ASSERT(!iree_uk_mmt4d_flags_is_dequant(params->flags));
 
   // Maybe handle this mmt4d "early", without needing to select a tile_func.
   // Typical cases include trivial cases (e.g. when params->K == 0) and hardware
@@ -142,12 +202,65 @@ void iree_uk_mmt4d_p(const iree_uk_mmt4d_params_t* params) {
 
 iree_uk_uint32_t iree_uk_mmt4d_info_p(const iree_uk_mmt4d_params_t* params) {
   iree_uk_uint32_t result = 0;
-  if (iree_uk_mmt4d_select_tile_func_arch(params)) {
+  bool have_arch_func =
+      iree_uk_mmt4d_flags_is_dequant(params->flags)
+          ? iree_uk_mmt4d_dequant_select_tile_func_arch(params) != 0
+          : (iree_uk_mmt4d_select_loop_func_arch(params) ||
+             iree_uk_mmt4d_select_tile_func_arch(params));
+  if (have_arch_func) {
     result |= IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION;
   }
   return result;
 }
 
+void iree_uk_mmt4d_dequant_p(const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_validate(params);
+  IREE_UK_ASSERT(iree_uk_mmt4d_flags_is_dequant(params->flags));
+  IREE_UK_ASSERT(params->group_size >= 1);
+
+  // Trivial cases. Unlike iree_uk_mmt4d_early, there is no loop_func here.
+  if (params->M == 0 || params->N == 0 ||
+      (params->K == 0 && params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)) {
+    return;
+  }
+
+  iree_uk_mmt4d_dequant_tile_func_t tile_func =
+      iree_uk_mmt4d_dequant_select_tile_func_arch(params);
+  if (!tile_func) {
+    if (params->flags &
+        IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION) {
+      tile_func = iree_uk_mmt4d_dequant_select_tile_func_generic(params);
+    } else {
+      IREE_UK_ASSERT(
+          0 && "no target-specific tile function, and fallback not enabled.");
+    }
+  }
+
+  iree_uk_mmt4d_dequant_using_tile_func(params, tile_func);
+}
+
+void iree_uk_mmt4d_grouped_p(const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_validate(params);
+  IREE_UK_ASSERT(!iree_uk_mmt4d_flags_is_dequant(params->flags));
+  IREE_UK_ASSERT(params->group_count >= 0);
+  // Each group is a plain mmt4d on a subrange of M-tiles with its own RHS. The
+  // tile function selection is repeated per group but is cheap relative to
+  // even a single tile.
+  iree_uk_mmt4d_params_t group_params = *params;
+  for (iree_uk_index_t g = 0; g < params->group_count; ++g) {
+    iree_uk_index_t m_begin = params->group_offsets[g];
+    iree_uk_index_t m_end = params->group_offsets[g + 1];
+    IREE_UK_ASSERT(0 <= m_begin && m_begin <= m_end && m_end <= params->M);
+    group_params.M = m_end - m_begin;
+    group_params.lhs_offset =
+        params->lhs_offset + m_begin * params->lhs_stride0;
+    group_params.out_offset =
+        params->out_offset + m_begin * params->out_stride0;
+    group_params.rhs_offset = params->rhs_offset + g * params->rhs_group_stride;
+    iree_uk_mmt4d_p(&group_params);
+  }
+}
+
 IREE_UK_EXPORT void iree_uk_mmt4d(
     const void* lhs_buffer, iree_uk_index_t lhs_offset,
     iree_uk_index_t lhs_stride0, const void* rhs_buffer,
@@ -176,6 +289,76 @@ IREE_UK_EXPORT void iree_uk_mmt4d(
   iree_uk_mmt4d_p(&params);
 }
 
+IREE_UK_EXPORT void iree_uk_mmt4d_dequant(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    const void* scales_buffer, iree_uk_index_t scales_offset,
+    iree_uk_index_t scales_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t M,
+    iree_uk_index_t N, iree_uk_index_t K, iree_uk_int32_t M0,
+    iree_uk_int32_t N0, iree_uk_int32_t K0, iree_uk_int32_t group_size,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_mmt4d_params_t params = {.lhs_buffer = lhs_buffer,
+                                   .lhs_offset = lhs_offset,
+                                   .lhs_stride0 = lhs_stride0,
+                                   .rhs_buffer = rhs_buffer,
+                                   .rhs_offset = rhs_offset,
+                                   .rhs_stride0 = rhs_stride0,
+                                   .out_buffer = out_buffer,
+                                   .out_offset = out_offset,
+                                   .out_stride0 = out_stride0,
+                                   .M = M,
+                                   .N = N,
+                                   .K = K,
+                                   .M0 = M0,
+                                   .N0 = N0,
+                                   .K0 = K0,
+                                   .flags = flags,
+                                   .cpu_data = cpu_data,
+                                   .scales_buffer = scales_buffer,
+                                   .scales_offset = scales_offset,
+                                   .scales_stride0 = scales_stride0,
+                                   .group_size = group_size};
+  iree_uk_mmt4d_dequant_p(&params);
+}
+
+IREE_UK_EXPORT void iree_uk_mmt4d_grouped(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    iree_uk_index_t rhs_group_stride, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0,
+    const void* group_offsets_buffer, iree_uk_index_t group_offsets_offset,
+    iree_uk_index_t group_count, iree_uk_index_t M, iree_uk_index_t N,
+    iree_uk_index_t K, iree_uk_int32_t M0, iree_uk_int32_t N0,
+    iree_uk_int32_t K0, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data) {
+  iree_uk_mmt4d_params_t params = {
+      .lhs_buffer = lhs_buffer,
+      .lhs_offset = lhs_offset,
+      .lhs_stride0 = lhs_stride0,
+      .rhs_buffer = rhs_buffer,
+      .rhs_offset = rhs_offset,
+      .rhs_stride0 = rhs_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .M = M,
+      .N = N,
+      .K = K,
+      .M0 = M0,
+      .N0 = N0,
+      .K0 = K0,
+      .flags = flags,
+      .cpu_data = cpu_data,
+      .group_offsets =
+          (const iree_uk_int32_t*)group_offsets_buffer + group_offsets_offset,
+      .group_count = group_count,
+      .rhs_group_stride = rhs_group_stride};
+  iree_uk_mmt4d_grouped_p(&params);
+}
+
 IREE_UK_EXPORT iree_uk_uint32_t
 iree_uk_mmt4d_info(iree_uk_int32_t M0, iree_uk_int32_t N0, iree_uk_int32_t K0,
                    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
@@ -20,8 +20,54 @@ IREE_UK_EXPORT void iree_uk_mmt4d(
     iree_uk_int32_t N0, iree_uk_int32_t K0, iree_uk_uint32_t flags,
     const iree_uk_uint64_t* cpu_data);
 
+// `mmt4d` variant for weight-only quantized matmuls: the RHS holds quantized
+// values that are dequantized in registers as `(rhs - zero_point) * scale`,
+// with one scale and zero point per RHS row and per group of `group_size`
+// consecutive K-tiles (i.e. `group_size * K0` reduction elements).
+//
+// The scales buffer holds f32 values. For each N-tile, at
+// `scales_offset + n * scales_stride0`, it holds one [2][N0] block (N0 scales
+// followed by N0 zero points) per group, for ceil(K / group_size) groups.
+//
+// Only accepts the IREE_UK_FLAG_MMT4D_TYPE_*U4F32 types.
+IREE_UK_EXPORT void iree_uk_mmt4d_dequant(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    const void* scales_buffer, iree_uk_index_t scales_offset,
+    iree_uk_index_t scales_stride0, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0, iree_uk_index_t M,
+    iree_uk_index_t N, iree_uk_index_t K, iree_uk_int32_t M0,
+    iree_uk_int32_t N0, iree_uk_int32_t K0, iree_uk_int32_t group_size,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
+
+// `mmt4d` variant for grouped matmuls, such as mixture-of-experts layers where
+// tokens routed to each expert are multiplied by that expert's weights. The
+// LHS and output M-tiles are partitioned into `group_count` consecutive groups
+// of varying sizes, each multiplied by its own RHS. Group `g` covers the
+// M-tiles [group_offsets[g], group_offsets[g + 1]) and uses the RHS starting at
+// `rhs_offset + g * rhs_group_stride`.
+//
+// The `group_count + 1` non-decreasing int32 group offsets are read from
+// `group_offsets_buffer` at `group_offsets_offset` when the ukernel runs so
+// that they can be produced on device by routing without a host sync. Tiles
+// outside of all groups are left untouched. `M` is the total number of LHS and
+// output M-tiles and bounds the group offsets.
+IREE_UK_EXPORT void iree_uk_mmt4d_grouped(
+    const void* lhs_buffer, iree_uk_index_t lhs_offset,
+    iree_uk_index_t lhs_stride0, const void* rhs_buffer,
+    iree_uk_index_t rhs_offset, iree_uk_index_t rhs_stride0,
+    iree_uk_index_t rhs_group_stride, void* out_buffer,
+    iree_uk_index_t out_offset, iree_uk_index_t out_stride0,
+    const void* group_offsets_buffer, iree_uk_index_t group_offsets_offset,
+    iree_uk_index_t group_count, iree_uk_index_t M, iree_uk_index_t N,
+    iree_uk_index_t K, iree_uk_int32_t M0, iree_uk_int32_t N0,
+    iree_uk_int32_t K0, iree_uk_uint32_t flags,
+    const iree_uk_uint64_t* cpu_data);
+
 // Returns a bit-field of information about how a mmt4d with the given
-// parameters would run.
+// parameters would run. Also covers iree_uk_mmt4d_dequant, selected by the
+// type in `flags`.
 IREE_UK_EXPORT iree_uk_uint32_t
 iree_uk_mmt4d_info(iree_uk_int32_t M0, iree_uk_int32_t N0, iree_uk_int32_t K0,
                    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
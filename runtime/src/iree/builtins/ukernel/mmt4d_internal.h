@@ -29,11 +29,28 @@ typedef struct iree_uk_mmt4d_params_t {
   iree_uk_int32_t K0;
   iree_uk_uint32_t flags;
   const iree_uk_uint64_t* cpu_data;
+  // Only used by iree_uk_mmt4d_dequant, zero otherwise.
+  const void* scales_buffer;
+  iree_uk_index_t scales_offset;
+  iree_uk_index_t scales_stride0;
+  iree_uk_int32_t group_size;
+  // Only used by iree_uk_mmt4d_grouped, zero otherwise. Note these groups
+  // partition M-tiles and are unrelated to the K-groups of `group_size` above.
+  const iree_uk_int32_t* group_offsets;
+  iree_uk_index_t group_count;
+  iree_uk_index_t rhs_group_stride;
 } iree_uk_mmt4d_params_t;
 
 // Same as the iree_uk_mmt4d public entry point, but taking the struct.
 void iree_uk_mmt4d_p(const iree_uk_mmt4d_params_t* params);
 
+// Same as the iree_uk_mmt4d_dequant public entry point, but taking the struct.
+void iree_uk_mmt4d_dequant_p(const iree_uk_mmt4d_params_t* params);
+
+// Same as the iree_uk_mmt4d_grouped public entry point, but taking the struct.
+// `group_offsets` points directly at the first group offset.
+void iree_uk_mmt4d_grouped_p(const iree_uk_mmt4d_params_t* params);
+
 // Same as the iree_uk_mmt4d_info public entry point, but taking the struct.
 // Only the struct fields corresponding to iree_uk_mmt4d_info parameters are
 // used.
@@ -60,6 +77,10 @@ typedef enum iree_uk_mmt4d_type_t {
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, FLOAT_32),
   iree_uk_mmt4d_type_bf16bf16bf16 =
       IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, BFLOAT_16, BFLOAT_16),
+  iree_uk_mmt4d_type_f16u4f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(FLOAT_16, UINT_4, FLOAT_32),
+  iree_uk_mmt4d_type_bf16u4f32 =
+      IREE_UK_TIE_3_TYPES_LITERAL(BFLOAT_16, UINT_4, FLOAT_32),
 } iree_uk_mmt4d_type_t;
 
 static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
@@ -84,6 +105,10 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
       return iree_uk_mmt4d_type_bf16bf16f32;
     case IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16:
       return iree_uk_mmt4d_type_bf16bf16bf16;
+    case IREE_UK_FLAG_MMT4D_TYPE_F16U4F32:
+      return iree_uk_mmt4d_type_f16u4f32;
+    case IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32:
+      return iree_uk_mmt4d_type_bf16u4f32;
     default:
       // Work around a LLVM/riscv32 miscompile. Without the unreachable here,
       // returning (iree_uk_mmt4d_type_t)0 causes this whole switch statement to
@@ -98,6 +123,14 @@ static inline iree_uk_mmt4d_type_t iree_uk_mmt4d_type(iree_uk_uint32_t flags) {
   }
 }
 
+// Returns true for the types that have a quantized RHS, which are only handled
+// by iree_uk_mmt4d_dequant.
+static inline bool iree_uk_mmt4d_flags_is_dequant(iree_uk_uint32_t flags) {
+  iree_uk_uint32_t flags_type = flags & IREE_UK_FLAG_MMT4D_TYPE_MASK;
+  return flags_type == IREE_UK_FLAG_MMT4D_TYPE_F16U4F32 ||
+         flags_type == IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32;
+}
+
 static inline iree_uk_type_t iree_uk_mmt4d_lhs_type(iree_uk_mmt4d_type_t type) {
   return iree_uk_untie_type(0, type);
 }
@@ -139,8 +172,55 @@ typedef void (*iree_uk_mmt4d_tile_func_t)(
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_arch(
     const iree_uk_mmt4d_params_t* params);
 
+// Function pointer type for functions computing the entire mmt4d loop nest.
+// Used by architectures that need to amortize some per-call setup across all
+// tiles, e.g. entering and exiting Arm SME streaming mode.
+typedef void (*iree_uk_mmt4d_loop_func_t)(
+    const iree_uk_mmt4d_params_t* params);
+
+// Architecture-specific implementation of the entire loop nest, or generic
+// fallback returning null. Takes precedence over tile functions.
+iree_uk_mmt4d_loop_func_t iree_uk_mmt4d_select_loop_func_arch(
+    const iree_uk_mmt4d_params_t* params);
+
 // Generic fallback.
 iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
     const iree_uk_mmt4d_params_t* params);
 
+// Function pointer type for iree_uk_mmt4d_dequant tile functions. Same as
+// iree_uk_mmt4d_tile_func_t plus the scales panel of the current N-tile, see
+// iree_uk_mmt4d_dequant for its layout.
+typedef void (*iree_uk_mmt4d_dequant_tile_func_t)(
+    void* IREE_UK_RESTRICT out_tile, const void* IREE_UK_RESTRICT lhs_panel,
+    const void* IREE_UK_RESTRICT rhs_panel,
+    const float* IREE_UK_RESTRICT scales_panel,
+    const iree_uk_mmt4d_params_t* params);
+
+// Dequant tile kernel declarations. Prototype matches
+// iree_uk_mmt4d_dequant_tile_func_t.
+#define IREE_UK_MMT4D_DEQUANT_TILE_FUNC_DECL(NAME)      \
+  void NAME(void* IREE_UK_RESTRICT out_tile,            \
+            const void* IREE_UK_RESTRICT lhs_panel,     \
+            const void* IREE_UK_RESTRICT rhs_panel,     \
+            const float* IREE_UK_RESTRICT scales_panel, \
+            const iree_uk_mmt4d_params_t* params);
+
+#define IREE_UK_MMT4D_DEQUANT_TILE_FUNC_IMPL_FOR_M0(GENERIC_FUNC, FUNC, M0) \
+  void FUNC(void* IREE_UK_RESTRICT out_tile,                                \
+            const void* IREE_UK_RESTRICT lhs_panel,                         \
+            const void* IREE_UK_RESTRICT rhs_panel,                         \
+            const float* IREE_UK_RESTRICT scales_panel,                     \
+            const iree_uk_mmt4d_params_t* params) {                         \
+    GENERIC_FUNC(out_tile, lhs_panel, rhs_panel, scales_panel, params, M0); \
+  }
+
+// Architecture-specific implementation, or generic fallback returning null.
+iree_uk_mmt4d_dequant_tile_func_t iree_uk_mmt4d_dequant_select_tile_func_arch(
+    const iree_uk_mmt4d_params_t* params);
+
+// Generic fallback.
+iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_generic(
+    const iree_uk_mmt4d_params_t* params);
+
 #endif  // IREE_BUILTINS_UKERNEL_MMT4D_INTERNAL_H_
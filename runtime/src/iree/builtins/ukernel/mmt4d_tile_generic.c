@@ -407,3 +407,76 @@ iree_uk_mmt4d_tile_func_t iree_uk_mmt4d_select_tile_func_generic(
       return 0;
   }
 }
+
+// Generic implementation of dequant matmul tiles, {f16,bf16}*u4->f32 cases.
+// The RHS nibbles are dequantized as `(q - zero_point) * scale` with the scale
+// and zero point of the current group and RHS row.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void
+iree_uk_mmt4d_dequant_tile_xxu4f32_generic(
+    void* out_tile_untyped, const void* lhs_panel_untyped,
+    const void* rhs_panel_untyped, const float* scales_panel,
+    const iree_uk_mmt4d_params_t* params, iree_uk_type_t lhs_type) {
+  float* out_tile = out_tile_untyped;
+  const iree_uk_uint16_t* lhs_panel = lhs_panel_untyped;
+  const iree_uk_uint8_t* rhs_panel = rhs_panel_untyped;
+  iree_uk_int16_t M0 = params->M0;
+  iree_uk_int16_t N0 = params->N0;
+  iree_uk_int16_t K0 = params->K0;
+  // K0 must be even.
+  IREE_UK_ASSERT(!(K0 % 2));
+  iree_uk_int16_t K0half = K0 / 2;
+  for (iree_uk_index_t i0 = 0; i0 < M0; ++i0) {
+    for (iree_uk_index_t j0 = 0; j0 < N0; ++j0) {
+      float acc = (params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE)
+                      ? out_tile[i0 * N0 + j0]
+                      : 0.f;
+      for (iree_uk_index_t k = 0; k < params->K; ++k) {
+        const float* group_scales =
+            scales_panel + (k / params->group_size) * 2 * N0;
+        float scale = group_scales[j0];
+        float zero_point = group_scales[N0 + j0];
+        for (iree_uk_index_t k0 = 0; k0 < K0; ++k0) {
+          iree_uk_uint16_t lhs = lhs_panel[k * M0 * K0 + i0 * K0 + k0];
+          float lhs_f32 = lhs_type == IREE_UK_TYPE_FLOAT_16
+                              ? iree_uk_f16_to_f32(lhs)
+                              : iree_uk_bf16_to_f32(lhs);
+          iree_uk_uint8_t rhs_byte =
+              rhs_panel[k * N0 * K0half + j0 * K0half + k0 / 2];
+          iree_uk_int32_t rhs_u4 = (k0 % 2) ? (rhs_byte >> 4) : rhs_byte & 0xF;
+          acc += lhs_f32 * (((float)rhs_u4 - zero_point) * scale);
+        }
+      }
+      out_tile[i0 * N0 + j0] = acc;
+    }
+  }
+}
+
+static void iree_uk_mmt4d_dequant_tile_f16u4f32_generic(
+    void* out_tile, const void* lhs_panel, const void* rhs_panel,
+    const float* scales_panel, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_generic(out_tile, lhs_panel, rhs_panel,
+                                             scales_panel, params,
+                                             IREE_UK_TYPE_FLOAT_16);
+}
+
+static void iree_uk_mmt4d_dequant_tile_bf16u4f32_generic(
+    void* out_tile, const void* lhs_panel, const void* rhs_panel,
+    const float* scales_panel, const iree_uk_mmt4d_params_t* params) {
+  iree_uk_mmt4d_dequant_tile_xxu4f32_generic(out_tile, lhs_panel, rhs_panel,
+                                             scales_panel, params,
+                                             IREE_UK_TYPE_BFLOAT_16);
+}
+
+iree_uk_mmt4d_dequant_tile_func_t
+iree_uk_mmt4d_dequant_select_tile_func_generic(
+    const iree_uk_mmt4d_params_t* params) {
+  switch (iree_uk_mmt4d_type(params->flags)) {
+    case iree_uk_mmt4d_type_f16u4f32:
+      return iree_uk_mmt4d_dequant_tile_f16u4f32_generic;
+    case iree_uk_mmt4d_type_bf16u4f32:
+      return iree_uk_mmt4d_dequant_tile_bf16u4f32_generic;
+    default:
+      // Shouldn't happen, validated earlier.
+      return 0;
+  }
+}
@@ -0,0 +1,207 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/elementwise_internal.h"
+#include "iree/builtins/ukernel/norm_internal.h"
+
+static void iree_uk_norm_validate(const iree_uk_norm_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_NORM_TYPE_MASK | IREE_UK_FLAG_NORM_RMS |
+      IREE_UK_FLAG_NORM_FAST_MATH | IREE_UK_FLAG_NORM_HAS_WEIGHT |
+      IREE_UK_FLAG_NORM_HAS_BIAS;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_NORM_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_NORM_TYPE_F32 ||
+                 flags_type == IREE_UK_FLAG_NORM_TYPE_F16 ||
+                 flags_type == IREE_UK_FLAG_NORM_TYPE_BF16);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= 0);
+  IREE_UK_ASSERT(params->out_stride0 >= 0);
+  IREE_UK_ASSERT(params->epsilon >= 0.0f);
+  IREE_UK_ASSERT(!(params->flags & IREE_UK_FLAG_NORM_HAS_WEIGHT) ||
+                 params->weight_buffer);
+  IREE_UK_ASSERT(!(params->flags & IREE_UK_FLAG_NORM_HAS_BIAS) ||
+                 params->bias_buffer);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_norm_early(const iree_uk_norm_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+// Accumulates the sum of the elements of a row and the sum of their squares,
+// into `lanes` partial sums each. The squares are centered around `center`,
+// which is the mean in the second pass of the precise layer norm.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_norm_row_sums(
+    const void* in_buffer, iree_uk_index_t in_base, iree_uk_index_t size1,
+    iree_uk_type_t type, float center, bool need_sum, bool need_sum_squares,
+    float* sum, float* sum_squares) {
+  enum { lanes = iree_uk_elementwise_lanes };
+  const iree_uk_index_t size1_main = size1 & ~(iree_uk_index_t)(lanes - 1);
+  float lane_sum[lanes];
+  float lane_sum_squares[lanes];
+  for (int l = 0; l < lanes; ++l) {
+    lane_sum[l] = 0.0f;
+    lane_sum_squares[l] = 0.0f;
+  }
+  for (iree_uk_index_t j0 = 0; j0 < size1_main; j0 += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      float x =
+          iree_uk_elementwise_load(in_buffer, in_base + j0 + l, type) - center;
+      if (need_sum) lane_sum[l] += x;
+      if (need_sum_squares) lane_sum_squares[l] += x * x;
+    }
+  }
+  float s = 0.0f;
+  float s2 = 0.0f;
+  for (int l = 0; l < lanes; ++l) {
+    s += lane_sum[l];
+    s2 += lane_sum_squares[l];
+  }
+  for (iree_uk_index_t j = size1_main; j < size1; ++j) {
+    float x = iree_uk_elementwise_load(in_buffer, in_base + j, type) - center;
+    s += x;
+    s2 += x * x;
+  }
+  *sum = s;
+  *sum_squares = s2;
+}
+
+// Normalizes one row. The precise layer norm computes the variance in a second
+// pass over the centered values, which avoids the cancellation of the
+// E[x^2] - E[x]^2 formula used by the single-pass fast variant when the mean
+// is large compared to the standard deviation.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_norm_row(
+    const iree_uk_norm_params_t* params, iree_uk_index_t i, iree_uk_type_t type,
+    bool rms, bool fast) {
+  const iree_uk_index_t in_base = params->in_offset + i * params->in_stride0;
+  const iree_uk_index_t out_base = params->out_offset + i * params->out_stride0;
+  const iree_uk_index_t size1 = params->size1;
+  const float inv_size1 = 1.0f / (float)size1;
+  float mean = 0.0f;
+  float variance;
+  float sum, sum_squares;
+  if (rms) {
+    iree_uk_norm_row_sums(params->in_buffer, in_base, size1, type, 0.0f,
+                          /*need_sum=*/false, /*need_sum_squares=*/true, &sum,
+                          &sum_squares);
+    variance = sum_squares * inv_size1;
+  } else if (fast) {
+    iree_uk_norm_row_sums(params->in_buffer, in_base, size1, type, 0.0f,
+                          /*need_sum=*/true, /*need_sum_squares=*/true, &sum,
+                          &sum_squares);
+    mean = sum * inv_size1;
+    variance = sum_squares * inv_size1 - mean * mean;
+    variance = variance < 0.0f ? 0.0f : variance;
+  } else {
+    iree_uk_norm_row_sums(params->in_buffer, in_base, size1, type, 0.0f,
+                          /*need_sum=*/true, /*need_sum_squares=*/false, &sum,
+                          &sum_squares);
+    mean = sum * inv_size1;
+    iree_uk_norm_row_sums(params->in_buffer, in_base, size1, type, mean,
+                          /*need_sum=*/false, /*need_sum_squares=*/true, &sum,
+                          &sum_squares);
+    variance = sum_squares * inv_size1;
+  }
+  const float scale = iree_uk_rsqrt_f32(variance + params->epsilon, fast);
+
+  const bool has_weight = params->flags & IREE_UK_FLAG_NORM_HAS_WEIGHT;
+  const bool has_bias = params->flags & IREE_UK_FLAG_NORM_HAS_BIAS;
+  for (iree_uk_index_t j = 0; j < size1; ++j) {
+    float x = iree_uk_elementwise_load(params->in_buffer, in_base + j, type);
+    float y = (x - mean) * scale;
+    if (has_weight) {
+      y *= iree_uk_elementwise_load(params->weight_buffer,
+                                    params->weight_offset + j, type);
+    }
+    if (has_bias) {
+      y += iree_uk_elementwise_load(params->bias_buffer,
+                                    params->bias_offset + j, type);
+    }
+    iree_uk_elementwise_store(params->out_buffer, out_base + j, y, type);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_norm_impl(
+    const iree_uk_norm_params_t* params, iree_uk_type_t type, bool rms,
+    bool fast) {
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    iree_uk_norm_row(params, i, type, rms, fast);
+  }
+}
+
+#define IREE_UK_NORM_IMPL_FOR_TYPE(SUFFIX, TYPE)                           \
+  static void iree_uk_norm_##SUFFIX(const iree_uk_norm_params_t* params) { \
+    bool rms = params->flags & IREE_UK_FLAG_NORM_RMS;                      \
+    if (params->flags & IREE_UK_FLAG_NORM_FAST_MATH) {                     \
+      if (rms) {                                                           \
+        iree_uk_norm_impl(params, TYPE, /*rms=*/true, /*fast=*/true);      \
+      } else {                                                             \
+        iree_uk_norm_impl(params, TYPE, /*rms=*/false, /*fast=*/true);     \
+      }                                                                    \
+    } else {                                                               \
+      if (rms) {                                                           \
+        iree_uk_norm_impl(params, TYPE, /*rms=*/true, /*fast=*/false);     \
+      } else {                                                             \
+        iree_uk_norm_impl(params, TYPE, /*rms=*/false, /*fast=*/false);    \
+      }                                                                    \
+    }                                                                      \
+  }
+
+IREE_UK_NORM_IMPL_FOR_TYPE(f32, IREE_UK_TYPE_FLOAT_32)
+IREE_UK_NORM_IMPL_FOR_TYPE(f16, IREE_UK_TYPE_FLOAT_16)
+IREE_UK_NORM_IMPL_FOR_TYPE(bf16, IREE_UK_TYPE_BFLOAT_16)
+
+void iree_uk_norm_p(const iree_uk_norm_params_t* params) {
+  iree_uk_norm_validate(params);
+
+  if (iree_uk_norm_early(params)) return;
+
+  switch (iree_uk_norm_type(params->flags)) {
+    case IREE_UK_TYPE_FLOAT_32:
+      iree_uk_norm_f32(params);
+      break;
+    case IREE_UK_TYPE_FLOAT_16:
+      iree_uk_norm_f16(params);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      iree_uk_norm_bf16(params);
+      break;
+    default:
+      // Shouldn't happen, validated earlier.
+      IREE_UK_ASSERT(false);
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_norm(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, const void* weight_buffer,
+    iree_uk_index_t weight_offset, const void* bias_buffer,
+    iree_uk_index_t bias_offset, iree_uk_index_t size0, iree_uk_index_t size1,
+    float epsilon, iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_norm_params_t params = {
+      .in_buffer = in_buffer,
+      .in_offset = in_offset,
+      .in_stride0 = in_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .weight_buffer = weight_buffer,
+      .weight_offset = weight_offset,
+      .bias_buffer = bias_buffer,
+      .bias_offset = bias_offset,
+      .size0 = size0,
+      .size1 = size1,
+      .epsilon = epsilon,
+      .flags = flags,
+      .cpu_data = cpu_data,
+  };
+  iree_uk_norm_p(&params);
+}
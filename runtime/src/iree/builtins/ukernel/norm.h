@@ -0,0 +1,35 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_NORM_H_
+#define IREE_BUILTINS_UKERNEL_NORM_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `norm` microkernel, normalizing each row of a [size0][size1] input. Layer
+// normalization computes
+//
+//   out[i][j] = (in[i][j] - mean_i) / sqrt(var_i + epsilon) * weight[j]
+//               + bias[j]
+//
+// and RMS normalization (IREE_UK_FLAG_NORM_RMS) computes
+//
+//   out[i][j] = in[i][j] / sqrt(mean_k(in[i][k]^2) + epsilon) * weight[j]
+//               + bias[j]
+//
+// where the weight and bias terms are only applied with
+// IREE_UK_FLAG_NORM_HAS_WEIGHT and IREE_UK_FLAG_NORM_HAS_BIAS, respectively.
+// Rows must be contiguous; `stride0` is the row stride, in elements. `weight`
+// and `bias` are contiguous vectors of size1 elements.
+IREE_UK_EXPORT void iree_uk_norm(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, const void* weight_buffer,
+    iree_uk_index_t weight_offset, const void* bias_buffer,
+    iree_uk_index_t bias_offset, iree_uk_index_t size0, iree_uk_index_t size1,
+    float epsilon, iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_NORM_H_
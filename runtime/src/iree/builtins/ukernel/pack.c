@@ -270,20 +270,23 @@ IREE_UK_EXPORT void iree_uk_pack(
     iree_uk_index_t out_size1, iree_uk_index_t out_size2,
     iree_uk_index_t out_size3, iree_uk_uint64_t padding_value,
     iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
-  iree_uk_pack_params_t params = {.in_buffer = in_buffer,
-                                  .in_offset = in_offset,
-                                  .in_stride0 = in_stride0,
-                                  .out_buffer = out_buffer,
-                                  .out_offset = out_offset,
-                                  .out_stride0 = out_stride0,
-                                  .in_size0 = in_size0,
-                                  .in_size1 = in_size1,
-                                  .out_size0 = out_size0,
-                                  .out_size1 = out_size1,
-                                  .out_size2 = out_size2,
-                                  .out_size3 = out_size3,
-                                  .padding_value = padding_value,
-                                  .flags = flags,
-                                  .cpu_data = cpu_data};
+  iree_uk_pack_params_t params = {
+      .in_buffer = in_buffer,
+      .in_offset = in_offset,
+      .in_stride0 = in_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .in_size0 = in_size0,
+      .in_size1 = in_size1,
+      .out_size0 = out_size0,
+      .out_size1 = out_size1,
+      .out_size2 = out_size2,
+      .out_size3 = out_size3,
+      .padding_value = padding_value,
+      .streaming_store_threshold =
+          iree_uk_pack_default_streaming_store_threshold,
+      .flags = flags,
+      .cpu_data = cpu_data};
   iree_uk_pack_p(&params);
 }
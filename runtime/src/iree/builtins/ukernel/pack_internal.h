@@ -23,10 +23,20 @@ typedef struct iree_uk_pack_params_t {
   iree_uk_index_t out_size2;
   iree_uk_index_t out_size3;
   iree_uk_uint64_t padding_value;
+  // Size in bytes of the packed output from which tile functions writing it
+  // with non-temporal (streaming) stores are preferred, when available. Large
+  // outputs are not going to be read back from the cache anyway, and writing
+  // them through it evicts the consumer's working set. 0 disables them.
+  iree_uk_index_t streaming_store_threshold;
   iree_uk_uint32_t flags;
   const iree_uk_uint64_t* cpu_data;
 } iree_uk_pack_params_t;
 
+// Default `streaming_store_threshold` used by the exported iree_uk_pack. Pack
+// ops typically run on all threads at once, so this is meant to be roughly a
+// per-core share of the last-level cache rather than its full size.
+enum { iree_uk_pack_default_streaming_store_threshold = 1 << 20 };
+
 void iree_uk_pack_p(const iree_uk_pack_params_t* params);
 
 typedef enum iree_uk_pack_type_t {
@@ -64,6 +74,21 @@ static inline iree_uk_type_t iree_uk_pack_out_type(iree_uk_pack_type_t type) {
   return iree_uk_untie_type(1, type);
 }
 
+// Returns true if the packed output is at least
+// `params->streaming_store_threshold` bytes. Architecture-specific code may
+// have additional requirements, e.g. on alignment, to actually select tile
+// functions using streaming stores.
+static inline bool iree_uk_pack_prefer_streaming_stores(
+    const iree_uk_pack_params_t* params) {
+  if (params->streaming_store_threshold <= 0) return false;
+  iree_uk_type_t out_type =
+      iree_uk_pack_out_type(iree_uk_pack_type(params->flags));
+  iree_uk_index_t out_bytes = params->out_size0 * params->out_size1 *
+                              params->out_size2 * params->out_size3 *
+                              iree_uk_type_size(out_type);
+  return out_bytes >= params->streaming_store_threshold;
+}
+
 typedef void (*iree_uk_pack_tile_func_t)(
     void* IREE_UK_RESTRICT out_tile_ptr,
     const void* IREE_UK_RESTRICT in_tile_ptr, iree_uk_index_t outer_size1,
@@ -47,6 +47,17 @@ static void iree_uk_query_tile_sizes_2d_matmul(
   if (!iree_uk_query_matmul_tile_sizes_arch(params, &matmul_tile_sizes)) {
     matmul_tile_sizes = iree_uk_query_matmul_tile_sizes_generic(params);
   }
+  // Narrow-M case, e.g. matrix-vector products: use the smallest power-of-two
+  // M tile size covering the narrow M dimension. mmt4d tile functions have
+  // specialized narrow variants for these, down to dedicated M0 == 1 kernels.
+  int narrow_m = iree_uk_query_tile_sizes_narrow_m(params->flags);
+  if (narrow_m) {
+    int narrow_tile_m = 1;
+    while (narrow_tile_m < narrow_m) narrow_tile_m *= 2;
+    if (narrow_tile_m < matmul_tile_sizes.M) {
+      matmul_tile_sizes.M = narrow_tile_m;
+    }
+  }
   iree_uk_uint32_t role = iree_uk_query_tile_sizes_operand_role(params->flags);
   if (role == IREE_UK_FLAG_QUERY_TILE_SIZES_OPERAND_ROLE_LHS) {
     out_params->tile_size0 = matmul_tile_sizes.M;
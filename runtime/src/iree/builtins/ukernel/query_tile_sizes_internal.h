@@ -19,6 +19,11 @@ static inline iree_uk_uint32_t iree_uk_query_tile_sizes_operation(
   return flags & IREE_UK_FLAG_QUERY_TILE_SIZES_OPERATION_MASK;
 }
 
+static inline int iree_uk_query_tile_sizes_narrow_m(iree_uk_uint32_t flags) {
+  return (flags & IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_MASK) >>
+         IREE_UK_FLAG_QUERY_TILE_SIZES_NARROW_M_SHIFT;
+}
+
 // Holds matmul tile params as returned from architecture-specific backend code.
 typedef struct iree_uk_matmul_tile_sizes_t {
   int M, K, N;
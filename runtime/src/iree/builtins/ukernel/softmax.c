@@ -0,0 +1,158 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/builtins/ukernel/elementwise_internal.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
+
+static void iree_uk_softmax_validate(const iree_uk_softmax_params_t* params) {
+#ifdef IREE_UK_ENABLE_ASSERTS
+  const iree_uk_uint32_t allflags =
+      IREE_UK_FLAG_SOFTMAX_TYPE_MASK | IREE_UK_FLAG_SOFTMAX_FAST_MATH;
+  IREE_UK_ASSERT(!(params->flags & ~allflags));
+  iree_uk_uint32_t flags_type = params->flags & IREE_UK_FLAG_SOFTMAX_TYPE_MASK;
+  IREE_UK_ASSERT(flags_type == IREE_UK_FLAG_SOFTMAX_TYPE_F32 ||
+                 flags_type == IREE_UK_FLAG_SOFTMAX_TYPE_F16 ||
+                 flags_type == IREE_UK_FLAG_SOFTMAX_TYPE_BF16);
+  IREE_UK_ASSERT(params->size0 >= 0);
+  IREE_UK_ASSERT(params->size1 >= 0);
+  IREE_UK_ASSERT(params->in_stride0 >= 0);
+  IREE_UK_ASSERT(params->out_stride0 >= 0);
+#endif  // IREE_UK_ENABLE_ASSERTS
+}
+
+// Early-return implementation for this ukernel. Returns true if already done.
+static bool iree_uk_softmax_early(const iree_uk_softmax_params_t* params) {
+  return params->size0 == 0 || params->size1 == 0;
+}
+
+// Computes the softmax of one row in three passes: maximum, sum of
+// exponentials, and normalization. For f32, the exponentials are stored to the
+// output in the second pass and rescaled in place in the third; for narrower
+// types, they are recomputed instead, as storing them would round them.
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_softmax_row(
+    const void* in_buffer, iree_uk_index_t in_base, void* out_buffer,
+    iree_uk_index_t out_base, iree_uk_index_t size1, iree_uk_type_t type,
+    bool fast) {
+  enum { lanes = iree_uk_elementwise_lanes };
+  const iree_uk_index_t size1_main = size1 & ~(iree_uk_index_t)(lanes - 1);
+  float lane_max[lanes];
+  float first = iree_uk_elementwise_load(in_buffer, in_base, type);
+  for (int l = 0; l < lanes; ++l) lane_max[l] = first;
+  for (iree_uk_index_t j0 = 0; j0 < size1_main; j0 += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      float x = iree_uk_elementwise_load(in_buffer, in_base + j0 + l, type);
+      lane_max[l] = x > lane_max[l] ? x : lane_max[l];
+    }
+  }
+  float max = lane_max[0];
+  for (int l = 1; l < lanes; ++l) max = lane_max[l] > max ? lane_max[l] : max;
+  for (iree_uk_index_t j = size1_main; j < size1; ++j) {
+    float x = iree_uk_elementwise_load(in_buffer, in_base + j, type);
+    max = x > max ? x : max;
+  }
+
+  float lane_sum[lanes];
+  for (int l = 0; l < lanes; ++l) lane_sum[l] = 0.0f;
+  for (iree_uk_index_t j0 = 0; j0 < size1_main; j0 += lanes) {
+    for (int l = 0; l < lanes; ++l) {
+      float x = iree_uk_elementwise_load(in_buffer, in_base + j0 + l, type);
+      float e = iree_uk_exp_f32(x - max, fast);
+      if (type == IREE_UK_TYPE_FLOAT_32) {
+        ((float*)out_buffer)[out_base + j0 + l] = e;
+      }
+      lane_sum[l] += e;
+    }
+  }
+  float sum = 0.0f;
+  for (int l = 0; l < lanes; ++l) sum += lane_sum[l];
+  for (iree_uk_index_t j = size1_main; j < size1; ++j) {
+    float x = iree_uk_elementwise_load(in_buffer, in_base + j, type);
+    float e = iree_uk_exp_f32(x - max, fast);
+    if (type == IREE_UK_TYPE_FLOAT_32) {
+      ((float*)out_buffer)[out_base + j] = e;
+    }
+    sum += e;
+  }
+
+  // sum >= 1 as the maximum contributes exp(0).
+  float inv_sum = 1.0f / sum;
+  for (iree_uk_index_t j = 0; j < size1; ++j) {
+    float e;
+    if (type == IREE_UK_TYPE_FLOAT_32) {
+      e = ((float*)out_buffer)[out_base + j];
+    } else {
+      float x = iree_uk_elementwise_load(in_buffer, in_base + j, type);
+      e = iree_uk_exp_f32(x - max, fast);
+    }
+    iree_uk_elementwise_store(out_buffer, out_base + j, e * inv_sum, type);
+  }
+}
+
+IREE_UK_ATTRIBUTE_ALWAYS_INLINE static inline void iree_uk_softmax_impl(
+    const iree_uk_softmax_params_t* params, iree_uk_type_t type, bool fast) {
+  for (iree_uk_index_t i = 0; i < params->size0; ++i) {
+    iree_uk_softmax_row(params->in_buffer,
+                        params->in_offset + i * params->in_stride0,
+                        params->out_buffer,
+                        params->out_offset + i * params->out_stride0,
+                        params->size1, type, fast);
+  }
+}
+
+#define IREE_UK_SOFTMAX_IMPL_FOR_TYPE(SUFFIX, TYPE)       \
+  static void iree_uk_softmax_##SUFFIX(                   \
+      const iree_uk_softmax_params_t* params) {           \
+    if (params->flags & IREE_UK_FLAG_SOFTMAX_FAST_MATH) { \
+      iree_uk_softmax_impl(params, TYPE, /*fast=*/true);  \
+    } else {                                              \
+      iree_uk_softmax_impl(params, TYPE, /*fast=*/false); \
+    }                                                     \
+  }
+
+IREE_UK_SOFTMAX_IMPL_FOR_TYPE(f32, IREE_UK_TYPE_FLOAT_32)
+IREE_UK_SOFTMAX_IMPL_FOR_TYPE(f16, IREE_UK_TYPE_FLOAT_16)
+IREE_UK_SOFTMAX_IMPL_FOR_TYPE(bf16, IREE_UK_TYPE_BFLOAT_16)
+
+void iree_uk_softmax_p(const iree_uk_softmax_params_t* params) {
+  iree_uk_softmax_validate(params);
+
+  if (iree_uk_softmax_early(params)) return;
+
+  switch (iree_uk_softmax_type(params->flags)) {
+    case IREE_UK_TYPE_FLOAT_32:
+      iree_uk_softmax_f32(params);
+      break;
+    case IREE_UK_TYPE_FLOAT_16:
+      iree_uk_softmax_f16(params);
+      break;
+    case IREE_UK_TYPE_BFLOAT_16:
+      iree_uk_softmax_bf16(params);
+      break;
+    default:
+      // Shouldn't happen, validated earlier.
+      IREE_UK_ASSERT(false);
+  }
+}
+
+IREE_UK_EXPORT void iree_uk_softmax(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data) {
+  iree_uk_softmax_params_t params = {
+      .in_buffer = in_buffer,
+      .in_offset = in_offset,
+      .in_stride0 = in_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .size0 = size0,
+      .size1 = size1,
+      .flags = flags,
+      .cpu_data = cpu_data,
+  };
+  iree_uk_softmax_p(&params);
+}
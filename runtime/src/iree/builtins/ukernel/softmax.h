@@ -0,0 +1,23 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+#define IREE_BUILTINS_UKERNEL_SOFTMAX_H_
+
+#include "iree/builtins/ukernel/common.h"
+
+// `softmax` microkernel, computing for each row i of a [size0][size1] input:
+//
+//   out[i][j] = exp(in[i][j] - max_k in[i][k]) / sum_k exp(in[i][k] - max)
+//
+// Rows must be contiguous; `stride0` is the row stride, in elements.
+IREE_UK_EXPORT void iree_uk_softmax(
+    const void* in_buffer, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, void* out_buffer, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t size0, iree_uk_index_t size1,
+    iree_uk_uint32_t flags, const iree_uk_uint64_t* cpu_data);
+
+#endif  // IREE_BUILTINS_UKERNEL_SOFTMAX_H_
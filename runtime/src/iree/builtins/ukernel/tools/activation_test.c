@@ -0,0 +1,167 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/activation_internal.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/elementwise_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static double iree_uk_test_activation_reference(double x,
+                                                iree_uk_uint32_t op) {
+  switch (op) {
+    case IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF:
+      return 0.5 * x * (1.0 + erf(x / sqrt(2.0)));
+    case IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH:
+      return 0.5 * x *
+             (1.0 + tanh(sqrt(2.0 / M_PI) * (x + 0.044715 * x * x * x)));
+    case IREE_UK_FLAG_ACTIVATION_OP_SILU:
+      return x / (1.0 + exp(-x));
+    default:
+      IREE_UK_ASSERT(false && "unhandled op");
+      return 0.0;
+  }
+}
+
+// Allocates a [rows][stride] buffer filled with random values uniformly
+// distributed in [-range, range], rounded to `type`.
+static void* iree_uk_test_activation_alloc(iree_uk_test_t* test,
+                                           iree_uk_type_t type,
+                                           iree_uk_index_t rows,
+                                           iree_uk_index_t cols, float range,
+                                           iree_uk_index_t* stride) {
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  *stride = cols + iree_uk_random_engine_get_0_1(engine) * 3;
+  iree_uk_index_t length = iree_uk_index_max(1, rows * *stride);
+  void* buffer = malloc(length * iree_uk_type_size(type));
+  for (iree_uk_index_t i = 0; i < length; ++i) {
+    float x = range * (iree_uk_random_engine_get_0_65535(engine) / 32767.5f -
+                       1.0f);
+    iree_uk_elementwise_store(buffer, i, x, type);
+  }
+  return buffer;
+}
+
+static void iree_uk_test_activation_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_activation_params_t* src_params,
+    float range) {
+  iree_uk_activation_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_type_t type = iree_uk_activation_type(params.flags);
+  iree_uk_uint32_t op = params.flags & IREE_UK_FLAG_ACTIVATION_OP_MASK;
+  bool fast = params.flags & IREE_UK_FLAG_ACTIVATION_FAST_MATH;
+  void* in_buffer = iree_uk_test_activation_alloc(
+      test, type, params.size0, params.size1, range, &params.in_stride0);
+  void* out_buffer = iree_uk_test_activation_alloc(
+      test, type, params.size0, params.size1, range, &params.out_stride0);
+  params.in_buffer = in_buffer;
+  params.out_buffer = out_buffer;
+  params.in_offset = 0;
+  params.out_offset = 0;
+  params.cpu_data = iree_uk_test_cpu_data(test);
+
+  iree_uk_activation_p(&params);
+
+  // These functions are close to x for large positive x and go to 0 for large
+  // negative x, so the tolerance is relative to 1 + |x|.
+  float tolerance = type == IREE_UK_TYPE_FLOAT_32   ? (fast ? 2e-4f : 2e-6f)
+                    : type == IREE_UK_TYPE_FLOAT_16 ? 2e-3f
+                                                    : 1e-2f;
+  for (iree_uk_index_t i = 0; i < params.size0; ++i) {
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      float x =
+          iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j, type);
+      double expected = iree_uk_test_activation_reference(x, op);
+      float actual = iree_uk_elementwise_load(
+          out_buffer, i * params.out_stride0 + j, type);
+      if (!(fabs(actual - expected) <= tolerance * (1.0 + fabs(x)))) {
+        IREE_UK_TEST_FAIL(test);
+        goto done;
+      }
+    }
+  }
+
+done:
+  free(out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_activation_for_flags(iree_uk_test_t* test,
+                                              const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+    float range;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases.
+      {0, 4, 1.0f},
+      {3, 0, 1.0f},
+      // Small shapes, around the region where these functions are nonlinear.
+      {1, 1, 4.0f},
+      {2, 7, 4.0f},
+      {5, 33, 4.0f},
+      {4, 1000, 6.0f},
+      // Large inputs, where exp saturates.
+      {3, 500, 100.0f},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_activation_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.size0 = shapes[i].size0;
+    params.size1 = shapes[i].size1;
+    iree_uk_test_activation_for_shape_params(test, &params, shapes[i].range);
+  }
+}
+
+static void iree_uk_test_activation(iree_uk_uint32_t flags,
+                                    const char* cpu_features) {
+  iree_uk_activation_params_t params = {.flags = flags};
+  char type_str[16];
+  iree_uk_type_str(type_str, sizeof type_str, iree_uk_activation_type(flags));
+  const char* op_str = "";
+  switch (flags & IREE_UK_FLAG_ACTIVATION_OP_MASK) {
+    case IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF:
+      op_str = "gelu_erf";
+      break;
+    case IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH:
+      op_str = "gelu_tanh";
+      break;
+    case IREE_UK_FLAG_ACTIVATION_OP_SILU:
+      op_str = "silu";
+      break;
+  }
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "op:%s type:%s fast_math:%d",
+           op_str, type_str,
+           (flags & IREE_UK_FLAG_ACTIVATION_FAST_MATH) ? 1 : 0);
+  iree_uk_test(test_label_str, iree_uk_test_activation_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t types[] = {
+      IREE_UK_FLAG_ACTIVATION_TYPE_F32,
+      IREE_UK_FLAG_ACTIVATION_TYPE_F16,
+      IREE_UK_FLAG_ACTIVATION_TYPE_BF16,
+  };
+  const iree_uk_uint32_t ops[] = {
+      IREE_UK_FLAG_ACTIVATION_OP_GELU_ERF,
+      IREE_UK_FLAG_ACTIVATION_OP_GELU_TANH,
+      IREE_UK_FLAG_ACTIVATION_OP_SILU,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(ops); ++i) {
+    for (int j = 0; j < IREE_ARRAYSIZE(types); ++j) {
+      iree_uk_test_activation(ops[i] | types[j], "");
+      iree_uk_test_activation(
+          ops[i] | types[j] | IREE_UK_FLAG_ACTIVATION_FAST_MATH, "");
+    }
+  }
+
+  return iree_uk_test_exit_status();
+}
@@ -0,0 +1,145 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/argmax_internal.h"
+#include "iree/builtins/ukernel/elementwise_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static void iree_uk_test_argmax_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_argmax_params_t* src_params,
+    bool special_values) {
+  iree_uk_argmax_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  iree_uk_type_t type = iree_uk_argmax_type(params.flags);
+  bool index_i64 = params.flags & IREE_UK_FLAG_ARGMAX_INDEX_I64;
+  iree_uk_index_t index_size = index_i64 ? 8 : 4;
+  params.in_stride0 =
+      params.size1 + iree_uk_random_engine_get_0_1(engine) * 3;
+  params.out_stride0 = 1 + iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t in_length = iree_uk_index_max(1, params.size0 *
+                                                       params.in_stride0);
+  iree_uk_index_t out_length = iree_uk_index_max(1, params.size0 *
+                                                        params.out_stride0);
+  // The small integers of iree_uk_write_random_buffer produce many ties,
+  // checking that the first maximum wins.
+  void* in_buffer = malloc(in_length * iree_uk_type_size(type));
+  iree_uk_write_random_buffer(in_buffer, in_length * iree_uk_type_size(type),
+                              type, engine);
+  if (special_values) {
+    for (iree_uk_index_t i = 0; i < in_length; ++i) {
+      int r = iree_uk_random_engine_get_0_255(engine);
+      if (r < 32) {
+        iree_uk_elementwise_store(in_buffer, i, NAN, type);
+      } else if (r < 64) {
+        iree_uk_elementwise_store(in_buffer, i, -INFINITY, type);
+      }
+    }
+    // A row with only -inf and NaN gets index 0.
+    for (iree_uk_index_t j = 0; params.size0 && j < params.size1; ++j) {
+      iree_uk_elementwise_store(in_buffer, j, j % 2 ? NAN : -INFINITY, type);
+    }
+  }
+  void* out_buffer = malloc(out_length * index_size);
+  memset(out_buffer, 0xFF, out_length * index_size);
+  params.in_buffer = in_buffer;
+  params.out_buffer = out_buffer;
+  params.in_offset = 0;
+  params.out_offset = 0;
+  params.cpu_data = iree_uk_test_cpu_data(test);
+
+  iree_uk_argmax_p(&params);
+
+  for (iree_uk_index_t i = 0; i < params.size0; ++i) {
+    float max = -INFINITY;
+    iree_uk_index_t expected = 0;
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      float x =
+          iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j, type);
+      if (x > max) {
+        max = x;
+        expected = j;
+      }
+    }
+    iree_uk_index_t out_index = i * params.out_stride0;
+    iree_uk_index_t actual =
+        index_i64 ? ((const int64_t*)out_buffer)[out_index]
+                  : ((const int32_t*)out_buffer)[out_index];
+    if (params.size1 == 0) {
+      // Nothing is written for empty rows.
+      if (actual != -1) IREE_UK_TEST_FAIL(test);
+    } else if (actual != expected) {
+      IREE_UK_TEST_FAIL(test);
+      break;
+    }
+  }
+
+  free(out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_argmax_for_flags(iree_uk_test_t* test,
+                                          const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+    bool special_values;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases.
+      {0, 4, false},
+      {3, 0, false},
+      // Rows shorter than, equal to, and not multiples of the reduction lanes.
+      {1, 1, false},
+      {2, 7, false},
+      {3, 16, false},
+      {5, 33, false},
+      {2, 1000, false},
+      // Vocabulary-sized rows, as in greedy decoding.
+      {1, 32003, false},
+      // NaN and -inf inputs.
+      {4, 50, true},
+      {2, 517, true},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_argmax_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.size0 = shapes[i].size0;
+    params.size1 = shapes[i].size1;
+    iree_uk_test_argmax_for_shape_params(test, &params,
+                                         shapes[i].special_values);
+  }
+}
+
+static void iree_uk_test_argmax(iree_uk_uint32_t flags,
+                                const char* cpu_features) {
+  iree_uk_argmax_params_t params = {.flags = flags};
+  char type_str[16];
+  iree_uk_type_str(type_str, sizeof type_str, iree_uk_argmax_type(flags));
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "type:%s index:i%d",
+           type_str, (flags & IREE_UK_FLAG_ARGMAX_INDEX_I64) ? 64 : 32);
+  iree_uk_test(test_label_str, iree_uk_test_argmax_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t types[] = {
+      IREE_UK_FLAG_ARGMAX_TYPE_F32,
+      IREE_UK_FLAG_ARGMAX_TYPE_F16,
+      IREE_UK_FLAG_ARGMAX_TYPE_BF16,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(types); ++i) {
+    iree_uk_test_argmax(types[i], "");
+    iree_uk_test_argmax(types[i] | IREE_UK_FLAG_ARGMAX_INDEX_I64, "");
+  }
+
+  return iree_uk_test_exit_status();
+}
@@ -0,0 +1,249 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/attention_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+static float iree_attention_reference_load(const void* buffer,
+                                           iree_uk_index_t index,
+                                           iree_uk_type_t type) {
+  switch (type) {
+    case IREE_UK_TYPE_FLOAT_32:
+      return ((const float*)buffer)[index];
+    case IREE_UK_TYPE_FLOAT_16:
+      return iree_uk_f16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+    case IREE_UK_TYPE_BFLOAT_16:
+      return iree_uk_bf16_to_f32(((const iree_uk_uint16_t*)buffer)[index]);
+    default:
+      IREE_UK_ASSERT(false && "unhandled type");
+      return 0.0f;
+  }
+}
+
+// Naive two-pass softmax in double precision. Writes f32 outputs to
+// `out_buffer`, a tight [batch][M][N] buffer, so that the comparison against
+// the ukernel output can be done with a tolerance.
+static void iree_attention_reference(const iree_uk_attention_params_t* params,
+                                     float* out_buffer) {
+  iree_uk_type_t type = iree_uk_attention_type(params->flags);
+  bool causal = params->flags & IREE_UK_FLAG_ATTENTION_CAUSAL;
+  bool transpose_v = params->flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  double* scores = malloc(iree_uk_index_max(1, params->K2) * sizeof(double));
+  for (iree_uk_index_t b = 0; b < params->batch; ++b) {
+    for (iree_uk_index_t i = 0; i < params->M; ++i) {
+      iree_uk_index_t visible = params->K2;
+      if (causal) {
+        visible = iree_uk_index_clamp(i + params->K2 - params->M + 1, 0,
+                                      params->K2);
+      }
+      double max = -INFINITY;
+      for (iree_uk_index_t j = 0; j < visible; ++j) {
+        double dot = 0.0;
+        for (iree_uk_index_t k = 0; k < params->K1; ++k) {
+          float q = iree_attention_reference_load(
+              params->q_buffer,
+              params->q_offset + b * params->q_stride0 + i * params->q_stride1 +
+                  k,
+              type);
+          float key = iree_attention_reference_load(
+              params->k_buffer,
+              params->k_offset + b * params->k_stride0 + j * params->k_stride1 +
+                  k,
+              type);
+          dot += (double)q * key;
+        }
+        scores[j] = dot * params->scale;
+        if (scores[j] > max) max = scores[j];
+      }
+      double sum = 0.0;
+      for (iree_uk_index_t j = 0; j < visible; ++j) {
+        scores[j] = exp(scores[j] - max);
+        sum += scores[j];
+      }
+      for (iree_uk_index_t n = 0; n < params->N; ++n) {
+        double acc = 0.0;
+        for (iree_uk_index_t j = 0; j < visible; ++j) {
+          iree_uk_index_t v_index =
+              params->v_offset + b * params->v_stride0 +
+              (transpose_v ? n * params->v_stride1 + j
+                           : j * params->v_stride1 + n);
+          acc += scores[j] *
+                 iree_attention_reference_load(params->v_buffer, v_index, type);
+        }
+        out_buffer[(b * params->M + i) * params->N + n] =
+            visible ? acc / sum : 0.0;
+      }
+    }
+  }
+  free(scores);
+}
+
+// Allocates a random [batch][rows][cols] buffer with the innermost dimension
+// contiguous and randomly padded outer strides. `extra_rows` leaves room for
+// rows beyond `rows` in each batch, as in a KV cache that is only partially
+// filled.
+static void* iree_uk_test_attention_alloc(
+    iree_uk_test_t* test, iree_uk_type_t type, iree_uk_index_t batch,
+    iree_uk_index_t rows, iree_uk_index_t cols, iree_uk_index_t extra_rows,
+    iree_uk_index_t* stride0, iree_uk_index_t* stride1) {
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  *stride1 = cols + iree_uk_random_engine_get_0_1(engine);
+  *stride0 = (rows + extra_rows) * *stride1 +
+             iree_uk_random_engine_get_0_1(engine);
+  iree_uk_index_t size =
+      iree_uk_index_max(1, batch * *stride0) * iree_uk_type_size(type);
+  void* buffer = malloc(size);
+  iree_uk_write_random_buffer(buffer, size, type, engine);
+  return buffer;
+}
+
+static void iree_uk_test_attention_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_attention_params_t* src_params) {
+  iree_uk_attention_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  iree_uk_type_t type = iree_uk_attention_type(params.flags);
+  bool transpose_v = params.flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V;
+  // Leave some unused rows at the end of K and V, and columns at the end of
+  // transposed V, like a KV cache holding more than K2 rows would.
+  iree_uk_index_t kv_cache_extra = iree_uk_random_engine_get_0_1(engine) * 5;
+  void* q_buffer =
+      iree_uk_test_attention_alloc(test, type, params.batch, params.M,
+                                   params.K1, 0, &params.q_stride0,
+                                   &params.q_stride1);
+  void* k_buffer = iree_uk_test_attention_alloc(
+      test, type, params.batch, params.K2, params.K1, kv_cache_extra,
+      &params.k_stride0, &params.k_stride1);
+  void* v_buffer =
+      transpose_v
+          ? iree_uk_test_attention_alloc(
+                test, type, params.batch, params.N,
+                params.K2 + kv_cache_extra, 0, &params.v_stride0,
+                &params.v_stride1)
+          : iree_uk_test_attention_alloc(test, type, params.batch, params.K2,
+                                         params.N, kv_cache_extra,
+                                         &params.v_stride0, &params.v_stride1);
+  void* out_buffer =
+      iree_uk_test_attention_alloc(test, type, params.batch, params.M,
+                                   params.N, 0, &params.out_stride0,
+                                   &params.out_stride1);
+  params.q_buffer = q_buffer;
+  params.k_buffer = k_buffer;
+  params.v_buffer = v_buffer;
+  params.out_buffer = out_buffer;
+  params.q_offset = 0;
+  params.k_offset = 0;
+  params.v_offset = 0;
+  params.out_offset = 0;
+  params.scale = params.K1 ? 1.0f / sqrtf((float)params.K1) : 1.0f;
+  params.cpu_data = iree_uk_test_cpu_data(test);
+
+  float* reference_out_buffer = malloc(
+      iree_uk_index_max(1, params.batch * params.M * params.N) * sizeof(float));
+  iree_attention_reference(&params, reference_out_buffer);
+  iree_uk_attention_p(&params);
+
+  // The online softmax does not compute the exact same sequence of float
+  // operations as the reference, so compare with a tolerance, which also has
+  // to account for the final rounding to the output type.
+  float tolerance = type == IREE_UK_TYPE_FLOAT_32   ? 1e-4f
+                    : type == IREE_UK_TYPE_FLOAT_16 ? 1e-2f
+                                                    : 2e-2f;
+  for (iree_uk_index_t b = 0; b < params.batch; ++b) {
+    for (iree_uk_index_t i = 0; i < params.M; ++i) {
+      for (iree_uk_index_t n = 0; n < params.N; ++n) {
+        float expected =
+            reference_out_buffer[(b * params.M + i) * params.N + n];
+        float actual = iree_attention_reference_load(
+            out_buffer, b * params.out_stride0 + i * params.out_stride1 + n,
+            type);
+        if (!(fabsf(actual - expected) <=
+              tolerance * (1.0f + fabsf(expected)))) {
+          IREE_UK_TEST_FAIL(test);
+          goto done;
+        }
+      }
+    }
+  }
+
+done:
+  free(reference_out_buffer);
+  free(out_buffer);
+  free(v_buffer);
+  free(k_buffer);
+  free(q_buffer);
+}
+
+static void iree_uk_test_attention_for_flags(iree_uk_test_t* test,
+                                             const void* src_params) {
+  typedef struct shape_t {
+    int batch, M, K1, K2, N;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases.
+      {0, 4, 4, 4, 4},
+      {1, 0, 4, 4, 4},
+      {1, 4, 4, 4, 0},
+      {1, 3, 4, 0, 5},
+      {1, 3, 0, 5, 2},
+      // Single-token decode against a KV cache.
+      {2, 1, 16, 37, 16},
+      {1, 1, 64, 200, 64},
+      // Prefill-like shapes, not multiples of the internal block sizes.
+      {1, 9, 8, 9, 7},
+      {3, 17, 33, 45, 70},
+      {1, 5, 130, 70, 3},
+      // More queries than keys: with a causal mask some rows see no key.
+      {1, 12, 8, 5, 8},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_attention_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.batch = shapes[i].batch;
+    params.M = shapes[i].M;
+    params.K1 = shapes[i].K1;
+    params.K2 = shapes[i].K2;
+    params.N = shapes[i].N;
+    iree_uk_test_attention_for_shape_params(test, &params);
+  }
+}
+
+static void iree_uk_test_attention(iree_uk_uint32_t flags,
+                                   const char* cpu_features) {
+  iree_uk_attention_params_t params = {.flags = flags};
+  char type_str[16];
+  iree_uk_type_str(type_str, sizeof type_str, iree_uk_attention_type(flags));
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str,
+           "type:%s causal:%d transpose_v:%d", type_str,
+           (flags & IREE_UK_FLAG_ATTENTION_CAUSAL) ? 1 : 0,
+           (flags & IREE_UK_FLAG_ATTENTION_TRANSPOSE_V) ? 1 : 0);
+  iree_uk_test(test_label_str, iree_uk_test_attention_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t types[] = {
+      IREE_UK_FLAG_ATTENTION_TYPE_F32,
+      IREE_UK_FLAG_ATTENTION_TYPE_F16,
+      IREE_UK_FLAG_ATTENTION_TYPE_BF16,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(types); ++i) {
+    iree_uk_test_attention(types[i], "");
+    iree_uk_test_attention(types[i] | IREE_UK_FLAG_ATTENTION_CAUSAL, "");
+    iree_uk_test_attention(types[i] | IREE_UK_FLAG_ATTENTION_TRANSPOSE_V, "");
+    iree_uk_test_attention(types[i] | IREE_UK_FLAG_ATTENTION_CAUSAL |
+                               IREE_UK_FLAG_ATTENTION_TRANSPOSE_V,
+                           "");
+  }
+
+  return iree_uk_test_exit_status();
+}
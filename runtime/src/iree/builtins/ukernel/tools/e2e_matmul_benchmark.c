@@ -7,7 +7,10 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/builtins/ukernel/api.h"
 #include "iree/builtins/ukernel/mmt4d_internal.h"
 #include "iree/builtins/ukernel/pack_internal.h"
@@ -34,12 +37,32 @@ IREE_FLAG(
     "host CPU capabilities. Other values are like in other benchmarks, e.g. "
     "\"avx2_fma\", \"avx512_base\". The empty string \"\" means the "
     "architecture baseline (e.g. on x86-64 that would be SSE2).");
+IREE_FLAG(int32_t, threads, 1,
+          "Number of threads running each of the pack, mmt4d and unpack ops, "
+          "which are sharded into workgroups like dispatches are.");
+IREE_FLAG(int32_t, workgroup_M, 64,
+          "Workgroup size along M, rounded up to a multiple of the M0 tile "
+          "size. Pack and unpack ops are sharded into workgroups of this many "
+          "rows, mmt4d into workgroups of workgroup_M x workgroup_N.");
+IREE_FLAG(int32_t, workgroup_N, 64,
+          "Workgroup size along N, rounded up to a multiple of the N0 tile "
+          "size. See workgroup_M.");
+IREE_FLAG(double, peak_gflops_per_thread, 0.0,
+          "Peak arithmetic throughput of one thread, in GFLOP/s. If set along "
+          "with peak_memory_gbps, the achieved fraction of the roofline is "
+          "reported.");
+IREE_FLAG(double, peak_memory_gbps, 0.0,
+          "Peak memory bandwidth shared by all threads, in GB/s. See "
+          "peak_gflops_per_thread.");
 
 typedef struct iree_uk_benchmark_e2e_matmul_params_t {
   iree_uk_uint32_t mmt4d_flags;
   int M;
   int K;
   int N;
+  int threads;
+  int workgroup_M;
+  int workgroup_N;
 } iree_uk_benchmark_e2e_matmul_params_t;
 
 static iree_uk_uint32_t iree_uk_qts_op_flag(iree_uk_mmt4d_type_t type) {
@@ -149,8 +172,10 @@ static uint32_t iree_uk_pack_flags(iree_uk_type_t type) {
     case IREE_UK_TYPE_FLOAT_32:
       return IREE_UK_FLAG_PACK_TYPE_F32F32;
     case IREE_UK_TYPE_INT_32:
+    case IREE_UK_TYPE_SINT_32:
       return IREE_UK_FLAG_PACK_TYPE_I32I32;
     case IREE_UK_TYPE_INT_8:
+    case IREE_UK_TYPE_SINT_8:
       return IREE_UK_FLAG_PACK_TYPE_I8I8;
     default:
       IREE_UK_ASSERT(false);
@@ -163,6 +188,7 @@ static uint32_t iree_uk_unpack_flags(iree_uk_type_t type) {
     case IREE_UK_TYPE_FLOAT_32:
       return IREE_UK_FLAG_UNPACK_TYPE_F32F32;
     case IREE_UK_TYPE_INT_32:
+    case IREE_UK_TYPE_SINT_32:
       return IREE_UK_FLAG_UNPACK_TYPE_I32I32;
     default:
       IREE_UK_ASSERT(false);
@@ -170,19 +196,214 @@ static uint32_t iree_uk_unpack_flags(iree_uk_type_t type) {
   }
 }
 
-static void iree_uk_e2e_matmul(
-    const iree_uk_pack_params_t* pack_lhs_params,
-    const iree_uk_pack_params_t* pack_rhs_params,
-    const iree_uk_pack_params_t* pack_out_params,
-    const iree_uk_mmt4d_params_t* mmt4d_params,
-    const iree_uk_unpack_params_t* unpack_out_params) {
-  iree_uk_pack_p(pack_lhs_params);
-  iree_uk_pack_p(pack_rhs_params);
-  if (mmt4d_params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE) {
-    iree_uk_pack_p(pack_out_params);
+// A reusable barrier for a fixed number of threads.
+typedef struct iree_uk_e2e_matmul_barrier_t {
+  int32_t count;
+  iree_atomic_int32_t arrived;
+  iree_atomic_int32_t generation;
+  iree_notification_t notification;
+} iree_uk_e2e_matmul_barrier_t;
+
+typedef struct iree_uk_e2e_matmul_barrier_wait_t {
+  iree_uk_e2e_matmul_barrier_t* barrier;
+  int32_t generation;
+} iree_uk_e2e_matmul_barrier_wait_t;
+
+static bool iree_uk_e2e_matmul_barrier_passed(void* arg) {
+  const iree_uk_e2e_matmul_barrier_wait_t* wait = arg;
+  return iree_atomic_load_int32(&wait->barrier->generation,
+                                iree_memory_order_acquire) != wait->generation;
+}
+
+static void iree_uk_e2e_matmul_barrier_wait(
+    iree_uk_e2e_matmul_barrier_t* barrier) {
+  int32_t generation =
+      iree_atomic_load_int32(&barrier->generation, iree_memory_order_acquire);
+  if (iree_atomic_fetch_add_int32(&barrier->arrived, 1,
+                                  iree_memory_order_acq_rel) ==
+      barrier->count - 1) {
+    // Last to arrive: reset for the next use, then release the others.
+    iree_atomic_store_int32(&barrier->arrived, 0, iree_memory_order_relaxed);
+    iree_atomic_store_int32(&barrier->generation, generation + 1,
+                            iree_memory_order_release);
+    iree_notification_post(&barrier->notification, IREE_ALL_WAITERS);
+    return;
+  }
+  iree_uk_e2e_matmul_barrier_wait_t wait = {.barrier = barrier,
+                                            .generation = generation};
+  iree_notification_await(&barrier->notification,
+                          iree_uk_e2e_matmul_barrier_passed, &wait,
+                          iree_infinite_timeout());
+}
+
+// The ops making up the matmul, run one after the other like dispatches,
+// each sharded into workgroups that threads pick up until none are left.
+typedef enum iree_uk_e2e_matmul_phase_e {
+  // Packs LHS, RHS and, if accumulating, the initial OUT, which are
+  // independent of each other.
+  IREE_UK_E2E_MATMUL_PHASE_PACK,
+  IREE_UK_E2E_MATMUL_PHASE_MMT4D,
+  IREE_UK_E2E_MATMUL_PHASE_UNPACK,
+  IREE_UK_E2E_MATMUL_PHASE_COUNT,
+} iree_uk_e2e_matmul_phase_t;
+
+typedef struct iree_uk_e2e_matmul_shards_t {
+  // The whole ops, which workgroups run slices of.
+  const iree_uk_pack_params_t* pack_lhs_params;
+  const iree_uk_pack_params_t* pack_rhs_params;
+  const iree_uk_pack_params_t* pack_out_params;
+  const iree_uk_mmt4d_params_t* mmt4d_params;
+  const iree_uk_unpack_params_t* unpack_out_params;
+  // Workgroup sizes, in M1 and N1 tiles, and workgroup counts along M and N.
+  int workgroup_M1;
+  int workgroup_N1;
+  int workgroup_count_M;
+  int workgroup_count_N;
+  int workgroup_counts[IREE_UK_E2E_MATMUL_PHASE_COUNT];
+  // Index of the next workgroup to run in each phase. Reset before starting
+  // each matmul, while all worker threads wait on `barrier`.
+  iree_atomic_int32_t next_workgroup[IREE_UK_E2E_MATMUL_PHASE_COUNT];
+  iree_uk_e2e_matmul_barrier_t barrier;
+  iree_atomic_int32_t should_stop;
+} iree_uk_e2e_matmul_shards_t;
+
+// Packs rows [M1_begin * M0, M1_end * M0) of a row-major [M, size1] matrix
+// into tiles [M1_begin, M1_end) of the packed [M1, size1_1, M0, size1_0]
+// output of `params`. Also used for the transposed RHS pack, whose rows are
+// the columns of the row-major RHS matrix.
+static void iree_uk_e2e_matmul_pack_rows(const iree_uk_pack_params_t* params,
+                                         bool transpose, int M1_begin,
+                                         int M1_end) {
+  iree_uk_pack_params_t slice = *params;
+  iree_uk_index_t row_begin = M1_begin * params->out_size2;
+  iree_uk_index_t rows = iree_uk_index_min(
+      (M1_end - M1_begin) * params->out_size2,
+      (transpose ? params->in_size1 : params->in_size0) - row_begin);
+  slice.out_offset += M1_begin * params->out_stride0;
+  slice.out_size0 = M1_end - M1_begin;
+  if (transpose) {
+    slice.in_offset += row_begin;
+    slice.in_size1 = rows;
+  } else {
+    slice.in_offset += row_begin * params->in_stride0;
+    slice.in_size0 = rows;
+  }
+  iree_uk_pack_p(&slice);
+}
+
+// Returns in [*begin, *end) the range of tiles of the `index`-th workgroup
+// along a dimension of `size` tiles, split in workgroups of `workgroup_size`.
+static void iree_uk_e2e_matmul_workgroup_range(int index, int workgroup_size,
+                                               int size, int* begin,
+                                               int* end) {
+  *begin = index * workgroup_size;
+  *end = iree_uk_index_min(size, *begin + workgroup_size);
+}
+
+static void iree_uk_e2e_matmul_run_workgroup(
+    const iree_uk_e2e_matmul_shards_t* shards,
+    iree_uk_e2e_matmul_phase_t phase, int workgroup) {
+  const iree_uk_mmt4d_params_t* mmt4d_params = shards->mmt4d_params;
+  int M1_begin = 0, M1_end = 0, N1_begin = 0, N1_end = 0;
+  switch (phase) {
+    case IREE_UK_E2E_MATMUL_PHASE_PACK: {
+      // Workgroups packing LHS, then RHS, then OUT.
+      if (workgroup < shards->workgroup_count_M) {
+        iree_uk_e2e_matmul_workgroup_range(workgroup, shards->workgroup_M1,
+                                           mmt4d_params->M, &M1_begin,
+                                           &M1_end);
+        iree_uk_e2e_matmul_pack_rows(shards->pack_lhs_params, false, M1_begin,
+                                     M1_end);
+        return;
+      }
+      workgroup -= shards->workgroup_count_M;
+      if (workgroup < shards->workgroup_count_N) {
+        iree_uk_e2e_matmul_workgroup_range(workgroup, shards->workgroup_N1,
+                                           mmt4d_params->N, &N1_begin,
+                                           &N1_end);
+        iree_uk_e2e_matmul_pack_rows(shards->pack_rhs_params, true, N1_begin,
+                                     N1_end);
+        return;
+      }
+      workgroup -= shards->workgroup_count_N;
+      iree_uk_e2e_matmul_workgroup_range(workgroup, shards->workgroup_M1,
+                                         mmt4d_params->M, &M1_begin, &M1_end);
+      iree_uk_e2e_matmul_pack_rows(shards->pack_out_params, false, M1_begin,
+                                   M1_end);
+      return;
+    }
+    case IREE_UK_E2E_MATMUL_PHASE_MMT4D: {
+      iree_uk_e2e_matmul_workgroup_range(
+          workgroup % shards->workgroup_count_M, shards->workgroup_M1,
+          mmt4d_params->M, &M1_begin, &M1_end);
+      iree_uk_e2e_matmul_workgroup_range(
+          workgroup / shards->workgroup_count_M, shards->workgroup_N1,
+          mmt4d_params->N, &N1_begin, &N1_end);
+      iree_uk_mmt4d_params_t slice = *mmt4d_params;
+      slice.lhs_offset += M1_begin * mmt4d_params->lhs_stride0;
+      slice.rhs_offset += N1_begin * mmt4d_params->rhs_stride0;
+      slice.out_offset += M1_begin * mmt4d_params->out_stride0 +
+                          N1_begin * mmt4d_params->M0 * mmt4d_params->N0;
+      slice.M = M1_end - M1_begin;
+      slice.N = N1_end - N1_begin;
+      iree_uk_mmt4d_p(&slice);
+      return;
+    }
+    case IREE_UK_E2E_MATMUL_PHASE_UNPACK: {
+      iree_uk_e2e_matmul_workgroup_range(workgroup, shards->workgroup_M1,
+                                         mmt4d_params->M, &M1_begin, &M1_end);
+      const iree_uk_unpack_params_t* params = shards->unpack_out_params;
+      iree_uk_unpack_params_t slice = *params;
+      iree_uk_index_t row_begin = M1_begin * params->in_size2;
+      slice.in_offset += M1_begin * params->in_stride0;
+      slice.in_size0 = M1_end - M1_begin;
+      slice.out_offset += row_begin * params->out_stride0;
+      slice.out_size0 =
+          iree_uk_index_min((M1_end - M1_begin) * params->in_size2,
+                            params->out_size0 - row_begin);
+      iree_uk_unpack_p(&slice);
+      return;
+    }
+    default:
+      IREE_UK_ASSERT(false);
   }
-  iree_uk_mmt4d_p(mmt4d_params);
-  iree_uk_unpack_p(unpack_out_params);
+}
+
+// Runs one matmul on the calling thread together with all worker threads.
+static void iree_uk_e2e_matmul_run_phases(iree_uk_e2e_matmul_shards_t* shards) {
+  for (int phase = 0; phase < IREE_UK_E2E_MATMUL_PHASE_COUNT; ++phase) {
+    while (true) {
+      int workgroup = iree_atomic_fetch_add_int32(
+          &shards->next_workgroup[phase], 1, iree_memory_order_relaxed);
+      if (workgroup >= shards->workgroup_counts[phase]) break;
+      iree_uk_e2e_matmul_run_workgroup(shards, phase, workgroup);
+    }
+    // Like between dispatches, the next op waits for this one to complete.
+    iree_uk_e2e_matmul_barrier_wait(&shards->barrier);
+  }
+}
+
+static int iree_uk_e2e_matmul_worker_main(void* arg) {
+  iree_uk_e2e_matmul_shards_t* shards = arg;
+  while (true) {
+    iree_uk_e2e_matmul_barrier_wait(&shards->barrier);
+    if (iree_atomic_load_int32(&shards->should_stop,
+                               iree_memory_order_relaxed)) {
+      return 0;
+    }
+    iree_uk_e2e_matmul_run_phases(shards);
+  }
+}
+
+// Runs one matmul. Called on the benchmark thread, which counts as one of the
+// `threads`: the worker threads are waiting on the barrier until it starts.
+static void iree_uk_e2e_matmul(iree_uk_e2e_matmul_shards_t* shards) {
+  for (int phase = 0; phase < IREE_UK_E2E_MATMUL_PHASE_COUNT; ++phase) {
+    iree_atomic_store_int32(&shards->next_workgroup[phase], 0,
+                            iree_memory_order_relaxed);
+  }
+  iree_uk_e2e_matmul_barrier_wait(&shards->barrier);
+  iree_uk_e2e_matmul_run_phases(shards);
 }
 
 static iree_status_t iree_uk_benchmark_e2e_matmul(
@@ -326,13 +547,44 @@ static iree_status_t iree_uk_benchmark_e2e_matmul(
   unpack_out_params.in_buffer = packed_out_buffer;
   unpack_out_params.out_buffer = rowmajor_out_buffer;
 
+  bool accumulate = params->mmt4d_flags & IREE_UK_FLAG_MMT4D_ACCUMULATE;
+  iree_uk_e2e_matmul_shards_t shards = {
+      .pack_lhs_params = &pack_lhs_params,
+      .pack_rhs_params = &pack_rhs_params,
+      .pack_out_params = &pack_out_params,
+      .mmt4d_params = &mmt4d_params,
+      .unpack_out_params = &unpack_out_params,
+      .workgroup_M1 = iree_uk_ceildiv(iree_max(params->workgroup_M, 1), M0),
+      .workgroup_N1 = iree_uk_ceildiv(iree_max(params->workgroup_N, 1), N0),
+  };
+  shards.workgroup_count_M = iree_uk_ceildiv(M1, shards.workgroup_M1);
+  shards.workgroup_count_N = iree_uk_ceildiv(N1, shards.workgroup_N1);
+  shards.workgroup_counts[IREE_UK_E2E_MATMUL_PHASE_PACK] =
+      shards.workgroup_count_M * (accumulate ? 2 : 1) +
+      shards.workgroup_count_N;
+  shards.workgroup_counts[IREE_UK_E2E_MATMUL_PHASE_MMT4D] =
+      shards.workgroup_count_M * shards.workgroup_count_N;
+  shards.workgroup_counts[IREE_UK_E2E_MATMUL_PHASE_UNPACK] =
+      shards.workgroup_count_M;
+  int threads = iree_max(params->threads, 1);
+  shards.barrier.count = threads;
+  iree_notification_initialize(&shards.barrier.notification);
+  iree_thread_t** workers = calloc(threads, sizeof *workers);
+  for (int i = 1; i < threads; ++i) {
+    iree_thread_create_params_t thread_params;
+    memset(&thread_params, 0, sizeof thread_params);
+    thread_params.name = iree_make_cstring_view("e2e_matmul_worker");
+    IREE_CHECK_OK(iree_thread_create(iree_uk_e2e_matmul_worker_main, &shards,
+                                     thread_params, iree_allocator_system(),
+                                     &workers[i]));
+  }
+
   int64_t num_mul_adds =
       (int64_t)params->M * (int64_t)params->N * (int64_t)params->K;
   // For small problem sizes we check results against reference code.
   if (num_mul_adds <= 512 * 512 * 512) {
     // Run once before the benchmark loop to check numerical correctness.
-    iree_uk_e2e_matmul(&pack_lhs_params, &pack_rhs_params, &pack_out_params,
-                       &mmt4d_params, &unpack_out_params);
+    iree_uk_e2e_matmul(&shards);
     // Get the reference results to compare against.
     void* rowmajor_reference_out_buffer = malloc(rowmajor_out_buffer_size);
     memcpy(rowmajor_reference_out_buffer, rowmajor_init_out_buffer,
@@ -354,14 +606,53 @@ static iree_status_t iree_uk_benchmark_e2e_matmul(
   int64_t total_iterations = 0;
   while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
     for (int i = 0; i < batch_count; ++i) {
-      iree_uk_e2e_matmul(&pack_lhs_params, &pack_rhs_params, &pack_out_params,
-                         &mmt4d_params, &unpack_out_params);
+      iree_uk_e2e_matmul(&shards);
     }
     total_iterations += batch_count;
     batch_count *= 2;
   }
+
+  // Release the workers from the barrier they are waiting on, to exit.
+  iree_atomic_store_int32(&shards.should_stop, 1, iree_memory_order_relaxed);
+  iree_uk_e2e_matmul_barrier_wait(&shards.barrier);
+  for (int i = 1; i < threads; ++i) {
+    // Releasing the last reference joins the thread.
+    iree_thread_release(workers[i]);
+  }
+  free(workers);
+  iree_notification_deinitialize(&shards.barrier.notification);
+
+  // Report the memory traffic that each op has to do at least, reading its
+  // inputs and writing its output once. Together with the arithmetic, this
+  // places the matmul on the roofline of the CPU.
+  int64_t flops = 2 * num_mul_adds;
+  int64_t bytes = rowmajor_lhs_buffer_size + rowmajor_rhs_buffer_size +
+                  2 * packed_lhs_buffer_size + 2 * packed_rhs_buffer_size +
+                  2 * packed_out_buffer_size + rowmajor_out_buffer_size;
+  if (accumulate) {
+    bytes += rowmajor_out_buffer_size + 2 * packed_out_buffer_size;
+  }
   iree_benchmark_set_items_processed(benchmark_state,
-                                     total_iterations * 2 * num_mul_adds);
+                                     total_iterations * flops);
+  iree_benchmark_set_bytes_processed(benchmark_state,
+                                     total_iterations * bytes);
+  double arithmetic_intensity = (double)flops / bytes;
+  iree_benchmark_set_counter(benchmark_state, "threads", threads,
+                             IREE_BENCHMARK_COUNTER_FLAG_NONE);
+  iree_benchmark_set_counter(benchmark_state, "flop/B", arithmetic_intensity,
+                             IREE_BENCHMARK_COUNTER_FLAG_NONE);
+  iree_benchmark_set_counter(benchmark_state, "flop/s/thread",
+                             (double)total_iterations * flops / threads,
+                             IREE_BENCHMARK_COUNTER_FLAG_IS_RATE);
+  if (FLAG_peak_gflops_per_thread > 0 && FLAG_peak_memory_gbps > 0) {
+    double attainable_flops_per_second =
+        1e9 * iree_min(FLAG_peak_gflops_per_thread * threads,
+                       FLAG_peak_memory_gbps * arithmetic_intensity);
+    iree_benchmark_set_counter(
+        benchmark_state, "roofline_fraction",
+        (double)total_iterations * flops / attainable_flops_per_second,
+        IREE_BENCHMARK_COUNTER_FLAG_IS_RATE);
+  }
 
   free(rowmajor_lhs_buffer);
   free(rowmajor_rhs_buffer);
@@ -387,14 +678,27 @@ iree_uk_uint32_t iree_uk_mmt4d_parse_type_into_flag(const char* type) {
 
 static void iree_uk_benchmark_register_e2e_matmul(const char* type_str, int M,
                                                   int K, int N, bool accumulate,
+                                                  int threads,
                                                   const char* cpu_features) {
   char name[128];
-  snprintf(name, sizeof name, "e2e_matmul_%s_%dx%dx%d", type_str, M, K, N);
+  int name_length = snprintf(name, sizeof name, "e2e_matmul_%s_%dx%dx%d",
+                             type_str, M, K, N);
+  if (threads > 1) {
+    snprintf(name + name_length, sizeof name - name_length, "_%dthreads",
+             threads);
+  }
   iree_uk_uint32_t mmt4d_flags = iree_uk_mmt4d_parse_type_into_flag(type_str);
   mmt4d_flags |= IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION;
   if (accumulate) mmt4d_flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
   iree_uk_benchmark_e2e_matmul_params_t params = {
-      .mmt4d_flags = mmt4d_flags, .M = M, .K = K, .N = N};
+      .mmt4d_flags = mmt4d_flags,
+      .M = M,
+      .K = K,
+      .N = N,
+      .threads = threads,
+      .workgroup_M = FLAG_workgroup_M,
+      .workgroup_N = FLAG_workgroup_N,
+  };
   iree_uk_benchmark_register(name, iree_uk_benchmark_e2e_matmul, &params,
                              sizeof params, cpu_features);
 }
@@ -403,10 +707,15 @@ int main(int argc, char** argv) {
   iree_flags_set_usage(
       "e2e_matmul_benchmark",
       "Benchmark an end-to-end matmul by chaining together multiple ukernels: "
-      "query_tile_sizes, pack, mmt4d, unpack.");
+      "query_tile_sizes, pack, mmt4d, unpack. With --threads, each op is "
+      "sharded into workgroups run by that many threads, so that the results "
+      "account for the contention between cores. Results can be written as "
+      "JSON with --benchmark_out=<file> --benchmark_out_format=json, to "
+      "compare across commits.");
   iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_UNDEFINED_OK, &argc, &argv);
   iree_uk_benchmark_initialize(&argc, argv);
   iree_uk_benchmark_register_e2e_matmul(FLAG_type, FLAG_M, FLAG_K, FLAG_N,
-                                        FLAG_accumulate, FLAG_cpu_features);
+                                        FLAG_accumulate, FLAG_threads,
+                                        FLAG_cpu_features);
   iree_uk_benchmark_run_and_cleanup();
 }
@@ -0,0 +1,372 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// Offline autotuner for mmt4d tile sizes.
+//
+// The compiler picks mmt4d tile sizes from per-ISA tables, which know nothing
+// about the cache sizes or microarchitecture of the actual CPU. This tool
+// times the mmt4d ukernel on the host for every M0xN0xK0 tile that has an
+// architecture-specific tile function with the available CPU features, then
+// sweeps the outer blocking (workgroup sizes) for the fastest tile, and writes
+// the results as a JSON tuning database. That file can be passed to the
+// compiler as --iree-llvmcpu-mmt4d-tuning-database, which will use its entries
+// for targets whose --iree-llvmcpu-target-cpu matches the --cpu flag given
+// here.
+//
+// Only the mmt4d op itself is timed, on pre-packed buffers: its cost dominates
+// that of the pack and unpack ops, which do not depend much on the tile shape.
+// The throughput is computed from the useful (unpadded) M x N x K work, so that
+// padding to a tile wider than a narrow matmul counts against that tile.
+//
+// Example:
+//   mmt4d_autotune --cpu=znver4 --types=f32f32f32,i8i8i32 --output=znver4.json
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/flags.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/mmt4d_internal.h"
+#include "iree/builtins/ukernel/tools/util.h"
+#include "iree/schemas/cpu_data.h"
+
+IREE_FLAG(string, cpu, "",
+          "Required. LLVM name of the host CPU, as it would be passed to "
+          "--iree-llvmcpu-target-cpu, e.g. \"znver4\" or \"neoverse-v1\". The "
+          "results are recorded for that name.");
+IREE_FLAG(
+    string, cpu_features, "host",
+    "Name of standard CPU features set to enable, or \"host\" to detect the "
+    "host CPU capabilities. Other values are like in other benchmarks, e.g. "
+    "\"avx2_fma\", \"avx512_base\".");
+IREE_FLAG(string, types, "f32f32f32,f16f16f32,bf16bf16f32,i8i8i32",
+          "Comma-separated list of element types triples (LHS, RHS, OUT) to "
+          "tune. Valid values: f32f32f32, f16f16f32, f16f16f16, bf16bf16f32, "
+          "bf16bf16bf16, i8i8i32, i16i16i32.");
+IREE_FLAG(int32_t, M, 512,
+          "M dimension size of the matmul timed for non-narrow cases. Narrow "
+          "cases (M <= 16) are tuned separately.");
+IREE_FLAG(int32_t, N, 512, "N dimension size of the matmuls timed.");
+IREE_FLAG(int32_t, K, 512, "K dimension size of the matmuls timed.");
+IREE_FLAG(int32_t, min_time_ms, 20,
+          "Minimum time to run each candidate configuration for.");
+IREE_FLAG(string, output, "",
+          "Path of the tuning database to write. If empty, it is written to "
+          "stdout.");
+
+typedef struct iree_uk_autotune_type_t {
+  const char* name;
+  iree_uk_uint32_t flags;
+} iree_uk_autotune_type_t;
+
+// The names are the compiler's spelling of the element types, which is what
+// the tuning database entries are matched against.
+static const iree_uk_autotune_type_t iree_uk_autotune_types[] = {
+    {"f32f32f32", IREE_UK_FLAG_MMT4D_TYPE_F32F32F32},
+    {"f16f16f32", IREE_UK_FLAG_MMT4D_TYPE_F16F16F32},
+    {"f16f16f16", IREE_UK_FLAG_MMT4D_TYPE_F16F16F16},
+    {"bf16bf16f32", IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32},
+    {"bf16bf16bf16", IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16},
+    {"i8i8i32", IREE_UK_FLAG_MMT4D_TYPE_S8S8S32},
+    {"i16i16i32", IREE_UK_FLAG_MMT4D_TYPE_S16S16S32},
+};
+
+// Tile sizes to try. Tiles without an architecture-specific tile function are
+// skipped: they would only run the slow generic fallback.
+static const int iree_uk_autotune_M0_values[] = {1, 2, 4, 8, 16, 32};
+static const int iree_uk_autotune_N0_values[] = {4, 8, 16, 32, 64};
+static const int iree_uk_autotune_K0_values[] = {1, 2, 4, 8, 16};
+
+// Workgroup sizes to try along M and N, in elements. Rounded up to multiples
+// of the tile size like in e2e_matmul_benchmark.
+static const int iree_uk_autotune_workgroup_values[] = {16,  32,  64,
+                                                        128, 256, 512};
+// Workgroup size used while comparing tiles, before sweeping workgroup sizes.
+static const int iree_uk_autotune_default_workgroup = 64;
+
+// Narrow-M sizes tuned separately. The compiler looks these up by rounding the
+// narrow M size of a matmul up to a power of two.
+static const int iree_uk_autotune_narrow_M_values[] = {1, 2, 4, 8, 16};
+
+typedef struct iree_uk_autotune_result_t {
+  int M0;
+  int N0;
+  int K0;
+  int workgroup_M;
+  int workgroup_N;
+  double gflops;
+} iree_uk_autotune_result_t;
+
+// Packed buffers for one tile shape and matmul size.
+typedef struct iree_uk_autotune_problem_t {
+  iree_uk_mmt4d_params_t params;
+  int M;
+  int N;
+  int K;
+  void* lhs_buffer;
+  void* rhs_buffer;
+  void* out_buffer;
+} iree_uk_autotune_problem_t;
+
+static int iree_uk_autotune_ceildiv(int a, int b) { return (a + b - 1) / b; }
+
+static void iree_uk_autotune_problem_initialize(
+    iree_uk_uint32_t flags, int M, int N, int K, int M0, int N0, int K0,
+    const iree_uk_uint64_t* cpu_data, iree_uk_autotune_problem_t* problem) {
+  memset(problem, 0, sizeof *problem);
+  problem->M = M;
+  problem->N = N;
+  problem->K = K;
+  iree_uk_mmt4d_params_t* params = &problem->params;
+  params->flags = flags | IREE_UK_FLAG_MMT4D_SKIP_INTERMEDIATE_ROUNDINGS;
+  params->cpu_data = cpu_data;
+  params->M0 = M0;
+  params->N0 = N0;
+  params->K0 = K0;
+  params->M = iree_uk_autotune_ceildiv(M, M0);
+  params->N = iree_uk_autotune_ceildiv(N, N0);
+  params->K = iree_uk_autotune_ceildiv(K, K0);
+  params->lhs_stride0 = params->K * M0 * K0;
+  params->rhs_stride0 = params->K * N0 * K0;
+  params->out_stride0 = params->N * M0 * N0;
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
+  iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+  iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+  iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+  iree_uk_index_t lhs_buffer_size =
+      iree_uk_2d_buffer_length(lhs_type, params->M, params->lhs_stride0);
+  iree_uk_index_t rhs_buffer_size =
+      iree_uk_2d_buffer_length(rhs_type, params->N, params->rhs_stride0);
+  iree_uk_index_t out_buffer_size =
+      iree_uk_2d_buffer_length(out_type, params->M, params->out_stride0);
+  problem->lhs_buffer = malloc(lhs_buffer_size);
+  problem->rhs_buffer = malloc(rhs_buffer_size);
+  problem->out_buffer = malloc(out_buffer_size);
+  iree_uk_random_engine_t engine = iree_uk_random_engine_init();
+  iree_uk_write_random_buffer(problem->lhs_buffer, lhs_buffer_size, lhs_type,
+                              &engine);
+  iree_uk_write_random_buffer(problem->rhs_buffer, rhs_buffer_size, rhs_type,
+                              &engine);
+  iree_uk_write_random_buffer(problem->out_buffer, out_buffer_size, out_type,
+                              &engine);
+  params->lhs_buffer = problem->lhs_buffer;
+  params->rhs_buffer = problem->rhs_buffer;
+  params->out_buffer = problem->out_buffer;
+}
+
+static void iree_uk_autotune_problem_deinitialize(
+    iree_uk_autotune_problem_t* problem) {
+  free(problem->lhs_buffer);
+  free(problem->rhs_buffer);
+  free(problem->out_buffer);
+}
+
+// Runs the whole matmul once, as a sequence of mmt4d calls on workgroups of
+// workgroup_M1 x workgroup_N1 tiles, in the order a dispatch would.
+static void iree_uk_autotune_run_once(const iree_uk_autotune_problem_t* problem,
+                                      int workgroup_M1, int workgroup_N1) {
+  const iree_uk_mmt4d_params_t* params = &problem->params;
+  iree_uk_mmt4d_params_t workgroup_params;
+  memcpy(&workgroup_params, params, sizeof workgroup_params);
+  for (iree_uk_index_t m1 = 0; m1 < params->M; m1 += workgroup_M1) {
+    for (iree_uk_index_t n1 = 0; n1 < params->N; n1 += workgroup_N1) {
+      workgroup_params.M = iree_uk_index_min(workgroup_M1, params->M - m1);
+      workgroup_params.N = iree_uk_index_min(workgroup_N1, params->N - n1);
+      workgroup_params.lhs_offset = m1 * params->lhs_stride0;
+      workgroup_params.rhs_offset = n1 * params->rhs_stride0;
+      workgroup_params.out_offset =
+          m1 * params->out_stride0 + n1 * params->M0 * params->N0;
+      iree_uk_mmt4d_p(&workgroup_params);
+    }
+  }
+}
+
+// Returns the throughput in GFLOP/s of the useful work of the matmul, running
+// it repeatedly for at least --min_time_ms after a warm-up run.
+static double iree_uk_autotune_time(const iree_uk_autotune_problem_t* problem,
+                                    int workgroup_M, int workgroup_N) {
+  int workgroup_M1 = iree_uk_autotune_ceildiv(workgroup_M, problem->params.M0);
+  int workgroup_N1 = iree_uk_autotune_ceildiv(workgroup_N, problem->params.N0);
+  iree_uk_autotune_run_once(problem, workgroup_M1, workgroup_N1);
+  iree_time_t min_duration_ns = (iree_time_t)FLAG_min_time_ms * 1000000;
+  iree_time_t start_ns = iree_time_now();
+  iree_time_t elapsed_ns = 0;
+  int64_t iterations = 0;
+  do {
+    iree_uk_autotune_run_once(problem, workgroup_M1, workgroup_N1);
+    ++iterations;
+    elapsed_ns = iree_time_now() - start_ns;
+  } while (elapsed_ns < min_duration_ns);
+  double flops =
+      2.0 * problem->M * problem->N * problem->K * (double)iterations;
+  return flops / (double)iree_max(elapsed_ns, 1);
+}
+
+// Tunes one element types triple and matmul M size: first compares all
+// candidate tiles with the default workgroup size, then sweeps workgroup sizes
+// for the best tile. Returns false if no tile has an architecture-specific
+// tile function.
+static bool iree_uk_autotune_one(iree_uk_uint32_t flags, int M,
+                                 const iree_uk_uint64_t* cpu_data,
+                                 iree_uk_autotune_result_t* out_result) {
+  memset(out_result, 0, sizeof *out_result);
+  for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_autotune_M0_values); ++i) {
+    for (int j = 0; j < IREE_ARRAYSIZE(iree_uk_autotune_N0_values); ++j) {
+      for (int k = 0; k < IREE_ARRAYSIZE(iree_uk_autotune_K0_values); ++k) {
+        iree_uk_mmt4d_params_t info_params = {
+            .flags = flags,
+            .M0 = iree_uk_autotune_M0_values[i],
+            .N0 = iree_uk_autotune_N0_values[j],
+            .K0 = iree_uk_autotune_K0_values[k],
+            .cpu_data = cpu_data,
+        };
+        const iree_uk_uint32_t have_arch_tile_func =
+            IREE_UK_FLAG_MMT4D_INFO_HAVE_ARCHITECTURE_SPECIFIC_TILE_FUNCTION;
+        if (!(iree_uk_mmt4d_info_p(&info_params) & have_arch_tile_func)) {
+          continue;
+        }
+        iree_uk_autotune_problem_t problem;
+        iree_uk_autotune_problem_initialize(
+            flags, M, FLAG_N, FLAG_K, info_params.M0, info_params.N0,
+            info_params.K0, cpu_data, &problem);
+        double gflops =
+            iree_uk_autotune_time(&problem, iree_uk_autotune_default_workgroup,
+                                  iree_uk_autotune_default_workgroup);
+        iree_uk_autotune_problem_deinitialize(&problem);
+        fprintf(stderr, "  M=%d tile %dx%dx%d: %.2f GFLOP/s\n", M,
+                info_params.M0, info_params.N0, info_params.K0, gflops);
+        if (gflops > out_result->gflops) {
+          out_result->M0 = info_params.M0;
+          out_result->N0 = info_params.N0;
+          out_result->K0 = info_params.K0;
+          out_result->workgroup_M = iree_uk_autotune_default_workgroup;
+          out_result->workgroup_N = iree_uk_autotune_default_workgroup;
+          out_result->gflops = gflops;
+        }
+      }
+    }
+  }
+  if (!out_result->M0) return false;
+
+  iree_uk_autotune_problem_t problem;
+  iree_uk_autotune_problem_initialize(flags, M, FLAG_N, FLAG_K, out_result->M0,
+                                      out_result->N0, out_result->K0, cpu_data,
+                                      &problem);
+  for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_autotune_workgroup_values); ++i) {
+    int workgroup_M = iree_uk_autotune_workgroup_values[i];
+    // Larger workgroups than the whole matmul all behave the same.
+    if (i > 0 && iree_uk_autotune_workgroup_values[i - 1] >= M) break;
+    for (int j = 0; j < IREE_ARRAYSIZE(iree_uk_autotune_workgroup_values);
+         ++j) {
+      int workgroup_N = iree_uk_autotune_workgroup_values[j];
+      if (j > 0 && iree_uk_autotune_workgroup_values[j - 1] >= FLAG_N) break;
+      double gflops = iree_uk_autotune_time(&problem, workgroup_M, workgroup_N);
+      if (gflops > out_result->gflops) {
+        out_result->workgroup_M = workgroup_M;
+        out_result->workgroup_N = workgroup_N;
+        out_result->gflops = gflops;
+      }
+    }
+  }
+  iree_uk_autotune_problem_deinitialize(&problem);
+  fprintf(stderr, "  M=%d best: tile %dx%dx%d, workgroup %dx%d: %.2f GFLOP/s\n",
+          M, out_result->M0, out_result->N0, out_result->K0,
+          out_result->workgroup_M, out_result->workgroup_N, out_result->gflops);
+  return true;
+}
+
+static void iree_uk_autotune_write_entry(
+    FILE* file, bool* first_entry, const char* type_name, int narrow_M,
+    const iree_uk_autotune_result_t* result) {
+  fprintf(file,
+          "%s\n    {\"cpu\": \"%s\", \"type\": \"%s\", \"narrow_m\": %d, "
+          "\"M0\": %d, \"N0\": %d, \"K0\": %d, \"workgroup_M\": %d, "
+          "\"workgroup_N\": %d, \"gflops\": %.2f}",
+          *first_entry ? "" : ",", FLAG_cpu, type_name, narrow_M, result->M0,
+          result->N0, result->K0, result->workgroup_M, result->workgroup_N,
+          result->gflops);
+  *first_entry = false;
+}
+
+static const iree_uk_autotune_type_t* iree_uk_autotune_lookup_type(
+    iree_string_view_t name) {
+  for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_autotune_types); ++i) {
+    if (iree_string_view_equal(
+            name, iree_make_cstring_view(iree_uk_autotune_types[i].name))) {
+      return &iree_uk_autotune_types[i];
+    }
+  }
+  return NULL;
+}
+
+int main(int argc, char** argv) {
+  iree_flags_set_usage(
+      "mmt4d_autotune",
+      "Times mmt4d tile sizes and workgroup sizes on the host CPU and writes "
+      "a tuning database for --iree-llvmcpu-mmt4d-tuning-database.\n");
+  iree_flags_parse_checked(IREE_FLAGS_PARSE_MODE_DEFAULT, &argc, &argv);
+  if (!strlen(FLAG_cpu)) {
+    fprintf(stderr, "--cpu is required.\n");
+    return EXIT_FAILURE;
+  }
+  if (FLAG_M <= 0 || FLAG_N <= 0 || FLAG_K <= 0) {
+    fprintf(stderr, "--M, --N and --K must be positive.\n");
+    return EXIT_FAILURE;
+  }
+
+  iree_uk_initialize_cpu_once();
+  iree_uk_uint64_t cpu_data[IREE_CPU_DATA_FIELD_COUNT];
+  iree_uk_make_cpu_data_for_features(FLAG_cpu_features, cpu_data);
+  if (!iree_uk_cpu_supports(cpu_data)) {
+    fprintf(stderr, "CPU feature unsupported on host: %s\n",
+            iree_uk_cpu_first_unsupported_feature(cpu_data));
+    return EXIT_FAILURE;
+  }
+
+  FILE* file = stdout;
+  if (strlen(FLAG_output)) {
+    file = fopen(FLAG_output, "w");
+    if (!file) {
+      fprintf(stderr, "Failed to open %s for writing.\n", FLAG_output);
+      return EXIT_FAILURE;
+    }
+  }
+  fprintf(file, "{\n  \"version\": 1,\n  \"entries\": [");
+  bool first_entry = true;
+
+  iree_string_view_t remaining_types = iree_make_cstring_view(FLAG_types);
+  while (!iree_string_view_is_empty(remaining_types)) {
+    iree_string_view_t type_name;
+    iree_string_view_split(remaining_types, ',', &type_name, &remaining_types);
+    type_name = iree_string_view_trim(type_name);
+    const iree_uk_autotune_type_t* type =
+        iree_uk_autotune_lookup_type(type_name);
+    if (!type) {
+      fprintf(stderr, "Unhandled type: %.*s\n", (int)type_name.size,
+              type_name.data);
+      return EXIT_FAILURE;
+    }
+    fprintf(stderr, "Tuning %s\n", type->name);
+    iree_uk_autotune_result_t result;
+    if (!iree_uk_autotune_one(type->flags, FLAG_M, cpu_data, &result)) {
+      fprintf(stderr, "  no architecture-specific tile function, skipped.\n");
+      continue;
+    }
+    iree_uk_autotune_write_entry(file, &first_entry, type->name, 0, &result);
+    for (int i = 0; i < IREE_ARRAYSIZE(iree_uk_autotune_narrow_M_values);
+         ++i) {
+      int narrow_M = iree_uk_autotune_narrow_M_values[i];
+      if (iree_uk_autotune_one(type->flags, narrow_M, cpu_data, &result)) {
+        iree_uk_autotune_write_entry(file, &first_entry, type->name, narrow_M,
+                                     &result);
+      }
+    }
+  }
+
+  fprintf(file, "\n  ]\n}\n");
+  if (file != stdout) fclose(file);
+  return EXIT_SUCCESS;
+}
@@ -244,6 +244,39 @@ static void iree_mmt4d_reference_innerloop_s16s8s32(
   *out_ptr = acc;
 }
 
+// Shared by f16u4f32 and bf16u4f32. `scales_ptr` points to the scale of this
+// RHS row in the first group; the zero point follows N0 elements later.
+static void iree_mmt4d_reference_innerloop_xxu4f32(
+    float* out_ptr, const uint16_t* lhs_ptr, const uint8_t* rhs_ptr,
+    const float* scales_ptr, const iree_uk_mmt4d_params_t* params,
+    iree_uk_type_t lhs_type) {
+  // K0 must be even.
+  IREE_UK_ASSERT(!(params->K0 % 2));
+  iree_uk_int16_t K0half = params->K0 / 2;
+  float acc = params->flags & IREE_UK_FLAG_MMT4D_ACCUMULATE ? *out_ptr : 0.f;
+  for (iree_uk_index_t k = 0; k < params->K; ++k) {
+    const float* group_ptr =
+        scales_ptr + (k / params->group_size) * 2 * params->N0;
+    float scale = group_ptr[0];
+    float zero_point = group_ptr[params->N0];
+    for (iree_uk_index_t k0h = 0; k0h < K0half; ++k0h) {
+      uint16_t lhs_0 = lhs_ptr[k * params->M0 * params->K0 + 2 * k0h];
+      uint16_t lhs_1 = lhs_ptr[k * params->M0 * params->K0 + 2 * k0h + 1];
+      float lhs_0_f32 = lhs_type == IREE_UK_TYPE_FLOAT_16
+                            ? iree_math_f16_to_f32(lhs_0)
+                            : iree_math_bf16_to_f32(lhs_0);
+      float lhs_1_f32 = lhs_type == IREE_UK_TYPE_FLOAT_16
+                            ? iree_math_f16_to_f32(lhs_1)
+                            : iree_math_bf16_to_f32(lhs_1);
+      uint8_t rhs_byte = rhs_ptr[k * params->N0 * K0half + k0h];
+      float rhs_0 = ((rhs_byte & 0xf) - zero_point) * scale;
+      float rhs_1 = ((rhs_byte >> 4) - zero_point) * scale;
+      acc += lhs_0_f32 * rhs_0 + lhs_1_f32 * rhs_1;
+    }
+  }
+  *out_ptr = acc;
+}
+
 static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
   iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params->flags);
   iree_uk_index_t lhs_elem_bits =
@@ -267,6 +300,11 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
           ((const char*)params->rhs_buffer) +
           iree_uk_bits_to_bytes_exact(
               (params->rhs_offset + j * params->rhs_stride0) * rhs_elem_bits);
+      const float* scales_panel_ptr =
+          iree_uk_mmt4d_flags_is_dequant(params->flags)
+              ? (const float*)params->scales_buffer + params->scales_offset +
+                    j * params->scales_stride0
+              : 0;
 
       for (iree_uk_index_t i0 = 0; i0 < params->M0; ++i0) {
         for (iree_uk_index_t j0 = 0; j0 < params->N0; ++j0) {
@@ -330,6 +368,18 @@ static void iree_mmt4d_reference(const iree_uk_mmt4d_params_t* params) {
                   (int32_t*)out_ptr, (const int16_t*)lhs_ptr,
                   (const int8_t*)rhs_ptr, params);
               break;
+            case IREE_UK_FLAG_MMT4D_TYPE_F16U4F32:
+              iree_mmt4d_reference_innerloop_xxu4f32(
+                  (float*)out_ptr, (const uint16_t*)lhs_ptr,
+                  (const uint8_t*)rhs_ptr, scales_panel_ptr + j0, params,
+                  IREE_UK_TYPE_FLOAT_16);
+              break;
+            case IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32:
+              iree_mmt4d_reference_innerloop_xxu4f32(
+                  (float*)out_ptr, (const uint16_t*)lhs_ptr,
+                  (const uint8_t*)rhs_ptr, scales_panel_ptr + j0, params,
+                  IREE_UK_TYPE_BFLOAT_16);
+              break;
             default:
               IREE_UK_ASSERT(false && "unhandled type");
           }
@@ -400,6 +450,33 @@ static void iree_uk_test_mmt4d_for_shape_params(
       (const char*)rhs_buffer -
       iree_uk_bits_to_bytes_exact(params.rhs_offset
                                   << iree_uk_type_bit_count_log2(rhs_type));
+  bool is_dequant = iree_uk_mmt4d_flags_is_dequant(params.flags);
+  float* scales_buffer = 0;
+  if (is_dequant) {
+    // One [2][N0] block of scales and zero points per group of K-tiles.
+    iree_uk_index_t group_count =
+        (params.K + params.group_size - 1) / params.group_size;
+    params.scales_stride0 = iree_uk_test_random_stride(
+        group_count * 2 * params.N0, IREE_UK_TYPE_FLOAT_32, engine);
+    iree_uk_index_t scales_buffer_size = iree_uk_2d_buffer_length(
+        IREE_UK_TYPE_FLOAT_32, params.N, params.scales_stride0);
+    scales_buffer = malloc(scales_buffer_size);
+    iree_uk_write_random_buffer(scales_buffer, scales_buffer_size,
+                                IREE_UK_TYPE_FLOAT_32, engine);
+    // Zero points are in the u4 range, like the quantized values.
+    for (iree_uk_index_t n = 0; n < params.N; ++n) {
+      for (iree_uk_index_t g = 0; g < group_count; ++g) {
+        float* zero_points = scales_buffer + n * params.scales_stride0 +
+                             g * 2 * params.N0 + params.N0;
+        for (iree_uk_index_t n0 = 0; n0 < params.N0; ++n0) {
+          zero_points[n0] = iree_uk_random_engine_get_0_255(engine) % 16;
+        }
+      }
+    }
+    params.scales_offset =
+        iree_uk_test_random_offset(IREE_UK_TYPE_FLOAT_32, engine);
+    params.scales_buffer = scales_buffer - params.scales_offset;
+  }
 
   iree_uk_mmt4d_params_t reference_params;
   memcpy(&reference_params, &params, sizeof params);
@@ -425,7 +502,11 @@ static void iree_uk_test_mmt4d_for_shape_params(
                                   << iree_uk_type_bit_count_log2(out_type));
 
   iree_mmt4d_reference(&reference_params);
-  iree_uk_mmt4d_p(&actual_params);
+  if (is_dequant) {
+    iree_uk_mmt4d_dequant_p(&actual_params);
+  } else {
+    iree_uk_mmt4d_p(&actual_params);
+  }
 
   // For now we use exact comparisons, even for float, even though the reference
   // code accumulates in a different order compared to the actual code. This
@@ -444,6 +525,7 @@ static void iree_uk_test_mmt4d_for_shape_params(
   free(actual_out_buffer);
   free(lhs_buffer);
   free(rhs_buffer);
+  free(scales_buffer);
 }
 
 static void iree_uk_test_mmt4d_for_tile_params(iree_uk_test_t* test,
@@ -496,9 +578,18 @@ static void iree_uk_test_mmt4d_for_tile_params(iree_uk_test_t* test,
     params.M = shape.m;
     params.N = shape.n;
     params.K = shape.k;
-    for (int accumulate = 0; accumulate <= 1; ++accumulate) {
-      if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
-      iree_uk_test_mmt4d_for_shape_params(test, &params);
+    // Dequantizing kernels are also tested with groups spanning one K-tile,
+    // a partial last group, and a single group covering all of K.
+    const int group_sizes[] = {1, 3, shape.k > 1 ? shape.k : 1};
+    int group_size_count =
+        iree_uk_mmt4d_flags_is_dequant(params.flags) ? 3 : 1;
+    for (int g = 0; g < group_size_count; ++g) {
+      params.group_size = group_sizes[g];
+      params.flags &= ~IREE_UK_FLAG_MMT4D_ACCUMULATE;
+      for (int accumulate = 0; accumulate <= 1; ++accumulate) {
+        if (accumulate) params.flags |= IREE_UK_FLAG_MMT4D_ACCUMULATE;
+        iree_uk_test_mmt4d_for_shape_params(test, &params);
+      }
     }
   }
 }
@@ -538,6 +629,109 @@ static void iree_uk_test_mmt4d(iree_uk_uint32_t flags, int M0, int N0, int K0,
   iree_uk_test_mmt4d_impl(flags, M0, N0, K0, cpu_features);
 }
 
+// Tests iree_uk_mmt4d_grouped against per-group reference mmt4d's.
+static void iree_uk_test_mmt4d_grouped_for_tile_params(
+    iree_uk_test_t* test, const void* src_params) {
+  typedef struct grouping_t {
+    int group_count;
+    int32_t group_offsets[5];
+  } grouping_t;
+  const grouping_t groupings[] = {
+      // No groups at all. Vacuous.
+      {0, {0}},
+      // A single group covering all M-tiles.
+      {1, {0, 6}},
+      // Ragged groups including empty ones.
+      {4, {0, 1, 1, 4, 6}},
+      // Leading and trailing M-tiles outside of any group are untouched.
+      {2, {1, 3, 5}},
+  };
+  const iree_uk_index_t M = 6;
+  const iree_uk_index_t N = 3;
+  const iree_uk_index_t K = 5;
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  for (int i = 0; i < IREE_ARRAYSIZE(groupings); ++i) {
+    const grouping_t* grouping = &groupings[i];
+    iree_uk_mmt4d_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.cpu_data = iree_uk_test_cpu_data(test);
+    params.M = M;
+    params.N = N;
+    params.K = K;
+    iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(params.flags);
+    iree_uk_type_t lhs_type = iree_uk_mmt4d_lhs_type(mmt4d_type);
+    iree_uk_type_t rhs_type = iree_uk_mmt4d_rhs_type(mmt4d_type);
+    iree_uk_type_t out_type = iree_uk_mmt4d_out_type(mmt4d_type);
+    params.lhs_stride0 = iree_uk_test_random_stride(
+        params.K * params.M0 * params.K0, lhs_type, engine);
+    params.rhs_stride0 = iree_uk_test_random_stride(
+        params.K * params.N0 * params.K0, rhs_type, engine);
+    params.out_stride0 = iree_uk_test_random_stride(
+        params.N * params.M0 * params.N0, out_type, engine);
+    params.rhs_group_stride = params.N * params.rhs_stride0;
+    params.group_count = grouping->group_count;
+    params.group_offsets = grouping->group_offsets;
+    iree_uk_index_t lhs_buffer_size =
+        iree_uk_2d_buffer_length(lhs_type, params.M, params.lhs_stride0);
+    iree_uk_index_t rhs_buffer_size = iree_uk_2d_buffer_length(
+        rhs_type, (grouping->group_count + 1) * params.N, params.rhs_stride0);
+    iree_uk_index_t out_buffer_size =
+        iree_uk_2d_buffer_length(out_type, params.M, params.out_stride0);
+    void* lhs_buffer = malloc(lhs_buffer_size);
+    void* rhs_buffer = malloc(rhs_buffer_size);
+    void* reference_out_buffer = malloc(out_buffer_size);
+    void* actual_out_buffer = malloc(out_buffer_size);
+    iree_uk_write_random_buffer(lhs_buffer, lhs_buffer_size, lhs_type, engine);
+    iree_uk_write_random_buffer(rhs_buffer, rhs_buffer_size, rhs_type, engine);
+    iree_uk_write_random_buffer(reference_out_buffer, out_buffer_size,
+                                out_type, engine);
+    memcpy(actual_out_buffer, reference_out_buffer, out_buffer_size);
+    params.lhs_buffer = lhs_buffer;
+    params.rhs_buffer = rhs_buffer;
+
+    iree_uk_mmt4d_params_t actual_params = params;
+    actual_params.out_buffer = actual_out_buffer;
+    iree_uk_mmt4d_grouped_p(&actual_params);
+
+    for (int g = 0; g < grouping->group_count; ++g) {
+      iree_uk_mmt4d_params_t reference_params = params;
+      reference_params.out_buffer = reference_out_buffer;
+      iree_uk_index_t m_begin = grouping->group_offsets[g];
+      reference_params.M = grouping->group_offsets[g + 1] - m_begin;
+      reference_params.lhs_offset = m_begin * params.lhs_stride0;
+      reference_params.out_offset = m_begin * params.out_stride0;
+      reference_params.rhs_offset = g * params.rhs_group_stride;
+      iree_mmt4d_reference(&reference_params);
+    }
+
+    if (memcmp(actual_out_buffer, reference_out_buffer, out_buffer_size)) {
+      IREE_UK_TEST_FAIL(test);
+    }
+
+    free(lhs_buffer);
+    free(rhs_buffer);
+    free(reference_out_buffer);
+    free(actual_out_buffer);
+  }
+}
+
+static void iree_uk_test_mmt4d_grouped(iree_uk_uint32_t flags, int M0, int N0,
+                                       int K0) {
+  char types_str[32];
+  iree_uk_mmt4d_type_t mmt4d_type = iree_uk_mmt4d_type(flags);
+  iree_uk_type_triple_str(types_str, sizeof types_str, mmt4d_type);
+  iree_uk_mmt4d_params_t params = {
+      .flags = flags | IREE_UK_FLAG_MMT4D_ALLOW_GENERIC_FALLBACK_TILE_FUNCTION,
+      .M0 = M0,
+      .N0 = N0,
+      .K0 = K0};
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str,
+           "grouped types:%s tile:%dx%dx%d", types_str, M0, N0, K0);
+  iree_uk_test(test_label_str, iree_uk_test_mmt4d_grouped_for_tile_params,
+               &params, "");
+}
+
 int main(int argc, char** argv) {
   // Generic tests, not matching any particular CPU feature. This is the place
   // to test weird M0, N0, K0 to ensure e.g. that we haven't unwittingly baked
@@ -552,6 +746,10 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F16, 3, 5, 8, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 11, 4, 1, "");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16BF16, 2, 9, 3, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16U4F32, 3, 5, 2, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32, 5, 3, 4, "");
+  iree_uk_test_mmt4d_grouped(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 3, 5, 7);
+  iree_uk_test_mmt4d_grouped(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 9, 6, 3);
 
 #if defined(IREE_ARCH_ARM_64)
 
@@ -572,6 +770,12 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 8, 8, "i8mm");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 8, 8, 8, "dotprod");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S4S32, 4, 8, 16, "i8mm");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 16, 16, 1, "sme");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 16, 16, 2, "sme");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 16, 16, 2, "sme");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 4, "sme");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16U4F32, 8, 8, 2, "");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32, 8, 8, 2, "");
 
 #elif defined(IREE_ARCH_X86_64)
 
@@ -601,6 +805,20 @@ int main(int argc, char** argv) {
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16S16S32, 16, 16, 2,
                      "avx512_vnni");
   iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S16U4S32, 1, 32, 8, "avx512_vnni");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 16, 16, 4, "amx");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16BF16F32, 16, 16, 2, "amx");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16U4F32, 8, 8, 2, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32, 8, 8, 2, "avx2_fma");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16U4F32, 16, 16, 2,
+                     "avx512_base");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_BF16U4F32, 16, 16, 2,
+                     "avx512_base");
+
+#elif defined(IREE_ARCH_RISCV_64)
+
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F32F32F32, 8, 16, 1, "v");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_S8S8S32, 8, 16, 1, "v");
+  iree_uk_test_mmt4d(IREE_UK_FLAG_MMT4D_TYPE_F16F16F32, 8, 16, 1, "v,zvfh");
 
 #endif  // defined(IREE_ARCH_ARM_64)
 
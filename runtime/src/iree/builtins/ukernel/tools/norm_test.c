@@ -0,0 +1,194 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/elementwise_internal.h"
+#include "iree/builtins/ukernel/norm_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Allocates a [rows][stride] buffer filled with random values uniformly
+// distributed in [offset - 1, offset + 1], rounded to `type`.
+static void* iree_uk_test_norm_alloc(iree_uk_test_t* test,
+                                     iree_uk_type_t type, iree_uk_index_t rows,
+                                     iree_uk_index_t cols, float offset,
+                                     iree_uk_index_t* stride) {
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  *stride = cols + iree_uk_random_engine_get_0_1(engine) * 3;
+  iree_uk_index_t length = iree_uk_index_max(1, rows * *stride);
+  void* buffer = malloc(length * iree_uk_type_size(type));
+  for (iree_uk_index_t i = 0; i < length; ++i) {
+    float x = offset + iree_uk_random_engine_get_0_65535(engine) / 32767.5f -
+              1.0f;
+    iree_uk_elementwise_store(buffer, i, x, type);
+  }
+  return buffer;
+}
+
+static void iree_uk_test_norm_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_norm_params_t* src_params,
+    float offset) {
+  iree_uk_norm_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_type_t type = iree_uk_norm_type(params.flags);
+  bool rms = params.flags & IREE_UK_FLAG_NORM_RMS;
+  bool fast = params.flags & IREE_UK_FLAG_NORM_FAST_MATH;
+  bool has_weight = params.flags & IREE_UK_FLAG_NORM_HAS_WEIGHT;
+  bool has_bias = params.flags & IREE_UK_FLAG_NORM_HAS_BIAS;
+  iree_uk_index_t unused_stride;
+  void* in_buffer = iree_uk_test_norm_alloc(test, type, params.size0,
+                                            params.size1, offset,
+                                            &params.in_stride0);
+  void* out_buffer = iree_uk_test_norm_alloc(test, type, params.size0,
+                                             params.size1, 0.0f,
+                                             &params.out_stride0);
+  void* weight_buffer = iree_uk_test_norm_alloc(test, type, 1, params.size1,
+                                                1.0f, &unused_stride);
+  void* bias_buffer = iree_uk_test_norm_alloc(test, type, 1, params.size1,
+                                              0.0f, &unused_stride);
+  params.in_buffer = in_buffer;
+  params.out_buffer = out_buffer;
+  params.weight_buffer = has_weight ? weight_buffer : NULL;
+  params.bias_buffer = has_bias ? bias_buffer : NULL;
+  params.in_offset = 0;
+  params.out_offset = 0;
+  params.weight_offset = 0;
+  params.bias_offset = 0;
+  params.epsilon = 1e-5f;
+  params.cpu_data = iree_uk_test_cpu_data(test);
+
+  double* expected =
+      malloc(iree_uk_index_max(1, params.size0 * params.size1) *
+             sizeof(double));
+  for (iree_uk_index_t i = 0; i < params.size0; ++i) {
+    double mean = 0.0;
+    if (!rms) {
+      for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+        mean += iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j,
+                                         type);
+      }
+      mean /= params.size1;
+    }
+    double variance = 0.0;
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      double x =
+          iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j, type) -
+          mean;
+      variance += x * x;
+    }
+    variance /= params.size1;
+    double scale = 1.0 / sqrt(variance + params.epsilon);
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      double x =
+          iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j, type);
+      double y = (x - mean) * scale;
+      if (has_weight) y *= iree_uk_elementwise_load(weight_buffer, j, type);
+      if (has_bias) y += iree_uk_elementwise_load(bias_buffer, j, type);
+      expected[i * params.size1 + j] = y;
+    }
+  }
+
+  iree_uk_norm_p(&params);
+
+  // Normalized values are O(1), so an absolute tolerance is used. The fast
+  // single-pass variance loses accuracy when the mean is large compared to the
+  // standard deviation, which the tests with an offset exercise.
+  float tolerance = type == IREE_UK_TYPE_FLOAT_32
+                        ? (fast ? (offset != 0.0f ? 2e-3f : 1e-4f) : 1e-5f)
+                    : type == IREE_UK_TYPE_FLOAT_16 ? 1e-2f
+                                                    : 5e-2f;
+  for (iree_uk_index_t i = 0; i < params.size0; ++i) {
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      double e = expected[i * params.size1 + j];
+      float actual = iree_uk_elementwise_load(
+          out_buffer, i * params.out_stride0 + j, type);
+      if (!(fabs(actual - e) <= tolerance * (1.0 + fabs(e)))) {
+        IREE_UK_TEST_FAIL(test);
+        goto done;
+      }
+    }
+  }
+
+done:
+  free(expected);
+  free(bias_buffer);
+  free(weight_buffer);
+  free(out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_norm_for_flags(iree_uk_test_t* test,
+                                        const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+    float offset;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases.
+      {0, 4, 0.0f},
+      {3, 0, 0.0f},
+      // Rows shorter than, equal to, and not multiples of the reduction lanes.
+      {1, 1, 0.0f},
+      {2, 7, 0.0f},
+      {3, 16, 0.0f},
+      {5, 33, 0.0f},
+      // Hidden sizes of transformer models.
+      {4, 768, 0.0f},
+      {2, 4096, 0.0f},
+      // Inputs with a mean large compared to their standard deviation.
+      {3, 100, 8.0f},
+      {2, 1024, 8.0f},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_norm_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.size0 = shapes[i].size0;
+    params.size1 = shapes[i].size1;
+    iree_uk_test_norm_for_shape_params(test, &params, shapes[i].offset);
+  }
+}
+
+static void iree_uk_test_norm(iree_uk_uint32_t flags,
+                              const char* cpu_features) {
+  iree_uk_norm_params_t params = {.flags = flags};
+  char type_str[16];
+  iree_uk_type_str(type_str, sizeof type_str, iree_uk_norm_type(flags));
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str,
+           "type:%s rms:%d fast_math:%d weight:%d bias:%d", type_str,
+           (flags & IREE_UK_FLAG_NORM_RMS) ? 1 : 0,
+           (flags & IREE_UK_FLAG_NORM_FAST_MATH) ? 1 : 0,
+           (flags & IREE_UK_FLAG_NORM_HAS_WEIGHT) ? 1 : 0,
+           (flags & IREE_UK_FLAG_NORM_HAS_BIAS) ? 1 : 0);
+  iree_uk_test(test_label_str, iree_uk_test_norm_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t types[] = {
+      IREE_UK_FLAG_NORM_TYPE_F32,
+      IREE_UK_FLAG_NORM_TYPE_F16,
+      IREE_UK_FLAG_NORM_TYPE_BF16,
+  };
+  const iree_uk_uint32_t variants[] = {
+      0,
+      IREE_UK_FLAG_NORM_HAS_WEIGHT | IREE_UK_FLAG_NORM_HAS_BIAS,
+      IREE_UK_FLAG_NORM_RMS,
+      IREE_UK_FLAG_NORM_RMS | IREE_UK_FLAG_NORM_HAS_WEIGHT,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(types); ++i) {
+    for (int j = 0; j < IREE_ARRAYSIZE(variants); ++j) {
+      iree_uk_test_norm(types[i] | variants[j], "");
+      iree_uk_test_norm(types[i] | variants[j] | IREE_UK_FLAG_NORM_FAST_MATH,
+                        "");
+    }
+  }
+
+  return iree_uk_test_exit_status();
+}
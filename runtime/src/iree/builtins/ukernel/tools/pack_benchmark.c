@@ -7,7 +7,9 @@
 #include <stdio.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/threading.h"
 #include "iree/builtins/ukernel/api.h"
 #include "iree/builtins/ukernel/pack_internal.h"
 #include "iree/builtins/ukernel/tools/benchmark.h"
@@ -21,6 +23,89 @@ IREE_FLAG(
 IREE_FLAG(
     int32_t, padding_size, 0,
     "Padding size (same value used for both dimensions, 0 means no padding)");
+IREE_FLAG(
+    int32_t, contention_threads, 0,
+    "Number of additional threads running the same pack on their own buffers "
+    "while each benchmark runs, to measure it under the cache and memory "
+    "bandwidth contention of a multi-threaded dispatch.");
+
+// Allocates a cache-line aligned output buffer, as some tile functions using
+// streaming stores are only selected for aligned outputs.
+static void* iree_uk_pack_benchmark_alloc_out_buffer(iree_uk_index_t size) {
+  void* buffer = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc_aligned(iree_allocator_system(), size,
+                                              64, 0, &buffer));
+  return buffer;
+}
+
+static void iree_uk_pack_benchmark_free_out_buffer(void* buffer) {
+  iree_allocator_free_aligned(iree_allocator_system(), buffer);
+}
+
+// A thread running pack ops in a loop until `should_stop` is set, on buffers
+// of its own, to contend with the benchmarked thread for shared caches and
+// memory bandwidth.
+typedef struct iree_uk_pack_benchmark_contender_t {
+  iree_uk_pack_params_t params;
+  void* in_buffer;
+  void* out_buffer;
+  iree_atomic_int32_t* should_stop;
+  iree_thread_t* thread;
+} iree_uk_pack_benchmark_contender_t;
+
+static int iree_uk_pack_benchmark_contender_main(void* arg) {
+  const iree_uk_pack_benchmark_contender_t* contender = arg;
+  while (!iree_atomic_load_int32(contender->should_stop,
+                                 iree_memory_order_relaxed)) {
+    iree_uk_pack_p(&contender->params);
+  }
+  return 0;
+}
+
+// Starts FLAG_contention_threads contenders packing copies of the buffers of
+// `params`. Returns NULL if there are none to start.
+static iree_uk_pack_benchmark_contender_t*
+iree_uk_pack_benchmark_start_contenders(const iree_uk_pack_params_t* params,
+                                        iree_uk_index_t in_buffer_size,
+                                        iree_uk_index_t out_buffer_size,
+                                        iree_atomic_int32_t* should_stop) {
+  if (FLAG_contention_threads <= 0) return NULL;
+  iree_uk_pack_benchmark_contender_t* contenders =
+      calloc(FLAG_contention_threads, sizeof *contenders);
+  for (int i = 0; i < FLAG_contention_threads; ++i) {
+    iree_uk_pack_benchmark_contender_t* contender = &contenders[i];
+    memcpy(&contender->params, params, sizeof contender->params);
+    contender->in_buffer = malloc(in_buffer_size);
+    contender->out_buffer =
+        iree_uk_pack_benchmark_alloc_out_buffer(out_buffer_size);
+    memcpy(contender->in_buffer, params->in_buffer, in_buffer_size);
+    contender->params.in_buffer = contender->in_buffer;
+    contender->params.out_buffer = contender->out_buffer;
+    contender->should_stop = should_stop;
+    iree_thread_create_params_t thread_params;
+    memset(&thread_params, 0, sizeof thread_params);
+    thread_params.name = iree_make_cstring_view("pack_contender");
+    IREE_CHECK_OK(iree_thread_create(iree_uk_pack_benchmark_contender_main,
+                                     contender, thread_params,
+                                     iree_allocator_system(),
+                                     &contender->thread));
+  }
+  return contenders;
+}
+
+static void iree_uk_pack_benchmark_stop_contenders(
+    iree_uk_pack_benchmark_contender_t* contenders,
+    iree_atomic_int32_t* should_stop) {
+  if (!contenders) return;
+  iree_atomic_store_int32(should_stop, 1, iree_memory_order_relaxed);
+  for (int i = 0; i < FLAG_contention_threads; ++i) {
+    // Releasing the last reference joins the thread.
+    iree_thread_release(contenders[i].thread);
+    free(contenders[i].in_buffer);
+    iree_uk_pack_benchmark_free_out_buffer(contenders[i].out_buffer);
+  }
+  free(contenders);
+}
 
 static iree_status_t iree_uk_benchmark_pack(
     const iree_benchmark_def_t* benchmark_def,
@@ -69,7 +154,7 @@ static iree_status_t iree_uk_benchmark_pack(
   iree_uk_index_t out_buffer_size =
       iree_uk_2d_buffer_length(out_type, params.out_size0, params.out_stride0);
   void* in_buffer = malloc(in_buffer_size);
-  void* out_buffer = malloc(out_buffer_size);
+  void* out_buffer = iree_uk_pack_benchmark_alloc_out_buffer(out_buffer_size);
   iree_uk_random_engine_t* engine = iree_uk_benchmark_random_engine(user_data);
   // It's just about plausible that on some platform, for some number type,
   // performance might be different on zero buffers vs random buffers. But it
@@ -81,6 +166,10 @@ static iree_status_t iree_uk_benchmark_pack(
   params.in_buffer = in_buffer;
   params.out_buffer = out_buffer;
   params.padding_value = 0;
+  iree_atomic_int32_t should_stop = IREE_ATOMIC_VAR_INIT(0);
+  iree_uk_pack_benchmark_contender_t* contenders =
+      iree_uk_pack_benchmark_start_contenders(&params, in_buffer_size,
+                                              out_buffer_size, &should_stop);
   int64_t total_iterations = 0;
   int64_t batch_count = 1;
   while (iree_benchmark_keep_running(benchmark_state, batch_count)) {
@@ -95,14 +184,18 @@ static iree_status_t iree_uk_benchmark_pack(
   // memory-bound).
   iree_benchmark_set_bytes_processed(benchmark_state,
                                      total_iterations * out_buffer_size);
+  iree_uk_pack_benchmark_stop_contenders(contenders, &should_stop);
   free(in_buffer);
-  free(out_buffer);
+  iree_uk_pack_benchmark_free_out_buffer(out_buffer);
   return iree_ok_status();
 }
 
 static void iree_uk_benchmark_register_pack(iree_uk_uint32_t flags,
                                             int tile_size0, int tile_size1,
                                             const char* cpu_features) {
+  // Each variant is registered with streaming stores disabled, and with them
+  // enabled regardless of the size, for comparison. Which is faster mostly
+  // depends on --working_set_size and --contention_threads.
   iree_uk_pack_type_t type = iree_uk_pack_type(flags);
   char type_str[32];
   iree_uk_type_pair_str(type_str, sizeof type_str, type);
@@ -120,13 +213,17 @@ static void iree_uk_benchmark_register_pack(iree_uk_uint32_t flags,
        IREE_UK_FLAG_PACK_TRANSPOSE_INNER | IREE_UK_FLAG_PACK_TRANSPOSE_OUTER},
   };
   for (int i = 0; i < IREE_ARRAYSIZE(variants); ++i) {
-    pack_variant_t variant = variants[i];
-    char name[128];
-    snprintf(name, sizeof name, "pack_%s_tile_%dx%d_%s_wss_%" PRIi64, type_str,
-             tile_size0, tile_size1, variant.label, FLAG_working_set_size);
-    params.flags = flags | variant.flags;
-    iree_uk_benchmark_register(name, iree_uk_benchmark_pack, &params,
-                               sizeof params, cpu_features);
+    for (int streaming = 0; streaming <= 1; ++streaming) {
+      pack_variant_t variant = variants[i];
+      char name[128];
+      snprintf(name, sizeof name, "pack_%s_tile_%dx%d_%s%s_wss_%" PRIi64,
+               type_str, tile_size0, tile_size1, variant.label,
+               streaming ? "_streaming" : "", FLAG_working_set_size);
+      params.flags = flags | variant.flags;
+      params.streaming_store_threshold = streaming;
+      iree_uk_benchmark_register(name, iree_uk_benchmark_pack, &params,
+                                 sizeof params, cpu_features);
+    }
   }
 }
 
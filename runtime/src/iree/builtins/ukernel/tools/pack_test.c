@@ -103,7 +103,13 @@ static void iree_uk_test_pack_for_shape_params(
 
   iree_uk_pack_params_t actual_params;
   memcpy(&actual_params, &params, sizeof actual_params);
-  void* actual_out_buffer = malloc(out_buffer_size);
+  // Streaming-store tile functions may require a 64-byte aligned output (see
+  // the arch-specific selection logic), so align it to exercise them.
+  char* actual_out_alloc = malloc(out_buffer_size + 64);
+  void* actual_out_buffer =
+      params.streaming_store_threshold
+          ? (void*)(((uintptr_t)actual_out_alloc + 63) & ~(uintptr_t)63)
+          : actual_out_alloc;
   iree_uk_write_random_buffer(actual_out_buffer, out_buffer_size, out_type,
                               engine);
   actual_params.out_buffer = (char*)actual_out_buffer -
@@ -117,7 +123,7 @@ static void iree_uk_test_pack_for_shape_params(
   }
 
   free(reference_out_buffer);
-  free(actual_out_buffer);
+  free(actual_out_alloc);
   free(in_buffer);
 }
 
@@ -186,20 +192,40 @@ static void iree_uk_test_pack_for_tile_params(iree_uk_test_t* test,
   }
 }
 
-static void iree_uk_test_pack(iree_uk_uint32_t flags, int tile_size0,
-                              int tile_size1, const char* cpu_features) {
+static void iree_uk_test_pack_impl(iree_uk_uint32_t flags, int tile_size0,
+                                   int tile_size1,
+                                   iree_uk_index_t streaming_store_threshold,
+                                   const char* cpu_features) {
   iree_uk_pack_params_t params = {
-      .flags = flags, .out_size2 = tile_size0, .out_size3 = tile_size1};
+      .flags = flags,
+      .out_size2 = tile_size0,
+      .out_size3 = tile_size1,
+      .streaming_store_threshold = streaming_store_threshold};
   char types_str[32];
   iree_uk_pack_type_t type = iree_uk_pack_type(flags);
   iree_uk_type_pair_str(types_str, sizeof types_str, type);
   char test_label_str[256];
-  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d",
-           types_str, tile_size0, tile_size1);
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d%s",
+           types_str, tile_size0, tile_size1,
+           streaming_store_threshold ? " streaming_stores" : "");
   iree_uk_test(test_label_str, iree_uk_test_pack_for_tile_params, &params,
                cpu_features);
 }
 
+static void iree_uk_test_pack(iree_uk_uint32_t flags, int tile_size0,
+                              int tile_size1, const char* cpu_features) {
+  iree_uk_test_pack_impl(flags, tile_size0, tile_size1, 0, cpu_features);
+}
+
+// Same as iree_uk_test_pack but with the lowest possible streaming store
+// threshold, so that even the small test shapes select tile functions using
+// streaming stores where available.
+static void iree_uk_test_pack_streaming(iree_uk_uint32_t flags, int tile_size0,
+                                        int tile_size1,
+                                        const char* cpu_features) {
+  iree_uk_test_pack_impl(flags, tile_size0, tile_size1, 1, cpu_features);
+}
+
 int main(int argc, char** argv) {
   // Generic tests, not matching any particular CPU feature. This is the place
   // to test weird tile shapes to ensure e.g. that we haven't unwittingly baked
@@ -215,6 +241,8 @@ int main(int argc, char** argv) {
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 8, 1, "");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 8, 8, "");
+  iree_uk_test_pack_streaming(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 1, "");
+  iree_uk_test_pack_streaming(IREE_UK_FLAG_PACK_TYPE_F32F32, 8, 8, "");
   // Tile size selected with CPU feature dotprod.
   // Not passing a cpu_features_list because the packing code itself
   // does not depend on any features.
@@ -230,6 +258,10 @@ int main(int argc, char** argv) {
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I8I8, 16, 2, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 16, "avx512_base");
   iree_uk_test_pack(IREE_UK_FLAG_PACK_TYPE_I32I32, 16, 16, "avx512_base");
+  iree_uk_test_pack_streaming(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 1,
+                              "avx512_base");
+  iree_uk_test_pack_streaming(IREE_UK_FLAG_PACK_TYPE_F32F32, 16, 16,
+                              "avx512_base");
   // avx512_vnni uses the same tile size and same pack code as avx512_base.
 #endif  // defined(IREE_ARCH_ARM_64)
 
@@ -0,0 +1,158 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <math.h>
+
+#include "iree/base/api.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/builtins/ukernel/elementwise_internal.h"
+#include "iree/builtins/ukernel/softmax_internal.h"
+#include "iree/builtins/ukernel/tools/test.h"
+#include "iree/builtins/ukernel/tools/util.h"
+
+// Allocates a [rows][stride] buffer filled with random values uniformly
+// distributed in [-range, range], rounded to `type`. Unlike the small integers
+// of iree_uk_write_random_buffer, this exercises the exp approximation over a
+// continuous range.
+static void* iree_uk_test_softmax_alloc(iree_uk_test_t* test,
+                                        iree_uk_type_t type,
+                                        iree_uk_index_t rows,
+                                        iree_uk_index_t cols, float range,
+                                        iree_uk_index_t* stride) {
+  iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
+  *stride = cols + iree_uk_random_engine_get_0_1(engine) * 3;
+  iree_uk_index_t length = iree_uk_index_max(1, rows * *stride);
+  void* buffer = malloc(length * iree_uk_type_size(type));
+  for (iree_uk_index_t i = 0; i < length; ++i) {
+    float x = range * (iree_uk_random_engine_get_0_65535(engine) / 32767.5f -
+                       1.0f);
+    iree_uk_elementwise_store(buffer, i, x, type);
+  }
+  return buffer;
+}
+
+static void iree_uk_test_softmax_for_shape_params(
+    iree_uk_test_t* test, const iree_uk_softmax_params_t* src_params,
+    float range) {
+  iree_uk_softmax_params_t params;
+  memcpy(&params, src_params, sizeof params);
+  iree_uk_type_t type = iree_uk_softmax_type(params.flags);
+  bool fast = params.flags & IREE_UK_FLAG_SOFTMAX_FAST_MATH;
+  void* in_buffer = iree_uk_test_softmax_alloc(
+      test, type, params.size0, params.size1, range, &params.in_stride0);
+  void* out_buffer = iree_uk_test_softmax_alloc(
+      test, type, params.size0, params.size1, range, &params.out_stride0);
+  params.in_buffer = in_buffer;
+  params.out_buffer = out_buffer;
+  params.in_offset = 0;
+  params.out_offset = 0;
+  params.cpu_data = iree_uk_test_cpu_data(test);
+
+  // Reference values, computed in double precision before calling the ukernel
+  // so that the output buffer can't affect them.
+  double* expected =
+      malloc(iree_uk_index_max(1, params.size0 * params.size1) *
+             sizeof(double));
+  for (iree_uk_index_t i = 0; i < params.size0; ++i) {
+    double max = -INFINITY;
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      double x =
+          iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j, type);
+      if (x > max) max = x;
+    }
+    double sum = 0.0;
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      double x =
+          iree_uk_elementwise_load(in_buffer, i * params.in_stride0 + j, type);
+      expected[i * params.size1 + j] = exp(x - max);
+      sum += expected[i * params.size1 + j];
+    }
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      expected[i * params.size1 + j] /= sum;
+    }
+  }
+
+  iree_uk_softmax_p(&params);
+
+  // The relative tolerance accounts for the exp approximation and the final
+  // rounding. The absolute one covers the smallest probabilities, notably as
+  // f16 conversions flush denormals to 0.
+  float tolerance = type == IREE_UK_TYPE_FLOAT_32   ? (fast ? 2e-4f : 1e-5f)
+                    : type == IREE_UK_TYPE_FLOAT_16 ? 2e-3f
+                                                    : 1e-2f;
+  double abs_tolerance = type == IREE_UK_TYPE_FLOAT_16 ? 6.2e-5 : 1e-7;
+  for (iree_uk_index_t i = 0; i < params.size0; ++i) {
+    for (iree_uk_index_t j = 0; j < params.size1; ++j) {
+      double e = expected[i * params.size1 + j];
+      float actual = iree_uk_elementwise_load(
+          out_buffer, i * params.out_stride0 + j, type);
+      if (!(fabs(actual - e) <= tolerance * e + abs_tolerance)) {
+        IREE_UK_TEST_FAIL(test);
+        goto done;
+      }
+    }
+  }
+
+done:
+  free(expected);
+  free(out_buffer);
+  free(in_buffer);
+}
+
+static void iree_uk_test_softmax_for_flags(iree_uk_test_t* test,
+                                           const void* src_params) {
+  typedef struct shape_t {
+    int size0, size1;
+    float range;
+  } shape_t;
+  const shape_t shapes[] = {
+      // Degenerate cases.
+      {0, 4, 1.0f},
+      {3, 0, 1.0f},
+      // Rows shorter than, equal to, and not multiples of the reduction lanes.
+      {1, 1, 4.0f},
+      {2, 7, 4.0f},
+      {3, 16, 4.0f},
+      {5, 33, 8.0f},
+      // Long rows, as in attention scores or vocabulary logits, including a
+      // wide range exercising the underflow of the smallest probabilities.
+      {2, 1000, 8.0f},
+      {1, 4099, 50.0f},
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(shapes); ++i) {
+    iree_uk_softmax_params_t params;
+    memcpy(&params, src_params, sizeof params);
+    params.size0 = shapes[i].size0;
+    params.size1 = shapes[i].size1;
+    iree_uk_test_softmax_for_shape_params(test, &params, shapes[i].range);
+  }
+}
+
+static void iree_uk_test_softmax(iree_uk_uint32_t flags,
+                                 const char* cpu_features) {
+  iree_uk_softmax_params_t params = {.flags = flags};
+  char type_str[16];
+  iree_uk_type_str(type_str, sizeof type_str, iree_uk_softmax_type(flags));
+  char test_label_str[256];
+  snprintf(test_label_str, sizeof test_label_str, "type:%s fast_math:%d",
+           type_str, (flags & IREE_UK_FLAG_SOFTMAX_FAST_MATH) ? 1 : 0);
+  iree_uk_test(test_label_str, iree_uk_test_softmax_for_flags, &params,
+               cpu_features);
+}
+
+int main(int argc, char** argv) {
+  const iree_uk_uint32_t types[] = {
+      IREE_UK_FLAG_SOFTMAX_TYPE_F32,
+      IREE_UK_FLAG_SOFTMAX_TYPE_F16,
+      IREE_UK_FLAG_SOFTMAX_TYPE_BF16,
+  };
+  for (int i = 0; i < IREE_ARRAYSIZE(types); ++i) {
+    iree_uk_test_softmax(types[i], "");
+    iree_uk_test_softmax(types[i] | IREE_UK_FLAG_SOFTMAX_FAST_MATH, "");
+  }
+
+  return iree_uk_test_exit_status();
+}
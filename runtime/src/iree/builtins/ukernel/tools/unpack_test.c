@@ -64,6 +64,10 @@ static void iree_uk_test_unpack_for_shape_params(
   // Randomly make strides either tight or not to exercise all cases.
   iree_uk_random_engine_t* engine = iree_uk_test_random_engine(test);
   params.out_stride0 = params.out_size1 + iree_uk_random_engine_get_0_1(engine);
+  if (params.streaming_store_threshold) {
+    // Keep rows 64-byte aligned, see the comment on `actual_out_buffer` below.
+    params.out_stride0 = (params.out_stride0 + 15) & ~15;
+  }
   params.in_stride0 = params.in_size1 * params.in_size2 * params.in_size3 +
                       iree_uk_random_engine_get_0_1(engine);
   iree_uk_unpack_type_t unpack_type = iree_uk_unpack_type(params.flags);
@@ -91,7 +95,13 @@ static void iree_uk_test_unpack_for_shape_params(
 
   iree_uk_unpack_params_t actual_params;
   memcpy(&actual_params, &params, sizeof actual_params);
-  void* actual_out_buffer = malloc(out_buffer_size);
+  // Streaming-store tile functions may require a 64-byte aligned output (see
+  // the arch-specific selection logic), so align it to exercise them.
+  char* actual_out_alloc = malloc(out_buffer_size + 64);
+  void* actual_out_buffer =
+      params.streaming_store_threshold
+          ? (void*)(((uintptr_t)actual_out_alloc + 63) & ~(uintptr_t)63)
+          : actual_out_alloc;
   iree_uk_write_random_buffer(actual_out_buffer, out_buffer_size, out_type,
                               engine);
   actual_params.out_buffer = (char*)actual_out_buffer -
@@ -107,7 +117,7 @@ static void iree_uk_test_unpack_for_shape_params(
   }
 
   free(reference_out_buffer);
-  free(actual_out_buffer);
+  free(actual_out_alloc);
   free(in_buffer);
 }
 
@@ -177,20 +187,40 @@ static void iree_uk_test_unpack_for_tile_params(iree_uk_test_t* test,
   }
 }
 
-static void iree_uk_test_unpack(iree_uk_uint32_t flags, int tile_size0,
-                                int tile_size1, const char* cpu_features) {
+static void iree_uk_test_unpack_impl(iree_uk_uint32_t flags, int tile_size0,
+                                     int tile_size1,
+                                     iree_uk_index_t streaming_store_threshold,
+                                     const char* cpu_features) {
   iree_uk_unpack_params_t params = {
-      .flags = flags, .in_size2 = tile_size0, .in_size3 = tile_size1};
+      .flags = flags,
+      .in_size2 = tile_size0,
+      .in_size3 = tile_size1,
+      .streaming_store_threshold = streaming_store_threshold};
   char types_str[32];
   iree_uk_unpack_type_t unpack_type = iree_uk_unpack_type(flags);
   iree_uk_type_pair_str(types_str, sizeof types_str, unpack_type);
   char test_label_str[256];
-  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d",
-           types_str, tile_size0, tile_size1);
+  snprintf(test_label_str, sizeof test_label_str, "types:%s tile:%dx%d%s",
+           types_str, tile_size0, tile_size1,
+           streaming_store_threshold ? " streaming_stores" : "");
   iree_uk_test(test_label_str, iree_uk_test_unpack_for_tile_params, &params,
                cpu_features);
 }
 
+static void iree_uk_test_unpack(iree_uk_uint32_t flags, int tile_size0,
+                                int tile_size1, const char* cpu_features) {
+  iree_uk_test_unpack_impl(flags, tile_size0, tile_size1, 0, cpu_features);
+}
+
+// Same as iree_uk_test_unpack but with the lowest possible streaming store
+// threshold, so that even the small test shapes select tile functions using
+// streaming stores where available.
+static void iree_uk_test_unpack_streaming(iree_uk_uint32_t flags,
+                                          int tile_size0, int tile_size1,
+                                          const char* cpu_features) {
+  iree_uk_test_unpack_impl(flags, tile_size0, tile_size1, 1, cpu_features);
+}
+
 int main(int argc, char** argv) {
   // Generic tests, not matching any particular CPU feature. This is the place
   // to test weird tile shapes to ensure e.g. that we haven't unwittingly baked
@@ -203,11 +233,14 @@ int main(int argc, char** argv) {
 #if defined(IREE_ARCH_ARM_64)
   iree_uk_test_unpack(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 8, 8, "");
   iree_uk_test_unpack(IREE_UK_FLAG_UNPACK_TYPE_I32I32, 8, 8, "");
+  iree_uk_test_unpack_streaming(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 8, 8, "");
 #elif defined(IREE_ARCH_X86_64)
   iree_uk_test_unpack(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 8, 8, "avx2_fma");
   iree_uk_test_unpack(IREE_UK_FLAG_UNPACK_TYPE_I32I32, 8, 8, "avx2_fma");
   iree_uk_test_unpack(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 16, 16, "avx512_base");
   iree_uk_test_unpack(IREE_UK_FLAG_UNPACK_TYPE_I32I32, 16, 16, "avx512_base");
+  iree_uk_test_unpack_streaming(IREE_UK_FLAG_UNPACK_TYPE_F32F32, 16, 16,
+                                "avx512_base");
 #endif  // defined(IREE_ARCH_ARM_64)
 
   return iree_uk_test_exit_status();
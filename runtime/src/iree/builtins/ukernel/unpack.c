@@ -212,19 +212,22 @@ IREE_UK_EXPORT void iree_uk_unpack(
     iree_uk_index_t in_size3, iree_uk_index_t out_size0,
     iree_uk_index_t out_size1, iree_uk_uint32_t flags,
     const iree_uk_uint64_t* cpu_data) {
-  iree_uk_unpack_params_t params = {.in_buffer = in_buffer,
-                                    .in_offset = in_offset,
-                                    .in_stride0 = in_stride0,
-                                    .out_buffer = out_buffer,
-                                    .out_offset = out_offset,
-                                    .out_stride0 = out_stride0,
-                                    .in_size0 = in_size0,
-                                    .in_size1 = in_size1,
-                                    .in_size2 = in_size2,
-                                    .in_size3 = in_size3,
-                                    .out_size0 = out_size0,
-                                    .out_size1 = out_size1,
-                                    .flags = flags,
-                                    .cpu_data = cpu_data};
+  iree_uk_unpack_params_t params = {
+      .in_buffer = in_buffer,
+      .in_offset = in_offset,
+      .in_stride0 = in_stride0,
+      .out_buffer = out_buffer,
+      .out_offset = out_offset,
+      .out_stride0 = out_stride0,
+      .in_size0 = in_size0,
+      .in_size1 = in_size1,
+      .in_size2 = in_size2,
+      .in_size3 = in_size3,
+      .out_size0 = out_size0,
+      .out_size1 = out_size1,
+      .streaming_store_threshold =
+          iree_uk_unpack_default_streaming_store_threshold,
+      .flags = flags,
+      .cpu_data = cpu_data};
   iree_uk_unpack_p(&params);
 }
\ No newline at end of file
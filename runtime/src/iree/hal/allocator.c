@@ -6,6 +6,7 @@
 
 #include "iree/hal/allocator.h"
 
+#include <inttypes.h>
 #include <stddef.h>
 #include <stdio.h>
 
@@ -67,6 +68,17 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_statistics_format(
       statistics->device_bytes_freed,
       (statistics->device_bytes_allocated - statistics->device_bytes_freed)));
 
+  if (statistics->pool_hit_count || statistics->pool_miss_count) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        "       POOLS: %12" PRIu64 " hits / %12" PRIu64
+        " misses / %12" PRIdsz "B reserved / %12" PRIdsz
+        "B free / %12" PRIdsz "B wasted\n",
+        statistics->pool_hit_count, statistics->pool_miss_count,
+        statistics->pool_bytes_reserved, statistics->pool_bytes_free,
+        statistics->pool_bytes_wasted));
+  }
+
 #else
   // No-op when disabled.
 #endif  // IREE_STATISTICS_ENABLE
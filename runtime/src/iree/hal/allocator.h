@@ -13,6 +13,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/resource.h"
+#include "iree/hal/statistics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -79,6 +80,27 @@ typedef struct iree_hal_allocator_memory_heap_t {
   iree_device_size_t min_alignment;
 } iree_hal_allocator_memory_heap_t;
 
+// Hints describing the lifetime and access frequency of a buffer.
+// Allocators may use the hint to place the buffer in memory better suited to
+// how it is used but buffers behave identically regardless of the hint and
+// allocators are free to ignore it.
+typedef enum iree_hal_buffer_placement_hint_e {
+  // No hint is provided and the allocator uses its default placement.
+  IREE_HAL_BUFFER_PLACEMENT_HINT_DEFAULT = 0,
+  // Long-lived and frequently accessed for the lifetime of the buffer, such
+  // as model weights and KV caches. Allocators may favor keeping the buffer
+  // resident (large pages, higher residency priority, cache persistence) at
+  // the cost of more expensive allocation.
+  IREE_HAL_BUFFER_PLACEMENT_HINT_PERSISTENT = 1,
+  // Long-lived but each byte is accessed rarely (such as once per use) and
+  // gains little from caching or priority residency.
+  IREE_HAL_BUFFER_PLACEMENT_HINT_STREAMING = 2,
+  // Short-lived and frequently allocated and released, such as scratch
+  // memory used within a single submission. Allocators should favor fast
+  // allocation and reuse.
+  IREE_HAL_BUFFER_PLACEMENT_HINT_TRANSIENT = 3,
+} iree_hal_buffer_placement_hint_t;
+
 // Parameters defining how a buffer should be allocated.
 //
 // Designed to be zero-initialized: any field with a 0 value will be assigned
@@ -131,6 +153,13 @@ typedef struct iree_hal_buffer_params_t {
   // If 0 then the alignment will be decided by the allocator based on optimal
   // device parameters.
   iree_device_size_t min_alignment;
+
+  // Hint describing the lifetime and access frequency of the buffer.
+  // Allocators may use this to select memory placement beyond what the memory
+  // type and usage bits specify.
+  //
+  // If 0 then the allocator will use its default placement.
+  iree_hal_buffer_placement_hint_t placement_hint;
 } iree_hal_buffer_params_t;
 
 // Canonicalizes |params| fields when zero initialization is used.
@@ -365,6 +394,20 @@ typedef struct iree_hal_allocator_statistics_t {
   iree_device_size_t device_bytes_peak;
   iree_device_size_t device_bytes_allocated;
   iree_device_size_t device_bytes_freed;
+  // Allocation requests serviced by pooling allocators from memory they had
+  // already acquired from their underlying allocator.
+  uint64_t pool_hit_count;
+  // Allocation requests that pooling allocators had to acquire new memory from
+  // their underlying allocator to service.
+  uint64_t pool_miss_count;
+  // Total bytes pooling allocators have acquired and are retaining, including
+  // both live allocations and unused cached memory.
+  iree_device_size_t pool_bytes_reserved;
+  // Bytes retained by pooling allocators that are not currently allocated.
+  iree_device_size_t pool_bytes_free;
+  // Bytes lost to internal fragmentation in live pooled allocations, such as
+  // from rounding requests up to a size class.
+  iree_device_size_t pool_bytes_wasted;
   // TODO(benvanik): mapping information (discarded, mapping ranges,
   //                 flushed/invalidated, etc).
 #else
@@ -537,6 +580,24 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
 
+// NUMA node ID indicating that a queue is not local to any single node.
+#define IREE_HAL_HEAP_NUMA_NODE_ANY UINT32_MAX
+
+// Creates a host-local heap allocator as with iree_hal_allocator_create_heap
+// that places the storage of buffers on the NUMA nodes of the queues they are
+// allocated for. |queue_node_ids| contains the node of each of |queue_count|
+// queues with bit N of a buffer queue affinity selecting queue
+// N % |queue_count|. Buffers for queues on a single node are placed on that
+// node and buffers for queues on multiple nodes (such as with
+// IREE_HAL_QUEUE_AFFINITY_ANY) are interleaved across them. Buffers for any
+// queue with a node of IREE_HAL_HEAP_NUMA_NODE_ANY are not placed.
+//
+// Placement is best-effort and a no-op on platforms without NUMA support.
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_numa(
+    iree_string_view_t identifier, iree_host_size_t queue_count,
+    const uint32_t* queue_node_ids, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_allocator_t implementation details
 //===----------------------------------------------------------------------===//
@@ -604,11 +665,13 @@ static inline void iree_hal_allocator_statistics_record_alloc(
     iree_hal_allocator_statistics_t* statistics,
     iree_hal_memory_type_t memory_type, iree_device_size_t allocation_size) {
   if (iree_all_bits_set(memory_type, IREE_HAL_MEMORY_TYPE_HOST_LOCAL)) {
+    iree_hal_statistics_record(IREE_HAL_STATISTIC_HOST_ALLOCATION_COUNT, 1);
     statistics->host_bytes_allocated += allocation_size;
     statistics->host_bytes_peak =
         iree_max(statistics->host_bytes_peak, statistics->host_bytes_allocated -
                                                   statistics->host_bytes_freed);
   } else {
+    iree_hal_statistics_record(IREE_HAL_STATISTIC_DEVICE_ALLOCATION_COUNT, 1);
     statistics->device_bytes_allocated += allocation_size;
     statistics->device_bytes_peak = iree_max(
         statistics->device_bytes_peak,
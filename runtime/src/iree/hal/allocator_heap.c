@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/hal/allocator.h"
@@ -12,10 +13,21 @@
 #include "iree/hal/buffer_heap_impl.h"
 #include "iree/hal/resource.h"
 
+// Maximum number of queues buffers may be placed for; one per queue affinity
+// bit.
+#define IREE_HAL_HEAP_ALLOCATOR_MAX_QUEUES 64
+
 typedef struct iree_hal_heap_allocator_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_allocator_t data_allocator;
+  // Pool of buffer storage used when data and host allocators are the same.
+  // NULL if pooling is disabled or a custom data allocator was provided.
+  iree_hal_heap_buffer_pool_t* pool;
+  // NUMA node of each queue used to place buffer storage or empty if buffers
+  // are not placed.
+  iree_host_size_t queue_count;
+  const uint32_t* queue_node_ids;  // [queue_count]
   iree_string_view_t identifier;
   IREE_STATISTICS(iree_hal_heap_allocator_statistics_t statistics;)
 } iree_hal_heap_allocator_t;
@@ -30,13 +42,29 @@ iree_hal_heap_allocator_t* iree_hal_heap_allocator_cast(
 IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
     iree_string_view_t identifier, iree_allocator_t data_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  return iree_hal_allocator_create_heap_numa(
+      identifier, /*queue_count=*/0, /*queue_node_ids=*/NULL, data_allocator,
+      host_allocator, out_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap_numa(
+    iree_string_view_t identifier, iree_host_size_t queue_count,
+    const uint32_t* queue_node_ids, iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+  IREE_ASSERT_ARGUMENT(!queue_count || queue_node_ids);
   IREE_ASSERT_ARGUMENT(out_allocator);
   *out_allocator = NULL;
+  if (queue_count > IREE_HAL_HEAP_ALLOCATOR_MAX_QUEUES) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "queue count %" PRIhsz " exceeds the maximum of %d",
+                            queue_count, IREE_HAL_HEAP_ALLOCATOR_MAX_QUEUES);
+  }
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_heap_allocator_t* allocator = NULL;
-  iree_host_size_t total_size =
-      iree_sizeof_struct(*allocator) + identifier.size;
+  iree_host_size_t total_size = iree_sizeof_struct(*allocator) +
+                                queue_count * sizeof(uint32_t) +
+                                identifier.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&allocator);
   if (iree_status_is_ok(status)) {
@@ -44,16 +72,37 @@ IREE_API_EXPORT iree_status_t iree_hal_allocator_create_heap(
                                  &allocator->resource);
     allocator->host_allocator = host_allocator;
     allocator->data_allocator = data_allocator;
-    iree_string_view_append_to_buffer(
-        identifier, &allocator->identifier,
-        (char*)allocator + iree_sizeof_struct(*allocator));
+    uint8_t* storage_ptr = (uint8_t*)allocator + iree_sizeof_struct(*allocator);
+    allocator->queue_count = queue_count;
+    allocator->queue_node_ids = (const uint32_t*)storage_ptr;
+    const iree_host_size_t queue_node_ids_size =
+        queue_count * sizeof(*queue_node_ids);
+    if (queue_node_ids_size) {
+      memcpy(storage_ptr, queue_node_ids, queue_node_ids_size);
+    }
+    storage_ptr += queue_node_ids_size;
+    iree_string_view_append_to_buffer(identifier, &allocator->identifier,
+                                      (char*)storage_ptr);
 
     IREE_STATISTICS({
       // All start initialized to zero.
       iree_slim_mutex_initialize(&allocator->statistics.mutex);
     });
+  }
+
+#if IREE_HAL_HEAP_BUFFER_POOL_ENABLE
+  // Custom data allocators (large pages, etc) are used as-is; otherwise we
+  // cache storage to keep the system allocator off the hot path.
+  if (iree_status_is_ok(status) &&
+      memcmp(&data_allocator, &host_allocator, sizeof(data_allocator)) == 0) {
+    status = iree_hal_heap_buffer_pool_create(host_allocator, &allocator->pool);
+  }
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_ENABLE
 
+  if (iree_status_is_ok(status)) {
     *out_allocator = (iree_hal_allocator_t*)allocator;
+  } else {
+    iree_hal_allocator_release((iree_hal_allocator_t*)allocator);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -67,6 +116,8 @@ static void iree_hal_heap_allocator_destroy(
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_heap_buffer_pool_free(allocator->pool);
+
   IREE_STATISTICS(iree_slim_mutex_deinitialize(&allocator->statistics.mutex));
 
   iree_allocator_free(host_allocator, allocator);
@@ -83,6 +134,9 @@ static iree_allocator_t iree_hal_heap_allocator_host_allocator(
 
 static iree_status_t iree_hal_heap_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_heap_allocator_t* allocator =
+      iree_hal_heap_allocator_cast(base_allocator);
+  if (allocator->pool) iree_hal_heap_buffer_pool_trim(allocator->pool);
   return iree_ok_status();
 }
 
@@ -96,6 +150,10 @@ static void iree_hal_heap_allocator_query_statistics(
     memcpy(out_statistics, &allocator->statistics.base,
            sizeof(*out_statistics));
     iree_slim_mutex_unlock(&allocator->statistics.mutex);
+    if (allocator->pool) {
+      iree_hal_heap_buffer_pool_query_statistics(allocator->pool,
+                                                 out_statistics);
+    }
   });
 }
 
@@ -175,6 +233,22 @@ iree_hal_heap_allocator_query_buffer_compatibility(
   return compatibility;
 }
 
+// Returns a mask of the NUMA nodes the queues in |queue_affinity| are on or 0
+// if buffers for them should not be placed.
+static uint64_t iree_hal_heap_allocator_numa_node_mask(
+    iree_hal_heap_allocator_t* allocator,
+    iree_hal_queue_affinity_t queue_affinity) {
+  if (!allocator->queue_count) return 0;
+  uint64_t node_mask = 0;
+  for (int i = 0; i < IREE_HAL_HEAP_ALLOCATOR_MAX_QUEUES; ++i) {
+    if (!(queue_affinity & (1ull << i))) continue;
+    uint32_t node_id = allocator->queue_node_ids[i % allocator->queue_count];
+    if (node_id >= 64) return 0;  // unplaced or beyond what we can bind
+    node_mask |= 1ull << node_id;
+  }
+  return node_mask;
+}
+
 static iree_status_t iree_hal_heap_allocator_allocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -198,7 +272,10 @@ static iree_status_t iree_hal_heap_allocator_allocate_buffer(
   IREE_STATISTICS(statistics = &allocator->statistics);
   iree_hal_buffer_t* buffer = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_create(
-      base_allocator, statistics, &compat_params, allocation_size,
+      base_allocator, statistics, allocator->pool, &compat_params,
+      allocation_size,
+      iree_hal_heap_allocator_numa_node_mask(allocator,
+                                             compat_params.queue_affinity),
       allocator->data_allocator, allocator->host_allocator, &buffer));
 
   *out_buffer = buffer;
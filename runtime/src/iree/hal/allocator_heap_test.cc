@@ -0,0 +1,193 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class HeapAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), iree_allocator_system(), iree_allocator_system(),
+        &allocator_));
+  }
+
+  void TearDown() override { iree_hal_allocator_release(allocator_); }
+
+  iree_hal_buffer_t* Allocate(
+      iree_device_size_t allocation_size,
+      iree_hal_buffer_placement_hint_t placement_hint =
+          IREE_HAL_BUFFER_PLACEMENT_HINT_DEFAULT) {
+    iree_hal_buffer_params_t params = {0};
+    params.placement_hint = placement_hint;
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(allocator_, params,
+                                                     allocation_size, &buffer));
+    return buffer;
+  }
+
+  // Returns the host pointer to the contents of |buffer|.
+  static uint8_t* Contents(iree_hal_buffer_t* buffer) {
+    iree_hal_buffer_mapping_t mapping;
+    IREE_CHECK_OK(iree_hal_buffer_map_range(
+        buffer, IREE_HAL_MAPPING_MODE_PERSISTENT,
+        IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, 0,
+        IREE_WHOLE_BUFFER, &mapping));
+    uint8_t* data = mapping.contents.data;
+    IREE_CHECK_OK(iree_hal_buffer_unmap_range(&mapping));
+    return data;
+  }
+
+  iree_hal_allocator_statistics_t QueryStatistics() {
+    iree_hal_allocator_statistics_t statistics;
+    iree_hal_allocator_query_statistics(allocator_, &statistics);
+    return statistics;
+  }
+
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+// Tests that buffer contents meet the heap alignment across size classes.
+TEST_F(HeapAllocatorTest, Alignment) {
+  for (iree_device_size_t size : {1, 63, 64, 1000, 300000, 1000000}) {
+    iree_hal_buffer_t* buffer = Allocate(size);
+    EXPECT_EQ(iree_hal_buffer_byte_length(buffer), size);
+    uint8_t* data = Contents(buffer);
+    EXPECT_TRUE(iree_host_size_has_alignment((iree_host_size_t)data,
+                                             IREE_HAL_HEAP_BUFFER_ALIGNMENT));
+    memset(data, 0xAB, size);
+    iree_hal_buffer_release(buffer);
+  }
+}
+
+// Tests that placement hints produce usable buffers regardless of size. Large
+// persistent buffers may be backed by large pages where available.
+TEST_F(HeapAllocatorTest, PlacementHints) {
+  for (iree_hal_buffer_placement_hint_t placement_hint :
+       {IREE_HAL_BUFFER_PLACEMENT_HINT_PERSISTENT,
+        IREE_HAL_BUFFER_PLACEMENT_HINT_STREAMING,
+        IREE_HAL_BUFFER_PLACEMENT_HINT_TRANSIENT}) {
+    for (iree_device_size_t size : {64, 1000000, 16 * 1024 * 1024}) {
+      iree_hal_buffer_t* buffer = Allocate(size, placement_hint);
+      EXPECT_EQ(iree_hal_buffer_byte_length(buffer), size);
+      uint8_t* data = Contents(buffer);
+      EXPECT_TRUE(iree_host_size_has_alignment(
+          (iree_host_size_t)data, IREE_HAL_HEAP_BUFFER_ALIGNMENT));
+      memset(data, 0xCD, size);
+      iree_hal_buffer_release(buffer);
+    }
+  }
+}
+
+// Tests that buffers from a NUMA-placing heap are usable for any queue
+// affinity. Placement itself is best-effort and not observable here.
+TEST(HeapAllocatorNumaTest, QueueAffinities) {
+  const uint32_t queue_node_ids[2] = {0, IREE_HAL_HEAP_NUMA_NODE_ANY};
+  iree_hal_allocator_t* allocator = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_create_heap_numa(
+      IREE_SV("heap"), IREE_ARRAYSIZE(queue_node_ids), queue_node_ids,
+      iree_allocator_system(), iree_allocator_system(), &allocator));
+  for (iree_hal_queue_affinity_t queue_affinity :
+       {(iree_hal_queue_affinity_t)0b01, (iree_hal_queue_affinity_t)0b10,
+        IREE_HAL_QUEUE_AFFINITY_ANY}) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    params.queue_affinity = queue_affinity;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(allocator, params,
+                                                      1024 * 1024, &buffer));
+    IREE_ASSERT_OK(iree_hal_buffer_map_fill(buffer, 0, IREE_WHOLE_BUFFER,
+                                            "\xEF", 1));
+    iree_hal_buffer_release(buffer);
+  }
+  iree_hal_allocator_release(allocator);
+}
+
+#if IREE_HAL_HEAP_BUFFER_POOL_ENABLE
+
+// Tests that released storage is reused by allocations of the same size class.
+TEST_F(HeapAllocatorTest, SizeClassReuse) {
+  for (iree_device_size_t size : {1000, 1000000}) {
+    iree_hal_buffer_t* buffer0 = Allocate(size);
+    uint8_t* data0 = Contents(buffer0);
+    iree_hal_buffer_release(buffer0);
+
+    iree_hal_buffer_t* buffer1 = Allocate(size + 8);
+    EXPECT_EQ(Contents(buffer1), data0);
+    iree_hal_buffer_release(buffer1);
+  }
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_hit_count, 2);
+  EXPECT_EQ(statistics.pool_miss_count, 2);
+  EXPECT_GT(statistics.pool_bytes_free, 1000000);
+  EXPECT_EQ(statistics.pool_bytes_reserved, statistics.pool_bytes_free);
+#endif  // IREE_STATISTICS_ENABLE
+
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+
+#if IREE_STATISTICS_ENABLE
+  statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_bytes_reserved, 0);
+  EXPECT_EQ(statistics.pool_bytes_free, 0);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+// Tests that live allocations are never handed out twice when many threads
+// allocate and release concurrently.
+TEST_F(HeapAllocatorTest, ConcurrentAllocations) {
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 4; ++i) {
+    threads.emplace_back([this, i]() {
+      std::vector<iree_hal_buffer_t*> buffers;
+      for (int j = 0; j < 256; ++j) {
+        iree_device_size_t size = 64 + (j % 7) * 4096;
+        iree_hal_buffer_t* buffer = Allocate(size);
+        memset(Contents(buffer), i, size);
+        buffers.push_back(buffer);
+      }
+      for (iree_hal_buffer_t* buffer : buffers) {
+        uint8_t* data = Contents(buffer);
+        for (iree_device_size_t k = 0; k < iree_hal_buffer_byte_length(buffer);
+             ++k) {
+          ASSERT_EQ(data[k], i);
+        }
+        iree_hal_buffer_release(buffer);
+      }
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_hit_count + statistics.pool_miss_count, 4 * 256);
+  EXPECT_EQ(statistics.pool_bytes_wasted, 0);
+  EXPECT_EQ(statistics.pool_bytes_reserved, statistics.pool_bytes_free);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_ENABLE
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -28,6 +28,7 @@
 #include "iree/hal/pipeline_layout.h"   // IWYU pragma: export
 #include "iree/hal/resource.h"          // IWYU pragma: export
 #include "iree/hal/semaphore.h"         // IWYU pragma: export
+#include "iree/hal/statistics.h"        // IWYU pragma: export
 #include "iree/hal/string_util.h"       // IWYU pragma: export
 
 #endif  // IREE_HAL_API_H_
@@ -9,6 +9,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
 #include "iree/hal/buffer_heap_impl.h"
@@ -28,6 +29,9 @@ typedef enum iree_hal_heap_buffer_storage_mode_e {
   // A user-provided buffer release callback is notified that the buffer is no
   // longer referencing the data.
   IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL = 2u,
+  // Allocated as a [metadata, data] slab from an iree_hal_heap_buffer_pool_t.
+  // The base metadata pointer must be released back to the pool.
+  IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED = 3u,
 } iree_hal_heap_buffer_storage_mode_t;
 
 typedef struct iree_hal_heap_buffer_t {
@@ -40,6 +44,8 @@ typedef struct iree_hal_heap_buffer_t {
     iree_allocator_t data_allocator;
     // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_EXTERNAL.
     iree_hal_buffer_release_callback_t release_callback;
+    // Used for IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED.
+    iree_hal_heap_buffer_pool_t* pool;
   };
 
   // Optional statistics shared with the allocator.
@@ -110,10 +116,55 @@ static iree_status_t iree_hal_heap_buffer_allocate_slab(
   return iree_ok_status();
 }
 
+// Size of the metadata header prefixing the data in pooled slabs.
+// Pool blocks are aligned to IREE_HAL_HEAP_BUFFER_ALIGNMENT so padding the
+// header out to it keeps the data aligned.
+#define IREE_HAL_HEAP_BUFFER_POOLED_HEADER_SIZE      \
+  iree_host_align(sizeof(iree_hal_heap_buffer_t), \
+                  IREE_HAL_HEAP_BUFFER_ALIGNMENT)
+
+// Allocates a buffer with the metadata as a prefix to the storage in a single
+// block acquired from |pool|.
+static iree_status_t iree_hal_heap_buffer_allocate_pooled(
+    iree_device_size_t allocation_size, iree_hal_heap_buffer_pool_t* pool,
+    iree_hal_heap_buffer_t** out_buffer, iree_byte_span_t* out_data) {
+  const iree_host_size_t header_size = IREE_HAL_HEAP_BUFFER_POOLED_HEADER_SIZE;
+  if (IREE_UNLIKELY(allocation_size > IREE_HOST_SIZE_MAX - header_size)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "allocation size %" PRIdsz
+                            " exceeds the host addressable range",
+                            allocation_size);
+  }
+  iree_hal_heap_buffer_t* buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_heap_buffer_pool_acquire(
+      pool, header_size + (iree_host_size_t)allocation_size, (void**)&buffer));
+  *out_buffer = buffer;
+
+  uint8_t* data_ptr = (uint8_t*)buffer + header_size;
+  IREE_ASSERT_TRUE(iree_host_size_has_alignment(
+      (iree_host_size_t)data_ptr, IREE_HAL_HEAP_BUFFER_ALIGNMENT));
+  *out_data = iree_make_byte_span(data_ptr, allocation_size);
+
+  return iree_ok_status();
+}
+
+// Minimum size of buffer storage placed on NUMA nodes.
+#define IREE_HAL_HEAP_BUFFER_MIN_NUMA_PLACEMENT_SIZE (64 * 1024)
+
+// Returns true if storage of |allocation_size| bytes spans enough large pages
+// for them to be worth the rounding up of the allocation.
+static bool iree_hal_heap_buffer_prefers_large_pages(
+    iree_device_size_t allocation_size) {
+  const iree_host_size_t large_page_size =
+      iree_memory_large_page_size(IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT);
+  return large_page_size && allocation_size >= 4 * large_page_size;
+}
+
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_allocator_t* allocator,
     iree_hal_heap_allocator_statistics_t* statistics,
-    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_heap_buffer_pool_t* pool, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, uint64_t numa_node_mask,
     iree_allocator_t data_allocator, iree_allocator_t host_allocator,
     iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(allocator);
@@ -127,14 +178,42 @@ iree_status_t iree_hal_heap_buffer_create(
   const bool same_allocator =
       memcmp(&data_allocator, &host_allocator, sizeof(data_allocator)) == 0;
 
+  // Large persistent buffers (weights, KV caches) are repeatedly streamed
+  // through in their entirety and are backed by transparent large pages to
+  // reduce TLB misses. They are rarely released and bypass the pool. Custom
+  // data allocators are always used as-is.
+  const bool use_large_pages =
+      (pool || same_allocator) &&
+      params->placement_hint == IREE_HAL_BUFFER_PLACEMENT_HINT_PERSISTENT &&
+      iree_hal_heap_buffer_prefers_large_pages(allocation_size);
+  if (use_large_pages) {
+    data_allocator =
+        iree_allocator_large_pages(IREE_MEMORY_LARGE_PAGE_MODE_TRANSPARENT);
+  }
+
   iree_hal_heap_buffer_t* buffer = NULL;
   iree_byte_span_t data = iree_make_byte_span(NULL, 0);
-  iree_status_t status =
-      same_allocator
-          ? iree_hal_heap_buffer_allocate_slab(allocation_size, host_allocator,
-                                               &buffer, &data)
-          : iree_hal_heap_buffer_allocate_split(allocation_size, data_allocator,
-                                                host_allocator, &buffer, &data);
+  iree_status_t status = iree_ok_status();
+  if (use_large_pages) {
+    status = iree_hal_heap_buffer_allocate_split(
+        allocation_size, data_allocator, host_allocator, &buffer, &data);
+  } else if (pool) {
+    status = iree_hal_heap_buffer_allocate_pooled(allocation_size, pool,
+                                                  &buffer, &data);
+  } else if (same_allocator) {
+    status = iree_hal_heap_buffer_allocate_slab(allocation_size, host_allocator,
+                                                &buffer, &data);
+  } else {
+    status = iree_hal_heap_buffer_allocate_split(
+        allocation_size, data_allocator, host_allocator, &buffer, &data);
+  }
+
+  // Place the storage on the NUMA nodes of the queues using it. Small buffers
+  // share pages with other allocations and are not worth the syscall.
+  if (iree_status_is_ok(status) && numa_node_mask &&
+      data.data_length >= IREE_HAL_HEAP_BUFFER_MIN_NUMA_PLACEMENT_SIZE) {
+    iree_memory_bind_numa_nodes(data.data, data.data_length, numa_node_mask);
+  }
 
   if (iree_status_is_ok(status)) {
     iree_hal_buffer_initialize(host_allocator, allocator, &buffer->base,
@@ -143,7 +222,13 @@ iree_status_t iree_hal_heap_buffer_create(
                                &iree_hal_heap_buffer_vtable, &buffer->base);
     buffer->data = data;
 
-    if (same_allocator) {
+    if (use_large_pages) {
+      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SPLIT;
+      buffer->data_allocator = data_allocator;
+    } else if (pool) {
+      buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED;
+      buffer->pool = pool;
+    } else if (same_allocator) {
       buffer->base.flags = IREE_HAL_HEAP_BUFFER_STORAGE_MODE_SLAB;
       buffer->data_allocator = iree_allocator_null();
     } else {
@@ -244,6 +329,13 @@ static void iree_hal_heap_buffer_destroy(iree_hal_buffer_t* base_buffer) {
       iree_allocator_free(host_allocator, buffer);
       break;
     }
+    case IREE_HAL_HEAP_BUFFER_STORAGE_MODE_POOLED: {
+      iree_hal_heap_buffer_pool_release(
+          buffer->pool, buffer,
+          IREE_HAL_HEAP_BUFFER_POOLED_HEADER_SIZE +
+              (iree_host_size_t)base_buffer->allocation_size);
+      break;
+    }
     default:
       IREE_ASSERT_UNREACHABLE("unhandled buffer storage mode");
       break;
@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/hal/allocator.h"
 #include "iree/hal/buffer.h"
 
 #ifdef __cplusplus
@@ -26,16 +27,70 @@ typedef struct iree_hal_heap_allocator_statistics_t {
   iree_hal_allocator_statistics_t base;
 } iree_hal_heap_allocator_statistics_t;
 
+//===----------------------------------------------------------------------===//
+// iree_hal_heap_buffer_pool_t
+//===----------------------------------------------------------------------===//
+
+// A thread-caching pool of host memory blocks used to back heap buffers.
+//
+// Small blocks are rounded up to size classes and cached on free lists that
+// are sharded by thread so that concurrent allocations from different threads
+// (such as local-task workers) rarely contend on the same lock and never touch
+// the system allocator once warm. Large blocks are mapped directly from the
+// platform virtual memory system where available and a bounded number of
+// released mappings are retained for reuse.
+//
+// All blocks are aligned to at least IREE_HAL_HEAP_BUFFER_ALIGNMENT.
+// Thread-safe.
+typedef struct iree_hal_heap_buffer_pool_t iree_hal_heap_buffer_pool_t;
+
+// Creates a block pool that acquires small blocks from |host_allocator|.
+iree_status_t iree_hal_heap_buffer_pool_create(
+    iree_allocator_t host_allocator, iree_hal_heap_buffer_pool_t** out_pool);
+
+// Frees |pool| and all cached blocks. All acquired blocks must have been
+// released back to the pool.
+void iree_hal_heap_buffer_pool_free(iree_hal_heap_buffer_pool_t* pool);
+
+// Acquires a block of at least |block_size| bytes from |pool|.
+iree_status_t iree_hal_heap_buffer_pool_acquire(
+    iree_hal_heap_buffer_pool_t* pool, iree_host_size_t block_size,
+    void** out_block);
+
+// Releases a |block| of |block_size| bytes previously acquired from |pool|.
+// |block_size| must match the size passed when the block was acquired.
+void iree_hal_heap_buffer_pool_release(iree_hal_heap_buffer_pool_t* pool,
+                                       void* block,
+                                       iree_host_size_t block_size);
+
+// Returns all cached blocks in |pool| to the system.
+void iree_hal_heap_buffer_pool_trim(iree_hal_heap_buffer_pool_t* pool);
+
+// Accumulates the pool_* fields of |out_statistics| with those of |pool|.
+// No-op if statistics are not enabled (IREE_STATISTICS_ENABLE).
+void iree_hal_heap_buffer_pool_query_statistics(
+    iree_hal_heap_buffer_pool_t* pool,
+    iree_hal_allocator_statistics_t* out_statistics);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_heap_buffer_t
+//===----------------------------------------------------------------------===//
+
 // Allocates a new heap buffer from the specified |data_allocator|.
 // |host_allocator| is used for the iree_hal_buffer_t metadata. If both
 // |data_allocator| and |host_allocator| are the same the buffer will be created
-// as a flat slab. |out_buffer| must be released by the caller.
+// as a flat slab. If |pool| is provided the slab is acquired from it instead of
+// |data_allocator| and returned to it when the buffer is destroyed; the pool
+// must outlive the buffer. If |numa_node_mask| is non-zero large storage is
+// placed on the NUMA nodes set in the mask (see iree_memory_bind_numa_nodes).
+// |out_buffer| must be released by the caller.
 iree_status_t iree_hal_heap_buffer_create(
     iree_hal_allocator_t* allocator,
     iree_hal_heap_allocator_statistics_t* statistics,
-    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
-    iree_allocator_t data_allocator, iree_allocator_t host_allocator,
-    iree_hal_buffer_t** out_buffer);
+    iree_hal_heap_buffer_pool_t* pool, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, uint64_t numa_node_mask,
+    iree_allocator_t data_allocator,
+    iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -0,0 +1,524 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/memory.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/buffer_heap_impl.h"
+
+// Number of thread shards small blocks are cached in. Threads are assigned
+// shards round-robin on first use; must be a power of two.
+#define IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT 8
+
+// Maximum total bytes of free small blocks cached by each shard. Blocks
+// released while a shard is at capacity are returned to the system.
+#define IREE_HAL_HEAP_BUFFER_POOL_MAX_SHARD_FREE_SIZE (4 * 1024 * 1024)
+
+// Maximum number of released large blocks retained for reuse.
+#define IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_COUNT 16
+
+// Maximum total bytes of released large blocks retained for reuse.
+#define IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_SIZE (64 * 1024 * 1024)
+
+// Thread shards require thread-local storage to remember their assignment.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS 1
+#define iree_hal_heap_buffer_pool_thread_local
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS 1
+#define iree_hal_heap_buffer_pool_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS 1
+#define iree_hal_heap_buffer_pool_thread_local __declspec(thread)
+#else
+#define IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS 0
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+// Large blocks are mapped directly from the kernel where supported.
+#if defined(IREE_PLATFORM_ANDROID) || defined(IREE_PLATFORM_APPLE) || \
+    defined(IREE_PLATFORM_LINUX)
+#define IREE_HAL_HEAP_BUFFER_POOL_HAS_MMAP 1
+#include <sys/mman.h>
+#else
+#define IREE_HAL_HEAP_BUFFER_POOL_HAS_MMAP 0
+#endif  // IREE_PLATFORM_*
+
+//===----------------------------------------------------------------------===//
+// Size classes
+//===----------------------------------------------------------------------===//
+
+// log2 of the smallest size class; smaller requests are rounded up to it.
+// Heap buffer blocks always contain at least the buffer metadata header.
+#define IREE_HAL_HEAP_BUFFER_POOL_MIN_SIZE_CLASS_LOG2 7
+
+// log2 of the largest small size class. Larger blocks are large blocks.
+#define IREE_HAL_HEAP_BUFFER_POOL_MAX_SMALL_SIZE_CLASS_LOG2 18
+
+// log2 of the number of size classes between each power of two.
+// With 4 steps each class wastes at most 25% of its size.
+#define IREE_HAL_HEAP_BUFFER_POOL_SIZE_CLASS_STEPS_LOG2 2
+
+// Total number of small size classes.
+#define IREE_HAL_HEAP_BUFFER_POOL_SMALL_SIZE_CLASS_COUNT         \
+  (((IREE_HAL_HEAP_BUFFER_POOL_MAX_SMALL_SIZE_CLASS_LOG2 -       \
+     IREE_HAL_HEAP_BUFFER_POOL_MIN_SIZE_CLASS_LOG2)              \
+    << IREE_HAL_HEAP_BUFFER_POOL_SIZE_CLASS_STEPS_LOG2) +        \
+   1)
+
+// Returns the index of the smallest size class that can hold |size| bytes and
+// the size of the class in |out_class_size|. Indices at or above
+// IREE_HAL_HEAP_BUFFER_POOL_SMALL_SIZE_CLASS_COUNT are large size classes.
+//
+// Size classes are 2^n + k * 2^(n - steps_log2) for k in [1, 2^steps_log2]
+// covering the range (2^n, 2^(n+1)].
+static iree_host_size_t iree_hal_heap_buffer_pool_size_class(
+    iree_host_size_t size, iree_host_size_t* out_class_size) {
+  const iree_host_size_t min_class_size =
+      (iree_host_size_t)1 << IREE_HAL_HEAP_BUFFER_POOL_MIN_SIZE_CLASS_LOG2;
+  if (size <= min_class_size) {
+    *out_class_size = min_class_size;
+    return 0;
+  }
+  const int n = 63 - iree_math_count_leading_zeros_u64((uint64_t)size - 1);
+  const int step_log2 = n - IREE_HAL_HEAP_BUFFER_POOL_SIZE_CLASS_STEPS_LOG2;
+  iree_host_size_t class_size =
+      iree_host_align(size, (iree_host_size_t)1 << step_log2);
+  if (IREE_UNLIKELY(class_size < size)) {
+    // Overflowed the top class; the allocation will never succeed anyway.
+    class_size = size;
+  }
+  *out_class_size = class_size;
+  const iree_host_size_t k =
+      (class_size >> step_log2) -
+      ((iree_host_size_t)1 << IREE_HAL_HEAP_BUFFER_POOL_SIZE_CLASS_STEPS_LOG2);
+  return ((iree_host_size_t)(n - IREE_HAL_HEAP_BUFFER_POOL_MIN_SIZE_CLASS_LOG2)
+          << IREE_HAL_HEAP_BUFFER_POOL_SIZE_CLASS_STEPS_LOG2) +
+         k;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_heap_buffer_pool_t
+//===----------------------------------------------------------------------===//
+
+// A free block threaded through its own storage.
+typedef struct iree_hal_heap_buffer_pool_block_t {
+  struct iree_hal_heap_buffer_pool_block_t* next;
+} iree_hal_heap_buffer_pool_block_t;
+
+// Per-thread cache of free small blocks.
+// Aligned so that threads working in different shards don't false share.
+typedef struct iree_alignas(iree_hardware_destructive_interference_size)
+    iree_hal_heap_buffer_pool_shard_t {
+  iree_slim_mutex_t mutex;
+  // Total bytes of blocks on the free lists.
+  iree_host_size_t free_size;
+  // Free blocks of each small size class.
+  iree_hal_heap_buffer_pool_block_t*
+      free_lists[IREE_HAL_HEAP_BUFFER_POOL_SMALL_SIZE_CLASS_COUNT];
+  IREE_STATISTICS(struct {
+    uint64_t hit_count;
+    uint64_t miss_count;
+    // Blocks may be released to a different shard than they were acquired
+    // from so live sizes are only meaningful when summed across shards.
+    int64_t live_size;
+    int64_t wasted_size;
+  } statistics;)
+} iree_hal_heap_buffer_pool_shard_t;
+
+// A released large block retained for reuse.
+typedef struct iree_hal_heap_buffer_pool_large_block_t {
+  void* base;
+  iree_host_size_t class_size;
+} iree_hal_heap_buffer_pool_large_block_t;
+
+struct iree_hal_heap_buffer_pool_t {
+  iree_hal_heap_buffer_pool_shard_t
+      shards[IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT];
+
+  iree_allocator_t host_allocator;
+
+  // Page size large block mappings are rounded up to.
+  iree_host_size_t page_size;
+
+  // Released large blocks ordered from least to most recently released.
+  iree_slim_mutex_t large_mutex;
+  iree_host_size_t large_free_count;
+  iree_host_size_t large_free_size;
+  iree_hal_heap_buffer_pool_large_block_t
+      large_free_blocks[IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_COUNT];
+  IREE_STATISTICS(struct {
+    uint64_t hit_count;
+    uint64_t miss_count;
+    int64_t live_size;
+    int64_t wasted_size;
+  } large_statistics;)
+};
+
+#if IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS
+// Next shard assigned to a thread on first use.
+static iree_atomic_int32_t iree_hal_heap_buffer_pool_next_shard =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// Shard assigned to the calling thread or -1 if not yet assigned.
+static iree_hal_heap_buffer_pool_thread_local int32_t
+    iree_hal_heap_buffer_pool_thread_shard = -1;
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS
+
+// Returns the shard of |pool| assigned to the calling thread.
+static iree_hal_heap_buffer_pool_shard_t* iree_hal_heap_buffer_pool_shard(
+    iree_hal_heap_buffer_pool_t* pool) {
+#if IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS
+  int32_t shard = iree_hal_heap_buffer_pool_thread_shard;
+  if (IREE_UNLIKELY(shard < 0)) {
+    shard = iree_atomic_fetch_add_int32(&iree_hal_heap_buffer_pool_next_shard,
+                                        1, iree_memory_order_relaxed) &
+            (IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT - 1);
+    iree_hal_heap_buffer_pool_thread_shard = shard;
+  }
+  return &pool->shards[shard];
+#else
+  return &pool->shards[0];
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_HAS_THREAD_SHARDS
+}
+
+iree_status_t iree_hal_heap_buffer_pool_create(
+    iree_allocator_t host_allocator, iree_hal_heap_buffer_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_heap_buffer_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc_aligned(
+              host_allocator, sizeof(*pool),
+              iree_hardware_destructive_interference_size, /*offset=*/0,
+              (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  pool->host_allocator = host_allocator;
+  pool->page_size = iree_memory_query_info().normal_page_size;
+  for (iree_host_size_t i = 0; i < IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT;
+       ++i) {
+    iree_slim_mutex_initialize(&pool->shards[i].mutex);
+  }
+  iree_slim_mutex_initialize(&pool->large_mutex);
+
+  *out_pool = pool;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_heap_buffer_pool_free(iree_hal_heap_buffer_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_heap_buffer_pool_trim(pool);
+
+  iree_slim_mutex_deinitialize(&pool->large_mutex);
+  for (iree_host_size_t i = 0; i < IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT;
+       ++i) {
+    iree_slim_mutex_deinitialize(&pool->shards[i].mutex);
+  }
+  iree_allocator_free_aligned(pool->host_allocator, pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Maps a new large block of |class_size| bytes from the system.
+static iree_status_t iree_hal_heap_buffer_pool_map_large_block(
+    iree_hal_heap_buffer_pool_t* pool, iree_host_size_t class_size,
+    void** out_base) {
+#if IREE_HAL_HEAP_BUFFER_POOL_HAS_MMAP
+  void* base =
+      mmap(NULL, iree_host_align(class_size, pool->page_size),
+           PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (base == MAP_FAILED) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "mapping of %" PRIhsz " bytes failed", class_size);
+  }
+  *out_base = base;
+  return iree_ok_status();
+#else
+  return iree_allocator_malloc_aligned(pool->host_allocator, class_size,
+                                       IREE_HAL_HEAP_BUFFER_ALIGNMENT,
+                                       /*offset=*/0, out_base);
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_HAS_MMAP
+}
+
+// Unmaps a large block of |class_size| bytes back to the system.
+static void iree_hal_heap_buffer_pool_unmap_large_block(
+    iree_hal_heap_buffer_pool_t* pool, void* base,
+    iree_host_size_t class_size) {
+#if IREE_HAL_HEAP_BUFFER_POOL_HAS_MMAP
+  munmap(base, iree_host_align(class_size, pool->page_size));
+#else
+  iree_allocator_free_aligned(pool->host_allocator, base);
+#endif  // IREE_HAL_HEAP_BUFFER_POOL_HAS_MMAP
+}
+
+static iree_status_t iree_hal_heap_buffer_pool_acquire_large(
+    iree_hal_heap_buffer_pool_t* pool, iree_host_size_t block_size,
+    iree_host_size_t class_size, void** out_block) {
+  // Reuse the most recently released block of the same class, if any.
+  void* base = NULL;
+  iree_slim_mutex_lock(&pool->large_mutex);
+  for (iree_host_size_t i = pool->large_free_count; i > 0; --i) {
+    if (pool->large_free_blocks[i - 1].class_size != class_size) continue;
+    base = pool->large_free_blocks[i - 1].base;
+    memmove(&pool->large_free_blocks[i - 1], &pool->large_free_blocks[i],
+            (pool->large_free_count - i) * sizeof(pool->large_free_blocks[0]));
+    --pool->large_free_count;
+    pool->large_free_size -= class_size;
+    break;
+  }
+  IREE_STATISTICS({
+    if (base) {
+      ++pool->large_statistics.hit_count;
+      pool->large_statistics.live_size += class_size;
+      pool->large_statistics.wasted_size += class_size - block_size;
+    }
+  });
+  iree_slim_mutex_unlock(&pool->large_mutex);
+  if (base) {
+    *out_block = base;
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, class_size);
+  iree_status_t status =
+      iree_hal_heap_buffer_pool_map_large_block(pool, class_size, &base);
+  if (!iree_status_is_ok(status)) {
+    // Cached blocks of other classes may be pinning the memory we need.
+    iree_hal_heap_buffer_pool_trim(pool);
+    iree_status_ignore(status);
+    status = iree_hal_heap_buffer_pool_map_large_block(pool, class_size, &base);
+  }
+  if (iree_status_is_ok(status)) {
+    IREE_STATISTICS({
+      iree_slim_mutex_lock(&pool->large_mutex);
+      ++pool->large_statistics.miss_count;
+      pool->large_statistics.live_size += class_size;
+      pool->large_statistics.wasted_size += class_size - block_size;
+      iree_slim_mutex_unlock(&pool->large_mutex);
+    });
+    *out_block = base;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_heap_buffer_pool_release_large(
+    iree_hal_heap_buffer_pool_t* pool, void* block, iree_host_size_t block_size,
+    iree_host_size_t class_size) {
+  // Evict the least recently released blocks to make room. Blocks too large to
+  // ever fit are returned to the system directly.
+  iree_hal_heap_buffer_pool_large_block_t
+      evicted_blocks[IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_COUNT];
+  iree_host_size_t evicted_count = 0;
+  bool retained = false;
+  iree_slim_mutex_lock(&pool->large_mutex);
+  IREE_STATISTICS({
+    pool->large_statistics.live_size -= class_size;
+    pool->large_statistics.wasted_size -= class_size - block_size;
+  });
+  if (class_size <= IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_SIZE) {
+    while (pool->large_free_count ==
+               IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_COUNT ||
+           pool->large_free_size + class_size >
+               IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_SIZE) {
+      evicted_blocks[evicted_count++] = pool->large_free_blocks[0];
+      pool->large_free_size -= pool->large_free_blocks[0].class_size;
+      --pool->large_free_count;
+      memmove(&pool->large_free_blocks[0], &pool->large_free_blocks[1],
+              pool->large_free_count * sizeof(pool->large_free_blocks[0]));
+    }
+    pool->large_free_blocks[pool->large_free_count++] =
+        (iree_hal_heap_buffer_pool_large_block_t){
+            .base = block,
+            .class_size = class_size,
+        };
+    pool->large_free_size += class_size;
+    retained = true;
+  }
+  iree_slim_mutex_unlock(&pool->large_mutex);
+
+  for (iree_host_size_t i = 0; i < evicted_count; ++i) {
+    iree_hal_heap_buffer_pool_unmap_large_block(
+        pool, evicted_blocks[i].base, evicted_blocks[i].class_size);
+  }
+  if (!retained) {
+    iree_hal_heap_buffer_pool_unmap_large_block(pool, block, class_size);
+  }
+}
+
+iree_status_t iree_hal_heap_buffer_pool_acquire(
+    iree_hal_heap_buffer_pool_t* pool, iree_host_size_t block_size,
+    void** out_block) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(out_block);
+  *out_block = NULL;
+
+  iree_host_size_t class_size = 0;
+  const iree_host_size_t class_index =
+      iree_hal_heap_buffer_pool_size_class(block_size, &class_size);
+  if (class_index >= IREE_HAL_HEAP_BUFFER_POOL_SMALL_SIZE_CLASS_COUNT) {
+    return iree_hal_heap_buffer_pool_acquire_large(pool, block_size,
+                                                   class_size, out_block);
+  }
+
+  // Fast path: pop a cached block from the thread's shard.
+  iree_hal_heap_buffer_pool_shard_t* shard =
+      iree_hal_heap_buffer_pool_shard(pool);
+  iree_slim_mutex_lock(&shard->mutex);
+  iree_hal_heap_buffer_pool_block_t* block = shard->free_lists[class_index];
+  if (block) {
+    shard->free_lists[class_index] = block->next;
+    shard->free_size -= class_size;
+    IREE_STATISTICS({
+      ++shard->statistics.hit_count;
+      shard->statistics.live_size += class_size;
+      shard->statistics.wasted_size += class_size - block_size;
+    });
+  }
+  iree_slim_mutex_unlock(&shard->mutex);
+  if (block) {
+    *out_block = block;
+    return iree_ok_status();
+  }
+
+  // Slow path: allocate a new block from the system.
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc_aligned(
+      pool->host_allocator, class_size, IREE_HAL_HEAP_BUFFER_ALIGNMENT,
+      /*offset=*/0, (void**)&block));
+  IREE_STATISTICS({
+    iree_slim_mutex_lock(&shard->mutex);
+    ++shard->statistics.miss_count;
+    shard->statistics.live_size += class_size;
+    shard->statistics.wasted_size += class_size - block_size;
+    iree_slim_mutex_unlock(&shard->mutex);
+  });
+  *out_block = block;
+  return iree_ok_status();
+}
+
+void iree_hal_heap_buffer_pool_release(iree_hal_heap_buffer_pool_t* pool,
+                                       void* block,
+                                       iree_host_size_t block_size) {
+  IREE_ASSERT_ARGUMENT(pool);
+  if (!block) return;
+
+  iree_host_size_t class_size = 0;
+  const iree_host_size_t class_index =
+      iree_hal_heap_buffer_pool_size_class(block_size, &class_size);
+  if (class_index >= IREE_HAL_HEAP_BUFFER_POOL_SMALL_SIZE_CLASS_COUNT) {
+    iree_hal_heap_buffer_pool_release_large(pool, block, block_size,
+                                            class_size);
+    return;
+  }
+
+  // Cache the block in the thread's shard if it has room.
+  iree_hal_heap_buffer_pool_shard_t* shard =
+      iree_hal_heap_buffer_pool_shard(pool);
+  bool retained = false;
+  iree_slim_mutex_lock(&shard->mutex);
+  IREE_STATISTICS({
+    shard->statistics.live_size -= class_size;
+    shard->statistics.wasted_size -= class_size - block_size;
+  });
+  if (shard->free_size + class_size <=
+      IREE_HAL_HEAP_BUFFER_POOL_MAX_SHARD_FREE_SIZE) {
+    iree_hal_heap_buffer_pool_block_t* free_block =
+        (iree_hal_heap_buffer_pool_block_t*)block;
+    free_block->next = shard->free_lists[class_index];
+    shard->free_lists[class_index] = free_block;
+    shard->free_size += class_size;
+    retained = true;
+  }
+  iree_slim_mutex_unlock(&shard->mutex);
+
+  if (!retained) {
+    iree_allocator_free_aligned(pool->host_allocator, block);
+  }
+}
+
+void iree_hal_heap_buffer_pool_trim(iree_hal_heap_buffer_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_host_size_t i = 0; i < IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT;
+       ++i) {
+    iree_hal_heap_buffer_pool_shard_t* shard = &pool->shards[i];
+    iree_hal_heap_buffer_pool_block_t*
+        free_lists[IREE_HAL_HEAP_BUFFER_POOL_SMALL_SIZE_CLASS_COUNT];
+    iree_slim_mutex_lock(&shard->mutex);
+    memcpy(free_lists, shard->free_lists, sizeof(free_lists));
+    memset(shard->free_lists, 0, sizeof(shard->free_lists));
+    shard->free_size = 0;
+    iree_slim_mutex_unlock(&shard->mutex);
+    for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(free_lists); ++j) {
+      iree_hal_heap_buffer_pool_block_t* block = free_lists[j];
+      while (block) {
+        iree_hal_heap_buffer_pool_block_t* next = block->next;
+        iree_allocator_free_aligned(pool->host_allocator, block);
+        block = next;
+      }
+    }
+  }
+
+  iree_hal_heap_buffer_pool_large_block_t
+      large_free_blocks[IREE_HAL_HEAP_BUFFER_POOL_MAX_LARGE_FREE_COUNT];
+  iree_slim_mutex_lock(&pool->large_mutex);
+  const iree_host_size_t large_free_count = pool->large_free_count;
+  memcpy(large_free_blocks, pool->large_free_blocks,
+         large_free_count * sizeof(large_free_blocks[0]));
+  pool->large_free_count = 0;
+  pool->large_free_size = 0;
+  iree_slim_mutex_unlock(&pool->large_mutex);
+  for (iree_host_size_t i = 0; i < large_free_count; ++i) {
+    iree_hal_heap_buffer_pool_unmap_large_block(
+        pool, large_free_blocks[i].base, large_free_blocks[i].class_size);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_heap_buffer_pool_query_statistics(
+    iree_hal_heap_buffer_pool_t* pool,
+    iree_hal_allocator_statistics_t* out_statistics) {
+  IREE_STATISTICS({
+    int64_t live_size = 0;
+    int64_t wasted_size = 0;
+    for (iree_host_size_t i = 0; i < IREE_HAL_HEAP_BUFFER_POOL_SHARD_COUNT;
+         ++i) {
+      iree_hal_heap_buffer_pool_shard_t* shard = &pool->shards[i];
+      iree_slim_mutex_lock(&shard->mutex);
+      out_statistics->pool_hit_count += shard->statistics.hit_count;
+      out_statistics->pool_miss_count += shard->statistics.miss_count;
+      out_statistics->pool_bytes_reserved += shard->free_size;
+      out_statistics->pool_bytes_free += shard->free_size;
+      live_size += shard->statistics.live_size;
+      wasted_size += shard->statistics.wasted_size;
+      iree_slim_mutex_unlock(&shard->mutex);
+    }
+    iree_slim_mutex_lock(&pool->large_mutex);
+    out_statistics->pool_hit_count += pool->large_statistics.hit_count;
+    out_statistics->pool_miss_count += pool->large_statistics.miss_count;
+    out_statistics->pool_bytes_reserved += pool->large_free_size;
+    out_statistics->pool_bytes_free += pool->large_free_size;
+    live_size += pool->large_statistics.live_size;
+    wasted_size += pool->large_statistics.wasted_size;
+    iree_slim_mutex_unlock(&pool->large_mutex);
+    out_statistics->pool_bytes_reserved += (iree_device_size_t)live_size;
+    out_statistics->pool_bytes_wasted += (iree_device_size_t)wasted_size;
+  });
+}
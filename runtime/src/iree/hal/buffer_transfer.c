@@ -151,8 +151,11 @@ static iree_status_t iree_hal_device_transfer_mappable_range(
       adjusted_data_length = target_mapping.contents.data_length;
     }
 
-    // Perform the copy, assuming there's anything to do.
-    if (adjusted_data_length != 0) {
+    // Perform the copy, assuming there's anything to do. Host memory imported
+    // into a device buffer on unified memory systems may alias the other side
+    // of the transfer in which case the data is already in place.
+    if (adjusted_data_length != 0 &&
+        target_mapping.contents.data != source_mapping.contents.data) {
       memcpy(target_mapping.contents.data, source_mapping.contents.data,
              adjusted_data_length);
     }
@@ -176,6 +179,37 @@ static iree_status_t iree_hal_device_transfer_mappable_range(
   return status;
 }
 
+// Returns true if |source| and |target| are device-local buffers allocated
+// from different allocators of the same implementation as that of |device|.
+// Such buffers usually live on different physical devices and mapping them
+// would pull all of the data through the host.
+static bool iree_hal_device_is_peer_transfer(
+    iree_hal_device_t* device, iree_hal_transfer_buffer_t source,
+    iree_hal_transfer_buffer_t target) {
+  if (!source.device_buffer || !target.device_buffer) return false;
+  if (!iree_all_bits_set(iree_hal_buffer_memory_type(source.device_buffer),
+                         IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) ||
+      !iree_all_bits_set(iree_hal_buffer_memory_type(target.device_buffer),
+                         IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    return false;
+  }
+  iree_hal_allocator_t* source_allocator =
+      iree_hal_buffer_allocated_buffer(source.device_buffer)->device_allocator;
+  iree_hal_allocator_t* target_allocator =
+      iree_hal_buffer_allocated_buffer(target.device_buffer)->device_allocator;
+  if (!source_allocator || !target_allocator ||
+      source_allocator == target_allocator) {
+    return false;
+  }
+  iree_hal_allocator_t* device_allocator = iree_hal_device_allocator(device);
+  if (device_allocator != source_allocator &&
+      device_allocator != target_allocator) {
+    return false;
+  }
+  return ((const iree_hal_resource_t*)source_allocator)->vtable ==
+         ((const iree_hal_resource_t*)target_allocator)->vtable;
+}
+
 // Performs a full transfer operation on a device transfer queue.
 // This creates a transfer command buffer, submits it against the device, and
 // waits for it to complete synchronously. Implementations that can do this
@@ -193,7 +227,12 @@ static iree_status_t iree_hal_device_submit_transfer_range_and_wait(
   // and where the memory lives. For example, if we have two device buffers in
   // device-local host-visible memory we'd be performing the transfer by pulling
   // all the memory to the CPU and pushing it back again.
-  // TODO(benvanik): check for device-local -> device-local and avoid mapping.
+  //
+  // Device-local buffers on different devices of the same implementation are
+  // routed through the queue so that implementations can copy directly over
+  // the device interconnect (peer-to-peer) instead of through the host.
+  bool is_peer_transfer =
+      iree_hal_device_is_peer_transfer(device, source, target);
   bool is_source_mappable =
       !source.device_buffer ||
       (iree_all_bits_set(iree_hal_buffer_memory_type(source.device_buffer),
@@ -206,7 +245,7 @@ static iree_status_t iree_hal_device_submit_transfer_range_and_wait(
                          IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
        iree_all_bits_set(iree_hal_buffer_allowed_usage(target.device_buffer),
                          IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED));
-  if (is_source_mappable && is_target_mappable) {
+  if (is_source_mappable && is_target_mappable && !is_peer_transfer) {
     return iree_hal_device_transfer_mappable_range(
         device, source, source_offset, target, target_offset, data_length,
         flags, timeout);
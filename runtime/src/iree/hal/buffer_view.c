@@ -7,6 +7,7 @@
 #include "iree/hal/buffer_view.h"
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/allocator.h"
 #include "iree/hal/buffer_view_util.h"
 #include "iree/hal/resource.h"
@@ -14,14 +15,64 @@
 struct iree_hal_buffer_view_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t host_allocator;
+  // Pool the buffer view is returned to when released or NULL if it is freed
+  // back to |host_allocator|.
+  iree_hal_buffer_view_pool_t* pool;
+  // Next free buffer view in the pool free list when not in use.
+  iree_hal_buffer_view_t* next_free;
   iree_hal_buffer_t* buffer;
   iree_hal_element_type_t element_type;
   iree_hal_encoding_type_t encoding_type;
   iree_device_size_t byte_length;
+  // Total number of dimensions that can be stored inline in |shape|.
+  iree_host_size_t shape_capacity;
   iree_host_size_t shape_rank;
   iree_hal_dim_t shape[];
 };
 
+// Initializes the metadata of |buffer_view| and retains |buffer|.
+// The shape must fit within the shape capacity of the buffer view.
+static void iree_hal_buffer_view_initialize(
+    iree_hal_buffer_t* buffer, iree_host_size_t shape_rank,
+    const iree_hal_dim_t* shape, iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type,
+    iree_hal_buffer_view_t* buffer_view) {
+  IREE_ASSERT_LE(shape_rank, buffer_view->shape_capacity);
+  buffer_view->buffer = buffer;
+  iree_hal_buffer_retain(buffer_view->buffer);
+  buffer_view->element_type = element_type;
+  buffer_view->encoding_type = encoding_type;
+  buffer_view->byte_length =
+      iree_hal_element_dense_byte_count(buffer_view->element_type);
+  buffer_view->shape_rank = shape_rank;
+  for (iree_host_size_t i = 0; i < shape_rank; ++i) {
+    buffer_view->shape[i] = shape[i];
+    buffer_view->byte_length *= shape[i];
+  }
+}
+
+// Allocates an uninitialized buffer view with room for |shape_capacity|
+// dimensions. The buffer view has a ref count of 1 and no buffer.
+static iree_status_t iree_hal_buffer_view_allocate(
+    iree_host_size_t shape_capacity, iree_allocator_t host_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  // Note that we have the dynamically-sized shape dimensions on the end.
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator,
+      sizeof(*buffer_view) + sizeof(iree_hal_dim_t) * shape_capacity,
+      (void**)&buffer_view));
+  iree_atomic_ref_count_init(&buffer_view->ref_count);
+  buffer_view->host_allocator = host_allocator;
+  buffer_view->pool = NULL;
+  buffer_view->next_free = NULL;
+  buffer_view->buffer = NULL;
+  buffer_view->shape_capacity = shape_capacity;
+  buffer_view->shape_rank = 0;
+  *out_buffer_view = buffer_view;
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_buffer_view_create(
     iree_hal_buffer_t* buffer, iree_host_size_t shape_rank,
     const iree_hal_dim_t* shape, iree_hal_element_type_t element_type,
@@ -39,26 +90,12 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_view_create(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Allocate and initialize the iree_hal_buffer_view_t struct.
-  // Note that we have the dynamically-sized shape dimensions on the end.
   iree_hal_buffer_view_t* buffer_view = NULL;
-  iree_status_t status = iree_allocator_malloc(
-      host_allocator,
-      sizeof(*buffer_view) + sizeof(iree_hal_dim_t) * shape_rank,
-      (void**)&buffer_view);
+  iree_status_t status =
+      iree_hal_buffer_view_allocate(shape_rank, host_allocator, &buffer_view);
   if (iree_status_is_ok(status)) {
-    iree_atomic_ref_count_init(&buffer_view->ref_count);
-    buffer_view->host_allocator = host_allocator;
-    buffer_view->buffer = buffer;
-    iree_hal_buffer_retain(buffer_view->buffer);
-    buffer_view->element_type = element_type;
-    buffer_view->encoding_type = encoding_type;
-    buffer_view->byte_length =
-        iree_hal_element_dense_byte_count(buffer_view->element_type);
-    buffer_view->shape_rank = shape_rank;
-    for (iree_host_size_t i = 0; i < shape_rank; ++i) {
-      buffer_view->shape[i] = shape[i];
-      buffer_view->byte_length *= shape[i];
-    }
+    iree_hal_buffer_view_initialize(buffer, shape_rank, shape, element_type,
+                                    encoding_type, buffer_view);
     *out_buffer_view = buffer_view;
   }
 
@@ -92,15 +129,54 @@ IREE_API_EXPORT void iree_hal_buffer_view_release(
   }
 }
 
+static void iree_hal_buffer_view_pool_recycle(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_view_t* buffer_view);
+
 IREE_API_EXPORT void iree_hal_buffer_view_destroy(
     iree_hal_buffer_view_t* buffer_view) {
   iree_allocator_t host_allocator = buffer_view->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_hal_buffer_release(buffer_view->buffer);
-  iree_allocator_free(host_allocator, buffer_view);
+  buffer_view->buffer = NULL;
+  if (buffer_view->pool) {
+    iree_hal_buffer_view_pool_recycle(buffer_view->pool, buffer_view);
+  } else {
+    iree_allocator_free(host_allocator, buffer_view);
+  }
   IREE_TRACE_ZONE_END(z0);
 }
 
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_reinitialize(
+    iree_hal_buffer_view_t* buffer_view, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type) {
+  IREE_ASSERT_ARGUMENT(buffer_view);
+  IREE_ASSERT_ARGUMENT(buffer);
+  if (IREE_UNLIKELY(shape_rank > 0 && !shape)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "no shape dimensions specified");
+  }
+  if (iree_atomic_ref_count_load(&buffer_view->ref_count) != 1) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "buffer views can only be reinitialized when the "
+                            "caller holds the only reference");
+  }
+  if (shape_rank > buffer_view->shape_capacity) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "shape rank %" PRIhsz
+                            " exceeds the buffer view capacity of %" PRIhsz,
+                            shape_rank, buffer_view->shape_capacity);
+  }
+  // Retain the new buffer before releasing the old one as they may be the
+  // same buffer.
+  iree_hal_buffer_t* old_buffer = buffer_view->buffer;
+  iree_hal_buffer_view_initialize(buffer, shape_rank, shape, element_type,
+                                  encoding_type, buffer_view);
+  iree_hal_buffer_release(old_buffer);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_hal_buffer_t* iree_hal_buffer_view_buffer(
     const iree_hal_buffer_view_t* buffer_view) {
   IREE_ASSERT_ARGUMENT(buffer_view);
@@ -240,3 +316,133 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_view_compute_range(
       buffer_view->encoding_type, indices_count, start_indices, lengths_count,
       lengths, out_start_offset, out_length);
 }
+
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_view_pool_t
+//===----------------------------------------------------------------------===//
+
+struct iree_hal_buffer_view_pool_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  // Shape capacity of all buffer views allocated from the pool.
+  iree_host_size_t shape_capacity;
+  // Guards the free list; buffer views may be released from any thread.
+  iree_slim_mutex_t mutex;
+  iree_hal_buffer_view_t* free_list IREE_GUARDED_BY(mutex);
+};
+
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_create(
+    iree_host_size_t shape_capacity, iree_allocator_t host_allocator,
+    iree_hal_buffer_view_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*pool), (void**)&pool));
+  iree_atomic_ref_count_init(&pool->ref_count);
+  pool->host_allocator = host_allocator;
+  pool->shape_capacity = shape_capacity;
+  iree_slim_mutex_initialize(&pool->mutex);
+  pool->free_list = NULL;
+  *out_pool = pool;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_buffer_view_pool_destroy(
+    iree_hal_buffer_view_pool_t* pool) {
+  iree_allocator_t host_allocator = pool->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_buffer_view_pool_trim(pool);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(host_allocator, pool);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_hal_buffer_view_pool_retain(
+    iree_hal_buffer_view_pool_t* pool) {
+  if (IREE_LIKELY(pool)) {
+    iree_atomic_ref_count_inc(&pool->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_hal_buffer_view_pool_release(
+    iree_hal_buffer_view_pool_t* pool) {
+  if (IREE_LIKELY(pool) && iree_atomic_ref_count_dec(&pool->ref_count) == 1) {
+    iree_hal_buffer_view_pool_destroy(pool);
+  }
+}
+
+IREE_API_EXPORT void iree_hal_buffer_view_pool_trim(
+    iree_hal_buffer_view_pool_t* pool) {
+  IREE_ASSERT_ARGUMENT(pool);
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_buffer_view_t* buffer_view = pool->free_list;
+  pool->free_list = NULL;
+  iree_slim_mutex_unlock(&pool->mutex);
+  while (buffer_view) {
+    iree_hal_buffer_view_t* next_free = buffer_view->next_free;
+    iree_allocator_free(buffer_view->host_allocator, buffer_view);
+    buffer_view = next_free;
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_acquire(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  IREE_ASSERT_ARGUMENT(pool);
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_ASSERT_ARGUMENT(out_buffer_view);
+  *out_buffer_view = NULL;
+
+  // Shapes that don't fit in pooled storage get their own allocation.
+  if (shape_rank > pool->shape_capacity) {
+    return iree_hal_buffer_view_create(buffer, shape_rank, shape, element_type,
+                                       encoding_type, pool->host_allocator,
+                                       out_buffer_view);
+  }
+  if (IREE_UNLIKELY(shape_rank > 0 && !shape)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "no shape dimensions specified");
+  }
+
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_hal_buffer_view_t* buffer_view = pool->free_list;
+  if (buffer_view) pool->free_list = buffer_view->next_free;
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  if (buffer_view) {
+    iree_atomic_ref_count_init(&buffer_view->ref_count);
+    buffer_view->next_free = NULL;
+  } else {
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_view_allocate(
+        pool->shape_capacity, pool->host_allocator, &buffer_view));
+  }
+
+  // Each live buffer view keeps the pool alive so that it has somewhere to
+  // return to when released.
+  buffer_view->pool = pool;
+  iree_hal_buffer_view_pool_retain(pool);
+  iree_hal_buffer_view_initialize(buffer, shape_rank, shape, element_type,
+                                  encoding_type, buffer_view);
+  *out_buffer_view = buffer_view;
+  return iree_ok_status();
+}
+
+// Returns |buffer_view| to the free list of |pool| and drops the reference the
+// buffer view held on the pool.
+static void iree_hal_buffer_view_pool_recycle(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_view_t* buffer_view) {
+  buffer_view->pool = NULL;
+  iree_slim_mutex_lock(&pool->mutex);
+  buffer_view->next_free = pool->free_list;
+  pool->free_list = buffer_view;
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_hal_buffer_view_pool_release(pool);
+}
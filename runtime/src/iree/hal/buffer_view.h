@@ -285,6 +285,60 @@ IREE_API_EXPORT iree_status_t iree_hal_buffer_view_compute_range(
     const iree_hal_dim_t* lengths, iree_device_size_t* out_start_offset,
     iree_device_size_t* out_length);
 
+// Reinitializes |buffer_view| in-place to view |buffer| with a new shape and
+// type. This avoids allocating a new buffer view per call when the caller
+// holds the only reference to one it is done with, such as when marshaling
+// the results of repeated invocations. Fails with
+// IREE_STATUS_FAILED_PRECONDITION if there are other references and
+// IREE_STATUS_OUT_OF_RANGE if |shape_rank| exceeds the shape storage of the
+// buffer view (its rank when created or the pool shape capacity).
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_reinitialize(
+    iree_hal_buffer_view_t* buffer_view, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_buffer_view_pool_t
+//===----------------------------------------------------------------------===//
+
+// A thread-safe free list of buffer views with fixed shape storage.
+// Buffer views acquired from the pool are returned to it when their last
+// reference is released instead of being freed, avoiding a host allocation per
+// buffer view when many short-lived ones are created (such as the inputs and
+// outputs of each call in high-rate serving). Acquired buffer views retain the
+// pool and may outlive the owner that created it.
+typedef struct iree_hal_buffer_view_pool_t iree_hal_buffer_view_pool_t;
+
+// Creates a pool of buffer views with room for |shape_capacity| dimensions.
+// Buffer views with larger shapes are allocated individually.
+// |out_pool| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_create(
+    iree_host_size_t shape_capacity, iree_allocator_t host_allocator,
+    iree_hal_buffer_view_pool_t** out_pool);
+
+// Retains the given |pool| for the caller.
+IREE_API_EXPORT void iree_hal_buffer_view_pool_retain(
+    iree_hal_buffer_view_pool_t* pool);
+
+// Releases the given |pool| from the caller.
+IREE_API_EXPORT void iree_hal_buffer_view_pool_release(
+    iree_hal_buffer_view_pool_t* pool);
+
+// Frees all buffer views not currently in use.
+IREE_API_EXPORT void iree_hal_buffer_view_pool_trim(
+    iree_hal_buffer_view_pool_t* pool);
+
+// Acquires a buffer view from |pool| with the given |buffer|, as with
+// iree_hal_buffer_view_create.
+// |out_buffer_view| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_hal_buffer_view_pool_acquire(
+    iree_hal_buffer_view_pool_t* pool, iree_hal_buffer_t* buffer,
+    iree_host_size_t shape_rank, const iree_hal_dim_t* shape,
+    iree_hal_element_type_t element_type,
+    iree_hal_encoding_type_t encoding_type,
+    iree_hal_buffer_view_t** out_buffer_view);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_t implementation details
 //===----------------------------------------------------------------------===//
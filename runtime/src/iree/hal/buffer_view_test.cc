@@ -0,0 +1,127 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class BufferViewTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), iree_allocator_system(), iree_allocator_system(),
+        &allocator_));
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    IREE_ASSERT_OK(
+        iree_hal_allocator_allocate_buffer(allocator_, params, 256, &buffer_));
+  }
+
+  void TearDown() override {
+    iree_hal_buffer_release(buffer_);
+    iree_hal_allocator_release(allocator_);
+  }
+
+  iree_hal_allocator_t* allocator_ = NULL;
+  iree_hal_buffer_t* buffer_ = NULL;
+};
+
+TEST_F(BufferViewTest, PoolRecyclesBufferViews) {
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_buffer_view_pool_create(4, iree_allocator_system(), &pool));
+
+  const iree_hal_dim_t shape[2] = {4, 8};
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, IREE_ARRAYSIZE(shape), shape,
+      IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      &buffer_view));
+  EXPECT_EQ(buffer_, iree_hal_buffer_view_buffer(buffer_view));
+  EXPECT_EQ(2, iree_hal_buffer_view_shape_rank(buffer_view));
+  EXPECT_EQ(8, iree_hal_buffer_view_shape_dim(buffer_view, 1));
+  EXPECT_EQ(4 * 8 * sizeof(float),
+            iree_hal_buffer_view_byte_length(buffer_view));
+  iree_hal_buffer_view_t* first_buffer_view = buffer_view;
+  iree_hal_buffer_view_release(buffer_view);
+
+  // The released buffer view is reused with the new metadata.
+  const iree_hal_dim_t new_shape[3] = {2, 2, 2};
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, IREE_ARRAYSIZE(new_shape), new_shape,
+      IREE_HAL_ELEMENT_TYPE_INT_8, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      &buffer_view));
+  EXPECT_EQ(first_buffer_view, buffer_view);
+  EXPECT_EQ(3, iree_hal_buffer_view_shape_rank(buffer_view));
+  EXPECT_EQ(IREE_HAL_ELEMENT_TYPE_INT_8,
+            iree_hal_buffer_view_element_type(buffer_view));
+  EXPECT_EQ(8, iree_hal_buffer_view_byte_length(buffer_view));
+
+  // Shapes larger than the pool capacity are allocated individually.
+  const iree_hal_dim_t large_shape[5] = {1, 1, 1, 1, 16};
+  iree_hal_buffer_view_t* large_buffer_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_pool_acquire(
+      pool, buffer_, IREE_ARRAYSIZE(large_shape), large_shape,
+      IREE_HAL_ELEMENT_TYPE_INT_8, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+      &large_buffer_view));
+  EXPECT_EQ(5, iree_hal_buffer_view_shape_rank(large_buffer_view));
+  iree_hal_buffer_view_release(large_buffer_view);
+
+  // Buffer views keep the pool alive after the owner releases it.
+  iree_hal_buffer_view_pool_release(pool);
+  EXPECT_EQ(buffer_, iree_hal_buffer_view_buffer(buffer_view));
+  iree_hal_buffer_view_release(buffer_view);
+}
+
+TEST_F(BufferViewTest, Reinitialize) {
+  const iree_hal_dim_t shape[2] = {4, 8};
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_view_create(
+      buffer_, IREE_ARRAYSIZE(shape), shape, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR, iree_allocator_system(),
+      &buffer_view));
+
+  // Same or lower rank shapes fit in-place.
+  const iree_hal_dim_t new_shape[1] = {16};
+  IREE_ASSERT_OK(iree_hal_buffer_view_reinitialize(
+      buffer_view, buffer_, IREE_ARRAYSIZE(new_shape), new_shape,
+      IREE_HAL_ELEMENT_TYPE_INT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR));
+  EXPECT_EQ(1, iree_hal_buffer_view_shape_rank(buffer_view));
+  EXPECT_EQ(16, iree_hal_buffer_view_shape_dim(buffer_view, 0));
+  EXPECT_EQ(16 * sizeof(int32_t),
+            iree_hal_buffer_view_byte_length(buffer_view));
+
+  // Higher ranks don't fit in the original storage.
+  const iree_hal_dim_t large_shape[3] = {2, 2, 2};
+  EXPECT_THAT(
+      Status(iree_hal_buffer_view_reinitialize(
+          buffer_view, buffer_, IREE_ARRAYSIZE(large_shape), large_shape,
+          IREE_HAL_ELEMENT_TYPE_INT_8, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR)),
+      StatusIs(StatusCode::kOutOfRange));
+
+  // Shared buffer views can't be modified.
+  iree_hal_buffer_view_retain(buffer_view);
+  EXPECT_THAT(
+      Status(iree_hal_buffer_view_reinitialize(
+          buffer_view, buffer_, IREE_ARRAYSIZE(new_shape), new_shape,
+          IREE_HAL_ELEMENT_TYPE_INT_8, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR)),
+      StatusIs(StatusCode::kFailedPrecondition));
+  iree_hal_buffer_view_release(buffer_view);
+
+  iree_hal_buffer_view_release(buffer_view);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
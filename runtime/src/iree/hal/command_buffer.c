@@ -13,6 +13,7 @@
 #include "iree/hal/detail.h"
 #include "iree/hal/device.h"
 #include "iree/hal/resource.h"
+#include "iree/hal/statistics.h"
 
 // Conditionally executes an expression based on whether command buffer
 // validation was enabled in the build and the command buffer wants validation.
@@ -413,6 +414,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_fill_buffer(
                 command_buffer, VALIDATION_STATE(command_buffer), target_buffer,
                 target_offset, length, pattern, pattern_length));
   });
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_BYTES_FILLED, length);
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, fill_buffer)(
       command_buffer, target_buffer, target_offset, length, pattern,
       pattern_length);
@@ -438,6 +440,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_update_buffer(
                 command_buffer, VALIDATION_STATE(command_buffer), source_buffer,
                 source_offset, target_buffer, target_offset, length));
   });
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_BYTES_COPIED, length);
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, update_buffer)(
       command_buffer, source_buffer, source_offset, target_buffer,
       target_offset, length);
@@ -461,6 +464,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_copy_buffer(
                 command_buffer, VALIDATION_STATE(command_buffer), source_buffer,
                 source_offset, target_buffer, target_offset, length));
   });
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_BYTES_COPIED, length);
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, copy_buffer)(
       command_buffer, source_buffer, source_offset, target_buffer,
       target_offset, length);
@@ -578,6 +582,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch(
     IREE_TRACE_ZONE_APPEND_TEXT_STRING_VIEW(z0, xyz_string, xyz_string_length);
   });
 #endif  // IREE_HAL_VERBOSE_TRACING_ENABLE
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_DISPATCH_COUNT, 1);
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, dispatch)(
       command_buffer, executable, entry_point, workgroup_x, workgroup_y,
       workgroup_z);
@@ -600,6 +605,7 @@ IREE_API_EXPORT iree_status_t iree_hal_command_buffer_dispatch_indirect(
                 command_buffer, VALIDATION_STATE(command_buffer), executable,
                 entry_point, workgroups_buffer, workgroups_offset));
   });
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_DISPATCH_COUNT, 1);
   iree_status_t status = _VTABLE_DISPATCH(command_buffer, dispatch_indirect)(
       command_buffer, executable, entry_point, workgroups_buffer,
       workgroups_offset);
@@ -11,6 +11,7 @@
 #include "iree/hal/command_buffer.h"
 #include "iree/hal/detail.h"
 #include "iree/hal/resource.h"
+#include "iree/hal/statistics.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_device_t
@@ -76,6 +77,15 @@ IREE_API_EXPORT iree_status_t iree_hal_device_query_i64(
   return _VTABLE_DISPATCH(device, query_i64)(device, category, key, out_value);
 }
 
+IREE_API_EXPORT void iree_hal_device_query_statistics(
+    iree_hal_device_t* device, iree_hal_device_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  iree_hal_statistics_query(&out_statistics->hal);
+  iree_hal_allocator_query_statistics(iree_hal_device_allocator(device),
+                                      &out_statistics->allocator);
+}
+
 IREE_API_EXPORT iree_hal_semaphore_compatibility_t
 iree_hal_device_query_semaphore_compatibility(iree_hal_device_t* device,
                                               iree_hal_semaphore_t* semaphore) {
@@ -102,6 +112,7 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_alloca(
   IREE_ASSERT_ARGUMENT(out_buffer);
   *out_buffer = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT, 1);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_alloca)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list, pool,
       params, allocation_size, out_buffer);
@@ -123,6 +134,7 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_dealloca(
                         signal_semaphore_list.payload_values));
   IREE_ASSERT_ARGUMENT(buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT, 1);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_dealloca)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       buffer);
@@ -245,6 +257,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_read(
   IREE_ASSERT_ARGUMENT(source_file);
   IREE_ASSERT_ARGUMENT(target_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT, 1);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_BYTES_COPIED, length);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_read)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       source_file, source_offset, target_buffer, target_offset, length, flags);
@@ -269,6 +283,8 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_write(
   IREE_ASSERT_ARGUMENT(source_buffer);
   IREE_ASSERT_ARGUMENT(target_file);
   IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT, 1);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_BYTES_COPIED, length);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_write)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       source_buffer, source_offset, target_file, target_offset, length, flags);
@@ -313,6 +329,9 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_execute(
     }
   }
 
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT, 1);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_COMMAND_BUFFER_SUBMISSION_COUNT,
+                             command_buffer_count);
   iree_status_t status = _VTABLE_DISPATCH(device, queue_execute)(
       device, queue_affinity, wait_semaphore_list, signal_semaphore_list,
       command_buffer_count, command_buffers);
@@ -350,8 +369,12 @@ IREE_API_EXPORT iree_status_t iree_hal_device_wait_semaphores(
   IREE_ASSERT_ARGUMENT(device);
   if (semaphore_list.count == 0) return iree_ok_status();
   IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_STATISTICS(const iree_time_t wait_start_ns = iree_time_now());
   iree_status_t status = _VTABLE_DISPATCH(device, wait_semaphores)(
       device, wait_mode, semaphore_list, timeout);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_SEMAPHORE_WAIT_COUNT, 1);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_SEMAPHORE_WAIT_NS,
+                             iree_time_now() - wait_start_ns);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -23,6 +23,7 @@
 #include "iree/hal/pipeline_layout.h"
 #include "iree/hal/resource.h"
 #include "iree/hal/semaphore.h"
+#include "iree/hal/statistics.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -280,6 +281,22 @@ IREE_API_EXPORT iree_status_t iree_hal_device_query_i64(
     iree_hal_device_t* device, iree_string_view_t category,
     iree_string_view_t key, int64_t* out_value);
 
+// Statistics queried with iree_hal_device_query_statistics.
+typedef struct iree_hal_device_statistics_t {
+  // Process-wide HAL counters; these are shared by all devices.
+  iree_hal_statistics_t hal;
+  // Statistics of the current device allocator.
+  iree_hal_allocator_statistics_t allocator;
+} iree_hal_device_statistics_t;
+
+// Queries the runtime statistics available for |device|.
+// Thread-safe and cheap enough to call periodically from production code.
+//
+// NOTE: statistics may be compiled out in some configurations and this call
+// will become a memset(0).
+IREE_API_EXPORT void iree_hal_device_query_statistics(
+    iree_hal_device_t* device, iree_hal_device_statistics_t* out_statistics);
+
 // Queries in what ways the given |semaphore| may be used with |device|.
 IREE_API_EXPORT iree_hal_semaphore_compatibility_t
 iree_hal_device_query_semaphore_compatibility(iree_hal_device_t* device,
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/utils/executable_disk_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -51,8 +52,16 @@ typedef struct iree_hal_cuda_memory_pooling_params_t {
   iree_hal_cuda_memory_pool_params_t device_local;
   // Used for any host-visible/host-local memory types.
   iree_hal_cuda_memory_pool_params_t other;
+  // Size in bytes of a block reserved from the device_local pool on first use
+  // and suballocated in stream order for DEVICE_LOCAL queue allocations.
+  // Allocations that do not fit in the block are made from the pool directly.
+  // 0 disables suballocation.
+  uint64_t transient_capacity;
 } iree_hal_cuda_memory_pooling_params_t;
 
+// The maximum number of queues (and CUDA streams) a device may expose.
+#define IREE_HAL_CUDA_MAX_QUEUE_COUNT 8
+
 // Parameters configuring an iree_hal_cuda_device_t.
 // Must be initialized with iree_hal_cuda_device_params_initialize prior to
 // use.
@@ -60,6 +69,10 @@ typedef struct iree_hal_cuda_device_params_t {
   // Number of queues exposed on the device.
   // Each queue acts as a separate synchronization scope where all work executes
   // concurrently unless prohibited by semaphores.
+  //
+  // Each queue is backed by its own CUDA stream such that submissions to
+  // different queues may overlap on the GPU. Queue affinity bits map to queues
+  // modulo the queue count. Must be at most IREE_HAL_CUDA_MAX_QUEUE_COUNT.
   iree_host_size_t queue_count;
 
   // Total size of each block in the device shared block pool.
@@ -77,6 +90,12 @@ typedef struct iree_hal_cuda_device_params_t {
   // Specifies how command buffers are recorded and executed.
   iree_hal_cuda_command_buffer_mode_t command_buffer_mode;
 
+  // Maximum number of idle instantiated graphs retained for reuse when using
+  // IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH. Command buffers that record graphs
+  // with the same structure as a retained one update it in-place instead of
+  // paying the cost of instantiation. 0 disables reuse.
+  iree_host_size_t graph_exec_cache_capacity;
+
   // Enables tracing of command buffers when IREE tracing is enabled.
   // May take advantage of additional extensions for more accurate timing or
   // hardware-specific performance counters.
@@ -91,14 +110,100 @@ typedef struct iree_hal_cuda_device_params_t {
   // device. Defaults to true when the device supports it.
   bool async_allocations;
 
+  // Whether to issue collective operations on a dedicated stream per queue
+  // such that they may overlap with dispatches recorded in the same barrier
+  // scope. Only used when NCCL is available.
+  bool collective_streams;
+
+  // Whether to enable peer-to-peer access to and from other CUDA devices in
+  // the system when the topology allows it. When enabled copies between
+  // devices are performed directly over the device interconnect and buffers
+  // allocated on peers may be imported and used by dispatches.
+  bool peer_access;
+
+  // Samples the GPU duration of every Nth dispatch and aggregates them per
+  // executable export for iree_hal_cuda_device_query_dispatch_statistics.
+  // Each sampled dispatch is bracketed by a pair of CUevents. Only dispatches
+  // issued through stream command buffers are sampled. 0 disables sampling.
+  iree_host_size_t dispatch_sample_interval;
+
+  // Size in bytes of the page-locked host memory ring used to stage scoped
+  // mappings of device-local buffers that are not host-visible. Copies are
+  // issued on a dedicated stream such that readback of results only waits for
+  // the copy itself. The memory is not allocated until first used. 0 disables
+  // staging and such buffers cannot be mapped.
+  iree_host_size_t staging_ring_capacity;
+
   // Parameters for each CUmemoryPool used for queue-ordered allocations.
   iree_hal_cuda_memory_pooling_params_t memory_pools;
+
+  // Optional persistent cache for cubins translated from PTX when executables
+  // are prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING.
+  // Retained by the driver and any devices created with these parameters.
+  iree_hal_executable_disk_cache_t* executable_disk_cache;
 } iree_hal_cuda_device_params_t;
 
 // Initializes |out_params| to default values.
 IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
     iree_hal_cuda_device_params_t* out_params);
 
+// Number of buckets in iree_hal_cuda_dispatch_statistics_t::histogram.
+#define IREE_HAL_CUDA_DISPATCH_HISTOGRAM_BUCKET_COUNT 24
+
+// GPU durations of the sampled dispatches of a single executable export.
+typedef struct iree_hal_cuda_dispatch_statistics_t {
+  // The executable containing the export. Not retained; remains valid until
+  // statistics are reset or the device is destroyed.
+  iree_hal_executable_t* executable;
+  // The export ordinal within |executable|.
+  int32_t entry_point;
+  // Number of dispatches sampled.
+  uint64_t sample_count;
+  // Sum, minimum, and maximum duration of all samples in nanoseconds.
+  uint64_t total_duration_ns;
+  uint64_t min_duration_ns;
+  uint64_t max_duration_ns;
+  // Bucket 0 counts samples under 1us and bucket i counts samples in
+  // [2^(i-1), 2^i) microseconds. The last bucket also counts all longer ones.
+  uint64_t histogram[IREE_HAL_CUDA_DISPATCH_HISTOGRAM_BUCKET_COUNT];
+} iree_hal_cuda_dispatch_statistics_t;
+
+// Queries the statistics aggregated for each sampled executable export since
+// the device was created or last reset. Sampling must have been enabled with
+// iree_hal_cuda_device_params_t::dispatch_sample_interval.
+//
+// |out_count| is set to the number of exports with statistics. If
+// |capacity| is smaller the first |capacity| entries are written to
+// |out_statistics| and IREE_STATUS_OUT_OF_RANGE is returned.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_query_dispatch_statistics(
+    iree_hal_device_t* device, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count);
+
+// Discards all statistics aggregated on |device| and releases the executables
+// they reference.
+IREE_API_EXPORT void iree_hal_cuda_device_reset_dispatch_statistics(
+    iree_hal_device_t* device);
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_buffer_t
+//===----------------------------------------------------------------------===//
+
+// Begins asynchronously copying |byte_length| bytes at |byte_offset| of the
+// device-local |buffer| into host staging memory. A subsequent scoped mapping
+// within the range waits only for the copy to complete and returns the staged
+// contents. Allows reading back results to overlap with the submission and
+// execution of later work. Only the most recent prefetch of a buffer is
+// retained.
+//
+// All device work producing the contents of the range must have completed,
+// e.g. by waiting on the semaphores signaled by the producer. No-op for
+// host-visible buffers that can be mapped directly.
+IREE_API_EXPORT iree_status_t iree_hal_cuda_buffer_prefetch_range(
+    iree_hal_buffer_t* buffer, iree_device_size_t byte_offset,
+    iree_device_size_t byte_length);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_cuda_driver_t
 //===----------------------------------------------------------------------===//
@@ -12,6 +12,7 @@
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/cuda/peer_access.h"
 
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
 static const char* IREE_HAL_CUDA_ALLOCATOR_ID = "CUDA unpooled";
@@ -31,6 +32,9 @@ typedef struct iree_hal_cuda_allocator_t {
   // NOTE: optional depending on device support.
   iree_hal_cuda_memory_pools_t* pools;
 
+  // NOTE: optional; used to map device-only buffers.
+  iree_hal_cuda_staging_ring_t* staging_ring;
+
   const iree_hal_cuda_dynamic_symbols_t* symbols;
 
   iree_allocator_t host_allocator;
@@ -57,7 +61,8 @@ static iree_hal_cuda_allocator_t* iree_hal_cuda_allocator_cast(
 iree_status_t iree_hal_cuda_allocator_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols, CUdevice device,
     CUstream stream, iree_hal_cuda_memory_pools_t* pools,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+    iree_hal_cuda_staging_ring_t* staging_ring, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(cuda_symbols);
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -107,6 +112,7 @@ iree_status_t iree_hal_cuda_allocator_create(
   allocator->device = device;
   allocator->stream = stream;
   allocator->pools = pools;
+  allocator->staging_ring = staging_ring;
   allocator->symbols = cuda_symbols;
   allocator->host_allocator = host_allocator;
   allocator->supports_concurrent_managed_access =
@@ -428,6 +434,11 @@ static iree_status_t iree_hal_cuda_allocator_allocate_buffer(
         iree_hal_allocator_host_allocator(base_allocator), &buffer);
   }
 
+  // Device-only buffers are mapped through the staging ring.
+  if (iree_status_is_ok(status) && !host_ptr && allocator->staging_ring) {
+    iree_hal_cuda_buffer_set_staging_ring(buffer, allocator->staging_ring);
+  }
+
   if (iree_status_is_ok(status)) {
     IREE_TRACE_ALLOC_NAMED(IREE_HAL_CUDA_ALLOCATOR_ID,
                            (void*)iree_hal_cuda_buffer_device_pointer(buffer),
@@ -494,6 +505,44 @@ static void iree_hal_cuda_allocator_deallocate_buffer(
   iree_hal_buffer_destroy(base_buffer);
 }
 
+// Verifies that the external |device_ptr| is accessible from the allocator
+// device. Allocations made on peer devices are aliased directly when the
+// topology allows peer-to-peer access and access is enabled on demand.
+static iree_status_t iree_hal_cuda_allocator_check_device_allocation(
+    iree_hal_cuda_allocator_t* allocator, CUdeviceptr device_ptr) {
+  // Managed memory may migrate between devices and is accessible from all.
+  unsigned int is_managed = 0;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      allocator->symbols,
+      cuPointerGetAttribute(&is_managed, CU_POINTER_ATTRIBUTE_IS_MANAGED,
+                            device_ptr),
+      "cuPointerGetAttribute"));
+  if (is_managed) return iree_ok_status();
+
+  int device_ordinal = 0;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      allocator->symbols,
+      cuPointerGetAttribute(&device_ordinal,
+                            CU_POINTER_ATTRIBUTE_DEVICE_ORDINAL, device_ptr),
+      "cuPointerGetAttribute"));
+  CUdevice owner_device = 0;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      allocator->symbols, cuDeviceGet(&owner_device, device_ordinal),
+      "cuDeviceGet"));
+  if (owner_device == allocator->device) return iree_ok_status();
+
+  if (!iree_hal_cuda_device_can_access_peer(allocator->symbols,
+                                            allocator->device, owner_device)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "device allocation belongs to CUDA device %d which is not accessible "
+        "peer-to-peer from device %d",
+        (int)owner_device, (int)allocator->device);
+  }
+  return iree_hal_cuda_device_enable_peer_access(
+      allocator->symbols, allocator->device, owner_device);
+}
+
 static iree_status_t iree_hal_cuda_allocator_import_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -571,6 +620,8 @@ static iree_status_t iree_hal_cuda_allocator_import_buffer(
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_DEVICE_ALLOCATION: {
       buffer_type = IREE_HAL_CUDA_BUFFER_TYPE_EXTERNAL;
       device_ptr = (CUdeviceptr)external_buffer->handle.device_allocation.ptr;
+      status = iree_hal_cuda_allocator_check_device_allocation(allocator,
+                                                               device_ptr);
       break;
     }
     case IREE_HAL_EXTERNAL_BUFFER_TYPE_OPAQUE_FD:
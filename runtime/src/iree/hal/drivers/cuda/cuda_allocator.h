@@ -11,6 +11,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/memory_pools.h"
+#include "iree/hal/drivers/cuda/staging_ring.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,10 +22,13 @@ extern "C" {
 // |pools| provides memory pools that may be shared across multiple allocators
 // and the pointer must remain valid for the lifetime of the allocator. Pools
 // may not be supported on all devices and can be NULL.
+// |staging_ring| is used to map device-local buffers from the host and must
+// remain valid for the lifetime of the allocator and its buffers. May be NULL.
 iree_status_t iree_hal_cuda_allocator_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols, CUdevice device,
     CUstream stream, iree_hal_cuda_memory_pools_t* pools,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+    iree_hal_cuda_staging_ring_t* staging_ring, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
 
 #ifdef __cplusplus
 }  // extern "C"
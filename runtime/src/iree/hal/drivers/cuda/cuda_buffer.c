@@ -11,6 +11,7 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/api.h"
 
 typedef struct iree_hal_cuda_buffer_t {
   iree_hal_buffer_t base;
@@ -18,6 +19,16 @@ typedef struct iree_hal_cuda_buffer_t {
   void* host_ptr;
   CUdeviceptr device_ptr;
   iree_hal_buffer_release_callback_t release_callback;
+
+  // Optional ring used to map the buffer when it has no |host_ptr|.
+  iree_hal_cuda_staging_ring_t* staging_ring;
+  // Range of the buffer prefetched with iree_hal_cuda_buffer_prefetch_range
+  // and not yet mapped, if any.
+  struct {
+    iree_hal_cuda_staging_range_t* range;
+    iree_device_size_t byte_offset;
+    iree_device_size_t byte_length;
+  } prefetch;
 } iree_hal_cuda_buffer_t;
 
 static const iree_hal_buffer_vtable_t iree_hal_cuda_buffer_vtable;
@@ -43,11 +54,12 @@ iree_status_t iree_hal_cuda_buffer_wrap(
     void* host_ptr, iree_hal_buffer_release_callback_t release_callback,
     iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer) {
   IREE_ASSERT_ARGUMENT(out_buffer);
+  // Scoped mappings of buffers without host pointers may be staged.
   if (!host_ptr && iree_any_bit_set(allowed_usage,
-                                    IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |
-                                        IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED)) {
+                                    IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT)) {
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                            "mappable buffers require host pointers");
+                            "persistently mappable buffers require host "
+                            "pointers");
   }
 
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -64,6 +76,8 @@ iree_status_t iree_hal_cuda_buffer_wrap(
     buffer->host_ptr = host_ptr;
     buffer->device_ptr = device_ptr;
     buffer->release_callback = release_callback;
+    buffer->staging_ring = NULL;
+    memset(&buffer->prefetch, 0, sizeof(buffer->prefetch));
     *out_buffer = &buffer->base;
   }
 
@@ -75,6 +89,10 @@ static void iree_hal_cuda_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(base_buffer);
   iree_allocator_t host_allocator = base_buffer->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
+  if (buffer->prefetch.range) {
+    iree_hal_cuda_staging_ring_release(buffer->staging_ring,
+                                       buffer->prefetch.range);
+  }
   if (buffer->release_callback.fn) {
     buffer->release_callback.fn(buffer->release_callback.user_data,
                                 base_buffer);
@@ -83,6 +101,72 @@ static void iree_hal_cuda_buffer_destroy(iree_hal_buffer_t* base_buffer) {
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Maps a range of a buffer without a host pointer through its staging ring.
+// Reads are served from a prior prefetch of the range when available and
+// otherwise downloaded on the staging copy stream. The staged range is stored
+// in the mapping and written back on unmap if the mapping allowed writes.
+static iree_status_t iree_hal_cuda_buffer_map_staged_range(
+    iree_hal_cuda_buffer_t* buffer, iree_hal_mapping_mode_t mapping_mode,
+    iree_hal_memory_access_t memory_access,
+    iree_device_size_t local_byte_offset, iree_device_size_t local_byte_length,
+    iree_hal_buffer_mapping_t* mapping) {
+  if (!buffer->staging_ring) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "buffer has no host pointer and staging is "
+                            "disabled on its device");
+  }
+  if (mapping_mode == IREE_HAL_MAPPING_MODE_PERSISTENT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device-local buffers can only be mapped scoped");
+  }
+  if (local_byte_length > IREE_HOST_SIZE_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "mapped range exceeds the host address space");
+  }
+
+  // Take ownership of a prefetched range covering the mapping.
+  iree_hal_cuda_staging_range_t* range = NULL;
+  iree_device_size_t range_offset = 0;
+  if (buffer->prefetch.range) {
+    if (local_byte_offset >= buffer->prefetch.byte_offset &&
+        local_byte_offset + local_byte_length <=
+            buffer->prefetch.byte_offset + buffer->prefetch.byte_length) {
+      range = buffer->prefetch.range;
+      range_offset = local_byte_offset - buffer->prefetch.byte_offset;
+    } else {
+      iree_hal_cuda_staging_ring_release(buffer->staging_ring,
+                                         buffer->prefetch.range);
+    }
+    memset(&buffer->prefetch, 0, sizeof(buffer->prefetch));
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, range ? "prefetched" : "staged");
+  if (!range) {
+    // Discarded contents need not be downloaded.
+    const bool is_discard =
+        iree_all_bits_set(memory_access, IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_cuda_staging_ring_reserve(
+                buffer->staging_ring,
+                is_discard ? 0 : buffer->device_ptr + local_byte_offset,
+                (iree_host_size_t)local_byte_length, &range));
+  }
+
+  uint8_t* host_ptr = NULL;
+  iree_status_t status =
+      iree_hal_cuda_staging_ring_wait(buffer->staging_ring, range, &host_ptr);
+  if (iree_status_is_ok(status)) {
+    mapping->contents = iree_make_byte_span(
+        host_ptr + range_offset, (iree_host_size_t)local_byte_length);
+    mapping->impl.reserved[0] = (uint64_t)(uintptr_t)range;
+  } else {
+    iree_hal_cuda_staging_ring_release(buffer->staging_ring, range);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_cuda_buffer_map_range(
     iree_hal_buffer_t* base_buffer, iree_hal_mapping_mode_t mapping_mode,
     iree_hal_memory_access_t memory_access,
@@ -92,7 +176,12 @@ static iree_status_t iree_hal_cuda_buffer_map_range(
   IREE_ASSERT_ARGUMENT(mapping);
   iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(base_buffer);
 
-  // TODO(benvanik): add upload/download for unmapped buffers.
+  if (!buffer->host_ptr) {
+    return iree_hal_cuda_buffer_map_staged_range(
+        buffer, mapping_mode, memory_access, local_byte_offset,
+        local_byte_length, mapping);
+  }
+
   IREE_RETURN_IF_ERROR(iree_hal_buffer_validate_memory_type(
       iree_hal_buffer_memory_type(base_buffer),
       IREE_HAL_MEMORY_TYPE_HOST_VISIBLE));
@@ -121,8 +210,22 @@ static iree_status_t iree_hal_cuda_buffer_map_range(
 static iree_status_t iree_hal_cuda_buffer_unmap_range(
     iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
     iree_device_size_t local_byte_length, iree_hal_buffer_mapping_t* mapping) {
-  // Nothing to do today.
-  return iree_ok_status();
+  iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(base_buffer);
+  iree_hal_cuda_staging_range_t* range =
+      (iree_hal_cuda_staging_range_t*)(uintptr_t)mapping->impl.reserved[0];
+  if (!range) return iree_ok_status();  // Host pointer mapped directly.
+
+  // Write back staged contents the host may have modified.
+  iree_status_t status = iree_ok_status();
+  if (iree_any_bit_set(mapping->impl.allowed_access,
+                       IREE_HAL_MEMORY_ACCESS_WRITE)) {
+    status = iree_hal_cuda_staging_ring_upload(
+        buffer->staging_ring, mapping->contents.data,
+        mapping->contents.data_length, buffer->device_ptr + local_byte_offset);
+  }
+  iree_hal_cuda_staging_ring_release(buffer->staging_ring, range);
+  mapping->impl.reserved[0] = 0;
+  return status;
 }
 
 static iree_status_t iree_hal_cuda_buffer_invalidate_range(
@@ -139,6 +242,10 @@ static iree_status_t iree_hal_cuda_buffer_flush_range(
   return iree_ok_status();
 }
 
+bool iree_hal_cuda_buffer_isa(const iree_hal_buffer_t* buffer) {
+  return iree_hal_resource_is(buffer, &iree_hal_cuda_buffer_vtable);
+}
+
 iree_hal_cuda_buffer_type_t iree_hal_cuda_buffer_type(
     const iree_hal_buffer_t* base_buffer) {
   const iree_hal_cuda_buffer_t* buffer =
@@ -159,6 +266,66 @@ void* iree_hal_cuda_buffer_host_pointer(const iree_hal_buffer_t* base_buffer) {
   return buffer->host_ptr;
 }
 
+void iree_hal_cuda_buffer_set_staging_ring(
+    iree_hal_buffer_t* base_buffer,
+    iree_hal_cuda_staging_ring_t* staging_ring) {
+  iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(base_buffer);
+  buffer->staging_ring = staging_ring;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_buffer_prefetch_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t byte_offset,
+    iree_device_size_t byte_length) {
+  IREE_ASSERT_ARGUMENT(base_buffer);
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(base_buffer);
+  if (!iree_hal_cuda_buffer_isa(allocated_buffer)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "buffer is not a CUDA buffer");
+  }
+  iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(allocated_buffer);
+  if (buffer->host_ptr || !buffer->staging_ring) {
+    // Host-visible buffers are mapped directly and need no staging.
+    return iree_ok_status();
+  }
+
+  const iree_device_size_t buffer_length =
+      iree_hal_buffer_byte_length(base_buffer);
+  if (byte_length == IREE_WHOLE_BUFFER) {
+    byte_length = buffer_length - iree_min(byte_offset, buffer_length);
+  }
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_validate_range(base_buffer, byte_offset, byte_length));
+  iree_device_size_t local_byte_offset =
+      iree_hal_buffer_byte_offset(base_buffer) + byte_offset;
+  iree_device_size_t local_byte_length = byte_length;
+  if (local_byte_length > IREE_HOST_SIZE_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "prefetched range exceeds the host address space");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, local_byte_length);
+
+  // Only one range is tracked per buffer; a new prefetch replaces the last.
+  if (buffer->prefetch.range) {
+    iree_hal_cuda_staging_ring_release(buffer->staging_ring,
+                                       buffer->prefetch.range);
+    memset(&buffer->prefetch, 0, sizeof(buffer->prefetch));
+  }
+
+  iree_hal_cuda_staging_range_t* range = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_staging_ring_reserve(
+              buffer->staging_ring, buffer->device_ptr + local_byte_offset,
+              (iree_host_size_t)local_byte_length, &range));
+  buffer->prefetch.range = range;
+  buffer->prefetch.byte_offset = local_byte_offset;
+  buffer->prefetch.byte_length = local_byte_length;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 void iree_hal_cuda_buffer_drop_release_callback(
     iree_hal_buffer_t* base_buffer) {
   iree_hal_cuda_buffer_t* buffer = iree_hal_cuda_buffer_cast(base_buffer);
@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/staging_ring.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -42,6 +43,9 @@ iree_status_t iree_hal_cuda_buffer_wrap(
     void* host_ptr, iree_hal_buffer_release_callback_t release_callback,
     iree_allocator_t host_allocator, iree_hal_buffer_t** out_buffer);
 
+// Returns true if |buffer| is an iree_hal_cuda_buffer_t.
+bool iree_hal_cuda_buffer_isa(const iree_hal_buffer_t* buffer);
+
 // Returns the underlying CUDA buffer type of the given |buffer|.
 iree_hal_cuda_buffer_type_t iree_hal_cuda_buffer_type(
     const iree_hal_buffer_t* buffer);
@@ -56,6 +60,11 @@ CUdeviceptr iree_hal_cuda_buffer_device_pointer(
 // Returns the CUDA host pointer for the given |buffer|, if available.
 void* iree_hal_cuda_buffer_host_pointer(const iree_hal_buffer_t* buffer);
 
+// Sets the |staging_ring| used to map the device-local |buffer| when it has no
+// host pointer. The ring must remain live for the lifetime of the buffer.
+void iree_hal_cuda_buffer_set_staging_ring(
+    iree_hal_buffer_t* buffer, iree_hal_cuda_staging_ring_t* staging_ring);
+
 // Drops the release callback so that when the buffer is destroyed no callback
 // will be made. This is not thread safe but all callers are expected to be
 // holding an allocation and the earliest the buffer could be destroyed is after
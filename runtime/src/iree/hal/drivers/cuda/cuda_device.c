@@ -14,22 +14,29 @@
 #include "iree/base/internal/event_pool.h"
 #include "iree/base/internal/math.h"
 #include "iree/hal/drivers/cuda/cuda_allocator.h"
+#include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/cuda/cufile_file.h"
+#include "iree/hal/drivers/cuda/dispatch_statistics.h"
 #include "iree/hal/drivers/cuda/event_pool.h"
 #include "iree/hal/drivers/cuda/event_semaphore.h"
 #include "iree/hal/drivers/cuda/graph_command_buffer.h"
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
 #include "iree/hal/drivers/cuda/memory_pools.h"
 #include "iree/hal/drivers/cuda/nccl_channel.h"
 #include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/nop_executable_cache.h"
+#include "iree/hal/drivers/cuda/peer_access.h"
 #include "iree/hal/drivers/cuda/pending_queue_actions.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
+#include "iree/hal/drivers/cuda/staging_ring.h"
 #include "iree/hal/drivers/cuda/stream_command_buffer.h"
 #include "iree/hal/drivers/cuda/timepoint_pool.h"
 #include "iree/hal/drivers/cuda/tracing.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
+#include "iree/hal/utils/io_uring_file.h"
 #include "iree/hal/utils/memory_file.h"
 
 //===----------------------------------------------------------------------===//
@@ -52,20 +59,36 @@ typedef struct iree_hal_cuda_device_t {
 
   const iree_hal_cuda_dynamic_symbols_t* cuda_symbols;
   const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols;
+  const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols;
 
   // Parameters used to control device behavior.
   iree_hal_cuda_device_params_t params;
 
   CUcontext cu_context;
   CUdevice cu_device;
-  // TODO: Support multiple device streams.
-  // The CUstream used to issue device kernels and allocations.
-  CUstream dispatch_cu_stream;
-  // The CUstream used to issue host callback functions.
-  CUstream callback_cu_stream;
+  // Per-queue CUstreams used to issue device kernels and allocations.
+  // Work on different streams may execute concurrently and any dependencies
+  // between them are expressed with CUevents by semaphore timepoints.
+  // The stream of queue 0 is also used for tracing and allocator operations.
+  CUstream dispatch_cu_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT];
+  // Per-queue CUstreams used to issue host callback functions. Separate
+  // streams ensure completion of one queue is not reported behind another.
+  CUstream callback_cu_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT];
+  // Optional per-queue CUstreams used to issue collective operations such that
+  // they overlap with work on the dispatch streams. NULL if collectives are
+  // issued inline on the dispatch streams.
+  CUstream collective_cu_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT];
 
   iree_hal_cuda_tracing_context_t* tracing_context;
 
+  // Samples dispatch durations for statistics queries.
+  // NULL if sampling is disabled.
+  iree_hal_cuda_dispatch_timer_t* dispatch_timer;
+
+  // Page-locked ring used to map buffers that have no host pointer.
+  // NULL if staging is disabled.
+  iree_hal_cuda_staging_ring_t* staging_ring;
+
   iree_allocator_t host_allocator;
 
   // Host/device event pools, used for backing semaphore timepoints.
@@ -80,6 +103,10 @@ typedef struct iree_hal_cuda_device_t {
   // and CUevent objects.
   iree_hal_cuda_pending_queue_actions_t* pending_queue_actions;
 
+  // Cache of idle graph execs reused by graph command buffers.
+  // NULL if graph command buffers are not used or caching is disabled.
+  iree_hal_cuda_graph_exec_cache_t* graph_exec_cache;
+
   // Device memory pools and allocators.
   bool supports_memory_pools;
   iree_hal_cuda_memory_pools_t memory_pools;
@@ -102,6 +129,16 @@ static iree_hal_cuda_device_t* iree_hal_cuda_device_cast_unsafe(
   return (iree_hal_cuda_device_t*)base_value;
 }
 
+// Returns the index of the queue that work with |queue_affinity| executes on.
+// The lowest set affinity bit selects the queue modulo the queue count such
+// that IREE_HAL_QUEUE_AFFINITY_ANY maps to queue 0.
+static iree_host_size_t iree_hal_cuda_device_select_queue(
+    iree_hal_cuda_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  if (queue_affinity == 0) return 0;
+  return iree_math_count_trailing_zeros_u64(queue_affinity) %
+         device->params.queue_count;
+}
+
 IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
     iree_hal_cuda_device_params_t* out_params) {
   memset(out_params, 0, sizeof(*out_params));
@@ -109,8 +146,37 @@ IREE_API_EXPORT void iree_hal_cuda_device_params_initialize(
   out_params->event_pool_capacity = 32;
   out_params->queue_count = 1;
   out_params->command_buffer_mode = IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH;
+  out_params->graph_exec_cache_capacity = 16;
   out_params->stream_tracing = false;
   out_params->async_allocations = true;
+  out_params->collective_streams = true;
+  out_params->peer_access = true;
+  out_params->staging_ring_capacity = 16 * 1024 * 1024;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_cuda_device_query_dispatch_statistics(
+    iree_hal_device_t* base_device, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(out_count);
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  *out_count = 0;
+  if (!device->dispatch_timer) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "dispatch sampling is not enabled on the device");
+  }
+  return iree_hal_cuda_dispatch_timer_query(device->dispatch_timer, capacity,
+                                            out_statistics, out_count);
+}
+
+IREE_API_EXPORT void iree_hal_cuda_device_reset_dispatch_statistics(
+    iree_hal_device_t* base_device) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  if (device->dispatch_timer) {
+    iree_hal_cuda_dispatch_timer_reset(device->dispatch_timer);
+  }
 }
 
 static iree_status_t iree_hal_cuda_device_check_params(
@@ -123,15 +189,22 @@ static iree_status_t iree_hal_cuda_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "at least one queue is required");
   }
+  if (params->queue_count > IREE_HAL_CUDA_MAX_QUEUE_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "queue count %" PRIhsz " exceeds the maximum of %d",
+                            params->queue_count, IREE_HAL_CUDA_MAX_QUEUE_COUNT);
+  }
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_cuda_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_cuda_device_params_t* params, CUdevice cu_device,
-    CUstream dispatch_stream, CUstream callback_stream, CUcontext context,
+    const CUstream* dispatch_streams, const CUstream* callback_streams,
+    CUcontext context,
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
     iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_cuda_device_t* device = NULL;
   iree_host_size_t total_size = iree_sizeof_struct(*device) + identifier.size;
@@ -148,24 +221,62 @@ static iree_status_t iree_hal_cuda_device_create_internal(
   iree_hal_driver_retain(device->driver);
   device->cuda_symbols = cuda_symbols;
   device->nccl_symbols = nccl_symbols;
+  device->cufile_symbols = cufile_symbols;
   device->params = *params;
+  iree_hal_executable_disk_cache_retain(device->params.executable_disk_cache);
   device->cu_context = context;
   device->cu_device = cu_device;
-  device->dispatch_cu_stream = dispatch_stream;
-  device->callback_cu_stream = callback_stream;
+  memcpy(device->dispatch_cu_streams, dispatch_streams,
+         params->queue_count * sizeof(*dispatch_streams));
+  memcpy(device->callback_cu_streams, callback_streams,
+         params->queue_count * sizeof(*callback_streams));
   device->host_allocator = host_allocator;
 
-  iree_status_t status = iree_hal_cuda_pending_queue_actions_create(
-      cuda_symbols, &device->block_pool, host_allocator,
-      &device->pending_queue_actions);
+  iree_status_t status = iree_ok_status();
+  if (params->collective_streams && nccl_symbols && nccl_symbols->dylib) {
+    for (iree_host_size_t i = 0;
+         i < params->queue_count && iree_status_is_ok(status); ++i) {
+      status = IREE_CURESULT_TO_STATUS(
+          cuda_symbols, cuStreamCreate(&device->collective_cu_streams[i],
+                                       CU_STREAM_NON_BLOCKING));
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_pending_queue_actions_create(
+        cuda_symbols, &device->block_pool, host_allocator,
+        &device->pending_queue_actions);
+  }
+
+  if (iree_status_is_ok(status) &&
+      params->command_buffer_mode == IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH &&
+      params->graph_exec_cache_capacity > 0) {
+    status = iree_hal_cuda_graph_exec_cache_allocate(
+        cuda_symbols, params->graph_exec_cache_capacity, host_allocator,
+        &device->graph_exec_cache);
+  }
 
-  // Enable tracing for the (currently only) stream - no-op if disabled.
+  // Enable tracing for the first stream - no-op if disabled.
+  // Work issued to other queues is not traced as tracing contexts require
+  // zones to be submitted in order.
   if (iree_status_is_ok(status) && device->params.stream_tracing) {
     status = iree_hal_cuda_tracing_context_allocate(
-        device->cuda_symbols, device->identifier, dispatch_stream,
+        device->cuda_symbols, device->identifier, dispatch_streams[0],
         &device->block_pool, host_allocator, &device->tracing_context);
   }
 
+  if (iree_status_is_ok(status) && params->dispatch_sample_interval > 0) {
+    status = iree_hal_cuda_dispatch_timer_allocate(
+        cuda_symbols, params->dispatch_sample_interval, host_allocator,
+        &device->dispatch_timer);
+  }
+
+  if (iree_status_is_ok(status) && params->staging_ring_capacity > 0) {
+    status = iree_hal_cuda_staging_ring_allocate(
+        cuda_symbols, params->staging_ring_capacity, host_allocator,
+        &device->staging_ring);
+  }
+
   // Memory pool support is conditional.
   if (iree_status_is_ok(status) && params->async_allocations) {
     int supports_memory_pools = 0;
@@ -183,13 +294,21 @@ static iree_status_t iree_hal_cuda_device_create_internal(
     status = iree_hal_cuda_memory_pools_initialize(
         cuda_symbols, cu_device, &params->memory_pools, host_allocator,
         &device->memory_pools);
+    device->memory_pools.staging_ring = device->staging_ring;
+  }
+
+  if (iree_status_is_ok(status) && params->peer_access) {
+    status = iree_hal_cuda_device_enable_all_peer_access(
+        cuda_symbols, cu_device,
+        device->supports_memory_pools ? device->memory_pools.device_local
+                                      : NULL);
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_allocator_create(
-        cuda_symbols, cu_device, dispatch_stream,
+        cuda_symbols, cu_device, dispatch_streams[0],
         device->supports_memory_pools ? &device->memory_pools : NULL,
-        host_allocator, &device->device_allocator);
+        device->staging_ring, host_allocator, &device->device_allocator);
   }
 
   if (iree_status_is_ok(status)) {
@@ -204,8 +323,10 @@ iree_status_t iree_hal_cuda_device_create(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_cuda_device_params_t* params,
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
-    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols, CUdevice device,
-    iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
+    const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
+    const iree_hal_cuda_cufile_dynamic_symbols_t* cufile_symbols,
+    CUdevice device, iree_allocator_t host_allocator,
+    iree_hal_device_t** out_device) {
   IREE_ASSERT_ARGUMENT(driver);
   IREE_ASSERT_ARGUMENT(params);
   IREE_ASSERT_ARGUMENT(cuda_symbols);
@@ -224,27 +345,36 @@ iree_status_t iree_hal_cuda_device_create(
     status = IREE_CURESULT_TO_STATUS(cuda_symbols, cuCtxSetCurrent(context));
   }
 
-  // Create the default dispatch stream for the device.
-  CUstream dispatch_stream = NULL;
-  if (iree_status_is_ok(status)) {
-    status = IREE_CURESULT_TO_STATUS(
-        cuda_symbols, cuStreamCreate(&dispatch_stream, CU_STREAM_NON_BLOCKING));
-  }
-  // Create the default callback stream for the device.
-  CUstream callback_stream = NULL;
-  if (iree_status_is_ok(status)) {
+  // Create the dispatch and callback streams for each queue.
+  CUstream dispatch_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT] = {NULL};
+  CUstream callback_streams[IREE_HAL_CUDA_MAX_QUEUE_COUNT] = {NULL};
+  for (iree_host_size_t i = 0;
+       i < params->queue_count && iree_status_is_ok(status); ++i) {
     status = IREE_CURESULT_TO_STATUS(
-        cuda_symbols, cuStreamCreate(&callback_stream, CU_STREAM_NON_BLOCKING));
+        cuda_symbols,
+        cuStreamCreate(&dispatch_streams[i], CU_STREAM_NON_BLOCKING));
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          cuda_symbols,
+          cuStreamCreate(&callback_streams[i], CU_STREAM_NON_BLOCKING));
+    }
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_cuda_device_create_internal(
-        driver, identifier, params, device, dispatch_stream, callback_stream,
-        context, cuda_symbols, nccl_symbols, host_allocator, out_device);
+        driver, identifier, params, device, dispatch_streams, callback_streams,
+        context, cuda_symbols, nccl_symbols, cufile_symbols, host_allocator,
+        out_device);
   } else {
     // Release resources we have accquired thus far.
-    if (callback_stream) cuda_symbols->cuStreamDestroy(callback_stream);
-    if (dispatch_stream) cuda_symbols->cuStreamDestroy(dispatch_stream);
+    for (iree_host_size_t i = 0; i < IREE_HAL_CUDA_MAX_QUEUE_COUNT; ++i) {
+      if (callback_streams[i]) {
+        cuda_symbols->cuStreamDestroy(callback_streams[i]);
+      }
+      if (dispatch_streams[i]) {
+        cuda_symbols->cuStreamDestroy(dispatch_streams[i]);
+      }
+    }
     if (context) cuda_symbols->cuDevicePrimaryCtxRelease(device);
   }
 
@@ -310,6 +440,10 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_cuda_pending_queue_actions_destroy(
       (iree_hal_resource_t*)device->pending_queue_actions);
 
+  // All graph command buffers have been released and returned their graph
+  // execs to the cache.
+  iree_hal_cuda_graph_exec_cache_free(device->graph_exec_cache);
+
   // There should be no more buffers live that use the allocator.
   iree_hal_allocator_release(device->device_allocator);
 
@@ -319,7 +453,11 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   // Destroy memory pools that hold on to reserved memory.
   iree_hal_cuda_memory_pools_deinitialize(&device->memory_pools);
 
+  // All buffers that could be mapped through the ring have been released.
+  iree_hal_cuda_staging_ring_free(device->staging_ring);
+
   iree_hal_cuda_tracing_context_free(device->tracing_context);
+  iree_hal_cuda_dispatch_timer_free(device->dispatch_timer);
 
   // Destroy various pools for synchronization.
   if (device->timepoint_pool) {
@@ -330,13 +468,23 @@ static void iree_hal_cuda_device_destroy(iree_hal_device_t* base_device) {
   }
   if (device->host_event_pool) iree_event_pool_free(device->host_event_pool);
 
-  IREE_CUDA_IGNORE_ERROR(symbols, cuStreamDestroy(device->dispatch_cu_stream));
-  IREE_CUDA_IGNORE_ERROR(symbols, cuStreamDestroy(device->callback_cu_stream));
+  for (iree_host_size_t i = 0; i < device->params.queue_count; ++i) {
+    IREE_CUDA_IGNORE_ERROR(symbols,
+                           cuStreamDestroy(device->dispatch_cu_streams[i]));
+    IREE_CUDA_IGNORE_ERROR(symbols,
+                           cuStreamDestroy(device->callback_cu_streams[i]));
+    if (device->collective_cu_streams[i]) {
+      IREE_CUDA_IGNORE_ERROR(symbols,
+                             cuStreamDestroy(device->collective_cu_streams[i]));
+    }
+  }
 
   IREE_CUDA_IGNORE_ERROR(symbols, cuDevicePrimaryCtxRelease(device->cu_device));
 
   iree_arena_block_pool_deinitialize(&device->block_pool);
 
+  iree_hal_executable_disk_cache_release(device->params.executable_disk_cache);
+
   // Finally, destroy the device.
   iree_hal_driver_release(device->driver);
 
@@ -382,7 +530,13 @@ static void iree_hal_cuda_replace_channel_provider(
 static iree_status_t iree_hal_cuda_device_trim(iree_hal_device_t* base_device) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
+  if (device->graph_exec_cache) {
+    iree_hal_cuda_graph_exec_cache_trim(device->graph_exec_cache);
+  }
   IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
+  if (device->staging_ring) {
+    iree_hal_cuda_staging_ring_trim(device->staging_ring);
+  }
   if (device->supports_memory_pools) {
     IREE_RETURN_IF_ERROR(iree_hal_cuda_memory_pools_trim(
         &device->memory_pools, &device->params.memory_pools));
@@ -523,14 +677,19 @@ static iree_status_t iree_hal_cuda_device_create_channel(
 iree_status_t iree_hal_cuda_device_create_stream_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  iree_host_size_t queue_index =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
   return iree_hal_cuda_stream_command_buffer_create(
       base_device, device->cuda_symbols, device->nccl_symbols,
-      device->tracing_context, mode, command_categories, binding_capacity,
-      device->dispatch_cu_stream, &device->block_pool, device->host_allocator,
-      out_command_buffer);
+      queue_index == 0 ? device->tracing_context : NULL,
+      device->dispatch_timer, mode,
+      command_categories, binding_capacity,
+      device->dispatch_cu_streams[queue_index],
+      device->collective_cu_streams[queue_index], &device->block_pool,
+      device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_cuda_device_create_command_buffer(
@@ -540,13 +699,19 @@ static iree_status_t iree_hal_cuda_device_create_command_buffer(
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
 
+  // Graphs are only traced when recorded for the traced queue.
+  iree_hal_cuda_tracing_context_t* tracing_context =
+      iree_hal_cuda_device_select_queue(device, queue_affinity) == 0
+          ? device->tracing_context
+          : NULL;
+
   switch (device->params.command_buffer_mode) {
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_GRAPH:
       return iree_hal_cuda_graph_command_buffer_create(
-          base_device, device->cuda_symbols, device->tracing_context,
+          base_device, device->cuda_symbols, tracing_context,
           device->cu_context, mode, command_categories, queue_affinity,
-          binding_capacity, &device->block_pool, device->host_allocator,
-          out_command_buffer);
+          binding_capacity, device->graph_exec_cache, &device->block_pool,
+          device->host_allocator, out_command_buffer);
     case IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM:
       return iree_hal_deferred_command_buffer_create(
           base_device, mode, command_categories, binding_capacity,
@@ -582,22 +747,41 @@ static iree_status_t iree_hal_cuda_device_create_executable_cache(
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   return iree_hal_cuda_nop_executable_cache_create(
       identifier, device->cuda_symbols, device->cu_device,
-      device->host_allocator, out_executable_cache);
+      device->params.executable_disk_cache, device->host_allocator,
+      out_executable_cache);
 }
 
 static iree_status_t iree_hal_cuda_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-    return iree_make_status(
-        IREE_STATUS_UNAVAILABLE,
-        "implementation does not support the external file type");
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+  switch (iree_io_file_handle_type(handle)) {
+    case IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION:
+      return iree_hal_memory_file_wrap(
+          queue_affinity, access, handle,
+          iree_hal_device_allocator(base_device), device->host_allocator,
+          out_file);
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+      // Prefer GPUDirect Storage when available so that reads into device
+      // memory bypass host staging. Not all file systems support it so fall
+      // back to a host file using the staged transfer path if registration
+      // fails.
+      if (device->cufile_symbols && device->cufile_symbols->dylib) {
+        iree_status_t status = iree_hal_cuda_cufile_file_wrap(
+            device->cufile_symbols, queue_affinity, access, handle,
+            device->host_allocator, out_file);
+        if (!iree_status_is_unavailable(status)) return status;
+        iree_status_ignore(status);
+      }
+      return iree_hal_io_uring_file_wrap(queue_affinity, access, handle,
+                                         device->host_allocator, out_file);
+    }
+    default:
+      return iree_make_status(
+          IREE_STATUS_UNAVAILABLE,
+          "implementation does not support the external file type");
   }
-  return iree_hal_memory_file_wrap(
-      queue_affinity, access, handle, iree_hal_device_allocator(base_device),
-      iree_hal_device_host_allocator(base_device), out_file);
 }
 
 static iree_status_t iree_hal_cuda_device_create_pipeline_layout(
@@ -627,8 +811,6 @@ iree_hal_cuda_device_query_semaphore_compatibility(
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
 // TODO: implement proper semaphores in CUDA to ensure ordering and avoid
 //       the barrier here.
 static iree_status_t iree_hal_cuda_device_queue_alloca(
@@ -654,7 +836,10 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
   if (device->supports_memory_pools &&
       !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     status = iree_hal_cuda_memory_pools_alloca(
-        &device->memory_pools, device->dispatch_cu_stream, pool, params,
+        &device->memory_pools,
+        device->dispatch_cu_streams[iree_hal_cuda_device_select_queue(
+            device, queue_affinity)],
+        pool, params,
         allocation_size, out_buffer);
   } else {
     status = iree_hal_allocator_allocate_buffer(
@@ -671,8 +856,6 @@ static iree_status_t iree_hal_cuda_device_queue_alloca(
   return status;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
 // TODO: implement proper semaphores in CUDA to ensure ordering and avoid
 //       the barrier here.
 static iree_status_t iree_hal_cuda_device_queue_dealloca(
@@ -693,7 +876,10 @@ static iree_status_t iree_hal_cuda_device_queue_dealloca(
   iree_status_t status = iree_ok_status();
   if (device->supports_memory_pools) {
     status = iree_hal_cuda_memory_pools_dealloca(
-        &device->memory_pools, device->dispatch_cu_stream, buffer);
+        &device->memory_pools,
+        device->dispatch_cu_streams[iree_hal_cuda_device_select_queue(
+            device, queue_affinity)],
+        buffer);
   }
 
   // Only signal if not returning a synchronous error - synchronous failure
@@ -712,6 +898,40 @@ static iree_status_t iree_hal_cuda_device_queue_read(
     iree_hal_file_t* source_file, uint64_t source_offset,
     iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
     iree_device_size_t length, uint32_t flags) {
+  iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
+
+  // GPUDirect Storage reads go straight from the file into device memory.
+  // cuFile only supports memory from cuMemAlloc so other buffer types (host,
+  // memory pool, external) take the staged path below.
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(target_buffer);
+  if (iree_hal_cuda_cufile_file_isa(source_file) &&
+      iree_hal_cuda_buffer_isa(allocated_buffer) &&
+      iree_hal_cuda_buffer_type(allocated_buffer) ==
+          IREE_HAL_CUDA_BUFFER_TYPE_DEVICE) {
+    // NOTE: this is synchronous on the calling thread like queue_alloca; a
+    // real async version would hand the read off to a worker once the waits
+    // are satisfied.
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
+                                                      iree_infinite_timeout()));
+    CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(
+                                 allocated_buffer) +
+                             iree_hal_buffer_byte_offset(target_buffer) +
+                             target_offset;
+    iree_status_t status = IREE_CURESULT_TO_STATUS(
+        device->cuda_symbols, cuCtxSetCurrent(device->cu_context));
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_cuda_cufile_file_read_device(source_file, source_offset,
+                                                     device_ptr, length);
+    }
+    if (iree_status_is_ok(status)) {
+      return iree_hal_semaphore_list_signal(signal_semaphore_list);
+    }
+    iree_hal_semaphore_list_fail(signal_semaphore_list,
+                                 iree_status_clone(status));
+    return status;
+  }
+
   // TODO: expose streaming chunk count/size options.
   iree_status_t loop_status = iree_ok_status();
   iree_hal_file_transfer_options_t options = {
@@ -761,9 +981,13 @@ static iree_status_t iree_hal_cuda_device_queue_execute(
   iree_hal_cuda_device_t* device = iree_hal_cuda_device_cast(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Dependencies on work submitted to other queues are expressed by the wait
+  // semaphores and resolved with CUevents when issued.
+  iree_host_size_t queue_index =
+      iree_hal_cuda_device_select_queue(device, queue_affinity);
   iree_status_t status = iree_hal_cuda_pending_queue_actions_enqueue_execution(
-      base_device, device->dispatch_cu_stream, device->callback_cu_stream,
-      device->pending_queue_actions,
+      base_device, queue_affinity, device->dispatch_cu_streams[queue_index],
+      device->callback_cu_streams[queue_index], device->pending_queue_actions,
       iree_hal_cuda_device_collect_tracing_context, device->tracing_context,
       wait_semaphore_list, signal_semaphore_list, command_buffer_count,
       command_buffers);
@@ -13,6 +13,7 @@
 #include "iree/hal/drivers/cuda/cuda_device.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/nccl_status_util.h"
 
@@ -36,6 +37,8 @@ typedef struct iree_hal_cuda_driver_t {
   iree_hal_cuda_dynamic_symbols_t cuda_symbols;
   // NCCL API dynamic symbols to interact with the CUDA system.
   iree_hal_cuda_nccl_dynamic_symbols_t nccl_symbols;
+  // Optional cuFile API dynamic symbols for GPUDirect Storage file transfers.
+  iree_hal_cuda_cufile_dynamic_symbols_t cufile_symbols;
 
   // The default parameters for creating devices using this driver.
   iree_hal_cuda_device_params_t device_params;
@@ -88,7 +91,17 @@ static iree_status_t iree_hal_cuda_driver_create_internal(
     if (iree_status_is_unavailable(status)) status = iree_status_ignore(status);
   }
 
+  if (iree_status_is_ok(status)) {
+    // Try to dynamically load cuFile. If unavailable files are imported using
+    // the host-staged transfer path instead.
+    status = iree_hal_cuda_cufile_dynamic_symbols_initialize(
+        host_allocator, &driver->cuda_symbols, &driver->cufile_symbols);
+    if (iree_status_is_unavailable(status)) status = iree_status_ignore(status);
+  }
+
   memcpy(&driver->device_params, device_params, sizeof(driver->device_params));
+  iree_hal_executable_disk_cache_retain(
+      driver->device_params.executable_disk_cache);
 
   if (iree_status_is_ok(status)) {
     *out_driver = (iree_hal_driver_t*)driver;
@@ -122,8 +135,11 @@ static void iree_hal_cuda_driver_destroy(iree_hal_driver_t* base_driver) {
   iree_allocator_t host_allocator = driver->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_cuda_cufile_dynamic_symbols_deinitialize(&driver->cufile_symbols);
   iree_hal_cuda_nccl_dynamic_symbols_deinitialize(&driver->nccl_symbols);
   iree_hal_cuda_dynamic_symbols_deinitialize(&driver->cuda_symbols);
+  iree_hal_executable_disk_cache_release(
+      driver->device_params.executable_disk_cache);
   iree_allocator_free(host_allocator, driver);
 
   IREE_TRACE_ZONE_END(z0);
@@ -488,7 +504,8 @@ static iree_status_t iree_hal_cuda_driver_create_device_by_id(
   // Attempt to create the device now.
   iree_status_t status = iree_hal_cuda_device_create(
       base_driver, device_name, &driver->device_params, &driver->cuda_symbols,
-      &driver->nccl_symbols, device, host_allocator, out_device);
+      &driver->nccl_symbols, &driver->cufile_symbols, device, host_allocator,
+      out_device);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -16,11 +16,14 @@ IREE_CU_PFN_DECL(cuDevicePrimaryCtxRelease, CUdevice)
 IREE_CU_PFN_DECL(cuCtxSetCurrent, CUcontext)
 IREE_CU_PFN_DECL(cuCtxPushCurrent, CUcontext)
 IREE_CU_PFN_DECL(cuCtxPopCurrent, CUcontext*)
+IREE_CU_PFN_DECL(cuCtxEnablePeerAccess, CUcontext, unsigned int)
 IREE_CU_PFN_DECL(cuDeviceGet, CUdevice*, int)
+IREE_CU_PFN_DECL(cuDeviceCanAccessPeer, int*, CUdevice, CUdevice)
 IREE_CU_PFN_DECL(cuDeviceGetCount, int*)
 IREE_CU_PFN_DECL(cuDeviceGetName, char*, int, CUdevice)
 IREE_CU_PFN_DECL(cuDeviceGetAttribute, int*, CUdevice_attribute, CUdevice)
 IREE_CU_PFN_DECL(cuDeviceGetUuid, CUuuid*, CUdevice)
+IREE_CU_PFN_DECL(cuDevicePrimaryCtxGetState, CUdevice, unsigned int*, int*)
 IREE_CU_PFN_DECL(cuEventCreate, CUevent*, unsigned int)
 IREE_CU_PFN_DECL(cuEventDestroy, CUevent)
 IREE_CU_PFN_DECL(cuEventElapsedTime, float*, CUevent, CUevent)
@@ -42,11 +45,19 @@ IREE_CU_PFN_DECL(cuGraphAddKernelNode, CUgraphNode*, CUgraph,
 IREE_CU_PFN_DECL(cuGraphCreate, CUgraph*, unsigned int)
 IREE_CU_PFN_DECL(cuGraphDestroy, CUgraph)
 IREE_CU_PFN_DECL(cuGraphExecDestroy, CUgraphExec)
+IREE_CU_PFN_DECL(cuGraphExecUpdate, CUgraphExec, CUgraph, CUgraphNode*,
+                 CUgraphExecUpdateResult*)
 IREE_CU_PFN_DECL(cuGraphGetNodes, CUgraph, CUgraphNode*, size_t*)
 IREE_CU_PFN_DECL(cuGraphInstantiate, CUgraphExec*, CUgraph, CUgraphNode*, char*,
                  size_t)
 IREE_CU_PFN_DECL(cuGraphLaunch, CUgraphExec, CUstream)
 IREE_CU_PFN_DECL(cuInit, unsigned int)
+IREE_CU_PFN_DECL(cuLinkAddData, CUlinkState, CUjitInputType, void*, size_t,
+                 const char*, unsigned int, CUjit_option*, void**)
+IREE_CU_PFN_DECL(cuLinkComplete, CUlinkState, void**, size_t*)
+IREE_CU_PFN_DECL(cuLinkCreate, unsigned int, CUjit_option*, void**,
+                 CUlinkState*)
+IREE_CU_PFN_DECL(cuLinkDestroy, CUlinkState)
 IREE_CU_PFN_DECL(cuMemAllocManaged, CUdeviceptr*, size_t, unsigned int)
 IREE_CU_PFN_DECL(cuMemPrefetchAsync, CUdeviceptr, size_t, CUdevice, CUstream)
 IREE_CU_PFN_DECL(cuMemAlloc, CUdeviceptr*, size_t)
@@ -83,7 +94,9 @@ IREE_CU_PFN_DECL(cuMemsetD16Async, unsigned long long, unsigned short, size_t,
 IREE_CU_PFN_DECL(cuMemsetD8Async, unsigned long long, unsigned char, size_t,
                  CUstream)
 IREE_CU_PFN_DECL(cuMemcpyAsync, CUdeviceptr, CUdeviceptr, size_t, CUstream)
+IREE_CU_PFN_DECL(cuMemcpyDtoHAsync, void*, CUdeviceptr, size_t, CUstream)
 IREE_CU_PFN_DECL(cuMemcpyHtoDAsync, CUdeviceptr, const void*, size_t, CUstream)
+IREE_CU_PFN_DECL(cuPointerGetAttribute, void*, CUpointer_attribute, CUdeviceptr)
 IREE_CU_PFN_DECL(cuFuncSetAttribute, CUfunction, CUfunction_attribute, int)
 IREE_CU_PFN_DECL(cuLaunchKernel, CUfunction, unsigned int, unsigned int,
                  unsigned int, unsigned int, unsigned int, unsigned int,
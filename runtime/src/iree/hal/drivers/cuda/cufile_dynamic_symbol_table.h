@@ -0,0 +1,14 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+IREE_CUFILE_PFN_DECL(cuFileDriverOpen, void)
+IREE_CUFILE_PFN_DECL(cuFileDriverClose, void)
+IREE_CUFILE_PFN_DECL(cuFileHandleRegister, CUfileHandle_t*, CUfileDescr_t*)
+IREE_CUFILE_PFN_DECL_VOID_RETURN(cuFileHandleDeregister, CUfileHandle_t)
+IREE_CUFILE_PFN_DECL_SSIZE_RETURN(cuFileRead, CUfileHandle_t, void*, size_t,
+                                  iree_cufile_off_t, iree_cufile_off_t)
+IREE_CUFILE_PFN_DECL_SSIZE_RETURN(cuFileWrite, CUfileHandle_t, const void*,
+                                  size_t, iree_cufile_off_t, iree_cufile_off_t)
@@ -0,0 +1,113 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbols.h"
+
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/dynamic_library.h"
+
+#if defined(IREE_PLATFORM_LINUX)
+static const char* iree_hal_cuda_cufile_dylib_names[] = {
+    "libcufile.so.0",
+    "libcufile.so",
+};
+#endif  // IREE_PLATFORM_LINUX
+
+// Resolves all cuFile dynamic symbols in `cufile_dynamic_symbol_table.h`.
+static iree_status_t iree_hal_cuda_cufile_dynamic_symbols_resolve_all(
+    iree_hal_cuda_cufile_dynamic_symbols_t* syms) {
+#define IREE_CUFILE_PFN_LOOKUP(cufile_symbol_name)              \
+  {                                                             \
+    static const char* name = #cufile_symbol_name;              \
+    IREE_RETURN_IF_ERROR(iree_dynamic_library_lookup_symbol(    \
+        syms->dylib, name, (void**)&syms->cufile_symbol_name)); \
+  }
+#define IREE_CUFILE_PFN_DECL(cufile_symbol_name, ...) \
+  IREE_CUFILE_PFN_LOOKUP(cufile_symbol_name)
+#define IREE_CUFILE_PFN_DECL_VOID_RETURN(cufile_symbol_name, ...) \
+  IREE_CUFILE_PFN_LOOKUP(cufile_symbol_name)
+#define IREE_CUFILE_PFN_DECL_SSIZE_RETURN(cufile_symbol_name, ...) \
+  IREE_CUFILE_PFN_LOOKUP(cufile_symbol_name)
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbol_table.h"  // IWYU pragma: keep
+#undef IREE_CUFILE_PFN_DECL
+#undef IREE_CUFILE_PFN_DECL_VOID_RETURN
+#undef IREE_CUFILE_PFN_DECL_SSIZE_RETURN
+#undef IREE_CUFILE_PFN_LOOKUP
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_cufile_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator,
+    const iree_hal_cuda_dynamic_symbols_t* cuda_library,
+    iree_hal_cuda_cufile_dynamic_symbols_t* out_syms) {
+  IREE_ASSERT_ARGUMENT(out_syms);
+  if (!cuda_library->dylib) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "CUDA dynamic symbols must be resolved prior to loading cuFile "
+        "symbols");
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  memset(out_syms, 0, sizeof(*out_syms));
+#if defined(IREE_PLATFORM_LINUX)
+  iree_status_t status = iree_dynamic_library_load_from_files(
+      IREE_ARRAYSIZE(iree_hal_cuda_cufile_dylib_names),
+      iree_hal_cuda_cufile_dylib_names, IREE_DYNAMIC_LIBRARY_FLAG_NONE,
+      host_allocator, &out_syms->dylib);
+  if (iree_status_is_not_found(status)) {
+    iree_status_ignore(status);
+    status = iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "cuFile (GPUDirect Storage) runtime library not available; ensure "
+        "installed and the shared library (libcufile.so) is on your "
+        "LD_LIBRARY_PATH.");
+  }
+#else
+  iree_status_t status = iree_make_status(
+      IREE_STATUS_UNAVAILABLE,
+      "cuFile (GPUDirect Storage) is only available on Linux");
+#endif  // IREE_PLATFORM_LINUX
+
+  // Resolve all symbols; this will fail if any required symbols are missing.
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_cufile_dynamic_symbols_resolve_all(out_syms);
+  }
+
+  // Open the driver. This fails if the kernel module or file system support is
+  // missing and we treat that the same as the library being missing.
+  if (iree_status_is_ok(status)) {
+    CUfileError_t result = out_syms->cuFileDriverOpen();
+    if (result.err != CU_FILE_SUCCESS) {
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "cuFileDriverOpen failed with error %d",
+                                (int)result.err);
+    }
+  }
+
+  if (!iree_status_is_ok(status)) {
+    iree_dynamic_library_release(out_syms->dylib);
+    memset(out_syms, 0, sizeof(*out_syms));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_cufile_dynamic_symbols_deinitialize(
+    iree_hal_cuda_cufile_dynamic_symbols_t* syms) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (syms->dylib) {
+    syms->cuFileDriverClose();
+  }
+  iree_dynamic_library_release(syms->dylib);
+  memset(syms, 0, sizeof(*syms));
+
+  IREE_TRACE_ZONE_END(z0);
+}
@@ -0,0 +1,63 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_DYNAMIC_SYMBOLS_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_DYNAMIC_SYMBOLS_H_
+
+#include "iree/base/api.h"
+#include "iree/base/internal/dynamic_library.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cufile_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// iree_dynamic_library_t allows dynamically loading a subset of the cuFile
+// (GPUDirect Storage) API. We load all the symbols in
+// `cufile_dynamic_symbol_table.h` and fail if any of the symbol is not
+// available. The functions signatures are matching the declarations in
+// `cufile.h`.
+
+// cuFile API dynamic symbols.
+typedef struct iree_hal_cuda_cufile_dynamic_symbols_t {
+  // The dynamic library handle.
+  iree_dynamic_library_t* dylib;
+
+  // Concrete cuFile symbols defined by including the symbol table.
+#define IREE_CUFILE_PFN_DECL(cufileSymbolName, ...) \
+  CUfileError_t (*cufileSymbolName)(__VA_ARGS__);
+#define IREE_CUFILE_PFN_DECL_VOID_RETURN(cufileSymbolName, ...) \
+  void (*cufileSymbolName)(__VA_ARGS__);
+#define IREE_CUFILE_PFN_DECL_SSIZE_RETURN(cufileSymbolName, ...) \
+  iree_cufile_ssize_t (*cufileSymbolName)(__VA_ARGS__);
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbol_table.h"  // IWYU pragma: export
+#undef IREE_CUFILE_PFN_DECL
+#undef IREE_CUFILE_PFN_DECL_VOID_RETURN
+#undef IREE_CUFILE_PFN_DECL_SSIZE_RETURN
+} iree_hal_cuda_cufile_dynamic_symbols_t;
+
+// Initializes |out_syms| in-place with dynamically loaded cuFile symbols and
+// opens the cuFile driver. Fails with IREE_STATUS_UNAVAILABLE if the library
+// is not present or the driver cannot be opened (no GPUDirect Storage support
+// in the kernel/file system, etc).
+// iree_hal_cuda_cufile_dynamic_symbols_deinitialize must be used to close the
+// driver and release the library resources.
+iree_status_t iree_hal_cuda_cufile_dynamic_symbols_initialize(
+    iree_allocator_t host_allocator,
+    const iree_hal_cuda_dynamic_symbols_t* cuda_library,
+    iree_hal_cuda_cufile_dynamic_symbols_t* out_syms);
+
+// Deinitializes |syms| by closing the cuFile driver and unloading the backing
+// library. All function pointers will be invalidated.
+void iree_hal_cuda_cufile_dynamic_symbols_deinitialize(
+    iree_hal_cuda_cufile_dynamic_symbols_t* syms);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_DYNAMIC_SYMBOLS_H_
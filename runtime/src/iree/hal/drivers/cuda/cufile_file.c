@@ -0,0 +1,194 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/cufile_file.h"
+
+#include <errno.h>
+#include <string.h>
+
+#include "iree/hal/utils/io_uring_file.h"
+
+// Maximum number of bytes per cuFileRead call. cuFile internally splits
+// transfers into bounce-buffer sized pieces when needed but large single calls
+// may still return short reads.
+#define IREE_HAL_CUDA_CUFILE_CHUNK_SIZE (64 * 1024 * 1024)
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_cufile_file_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_cuda_cufile_file_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+  const iree_hal_cuda_cufile_dynamic_symbols_t* symbols;
+  // Host-side file used for synchronous and staged transfers.
+  iree_hal_file_t* host_file;
+  // cuFile registration of the file descriptor.
+  CUfileHandle_t cufile_handle;
+} iree_hal_cuda_cufile_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_cuda_cufile_file_vtable;
+
+static iree_hal_cuda_cufile_file_t* iree_hal_cuda_cufile_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_cuda_cufile_file_vtable);
+  return (iree_hal_cuda_cufile_file_t*)base_value;
+}
+
+iree_status_t iree_hal_cuda_cufile_file_wrap(
+    const iree_hal_cuda_cufile_dynamic_symbols_t* symbols,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  if (!symbols->dylib) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "cuFile (GPUDirect Storage) not available");
+  }
+  if (iree_io_file_handle_type(handle) != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "cuFile requires file descriptor handles");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_cufile_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  memset(file, 0, sizeof(*file));
+  iree_hal_resource_initialize(&iree_hal_cuda_cufile_file_vtable,
+                               &file->resource);
+  file->host_allocator = host_allocator;
+  file->symbols = symbols;
+
+  iree_status_t status = iree_hal_io_uring_file_wrap(
+      queue_affinity, access, handle, host_allocator, &file->host_file);
+
+  if (iree_status_is_ok(status)) {
+    CUfileDescr_t descr;
+    memset(&descr, 0, sizeof(descr));
+    descr.type = CU_FILE_HANDLE_TYPE_OPAQUE_FD;
+    descr.handle.fd = iree_io_file_handle_value(handle).fd;
+    CUfileError_t result =
+        symbols->cuFileHandleRegister(&file->cufile_handle, &descr);
+    if (result.err != CU_FILE_SUCCESS) {
+      file->cufile_handle = NULL;
+      status = iree_make_status(IREE_STATUS_UNAVAILABLE,
+                                "cuFileHandleRegister failed with error %d",
+                                (int)result.err);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_file = (iree_hal_file_t*)file;
+  } else {
+    iree_hal_file_release((iree_hal_file_t*)file);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_cuda_cufile_file_destroy(
+    iree_hal_file_t* IREE_RESTRICT base_file) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (file->cufile_handle) {
+    file->symbols->cuFileHandleDeregister(file->cufile_handle);
+  }
+  iree_hal_file_release(file->host_file);
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_cuda_cufile_file_isa(iree_hal_file_t* file) {
+  return iree_hal_resource_is(file, &iree_hal_cuda_cufile_file_vtable);
+}
+
+iree_status_t iree_hal_cuda_cufile_file_read_device(iree_hal_file_t* base_file,
+                                                    uint64_t file_offset,
+                                                    CUdeviceptr device_ptr,
+                                                    iree_device_size_t length) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  iree_status_t status = iree_ok_status();
+  iree_device_size_t offset = 0;
+  while (iree_status_is_ok(status) && offset < length) {
+    size_t chunk_length =
+        (size_t)iree_min(length - offset, IREE_HAL_CUDA_CUFILE_CHUNK_SIZE);
+    iree_cufile_ssize_t read_length = file->symbols->cuFileRead(
+        file->cufile_handle, (void*)(uintptr_t)device_ptr, chunk_length,
+        (iree_cufile_off_t)(file_offset + offset), (iree_cufile_off_t)offset);
+    if (read_length < 0) {
+      // -1 indicates a system error in errno; other negative values are
+      // negated CUfileOpError codes.
+      status = read_length == -1
+                   ? iree_make_status(iree_status_code_from_errno(errno),
+                                      "cuFileRead failed")
+                   : iree_make_status(IREE_STATUS_INTERNAL,
+                                      "cuFileRead failed with error %d",
+                                      (int)-read_length);
+    } else if (read_length == 0) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "unexpected end of file reading %" PRIu64 " bytes at offset %" PRIu64,
+          (uint64_t)length, file_offset);
+    } else {
+      offset += (iree_device_size_t)read_length;
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_hal_memory_access_t iree_hal_cuda_cufile_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  return iree_hal_file_allowed_access(file->host_file);
+}
+
+static uint64_t iree_hal_cuda_cufile_file_length(iree_hal_file_t* base_file) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  return iree_hal_file_length(file->host_file);
+}
+
+static iree_hal_buffer_t* iree_hal_cuda_cufile_file_storage_buffer(
+    iree_hal_file_t* base_file) {
+  // Descriptors have no device-accessible storage.
+  return NULL;
+}
+
+static iree_status_t iree_hal_cuda_cufile_file_read(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  return iree_hal_file_read(file->host_file, file_offset, buffer,
+                            buffer_offset, length);
+}
+
+static iree_status_t iree_hal_cuda_cufile_file_write(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  iree_hal_cuda_cufile_file_t* file = iree_hal_cuda_cufile_file_cast(base_file);
+  return iree_hal_file_write(file->host_file, file_offset, buffer,
+                             buffer_offset, length);
+}
+
+static const iree_hal_file_vtable_t iree_hal_cuda_cufile_file_vtable = {
+    .destroy = iree_hal_cuda_cufile_file_destroy,
+    .allowed_access = iree_hal_cuda_cufile_file_allowed_access,
+    .length = iree_hal_cuda_cufile_file_length,
+    .storage_buffer = iree_hal_cuda_cufile_file_storage_buffer,
+    .read = iree_hal_cuda_cufile_file_read,
+    .write = iree_hal_cuda_cufile_file_write,
+};
@@ -0,0 +1,51 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_FILE_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/cufile_dynamic_symbols.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a file backed by the file descriptor referenced by |handle| that is
+// registered with cuFile (GPUDirect Storage) so that reads can be DMA'ed from
+// storage directly into device memory.
+//
+// Host-side synchronous reads/writes and transfers into buffers that are not
+// device allocations are serviced by an io_uring file wrapping the same
+// handle (see iree/hal/utils/io_uring_file.h).
+//
+// Fails with IREE_STATUS_UNAVAILABLE if |handle| is not a file descriptor or
+// cuFile is unable to register it (file system without GPUDirect Storage
+// support, O_DIRECT unsupported, etc).
+iree_status_t iree_hal_cuda_cufile_file_wrap(
+    const iree_hal_cuda_cufile_dynamic_symbols_t* symbols,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file);
+
+// Returns true if |file| is an iree_hal_cuda_cufile_file_t.
+bool iree_hal_cuda_cufile_file_isa(iree_hal_file_t* file);
+
+// Synchronously reads |length| bytes from |file| at |file_offset| into device
+// memory at |device_ptr|. The CUDA context owning |device_ptr| must be current.
+iree_status_t iree_hal_cuda_cufile_file_read_device(iree_hal_file_t* file,
+                                                    uint64_t file_offset,
+                                                    CUdeviceptr device_ptr,
+                                                    iree_device_size_t length);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_FILE_H_
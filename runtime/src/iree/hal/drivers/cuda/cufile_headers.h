@@ -0,0 +1,51 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
+#define IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
+
+#include <stdint.h>
+
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+// The subset of the cuFile (GPUDirect Storage) ABI used by the CUDA HAL.
+// libcufile is loaded dynamically and is not available on all systems so we
+// declare only what we need here instead of depending on the full cufile.h.
+// Layouts must match cufile.h:
+// https://docs.nvidia.com/gpudirect-storage/api-reference-guide/index.html
+//
+// cuFile is only available on 64-bit Linux where both `ssize_t` and `off_t`
+// are 64-bit; we use fixed-width types so this header compiles everywhere.
+typedef int64_t iree_cufile_ssize_t;
+typedef int64_t iree_cufile_off_t;
+
+typedef enum CUfileOpError {
+  CU_FILE_SUCCESS = 0,
+} CUfileOpError;
+
+typedef struct CUfileError {
+  CUfileOpError err;
+  CUresult cu_err;
+} CUfileError_t;
+
+typedef enum CUfileFileHandleType {
+  CU_FILE_HANDLE_TYPE_OPAQUE_FD = 1,
+  CU_FILE_HANDLE_TYPE_OPAQUE_WIN32 = 2,
+  CU_FILE_HANDLE_TYPE_USERSPACE_FS = 3,
+} CUfileFileHandleType;
+
+typedef struct CUfileDescr_t {
+  CUfileFileHandleType type;
+  union {
+    int fd;
+    void* handle;
+  } handle;
+  const void* fs_ops;
+} CUfileDescr_t;
+
+typedef void* CUfileHandle_t;
+
+#endif  // IREE_HAL_DRIVERS_CUDA_CUFILE_HEADERS_H_
@@ -0,0 +1,349 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/dispatch_statistics.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+// Maximum number of samples that may be in flight at any time. Dispatches
+// issued while the ring is full and no samples have completed go unsampled.
+#define IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES 1024
+
+typedef struct iree_hal_cuda_dispatch_sample_t {
+  // Executable of the sampled dispatch; retained until collected.
+  iree_hal_executable_t* executable;
+  int32_t entry_point;
+  // True once the end event has been recorded (or failed to record).
+  bool is_ended;
+  // False if recording either event failed and the sample must be dropped.
+  bool is_valid;
+  // Recorded before and after the dispatch. Lazily created and reused by later
+  // samples occupying the same slot.
+  CUevent begin_event;
+  CUevent end_event;
+} iree_hal_cuda_dispatch_sample_t;
+
+struct iree_hal_cuda_dispatch_timer_t {
+  // The allocator used to create the timer.
+  iree_allocator_t host_allocator;
+  // The symbols used to record and query events.
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+  // Every Nth dispatch is sampled.
+  iree_host_size_t sample_interval;
+
+  // Guards all state below.
+  iree_slim_mutex_t mutex;
+
+  // Dispatches seen since the last sampled dispatch.
+  iree_host_size_t dispatch_counter IREE_GUARDED_BY(mutex);
+
+  // Ring of samples ordered from oldest to newest starting at |sample_tail|
+  // and containing |sample_count| entries.
+  iree_host_size_t sample_tail IREE_GUARDED_BY(mutex);
+  iree_host_size_t sample_count IREE_GUARDED_BY(mutex);
+  iree_hal_cuda_dispatch_sample_t
+      samples[IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES] IREE_GUARDED_BY(mutex);
+
+  // Aggregated statistics per export in the order first sampled. Each entry
+  // retains its executable.
+  iree_host_size_t entry_count IREE_GUARDED_BY(mutex);
+  iree_host_size_t entry_capacity IREE_GUARDED_BY(mutex);
+  iree_hal_cuda_dispatch_statistics_t* entries IREE_GUARDED_BY(mutex);
+};
+
+iree_status_t iree_hal_cuda_dispatch_timer_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols,
+    iree_host_size_t sample_interval, iree_allocator_t host_allocator,
+    iree_hal_cuda_dispatch_timer_t** out_timer) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(out_timer);
+  *out_timer = NULL;
+  if (sample_interval == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "dispatch sample interval must be non-zero");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_dispatch_timer_t* timer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*timer), (void**)&timer));
+  memset(timer, 0, sizeof(*timer));
+  timer->host_allocator = host_allocator;
+  timer->symbols = symbols;
+  timer->sample_interval = sample_interval;
+  iree_slim_mutex_initialize(&timer->mutex);
+
+  *out_timer = timer;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_cuda_dispatch_timer_clear_entries(
+    iree_hal_cuda_dispatch_timer_t* timer)
+    IREE_REQUIRES_EXCLUSIVE(timer->mutex) {
+  for (iree_host_size_t i = 0; i < timer->entry_count; ++i) {
+    iree_hal_executable_release(timer->entries[i].executable);
+  }
+  timer->entry_count = 0;
+}
+
+void iree_hal_cuda_dispatch_timer_free(iree_hal_cuda_dispatch_timer_t* timer) {
+  if (!timer) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&timer->mutex);
+  for (iree_host_size_t i = 0; i < timer->sample_count; ++i) {
+    iree_hal_cuda_dispatch_sample_t* sample =
+        &timer->samples[(timer->sample_tail + i) %
+                        IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES];
+    iree_hal_executable_release(sample->executable);
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(timer->samples); ++i) {
+    iree_hal_cuda_dispatch_sample_t* sample = &timer->samples[i];
+    if (sample->begin_event) {
+      IREE_CUDA_IGNORE_ERROR(timer->symbols,
+                             cuEventDestroy(sample->begin_event));
+    }
+    if (sample->end_event) {
+      IREE_CUDA_IGNORE_ERROR(timer->symbols, cuEventDestroy(sample->end_event));
+    }
+  }
+  iree_hal_cuda_dispatch_timer_clear_entries(timer);
+  iree_slim_mutex_unlock(&timer->mutex);
+
+  iree_slim_mutex_deinitialize(&timer->mutex);
+  iree_allocator_t host_allocator = timer->host_allocator;
+  iree_allocator_free(host_allocator, timer->entries);
+  iree_allocator_free(host_allocator, timer);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns the histogram bucket for a dispatch taking |duration_ns|.
+static iree_host_size_t iree_hal_cuda_dispatch_histogram_bucket(
+    uint64_t duration_ns) {
+  uint64_t duration_us = duration_ns / 1000;
+  if (duration_us == 0) return 0;
+  iree_host_size_t bucket =
+      1 + (iree_host_size_t)(63 -
+                             iree_math_count_leading_zeros_u64(duration_us));
+  return iree_min(bucket, IREE_HAL_CUDA_DISPATCH_HISTOGRAM_BUCKET_COUNT - 1);
+}
+
+// Folds |duration_ns| into the statistics of the export of |sample|.
+// Takes ownership of the sample's executable reference.
+static iree_status_t iree_hal_cuda_dispatch_timer_accumulate(
+    iree_hal_cuda_dispatch_timer_t* timer,
+    iree_hal_cuda_dispatch_sample_t* sample,
+    uint64_t duration_ns) IREE_REQUIRES_EXCLUSIVE(timer->mutex) {
+  iree_hal_cuda_dispatch_statistics_t* entry = NULL;
+  for (iree_host_size_t i = 0; i < timer->entry_count; ++i) {
+    if (timer->entries[i].executable == sample->executable &&
+        timer->entries[i].entry_point == sample->entry_point) {
+      entry = &timer->entries[i];
+      break;
+    }
+  }
+
+  if (entry) {
+    // The entry already holds a reference.
+    iree_hal_executable_release(sample->executable);
+  } else {
+    if (timer->entry_count == timer->entry_capacity) {
+      iree_host_size_t new_capacity = iree_max(16, timer->entry_capacity * 2);
+      iree_status_t status = iree_allocator_realloc(
+          timer->host_allocator, new_capacity * sizeof(timer->entries[0]),
+          (void**)&timer->entries);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_executable_release(sample->executable);
+        return status;
+      }
+      timer->entry_capacity = new_capacity;
+    }
+    entry = &timer->entries[timer->entry_count++];
+    memset(entry, 0, sizeof(*entry));
+    entry->executable = sample->executable;
+    entry->entry_point = sample->entry_point;
+    entry->min_duration_ns = UINT64_MAX;
+  }
+  sample->executable = NULL;
+
+  ++entry->sample_count;
+  entry->total_duration_ns += duration_ns;
+  entry->min_duration_ns = iree_min(entry->min_duration_ns, duration_ns);
+  entry->max_duration_ns = iree_max(entry->max_duration_ns, duration_ns);
+  ++entry->histogram[iree_hal_cuda_dispatch_histogram_bucket(duration_ns)];
+  return iree_ok_status();
+}
+
+// Collects samples in the order recorded, stopping at the first incomplete one.
+static iree_status_t iree_hal_cuda_dispatch_timer_collect(
+    iree_hal_cuda_dispatch_timer_t* timer)
+    IREE_REQUIRES_EXCLUSIVE(timer->mutex) {
+  iree_status_t status = iree_ok_status();
+  while (timer->sample_count > 0 && iree_status_is_ok(status)) {
+    iree_hal_cuda_dispatch_sample_t* sample =
+        &timer->samples[timer->sample_tail];
+    if (!sample->is_ended) break;
+    // Returns CUDA_ERROR_NOT_READY if recorded but not yet retired.
+    if (sample->is_valid &&
+        timer->symbols->cuEventQuery(sample->end_event) != CUDA_SUCCESS) {
+      break;
+    }
+
+    float elapsed_millis = 0.0f;
+    if (sample->is_valid) {
+      status = IREE_CURESULT_TO_STATUS(
+          timer->symbols,
+          cuEventElapsedTime(&elapsed_millis, sample->begin_event,
+                             sample->end_event),
+          "cuEventElapsedTime");
+    }
+    if (iree_status_is_ok(status) && sample->is_valid) {
+      status = iree_hal_cuda_dispatch_timer_accumulate(
+          timer, sample, (uint64_t)((double)elapsed_millis * 1000000.0));
+    } else {
+      iree_hal_executable_release(sample->executable);
+      sample->executable = NULL;
+    }
+
+    timer->sample_tail =
+        (timer->sample_tail + 1) % IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES;
+    --timer->sample_count;
+  }
+  return status;
+}
+
+static iree_status_t iree_hal_cuda_dispatch_timer_ensure_event(
+    iree_hal_cuda_dispatch_timer_t* timer, CUevent* event) {
+  if (*event) return iree_ok_status();
+  return IREE_CURESULT_TO_STATUS(timer->symbols,
+                                 cuEventCreate(event, CU_EVENT_DEFAULT),
+                                 "cuEventCreate");
+}
+
+iree_status_t iree_hal_cuda_dispatch_timer_begin(
+    iree_hal_cuda_dispatch_timer_t* timer, CUstream stream,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    iree_host_size_t* out_sample) {
+  IREE_ASSERT_ARGUMENT(timer);
+  IREE_ASSERT_ARGUMENT(out_sample);
+  *out_sample = IREE_HAL_CUDA_DISPATCH_TIMER_NO_SAMPLE;
+
+  iree_slim_mutex_lock(&timer->mutex);
+
+  if (++timer->dispatch_counter < timer->sample_interval) {
+    iree_slim_mutex_unlock(&timer->mutex);
+    return iree_ok_status();
+  }
+
+  // Make room by retiring completed samples; if none have completed skip this
+  // dispatch and try again with the next one.
+  iree_status_t status = iree_ok_status();
+  if (timer->sample_count == IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES) {
+    status = iree_hal_cuda_dispatch_timer_collect(timer);
+    if (iree_status_is_ok(status) &&
+        timer->sample_count == IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES) {
+      iree_slim_mutex_unlock(&timer->mutex);
+      return iree_ok_status();
+    }
+  }
+  timer->dispatch_counter = 0;
+
+  iree_host_size_t sample_ordinal =
+      (timer->sample_tail + timer->sample_count) %
+      IREE_HAL_CUDA_DISPATCH_TIMER_MAX_SAMPLES;
+  iree_hal_cuda_dispatch_sample_t* sample = &timer->samples[sample_ordinal];
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_hal_cuda_dispatch_timer_ensure_event(timer, &sample->begin_event);
+  }
+  if (iree_status_is_ok(status)) {
+    status =
+        iree_hal_cuda_dispatch_timer_ensure_event(timer, &sample->end_event);
+  }
+  if (iree_status_is_ok(status)) {
+    status = IREE_CURESULT_TO_STATUS(
+        timer->symbols, cuEventRecord(sample->begin_event, stream),
+        "cuEventRecord");
+  }
+  if (iree_status_is_ok(status)) {
+    sample->executable = executable;
+    iree_hal_executable_retain(executable);
+    sample->entry_point = entry_point;
+    sample->is_ended = false;
+    sample->is_valid = true;
+    ++timer->sample_count;
+    *out_sample = sample_ordinal;
+  }
+
+  iree_slim_mutex_unlock(&timer->mutex);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_dispatch_timer_end(
+    iree_hal_cuda_dispatch_timer_t* timer, CUstream stream,
+    iree_host_size_t sample) {
+  IREE_ASSERT_ARGUMENT(timer);
+  if (sample == IREE_HAL_CUDA_DISPATCH_TIMER_NO_SAMPLE) return iree_ok_status();
+
+  iree_slim_mutex_lock(&timer->mutex);
+  iree_hal_cuda_dispatch_sample_t* sample_slot = &timer->samples[sample];
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      timer->symbols, cuEventRecord(sample_slot->end_event, stream),
+      "cuEventRecord");
+  // A failed record still ends the sample so collection is not blocked behind
+  // it but the sample is dropped instead of timed.
+  sample_slot->is_ended = true;
+  sample_slot->is_valid = iree_status_is_ok(status);
+  iree_slim_mutex_unlock(&timer->mutex);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_dispatch_timer_query(
+    iree_hal_cuda_dispatch_timer_t* timer, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(timer);
+  IREE_ASSERT_ARGUMENT(!capacity || out_statistics);
+  IREE_ASSERT_ARGUMENT(out_count);
+  *out_count = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&timer->mutex);
+  iree_status_t status = iree_hal_cuda_dispatch_timer_collect(timer);
+  if (iree_status_is_ok(status)) {
+    *out_count = timer->entry_count;
+    if (capacity > 0) {
+      memcpy(out_statistics, timer->entries,
+             iree_min(capacity, timer->entry_count) * sizeof(*out_statistics));
+    }
+    if (capacity < timer->entry_count) {
+      status = iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE,
+          "statistics capacity %" PRIhsz " too small for %" PRIhsz " exports",
+          capacity, timer->entry_count);
+    }
+  }
+  iree_slim_mutex_unlock(&timer->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_dispatch_timer_reset(iree_hal_cuda_dispatch_timer_t* timer) {
+  IREE_ASSERT_ARGUMENT(timer);
+  iree_slim_mutex_lock(&timer->mutex);
+  iree_hal_cuda_dispatch_timer_clear_entries(timer);
+  iree_slim_mutex_unlock(&timer->mutex);
+}
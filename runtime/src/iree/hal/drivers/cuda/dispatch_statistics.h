@@ -0,0 +1,81 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_DISPATCH_STATISTICS_H_
+#define IREE_HAL_DRIVERS_CUDA_DISPATCH_STATISTICS_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/cuda/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_dispatch_timer_t
+//===----------------------------------------------------------------------===//
+
+// Sentinel sample ordinal indicating a dispatch was not sampled.
+#define IREE_HAL_CUDA_DISPATCH_TIMER_NO_SAMPLE IREE_HOST_SIZE_MAX
+
+// Samples GPU durations of dispatches and aggregates them per executable
+// export.
+//
+// Every |sample_interval|th dispatch is bracketed by a pair of CUevents
+// recorded on the stream it is issued to. Completed pairs are collected in the
+// order they were recorded and their elapsed times folded into per-export
+// statistics. Unlike the tracing context this is available in all builds and
+// only costs two event records per sampled dispatch.
+//
+// Samples are held in a fixed-size ring; when collection cannot keep up new
+// dispatches go unsampled until older samples complete.
+//
+// Thread-safe; samples may be recorded and collected from any thread.
+typedef struct iree_hal_cuda_dispatch_timer_t iree_hal_cuda_dispatch_timer_t;
+
+// Allocates a timer sampling every |sample_interval|th dispatch.
+iree_status_t iree_hal_cuda_dispatch_timer_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols,
+    iree_host_size_t sample_interval, iree_allocator_t host_allocator,
+    iree_hal_cuda_dispatch_timer_t** out_timer);
+
+// Frees |timer| and releases all executables it references.
+// All work recorded with the timer must have completed.
+void iree_hal_cuda_dispatch_timer_free(iree_hal_cuda_dispatch_timer_t* timer);
+
+// Begins timing a dispatch of |entry_point| in |executable| on |stream| if it
+// is selected for sampling. |out_sample| receives the ordinal to pass to
+// iree_hal_cuda_dispatch_timer_end or
+// IREE_HAL_CUDA_DISPATCH_TIMER_NO_SAMPLE if the dispatch is not sampled.
+iree_status_t iree_hal_cuda_dispatch_timer_begin(
+    iree_hal_cuda_dispatch_timer_t* timer, CUstream stream,
+    iree_hal_executable_t* executable, int32_t entry_point,
+    iree_host_size_t* out_sample);
+
+// Ends timing of the dispatch |sample| on |stream| after it has been issued.
+// No-op if |sample| is IREE_HAL_CUDA_DISPATCH_TIMER_NO_SAMPLE.
+iree_status_t iree_hal_cuda_dispatch_timer_end(
+    iree_hal_cuda_dispatch_timer_t* timer, CUstream stream,
+    iree_host_size_t sample);
+
+// Collects completed samples and returns the aggregated statistics.
+// See iree_hal_cuda_device_query_dispatch_statistics.
+iree_status_t iree_hal_cuda_dispatch_timer_query(
+    iree_hal_cuda_dispatch_timer_t* timer, iree_host_size_t capacity,
+    iree_hal_cuda_dispatch_statistics_t* out_statistics,
+    iree_host_size_t* out_count);
+
+// Discards all aggregated statistics. Samples still in flight are kept.
+void iree_hal_cuda_dispatch_timer_reset(iree_hal_cuda_dispatch_timer_t* timer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_DISPATCH_STATISTICS_H_
@@ -13,6 +13,7 @@
 #include "iree/hal/drivers/cuda/cuda_buffer.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_status_util.h"
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
 #include "iree/hal/drivers/cuda/native_executable.h"
 #include "iree/hal/drivers/cuda/pipeline_layout.h"
 #include "iree/hal/drivers/cuda/tracing.h"
@@ -48,6 +49,15 @@ typedef struct iree_hal_cuda_graph_command_buffer_t {
   CUgraph cu_graph;
   CUgraphExec cu_graph_exec;
 
+  // Optional device cache of idle graph execs. When present the graph exec is
+  // returned to the cache upon destruction and reused by subsequent command
+  // buffers with the same graph signature.
+  iree_hal_cuda_graph_exec_cache_t* exec_cache;
+  // Running hash of the structure of the graph under construction.
+  // Two graphs with the same signature are expected (but not guaranteed) to be
+  // updatable from one to the other with cuGraphExecUpdate.
+  uint64_t graph_signature;
+
   // A node acting as a barrier for all commands added to the command buffer.
   CUgraphNode cu_barrier_node;
 
@@ -79,6 +89,44 @@ iree_hal_cuda_graph_command_buffer_cast(iree_hal_command_buffer_t* base_value) {
   return (iree_hal_cuda_graph_command_buffer_t*)base_value;
 }
 
+// Kinds of structural changes to the graph mixed into its signature.
+typedef enum iree_hal_cuda_graph_signature_kind_e {
+  IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_BARRIER = 1,
+  IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_EVENT_RECORD_NODE,
+  IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_MEMSET_NODE,
+  IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_MEMCPY_NODE,
+  IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_KERNEL_NODE,
+} iree_hal_cuda_graph_signature_kind_t;
+
+// Mixes |value| into the graph signature with FNV-1a.
+static void iree_hal_cuda_graph_command_buffer_mix_signature(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer, uint64_t value) {
+  uint64_t hash = command_buffer->graph_signature;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value >> (i * 8)) & 0xFFu;
+    hash *= 0x100000001B3ull;
+  }
+  command_buffer->graph_signature = hash;
+}
+
+// Mixes a structural change of type |kind| into the graph signature.
+// Only properties that cuGraphExecUpdate cannot change between graphs need to
+// be included in |values|: the topology, node types, and kernel functions and
+// memory types. Pointers, launch dimensions, and kernel arguments may differ.
+static void iree_hal_cuda_graph_command_buffer_append_signature(
+    iree_hal_cuda_graph_command_buffer_t* command_buffer,
+    iree_hal_cuda_graph_signature_kind_t kind, iree_host_size_t value_count,
+    const uint64_t* values) {
+  iree_hal_cuda_graph_command_buffer_mix_signature(
+      command_buffer, ((uint64_t)command_buffer->graph_node_count << 32) |
+                          (command_buffer->cu_barrier_node ? 1u << 31 : 0) |
+                          (uint64_t)kind);
+  for (iree_host_size_t i = 0; i < value_count; ++i) {
+    iree_hal_cuda_graph_command_buffer_mix_signature(command_buffer,
+                                                     values[i]);
+  }
+}
+
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
 
 static void iree_cuda_graph_command_buffer_trace_zone_begin_external(
@@ -92,6 +140,9 @@ static void iree_cuda_graph_command_buffer_trace_zone_begin_external(
         command_buffer);
   }
 
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_EVENT_RECORD_NODE, 0,
+      NULL);
   CUgraphNode* tracing_event_node =
       &command_buffer->cu_graph_nodes[command_buffer->graph_node_count++];
   size_t dependency_count = command_buffer->cu_barrier_node ? 1 : 0;
@@ -116,6 +167,9 @@ static void iree_cuda_graph_command_buffer_trace_zone_end(
         command_buffer);
   }
 
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_EVENT_RECORD_NODE, 0,
+      NULL);
   CUgraphNode* tracing_event_node =
       &command_buffer->cu_graph_nodes[command_buffer->graph_node_count++];
   size_t dependency_count = command_buffer->cu_barrier_node ? 1 : 0;
@@ -161,6 +215,7 @@ iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_cuda_graph_exec_cache_t* exec_cache,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(block_pool);
@@ -190,6 +245,8 @@ iree_status_t iree_hal_cuda_graph_command_buffer_create(
   command_buffer->cu_context = context;
   command_buffer->cu_graph = NULL;
   command_buffer->cu_graph_exec = NULL;
+  command_buffer->exec_cache = exec_cache;
+  command_buffer->graph_signature = 0xCBF29CE484222325ull;  // FNV-1a basis
   command_buffer->cu_barrier_node = NULL;
   command_buffer->graph_node_count = 0;
 
@@ -228,8 +285,16 @@ static void iree_hal_cuda_graph_command_buffer_destroy(
     command_buffer->cu_graph = NULL;
   }
   if (command_buffer->cu_graph_exec != NULL) {
-    IREE_CUDA_IGNORE_ERROR(command_buffer->symbols,
-                           cuGraphExecDestroy(command_buffer->cu_graph_exec));
+    // The command buffer is only destroyed once all launches of it have
+    // completed and the graph exec can be reused by future command buffers.
+    if (command_buffer->exec_cache) {
+      iree_hal_cuda_graph_exec_cache_release(command_buffer->exec_cache,
+                                             command_buffer->graph_signature,
+                                             command_buffer->cu_graph_exec);
+    } else {
+      IREE_CUDA_IGNORE_ERROR(command_buffer->symbols,
+                             cuGraphExecDestroy(command_buffer->cu_graph_exec));
+    }
     command_buffer->cu_graph_exec = NULL;
   }
   command_buffer->cu_barrier_node = NULL;
@@ -332,14 +397,44 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_end(
   command_buffer->cu_barrier_node = NULL;
   command_buffer->graph_node_count = 0;
 
+  // Try to reuse an idle graph exec with the same structure by updating its
+  // node parameters in-place. Updates are much cheaper than instantiation.
+  iree_status_t status = iree_ok_status();
+  CUgraphExec cached_exec = NULL;
+  if (command_buffer->exec_cache &&
+      iree_hal_cuda_graph_exec_cache_acquire(command_buffer->exec_cache,
+                                             command_buffer->graph_signature,
+                                             &cached_exec)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "cuGraphExecUpdate");
+    CUgraphNode error_node = NULL;
+    CUgraphExecUpdateResult update_result = CU_GRAPH_EXEC_UPDATE_SUCCESS;
+    iree_status_t update_status = IREE_CURESULT_TO_STATUS(
+        command_buffer->symbols,
+        cuGraphExecUpdate(cached_exec, command_buffer->cu_graph, &error_node,
+                          &update_result));
+    if (iree_status_is_ok(update_status) &&
+        update_result == CU_GRAPH_EXEC_UPDATE_SUCCESS) {
+      command_buffer->cu_graph_exec = cached_exec;
+    } else {
+      // Signature collision or an unsupported change; fall back to
+      // instantiation below.
+      iree_status_ignore(update_status);
+      IREE_CUDA_IGNORE_ERROR(command_buffer->symbols,
+                             cuGraphExecDestroy(cached_exec));
+    }
+    IREE_TRACE_ZONE_END(z1);
+  }
+
   // Compile the graph.
-  CUgraphNode error_node = NULL;
-  iree_status_t status = IREE_CURESULT_TO_STATUS(
-      command_buffer->symbols,
-      cuGraphInstantiate(&command_buffer->cu_graph_exec,
-                         command_buffer->cu_graph, &error_node,
-                         /*logBuffer=*/NULL,
-                         /*bufferSize=*/0));
+  if (!command_buffer->cu_graph_exec) {
+    CUgraphNode error_node = NULL;
+    status = IREE_CURESULT_TO_STATUS(
+        command_buffer->symbols,
+        cuGraphInstantiate(&command_buffer->cu_graph_exec,
+                           command_buffer->cu_graph, &error_node,
+                           /*logBuffer=*/NULL,
+                           /*bufferSize=*/0));
+  }
   if (iree_status_is_ok(status)) {
     // No longer need the source graph used for construction.
     IREE_CUDA_IGNORE_ERROR(command_buffer->symbols,
@@ -349,7 +444,7 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_end(
 
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_cuda_graph_command_buffer_begin_debug_group(
@@ -383,6 +478,9 @@ iree_hal_cuda_graph_command_buffer_execution_barrier_internal(
   IREE_ASSERT_GT(command_buffer->graph_node_count, 0,
                  "expected at least one node before a barrier");
 
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_BARRIER, 0, NULL);
+
   // Use the last node as a barrier to avoid creating redundant empty nodes.
   if (IREE_LIKELY(command_buffer->graph_node_count == 1)) {
     command_buffer->cu_barrier_node = command_buffer->cu_graph_nodes[0];
@@ -512,6 +610,11 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_fill_buffer(
                             "exceeded max concurrent node limit");
   }
 
+  const uint64_t signature_values[1] = {pattern_length};
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_MEMSET_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+
   size_t dependency_count = command_buffer->cu_barrier_node ? 1 : 0;
   IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
@@ -573,6 +676,12 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_update_buffer(
                             "exceeded max concurrent node limit");
   }
 
+  const uint64_t signature_values[2] = {params.srcMemoryType,
+                                       params.dstMemoryType};
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_MEMCPY_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+
   size_t dependency_count = command_buffer->cu_barrier_node ? 1 : 0;
   IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
@@ -630,6 +739,12 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_copy_buffer(
                             "exceeded max concurrent node limit");
   }
 
+  const uint64_t signature_values[2] = {params.srcMemoryType,
+                                       params.dstMemoryType};
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_MEMCPY_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+
   size_t dependency_count = command_buffer->cu_barrier_node ? 1 : 0;
   IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
@@ -820,6 +935,11 @@ static iree_status_t iree_hal_cuda_graph_command_buffer_dispatch(
                             "exceeded max concurrent node limit");
   }
 
+  const uint64_t signature_values[1] = {(uint64_t)(uintptr_t)params.func};
+  iree_hal_cuda_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_CUDA_GRAPH_SIGNATURE_KIND_KERNEL_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+
   size_t dependency_count = command_buffer->cu_barrier_node ? 1 : 0;
   IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
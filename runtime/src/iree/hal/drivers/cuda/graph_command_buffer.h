@@ -17,10 +17,17 @@ extern "C" {
 #endif  // __cplusplus
 
 typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
+typedef struct iree_hal_cuda_graph_exec_cache_t
+    iree_hal_cuda_graph_exec_cache_t;
 typedef struct iree_hal_cuda_tracing_context_t iree_hal_cuda_tracing_context_t;
 
 // Creates a command buffer that records into a CUDA graph.
 //
+// |exec_cache| is an optional cache of idle graph execs that will be used to
+// update a previously instantiated graph with the same structure instead of
+// instantiating a new one. It must remain live for the lifetime of the command
+// buffers that use it.
+//
 // |block_pool| will be used by the graph command buffer to retain copies of
 // input data until reset. It must remain live for the lifetime of the command
 // buffers that use it.
@@ -31,6 +38,7 @@ iree_status_t iree_hal_cuda_graph_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_cuda_graph_exec_cache_t* exec_cache,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -0,0 +1,146 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/graph_exec_cache.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+typedef struct iree_hal_cuda_graph_exec_cache_entry_t {
+  uint64_t signature;
+  CUgraphExec exec;
+} iree_hal_cuda_graph_exec_cache_entry_t;
+
+struct iree_hal_cuda_graph_exec_cache_t {
+  // The allocator used to create the cache.
+  iree_allocator_t host_allocator;
+  // The symbols used to destroy CUgraphExec objects.
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+
+  // Guards the entry list. The lock is only held while scanning or shifting
+  // the list; graph execs are never destroyed with the lock held.
+  iree_slim_mutex_t mutex;
+
+  // Maximum number of idle graph execs retained by the cache.
+  iree_host_size_t capacity;
+  // Total number of idle graph execs currently in the cache.
+  iree_host_size_t count IREE_GUARDED_BY(mutex);
+  // Idle graph execs ordered from least to most recently released.
+  iree_hal_cuda_graph_exec_cache_entry_t entries[] IREE_GUARDED_BY(mutex);
+};
+
+iree_status_t iree_hal_cuda_graph_exec_cache_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, iree_host_size_t capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_cuda_graph_exec_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_graph_exec_cache_t* cache = NULL;
+  iree_host_size_t total_size =
+      sizeof(*cache) + capacity * sizeof(*cache->entries);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&cache));
+  cache->host_allocator = host_allocator;
+  cache->symbols = symbols;
+  iree_slim_mutex_initialize(&cache->mutex);
+  cache->capacity = capacity;
+  cache->count = 0;
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_cuda_graph_exec_cache_free(
+    iree_hal_cuda_graph_exec_cache_t* cache) {
+  if (!cache) return;
+  iree_allocator_t host_allocator = cache->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_graph_exec_cache_trim(cache);
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  iree_allocator_free(host_allocator, cache);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_cuda_graph_exec_cache_acquire(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t signature,
+    CUgraphExec* out_exec) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_exec);
+  *out_exec = NULL;
+
+  // Scan from the most recently released entry as graphs recorded in a loop
+  // are most likely to match the one released by the prior iteration.
+  iree_slim_mutex_lock(&cache->mutex);
+  for (iree_host_size_t i = cache->count; i > 0; --i) {
+    if (cache->entries[i - 1].signature != signature) continue;
+    *out_exec = cache->entries[i - 1].exec;
+    memmove(&cache->entries[i - 1], &cache->entries[i],
+            (cache->count - i) * sizeof(*cache->entries));
+    --cache->count;
+    break;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  return *out_exec != NULL;
+}
+
+void iree_hal_cuda_graph_exec_cache_release(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t signature,
+    CUgraphExec exec) {
+  IREE_ASSERT_ARGUMENT(cache);
+  if (!exec) return;
+
+  // Append to the end of the list and evict the least recently released entry
+  // if we are over capacity.
+  CUgraphExec evicted_exec = exec;
+  iree_slim_mutex_lock(&cache->mutex);
+  if (cache->capacity > 0) {
+    if (cache->count == cache->capacity) {
+      evicted_exec = cache->entries[0].exec;
+      memmove(&cache->entries[0], &cache->entries[1],
+              (cache->count - 1) * sizeof(*cache->entries));
+      --cache->count;
+    } else {
+      evicted_exec = NULL;
+    }
+    cache->entries[cache->count].signature = signature;
+    cache->entries[cache->count].exec = exec;
+    ++cache->count;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  if (evicted_exec) {
+    IREE_CUDA_IGNORE_ERROR(cache->symbols, cuGraphExecDestroy(evicted_exec));
+  }
+}
+
+void iree_hal_cuda_graph_exec_cache_trim(
+    iree_hal_cuda_graph_exec_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Pop entries one at a time so that the lock is not held while destroying.
+  while (true) {
+    CUgraphExec exec = NULL;
+    iree_slim_mutex_lock(&cache->mutex);
+    if (cache->count > 0) exec = cache->entries[--cache->count].exec;
+    iree_slim_mutex_unlock(&cache->mutex);
+    if (!exec) break;
+    IREE_CUDA_IGNORE_ERROR(cache->symbols, cuGraphExecDestroy(exec));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
@@ -0,0 +1,74 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
+#define IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_graph_exec_cache_t
+//===----------------------------------------------------------------------===//
+
+// A cache of idle instantiated CUDA graphs keyed by the structural signature
+// of the graph they were instantiated from.
+//
+// Graph instantiation is expensive and programs with dynamic shapes commonly
+// record command buffers that are topologically identical and differ only in
+// kernel arguments, launch dimensions, or buffer pointers. When such a command
+// buffer is released its CUgraphExec is returned to the cache and a later
+// command buffer with the same signature can update it in-place with
+// cuGraphExecUpdate instead of instantiating a new one.
+//
+// Signatures are only a hint: cuGraphExecUpdate verifies the topology and
+// callers must fall back to instantiation if the update is rejected.
+//
+// Thread-safe; command buffers may acquire and release from any thread.
+typedef struct iree_hal_cuda_graph_exec_cache_t
+    iree_hal_cuda_graph_exec_cache_t;
+
+// Allocates a new cache holding up to |capacity| idle graph execs.
+// The least recently released graph exec is destroyed when over capacity.
+iree_status_t iree_hal_cuda_graph_exec_cache_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, iree_host_size_t capacity,
+    iree_allocator_t host_allocator,
+    iree_hal_cuda_graph_exec_cache_t** out_cache);
+
+// Destroys all idle graph execs in |cache| and frees it.
+void iree_hal_cuda_graph_exec_cache_free(
+    iree_hal_cuda_graph_exec_cache_t* cache);
+
+// Removes an idle graph exec with the given |signature| from |cache|.
+// Returns true and transfers ownership of the graph exec to the caller in
+// |out_exec| if one was found.
+bool iree_hal_cuda_graph_exec_cache_acquire(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t signature,
+    CUgraphExec* out_exec);
+
+// Returns ownership of the idle graph |exec| with the given |signature| to
+// |cache|. The graph exec must not be in use by any pending launch.
+void iree_hal_cuda_graph_exec_cache_release(
+    iree_hal_cuda_graph_exec_cache_t* cache, uint64_t signature,
+    CUgraphExec exec);
+
+// Destroys all idle graph execs in |cache|.
+void iree_hal_cuda_graph_exec_cache_trim(
+    iree_hal_cuda_graph_exec_cache_t* cache);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_GRAPH_EXEC_CACHE_H_
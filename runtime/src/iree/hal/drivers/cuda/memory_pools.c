@@ -18,6 +18,8 @@ static const char* IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID =
     "CUDA pool: device-local reserved";
 static const char* IREE_HAL_CUDA_OTHER_POOL_RESERVED_ID =
     "CUDA pool: other reserved";
+static const char* IREE_HAL_CUDA_TRANSIENT_HEAP_RESERVED_ID =
+    "CUDA pool: transient heap reserved";
 #endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
 
 static iree_status_t iree_hal_cuda_create_memory_pool(
@@ -84,6 +86,13 @@ iree_status_t iree_hal_cuda_memory_pools_initialize(
         cuda_symbols, cu_device, pooling_params->other, &out_pools->other);
   }
 
+  if (iree_status_is_ok(status) && pooling_params->transient_capacity > 0) {
+    status = iree_hal_cuda_transient_heap_allocate(
+        cuda_symbols, out_pools->device_local,
+        (iree_device_size_t)pooling_params->transient_capacity, host_allocator,
+        &out_pools->transient_heap);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
@@ -92,6 +101,11 @@ void iree_hal_cuda_memory_pools_deinitialize(
     iree_hal_cuda_memory_pools_t* pools) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // The heap block is allocated from the device-local pool and must be
+  // released before the pool is destroyed.
+  iree_hal_cuda_transient_heap_free(pools->transient_heap);
+  pools->transient_heap = NULL;
+
   if (pools->device_local) {
     IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols,
                            cuMemPoolDestroy(pools->device_local));
@@ -106,6 +120,23 @@ void iree_hal_cuda_memory_pools_deinitialize(
   IREE_TRACE_ZONE_END(z0);
 }
 
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+// Returns the tracing ID of the pool |buffer| was allocated from.
+static const char* iree_hal_cuda_memory_pool_trace_id(
+    iree_hal_cuda_memory_pools_t* pools, iree_hal_buffer_t* buffer) {
+  CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(buffer);
+  if (pools->transient_heap &&
+      iree_hal_cuda_transient_heap_contains(pools->transient_heap,
+                                            device_ptr)) {
+    return IREE_HAL_CUDA_TRANSIENT_HEAP_RESERVED_ID;
+  }
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)
+             ? IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID
+             : IREE_HAL_CUDA_OTHER_POOL_RESERVED_ID;
+}
+#endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+
 static void iree_hal_cuda_memory_pool_track_alloc(
     iree_hal_cuda_memory_pools_t* pools, iree_hal_buffer_t* buffer) {
   bool is_device_local = iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
@@ -114,8 +145,7 @@ static void iree_hal_cuda_memory_pool_track_alloc(
   iree_device_size_t allocation_size = iree_hal_buffer_allocation_size(buffer);
   (void)allocation_size;
   IREE_TRACE_ALLOC_NAMED(
-      is_device_local ? IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID
-                      : IREE_HAL_CUDA_OTHER_POOL_RESERVED_ID,
+      iree_hal_cuda_memory_pool_trace_id(pools, buffer),
       (void*)iree_hal_cuda_buffer_device_pointer(buffer), allocation_size);
   IREE_STATISTICS({
     iree_atomic_int64_t* bytes_allocated =
@@ -131,9 +161,7 @@ static void iree_hal_cuda_memory_pool_track_free(
   bool is_device_local = iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
                                            IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL);
   (void)is_device_local;
-  IREE_TRACE_FREE_NAMED(is_device_local
-                            ? IREE_HAL_CUDA_DEVICE_LOCAL_POOL_RESERVED_ID
-                            : IREE_HAL_CUDA_OTHER_POOL_RESERVED_ID,
+  IREE_TRACE_FREE_NAMED(iree_hal_cuda_memory_pool_trace_id(pools, buffer),
                         (void*)iree_hal_cuda_buffer_device_pointer(buffer));
   IREE_STATISTICS({
     iree_atomic_int64_t* bytes_freed =
@@ -158,6 +186,9 @@ void iree_hal_cuda_memory_pools_merge_statistics(
         &pools->statistics.device_bytes_freed, iree_memory_order_relaxed);
     statistics->host_bytes_freed = iree_atomic_load_int64(
         &pools->statistics.host_bytes_freed, iree_memory_order_relaxed);
+    // NOTE: suballocations from the transient heap are counted as device bytes
+    // allocated/freed above and the heap block itself is included in the
+    // device-local pool peak below.
     if (pools->device_local) {
       cuuint64_t pool_peak = 0;
       IREE_CUDA_IGNORE_ERROR(
@@ -180,6 +211,10 @@ void iree_hal_cuda_memory_pools_merge_statistics(
 iree_status_t iree_hal_cuda_memory_pools_trim(
     iree_hal_cuda_memory_pools_t* pools,
     const iree_hal_cuda_memory_pooling_params_t* pooling_params) {
+  // Release the transient heap block if idle so the pool trim can return it.
+  if (pools->transient_heap) {
+    iree_hal_cuda_transient_heap_trim(pools->transient_heap);
+  }
   IREE_CUDA_RETURN_IF_ERROR(
       pools->cuda_symbols,
       cuMemPoolTrimTo(pools->device_local,
@@ -208,6 +243,23 @@ static void iree_hal_cuda_async_buffer_release_callback(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// NOTE: this is only issued if a transient heap buffer is destroyed without
+// having been scheduled for deallocation asynchronously. The buffer is no
+// longer referenced by any pending work so its range can be reused right away.
+static void iree_hal_cuda_transient_buffer_release_callback(
+    void* user_data, iree_hal_buffer_t* buffer) {
+  iree_hal_cuda_memory_pools_t* pools =
+      (iree_hal_cuda_memory_pools_t*)user_data;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_memory_pool_track_free(pools, buffer);
+  CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(buffer);
+  IREE_IGNORE_ERROR(iree_hal_cuda_transient_heap_retire(
+      pools->transient_heap, /*stream=*/NULL, device_ptr));
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 iree_status_t iree_hal_cuda_memory_pools_alloca(
     iree_hal_cuda_memory_pools_t* pools, CUstream stream,
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
@@ -223,17 +275,33 @@ iree_status_t iree_hal_cuda_memory_pools_alloca(
   // external) but could use more buffer properties (including usage/export
   // flags) to better isolate the different usage patterns and keep the pools
   // operating with reasonable limits. We should be using the |pool| arg.
+  bool is_device_local =
+      iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL);
   CUmemoryPool memory_pool =
-      iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)
-          ? pools->device_local
-          : pools->other;
+      is_device_local ? pools->device_local : pools->other;
 
+  // Try to suballocate from the transient heap first and only fall back to the
+  // pool if the heap is disabled or has no space available.
   CUdeviceptr device_ptr = 0;
-  iree_status_t status = IREE_CURESULT_TO_STATUS(
-      pools->cuda_symbols,
-      cuMemAllocFromPoolAsync(&device_ptr, (size_t)allocation_size, memory_pool,
-                              stream),
-      "cuMemAllocFromPoolAsync");
+  iree_status_t status = iree_ok_status();
+  iree_hal_buffer_release_callback_t release_callback = {
+      .fn = iree_hal_cuda_async_buffer_release_callback,
+      .user_data = pools,
+  };
+  if (is_device_local && pools->transient_heap) {
+    status = iree_hal_cuda_transient_heap_reserve(
+        pools->transient_heap, stream, allocation_size, &device_ptr);
+    if (device_ptr) {
+      release_callback.fn = iree_hal_cuda_transient_buffer_release_callback;
+    }
+  }
+  if (iree_status_is_ok(status) && !device_ptr) {
+    status = IREE_CURESULT_TO_STATUS(
+        pools->cuda_symbols,
+        cuMemAllocFromPoolAsync(&device_ptr, (size_t)allocation_size,
+                                memory_pool, stream),
+        "cuMemAllocFromPoolAsync");
+  }
 
   // Wrap the allocated CUDA buffer in a HAL buffer.
   // NOTE: we don't provide a device allocator because we didn't allocate from
@@ -241,10 +309,6 @@ iree_status_t iree_hal_cuda_memory_pools_alloca(
   // doesn't dealloca the buffer.
   iree_hal_buffer_t* buffer = NULL;
   if (iree_status_is_ok(status)) {
-    iree_hal_buffer_release_callback_t release_callback = {
-        .fn = iree_hal_cuda_async_buffer_release_callback,
-        .user_data = pools,
-    };
     status = iree_hal_cuda_buffer_wrap(
         /*device_allocator=*/NULL, params.type, params.access, params.usage,
         allocation_size, /*byte_offset=*/0,
@@ -253,13 +317,22 @@ iree_status_t iree_hal_cuda_memory_pools_alloca(
         &buffer);
   }
 
+  // Pool allocations have no host pointer and are mapped through the ring.
+  if (iree_status_is_ok(status) && pools->staging_ring) {
+    iree_hal_cuda_buffer_set_staging_ring(buffer, pools->staging_ring);
+  }
+
   if (iree_status_is_ok(status)) {
     // Update statistics (note that it may not yet be accurate).
     iree_hal_cuda_memory_pool_track_alloc(pools, buffer);
     *out_buffer = buffer;
   } else if (buffer) {
     iree_hal_buffer_release(buffer);
-  } else {
+  } else if (release_callback.fn ==
+             iree_hal_cuda_transient_buffer_release_callback) {
+    IREE_IGNORE_ERROR(iree_hal_cuda_transient_heap_retire(
+        pools->transient_heap, /*stream=*/NULL, device_ptr));
+  } else if (device_ptr) {
     IREE_CUDA_IGNORE_ERROR(pools->cuda_symbols,
                            cuMemFreeAsync(device_ptr, stream));
   }
@@ -281,11 +354,18 @@ iree_status_t iree_hal_cuda_memory_pools_dealloca(
   // it asynchronously.
   iree_status_t status = iree_ok_status();
   if (iree_hal_cuda_buffer_type(buffer) == IREE_HAL_CUDA_BUFFER_TYPE_ASYNC) {
-    // Try to schedule the buffer for freeing.
+    // Try to schedule the buffer for freeing. Transient heap ranges are
+    // retired in stream order and reclaimed by a later reservation.
     CUdeviceptr device_ptr = iree_hal_cuda_buffer_device_pointer(buffer);
-    status = IREE_CURESULT_TO_STATUS(pools->cuda_symbols,
-                                     cuMemFreeAsync(device_ptr, stream),
-                                     "cuMemFreeAsync");
+    if (pools->transient_heap && iree_hal_cuda_transient_heap_contains(
+                                     pools->transient_heap, device_ptr)) {
+      status = iree_hal_cuda_transient_heap_retire(pools->transient_heap,
+                                                   stream, device_ptr);
+    } else {
+      status = IREE_CURESULT_TO_STATUS(pools->cuda_symbols,
+                                       cuMemFreeAsync(device_ptr, stream),
+                                       "cuMemFreeAsync");
+    }
     if (iree_status_is_ok(status)) {
       // Drop the release callback so that we don't try to double-free the
       // buffer. Note that we only do this if the CUDA free succeeded as
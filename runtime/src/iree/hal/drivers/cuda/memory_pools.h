@@ -13,6 +13,8 @@
 #include "iree/hal/drivers/cuda/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/staging_ring.h"
+#include "iree/hal/drivers/cuda/transient_heap.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -24,6 +26,11 @@ typedef struct iree_hal_cuda_memory_pools_t {
   CUmemoryPool device_local;
   // Used for any host-visible/host-local memory types.
   CUmemoryPool other;
+  // Optional suballocator over a block from |device_local| used for
+  // DEVICE_LOCAL allocations before falling back to the pool.
+  iree_hal_cuda_transient_heap_t* transient_heap;
+  // Optional ring used to map allocations from the host. Not owned.
+  iree_hal_cuda_staging_ring_t* staging_ring;
 
   const iree_hal_cuda_dynamic_symbols_t* cuda_symbols;
   iree_allocator_t host_allocator;
@@ -99,6 +99,16 @@ static iree_status_t iree_hal_cuda_native_executable_flatbuffer_verify(
         entry_point_count, block_size_count);
   }
 
+  flatbuffers_int32_vec_t shared_memory_carveouts =
+      iree_hal_cuda_ExecutableDef_shared_memory_carveout_get(executable_def);
+  if (shared_memory_carveouts &&
+      flatbuffers_int32_vec_len(shared_memory_carveouts) != entry_point_count) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "entry points (%zu) and shared memory carveouts (%zu) count mismatch",
+        entry_point_count, flatbuffers_int32_vec_len(shared_memory_carveouts));
+  }
+
   flatbuffers_string_t ptx_image =
       iree_hal_cuda_ExecutableDef_ptx_image_get(executable_def);
   if (flatbuffers_string_len(ptx_image) == 0) {
@@ -109,8 +119,84 @@ static iree_status_t iree_hal_cuda_native_executable_flatbuffer_verify(
   return iree_ok_status();
 }
 
+// Loads a cubin translated from |ptx_image| into |out_module|.
+// The translation result is reused from |disk_cache| when available and
+// otherwise stored there after the PTX is JIT compiled.
+static iree_status_t iree_hal_cuda_native_executable_load_cached_module(
+    const iree_hal_cuda_dynamic_symbols_t* symbols,
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* disk_cache_key,
+    flatbuffers_string_t ptx_image, iree_allocator_t host_allocator,
+    CUmodule* out_module) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Try loading the cubin from the cache. The driver may still reject it (such
+  // as when it was produced by a driver with a different JIT) in which case we
+  // fall back to translating it again.
+  iree_byte_span_t cubin = iree_make_byte_span(NULL, 0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_disk_cache_lookup(disk_cache, disk_cache_key,
+                                                host_allocator, &cubin));
+  if (cubin.data) {
+    iree_status_t status = IREE_CURESULT_TO_STATUS(
+        symbols, cuModuleLoadDataEx(out_module, cubin.data, 0, NULL, NULL),
+        "cuModuleLoadDataEx");
+    iree_allocator_free(host_allocator, cubin.data);
+    if (iree_status_is_ok(status)) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+
+  // Translate the PTX to a cubin we can retrieve for storing.
+  CUlinkState link_state = NULL;
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      symbols, cuLinkCreate(0, NULL, NULL, &link_state), "cuLinkCreate");
+  if (iree_status_is_ok(status)) {
+    status = IREE_CURESULT_TO_STATUS(
+        symbols,
+        cuLinkAddData(link_state, CU_JIT_INPUT_PTX, (void*)ptx_image,
+                      flatbuffers_string_len(ptx_image) + 1, "ptx_image", 0,
+                      NULL, NULL),
+        "cuLinkAddData");
+  }
+  void* cubin_data = NULL;
+  size_t cubin_size = 0;
+  if (iree_status_is_ok(status)) {
+    status = IREE_CURESULT_TO_STATUS(
+        symbols, cuLinkComplete(link_state, &cubin_data, &cubin_size),
+        "cuLinkComplete");
+  }
+  if (iree_status_is_ok(status)) {
+    status = IREE_CURESULT_TO_STATUS(
+        symbols, cuModuleLoadDataEx(out_module, cubin_data, 0, NULL, NULL),
+        "cuModuleLoadDataEx");
+  }
+
+  // Storing is best-effort: failing to persist the cubin only means it will
+  // be translated again next time.
+  if (iree_status_is_ok(status)) {
+    iree_status_ignore(iree_hal_executable_disk_cache_store(
+        disk_cache, disk_cache_key,
+        iree_make_const_byte_span(cubin_data, cubin_size)));
+  }
+
+  // The cubin is owned by the link state and released with it.
+  if (link_state) {
+    IREE_CUDA_IGNORE_ERROR(symbols, cuLinkDestroy(link_state));
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 iree_status_t iree_hal_cuda_native_executable_create(
     const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* disk_cache_key,
     const iree_hal_executable_params_t* executable_params,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_params);
@@ -132,6 +218,8 @@ iree_status_t iree_hal_cuda_native_executable_create(
       iree_hal_cuda_ExecutableDef_ptx_image_get(executable_def);
   flatbuffers_uint32_vec_t shared_memory_sizes =
       iree_hal_cuda_ExecutableDef_shared_memory_size_get(executable_def);
+  flatbuffers_int32_vec_t shared_memory_carveouts =
+      iree_hal_cuda_ExecutableDef_shared_memory_carveout_get(executable_def);
   flatbuffers_string_vec_t entry_points_vec =
       iree_hal_cuda_ExecutableDef_entry_points_get(executable_def);
   iree_hal_cuda_BlockSizeDef_vec_t block_sizes_vec =
@@ -171,9 +259,16 @@ iree_status_t iree_hal_cuda_native_executable_create(
   // contents. We could check this prior to creating
   CUmodule module = NULL;
 
-  iree_status_t status = IREE_CURESULT_TO_STATUS(
-      symbols, cuModuleLoadDataEx(&module, ptx_image, 0, NULL, NULL),
-      "cuModuleLoadDataEx");
+  iree_status_t status = iree_ok_status();
+  if (disk_cache) {
+    status = iree_hal_cuda_native_executable_load_cached_module(
+        symbols, disk_cache, disk_cache_key, ptx_image, host_allocator,
+        &module);
+  } else {
+    status = IREE_CURESULT_TO_STATUS(
+        symbols, cuModuleLoadDataEx(&module, ptx_image, 0, NULL, NULL),
+        "cuModuleLoadDataEx");
+  }
 
   // Query max optin shared memory per block - we'll use it to compare with
   // kernel usages.
@@ -224,6 +319,17 @@ iree_status_t iree_hal_cuda_native_executable_create(
       }
       if (!iree_status_is_ok(status)) break;
 
+      // The carveout is only a hint; a negative value leaves it to the driver.
+      if (shared_memory_carveouts && shared_memory_carveouts[i] >= 0) {
+        status = IREE_CURESULT_TO_STATUS(
+            symbols,
+            cuFuncSetAttribute(
+                function, CU_FUNC_ATTRIBUTE_PREFERRED_SHARED_MEMORY_CARVEOUT,
+                shared_memory_carveouts[i]),
+            "cuFuncSetAttribute");
+        if (!iree_status_is_ok(status)) break;
+      }
+
       // Package required parameters for kernel launches for each entry point.
       iree_hal_cuda_kernel_info_t* info = &executable->entry_points[i];
       info->layout = executable_params->pipeline_layouts[i];
@@ -14,6 +14,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/utils/executable_disk_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -32,8 +33,13 @@ typedef struct iree_hal_cuda_kernel_info_t {
 
 // Creates an IREE executable from a CUDA PTX module. The module may contain
 // several kernels that can be extracted along with the associated block size.
+//
+// If |disk_cache| is provided the cubin translated from the PTX is looked up
+// by |disk_cache_key| and stored there on a miss.
 iree_status_t iree_hal_cuda_native_executable_create(
     const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* disk_cache_key,
     const iree_hal_executable_params_t* executable_params,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable);
 
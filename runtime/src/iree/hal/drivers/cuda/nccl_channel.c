@@ -539,6 +539,90 @@ static iree_status_t iree_hal_cuda_nccl_submit_batch_entry(
   return iree_ok_status();
 }
 
+// Returns the device pointer of the start of |binding|.
+static CUdeviceptr iree_hal_cuda_nccl_binding_device_pointer(
+    const iree_hal_buffer_binding_t* binding) {
+  return iree_hal_cuda_buffer_device_pointer(
+             iree_hal_buffer_allocated_buffer(binding->buffer)) +
+         iree_hal_buffer_byte_offset(binding->buffer) + binding->offset;
+}
+
+// Returns the number of all-reduces starting at |entries| that can be fused
+// into a single all-reduce. Entries can be fused when they perform the same
+// reduction on the same channel and both their send and receive ranges
+// immediately follow those of the prior entry.
+static iree_host_size_t iree_hal_cuda_nccl_count_fusable_all_reduces(
+    const iree_hal_collective_batch_entry_t* entries,
+    iree_host_size_t entry_count) {
+  const iree_hal_collective_batch_entry_t* first_entry = &entries[0];
+  const iree_device_size_t element_size =
+      iree_hal_collective_element_byte_count(first_entry->op.element_type);
+  CUdeviceptr send_end =
+      iree_hal_cuda_nccl_binding_device_pointer(&first_entry->send_binding) +
+      first_entry->element_count * element_size;
+  CUdeviceptr recv_end =
+      iree_hal_cuda_nccl_binding_device_pointer(&first_entry->recv_binding) +
+      first_entry->element_count * element_size;
+  iree_host_size_t count = 1;
+  for (; count < entry_count; ++count) {
+    const iree_hal_collective_batch_entry_t* entry = &entries[count];
+    if (entry->channel != first_entry->channel ||
+        entry->op.packed != first_entry->op.packed) {
+      break;
+    }
+    if (iree_hal_cuda_nccl_binding_device_pointer(&entry->send_binding) !=
+            send_end ||
+        iree_hal_cuda_nccl_binding_device_pointer(&entry->recv_binding) !=
+            recv_end) {
+      break;
+    }
+    send_end += entry->element_count * element_size;
+    recv_end += entry->element_count * element_size;
+  }
+  return count;
+}
+
+// Submits |entry_count| all-reduces starting at |entries| as one all-reduce.
+// Entries must have been verified as fusable with
+// iree_hal_cuda_nccl_count_fusable_all_reduces.
+static iree_status_t iree_hal_cuda_nccl_submit_fused_all_reduce(
+    const iree_hal_collective_batch_entry_t* entries,
+    iree_host_size_t entry_count, CUstream stream) {
+  const iree_hal_collective_batch_entry_t* first_entry = &entries[0];
+  iree_hal_cuda_nccl_channel_t* channel =
+      iree_hal_cuda_nccl_channel_cast(first_entry->channel);
+  const iree_hal_cuda_nccl_dynamic_symbols_t* symbols = channel->nccl_symbols;
+  ncclComm_t comm = iree_hal_cuda_nccl_channel_comm(first_entry->channel);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)entry_count);
+
+  ncclDataType_t datatype;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_get_nccl_data_type(first_entry->op.element_type,
+                                           &datatype));
+  ncclRedOp_t redop;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_get_nccl_reduction_type(first_entry->op.reduction,
+                                                &redop));
+
+  iree_device_size_t element_count = 0;
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    element_count += entries[i].element_count;
+  }
+  CUdeviceptr sendbuff =
+      iree_hal_cuda_nccl_binding_device_pointer(&first_entry->send_binding);
+  CUdeviceptr recvbuff =
+      iree_hal_cuda_nccl_binding_device_pointer(&first_entry->recv_binding);
+  IREE_NCCL_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, symbols,
+      ncclAllReduce((const void*)sendbuff, (void*)recvbuff, element_count,
+                    datatype, redop, comm, stream),
+      "ncclAllReduce");
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_cuda_nccl_submit_batch(
     const iree_hal_cuda_nccl_dynamic_symbols_t* symbols,
     iree_hal_cuda_tracing_context_t* tracing_context,
@@ -566,10 +650,25 @@ iree_status_t iree_hal_cuda_nccl_submit_batch(
 
   // Issue all collective operations in the batch as part of a group.
   // NCCL may be able to fuse or reduce overheads by issuing like this.
+  // Runs of all-reduces over contiguous ranges are fused into a single larger
+  // all-reduce as NCCL launches one kernel per operation even when grouped and
+  // small reductions are dominated by latency.
   IREE_NCCL_RETURN_IF_ERROR(symbols, ncclGroupStart(), "ncclGroupStart");
-  for (iree_host_size_t i = 0; i < batch->count; ++i) {
-    IREE_RETURN_IF_ERROR(
-        iree_hal_cuda_nccl_submit_batch_entry(&batch->entries[i], stream));
+  for (iree_host_size_t i = 0; i < batch->count;) {
+    const iree_hal_collective_batch_entry_t* entry = &batch->entries[i];
+    iree_host_size_t fused_count = 1;
+    if (entry->op.kind == IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE) {
+      fused_count = iree_hal_cuda_nccl_count_fusable_all_reduces(
+          &batch->entries[i], batch->count - i);
+    }
+    if (fused_count > 1) {
+      IREE_RETURN_IF_ERROR(iree_hal_cuda_nccl_submit_fused_all_reduce(
+          &batch->entries[i], fused_count, stream));
+    } else {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_cuda_nccl_submit_batch_entry(entry, stream));
+    }
+    i += fused_count;
   }
   IREE_NCCL_RETURN_IF_ERROR(symbols, ncclGroupEnd(), "ncclGroupEnd");
 
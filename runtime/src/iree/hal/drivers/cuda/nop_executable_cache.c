@@ -8,9 +8,11 @@
 
 #include <stdbool.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/tracing.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
 #include "iree/hal/drivers/cuda/native_executable.h"
 
 typedef struct iree_hal_cuda_nop_executable_cache_t {
@@ -23,6 +25,11 @@ typedef struct iree_hal_cuda_nop_executable_cache_t {
   const iree_hal_cuda_dynamic_symbols_t* symbols;
 
   CUdevice device;
+
+  // Optional persistent cache for translated cubins.
+  iree_hal_executable_disk_cache_t* disk_cache;
+  // Key identifying the device and driver that all entry keys start with.
+  iree_hal_executable_disk_cache_key_t disk_cache_key;
 } iree_hal_cuda_nop_executable_cache_t;
 
 static const iree_hal_executable_cache_vtable_t
@@ -35,15 +42,53 @@ iree_hal_cuda_nop_executable_cache_cast(
   return (iree_hal_cuda_nop_executable_cache_t*)base_value;
 }
 
+// Initializes |out_key| with the identity of |device| and the driver version.
+// Cubins are specific to both the device architecture and the driver that
+// translated them.
+static iree_status_t iree_hal_cuda_nop_executable_cache_initialize_key(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    iree_hal_executable_disk_cache_key_t* out_key) {
+  int32_t identity[3] = {0, 0, 0};
+  IREE_CUDA_RETURN_IF_ERROR(symbols, cuDriverGetVersion(&identity[0]),
+                            "cuDriverGetVersion");
+  IREE_CUDA_RETURN_IF_ERROR(
+      symbols,
+      cuDeviceGetAttribute(&identity[1],
+                           CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MAJOR,
+                           device),
+      "cuDeviceGetAttribute");
+  IREE_CUDA_RETURN_IF_ERROR(
+      symbols,
+      cuDeviceGetAttribute(&identity[2],
+                           CU_DEVICE_ATTRIBUTE_COMPUTE_CAPABILITY_MINOR,
+                           device),
+      "cuDeviceGetAttribute");
+  iree_hal_executable_disk_cache_key_initialize(out_key);
+  iree_hal_executable_disk_cache_key_append_string(out_key, IREE_SV("cuda"));
+  iree_hal_executable_disk_cache_key_append(
+      out_key, iree_make_const_byte_span(identity, sizeof(identity)));
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_cuda_nop_executable_cache_create(
     iree_string_view_t identifier,
     const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    iree_hal_executable_disk_cache_t* disk_cache,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(out_executable_cache);
   IREE_TRACE_ZONE_BEGIN(z0);
 
   *out_executable_cache = NULL;
+
+  iree_hal_executable_disk_cache_key_t disk_cache_key;
+  memset(&disk_cache_key, 0, sizeof(disk_cache_key));
+  if (disk_cache) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_cuda_nop_executable_cache_initialize_key(symbols, device,
+                                                              &disk_cache_key));
+  }
+
   iree_hal_cuda_nop_executable_cache_t* executable_cache = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_allocator_malloc(host_allocator, sizeof(*executable_cache),
@@ -54,6 +99,9 @@ iree_status_t iree_hal_cuda_nop_executable_cache_create(
   executable_cache->host_allocator = host_allocator;
   executable_cache->symbols = symbols;
   executable_cache->device = device;
+  executable_cache->disk_cache = disk_cache;
+  iree_hal_executable_disk_cache_retain(disk_cache);
+  executable_cache->disk_cache_key = disk_cache_key;
 
   *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
 
@@ -68,6 +116,7 @@ static void iree_hal_cuda_nop_executable_cache_destroy(
   iree_allocator_t host_allocator = executable_cache->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_executable_disk_cache_release(executable_cache->disk_cache);
   iree_allocator_free(host_allocator, executable_cache);
 
   IREE_TRACE_ZONE_END(z0);
@@ -87,9 +136,26 @@ static iree_status_t iree_hal_cuda_nop_executable_cache_prepare_executable(
     iree_hal_executable_t** out_executable) {
   iree_hal_cuda_nop_executable_cache_t* executable_cache =
       iree_hal_cuda_nop_executable_cache_cast(base_executable_cache);
+
+  // Only executables that allow persistent caching are stored to disk.
+  iree_hal_executable_disk_cache_t* disk_cache = NULL;
+  iree_hal_executable_disk_cache_key_t disk_cache_key =
+      executable_cache->disk_cache_key;
+  if (executable_cache->disk_cache &&
+      iree_all_bits_set(
+          executable_params->caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING)) {
+    disk_cache = executable_cache->disk_cache;
+    iree_hal_executable_disk_cache_key_append_string(
+        &disk_cache_key, executable_params->executable_format);
+    iree_hal_executable_disk_cache_key_append(
+        &disk_cache_key, executable_params->executable_data);
+  }
+
   return iree_hal_cuda_native_executable_create(
-      executable_cache->symbols, executable_cache->device, executable_params,
-      executable_cache->host_allocator, out_executable);
+      executable_cache->symbols, executable_cache->device, disk_cache,
+      &disk_cache_key, executable_params, executable_cache->host_allocator,
+      out_executable);
 }
 
 static const iree_hal_executable_cache_vtable_t
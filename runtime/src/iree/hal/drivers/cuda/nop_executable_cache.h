@@ -11,17 +11,20 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/utils/executable_disk_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a no-op executable cache that does not cache at all.
+// Creates an executable cache that does not cache in memory.
 // This is useful to isolate pipeline caching behavior and verify compilation
-// behavior.
+// behavior. If an optional |disk_cache| is provided then cubins translated from
+// PTX are persisted there when executables allow persistent caching.
 iree_status_t iree_hal_cuda_nop_executable_cache_create(
     iree_string_view_t identifier,
     const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    iree_hal_executable_disk_cache_t* disk_cache,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
@@ -0,0 +1,114 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/peer_access.h"
+
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+bool iree_hal_cuda_device_can_access_peer(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    CUdevice peer) {
+  if (device == peer) return false;
+  int can_access_peer = 0;
+  CUresult result =
+      symbols->cuDeviceCanAccessPeer(&can_access_peer, device, peer);
+  return result == CUDA_SUCCESS && can_access_peer != 0;
+}
+
+iree_status_t iree_hal_cuda_device_enable_peer_access(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    CUdevice peer) {
+  if (!iree_hal_cuda_device_can_access_peer(symbols, device, peer)) {
+    return iree_ok_status();
+  }
+
+  // Peer access is granted between contexts and not devices. We only use
+  // primary contexts and don't want to be the ones creating the primary context
+  // of the peer as doing so allocates resources on a device that may never be
+  // used by the program.
+  unsigned int peer_flags = 0;
+  int peer_active = 0;
+  IREE_RETURN_IF_ERROR(IREE_CURESULT_TO_STATUS(
+      symbols, cuDevicePrimaryCtxGetState(peer, &peer_flags, &peer_active),
+      "cuDevicePrimaryCtxGetState"));
+  if (!peer_active) return iree_ok_status();
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)device);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)peer);
+
+  CUcontext context = NULL;
+  CUcontext peer_context = NULL;
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      symbols, cuDevicePrimaryCtxRetain(&context, device));
+  if (iree_status_is_ok(status)) {
+    status = IREE_CURESULT_TO_STATUS(
+        symbols, cuDevicePrimaryCtxRetain(&peer_context, peer));
+  }
+  if (iree_status_is_ok(status)) {
+    status = IREE_CURESULT_TO_STATUS(symbols, cuCtxPushCurrent(context));
+  }
+  if (iree_status_is_ok(status)) {
+    CUresult result = symbols->cuCtxEnablePeerAccess(peer_context, 0);
+    if (result != CUDA_SUCCESS &&
+        result != CUDA_ERROR_PEER_ACCESS_ALREADY_ENABLED) {
+      status = iree_hal_cuda_result_to_status(symbols, result, __FILE__,
+                                              __LINE__);
+    }
+    IREE_CUDA_IGNORE_ERROR(symbols, cuCtxPopCurrent(NULL));
+  }
+  if (peer_context) symbols->cuDevicePrimaryCtxRelease(peer);
+  if (context) symbols->cuDevicePrimaryCtxRelease(device);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_device_enable_all_peer_access(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    CUmemoryPool memory_pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int device_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, IREE_CURESULT_TO_STATUS(symbols, cuDeviceGetCount(&device_count),
+                                  "cuDeviceGetCount"));
+
+  for (int i = 0; i < device_count; ++i) {
+    CUdevice peer = 0;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, IREE_CURESULT_TO_STATUS(symbols, cuDeviceGet(&peer, i),
+                                    "cuDeviceGet"));
+    if (peer == device) continue;
+
+    // Peer access is an optimization: copies between devices still work
+    // without it by staging through the host. Failures here (such as exceeding
+    // the hardware limit on the number of peers) are not fatal.
+    iree_status_ignore(
+        iree_hal_cuda_device_enable_peer_access(symbols, device, peer));
+    iree_status_ignore(
+        iree_hal_cuda_device_enable_peer_access(symbols, peer, device));
+
+    // Memory pools are not covered by context peer access and must have
+    // access granted per device.
+    if (memory_pool &&
+        iree_hal_cuda_device_can_access_peer(symbols, peer, device)) {
+      CUmemAccessDesc access_desc = {
+          .location =
+              {
+                  .type = CU_MEM_LOCATION_TYPE_DEVICE,
+                  .id = peer,
+              },
+          .flags = CU_MEM_ACCESS_FLAGS_PROT_READWRITE,
+      };
+      IREE_CUDA_IGNORE_ERROR(symbols,
+                             cuMemPoolSetAccess(memory_pool, &access_desc, 1));
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
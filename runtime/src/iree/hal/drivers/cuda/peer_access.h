@@ -0,0 +1,58 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_PEER_ACCESS_H_
+#define IREE_HAL_DRIVERS_CUDA_PEER_ACCESS_H_
+
+#include <stdbool.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// Peer-to-peer access between CUDA devices
+//===----------------------------------------------------------------------===//
+
+// Returns true if memory on |peer| can be accessed directly by |device|.
+// Returns false if the devices are the same or the topology does not allow
+// peer-to-peer access (such as devices on different PCIe root complexes
+// without NVLink).
+bool iree_hal_cuda_device_can_access_peer(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    CUdevice peer);
+
+// Enables the primary context of |device| to access memory allocated in the
+// primary context of |peer|. This is a no-op if access is already enabled or
+// if the primary context of |peer| has not been created yet.
+//
+// Once enabled copies between the devices are performed directly over the
+// device interconnect and kernels on |device| may dereference pointers to
+// memory on |peer|.
+iree_status_t iree_hal_cuda_device_enable_peer_access(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    CUdevice peer);
+
+// Enables peer-to-peer access in both directions between |device| and every
+// other device in the system whose primary context is active and that the
+// topology allows. If provided |memory_pool| is made accessible to all peers
+// that can access |device|.
+//
+// Devices created later will enable access back to |device| when they are
+// created such that the order devices are created in does not matter.
+iree_status_t iree_hal_cuda_device_enable_all_peer_access(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUdevice device,
+    CUmemoryPool memory_pool);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_PEER_ACCESS_H_
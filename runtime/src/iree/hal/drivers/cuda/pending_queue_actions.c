@@ -81,6 +81,8 @@ typedef struct iree_hal_cuda_queue_action_t {
   // The device from which to allocate CUDA stream-based command buffers for
   // applying deferred command buffers.
   iree_hal_device_t* device;
+  // The queue the action was submitted to.
+  iree_hal_queue_affinity_t queue_affinity;
 
   // The stream to launch main GPU workload.
   CUstream dispatch_cu_stream;
@@ -95,6 +97,13 @@ typedef struct iree_hal_cuda_queue_action_t {
   // Semaphore list to signal after the payload completes on the GPU.
   iree_hal_semaphore_list_t signal_semaphore_list;
 
+  // Device signal events for each semaphore in |signal_semaphore_list|.
+  // Acquired when the action becomes ready, before it is handed to the worker,
+  // such that dependent actions can wait on them on the device immediately.
+  // Stored in trailing storage of the action allocation.
+  CUevent* signal_events;
+  iree_host_size_t signal_event_count;
+
   // Scratch fields for analyzing whether actions are ready to issue.
   iree_hal_cuda_event_t* events[IREE_HAL_CUDA_MAX_WAIT_EVENT_COUNT];
   iree_host_size_t event_count;
@@ -433,8 +442,9 @@ static void iree_hal_cuda_free_semaphore_list(
 }
 
 iree_status_t iree_hal_cuda_pending_queue_actions_enqueue_execution(
-    iree_hal_device_t* device, CUstream dispatch_stream,
-    CUstream callback_stream, iree_hal_cuda_pending_queue_actions_t* actions,
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    CUstream dispatch_stream, CUstream callback_stream,
+    iree_hal_cuda_pending_queue_actions_t* actions,
     iree_hal_cuda_pending_action_cleanup_callback_t cleanup_callback,
     void* callback_user_data,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -446,8 +456,11 @@ iree_status_t iree_hal_cuda_pending_queue_actions_enqueue_execution(
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_hal_cuda_queue_action_t* action = NULL;
+  iree_host_size_t total_size =
+      sizeof(*action) +
+      signal_semaphore_list.count * sizeof(*action->signal_events);
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_allocator_malloc(actions->host_allocator, sizeof(*action),
+      z0, iree_allocator_malloc(actions->host_allocator, total_size,
                                 (void**)&action));
 
   action->owning_actions = actions;
@@ -456,8 +469,11 @@ iree_status_t iree_hal_cuda_pending_queue_actions_enqueue_execution(
   action->callback_user_data = callback_user_data;
   action->kind = IREE_HAL_CUDA_QUEUE_ACTION_TYPE_EXECUTION;
   action->device = device;
+  action->queue_affinity = queue_affinity;
   action->dispatch_cu_stream = dispatch_stream;
   action->callback_cu_stream = callback_stream;
+  action->signal_events = (CUevent*)((uint8_t*)action + sizeof(*action));
+  action->signal_event_count = 0;
 
   // Initialize scratch fields.
   action->event_count = 0;
@@ -631,6 +647,7 @@ static iree_status_t iree_hal_cuda_pending_queue_actions_issue_execution(
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_cuda_device_create_stream_command_buffer(
                   action->device, mode, IREE_HAL_COMMAND_CATEGORY_ANY,
+                  action->queue_affinity,
                   /*binding_capacity=*/0, &stream_command_buffer));
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_resource_set_insert(action->resource_set, 1,
@@ -643,14 +660,13 @@ static iree_status_t iree_hal_cuda_pending_queue_actions_issue_execution(
   }
   IREE_TRACE_ZONE_END(dispatch_command_buffers);
 
-  // Last record CUevent signals in the dispatch stream.
-  for (iree_host_size_t i = 0; i < action->signal_semaphore_list.count; ++i) {
-    // Grab a CUevent for this semaphore value signaling.
-    CUevent event = NULL;
-    IREE_RETURN_AND_END_ZONE_IF_ERROR(
-        z0, iree_hal_cuda_event_semaphore_acquire_timepoint_device_signal(
-                action->signal_semaphore_list.semaphores[i],
-                action->signal_semaphore_list.payload_values[i], &event));
+  // Last record CUevent signals in the dispatch stream. The events were
+  // acquired when the action became ready and other actions may already be
+  // waiting on them.
+  IREE_ASSERT_EQ(action->signal_event_count,
+                 action->signal_semaphore_list.count);
+  for (iree_host_size_t i = 0; i < action->signal_event_count; ++i) {
+    CUevent event = action->signal_events[i];
 
     // Record the event signaling in the dispatch stream.
     IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
@@ -681,6 +697,29 @@ static iree_status_t iree_hal_cuda_pending_queue_actions_issue_execution(
   return iree_ok_status();
 }
 
+// Acquires device signal timepoints for all semaphores signaled by |action|.
+//
+// This runs when the action is determined ready so that any action scanned
+// after it (or submitted later) waiting on the same timepoints can resolve
+// them to device events and be issued without waiting for the host callback
+// of this action. Waiting on an event before it is recorded is a no-op in CUDA
+// so this relies on the worker issuing ready actions in the order they were
+// determined ready: this action records its events before any dependent waits.
+static iree_status_t iree_hal_cuda_queue_action_acquire_signal_events(
+    iree_hal_cuda_queue_action_t* action) {
+  // Resume from where a prior partial acquisition may have failed.
+  for (iree_host_size_t i = action->signal_event_count;
+       i < action->signal_semaphore_list.count; ++i) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_cuda_event_semaphore_acquire_timepoint_device_signal(
+            action->signal_semaphore_list.semaphores[i],
+            action->signal_semaphore_list.payload_values[i],
+            &action->signal_events[i]));
+    ++action->signal_event_count;
+  }
+  return iree_ok_status();
+}
+
 static void iree_hal_cuda_queue_action_clear_events(
     iree_hal_cuda_queue_action_t* action) {
   for (iree_host_size_t i = 0; i < action->event_count; ++i) {
@@ -803,6 +842,12 @@ iree_status_t iree_hal_cuda_pending_queue_actions_issue(
       }
     }
 
+    // Publish the signals of ready actions before scanning the next action.
+    if (iree_status_is_ok(status) && !action->is_pending &&
+        action->state == IREE_HAL_cuda_QUEUE_ACTION_STATE_ALIVE) {
+      status = iree_hal_cuda_queue_action_acquire_signal_events(action);
+    }
+
     if (IREE_UNLIKELY(!iree_status_is_ok(status))) break;
 
     if (action->is_pending) {
@@ -825,10 +870,9 @@ iree_status_t iree_hal_cuda_pending_queue_actions_issue(
   // Preserve pending timepoints.
   actions->action_list = pending_list;
 
-  iree_slim_mutex_unlock(&actions->action_mutex);
-
   if (ready_list.head == NULL) {
     // Nothing ready yet. Just return.
+    iree_slim_mutex_unlock(&actions->action_mutex);
     IREE_TRACE_ZONE_END(z0);
     return status;
   }
@@ -841,6 +885,7 @@ iree_status_t iree_hal_cuda_pending_queue_actions_issue(
   }
 
   if (IREE_UNLIKELY(!iree_status_is_ok(status))) {
+    iree_slim_mutex_unlock(&actions->action_mutex);
     // Release all actions in the ready list to avoid leaking.
     iree_hal_cuda_queue_action_list_free_actions(actions->host_allocator,
                                                  &ready_list);
@@ -850,11 +895,15 @@ iree_status_t iree_hal_cuda_pending_queue_actions_issue(
   }
 
   // Now push the ready list to the worker and have it to issue the actions to
-  // the GPU.
+  // the GPU. This must happen with the lock held so that ready lists are pushed
+  // in the same order they were scanned: actions may wait on device events of
+  // actions in prior ready lists and the worker must record those first.
   entry->ready_list_head = ready_list.head;
   iree_hal_cuda_ready_action_slist_push(&actions->working_area.ready_worklist,
                                         entry);
 
+  iree_slim_mutex_unlock(&actions->action_mutex);
+
   // We can only overwrite the worker state if the previous state is idle
   // waiting; we cannot overwrite exit related states. so we need to perform
   // atomic compare and exchange here.
@@ -906,11 +955,19 @@ static iree_status_t iree_hal_cuda_worker_process_ready_list(
     iree_hal_cuda_ready_action_slist_t* worklist) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Ready lists must be processed in the order they were pushed as actions may
+  // wait on device events recorded by actions in earlier lists. Entries are
+  // flushed in FIFO order and the worklist is re-checked until it is empty.
   iree_status_t status = iree_ok_status();
-  do {
-    iree_hal_cuda_atomic_slist_entry_t* entry =
-        iree_hal_cuda_ready_action_slist_pop(worklist);
-    if (!entry) break;
+  iree_hal_cuda_atomic_slist_entry_t* entry = NULL;
+  while (iree_status_is_ok(status)) {
+    if (!entry && !iree_hal_cuda_ready_action_slist_flush(
+                      worklist, IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_FIFO,
+                      &entry, /*out_tail=*/NULL)) {
+      break;
+    }
+    iree_hal_cuda_atomic_slist_entry_t* next_entry =
+        iree_hal_cuda_ready_action_slist_get_next(entry);
 
     // Process the current batch of ready actions.
     iree_hal_cuda_queue_action_t* action = entry->ready_list_head;
@@ -933,7 +990,16 @@ static iree_status_t iree_hal_cuda_worker_process_ready_list(
     }
 
     iree_allocator_free(host_allocator, entry);
-  } while (iree_status_is_ok(status));
+    entry = next_entry;
+  }
+
+  // Release any remaining ready lists if we bailed on an error.
+  while (entry) {
+    iree_hal_cuda_atomic_slist_entry_t* next_entry =
+        iree_hal_cuda_ready_action_slist_get_next(entry);
+    iree_allocator_free(host_allocator, entry);
+    entry = next_entry;
+  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
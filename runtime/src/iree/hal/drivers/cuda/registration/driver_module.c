@@ -17,6 +17,15 @@ IREE_FLAG(
     bool, cuda_use_streams, true,
     "Use CUDA streams (instead of graphs) for executing command buffers.");
 
+IREE_FLAG(int32_t, cuda_graph_exec_cache_capacity, 16,
+          "Maximum number of idle instantiated CUDA graphs retained for reuse\n"
+          "by structurally identical command buffers. 0 disables reuse.");
+
+IREE_FLAG(int32_t, cuda_queue_count, 1,
+          "Number of queues exposed by each CUDA device. Each queue is backed\n"
+          "by its own CUDA stream such that work submitted with different\n"
+          "queue affinities may execute concurrently.");
+
 IREE_FLAG(bool, cuda_allow_inline_execution, false,
           "Allow command buffers to execute inline against CUDA streams when\n"
           "possible.");
@@ -25,12 +34,39 @@ IREE_FLAG(
     bool, cuda_async_allocations, true,
     "Enables CUDA asynchronous stream-ordered allocations when supported.");
 
+IREE_FLAG(bool, cuda_collective_streams, true,
+          "Issues collective operations on a dedicated stream per queue such\n"
+          "that they overlap with dispatches in the same barrier scope.");
+
+IREE_FLAG(bool, cuda_peer_access, true,
+          "Enables peer-to-peer access between CUDA devices when the topology\n"
+          "allows it.");
+
+IREE_FLAG(int32_t, cuda_transient_heap_mb, 0,
+          "Size in MiB of a device-local block suballocated in stream order\n"
+          "for asynchronous allocations. Allocations that do not fit are made\n"
+          "from the CUDA memory pool directly. 0 disables suballocation.");
+
 IREE_FLAG(
     bool, cuda_tracing, true,
     "Enables tracing of stream events when Tracy instrumentation is enabled.\n"
     "Severely impacts benchmark timings and should only be used when\n"
     "analyzing dispatch timings.");
 
+IREE_FLAG(int32_t, cuda_dispatch_sample_interval, 0,
+          "Samples the GPU duration of every Nth dispatch issued through CUDA\n"
+          "stream command buffers for per-export statistics queries.\n"
+          "0 disables sampling.");
+
+IREE_FLAG(int32_t, cuda_staging_ring_mb, 16,
+          "Size in MiB of the page-locked ring used to stage host mappings of\n"
+          "device-local CUDA buffers. 0 disables mapping such buffers.");
+
+IREE_FLAG(
+    string, cuda_executable_cache, "",
+    "Directory used to persist cubins translated from PTX across runs.\n"
+    "The directory must exist and be writable only by trusted users.");
+
 IREE_FLAG(int32_t, cuda_default_index, 0,
           "Specifies the index of the default CUDA device to use");
 
@@ -102,8 +138,20 @@ static iree_status_t iree_hal_cuda_driver_factory_try_create(
     device_params.command_buffer_mode =
         IREE_HAL_CUDA_COMMAND_BUFFER_MODE_STREAM;
   }
+  device_params.queue_count =
+      (iree_host_size_t)iree_max(1, FLAG_cuda_queue_count);
+  device_params.graph_exec_cache_capacity =
+      (iree_host_size_t)iree_max(0, FLAG_cuda_graph_exec_cache_capacity);
   device_params.stream_tracing = FLAG_cuda_tracing;
   device_params.async_allocations = FLAG_cuda_async_allocations;
+  device_params.collective_streams = FLAG_cuda_collective_streams;
+  device_params.peer_access = FLAG_cuda_peer_access;
+  device_params.memory_pools.transient_capacity =
+      (uint64_t)iree_max(0, FLAG_cuda_transient_heap_mb) * 1024 * 1024;
+  device_params.dispatch_sample_interval =
+      (iree_host_size_t)iree_max(0, FLAG_cuda_dispatch_sample_interval);
+  device_params.staging_ring_capacity =
+      (iree_host_size_t)iree_max(0, FLAG_cuda_staging_ring_mb) * 1024 * 1024;
 
   driver_options.default_device_index = FLAG_cuda_default_index;
   if (FLAG_cuda_default_index_from_mpi) {
@@ -112,8 +160,21 @@ static iree_status_t iree_hal_cuda_driver_factory_try_create(
             driver_options.default_device_index);
   }
 
-  iree_status_t status = iree_hal_cuda_driver_create(
-      driver_name, &driver_options, &device_params, host_allocator, out_driver);
+  iree_status_t status = iree_ok_status();
+  if (strlen(FLAG_cuda_executable_cache) > 0) {
+    status = iree_hal_executable_disk_cache_create(
+        iree_make_cstring_view(FLAG_cuda_executable_cache), host_allocator,
+        &device_params.executable_disk_cache);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_driver_create(driver_name, &driver_options,
+                                         &device_params, host_allocator,
+                                         out_driver);
+  }
+
+  // Retained by the driver.
+  iree_hal_executable_disk_cache_release(device_params.executable_disk_cache);
 
   IREE_TRACE_ZONE_END(z0);
 
@@ -0,0 +1,346 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/staging_ring.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+// Alignment of all reserved ranges. Keeps staged contents suitably aligned for
+// any element type the host may read them as.
+#define IREE_HAL_CUDA_STAGING_RING_ALIGNMENT 64
+
+// Maximum number of ranges that may be reserved or pending reclamation at any
+// time.
+#define IREE_HAL_CUDA_STAGING_RING_MAX_RANGES 64
+
+struct iree_hal_cuda_staging_range_t {
+  // Byte offset of the range from the block base.
+  iree_host_size_t offset;
+  // Total aligned length of the range in bytes.
+  iree_host_size_t length;
+  // True once the range has been released by its user.
+  bool is_released;
+  // True if a copy into the range was issued and |event| must complete before
+  // the range can be read or reused.
+  bool is_pending;
+  // Recorded on the copy stream after the copy into the range. Lazily created
+  // and reused by later ranges occupying the same slot.
+  CUevent event;
+};
+
+struct iree_hal_cuda_staging_ring_t {
+  // The allocator used to create the ring.
+  iree_allocator_t host_allocator;
+  // The symbols used to manage the block, stream, and events.
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+  // Total size of the block in bytes.
+  iree_host_size_t capacity;
+  // Stream all copies are issued on.
+  CUstream copy_stream;
+
+  // Guards the ring state below.
+  iree_slim_mutex_t mutex;
+
+  // Base pointer of the block or NULL if not yet allocated (or trimmed).
+  uint8_t* base IREE_GUARDED_BY(mutex);
+  // Byte offset the next range will be reserved at.
+  iree_host_size_t head IREE_GUARDED_BY(mutex);
+  // Ring of ranges ordered from oldest to newest reservation starting at
+  // |range_tail| and containing |range_count| entries.
+  iree_host_size_t range_tail IREE_GUARDED_BY(mutex);
+  iree_host_size_t range_count IREE_GUARDED_BY(mutex);
+  iree_hal_cuda_staging_range_t
+      ranges[IREE_HAL_CUDA_STAGING_RING_MAX_RANGES] IREE_GUARDED_BY(mutex);
+};
+
+iree_status_t iree_hal_cuda_staging_ring_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, iree_host_size_t capacity,
+    iree_allocator_t host_allocator, iree_hal_cuda_staging_ring_t** out_ring) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(out_ring);
+  *out_ring = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_staging_ring_t* ring = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*ring), (void**)&ring));
+  memset(ring, 0, sizeof(*ring));
+  ring->host_allocator = host_allocator;
+  ring->symbols = symbols;
+  ring->capacity =
+      iree_host_align(capacity, IREE_HAL_CUDA_STAGING_RING_ALIGNMENT);
+  iree_slim_mutex_initialize(&ring->mutex);
+
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      symbols, cuStreamCreate(&ring->copy_stream, CU_STREAM_NON_BLOCKING),
+      "cuStreamCreate");
+
+  if (iree_status_is_ok(status)) {
+    *out_ring = ring;
+  } else {
+    iree_hal_cuda_staging_ring_free(ring);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Releases the block if no ranges are reserved. Requires the ring lock.
+static void iree_hal_cuda_staging_ring_release_block(
+    iree_hal_cuda_staging_ring_t* ring) {
+  if (!ring->base || ring->range_count > 0) return;
+  IREE_CUDA_IGNORE_ERROR(ring->symbols, cuMemFreeHost(ring->base));
+  ring->base = NULL;
+  ring->head = 0;
+}
+
+void iree_hal_cuda_staging_ring_free(iree_hal_cuda_staging_ring_t* ring) {
+  if (!ring) return;
+  iree_allocator_t host_allocator = ring->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&ring->mutex);
+  IREE_ASSERT_EQ(ring->range_count, 0, "staging ranges still reserved");
+  if (ring->copy_stream) {
+    // Released ranges may still have copies in flight.
+    IREE_CUDA_IGNORE_ERROR(ring->symbols,
+                           cuStreamSynchronize(ring->copy_stream));
+  }
+  ring->range_count = 0;
+  iree_hal_cuda_staging_ring_release_block(ring);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(ring->ranges); ++i) {
+    if (ring->ranges[i].event) {
+      IREE_CUDA_IGNORE_ERROR(ring->symbols,
+                             cuEventDestroy(ring->ranges[i].event));
+    }
+  }
+  if (ring->copy_stream) {
+    IREE_CUDA_IGNORE_ERROR(ring->symbols, cuStreamDestroy(ring->copy_stream));
+  }
+  iree_slim_mutex_unlock(&ring->mutex);
+
+  iree_slim_mutex_deinitialize(&ring->mutex);
+  iree_allocator_free(host_allocator, ring);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Reclaims released ranges from the tail of the ring in reservation order once
+// any copies into them have completed. Requires the ring lock.
+static iree_status_t iree_hal_cuda_staging_ring_reclaim(
+    iree_hal_cuda_staging_ring_t* ring) {
+  iree_status_t status = iree_ok_status();
+  while (ring->range_count > 0) {
+    iree_hal_cuda_staging_range_t* range = &ring->ranges[ring->range_tail];
+    if (!range->is_released) break;
+    if (range->is_pending) {
+      CUresult result = ring->symbols->cuEventQuery(range->event);
+      if (result == CUDA_ERROR_NOT_READY) break;
+      status = iree_hal_cuda_result_to_status(ring->symbols, result, __FILE__,
+                                              __LINE__);
+      if (!iree_status_is_ok(status)) break;
+      range->is_pending = false;
+    }
+    ring->range_tail =
+        (ring->range_tail + 1) % IREE_HAL_CUDA_STAGING_RING_MAX_RANGES;
+    --ring->range_count;
+  }
+  // Once empty reset to the start of the block to reduce fragmentation.
+  if (ring->range_count == 0) ring->head = 0;
+  return status;
+}
+
+// Returns the offset at which |length| bytes can be reserved or
+// IREE_HOST_SIZE_MAX if the ring does not have enough contiguous free space.
+// Requires the ring lock.
+static iree_host_size_t iree_hal_cuda_staging_ring_find_offset(
+    iree_hal_cuda_staging_ring_t* ring, iree_host_size_t length) {
+  if (ring->range_count == 0) {
+    return length <= ring->capacity ? 0 : IREE_HOST_SIZE_MAX;
+  }
+  if (ring->range_count == IREE_HAL_CUDA_STAGING_RING_MAX_RANGES) {
+    return IREE_HOST_SIZE_MAX;
+  }
+  iree_host_size_t tail = ring->ranges[ring->range_tail].offset;
+  if (ring->head > tail) {
+    // Free space is [head, capacity) followed by [0, tail).
+    if (length <= ring->capacity - ring->head) return ring->head;
+    if (length <= tail) return 0;
+  } else {
+    // Wrapped: free space is [head, tail).
+    if (length <= tail - ring->head) return ring->head;
+  }
+  return IREE_HOST_SIZE_MAX;
+}
+
+iree_status_t iree_hal_cuda_staging_ring_reserve(
+    iree_hal_cuda_staging_ring_t* ring, CUdeviceptr source,
+    iree_host_size_t length, iree_hal_cuda_staging_range_t** out_range) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(out_range);
+  *out_range = NULL;
+  iree_host_size_t aligned_length = iree_host_align(
+      iree_max(length, 1), IREE_HAL_CUDA_STAGING_RING_ALIGNMENT);
+  if (aligned_length > ring->capacity) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "staging range of %" PRIhsz
+                            " bytes exceeds the staging ring capacity of "
+                            "%" PRIhsz " bytes",
+                            length, ring->capacity);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+
+  iree_slim_mutex_lock(&ring->mutex);
+
+  // Allocate the block on first use. Cached memory is used as the host reads
+  // the staged contents back.
+  iree_status_t status = iree_ok_status();
+  if (!ring->base) {
+    status = IREE_CURESULT_TO_STATUS(
+        ring->symbols,
+        cuMemHostAlloc((void**)&ring->base, ring->capacity, /*flags=*/0),
+        "cuMemHostAlloc");
+    if (!iree_status_is_ok(status)) ring->base = NULL;
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_staging_ring_reclaim(ring);
+  }
+
+  iree_hal_cuda_staging_range_t* range = NULL;
+  if (iree_status_is_ok(status)) {
+    iree_host_size_t offset =
+        iree_hal_cuda_staging_ring_find_offset(ring, aligned_length);
+    if (offset != IREE_HOST_SIZE_MAX) {
+      iree_host_size_t index = (ring->range_tail + ring->range_count) %
+                               IREE_HAL_CUDA_STAGING_RING_MAX_RANGES;
+      range = &ring->ranges[index];
+      range->offset = offset;
+      range->length = aligned_length;
+      range->is_released = false;
+      range->is_pending = false;
+      ++ring->range_count;
+      ring->head = offset + aligned_length;
+    } else {
+      status = iree_make_status(
+          IREE_STATUS_RESOURCE_EXHAUSTED,
+          "staging ring exhausted; too many buffers are mapped or staged");
+    }
+  }
+
+  // Issue the copy into the range and fence it.
+  if (iree_status_is_ok(status) && source) {
+    if (!range->event) {
+      status = IREE_CURESULT_TO_STATUS(
+          ring->symbols, cuEventCreate(&range->event, CU_EVENT_DISABLE_TIMING),
+          "cuEventCreate");
+    }
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          ring->symbols,
+          cuMemcpyDtoHAsync(ring->base + range->offset, source, length,
+                            ring->copy_stream),
+          "cuMemcpyDtoHAsync");
+    }
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          ring->symbols, cuEventRecord(range->event, ring->copy_stream),
+          "cuEventRecord");
+    }
+    // Even on failure the copy may have been issued so the range cannot be
+    // reclaimed until everything on the stream has completed.
+    if (!iree_status_is_ok(status)) {
+      IREE_CUDA_IGNORE_ERROR(ring->symbols,
+                             cuStreamSynchronize(ring->copy_stream));
+    } else {
+      range->is_pending = true;
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_range = range;
+  } else if (range) {
+    range->is_released = true;
+    iree_status_ignore(iree_hal_cuda_staging_ring_reclaim(ring));
+  }
+
+  iree_slim_mutex_unlock(&ring->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_staging_ring_wait(
+    iree_hal_cuda_staging_ring_t* ring, iree_hal_cuda_staging_range_t* range,
+    uint8_t** out_host_ptr) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_ASSERT_ARGUMENT(range);
+  IREE_ASSERT_ARGUMENT(out_host_ptr);
+  *out_host_ptr = NULL;
+
+  // The range is owned by the caller and its event is only recorded on
+  // reservation so we can wait without holding the lock.
+  if (range->is_pending) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, IREE_CURESULT_TO_STATUS(ring->symbols,
+                                    cuEventSynchronize(range->event),
+                                    "cuEventSynchronize"));
+    IREE_TRACE_ZONE_END(z0);
+  }
+
+  iree_slim_mutex_lock(&ring->mutex);
+  range->is_pending = false;
+  *out_host_ptr = ring->base + range->offset;
+  iree_slim_mutex_unlock(&ring->mutex);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_cuda_staging_ring_upload(
+    iree_hal_cuda_staging_ring_t* ring, const void* host_ptr,
+    iree_host_size_t length, CUdeviceptr target) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, IREE_CURESULT_TO_STATUS(
+              ring->symbols,
+              cuMemcpyHtoDAsync(target, host_ptr, length, ring->copy_stream),
+              "cuMemcpyHtoDAsync"));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, IREE_CURESULT_TO_STATUS(ring->symbols,
+                                  cuStreamSynchronize(ring->copy_stream),
+                                  "cuStreamSynchronize"));
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_cuda_staging_ring_release(iree_hal_cuda_staging_ring_t* ring,
+                                        iree_hal_cuda_staging_range_t* range) {
+  IREE_ASSERT_ARGUMENT(ring);
+  if (!range) return;
+  iree_slim_mutex_lock(&ring->mutex);
+  range->is_released = true;
+  iree_status_ignore(iree_hal_cuda_staging_ring_reclaim(ring));
+  iree_slim_mutex_unlock(&ring->mutex);
+}
+
+void iree_hal_cuda_staging_ring_trim(iree_hal_cuda_staging_ring_t* ring) {
+  IREE_ASSERT_ARGUMENT(ring);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&ring->mutex);
+  iree_status_ignore(iree_hal_cuda_staging_ring_reclaim(ring));
+  iree_hal_cuda_staging_ring_release_block(ring);
+  iree_slim_mutex_unlock(&ring->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+}
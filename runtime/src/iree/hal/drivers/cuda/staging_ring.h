@@ -0,0 +1,81 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_STAGING_RING_H_
+#define IREE_HAL_DRIVERS_CUDA_STAGING_RING_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_staging_ring_t
+//===----------------------------------------------------------------------===//
+
+// A ring of page-locked host memory used to map device-local buffers that have
+// no host pointer of their own.
+//
+// Ranges are reserved from a single block of cached page-locked memory
+// allocated on first use and copies into and out of them are issued on a
+// dedicated copy stream. Because the copy stream is not ordered behind any
+// queue a download only waits for its own copy and not for unrelated work
+// issued to the device after the data was produced. Each download records a
+// CUevent that acts as the fence for the staged contents.
+//
+// Ranges are reclaimed from the tail of the ring in the order they were
+// reserved once released. Reservations that do not fit fail with
+// IREE_STATUS_RESOURCE_EXHAUSTED.
+//
+// Thread-safe; ranges may be reserved and released from any thread.
+typedef struct iree_hal_cuda_staging_ring_t iree_hal_cuda_staging_ring_t;
+
+// A range reserved from an iree_hal_cuda_staging_ring_t.
+typedef struct iree_hal_cuda_staging_range_t iree_hal_cuda_staging_range_t;
+
+// Allocates a ring staging through a |capacity| byte block of page-locked
+// memory. The block itself is not allocated until the first reservation.
+// Must be called with the CUDA context the ring will be used with current.
+iree_status_t iree_hal_cuda_staging_ring_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, iree_host_size_t capacity,
+    iree_allocator_t host_allocator, iree_hal_cuda_staging_ring_t** out_ring);
+
+// Frees |ring| and its block. All reserved ranges must have been released.
+void iree_hal_cuda_staging_ring_free(iree_hal_cuda_staging_ring_t* ring);
+
+// Reserves |length| bytes and, if |source| is not 0, begins asynchronously
+// copying |length| bytes from |source| into them.
+// The contents are available once iree_hal_cuda_staging_ring_wait returns.
+iree_status_t iree_hal_cuda_staging_ring_reserve(
+    iree_hal_cuda_staging_ring_t* ring, CUdeviceptr source,
+    iree_host_size_t length, iree_hal_cuda_staging_range_t** out_range);
+
+// Waits for any copy into |range| to complete and returns its host pointer.
+iree_status_t iree_hal_cuda_staging_ring_wait(
+    iree_hal_cuda_staging_ring_t* ring, iree_hal_cuda_staging_range_t* range,
+    uint8_t** out_host_ptr);
+
+// Synchronously copies |length| bytes from |host_ptr| within a reserved range
+// to |target| on the copy stream.
+iree_status_t iree_hal_cuda_staging_ring_upload(
+    iree_hal_cuda_staging_ring_t* ring, const void* host_ptr,
+    iree_host_size_t length, CUdeviceptr target);
+
+// Releases |range|. It is reused once any copy into it has completed.
+void iree_hal_cuda_staging_ring_release(iree_hal_cuda_staging_ring_t* ring,
+                                        iree_hal_cuda_staging_range_t* range);
+
+// Frees the block if no ranges are reserved.
+void iree_hal_cuda_staging_ring_trim(iree_hal_cuda_staging_ring_t* ring);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_STAGING_RING_H_
@@ -24,8 +24,20 @@ typedef struct iree_hal_cuda_stream_command_buffer_t {
   // Per-stream CUDA tracing context.
   iree_hal_cuda_tracing_context_t* tracing_context;
 
+  // Optional timer sampling dispatch durations.
+  iree_hal_cuda_dispatch_timer_t* dispatch_timer;
+
   CUstream cu_stream;
 
+  // Optional stream collectives are issued on to overlap with |cu_stream|.
+  CUstream cu_collective_stream;
+  // Events used to order |cu_collective_stream| after prior work on
+  // |cu_stream| and to join it back. Created on first use.
+  CUevent cu_collective_fork_event;
+  CUevent cu_collective_join_event;
+  // True if collectives were issued that |cu_stream| has not yet waited on.
+  bool collectives_pending_join;
+
   // A resource set to maintain references to all resources used within the
   // command buffer. Reset on each begin.
   iree_hal_resource_set_t* resource_set;
@@ -62,10 +74,12 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_hal_cuda_dispatch_timer_t* dispatch_timer,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, CUstream stream,
-    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    CUstream collective_stream, iree_arena_block_pool_t* block_pool,
+    iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(cuda_symbols);
@@ -94,7 +108,12 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
   command_buffer->cuda_symbols = cuda_symbols;
   command_buffer->nccl_symbols = nccl_symbols;
   command_buffer->tracing_context = tracing_context;
+  command_buffer->dispatch_timer = dispatch_timer;
   command_buffer->cu_stream = stream;
+  // Zones are recorded against a single stream and tracing collectives on
+  // another would interleave them out of order.
+  command_buffer->cu_collective_stream =
+      tracing_context ? NULL : collective_stream;
   iree_arena_initialize(block_pool, &command_buffer->arena);
 
   iree_status_t status =
@@ -118,6 +137,16 @@ static void iree_hal_cuda_stream_command_buffer_destroy(
   iree_allocator_t host_allocator = command_buffer->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  if (command_buffer->cu_collective_fork_event) {
+    IREE_CUDA_IGNORE_ERROR(
+        command_buffer->cuda_symbols,
+        cuEventDestroy(command_buffer->cu_collective_fork_event));
+  }
+  if (command_buffer->cu_collective_join_event) {
+    IREE_CUDA_IGNORE_ERROR(
+        command_buffer->cuda_symbols,
+        cuEventDestroy(command_buffer->cu_collective_join_event));
+  }
   iree_hal_collective_batch_deinitialize(&command_buffer->collective_batch);
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_arena_deinitialize(&command_buffer->arena);
@@ -145,14 +174,75 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_flush_collectives(
     return iree_ok_status();
   }
   IREE_TRACE_ZONE_BEGIN(z0);
-  iree_status_t status = iree_hal_cuda_nccl_submit_batch(
-      command_buffer->nccl_symbols, command_buffer->tracing_context,
-      &command_buffer->collective_batch, command_buffer->cu_stream);
+
+  // Fork the collective stream from the dispatch stream so that collectives
+  // observe all prior work.
+  CUstream stream = command_buffer->cu_stream;
+  iree_status_t status = iree_ok_status();
+  if (command_buffer->cu_collective_stream) {
+    stream = command_buffer->cu_collective_stream;
+    if (!command_buffer->cu_collective_fork_event) {
+      status = IREE_CURESULT_TO_STATUS(
+          command_buffer->cuda_symbols,
+          cuEventCreate(&command_buffer->cu_collective_fork_event,
+                        CU_EVENT_DISABLE_TIMING));
+    }
+    if (iree_status_is_ok(status) &&
+        !command_buffer->cu_collective_join_event) {
+      status = IREE_CURESULT_TO_STATUS(
+          command_buffer->cuda_symbols,
+          cuEventCreate(&command_buffer->cu_collective_join_event,
+                        CU_EVENT_DISABLE_TIMING));
+    }
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          command_buffer->cuda_symbols,
+          cuEventRecord(command_buffer->cu_collective_fork_event,
+                        command_buffer->cu_stream));
+    }
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          command_buffer->cuda_symbols,
+          cuStreamWaitEvent(stream, command_buffer->cu_collective_fork_event,
+                            CU_EVENT_WAIT_DEFAULT));
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_nccl_submit_batch(
+        command_buffer->nccl_symbols, command_buffer->tracing_context,
+        &command_buffer->collective_batch, stream);
+  }
   iree_hal_collective_batch_clear(&command_buffer->collective_batch);
+
+  // The dispatch stream joins back at the next barrier.
+  if (iree_status_is_ok(status) && command_buffer->cu_collective_stream) {
+    status = IREE_CURESULT_TO_STATUS(
+        command_buffer->cuda_symbols,
+        cuEventRecord(command_buffer->cu_collective_join_event, stream));
+    command_buffer->collectives_pending_join = iree_status_is_ok(status);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+// Orders all subsequent work on the dispatch stream after any collectives
+// issued on the collective stream.
+static iree_status_t iree_hal_cuda_stream_command_buffer_join_collectives(
+    iree_hal_cuda_stream_command_buffer_t* command_buffer) {
+  if (IREE_LIKELY(!command_buffer->collectives_pending_join)) {
+    return iree_ok_status();
+  }
+  command_buffer->collectives_pending_join = false;
+  return IREE_CURESULT_TO_STATUS(
+      command_buffer->cuda_symbols,
+      cuStreamWaitEvent(command_buffer->cu_stream,
+                        command_buffer->cu_collective_join_event,
+                        CU_EVENT_WAIT_DEFAULT),
+      "cuStreamWaitEvent");
+}
+
 static iree_status_t iree_hal_cuda_stream_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_cuda_stream_command_buffer_t* command_buffer =
@@ -176,6 +266,8 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_end(
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0,
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_stream_command_buffer_join_collectives(command_buffer));
 
   // Reset the arena as there should be nothing using it now that we've
   // dispatched all our operations inline.
@@ -255,12 +347,18 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_execution_barrier(
   }
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  IREE_RETURN_IF_ERROR(
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
       iree_hal_cuda_stream_command_buffer_flush_collectives(command_buffer));
 
-  // Nothing to do for barriers between memory operations or dispatches--CUDA
-  // stream semantics guarantees execution and memory visibility in program
-  // order.
+  // Collectives issued on the collective stream must complete before any work
+  // after the barrier.
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_cuda_stream_command_buffer_join_collectives(command_buffer));
+
+  // Nothing else to do for barriers between memory operations or
+  // dispatches--CUDA stream semantics guarantees execution and memory
+  // visibility in program order.
 
   IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
@@ -593,8 +691,16 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch(
         command_buffer->push_constants[i];
   }
 
-  IREE_CUDA_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, command_buffer->cuda_symbols,
+  iree_host_size_t sample = IREE_HAL_CUDA_DISPATCH_TIMER_NO_SAMPLE;
+  if (command_buffer->dispatch_timer) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_hal_cuda_dispatch_timer_begin(
+                command_buffer->dispatch_timer, command_buffer->cu_stream,
+                executable, entry_point, &sample));
+  }
+
+  iree_status_t status = IREE_CURESULT_TO_STATUS(
+      command_buffer->cuda_symbols,
       cuLaunchKernel(kernel_info.function, workgroup_x, workgroup_y,
                      workgroup_z, kernel_info.block_size[0],
                      kernel_info.block_size[1], kernel_info.block_size[2],
@@ -602,6 +708,15 @@ static iree_status_t iree_hal_cuda_stream_command_buffer_dispatch(
                      params_ptr, NULL),
       "cuLaunchKernel");
 
+  // Samples are always ended so that collection is not blocked on them.
+  if (command_buffer->dispatch_timer) {
+    status = iree_status_join(
+        status,
+        iree_hal_cuda_dispatch_timer_end(command_buffer->dispatch_timer,
+                                         command_buffer->cu_stream, sample));
+  }
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, status);
+
   IREE_CUDA_STREAM_TRACE_ZONE_END(command_buffer->tracing_context,
                                   command_buffer->cu_stream);
 
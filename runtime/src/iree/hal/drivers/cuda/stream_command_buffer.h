@@ -11,6 +11,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/cuda_headers.h"
+#include "iree/hal/drivers/cuda/dispatch_statistics.h"
 #include "iree/hal/drivers/cuda/nccl_dynamic_symbols.h"
 #include "iree/hal/drivers/cuda/tracing.h"
 
@@ -21,6 +22,13 @@ extern "C" {
 // Creates command buffer that immediately issues commands against the given
 // CUDA |stream|. Access to |stream| must be synchronized by the user.
 //
+// If |collective_stream| is non-NULL collective operations are issued against
+// it instead of |stream| such that they may overlap with other commands
+// recorded in the same barrier scope. |stream| waits for the collectives to
+// complete at the next barrier or the end of the command buffer.
+//
+// If |dispatch_timer| is non-NULL dispatches are sampled with it.
+//
 // If |block_pool| is non-NULL then the stream command buffer will retain copies
 // of input data until reset. If NULL then the caller must ensure the lifetime
 // of input data outlives the command buffer.
@@ -34,10 +42,12 @@ iree_status_t iree_hal_cuda_stream_command_buffer_create(
     const iree_hal_cuda_dynamic_symbols_t* cuda_symbols,
     const iree_hal_cuda_nccl_dynamic_symbols_t* nccl_symbols,
     iree_hal_cuda_tracing_context_t* tracing_context,
+    iree_hal_cuda_dispatch_timer_t* dispatch_timer,
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_host_size_t binding_capacity, CUstream stream,
-    iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
+    CUstream collective_stream, iree_arena_block_pool_t* block_pool,
+    iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
 // Returns true if |command_buffer| is a CUDA stream-based command buffer.
@@ -0,0 +1,299 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/cuda/transient_heap.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/cuda/cuda_status_util.h"
+
+// Alignment of all reserved ranges. Matches the minimum alignment of
+// allocations made by the CUDA driver.
+#define IREE_HAL_CUDA_TRANSIENT_HEAP_ALIGNMENT 256
+
+// Maximum number of ranges that may be reserved or pending reclamation at any
+// time. Reservations beyond this fail softly and fall back to the pool.
+#define IREE_HAL_CUDA_TRANSIENT_HEAP_MAX_RANGES 256
+
+typedef struct iree_hal_cuda_transient_range_t {
+  // Byte offset of the range from the heap block base.
+  iree_device_size_t offset;
+  // Total aligned length of the range in bytes.
+  iree_device_size_t length;
+  // True once the range has been retired by its user.
+  bool is_retired;
+  // The stream the retirement was ordered on or NULL if the range may be
+  // reclaimed without waiting for any device work.
+  CUstream stream;
+  // Recorded on |stream| at retirement. Lazily created and reused by later
+  // ranges occupying the same slot.
+  CUevent event;
+} iree_hal_cuda_transient_range_t;
+
+struct iree_hal_cuda_transient_heap_t {
+  // The allocator used to create the heap.
+  iree_allocator_t host_allocator;
+  // The symbols used to manage the block and events.
+  const iree_hal_cuda_dynamic_symbols_t* symbols;
+  // The pool the block is allocated from.
+  CUmemoryPool memory_pool;
+  // Total size of the block in bytes.
+  iree_device_size_t capacity;
+
+  // Guards the ring state below.
+  iree_slim_mutex_t mutex;
+
+  // Base pointer of the block or 0 if not yet allocated (or trimmed).
+  CUdeviceptr base IREE_GUARDED_BY(mutex);
+  // Byte offset the next range will be reserved at.
+  iree_device_size_t head IREE_GUARDED_BY(mutex);
+  // Ring of ranges ordered from oldest to newest reservation starting at
+  // |range_tail| and containing |range_count| entries.
+  iree_host_size_t range_tail IREE_GUARDED_BY(mutex);
+  iree_host_size_t range_count IREE_GUARDED_BY(mutex);
+  iree_hal_cuda_transient_range_t
+      ranges[IREE_HAL_CUDA_TRANSIENT_HEAP_MAX_RANGES] IREE_GUARDED_BY(mutex);
+};
+
+iree_status_t iree_hal_cuda_transient_heap_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUmemoryPool memory_pool,
+    iree_device_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_cuda_transient_heap_t** out_heap) {
+  IREE_ASSERT_ARGUMENT(symbols);
+  IREE_ASSERT_ARGUMENT(out_heap);
+  *out_heap = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_cuda_transient_heap_t* heap = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*heap), (void**)&heap));
+  memset(heap, 0, sizeof(*heap));
+  heap->host_allocator = host_allocator;
+  heap->symbols = symbols;
+  heap->memory_pool = memory_pool;
+  heap->capacity =
+      iree_device_align(capacity, IREE_HAL_CUDA_TRANSIENT_HEAP_ALIGNMENT);
+  iree_slim_mutex_initialize(&heap->mutex);
+
+  *out_heap = heap;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Releases the block if no ranges are reserved. Requires the heap lock.
+static void iree_hal_cuda_transient_heap_release_block(
+    iree_hal_cuda_transient_heap_t* heap) {
+  if (!heap->base || heap->range_count > 0) return;
+  IREE_CUDA_IGNORE_ERROR(heap->symbols, cuMemFree(heap->base));
+  heap->base = 0;
+  heap->head = 0;
+}
+
+void iree_hal_cuda_transient_heap_free(iree_hal_cuda_transient_heap_t* heap) {
+  if (!heap) return;
+  iree_allocator_t host_allocator = heap->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&heap->mutex);
+  IREE_ASSERT_EQ(heap->range_count, 0, "transient ranges still reserved");
+  heap->range_count = 0;
+  iree_hal_cuda_transient_heap_release_block(heap);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(heap->ranges); ++i) {
+    if (heap->ranges[i].event) {
+      IREE_CUDA_IGNORE_ERROR(heap->symbols,
+                             cuEventDestroy(heap->ranges[i].event));
+    }
+  }
+  iree_slim_mutex_unlock(&heap->mutex);
+
+  iree_slim_mutex_deinitialize(&heap->mutex);
+  iree_allocator_free(host_allocator, heap);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_cuda_transient_heap_contains(iree_hal_cuda_transient_heap_t* heap,
+                                           CUdeviceptr device_ptr) {
+  iree_slim_mutex_lock(&heap->mutex);
+  bool contains = heap->base && device_ptr >= heap->base &&
+                  device_ptr < heap->base + heap->capacity;
+  iree_slim_mutex_unlock(&heap->mutex);
+  return contains;
+}
+
+// Reclaims retired ranges from the tail of the ring in reservation order.
+// Ranges retired on |stream| are reclaimed immediately as any work that uses
+// them afterward is ordered behind the retirement. Ranges retired on other
+// streams are reclaimed only once their retirement event has completed.
+// Requires the heap lock.
+static iree_status_t iree_hal_cuda_transient_heap_reclaim(
+    iree_hal_cuda_transient_heap_t* heap, CUstream stream) {
+  iree_status_t status = iree_ok_status();
+  while (heap->range_count > 0) {
+    iree_hal_cuda_transient_range_t* range = &heap->ranges[heap->range_tail];
+    if (!range->is_retired) break;
+    if (range->stream && range->stream != stream) {
+      CUresult result = heap->symbols->cuEventQuery(range->event);
+      if (result == CUDA_ERROR_NOT_READY) break;
+      status = iree_hal_cuda_result_to_status(heap->symbols, result, __FILE__,
+                                              __LINE__);
+      if (!iree_status_is_ok(status)) break;
+    }
+    heap->range_tail =
+        (heap->range_tail + 1) % IREE_HAL_CUDA_TRANSIENT_HEAP_MAX_RANGES;
+    --heap->range_count;
+  }
+  // Once empty reset to the start of the block to reduce fragmentation.
+  if (heap->range_count == 0) heap->head = 0;
+  return status;
+}
+
+// Returns the offset at which |length| bytes can be reserved or
+// IREE_DEVICE_SIZE_MAX if the ring does not have enough contiguous free space.
+// Requires the heap lock.
+static iree_device_size_t iree_hal_cuda_transient_heap_find_offset(
+    iree_hal_cuda_transient_heap_t* heap, iree_device_size_t length) {
+  if (heap->range_count == 0) {
+    return length <= heap->capacity ? 0 : IREE_DEVICE_SIZE_MAX;
+  }
+  if (heap->range_count == IREE_HAL_CUDA_TRANSIENT_HEAP_MAX_RANGES) {
+    return IREE_DEVICE_SIZE_MAX;
+  }
+  iree_device_size_t tail = heap->ranges[heap->range_tail].offset;
+  if (heap->head > tail) {
+    // Free space is [head, capacity) followed by [0, tail).
+    if (length <= heap->capacity - heap->head) return heap->head;
+    if (length <= tail) return 0;
+  } else {
+    // Wrapped: free space is [head, tail).
+    if (length <= tail - heap->head) return heap->head;
+  }
+  return IREE_DEVICE_SIZE_MAX;
+}
+
+iree_status_t iree_hal_cuda_transient_heap_reserve(
+    iree_hal_cuda_transient_heap_t* heap, CUstream stream,
+    iree_device_size_t length, CUdeviceptr* out_device_ptr) {
+  IREE_ASSERT_ARGUMENT(heap);
+  IREE_ASSERT_ARGUMENT(out_device_ptr);
+  *out_device_ptr = 0;
+  length = iree_device_align(iree_max(length, 1),
+                             IREE_HAL_CUDA_TRANSIENT_HEAP_ALIGNMENT);
+  if (length > heap->capacity) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&heap->mutex);
+
+  // Allocate the block on first use. We synchronize so that it can be used
+  // from any stream and not just the one that happened to allocate it.
+  iree_status_t status = iree_ok_status();
+  if (!heap->base) {
+    status = IREE_CURESULT_TO_STATUS(
+        heap->symbols,
+        cuMemAllocFromPoolAsync(&heap->base, (size_t)heap->capacity,
+                                heap->memory_pool, stream),
+        "cuMemAllocFromPoolAsync");
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          heap->symbols, cuStreamSynchronize(stream), "cuStreamSynchronize");
+    }
+    if (!iree_status_is_ok(status)) heap->base = 0;
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_cuda_transient_heap_reclaim(heap, stream);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_device_size_t offset =
+        iree_hal_cuda_transient_heap_find_offset(heap, length);
+    if (offset != IREE_DEVICE_SIZE_MAX) {
+      iree_host_size_t index =
+          (heap->range_tail + heap->range_count) %
+          IREE_HAL_CUDA_TRANSIENT_HEAP_MAX_RANGES;
+      iree_hal_cuda_transient_range_t* range = &heap->ranges[index];
+      range->offset = offset;
+      range->length = length;
+      range->is_retired = false;
+      range->stream = NULL;
+      ++heap->range_count;
+      heap->head = offset + length;
+      *out_device_ptr = heap->base + offset;
+    }
+  }
+
+  iree_slim_mutex_unlock(&heap->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_cuda_transient_heap_retire(
+    iree_hal_cuda_transient_heap_t* heap, CUstream stream,
+    CUdeviceptr device_ptr) {
+  IREE_ASSERT_ARGUMENT(heap);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&heap->mutex);
+
+  // Find the range. Ranges are usually retired in reservation order so we scan
+  // from the oldest.
+  iree_hal_cuda_transient_range_t* range = NULL;
+  iree_device_size_t offset = device_ptr - heap->base;
+  for (iree_host_size_t i = 0; i < heap->range_count; ++i) {
+    iree_hal_cuda_transient_range_t* candidate =
+        &heap->ranges[(heap->range_tail + i) %
+                      IREE_HAL_CUDA_TRANSIENT_HEAP_MAX_RANGES];
+    if (candidate->offset == offset && !candidate->is_retired) {
+      range = candidate;
+      break;
+    }
+  }
+
+  iree_status_t status = iree_ok_status();
+  if (!range) {
+    status = iree_make_status(IREE_STATUS_NOT_FOUND,
+                              "transient range not reserved from this heap");
+  }
+
+  // Order the retirement on the stream.
+  if (iree_status_is_ok(status) && stream) {
+    if (!range->event) {
+      status = IREE_CURESULT_TO_STATUS(
+          heap->symbols, cuEventCreate(&range->event, CU_EVENT_DISABLE_TIMING),
+          "cuEventCreate");
+    }
+    if (iree_status_is_ok(status)) {
+      status = IREE_CURESULT_TO_STATUS(
+          heap->symbols, cuEventRecord(range->event, stream), "cuEventRecord");
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    range->is_retired = true;
+    range->stream = stream;
+  }
+
+  iree_slim_mutex_unlock(&heap->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_cuda_transient_heap_trim(iree_hal_cuda_transient_heap_t* heap) {
+  IREE_ASSERT_ARGUMENT(heap);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&heap->mutex);
+  iree_status_ignore(iree_hal_cuda_transient_heap_reclaim(heap, NULL));
+  iree_hal_cuda_transient_heap_release_block(heap);
+  iree_slim_mutex_unlock(&heap->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+}
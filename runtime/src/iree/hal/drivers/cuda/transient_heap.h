@@ -0,0 +1,76 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_CUDA_TRANSIENT_HEAP_H_
+#define IREE_HAL_DRIVERS_CUDA_TRANSIENT_HEAP_H_
+
+#include <stdbool.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/cuda/cuda_dynamic_symbols.h"
+#include "iree/hal/drivers/cuda/cuda_headers.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_cuda_transient_heap_t
+//===----------------------------------------------------------------------===//
+
+// A stream-ordered suballocator for transient queue-ordered allocations.
+//
+// A single large block is allocated from a CUmemoryPool on first use and
+// suballocated as a ring: ranges are reserved by bumping the head and retired
+// ranges are reclaimed from the tail in the order they were reserved. Each
+// retirement records a CUevent on the stream it was ordered on and the range
+// is reclaimed once that event has completed or immediately when the next
+// reservation is ordered on the same stream. Programs that allocate and free
+// their transients in roughly the same order each invocation reuse the same
+// memory without paying driver overhead per allocation.
+//
+// Reservations that do not fit fail softly and callers are expected to fall
+// back to allocating from the pool directly.
+//
+// Thread-safe; ranges may be reserved and retired from any thread.
+typedef struct iree_hal_cuda_transient_heap_t iree_hal_cuda_transient_heap_t;
+
+// Allocates a heap suballocating a |capacity| byte block from |memory_pool|.
+// The block itself is not allocated until the first reservation.
+iree_status_t iree_hal_cuda_transient_heap_allocate(
+    const iree_hal_cuda_dynamic_symbols_t* symbols, CUmemoryPool memory_pool,
+    iree_device_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_cuda_transient_heap_t** out_heap);
+
+// Frees |heap| and its block. All reserved ranges must have been retired.
+void iree_hal_cuda_transient_heap_free(iree_hal_cuda_transient_heap_t* heap);
+
+// Returns true if |device_ptr| was reserved from |heap|.
+bool iree_hal_cuda_transient_heap_contains(iree_hal_cuda_transient_heap_t* heap,
+                                           CUdeviceptr device_ptr);
+
+// Reserves |length| bytes for use in the order of |stream|.
+// Sets |out_device_ptr| to 0 if there is not enough free space in the heap.
+iree_status_t iree_hal_cuda_transient_heap_reserve(
+    iree_hal_cuda_transient_heap_t* heap, CUstream stream,
+    iree_device_size_t length, CUdeviceptr* out_device_ptr);
+
+// Retires a range previously reserved at |device_ptr|. The range becomes
+// available for reuse once all work issued to |stream| prior to this call has
+// completed. A NULL |stream| indicates the range is no longer in use by any
+// device work and may be reused immediately.
+iree_status_t iree_hal_cuda_transient_heap_retire(
+    iree_hal_cuda_transient_heap_t* heap, CUstream stream,
+    CUdeviceptr device_ptr);
+
+// Reclaims completed ranges and frees the block if no ranges are reserved.
+void iree_hal_cuda_transient_heap_trim(iree_hal_cuda_transient_heap_t* heap);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_CUDA_TRANSIENT_HEAP_H_
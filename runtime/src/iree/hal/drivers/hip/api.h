@@ -45,8 +45,16 @@ typedef struct iree_hal_hip_memory_pooling_params_t {
   iree_hal_hip_memory_pool_params_t device_local;
   // Used for any host-visible/host-local memory types.
   iree_hal_hip_memory_pool_params_t other;
+  // Size in bytes of a block reserved from the device_local pool on first use
+  // and suballocated in stream order for DEVICE_LOCAL queue allocations.
+  // Allocations that do not fit in the block are made from the pool directly.
+  // 0 disables suballocation.
+  uint64_t transient_capacity;
 } iree_hal_hip_memory_pooling_params_t;
 
+// The maximum number of queues (and HIP streams) a device may expose.
+#define IREE_HAL_HIP_MAX_QUEUE_COUNT 8
+
 // Parameters configuring an iree_hal_hip_device_t.
 // Must be initialized with iree_hal_hip_device_params_initialize prior to
 // use.
@@ -54,6 +62,10 @@ typedef struct iree_hal_hip_device_params_t {
   // Number of queues exposed on the device.
   // Each queue acts as a separate synchronization scope where all work executes
   // concurrently unless prohibited by semaphores.
+  //
+  // Each queue is backed by its own HIP stream such that submissions to
+  // different queues may overlap on the GPU. Queue affinity bits map to queues
+  // modulo the queue count. Must be at most IREE_HAL_HIP_MAX_QUEUE_COUNT.
   iree_host_size_t queue_count;
 
   // Total size of each block in the device shared block pool.
@@ -71,6 +83,12 @@ typedef struct iree_hal_hip_device_params_t {
   // Specifies how command buffers are recorded and executed.
   iree_hal_hip_command_buffer_mode_t command_buffer_mode;
 
+  // Maximum number of idle instantiated graphs retained for reuse when using
+  // IREE_HAL_HIP_COMMAND_BUFFER_MODE_GRAPH. Command buffers that record graphs
+  // with the same structure as a retained one update it in-place instead of
+  // paying the cost of instantiation. 0 disables reuse.
+  iree_host_size_t graph_exec_cache_capacity;
+
   // Enables tracing of command buffers when IREE tracing is enabled.
   // May take advantage of additional extensions for more accurate timing or
   // hardware-specific performance counters.
@@ -40,6 +40,9 @@ IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipGetDevicePropertiesR0600, hipDeviceProp_t *,
 // const char* instead of hipError_t so it uses a different macro.
 IREE_HAL_HIP_REQUIRED_PFN_STR_DECL(hipGetErrorName, hipError_t)
 IREE_HAL_HIP_REQUIRED_PFN_STR_DECL(hipGetErrorString, hipError_t)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipGraphAddChildGraphNode, hipGraphNode_t *,
+                               hipGraph_t, const hipGraphNode_t *, size_t,
+                               hipGraph_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphAddEmptyNode, hipGraphNode_t *,
                                hipGraph_t, const hipGraphNode_t *, size_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphAddEventRecordNode, hipGraphNode_t *,
@@ -54,6 +57,8 @@ IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphAddMemsetNode, hipGraphNode_t *,
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphCreate, hipGraph_t *, unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphDestroy, hipGraph_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphExecDestroy, hipGraphExec_t)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipGraphExecUpdate, hipGraphExec_t, hipGraph_t,
+                               hipGraphNode_t *, hipGraphExecUpdateResult *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphInstantiate, hipGraphExec_t *,
                                hipGraph_t, hipGraphNode_t *, char *, size_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipGraphLaunch, hipGraphExec_t, hipStream_t)
@@ -107,9 +112,12 @@ IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleLoadData, hipModule_t *, const void *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleLoadDataEx, hipModule_t *, const void *,
                                unsigned int, hipJitOption *, void **)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipModuleUnload, hipModule_t)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipStreamBeginCapture, hipStream_t,
+                               hipStreamCaptureMode)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipStreamCreateWithFlags, hipStream_t *,
                                unsigned int)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipStreamDestroy, hipStream_t)
+IREE_HAL_HIP_OPTIONAL_PFN_DECL(hipStreamEndCapture, hipStream_t, hipGraph_t *)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipStreamSynchronize, hipStream_t)
 IREE_HAL_HIP_REQUIRED_PFN_DECL(hipStreamWaitEvent, hipStream_t, hipEvent_t,
                                unsigned int)
@@ -12,6 +12,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/drivers/hip/dynamic_symbols.h"
+#include "iree/hal/drivers/hip/graph_exec_cache.h"
 #include "iree/hal/drivers/hip/hip_buffer.h"
 #include "iree/hal/drivers/hip/native_executable.h"
 #include "iree/hal/drivers/hip/pipeline_layout.h"
@@ -48,6 +49,19 @@ typedef struct iree_hal_hip_graph_command_buffer_t {
   hipGraph_t hip_graph;
   hipGraphExec_t hip_exec;
 
+  // Optional device cache of idle graph execs. When present the graph exec is
+  // returned to the cache upon destruction and reused by subsequent command
+  // buffers with the same graph signature.
+  iree_hal_hip_graph_exec_cache_t* exec_cache;
+  // Running hash of the structure of the graph under construction.
+  // Two graphs with the same signature are expected (but not guaranteed) to be
+  // updatable from one to the other with hipGraphExecUpdate.
+  uint64_t graph_signature;
+
+  // Stream used to capture operations that cannot be added as graph nodes
+  // directly into child graphs. Created on first use.
+  hipStream_t hip_capture_stream;
+
   // A node acting as a barrier for all commands added to the command buffer.
   hipGraphNode_t hip_barrier_node;
 
@@ -76,6 +90,44 @@ iree_hal_hip_graph_command_buffer_cast(iree_hal_command_buffer_t* base_value) {
   return (iree_hal_hip_graph_command_buffer_t*)base_value;
 }
 
+// Kinds of structural changes to the graph mixed into its signature.
+typedef enum iree_hal_hip_graph_signature_kind_e {
+  IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_BARRIER = 1,
+  IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_EVENT_RECORD_NODE,
+  IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_MEMSET_NODE,
+  IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_MEMCPY_NODE,
+  IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_KERNEL_NODE,
+  IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_CHILD_GRAPH_NODE,
+} iree_hal_hip_graph_signature_kind_t;
+
+// Mixes |value| into the graph signature with FNV-1a.
+static void iree_hal_hip_graph_command_buffer_mix_signature(
+    iree_hal_hip_graph_command_buffer_t* command_buffer, uint64_t value) {
+  uint64_t hash = command_buffer->graph_signature;
+  for (int i = 0; i < 8; ++i) {
+    hash ^= (value >> (i * 8)) & 0xFFu;
+    hash *= 0x100000001B3ull;
+  }
+  command_buffer->graph_signature = hash;
+}
+
+// Mixes a structural change of type |kind| into the graph signature.
+// Only properties that hipGraphExecUpdate cannot change between graphs need to
+// be included in |values|: the topology, node types, and kernel functions and
+// memory types. Pointers, launch dimensions, and kernel arguments may differ.
+static void iree_hal_hip_graph_command_buffer_append_signature(
+    iree_hal_hip_graph_command_buffer_t* command_buffer,
+    iree_hal_hip_graph_signature_kind_t kind, iree_host_size_t value_count,
+    const uint64_t* values) {
+  iree_hal_hip_graph_command_buffer_mix_signature(
+      command_buffer, ((uint64_t)command_buffer->graph_node_count << 32) |
+                          (command_buffer->hip_barrier_node ? 1u << 31 : 0) |
+                          (uint64_t)kind);
+  for (iree_host_size_t i = 0; i < value_count; ++i) {
+    iree_hal_hip_graph_command_buffer_mix_signature(command_buffer, values[i]);
+  }
+}
+
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION_DEVICE
 
 static void iree_hip_graph_command_buffer_trace_zone_begin_external(
@@ -89,6 +141,9 @@ static void iree_hip_graph_command_buffer_trace_zone_begin_external(
         command_buffer);
   }
 
+  iree_hal_hip_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_EVENT_RECORD_NODE, 0,
+      NULL);
   hipGraphNode_t* tracing_event_node =
       &command_buffer->hip_graph_nodes[command_buffer->graph_node_count++];
   size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
@@ -113,6 +168,9 @@ static void iree_hip_graph_command_buffer_trace_zone_end(
         command_buffer);
   }
 
+  iree_hal_hip_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_EVENT_RECORD_NODE, 0,
+      NULL);
   hipGraphNode_t* tracing_event_node =
       &command_buffer->hip_graph_nodes[command_buffer->graph_node_count++];
   size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
@@ -158,6 +216,7 @@ iree_status_t iree_hal_hip_graph_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_hip_graph_exec_cache_t* exec_cache,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
@@ -189,6 +248,9 @@ iree_status_t iree_hal_hip_graph_command_buffer_create(
   command_buffer->hip_context = context;
   command_buffer->hip_graph = NULL;
   command_buffer->hip_exec = NULL;
+  command_buffer->exec_cache = exec_cache;
+  command_buffer->graph_signature = 0xCBF29CE484222325ull;  // FNV-1a basis
+  command_buffer->hip_capture_stream = NULL;
   command_buffer->hip_barrier_node = NULL;
   command_buffer->graph_node_count = 0;
 
@@ -218,10 +280,23 @@ static void iree_hal_hip_graph_command_buffer_destroy(
     command_buffer->hip_graph = NULL;
   }
   if (command_buffer->hip_exec != NULL) {
-    IREE_HIP_IGNORE_ERROR(command_buffer->symbols,
-                          hipGraphExecDestroy(command_buffer->hip_exec));
+    // The command buffer is only destroyed once all launches of it have
+    // completed and the graph exec can be reused by future command buffers.
+    if (command_buffer->exec_cache) {
+      iree_hal_hip_graph_exec_cache_release(command_buffer->exec_cache,
+                                            command_buffer->graph_signature,
+                                            command_buffer->hip_exec);
+    } else {
+      IREE_HIP_IGNORE_ERROR(command_buffer->symbols,
+                            hipGraphExecDestroy(command_buffer->hip_exec));
+    }
     command_buffer->hip_exec = NULL;
   }
+  if (command_buffer->hip_capture_stream != NULL) {
+    IREE_HIP_IGNORE_ERROR(command_buffer->symbols,
+                          hipStreamDestroy(command_buffer->hip_capture_stream));
+    command_buffer->hip_capture_stream = NULL;
+  }
   command_buffer->hip_barrier_node = NULL;
   command_buffer->graph_node_count = 0;
 
@@ -277,14 +352,46 @@ static iree_status_t iree_hal_hip_graph_command_buffer_end(
   command_buffer->hip_barrier_node = NULL;
   command_buffer->graph_node_count = 0;
 
+  // Try to reuse an idle graph exec with the same structure by updating its
+  // node parameters in-place. Instantiation is particularly expensive on AMD
+  // GPUs and updates avoid most of its cost.
+  iree_status_t status = iree_ok_status();
+  hipGraphExec_t cached_exec = NULL;
+  if (command_buffer->exec_cache &&
+      command_buffer->symbols->hipGraphExecUpdate &&
+      iree_hal_hip_graph_exec_cache_acquire(command_buffer->exec_cache,
+                                            command_buffer->graph_signature,
+                                            &cached_exec)) {
+    IREE_TRACE_ZONE_BEGIN_NAMED(z1, "hipGraphExecUpdate");
+    hipGraphNode_t error_node = NULL;
+    hipGraphExecUpdateResult update_result = hipGraphExecUpdateSuccess;
+    iree_status_t update_status = IREE_HIP_RESULT_TO_STATUS(
+        command_buffer->symbols,
+        hipGraphExecUpdate(cached_exec, command_buffer->hip_graph, &error_node,
+                           &update_result));
+    if (iree_status_is_ok(update_status) &&
+        update_result == hipGraphExecUpdateSuccess) {
+      command_buffer->hip_exec = cached_exec;
+    } else {
+      // Signature collision or an unsupported change; fall back to
+      // instantiation below.
+      iree_status_ignore(update_status);
+      IREE_HIP_IGNORE_ERROR(command_buffer->symbols,
+                            hipGraphExecDestroy(cached_exec));
+    }
+    IREE_TRACE_ZONE_END(z1);
+  }
+
   // Compile the graph.
-  hipGraphNode_t error_node = NULL;
-  iree_status_t status = IREE_HIP_RESULT_TO_STATUS(
-      command_buffer->symbols,
-      hipGraphInstantiate(&command_buffer->hip_exec, command_buffer->hip_graph,
-                          &error_node,
-                          /*logBuffer=*/NULL,
-                          /*bufferSize=*/0));
+  if (!command_buffer->hip_exec) {
+    hipGraphNode_t error_node = NULL;
+    status = IREE_HIP_RESULT_TO_STATUS(
+        command_buffer->symbols,
+        hipGraphInstantiate(&command_buffer->hip_exec,
+                            command_buffer->hip_graph, &error_node,
+                            /*logBuffer=*/NULL,
+                            /*bufferSize=*/0));
+  }
   if (iree_status_is_ok(status)) {
     // No longer need the source graph used for construction.
     IREE_HIP_IGNORE_ERROR(command_buffer->symbols,
@@ -294,7 +401,7 @@ static iree_status_t iree_hal_hip_graph_command_buffer_end(
 
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
-  return iree_ok_status();
+  return status;
 }
 
 static void iree_hal_hip_graph_command_buffer_begin_debug_group(
@@ -325,6 +432,9 @@ iree_hal_hip_graph_command_buffer_execution_barrier_internal(
   IREE_ASSERT_GT(command_buffer->graph_node_count, 0,
                  "expected at least one node before a barrier");
 
+  iree_hal_hip_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_BARRIER, 0, NULL);
+
   // Use the last node as a barrier to avoid creating redundant empty nodes.
   if (IREE_LIKELY(command_buffer->graph_node_count == 1)) {
     command_buffer->hip_barrier_node = command_buffer->hip_graph_nodes[0];
@@ -451,6 +561,11 @@ static iree_status_t iree_hal_hip_graph_command_buffer_fill_buffer(
                             "exceeded max concurrent node limit");
   }
 
+  const uint64_t signature_values[1] = {pattern_length};
+  iree_hal_hip_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_MEMSET_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+
   size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
   IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
@@ -465,17 +580,109 @@ static iree_status_t iree_hal_hip_graph_command_buffer_fill_buffer(
   return iree_ok_status();
 }
 
+// Captures the linear copy described by |params| on the capture stream into a
+// child graph and adds it to the graph under construction.
+static iree_status_t iree_hal_hip_graph_command_buffer_add_captured_memcpy(
+    iree_hal_hip_graph_command_buffer_t* command_buffer,
+    const HIP_MEMCPY3D* params, hipGraphNode_t* out_node,
+    size_t dependency_count) {
+  const iree_hal_hip_dynamic_symbols_t* symbols = command_buffer->symbols;
+  if (!symbols->hipStreamBeginCapture || !symbols->hipStreamEndCapture ||
+      !symbols->hipGraphAddChildGraphNode) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "missing hipDrvGraphAddMemcpyNode and stream "
+                            "capture symbols; cannot use graph-based command "
+                            "buffer");
+  }
+
+  if (!command_buffer->hip_capture_stream) {
+    IREE_HIP_RETURN_IF_ERROR(
+        symbols,
+        hipStreamCreateWithFlags(&command_buffer->hip_capture_stream,
+                                 hipStreamNonBlocking),
+        "hipStreamCreateWithFlags");
+  }
+
+  const uint8_t* src = params->srcMemoryType == hipMemoryTypeHost
+                           ? (const uint8_t*)params->srcHost
+                           : (const uint8_t*)params->srcDevice;
+  uint8_t* dst = (uint8_t*)params->dstDevice;
+  hipMemcpyKind kind = params->srcMemoryType == hipMemoryTypeHost
+                           ? hipMemcpyHostToDevice
+                           : hipMemcpyDeviceToDevice;
+
+  // Thread-local capture only captures work issued from this thread and does
+  // not interfere with unrelated streams being used concurrently.
+  hipStream_t stream = command_buffer->hip_capture_stream;
+  IREE_HIP_RETURN_IF_ERROR(
+      symbols, hipStreamBeginCapture(stream, hipStreamCaptureModeThreadLocal),
+      "hipStreamBeginCapture");
+  iree_status_t status = IREE_HIP_RESULT_TO_STATUS(
+      symbols,
+      hipMemcpyAsync(dst + params->dstXInBytes, src + params->srcXInBytes,
+                     params->WidthInBytes, kind, stream),
+      "hipMemcpyAsync");
+  // Capture must always be ended to return the stream to normal operation.
+  hipGraph_t child_graph = NULL;
+  status = iree_status_join(
+      status, IREE_HIP_RESULT_TO_STATUS(
+                  symbols, hipStreamEndCapture(stream, &child_graph),
+                  "hipStreamEndCapture"));
+  if (iree_status_is_ok(status)) {
+    // The child graph is cloned into the parent and can be released.
+    status = IREE_HIP_RESULT_TO_STATUS(
+        symbols,
+        hipGraphAddChildGraphNode(out_node, command_buffer->hip_graph,
+                                  &command_buffer->hip_barrier_node,
+                                  dependency_count, child_graph),
+        "hipGraphAddChildGraphNode");
+  }
+  if (child_graph) {
+    IREE_HIP_IGNORE_ERROR(symbols, hipGraphDestroy(child_graph));
+  }
+  return status;
+}
+
+// Adds a node performing the linear copy described by |params| to the graph
+// under construction. Copies are captured from a stream when the HIP runtime
+// does not support adding memcpy nodes directly.
+static iree_status_t iree_hal_hip_graph_command_buffer_add_memcpy_node(
+    iree_hal_hip_graph_command_buffer_t* command_buffer,
+    const HIP_MEMCPY3D* params) {
+  hipGraphNode_t* node =
+      &command_buffer->hip_graph_nodes[command_buffer->graph_node_count];
+  size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
+  const bool is_captured =
+      command_buffer->symbols->hipDrvGraphAddMemcpyNode == NULL;
+  const uint64_t signature_values[2] = {params->srcMemoryType,
+                                        params->dstMemoryType};
+  iree_hal_hip_graph_command_buffer_append_signature(
+      command_buffer,
+      is_captured ? IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_CHILD_GRAPH_NODE
+                  : IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_MEMCPY_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+  if (!is_captured) {
+    IREE_HIP_RETURN_IF_ERROR(
+        command_buffer->symbols,
+        hipDrvGraphAddMemcpyNode(node, command_buffer->hip_graph,
+                                 &command_buffer->hip_barrier_node,
+                                 dependency_count, params,
+                                 command_buffer->hip_context),
+        "hipDrvGraphAddMemcpyNode");
+  } else {
+    IREE_RETURN_IF_ERROR(iree_hal_hip_graph_command_buffer_add_captured_memcpy(
+        command_buffer, params, node, dependency_count));
+  }
+  ++command_buffer->graph_node_count;
+  return iree_ok_status();
+}
+
 static iree_status_t iree_hal_hip_graph_command_buffer_update_buffer(
     iree_hal_command_buffer_t* base_command_buffer, const void* source_buffer,
     iree_host_size_t source_offset, iree_hal_buffer_t* target_buffer,
     iree_device_size_t target_offset, iree_device_size_t length) {
   iree_hal_hip_graph_command_buffer_t* command_buffer =
       iree_hal_hip_graph_command_buffer_cast(base_command_buffer);
-  if (command_buffer->symbols->hipDrvGraphAddMemcpyNode == NULL) {
-    return iree_make_status(IREE_STATUS_UNAVAILABLE,
-                            "missing hipDrvGraphAddMemcpyNode symbol; "
-                            "cannot use graph-based command buffer");
-  }
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_HIP_GRAPH_COMMAND_BUFFER_TRACE_ZONE_BEGIN(command_buffer);
 
@@ -515,14 +722,9 @@ static iree_status_t iree_hal_hip_graph_command_buffer_update_buffer(
                             "exceeded max concurrent node limit");
   }
 
-  size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
-  IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, command_buffer->symbols,
-      hipDrvGraphAddMemcpyNode(
-          &command_buffer->hip_graph_nodes[command_buffer->graph_node_count++],
-          command_buffer->hip_graph, &command_buffer->hip_barrier_node,
-          dependency_count, &params, command_buffer->hip_context),
-      "hipDrvGraphAddMemcpyNode");
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_hip_graph_command_buffer_add_memcpy_node(command_buffer,
+                                                            &params));
 
   IREE_HIP_GRAPH_COMMAND_BUFFER_TRACE_ZONE_END(command_buffer);
   IREE_TRACE_ZONE_END(z0);
@@ -536,11 +738,6 @@ static iree_status_t iree_hal_hip_graph_command_buffer_copy_buffer(
     iree_device_size_t length) {
   iree_hal_hip_graph_command_buffer_t* command_buffer =
       iree_hal_hip_graph_command_buffer_cast(base_command_buffer);
-  if (command_buffer->symbols->hipDrvGraphAddMemcpyNode == NULL) {
-    return iree_make_status(IREE_STATUS_UNAVAILABLE,
-                            "missing hipDrvGraphAddMemcpyNode symbol; "
-                            "cannot use graph-based command buffer");
-  }
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_HIP_GRAPH_COMMAND_BUFFER_TRACE_ZONE_BEGIN(command_buffer);
 
@@ -574,14 +771,9 @@ static iree_status_t iree_hal_hip_graph_command_buffer_copy_buffer(
                             "exceeded max concurrent node limit");
   }
 
-  size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
-  IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, command_buffer->symbols,
-      hipDrvGraphAddMemcpyNode(
-          &command_buffer->hip_graph_nodes[command_buffer->graph_node_count++],
-          command_buffer->hip_graph, &command_buffer->hip_barrier_node,
-          dependency_count, &params, command_buffer->hip_context),
-      "hipDrvGraphAddMemcpyNode");
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_hip_graph_command_buffer_add_memcpy_node(command_buffer,
+                                                            &params));
 
   IREE_HIP_GRAPH_COMMAND_BUFFER_TRACE_ZONE_END(command_buffer);
   IREE_TRACE_ZONE_END(z0);
@@ -749,6 +941,11 @@ static iree_status_t iree_hal_hip_graph_command_buffer_dispatch(
                             "exceeded max concurrent node limit");
   }
 
+  const uint64_t signature_values[1] = {(uint64_t)(uintptr_t)params.func};
+  iree_hal_hip_graph_command_buffer_append_signature(
+      command_buffer, IREE_HAL_HIP_GRAPH_SIGNATURE_KIND_KERNEL_NODE,
+      IREE_ARRAYSIZE(signature_values), signature_values);
+
   size_t dependency_count = command_buffer->hip_barrier_node ? 1 : 0;
   IREE_HIP_RETURN_AND_END_ZONE_IF_ERROR(
       z0, command_buffer->symbols,
@@ -21,12 +21,16 @@ extern "C" {
 // changes and may have outstanding issues.
 
 typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
+typedef struct iree_hal_hip_graph_exec_cache_t iree_hal_hip_graph_exec_cache_t;
 typedef struct iree_hal_hip_tracing_context_t iree_hal_hip_tracing_context_t;
 
 // Creates a command buffer that records into a HIP graph.
 //
-// NOTE: the |block_pool| must remain live for the lifetime of the command
-// buffers that use it.
+// If |exec_cache| is provided instantiated graphs are reused across command
+// buffers with the same structure.
+//
+// NOTE: the |block_pool| and |exec_cache| must remain live for the lifetime of
+// the command buffers that use them.
 iree_status_t iree_hal_hip_graph_command_buffer_create(
     iree_hal_device_t* device,
     const iree_hal_hip_dynamic_symbols_t* hip_symbols,
@@ -34,6 +38,7 @@ iree_status_t iree_hal_hip_graph_command_buffer_create(
     iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
+    iree_hal_hip_graph_exec_cache_t* exec_cache,
     iree_arena_block_pool_t* block_pool, iree_allocator_t host_allocator,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -18,6 +18,7 @@
 #include "iree/hal/drivers/hip/event_pool.h"
 #include "iree/hal/drivers/hip/event_semaphore.h"
 #include "iree/hal/drivers/hip/graph_command_buffer.h"
+#include "iree/hal/drivers/hip/graph_exec_cache.h"
 #include "iree/hal/drivers/hip/hip_allocator.h"
 #include "iree/hal/drivers/hip/hip_buffer.h"
 #include "iree/hal/drivers/hip/memory_pools.h"
@@ -57,11 +58,14 @@ typedef struct iree_hal_hip_device_t {
 
   hipCtx_t hip_context;
   hipDevice_t hip_device;
-  // TODO: Support multiple device streams.
-  // The hipStream_t used to issue device kernels and allocations.
-  hipStream_t hip_dispatch_stream;
-  // The hipStream_t used to issue host callback functions.
-  hipStream_t hip_callback_stream;
+  // Per-queue hipStream_ts used to issue device kernels and allocations.
+  // Work on different streams may execute concurrently and any dependencies
+  // between them are expressed with hipEvent_ts by semaphore timepoints.
+  // The stream of queue 0 is also used for tracing and allocator operations.
+  hipStream_t hip_dispatch_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT];
+  // Per-queue hipStream_ts used to issue host callback functions. Separate
+  // streams ensure completion of one queue is not reported behind another.
+  hipStream_t hip_callback_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT];
 
   iree_hal_hip_tracing_context_t* tracing_context;
 
@@ -79,6 +83,10 @@ typedef struct iree_hal_hip_device_t {
   // and hipEvent_t objects.
   iree_hal_hip_pending_queue_actions_t* pending_queue_actions;
 
+  // Idle instantiated graphs available for reuse by graph command buffers.
+  // NULL if reuse is disabled or command buffers are not backed by graphs.
+  iree_hal_hip_graph_exec_cache_t* graph_exec_cache;
+
   // Device memory pools and allocators.
   bool supports_memory_pools;
   iree_hal_hip_memory_pools_t memory_pools;
@@ -98,6 +106,16 @@ static iree_hal_hip_device_t* iree_hal_hip_device_cast_unsafe(
   return (iree_hal_hip_device_t*)base_value;
 }
 
+// Returns the index of the queue that work with |queue_affinity| executes on.
+// The lowest set affinity bit selects the queue modulo the queue count such
+// that IREE_HAL_QUEUE_AFFINITY_ANY maps to queue 0.
+static iree_host_size_t iree_hal_hip_device_select_queue(
+    iree_hal_hip_device_t* device, iree_hal_queue_affinity_t queue_affinity) {
+  if (queue_affinity == 0) return 0;
+  return iree_math_count_trailing_zeros_u64(queue_affinity) %
+         device->params.queue_count;
+}
+
 IREE_API_EXPORT void iree_hal_hip_device_params_initialize(
     iree_hal_hip_device_params_t* out_params) {
   memset(out_params, 0, sizeof(*out_params));
@@ -105,6 +123,7 @@ IREE_API_EXPORT void iree_hal_hip_device_params_initialize(
   out_params->event_pool_capacity = 32;
   out_params->queue_count = 1;
   out_params->command_buffer_mode = IREE_HAL_HIP_COMMAND_BUFFER_MODE_GRAPH;
+  out_params->graph_exec_cache_capacity = 16;
   out_params->stream_tracing = false;
   out_params->async_allocations = true;
   out_params->allow_inline_execution = false;
@@ -120,13 +139,19 @@ static iree_status_t iree_hal_hip_device_check_params(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "at least one queue is required");
   }
+  if (params->queue_count > IREE_HAL_HIP_MAX_QUEUE_COUNT) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "queue count %" PRIhsz " exceeds the maximum of %d",
+                            params->queue_count, IREE_HAL_HIP_MAX_QUEUE_COUNT);
+  }
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_hip_device_create_internal(
     iree_hal_driver_t* driver, iree_string_view_t identifier,
     const iree_hal_hip_device_params_t* params, hipDevice_t hip_device,
-    hipStream_t dispatch_stream, hipStream_t callback_stream, hipCtx_t context,
+    const hipStream_t* dispatch_streams, const hipStream_t* callback_streams,
+    hipCtx_t context,
     const iree_hal_hip_dynamic_symbols_t* symbols,
     iree_allocator_t host_allocator, iree_hal_device_t** out_device) {
   iree_hal_hip_device_t* device = NULL;
@@ -146,18 +171,30 @@ static iree_status_t iree_hal_hip_device_create_internal(
   device->params = *params;
   device->hip_context = context;
   device->hip_device = hip_device;
-  device->hip_dispatch_stream = dispatch_stream;
-  device->hip_callback_stream = callback_stream;
+  memcpy(device->hip_dispatch_streams, dispatch_streams,
+         params->queue_count * sizeof(*dispatch_streams));
+  memcpy(device->hip_callback_streams, callback_streams,
+         params->queue_count * sizeof(*callback_streams));
   device->host_allocator = host_allocator;
 
   iree_status_t status = iree_hal_hip_pending_queue_actions_create(
       symbols, &device->block_pool, host_allocator,
       &device->pending_queue_actions);
 
-  // Enable tracing for the (currently only) stream - no-op if disabled.
+  if (iree_status_is_ok(status) &&
+      params->command_buffer_mode == IREE_HAL_HIP_COMMAND_BUFFER_MODE_GRAPH &&
+      params->graph_exec_cache_capacity > 0) {
+    status = iree_hal_hip_graph_exec_cache_allocate(
+        symbols, params->graph_exec_cache_capacity, host_allocator,
+        &device->graph_exec_cache);
+  }
+
+  // Enable tracing for the first stream - no-op if disabled.
+  // Work issued to other queues is not traced as tracing contexts require
+  // zones to be submitted in order.
   if (iree_status_is_ok(status) && device->params.stream_tracing) {
     status = iree_hal_hip_tracing_context_allocate(
-        device->hip_symbols, device->identifier, dispatch_stream,
+        device->hip_symbols, device->identifier, dispatch_streams[0],
         &device->block_pool, host_allocator, &device->tracing_context);
   }
 
@@ -182,7 +219,7 @@ static iree_status_t iree_hal_hip_device_create_internal(
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_hip_allocator_create(
-        symbols, hip_device, dispatch_stream,
+        symbols, hip_device, dispatch_streams[0],
         device->supports_memory_pools ? &device->memory_pools : NULL,
         host_allocator, &device->device_allocator);
   }
@@ -218,28 +255,30 @@ iree_status_t iree_hal_hip_device_create(
     status = IREE_HIP_RESULT_TO_STATUS(symbols, hipCtxSetCurrent(context));
   }
 
-  // Create the default dispatch stream for the device.
-  hipStream_t dispatch_stream = NULL;
-  if (iree_status_is_ok(status)) {
+  // Create the dispatch and callback streams for each queue.
+  hipStream_t dispatch_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT] = {NULL};
+  hipStream_t callback_streams[IREE_HAL_HIP_MAX_QUEUE_COUNT] = {NULL};
+  for (iree_host_size_t i = 0;
+       i < params->queue_count && iree_status_is_ok(status); ++i) {
     status = IREE_HIP_RESULT_TO_STATUS(
         symbols,
-        hipStreamCreateWithFlags(&dispatch_stream, hipStreamNonBlocking));
-  }
-  // Create the default callback stream for the device.
-  hipStream_t callback_stream = NULL;
-  if (iree_status_is_ok(status)) {
-    status = IREE_HIP_RESULT_TO_STATUS(
-        symbols,
-        hipStreamCreateWithFlags(&callback_stream, hipStreamNonBlocking));
+        hipStreamCreateWithFlags(&dispatch_streams[i], hipStreamNonBlocking));
+    if (iree_status_is_ok(status)) {
+      status = IREE_HIP_RESULT_TO_STATUS(
+          symbols,
+          hipStreamCreateWithFlags(&callback_streams[i], hipStreamNonBlocking));
+    }
   }
 
   if (iree_status_is_ok(status)) {
     status = iree_hal_hip_device_create_internal(
-        driver, identifier, params, device, dispatch_stream, callback_stream,
+        driver, identifier, params, device, dispatch_streams, callback_streams,
         context, symbols, host_allocator, out_device);
   } else {
-    if (callback_stream) symbols->hipStreamDestroy(callback_stream);
-    if (dispatch_stream) symbols->hipStreamDestroy(dispatch_stream);
+    for (iree_host_size_t i = 0; i < IREE_HAL_HIP_MAX_QUEUE_COUNT; ++i) {
+      if (callback_streams[i]) symbols->hipStreamDestroy(callback_streams[i]);
+      if (dispatch_streams[i]) symbols->hipStreamDestroy(dispatch_streams[i]);
+    }
     // NOTE: This function return hipSuccess though doesn't release the
     // primaryCtx by design on HIP/HCC path.
     if (context) symbols->hipDevicePrimaryCtxRelease(device);
@@ -304,6 +343,9 @@ static void iree_hal_hip_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_hip_pending_queue_actions_destroy(
       (iree_hal_resource_t*)device->pending_queue_actions);
 
+  // All command buffers have been released and their graph execs returned.
+  iree_hal_hip_graph_exec_cache_free(device->graph_exec_cache);
+
   // There should be no more buffers live that use the allocator.
   iree_hal_allocator_release(device->device_allocator);
 
@@ -321,8 +363,12 @@ static void iree_hal_hip_device_destroy(iree_hal_device_t* base_device) {
   }
   if (device->host_event_pool) iree_event_pool_free(device->host_event_pool);
 
-  IREE_HIP_IGNORE_ERROR(symbols, hipStreamDestroy(device->hip_dispatch_stream));
-  IREE_HIP_IGNORE_ERROR(symbols, hipStreamDestroy(device->hip_callback_stream));
+  for (iree_host_size_t i = 0; i < device->params.queue_count; ++i) {
+    IREE_HIP_IGNORE_ERROR(symbols,
+                          hipStreamDestroy(device->hip_dispatch_streams[i]));
+    IREE_HIP_IGNORE_ERROR(symbols,
+                          hipStreamDestroy(device->hip_callback_streams[i]));
+  }
 
   // NOTE: This function return hipSuccess though doesn't release the
   // primaryCtx by design on HIP/HCC path.
@@ -374,6 +420,9 @@ static iree_status_t iree_hal_hip_device_trim(iree_hal_device_t* base_device) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
   iree_arena_block_pool_trim(&device->block_pool);
   IREE_RETURN_IF_ERROR(iree_hal_allocator_trim(device->device_allocator));
+  if (device->graph_exec_cache) {
+    iree_hal_hip_graph_exec_cache_trim(device->graph_exec_cache);
+  }
   if (device->supports_memory_pools) {
     IREE_RETURN_IF_ERROR(iree_hal_hip_memory_pools_trim(
         &device->memory_pools, &device->params.memory_pools));
@@ -426,13 +475,17 @@ static iree_status_t iree_hal_hip_device_create_channel(
 iree_status_t iree_hal_hip_device_create_stream_command_buffer(
     iree_hal_device_t* base_device, iree_hal_command_buffer_mode_t mode,
     iree_hal_command_category_t command_categories,
-    iree_host_size_t binding_capacity,
+    iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
+  iree_host_size_t queue_index =
+      iree_hal_hip_device_select_queue(device, queue_affinity);
   return iree_hal_hip_stream_command_buffer_create(
-      base_device, device->hip_symbols, device->tracing_context, mode,
-      command_categories, binding_capacity, device->hip_dispatch_stream,
-      &device->block_pool, device->host_allocator, out_command_buffer);
+      base_device, device->hip_symbols,
+      queue_index == 0 ? device->tracing_context : NULL, mode,
+      command_categories, binding_capacity,
+      device->hip_dispatch_streams[queue_index], &device->block_pool,
+      device->host_allocator, out_command_buffer);
 }
 
 static iree_status_t iree_hal_hip_device_create_command_buffer(
@@ -441,6 +494,11 @@ static iree_status_t iree_hal_hip_device_create_command_buffer(
     iree_hal_queue_affinity_t queue_affinity, iree_host_size_t binding_capacity,
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
+  // Command buffers are only traced when recorded for the traced queue.
+  iree_host_size_t queue_index =
+      iree_hal_hip_device_select_queue(device, queue_affinity);
+  iree_hal_hip_tracing_context_t* tracing_context =
+      queue_index == 0 ? device->tracing_context : NULL;
   if (device->params.allow_inline_execution &&
       iree_all_bits_set(mode,
                         IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION)) {
@@ -449,17 +507,18 @@ static iree_status_t iree_hal_hip_device_create_command_buffer(
     // need to be persisted. This lets us lower the execution delay as we can
     // directly route commands to a HIP stream and let it eagerly flush.
     return iree_hal_hip_stream_command_buffer_create(
-        base_device, device->hip_symbols, device->tracing_context, mode,
-        command_categories, binding_capacity, device->hip_dispatch_stream,
-        &device->block_pool, device->host_allocator, out_command_buffer);
+        base_device, device->hip_symbols, tracing_context, mode,
+        command_categories, binding_capacity,
+        device->hip_dispatch_streams[queue_index], &device->block_pool,
+        device->host_allocator, out_command_buffer);
   }
   switch (device->params.command_buffer_mode) {
     case IREE_HAL_HIP_COMMAND_BUFFER_MODE_GRAPH:
       return iree_hal_hip_graph_command_buffer_create(
-          base_device, device->hip_symbols, device->tracing_context,
+          base_device, device->hip_symbols, tracing_context,
           device->hip_context, mode, command_categories, queue_affinity,
-          binding_capacity, &device->block_pool, device->host_allocator,
-          out_command_buffer);
+          binding_capacity, device->graph_exec_cache, &device->block_pool,
+          device->host_allocator, out_command_buffer);
     case IREE_HAL_HIP_COMMAND_BUFFER_MODE_STREAM:
       return iree_hal_deferred_command_buffer_create(
           base_device, mode, command_categories, binding_capacity,
@@ -540,8 +599,6 @@ iree_hal_hip_device_query_semaphore_compatibility(
   return IREE_HAL_SEMAPHORE_COMPATIBILITY_HOST_ONLY;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
 // TODO: implement proper semaphores in HIP to ensure ordering and avoid
 //       the barrier here.
 static iree_status_t iree_hal_hip_device_queue_alloca(
@@ -567,7 +624,10 @@ static iree_status_t iree_hal_hip_device_queue_alloca(
   if (device->supports_memory_pools &&
       !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     status = iree_hal_hip_memory_pools_allocate(
-        &device->memory_pools, device->hip_dispatch_stream, pool, params,
+        &device->memory_pools,
+        device->hip_dispatch_streams[iree_hal_hip_device_select_queue(
+            device, queue_affinity)],
+        pool, params,
         allocation_size, out_buffer);
   } else {
     status = iree_hal_allocator_allocate_buffer(
@@ -584,8 +644,6 @@ static iree_status_t iree_hal_hip_device_queue_alloca(
   return status;
 }
 
-// TODO: implement multiple streams; today we only have one and queue_affinity
-//       is ignored.
 // TODO: implement proper semaphores in HIP to ensure ordering and avoid
 //       the barrier here.
 static iree_status_t iree_hal_hip_device_queue_dealloca(
@@ -606,7 +664,10 @@ static iree_status_t iree_hal_hip_device_queue_dealloca(
   iree_status_t status = iree_ok_status();
   if (device->supports_memory_pools) {
     status = iree_hal_hip_memory_pools_deallocate(
-        &device->memory_pools, device->hip_dispatch_stream, buffer);
+        &device->memory_pools,
+        device->hip_dispatch_streams[iree_hal_hip_device_select_queue(
+            device, queue_affinity)],
+        buffer);
   }
 
   // Only signal if not returning a synchronous error - synchronous failure
@@ -674,9 +735,13 @@ static iree_status_t iree_hal_hip_device_queue_execute(
   iree_hal_hip_device_t* device = iree_hal_hip_device_cast(base_device);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Dependencies on work submitted to other queues are expressed by the wait
+  // semaphores and resolved with hipEvent_ts when issued.
+  iree_host_size_t queue_index =
+      iree_hal_hip_device_select_queue(device, queue_affinity);
   iree_status_t status = iree_hal_hip_pending_queue_actions_enqueue_execution(
-      base_device, device->hip_dispatch_stream, device->hip_callback_stream,
-      device->pending_queue_actions,
+      base_device, queue_affinity, device->hip_dispatch_streams[queue_index],
+      device->hip_callback_streams[queue_index], device->pending_queue_actions,
       iree_hal_hip_device_collect_tracing_context, device->tracing_context,
       wait_semaphore_list, signal_semaphore_list, command_buffer_count,
       command_buffers);
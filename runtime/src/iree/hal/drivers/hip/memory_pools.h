@@ -13,6 +13,7 @@
 #include "iree/hal/drivers/hip/api.h"
 #include "iree/hal/drivers/hip/dynamic_symbols.h"
 #include "iree/hal/drivers/hip/hip_headers.h"
+#include "iree/hal/drivers/hip/transient_heap.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -31,6 +32,9 @@ typedef struct iree_hal_hip_memory_pools_t {
   hipMemPool_t device_local;
   // Used for any host-visible/host-local memory types.
   hipMemPool_t other;
+  // Optional suballocator over a block from |device_local| used for
+  // DEVICE_LOCAL allocations before falling back to the pool.
+  iree_hal_hip_transient_heap_t* transient_heap;
 
   const iree_hal_hip_dynamic_symbols_t* hip_symbols;
   iree_allocator_t host_allocator;
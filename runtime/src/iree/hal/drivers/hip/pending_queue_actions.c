@@ -82,6 +82,8 @@ typedef struct iree_hal_hip_queue_action_t {
   // The device from which to allocate HIP stream-based command buffers for
   // applying deferred command buffers.
   iree_hal_device_t* device;
+  // The queue the action was submitted to.
+  iree_hal_queue_affinity_t queue_affinity;
 
   // The stream to launch main GPU workload.
   hipStream_t dispatch_hip_stream;
@@ -434,8 +436,9 @@ static void iree_hal_hip_free_semaphore_list(
 }
 
 iree_status_t iree_hal_hip_pending_queue_actions_enqueue_execution(
-    iree_hal_device_t* device, hipStream_t dispatch_stream,
-    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    hipStream_t dispatch_stream, hipStream_t callback_stream,
+    iree_hal_hip_pending_queue_actions_t* actions,
     iree_hal_hip_pending_action_cleanup_callback_t cleanup_callback,
     void* callback_user_data,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -457,6 +460,7 @@ iree_status_t iree_hal_hip_pending_queue_actions_enqueue_execution(
   action->callback_user_data = callback_user_data;
   action->kind = IREE_HAL_HIP_QUEUE_ACTION_TYPE_EXECUTION;
   action->device = device;
+  action->queue_affinity = queue_affinity;
   action->dispatch_hip_stream = dispatch_stream;
   action->callback_hip_stream = callback_stream;
 
@@ -636,6 +640,7 @@ static iree_status_t iree_hal_hip_pending_queue_actions_issue_execution(
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_hip_device_create_stream_command_buffer(
                   action->device, mode, IREE_HAL_COMMAND_CATEGORY_ANY,
+                  action->queue_affinity,
                   /*binding_capacity=*/0, &stream_command_buffer));
       IREE_RETURN_AND_END_ZONE_IF_ERROR(
           z0, iree_hal_resource_set_insert(action->resource_set, 1,
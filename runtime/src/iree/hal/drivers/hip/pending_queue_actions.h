@@ -55,11 +55,16 @@ typedef void(IREE_API_PTR* iree_hal_hip_pending_action_cleanup_callback_t)(
 // Enqueues the given list of |command_buffers| that waits on
 // |wait_semaphore_list| and signals |signal_semaphore_lsit|.
 //
+// The command buffers are issued to |dispatch_stream| of the queue selected by
+// |queue_affinity| and completion is reported from |callback_stream|. Waits on
+// work issued to other streams are resolved with hipEvent_ts.
+//
 // |cleanup_callback|, if not NULL, will run after the action completes but
 // before releasing all retained resources.
 iree_status_t iree_hal_hip_pending_queue_actions_enqueue_execution(
-    iree_hal_device_t* device, hipStream_t dispatch_stream,
-    hipStream_t callback_stream, iree_hal_hip_pending_queue_actions_t* actions,
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    hipStream_t dispatch_stream, hipStream_t callback_stream,
+    iree_hal_hip_pending_queue_actions_t* actions,
     iree_hal_hip_pending_action_cleanup_callback_t cleanup_callback,
     void* callback_user_data,
     const iree_hal_semaphore_list_t wait_semaphore_list,
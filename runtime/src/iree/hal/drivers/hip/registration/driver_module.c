@@ -27,6 +27,15 @@ IREE_FLAG_LIST(
 IREE_FLAG(bool, hip_use_streams, true,
           "Use HIP streams (instead of graphs) for executing command buffers.");
 
+IREE_FLAG(int32_t, hip_queue_count, 1,
+          "Number of queues exposed by each HIP device. Each queue is backed\n"
+          "by its own HIP stream such that work submitted with different\n"
+          "queue affinities may execute concurrently.");
+
+IREE_FLAG(int32_t, hip_graph_exec_cache_capacity, 16,
+          "Maximum number of idle instantiated HIP graphs retained for reuse\n"
+          "by command buffers with the same structure. 0 disables reuse.");
+
 IREE_FLAG(bool, hip_allow_inline_execution, false,
           "Allow command buffers to execute inline against HIP streams when \n"
           "possible.");
@@ -35,6 +44,11 @@ IREE_FLAG(
     bool, hip_async_allocations, true,
     "Enables HIP asynchronous stream-ordered allocations when supported.");
 
+IREE_FLAG(int32_t, hip_transient_heap_mb, 0,
+          "Size in MiB of a device-local block suballocated in stream order\n"
+          "for asynchronous allocations. Allocations that do not fit are made\n"
+          "from the HIP memory pool directly. 0 disables suballocation.");
+
 IREE_FLAG(
     bool, hip_tracing, true,
     "Enables tracing of stream events when Tracy instrumentation is enabled.\n"
@@ -67,10 +81,16 @@ static const iree_string_view_t key_hip_dylib_path =
     iree_string_view_literal("hip_dylib_path");
 static const iree_string_view_t key_hip_use_streams =
     iree_string_view_literal("hip_use_streams");
+static const iree_string_view_t key_hip_queue_count =
+    iree_string_view_literal("hip_queue_count");
+static const iree_string_view_t key_hip_graph_exec_cache_capacity =
+    iree_string_view_literal("hip_graph_exec_cache_capacity");
 static const iree_string_view_t key_hip_allow_inline_execution =
     iree_string_view_literal("hip_allow_inline_execution");
 static const iree_string_view_t key_hip_async_allocations =
     iree_string_view_literal("hip_async_allocations");
+static const iree_string_view_t key_hip_transient_heap_mb =
+    iree_string_view_literal("hip_transient_heap_mb");
 static const iree_string_view_t key_hip_tracing =
     iree_string_view_literal("hip_tracing");
 static const iree_string_view_t key_hip_default_index =
@@ -91,11 +111,18 @@ static iree_status_t iree_hal_hip_driver_parse_flags(
   // bool and int flags
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
       builder, key_hip_use_streams, FLAG_hip_use_streams));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_queue_count, FLAG_hip_queue_count));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_graph_exec_cache_capacity,
+      FLAG_hip_graph_exec_cache_capacity));
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
       builder, key_hip_allow_inline_execution,
       FLAG_hip_allow_inline_execution));
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
       builder, key_hip_async_allocations, FLAG_hip_async_allocations));
+  IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
+      builder, key_hip_transient_heap_mb, FLAG_hip_transient_heap_mb));
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
       builder, key_hip_tracing, FLAG_hip_tracing));
   IREE_RETURN_IF_ERROR(iree_string_pair_builder_add_int32(
@@ -156,6 +183,25 @@ static iree_status_t iree_hal_hip_driver_populate_options(
         device_params->command_buffer_mode =
             IREE_HAL_HIP_COMMAND_BUFFER_MODE_STREAM;
       }
+    } else if (iree_string_view_equal(key, key_hip_queue_count)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue <= 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_queue_count' expected to be a positive int. "
+            "Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->queue_count = (iree_host_size_t)ivalue;
+    } else if (iree_string_view_equal(key,
+                                      key_hip_graph_exec_cache_capacity)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue < 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_graph_exec_cache_capacity' expected to be a "
+            "non-negative int. Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->graph_exec_cache_capacity = (iree_host_size_t)ivalue;
     } else if (iree_string_view_equal(key, key_hip_allow_inline_execution)) {
       if (!iree_string_view_atoi_int32(value, &ivalue)) {
         return iree_make_status(
@@ -175,6 +221,16 @@ static iree_status_t iree_hal_hip_driver_populate_options(
             (int)value.size, value.data);
       }
       device_params->async_allocations = ivalue ? true : false;
+    } else if (iree_string_view_equal(key, key_hip_transient_heap_mb)) {
+      if (!iree_string_view_atoi_int32(value, &ivalue) || ivalue < 0) {
+        return iree_make_status(
+            IREE_STATUS_FAILED_PRECONDITION,
+            "Option 'hip_transient_heap_mb' expected to be a non-negative "
+            "int. Got: '%.*s'",
+            (int)value.size, value.data);
+      }
+      device_params->memory_pools.transient_capacity =
+          (uint64_t)ivalue * 1024 * 1024;
     } else if (iree_string_view_equal(key, key_hip_tracing)) {
       if (!iree_string_view_atoi_int32(value, &ivalue)) {
         return iree_make_status(
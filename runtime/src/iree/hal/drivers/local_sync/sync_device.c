@@ -14,12 +14,15 @@
 #include "iree/base/internal/cpu.h"
 #include "iree/hal/drivers/local_sync/sync_event.h"
 #include "iree/hal/drivers/local_sync/sync_semaphore.h"
+#include "iree/hal/local/dispatch_profile.h"
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/inline_command_buffer.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/shm_channel.h"
 #include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
+#include "iree/hal/utils/io_uring_file.h"
 #include "iree/hal/utils/memory_file.h"
 
 typedef struct iree_hal_sync_device_t {
@@ -41,10 +44,24 @@ typedef struct iree_hal_sync_device_t {
   // synchronization ourselves.
   iree_hal_sync_semaphore_state_t semaphore_state;
 
+  // Profile shared with all executables loaded by the device. Dispatches are
+  // recorded while profiling with IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_*.
+  iree_hal_local_dispatch_profile_t* dispatch_profile;
+
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_sync_device_t;
 
+// Additional mode bits used by inline command buffers replaying or recording
+// work that has already been validated or is trusted. Validation is only
+// skipped in release builds so that debug builds still get useful errors.
+#if defined(NDEBUG)
+#define IREE_HAL_SYNC_DEVICE_INLINE_MODE \
+  IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED
+#else
+#define IREE_HAL_SYNC_DEVICE_INLINE_MODE 0
+#endif  // NDEBUG
+
 static const iree_hal_device_vtable_t iree_hal_sync_device_vtable;
 
 static iree_hal_sync_device_t* iree_hal_sync_device_cast(
@@ -110,6 +127,11 @@ iree_status_t iree_hal_sync_device_create(
     iree_hal_sync_semaphore_state_initialize(&device->semaphore_state);
   }
 
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_local_dispatch_profile_create(host_allocator,
+                                                    &device->dispatch_profile);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -129,6 +151,7 @@ static void iree_hal_sync_device_destroy(iree_hal_device_t* base_device) {
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
+  iree_hal_local_dispatch_profile_release(device->dispatch_profile);
 
   iree_hal_allocator_release(device->device_allocator);
   iree_hal_channel_provider_release(device->channel_provider);
@@ -223,8 +246,11 @@ static iree_status_t iree_hal_sync_device_query_i64(
 static iree_status_t iree_hal_sync_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  // Participants are processes on the same host sharing memory.
+  return iree_hal_shm_channel_create(device->channel_provider, queue_affinity,
+                                     params, device->host_allocator,
+                                     out_channel);
 }
 
 static iree_status_t iree_hal_sync_device_create_command_buffer(
@@ -268,6 +294,7 @@ static iree_status_t iree_hal_sync_device_create_executable_cache(
   iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
   return iree_hal_local_executable_cache_create(
       identifier, /*worker_capacity=*/1, device->loader_count, device->loaders,
+      device->dispatch_profile, /*dispatch_counters=*/NULL, loop,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -275,8 +302,12 @@ static iree_status_t iree_hal_sync_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+  if (iree_io_file_handle_type(handle) == IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_hal_io_uring_file_wrap(
+        queue_affinity, access, handle,
+        iree_hal_device_host_allocator(base_device), out_file);
+  } else if (iree_io_file_handle_type(handle) !=
+             IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
     return iree_make_status(
         IREE_STATUS_UNAVAILABLE,
         "implementation does not support the external file type");
@@ -367,7 +398,8 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
       IREE_RETURN_IF_ERROR(iree_hal_inline_command_buffer_initialize(
           (iree_hal_device_t*)device,
           iree_hal_command_buffer_mode(command_buffer) |
-              IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION,
+              IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+              IREE_HAL_SYNC_DEVICE_INLINE_MODE,
           IREE_HAL_COMMAND_CATEGORY_ANY, IREE_HAL_QUEUE_AFFINITY_ANY,
           /*binding_capacity=*/0, device->host_allocator, storage,
           &inline_command_buffer));
@@ -382,6 +414,44 @@ static iree_status_t iree_hal_sync_device_apply_deferred_command_buffers(
   return iree_ok_status();
 }
 
+iree_status_t iree_hal_sync_device_execute_inline(
+    iree_hal_device_t* base_device,
+    iree_hal_command_category_t command_categories,
+    iree_hal_sync_device_record_fn_t record_fn, void* user_data) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(record_fn);
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // The command buffer lives on the stack and is never retained by anything;
+  // commands execute as they are recorded so there's nothing to submit.
+  iree_byte_span_t storage =
+      iree_make_byte_span(iree_alloca(iree_hal_inline_command_buffer_size()),
+                          iree_hal_inline_command_buffer_size());
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_inline_command_buffer_initialize(
+              base_device,
+              IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT |
+                  IREE_HAL_COMMAND_BUFFER_MODE_ALLOW_INLINE_EXECUTION |
+                  IREE_HAL_SYNC_DEVICE_INLINE_MODE,
+              command_categories, IREE_HAL_QUEUE_AFFINITY_ANY,
+              /*binding_capacity=*/0, device->host_allocator, storage,
+              &command_buffer));
+
+  iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = record_fn(user_data, command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+
+  iree_hal_inline_command_buffer_deinitialize(command_buffer);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_sync_device_queue_read(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -471,14 +541,25 @@ static iree_status_t iree_hal_sync_device_wait_semaphores(
 static iree_status_t iree_hal_sync_device_profiling_begin(
     iree_hal_device_t* base_device,
     const iree_hal_device_profiling_options_t* options) {
-  // Unimplemented (and that's ok).
-  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra:
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  // Dispatches run one at a time so their wall time is their cost; we record
+  // it per export for feeding back into the compiler.
+  // We could hook in to vendor APIs (Intel/ARM/etc) or generic perf infra for
+  // more detailed counters:
   // https://man7.org/linux/man-pages/man2/perf_event_open.2.html
   // Capturing things like:
   //   PERF_COUNT_HW_CPU_CYCLES / PERF_COUNT_HW_INSTRUCTIONS
   //   PERF_COUNT_HW_CACHE_REFERENCES / PERF_COUNT_HW_CACHE_MISSES
   //   etc
-  // TODO(benvanik): shared iree/hal/local/profiling implementation of this.
+  const iree_hal_device_profiling_mode_t dispatch_modes =
+      IREE_HAL_DEVICE_PROFILING_MODE_DISPATCH_COUNTERS |
+      IREE_HAL_DEVICE_PROFILING_MODE_EXECUTABLE_COUNTERS;
+  if (iree_any_bit_set(options->mode, dispatch_modes)) {
+    return iree_hal_local_dispatch_profile_begin(
+        device->dispatch_profile,
+        options->file_path ? iree_make_cstring_view(options->file_path)
+                           : iree_string_view_empty());
+  }
   return iree_ok_status();
 }
 
@@ -490,8 +571,8 @@ static iree_status_t iree_hal_sync_device_profiling_flush(
 
 static iree_status_t iree_hal_sync_device_profiling_end(
     iree_hal_device_t* base_device) {
-  // Unimplemented (and that's ok).
-  return iree_ok_status();
+  iree_hal_sync_device_t* device = iree_hal_sync_device_cast(base_device);
+  return iree_hal_local_dispatch_profile_end(device->dispatch_profile);
 }
 
 static const iree_hal_device_vtable_t iree_hal_sync_device_vtable = {
@@ -37,6 +37,26 @@ iree_status_t iree_hal_sync_device_create(
     iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
+// Records commands into |command_buffer| that execute as they are recorded.
+typedef iree_status_t(IREE_API_PTR* iree_hal_sync_device_record_fn_t)(
+    void* user_data, iree_hal_command_buffer_t* command_buffer);
+
+// Executes the commands recorded by |record_fn| immediately on the calling
+// thread. This is a fast path for tiny workloads (such as a single dispatch)
+// issued at high frequency that would otherwise be dominated by command buffer
+// creation and queue submission overheads: the command buffer is an inline
+// command buffer allocated on the stack, no semaphores are involved, and in
+// release builds (NDEBUG) command validation is skipped.
+//
+// |command_buffer| is only valid for the duration of |record_fn| and must not
+// be retained. Any work that depends on prior queue submissions must be waited
+// on by the caller first. Returns the first failure produced while recording.
+//
+// |device| must have been created with iree_hal_sync_device_create.
+iree_status_t iree_hal_sync_device_execute_inline(
+    iree_hal_device_t* device, iree_hal_command_category_t command_categories,
+    iree_hal_sync_device_record_fn_t record_fn, void* user_data);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
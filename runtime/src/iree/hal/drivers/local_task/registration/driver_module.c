@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/drivers/local_task/task_driver.h"
 #include "iree/hal/local/loaders/registration/init.h"
 #include "iree/hal/local/plugins/registration/init.h"
@@ -20,6 +21,19 @@ IREE_FLAG(
     bool, task_abort_on_failure, false,
     "Aborts the program on the first failure within a task system queue.");
 
+IREE_FLAG(
+    string, task_large_pages, "none",
+    "Backs device heap allocations and transient arena blocks with large\n"
+    "pages. One of `none`, `transparent`, `2mb`, or `1gb`. Only allocations\n"
+    "of at least the large page size are affected.");
+
+IREE_FLAG(
+    bool, task_dispatch_counters, false,
+    "Measures each workgroup call with hardware performance counters and\n"
+    "prints per-export calls, time, IPC, and estimated memory bandwidth to\n"
+    "stderr when the device is destroyed. Requires Linux perf_event access\n"
+    "for hardware counters and adds overhead to every call.");
+
 static iree_status_t iree_hal_local_task_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
     const iree_hal_driver_info_t** out_driver_infos) {
@@ -49,10 +63,15 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   if (FLAG_task_abort_on_failure) {
     default_params.queue_scope_flags |= IREE_TASK_SCOPE_FLAG_ABORT_ON_FAILURE;
   }
+  IREE_RETURN_IF_ERROR(iree_memory_large_page_mode_parse(
+      iree_make_cstring_view(FLAG_task_large_pages),
+      &default_params.large_page_mode));
+  default_params.dispatch_counters = FLAG_task_dispatch_counters;
 
   // Create executors for each topology specified by flags.
   // Stack allocated storage today but we can query for the total count and
-  // grow if needed in the future (16 NUMA nodes is enough for anyone, right?).
+  // grow if needed in the future (16 NUMA nodes or cache partitions is enough
+  // for anyone, right?).
   iree_task_executor_t* executor_storage[16] = {NULL};
   iree_task_executor_t** executors = executor_storage;
   iree_host_size_t executor_count = 0;
@@ -74,11 +93,28 @@ static iree_status_t iree_hal_local_task_driver_factory_try_create(
   }
 
   // TODO(benvanik): allow this to be injected to share across drivers.
+  // Each executor services one queue and when they are on different NUMA
+  // nodes buffers are placed on the nodes of the queues they are allocated
+  // for so that workers read local memory.
   iree_hal_allocator_t* device_allocator = NULL;
   if (iree_status_is_ok(status)) {
-    status = iree_hal_allocator_create_heap(iree_make_cstring_view("local"),
-                                            host_allocator, host_allocator,
-                                            &device_allocator);
+    iree_allocator_t data_allocator =
+        default_params.large_page_mode == IREE_MEMORY_LARGE_PAGE_MODE_NONE
+            ? host_allocator
+            : iree_allocator_large_pages(default_params.large_page_mode);
+    uint32_t queue_node_ids[IREE_ARRAYSIZE(executor_storage)];
+    for (iree_host_size_t i = 0; i < executor_count; ++i) {
+      iree_task_topology_node_id_t node_id =
+          iree_task_executor_node_id(executors[i]);
+      queue_node_ids[i] = node_id == IREE_TASK_TOPOLOGY_NODE_ID_ANY
+                              ? IREE_HAL_HEAP_NUMA_NODE_ANY
+                              : node_id;
+    }
+    const iree_host_size_t numa_queue_count =
+        executor_count > 1 ? executor_count : 0;
+    status = iree_hal_allocator_create_heap_numa(
+        iree_make_cstring_view("local"), numa_queue_count, queue_node_ids,
+        data_allocator, host_allocator, &device_allocator);
   }
 
   // Create a task driver that will use the given executors for scheduling work
@@ -16,6 +16,7 @@
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/shm_channel.h"
 #include "iree/hal/utils/resource_set.h"
 #include "iree/task/affinity_set.h"
 #include "iree/task/list.h"
@@ -26,6 +27,87 @@
 // iree_hal_task_command_buffer_t
 //===----------------------------------------------------------------------===//
 
+// Kind of allocation tracked by an iree_hal_task_command_buffer_node_t.
+typedef enum iree_hal_task_command_buffer_node_type_e {
+  // A command struct with an iree_task_t at offset 0.
+  IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK = 0,
+  // An array of iree_task_t* (such as barrier dependent task lists).
+  IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK_LIST,
+  // Plain data with no pointers to other nodes.
+  IREE_HAL_TASK_COMMAND_BUFFER_NODE_DATA,
+} iree_hal_task_command_buffer_node_type_t;
+
+// Header prefixed to every allocation made while recording a reusable command
+// buffer. Allows the recorded DAG to be flattened into a template by mapping
+// any pointer to a node to its offset within the template storage.
+typedef struct iree_hal_task_command_buffer_node_t {
+  struct iree_hal_task_command_buffer_node_t* next;
+  iree_hal_task_command_buffer_node_type_t type;
+  // Offset of the node contents within the template storage.
+  iree_host_size_t offset;
+  // Length of the node contents aligned to iree_max_align_t.
+  iree_host_size_t length;
+} iree_hal_task_command_buffer_node_t;
+
+// Size of the node header including padding to keep the contents aligned.
+#define IREE_HAL_TASK_COMMAND_BUFFER_NODE_HEADER_SIZE          \
+  iree_host_align(sizeof(iree_hal_task_command_buffer_node_t), \
+                  iree_max_align_t)
+
+// A flattened and relocatable copy of the task DAG of a reusable command
+// buffer built once when recording ends. Each issue clones the storage into
+// the submission arena with a single memcpy and rebases the pointers listed in
+// |relocations| such that any number of submissions may be in flight at once
+// without the command buffer needing to track their completion.
+typedef struct iree_hal_task_graph_template_t {
+  // Total size of |storage| in bytes.
+  iree_host_size_t storage_size;
+  // All task nodes with pointers between them stored as storage offsets.
+  uint8_t* storage;
+  // Offsets in |storage| of pointer slots to rebase on each clone.
+  iree_host_size_t relocation_count;
+  iree_host_size_t* relocations;
+  // Offsets in |storage| of the tasks at the root of the DAG.
+  iree_host_size_t root_count;
+  iree_host_size_t* root_offsets;
+  // Offsets in |storage| of the tasks that must complete before the retire
+  // task. Empty if the root tasks are also the leaves.
+  iree_host_size_t leaf_count;
+  iree_host_size_t* leaf_offsets;
+} iree_hal_task_graph_template_t;
+
+// Maximum number of buffer ranges tracked for the commands recorded since the
+// last emitted barrier. Once exceeded barriers are no longer elided until the
+// next one is emitted.
+#define IREE_HAL_TASK_COMMAND_BUFFER_MAX_SCOPE_RANGES 64
+
+// Maximum number of workgroups in dispatches that may be pipelined with
+// IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PIPELINE_WORKGROUPS_V0. Each requires a
+// 4 byte completion flag in the command buffer.
+#define IREE_HAL_TASK_COMMAND_BUFFER_MAX_PIPELINED_WORKGROUPS (64 * 1024)
+
+// Number of tiles dispatches of workgroup range entry points
+// (IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0) are split into when
+// they have enough workgroups. This needs to be large enough that shards can
+// still balance the tiles across workers.
+#define IREE_HAL_TASK_COMMAND_BUFFER_TARGET_WORKGROUP_RANGES 256
+
+// Maximum number of workgroups executed by each call to a workgroup range
+// entry point. Bounds the latency of each tile.
+#define IREE_HAL_TASK_COMMAND_BUFFER_MAX_WORKGROUP_RANGE_SIZE 1024
+
+// A byte range of an allocated buffer accessed by a command.
+typedef struct iree_hal_task_access_range_t {
+  // Allocated buffer the range is within. Distinct allocated buffers are
+  // assumed to not alias.
+  const iree_hal_buffer_t* buffer;
+  // [begin, end) in bytes from the start of |buffer|.
+  iree_device_size_t begin;
+  iree_device_size_t end;
+  // True if the command may write to the range.
+  bool is_write;
+} iree_hal_task_access_range_t;
+
 // iree/task/-based command buffer.
 // We track a minimal amount of state here and incrementally build out the task
 // DAG that we can submit to the task system directly. There's no intermediate
@@ -59,6 +141,16 @@ typedef struct iree_hal_task_command_buffer_t {
   // An empty list indicates that root_tasks are also the leaves.
   iree_task_list_t leaf_tasks;
 
+  // Template the DAG is cloned from on each issue of a reusable command buffer.
+  // NULL for one-shot command buffers, which hand their tasks directly to the
+  // executor.
+  iree_hal_task_graph_template_t* graph_template;
+
+  // Total number of global barriers emitted into the DAG during recording.
+  // Barriers elided by iree_hal_task_command_buffer_track_access aren't
+  // counted.
+  iree_host_size_t barrier_count;
+
   // TODO(benvanik): move this out of the struct and allocate from the arena -
   // we only need this during recording and it's ~4KB of waste otherwise.
   // State tracked within the command buffer during recording only.
@@ -89,10 +181,53 @@ typedef struct iree_hal_task_command_buffer_t {
         binding_lengths[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
                         IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
 
+    // Allocated buffer and absolute offset of each binding in |bindings| used
+    // to determine which ranges dispatches access.
+    const iree_hal_buffer_t*
+        binding_buffers[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                        IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+    iree_device_size_t
+        binding_offsets[IREE_HAL_LOCAL_MAX_DESCRIPTOR_SET_COUNT *
+                        IREE_HAL_LOCAL_MAX_DESCRIPTOR_BINDING_COUNT];
+
+    // True if an execution barrier was requested but has not been emitted.
+    // Barriers are emitted lazily by the next command only if it accesses a
+    // range that conflicts with one accessed by a command recorded since the
+    // last emitted barrier. Commands that don't conflict join the current
+    // synchronization scope and run concurrently with it.
+    bool pending_barrier;
+
+    // Ranges accessed by all commands recorded since the last emitted barrier.
+    // |scope_range_count| is IREE_HOST_SIZE_MAX if there were too many ranges
+    // to track and the next barrier must be emitted.
+    iree_host_size_t scope_range_count;
+    iree_hal_task_access_range_t
+        scope_ranges[IREE_HAL_TASK_COMMAND_BUFFER_MAX_SCOPE_RANGES];
+
+    // Total number of commands recorded since the last emitted barrier.
+    iree_host_size_t scope_command_count;
+
+    // True if a collective was recorded since the last emitted barrier.
+    // Collectives must execute in the order recorded as all ranks need to
+    // perform them in the same order and never share a scope.
+    bool scope_collective;
+
+    // The direct dispatch recorded since the last emitted barrier if it is the
+    // only command. Dispatches that may pipeline their workgroups with it can
+    // replace a pending barrier with per-workgroup dependencies.
+    struct iree_hal_cmd_dispatch_t* scope_dispatch;
+
     // All available push constants updated each time push_constants is called.
     // Reset only with the command buffer and otherwise will maintain its values
     // during recording to allow for partial push_constants updates.
     uint32_t push_constants[IREE_HAL_LOCAL_MAX_PUSH_CONSTANT_COUNT];
+
+    // All nodes allocated while recording a reusable command buffer in
+    // allocation order and the total size they occupy in the template.
+    iree_hal_task_command_buffer_node_t* node_head;
+    iree_hal_task_command_buffer_node_t* node_tail;
+    iree_host_size_t node_count;
+    iree_host_size_t node_storage_size;
   } state;
 } iree_hal_task_command_buffer_t;
 
@@ -115,19 +250,6 @@ iree_status_t iree_hal_task_command_buffer_create(
   IREE_ASSERT_ARGUMENT(out_command_buffer);
   *out_command_buffer = NULL;
 
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
-    // If we want reuse we'd need to support duplicating the task DAG after
-    // recording or have some kind of copy-on-submit behavior that does so if
-    // a command buffer is submitted for execution twice. Allowing for the same
-    // command buffer to be enqueued multiple times would be fine so long as
-    // execution doesn't overlap (`cmdbuf|cmdbuf` vs
-    // `cmdbuf -> semaphore -> cmdbuf`) though we'd still need to be careful
-    // that we did the enqueuing and reset of the task structures at the right
-    // times. Definitely something that'll be useful in the future... but not
-    // today :)
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "only one-shot command buffer usage is supported");
-  }
   if (binding_capacity > 0) {
     // TODO(#10144): support indirect command buffers with binding tables.
     return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
@@ -148,6 +270,7 @@ iree_status_t iree_hal_task_command_buffer_create(
     iree_arena_initialize(block_pool, &command_buffer->arena);
     iree_task_list_initialize(&command_buffer->root_tasks);
     iree_task_list_initialize(&command_buffer->leaf_tasks);
+    command_buffer->barrier_count = 0;
     memset(&command_buffer->state, 0, sizeof(command_buffer->state));
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
@@ -185,12 +308,62 @@ bool iree_hal_task_command_buffer_isa(
                               &iree_hal_task_command_buffer_vtable);
 }
 
+iree_host_size_t iree_hal_task_command_buffer_barrier_count(
+    iree_hal_command_buffer_t* base_command_buffer) {
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  return command_buffer->barrier_count;
+}
+
+static bool iree_hal_task_command_buffer_is_reusable(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  return !iree_all_bits_set(command_buffer->base.mode,
+                            IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+}
+
+// Allocates |length| bytes from the command buffer arena for a task or task
+// list referenced by the DAG. Reusable command buffers track each allocation
+// so that the DAG can be flattened into a template when recording ends.
+static iree_status_t iree_hal_task_command_buffer_allocate_node(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_task_command_buffer_node_type_t type, iree_host_size_t length,
+    void** out_ptr) {
+  if (!iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    return iree_arena_allocate(&command_buffer->arena, length, out_ptr);
+  }
+  const iree_host_size_t header_size =
+      IREE_HAL_TASK_COMMAND_BUFFER_NODE_HEADER_SIZE;
+  const iree_host_size_t aligned_length =
+      iree_host_align(length, iree_max_align_t);
+  uint8_t* storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_arena_allocate(
+      &command_buffer->arena, header_size + aligned_length, (void**)&storage));
+  iree_hal_task_command_buffer_node_t* node =
+      (iree_hal_task_command_buffer_node_t*)storage;
+  node->next = NULL;
+  node->type = type;
+  node->offset = command_buffer->state.node_storage_size;
+  node->length = aligned_length;
+  if (command_buffer->state.node_tail) {
+    command_buffer->state.node_tail->next = node;
+  } else {
+    command_buffer->state.node_head = node;
+  }
+  command_buffer->state.node_tail = node;
+  ++command_buffer->state.node_count;
+  command_buffer->state.node_storage_size += aligned_length;
+  *out_ptr = storage + header_size;
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t recording
 //===----------------------------------------------------------------------===//
 
 static iree_status_t iree_hal_task_command_buffer_flush_tasks(
     iree_hal_task_command_buffer_t* command_buffer);
+static iree_status_t iree_hal_task_command_buffer_build_template(
+    iree_hal_task_command_buffer_t* command_buffer);
 
 static iree_status_t iree_hal_task_command_buffer_begin(
     iree_hal_command_buffer_t* base_command_buffer) {
@@ -222,6 +395,174 @@ static iree_status_t iree_hal_task_command_buffer_end(
 
   iree_hal_resource_set_freeze(command_buffer->resource_set);
 
+  if (iree_hal_task_command_buffer_is_reusable(command_buffer)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_task_command_buffer_build_template(command_buffer));
+  }
+
+  return iree_ok_status();
+}
+
+// Returns the template storage offset of the node containing |ptr|.
+// |ptr| must be the start of a node allocated with
+// iree_hal_task_command_buffer_allocate_node.
+static iree_host_size_t iree_hal_task_command_buffer_node_offset(
+    const void* ptr) {
+  const uint8_t* node_ptr =
+      (const uint8_t*)ptr - IREE_HAL_TASK_COMMAND_BUFFER_NODE_HEADER_SIZE;
+  return ((const iree_hal_task_command_buffer_node_t*)node_ptr)->offset;
+}
+
+// Converts the pointer at |slot_offset| in |storage| to a storage offset and
+// records the slot for relocation. Only counts the slot if |relocations| is
+// NULL.
+static void iree_hal_task_graph_template_add_relocation(
+    uint8_t* storage, iree_host_size_t slot_offset,
+    iree_host_size_t* relocations, iree_host_size_t* relocation_count) {
+  void** slot = (void**)(storage + slot_offset);
+  if (!*slot) return;
+  if (relocations) {
+    *slot = (void*)iree_hal_task_command_buffer_node_offset(*slot);
+    relocations[*relocation_count] = slot_offset;
+  }
+  ++*relocation_count;
+}
+
+// Records all pointer slots within the node at |node_offset| in |storage| that
+// reference other nodes. Only counts them if |relocations| is NULL.
+static void iree_hal_task_graph_template_relocate_node(
+    const iree_hal_task_command_buffer_node_t* node, uint8_t* storage,
+    iree_host_size_t* relocations, iree_host_size_t* relocation_count) {
+  const iree_host_size_t base = node->offset;
+  if (node->type == IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK_LIST) {
+    for (iree_host_size_t i = 0; i < node->length / sizeof(iree_task_t*); ++i) {
+      iree_hal_task_graph_template_add_relocation(
+          storage, base + i * sizeof(iree_task_t*), relocations,
+          relocation_count);
+    }
+    return;
+  }
+
+  // The list link is rebuilt on each issue and any other value is stale.
+  iree_task_t* task = (iree_task_t*)(storage + base);
+  task->next_task = NULL;
+  iree_hal_task_graph_template_add_relocation(
+      storage, base + offsetof(iree_task_t, completion_task), relocations,
+      relocation_count);
+  switch (task->type) {
+    case IREE_TASK_TYPE_CALL:
+      iree_hal_task_graph_template_add_relocation(
+          storage,
+          base + offsetof(iree_task_call_t, closure) +
+              offsetof(iree_task_call_closure_t, user_context),
+          relocations, relocation_count);
+      break;
+    case IREE_TASK_TYPE_BARRIER:
+      iree_hal_task_graph_template_add_relocation(
+          storage, base + offsetof(iree_task_barrier_t, dependent_tasks),
+          relocations, relocation_count);
+      break;
+    case IREE_TASK_TYPE_DISPATCH:
+      // NOTE: indirect workgroup counts point into mapped buffer memory and
+      // are not relocated.
+      iree_hal_task_graph_template_add_relocation(
+          storage,
+          base + offsetof(iree_task_dispatch_t, closure) +
+              offsetof(iree_task_dispatch_closure_t, user_context),
+          relocations, relocation_count);
+      iree_hal_task_graph_template_add_relocation(
+          storage, base + offsetof(iree_task_dispatch_t, tile_consumer),
+          relocations, relocation_count);
+      iree_hal_task_graph_template_add_relocation(
+          storage, base + offsetof(iree_task_dispatch_t, tile_producer),
+          relocations, relocation_count);
+      iree_hal_task_graph_template_add_relocation(
+          storage, base + offsetof(iree_task_dispatch_t, tile_completions),
+          relocations, relocation_count);
+      break;
+    default:
+      break;
+  }
+}
+
+// Flattens the recorded task DAG into |command_buffer|->graph_template.
+// The recorded tasks themselves are never issued and only act as the source
+// of the template.
+static iree_status_t iree_hal_task_command_buffer_build_template(
+    iree_hal_task_command_buffer_t* command_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0,
+                                   (int64_t)command_buffer->state.node_count);
+
+  iree_hal_task_graph_template_t* graph_template = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena, sizeof(*graph_template),
+                              (void**)&graph_template));
+  memset(graph_template, 0, sizeof(*graph_template));
+  graph_template->storage_size = command_buffer->state.node_storage_size;
+  if (graph_template->storage_size > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(&command_buffer->arena,
+                                graph_template->storage_size,
+                                (void**)&graph_template->storage));
+  }
+
+  // Copy all nodes into the storage and count the pointers between them.
+  iree_host_size_t relocation_count = 0;
+  for (iree_hal_task_command_buffer_node_t* node =
+           command_buffer->state.node_head;
+       node != NULL; node = node->next) {
+    memcpy(graph_template->storage + node->offset,
+           (uint8_t*)node + IREE_HAL_TASK_COMMAND_BUFFER_NODE_HEADER_SIZE,
+           node->length);
+    iree_hal_task_graph_template_relocate_node(node, graph_template->storage,
+                                               NULL, &relocation_count);
+  }
+
+  // Convert the pointers to offsets and record where they are.
+  if (relocation_count > 0) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(&command_buffer->arena,
+                                relocation_count * sizeof(iree_host_size_t),
+                                (void**)&graph_template->relocations));
+  }
+  for (iree_hal_task_command_buffer_node_t* node =
+           command_buffer->state.node_head;
+       node != NULL; node = node->next) {
+    iree_hal_task_graph_template_relocate_node(
+        node, graph_template->storage, graph_template->relocations,
+        &graph_template->relocation_count);
+  }
+
+  // Record the tasks at the edges of the DAG.
+  iree_task_list_t* edge_lists[2] = {
+      &command_buffer->root_tasks,
+      &command_buffer->leaf_tasks,
+  };
+  iree_host_size_t* edge_counts[2] = {
+      &graph_template->root_count,
+      &graph_template->leaf_count,
+  };
+  iree_host_size_t** edge_offsets[2] = {
+      &graph_template->root_offsets,
+      &graph_template->leaf_offsets,
+  };
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(edge_lists); ++i) {
+    iree_host_size_t count = iree_task_list_calculate_size(edge_lists[i]);
+    if (count == 0) continue;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_arena_allocate(&command_buffer->arena,
+                                count * sizeof(iree_host_size_t),
+                                (void**)edge_offsets[i]));
+    for (iree_task_t* task = iree_task_list_front(edge_lists[i]); task != NULL;
+         task = task->next_task) {
+      (*edge_offsets[i])[(*edge_counts[i])++] =
+          iree_hal_task_command_buffer_node_offset(task);
+    }
+  }
+
+  command_buffer->graph_template = graph_template;
+  IREE_TRACE_ZONE_END(z0);
   return iree_ok_status();
 }
 
@@ -249,8 +590,9 @@ static iree_status_t iree_hal_task_command_buffer_flush_tasks(
       // Since we couldn't know at the time how many tasks would end up in the
       // barrier we had to defer it until now.
       iree_task_t** dependent_tasks = NULL;
-      IREE_RETURN_IF_ERROR(iree_arena_allocate(
-          &command_buffer->arena, dependent_task_count * sizeof(iree_task_t*),
+      IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+          command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK_LIST,
+          dependent_task_count * sizeof(iree_task_t*),
           (void**)&dependent_tasks));
       iree_task_t* task = task_head;
       for (iree_host_size_t i = 0; i < dependent_task_count; ++i) {
@@ -293,9 +635,11 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   // it so we can setup the join from previous tasks (the first half of the
   // synchronization domain).
   iree_task_barrier_t* barrier = NULL;
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           sizeof(*barrier), (void**)&barrier));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+      command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK, sizeof(*barrier),
+      (void**)&barrier));
   iree_task_barrier_initialize_empty(command_buffer->scope, barrier);
+  ++command_buffer->barrier_count;
 
   // If there were previous tasks then join them to the barrier.
   for (iree_task_t* task = iree_task_list_front(&command_buffer->leaf_tasks);
@@ -325,6 +669,13 @@ static iree_status_t iree_hal_task_command_buffer_emit_global_barrier(
   command_buffer->state.open_barrier = barrier;
   command_buffer->state.open_task_count = 0;
 
+  // Commands recorded after this barrier start a new synchronization scope.
+  command_buffer->state.pending_barrier = false;
+  command_buffer->state.scope_range_count = 0;
+  command_buffer->state.scope_command_count = 0;
+  command_buffer->state.scope_collective = false;
+  command_buffer->state.scope_dispatch = NULL;
+
   return iree_ok_status();
 }
 
@@ -344,10 +695,131 @@ static iree_status_t iree_hal_task_command_buffer_emit_execution_task(
   return iree_ok_status();
 }
 
+// Returns the range of |buffer| accessed by a command.
+static iree_hal_task_access_range_t iree_hal_task_make_access_range(
+    const iree_hal_buffer_t* buffer, iree_device_size_t offset,
+    iree_device_size_t length, bool is_write) {
+  iree_device_size_t begin = iree_hal_buffer_byte_offset(buffer) + offset;
+  iree_hal_task_access_range_t range = {
+      .buffer = iree_hal_buffer_allocated_buffer(buffer),
+      .begin = begin,
+      .end = length == IREE_WHOLE_BUFFER ? IREE_DEVICE_SIZE_MAX
+                                         : begin + length,
+      .is_write = is_write,
+  };
+  return range;
+}
+
+// Returns true if |a| and |b| overlap and at least one of them is a write.
+static bool iree_hal_task_access_ranges_conflict(
+    const iree_hal_task_access_range_t* a,
+    const iree_hal_task_access_range_t* b) {
+  return a->buffer == b->buffer && (a->is_write || b->is_write) &&
+         a->begin < b->end && b->begin < a->end;
+}
+
+// Tracks the |ranges| accessed by a command about to be emitted with
+// iree_hal_task_command_buffer_emit_execution_task. If a barrier is pending
+// it is only emitted if any of |ranges| conflicts with the ranges accessed by
+// commands recorded since the last emitted barrier; otherwise the barrier is
+// elided and the command can execute concurrently with them.
+static iree_status_t iree_hal_task_command_buffer_track_access(
+    iree_hal_task_command_buffer_t* command_buffer, iree_host_size_t count,
+    const iree_hal_task_access_range_t* ranges) {
+  iree_host_size_t scope_range_count = command_buffer->state.scope_range_count;
+  const iree_hal_task_access_range_t* scope_ranges =
+      command_buffer->state.scope_ranges;
+
+  if (command_buffer->state.pending_barrier) {
+    bool has_conflict = scope_range_count == IREE_HOST_SIZE_MAX;
+    for (iree_host_size_t i = 0; i < count && !has_conflict; ++i) {
+      for (iree_host_size_t j = 0; j < scope_range_count; ++j) {
+        if (iree_hal_task_access_ranges_conflict(&ranges[i],
+                                                 &scope_ranges[j])) {
+          has_conflict = true;
+          break;
+        }
+      }
+    }
+    if (has_conflict) {
+      IREE_RETURN_IF_ERROR(
+          iree_hal_task_command_buffer_emit_global_barrier(command_buffer));
+      scope_range_count = 0;
+    }
+    command_buffer->state.pending_barrier = false;
+  }
+
+  // Add the ranges to the current scope, giving up if we run out of space.
+  if (scope_range_count != IREE_HOST_SIZE_MAX) {
+    if (scope_range_count + count >
+        IREE_ARRAYSIZE(command_buffer->state.scope_ranges)) {
+      scope_range_count = IREE_HOST_SIZE_MAX;
+    } else {
+      memcpy(&command_buffer->state.scope_ranges[scope_range_count], ranges,
+             count * sizeof(*ranges));
+      scope_range_count += count;
+    }
+  }
+  command_buffer->state.scope_range_count = scope_range_count;
+  ++command_buffer->state.scope_command_count;
+
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_command_buffer_t execution
 //===----------------------------------------------------------------------===//
 
+// Clones the DAG from |graph_template| into |arena| and enqueues its root tasks
+// into |pending_submission|. The clone is owned by the submission and retires
+// with |retire_task|.
+static iree_status_t iree_hal_task_graph_template_issue(
+    const iree_hal_task_graph_template_t* graph_template,
+    iree_task_t* retire_task, iree_arena_allocator_t* arena,
+    iree_task_submission_t* pending_submission) {
+  // If the command buffer is empty (valid!) then we are a no-op.
+  if (graph_template->root_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Clone and rebase all pointers between tasks.
+  uint8_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(arena, graph_template->storage_size,
+                              (void**)&storage));
+  memcpy(storage, graph_template->storage, graph_template->storage_size);
+  for (iree_host_size_t i = 0; i < graph_template->relocation_count; ++i) {
+    uintptr_t* slot = (uintptr_t*)(storage + graph_template->relocations[i]);
+    *slot += (uintptr_t)storage;
+  }
+
+  // Chain the retire task onto the leaf tasks as their completion indicates
+  // that all commands have completed. If there are no leaf tasks then this is
+  // a single layer DAG and the root tasks are the leaves.
+  iree_host_size_t leaf_count = graph_template->leaf_count;
+  const iree_host_size_t* leaf_offsets = graph_template->leaf_offsets;
+  if (leaf_count == 0) {
+    leaf_count = graph_template->root_count;
+    leaf_offsets = graph_template->root_offsets;
+  }
+  for (iree_host_size_t i = 0; i < leaf_count; ++i) {
+    iree_task_set_completion_task((iree_task_t*)(storage + leaf_offsets[i]),
+                                  retire_task);
+  }
+
+  // Enqueue all root tasks that are ready to run immediately.
+  iree_task_list_t root_tasks;
+  iree_task_list_initialize(&root_tasks);
+  for (iree_host_size_t i = 0; i < graph_template->root_count; ++i) {
+    iree_task_list_push_back(
+        &root_tasks,
+        (iree_task_t*)(storage + graph_template->root_offsets[i]));
+  }
+  iree_task_submission_enqueue_list(pending_submission, &root_tasks);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 iree_status_t iree_hal_task_command_buffer_issue(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_task_queue_state_t* queue_state, iree_task_t* retire_task,
@@ -356,6 +828,12 @@ iree_status_t iree_hal_task_command_buffer_issue(
       iree_hal_task_command_buffer_cast(base_command_buffer);
   IREE_ASSERT_TRUE(command_buffer);
 
+  // Reusable command buffers clone their DAG into the submission arena.
+  if (command_buffer->graph_template) {
+    return iree_hal_task_graph_template_issue(
+        command_buffer->graph_template, retire_task, arena, pending_submission);
+  }
+
   // If the command buffer is empty (valid!) then we are a no-op.
   bool has_root_tasks = !iree_task_list_is_empty(&command_buffer->root_tasks);
   if (!has_root_tasks) {
@@ -421,9 +899,11 @@ static iree_status_t iree_hal_task_command_buffer_execution_barrier(
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
 
-  // TODO(benvanik): actual DAG construction. Right now we are just doing simple
-  // global barriers each time and forcing a join-fork point.
-  return iree_hal_task_command_buffer_emit_global_barrier(command_buffer);
+  // TODO(benvanik): actual DAG construction. Right now we either elide the
+  // barrier or emit a global barrier and force a join-fork point. See
+  // iree_hal_task_command_buffer_track_access.
+  command_buffer->state.pending_barrier = true;
+  return iree_ok_status();
 }
 
 //===----------------------------------------------------------------------===//
@@ -532,8 +1012,9 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
       command_buffer->resource_set, 1, &target_buffer));
 
   iree_hal_cmd_fill_buffer_t* cmd = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+      command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK, sizeof(*cmd),
+      (void**)&cmd));
 
   const uint32_t workgroup_size[3] = {
       /*x=*/IREE_HAL_CMD_FILL_SLICE_LENGTH,
@@ -555,6 +1036,11 @@ static iree_status_t iree_hal_task_command_buffer_fill_buffer(
   memcpy(cmd->pattern, pattern, pattern_length);
   cmd->pattern_length = pattern_length;
 
+  const iree_hal_task_access_range_t range = iree_hal_task_make_access_range(
+      target_buffer, target_offset, length, /*is_write=*/true);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_access(command_buffer, 1, &range));
+
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -597,8 +1083,9 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
       sizeof(iree_hal_cmd_update_buffer_t) + length;
 
   iree_hal_cmd_update_buffer_t* cmd = NULL;
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           total_cmd_size, (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+      command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK, total_cmd_size,
+      (void**)&cmd));
 
   iree_task_call_initialize(
       command_buffer->scope,
@@ -611,6 +1098,11 @@ static iree_status_t iree_hal_task_command_buffer_update_buffer(
   memcpy(cmd->source_buffer, (const uint8_t*)source_buffer + source_offset,
          cmd->length);
 
+  const iree_hal_task_access_range_t range = iree_hal_task_make_access_range(
+      target_buffer, target_offset, length, /*is_write=*/true);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_task_command_buffer_track_access(command_buffer, 1, &range));
+
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -672,8 +1164,9 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
       iree_hal_resource_set_insert(command_buffer->resource_set, 2, buffers));
 
   iree_hal_cmd_copy_buffer_t* cmd = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_arena_allocate(&command_buffer->arena, sizeof(*cmd), (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+      command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK, sizeof(*cmd),
+      (void**)&cmd));
 
   const uint32_t workgroup_size[3] = {
       /*x=*/IREE_HAL_CMD_COPY_SLICE_LENGTH,
@@ -695,6 +1188,15 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
   cmd->target_offset = target_offset;
   cmd->length = length;
 
+  const iree_hal_task_access_range_t ranges[2] = {
+      iree_hal_task_make_access_range(source_buffer, source_offset, length,
+                                      /*is_write=*/false),
+      iree_hal_task_make_access_range(target_buffer, target_offset, length,
+                                      /*is_write=*/true),
+  };
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, IREE_ARRAYSIZE(ranges), ranges));
+
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -703,31 +1205,94 @@ static iree_status_t iree_hal_task_command_buffer_copy_buffer(
 // iree_hal_command_buffer_collective
 //===----------------------------------------------------------------------===//
 
+// NOTE: collectives on shared memory channels block the worker executing them
+// until all participants have reached the same operation. Participants are
+// separate processes and each has its own workers so this cannot deadlock so
+// long as all ranks record collectives in the same order.
+
+typedef struct iree_hal_cmd_collective_t {
+  iree_task_call_t task;
+  iree_hal_channel_t* channel;
+  iree_hal_collective_op_t op;
+  uint32_t param;
+  iree_hal_buffer_binding_t send_binding;
+  iree_hal_buffer_binding_t recv_binding;
+  iree_device_size_t element_count;
+} iree_hal_cmd_collective_t;
+
+static iree_status_t iree_hal_cmd_collective(
+    void* user_context, iree_task_t* task,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_cmd_collective_t* cmd =
+      (const iree_hal_cmd_collective_t*)user_context;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_hal_shm_channel_collective_bindings(
+      cmd->channel, cmd->op, cmd->param, cmd->send_binding, cmd->recv_binding,
+      cmd->element_count);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_task_command_buffer_collective(
     iree_hal_command_buffer_t* base_command_buffer, iree_hal_channel_t* channel,
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  // The channel can be used as a vtable if we want to inject collective APIs -
-  // the device creation function would set up the channel once and we'll
-  // receive it here each time. When interacting with the task system we want to
-  // get wait handles we can model with iree_task_wait_t.
-  //
-  // An example basic flow:
-  //   insert iree_task_call_t:
-  //     chains with prior commands and makes the collective API call
-  //   insert iree_task_wait_t with API wait handle or our event:
-  //     chains with call
-  //
-  // What we probably want to do, though, is group the commands based on
-  // execution barriers. When a new collective command comes in we should
-  // reserve an event from the event pool, create the call to issue the
-  // collective operation, and then track the event in the command buffer state.
-  // When another collective call comes in we'll do the same and append the
-  // event. At the next execution barrier (or non-collective command) we'd
-  // flush to a multi-wait on all of the pending events.
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on the task system");
+  iree_hal_task_command_buffer_t* command_buffer =
+      iree_hal_task_command_buffer_cast(base_command_buffer);
+  if (!iree_hal_shm_channel_isa(channel)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collectives on the task system require a shared "
+                            "memory channel");
+  }
+
+  iree_host_size_t resource_count = 0;
+  void* resources[3] = {NULL, NULL, NULL};
+  resources[resource_count++] = channel;
+  if (send_binding.buffer) resources[resource_count++] = send_binding.buffer;
+  if (recv_binding.buffer) resources[resource_count++] = recv_binding.buffer;
+  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
+      command_buffer->resource_set, resource_count, resources));
+
+  iree_hal_cmd_collective_t* cmd = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+      command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK, sizeof(*cmd),
+      (void**)&cmd));
+
+  iree_task_call_initialize(
+      command_buffer->scope,
+      iree_task_make_call_closure(iree_hal_cmd_collective, (void*)cmd),
+      &cmd->task);
+  cmd->channel = channel;
+  cmd->op = op;
+  cmd->param = param;
+  cmd->send_binding = send_binding;
+  cmd->recv_binding = recv_binding;
+  cmd->element_count = element_count;
+
+  iree_host_size_t range_count = 0;
+  iree_hal_task_access_range_t ranges[2];
+  if (send_binding.buffer) {
+    ranges[range_count++] = iree_hal_task_make_access_range(
+        send_binding.buffer, send_binding.offset, send_binding.length,
+        /*is_write=*/false);
+  }
+  if (recv_binding.buffer) {
+    ranges[range_count++] = iree_hal_task_make_access_range(
+        recv_binding.buffer, recv_binding.offset, recv_binding.length,
+        /*is_write=*/true);
+  }
+  // Force a barrier between collectives even if their ranges don't conflict.
+  if (command_buffer->state.scope_collective) {
+    command_buffer->state.pending_barrier = true;
+    command_buffer->state.scope_range_count = IREE_HOST_SIZE_MAX;
+  }
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, range_count, ranges));
+  command_buffer->state.scope_collective = true;
+
+  return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
+                                                          &cmd->task.header);
 }
 
 //===----------------------------------------------------------------------===//
@@ -799,6 +1364,10 @@ static iree_status_t iree_hal_task_command_buffer_push_descriptor_set(
           buffer_mapping.contents.data;
       command_buffer->state.binding_lengths[binding_ordinal] =
           buffer_mapping.contents.data_length;
+      command_buffer->state.binding_buffers[binding_ordinal] =
+          iree_hal_buffer_allocated_buffer(bindings[i].buffer);
+      command_buffer->state.binding_offsets[binding_ordinal] =
+          iree_hal_buffer_byte_offset(bindings[i].buffer) + bindings[i].offset;
     } else {
       // TODO(#10144): stash indirect binding reference in the state table.
       return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
@@ -826,6 +1395,13 @@ typedef struct iree_hal_cmd_dispatch_t {
   // used (known at compile-time).
   uint16_t binding_count;
 
+  // Number of workgroups executed by each tile of the dispatch or 0 if the
+  // entry point executes a single workgroup per call. When non-zero the task
+  // is a 1D grid of tiles each covering a contiguous range of the linearized
+  // |workgroup_count| workgroups.
+  uint32_t workgroup_range_size;
+  uint32_t workgroup_count[3];
+
   // Following this structure in memory there are 3 tables:
   // - const uint32_t push_constants[push_constant_count];
   // - void* binding_ptrs[binding_count];
@@ -844,14 +1420,17 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   // It'd grow the size of iree_hal_cmd_dispatch_t by a few dozen bytes, though,
   // and so we'd need some profiling to see if it's worth it (fixed command
   // buffer cost vs potential for saving a cache miss or two).
+  const uint32_t* workgroup_count = cmd->workgroup_range_size
+                                        ? cmd->workgroup_count
+                                        : tile_context->workgroup_count;
   iree_alignas(64) iree_hal_executable_dispatch_state_v0_t dispatch_state = {
       .workgroup_size_x = tile_context->workgroup_size[0],
       .workgroup_size_y = tile_context->workgroup_size[1],
       .workgroup_size_z = tile_context->workgroup_size[2],
       .push_constant_count = cmd->push_constant_count,
-      .workgroup_count_x = tile_context->workgroup_count[0],
-      .workgroup_count_y = tile_context->workgroup_count[1],
-      .workgroup_count_z = tile_context->workgroup_count[2],
+      .workgroup_count_x = workgroup_count[0],
+      .workgroup_count_y = workgroup_count[1],
+      .workgroup_count_z = workgroup_count[2],
       .max_concurrency =
           iree_task_affinity_set_count_ones(cmd->task.header.affinity_set),
       .binding_count = cmd->binding_count,
@@ -864,16 +1443,45 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   dispatch_state.binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += cmd->binding_count * sizeof(*dispatch_state.binding_lengths);
 
-  const iree_alignas(64)
-      iree_hal_executable_workgroup_state_v0_t workgroup_state = {
-          .workgroup_id_x = tile_context->workgroup_xyz[0],
-          .workgroup_id_y = tile_context->workgroup_xyz[1],
-          .workgroup_id_z = tile_context->workgroup_xyz[2],
-          .reserved = 0,
-          .processor_id = tile_context->processor_id,
-          .local_memory = tile_context->local_memory.data,
-          .local_memory_size = (size_t)tile_context->local_memory.data_length,
-      };
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = tile_context->workgroup_xyz[0],
+      .workgroup_id_y = tile_context->workgroup_xyz[1],
+      .workgroup_id_z = tile_context->workgroup_xyz[2],
+      .reserved = 0,
+      .processor_id = tile_context->processor_id,
+      .local_memory = tile_context->local_memory.data,
+      .local_memory_size = (size_t)tile_context->local_memory.data_length,
+      .workgroup_range_count = 1,
+      .next_workgroup_id_x = tile_context->next_workgroup_xyz[0],
+      .next_workgroup_id_y = tile_context->next_workgroup_xyz[1],
+      .next_workgroup_id_z = tile_context->next_workgroup_xyz[2],
+      .processor_cluster_id = (uint16_t)iree_min(tile_context->node_id,
+                                                 (uint32_t)UINT16_MAX),
+      .l1_data_cache_size = tile_context->caches.l1_data,
+      .l2_data_cache_size = tile_context->caches.l2_data,
+  };
+  if (cmd->workgroup_range_size) {
+    // Tile X indexes the range of linearized workgroups to execute.
+    const uint32_t workgroup_count_xy = workgroup_count[0] * workgroup_count[1];
+    const uint32_t workgroup_total = workgroup_count_xy * workgroup_count[2];
+    const uint32_t workgroup_begin =
+        tile_context->workgroup_xyz[0] * cmd->workgroup_range_size;
+    workgroup_state.workgroup_id_x = workgroup_begin % workgroup_count[0];
+    workgroup_state.workgroup_id_y =
+        (workgroup_begin / workgroup_count[0]) % workgroup_count[1];
+    workgroup_state.workgroup_id_z =
+        (uint16_t)(workgroup_begin / workgroup_count_xy);
+    workgroup_state.workgroup_range_count = iree_min(
+        cmd->workgroup_range_size, workgroup_total - workgroup_begin);
+    const uint32_t next_workgroup_begin =
+        tile_context->next_workgroup_xyz[0] * cmd->workgroup_range_size;
+    workgroup_state.next_workgroup_id_x =
+        next_workgroup_begin % workgroup_count[0];
+    workgroup_state.next_workgroup_id_y =
+        (next_workgroup_begin / workgroup_count[0]) % workgroup_count[1];
+    workgroup_state.next_workgroup_id_z =
+        (uint16_t)(next_workgroup_begin / workgroup_count_xy);
+  }
   iree_status_t status = iree_hal_local_executable_issue_call(
       cmd->executable, cmd->ordinal, &dispatch_state, &workgroup_state,
       tile_context->worker_id);
@@ -882,10 +1490,53 @@ static iree_status_t iree_hal_cmd_dispatch_tile(
   return status;
 }
 
+// Returns the dispatch that a new dispatch of |entry_point| in
+// |local_executable| with |workgroup_count| can pipeline its workgroups with in
+// place of the pending barrier, or NULL if it must wait on the barrier.
+static iree_hal_cmd_dispatch_t* iree_hal_task_command_buffer_select_producer(
+    iree_hal_task_command_buffer_t* command_buffer,
+    iree_hal_local_executable_t* local_executable, int32_t entry_point,
+    const uint32_t workgroup_count[3]) {
+  // Only useful when there's a barrier to replace and the scope prior to the
+  // barrier contains just the single producer dispatch.
+  if (!command_buffer->state.pending_barrier ||
+      command_buffer->state.scope_command_count != 1) {
+    return NULL;
+  }
+  iree_hal_cmd_dispatch_t* producer_cmd = command_buffer->state.scope_dispatch;
+  if (!producer_cmd) return NULL;
+
+  // The consumer must declare that each of its workgroups only depends on the
+  // workgroup with the same ID in the producer.
+  const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs =
+      local_executable->dispatch_attrs;
+  if (!dispatch_attrs ||
+      !iree_all_bits_set(
+          dispatch_attrs[entry_point].flags,
+          IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PIPELINE_WORKGROUPS_V0)) {
+    return NULL;
+  }
+
+  // Workgroups are matched by ID and the grids must be identical.
+  if (memcmp(producer_cmd->task.workgroup_count.value, workgroup_count,
+             sizeof(producer_cmd->task.workgroup_count.value)) != 0) {
+    return NULL;
+  }
+  uint64_t tile_count = (uint64_t)workgroup_count[0] * workgroup_count[1] *
+                        workgroup_count[2];
+  if (tile_count == 0 ||
+      tile_count > IREE_HAL_TASK_COMMAND_BUFFER_MAX_PIPELINED_WORKGROUPS) {
+    return NULL;
+  }
+
+  return producer_cmd;
+}
+
 static iree_status_t iree_hal_task_command_buffer_build_dispatch(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_executable_t* executable, int32_t entry_point,
     uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z,
+    const iree_hal_task_access_range_t* workgroups_range,
     iree_hal_cmd_dispatch_t** out_cmd) {
   iree_hal_task_command_buffer_t* command_buffer =
       iree_hal_task_command_buffer_cast(base_command_buffer);
@@ -918,8 +1569,9 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       sizeof(*cmd) + push_constant_count * sizeof(uint32_t) +
       used_binding_count * sizeof(void*) +
       used_binding_count * sizeof(iree_device_size_t);
-  IREE_RETURN_IF_ERROR(iree_arena_allocate(&command_buffer->arena,
-                                           total_cmd_size, (void**)&cmd));
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+      command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_TASK, total_cmd_size,
+      (void**)&cmd));
 
   cmd->executable = local_executable;
   cmd->ordinal = entry_point;
@@ -927,12 +1579,38 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   cmd->binding_count = used_binding_count;
 
   const uint32_t workgroup_count[3] = {workgroup_x, workgroup_y, workgroup_z};
+  cmd->workgroup_range_size = 0;
+  memcpy(cmd->workgroup_count, workgroup_count, sizeof(cmd->workgroup_count));
+
+  // Direct dispatches of workgroup range entry points are issued as a 1D grid
+  // of tiles that each execute a range of workgroups. Indirect dispatches only
+  // know their workgroup count at execution time and run a workgroup per tile.
+  uint32_t task_workgroup_count[3] = {workgroup_x, workgroup_y, workgroup_z};
+  const uint64_t workgroup_total =
+      (uint64_t)workgroup_x * workgroup_y * workgroup_z;
+  if (!workgroups_range && local_executable->dispatch_attrs &&
+      iree_all_bits_set(local_executable->dispatch_attrs[entry_point].flags,
+                        IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0) &&
+      (uint64_t)workgroup_x * workgroup_y <= UINT32_MAX &&
+      workgroup_total <= UINT32_MAX) {
+    uint32_t range_size = (uint32_t)(
+        workgroup_total / IREE_HAL_TASK_COMMAND_BUFFER_TARGET_WORKGROUP_RANGES);
+    range_size = iree_max(
+        1u, iree_min(range_size,
+                     IREE_HAL_TASK_COMMAND_BUFFER_MAX_WORKGROUP_RANGE_SIZE));
+    cmd->workgroup_range_size = range_size;
+    task_workgroup_count[0] =
+        (uint32_t)iree_host_size_ceil_div(workgroup_total, range_size);
+    task_workgroup_count[1] = 1;
+    task_workgroup_count[2] = 1;
+  }
+
   // TODO(benvanik): expose on API or keep fixed on executable.
   const uint32_t workgroup_size[3] = {1, 1, 1};
   iree_task_dispatch_initialize(
       command_buffer->scope,
       iree_task_make_dispatch_closure(iree_hal_cmd_dispatch_tile, (void*)cmd),
-      workgroup_size, workgroup_count, &cmd->task);
+      workgroup_size, task_workgroup_count, &cmd->task);
 
   // Tell the task system how much workgroup local memory is required for the
   // dispatch; each invocation of the entry point will have at least as much
@@ -943,6 +1621,13 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
 
+  // Keep workgroups on the same workers across dispatches if requested.
+  if (local_executable->dispatch_attrs &&
+      iree_all_bits_set(local_executable->dispatch_attrs[entry_point].flags,
+                        IREE_HAL_EXECUTABLE_DISPATCH_FLAG_LOCALITY_V0)) {
+    cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_LOCALITY;
+  }
+
   // Copy only the push constant range used by the executable.
   uint8_t* cmd_ptr = (uint8_t*)cmd + sizeof(*cmd);
   uint32_t* push_constants = (uint32_t*)cmd_ptr;
@@ -962,6 +1647,12 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
   cmd_ptr += used_binding_count * sizeof(*binding_ptrs);
   size_t* binding_lengths = (size_t*)cmd_ptr;
   cmd_ptr += used_binding_count * sizeof(*binding_lengths);
+  //
+  // Each binding not declared read-only may be written by the dispatch and
+  // the ranges are tracked to determine whether pending barriers are needed.
+  iree_hal_task_access_range_t ranges[IREE_HAL_LOCAL_BINDING_MASK_BITS + 1];
+  iree_host_size_t range_count = 0;
+  if (workgroups_range) ranges[range_count++] = *workgroups_range;
   iree_host_size_t binding_base = 0;
   for (iree_host_size_t i = 0; i < used_binding_count; ++i) {
     int mask_offset = iree_math_count_trailing_zeros_u64(used_binding_mask);
@@ -974,9 +1665,48 @@ static iree_status_t iree_hal_task_command_buffer_build_dispatch(
       return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
                               "(flat) binding %d is NULL", binding_ordinal);
     }
+    iree_hal_task_access_range_t* range = &ranges[range_count++];
+    range->buffer = command_buffer->state.binding_buffers[binding_ordinal];
+    range->begin = command_buffer->state.binding_offsets[binding_ordinal];
+    range->end = range->begin + binding_lengths[i];
+    range->is_write =
+        !(local_layout->read_only_bindings & (1ull << binding_ordinal));
   }
 
+  // Direct dispatches may pipeline their workgroups with the single dispatch
+  // prior to a pending barrier. The consumer is issued by the producer and
+  // runs in the same synchronization scope so the barrier is dropped.
+  // Tiles of workgroup range dispatches don't map 1:1 to workgroups and can't
+  // be pipelined.
+  iree_hal_cmd_dispatch_t* producer_cmd =
+      workgroups_range || cmd->workgroup_range_size
+          ? NULL
+          : iree_hal_task_command_buffer_select_producer(
+                command_buffer, local_executable, entry_point,
+                workgroup_count);
+  if (producer_cmd) command_buffer->state.pending_barrier = false;
+
+  IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_track_access(
+      command_buffer, range_count, ranges));
+
   *out_cmd = cmd;
+  if (producer_cmd) {
+    iree_host_size_t tile_count =
+        (iree_host_size_t)workgroup_x * workgroup_y * workgroup_z;
+    iree_atomic_int32_t* tile_completions = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_allocate_node(
+        command_buffer, IREE_HAL_TASK_COMMAND_BUFFER_NODE_DATA,
+        tile_count * sizeof(*tile_completions), (void**)&tile_completions));
+    memset(tile_completions, 0, tile_count * sizeof(*tile_completions));
+    iree_task_dispatch_set_tile_consumer(&producer_cmd->task, tile_completions,
+                                         &cmd->task);
+    return iree_ok_status();
+  }
+
+  if (command_buffer->state.scope_command_count == 1 && !workgroups_range &&
+      !cmd->workgroup_range_size) {
+    command_buffer->state.scope_dispatch = cmd;
+  }
   return iree_hal_task_command_buffer_emit_execution_task(command_buffer,
                                                           &cmd->task.header);
 }
@@ -992,7 +1722,7 @@ static iree_status_t iree_hal_task_command_buffer_dispatch(
   iree_hal_cmd_dispatch_t* cmd = NULL;
   return iree_hal_task_command_buffer_build_dispatch(
       base_command_buffer, executable, entry_point, workgroup_x, workgroup_y,
-      workgroup_z, &cmd);
+      workgroup_z, /*workgroups_range=*/NULL, &cmd);
 }
 
 static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
@@ -1014,9 +1744,14 @@ static iree_status_t iree_hal_task_command_buffer_dispatch_indirect(
       IREE_HAL_MEMORY_ACCESS_READ, workgroups_offset, 3 * sizeof(uint32_t),
       &buffer_mapping));
 
+  const iree_hal_task_access_range_t workgroups_range =
+      iree_hal_task_make_access_range(workgroups_buffer, workgroups_offset,
+                                      3 * sizeof(uint32_t),
+                                      /*is_write=*/false);
   iree_hal_cmd_dispatch_t* cmd = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_task_command_buffer_build_dispatch(
-      base_command_buffer, executable, entry_point, 0, 0, 0, &cmd));
+      base_command_buffer, executable, entry_point, 0, 0, 0, &workgroups_range,
+      &cmd));
   cmd->task.workgroup_count.ptr = (const uint32_t*)buffer_mapping.contents.data;
   cmd->task.header.flags |= IREE_TASK_FLAG_DISPATCH_INDIRECT;
   return iree_ok_status();
@@ -30,6 +30,13 @@ iree_status_t iree_hal_task_command_buffer_create(
 bool iree_hal_task_command_buffer_isa(
     iree_hal_command_buffer_t* command_buffer);
 
+// Returns the number of global barriers emitted into the task DAG of
+// |command_buffer| during recording. Execution barriers that were elided
+// because the commands on either side of them access disjoint buffer ranges
+// are not counted. Intended for testing.
+iree_host_size_t iree_hal_task_command_buffer_barrier_count(
+    iree_hal_command_buffer_t* command_buffer);
+
 // Issues a recorded command buffer using the serial |queue_state|.
 // |queue_state| is used to track the synchronization scope of the queue from
 // prior commands such as signaled events and will be mutated as events are
@@ -0,0 +1,768 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_command_buffer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_task/task_device.h"
+#include "iree/hal/local/executable_library.h"
+#include "iree/hal/local/loaders/static_library_loader.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+//===----------------------------------------------------------------------===//
+// Test executable
+//===----------------------------------------------------------------------===//
+
+// Number of int32 elements in each test buffer; each workgroup handles one.
+static constexpr uint32_t kElementCount = 64;
+static constexpr iree_device_size_t kBufferSize =
+    kElementCount * sizeof(int32_t);
+
+// Export ordinals of the test executable.
+enum {
+  // binding[0][x] += 1
+  kAddOneOrdinal = 0,
+  // binding[1][x] += binding[0][x] with binding[0] declared read-only.
+  kAccumulateOrdinal = 1,
+  // atomic binding[0][x] += 1
+  kAtomicAddOneOrdinal = 2,
+};
+
+static int AddOne(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  int32_t* buffer = (int32_t*)dispatch_state->binding_ptrs[0];
+  buffer[workgroup_state->workgroup_id_x] += 1;
+  return 0;
+}
+
+static int Accumulate(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  const int32_t* source = (const int32_t*)dispatch_state->binding_ptrs[0];
+  int32_t* target = (int32_t*)dispatch_state->binding_ptrs[1];
+  const uint32_t x = workgroup_state->workgroup_id_x;
+  target[x] += source[x];
+  return 0;
+}
+
+static int AtomicAddOne(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  iree_atomic_int32_t* buffer =
+      (iree_atomic_int32_t*)dispatch_state->binding_ptrs[0];
+  iree_atomic_fetch_add_int32(&buffer[workgroup_state->workgroup_id_x], 1,
+                              iree_memory_order_relaxed);
+  return 0;
+}
+
+static const iree_hal_executable_library_header_t** TestLibraryQuery(
+    iree_hal_executable_library_version_t max_version,
+    const iree_hal_executable_environment_v0_t* environment) {
+  static const iree_hal_executable_library_header_t header = {
+      /*version=*/IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST,
+      /*name=*/"task_command_buffer_test",
+      /*features=*/IREE_HAL_EXECUTABLE_LIBRARY_FEATURE_NONE,
+      /*sanitizer=*/IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
+  };
+  static const iree_hal_executable_dispatch_v0_t entry_points[] = {
+      AddOne,
+      Accumulate,
+      AtomicAddOne,
+  };
+  static const char* entry_point_names[] = {
+      "add_one",
+      "accumulate",
+      "atomic_add_one",
+  };
+  static iree_hal_executable_library_v0_t library;
+  library.header = &header;
+  library.exports.count = IREE_ARRAYSIZE(entry_points);
+  library.exports.ptrs = entry_points;
+  library.exports.names = entry_point_names;
+  return max_version <= IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST
+             ? (const iree_hal_executable_library_header_t**)&library
+             : NULL;
+}
+
+//===----------------------------------------------------------------------===//
+// Test fixture
+//===----------------------------------------------------------------------===//
+
+class TaskCommandBufferTest : public ::testing::Test {
+ protected:
+  static constexpr iree_host_size_t kQueueCount = 2;
+
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/4,
+                                                   &topology);
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    options.worker_local_memory_size = 64 * 1024;
+    IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                             host_allocator, &executor_));
+    iree_task_topology_deinitialize(&topology);
+
+    const iree_hal_executable_library_query_fn_t library_query_fns[] = {
+        TestLibraryQuery,
+    };
+    iree_hal_executable_loader_t* loader = NULL;
+    IREE_ASSERT_OK(iree_hal_static_library_loader_create(
+        IREE_ARRAYSIZE(library_query_fns), library_query_fns,
+        iree_hal_executable_import_provider_null(), host_allocator, &loader));
+
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator));
+
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    iree_task_executor_t* queue_executors[kQueueCount] = {executor_,
+                                                          executor_};
+    iree_status_t status = iree_hal_task_device_create(
+        iree_make_cstring_view("local-task"), &params, kQueueCount,
+        queue_executors, /*loader_count=*/1, &loader, device_allocator,
+        host_allocator, &device_);
+    iree_hal_allocator_release(device_allocator);
+    iree_hal_executable_loader_release(loader);
+    IREE_ASSERT_OK(status);
+
+    PrepareExecutable();
+  }
+
+  void TearDown() override {
+    iree_hal_executable_release(executable_);
+    for (auto* pipeline_layout : pipeline_layouts_) {
+      iree_hal_pipeline_layout_release(pipeline_layout);
+    }
+    iree_hal_descriptor_set_layout_release(read_write_set_layout_);
+    iree_hal_descriptor_set_layout_release(accumulate_set_layout_);
+    iree_hal_device_release(device_);
+    iree_task_executor_release(executor_);
+  }
+
+  void PrepareExecutable() {
+    const iree_hal_descriptor_set_layout_binding_t read_write_bindings[] = {
+        {0, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_NONE},
+    };
+    IREE_ASSERT_OK(iree_hal_descriptor_set_layout_create(
+        device_, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE,
+        IREE_ARRAYSIZE(read_write_bindings), read_write_bindings,
+        &read_write_set_layout_));
+    const iree_hal_descriptor_set_layout_binding_t accumulate_bindings[] = {
+        {0, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_READ_ONLY},
+        {1, IREE_HAL_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+         IREE_HAL_DESCRIPTOR_FLAG_NONE},
+    };
+    IREE_ASSERT_OK(iree_hal_descriptor_set_layout_create(
+        device_, IREE_HAL_DESCRIPTOR_SET_LAYOUT_FLAG_NONE,
+        IREE_ARRAYSIZE(accumulate_bindings), accumulate_bindings,
+        &accumulate_set_layout_));
+
+    iree_hal_descriptor_set_layout_t* const export_set_layouts[] = {
+        read_write_set_layout_,
+        accumulate_set_layout_,
+        read_write_set_layout_,
+    };
+    for (auto* set_layout : export_set_layouts) {
+      iree_hal_pipeline_layout_t* pipeline_layout = NULL;
+      IREE_ASSERT_OK(iree_hal_pipeline_layout_create(
+          device_, /*push_constants=*/0, /*set_layout_count=*/1, &set_layout,
+          &pipeline_layout));
+      pipeline_layouts_.push_back(pipeline_layout);
+    }
+
+    iree_hal_executable_cache_t* executable_cache = NULL;
+    IREE_ASSERT_OK(iree_hal_executable_cache_create(
+        device_, iree_make_cstring_view("default"),
+        iree_loop_inline(&loop_status_), &executable_cache));
+    iree_hal_executable_params_t executable_params;
+    iree_hal_executable_params_initialize(&executable_params);
+    executable_params.caching_mode =
+        IREE_HAL_EXECUTABLE_CACHING_MODE_ALIAS_PROVIDED_DATA;
+    executable_params.executable_format = iree_make_cstring_view("static");
+    static const char kLibraryName[] = "task_command_buffer_test";
+    executable_params.executable_data = iree_make_const_byte_span(
+        kLibraryName, IREE_ARRAYSIZE(kLibraryName) - 1);
+    executable_params.pipeline_layout_count = pipeline_layouts_.size();
+    executable_params.pipeline_layouts = pipeline_layouts_.data();
+    iree_status_t status = iree_hal_executable_cache_prepare_executable(
+        executable_cache, &executable_params, &executable_);
+    iree_hal_executable_cache_release(executable_cache);
+    IREE_ASSERT_OK(status);
+    IREE_ASSERT_OK(loop_status_);
+  }
+
+  // Allocates a host-visible device buffer filled with |value|.
+  iree_hal_buffer_t* CreateBuffer(int32_t value) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DISPATCH_STORAGE |
+                   IREE_HAL_BUFFER_USAGE_DISPATCH_INDIRECT_PARAMS |
+                   IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device_), params, kBufferSize, &buffer));
+    IREE_CHECK_OK(iree_hal_buffer_map_fill(buffer, 0, kBufferSize,
+                                           &value, sizeof(value)));
+    return buffer;
+  }
+
+  std::vector<int32_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<int32_t> contents(kElementCount);
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, contents.data(), kBufferSize));
+    return contents;
+  }
+
+  // Creates a command buffer that may be submitted multiple times.
+  iree_hal_command_buffer_t* CreateReusableCommandBuffer(
+      iree_hal_command_buffer_mode_t mode = 0) {
+    iree_hal_command_buffer_t* command_buffer = NULL;
+    IREE_CHECK_OK(iree_hal_command_buffer_create(
+        device_, mode,
+        IREE_HAL_COMMAND_CATEGORY_TRANSFER | IREE_HAL_COMMAND_CATEGORY_DISPATCH,
+        IREE_HAL_QUEUE_AFFINITY_ANY, /*binding_capacity=*/0, &command_buffer));
+    return command_buffer;
+  }
+
+  void Barrier(iree_hal_command_buffer_t* command_buffer) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_execution_barrier(
+        command_buffer, IREE_HAL_EXECUTION_STAGE_COMMAND_RETIRE,
+        IREE_HAL_EXECUTION_STAGE_COMMAND_ISSUE,
+        IREE_HAL_EXECUTION_BARRIER_FLAG_NONE, 0, NULL, 0, NULL));
+  }
+
+  void Fill(iree_hal_command_buffer_t* command_buffer,
+            iree_hal_buffer_t* buffer, iree_device_size_t offset,
+            iree_device_size_t length, int32_t value) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_fill_buffer(
+        command_buffer, buffer, offset, length, &value, sizeof(value)));
+  }
+
+  void Copy(iree_hal_command_buffer_t* command_buffer,
+            iree_hal_buffer_t* source_buffer, iree_device_size_t source_offset,
+            iree_hal_buffer_t* target_buffer, iree_device_size_t target_offset,
+            iree_device_size_t length) {
+    IREE_ASSERT_OK(iree_hal_command_buffer_copy_buffer(
+        command_buffer, source_buffer, source_offset, target_buffer,
+        target_offset, length));
+  }
+
+  void Dispatch(iree_hal_command_buffer_t* command_buffer, int32_t ordinal,
+                std::vector<iree_hal_buffer_t*> buffers) {
+    std::vector<iree_hal_descriptor_set_binding_t> bindings(buffers.size());
+    for (size_t i = 0; i < buffers.size(); ++i) {
+      bindings[i].binding = (uint32_t)i;
+      bindings[i].buffer = buffers[i];
+      bindings[i].offset = 0;
+      bindings[i].length = kBufferSize;
+    }
+    IREE_ASSERT_OK(iree_hal_command_buffer_push_descriptor_set(
+        command_buffer, pipeline_layouts_[ordinal], /*set=*/0, bindings.size(),
+        bindings.data()));
+    IREE_ASSERT_OK(iree_hal_command_buffer_dispatch(
+        command_buffer, executable_, ordinal, kElementCount, 1, 1));
+  }
+
+  void DispatchIndirect(iree_hal_command_buffer_t* command_buffer,
+                        int32_t ordinal, iree_hal_buffer_t* buffer,
+                        iree_hal_buffer_t* workgroups_buffer) {
+    iree_hal_descriptor_set_binding_t binding;
+    memset(&binding, 0, sizeof(binding));
+    binding.buffer = buffer;
+    binding.length = kBufferSize;
+    IREE_ASSERT_OK(iree_hal_command_buffer_push_descriptor_set(
+        command_buffer, pipeline_layouts_[ordinal], /*set=*/0, 1, &binding));
+    IREE_ASSERT_OK(iree_hal_command_buffer_dispatch_indirect(
+        command_buffer, executable_, ordinal, workgroups_buffer, 0));
+  }
+
+  // Submits |command_buffer| to the queue selected by |queue_affinity| after
+  // |semaphore| reaches |wait_value| and signals it to |signal_value|.
+  iree_status_t Submit(iree_hal_command_buffer_t* command_buffer,
+                       iree_hal_queue_affinity_t queue_affinity,
+                       iree_hal_semaphore_t* semaphore, uint64_t wait_value,
+                       uint64_t signal_value) {
+    iree_hal_semaphore_list_t wait_semaphores = {
+        /*count=*/1,
+        /*semaphores=*/&semaphore,
+        /*payload_values=*/&wait_value,
+    };
+    iree_hal_semaphore_list_t signal_semaphores = {
+        /*count=*/1,
+        /*semaphores=*/&semaphore,
+        /*payload_values=*/&signal_value,
+    };
+    return iree_hal_device_queue_execute(device_, queue_affinity,
+                                         wait_semaphores, signal_semaphores, 1,
+                                         &command_buffer);
+  }
+
+  iree_task_executor_t* executor_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_status_t loop_status_ = iree_ok_status();
+  iree_hal_descriptor_set_layout_t* read_write_set_layout_ = NULL;
+  iree_hal_descriptor_set_layout_t* accumulate_set_layout_ = NULL;
+  std::vector<iree_hal_pipeline_layout_t*> pipeline_layouts_;
+  iree_hal_executable_t* executable_ = NULL;
+};
+
+//===----------------------------------------------------------------------===//
+// Reusable command buffers
+//===----------------------------------------------------------------------===//
+
+// Tests that a reusable command buffer with multiple barrier-separated stages
+// can be submitted repeatedly and that each submission only retires once all
+// of its stages complete. Each submission is waited on before checking the
+// outputs and issuing the next.
+TEST_F(TaskCommandBufferTest, ReusableSubmitAndWaitRepeatedly) {
+  iree_hal_buffer_t* counter = CreateBuffer(0);
+  iree_hal_buffer_t* sum = CreateBuffer(0);
+
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Dispatch(command_buffer, kAddOneOrdinal, {counter});
+  Barrier(command_buffer);
+  Dispatch(command_buffer, kAccumulateOrdinal, {counter, sum});
+  Barrier(command_buffer);
+  Dispatch(command_buffer, kAddOneOrdinal, {sum});
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  int32_t expected_sum = 0;
+  for (uint64_t i = 1; i <= 8; ++i) {
+    IREE_ASSERT_OK(Submit(command_buffer, IREE_HAL_QUEUE_AFFINITY_ANY,
+                          semaphore, i - 1, i));
+    IREE_ASSERT_OK(
+        iree_hal_semaphore_wait(semaphore, i, iree_infinite_timeout()));
+    expected_sum += (int32_t)i + 1;
+    EXPECT_EQ(ReadBuffer(counter),
+              std::vector<int32_t>(kElementCount, (int32_t)i));
+    EXPECT_EQ(ReadBuffer(sum),
+              std::vector<int32_t>(kElementCount, expected_sum));
+  }
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(sum);
+  iree_hal_buffer_release(counter);
+}
+
+// Tests submitting a reusable command buffer many times back-to-back with each
+// submission waiting on the previous one. If the retire task were chained to
+// the wrong tasks of a clone the next submission would start while the
+// previous one was still accumulating and the sums would be off.
+TEST_F(TaskCommandBufferTest, ReusableSubmitBackToBack) {
+  iree_hal_buffer_t* counter = CreateBuffer(0);
+  iree_hal_buffer_t* sum = CreateBuffer(0);
+
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Dispatch(command_buffer, kAddOneOrdinal, {counter});
+  Barrier(command_buffer);
+  Dispatch(command_buffer, kAccumulateOrdinal, {counter, sum});
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  const uint64_t kSubmissionCount = 64;
+  for (uint64_t i = 1; i <= kSubmissionCount; ++i) {
+    IREE_ASSERT_OK(Submit(command_buffer, IREE_HAL_QUEUE_AFFINITY_ANY,
+                          semaphore, i - 1, i));
+  }
+  IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore, kSubmissionCount,
+                                         iree_infinite_timeout()));
+
+  EXPECT_EQ(ReadBuffer(counter),
+            std::vector<int32_t>(kElementCount, (int32_t)kSubmissionCount));
+  EXPECT_EQ(ReadBuffer(sum),
+            std::vector<int32_t>(
+                kElementCount,
+                (int32_t)(kSubmissionCount * (kSubmissionCount + 1) / 2)));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(sum);
+  iree_hal_buffer_release(counter);
+}
+
+// Tests that a reusable command buffer may have multiple submissions in flight
+// at once across queues. Each submission executes its own clone of the task
+// DAG so all of them must complete and signal independently.
+TEST_F(TaskCommandBufferTest, ReusableSubmitConcurrentlyAcrossQueues) {
+  iree_hal_buffer_t* counter = CreateBuffer(0);
+
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Dispatch(command_buffer, kAtomicAddOneOrdinal, {counter});
+  Barrier(command_buffer);
+  Dispatch(command_buffer, kAtomicAddOneOrdinal, {counter});
+  Barrier(command_buffer);
+  Dispatch(command_buffer, kAtomicAddOneOrdinal, {counter});
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  // Gate all submissions on a single semaphore so that they are issued and
+  // start executing together.
+  iree_hal_semaphore_t* start_semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &start_semaphore));
+  const iree_host_size_t kSubmissionsPerQueue = 8;
+  std::vector<iree_hal_semaphore_t*> semaphores;
+  for (iree_host_size_t i = 0; i < kQueueCount * kSubmissionsPerQueue; ++i) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+    semaphores.push_back(semaphore);
+    uint64_t wait_value = 1ull;
+    uint64_t signal_value = 1ull;
+    iree_hal_semaphore_list_t wait_semaphores = {1, &start_semaphore,
+                                                 &wait_value};
+    iree_hal_semaphore_list_t signal_semaphores = {1, &semaphore,
+                                                   &signal_value};
+    IREE_ASSERT_OK(iree_hal_device_queue_execute(
+        device_, 1ull << (i % kQueueCount), wait_semaphores, signal_semaphores,
+        1, &command_buffer));
+  }
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(start_semaphore, 1ull));
+  for (auto* semaphore : semaphores) {
+    IREE_ASSERT_OK(
+        iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+    iree_hal_semaphore_release(semaphore);
+  }
+
+  EXPECT_EQ(ReadBuffer(counter),
+            std::vector<int32_t>(kElementCount,
+                                 (int32_t)(3 * kQueueCount *
+                                           kSubmissionsPerQueue)));
+
+  iree_hal_semaphore_release(start_semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(counter);
+}
+
+// Tests a reusable command buffer whose DAG has a single layer: the root tasks
+// are also the leaves that the retire task is chained to.
+TEST_F(TaskCommandBufferTest, ReusableSingleLayer) {
+  iree_hal_buffer_t* a = CreateBuffer(0);
+  iree_hal_buffer_t* b = CreateBuffer(10);
+
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Dispatch(command_buffer, kAddOneOrdinal, {a});
+  Dispatch(command_buffer, kAddOneOrdinal, {b});
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  for (uint64_t i = 1; i <= 4; ++i) {
+    IREE_ASSERT_OK(Submit(command_buffer, IREE_HAL_QUEUE_AFFINITY_ANY,
+                          semaphore, i - 1, i));
+  }
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 4ull, iree_infinite_timeout()));
+  EXPECT_EQ(ReadBuffer(a), std::vector<int32_t>(kElementCount, 4));
+  EXPECT_EQ(ReadBuffer(b), std::vector<int32_t>(kElementCount, 14));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(b);
+  iree_hal_buffer_release(a);
+}
+
+//===----------------------------------------------------------------------===//
+// Barrier elision
+//===----------------------------------------------------------------------===//
+
+// Tests that a barrier between writes to overlapping ranges is kept.
+TEST_F(TaskCommandBufferTest, BarrierKeptForOverlappingWrites) {
+  iree_hal_buffer_t* buffer = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Fill(command_buffer, buffer, 0, 128, 1);
+  Barrier(command_buffer);
+  Fill(command_buffer, buffer, 64, 128, 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests that a barrier between writes to disjoint ranges of the same buffer
+// is elided.
+TEST_F(TaskCommandBufferTest, BarrierElidedForDisjointWrites) {
+  iree_hal_buffer_t* buffer = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Fill(command_buffer, buffer, 0, 128, 1);
+  Barrier(command_buffer);
+  Fill(command_buffer, buffer, 128, 128, 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 0);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests that a barrier between a write and a read of an overlapping range is
+// kept while one between two reads of the same range is elided.
+TEST_F(TaskCommandBufferTest, BarrierKeptForReadAfterWrite) {
+  iree_hal_buffer_t* source = CreateBuffer(0);
+  iree_hal_buffer_t* target = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Fill(command_buffer, source, 0, 128, 1);
+  Barrier(command_buffer);
+  // RAW on source[64, 128): kept.
+  Copy(command_buffer, source, 64, target, 0, 64);
+  Barrier(command_buffer);
+  // RAR on source[64, 128) and disjoint writes to target: elided.
+  Copy(command_buffer, source, 64, target, 64, 64);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(target);
+  iree_hal_buffer_release(source);
+}
+
+// Tests that a barrier between a read and a write of an overlapping range is
+// kept.
+TEST_F(TaskCommandBufferTest, BarrierKeptForWriteAfterRead) {
+  iree_hal_buffer_t* source = CreateBuffer(0);
+  iree_hal_buffer_t* target = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Copy(command_buffer, source, 0, target, 0, 64);
+  Barrier(command_buffer);
+  Fill(command_buffer, source, 32, 4, 1);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(target);
+  iree_hal_buffer_release(source);
+}
+
+// Tests that subspans are resolved to their allocated buffer such that
+// overlapping subspan ranges keep the barrier and disjoint ones elide it.
+TEST_F(TaskCommandBufferTest, BarrierTracksAliasedSubspans) {
+  iree_hal_buffer_t* buffer = CreateBuffer(0);
+  iree_hal_buffer_t* lhs = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan(buffer, 0, 128, &lhs));
+  iree_hal_buffer_t* middle = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan(buffer, 64, 128, &middle));
+  iree_hal_buffer_t* rhs = NULL;
+  IREE_ASSERT_OK(iree_hal_buffer_subspan(buffer, 128, 128, &rhs));
+
+  // lhs[64, 128) and middle[0, 64) are the same bytes of |buffer|.
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Fill(command_buffer, lhs, 64, 64, 1);
+  Barrier(command_buffer);
+  Fill(command_buffer, middle, 0, 4, 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+  iree_hal_command_buffer_release(command_buffer);
+
+  // lhs and rhs are disjoint views of |buffer|.
+  command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Fill(command_buffer, lhs, 0, 128, 1);
+  Barrier(command_buffer);
+  Fill(command_buffer, rhs, 0, 128, 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 0);
+  iree_hal_command_buffer_release(command_buffer);
+
+  iree_hal_buffer_release(rhs);
+  iree_hal_buffer_release(middle);
+  iree_hal_buffer_release(lhs);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests that dispatch bindings declared read-only in the layout are tracked as
+// reads: two dispatches reading the same source elide the barrier between them
+// while a dispatch reading what the prior one wrote keeps it.
+TEST_F(TaskCommandBufferTest, BarrierUsesReadOnlyBindings) {
+  iree_hal_buffer_t* a = CreateBuffer(1);
+  iree_hal_buffer_t* b = CreateBuffer(0);
+  iree_hal_buffer_t* c = CreateBuffer(0);
+  iree_hal_buffer_t* d = CreateBuffer(0);
+
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Dispatch(command_buffer, kAccumulateOrdinal, {a, b});
+  Barrier(command_buffer);
+  // Only reads |a| in common with the prior dispatch: elided.
+  Dispatch(command_buffer, kAccumulateOrdinal, {a, c});
+  Barrier(command_buffer);
+  // Reads |c| written by the prior dispatch: kept.
+  Dispatch(command_buffer, kAccumulateOrdinal, {c, d});
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  IREE_ASSERT_OK(
+      Submit(command_buffer, IREE_HAL_QUEUE_AFFINITY_ANY, semaphore, 0, 1));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+  EXPECT_EQ(ReadBuffer(b), std::vector<int32_t>(kElementCount, 1));
+  EXPECT_EQ(ReadBuffer(c), std::vector<int32_t>(kElementCount, 1));
+  EXPECT_EQ(ReadBuffer(d), std::vector<int32_t>(kElementCount, 1));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(d);
+  iree_hal_buffer_release(c);
+  iree_hal_buffer_release(b);
+  iree_hal_buffer_release(a);
+}
+
+// Tests that writable dispatch bindings keep the barrier before a dispatch
+// accessing the same buffer.
+TEST_F(TaskCommandBufferTest, BarrierKeptForWritableBindings) {
+  iree_hal_buffer_t* buffer = CreateBuffer(0);
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  Dispatch(command_buffer, kAddOneOrdinal, {buffer});
+  Barrier(command_buffer);
+  Dispatch(command_buffer, kAddOneOrdinal, {buffer});
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests that the workgroup count buffer of an indirect dispatch is tracked as
+// a read such that a barrier after the command producing it is kept.
+TEST_F(TaskCommandBufferTest, BarrierTracksIndirectWorkgroups) {
+  iree_hal_buffer_t* buffer = CreateBuffer(0);
+  iree_hal_buffer_t* other = CreateBuffer(0);
+  iree_hal_buffer_t* workgroups = CreateBuffer(0);
+  const uint32_t workgroup_count[3] = {kElementCount, 1, 1};
+
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer(
+      // The heap allocator doesn't report indirect parameter buffers as
+      // dispatch compatible.
+      IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED);
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  IREE_ASSERT_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, workgroup_count, 0, workgroups, 0,
+      sizeof(workgroup_count)));
+  Barrier(command_buffer);
+  // Reads the workgroup count written by the prior update: kept.
+  DispatchIndirect(command_buffer, kAddOneOrdinal, buffer, workgroups);
+  Barrier(command_buffer);
+  // Reads the workgroup count also read by the prior dispatch: elided.
+  DispatchIndirect(command_buffer, kAddOneOrdinal, other, workgroups);
+  Barrier(command_buffer);
+  // Overwrites the workgroup count read by the prior dispatches: kept.
+  IREE_ASSERT_OK(iree_hal_command_buffer_update_buffer(
+      command_buffer, workgroup_count, 0, workgroups, 0,
+      sizeof(workgroup_count)));
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 2);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  IREE_ASSERT_OK(
+      Submit(command_buffer, IREE_HAL_QUEUE_AFFINITY_ANY, semaphore, 0, 1));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+  EXPECT_EQ(ReadBuffer(buffer), std::vector<int32_t>(kElementCount, 1));
+  EXPECT_EQ(ReadBuffer(other), std::vector<int32_t>(kElementCount, 1));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(workgroups);
+  iree_hal_buffer_release(other);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests that once more ranges are accessed in a scope than can be tracked the
+// next barrier is kept even if the commands after it don't conflict.
+TEST_F(TaskCommandBufferTest, BarrierKeptWhenScopeRangesOverflow) {
+  // Scopes are limited to IREE_HAL_TASK_COMMAND_BUFFER_MAX_SCOPE_RANGES.
+  const iree_host_size_t kMaxScopeRanges = 64;
+  iree_hal_buffer_t* scope_buffer = CreateBuffer(0);
+  iree_hal_buffer_t* overflow_buffer = CreateBuffer(0);
+  iree_hal_buffer_t* other_buffer = CreateBuffer(0);
+  static_assert(kElementCount == kMaxScopeRanges,
+                "one element per range in |scope_buffer|");
+
+  // Exactly the maximum number of ranges are tracked: elided.
+  iree_hal_command_buffer_t* command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  for (iree_host_size_t i = 0; i < kMaxScopeRanges; ++i) {
+    Fill(command_buffer, scope_buffer, i * sizeof(int32_t), sizeof(int32_t),
+         (int32_t)i);
+  }
+  Barrier(command_buffer);
+  Fill(command_buffer, other_buffer, 0, kBufferSize, 1);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 0);
+  iree_hal_command_buffer_release(command_buffer);
+
+  // One more range than can be tracked: kept.
+  command_buffer = CreateReusableCommandBuffer();
+  IREE_ASSERT_OK(iree_hal_command_buffer_begin(command_buffer));
+  for (iree_host_size_t i = 0; i < kMaxScopeRanges; ++i) {
+    Fill(command_buffer, scope_buffer, i * sizeof(int32_t), sizeof(int32_t),
+         (int32_t)i);
+  }
+  Fill(command_buffer, overflow_buffer, 0, kBufferSize, 1);
+  Barrier(command_buffer);
+  Fill(command_buffer, other_buffer, 0, kBufferSize, 1);
+  // Tracking resumes in the scope started by the kept barrier.
+  Barrier(command_buffer);
+  Fill(command_buffer, overflow_buffer, 0, kBufferSize, 2);
+  IREE_ASSERT_OK(iree_hal_command_buffer_end(command_buffer));
+  EXPECT_EQ(iree_hal_task_command_buffer_barrier_count(command_buffer), 1);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  IREE_ASSERT_OK(
+      Submit(command_buffer, IREE_HAL_QUEUE_AFFINITY_ANY, semaphore, 0, 1));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, 1ull, iree_infinite_timeout()));
+  std::vector<int32_t> expected_scope(kElementCount);
+  for (uint32_t i = 0; i < kElementCount; ++i) expected_scope[i] = (int32_t)i;
+  EXPECT_EQ(ReadBuffer(scope_buffer), expected_scope);
+  EXPECT_EQ(ReadBuffer(overflow_buffer),
+            std::vector<int32_t>(kElementCount, 2));
+  EXPECT_EQ(ReadBuffer(other_buffer), std::vector<int32_t>(kElementCount, 1));
+
+  iree_hal_semaphore_release(semaphore);
+  iree_hal_command_buffer_release(command_buffer);
+  iree_hal_buffer_release(other_buffer);
+  iree_hal_buffer_release(overflow_buffer);
+  iree_hal_buffer_release(scope_buffer);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -12,6 +12,7 @@
 
 #include "iree/base/internal/arena.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/base/internal/math.h"
 #include "iree/hal/drivers/local_task/task_command_buffer.h"
 #include "iree/hal/drivers/local_task/task_event.h"
 #include "iree/hal/drivers/local_task/task_queue.h"
@@ -19,7 +20,9 @@
 #include "iree/hal/local/executable_environment.h"
 #include "iree/hal/local/local_executable_cache.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/shm_channel.h"
 #include "iree/hal/utils/file_transfer.h"
+#include "iree/hal/utils/io_uring_file.h"
 #include "iree/hal/utils/memory_file.h"
 
 typedef struct iree_hal_task_device_t {
@@ -42,6 +45,9 @@ typedef struct iree_hal_task_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Optional per-export counters shared with all executables loaded.
+  iree_hal_local_dispatch_counters_t* dispatch_counters;
+
   iree_host_size_t queue_count;
   iree_hal_task_queue_t queues[];
 } iree_hal_task_device_t;
@@ -57,7 +63,9 @@ static iree_hal_task_device_t* iree_hal_task_device_cast(
 void iree_hal_task_device_params_initialize(
     iree_hal_task_device_params_t* out_params) {
   out_params->arena_block_size = 32 * 1024;
+  out_params->large_page_mode = IREE_MEMORY_LARGE_PAGE_MODE_NONE;
   out_params->queue_scope_flags = IREE_TASK_SCOPE_FLAG_NONE;
+  out_params->dispatch_counters = false;
 }
 
 static iree_status_t iree_hal_task_device_check_params(
@@ -117,8 +125,12 @@ iree_status_t iree_hal_task_device_create(
 
     iree_arena_block_pool_initialize(4096, host_allocator,
                                      &device->small_block_pool);
-    iree_arena_block_pool_initialize(params->arena_block_size, host_allocator,
-                                     &device->large_block_pool);
+    iree_arena_block_pool_initialize(
+        params->arena_block_size,
+        params->large_page_mode == IREE_MEMORY_LARGE_PAGE_MODE_NONE
+            ? host_allocator
+            : iree_allocator_large_pages(params->large_page_mode),
+        &device->large_block_pool);
 
     device->loader_count = loader_count;
     device->loaders =
@@ -138,6 +150,17 @@ iree_status_t iree_hal_task_device_create(
     }
   }
 
+  if (iree_status_is_ok(status) && params->dispatch_counters) {
+    // Sized to match the executable caches. Worker IDs are local to each
+    // executor and counters are only reliable with a single queue executor.
+    iree_host_size_t total_worker_count = 0;
+    for (iree_host_size_t i = 0; i < queue_count; ++i) {
+      total_worker_count += iree_task_executor_worker_count(queue_executors[i]);
+    }
+    status = iree_hal_local_dispatch_counters_create(
+        total_worker_count, host_allocator, &device->dispatch_counters);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_device = (iree_hal_device_t*)device;
   } else {
@@ -156,6 +179,13 @@ static void iree_hal_task_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_task_queue_deinitialize(&device->queues[i]);
   }
 
+  if (device->dispatch_counters) {
+    // All work has completed and the counters are final.
+    iree_status_ignore(iree_hal_local_dispatch_counters_fprint(
+        stderr, device->dispatch_counters));
+    iree_hal_local_dispatch_counters_release(device->dispatch_counters);
+  }
+
   for (iree_host_size_t i = 0; i < device->loader_count; ++i) {
     iree_hal_executable_loader_release(device->loaders[i]);
   }
@@ -273,17 +303,22 @@ static iree_host_size_t iree_hal_task_device_select_queue(
     iree_hal_task_device_t* device,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(benvanik): evaluate if we want to obscure this mapping a bit so that
-  // affinity really means "equivalent affinities map to equivalent queues" and
-  // not a specific queue index.
-  return queue_affinity % device->queue_count;
+  // Bit N of the affinity selects queue N % queue_count, matching how the
+  // device heap allocator places buffers on the NUMA nodes of the queues. Work
+  // for multiple queues goes to the first.
+  if (!queue_affinity) return 0;
+  return iree_math_count_trailing_zeros_u64(queue_affinity) %
+         device->queue_count;
 }
 
 static iree_status_t iree_hal_task_device_create_channel(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_channel_params_t params, iree_hal_channel_t** out_channel) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not implemented");
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  // Participants are processes on the same host sharing memory.
+  return iree_hal_shm_channel_create(device->channel_provider, queue_affinity,
+                                     params, device->host_allocator,
+                                     out_channel);
 }
 
 static iree_status_t iree_hal_task_device_create_command_buffer(
@@ -317,6 +352,96 @@ static iree_status_t iree_hal_task_device_create_event(
                                     out_event);
 }
 
+typedef struct iree_hal_task_device_loop_closure_t {
+  iree_loop_t loop;
+  const iree_loop_dispatch_params_t* params;
+} iree_hal_task_device_loop_closure_t;
+
+static iree_status_t iree_hal_task_device_loop_dispatch_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_task_device_loop_closure_t* closure =
+      (const iree_hal_task_device_loop_closure_t*)user_context;
+  return closure->params->workgroup_fn(
+      closure->params->callback.user_data, closure->loop,
+      tile_context->workgroup_xyz[0], tile_context->workgroup_xyz[1],
+      tile_context->workgroup_xyz[2]);
+}
+
+// Runs the dispatch described by |params| across the workers of |executor| and
+// issues the completion callback once all workgroups have finished.
+static iree_status_t iree_hal_task_device_loop_dispatch(
+    iree_task_executor_t* executor, iree_loop_t loop,
+    const iree_loop_dispatch_params_t* params) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(IREE_SV("iree_hal_task_device_loop"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  iree_hal_task_device_loop_closure_t closure = {
+      .loop = loop,
+      .params = params,
+  };
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(iree_hal_task_device_loop_dispatch_tile,
+                                      &closure),
+      workgroup_size, params->workgroup_count_xyz, &dispatch_task);
+
+  iree_task_fence_t* fence = NULL;
+  iree_status_t status =
+      iree_task_executor_acquire_fence(executor, &scope, &fence);
+  if (iree_status_is_ok(status)) {
+    iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_task.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    status = iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_task_scope_consume_status(&scope);
+  }
+  iree_task_scope_deinitialize(&scope);
+
+  // The completion callback is always issued and takes ownership of |status|.
+  status = params->callback.fn(params->callback.user_data, loop, status);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Loop used by executable caches to parallelize host-side work (such as
+// loading batches of executables) across the device task executor.
+// Dispatches block the caller until they complete; other commands are not
+// used by the caches and are unimplemented.
+static iree_status_t iree_hal_task_device_loop_ctl(void* self,
+                                                   iree_loop_command_t command,
+                                                   const void* params,
+                                                   void** inout_ptr) {
+  iree_task_executor_t* executor = (iree_task_executor_t*)self;
+  iree_loop_t loop = {
+      .self = self,
+      .ctl = iree_hal_task_device_loop_ctl,
+  };
+  switch (command) {
+    case IREE_LOOP_COMMAND_DISPATCH:
+      return iree_hal_task_device_loop_dispatch(
+          executor, loop, (const iree_loop_dispatch_params_t*)params);
+    case IREE_LOOP_COMMAND_DRAIN:
+      // Dispatches complete before they return so there is nothing to drain.
+      return iree_ok_status();
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "unsupported task device loop command %u",
+                              command);
+  }
+}
+
 static iree_status_t iree_hal_task_device_create_executable_cache(
     iree_hal_device_t* base_device, iree_string_view_t identifier,
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
@@ -330,8 +455,20 @@ static iree_status_t iree_hal_task_device_create_executable_cache(
         iree_task_executor_worker_count(device->queues[i].executor);
   }
 
+  // Executables are loaded on the first queue executor. The executor lives as
+  // long as the device and executable caches must not outlive the device that
+  // created them.
+  iree_loop_t executor_loop = {
+      .self = device->queues[0].executor,
+      .ctl = iree_hal_task_device_loop_ctl,
+  };
+
+  // NOTE: dispatch profiles are only captured by the local-sync device as here
+  // workgroups of concurrent dispatches are interleaved across workers.
+  // Dispatch counters are measured per worker and are not affected.
   return iree_hal_local_executable_cache_create(
       identifier, total_worker_count, device->loader_count, device->loaders,
+      /*dispatch_profile=*/NULL, device->dispatch_counters, executor_loop,
       iree_hal_device_host_allocator(base_device), out_executable_cache);
 }
 
@@ -339,8 +476,12 @@ static iree_status_t iree_hal_task_device_import_file(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     iree_hal_memory_access_t access, iree_io_file_handle_t* handle,
     iree_hal_external_file_flags_t flags, iree_hal_file_t** out_file) {
-  if (iree_io_file_handle_type(handle) !=
-      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+  if (iree_io_file_handle_type(handle) == IREE_IO_FILE_HANDLE_TYPE_FD) {
+    return iree_hal_io_uring_file_wrap(
+        queue_affinity, access, handle,
+        iree_hal_device_host_allocator(base_device), out_file);
+  } else if (iree_io_file_handle_type(handle) !=
+             IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
     return iree_make_status(
         IREE_STATUS_UNAVAILABLE,
         "implementation does not support the external file type");
@@ -483,10 +624,8 @@ static iree_status_t iree_hal_task_device_wait_semaphores(
     iree_hal_device_t* base_device, iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout) {
   iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
-  return iree_hal_task_semaphore_multi_wait(
-      wait_mode, semaphore_list, timeout,
-      iree_hal_task_device_shared_event_pool(device),
-      &device->large_block_pool);
+  return iree_hal_task_semaphore_multi_wait(wait_mode, semaphore_list, timeout,
+                                            &device->large_block_pool);
 }
 
 static iree_status_t iree_hal_task_device_profiling_begin(
@@ -515,6 +654,89 @@ static iree_status_t iree_hal_task_device_profiling_end(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// User task submission
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_task_device_query_executor(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_executor_t** out_executor) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  IREE_ASSERT_ARGUMENT(out_executor);
+  *out_executor = NULL;
+  if (!iree_hal_resource_is(base_device, &iree_hal_task_device_vtable)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "device is not a local-task device");
+  }
+  iree_hal_task_device_t* device = iree_hal_task_device_cast(base_device);
+  iree_host_size_t queue_index = iree_hal_task_device_select_queue(
+      device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
+  *out_executor = device->queues[queue_index].executor;
+  return iree_ok_status();
+}
+
+iree_hal_local_dispatch_counters_t*
+iree_hal_task_device_query_dispatch_counters(iree_hal_device_t* base_device) {
+  IREE_ASSERT_ARGUMENT(base_device);
+  if (!iree_hal_resource_is(base_device, &iree_hal_task_device_vtable)) {
+    return NULL;
+  }
+  return iree_hal_task_device_cast(base_device)->dispatch_counters;
+}
+
+// A user call task allocated from the device host allocator and freed when the
+// task is cleaned up.
+typedef struct iree_hal_task_device_call_t {
+  iree_task_call_t task;
+  iree_allocator_t host_allocator;
+} iree_hal_task_device_call_t;
+
+static void iree_hal_task_device_call_cleanup(iree_task_t* task,
+                                              iree_status_code_t status_code) {
+  iree_hal_task_device_call_t* call = (iree_hal_task_device_call_t*)task;
+  iree_allocator_free(call->host_allocator, call);
+}
+
+iree_status_t iree_hal_task_device_submit_call(
+    iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_scope_t* scope, iree_task_call_closure_t closure) {
+  IREE_ASSERT_ARGUMENT(scope);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_task_executor_t* executor = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_task_device_query_executor(base_device, queue_affinity,
+                                              &executor));
+
+  iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
+  iree_hal_task_device_call_t* call = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*call), (void**)&call));
+  call->host_allocator = host_allocator;
+  iree_task_call_initialize(scope, closure, &call->task);
+  iree_task_set_cleanup_fn(&call->task.header,
+                           iree_hal_task_device_call_cleanup);
+
+  // The fence keeps the scope from going idle until the call has retired and
+  // its storage has been released by the cleanup function.
+  iree_task_fence_t* fence = NULL;
+  iree_status_t status =
+      iree_task_executor_acquire_fence(executor, scope, &fence);
+  if (iree_status_is_ok(status)) {
+    iree_task_set_completion_task(&call->task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call->task.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+  } else {
+    iree_allocator_free(host_allocator, call);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static const iree_hal_device_vtable_t iree_hal_task_device_vtable = {
     .destroy = iree_hal_task_device_destroy,
     .id = iree_hal_task_device_id,
@@ -8,7 +8,9 @@
 #define IREE_HAL_DRIVERS_LOCAL_TASK_TASK_DEVICE_H_
 
 #include "iree/base/api.h"
+#include "iree/base/internal/memory.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/dispatch_counters.h"
 #include "iree/hal/local/executable_loader.h"
 #include "iree/task/executor.h"
 
@@ -23,8 +25,18 @@ typedef struct iree_hal_task_device_params_t {
   // Larger sizes will lower overhead and ensure the heap isn't hit for
   // transient allocations while also increasing memory consumption.
   iree_host_size_t arena_block_size;
+  // Controls whether arena blocks are backed by large pages. Only blocks of at
+  // least the large page size benefit and |arena_block_size| should be raised
+  // accordingly (2MB for most systems).
+  iree_memory_large_page_mode_t large_page_mode;
   // Default flags for the iree_task_scope_t used for each queue.
   iree_task_scope_flags_t queue_scope_flags;
+  // Measures every workgroup call with hardware performance counters and
+  // aggregates them by executable export. Adds a syscall pair per call and
+  // should only be enabled while diagnosing. Per-export counters are printed
+  // to stderr when the device is destroyed and can be queried with
+  // iree_hal_task_device_query_dispatch_counters.
+  bool dispatch_counters;
 } iree_hal_task_device_params_t;
 
 // Initializes |out_params| to default values.
@@ -48,6 +60,35 @@ iree_status_t iree_hal_task_device_create(
     iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_device_t** out_device);
 
+// Returns the task executor servicing the queue selected by |queue_affinity|
+// on the local-task |device|. The executor is not retained and is only valid
+// for the lifetime of the device. Applications may submit their own tasks to
+// the executor to share its workers with the device instead of running their
+// own thread pools that would oversubscribe the same cores.
+iree_status_t iree_hal_task_device_query_executor(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_executor_t** out_executor);
+
+// Submits |closure| to run as an IREE_TASK_TYPE_CALL on the task executor
+// servicing the queue selected by |queue_affinity| on the local-task |device|.
+// The call runs on the same workers as the device work and may execute
+// concurrently with it. Calls may enqueue additional tasks in the submission
+// they are provided as with any other call task.
+//
+// Completion and failure are tracked by |scope|: callers can wait for all
+// calls submitted with the scope using iree_task_scope_wait_idle and retrieve
+// any failure with iree_task_scope_consume_status. The device and |scope| must
+// remain valid until the scope is idle.
+iree_status_t iree_hal_task_device_submit_call(
+    iree_hal_device_t* device, iree_hal_queue_affinity_t queue_affinity,
+    iree_task_scope_t* scope, iree_task_call_closure_t closure);
+
+// Returns the per-export dispatch counters of the local-task |device| or NULL
+// if the device was not created with dispatch counters enabled. The counters
+// are not retained and are only valid for the lifetime of the device.
+iree_hal_local_dispatch_counters_t*
+iree_hal_task_device_query_dispatch_counters(iree_hal_device_t* device);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,126 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_device.h"
+
+#include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/hal/api.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class TaskDeviceTest : public ::testing::Test {
+ protected:
+  static constexpr iree_host_size_t kQueueCount = 2;
+
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+
+    // Each queue gets its own executor so that queries can be distinguished.
+    for (iree_host_size_t i = 0; i < kQueueCount; ++i) {
+      iree_task_topology_t topology;
+      iree_task_topology_initialize_from_group_count(/*group_count=*/2,
+                                                     &topology);
+      iree_task_executor_options_t options;
+      iree_task_executor_options_initialize(&options);
+      IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                               host_allocator, &executors_[i]));
+      iree_task_topology_deinitialize(&topology);
+    }
+
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator));
+    iree_hal_task_device_params_t params;
+    iree_hal_task_device_params_initialize(&params);
+    iree_status_t status = iree_hal_task_device_create(
+        iree_make_cstring_view("local-task"), &params, kQueueCount, executors_,
+        /*loader_count=*/0, /*loaders=*/NULL, device_allocator,
+        host_allocator, &device_);
+    iree_hal_allocator_release(device_allocator);
+    IREE_ASSERT_OK(status);
+
+    iree_task_scope_initialize(iree_make_cstring_view("user"),
+                               IREE_TASK_SCOPE_FLAG_NONE, &scope_);
+  }
+
+  void TearDown() override {
+    IREE_EXPECT_OK(
+        iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+    iree_task_scope_deinitialize(&scope_);
+    iree_hal_device_release(device_);
+    for (iree_host_size_t i = 0; i < kQueueCount; ++i) {
+      iree_task_executor_release(executors_[i]);
+    }
+  }
+
+  iree_task_executor_t* executors_[kQueueCount] = {NULL};
+  iree_hal_device_t* device_ = NULL;
+  iree_task_scope_t scope_;
+};
+
+// Tests that each queue affinity maps to the executor servicing that queue.
+TEST_F(TaskDeviceTest, QueryExecutor) {
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_task_device_query_executor(device_, 1ull << 0, &executor));
+  EXPECT_EQ(executor, executors_[0]);
+  IREE_ASSERT_OK(
+      iree_hal_task_device_query_executor(device_, 1ull << 1, &executor));
+  EXPECT_EQ(executor, executors_[1]);
+  IREE_ASSERT_OK(iree_hal_task_device_query_executor(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, &executor));
+  EXPECT_EQ(executor, executors_[0]);
+}
+
+// Tests that submitted calls all run before the scope goes idle.
+TEST_F(TaskDeviceTest, SubmitCalls) {
+  iree_atomic_int32_t call_count = IREE_ATOMIC_VAR_INIT(0);
+  const int32_t kCallCount = 128;
+  for (int32_t i = 0; i < kCallCount; ++i) {
+    IREE_ASSERT_OK(iree_hal_task_device_submit_call(
+        device_, 1ull << (i % kQueueCount), &scope_,
+        iree_task_make_call_closure(
+            [](void* user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              iree_atomic_fetch_add_int32(
+                  (iree_atomic_int32_t*)user_context, 1,
+                  iree_memory_order_relaxed);
+              return iree_ok_status();
+            },
+            &call_count)));
+  }
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  EXPECT_EQ(iree_atomic_load_int32(&call_count, iree_memory_order_relaxed),
+            kCallCount);
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+}
+
+// Tests that a failing call fails the scope it was submitted with.
+TEST_F(TaskDeviceTest, SubmitCallFailure) {
+  IREE_ASSERT_OK(iree_hal_task_device_submit_call(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, &scope_,
+      iree_task_make_call_closure(
+          [](void* user_context, iree_task_t* task,
+             iree_task_submission_t* pending_submission) {
+            return iree_make_status(IREE_STATUS_DATA_LOSS, "call failed");
+          },
+          NULL)));
+  IREE_ASSERT_OK(iree_task_scope_wait_idle(&scope_, IREE_TIME_INFINITE_FUTURE));
+  iree_status_t status = iree_task_scope_consume_status(&scope_);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS, status);
+  iree_status_free(status);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -521,9 +521,10 @@ static iree_status_t iree_hal_task_queue_submit_batch(
     iree_task_submission_enqueue(&submission, head_task);
   }
 
-  // Submit the tasks immediately. The executor may queue them up until we
-  // force the flush after all batches have been processed.
-  iree_task_executor_submit(queue->executor, &submission);
+  // Submit the tasks immediately. Ready tasks are posted directly to workers
+  // from this thread so that concurrent submissions from many queues don't
+  // contend on the executor coordinator.
+  iree_task_executor_submit_direct(queue->executor, &submission);
   return iree_ok_status();
 }
 
@@ -547,9 +548,6 @@ iree_status_t iree_hal_task_queue_submit(
 
   iree_status_t status =
       iree_hal_task_queue_submit_batches(queue, batch_count, batches);
-  if (iree_status_is_ok(status)) {
-    iree_task_executor_flush(queue->executor);
-  }
 
   IREE_TRACE_ZONE_END(z0);
   return status;
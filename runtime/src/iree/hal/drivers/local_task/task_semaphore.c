@@ -23,9 +23,9 @@
 // When the semaphore is signaled to at least the specified value then the
 // given event will be signaled and the timepoint discarded.
 //
-// Instances are owned and retained by the caller that requested them - usually
-// in the arena associated with the submission, but could be on the stack of a
-// synchronously waiting thread.
+// Instances are owned and retained by the caller that requested them in the
+// arena associated with the submission. The event is what the task system
+// poller waits on; host threads use iree_hal_task_host_wait_t instead.
 typedef struct iree_hal_task_timepoint_t {
   iree_hal_semaphore_timepoint_t base;
   iree_hal_semaphore_t* semaphore;
@@ -42,6 +42,97 @@ static iree_status_t iree_hal_task_semaphore_timepoint_callback(
   return iree_ok_status();
 }
 
+//===----------------------------------------------------------------------===//
+// iree_hal_task_host_wait_t
+//===----------------------------------------------------------------------===//
+
+// State of a host thread blocked on one or more semaphore timepoints.
+// Host waits never leave the process and use a futex-backed notification
+// instead of an iree_event_t: signaling without a waiter blocked is just an
+// atomic operation and waiting on any number of semaphores needs no wait set.
+// Events (and the kernel objects behind them) are reserved for waits that are
+// handed to the task system poller or exported.
+//
+// Each semaphore gets a base timepoint whose callback decrements |remaining|
+// and the last one (or any failure) wakes the waiter. All timepoints must be
+// cancelled before the wait is deinitialized: cancellation synchronizes with
+// callbacks that may still be running on the signaling thread.
+typedef struct iree_hal_task_host_wait_t {
+  iree_notification_t notification;
+  // Number of timepoints that must resolve before the wait completes. ANY
+  // waits use 1 so that the first resolved timepoint wakes the waiter. Reset
+  // to 0 when any timepoint fails or expires.
+  iree_atomic_int32_t remaining;
+} iree_hal_task_host_wait_t;
+
+// A timepoint registered on one semaphore of a host wait.
+typedef struct iree_hal_task_host_wait_timepoint_t {
+  iree_hal_semaphore_timepoint_t base;
+  // Unlike |base|.semaphore this is not reset when the timepoint resolves.
+  iree_hal_semaphore_t* semaphore;
+} iree_hal_task_host_wait_timepoint_t;
+
+static void iree_hal_task_host_wait_initialize(
+    int32_t remaining, iree_hal_task_host_wait_t* out_wait) {
+  iree_notification_initialize(&out_wait->notification);
+  iree_atomic_store_int32(&out_wait->remaining, remaining,
+                          iree_memory_order_relaxed);
+}
+
+static void iree_hal_task_host_wait_deinitialize(
+    iree_hal_task_host_wait_t* wait) {
+  iree_notification_deinitialize(&wait->notification);
+}
+
+static bool iree_hal_task_host_wait_is_resolved(
+    iree_hal_task_host_wait_t* wait) {
+  return iree_atomic_load_int32(&wait->remaining, iree_memory_order_acquire) <=
+         0;
+}
+
+// Handles timepoint callbacks for host waits. As with events we wake the
+// waiter on failure and let it deal with the fallout.
+static iree_status_t iree_hal_task_host_wait_timepoint_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  iree_hal_task_host_wait_t* wait = (iree_hal_task_host_wait_t*)user_data;
+  if (status_code != IREE_STATUS_OK) {
+    iree_atomic_store_int32(&wait->remaining, 0, iree_memory_order_release);
+    iree_notification_post(&wait->notification, IREE_ALL_WAITERS);
+  } else if (iree_atomic_fetch_sub_int32(&wait->remaining, 1,
+                                         iree_memory_order_acq_rel) == 1) {
+    iree_notification_post(&wait->notification, IREE_ALL_WAITERS);
+  }
+  return iree_ok_status();
+}
+
+// Acquires |timepoint| on |semaphore| contributing to |wait|.
+static void iree_hal_task_host_wait_acquire_timepoint(
+    iree_hal_task_host_wait_t* wait, iree_hal_semaphore_t* semaphore,
+    uint64_t minimum_value, iree_timeout_t timeout,
+    iree_hal_task_host_wait_timepoint_t* out_timepoint) {
+  out_timepoint->semaphore = semaphore;
+  iree_hal_semaphore_acquire_timepoint(
+      semaphore, minimum_value, timeout,
+      (iree_hal_semaphore_callback_t){
+          .fn = iree_hal_task_host_wait_timepoint_callback,
+          .user_data = wait,
+      },
+      &out_timepoint->base);
+}
+
+// Blocks until |wait| resolves or |timeout| elapses.
+static iree_status_t iree_hal_task_host_wait_await(
+    iree_hal_task_host_wait_t* wait, iree_timeout_t timeout) {
+  if (!iree_notification_await(
+          &wait->notification,
+          (iree_condition_fn_t)iree_hal_task_host_wait_is_resolved, wait,
+          timeout)) {
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_task_semaphore_t
 //===----------------------------------------------------------------------===//
@@ -299,24 +390,25 @@ static iree_status_t iree_hal_task_semaphore_wait(
     return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
   }
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
-
   // Slow path: acquire a timepoint while we hold the lock.
-  iree_hal_task_timepoint_t timepoint;
-  iree_status_t status = iree_hal_task_semaphore_acquire_timepoint(
-      semaphore, value, timeout, &timepoint);
+  // Convert the timeout to a deadline now so that the time spent acquiring the
+  // timepoint counts towards it.
+  timeout = iree_make_deadline(iree_timeout_as_deadline_ns(timeout));
+  iree_hal_task_host_wait_t wait;
+  iree_hal_task_host_wait_initialize(1, &wait);
+  iree_hal_task_host_wait_timepoint_t timepoint;
+  iree_hal_task_host_wait_acquire_timepoint(&wait, &semaphore->base, value,
+                                            timeout, &timepoint);
 
   iree_slim_mutex_unlock(&semaphore->mutex);
-  if (IREE_UNLIKELY(!iree_status_is_ok(status))) return status;
 
   // Wait until the timepoint resolves.
-  // If satisfied the timepoint is automatically cleaned up and we are done. If
-  // the deadline is reached before satisfied then we have to clean it up.
-  status = iree_wait_one(&timepoint.event, deadline_ns);
-  if (!iree_status_is_ok(status)) {
-    iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
-  }
-  iree_event_pool_release(semaphore->event_pool, 1, &timepoint.event);
+  // If satisfied the timepoint is automatically cleaned up and cancellation is
+  // a no-op. If the deadline is reached before satisfied then we have to clean
+  // it up.
+  iree_status_t status = iree_hal_task_host_wait_await(&wait, timeout);
+  iree_hal_semaphore_cancel_timepoint(&semaphore->base, &timepoint.base);
+  iree_hal_task_host_wait_deinitialize(&wait);
 
   return status;
 }
@@ -324,7 +416,7 @@ static iree_status_t iree_hal_task_semaphore_wait(
 iree_status_t iree_hal_task_semaphore_multi_wait(
     iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t semaphore_list, iree_timeout_t timeout,
-    iree_event_pool_t* event_pool, iree_arena_block_pool_t* block_pool) {
+    iree_arena_block_pool_t* block_pool) {
   if (semaphore_list.count == 0) {
     return iree_ok_status();
   } else if (semaphore_list.count == 1) {
@@ -335,74 +427,74 @@ iree_status_t iree_hal_task_semaphore_multi_wait(
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_time_t deadline_ns = iree_timeout_as_deadline_ns(timeout);
+  timeout = iree_make_deadline(iree_timeout_as_deadline_ns(timeout));
 
-  // Avoid heap allocations by using the device block pool for the wait set.
+  // Avoid heap allocations by using the device block pool for the timepoints.
   iree_arena_allocator_t arena;
   iree_arena_initialize(block_pool, &arena);
-  iree_wait_set_t* wait_set = NULL;
-  iree_status_t status = iree_wait_set_allocate(
-      semaphore_list.count, iree_arena_allocator(&arena), &wait_set);
-
-  // Acquire a wait handle for each semaphore timepoint we are to wait on.
-  // TODO(benvanik): flip this API around so we can batch request events from
-  // the event pool. We should be acquiring all required time points in one
-  // call.
   iree_host_size_t timepoint_count = 0;
-  iree_hal_task_timepoint_t* timepoints = NULL;
+  iree_hal_task_host_wait_timepoint_t* timepoints = NULL;
   iree_host_size_t total_timepoint_size =
       semaphore_list.count * sizeof(timepoints[0]);
-  bool needs_wait = true;
-  status =
+  iree_status_t status =
       iree_arena_allocate(&arena, total_timepoint_size, (void**)&timepoints);
-  if (iree_status_is_ok(status)) {
-    memset(timepoints, 0, total_timepoint_size);
-    for (iree_host_size_t i = 0; i < semaphore_list.count && needs_wait; ++i) {
-      iree_hal_task_semaphore_t* semaphore =
-          iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
-      iree_slim_mutex_lock(&semaphore->mutex);
-      if (semaphore->current_value >= semaphore_list.payload_values[i]) {
-        // Fast path: already satisfied.
-        // If in ANY wait mode, this is sufficient and we don't actually need
-        // to wait. This also skips acquiring timepoints for any remaining
-        // semaphores. We still exit normally otherwise so as to cleanup
-        // any timepoints already acquired.
-        if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
-          needs_wait = false;
-        }
-      } else {
-        // Slow path: get a native wait handle for the timepoint.
-        iree_hal_task_timepoint_t* timepoint = &timepoints[timepoint_count++];
-        status = iree_hal_task_semaphore_acquire_timepoint(
-            semaphore, semaphore_list.payload_values[i], timeout, timepoint);
-        if (iree_status_is_ok(status)) {
-          status = iree_wait_set_insert(wait_set, timepoint->event);
-        }
+  if (!iree_status_is_ok(status)) {
+    iree_arena_deinitialize(&arena);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // In ALL mode the count starts with a guard reference that prevents the
+  // wait from resolving as timepoints resolve while others are still being
+  // registered. ANY mode resolves on the first timepoint.
+  iree_hal_task_host_wait_t wait;
+  iree_hal_task_host_wait_initialize(1, &wait);
+  bool needs_wait = true;
+  for (iree_host_size_t i = 0; i < semaphore_list.count && needs_wait; ++i) {
+    iree_hal_task_semaphore_t* semaphore =
+        iree_hal_task_semaphore_cast(semaphore_list.semaphores[i]);
+    iree_slim_mutex_lock(&semaphore->mutex);
+    if (semaphore->current_value >= semaphore_list.payload_values[i]) {
+      // Fast path: already satisfied.
+      // If in ANY wait mode, this is sufficient and we don't actually need
+      // to wait. This also skips acquiring timepoints for any remaining
+      // semaphores. We still exit normally otherwise so as to cleanup
+      // any timepoints already acquired.
+      if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
+        needs_wait = false;
+      }
+    } else {
+      // Slow path: register a timepoint that contributes to the shared wait.
+      if (wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+        iree_atomic_fetch_add_int32(&wait.remaining, 1,
+                                    iree_memory_order_relaxed);
       }
-      iree_slim_mutex_unlock(&semaphore->mutex);
-      if (!iree_status_is_ok(status)) break;
+      iree_hal_task_host_wait_acquire_timepoint(
+          &wait, &semaphore->base, semaphore_list.payload_values[i], timeout,
+          &timepoints[timepoint_count++]);
     }
+    iree_slim_mutex_unlock(&semaphore->mutex);
+  }
+
+  // Drop the registration guard; if all timepoints already resolved then the
+  // wait below returns immediately.
+  if (wait_mode == IREE_HAL_WAIT_MODE_ALL) {
+    iree_atomic_fetch_sub_int32(&wait.remaining, 1, iree_memory_order_acq_rel);
   }
 
   // Perform the wait.
-  if (iree_status_is_ok(status) && needs_wait) {
-    if (wait_mode == IREE_HAL_WAIT_MODE_ANY) {
-      status = iree_wait_any(wait_set, deadline_ns, /*out_wake_handle=*/NULL);
-    } else {
-      status = iree_wait_all(wait_set, deadline_ns);
-    }
+  if (needs_wait) {
+    status = iree_hal_task_host_wait_await(&wait, timeout);
   }
 
-  // TODO(benvanik): if we flip the API to multi-acquire events from the pool
-  // above then we can multi-release here too.
+  // Cancel any timepoints that have not resolved. Cancellation of resolved
+  // timepoints is a no-op but still synchronizes with their callbacks so that
+  // none can touch |wait| once it is deinitialized.
   for (iree_host_size_t i = 0; i < timepoint_count; ++i) {
-    iree_hal_semaphore_t* semaphore = timepoints[i].semaphore;
-    if (semaphore) {
-      iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i].base);
-      iree_event_pool_release(event_pool, 1, &timepoints[i].event);
-    }
+    iree_hal_semaphore_cancel_timepoint(timepoints[i].semaphore,
+                                        &timepoints[i].base);
   }
-  iree_wait_set_free(wait_set);
+  iree_hal_task_host_wait_deinitialize(&wait);
   iree_arena_deinitialize(&arena);
 
   IREE_TRACE_ZONE_END(z0);
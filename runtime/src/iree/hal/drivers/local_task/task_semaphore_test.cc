@@ -0,0 +1,236 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/local_task/task_semaphore.h"
+
+#include <chrono>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/arena.h"
+#include "iree/base/internal/event_pool.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+// Delay before signaling from another thread so that waiters block.
+static constexpr std::chrono::milliseconds kSignalDelay(10);
+
+class TaskSemaphoreTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_event_pool_allocate(/*available_capacity=*/4,
+                                            iree_allocator_system(),
+                                            &event_pool_));
+    iree_arena_block_pool_initialize(4096, iree_allocator_system(),
+                                     &block_pool_);
+  }
+
+  void TearDown() override {
+    iree_arena_block_pool_deinitialize(&block_pool_);
+    iree_event_pool_free(event_pool_);
+  }
+
+  iree_hal_semaphore_t* CreateSemaphore(uint64_t initial_value) {
+    iree_hal_semaphore_t* semaphore = NULL;
+    IREE_CHECK_OK(iree_hal_task_semaphore_create(
+        event_pool_, initial_value, iree_allocator_system(), &semaphore));
+    return semaphore;
+  }
+
+  iree_status_t MultiWait(iree_hal_wait_mode_t wait_mode,
+                          std::vector<iree_hal_semaphore_t*> semaphores,
+                          std::vector<uint64_t> values,
+                          iree_timeout_t timeout) {
+    iree_hal_semaphore_list_t semaphore_list = {
+        semaphores.size(),
+        semaphores.data(),
+        values.data(),
+    };
+    return iree_hal_task_semaphore_multi_wait(wait_mode, semaphore_list,
+                                              timeout, &block_pool_);
+  }
+
+  iree_event_pool_t* event_pool_ = NULL;
+  iree_arena_block_pool_t block_pool_;
+};
+
+// Tests that waits on values already reached return without blocking.
+TEST_F(TaskSemaphoreTest, WaitAlreadySignaled) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(2);
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore, 1, iree_immediate_timeout()));
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore, 2, iree_immediate_timeout()));
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      iree_hal_semaphore_wait(semaphore, 3, iree_immediate_timeout()));
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that a blocked wait times out and leaves no timepoint behind.
+TEST_F(TaskSemaphoreTest, WaitTimeout) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(0);
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      iree_hal_semaphore_wait(semaphore, 1,
+                              iree_make_timeout_ms(kSignalDelay.count())));
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore, 1, iree_immediate_timeout()));
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that a blocked wait wakes when another thread signals.
+TEST_F(TaskSemaphoreTest, WaitSignaledFromThread) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(0);
+  std::thread thread([&]() {
+    std::this_thread::sleep_for(kSignalDelay);
+    IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore, 1));
+    std::this_thread::sleep_for(kSignalDelay);
+    IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore, 3));
+  });
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore, 1, iree_infinite_timeout()));
+  IREE_EXPECT_OK(
+      iree_hal_semaphore_wait(semaphore, 2, iree_infinite_timeout()));
+  uint64_t value = 0;
+  IREE_EXPECT_OK(iree_hal_semaphore_query(semaphore, &value));
+  EXPECT_EQ(value, 3u);
+  thread.join();
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that one signal wakes all threads blocked on the semaphore.
+TEST_F(TaskSemaphoreTest, WaitManyWaiters) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(0);
+  std::vector<std::thread> threads;
+  for (int i = 0; i < 8; ++i) {
+    threads.emplace_back([&]() {
+      IREE_EXPECT_OK(
+          iree_hal_semaphore_wait(semaphore, 1, iree_infinite_timeout()));
+    });
+  }
+  std::this_thread::sleep_for(kSignalDelay);
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, 1));
+  for (auto& thread : threads) thread.join();
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that a blocked wait wakes when another thread fails the semaphore.
+TEST_F(TaskSemaphoreTest, WaitFailedFromThread) {
+  iree_hal_semaphore_t* semaphore = CreateSemaphore(0);
+  std::thread thread([&]() {
+    std::this_thread::sleep_for(kSignalDelay);
+    iree_hal_semaphore_fail(semaphore,
+                            iree_make_status(IREE_STATUS_DATA_LOSS));
+  });
+  iree_status_ignore(
+      iree_hal_semaphore_wait(semaphore, 1, iree_infinite_timeout()));
+  thread.join();
+  uint64_t value = 0;
+  iree_status_t status = iree_hal_semaphore_query(semaphore, &value);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS, status);
+  iree_status_free(status);
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_ABORTED,
+      iree_hal_semaphore_wait(semaphore, 1, iree_infinite_timeout()));
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that ALL waits only return once every semaphore is signaled.
+TEST_F(TaskSemaphoreTest, MultiWaitAll) {
+  iree_hal_semaphore_t* semaphore0 = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore1 = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore2 = CreateSemaphore(5);
+  std::thread thread([&]() {
+    std::this_thread::sleep_for(kSignalDelay);
+    IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore0, 1));
+    std::this_thread::sleep_for(kSignalDelay);
+    IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore1, 2));
+  });
+  IREE_EXPECT_OK(MultiWait(IREE_HAL_WAIT_MODE_ALL,
+                           {semaphore0, semaphore1, semaphore2}, {1, 2, 5},
+                           iree_infinite_timeout()));
+  uint64_t value = 0;
+  IREE_EXPECT_OK(iree_hal_semaphore_query(semaphore1, &value));
+  EXPECT_EQ(value, 2u);
+  thread.join();
+  iree_hal_semaphore_release(semaphore2);
+  iree_hal_semaphore_release(semaphore1);
+  iree_hal_semaphore_release(semaphore0);
+}
+
+// Tests that ALL waits time out if any semaphore is not signaled.
+TEST_F(TaskSemaphoreTest, MultiWaitAllTimeout) {
+  iree_hal_semaphore_t* semaphore0 = CreateSemaphore(1);
+  iree_hal_semaphore_t* semaphore1 = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore2 = CreateSemaphore(0);
+  IREE_EXPECT_STATUS_IS(
+      IREE_STATUS_DEADLINE_EXCEEDED,
+      MultiWait(IREE_HAL_WAIT_MODE_ALL, {semaphore0, semaphore1, semaphore2},
+                {1, 1, 1}, iree_make_timeout_ms(kSignalDelay.count())));
+  // Cancelled timepoints must not be signaled.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore1, 1));
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore2, 1));
+  IREE_EXPECT_OK(MultiWait(IREE_HAL_WAIT_MODE_ALL,
+                           {semaphore0, semaphore1, semaphore2}, {1, 1, 1},
+                           iree_immediate_timeout()));
+  iree_hal_semaphore_release(semaphore2);
+  iree_hal_semaphore_release(semaphore1);
+  iree_hal_semaphore_release(semaphore0);
+}
+
+// Tests that ANY waits return once the first semaphore is signaled.
+TEST_F(TaskSemaphoreTest, MultiWaitAny) {
+  iree_hal_semaphore_t* semaphore0 = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore1 = CreateSemaphore(0);
+  std::thread thread([&]() {
+    std::this_thread::sleep_for(kSignalDelay);
+    IREE_EXPECT_OK(iree_hal_semaphore_signal(semaphore1, 1));
+  });
+  IREE_EXPECT_OK(MultiWait(IREE_HAL_WAIT_MODE_ANY, {semaphore0, semaphore1},
+                           {1, 1}, iree_infinite_timeout()));
+  thread.join();
+  uint64_t value = 0;
+  IREE_EXPECT_OK(iree_hal_semaphore_query(semaphore0, &value));
+  EXPECT_EQ(value, 0u);
+  iree_hal_semaphore_release(semaphore1);
+  iree_hal_semaphore_release(semaphore0);
+}
+
+// Tests that ALL waits wake when one of the semaphores fails.
+TEST_F(TaskSemaphoreTest, MultiWaitAllFailure) {
+  iree_hal_semaphore_t* semaphore0 = CreateSemaphore(0);
+  iree_hal_semaphore_t* semaphore1 = CreateSemaphore(0);
+  std::thread thread([&]() {
+    std::this_thread::sleep_for(kSignalDelay);
+    iree_hal_semaphore_fail(semaphore1,
+                            iree_make_status(IREE_STATUS_DATA_LOSS));
+  });
+  iree_status_ignore(MultiWait(IREE_HAL_WAIT_MODE_ALL,
+                               {semaphore0, semaphore1}, {1, 1},
+                               iree_infinite_timeout()));
+  thread.join();
+  uint64_t value = 0;
+  IREE_EXPECT_OK(iree_hal_semaphore_query(semaphore0, &value));
+  EXPECT_EQ(value, 0u);
+  iree_status_t status = iree_hal_semaphore_query(semaphore1, &value);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_DATA_LOSS, status);
+  iree_status_free(status);
+  iree_hal_semaphore_release(semaphore1);
+  iree_hal_semaphore_release(semaphore0);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -11,6 +11,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/utils/executable_disk_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -75,6 +76,18 @@ typedef struct iree_hal_metal_device_params_t {
   // usages and prevent hazards, which incurs runtime overhead. But it can be
   // helpful for debugging purposes.
   iree_hal_metal_resource_hazard_tracking_mode_t resource_hazard_tracking_mode;
+
+  // Optional persistent cache for MTLBinaryArchives holding compiled compute
+  // pipelines for executables prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING.
+  // Retained by the driver and any devices created with these parameters.
+  iree_hal_executable_disk_cache_t* executable_disk_cache;
+
+  // Allocates device-local buffers with shared storage on devices with unified
+  // memory. Such buffers are host-visible and coherent so that transfers to and
+  // from them are mapped memcpys instead of blit encoder copies through staging
+  // buffers. Ignored on devices without unified memory.
+  bool unified_memory;
 } iree_hal_metal_device_params_t;
 
 // Initializes |out_params| to default values.
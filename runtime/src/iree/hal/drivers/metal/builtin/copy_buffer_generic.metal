@@ -5,6 +5,7 @@
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
 // Polyfill Metal kernels for buffer copies without 4-byte aligned offsets / lengths.
+// All kernels use grid-stride loops so the host can bound the dispatch size.
 
 struct CopySpec {
   uint64_t src_buffer_offset;  // Source buffer offset (in bytes)
@@ -12,16 +13,59 @@ struct CopySpec {
   uint64_t length;             // Buffer length to fill (in bytes)
 };
 
+// Copies data from |src_buffer| to |dst_buffer| with the given |spec|ification.
+//
+// The source/destination buffer offsets and length are assumed to be 16-byte
+// aligned. Each thread copies 4-component 32-bit element vectors in a
+// grid-stride loop so that a bounded grid can cover copies of any size.
+kernel void copy_buffer_16byte(
+  device const uint4 *src_buffer [[buffer(0)]],
+  device uint4 *dst_buffer [[buffer(1)]],
+  constant CopySpec &spec [[buffer(2)]],
+  uint id [[thread_position_in_grid]],
+  uint grid_size [[threads_per_grid]]
+) {
+  uint64_t src_start = spec.src_buffer_offset / 16;
+  uint64_t dst_start = spec.dst_buffer_offset / 16;
+  uint64_t end = spec.length / 16;
+  for (uint64_t i = id; i < end; i += grid_size) {
+    dst_buffer[dst_start + i] = src_buffer[src_start + i];
+  }
+}
+
+// Copies data from |src_buffer| to |dst_buffer| with the given |spec|ification.
+//
+// The source/destination buffer offsets and length are assumed to be 4-byte
+// aligned. Each thread copies 32-bit scalars in a grid-stride loop.
+kernel void copy_buffer_4byte(
+  device const uint32_t *src_buffer [[buffer(0)]],
+  device uint32_t *dst_buffer [[buffer(1)]],
+  constant CopySpec &spec [[buffer(2)]],
+  uint id [[thread_position_in_grid]],
+  uint grid_size [[threads_per_grid]]
+) {
+  uint64_t src_start = spec.src_buffer_offset / 4;
+  uint64_t dst_start = spec.dst_buffer_offset / 4;
+  uint64_t end = spec.length / 4;
+  for (uint64_t i = id; i < end; i += grid_size) {
+    dst_buffer[dst_start + i] = src_buffer[src_start + i];
+  }
+}
+
 // Copies data from |src_buffer| to |dst_buffer| with the given |spec|ification.
 //
 // No alignment requirement on source/destination buffer offset and length.
-// Each thread copies over one byte. This won't be good for perf; so just a fallback.
+// Each thread copies bytes in a grid-stride loop. The host only uses this for
+// the unaligned head/tail of copies and for copies whose source and destination
+// can never be co-aligned.
 kernel void copy_buffer_1byte(
-  device uint8_t *src_buffer [[buffer(0)]],
+  device const uint8_t *src_buffer [[buffer(0)]],
   device uint8_t *dst_buffer [[buffer(1)]],
   constant CopySpec &spec [[buffer(2)]],
-  uint id [[thread_position_in_grid]]
+  uint id [[thread_position_in_grid]],
+  uint grid_size [[threads_per_grid]]
 ) {
-  if (id >= spec.length) return;
-  dst_buffer[spec.dst_buffer_offset + id] = src_buffer[spec.src_buffer_offset + id];
+  for (uint64_t i = id; i < spec.length; i += grid_size) {
+    dst_buffer[spec.dst_buffer_offset + i] = src_buffer[spec.src_buffer_offset + i];
+  }
 }
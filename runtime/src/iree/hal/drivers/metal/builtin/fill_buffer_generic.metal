@@ -15,41 +15,51 @@ struct FillSpec {
 // Fills target |buffer| with the given |spec|ification.
 //
 // The target |buffer| is assumed to have 16-byte aligned offset/length.
-// Each thread fills one 4-compoment 32-bit element vector.
+// Each thread fills 4-compoment 32-bit element vectors in a grid-stride loop so
+// that a bounded grid can cover fills of any size.
 kernel void fill_buffer_16byte(
   device uint4 *buffer [[buffer(0)]],
   constant FillSpec &spec [[buffer(1)]],
-  uint id [[thread_position_in_grid]]
+  uint id [[thread_position_in_grid]],
+  uint grid_size [[threads_per_grid]]
 ) {
-  uint64_t end = spec.buffer_length / 16;
-  if (id >= end) return;
   uint64_t start = spec.buffer_offset / 16;
-  buffer[start + id] = uint4(spec.pattern, spec.pattern, spec.pattern, spec.pattern);
+  uint64_t end = spec.buffer_length / 16;
+  uint4 pattern = uint4(spec.pattern, spec.pattern, spec.pattern, spec.pattern);
+  for (uint64_t i = id; i < end; i += grid_size) {
+    buffer[start + i] = pattern;
+  }
 }
 
 // Fills target |buffer| with the given |spec|ification.
 //
 // The target |buffer| is assumed to have 4-byte aligned offset/length.
-// Each thread fills one 32-bit scalar.
+// Each thread fills 32-bit scalars in a grid-stride loop.
 kernel void fill_buffer_4byte(
   device uint32_t *buffer [[buffer(0)]],
   constant FillSpec &spec [[buffer(1)]],
-  uint id [[thread_position_in_grid]]
+  uint id [[thread_position_in_grid]],
+  uint grid_size [[threads_per_grid]]
 ) {
-  uint64_t end = spec.buffer_length / 4;
-  if (id >= end) return;
   uint64_t start = spec.buffer_offset / 4;
-  buffer[start + id] = spec.pattern;
+  uint64_t end = spec.buffer_length / 4;
+  for (uint64_t i = id; i < end; i += grid_size) {
+    buffer[start + i] = spec.pattern;
+  }
 }
 
 // Fills target |buffer| with the given |spec|ification.
 //
 // The target |buffer| is assumed to have 1-byte aligned offset/length.
-// Each thread fills one 8-bit scalar.
+// Each thread fills 32-bit scalars in the aligned middle in a grid-stride loop
+// and the first thread additionally fills the unaligned bytes on either end.
+// The host only uses this for short fills or the unaligned head/tail of large
+// fills, with the 16-byte aligned interior handled by fill_buffer_16byte.
 kernel void fill_buffer_1byte(
   device uint32_t *buffer [[buffer(0)]],
   constant FillSpec &spec [[buffer(1)]],
-  uint id [[thread_position_in_grid]]
+  uint id [[thread_position_in_grid]],
+  uint grid_size [[threads_per_grid]]
 ) {
   // We split the full buffer fill range into three parts:
   // 1. Left bytes: containing (0 to 3) bytes before the first 4-byte aligned address
@@ -73,9 +83,8 @@ kernel void fill_buffer_1byte(
   uint64_t middle_start = (spec.buffer_offset + 3) / 4;
   uint64_t right_start = (spec.buffer_offset + spec.buffer_length) / 4;
 
-  if (middle_start < right_start) {  // Middle bytes
-    if (middle_start + id >= right_start) return;
-    buffer[middle_start + id] = middle_pattern;
+  for (uint64_t i = middle_start + id; i < right_start; i += grid_size) {  // Middle bytes
+    buffer[i] = middle_pattern;
   }
 
   if (left_byte_count != 0 && id == 0) {  // Left bytes
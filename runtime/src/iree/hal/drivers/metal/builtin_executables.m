@@ -18,6 +18,17 @@ typedef struct iree_hal_metal_builtin_executable_data_t {
   uint32_t file_index;
 } iree_hal_metal_builtin_executable_data_t;
 
+// Indices of the builtin executable entry points. This MUST be consistent with the order of
+// iree_hal_metal_builtin_executable_entry_points.
+enum iree_hal_metal_builtin_entry_point_e {
+  IREE_HAL_METAL_BUILTIN_FILL_BUFFER_16BYTE = 0,
+  IREE_HAL_METAL_BUILTIN_FILL_BUFFER_4BYTE,
+  IREE_HAL_METAL_BUILTIN_FILL_BUFFER_1BYTE,
+  IREE_HAL_METAL_BUILTIN_COPY_BUFFER_16BYTE,
+  IREE_HAL_METAL_BUILTIN_COPY_BUFFER_4BYTE,
+  IREE_HAL_METAL_BUILTIN_COPY_BUFFER_1BYTE,
+};
+
 // The list of builtin executable entry points and their source file index in builtin exectuable
 // embedded data. This MUST be consistent with kernel function names in MSL source code and the file
 // order in embedded data.
@@ -25,9 +36,23 @@ static iree_hal_metal_builtin_executable_data_t iree_hal_metal_builtin_executabl
     {"fill_buffer_16byte", 1},  // Buffer fills; 16-byte aligned offset/length
     {"fill_buffer_4byte", 1},   // Buffer fills; 4-byte aligned offset/length
     {"fill_buffer_1byte", 1},   // Buffer fills; 1-byte aligned offset/length
-    {"copy_buffer_1byte", 0},   // Buffer copies; 1-byte aligned offset/length
+    {"copy_buffer_16byte", 0},  // Buffer copies; 16-byte aligned offsets/length
+    {"copy_buffer_4byte", 0},   // Buffer copies; 4-byte aligned offsets/length
+    {"copy_buffer_1byte", 0},   // Buffer copies; 1-byte aligned offsets/length
 };
 
+// Number of threads per threadgroup used by all builtin kernels.
+#define IREE_HAL_METAL_BUILTIN_WORKGROUP_SIZE 32
+
+// Maximum number of threadgroups dispatched for a single builtin kernel. All kernels use
+// grid-stride loops so larger fills/copies reuse threads instead of growing the grid; this is
+// enough threads to saturate memory bandwidth on current Apple GPUs.
+#define IREE_HAL_METAL_BUILTIN_MAX_WORKGROUP_COUNT 4096
+
+// Unaligned fills/copies at least this long are split into an unaligned head/tail and a 16-byte
+// vectorized interior. Shorter ones are done in a single dispatch.
+#define IREE_HAL_METAL_BUILTIN_SPLIT_THRESHOLD 256
+
 // The buffer fill specificiation. This MUST be consistent with the same struct in MSL source code.
 typedef struct iree_hal_metal_buffer_fill_spec_t {
   uint64_t buffer_offset;  // Buffer offset to fill (in bytes)
@@ -131,89 +156,184 @@ static inline iree_device_size_t iree_hal_metal_ceil_div(iree_device_size_t a,
   return (a + b - 1) / b;
 }
 
-iree_status_t iree_hal_metal_builtin_executable_fill_buffer(
+// Dispatches the builtin |entry_point| with enough threads to cover |element_count| elements, up
+// to the maximum grid size.
+static void iree_hal_metal_builtin_executable_dispatch(
     const iree_hal_metal_builtin_executable_t* executable, id<MTLComputeCommandEncoder> encoder,
-    id<MTLBuffer> target_buffer, iree_device_size_t target_offset, iree_device_size_t length,
-    uint32_t pattern) {
-  id<MTLComputePipelineState> pso = nil;
-  MTLResourceUsage usage = MTLResourceUsageWrite;
-  const iree_device_size_t workgroup_size = 32;
-  iree_device_size_t workgroup_count = 0;
-
-  if (target_offset % 16 == 0 && length % 16 == 0) {  // 16-byte aligned case
-    pso = executable->entry_points[0].pso;
-    workgroup_count = iree_hal_metal_ceil_div(length, workgroup_size * 16);
-  } else if (target_offset % 4 == 0 && length % 4 == 0) {  // 4-byte aligned case
-    pso = executable->entry_points[1].pso;
-    workgroup_count = iree_hal_metal_ceil_div(length, workgroup_size * 4);
-  } else {  // 1-byte aligned case
-    pso = executable->entry_points[2].pso;
-    // We may potentially need to read some 32-bit scalars at unaligned addresses.
-    usage |= MTLResourceUsageRead;
-    // Calculate unaligned partial prefix/suffix byte count, and then get the middle aligned byte
-    // count for distributing threads. This logic MUST be consistent with the MSL source code.
-    iree_device_size_t left_byte_count = target_offset % 4;
-    iree_device_size_t right_byte_count = (target_offset + length) % 4;
-    int64_t middle_byte_count = length - left_byte_count - right_byte_count;
-    // Note that in the extreme case, we don't have aligned bytes in the middle (0), or actually
-    // prefix and suffix partial bytes are the same (< 0). We'd need one thread to handle the
-    // partial bytes at least.
-    if (middle_byte_count <= 0) middle_byte_count = 1;
-    workgroup_count = iree_hal_metal_ceil_div(middle_byte_count, workgroup_size * 4);
-  }
+    enum iree_hal_metal_builtin_entry_point_e entry_point, iree_device_size_t element_count) {
+  const iree_device_size_t workgroup_size = IREE_HAL_METAL_BUILTIN_WORKGROUP_SIZE;
+  iree_device_size_t workgroup_count =
+      iree_max(1, iree_hal_metal_ceil_div(element_count, workgroup_size));
+  workgroup_count = iree_min(workgroup_count, IREE_HAL_METAL_BUILTIN_MAX_WORKGROUP_COUNT);
+  [encoder setComputePipelineState:executable->entry_points[entry_point].pso];
+  [encoder dispatchThreadgroups:MTLSizeMake(workgroup_count, 1, 1)
+          threadsPerThreadgroup:MTLSizeMake(workgroup_size, 1, 1)];
+}
 
+// Encodes a fill of [offset, offset + length) of the buffer bound at index 0 using |entry_point|.
+static void iree_hal_metal_builtin_executable_encode_fill(
+    const iree_hal_metal_builtin_executable_t* executable, id<MTLComputeCommandEncoder> encoder,
+    enum iree_hal_metal_builtin_entry_point_e entry_point, iree_device_size_t offset,
+    iree_device_size_t length, uint32_t pattern) {
   iree_hal_metal_buffer_fill_spec_t spec = {
-      .buffer_offset = target_offset,
+      .buffer_offset = offset,
       .buffer_length = length,
       .pattern = pattern,
   };
+  // buffer(1) is the buffer fill spec.
+  [encoder setBytes:&spec length:sizeof(spec) atIndex:1];
 
-  [encoder setComputePipelineState:pso];
+  iree_device_size_t element_count = 0;
+  switch (entry_point) {
+    case IREE_HAL_METAL_BUILTIN_FILL_BUFFER_16BYTE:
+      element_count = length / 16;
+      break;
+    case IREE_HAL_METAL_BUILTIN_FILL_BUFFER_4BYTE:
+      element_count = length / 4;
+      break;
+    default:
+      // Threads are distributed over the aligned 32-bit scalars in the middle; the first thread
+      // additionally handles the partial bytes on either end. This logic MUST be consistent with
+      // the MSL source code.
+      element_count = ((offset + length) / 4) - iree_min((offset + 3) / 4, (offset + length) / 4);
+      break;
+  }
+  iree_hal_metal_builtin_executable_dispatch(executable, encoder, entry_point, element_count);
+}
 
+iree_status_t iree_hal_metal_builtin_executable_fill_buffer(
+    const iree_hal_metal_builtin_executable_t* executable, id<MTLComputeCommandEncoder> encoder,
+    id<MTLBuffer> target_buffer, iree_device_size_t target_offset, iree_device_size_t length,
+    uint32_t pattern) {
   // The following MUST exactly match the pipeline layout from MSL source code.
   // buffer(0) is the target buffer to fill. Note that we MUST set 0 as offset here--the offset
   // is to be handled directly in the kernels!
   [encoder setBuffer:target_buffer offset:0 atIndex:0];
-  [encoder useResource:target_buffer usage:usage];
-  // buffer(1) is the buffer fill spec.
-  [encoder setBytes:&spec length:sizeof(spec) atIndex:1];
 
-  // Encode the dispatch.
-  [encoder dispatchThreadgroups:MTLSizeMake(workgroup_count, 1, 1)
-          threadsPerThreadgroup:MTLSizeMake(workgroup_size, 1, 1)];
+  if (target_offset % 16 == 0 && length % 16 == 0) {  // 16-byte aligned case
+    [encoder useResource:target_buffer usage:MTLResourceUsageWrite];
+    iree_hal_metal_builtin_executable_encode_fill(
+        executable, encoder, IREE_HAL_METAL_BUILTIN_FILL_BUFFER_16BYTE, target_offset, length,
+        pattern);
+    return iree_ok_status();
+  }
+
+  // We may potentially need to read some 32-bit scalars at unaligned addresses.
+  [encoder useResource:target_buffer usage:MTLResourceUsageRead | MTLResourceUsageWrite];
+
+  iree_device_size_t target_end = target_offset + length;
+  iree_device_size_t middle_start = iree_device_align(target_offset, 16);
+  iree_device_size_t middle_end = target_end & ~(iree_device_size_t)15;
+  if (length < IREE_HAL_METAL_BUILTIN_SPLIT_THRESHOLD || middle_start >= middle_end) {
+    iree_hal_metal_builtin_executable_encode_fill(
+        executable, encoder,
+        target_offset % 4 == 0 && length % 4 == 0 ? IREE_HAL_METAL_BUILTIN_FILL_BUFFER_4BYTE
+                                                  : IREE_HAL_METAL_BUILTIN_FILL_BUFFER_1BYTE,
+        target_offset, length, pattern);
+    return iree_ok_status();
+  }
+
+  // Split into an unaligned head, a 16-byte aligned interior, and an unaligned tail. The ranges
+  // touch disjoint 32-bit scalars so the dispatches don't need to be ordered. The pattern is
+  // rotated so that the aligned pieces continue the byte sequence started at |target_offset|;
+  // this MUST be consistent with the rotation in fill_buffer_1byte.
+  uint32_t rotation = 8 * (uint32_t)(target_offset % 4);
+  uint32_t aligned_pattern =
+      rotation ? (pattern << rotation) | (pattern >> (32 - rotation)) : pattern;
+  if (middle_start > target_offset) {
+    iree_hal_metal_builtin_executable_encode_fill(executable, encoder,
+                                                  IREE_HAL_METAL_BUILTIN_FILL_BUFFER_1BYTE,
+                                                  target_offset, middle_start - target_offset,
+                                                  pattern);
+  }
+  iree_hal_metal_builtin_executable_encode_fill(executable, encoder,
+                                                IREE_HAL_METAL_BUILTIN_FILL_BUFFER_16BYTE,
+                                                middle_start, middle_end - middle_start,
+                                                aligned_pattern);
+  if (target_end > middle_end) {
+    iree_hal_metal_builtin_executable_encode_fill(
+        executable, encoder, IREE_HAL_METAL_BUILTIN_FILL_BUFFER_1BYTE, middle_end,
+        target_end - middle_end, aligned_pattern);
+  }
   return iree_ok_status();
 }
 
-iree_status_t iree_hal_metal_builtin_executable_copy_buffer(
+// Encodes a copy of |length| bytes between the buffers bound at index 0/1 using |entry_point|.
+static void iree_hal_metal_builtin_executable_encode_copy(
     const iree_hal_metal_builtin_executable_t* executable, id<MTLComputeCommandEncoder> encoder,
-    id<MTLBuffer> source_buffer, iree_device_size_t source_offset, id<MTLBuffer> target_buffer,
+    enum iree_hal_metal_builtin_entry_point_e entry_point, iree_device_size_t source_offset,
     iree_device_size_t target_offset, iree_device_size_t length) {
-  id<MTLComputePipelineState> pso = executable->entry_points[3].pso;
-  const iree_device_size_t workgroup_size = 32;
-  iree_device_size_t workgroup_count = iree_hal_metal_ceil_div(length, workgroup_size * 4);
-
   iree_hal_metal_buffer_copy_spec_t spec = {
       .src_buffer_offset = source_offset,
       .dst_buffer_offset = target_offset,
       .length = length,
   };
+  // buffer(2) is the buffer copy spec.
+  [encoder setBytes:&spec length:sizeof(spec) atIndex:2];
 
-  [encoder setComputePipelineState:pso];
+  iree_device_size_t element_size = 1;
+  if (entry_point == IREE_HAL_METAL_BUILTIN_COPY_BUFFER_16BYTE) {
+    element_size = 16;
+  } else if (entry_point == IREE_HAL_METAL_BUILTIN_COPY_BUFFER_4BYTE) {
+    element_size = 4;
+  }
+  iree_hal_metal_builtin_executable_dispatch(executable, encoder, entry_point,
+                                             length / element_size);
+}
 
+iree_status_t iree_hal_metal_builtin_executable_copy_buffer(
+    const iree_hal_metal_builtin_executable_t* executable, id<MTLComputeCommandEncoder> encoder,
+    id<MTLBuffer> source_buffer, iree_device_size_t source_offset, id<MTLBuffer> target_buffer,
+    iree_device_size_t target_offset, iree_device_size_t length) {
   // The following MUST exactly match the pipeline layout from MSL source code.
   // buffer(0) is the source buffer. Note that we MUST set 0 as offset here--the offset is to be
   // handled directly in the kernels!
   [encoder setBuffer:source_buffer offset:0 atIndex:0];
   [encoder useResource:source_buffer usage:MTLResourceUsageRead];
-  // buffer(0) is the target buffer. Note that we MUST set 0 as offset here--the offset is to be
+  // buffer(1) is the target buffer. Note that we MUST set 0 as offset here--the offset is to be
   // handled directly in the kernels!
   [encoder setBuffer:target_buffer offset:0 atIndex:1];
   [encoder useResource:target_buffer usage:MTLResourceUsageWrite];
-  // buffer(1) is the buffer copy spec.
-  [encoder setBytes:&spec length:sizeof(spec) atIndex:2];
 
-  // Encode the dispatch.
-  [encoder dispatchThreadgroups:MTLSizeMake(workgroup_count, 1, 1)
-          threadsPerThreadgroup:MTLSizeMake(workgroup_size, 1, 1)];
+  // Use the widest vector both ends are co-aligned to. If the offsets are co-aligned but not
+  // aligned the unaligned head/tail are copied bytewise around a vectorized interior.
+  iree_device_size_t element_size = 1;
+  enum iree_hal_metal_builtin_entry_point_e entry_point = IREE_HAL_METAL_BUILTIN_COPY_BUFFER_1BYTE;
+  if (source_offset % 16 == target_offset % 16) {
+    element_size = 16;
+    entry_point = IREE_HAL_METAL_BUILTIN_COPY_BUFFER_16BYTE;
+  } else if (source_offset % 4 == target_offset % 4) {
+    element_size = 4;
+    entry_point = IREE_HAL_METAL_BUILTIN_COPY_BUFFER_4BYTE;
+  }
+  iree_device_size_t head_length =
+      iree_min(length, iree_device_align(target_offset, element_size) - target_offset);
+  iree_device_size_t middle_length = (length - head_length) & ~(element_size - 1);
+  iree_device_size_t tail_length = length - head_length - middle_length;
+  if (element_size == 1 ||
+      (head_length + tail_length != 0 && length < IREE_HAL_METAL_BUILTIN_SPLIT_THRESHOLD)) {
+    iree_hal_metal_builtin_executable_encode_copy(executable, encoder,
+                                                  IREE_HAL_METAL_BUILTIN_COPY_BUFFER_1BYTE,
+                                                  source_offset, target_offset, length);
+    return iree_ok_status();
+  }
+
+  if (head_length > 0) {
+    iree_hal_metal_builtin_executable_encode_copy(executable, encoder,
+                                                  IREE_HAL_METAL_BUILTIN_COPY_BUFFER_1BYTE,
+                                                  source_offset, target_offset, head_length);
+  }
+  if (middle_length > 0) {
+    iree_hal_metal_builtin_executable_encode_copy(executable, encoder, entry_point,
+                                                  source_offset + head_length,
+                                                  target_offset + head_length, middle_length);
+  }
+  if (tail_length > 0) {
+    iree_device_size_t tail_offset = head_length + middle_length;
+    iree_hal_metal_builtin_executable_encode_copy(executable, encoder,
+                                                  IREE_HAL_METAL_BUILTIN_COPY_BUFFER_1BYTE,
+                                                  source_offset + tail_offset,
+                                                  target_offset + tail_offset, tail_length);
+  }
   return iree_ok_status();
 }
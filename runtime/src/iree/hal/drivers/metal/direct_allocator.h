@@ -17,12 +17,24 @@
 extern "C" {
 #endif  // __cplusplus
 
+// MTLResidencySet is only available when building against the macOS 15 or
+// iOS 18 SDKs; availability on the running OS is checked at runtime.
+#if (defined(__MAC_15_0) && __MAC_OS_X_VERSION_MAX_ALLOWED >= __MAC_15_0) || \
+    (defined(__IPHONE_18_0) && __IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_18_0)
+#define IREE_HAL_METAL_HAVE_RESIDENCY_SETS 1
+#else
+#define IREE_HAL_METAL_HAVE_RESIDENCY_SETS 0
+#endif  // __MAC_15_0 || __IPHONE_18_0
+
 // Creates a straightforward Metal allocator from the given |device| that
 // performs allocations separately without caching or suballocation.
 //
 // On macOS, we additionally need the command queue to encode commands to make
 // buffer contents visible to the CPU for managed storage type.
 //
+// If |enable_unified_memory| is set and the device has unified memory then
+// device-local buffers are allocated with shared storage and are host-visible.
+//
 // |out_allocator| must be released by the caller (see
 // iree_hal_allocator_release).
 iree_status_t iree_hal_metal_allocator_create(
@@ -31,7 +43,8 @@ iree_status_t iree_hal_metal_allocator_create(
     id<MTLCommandQueue> queue,
 #endif  // IREE_PLATFORM_MACOS
     iree_hal_metal_resource_hazard_tracking_mode_t resource_tracking_mode,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
+    bool enable_unified_memory, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator);
 
 #if defined(IREE_PLATFORM_MACOS)
 // Returns the underyling MetalCommandQueue associated with the given
@@ -40,6 +53,23 @@ id<MTLCommandQueue> iree_hal_metal_allocator_command_queue(
     const iree_hal_allocator_t* allocator);
 #endif  // IREE_PLATFORM_MACOS
 
+// Returns true if |allocator| keeps all buffers it allocates or imports in a
+// residency set. When it does command buffers need not declare them resident
+// with useResource unless Metal is tracking hazards on them.
+bool iree_hal_metal_allocator_has_residency_set(
+    const iree_hal_allocator_t* allocator);
+
+// Adds the residency set of |allocator|, if any, to |queue| so that all its
+// buffers are resident for all command buffers committed to the queue.
+void iree_hal_metal_allocator_attach_residency_set(
+    iree_hal_allocator_t* allocator, id<MTLCommandQueue> queue);
+
+// Commits pending additions and removals to the residency set of |allocator|.
+// Must be called before committing command buffers that use buffers allocated
+// since the last commit. No-op if nothing changed or there is no residency
+// set.
+void iree_hal_metal_allocator_commit_residency(iree_hal_allocator_t* allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
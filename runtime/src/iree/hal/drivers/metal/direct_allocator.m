@@ -9,6 +9,7 @@
 #import <Metal/Metal.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/base/target_platform.h"
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
@@ -30,8 +31,19 @@ typedef struct iree_hal_metal_allocator_t {
 #endif  // IREE_PLATFORM_MACOS
 
   bool is_unified_memory;
+  // Whether device-local buffers are allocated host-visible with shared storage.
+  bool use_unified_storage;
   iree_hal_metal_resource_hazard_tracking_mode_t resource_tracking_mode;
 
+  // Residency set holding all live buffers; nil if not supported by the OS.
+  // Additions and removals must not race with commits.
+  iree_slim_mutex_t residency_mutex;
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  id<MTLResidencySet> residency_set API_AVAILABLE(macos(15.0), ios(18.0));
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  // Whether the residency set has changes not yet committed.
+  bool residency_dirty IREE_GUARDED_BY(residency_mutex);
+
   iree_allocator_t host_allocator;
 
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
@@ -56,7 +68,8 @@ iree_status_t iree_hal_metal_allocator_create(
     id<MTLCommandQueue> queue,
 #endif  // IREE_PLATFORM_MACOS
     iree_hal_metal_resource_hazard_tracking_mode_t resource_tracking_mode,
-    iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator) {
+    bool enable_unified_memory, iree_allocator_t host_allocator,
+    iree_hal_allocator_t** out_allocator) {
   IREE_ASSERT_ARGUMENT(out_allocator);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -68,8 +81,21 @@ iree_status_t iree_hal_metal_allocator_create(
     iree_hal_resource_initialize(&iree_hal_metal_allocator_vtable, &allocator->resource);
     allocator->device = [device retain];  // +1
     allocator->is_unified_memory = [device hasUnifiedMemory];
+    allocator->use_unified_storage = enable_unified_memory && allocator->is_unified_memory;
     allocator->resource_tracking_mode = resource_tracking_mode;
     allocator->host_allocator = host_allocator;
+    iree_slim_mutex_initialize(&allocator->residency_mutex);
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+    if (@available(macOS 15.0, iOS 18.0, *)) {
+      // Residency sets are an optimization; on failure we fall back to per-dispatch useResource.
+      MTLResidencySetDescriptor* descriptor = [MTLResidencySetDescriptor new];  // +1
+      descriptor.label = @"dev.iree.hal.metal.allocator";
+      NSError* error = nil;
+      allocator->residency_set = [device newResidencySetWithDescriptor:descriptor
+                                                                 error:&error];  // +1
+      [descriptor release];  // -1
+    }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
 
     *out_allocator = (iree_hal_allocator_t*)allocator;
   }
@@ -83,6 +109,12 @@ static void iree_hal_metal_allocator_destroy(iree_hal_allocator_t* IREE_RESTRICT
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    [allocator->residency_set release];  // -1
+  }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  iree_slim_mutex_deinitialize(&allocator->residency_mutex);
   [allocator->device release];  // -1
   iree_allocator_free(host_allocator, allocator);
 
@@ -103,6 +135,74 @@ id<MTLCommandQueue> iree_hal_metal_allocator_command_queue(
 }
 #endif  // IREE_PLATFORM_MACOS
 
+bool iree_hal_metal_allocator_has_residency_set(const iree_hal_allocator_t* base_allocator) {
+  if (!iree_hal_resource_is(base_allocator, &iree_hal_metal_allocator_vtable)) return false;
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    const iree_hal_metal_allocator_t* allocator =
+        iree_hal_metal_allocator_const_cast(base_allocator);
+    return allocator->residency_set != nil;
+  }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  return false;
+}
+
+void iree_hal_metal_allocator_attach_residency_set(iree_hal_allocator_t* base_allocator,
+                                                   id<MTLCommandQueue> queue) {
+  if (!iree_hal_metal_allocator_has_residency_set(base_allocator)) return;
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
+    [queue addResidencySet:allocator->residency_set];
+  }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+}
+
+void iree_hal_metal_allocator_commit_residency(iree_hal_allocator_t* base_allocator) {
+  if (!iree_hal_metal_allocator_has_residency_set(base_allocator)) return;
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
+    iree_slim_mutex_lock(&allocator->residency_mutex);
+    if (allocator->residency_dirty) {
+      IREE_TRACE_ZONE_BEGIN(z0);
+      [allocator->residency_set commit];
+      allocator->residency_dirty = false;
+      IREE_TRACE_ZONE_END(z0);
+    }
+    iree_slim_mutex_unlock(&allocator->residency_mutex);
+  }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+}
+
+// Adds |metal_buffer| to the residency set of |allocator|, if any.
+static void iree_hal_metal_allocator_make_resident(iree_hal_metal_allocator_t* allocator,
+                                                   id<MTLBuffer> metal_buffer) {
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    if (!allocator->residency_set) return;
+    iree_slim_mutex_lock(&allocator->residency_mutex);
+    [allocator->residency_set addAllocation:metal_buffer];
+    allocator->residency_dirty = true;
+    iree_slim_mutex_unlock(&allocator->residency_mutex);
+  }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+}
+
+// Removes |metal_buffer| from the residency set of |allocator|, if any.
+static void iree_hal_metal_allocator_evict(iree_hal_metal_allocator_t* allocator,
+                                           id<MTLBuffer> metal_buffer) {
+#if IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+  if (@available(macOS 15.0, iOS 18.0, *)) {
+    if (!allocator->residency_set) return;
+    iree_slim_mutex_lock(&allocator->residency_mutex);
+    [allocator->residency_set removeAllocation:metal_buffer];
+    allocator->residency_dirty = true;
+    iree_slim_mutex_unlock(&allocator->residency_mutex);
+  }
+#endif  // IREE_HAL_METAL_HAVE_RESIDENCY_SETS
+}
+
 static iree_status_t iree_hal_metal_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
   return iree_ok_status();
@@ -138,13 +238,23 @@ static iree_hal_buffer_compatibility_t iree_hal_metal_allocator_query_buffer_com
     }
   }
 
-  if (iree_all_bits_set(params->type,
-                        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
+  iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
+  if (allocator->use_unified_storage &&
+      iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    // Device-local memory is system memory: use shared storage so that the host can map the
+    // buffer directly and transfers become memcpys instead of staged blit copies. Cached so that
+    // host reads of results don't go through write-combined memory.
+    params->type |= IREE_HAL_MEMORY_TYPE_HOST_VISIBLE | IREE_HAL_MEMORY_TYPE_HOST_COHERENT |
+                    IREE_HAL_MEMORY_TYPE_HOST_CACHED;
+    params->usage |= IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                     IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |
+                     IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM;
+  } else if (iree_all_bits_set(params->type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL |
+                                                 IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
     // On iOS, we don't have device local + host visible memory. But given the unified memory
     // architecture, it's fine to just request host local + device visible memory.
     // On macOS, for unified memory architecture, it's similar to iOS. Otherwise, we can have
     // device local + host visible memory backed by Managed storage mode.
-    iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
     if (allocator->is_unified_memory) {
       params->type &= ~(IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE);
       params->type |= IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
@@ -192,10 +302,9 @@ static MTLResourceOptions iree_hal_metal_select_resource_options(
     if (iree_all_bits_set(type, IREE_HAL_MEMORY_TYPE_HOST_VISIBLE)) {
       // Device local + host visible.
       // iree_hal_metal_allocator_query_buffer_compatibility guarantees that we only fall into this
-      // case for macOS devices with non-uniform memory.
+      // case for macOS devices with non-uniform memory or when unified storage was requested.
 #if defined(IREE_PLATFORM_MACOS)
-      IREE_ASSERT(!is_unified_memory);
-      options = MTLResourceStorageModeManaged;
+      options = is_unified_memory ? MTLResourceStorageModeShared : MTLResourceStorageModeManaged;
 #else
       options = MTLResourceStorageModeShared;
 #endif  // IREE_PLATFORM_MACOS
@@ -283,6 +392,7 @@ static iree_status_t iree_hal_metal_allocator_allocate_buffer(
       iree_hal_buffer_release_callback_null(), &buffer);  // +1
 
   if (iree_status_is_ok(status)) {
+    iree_hal_metal_allocator_make_resident(allocator, metal_buffer);
     IREE_TRACE_ALLOC_NAMED(IREE_HAL_METAL_ALLOCATOR_ID, (void*)iree_hal_metal_buffer_handle(buffer),
                            allocation_size);
     IREE_STATISTICS(iree_hal_allocator_statistics_record_alloc(
@@ -303,6 +413,8 @@ static void iree_hal_metal_allocator_deallocate_buffer(
     iree_hal_buffer_t* IREE_RESTRICT base_buffer) {
   iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
 
+  iree_hal_metal_allocator_evict(allocator, iree_hal_metal_buffer_handle(base_buffer));
+
   IREE_TRACE_FREE_NAMED(IREE_HAL_METAL_ALLOCATOR_ID,
                         (void*)iree_hal_metal_buffer_handle(base_buffer));
   IREE_STATISTICS(iree_hal_allocator_statistics_record_free(
@@ -334,13 +446,17 @@ static iree_status_t iree_hal_metal_allocator_import_host_buffer(
     return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED, "unable to allocate buffer");
   }
 
-  return iree_hal_metal_buffer_wrap(
+  iree_status_t status = iree_hal_metal_buffer_wrap(
 #if defined(IREE_PLATFORM_MACOS)
       allocator->queue,
 #endif  // IREE_PLATFORM_MACOS
       metal_buffer, base_allocator, params->type, params->access, params->usage,
       external_buffer->size, /*byte_offset=*/0, /*byte_length=*/external_buffer->size,
       release_callback, out_buffer);  // +1
+  if (iree_status_is_ok(status)) {
+    iree_hal_metal_allocator_make_resident(allocator, metal_buffer);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_metal_allocator_import_device_buffer(
@@ -350,7 +466,6 @@ static iree_status_t iree_hal_metal_allocator_import_device_buffer(
     iree_hal_buffer_release_callback_t release_callback,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   iree_hal_metal_allocator_t* allocator = iree_hal_metal_allocator_cast(base_allocator);
-  (void)allocator;
 
   // Device allocation is an unowned MTLBuffer; we need to retain it to keep it live.
   id<MTLBuffer> metal_buffer =
@@ -361,13 +476,17 @@ static iree_status_t iree_hal_metal_allocator_import_device_buffer(
 
   // Wrap the externally-provided buffer in a HAL buffer handle that will retain the MTLBuffer until
   // it has been released.
-  return iree_hal_metal_buffer_wrap(
+  iree_status_t status = iree_hal_metal_buffer_wrap(
 #if defined(IREE_PLATFORM_MACOS)
       allocator->queue,
 #endif  // IREE_PLATFORM_MACOS
       metal_buffer, base_allocator, params->type, params->access, params->usage,
       external_buffer->size, /*byte_offset=*/0, /*byte_length=*/external_buffer->size,
       release_callback, out_buffer);  // +1
+  if (iree_status_is_ok(status)) {
+    iree_hal_metal_allocator_make_resident(allocator, metal_buffer);
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_metal_allocator_import_buffer(
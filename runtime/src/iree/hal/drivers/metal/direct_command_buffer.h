@@ -20,7 +20,15 @@ extern "C" {
 #endif  // __cplusplus
 
 // Creates a Metal command buffer that directly records into a MTLCommandBuffer.
-// Such command buffers are one shot--they can only be submitted once.
+//
+// One-shot command buffers are recorded into a single MTLCommandBuffer when
+// recording ends and can only be submitted once. Reusable command buffers that
+// only contain dispatches with static workgroup counts and barriers are encoded
+// once into a MTLIndirectCommandBuffer that is executed by each submission;
+// others are recorded again into a new MTLCommandBuffer for each submission
+// while reusing argument buffers encoded by the first one. Argument buffers and
+// uploaded data stay in |staging_buffer| for the lifetime of the command
+// buffer.
 //
 // The command buffer would have the given |mode| and be recorded and submitted
 // to the given |queue|.
@@ -52,10 +60,16 @@ iree_status_t iree_hal_metal_direct_command_buffer_create(
 bool iree_hal_metal_direct_command_buffer_isa(
     iree_hal_command_buffer_t* command_buffer);
 
-// Returns the underlying Metal command buffer handle for the given
-// |command_buffer|.
-id<MTLCommandBuffer> iree_hal_metal_direct_command_buffer_handle(
-    const iree_hal_command_buffer_t* command_buffer);
+// Returns the Metal command buffer handle to commit for a submission of the
+// given |command_buffer| in |out_handle|.
+//
+// One-shot command buffers return the handle recorded into when recording
+// ended. Reusable command buffers return a new autoreleased handle for each
+// submission that either executes the indirect command buffer encoded when
+// recording ended or has all commands recorded into it again.
+iree_status_t iree_hal_metal_direct_command_buffer_acquire_handle(
+    iree_hal_command_buffer_t* command_buffer,
+    id<MTLCommandBuffer>* out_handle);
 
 #ifdef __cplusplus
 }  // extern "C"
@@ -13,6 +13,7 @@
 #include "iree/base/tracing.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/metal/builtin_executables.h"
+#include "iree/hal/drivers/metal/direct_allocator.h"
 #include "iree/hal/drivers/metal/kernel_library.h"
 #include "iree/hal/drivers/metal/metal_buffer.h"
 #include "iree/hal/drivers/metal/metal_device.h"
@@ -90,6 +91,16 @@ typedef struct iree_hal_metal_dispatch_segment_t {
   iree_host_size_t push_constant_count;
   // The list of push constants, pointing to the end of the segment allocation.
   int32_t* push_constants;
+
+  // Argument buffers for all bound descriptor sets in the staging buffer. Encoded on first record
+  // and reused by later submissions of reusable command buffers.
+  bool arguments_encoded;
+  iree_host_size_t argument_buffer_count;
+  struct {
+    uint32_t set;
+    uint32_t offset;
+    id<MTLBuffer> buffer;
+  } argument_buffers[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_COUNT];
 } iree_hal_metal_dispatch_segment_t;
 // + Additional inline allocation for holding all bound descriptors.
 // + Additional inline allocation for holding all push constants.
@@ -179,14 +190,42 @@ typedef struct iree_hal_metal_command_buffer_t {
 
   iree_allocator_t host_allocator;
 
+  // Device allocator whose buffers are all kept resident on the queue with a residency set and are
+  // not hazard tracked by Metal. Such buffers need not be declared with useResource. NULL if none.
+  const iree_hal_allocator_t* resident_allocator;
+
   // Maintains a reference to all resources used within the command buffer. Resets on each begin.
   iree_hal_resource_set_t* resource_set;
 
   // Linked list of command segments to be recorded into a command buffer.
   iree_hal_metal_command_segment_list_t segments;
 
+  // The Metal command buffer being recorded. One-shot command buffers record into it once at the
+  // end of recording; reusable command buffers without an indirect command buffer re-record their
+  // segments into a new one for each submission.
   id<MTLCommandBuffer> command_buffer;
 
+  // Descriptor used to create Metal command buffers for each submission of reusable command
+  // buffers.
+  MTLCommandBufferDescriptor* command_buffer_descriptor;
+
+  // Serializes submissions of reusable command buffers, which may be submitted from multiple
+  // threads concurrently but share the recording state and Metal command buffer handle.
+  iree_slim_mutex_t submit_mutex;
+
+  // Reusable command buffers containing only direct dispatches and barriers are encoded once into
+  // an indirect command buffer that each submission executes without re-encoding.
+  struct {
+    // nil if the segments must be recorded for each submission instead.
+    id<MTLIndirectCommandBuffer> handle;
+    NSUInteger command_count;
+    // All resources referenced by the indirect commands, allocated from the arena.
+    id<MTLResource>* read_resources;
+    NSUInteger read_resource_count;
+    id<MTLResource>* write_resources;
+    NSUInteger write_resource_count;
+  } indirect;
+
   MTLDispatchType dispatch_type;
 
   struct {
@@ -237,11 +276,10 @@ static const iree_hal_metal_command_buffer_t* iree_hal_metal_command_buffer_cons
   return (const iree_hal_metal_command_buffer_t*)base_value;
 }
 
-id<MTLCommandBuffer> iree_hal_metal_direct_command_buffer_handle(
-    const iree_hal_command_buffer_t* base_command_buffer) {
-  const iree_hal_metal_command_buffer_t* command_buffer =
-      iree_hal_metal_command_buffer_const_cast(base_command_buffer);
-  return command_buffer->command_buffer;
+static bool iree_hal_metal_command_buffer_is_one_shot(
+    const iree_hal_metal_command_buffer_t* command_buffer) {
+  return iree_all_bits_set(iree_hal_command_buffer_mode(&command_buffer->base),
+                           IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
 }
 
 static void iree_hal_metal_end_compute_encoder(iree_hal_metal_command_buffer_t* command_buffer) {
@@ -264,6 +302,8 @@ static void iree_hal_metal_command_buffer_reset(iree_hal_metal_command_buffer_t*
   IREE_TRACE_ZONE_BEGIN(z0);
   iree_hal_metal_end_blit_encoder(command_buffer);
   iree_hal_metal_end_compute_encoder(command_buffer);
+  [command_buffer->indirect.handle release];  // -1
+  memset(&command_buffer->indirect, 0, sizeof(command_buffer->indirect));
   iree_hal_metal_command_segment_list_reset(&command_buffer->segments);
   iree_arena_reset(&command_buffer->arena);
   IREE_TRACE_ZONE_END(z0);
@@ -341,7 +381,6 @@ iree_status_t iree_hal_metal_direct_command_buffer_create(
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(device);
   IREE_ASSERT_ARGUMENT(out_command_buffer);
-  IREE_ASSERT_TRUE(iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT));
   IREE_ASSERT_TRUE(!iree_any_bit_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED));
   *out_command_buffer = NULL;
 
@@ -365,6 +404,7 @@ iree_status_t iree_hal_metal_direct_command_buffer_create(
   iree_arena_initialize(block_pool, &command_buffer->arena);
   command_buffer->staging_buffer = staging_buffer;
   command_buffer->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&command_buffer->submit_mutex);
   iree_status_t status = iree_hal_resource_set_allocate(block_pool, &command_buffer->resource_set);
   if (iree_status_is_ok(status)) {
     iree_hal_metal_command_segment_list_reset(&command_buffer->segments);
@@ -375,15 +415,24 @@ iree_status_t iree_hal_metal_direct_command_buffer_create(
       descriptor.retainedReferences =
           resource_reference_mode == IREE_HAL_METAL_COMMAND_BUFFER_RESOURCE_REFERENCE_MODE_RETAINED;
       descriptor.errorOptions = MTLCommandBufferErrorOptionNone;
-      command_buffer->command_buffer =
-          [[queue commandBufferWithDescriptor:descriptor] retain];  // +1
-      [descriptor release];                                         // -1
+      command_buffer->command_buffer_descriptor = descriptor;
+      // Reusable command buffers get a new Metal command buffer for each submission.
+      if (iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+        command_buffer->command_buffer =
+            [[queue commandBufferWithDescriptor:descriptor] retain];  // +1
+      }
     }
     const iree_hal_metal_device_params_t* params = iree_hal_metal_device_params(device);
     command_buffer->dispatch_type =
         params->command_dispatch_type == IREE_HAL_METAL_COMMAND_DISPATCH_TYPE_CONCURRENT
             ? MTLDispatchTypeConcurrent
             : MTLDispatchTypeSerial;
+    iree_hal_allocator_t* device_allocator = iree_hal_device_allocator(device);
+    if (params->resource_hazard_tracking_mode ==
+            IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_UNTRACKED &&
+        iree_hal_metal_allocator_has_residency_set(device_allocator)) {
+      command_buffer->resident_allocator = device_allocator;
+    }
     command_buffer->state.compute_encoder = nil;
     command_buffer->state.blit_encoder = nil;
     command_buffer->state.encoder_event = [queue.device newEvent];  // +1
@@ -416,8 +465,10 @@ static void iree_hal_metal_command_buffer_destroy_internal(
   [command_buffer->state.encoder_event release];  // -1
   IREE_ASSERT_EQ(command_buffer->state.compute_encoder, nil);
   IREE_ASSERT_EQ(command_buffer->state.blit_encoder, nil);
-  [command_buffer->command_buffer release];  // -1
-  [command_buffer->queue release];           // -1
+  [command_buffer->command_buffer release];             // -1
+  [command_buffer->command_buffer_descriptor release];  // -1
+  [command_buffer->queue release];                      // -1
+  iree_slim_mutex_deinitialize(&command_buffer->submit_mutex);
   iree_hal_resource_set_free(command_buffer->resource_set);
   iree_arena_deinitialize(&command_buffer->arena);
   iree_allocator_free(command_buffer->host_allocator, command_buffer);
@@ -786,10 +837,11 @@ static iree_status_t iree_hal_metal_command_buffer_prepare_update_buffer(
 
   iree_const_byte_span_t source_data_span =
       iree_make_const_byte_span((uint8_t*)source_buffer + source_offset, length);
+  id<MTLBuffer> staging_buffer = nil;
   uint32_t offset = 0;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_metal_staging_buffer_append(command_buffer->staging_buffer, source_data_span,
-                                               /*alignment=*/4, &offset));
+                                               /*alignment=*/4, &staging_buffer, &offset));
 
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_resource_set_insert(command_buffer->resource_set, 1, &target_buffer));
@@ -799,8 +851,7 @@ static iree_status_t iree_hal_metal_command_buffer_prepare_update_buffer(
   target_offset += iree_hal_buffer_byte_offset(target_buffer);
 
   iree_status_t status = iree_hal_metal_command_segment_create_copy_buffer(
-      command_buffer, command_buffer->staging_buffer->metal_buffer, offset, target_device_buffer,
-      target_offset, length);
+      command_buffer, staging_buffer, offset, target_device_buffer, target_offset, length);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
@@ -987,45 +1038,47 @@ static iree_status_t iree_hal_metal_command_segment_create_dispatch(
   return iree_ok_status();
 }
 
-static iree_status_t iree_hal_metal_command_segment_record_dispatch(
+// Returns true if |buffer| is kept resident by the device residency set and needs no useResource.
+static inline bool iree_hal_metal_command_buffer_is_resident(
+    const iree_hal_metal_command_buffer_t* command_buffer, iree_hal_buffer_t* buffer) {
+  return command_buffer->resident_allocator &&
+         iree_hal_buffer_allocated_buffer(buffer)->device_allocator ==
+             command_buffer->resident_allocator;
+}
+
+// Encodes the argument buffers for all descriptor sets bound to |segment| into the staging buffer.
+// Argument buffers are only encoded once; reusable command buffers reuse them across submissions.
+static iree_status_t iree_hal_metal_command_segment_encode_arguments(
     iree_hal_metal_command_buffer_t* command_buffer, iree_hal_metal_dispatch_segment_t* segment) {
+  if (segment->arguments_encoded) return iree_ok_status();
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Set the compute kernel to dispatch.
-  id<MTLComputeCommandEncoder> compute_encoder =
-      iree_hal_metal_get_or_begin_compute_encoder(command_buffer);
-  [compute_encoder setComputePipelineState:segment->kernel_params.pso];
-
-  // Record push constants.
-  if (segment->push_constant_count != 0) {
-    [compute_encoder setBytes:(void*)segment->push_constants
-                       length:segment->push_constant_count * sizeof(int32_t)
-                      atIndex:IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX];
-  }
-
-  // Record argument buffers for all descriptors and record buffer usages.
   iree_hal_metal_descriptor_t* descriptors = segment->descriptors;
+  iree_slim_mutex_t* argument_encoder_mutex = segment->kernel_params.argument_encoder_mutex;
+  segment->argument_buffer_count = 0;
   for (iree_host_size_t i = 0; i < segment->descriptor_count;) {
     uint32_t current_set = descriptors[i].set;
 
-    // Build argument encoder and argument buffer for the current descriptor set.
+    // Use the cached argument encoder to build the argument buffer for the current set.
     // TODO(antiagainst): Use a cache layer to cache and reuse argument buffers with the same
     // content, to avoid duplicating overhead.
-    id<MTLBuffer> argument_buffer = command_buffer->staging_buffer->metal_buffer;
     id<MTLArgumentEncoder> argument_encoder =
-        [segment->kernel_params.function newArgumentEncoderWithBufferIndex:current_set];  // +1
+        segment->kernel_params.argument_encoders[current_set];
     IREE_ASSERT(argument_encoder != nil);
 
     // Reserve space for the argument buffer from shared staging buffer.
     iree_byte_span_t reservation;
+    id<MTLBuffer> argument_buffer = nil;
     uint32_t argument_buffer_offset;
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, iree_hal_metal_staging_buffer_reserve(
                 command_buffer->staging_buffer, argument_encoder.encodedLength,
-                argument_encoder.alignment, &reservation, &argument_buffer_offset));
-    [argument_encoder setArgumentBuffer:argument_buffer offset:argument_buffer_offset];
+                argument_encoder.alignment, &reservation, &argument_buffer,
+                &argument_buffer_offset));
 
     // Now record all bound buffers belonging to the current set into the argument buffer.
+    iree_slim_mutex_lock(argument_encoder_mutex);
+    [argument_encoder setArgumentBuffer:argument_buffer offset:argument_buffer_offset];
     for (; i < segment->descriptor_count && descriptors[i].set == current_set; ++i) {
       uint32_t current_binding = descriptors[i].binding;
       id<MTLBuffer> current_buffer =
@@ -1033,16 +1086,99 @@ static iree_status_t iree_hal_metal_command_segment_record_dispatch(
       iree_host_size_t offset =
           iree_hal_buffer_byte_offset(descriptors[i].buffer) + descriptors[i].offset;
       [argument_encoder setBuffer:current_buffer offset:offset atIndex:current_binding];
+    }
+    iree_slim_mutex_unlock(argument_encoder_mutex);
+
+    segment->argument_buffers[segment->argument_buffer_count].set = current_set;
+    segment->argument_buffers[segment->argument_buffer_count].buffer = argument_buffer;
+    segment->argument_buffers[segment->argument_buffer_count].offset = argument_buffer_offset;
+    ++segment->argument_buffer_count;
+  }
+  segment->arguments_encoded = true;
 
-      // Also record buffer usages.
-      [compute_encoder useResource:current_buffer usage:descriptors[i].usage];
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Appends the buffers bound to |segment| that must be declared with useResources to
+// |read_resources| or |write_resources| based on their usage. Resources resident through the device
+// residency set need no declaration when hazards are not tracked by Metal.
+static void iree_hal_metal_command_segment_collect_resources(
+    const iree_hal_metal_command_buffer_t* command_buffer,
+    const iree_hal_metal_dispatch_segment_t* segment, id<MTLResource>* read_resources,
+    NSUInteger* read_resource_count, id<MTLResource>* write_resources,
+    NSUInteger* write_resource_count) {
+  const iree_hal_metal_descriptor_t* descriptors = segment->descriptors;
+  for (iree_host_size_t i = 0; i < segment->descriptor_count; ++i) {
+    if (iree_hal_metal_command_buffer_is_resident(command_buffer, descriptors[i].buffer)) {
+      continue;
     }
-    // Record the argument buffer.
-    [compute_encoder setBuffer:argument_buffer offset:argument_buffer_offset atIndex:current_set];
+    id<MTLBuffer> current_buffer =
+        iree_hal_metal_buffer_handle(iree_hal_buffer_allocated_buffer(descriptors[i].buffer));
+    if (descriptors[i].usage & MTLResourceUsageWrite) {
+      write_resources[(*write_resource_count)++] = current_buffer;
+    } else {
+      read_resources[(*read_resource_count)++] = current_buffer;
+    }
+  }
+}
+
+// Declares the given resources used by the following dispatches with one call per usage kind.
+static void iree_hal_metal_compute_encoder_use_resources(id<MTLComputeCommandEncoder> encoder,
+                                                         id<MTLResource>* read_resources,
+                                                         NSUInteger read_resource_count,
+                                                         id<MTLResource>* write_resources,
+                                                         NSUInteger write_resource_count) {
+  if (read_resource_count != 0) {
+    [encoder useResources:read_resources count:read_resource_count usage:MTLResourceUsageRead];
+  }
+  if (write_resource_count != 0) {
+    [encoder useResources:write_resources
+                    count:write_resource_count
+                    usage:MTLResourceUsageRead | MTLResourceUsageWrite];
+  }
+}
+
+static iree_status_t iree_hal_metal_command_segment_record_dispatch(
+    iree_hal_metal_command_buffer_t* command_buffer, iree_hal_metal_dispatch_segment_t* segment) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_metal_command_segment_encode_arguments(command_buffer, segment));
+
+  // Set the compute kernel to dispatch.
+  id<MTLComputeCommandEncoder> compute_encoder =
+      iree_hal_metal_get_or_begin_compute_encoder(command_buffer);
+  [compute_encoder setComputePipelineState:segment->kernel_params.pso];
+
+  // Record push constants.
+  if (segment->push_constant_count != 0) {
+    [compute_encoder setBytes:(void*)segment->push_constants
+                       length:segment->push_constant_count * sizeof(int32_t)
+                      atIndex:IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX];
+  }
 
-    [argument_encoder release];  // -1
+  // Record argument buffers for all descriptor sets.
+  for (iree_host_size_t i = 0; i < segment->argument_buffer_count; ++i) {
+    [compute_encoder setBuffer:segment->argument_buffers[i].buffer
+                        offset:segment->argument_buffers[i].offset
+                       atIndex:segment->argument_buffers[i].set];
   }
 
+  // Record buffer usages. Resources are batched by usage so that each kind only needs a single
+  // useResources call.
+  id<MTLResource> read_resources[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_COUNT *
+                                 IREE_HAL_METAL_MAX_DESCRIPTOR_SET_BINDING_COUNT];
+  id<MTLResource> write_resources[IREE_ARRAYSIZE(read_resources)];
+  NSUInteger read_resource_count = 0;
+  NSUInteger write_resource_count = 0;
+  iree_hal_metal_command_segment_collect_resources(command_buffer, segment, read_resources,
+                                                   &read_resource_count, write_resources,
+                                                   &write_resource_count);
+  iree_hal_metal_compute_encoder_use_resources(compute_encoder, read_resources,
+                                               read_resource_count, write_resources,
+                                               write_resource_count);
+
   // Record the dispatch, either direct or indirect.
   uint32_t* workgroup_size = segment->kernel_params.threadgroup_size;
   if (segment->workgroups_buffer == nil) {
@@ -1149,12 +1285,152 @@ static iree_status_t iree_hal_metal_command_buffer_begin(
   return iree_ok_status();
 }
 
+// Alignment of push constant data uploaded to the staging buffer for indirect commands.
+// Metal requires buffers in the constant address space to be bound at 256 byte offsets on macOS.
+#if defined(IREE_PLATFORM_MACOS)
+#define IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_ALIGNMENT 256
+#else
+#define IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_ALIGNMENT 16
+#endif  // IREE_PLATFORM_MACOS
+
+// Encodes all segments of a reusable command buffer into an indirect command buffer if they only
+// contain direct dispatches and barriers. Otherwise leaves the segments to be recorded for each
+// submission.
+static iree_status_t iree_hal_metal_command_buffer_encode_indirect(
+    iree_hal_metal_command_buffer_t* command_buffer) {
+  // Indirect compute commands can only dispatch a fixed workgroup count and cannot express blit
+  // operations or builtin kernels.
+  NSUInteger command_count = 0;
+  iree_host_size_t max_resource_count = 0;
+  for (iree_hal_metal_command_segment_t* segment = command_buffer->segments.head; segment;
+       segment = segment->next_segment) {
+    if (segment->action == IREE_HAL_METAL_COMMAND_SEGMENT_ACTION_BARRIER) continue;
+    if (segment->action != IREE_HAL_METAL_COMMAND_SEGMENT_ACTION_DISPATCH ||
+        segment->dispatch.workgroups_buffer != nil) {
+      return iree_ok_status();
+    }
+    ++command_count;
+    // All bound buffers plus argument buffers and push constants in the staging buffer.
+    max_resource_count +=
+        segment->dispatch.descriptor_count + IREE_HAL_METAL_MAX_DESCRIPTOR_SET_COUNT + 1;
+  }
+  if (command_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, command_count);
+
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_arena_allocate(&command_buffer->arena,
+                              max_resource_count * sizeof(id<MTLResource>) * 2,
+                              (void**)&command_buffer->indirect.read_resources));
+  command_buffer->indirect.write_resources =
+      command_buffer->indirect.read_resources + max_resource_count;
+
+  MTLIndirectCommandBufferDescriptor* descriptor =
+      [MTLIndirectCommandBufferDescriptor new];  // +1
+  descriptor.commandTypes = MTLIndirectCommandTypeConcurrentDispatch;
+  descriptor.inheritBuffers = NO;
+  descriptor.inheritPipelineState = NO;
+  descriptor.maxKernelBufferBindCount = IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX + 1;
+  id<MTLIndirectCommandBuffer> indirect_buffer =
+      [command_buffer->queue.device newIndirectCommandBufferWithDescriptor:descriptor
+                                                            maxCommandCount:command_count
+                                                                    options:0];  // +1
+  [descriptor release];  // -1
+  if (!indirect_buffer) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "failed to create indirect command buffer with %lu commands",
+                            (unsigned long)command_count);
+  }
+
+  // Serial dispatch types require each command to wait for the previous one. Otherwise commands
+  // only wait where the command buffer has barriers.
+  const bool serial = command_buffer->dispatch_type == MTLDispatchTypeSerial;
+  bool pending_barrier = false;
+  NSUInteger command_index = 0;
+  iree_status_t status = iree_ok_status();
+  for (iree_hal_metal_command_segment_t* segment = command_buffer->segments.head; segment;
+       segment = segment->next_segment) {
+    if (segment->action == IREE_HAL_METAL_COMMAND_SEGMENT_ACTION_BARRIER) {
+      pending_barrier = true;
+      continue;
+    }
+    iree_hal_metal_dispatch_segment_t* dispatch = &segment->dispatch;
+    status = iree_hal_metal_command_segment_encode_arguments(command_buffer, dispatch);
+    if (!iree_status_is_ok(status)) break;
+
+    id<MTLIndirectComputeCommand> command =
+        [indirect_buffer indirectComputeCommandAtIndex:command_index++];
+    [command setComputePipelineState:dispatch->kernel_params.pso];
+    for (iree_host_size_t i = 0; i < dispatch->argument_buffer_count; ++i) {
+      [command setKernelBuffer:dispatch->argument_buffers[i].buffer
+                        offset:dispatch->argument_buffers[i].offset
+                       atIndex:dispatch->argument_buffers[i].set];
+      command_buffer->indirect.read_resources[command_buffer->indirect.read_resource_count++] =
+          dispatch->argument_buffers[i].buffer;
+    }
+
+    // Indirect commands cannot set inline bytes so push constants are uploaded to the staging
+    // buffer alongside the argument buffers.
+    if (dispatch->push_constant_count != 0) {
+      id<MTLBuffer> push_constant_buffer = nil;
+      uint32_t push_constant_offset = 0;
+      status = iree_hal_metal_staging_buffer_append(
+          command_buffer->staging_buffer,
+          iree_make_const_byte_span(dispatch->push_constants,
+                                    dispatch->push_constant_count * sizeof(int32_t)),
+          IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_ALIGNMENT, &push_constant_buffer,
+          &push_constant_offset);
+      if (!iree_status_is_ok(status)) break;
+      [command setKernelBuffer:push_constant_buffer
+                        offset:push_constant_offset
+                       atIndex:IREE_HAL_METAL_PUSH_CONSTANT_BUFFER_INDEX];
+      command_buffer->indirect.read_resources[command_buffer->indirect.read_resource_count++] =
+          push_constant_buffer;
+    }
+
+    iree_hal_metal_command_segment_collect_resources(
+        command_buffer, dispatch, command_buffer->indirect.read_resources,
+        &command_buffer->indirect.read_resource_count, command_buffer->indirect.write_resources,
+        &command_buffer->indirect.write_resource_count);
+
+    if (serial || pending_barrier) [command setBarrier];
+    pending_barrier = false;
+
+    uint32_t* workgroup_count = dispatch->workgroup_count;
+    uint32_t* workgroup_size = dispatch->kernel_params.threadgroup_size;
+    [command concurrentDispatchThreadgroups:MTLSizeMake(workgroup_count[0], workgroup_count[1],
+                                                        workgroup_count[2])
+                      threadsPerThreadgroup:MTLSizeMake(workgroup_size[0], workgroup_size[1],
+                                                        workgroup_size[2])];
+  }
+
+  if (iree_status_is_ok(status)) {
+    command_buffer->indirect.handle = indirect_buffer;
+    command_buffer->indirect.command_count = command_count;
+  } else {
+    [indirect_buffer release];  // -1
+    command_buffer->indirect.read_resource_count = 0;
+    command_buffer->indirect.write_resource_count = 0;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_metal_command_buffer_end(
     iree_hal_command_buffer_t* base_command_buffer) {
   iree_hal_metal_command_buffer_t* command_buffer =
       iree_hal_metal_command_buffer_cast(base_command_buffer);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Reusable command buffers are recorded when submitted unless they can be encoded once now.
+  if (!iree_hal_metal_command_buffer_is_one_shot(command_buffer)) {
+    iree_status_t status = iree_hal_metal_command_buffer_encode_indirect(command_buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
   IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, iree_hal_metal_command_segment_record(command_buffer));
   iree_hal_metal_end_blit_encoder(command_buffer);
   iree_hal_metal_end_compute_encoder(command_buffer);
@@ -1163,6 +1439,49 @@ static iree_status_t iree_hal_metal_command_buffer_end(
   return iree_ok_status();
 }
 
+iree_status_t iree_hal_metal_direct_command_buffer_acquire_handle(
+    iree_hal_command_buffer_t* base_command_buffer, id<MTLCommandBuffer>* out_handle) {
+  iree_hal_metal_command_buffer_t* command_buffer =
+      iree_hal_metal_command_buffer_cast(base_command_buffer);
+  *out_handle = nil;
+  if (iree_hal_metal_command_buffer_is_one_shot(command_buffer)) {
+    *out_handle = command_buffer->command_buffer;
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&command_buffer->submit_mutex);
+  id<MTLCommandBuffer> handle = [command_buffer->queue
+      commandBufferWithDescriptor:command_buffer->command_buffer_descriptor];  // autoreleased
+  iree_status_t status = iree_ok_status();
+  if (command_buffer->indirect.handle) {
+    // All commands were encoded at the end of recording; only the resources they reference need to
+    // be declared again for the new encoder.
+    id<MTLComputeCommandEncoder> encoder =
+        [handle computeCommandEncoderWithDispatchType:command_buffer->dispatch_type];
+    iree_hal_metal_compute_encoder_use_resources(
+        encoder, command_buffer->indirect.read_resources,
+        command_buffer->indirect.read_resource_count, command_buffer->indirect.write_resources,
+        command_buffer->indirect.write_resource_count);
+    [encoder executeCommandsInBuffer:command_buffer->indirect.handle
+                           withRange:NSMakeRange(0, command_buffer->indirect.command_count)];
+    [encoder endEncoding];
+  } else {
+    // Record all segments into the new command buffer. Argument buffers were encoded by the first
+    // submission and are reused.
+    [command_buffer->command_buffer release];        // -1
+    command_buffer->command_buffer = [handle retain];  // +1
+    status = iree_hal_metal_command_segment_record(command_buffer);
+    iree_hal_metal_end_blit_encoder(command_buffer);
+    iree_hal_metal_end_compute_encoder(command_buffer);
+  }
+  iree_slim_mutex_unlock(&command_buffer->submit_mutex);
+
+  if (iree_status_is_ok(status)) *out_handle = handle;
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static const iree_hal_command_buffer_vtable_t iree_hal_metal_command_buffer_vtable = {
     .destroy = iree_hal_metal_command_buffer_destroy,
     .begin = iree_hal_metal_command_buffer_begin,
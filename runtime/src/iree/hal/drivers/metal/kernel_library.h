@@ -12,7 +12,9 @@
 
 #include "iree/base/api.h"
 #include "iree/base/tracing.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/metal/pipeline_layout.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -25,6 +27,13 @@ typedef struct iree_hal_metal_kernel_params_t {
   id<MTLComputePipelineState> pso;
   uint32_t threadgroup_size[3];
   iree_hal_pipeline_layout_t* layout;
+  // Argument encoders for each descriptor set in |layout|, created once with
+  // the pipeline state. Encoders hold the argument buffer they are encoding
+  // into and must only be used with |argument_encoder_mutex| held.
+  // nil for kernels that do not use argument buffers.
+  id<MTLArgumentEncoder>
+      argument_encoders[IREE_HAL_METAL_MAX_DESCRIPTOR_SET_COUNT];
+  iree_slim_mutex_t* argument_encoder_mutex;
   IREE_TRACE(iree_string_view_t function_name;)
 } iree_hal_metal_kernel_params_t;
 
@@ -38,10 +47,15 @@ typedef struct iree_hal_metal_kernel_params_t {
 // This class bundles all the necessary Metal objects for getting pipeline state
 // objects for a compute kernel.
 //
+// If |binary_archive| is provided compute pipelines are looked up in it and any
+// pipelines not found are compiled and added to it. The caller is responsible
+// for serializing the archive.
+//
 // |out_executable| must be released by the caller (see
 // iree_hal_executable_release).
 iree_status_t iree_hal_metal_kernel_library_create(
-    id<MTLDevice> device, const iree_hal_executable_params_t* executable_params,
+    id<MTLDevice> device, id<MTLBinaryArchive> binary_archive,
+    const iree_hal_executable_params_t* executable_params,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable);
 
 // Returns the kernel launch parameters for the given |entry_point|.
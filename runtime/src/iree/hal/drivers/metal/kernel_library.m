@@ -21,6 +21,10 @@ typedef struct iree_hal_metal_kernel_library_t {
 
   iree_allocator_t host_allocator;
 
+  // Guards the argument encoders of all entry points, which may be used by multiple command
+  // buffers recording concurrently.
+  iree_slim_mutex_t argument_encoder_mutex;
+
   iree_host_size_t entry_point_count;
   iree_hal_metal_kernel_params_t entry_points[];
 } iree_hal_metal_kernel_library_t;
@@ -192,9 +196,12 @@ static iree_status_t iree_hal_metal_load_mtllib(iree_const_byte_span_t source_da
 
 // Creates MTL compute pipeline objects for the given |entry_point| in |library| and writes to
 // |out_function| and |out_pso|. The caller should release |out_function| and |out_pso| after done.
+// If |binary_archive| is provided the pipeline is loaded from it when present and otherwise added
+// to it after compilation.
 static iree_status_t iree_hal_metal_create_pipline_object(
     id<MTLLibrary> library, iree_string_view_t entry_point, const char* source_code,
-    id<MTLDevice> device, id<MTLFunction>* out_function, id<MTLComputePipelineState>* out_pso) {
+    id<MTLDevice> device, id<MTLBinaryArchive> binary_archive, id<MTLFunction>* out_function,
+    id<MTLComputePipelineState>* out_pso) {
   @autoreleasepool {
     NSError* error = nil;
     NSString* function_name =
@@ -209,7 +216,20 @@ static iree_status_t iree_hal_metal_create_pipline_object(
     }
 
     // TODO(#14047): Enable async pipeline creation at runtime.
-    *out_pso = [device newComputePipelineStateWithFunction:*out_function error:&error];  // +1
+    MTLComputePipelineDescriptor* descriptor = [[MTLComputePipelineDescriptor new] autorelease];
+    descriptor.computeFunction = *out_function;
+    // Allow encoding dispatches into indirect command buffers for reusable command buffers.
+    descriptor.supportIndirectCommandBuffers = YES;
+    if (binary_archive) descriptor.binaryArchives = @[ binary_archive ];
+    *out_pso = [device newComputePipelineStateWithDescriptor:descriptor
+                                                     options:MTLPipelineOptionNone
+                                                  reflection:nil
+                                                       error:&error];  // +1
+    // Adding a pipeline already in the archive is a no-op. Failing to add only means the pipeline
+    // will be compiled again next time so errors are ignored.
+    if (binary_archive && *out_pso != nil) {
+      [binary_archive addComputePipelineFunctionsWithDescriptor:descriptor error:nil];
+    }
     if (IREE_UNLIKELY(*out_pso == nil)) {
       [*out_function release];
       return iree_hal_metal_get_invalid_kernel_status(
@@ -227,12 +247,13 @@ iree_status_t iree_hal_metal_compile_msl_and_create_pipeline_object(
   IREE_RETURN_IF_ERROR(
       iree_hal_metal_compile_msl(source_code, entry_point, device, compile_options, out_library));
   return iree_hal_metal_create_pipline_object(*out_library, entry_point, source_code.data, device,
-                                              out_function, out_pso);
+                                              /*binary_archive=*/nil, out_function, out_pso);
 }
 
 iree_status_t iree_hal_metal_kernel_library_create(
-    id<MTLDevice> device, const iree_hal_executable_params_t* executable_params,
-    iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
+    id<MTLDevice> device, id<MTLBinaryArchive> binary_archive,
+    const iree_hal_executable_params_t* executable_params, iree_allocator_t host_allocator,
+    iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_params);
   IREE_ASSERT_ARGUMENT(out_executable);
   *out_executable = NULL;
@@ -278,6 +299,7 @@ iree_status_t iree_hal_metal_kernel_library_create(
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(&iree_hal_metal_kernel_library_vtable, &executable->resource);
     executable->host_allocator = host_allocator;
+    iree_slim_mutex_initialize(&executable->argument_encoder_mutex);
     executable->entry_point_count = entry_point_count;
 
     size_t shader_library_count = flatbuffers_string_vec_len(shader_libraries_vec);
@@ -314,7 +336,7 @@ iree_status_t iree_hal_metal_kernel_library_create(
       if (!iree_status_is_ok(status)) break;
 
       status = iree_hal_metal_create_pipline_object(library, entry_point_view, source_code, device,
-                                                    &function, &pso);
+                                                    binary_archive, &function, &pso);
       if (!iree_status_is_ok(status)) break;
 
       // Package required parameters for kernel launches for each entry point.
@@ -328,6 +350,20 @@ iree_status_t iree_hal_metal_kernel_library_create(
       params->layout = executable_params->pipeline_layouts[i];
       iree_hal_pipeline_layout_retain(params->layout);
 
+      // Create the argument encoders for each descriptor set once instead of per dispatch.
+      params->argument_encoder_mutex = &executable->argument_encoder_mutex;
+      iree_host_size_t set_count =
+          iree_hal_metal_pipeline_layout_descriptor_set_count(params->layout);
+      for (iree_host_size_t j = 0; j < set_count; ++j) {
+        params->argument_encoders[j] = [function newArgumentEncoderWithBufferIndex:j];  // +1
+        if (!params->argument_encoders[j]) {
+          status = iree_make_status(IREE_STATUS_INTERNAL,
+                                    "failed to create argument encoder for set %" PRIhsz, j);
+          break;
+        }
+      }
+      if (!iree_status_is_ok(status)) break;
+
       // Stash the entry point name in the string table for use when tracing.
       IREE_TRACE({
         iree_host_size_t entry_name_length = flatbuffers_string_len(entry_point);
@@ -356,11 +392,15 @@ static void iree_hal_metal_kernel_library_destroy(iree_hal_executable_t* base_ex
 
   for (iree_host_size_t i = 0; i < executable->entry_point_count; ++i) {
     iree_hal_metal_kernel_params_t* entry_point = &executable->entry_points[i];
+    for (iree_host_size_t j = 0; j < IREE_ARRAYSIZE(entry_point->argument_encoders); ++j) {
+      [entry_point->argument_encoders[j] release];  // -1
+    }
     [entry_point->pso release];       // -1
     [entry_point->function release];  // -1
     [entry_point->library release];   // -1
     iree_hal_pipeline_layout_release(entry_point->layout);
   }
+  iree_slim_mutex_deinitialize(&executable->argument_encoder_mutex);
   iree_allocator_free(executable->host_allocator, executable);
 
   IREE_TRACE_ZONE_END(z0);
@@ -102,6 +102,7 @@ static iree_status_t iree_hal_metal_device_create_internal(
                                     (char*)device + iree_sizeof_struct(*device));
   iree_arena_block_pool_initialize(params->arena_block_size, host_allocator, &device->block_pool);
   device->params = *params;
+  iree_hal_executable_disk_cache_retain(device->params.executable_disk_cache);
   device->host_allocator = host_allocator;
 
   device->device = [metal_device retain];                            // +1
@@ -127,9 +128,12 @@ static iree_status_t iree_hal_metal_device_create_internal(
                                                          metal_queue,
 #endif  // IREE_PLATFORM_MACOS
                                                          params->resource_hazard_tracking_mode,
-                                                         host_allocator, &device->device_allocator);
+                                                         params->unified_memory, host_allocator,
+                                                         &device->device_allocator);
 
   if (iree_status_is_ok(status)) {
+    // Keep all buffers from the device allocator resident on the queue, if supported.
+    iree_hal_metal_allocator_attach_residency_set(device->device_allocator, metal_queue);
     status = iree_hal_metal_builtin_executable_create(metal_device, host_allocator,
                                                       &device->builtin_executable);
   }
@@ -179,6 +183,8 @@ static void iree_hal_metal_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_metal_staging_buffer_deinitialize(&device->staging_buffer);
   iree_arena_block_pool_deinitialize(&device->block_pool);
 
+  iree_hal_executable_disk_cache_release(device->params.executable_disk_cache);
+
   iree_allocator_free(host_allocator, device);
 
   IREE_TRACE_ZONE_END(z0);
@@ -249,9 +255,6 @@ static iree_status_t iree_hal_metal_device_create_command_buffer(
 
   if (iree_any_bit_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED))
     return iree_make_status(IREE_STATUS_UNIMPLEMENTED, "nested command buffer not yet supported");
-  if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT))
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "multi-shot command buffer not yet supported");
 
   return iree_hal_metal_direct_command_buffer_create(
       base_device, mode, command_categories, binding_capacity,
@@ -279,6 +282,7 @@ static iree_status_t iree_hal_metal_device_create_executable_cache(
     iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_metal_device_t* device = iree_hal_metal_device_cast(base_device);
   return iree_hal_metal_nop_executable_cache_create(device->device, identifier,
+                                                    device->params.executable_disk_cache,
                                                     device->host_allocator, out_executable_cache);
 }
 
@@ -314,12 +318,30 @@ static iree_status_t iree_hal_metal_device_create_semaphore(iree_hal_device_t* b
                                             device->host_allocator, out_semaphore);
 }
 
+// Returns true if |semaphore| is a shared event created on the same MTLDevice as |device| and can
+// be waited on and signaled directly by command buffers on its queue.
+static bool iree_hal_metal_device_is_native_semaphore(iree_hal_metal_device_t* device,
+                                                      iree_hal_semaphore_t* semaphore) {
+  return iree_hal_metal_shared_event_isa(semaphore) &&
+         iree_hal_metal_shared_event_handle(semaphore).device == device->device;
+}
+
+// Returns true if all semaphores in |semaphore_list| are native to |device|.
+static bool iree_hal_metal_device_are_native_semaphores(
+    iree_hal_metal_device_t* device, const iree_hal_semaphore_list_t semaphore_list) {
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    if (!iree_hal_metal_device_is_native_semaphore(device, semaphore_list.semaphores[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static iree_hal_semaphore_compatibility_t iree_hal_metal_device_query_semaphore_compatibility(
     iree_hal_device_t* base_device, iree_hal_semaphore_t* semaphore) {
-  if (iree_hal_metal_shared_event_isa(semaphore)) {
+  iree_hal_metal_device_t* device = iree_hal_metal_device_cast(base_device);
+  if (iree_hal_metal_device_is_native_semaphore(device, semaphore)) {
     // Fast-path for semaphores related to this device.
-    // TODO(benvanik): ensure the creating devices are compatible in cases where
-    // multiple devices are used.
     return IREE_HAL_SEMAPHORE_COMPATIBILITY_ALL;
   }
   // TODO(benvanik): semaphore APIs for querying allowed export formats. We
@@ -334,11 +356,27 @@ static iree_status_t iree_hal_metal_device_queue_alloca(
     iree_hal_buffer_params_t params, iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   // TODO(benvanik): queue-ordered allocations.
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list, iree_infinite_timeout()));
+  iree_hal_metal_device_t* device = iree_hal_metal_device_cast(base_device);
+  if (!iree_hal_metal_device_are_native_semaphores(device, wait_semaphore_list)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_semaphore_list_wait(wait_semaphore_list, iree_infinite_timeout()));
+    IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
+                                                            params, allocation_size, out_buffer));
+    return iree_hal_semaphore_list_signal(signal_semaphore_list);
+  }
+
+  // The allocation is made immediately and its contents are undefined until used. As all uses are
+  // ordered after the signal semaphores the waits can be forwarded to them on the GPU instead of
+  // blocking the caller until they are reached.
   IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(iree_hal_device_allocator(base_device),
                                                           params, allocation_size, out_buffer));
-  IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_signal(signal_semaphore_list));
-  return iree_ok_status();
+  iree_status_t status = iree_hal_device_queue_barrier(base_device, queue_affinity,
+                                                       wait_semaphore_list, signal_semaphore_list);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(*out_buffer);
+    *out_buffer = NULL;
+  }
+  return status;
 }
 
 static iree_status_t iree_hal_metal_device_queue_dealloca(
@@ -414,57 +452,131 @@ static iree_status_t iree_hal_metal_device_queue_execute(
                                           signal_semaphore_list.semaphores);
   }
 
+  // Semaphores from other devices or drivers cannot be waited on by the GPU; wait for them on the
+  // host before submitting. Shared events of this device are waited on by the GPU below so chained
+  // submissions do not round-trip through the host.
+  iree_host_size_t device_wait_count = 0;
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count && iree_status_is_ok(status); ++i) {
+    if (iree_hal_metal_device_is_native_semaphore(device, wait_semaphore_list.semaphores[i])) {
+      ++device_wait_count;
+      continue;
+    }
+    status = iree_hal_semaphore_wait(wait_semaphore_list.semaphores[i],
+                                     wait_semaphore_list.payload_values[i],
+                                     iree_infinite_timeout());
+  }
+
+  // Semaphores that cannot be signaled by the GPU are signaled from the completion handler. Their
+  // payloads are copied as the lists are only valid for the duration of this call.
+  iree_host_size_t host_signal_count = 0;
+  for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+    if (!iree_hal_metal_device_is_native_semaphore(device, signal_semaphore_list.semaphores[i])) {
+      ++host_signal_count;
+    }
+  }
+  iree_hal_semaphore_list_t host_signal_list = {0};
+  if (iree_status_is_ok(status) && host_signal_count > 0) {
+    status = iree_allocator_malloc(
+        device->host_allocator,
+        host_signal_count * (sizeof(iree_hal_semaphore_t*) + sizeof(uint64_t)),
+        (void**)&host_signal_list.semaphores);
+  }
+  if (iree_status_is_ok(status) && host_signal_count > 0) {
+    host_signal_list.payload_values = (uint64_t*)(host_signal_list.semaphores + host_signal_count);
+    for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+      if (iree_hal_metal_device_is_native_semaphore(device, signal_semaphore_list.semaphores[i])) {
+        continue;
+      }
+      host_signal_list.semaphores[host_signal_list.count] = signal_semaphore_list.semaphores[i];
+      host_signal_list.payload_values[host_signal_list.count] =
+          signal_semaphore_list.payload_values[i];
+      ++host_signal_list.count;
+    }
+  }
+
   if (iree_status_is_ok(status)) {
+    // Make buffers allocated since the last submission resident before any command buffer runs.
+    iree_hal_metal_allocator_commit_residency(device->device_allocator);
+
     @autoreleasepool {
-      // First create a new command buffer and encode wait commands for all wait semaphores.
-      if (wait_semaphore_list.count > 0) {
-        id<MTLCommandBuffer> wait_command_buffer = [device->queue
-            commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
-        for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
-          id<MTLSharedEvent> handle =
-              iree_hal_metal_shared_event_handle(wait_semaphore_list.semaphores[i]);
-          [wait_command_buffer encodeWaitForEvent:handle
-                                            value:wait_semaphore_list.payload_values[i]];
-        }
-        [wait_command_buffer commit];
+      // Acquire the Metal command buffers of all command buffers before committing anything so
+      // that a failure does not leave a partial submission behind. Reusable command buffers are
+      // encoded into new Metal command buffers here.
+      id<MTLCommandBuffer>* handles =
+          (id<MTLCommandBuffer>*)iree_alloca(command_buffer_count * sizeof(id<MTLCommandBuffer>));
+      for (iree_host_size_t i = 0; i < command_buffer_count && iree_status_is_ok(status); ++i) {
+        status =
+            iree_hal_metal_direct_command_buffer_acquire_handle(command_buffers[i], &handles[i]);
       }
 
-      // Then commit all recorded compute command buffers, except the last one, which we will patch
-      // up with semaphore signaling.
-      id<MTLCommandBuffer> signal_command_buffer = nil;
-      for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
-        iree_hal_command_buffer_t* command_buffer = command_buffers[i];
-        id<MTLCommandBuffer> handle = iree_hal_metal_direct_command_buffer_handle(command_buffer);
-        if (i + 1 != command_buffer_count) [handle commit];
-        signal_command_buffer = handle;
-      }
-      if (signal_command_buffer == nil) {
-        signal_command_buffer = [device->queue
-            commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
-      }
+      if (iree_status_is_ok(status)) {
+        // First create a new command buffer and encode wait commands for all wait semaphores.
+        if (device_wait_count > 0) {
+          id<MTLCommandBuffer> wait_command_buffer = [device->queue
+              commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
+          for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+            if (!iree_hal_metal_device_is_native_semaphore(device,
+                                                           wait_semaphore_list.semaphores[i])) {
+              continue;
+            }
+            id<MTLSharedEvent> handle =
+                iree_hal_metal_shared_event_handle(wait_semaphore_list.semaphores[i]);
+            [wait_command_buffer encodeWaitForEvent:handle
+                                              value:wait_semaphore_list.payload_values[i]];
+          }
+          [wait_command_buffer commit];
+        }
 
-      // Finally encode signal commands for all signal semaphores.
-      for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
-        id<MTLSharedEvent> handle =
-            iree_hal_metal_shared_event_handle(signal_semaphore_list.semaphores[i]);
-        [signal_command_buffer encodeSignalEvent:handle
-                                           value:signal_semaphore_list.payload_values[i]];
-      }
+        // Then commit all recorded compute command buffers, except the last one, which we will
+        // patch up with semaphore signaling.
+        id<MTLCommandBuffer> signal_command_buffer = nil;
+        for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+          if (i + 1 != command_buffer_count) [handles[i] commit];
+          signal_command_buffer = handles[i];
+        }
+        if (signal_command_buffer == nil) {
+          signal_command_buffer = [device->queue
+              commandBufferWithDescriptor:device->command_buffer_descriptor];  // autoreleased
+        }
 
-      // We use a resource set to keep track of resources in the above. So here we need to retain
-      // the device to make sure the block pool behind outlives the resource set.
-      iree_hal_device_retain(base_device);
-      [signal_command_buffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
-        // Now we can release all retained resources.
+        // Finally encode signal commands for all signal semaphores.
+        for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+          if (!iree_hal_metal_device_is_native_semaphore(device,
+                                                         signal_semaphore_list.semaphores[i])) {
+            continue;
+          }
+          id<MTLSharedEvent> handle =
+              iree_hal_metal_shared_event_handle(signal_semaphore_list.semaphores[i]);
+          [signal_command_buffer encodeSignalEvent:handle
+                                             value:signal_semaphore_list.payload_values[i]];
+        }
+
+        // We use a resource set to keep track of resources in the above. So here we need to
+        // retain the device to make sure the block pool behind outlives the resource set.
+        iree_hal_device_retain(base_device);
+        iree_allocator_t host_allocator = device->host_allocator;
+        [signal_command_buffer addCompletedHandler:^(id<MTLCommandBuffer> cb) {
+          // Signal the semaphores the GPU could not while they are still retained.
+          if (host_signal_list.count > 0) {
+            IREE_IGNORE_ERROR(iree_hal_semaphore_list_signal(host_signal_list));
+            iree_allocator_free(host_allocator, host_signal_list.semaphores);
+          }
+          // Now we can release all retained resources.
+          iree_hal_resource_set_free(resource_set);
+          // And then release the device handle. Note that this must happen separately--if we put
+          // the device itself in the resource set, we can destroy the block pool data structure
+          // inside the device prematurely, before the resource set free procedure done scanning
+          // it.
+          iree_hal_device_release(base_device);
+        }];
+        [signal_command_buffer commit];
+      } else {
+        iree_allocator_free(device->host_allocator, host_signal_list.semaphores);
         iree_hal_resource_set_free(resource_set);
-        // And then release the device handle. Note that this must happen separately--if we put the
-        // device itself in the resource set, we can destroy the block pool data structure inside
-        // the device prematurely, before the resource set free procedure done scanning it.
-        iree_hal_device_release(base_device);
-      }];
-      [signal_command_buffer commit];
+      }
     }
   } else {
+    iree_allocator_free(device->host_allocator, host_signal_list.semaphores);
     iree_hal_resource_set_free(resource_set);
   }
 
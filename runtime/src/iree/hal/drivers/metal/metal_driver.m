@@ -87,6 +87,7 @@ static iree_status_t iree_hal_metal_driver_create_internal(
   iree_string_view_append_to_buffer(identifier, &driver->identifier,
                                     (char*)driver + iree_sizeof_struct(*driver));
   driver->device_params = *device_params;
+  iree_hal_executable_disk_cache_retain(driver->device_params.executable_disk_cache);
 
   // Get all available Metal devices.
   driver->devices = iree_hal_metal_device_copy();
@@ -115,6 +116,7 @@ static void iree_hal_metal_driver_destroy(iree_hal_driver_t* base_driver) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   [driver->devices release];  // -1
+  iree_hal_executable_disk_cache_release(driver->device_params.executable_disk_cache);
   iree_allocator_free(host_allocator, driver);
 
   IREE_TRACE_ZONE_END(z0);
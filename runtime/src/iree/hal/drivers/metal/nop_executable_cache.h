@@ -16,14 +16,17 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a no-op executable cache that does not cache at all.
+// Creates an executable cache that does not cache in memory.
 // This is useful to isolate pipeline caching behavior and verify compilation
-// behavior.
+// behavior. If an optional |disk_cache| is provided then compiled compute
+// pipelines are persisted there in MTLBinaryArchives when executables allow
+// persistent caching.
 //
 // |out_executable_cache| must be released by the caller (see
 // iree_hal_executable_cache_release).
 iree_status_t iree_hal_metal_nop_executable_cache_create(
     id<MTLDevice> device, iree_string_view_t identifier,
+    iree_hal_executable_disk_cache_t* disk_cache,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
@@ -19,6 +19,11 @@ typedef struct iree_hal_metal_nop_executable_cache_t {
 
   id<MTLDevice> device;
 
+  // Optional persistent cache for MTLBinaryArchives.
+  iree_hal_executable_disk_cache_t* disk_cache;
+  // Key identifying the device and OS that all entry keys start with.
+  iree_hal_executable_disk_cache_key_t disk_cache_key;
+
   iree_allocator_t host_allocator;
 } iree_hal_metal_nop_executable_cache_t;
 
@@ -30,8 +35,26 @@ static iree_hal_metal_nop_executable_cache_t* iree_hal_metal_nop_executable_cach
   return (iree_hal_metal_nop_executable_cache_t*)base_value;
 }
 
+// File extension used for binary archive entries in the disk cache.
+#define IREE_HAL_METAL_BINARY_ARCHIVE_EXTENSION IREE_SV(".metallib")
+
+// Initializes |out_key| with the identity of |device| and the OS version.
+// The Metal compiler ships with the OS and archives are specific to the GPU.
+static void iree_hal_metal_nop_executable_cache_initialize_key(
+    id<MTLDevice> device, iree_hal_executable_disk_cache_key_t* out_key) {
+  @autoreleasepool {
+    const char* device_name = [device.name UTF8String];
+    const char* os_version = [[NSProcessInfo processInfo].operatingSystemVersionString UTF8String];
+    iree_hal_executable_disk_cache_key_initialize(out_key);
+    iree_hal_executable_disk_cache_key_append_string(out_key, IREE_SV("metal"));
+    iree_hal_executable_disk_cache_key_append_string(out_key, iree_make_cstring_view(device_name));
+    iree_hal_executable_disk_cache_key_append_string(out_key, iree_make_cstring_view(os_version));
+  }
+}
+
 iree_status_t iree_hal_metal_nop_executable_cache_create(
-    id<MTLDevice> device, iree_string_view_t identifier, iree_allocator_t host_allocator,
+    id<MTLDevice> device, iree_string_view_t identifier,
+    iree_hal_executable_disk_cache_t* disk_cache, iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(out_executable_cache);
   *out_executable_cache = NULL;
@@ -44,6 +67,12 @@ iree_status_t iree_hal_metal_nop_executable_cache_create(
     iree_hal_resource_initialize(&iree_hal_metal_nop_executable_cache_vtable,
                                  &executable_cache->resource);
     executable_cache->device = [device retain];  // +1
+    executable_cache->disk_cache = disk_cache;
+    iree_hal_executable_disk_cache_retain(disk_cache);
+    if (disk_cache) {
+      iree_hal_metal_nop_executable_cache_initialize_key(device,
+                                                         &executable_cache->disk_cache_key);
+    }
     executable_cache->host_allocator = host_allocator;
 
     *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
@@ -58,6 +87,7 @@ static void iree_hal_metal_nop_executable_cache_destroy(
       iree_hal_metal_nop_executable_cache_cast(base_executable_cache);
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_executable_disk_cache_release(executable_cache->disk_cache);
   [executable_cache->device release];  // -1
   iree_allocator_free(executable_cache->host_allocator, executable_cache);
 
@@ -70,13 +100,98 @@ static bool iree_hal_metal_nop_executable_cache_can_prepare_format(
   return iree_string_view_equal(executable_format, iree_make_cstring_view("MTLE"));
 }
 
+// Serializes the binary archive in |user_data| to |path|.
+static iree_status_t iree_hal_metal_nop_executable_cache_write_archive(void* user_data,
+                                                                       const char* path) {
+  id<MTLBinaryArchive> binary_archive = (id<MTLBinaryArchive>)user_data;
+  @autoreleasepool {
+    NSError* error = nil;
+    NSURL* url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path]];
+    if (![binary_archive serializeToURL:url error:&error]) {
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "failed to serialize MTLBinaryArchive with NSError: %s",
+                              [error.localizedDescription UTF8String]);
+    }
+  }
+  return iree_ok_status();
+}
+
+// Creates an MTLBinaryArchive loaded from the file at |path| if |found| and otherwise empty.
+// Archives that fail to load (from older OS versions, corruption, etc) are replaced with empty
+// ones. Returns nil if archives are unsupported.
+static id<MTLBinaryArchive> iree_hal_metal_nop_executable_cache_create_archive(
+    id<MTLDevice> device, const char* path, bool found) {
+  id<MTLBinaryArchive> binary_archive = nil;
+  @autoreleasepool {
+    MTLBinaryArchiveDescriptor* descriptor = [[MTLBinaryArchiveDescriptor new] autorelease];
+    if (found) {
+      descriptor.url = [NSURL fileURLWithPath:[NSString stringWithUTF8String:path]];
+      binary_archive = [device newBinaryArchiveWithDescriptor:descriptor error:nil];  // +1
+    }
+    if (!binary_archive) {
+      descriptor.url = nil;
+      binary_archive = [device newBinaryArchiveWithDescriptor:descriptor error:nil];  // +1
+    }
+  }
+  return binary_archive;
+}
+
+// Prepares an executable using compute pipelines persisted on disk in an MTLBinaryArchive.
+//
+// NOTE: only the compiled pipelines are archived. MSL source still has to be compiled to a
+// MTLLibrary each time as there is no public API for serializing libraries compiled at runtime.
+static iree_status_t iree_hal_metal_nop_executable_cache_prepare_persistent(
+    iree_hal_metal_nop_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params, iree_hal_executable_t** out_executable) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_executable_disk_cache_key_t key = executable_cache->disk_cache_key;
+  iree_hal_executable_disk_cache_key_append_string(&key, executable_params->executable_format);
+  iree_hal_executable_disk_cache_key_append(&key, executable_params->executable_data);
+
+  char path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  bool found = false;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_disk_cache_lookup_file(executable_cache->disk_cache, &key,
+                                                     IREE_HAL_METAL_BINARY_ARCHIVE_EXTENSION,
+                                                     sizeof(path), path, &found));
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, found ? "hit" : "miss");
+
+  id<MTLBinaryArchive> binary_archive =
+      iree_hal_metal_nop_executable_cache_create_archive(executable_cache->device, path, found);
+
+  iree_status_t status = iree_hal_metal_kernel_library_create(
+      executable_cache->device, binary_archive, executable_params,
+      executable_cache->host_allocator, out_executable);
+
+  // Storing is best-effort: failures only mean pipelines are compiled again the next time the
+  // executable is prepared.
+  if (iree_status_is_ok(status) && binary_archive && !found) {
+    iree_status_ignore(iree_hal_executable_disk_cache_store_file(
+        executable_cache->disk_cache, &key, IREE_HAL_METAL_BINARY_ARCHIVE_EXTENSION,
+        iree_hal_metal_nop_executable_cache_write_archive, (void*)binary_archive));
+  }
+
+  [binary_archive release];  // -1
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_metal_nop_executable_cache_prepare_executable(
     iree_hal_executable_cache_t* base_executable_cache,
     const iree_hal_executable_params_t* executable_params, iree_hal_executable_t** out_executable) {
   iree_hal_metal_nop_executable_cache_t* executable_cache =
       iree_hal_metal_nop_executable_cache_cast(base_executable_cache);
-  return iree_hal_metal_kernel_library_create(executable_cache->device, executable_params,
-                                              executable_cache->host_allocator, out_executable);
+  if (executable_cache->disk_cache &&
+      iree_all_bits_set(executable_params->caching_mode,
+                        IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING)) {
+    return iree_hal_metal_nop_executable_cache_prepare_persistent(
+        executable_cache, executable_params, out_executable);
+  }
+  return iree_hal_metal_kernel_library_create(executable_cache->device, /*binary_archive=*/nil,
+                                              executable_params, executable_cache->host_allocator,
+                                              out_executable);
 }
 
 static const iree_hal_executable_cache_vtable_t iree_hal_metal_nop_executable_cache_vtable = {
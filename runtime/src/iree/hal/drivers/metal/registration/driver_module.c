@@ -8,6 +8,7 @@
 
 #include <inttypes.h>
 #include <stddef.h>
+#include <string.h>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
@@ -24,6 +25,12 @@ IREE_FLAG(bool, metal_command_buffer_retain_resources, false,
 IREE_FLAG(bool, metal_resource_hazard_tracking, false,
           "Enables automatic Metal hazard tracking for diagnosing concurrency "
           "issues");
+IREE_FLAG(bool, metal_unified_memory, false,
+          "Allocates device-local buffers with shared storage on devices with "
+          "unified memory so that host transfers avoid staging copies");
+IREE_FLAG(string, metal_executable_cache, "",
+          "Directory used to persist compiled compute pipelines across runs.\n"
+          "The directory must exist and be writable only by trusted users.");
 
 static iree_status_t iree_hal_metal_driver_factory_enumerate(
     void* self, iree_host_size_t* out_driver_info_count,
@@ -70,9 +77,22 @@ static iree_status_t iree_hal_metal_driver_factory_try_create(
       FLAG_metal_resource_hazard_tracking
           ? IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_TRACKED
           : IREE_HAL_METAL_RESOURCE_HAZARD_TRACKING_MODE_UNTRACKED;
+  device_params.unified_memory = FLAG_metal_unified_memory;
 
-  iree_status_t status = iree_hal_metal_driver_create(
-      driver_name, &device_params, host_allocator, out_driver);
+  iree_status_t status = iree_ok_status();
+  if (strlen(FLAG_metal_executable_cache) > 0) {
+    status = iree_hal_executable_disk_cache_create(
+        iree_make_cstring_view(FLAG_metal_executable_cache), host_allocator,
+        &device_params.executable_disk_cache);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_metal_driver_create(driver_name, &device_params,
+                                          host_allocator, out_driver);
+  }
+
+  // Retained by the driver.
+  iree_hal_executable_disk_cache_release(device_params.executable_disk_cache);
 
   IREE_TRACE_ZONE_END(z0);
 
@@ -37,6 +37,9 @@ id<MTLSharedEvent> iree_hal_metal_shared_event_handle(
 
 // Waits on the shared events in the given |semaphore_list| according to the
 // |wait_mode| before |timeout|.
+//
+// Values already reached are checked without blocking; listener notifications
+// on the device dispatch queue are only used for the ones still pending.
 iree_status_t iree_hal_metal_shared_event_multi_wait(
     iree_hal_wait_mode_t wait_mode,
     const iree_hal_semaphore_list_t* semaphore_list, iree_timeout_t timeout);
@@ -158,10 +158,11 @@ static iree_status_t iree_hal_metal_shared_event_wait(iree_hal_semaphore_t* base
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Quick path for impatient waiting to avoid all the overhead of dispatch queues and semaphores.
-  if (timeout_ns == 0) {
-    uint64_t current_value = 0;
-    iree_status_t status = iree_hal_metal_shared_event_query(base_semaphore, &current_value);
+  // Quick path for impatient waiting or already reached values to avoid all the overhead of
+  // dispatch queues and semaphores.
+  uint64_t current_value = 0;
+  iree_status_t status = iree_hal_metal_shared_event_query(base_semaphore, &current_value);
+  if (!iree_status_is_ok(status) || current_value >= value || timeout_ns == 0) {
     if (iree_status_is_ok(status) && current_value < value) {
       status = iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
     }
@@ -228,12 +229,38 @@ iree_status_t iree_hal_metal_shared_event_multi_wait(
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Skip the semaphores that have already reached their values so that listeners are only
+  // registered for the ones that have not. This avoids any notification round trip when all
+  // (or for IREE_HAL_WAIT_MODE_ANY, any) of the values have been reached.
+  bool* pending = (bool*)iree_alloca(semaphore_list->count * sizeof(bool));
+  iree_host_size_t reached_count = 0;
+  for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
+    uint64_t current_value = 0;
+    iree_status_t status =
+        iree_hal_metal_shared_event_query(semaphore_list->semaphores[i], &current_value);
+    if (!iree_status_is_ok(status)) {
+      IREE_TRACE_ZONE_END(z0);
+      return status;
+    }
+    pending[i] = current_value < semaphore_list->payload_values[i];
+    if (!pending[i]) ++reached_count;
+  }
+  if (reached_count == semaphore_list->count ||
+      (wait_mode == IREE_HAL_WAIT_MODE_ANY && reached_count > 0)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  } else if (timeout_ns == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+
   // Create an atomic to count how many semaphores have signaled. Mark it as `__block` so different
   // threads are sharing the same data via reference.
   __block iree_atomic_int32_t wait_count;
   iree_atomic_store_int32(&wait_count, 0, iree_memory_order_release);
   // The total count we are expecting to see.
-  iree_host_size_t total_count = (wait_mode == IREE_HAL_WAIT_MODE_ALL) ? semaphore_list->count : 1;
+  iree_host_size_t total_count =
+      (wait_mode == IREE_HAL_WAIT_MODE_ALL) ? semaphore_list->count - reached_count : 1;
   // Theoretically we don't really need to mark the semaphore handle as __block given that the
   // handle itself is not modified and there is only one block and it will copy the handle.
   // But marking it as __block serves as good documentation purpose.
@@ -242,6 +269,7 @@ iree_status_t iree_hal_metal_shared_event_multi_wait(
   __block bool did_fail = false;
 
   for (iree_host_size_t i = 0; i < semaphore_list->count; ++i) {
+    if (!pending[i]) continue;
     // Use a listener to the MTLSharedEvent to notify us when the work is done on GPU by signaling a
     // semaphore. The signaling will happen in a new dispatch queue; the current thread will wait on
     // the semaphore.
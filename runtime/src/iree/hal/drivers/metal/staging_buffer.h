@@ -17,15 +17,15 @@
 extern "C" {
 #endif  // __cplusplus
 
-// Size, in bytes, of the shared storage mode staging buffer.
+// Initial size, in bytes, of the shared storage mode staging buffer.
 // The given amount of system memory will be allocated and is accessible to both
-// the CPU and the GPU.
+// the CPU and the GPU. The buffer grows on demand when exhausted.
 //
-// Larger values here will use more memory but allow more concurrent/complex
-// command buffers. As most models that run in these environments are only a few
-// hundred dispatches per command buffer we can approximate an average
-// consumption of 500 dispatches x worst-case 256B per dispatch of parameters
-// and get 128KB.
+// Larger values here will use more memory but avoid growing for more
+// concurrent/complex command buffers. As most models that run in these
+// environments are only a few hundred dispatches per command buffer we can
+// approximate an average consumption of 500 dispatches x worst-case 256B per
+// dispatch of parameters and get 128KB.
 #define IREE_HAL_METAL_STAGING_BUFFER_DEFAULT_CAPACITY (128 * 1024)
 
 // A staging uniform buffer used for uploading parameters to the device.
@@ -41,22 +41,34 @@ extern "C" {
 // * Argument buffers for descriptor sets
 // * Source buffer for buffer update commands
 //
+// When a reservation does not fit a new buffer of at least twice the capacity
+// is allocated and used for all subsequent reservations. Buffers replaced this
+// way may still be referenced by pending command buffers and are retained
+// until the staging buffer is next reset. Reservations are only valid in the
+// buffer they were returned with.
+//
 // Thread safe; multiple threads can reserve spaces concurrently.
 typedef struct iree_hal_metal_staging_buffer_t {
+  // Device used to allocate replacement buffers when growing.
+  id<MTLDevice> device;
+
+  // Non-recursive mutex guarding access to the buffer and offset fields.
+  iree_slim_mutex_t offset_mutex;
+
   // Maximum number of bytes in the buffer.
-  uint32_t capacity;
+  uint32_t capacity IREE_GUARDED_BY(offset_mutex);
 
   // Device handle to the buffer.
-  id<MTLBuffer> metal_buffer;
+  id<MTLBuffer> metal_buffer IREE_GUARDED_BY(offset_mutex);
   // Host pointer to the buffer.
-  uint8_t* host_buffer;
-
-  // Non-recursive mutex guarding access to the offset field.
-  iree_slim_mutex_t offset_mutex;
+  uint8_t* host_buffer IREE_GUARDED_BY(offset_mutex);
 
   // Current write offset of the device buffer.
   uint32_t offset IREE_GUARDED_BY(offset_mutex);
 
+  // Buffers replaced by growth that may still be in use until the next reset.
+  NSMutableArray<id<MTLBuffer>>* retired_buffers IREE_GUARDED_BY(offset_mutex);
+
   // The number of command buffers that are being recorded or executed on
   // device. If this reaches zero, we know that there are no users of the
   // staging buffer so we can discard the contents and reset the offset to
@@ -73,19 +85,21 @@ void iree_hal_metal_staging_buffer_deinitialize(
     iree_hal_metal_staging_buffer_t* staging_buffer);
 
 // Reserves |length| bytes from the staging buffer and returns a pointer to it
-// in |out_reservation|.
+// in |out_reservation| and the buffer and offset it is at in |out_buffer| and
+// |out_offset|. |out_buffer| is unretained and valid until the next reset.
 iree_status_t iree_hal_metal_staging_buffer_reserve(
     iree_hal_metal_staging_buffer_t* staging_buffer, iree_host_size_t length,
     iree_host_size_t alignment, iree_byte_span_t* out_reservation,
-    uint32_t* out_offset);
+    id<MTLBuffer>* out_buffer, uint32_t* out_offset);
 
 // Appends |data| of |length| bytes to the staging buffer.
 iree_status_t iree_hal_metal_staging_buffer_append(
     iree_hal_metal_staging_buffer_t* staging_buffer,
     iree_const_byte_span_t source, iree_host_size_t alignment,
-    uint32_t* out_offset);
+    id<MTLBuffer>* out_buffer, uint32_t* out_offset);
 
-// Resets the staging buffer to discard all its contents.
+// Resets the staging buffer to discard all its contents and release buffers
+// replaced by growth.
 void iree_hal_metal_staging_buffer_reset(
     iree_hal_metal_staging_buffer_t* staging_buffer);
 
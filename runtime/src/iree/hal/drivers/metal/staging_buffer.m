@@ -11,14 +11,10 @@
 #include "iree/base/api.h"
 #include "iree/base/tracing.h"
 
-iree_status_t iree_hal_metal_staging_buffer_initialize(
-    id<MTLDevice> device, iree_host_size_t buffer_capacity,
-    iree_hal_metal_staging_buffer_t* out_staging_buffer) {
-  IREE_ASSERT_ARGUMENT(device);
-  IREE_ASSERT_ARGUMENT(out_staging_buffer);
-  IREE_TRACE_ZONE_BEGIN(z0);
-  memset(out_staging_buffer, 0, sizeof(*out_staging_buffer));
-
+// Allocates a shared storage mode buffer of |buffer_capacity| bytes.
+static iree_status_t iree_hal_metal_staging_buffer_allocate(id<MTLDevice> device,
+                                                            iree_host_size_t buffer_capacity,
+                                                            id<MTLBuffer>* out_metal_buffer) {
   // From Metal Best Practices Guide:
   // "For small-sized data that changes frequently, choose the Shared mode. The overhead of copying
   // data to video memory may be more expensive than the overhead of the GPU accessing system memory
@@ -26,17 +22,33 @@ iree_status_t iree_hal_metal_staging_buffer_initialize(
   MTLResourceOptions options = MTLResourceStorageModeShared | MTLResourceCPUCacheModeWriteCombined;
   id<MTLBuffer> metal_buffer = [device newBufferWithLength:buffer_capacity options:options];  // +1
   if (!metal_buffer) {
-    IREE_TRACE_ZONE_END(z0);
     return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
                             "failed to allocate staging buffer with size = %ld bytes",
                             buffer_capacity);
   }
+  *out_metal_buffer = metal_buffer;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_metal_staging_buffer_initialize(
+    id<MTLDevice> device, iree_host_size_t buffer_capacity,
+    iree_hal_metal_staging_buffer_t* out_staging_buffer) {
+  IREE_ASSERT_ARGUMENT(device);
+  IREE_ASSERT_ARGUMENT(out_staging_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_staging_buffer, 0, sizeof(*out_staging_buffer));
 
+  id<MTLBuffer> metal_buffer = nil;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_metal_staging_buffer_allocate(device, buffer_capacity, &metal_buffer));
+
+  out_staging_buffer->device = [device retain];  // +1
   out_staging_buffer->capacity = (uint32_t)buffer_capacity;
   out_staging_buffer->metal_buffer = metal_buffer;
   out_staging_buffer->host_buffer = metal_buffer.contents;
   iree_slim_mutex_initialize(&out_staging_buffer->offset_mutex);
   out_staging_buffer->offset = 0;
+  out_staging_buffer->retired_buffers = [[NSMutableArray alloc] init];  // +1
   iree_atomic_store_int32(&out_staging_buffer->pending_command_buffers, 0,
                           iree_memory_order_relaxed);
 
@@ -46,34 +58,62 @@ iree_status_t iree_hal_metal_staging_buffer_initialize(
 
 void iree_hal_metal_staging_buffer_deinitialize(iree_hal_metal_staging_buffer_t* staging_buffer) {
   iree_slim_mutex_deinitialize(&staging_buffer->offset_mutex);
-  [staging_buffer->metal_buffer release];  // -1
+  [staging_buffer->retired_buffers release];  // -1
+  [staging_buffer->metal_buffer release];     // -1
+  [staging_buffer->device release];           // -1
+}
+
+// Replaces the current buffer with one of at least |min_capacity| bytes.
+// Must be called with the offset mutex held.
+static iree_status_t iree_hal_metal_staging_buffer_grow(
+    iree_hal_metal_staging_buffer_t* staging_buffer, iree_host_size_t min_capacity) {
+  iree_host_size_t new_capacity = (iree_host_size_t)staging_buffer->capacity * 2;
+  while (new_capacity < min_capacity) new_capacity *= 2;
+  if (new_capacity > UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "staging buffer cannot grow beyond %" PRIu32 " bytes", UINT32_MAX);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, new_capacity);
+
+  id<MTLBuffer> metal_buffer = nil;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_metal_staging_buffer_allocate(staging_buffer->device, new_capacity,
+                                                 &metal_buffer));
+
+  // The old buffer may still be referenced by pending command buffers.
+  [staging_buffer->retired_buffers addObject:staging_buffer->metal_buffer];  // +1
+  [staging_buffer->metal_buffer release];                                    // -1
+  staging_buffer->capacity = (uint32_t)new_capacity;
+  staging_buffer->metal_buffer = metal_buffer;
+  staging_buffer->host_buffer = metal_buffer.contents;
+  staging_buffer->offset = 0;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
 }
 
 iree_status_t iree_hal_metal_staging_buffer_reserve(iree_hal_metal_staging_buffer_t* staging_buffer,
                                                     iree_host_size_t length,
                                                     iree_host_size_t alignment,
                                                     iree_byte_span_t* out_reservation,
+                                                    id<MTLBuffer>* out_buffer,
                                                     uint32_t* out_offset) {
-  if (length > staging_buffer->capacity) {
-    // This will never fit in the staging buffer.
-    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
-                            "reservation (%" PRIhsz " bytes) exceeds the maximum capacity of "
-                            "the staging buffer (%" PRIu32 " bytes)",
-                            length, staging_buffer->capacity);
-  }
-
   iree_slim_mutex_lock(&staging_buffer->offset_mutex);
-  uint32_t aligned_offset = iree_host_align(staging_buffer->offset, alignment);
+  iree_host_size_t aligned_offset = iree_host_align(staging_buffer->offset, alignment);
   if (aligned_offset + length > staging_buffer->capacity) {
-    iree_slim_mutex_unlock(&staging_buffer->offset_mutex);
-    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
-                            "failed to reserve %" PRIhsz " bytes in staging buffer", length);
+    iree_status_t status = iree_hal_metal_staging_buffer_grow(staging_buffer, length);
+    if (!iree_status_is_ok(status)) {
+      iree_slim_mutex_unlock(&staging_buffer->offset_mutex);
+      return status;
+    }
+    aligned_offset = 0;
   }
-  staging_buffer->offset = aligned_offset + length;
-  iree_slim_mutex_unlock(&staging_buffer->offset_mutex);
-
+  staging_buffer->offset = (uint32_t)(aligned_offset + length);
   *out_reservation = iree_make_byte_span(staging_buffer->host_buffer + aligned_offset, length);
-  *out_offset = aligned_offset;
+  *out_buffer = staging_buffer->metal_buffer;
+  *out_offset = (uint32_t)aligned_offset;
+  iree_slim_mutex_unlock(&staging_buffer->offset_mutex);
 
   return iree_ok_status();
 }
@@ -81,10 +121,11 @@ iree_status_t iree_hal_metal_staging_buffer_reserve(iree_hal_metal_staging_buffe
 iree_status_t iree_hal_metal_staging_buffer_append(iree_hal_metal_staging_buffer_t* staging_buffer,
                                                    iree_const_byte_span_t source,
                                                    iree_host_size_t alignment,
+                                                   id<MTLBuffer>* out_buffer,
                                                    uint32_t* out_offset) {
   iree_byte_span_t reservation;
-  IREE_RETURN_IF_ERROR(iree_hal_metal_staging_buffer_reserve(staging_buffer, source.data_length,
-                                                             alignment, &reservation, out_offset));
+  IREE_RETURN_IF_ERROR(iree_hal_metal_staging_buffer_reserve(
+      staging_buffer, source.data_length, alignment, &reservation, out_buffer, out_offset));
   memcpy(reservation.data, source.data, source.data_length);
   return iree_ok_status();
 }
@@ -92,6 +133,7 @@ iree_status_t iree_hal_metal_staging_buffer_append(iree_hal_metal_staging_buffer
 void iree_hal_metal_staging_buffer_reset(iree_hal_metal_staging_buffer_t* staging_buffer) {
   iree_slim_mutex_lock(&staging_buffer->offset_mutex);
   staging_buffer->offset = 0;
+  [staging_buffer->retired_buffers removeAllObjects];
   iree_slim_mutex_unlock(&staging_buffer->offset_mutex);
 }
 
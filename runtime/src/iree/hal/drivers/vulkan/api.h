@@ -13,6 +13,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/utils/executable_disk_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -94,6 +95,12 @@ enum iree_hal_vulkan_feature_bits_t {
   // Enables buffer device addresses when supported and uses them when
   // appropriately compiled SPIR-V executables require them.
   IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES = 1u << 6,
+
+  // Enables VK_EXT_descriptor_buffer when supported and writes descriptor sets
+  // directly into host-visible descriptor buffers instead of allocating them
+  // from descriptor pools. Only used when VK_KHR_push_descriptor is unavailable
+  // and requires IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES.
+  IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS = 1u << 7,
 };
 typedef uint32_t iree_hal_vulkan_features_t;
 
@@ -207,12 +214,31 @@ enum iree_hal_vulkan_device_flag_bits_t {
   // IREE execution to run asynchronously with the graphics workloads.
   // See: https://gpuopen.com/learn/concurrent-execution-asynchronous-queues/
   IREE_HAL_VULKAN_DEVICE_FLAG_DEDICATED_COMPUTE_QUEUE = 1u << 0,
+
+  // Treat host and device memory as unified on integrated GPUs and CPUs that
+  // expose a DEVICE_LOCAL|HOST_VISIBLE|HOST_COHERENT memory type. Device-local
+  // buffers are then allocated host-visible and mappable so that transfers to
+  // and from them become mapped memcpys instead of staged queue copies.
+  // Ignored on discrete devices.
+  IREE_HAL_VULKAN_DEVICE_FLAG_UNIFIED_MEMORY = 1u << 1,
 };
 typedef uint32_t iree_hal_vulkan_device_flags_t;
 
 typedef struct iree_hal_vulkan_device_options_t {
   // Flags controlling device behavior.
   iree_hal_vulkan_device_flags_t flags;
+
+  // Optional persistent cache for VkPipelineCache data produced when
+  // executables are prepared with
+  // IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING.
+  // Retained by the driver and any devices created with these options.
+  iree_hal_executable_disk_cache_t* executable_disk_cache;
+
+  // Optional path of a file holding VkPipelineCache data shared by all
+  // executables prepared on the device. The file is loaded when the device is
+  // created, ignored if produced by a different device or driver, and written
+  // back when the device is trimmed or destroyed. Copied by the driver.
+  iree_string_view_t pipeline_cache_path;
 } iree_hal_vulkan_device_options_t;
 
 IREE_API_EXPORT void iree_hal_vulkan_device_options_initialize(
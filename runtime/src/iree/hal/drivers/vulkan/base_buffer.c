@@ -47,8 +47,13 @@ iree_status_t iree_hal_vulkan_find_memory_type(
   if (device_props->deviceType == VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU) {
     // Integrated GPUs have tiny device local heaps commonly used for
     // framebuffers and other bounded resources. We don't currently try to use
-    // them but could for very small transients.
-    if (iree_all_bits_set(requested_type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    // them but could for very small transients. Requests for coherent
+    // host-visible device-local memory come from the unified memory mode and
+    // keep preferring device-local types.
+    if (iree_all_bits_set(requested_type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) &&
+        !iree_all_bits_set(requested_type,
+                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE |
+                               IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
       requested_type &= ~IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
       requested_type |= IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
     }
@@ -0,0 +1,464 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/vulkan/block_allocator.h"
+
+#include <cstddef>
+#include <cstring>
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/drivers/vulkan/dynamic_symbols.h"
+#include "iree/hal/drivers/vulkan/status_util.h"
+
+using namespace iree::hal::vulkan;
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+static const char* IREE_HAL_VULKAN_BLOCK_ALLOCATOR_ID = "Vulkan/Block";
+#endif  // IREE_TRACING_FEATURE_ALLOCATION_TRACKING
+
+// Block size used for memory types of heaps larger than
+// IREE_HAL_VULKAN_SMALL_HEAP_MAX_SIZE.
+#define IREE_HAL_VULKAN_LARGE_HEAP_BLOCK_SIZE (64 * 1024 * 1024)
+
+// Heaps up to this size use blocks of 1/8th of the heap size.
+#define IREE_HAL_VULKAN_SMALL_HEAP_MAX_SIZE (1024ull * 1024 * 1024)
+
+// A contiguous range of a block that is either free or allocated.
+typedef struct iree_hal_vulkan_memory_chunk_t {
+  VkDeviceSize offset;
+  VkDeviceSize size;
+  bool is_free;
+} iree_hal_vulkan_memory_chunk_t;
+
+struct iree_hal_vulkan_memory_block_t {
+  // Next block of the same memory type.
+  iree_hal_vulkan_memory_block_t* next;
+  iree_hal_vulkan_block_allocator_t* block_allocator;
+  uint32_t memory_type_index;
+
+  VkDeviceMemory device_memory;
+  VkDeviceSize size;
+  // Persistent mapping of the entire block if host-visible.
+  uint8_t* host_ptr;
+
+  // Number of allocated chunks; the block is empty when 0.
+  iree_host_size_t allocation_count;
+  // Chunks covering the entire block sorted by offset. Neighboring free chunks
+  // are always coalesced.
+  iree_host_size_t chunk_count;
+  iree_host_size_t chunk_capacity;
+  iree_hal_vulkan_memory_chunk_t* chunks;
+};
+
+struct iree_hal_vulkan_block_allocator_t {
+  VkDeviceHandle* logical_device;
+  iree_allocator_t host_allocator;
+  VkPhysicalDeviceMemoryProperties memory_props;
+
+  // Size of blocks allocated for each memory type.
+  VkDeviceSize block_sizes[VK_MAX_MEMORY_TYPES];
+
+  iree_slim_mutex_t mutex;
+  // Singly-linked list of blocks for each memory type.
+  iree_hal_vulkan_memory_block_t* blocks[VK_MAX_MEMORY_TYPES] IREE_GUARDED_BY(
+      mutex);
+};
+
+iree_status_t iree_hal_vulkan_block_allocator_create(
+    VkDeviceHandle* logical_device,
+    const VkPhysicalDeviceMemoryProperties* memory_props,
+    iree_allocator_t host_allocator,
+    iree_hal_vulkan_block_allocator_t** out_block_allocator) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(memory_props);
+  IREE_ASSERT_ARGUMENT(out_block_allocator);
+  *out_block_allocator = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_vulkan_block_allocator_t* block_allocator = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*block_allocator),
+                                (void**)&block_allocator));
+  block_allocator->logical_device = logical_device;
+  block_allocator->host_allocator = host_allocator;
+  block_allocator->memory_props = *memory_props;
+  iree_slim_mutex_initialize(&block_allocator->mutex);
+
+  // Small heaps (integrated GPUs with a carveout, BAR windows, etc) would be
+  // exhausted quickly by large partially-used blocks.
+  for (uint32_t i = 0; i < memory_props->memoryTypeCount; ++i) {
+    VkDeviceSize heap_size =
+        memory_props->memoryHeaps[memory_props->memoryTypes[i].heapIndex].size;
+    block_allocator->block_sizes[i] =
+        heap_size <= IREE_HAL_VULKAN_SMALL_HEAP_MAX_SIZE
+            ? heap_size / 8
+            : IREE_HAL_VULKAN_LARGE_HEAP_BLOCK_SIZE;
+  }
+
+  *out_block_allocator = block_allocator;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_vulkan_memory_block_free(
+    iree_hal_vulkan_memory_block_t* block) {
+  iree_hal_vulkan_block_allocator_t* block_allocator = block->block_allocator;
+  VkDeviceHandle* logical_device = block_allocator->logical_device;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block->size);
+
+  IREE_TRACE_FREE_NAMED(IREE_HAL_VULKAN_BLOCK_ALLOCATOR_ID,
+                        (void*)block->device_memory);
+  if (block->host_ptr) {
+    logical_device->syms()->vkUnmapMemory(*logical_device,
+                                          block->device_memory);
+  }
+  logical_device->syms()->vkFreeMemory(*logical_device, block->device_memory,
+                                       logical_device->allocator());
+  iree_allocator_free(block_allocator->host_allocator, block->chunks);
+  iree_allocator_free(block_allocator->host_allocator, block);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_vulkan_block_allocator_destroy(
+    iree_hal_vulkan_block_allocator_t* block_allocator) {
+  if (!block_allocator) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (uint32_t i = 0; i < IREE_ARRAYSIZE(block_allocator->blocks); ++i) {
+    iree_hal_vulkan_memory_block_t* block = block_allocator->blocks[i];
+    while (block) {
+      iree_hal_vulkan_memory_block_t* next = block->next;
+      IREE_ASSERT_EQ(block->allocation_count, 0,
+                     "all allocations must be released");
+      iree_hal_vulkan_memory_block_free(block);
+      block = next;
+    }
+  }
+  iree_slim_mutex_deinitialize(&block_allocator->mutex);
+  iree_allocator_free(block_allocator->host_allocator, block_allocator);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_vulkan_block_allocator_should_suballocate(
+    iree_hal_vulkan_block_allocator_t* block_allocator,
+    uint32_t memory_type_index, const VkMemoryRequirements* requirements) {
+  VkMemoryPropertyFlags property_flags =
+      block_allocator->memory_props.memoryTypes[memory_type_index]
+          .propertyFlags;
+  if (iree_all_bits_set(property_flags, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) &&
+      !iree_all_bits_set(property_flags,
+                         VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+    return false;
+  }
+  return requirements->size <=
+         block_allocator->block_sizes[memory_type_index] / 2;
+}
+
+// Allocates a new empty block of |memory_type_index|.
+static iree_status_t iree_hal_vulkan_memory_block_allocate(
+    iree_hal_vulkan_block_allocator_t* block_allocator,
+    uint32_t memory_type_index, iree_hal_vulkan_memory_block_t** out_block) {
+  VkDeviceHandle* logical_device = block_allocator->logical_device;
+  iree_allocator_t host_allocator = block_allocator->host_allocator;
+  VkDeviceSize block_size = block_allocator->block_sizes[memory_type_index];
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)block_size);
+
+  iree_hal_vulkan_memory_block_t* block = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*block), (void**)&block));
+  block->block_allocator = block_allocator;
+  block->memory_type_index = memory_type_index;
+  block->size = block_size;
+  block->chunk_capacity = 16;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, block->chunk_capacity * sizeof(block->chunks[0]),
+      (void**)&block->chunks);
+  if (iree_status_is_ok(status)) {
+    block->chunk_count = 1;
+    block->chunks[0].offset = 0;
+    block->chunks[0].size = block_size;
+    block->chunks[0].is_free = true;
+  }
+
+  if (iree_status_is_ok(status)) {
+    VkMemoryAllocateFlagsInfo allocate_flags_info = {};
+    allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+    allocate_flags_info.pNext = NULL;
+    allocate_flags_info.flags = 0;
+    if (iree_all_bits_set(
+            logical_device->enabled_features(),
+            IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES)) {
+      allocate_flags_info.flags |= VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+    }
+    allocate_flags_info.deviceMask = 0;
+    VkMemoryAllocateInfo allocate_info = {};
+    allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocate_info.pNext = &allocate_flags_info;
+    allocate_info.allocationSize = block_size;
+    allocate_info.memoryTypeIndex = memory_type_index;
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkAllocateMemory(
+            *logical_device, &allocate_info, logical_device->allocator(),
+            &block->device_memory),
+        "vkAllocateMemory");
+  }
+
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(
+          block_allocator->memory_props.memoryTypes[memory_type_index]
+              .propertyFlags,
+          VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkMapMemory(
+            *logical_device, block->device_memory, /*offset=*/0,
+            VK_WHOLE_SIZE, /*flags=*/0, (void**)&block->host_ptr),
+        "vkMapMemory");
+    if (!iree_status_is_ok(status)) {
+      logical_device->syms()->vkFreeMemory(
+          *logical_device, block->device_memory, logical_device->allocator());
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    IREE_TRACE_ALLOC_NAMED(IREE_HAL_VULKAN_BLOCK_ALLOCATOR_ID,
+                           (void*)block->device_memory, block_size);
+    *out_block = block;
+  } else {
+    iree_allocator_free(host_allocator, block->chunks);
+    iree_allocator_free(host_allocator, block);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Inserts |count| uninitialized chunks into |block| before |index|.
+static iree_status_t iree_hal_vulkan_memory_block_insert_chunks(
+    iree_hal_vulkan_memory_block_t* block, iree_host_size_t index,
+    iree_host_size_t count) {
+  if (block->chunk_count + count > block->chunk_capacity) {
+    iree_host_size_t new_capacity = block->chunk_capacity * 2;
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        block->block_allocator->host_allocator,
+        new_capacity * sizeof(block->chunks[0]), (void**)&block->chunks));
+    block->chunk_capacity = new_capacity;
+  }
+  memmove(&block->chunks[index + count], &block->chunks[index],
+          (block->chunk_count - index) * sizeof(block->chunks[0]));
+  block->chunk_count += count;
+  return iree_ok_status();
+}
+
+// Removes |count| chunks from |block| starting at |index|.
+static void iree_hal_vulkan_memory_block_erase_chunks(
+    iree_hal_vulkan_memory_block_t* block, iree_host_size_t index,
+    iree_host_size_t count) {
+  memmove(&block->chunks[index], &block->chunks[index + count],
+          (block->chunk_count - index - count) * sizeof(block->chunks[0]));
+  block->chunk_count -= count;
+}
+
+// Allocates a range satisfying |requirements| from |block| if it has room.
+// Returns false in |out_found| if no free chunk is large enough.
+static iree_status_t iree_hal_vulkan_memory_block_allocate_range(
+    iree_hal_vulkan_memory_block_t* block,
+    const VkMemoryRequirements* requirements, bool* out_found,
+    VkDeviceSize* out_offset) {
+  *out_found = false;
+  VkDeviceSize alignment = iree_max(requirements->alignment, 1);
+  for (iree_host_size_t i = 0; i < block->chunk_count; ++i) {
+    iree_hal_vulkan_memory_chunk_t chunk = block->chunks[i];
+    if (!chunk.is_free) continue;
+    VkDeviceSize aligned_offset = iree_device_align(chunk.offset, alignment);
+    VkDeviceSize padding = aligned_offset - chunk.offset;
+    if (chunk.size < padding + requirements->size) continue;
+    VkDeviceSize remaining = chunk.size - padding - requirements->size;
+
+    // Split the chunk into [padding][allocation][remaining], dropping the
+    // empty ones. Padding is returned to the free list so that it can be used
+    // by allocations with smaller alignment requirements.
+    iree_host_size_t index = i;
+    iree_host_size_t new_chunk_count = (padding ? 1 : 0) + (remaining ? 1 : 0);
+    IREE_RETURN_IF_ERROR(iree_hal_vulkan_memory_block_insert_chunks(
+        block, index + 1, new_chunk_count));
+    if (padding) {
+      block->chunks[index].offset = chunk.offset;
+      block->chunks[index].size = padding;
+      block->chunks[index].is_free = true;
+      ++index;
+    }
+    block->chunks[index].offset = aligned_offset;
+    block->chunks[index].size = requirements->size;
+    block->chunks[index].is_free = false;
+    if (remaining) {
+      block->chunks[index + 1].offset = aligned_offset + requirements->size;
+      block->chunks[index + 1].size = remaining;
+      block->chunks[index + 1].is_free = true;
+    }
+
+    ++block->allocation_count;
+    *out_found = true;
+    *out_offset = aligned_offset;
+    return iree_ok_status();
+  }
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_vulkan_block_allocator_allocate(
+    iree_hal_vulkan_block_allocator_t* block_allocator,
+    uint32_t memory_type_index, const VkMemoryRequirements* requirements,
+    iree_hal_vulkan_block_allocation_t* out_allocation) {
+  IREE_ASSERT_ARGUMENT(block_allocator);
+  IREE_ASSERT_ARGUMENT(requirements);
+  IREE_ASSERT_ARGUMENT(out_allocation);
+  memset(out_allocation, 0, sizeof(*out_allocation));
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)requirements->size);
+
+  iree_slim_mutex_lock(&block_allocator->mutex);
+
+  iree_status_t status = iree_ok_status();
+  bool found = false;
+  VkDeviceSize offset = 0;
+  iree_hal_vulkan_memory_block_t* block =
+      block_allocator->blocks[memory_type_index];
+  for (; block && iree_status_is_ok(status); block = block->next) {
+    status = iree_hal_vulkan_memory_block_allocate_range(block, requirements,
+                                                         &found, &offset);
+    if (found) break;
+  }
+
+  if (iree_status_is_ok(status) && !found) {
+    status = iree_hal_vulkan_memory_block_allocate(block_allocator,
+                                                   memory_type_index, &block);
+    if (iree_status_is_ok(status)) {
+      block->next = block_allocator->blocks[memory_type_index];
+      block_allocator->blocks[memory_type_index] = block;
+      status = iree_hal_vulkan_memory_block_allocate_range(block, requirements,
+                                                           &found, &offset);
+    }
+    if (iree_status_is_ok(status) && !found) {
+      status = iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                                "allocation of %" PRIu64
+                                " bytes does not fit in a block",
+                                (uint64_t)requirements->size);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    out_allocation->block = block;
+    out_allocation->device_memory = block->device_memory;
+    out_allocation->offset = offset;
+    out_allocation->host_ptr =
+        block->host_ptr ? block->host_ptr + offset : NULL;
+  }
+
+  iree_slim_mutex_unlock(&block_allocator->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Unlinks |block| from the list of its memory type.
+static void iree_hal_vulkan_block_allocator_unlink_block(
+    iree_hal_vulkan_block_allocator_t* block_allocator,
+    iree_hal_vulkan_memory_block_t* block) {
+  iree_hal_vulkan_memory_block_t** link =
+      &block_allocator->blocks[block->memory_type_index];
+  while (*link != block) link = &(*link)->next;
+  *link = block->next;
+}
+
+void iree_hal_vulkan_block_allocator_release(
+    iree_hal_vulkan_memory_block_t* block, VkDeviceSize offset) {
+  IREE_ASSERT_ARGUMENT(block);
+  iree_hal_vulkan_block_allocator_t* block_allocator = block->block_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&block_allocator->mutex);
+
+  // Binary search for the chunk at |offset|.
+  iree_host_size_t low = 0;
+  iree_host_size_t high = block->chunk_count;
+  while (low < high) {
+    iree_host_size_t mid = low + (high - low) / 2;
+    if (block->chunks[mid].offset < offset) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  iree_host_size_t index = low;
+  IREE_ASSERT(index < block->chunk_count &&
+              block->chunks[index].offset == offset &&
+              !block->chunks[index].is_free);
+  block->chunks[index].is_free = true;
+  --block->allocation_count;
+
+  // Coalesce with the following and preceding chunks if free.
+  if (index + 1 < block->chunk_count && block->chunks[index + 1].is_free) {
+    block->chunks[index].size += block->chunks[index + 1].size;
+    iree_hal_vulkan_memory_block_erase_chunks(block, index + 1, 1);
+  }
+  if (index > 0 && block->chunks[index - 1].is_free) {
+    block->chunks[index - 1].size += block->chunks[index].size;
+    iree_hal_vulkan_memory_block_erase_chunks(block, index, 1);
+  }
+
+  // Keep a single empty block per memory type around to avoid thrashing when
+  // a transient allocation repeatedly comes and goes.
+  bool free_block = false;
+  if (block->allocation_count == 0) {
+    for (iree_hal_vulkan_memory_block_t* other =
+             block_allocator->blocks[block->memory_type_index];
+         other; other = other->next) {
+      if (other != block && other->allocation_count == 0) {
+        free_block = true;
+        break;
+      }
+    }
+    if (free_block) {
+      iree_hal_vulkan_block_allocator_unlink_block(block_allocator, block);
+    }
+  }
+
+  iree_slim_mutex_unlock(&block_allocator->mutex);
+  if (free_block) iree_hal_vulkan_memory_block_free(block);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_vulkan_block_allocator_trim(
+    iree_hal_vulkan_block_allocator_t* block_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Unlink all empty blocks under the lock and free them outside of it.
+  iree_hal_vulkan_memory_block_t* empty_blocks = NULL;
+  iree_slim_mutex_lock(&block_allocator->mutex);
+  for (uint32_t i = 0; i < IREE_ARRAYSIZE(block_allocator->blocks); ++i) {
+    iree_hal_vulkan_memory_block_t** link = &block_allocator->blocks[i];
+    while (*link) {
+      iree_hal_vulkan_memory_block_t* block = *link;
+      if (block->allocation_count == 0) {
+        *link = block->next;
+        block->next = empty_blocks;
+        empty_blocks = block;
+      } else {
+        link = &block->next;
+      }
+    }
+  }
+  iree_slim_mutex_unlock(&block_allocator->mutex);
+
+  while (empty_blocks) {
+    iree_hal_vulkan_memory_block_t* next = empty_blocks->next;
+    iree_hal_vulkan_memory_block_free(empty_blocks);
+    empty_blocks = next;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
@@ -0,0 +1,94 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_VULKAN_BLOCK_ALLOCATOR_H_
+#define IREE_HAL_DRIVERS_VULKAN_BLOCK_ALLOCATOR_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/vulkan/handle_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_vulkan_block_allocator_t
+//===----------------------------------------------------------------------===//
+
+// Suballocates device memory for buffers from large VkDeviceMemory blocks.
+//
+// Implementations limit the number of live vkAllocateMemory allocations
+// (maxMemoryAllocationCount may be as low as 4096) and each allocation is
+// expensive. Each memory type has its own set of blocks sized relative to the
+// heap it comes from and allocations are placed first-fit into the free
+// ranges of a block with neighboring free ranges coalesced when released.
+//
+// Allocations larger than half a block are expected to use dedicated device
+// memory instead. Host-visible memory types that are not host-coherent are
+// never suballocated so that flushes and invalidations of one buffer do not
+// need to be aligned against its neighbors. Blocks of host-visible memory are
+// persistently mapped.
+//
+// Empty blocks beyond one per memory type are released as soon as they empty
+// and the remaining ones are released on trim.
+//
+// Thread-safe; allocations may be made and released from any thread.
+typedef struct iree_hal_vulkan_block_allocator_t
+    iree_hal_vulkan_block_allocator_t;
+
+// A block of device memory that suballocations are made from.
+typedef struct iree_hal_vulkan_memory_block_t iree_hal_vulkan_memory_block_t;
+
+// A range of device memory suballocated from a block.
+typedef struct iree_hal_vulkan_block_allocation_t {
+  // Block the range was allocated from; passed back when releasing.
+  iree_hal_vulkan_memory_block_t* block;
+  // Device memory of the block the range is within.
+  VkDeviceMemory device_memory;
+  // Offset of the range within |device_memory|.
+  VkDeviceSize offset;
+  // Host pointer to the start of the range if the memory is host-visible.
+  uint8_t* host_ptr;
+} iree_hal_vulkan_block_allocation_t;
+
+// Creates a block allocator for the memory types in |memory_props|.
+iree_status_t iree_hal_vulkan_block_allocator_create(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    const VkPhysicalDeviceMemoryProperties* memory_props,
+    iree_allocator_t host_allocator,
+    iree_hal_vulkan_block_allocator_t** out_block_allocator);
+
+// Destroys |block_allocator| and all of its blocks.
+// All allocations must have been released.
+void iree_hal_vulkan_block_allocator_destroy(
+    iree_hal_vulkan_block_allocator_t* block_allocator);
+
+// Returns true if memory satisfying |requirements| from |memory_type_index|
+// should be suballocated instead of using a dedicated allocation.
+bool iree_hal_vulkan_block_allocator_should_suballocate(
+    iree_hal_vulkan_block_allocator_t* block_allocator,
+    uint32_t memory_type_index, const VkMemoryRequirements* requirements);
+
+// Allocates a range satisfying |requirements| from a block of
+// |memory_type_index|, allocating a new block if no existing one has room.
+iree_status_t iree_hal_vulkan_block_allocator_allocate(
+    iree_hal_vulkan_block_allocator_t* block_allocator,
+    uint32_t memory_type_index, const VkMemoryRequirements* requirements,
+    iree_hal_vulkan_block_allocation_t* out_allocation);
+
+// Releases the range at |offset| previously allocated from |block|.
+void iree_hal_vulkan_block_allocator_release(
+    iree_hal_vulkan_memory_block_t* block, VkDeviceSize offset);
+
+// Releases all blocks that have no live allocations.
+void iree_hal_vulkan_block_allocator_trim(
+    iree_hal_vulkan_block_allocator_t* block_allocator);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_VULKAN_BLOCK_ALLOCATOR_H_
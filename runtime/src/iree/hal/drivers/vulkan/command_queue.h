@@ -13,6 +13,7 @@
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
+#include "iree/hal/drivers/vulkan/status_util.h"
 #include "iree/hal/drivers/vulkan/tracing.h"
 #include "iree/hal/drivers/vulkan/util/arena.h"
 
@@ -52,6 +53,21 @@ class CommandQueue {
 
   virtual iree_status_t WaitIdle(iree_timeout_t timeout) = 0;
 
+  // Enqueues sparse binding operations. The queue must be from a family with
+  // VK_QUEUE_SPARSE_BINDING_BIT and the operations are ordered only by the
+  // semaphores in |bind_infos|.
+  iree_status_t BindSparse(uint32_t bind_info_count,
+                           const VkBindSparseInfo* bind_infos) {
+    IREE_TRACE_SCOPE_NAMED("CommandQueue::BindSparse");
+    iree_slim_mutex_lock(&queue_mutex_);
+    iree_status_t status = VK_RESULT_TO_STATUS(
+        syms()->vkQueueBindSparse(queue_, bind_info_count, bind_infos,
+                                  VK_NULL_HANDLE),
+        "vkQueueBindSparse");
+    iree_slim_mutex_unlock(&queue_mutex_);
+    return status;
+  }
+
  protected:
   CommandQueue(VkDeviceHandle* logical_device,
                iree_hal_command_category_t supported_categories, VkQueue queue)
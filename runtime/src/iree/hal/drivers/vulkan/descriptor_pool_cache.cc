@@ -8,6 +8,7 @@
 
 #include <array>
 #include <cstdint>
+#include <cstring>
 #include <ostream>
 
 #include "iree/hal/drivers/vulkan/status_util.h"
@@ -22,6 +23,10 @@ namespace {
 // chaining in the command buffer when pools run out.
 static constexpr int kMaxDescriptorSets = 4096;
 
+// Capacity of each descriptor buffer. Descriptors for storage buffers are
+// typically 16-64 bytes and so this fits a few thousand sets.
+static constexpr VkDeviceSize kDescriptorBufferCapacity = 256 * 1024;
+
 }  // namespace
 
 DescriptorSetGroup::~DescriptorSetGroup() {
@@ -38,11 +43,44 @@ iree_status_t DescriptorSetGroup::Reset() {
   }
   descriptor_pools_.clear();
 
+  if (descriptor_pool_cache_ != nullptr) {
+    descriptor_pool_cache_->ReleaseDescriptorBuffers(descriptor_buffers_);
+  }
+  descriptor_buffers_.clear();
+
   return iree_ok_status();
 }
 
 DescriptorPoolCache::DescriptorPoolCache(VkDeviceHandle* logical_device)
-    : logical_device_(logical_device) {}
+    : logical_device_(logical_device) {
+  iree_slim_mutex_initialize(&mutex_);
+
+  memset(&descriptor_buffer_properties_, 0,
+         sizeof(descriptor_buffer_properties_));
+  descriptor_buffer_properties_.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_PROPERTIES_EXT;
+  memset(&memory_properties_, 0, sizeof(memory_properties_));
+  if (logical_device_->enabled_extensions().descriptor_buffer) {
+    VkPhysicalDeviceProperties2 physical_device_properties;
+    memset(&physical_device_properties, 0, sizeof(physical_device_properties));
+    physical_device_properties.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2;
+    physical_device_properties.pNext = &descriptor_buffer_properties_;
+    syms().vkGetPhysicalDeviceProperties2(logical_device_->physical_device(),
+                                          &physical_device_properties);
+    descriptor_buffer_properties_.pNext = nullptr;
+    syms().vkGetPhysicalDeviceMemoryProperties(
+        logical_device_->physical_device(), &memory_properties_);
+  }
+}
+
+DescriptorPoolCache::~DescriptorPoolCache() {
+  for (const auto& descriptor_buffer : free_descriptor_buffers_) {
+    DestroyDescriptorBuffer(descriptor_buffer);
+  }
+  free_descriptor_buffers_.clear();
+  iree_slim_mutex_deinitialize(&mutex_);
+}
 
 iree_status_t DescriptorPoolCache::AcquireDescriptorPool(
     VkDescriptorType descriptor_type, int max_descriptor_count,
@@ -95,6 +133,135 @@ iree_status_t DescriptorPoolCache::ReleaseDescriptorPools(
   return iree_ok_status();
 }
 
+iree_status_t DescriptorPoolCache::AcquireDescriptorBuffer(
+    DescriptorBuffer* out_descriptor_buffer) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorPoolCache::AcquireDescriptorBuffer");
+
+  iree_slim_mutex_lock(&mutex_);
+  if (!free_descriptor_buffers_.empty()) {
+    *out_descriptor_buffer = free_descriptor_buffers_.back();
+    free_descriptor_buffers_.pop_back();
+    iree_slim_mutex_unlock(&mutex_);
+    return iree_ok_status();
+  }
+  iree_slim_mutex_unlock(&mutex_);
+
+  DescriptorBuffer descriptor_buffer;
+  descriptor_buffer.capacity = kDescriptorBufferCapacity;
+
+  VkBufferCreateInfo buffer_create_info;
+  buffer_create_info.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  buffer_create_info.pNext = nullptr;
+  buffer_create_info.flags = 0;
+  buffer_create_info.size = descriptor_buffer.capacity;
+  buffer_create_info.usage =
+      VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT |
+      VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT;
+  buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  buffer_create_info.queueFamilyIndexCount = 0;
+  buffer_create_info.pQueueFamilyIndices = nullptr;
+  VK_RETURN_IF_ERROR(syms().vkCreateBuffer(*logical_device_,
+                                           &buffer_create_info,
+                                           logical_device_->allocator(),
+                                           &descriptor_buffer.handle),
+                     "vkCreateBuffer");
+
+  // Descriptors are written from the host during recording and read by the
+  // device so we need memory that is both host-visible and coherent.
+  VkMemoryRequirements requirements;
+  syms().vkGetBufferMemoryRequirements(*logical_device_,
+                                       descriptor_buffer.handle, &requirements);
+  const VkMemoryPropertyFlags required_flags =
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  uint32_t memory_type_index = UINT32_MAX;
+  for (uint32_t i = 0; i < memory_properties_.memoryTypeCount; ++i) {
+    if ((requirements.memoryTypeBits & (1u << i)) &&
+        iree_all_bits_set(memory_properties_.memoryTypes[i].propertyFlags,
+                          required_flags)) {
+      memory_type_index = i;
+      break;
+    }
+  }
+  if (memory_type_index == UINT32_MAX) {
+    DestroyDescriptorBuffer(descriptor_buffer);
+    return iree_make_status(
+        IREE_STATUS_UNAVAILABLE,
+        "no host-visible coherent memory type usable for descriptor buffers");
+  }
+
+  VkMemoryAllocateFlagsInfo allocate_flags_info;
+  allocate_flags_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO;
+  allocate_flags_info.pNext = nullptr;
+  allocate_flags_info.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT;
+  allocate_flags_info.deviceMask = 0;
+  VkMemoryAllocateInfo allocate_info;
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.pNext = &allocate_flags_info;
+  allocate_info.allocationSize = requirements.size;
+  allocate_info.memoryTypeIndex = memory_type_index;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      syms().vkAllocateMemory(*logical_device_, &allocate_info,
+                              logical_device_->allocator(),
+                              &descriptor_buffer.memory),
+      "vkAllocateMemory");
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms().vkBindBufferMemory(*logical_device_, descriptor_buffer.handle,
+                                  descriptor_buffer.memory, 0),
+        "vkBindBufferMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        syms().vkMapMemory(*logical_device_, descriptor_buffer.memory, 0,
+                           VK_WHOLE_SIZE, 0,
+                           (void**)&descriptor_buffer.host_ptr),
+        "vkMapMemory");
+  }
+  if (iree_status_is_ok(status)) {
+    VkBufferDeviceAddressInfo address_info;
+    address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+    address_info.pNext = nullptr;
+    address_info.buffer = descriptor_buffer.handle;
+    descriptor_buffer.device_address =
+        syms().vkGetBufferDeviceAddress
+            ? syms().vkGetBufferDeviceAddress(*logical_device_, &address_info)
+            : syms().vkGetBufferDeviceAddressKHR(*logical_device_,
+                                                 &address_info);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_descriptor_buffer = descriptor_buffer;
+  } else {
+    DestroyDescriptorBuffer(descriptor_buffer);
+  }
+  return status;
+}
+
+void DescriptorPoolCache::ReleaseDescriptorBuffers(
+    const std::vector<DescriptorBuffer>& descriptor_buffers) {
+  if (descriptor_buffers.empty()) return;
+  IREE_TRACE_SCOPE_NAMED("DescriptorPoolCache::ReleaseDescriptorBuffers");
+  iree_slim_mutex_lock(&mutex_);
+  free_descriptor_buffers_.insert(free_descriptor_buffers_.end(),
+                                  descriptor_buffers.begin(),
+                                  descriptor_buffers.end());
+  iree_slim_mutex_unlock(&mutex_);
+}
+
+void DescriptorPoolCache::DestroyDescriptorBuffer(
+    const DescriptorBuffer& descriptor_buffer) {
+  if (descriptor_buffer.handle != VK_NULL_HANDLE) {
+    syms().vkDestroyBuffer(*logical_device_, descriptor_buffer.handle,
+                           logical_device_->allocator());
+  }
+  if (descriptor_buffer.memory != VK_NULL_HANDLE) {
+    // Freeing the memory implicitly unmaps it.
+    syms().vkFreeMemory(*logical_device_, descriptor_buffer.memory,
+                        logical_device_->allocator());
+  }
+}
+
 }  // namespace vulkan
 }  // namespace hal
 }  // namespace iree
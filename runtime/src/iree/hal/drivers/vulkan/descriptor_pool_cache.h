@@ -12,6 +12,7 @@
 #include <vector>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
@@ -32,23 +33,42 @@ struct DescriptorPool {
   VkDescriptorPool handle = VK_NULL_HANDLE;
 };
 
+// A host-visible block of device memory that descriptor sets are written into
+// directly when VK_EXT_descriptor_buffer is in use.
+struct DescriptorBuffer {
+  // Buffer handle bound with the descriptor buffer usage.
+  VkBuffer handle = VK_NULL_HANDLE;
+  // Memory backing the buffer.
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  // Persistently mapped host pointer to the buffer contents.
+  uint8_t* host_ptr = nullptr;
+  // Device address of the buffer used when binding it to command buffers.
+  VkDeviceAddress device_address = 0;
+  // Total capacity of the buffer in bytes.
+  VkDeviceSize capacity = 0;
+};
+
 // A group of descriptor sets allocated and released together.
 // The group must be explicitly reset with Reset() prior to disposing.
 class DescriptorSetGroup final {
  public:
   DescriptorSetGroup() = default;
   DescriptorSetGroup(DescriptorPoolCache* descriptor_pool_cache,
-                     std::vector<DescriptorPool> descriptor_pools)
+                     std::vector<DescriptorPool> descriptor_pools,
+                     std::vector<DescriptorBuffer> descriptor_buffers = {})
       : descriptor_pool_cache_(descriptor_pool_cache),
-        descriptor_pools_(std::move(descriptor_pools)) {}
+        descriptor_pools_(std::move(descriptor_pools)),
+        descriptor_buffers_(std::move(descriptor_buffers)) {}
   DescriptorSetGroup(const DescriptorSetGroup&) = delete;
   DescriptorSetGroup& operator=(const DescriptorSetGroup&) = delete;
   DescriptorSetGroup(DescriptorSetGroup&& other) noexcept
       : descriptor_pool_cache_(std::move(other.descriptor_pool_cache_)),
-        descriptor_pools_(std::move(other.descriptor_pools_)) {}
+        descriptor_pools_(std::move(other.descriptor_pools_)),
+        descriptor_buffers_(std::move(other.descriptor_buffers_)) {}
   DescriptorSetGroup& operator=(DescriptorSetGroup&& other) {
     std::swap(descriptor_pool_cache_, other.descriptor_pool_cache_);
     std::swap(descriptor_pools_, other.descriptor_pools_);
+    std::swap(descriptor_buffers_, other.descriptor_buffers_);
     return *this;
   }
   ~DescriptorSetGroup();
@@ -58,6 +78,7 @@ class DescriptorSetGroup final {
  private:
   DescriptorPoolCache* descriptor_pool_cache_;
   std::vector<DescriptorPool> descriptor_pools_;
+  std::vector<DescriptorBuffer> descriptor_buffers_;
 };
 
 // A "cache" (or really, pool) of descriptor pools. These pools are allocated
@@ -69,6 +90,7 @@ class DescriptorSetGroup final {
 class DescriptorPoolCache final {
  public:
   explicit DescriptorPoolCache(VkDeviceHandle* logical_device);
+  ~DescriptorPoolCache();
 
   VkDeviceHandle* logical_device() const { return logical_device_; }
   const DynamicSymbols& syms() const { return *logical_device_->syms(); }
@@ -86,8 +108,38 @@ class DescriptorPoolCache final {
   iree_status_t ReleaseDescriptorPools(
       const std::vector<DescriptorPool>& descriptor_pools);
 
+  // Properties of descriptor buffers on the device. Only valid when
+  // VK_EXT_descriptor_buffer is in use.
+  const VkPhysicalDeviceDescriptorBufferPropertiesEXT&
+  descriptor_buffer_properties() const {
+    return descriptor_buffer_properties_;
+  }
+
+  // Acquires a descriptor buffer for use by the caller. Buffers released to
+  // the cache are reused before new ones are allocated.
+  // When all sets written to the buffer are no longer in use it must be
+  // returned to the cache with ReleaseDescriptorBuffers.
+  iree_status_t AcquireDescriptorBuffer(
+      DescriptorBuffer* out_descriptor_buffer);
+
+  // Releases descriptor buffers back to the cache. The buffers must no longer
+  // be in use by any in-flight command.
+  void ReleaseDescriptorBuffers(
+      const std::vector<DescriptorBuffer>& descriptor_buffers);
+
  private:
+  void DestroyDescriptorBuffer(const DescriptorBuffer& descriptor_buffer);
+
   VkDeviceHandle* logical_device_;
+
+  VkPhysicalDeviceDescriptorBufferPropertiesEXT descriptor_buffer_properties_;
+  VkPhysicalDeviceMemoryProperties memory_properties_;
+
+  // Descriptor buffers released for reuse. Guarded by the mutex as command
+  // buffers may be recorded and retired concurrently from multiple threads.
+  iree_slim_mutex_t mutex_;
+  std::vector<DescriptorBuffer> free_descriptor_buffers_
+      IREE_GUARDED_BY(mutex_);
 };
 
 }  // namespace vulkan
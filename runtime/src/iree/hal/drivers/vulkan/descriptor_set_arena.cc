@@ -6,7 +6,9 @@
 
 #include "iree/hal/drivers/vulkan/descriptor_set_arena.h"
 
+#include <cinttypes>
 #include <cstddef>
+#include <cstring>
 #include <type_traits>
 #include <utility>
 
@@ -98,6 +100,10 @@ DescriptorSetArena::~DescriptorSetArena() {
         descriptor_pool_cache_->ReleaseDescriptorPools(used_descriptor_pools_));
     used_descriptor_pools_.clear();
   }
+  if (!used_descriptor_buffers_.empty()) {
+    descriptor_pool_cache_->ReleaseDescriptorBuffers(used_descriptor_buffers_);
+    used_descriptor_buffers_.clear();
+  }
 }
 
 iree_status_t DescriptorSetArena::BindDescriptorSet(
@@ -112,6 +118,13 @@ iree_status_t DescriptorSetArena::BindDescriptorSet(
     return iree_ok_status();
   }
 
+  // Otherwise write directly into descriptor buffers when available to avoid
+  // the pool allocation and vkUpdateDescriptorSets overhead below.
+  if (logical_device_->enabled_extensions().descriptor_buffer) {
+    return WriteDescriptorBufferSet(command_buffer, pipeline_layout, set,
+                                    binding_count, bindings);
+  }
+
   IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::BindDescriptorSet");
 
   auto* set_layout =
@@ -220,10 +233,162 @@ void DescriptorSetArena::PushDescriptorSet(
       set, static_cast<uint32_t>(write_info_count), write_infos);
 }
 
+iree_status_t DescriptorSetArena::WriteDescriptorBufferSet(
+    VkCommandBuffer command_buffer, iree_hal_pipeline_layout_t* pipeline_layout,
+    uint32_t set, iree_host_size_t binding_count,
+    const iree_hal_descriptor_set_binding_t* bindings) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::WriteDescriptorBufferSet");
+  if (set >= bound_descriptor_buffer_sets_.size()) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "descriptor set %u out of range (max=%" PRIhsz ")",
+                            set, bound_descriptor_buffer_sets_.size());
+  }
+
+  const auto& properties =
+      descriptor_pool_cache_->descriptor_buffer_properties();
+  auto* set_layout =
+      iree_hal_vulkan_native_pipeline_layout_set(pipeline_layout, set);
+  VkDeviceSize set_size =
+      iree_hal_vulkan_native_descriptor_set_layout_buffer_size(set_layout);
+
+  // Sub-allocate the set from the current buffer, switching to a new one if
+  // this is the first set written or the current one is exhausted.
+  VkDeviceSize set_offset = iree_device_align(
+      descriptor_buffer_offset_, properties.descriptorBufferOffsetAlignment);
+  if (descriptor_buffer_.handle == VK_NULL_HANDLE ||
+      set_offset + set_size > descriptor_buffer_.capacity) {
+    IREE_RETURN_IF_ERROR(
+        SwitchDescriptorBuffer(command_buffer, pipeline_layout));
+    set_offset = iree_device_align(descriptor_buffer_offset_,
+                                   properties.descriptorBufferOffsetAlignment);
+    if (set_offset + set_size > descriptor_buffer_.capacity) {
+      return iree_make_status(
+          IREE_STATUS_RESOURCE_EXHAUSTED,
+          "descriptor set of %" PRIu64 " bytes exceeds descriptor buffer "
+          "capacity",
+          (uint64_t)set_size);
+    }
+  }
+  descriptor_buffer_offset_ = set_offset + set_size;
+
+  // Write each binding directly into the mapped buffer. Unlike
+  // vkUpdateDescriptorSets this needs no intermediate objects and only copies
+  // the driver's descriptor bytes.
+  uint8_t* set_ptr = descriptor_buffer_.host_ptr + set_offset;
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    const auto& binding = bindings[i];
+    VkDescriptorAddressInfoEXT address_info;
+    address_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_ADDRESS_INFO_EXT;
+    address_info.pNext = nullptr;
+    address_info.address = 0;
+    address_info.range = 0;
+    address_info.format = VK_FORMAT_UNDEFINED;
+    if (binding.buffer) {
+      VkBufferDeviceAddressInfo buffer_address_info;
+      buffer_address_info.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO;
+      buffer_address_info.pNext = nullptr;
+      buffer_address_info.buffer =
+          iree_hal_vulkan_buffer_handle(binding.buffer);
+      VkDeviceAddress buffer_address =
+          syms().vkGetBufferDeviceAddress
+              ? syms().vkGetBufferDeviceAddress(*logical_device_,
+                                                &buffer_address_info)
+              : syms().vkGetBufferDeviceAddressKHR(*logical_device_,
+                                                   &buffer_address_info);
+      address_info.address = buffer_address +
+                             iree_hal_buffer_byte_offset(binding.buffer) +
+                             binding.offset;
+      // See PopulateDescriptorSetWriteInfos for why ranges are 32-bit aligned.
+      // Descriptor buffers have no VK_WHOLE_SIZE so whole-buffer bindings use
+      // the remaining length of the buffer.
+      iree_device_size_t remaining_length =
+          iree_hal_buffer_byte_length(binding.buffer) - binding.offset;
+      address_info.range = iree_device_align(
+          binding.length == IREE_WHOLE_BUFFER
+              ? remaining_length
+              : std::min(binding.length, remaining_length),
+          4);
+    }
+    VkDescriptorGetInfoEXT get_info;
+    get_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_GET_INFO_EXT;
+    get_info.pNext = nullptr;
+    get_info.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    get_info.data.pStorageBuffer = binding.buffer ? &address_info : nullptr;
+    syms().vkGetDescriptorEXT(
+        *logical_device_, &get_info, properties.storageBufferDescriptorSize,
+        set_ptr + iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+                      set_layout, binding.binding));
+  }
+
+  // Point the set at its range of the bound buffer (always index 0).
+  uint32_t buffer_index = 0;
+  syms().vkCmdSetDescriptorBufferOffsetsEXT(
+      command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+      iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout), set, 1,
+      &buffer_index, &set_offset);
+  bound_descriptor_buffer_sets_[set].offset = set_offset;
+  bound_descriptor_buffer_sets_[set].size = set_size;
+
+  return iree_ok_status();
+}
+
+iree_status_t DescriptorSetArena::SwitchDescriptorBuffer(
+    VkCommandBuffer command_buffer,
+    iree_hal_pipeline_layout_t* pipeline_layout) {
+  IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::SwitchDescriptorBuffer");
+  const auto& properties =
+      descriptor_pool_cache_->descriptor_buffer_properties();
+
+  DescriptorBuffer previous_buffer = descriptor_buffer_;
+  IREE_RETURN_IF_ERROR(
+      descriptor_pool_cache_->AcquireDescriptorBuffer(&descriptor_buffer_));
+  used_descriptor_buffers_.push_back(descriptor_buffer_);
+  descriptor_buffer_offset_ = 0;
+
+  VkDescriptorBufferBindingInfoEXT binding_info;
+  binding_info.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_BUFFER_BINDING_INFO_EXT;
+  binding_info.pNext = nullptr;
+  binding_info.address = descriptor_buffer_.device_address;
+  binding_info.usage = VK_BUFFER_USAGE_RESOURCE_DESCRIPTOR_BUFFER_BIT_EXT;
+  syms().vkCmdBindDescriptorBuffersEXT(command_buffer, 1, &binding_info);
+
+  // Rebinding the buffer invalidates the offsets of sets still bound from the
+  // previous one. Their contents are immutable once written so they can be
+  // copied over as-is; the previous buffer stays alive until the group
+  // retires.
+  if (previous_buffer.handle == VK_NULL_HANDLE) return iree_ok_status();
+  iree_host_size_t set_count =
+      iree_hal_vulkan_native_pipeline_layout_set_count(pipeline_layout);
+  for (uint32_t set = 0;
+       set < std::min(set_count, bound_descriptor_buffer_sets_.size()); ++set) {
+    auto& bound_set = bound_descriptor_buffer_sets_[set];
+    if (bound_set.size == 0) continue;
+    VkDeviceSize set_offset = iree_device_align(
+        descriptor_buffer_offset_, properties.descriptorBufferOffsetAlignment);
+    memcpy(descriptor_buffer_.host_ptr + set_offset,
+           previous_buffer.host_ptr + bound_set.offset, bound_set.size);
+    descriptor_buffer_offset_ = set_offset + bound_set.size;
+    uint32_t buffer_index = 0;
+    syms().vkCmdSetDescriptorBufferOffsetsEXT(
+        command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE,
+        iree_hal_vulkan_native_pipeline_layout_handle(pipeline_layout), set, 1,
+        &buffer_index, &set_offset);
+    bound_set.offset = set_offset;
+  }
+  return iree_ok_status();
+}
+
 DescriptorSetGroup DescriptorSetArena::Flush() {
   IREE_TRACE_SCOPE_NAMED("DescriptorSetArena::Flush");
 
-  if (used_descriptor_pools_.empty()) {
+  // The next recording starts with no descriptor buffer bound.
+  descriptor_buffer_ = {};
+  descriptor_buffer_offset_ = 0;
+  for (auto& bound_set : bound_descriptor_buffer_sets_) {
+    bound_set = {};
+  }
+
+  if (used_descriptor_pools_.empty() && used_descriptor_buffers_.empty()) {
     // No resources to free.
     return DescriptorSetGroup{};
   }
@@ -232,7 +397,8 @@ DescriptorSetGroup DescriptorSetArena::Flush() {
     bucket = {};
   }
   return DescriptorSetGroup(descriptor_pool_cache_,
-                            std::move(used_descriptor_pools_));
+                            std::move(used_descriptor_pools_),
+                            std::move(used_descriptor_buffers_));
 }
 
 }  // namespace vulkan
@@ -54,6 +54,21 @@ class DescriptorSetArena final {
                          uint32_t set, iree_host_size_t binding_count,
                          const iree_hal_descriptor_set_binding_t* bindings);
 
+  // Writes the descriptor set into the current descriptor buffer and binds it
+  // to the command buffer, if supported.
+  iree_status_t WriteDescriptorBufferSet(
+      VkCommandBuffer command_buffer,
+      iree_hal_pipeline_layout_t* pipeline_layout, uint32_t set,
+      iree_host_size_t binding_count,
+      const iree_hal_descriptor_set_binding_t* bindings);
+
+  // Acquires a new descriptor buffer and binds it to |command_buffer|. Any
+  // sets written to the previous buffer that are still in use by
+  // |pipeline_layout| are copied into the new buffer and rebound.
+  iree_status_t SwitchDescriptorBuffer(
+      VkCommandBuffer command_buffer,
+      iree_hal_pipeline_layout_t* pipeline_layout);
+
   VkDeviceHandle* logical_device_;
   DescriptorPoolCache* descriptor_pool_cache_;
 
@@ -66,6 +81,24 @@ class DescriptorSetArena final {
 
   // All pools that have been used during allocation.
   std::vector<DescriptorPool> used_descriptor_pools_;
+
+  // Descriptor buffer that sets are currently written into and bound from when
+  // VK_EXT_descriptor_buffer is in use. Sets are sub-allocated linearly from
+  // |descriptor_buffer_offset_| and the buffer is bound to the command buffer
+  // when the first set is written.
+  DescriptorBuffer descriptor_buffer_;
+  VkDeviceSize descriptor_buffer_offset_ = 0;
+
+  // Ranges of |descriptor_buffer_| containing the sets last bound to each set
+  // index. Used to carry bound sets over when switching buffers.
+  struct BoundDescriptorBufferSet {
+    VkDeviceSize offset = 0;
+    VkDeviceSize size = 0;
+  };
+  std::array<BoundDescriptorBufferSet, 4> bound_descriptor_buffer_sets_;
+
+  // All descriptor buffers that have been used during allocation.
+  std::vector<DescriptorBuffer> used_descriptor_buffers_;
 };
 
 }  // namespace vulkan
@@ -8,6 +8,7 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/inline_array.h"
@@ -20,6 +21,7 @@
 #include "iree/hal/drivers/vulkan/native_pipeline_layout.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/resource_set.h"
 
 using namespace iree::hal::vulkan;
@@ -29,6 +31,7 @@ using namespace iree::hal::vulkan;
 // indirection.
 typedef struct iree_hal_vulkan_direct_command_buffer_t {
   iree_hal_command_buffer_t base;
+  iree_hal_device_t* device;
   VkDeviceHandle* logical_device;
   iree_hal_vulkan_tracing_context_t* tracing_context;
   iree_arena_block_pool_t* block_pool;
@@ -36,6 +39,12 @@ typedef struct iree_hal_vulkan_direct_command_buffer_t {
   VkCommandPoolHandle* command_pool;
   VkCommandBuffer handle;
 
+  // True if the command pool belongs to a queue family supporting dispatches.
+  // Command buffers recorded for transfer queues fail any command requiring a
+  // dispatch with IREE_STATUS_UNAVAILABLE so that they can be re-recorded for
+  // a dispatch queue.
+  bool can_dispatch;
+
   DynamicSymbols* syms;
 
   // Maintains a reference to all resources used within the command buffer.
@@ -52,6 +61,12 @@ typedef struct iree_hal_vulkan_direct_command_buffer_t {
 
   BuiltinExecutables* builtin_executables;
 
+  // Used to create nested command buffers for indirect command buffers
+  // executed within this one.
+  DescriptorPoolCache* descriptor_pool_cache;
+  // Recordings of indirect command buffers shared across the device.
+  iree_hal_vulkan_indirect_command_buffer_cache_t* indirect_cache;
+
   // Shadow copy of push constants used during normal operation, for restoring
   // after builtin_executables uses vkCmdPushConstants. Size must be greater
   // than or equal to the push constant memory used by builtin_executables.
@@ -83,6 +98,7 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
     iree_hal_vulkan_tracing_context_t* tracing_context,
     iree::hal::vulkan::DescriptorPoolCache* descriptor_pool_cache,
     iree::hal::vulkan::BuiltinExecutables* builtin_executables,
+    iree_hal_vulkan_indirect_command_buffer_cache_t* indirect_cache,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer) {
   IREE_ASSERT_ARGUMENT(logical_device);
@@ -105,7 +121,10 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
   allocate_info.pNext = NULL;
   allocate_info.commandPool = *command_pool;
   allocate_info.commandBufferCount = 1;
-  allocate_info.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+  allocate_info.level =
+      iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED)
+          ? VK_COMMAND_BUFFER_LEVEL_SECONDARY
+          : VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 
   VkCommandBuffer handle = VK_NULL_HANDLE;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -119,11 +138,14 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
     iree_hal_command_buffer_initialize(
         device, mode, command_categories, queue_affinity, binding_capacity,
         &iree_hal_vulkan_direct_command_buffer_vtable, &command_buffer->base);
+    command_buffer->device = device;
     command_buffer->logical_device = logical_device;
     command_buffer->tracing_context = tracing_context;
     command_buffer->block_pool = block_pool;
     command_buffer->command_pool = command_pool;
     command_buffer->handle = handle;
+    command_buffer->can_dispatch = iree_all_bits_set(
+        command_categories, IREE_HAL_COMMAND_CATEGORY_DISPATCH);
     command_buffer->syms = logical_device->syms().get();
 
     new (&command_buffer->descriptor_set_arena)
@@ -131,6 +153,8 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
     new (&command_buffer->descriptor_set_group) DescriptorSetGroup();
 
     command_buffer->builtin_executables = builtin_executables;
+    command_buffer->descriptor_pool_cache = descriptor_pool_cache;
+    command_buffer->indirect_cache = indirect_cache;
     status = iree_hal_resource_set_allocate(block_pool,
                                             &command_buffer->resource_set);
   }
@@ -189,11 +213,26 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_begin(
   VkCommandBufferBeginInfo begin_info;
   begin_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
   begin_info.pNext = NULL;
-  begin_info.flags = iree_all_bits_set(command_buffer->base.mode,
-                                       IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)
-                         ? VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
-                         : 0;
+  begin_info.flags = 0;
   begin_info.pInheritanceInfo = NULL;
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    begin_info.flags |= VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  }
+  VkCommandBufferInheritanceInfo inheritance_info;
+  if (iree_all_bits_set(command_buffer->base.mode,
+                        IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+    // Secondary command buffers are compute-only and inherit nothing.
+    memset(&inheritance_info, 0, sizeof(inheritance_info));
+    inheritance_info.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    begin_info.pInheritanceInfo = &inheritance_info;
+  }
+  if (!iree_all_bits_set(command_buffer->base.mode,
+                         IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT)) {
+    // Reusable command buffers may be pending in multiple submissions or
+    // executed by multiple primary command buffers at the same time.
+    begin_info.flags |= VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
+  }
   VK_RETURN_IF_ERROR(command_buffer->syms->vkBeginCommandBuffer(
                          command_buffer->handle, &begin_info),
                      "vkBeginCommandBuffer");
@@ -333,6 +372,44 @@ static VkAccessFlags iree_hal_vulkan_convert_access_mask(
   return flags;
 }
 
+// Returns the pipeline stages in |stage_mask| supported by the queue family
+// |command_buffer| is recorded for. Transfer queues support neither shader
+// stages nor indirect command processing.
+static VkPipelineStageFlags iree_hal_vulkan_direct_command_buffer_stages(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_execution_stage_t stage_mask) {
+  VkPipelineStageFlags flags =
+      iree_hal_vulkan_convert_pipeline_stage_flags(stage_mask);
+  if (!command_buffer->can_dispatch) {
+    flags &= ~(VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT |
+               VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT);
+    if (!flags) flags = VK_PIPELINE_STAGE_ALL_COMMANDS_BIT;
+  }
+  return flags;
+}
+
+// Returns the access types in |access_mask| supported by the queue family
+// |command_buffer| is recorded for.
+static VkAccessFlags iree_hal_vulkan_direct_command_buffer_access(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_access_scope_t access_mask) {
+  VkAccessFlags flags = iree_hal_vulkan_convert_access_mask(access_mask);
+  if (!command_buffer->can_dispatch) {
+    flags &= ~(VK_ACCESS_INDIRECT_COMMAND_READ_BIT |
+               VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT |
+               VK_ACCESS_SHADER_WRITE_BIT);
+  }
+  return flags;
+}
+
+// Fails if |command_buffer| is recorded for a queue that cannot dispatch.
+static iree_status_t iree_hal_vulkan_direct_command_buffer_require_dispatch(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer) {
+  if (IREE_LIKELY(command_buffer->can_dispatch)) return iree_ok_status();
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "command requires a queue supporting dispatches");
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_execution_stage_t source_stage_mask,
@@ -354,10 +431,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     VkMemoryBarrier* info = iree_inline_array_at(memory_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, memory_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, memory_barrier.target_scope);
   }
 
   iree_inline_array(VkBufferMemoryBarrier, buffer_barrier_infos,
@@ -367,10 +444,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
     VkBufferMemoryBarrier* info = iree_inline_array_at(buffer_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, buffer_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, buffer_barrier.target_scope);
     info->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->buffer = iree_hal_vulkan_buffer_handle(buffer_barrier.buffer);
@@ -380,8 +457,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execution_barrier(
 
   command_buffer->syms->vkCmdPipelineBarrier(
       command_buffer->handle,
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask),
-      iree_hal_vulkan_convert_pipeline_stage_flags(target_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stages(command_buffer,
+                                                   source_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stages(command_buffer,
+                                                   target_stage_mask),
       /*dependencyFlags=*/0, (uint32_t)memory_barrier_count,
       iree_inline_array_data(memory_barrier_infos),
       (uint32_t)buffer_barrier_count,
@@ -404,7 +483,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_signal_event(
 
   command_buffer->syms->vkCmdSetEvent(
       command_buffer->handle, iree_hal_vulkan_native_event_handle(event),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask));
+      iree_hal_vulkan_direct_command_buffer_stages(command_buffer,
+                                                   source_stage_mask));
 
   return iree_ok_status();
 }
@@ -420,7 +500,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_reset_event(
 
   command_buffer->syms->vkCmdResetEvent(
       command_buffer->handle, iree_hal_vulkan_native_event_handle(event),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask));
+      iree_hal_vulkan_direct_command_buffer_stages(command_buffer,
+                                                   source_stage_mask));
 
   return iree_ok_status();
 }
@@ -455,10 +536,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
     VkMemoryBarrier* info = iree_inline_array_at(memory_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(memory_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, memory_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, memory_barrier.target_scope);
   }
 
   iree_inline_array(VkBufferMemoryBarrier, buffer_barrier_infos,
@@ -468,10 +549,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
     VkBufferMemoryBarrier* info = iree_inline_array_at(buffer_barrier_infos, i);
     info->sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
     info->pNext = NULL;
-    info->srcAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.source_scope);
-    info->dstAccessMask =
-        iree_hal_vulkan_convert_access_mask(buffer_barrier.target_scope);
+    info->srcAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, buffer_barrier.source_scope);
+    info->dstAccessMask = iree_hal_vulkan_direct_command_buffer_access(
+        command_buffer, buffer_barrier.target_scope);
     info->srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
     info->buffer = iree_hal_vulkan_buffer_handle(buffer_barrier.buffer);
@@ -482,8 +563,10 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_wait_events(
   command_buffer->syms->vkCmdWaitEvents(
       command_buffer->handle, (uint32_t)event_count,
       iree_inline_array_data(event_handles),
-      iree_hal_vulkan_convert_pipeline_stage_flags(source_stage_mask),
-      iree_hal_vulkan_convert_pipeline_stage_flags(target_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stages(command_buffer,
+                                                   source_stage_mask),
+      iree_hal_vulkan_direct_command_buffer_stages(command_buffer,
+                                                   target_stage_mask),
       (uint32_t)memory_barrier_count,
       iree_inline_array_data(memory_barrier_infos),
       (uint32_t)buffer_barrier_count,
@@ -533,16 +616,20 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_fill_buffer(
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
   VkBuffer target_device_buffer = iree_hal_vulkan_buffer_handle(target_buffer);
 
+  // vkCmdFillBuffer requires a 4 byte alignment for the offset, pattern, and
+  // length. We use a polyfill here that fills the unaligned start and end of
+  // fill operations, if needed. The polyfill is a dispatch.
+  if (target_offset % 4 != 0 || length % 4 != 0) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_vulkan_direct_command_buffer_require_dispatch(command_buffer));
+  }
+
   IREE_VULKAN_TRACE_ZONE_BEGIN(command_buffer->tracing_context,
                                command_buffer->handle);
 
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &target_buffer));
 
-  // vkCmdFillBuffer requires a 4 byte alignment for the offset, pattern, and
-  // length. We use a polyfill here that fills the unaligned start and end of
-  // fill operations, if needed.
-
   if (target_offset % 4 != 0 || length % 4 != 0) {
     // TODO(scotttodd): only restore push constants that have been modified?
     //                  (this can pass uninitialized memory right now, which
@@ -672,6 +759,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_push_constants(
     const void* values, iree_host_size_t values_length) {
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_direct_command_buffer_require_dispatch(command_buffer));
 
   iree_host_size_t storage_size =
       IREE_ARRAYSIZE(command_buffer->push_constants_storage);
@@ -696,6 +785,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_push_descriptor_set(
     const iree_hal_descriptor_set_binding_t* bindings) {
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_direct_command_buffer_require_dispatch(command_buffer));
 
   // TODO(benvanik): batch insert by getting the resources in their own list.
   for (iree_host_size_t i = 0; i < binding_count; ++i) {
@@ -717,6 +808,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch(
     uint32_t workgroup_x, uint32_t workgroup_y, uint32_t workgroup_z) {
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_direct_command_buffer_require_dispatch(command_buffer));
 
   IREE_TRACE({
     iree_hal_vulkan_source_location_t source_location;
@@ -757,6 +850,8 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch_indirect(
     iree_device_size_t workgroups_offset) {
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
+  IREE_RETURN_IF_ERROR(
+      iree_hal_vulkan_direct_command_buffer_require_dispatch(command_buffer));
 
   const void* resources[2] = {executable, workgroups_buffer};
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
@@ -792,6 +887,60 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_dispatch_indirect(
   return iree_ok_status();
 }
 
+// Returns a nested recording of the indirect |commands| with |binding_table|,
+// reusing a prior recording if one was made with the same bindings.
+// NOTE: Vulkan has no native indirect bindings. A recording bakes in the
+// bindings and is only reused when the binding table matches exactly; update-
+// after-bind descriptors or device addresses would allow patching bindings in
+// place but require matching executables.
+static iree_status_t iree_hal_vulkan_direct_command_buffer_record_indirect(
+    iree_hal_vulkan_direct_command_buffer_t* command_buffer,
+    iree_hal_command_buffer_t* commands,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_hal_command_buffer_t** out_recording) {
+  *out_recording = NULL;
+  bool is_reusable = !iree_all_bits_set(commands->mode,
+                                        IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+  if (is_reusable && command_buffer->indirect_cache &&
+      iree_hal_vulkan_indirect_command_buffer_cache_lookup(
+          command_buffer->indirect_cache, commands, binding_table,
+          out_recording)) {
+    return iree_ok_status();
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_command_buffer_mode_t mode =
+      IREE_HAL_COMMAND_BUFFER_MODE_NESTED |
+      IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED |
+      (commands->mode & IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+  iree_hal_command_buffer_t* recording = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_direct_command_buffer_allocate(
+              command_buffer->device, command_buffer->logical_device,
+              command_buffer->command_pool, mode,
+              command_buffer->base.allowed_categories,
+              command_buffer->base.queue_affinity,
+              /*binding_capacity=*/0, command_buffer->tracing_context,
+              command_buffer->descriptor_pool_cache,
+              command_buffer->builtin_executables,
+              command_buffer->indirect_cache, command_buffer->block_pool,
+              &recording));
+  iree_status_t status = iree_hal_deferred_command_buffer_apply(
+      commands, recording, binding_table);
+  if (iree_status_is_ok(status) && is_reusable &&
+      command_buffer->indirect_cache) {
+    status = iree_hal_vulkan_indirect_command_buffer_cache_insert(
+        command_buffer->indirect_cache, commands, binding_table, recording);
+  }
+  if (iree_status_is_ok(status)) {
+    *out_recording = recording;
+  } else {
+    iree_hal_command_buffer_release(recording);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_vulkan_direct_command_buffer_execute_commands(
     iree_hal_command_buffer_t* base_command_buffer,
     iree_hal_command_buffer_t* base_commands,
@@ -799,22 +948,34 @@ static iree_status_t iree_hal_vulkan_direct_command_buffer_execute_commands(
   iree_hal_vulkan_direct_command_buffer_t* command_buffer =
       iree_hal_vulkan_direct_command_buffer_cast(base_command_buffer);
 
-  if (binding_table.count > 0) {
-    // TODO(#10144): support indirect command buffers with binding tables.
-    // Since Vulkan doesn't natively support this we'd need to emulate things
-    // with an iree_hal_vulkan_indirect_command_buffer_t type that captured the
-    // command buffer using deferred command buffer and allowed replay with a
-    // binding table. If we wanted to actually reuse the command buffers we'd
-    // need to use update-after-bind (where supported), device pointers (where
-    // supported), or descriptor indexing and a big ringbuffer (make a 1024
-    // element descriptor array and cycle through it with each submission).
-    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                            "indirect command buffers not yet implemented");
-  }
-
   IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert(
       command_buffer->resource_set, 1, &base_commands));
 
+  if (iree_hal_deferred_command_buffer_isa(base_commands)) {
+    // Indirect command buffers are recorded into a nested VkCommandBuffer
+    // with the bindings resolved from the binding table.
+    iree_hal_command_buffer_t* recording = NULL;
+    IREE_RETURN_IF_ERROR(
+        iree_hal_vulkan_direct_command_buffer_record_indirect(
+            command_buffer, base_commands, binding_table, &recording));
+    iree_status_t status = iree_hal_resource_set_insert(
+        command_buffer->resource_set, 1, &recording);
+    if (iree_status_is_ok(status)) {
+      VkCommandBuffer recording_handle =
+          iree_hal_vulkan_direct_command_buffer_handle(recording);
+      command_buffer->syms->vkCmdExecuteCommands(command_buffer->handle, 1,
+                                                 &recording_handle);
+    }
+    iree_hal_command_buffer_release(recording);
+    return status;
+  }
+
+  if (binding_table.count > 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "binding tables are only supported with indirect "
+                            "command buffers");
+  }
+
   iree_hal_vulkan_direct_command_buffer_t* commands =
       iree_hal_vulkan_direct_command_buffer_cast(base_commands);
 
@@ -12,6 +12,7 @@
 #include "iree/hal/drivers/vulkan/builtin_executables.h"
 #include "iree/hal/drivers/vulkan/descriptor_pool_cache.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
+#include "iree/hal/drivers/vulkan/indirect_command_buffer_cache.h"
 #include "iree/hal/drivers/vulkan/tracing.h"
 
 #ifdef __cplusplus
@@ -21,6 +22,13 @@ extern "C" {
 typedef struct iree_arena_block_pool_t iree_arena_block_pool_t;
 
 // Creates a command buffer that directly records into a VkCommandBuffer.
+// Command buffers with IREE_HAL_COMMAND_BUFFER_MODE_NESTED record into a
+// secondary VkCommandBuffer that can be executed by other command buffers.
+//
+// Indirect command buffers (those with deferred bindings) executed by this
+// command buffer are recorded into nested command buffers on first use and
+// memoized in |indirect_cache| by binding table so that later executions with
+// the same bindings reuse the recording.
 //
 // NOTE: the |block_pool| must remain live for the lifetime of the command
 // buffers that use it.
@@ -34,6 +42,7 @@ iree_status_t iree_hal_vulkan_direct_command_buffer_allocate(
     iree_hal_vulkan_tracing_context_t* tracing_context,
     iree::hal::vulkan::DescriptorPoolCache* descriptor_pool_cache,
     iree::hal::vulkan::BuiltinExecutables* builtin_executables,
+    iree_hal_vulkan_indirect_command_buffer_cache_t* indirect_cache,
     iree_arena_block_pool_t* block_pool,
     iree_hal_command_buffer_t** out_command_buffer);
 
@@ -32,8 +32,9 @@ iree_status_t DirectCommandQueue::TranslateBatchInfo(
   // TODO(benvanik): see if we can go to finer-grained stages.
   // For example, if this was just queue ownership transfers then we can use
   // the pseudo-stage of VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT.
-  VkPipelineStageFlags dst_stage_mask =
-      VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+  // Transfer queues do not support shader stages.
+  VkPipelineStageFlags dst_stage_mask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+  if (can_dispatch()) dst_stage_mask |= VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
 
   auto wait_semaphore_handles =
       arena->AllocateSpan<VkSemaphore>(batch->wait_semaphores.count);
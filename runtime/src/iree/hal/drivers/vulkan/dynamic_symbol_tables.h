@@ -296,6 +296,12 @@ namespace vulkan {
   DEV_PFN(OPTIONAL, vkGetBufferDeviceAddress)                           \
   DEV_PFN(OPTIONAL, vkGetBufferDeviceAddressKHR)                        \
                                                                         \
+  DEV_PFN(OPTIONAL, vkCmdBindDescriptorBuffersEXT)                      \
+  DEV_PFN(OPTIONAL, vkCmdSetDescriptorBufferOffsetsEXT)                 \
+  DEV_PFN(OPTIONAL, vkGetDescriptorEXT)                                 \
+  DEV_PFN(OPTIONAL, vkGetDescriptorSetLayoutBindingOffsetEXT)           \
+  DEV_PFN(OPTIONAL, vkGetDescriptorSetLayoutSizeEXT)                    \
+                                                                        \
   INS_PFN(EXCLUDED, vkCreateDebugReportCallbackEXT)                     \
   INS_PFN(OPTIONAL, vkCreateDebugUtilsMessengerEXT)                     \
   INS_PFN(EXCLUDED, vkCreateDisplayPlaneSurfaceKHR)                     \
@@ -225,6 +225,12 @@ iree_hal_vulkan_populate_enabled_device_extensions(
     } else if (strcmp(extension_name,
                       VK_KHR_COOPERATIVE_MATRIX_EXTENSION_NAME) == 0) {
       extensions.cooperative_matrix = true;
+    } else if (strcmp(extension_name,
+                      VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME) == 0) {
+      extensions.descriptor_buffer = true;
+    } else if (strcmp(extension_name,
+                      VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME) == 0) {
+      extensions.memory_priority = true;
     }
   }
   return extensions;
@@ -254,5 +260,8 @@ iree_hal_vulkan_infer_enabled_device_extensions(
       device_syms->vkGetBufferDeviceAddressKHR) {
     extensions.buffer_device_address = true;
   }
+  // NOTE: descriptor_buffer and memory_priority are not inferred as we can't
+  // tell whether the `descriptorBuffer` and `memoryPriority` features were
+  // enabled on a device we didn't create.
   return extensions;
 }
@@ -92,6 +92,11 @@ typedef struct iree_hal_vulkan_device_extensions_t {
   bool shader_float16_int8 : 1;
   // VK_KHR_cooperative_matrix is enabled.
   bool cooperative_matrix : 1;
+  // VK_EXT_descriptor_buffer is enabled along with its `descriptorBuffer`
+  // feature and descriptor sets are written into descriptor buffers.
+  bool descriptor_buffer : 1;
+  // VK_EXT_memory_priority is enabled along with its `memoryPriority` feature.
+  bool memory_priority : 1;
 } iree_hal_vulkan_device_extensions_t;
 
 // Returns a bitfield with all of the provided extension names.
@@ -0,0 +1,193 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/vulkan/indirect_command_buffer_cache.h"
+
+#include <cstring>
+
+#include "iree/base/internal/synchronization.h"
+
+typedef struct iree_hal_vulkan_indirect_command_buffer_cache_entry_t {
+  // Deferred command buffer the recording was made from (retained).
+  iree_hal_command_buffer_t* commands;
+  // Recording of |commands| made with |bindings| (retained).
+  iree_hal_command_buffer_t* recording;
+  // Copy of the binding table the recording was made with.
+  iree_host_size_t binding_count;
+  iree_hal_buffer_binding_t* bindings;
+} iree_hal_vulkan_indirect_command_buffer_cache_entry_t;
+
+struct iree_hal_vulkan_indirect_command_buffer_cache_t {
+  // The allocator used to create the cache.
+  iree_allocator_t host_allocator;
+
+  // Guards the entry list. The lock is only held while scanning or shifting
+  // the list; command buffers are never released with the lock held.
+  iree_slim_mutex_t mutex;
+
+  // Maximum number of recordings retained by the cache.
+  iree_host_size_t capacity;
+  // Total number of recordings currently in the cache.
+  iree_host_size_t count IREE_GUARDED_BY(mutex);
+  // Recordings ordered from least to most recently used.
+  iree_hal_vulkan_indirect_command_buffer_cache_entry_t entries[]
+      IREE_GUARDED_BY(mutex);
+};
+
+static void iree_hal_vulkan_indirect_command_buffer_cache_entry_release(
+    iree_allocator_t host_allocator,
+    iree_hal_vulkan_indirect_command_buffer_cache_entry_t* entry) {
+  iree_hal_command_buffer_release(entry->recording);
+  iree_hal_command_buffer_release(entry->commands);
+  iree_allocator_free(host_allocator, entry->bindings);
+}
+
+static bool iree_hal_vulkan_indirect_command_buffer_cache_entry_matches(
+    const iree_hal_vulkan_indirect_command_buffer_cache_entry_t* entry,
+    iree_hal_command_buffer_t* commands,
+    iree_hal_buffer_binding_table_t binding_table) {
+  if (entry->commands != commands) return false;
+  if (entry->binding_count != binding_table.count) return false;
+  for (iree_host_size_t i = 0; i < binding_table.count; ++i) {
+    const iree_hal_buffer_binding_t* a = &entry->bindings[i];
+    const iree_hal_buffer_binding_t* b = &binding_table.bindings[i];
+    if (a->buffer != b->buffer || a->offset != b->offset ||
+        a->length != b->length) {
+      return false;
+    }
+  }
+  return true;
+}
+
+iree_status_t iree_hal_vulkan_indirect_command_buffer_cache_allocate(
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_vulkan_indirect_command_buffer_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_vulkan_indirect_command_buffer_cache_t* cache = NULL;
+  iree_host_size_t total_size =
+      sizeof(*cache) + capacity * sizeof(*cache->entries);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&cache));
+  cache->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&cache->mutex);
+  cache->capacity = capacity;
+  cache->count = 0;
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_hal_vulkan_indirect_command_buffer_cache_free(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache) {
+  if (!cache) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_hal_vulkan_indirect_command_buffer_cache_trim(cache);
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  iree_allocator_free(cache->host_allocator, cache);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+bool iree_hal_vulkan_indirect_command_buffer_cache_lookup(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache,
+    iree_hal_command_buffer_t* commands,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_hal_command_buffer_t** out_recording) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(out_recording);
+  *out_recording = NULL;
+
+  iree_slim_mutex_lock(&cache->mutex);
+  // Scan from the most recently used end as the same few command buffers are
+  // usually executed back to back.
+  for (iree_host_size_t i = cache->count; i > 0; --i) {
+    iree_hal_vulkan_indirect_command_buffer_cache_entry_t entry =
+        cache->entries[i - 1];
+    if (!iree_hal_vulkan_indirect_command_buffer_cache_entry_matches(
+            &entry, commands, binding_table)) {
+      continue;
+    }
+    // Move the entry to the most recently used end.
+    memmove(&cache->entries[i - 1], &cache->entries[i],
+            (cache->count - i) * sizeof(cache->entries[0]));
+    cache->entries[cache->count - 1] = entry;
+    iree_hal_command_buffer_retain(entry.recording);
+    *out_recording = entry.recording;
+    break;
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+  return *out_recording != NULL;
+}
+
+iree_status_t iree_hal_vulkan_indirect_command_buffer_cache_insert(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache,
+    iree_hal_command_buffer_t* commands,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_hal_command_buffer_t* recording) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(commands);
+  IREE_ASSERT_ARGUMENT(recording);
+  if (cache->capacity == 0) return iree_ok_status();
+
+  iree_hal_vulkan_indirect_command_buffer_cache_entry_t entry;
+  entry.commands = commands;
+  entry.recording = recording;
+  entry.binding_count = binding_table.count;
+  entry.bindings = NULL;
+  if (binding_table.count > 0) {
+    IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+        cache->host_allocator,
+        binding_table.count * sizeof(binding_table.bindings[0]),
+        (void**)&entry.bindings));
+    memcpy(entry.bindings, binding_table.bindings,
+           binding_table.count * sizeof(binding_table.bindings[0]));
+  }
+  iree_hal_command_buffer_retain(commands);
+  iree_hal_command_buffer_retain(recording);
+
+  iree_hal_vulkan_indirect_command_buffer_cache_entry_t evicted;
+  bool did_evict = false;
+  iree_slim_mutex_lock(&cache->mutex);
+  if (cache->count == cache->capacity) {
+    evicted = cache->entries[0];
+    did_evict = true;
+    memmove(&cache->entries[0], &cache->entries[1],
+            (cache->count - 1) * sizeof(cache->entries[0]));
+    --cache->count;
+  }
+  cache->entries[cache->count++] = entry;
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  if (did_evict) {
+    iree_hal_vulkan_indirect_command_buffer_cache_entry_release(
+        cache->host_allocator, &evicted);
+  }
+  return iree_ok_status();
+}
+
+void iree_hal_vulkan_indirect_command_buffer_cache_trim(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Pop one entry at a time so that no command buffer is released while the
+  // lock is held.
+  while (true) {
+    iree_hal_vulkan_indirect_command_buffer_cache_entry_t entry;
+    iree_slim_mutex_lock(&cache->mutex);
+    bool has_entry = cache->count > 0;
+    if (has_entry) entry = cache->entries[--cache->count];
+    iree_slim_mutex_unlock(&cache->mutex);
+    if (!has_entry) break;
+    iree_hal_vulkan_indirect_command_buffer_cache_entry_release(
+        cache->host_allocator, &entry);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
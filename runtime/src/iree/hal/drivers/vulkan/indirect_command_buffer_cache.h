@@ -0,0 +1,75 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_VULKAN_INDIRECT_COMMAND_BUFFER_CACHE_H_
+#define IREE_HAL_DRIVERS_VULKAN_INDIRECT_COMMAND_BUFFER_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_vulkan_indirect_command_buffer_cache_t
+//===----------------------------------------------------------------------===//
+
+// A cache of VkCommandBuffer recordings of indirect command buffers keyed by
+// the binding table they were recorded with.
+//
+// Vulkan has no native indirect bindings so command buffers created with a
+// binding capacity are captured as deferred command buffers and recorded into
+// a nested VkCommandBuffer once their binding table is known. Reusable models
+// commonly execute the same command buffer with the same binding table every
+// invocation and the cache lets those executions skip recording entirely and
+// issue a single vkCmdExecuteCommands.
+//
+// Entries retain both the deferred command buffer and its recording. Deferred
+// command buffers cannot be re-recorded so a retained one always matches its
+// recordings. Binding table buffers are compared by identity only and are kept
+// live by the recording that references them.
+//
+// Thread-safe; command buffers may look up and insert from any thread.
+typedef struct iree_hal_vulkan_indirect_command_buffer_cache_t
+    iree_hal_vulkan_indirect_command_buffer_cache_t;
+
+// Allocates a new cache holding up to |capacity| recordings.
+// The least recently used recording is released when over capacity.
+iree_status_t iree_hal_vulkan_indirect_command_buffer_cache_allocate(
+    iree_host_size_t capacity, iree_allocator_t host_allocator,
+    iree_hal_vulkan_indirect_command_buffer_cache_t** out_cache);
+
+// Releases all recordings in |cache| and frees it.
+void iree_hal_vulkan_indirect_command_buffer_cache_free(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache);
+
+// Looks up a recording of |commands| made with |binding_table|.
+// Returns true and a retained recording in |out_recording| if one was found.
+bool iree_hal_vulkan_indirect_command_buffer_cache_lookup(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache,
+    iree_hal_command_buffer_t* commands,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_hal_command_buffer_t** out_recording);
+
+// Inserts |recording| of |commands| made with |binding_table| into |cache|.
+// Both command buffers are retained by the cache. The recording must have been
+// made reusable as it may be executed by multiple submissions concurrently.
+iree_status_t iree_hal_vulkan_indirect_command_buffer_cache_insert(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache,
+    iree_hal_command_buffer_t* commands,
+    iree_hal_buffer_binding_table_t binding_table,
+    iree_hal_command_buffer_t* recording);
+
+// Releases all recordings in |cache|.
+void iree_hal_vulkan_indirect_command_buffer_cache_trim(
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_VULKAN_INDIRECT_COMMAND_BUFFER_CACHE_H_
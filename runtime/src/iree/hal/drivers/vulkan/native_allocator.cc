@@ -9,6 +9,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/drivers/vulkan/base_buffer.h"
+#include "iree/hal/drivers/vulkan/block_allocator.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/native_buffer.h"
 #include "iree/hal/drivers/vulkan/sparse_buffer.h"
@@ -35,9 +36,17 @@ typedef struct iree_hal_vulkan_native_allocator_t {
   VkPhysicalDeviceMemoryProperties memory_props;
   VkDeviceSize min_imported_host_pointer_alignment;
 
+  // True if device-local buffers are allocated from host-visible coherent
+  // memory. See IREE_HAL_VULKAN_DEVICE_FLAG_UNIFIED_MEMORY.
+  bool unified_memory;
+
   // Used to quickly look up the memory type index used for a particular usage.
   iree_hal_vulkan_memory_types_t memory_types;
 
+  // Suballocates device memory for buffers that are small relative to the
+  // heap they are allocated from.
+  iree_hal_vulkan_block_allocator_t* block_allocator;
+
   IREE_STATISTICS(iree_hal_allocator_statistics_t statistics;)
 } iree_hal_vulkan_native_allocator_t;
 
@@ -55,6 +64,30 @@ iree_hal_vulkan_native_allocator_cast(iree_hal_allocator_t* base_value) {
 static void iree_hal_vulkan_native_allocator_destroy(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator);
 
+// Returns true if the device shares its memory with the host and exposes a
+// memory type that is device-local, host-visible, and host-coherent. Only
+// integrated GPUs and CPUs are considered as discrete devices may report such
+// types for small BAR windows that shouldn't be used for all allocations.
+static bool iree_hal_vulkan_has_unified_memory(
+    const VkPhysicalDeviceProperties* device_props,
+    const VkPhysicalDeviceMemoryProperties* memory_props) {
+  if (device_props->deviceType != VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU &&
+      device_props->deviceType != VK_PHYSICAL_DEVICE_TYPE_CPU) {
+    return false;
+  }
+  const VkMemoryPropertyFlags unified_flags =
+      VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+      VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+      VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+  for (uint32_t i = 0; i < memory_props->memoryTypeCount; ++i) {
+    if (iree_all_bits_set(memory_props->memoryTypes[i].propertyFlags,
+                          unified_flags)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 extern "C" iree_status_t iree_hal_vulkan_native_allocator_create(
     const iree_hal_vulkan_device_options_t* options, VkInstance instance,
     VkPhysicalDevice physical_device, VkDeviceHandle* logical_device,
@@ -94,10 +127,22 @@ extern "C" iree_status_t iree_hal_vulkan_native_allocator_create(
   allocator->min_imported_host_pointer_alignment =
       external_memory_props.minImportedHostPointerAlignment;
 
+  if (iree_all_bits_set(options->flags,
+                        IREE_HAL_VULKAN_DEVICE_FLAG_UNIFIED_MEMORY)) {
+    allocator->unified_memory = iree_hal_vulkan_has_unified_memory(
+        &allocator->device_props, &allocator->memory_props);
+  }
+
   iree_status_t status = iree_hal_vulkan_populate_memory_types(
       &allocator->device_props, &allocator->memory_props,
       &allocator->memory_types);
 
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_block_allocator_create(
+        logical_device, &allocator->memory_props, host_allocator,
+        &allocator->block_allocator);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_allocator = (iree_hal_allocator_t*)allocator;
   } else {
@@ -115,6 +160,7 @@ static void iree_hal_vulkan_native_allocator_destroy(
   iree_allocator_t host_allocator = allocator->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_vulkan_block_allocator_destroy(allocator->block_allocator);
   iree_allocator_free(host_allocator, allocator);
 
   IREE_TRACE_ZONE_END(z0);
@@ -129,6 +175,9 @@ static iree_allocator_t iree_hal_vulkan_native_allocator_host_allocator(
 
 static iree_status_t iree_hal_vulkan_native_allocator_trim(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator) {
+  iree_hal_vulkan_native_allocator_t* allocator =
+      iree_hal_vulkan_native_allocator_cast(base_allocator);
+  iree_hal_vulkan_block_allocator_trim(allocator->block_allocator);
   return iree_ok_status();
 }
 
@@ -240,6 +289,17 @@ iree_hal_vulkan_native_allocator_query_buffer_compatibility(
     // Cannot allocate buffers larger than the max allowed without sparse
     // binding.
     compatibility = IREE_HAL_BUFFER_COMPATIBILITY_NONE;
+  } else if (allocator->unified_memory &&
+             iree_all_bits_set(params->type,
+                               IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+    // Device-local memory is host memory: allocate it coherent and mappable
+    // so that host transfers can be performed with a mapped memcpy instead of
+    // going through staging buffers and queue copies.
+    params->type |= IREE_HAL_MEMORY_TYPE_HOST_VISIBLE |
+                    IREE_HAL_MEMORY_TYPE_HOST_COHERENT;
+    params->usage |= IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                     IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT |
+                     IREE_HAL_BUFFER_USAGE_MAPPING_ACCESS_RANDOM;
   }
 
   return compatibility;
@@ -247,7 +307,7 @@ iree_hal_vulkan_native_allocator_query_buffer_compatibility(
 
 static void iree_hal_vulkan_native_allocator_native_buffer_release(
     void* user_data, iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkDeviceMemory device_memory, VkBuffer handle) {
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, VkBuffer handle) {
   IREE_TRACE_FREE_NAMED(IREE_HAL_VULKAN_NATIVE_ALLOCATOR_ID, (void*)handle);
   logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
                                           logical_device->allocator());
@@ -255,6 +315,74 @@ static void iree_hal_vulkan_native_allocator_native_buffer_release(
                                        logical_device->allocator());
 }
 
+static void iree_hal_vulkan_native_allocator_suballocated_buffer_release(
+    void* user_data, iree::hal::vulkan::VkDeviceHandle* logical_device,
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, VkBuffer handle) {
+  IREE_TRACE_FREE_NAMED(IREE_HAL_VULKAN_NATIVE_ALLOCATOR_ID, (void*)handle);
+  logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
+                                          logical_device->allocator());
+  iree_hal_vulkan_block_allocator_release(
+      (iree_hal_vulkan_memory_block_t*)user_data, memory_offset);
+}
+
+// Suballocates memory for |handle| from the block allocator and wraps it.
+// Returns IREE_STATUS_RESOURCE_EXHAUSTED without a buffer if no block could be
+// allocated in which case the caller should fall back to a dedicated
+// allocation.
+static iree_status_t iree_hal_vulkan_native_allocator_suballocate_and_wrap(
+    iree_hal_vulkan_native_allocator_t* IREE_RESTRICT allocator,
+    const iree_hal_buffer_params_t* IREE_RESTRICT params,
+    iree_device_size_t allocation_size, uint32_t memory_type_index,
+    const VkMemoryRequirements* requirements, VkBuffer handle,
+    iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
+  VkDeviceHandle* logical_device = allocator->logical_device;
+
+  iree_hal_vulkan_block_allocation_t allocation;
+  IREE_RETURN_IF_ERROR(iree_hal_vulkan_block_allocator_allocate(
+      allocator->block_allocator, memory_type_index, requirements,
+      &allocation));
+
+  // Wrap the suballocated range and buffer handle in our own buffer type.
+  iree_hal_vulkan_native_buffer_release_callback_t internal_release_callback = {
+      0};
+  internal_release_callback.fn =
+      iree_hal_vulkan_native_allocator_suballocated_buffer_release;
+  internal_release_callback.user_data = allocation.block;
+  iree_status_t status = iree_hal_vulkan_native_buffer_wrap(
+      (iree_hal_allocator_t*)allocator, params->type, params->access,
+      params->usage, allocation_size,
+      /*byte_offset=*/0,
+      /*byte_length=*/allocation_size, logical_device, allocation.device_memory,
+      allocation.offset, allocation.host_ptr, handle, internal_release_callback,
+      iree_hal_buffer_release_callback_null(), out_buffer);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_vulkan_block_allocator_release(allocation.block,
+                                            allocation.offset);
+    return status;
+  }
+
+  // Bind the range to the buffer.
+  return VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkBindBufferMemory(*logical_device, handle,
+                                                 allocation.device_memory,
+                                                 allocation.offset),
+      "vkBindBufferMemory");
+}
+
+// Returns the VK_EXT_memory_priority priority of allocations with the given
+// |placement_hint|. 0.5 is the default priority of allocations without one.
+static float iree_hal_vulkan_memory_priority_from_hint(
+    iree_hal_buffer_placement_hint_t placement_hint) {
+  switch (placement_hint) {
+    case IREE_HAL_BUFFER_PLACEMENT_HINT_PERSISTENT:
+      return 1.0f;
+    case IREE_HAL_BUFFER_PLACEMENT_HINT_STREAMING:
+      return 0.25f;
+    default:
+      return 0.5f;
+  }
+}
+
 static iree_status_t iree_hal_vulkan_native_allocator_commit_and_wrap(
     iree_hal_vulkan_native_allocator_t* IREE_RESTRICT allocator,
     const iree_hal_buffer_params_t* IREE_RESTRICT params,
@@ -291,6 +419,31 @@ static iree_status_t iree_hal_vulkan_native_allocator_commit_and_wrap(
         allocator->device_props_11.maxMemoryAllocationSize, out_buffer);
   }
 
+  // Most buffers are small relative to the heap and are suballocated from
+  // shared blocks to avoid the cost and count limits of vkAllocateMemory.
+  // If no new block can be allocated we still try a dedicated allocation as
+  // it may fit in what remains of the heap. Persistent buffers get a dedicated
+  // allocation when priorities are supported so that their priority isn't
+  // shared with the transients suballocated from the same block.
+  const bool use_memory_priority =
+      logical_device->enabled_extensions().memory_priority &&
+      params->placement_hint != IREE_HAL_BUFFER_PLACEMENT_HINT_DEFAULT;
+  const bool prefer_dedicated =
+      use_memory_priority &&
+      params->placement_hint == IREE_HAL_BUFFER_PLACEMENT_HINT_PERSISTENT;
+  if (!prefer_dedicated &&
+      iree_hal_vulkan_block_allocator_should_suballocate(
+          allocator->block_allocator, memory_type_index, &requirements)) {
+    iree_status_t status =
+        iree_hal_vulkan_native_allocator_suballocate_and_wrap(
+            allocator, params, allocation_size, memory_type_index,
+            &requirements, handle, out_buffer);
+    if (*out_buffer || !iree_status_is_resource_exhausted(status)) {
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+
   // Allocate the device memory we'll attach the buffer to.
   VkMemoryAllocateInfo allocate_info = {};
   allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
@@ -308,6 +461,14 @@ static iree_status_t iree_hal_vulkan_native_allocator_commit_and_wrap(
   }
   allocate_flags_info.deviceMask = 0;
   allocate_info.pNext = &allocate_flags_info;
+  VkMemoryPriorityAllocateInfoEXT priority_info = {};
+  if (use_memory_priority) {
+    priority_info.sType = VK_STRUCTURE_TYPE_MEMORY_PRIORITY_ALLOCATE_INFO_EXT;
+    priority_info.pNext = allocate_info.pNext;
+    priority_info.priority =
+        iree_hal_vulkan_memory_priority_from_hint(params->placement_hint);
+    allocate_info.pNext = &priority_info;
+  }
   VkDeviceMemory device_memory = VK_NULL_HANDLE;
   VK_RETURN_IF_ERROR(logical_device->syms()->vkAllocateMemory(
                          *logical_device, &allocate_info,
@@ -324,9 +485,9 @@ static iree_status_t iree_hal_vulkan_native_allocator_commit_and_wrap(
       (iree_hal_allocator_t*)allocator, params->type, params->access,
       params->usage, allocation_size,
       /*byte_offset=*/0,
-      /*byte_length=*/allocation_size, logical_device, device_memory, handle,
-      internal_release_callback, iree_hal_buffer_release_callback_null(),
-      out_buffer);
+      /*byte_length=*/allocation_size, logical_device, device_memory,
+      /*memory_offset=*/0, /*host_ptr=*/NULL, handle, internal_release_callback,
+      iree_hal_buffer_release_callback_null(), out_buffer);
   if (!iree_status_is_ok(status)) {
     logical_device->syms()->vkFreeMemory(*logical_device, device_memory,
                                          logical_device->allocator());
@@ -373,8 +534,14 @@ static iree_status_t iree_hal_vulkan_native_allocator_create_buffer(
     buffer_create_info.usage |= VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT;
   }
   if (use_sparse_allocation) {
-    buffer_create_info.flags |= VK_BUFFER_CREATE_SPARSE_BINDING_BIT |
-                                VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+    // Residency is only required for partially bound buffers and is only
+    // valid when the feature is enabled.
+    buffer_create_info.flags |= VK_BUFFER_CREATE_SPARSE_BINDING_BIT;
+    if (iree_all_bits_set(
+            logical_device->enabled_features(),
+            IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_RESIDENCY_ALIASED)) {
+      buffer_create_info.flags |= VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+    }
   }
   buffer_create_info.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
   buffer_create_info.queueFamilyIndexCount = 0;
@@ -457,9 +624,6 @@ static iree_status_t iree_hal_vulkan_native_allocator_allocate_internal(
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
   VkDeviceHandle* logical_device = allocator->logical_device;
 
-  // TODO(benvanik): if on a unified memory system and initial data is present
-  // we could set the mapping bit and ensure a much more efficient upload.
-
   // When required and available we allocate buffers using sparse binding.
   const bool use_sparse_allocation =
       iree_hal_vulkan_buffer_needs_sparse_binding(allocator, params,
@@ -536,6 +700,76 @@ static iree_status_t iree_hal_vulkan_native_allocator_allocate_buffer(
       allocator, &compat_params, allocation_size, out_buffer);
 }
 
+extern "C" iree_status_t iree_hal_vulkan_native_allocator_allocate_unbound(
+    iree_hal_allocator_t* base_allocator,
+    const iree_hal_buffer_params_t* params, iree_device_size_t allocation_size,
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (!iree_hal_resource_is(base_allocator,
+                            &iree_hal_vulkan_native_allocator_vtable)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "device allocator has been replaced");
+  }
+  iree_hal_vulkan_native_allocator_t* allocator =
+      iree_hal_vulkan_native_allocator_cast(base_allocator);
+  VkDeviceHandle* logical_device = allocator->logical_device;
+  if (!iree_all_bits_set(logical_device->enabled_features(),
+                         IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_BINDING)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "sparse binding not enabled on this device");
+  }
+
+  // Coerce options into those required by the current device.
+  iree_hal_buffer_params_t compat_params = *params;
+  if (!iree_all_bits_set(
+          iree_hal_vulkan_native_allocator_query_buffer_compatibility(
+              base_allocator, &compat_params, &allocation_size),
+          IREE_HAL_BUFFER_COMPATIBILITY_ALLOCATABLE)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "allocator cannot allocate a buffer with the given parameters");
+  }
+  if (iree_any_bit_set(compat_params.type,
+                       IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) ||
+      iree_any_bit_set(compat_params.usage,
+                       IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED |
+                           IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT)) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "mappable buffers cannot be sparsely bound");
+  }
+
+  VkBuffer handle = VK_NULL_HANDLE;
+  IREE_RETURN_IF_ERROR(iree_hal_vulkan_native_allocator_create_buffer(
+      logical_device, &compat_params, allocation_size,
+      /*use_sparse_allocation=*/true, /*bind_host_memory=*/false, &handle));
+
+  VkMemoryRequirements requirements = {0};
+  logical_device->syms()->vkGetBufferMemoryRequirements(*logical_device, handle,
+                                                        &requirements);
+  uint32_t memory_type_index = 0;
+  iree_status_t status = iree_hal_vulkan_find_memory_type(
+      &allocator->device_props, &allocator->memory_props, &compat_params,
+      /*allowed_type_indices=*/requirements.memoryTypeBits,
+      &memory_type_index);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_sparse_buffer_create_unbound(
+        base_allocator, compat_params.type, compat_params.access,
+        compat_params.usage, allocation_size, /*byte_offset=*/0,
+        /*byte_length=*/allocation_size, logical_device, handle, requirements,
+        memory_type_index, page_pool, out_buffer);
+  }
+  if (!iree_status_is_ok(status)) {
+    logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
+                                            logical_device->allocator());
+    return status;
+  }
+
+  iree_hal_allocator_statistics_record_alloc(
+      &allocator->statistics, compat_params.type, allocation_size);
+  return iree_ok_status();
+}
+
 static void iree_hal_vulkan_native_allocator_deallocate_buffer(
     iree_hal_allocator_t* IREE_RESTRICT base_allocator,
     iree_hal_buffer_t* IREE_RESTRICT base_buffer) {
@@ -550,7 +784,7 @@ static void iree_hal_vulkan_native_allocator_deallocate_buffer(
 
 static void iree_hal_vulkan_native_allocator_external_host_buffer_release(
     void* user_data, iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkDeviceMemory device_memory, VkBuffer handle) {
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, VkBuffer handle) {
   if (handle) {
     logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
                                             logical_device->allocator());
@@ -733,7 +967,8 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_host_buffer(
       params->usage, (iree_device_size_t)allocation_size,
       /*byte_offset=*/0,
       /*byte_length=*/external_buffer->size, logical_device, device_memory,
-      handle, internal_release_callback, release_callback, &buffer);
+      memory_offset, /*host_ptr=*/NULL, handle, internal_release_callback,
+      release_callback, &buffer);
   if (!iree_status_is_ok(status)) {
     logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
                                             logical_device->allocator());
@@ -761,7 +996,7 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_host_buffer(
 
 static void iree_hal_vulkan_native_allocator_external_device_buffer_release(
     void* user_data, iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkDeviceMemory device_memory, VkBuffer handle) {
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, VkBuffer handle) {
   // NOTE: device memory is unowned but the buffer handle is ours to clean up.
   if (handle) {
     logical_device->syms()->vkDestroyBuffer(*logical_device, handle,
@@ -819,7 +1054,8 @@ static iree_status_t iree_hal_vulkan_native_allocator_import_device_buffer(
       params->usage, (iree_device_size_t)external_buffer->size,
       /*byte_offset=*/0,
       /*byte_length=*/external_buffer->size, logical_device, device_memory,
-      handle, internal_release_callback, release_callback, out_buffer);
+      /*memory_offset=*/0, /*host_ptr=*/NULL, handle, internal_release_callback,
+      release_callback, out_buffer);
 }
 
 static iree_status_t iree_hal_vulkan_native_allocator_import_buffer(
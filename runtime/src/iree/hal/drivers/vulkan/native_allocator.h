@@ -10,6 +10,7 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
+#include "iree/hal/drivers/vulkan/sparse_buffer.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -23,6 +24,19 @@ iree_status_t iree_hal_vulkan_native_allocator_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
     iree_hal_allocator_t** out_allocator);
 
+// Allocates a sparse buffer with no memory bound that is backed by pages from
+// |page_pool| when bound on a queue. See
+// iree_hal_vulkan_sparse_buffer_queue_bind.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the buffer cannot be sparsely bound (such
+// as when it must be mappable) in which case callers should allocate it with
+// iree_hal_allocator_allocate_buffer instead.
+iree_status_t iree_hal_vulkan_native_allocator_allocate_unbound(
+    iree_hal_allocator_t* allocator, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size,
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    iree_hal_buffer_t** out_buffer);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
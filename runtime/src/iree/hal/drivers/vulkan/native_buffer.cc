@@ -17,6 +17,10 @@
 typedef struct iree_hal_vulkan_native_buffer_t {
   iree_hal_vulkan_base_buffer_t base;
   iree::hal::vulkan::VkDeviceHandle* logical_device;
+  // Offset of the buffer within |base.device_memory|.
+  VkDeviceSize memory_offset;
+  // Optional persistent host-coherent mapping of the buffer at offset 0.
+  uint8_t* host_ptr;
   iree_hal_vulkan_native_buffer_release_callback_t internal_release_callback;
   iree_hal_buffer_release_callback_t user_release_callback;
 } iree_hal_vulkan_native_buffer_t;
@@ -37,7 +41,8 @@ iree_status_t iree_hal_vulkan_native_buffer_wrap(
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkDeviceMemory device_memory, VkBuffer handle,
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, uint8_t* host_ptr,
+    VkBuffer handle,
     iree_hal_vulkan_native_buffer_release_callback_t internal_release_callback,
     iree_hal_buffer_release_callback_t user_release_callback,
     iree_hal_buffer_t** out_buffer) {
@@ -61,6 +66,8 @@ iree_status_t iree_hal_vulkan_native_buffer_wrap(
     buffer->base.device_memory = device_memory;
     buffer->base.handle = handle;
     buffer->logical_device = logical_device;
+    buffer->memory_offset = memory_offset;
+    buffer->host_ptr = host_ptr;
     buffer->internal_release_callback = internal_release_callback;
     buffer->user_release_callback = user_release_callback;
 
@@ -83,7 +90,7 @@ static void iree_hal_vulkan_native_buffer_destroy(
   if (buffer->internal_release_callback.fn) {
     buffer->internal_release_callback.fn(
         buffer->internal_release_callback.user_data, buffer->logical_device,
-        buffer->base.device_memory, buffer->base.handle);
+        buffer->base.device_memory, buffer->memory_offset, buffer->base.handle);
   }
   if (buffer->user_release_callback.fn) {
     buffer->user_release_callback.fn(buffer->user_release_callback.user_data,
@@ -122,12 +129,16 @@ static iree_status_t iree_hal_vulkan_native_buffer_map_range(
   // TODO(benvanik): map VK_WHOLE_SIZE and subset ourselves? may need to get
   // around some minimum mapping alignment rules.
   uint8_t* data_ptr = nullptr;
-  VK_RETURN_IF_ERROR(logical_device->syms()->vkMapMemory(
-                         *logical_device, buffer->base.device_memory,
-                         /*offset=*/local_byte_offset,
-                         /*size=*/local_byte_length,
-                         /*flags=*/0, (void**)&data_ptr),
-                     "vkMapMemory");
+  if (buffer->host_ptr) {
+    data_ptr = buffer->host_ptr + local_byte_offset;
+  } else {
+    VK_RETURN_IF_ERROR(logical_device->syms()->vkMapMemory(
+                           *logical_device, buffer->base.device_memory,
+                           /*offset=*/buffer->memory_offset + local_byte_offset,
+                           /*size=*/local_byte_length,
+                           /*flags=*/0, (void**)&data_ptr),
+                       "vkMapMemory");
+  }
   mapping->contents = iree_make_byte_span(data_ptr, local_byte_length);
 
   // If we mapped for discard scribble over the bytes. This is not a mandated
@@ -153,6 +164,7 @@ static iree_status_t iree_hal_vulkan_native_buffer_unmap_range(
         IREE_STATUS_FAILED_PRECONDITION,
         "buffer does not have device memory attached and cannot be mapped");
   }
+  if (buffer->host_ptr) return iree_ok_status();  // persistently mapped
   auto* logical_device = buffer->logical_device;
   logical_device->syms()->vkUnmapMemory(*logical_device,
                                         buffer->base.device_memory);
@@ -169,12 +181,13 @@ static iree_status_t iree_hal_vulkan_native_buffer_invalidate_range(
         IREE_STATUS_FAILED_PRECONDITION,
         "buffer does not have device memory attached and cannot be mapped");
   }
+  if (buffer->host_ptr) return iree_ok_status();  // host-coherent
   auto* logical_device = buffer->logical_device;
   VkMappedMemoryRange range;
   range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
   range.pNext = NULL;
   range.memory = buffer->base.device_memory;
-  range.offset = local_byte_offset;
+  range.offset = buffer->memory_offset + local_byte_offset;
   range.size = local_byte_length;
   VK_RETURN_IF_ERROR(logical_device->syms()->vkInvalidateMappedMemoryRanges(
                          *logical_device, 1, &range),
@@ -192,12 +205,13 @@ static iree_status_t iree_hal_vulkan_native_buffer_flush_range(
         IREE_STATUS_FAILED_PRECONDITION,
         "buffer does not have device memory attached and cannot be mapped");
   }
+  if (buffer->host_ptr) return iree_ok_status();  // host-coherent
   auto* logical_device = buffer->logical_device;
   VkMappedMemoryRange range;
   range.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
   range.pNext = NULL;
   range.memory = buffer->base.device_memory;
-  range.offset = local_byte_offset;
+  range.offset = buffer->memory_offset + local_byte_offset;
   range.size = local_byte_length;
   VK_RETURN_IF_ERROR(logical_device->syms()->vkFlushMappedMemoryRanges(
                          *logical_device, 1, &range),
@@ -21,7 +21,7 @@ extern "C" {
 
 typedef void(IREE_API_PTR* iree_hal_vulkan_native_buffer_release_fn_t)(
     void* user_data, iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkDeviceMemory device_memory, VkBuffer handle);
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, VkBuffer handle);
 
 // A callback issued when a buffer is released.
 typedef struct {
@@ -31,16 +31,21 @@ typedef struct {
   void* user_data;
 } iree_hal_vulkan_native_buffer_release_callback_t;
 
-// Wraps a Vulkan |buffer| bound to device |device_memory| for exposure into the
-// HAL. The provided callback is made when the buffer is destroyed to allow the
-// caller to clean up as appropriate.
+// Wraps a Vulkan |buffer| bound to device |device_memory| at |memory_offset|
+// for exposure into the HAL. The provided callback is made when the buffer is
+// destroyed to allow the caller to clean up as appropriate.
+//
+// If |host_ptr| is provided it is a persistent host-coherent mapping of the
+// buffer contents owned by the caller and used for all mappings of the buffer
+// instead of mapping |device_memory|.
 iree_status_t iree_hal_vulkan_native_buffer_wrap(
     iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
     iree_hal_memory_access_t allowed_access,
     iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
     iree_device_size_t byte_offset, iree_device_size_t byte_length,
     iree::hal::vulkan::VkDeviceHandle* logical_device,
-    VkDeviceMemory device_memory, VkBuffer handle,
+    VkDeviceMemory device_memory, VkDeviceSize memory_offset, uint8_t* host_ptr,
+    VkBuffer handle,
     iree_hal_vulkan_native_buffer_release_callback_t internal_release_callback,
     iree_hal_buffer_release_callback_t user_release_callback,
     iree_hal_buffer_t** out_buffer);
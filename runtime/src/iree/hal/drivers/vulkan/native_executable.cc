@@ -121,6 +121,9 @@ static iree_status_t iree_hal_vulkan_create_pipelines(
     } else {
       create_info->flags |= VK_PIPELINE_CREATE_DERIVATIVE_BIT;
     }
+    if (logical_device->enabled_extensions().descriptor_buffer) {
+      create_info->flags |= VK_PIPELINE_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+    }
     create_info->layout = iree_hal_vulkan_native_pipeline_layout_handle(
         executable_params->pipeline_layouts[entry_ordinal]);
     create_info->basePipelineHandle = VK_NULL_HANDLE;
@@ -26,6 +26,15 @@ typedef struct iree_hal_vulkan_native_descriptor_set_layout_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
   VkDescriptorSetLayout handle;
+  // Total size of the layout in a descriptor buffer, if they are in use.
+  VkDeviceSize buffer_size;
+  // Binding ordinals and their offsets in a descriptor buffer, if they are in
+  // use. Bindings are few so these are scanned linearly.
+  iree_host_size_t binding_count;
+  struct {
+    uint32_t binding;
+    VkDeviceSize offset;
+  } binding_offsets[];
 } iree_hal_vulkan_native_descriptor_set_layout_t;
 
 namespace {
@@ -53,6 +62,12 @@ static iree_status_t iree_hal_vulkan_create_descriptor_set_layout(
   create_info.flags = 0;
 
   VkDescriptorSetLayoutBinding* native_bindings = NULL;
+  if (logical_device->enabled_extensions().descriptor_buffer) {
+    // All set layouts used with a pipeline bound to descriptor buffers must
+    // have this flag, including the empty ones used by builtin executables.
+    create_info.flags |=
+        VK_DESCRIPTOR_SET_LAYOUT_CREATE_DESCRIPTOR_BUFFER_BIT_EXT;
+  }
   if (binding_count > 0) {
     if (logical_device->enabled_extensions().push_descriptors) {
       // Note that we can *only* use push descriptor sets if we set this create
@@ -118,15 +133,35 @@ iree_status_t iree_hal_vulkan_native_descriptor_set_layout_create(
               logical_device, flags, binding_count, bindings, &handle));
 
   iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout = NULL;
-  iree_status_t status = iree_allocator_malloc(logical_device->host_allocator(),
-                                               sizeof(*descriptor_set_layout),
-                                               (void**)&descriptor_set_layout);
+  iree_status_t status = iree_allocator_malloc(
+      logical_device->host_allocator(),
+      sizeof(*descriptor_set_layout) +
+          binding_count * sizeof(descriptor_set_layout->binding_offsets[0]),
+      (void**)&descriptor_set_layout);
   if (iree_status_is_ok(status)) {
     iree_hal_resource_initialize(
         &iree_hal_vulkan_native_descriptor_set_layout_vtable,
         &descriptor_set_layout->resource);
     descriptor_set_layout->logical_device = logical_device;
     descriptor_set_layout->handle = handle;
+    descriptor_set_layout->buffer_size = 0;
+    descriptor_set_layout->binding_count = binding_count;
+    for (iree_host_size_t i = 0; i < binding_count; ++i) {
+      descriptor_set_layout->binding_offsets[i].binding = bindings[i].binding;
+      descriptor_set_layout->binding_offsets[i].offset = 0;
+    }
+    if (logical_device->enabled_extensions().descriptor_buffer) {
+      // Query the layout of the set within descriptor buffers once here so
+      // that writing descriptors during recording needs no additional calls.
+      const auto& syms = logical_device->syms();
+      syms->vkGetDescriptorSetLayoutSizeEXT(
+          *logical_device, handle, &descriptor_set_layout->buffer_size);
+      for (iree_host_size_t i = 0; i < binding_count; ++i) {
+        syms->vkGetDescriptorSetLayoutBindingOffsetEXT(
+            *logical_device, handle, bindings[i].binding,
+            &descriptor_set_layout->binding_offsets[i].offset);
+      }
+    }
     *out_descriptor_set_layout =
         (iree_hal_descriptor_set_layout_t*)descriptor_set_layout;
   } else {
@@ -161,6 +196,29 @@ VkDescriptorSetLayout iree_hal_vulkan_native_descriptor_set_layout_handle(
   return descriptor_set_layout->handle;
 }
 
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_buffer_size(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout) {
+  iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_vulkan_native_descriptor_set_layout_cast(
+          base_descriptor_set_layout);
+  return descriptor_set_layout->buffer_size;
+}
+
+VkDeviceSize iree_hal_vulkan_native_descriptor_set_layout_binding_offset(
+    iree_hal_descriptor_set_layout_t* base_descriptor_set_layout,
+    uint32_t binding) {
+  iree_hal_vulkan_native_descriptor_set_layout_t* descriptor_set_layout =
+      iree_hal_vulkan_native_descriptor_set_layout_cast(
+          base_descriptor_set_layout);
+  for (iree_host_size_t i = 0; i < descriptor_set_layout->binding_count; ++i) {
+    if (descriptor_set_layout->binding_offsets[i].binding == binding) {
+      return descriptor_set_layout->binding_offsets[i].offset;
+    }
+  }
+  IREE_ASSERT_UNREACHABLE("binding not declared by the set layout");
+  return 0;
+}
+
 namespace {
 const iree_hal_descriptor_set_layout_vtable_t
     iree_hal_vulkan_native_descriptor_set_layout_vtable = {
@@ -7,16 +7,27 @@
 #include "iree/hal/drivers/vulkan/nop_executable_cache.h"
 
 #include <cstddef>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/hal/drivers/vulkan/dynamic_symbol_tables.h"
 #include "iree/hal/drivers/vulkan/native_executable.h"
+#include "iree/hal/drivers/vulkan/status_util.h"
 
 using namespace iree::hal::vulkan;
 
 typedef struct iree_hal_vulkan_nop_executable_cache_t {
   iree_hal_resource_t resource;
   VkDeviceHandle* logical_device;
+
+  // Optional persistent cache for VkPipelineCache data.
+  iree_hal_executable_disk_cache_t* disk_cache;
+  // Key identifying the device and driver that all entry keys start with.
+  iree_hal_executable_disk_cache_key_t disk_cache_key;
+
+  // Optional pipeline cache shared across the device used when executables
+  // are not persisted in |disk_cache|. Not owned.
+  VkPipelineCache pipeline_cache;
 } iree_hal_vulkan_nop_executable_cache_t;
 
 namespace {
@@ -32,9 +43,34 @@ iree_hal_vulkan_nop_executable_cache_cast(
   return (iree_hal_vulkan_nop_executable_cache_t*)base_value;
 }
 
+// Initializes |out_key| with the identity of the physical device and driver.
+// Implementations ignore pipeline cache data that does not match their
+// pipelineCacheUUID but keying on it avoids loading data that would be dropped.
+static void iree_hal_vulkan_nop_executable_cache_initialize_key(
+    VkDeviceHandle* logical_device,
+    iree_hal_executable_disk_cache_key_t* out_key) {
+  VkPhysicalDeviceProperties properties;
+  logical_device->syms()->vkGetPhysicalDeviceProperties(
+      logical_device->physical_device(), &properties);
+  const uint32_t identity[3] = {
+      properties.vendorID,
+      properties.deviceID,
+      properties.driverVersion,
+  };
+  iree_hal_executable_disk_cache_key_initialize(out_key);
+  iree_hal_executable_disk_cache_key_append_string(out_key, IREE_SV("vulkan"));
+  iree_hal_executable_disk_cache_key_append(
+      out_key, iree_make_const_byte_span(identity, sizeof(identity)));
+  iree_hal_executable_disk_cache_key_append(
+      out_key, iree_make_const_byte_span(properties.pipelineCacheUUID,
+                                         sizeof(properties.pipelineCacheUUID)));
+}
+
 iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
     iree_string_view_t identifier,
+    iree_hal_executable_disk_cache_t* disk_cache,
+    VkPipelineCache pipeline_cache,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(out_executable_cache);
   *out_executable_cache = NULL;
@@ -48,6 +84,13 @@ iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree_hal_resource_initialize(&iree_hal_vulkan_nop_executable_cache_vtable,
                                  &executable_cache->resource);
     executable_cache->logical_device = logical_device;
+    executable_cache->disk_cache = disk_cache;
+    iree_hal_executable_disk_cache_retain(disk_cache);
+    executable_cache->pipeline_cache = pipeline_cache;
+    if (disk_cache) {
+      iree_hal_vulkan_nop_executable_cache_initialize_key(
+          logical_device, &executable_cache->disk_cache_key);
+    }
 
     *out_executable_cache = (iree_hal_executable_cache_t*)executable_cache;
   }
@@ -64,6 +107,7 @@ static void iree_hal_vulkan_nop_executable_cache_destroy(
       executable_cache->logical_device->host_allocator();
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_hal_executable_disk_cache_release(executable_cache->disk_cache);
   iree_allocator_free(host_allocator, executable_cache);
 
   IREE_TRACE_ZONE_END(z0);
@@ -88,6 +132,105 @@ static bool iree_hal_vulkan_nop_executable_cache_can_prepare_format(
   return false;
 }
 
+// Stores the contents of |pipeline_cache| in the disk cache under |key|.
+// Storing is best-effort: failures only mean pipelines are compiled again the
+// next time the executable is prepared.
+static void iree_hal_vulkan_nop_executable_cache_store_pipeline_cache(
+    iree_hal_vulkan_nop_executable_cache_t* executable_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    VkPipelineCache pipeline_cache) {
+  VkDeviceHandle* logical_device = executable_cache->logical_device;
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  size_t data_size = 0;
+  iree_status_t status =
+      VK_RESULT_TO_STATUS(logical_device->syms()->vkGetPipelineCacheData(
+                              *logical_device, pipeline_cache, &data_size,
+                              /*pData=*/NULL),
+                          "vkGetPipelineCacheData");
+  void* data = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(host_allocator, data_size, &data);
+  }
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkGetPipelineCacheData(
+            *logical_device, pipeline_cache, &data_size, data),
+        "vkGetPipelineCacheData");
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_executable_disk_cache_store(
+        executable_cache->disk_cache, key,
+        iree_make_const_byte_span(data, data_size));
+  }
+  iree_allocator_free(host_allocator, data);
+  iree_status_ignore(status);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Prepares an executable using pipeline cache data persisted on disk.
+static iree_status_t iree_hal_vulkan_nop_executable_cache_prepare_persistent(
+    iree_hal_vulkan_nop_executable_cache_t* executable_cache,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executable) {
+  VkDeviceHandle* logical_device = executable_cache->logical_device;
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Specialization constants are baked into the pipelines and must be part of
+  // the key along with the SPIR-V.
+  iree_hal_executable_disk_cache_key_t key = executable_cache->disk_cache_key;
+  iree_hal_executable_disk_cache_key_append_string(
+      &key, executable_params->executable_format);
+  iree_hal_executable_disk_cache_key_append(
+      &key, executable_params->executable_data);
+  iree_hal_executable_disk_cache_key_append(
+      &key, iree_make_const_byte_span(
+                executable_params->constants,
+                executable_params->constant_count * sizeof(uint32_t)));
+
+  iree_byte_span_t initial_data = iree_make_byte_span(NULL, 0);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_disk_cache_lookup(executable_cache->disk_cache,
+                                                &key, host_allocator,
+                                                &initial_data));
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, initial_data.data ? "hit" : "miss");
+
+  // Implementations are required to ignore initial data that is incompatible.
+  VkPipelineCacheCreateInfo create_info;
+  memset(&create_info, 0, sizeof(create_info));
+  create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  create_info.initialDataSize = initial_data.data_length;
+  create_info.pInitialData = initial_data.data;
+  VkPipelineCache pipeline_cache = VK_NULL_HANDLE;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkCreatePipelineCache(
+          *logical_device, &create_info, logical_device->allocator(),
+          &pipeline_cache),
+      "vkCreatePipelineCache");
+  const bool was_hit = initial_data.data != NULL;
+  iree_allocator_free(host_allocator, initial_data.data);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_native_executable_create(
+        logical_device, pipeline_cache, executable_params, out_executable);
+  }
+  if (iree_status_is_ok(status) && !was_hit) {
+    iree_hal_vulkan_nop_executable_cache_store_pipeline_cache(
+        executable_cache, &key, pipeline_cache);
+  }
+
+  if (pipeline_cache != VK_NULL_HANDLE) {
+    logical_device->syms()->vkDestroyPipelineCache(
+        *logical_device, pipeline_cache, logical_device->allocator());
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_hal_vulkan_nop_executable_cache_prepare_executable(
     iree_hal_executable_cache_t* base_executable_cache,
     const iree_hal_executable_params_t* executable_params,
@@ -103,9 +246,16 @@ static iree_status_t iree_hal_vulkan_nop_executable_cache_prepare_executable(
   }
   iree_hal_vulkan_nop_executable_cache_t* executable_cache =
       iree_hal_vulkan_nop_executable_cache_cast(base_executable_cache);
+  if (executable_cache->disk_cache &&
+      iree_all_bits_set(
+          executable_params->caching_mode,
+          IREE_HAL_EXECUTABLE_CACHING_MODE_ALLOW_PERSISTENT_CACHING)) {
+    return iree_hal_vulkan_nop_executable_cache_prepare_persistent(
+        executable_cache, executable_params, out_executable);
+  }
   return iree_hal_vulkan_native_executable_create(
-      executable_cache->logical_device,
-      /*pipeline_cache=*/VK_NULL_HANDLE, executable_params, out_executable);
+      executable_cache->logical_device, executable_cache->pipeline_cache,
+      executable_params, out_executable);
 }
 
 namespace {
@@ -10,17 +10,23 @@
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
+#include "iree/hal/utils/executable_disk_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif  // __cplusplus
 
-// Creates a no-op executable cache that does not cache at all.
+// Creates an executable cache that does not cache in memory.
 // This is useful to isolate pipeline caching behavior and verify compilation
-// behavior.
+// behavior. If an optional |disk_cache| is provided then pipeline cache data
+// is persisted there when executables allow persistent caching. Otherwise
+// pipelines are created with the optional device-wide |pipeline_cache|, which
+// must remain valid for the lifetime of the executable cache.
 iree_status_t iree_hal_vulkan_nop_executable_cache_create(
     iree::hal::vulkan::VkDeviceHandle* logical_device,
     iree_string_view_t identifier,
+    iree_hal_executable_disk_cache_t* disk_cache,
+    VkPipelineCache pipeline_cache,
     iree_hal_executable_cache_t** out_executable_cache);
 
 #ifdef __cplusplus
@@ -0,0 +1,156 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/drivers/vulkan/pipeline_cache.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/hal/drivers/vulkan/dynamic_symbol_tables.h"
+#include "iree/hal/drivers/vulkan/status_util.h"
+
+using namespace iree::hal::vulkan;
+
+// Returns true if |data| begins with a pipeline cache header produced by the
+// physical device of |logical_device|. Implementations are required to ignore
+// incompatible data but some drivers have been known to crash on it.
+static bool iree_hal_vulkan_pipeline_cache_is_compatible(
+    VkDeviceHandle* logical_device, iree_const_byte_span_t data) {
+  VkPipelineCacheHeaderVersionOne header;
+  if (data.data_length < sizeof(header)) return false;
+  memcpy(&header, data.data, sizeof(header));
+  if (header.headerSize < sizeof(header) ||
+      header.headerSize > data.data_length ||
+      header.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE) {
+    return false;
+  }
+  VkPhysicalDeviceProperties properties;
+  logical_device->syms()->vkGetPhysicalDeviceProperties(
+      logical_device->physical_device(), &properties);
+  return header.vendorID == properties.vendorID &&
+         header.deviceID == properties.deviceID &&
+         memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID,
+                sizeof(header.pipelineCacheUUID)) == 0;
+}
+
+iree_status_t iree_hal_vulkan_pipeline_cache_load(
+    VkDeviceHandle* logical_device, const char* path,
+    VkPipelineCache* out_pipeline_cache, size_t* out_data_size) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(out_pipeline_cache);
+  IREE_ASSERT_ARGUMENT(out_data_size);
+  *out_pipeline_cache = VK_NULL_HANDLE;
+  *out_data_size = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Any failure to read the file is treated as an empty cache.
+  iree_file_contents_t* contents = NULL;
+  iree_const_byte_span_t initial_data = iree_const_byte_span_empty();
+#if IREE_FILE_IO_ENABLE
+  iree_status_t read_status = iree_file_read_contents(
+      path, IREE_FILE_READ_FLAG_DEFAULT, logical_device->host_allocator(),
+      &contents);
+  if (iree_status_is_ok(read_status) &&
+      iree_hal_vulkan_pipeline_cache_is_compatible(logical_device,
+                                                   contents->const_buffer)) {
+    initial_data = contents->const_buffer;
+  }
+  iree_status_ignore(read_status);
+#endif  // IREE_FILE_IO_ENABLE
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, initial_data.data ? "hit" : "miss");
+
+  VkPipelineCacheCreateInfo create_info;
+  memset(&create_info, 0, sizeof(create_info));
+  create_info.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  create_info.initialDataSize = initial_data.data_length;
+  create_info.pInitialData = initial_data.data;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkCreatePipelineCache(
+          *logical_device, &create_info, logical_device->allocator(),
+          out_pipeline_cache),
+      "vkCreatePipelineCache");
+  if (iree_status_is_ok(status)) {
+    *out_data_size = initial_data.data_length;
+  }
+  iree_file_contents_free(contents);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_vulkan_pipeline_cache_save(
+    VkDeviceHandle* logical_device, const char* path,
+    VkPipelineCache pipeline_cache, size_t* inout_data_size) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_ASSERT_ARGUMENT(inout_data_size);
+#if IREE_FILE_IO_ENABLE
+  iree_allocator_t host_allocator = logical_device->host_allocator();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Pipeline caches only grow as pipelines are added so an unchanged size
+  // means there is nothing new to persist.
+  size_t data_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, VK_RESULT_TO_STATUS(logical_device->syms()->vkGetPipelineCacheData(
+                                  *logical_device, pipeline_cache, &data_size,
+                                  /*pData=*/NULL),
+                              "vkGetPipelineCacheData"));
+  if (data_size == *inout_data_size) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  void* data = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(host_allocator, data_size, &data);
+  if (iree_status_is_ok(status)) {
+    status = VK_RESULT_TO_STATUS(
+        logical_device->syms()->vkGetPipelineCacheData(
+            *logical_device, pipeline_cache, &data_size, data),
+        "vkGetPipelineCacheData");
+  }
+
+  // Write to a temporary file and move it into place so that other processes
+  // loading the cache never observe a partially written file.
+  char temp_path[1024];
+  if (iree_status_is_ok(status)) {
+    int length = snprintf(temp_path, sizeof(temp_path), "%s.tmp", path);
+    if (length < 0 || (size_t)length >= sizeof(temp_path)) {
+      status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                "pipeline cache path too long");
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_file_write_contents(
+        temp_path, iree_make_const_byte_span(data, data_size));
+  }
+  if (iree_status_is_ok(status) && rename(temp_path, path) != 0) {
+    // Windows does not replace existing files on rename.
+    remove(path);
+    if (rename(temp_path, path) != 0) {
+      int error_number = errno;
+      remove(temp_path);
+      status = iree_make_status(iree_status_code_from_errno(error_number),
+                                "failed to move pipeline cache into place at "
+                                "'%s'",
+                                path);
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    *inout_data_size = data_size;
+  }
+  iree_allocator_free(host_allocator, data);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_ok_status();
+#endif  // IREE_FILE_IO_ENABLE
+}
@@ -0,0 +1,37 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_DRIVERS_VULKAN_PIPELINE_CACHE_H_
+#define IREE_HAL_DRIVERS_VULKAN_PIPELINE_CACHE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/drivers/vulkan/handle_util.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a VkPipelineCache seeded with the contents of the file at |path|.
+// The file is ignored if it does not exist, cannot be read, or was produced
+// by a different device or driver as identified by its pipeline cache header.
+// |out_data_size| receives the size of the data loaded, if any, so that
+// callers can skip writing back unchanged caches.
+iree_status_t iree_hal_vulkan_pipeline_cache_load(
+    iree::hal::vulkan::VkDeviceHandle* logical_device, const char* path,
+    VkPipelineCache* out_pipeline_cache, size_t* out_data_size);
+
+// Writes the contents of |pipeline_cache| to the file at |path| if they differ
+// in size from |*inout_data_size| and updates it on success. The file is
+// replaced atomically so that concurrent readers never observe partial data.
+iree_status_t iree_hal_vulkan_pipeline_cache_save(
+    iree::hal::vulkan::VkDeviceHandle* logical_device, const char* path,
+    VkPipelineCache pipeline_cache, size_t* inout_data_size);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_DRIVERS_VULKAN_PIPELINE_CACHE_H_
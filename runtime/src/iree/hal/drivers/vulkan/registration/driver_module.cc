@@ -8,6 +8,7 @@
 
 #include <cinttypes>
 #include <cstddef>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
@@ -41,10 +42,28 @@ IREE_FLAG(bool, vulkan_sparse_residency, true,
 IREE_FLAG(bool, vulkan_buffer_device_addresses, true,
           "Enables the Vulkan 'bufferDeviceAddress` feature and support for "
           "SPIR-V executables compiled to use it.");
+IREE_FLAG(bool, vulkan_descriptor_buffers, true,
+          "Enables the Vulkan 'descriptorBuffer' feature and writes descriptor "
+          "sets into descriptor buffers when push descriptors are "
+          "unavailable.");
 
 IREE_FLAG(
     bool, vulkan_dedicated_compute_queue, false,
     "Use a dedicated queue with VK_QUEUE_COMPUTE_BIT for dispatch workloads.");
+IREE_FLAG(
+    bool, vulkan_unified_memory, false,
+    "Allocate device-local buffers from host-visible coherent memory on\n"
+    "integrated GPUs so that host transfers avoid staging copies.");
+
+IREE_FLAG(
+    string, vulkan_executable_cache, "",
+    "Directory used to persist pipeline cache data across runs.\n"
+    "The directory must exist and be writable only by trusted users.");
+IREE_FLAG(
+    string, vulkan_pipeline_cache, "",
+    "File used to persist the device pipeline cache across runs.\n"
+    "Loaded when devices are created and written back when they are trimmed\n"
+    "or destroyed.");
 
 static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     iree_string_view_t identifier, iree_allocator_t host_allocator,
@@ -94,11 +113,19 @@ static iree_status_t iree_hal_vulkan_create_driver_with_flags(
     driver_options.requested_features |=
         IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES;
   }
+  if (FLAG_vulkan_descriptor_buffers) {
+    driver_options.requested_features |=
+        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS;
+  }
 
   if (FLAG_vulkan_dedicated_compute_queue) {
     driver_options.device_options.flags |=
         IREE_HAL_VULKAN_DEVICE_FLAG_DEDICATED_COMPUTE_QUEUE;
   }
+  if (FLAG_vulkan_unified_memory) {
+    driver_options.device_options.flags |=
+        IREE_HAL_VULKAN_DEVICE_FLAG_UNIFIED_MEMORY;
+  }
 
   // Load the Vulkan library. This will fail if the library cannot be found or
   // does not have the expected functions.
@@ -106,9 +133,24 @@ static iree_status_t iree_hal_vulkan_create_driver_with_flags(
   IREE_RETURN_IF_ERROR(
       iree_hal_vulkan_syms_create_from_system_loader(host_allocator, &syms));
 
-  iree_status_t status = iree_hal_vulkan_driver_create(
-      identifier, &driver_options, syms, host_allocator, out_driver);
+  driver_options.device_options.pipeline_cache_path =
+      iree_make_cstring_view(FLAG_vulkan_pipeline_cache);
+
+  iree_status_t status = iree_ok_status();
+  if (strlen(FLAG_vulkan_executable_cache) > 0) {
+    status = iree_hal_executable_disk_cache_create(
+        iree_make_cstring_view(FLAG_vulkan_executable_cache), host_allocator,
+        &driver_options.device_options.executable_disk_cache);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_driver_create(identifier, &driver_options, syms,
+                                           host_allocator, out_driver);
+  }
 
+  // Retained by the driver.
+  iree_hal_executable_disk_cache_release(
+      driver_options.device_options.executable_disk_cache);
   iree_hal_vulkan_syms_release(syms);
   return status;
 }
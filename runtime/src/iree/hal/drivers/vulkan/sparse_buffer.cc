@@ -11,12 +11,336 @@
 #include <cstring>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/drivers/vulkan/base_buffer.h"
+#include "iree/hal/drivers/vulkan/native_semaphore.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 
+using namespace iree::hal::vulkan;
+
+//===----------------------------------------------------------------------===//
+// iree_hal_vulkan_sparse_page_pool_t
+//===----------------------------------------------------------------------===//
+
+// Size of the device memory chunks pages are carved out of.
+#define IREE_HAL_VULKAN_SPARSE_PAGE_CHUNK_SIZE (32 * 1024 * 1024)
+
+// A device memory allocation divided into pages.
+typedef struct iree_hal_vulkan_sparse_page_chunk_t {
+  struct iree_hal_vulkan_sparse_page_chunk_t* next;
+  VkDeviceMemory device_memory;
+  uint32_t memory_type_index;
+  // Total number of pages in the chunk and the number in the free list.
+  iree_host_size_t page_count;
+  iree_host_size_t free_page_count;
+  // Largest timeline value any page of the chunk was released with.
+  uint64_t last_release_value;
+} iree_hal_vulkan_sparse_page_chunk_t;
+
+// A single page of a chunk.
+typedef struct iree_hal_vulkan_sparse_page_t {
+  iree_hal_vulkan_sparse_page_chunk_t* chunk;
+  VkDeviceSize memory_offset;
+  // Pool timeline value after which the page is no longer bound to the buffer
+  // it was released from. 0 if never bound.
+  uint64_t release_value;
+} iree_hal_vulkan_sparse_page_t;
+
+// Pages of a single memory type available to be bound.
+typedef struct iree_hal_vulkan_sparse_page_list_t {
+  iree_host_size_t count;
+  iree_host_size_t capacity;
+  iree_hal_vulkan_sparse_page_t* pages;
+} iree_hal_vulkan_sparse_page_list_t;
+
+struct iree_hal_vulkan_sparse_page_pool_t {
+  VkDeviceHandle* logical_device;
+  iree_allocator_t host_allocator;
+
+  // Timeline signaled by unbind operations as they complete.
+  VkSemaphore timeline;
+
+  iree_slim_mutex_t mutex;
+  // Size of each page; assigned from the sparse block size of the first buffer
+  // created against the pool.
+  VkDeviceSize page_size IREE_GUARDED_BY(mutex);
+  // Last value of |timeline| any operation was submitted to signal. Submission
+  // of unbinds happens under the lock so values are signaled in order.
+  uint64_t timeline_value IREE_GUARDED_BY(mutex);
+  // All chunks allocated from the device.
+  iree_hal_vulkan_sparse_page_chunk_t* chunks IREE_GUARDED_BY(mutex);
+  // Free pages for each memory type; most recently released pages are last.
+  iree_hal_vulkan_sparse_page_list_t free_lists[VK_MAX_MEMORY_TYPES]
+      IREE_GUARDED_BY(mutex);
+};
+
+iree_status_t iree_hal_vulkan_sparse_page_pool_create(
+    VkDeviceHandle* logical_device, iree_allocator_t host_allocator,
+    iree_hal_vulkan_sparse_page_pool_t** out_page_pool) {
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(out_page_pool);
+  *out_page_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_vulkan_sparse_page_pool_t* page_pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*page_pool),
+                                (void**)&page_pool));
+  page_pool->logical_device = logical_device;
+  page_pool->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&page_pool->mutex);
+
+  VkSemaphoreTypeCreateInfo timeline_create_info;
+  timeline_create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+  timeline_create_info.pNext = NULL;
+  timeline_create_info.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+  timeline_create_info.initialValue = 0;
+  VkSemaphoreCreateInfo create_info;
+  create_info.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+  create_info.pNext = &timeline_create_info;
+  create_info.flags = 0;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkCreateSemaphore(*logical_device, &create_info,
+                                                logical_device->allocator(),
+                                                &page_pool->timeline),
+      "vkCreateSemaphore");
+
+  if (iree_status_is_ok(status)) {
+    *out_page_pool = page_pool;
+  } else {
+    iree_hal_vulkan_sparse_page_pool_free(page_pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_hal_vulkan_sparse_page_chunk_free(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    iree_hal_vulkan_sparse_page_chunk_t* chunk) {
+  VkDeviceHandle* logical_device = page_pool->logical_device;
+  logical_device->syms()->vkFreeMemory(*logical_device, chunk->device_memory,
+                                       logical_device->allocator());
+  iree_allocator_free(page_pool->host_allocator, chunk);
+}
+
+void iree_hal_vulkan_sparse_page_pool_free(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool) {
+  if (!page_pool) return;
+  VkDeviceHandle* logical_device = page_pool->logical_device;
+  iree_allocator_t host_allocator = page_pool->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_vulkan_sparse_page_chunk_t* chunk = page_pool->chunks;
+  while (chunk) {
+    iree_hal_vulkan_sparse_page_chunk_t* next = chunk->next;
+    IREE_ASSERT_EQ(chunk->free_page_count, chunk->page_count,
+                   "all pages must be released");
+    iree_hal_vulkan_sparse_page_chunk_free(page_pool, chunk);
+    chunk = next;
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(page_pool->free_lists);
+       ++i) {
+    iree_allocator_free(host_allocator, page_pool->free_lists[i].pages);
+  }
+  if (page_pool->timeline != VK_NULL_HANDLE) {
+    logical_device->syms()->vkDestroySemaphore(
+        *logical_device, page_pool->timeline, logical_device->allocator());
+  }
+  iree_slim_mutex_deinitialize(&page_pool->mutex);
+  iree_allocator_free(host_allocator, page_pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns the timeline value all submitted unbinds have reached.
+static uint64_t iree_hal_vulkan_sparse_page_pool_query_timeline(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool) {
+  VkDeviceHandle* logical_device = page_pool->logical_device;
+  uint64_t value = 0;
+  if (logical_device->syms()->vkGetSemaphoreCounterValue(
+          *logical_device, page_pool->timeline, &value) != VK_SUCCESS) {
+    return 0;
+  }
+  return value;
+}
+
+void iree_hal_vulkan_sparse_page_pool_trim(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&page_pool->mutex);
+
+  // Chunks can be freed once all of their pages are back in the pool and no
+  // longer bound to any buffer by an in-flight unbind. Pages of freeable
+  // chunks are dropped from the free lists by marking the chunks with an
+  // empty page count before compacting.
+  uint64_t completed_value =
+      iree_hal_vulkan_sparse_page_pool_query_timeline(page_pool);
+  bool any_freeable = false;
+  for (iree_hal_vulkan_sparse_page_chunk_t* chunk = page_pool->chunks; chunk;
+       chunk = chunk->next) {
+    if (chunk->free_page_count == chunk->page_count &&
+        chunk->last_release_value <= completed_value) {
+      chunk->page_count = 0;
+      any_freeable = true;
+    }
+  }
+  if (any_freeable) {
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(page_pool->free_lists);
+         ++i) {
+      iree_hal_vulkan_sparse_page_list_t* list = &page_pool->free_lists[i];
+      iree_host_size_t count = 0;
+      for (iree_host_size_t j = 0; j < list->count; ++j) {
+        if (list->pages[j].chunk->page_count == 0) continue;
+        list->pages[count++] = list->pages[j];
+      }
+      list->count = count;
+    }
+    iree_hal_vulkan_sparse_page_chunk_t** link = &page_pool->chunks;
+    while (*link) {
+      iree_hal_vulkan_sparse_page_chunk_t* chunk = *link;
+      if (chunk->page_count == 0) {
+        *link = chunk->next;
+        iree_hal_vulkan_sparse_page_chunk_free(page_pool, chunk);
+      } else {
+        link = &chunk->next;
+      }
+    }
+  }
+
+  iree_slim_mutex_unlock(&page_pool->mutex);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Reserves capacity for |count| additional pages in |list|.
+static iree_status_t iree_hal_vulkan_sparse_page_list_reserve(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    iree_hal_vulkan_sparse_page_list_t* list, iree_host_size_t count) {
+  if (list->count + count <= list->capacity) return iree_ok_status();
+  iree_host_size_t new_capacity = iree_max(list->capacity * 2, 64);
+  while (new_capacity < list->count + count) new_capacity *= 2;
+  IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+      page_pool->host_allocator, new_capacity * sizeof(list->pages[0]),
+      (void**)&list->pages));
+  list->capacity = new_capacity;
+  return iree_ok_status();
+}
+
+// Allocates a new chunk of |memory_type_index| and adds its pages to the free
+// list. Must be called with the pool lock held.
+static iree_status_t iree_hal_vulkan_sparse_page_pool_grow(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    uint32_t memory_type_index) {
+  VkDeviceHandle* logical_device = page_pool->logical_device;
+  iree_hal_vulkan_sparse_page_list_t* list =
+      &page_pool->free_lists[memory_type_index];
+  iree_host_size_t page_count = (iree_host_size_t)iree_max(
+      IREE_HAL_VULKAN_SPARSE_PAGE_CHUNK_SIZE / page_pool->page_size, 1);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)page_count);
+
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_vulkan_sparse_page_list_reserve(page_pool, list,
+                                                   page_count));
+  iree_hal_vulkan_sparse_page_chunk_t* chunk = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(page_pool->host_allocator, sizeof(*chunk),
+                                (void**)&chunk));
+  chunk->memory_type_index = memory_type_index;
+  chunk->page_count = page_count;
+
+  VkMemoryAllocateInfo allocate_info;
+  allocate_info.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocate_info.pNext = NULL;
+  allocate_info.allocationSize = page_count * page_pool->page_size;
+  allocate_info.memoryTypeIndex = memory_type_index;
+  iree_status_t status = VK_RESULT_TO_STATUS(
+      logical_device->syms()->vkAllocateMemory(*logical_device, &allocate_info,
+                                               logical_device->allocator(),
+                                               &chunk->device_memory),
+      "vkAllocateMemory");
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(page_pool->host_allocator, chunk);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  // Pages are popped from the end of the list so add them in reverse to have
+  // buffers bound to ascending contiguous ranges that coalesce into fewer
+  // binds.
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    iree_hal_vulkan_sparse_page_t* page = &list->pages[list->count++];
+    page->chunk = chunk;
+    page->memory_offset = (page_count - i - 1) * page_pool->page_size;
+    page->release_value = 0;
+  }
+  chunk->free_page_count = page_count;
+  chunk->next = page_pool->chunks;
+  page_pool->chunks = chunk;
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Acquires |page_count| pages of |memory_type_index| into |out_pages|.
+// |out_wait_value| is set to the pool timeline value that must be waited on
+// before the pages can be bound. Must be called with the pool lock held.
+static iree_status_t iree_hal_vulkan_sparse_page_pool_acquire(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool, uint32_t memory_type_index,
+    iree_host_size_t page_count, iree_hal_vulkan_sparse_page_t* out_pages,
+    uint64_t* out_wait_value) {
+  *out_wait_value = 0;
+  iree_hal_vulkan_sparse_page_list_t* list =
+      &page_pool->free_lists[memory_type_index];
+  while (list->count < page_count) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_vulkan_sparse_page_pool_grow(page_pool, memory_type_index));
+  }
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    iree_hal_vulkan_sparse_page_t page = list->pages[--list->count];
+    --page.chunk->free_page_count;
+    *out_wait_value = iree_max(*out_wait_value, page.release_value);
+    out_pages[i] = page;
+  }
+  return iree_ok_status();
+}
+
+// Returns |page_count| pages to the pool once |release_value| is reached.
+// Must be called with the pool lock held.
+static void iree_hal_vulkan_sparse_page_pool_release(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool, uint32_t memory_type_index,
+    iree_host_size_t page_count, const iree_hal_vulkan_sparse_page_t* pages,
+    uint64_t release_value) {
+  iree_hal_vulkan_sparse_page_list_t* list =
+      &page_pool->free_lists[memory_type_index];
+  // Capacity was reserved by the chunks the pages came from.
+  IREE_ASSERT_LE(list->count + page_count, list->capacity);
+  for (iree_host_size_t i = 0; i < page_count; ++i) {
+    iree_hal_vulkan_sparse_page_t page = pages[page_count - i - 1];
+    page.release_value = iree_max(page.release_value, release_value);
+    ++page.chunk->free_page_count;
+    page.chunk->last_release_value =
+        iree_max(page.chunk->last_release_value, page.release_value);
+    list->pages[list->count++] = page;
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_vulkan_sparse_buffer_t
+//===----------------------------------------------------------------------===//
+
 typedef struct iree_hal_vulkan_sparse_buffer_t {
   iree_hal_vulkan_base_buffer_t base;
   iree::hal::vulkan::VkDeviceHandle* logical_device;
+
+  // Pool pages are acquired from when the buffer is queue-ordered.
+  iree_hal_vulkan_sparse_page_pool_t* page_pool;
+  uint32_t memory_type_index;
+  // Size of the buffer memory as required by the implementation.
+  VkDeviceSize resource_size;
+  // Pages bound to the buffer or NULL if unbound.
+  iree_host_size_t page_count;
+  iree_hal_vulkan_sparse_page_t* pages;
+
   iree_host_size_t physical_block_count;
   VkDeviceMemory physical_blocks[];
 } iree_hal_vulkan_sparse_buffer_t;
@@ -182,6 +506,264 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
   return status;
 }
 
+iree_status_t iree_hal_vulkan_sparse_buffer_create_unbound(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    VkDeviceHandle* logical_device, VkBuffer handle,
+    VkMemoryRequirements requirements, uint32_t memory_type_index,
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(allocator);
+  IREE_ASSERT_ARGUMENT(logical_device);
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(page_pool);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
+
+  // All buffers share the same page size and the first buffer created decides
+  // it. Implementations generally report the same sparse block size for all
+  // buffers but if not we bail and let the caller allocate normally.
+  iree_slim_mutex_lock(&page_pool->mutex);
+  if (!page_pool->page_size) page_pool->page_size = requirements.alignment;
+  VkDeviceSize page_size = page_pool->page_size;
+  iree_slim_mutex_unlock(&page_pool->mutex);
+  if (page_size % requirements.alignment != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "sparse block size %" PRIu64
+                            " incompatible with pool page size %" PRIu64,
+                            (uint64_t)requirements.alignment,
+                            (uint64_t)page_size);
+  }
+
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(allocator);
+  iree_hal_vulkan_sparse_buffer_t* buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer));
+  iree_hal_buffer_initialize(
+      host_allocator, allocator, &buffer->base.base, allocation_size,
+      byte_offset, byte_length, memory_type, allowed_access, allowed_usage,
+      &iree_hal_vulkan_sparse_buffer_vtable, &buffer->base.base);
+  buffer->base.handle = handle;
+  buffer->logical_device = logical_device;
+  buffer->page_pool = page_pool;
+  buffer->memory_type_index = memory_type_index;
+  buffer->resource_size = requirements.size;
+  buffer->page_count = (iree_host_size_t)iree_device_size_ceil_div(
+      requirements.size, page_size);
+  buffer->pages = NULL;
+  buffer->physical_block_count = 0;
+
+  *out_buffer = &buffer->base.base;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+bool iree_hal_vulkan_sparse_buffer_is_queue_ordered(iree_hal_buffer_t* buffer) {
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffer);
+  return iree_hal_resource_is(allocated_buffer,
+                              &iree_hal_vulkan_sparse_buffer_vtable) &&
+         ((iree_hal_vulkan_sparse_buffer_t*)allocated_buffer)->page_pool;
+}
+
+// Translates |semaphore_list| into Vulkan timeline semaphores and values
+// followed by |extra_semaphore| at |extra_value| if not VK_NULL_HANDLE.
+// |out_handles| and |out_values| must have room for one more entry than the
+// list.
+static uint32_t iree_hal_vulkan_sparse_buffer_translate_semaphores(
+    const iree_hal_semaphore_list_t semaphore_list, VkSemaphore extra_semaphore,
+    uint64_t extra_value, VkSemaphore* out_handles, uint64_t* out_values) {
+  uint32_t count = 0;
+  for (iree_host_size_t i = 0; i < semaphore_list.count; ++i) {
+    out_handles[count] =
+        iree_hal_vulkan_native_semaphore_handle(semaphore_list.semaphores[i]);
+    out_values[count] = semaphore_list.payload_values[i];
+    ++count;
+  }
+  if (extra_semaphore != VK_NULL_HANDLE) {
+    out_handles[count] = extra_semaphore;
+    out_values[count] = extra_value;
+    ++count;
+  }
+  return count;
+}
+
+// Enqueues |bind_count| |binds| to |buffer| on |queue| ordered by the given
+// semaphores. The pool timeline is waited on if |timeline_wait_value| is
+// non-zero and signaled if |timeline_signal_value| is non-zero.
+static iree_status_t iree_hal_vulkan_sparse_buffer_enqueue_binds(
+    iree_hal_vulkan_sparse_buffer_t* buffer, CommandQueue* queue,
+    uint32_t bind_count, const VkSparseMemoryBind* binds,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    uint64_t timeline_wait_value,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    uint64_t timeline_signal_value) {
+  VkSemaphore timeline = buffer->page_pool->timeline;
+  VkSemaphore* wait_handles = (VkSemaphore*)iree_alloca(
+      (wait_semaphore_list.count + 1) * sizeof(VkSemaphore));
+  uint64_t* wait_values = (uint64_t*)iree_alloca(
+      (wait_semaphore_list.count + 1) * sizeof(uint64_t));
+  uint32_t wait_count = iree_hal_vulkan_sparse_buffer_translate_semaphores(
+      wait_semaphore_list, timeline_wait_value ? timeline : VK_NULL_HANDLE,
+      timeline_wait_value, wait_handles, wait_values);
+  VkSemaphore* signal_handles = (VkSemaphore*)iree_alloca(
+      (signal_semaphore_list.count + 1) * sizeof(VkSemaphore));
+  uint64_t* signal_values = (uint64_t*)iree_alloca(
+      (signal_semaphore_list.count + 1) * sizeof(uint64_t));
+  uint32_t signal_count = iree_hal_vulkan_sparse_buffer_translate_semaphores(
+      signal_semaphore_list, timeline_signal_value ? timeline : VK_NULL_HANDLE,
+      timeline_signal_value, signal_handles, signal_values);
+
+  VkTimelineSemaphoreSubmitInfo timeline_submit_info;
+  timeline_submit_info.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+  timeline_submit_info.pNext = NULL;
+  timeline_submit_info.waitSemaphoreValueCount = wait_count;
+  timeline_submit_info.pWaitSemaphoreValues = wait_values;
+  timeline_submit_info.signalSemaphoreValueCount = signal_count;
+  timeline_submit_info.pSignalSemaphoreValues = signal_values;
+
+  VkSparseBufferMemoryBindInfo memory_bind_info;
+  memory_bind_info.buffer = buffer->base.handle;
+  memory_bind_info.bindCount = bind_count;
+  memory_bind_info.pBinds = binds;
+  VkBindSparseInfo bind_info;
+  memset(&bind_info, 0, sizeof(bind_info));
+  bind_info.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+  bind_info.pNext = &timeline_submit_info;
+  bind_info.waitSemaphoreCount = wait_count;
+  bind_info.pWaitSemaphores = wait_handles;
+  bind_info.bufferBindCount = 1;
+  bind_info.pBufferBinds = &memory_bind_info;
+  bind_info.signalSemaphoreCount = signal_count;
+  bind_info.pSignalSemaphores = signal_handles;
+  return queue->BindSparse(1, &bind_info);
+}
+
+iree_status_t iree_hal_vulkan_sparse_buffer_queue_bind(
+    iree_hal_buffer_t* base_buffer, CommandQueue* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list) {
+  iree_hal_vulkan_sparse_buffer_t* buffer = iree_hal_vulkan_sparse_buffer_cast(
+      iree_hal_buffer_allocated_buffer(base_buffer));
+  iree_hal_vulkan_sparse_page_pool_t* page_pool = buffer->page_pool;
+  IREE_ASSERT(page_pool && !buffer->pages);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer->page_count);
+
+  iree_hal_vulkan_sparse_page_t* pages = NULL;
+  VkSparseMemoryBind* binds = NULL;
+  iree_allocator_t host_allocator = page_pool->host_allocator;
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, buffer->page_count * sizeof(pages[0]), (void**)&pages);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(host_allocator,
+                                   buffer->page_count * sizeof(binds[0]),
+                                   (void**)&binds);
+  }
+
+  // Acquisition and submission happen under the pool lock so that pages
+  // released by concurrent unbinds are not seen before their timeline value
+  // has been submitted.
+  iree_slim_mutex_lock(&page_pool->mutex);
+  VkDeviceSize page_size = page_pool->page_size;
+  uint64_t wait_value = 0;
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_sparse_page_pool_acquire(
+        page_pool, buffer->memory_type_index, buffer->page_count, pages,
+        &wait_value);
+  }
+
+  // Coalesce runs of pages contiguous in both the buffer and their chunk.
+  // Only the last bind may be smaller than a page.
+  uint32_t bind_count = 0;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = 0; i < buffer->page_count; ++i) {
+      VkDeviceSize resource_offset = i * page_size;
+      VkDeviceSize size =
+          iree_min(page_size, buffer->resource_size - resource_offset);
+      VkSparseMemoryBind* last = bind_count ? &binds[bind_count - 1] : NULL;
+      if (last && last->memory == pages[i].chunk->device_memory &&
+          last->memoryOffset + last->size == pages[i].memory_offset) {
+        last->size += size;
+        continue;
+      }
+      VkSparseMemoryBind* bind = &binds[bind_count++];
+      bind->resourceOffset = resource_offset;
+      bind->size = size;
+      bind->memory = pages[i].chunk->device_memory;
+      bind->memoryOffset = pages[i].memory_offset;
+      bind->flags = 0;
+    }
+    status = iree_hal_vulkan_sparse_buffer_enqueue_binds(
+        buffer, queue, bind_count, binds, wait_semaphore_list, wait_value,
+        signal_semaphore_list, /*timeline_signal_value=*/0);
+    if (!iree_status_is_ok(status)) {
+      iree_hal_vulkan_sparse_page_pool_release(
+          page_pool, buffer->memory_type_index, buffer->page_count, pages,
+          /*release_value=*/0);
+    }
+  }
+  iree_slim_mutex_unlock(&page_pool->mutex);
+
+  iree_allocator_free(host_allocator, binds);
+  if (iree_status_is_ok(status)) {
+    buffer->pages = pages;
+  } else {
+    iree_allocator_free(host_allocator, pages);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_hal_vulkan_sparse_buffer_queue_unbind(
+    iree_hal_buffer_t* base_buffer, CommandQueue* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list) {
+  iree_hal_vulkan_sparse_buffer_t* buffer = iree_hal_vulkan_sparse_buffer_cast(
+      iree_hal_buffer_allocated_buffer(base_buffer));
+  iree_hal_vulkan_sparse_page_pool_t* page_pool = buffer->page_pool;
+  IREE_ASSERT(page_pool);
+  if (!buffer->pages) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "sparse buffer has no memory bound");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)buffer->page_count);
+
+  VkSparseMemoryBind bind;
+  bind.resourceOffset = 0;
+  bind.size = buffer->resource_size;
+  bind.memory = VK_NULL_HANDLE;
+  bind.memoryOffset = 0;
+  bind.flags = 0;
+
+  iree_slim_mutex_lock(&page_pool->mutex);
+  uint64_t release_value = page_pool->timeline_value + 1;
+  iree_status_t status = iree_hal_vulkan_sparse_buffer_enqueue_binds(
+      buffer, queue, /*bind_count=*/1, &bind, wait_semaphore_list,
+      /*timeline_wait_value=*/0, signal_semaphore_list, release_value);
+  if (iree_status_is_ok(status)) {
+    page_pool->timeline_value = release_value;
+    iree_hal_vulkan_sparse_page_pool_release(
+        page_pool, buffer->memory_type_index, buffer->page_count,
+        buffer->pages, release_value);
+  }
+  iree_slim_mutex_unlock(&page_pool->mutex);
+
+  if (iree_status_is_ok(status)) {
+    iree_allocator_free(page_pool->host_allocator, buffer->pages);
+    buffer->pages = NULL;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static void iree_hal_vulkan_sparse_buffer_destroy(
     iree_hal_buffer_t* base_buffer) {
   iree_hal_vulkan_sparse_buffer_t* buffer =
@@ -197,6 +779,18 @@ static void iree_hal_vulkan_sparse_buffer_destroy(
     logical_device->syms()->vkDestroyBuffer(
         *logical_device, buffer->base.handle, logical_device->allocator());
   }
+
+  // Return pages still bound if the buffer was not deallocated on a queue.
+  // As with any other buffer no work may be using it when it is destroyed.
+  if (buffer->pages) {
+    iree_hal_vulkan_sparse_page_pool_t* page_pool = buffer->page_pool;
+    iree_slim_mutex_lock(&page_pool->mutex);
+    iree_hal_vulkan_sparse_page_pool_release(
+        page_pool, buffer->memory_type_index, buffer->page_count,
+        buffer->pages, /*release_value=*/0);
+    iree_slim_mutex_unlock(&page_pool->mutex);
+    iree_allocator_free(page_pool->host_allocator, buffer->pages);
+  }
   for (iree_host_size_t i = 0; i < buffer->physical_block_count; ++i) {
     if (buffer->physical_blocks[i] != VK_NULL_HANDLE) {
       logical_device->syms()->vkFreeMemory(*logical_device,
@@ -13,6 +13,7 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/drivers/vulkan/command_queue.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
 
 #ifdef __cplusplus
@@ -35,6 +36,79 @@ iree_status_t iree_hal_vulkan_sparse_buffer_create_bound_sync(
     uint32_t memory_type_index, VkDeviceSize max_allocation_size,
     iree_hal_buffer_t** out_buffer);
 
+//===----------------------------------------------------------------------===//
+// iree_hal_vulkan_sparse_page_pool_t
+//===----------------------------------------------------------------------===//
+
+// A pool of fixed-size pages of device memory that queue-ordered sparse
+// buffers are bound to.
+//
+// Pages are carved out of larger device memory chunks allocated on demand.
+// When a buffer is deallocated on a queue its pages are unbound by a sparse
+// binding operation that signals an internal timeline semaphore and the pages
+// return to the pool tagged with the timeline value. Buffers allocated later
+// may immediately reuse those pages by waiting on the timeline value in their
+// own binding operation, allowing transient memory to be reused at page
+// granularity without waiting on the host.
+//
+// Thread-safe; pages may be acquired and released from any thread.
+typedef struct iree_hal_vulkan_sparse_page_pool_t
+    iree_hal_vulkan_sparse_page_pool_t;
+
+// Creates a sparse page pool allocating memory from |logical_device|.
+iree_status_t iree_hal_vulkan_sparse_page_pool_create(
+    iree::hal::vulkan::VkDeviceHandle* logical_device,
+    iree_allocator_t host_allocator,
+    iree_hal_vulkan_sparse_page_pool_t** out_page_pool);
+
+// Frees |page_pool| and all of its device memory. No buffers using the pool
+// may be live and all queue operations using it must have completed.
+void iree_hal_vulkan_sparse_page_pool_free(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool);
+
+// Frees device memory chunks with no pages in use.
+void iree_hal_vulkan_sparse_page_pool_trim(
+    iree_hal_vulkan_sparse_page_pool_t* page_pool);
+
+//===----------------------------------------------------------------------===//
+// Queue-ordered sparse buffers
+//===----------------------------------------------------------------------===//
+
+// Creates a sparse buffer with no memory bound that is backed by pages from
+// |page_pool| once bound on a queue with
+// iree_hal_vulkan_sparse_buffer_queue_bind. |handle| must have been created
+// with VK_BUFFER_CREATE_SPARSE_BINDING_BIT and is owned by the buffer.
+//
+// Returns IREE_STATUS_UNAVAILABLE if the sparse block size required by
+// |requirements| is incompatible with the pages in |page_pool|.
+iree_status_t iree_hal_vulkan_sparse_buffer_create_unbound(
+    iree_hal_allocator_t* allocator, iree_hal_memory_type_t memory_type,
+    iree_hal_memory_access_t allowed_access,
+    iree_hal_buffer_usage_t allowed_usage, iree_device_size_t allocation_size,
+    iree_device_size_t byte_offset, iree_device_size_t byte_length,
+    iree::hal::vulkan::VkDeviceHandle* logical_device, VkBuffer handle,
+    VkMemoryRequirements requirements, uint32_t memory_type_index,
+    iree_hal_vulkan_sparse_page_pool_t* page_pool,
+    iree_hal_buffer_t** out_buffer);
+
+// Returns true if |buffer| is a queue-ordered sparse buffer.
+bool iree_hal_vulkan_sparse_buffer_is_queue_ordered(iree_hal_buffer_t* buffer);
+
+// Binds pages to the unbound |buffer| on |queue| once |wait_semaphore_list|
+// is reached and signals |signal_semaphore_list| when the memory is bound.
+iree_status_t iree_hal_vulkan_sparse_buffer_queue_bind(
+    iree_hal_buffer_t* buffer, iree::hal::vulkan::CommandQueue* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list);
+
+// Unbinds the pages of |buffer| on |queue| once |wait_semaphore_list| is
+// reached and signals |signal_semaphore_list| when the memory is unbound.
+// The pages are returned to the pool for reuse by subsequent queue binds.
+iree_status_t iree_hal_vulkan_sparse_buffer_queue_unbind(
+    iree_hal_buffer_t* buffer, iree::hal::vulkan::CommandQueue* queue,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -12,7 +12,10 @@
 #include <vector>
 
 #include "iree/base/internal/arena.h"
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/inline_array.h"
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/drivers/vulkan/api.h"
 #include "iree/hal/drivers/vulkan/builtin_executables.h"
 #include "iree/hal/drivers/vulkan/command_queue.h"
@@ -22,15 +25,19 @@
 #include "iree/hal/drivers/vulkan/dynamic_symbols.h"
 #include "iree/hal/drivers/vulkan/extensibility_util.h"
 #include "iree/hal/drivers/vulkan/handle_util.h"
+#include "iree/hal/drivers/vulkan/indirect_command_buffer_cache.h"
 #include "iree/hal/drivers/vulkan/native_allocator.h"
 #include "iree/hal/drivers/vulkan/native_event.h"
 #include "iree/hal/drivers/vulkan/native_pipeline_layout.h"
 #include "iree/hal/drivers/vulkan/native_semaphore.h"
 #include "iree/hal/drivers/vulkan/nop_executable_cache.h"
+#include "iree/hal/drivers/vulkan/pipeline_cache.h"
+#include "iree/hal/drivers/vulkan/sparse_buffer.h"
 #include "iree/hal/drivers/vulkan/status_util.h"
 #include "iree/hal/drivers/vulkan/tracing.h"
 #include "iree/hal/drivers/vulkan/util/arena.h"
 #include "iree/hal/drivers/vulkan/util/ref_ptr.h"
+#include "iree/hal/utils/deferred_command_buffer.h"
 #include "iree/hal/utils/file_transfer.h"
 #include "iree/hal/utils/memory_file.h"
 
@@ -218,6 +225,23 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_query_extensibility_set(
   ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
           VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
 
+  // VK_EXT_descriptor_buffer:
+  // Allows descriptor sets to be written directly into device memory instead
+  // of being allocated from pools and updated with vkUpdateDescriptorSets.
+  // Only used when push descriptors are unavailable and requires buffer device
+  // addresses to reference the descriptor buffers.
+  if (iree_all_bits_set(requested_features,
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS)) {
+    ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+            VK_EXT_DESCRIPTOR_BUFFER_EXTENSION_NAME);
+  }
+
+  // VK_EXT_memory_priority:
+  // Allows persistent buffers to be given a higher residency priority than
+  // transient ones when device memory is oversubscribed.
+  ADD_EXT(IREE_HAL_VULKAN_EXTENSIBILITY_DEVICE_EXTENSIONS_OPTIONAL,
+          VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+
   //===--------------------------------------------------------------------===//
   // Vulkan forward-compatibility shims
   //===--------------------------------------------------------------------===//
@@ -315,6 +339,9 @@ IREE_API_EXPORT iree_status_t iree_hal_vulkan_query_extensibility_set(
 
 #define IREE_HAL_VULKAN_INVALID_QUEUE_FAMILY_INDEX (-1)
 
+// Maximum number of indirect command buffer recordings retained per device.
+#define IREE_HAL_VULKAN_INDIRECT_COMMAND_BUFFER_CACHE_CAPACITY 32
+
 typedef struct iree_hal_vulkan_queue_family_info_t {
   uint32_t dispatch_index;
   iree_host_size_t dispatch_queue_count;
@@ -447,6 +474,25 @@ static iree_status_t iree_hal_vulkan_select_queue_families(
   return iree_ok_status();
 }
 
+// Returns true if the queue family |queue_family_index| supports sparse
+// binding operations.
+static bool iree_hal_vulkan_queue_family_supports_sparse_binding(
+    iree::hal::vulkan::DynamicSymbols* syms, VkPhysicalDevice physical_device,
+    uint32_t queue_family_index) {
+  uint32_t queue_family_count = 0;
+  syms->vkGetPhysicalDeviceQueueFamilyProperties(physical_device,
+                                                 &queue_family_count, NULL);
+  if (queue_family_index >= queue_family_count) return false;
+  VkQueueFamilyProperties* queue_family_properties =
+      (VkQueueFamilyProperties*)iree_alloca(queue_family_count *
+                                            sizeof(VkQueueFamilyProperties));
+  syms->vkGetPhysicalDeviceQueueFamilyProperties(
+      physical_device, &queue_family_count, queue_family_properties);
+  return iree_all_bits_set(
+      queue_family_properties[queue_family_index].queueFlags,
+      VK_QUEUE_SPARSE_BINDING_BIT);
+}
+
 // Builds a set of compute and transfer queues based on the queues available on
 // the device and some magic heuristical goo.
 static iree_status_t iree_hal_vulkan_build_queue_sets(
@@ -511,6 +557,18 @@ typedef struct iree_hal_vulkan_device_t {
   // Optional provider used for creating/configuring collective channels.
   iree_hal_channel_provider_t* channel_provider;
 
+  // Optional persistent cache used by executable caches.
+  iree_hal_executable_disk_cache_t* executable_disk_cache;
+
+  // Pipeline cache shared by all executables prepared on the device.
+  VkPipelineCache pipeline_cache;
+  // NUL-terminated path the pipeline cache is persisted to, or NULL.
+  const char* pipeline_cache_path;
+  // Serializes writes of the pipeline cache to |pipeline_cache_path|.
+  iree_slim_mutex_t pipeline_cache_mutex;
+  // Size of the pipeline cache data last loaded from or saved to disk.
+  size_t pipeline_cache_data_size IREE_GUARDED_BY(pipeline_cache_mutex);
+
   // All queues available on the device; the device owns these.
   iree_host_size_t queue_count;
   CommandQueue** queues;
@@ -537,6 +595,19 @@ typedef struct iree_hal_vulkan_device_t {
 
   BuiltinExecutables* builtin_executables;
 
+  // Recordings of indirect command buffers keyed by binding table.
+  iree_hal_vulkan_indirect_command_buffer_cache_t* indirect_cache;
+  // Recordings of transfer command buffers made for the dedicated transfer
+  // queues, if any.
+  iree_hal_vulkan_indirect_command_buffer_cache_t* transfer_indirect_cache;
+
+  // Ordinal used to spread submissions with any queue affinity across queues.
+  iree_atomic_int32_t next_queue_ordinal;
+
+  // Pages backing buffers allocated with queue_alloca when the dispatch queues
+  // support sparse binding, or NULL if queue allocations are synchronous.
+  iree_hal_vulkan_sparse_page_pool_t* sparse_page_pool;
+
 #if defined(IREE_HAL_VULKAN_HAVE_RENDERDOC)
   RENDERDOC_API_LATEST* renderdoc_api;
 #endif  // IREE_HAL_VULKAN_HAVE_RENDERDOC
@@ -709,7 +780,9 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
       total_queue_count * sizeof(device->queues[0]) +
       total_queue_count * sizeof(device->dispatch_queues[0]) +
       total_queue_count * sizeof(device->transfer_queues[0]) +
-      total_queue_count * sizeof(device->queue_tracing_contexts[0]);
+      total_queue_count * sizeof(device->queue_tracing_contexts[0]) +
+      (options->pipeline_cache_path.size ? options->pipeline_cache_path.size + 1
+                                         : 0);
   IREE_RETURN_IF_ERROR(
       iree_allocator_malloc(host_allocator, total_size, (void**)&device));
   memset(device, 0, total_size);
@@ -722,6 +795,8 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   buffer_ptr += iree_string_view_append_to_buffer(
       identifier, &device->identifier, (char*)buffer_ptr);
   device->flags = options->flags;
+  device->executable_disk_cache = options->executable_disk_cache;
+  iree_hal_executable_disk_cache_retain(device->executable_disk_cache);
 
   device->device_extensions = *device_extensions;
   device->device_properties = *device_properties;
@@ -748,6 +823,13 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   device->queue_tracing_contexts =
       (iree_hal_vulkan_tracing_context_t**)buffer_ptr;
   buffer_ptr += total_queue_count * sizeof(device->queue_tracing_contexts[0]);
+  if (options->pipeline_cache_path.size) {
+    memcpy(buffer_ptr, options->pipeline_cache_path.data,
+           options->pipeline_cache_path.size);
+    buffer_ptr[options->pipeline_cache_path.size] = 0;
+    device->pipeline_cache_path = (const char*)buffer_ptr;
+  }
+  iree_slim_mutex_initialize(&device->pipeline_cache_mutex);
 
   device->descriptor_pool_cache =
       new DescriptorPoolCache(device->logical_device);
@@ -758,6 +840,32 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
       options, instance, physical_device, logical_device,
       &device->device_allocator);
 
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_vulkan_indirect_command_buffer_cache_allocate(
+        IREE_HAL_VULKAN_INDIRECT_COMMAND_BUFFER_CACHE_CAPACITY, host_allocator,
+        &device->indirect_cache);
+  }
+
+  // Queue-ordered allocations are bound on the dispatch queues and require
+  // their family to support sparse binding.
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(enabled_features,
+                        IREE_HAL_VULKAN_FEATURE_ENABLE_SPARSE_BINDING) &&
+      iree_hal_vulkan_queue_family_supports_sparse_binding(
+          logical_device->syms().get(), physical_device,
+          compute_queue_set->queue_family_index)) {
+    status = iree_hal_vulkan_sparse_page_pool_create(
+        logical_device, host_allocator, &device->sparse_page_pool);
+  }
+
+  // Seed the shared pipeline cache from disk so that pipelines compiled by
+  // previous runs of the process need not be compiled again.
+  if (iree_status_is_ok(status) && device->pipeline_cache_path) {
+    status = iree_hal_vulkan_pipeline_cache_load(
+        device->logical_device, device->pipeline_cache_path,
+        &device->pipeline_cache, &device->pipeline_cache_data_size);
+  }
+
   // Create command pools for each queue family. If we don't have a transfer
   // queue then we'll ignore that one and just use the dispatch pool.
   // If we wanted to expose the pools through the HAL to allow the VM to more
@@ -772,6 +880,11 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
     status = iree_hal_vulkan_create_transient_command_pool(
         device->logical_device, transfer_queue_set->queue_family_index,
         &device->transfer_command_pool);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_vulkan_indirect_command_buffer_cache_allocate(
+          IREE_HAL_VULKAN_INDIRECT_COMMAND_BUFFER_CACHE_CAPACITY,
+          host_allocator, &device->transfer_indirect_cache);
+    }
   }
 
   // Initialize queues now that we've completed the rest of the device
@@ -797,6 +910,18 @@ static iree_status_t iree_hal_vulkan_device_create_internal(
   return status;
 }
 
+// Writes the shared pipeline cache back to disk if it has grown.
+static iree_status_t iree_hal_vulkan_device_save_pipeline_cache(
+    iree_hal_vulkan_device_t* device) {
+  if (device->pipeline_cache == VK_NULL_HANDLE) return iree_ok_status();
+  iree_slim_mutex_lock(&device->pipeline_cache_mutex);
+  iree_status_t status = iree_hal_vulkan_pipeline_cache_save(
+      device->logical_device, device->pipeline_cache_path,
+      device->pipeline_cache, &device->pipeline_cache_data_size);
+  iree_slim_mutex_unlock(&device->pipeline_cache_mutex);
+  return status;
+}
+
 static void iree_hal_vulkan_device_destroy(iree_hal_device_t* base_device) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   iree_allocator_t host_allocator = iree_hal_device_host_allocator(base_device);
@@ -808,6 +933,17 @@ static void iree_hal_vulkan_device_destroy(iree_hal_device_t* base_device) {
     iree_hal_vulkan_tracing_context_free(device->queue_tracing_contexts[i]);
   }
 
+  // Drop cached recordings of indirect command buffers. Any still in flight
+  // were retained by their submissions and have completed above.
+  iree_hal_vulkan_indirect_command_buffer_cache_free(device->indirect_cache);
+  if (device->transfer_indirect_cache) {
+    iree_hal_vulkan_indirect_command_buffer_cache_free(
+        device->transfer_indirect_cache);
+  }
+
+  // All queue allocations have been unbound or their buffers destroyed.
+  iree_hal_vulkan_sparse_page_pool_free(device->sparse_page_pool);
+
   // Drop command pools now that we know there are no more outstanding command
   // buffers.
   delete device->dispatch_command_pool;
@@ -827,6 +963,17 @@ static void iree_hal_vulkan_device_destroy(iree_hal_device_t* base_device) {
   // All arena blocks should have been returned.
   iree_arena_block_pool_deinitialize(&device->block_pool);
 
+  iree_hal_executable_disk_cache_release(device->executable_disk_cache);
+
+  // Persist any pipelines compiled during the lifetime of the device.
+  if (device->pipeline_cache != VK_NULL_HANDLE) {
+    iree_status_ignore(iree_hal_vulkan_device_save_pipeline_cache(device));
+    device->logical_device->syms()->vkDestroyPipelineCache(
+        *device->logical_device, device->pipeline_cache,
+        device->logical_device->allocator());
+  }
+  iree_slim_mutex_deinitialize(&device->pipeline_cache_mutex);
+
   // Finally, destroy the device.
   device->logical_device->ReleaseReference();
   iree_hal_driver_release(device->driver);
@@ -1141,6 +1288,29 @@ iree_status_t iree_hal_vulkan_device_create(
   available_subgroup_properties.pNext = available_features2.pNext;
   available_features2.pNext = &available_subgroup_properties;
 
+  // + Descriptor buffer features.
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT
+      available_descriptor_buffer_features;
+  memset(&available_descriptor_buffer_features, 0,
+         sizeof(available_descriptor_buffer_features));
+  available_descriptor_buffer_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+  if (enabled_device_extensions.descriptor_buffer) {
+    available_descriptor_buffer_features.pNext = available_features2.pNext;
+    available_features2.pNext = &available_descriptor_buffer_features;
+  }
+
+  // + Memory priority features.
+  VkPhysicalDeviceMemoryPriorityFeaturesEXT available_memory_priority_features;
+  memset(&available_memory_priority_features, 0,
+         sizeof(available_memory_priority_features));
+  available_memory_priority_features.sType =
+      VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+  if (enabled_device_extensions.memory_priority) {
+    available_memory_priority_features.pNext = available_features2.pNext;
+    available_features2.pNext = &available_memory_priority_features;
+  }
+
   // + Cooperative matrix features.
   VkPhysicalDeviceCooperativeMatrixFeaturesKHR available_coop_matrix_features;
   memset(&available_coop_matrix_features, 0,
@@ -1229,6 +1399,40 @@ iree_status_t iree_hal_vulkan_device_create(
     enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES;
   }
 
+  // Descriptor buffers are only used when push descriptors are unavailable as
+  // push descriptors need no memory management of our own. They are addressed
+  // by device address and so also require buffer device addresses.
+  VkPhysicalDeviceDescriptorBufferFeaturesEXT descriptor_buffer_features;
+  if (enabled_device_extensions.descriptor_buffer &&
+      !enabled_device_extensions.push_descriptors &&
+      available_descriptor_buffer_features.descriptorBuffer &&
+      iree_all_bits_set(
+          enabled_features,
+          IREE_HAL_VULKAN_FEATURE_ENABLE_BUFFER_DEVICE_ADDRESSES)) {
+    memset(&descriptor_buffer_features, 0, sizeof(descriptor_buffer_features));
+    descriptor_buffer_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_BUFFER_FEATURES_EXT;
+    descriptor_buffer_features.pNext = enabled_features2.pNext;
+    enabled_features2.pNext = &descriptor_buffer_features;
+    descriptor_buffer_features.descriptorBuffer = VK_TRUE;
+    enabled_features |= IREE_HAL_VULKAN_FEATURE_ENABLE_DESCRIPTOR_BUFFERS;
+  } else {
+    enabled_device_extensions.descriptor_buffer = false;
+  }
+
+  VkPhysicalDeviceMemoryPriorityFeaturesEXT memory_priority_features;
+  if (enabled_device_extensions.memory_priority &&
+      available_memory_priority_features.memoryPriority) {
+    memset(&memory_priority_features, 0, sizeof(memory_priority_features));
+    memory_priority_features.sType =
+        VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+    memory_priority_features.pNext = enabled_features2.pNext;
+    enabled_features2.pNext = &memory_priority_features;
+    memory_priority_features.memoryPriority = VK_TRUE;
+  } else {
+    enabled_device_extensions.memory_priority = false;
+  }
+
   VkPhysicalDeviceTimelineSemaphoreFeatures semaphore_features;
   memset(&semaphore_features, 0, sizeof(semaphore_features));
   semaphore_features.sType =
@@ -1414,7 +1618,18 @@ static void iree_hal_vulkan_replace_channel_provider(
 static iree_status_t iree_hal_vulkan_device_trim(
     iree_hal_device_t* base_device) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+  iree_hal_vulkan_indirect_command_buffer_cache_trim(device->indirect_cache);
+  if (device->transfer_indirect_cache) {
+    iree_hal_vulkan_indirect_command_buffer_cache_trim(
+        device->transfer_indirect_cache);
+  }
+  // Saving is best-effort: failing only means pipelines are compiled again by
+  // the next process.
+  iree_status_ignore(iree_hal_vulkan_device_save_pipeline_cache(device));
   iree_arena_block_pool_trim(&device->block_pool);
+  if (device->sparse_page_pool) {
+    iree_hal_vulkan_sparse_page_pool_trim(device->sparse_page_pool);
+  }
   return iree_hal_allocator_trim(device->device_allocator);
 }
 
@@ -1493,17 +1708,14 @@ static CommandQueue* iree_hal_vulkan_device_select_queue(
     iree_hal_vulkan_device_t* device,
     iree_hal_command_category_t command_categories,
     iree_hal_queue_affinity_t queue_affinity) {
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
-
-  // TODO(benvanik): meaningful heuristics for affinity. We don't generate
-  // anything from the compiler that uses multiple queues and until we do it's
-  // best not to do anything too clever here.
+  // Work that may execute on any queue is spread round-robin across the
+  // queues so that independent submissions can overlap. Submissions are only
+  // ordered with respect to each other by their semaphores so this is safe
+  // even when a producer and consumer land on different queues.
+  if (queue_affinity == IREE_HAL_QUEUE_AFFINITY_ANY) {
+    queue_affinity = (uint32_t)iree_atomic_fetch_add_int32(
+        &device->next_queue_ordinal, 1, iree_memory_order_relaxed);
+  }
   if (command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER) {
     return device
         ->transfer_queues[queue_affinity % device->transfer_queue_count];
@@ -1525,26 +1737,43 @@ static iree_status_t iree_hal_vulkan_device_create_command_buffer(
     iree_hal_command_buffer_t** out_command_buffer) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
 
-  // TODO(scotttodd): revisit queue selection logic and remove this
-  //   * the unaligned buffer fill polyfill and tracing timestamp queries may
-  //     both insert dispatches into command buffers that at compile time are
-  //     expected to only contain transfer commands
-  //   * we could set a bit at recording time if emulation or tracing is used
-  //     and submit to the right queue based on that
-  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
+  // Vulkan has no native indirect bindings so command buffers that reference
+  // a binding table are captured and recorded into a VkCommandBuffer when
+  // executed with one. Binding tables can only be provided when executing a
+  // nested command buffer.
+  if (binding_capacity > 0) {
+    if (!iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+      return iree_make_status(
+          IREE_STATUS_UNIMPLEMENTED,
+          "indirect command buffers must be nested and executed with "
+          "iree_hal_command_buffer_execute_commands");
+    }
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, binding_capacity,
+        &device->block_pool, iree_hal_device_host_allocator(base_device),
+        out_command_buffer);
+  }
 
-  // Select the command pool to used based on the types of commands used.
-  // Note that we may not have a dedicated transfer command pool if there are
-  // no dedicated transfer queues.
-  VkCommandPoolHandle* command_pool = NULL;
+  // Transfer command buffers are captured and recorded when submitted so that
+  // the submission can be routed to a dedicated transfer queue. The queue
+  // family of a VkCommandBuffer is fixed by its pool and only once recorded
+  // do we know whether the commands can run on a transfer queue: unaligned
+  // fills are emulated with a dispatch.
   if (device->transfer_command_pool &&
-      !iree_all_bits_set(command_categories,
-                         IREE_HAL_COMMAND_CATEGORY_DISPATCH)) {
-    command_pool = device->transfer_command_pool;
-  } else {
-    command_pool = device->dispatch_command_pool;
+      command_categories == IREE_HAL_COMMAND_CATEGORY_TRANSFER &&
+      !iree_all_bits_set(mode, IREE_HAL_COMMAND_BUFFER_MODE_NESTED)) {
+    return iree_hal_deferred_command_buffer_create(
+        base_device, mode, command_categories, /*binding_capacity=*/0,
+        &device->block_pool, iree_hal_device_host_allocator(base_device),
+        out_command_buffer);
   }
 
+  // All other command buffers are recorded directly for the dispatch queues.
+  // Even transfer command buffers may contain dispatches from the unaligned
+  // fill polyfill.
+  command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
+  VkCommandPoolHandle* command_pool = device->dispatch_command_pool;
+
   // The tracing context is tied to a particular queue so we must select here
   // even though ideally we'd do it during submission. This is informational
   // only and if the user does provide a different queue affinity during
@@ -1557,7 +1786,8 @@ static iree_status_t iree_hal_vulkan_device_create_command_buffer(
       base_device, device->logical_device, command_pool, mode,
       command_categories, queue_affinity, binding_capacity,
       queue->tracing_context(), device->descriptor_pool_cache,
-      device->builtin_executables, &device->block_pool, out_command_buffer);
+      device->builtin_executables, device->indirect_cache, &device->block_pool,
+      out_command_buffer);
 }
 
 static iree_status_t iree_hal_vulkan_device_create_descriptor_set_layout(
@@ -1583,7 +1813,8 @@ static iree_status_t iree_hal_vulkan_device_create_executable_cache(
     iree_loop_t loop, iree_hal_executable_cache_t** out_executable_cache) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
   return iree_hal_vulkan_nop_executable_cache_create(
-      device->logical_device, identifier, out_executable_cache);
+      device->logical_device, identifier, device->executable_disk_cache,
+      device->pipeline_cache, out_executable_cache);
 }
 
 static iree_status_t iree_hal_vulkan_device_import_file(
@@ -1641,7 +1872,34 @@ static iree_status_t iree_hal_vulkan_device_queue_alloca(
     iree_hal_allocator_pool_t pool, iree_hal_buffer_params_t params,
     iree_device_size_t allocation_size,
     iree_hal_buffer_t** IREE_RESTRICT out_buffer) {
-  // TODO(benvanik): queue-ordered allocations.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // Device-local allocations are bound to pooled pages on the queue so that
+  // memory released by earlier queue deallocations can be reused without
+  // waiting on the host. Buffers that cannot be sparsely bound (such as
+  // mappable ones) fall back to synchronous allocation.
+  if (device->sparse_page_pool) {
+    iree_hal_buffer_t* buffer = NULL;
+    iree_status_t status = iree_hal_vulkan_native_allocator_allocate_unbound(
+        device->device_allocator, &params, allocation_size,
+        device->sparse_page_pool, &buffer);
+    if (iree_status_is_ok(status)) {
+      CommandQueue* queue = iree_hal_vulkan_device_select_queue(
+          device, IREE_HAL_COMMAND_CATEGORY_ANY, queue_affinity);
+      status = iree_hal_vulkan_sparse_buffer_queue_bind(
+          buffer, queue, wait_semaphore_list, signal_semaphore_list);
+      if (iree_status_is_ok(status)) {
+        *out_buffer = buffer;
+      } else {
+        iree_hal_buffer_release(buffer);
+      }
+      return status;
+    } else if (!iree_status_is_unavailable(status)) {
+      return status;
+    }
+    iree_status_ignore(status);
+  }
+
   IREE_RETURN_IF_ERROR(iree_hal_semaphore_list_wait(wait_semaphore_list,
                                                     iree_infinite_timeout()));
   IREE_RETURN_IF_ERROR(
@@ -1656,7 +1914,17 @@ static iree_status_t iree_hal_vulkan_device_queue_dealloca(
     const iree_hal_semaphore_list_t wait_semaphore_list,
     const iree_hal_semaphore_list_t signal_semaphore_list,
     iree_hal_buffer_t* buffer) {
-  // TODO(benvanik): queue-ordered allocations.
+  iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
+
+  // Unbind pages on the queue to make them available to subsequent queue
+  // allocations. The buffer itself is released by the caller.
+  if (iree_hal_vulkan_sparse_buffer_is_queue_ordered(buffer)) {
+    CommandQueue* queue = iree_hal_vulkan_device_select_queue(
+        device, IREE_HAL_COMMAND_CATEGORY_ANY, queue_affinity);
+    return iree_hal_vulkan_sparse_buffer_queue_unbind(
+        buffer, queue, wait_semaphore_list, signal_semaphore_list);
+  }
+
   IREE_RETURN_IF_ERROR(iree_hal_device_queue_barrier(
       base_device, queue_affinity, wait_semaphore_list, signal_semaphore_list));
   return iree_ok_status();
@@ -1704,6 +1972,83 @@ static iree_status_t iree_hal_vulkan_device_queue_write(
   return loop_status;
 }
 
+// Releases the recordings of the deferred command buffers in
+// |command_buffers| made by iree_hal_vulkan_device_record_submission.
+static void iree_hal_vulkan_device_release_recordings(
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    iree_hal_command_buffer_t** recordings) {
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    if (recordings[i] != command_buffers[i]) {
+      iree_hal_command_buffer_release(recordings[i]);
+    }
+    recordings[i] = NULL;
+  }
+}
+
+// Populates |out_recordings| with command buffers from |command_pool| that
+// can be submitted to |queue| in place of |command_buffers|. Deferred command
+// buffers are recorded (or looked up in |cache| if reusable) and all others
+// are passed through. Fails with IREE_STATUS_UNAVAILABLE if |queue| does not
+// support dispatches and the commands require one.
+static iree_status_t iree_hal_vulkan_device_record_submission(
+    iree_hal_vulkan_device_t* device, CommandQueue* queue,
+    VkCommandPoolHandle* command_pool,
+    iree_hal_vulkan_indirect_command_buffer_cache_t* cache,
+    iree_host_size_t command_buffer_count,
+    iree_hal_command_buffer_t* const* command_buffers,
+    iree_hal_command_buffer_t** out_recordings) {
+  iree_hal_buffer_binding_table_t binding_table =
+      iree_hal_buffer_binding_table_empty();
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < command_buffer_count; ++i) {
+    iree_hal_command_buffer_t* commands = command_buffers[i];
+    out_recordings[i] = commands;
+    if (!iree_hal_deferred_command_buffer_isa(commands)) continue;
+    out_recordings[i] = NULL;
+
+    bool is_reusable = !iree_all_bits_set(
+        commands->mode, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT);
+    if (is_reusable && iree_hal_vulkan_indirect_command_buffer_cache_lookup(
+                           cache, commands, binding_table,
+                           &out_recordings[i])) {
+      continue;
+    }
+
+    iree_hal_command_category_t command_categories =
+        commands->allowed_categories;
+    if (queue->can_dispatch()) {
+      command_categories |= IREE_HAL_COMMAND_CATEGORY_DISPATCH;
+    }
+    iree_hal_command_buffer_t* recording = NULL;
+    status = iree_hal_vulkan_direct_command_buffer_allocate(
+        (iree_hal_device_t*)device, device->logical_device, command_pool,
+        IREE_HAL_COMMAND_BUFFER_MODE_UNVALIDATED |
+            (commands->mode & IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT),
+        command_categories, commands->queue_affinity,
+        /*binding_capacity=*/0, queue->tracing_context(),
+        device->descriptor_pool_cache, device->builtin_executables,
+        device->indirect_cache, &device->block_pool, &recording);
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_deferred_command_buffer_apply(commands, recording,
+                                                      binding_table);
+    }
+    if (iree_status_is_ok(status) && is_reusable) {
+      status = iree_hal_vulkan_indirect_command_buffer_cache_insert(
+          cache, commands, binding_table, recording);
+    }
+    if (!iree_status_is_ok(status)) {
+      iree_hal_command_buffer_release(recording);
+      out_recordings[i] = commands;
+      iree_hal_vulkan_device_release_recordings(i, command_buffers,
+                                                out_recordings);
+      break;
+    }
+    out_recordings[i] = recording;
+  }
+  return status;
+}
+
 static iree_status_t iree_hal_vulkan_device_queue_execute(
     iree_hal_device_t* base_device, iree_hal_queue_affinity_t queue_affinity,
     const iree_hal_semaphore_list_t wait_semaphore_list,
@@ -1711,19 +2056,71 @@ static iree_status_t iree_hal_vulkan_device_queue_execute(
     iree_host_size_t command_buffer_count,
     iree_hal_command_buffer_t* const* command_buffers) {
   iree_hal_vulkan_device_t* device = iree_hal_vulkan_device_cast(base_device);
-  // NOTE: today we are not discriminating queues based on command type.
-  CommandQueue* queue = iree_hal_vulkan_device_select_queue(
-      device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
-  iree_hal_submission_batch_t batch = {
-      /*.wait_semaphores=*/wait_semaphore_list,
-      /*.command_buffer_count=*/command_buffer_count,
-      /*.command_buffers=*/command_buffers,
-      /*.signal_semaphores=*/signal_semaphore_list,
-  };
-  IREE_RETURN_IF_ERROR(queue->Submit(1, &batch));
-  // HACK: we don't track async resource lifetimes so we have to block.
-  return iree_hal_semaphore_list_wait(signal_semaphore_list,
-                                      iree_infinite_timeout());
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Submissions made up only of transfer command buffers are issued to a
+  // dedicated transfer queue when the device has one so that uploads and
+  // downloads can overlap with dispatches. If the commands turn out to
+  // require a dispatch the submission falls back to a dispatch queue.
+  bool is_transfer =
+      device->transfer_command_pool != NULL && command_buffer_count > 0;
+  for (iree_host_size_t i = 0; i < command_buffer_count && is_transfer; ++i) {
+    is_transfer = iree_hal_deferred_command_buffer_isa(command_buffers[i]) &&
+                  command_buffers[i]->allowed_categories ==
+                      IREE_HAL_COMMAND_CATEGORY_TRANSFER;
+  }
+
+  iree_inline_array(iree_hal_command_buffer_t*, recordings,
+                    command_buffer_count, device->host_allocator);
+  CommandQueue* queue = NULL;
+  iree_status_t status = iree_ok_status();
+  if (is_transfer) {
+    queue = iree_hal_vulkan_device_select_queue(
+        device, IREE_HAL_COMMAND_CATEGORY_TRANSFER, queue_affinity);
+    status = iree_hal_vulkan_device_record_submission(
+        device, queue, device->transfer_command_pool,
+        device->transfer_indirect_cache, command_buffer_count, command_buffers,
+        iree_inline_array_data(recordings));
+    if (iree_status_is_unavailable(status)) {
+      status = iree_status_ignore(status);
+      is_transfer = false;
+    }
+  }
+  if (!is_transfer && iree_status_is_ok(status)) {
+    queue = iree_hal_vulkan_device_select_queue(
+        device, IREE_HAL_COMMAND_CATEGORY_DISPATCH, queue_affinity);
+    status = iree_hal_vulkan_device_record_submission(
+        device, queue, device->dispatch_command_pool, device->indirect_cache,
+        command_buffer_count, command_buffers,
+        iree_inline_array_data(recordings));
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_hal_submission_batch_t batch = {
+        /*.wait_semaphores=*/wait_semaphore_list,
+        /*.command_buffer_count=*/command_buffer_count,
+        /*.command_buffers=*/iree_inline_array_data(recordings),
+        /*.signal_semaphores=*/signal_semaphore_list,
+    };
+    status = queue->Submit(1, &batch);
+    // HACK: we don't track async resource lifetimes so we have to block.
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_list_wait(signal_semaphore_list,
+                                            iree_infinite_timeout());
+    }
+    // Recordings made for this submission are released below and without
+    // semaphores to wait on we have to wait for the queue itself.
+    if (iree_status_is_ok(status) && signal_semaphore_list.count == 0) {
+      status = queue->WaitIdle(iree_infinite_timeout());
+    }
+    iree_hal_vulkan_device_release_recordings(
+        command_buffer_count, command_buffers,
+        iree_inline_array_data(recordings));
+  }
+
+  iree_inline_array_deinitialize(recordings);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
 
 static iree_status_t iree_hal_vulkan_device_queue_flush(
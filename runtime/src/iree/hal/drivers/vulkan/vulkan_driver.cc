@@ -110,7 +110,9 @@ static iree_status_t iree_hal_vulkan_driver_create_internal(
   }
 
   iree_hal_vulkan_driver_t* driver = NULL;
-  iree_host_size_t total_size = sizeof(*driver) + identifier.size;
+  iree_host_size_t total_size =
+      sizeof(*driver) + identifier.size +
+      options->device_options.pipeline_cache_path.size;
   iree_status_t status =
       iree_allocator_malloc(host_allocator, total_size, (void**)&driver);
   if (!iree_status_is_ok(status)) {
@@ -121,11 +123,16 @@ static iree_status_t iree_hal_vulkan_driver_create_internal(
   iree_hal_resource_initialize(&iree_hal_vulkan_driver_vtable,
                                &driver->resource);
   driver->host_allocator = host_allocator;
-  iree_string_view_append_to_buffer(
-      identifier, &driver->identifier,
-      (char*)driver + total_size - identifier.size);
+  char* buffer_ptr = (char*)driver + sizeof(*driver);
+  buffer_ptr += iree_string_view_append_to_buffer(
+      identifier, &driver->identifier, buffer_ptr);
   memcpy(&driver->device_options, &options->device_options,
          sizeof(driver->device_options));
+  iree_string_view_append_to_buffer(
+      options->device_options.pipeline_cache_path,
+      &driver->device_options.pipeline_cache_path, buffer_ptr);
+  iree_hal_executable_disk_cache_retain(
+      driver->device_options.executable_disk_cache);
   driver->enabled_features = options->requested_features;
   driver->syms = iree::add_ref(instance_syms);
   driver->instance = instance;
@@ -145,6 +152,8 @@ static void iree_hal_vulkan_driver_destroy(iree_hal_driver_t* base_driver) {
     driver->syms->vkDestroyInstance(driver->instance, /*pAllocator=*/NULL);
   }
   driver->syms.reset();
+  iree_hal_executable_disk_cache_release(
+      driver->device_options.executable_disk_cache);
   iree_allocator_free(host_allocator, driver);
 
   IREE_TRACE_ZONE_END(z0);
@@ -14,6 +14,7 @@
 #include "iree/hal/executable.h"
 #include "iree/hal/pipeline_layout.h"
 #include "iree/hal/resource.h"
+#include "iree/io/file_handle.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -92,6 +93,15 @@ typedef struct iree_hal_executable_params_t {
   // to any executable created using it still held by the caller.
   iree_const_byte_span_t executable_data;
 
+  // Optional file containing |executable_data| at |executable_file_offset|.
+  // Loaders may use this to map the executable contents directly from the
+  // file instead of copying them such that pages are shared across processes
+  // loading the same file. The file contents must not change for the lifetime
+  // of any executable created from it but the handle need only remain valid
+  // for the duration of the preparation call.
+  iree_io_file_handle_t* executable_file;
+  uint64_t executable_file_offset;
+
   // A set of pipeline layouts for each entry point in the executable.
   // The order matches that produced by the compiler. As multiple entry points
   // may share the same layout some entries in this list may reference the same
@@ -188,6 +198,22 @@ IREE_API_EXPORT iree_status_t iree_hal_executable_cache_prepare_executable(
     const iree_hal_executable_params_t* executable_params,
     iree_hal_executable_t** out_executable);
 
+// Prepares |executable_count| executables defined by |executable_params| for
+// use and returns them in the matching |out_executables| slots.
+// Implementations may prepare the executables concurrently using the loop the
+// cache was created with such that independent JITs/translations can overlap.
+// Callers with multiple executables available at once (such as when loading a
+// module) should prefer this over multiple serial calls to
+// iree_hal_executable_cache_prepare_executable.
+//
+// Blocks until all executables have been prepared. If any fails to prepare the
+// first failure is returned and all |out_executables| are NULL.
+IREE_API_EXPORT iree_status_t iree_hal_executable_cache_prepare_executables(
+    iree_hal_executable_cache_t* executable_cache,
+    iree_host_size_t executable_count,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executables);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_executable_cache_t implementation details
 //===----------------------------------------------------------------------===//
@@ -204,6 +230,14 @@ typedef struct iree_hal_executable_cache_vtable_t {
       iree_hal_executable_cache_t* executable_cache,
       const iree_hal_executable_params_t* executable_params,
       iree_hal_executable_t** out_executable);
+
+  // Optional; when omitted executables are prepared serially with
+  // prepare_executable.
+  iree_status_t(IREE_API_PTR* prepare_executables)(
+      iree_hal_executable_cache_t* executable_cache,
+      iree_host_size_t executable_count,
+      const iree_hal_executable_params_t* executable_params,
+      iree_hal_executable_t** out_executables);
 } iree_hal_executable_cache_vtable_t;
 IREE_HAL_ASSERT_VTABLE_LAYOUT(iree_hal_executable_cache_vtable_t);
 
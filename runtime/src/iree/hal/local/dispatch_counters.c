@@ -0,0 +1,466 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_counters.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+
+#if defined(IREE_PLATFORM_LINUX)
+#include <linux/perf_event.h>
+#include <pthread.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX
+
+// Bytes transferred from memory per last-level cache miss. Used to estimate
+// memory bandwidth as hardware counters for it are not portably available.
+#define IREE_HAL_LOCAL_DISPATCH_COUNTERS_CACHE_LINE_SIZE 64
+
+// Hardware counters read per call, in perf event group order.
+enum iree_hal_local_dispatch_counter_e {
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES = 0,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_INSTRUCTIONS,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_LLC_REFERENCES,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_LLC_MISSES,
+  IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT,
+};
+
+struct iree_hal_local_dispatch_counters_slot_t {
+  // Export name stored immediately after the slot.
+  iree_string_view_t name;
+  iree_atomic_int64_t call_count;
+  iree_atomic_int64_t duration_ns;
+  iree_atomic_int64_t sampled_call_count;
+  iree_atomic_int64_t values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+};
+
+// Worker counter state. Only accessed by the thread that owns the worker.
+typedef enum iree_hal_local_dispatch_counters_worker_state_e {
+  // Counters have not yet been opened by the worker.
+  IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_UNOPENED = 0,
+  // Counters are open and measuring |thread|.
+  IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_OPEN,
+  // Counters could not be opened and only times are recorded.
+  IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_UNAVAILABLE,
+} iree_hal_local_dispatch_counters_worker_state_t;
+
+typedef struct iree_hal_local_dispatch_counters_worker_t {
+  iree_hal_local_dispatch_counters_worker_state_t state;
+#if defined(IREE_PLATFORM_LINUX)
+  // Thread the counters measure; perf events opened with pid=0 only count the
+  // thread that opened them.
+  pthread_t thread;
+  // Event file descriptors; the first is the group leader.
+  int fds[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+#endif  // IREE_PLATFORM_LINUX
+  // Pads workers to avoid sharing cache lines between them.
+  uint8_t reserved[64];
+} iree_hal_local_dispatch_counters_worker_t;
+
+struct iree_hal_local_dispatch_counters_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Set if any worker has opened hardware counters.
+  iree_atomic_int32_t any_hardware_available;
+
+  // Guards the slot list. Slots themselves are updated with atomics.
+  iree_slim_mutex_t mutex;
+  iree_host_size_t slot_count;
+  iree_host_size_t slot_capacity;
+  iree_hal_local_dispatch_counters_slot_t** slots;
+
+  iree_host_size_t worker_capacity;
+  iree_hal_local_dispatch_counters_worker_t workers[];
+};
+
+//===----------------------------------------------------------------------===//
+// Platform counters
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_PLATFORM_LINUX)
+
+static int iree_hal_local_dispatch_counters_open_event(uint32_t type,
+                                                       uint64_t config,
+                                                       int group_fd) {
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = type;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  // Members follow the leader; the leader starts enabled.
+  attr.disabled = 0;
+  return (int)syscall(__NR_perf_event_open, &attr, /*pid=*/0, /*cpu=*/-1,
+                      group_fd, /*flags=*/0);
+}
+
+static void iree_hal_local_dispatch_counters_worker_close(
+    iree_hal_local_dispatch_counters_worker_t* worker) {
+  if (worker->state != IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_OPEN) {
+    return;
+  }
+  for (int i = IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT - 1; i >= 0; --i) {
+    if (worker->fds[i] >= 0) close(worker->fds[i]);
+    worker->fds[i] = -1;
+  }
+  worker->state = IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_UNAVAILABLE;
+}
+
+// Opens the counters of |worker| on the calling thread.
+static void iree_hal_local_dispatch_counters_worker_open(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_hal_local_dispatch_counters_worker_t* worker) {
+  static const struct {
+    uint32_t type;
+    uint64_t config;
+  } events[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT] = {
+      [IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES] = {PERF_TYPE_HARDWARE,
+                                                  PERF_COUNT_HW_CPU_CYCLES},
+      [IREE_HAL_LOCAL_DISPATCH_COUNTER_INSTRUCTIONS] =
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+      [IREE_HAL_LOCAL_DISPATCH_COUNTER_LLC_REFERENCES] =
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_REFERENCES},
+      [IREE_HAL_LOCAL_DISPATCH_COUNTER_LLC_MISSES] =
+          {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+  };
+  for (int i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    worker->fds[i] = -1;
+  }
+  worker->state = IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_OPEN;
+  for (int i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    worker->fds[i] = iree_hal_local_dispatch_counters_open_event(
+        events[i].type, events[i].config, i == 0 ? -1 : worker->fds[0]);
+    if (worker->fds[i] < 0) {
+      // All events are required so that group reads have a fixed layout.
+      iree_hal_local_dispatch_counters_worker_close(worker);
+      return;
+    }
+  }
+  worker->thread = pthread_self();
+  iree_atomic_store_int32(&counters->any_hardware_available, 1,
+                          iree_memory_order_relaxed);
+}
+
+// Reads the current counter values of |worker| into |out_values|.
+// Returns false if the counters are not available on the calling thread.
+static bool iree_hal_local_dispatch_counters_worker_read(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_hal_local_dispatch_counters_worker_t* worker, uint64_t* out_values) {
+  if (IREE_UNLIKELY(worker->state ==
+                    IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_UNOPENED)) {
+    iree_hal_local_dispatch_counters_worker_open(counters, worker);
+  }
+  if (worker->state != IREE_HAL_LOCAL_DISPATCH_COUNTERS_WORKER_STATE_OPEN ||
+      !pthread_equal(worker->thread, pthread_self())) {
+    return false;
+  }
+  struct {
+    uint64_t nr;
+    uint64_t values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+  } group;
+  if (read(worker->fds[0], &group, sizeof(group)) != sizeof(group) ||
+      group.nr != IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT) {
+    return false;
+  }
+  memcpy(out_values, group.values, sizeof(group.values));
+  return true;
+}
+
+#else
+
+static void iree_hal_local_dispatch_counters_worker_close(
+    iree_hal_local_dispatch_counters_worker_t* worker) {}
+
+static bool iree_hal_local_dispatch_counters_worker_read(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_hal_local_dispatch_counters_worker_t* worker, uint64_t* out_values) {
+  // Hardware counters are only implemented with Linux perf_event.
+  return false;
+}
+
+#endif  // IREE_PLATFORM_LINUX
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_counters_t
+//===----------------------------------------------------------------------===//
+
+iree_status_t iree_hal_local_dispatch_counters_create(
+    iree_host_size_t worker_capacity, iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_counters_t** out_counters) {
+  IREE_ASSERT_ARGUMENT(out_counters);
+  *out_counters = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)worker_capacity);
+
+  iree_hal_local_dispatch_counters_t* counters = NULL;
+  iree_host_size_t total_size =
+      sizeof(*counters) + worker_capacity * sizeof(counters->workers[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&counters));
+  memset(counters, 0, total_size);
+  iree_atomic_ref_count_init(&counters->ref_count);
+  counters->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&counters->mutex);
+  counters->worker_capacity = worker_capacity;
+
+  *out_counters = counters;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_local_dispatch_counters_destroy(
+    iree_hal_local_dispatch_counters_t* counters) {
+  iree_allocator_t host_allocator = counters->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  for (iree_host_size_t i = 0; i < counters->worker_capacity; ++i) {
+    iree_hal_local_dispatch_counters_worker_close(&counters->workers[i]);
+  }
+  for (iree_host_size_t i = 0; i < counters->slot_count; ++i) {
+    iree_allocator_free(host_allocator, counters->slots[i]);
+  }
+  iree_allocator_free(host_allocator, counters->slots);
+  iree_slim_mutex_deinitialize(&counters->mutex);
+  iree_allocator_free(host_allocator, counters);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_local_dispatch_counters_retain(
+    iree_hal_local_dispatch_counters_t* counters) {
+  if (IREE_LIKELY(counters)) {
+    iree_atomic_ref_count_inc(&counters->ref_count);
+  }
+}
+
+void iree_hal_local_dispatch_counters_release(
+    iree_hal_local_dispatch_counters_t* counters) {
+  if (IREE_LIKELY(counters) &&
+      iree_atomic_ref_count_dec(&counters->ref_count) == 1) {
+    iree_hal_local_dispatch_counters_destroy(counters);
+  }
+}
+
+// Returns the slot for |name|, adding one if needed.
+// Callers must hold the counters mutex.
+static iree_status_t iree_hal_local_dispatch_counters_lookup(
+    iree_hal_local_dispatch_counters_t* counters, iree_string_view_t name,
+    iree_hal_local_dispatch_counters_slot_t** out_slot) {
+  for (iree_host_size_t i = 0; i < counters->slot_count; ++i) {
+    if (iree_string_view_equal(counters->slots[i]->name, name)) {
+      *out_slot = counters->slots[i];
+      return iree_ok_status();
+    }
+  }
+  if (counters->slot_count == counters->slot_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, counters->slot_capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        counters->host_allocator, new_capacity * sizeof(*counters->slots),
+        (void**)&counters->slots));
+    counters->slot_capacity = new_capacity;
+  }
+  iree_hal_local_dispatch_counters_slot_t* slot = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      counters->host_allocator, sizeof(*slot) + name.size, (void**)&slot));
+  memset(slot, 0, sizeof(*slot));
+  char* name_ptr = (char*)slot + sizeof(*slot);
+  memcpy(name_ptr, name.data, name.size);
+  slot->name = iree_make_string_view(name_ptr, name.size);
+  counters->slots[counters->slot_count++] = slot;
+  *out_slot = slot;
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_local_dispatch_counters_resolve(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_host_size_t export_count, const char* const* export_names,
+    iree_hal_local_dispatch_counters_slot_t** out_slots) {
+  IREE_ASSERT_ARGUMENT(counters);
+  IREE_ASSERT_ARGUMENT(!export_count || out_slots);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&counters->mutex);
+  for (iree_host_size_t i = 0; i < export_count && iree_status_is_ok(status);
+       ++i) {
+    iree_string_view_t name =
+        export_names && export_names[i]
+            ? iree_make_cstring_view(export_names[i])
+            : iree_make_cstring_view("unknown_export");
+    status = iree_hal_local_dispatch_counters_lookup(counters, name,
+                                                     &out_slots[i]);
+  }
+  iree_slim_mutex_unlock(&counters->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_hal_local_dispatch_counters_begin(
+    iree_hal_local_dispatch_counters_t* counters, uint32_t worker_id,
+    iree_hal_local_dispatch_counters_sample_t* out_sample) {
+  out_sample->has_values = 0;
+  if (worker_id < counters->worker_capacity) {
+    out_sample->has_values = iree_hal_local_dispatch_counters_worker_read(
+        counters, &counters->workers[worker_id], out_sample->values);
+  }
+  // Read the time last so that the counter read isn't included.
+  out_sample->start_ns = iree_time_now();
+}
+
+void iree_hal_local_dispatch_counters_end(
+    iree_hal_local_dispatch_counters_t* counters, uint32_t worker_id,
+    iree_hal_local_dispatch_counters_slot_t* slot,
+    const iree_hal_local_dispatch_counters_sample_t* sample) {
+  iree_time_t end_ns = iree_time_now();
+  uint64_t values[IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT];
+  bool has_values =
+      sample->has_values && worker_id < counters->worker_capacity &&
+      iree_hal_local_dispatch_counters_worker_read(
+          counters, &counters->workers[worker_id], values);
+  iree_atomic_fetch_add_int64(&slot->call_count, 1, iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int64(&slot->duration_ns,
+                              end_ns > sample->start_ns
+                                  ? (int64_t)(end_ns - sample->start_ns)
+                                  : 0,
+                              iree_memory_order_relaxed);
+  if (!has_values) return;
+  iree_atomic_fetch_add_int64(&slot->sampled_call_count, 1,
+                              iree_memory_order_relaxed);
+  for (int i = 0; i < IREE_HAL_LOCAL_DISPATCH_COUNTER_COUNT; ++i) {
+    iree_atomic_fetch_add_int64(&slot->values[i],
+                                (int64_t)(values[i] - sample->values[i]),
+                                iree_memory_order_relaxed);
+  }
+}
+
+iree_status_t iree_hal_local_dispatch_counters_query(
+    iree_hal_local_dispatch_counters_t* counters, iree_host_size_t capacity,
+    iree_hal_local_dispatch_counters_entry_t* out_entries,
+    iree_host_size_t* out_count) {
+  IREE_ASSERT_ARGUMENT(counters);
+  IREE_ASSERT_ARGUMENT(!capacity || out_entries);
+  IREE_ASSERT_ARGUMENT(out_count);
+  iree_slim_mutex_lock(&counters->mutex);
+  *out_count = counters->slot_count;
+  iree_host_size_t count = iree_min(capacity, counters->slot_count);
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    iree_hal_local_dispatch_counters_slot_t* slot = counters->slots[i];
+    iree_hal_local_dispatch_counters_entry_t* entry = &out_entries[i];
+    entry->name = slot->name;
+    entry->call_count = (uint64_t)iree_atomic_load_int64(
+        &slot->call_count, iree_memory_order_relaxed);
+    entry->duration_ns = (uint64_t)iree_atomic_load_int64(
+        &slot->duration_ns, iree_memory_order_relaxed);
+    entry->sampled_call_count = (uint64_t)iree_atomic_load_int64(
+        &slot->sampled_call_count, iree_memory_order_relaxed);
+    entry->cycles = (uint64_t)iree_atomic_load_int64(
+        &slot->values[IREE_HAL_LOCAL_DISPATCH_COUNTER_CYCLES],
+        iree_memory_order_relaxed);
+    entry->instructions = (uint64_t)iree_atomic_load_int64(
+        &slot->values[IREE_HAL_LOCAL_DISPATCH_COUNTER_INSTRUCTIONS],
+        iree_memory_order_relaxed);
+    entry->llc_references = (uint64_t)iree_atomic_load_int64(
+        &slot->values[IREE_HAL_LOCAL_DISPATCH_COUNTER_LLC_REFERENCES],
+        iree_memory_order_relaxed);
+    entry->llc_misses = (uint64_t)iree_atomic_load_int64(
+        &slot->values[IREE_HAL_LOCAL_DISPATCH_COUNTER_LLC_MISSES],
+        iree_memory_order_relaxed);
+  }
+  iree_slim_mutex_unlock(&counters->mutex);
+  return count < *out_count ? iree_status_from_code(IREE_STATUS_OUT_OF_RANGE)
+                            : iree_ok_status();
+}
+
+iree_status_t iree_hal_local_dispatch_counters_format(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(counters);
+  IREE_ASSERT_ARGUMENT(builder);
+
+  iree_host_size_t count = 0;
+  iree_status_t status =
+      iree_hal_local_dispatch_counters_query(counters, 0, NULL, &count);
+  if (iree_status_is_out_of_range(status)) {
+    iree_status_ignore(status);
+    status = iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(status);
+  iree_hal_local_dispatch_counters_entry_t* entries = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(counters->host_allocator,
+                                             count * sizeof(*entries) + 1,
+                                             (void**)&entries));
+  status =
+      iree_hal_local_dispatch_counters_query(counters, count, entries, &count);
+
+  if (iree_status_is_ok(status) &&
+      !iree_atomic_load_int32(&counters->any_hardware_available,
+                              iree_memory_order_relaxed)) {
+    status = iree_string_builder_append_cstring(
+        builder,
+        "  (hardware counters unavailable; check "
+        "/proc/sys/kernel/perf_event_paranoid)\n");
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_format(
+        builder, "%12s %12s %8s %8s %10s %-s\n", "CALLS", "TIME (ms)", "IPC",
+        "LLC MISS", "EST GB/s", "EXPORT");
+  }
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    const iree_hal_local_dispatch_counters_entry_t* entry = &entries[i];
+    if (!entry->call_count) continue;
+    // Derived values only consider calls that were measured by hardware
+    // counters.
+    double ipc = entry->cycles
+                     ? (double)entry->instructions / (double)entry->cycles
+                     : 0.0;
+    double miss_rate =
+        entry->llc_references
+            ? (double)entry->llc_misses / (double)entry->llc_references
+            : 0.0;
+    double sampled_duration_ns =
+        (double)entry->duration_ns *
+        ((double)entry->sampled_call_count / (double)entry->call_count);
+    double bandwidth_gbps =
+        sampled_duration_ns > 0.0
+            ? (double)entry->llc_misses *
+                  IREE_HAL_LOCAL_DISPATCH_COUNTERS_CACHE_LINE_SIZE /
+                  sampled_duration_ns
+            : 0.0;
+    status = iree_string_builder_append_format(
+        builder, "%12" PRIu64 " %12.3f %8.2f %7.1f%% %10.2f %.*s\n",
+        entry->call_count, entry->duration_ns / 1000000.0, ipc,
+        miss_rate * 100.0, bandwidth_gbps, (int)entry->name.size,
+        entry->name.data);
+  }
+
+  iree_allocator_free(counters->host_allocator, entries);
+  return status;
+}
+
+iree_status_t iree_hal_local_dispatch_counters_fprint(
+    FILE* file, iree_hal_local_dispatch_counters_t* counters) {
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(counters->host_allocator, &builder);
+  iree_status_t status = iree_string_builder_append_cstring(
+      &builder, "[[ iree_hal_local_dispatch_counters_t ]]\n");
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_local_dispatch_counters_format(counters, &builder);
+  }
+  if (iree_status_is_ok(status)) {
+    fprintf(file, "%.*s", (int)iree_string_builder_size(&builder),
+            iree_string_builder_buffer(&builder));
+  }
+  iree_string_builder_deinitialize(&builder);
+  return status;
+}
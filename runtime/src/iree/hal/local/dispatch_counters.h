@@ -0,0 +1,133 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_COUNTERS_H_
+#define IREE_HAL_LOCAL_DISPATCH_COUNTERS_H_
+
+#include <stdio.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_counters_t
+//===----------------------------------------------------------------------===//
+
+// Accumulated counters of all workgroup calls made to one executable export.
+typedef struct iree_hal_local_dispatch_counters_entry_t {
+  // Export name. Valid for the lifetime of the counters.
+  iree_string_view_t name;
+  // Number of calls into the export. Each call may execute multiple
+  // workgroups when the export supports workgroup ranges.
+  uint64_t call_count;
+  // Total wall time spent in calls summed across all workers.
+  uint64_t duration_ns;
+  // Calls that were measured by hardware counters. Calls made on workers where
+  // the counters could not be opened only contribute to the fields above.
+  uint64_t sampled_call_count;
+  // CPU cycles spent in calls.
+  uint64_t cycles;
+  // Instructions retired in calls.
+  uint64_t instructions;
+  // Last-level cache references and misses in calls.
+  uint64_t llc_references;
+  uint64_t llc_misses;
+} iree_hal_local_dispatch_counters_entry_t;
+
+// Aggregates hardware performance counters by executable export.
+//
+// Devices own the counters and share them with the executables they load. Each
+// workgroup call made by a worker is bracketed by reads of per-worker
+// perf_event counters (cycles, instructions, LLC references and misses) and
+// the deltas are added to the export entry. Unlike the dispatch profile this
+// is safe with workgroups of concurrent dispatches interleaved across workers
+// and is intended to tell memory-bound kernels (high LLC miss bandwidth, low
+// IPC) from compute-bound ones in deployed systems.
+//
+// Reading the counters costs a syscall before and after every workgroup call
+// and counters should only be enabled while diagnosing. Hardware counters are
+// only available on Linux and may additionally require lowering
+// /proc/sys/kernel/perf_event_paranoid; when unavailable only call counts and
+// durations are recorded.
+//
+// Thread-safe: each worker ID must only be used by a single thread at a time.
+typedef struct iree_hal_local_dispatch_counters_t
+    iree_hal_local_dispatch_counters_t;
+
+// Opaque per-worker counter values captured at the start of a call.
+typedef struct iree_hal_local_dispatch_counters_sample_t {
+  iree_time_t start_ns;
+  // Nonzero if |values| were read from hardware counters.
+  int32_t has_values;
+  uint64_t values[4];
+} iree_hal_local_dispatch_counters_sample_t;
+
+// Opaque accumulator resolved for an export with
+// iree_hal_local_dispatch_counters_resolve.
+typedef struct iree_hal_local_dispatch_counters_slot_t
+    iree_hal_local_dispatch_counters_slot_t;
+
+// Creates counters that can be recorded by up to |worker_capacity| workers.
+iree_status_t iree_hal_local_dispatch_counters_create(
+    iree_host_size_t worker_capacity, iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_counters_t** out_counters);
+
+// Retains the given |counters| for the caller.
+void iree_hal_local_dispatch_counters_retain(
+    iree_hal_local_dispatch_counters_t* counters);
+
+// Releases the given |counters| from the caller.
+void iree_hal_local_dispatch_counters_release(
+    iree_hal_local_dispatch_counters_t* counters);
+
+// Resolves the accumulators for |export_count| exports named |export_names|
+// and stores them in |out_slots|. Exports with the same name in different
+// executables share an accumulator. Slots remain valid for the lifetime of the
+// counters.
+iree_status_t iree_hal_local_dispatch_counters_resolve(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_host_size_t export_count, const char* const* export_names,
+    iree_hal_local_dispatch_counters_slot_t** out_slots);
+
+// Captures the counters of |worker_id| at the start of a call.
+void iree_hal_local_dispatch_counters_begin(
+    iree_hal_local_dispatch_counters_t* counters, uint32_t worker_id,
+    iree_hal_local_dispatch_counters_sample_t* out_sample);
+
+// Adds the counter deltas of |worker_id| since |sample| was captured to
+// |slot|.
+void iree_hal_local_dispatch_counters_end(
+    iree_hal_local_dispatch_counters_t* counters, uint32_t worker_id,
+    iree_hal_local_dispatch_counters_slot_t* slot,
+    const iree_hal_local_dispatch_counters_sample_t* sample);
+
+// Queries the accumulated counters of all exports.
+// |out_count| is set to the total number of exports and up to |capacity|
+// entries are written to |out_entries|. Returns IREE_STATUS_OUT_OF_RANGE if
+// |capacity| is insufficient.
+iree_status_t iree_hal_local_dispatch_counters_query(
+    iree_hal_local_dispatch_counters_t* counters, iree_host_size_t capacity,
+    iree_hal_local_dispatch_counters_entry_t* out_entries,
+    iree_host_size_t* out_count);
+
+// Formats the counters as a table with derived IPC and estimated memory
+// bandwidth (LLC misses multiplied by the cache line size over call time).
+iree_status_t iree_hal_local_dispatch_counters_format(
+    iree_hal_local_dispatch_counters_t* counters,
+    iree_string_builder_t* builder);
+
+// Prints the counters to |file|.
+iree_status_t iree_hal_local_dispatch_counters_fprint(
+    FILE* file, iree_hal_local_dispatch_counters_t* counters);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_COUNTERS_H_
@@ -0,0 +1,73 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_counters.h"
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class DispatchCountersTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_local_dispatch_counters_create(
+        /*worker_capacity=*/2, iree_allocator_system(), &counters_));
+  }
+
+  void TearDown() override {
+    iree_hal_local_dispatch_counters_release(counters_);
+  }
+
+  iree_hal_local_dispatch_counters_t* counters_ = NULL;
+};
+
+TEST_F(DispatchCountersTest, SharesSlotsByName) {
+  const char* const names_a[] = {"dispatch_0", "dispatch_1"};
+  const char* const names_b[] = {"dispatch_1"};
+  iree_hal_local_dispatch_counters_slot_t* slots_a[2] = {NULL, NULL};
+  iree_hal_local_dispatch_counters_slot_t* slots_b[1] = {NULL};
+  IREE_ASSERT_OK(iree_hal_local_dispatch_counters_resolve(
+      counters_, IREE_ARRAYSIZE(names_a), names_a, slots_a));
+  IREE_ASSERT_OK(iree_hal_local_dispatch_counters_resolve(
+      counters_, IREE_ARRAYSIZE(names_b), names_b, slots_b));
+  EXPECT_NE(slots_a[0], slots_a[1]);
+  EXPECT_EQ(slots_a[1], slots_b[0]);
+
+  iree_host_size_t count = 0;
+  iree_status_t status =
+      iree_hal_local_dispatch_counters_query(counters_, 0, NULL, &count);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_OUT_OF_RANGE, status);
+  iree_status_free(status);
+  EXPECT_EQ(count, 2);
+}
+
+TEST_F(DispatchCountersTest, AccumulatesCalls) {
+  const char* const names[] = {"dispatch_0"};
+  iree_hal_local_dispatch_counters_slot_t* slot = NULL;
+  IREE_ASSERT_OK(
+      iree_hal_local_dispatch_counters_resolve(counters_, 1, names, &slot));
+
+  for (uint32_t worker_id = 0; worker_id < 3; ++worker_id) {
+    // Worker 2 is out of range and must only record the call.
+    iree_hal_local_dispatch_counters_sample_t sample;
+    iree_hal_local_dispatch_counters_begin(counters_, worker_id, &sample);
+    iree_hal_local_dispatch_counters_end(counters_, worker_id, slot, &sample);
+  }
+
+  iree_hal_local_dispatch_counters_entry_t entry;
+  iree_host_size_t count = 0;
+  IREE_ASSERT_OK(
+      iree_hal_local_dispatch_counters_query(counters_, 1, &entry, &count));
+  ASSERT_EQ(count, 1);
+  EXPECT_TRUE(iree_string_view_equal(entry.name,
+                                     iree_make_cstring_view("dispatch_0")));
+  EXPECT_EQ(entry.call_count, 3);
+  // Hardware counters may be unavailable in the test environment.
+  EXPECT_LE(entry.sampled_call_count, 2);
+}
+
+}  // namespace
@@ -0,0 +1,250 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_profile.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/synchronization.h"
+
+typedef struct iree_hal_local_dispatch_profile_entry_t {
+  // Export name; allocated with the profile host allocator.
+  iree_string_view_t name;
+  uint64_t count;
+  uint64_t total_duration_ns;
+  uint64_t total_bindings_length;
+} iree_hal_local_dispatch_profile_entry_t;
+
+struct iree_hal_local_dispatch_profile_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Nonzero while capturing. Checked without the mutex on each dispatch so
+  // that profiling has no cost when disabled.
+  iree_atomic_int32_t capturing;
+
+  // Guards all fields below.
+  iree_slim_mutex_t mutex;
+
+  // Path the profile is written to when the capture ends, if any.
+  char* file_path;
+
+  iree_host_size_t entry_count;
+  iree_host_size_t entry_capacity;
+  iree_hal_local_dispatch_profile_entry_t* entries;
+};
+
+iree_status_t iree_hal_local_dispatch_profile_create(
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_profile_t** out_profile) {
+  IREE_ASSERT_ARGUMENT(out_profile);
+  *out_profile = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_dispatch_profile_t* profile = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*profile),
+                                (void**)&profile));
+  memset(profile, 0, sizeof(*profile));
+  iree_atomic_ref_count_init(&profile->ref_count);
+  profile->host_allocator = host_allocator;
+  iree_atomic_store_int32(&profile->capturing, 0, iree_memory_order_relaxed);
+  iree_slim_mutex_initialize(&profile->mutex);
+
+  *out_profile = profile;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+// Drops all recorded entries. Callers must hold the profile mutex.
+static void iree_hal_local_dispatch_profile_reset(
+    iree_hal_local_dispatch_profile_t* profile) {
+  for (iree_host_size_t i = 0; i < profile->entry_count; ++i) {
+    iree_allocator_free(profile->host_allocator,
+                        (void*)profile->entries[i].name.data);
+  }
+  profile->entry_count = 0;
+  iree_allocator_free(profile->host_allocator, profile->file_path);
+  profile->file_path = NULL;
+}
+
+static void iree_hal_local_dispatch_profile_destroy(
+    iree_hal_local_dispatch_profile_t* profile) {
+  iree_allocator_t host_allocator = profile->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_local_dispatch_profile_reset(profile);
+  iree_allocator_free(host_allocator, profile->entries);
+  iree_slim_mutex_deinitialize(&profile->mutex);
+  iree_allocator_free(host_allocator, profile);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+void iree_hal_local_dispatch_profile_retain(
+    iree_hal_local_dispatch_profile_t* profile) {
+  if (IREE_LIKELY(profile)) {
+    iree_atomic_ref_count_inc(&profile->ref_count);
+  }
+}
+
+void iree_hal_local_dispatch_profile_release(
+    iree_hal_local_dispatch_profile_t* profile) {
+  if (IREE_LIKELY(profile) &&
+      iree_atomic_ref_count_dec(&profile->ref_count) == 1) {
+    iree_hal_local_dispatch_profile_destroy(profile);
+  }
+}
+
+bool iree_hal_local_dispatch_profile_is_capturing(
+    iree_hal_local_dispatch_profile_t* profile) {
+  return profile && iree_atomic_load_int32(&profile->capturing,
+                                           iree_memory_order_relaxed) != 0;
+}
+
+iree_status_t iree_hal_local_dispatch_profile_begin(
+    iree_hal_local_dispatch_profile_t* profile, iree_string_view_t file_path) {
+  IREE_ASSERT_ARGUMENT(profile);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Copy the path with a NUL terminator as it's passed to the file APIs.
+  char* file_path_copy = NULL;
+  if (!iree_string_view_is_empty(file_path)) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(profile->host_allocator, file_path.size + 1,
+                                  (void**)&file_path_copy));
+    memcpy(file_path_copy, file_path.data, file_path.size);
+    file_path_copy[file_path.size] = 0;
+  }
+
+  iree_slim_mutex_lock(&profile->mutex);
+  iree_hal_local_dispatch_profile_reset(profile);
+  profile->file_path = file_path_copy;
+  iree_atomic_store_int32(&profile->capturing, 1, iree_memory_order_relaxed);
+  iree_slim_mutex_unlock(&profile->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_local_dispatch_profile_end(
+    iree_hal_local_dispatch_profile_t* profile) {
+  IREE_ASSERT_ARGUMENT(profile);
+  if (!iree_hal_local_dispatch_profile_is_capturing(profile)) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&profile->mutex);
+  iree_atomic_store_int32(&profile->capturing, 0, iree_memory_order_relaxed);
+  char* file_path = profile->file_path;
+  profile->file_path = NULL;
+  iree_slim_mutex_unlock(&profile->mutex);
+
+  iree_status_t status = iree_ok_status();
+  if (file_path) {
+    iree_string_builder_t builder;
+    iree_string_builder_initialize(profile->host_allocator, &builder);
+    status = iree_hal_local_dispatch_profile_format(profile, &builder);
+    if (iree_status_is_ok(status)) {
+      status = iree_file_write_contents(
+          file_path,
+          iree_make_const_byte_span(iree_string_builder_buffer(&builder),
+                                    iree_string_builder_size(&builder)));
+    }
+    iree_string_builder_deinitialize(&builder);
+    iree_allocator_free(profile->host_allocator, file_path);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns the entry for |name|, adding one if needed, or NULL if out of
+// memory. Callers must hold the profile mutex.
+static iree_hal_local_dispatch_profile_entry_t*
+iree_hal_local_dispatch_profile_lookup(
+    iree_hal_local_dispatch_profile_t* profile, iree_string_view_t name) {
+  for (iree_host_size_t i = 0; i < profile->entry_count; ++i) {
+    if (iree_string_view_equal(profile->entries[i].name, name)) {
+      return &profile->entries[i];
+    }
+  }
+  if (profile->entry_count == profile->entry_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, profile->entry_capacity * 2);
+    iree_status_t status = iree_allocator_realloc(
+        profile->host_allocator, new_capacity * sizeof(*profile->entries),
+        (void**)&profile->entries);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      return NULL;
+    }
+    profile->entry_capacity = new_capacity;
+  }
+  char* name_copy = NULL;
+  iree_status_t status =
+      iree_allocator_malloc(profile->host_allocator, name.size,
+                            (void**)&name_copy);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return NULL;
+  }
+  memcpy(name_copy, name.data, name.size);
+  iree_hal_local_dispatch_profile_entry_t* entry =
+      &profile->entries[profile->entry_count++];
+  memset(entry, 0, sizeof(*entry));
+  entry->name = iree_make_string_view(name_copy, name.size);
+  return entry;
+}
+
+void iree_hal_local_dispatch_profile_record(
+    iree_hal_local_dispatch_profile_t* profile, iree_string_view_t name,
+    iree_duration_t duration_ns, iree_device_size_t bindings_length) {
+  if (!iree_hal_local_dispatch_profile_is_capturing(profile) ||
+      iree_string_view_is_empty(name)) {
+    return;
+  }
+  iree_slim_mutex_lock(&profile->mutex);
+  // Profiling is best-effort: if we can't allocate an entry we drop the
+  // dispatch instead of failing execution.
+  iree_hal_local_dispatch_profile_entry_t* entry =
+      iree_hal_local_dispatch_profile_lookup(profile, name);
+  if (entry) {
+    ++entry->count;
+    entry->total_duration_ns += duration_ns > 0 ? (uint64_t)duration_ns : 0;
+    entry->total_bindings_length += bindings_length;
+  }
+  iree_slim_mutex_unlock(&profile->mutex);
+}
+
+iree_status_t iree_hal_local_dispatch_profile_format(
+    iree_hal_local_dispatch_profile_t* profile,
+    iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(profile);
+  IREE_ASSERT_ARGUMENT(builder);
+  iree_slim_mutex_lock(&profile->mutex);
+  iree_status_t status = iree_string_builder_append_cstring(
+      builder, "{\n  \"version\": 1,\n  \"exports\": {");
+  for (iree_host_size_t i = 0;
+       i < profile->entry_count && iree_status_is_ok(status); ++i) {
+    const iree_hal_local_dispatch_profile_entry_t* entry = &profile->entries[i];
+    // Export names are C identifiers and need no escaping.
+    status = iree_string_builder_append_format(
+        builder,
+        "%s\n    \"%.*s\": {\"count\": %" PRIu64 ", \"duration_ns\": %" PRIu64
+        ", \"bytes\": %" PRIu64 "}",
+        i > 0 ? "," : "", (int)entry->name.size, entry->name.data,
+        entry->count, entry->total_duration_ns / entry->count,
+        entry->total_bindings_length / entry->count);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_string_builder_append_cstring(builder, "\n  }\n}\n");
+  }
+  iree_slim_mutex_unlock(&profile->mutex);
+  return status;
+}
@@ -0,0 +1,81 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_DISPATCH_PROFILE_H_
+#define IREE_HAL_LOCAL_DISPATCH_PROFILE_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_local_dispatch_profile_t
+//===----------------------------------------------------------------------===//
+
+// Accumulates the measured cost of dispatches by executable export name.
+//
+// Devices own a profile and share it with the executables they load. While a
+// capture is active each dispatch records its duration and the number of bytes
+// of bindings it had access to. Ending the capture writes a JSON file that the
+// compiler accepts with `--iree-stream-cost-profile=`:
+//   {
+//     "version": 1,
+//     "exports": {
+//       "main_dispatch_0": {"count": 4, "duration_ns": 1200, "bytes": 4096},
+//       ...
+//     }
+//   }
+// Durations and bytes are the average of all dispatches of the export.
+//
+// Thread-safe: dispatches from any thread may record into the profile.
+typedef struct iree_hal_local_dispatch_profile_t
+    iree_hal_local_dispatch_profile_t;
+
+// Creates an empty profile that is not capturing.
+iree_status_t iree_hal_local_dispatch_profile_create(
+    iree_allocator_t host_allocator,
+    iree_hal_local_dispatch_profile_t** out_profile);
+
+// Retains the given |profile| for the caller.
+void iree_hal_local_dispatch_profile_retain(
+    iree_hal_local_dispatch_profile_t* profile);
+
+// Releases the given |profile| from the caller.
+void iree_hal_local_dispatch_profile_release(
+    iree_hal_local_dispatch_profile_t* profile);
+
+// Returns true if |profile| is non-NULL and capturing dispatches.
+bool iree_hal_local_dispatch_profile_is_capturing(
+    iree_hal_local_dispatch_profile_t* profile);
+
+// Discards any previously recorded dispatches and begins capturing.
+// The profile is written to |file_path| when the capture ends.
+iree_status_t iree_hal_local_dispatch_profile_begin(
+    iree_hal_local_dispatch_profile_t* profile, iree_string_view_t file_path);
+
+// Ends the capture and writes the recorded dispatches to the file path given
+// when it began. No-op if the profile is not capturing.
+iree_status_t iree_hal_local_dispatch_profile_end(
+    iree_hal_local_dispatch_profile_t* profile);
+
+// Records a dispatch of the export |name| that took |duration_ns| and had
+// access to |bindings_length| bytes. Ignored if the profile is not capturing.
+void iree_hal_local_dispatch_profile_record(
+    iree_hal_local_dispatch_profile_t* profile, iree_string_view_t name,
+    iree_duration_t duration_ns, iree_device_size_t bindings_length);
+
+// Appends the recorded dispatches to |builder| as JSON.
+iree_status_t iree_hal_local_dispatch_profile_format(
+    iree_hal_local_dispatch_profile_t* profile,
+    iree_string_builder_t* builder);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_DISPATCH_PROFILE_H_
@@ -0,0 +1,80 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/dispatch_profile.h"
+
+#include <string>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+class DispatchProfileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_local_dispatch_profile_create(
+        iree_allocator_system(), &profile_));
+  }
+
+  void TearDown() override {
+    iree_hal_local_dispatch_profile_release(profile_);
+  }
+
+  std::string Format() {
+    iree_string_builder_t builder;
+    iree_string_builder_initialize(iree_allocator_system(), &builder);
+    IREE_CHECK_OK(iree_hal_local_dispatch_profile_format(profile_, &builder));
+    std::string result(iree_string_builder_buffer(&builder),
+                       iree_string_builder_size(&builder));
+    iree_string_builder_deinitialize(&builder);
+    return result;
+  }
+
+  iree_hal_local_dispatch_profile_t* profile_ = NULL;
+};
+
+TEST_F(DispatchProfileTest, IgnoredUnlessCapturing) {
+  EXPECT_FALSE(iree_hal_local_dispatch_profile_is_capturing(profile_));
+  iree_hal_local_dispatch_profile_record(
+      profile_, iree_make_cstring_view("dispatch_0"), 100, 64);
+  EXPECT_EQ(Format(), "{\n  \"version\": 1,\n  \"exports\": {\n  }\n}\n");
+}
+
+TEST_F(DispatchProfileTest, AveragesByExport) {
+  IREE_ASSERT_OK(iree_hal_local_dispatch_profile_begin(
+      profile_, iree_string_view_empty()));
+  EXPECT_TRUE(iree_hal_local_dispatch_profile_is_capturing(profile_));
+  iree_hal_local_dispatch_profile_record(
+      profile_, iree_make_cstring_view("dispatch_0"), 100, 64);
+  iree_hal_local_dispatch_profile_record(
+      profile_, iree_make_cstring_view("dispatch_1"), 10, 8);
+  iree_hal_local_dispatch_profile_record(
+      profile_, iree_make_cstring_view("dispatch_0"), 300, 64);
+  EXPECT_EQ(Format(),
+            "{\n  \"version\": 1,\n  \"exports\": {\n"
+            "    \"dispatch_0\": {\"count\": 2, \"duration_ns\": 200, "
+            "\"bytes\": 64},\n"
+            "    \"dispatch_1\": {\"count\": 1, \"duration_ns\": 10, "
+            "\"bytes\": 8}\n"
+            "  }\n}\n");
+  IREE_ASSERT_OK(iree_hal_local_dispatch_profile_end(profile_));
+  EXPECT_FALSE(iree_hal_local_dispatch_profile_is_capturing(profile_));
+}
+
+TEST_F(DispatchProfileTest, BeginDiscardsPreviousCapture) {
+  IREE_ASSERT_OK(iree_hal_local_dispatch_profile_begin(
+      profile_, iree_string_view_empty()));
+  iree_hal_local_dispatch_profile_record(
+      profile_, iree_make_cstring_view("dispatch_0"), 100, 64);
+  IREE_ASSERT_OK(iree_hal_local_dispatch_profile_end(profile_));
+  IREE_ASSERT_OK(iree_hal_local_dispatch_profile_begin(
+      profile_, iree_string_view_empty()));
+  EXPECT_EQ(Format(), "{\n  \"version\": 1,\n  \"exports\": {\n  }\n}\n");
+  IREE_ASSERT_OK(iree_hal_local_dispatch_profile_end(profile_));
+}
+
+}  // namespace
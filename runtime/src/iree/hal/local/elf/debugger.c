@@ -0,0 +1,196 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/elf/debugger.h"
+
+#include <string.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/local/elf/elf_types.h"
+
+//==============================================================================
+// GDB JIT interface
+//==============================================================================
+// Debuggers place a breakpoint on __jit_debug_register_code and read
+// __jit_debug_descriptor to find in-memory object files when it is hit. The
+// names and layouts of these are fixed by the debuggers:
+// https://sourceware.org/gdb/current/onlinedocs/gdb.html/JIT-Interface.html
+//
+// Other JITs in the process (such as LLVM's ORC) may define the same symbols.
+// Ours are weak so that a single definition is used by everyone; the actions
+// performed by each JIT are serialized by their own locks and the debugger
+// only ever observes the descriptor while the process is stopped.
+
+typedef enum {
+  IREE_JIT_NOACTION = 0,
+  IREE_JIT_REGISTER_FN = 1,
+  IREE_JIT_UNREGISTER_FN = 2,
+} iree_jit_actions_t;
+
+struct jit_code_entry {
+  struct jit_code_entry* next_entry;
+  struct jit_code_entry* prev_entry;
+  const char* symfile_addr;
+  uint64_t symfile_size;
+};
+
+struct jit_descriptor {
+  uint32_t version;
+  // One of iree_jit_actions_t.
+  uint32_t action_flag;
+  struct jit_code_entry* relevant_entry;
+  struct jit_code_entry* first_entry;
+};
+
+IREE_ATTRIBUTE_WEAK IREE_ATTRIBUTE_NOINLINE void __jit_debug_register_code(
+    void);
+IREE_ATTRIBUTE_WEAK IREE_ATTRIBUTE_NOINLINE void __jit_debug_register_code(
+    void) {
+  // The noinline and the asm prevent calls to this from being optimized out;
+  // debuggers break on entry.
+#if !defined(IREE_COMPILER_MSVC)
+  __asm__ volatile("" ::: "memory");
+#endif  // !IREE_COMPILER_MSVC
+}
+
+IREE_ATTRIBUTE_WEAK struct jit_descriptor __jit_debug_descriptor = {
+    1, IREE_JIT_NOACTION, NULL, NULL};
+
+static iree_slim_mutex_t iree_elf_debugger_mutex;
+static iree_once_flag iree_elf_debugger_mutex_flag = IREE_ONCE_FLAG_INIT;
+static void iree_elf_debugger_mutex_initialize(void) {
+  iree_slim_mutex_initialize(&iree_elf_debugger_mutex);
+}
+
+struct iree_elf_debugger_entry_t {
+  iree_allocator_t host_allocator;
+  struct jit_code_entry code_entry;
+  // Rebased copy of the ELF image referenced by code_entry.
+  uint8_t image[];
+};
+
+//==============================================================================
+// Image rebasing
+//==============================================================================
+
+// Rebases all allocated sections and loadable segments in |image| by |bias| so
+// that the debugger sees the addresses the module was actually loaded at.
+// Symbol values are relative to their sections and follow along.
+static iree_status_t iree_elf_debugger_rebase_image(uint8_t* image,
+                                                    iree_host_size_t image_size,
+                                                    iree_elf_addr_t bias) {
+  if (image_size < sizeof(iree_elf_ehdr_t)) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "ELF image too small for a header");
+  }
+  iree_elf_ehdr_t* ehdr = (iree_elf_ehdr_t*)image;
+
+  iree_host_size_t phdrs_size =
+      (iree_host_size_t)ehdr->e_phnum * sizeof(iree_elf_phdr_t);
+  if (ehdr->e_phoff + phdrs_size > image_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "ELF program headers out of bounds");
+  }
+  iree_elf_phdr_t* phdrs = (iree_elf_phdr_t*)(image + ehdr->e_phoff);
+  for (iree_elf_half_t i = 0; i < ehdr->e_phnum; ++i) {
+    phdrs[i].p_vaddr += bias;
+    phdrs[i].p_paddr += bias;
+  }
+
+  // Stripped modules may have no section headers; debuggers will still get
+  // the segments but without symbols there's not much they can do.
+  if (!ehdr->e_shoff || !ehdr->e_shnum) return iree_ok_status();
+  iree_host_size_t shdrs_size =
+      (iree_host_size_t)ehdr->e_shnum * sizeof(iree_elf_shdr_t);
+  if (ehdr->e_shoff + shdrs_size > image_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "ELF section headers out of bounds");
+  }
+  iree_elf_shdr_t* shdrs = (iree_elf_shdr_t*)(image + ehdr->e_shoff);
+  for (iree_elf_half_t i = 0; i < ehdr->e_shnum; ++i) {
+    if (shdrs[i].sh_flags & IREE_ELF_SHF_ALLOC) {
+      shdrs[i].sh_addr += bias;
+    }
+  }
+
+  return iree_ok_status();
+}
+
+//==============================================================================
+// API
+//==============================================================================
+
+iree_status_t iree_elf_debugger_register(
+    iree_const_byte_span_t raw_data, const uint8_t* vaddr_bias,
+    iree_allocator_t host_allocator, iree_elf_debugger_entry_t** out_entry) {
+  IREE_ASSERT_ARGUMENT(raw_data.data);
+  IREE_ASSERT_ARGUMENT(out_entry);
+  *out_entry = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)raw_data.data_length);
+
+  iree_elf_debugger_entry_t* entry = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                sizeof(*entry) + raw_data.data_length,
+                                (void**)&entry));
+  memset(entry, 0, sizeof(*entry));
+  entry->host_allocator = host_allocator;
+  memcpy(entry->image, raw_data.data, raw_data.data_length);
+  iree_status_t status = iree_elf_debugger_rebase_image(
+      entry->image, raw_data.data_length, (iree_elf_addr_t)vaddr_bias);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, entry);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+  entry->code_entry.symfile_addr = (const char*)entry->image;
+  entry->code_entry.symfile_size = raw_data.data_length;
+
+  iree_call_once(&iree_elf_debugger_mutex_flag,
+                 iree_elf_debugger_mutex_initialize);
+  iree_slim_mutex_lock(&iree_elf_debugger_mutex);
+  entry->code_entry.next_entry = __jit_debug_descriptor.first_entry;
+  if (entry->code_entry.next_entry) {
+    entry->code_entry.next_entry->prev_entry = &entry->code_entry;
+  }
+  __jit_debug_descriptor.first_entry = &entry->code_entry;
+  __jit_debug_descriptor.relevant_entry = &entry->code_entry;
+  __jit_debug_descriptor.action_flag = IREE_JIT_REGISTER_FN;
+  __jit_debug_register_code();
+  __jit_debug_descriptor.action_flag = IREE_JIT_NOACTION;
+  iree_slim_mutex_unlock(&iree_elf_debugger_mutex);
+
+  *out_entry = entry;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+void iree_elf_debugger_unregister(iree_elf_debugger_entry_t* entry) {
+  if (!entry) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&iree_elf_debugger_mutex);
+  struct jit_code_entry* code_entry = &entry->code_entry;
+  if (code_entry->prev_entry) {
+    code_entry->prev_entry->next_entry = code_entry->next_entry;
+  } else {
+    __jit_debug_descriptor.first_entry = code_entry->next_entry;
+  }
+  if (code_entry->next_entry) {
+    code_entry->next_entry->prev_entry = code_entry->prev_entry;
+  }
+  __jit_debug_descriptor.relevant_entry = code_entry;
+  __jit_debug_descriptor.action_flag = IREE_JIT_UNREGISTER_FN;
+  __jit_debug_register_code();
+  __jit_debug_descriptor.action_flag = IREE_JIT_NOACTION;
+  __jit_debug_descriptor.relevant_entry = NULL;
+  iree_slim_mutex_unlock(&iree_elf_debugger_mutex);
+
+  iree_allocator_free(entry->host_allocator, entry);
+  IREE_TRACE_ZONE_END(z0);
+}
@@ -0,0 +1,49 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_ELF_DEBUGGER_H_
+#define IREE_HAL_LOCAL_ELF_DEBUGGER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//==============================================================================
+// GDB JIT interface registration
+//==============================================================================
+
+// A loaded ELF image registered with attached debuggers.
+typedef struct iree_elf_debugger_entry_t iree_elf_debugger_entry_t;
+
+// Registers the ELF in |raw_data| loaded at |vaddr_bias| with any debugger
+// that implements the GDB JIT interface (gdb and lldb). Without this the
+// module is anonymous memory to the debugger and has no symbols, source
+// locations, or unwind info.
+//
+// A copy of |raw_data| is made with its section and segment addresses
+// rebased to where the module was loaded. This can be costly for large
+// modules with debug info, so registration should only be enabled when a
+// debugger may be attached.
+//
+// The returned entry must be unregistered with iree_elf_debugger_unregister
+// before the module is unloaded.
+iree_status_t iree_elf_debugger_register(
+    iree_const_byte_span_t raw_data, const uint8_t* vaddr_bias,
+    iree_allocator_t host_allocator, iree_elf_debugger_entry_t** out_entry);
+
+// Unregisters an |entry| previously registered with
+// iree_elf_debugger_register. No-op if |entry| is NULL.
+void iree_elf_debugger_unregister(iree_elf_debugger_entry_t* entry);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_ELF_DEBUGGER_H_
@@ -229,29 +229,112 @@ static iree_byte_range_t iree_elf_module_calculate_vaddr_range(
   return byte_range;
 }
 
+// Attempts to map the file contents of the segment |phdr| directly from |file|
+// with copy-on-write pages. Any bss tail is zeroed and memory beyond the last
+// file page is committed. Returns false if the segment could not be mapped and
+// must be committed and copied instead.
+static bool iree_elf_module_map_segment(iree_elf_module_file_t file,
+                                        const iree_elf_phdr_t* phdr,
+                                        iree_host_size_t page_size,
+                                        iree_elf_module_t* module) {
+  if (phdr->p_filesz == 0) return false;
+
+  // The segment must start at the same offset within a page in memory as its
+  // contents do in the file.
+  uint8_t* segment_ptr = module->vaddr_bias + phdr->p_vaddr;
+  const uint64_t file_offset = file.offset + phdr->p_offset;
+  const iree_host_size_t page_offset = (uintptr_t)segment_ptr % page_size;
+  if (page_offset != file_offset % page_size) return false;
+
+  // Map all pages containing file data. The pages are initially writable so
+  // that relocations can be applied; only the pages written to are copied.
+  uint8_t* map_ptr = segment_ptr - page_offset;
+  uint8_t* map_end = (uint8_t*)iree_host_align(
+      (uintptr_t)(segment_ptr + phdr->p_filesz), page_size);
+  iree_status_t status = iree_memory_view_map_file_range(
+      module->vaddr_base, (iree_host_size_t)(map_ptr - module->vaddr_base),
+      (iree_host_size_t)(map_end - map_ptr), file.fd, file_offset - page_offset,
+      IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(status);
+    return false;
+  }
+
+  // Zero the bss portion of the last file page and commit the remaining
+  // zero-initialized pages (if any).
+  if (phdr->p_memsz > phdr->p_filesz) {
+    uint8_t* file_end = segment_ptr + phdr->p_filesz;
+    uint8_t* memory_end = segment_ptr + phdr->p_memsz;
+    memset(file_end, 0, iree_min(map_end, memory_end) - file_end);
+    if (memory_end > map_end) {
+      iree_byte_range_t byte_range = {
+          .offset = (iree_host_size_t)(map_end - module->vaddr_bias),
+          .length = (iree_host_size_t)(memory_end - map_end),
+      };
+      status = iree_memory_view_commit_ranges(
+          module->vaddr_bias, 1, &byte_range,
+          IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE);
+      if (!iree_status_is_ok(status)) {
+        // The mapped pages are replaced when the segment is committed.
+        iree_status_ignore(status);
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
+
 // Allocates space for and loads all DT_LOAD segments into the host virtual
-// address space.
+// address space. If |file|.fd is valid then segments are mapped from the file
+// when possible and otherwise copied from |raw_data|.
 static iree_status_t iree_elf_module_load_segments(
-    iree_const_byte_span_t raw_data, iree_elf_module_load_state_t* load_state,
+    iree_const_byte_span_t raw_data, iree_elf_module_file_t file,
+    iree_elf_module_flags_t flags, iree_elf_module_load_state_t* load_state,
     iree_elf_module_t* module) {
   // Calculate the total internally-aligned vaddr range.
   iree_byte_range_t vaddr_range =
       iree_elf_module_calculate_vaddr_range(load_state);
 
+  // Large pages are only worth it if the module spans at least one; otherwise
+  // we'd be wasting the remainder of the page.
+  iree_memory_view_flags_t view_flags = IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE;
+  const iree_host_size_t large_page_size =
+      load_state->memory_info.large_page_granularity;
+  const bool use_large_pages =
+      (flags & IREE_ELF_MODULE_FLAG_LARGE_PAGES) &&
+      large_page_size > load_state->memory_info.normal_page_size &&
+      vaddr_range.length >= large_page_size;
+  if (use_large_pages) view_flags |= IREE_MEMORY_VIEW_FLAG_LARGE_PAGES;
+
   // Reserve virtual address space in the host memory space. This memory is
   // uncommitted by default as the ELF may only sparsely use the address space.
   module->vaddr_size = iree_page_align_end(
-      vaddr_range.length, load_state->memory_info.normal_page_size);
+      vaddr_range.length, use_large_pages
+                              ? large_page_size
+                              : load_state->memory_info.normal_page_size);
   IREE_RETURN_IF_ERROR(iree_memory_view_reserve(
-      IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE, module->vaddr_size,
-      module->host_allocator, (void**)&module->vaddr_base));
+      view_flags, module->vaddr_size, module->host_allocator,
+      (void**)&module->vaddr_base));
   module->vaddr_bias = module->vaddr_base - vaddr_range.offset;
 
+  // Large pages must be anonymous memory so file mapping is only used when
+  // they were not requested.
+  const bool use_file = file.fd >= 0 && !use_large_pages;
+
   // Commit and load all of the segments.
   for (iree_elf_half_t i = 0; i < load_state->ehdr->e_phnum; ++i) {
     const iree_elf_phdr_t* phdr = &load_state->phdr_table[i];
     if (phdr->p_type != IREE_ELF_PT_LOAD) continue;
 
+    // Map the segment from the file if possible. Read-only and executable
+    // pages not touched by relocations remain shared with the page cache.
+    if (use_file &&
+        iree_elf_module_map_segment(
+            file, phdr, load_state->memory_info.normal_page_size, module)) {
+      continue;
+    }
+
     // Commit the range of pages used by this segment, initially with write
     // access so that we can modify the pages.
     iree_byte_range_t byte_range = {
@@ -263,13 +346,6 @@ static iree_status_t iree_elf_module_load_segments(
         IREE_MEMORY_ACCESS_READ | IREE_MEMORY_ACCESS_WRITE));
 
     // Copy data present in the file.
-    // TODO(benvanik): infra for being able to detect if the source model is in
-    // a mapped file - if it is, we can remap the page and directly reference it
-    // here for read-only segments and setup copy-on-write for writeable ones.
-    // We'd need a way to pass in the underlying mapping and some guarantees on
-    // the lifetime of it. Today we are just always committing above and copying
-    // here because it keeps this all super simple (you know, as simple as an
-    // entire custom ELF loader can be :).
     if (phdr->p_filesz > 0) {
       memcpy(module->vaddr_bias + phdr->p_vaddr, raw_data.data + phdr->p_offset,
              phdr->p_filesz);
@@ -284,6 +360,12 @@ static iree_status_t iree_elf_module_load_segments(
     // pages in iree_elf_module_protect_segments.
   }
 
+  // Request large pages for the committed segments. Only segments spanning
+  // entire large pages will be able to use them.
+  if (use_large_pages) {
+    iree_memory_view_advise_large_pages(module->vaddr_base, module->vaddr_size);
+  }
+
   return iree_ok_status();
 }
 
@@ -571,9 +653,21 @@ static const iree_elf_sym_t* iree_elf_module_lookup_global_symbol(
 //==============================================================================
 
 iree_status_t iree_elf_module_initialize_from_memory(
-    iree_const_byte_span_t raw_data,
+    iree_const_byte_span_t raw_data, iree_elf_module_flags_t flags,
     const iree_elf_import_table_t* import_table,
     iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
+  iree_elf_module_file_t file = {
+      .fd = -1,
+      .offset = 0,
+  };
+  return iree_elf_module_initialize_from_file(
+      raw_data, file, flags, import_table, host_allocator, out_module);
+}
+
+iree_status_t iree_elf_module_initialize_from_file(
+    iree_const_byte_span_t raw_data, iree_elf_module_file_t file,
+    iree_elf_module_flags_t flags, const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module) {
   IREE_ASSERT_ARGUMENT(raw_data.data);
   IREE_ASSERT_ARGUMENT(out_module);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -581,8 +675,10 @@ iree_status_t iree_elf_module_initialize_from_memory(
   // If the file is a FatELF then select the ELF for this architecture.
   // Ignored of not a FatELF and otherwise errors if no compatible architecture
   // is available.
+  iree_const_byte_span_t fat_data = raw_data;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(z0,
-                                    iree_fatelf_select(raw_data, &raw_data));
+                                    iree_fatelf_select(fat_data, &raw_data));
+  file.offset += (uint64_t)(raw_data.data - fat_data.data);
 
   // Parse the ELF headers and verify that it's something we can handle.
   // Temporary state required during loading such as references to subtables
@@ -596,7 +692,8 @@ iree_status_t iree_elf_module_initialize_from_memory(
   // Allocate and load the ELF into memory.
   iree_memory_jit_context_begin();
   if (iree_status_is_ok(status)) {
-    status = iree_elf_module_load_segments(raw_data, &load_state, out_module);
+    status = iree_elf_module_load_segments(raw_data, file, flags, &load_state,
+                                           out_module);
   }
 
   // Parse required dynamic symbol tables in loaded memory. These are used for
@@ -623,6 +720,15 @@ iree_status_t iree_elf_module_initialize_from_memory(
   }
   iree_memory_jit_context_end();
 
+  // Register with debuggers before running any code in the module so that
+  // breakpoints in initializers can be resolved.
+  if (iree_status_is_ok(status) &&
+      (flags & IREE_ELF_MODULE_FLAG_DEBUGGER_REGISTRATION)) {
+    status = iree_elf_debugger_register(raw_data, out_module->vaddr_bias,
+                                        host_allocator,
+                                        &out_module->debugger_entry);
+  }
+
   // Run initializers prior to returning to the caller.
   if (iree_status_is_ok(status)) {
     status = iree_elf_module_run_initializers(&load_state, out_module);
@@ -641,6 +747,7 @@ void iree_elf_module_deinitialize(iree_elf_module_t* module) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_elf_module_run_finalizers(module);
+  iree_elf_debugger_unregister(module->debugger_entry);
   iree_elf_module_unload_segments(module);
   memset(module, 0, sizeof(*module));
 
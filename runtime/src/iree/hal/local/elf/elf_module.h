@@ -10,7 +10,8 @@
 #include <stdint.h>
 
 #include "iree/base/api.h"
-#include "iree/hal/local/elf/arch.h"       // IWYU pragma: export
+#include "iree/hal/local/elf/arch.h"  // IWYU pragma: export
+#include "iree/hal/local/elf/debugger.h"
 #include "iree/hal/local/elf/elf_types.h"  // IWYU pragma: export
 
 //==============================================================================
@@ -34,6 +35,20 @@ typedef struct iree_elf_import_table_t {
 // Runtime ELF module loader/linker
 //==============================================================================
 
+// Flags controlling how an ELF module is loaded.
+enum iree_elf_module_flag_bits_t {
+  IREE_ELF_MODULE_FLAG_NONE = 0u,
+  // Requests that the module be loaded into memory that may be backed by large
+  // pages. This reduces instruction TLB pressure for large modules at the cost
+  // of rounding up the reservation to the large page size.
+  IREE_ELF_MODULE_FLAG_LARGE_PAGES = 1u << 0,
+  // Registers the module with debuggers implementing the GDB JIT interface so
+  // that its symbols and debug info are available. Requires retaining a copy
+  // of the ELF for the lifetime of the module.
+  IREE_ELF_MODULE_FLAG_DEBUGGER_REGISTRATION = 1u << 1,
+};
+typedef uint32_t iree_elf_module_flags_t;
+
 // An ELF module mapped directly from memory.
 typedef struct iree_elf_module_t {
   // Allocator used for additional dynamic memory when needed.
@@ -56,12 +71,18 @@ typedef struct iree_elf_module_t {
   // Dynamic symbol table (.dynsym).
   const iree_elf_sym_t* dynsym;   // DT_SYMTAB
   iree_host_size_t dynsym_count;  // DT_SYMENT (bytes) / sizeof(iree_elf_sym_t)
+
+  // Registration with attached debuggers, if requested with
+  // IREE_ELF_MODULE_FLAG_DEBUGGER_REGISTRATION.
+  iree_elf_debugger_entry_t* debugger_entry;
 } iree_elf_module_t;
 
 // Initializes an ELF module from the ELF |raw_data| in memory.
 // |raw_data| only needs to remain valid for the initialization of the module
 // and may be discarded afterward.
 //
+// |flags| controls how the module is loaded into memory.
+//
 // An optional |import_table| may be specified to provide a set of symbols that
 // the module may import. Strong imports will not be resolved from the host
 // system and initialization will fail if any are not present in the provided
@@ -73,10 +94,35 @@ typedef struct iree_elf_module_t {
 // called to unload when it is safe (no more outstanding pointers into the
 // loaded module, etc).
 iree_status_t iree_elf_module_initialize_from_memory(
-    iree_const_byte_span_t raw_data,
+    iree_const_byte_span_t raw_data, iree_elf_module_flags_t flags,
     const iree_elf_import_table_t* import_table,
     iree_allocator_t host_allocator, iree_elf_module_t* out_module);
 
+// A file containing the ELF that segments may be mapped from.
+typedef struct iree_elf_module_file_t {
+  // POSIX file descriptor of the file or -1 if not available.
+  int fd;
+  // Offset, in bytes, of the start of the ELF |raw_data| within the file.
+  uint64_t offset;
+} iree_elf_module_file_t;
+
+// Initializes an ELF module from the ELF |raw_data| in memory that is also
+// present at |file|.offset in |file|. Loadable segments with suitable page
+// alignment are mapped directly from the file instead of being copied:
+// read-only and executable pages are shared with all other processes mapping
+// the same file and writable pages are copy-on-write such that only those
+// touched by relocations consume private memory. Segments that cannot be
+// mapped (misaligned, requiring text relocations, large pages requested, or
+// the platform does not support file mappings) are copied as with
+// iree_elf_module_initialize_from_memory.
+//
+// The file must not be modified for the lifetime of the module but |file|.fd
+// may be closed once this returns.
+iree_status_t iree_elf_module_initialize_from_file(
+    iree_const_byte_span_t raw_data, iree_elf_module_file_t file,
+    iree_elf_module_flags_t flags, const iree_elf_import_table_t* import_table,
+    iree_allocator_t host_allocator, iree_elf_module_t* out_module);
+
 // Deinitializes a |module|, releasing any allocated executable or data pages.
 // Invalidates all symbol pointers previous retrieved from the module and any
 // pointer to data that may have been in the module text or rwdata.
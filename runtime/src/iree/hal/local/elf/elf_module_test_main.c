@@ -4,6 +4,10 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
 #include "iree/base/api.h"
 #include "iree/base/internal/cpu.h"
 #include "iree/hal/local/elf/elf_module.h"
@@ -51,23 +55,16 @@ static iree_status_t query_arch_test_file_data(
                           "the application for the current target platform");
 }
 
-static iree_status_t run_test() {
-  iree_const_byte_span_t file_data;
-  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
-
-  iree_elf_import_table_t import_table;
-  memset(&import_table, 0, sizeof(import_table));
-  iree_elf_module_t module;
-  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
-      file_data, &import_table, iree_allocator_system(), &module));
-
+// Runs the elementwise_mul dispatch in the loaded |module| and verifies the
+// results.
+static iree_status_t check_module(iree_elf_module_t* module) {
   iree_hal_executable_environment_v0_t environment;
   iree_hal_executable_environment_initialize(iree_allocator_system(),
                                              &environment);
 
   void* query_fn_ptr = NULL;
   IREE_RETURN_IF_ERROR(iree_elf_module_lookup_export(
-      &module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
+      module, IREE_HAL_EXECUTABLE_LIBRARY_EXPORT_NAME, &query_fn_ptr));
 
   union {
     const iree_hal_executable_library_header_t** header;
@@ -140,21 +137,87 @@ static iree_status_t run_test() {
                             "dispatch function returned failure: %d", ret);
   }
 
-  iree_status_t status = iree_ok_status();
   for (int i = 0; i < IREE_ARRAYSIZE(expected); ++i) {
     if (ret0[i] != expected[i]) {
-      status =
-          iree_make_status(IREE_STATUS_INTERNAL,
-                           "output mismatch: ret[%d] = %.1f, expected %.1f", i,
-                           ret0[i], expected[i]);
-      break;
+      return iree_make_status(IREE_STATUS_INTERNAL,
+                              "output mismatch: ret[%d] = %.1f, expected %.1f",
+                              i, ret0[i], expected[i]);
     }
   }
+  return iree_ok_status();
+}
 
+// Loads the ELF by copying its segments out of |file_data|.
+static iree_status_t run_test_from_memory(iree_const_byte_span_t file_data) {
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_t module;
+  IREE_RETURN_IF_ERROR(iree_elf_module_initialize_from_memory(
+      file_data, IREE_ELF_MODULE_FLAG_NONE, &import_table,
+      iree_allocator_system(), &module));
+  iree_status_t status = check_module(&module);
   iree_elf_module_deinitialize(&module);
   return status;
 }
 
+// Writes |file_data| to a temporary file at |file_offset| and loads the ELF
+// with segments mapped from the file where possible. The file is closed
+// before the module is used to ensure the mappings don't depend on it.
+static iree_status_t run_test_from_file(iree_const_byte_span_t file_data,
+                                        uint64_t file_offset) {
+#if defined(IREE_PLATFORM_WINDOWS)
+  // File mapping is unavailable and loading falls back to copying.
+  return iree_ok_status();
+#else
+  FILE* file = tmpfile();
+  if (!file) {
+    fprintf(stderr, "skipping file test: unable to create temporary file\n");
+    return iree_ok_status();
+  }
+  bool did_write = fseek(file, (long)file_offset, SEEK_SET) == 0 &&
+                   fwrite(file_data.data, 1, file_data.data_length, file) ==
+                       file_data.data_length &&
+                   fflush(file) == 0;
+  if (!did_write) {
+    fclose(file);
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "failed to write temporary ELF file");
+  }
+
+  iree_elf_import_table_t import_table;
+  memset(&import_table, 0, sizeof(import_table));
+  iree_elf_module_file_t module_file = {
+      .fd = fileno(file),
+      .offset = file_offset,
+  };
+  iree_elf_module_t module;
+  iree_status_t status = iree_elf_module_initialize_from_file(
+      file_data, module_file, IREE_ELF_MODULE_FLAG_NONE, &import_table,
+      iree_allocator_system(), &module);
+  fclose(file);
+  if (iree_status_is_ok(status)) {
+    status = check_module(&module);
+    iree_elf_module_deinitialize(&module);
+  }
+  return iree_status_annotate_f(status, "file offset %" PRIu64, file_offset);
+#endif  // IREE_PLATFORM_WINDOWS
+}
+
+static iree_status_t run_test() {
+  iree_const_byte_span_t file_data;
+  IREE_RETURN_IF_ERROR(query_arch_test_file_data(&file_data));
+
+  IREE_RETURN_IF_ERROR(run_test_from_memory(file_data));
+
+  // Segments are mapped from the file when the file offset is page aligned
+  // (64KB covers all common page sizes) and copied when it is not.
+  IREE_RETURN_IF_ERROR(run_test_from_file(file_data, /*file_offset=*/0));
+  IREE_RETURN_IF_ERROR(run_test_from_file(file_data, /*file_offset=*/65536));
+  IREE_RETURN_IF_ERROR(run_test_from_file(file_data, /*file_offset=*/16));
+
+  return iree_ok_status();
+}
+
 int main() {
   const iree_status_t result = run_test();
   int ret = (int)iree_status_code(result);
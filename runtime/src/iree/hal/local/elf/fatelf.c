@@ -6,10 +6,102 @@
 
 #include "iree/hal/local/elf/fatelf.h"
 
+#include "iree/base/internal/cpu.h"
 #include "iree/hal/local/elf/arch.h"
+#include "iree/schemas/cpu_data.h"
+
+//===----------------------------------------------------------------------===//
+// Host feature level
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_ARCH_X86_64)
+
+static iree_fatelf_feature_level_t iree_fatelf_feature_level_from_cpu_data(
+    uint64_t field0) {
+  const uint64_t v2_bits =
+      IREE_CPU_DATA0_X86_64_SSE3 | IREE_CPU_DATA0_X86_64_SSSE3 |
+      IREE_CPU_DATA0_X86_64_SSE41 | IREE_CPU_DATA0_X86_64_SSE42;
+  const uint64_t v3_bits = v2_bits | IREE_CPU_DATA0_X86_64_AVX |
+                           IREE_CPU_DATA0_X86_64_AVX2 |
+                           IREE_CPU_DATA0_X86_64_FMA |
+                           IREE_CPU_DATA0_X86_64_F16C;
+  const uint64_t v4_bits =
+      v3_bits | IREE_CPU_DATA0_X86_64_AVX512F | IREE_CPU_DATA0_X86_64_AVX512CD |
+      IREE_CPU_DATA0_X86_64_AVX512VL | IREE_CPU_DATA0_X86_64_AVX512DQ |
+      IREE_CPU_DATA0_X86_64_AVX512BW;
+  if (iree_all_bits_set(field0, v4_bits)) {
+    return IREE_FATELF_FEATURE_LEVEL_X86_64_V4;
+  } else if (iree_all_bits_set(field0, v3_bits)) {
+    return IREE_FATELF_FEATURE_LEVEL_X86_64_V3;
+  } else if (iree_all_bits_set(field0, v2_bits)) {
+    return IREE_FATELF_FEATURE_LEVEL_X86_64_V2;
+  }
+  return IREE_FATELF_FEATURE_LEVEL_BASELINE;
+}
+
+#elif defined(IREE_ARCH_ARM_64)
+
+static iree_fatelf_feature_level_t iree_fatelf_feature_level_from_cpu_data(
+    uint64_t field0) {
+  const uint64_t v8_2_bits = IREE_CPU_DATA0_ARM_64_LSE |
+                             IREE_CPU_DATA0_ARM_64_FULLFP16 |
+                             IREE_CPU_DATA0_ARM_64_DOTPROD;
+  const uint64_t v9_bits =
+      v8_2_bits | IREE_CPU_DATA0_ARM_64_SVE | IREE_CPU_DATA0_ARM_64_SVE2;
+  if (iree_all_bits_set(field0, v9_bits)) {
+    return IREE_FATELF_FEATURE_LEVEL_ARM_64_V9;
+  } else if (iree_all_bits_set(field0, v8_2_bits)) {
+    return IREE_FATELF_FEATURE_LEVEL_ARM_64_V8_2;
+  }
+  return IREE_FATELF_FEATURE_LEVEL_BASELINE;
+}
+
+#else
+
+static iree_fatelf_feature_level_t iree_fatelf_feature_level_from_cpu_data(
+    uint64_t field0) {
+  // No levels defined for this architecture.
+  return IREE_FATELF_FEATURE_LEVEL_BASELINE;
+}
+
+#endif  // IREE_ARCH_*
+
+iree_fatelf_feature_level_t iree_fatelf_query_host_feature_level(void) {
+  // The cached data is populated when executable environments are initialized
+  // and that may not have happened yet when loading the first executable. Like
+  // the environment initialization this is not strictly thread-safe but the
+  // values written are always the same.
+  uint64_t field0 = iree_cpu_data_field(0);
+  if (!field0) {
+    iree_cpu_initialize(iree_allocator_system());
+    field0 = iree_cpu_data_field(0);
+  }
+  return iree_fatelf_feature_level_from_cpu_data(field0);
+}
+
+//===----------------------------------------------------------------------===//
+// FatELF record selection
+//===----------------------------------------------------------------------===//
 
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                                  iree_const_byte_span_t* out_elf_data) {
+  // Only query the host when it's actually a FatELF as the query may need to
+  // go to the system.
+  if (file_data.data_length < sizeof(iree_fatelf_header_t) ||
+      iree_unaligned_load_le_u32(
+          &((const iree_fatelf_header_t*)file_data.data)->magic) !=
+          IREE_FATELF_MAGIC) {
+    *out_elf_data = file_data;
+    return iree_ok_status();
+  }
+  return iree_fatelf_select_with_feature_level(
+      file_data, iree_fatelf_query_host_feature_level(), out_elf_data);
+}
+
+iree_status_t iree_fatelf_select_with_feature_level(
+    iree_const_byte_span_t file_data,
+    iree_fatelf_feature_level_t max_feature_level,
+    iree_const_byte_span_t* out_elf_data) {
   *out_elf_data = iree_const_byte_span_empty();
 
   // If there's not enough room for the header and a single record then don't
@@ -58,9 +150,13 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                             required_bytes, file_data.data_length);
   }
 
-  // Scan record table to find one that matches.
+  // Scan record table to find the highest feature level that matches. Ties
+  // resolve to the first record so that files written without levels behave
+  // as they always have.
   iree_elf64_off_t selected_offset = 0;
   iree_elf64_xword_t selected_size = 0;
+  iree_fatelf_feature_level_t selected_feature_level = 0;
+  bool any_machine_match = false;
   for (iree_elf64_byte_t i = 0; i < host_header.record_count; ++i) {
     const iree_fatelf_record_t* raw_record = &raw_header->records[i];
     const iree_fatelf_record_t host_record = {
@@ -69,7 +165,8 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
         .osabi_version = iree_unaligned_load_le_u8(&raw_record->osabi_version),
         .word_size = iree_unaligned_load_le_u8(&raw_record->word_size),
         .byte_order = iree_unaligned_load_le_u8(&raw_record->byte_order),
-        .reserved0 = iree_unaligned_load_le_u8(&raw_record->reserved0),
+        .feature_level =
+            iree_unaligned_load_le_u8(&raw_record->feature_level),
         .reserved1 = iree_unaligned_load_le_u8(&raw_record->reserved1),
         .offset = iree_unaligned_load_le_u64(&raw_record->offset),
         .size = iree_unaligned_load_le_u64(&raw_record->size),
@@ -91,11 +188,24 @@ iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
 #else
     if (host_record.byte_order != IREE_FATELF_BYTE_ORDER_MSB) continue;
 #endif  // IREE_ENDIANNESS_LITTLE
+    any_machine_match = true;
+    if (host_record.feature_level > max_feature_level) continue;
+    if (selected_size &&
+        host_record.feature_level <= selected_feature_level) {
+      continue;
+    }
     selected_offset = host_record.offset;
     selected_size = host_record.size;
-    break;
+    selected_feature_level = host_record.feature_level;
   }
   if (!selected_offset || !selected_size) {
+    if (any_machine_match) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "FatELF only contains ELFs for the runtime architecture requiring "
+          "processor features beyond the host feature level %d",
+          (int)max_feature_level);
+    }
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "no ELFs matching the runtime architecture or "
                             "Linux ABI found in the FatELF");
@@ -28,6 +28,8 @@
 //
 // To create a FatELF file from several ELFs:
 //   iree-fatelf join elf_a.so elf_b.so elf_c.so > fatelf.sos
+// To include microarchitecture variants tag each with its feature level:
+//   iree-fatelf join elf.so elf_v3.so@x86-64-v3 elf_v4.so@x86-64-v4 > fat.sos
 // To extract all ELFs from a FatELF file:
 //   iree-fatelf split fatelf.sos
 //
@@ -39,9 +41,10 @@
 #define IREE_FATELF_MAGIC 0x1F0E70FA  // FA700E1F 'fat' 'elf' lol
 
 // Only version 1 is defined. We may end up with our own versions if we diverge.
-// FatELF doesn't have any architectural feature requirement bits which makes it
-// difficult to support specialized ELFs based on things like instruction set
-// support and we may want to add that.
+// FatELF doesn't have any architectural feature requirement bits so we
+// repurpose the first reserved byte of each record as a feature level (see
+// iree_fatelf_feature_level_t). Other tools write zero there which is treated
+// as the baseline so files remain compatible in both directions.
 #define IREE_FATELF_FORMAT_VERSION 1
 
 enum {
@@ -54,6 +57,29 @@ enum {
   IREE_FATELF_BYTE_ORDER_LSB = 1,  // IREE_ELF_ELFDATA2LSB - little-endian
 };
 
+// Per-machine microarchitecture level an ELF was compiled for.
+// Levels are cumulative within a machine: a host supporting a particular level
+// supports all lower levels. Level 0 is the machine baseline and always usable.
+// When multiple records match the host machine the one with the highest level
+// supported by the host is selected. Older runtimes ignore the level and pick
+// the first matching record so baseline ELFs should come first.
+typedef iree_elf64_byte_t iree_fatelf_feature_level_t;
+enum iree_fatelf_feature_level_bits_t {
+  IREE_FATELF_FEATURE_LEVEL_BASELINE = 0,
+
+  // x86-64-v2: SSE3/SSSE3/SSE4.1/SSE4.2.
+  IREE_FATELF_FEATURE_LEVEL_X86_64_V2 = 1,
+  // x86-64-v3: v2 + AVX/AVX2/FMA/F16C.
+  IREE_FATELF_FEATURE_LEVEL_X86_64_V3 = 2,
+  // x86-64-v4: v3 + AVX-512 F/CD/VL/DQ/BW.
+  IREE_FATELF_FEATURE_LEVEL_X86_64_V4 = 3,
+
+  // armv8.2-a: LSE + FP16 + dot product.
+  IREE_FATELF_FEATURE_LEVEL_ARM_64_V8_2 = 1,
+  // armv9-a: armv8.2-a + SVE/SVE2.
+  IREE_FATELF_FEATURE_LEVEL_ARM_64_V9 = 2,
+};
+
 // An individual record in the FatELF record table.
 // This has some of the fields from the iree_elf_ehdr_t and references a header-
 // relative file range of where the corresponding ELF file can be found.
@@ -63,7 +89,7 @@ typedef struct {
   iree_elf64_byte_t osabi_version;  // e_ident[EI_ABIVERSION]
   iree_elf64_byte_t word_size;      // e_ident[EI_CLASS]
   iree_elf64_byte_t byte_order;     // e_ident[EI_DATA]
-  iree_elf64_byte_t reserved0;
+  iree_fatelf_feature_level_t feature_level;  // reserved0 in FatELF
   iree_elf64_byte_t reserved1;
   iree_elf64_off_t offset;
   iree_elf64_xword_t size;
@@ -80,11 +106,25 @@ typedef struct {
 } iree_fatelf_header_t;
 static_assert(sizeof(iree_fatelf_header_t) == 8, "must be packed");
 
+// Returns the highest feature level of the host machine as determined by the
+// iree_cpu feature bits. Initializes the cached CPU data if that has not yet
+// been done.
+iree_fatelf_feature_level_t iree_fatelf_query_host_feature_level(void);
+
 // Scans |file_data| for a FatELF header and if present selects the matching ELF
-// for the current system if available.
+// for the current system if available. Of the records matching the host
+// architecture the one with the highest feature level supported by the host is
+// chosen.
 // Upon return |out_elf_data| will either be the entire file if no FatELF header
 // was found or just the bytes of the selected ELF.
 iree_status_t iree_fatelf_select(iree_const_byte_span_t file_data,
                                  iree_const_byte_span_t* out_elf_data);
 
+// Selects as with iree_fatelf_select but limits the records considered to those
+// with a feature level of at most |max_feature_level|.
+iree_status_t iree_fatelf_select_with_feature_level(
+    iree_const_byte_span_t file_data,
+    iree_fatelf_feature_level_t max_feature_level,
+    iree_const_byte_span_t* out_elf_data);
+
 #endif  // IREE_HAL_LOCAL_ELF_FATELF_H_
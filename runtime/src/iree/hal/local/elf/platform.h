@@ -48,6 +48,12 @@ enum iree_memory_view_flag_bits_t {
   // Indicates that the memory may be used to execute code.
   // May be used to ask for special privileges (like MAP_JIT on MacOS).
   IREE_MEMORY_VIEW_FLAG_MAY_EXECUTE = 1u << 10,
+
+  // Requests that the view be aligned such that it may be backed by large
+  // pages (see iree_memory_info_t::large_page_granularity). Large pages must
+  // still be requested for committed ranges with
+  // iree_memory_view_advise_large_pages.
+  IREE_MEMORY_VIEW_FLAG_LARGE_PAGES = 1u << 11,
 };
 typedef uint32_t iree_memory_view_flags_t;
 
@@ -89,4 +95,35 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
                                               const iree_byte_range_t* ranges,
                                               iree_memory_access_t new_access);
 
+// Maps |length| bytes of the file |fd| starting at |file_offset| into the
+// reserved view at |base_address| + |view_offset| with |access| protection.
+// Both |view_offset| (relative to the page-aligned view base) and
+// |file_offset| must be aligned to the normal page size. The mapping is
+// private: clean pages are shared with any other mapping of the same file
+// (including those in other processes) and pages written to are copied on
+// first write. The file may be closed after the call returns but its contents
+// must not be modified for the lifetime of the view.
+//
+// Returns IREE_STATUS_UNAVAILABLE on platforms that are unable to map files
+// into a view; callers should fall back to committing and copying.
+//
+// Implemented by mmap+MAP_PRIVATE+MAP_FIXED:
+//  https://man7.org/linux/man-pages/man2/mmap.2.html
+iree_status_t iree_memory_view_map_file_range(void* base_address,
+                                              iree_host_size_t view_offset,
+                                              iree_host_size_t length, int fd,
+                                              uint64_t file_offset,
+                                              iree_memory_access_t access);
+
+// Hints that the committed pages in the view starting at |base_address| should
+// be backed by large pages. Only portions of the view aligned to the large page
+// granularity and with uniform access protection can use large pages. This is
+// a best-effort hint and is ignored on platforms without transparent large page
+// support.
+//
+// Implemented by madvise(MADV_HUGEPAGE):
+//  https://man7.org/linux/man-pages/man2/madvise.2.html
+void iree_memory_view_advise_large_pages(void* base_address,
+                                         iree_host_size_t total_length);
+
 #endif  // IREE_HAL_LOCAL_ELF_PLATFORM_H_
@@ -136,4 +136,20 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_map_file_range(void* base_address,
+                                              iree_host_size_t view_offset,
+                                              iree_host_size_t length, int fd,
+                                              uint64_t file_offset,
+                                              iree_memory_access_t access) {
+  // NOTE: executable file mappings require the file to be code signed under
+  // the hardened runtime so we always fall back to copying into MAP_JIT pages.
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file mapping not supported");
+}
+
+void iree_memory_view_advise_large_pages(void* base_address,
+                                         iree_host_size_t total_length) {
+  // No-op.
+}
+
 #endif  // IREE_PLATFORM_APPLE
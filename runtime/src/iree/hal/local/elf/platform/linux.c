@@ -34,11 +34,30 @@ iree_status_t iree_memory_view_reserve(iree_memory_view_flags_t flags,
   int mmap_prot = PROT_NONE;
   int mmap_flags = MAP_PRIVATE | MAP_ANON | MAP_NORESERVE;
 
+  // Large pages can only be used if the base address is aligned to the large
+  // page size. We over-reserve and trim the unaligned head and tail.
+  iree_host_size_t alignment = 0;
+  if (flags & IREE_MEMORY_VIEW_FLAG_LARGE_PAGES) {
+    alignment = iree_memory_query_info().large_page_granularity;
+    if (alignment <= (iree_host_size_t)getpagesize()) alignment = 0;
+  }
+  const iree_host_size_t reserve_length = total_length + alignment;
+
   iree_status_t status = iree_ok_status();
-  void* base_address = mmap(NULL, total_length, mmap_prot, mmap_flags, -1, 0);
+  void* base_address =
+      mmap(NULL, reserve_length, mmap_prot, mmap_flags, -1, 0);
   if (base_address == MAP_FAILED) {
     status = iree_make_status(iree_status_code_from_errno(errno),
                               "mmap reservation failed");
+  } else if (alignment) {
+    uint8_t* reserve_base = (uint8_t*)base_address;
+    base_address = (void*)iree_host_align((uintptr_t)reserve_base, alignment);
+    const iree_host_size_t head_length =
+        (uint8_t*)base_address - reserve_base;
+    const iree_host_size_t tail_length =
+        reserve_length - head_length - total_length;
+    if (head_length) munmap(reserve_base, head_length);
+    if (tail_length) munmap((uint8_t*)base_address + total_length, tail_length);
   }
 
   *out_base_address = base_address;
@@ -109,4 +128,41 @@ iree_status_t iree_memory_view_protect_ranges(void* base_address,
   return status;
 }
 
+iree_status_t iree_memory_view_map_file_range(void* base_address,
+                                              iree_host_size_t view_offset,
+                                              iree_host_size_t length, int fd,
+                                              uint64_t file_offset,
+                                              iree_memory_access_t access) {
+  const iree_host_size_t page_size = (iree_host_size_t)getpagesize();
+  if (!iree_host_size_has_alignment(view_offset, page_size) ||
+      (file_offset % page_size) != 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "file mappings must be page aligned");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int mmap_prot = iree_memory_access_to_prot(access);
+  int mmap_flags = MAP_PRIVATE | MAP_FIXED;
+
+  iree_status_t status = iree_ok_status();
+  void* result = mmap((uint8_t*)base_address + view_offset, length, mmap_prot,
+                      mmap_flags, fd, (off_t)file_offset);
+  if (result == MAP_FAILED) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "mmap of file range failed");
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+void iree_memory_view_advise_large_pages(void* base_address,
+                                         iree_host_size_t total_length) {
+#if defined(MADV_HUGEPAGE)
+  // NOTE: return value ignored as the kernel may have large pages disabled and
+  // this is only a hint.
+  madvise(base_address, total_length, MADV_HUGEPAGE);
+#endif  // MADV_HUGEPAGE
+}
+
 #endif  // IREE_PLATFORM_*
@@ -88,11 +88,15 @@ typedef struct iree_hal_executable_environment_v0_t
 typedef uint32_t iree_hal_executable_library_version_t;
 
 #define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4 0x00000004u
+// v0.5 adds workgroup range entry points
+// (IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0) and scheduling hints
+// to iree_hal_executable_workgroup_state_v0_t.
+#define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_5 0x00000005u
 
 // The latest version of the library API; can be used to populate the
 // iree_hal_executable_library_header_t::version when building libraries.
 #define IREE_HAL_EXECUTABLE_LIBRARY_VERSION_LATEST \
-  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_4
+  IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_5
 
 // A header present at the top of all versions of the library API used by the
 // runtime to ensure version compatibility.
@@ -348,7 +352,30 @@ typedef struct iree_hal_executable_workgroup_state_v0_t {
   // the requested amount.
   uint32_t local_memory_size;
 
-  // +4 trailing bytes of free space
+  // Number of workgroups to execute starting at the workgroup ID above for
+  // entry points with the WORKGROUP_RANGE_V0 dispatch flag.
+  // Workgroups are executed in linearized order with X varying fastest and
+  // wrap from the end of a row (or slice) to the start of the next one. Always
+  // 1 for all other entry points; 0 must be treated as 1.
+  uint32_t workgroup_range_count;
+
+  // Workgroup ID of the workgroup (or first workgroup of the range) the
+  // processor is expected to execute after this one. Equal to the current
+  // workgroup ID if not known. This is only a hint that can be used to
+  // prefetch operands and the processor may end up executing any workgroup.
+  uint32_t next_workgroup_id_x;
+  uint32_t next_workgroup_id_y;
+  uint16_t next_workgroup_id_z;
+
+  // Opaque identifier of the cluster of processors (NUMA node, package, etc)
+  // containing |processor_id|. Processors in the same cluster generally share
+  // their last level of cache. UINT16_MAX if not known.
+  uint16_t processor_cluster_id;
+
+  // Sizes in bytes of the L1 and L2 data caches of the processor or 0 if not
+  // known. Can be used to dynamically size cache blocking.
+  uint32_t l1_data_cache_size;
+  uint32_t l2_data_cache_size;
 } iree_hal_executable_workgroup_state_v0_t;
 static_assert(
     sizeof(iree_hal_executable_workgroup_state_v0_t) <= 64,
@@ -357,7 +384,9 @@ static_assert(
 // Function signature of exported executable entry points.
 // The same |environment| is passed to all dispatches.
 // The same |dispatch_state| is passed to all workgroups within a dispatch.
-// A unique |workgroup_state| is passed to every workgroup within a dispatch.
+// A unique |workgroup_state| is passed to every workgroup within a dispatch
+// or to every range of workgroups for workgroup range entry points (see
+// IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0).
 //
 // Returns 0 on success and non-zero on failure. Failures will cause device loss
 // and should only be used to communicate serious issues that should abort all
@@ -374,6 +403,37 @@ typedef int (*iree_hal_executable_dispatch_v0_t)(
 // This is chosen to match the common page size of devices.
 #define IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE 4096
 
+// Defines a bitfield of flags controlling dispatch behavior/synchronization.
+enum iree_hal_executable_dispatch_flag_bits_v0_t {
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_NONE_V0 = 0u,
+  // Each workgroup only reads data produced by the workgroup with the same
+  // workgroup ID in the immediately preceding dispatch when both dispatches
+  // have the same workgroup count (such as an elementwise op consuming the
+  // result tiles of a matmul). Runtimes may use this to begin each workgroup
+  // as soon as its producer workgroup completes instead of waiting for the
+  // entire producer dispatch, keeping the data hot in cache between the two.
+  // The runtime still ensures all workgroups of the preceding dispatch have
+  // completed before any work following this dispatch begins and the flag has
+  // no effect if the dispatches do not match.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_PIPELINE_WORKGROUPS_V0 = 1u << 0,
+  // Prefers that workgroups be assigned to workers to preserve cache locality
+  // instead of dynamically balanced: consecutive dispatches with the same
+  // workgroup count have the same workgroups executed by the same workers and
+  // each worker processes a compact 2D region of the grid. Useful for chains
+  // of dispatches (such as matmuls) that reuse operands resident in the
+  // caches of the workers that produced them.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_LOCALITY_V0 = 1u << 1,
+  // The entry point executes the range of
+  // iree_hal_executable_workgroup_state_v0_t::workgroup_range_count workgroups
+  // starting at the provided workgroup ID instead of a single workgroup. This
+  // amortizes the call and state setup overhead over many workgroups and is
+  // recommended for dispatches with many small workgroups. Runtimes choose the
+  // range sizes and may still pass ranges of a single workgroup.
+  // Requires IREE_HAL_EXECUTABLE_LIBRARY_VERSION_0_5 or newer.
+  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0 = 1u << 2,
+};
+typedef uint16_t iree_hal_executable_dispatch_flags_v0_t;
+
 // Attributes for exported dispatch functions defining how they are to be
 // executed. 0 defaults are well-specified and the entire attributes table may
 // be omitted if no dispatch functions require these fields.
@@ -382,9 +442,9 @@ typedef struct iree_hal_executable_dispatch_attrs_v0_t {
   // indicating how much workgroup local memory is required for the dispatch.
   // This is the size of the buffer referenced by the `local_memory` argument.
   uint16_t local_memory_pages;
-  // Must be 0. May be used in the future for flags controlling the dispatch
-  // behavior/synchronization requirements.
-  uint16_t reserved;
+  // Flags controlling the dispatch behavior/synchronization requirements.
+  // Unknown flags are ignored by older runtimes.
+  iree_hal_executable_dispatch_flags_v0_t flags;
 } iree_hal_executable_dispatch_attrs_v0_t;
 static_assert(sizeof(iree_hal_executable_dispatch_attrs_v0_t) == 4, "uint32_t");
 
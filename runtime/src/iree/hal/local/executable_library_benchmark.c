@@ -4,12 +4,14 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+#include <math.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/api.h"
@@ -19,7 +21,13 @@
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
 #include "iree/hal/local/plugins/registration/init.h"
+#include "iree/io/stdio_stream.h"
+#include "iree/task/executor.h"
+#include "iree/task/scope.h"
+#include "iree/task/task.h"
+#include "iree/task/topology.h"
 #include "iree/testing/benchmark.h"
+#include "iree/tooling/numpy_io.h"
 
 IREE_FLAG(string, executable_format, "",
           "Format of the executable file being loaded.");
@@ -47,7 +55,17 @@ IREE_FLAG(int32_t, workgroup_size_z, 1,
           "Z dimension of the workgroup size passed to the executable.");
 
 IREE_FLAG(int32_t, max_concurrency, 1,
-          "Maximum available concurrency exposed to the dispatch.");
+          "Maximum available concurrency exposed to the dispatch.\n"
+          "Ignored when running with --task_worker_count= as the worker count\n"
+          "is used instead.");
+
+IREE_FLAG_LIST(
+    string, task_worker_count,
+    "Runs the dispatch through the task system with the given number of\n"
+    "workers instead of inline on the benchmark thread. Each repetition of\n"
+    "the flag registers a benchmark and the first one is the baseline that\n"
+    "the scaling efficiency of the others is reported against, e.g.:\n"
+    "  --task_worker_count=1 --task_worker_count=2 --task_worker_count=4");
 
 // Total number of bindings we (currently) allow any executable to have.
 #define IREE_HAL_LOCAL_MAX_TOTAL_BINDING_COUNT \
@@ -121,14 +139,286 @@ static void print_binding(iree_string_view_t flag_name, void* storage,
 IREE_FLAG_CALLBACK(
     parse_binding, print_binding, &dispatch_params, binding,
     "Appends a binding to the dispatch parameters.\n"
-    "Bindings are defined by their shape, element type, and their data.\n"
+    "Bindings are defined by their shape, element type, and their data or\n"
+    "loaded from a .npy file when prefixed with `@`.\n"
     "Examples:\n"
     "  # 16 4-byte elements zero-initialized:\n"
     "  --binding=2x8xi32\n"
     "  # 10000 bytes all initialized to 123:\n"
     "  --binding=10000xi8=123\n"
     "  # 2 4-byte floating-point values with contents [[1.4], [2.1]]:\n"
-    "  --binding=2x1xf32=1.4,2.1");
+    "  --binding=2x1xf32=1.4,2.1\n"
+    "  # ndarray loaded from a numpy file:\n"
+    "  --binding=@path/to/input.npy");
+
+// Parses |binding| as either a `@path.npy` reference or an inline buffer view
+// and allocates its storage from |heap_allocator|.
+static iree_status_t iree_hal_executable_library_parse_binding(
+    iree_string_view_t binding, iree_hal_allocator_t* heap_allocator,
+    iree_allocator_t host_allocator, iree_hal_buffer_view_t** out_buffer_view) {
+  if (!iree_string_view_consume_prefix(&binding, IREE_SV("@"))) {
+    return iree_hal_buffer_view_parse(binding, /*device=*/NULL, heap_allocator,
+                                      out_buffer_view);
+  }
+  iree_io_stream_t* stream = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_stdio_stream_open(
+      IREE_IO_STDIO_STREAM_MODE_READ, binding, host_allocator, &stream));
+  const iree_hal_buffer_params_t buffer_params = {
+      .usage = IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING,
+      .access = IREE_HAL_MEMORY_ACCESS_ALL,
+      .type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL |
+              IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE,
+  };
+  iree_status_t status = iree_numpy_npy_load_ndarray(
+      stream, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params,
+      /*device=*/NULL, heap_allocator, out_buffer_view);
+  iree_io_stream_release(stream);
+  return iree_status_annotate_f(status, "loading binding from '%.*s'",
+                                (int)binding.size, binding.data);
+}
+
+// Configuration of a registered benchmark.
+typedef struct iree_hal_executable_library_benchmark_t {
+  iree_hal_executable_plugin_manager_t* plugin_manager;
+  // Number of task system workers to dispatch across or 0 to run inline.
+  uint32_t worker_count;
+  // True if this is the task system run other runs are scaled against.
+  bool is_scaling_baseline;
+} iree_hal_executable_library_benchmark_t;
+
+// Wall time of a single dispatch from the scaling baseline run.
+static struct {
+  uint32_t worker_count;
+  double dispatch_ns;
+} iree_hal_executable_library_scaling_baseline = {0, 0.0};
+
+// Per-worker workgroup timing statistics.
+// Each worker only ever updates its own entry so no synchronization is needed
+// beyond the scope idle wait prior to reading them.
+typedef struct iree_hal_executable_library_worker_stats_t {
+  iree_alignas(iree_hardware_destructive_interference_size) uint64_t
+      workgroup_count;
+  double total_ns;
+  double total_sq_ns;
+  iree_time_t min_ns;
+  iree_time_t max_ns;
+} iree_hal_executable_library_worker_stats_t;
+
+typedef struct iree_hal_executable_library_task_dispatch_t {
+  iree_hal_local_executable_t* executable;
+  int32_t entry_point;
+  const iree_hal_executable_dispatch_state_v0_t* dispatch_state;
+  iree_hal_executable_library_worker_stats_t* worker_stats;
+} iree_hal_executable_library_task_dispatch_t;
+
+// Issues a single workgroup from a task system dispatch tile as the HAL
+// local-task driver does and records its duration.
+static iree_status_t iree_hal_executable_library_dispatch_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_hal_executable_library_task_dispatch_t* dispatch =
+      (const iree_hal_executable_library_task_dispatch_t*)user_context;
+  iree_alignas(64) iree_hal_executable_workgroup_state_v0_t workgroup_state = {
+      .workgroup_id_x = tile_context->workgroup_xyz[0],
+      .workgroup_id_y = tile_context->workgroup_xyz[1],
+      .workgroup_id_z = tile_context->workgroup_xyz[2],
+      .reserved = 0,
+      .processor_id = tile_context->processor_id,
+      .local_memory = tile_context->local_memory.data,
+      .local_memory_size = (size_t)tile_context->local_memory.data_length,
+      .workgroup_range_count = 1,
+      .next_workgroup_id_x = tile_context->next_workgroup_xyz[0],
+      .next_workgroup_id_y = tile_context->next_workgroup_xyz[1],
+      .next_workgroup_id_z = tile_context->next_workgroup_xyz[2],
+      .processor_cluster_id =
+          (uint16_t)iree_min(tile_context->node_id, (uint32_t)UINT16_MAX),
+      .l1_data_cache_size = tile_context->caches.l1_data,
+      .l2_data_cache_size = tile_context->caches.l2_data,
+  };
+  const iree_time_t start_ns = iree_time_now();
+  iree_status_t status = iree_hal_local_executable_issue_call(
+      dispatch->executable, dispatch->entry_point, dispatch->dispatch_state,
+      &workgroup_state, tile_context->worker_id);
+  const iree_time_t duration_ns = iree_time_now() - start_ns;
+
+  iree_hal_executable_library_worker_stats_t* stats =
+      &dispatch->worker_stats[tile_context->worker_id];
+  ++stats->workgroup_count;
+  stats->total_ns += (double)duration_ns;
+  stats->total_sq_ns += (double)duration_ns * (double)duration_ns;
+  stats->min_ns = iree_min(stats->min_ns, duration_ns);
+  stats->max_ns = iree_max(stats->max_ns, duration_ns);
+  return status;
+}
+
+// Reports the workgroup time distribution and scaling counters of a task
+// system run that took |wall_ns| for |dispatch_count| dispatches.
+static void iree_hal_executable_library_report_task_stats(
+    const iree_hal_executable_library_benchmark_t* benchmark,
+    const iree_hal_executable_library_worker_stats_t* worker_stats,
+    int64_t dispatch_count, iree_time_t wall_ns,
+    iree_benchmark_state_t* benchmark_state) {
+  if (dispatch_count == 0 || wall_ns <= 0) return;
+  uint64_t workgroup_count = 0;
+  double total_ns = 0.0;
+  double total_sq_ns = 0.0;
+  iree_time_t min_ns = IREE_TIME_INFINITE_FUTURE;
+  iree_time_t max_ns = 0;
+  double max_worker_ns = 0.0;
+  for (uint32_t i = 0; i < benchmark->worker_count; ++i) {
+    const iree_hal_executable_library_worker_stats_t* stats = &worker_stats[i];
+    if (!stats->workgroup_count) continue;
+    workgroup_count += stats->workgroup_count;
+    total_ns += stats->total_ns;
+    total_sq_ns += stats->total_sq_ns;
+    min_ns = iree_min(min_ns, stats->min_ns);
+    max_ns = iree_max(max_ns, stats->max_ns);
+    max_worker_ns = iree_max(max_worker_ns, stats->total_ns);
+  }
+  if (!workgroup_count) return;
+
+  // Distribution of individual workgroup times: a high coefficient of
+  // variation usually means tiles contend for memory bandwidth or caches.
+  const double mean_ns = total_ns / workgroup_count;
+  const double variance_ns =
+      iree_max(total_sq_ns / workgroup_count - mean_ns * mean_ns, 0.0);
+  const double stddev_ns = sqrt(variance_ns);
+  iree_benchmark_set_counter(benchmark_state, "wg_mean_ns", mean_ns, 0);
+  iree_benchmark_set_counter(benchmark_state, "wg_stddev_ns", stddev_ns, 0);
+  iree_benchmark_set_counter(benchmark_state, "wg_cv",
+                             mean_ns > 0.0 ? stddev_ns / mean_ns : 0.0, 0);
+  iree_benchmark_set_counter(benchmark_state, "wg_min_ns", (double)min_ns, 0);
+  iree_benchmark_set_counter(benchmark_state, "wg_max_ns", (double)max_ns, 0);
+
+  // Fraction of the available worker time spent executing workgroups (vs.
+  // scheduling, stealing, and waiting) and how unevenly work was distributed.
+  const double mean_worker_ns = total_ns / benchmark->worker_count;
+  iree_benchmark_set_counter(
+      benchmark_state, "utilization",
+      total_ns / ((double)wall_ns * benchmark->worker_count), 0);
+  iree_benchmark_set_counter(benchmark_state, "worker_imbalance",
+                             max_worker_ns / mean_worker_ns, 0);
+
+  // Speedup and scaling efficiency relative to the baseline run. The baseline
+  // itself reports 1.0 for both.
+  const double dispatch_ns = (double)wall_ns / dispatch_count;
+  if (benchmark->is_scaling_baseline) {
+    iree_hal_executable_library_scaling_baseline.worker_count =
+        benchmark->worker_count;
+    iree_hal_executable_library_scaling_baseline.dispatch_ns = dispatch_ns;
+  }
+  if (iree_hal_executable_library_scaling_baseline.worker_count) {
+    const double speedup =
+        iree_hal_executable_library_scaling_baseline.dispatch_ns / dispatch_ns;
+    iree_benchmark_set_counter(benchmark_state, "speedup", speedup, 0);
+    iree_benchmark_set_counter(
+        benchmark_state, "scaling_efficiency",
+        speedup * iree_hal_executable_library_scaling_baseline.worker_count /
+            benchmark->worker_count,
+        0);
+  }
+}
+
+// Runs the dispatch through the task system sharded across the workers of a
+// dedicated executor.
+static iree_status_t iree_hal_executable_library_run_task(
+    const iree_hal_executable_library_benchmark_t* benchmark,
+    iree_hal_local_executable_t* local_executable,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_host_size_t local_memory_size, iree_allocator_t host_allocator,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = local_memory_size;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(benchmark->worker_count,
+                                                 &topology);
+  iree_task_executor_t* executor = NULL;
+  iree_status_t status =
+      iree_task_executor_create(options, &topology, host_allocator, &executor);
+  iree_task_topology_deinitialize(&topology);
+  IREE_RETURN_IF_ERROR(status);
+
+  iree_hal_executable_library_worker_stats_t* worker_stats = NULL;
+  status = iree_allocator_malloc_aligned(
+      host_allocator, benchmark->worker_count * sizeof(*worker_stats),
+      iree_alignof(iree_hal_executable_library_worker_stats_t), 0,
+      (void**)&worker_stats);
+  if (!iree_status_is_ok(status)) {
+    iree_task_executor_release(executor);
+    return status;
+  }
+  for (uint32_t i = 0; i < benchmark->worker_count; ++i) {
+    worker_stats[i].min_ns = IREE_TIME_INFINITE_FUTURE;
+  }
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  const iree_hal_executable_library_task_dispatch_t dispatch = {
+      .executable = local_executable,
+      .entry_point = FLAG_entry_point,
+      .dispatch_state = dispatch_state,
+      .worker_stats = worker_stats,
+  };
+  const uint32_t workgroup_size[3] = {
+      dispatch_state->workgroup_size_x,
+      dispatch_state->workgroup_size_y,
+      dispatch_state->workgroup_size_z,
+  };
+  const uint32_t workgroup_count[3] = {
+      dispatch_state->workgroup_count_x,
+      dispatch_state->workgroup_count_y,
+      dispatch_state->workgroup_count_z,
+  };
+
+  // Each iteration submits the dispatch and waits for it to complete such that
+  // the measured time includes the fork/join overhead real dispatches pay.
+  int64_t dispatch_count = 0;
+  const iree_time_t start_ns = iree_time_now();
+  while (iree_status_is_ok(status) &&
+         iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    iree_task_dispatch_t dispatch_task;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            iree_hal_executable_library_dispatch_tile, (void*)&dispatch),
+        workgroup_size, workgroup_count, &dispatch_task);
+    dispatch_task.local_memory_size = (uint32_t)local_memory_size;
+
+    iree_task_fence_t* fence = NULL;
+    status = iree_task_executor_acquire_fence(executor, &scope, &fence);
+    if (!iree_status_is_ok(status)) break;
+    iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_task.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    status = iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE);
+    if (iree_status_is_ok(status) && iree_task_scope_has_failed(&scope)) {
+      status = iree_task_scope_consume_status(&scope);
+    }
+    ++dispatch_count;
+  }
+  const iree_time_t wall_ns = iree_time_now() - start_ns;
+
+  if (iree_status_is_ok(status)) {
+    iree_benchmark_set_items_processed(
+        benchmark_state, dispatch_count * dispatch_state->workgroup_count_x *
+                             dispatch_state->workgroup_count_y *
+                             dispatch_state->workgroup_count_z);
+    iree_hal_executable_library_report_task_stats(
+        benchmark, worker_stats, dispatch_count, wall_ns, benchmark_state);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_allocator_free_aligned(host_allocator, worker_stats);
+  iree_task_executor_release(executor);
+  return status;
+}
 
 // NOTE: error handling is here just for better diagnostics: it is not tracking
 // allocations correctly and will leak. Don't use this as an example for how to
@@ -137,14 +427,14 @@ static iree_status_t iree_hal_executable_library_run(
     const iree_benchmark_def_t* benchmark_def,
     iree_benchmark_state_t* benchmark_state) {
   iree_allocator_t host_allocator = benchmark_state->host_allocator;
-  iree_hal_executable_plugin_manager_t* plugin_manager =
-      (iree_hal_executable_plugin_manager_t*)benchmark_def->user_data;
+  const iree_hal_executable_library_benchmark_t* benchmark =
+      (const iree_hal_executable_library_benchmark_t*)benchmark_def->user_data;
 
   // Register the loader used to load (or find) the executable.
   iree_hal_executable_loader_t* executable_loader = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_create_executable_loader_by_name(
-      iree_make_cstring_view(FLAG_executable_format), plugin_manager,
-      host_allocator, &executable_loader));
+      iree_make_cstring_view(FLAG_executable_format),
+      benchmark->plugin_manager, host_allocator, &executable_loader));
 
   // Setup the specification used to perform the executable load.
   // This information is normally used to select the appropriate loader but in
@@ -174,13 +464,14 @@ static iree_status_t iree_hal_executable_library_run(
   // Perform the load, which will fail if the executable cannot be loaded or
   // there was an issue with the layouts.
   iree_hal_executable_t* executable = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_hal_executable_loader_try_load(executable_loader, &executable_params,
-                                          /*worker_capacity=*/1, &executable));
+  IREE_RETURN_IF_ERROR(iree_hal_executable_loader_try_load(
+      executable_loader, &executable_params,
+      /*worker_capacity=*/iree_max(1u, benchmark->worker_count), &executable));
   iree_hal_local_executable_t* local_executable =
       iree_hal_local_executable_cast(executable);
 
-  // Allocate workgroup-local memory that each invocation can use.
+  // Allocate workgroup-local memory that each invocation can use. When running
+  // through the task system each worker provides its own.
   iree_byte_span_t local_memory = iree_make_byte_span(NULL, 0);
   iree_host_size_t local_memory_size =
       local_executable->dispatch_attrs
@@ -188,7 +479,7 @@ static iree_status_t iree_hal_executable_library_run(
                     .local_memory_pages *
                 IREE_HAL_WORKGROUP_LOCAL_MEMORY_PAGE_SIZE
           : 0;
-  if (local_memory_size > 0) {
+  if (local_memory_size > 0 && benchmark->worker_count == 0) {
     IREE_RETURN_IF_ERROR(iree_allocator_malloc(
         host_allocator, local_memory_size, (void**)&local_memory.data));
     local_memory.data_length = local_memory_size;
@@ -205,9 +496,9 @@ static iree_status_t iree_hal_executable_library_run(
   void* binding_ptrs[IREE_HAL_LOCAL_MAX_TOTAL_BINDING_COUNT];
   size_t binding_lengths[IREE_HAL_LOCAL_MAX_TOTAL_BINDING_COUNT];
   for (iree_host_size_t i = 0; i < dispatch_params.binding_count; ++i) {
-    IREE_RETURN_IF_ERROR(
-        iree_hal_buffer_view_parse(dispatch_params.bindings[i], /*device=*/NULL,
-                                   heap_allocator, &buffer_views[i]));
+    IREE_RETURN_IF_ERROR(iree_hal_executable_library_parse_binding(
+        dispatch_params.bindings[i], heap_allocator, host_allocator,
+        &buffer_views[i]));
     iree_hal_buffer_t* buffer = iree_hal_buffer_view_buffer(buffer_views[i]);
     iree_device_size_t buffer_length =
         iree_hal_buffer_view_byte_length(buffer_views[i]);
@@ -228,7 +519,9 @@ static iree_status_t iree_hal_executable_library_run(
       .workgroup_size_x = FLAG_workgroup_size_x,
       .workgroup_size_y = FLAG_workgroup_size_y,
       .workgroup_size_z = FLAG_workgroup_size_z,
-      .max_concurrency = FLAG_max_concurrency,
+      .max_concurrency =
+          benchmark->worker_count ? benchmark->worker_count
+                                  : FLAG_max_concurrency,
       .push_constant_count = dispatch_params.push_constant_count,
       .push_constants = &dispatch_params.push_constants[0].ui32,
       .binding_count = dispatch_params.binding_count,
@@ -241,20 +534,27 @@ static iree_status_t iree_hal_executable_library_run(
   // we are testing the memory access patterns: if we just ran the same single
   // tile processing the same exact region of memory over and over we are not
   // testing cache effects.
-  int64_t dispatch_count = 0;
-  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
-    IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_dispatch_inline(
-        local_executable, FLAG_entry_point, &dispatch_state, 0, local_memory));
-    ++dispatch_count;
-  }
+  if (benchmark->worker_count > 0) {
+    IREE_RETURN_IF_ERROR(iree_hal_executable_library_run_task(
+        benchmark, local_executable, &dispatch_state, local_memory_size,
+        host_allocator, benchmark_state));
+  } else {
+    int64_t dispatch_count = 0;
+    while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+      IREE_RETURN_IF_ERROR(iree_hal_local_executable_issue_dispatch_inline(
+          local_executable, FLAG_entry_point, &dispatch_state, 0,
+          local_memory));
+      ++dispatch_count;
+    }
 
-  // To get a total time per invocation we set the item count to the total
-  // invocations dispatched. That gives us both total dispatch and single
-  // invocation times in the reporter output.
-  int64_t total_invocations =
-      dispatch_count * dispatch_state.workgroup_count_x *
-      dispatch_state.workgroup_count_y * dispatch_state.workgroup_count_z;
-  iree_benchmark_set_items_processed(benchmark_state, total_invocations);
+    // To get a total time per invocation we set the item count to the total
+    // invocations dispatched. That gives us both total dispatch and single
+    // invocation times in the reporter output.
+    int64_t total_invocations =
+        dispatch_count * dispatch_state.workgroup_count_x *
+        dispatch_state.workgroup_count_y * dispatch_state.workgroup_count_z;
+    iree_benchmark_set_items_processed(benchmark_state, total_invocations);
+  }
 
   // Deallocate buffers.
   for (iree_host_size_t i = 0; i < dispatch_params.binding_count; ++i) {
@@ -287,6 +587,12 @@ int main(int argc, char** argv) {
       "executables (bypassing all of the IREE VM, HAL APIs, task system,\n"
       "etc).\n"
       "\n"
+      "Passing --task_worker_count= runs the dispatch through the task system\n"
+      "instead to measure how it scales across workers. Each workgroup is\n"
+      "timed and the distribution of workgroup times, worker utilization,\n"
+      "and speedup/scaling efficiency relative to the first worker count are\n"
+      "reported as counters.\n"
+      "\n"
       "Example --flagfile:\n"
       "  --executable_format=embedded-elf\n"
       "  --executable_file=iree/hal/local/elf/testdata/"
@@ -310,20 +616,57 @@ int main(int argc, char** argv) {
   IREE_CHECK_OK(iree_hal_executable_plugin_manager_create_from_flags(
       iree_allocator_system(), &plugin_manager));
 
-  // TODO(benvanik): override these with our own flags.
-  iree_benchmark_def_t benchmark_def = {
-      .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
-               IREE_BENCHMARK_FLAG_USE_REAL_TIME,
-      .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
-      .minimum_duration_ns = 0,
-      .iteration_count = 0,
-      .run = iree_hal_executable_library_run,
-      .user_data = plugin_manager,
-  };
-  iree_benchmark_register(iree_make_cstring_view("dispatch"), &benchmark_def);
+  // One benchmark per requested task system worker count or a single inline
+  // benchmark if none were requested.
+  const iree_flag_string_list_t worker_count_list =
+      FLAG_task_worker_count_list();
+  const iree_host_size_t benchmark_count =
+      iree_max(worker_count_list.count, (iree_host_size_t)1);
+  iree_hal_executable_library_benchmark_t* benchmarks = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(iree_allocator_system(),
+                                      benchmark_count * sizeof(*benchmarks),
+                                      (void**)&benchmarks));
+  for (iree_host_size_t i = 0; i < benchmark_count; ++i) {
+    benchmarks[i].plugin_manager = plugin_manager;
+    benchmarks[i].worker_count = 0;
+    benchmarks[i].is_scaling_baseline = false;
+    if (i < worker_count_list.count) {
+      int32_t worker_count = 0;
+      if (!iree_string_view_atoi_int32(worker_count_list.values[i],
+                                       &worker_count) ||
+          worker_count <= 0) {
+        fprintf(stderr, "invalid --task_worker_count=%.*s\n",
+                (int)worker_count_list.values[i].size,
+                worker_count_list.values[i].data);
+        return 1;
+      }
+      benchmarks[i].worker_count = (uint32_t)worker_count;
+      benchmarks[i].is_scaling_baseline = i == 0;
+    }
+
+    // TODO(benvanik): override these with our own flags.
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_executable_library_run,
+        .user_data = &benchmarks[i],
+    };
+    char name[64];
+    if (benchmarks[i].worker_count) {
+      snprintf(name, sizeof(name), "dispatch/task_workers:%u",
+               benchmarks[i].worker_count);
+    } else {
+      snprintf(name, sizeof(name), "dispatch");
+    }
+    iree_benchmark_register(iree_make_cstring_view(name), &benchmark_def);
+  }
 
   iree_benchmark_run_specified();
 
+  iree_allocator_free(iree_allocator_system(), benchmarks);
   iree_hal_executable_plugin_manager_release(plugin_manager);
   return 0;
 }
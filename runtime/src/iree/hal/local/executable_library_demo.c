@@ -36,6 +36,28 @@ static int dispatch_tile_a(
   return 0;
 }
 
+// The same as dispatch_tile_a but executing
+// |workgroup_state->workgroup_range_count| workgroups per call. Entry points
+// like this avoid the per-call overhead when a dispatch has many workgroups
+// that each perform very little work.
+static int dispatch_tile_a_range(
+    const iree_hal_executable_environment_v0_t* environment,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    const iree_hal_executable_workgroup_state_v0_t* workgroup_state) {
+  const dispatch_tile_a_push_constants_t* push_constants =
+      (const dispatch_tile_a_push_constants_t*)dispatch_state->push_constants;
+  const float* src = ((const float*)dispatch_state->binding_ptrs[0]);
+  float* dst = ((float*)dispatch_state->binding_ptrs[1]);
+  const uint32_t x_begin = workgroup_state->workgroup_id_x;
+  const uint32_t x_count = workgroup_state->workgroup_range_count
+                               ? workgroup_state->workgroup_range_count
+                               : 1;
+  for (uint32_t x = x_begin; x < x_begin + x_count; ++x) {
+    dst[x] = src[x] + push_constants->f0;
+  }
+  return 0;
+}
+
 // Just another entry point.
 static int dispatch_tile_b(
     const iree_hal_executable_environment_v0_t* environment,
@@ -56,30 +78,37 @@ static const iree_hal_executable_library_header_t header = {
     .sanitizer = IREE_HAL_EXECUTABLE_LIBRARY_SANITIZER_NONE,
 };
 // Table of export function entry points.
-static const iree_hal_executable_dispatch_v0_t entry_points[2] = {
+static const iree_hal_executable_dispatch_v0_t entry_points[3] = {
     dispatch_tile_a,
     dispatch_tile_b,
+    dispatch_tile_a_range,
 };
 // Optional attributes for each dispatch function used by the runtime.
 // The table can be omitted if no attributes are non-zero. We don't use
 // local_memory in our dispatches here and don't need to specify the sizes.
-static const iree_hal_executable_dispatch_attrs_v0_t entry_attrs[2] = {
+static const iree_hal_executable_dispatch_attrs_v0_t entry_attrs[3] = {
     {
         .local_memory_pages = 0,
     },
     {
         .local_memory_pages = 0,
     },
+    {
+        .local_memory_pages = 0,
+        .flags = IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0,
+    },
 };
 // Names for each entry point.
-static const char* entry_point_names[2] = {
+static const char* entry_point_names[3] = {
     "dispatch_tile_a",
     "dispatch_tile_b",
+    "dispatch_tile_a_range",
 };
 // User tags for debugging/logging; not used for anything but presentation.
-static const char* entry_point_tags[2] = {
+static const char* entry_point_tags[3] = {
     "matmul+div",
     "conv2d[512x512]",
+    "matmul+div",
 };
 static const iree_hal_executable_library_v0_t library = {
     .header = &header,
@@ -90,7 +119,7 @@ static const iree_hal_executable_library_v0_t library = {
         },
     .exports =
         {
-            .count = 2,
+            .count = 3,
             .ptrs = entry_points,
             .attrs = entry_attrs,
             .names = entry_point_names,
@@ -42,6 +42,10 @@ typedef union {
 //       push constants: 0
 //       bindings: 0
 //
+// [2] 'dispatch_tile_a_range': matmul+div
+//       the same as 'dispatch_tile_a' but executing ranges of workgroups
+//       (IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0)
+//
 const iree_hal_executable_library_header_t** demo_executable_library_query(
     iree_hal_executable_library_version_t max_version,
     const iree_hal_executable_environment_v0_t* environment);
@@ -121,5 +121,25 @@ int main(int argc, char** argv) {
     IREE_ASSERT_EQ(ret0[i], ret0_expected[i], "math is hard");
     all_match = all_match && ret0[i] == ret0_expected[i];
   }
+
+  // Workgroup range entry points can execute all workgroups in one call.
+  IREE_ASSERT_GT(library.v0->exports.count, 2,
+                 "expected the workgroup range entry point");
+  IREE_ASSERT(iree_all_bits_set(
+                  library.v0->exports.attrs[2].flags,
+                  IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0),
+              "expected the entry point to execute workgroup ranges");
+  memset(ret0, 0, sizeof(ret0));
+  workgroup_state.workgroup_id_x = 0;
+  workgroup_state.workgroup_id_y = 0;
+  workgroup_state.workgroup_id_z = 0;
+  workgroup_state.workgroup_range_count = dispatch_state.workgroup_count_x;
+  int ret = library.v0->exports.ptrs[2](&environment, &dispatch_state,
+                                        &workgroup_state);
+  IREE_ASSERT_EQ(ret, 0, "range entry point failed");
+  for (size_t i = 0; i < IREE_ARRAYSIZE(ret0_expected); ++i) {
+    IREE_ASSERT_EQ(ret0[i], ret0_expected[i], "math is still hard");
+    all_match = all_match && ret0[i] == ret0_expected[i];
+  }
   return all_match ? 0 : 1;
 }
@@ -6,6 +6,16 @@
 
 #include "iree/hal/local/executable_library_util.h"
 
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "iree/base/internal/call_once.h"
+#include "iree/base/internal/synchronization.h"
+
+#if defined(IREE_PLATFORM_LINUX)
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX
+
 iree_status_t iree_hal_executable_library_verify(
     const iree_hal_executable_params_t* executable_params,
     const iree_hal_executable_library_v0_t* library) {
@@ -98,6 +108,76 @@ void iree_hal_executable_library_deinitialize_imports(
   environment->import_thunk = NULL;
 }
 
+#if defined(IREE_PLATFORM_LINUX)
+
+// Process-wide perf map shared by all executables. The format is documented in
+// the Linux source at tools/perf/Documentation/jit-interface.txt.
+static struct {
+  iree_slim_mutex_t mutex;
+  FILE* file;
+} iree_hal_executable_perf_map;
+static iree_once_flag iree_hal_executable_perf_map_flag = IREE_ONCE_FLAG_INIT;
+static void iree_hal_executable_perf_map_initialize(void) {
+  iree_slim_mutex_initialize(&iree_hal_executable_perf_map.mutex);
+  char path[64];
+  snprintf(path, sizeof(path), "/tmp/perf-%d.map", (int)getpid());
+  // NOTE: intentionally never closed; entries must remain valid until perf
+  // processes the recording after the process exits.
+  iree_hal_executable_perf_map.file = fopen(path, "a");
+}
+
+void iree_hal_executable_library_publish_perf_map(
+    iree_string_view_t executable_identifier,
+    const iree_hal_executable_library_v0_t* library, const void* code_end) {
+  iree_call_once(&iree_hal_executable_perf_map_flag,
+                 iree_hal_executable_perf_map_initialize);
+  if (!iree_hal_executable_perf_map.file) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&iree_hal_executable_perf_map.mutex);
+  FILE* file = iree_hal_executable_perf_map.file;
+  for (uint32_t i = 0; i < library->exports.count; ++i) {
+    uintptr_t start = (uintptr_t)library->exports.ptrs[i];
+    if (!start) continue;
+
+    // Exports are usually few enough that a linear scan for the closest
+    // following export is cheaper than sorting.
+    uintptr_t end = (uintptr_t)code_end;
+    for (uint32_t j = 0; j < library->exports.count; ++j) {
+      uintptr_t other = (uintptr_t)library->exports.ptrs[j];
+      if (other > start && other < end) end = other;
+    }
+    if (end <= start) continue;
+
+    const char* name = library->exports.names && library->exports.names[i]
+                           ? library->exports.names[i]
+                           : NULL;
+    if (name) {
+      fprintf(file, "%" PRIxPTR " %" PRIxPTR " %.*s::%s\n", start, end - start,
+              (int)executable_identifier.size, executable_identifier.data,
+              name);
+    } else {
+      fprintf(file, "%" PRIxPTR " %" PRIxPTR " %.*s::export_%u\n", start,
+              end - start, (int)executable_identifier.size,
+              executable_identifier.data, i);
+    }
+  }
+  fflush(file);
+  iree_slim_mutex_unlock(&iree_hal_executable_perf_map.mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+#else
+
+void iree_hal_executable_library_publish_perf_map(
+    iree_string_view_t executable_identifier,
+    const iree_hal_executable_library_v0_t* library, const void* code_end) {
+  // No-op: perf maps are only supported on Linux.
+}
+
+#endif  // IREE_PLATFORM_LINUX
+
 #if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
 
 void iree_hal_executable_library_publish_source_files(
@@ -33,6 +33,19 @@ void iree_hal_executable_library_deinitialize_imports(
     iree_hal_executable_environment_v0_t* environment,
     iree_allocator_t host_allocator);
 
+// Appends entries for all exports in |library| to the Linux perf map of the
+// process (/tmp/perf-<pid>.map) so that `perf record`/`perf report` can
+// attribute samples in loader-allocated memory to dispatch functions.
+// Function sizes are not stored in libraries and are estimated as the distance
+// to the next export, with the last export extending to |code_end|.
+//
+// Best-effort: failures to write the map are ignored. Perf maps have no way to
+// remove entries and tools may misattribute samples if the address range of an
+// unloaded executable is later reused. No-op on platforms other than Linux.
+void iree_hal_executable_library_publish_perf_map(
+    iree_string_view_t executable_identifier,
+    const iree_hal_executable_library_v0_t* library, const void* code_end);
+
 #if defined(IREE_HAL_EXECUTABLE_LIBRARY_CALL_HOOK)
 #if !IREE_HAVE_ATTRIBUTE_WEAK
 #error IREE_HAL_EXECUTABLE_LIBRARY_CALL_HOOK requires toolchain support for weak symbols.
@@ -142,10 +142,13 @@ typedef uint32_t iree_hal_executable_plugin_version_t;
 
 #define IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_1 0x00000001u
 
+// Adds iree_hal_executable_plugin_v0_t::query_kernels.
+#define IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2 0x00000002u
+
 // The latest version of the plugin API; can be used to populate the
 // iree_hal_executable_plugin_header_t::version when building plugins.
 #define IREE_HAL_EXECUTABLE_PLUGIN_VERSION_LATEST \
-  IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_1
+  IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2
 
 // A header present at the top of all versions of the plugin API used by the
 // runtime to ensure version compatibility.
@@ -390,6 +393,84 @@ typedef struct iree_hal_executable_plugin_resolve_params_v0_t {
   void** out_fn_contexts;
 } iree_hal_executable_plugin_resolve_params_v0_t;
 
+// A constraint on the size of one dimension of the problem a kernel can be
+// invoked with. The dimension ordinals are defined by the logical operation the
+// kernel implements (such as M, N, K for a matmul).
+typedef struct iree_hal_executable_plugin_kernel_predicate_v0_t {
+  // Ordinal of the dimension in the operation shape.
+  uint32_t dim;
+  // The dimension size must be a multiple of this value or 0 if any.
+  uint32_t divisor;
+  // Inclusive range of allowed dimension sizes.
+  int64_t min_size;
+  int64_t max_size;
+} iree_hal_executable_plugin_kernel_predicate_v0_t;
+
+// A tuned kernel implementing a logical operation for the problem shapes
+// matching all of its predicates.
+typedef struct iree_hal_executable_plugin_kernel_v0_t {
+  // Import symbol name the kernel is resolved by. Unique within the plugin.
+  const char* symbol_name;
+  // Logical operation the kernel implements (such as `matmul_f32f32f32`).
+  // Multiple kernels may implement the same operation for different shapes.
+  const char* op_name;
+  // Function pointer and optional context as would be returned by resolve.
+  void* fn_ptr;
+  void* fn_context;
+  // Relative cost of invoking the kernel; when multiple kernels implementing
+  // the same operation match a shape the one with the lowest cost is used.
+  uint32_t cost;
+  // Predicates that must all hold for the kernel to be used.
+  uint32_t predicate_count;
+  const iree_hal_executable_plugin_kernel_predicate_v0_t* predicates;
+} iree_hal_executable_plugin_kernel_v0_t;
+
+// A table of tuned kernels exported by a plugin.
+typedef struct iree_hal_executable_plugin_kernel_table_v0_t {
+  // Total number of kernels in the table.
+  size_t count;
+  // Kernels sorted by symbol_name.
+  const iree_hal_executable_plugin_kernel_v0_t* kernels;
+} iree_hal_executable_plugin_kernel_table_v0_t;
+
+// Returns true if the |dim_count| dimension sizes in |dims| meet all of the
+// predicates of |kernel|. Predicates referencing dimensions not present fail.
+static inline bool iree_hal_executable_plugin_kernel_matches(
+    const iree_hal_executable_plugin_kernel_v0_t* kernel, size_t dim_count,
+    const int64_t* dims) {
+  for (uint32_t i = 0; i < kernel->predicate_count; ++i) {
+    const iree_hal_executable_plugin_kernel_predicate_v0_t* predicate =
+        &kernel->predicates[i];
+    if (predicate->dim >= dim_count) return false;
+    const int64_t size = dims[predicate->dim];
+    if (size < predicate->min_size || size > predicate->max_size) return false;
+    if (predicate->divisor > 1 && (size % predicate->divisor) != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns the lowest cost kernel in |table| implementing |op_name| that
+// matches the |dim_count| dimension sizes in |dims| or NULL if none match.
+static inline const iree_hal_executable_plugin_kernel_v0_t*
+iree_hal_executable_plugin_select_kernel(
+    const iree_hal_executable_plugin_kernel_table_v0_t* table,
+    const char* op_name, size_t dim_count, const int64_t* dims) {
+  const iree_hal_executable_plugin_kernel_v0_t* best_kernel = NULL;
+  for (size_t i = 0; table && i < table->count; ++i) {
+    const iree_hal_executable_plugin_kernel_v0_t* kernel = &table->kernels[i];
+    if (best_kernel && kernel->cost >= best_kernel->cost) continue;
+    if (iree_hal_executable_plugin_strcmp(kernel->op_name, op_name) != 0) {
+      continue;
+    }
+    if (iree_hal_executable_plugin_kernel_matches(kernel, dim_count, dims)) {
+      best_kernel = kernel;
+    }
+  }
+  return best_kernel;
+}
+
 typedef iree_hal_executable_plugin_status_t (
     *iree_hal_executable_plugin_resolve_fn_v0_t)(
     void* self, const iree_hal_executable_plugin_resolve_params_v0_t* params,
@@ -457,7 +538,21 @@ typedef struct iree_hal_executable_plugin_v0_t {
   // walk vs potential O(nlogn)/O(n^2)). For example if JITing many similar
   // ukernel variants (matmul_Ma_Na_Ka, matmul_Mb_Nb_Kb, etc) a resolver can
   // avoid big switch tables.
+  //
+  // May be NULL if the plugin only exports kernels via |query_kernels|.
   iree_hal_executable_plugin_resolve_fn_v0_t resolve;
+
+  // IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2+
+  // Optional; returns the table of tuned kernels exported by the plugin
+  // instance |self|. Queried once after load and must remain valid until
+  // unload.
+  //
+  // Imports matching kernel symbol names are resolved by the runtime directly
+  // from the table prior to calling |resolve| for any that remain. Compilers
+  // targeting the plugin may use the kernel predicates and costs to choose
+  // which kernel symbol to import for a particular operation shape.
+  const iree_hal_executable_plugin_kernel_table_v0_t* (*query_kernels)(
+      void* self);
 } iree_hal_executable_plugin_v0_t;
 
 #ifdef __cplusplus
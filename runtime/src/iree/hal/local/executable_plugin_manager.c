@@ -188,11 +188,28 @@ iree_status_t iree_hal_executable_plugin_initialize(
   memset(&out_base_plugin->library, 0, sizeof(out_base_plugin->library));
   out_base_plugin->self = NULL;
   out_base_plugin->resolve_thunk = resolve_thunk;
+  out_base_plugin->kernels = NULL;
 
   // Try to load the plugin; this may fail if the plugin is not supported
   // (version, features, etc) or the plugin decides it doesn't like Tuesdays.
   iree_status_t status = iree_hal_executable_plugin_load(
       header_ptr, param_count, params, host_allocator, out_base_plugin);
+
+  // Query the kernel table from plugins new enough to have one.
+  const iree_hal_executable_plugin_v0_t* v0 = out_base_plugin->library.v0;
+  if (iree_status_is_ok(status) &&
+      v0->header->version >= IREE_HAL_EXECUTABLE_PLUGIN_VERSION_0_2 &&
+      v0->query_kernels) {
+    out_base_plugin->kernels = v0->query_kernels(out_base_plugin->self);
+  }
+  if (iree_status_is_ok(status) && !v0->resolve && !out_base_plugin->kernels) {
+    status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "plugin `%.*s` provides neither a resolver nor a "
+                              "kernel table",
+                              (int)out_base_plugin->identifier.size,
+                              out_base_plugin->identifier.data);
+  }
+
   if (iree_status_is_ok(status)) {
     IREE_TRACE({
       const iree_hal_executable_plugin_header_t* header =
@@ -218,6 +235,7 @@ void iree_hal_executable_plugin_destroy(iree_hal_executable_plugin_t* plugin) {
   }
   memset(&plugin->library, 0, sizeof(plugin->library));
   plugin->self = NULL;
+  plugin->kernels = NULL;
 
   plugin->vtable->destroy(plugin);
 
@@ -237,6 +255,59 @@ void iree_hal_executable_plugin_release(iree_hal_executable_plugin_t* plugin) {
   }
 }
 
+// Returns the kernel in |table| with the given |symbol_name| or NULL if not
+// found. Kernels are sorted by symbol name.
+static const iree_hal_executable_plugin_kernel_v0_t*
+iree_hal_executable_plugin_lookup_kernel(
+    const iree_hal_executable_plugin_kernel_table_v0_t* table,
+    const char* symbol_name) {
+  size_t low = 0;
+  size_t high = table->count;
+  while (low < high) {
+    const size_t mid = low + (high - low) / 2;
+    const iree_hal_executable_plugin_kernel_v0_t* kernel = &table->kernels[mid];
+    const int cmp =
+        iree_hal_executable_plugin_strcmp(kernel->symbol_name, symbol_name);
+    if (cmp == 0) return kernel;
+    if (cmp < 0) {
+      low = mid + 1;
+    } else {
+      high = mid;
+    }
+  }
+  return NULL;
+}
+
+// Resolves all unresolved imports in |symbol_names| that are present in the
+// plugin kernel |table|. Returns true if all required imports are resolved and
+// sets the MISSING_OPTIONAL bit in |out_resolution| if any optional imports
+// remain unresolved.
+static bool iree_hal_executable_plugin_resolve_kernels(
+    const iree_hal_executable_plugin_kernel_table_v0_t* table,
+    iree_host_size_t count, const char* const* symbol_names, void** out_fn_ptrs,
+    void** out_fn_contexts,
+    iree_hal_executable_plugin_resolution_t* out_resolution) {
+  bool all_required_resolved = true;
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    if (out_fn_ptrs[i]) continue;
+    const char* symbol_name = symbol_names[i];
+    const bool is_optional =
+        iree_hal_executable_plugin_import_is_optional(symbol_name);
+    if (is_optional) ++symbol_name;
+    const iree_hal_executable_plugin_kernel_v0_t* kernel =
+        iree_hal_executable_plugin_lookup_kernel(table, symbol_name);
+    if (kernel) {
+      out_fn_ptrs[i] = kernel->fn_ptr;
+      out_fn_contexts[i] = kernel->fn_context;
+    } else if (is_optional) {
+      *out_resolution |= IREE_HAL_EXECUTABLE_PLUGIN_RESOLUTION_MISSING_OPTIONAL;
+    } else {
+      all_required_resolved = false;
+    }
+  }
+  return all_required_resolved;
+}
+
 // NOTE: must match iree_hal_executable_import_provider_t.resolve.
 static iree_status_t iree_hal_executable_plugin_resolve(
     void* self, iree_host_size_t count, const char* const* symbol_names,
@@ -251,19 +322,38 @@ static iree_status_t iree_hal_executable_plugin_resolve(
   IREE_TRACE_ZONE_APPEND_TEXT(z0, plugin->identifier.data,
                               plugin->identifier.size);
 
-  const iree_hal_executable_plugin_resolve_params_v0_t params = {
-      .count = (size_t)count,
-      .symbol_names = symbol_names,
-      .out_fn_ptrs = out_fn_ptrs,
-      .out_fn_contexts = out_fn_contexts,
-  };
+  // Resolve from the kernel table first as it requires no calls into the
+  // plugin. Only if imports remain do we fall back to the plugin resolver.
   iree_hal_executable_plugin_resolution_t resolution = 0;
-  iree_status_t status =
-      plugin->resolve_thunk
-          ? plugin->resolve_thunk(plugin->library.v0->resolve, plugin->self,
-                                  &params, &resolution)
-          : (iree_status_t)plugin->library.v0->resolve(plugin->self, &params,
-                                                       &resolution);
+  bool all_resolved = true;
+  bool all_required_resolved = true;
+  if (plugin->kernels) {
+    all_required_resolved = iree_hal_executable_plugin_resolve_kernels(
+        plugin->kernels, count, symbol_names, out_fn_ptrs, out_fn_contexts,
+        &resolution);
+    all_resolved = all_required_resolved && resolution == 0;
+  }
+
+  iree_status_t status = iree_ok_status();
+  if ((!plugin->kernels || !all_resolved) && plugin->library.v0->resolve) {
+    const iree_hal_executable_plugin_resolve_params_v0_t params = {
+        .count = (size_t)count,
+        .symbol_names = symbol_names,
+        .out_fn_ptrs = out_fn_ptrs,
+        .out_fn_contexts = out_fn_contexts,
+    };
+    resolution = 0;
+    status =
+        plugin->resolve_thunk
+            ? plugin->resolve_thunk(plugin->library.v0->resolve, plugin->self,
+                                    &params, &resolution)
+            : (iree_status_t)plugin->library.v0->resolve(plugin->self, &params,
+                                                         &resolution);
+  } else if (!all_required_resolved) {
+    // NOTE: the plugin manager builds the full error message listing the
+    // missing imports once all providers have been queried.
+    status = iree_status_from_code(IREE_STATUS_NOT_FOUND);
+  }
   *out_resolution = (iree_hal_executable_import_resolution_t)resolution;
 
   IREE_TRACE_ZONE_END(z0);
@@ -37,6 +37,8 @@ typedef struct iree_hal_executable_plugin_t {
   void* self;
   iree_string_view_t identifier;
   iree_hal_executable_plugin_resolve_thunk_t resolve_thunk;
+  // Optional tuned kernel table queried from the plugin after loading.
+  const iree_hal_executable_plugin_kernel_table_v0_t* kernels;
 } iree_hal_executable_plugin_t;
 
 // Initializes the base iree_hal_executable_plugin_t type using the given
@@ -17,6 +17,7 @@
 #include "iree/hal/local/executable_library.h"
 #include "iree/hal/local/local_executable.h"
 #include "iree/hal/local/local_pipeline_layout.h"
+#include "iree/hal/local/shm_channel.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_inline_command_buffer_t
@@ -357,8 +358,8 @@ static iree_status_t iree_hal_inline_command_buffer_collective(
     iree_hal_collective_op_t op, uint32_t param,
     iree_hal_buffer_binding_t send_binding,
     iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
-  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
-                          "collectives not yet implemented on CPU");
+  return iree_hal_shm_channel_collective_bindings(
+      channel, op, param, send_binding, recv_binding, element_count);
 }
 
 //===----------------------------------------------------------------------===//
@@ -81,11 +81,14 @@ static iree_status_t iree_hal_elf_executable_query_library(
 
   executable->identifier = iree_make_cstring_view(header->name);
   executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+  executable->base.export_names = executable->library.v0->exports.names;
+  executable->base.export_count = executable->library.v0->exports.count;
   return iree_ok_status();
 }
 
 static iree_status_t iree_hal_elf_executable_create(
     const iree_hal_executable_params_t* executable_params,
+    iree_hal_embedded_elf_loader_flags_t loader_flags,
     const iree_hal_executable_import_provider_t import_provider,
     iree_allocator_t host_allocator, iree_hal_executable_t** out_executable) {
   IREE_ASSERT_ARGUMENT(executable_params);
@@ -131,9 +134,29 @@ static iree_status_t iree_hal_elf_executable_create(
 
   // Attempt to load the ELF module.
   if (iree_status_is_ok(status)) {
-    status = iree_elf_module_initialize_from_memory(
-        executable_params->executable_data, /*import_table=*/NULL,
-        host_allocator, &executable->module);
+    // Map directly from the source file if one was provided so that pages can
+    // be shared with other processes.
+    iree_elf_module_file_t file = {
+        .fd = -1,
+        .offset = executable_params->executable_file_offset,
+    };
+    if (executable_params->executable_file &&
+        iree_io_file_handle_type(executable_params->executable_file) ==
+            IREE_IO_FILE_HANDLE_TYPE_FD) {
+      file.fd =
+          iree_io_file_handle_value(executable_params->executable_file).fd;
+    }
+    iree_elf_module_flags_t module_flags = IREE_ELF_MODULE_FLAG_NONE;
+    if (loader_flags & IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LARGE_PAGES) {
+      module_flags |= IREE_ELF_MODULE_FLAG_LARGE_PAGES;
+    }
+    if (loader_flags &
+        IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_DEBUGGER_REGISTRATION) {
+      module_flags |= IREE_ELF_MODULE_FLAG_DEBUGGER_REGISTRATION;
+    }
+    status = iree_elf_module_initialize_from_file(
+        executable_params->executable_data, file, module_flags,
+        /*import_table=*/NULL, host_allocator, &executable->module);
   }
 
   // Query metadata and get the entry point function pointers.
@@ -161,6 +184,14 @@ static iree_status_t iree_hal_elf_executable_create(
     iree_hal_executable_library_publish_source_files(executable->library.v0);
   }
 
+  // Publish the exports to the perf map so samples can be attributed.
+  if (iree_status_is_ok(status) &&
+      (loader_flags & IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_PERF_MAP)) {
+    iree_hal_executable_library_publish_perf_map(
+        executable->identifier, executable->library.v0,
+        executable->module.vaddr_base + executable->module.vaddr_size);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_executable = (iree_hal_executable_t*)executable;
   } else {
@@ -237,6 +268,7 @@ static const iree_hal_local_executable_vtable_t iree_hal_elf_executable_vtable =
 typedef struct iree_hal_embedded_elf_loader_t {
   iree_hal_executable_loader_t base;
   iree_allocator_t host_allocator;
+  iree_hal_embedded_elf_loader_flags_t flags;
   iree_hal_executable_plugin_manager_t* plugin_manager;
 } iree_hal_embedded_elf_loader_t;
 
@@ -247,6 +279,16 @@ iree_status_t iree_hal_embedded_elf_loader_create(
     iree_hal_executable_plugin_manager_t* plugin_manager,
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader) {
+  return iree_hal_embedded_elf_loader_create_with_flags(
+      IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_NONE, plugin_manager, host_allocator,
+      out_executable_loader);
+}
+
+iree_status_t iree_hal_embedded_elf_loader_create_with_flags(
+    iree_hal_embedded_elf_loader_flags_t flags,
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader) {
   IREE_ASSERT_ARGUMENT(out_executable_loader);
   *out_executable_loader = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -260,6 +302,7 @@ iree_status_t iree_hal_embedded_elf_loader_create(
         iree_hal_executable_plugin_manager_provider(plugin_manager),
         &executable_loader->base);
     executable_loader->host_allocator = host_allocator;
+    executable_loader->flags = flags;
     executable_loader->plugin_manager = plugin_manager;
     iree_hal_executable_plugin_manager_retain(
         executable_loader->plugin_manager);
@@ -301,7 +344,8 @@ static iree_status_t iree_hal_embedded_elf_loader_try_load(
 
   // Perform the load of the ELF and wrap it in an executable handle.
   iree_status_t status = iree_hal_elf_executable_create(
-      executable_params, base_executable_loader->import_provider,
+      executable_params, executable_loader->flags,
+      base_executable_loader->import_provider,
       executable_loader->host_allocator, out_executable);
 
   IREE_TRACE_ZONE_END(z0);
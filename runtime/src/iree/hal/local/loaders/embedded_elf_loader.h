@@ -20,6 +20,21 @@ extern "C" {
 typedef struct iree_hal_executable_plugin_manager_t
     iree_hal_executable_plugin_manager_t;
 
+// Flags controlling embedded ELF loader behavior.
+enum iree_hal_embedded_elf_loader_flag_bits_t {
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_NONE = 0u,
+  // Loads executable code into memory that may be backed by large pages where
+  // supported. Reduces instruction TLB pressure for large executables.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LARGE_PAGES = 1u << 0,
+  // Publishes loaded executable exports to the Linux perf map so that
+  // `perf record` can attribute samples to dispatch functions.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_PERF_MAP = 1u << 1,
+  // Registers loaded executables with debuggers implementing the GDB JIT
+  // interface (gdb and lldb) so that symbols and debug info are available.
+  IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_DEBUGGER_REGISTRATION = 1u << 2,
+};
+typedef uint32_t iree_hal_embedded_elf_loader_flags_t;
+
 // Creates an executable loader that can load minimally-featured ELF dynamic
 // libraries on any platform. This allows us to use a single file format across
 // all operating systems at the cost of some missing debugging/profiling
@@ -29,6 +44,14 @@ iree_status_t iree_hal_embedded_elf_loader_create(
     iree_allocator_t host_allocator,
     iree_hal_executable_loader_t** out_executable_loader);
 
+// Creates an embedded ELF executable loader as with
+// iree_hal_embedded_elf_loader_create with the specified |flags|.
+iree_status_t iree_hal_embedded_elf_loader_create_with_flags(
+    iree_hal_embedded_elf_loader_flags_t flags,
+    iree_hal_executable_plugin_manager_t* plugin_manager,
+    iree_allocator_t host_allocator,
+    iree_hal_executable_loader_t** out_executable_loader);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,6 +6,8 @@
 
 #include "iree/hal/local/loaders/registration/init.h"
 
+#include "iree/base/internal/flags.h"
+
 // NOTE: we register in a specific order to allow for prioritization:
 // - system-library: used when embedded is not desired (TSAN/debugging/etc).
 // - embedded-elf: default codegen portable ELF output format.
@@ -17,6 +19,39 @@
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
 #include "iree/hal/local/loaders/embedded_elf_loader.h"
+
+IREE_FLAG(
+    bool, executable_large_pages, false,
+    "Requests that embedded ELF executable code be backed by transparent\n"
+    "large pages to reduce instruction TLB misses. Only executables with\n"
+    "code and data at least the large page size are affected.");
+
+IREE_FLAG(
+    bool, executable_perf_map, false,
+    "Appends embedded ELF executable exports to /tmp/perf-<pid>.map as they\n"
+    "are loaded so that Linux `perf` can attribute samples to dispatches.");
+
+IREE_FLAG(
+    bool, executable_debugger_registration, false,
+    "Registers embedded ELF executables with debuggers using the GDB JIT\n"
+    "interface so that gdb and lldb can resolve their symbols. Retains a\n"
+    "copy of each executable for as long as it is loaded.");
+
+static iree_hal_embedded_elf_loader_flags_t
+iree_hal_embedded_elf_loader_flags_from_flags(void) {
+  iree_hal_embedded_elf_loader_flags_t flags =
+      IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_NONE;
+  if (FLAG_executable_large_pages) {
+    flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_LARGE_PAGES;
+  }
+  if (FLAG_executable_perf_map) {
+    flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_PERF_MAP;
+  }
+  if (FLAG_executable_debugger_registration) {
+    flags |= IREE_HAL_EMBEDDED_ELF_LOADER_FLAG_DEBUGGER_REGISTRATION;
+  }
+  return flags;
+}
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_VMVX_MODULE)
@@ -59,8 +94,9 @@ IREE_API_EXPORT iree_status_t iree_hal_create_all_available_executable_loaders(
 
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
   if (iree_status_is_ok(status)) {
-    status = iree_hal_embedded_elf_loader_create(plugin_manager, host_allocator,
-                                                 &loaders[count++]);
+    status = iree_hal_embedded_elf_loader_create_with_flags(
+        iree_hal_embedded_elf_loader_flags_from_flags(), plugin_manager,
+        host_allocator, &loaders[count++]);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
@@ -89,8 +125,9 @@ IREE_API_EXPORT iree_status_t iree_hal_create_executable_loader_by_name(
     iree_hal_executable_loader_t** out_executable_loader) {
 #if defined(IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF)
   if (iree_string_view_starts_with(name, IREE_SV("embedded-elf"))) {
-    return iree_hal_embedded_elf_loader_create(plugin_manager, host_allocator,
-                                               out_executable_loader);
+    return iree_hal_embedded_elf_loader_create_with_flags(
+        iree_hal_embedded_elf_loader_flags_from_flags(), plugin_manager,
+        host_allocator, out_executable_loader);
   }
 #endif  // IREE_HAVE_HAL_EXECUTABLE_LOADER_EMBEDDED_ELF
 
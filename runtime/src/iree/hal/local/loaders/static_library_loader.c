@@ -74,6 +74,8 @@ static iree_status_t iree_hal_static_executable_create(
     executable->library.header = library_header;
     executable->identifier = iree_make_cstring_view((*library_header)->name);
     executable->base.dispatch_attrs = executable->library.v0->exports.attrs;
+    executable->base.export_names = executable->library.v0->exports.names;
+    executable->base.export_count = executable->library.v0->exports.count;
   }
 
   // Copy executable constants so we own them.
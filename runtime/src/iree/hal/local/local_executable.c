@@ -27,6 +27,11 @@ void iree_hal_local_executable_initialize(
 
   // Function attributes are optional and populated by the parent type.
   out_base_executable->dispatch_attrs = NULL;
+  out_base_executable->export_count = 0;
+  out_base_executable->export_names = NULL;
+  out_base_executable->dispatch_profile = NULL;
+  out_base_executable->dispatch_counters = NULL;
+  out_base_executable->dispatch_counter_slots = NULL;
 
   // Default environment with no imports assigned.
   iree_hal_executable_environment_initialize(host_allocator,
@@ -35,12 +40,39 @@ void iree_hal_local_executable_initialize(
 
 void iree_hal_local_executable_deinitialize(
     iree_hal_local_executable_t* base_executable) {
+  iree_hal_local_dispatch_profile_release(base_executable->dispatch_profile);
+  iree_hal_local_dispatch_counters_release(base_executable->dispatch_counters);
+  iree_allocator_free(base_executable->host_allocator,
+                      base_executable->dispatch_counter_slots);
   for (iree_host_size_t i = 0; i < base_executable->pipeline_layout_count;
        ++i) {
     iree_hal_pipeline_layout_release(base_executable->pipeline_layouts[i]);
   }
 }
 
+iree_status_t iree_hal_local_executable_set_dispatch_counters(
+    iree_hal_local_executable_t* executable,
+    iree_hal_local_dispatch_counters_t* dispatch_counters) {
+  IREE_ASSERT_ARGUMENT(executable);
+  if (!dispatch_counters || !executable->export_names) return iree_ok_status();
+  IREE_ASSERT(!executable->dispatch_counters);
+  iree_hal_local_dispatch_counters_slot_t** slots = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      executable->host_allocator,
+      executable->export_count * sizeof(*slots) + 1, (void**)&slots));
+  iree_status_t status = iree_hal_local_dispatch_counters_resolve(
+      dispatch_counters, executable->export_count, executable->export_names,
+      slots);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(executable->host_allocator, slots);
+    return status;
+  }
+  iree_hal_local_dispatch_counters_retain(dispatch_counters);
+  executable->dispatch_counters = dispatch_counters;
+  executable->dispatch_counter_slots = slots;
+  return iree_ok_status();
+}
+
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value) {
   return (iree_hal_local_executable_t*)base_value;
@@ -54,10 +86,40 @@ iree_status_t iree_hal_local_executable_issue_call(
   IREE_ASSERT_ARGUMENT(executable);
   IREE_ASSERT_ARGUMENT(dispatch_state);
   IREE_ASSERT_ARGUMENT(workgroup_state);
-  return ((const iree_hal_local_executable_vtable_t*)
-              executable->resource.vtable)
-      ->issue_call(executable, ordinal, dispatch_state, workgroup_state,
-                   worker_id);
+  const iree_hal_local_executable_vtable_t* vtable =
+      (const iree_hal_local_executable_vtable_t*)executable->resource.vtable;
+  if (IREE_LIKELY(!executable->dispatch_counters) ||
+      ordinal >= executable->export_count) {
+    return vtable->issue_call(executable, ordinal, dispatch_state,
+                              workgroup_state, worker_id);
+  }
+  iree_hal_local_dispatch_counters_sample_t sample;
+  iree_hal_local_dispatch_counters_begin(executable->dispatch_counters,
+                                         worker_id, &sample);
+  iree_status_t status = vtable->issue_call(executable, ordinal, dispatch_state,
+                                            workgroup_state, worker_id);
+  iree_hal_local_dispatch_counters_end(
+      executable->dispatch_counters, worker_id,
+      executable->dispatch_counter_slots[ordinal], &sample);
+  return status;
+}
+
+// Records a dispatch of |ordinal| that began at |start_ns| into the profile of
+// |executable|. Only called while the profile is capturing.
+static void iree_hal_local_executable_record_dispatch(
+    iree_hal_local_executable_t* executable, iree_host_size_t ordinal,
+    const iree_hal_executable_dispatch_state_v0_t* dispatch_state,
+    iree_time_t start_ns) {
+  iree_time_t end_ns = iree_time_now();
+  if (!executable->export_names) return;
+  iree_device_size_t bindings_length = 0;
+  for (iree_host_size_t i = 0; i < dispatch_state->binding_count; ++i) {
+    bindings_length += dispatch_state->binding_lengths[i];
+  }
+  iree_hal_local_dispatch_profile_record(
+      executable->dispatch_profile,
+      iree_make_cstring_view(executable->export_names[ordinal]),
+      end_ns - start_ns, bindings_length);
 }
 
 iree_status_t iree_hal_local_executable_issue_dispatch_inline(
@@ -67,6 +129,10 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
   IREE_TRACE_ZONE_BEGIN(z0);
   // TODO(benvanik): annotate with executable name to calculate total time.
 
+  const bool is_profiling = iree_hal_local_dispatch_profile_is_capturing(
+      executable->dispatch_profile);
+  const iree_time_t start_ns = is_profiling ? iree_time_now() : 0;
+
   const uint32_t workgroup_count_x = dispatch_state->workgroup_count_x;
   const uint32_t workgroup_count_y = dispatch_state->workgroup_count_y;
   const uint32_t workgroup_count_z = dispatch_state->workgroup_count_z;
@@ -91,13 +157,70 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
       .processor_id = processor_id,
       .local_memory = local_memory.data,
       .local_memory_size = (size_t)local_memory.data_length,
+      .workgroup_range_count = 1,
+      .processor_cluster_id = UINT16_MAX,
   };
+
+  // Workgroup range entry points can execute the whole grid in as few calls
+  // as the range count allows.
+  if (executable->dispatch_attrs &&
+      iree_all_bits_set(executable->dispatch_attrs[ordinal].flags,
+                        IREE_HAL_EXECUTABLE_DISPATCH_FLAG_WORKGROUP_RANGE_V0)) {
+    const uint64_t workgroup_count_xy =
+        (uint64_t)workgroup_count_x * workgroup_count_y;
+    const uint64_t workgroup_count = workgroup_count_xy * workgroup_count_z;
+    for (uint64_t i = 0; i < workgroup_count;) {
+      workgroup_state.workgroup_id_x = (uint32_t)(i % workgroup_count_x);
+      workgroup_state.workgroup_id_y =
+          (uint32_t)((i / workgroup_count_x) % workgroup_count_y);
+      workgroup_state.workgroup_id_z = (uint16_t)(i / workgroup_count_xy);
+      workgroup_state.workgroup_range_count =
+          (uint32_t)iree_min(workgroup_count - i, (uint64_t)UINT32_MAX);
+      const uint64_t next_i =
+          i + workgroup_state.workgroup_range_count < workgroup_count
+              ? i + workgroup_state.workgroup_range_count
+              : i;
+      workgroup_state.next_workgroup_id_x =
+          (uint32_t)(next_i % workgroup_count_x);
+      workgroup_state.next_workgroup_id_y =
+          (uint32_t)((next_i / workgroup_count_x) % workgroup_count_y);
+      workgroup_state.next_workgroup_id_z =
+          (uint16_t)(next_i / workgroup_count_xy);
+      status = iree_hal_local_executable_issue_call(
+          executable, ordinal, dispatch_state, &workgroup_state,
+          /*worker_id=*/0);
+      if (!iree_status_is_ok(status)) break;
+      i += workgroup_state.workgroup_range_count;
+    }
+    if (is_profiling && iree_status_is_ok(status)) {
+      iree_hal_local_executable_record_dispatch(executable, ordinal,
+                                                dispatch_state, start_ns);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
   for (uint32_t z = 0; z < workgroup_count_z; ++z) {
     workgroup_state.workgroup_id_z = z;
     for (uint32_t y = 0; y < workgroup_count_y; ++y) {
       workgroup_state.workgroup_id_y = y;
       for (uint32_t x = 0; x < workgroup_count_x; ++x) {
         workgroup_state.workgroup_id_x = x;
+        // Next workgroup in execution order (or this one if it's the last).
+        uint32_t next_xyz[3] = {x, y, z};
+        if (x + 1 < workgroup_count_x) {
+          next_xyz[0] = x + 1;
+        } else if (y + 1 < workgroup_count_y) {
+          next_xyz[0] = 0;
+          next_xyz[1] = y + 1;
+        } else if (z + 1 < workgroup_count_z) {
+          next_xyz[0] = 0;
+          next_xyz[1] = 0;
+          next_xyz[2] = z + 1;
+        }
+        workgroup_state.next_workgroup_id_x = next_xyz[0];
+        workgroup_state.next_workgroup_id_y = next_xyz[1];
+        workgroup_state.next_workgroup_id_z = (uint16_t)next_xyz[2];
         status = iree_hal_local_executable_issue_call(
             executable, ordinal, dispatch_state, &workgroup_state,
             /*worker_id=*/0);
@@ -106,6 +229,11 @@ iree_status_t iree_hal_local_executable_issue_dispatch_inline(
     }
   }
 
+  if (is_profiling && iree_status_is_ok(status)) {
+    iree_hal_local_executable_record_dispatch(executable, ordinal,
+                                              dispatch_state, start_ns);
+  }
+
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
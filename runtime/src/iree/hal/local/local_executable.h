@@ -9,6 +9,8 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/dispatch_counters.h"
+#include "iree/hal/local/dispatch_profile.h"
 #include "iree/hal/local/executable_library.h"
 
 #ifdef __cplusplus
@@ -35,6 +37,23 @@ typedef struct iree_hal_local_executable_t {
   // of memory required by the function.
   const iree_hal_executable_dispatch_attrs_v0_t* dispatch_attrs;
 
+  // Optional per-entry point names used when recording dispatch profiles.
+  // Populated by the parent type when the executable format has them along
+  // with the total number of entry points.
+  iree_host_size_t export_count;
+  const char* const* export_names;
+
+  // Optional profile dispatches are recorded into while it is capturing.
+  // Retained by the executable; assigned by the executable cache.
+  iree_hal_local_dispatch_profile_t* dispatch_profile;
+
+  // Optional counters each workgroup call is measured into.
+  // Retained by the executable; assigned by the executable cache with
+  // iree_hal_local_executable_set_dispatch_counters.
+  iree_hal_local_dispatch_counters_t* dispatch_counters;
+  // One accumulator per entry point in |dispatch_counters|.
+  iree_hal_local_dispatch_counters_slot_t** dispatch_counter_slots;
+
   // Execution environment.
   iree_hal_executable_environment_v0_t environment;
 } iree_hal_local_executable_t;
@@ -64,6 +83,13 @@ void iree_hal_local_executable_initialize(
 void iree_hal_local_executable_deinitialize(
     iree_hal_local_executable_t* base_executable);
 
+// Assigns |dispatch_counters| that all subsequent workgroup calls of
+// |executable| are measured into. Only valid before the executable is used and
+// a no-op if the executable has no export names.
+iree_status_t iree_hal_local_executable_set_dispatch_counters(
+    iree_hal_local_executable_t* executable,
+    iree_hal_local_dispatch_counters_t* dispatch_counters);
+
 iree_hal_local_executable_t* iree_hal_local_executable_cast(
     iree_hal_executable_t* base_value);
 
@@ -9,11 +9,16 @@
 #include <stdbool.h>
 #include <stddef.h>
 
+#include "iree/hal/local/local_executable.h"
+
 typedef struct iree_hal_local_executable_cache_t {
   iree_hal_resource_t resource;
   iree_allocator_t host_allocator;
   iree_string_view_t identifier;
   iree_host_size_t worker_capacity;
+  iree_loop_t loop;
+  iree_hal_local_dispatch_profile_t* dispatch_profile;
+  iree_hal_local_dispatch_counters_t* dispatch_counters;
   iree_host_size_t loader_count;
   iree_hal_executable_loader_t* loaders[];
 } iree_hal_local_executable_cache_t;
@@ -30,6 +35,8 @@ static iree_hal_local_executable_cache_t* iree_hal_local_executable_cache_cast(
 iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_t identifier, iree_host_size_t worker_capacity,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_hal_local_dispatch_profile_t* dispatch_profile,
+    iree_hal_local_dispatch_counters_t* dispatch_counters, iree_loop_t loop,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache) {
   IREE_ASSERT_ARGUMENT(!loader_count || loaders);
@@ -52,6 +59,11 @@ iree_status_t iree_hal_local_executable_cache_create(
         identifier, &executable_cache->identifier,
         (char*)executable_cache + total_size - identifier.size);
     executable_cache->worker_capacity = worker_capacity;
+    executable_cache->loop = loop;
+    executable_cache->dispatch_profile = dispatch_profile;
+    iree_hal_local_dispatch_profile_retain(dispatch_profile);
+    executable_cache->dispatch_counters = dispatch_counters;
+    iree_hal_local_dispatch_counters_retain(dispatch_counters);
 
     executable_cache->loader_count = loader_count;
     for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
@@ -76,6 +88,8 @@ static void iree_hal_local_executable_cache_destroy(
   for (iree_host_size_t i = 0; i < executable_cache->loader_count; ++i) {
     iree_hal_executable_loader_release(executable_cache->loaders[i]);
   }
+  iree_hal_local_dispatch_profile_release(executable_cache->dispatch_profile);
+  iree_hal_local_dispatch_counters_release(executable_cache->dispatch_counters);
   iree_allocator_free(host_allocator, executable_cache);
 
   IREE_TRACE_ZONE_END(z0);
@@ -117,6 +131,18 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
         executable_cache->worker_capacity, out_executable);
     if (iree_status_is_ok(status)) {
       // Executable was successfully loaded.
+      iree_hal_local_dispatch_profile_t* dispatch_profile =
+          executable_cache->dispatch_profile;
+      iree_hal_local_dispatch_profile_retain(dispatch_profile);
+      iree_hal_local_executable_t* executable =
+          iree_hal_local_executable_cast(*out_executable);
+      executable->dispatch_profile = dispatch_profile;
+      status = iree_hal_local_executable_set_dispatch_counters(
+          executable, executable_cache->dispatch_counters);
+      if (!iree_status_is_ok(status)) {
+        iree_hal_executable_release(*out_executable);
+        *out_executable = NULL;
+      }
       return status;
     } else if (!iree_status_is_cancelled(status)) {
       // Error beyond just the try failing due to unsupported formats.
@@ -131,6 +157,75 @@ static iree_status_t iree_hal_local_executable_cache_prepare_executable(
       executable_params->executable_format.data);
 }
 
+typedef struct iree_hal_local_executable_cache_batch_t {
+  iree_hal_executable_cache_t* executable_cache;
+  const iree_hal_executable_params_t* executable_params;
+  iree_hal_executable_t** out_executables;
+  // Set by the completion callback once all workgroups have finished.
+  bool completed;
+  iree_status_t status;
+} iree_hal_local_executable_cache_batch_t;
+
+static iree_status_t iree_hal_local_executable_cache_batch_workgroup(
+    void* user_data, iree_loop_t loop, uint32_t workgroup_x,
+    uint32_t workgroup_y, uint32_t workgroup_z) {
+  iree_hal_local_executable_cache_batch_t* batch =
+      (iree_hal_local_executable_cache_batch_t*)user_data;
+  return iree_hal_local_executable_cache_prepare_executable(
+      batch->executable_cache, &batch->executable_params[workgroup_x],
+      &batch->out_executables[workgroup_x]);
+}
+
+static iree_status_t iree_hal_local_executable_cache_batch_complete(
+    void* user_data, iree_loop_t loop, iree_status_t status) {
+  iree_hal_local_executable_cache_batch_t* batch =
+      (iree_hal_local_executable_cache_batch_t*)user_data;
+  batch->status = status;
+  batch->completed = true;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_local_executable_cache_prepare_executables(
+    iree_hal_executable_cache_t* base_executable_cache,
+    iree_host_size_t executable_count,
+    const iree_hal_executable_params_t* executable_params,
+    iree_hal_executable_t** out_executables) {
+  iree_hal_local_executable_cache_t* executable_cache =
+      iree_hal_local_executable_cache_cast(base_executable_cache);
+  if (executable_count == 0) return iree_ok_status();
+  if (executable_count > UINT32_MAX) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "too many executables in batch (%" PRIhsz ")",
+                            executable_count);
+  }
+
+  // Each executable is loaded by its own workgroup. Loaders are thread-safe and
+  // each workgroup writes only its own output slot.
+  iree_hal_local_executable_cache_batch_t batch = {
+      .executable_cache = base_executable_cache,
+      .executable_params = executable_params,
+      .out_executables = out_executables,
+      .completed = false,
+      .status = iree_ok_status(),
+  };
+  const uint32_t workgroup_count[3] = {(uint32_t)executable_count, 1, 1};
+  IREE_RETURN_IF_ERROR(iree_loop_dispatch(
+      executable_cache->loop, workgroup_count,
+      iree_hal_local_executable_cache_batch_workgroup,
+      iree_hal_local_executable_cache_batch_complete, &batch));
+
+  // Loops may defer the dispatch; run them until our completion is issued.
+  if (!batch.completed) {
+    IREE_RETURN_IF_ERROR(
+        iree_loop_drain(executable_cache->loop, iree_infinite_timeout()));
+  }
+  if (!batch.completed) {
+    return iree_make_status(IREE_STATUS_INTERNAL,
+                            "loop drained without completing the batch");
+  }
+  return batch.status;
+}
+
 static const iree_hal_executable_cache_vtable_t
     iree_hal_local_executable_cache_vtable = {
         .destroy = iree_hal_local_executable_cache_destroy,
@@ -138,4 +233,6 @@ static const iree_hal_executable_cache_vtable_t
             iree_hal_local_executable_cache_can_prepare_format,
         .prepare_executable =
             iree_hal_local_executable_cache_prepare_executable,
+        .prepare_executables =
+            iree_hal_local_executable_cache_prepare_executables,
 };
@@ -9,6 +9,8 @@
 
 #include "iree/base/api.h"
 #include "iree/hal/api.h"
+#include "iree/hal/local/dispatch_counters.h"
+#include "iree/hal/local/dispatch_profile.h"
 #include "iree/hal/local/executable_loader.h"
 
 #ifdef __cplusplus
@@ -23,9 +25,21 @@ extern "C" {
 // one device is the same JIT'ed executable in another, and in multi-tenant
 // situations we're likely to want that isolation _and_ sharing.
 
+// Creates an executable cache that loads executables with |loaders|.
+// Batches of executables prepared with
+// iree_hal_executable_cache_prepare_executables are loaded concurrently by
+// dispatching across |loop|. The loop must remain valid for the lifetime of
+// the executable cache.
+//
+// If provided, |dispatch_profile| is retained by each executable prepared so
+// that their dispatches are recorded while it is capturing. Similarly if
+// |dispatch_counters| is provided every workgroup call of the executables is
+// measured into it.
 iree_status_t iree_hal_local_executable_cache_create(
     iree_string_view_t identifier, iree_host_size_t worker_capacity,
     iree_host_size_t loader_count, iree_hal_executable_loader_t** loaders,
+    iree_hal_local_dispatch_profile_t* dispatch_profile,
+    iree_hal_local_dispatch_counters_t* dispatch_counters, iree_loop_t loop,
     iree_allocator_t host_allocator,
     iree_hal_executable_cache_t** out_executable_cache);
 
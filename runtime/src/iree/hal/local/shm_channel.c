@@ -0,0 +1,1060 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/shm_channel.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/math.h"
+#include "iree/base/internal/threading.h"
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_MACOS)
+#define IREE_HAL_SHM_CHANNEL_HAVE_POSIX_SHM 1
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_MACOS
+
+// Size in bytes of each rank's data slot in the shared segment. Operations
+// larger than what fits in the slots are processed in multiple chunks. Must be
+// the same in all participating processes.
+#if !defined(IREE_HAL_SHM_CHANNEL_SLOT_SIZE)
+#define IREE_HAL_SHM_CHANNEL_SLOT_SIZE (4 * 1024 * 1024)
+#endif  // !IREE_HAL_SHM_CHANNEL_SLOT_SIZE
+
+// Maximum time in milliseconds to wait for all participants to attach to a
+// segment. Processes launched together may start with some skew.
+#if !defined(IREE_HAL_SHM_CHANNEL_ATTACH_TIMEOUT_MS)
+#define IREE_HAL_SHM_CHANNEL_ATTACH_TIMEOUT_MS (60 * 1000)
+#endif  // !IREE_HAL_SHM_CHANNEL_ATTACH_TIMEOUT_MS
+
+// Number of times a barrier polls peers before yielding the thread.
+#define IREE_HAL_SHM_CHANNEL_SPIN_COUNT 1024
+
+//===----------------------------------------------------------------------===//
+// Shared segment layout
+//===----------------------------------------------------------------------===//
+// The segment starts with a header followed by one cache line per rank holding
+// its barrier epoch and then one data slot per rank:
+//   [header][rank 0 epoch]...[rank N-1 epoch][slot 0]...[slot N-1]
+// Each rank only writes its own epoch and (outside of reductions) its own slot.
+
+#define IREE_HAL_SHM_SEGMENT_MAGIC 0x4D485349u  // 'ISHM'
+
+enum iree_hal_shm_segment_state_e {
+  // Segment is being initialized by rank 0.
+  IREE_HAL_SHM_SEGMENT_STATE_CREATING = 0,
+  // Segment is initialized and ranks may attach.
+  IREE_HAL_SHM_SEGMENT_STATE_READY = 1,
+  // All ranks have attached and the segment name has been unlinked. Segments
+  // observed in this state when attaching are stale.
+  IREE_HAL_SHM_SEGMENT_STATE_SEALED = 2,
+};
+
+typedef struct iree_hal_shm_segment_header_t {
+  uint32_t magic;
+  int32_t count;
+  uint64_t slot_size;
+  iree_atomic_int32_t state;
+  iree_atomic_int32_t attached;
+} iree_hal_shm_segment_header_t;
+static_assert(sizeof(iree_hal_shm_segment_header_t) <=
+                  iree_hardware_destructive_interference_size,
+              "header must fit in a cache line");
+
+static iree_host_size_t iree_hal_shm_segment_slots_offset(int32_t count) {
+  return iree_host_align(
+      (1 + (iree_host_size_t)count) * iree_hardware_destructive_interference_size,
+      4096);
+}
+
+static iree_host_size_t iree_hal_shm_segment_size(int32_t count,
+                                                  iree_host_size_t slot_size) {
+  return iree_hal_shm_segment_slots_offset(count) +
+         (iree_host_size_t)count * slot_size;
+}
+
+// Returns a segment name derived from |key| in |buffer|.
+static void iree_hal_shm_segment_name(uint64_t key, char buffer[32]) {
+  snprintf(buffer, 32, "/iree-shm-%016" PRIx64, key);
+}
+
+#if defined(IREE_HAL_SHM_CHANNEL_HAVE_POSIX_SHM)
+
+// Sleeps the calling thread briefly while polling for other processes.
+static void iree_hal_shm_segment_poll_sleep(void) {
+  iree_wait_until(iree_time_now() + 1000000ll);
+}
+
+// Waits until |value| reaches |expected| or |deadline_ns| elapses.
+static bool iree_hal_shm_segment_await(iree_atomic_int32_t* value,
+                                       int32_t expected,
+                                       iree_time_t deadline_ns) {
+  while (iree_atomic_load_int32(value, iree_memory_order_acquire) != expected) {
+    if (iree_time_now() >= deadline_ns) return false;
+    iree_hal_shm_segment_poll_sleep();
+  }
+  return true;
+}
+
+// Creates the segment named by |key| as rank 0 and waits for all other ranks
+// to attach before unlinking its name.
+static iree_status_t iree_hal_shm_segment_create(uint64_t key, int32_t count,
+                                                 iree_host_size_t slot_size,
+                                                 iree_time_t deadline_ns,
+                                                 uint8_t** out_mapping) {
+  char name[32];
+  iree_hal_shm_segment_name(key, name);
+  const iree_host_size_t size = iree_hal_shm_segment_size(count, slot_size);
+
+  // Remove any segment left behind by a process that crashed while attaching.
+  shm_unlink(name);
+  int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to create shared memory segment %s", name);
+  }
+  if (ftruncate(fd, (off_t)size) != 0) {
+    int error_number = errno;
+    close(fd);
+    shm_unlink(name);
+    return iree_make_status(iree_status_code_from_errno(error_number),
+                            "failed to size shared memory segment %s to %" PRIhsz
+                            " bytes",
+                            name, size);
+  }
+  void* mapping =
+      mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, /*offset=*/0);
+  int error_number = errno;
+  close(fd);
+  if (mapping == MAP_FAILED) {
+    shm_unlink(name);
+    return iree_make_status(iree_status_code_from_errno(error_number),
+                            "failed to map shared memory segment %s", name);
+  }
+
+  iree_hal_shm_segment_header_t* header =
+      (iree_hal_shm_segment_header_t*)mapping;
+  header->magic = IREE_HAL_SHM_SEGMENT_MAGIC;
+  header->count = count;
+  header->slot_size = slot_size;
+  iree_atomic_store_int32(&header->state, IREE_HAL_SHM_SEGMENT_STATE_READY,
+                          iree_memory_order_release);
+
+  // Once everyone has the segment mapped the name is no longer needed and
+  // unlinking it ensures the memory is released when the last rank exits even
+  // if it crashes.
+  bool all_attached =
+      iree_hal_shm_segment_await(&header->attached, count - 1, deadline_ns);
+  shm_unlink(name);
+  iree_atomic_store_int32(&header->state, IREE_HAL_SHM_SEGMENT_STATE_SEALED,
+                          iree_memory_order_release);
+  if (!all_attached) {
+    int32_t attached =
+        iree_atomic_load_int32(&header->attached, iree_memory_order_acquire);
+    munmap(mapping, size);
+    return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                            "timed out waiting for collective participants to "
+                            "attach to %s; %d of %d attached",
+                            name, attached + 1, count);
+  }
+
+  *out_mapping = (uint8_t*)mapping;
+  return iree_ok_status();
+}
+
+// Attaches to the segment named by |key| created by rank 0.
+static iree_status_t iree_hal_shm_segment_open(uint64_t key, int32_t count,
+                                               iree_host_size_t slot_size,
+                                               iree_time_t deadline_ns,
+                                               uint8_t** out_mapping) {
+  char name[32];
+  iree_hal_shm_segment_name(key, name);
+  const iree_host_size_t size = iree_hal_shm_segment_size(count, slot_size);
+
+  for (;;) {
+    if (iree_time_now() >= deadline_ns) {
+      return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                              "timed out waiting for collective rank 0 to "
+                              "create shared memory segment %s",
+                              name);
+    }
+
+    // Rank 0 may not have created or sized the segment yet.
+    int fd = shm_open(name, O_RDWR, 0);
+    if (fd < 0) {
+      if (errno != ENOENT) {
+        return iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to open shared memory segment %s",
+                                name);
+      }
+      iree_hal_shm_segment_poll_sleep();
+      continue;
+    }
+    struct stat fd_stat;
+    if (fstat(fd, &fd_stat) != 0 || (uint64_t)fd_stat.st_size < size) {
+      close(fd);
+      iree_hal_shm_segment_poll_sleep();
+      continue;
+    }
+    void* mapping =
+        mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, /*offset=*/0);
+    int error_number = errno;
+    close(fd);
+    if (mapping == MAP_FAILED) {
+      return iree_make_status(iree_status_code_from_errno(error_number),
+                              "failed to map shared memory segment %s", name);
+    }
+
+    // Segments that are sealed or already have all ranks attached belong to a
+    // previous channel with the same name that has not yet been unlinked.
+    iree_hal_shm_segment_header_t* header =
+        (iree_hal_shm_segment_header_t*)mapping;
+    int32_t state =
+        iree_atomic_load_int32(&header->state, iree_memory_order_acquire);
+    if (state != IREE_HAL_SHM_SEGMENT_STATE_READY ||
+        header->magic != IREE_HAL_SHM_SEGMENT_MAGIC ||
+        header->count != count || header->slot_size != slot_size) {
+      munmap(mapping, size);
+      iree_hal_shm_segment_poll_sleep();
+      continue;
+    }
+    int32_t attached = iree_atomic_fetch_add_int32(&header->attached, 1,
+                                                   iree_memory_order_acq_rel);
+    if (attached >= count - 1) {
+      munmap(mapping, size);
+      iree_hal_shm_segment_poll_sleep();
+      continue;
+    }
+
+    // Wait for rank 0 to unlink the name so that a subsequent channel created
+    // with the same name cannot observe this segment.
+    if (!iree_hal_shm_segment_await(&header->state,
+                                    IREE_HAL_SHM_SEGMENT_STATE_SEALED,
+                                    deadline_ns)) {
+      munmap(mapping, size);
+      return iree_make_status(IREE_STATUS_DEADLINE_EXCEEDED,
+                              "timed out waiting for collective participants "
+                              "to attach to %s",
+                              name);
+    }
+
+    *out_mapping = (uint8_t*)mapping;
+    return iree_ok_status();
+  }
+}
+
+static iree_status_t iree_hal_shm_segment_attach(uint64_t key, int32_t rank,
+                                                 int32_t count,
+                                                 iree_host_size_t slot_size,
+                                                 uint8_t** out_mapping) {
+  iree_time_t deadline_ns =
+      iree_time_now() + IREE_HAL_SHM_CHANNEL_ATTACH_TIMEOUT_MS * 1000000ll;
+  if (rank == 0) {
+    return iree_hal_shm_segment_create(key, count, slot_size, deadline_ns,
+                                       out_mapping);
+  } else {
+    return iree_hal_shm_segment_open(key, count, slot_size, deadline_ns,
+                                     out_mapping);
+  }
+}
+
+static void iree_hal_shm_segment_detach(uint8_t* mapping,
+                                        iree_host_size_t size) {
+  munmap(mapping, size);
+}
+
+static uint64_t iree_hal_shm_process_id(void) { return (uint64_t)getpid(); }
+
+#else
+
+static iree_status_t iree_hal_shm_segment_attach(uint64_t key, int32_t rank,
+                                                 int32_t count,
+                                                 iree_host_size_t slot_size,
+                                                 uint8_t** out_mapping) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "shared memory collective channels are not "
+                          "supported on this platform");
+}
+
+static void iree_hal_shm_segment_detach(uint8_t* mapping,
+                                        iree_host_size_t size) {}
+
+static uint64_t iree_hal_shm_process_id(void) { return 0; }
+
+#endif  // IREE_HAL_SHM_CHANNEL_HAVE_POSIX_SHM
+
+IREE_API_EXPORT bool iree_hal_shm_channel_is_supported(void) {
+#if defined(IREE_HAL_SHM_CHANNEL_HAVE_POSIX_SHM)
+  return true;
+#else
+  return false;
+#endif  // IREE_HAL_SHM_CHANNEL_HAVE_POSIX_SHM
+}
+
+//===----------------------------------------------------------------------===//
+// Reductions
+//===----------------------------------------------------------------------===//
+// Reductions combine one rank's contribution into an accumulator in place.
+// The loops are written such that the compiler vectorizes them for the target
+// ISA; half-precision types are widened to f32 for the arithmetic.
+
+typedef void (*iree_hal_shm_reduce_fn_t)(void* IREE_RESTRICT target,
+                                         const void* IREE_RESTRICT source,
+                                         iree_host_size_t count);
+typedef void (*iree_hal_shm_scale_fn_t)(void* target, iree_host_size_t count,
+                                        int32_t divisor);
+
+#define IREE_HAL_SHM_DEFINE_REDUCE_FN(name, T, expr)                   \
+  static void name(void* IREE_RESTRICT target_ptr,                     \
+                   const void* IREE_RESTRICT source_ptr,               \
+                   iree_host_size_t count) {                           \
+    T* IREE_RESTRICT target = (T*)target_ptr;                          \
+    const T* IREE_RESTRICT source = (const T*)source_ptr;              \
+    for (iree_host_size_t i = 0; i < count; ++i) {                     \
+      const T a = target[i];                                           \
+      const T b = source[i];                                           \
+      target[i] = (T)(expr);                                           \
+    }                                                                  \
+  }
+
+// Sums and products use the unsigned type for integers so that overflow wraps
+// identically for signed and unsigned elements.
+#define IREE_HAL_SHM_DEFINE_REDUCE_FNS(type_name, T, arithmetic_T)            \
+  IREE_HAL_SHM_DEFINE_REDUCE_FN(iree_hal_shm_reduce_sum_##type_name,         \
+                                arithmetic_T, a + b)                         \
+  IREE_HAL_SHM_DEFINE_REDUCE_FN(iree_hal_shm_reduce_product_##type_name,     \
+                                arithmetic_T, a * b)                         \
+  IREE_HAL_SHM_DEFINE_REDUCE_FN(iree_hal_shm_reduce_min_##type_name, T,      \
+                                b < a ? b : a)                               \
+  IREE_HAL_SHM_DEFINE_REDUCE_FN(iree_hal_shm_reduce_max_##type_name, T,      \
+                                b > a ? b : a)                               \
+  static void iree_hal_shm_scale_##type_name(                                 \
+      void* target_ptr, iree_host_size_t count, int32_t divisor) {           \
+    T* target = (T*)target_ptr;                                              \
+    for (iree_host_size_t i = 0; i < count; ++i) {                           \
+      target[i] = (T)(target[i] / divisor);                                  \
+    }                                                                        \
+  }
+
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(i8, int8_t, uint8_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(u8, uint8_t, uint8_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(i16, int16_t, uint16_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(u16, uint16_t, uint16_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(i32, int32_t, uint32_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(u32, uint32_t, uint32_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(i64, int64_t, uint64_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(u64, uint64_t, uint64_t)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(f32, float, float)
+IREE_HAL_SHM_DEFINE_REDUCE_FNS(f64, double, double)
+
+#define IREE_HAL_SHM_DEFINE_HALF_REDUCE_FN(name, type_name, expr)         \
+  static void name(void* IREE_RESTRICT target_ptr,                        \
+                   const void* IREE_RESTRICT source_ptr,                  \
+                   iree_host_size_t count) {                              \
+    uint16_t* IREE_RESTRICT target = (uint16_t*)target_ptr;               \
+    const uint16_t* IREE_RESTRICT source = (const uint16_t*)source_ptr;   \
+    for (iree_host_size_t i = 0; i < count; ++i) {                        \
+      const float a = iree_math_##type_name##_to_f32(target[i]);          \
+      const float b = iree_math_##type_name##_to_f32(source[i]);          \
+      target[i] = iree_math_f32_to_##type_name(expr);                     \
+    }                                                                     \
+  }
+
+#define IREE_HAL_SHM_DEFINE_HALF_REDUCE_FNS(type_name)                         \
+  IREE_HAL_SHM_DEFINE_HALF_REDUCE_FN(iree_hal_shm_reduce_sum_##type_name,     \
+                                     type_name, a + b)                        \
+  IREE_HAL_SHM_DEFINE_HALF_REDUCE_FN(iree_hal_shm_reduce_product_##type_name, \
+                                     type_name, a * b)                        \
+  IREE_HAL_SHM_DEFINE_HALF_REDUCE_FN(iree_hal_shm_reduce_min_##type_name,     \
+                                     type_name, b < a ? b : a)                \
+  IREE_HAL_SHM_DEFINE_HALF_REDUCE_FN(iree_hal_shm_reduce_max_##type_name,     \
+                                     type_name, b > a ? b : a)                \
+  static void iree_hal_shm_scale_##type_name(                                  \
+      void* target_ptr, iree_host_size_t count, int32_t divisor) {            \
+    uint16_t* target = (uint16_t*)target_ptr;                                 \
+    for (iree_host_size_t i = 0; i < count; ++i) {                            \
+      target[i] = iree_math_f32_to_##type_name(                               \
+          iree_math_##type_name##_to_f32(target[i]) / (float)divisor);        \
+    }                                                                         \
+  }
+
+IREE_HAL_SHM_DEFINE_HALF_REDUCE_FNS(f16)
+IREE_HAL_SHM_DEFINE_HALF_REDUCE_FNS(bf16)
+
+typedef struct iree_hal_shm_element_fns_t {
+  // Indexed by iree_hal_collective_reduction_t - 1 for SUM through MAXIMUM.
+  iree_hal_shm_reduce_fn_t reduce[4];
+  // Divides accumulated sums by the participant count for AVERAGE.
+  iree_hal_shm_scale_fn_t scale;
+} iree_hal_shm_element_fns_t;
+
+#define IREE_HAL_SHM_ELEMENT_FNS(type_name)                                 \
+  {                                                                         \
+    .reduce =                                                               \
+        {                                                                   \
+            iree_hal_shm_reduce_sum_##type_name,                            \
+            iree_hal_shm_reduce_product_##type_name,                        \
+            iree_hal_shm_reduce_min_##type_name,                            \
+            iree_hal_shm_reduce_max_##type_name,                            \
+        },                                                                  \
+    .scale = iree_hal_shm_scale_##type_name,                                \
+  }
+
+// Indexed by iree_hal_collective_element_type_t.
+static const iree_hal_shm_element_fns_t iree_hal_shm_element_fns[] = {
+    IREE_HAL_SHM_ELEMENT_FNS(i8),  IREE_HAL_SHM_ELEMENT_FNS(u8),
+    IREE_HAL_SHM_ELEMENT_FNS(i16), IREE_HAL_SHM_ELEMENT_FNS(u16),
+    IREE_HAL_SHM_ELEMENT_FNS(i32), IREE_HAL_SHM_ELEMENT_FNS(u32),
+    IREE_HAL_SHM_ELEMENT_FNS(i64), IREE_HAL_SHM_ELEMENT_FNS(u64),
+    IREE_HAL_SHM_ELEMENT_FNS(f16), IREE_HAL_SHM_ELEMENT_FNS(f32),
+    IREE_HAL_SHM_ELEMENT_FNS(f64), IREE_HAL_SHM_ELEMENT_FNS(bf16),
+};
+static_assert(IREE_ARRAYSIZE(iree_hal_shm_element_fns) ==
+                  IREE_HAL_COLLECTIVE_ELEMENT_TYPE_MAX_VALUE + 1,
+              "element type table must cover all element types");
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shm_channel_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_shm_channel_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+
+  // This participant's rank in the group.
+  int32_t rank;
+  // Total number of participants in the group.
+  int32_t count;
+
+  // Hash of the channel ID and group naming the shared segment. Channels split
+  // from this one derive their keys from it.
+  uint64_t key;
+  // Number of splits performed on this channel. Splits are collective and
+  // ordered identically on all ranks and the ordinal disambiguates segments
+  // of successive splits with the same color.
+  uint32_t split_count;
+
+  // Last barrier epoch this rank published.
+  int64_t epoch;
+
+  // Size of each rank's slot in bytes.
+  iree_host_size_t slot_size;
+  // Shared segment mapping of iree_hal_shm_segment_size bytes.
+  uint8_t* mapping;
+} iree_hal_shm_channel_t;
+
+static const iree_hal_channel_vtable_t iree_hal_shm_channel_vtable;
+
+static iree_hal_shm_channel_t* iree_hal_shm_channel_cast(
+    iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_shm_channel_vtable);
+  return (iree_hal_shm_channel_t*)base_value;
+}
+
+static const iree_hal_shm_channel_t* iree_hal_shm_channel_const_cast(
+    const iree_hal_channel_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_shm_channel_vtable);
+  return (const iree_hal_shm_channel_t*)base_value;
+}
+
+// Mixes |data| into |hash| with FNV-1a.
+static uint64_t iree_hal_shm_channel_hash(uint64_t hash, const void* data,
+                                          iree_host_size_t data_length) {
+  const uint8_t* bytes = (const uint8_t*)data;
+  for (iree_host_size_t i = 0; i < data_length; ++i) {
+    hash ^= bytes[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+static iree_atomic_int64_t* iree_hal_shm_channel_epoch(
+    iree_hal_shm_channel_t* channel, int32_t rank) {
+  return (iree_atomic_int64_t*)(channel->mapping +
+                                (1 + (iree_host_size_t)rank) *
+                                    iree_hardware_destructive_interference_size);
+}
+
+static uint8_t* iree_hal_shm_channel_slot(iree_hal_shm_channel_t* channel,
+                                          int32_t rank) {
+  return channel->mapping + iree_hal_shm_segment_slots_offset(channel->count) +
+         (iree_host_size_t)rank * channel->slot_size;
+}
+
+// Blocks until all ranks have reached the barrier. Writes made to the segment
+// by any rank before the barrier are visible to all ranks after it.
+static void iree_hal_shm_channel_barrier(iree_hal_shm_channel_t* channel) {
+  const int64_t epoch = ++channel->epoch;
+  iree_atomic_store_int64(iree_hal_shm_channel_epoch(channel, channel->rank),
+                          epoch, iree_memory_order_release);
+  for (int32_t r = 0; r < channel->count; ++r) {
+    iree_atomic_int64_t* peer_epoch = iree_hal_shm_channel_epoch(channel, r);
+    uint32_t spin_count = 0;
+    while (iree_atomic_load_int64(peer_epoch, iree_memory_order_acquire) <
+           epoch) {
+      if (++spin_count > IREE_HAL_SHM_CHANNEL_SPIN_COUNT) iree_thread_yield();
+    }
+  }
+}
+
+static iree_status_t iree_hal_shm_channel_create_with_key(
+    uint64_t key, int32_t rank, int32_t count, iree_allocator_t host_allocator,
+    iree_hal_channel_t** out_channel) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, key);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, rank);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+
+  iree_hal_shm_channel_t* channel = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*channel),
+                                (void**)&channel));
+  iree_hal_resource_initialize(&iree_hal_shm_channel_vtable,
+                               &channel->resource);
+  channel->host_allocator = host_allocator;
+  channel->rank = rank;
+  channel->count = count;
+  channel->key = key;
+  channel->split_count = 0;
+  channel->epoch = 0;
+  channel->slot_size = IREE_HAL_SHM_CHANNEL_SLOT_SIZE;
+  channel->mapping = NULL;
+
+  iree_status_t status = iree_hal_shm_segment_attach(
+      key, rank, count, channel->slot_size, &channel->mapping);
+
+  if (iree_status_is_ok(status)) {
+    *out_channel = (iree_hal_channel_t*)channel;
+  } else {
+    iree_hal_channel_release((iree_hal_channel_t*)channel);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Populates |id| with a value unique to the calling process for use by the
+// root participant when exchanging the default ID.
+static void iree_hal_shm_channel_generate_id(iree_byte_span_t id) {
+  snprintf((char*)id.data, id.data_length, "%" PRIu64 "-%" PRId64,
+           iree_hal_shm_process_id(), (int64_t)iree_time_now());
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_create(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_channel_params_t params,
+    iree_allocator_t host_allocator, iree_hal_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+  if (!iree_hal_shm_channel_is_supported()) {
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "shared memory collective channels are not "
+                            "supported on this platform");
+  }
+
+  // Today we only allow a single logical device per channel.
+  int requested_count = iree_math_count_ones_u64(queue_affinity);
+  if (requested_count != 64 && requested_count != 1) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "exactly one participant is allowed in a "
+                            "channel but %d were specified",
+                            requested_count);
+  }
+
+  // Ask the channel provider (if configured) for the default rank and count
+  // if the user did not set them.
+  if (channel_provider && (params.rank == IREE_HAL_CHANNEL_RANK_DEFAULT ||
+                           params.count == IREE_HAL_CHANNEL_COUNT_DEFAULT)) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_channel_provider_query_default_rank_and_count(
+            channel_provider, &params.rank, &params.count),
+        "querying default collective group rank and count");
+  }
+  if (params.count <= 0 || params.rank < 0 || params.rank >= params.count) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collective rank and count must be provided by "
+                            "the channel parameters or a channel provider; "
+                            "rank=%d count=%d",
+                            params.rank, params.count);
+  }
+
+  // The ID names the segment shared by all participants. If not provided the
+  // root generates one and it is exchanged with the others by the provider.
+  uint8_t default_id[IREE_HAL_SHM_CHANNEL_ID_LENGTH];
+  iree_const_byte_span_t id = params.id;
+  if (iree_const_byte_span_is_empty(id)) {
+    if (!channel_provider) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "default collective channel ID requested but no channel provider has "
+          "been set on the device to provide it");
+    }
+    memset(default_id, 0, sizeof(default_id));
+    if (params.rank == 0) {
+      iree_hal_shm_channel_generate_id(
+          iree_make_byte_span(default_id, sizeof(default_id)));
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_channel_provider_exchange_default_id(
+                             channel_provider,
+                             iree_make_byte_span(default_id, sizeof(default_id))),
+                         "exchanging channel ID with other participants");
+    id = iree_make_const_byte_span(default_id, sizeof(default_id));
+  }
+
+  // FNV-1a basis.
+  uint64_t key = 0xCBF29CE484222325ull;
+  key = iree_hal_shm_channel_hash(key, id.data, id.data_length);
+  key = iree_hal_shm_channel_hash(key, &params.count, sizeof(params.count));
+  key = iree_hal_shm_channel_hash(key, params.group.data, params.group.size);
+
+  return iree_hal_shm_channel_create_with_key(key, params.rank, params.count,
+                                              host_allocator, out_channel);
+}
+
+IREE_API_EXPORT bool iree_hal_shm_channel_isa(iree_hal_channel_t* channel) {
+  return iree_hal_resource_is(channel, &iree_hal_shm_channel_vtable);
+}
+
+static void iree_hal_shm_channel_destroy(iree_hal_channel_t* base_channel) {
+  iree_hal_shm_channel_t* channel = iree_hal_shm_channel_cast(base_channel);
+  iree_allocator_t host_allocator = channel->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (channel->mapping) {
+    iree_hal_shm_segment_detach(
+        channel->mapping,
+        iree_hal_shm_segment_size(channel->count, channel->slot_size));
+  }
+  iree_allocator_free(host_allocator, channel);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_hal_shm_channel_split(
+    iree_hal_channel_t* base_channel, int32_t color, int32_t key,
+    iree_hal_channel_flags_t flags, iree_hal_channel_t** out_split_channel) {
+  iree_hal_shm_channel_t* channel = iree_hal_shm_channel_cast(base_channel);
+
+  // Exchange the color and key of all ranks through their slots. Ranks with
+  // the same color form a group ordered by key and then by parent rank.
+  int32_t* exchange = (int32_t*)iree_hal_shm_channel_slot(channel, channel->rank);
+  exchange[0] = color;
+  exchange[1] = key;
+  iree_hal_shm_channel_barrier(channel);
+  int32_t split_rank = 0;
+  int32_t split_count = 0;
+  for (int32_t r = 0; r < channel->count; ++r) {
+    const int32_t* peer = (const int32_t*)iree_hal_shm_channel_slot(channel, r);
+    if (peer[0] != color) continue;
+    ++split_count;
+    if (peer[1] < key || (peer[1] == key && r < channel->rank)) ++split_rank;
+  }
+  iree_hal_shm_channel_barrier(channel);
+
+  const uint32_t split_ordinal = channel->split_count++;
+  if (color == IREE_HAL_CHANNEL_NO_COLOR) return iree_ok_status();
+
+  uint64_t split_key = channel->key;
+  split_key =
+      iree_hal_shm_channel_hash(split_key, &split_ordinal, sizeof(split_ordinal));
+  split_key = iree_hal_shm_channel_hash(split_key, &color, sizeof(color));
+  return iree_hal_shm_channel_create_with_key(split_key, split_rank,
+                                              split_count,
+                                              channel->host_allocator,
+                                              out_split_channel);
+}
+
+static void iree_hal_shm_channel_query_rank_and_count(
+    const iree_hal_channel_t* base_channel, int32_t* out_rank,
+    int32_t* out_count) {
+  const iree_hal_shm_channel_t* channel =
+      iree_hal_shm_channel_const_cast(base_channel);
+  *out_rank = channel->rank;
+  *out_count = channel->count;
+}
+
+//===----------------------------------------------------------------------===//
+// Collective operations
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_hal_shm_collective_t {
+  iree_hal_shm_channel_t* channel;
+  // Size of a single element in bytes.
+  iree_host_size_t element_size;
+  // Number of elements that fit in a single slot.
+  iree_host_size_t slot_capacity;
+  // Reduction function and optional AVERAGE scaling function.
+  iree_hal_shm_reduce_fn_t reduce_fn;
+  iree_hal_shm_scale_fn_t scale_fn;
+} iree_hal_shm_collective_t;
+
+// Returns the range of elements in a chunk of |count| elements that |rank| is
+// responsible for reducing.
+static void iree_hal_shm_collective_stripe(const iree_hal_shm_collective_t* op,
+                                           iree_host_size_t count, int32_t rank,
+                                           iree_host_size_t* out_begin,
+                                           iree_host_size_t* out_end) {
+  const iree_host_size_t ranks = (iree_host_size_t)op->channel->count;
+  *out_begin = count * (iree_host_size_t)rank / ranks;
+  *out_end = count * (iree_host_size_t)(rank + 1) / ranks;
+}
+
+// Reduces the stripe of this rank across the chunk of |count| elements in the
+// slots of all ranks into this rank's slot.
+static void iree_hal_shm_collective_reduce_stripe(
+    const iree_hal_shm_collective_t* op, iree_host_size_t count) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  iree_host_size_t begin = 0, end = 0;
+  iree_hal_shm_collective_stripe(op, count, channel->rank, &begin, &end);
+  if (begin == end) return;
+  uint8_t* target =
+      iree_hal_shm_channel_slot(channel, channel->rank) + begin * op->element_size;
+  for (int32_t r = 0; r < channel->count; ++r) {
+    if (r == channel->rank) continue;
+    op->reduce_fn(target,
+                  iree_hal_shm_channel_slot(channel, r) + begin * op->element_size,
+                  end - begin);
+  }
+  if (op->scale_fn) op->scale_fn(target, end - begin, channel->count);
+}
+
+// Copies the reduced stripes of all ranks for a chunk of |count| elements into
+// |target|.
+static void iree_hal_shm_collective_gather_stripes(
+    const iree_hal_shm_collective_t* op, iree_host_size_t count,
+    uint8_t* target) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  for (int32_t r = 0; r < channel->count; ++r) {
+    iree_host_size_t begin = 0, end = 0;
+    iree_hal_shm_collective_stripe(op, count, r, &begin, &end);
+    memcpy(target + begin * op->element_size,
+           iree_hal_shm_channel_slot(channel, r) + begin * op->element_size,
+           (end - begin) * op->element_size);
+  }
+}
+
+// Reduces |element_count| elements from all ranks. The reduction of each chunk
+// is striped across ranks and the result gathered by all ranks (or only
+// |root_rank| if not -1).
+static void iree_hal_shm_collective_reduce(const iree_hal_shm_collective_t* op,
+                                           int32_t root_rank,
+                                           const uint8_t* send_data,
+                                           uint8_t* recv_data,
+                                           iree_host_size_t element_count) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  uint8_t* slot = iree_hal_shm_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += op->slot_capacity) {
+    const iree_host_size_t count =
+        iree_min(op->slot_capacity, element_count - base);
+    memcpy(slot, send_data + base * op->element_size,
+           count * op->element_size);
+    iree_hal_shm_channel_barrier(channel);
+    iree_hal_shm_collective_reduce_stripe(op, count);
+    iree_hal_shm_channel_barrier(channel);
+    if (root_rank == -1 || root_rank == channel->rank) {
+      iree_hal_shm_collective_gather_stripes(
+          op, count, recv_data + base * op->element_size);
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Reduces N*|element_count| elements from all ranks and stores block |rank| of
+// the result on each rank.
+static void iree_hal_shm_collective_reduce_scatter(
+    const iree_hal_shm_collective_t* op, const uint8_t* send_data,
+    uint8_t* recv_data, iree_host_size_t element_count) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  const iree_host_size_t element_size = op->element_size;
+  const iree_host_size_t chunk_capacity =
+      op->slot_capacity / (iree_host_size_t)channel->count;
+  uint8_t* slot = iree_hal_shm_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += chunk_capacity) {
+    const iree_host_size_t count =
+        iree_min(chunk_capacity, element_count - base);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(slot + r * count * element_size,
+             send_data + (r * element_count + base) * element_size,
+             count * element_size);
+    }
+    iree_hal_shm_channel_barrier(channel);
+    uint8_t* target = recv_data + base * element_size;
+    const iree_host_size_t block_offset = channel->rank * count * element_size;
+    memcpy(target, iree_hal_shm_channel_slot(channel, 0) + block_offset,
+           count * element_size);
+    for (int32_t r = 1; r < channel->count; ++r) {
+      op->reduce_fn(target, iree_hal_shm_channel_slot(channel, r) + block_offset,
+                    count);
+    }
+    if (op->scale_fn) op->scale_fn(target, count, channel->count);
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Concatenates |element_count| elements from each rank on all ranks.
+static void iree_hal_shm_collective_all_gather(
+    const iree_hal_shm_collective_t* op, const uint8_t* send_data,
+    uint8_t* recv_data, iree_host_size_t element_count) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  const iree_host_size_t element_size = op->element_size;
+  uint8_t* slot = iree_hal_shm_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += op->slot_capacity) {
+    const iree_host_size_t count =
+        iree_min(op->slot_capacity, element_count - base);
+    memcpy(slot, send_data + base * element_size, count * element_size);
+    iree_hal_shm_channel_barrier(channel);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(recv_data + (r * element_count + base) * element_size,
+             iree_hal_shm_channel_slot(channel, r), count * element_size);
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Exchanges part r of |element_count|/N elements from each rank with rank r.
+static void iree_hal_shm_collective_all_to_all(
+    const iree_hal_shm_collective_t* op, const uint8_t* send_data,
+    uint8_t* recv_data, iree_host_size_t element_count) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  const iree_host_size_t element_size = op->element_size;
+  const iree_host_size_t part_count =
+      element_count / (iree_host_size_t)channel->count;
+  const iree_host_size_t chunk_capacity =
+      op->slot_capacity / (iree_host_size_t)channel->count;
+  uint8_t* slot = iree_hal_shm_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < part_count; base += chunk_capacity) {
+    const iree_host_size_t count = iree_min(chunk_capacity, part_count - base);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(slot + r * count * element_size,
+             send_data + (r * part_count + base) * element_size,
+             count * element_size);
+    }
+    iree_hal_shm_channel_barrier(channel);
+    for (int32_t r = 0; r < channel->count; ++r) {
+      memcpy(recv_data + (r * part_count + base) * element_size,
+             iree_hal_shm_channel_slot(channel, r) +
+                 channel->rank * count * element_size,
+             count * element_size);
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+// Copies |element_count| elements from |source_rank| (if not -1) to
+// |recv_data| (if not NULL) on all ranks. Ranks not receiving data from a
+// source zero |recv_data|.
+static void iree_hal_shm_collective_copy(const iree_hal_shm_collective_t* op,
+                                         bool is_source, int32_t source_rank,
+                                         const uint8_t* send_data,
+                                         uint8_t* recv_data,
+                                         iree_host_size_t element_count) {
+  iree_hal_shm_channel_t* channel = op->channel;
+  const iree_host_size_t element_size = op->element_size;
+  uint8_t* slot = iree_hal_shm_channel_slot(channel, channel->rank);
+  for (iree_host_size_t base = 0; base < element_count;
+       base += op->slot_capacity) {
+    const iree_host_size_t count =
+        iree_min(op->slot_capacity, element_count - base);
+    if (is_source) {
+      memcpy(slot, send_data + base * element_size, count * element_size);
+    }
+    iree_hal_shm_channel_barrier(channel);
+    if (recv_data &&
+        !(recv_data == send_data && source_rank == channel->rank)) {
+      if (source_rank >= 0) {
+        memcpy(recv_data + base * element_size,
+               iree_hal_shm_channel_slot(channel, source_rank),
+               count * element_size);
+      } else {
+        memset(recv_data + base * element_size, 0, count * element_size);
+      }
+    }
+    iree_hal_shm_channel_barrier(channel);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_collective(
+    iree_hal_channel_t* base_channel, iree_hal_collective_op_t op,
+    uint32_t param, const void* send_data, void* recv_data,
+    iree_host_size_t element_count) {
+  IREE_ASSERT_ARGUMENT(base_channel);
+  iree_hal_shm_channel_t* channel = iree_hal_shm_channel_cast(base_channel);
+  if (op.element_type > IREE_HAL_COLLECTIVE_ELEMENT_TYPE_MAX_VALUE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unhandled collective element type %u",
+                            op.element_type);
+  }
+
+  iree_hal_shm_collective_t state = {
+      .channel = channel,
+      .element_size =
+          (iree_host_size_t)iree_hal_collective_element_byte_count(
+              op.element_type),
+      .reduce_fn = NULL,
+      .scale_fn = NULL,
+  };
+  state.slot_capacity = channel->slot_size / state.element_size;
+  if (state.slot_capacity < (iree_host_size_t)channel->count) {
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "shared memory slots too small for %d participants",
+                            channel->count);
+  }
+  if (op.kind == IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE ||
+      op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE ||
+      op.kind == IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER) {
+    const iree_hal_shm_element_fns_t* fns =
+        &iree_hal_shm_element_fns[op.element_type];
+    switch (op.reduction) {
+      case IREE_HAL_COLLECTIVE_REDUCTION_SUM:
+      case IREE_HAL_COLLECTIVE_REDUCTION_PRODUCT:
+      case IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM:
+      case IREE_HAL_COLLECTIVE_REDUCTION_MAXIMUM:
+        state.reduce_fn = fns->reduce[op.reduction - 1];
+        break;
+      case IREE_HAL_COLLECTIVE_REDUCTION_AVERAGE:
+        state.reduce_fn = fns->reduce[IREE_HAL_COLLECTIVE_REDUCTION_SUM - 1];
+        state.scale_fn = fns->scale;
+        break;
+      default:
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "unhandled collective reduction %u",
+                                op.reduction);
+    }
+  }
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, op.kind);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, element_count);
+
+  const uint8_t* send_bytes = (const uint8_t*)send_data;
+  uint8_t* recv_bytes = (uint8_t*)recv_data;
+  iree_status_t status = iree_ok_status();
+  switch (op.kind) {
+    case IREE_HAL_COLLECTIVE_KIND_ALL_GATHER:
+      iree_hal_shm_collective_all_gather(&state, send_bytes, recv_bytes,
+                                         element_count);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE:
+      iree_hal_shm_collective_reduce(&state, /*root_rank=*/-1, send_bytes,
+                                     recv_bytes, element_count);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_ALL_TO_ALL:
+      if (element_count % (iree_host_size_t)channel->count != 0) {
+        status = iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "all-to-all element count %" PRIhsz
+            " must be divisible by the participant count %d",
+            element_count, channel->count);
+        break;
+      }
+      iree_hal_shm_collective_all_to_all(&state, send_bytes, recv_bytes,
+                                         element_count);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_BROADCAST:
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE: {
+      if (param >= (uint32_t)channel->count) {
+        status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "root rank %u out of range [0, %d)", param,
+                                  channel->count);
+        break;
+      }
+      if (op.kind == IREE_HAL_COLLECTIVE_KIND_BROADCAST) {
+        iree_hal_shm_collective_copy(
+            &state, /*is_source=*/channel->rank == (int32_t)param,
+            (int32_t)param, send_bytes, recv_bytes, element_count);
+      } else {
+        iree_hal_shm_collective_reduce(&state, (int32_t)param, send_bytes,
+                                       recv_bytes, element_count);
+      }
+      break;
+    }
+    case IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER:
+      iree_hal_shm_collective_reduce_scatter(&state, send_bytes, recv_bytes,
+                                             element_count);
+      break;
+    case IREE_HAL_COLLECTIVE_KIND_SEND_RECV: {
+      const int16_t target_rank = (int16_t)(param & 0xFFFF);
+      const int16_t source_rank = (int16_t)(param >> 16);
+      if (target_rank >= channel->count || source_rank >= channel->count) {
+        status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                  "send/recv ranks %d/%d out of range [0, %d)",
+                                  target_rank, source_rank, channel->count);
+        break;
+      }
+      iree_hal_shm_collective_copy(&state, /*is_source=*/target_rank >= 0,
+                                   source_rank, send_bytes, recv_bytes,
+                                   element_count);
+      break;
+    }
+    default:
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "unsupported collective operation %u on shared "
+                                "memory channels",
+                                op.kind);
+      break;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_collective_bindings(
+    iree_hal_channel_t* channel, iree_hal_collective_op_t op, uint32_t param,
+    iree_hal_buffer_binding_t send_binding,
+    iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count) {
+  IREE_ASSERT_ARGUMENT(channel);
+  if (!iree_hal_shm_channel_isa(channel)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "collectives on host devices require a shared "
+                            "memory channel");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_buffer_mapping_t send_mapping = {{0}};
+  iree_hal_buffer_mapping_t recv_mapping = {{0}};
+  iree_status_t status = iree_ok_status();
+  if (send_binding.buffer) {
+    status = iree_hal_buffer_map_range(
+        send_binding.buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_READ, send_binding.offset, send_binding.length,
+        &send_mapping);
+  }
+  if (iree_status_is_ok(status) && recv_binding.buffer) {
+    status = iree_hal_buffer_map_range(
+        recv_binding.buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_WRITE, recv_binding.offset, recv_binding.length,
+        &recv_mapping);
+  }
+
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_shm_channel_collective(
+        channel, op, param, send_mapping.contents.data,
+        recv_mapping.contents.data, (iree_host_size_t)element_count);
+  }
+
+  if (recv_mapping.buffer) {
+    status = iree_status_join(status, iree_hal_buffer_unmap_range(&recv_mapping));
+  }
+  if (send_mapping.buffer) {
+    status = iree_status_join(status, iree_hal_buffer_unmap_range(&send_mapping));
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_hal_channel_vtable_t iree_hal_shm_channel_vtable = {
+    .destroy = iree_hal_shm_channel_destroy,
+    .split = iree_hal_shm_channel_split,
+    .query_rank_and_count = iree_hal_shm_channel_query_rank_and_count,
+};
@@ -0,0 +1,75 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_LOCAL_SHM_CHANNEL_H_
+#define IREE_HAL_LOCAL_SHM_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_shm_channel_t
+//===----------------------------------------------------------------------===//
+
+// Length in bytes of the default channel ID exchanged with the channel
+// provider when the channel parameters do not specify one.
+#define IREE_HAL_SHM_CHANNEL_ID_LENGTH 64
+
+// Returns true if shared-memory channels are supported on the current platform.
+IREE_API_EXPORT bool iree_hal_shm_channel_is_supported(void);
+
+// Creates a collective channel for host CPU devices whose participants are
+// processes on the same host. All ranks map a common shared memory segment
+// named by hashing the channel ID and group and exchange data through per-rank
+// slots in it: reductions are striped across ranks such that each rank reduces
+// a disjoint portion of every rank's contribution (a reduce-scatter) before all
+// ranks gather the reduced stripes (an all-gather). Large operations are
+// processed in slot-sized chunks.
+//
+// Unset |params| fields are resolved using |channel_provider| (if any) as with
+// other HAL devices: the rank and count are queried from the provider and the
+// root-generated ID is exchanged through it.
+//
+// Creation blocks until all |params|.count participants have attached or a
+// timeout is reached.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_create(
+    iree_hal_channel_provider_t* channel_provider,
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_channel_params_t params,
+    iree_allocator_t host_allocator, iree_hal_channel_t** out_channel);
+
+// Returns true if |channel| is a shared-memory channel.
+IREE_API_EXPORT bool iree_hal_shm_channel_isa(iree_hal_channel_t* channel);
+
+// Performs the collective operation |op| with all other participants of
+// |channel| on host memory. |send_data| and |recv_data| follow the same
+// semantics as the bindings in iree_hal_command_buffer_collective and may be
+// NULL on ranks where they are unused. Blocks until this rank's portion of the
+// operation has completed.
+//
+// Point-to-point IREE_HAL_COLLECTIVE_KIND_SEND and IREE_HAL_COLLECTIVE_KIND_RECV
+// are not supported as they only synchronize a pair of ranks;
+// IREE_HAL_COLLECTIVE_KIND_SEND_RECV issued on all ranks is.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_collective(
+    iree_hal_channel_t* channel, iree_hal_collective_op_t op, uint32_t param,
+    const void* send_data, void* recv_data, iree_host_size_t element_count);
+
+// Performs the collective operation |op| on the contents of |send_binding| and
+// |recv_binding| as with iree_hal_shm_channel_collective. Bindings with a NULL
+// buffer are treated as unused and all others must be host mappable.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_collective_bindings(
+    iree_hal_channel_t* channel, iree_hal_collective_op_t op, uint32_t param,
+    iree_hal_buffer_binding_t send_binding,
+    iree_hal_buffer_binding_t recv_binding, iree_device_size_t element_count);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_LOCAL_SHM_CHANNEL_H_
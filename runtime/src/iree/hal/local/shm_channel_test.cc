@@ -0,0 +1,130 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/local/shm_channel.h"
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+constexpr int32_t kRankCount = 3;
+
+static iree_hal_collective_op_t MakeOp(
+    iree_hal_collective_kind_t kind, iree_hal_collective_reduction_t reduction,
+    iree_hal_collective_element_type_t element_type) {
+  iree_hal_collective_op_t op = {};
+  op.kind = kind;
+  op.reduction = reduction;
+  op.element_type = element_type;
+  return op;
+}
+
+// Runs |fn| on a channel for each rank. Ranks are threads in this process but
+// attach to the shared segment exactly as separate processes would.
+static void RunRanks(const char* id,
+                     std::function<void(int32_t, iree_hal_channel_t*)> fn) {
+  std::string unique_id = std::string(id) + "-" +
+                          std::to_string((int64_t)iree_time_now());
+  std::vector<std::thread> threads;
+  for (int32_t rank = 0; rank < kRankCount; ++rank) {
+    threads.emplace_back([&, rank]() {
+      iree_hal_channel_params_t params = {};
+      params.id = iree_make_const_byte_span(unique_id.data(), unique_id.size());
+      params.rank = rank;
+      params.count = kRankCount;
+      iree_hal_channel_t* channel = NULL;
+      IREE_ASSERT_OK(iree_hal_shm_channel_create(
+          /*channel_provider=*/NULL, IREE_HAL_QUEUE_AFFINITY_ANY, params,
+          iree_allocator_system(), &channel));
+      fn(rank, channel);
+      iree_hal_channel_release(channel);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+}
+
+TEST(ShmChannelTest, AllReduce) {
+  if (!iree_hal_shm_channel_is_supported()) GTEST_SKIP();
+  // Larger than a single slot to exercise chunking.
+  constexpr size_t kCount = 3 * 1024 * 1024;
+  RunRanks("all-reduce", [&](int32_t rank, iree_hal_channel_t* channel) {
+    std::vector<float> send(kCount), recv(kCount);
+    for (size_t i = 0; i < kCount; ++i) send[i] = (float)(rank + 1) * (i % 7);
+    IREE_ASSERT_OK(iree_hal_shm_channel_collective(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+               IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_FLOAT_32),
+        0, send.data(), recv.data(), kCount));
+    for (size_t i = 0; i < kCount; ++i) {
+      ASSERT_EQ(recv[i], 6.0f * (i % 7));
+    }
+  });
+}
+
+TEST(ShmChannelTest, ReduceScatterAllGather) {
+  if (!iree_hal_shm_channel_is_supported()) GTEST_SKIP();
+  constexpr size_t kCount = 1000;
+  RunRanks("scatter-gather", [&](int32_t rank, iree_hal_channel_t* channel) {
+    std::vector<int32_t> send(kRankCount * kCount);
+    for (size_t i = 0; i < send.size(); ++i) send[i] = (int32_t)i - rank;
+    std::vector<int32_t> partial(kCount);
+    IREE_ASSERT_OK(iree_hal_shm_channel_collective(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_REDUCE_SCATTER,
+               IREE_HAL_COLLECTIVE_REDUCTION_MINIMUM,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        0, send.data(), partial.data(), kCount));
+    for (size_t i = 0; i < kCount; ++i) {
+      ASSERT_EQ(partial[i], (int32_t)(rank * kCount + i) - (kRankCount - 1));
+    }
+    std::vector<int32_t> gathered(kRankCount * kCount);
+    IREE_ASSERT_OK(iree_hal_shm_channel_collective(
+        channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_GATHER,
+               IREE_HAL_COLLECTIVE_REDUCTION_NONE,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        0, partial.data(), gathered.data(), kCount));
+    for (size_t i = 0; i < gathered.size(); ++i) {
+      ASSERT_EQ(gathered[i], (int32_t)i - (kRankCount - 1));
+    }
+  });
+}
+
+TEST(ShmChannelTest, Split) {
+  if (!iree_hal_shm_channel_is_supported()) GTEST_SKIP();
+  RunRanks("split", [&](int32_t rank, iree_hal_channel_t* channel) {
+    // Ranks 0 and 2 form a group ordered in reverse and rank 1 is alone.
+    iree_hal_channel_t* split_channel = NULL;
+    IREE_ASSERT_OK(iree_hal_channel_split(channel, rank % 2, -rank,
+                                          IREE_HAL_CHANNEL_FLAG_NONE,
+                                          &split_channel));
+    int32_t split_rank = 0, split_count = 0;
+    iree_hal_channel_query_rank_and_count(split_channel, &split_rank,
+                                          &split_count);
+    EXPECT_EQ(split_count, rank == 1 ? 1 : 2);
+    EXPECT_EQ(split_rank, rank == 0 ? 1 : 0);
+    int32_t value = rank, result = 0;
+    IREE_ASSERT_OK(iree_hal_shm_channel_collective(
+        split_channel,
+        MakeOp(IREE_HAL_COLLECTIVE_KIND_ALL_REDUCE,
+               IREE_HAL_COLLECTIVE_REDUCTION_SUM,
+               IREE_HAL_COLLECTIVE_ELEMENT_TYPE_SINT_32),
+        0, &value, &result, 1));
+    EXPECT_EQ(result, rank == 1 ? 1 : 2);
+    iree_hal_channel_release(split_channel);
+  });
+}
+
+}  // namespace
@@ -10,6 +10,7 @@
 
 #include "iree/hal/detail.h"
 #include "iree/hal/device.h"
+#include "iree/hal/statistics.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_semaphore_t
@@ -73,8 +74,12 @@ IREE_API_EXPORT iree_status_t iree_hal_semaphore_wait(
   IREE_ASSERT_ARGUMENT(semaphore);
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, value);
+  IREE_STATISTICS(const iree_time_t wait_start_ns = iree_time_now());
   iree_status_t status =
       _VTABLE_DISPATCH(semaphore, wait)(semaphore, value, timeout);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_SEMAPHORE_WAIT_COUNT, 1);
+  iree_hal_statistics_record(IREE_HAL_STATISTIC_SEMAPHORE_WAIT_NS,
+                             iree_time_now() - wait_start_ns);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
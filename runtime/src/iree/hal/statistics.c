@@ -0,0 +1,125 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/statistics.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/cpu.h"
+
+#if IREE_STATISTICS_ENABLE
+
+// Number of independently updated copies of the counters. Threads update the
+// stripe of the processor they are running on so that concurrent updates from
+// different cores rarely touch the same cache line.
+#define IREE_HAL_STATISTICS_STRIPE_COUNT 16
+
+typedef struct iree_hal_statistics_stripe_t {
+  iree_alignas(iree_hardware_destructive_interference_size)
+      iree_atomic_int64_t values[IREE_HAL_STATISTIC_COUNT];
+} iree_hal_statistics_stripe_t;
+
+static iree_hal_statistics_stripe_t
+    iree_hal_statistics_stripes[IREE_HAL_STATISTICS_STRIPE_COUNT];
+
+IREE_API_EXPORT void iree_hal_statistics_record(iree_hal_statistic_t statistic,
+                                               uint64_t value) {
+  // The processor may change before the add lands; that only costs some
+  // sharing as any stripe is valid.
+  iree_cpu_processor_id_t processor_id = iree_cpu_query_processor_id();
+  iree_hal_statistics_stripe_t* stripe =
+      &iree_hal_statistics_stripes[processor_id %
+                                   IREE_HAL_STATISTICS_STRIPE_COUNT];
+  iree_atomic_fetch_add_int64(&stripe->values[statistic], (int64_t)value,
+                              iree_memory_order_relaxed);
+}
+
+#endif  // IREE_STATISTICS_ENABLE
+
+IREE_API_EXPORT void iree_hal_statistics_query(
+    iree_hal_statistics_t* out_statistics) {
+  IREE_ASSERT_ARGUMENT(out_statistics);
+  memset(out_statistics, 0, sizeof(*out_statistics));
+#if IREE_STATISTICS_ENABLE
+  uint64_t values[IREE_HAL_STATISTIC_COUNT] = {0};
+  for (iree_host_size_t i = 0; i < IREE_HAL_STATISTICS_STRIPE_COUNT; ++i) {
+    for (iree_host_size_t j = 0; j < IREE_HAL_STATISTIC_COUNT; ++j) {
+      values[j] += (uint64_t)iree_atomic_load_int64(
+          &iree_hal_statistics_stripes[i].values[j], iree_memory_order_relaxed);
+    }
+  }
+  out_statistics->queue_submission_count =
+      values[IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT];
+  out_statistics->command_buffer_submission_count =
+      values[IREE_HAL_STATISTIC_COMMAND_BUFFER_SUBMISSION_COUNT];
+  out_statistics->dispatch_count = values[IREE_HAL_STATISTIC_DISPATCH_COUNT];
+  out_statistics->bytes_copied = values[IREE_HAL_STATISTIC_BYTES_COPIED];
+  out_statistics->bytes_filled = values[IREE_HAL_STATISTIC_BYTES_FILLED];
+  out_statistics->host_allocation_count =
+      values[IREE_HAL_STATISTIC_HOST_ALLOCATION_COUNT];
+  out_statistics->device_allocation_count =
+      values[IREE_HAL_STATISTIC_DEVICE_ALLOCATION_COUNT];
+  out_statistics->semaphore_wait_count =
+      values[IREE_HAL_STATISTIC_SEMAPHORE_WAIT_COUNT];
+  out_statistics->semaphore_wait_ns =
+      values[IREE_HAL_STATISTIC_SEMAPHORE_WAIT_NS];
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_statistics_format(
+    const iree_hal_statistics_t* statistics, iree_string_builder_t* builder) {
+#if IREE_STATISTICS_ENABLE
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder,
+      "      QUEUE: %12" PRIu64 " submissions / %12" PRIu64
+      " command buffers / %12" PRIu64 " dispatches\n",
+      statistics->queue_submission_count,
+      statistics->command_buffer_submission_count,
+      statistics->dispatch_count));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder,
+      "   TRANSFER: %12" PRIu64 "B copied / %12" PRIu64 "B filled\n",
+      statistics->bytes_copied, statistics->bytes_filled));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder,
+      "ALLOCATIONS: %12" PRIu64 " host-local / %12" PRIu64 " device-local\n",
+      statistics->host_allocation_count, statistics->device_allocation_count));
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "      WAITS: %12" PRIu64 " waits / %12.3fms blocked\n",
+      statistics->semaphore_wait_count,
+      statistics->semaphore_wait_ns / 1000000.0));
+#else
+  // No-op when disabled.
+#endif  // IREE_STATISTICS_ENABLE
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_statistics_fprint(
+    FILE* file, iree_allocator_t host_allocator) {
+#if IREE_STATISTICS_ENABLE
+  iree_hal_statistics_t statistics;
+  iree_hal_statistics_query(&statistics);
+
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(host_allocator, &builder);
+  iree_status_t status = iree_string_builder_append_cstring(
+      &builder, "[[ iree_hal_statistics_t ]]\n");
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_statistics_format(&statistics, &builder);
+  }
+  if (iree_status_is_ok(status)) {
+    fprintf(file, "%.*s", (int)iree_string_builder_size(&builder),
+            iree_string_builder_buffer(&builder));
+  }
+  iree_string_builder_deinitialize(&builder);
+  return status;
+#else
+  // No-op.
+  return iree_ok_status();
+#endif  // IREE_STATISTICS_ENABLE
+}
@@ -0,0 +1,104 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_STATISTICS_H_
+#define IREE_HAL_STATISTICS_H_
+
+#include <stdint.h>
+#include <stdio.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_statistics_t
+//===----------------------------------------------------------------------===//
+
+// Process-wide counters of work issued through the HAL API.
+//
+// Counters are recorded in the API layer and are available with every driver.
+// Unlike tracing they are cheap enough to leave enabled in production: each
+// update is a relaxed atomic add into a per-processor stripe and stripes are
+// only summed when queried. Counters only ever increase; callers interested in
+// a particular interval should query at its start and end and subtract.
+typedef struct iree_hal_statistics_t {
+#if IREE_STATISTICS_ENABLE
+  // Operations submitted to device queues (execute, copy, fill, alloca, etc).
+  uint64_t queue_submission_count;
+  // Command buffers submitted for execution. Reusable command buffers are
+  // counted each time they are submitted.
+  uint64_t command_buffer_submission_count;
+  // Dispatches recorded into command buffers, direct and indirect.
+  uint64_t dispatch_count;
+  // Bytes copied by command buffer and queue transfer operations.
+  uint64_t bytes_copied;
+  // Bytes written by command buffer and queue fill operations.
+  uint64_t bytes_filled;
+  // Buffers allocated from host-local heaps.
+  uint64_t host_allocation_count;
+  // Buffers allocated from device-local heaps.
+  uint64_t device_allocation_count;
+  // Host waits on semaphores, including those made through fences.
+  uint64_t semaphore_wait_count;
+  // Total time spent blocked in semaphore waits.
+  uint64_t semaphore_wait_ns;
+#else
+  int reserved;
+#endif  // IREE_STATISTICS_ENABLE
+} iree_hal_statistics_t;
+
+// Queries the current value of all HAL counters.
+// Thread-safe; counters updated concurrently with the query may or may not be
+// included.
+//
+// NOTE: statistics may be compiled out in some configurations and this call
+// will become a memset(0).
+IREE_API_EXPORT void iree_hal_statistics_query(
+    iree_hal_statistics_t* out_statistics);
+
+// Formats HAL statistics as a pretty-printed multi-line string.
+IREE_API_EXPORT iree_status_t iree_hal_statistics_format(
+    const iree_hal_statistics_t* statistics, iree_string_builder_t* builder);
+
+// Prints the current HAL statistics to |file|.
+// No-op if statistics are not enabled (IREE_STATISTICS_ENABLE).
+IREE_API_EXPORT iree_status_t iree_hal_statistics_fprint(
+    FILE* file, iree_allocator_t host_allocator);
+
+//===----------------------------------------------------------------------===//
+// Recording (internal)
+//===----------------------------------------------------------------------===//
+
+// Identifies a counter in iree_hal_statistics_t.
+typedef enum iree_hal_statistic_e {
+  IREE_HAL_STATISTIC_QUEUE_SUBMISSION_COUNT = 0,
+  IREE_HAL_STATISTIC_COMMAND_BUFFER_SUBMISSION_COUNT,
+  IREE_HAL_STATISTIC_DISPATCH_COUNT,
+  IREE_HAL_STATISTIC_BYTES_COPIED,
+  IREE_HAL_STATISTIC_BYTES_FILLED,
+  IREE_HAL_STATISTIC_HOST_ALLOCATION_COUNT,
+  IREE_HAL_STATISTIC_DEVICE_ALLOCATION_COUNT,
+  IREE_HAL_STATISTIC_SEMAPHORE_WAIT_COUNT,
+  IREE_HAL_STATISTIC_SEMAPHORE_WAIT_NS,
+  IREE_HAL_STATISTIC_COUNT,
+} iree_hal_statistic_t;
+
+#if IREE_STATISTICS_ENABLE
+// Adds |value| to |statistic|. Only intended for use by HAL implementations.
+IREE_API_EXPORT void iree_hal_statistics_record(iree_hal_statistic_t statistic,
+                                               uint64_t value);
+#else
+#define iree_hal_statistics_record(statistic, value)
+#endif  // IREE_STATISTICS_ENABLE
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_STATISTICS_H_
@@ -6,11 +6,78 @@
 
 #include "iree/hal/utils/caching_allocator.h"
 
+#include "iree/base/internal/math.h"
 #include "iree/base/internal/synchronization.h"
+#include "iree/hal/detail.h"
 
 // Default capacity of a pool free list when not specified by the user.
 #define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY 64
 
+// Default size of the blocks suballocated for small size classes.
+#define IREE_HAL_CACHING_ALLOCATOR_DEFAULT_SLAB_BLOCK_SIZE (4 * 1024 * 1024)
+
+// Minimum number of slots a slab block must be divided into for a size class to
+// be suballocated. Larger size classes receive dedicated allocations.
+#define IREE_HAL_CACHING_ALLOCATOR_MIN_SLAB_SLOT_COUNT 8
+
+//===----------------------------------------------------------------------===//
+// Size classes
+//===----------------------------------------------------------------------===//
+
+// log2 of the smallest size class; smaller requests are rounded up to it.
+#define IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2 8
+
+// log2 of the number of size classes between each power of two.
+// With 4 steps each class wastes at most 25% of its size.
+#define IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_STEPS_LOG2 2
+
+// Total number of size classes covering all of iree_device_size_t.
+#define IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_COUNT                 \
+  ((((iree_host_size_t)sizeof(iree_device_size_t) * 8 -             \
+     IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2)                \
+    << IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_STEPS_LOG2) +          \
+   1)
+
+// Returns the index of the smallest size class that can hold |size| bytes and
+// the size of the class in |out_class_size|.
+//
+// Size classes are 2^n + k * 2^(n - steps_log2) for k in [1, 2^steps_log2]
+// covering the range (2^n, 2^(n+1)].
+static iree_host_size_t iree_hal_caching_allocator_size_class_ceil(
+    iree_device_size_t size, iree_device_size_t* out_class_size) {
+  const iree_device_size_t min_class_size =
+      (iree_device_size_t)1 << IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2;
+  if (size <= min_class_size) {
+    *out_class_size = min_class_size;
+    return 0;
+  }
+  const int n = 63 - iree_math_count_leading_zeros_u64((uint64_t)size - 1);
+  const int step_log2 = n - IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_STEPS_LOG2;
+  iree_device_size_t class_size =
+      iree_device_align(size, (iree_device_size_t)1 << step_log2);
+  if (IREE_UNLIKELY(class_size < size)) {
+    // Overflowed the top class; the allocation will never succeed anyway.
+    class_size = size;
+  }
+  *out_class_size = class_size;
+  const iree_host_size_t k =
+      (iree_host_size_t)(class_size >> step_log2) -
+      ((iree_host_size_t)1 << IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_STEPS_LOG2);
+  return ((iree_host_size_t)(n - IREE_HAL_CACHING_ALLOCATOR_MIN_SIZE_CLASS_LOG2)
+          << IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_STEPS_LOG2) +
+         k;
+}
+
+// Returns the index of the largest size class that fits within |size| bytes.
+// Used to file allocations that may be larger than their requested class.
+static iree_host_size_t iree_hal_caching_allocator_size_class_floor(
+    iree_device_size_t size) {
+  iree_device_size_t class_size = 0;
+  iree_host_size_t class_index =
+      iree_hal_caching_allocator_size_class_ceil(size, &class_size);
+  return class_size > size && class_index > 0 ? class_index - 1 : class_index;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_caching_allocator_pool_t
 //===----------------------------------------------------------------------===//
@@ -28,11 +95,66 @@ void iree_hal_caching_allocator_pool_params_initialize(
   out_params->max_allocation_capacity = IREE_DEVICE_SIZE_MAX;
   out_params->max_free_allocation_count =
       IREE_HAL_CACHING_ALLOCATOR_DEFAULT_FREE_LIST_CAPACITY;
+  out_params->slab_block_size =
+      IREE_HAL_CACHING_ALLOCATOR_DEFAULT_SLAB_BLOCK_SIZE;
 }
 
+// Sentinel used to terminate index-linked lists.
+#define IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX UINT32_MAX
+
+typedef struct iree_hal_caching_allocator_pool_t
+    iree_hal_caching_allocator_pool_t;
+typedef struct iree_hal_caching_allocator_slab_t
+    iree_hal_caching_allocator_slab_t;
+
+// A buffer referencing a slot in a slab block.
+// Storage for the buffers lives in the slab so that suballocating requires no
+// host allocations.
+typedef struct iree_hal_caching_allocator_slab_buffer_t {
+  iree_hal_buffer_t base;
+  // Slab the slot belongs to.
+  iree_hal_caching_allocator_slab_t* slab;
+  // Index of the next free slot in the slab when this slot is free.
+  uint32_t next_free_slot;
+} iree_hal_caching_allocator_slab_buffer_t;
+
+// A block acquired from the underlying allocator divided into equally sized
+// slots of a single size class.
+struct iree_hal_caching_allocator_slab_t {
+  // Next slab with the same size class in the pool.
+  iree_hal_caching_allocator_slab_t* next;
+  // Pool the slab was allocated from and is accounted against.
+  iree_hal_caching_allocator_pool_t* pool;
+  // Block allocated from the underlying allocator. Retained by the slab and by
+  // each live slot buffer.
+  iree_hal_buffer_t* block;
+  // Size of the block as accounted in the pool.
+  iree_device_size_t block_size;
+  // Distance in bytes between each slot in the block.
+  iree_device_size_t slot_stride;
+  // Total number of slots in the block.
+  uint32_t slot_count;
+  // Number of slots currently allocated.
+  uint32_t live_count;
+  // Index of the first free slot or IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX.
+  uint32_t free_slot;
+  iree_hal_caching_allocator_slab_buffer_t slots[];
+};
+
+// An entry in a pool size class free list.
+typedef struct iree_hal_caching_allocator_free_entry_t {
+  // Free buffer retained by the pool or NULL if the entry is unused.
+  iree_hal_buffer_t* buffer;
+  // Monotonically increasing sequence number used to trim the oldest first.
+  uint64_t release_sequence;
+  // Next entry in the size class list (or unused list).
+  uint32_t next;
+} iree_hal_caching_allocator_free_entry_t;
+
 // Pool of arbitrarily-sized device allocations for a particular heap.
-// This maintains a free list of blocks available for use but does not track
-// outstanding allocations.
+// This maintains free lists of allocations available for use per size class and
+// slabs of suballocated blocks for small size classes but does not track
+// outstanding dedicated allocations.
 //
 // Thread-safe. Pools can service requests from multiple threads concurrently by
 // way of a pool-specific mutex. The mutex will not be held during underlying
@@ -47,6 +169,12 @@ typedef iree_alignas(
   // Unretained as the parent allocator retains it for us.
   iree_hal_allocator_t* device_allocator;
 
+  // Allocator used for slab bookkeeping.
+  iree_allocator_t host_allocator;
+
+  // Largest size class that is suballocated from slabs or 0 if disabled.
+  iree_device_size_t max_slab_class_size;
+
   // Guards access to the pool data structures as buffers can be
   // acquired/released from multiple threads if shared across user-visible
   // devices.
@@ -60,16 +188,34 @@ typedef iree_alignas(
   // observe imported/exported buffers.
   iree_device_size_t total_allocated_size;
 
-  // Total size, in bytes, of all free buffers currently in this pool.
+  // Total size, in bytes, of all free buffers and free slab slots currently in
+  // this pool.
   iree_device_size_t free_allocated_size;
 
-  // Flat MRU list of available buffers with max_free_allocation_count slots.
-  // Sorted by ascending recency (the higher the index the more recent).
-  // If we really cared about optimizing the interior removal then we'd want
-  // a linked/skip list or some bucketing but that's really for the higher
-  // level allocators to do.
+  IREE_STATISTICS(struct {
+    uint64_t hit_count;
+    uint64_t miss_count;
+    iree_device_size_t wasted_size;
+  } statistics;)
+
+  // Slabs for each size class that is suballocated.
+  iree_hal_caching_allocator_slab_t*
+      slabs[IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_COUNT];
+
+  // Heads of the free lists for each size class, most recently used first.
+  uint32_t free_heads[IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_COUNT];
+
+  // Head of the list of unused entries in |free_entries|.
+  uint32_t unused_entry_head;
+
+  // Sequence number assigned to the next released buffer.
+  uint64_t next_release_sequence;
+
+  // Total number of buffers across all free lists.
   iree_host_size_t free_count;
-  iree_hal_buffer_t* free_buffers[];
+
+  // Storage for free list entries with max_free_allocation_count slots.
+  iree_hal_caching_allocator_free_entry_t free_entries[];
 } iree_hal_caching_allocator_pool_t;
 
 static void iree_hal_caching_allocator_pool_trim(
@@ -79,15 +225,45 @@ static void iree_hal_caching_allocator_pool_trim(
 // Buffer device storage will be allocated from |device_allocator|.
 static void iree_hal_caching_allocator_pool_initialize(
     iree_hal_caching_allocator_pool_params_t params,
-    iree_hal_allocator_t* device_allocator,
+    iree_hal_allocator_t* device_allocator, iree_allocator_t host_allocator,
     iree_hal_caching_allocator_pool_t* out_pool) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_pool->params = params;
   out_pool->device_allocator = device_allocator;
+  out_pool->host_allocator = host_allocator;
   iree_slim_mutex_initialize(&out_pool->mutex);
   out_pool->total_allocated_size = 0;
   out_pool->free_allocated_size = 0;
+  IREE_STATISTICS(
+      memset(&out_pool->statistics, 0, sizeof(out_pool->statistics)));
+
+  // Slabs are only used if they can be retained by the pool.
+  iree_device_size_t slab_block_size =
+      iree_min(params.slab_block_size, params.heap.max_allocation_size);
+  out_pool->max_slab_class_size =
+      slab_block_size <= params.max_allocation_capacity
+          ? slab_block_size / IREE_HAL_CACHING_ALLOCATOR_MIN_SLAB_SLOT_COUNT
+          : 0;
+  out_pool->params.slab_block_size = slab_block_size;
+
+  for (iree_host_size_t i = 0; i < IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_COUNT;
+       ++i) {
+    out_pool->slabs[i] = NULL;
+    out_pool->free_heads[i] = IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX;
+  }
+  for (iree_host_size_t i = 0; i < params.max_free_allocation_count; ++i) {
+    out_pool->free_entries[i].buffer = NULL;
+    out_pool->free_entries[i].release_sequence = 0;
+    out_pool->free_entries[i].next =
+        i + 1 < params.max_free_allocation_count
+            ? (uint32_t)(i + 1)
+            : IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX;
+  }
+  out_pool->unused_entry_head = params.max_free_allocation_count
+                                    ? 0
+                                    : IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX;
+  out_pool->next_release_sequence = 0;
   out_pool->free_count = 0;
 
   IREE_TRACE_SET_PLOT_TYPE(IREE_HAL_CACHING_ALLOCATOR_ID,
@@ -119,8 +295,28 @@ static void iree_hal_caching_allocator_pool_deinitialize(
   IREE_TRACE_ZONE_END(z0);
 }
 
-// Pushes |buffer| on to the pool free list as the most recently used.
-// The buffer will be retained in the list.
+// Returns true if |buffer| can service a request with the given |params|.
+static bool iree_hal_caching_allocator_is_compatible(
+    iree_hal_buffer_t* buffer, const iree_hal_buffer_params_t* params) {
+  // NOTE: we are not currently checking alignment as we don't really have it.
+  // We assume programs will use consistent alignments for a particular heap
+  // (as the heap has a min alignment).
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           params->usage);
+}
+
+static void iree_hal_caching_allocator_pool_update_free_size(
+    iree_hal_caching_allocator_pool_t* pool, iree_device_size_t added_size,
+    iree_device_size_t removed_size) {
+  pool->free_allocated_size += added_size;
+  pool->free_allocated_size -= removed_size;
+  IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
+                            pool->free_allocated_size);
+}
+
+// Pushes |buffer| on to the pool free list for its size class as the most
+// recently used. The buffer will be retained in the list.
 //
 // Must be called with the pool mutex held.
 static void iree_hal_caching_allocator_pool_push_buffer(
@@ -130,63 +326,117 @@ static void iree_hal_caching_allocator_pool_push_buffer(
   iree_hal_buffer_retain(buffer);
 
   IREE_ASSERT_LT(pool->free_count, pool->params.max_free_allocation_count);
-
-  // Add to the end of the list (the most recent).
-  iree_host_size_t i = pool->free_count++;
-  pool->free_buffers[i] = buffer;
+  const uint32_t i = pool->unused_entry_head;
+  iree_hal_caching_allocator_free_entry_t* entry = &pool->free_entries[i];
+  pool->unused_entry_head = entry->next;
+
+  // Add to the head of the class list (the most recent).
+  const iree_host_size_t class_index =
+      iree_hal_caching_allocator_size_class_floor(buffer->allocation_size);
+  entry->buffer = buffer;
+  entry->release_sequence = pool->next_release_sequence++;
+  entry->next = pool->free_heads[class_index];
+  pool->free_heads[class_index] = i;
+  ++pool->free_count;
 
   // Track that we're now retaining unused memory.
-  pool->free_allocated_size += buffer->allocation_size;
-  IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
-                            pool->free_allocated_size);
+  iree_hal_caching_allocator_pool_update_free_size(pool,
+                                                   buffer->allocation_size, 0);
 }
 
-// Takes the buffer in the |pool| free list at index |i| and returns ownership.
-// If the list is large this is bad but in most cases it's just a few dozen
-// elements.
+// Unlinks the entry referenced by |link| from its list and returns ownership of
+// its buffer.
 //
 // Must be called with the pool mutex held.
-static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_buffer_at(
-    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t i) {
-  iree_hal_buffer_t* buffer = pool->free_buffers[i];
-  if (i < pool->free_count - 1) {
-    // Shift the list down to keep it dense and in ascending recency order.
-    memmove(&pool->free_buffers[i], &pool->free_buffers[i + 1],
-            (pool->free_count - i - 1) * sizeof(pool->free_buffers[0]));
-  }
+static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_entry(
+    iree_hal_caching_allocator_pool_t* pool, uint32_t* link) {
+  const uint32_t i = *link;
+  iree_hal_caching_allocator_free_entry_t* entry = &pool->free_entries[i];
+  iree_hal_buffer_t* buffer = entry->buffer;
+  *link = entry->next;
+  entry->buffer = NULL;
+  entry->next = pool->unused_entry_head;
+  pool->unused_entry_head = i;
   --pool->free_count;
-  pool->free_allocated_size -= buffer->allocation_size;
-  IREE_TRACE_PLOT_VALUE_I64(IREE_HAL_CACHING_ALLOCATOR_ID,
-                            pool->free_allocated_size);
+  iree_hal_caching_allocator_pool_update_free_size(pool, 0,
+                                                   buffer->allocation_size);
   return buffer;
 }
 
-// Scans the |pool| free list for a buffer matching the given requirements and
-// returns ownership.
+// Scans the |pool| free list of |class_index| for a buffer matching the given
+// requirements and returns ownership.
 //
 // Must be called with the pool mutex held.
 static iree_hal_buffer_t* iree_hal_caching_allocator_pool_find_and_take_buffer(
-    iree_hal_caching_allocator_pool_t* pool,
-    const iree_hal_buffer_params_t* params,
-    iree_device_size_t allocation_size) {
-  // Walk backwards so that we check the most recently released buffers first.
-  for (int i = (int)pool->free_count - 1; i >= 0; --i) {
-    // NOTE: we are not currently checking alignment as we don't really have it.
-    // We assume programs will use consistent alignments for a particular heap
-    // (as the heap has a min alignment).
-    iree_hal_buffer_t* buffer = pool->free_buffers[i];
-    if (iree_all_bits_set(iree_hal_buffer_memory_type(buffer), params->type) &&
-        iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
-                          params->usage) &&
-        iree_hal_buffer_allocation_size(buffer) == allocation_size) {
-      return iree_hal_caching_allocator_pool_take_buffer_at(pool, i);
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    const iree_hal_buffer_params_t* params) {
+  // Walk the list in order so that we check the most recently released buffers
+  // first.
+  for (uint32_t* link = &pool->free_heads[class_index];
+       *link != IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX;
+       link = &pool->free_entries[*link].next) {
+    if (iree_hal_caching_allocator_is_compatible(
+            pool->free_entries[*link].buffer, params)) {
+      return iree_hal_caching_allocator_pool_take_entry(pool, link);
     }
   }
   return NULL;  // nothing found
 }
 
+// Takes the least recently released buffer in the |pool| free lists and
+// returns ownership. Returns NULL if the free lists are empty.
+//
+// Must be called with the pool mutex held.
+static iree_hal_buffer_t* iree_hal_caching_allocator_pool_take_oldest_buffer(
+    iree_hal_caching_allocator_pool_t* pool) {
+  if (!pool->free_count) return NULL;
+  const iree_hal_caching_allocator_free_entry_t* oldest_entry = NULL;
+  for (iree_host_size_t i = 0; i < pool->params.max_free_allocation_count;
+       ++i) {
+    const iree_hal_caching_allocator_free_entry_t* entry =
+        &pool->free_entries[i];
+    if (!entry->buffer) continue;
+    if (!oldest_entry ||
+        entry->release_sequence < oldest_entry->release_sequence) {
+      oldest_entry = entry;
+    }
+  }
+  const iree_host_size_t class_index =
+      iree_hal_caching_allocator_size_class_floor(
+          oldest_entry->buffer->allocation_size);
+  uint32_t* link = &pool->free_heads[class_index];
+  while (&pool->free_entries[*link] != oldest_entry) {
+    link = &pool->free_entries[*link].next;
+  }
+  return iree_hal_caching_allocator_pool_take_entry(pool, link);
+}
+
+// Unlinks and returns a slab with no live slots from |pool|, if any.
+//
+// Must be called with the pool mutex held.
+static iree_hal_caching_allocator_slab_t*
+iree_hal_caching_allocator_pool_take_empty_slab(
+    iree_hal_caching_allocator_pool_t* pool) {
+  if (!pool->max_slab_class_size) return NULL;
+  for (iree_host_size_t i = 0; i < IREE_HAL_CACHING_ALLOCATOR_SIZE_CLASS_COUNT;
+       ++i) {
+    for (iree_hal_caching_allocator_slab_t** link = &pool->slabs[i]; *link;
+         link = &(*link)->next) {
+      iree_hal_caching_allocator_slab_t* slab = *link;
+      if (slab->live_count == 0) {
+        *link = slab->next;
+        slab->next = NULL;
+        iree_hal_caching_allocator_pool_update_free_size(pool, 0,
+                                                         slab->block_size);
+        return slab;
+      }
+    }
+  }
+  return NULL;
+}
+
 // Trims |pool| down to at most |target_size| of available allocations.
-// The oldest allocations will be trimmed first.
+// The oldest free buffers will be trimmed first followed by empty slabs.
 //
 // Thread-safe; multiple threads may concurrently access the |pool|.
 static void iree_hal_caching_allocator_pool_trim_to_size(
@@ -196,22 +446,31 @@ static void iree_hal_caching_allocator_pool_trim_to_size(
 
   iree_slim_mutex_lock(&pool->mutex);
 
-  while (pool->free_count > 0 && pool->total_allocated_size > target_size) {
-    // Take the oldest buffer in the list.
+  while (pool->total_allocated_size > target_size) {
+    // Take the oldest buffer in the lists and if there are none an empty slab.
     iree_hal_buffer_t* dead_buffer =
-        iree_hal_caching_allocator_pool_take_buffer_at(pool,
-                                                       pool->free_count - 1);
+        iree_hal_caching_allocator_pool_take_oldest_buffer(pool);
+    iree_hal_caching_allocator_slab_t* dead_slab =
+        dead_buffer ? NULL
+                    : iree_hal_caching_allocator_pool_take_empty_slab(pool);
+    if (!dead_buffer && !dead_slab) break;
 
     // NOTE: we've removed the buffer but have not subtracted the size from
     // the total yet - we want to do that only after releasing the buffer.
     // If we didn't it's possible for another thread to start an allocation
     // thinking that we've already released the buffer.
     iree_device_size_t allocation_size =
-        iree_hal_buffer_allocation_size(dead_buffer);
+        dead_buffer ? iree_hal_buffer_allocation_size(dead_buffer)
+                    : dead_slab->block_size;
 
     // Release the buffer without holding the lock as deallocation can be slow.
     iree_slim_mutex_unlock(&pool->mutex);
-    iree_hal_allocator_deallocate_buffer(pool->device_allocator, dead_buffer);
+    if (dead_buffer) {
+      iree_hal_allocator_deallocate_buffer(pool->device_allocator, dead_buffer);
+    } else {
+      iree_hal_buffer_release(dead_slab->block);
+      iree_allocator_free(pool->host_allocator, dead_slab);
+    }
     iree_slim_mutex_lock(&pool->mutex);
 
     // Update accounting to represent that we've released the buffer.
@@ -232,6 +491,186 @@ static void iree_hal_caching_allocator_pool_trim(
   iree_hal_caching_allocator_pool_trim_to_size(pool, 0);
 }
 
+static const iree_hal_buffer_vtable_t
+    iree_hal_caching_allocator_slab_buffer_vtable;
+
+// Takes a free slot from |slab| and initializes it as a buffer of
+// |allocation_size| bytes.
+//
+// Must be called with the pool mutex held.
+static iree_hal_buffer_t* iree_hal_caching_allocator_slab_take_slot(
+    iree_hal_caching_allocator_slab_t* slab,
+    iree_device_size_t allocation_size) {
+  const uint32_t slot_index = slab->free_slot;
+  iree_hal_caching_allocator_slab_buffer_t* slot = &slab->slots[slot_index];
+  slab->free_slot = slot->next_free_slot;
+  ++slab->live_count;
+
+  iree_hal_buffer_t* block = slab->block;
+  iree_hal_buffer_initialize(
+      slab->pool->host_allocator, /*device_allocator=*/NULL, block,
+      block->allocation_size, slot_index * slab->slot_stride, allocation_size,
+      block->memory_type, block->allowed_access, block->allowed_usage,
+      &iree_hal_caching_allocator_slab_buffer_vtable, &slot->base);
+
+  iree_hal_caching_allocator_pool_update_free_size(slab->pool, 0,
+                                                   slab->slot_stride);
+  IREE_STATISTICS(slab->pool->statistics.wasted_size +=
+                  slab->slot_stride - allocation_size);
+  return &slot->base;
+}
+
+// Scans the |pool| slabs of |class_index| for a free slot compatible with the
+// given requirements and returns it as a buffer.
+//
+// Must be called with the pool mutex held.
+static iree_hal_buffer_t* iree_hal_caching_allocator_pool_find_and_take_slot(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size) {
+  for (iree_hal_caching_allocator_slab_t* slab = pool->slabs[class_index]; slab;
+       slab = slab->next) {
+    if (slab->free_slot != IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX &&
+        iree_hal_caching_allocator_is_compatible(slab->block, params)) {
+      return iree_hal_caching_allocator_slab_take_slot(slab, allocation_size);
+    }
+  }
+  return NULL;  // nothing found
+}
+
+// Allocates a new slab for |class_size| from the underlying allocator and takes
+// a slot from it. The slab block size must have already been accounted for in
+// the pool total.
+//
+// Thread-safe; the pool mutex must not be held by the caller.
+static iree_status_t iree_hal_caching_allocator_pool_allocate_slab(
+    iree_hal_caching_allocator_pool_t* pool, iree_host_size_t class_index,
+    iree_device_size_t class_size, const iree_hal_buffer_params_t* params,
+    iree_device_size_t allocation_size, iree_hal_buffer_t** out_buffer) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)class_size);
+
+  // Slots are aligned to the heap alignment so that each suballocation meets
+  // the same requirements as a dedicated allocation would.
+  const iree_device_size_t block_size = pool->params.slab_block_size;
+  const iree_device_size_t slot_stride = iree_device_align(
+      class_size, iree_max(1, pool->params.heap.min_alignment));
+  const uint32_t slot_count = (uint32_t)(block_size / slot_stride);
+
+  iree_hal_buffer_t* block = NULL;
+  iree_status_t status = iree_hal_allocator_allocate_buffer(
+      pool->device_allocator, *params, block_size, &block);
+
+  iree_hal_caching_allocator_slab_t* slab = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(
+        pool->host_allocator,
+        sizeof(*slab) + slot_count * sizeof(slab->slots[0]), (void**)&slab);
+  }
+
+  iree_slim_mutex_lock(&pool->mutex);
+  if (iree_status_is_ok(status)) {
+    slab->pool = pool;
+    slab->block = block;
+    slab->block_size = block_size;
+    slab->slot_stride = slot_stride;
+    slab->slot_count = slot_count;
+    slab->live_count = 0;
+    for (uint32_t i = 0; i < slot_count; ++i) {
+      slab->slots[i].slab = slab;
+      slab->slots[i].next_free_slot =
+          i + 1 < slot_count ? i + 1 : IREE_HAL_CACHING_ALLOCATOR_NULL_INDEX;
+    }
+    slab->free_slot = 0;
+    slab->next = pool->slabs[class_index];
+    pool->slabs[class_index] = slab;
+    iree_hal_caching_allocator_pool_update_free_size(pool, block_size, 0);
+    *out_buffer =
+        iree_hal_caching_allocator_slab_take_slot(slab, allocation_size);
+  } else {
+    pool->total_allocated_size -= block_size;
+  }
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_release(block);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns the slot referenced by |buffer| to its slab.
+//
+// Thread-safe; the pool mutex must not be held by the caller.
+static void iree_hal_caching_allocator_slab_buffer_destroy(
+    iree_hal_buffer_t* base_buffer) {
+  iree_hal_caching_allocator_slab_buffer_t* buffer =
+      (iree_hal_caching_allocator_slab_buffer_t*)base_buffer;
+  iree_hal_caching_allocator_slab_t* slab = buffer->slab;
+  iree_hal_caching_allocator_pool_t* pool = slab->pool;
+
+  // The slab retains the block so this will never be the last reference.
+  iree_hal_buffer_release(base_buffer->allocated_buffer);
+  base_buffer->allocated_buffer = NULL;
+
+  iree_slim_mutex_lock(&pool->mutex);
+  IREE_STATISTICS(pool->statistics.wasted_size -=
+                  slab->slot_stride - base_buffer->byte_length);
+  buffer->next_free_slot = slab->free_slot;
+  slab->free_slot = (uint32_t)(buffer - slab->slots);
+  --slab->live_count;
+  iree_hal_caching_allocator_pool_update_free_size(pool, slab->slot_stride, 0);
+  iree_slim_mutex_unlock(&pool->mutex);
+}
+
+static iree_status_t iree_hal_caching_allocator_slab_buffer_map_range(
+    iree_hal_buffer_t* buffer, iree_hal_mapping_mode_t mapping_mode,
+    iree_hal_memory_access_t memory_access,
+    iree_device_size_t local_byte_offset, iree_device_size_t local_byte_length,
+    iree_hal_buffer_mapping_t* mapping) {
+  return IREE_HAL_VTABLE_DISPATCH(buffer->allocated_buffer, iree_hal_buffer,
+                                  map_range)(
+      buffer->allocated_buffer, mapping_mode, memory_access, local_byte_offset,
+      local_byte_length, mapping);
+}
+
+static iree_status_t iree_hal_caching_allocator_slab_buffer_unmap_range(
+    iree_hal_buffer_t* buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length, iree_hal_buffer_mapping_t* mapping) {
+  if (!buffer->allocated_buffer) return iree_ok_status();
+  return IREE_HAL_VTABLE_DISPATCH(buffer->allocated_buffer, iree_hal_buffer,
+                                  unmap_range)(
+      buffer->allocated_buffer, local_byte_offset, local_byte_length, mapping);
+}
+
+static iree_status_t iree_hal_caching_allocator_slab_buffer_invalidate_range(
+    iree_hal_buffer_t* buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  return IREE_HAL_VTABLE_DISPATCH(buffer->allocated_buffer, iree_hal_buffer,
+                                  invalidate_range)(
+      buffer->allocated_buffer, local_byte_offset, local_byte_length);
+}
+
+static iree_status_t iree_hal_caching_allocator_slab_buffer_flush_range(
+    iree_hal_buffer_t* buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  return IREE_HAL_VTABLE_DISPATCH(buffer->allocated_buffer, iree_hal_buffer,
+                                  flush_range)(
+      buffer->allocated_buffer, local_byte_offset, local_byte_length);
+}
+
+static const iree_hal_buffer_vtable_t
+    iree_hal_caching_allocator_slab_buffer_vtable = {
+        .recycle = iree_hal_buffer_recycle,
+        .destroy = iree_hal_caching_allocator_slab_buffer_destroy,
+        .map_range = iree_hal_caching_allocator_slab_buffer_map_range,
+        .unmap_range = iree_hal_caching_allocator_slab_buffer_unmap_range,
+        .invalidate_range =
+            iree_hal_caching_allocator_slab_buffer_invalidate_range,
+        .flush_range = iree_hal_caching_allocator_slab_buffer_flush_range,
+};
+
 // Acquires a buffer of |allocation_size| from the |pool|.
 // The buffer will have a memory type and usage compatible with the given types.
 // Fails if the pool is empty and the underlying device fails the allocation.
@@ -244,20 +683,38 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)allocation_size);
 
-  // Scan the free list to find an appropriate block.
+  iree_device_size_t class_size = 0;
+  const iree_host_size_t class_index =
+      iree_hal_caching_allocator_size_class_ceil(allocation_size, &class_size);
+  const bool use_slab = class_size <= pool->max_slab_class_size;
+
+  // Scan the free list or slabs of the size class to find an appropriate block.
   // If found we pop it off the list and return it without needing to allocate.
   iree_slim_mutex_lock(&pool->mutex);
   iree_hal_buffer_t* existing_buffer =
-      iree_hal_caching_allocator_pool_find_and_take_buffer(pool, params,
-                                                           allocation_size);
-  if (!existing_buffer) {
+      use_slab ? iree_hal_caching_allocator_pool_find_and_take_slot(
+                     pool, class_index, params, allocation_size)
+               : iree_hal_caching_allocator_pool_find_and_take_buffer(
+                     pool, class_index, params);
+  const iree_device_size_t reserve_size =
+      use_slab ? pool->params.slab_block_size : class_size;
+  if (existing_buffer) {
+    IREE_STATISTICS(++pool->statistics.hit_count);
+    if (!use_slab) {
+      IREE_STATISTICS(pool->statistics.wasted_size +=
+                      existing_buffer->allocation_size - allocation_size);
+    }
+  } else {
     // We'll need to allocate so we add the size such that it'll be accounted
     // for by other threads allocating at the same time.
-    pool->total_allocated_size += allocation_size;
+    IREE_STATISTICS(++pool->statistics.miss_count);
+    pool->total_allocated_size += reserve_size;
   }
   iree_slim_mutex_unlock(&pool->mutex);
   if (existing_buffer) {
-    // Found a buffer! Return it uninitialized.
+    // Found a buffer! Return it uninitialized. Cached dedicated buffers may
+    // be larger than requested and are trimmed to the requested length.
+    existing_buffer->byte_length = allocation_size;
     *out_buffer = existing_buffer;
     IREE_TRACE_ZONE_END(z0);
     return iree_ok_status();
@@ -271,25 +728,37 @@ static iree_status_t iree_hal_caching_allocator_pool_acquire(
   // one. Note that we do this without holding the lock as the underlying
   // device allocator can be very slow. It's possible for buffers to be released
   // to the pool by another thread while we're allocating here but that's OK.
+  if (use_slab) {
+    iree_status_t status = iree_hal_caching_allocator_pool_allocate_slab(
+        pool, class_index, class_size, params, allocation_size, out_buffer);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
   iree_hal_buffer_t* buffer = NULL;
   iree_status_t status = iree_hal_allocator_allocate_buffer(
-      pool->device_allocator, *params, allocation_size, &buffer);
+      pool->device_allocator, *params, class_size, &buffer);
 
   // If the allocation failed then remove the size from the total.
+  iree_slim_mutex_lock(&pool->mutex);
   if (iree_status_is_ok(status)) {
+    // The underlying allocator may have rounded up the allocation.
+    pool->total_allocated_size += buffer->allocation_size - class_size;
+    IREE_STATISTICS(pool->statistics.wasted_size +=
+                    buffer->allocation_size - allocation_size);
+    buffer->byte_length = allocation_size;
     *out_buffer = buffer;
   } else {
-    if (buffer) iree_hal_buffer_release(buffer);
-    iree_slim_mutex_lock(&pool->mutex);
-    pool->total_allocated_size -= allocation_size;
-    iree_slim_mutex_unlock(&pool->mutex);
+    pool->total_allocated_size -= class_size;
   }
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (!iree_status_is_ok(status) && buffer) iree_hal_buffer_release(buffer);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
 // Releases a |buffer| to the |pool| if there is capacity remaining.
+// Buffers suballocated from slabs are returned to their slab.
 //
 // Thread-safe; multiple threads may concurrently access the |pool|.
 static void iree_hal_caching_allocator_pool_release(
@@ -304,6 +773,8 @@ static void iree_hal_caching_allocator_pool_release(
 
   const iree_device_size_t allocation_size =
       iree_hal_buffer_allocation_size(buffer);
+  IREE_STATISTICS(pool->statistics.wasted_size -=
+                  allocation_size - buffer->byte_length);
   const bool under_capacity = pool->total_allocated_size - allocation_size <=
                               pool->params.max_allocation_capacity;
   const bool under_count =
@@ -406,7 +877,7 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
   for (iree_host_size_t i = 0; i < pool_count; ++i) {
     iree_hal_caching_allocator_pool_t* pool = NULL;
     total_size += iree_host_align(
-        sizeof(*pool) + sizeof(pool->free_buffers[0]) *
+        sizeof(*pool) + sizeof(pool->free_entries[0]) *
                             pool_params[i].max_free_allocation_count,
         iree_max_align_t);
   }
@@ -428,12 +899,12 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
     iree_hal_caching_allocator_pool_t* pool =
         (iree_hal_caching_allocator_pool_t*)pool_ptr;
     pool_ptr += iree_host_align(
-        sizeof(*pool) + sizeof(pool->free_buffers[0]) *
+        sizeof(*pool) + sizeof(pool->free_entries[0]) *
                             pool_params[i].max_free_allocation_count,
         iree_max_align_t);
     allocator->pools[i] = pool;
     iree_hal_caching_allocator_pool_initialize(pool_params[i], device_allocator,
-                                               pool);
+                                               host_allocator, pool);
   }
 
   *out_allocator = (iree_hal_allocator_t*)allocator;
@@ -547,12 +1018,15 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t max_allocation_size_str = iree_string_view_empty();
     iree_string_view_t max_allocation_capacity_str = iree_string_view_empty();
     iree_string_view_t max_free_allocation_count_str = iree_string_view_empty();
+    iree_string_view_t slab_block_size_str = iree_string_view_empty();
     iree_string_view_split(pool_config, ';', &max_allocation_size_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_allocation_capacity_str,
                            &pool_config);
     iree_string_view_split(pool_config, ';', &max_free_allocation_count_str,
                            &pool_config);
+    iree_string_view_split(pool_config, ';', &slab_block_size_str,
+                           &pool_config);
     max_allocation_size_str = iree_string_view_trim(max_allocation_size_str);
     if (!iree_string_view_is_empty(max_allocation_size_str) &&
         !iree_string_view_equal(max_allocation_size_str, IREE_SV("*"))) {
@@ -584,6 +1058,14 @@ iree_status_t iree_hal_caching_allocator_create_from_spec(
       }
       pool_params->max_free_allocation_count = max_free_allocation_count;
     }
+    slab_block_size_str = iree_string_view_trim(slab_block_size_str);
+    if (!iree_string_view_is_empty(slab_block_size_str) &&
+        !iree_string_view_equal(slab_block_size_str, IREE_SV("*"))) {
+      IREE_RETURN_IF_ERROR(
+          iree_string_view_parse_device_size(slab_block_size_str,
+                                             &pool_params->slab_block_size),
+          "parsing slab_block_size");
+    }
   } while (!iree_string_view_is_empty(config_pairs));
   return iree_hal_caching_allocator_create_with_pools(
       pool_count, pool_params_storage, device_allocator, host_allocator,
@@ -633,6 +1115,25 @@ static void iree_hal_caching_allocator_query_statistics(
       iree_hal_caching_allocator_cast(base_allocator);
   iree_hal_allocator_query_statistics(allocator->device_allocator,
                                       out_statistics);
+  IREE_STATISTICS({
+    // Pool statistics describe our pools only. Any pooling done by the device
+    // allocator sits below us and only sees our misses.
+    out_statistics->pool_hit_count = 0;
+    out_statistics->pool_miss_count = 0;
+    out_statistics->pool_bytes_reserved = 0;
+    out_statistics->pool_bytes_free = 0;
+    out_statistics->pool_bytes_wasted = 0;
+    for (iree_host_size_t i = 0; i < allocator->pool_count; ++i) {
+      iree_hal_caching_allocator_pool_t* pool = allocator->pools[i];
+      iree_slim_mutex_lock(&pool->mutex);
+      out_statistics->pool_hit_count += pool->statistics.hit_count;
+      out_statistics->pool_miss_count += pool->statistics.miss_count;
+      out_statistics->pool_bytes_reserved += pool->total_allocated_size;
+      out_statistics->pool_bytes_free += pool->free_allocated_size;
+      out_statistics->pool_bytes_wasted += pool->statistics.wasted_size;
+      iree_slim_mutex_unlock(&pool->mutex);
+    }
+  });
 }
 
 static iree_status_t iree_hal_caching_allocator_query_memory_heaps(
@@ -741,6 +1242,13 @@ static void iree_hal_caching_allocator_deallocate_buffer(
   iree_hal_caching_allocator_t* allocator =
       iree_hal_caching_allocator_cast(base_allocator);
 
+  // Suballocated buffers return to the slab they came from.
+  if (iree_hal_resource_is(buffer,
+                           &iree_hal_caching_allocator_slab_buffer_vtable)) {
+    iree_hal_buffer_destroy(buffer);
+    return;
+  }
+
   // Try to find the pool we would want to release the buffer into.
   // Note that we are only going to get called if we had successfully placed the
   // buffer into a pool.
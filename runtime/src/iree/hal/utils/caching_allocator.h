@@ -22,6 +22,18 @@ extern "C" {
 // device-local and host-visible buffers on devices with discrete memory.
 // Pools are scanned in-order to allow for prioritization.
 //
+// Requests are rounded up to size classes spaced at quarter steps between
+// powers of two (256, 320, 384, 448, 512, 640, ...) such that allocations of
+// slightly varying sizes - as is common with dynamic shapes - can reuse each
+// other's memory while wasting at most 25% of each allocation. Each pool keeps
+// a free list per size class. Small size classes are suballocated from large
+// slab blocks acquired from the underlying allocator to amortize the cost of
+// device allocations; buffers returned for such allocations are subspans of the
+// slab blocks.
+//
+// Hit, miss, and fragmentation statistics are reported through
+// iree_hal_allocator_query_statistics when IREE_STATISTICS_ENABLE is set.
+//
 // Thread-safe: the allocator can be shared across multiple user-level devices
 // manipulated from multiple threads.
 typedef struct iree_hal_caching_allocator_t iree_hal_caching_allocator_t;
@@ -47,8 +59,16 @@ typedef struct iree_hal_caching_allocator_pool_params_t {
 
   // Maximum number of free allocations that will be tracked.
   // This is used to allocate storage for the free list and should be reasonably
-  // bounded (~64-1024).
+  // bounded (~64-1024). Slots in slab blocks are not counted.
   iree_host_size_t max_free_allocation_count;
+
+  // Size in bytes of the blocks acquired from the underlying allocator and
+  // suballocated for small size classes. Size classes up to 1/8th of the block
+  // size are suballocated while larger ones receive dedicated allocations.
+  // Slab blocks count against max_allocation_capacity and are released once
+  // all of their suballocations have been freed and the pool is trimmed.
+  // May be 0 to disable suballocation.
+  iree_device_size_t slab_block_size;
 } iree_hal_caching_allocator_pool_params_t;
 
 // Initializes |out_params| to the default values using |heap| for storage.
@@ -101,10 +121,10 @@ iree_status_t iree_hal_caching_allocator_create_with_pools(
 // defaults.
 //
 // Expected form:
-//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count
+//   heap_key=max_allocation_size;max_allocation_capacity;max_free_allocation_count[;slab_block_size]
 // Example:
 //   device_local=1gib;1gib;8
-//   host_local=*;*;32
+//   host_local=*;*;32;16mib
 iree_status_t iree_hal_caching_allocator_create_from_spec(
     iree_string_view_t config_pairs, iree_hal_allocator_t* device_allocator,
     iree_allocator_t host_allocator, iree_hal_allocator_t** out_allocator);
@@ -0,0 +1,166 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/caching_allocator.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class CachingAllocatorTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), iree_allocator_system(), iree_allocator_system(),
+        &device_allocator_));
+  }
+
+  void TearDown() override {
+    iree_hal_allocator_release(allocator_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  void CreateFromSpec(const char* spec) {
+    IREE_ASSERT_OK(iree_hal_caching_allocator_create_from_spec(
+        iree_make_cstring_view(spec), device_allocator_,
+        iree_allocator_system(), &allocator_));
+  }
+
+  iree_hal_buffer_t* Allocate(iree_device_size_t allocation_size) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(allocator_, params,
+                                                     allocation_size, &buffer));
+    return buffer;
+  }
+
+  iree_hal_allocator_statistics_t QueryStatistics() {
+    iree_hal_allocator_statistics_t statistics;
+    iree_hal_allocator_query_statistics(allocator_, &statistics);
+    return statistics;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_allocator_t* allocator_ = NULL;
+};
+
+// Tests that dedicated allocations of slightly different sizes that round to
+// the same size class reuse each other.
+TEST_F(CachingAllocatorTest, SizeClassReuse) {
+  CreateFromSpec("*=*;*;*;0");
+
+  iree_hal_buffer_t* buffer0 = Allocate(1000000);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer0), 1000000);
+  iree_hal_buffer_t* allocated_buffer0 =
+      iree_hal_buffer_allocated_buffer(buffer0);
+  iree_hal_buffer_release(buffer0);
+
+  iree_hal_buffer_t* buffer1 = Allocate(1000100);
+  EXPECT_EQ(iree_hal_buffer_byte_length(buffer1), 1000100);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffer1), allocated_buffer0);
+
+  // Different size class; must not reuse.
+  iree_hal_buffer_t* buffer2 = Allocate(2000000);
+  EXPECT_NE(iree_hal_buffer_allocated_buffer(buffer2), allocated_buffer0);
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_hit_count, 1);
+  EXPECT_EQ(statistics.pool_miss_count, 2);
+  EXPECT_EQ(statistics.pool_bytes_free, 0);
+  EXPECT_GT(statistics.pool_bytes_wasted, 0);
+#endif  // IREE_STATISTICS_ENABLE
+
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer2);
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+
+#if IREE_STATISTICS_ENABLE
+  statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_bytes_reserved, 0);
+  EXPECT_EQ(statistics.pool_bytes_wasted, 0);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+// Tests that small allocations are suballocated from a shared slab and don't
+// overlap.
+TEST_F(CachingAllocatorTest, SlabSuballocation) {
+  CreateFromSpec("*=*;*;*;64kib");
+
+  std::vector<iree_hal_buffer_t*> buffers;
+  for (int i = 0; i < 8; ++i) {
+    iree_hal_buffer_t* buffer = Allocate(1000 + i);
+    uint8_t pattern = (uint8_t)i;
+    IREE_ASSERT_OK(iree_hal_buffer_map_fill(buffer, 0, IREE_WHOLE_BUFFER,
+                                            &pattern, sizeof(pattern)));
+    buffers.push_back(buffer);
+  }
+  for (size_t i = 1; i < buffers.size(); ++i) {
+    EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffers[i]),
+              iree_hal_buffer_allocated_buffer(buffers[0]));
+    EXPECT_NE(iree_hal_buffer_byte_offset(buffers[i]),
+              iree_hal_buffer_byte_offset(buffers[0]));
+  }
+  for (size_t i = 0; i < buffers.size(); ++i) {
+    uint8_t value = 0;
+    IREE_ASSERT_OK(iree_hal_buffer_map_read(
+        buffers[i], iree_hal_buffer_byte_length(buffers[i]) - 1, &value,
+        sizeof(value)));
+    EXPECT_EQ(value, (uint8_t)i);
+  }
+
+#if IREE_STATISTICS_ENABLE
+  iree_hal_allocator_statistics_t statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_hit_count, 7);
+  EXPECT_EQ(statistics.pool_miss_count, 1);
+  EXPECT_EQ(statistics.pool_bytes_reserved, 64 * 1024);
+#endif  // IREE_STATISTICS_ENABLE
+
+  // Freed slots are reused.
+  iree_hal_buffer_t* allocated_buffer =
+      iree_hal_buffer_allocated_buffer(buffers[3]);
+  iree_device_size_t byte_offset = iree_hal_buffer_byte_offset(buffers[3]);
+  iree_hal_buffer_release(buffers[3]);
+  buffers[3] = Allocate(1010);
+  EXPECT_EQ(iree_hal_buffer_allocated_buffer(buffers[3]), allocated_buffer);
+  EXPECT_EQ(iree_hal_buffer_byte_offset(buffers[3]), byte_offset);
+
+  for (auto* buffer : buffers) iree_hal_buffer_release(buffer);
+  IREE_ASSERT_OK(iree_hal_allocator_trim(allocator_));
+
+#if IREE_STATISTICS_ENABLE
+  statistics = QueryStatistics();
+  EXPECT_EQ(statistics.pool_bytes_reserved, 0);
+  EXPECT_EQ(statistics.pool_bytes_free, 0);
+  EXPECT_EQ(statistics.pool_bytes_wasted, 0);
+#endif  // IREE_STATISTICS_ENABLE
+}
+
+// Tests that slabs are not used when they would exceed the pool capacity.
+TEST_F(CachingAllocatorTest, SlabExceedsCapacity) {
+  CreateFromSpec("*=*;16kib;*;64kib");
+  iree_hal_buffer_t* buffer0 = Allocate(1000);
+  iree_hal_buffer_t* buffer1 = Allocate(1000);
+  EXPECT_NE(iree_hal_buffer_allocated_buffer(buffer0),
+            iree_hal_buffer_allocated_buffer(buffer1));
+  iree_hal_buffer_release(buffer0);
+  iree_hal_buffer_release(buffer1);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
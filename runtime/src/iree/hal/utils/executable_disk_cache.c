@@ -0,0 +1,397 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/executable_disk_cache.h"
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/file_io.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_disk_cache_key_t
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT void iree_hal_executable_disk_cache_key_initialize(
+    iree_hal_executable_disk_cache_key_t* out_key) {
+  IREE_ASSERT_ARGUMENT(out_key);
+  // FNV-1a offset basis and the fractional part of the golden ratio.
+  out_key->hash[0] = 0xCBF29CE484222325ull;
+  out_key->hash[1] = 0x9E3779B97F4A7C15ull;
+  out_key->length = 0;
+}
+
+static void iree_hal_executable_disk_cache_key_mix(
+    iree_hal_executable_disk_cache_key_t* key, const uint8_t* data,
+    iree_host_size_t data_length) {
+  // Two independent lanes: FNV-1a and a multiply-rotate hash. Neither is
+  // strong on its own but together with the total length they make accidental
+  // collisions between executables vanishingly unlikely.
+  uint64_t hash0 = key->hash[0];
+  uint64_t hash1 = key->hash[1];
+  for (iree_host_size_t i = 0; i < data_length; ++i) {
+    hash0 ^= data[i];
+    hash0 *= 0x100000001B3ull;
+    hash1 = (hash1 ^ data[i]) * 0xFF51AFD7ED558CCDull;
+    hash1 = (hash1 << 31) | (hash1 >> 33);
+  }
+  key->hash[0] = hash0;
+  key->hash[1] = hash1;
+  key->length += data_length;
+}
+
+IREE_API_EXPORT void iree_hal_executable_disk_cache_key_append(
+    iree_hal_executable_disk_cache_key_t* key, iree_const_byte_span_t data) {
+  IREE_ASSERT_ARGUMENT(key);
+  // Prefix each part with its length so that part boundaries are part of the
+  // key.
+  uint8_t length_bytes[8];
+  for (int i = 0; i < 8; ++i) {
+    length_bytes[i] = (uint8_t)((uint64_t)data.data_length >> (i * 8));
+  }
+  iree_hal_executable_disk_cache_key_mix(key, length_bytes,
+                                         sizeof(length_bytes));
+  iree_hal_executable_disk_cache_key_mix(key, data.data, data.data_length);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_disk_cache_t
+//===----------------------------------------------------------------------===//
+
+// 'IRXC' in little-endian.
+#define IREE_HAL_EXECUTABLE_DISK_CACHE_MAGIC 0x43585249u
+// Bumped whenever the entry layout changes.
+#define IREE_HAL_EXECUTABLE_DISK_CACHE_VERSION 0u
+
+// Header of data entries used to validate them on lookup.
+typedef struct iree_hal_executable_disk_cache_header_t {
+  uint32_t magic;
+  uint32_t version;
+  uint64_t key_hash[2];
+  uint64_t key_length;
+  uint64_t data_length;
+} iree_hal_executable_disk_cache_header_t;
+
+struct iree_hal_executable_disk_cache_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  // Incremented to generate unique temporary file names.
+  iree_atomic_int32_t temp_counter;
+  // NUL-terminated directory path stored inline.
+  iree_host_size_t directory_length;
+  char directory[];
+};
+
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_create(
+    iree_string_view_t directory, iree_allocator_t host_allocator,
+    iree_hal_executable_disk_cache_t** out_disk_cache) {
+  IREE_ASSERT_ARGUMENT(out_disk_cache);
+  *out_disk_cache = NULL;
+#if IREE_FILE_IO_ENABLE
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, directory.data, directory.size);
+
+  // Strip trailing separators so we can append our own.
+  while (directory.size > 1 && (directory.data[directory.size - 1] == '/' ||
+                                directory.data[directory.size - 1] == '\\')) {
+    --directory.size;
+  }
+  // Leave room for the entry file names.
+  if (iree_string_view_is_empty(directory) ||
+      directory.size + 128 > IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid executable cache directory `%.*s`",
+                            (int)directory.size, directory.data);
+  }
+
+  iree_hal_executable_disk_cache_t* disk_cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator,
+                                sizeof(*disk_cache) + directory.size + 1,
+                                (void**)&disk_cache));
+  iree_atomic_ref_count_init(&disk_cache->ref_count);
+  disk_cache->host_allocator = host_allocator;
+  iree_atomic_store_int32(&disk_cache->temp_counter, 0,
+                          iree_memory_order_relaxed);
+  disk_cache->directory_length = directory.size;
+  memcpy(disk_cache->directory, directory.data, directory.size);
+  disk_cache->directory[directory.size] = 0;
+
+  iree_status_t status = iree_file_exists(disk_cache->directory);
+  if (iree_status_is_ok(status)) {
+    *out_disk_cache = disk_cache;
+  } else {
+    status = iree_status_annotate(
+        status, IREE_SV("executable cache directories must exist"));
+    iree_allocator_free(host_allocator, disk_cache);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file I/O is disabled; executable disk caches are "
+                          "not available");
+#endif  // IREE_FILE_IO_ENABLE
+}
+
+static void iree_hal_executable_disk_cache_destroy(
+    iree_hal_executable_disk_cache_t* disk_cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_free(disk_cache->host_allocator, disk_cache);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_hal_executable_disk_cache_retain(
+    iree_hal_executable_disk_cache_t* disk_cache) {
+  if (IREE_LIKELY(disk_cache)) {
+    iree_atomic_ref_count_inc(&disk_cache->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_hal_executable_disk_cache_release(
+    iree_hal_executable_disk_cache_t* disk_cache) {
+  if (IREE_LIKELY(disk_cache) &&
+      iree_atomic_ref_count_dec(&disk_cache->ref_count) == 1) {
+    iree_hal_executable_disk_cache_destroy(disk_cache);
+  }
+}
+
+// Formats the path of the entry for |key| with |extension| into |out_path|.
+static iree_status_t iree_hal_executable_disk_cache_format_path(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_string_view_t extension, iree_host_size_t path_capacity,
+    char* out_path) {
+  int length = snprintf(out_path, path_capacity,
+                        "%s/%016" PRIx64 "%016" PRIx64 "%.*s",
+                        disk_cache->directory, key->hash[0], key->hash[1],
+                        (int)extension.size, extension.data);
+  if (length < 0 || (iree_host_size_t)length >= path_capacity) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "executable cache entry path exceeds %" PRIhsz
+                            " characters",
+                            path_capacity);
+  }
+  return iree_ok_status();
+}
+
+#if IREE_FILE_IO_ENABLE
+
+// Moves the file at |temp_path| to |path| replacing any existing file.
+// The temporary file is removed if the move fails.
+static iree_status_t iree_hal_executable_disk_cache_commit(
+    const char* temp_path, const char* path) {
+  if (rename(temp_path, path) == 0) return iree_ok_status();
+  // Windows does not replace existing files on rename; another writer may
+  // have stored the same entry concurrently in which case either is fine.
+  remove(path);
+  if (rename(temp_path, path) == 0) return iree_ok_status();
+  int error_number = errno;
+  remove(temp_path);
+  return iree_make_status(iree_status_code_from_errno(error_number),
+                          "failed to move executable cache entry into place "
+                          "at '%s'",
+                          path);
+}
+
+// Formats a unique temporary path next to |path| into |out_temp_path|.
+static iree_status_t iree_hal_executable_disk_cache_format_temp_path(
+    iree_hal_executable_disk_cache_t* disk_cache, const char* path,
+    iree_host_size_t temp_path_capacity, char* out_temp_path) {
+  // Other processes may be writing the same entry; the timestamp and counter
+  // keep our temporary files distinct from theirs.
+  uint32_t counter = (uint32_t)iree_atomic_fetch_add_int32(
+      &disk_cache->temp_counter, 1, iree_memory_order_relaxed);
+  uint64_t now = (uint64_t)iree_time_now();
+  int length = snprintf(out_temp_path, temp_path_capacity,
+                        "%s.tmp%08x%016" PRIx64, path, counter, now);
+  if (length < 0 || (iree_host_size_t)length >= temp_path_capacity) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "executable cache temporary path too long");
+  }
+  return iree_ok_status();
+}
+
+#endif  // IREE_FILE_IO_ENABLE
+
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_lookup(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key, iree_allocator_t allocator,
+    iree_byte_span_t* out_data) {
+  IREE_ASSERT_ARGUMENT(disk_cache);
+  IREE_ASSERT_ARGUMENT(key);
+  IREE_ASSERT_ARGUMENT(out_data);
+  *out_data = iree_make_byte_span(NULL, 0);
+#if IREE_FILE_IO_ENABLE
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  char path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_disk_cache_format_path(
+              disk_cache, key, IREE_SV(".bin"), sizeof(path), path));
+
+  // Any failure to open or validate the entry is a miss.
+  FILE* file = fopen(path, "rb");
+  if (!file) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+  iree_hal_executable_disk_cache_header_t header;
+  uint64_t file_length = 0;
+  bool valid = fread(&header, sizeof(header), 1, file) == 1 &&
+               iree_status_is_ok(iree_file_query_length(file, &file_length)) &&
+               header.magic == IREE_HAL_EXECUTABLE_DISK_CACHE_MAGIC &&
+               header.version == IREE_HAL_EXECUTABLE_DISK_CACHE_VERSION &&
+               header.key_hash[0] == key->hash[0] &&
+               header.key_hash[1] == key->hash[1] &&
+               header.key_length == key->length &&
+               header.data_length == file_length - sizeof(header) &&
+               header.data_length <= IREE_HOST_SIZE_MAX;
+
+  iree_status_t status = iree_ok_status();
+  void* data = NULL;
+  if (valid) {
+    status = iree_allocator_malloc(
+        allocator, (iree_host_size_t)header.data_length, &data);
+    if (iree_status_is_ok(status) &&
+        fread(data, 1, (iree_host_size_t)header.data_length, file) !=
+            header.data_length) {
+      iree_allocator_free(allocator, data);
+      data = NULL;
+      valid = false;
+    }
+  }
+  fclose(file);
+
+  if (iree_status_is_ok(status) && valid) {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "hit");
+    *out_data =
+        iree_make_byte_span(data, (iree_host_size_t)header.data_length);
+  } else {
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "miss");
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_ok_status();
+#endif  // IREE_FILE_IO_ENABLE
+}
+
+#if IREE_FILE_IO_ENABLE
+
+typedef struct iree_hal_executable_disk_cache_write_state_t {
+  const iree_hal_executable_disk_cache_key_t* key;
+  iree_const_byte_span_t data;
+} iree_hal_executable_disk_cache_write_state_t;
+
+static iree_status_t iree_hal_executable_disk_cache_write_data_entry(
+    void* user_data, const char* path) {
+  const iree_hal_executable_disk_cache_write_state_t* state =
+      (const iree_hal_executable_disk_cache_write_state_t*)user_data;
+  iree_hal_executable_disk_cache_header_t header = {
+      .magic = IREE_HAL_EXECUTABLE_DISK_CACHE_MAGIC,
+      .version = IREE_HAL_EXECUTABLE_DISK_CACHE_VERSION,
+      .key_hash = {state->key->hash[0], state->key->hash[1]},
+      .key_length = state->key->length,
+      .data_length = state->data.data_length,
+  };
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open executable cache entry '%s' for "
+                            "writing",
+                            path);
+  }
+  bool written = fwrite(&header, sizeof(header), 1, file) == 1 &&
+                 (state->data.data_length == 0 ||
+                  fwrite(state->data.data, state->data.data_length, 1,
+                         file) == 1);
+  bool closed = fclose(file) == 0;
+  if (!written || !closed) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "failed to write executable cache entry '%s'",
+                            path);
+  }
+  return iree_ok_status();
+}
+
+#endif  // IREE_FILE_IO_ENABLE
+
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_store(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_const_byte_span_t data) {
+#if IREE_FILE_IO_ENABLE
+  iree_hal_executable_disk_cache_write_state_t state = {
+      .key = key,
+      .data = data,
+  };
+  return iree_hal_executable_disk_cache_store_file(
+      disk_cache, key, IREE_SV(".bin"),
+      iree_hal_executable_disk_cache_write_data_entry, &state);
+#else
+  return iree_ok_status();
+#endif  // IREE_FILE_IO_ENABLE
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_lookup_file(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_string_view_t extension, iree_host_size_t path_capacity,
+    char* out_path, bool* out_found) {
+  IREE_ASSERT_ARGUMENT(disk_cache);
+  IREE_ASSERT_ARGUMENT(key);
+  IREE_ASSERT_ARGUMENT(out_path);
+  IREE_ASSERT_ARGUMENT(out_found);
+  *out_found = false;
+  IREE_RETURN_IF_ERROR(iree_hal_executable_disk_cache_format_path(
+      disk_cache, key, extension, path_capacity, out_path));
+#if IREE_FILE_IO_ENABLE
+  iree_status_t status = iree_file_exists(out_path);
+  *out_found = iree_status_is_ok(status);
+  iree_status_ignore(status);
+#endif  // IREE_FILE_IO_ENABLE
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_store_file(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_string_view_t extension,
+    iree_hal_executable_disk_cache_write_fn_t write_fn, void* user_data) {
+  IREE_ASSERT_ARGUMENT(disk_cache);
+  IREE_ASSERT_ARGUMENT(key);
+  IREE_ASSERT_ARGUMENT(write_fn);
+#if IREE_FILE_IO_ENABLE
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  char path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  char temp_path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_disk_cache_format_path(disk_cache, key, extension,
+                                                     sizeof(path), path));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_executable_disk_cache_format_temp_path(
+              disk_cache, path, sizeof(temp_path), temp_path));
+
+  iree_status_t status = write_fn(user_data, temp_path);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_executable_disk_cache_commit(temp_path, path);
+  } else {
+    remove(temp_path);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_ok_status();
+#endif  // IREE_FILE_IO_ENABLE
+}
@@ -0,0 +1,135 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_EXECUTABLE_DISK_CACHE_H_
+#define IREE_HAL_UTILS_EXECUTABLE_DISK_CACHE_H_
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_disk_cache_key_t
+//===----------------------------------------------------------------------===//
+
+// Content-derived key identifying a disk cache entry.
+// Keys are built by appending everything that influences the translated
+// result: the executable contents, specialization constants, and the
+// device/driver identity (architecture, driver version, etc).
+//
+// NOTE: keys are not cryptographic hashes. They guard against accidental
+// collisions only and cache directories must not be writable by untrusted
+// users as entries are loaded as device code.
+typedef struct iree_hal_executable_disk_cache_key_t {
+  uint64_t hash[2];
+  uint64_t length;
+} iree_hal_executable_disk_cache_key_t;
+
+// Initializes |out_key| to an empty key.
+IREE_API_EXPORT void iree_hal_executable_disk_cache_key_initialize(
+    iree_hal_executable_disk_cache_key_t* out_key);
+
+// Appends |data| to |key|. Each appended part is delimited such that the
+// resulting key depends on how the data was split into parts.
+IREE_API_EXPORT void iree_hal_executable_disk_cache_key_append(
+    iree_hal_executable_disk_cache_key_t* key, iree_const_byte_span_t data);
+
+// Appends the characters of |value| to |key|.
+static inline void iree_hal_executable_disk_cache_key_append_string(
+    iree_hal_executable_disk_cache_key_t* key, iree_string_view_t value) {
+  iree_hal_executable_disk_cache_key_append(
+      key, iree_make_const_byte_span(value.data, value.size));
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_executable_disk_cache_t
+//===----------------------------------------------------------------------===//
+
+// A persistent content-addressed store for translated executables.
+// Drivers that translate executables when they are prepared (JIT compiling
+// PTX, compiling pipelines, etc) store the device-specific results keyed by
+// the executable contents and device identity such that later launches of the
+// process can skip translation entirely.
+//
+// Entries are individual files in a user-provided directory that may be shared
+// by multiple processes. Entries are written to temporary files and renamed
+// into place so readers never observe partially written entries. The cache is
+// best-effort: entries that are missing, truncated, or fail validation are
+// treated as misses and are overwritten when the caller stores new results.
+//
+// The cache performs no eviction; users are expected to manage the directory
+// (such as clearing it when upgrading drivers or compilers).
+//
+// Thread-safe: entries may be looked up and stored concurrently.
+typedef struct iree_hal_executable_disk_cache_t
+    iree_hal_executable_disk_cache_t;
+
+// Creates a disk cache storing entries in the existing |directory|.
+// Returns IREE_STATUS_NOT_FOUND if the directory does not exist and
+// IREE_STATUS_UNAVAILABLE if file I/O is disabled in the build.
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_create(
+    iree_string_view_t directory, iree_allocator_t host_allocator,
+    iree_hal_executable_disk_cache_t** out_disk_cache);
+
+// Retains the given |disk_cache| for the caller.
+IREE_API_EXPORT void iree_hal_executable_disk_cache_retain(
+    iree_hal_executable_disk_cache_t* disk_cache);
+
+// Releases the given |disk_cache| from the caller.
+IREE_API_EXPORT void iree_hal_executable_disk_cache_release(
+    iree_hal_executable_disk_cache_t* disk_cache);
+
+// Looks up the data stored for |key|.
+// On a hit returns the data in |out_data| allocated from |allocator| and the
+// caller must free it with iree_allocator_free. On a miss returns OK with an
+// empty |out_data|.
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_lookup(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key, iree_allocator_t allocator,
+    iree_byte_span_t* out_data);
+
+// Stores |data| for |key|, replacing any existing entry.
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_store(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_const_byte_span_t data);
+
+// Maximum length of any path produced by the cache including the NUL.
+#define IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH 2048
+
+// Writes an entry to the file at |path|.
+typedef iree_status_t(IREE_API_PTR* iree_hal_executable_disk_cache_write_fn_t)(
+    void* user_data, const char* path);
+
+// Returns the path of the file entry for |key| with the given |extension| in
+// |out_path| (NUL-terminated) and whether the file exists in |out_found|.
+// File entries are for APIs that load and serialize their own file formats
+// directly (such as MTLBinaryArchive) and are not validated by the cache.
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_lookup_file(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_string_view_t extension, iree_host_size_t path_capacity,
+    char* out_path, bool* out_found);
+
+// Stores the file entry for |key| with the given |extension| by calling
+// |write_fn| to produce the file at a temporary path that is then moved into
+// place, replacing any existing entry.
+IREE_API_EXPORT iree_status_t iree_hal_executable_disk_cache_store_file(
+    iree_hal_executable_disk_cache_t* disk_cache,
+    const iree_hal_executable_disk_cache_key_t* key,
+    iree_string_view_t extension,
+    iree_hal_executable_disk_cache_write_fn_t write_fn, void* user_data);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_EXECUTABLE_DISK_CACHE_H_
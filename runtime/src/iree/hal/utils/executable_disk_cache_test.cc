@@ -0,0 +1,225 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/executable_disk_cache.h"
+
+#include "iree/base/config.h"
+
+#if IREE_FILE_IO_ENABLE
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+const char* GetTempDirectory() {
+  const char* test_tmpdir = getenv("TEST_TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TMPDIR");
+  if (!test_tmpdir) test_tmpdir = getenv("TEMP");
+  if (!test_tmpdir) test_tmpdir = "/tmp";
+  return test_tmpdir;
+}
+
+class ExecutableDiskCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(iree_hal_executable_disk_cache_create(
+        iree_make_cstring_view(GetTempDirectory()), iree_allocator_system(),
+        &disk_cache_));
+    // Tests may run concurrently in multiple processes sharing the directory.
+    std::random_device device;
+    unique_contents_ = "executable " + std::to_string(device()) + "_" +
+                       std::to_string(device());
+  }
+
+  void TearDown() override {
+    iree_hal_executable_disk_cache_release(disk_cache_);
+  }
+
+  iree_hal_executable_disk_cache_key_t MakeKey(const char* suffix) {
+    iree_hal_executable_disk_cache_key_t key;
+    iree_hal_executable_disk_cache_key_initialize(&key);
+    iree_hal_executable_disk_cache_key_append_string(
+        &key, iree_make_string_view(unique_contents_.data(),
+                                    unique_contents_.size()));
+    iree_hal_executable_disk_cache_key_append_string(
+        &key, iree_make_cstring_view(suffix));
+    return key;
+  }
+
+  void RemoveEntry(const iree_hal_executable_disk_cache_key_t& key,
+                   const char* extension) {
+    char path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+    bool found = false;
+    IREE_ASSERT_OK(iree_hal_executable_disk_cache_lookup_file(
+        disk_cache_, &key, iree_make_cstring_view(extension), sizeof(path),
+        path, &found));
+    if (found) remove(path);
+  }
+
+  std::string Lookup(const iree_hal_executable_disk_cache_key_t& key,
+                     bool* out_found) {
+    iree_byte_span_t data = iree_make_byte_span(NULL, 0);
+    IREE_CHECK_OK(iree_hal_executable_disk_cache_lookup(
+        disk_cache_, &key, iree_allocator_system(), &data));
+    *out_found = data.data != NULL;
+    std::string result((const char*)data.data, data.data_length);
+    iree_allocator_free(iree_allocator_system(), data.data);
+    return result;
+  }
+
+  iree_hal_executable_disk_cache_t* disk_cache_ = NULL;
+  std::string unique_contents_;
+};
+
+TEST(ExecutableDiskCacheKeyTest, PartBoundaries) {
+  iree_hal_executable_disk_cache_key_t key_a;
+  iree_hal_executable_disk_cache_key_initialize(&key_a);
+  iree_hal_executable_disk_cache_key_append_string(&key_a, IREE_SV("ab"));
+  iree_hal_executable_disk_cache_key_append_string(&key_a, IREE_SV("c"));
+  iree_hal_executable_disk_cache_key_t key_b;
+  iree_hal_executable_disk_cache_key_initialize(&key_b);
+  iree_hal_executable_disk_cache_key_append_string(&key_b, IREE_SV("a"));
+  iree_hal_executable_disk_cache_key_append_string(&key_b, IREE_SV("bc"));
+  EXPECT_EQ(key_a.length, key_b.length);
+  EXPECT_FALSE(key_a.hash[0] == key_b.hash[0] &&
+               key_a.hash[1] == key_b.hash[1]);
+
+  iree_hal_executable_disk_cache_key_t key_c;
+  iree_hal_executable_disk_cache_key_initialize(&key_c);
+  iree_hal_executable_disk_cache_key_append_string(&key_c, IREE_SV("ab"));
+  iree_hal_executable_disk_cache_key_append_string(&key_c, IREE_SV("c"));
+  EXPECT_EQ(key_a.hash[0], key_c.hash[0]);
+  EXPECT_EQ(key_a.hash[1], key_c.hash[1]);
+  EXPECT_EQ(key_a.length, key_c.length);
+}
+
+TEST(ExecutableDiskCacheCreateTest, MissingDirectory) {
+  std::string directory =
+      std::string(GetTempDirectory()) + "/iree_executable_cache_missing_dir";
+  iree_hal_executable_disk_cache_t* disk_cache = NULL;
+  EXPECT_THAT(Status(iree_hal_executable_disk_cache_create(
+                  iree_make_string_view(directory.data(), directory.size()),
+                  iree_allocator_system(), &disk_cache)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(disk_cache, nullptr);
+}
+
+TEST_F(ExecutableDiskCacheTest, Miss) {
+  auto key = MakeKey("miss");
+  bool found = true;
+  EXPECT_EQ(Lookup(key, &found), "");
+  EXPECT_FALSE(found);
+}
+
+TEST_F(ExecutableDiskCacheTest, StoreLookup) {
+  auto key = MakeKey("store");
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_store(
+      disk_cache_, &key, iree_make_const_byte_span("binary", 6)));
+  bool found = false;
+  EXPECT_EQ(Lookup(key, &found), "binary");
+  EXPECT_TRUE(found);
+
+  // Storing again replaces the existing entry.
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_store(
+      disk_cache_, &key, iree_make_const_byte_span("updated binary", 14)));
+  EXPECT_EQ(Lookup(key, &found), "updated binary");
+  EXPECT_TRUE(found);
+
+  // Other keys are unaffected.
+  auto other_key = MakeKey("other");
+  EXPECT_EQ(Lookup(other_key, &found), "");
+  EXPECT_FALSE(found);
+
+  RemoveEntry(key, ".bin");
+}
+
+TEST_F(ExecutableDiskCacheTest, TruncatedEntryIsMiss) {
+  auto key = MakeKey("truncated");
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_store(
+      disk_cache_, &key, iree_make_const_byte_span("binary", 6)));
+
+  // Truncate the entry as if the writer had crashed without our rename.
+  char path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  bool found = false;
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_lookup_file(
+      disk_cache_, &key, IREE_SV(".bin"), sizeof(path), path, &found));
+  ASSERT_TRUE(found);
+  FILE* file = fopen(path, "wb");
+  ASSERT_NE(file, nullptr);
+  fwrite("IRXC", 4, 1, file);
+  fclose(file);
+
+  EXPECT_EQ(Lookup(key, &found), "");
+  EXPECT_FALSE(found);
+  RemoveEntry(key, ".bin");
+}
+
+TEST_F(ExecutableDiskCacheTest, FileEntries) {
+  auto key = MakeKey("file");
+  char path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  bool found = true;
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_lookup_file(
+      disk_cache_, &key, IREE_SV(".archive"), sizeof(path), path, &found));
+  EXPECT_FALSE(found);
+
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_store_file(
+      disk_cache_, &key, IREE_SV(".archive"),
+      [](void* user_data, const char* temp_path) -> iree_status_t {
+        FILE* file = fopen(temp_path, "wb");
+        if (!file) return iree_make_status(IREE_STATUS_INTERNAL);
+        fwrite("archive", 7, 1, file);
+        fclose(file);
+        return iree_ok_status();
+      },
+      NULL));
+
+  char found_path[IREE_HAL_EXECUTABLE_DISK_CACHE_MAX_PATH_LENGTH];
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_lookup_file(
+      disk_cache_, &key, IREE_SV(".archive"), sizeof(found_path), found_path,
+      &found));
+  EXPECT_TRUE(found);
+  EXPECT_STREQ(path, found_path);
+  FILE* file = fopen(found_path, "rb");
+  ASSERT_NE(file, nullptr);
+  char contents[16] = {0};
+  EXPECT_EQ(fread(contents, 1, sizeof(contents), file), 7u);
+  fclose(file);
+  EXPECT_STREQ(contents, "archive");
+
+  // Failed writes leave no entry behind.
+  auto failed_key = MakeKey("failed");
+  EXPECT_THAT(Status(iree_hal_executable_disk_cache_store_file(
+                  disk_cache_, &failed_key, IREE_SV(".archive"),
+                  [](void* user_data, const char* temp_path) {
+                    return iree_make_status(IREE_STATUS_INTERNAL);
+                  },
+                  NULL)),
+              StatusIs(StatusCode::kInternal));
+  IREE_ASSERT_OK(iree_hal_executable_disk_cache_lookup_file(
+      disk_cache_, &failed_key, IREE_SV(".archive"), sizeof(path), path,
+      &found));
+  EXPECT_FALSE(found);
+
+  RemoveEntry(key, ".archive");
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
+
+#endif  // IREE_FILE_IO_ENABLE
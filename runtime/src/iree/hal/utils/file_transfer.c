@@ -7,6 +7,9 @@
 #include "iree/hal/utils/file_transfer.h"
 
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+#include "iree/hal/utils/io_uring_file.h"
 #include "iree/hal/utils/memory_file.h"
 
 //===----------------------------------------------------------------------===//
@@ -26,7 +29,7 @@
 #if !defined(IREE_HAL_TRANSFER_CHUNK_SIZE)
 // Bytes per worker to stage chunks of data. Larger chunks will result in less
 // overhead as fewer copy operations are required.
-#define IREE_HAL_TRANSFER_CHUNK_SIZE (64 * 1024 * 1024)
+#define IREE_HAL_TRANSFER_CHUNK_SIZE (32 * 1024 * 1024)
 #endif  // !IREE_HAL_TRANSFER_CHUNK_SIZE
 
 #if !defined(IREE_HAL_TRANSFER_CHUNKS_PER_WORKER)
@@ -36,6 +39,299 @@
 #define IREE_HAL_TRANSFER_CHUNKS_PER_WORKER 8
 #endif  // IREE_HAL_TRANSFER_CHUNKS_PER_WORKER
 
+#if !defined(IREE_HAL_TRANSFER_PIPELINE_DEPTH)
+// Number of staging chunks each worker keeps in flight by default. With 2 the
+// host stages chunk N+1 while the device copies chunk N (double buffering) and
+// with 3 there is additional slack for jittery file IO.
+#define IREE_HAL_TRANSFER_PIPELINE_DEPTH 2
+#endif  // !IREE_HAL_TRANSFER_PIPELINE_DEPTH
+
+#if !defined(IREE_HAL_TRANSFER_THREAD_LIMIT)
+// Maximum number of host threads used by default to split the file IO of each
+// chunk. Explicitly requested thread counts are capped at
+// IREE_HAL_TRANSFER_THREAD_MAX_COUNT instead.
+#define IREE_HAL_TRANSFER_THREAD_LIMIT 4
+#endif  // !IREE_HAL_TRANSFER_THREAD_LIMIT
+
+#if !defined(IREE_HAL_TRANSFER_THREAD_SLICE_SIZE)
+// Minimum bytes of each chunk that a single thread will handle when selecting
+// the default thread count. Transfers with chunks smaller than two slices run
+// entirely on the worker without spinning up any threads.
+#define IREE_HAL_TRANSFER_THREAD_SLICE_SIZE (8 * 1024 * 1024)
+#endif  // !IREE_HAL_TRANSFER_THREAD_SLICE_SIZE
+
+//===----------------------------------------------------------------------===//
+// iree_hal_transfer_io_pool_t
+//===----------------------------------------------------------------------===//
+
+// Maximum number of threads (including the worker issuing the IO) that can be
+// used to split the file IO of a single chunk.
+#define IREE_HAL_TRANSFER_THREAD_MAX_COUNT 16
+
+// Describes the direction of a transfer operation.
+typedef enum {
+  // Transferring from the file to the buffer (read).
+  IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER = 0,
+  // Transferring from the buffer to the file (write).
+  IREE_HAL_TRANSFER_WRITE_BUFFER_TO_FILE,
+} iree_hal_transfer_direction_t;
+
+// Synchronously transfers |length| bytes between |file| and |buffer|.
+static iree_status_t iree_hal_transfer_file_io(
+    iree_hal_transfer_direction_t direction, iree_hal_file_t* file,
+    uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  if (direction == IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER) {
+    return iree_hal_file_read(file, file_offset, buffer, buffer_offset, length);
+  } else {
+    return iree_hal_file_write(file, file_offset, buffer, buffer_offset,
+                               length);
+  }
+}
+
+// A fork-join pool of host threads used to split the synchronous file IO of
+// each chunk into slices that are processed concurrently. The worker issuing
+// the IO participates by processing slices itself and then blocks until all
+// slices have completed so the surrounding state machine remains unchanged.
+//
+// Files are accessed with positional IO (or memcpy for memory files) and
+// staging buffers are mapped per-slice so concurrent slices are independent.
+typedef struct iree_hal_transfer_io_pool_t {
+  iree_allocator_t host_allocator;
+
+  // Guards all job state below.
+  iree_slim_mutex_t mutex;
+  // Posted when a new job is available or the threads have been asked to exit.
+  iree_notification_t job_notification;
+  // Posted when the last slice of a job has completed or a thread has exited.
+  iree_notification_t done_notification;
+
+  // Current job parameters.
+  iree_hal_transfer_direction_t direction;
+  iree_hal_file_t* file;
+  uint64_t file_offset;
+  iree_hal_buffer_t* buffer;
+  iree_device_size_t buffer_offset;
+  iree_device_size_t length;
+  iree_device_size_t slice_length;
+  iree_host_size_t slice_count;
+  // Next slice to be claimed by a thread.
+  iree_host_size_t next_slice;
+  // Total number of slices that have finished (successfully or not).
+  iree_host_size_t completed_slice_count;
+  // Joined status of all slices in the current job.
+  iree_status_t status;
+  // Set when the pool is being destroyed and the threads should exit.
+  bool exit_requested;
+  // Number of helper threads that have returned from their main loop.
+  iree_host_size_t exited_thread_count;
+
+  // Helper threads; the worker issuing the job is the final participant.
+  iree_host_size_t thread_count;
+  iree_thread_t* threads[IREE_HAL_TRANSFER_THREAD_MAX_COUNT - 1];
+} iree_hal_transfer_io_pool_t;
+
+// Claims and processes one slice of the current job, if any remain.
+// Returns false if there were no slices left to claim.
+static bool iree_hal_transfer_io_pool_run_slice(
+    iree_hal_transfer_io_pool_t* pool) {
+  iree_slim_mutex_lock(&pool->mutex);
+  if (pool->next_slice >= pool->slice_count) {
+    iree_slim_mutex_unlock(&pool->mutex);
+    return false;
+  }
+  iree_host_size_t slice_index = pool->next_slice++;
+  iree_device_size_t slice_offset = slice_index * pool->slice_length;
+  iree_device_size_t slice_length =
+      iree_min(pool->slice_length, pool->length - slice_offset);
+  iree_hal_transfer_direction_t direction = pool->direction;
+  iree_hal_file_t* file = pool->file;
+  uint64_t file_offset = pool->file_offset + slice_offset;
+  iree_hal_buffer_t* buffer = pool->buffer;
+  iree_device_size_t buffer_offset = pool->buffer_offset + slice_offset;
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slice_offset);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slice_length);
+  iree_status_t status =
+      iree_hal_transfer_file_io(direction, file, file_offset, buffer,
+                                buffer_offset, slice_length);
+  IREE_TRACE_ZONE_END(z0);
+
+  iree_slim_mutex_lock(&pool->mutex);
+  pool->status = iree_status_join(pool->status, status);
+  const bool job_done = ++pool->completed_slice_count == pool->slice_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  if (job_done) {
+    iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+  }
+  return true;
+}
+
+static bool iree_hal_transfer_io_pool_has_work(void* arg) {
+  iree_hal_transfer_io_pool_t* pool = (iree_hal_transfer_io_pool_t*)arg;
+  iree_slim_mutex_lock(&pool->mutex);
+  const bool has_work =
+      pool->exit_requested || pool->next_slice < pool->slice_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  return has_work;
+}
+
+static bool iree_hal_transfer_io_pool_is_job_done(void* arg) {
+  iree_hal_transfer_io_pool_t* pool = (iree_hal_transfer_io_pool_t*)arg;
+  iree_slim_mutex_lock(&pool->mutex);
+  const bool job_done = pool->completed_slice_count == pool->slice_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  return job_done;
+}
+
+static int iree_hal_transfer_io_pool_thread_main(void* arg) {
+  iree_hal_transfer_io_pool_t* pool = (iree_hal_transfer_io_pool_t*)arg;
+  for (;;) {
+    iree_notification_await(&pool->job_notification,
+                            iree_hal_transfer_io_pool_has_work, pool,
+                            iree_infinite_timeout());
+    if (!iree_hal_transfer_io_pool_run_slice(pool)) {
+      iree_slim_mutex_lock(&pool->mutex);
+      const bool exit_requested = pool->exit_requested;
+      iree_slim_mutex_unlock(&pool->mutex);
+      if (exit_requested) break;
+    }
+  }
+  iree_slim_mutex_lock(&pool->mutex);
+  ++pool->exited_thread_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_notification_post(&pool->done_notification, IREE_ALL_WAITERS);
+  return 0;
+}
+
+static bool iree_hal_transfer_io_pool_all_exited(void* arg) {
+  iree_hal_transfer_io_pool_t* pool = (iree_hal_transfer_io_pool_t*)arg;
+  iree_slim_mutex_lock(&pool->mutex);
+  const bool all_exited = pool->exited_thread_count == pool->thread_count;
+  iree_slim_mutex_unlock(&pool->mutex);
+  return all_exited;
+}
+
+static void iree_hal_transfer_io_pool_destroy(
+    iree_hal_transfer_io_pool_t* pool) {
+  if (!pool) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Ask all threads to exit and join them. No job can be in progress as the
+  // issuing worker always waits for jobs to complete. Releasing a thread only
+  // joins it once it has started running so we first wait for all threads to
+  // leave their main loop.
+  iree_slim_mutex_lock(&pool->mutex);
+  pool->exit_requested = true;
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_notification_post(&pool->job_notification, IREE_ALL_WAITERS);
+  iree_notification_await(&pool->done_notification,
+                          iree_hal_transfer_io_pool_all_exited, pool,
+                          iree_infinite_timeout());
+  for (iree_host_size_t i = 0; i < pool->thread_count; ++i) {
+    iree_thread_release(pool->threads[i]);
+  }
+
+  iree_status_ignore(pool->status);
+  iree_notification_deinitialize(&pool->done_notification);
+  iree_notification_deinitialize(&pool->job_notification);
+  iree_slim_mutex_deinitialize(&pool->mutex);
+  iree_allocator_free(pool->host_allocator, pool);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Creates a pool that splits IO across |participant_count| threads including
+// the calling worker.
+static iree_status_t iree_hal_transfer_io_pool_create(
+    iree_host_size_t participant_count, iree_allocator_t host_allocator,
+    iree_hal_transfer_io_pool_t** out_pool) {
+  IREE_ASSERT_ARGUMENT(out_pool);
+  IREE_ASSERT(participant_count > 1 &&
+              participant_count <= IREE_HAL_TRANSFER_THREAD_MAX_COUNT);
+  *out_pool = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)participant_count);
+
+  iree_hal_transfer_io_pool_t* pool = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*pool), (void**)&pool));
+  memset(pool, 0, sizeof(*pool));
+  pool->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&pool->mutex);
+  iree_notification_initialize(&pool->job_notification);
+  iree_notification_initialize(&pool->done_notification);
+
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < participant_count - 1; ++i) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-hal-transfer");
+    status = iree_thread_create(iree_hal_transfer_io_pool_thread_main, pool,
+                                params, host_allocator, &pool->threads[i]);
+    if (!iree_status_is_ok(status)) break;
+    ++pool->thread_count;
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_pool = pool;
+  } else {
+    iree_hal_transfer_io_pool_destroy(pool);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Synchronously transfers |length| bytes between |file| and |buffer| using all
+// threads in |pool|. Only one job may be issued at a time.
+static iree_status_t iree_hal_transfer_io_pool_execute(
+    iree_hal_transfer_io_pool_t* pool, iree_hal_transfer_direction_t direction,
+    iree_hal_file_t* file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Evenly split the job across all participants. Slices are kept aligned so
+  // that positional IO on page-aligned files stays page-aligned.
+  const iree_host_size_t participant_count = pool->thread_count + 1;
+  iree_device_size_t slice_length = iree_device_align(
+      iree_device_size_ceil_div(length, participant_count), 4096);
+
+  iree_slim_mutex_lock(&pool->mutex);
+  pool->direction = direction;
+  pool->file = file;
+  pool->file_offset = file_offset;
+  pool->buffer = buffer;
+  pool->buffer_offset = buffer_offset;
+  pool->length = length;
+  pool->slice_length = slice_length;
+  pool->slice_count =
+      (iree_host_size_t)iree_device_size_ceil_div(length, slice_length);
+  pool->next_slice = 0;
+  pool->completed_slice_count = 0;
+  iree_slim_mutex_unlock(&pool->mutex);
+  iree_notification_post(&pool->job_notification, IREE_ALL_WAITERS);
+
+  // Participate until all slices are claimed and then wait for the stragglers.
+  while (iree_hal_transfer_io_pool_run_slice(pool)) {
+  }
+  iree_notification_await(&pool->done_notification,
+                          iree_hal_transfer_io_pool_is_job_done, pool,
+                          iree_infinite_timeout());
+
+  iree_slim_mutex_lock(&pool->mutex);
+  iree_status_t status = pool->status;
+  pool->status = iree_ok_status();
+  pool->slice_count = 0;
+  pool->next_slice = 0;
+  pool->completed_slice_count = 0;
+  iree_slim_mutex_unlock(&pool->mutex);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_transfer_operation_t
 //===----------------------------------------------------------------------===//
@@ -55,16 +351,25 @@ typedef uint64_t iree_hal_transfer_worker_bitmask_t;
 #define iree_hal_transfer_worker_live_count(bitmask) \
   iree_math_count_ones_u64(bitmask)
 
-// Describes the direction of a transfer operation.
-typedef enum {
-  // Transferring from the file to the buffer (read).
-  IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER = 0,
-  // Transferring from the buffer to the file (write).
-  IREE_HAL_TRANSFER_WRITE_BUFFER_TO_FILE,
-} iree_hal_transfer_direction_t;
-
 typedef struct iree_hal_transfer_operation_t iree_hal_transfer_operation_t;
 
+// One chunk-sized region of the staging buffer owned by a worker.
+// Workers rotate through their slots in order so that while the device is
+// copying one slot the host can be staging another.
+typedef struct iree_hal_transfer_slot_t {
+  // Aligned offset into the staging buffer of the slot storage.
+  iree_device_size_t staging_buffer_offset;
+  // Worker semaphore timepoint at which the last device operation using the
+  // slot completes and the slot is available for reuse.
+  uint64_t timepoint;
+  // Offset into the transfer operation of the chunk held by the slot.
+  iree_device_size_t transfer_offset;
+  // Length of the chunk held by the slot; usually the chunk size but may be
+  // less if the slot is processing the end of the file. When writing 0
+  // indicates the slot holds no chunk pending flush to the file.
+  iree_device_size_t transfer_length;
+} iree_hal_transfer_slot_t;
+
 // A worker greedily processing subranges of a larger transfer operation.
 // Since transfers are 99% IO bound we avoid real threads and use workers as
 // coroutines (or something like them): workers submit operations and schedule
@@ -72,26 +377,28 @@ typedef struct iree_hal_transfer_operation_t iree_hal_transfer_operation_t;
 // woken the worker will try to grab another subrange of the transfer and
 // continue running. When there are no remaining subranges the workers will
 // exit and when the last does the transfer is marked complete.
+//
+// Each worker owns one or more staging slots and keeps that many chunks in
+// flight: device copies of previously staged chunks overlap with the host file
+// IO of the next chunk.
 typedef struct iree_hal_transfer_worker_t {
   // Parent operation this worker is a part of.
   iree_hal_transfer_operation_t* operation;
   // Used to associate tracing events with this worker.
   IREE_TRACE(int32_t trace_id;)
-  // Aligned offset into the staging buffer of the worker storage.
-  iree_device_size_t staging_buffer_offset;
-  // Aligned length of the staging buffer storage reserved for the worker.
-  iree_device_size_t staging_buffer_length;
   // Semaphore representing the timeline of the worker. The payload is a
   // monotonically increasing operation count.
   iree_hal_semaphore_t* semaphore;
-  // Pending timepoint representing an in-flight operation. Upon completion of
-  // the operation the semaphore will reach this value.
+  // Pending timepoint representing the last in-flight operation. Upon
+  // completion of all operations the semaphore will reach this value.
   uint64_t pending_timepoint;
-  // Offset into the transfer operation this worker is currently processing.
-  iree_device_size_t pending_transfer_offset;
-  // Length of the current worker transfer; usually staging_buffer_length but
-  // may be less if this worker is processing the end of the file.
-  iree_device_size_t pending_transfer_length;
+  // Total number of staging slots owned by the worker.
+  iree_host_size_t slot_count;
+  // Index of the next slot to process. When reading this is the next slot to
+  // stage into and when writing it is the oldest slot pending flush.
+  iree_host_size_t next_slot;
+  // Staging slots; stored at the end of the operation struct.
+  iree_hal_transfer_slot_t* slots;
 } iree_hal_transfer_worker_t;
 
 // Manages an asynchronous transfer operation.
@@ -128,10 +435,15 @@ typedef struct iree_hal_transfer_operation_t {
   // Contents are stored at the end of the struct.
   iree_hal_semaphore_list_t signal_semaphore_list;
 
-  // Shared staging buffer; contains storage for all workers.
+  // Shared staging buffer; contains storage for all worker slots.
   // We avoid a subspan buffer here to reduce overheads.
   iree_hal_buffer_t* staging_buffer;
   iree_device_size_t staging_buffer_size;
+  // Size of each staging slot and the maximum length of each chunk.
+  iree_device_size_t chunk_size;
+
+  // Optional pool of threads used to split the file IO of each chunk.
+  iree_hal_transfer_io_pool_t* io_pool;
 
   // Offset to where the transfer head is in the operation.
   // Ranges from 0 at the start and length at the end.
@@ -180,15 +492,36 @@ static iree_status_t iree_hal_transfer_operation_create(
   }
   iree_device_size_t total_chunk_count =
       iree_device_size_ceil_div(length, worker_chunk_size);
-  iree_host_size_t worker_count = options.chunk_count;
-  if (worker_count == IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT) {
-    // Try to give each worker a couple chunks.
-    worker_count = (iree_host_size_t)iree_device_size_ceil_div(
-        total_chunk_count, IREE_HAL_TRANSFER_CHUNKS_PER_WORKER);
-  }
+  iree_host_size_t worker_count = (iree_host_size_t)iree_device_size_ceil_div(
+      total_chunk_count, IREE_HAL_TRANSFER_CHUNKS_PER_WORKER);
   worker_count =
-      iree_min(worker_count, iree_min(IREE_HAL_TRANSFER_WORKER_LIMIT,
-                                      IREE_HAL_TRANSFER_WORKER_MAX_COUNT));
+      iree_max(1, iree_min(worker_count,
+                           iree_min(IREE_HAL_TRANSFER_WORKER_LIMIT,
+                                    IREE_HAL_TRANSFER_WORKER_MAX_COUNT)));
+
+  // Distribute the staging chunks across workers. There's no use in having
+  // more chunks in flight than there are in the transfer.
+  iree_device_size_t staging_chunk_count = options.chunk_count;
+  if (staging_chunk_count == IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT) {
+    staging_chunk_count = worker_count * IREE_HAL_TRANSFER_PIPELINE_DEPTH;
+  }
+  staging_chunk_count = iree_min(staging_chunk_count, total_chunk_count);
+  worker_count = (iree_host_size_t)iree_max(
+      1, iree_min(worker_count, staging_chunk_count));
+  iree_host_size_t slots_per_worker = (iree_host_size_t)iree_max(
+      1, staging_chunk_count / worker_count);
+
+  // Determine how many threads will split the file IO of each chunk.
+  iree_host_size_t thread_count = options.thread_count;
+  if (thread_count == IREE_HAL_FILE_TRANSFER_THREAD_COUNT_DEFAULT) {
+    thread_count = (iree_host_size_t)iree_min(
+        IREE_HAL_TRANSFER_THREAD_LIMIT,
+        worker_chunk_size / IREE_HAL_TRANSFER_THREAD_SLICE_SIZE);
+  }
+  thread_count = iree_max(1, iree_min(thread_count,
+                                      IREE_HAL_TRANSFER_THREAD_MAX_COUNT));
+  // Multiple loop workers would contend for the single pool.
+  if (worker_count > 1) thread_count = 1;
 
   // Calculate total size of the structure with all its associated data.
   iree_hal_transfer_operation_t* operation = NULL;
@@ -205,6 +538,9 @@ static iree_status_t iree_hal_transfer_operation_create(
   iree_host_size_t worker_offset =
       iree_host_align(total_size, iree_max_align_t);
   total_size = worker_offset + sizeof(operation->workers[0]) * worker_count;
+  iree_host_size_t slot_offset = iree_host_align(total_size, iree_max_align_t);
+  total_size = slot_offset + sizeof(operation->workers[0].slots[0]) *
+                                 worker_count * slots_per_worker;
 
   // Allocate and initialize the struct.
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -222,7 +558,9 @@ static iree_status_t iree_hal_transfer_operation_create(
   iree_hal_buffer_retain(buffer);
   operation->buffer_offset = buffer_offset;
   operation->length = length;
-  operation->staging_buffer_size = worker_count * worker_chunk_size;
+  operation->staging_buffer_size =
+      worker_count * slots_per_worker * worker_chunk_size;
+  operation->chunk_size = worker_chunk_size;
   operation->transfer_head = 0;
   operation->remaining_chunks = (iree_host_size_t)total_chunk_count;
   operation->worker_count = worker_count;
@@ -237,6 +575,8 @@ static iree_status_t iree_hal_transfer_operation_create(
       (uint64_t*)((uintptr_t)operation + payload_values_offset);
   operation->workers =
       (iree_hal_transfer_worker_t*)((uintptr_t)operation + worker_offset);
+  iree_hal_transfer_slot_t* slots =
+      (iree_hal_transfer_slot_t*)((uintptr_t)operation + slot_offset);
 
   // Assign a unique ID we'll use to make it easier to track what individual
   // steps are part of this transfer.
@@ -272,9 +612,18 @@ static iree_status_t iree_hal_transfer_operation_create(
     // operation.
     IREE_TRACE(worker->trace_id = (int64_t)i);
 
-    // View into the staging buffer where the worker keeps its memory.
-    worker->staging_buffer_offset = worker_chunk_size * i;
-    worker->staging_buffer_length = worker_chunk_size;
+    // Views into the staging buffer where the worker keeps its memory.
+    worker->slot_count = slots_per_worker;
+    worker->next_slot = 0;
+    worker->slots = &slots[i * slots_per_worker];
+    for (iree_host_size_t j = 0; j < slots_per_worker; ++j) {
+      iree_hal_transfer_slot_t* slot = &worker->slots[j];
+      slot->staging_buffer_offset =
+          worker_chunk_size * (i * slots_per_worker + j);
+      slot->timepoint = 0ull;
+      slot->transfer_offset = 0;
+      slot->transfer_length = 0;
+    }
 
     // Create semaphore for tracking worker progress.
     worker->pending_timepoint = 0ull;
@@ -283,11 +632,20 @@ static iree_status_t iree_hal_transfer_operation_create(
     if (!iree_status_is_ok(status)) break;
   }
 
+  if (iree_status_is_ok(status) && thread_count > 1) {
+    status = iree_hal_transfer_io_pool_create(thread_count, host_allocator,
+                                              &operation->io_pool);
+  }
+
   if (iree_status_is_ok(status)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "worker count: ");
     IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)worker_count);
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "worker chunk size: ");
     IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)worker_chunk_size);
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "slots per worker: ");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slots_per_worker);
+    IREE_TRACE_ZONE_APPEND_TEXT(z0, "thread count: ");
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)thread_count);
     *out_operation = operation;
   } else {
     iree_hal_transfer_operation_release(operation);
@@ -322,6 +680,7 @@ static void iree_hal_transfer_operation_destroy(
   // handlers will try to access the memory.
   IREE_ASSERT(operation->live_workers == 0, "all workers must have exited");
 
+  iree_hal_transfer_io_pool_destroy(operation->io_pool);
   for (iree_host_size_t i = 0; i < operation->worker_count; ++i) {
     iree_hal_semaphore_release(operation->workers[i].semaphore);
   }
@@ -340,12 +699,44 @@ static void iree_hal_transfer_operation_destroy(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Synchronously transfers a chunk of the operation between the file and the
+// staging buffer, splitting it across the IO pool threads if available.
+static iree_status_t iree_hal_transfer_operation_stage(
+    iree_hal_transfer_operation_t* operation, iree_hal_transfer_slot_t* slot) {
+  uint64_t file_offset = operation->file_offset + slot->transfer_offset;
+  if (operation->io_pool) {
+    return iree_hal_transfer_io_pool_execute(
+        operation->io_pool, operation->direction, operation->file, file_offset,
+        operation->staging_buffer, slot->staging_buffer_offset,
+        slot->transfer_length);
+  }
+  return iree_hal_transfer_file_io(
+      operation->direction, operation->file, file_offset,
+      operation->staging_buffer, slot->staging_buffer_offset,
+      slot->transfer_length);
+}
+
+// Grabs the next chunk of the transfer and assigns it to |slot|.
+static void iree_hal_transfer_operation_take_chunk(
+    iree_hal_transfer_operation_t* operation, iree_hal_transfer_slot_t* slot) {
+  IREE_ASSERT(operation->remaining_chunks > 0,
+              "should not have ticked if there was no work to do");
+  --operation->remaining_chunks;
+  slot->transfer_offset = operation->transfer_head;
+  slot->transfer_length = iree_min(operation->length - slot->transfer_offset,
+                                   operation->chunk_size);
+  IREE_ASSERT(slot->transfer_length > 0,
+              "should not have ticked if there was no work to do");
+  operation->transfer_head += slot->transfer_length;
+}
+
 // Notifies listeners that the operation has completed and releases its memory.
-// If this was a read then the staging buffer dealloca will be chained to the
-// last asynchronous copies. In writes the last flush to the file happened
-// synchronously so the dealloca happens immediately.
+// The staging buffer dealloca will be chained to the last asynchronous device
+// operations of each worker. In writes the last flush to the file happened
+// synchronously but failed workers may have left copies in flight.
 //
-// Pre-condition: all workers have exited and there are no operations in flight.
+// Pre-condition: all workers have exited and there are no host operations in
+// flight.
 // Post-condition: the operation is freed.
 static void iree_hal_transfer_operation_notify_completion(
     iree_hal_transfer_operation_t* operation) {
@@ -357,23 +748,19 @@ static void iree_hal_transfer_operation_notify_completion(
   IREE_ASSERT(operation->live_workers == 0, "no workers can be live");
 
   // Deallocating the staging buffer can only happen after all workers have
-  // completed copies into/out-of it. In reads it's expected there are copies
-  // in-flight and we can wait on all worker semaphores. In writes the last
-  // flush to the file happened synchronously so we don't need to wait at all.
-  iree_hal_semaphore_list_t wait_semaphore_list =
-      iree_hal_semaphore_list_empty();
-  if (operation->direction == IREE_HAL_TRANSFER_READ_FILE_TO_BUFFER) {
-    wait_semaphore_list.count = operation->worker_count;
-    wait_semaphore_list.semaphores = (iree_hal_semaphore_t**)iree_alloca(
-        wait_semaphore_list.count * sizeof(wait_semaphore_list.semaphores[0]));
-    wait_semaphore_list.payload_values =
-        (uint64_t*)iree_alloca(wait_semaphore_list.count *
-                               sizeof(wait_semaphore_list.payload_values[0]));
-    for (iree_host_size_t i = 0; i < operation->worker_count; ++i) {
-      iree_hal_transfer_worker_t* worker = &operation->workers[i];
-      wait_semaphore_list.semaphores[i] = worker->semaphore;
-      wait_semaphore_list.payload_values[i] = worker->pending_timepoint;
-    }
+  // completed copies into/out-of it. Waiting on timepoints that have already
+  // been reached is cheap so we always wait on every worker.
+  iree_hal_semaphore_list_t wait_semaphore_list = {
+      .count = operation->worker_count,
+      .semaphores = (iree_hal_semaphore_t**)iree_alloca(
+          operation->worker_count * sizeof(iree_hal_semaphore_t*)),
+      .payload_values =
+          (uint64_t*)iree_alloca(operation->worker_count * sizeof(uint64_t)),
+  };
+  for (iree_host_size_t i = 0; i < operation->worker_count; ++i) {
+    iree_hal_transfer_worker_t* worker = &operation->workers[i];
+    wait_semaphore_list.semaphores[i] = worker->semaphore;
+    wait_semaphore_list.payload_values[i] = worker->pending_timepoint;
   }
 
   // When the dealloca completes signal the original semaphores passed in to the
@@ -481,16 +868,14 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
     return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
   }
 
-  // Grab a piece of the transfer to operate on.
-  --operation->remaining_chunks;
-  iree_device_size_t transfer_offset = operation->transfer_head;
-  iree_device_size_t transfer_length = iree_min(
-      operation->length - transfer_offset, worker->staging_buffer_length);
-  IREE_ASSERT(transfer_length > 0,
-              "should not have ticked if there was no work to do");
-  operation->transfer_head += transfer_length;
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_offset);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_length);
+  // Grab a piece of the transfer to operate on and stage it into the next slot.
+  // The slot is available as we waited for its last copy to complete before
+  // ticking.
+  iree_hal_transfer_slot_t* slot = &worker->slots[worker->next_slot];
+  worker->next_slot = (worker->next_slot + 1) % worker->slot_count;
+  iree_hal_transfer_operation_take_chunk(operation, slot);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slot->transfer_offset);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slot->transfer_length);
 
   // Timeline increments by one.
   uint64_t wait_timepoint = worker->pending_timepoint;
@@ -505,31 +890,26 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
       .semaphores = &worker->semaphore,
       .payload_values = &signal_timepoint,
   };
-
-  // Track the pending copy operation so we know where to place it in the
-  // buffer.
-  worker->pending_transfer_offset = transfer_offset;
-  worker->pending_transfer_length = transfer_length;
+  slot->timepoint = signal_timepoint;
 
   // Synchronously copy the contents from the file to the staging buffer.
-  status = iree_hal_file_read(
-      operation->file, operation->file_offset + worker->pending_transfer_offset,
-      operation->staging_buffer, worker->staging_buffer_offset,
-      worker->pending_transfer_length);
+  // Copies of chunks staged into other slots may still be in flight.
+  status = iree_hal_transfer_operation_stage(operation, slot);
 
   // Issue asynchronous copy from the staging buffer into the target buffer.
   if (iree_status_is_ok(status)) {
     status = iree_hal_device_queue_copy(
         operation->device, operation->queue_affinity, wait_semaphore_list,
         signal_semaphore_list, operation->staging_buffer,
-        worker->staging_buffer_offset, operation->buffer,
-        operation->buffer_offset + transfer_offset, transfer_length);
+        slot->staging_buffer_offset, operation->buffer,
+        operation->buffer_offset + slot->transfer_offset,
+        slot->transfer_length);
   }
 
-  // Wait for the copy to complete and tick again if we expect there to be more
-  // work. If there are no more chunks to copy (or they are spoken for by other
-  // live workers) we can avoid the loop wait and exit such that the dealloca
-  // can chain on to the copy operations.
+  // Wait for the next slot to be available and tick again if we expect there
+  // to be more work. If there are no more chunks to copy (or they are spoken
+  // for by other live workers) we can avoid the loop wait and exit such that
+  // the dealloca can chain on to the copy operations.
   if (iree_status_is_ok(status)) {
     if (iree_hal_transfer_worker_live_count(operation->live_workers) >
         operation->remaining_chunks) {
@@ -537,15 +917,15 @@ static iree_status_t iree_hal_transfer_worker_copy_file_to_buffer(
       // avoid an additional host wake (+ latency) by the loop event.
       IREE_TRACE_ZONE_APPEND_TEXT(z0,
                                   "exit: remaining chunks covered by workers");
-      status = iree_hal_transfer_worker_exit(operation, worker, status);
-    } else {
-      status = iree_loop_wait_one(
-          loop,
-          iree_hal_semaphore_await(worker->semaphore,
-                                   worker->pending_timepoint),
-          iree_infinite_timeout(), iree_hal_transfer_worker_copy_file_to_buffer,
-          worker);
+      IREE_TRACE_ZONE_END(z0);
+      return iree_hal_transfer_worker_exit(operation, worker, status);
     }
+    status = iree_loop_wait_one(
+        loop,
+        iree_hal_semaphore_await(worker->semaphore,
+                                 worker->slots[worker->next_slot].timepoint),
+        iree_infinite_timeout(), iree_hal_transfer_worker_copy_file_to_buffer,
+        worker);
   }
 
   if (!iree_status_is_ok(status)) {
@@ -594,6 +974,9 @@ static iree_status_t iree_hal_transfer_operation_launch_read(
     iree_hal_transfer_worker_t* worker = &operation->workers[i];
     alloca_semaphore_list.semaphores[i] = worker->semaphore;
     alloca_semaphore_list.payload_values[i] = ++worker->pending_timepoint;
+    for (iree_host_size_t j = 0; j < worker->slot_count; ++j) {
+      worker->slots[j].timepoint = worker->pending_timepoint;
+    }
   }
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_hal_device_queue_alloca(
@@ -638,71 +1021,63 @@ static iree_status_t iree_hal_transfer_operation_launch_read(
 static iree_status_t iree_hal_transfer_worker_copy_staging_to_file(
     void* user_data, iree_loop_t loop, iree_status_t status);
 
+// Grabs the next chunk of the transfer and issues an asynchronous copy of it
+// from the source buffer into |slot|.
 static iree_status_t iree_hal_transfer_worker_copy_buffer_to_staging(
     iree_hal_transfer_operation_t* operation,
-    iree_hal_transfer_worker_t* worker, iree_loop_t loop) {
+    iree_hal_transfer_worker_t* worker, iree_hal_transfer_slot_t* slot) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)operation->trace_id);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)worker->trace_id);
 
-  // If there's been an error we bail.
-  if (!iree_status_is_ok(operation->error_status)) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: error bit set");
-    IREE_TRACE_ZONE_END(z0);
-    return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
-  }
-
   // Grab a piece of the transfer to operate on.
-  IREE_ASSERT(operation->remaining_chunks > 0,
-              "should not have ticked if there was no work to do");
-  --operation->remaining_chunks;
-  iree_device_size_t transfer_offset = operation->transfer_head;
-  iree_device_size_t transfer_length = iree_min(
-      operation->length - transfer_offset, worker->staging_buffer_length);
-  IREE_ASSERT(transfer_length > 0,
-              "should not have ticked if there was no work to do");
-  operation->transfer_head += transfer_length;
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_offset);
-  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)transfer_length);
+  iree_hal_transfer_operation_take_chunk(operation, slot);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slot->transfer_offset);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)slot->transfer_length);
 
   // Timeline increments by one.
+  uint64_t wait_timepoint = worker->pending_timepoint;
   iree_hal_semaphore_list_t wait_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
-      .payload_values = &worker->pending_timepoint,
+      .payload_values = &wait_timepoint,
   };
-  ++worker->pending_timepoint;
+  uint64_t signal_timepoint = ++worker->pending_timepoint;
   iree_hal_semaphore_list_t signal_semaphore_list = {
       .count = 1,
       .semaphores = &worker->semaphore,
-      .payload_values = &worker->pending_timepoint,
+      .payload_values = &signal_timepoint,
   };
-
-  // Track the pending copy operation so we know where to place it in the file.
-  worker->pending_transfer_offset = transfer_offset;
-  worker->pending_transfer_length = transfer_length;
+  slot->timepoint = signal_timepoint;
 
   // Issue an asynchronous copy from the source buffer to the staging buffer.
   iree_status_t status = iree_hal_device_queue_copy(
       operation->device, operation->queue_affinity, wait_semaphore_list,
       signal_semaphore_list, operation->buffer,
-      operation->buffer_offset + transfer_offset, operation->staging_buffer,
-      worker->staging_buffer_offset, transfer_length);
+      operation->buffer_offset + slot->transfer_offset,
+      operation->staging_buffer, slot->staging_buffer_offset,
+      slot->transfer_length);
 
-  // Wait for the copy to complete so we can write it to the file.
-  if (iree_status_is_ok(status)) {
-    status = iree_loop_wait_one(
-        loop,
-        iree_hal_semaphore_await(worker->semaphore, worker->pending_timepoint),
-        iree_infinite_timeout(), iree_hal_transfer_worker_copy_staging_to_file,
-        worker);
-  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
 
+// Waits for the oldest in-flight copy of |worker| so that it can be flushed to
+// the file. Exits the worker if it has no chunks in flight.
+static iree_status_t iree_hal_transfer_worker_wait_staging(
+    iree_hal_transfer_operation_t* operation,
+    iree_hal_transfer_worker_t* worker, iree_loop_t loop) {
+  iree_hal_transfer_slot_t* slot = &worker->slots[worker->next_slot];
+  if (slot->transfer_length == 0) {
+    return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
+  }
+  iree_status_t status = iree_loop_wait_one(
+      loop, iree_hal_semaphore_await(worker->semaphore, slot->timepoint),
+      iree_infinite_timeout(), iree_hal_transfer_worker_copy_staging_to_file,
+      worker);
   if (!iree_status_is_ok(status)) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: copy/wait failure");
     status = iree_hal_transfer_worker_exit(operation, worker, status);
   }
-  IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
@@ -723,28 +1098,33 @@ static iree_status_t iree_hal_transfer_worker_copy_staging_to_file(
   }
 
   // Synchronously copy the contents from the staging buffer to the file.
-  status = iree_hal_file_write(
-      operation->file, operation->file_offset + worker->pending_transfer_offset,
-      operation->staging_buffer, worker->staging_buffer_offset,
-      worker->pending_transfer_length);
-
-  if (iree_status_is_ok(status) && operation->remaining_chunks == 0) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "exit: no more chunks remaining to write");
-    IREE_TRACE_ZONE_END(z0);
-    return iree_hal_transfer_worker_exit(operation, worker, iree_ok_status());
-  }
-
+  // Copies into other slots may still be in flight.
+  iree_hal_transfer_slot_t* slot = &worker->slots[worker->next_slot];
+  status = iree_hal_transfer_operation_stage(operation, slot);
+  slot->transfer_length = 0;
   if (!iree_status_is_ok(status)) {
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: file write error");
     IREE_TRACE_ZONE_END(z0);
     return iree_hal_transfer_worker_exit(operation, worker, status);
   }
 
+  // Refill the now-available slot with the next chunk so that it is in flight
+  // behind the copies into the other slots.
+  if (operation->remaining_chunks > 0) {
+    status = iree_hal_transfer_worker_copy_buffer_to_staging(operation,
+                                                             worker, slot);
+    if (!iree_status_is_ok(status)) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "bail: copy failure");
+      IREE_TRACE_ZONE_END(z0);
+      return iree_hal_transfer_worker_exit(operation, worker, status);
+    }
+  }
+  worker->next_slot = (worker->next_slot + 1) % worker->slot_count;
+
   IREE_TRACE_ZONE_END(z0);
 
-  // Tail call: tick the worker so that it transfers another chunk.
-  return iree_hal_transfer_worker_copy_buffer_to_staging(operation, worker,
-                                                         loop);
+  // Tail call: wait for the next slot to flush (or exit if none are pending).
+  return iree_hal_transfer_worker_wait_staging(operation, worker, loop);
 }
 
 // Begins the transfer operation after |wait_semaphore_list| is satisfied.
@@ -795,7 +1175,7 @@ static iree_status_t iree_hal_transfer_operation_launch_write(
               &operation->staging_buffer));
 
   // After the alloca completes each worker will be at the same starting point.
-  // We'll wait on each and start the worker-specific coroutines.
+  // We'll fill each worker's slots and start the worker-specific coroutines.
   iree_status_t status = iree_ok_status();
   for (iree_host_size_t worker_index = 0;
        worker_index < operation->worker_count; ++worker_index) {
@@ -803,12 +1183,22 @@ static iree_status_t iree_hal_transfer_operation_launch_write(
     operation->live_workers |= 1ull << worker_index;
     iree_hal_transfer_operation_retain(operation);
 
-    // Issue the initial asynchronous copy from the source buffer to the worker
-    // chunk. This will wait for the alloca to complete so that the staging
-    // buffer is available for use. After the copy completes the worker will
-    // tick itself so long as there are chunks remaining to write.
-    status = iree_hal_transfer_worker_copy_buffer_to_staging(operation, worker,
-                                                             loop);
+    // Issue the initial asynchronous copies from the source buffer to each
+    // worker slot. These will wait for the alloca to complete so that the
+    // staging buffer is available for use. After each copy completes the
+    // worker will flush it to the file and refill the slot so long as there
+    // are chunks remaining to write.
+    for (iree_host_size_t i = 0;
+         i < worker->slot_count && operation->remaining_chunks > 0; ++i) {
+      status = iree_hal_transfer_worker_copy_buffer_to_staging(
+          operation, worker, &worker->slots[i]);
+      if (!iree_status_is_ok(status)) break;
+    }
+    if (!iree_status_is_ok(status)) {
+      status = iree_hal_transfer_worker_exit(operation, worker, status);
+      break;
+    }
+    status = iree_hal_transfer_worker_wait_staging(operation, worker, loop);
     if (!iree_status_is_ok(status)) break;
 
     // It's possible that the entire operation completed inline.
@@ -874,6 +1264,15 @@ IREE_API_EXPORT iree_status_t iree_hal_device_queue_read_streaming(
         target_offset, length);
   }
 
+  // If the file supports asynchronous reads directly into the target buffer
+  // then we can avoid staging and let the file signal when the data lands.
+  if (iree_hal_io_uring_file_isa(source_file) &&
+      iree_hal_io_uring_file_can_read_into(target_buffer)) {
+    return iree_hal_io_uring_file_enqueue_read(
+        source_file, wait_semaphore_list, signal_semaphore_list, source_offset,
+        target_buffer, target_offset, length);
+  }
+
   // Allocate full transfer operation.
   iree_hal_transfer_operation_t* operation = NULL;
   IREE_RETURN_IF_ERROR(iree_hal_transfer_operation_create(
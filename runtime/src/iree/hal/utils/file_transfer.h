@@ -20,6 +20,7 @@ extern "C" {
 
 #define IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT 0
 #define IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT 0
+#define IREE_HAL_FILE_TRANSFER_THREAD_COUNT_DEFAULT 0
 
 // Options for file-based transfer operations.
 typedef struct iree_hal_file_transfer_options_t {
@@ -28,9 +29,11 @@ typedef struct iree_hal_file_transfer_options_t {
   iree_loop_t loop;
   // Total number of staging buffer chunks to allocate.
   // Setting to >1 will allow for overlapped staging and transfer at the cost
-  // of additional staging buffer memory consumption.
+  // of additional staging buffer memory consumption: with 2 the host stages
+  // one chunk while the device copies the previous one (double buffering) and
+  // with 3 there is additional slack to absorb file IO latency variance.
   // IREE_HAL_FILE_TRANSFER_CHUNK_COUNT_DEFAULT can be used to have the
-  // implementation select a chunk size based on whether the device can benefit
+  // implementation select a chunk count based on whether the device can benefit
   // from overlapping staging.
   iree_device_size_t chunk_count;
   // Maximum size of chunks in bytes. The size may be adjusted to meet alignment
@@ -38,6 +41,14 @@ typedef struct iree_hal_file_transfer_options_t {
   // IREE_HAL_FILE_TRANSFER_CHUNK_SIZE_DEFAULT can be used to have the
   // implementation select a chunk size based on the size of the transfer.
   iree_device_size_t chunk_size;
+  // Total number of host threads used to perform the file reads/writes of each
+  // chunk, including the thread running the transfer. Setting to >1 splits
+  // each chunk into slices that are processed concurrently by threads owned by
+  // the transfer which can improve throughput on storage that requires deep
+  // queues to reach peak bandwidth.
+  // IREE_HAL_FILE_TRANSFER_THREAD_COUNT_DEFAULT can be used to have the
+  // implementation select a thread count based on the chunk size.
+  iree_host_size_t thread_count;
 } iree_hal_file_transfer_options_t;
 
 // EXPERIMENTAL: eventually we'll focus this only on emulating support where
@@ -0,0 +1,187 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/file_transfer.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/hal/utils/memory_file.h"
+#include "iree/io/file_handle.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace hal {
+namespace {
+
+class FileTransferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &device_allocator_));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_sync_device_create(
+        IREE_SV("sync"), &params, /*loader_count=*/0, /*loaders=*/NULL,
+        device_allocator_, host_allocator, &device_));
+    IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore_));
+  }
+
+  void TearDown() override {
+    iree_hal_semaphore_release(semaphore_);
+    iree_hal_file_release(file_);
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  // Wraps |contents| in a memory file. |contents| must remain live for the
+  // duration of the test.
+  void CreateFile(std::vector<uint8_t>& contents) {
+    iree_io_file_handle_t* handle = NULL;
+    IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+        iree_make_byte_span(contents.data(), contents.size()),
+        iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+        &handle));
+    iree_status_t status = iree_hal_memory_file_wrap(
+        IREE_HAL_QUEUE_AFFINITY_ANY, IREE_HAL_MEMORY_ACCESS_ALL, handle,
+        device_allocator_, iree_allocator_system(), &file_);
+    iree_io_file_handle_release(handle);
+    IREE_ASSERT_OK(status);
+  }
+
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t length) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage =
+        IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(device_allocator_, params,
+                                                     length, &buffer));
+    return buffer;
+  }
+
+  std::vector<uint8_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<uint8_t> data(iree_hal_buffer_byte_length(buffer));
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, data.data(), data.size()));
+    return data;
+  }
+
+  static std::vector<uint8_t> MakeContents(iree_host_size_t length) {
+    std::vector<uint8_t> contents(length);
+    for (iree_host_size_t i = 0; i < length; ++i) {
+      contents[i] = (uint8_t)(i * 13 + (i >> 11));
+    }
+    return contents;
+  }
+
+  // Reads |length| bytes from the file at |file_offset| into a new buffer.
+  iree_hal_buffer_t* Read(uint64_t file_offset, iree_device_size_t length,
+                          iree_hal_file_transfer_options_t options) {
+    iree_hal_buffer_t* buffer = AllocateBuffer(length);
+    iree_status_t loop_status = iree_ok_status();
+    options.loop = iree_loop_inline(&loop_status);
+    uint64_t signal_value = ++timepoint_;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore_, &signal_value};
+    IREE_CHECK_OK(iree_hal_device_queue_read_streaming(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_list, file_, file_offset, buffer, /*target_offset=*/0, length,
+        /*flags=*/0, options));
+    IREE_CHECK_OK(loop_status);
+    IREE_CHECK_OK(iree_hal_semaphore_wait(semaphore_, signal_value,
+                                          iree_infinite_timeout()));
+    return buffer;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_hal_semaphore_t* semaphore_ = NULL;
+  uint64_t timepoint_ = 0ull;
+  iree_hal_file_t* file_ = NULL;
+};
+
+TEST_F(FileTransferTest, ReadDefaultOptions) {
+  std::vector<uint8_t> contents = MakeContents(100 * 1024 + 17);
+  CreateFile(contents);
+  iree_hal_file_transfer_options_t options = {};
+  iree_hal_buffer_t* buffer = Read(/*file_offset=*/17, 100 * 1024, options);
+  EXPECT_EQ(ReadBuffer(buffer),
+            std::vector<uint8_t>(contents.begin() + 17, contents.end()));
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests reads that rotate through multiple staging chunks.
+TEST_F(FileTransferTest, ReadPipelined) {
+  const iree_host_size_t length = 1024 * 1024 + 123;
+  std::vector<uint8_t> contents = MakeContents(length);
+  CreateFile(contents);
+  iree_hal_file_transfer_options_t options = {};
+  options.chunk_count = 3;
+  options.chunk_size = 64 * 1024;
+  options.thread_count = 1;
+  iree_hal_buffer_t* buffer = Read(/*file_offset=*/0, length, options);
+  EXPECT_EQ(ReadBuffer(buffer), contents);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests reads that split each chunk across multiple threads.
+TEST_F(FileTransferTest, ReadThreaded) {
+  const iree_host_size_t length = 3 * 1024 * 1024 + 5;
+  std::vector<uint8_t> contents = MakeContents(length + 100);
+  CreateFile(contents);
+  iree_hal_file_transfer_options_t options = {};
+  options.chunk_count = 2;
+  options.chunk_size = 512 * 1024;
+  options.thread_count = 4;
+  iree_hal_buffer_t* buffer = Read(/*file_offset=*/100, length, options);
+  EXPECT_EQ(ReadBuffer(buffer),
+            std::vector<uint8_t>(contents.begin() + 100, contents.end()));
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests writes that rotate through multiple staging chunks and threads.
+TEST_F(FileTransferTest, WritePipelinedThreaded) {
+  const iree_host_size_t length = 2 * 1024 * 1024 + 77;
+  std::vector<uint8_t> contents(length + 64, 0);
+  CreateFile(contents);
+  std::vector<uint8_t> source = MakeContents(length);
+  iree_hal_buffer_t* buffer = AllocateBuffer(length);
+  IREE_ASSERT_OK(
+      iree_hal_buffer_map_write(buffer, 0, source.data(), source.size()));
+
+  iree_status_t loop_status = iree_ok_status();
+  iree_hal_file_transfer_options_t options = {};
+  options.loop = iree_loop_inline(&loop_status);
+  options.chunk_count = 3;
+  options.chunk_size = 256 * 1024;
+  options.thread_count = 3;
+  uint64_t signal_value = ++timepoint_;
+  iree_hal_semaphore_list_t signal_list = {1, &semaphore_, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_write_streaming(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_list, buffer, /*source_offset=*/0, file_, /*target_offset=*/64,
+      length, /*flags=*/0, options));
+  IREE_ASSERT_OK(loop_status);
+  IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore_, signal_value,
+                                         iree_infinite_timeout()));
+
+  EXPECT_EQ(std::vector<uint8_t>(contents.begin(), contents.begin() + 64),
+            std::vector<uint8_t>(64, 0));
+  EXPECT_EQ(std::vector<uint8_t>(contents.begin() + 64, contents.end()),
+            source);
+  iree_hal_buffer_release(buffer);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
@@ -0,0 +1,961 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/io_uring_file.h"
+
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
+//===----------------------------------------------------------------------===//
+// Configuration
+//===----------------------------------------------------------------------===//
+
+// When 1 file descriptors can be wrapped and read/written with positional IO.
+#if !defined(IREE_HAL_IO_URING_FILE_HAVE_FD)
+#if defined(IREE_PLATFORM_WINDOWS) || defined(IREE_PLATFORM_EMSCRIPTEN) || \
+    defined(IREE_PLATFORM_GENERIC)
+#define IREE_HAL_IO_URING_FILE_HAVE_FD 0
+#else
+#define IREE_HAL_IO_URING_FILE_HAVE_FD 1
+#endif  // IREE_PLATFORM_*
+#endif  // !IREE_HAL_IO_URING_FILE_HAVE_FD
+
+// When 1 asynchronous reads are submitted to an io_uring instead of being
+// serviced with positional reads on the reader thread.
+#if !defined(IREE_HAL_IO_URING_FILE_HAVE_IO_URING)
+#if defined(IREE_PLATFORM_LINUX) && defined(__has_include)
+#if __has_include(<linux/io_uring.h>)
+#define IREE_HAL_IO_URING_FILE_HAVE_IO_URING 1
+#endif  // __has_include(<linux/io_uring.h>)
+#endif  // IREE_PLATFORM_LINUX && __has_include
+#endif  // !IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+#if !defined(IREE_HAL_IO_URING_FILE_HAVE_IO_URING)
+#define IREE_HAL_IO_URING_FILE_HAVE_IO_URING 0
+#endif  // !IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+#if !defined(IREE_HAL_IO_URING_FILE_QUEUE_DEPTH)
+// Maximum number of reads in flight per file. Each in-flight read occupies one
+// submission queue entry.
+#define IREE_HAL_IO_URING_FILE_QUEUE_DEPTH 64
+#endif  // !IREE_HAL_IO_URING_FILE_QUEUE_DEPTH
+
+#if !defined(IREE_HAL_IO_URING_FILE_CHUNK_SIZE)
+// Maximum number of bytes per read. Large transfers are split into chunks so
+// that multiple reads can be in flight at once and short reads only need to
+// retry a portion of the transfer.
+#define IREE_HAL_IO_URING_FILE_CHUNK_SIZE (4 * 1024 * 1024)
+#endif  // !IREE_HAL_IO_URING_FILE_CHUNK_SIZE
+
+#if IREE_HAL_IO_URING_FILE_HAVE_FD
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+//===----------------------------------------------------------------------===//
+// Positional IO utilities
+//===----------------------------------------------------------------------===//
+
+// Reads exactly |length| bytes from |fd| at |offset| into |data|.
+static iree_status_t iree_hal_fd_pread_all(int fd, uint64_t offset,
+                                           uint8_t* data,
+                                           iree_host_size_t length) {
+  while (length > 0) {
+    ssize_t read_length =
+        pread(fd, data, iree_min(length, IREE_HAL_IO_URING_FILE_CHUNK_SIZE),
+              (off_t)offset);
+    if (read_length < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "read of %" PRIhsz " bytes at offset %" PRIu64
+                              " failed",
+                              length, offset);
+    } else if (read_length == 0) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "unexpected end of file reading %" PRIhsz
+                              " bytes at offset %" PRIu64,
+                              length, offset);
+    }
+    data += read_length;
+    offset += (uint64_t)read_length;
+    length -= (iree_host_size_t)read_length;
+  }
+  return iree_ok_status();
+}
+
+// Writes exactly |length| bytes from |data| to |fd| at |offset|.
+static iree_status_t iree_hal_fd_pwrite_all(int fd, uint64_t offset,
+                                            const uint8_t* data,
+                                            iree_host_size_t length) {
+  while (length > 0) {
+    ssize_t write_length =
+        pwrite(fd, data, iree_min(length, IREE_HAL_IO_URING_FILE_CHUNK_SIZE),
+               (off_t)offset);
+    if (write_length < 0) {
+      if (errno == EINTR) continue;
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "write of %" PRIhsz " bytes at offset %" PRIu64
+                              " failed",
+                              length, offset);
+    }
+    data += write_length;
+    offset += (uint64_t)write_length;
+    length -= (iree_host_size_t)write_length;
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_t
+//===----------------------------------------------------------------------===//
+// A minimal io_uring wrapper using the raw syscalls so that we don't take a
+// dependency on liburing. Only a single thread (the file reader) ever touches
+// the rings so the only synchronization required is with the kernel.
+
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+typedef struct iree_hal_io_uring_t {
+  // Ring file descriptor or -1 if not initialized.
+  int ring_fd;
+  // Total number of submission queue entries.
+  uint32_t sq_entries;
+  // Number of SQEs queued since the last submission.
+  uint32_t sq_pending;
+
+  // Submission queue ring mapping.
+  void* sq_ring;
+  size_t sq_ring_size;
+  uint32_t* sq_head;
+  uint32_t* sq_tail;
+  uint32_t* sq_ring_mask;
+  uint32_t* sq_array;
+  // Submission queue entries mapping.
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  // Completion queue ring mapping. May alias sq_ring if the kernel supports
+  // IORING_FEAT_SINGLE_MMAP.
+  void* cq_ring;
+  size_t cq_ring_size;
+  uint32_t* cq_head;
+  uint32_t* cq_tail;
+  uint32_t* cq_ring_mask;
+  struct io_uring_cqe* cqes;
+} iree_hal_io_uring_t;
+
+static void iree_hal_io_uring_deinitialize(iree_hal_io_uring_t* ring) {
+  if (ring->sqes) munmap(ring->sqes, ring->sqes_size);
+  if (ring->cq_ring && ring->cq_ring != ring->sq_ring) {
+    munmap(ring->cq_ring, ring->cq_ring_size);
+  }
+  if (ring->sq_ring) munmap(ring->sq_ring, ring->sq_ring_size);
+  if (ring->ring_fd >= 0) close(ring->ring_fd);
+  memset(ring, 0, sizeof(*ring));
+  ring->ring_fd = -1;
+}
+
+static iree_status_t iree_hal_io_uring_initialize(uint32_t entries,
+                                                  iree_hal_io_uring_t* ring) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(ring, 0, sizeof(*ring));
+  ring->ring_fd = -1;
+
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  int ring_fd = (int)syscall(__NR_io_uring_setup, entries, &params);
+  if (ring_fd < 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "io_uring_setup failed");
+  }
+  ring->ring_fd = ring_fd;
+  ring->sq_entries = params.sq_entries;
+
+  ring->sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+  ring->cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  const bool single_mmap = params.features & IORING_FEAT_SINGLE_MMAP;
+  if (single_mmap) {
+    ring->sq_ring_size = iree_max(ring->sq_ring_size, ring->cq_ring_size);
+    ring->cq_ring_size = ring->sq_ring_size;
+  }
+
+  iree_status_t status = iree_ok_status();
+  void* sq_ring =
+      mmap(NULL, ring->sq_ring_size, PROT_READ | PROT_WRITE,
+           MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQ_RING);
+  if (sq_ring == MAP_FAILED) {
+    status = iree_make_status(iree_status_code_from_errno(errno),
+                              "io_uring submission ring mapping failed");
+  } else {
+    ring->sq_ring = sq_ring;
+  }
+  if (iree_status_is_ok(status)) {
+    if (single_mmap) {
+      ring->cq_ring = ring->sq_ring;
+    } else {
+      void* cq_ring =
+          mmap(NULL, ring->cq_ring_size, PROT_READ | PROT_WRITE,
+               MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_CQ_RING);
+      if (cq_ring == MAP_FAILED) {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "io_uring completion ring mapping failed");
+      } else {
+        ring->cq_ring = cq_ring;
+      }
+    }
+  }
+  if (iree_status_is_ok(status)) {
+    ring->sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(NULL, ring->sqes_size, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, ring_fd, IORING_OFF_SQES);
+    if (sqes == MAP_FAILED) {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "io_uring submission entry mapping failed");
+    } else {
+      ring->sqes = (struct io_uring_sqe*)sqes;
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    uint8_t* sq_base = (uint8_t*)ring->sq_ring;
+    ring->sq_head = (uint32_t*)(sq_base + params.sq_off.head);
+    ring->sq_tail = (uint32_t*)(sq_base + params.sq_off.tail);
+    ring->sq_ring_mask = (uint32_t*)(sq_base + params.sq_off.ring_mask);
+    ring->sq_array = (uint32_t*)(sq_base + params.sq_off.array);
+    uint8_t* cq_base = (uint8_t*)ring->cq_ring;
+    ring->cq_head = (uint32_t*)(cq_base + params.cq_off.head);
+    ring->cq_tail = (uint32_t*)(cq_base + params.cq_off.tail);
+    ring->cq_ring_mask = (uint32_t*)(cq_base + params.cq_off.ring_mask);
+    ring->cqes = (struct io_uring_cqe*)(cq_base + params.cq_off.cqes);
+  } else {
+    iree_hal_io_uring_deinitialize(ring);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Returns the next free submission queue entry or NULL if the queue is full.
+// The entry is zeroed and will be submitted on the next
+// iree_hal_io_uring_submit_and_wait.
+static struct io_uring_sqe* iree_hal_io_uring_get_sqe(
+    iree_hal_io_uring_t* ring) {
+  const uint32_t head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+  const uint32_t tail = *ring->sq_tail;
+  if (tail - head >= ring->sq_entries) return NULL;
+  const uint32_t index = tail & *ring->sq_ring_mask;
+  struct io_uring_sqe* sqe = &ring->sqes[index];
+  memset(sqe, 0, sizeof(*sqe));
+  ring->sq_array[index] = index;
+  __atomic_store_n(ring->sq_tail, tail + 1, __ATOMIC_RELEASE);
+  ++ring->sq_pending;
+  return sqe;
+}
+
+// Submits all pending entries and waits until at least |min_complete|
+// completions are available.
+static iree_status_t iree_hal_io_uring_submit_and_wait(
+    iree_hal_io_uring_t* ring, uint32_t min_complete) {
+  const unsigned flags = min_complete ? IORING_ENTER_GETEVENTS : 0;
+  for (;;) {
+    int result = (int)syscall(__NR_io_uring_enter, ring->ring_fd,
+                              ring->sq_pending, min_complete, flags, NULL, 0);
+    if (result >= 0) {
+      ring->sq_pending -= iree_min((uint32_t)result, ring->sq_pending);
+      if (!ring->sq_pending || min_complete) return iree_ok_status();
+    } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      return iree_make_status(iree_status_code_from_errno(errno),
+                              "io_uring_enter failed");
+    }
+  }
+}
+
+// Pops the next available completion into |out_cqe|.
+// Returns false if no completions are available.
+static bool iree_hal_io_uring_pop_cqe(iree_hal_io_uring_t* ring,
+                                      struct io_uring_cqe* out_cqe) {
+  const uint32_t head = *ring->cq_head;
+  const uint32_t tail = __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE);
+  if (head == tail) return false;
+  *out_cqe = ring->cqes[head & *ring->cq_ring_mask];
+  __atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+  return true;
+}
+
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_read_op_t
+//===----------------------------------------------------------------------===//
+
+// An asynchronous read operation enqueued on a file.
+// Resources and semaphore lists are retained and stored at the end of the
+// struct.
+typedef struct iree_hal_io_uring_read_op_t {
+  struct iree_hal_io_uring_read_op_t* next;
+  uint64_t file_offset;
+  iree_hal_buffer_t* buffer;
+  iree_device_size_t buffer_offset;
+  iree_device_size_t length;
+  iree_hal_semaphore_list_t wait_semaphore_list;
+  iree_hal_semaphore_list_t signal_semaphore_list;
+
+  // Set once the op has been started by the reader (waits satisfied and the
+  // buffer mapped).
+  bool started;
+  // Scoped mapping of the target buffer range valid once started.
+  iree_hal_buffer_mapping_t mapping;
+  bool mapped;
+  // Total number of bytes handed out to reads.
+  iree_device_size_t submitted_length;
+  // Number of reads currently in flight.
+  iree_host_size_t inflight_count;
+  // Sticky failure status; once set no more reads are issued.
+  iree_status_t status;
+} iree_hal_io_uring_read_op_t;
+
+static iree_status_t iree_hal_io_uring_read_op_create(
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length, iree_allocator_t host_allocator,
+    iree_hal_io_uring_read_op_t** out_op) {
+  *out_op = NULL;
+
+  iree_hal_io_uring_read_op_t* op = NULL;
+  const iree_host_size_t semaphore_count =
+      wait_semaphore_list.count + signal_semaphore_list.count;
+  iree_host_size_t total_size = iree_host_align(sizeof(*op), iree_max_align_t);
+  const iree_host_size_t semaphores_offset = total_size;
+  total_size += semaphore_count * sizeof(iree_hal_semaphore_t*);
+  total_size = iree_host_align(total_size, iree_max_align_t);
+  const iree_host_size_t payload_values_offset = total_size;
+  total_size += semaphore_count * sizeof(uint64_t);
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, total_size, (void**)&op));
+  memset(op, 0, sizeof(*op));
+  op->file_offset = file_offset;
+  op->buffer = buffer;
+  iree_hal_buffer_retain(buffer);
+  op->buffer_offset = buffer_offset;
+  op->length = length;
+
+  iree_hal_semaphore_t** semaphores =
+      (iree_hal_semaphore_t**)((uint8_t*)op + semaphores_offset);
+  uint64_t* payload_values = (uint64_t*)((uint8_t*)op + payload_values_offset);
+  op->wait_semaphore_list.count = wait_semaphore_list.count;
+  op->wait_semaphore_list.semaphores = semaphores;
+  op->wait_semaphore_list.payload_values = payload_values;
+  op->signal_semaphore_list.count = signal_semaphore_list.count;
+  op->signal_semaphore_list.semaphores =
+      semaphores + wait_semaphore_list.count;
+  op->signal_semaphore_list.payload_values =
+      payload_values + wait_semaphore_list.count;
+  for (iree_host_size_t i = 0; i < wait_semaphore_list.count; ++i) {
+    op->wait_semaphore_list.semaphores[i] = wait_semaphore_list.semaphores[i];
+    op->wait_semaphore_list.payload_values[i] =
+        wait_semaphore_list.payload_values[i];
+    iree_hal_semaphore_retain(wait_semaphore_list.semaphores[i]);
+  }
+  for (iree_host_size_t i = 0; i < signal_semaphore_list.count; ++i) {
+    op->signal_semaphore_list.semaphores[i] =
+        signal_semaphore_list.semaphores[i];
+    op->signal_semaphore_list.payload_values[i] =
+        signal_semaphore_list.payload_values[i];
+    iree_hal_semaphore_retain(signal_semaphore_list.semaphores[i]);
+  }
+
+  *out_op = op;
+  return iree_ok_status();
+}
+
+static void iree_hal_io_uring_read_op_destroy(
+    iree_hal_io_uring_read_op_t* op, iree_allocator_t host_allocator) {
+  for (iree_host_size_t i = 0; i < op->wait_semaphore_list.count; ++i) {
+    iree_hal_semaphore_release(op->wait_semaphore_list.semaphores[i]);
+  }
+  for (iree_host_size_t i = 0; i < op->signal_semaphore_list.count; ++i) {
+    iree_hal_semaphore_release(op->signal_semaphore_list.semaphores[i]);
+  }
+  iree_hal_buffer_release(op->buffer);
+  iree_allocator_free(host_allocator, op);
+}
+
+// Waits for the op dependencies and maps the target buffer range.
+// Failures are recorded on the op and reported when it completes.
+static void iree_hal_io_uring_read_op_start(iree_hal_io_uring_read_op_t* op) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  op->started = true;
+  op->status = iree_hal_semaphore_list_wait(op->wait_semaphore_list,
+                                            iree_infinite_timeout());
+  if (iree_status_is_ok(op->status) && op->length > 0) {
+    op->status = iree_hal_buffer_map_range(
+        op->buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+        IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, op->buffer_offset, op->length,
+        &op->mapping);
+    op->mapped = iree_status_is_ok(op->status);
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns true if the op has no more reads to issue or wait on.
+static bool iree_hal_io_uring_read_op_is_done(
+    const iree_hal_io_uring_read_op_t* op) {
+  return op->started && op->inflight_count == 0 &&
+         (!iree_status_is_ok(op->status) ||
+          op->submitted_length == op->length);
+}
+
+// Unmaps the target buffer and signals or fails the signal semaphores.
+static void iree_hal_io_uring_read_op_complete(
+    iree_hal_io_uring_read_op_t* op, iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_status_t status = op->status;
+  op->status = iree_ok_status();
+  if (op->mapped) {
+    if (iree_status_is_ok(status) &&
+        !iree_all_bits_set(iree_hal_buffer_memory_type(op->buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+      status = iree_hal_buffer_mapping_flush_range(&op->mapping, 0,
+                                                   IREE_WHOLE_BUFFER);
+    }
+    status = iree_status_join(status,
+                              iree_hal_buffer_unmap_range(&op->mapping));
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_semaphore_list_signal(op->signal_semaphore_list);
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_hal_semaphore_list_fail(op->signal_semaphore_list, status);
+  }
+  iree_hal_io_uring_read_op_destroy(op, host_allocator);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_file_t
+//===----------------------------------------------------------------------===//
+
+// A single read in flight on the ring.
+typedef struct iree_hal_io_uring_slot_t {
+  // Op the read is servicing or NULL if the slot is free.
+  iree_hal_io_uring_read_op_t* op;
+  // Remaining absolute file offset and host destination of the read.
+  uint64_t file_offset;
+  uint8_t* data;
+  iree_host_size_t length;
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  // Storage for the submitted IORING_OP_READV vector.
+  struct iovec iov;
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+} iree_hal_io_uring_slot_t;
+
+typedef struct iree_hal_io_uring_file_t {
+  iree_hal_resource_t resource;
+  // Used to allocate this structure.
+  iree_allocator_t host_allocator;
+  // Allowed access bits.
+  iree_hal_memory_access_t access;
+  // Base file handle, retained.
+  iree_io_file_handle_t* handle;
+  // File descriptor from the handle.
+  int fd;
+  // Total length of the file in bytes at the time it was wrapped.
+  uint64_t length;
+
+  // Guards the pending op list and reader lifetime.
+  iree_slim_mutex_t mutex;
+  // Posted when new ops are pending or the reader has been asked to exit.
+  iree_notification_t pending_notification;
+  // FIFO of ops waiting to be picked up by the reader.
+  iree_hal_io_uring_read_op_t* pending_head;
+  iree_hal_io_uring_read_op_t* pending_tail;
+  // Set when the file is being destroyed and the reader should exit once all
+  // pending work has drained.
+  bool exit_requested;
+  // Reader thread; created on first use.
+  iree_thread_t* reader_thread;
+
+  // Reader-thread owned state.
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  bool has_ring;
+  iree_hal_io_uring_t ring;
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  iree_host_size_t inflight_count;
+  iree_hal_io_uring_slot_t slots[IREE_HAL_IO_URING_FILE_QUEUE_DEPTH];
+} iree_hal_io_uring_file_t;
+
+static const iree_hal_file_vtable_t iree_hal_io_uring_file_vtable;
+
+static iree_hal_io_uring_file_t* iree_hal_io_uring_file_cast(
+    iree_hal_file_t* IREE_RESTRICT base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_io_uring_file_vtable);
+  return (iree_hal_io_uring_file_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_wrap(
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(handle);
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (iree_io_file_handle_type(handle) != IREE_IO_FILE_HANDLE_TYPE_FD) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                            "io_uring files require file descriptor handles");
+  }
+  const int fd = iree_io_file_handle_value(handle).fd;
+
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "unable to query length of fd %d", fd);
+  }
+
+  iree_hal_io_uring_file_t* file = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*file), (void**)&file));
+  memset(file, 0, sizeof(*file));
+  iree_hal_resource_initialize(&iree_hal_io_uring_file_vtable,
+                               &file->resource);
+  file->host_allocator = host_allocator;
+  file->access = access;
+  file->handle = handle;
+  iree_io_file_handle_retain(handle);
+  file->fd = fd;
+  file->length = (uint64_t)file_stat.st_size;
+  iree_slim_mutex_initialize(&file->mutex);
+  iree_notification_initialize(&file->pending_notification);
+
+  *out_file = (iree_hal_file_t*)file;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_io_uring_file_destroy(
+    iree_hal_file_t* IREE_RESTRICT base_file) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  iree_allocator_t host_allocator = file->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Ask the reader to exit once it has drained all outstanding reads and
+  // join it. Ops retain their buffers and semaphores but not the file so that
+  // the reader never has to release the last file reference itself.
+  iree_slim_mutex_lock(&file->mutex);
+  file->exit_requested = true;
+  iree_thread_t* reader_thread = file->reader_thread;
+  file->reader_thread = NULL;
+  iree_slim_mutex_unlock(&file->mutex);
+  iree_notification_post(&file->pending_notification, IREE_ALL_WAITERS);
+  iree_thread_release(reader_thread);
+
+  iree_notification_deinitialize(&file->pending_notification);
+  iree_slim_mutex_deinitialize(&file->mutex);
+  iree_io_file_handle_release(file->handle);
+
+  iree_allocator_free(host_allocator, file);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_hal_memory_access_t iree_hal_io_uring_file_allowed_access(
+    iree_hal_file_t* base_file) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  return file->access;
+}
+
+static uint64_t iree_hal_io_uring_file_length(iree_hal_file_t* base_file) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  return file->length;
+}
+
+static iree_hal_buffer_t* iree_hal_io_uring_file_storage_buffer(
+    iree_hal_file_t* base_file) {
+  // Descriptors have no device-accessible storage.
+  return NULL;
+}
+
+static iree_status_t iree_hal_io_uring_file_read(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_DISCARD_WRITE, buffer_offset, length, &mapping));
+  iree_status_t status =
+      iree_hal_fd_pread_all(file->fd, file_offset, mapping.contents.data,
+                            mapping.contents.data_length);
+  if (iree_status_is_ok(status) &&
+      !iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status =
+        iree_hal_buffer_mapping_flush_range(&mapping, 0, IREE_WHOLE_BUFFER);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+static iree_status_t iree_hal_io_uring_file_write(
+    iree_hal_file_t* base_file, uint64_t file_offset, iree_hal_buffer_t* buffer,
+    iree_device_size_t buffer_offset, iree_device_size_t length) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      buffer, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ,
+      buffer_offset, length, &mapping));
+  iree_status_t status = iree_ok_status();
+  if (!iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                         IREE_HAL_MEMORY_TYPE_HOST_COHERENT)) {
+    status = iree_hal_buffer_mapping_invalidate_range(&mapping, 0,
+                                                      IREE_WHOLE_BUFFER);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_fd_pwrite_all(file->fd, file_offset,
+                                    mapping.contents.data,
+                                    mapping.contents.data_length);
+  }
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+//===----------------------------------------------------------------------===//
+// Reader thread
+//===----------------------------------------------------------------------===//
+
+// Hands out chunks of |op| to free slots and queues their reads on the ring.
+// Without a ring the whole op is read synchronously.
+static void iree_hal_io_uring_file_issue_reads(
+    iree_hal_io_uring_file_t* file, iree_hal_io_uring_read_op_t* op) {
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  if (file->has_ring) {
+    while (iree_status_is_ok(op->status) &&
+           op->submitted_length < op->length &&
+           file->inflight_count < IREE_ARRAYSIZE(file->slots)) {
+      struct io_uring_sqe* sqe = iree_hal_io_uring_get_sqe(&file->ring);
+      if (!sqe) break;
+      iree_hal_io_uring_slot_t* slot = NULL;
+      for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(file->slots); ++i) {
+        if (!file->slots[i].op) {
+          slot = &file->slots[i];
+          sqe->user_data = (uint64_t)i;
+          break;
+        }
+      }
+      const iree_device_size_t chunk_length =
+          iree_min(op->length - op->submitted_length,
+                   (iree_device_size_t)IREE_HAL_IO_URING_FILE_CHUNK_SIZE);
+      slot->op = op;
+      slot->file_offset = op->file_offset + op->submitted_length;
+      slot->data = op->mapping.contents.data + op->submitted_length;
+      slot->length = (iree_host_size_t)chunk_length;
+      slot->iov.iov_base = slot->data;
+      slot->iov.iov_len = slot->length;
+      sqe->opcode = IORING_OP_READV;
+      sqe->fd = file->fd;
+      sqe->off = slot->file_offset;
+      sqe->addr = (uint64_t)(uintptr_t)&slot->iov;
+      sqe->len = 1;
+      op->submitted_length += chunk_length;
+      ++op->inflight_count;
+      ++file->inflight_count;
+    }
+    return;
+  }
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  if (iree_status_is_ok(op->status) && op->submitted_length < op->length) {
+    op->status = iree_hal_fd_pread_all(
+        file->fd, op->file_offset + op->submitted_length,
+        op->mapping.contents.data + op->submitted_length,
+        (iree_host_size_t)(op->length - op->submitted_length));
+    op->submitted_length = op->length;
+  }
+}
+
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+// Submits all queued reads, waits for at least one to complete if any are in
+// flight, and processes all available completions.
+static iree_status_t iree_hal_io_uring_file_pump_ring(
+    iree_hal_io_uring_file_t* file) {
+  IREE_RETURN_IF_ERROR(iree_hal_io_uring_submit_and_wait(
+      &file->ring, file->inflight_count ? 1 : 0));
+  struct io_uring_cqe cqe;
+  while (iree_hal_io_uring_pop_cqe(&file->ring, &cqe)) {
+    iree_hal_io_uring_slot_t* slot = &file->slots[cqe.user_data];
+    iree_hal_io_uring_read_op_t* op = slot->op;
+    if (cqe.res > 0 && (iree_host_size_t)cqe.res < slot->length &&
+        iree_status_is_ok(op->status)) {
+      // Short read; reissue the remainder using the same slot.
+      slot->file_offset += (uint64_t)cqe.res;
+      slot->data += cqe.res;
+      slot->length -= (iree_host_size_t)cqe.res;
+      slot->iov.iov_base = slot->data;
+      slot->iov.iov_len = slot->length;
+      struct io_uring_sqe* sqe = iree_hal_io_uring_get_sqe(&file->ring);
+      if (sqe) {
+        sqe->opcode = IORING_OP_READV;
+        sqe->fd = file->fd;
+        sqe->off = slot->file_offset;
+        sqe->addr = (uint64_t)(uintptr_t)&slot->iov;
+        sqe->len = 1;
+        sqe->user_data = cqe.user_data;
+        continue;
+      }
+      // The submission queue is sized to the slot count so this shouldn't
+      // happen but if it does we finish the read inline.
+      op->status = iree_hal_fd_pread_all(file->fd, slot->file_offset,
+                                         slot->data, slot->length);
+    } else if (cqe.res < 0 && iree_status_is_ok(op->status)) {
+      op->status = iree_make_status(
+          iree_status_code_from_errno(-cqe.res),
+          "read of %" PRIhsz " bytes at offset %" PRIu64 " failed",
+          slot->length, slot->file_offset);
+    } else if (cqe.res == 0 && slot->length > 0 &&
+               iree_status_is_ok(op->status)) {
+      op->status = iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                                    "unexpected end of file reading %" PRIhsz
+                                    " bytes at offset %" PRIu64,
+                                    slot->length, slot->file_offset);
+    }
+    slot->op = NULL;
+    --op->inflight_count;
+    --file->inflight_count;
+  }
+  return iree_ok_status();
+}
+
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+static bool iree_hal_io_uring_file_has_pending(void* arg) {
+  iree_hal_io_uring_file_t* file = (iree_hal_io_uring_file_t*)arg;
+  iree_slim_mutex_lock(&file->mutex);
+  const bool has_pending = file->pending_head || file->exit_requested;
+  iree_slim_mutex_unlock(&file->mutex);
+  return has_pending;
+}
+
+static int iree_hal_io_uring_file_reader_main(void* arg) {
+  iree_hal_io_uring_file_t* file = (iree_hal_io_uring_file_t*)arg;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  // The ring is optional: if the kernel or sandbox doesn't allow io_uring we
+  // fall back to positional reads on this thread.
+  iree_status_t ring_status = iree_hal_io_uring_initialize(
+      IREE_HAL_IO_URING_FILE_QUEUE_DEPTH, &file->ring);
+  file->has_ring = iree_status_is_ok(ring_status);
+  IREE_TRACE({
+    if (!file->has_ring) {
+      IREE_TRACE_ZONE_APPEND_TEXT(
+          z0, iree_status_code_string(iree_status_code(ring_status)));
+    }
+  });
+  iree_status_ignore(ring_status);
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+  // Ops taken from the pending list in submission order.
+  iree_hal_io_uring_read_op_t* active_head = NULL;
+  iree_hal_io_uring_read_op_t* active_tail = NULL;
+  for (;;) {
+    // Take all newly pending ops.
+    iree_slim_mutex_lock(&file->mutex);
+    if (file->pending_head) {
+      if (active_tail) {
+        active_tail->next = file->pending_head;
+      } else {
+        active_head = file->pending_head;
+      }
+      active_tail = file->pending_tail;
+      file->pending_head = file->pending_tail = NULL;
+    }
+    const bool exit_requested = file->exit_requested;
+    iree_slim_mutex_unlock(&file->mutex);
+
+    if (!active_head) {
+      if (exit_requested) break;
+      iree_notification_await(&file->pending_notification,
+                              iree_hal_io_uring_file_has_pending, file,
+                              iree_infinite_timeout());
+      continue;
+    }
+
+    // Start ops in order and issue reads while there is room in the queue.
+    for (iree_hal_io_uring_read_op_t* op = active_head; op; op = op->next) {
+      if (!op->started) iree_hal_io_uring_read_op_start(op);
+      iree_hal_io_uring_file_issue_reads(file, op);
+      if (file->inflight_count >= IREE_ARRAYSIZE(file->slots)) break;
+    }
+
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+    if (file->has_ring) {
+      iree_status_t status = iree_hal_io_uring_file_pump_ring(file);
+      if (!iree_status_is_ok(status)) {
+        // The ring itself is broken; we can't tell which reads completed so
+        // fail everything in flight and stop using the ring.
+        for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(file->slots); ++i) {
+          iree_hal_io_uring_read_op_t* op = file->slots[i].op;
+          if (!op) continue;
+          if (iree_status_is_ok(op->status)) {
+            op->status = iree_status_clone(status);
+          }
+          file->slots[i].op = NULL;
+          --op->inflight_count;
+        }
+        file->inflight_count = 0;
+        iree_hal_io_uring_deinitialize(&file->ring);
+        file->has_ring = false;
+        iree_status_ignore(status);
+      }
+    }
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+    // Retire completed ops.
+    iree_hal_io_uring_read_op_t* prev_op = NULL;
+    for (iree_hal_io_uring_read_op_t* op = active_head; op;) {
+      iree_hal_io_uring_read_op_t* next_op = op->next;
+      if (iree_hal_io_uring_read_op_is_done(op)) {
+        if (prev_op) {
+          prev_op->next = next_op;
+        } else {
+          active_head = next_op;
+        }
+        if (active_tail == op) active_tail = prev_op;
+        iree_hal_io_uring_read_op_complete(op, file->host_allocator);
+      } else {
+        prev_op = op;
+      }
+      op = next_op;
+    }
+  }
+
+#if IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+  if (file->has_ring) iree_hal_io_uring_deinitialize(&file->ring);
+  file->has_ring = false;
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_IO_URING
+
+  IREE_TRACE_ZONE_END(z0);
+  return 0;
+}
+
+IREE_API_EXPORT bool iree_hal_io_uring_file_isa(iree_hal_file_t* file) {
+  return iree_hal_resource_is(file, &iree_hal_io_uring_file_vtable);
+}
+
+IREE_API_EXPORT bool iree_hal_io_uring_file_can_read_into(
+    iree_hal_buffer_t* buffer) {
+  return iree_all_bits_set(iree_hal_buffer_memory_type(buffer),
+                           IREE_HAL_MEMORY_TYPE_HOST_VISIBLE) &&
+         iree_all_bits_set(iree_hal_buffer_allowed_usage(buffer),
+                           IREE_HAL_BUFFER_USAGE_MAPPING_SCOPED);
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_enqueue_read(
+    iree_hal_file_t* base_file,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length) {
+  iree_hal_io_uring_file_t* file = iree_hal_io_uring_file_cast(base_file);
+  IREE_ASSERT_ARGUMENT(buffer);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)length);
+
+  if (!iree_hal_io_uring_file_can_read_into(buffer)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "asynchronous file reads require host-mappable "
+                            "target buffers");
+  }
+
+  iree_hal_io_uring_read_op_t* op = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_io_uring_read_op_create(
+              wait_semaphore_list, signal_semaphore_list, file_offset, buffer,
+              buffer_offset, length, file->host_allocator, &op));
+
+  iree_status_t status = iree_ok_status();
+  iree_slim_mutex_lock(&file->mutex);
+  if (!file->reader_thread) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-io-uring-file");
+    status = iree_thread_create(iree_hal_io_uring_file_reader_main, file,
+                                params, file->host_allocator,
+                                &file->reader_thread);
+  }
+  if (iree_status_is_ok(status)) {
+    if (file->pending_tail) {
+      file->pending_tail->next = op;
+    } else {
+      file->pending_head = op;
+    }
+    file->pending_tail = op;
+  }
+  iree_slim_mutex_unlock(&file->mutex);
+
+  if (iree_status_is_ok(status)) {
+    iree_notification_post(&file->pending_notification, IREE_ALL_WAITERS);
+  } else {
+    iree_hal_io_uring_read_op_destroy(op, file->host_allocator);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_hal_file_vtable_t iree_hal_io_uring_file_vtable = {
+    .destroy = iree_hal_io_uring_file_destroy,
+    .allowed_access = iree_hal_io_uring_file_allowed_access,
+    .length = iree_hal_io_uring_file_length,
+    .storage_buffer = iree_hal_io_uring_file_storage_buffer,
+    .read = iree_hal_io_uring_file_read,
+    .write = iree_hal_io_uring_file_write,
+};
+
+#else
+
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_wrap(
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file) {
+  IREE_ASSERT_ARGUMENT(out_file);
+  *out_file = NULL;
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptors are not supported on this "
+                          "platform");
+}
+
+IREE_API_EXPORT bool iree_hal_io_uring_file_isa(iree_hal_file_t* file) {
+  return false;
+}
+
+IREE_API_EXPORT bool iree_hal_io_uring_file_can_read_into(
+    iree_hal_buffer_t* buffer) {
+  return false;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_enqueue_read(
+    iree_hal_file_t* file, const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length) {
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "file descriptors are not supported on this "
+                          "platform");
+}
+
+#endif  // IREE_HAL_IO_URING_FILE_HAVE_FD
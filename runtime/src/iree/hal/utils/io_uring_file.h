@@ -0,0 +1,66 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_IO_URING_FILE_H_
+#define IREE_HAL_UTILS_IO_URING_FILE_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/io/file_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_hal_io_uring_file_t
+//===----------------------------------------------------------------------===//
+
+// Creates a file backed by the file descriptor referenced by |handle|.
+// |handle| must be of type IREE_IO_FILE_HANDLE_TYPE_FD and is retained for the
+// lifetime of the file.
+//
+// Synchronous reads and writes are serviced with positional reads/writes.
+// Asynchronous reads (see iree_hal_io_uring_file_enqueue_read) are serviced by
+// a reader thread owned by the file that batches reads into an io_uring
+// submission queue and deposits the data directly into mapped buffers without
+// staging. If io_uring is unavailable (old kernel, seccomp, etc) the reader
+// falls back to positional reads on the same thread.
+//
+// Fails with IREE_STATUS_UNAVAILABLE on platforms without file descriptor
+// support.
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_wrap(
+    iree_hal_queue_affinity_t queue_affinity, iree_hal_memory_access_t access,
+    iree_io_file_handle_t* handle, iree_allocator_t host_allocator,
+    iree_hal_file_t** out_file);
+
+// Returns true if |file| is an iree_hal_io_uring_file_t.
+IREE_API_EXPORT bool iree_hal_io_uring_file_isa(iree_hal_file_t* file);
+
+// Returns true if reads from an io_uring file can be deposited directly into
+// |buffer|. This requires the buffer to be host-visible and mappable.
+IREE_API_EXPORT bool iree_hal_io_uring_file_can_read_into(
+    iree_hal_buffer_t* buffer);
+
+// Asynchronously reads |length| bytes from |file| at |file_offset| into
+// |buffer| at |buffer_offset| once |wait_semaphore_list| is satisfied and
+// signals |signal_semaphore_list| when the data is available. Failures are
+// propagated to |signal_semaphore_list|.
+//
+// |buffer| must satisfy iree_hal_io_uring_file_can_read_into. All resources are
+// retained until the read completes. Releasing the file blocks until all of its
+// outstanding reads have completed.
+IREE_API_EXPORT iree_status_t iree_hal_io_uring_file_enqueue_read(
+    iree_hal_file_t* file, const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list, uint64_t file_offset,
+    iree_hal_buffer_t* buffer, iree_device_size_t buffer_offset,
+    iree_device_size_t length);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_IO_URING_FILE_H_
@@ -0,0 +1,215 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/io_uring_file.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/io/file_handle.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+#if !defined(IREE_PLATFORM_WINDOWS) && !defined(IREE_PLATFORM_EMSCRIPTEN)
+
+#include <unistd.h>
+
+namespace iree {
+namespace hal {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+static void CloseFd(void* user_data,
+                    iree_io_file_handle_primitive_t handle_primitive) {
+  close(handle_primitive.value.fd);
+}
+
+class IoUringFileTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &device_allocator_));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    IREE_ASSERT_OK(iree_hal_sync_device_create(
+        IREE_SV("sync"), &params, /*loader_count=*/0, /*loaders=*/NULL,
+        device_allocator_, host_allocator, &device_));
+  }
+
+  void TearDown() override {
+    iree_hal_file_release(file_);
+    iree_hal_device_release(device_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  // Creates an unlinked temporary file with |contents| and imports it.
+  void CreateFile(const std::vector<uint8_t>& contents) {
+    char path[] = "/tmp/iree_io_uring_file_test_XXXXXX";
+    int fd = mkstemp(path);
+    ASSERT_GE(fd, 0);
+    unlink(path);
+    ASSERT_EQ(write(fd, contents.data(), contents.size()),
+              (ssize_t)contents.size());
+    iree_io_file_handle_release_callback_t release_callback = {
+        /*.fn=*/CloseFd,
+        /*.user_data=*/NULL,
+    };
+    iree_io_file_handle_t* handle = NULL;
+    IREE_ASSERT_OK(iree_io_file_handle_wrap_fd(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE, fd,
+        release_callback, iree_allocator_system(), &handle));
+    iree_status_t status = iree_hal_file_import(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, IREE_HAL_MEMORY_ACCESS_ALL,
+        handle, IREE_HAL_EXTERNAL_FILE_FLAG_NONE, &file_);
+    iree_io_file_handle_release(handle);
+    IREE_ASSERT_OK(status);
+    ASSERT_TRUE(iree_hal_io_uring_file_isa(file_));
+    EXPECT_EQ(iree_hal_file_length(file_), contents.size());
+  }
+
+  iree_hal_buffer_t* AllocateBuffer(iree_device_size_t length) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT | IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(device_allocator_, params,
+                                                     length, &buffer));
+    return buffer;
+  }
+
+  std::vector<uint8_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<uint8_t> data(iree_hal_buffer_byte_length(buffer));
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, data.data(), data.size()));
+    return data;
+  }
+
+  static std::vector<uint8_t> MakeContents(iree_host_size_t length) {
+    std::vector<uint8_t> contents(length);
+    for (iree_host_size_t i = 0; i < length; ++i) {
+      contents[i] = (uint8_t)(i * 7 + (i >> 12));
+    }
+    return contents;
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  iree_hal_device_t* device_ = NULL;
+  iree_hal_file_t* file_ = NULL;
+};
+
+TEST_F(IoUringFileTest, SynchronousReadWrite) {
+  std::vector<uint8_t> contents = MakeContents(4096);
+  CreateFile(contents);
+
+  iree_hal_buffer_t* buffer = AllocateBuffer(1000);
+  IREE_ASSERT_OK(iree_hal_file_read(file_, 100, buffer, 0, 1000));
+  EXPECT_EQ(ReadBuffer(buffer),
+            std::vector<uint8_t>(contents.begin() + 100,
+                                 contents.begin() + 1100));
+
+  // Write the buffer back at the start of the file and read it again.
+  IREE_ASSERT_OK(iree_hal_file_write(file_, 0, buffer, 0, 1000));
+  iree_hal_buffer_t* readback = AllocateBuffer(1000);
+  IREE_ASSERT_OK(iree_hal_file_read(file_, 0, readback, 0, 1000));
+  EXPECT_EQ(ReadBuffer(readback), ReadBuffer(buffer));
+
+  iree_hal_buffer_release(readback);
+  iree_hal_buffer_release(buffer);
+}
+
+// Tests a queue read that spans multiple chunks and waits on a dependency.
+TEST_F(IoUringFileTest, QueueRead) {
+  const iree_host_size_t length = 9 * 1024 * 1024 + 123;
+  std::vector<uint8_t> contents = MakeContents(length + 64);
+  CreateFile(contents);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  iree_hal_buffer_t* buffer = AllocateBuffer(length);
+
+  uint64_t wait_value = 1ull;
+  uint64_t signal_value = 2ull;
+  iree_hal_semaphore_list_t wait_list = {1, &semaphore, &wait_value};
+  iree_hal_semaphore_list_t signal_list = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_read(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, wait_list, signal_list, file_,
+      /*source_offset=*/64, buffer, /*target_offset=*/0, length, /*flags=*/0));
+
+  // The read can't begin until the wait is satisfied.
+  IREE_ASSERT_OK(iree_hal_semaphore_signal(semaphore, wait_value));
+  IREE_ASSERT_OK(
+      iree_hal_semaphore_wait(semaphore, signal_value, iree_infinite_timeout()));
+  EXPECT_EQ(ReadBuffer(buffer),
+            std::vector<uint8_t>(contents.begin() + 64, contents.end()));
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that many small reads batched together all land.
+TEST_F(IoUringFileTest, QueueReadBatch) {
+  std::vector<uint8_t> contents = MakeContents(256 * 1024);
+  CreateFile(contents);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  std::vector<iree_hal_buffer_t*> buffers;
+  std::vector<uint64_t> signal_values(100);
+  for (iree_host_size_t i = 0; i < signal_values.size(); ++i) {
+    buffers.push_back(AllocateBuffer(1024 + i));
+    signal_values[i] = i + 1;
+    iree_hal_semaphore_list_t signal_list = {1, &semaphore, &signal_values[i]};
+    IREE_ASSERT_OK(iree_hal_device_queue_read(
+        device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+        signal_list, file_, /*source_offset=*/i * 2048, buffers[i],
+        /*target_offset=*/0, 1024 + i, /*flags=*/0));
+  }
+  IREE_ASSERT_OK(iree_hal_semaphore_wait(semaphore, signal_values.back(),
+                                         iree_infinite_timeout()));
+  for (iree_host_size_t i = 0; i < buffers.size(); ++i) {
+    EXPECT_EQ(ReadBuffer(buffers[i]),
+              std::vector<uint8_t>(contents.begin() + i * 2048,
+                                   contents.begin() + i * 2048 + 1024 + i));
+    iree_hal_buffer_release(buffers[i]);
+  }
+  iree_hal_semaphore_release(semaphore);
+}
+
+// Tests that reading past the end of the file fails the signal semaphore.
+TEST_F(IoUringFileTest, QueueReadPastEnd) {
+  std::vector<uint8_t> contents = MakeContents(1024);
+  CreateFile(contents);
+
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_ASSERT_OK(iree_hal_semaphore_create(device_, 0ull, &semaphore));
+  iree_hal_buffer_t* buffer = AllocateBuffer(2048);
+
+  uint64_t signal_value = 1ull;
+  iree_hal_semaphore_list_t signal_list = {1, &semaphore, &signal_value};
+  IREE_ASSERT_OK(iree_hal_device_queue_read(
+      device_, IREE_HAL_QUEUE_AFFINITY_ANY, iree_hal_semaphore_list_empty(),
+      signal_list, file_, /*source_offset=*/0, buffer, /*target_offset=*/0,
+      2048, /*flags=*/0));
+  EXPECT_THAT(Status(iree_hal_semaphore_wait(semaphore, signal_value,
+                                             iree_infinite_timeout())),
+              StatusIs(StatusCode::kAborted));
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_semaphore_release(semaphore);
+}
+
+}  // namespace
+}  // namespace hal
+}  // namespace iree
+
+#endif  // !IREE_PLATFORM_WINDOWS && !IREE_PLATFORM_EMSCRIPTEN
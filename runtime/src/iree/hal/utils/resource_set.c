@@ -17,6 +17,28 @@ static uint16_t iree_hal_resource_set_chunk_capacity(
                   IREE_HAL_RESOURCE_SET_CHUNK_MAX_CAPACITY);
 }
 
+// Computes the capacity of the lookup table for sets allocated from blocks of
+// |usable_block_size|. Tables smaller than a cache line worth of MRU entries
+// would not catch anything the MRU does not and are disabled.
+static uint16_t iree_hal_resource_set_table_capacity(
+    iree_host_size_t usable_block_size) {
+  iree_host_size_t max_entries =
+      (usable_block_size / 4) / sizeof(iree_hal_resource_t*);
+  uint16_t capacity = 0;
+  for (iree_host_size_t c = IREE_HAL_RESOURCE_SET_MRU_SIZE * 2;
+       c <= max_entries && c <= IREE_HAL_RESOURCE_SET_TABLE_MAX_CAPACITY;
+       c *= 2) {
+    capacity = (uint16_t)c;
+  }
+  return capacity;
+}
+
+// Returns the byte offset of the inline chunk from the start of |set|.
+static iree_host_size_t iree_hal_resource_set_inline_chunk_offset(
+    const iree_hal_resource_set_t* set) {
+  return sizeof(*set) + set->table_capacity * sizeof(set->table[0]);
+}
+
 IREE_API_EXPORT iree_status_t iree_hal_resource_set_allocate(
     iree_arena_block_pool_t* block_pool, iree_hal_resource_set_t** out_set) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -34,18 +56,26 @@ IREE_API_EXPORT iree_status_t iree_hal_resource_set_allocate(
   memset(set, 0, sizeof(*set));
   set->block_pool = block_pool;
 
+  // Place the lookup table immediately after the set.
+  set->table = (iree_hal_resource_t**)((uint8_t*)set + sizeof(*set));
+  set->table_capacity =
+      iree_hal_resource_set_table_capacity(block_pool->usable_block_size);
+  memset(set->table, 0, set->table_capacity * sizeof(set->table[0]));
+
   // Inline the first chunk into the block using all of the remaining space.
   // This is a special case chunk that is released back to the pool with the
   // resource set and lets us avoid an additional allocation.
   // The total capacity in resources will be less than those of chunks allocated
   // from the block pool as there's reserved space at the front for the
-  // iree_hal_resource_set_t.
+  // iree_hal_resource_set_t and its table.
+  const iree_host_size_t inline_chunk_offset =
+      iree_hal_resource_set_inline_chunk_offset(set);
   iree_hal_resource_set_chunk_t* inlined_chunk =
-      (iree_hal_resource_set_chunk_t*)((uint8_t*)set + sizeof(*set));
+      (iree_hal_resource_set_chunk_t*)((uint8_t*)set + inline_chunk_offset);
   inlined_chunk->next_chunk = NULL;
   inlined_chunk->capacity = iree_hal_resource_set_chunk_capacity(
       block_pool->usable_block_size -
-      iree_host_align(sizeof(iree_hal_resource_set_t), iree_max_align_t));
+      iree_host_align(inline_chunk_offset, iree_max_align_t));
   inlined_chunk->count = 0;
   set->chunk_head = inlined_chunk;
 
@@ -129,13 +159,15 @@ IREE_API_EXPORT void iree_hal_resource_set_freeze(
     IREE_ASAN_POISON_MEMORY_REGION(
         chunk, set->block_pool->usable_block_size -
                    (iree_hal_resource_set_chunk_is_stored_inline(set, chunk)
-                        ? iree_host_align(sizeof(iree_hal_resource_set_t),
-                                          iree_max_align_t)
+                        ? iree_host_align(
+                              iree_hal_resource_set_inline_chunk_offset(set),
+                              iree_max_align_t)
                         : 0));
     chunk = next_chunk;
   }
-  // Poison the set.
-  IREE_ASAN_POISON_MEMORY_REGION(set, sizeof(iree_hal_resource_set_t));
+  // Poison the set and its table.
+  IREE_ASAN_POISON_MEMORY_REGION(
+      set, iree_hal_resource_set_inline_chunk_offset(set));
 #endif  // IREE_SANITIZER_ADDRESS
 }
 
@@ -162,6 +194,29 @@ static iree_status_t iree_hal_resource_set_insert_retain(
   return iree_ok_status();
 }
 
+// Returns the table entry holding |resource| or the empty entry where it can be
+// inserted. Returns NULL if the table is disabled or too full to accept more
+// resources; the table is kept at most 3/4 full so probing always terminates.
+static iree_hal_resource_t** iree_hal_resource_set_table_find(
+    iree_hal_resource_set_t* set, iree_hal_resource_t* resource) {
+  if (set->table_capacity == 0) return NULL;
+  const uint32_t mask = set->table_capacity - 1;
+  // Fibonacci hashing; the high bits of the product depend on all pointer bits
+  // (including those above the allocation alignment).
+  uint32_t index =
+      (uint32_t)(((uint64_t)(uintptr_t)resource * 0x9E3779B97F4A7C15ull) >>
+                 32) &
+      mask;
+  while (true) {
+    iree_hal_resource_t** entry = &set->table[index];
+    if (*entry == resource) return entry;
+    if (*entry == NULL) {
+      return set->table_count < set->table_capacity / 4 * 3 ? entry : NULL;
+    }
+    index = (index + 1) & mask;
+  }
+}
+
 // Scans the lookaside for the resource pointer and updates the order if found.
 // If the resource was not found then it will be inserted into the main list as
 // well as the MRU.
@@ -259,10 +314,22 @@ static iree_status_t iree_hal_resource_set_insert_1(
     return iree_ok_status();
   }
 
-  // Miss - insert into the main list (slow path).
-  // Note that we do this before updating the MRU in case allocation fails - we
-  // don't want to keep the pointer around unless we've really retained it.
-  IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+  // Miss - check the table to see if the resource was retained previously.
+  iree_hal_resource_t** table_entry =
+      iree_hal_resource_set_table_find(set, resource);
+  if (table_entry && *table_entry == resource) {
+    // Already retained; only the MRU needs updating.
+  } else {
+    // Insert into the main list (slow path).
+    // Note that we do this before updating the MRU and table in case
+    // allocation fails - we don't want to keep the pointer around unless we've
+    // really retained it.
+    IREE_RETURN_IF_ERROR(iree_hal_resource_set_insert_retain(set, resource));
+    if (table_entry) {
+      *table_entry = resource;
+      ++set->table_count;
+    }
+  }
 
   // Shift the MRU down and insert the new item at the head.
   memmove(&set->mru[1], &set->mru[0],
@@ -36,8 +36,9 @@ typedef struct iree_hal_resource_set_chunk_t {
 } iree_hal_resource_set_chunk_t;
 
 // Returns true if the chunk is stored inline in the parent resource set.
+// The inline chunk follows the set and its lookup table.
 #define iree_hal_resource_set_chunk_is_stored_inline(set, chunk) \
-  ((const void*)(chunk) == (const uint8_t*)set + sizeof(*set))
+  ((const void*)(chunk) == (const void*)((set)->table + (set)->table_capacity))
 
 // Number of elements in the most-recently-used resource list of a set.
 // The larger the number the greater the chance of having a hit but the more
@@ -54,6 +55,11 @@ typedef struct iree_hal_resource_set_chunk_t {
 #define IREE_HAL_RESOURCE_SET_MRU_SIZE \
   (iree_hardware_constructive_interference_size / sizeof(uintptr_t))
 
+// Maximum number of entries in the lookup table of a resource set.
+// The table is carved out of the first block of the set and sized to a power
+// of two using at most a quarter of the block.
+#define IREE_HAL_RESOURCE_SET_TABLE_MAX_CAPACITY 512
+
 // "Efficient" append-only set for retaining a set of resources.
 // This is a non-deterministic data structure that tries to reduce the amount of
 // overhead involved in tracking a reasonably-sized set of resources (~dozens to
@@ -66,6 +72,11 @@ typedef struct iree_hal_resource_set_chunk_t {
 // same buffers, etc) and is implemented to have a fixed cost regardless of
 // whether the values are found and should hopefully trigger enough to avoid the
 // subsequent full insertion that can introduce allocations and ref counting.
+// MRU misses then check a small open-addressing hash table of all resources
+// retained so far so that working sets larger than the MRU (such as the
+// bindings of dispatch-heavy command buffers) are still only retained once.
+// The table has a fixed capacity and once it fills resources are only
+// deduplicated by the MRU.
 // The idea is that if we can keep the MRU in cache and spend a dozen cycles to
 // manage it we only need to avoid a single cache miss that would occur doing
 // the full insertion. We care here because this is on the critical path of
@@ -99,6 +110,16 @@ typedef struct iree_hal_resource_set_t {
 
   // Linked list of storage chunks.
   iree_hal_resource_set_chunk_t* chunk_head;
+
+  // Open-addressing hash table with linear probing of retained resources.
+  // Stored in the first block immediately after the set and before the inline
+  // chunk. Empty entries are NULL. May have a capacity of 0 if the block is too
+  // small to hold a useful table.
+  iree_hal_resource_t** table;
+  // Power-of-two capacity of |table| in entries.
+  uint16_t table_capacity;
+  // Number of non-empty entries in |table|.
+  uint16_t table_count;
 } iree_hal_resource_set_t;
 
 // TODO(benvanik): add an allocation method that allows for placement; in many
@@ -252,6 +252,40 @@ TEST_F(ResourceSetTest, RedundantInsertion) {
   EXPECT_EQ(live_bitmap, 0u);
 }
 
+// Tests that redundant insertions that miss in the MRU are deduplicated by the
+// lookup table when the block size is large enough to have one.
+TEST_F(ResourceSetTest, RedundantInsertionBeyondMRU) {
+  iree_arena_block_pool_t large_block_pool;
+  iree_arena_block_pool_initialize(4096, host_allocator, &large_block_pool);
+  auto resource_set = make_resource_set(&large_block_pool);
+  ASSERT_GT(resource_set->table_capacity, 0);
+
+  iree_hal_resource_t* resources[32] = {NULL};
+  static_assert(IREE_ARRAYSIZE(resources) > IREE_HAL_RESOURCE_SET_MRU_SIZE,
+                "need to pick a value that lets us exceed the MRU capacity");
+  uint32_t live_bitmap = 0u;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    IREE_ASSERT_OK(iree_hal_test_resource_create(
+        i, &live_bitmap, host_allocator, &resources[i]));
+  }
+
+  // Insert all resources twice; the second pass misses in the MRU for every
+  // resource but must not retain them again.
+  for (int pass = 0; pass < 2; ++pass) {
+    IREE_ASSERT_OK(iree_hal_resource_set_insert(
+        resource_set.get(), IREE_ARRAYSIZE(resources), resources));
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(resources); ++i) {
+    EXPECT_EQ(iree_atomic_ref_count_load(&resources[i]->ref_count), 2);
+    iree_hal_resource_release(resources[i]);
+  }
+  EXPECT_EQ(live_bitmap, 0xFFFFFFFFu);
+
+  resource_set.reset();
+  EXPECT_EQ(live_bitmap, 0u);
+  iree_arena_block_pool_deinitialize(&large_block_pool);
+}
+
 }  // namespace
 }  // namespace hal
 }  // namespace iree
@@ -32,6 +32,31 @@ static void iree_hal_semaphore_timepoint_list_push_back(
   list->tail = timepoint;
 }
 
+// Inserts |timepoint| into |list| sorted by increasing minimum value.
+// Timepoints with equal values are kept in insertion order. The list is walked
+// from the tail as waiters commonly target increasing values.
+static void iree_hal_semaphore_timepoint_list_insert_sorted(
+    iree_hal_semaphore_timepoint_list_t* list,
+    iree_hal_semaphore_timepoint_t* timepoint) {
+  iree_hal_semaphore_timepoint_t* prev = list->tail;
+  while (prev && prev->minimum_value > timepoint->minimum_value) {
+    prev = prev->prev;
+  }
+  timepoint->prev = prev;
+  if (prev) {
+    timepoint->next = prev->next;
+    prev->next = timepoint;
+  } else {
+    timepoint->next = list->head;
+    list->head = timepoint;
+  }
+  if (timepoint->next) {
+    timepoint->next->prev = timepoint;
+  } else {
+    list->tail = timepoint;
+  }
+}
+
 // Erases |timepoint| from |list|.
 static void iree_hal_semaphore_timepoint_list_erase(
     iree_hal_semaphore_timepoint_list_t* list,
@@ -112,7 +137,6 @@ static void iree_hal_semaphore_resolve_timepoints(
     iree_hal_semaphore_t* semaphore, uint64_t new_value) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  iree_hal_semaphore_timepoint_list_t pending_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t ready_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_t expired_list = {NULL, NULL};
 
@@ -124,32 +148,33 @@ static void iree_hal_semaphore_resolve_timepoints(
     return;
   }
 
-  // Scan through the list and divvy up timepoints into still-pending, ready to
-  // resolve, and expired buckets.
-  iree_time_t now_ns = iree_time_now();
-  for (iree_hal_semaphore_timepoint_t* timepoint =
-           semaphore->timepoint_list.head;
-       timepoint != NULL;) {
-    iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
-    timepoint->next = NULL;
-
-    if (timepoint->minimum_value <= new_value) {
-      // Reached the timepoint; even if the deadline has been reached we'll
-      // still consider this a hit.
-      iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
-    } else if (timepoint->deadline_ns <= now_ns) {
-      // Deadline expired before the timepoint was reached.
-      iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
-    } else {
-      // Still pending.
-      iree_hal_semaphore_timepoint_list_push_back(&pending_list, timepoint);
+  // Pop all reached timepoints off the front of the sorted list. Even if the
+  // deadline has been reached we'll still consider these hits.
+  iree_hal_semaphore_timepoint_list_t* list = &semaphore->timepoint_list;
+  while (list->head && list->head->minimum_value <= new_value) {
+    iree_hal_semaphore_timepoint_t* timepoint = list->head;
+    iree_hal_semaphore_timepoint_list_erase(list, timepoint);
+    if (timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+      --semaphore->timepoint_deadline_count;
     }
-
-    timepoint = next_timepoint;
+    iree_hal_semaphore_timepoint_list_push_back(&ready_list, timepoint);
   }
 
-  // Preserve pending timepoints.
-  semaphore->timepoint_list = pending_list;
+  // Scan the still-pending timepoints for expired deadlines only if there are
+  // any that can expire.
+  if (semaphore->timepoint_deadline_count > 0) {
+    iree_time_t now_ns = iree_time_now();
+    for (iree_hal_semaphore_timepoint_t* timepoint = list->head;
+         timepoint != NULL;) {
+      iree_hal_semaphore_timepoint_t* next_timepoint = timepoint->next;
+      if (timepoint->deadline_ns <= now_ns) {
+        iree_hal_semaphore_timepoint_list_erase(list, timepoint);
+        --semaphore->timepoint_deadline_count;
+        iree_hal_semaphore_timepoint_list_push_back(&expired_list, timepoint);
+      }
+      timepoint = next_timepoint;
+    }
+  }
 
   // Issue callbacks for all successes and failures.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, new_value,
@@ -173,6 +198,7 @@ static void iree_hal_semaphore_reject_timepoints(
   iree_hal_semaphore_timepoint_list_t failed_list = {NULL, NULL};
   iree_hal_semaphore_timepoint_list_take_all(&semaphore->timepoint_list,
                                              &failed_list);
+  semaphore->timepoint_deadline_count = 0;
 
   // Issue failure callbacks for all timepoints.
   iree_hal_semaphore_issue_timepoint_callbacks(semaphore, UINT64_MAX,
@@ -195,6 +221,7 @@ IREE_API_EXPORT void iree_hal_semaphore_initialize(
   iree_slim_mutex_initialize(&out_semaphore->timepoint_mutex);
   memset(&out_semaphore->timepoint_list, 0,
          sizeof(out_semaphore->timepoint_list));
+  out_semaphore->timepoint_deadline_count = 0;
 }
 
 IREE_API_EXPORT void iree_hal_semaphore_deinitialize(
@@ -226,8 +253,11 @@ IREE_API_EXPORT void iree_hal_semaphore_acquire_timepoint(
   // After we release the lock the callback may be issued immediately as another
   // thread may be waiting to signal the timepoint.
   iree_slim_mutex_lock(&semaphore->timepoint_mutex);
-  iree_hal_semaphore_timepoint_list_push_back(&semaphore->timepoint_list,
-                                              out_timepoint);
+  iree_hal_semaphore_timepoint_list_insert_sorted(&semaphore->timepoint_list,
+                                                  out_timepoint);
+  if (out_timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+    ++semaphore->timepoint_deadline_count;
+  }
   iree_slim_mutex_unlock(&semaphore->timepoint_mutex);
 
   IREE_TRACE_ZONE_END(z0);
@@ -250,6 +280,9 @@ IREE_API_EXPORT void iree_hal_semaphore_cancel_timepoint(
     // callback.
     iree_hal_semaphore_timepoint_list_erase(&semaphore->timepoint_list,
                                             timepoint);
+    if (timepoint->deadline_ns != IREE_TIME_INFINITE_FUTURE) {
+      --semaphore->timepoint_deadline_count;
+    }
 
     // Neuter the timepoint so that it is never called.
     // Other threads may be sitting and waiting for the lock and we need to
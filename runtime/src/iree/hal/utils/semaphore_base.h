@@ -66,9 +66,10 @@ typedef struct iree_hal_semaphore_timepoint_t {
   iree_hal_semaphore_callback_t callback;
 } iree_hal_semaphore_timepoint_t;
 
-// A doubly-linked FIFO list of timepoints.
-// The order of the timepoints does *not* match increasing payload values but
-// instead the order they were added to the list.
+// A doubly-linked list of timepoints.
+// Semaphores keep their list sorted by increasing |minimum_value| with
+// timepoints of equal value in the order they were added; lists used for
+// batching callbacks are in FIFO order.
 //
 // Note that the timepoints are not owned by the list - this just nicely
 // stitches together timepoints for easier management.
@@ -95,14 +96,19 @@ struct iree_hal_semaphore_t {
   // Non-recursive mutex guarding access to the timepoint list.
   iree_slim_mutex_t timepoint_mutex;
 
-  // Timepoint list in insertion order.
-  // There are probably better orderings we could use here that allow us to
-  // walk the entire list less frequently, though target payload value is not
-  // enough as deadlines still require the scan. We could sort by non-infinite
-  // deadlines first and then infinite ones last but given the common timepoint
-  // counts (0..1) it's not worth the complexity today.
+  // Timepoint list sorted by increasing minimum value.
+  // Signals only need to visit the prefix of timepoints that have been reached
+  // and insertion walks back from the tail so that the common case of waits on
+  // monotonically increasing values is O(1). Timepoints are stored in caller
+  // memory and acquiring them must not allocate so a heap array is not an
+  // option.
   iree_hal_semaphore_timepoint_list_t timepoint_list
       IREE_GUARDED_BY(timepoint_mutex);
+
+  // Number of timepoints in |timepoint_list| with a finite deadline.
+  // Only when nonzero do signals need to scan the remaining timepoints for
+  // expired deadlines.
+  iree_host_size_t timepoint_deadline_count IREE_GUARDED_BY(timepoint_mutex);
 };
 
 // Initializes the base |out_semaphore| resource.
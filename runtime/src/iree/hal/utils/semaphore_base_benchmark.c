@@ -0,0 +1,307 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/semaphore_base.h"
+#include "iree/testing/benchmark.h"
+
+//===----------------------------------------------------------------------===//
+// iree_hal_test_semaphore_t
+//===----------------------------------------------------------------------===//
+
+// Minimal semaphore that notifies the base timepoints on signal.
+typedef struct iree_hal_test_semaphore_t {
+  iree_hal_semaphore_t base;
+  iree_allocator_t host_allocator;
+  iree_slim_mutex_t mutex;
+  uint64_t current_value IREE_GUARDED_BY(mutex);
+} iree_hal_test_semaphore_t;
+
+static const iree_hal_semaphore_vtable_t iree_hal_test_semaphore_vtable;
+
+static iree_hal_test_semaphore_t* iree_hal_test_semaphore_cast(
+    iree_hal_semaphore_t* base_value) {
+  return (iree_hal_test_semaphore_t*)base_value;
+}
+
+static iree_status_t iree_hal_test_semaphore_create(
+    iree_allocator_t host_allocator, iree_hal_semaphore_t** out_semaphore) {
+  iree_hal_test_semaphore_t* semaphore = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      host_allocator, sizeof(*semaphore), (void**)&semaphore));
+  iree_hal_semaphore_initialize(&iree_hal_test_semaphore_vtable,
+                                &semaphore->base);
+  semaphore->host_allocator = host_allocator;
+  iree_slim_mutex_initialize(&semaphore->mutex);
+  semaphore->current_value = 0;
+  *out_semaphore = &semaphore->base;
+  return iree_ok_status();
+}
+
+static void iree_hal_test_semaphore_destroy(
+    iree_hal_semaphore_t* base_semaphore) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  iree_allocator_t host_allocator = semaphore->host_allocator;
+  iree_slim_mutex_deinitialize(&semaphore->mutex);
+  iree_hal_semaphore_deinitialize(&semaphore->base);
+  iree_allocator_free(host_allocator, semaphore);
+}
+
+static iree_status_t iree_hal_test_semaphore_query(
+    iree_hal_semaphore_t* base_semaphore, uint64_t* out_value) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  iree_slim_mutex_lock(&semaphore->mutex);
+  *out_value = semaphore->current_value;
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_test_semaphore_signal(
+    iree_hal_semaphore_t* base_semaphore, uint64_t new_value) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  iree_slim_mutex_lock(&semaphore->mutex);
+  semaphore->current_value = new_value;
+  iree_slim_mutex_unlock(&semaphore->mutex);
+  iree_hal_semaphore_notify(&semaphore->base, new_value, IREE_STATUS_OK);
+  return iree_ok_status();
+}
+
+static void iree_hal_test_semaphore_fail(iree_hal_semaphore_t* base_semaphore,
+                                         iree_status_t status) {
+  iree_hal_test_semaphore_t* semaphore =
+      iree_hal_test_semaphore_cast(base_semaphore);
+  const iree_status_code_t status_code = iree_status_code(status);
+  iree_status_ignore(status);
+  iree_hal_semaphore_notify(&semaphore->base, 0, status_code);
+}
+
+static iree_status_t iree_hal_test_semaphore_wait(
+    iree_hal_semaphore_t* base_semaphore, uint64_t value,
+    iree_timeout_t timeout) {
+  return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                          "benchmark semaphores do not support waits");
+}
+
+static const iree_hal_semaphore_vtable_t iree_hal_test_semaphore_vtable = {
+    .destroy = iree_hal_test_semaphore_destroy,
+    .query = iree_hal_test_semaphore_query,
+    .signal = iree_hal_test_semaphore_signal,
+    .fail = iree_hal_test_semaphore_fail,
+    .wait = iree_hal_test_semaphore_wait,
+};
+
+static iree_status_t iree_hal_test_timepoint_callback(
+    void* user_data, iree_hal_semaphore_t* semaphore, uint64_t value,
+    iree_status_code_t status_code) {
+  ++*(uint64_t*)user_data;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Benchmarks
+//===----------------------------------------------------------------------===//
+
+// Allocates storage for |count| timepoints.
+static iree_hal_semaphore_timepoint_t* iree_hal_test_allocate_timepoints(
+    iree_allocator_t host_allocator, uint32_t count) {
+  iree_hal_semaphore_timepoint_t* timepoints = NULL;
+  IREE_CHECK_OK(iree_allocator_malloc(host_allocator,
+                                      sizeof(*timepoints) * count,
+                                      (void**)&timepoints));
+  return timepoints;
+}
+
+// Tests acquiring timepoints on increasing values and then signaling each
+// value in turn as a pipelined producer/consumer pair would.
+//
+// user_data is a count of timepoints pending at once.
+static iree_status_t iree_hal_semaphore_benchmark_signal_each_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_timepoint_t* timepoints =
+      iree_hal_test_allocate_timepoints(host_allocator, count);
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(host_allocator, &semaphore));
+
+  uint64_t value = 0;
+  uint64_t callback_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      .fn = iree_hal_test_timepoint_callback,
+      .user_data = &callback_count,
+  };
+  while (iree_benchmark_keep_running(benchmark_state,
+                                     /*batch_count=*/count)) {
+    for (uint32_t i = 0; i < count; ++i) {
+      iree_hal_semaphore_acquire_timepoint(semaphore, value + i + 1,
+                                           iree_infinite_timeout(), callback,
+                                           &timepoints[i]);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+      IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, ++value));
+    }
+  }
+  IREE_ASSERT_EQ(callback_count, value);
+
+  iree_hal_semaphore_release(semaphore);
+  iree_allocator_free(host_allocator, timepoints);
+  return iree_ok_status();
+}
+
+// Tests signaling a semaphore with timepoints pending on values that are not
+// reached such as those of waits on later stages of a pipeline.
+//
+// user_data is a count of timepoints pending at once.
+static iree_status_t iree_hal_semaphore_benchmark_signal_pending_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_timepoint_t* timepoints =
+      iree_hal_test_allocate_timepoints(host_allocator, count);
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(host_allocator, &semaphore));
+
+  uint64_t callback_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      .fn = iree_hal_test_timepoint_callback,
+      .user_data = &callback_count,
+  };
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_semaphore_acquire_timepoint(semaphore, UINT64_MAX - count + i,
+                                         iree_infinite_timeout(), callback,
+                                         &timepoints[i]);
+  }
+
+  uint64_t value = 0;
+  while (iree_benchmark_keep_running(benchmark_state, /*batch_count=*/1)) {
+    IREE_CHECK_OK(iree_hal_semaphore_signal(semaphore, ++value));
+  }
+  IREE_ASSERT_EQ(callback_count, 0);
+
+  for (uint32_t i = 0; i < count; ++i) {
+    iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i]);
+  }
+  iree_hal_semaphore_release(semaphore);
+  iree_allocator_free(host_allocator, timepoints);
+  return iree_ok_status();
+}
+
+// Tests acquiring and cancelling timepoints as timed out waits do.
+//
+// user_data is a count of timepoints pending at once.
+static iree_status_t iree_hal_semaphore_benchmark_cancel_n(
+    const iree_benchmark_def_t* benchmark_def,
+    iree_benchmark_state_t* benchmark_state) {
+  iree_allocator_t host_allocator = benchmark_state->host_allocator;
+  uint32_t count = (uint32_t)(uintptr_t)benchmark_def->user_data;
+  iree_hal_semaphore_timepoint_t* timepoints =
+      iree_hal_test_allocate_timepoints(host_allocator, count);
+  iree_hal_semaphore_t* semaphore = NULL;
+  IREE_CHECK_OK(iree_hal_test_semaphore_create(host_allocator, &semaphore));
+
+  uint64_t callback_count = 0;
+  iree_hal_semaphore_callback_t callback = {
+      .fn = iree_hal_test_timepoint_callback,
+      .user_data = &callback_count,
+  };
+  while (iree_benchmark_keep_running(benchmark_state,
+                                     /*batch_count=*/count)) {
+    for (uint32_t i = 0; i < count; ++i) {
+      iree_hal_semaphore_acquire_timepoint(
+          semaphore, 1 + i, iree_make_deadline(IREE_TIME_INFINITE_FUTURE - 1),
+          callback, &timepoints[i]);
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+      iree_hal_semaphore_cancel_timepoint(semaphore, &timepoints[i]);
+    }
+  }
+  IREE_ASSERT_EQ(callback_count, 0);
+
+  iree_hal_semaphore_release(semaphore);
+  iree_allocator_free(host_allocator, timepoints);
+  return iree_ok_status();
+}
+
+int main(int argc, char** argv) {
+  iree_benchmark_initialize(&argc, argv);
+
+  // iree_hal_semaphore_benchmark_signal_each_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_signal_each_n,
+    };
+    benchmark_def.user_data = (void*)1u;
+    iree_benchmark_register(iree_make_cstring_view("signal_each_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)16u;
+    iree_benchmark_register(iree_make_cstring_view("signal_each_16"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)256u;
+    iree_benchmark_register(iree_make_cstring_view("signal_each_256"),
+                            &benchmark_def);
+  }
+
+  // iree_hal_semaphore_benchmark_signal_pending_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_signal_pending_n,
+    };
+    benchmark_def.user_data = (void*)1u;
+    iree_benchmark_register(iree_make_cstring_view("signal_pending_1"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)16u;
+    iree_benchmark_register(iree_make_cstring_view("signal_pending_16"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)256u;
+    iree_benchmark_register(iree_make_cstring_view("signal_pending_256"),
+                            &benchmark_def);
+  }
+
+  // iree_hal_semaphore_benchmark_cancel_n
+  {
+    iree_benchmark_def_t benchmark_def = {
+        .flags = IREE_BENCHMARK_FLAG_MEASURE_PROCESS_CPU_TIME |
+                 IREE_BENCHMARK_FLAG_USE_REAL_TIME,
+        .time_unit = IREE_BENCHMARK_UNIT_NANOSECOND,
+        .minimum_duration_ns = 0,
+        .iteration_count = 0,
+        .run = iree_hal_semaphore_benchmark_cancel_n,
+    };
+    benchmark_def.user_data = (void*)1u;
+    iree_benchmark_register(iree_make_cstring_view("cancel_1"), &benchmark_def);
+    benchmark_def.user_data = (void*)16u;
+    iree_benchmark_register(iree_make_cstring_view("cancel_16"),
+                            &benchmark_def);
+    benchmark_def.user_data = (void*)256u;
+    iree_benchmark_register(iree_make_cstring_view("cancel_256"),
+                            &benchmark_def);
+  }
+
+  iree_benchmark_run_specified();
+  return 0;
+}
@@ -0,0 +1,156 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/hal/utils/shm_channel_provider.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_MACOS)
+#include <unistd.h>
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_MACOS
+
+// Maximum length of the configured channel ID including the NUL terminator.
+#define IREE_HAL_SHM_CHANNEL_PROVIDER_MAX_ID_LENGTH 64
+
+// Parses |var_name| from the environment as a non-negative int32_t.
+static bool iree_hal_shm_env_parse_int32(const char* var_name,
+                                         int32_t* out_value) {
+  const char* var_value = getenv(var_name);
+  if (!var_value || strlen(var_value) == 0) return false;
+  return iree_string_view_atoi_int32(iree_make_cstring_view(var_value),
+                                     out_value) &&
+         *out_value >= 0;
+}
+
+IREE_API_EXPORT bool iree_hal_shm_channel_is_configured(void) {
+  int32_t rank = 0;
+  int32_t count = 0;
+  return iree_hal_shm_env_parse_int32(IREE_HAL_SHM_CHANNEL_RANK_ENV, &rank) &&
+         iree_hal_shm_env_parse_int32(IREE_HAL_SHM_CHANNEL_COUNT_ENV, &count);
+}
+
+typedef struct iree_hal_shm_channel_provider_t {
+  iree_hal_resource_t resource;
+  iree_allocator_t host_allocator;
+
+  // Default rank and count from the environment.
+  int32_t rank;
+  int32_t count;
+
+  // NUL-terminated default channel ID shared by all processes in the group.
+  char id[IREE_HAL_SHM_CHANNEL_PROVIDER_MAX_ID_LENGTH];
+} iree_hal_shm_channel_provider_t;
+
+static const iree_hal_channel_provider_vtable_t
+    iree_hal_shm_channel_provider_vtable;
+
+static iree_hal_shm_channel_provider_t* iree_hal_shm_channel_provider_cast(
+    iree_hal_channel_provider_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_hal_shm_channel_provider_vtable);
+  return (iree_hal_shm_channel_provider_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_provider_create(
+    iree_allocator_t host_allocator,
+    iree_hal_channel_provider_t** out_channel_provider) {
+  IREE_ASSERT_ARGUMENT(out_channel_provider);
+  *out_channel_provider = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  int32_t rank = 0;
+  int32_t count = 0;
+  if (!iree_hal_shm_env_parse_int32(IREE_HAL_SHM_CHANNEL_RANK_ENV, &rank) ||
+      !iree_hal_shm_env_parse_int32(IREE_HAL_SHM_CHANNEL_COUNT_ENV, &count) ||
+      rank >= count) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "%s and %s must be set in the environment to a "
+                            "rank in [0, count) and a participant count",
+                            IREE_HAL_SHM_CHANNEL_RANK_ENV,
+                            IREE_HAL_SHM_CHANNEL_COUNT_ENV);
+  }
+
+  iree_hal_shm_channel_provider_t* channel_provider = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*channel_provider),
+                                (void**)&channel_provider));
+  iree_hal_resource_initialize(&iree_hal_shm_channel_provider_vtable,
+                               &channel_provider->resource);
+  channel_provider->host_allocator = host_allocator;
+  channel_provider->rank = rank;
+  channel_provider->count = count;
+
+  // All processes spawned by the same launcher share a parent and can agree on
+  // an ID without any communication.
+  const char* id = getenv(IREE_HAL_SHM_CHANNEL_ID_ENV);
+  if (id && strlen(id) > 0) {
+    snprintf(channel_provider->id, sizeof(channel_provider->id), "%s", id);
+  } else {
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_MACOS)
+    snprintf(channel_provider->id, sizeof(channel_provider->id), "ppid-%ld",
+             (long)getppid());
+#else
+    snprintf(channel_provider->id, sizeof(channel_provider->id), "default");
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_MACOS
+  }
+
+  *out_channel_provider = (iree_hal_channel_provider_t*)channel_provider;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_hal_shm_channel_provider_destroy(
+    iree_hal_channel_provider_t* base_channel_provider) {
+  iree_hal_shm_channel_provider_t* channel_provider =
+      iree_hal_shm_channel_provider_cast(base_channel_provider);
+  iree_allocator_t host_allocator = channel_provider->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_allocator_free(host_allocator, channel_provider);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT bool iree_hal_shm_channel_provider_isa(
+    iree_hal_channel_provider_t* channel_provider) {
+  return iree_hal_resource_is(channel_provider,
+                              &iree_hal_shm_channel_provider_vtable);
+}
+
+static iree_status_t iree_hal_shm_channel_provider_query_default_rank_and_count(
+    iree_hal_channel_provider_t* base_channel_provider, int32_t* out_rank,
+    int32_t* out_count) {
+  iree_hal_shm_channel_provider_t* channel_provider =
+      iree_hal_shm_channel_provider_cast(base_channel_provider);
+  *out_rank = channel_provider->rank;
+  *out_count = channel_provider->count;
+  return iree_ok_status();
+}
+
+static iree_status_t iree_hal_shm_channel_provider_exchange_default_id(
+    iree_hal_channel_provider_t* base_channel_provider, iree_byte_span_t id) {
+  iree_hal_shm_channel_provider_t* channel_provider =
+      iree_hal_shm_channel_provider_cast(base_channel_provider);
+
+  // Every participant was configured with the same ID so there is nothing to
+  // exchange; all ranks (including the root) use the configured one.
+  memset(id.data, 0, id.data_length);
+  memcpy(id.data, channel_provider->id,
+         iree_min(id.data_length, strlen(channel_provider->id)));
+
+  return iree_ok_status();
+}
+
+static const iree_hal_channel_provider_vtable_t
+    iree_hal_shm_channel_provider_vtable = {
+        .destroy = iree_hal_shm_channel_provider_destroy,
+        .query_default_rank_and_count =
+            iree_hal_shm_channel_provider_query_default_rank_and_count,
+        .exchange_default_id =
+            iree_hal_shm_channel_provider_exchange_default_id,
+};
@@ -0,0 +1,49 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_HAL_UTILS_SHM_CHANNEL_PROVIDER_H_
+#define IREE_HAL_UTILS_SHM_CHANNEL_PROVIDER_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Environment variables used to configure the default collective group of
+// processes on the same host:
+//   IREE_HAL_SHM_CHANNEL_RANK: rank of the process in `[0, count)`.
+//   IREE_HAL_SHM_CHANNEL_COUNT: total number of processes in the group.
+//   IREE_HAL_SHM_CHANNEL_ID: optional ID shared by all processes in the group.
+//     Defaults to one derived from the parent process ID such that processes
+//     spawned by the same launcher form a group.
+#define IREE_HAL_SHM_CHANNEL_RANK_ENV "IREE_HAL_SHM_CHANNEL_RANK"
+#define IREE_HAL_SHM_CHANNEL_COUNT_ENV "IREE_HAL_SHM_CHANNEL_COUNT"
+#define IREE_HAL_SHM_CHANNEL_ID_ENV "IREE_HAL_SHM_CHANNEL_ID"
+
+// Returns true if a shared memory collective group has been configured by the
+// user in the environment.
+IREE_API_EXPORT bool iree_hal_shm_channel_is_configured(void);
+
+// Creates a channel provider for collective groups of processes on the same
+// host communicating through shared memory as configured by the environment.
+// Devices that support shared memory channels (such as local-sync and
+// local-task) use the provided rank, count, and ID when channels are created
+// with default parameters.
+IREE_API_EXPORT iree_status_t iree_hal_shm_channel_provider_create(
+    iree_allocator_t host_allocator,
+    iree_hal_channel_provider_t** out_channel_provider);
+
+// Returns true if |channel_provider| is a shared memory channel provider.
+IREE_API_EXPORT bool iree_hal_shm_channel_provider_isa(
+    iree_hal_channel_provider_t* channel_provider);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_HAL_UTILS_SHM_CHANNEL_PROVIDER_H_
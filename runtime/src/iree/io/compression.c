@@ -0,0 +1,314 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/compression.h"
+
+IREE_API_EXPORT iree_string_view_t
+iree_io_compression_type_name(iree_io_compression_type_t compression_type) {
+  switch (compression_type) {
+    case IREE_IO_COMPRESSION_TYPE_NONE:
+      return IREE_SV("none");
+    case IREE_IO_COMPRESSION_TYPE_LZ4:
+      return IREE_SV("lz4");
+    case IREE_IO_COMPRESSION_TYPE_ZSTD:
+      return IREE_SV("zstd");
+    default:
+      return IREE_SV("unknown");
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_io_compression_type_parse(
+    iree_string_view_t name, iree_io_compression_type_t* out_compression_type) {
+  IREE_ASSERT_ARGUMENT(out_compression_type);
+  if (iree_string_view_equal_case(name, IREE_SV("none"))) {
+    *out_compression_type = IREE_IO_COMPRESSION_TYPE_NONE;
+  } else if (iree_string_view_equal_case(name, IREE_SV("lz4"))) {
+    *out_compression_type = IREE_IO_COMPRESSION_TYPE_LZ4;
+  } else if (iree_string_view_equal_case(name, IREE_SV("zstd"))) {
+    *out_compression_type = IREE_IO_COMPRESSION_TYPE_ZSTD;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unknown compression type `%.*s`; expected one of "
+                            "`none`, `lz4`, or `zstd`",
+                            (int)name.size, name.data);
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// LZ4 block format
+//===----------------------------------------------------------------------===//
+// https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+//
+// The encoder is a simple greedy single-probe hash matcher. It trades some
+// ratio for simplicity; any conforming LZ4 block decoder can read its output
+// and the decoder here accepts blocks produced by any conforming encoder.
+
+// Minimum match length encoded by a sequence.
+#define IREE_IO_LZ4_MIN_MATCH 4
+// The last match must start at least this many bytes before the block end.
+#define IREE_IO_LZ4_MF_LIMIT 12
+// The last this many bytes of a block are always literals.
+#define IREE_IO_LZ4_LAST_LITERALS 5
+// Maximum distance back to a match.
+#define IREE_IO_LZ4_MAX_DISTANCE 65535
+// log2 of the number of entries in the encoder match table.
+#define IREE_IO_LZ4_HASH_LOG 12
+
+static inline uint32_t iree_io_lz4_read_u32(const uint8_t* ptr) {
+  uint32_t value;
+  memcpy(&value, ptr, sizeof(value));
+  return value;
+}
+
+static inline uint32_t iree_io_lz4_hash(uint32_t sequence) {
+  return (sequence * 2654435761u) >> (32 - IREE_IO_LZ4_HASH_LOG);
+}
+
+// Writes an LZ4 length extension for |length| (already reduced by 15).
+static inline uint8_t* iree_io_lz4_write_length(uint8_t* op,
+                                                iree_host_size_t length) {
+  while (length >= 255) {
+    *op++ = 255;
+    length -= 255;
+  }
+  *op++ = (uint8_t)length;
+  return op;
+}
+
+// Emits a sequence of |literal_length| literals from |literals| followed by a
+// match of |match_length| at |distance| (or no match if |match_length| is 0).
+// Returns NULL if the sequence would not fit before |op_end|.
+static uint8_t* iree_io_lz4_emit_sequence(uint8_t* op, uint8_t* op_end,
+                                          const uint8_t* literals,
+                                          iree_host_size_t literal_length,
+                                          iree_host_size_t match_length,
+                                          uint32_t distance) {
+  const iree_host_size_t encoded_match_length =
+      match_length ? match_length - IREE_IO_LZ4_MIN_MATCH : 0;
+  const iree_host_size_t worst_case_length =
+      1 + literal_length / 255 + 1 + literal_length +
+      (match_length ? 2 + encoded_match_length / 255 + 1 : 0);
+  if (worst_case_length > (iree_host_size_t)(op_end - op)) return NULL;
+
+  uint8_t* token = op++;
+  *token = (uint8_t)(iree_min(literal_length, 15) << 4);
+  if (literal_length >= 15) {
+    op = iree_io_lz4_write_length(op, literal_length - 15);
+  }
+  memcpy(op, literals, literal_length);
+  op += literal_length;
+  if (!match_length) return op;
+
+  *op++ = (uint8_t)(distance & 0xFF);
+  *op++ = (uint8_t)(distance >> 8);
+  *token |= (uint8_t)iree_min(encoded_match_length, 15);
+  if (encoded_match_length >= 15) {
+    op = iree_io_lz4_write_length(op, encoded_match_length - 15);
+  }
+  return op;
+}
+
+// Compresses |source| into |target| and returns the compressed length or 0 if
+// the compressed block would not fit in |target|.
+static iree_host_size_t iree_io_lz4_compress(iree_const_byte_span_t source,
+                                             iree_byte_span_t target) {
+  const uint8_t* const base = source.data;
+  const iree_host_size_t length = source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* const op_end = target.data + target.data_length;
+
+  iree_host_size_t anchor = 0;
+  if (length > IREE_IO_LZ4_MF_LIMIT) {
+    uint32_t table[1 << IREE_IO_LZ4_HASH_LOG];
+    memset(table, 0, sizeof(table));
+    const iree_host_size_t match_start_limit = length - IREE_IO_LZ4_MF_LIMIT;
+    const iree_host_size_t match_end_limit = length - IREE_IO_LZ4_LAST_LITERALS;
+    iree_host_size_t ip = 0;
+    while (ip < match_start_limit) {
+      const uint32_t sequence = iree_io_lz4_read_u32(base + ip);
+      const uint32_t hash = iree_io_lz4_hash(sequence);
+      const iree_host_size_t candidate = table[hash];
+      table[hash] = (uint32_t)ip;
+      if (candidate >= ip || ip - candidate > IREE_IO_LZ4_MAX_DISTANCE ||
+          iree_io_lz4_read_u32(base + candidate) != sequence) {
+        // Skip faster through data that is not matching.
+        ip += 1 + ((ip - anchor) >> 6);
+        continue;
+      }
+
+      // Extend the match backwards over pending literals and then forwards.
+      iree_host_size_t match_ip = ip;
+      iree_host_size_t match_ref = candidate;
+      while (match_ip > anchor && match_ref > 0 &&
+             base[match_ip - 1] == base[match_ref - 1]) {
+        --match_ip;
+        --match_ref;
+      }
+      iree_host_size_t match_end = ip + IREE_IO_LZ4_MIN_MATCH;
+      while (match_end < match_end_limit &&
+             base[match_end] == base[match_ref + (match_end - match_ip)]) {
+        ++match_end;
+      }
+
+      op = iree_io_lz4_emit_sequence(op, op_end, base + anchor,
+                                     match_ip - anchor, match_end - match_ip,
+                                     (uint32_t)(match_ip - match_ref));
+      if (!op) return 0;
+      ip = anchor = match_end;
+    }
+  }
+
+  // Trailing literals end the block.
+  op = iree_io_lz4_emit_sequence(op, op_end, base + anchor, length - anchor,
+                                 /*match_length=*/0, /*distance=*/0);
+  if (!op) return 0;
+  return (iree_host_size_t)(op - target.data);
+}
+
+// Reads an LZ4 length extension into |length|.
+static inline bool iree_io_lz4_read_length(const uint8_t** ip,
+                                           const uint8_t* ip_end,
+                                           iree_host_size_t* length) {
+  uint8_t byte = 0;
+  do {
+    if (*ip >= ip_end) return false;
+    byte = *(*ip)++;
+    *length += byte;
+  } while (byte == 255);
+  return true;
+}
+
+static iree_status_t iree_io_lz4_decompress(iree_const_byte_span_t source,
+                                            iree_byte_span_t target) {
+  const uint8_t* ip = source.data;
+  const uint8_t* const ip_end = source.data + source.data_length;
+  uint8_t* op = target.data;
+  uint8_t* const op_end = target.data + target.data_length;
+  while (ip < ip_end) {
+    const uint8_t token = *ip++;
+
+    iree_host_size_t literal_length = token >> 4;
+    if (literal_length == 15 &&
+        !iree_io_lz4_read_length(&ip, ip_end, &literal_length)) {
+      break;
+    }
+    if (literal_length > (iree_host_size_t)(ip_end - ip) ||
+        literal_length > (iree_host_size_t)(op_end - op)) {
+      break;
+    }
+    memcpy(op, ip, literal_length);
+    ip += literal_length;
+    op += literal_length;
+    if (ip == ip_end) {
+      // Last sequence has only literals.
+      if (op != op_end) break;
+      return iree_ok_status();
+    }
+
+    if (ip_end - ip < 2) break;
+    const iree_host_size_t distance = (iree_host_size_t)ip[0] | (ip[1] << 8);
+    ip += 2;
+    if (distance == 0 || distance > (iree_host_size_t)(op - target.data)) {
+      break;
+    }
+    iree_host_size_t match_length = token & 0xF;
+    if (match_length == 15 &&
+        !iree_io_lz4_read_length(&ip, ip_end, &match_length)) {
+      break;
+    }
+    match_length += IREE_IO_LZ4_MIN_MATCH;
+    if (match_length > (iree_host_size_t)(op_end - op)) break;
+
+    // Matches may overlap the bytes they produce (runs) and must be copied
+    // forward a byte at a time in that case.
+    const uint8_t* match = op - distance;
+    if (distance >= match_length) {
+      memcpy(op, match, match_length);
+      op += match_length;
+    } else {
+      for (iree_host_size_t i = 0; i < match_length; ++i) *op++ = *match++;
+    }
+  }
+  return iree_make_status(IREE_STATUS_DATA_LOSS,
+                          "malformed lz4 block at offset %" PRIhsz
+                          " (decoded %" PRIhsz " of %" PRIhsz " bytes)",
+                          (iree_host_size_t)(ip - source.data),
+                          (iree_host_size_t)(op - target.data),
+                          target.data_length);
+}
+
+//===----------------------------------------------------------------------===//
+// Chunks
+//===----------------------------------------------------------------------===//
+
+IREE_API_EXPORT iree_status_t iree_io_compress_chunk(
+    iree_io_compression_type_t compression_type, iree_const_byte_span_t source,
+    iree_byte_span_t target, iree_host_size_t* out_length) {
+  IREE_ASSERT_ARGUMENT(out_length);
+  *out_length = 0;
+  if (target.data_length < source.data_length) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "chunk target capacity %" PRIhsz
+                            " is less than the source length %" PRIhsz,
+                            target.data_length, source.data_length);
+  }
+
+  // Compressed chunks must be strictly smaller than the source so that readers
+  // can distinguish them from raw chunks by length alone.
+  iree_host_size_t compressed_length = 0;
+  switch (compression_type) {
+    case IREE_IO_COMPRESSION_TYPE_NONE:
+      break;
+    case IREE_IO_COMPRESSION_TYPE_LZ4:
+      // Match positions are tracked as 32-bit offsets.
+      if (source.data_length > 1 && source.data_length <= UINT32_MAX) {
+        compressed_length = iree_io_lz4_compress(
+            source, iree_make_byte_span(target.data, source.data_length - 1));
+      }
+      break;
+    case IREE_IO_COMPRESSION_TYPE_ZSTD:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "zstd compression not available in this build");
+    default:
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unknown compression type %u", compression_type);
+  }
+
+  if (compressed_length) {
+    *out_length = compressed_length;
+  } else {
+    memcpy(target.data, source.data, source.data_length);
+    *out_length = source.data_length;
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_decompress_chunk(
+    iree_io_compression_type_t compression_type, iree_const_byte_span_t source,
+    iree_byte_span_t target) {
+  if (source.data_length == target.data_length) {
+    // Stored raw.
+    memcpy(target.data, source.data, source.data_length);
+    return iree_ok_status();
+  } else if (source.data_length > target.data_length) {
+    return iree_make_status(IREE_STATUS_DATA_LOSS,
+                            "stored chunk length %" PRIhsz
+                            " exceeds its uncompressed length %" PRIhsz,
+                            source.data_length, target.data_length);
+  }
+  switch (compression_type) {
+    case IREE_IO_COMPRESSION_TYPE_LZ4:
+      return iree_io_lz4_decompress(source, target);
+    case IREE_IO_COMPRESSION_TYPE_ZSTD:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "zstd decompression not available in this build");
+    default:
+      return iree_make_status(IREE_STATUS_DATA_LOSS,
+                              "chunk compressed with unknown type %u",
+                              compression_type);
+  }
+}
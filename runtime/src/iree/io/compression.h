@@ -0,0 +1,86 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_COMPRESSION_H_
+#define IREE_IO_COMPRESSION_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Compression scheme applied to each chunk of a chunked payload.
+// Values match iree_io_parameter_archive_compression_type_t.
+enum iree_io_compression_type_e {
+  // Chunks are stored uncompressed.
+  IREE_IO_COMPRESSION_TYPE_NONE = 0u,
+  // Chunks are LZ4 blocks (no frame headers or checksums).
+  IREE_IO_COMPRESSION_TYPE_LZ4 = 1u,
+  // Chunks are zstd frames. Reserved; not supported by this implementation.
+  IREE_IO_COMPRESSION_TYPE_ZSTD = 2u,
+};
+typedef uint32_t iree_io_compression_type_t;
+
+// Default uncompressed length of each chunk in a chunked payload.
+// Chunks are the unit of random access and parallelism: reading any byte of a
+// parameter requires decompressing the whole chunk containing it and each
+// chunk can be decompressed independently of all others.
+#define IREE_IO_COMPRESSION_DEFAULT_CHUNK_LENGTH (1024 * 1024)
+
+// Returns a string name for |compression_type| (such as `lz4`).
+IREE_API_EXPORT iree_string_view_t
+iree_io_compression_type_name(iree_io_compression_type_t compression_type);
+
+// Parses a compression type |name| (`none`, `lz4`, or `zstd`).
+IREE_API_EXPORT iree_status_t iree_io_compression_type_parse(
+    iree_string_view_t name, iree_io_compression_type_t* out_compression_type);
+
+//===----------------------------------------------------------------------===//
+// Chunked payloads
+//===----------------------------------------------------------------------===//
+// A chunked payload stores data of some uncompressed length split into
+// fixed-size chunks (the last may be shorter) that are compressed
+// independently. The payload begins with a table of chunk_count + 1
+// little-endian uint64_t offsets relative to the start of the payload with
+// chunk i stored in [offsets[i], offsets[i + 1]). The table allows readers to
+// locate and decompress only the chunks covering the range they need.
+//
+// Chunks that do not compress are stored raw; a chunk whose stored length
+// equals its uncompressed length is always raw.
+
+// Returns the number of chunks in a payload of |length| uncompressed bytes.
+static inline uint64_t iree_io_chunked_payload_chunk_count(
+    uint64_t length, uint64_t chunk_length) {
+  return (length + chunk_length - 1) / chunk_length;
+}
+
+// Returns the size in bytes of the chunk offset table at the head of a payload
+// with |chunk_count| chunks.
+static inline uint64_t iree_io_chunked_payload_table_size(
+    uint64_t chunk_count) {
+  return (chunk_count + 1) * sizeof(uint64_t);
+}
+
+// Compresses one chunk of |source| contents into |target| and returns the
+// stored length in |out_length|. |target| must have capacity for at least
+// |source| bytes. If the contents do not compress they are copied raw and the
+// stored length equals the source length.
+IREE_API_EXPORT iree_status_t iree_io_compress_chunk(
+    iree_io_compression_type_t compression_type, iree_const_byte_span_t source,
+    iree_byte_span_t target, iree_host_size_t* out_length);
+
+// Decompresses one stored chunk in |source| into |target|. The length of
+// |target| must be the exact uncompressed length of the chunk.
+IREE_API_EXPORT iree_status_t iree_io_decompress_chunk(
+    iree_io_compression_type_t compression_type, iree_const_byte_span_t source,
+    iree_byte_span_t target);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_COMPRESSION_H_
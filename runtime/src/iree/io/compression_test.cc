@@ -0,0 +1,110 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/compression.h"
+
+#include <cstdint>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+// Compresses |source| as a chunk, verifies it round-trips, and returns the
+// stored length.
+static iree_host_size_t RoundTrip(iree_io_compression_type_t compression_type,
+                                  const std::vector<uint8_t>& source) {
+  std::vector<uint8_t> stored(source.size());
+  iree_host_size_t stored_length = 0;
+  IREE_CHECK_OK(iree_io_compress_chunk(
+      compression_type, iree_make_const_byte_span(source.data(), source.size()),
+      iree_make_byte_span(stored.data(), stored.size()), &stored_length));
+  EXPECT_LE(stored_length, source.size());
+  std::vector<uint8_t> result(source.size());
+  IREE_CHECK_OK(iree_io_decompress_chunk(
+      compression_type, iree_make_const_byte_span(stored.data(), stored_length),
+      iree_make_byte_span(result.data(), result.size())));
+  EXPECT_EQ(result, source);
+  return stored_length;
+}
+
+TEST(CompressionTest, ParseTypes) {
+  iree_io_compression_type_t compression_type = 0;
+  IREE_ASSERT_OK(iree_io_compression_type_parse(IREE_SV("lz4"),
+                                                &compression_type));
+  EXPECT_EQ(compression_type, IREE_IO_COMPRESSION_TYPE_LZ4);
+  IREE_ASSERT_OK(iree_io_compression_type_parse(IREE_SV("none"),
+                                                &compression_type));
+  EXPECT_EQ(compression_type, IREE_IO_COMPRESSION_TYPE_NONE);
+  EXPECT_THAT(Status(iree_io_compression_type_parse(IREE_SV("gzip"),
+                                                    &compression_type)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+// Tests that data that does not compress is stored raw.
+TEST(CompressionTest, IncompressibleStoredRaw) {
+  std::vector<uint8_t> source(4096);
+  uint32_t state = 0x12345678u;
+  for (auto& value : source) {
+    state = state * 1664525u + 1013904223u;
+    value = (uint8_t)(state >> 24);
+  }
+  EXPECT_EQ(RoundTrip(IREE_IO_COMPRESSION_TYPE_LZ4, source), source.size());
+  EXPECT_EQ(RoundTrip(IREE_IO_COMPRESSION_TYPE_NONE, source), source.size());
+}
+
+// Tests runs, repeated patterns, and short inputs of every length around the
+// LZ4 end-of-block limits.
+TEST(CompressionTest, Lz4RoundTrip) {
+  std::vector<uint8_t> zeros(1024 * 1024);
+  EXPECT_LT(RoundTrip(IREE_IO_COMPRESSION_TYPE_LZ4, zeros), 8 * 1024);
+
+  std::vector<uint8_t> pattern(100000);
+  for (size_t i = 0; i < pattern.size(); ++i) {
+    pattern[i] = (uint8_t)((i * 7) % 251);
+  }
+  EXPECT_LT(RoundTrip(IREE_IO_COMPRESSION_TYPE_LZ4, pattern), pattern.size());
+
+  for (size_t length = 0; length < 64; ++length) {
+    std::vector<uint8_t> source(length, 0xAB);
+    RoundTrip(IREE_IO_COMPRESSION_TYPE_LZ4, source);
+  }
+}
+
+// Tests that corrupt blocks are rejected instead of overrunning buffers.
+TEST(CompressionTest, Lz4Malformed) {
+  // A match with a distance pointing before the start of the output.
+  const uint8_t source[] = {0x14, 'a', 0x05, 0x00, 0x00};
+  uint8_t target[16];
+  EXPECT_THAT(Status(iree_io_decompress_chunk(
+                  IREE_IO_COMPRESSION_TYPE_LZ4,
+                  iree_make_const_byte_span(source, sizeof(source)),
+                  iree_make_byte_span(target, sizeof(target)))),
+              StatusIs(StatusCode::kDataLoss));
+
+  // A stored chunk larger than its uncompressed length.
+  EXPECT_THAT(Status(iree_io_decompress_chunk(
+                  IREE_IO_COMPRESSION_TYPE_LZ4,
+                  iree_make_const_byte_span(source, sizeof(source)),
+                  iree_make_byte_span(target, 2))),
+              StatusIs(StatusCode::kDataLoss));
+}
+
+TEST(CompressionTest, ChunkCount) {
+  EXPECT_EQ(iree_io_chunked_payload_chunk_count(0, 16), 0);
+  EXPECT_EQ(iree_io_chunked_payload_chunk_count(1, 16), 1);
+  EXPECT_EQ(iree_io_chunked_payload_chunk_count(16, 16), 1);
+  EXPECT_EQ(iree_io_chunked_payload_chunk_count(17, 16), 2);
+  EXPECT_EQ(iree_io_chunked_payload_table_size(2), 3 * sizeof(uint64_t));
+}
+
+}  // namespace
@@ -6,9 +6,15 @@
 
 #include "iree/io/file_handle.h"
 
+#include <errno.h>
+
 #include "iree/base/internal/atomics.h"
 #include "iree/io/memory_stream.h"
 
+#if !defined(IREE_PLATFORM_WINDOWS)
+#include <unistd.h>
+#endif  // !IREE_PLATFORM_WINDOWS
+
 //===----------------------------------------------------------------------===//
 // iree_io_file_handle_t
 //===----------------------------------------------------------------------===//
@@ -60,6 +66,25 @@ IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_host_allocation(
                                   release_callback, host_allocator, out_handle);
 }
 
+IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_fd(
+    iree_io_file_access_t allowed_access, int fd,
+    iree_io_file_handle_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle) {
+  if (fd < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid file descriptor %d", fd);
+  }
+  iree_io_file_handle_primitive_t handle_primitive = {
+      .type = IREE_IO_FILE_HANDLE_TYPE_FD,
+      .value =
+          {
+              .fd = fd,
+          },
+  };
+  return iree_io_file_handle_wrap(allowed_access, handle_primitive,
+                                  release_callback, host_allocator, out_handle);
+}
+
 static void iree_io_file_handle_destroy(iree_io_file_handle_t* handle) {
   IREE_ASSERT_ARGUMENT(handle);
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -111,6 +136,19 @@ iree_io_file_handle_flush(iree_io_file_handle_t* handle) {
       // No-op (though we could flush when known mapped).
       break;
     }
+    case IREE_IO_FILE_HANDLE_TYPE_FD: {
+#if !defined(IREE_PLATFORM_WINDOWS)
+      if (fsync(handle->primitive.value.fd) != 0) {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "fsync of fd %d failed",
+                                  handle->primitive.value.fd);
+      }
+#else
+      status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                                "fd flush not supported on this platform");
+#endif  // !IREE_PLATFORM_WINDOWS
+      break;
+    }
     default: {
       status = iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "flush not supported on handle type %d",
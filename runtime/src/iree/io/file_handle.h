@@ -46,7 +46,13 @@ typedef enum iree_io_file_handle_type_e {
   // as long as the file handle referencing it.
   IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION = 0u,
 
-  // TODO(benvanik): file descriptor, FILE*, HANDLE, etc.
+  // A POSIX file descriptor opened for positional reads/writes.
+  // The handle creator is responsible for ensuring the descriptor remains open
+  // for as long as the file handle referencing it. The primitive release
+  // callback is a usable place to close the descriptor.
+  IREE_IO_FILE_HANDLE_TYPE_FD = 1u,
+
+  // TODO(benvanik): FILE*, HANDLE, etc.
 } iree_io_file_handle_type_t;
 
 // A platform handle to a file primitive.
@@ -55,6 +61,8 @@ typedef enum iree_io_file_handle_type_e {
 typedef union iree_io_file_handle_primitive_value_t {
   // IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION
   iree_byte_span_t host_allocation;
+  // IREE_IO_FILE_HANDLE_TYPE_FD
+  int fd;
 } iree_io_file_handle_primitive_value_t;
 
 // A (type, value) pair describing a system file primitive handle.
@@ -112,6 +120,16 @@ IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_host_allocation(
     iree_io_file_handle_release_callback_t release_callback,
     iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle);
 
+// Wraps a POSIX file descriptor |fd| in a reference-counted file handle.
+// |allowed_access| declares which operations are allowed on the handle and may
+// be more restrictive than the mode the descriptor was opened with.
+// The optional provided |release_callback| will be issued when the last
+// reference to the handle is released and may be used to close |fd|.
+IREE_API_EXPORT iree_status_t iree_io_file_handle_wrap_fd(
+    iree_io_file_access_t allowed_access, int fd,
+    iree_io_file_handle_release_callback_t release_callback,
+    iree_allocator_t host_allocator, iree_io_file_handle_t** out_handle);
+
 // Retains the file |handle| for the caller.
 IREE_API_EXPORT void iree_io_file_handle_retain(iree_io_file_handle_t* handle);
 
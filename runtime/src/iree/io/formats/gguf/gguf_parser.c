@@ -605,6 +605,11 @@ static iree_status_t iree_io_gguf_parse_metadata(void* user_data,
           IREE_STATUS_INVALID_ARGUMENT,
           "general.alignment metadata value must be uint32");
     }
+    if (!iree_is_power_of_two_uint64(kv->value.uint32)) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "general.alignment %u must be a power of two", kv->value.uint32);
+    }
     parser->alignment = kv->value.uint32;
   }
   return iree_ok_status();
@@ -634,10 +639,27 @@ static iree_status_t iree_io_gguf_append_tensor_info(
                             begin, end, parser->tensor_data_size);
   }
 
+  // Describe the tensor so that consumers can interpret the storage without
+  // needing to parse the file again.
+  if (tensor_info->n_dimensions > IREE_IO_GGUF_MAX_DIMS) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "tensor `%.*s` has %u dimensions (max %d)",
+                            (int)tensor_info->name.size,
+                            tensor_info->name.data, tensor_info->n_dimensions,
+                            IREE_IO_GGUF_MAX_DIMS);
+  }
+  iree_io_gguf_tensor_metadata_t metadata;
+  memset(&metadata, 0, sizeof(metadata));
+  metadata.magic = IREE_IO_GGUF_TENSOR_METADATA_MAGIC;
+  metadata.type = tensor_info->type;
+  metadata.dimension_count = tensor_info->n_dimensions;
+  memcpy(metadata.dimensions, tensor_info->dimensions,
+         tensor_info->n_dimensions * sizeof(metadata.dimensions[0]));
+
   // Add entry to the index.
   iree_io_parameter_index_entry_t entry = {
       .key = tensor_info->name,
-      .metadata = iree_const_byte_span_empty(),
+      .metadata = iree_make_const_byte_span(&metadata, sizeof(metadata)),
       .length = storage_size,
       .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
       .storage =
@@ -646,6 +668,11 @@ static iree_status_t iree_io_gguf_append_tensor_info(
                   {
                       .handle = parser->file_handle,
                       .offset = parser->tensor_data_offset + begin,
+                      // Tensor data is aligned to the file alignment unless
+                      // the file is malformed.
+                      .alignment = iree_io_parameter_offset_alignment(
+                          parser->tensor_data_offset + begin,
+                          parser->alignment),
                   },
           },
   };
@@ -750,3 +777,21 @@ IREE_API_EXPORT iree_status_t iree_io_parse_gguf_index(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+IREE_API_EXPORT bool iree_io_gguf_tensor_metadata_get(
+    const iree_io_parameter_index_entry_t* entry,
+    iree_io_gguf_tensor_metadata_t* out_metadata) {
+  IREE_ASSERT_ARGUMENT(entry);
+  IREE_ASSERT_ARGUMENT(out_metadata);
+  memset(out_metadata, 0, sizeof(*out_metadata));
+  // Metadata storage in the index has no alignment guarantees so we copy it.
+  if (entry->metadata.data_length != sizeof(*out_metadata)) return false;
+  iree_io_gguf_tensor_metadata_t metadata;
+  memcpy(&metadata, entry->metadata.data, sizeof(metadata));
+  if (metadata.magic != IREE_IO_GGUF_TENSOR_METADATA_MAGIC ||
+      metadata.dimension_count > IREE_IO_GGUF_MAX_DIMS) {
+    return false;
+  }
+  *out_metadata = metadata;
+  return true;
+}
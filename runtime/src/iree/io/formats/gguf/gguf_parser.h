@@ -15,13 +15,54 @@
 extern "C" {
 #endif  // __cplusplus
 
+// Element types of GGUF tensors as stored in the file (`ggml_type`).
+// Only the subset of types with stable layouts across producers is listed.
+enum iree_io_gguf_tensor_type_e {
+  IREE_IO_GGUF_TENSOR_TYPE_F32 = 0,
+  IREE_IO_GGUF_TENSOR_TYPE_F16 = 1,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_0 = 2,
+  IREE_IO_GGUF_TENSOR_TYPE_Q4_1 = 3,
+  IREE_IO_GGUF_TENSOR_TYPE_Q8_0 = 8,
+  IREE_IO_GGUF_TENSOR_TYPE_I8 = 16,
+  IREE_IO_GGUF_TENSOR_TYPE_I16 = 17,
+  IREE_IO_GGUF_TENSOR_TYPE_I32 = 18,
+};
+typedef uint32_t iree_io_gguf_tensor_type_t;
+
+// Magic identifying iree_io_gguf_tensor_metadata_t in entry metadata: 'GGTI'.
+#define IREE_IO_GGUF_TENSOR_METADATA_MAGIC 0x49544747u
+
+// Maximum number of dimensions of a GGUF tensor.
+#define IREE_IO_GGUF_MAX_DIMS 4
+
+// Describes a GGUF tensor. Stored as the metadata of each parameter index entry
+// produced by iree_io_parse_gguf_index.
+typedef struct iree_io_gguf_tensor_metadata_t {
+  // IREE_IO_GGUF_TENSOR_METADATA_MAGIC.
+  uint32_t magic;
+  // Element type of the tensor storage.
+  iree_io_gguf_tensor_type_t type;
+  // Number of valid dimensions in |dimensions|.
+  uint32_t dimension_count;
+  uint32_t reserved;
+  // Dimensions of the tensor ordered innermost (contiguous) first as in ggml.
+  uint64_t dimensions[IREE_IO_GGUF_MAX_DIMS];
+} iree_io_gguf_tensor_metadata_t;
+
 // Parses a .gguf file and merges its contained resources into |index|.
+// Each entry has an iree_io_gguf_tensor_metadata_t as its metadata.
 //
 // Specification:
 // https://github.com/ggerganov/ggml/blob/master/docs/gguf.md
 IREE_API_EXPORT iree_status_t iree_io_parse_gguf_index(
     iree_io_file_handle_t* file_handle, iree_io_parameter_index_t* index);
 
+// Returns true and copies the tensor description of |entry| to |out_metadata|
+// if the entry was produced by iree_io_parse_gguf_index.
+IREE_API_EXPORT bool iree_io_gguf_tensor_metadata_get(
+    const iree_io_parameter_index_entry_t* entry,
+    iree_io_gguf_tensor_metadata_t* out_metadata);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -6,6 +6,9 @@
 
 #include "iree/io/formats/gguf/gguf_parser.h"
 
+#include <cstdint>
+#include <vector>
+
 #include "iree/io/formats/gguf/testdata/gguf_files.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -32,6 +35,16 @@ static iree_io_file_handle_t* OpenTestFile(const char* name) {
   return NULL;
 }
 
+// Returns the dimensions of |entry| after verifying it is an f32 tensor.
+static std::vector<uint64_t> GetF32Dimensions(
+    const iree_io_parameter_index_entry_t* entry) {
+  iree_io_gguf_tensor_metadata_t metadata;
+  EXPECT_TRUE(iree_io_gguf_tensor_metadata_get(entry, &metadata));
+  EXPECT_EQ(metadata.type, IREE_IO_GGUF_TENSOR_TYPE_F32);
+  return std::vector<uint64_t>(metadata.dimensions,
+                               metadata.dimensions + metadata.dimension_count);
+}
+
 TEST(GgufFormatTest, Empty) {
   iree_io_parameter_index_t* index = NULL;
   IREE_ASSERT_OK(
@@ -57,8 +70,9 @@ TEST(GgufFormatTest, SingleTensor) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor0"), &entry0));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor0"), entry0->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
+  EXPECT_EQ(GetF32Dimensions(entry0), (std::vector<uint64_t>{2, 2}));
   EXPECT_EQ(entry0->storage.file.offset, 384);
+  EXPECT_EQ(entry0->storage.file.alignment, 64);
   EXPECT_EQ(entry0->length, 16);
 
   iree_io_parameter_index_release(index);
@@ -77,24 +91,27 @@ TEST(GgufFormatTest, MultipleTensors) {
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor0"), &entry0));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor0"), entry0->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
+  EXPECT_EQ(GetF32Dimensions(entry0), (std::vector<uint64_t>{2, 2}));
   EXPECT_EQ(entry0->storage.file.offset, 448);
+  EXPECT_EQ(entry0->storage.file.alignment, 64);
   EXPECT_EQ(entry0->length, 16);
 
   const iree_io_parameter_index_entry_t* entry1 = NULL;
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor1"), &entry1));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor1"), entry1->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry1->metadata));
+  EXPECT_EQ(GetF32Dimensions(entry1), (std::vector<uint64_t>{2, 1}));
   EXPECT_EQ(entry1->storage.file.offset, 512);
+  EXPECT_EQ(entry1->storage.file.alignment, 64);
   EXPECT_EQ(entry1->length, 8);
 
   const iree_io_parameter_index_entry_t* entry2 = NULL;
   IREE_ASSERT_OK(
       iree_io_parameter_index_lookup(index, IREE_SV("tensor2"), &entry2));
   EXPECT_TRUE(iree_string_view_equal(IREE_SV("tensor2"), entry2->key));
-  EXPECT_TRUE(iree_const_byte_span_is_empty(entry2->metadata));
+  EXPECT_EQ(GetF32Dimensions(entry2), (std::vector<uint64_t>{3, 4}));
   EXPECT_EQ(entry2->storage.file.offset, 576);
+  EXPECT_EQ(entry2->storage.file.alignment, 64);
   EXPECT_EQ(entry2->length, 48);
 
   iree_io_parameter_index_release(index);
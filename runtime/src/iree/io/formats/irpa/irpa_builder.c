@@ -184,10 +184,43 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_write(
         };
         target_entry.storage.file.handle = file_handle;
         target_entry.storage.file.offset += storage_segment.offset;
+        target_entry.storage.file.alignment =
+            iree_io_parameter_offset_alignment(
+                target_entry.storage.file.offset,
+                IREE_IO_PARAMETER_ALIAS_ALIGNMENT);
         IREE_RETURN_AND_END_ZONE_IF_ERROR(
             z0, iree_io_stream_write(stream, sizeof(data_entry), &data_entry));
         break;
       }
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED: {
+        iree_io_parameter_archive_compressed_entry_t compressed_entry = {
+            .header =
+                {
+                    .entry_size = sizeof(compressed_entry),
+                    .type = IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED,
+                    .flags = 0,
+                    .name = name_ref,
+                    .metadata = metadata_ref,
+                    .minimum_alignment =
+                        IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+                },
+            .length = target_entry.length,
+            .chunk_length = target_entry.storage.compressed.chunk_length,
+            .compression_type =
+                target_entry.storage.compressed.compression_type,
+            .storage =
+                {
+                    .offset = target_entry.storage.compressed.offset,
+                    .length = target_entry.storage.compressed.storage_length,
+                },
+        };
+        target_entry.storage.compressed.handle = file_handle;
+        target_entry.storage.compressed.offset += storage_segment.offset;
+        IREE_RETURN_AND_END_ZONE_IF_ERROR(
+            z0, iree_io_stream_write(stream, sizeof(compressed_entry),
+                                     &compressed_entry));
+        break;
+      }
       default: {
         IREE_RETURN_AND_END_ZONE_IF_ERROR(
             z0, iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -303,25 +336,266 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_data_entry(
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_archive_builder_add_compressed_entry(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
+    iree_io_compression_type_t compression_type,
+    iree_io_physical_size_t chunk_length, iree_io_physical_size_t data_length,
+    iree_io_physical_size_t storage_length) {
+  IREE_ASSERT_ARGUMENT(builder);
+  if (chunk_length == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "compressed entry chunk length must be non-zero");
+  }
+  if (storage_length < iree_io_chunked_payload_table_size(
+                           iree_io_chunked_payload_chunk_count(data_length,
+                                                               chunk_length))) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "compressed entry storage of %" PRIu64
+                            " bytes too small for its chunk table",
+                            storage_length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, name.data, name.size);
+  iree_io_parameter_index_entry_t entry = {
+      .key = name,
+      .metadata = metadata,
+      .length = data_length,
+      .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED,
+      .storage =
+          {
+              .compressed =
+                  {
+                      .handle = NULL,  // set on commit
+                      .offset = iree_align_uint64(builder->storage_segment_size,
+                                                  minimum_alignment),
+                      .storage_length = storage_length,
+                      .chunk_length = chunk_length,
+                      .compression_type = compression_type,
+                  },
+          },
+  };
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_parameter_index_add(builder->index, &entry));
+  builder->entry_segment_size =
+      iree_align_uint64(builder->entry_segment_size,
+                        IREE_IO_PARAMETER_ARCHIVE_ENTRY_ALIGNMENT) +
+      sizeof(iree_io_parameter_archive_compressed_entry_t);
+  builder->metadata_segment_size += name.size + metadata.data_length;
+  builder->storage_segment_size =
+      entry.storage.compressed.offset + storage_length;
+  if (!builder->storage_alignment) {
+    // First entry sets the base alignment.
+    builder->storage_alignment = minimum_alignment;
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT void iree_io_parameter_archive_build_options_initialize(
+    iree_io_parameter_archive_build_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->compression_type = IREE_IO_COMPRESSION_TYPE_NONE;
+  out_options->chunk_length = IREE_IO_COMPRESSION_DEFAULT_CHUNK_LENGTH;
+}
+
+// Scratch memory used to compress parameters one chunk at a time.
+typedef struct iree_io_parameter_archive_compressor_t {
+  iree_io_compression_type_t compression_type;
+  iree_io_physical_size_t chunk_length;
+  // Uncompressed contents of the current chunk.
+  uint8_t* source_chunk;
+  // Stored contents of the current chunk.
+  uint8_t* target_chunk;
+} iree_io_parameter_archive_compressor_t;
+
+// Reads chunk |chunk_index| of |source_entry| from |source_stream| and
+// compresses it into the compressor target chunk.
+static iree_status_t iree_io_parameter_archive_compressor_compress_chunk(
+    iree_io_parameter_archive_compressor_t* compressor,
+    const iree_io_parameter_index_entry_t* source_entry,
+    iree_io_stream_t* source_stream, uint64_t chunk_index,
+    iree_host_size_t* out_stored_length) {
+  const iree_host_size_t chunk_length = (iree_host_size_t)iree_min(
+      compressor->chunk_length,
+      source_entry->length - chunk_index * compressor->chunk_length);
+  IREE_RETURN_IF_ERROR(iree_io_stream_read(source_stream, chunk_length,
+                                           compressor->source_chunk,
+                                           /*out_buffer_length=*/NULL));
+  return iree_io_compress_chunk(
+      compressor->compression_type,
+      iree_make_const_byte_span(compressor->source_chunk, chunk_length),
+      iree_make_byte_span(compressor->target_chunk, chunk_length),
+      out_stored_length);
+}
+
+// Compresses the file-backed |source_entry| and returns its chunk table in
+// |out_chunk_offsets| (which must be freed by the caller) or NULL if the
+// parameter does not get smaller when compressed.
+static iree_status_t iree_io_parameter_archive_compressor_measure(
+    iree_io_parameter_archive_compressor_t* compressor,
+    const iree_io_parameter_index_entry_t* source_entry,
+    iree_allocator_t host_allocator, uint64_t** out_chunk_offsets) {
+  *out_chunk_offsets = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, source_entry->key.data,
+                              source_entry->key.size);
+
+  const uint64_t chunk_count = iree_io_chunked_payload_chunk_count(
+      source_entry->length, compressor->chunk_length);
+  uint64_t* chunk_offsets = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              host_allocator,
+              (iree_host_size_t)iree_io_chunked_payload_table_size(chunk_count),
+              (void**)&chunk_offsets));
+
+  iree_io_stream_t* source_stream = NULL;
+  iree_status_t status = iree_io_stream_open(
+      IREE_IO_STREAM_MODE_READABLE, source_entry->storage.file.handle,
+      source_entry->storage.file.offset, host_allocator, &source_stream);
+  uint64_t offset = iree_io_chunked_payload_table_size(chunk_count);
+  for (uint64_t i = 0; i < chunk_count && iree_status_is_ok(status); ++i) {
+    chunk_offsets[i] = offset;
+    iree_host_size_t stored_length = 0;
+    status = iree_io_parameter_archive_compressor_compress_chunk(
+        compressor, source_entry, source_stream, i, &stored_length);
+    offset += stored_length;
+  }
+  chunk_offsets[chunk_count] = offset;
+  iree_io_stream_release(source_stream);
+
+  // Only keep the compressed form if it saves space.
+  if (iree_status_is_ok(status) && offset < source_entry->length) {
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, offset);
+    *out_chunk_offsets = chunk_offsets;
+  } else {
+    iree_allocator_free(host_allocator, chunk_offsets);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Writes the compressed payload of |source_entry| with the |chunk_offsets|
+// produced by iree_io_parameter_archive_compressor_measure to |target_stream|.
+static iree_status_t iree_io_parameter_archive_compressor_write(
+    iree_io_parameter_archive_compressor_t* compressor,
+    const iree_io_parameter_index_entry_t* source_entry,
+    const uint64_t* chunk_offsets, iree_io_stream_t* target_stream,
+    iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, source_entry->key.data,
+                              source_entry->key.size);
+
+  const uint64_t chunk_count = iree_io_chunked_payload_chunk_count(
+      source_entry->length, compressor->chunk_length);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_io_stream_write(
+          target_stream,
+          (iree_host_size_t)iree_io_chunked_payload_table_size(chunk_count),
+          chunk_offsets));
+
+  iree_io_stream_t* source_stream = NULL;
+  iree_status_t status = iree_io_stream_open(
+      IREE_IO_STREAM_MODE_READABLE, source_entry->storage.file.handle,
+      source_entry->storage.file.offset, host_allocator, &source_stream);
+  for (uint64_t i = 0; i < chunk_count && iree_status_is_ok(status); ++i) {
+    iree_host_size_t stored_length = 0;
+    status = iree_io_parameter_archive_compressor_compress_chunk(
+        compressor, source_entry, source_stream, i, &stored_length);
+    // Compression is deterministic so this only fails if the source changed
+    // while the archive was being built.
+    if (iree_status_is_ok(status) &&
+        stored_length != chunk_offsets[i + 1] - chunk_offsets[i]) {
+      status = iree_make_status(
+          IREE_STATUS_ABORTED,
+          "parameter `%.*s` chunk %" PRIu64
+          " changed size while building the archive; source modified?",
+          (int)source_entry->key.size, source_entry->key.data, i);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_io_stream_write(target_stream, stored_length,
+                                    compressor->target_chunk);
+    }
+  }
+  iree_io_stream_release(source_stream);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
     iree_io_parameter_index_t* source_index,
     iree_io_parameter_index_t* target_index,
     iree_io_parameter_archive_file_open_callback_t target_file_open,
     iree_io_physical_offset_t target_file_offset,
     iree_allocator_t host_allocator) {
+  iree_io_parameter_archive_build_options_t options;
+  iree_io_parameter_archive_build_options_initialize(&options);
+  return iree_io_build_parameter_archive_with_options(
+      source_index, target_index, target_file_open, target_file_offset,
+      &options, host_allocator);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive_with_options(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    const iree_io_parameter_archive_build_options_t* options,
+    iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(source_index);
   IREE_ASSERT_ARGUMENT(target_index);
   IREE_ASSERT_ARGUMENT(target_file_open.fn);
+  IREE_ASSERT_ARGUMENT(options);
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_io_parameter_archive_builder_t builder;
   iree_io_parameter_archive_builder_initialize(host_allocator, &builder);
 
+  // When compressing we track the chunk table of each compressed parameter
+  // between sizing and writing the archive. Chunk scratch memory is reused for
+  // all parameters.
+  const iree_host_size_t source_count =
+      iree_io_parameter_index_count(source_index);
+  iree_io_parameter_archive_compressor_t compressor = {
+      .compression_type = options->compression_type,
+      .chunk_length = options->chunk_length
+                          ? options->chunk_length
+                          : IREE_IO_COMPRESSION_DEFAULT_CHUNK_LENGTH,
+  };
+  uint64_t** chunk_tables = NULL;
+  iree_status_t status = iree_ok_status();
+  if (options->compression_type != IREE_IO_COMPRESSION_TYPE_NONE) {
+    if (compressor.chunk_length > IREE_HOST_SIZE_MAX / 2) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "compression chunk length %" PRIu64
+                                " too large",
+                                compressor.chunk_length);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_allocator_malloc(
+          host_allocator, source_count * sizeof(chunk_tables[0]),
+          (void**)&chunk_tables);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_allocator_malloc(
+          host_allocator, (iree_host_size_t)compressor.chunk_length * 2,
+          (void**)&compressor.source_chunk);
+    }
+    if (iree_status_is_ok(status)) {
+      compressor.target_chunk =
+          compressor.source_chunk + compressor.chunk_length;
+    }
+  }
+
   // Declare a parameter for each entry in the index.
   // This lets us calculate the size we require to store the entry metadata and
-  // its contents (if any). No data is accessed yet.
-  iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < iree_io_parameter_index_count(source_index);
+  // its contents (if any). Contents are only accessed when compressing.
+  for (iree_host_size_t i = 0; i < source_count && iree_status_is_ok(status);
        ++i) {
     const iree_io_parameter_index_entry_t* source_entry = NULL;
     status = iree_io_parameter_index_get(source_index, i, &source_entry);
@@ -334,10 +608,35 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
             source_entry->storage.splat.pattern_length, source_entry->length);
         break;
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
-        status = iree_io_parameter_archive_builder_add_data_entry(
+        if (chunk_tables && source_entry->length > 0) {
+          status = iree_io_parameter_archive_compressor_measure(
+              &compressor, source_entry, host_allocator, &chunk_tables[i]);
+          if (!iree_status_is_ok(status)) break;
+        }
+        if (chunk_tables && chunk_tables[i]) {
+          const uint64_t chunk_count = iree_io_chunked_payload_chunk_count(
+              source_entry->length, compressor.chunk_length);
+          status = iree_io_parameter_archive_builder_add_compressed_entry(
+              &builder, source_entry->key, source_entry->metadata,
+              IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+              compressor.compression_type, compressor.chunk_length,
+              source_entry->length, chunk_tables[i][chunk_count]);
+        } else {
+          status = iree_io_parameter_archive_builder_add_data_entry(
+              &builder, source_entry->key, source_entry->metadata,
+              IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
+              source_entry->length);
+        }
+        break;
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED:
+        // Already compressed payloads are copied verbatim.
+        status = iree_io_parameter_archive_builder_add_compressed_entry(
             &builder, source_entry->key, source_entry->metadata,
             IREE_IO_PARAMETER_ARCHIVE_DEFAULT_DATA_ALIGNMENT,
-            source_entry->length);
+            source_entry->storage.compressed.compression_type,
+            source_entry->storage.compressed.chunk_length,
+            source_entry->length,
+            source_entry->storage.compressed.storage_length);
         break;
       default:
         status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
@@ -393,6 +692,17 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
           // No work to do.
           break;
         case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
+          if (target_entry->type ==
+              IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED) {
+            status = iree_io_stream_seek(
+                target_stream, IREE_IO_STREAM_SEEK_SET,
+                target_file_offset + target_entry->storage.compressed.offset);
+            if (!iree_status_is_ok(status)) break;
+            status = iree_io_parameter_archive_compressor_write(
+                &compressor, source_entry, chunk_tables[i], target_stream,
+                host_allocator);
+            break;
+          }
           status = iree_io_stream_seek(
               target_stream, IREE_IO_STREAM_SEEK_SET,
               target_file_offset + target_entry->storage.file.offset);
@@ -402,6 +712,16 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
               source_entry->storage.file.offset, target_entry->length,
               host_allocator);
           break;
+        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED:
+          status = iree_io_stream_seek(
+              target_stream, IREE_IO_STREAM_SEEK_SET,
+              target_file_offset + target_entry->storage.compressed.offset);
+          if (!iree_status_is_ok(status)) break;
+          status = iree_io_stream_write_file(
+              target_stream, source_entry->storage.compressed.handle,
+              source_entry->storage.compressed.offset,
+              source_entry->storage.compressed.storage_length, host_allocator);
+          break;
         default:
           status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                                     "unhandled index entry storage type %d",
@@ -422,6 +742,13 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
 
   iree_io_file_handle_release(target_file_handle);
   iree_io_parameter_archive_builder_deinitialize(&builder);
+  if (chunk_tables) {
+    for (iree_host_size_t i = 0; i < source_count; ++i) {
+      iree_allocator_free(host_allocator, chunk_tables[i]);
+    }
+    iree_allocator_free(host_allocator, chunk_tables);
+  }
+  iree_allocator_free(host_allocator, compressor.source_chunk);
 
   IREE_TRACE_ZONE_END(z0);
   return status;
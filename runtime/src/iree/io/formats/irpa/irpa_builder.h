@@ -8,6 +8,7 @@
 #define IREE_IO_FORMATS_IRPA_IRPA_BUILDER_H_
 
 #include "iree/base/api.h"
+#include "iree/io/compression.h"
 #include "iree/io/file_handle.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/stream.h"
@@ -92,6 +93,20 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_archive_builder_add_data_entry(
     iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
     iree_io_physical_size_t data_length);
 
+// Adds a new compressed entry to |builder|.
+// |metadata| (if provided) is copied prior to returning.
+// Physical storage will be allocated for the |storage_length| byte chunked
+// payload (see iree/io/compression.h) holding |data_length| uncompressed bytes
+// split into chunks of |chunk_length| and it will be aligned to at least
+// |minimum_alignment|. Callers are responsible for writing the payload.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_archive_builder_add_compressed_entry(
+    iree_io_parameter_archive_builder_t* builder, iree_string_view_t name,
+    iree_const_byte_span_t metadata, iree_io_physical_size_t minimum_alignment,
+    iree_io_compression_type_t compression_type,
+    iree_io_physical_size_t chunk_length, iree_io_physical_size_t data_length,
+    iree_io_physical_size_t storage_length);
+
 // Callback for opening a file for writing.
 // Implementations need to ensure that at least |archive_length| bytes are
 // available in the file starting at |archive_offset|.
@@ -108,6 +123,22 @@ typedef struct {
   void* user_data;
 } iree_io_parameter_archive_file_open_callback_t;
 
+// Options controlling how parameter archives are built.
+typedef struct iree_io_parameter_archive_build_options_t {
+  // Compression applied to parameters with file storage or
+  // IREE_IO_COMPRESSION_TYPE_NONE to store them as-is. Parameters that do not
+  // get smaller when compressed are stored as-is.
+  iree_io_compression_type_t compression_type;
+  // Uncompressed length of each compressed chunk or 0 to use
+  // IREE_IO_COMPRESSION_DEFAULT_CHUNK_LENGTH. Smaller chunks allow finer
+  // grained partial reads and more parallelism at the cost of ratio.
+  iree_io_physical_size_t chunk_length;
+} iree_io_parameter_archive_build_options_t;
+
+// Initializes |out_options| to the default values.
+IREE_API_EXPORT void iree_io_parameter_archive_build_options_initialize(
+    iree_io_parameter_archive_build_options_t* out_options);
+
 // Builds a parameter archive from the given |source_index| and returns a new
 // index in |target_index| referencing the new archive file.
 // The total size of the archive will be calculated and the provided
@@ -121,6 +152,20 @@ IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive(
     iree_io_physical_offset_t target_file_offset,
     iree_allocator_t host_allocator);
 
+// Builds a parameter archive with the given |options|.
+// See iree_io_build_parameter_archive.
+//
+// When compressing each parameter is compressed twice: once to size the archive
+// and again while writing it. This keeps memory usage bounded by the chunk
+// length regardless of how large the parameters are.
+IREE_API_EXPORT iree_status_t iree_io_build_parameter_archive_with_options(
+    iree_io_parameter_index_t* source_index,
+    iree_io_parameter_index_t* target_index,
+    iree_io_parameter_archive_file_open_callback_t target_file_open,
+    iree_io_physical_offset_t target_file_offset,
+    const iree_io_parameter_archive_build_options_t* options,
+    iree_allocator_t host_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -148,6 +148,71 @@ static iree_status_t iree_io_parse_irpa_v0_data_entry(
                   {
                       .handle = file_handle,
                       .offset = storage_offset,
+                      .alignment = iree_io_parameter_offset_alignment(
+                          storage_offset, IREE_IO_PARAMETER_ALIAS_ALIGNMENT),
+                  },
+          },
+  };
+  return iree_io_parameter_index_add(index, &entry);
+}
+
+static iree_status_t iree_io_parse_irpa_v0_compressed_entry(
+    iree_io_file_handle_t* file_handle, iree_const_byte_span_t file_contents,
+    iree_io_physical_offset_t base_offset,
+    const iree_io_parameter_archive_header_v0_t* header,
+    const iree_io_parameter_archive_compressed_entry_t* compressed_entry,
+    iree_string_view_t name, iree_const_byte_span_t metadata,
+    iree_io_parameter_index_t* index) {
+  if (compressed_entry->header.entry_size < sizeof(*compressed_entry)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "compressed entry length underflow");
+  }
+  switch (compressed_entry->compression_type) {
+    case IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_TYPE_NONE:
+    case IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_TYPE_LZ4:
+    case IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_TYPE_ZSTD:
+      break;
+    default:
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "parser does not support compression type %u",
+                              compressed_entry->compression_type);
+  }
+  if (compressed_entry->chunk_length == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "compressed entry chunk length must be non-zero");
+  }
+
+  // The chunk table must fit in the storage. Chunk offsets in the table are
+  // validated as chunks are read.
+  const uint64_t chunk_count = iree_io_chunked_payload_chunk_count(
+      compressed_entry->length, compressed_entry->chunk_length);
+  if (iree_io_chunked_payload_table_size(chunk_count) >
+      compressed_entry->storage.length) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE,
+        "compressed entry storage of %" PRIu64
+        " bytes too small for a chunk table of %" PRIu64 " chunks",
+        compressed_entry->storage.length, chunk_count);
+  }
+  iree_io_physical_offset_t storage_offset = 0;
+  IREE_RETURN_IF_ERROR(iree_io_resolve_irpa_v0_storage(
+      file_contents, base_offset, header, compressed_entry->storage,
+      &storage_offset));
+
+  iree_io_parameter_index_entry_t entry = {
+      .key = name,
+      .metadata = metadata,
+      .length = compressed_entry->length,
+      .type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED,
+      .storage =
+          {
+              .compressed =
+                  {
+                      .handle = file_handle,
+                      .offset = storage_offset,
+                      .storage_length = compressed_entry->storage.length,
+                      .chunk_length = compressed_entry->chunk_length,
+                      .compression_type = compressed_entry->compression_type,
                   },
           },
   };
@@ -250,6 +315,13 @@ static iree_status_t iree_io_parse_irpa_v0_index_from_memory(
             metadata, index));
         break;
       }
+      case IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED: {
+        IREE_RETURN_IF_ERROR(iree_io_parse_irpa_v0_compressed_entry(
+            file_handle, file_contents, base_offset, header,
+            (const iree_io_parameter_archive_compressed_entry_t*)entry_header,
+            name, metadata, index));
+        break;
+      }
       default:
         return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
                                 "parser does not support entry type %d",
@@ -62,6 +62,7 @@ TEST(IrpaFormatTest, SingleParameters) {
   EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
   EXPECT_EQ(entry0->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
   EXPECT_EQ(entry0->storage.file.offset, 192);
+  EXPECT_EQ(entry0->storage.file.alignment, 64);
   EXPECT_EQ(entry0->length, 16);
 
   iree_io_parameter_index_release(index);
@@ -84,6 +85,7 @@ TEST(IrpaFormatTest, MultipleParameters) {
   EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
   EXPECT_EQ(entry0->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
   EXPECT_EQ(entry0->storage.file.offset, 320);
+  EXPECT_EQ(entry0->storage.file.alignment, 64);
   EXPECT_EQ(entry0->length, 16);
 
   const iree_io_parameter_index_entry_t* entry1 = NULL;
@@ -93,6 +95,7 @@ TEST(IrpaFormatTest, MultipleParameters) {
   EXPECT_TRUE(iree_const_byte_span_is_empty(entry1->metadata));
   EXPECT_EQ(entry1->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
   EXPECT_EQ(entry1->storage.file.offset, 384);
+  EXPECT_EQ(entry1->storage.file.alignment, 64);
   EXPECT_EQ(entry1->length, 5);
 
   iree_io_parameter_index_release(index);
@@ -115,6 +118,7 @@ TEST(IrpaFormatTest, MixedDataAndSplats) {
   EXPECT_TRUE(iree_const_byte_span_is_empty(entry0->metadata));
   EXPECT_EQ(entry0->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
   EXPECT_EQ(entry0->storage.file.offset, 512);
+  EXPECT_EQ(entry0->storage.file.alignment, 64);
   EXPECT_EQ(entry0->length, 16);
 
   const iree_io_parameter_index_entry_t* entry1 = NULL;
@@ -124,6 +128,7 @@ TEST(IrpaFormatTest, MixedDataAndSplats) {
   EXPECT_TRUE(iree_const_byte_span_is_empty(entry1->metadata));
   EXPECT_EQ(entry1->type, IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE);
   EXPECT_EQ(entry1->storage.file.offset, 576);
+  EXPECT_EQ(entry1->storage.file.alignment, 64);
   EXPECT_EQ(entry1->length, 5);
 
   const iree_io_parameter_index_entry_t* entry2 = NULL;
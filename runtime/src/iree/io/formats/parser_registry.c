@@ -6,7 +6,10 @@
 
 #include "iree/io/formats/parser_registry.h"
 
+#include "iree/base/internal/atomics.h"
 #include "iree/base/internal/path.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
 #include "iree/io/formats/gguf/gguf_parser.h"
 #include "iree/io/formats/irpa/irpa_parser.h"
 #include "iree/io/formats/safetensors/safetensors_parser.h"
@@ -44,3 +47,303 @@ IREE_API_EXPORT iree_status_t iree_io_parse_file_index(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// Parallel file parsing
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_io_parse_file_indices_state_t {
+  iree_host_size_t path_count;
+  const iree_string_view_t* paths;
+  iree_io_parameter_file_open_callback_t file_open;
+  iree_allocator_t host_allocator;
+  // Ordinal of the next file to be claimed by a worker.
+  iree_atomic_int32_t next_ordinal;
+  // Set when any file fails to parse so workers stop claiming new files.
+  iree_atomic_int32_t failed;
+  // Number of workers that have finished claiming files.
+  iree_atomic_int32_t exited_count;
+  // Posted each time a worker finishes.
+  iree_notification_t exit_notification;
+  // Per-file indices populated by whichever worker claimed the file.
+  iree_io_parameter_index_t** file_indices;
+  // Per-file parse results.
+  iree_status_t* file_statuses;
+} iree_io_parse_file_indices_state_t;
+
+// Opens and parses the file at |ordinal| into its own index.
+static iree_status_t iree_io_parse_file_indices_parse_one(
+    iree_io_parse_file_indices_state_t* state, iree_host_size_t ordinal) {
+  iree_string_view_t path = state->paths[ordinal];
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
+
+  iree_io_parameter_index_t* file_index = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_parameter_index_create(state->host_allocator, &file_index));
+  state->file_indices[ordinal] = file_index;
+
+  iree_io_file_handle_t* file_handle = NULL;
+  iree_status_t status = state->file_open.fn(state->file_open.user_data, path,
+                                             &file_handle);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parse_file_index(path, file_handle, file_index);
+  }
+  iree_io_file_handle_release(file_handle);
+  if (!iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(status, "parsing parameter file `%.*s`",
+                                    (int)path.size, path.data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Claims and parses files until all have been claimed or any has failed.
+static int iree_io_parse_file_indices_worker_main(void* arg) {
+  iree_io_parse_file_indices_state_t* state =
+      (iree_io_parse_file_indices_state_t*)arg;
+  while (!iree_atomic_load_int32(&state->failed, iree_memory_order_acquire)) {
+    iree_host_size_t ordinal = (iree_host_size_t)iree_atomic_fetch_add_int32(
+        &state->next_ordinal, 1, iree_memory_order_relaxed);
+    if (ordinal >= state->path_count) break;
+    iree_status_t status =
+        iree_io_parse_file_indices_parse_one(state, ordinal);
+    state->file_statuses[ordinal] = status;
+    if (!iree_status_is_ok(status)) {
+      iree_atomic_store_int32(&state->failed, 1, iree_memory_order_release);
+    }
+  }
+  iree_atomic_fetch_add_int32(&state->exited_count, 1,
+                              iree_memory_order_acq_rel);
+  iree_notification_post(&state->exit_notification, IREE_ALL_WAITERS);
+  return 0;
+}
+
+typedef struct iree_io_parse_file_indices_join_t {
+  iree_io_parse_file_indices_state_t* state;
+  int32_t worker_count;
+} iree_io_parse_file_indices_join_t;
+
+static bool iree_io_parse_file_indices_all_exited(void* arg) {
+  iree_io_parse_file_indices_join_t* join =
+      (iree_io_parse_file_indices_join_t*)arg;
+  return iree_atomic_load_int32(&join->state->exited_count,
+                                iree_memory_order_acquire) ==
+         join->worker_count;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parse_file_indices(
+    iree_host_size_t path_count, const iree_string_view_t* paths,
+    iree_io_parameter_file_open_callback_t file_open,
+    iree_host_size_t thread_count, iree_io_parameter_index_t* index,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(!path_count || paths);
+  IREE_ASSERT_ARGUMENT(file_open.fn);
+  IREE_ASSERT_ARGUMENT(index);
+  if (path_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, path_count);
+
+  if (thread_count == 0) {
+    thread_count = IREE_IO_PARSE_FILE_INDICES_DEFAULT_THREAD_COUNT;
+  }
+  thread_count = iree_min(thread_count, path_count);
+
+  iree_io_parse_file_indices_state_t state;
+  memset(&state, 0, sizeof(state));
+  state.path_count = path_count;
+  state.paths = paths;
+  state.file_open = file_open;
+  state.host_allocator = host_allocator;
+  iree_atomic_store_int32(&state.next_ordinal, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.failed, 0, iree_memory_order_relaxed);
+  iree_atomic_store_int32(&state.exited_count, 0, iree_memory_order_relaxed);
+
+  // Allocate per-file state and the worker thread list as one block.
+  iree_thread_t** threads = NULL;
+  iree_host_size_t total_size =
+      path_count * (sizeof(state.file_indices[0]) +
+                    sizeof(state.file_statuses[0])) +
+      (thread_count - 1) * sizeof(threads[0]);
+  uint8_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&storage));
+  iree_notification_initialize(&state.exit_notification);
+  state.file_indices = (iree_io_parameter_index_t**)storage;
+  state.file_statuses =
+      (iree_status_t*)(storage + path_count * sizeof(state.file_indices[0]));
+  threads = (iree_thread_t**)(storage +
+                              path_count * (sizeof(state.file_indices[0]) +
+                                            sizeof(state.file_statuses[0])));
+
+  // Launch helper threads. If a thread fails to launch we continue with those
+  // we have as the calling thread is always able to make progress.
+  iree_host_size_t launched_count = 0;
+  for (iree_host_size_t i = 0; i < thread_count - 1; ++i) {
+    iree_thread_create_params_t params;
+    memset(&params, 0, sizeof(params));
+    params.name = IREE_SV("iree-io-parse");
+    iree_status_t thread_status =
+        iree_thread_create(iree_io_parse_file_indices_worker_main, &state,
+                           params, host_allocator, &threads[i]);
+    if (!iree_status_is_ok(thread_status)) {
+      iree_status_ignore(thread_status);
+      break;
+    }
+    ++launched_count;
+  }
+
+  // Participate in parsing and then join all helpers. Releasing a thread only
+  // joins it once it has started running so we first wait for every worker
+  // (including our own) to finish with the state.
+  iree_io_parse_file_indices_worker_main(&state);
+  iree_io_parse_file_indices_join_t join = {
+      .state = &state,
+      .worker_count = (int32_t)launched_count + 1,
+  };
+  iree_notification_await(&state.exit_notification,
+                          iree_io_parse_file_indices_all_exited, &join,
+                          iree_infinite_timeout());
+  for (iree_host_size_t i = 0; i < launched_count; ++i) {
+    iree_thread_release(threads[i]);
+  }
+
+  // Merge the per-file indices in file order. The first failure (in file
+  // order) is returned and all others are dropped.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < path_count; ++i) {
+    if (iree_status_is_ok(status)) {
+      status = state.file_statuses[i];
+      if (iree_status_is_ok(status) && state.file_indices[i]) {
+        status = iree_io_parameter_index_merge(index, state.file_indices[i]);
+      }
+    } else {
+      iree_status_ignore(state.file_statuses[i]);
+    }
+    iree_io_parameter_index_release(state.file_indices[i]);
+  }
+
+  iree_notification_deinitialize(&state.exit_notification);
+  iree_allocator_free(host_allocator, storage);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Shard manifests
+//===----------------------------------------------------------------------===//
+
+// Returns true if |path| is absolute (or drive-qualified on Windows).
+static bool iree_io_manifest_path_is_absolute(iree_string_view_t path) {
+  if (iree_string_view_starts_with(path, IREE_SV("/")) ||
+      iree_string_view_starts_with(path, IREE_SV("\\"))) {
+    return true;
+  }
+  return path.size >= 2 && path.data[1] == ':';
+}
+
+// Calls |fn| with each shard path listed in |manifest_contents|.
+static iree_status_t iree_io_manifest_enumerate_shards(
+    iree_string_view_t manifest_contents,
+    iree_status_t (*fn)(void* user_data, iree_string_view_t shard_path),
+    void* user_data) {
+  iree_string_view_t remaining = manifest_contents;
+  while (!iree_string_view_is_empty(remaining)) {
+    iree_string_view_t line = iree_string_view_empty();
+    iree_string_view_split(remaining, '\n', &line, &remaining);
+    line = iree_string_view_trim(line);
+    if (iree_string_view_is_empty(line) ||
+        iree_string_view_starts_with(line, IREE_SV("#"))) {
+      continue;
+    }
+    IREE_RETURN_IF_ERROR(fn(user_data, line));
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_manifest_count_shard(void* user_data,
+                                                  iree_string_view_t path) {
+  ++*(iree_host_size_t*)user_data;
+  return iree_ok_status();
+}
+
+typedef struct iree_io_manifest_resolve_state_t {
+  iree_string_view_t base_path;
+  iree_allocator_t host_allocator;
+  iree_host_size_t count;
+  iree_string_view_t* paths;
+  // Joined path storage for each relative path or NULL if absolute.
+  char** joined_paths;
+} iree_io_manifest_resolve_state_t;
+
+static iree_status_t iree_io_manifest_resolve_shard(void* user_data,
+                                                    iree_string_view_t path) {
+  iree_io_manifest_resolve_state_t* state =
+      (iree_io_manifest_resolve_state_t*)user_data;
+  iree_host_size_t i = state->count++;
+  if (iree_string_view_is_empty(state->base_path) ||
+      iree_io_manifest_path_is_absolute(path)) {
+    state->paths[i] = path;
+    return iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(iree_file_path_join(state->base_path, path,
+                                           state->host_allocator,
+                                           &state->joined_paths[i]));
+  state->paths[i] = iree_make_cstring_view(state->joined_paths[i]);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parse_manifest_index(
+    iree_string_view_t manifest_path, iree_string_view_t manifest_contents,
+    iree_io_parameter_file_open_callback_t file_open,
+    iree_host_size_t thread_count, iree_io_parameter_index_t* index,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(file_open.fn);
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, manifest_path.data, manifest_path.size);
+
+  // Count the shards so we can allocate the path list in one go.
+  iree_host_size_t shard_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_manifest_enumerate_shards(
+              manifest_contents, iree_io_manifest_count_shard, &shard_count));
+  if (shard_count == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  iree_io_manifest_resolve_state_t state = {
+      .base_path = iree_file_path_dirname(manifest_path),
+      .host_allocator = host_allocator,
+      .count = 0,
+      .paths = NULL,
+      .joined_paths = NULL,
+  };
+  uint8_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              host_allocator,
+              shard_count * (sizeof(state.paths[0]) +
+                             sizeof(state.joined_paths[0])),
+              (void**)&storage));
+  state.paths = (iree_string_view_t*)storage;
+  state.joined_paths =
+      (char**)(storage + shard_count * sizeof(state.paths[0]));
+
+  // Resolve all shard paths relative to the manifest and parse them.
+  iree_status_t status = iree_io_manifest_enumerate_shards(
+      manifest_contents, iree_io_manifest_resolve_shard, &state);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parse_file_indices(shard_count, state.paths, file_open,
+                                        thread_count, index, host_allocator);
+  }
+
+  for (iree_host_size_t i = 0; i < shard_count; ++i) {
+    iree_allocator_free(host_allocator, state.joined_paths[i]);
+  }
+  iree_allocator_free(host_allocator, storage);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -23,6 +23,53 @@ IREE_API_EXPORT iree_status_t iree_io_parse_file_index(
     iree_string_view_t path, iree_io_file_handle_t* file_handle,
     iree_io_parameter_index_t* index);
 
+// Callback for opening a parameter file for reading.
+typedef iree_status_t(IREE_API_PTR* iree_io_parameter_file_open_fn_t)(
+    void* user_data, iree_string_view_t path,
+    iree_io_file_handle_t** out_file_handle);
+
+// A callback issued to open a parameter file.
+typedef struct {
+  // Callback function pointer.
+  iree_io_parameter_file_open_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_io_parameter_file_open_callback_t;
+
+// Default upper bound on the number of threads used to parse parameter files.
+#define IREE_IO_PARSE_FILE_INDICES_DEFAULT_THREAD_COUNT 8
+
+// Opens and parses the parameter files at |paths| using |file_open| and
+// appends their parameters to |index| as with iree_io_parse_file_index.
+// Files are opened and parsed concurrently on up to |thread_count| threads
+// (including the caller; 0 selects a default) but parameters are appended to
+// |index| in the order the files are listed such that lookups of keys defined
+// in multiple files deterministically resolve to the first file.
+//
+// |file_open| must be thread-safe.
+IREE_API_EXPORT iree_status_t iree_io_parse_file_indices(
+    iree_host_size_t path_count, const iree_string_view_t* paths,
+    iree_io_parameter_file_open_callback_t file_open,
+    iree_host_size_t thread_count, iree_io_parameter_index_t* index,
+    iree_allocator_t host_allocator);
+
+// Parses a shard manifest listing parameter files and appends the parameters
+// of all listed files to |index| as with iree_io_parse_file_indices.
+// |manifest_path| is the path of the manifest and relative shard paths are
+// resolved against its directory.
+//
+// The manifest is a text file with one shard path per line. Blank lines and
+// lines beginning with `#` are ignored. Example `model.shards`:
+//   # 3 shards of a checkpoint
+//   model-00001-of-00003.irpa
+//   model-00002-of-00003.irpa
+//   /mnt/other/model-00003-of-00003.safetensors
+IREE_API_EXPORT iree_status_t iree_io_parse_manifest_index(
+    iree_string_view_t manifest_path, iree_string_view_t manifest_contents,
+    iree_io_parameter_file_open_callback_t file_open,
+    iree_host_size_t thread_count, iree_io_parameter_index_t* index,
+    iree_allocator_t host_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
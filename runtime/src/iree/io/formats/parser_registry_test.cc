@@ -0,0 +1,113 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/formats/parser_registry.h"
+
+#include <mutex>
+#include <set>
+#include <string>
+
+#include "iree/base/internal/path.h"
+#include "iree/io/formats/irpa/testdata/irpa_files.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+struct OpenedPaths {
+  std::mutex mutex;
+  std::set<std::string> paths;
+};
+
+// Opens embedded test files by the basename of |path| and records each |path|
+// opened in the OpenedPaths |user_data|.
+static iree_status_t OpenTestFile(void* user_data, iree_string_view_t path,
+                                  iree_io_file_handle_t** out_file_handle) {
+  OpenedPaths* opened_paths = (OpenedPaths*)user_data;
+  {
+    std::lock_guard<std::mutex> lock(opened_paths->mutex);
+    opened_paths->paths.insert(std::string(path.data, path.size));
+  }
+  iree_string_view_t name = iree_file_path_basename(path);
+  const struct iree_file_toc_t* file_toc = iree_io_irpa_files_create();
+  for (size_t i = 0; i < iree_io_irpa_files_size(); ++i) {
+    iree_string_view_t file_name = iree_make_cstring_view(file_toc[i].name);
+    if (iree_string_view_equal(name, file_name)) {
+      return iree_io_file_handle_wrap_host_allocation(
+          IREE_IO_FILE_ACCESS_READ,
+          iree_make_byte_span((void*)file_toc[i].data, file_toc[i].size),
+          iree_io_file_handle_release_callback_null(), iree_allocator_system(),
+          out_file_handle);
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND, "test file `%.*s` not found",
+                          (int)path.size, path.data);
+}
+
+class ParserRegistryTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(
+        iree_io_parameter_index_create(iree_allocator_system(), &index_));
+  }
+
+  void TearDown() override { iree_io_parameter_index_release(index_); }
+
+  iree_status_t ParseManifest(const char* manifest_path, const char* contents,
+                              iree_host_size_t thread_count) {
+    iree_io_parameter_file_open_callback_t file_open = {
+        /*.fn=*/OpenTestFile,
+        /*.user_data=*/&opened_paths_,
+    };
+    return iree_io_parse_manifest_index(
+        iree_make_cstring_view(manifest_path), iree_make_cstring_view(contents),
+        file_open, thread_count, index_, iree_allocator_system());
+  }
+
+  iree_io_parameter_index_t* index_ = NULL;
+  OpenedPaths opened_paths_;
+};
+
+TEST_F(ParserRegistryTest, EmptyManifest) {
+  IREE_ASSERT_OK(ParseManifest("model.shards", "# nothing\n\n", 0));
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 0);
+}
+
+// Tests that shards parsed in parallel are merged in manifest order.
+TEST_F(ParserRegistryTest, ManifestOrder) {
+  IREE_ASSERT_OK(ParseManifest("dir/model.shards",
+                               "# shards\n"
+                               "multiple.irpa\n"
+                               "  single.irpa  \n"
+                               "\n"
+                               "/abs/mixed.irpa",
+                               /*thread_count=*/3));
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 2 + 1 + 4);
+  EXPECT_EQ(opened_paths_.paths,
+            std::set<std::string>({"dir/multiple.irpa", "dir/single.irpa",
+                                   "/abs/mixed.irpa"}));
+
+  // key0 is defined in all files and must resolve to the first shard.
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_lookup(index_, IREE_SV("key0"), &entry));
+  EXPECT_EQ(entry->storage.file.offset, 320);
+  IREE_ASSERT_OK(iree_io_parameter_index_get(index_, 2, &entry));
+  EXPECT_TRUE(iree_string_view_equal(entry->key, IREE_SV("key0")));
+  EXPECT_EQ(entry->storage.file.offset, 192);
+}
+
+TEST_F(ParserRegistryTest, ManifestMissingShard) {
+  EXPECT_THAT(Status(ParseManifest("model.shards",
+                                   "single.irpa\nmissing.irpa\n", 2)),
+              StatusIs(StatusCode::kNotFound));
+}
+
+}  // namespace
+}  // namespace iree
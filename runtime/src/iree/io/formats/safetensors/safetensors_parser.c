@@ -449,6 +449,11 @@ static iree_status_t iree_io_enumerate_safetensors_entries(
                   {
                       .handle = entry_state->file_handle,
                       .offset = entry_state->base_offset + begin,
+                      // The format does not align tensor data so entries
+                      // are only aliasable if they happen to be aligned.
+                      .alignment = iree_io_parameter_offset_alignment(
+                          entry_state->base_offset + begin,
+                          IREE_IO_PARAMETER_ALIAS_ALIGNMENT),
                   },
           },
   };
@@ -0,0 +1,277 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/output_channel.h"
+
+#include "iree/base/internal/synchronization.h"
+
+// Header of each slot in the ring, followed by item_capacity bytes of data.
+typedef struct iree_io_output_channel_slot_t {
+  iree_host_size_t length;
+  uint8_t data[];
+} iree_io_output_channel_slot_t;
+
+struct iree_io_output_channel_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Optional semaphore signaled with the published item count.
+  iree_hal_semaphore_t* semaphore;
+
+  iree_host_size_t slot_count;
+  iree_host_size_t item_capacity;
+  // Stride in bytes between slots in |slot_storage|.
+  iree_host_size_t slot_stride;
+
+  iree_slim_mutex_t mutex;
+  // Posted whenever an item is published or read or the channel is closed.
+  iree_notification_t notification;
+  // Total number of items published.
+  uint64_t write_count IREE_GUARDED_BY(mutex);
+  // Total number of items read.
+  uint64_t read_count IREE_GUARDED_BY(mutex);
+  // Set once no more items will be published.
+  bool closed IREE_GUARDED_BY(mutex);
+
+  // Ring of |slot_count| slots.
+  uint8_t* slot_storage;
+};
+
+static iree_io_output_channel_slot_t* iree_io_output_channel_slot(
+    iree_io_output_channel_t* channel, uint64_t item_index) {
+  return (iree_io_output_channel_slot_t*)(channel->slot_storage +
+                                          (item_index % channel->slot_count) *
+                                              channel->slot_stride);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_output_channel_create(
+    iree_host_size_t slot_count, iree_host_size_t item_capacity,
+    iree_hal_semaphore_t* semaphore, iree_allocator_t host_allocator,
+    iree_io_output_channel_t** out_channel) {
+  IREE_ASSERT_ARGUMENT(out_channel);
+  *out_channel = NULL;
+  if (slot_count == 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "output channels require at least one slot");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, slot_count);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, item_capacity);
+
+  iree_host_size_t slot_stride =
+      iree_host_align(sizeof(iree_io_output_channel_slot_t) + item_capacity,
+                      iree_max_align_t);
+  iree_host_size_t total_size =
+      iree_host_align(sizeof(iree_io_output_channel_t), iree_max_align_t) +
+      slot_count * slot_stride;
+  iree_io_output_channel_t* channel = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&channel));
+  memset(channel, 0, sizeof(*channel));
+  iree_atomic_ref_count_init(&channel->ref_count);
+  channel->host_allocator = host_allocator;
+  channel->semaphore = semaphore;
+  iree_hal_semaphore_retain(semaphore);
+  channel->slot_count = slot_count;
+  channel->item_capacity = item_capacity;
+  channel->slot_stride = slot_stride;
+  iree_slim_mutex_initialize(&channel->mutex);
+  iree_notification_initialize(&channel->notification);
+  channel->slot_storage =
+      (uint8_t*)channel +
+      iree_host_align(sizeof(iree_io_output_channel_t), iree_max_align_t);
+
+  *out_channel = channel;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_output_channel_destroy(iree_io_output_channel_t* channel) {
+  iree_allocator_t host_allocator = channel->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_notification_deinitialize(&channel->notification);
+  iree_slim_mutex_deinitialize(&channel->mutex);
+  iree_hal_semaphore_release(channel->semaphore);
+  iree_allocator_free(host_allocator, channel);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_io_output_channel_retain(
+    iree_io_output_channel_t* channel) {
+  if (IREE_LIKELY(channel)) {
+    iree_atomic_ref_count_inc(&channel->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_output_channel_release(
+    iree_io_output_channel_t* channel) {
+  if (IREE_LIKELY(channel) &&
+      iree_atomic_ref_count_dec(&channel->ref_count) == 1) {
+    iree_io_output_channel_destroy(channel);
+  }
+}
+
+IREE_API_EXPORT iree_host_size_t
+iree_io_output_channel_item_capacity(const iree_io_output_channel_t* channel) {
+  IREE_ASSERT_ARGUMENT(channel);
+  return channel->item_capacity;
+}
+
+IREE_API_EXPORT iree_hal_semaphore_t* iree_io_output_channel_semaphore(
+    const iree_io_output_channel_t* channel) {
+  IREE_ASSERT_ARGUMENT(channel);
+  return channel->semaphore;
+}
+
+// Returns true if a publisher can make progress: either a slot is free or the
+// channel was closed out from under it.
+static bool iree_io_output_channel_can_publish(void* arg) {
+  iree_io_output_channel_t* channel = (iree_io_output_channel_t*)arg;
+  iree_slim_mutex_lock(&channel->mutex);
+  bool can_publish =
+      channel->closed ||
+      channel->write_count - channel->read_count < channel->slot_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+  return can_publish;
+}
+
+// Returns true if a reader can make progress: either an item is available or
+// the channel has been closed.
+static bool iree_io_output_channel_can_read(void* arg) {
+  iree_io_output_channel_t* channel = (iree_io_output_channel_t*)arg;
+  iree_slim_mutex_lock(&channel->mutex);
+  bool can_read =
+      channel->closed || channel->read_count < channel->write_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+  return can_read;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_output_channel_publish(
+    iree_io_output_channel_t* channel, iree_const_byte_span_t contents,
+    iree_timeout_t timeout) {
+  IREE_ASSERT_ARGUMENT(channel);
+  if (contents.data_length > channel->item_capacity) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "item of %" PRIhsz
+                            " bytes exceeds the channel item capacity of "
+                            "%" PRIhsz " bytes",
+                            contents.data_length, channel->item_capacity);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, contents.data_length);
+
+  if (!iree_notification_await(&channel->notification,
+                               iree_io_output_channel_can_publish, channel,
+                               timeout)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+
+  // Only one producer is allowed so the free slot can't be taken between the
+  // wait and here; the consumer only ever frees more slots.
+  iree_slim_mutex_lock(&channel->mutex);
+  if (channel->closed) {
+    iree_slim_mutex_unlock(&channel->mutex);
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "output channel has been closed");
+  }
+  uint64_t item_index = channel->write_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+
+  // Copy outside of the lock so the consumer can read earlier items.
+  iree_io_output_channel_slot_t* slot =
+      iree_io_output_channel_slot(channel, item_index);
+  slot->length = contents.data_length;
+  if (contents.data_length > 0) {
+    memcpy(slot->data, contents.data, contents.data_length);
+  }
+
+  iree_slim_mutex_lock(&channel->mutex);
+  uint64_t write_count = ++channel->write_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+  iree_notification_post(&channel->notification, IREE_ALL_WAITERS);
+
+  iree_status_t status = iree_ok_status();
+  if (channel->semaphore) {
+    status = iree_hal_semaphore_signal(channel->semaphore, write_count);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_io_output_channel_close(
+    iree_io_output_channel_t* channel) {
+  IREE_ASSERT_ARGUMENT(channel);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_slim_mutex_lock(&channel->mutex);
+  bool was_closed = channel->closed;
+  channel->closed = true;
+  uint64_t write_count = channel->write_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+
+  if (!was_closed) {
+    iree_notification_post(&channel->notification, IREE_ALL_WAITERS);
+    if (channel->semaphore) {
+      // The semaphore may have already failed; consumers will observe that
+      // instead of the close.
+      iree_status_ignore(
+          iree_hal_semaphore_signal(channel->semaphore, write_count + 1));
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_output_channel_read(
+    iree_io_output_channel_t* channel, iree_timeout_t timeout,
+    iree_byte_span_t buffer, iree_host_size_t* out_length) {
+  IREE_ASSERT_ARGUMENT(channel);
+  IREE_ASSERT_ARGUMENT(out_length);
+  *out_length = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!iree_notification_await(&channel->notification,
+                               iree_io_output_channel_can_read, channel,
+                               timeout)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_from_code(IREE_STATUS_DEADLINE_EXCEEDED);
+  }
+
+  // Only one consumer is allowed so the item can't be taken between the wait
+  // and here; the producer only ever publishes more items.
+  iree_slim_mutex_lock(&channel->mutex);
+  uint64_t item_index = channel->read_count;
+  bool has_item = item_index < channel->write_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+  if (!has_item) {
+    // Closed and drained.
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_from_code(IREE_STATUS_OUT_OF_RANGE);
+  }
+
+  iree_io_output_channel_slot_t* slot =
+      iree_io_output_channel_slot(channel, item_index);
+  *out_length = slot->length;
+  if (slot->length > buffer.data_length) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_status_from_code(IREE_STATUS_RESOURCE_EXHAUSTED);
+  }
+  if (slot->length > 0) {
+    memcpy(buffer.data, slot->data, slot->length);
+  }
+
+  iree_slim_mutex_lock(&channel->mutex);
+  ++channel->read_count;
+  iree_slim_mutex_unlock(&channel->mutex);
+  iree_notification_post(&channel->notification, IREE_ALL_WAITERS);
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
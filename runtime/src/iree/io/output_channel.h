@@ -0,0 +1,90 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_OUTPUT_CHANNEL_H_
+#define IREE_IO_OUTPUT_CHANNEL_H_
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_output_channel_t
+//===----------------------------------------------------------------------===//
+
+// A single-producer single-consumer channel of partial results published by a
+// program while it runs (such as each token decoded by a generative model).
+// The host can read items as soon as they are published instead of waiting for
+// the invocation to complete.
+//
+// Items are copied into a fixed-size ring of host memory slots. Publishers
+// block when all slots are full until the consumer reads an item, providing
+// back-pressure against consumers that can't keep up.
+//
+// An optional HAL semaphore is signaled with the total number of items
+// published after each item so that consumers can wait on it alongside other
+// HAL work. Closing the channel counts as one final event and signals the
+// semaphore to the item count + 1.
+//
+// Thread-safe.
+typedef struct iree_io_output_channel_t iree_io_output_channel_t;
+
+// Creates an output channel with |slot_count| slots of up to |item_capacity|
+// bytes each. |semaphore| is optional and retained by the channel if provided.
+// |out_channel| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_io_output_channel_create(
+    iree_host_size_t slot_count, iree_host_size_t item_capacity,
+    iree_hal_semaphore_t* semaphore, iree_allocator_t host_allocator,
+    iree_io_output_channel_t** out_channel);
+
+// Retains the given |channel| for the caller.
+IREE_API_EXPORT void iree_io_output_channel_retain(
+    iree_io_output_channel_t* channel);
+
+// Releases the given |channel| from the caller.
+IREE_API_EXPORT void iree_io_output_channel_release(
+    iree_io_output_channel_t* channel);
+
+// Returns the maximum size in bytes of each item in the channel.
+IREE_API_EXPORT iree_host_size_t
+iree_io_output_channel_item_capacity(const iree_io_output_channel_t* channel);
+
+// Returns the semaphore signaled as items are published, if any.
+IREE_API_EXPORT iree_hal_semaphore_t* iree_io_output_channel_semaphore(
+    const iree_io_output_channel_t* channel);
+
+// Publishes a copy of |contents| as the next item in the channel.
+// Waits up to |timeout| for a free slot if the consumer has not yet read the
+// previously published items. Fails with IREE_STATUS_FAILED_PRECONDITION if the
+// channel has been closed and IREE_STATUS_OUT_OF_RANGE if |contents| exceeds
+// the item capacity.
+IREE_API_EXPORT iree_status_t iree_io_output_channel_publish(
+    iree_io_output_channel_t* channel, iree_const_byte_span_t contents,
+    iree_timeout_t timeout);
+
+// Closes the channel to indicate that no more items will be published.
+// Items already published remain readable. Closing is idempotent.
+IREE_API_EXPORT void iree_io_output_channel_close(
+    iree_io_output_channel_t* channel);
+
+// Reads the next item from the channel into |buffer| and returns its length in
+// |out_length|. Waits up to |timeout| for an item to be published.
+// Returns IREE_STATUS_OUT_OF_RANGE without populating |buffer| once the
+// channel is closed and all items have been read and
+// IREE_STATUS_RESOURCE_EXHAUSTED if |buffer| is smaller than the item, in
+// which case the item remains in the channel and |out_length| has its length.
+IREE_API_EXPORT iree_status_t iree_io_output_channel_read(
+    iree_io_output_channel_t* channel, iree_timeout_t timeout,
+    iree_byte_span_t buffer, iree_host_size_t* out_length);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_OUTPUT_CHANNEL_H_
@@ -0,0 +1,126 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/output_channel.h"
+
+#include <string>
+#include <thread>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace {
+
+using iree::Status;
+using iree::StatusCode;
+using iree::testing::status::StatusIs;
+
+static iree_status_t Publish(iree_io_output_channel_t* channel,
+                             std::string_view value,
+                             iree_timeout_t timeout = iree_infinite_timeout()) {
+  return iree_io_output_channel_publish(
+      channel,
+      iree_make_const_byte_span(value.data(), value.size()), timeout);
+}
+
+static iree_status_t Read(iree_io_output_channel_t* channel,
+                          std::string* out_value,
+                          iree_timeout_t timeout = iree_infinite_timeout()) {
+  char buffer[16];
+  iree_host_size_t length = 0;
+  IREE_RETURN_IF_ERROR(iree_io_output_channel_read(
+      channel, timeout, iree_make_byte_span(buffer, sizeof(buffer)), &length));
+  out_value->assign(buffer, length);
+  return iree_ok_status();
+}
+
+TEST(OutputChannelTest, PublishAndRead) {
+  iree_io_output_channel_t* channel = NULL;
+  IREE_ASSERT_OK(iree_io_output_channel_create(
+      /*slot_count=*/2, /*item_capacity=*/8, /*semaphore=*/NULL,
+      iree_allocator_system(), &channel));
+  EXPECT_EQ(8, iree_io_output_channel_item_capacity(channel));
+
+  // Nothing to read yet.
+  std::string value;
+  EXPECT_THAT(Status(Read(channel, &value, iree_immediate_timeout())),
+              StatusIs(StatusCode::kDeadlineExceeded));
+
+  // Fill the ring; the next publish has to wait on the consumer.
+  IREE_ASSERT_OK(Publish(channel, "hello"));
+  IREE_ASSERT_OK(Publish(channel, ""));
+  EXPECT_THAT(Status(Publish(channel, "full", iree_immediate_timeout())),
+              StatusIs(StatusCode::kDeadlineExceeded));
+  EXPECT_THAT(Status(Publish(channel, "too long to fit")),
+              StatusIs(StatusCode::kOutOfRange));
+
+  IREE_ASSERT_OK(Read(channel, &value));
+  EXPECT_EQ("hello", value);
+  IREE_ASSERT_OK(Publish(channel, "world"));
+  IREE_ASSERT_OK(Read(channel, &value));
+  EXPECT_EQ("", value);
+
+  // Published items remain readable after closing.
+  iree_io_output_channel_close(channel);
+  EXPECT_THAT(Status(Publish(channel, "late")),
+              StatusIs(StatusCode::kFailedPrecondition));
+  IREE_ASSERT_OK(Read(channel, &value));
+  EXPECT_EQ("world", value);
+  EXPECT_THAT(Status(Read(channel, &value)), StatusIs(StatusCode::kOutOfRange));
+
+  iree_io_output_channel_release(channel);
+}
+
+TEST(OutputChannelTest, SmallReadBuffer) {
+  iree_io_output_channel_t* channel = NULL;
+  IREE_ASSERT_OK(iree_io_output_channel_create(
+      /*slot_count=*/1, /*item_capacity=*/8, /*semaphore=*/NULL,
+      iree_allocator_system(), &channel));
+  IREE_ASSERT_OK(Publish(channel, "hello"));
+
+  // The item stays in the channel until a large enough buffer is provided.
+  char buffer[2];
+  iree_host_size_t length = 0;
+  EXPECT_THAT(Status(iree_io_output_channel_read(
+                  channel, iree_infinite_timeout(),
+                  iree_make_byte_span(buffer, sizeof(buffer)), &length)),
+              StatusIs(StatusCode::kResourceExhausted));
+  EXPECT_EQ(5, length);
+  std::string value;
+  IREE_ASSERT_OK(Read(channel, &value));
+  EXPECT_EQ("hello", value);
+
+  iree_io_output_channel_release(channel);
+}
+
+TEST(OutputChannelTest, Streaming) {
+  static constexpr int kItemCount = 1000;
+  iree_io_output_channel_t* channel = NULL;
+  IREE_ASSERT_OK(iree_io_output_channel_create(
+      /*slot_count=*/4, /*item_capacity=*/8, /*semaphore=*/NULL,
+      iree_allocator_system(), &channel));
+
+  // The producer runs ahead of the consumer by at most the slot count.
+  std::thread producer([&]() {
+    for (int i = 0; i < kItemCount; ++i) {
+      IREE_CHECK_OK(Publish(channel, std::to_string(i)));
+    }
+    iree_io_output_channel_close(channel);
+  });
+  for (int i = 0; i < kItemCount; ++i) {
+    std::string value;
+    IREE_ASSERT_OK(Read(channel, &value));
+    EXPECT_EQ(std::to_string(i), value);
+  }
+  std::string value;
+  EXPECT_THAT(Status(Read(channel, &value)), StatusIs(StatusCode::kOutOfRange));
+  producer.join();
+
+  iree_io_output_channel_release(channel);
+}
+
+}  // namespace
@@ -0,0 +1,801 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_converter.h"
+
+#include "iree/base/internal/cpu.h"
+#include "iree/base/internal/math.h"
+#include "iree/builtins/ukernel/api.h"
+#include "iree/io/formats/gguf/gguf_parser.h"
+#include "iree/task/task.h"
+
+// Approximate number of elements processed by each tile of a conversion.
+// Tiles are the unit of work distributed across executor workers and should be
+// large enough to amortize the dispatch overhead while still allowing large
+// parameters to be split across all workers.
+#define IREE_IO_PARAMETER_CONVERTER_TILE_ELEMENTS (64 * 1024)
+
+// Number of elements in each block of the ggml quantized types we support.
+#define IREE_IO_GGML_QK 32
+
+// Size of the temporary buffer iree_uk_pack uses for padding tiles.
+#define IREE_IO_PARAMETER_CONVERTER_MAX_PACK_TILE_SIZE 4096
+
+// Implementation of iree_uk_assert_fail is deferred to users of the ukernels.
+// Weak as other users linked into the same binary (such as the VMVX module)
+// provide their own. All arguments are validated prior to calling into the
+// ukernels so this should never be reached.
+IREE_ATTRIBUTE_WEAK void iree_uk_assert_fail(const char* file, int line,
+                                             const char* function,
+                                             const char* condition) {
+  IREE_ASSERT(false, "%s:%d: %s: assertion failed: %s", file, line, function,
+              condition);
+}
+
+//===----------------------------------------------------------------------===//
+// Rule parsing
+//===----------------------------------------------------------------------===//
+
+static iree_status_t iree_io_parameter_conversion_rule_parse_op(
+    iree_string_view_t op, iree_io_parameter_conversion_rule_t* rule) {
+  if (iree_string_view_consume_prefix(&op, IREE_SV("pack:"))) {
+    iree_string_view_t rows_str = iree_string_view_empty();
+    iree_string_view_t cols_str = iree_string_view_empty();
+    if (iree_string_view_split(op, 'x', &rows_str, &cols_str) == -1 ||
+        !iree_string_view_atoi_uint32(rows_str, &rule->tile_sizes[0]) ||
+        !iree_string_view_atoi_uint32(cols_str, &rule->tile_sizes[1]) ||
+        rule->tile_sizes[0] == 0 || rule->tile_sizes[1] == 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "invalid pack tile size `%.*s`; expected "
+                              "`pack:<rows>x<cols>` such as `pack:16x1`",
+                              (int)op.size, op.data);
+    }
+    return iree_ok_status();
+  } else if (iree_string_view_equal(op, IREE_SV("transpose_inner"))) {
+    rule->flags |= IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_INNER;
+    return iree_ok_status();
+  } else if (iree_string_view_equal(op, IREE_SV("transpose_outer"))) {
+    rule->flags |= IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_OUTER;
+    return iree_ok_status();
+  }
+  iree_hal_element_type_t element_type = IREE_HAL_ELEMENT_TYPE_NONE;
+  if (iree_status_is_ok(iree_hal_parse_element_type(op, &element_type)) &&
+      (element_type == IREE_HAL_ELEMENT_TYPE_FLOAT_32 ||
+       element_type == IREE_HAL_ELEMENT_TYPE_FLOAT_16 ||
+       element_type == IREE_HAL_ELEMENT_TYPE_BFLOAT_16)) {
+    rule->element_type = element_type;
+    return iree_ok_status();
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "unsupported parameter conversion `%.*s`; expected "
+                          "one of f32, f16, bf16, pack:<rows>x<cols>, "
+                          "transpose_inner, or transpose_outer",
+                          (int)op.size, op.data);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_conversion_rule_parse(
+    iree_string_view_t value, iree_io_parameter_conversion_rule_t* out_rule) {
+  IREE_ASSERT_ARGUMENT(out_rule);
+  memset(out_rule, 0, sizeof(*out_rule));
+  iree_string_view_t ops = iree_string_view_empty();
+  if (iree_string_view_split(value, '=', &out_rule->pattern, &ops) == -1 ||
+      iree_string_view_is_empty(out_rule->pattern) ||
+      iree_string_view_is_empty(ops)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter conversion rules must be specified as "
+                            "`pattern=op[,op...]`; got `%.*s`",
+                            (int)value.size, value.data);
+  }
+  while (!iree_string_view_is_empty(ops)) {
+    iree_string_view_t op = iree_string_view_empty();
+    iree_string_view_split(ops, ',', &op, &ops);
+    IREE_RETURN_IF_ERROR(iree_io_parameter_conversion_rule_parse_op(
+        iree_string_view_trim(op), out_rule));
+  }
+  if (out_rule->tile_sizes[0] == 0) {
+    if (out_rule->element_type == IREE_HAL_ELEMENT_TYPE_NONE) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "parameter conversion rule `%.*s` must convert "
+                              "or pack values",
+                              (int)value.size, value.data);
+    } else if (out_rule->flags) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "parameter conversion rule `%.*s` transposes "
+                              "without packing",
+                              (int)value.size, value.data);
+    }
+  }
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Conversion planning
+//===----------------------------------------------------------------------===//
+
+// A conversion of a single parameter as resolved from its matching rule.
+typedef struct iree_io_parameter_conversion_t {
+  // Storage type of the source parameter.
+  iree_io_gguf_tensor_type_t source_type;
+  // Total number of elements in the parameter.
+  uint64_t element_count;
+  // Element type of the converted values or NONE if the stored values are
+  // packed directly.
+  iree_hal_element_type_t element_type;
+  // Size in bytes of each element of the matrix being packed.
+  iree_host_size_t element_size;
+  // True if the matrix is packed.
+  bool pack;
+  // Dimensions of the source matrix as [rows, cols].
+  uint64_t in_sizes[2];
+  // Tile size along the source matrix [rows, cols].
+  uint64_t in_tile_sizes[2];
+  // Dimensions of the packed result as [outer0, outer1, tile0, tile1].
+  uint64_t out_sizes[4];
+  // iree_uk_pack flags.
+  uint32_t pack_flags;
+  // Total length of the transformed contents in bytes.
+  uint64_t target_length;
+} iree_io_parameter_conversion_t;
+
+// Returns the HAL element type the |source_type| maps to or NONE if it is
+// quantized.
+static iree_hal_element_type_t iree_io_gguf_tensor_type_element_type(
+    iree_io_gguf_tensor_type_t source_type) {
+  switch (source_type) {
+    case IREE_IO_GGUF_TENSOR_TYPE_F32:
+      return IREE_HAL_ELEMENT_TYPE_FLOAT_32;
+    case IREE_IO_GGUF_TENSOR_TYPE_F16:
+      return IREE_HAL_ELEMENT_TYPE_FLOAT_16;
+    case IREE_IO_GGUF_TENSOR_TYPE_I8:
+      return IREE_HAL_ELEMENT_TYPE_INT_8;
+    case IREE_IO_GGUF_TENSOR_TYPE_I16:
+      return IREE_HAL_ELEMENT_TYPE_INT_16;
+    case IREE_IO_GGUF_TENSOR_TYPE_I32:
+      return IREE_HAL_ELEMENT_TYPE_INT_32;
+    default:
+      return IREE_HAL_ELEMENT_TYPE_NONE;
+  }
+}
+
+// Returns true if |source_type| values can be converted to floating-point.
+static bool iree_io_gguf_tensor_type_is_convertible(
+    iree_io_gguf_tensor_type_t source_type) {
+  switch (source_type) {
+    case IREE_IO_GGUF_TENSOR_TYPE_F32:
+    case IREE_IO_GGUF_TENSOR_TYPE_F16:
+    case IREE_IO_GGUF_TENSOR_TYPE_Q4_0:
+    case IREE_IO_GGUF_TENSOR_TYPE_Q4_1:
+    case IREE_IO_GGUF_TENSOR_TYPE_Q8_0:
+      return true;
+    default:
+      return false;
+  }
+}
+
+// Returns true if |source_type| stores values in blocks of IREE_IO_GGML_QK.
+static bool iree_io_gguf_tensor_type_is_quantized(
+    iree_io_gguf_tensor_type_t source_type) {
+  return source_type == IREE_IO_GGUF_TENSOR_TYPE_Q4_0 ||
+         source_type == IREE_IO_GGUF_TENSOR_TYPE_Q4_1 ||
+         source_type == IREE_IO_GGUF_TENSOR_TYPE_Q8_0;
+}
+
+// Returns the iree_uk_pack type flags for elements of |element_type| or 0 if
+// the type cannot be packed.
+static uint32_t iree_io_parameter_pack_type_flags(
+    iree_hal_element_type_t element_type) {
+  switch (element_type) {
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+      return IREE_UK_FLAG_PACK_TYPE_F32F32;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+      return IREE_UK_FLAG_PACK_TYPE_F16F16;
+    case IREE_HAL_ELEMENT_TYPE_BFLOAT_16:
+      return IREE_UK_FLAG_PACK_TYPE_BF16BF16;
+    case IREE_HAL_ELEMENT_TYPE_INT_8:
+      return IREE_UK_FLAG_PACK_TYPE_I8I8;
+    case IREE_HAL_ELEMENT_TYPE_INT_32:
+      return IREE_UK_FLAG_PACK_TYPE_I32I32;
+    default:
+      return 0;
+  }
+}
+
+// Resolves the conversion of |entry| with |rule|.
+static iree_status_t iree_io_parameter_conversion_resolve(
+    const iree_io_parameter_conversion_rule_t* rule,
+    const iree_io_parameter_index_entry_t* entry,
+    iree_io_parameter_conversion_t* out_conversion) {
+  memset(out_conversion, 0, sizeof(*out_conversion));
+
+  iree_io_gguf_tensor_metadata_t metadata;
+  if (entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE ||
+      !iree_io_gguf_tensor_metadata_get(entry, &metadata)) {
+    return iree_make_status(
+        IREE_STATUS_FAILED_PRECONDITION,
+        "parameter `%.*s` matches a conversion rule but has no tensor type "
+        "information; only parameters from GGUF files can be converted",
+        (int)entry->key.size, entry->key.data);
+  }
+  out_conversion->source_type = metadata.type;
+
+  // Collapse all outer dimensions into rows.
+  uint64_t rows = 1;
+  for (uint32_t i = 1; i < metadata.dimension_count; ++i) {
+    rows *= metadata.dimensions[i];
+  }
+  uint64_t cols = metadata.dimension_count > 0 ? metadata.dimensions[0] : 1;
+  out_conversion->element_count = rows * cols;
+  out_conversion->in_sizes[0] = rows;
+  out_conversion->in_sizes[1] = cols;
+  if (iree_io_gguf_tensor_type_is_quantized(metadata.type) &&
+      cols % IREE_IO_GGML_QK != 0) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "parameter `%.*s` has %" PRIu64
+        " columns that are not a multiple of the quantization block size",
+        (int)entry->key.size, entry->key.data, cols);
+  }
+
+  // Determine the element type after conversion.
+  iree_hal_element_type_t element_type = rule->element_type;
+  if (element_type != IREE_HAL_ELEMENT_TYPE_NONE) {
+    if (!iree_io_gguf_tensor_type_is_convertible(metadata.type)) {
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "parameter `%.*s` has tensor type %u that "
+                              "cannot be converted to floating-point",
+                              (int)entry->key.size, entry->key.data,
+                              metadata.type);
+    }
+    out_conversion->element_type = element_type;
+  } else {
+    element_type = iree_io_gguf_tensor_type_element_type(metadata.type);
+    if (element_type == IREE_HAL_ELEMENT_TYPE_NONE) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "parameter `%.*s` has quantized tensor type %u "
+                              "and must be converted before it can be packed",
+                              (int)entry->key.size, entry->key.data,
+                              metadata.type);
+    }
+  }
+  out_conversion->element_size =
+      iree_hal_element_dense_byte_count(element_type);
+
+  // Without packing the result is just the converted elements.
+  if (rule->tile_sizes[0] == 0) {
+    out_conversion->target_length =
+        out_conversion->element_count * out_conversion->element_size;
+    return iree_ok_status();
+  }
+
+  uint32_t pack_type_flags = iree_io_parameter_pack_type_flags(element_type);
+  if (!pack_type_flags) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "parameter `%.*s` elements cannot be packed",
+                            (int)entry->key.size, entry->key.data);
+  }
+  if (metadata.dimension_count > 2) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter `%.*s` has %u dimensions; only "
+                            "matrices can be packed",
+                            (int)entry->key.size, entry->key.data,
+                            metadata.dimension_count);
+  }
+  const uint64_t tile_size0 = rule->tile_sizes[0];
+  const uint64_t tile_size1 = rule->tile_sizes[1];
+  if (tile_size0 * tile_size1 * out_conversion->element_size >
+      IREE_IO_PARAMETER_CONVERTER_MAX_PACK_TILE_SIZE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter `%.*s` pack tile %" PRIu64 "x%" PRIu64
+                            " exceeds the maximum tile size of %d bytes",
+                            (int)entry->key.size, entry->key.data, tile_size0,
+                            tile_size1,
+                            IREE_IO_PARAMETER_CONVERTER_MAX_PACK_TILE_SIZE);
+  }
+  out_conversion->pack = true;
+  out_conversion->pack_flags = pack_type_flags;
+  out_conversion->in_tile_sizes[0] = tile_size0;
+  out_conversion->in_tile_sizes[1] = tile_size1;
+  uint64_t outer0 = iree_device_size_ceil_div(rows, tile_size0);
+  uint64_t outer1 = iree_device_size_ceil_div(cols, tile_size1);
+  out_conversion->out_sizes[0] = outer0;
+  out_conversion->out_sizes[1] = outer1;
+  out_conversion->out_sizes[2] = tile_size0;
+  out_conversion->out_sizes[3] = tile_size1;
+  if (iree_all_bits_set(rule->flags,
+                        IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_OUTER)) {
+    out_conversion->pack_flags |= IREE_UK_FLAG_PACK_TRANSPOSE_OUTER;
+    out_conversion->out_sizes[0] = outer1;
+    out_conversion->out_sizes[1] = outer0;
+  }
+  if (iree_all_bits_set(rule->flags,
+                        IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_INNER)) {
+    out_conversion->pack_flags |= IREE_UK_FLAG_PACK_TRANSPOSE_INNER;
+    out_conversion->out_sizes[2] = tile_size1;
+    out_conversion->out_sizes[3] = tile_size0;
+  }
+  out_conversion->target_length = outer0 * outer1 * tile_size0 * tile_size1 *
+                                  out_conversion->element_size;
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Element conversion
+//===----------------------------------------------------------------------===//
+
+typedef struct {
+  uint16_t d;
+  uint8_t qs[IREE_IO_GGML_QK / 2];
+} iree_io_ggml_block_q4_0_t;
+typedef struct {
+  uint16_t d;
+  uint16_t m;
+  uint8_t qs[IREE_IO_GGML_QK / 2];
+} iree_io_ggml_block_q4_1_t;
+typedef struct {
+  uint16_t d;
+  int8_t qs[IREE_IO_GGML_QK];
+} iree_io_ggml_block_q8_0_t;
+
+// Decodes |count| elements (a multiple of the block size for quantized types)
+// from |source| into |values|.
+static void iree_io_parameter_decode_f32(iree_io_gguf_tensor_type_t type,
+                                         const uint8_t* source,
+                                         iree_host_size_t count,
+                                         float* values) {
+  switch (type) {
+    case IREE_IO_GGUF_TENSOR_TYPE_F32: {
+      memcpy(values, source, count * sizeof(float));
+      break;
+    }
+    case IREE_IO_GGUF_TENSOR_TYPE_F16: {
+      const uint16_t* elements = (const uint16_t*)source;
+      for (iree_host_size_t i = 0; i < count; ++i) {
+        values[i] = iree_math_f16_to_f32(elements[i]);
+      }
+      break;
+    }
+    case IREE_IO_GGUF_TENSOR_TYPE_Q4_0: {
+      const iree_io_ggml_block_q4_0_t* blocks =
+          (const iree_io_ggml_block_q4_0_t*)source;
+      for (iree_host_size_t i = 0; i < count / IREE_IO_GGML_QK; ++i) {
+        const float d = iree_math_f16_to_f32(blocks[i].d);
+        float* block_values = values + i * IREE_IO_GGML_QK;
+        for (iree_host_size_t j = 0; j < IREE_IO_GGML_QK / 2; ++j) {
+          block_values[j] = ((int)(blocks[i].qs[j] & 0x0F) - 8) * d;
+          block_values[j + IREE_IO_GGML_QK / 2] =
+              ((int)(blocks[i].qs[j] >> 4) - 8) * d;
+        }
+      }
+      break;
+    }
+    case IREE_IO_GGUF_TENSOR_TYPE_Q4_1: {
+      const iree_io_ggml_block_q4_1_t* blocks =
+          (const iree_io_ggml_block_q4_1_t*)source;
+      for (iree_host_size_t i = 0; i < count / IREE_IO_GGML_QK; ++i) {
+        const float d = iree_math_f16_to_f32(blocks[i].d);
+        const float m = iree_math_f16_to_f32(blocks[i].m);
+        float* block_values = values + i * IREE_IO_GGML_QK;
+        for (iree_host_size_t j = 0; j < IREE_IO_GGML_QK / 2; ++j) {
+          block_values[j] = (blocks[i].qs[j] & 0x0F) * d + m;
+          block_values[j + IREE_IO_GGML_QK / 2] =
+              (blocks[i].qs[j] >> 4) * d + m;
+        }
+      }
+      break;
+    }
+    case IREE_IO_GGUF_TENSOR_TYPE_Q8_0: {
+      const iree_io_ggml_block_q8_0_t* blocks =
+          (const iree_io_ggml_block_q8_0_t*)source;
+      for (iree_host_size_t i = 0; i < count / IREE_IO_GGML_QK; ++i) {
+        const float d = iree_math_f16_to_f32(blocks[i].d);
+        float* block_values = values + i * IREE_IO_GGML_QK;
+        for (iree_host_size_t j = 0; j < IREE_IO_GGML_QK; ++j) {
+          block_values[j] = blocks[i].qs[j] * d;
+        }
+      }
+      break;
+    }
+    default:
+      IREE_ASSERT_UNREACHABLE("validated during resolution");
+      break;
+  }
+}
+
+// Returns the byte offset of element |index| within |type| storage.
+// |index| must be a multiple of the block size for quantized types.
+static uint64_t iree_io_parameter_storage_offset(
+    iree_io_gguf_tensor_type_t type, uint64_t index) {
+  switch (type) {
+    case IREE_IO_GGUF_TENSOR_TYPE_Q4_0:
+      return index / IREE_IO_GGML_QK * sizeof(iree_io_ggml_block_q4_0_t);
+    case IREE_IO_GGUF_TENSOR_TYPE_Q4_1:
+      return index / IREE_IO_GGML_QK * sizeof(iree_io_ggml_block_q4_1_t);
+    case IREE_IO_GGUF_TENSOR_TYPE_Q8_0:
+      return index / IREE_IO_GGML_QK * sizeof(iree_io_ggml_block_q8_0_t);
+    default:
+      return index * iree_hal_element_dense_byte_count(
+                         iree_io_gguf_tensor_type_element_type(type));
+  }
+}
+
+// Converts elements [begin, end) of |source| into |target|.
+static void iree_io_parameter_convert_elements(
+    const iree_io_parameter_conversion_t* conversion, const uint8_t* source,
+    uint8_t* target, uint64_t begin, uint64_t end) {
+  // Values are decoded through a small stack buffer so that each source
+  // encoding only needs a single decoder.
+  float values[256];
+  static_assert(IREE_ARRAYSIZE(values) % IREE_IO_GGML_QK == 0,
+                "must hold whole blocks");
+  for (uint64_t i = begin; i < end; i += IREE_ARRAYSIZE(values)) {
+    iree_host_size_t count =
+        (iree_host_size_t)iree_min(IREE_ARRAYSIZE(values), end - i);
+    iree_io_parameter_decode_f32(
+        conversion->source_type,
+        source + iree_io_parameter_storage_offset(conversion->source_type, i),
+        count, values);
+    switch (conversion->element_type) {
+      case IREE_HAL_ELEMENT_TYPE_FLOAT_32: {
+        memcpy(target + i * sizeof(float), values, count * sizeof(float));
+        break;
+      }
+      case IREE_HAL_ELEMENT_TYPE_FLOAT_16: {
+        uint16_t* elements = (uint16_t*)target + i;
+        for (iree_host_size_t j = 0; j < count; ++j) {
+          elements[j] = iree_math_f32_to_f16(values[j]);
+        }
+        break;
+      }
+      case IREE_HAL_ELEMENT_TYPE_BFLOAT_16: {
+        uint16_t* elements = (uint16_t*)target + i;
+        for (iree_host_size_t j = 0; j < count; ++j) {
+          elements[j] = iree_math_f32_to_bf16(values[j]);
+        }
+        break;
+      }
+      default:
+        IREE_ASSERT_UNREACHABLE("validated during rule parsing");
+        break;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_converter_t
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_io_parameter_converter_t {
+  iree_io_parameter_transform_t base;
+  iree_allocator_t host_allocator;
+  // Executor used to distribute conversion tiles or NULL to run inline.
+  iree_task_executor_t* executor;
+  iree_host_size_t rule_count;
+  iree_io_parameter_conversion_rule_t rules[];
+  // Followed by rule pattern storage.
+} iree_io_parameter_converter_t;
+
+static const iree_io_parameter_transform_vtable_t
+    iree_io_parameter_converter_vtable;
+
+static iree_io_parameter_converter_t* iree_io_parameter_converter_cast(
+    iree_io_parameter_transform_t* IREE_RESTRICT base_transform) {
+  return (iree_io_parameter_converter_t*)base_transform;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_converter_create(
+    iree_task_executor_t* executor, iree_host_size_t rule_count,
+    const iree_io_parameter_conversion_rule_t* rules,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_transform_t** out_transform) {
+  IREE_ASSERT_ARGUMENT(!rule_count || rules);
+  IREE_ASSERT_ARGUMENT(out_transform);
+  *out_transform = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, rule_count);
+
+  iree_host_size_t total_size =
+      sizeof(iree_io_parameter_converter_t) + rule_count * sizeof(rules[0]);
+  for (iree_host_size_t i = 0; i < rule_count; ++i) {
+    total_size += rules[i].pattern.size;
+  }
+  iree_io_parameter_converter_t* converter = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, total_size, (void**)&converter));
+  iree_atomic_ref_count_init(&converter->base.ref_count);
+  converter->base.vtable = &iree_io_parameter_converter_vtable;
+  converter->host_allocator = host_allocator;
+  converter->executor = executor;
+  iree_task_executor_retain(executor);
+
+  converter->rule_count = rule_count;
+  char* pattern_storage = (char*)&converter->rules[rule_count];
+  for (iree_host_size_t i = 0; i < rule_count; ++i) {
+    converter->rules[i] = rules[i];
+    memcpy(pattern_storage, rules[i].pattern.data, rules[i].pattern.size);
+    converter->rules[i].pattern =
+        iree_make_string_view(pattern_storage, rules[i].pattern.size);
+    pattern_storage += rules[i].pattern.size;
+  }
+
+  *out_transform = &converter->base;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_converter_destroy(
+    iree_io_parameter_transform_t* IREE_RESTRICT base_transform) {
+  iree_io_parameter_converter_t* converter =
+      iree_io_parameter_converter_cast(base_transform);
+  iree_allocator_t host_allocator = converter->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_task_executor_release(converter->executor);
+  iree_allocator_free(host_allocator, converter);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns the first rule matching the |entry| key or NULL if none match.
+static const iree_io_parameter_conversion_rule_t*
+iree_io_parameter_converter_match(
+    iree_io_parameter_converter_t* converter,
+    const iree_io_parameter_index_entry_t* entry) {
+  for (iree_host_size_t i = 0; i < converter->rule_count; ++i) {
+    if (iree_string_view_match_pattern(entry->key,
+                                       converter->rules[i].pattern)) {
+      return &converter->rules[i];
+    }
+  }
+  return NULL;
+}
+
+static iree_status_t iree_io_parameter_converter_query(
+    iree_io_parameter_transform_t* base_transform,
+    const iree_io_parameter_index_entry_t* entry, bool* out_applies,
+    uint64_t* out_target_length) {
+  iree_io_parameter_converter_t* converter =
+      iree_io_parameter_converter_cast(base_transform);
+  const iree_io_parameter_conversion_rule_t* rule =
+      iree_io_parameter_converter_match(converter, entry);
+  if (!rule) return iree_ok_status();
+  iree_io_parameter_conversion_t conversion;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_conversion_resolve(rule, entry, &conversion));
+  *out_applies = true;
+  *out_target_length = conversion.target_length;
+  return iree_ok_status();
+}
+
+typedef iree_status_t (*iree_io_parameter_converter_tile_fn_t)(
+    void* user_data, uint32_t tile_index);
+
+typedef struct iree_io_parameter_converter_closure_t {
+  iree_io_parameter_converter_tile_fn_t fn;
+  void* user_data;
+} iree_io_parameter_converter_closure_t;
+
+static iree_status_t iree_io_parameter_converter_dispatch_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_io_parameter_converter_closure_t* closure =
+      (const iree_io_parameter_converter_closure_t*)user_context;
+  return closure->fn(closure->user_data, tile_context->workgroup_xyz[0]);
+}
+
+// Runs |fn| for each tile in [0, tile_count) and returns after all complete.
+// Tiles are distributed across the converter executor when available.
+static iree_status_t iree_io_parameter_converter_dispatch(
+    iree_io_parameter_converter_t* converter, uint32_t tile_count,
+    iree_io_parameter_converter_tile_fn_t fn, void* user_data) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, tile_count);
+
+  // Small conversions are not worth the round-trip through the executor.
+  if (!converter->executor || tile_count <= 1) {
+    iree_status_t status = iree_ok_status();
+    for (uint32_t i = 0; i < tile_count && iree_status_is_ok(status); ++i) {
+      status = fn(user_data, i);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(IREE_SV("iree_io_parameter_converter"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  iree_io_parameter_converter_closure_t closure = {
+      .fn = fn,
+      .user_data = user_data,
+  };
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(iree_io_parameter_converter_dispatch_tile,
+                                      &closure),
+      workgroup_size, workgroup_count, &dispatch_task);
+
+  // The fence signals the scope when the dispatch completes so that we can
+  // wait for it below.
+  iree_task_fence_t* fence = NULL;
+  iree_status_t status =
+      iree_task_executor_acquire_fence(converter->executor, &scope, &fence);
+  if (iree_status_is_ok(status)) {
+    iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_task.header);
+    iree_task_executor_submit(converter->executor, &submission);
+    iree_task_executor_flush(converter->executor);
+    status = iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_task_scope_consume_status(&scope);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+typedef struct iree_io_parameter_converter_tile_params_t {
+  const iree_io_parameter_conversion_t* conversion;
+  const uint8_t* source;
+  uint8_t* target;
+  // Number of elements (when converting) or outer tiles along the first packed
+  // dimension (when packing) processed per tile.
+  uint64_t tile_extent;
+} iree_io_parameter_converter_tile_params_t;
+
+static iree_status_t iree_io_parameter_converter_convert_tile(
+    void* user_data, uint32_t tile_index) {
+  const iree_io_parameter_converter_tile_params_t* params =
+      (const iree_io_parameter_converter_tile_params_t*)user_data;
+  uint64_t begin = tile_index * params->tile_extent;
+  uint64_t end = iree_min(begin + params->tile_extent,
+                          params->conversion->element_count);
+  iree_io_parameter_convert_elements(params->conversion, params->source,
+                                     params->target, begin, end);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_parameter_converter_pack_tile(
+    void* user_data, uint32_t tile_index) {
+  const iree_io_parameter_converter_tile_params_t* params =
+      (const iree_io_parameter_converter_tile_params_t*)user_data;
+  const iree_io_parameter_conversion_t* conversion = params->conversion;
+
+  // Each tile packs a range of the outermost packed dimension. That dimension
+  // walks the source rows or (with a transposed outer layout) the columns.
+  const uint64_t out_begin = tile_index * params->tile_extent;
+  const uint64_t out_end =
+      iree_min(out_begin + params->tile_extent, conversion->out_sizes[0]);
+  const bool transpose_outer = iree_all_bits_set(
+      conversion->pack_flags, IREE_UK_FLAG_PACK_TRANSPOSE_OUTER);
+  const iree_host_size_t in_dim = transpose_outer ? 1 : 0;
+  const uint64_t in_tile_size = conversion->in_tile_sizes[in_dim];
+  const uint64_t in_begin = out_begin * in_tile_size;
+  const uint64_t in_end =
+      iree_min(out_end * in_tile_size, conversion->in_sizes[in_dim]);
+  uint64_t in_sizes[2] = {conversion->in_sizes[0], conversion->in_sizes[1]};
+  in_sizes[in_dim] = in_end > in_begin ? in_end - in_begin : 0;
+  const uint64_t in_stride0 = conversion->in_sizes[1];
+  const uint64_t out_stride0 = conversion->out_sizes[1] *
+                               conversion->out_sizes[2] *
+                               conversion->out_sizes[3];
+  iree_uk_pack(params->source,
+               (iree_uk_index_t)(transpose_outer ? in_begin
+                                                 : in_begin * in_stride0),
+               (iree_uk_index_t)in_stride0, params->target,
+               (iree_uk_index_t)(out_begin * out_stride0),
+               (iree_uk_index_t)out_stride0, (iree_uk_index_t)in_sizes[0],
+               (iree_uk_index_t)in_sizes[1],
+               (iree_uk_index_t)(out_end - out_begin),
+               (iree_uk_index_t)conversion->out_sizes[1],
+               (iree_uk_index_t)conversion->out_sizes[2],
+               (iree_uk_index_t)conversion->out_sizes[3],
+               /*padding_value=*/0, conversion->pack_flags,
+               (const iree_uk_uint64_t*)iree_cpu_data_fields());
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_parameter_converter_apply(
+    iree_io_parameter_transform_t* base_transform,
+    const iree_io_parameter_index_entry_t* entry, iree_const_byte_span_t source,
+    iree_byte_span_t target) {
+  iree_io_parameter_converter_t* converter =
+      iree_io_parameter_converter_cast(base_transform);
+  const iree_io_parameter_conversion_rule_t* rule =
+      iree_io_parameter_converter_match(converter, entry);
+  if (!rule) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "parameter `%.*s` does not match any rule",
+                            (int)entry->key.size, entry->key.data);
+  }
+  iree_io_parameter_conversion_t conversion;
+  IREE_RETURN_IF_ERROR(
+      iree_io_parameter_conversion_resolve(rule, entry, &conversion));
+  if (source.data_length < entry->length ||
+      iree_io_parameter_storage_offset(conversion.source_type,
+                                       conversion.element_count) >
+          entry->length) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "parameter `%.*s` source contents are smaller than "
+                            "its tensor type requires",
+                            (int)entry->key.size, entry->key.data);
+  } else if (target.data_length != conversion.target_length) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "parameter `%.*s` target length %" PRIhsz
+        " does not match the transformed length %" PRIu64,
+        (int)entry->key.size, entry->key.data, target.data_length,
+        conversion.target_length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Convert element values first. When packing the converted values go into a
+  // transient buffer that is then packed into the target.
+  const uint8_t* pack_source = source.data;
+  uint8_t* converted_storage = NULL;
+  iree_status_t status = iree_ok_status();
+  if (conversion.element_type != IREE_HAL_ELEMENT_TYPE_NONE) {
+    uint8_t* convert_target = target.data;
+    if (conversion.pack) {
+      status = iree_allocator_malloc(
+          converter->host_allocator,
+          conversion.element_count * conversion.element_size,
+          (void**)&converted_storage);
+      convert_target = converted_storage;
+      pack_source = converted_storage;
+    }
+    if (iree_status_is_ok(status)) {
+      iree_io_parameter_converter_tile_params_t params = {
+          .conversion = &conversion,
+          .source = source.data,
+          .target = convert_target,
+          .tile_extent = IREE_IO_PARAMETER_CONVERTER_TILE_ELEMENTS,
+      };
+      status = iree_io_parameter_converter_dispatch(
+          converter,
+          (uint32_t)iree_device_size_ceil_div(conversion.element_count,
+                                              params.tile_extent),
+          iree_io_parameter_converter_convert_tile, &params);
+    }
+  }
+
+  // Pack the (possibly converted) matrix into the target.
+  if (iree_status_is_ok(status) && conversion.pack) {
+    // Split along the outermost packed dimension such that each tile covers
+    // roughly the desired number of elements.
+    const uint64_t outer_elements = conversion.out_sizes[1] *
+                                    conversion.out_sizes[2] *
+                                    conversion.out_sizes[3];
+    iree_io_parameter_converter_tile_params_t params = {
+        .conversion = &conversion,
+        .source = pack_source,
+        .target = target.data,
+        .tile_extent = iree_max(
+            1, IREE_IO_PARAMETER_CONVERTER_TILE_ELEMENTS / outer_elements),
+    };
+    status = iree_io_parameter_converter_dispatch(
+        converter,
+        (uint32_t)iree_device_size_ceil_div(conversion.out_sizes[0],
+                                            params.tile_extent),
+        iree_io_parameter_converter_pack_tile, &params);
+  }
+
+  iree_allocator_free(converter->host_allocator, converted_storage);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static const iree_io_parameter_transform_vtable_t
+    iree_io_parameter_converter_vtable = {
+        .destroy = iree_io_parameter_converter_destroy,
+        .query = iree_io_parameter_converter_query,
+        .apply = iree_io_parameter_converter_apply,
+};
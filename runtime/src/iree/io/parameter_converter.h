@@ -0,0 +1,81 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_CONVERTER_H_
+#define IREE_IO_PARAMETER_CONVERTER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/io/parameter_transform.h"
+#include "iree/task/executor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Controls how matrices are packed by a conversion rule.
+enum iree_io_parameter_conversion_flag_bits_t {
+  IREE_IO_PARAMETER_CONVERSION_FLAG_NONE = 0u,
+  // Each tile is stored transposed (IREE_UK_FLAG_PACK_TRANSPOSE_INNER).
+  IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_INNER = 1u << 0,
+  // The grid of tiles is stored transposed (IREE_UK_FLAG_PACK_TRANSPOSE_OUTER).
+  IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_OUTER = 1u << 1,
+};
+typedef uint32_t iree_io_parameter_conversion_flags_t;
+
+// Describes how parameters with keys matching |pattern| are converted.
+// Conversion happens in two optional steps: element values are first converted
+// to |element_type| (dequantizing if needed) and then the resulting matrix is
+// packed into the tiled layout produced by the iree_uk_pack ukernel.
+//
+// Parameters must carry tensor type information in their index entry metadata
+// such as the iree_io_gguf_tensor_metadata_t produced by the GGUF parser.
+// Tensors are treated as row-major with the innermost dimension as the columns
+// and all outer dimensions as rows.
+typedef struct iree_io_parameter_conversion_rule_t {
+  // Pattern matched against parameter keys with iree_string_view_match_pattern.
+  iree_string_view_t pattern;
+  // Floating-point type to convert element values to or
+  // IREE_HAL_ELEMENT_TYPE_NONE to keep the stored type. Quantized parameters
+  // must be converted before they can be packed.
+  iree_hal_element_type_t element_type;
+  // Tile size along the rows and columns of the source matrix when packing or
+  // 0 to store the (converted) matrix without packing it.
+  uint32_t tile_sizes[2];
+  // Flags controlling the packed layout.
+  iree_io_parameter_conversion_flags_t flags;
+} iree_io_parameter_conversion_rule_t;
+
+// Parses a conversion rule from a string of the form `pattern=op[,op...]`.
+// Supported operations:
+//   `f32`/`f16`/`bf16`: converts element values to the given type.
+//   `pack:<rows>x<cols>`: packs into tiles of the given size.
+//   `transpose_inner`/`transpose_outer`: transposes the packed layout.
+// Example converting and packing all matmul weights of a llama model:
+//   `blk.*.weight=f16,pack:16x1`
+// The |out_rule| pattern references |value| which must remain valid for as long
+// as the rule is used.
+IREE_API_EXPORT iree_status_t iree_io_parameter_conversion_rule_parse(
+    iree_string_view_t value, iree_io_parameter_conversion_rule_t* out_rule);
+
+// Creates a parameter transform applying the first of |rules| with a pattern
+// matching each parameter key. Parameters not matching any rule are not
+// transformed. The rules and their patterns are copied. If provided the work
+// of each conversion is split into tiles executed on |executor|; otherwise
+// conversions execute on the thread applying the transform.
+IREE_API_EXPORT iree_status_t iree_io_parameter_converter_create(
+    iree_task_executor_t* executor, iree_host_size_t rule_count,
+    const iree_io_parameter_conversion_rule_t* rules,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_transform_t** out_transform);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_CONVERTER_H_
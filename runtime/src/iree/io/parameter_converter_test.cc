@@ -0,0 +1,247 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_converter.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+#include "iree/io/formats/gguf/gguf_parser.h"
+#include "iree/task/executor.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace io {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+using ::testing::ElementsAre;
+using ::testing::ElementsAreArray;
+
+// A file-backed parameter entry carrying GGUF tensor metadata.
+// Dimensions are listed innermost first as in GGUF files.
+struct TestEntry {
+  TestEntry(const char* key, iree_io_gguf_tensor_type_t type,
+            std::vector<uint64_t> dims, uint64_t length) {
+    memset(&metadata, 0, sizeof(metadata));
+    metadata.magic = IREE_IO_GGUF_TENSOR_METADATA_MAGIC;
+    metadata.type = type;
+    metadata.dimension_count = (uint32_t)dims.size();
+    for (size_t i = 0; i < dims.size(); ++i) metadata.dimensions[i] = dims[i];
+    memset(&entry, 0, sizeof(entry));
+    entry.key = iree_make_cstring_view(key);
+    entry.metadata =
+        iree_make_const_byte_span((const uint8_t*)&metadata, sizeof(metadata));
+    entry.length = length;
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+  }
+  iree_io_gguf_tensor_metadata_t metadata;
+  iree_io_parameter_index_entry_t entry;
+};
+
+class ParameterConverterTest : public ::testing::Test {
+ protected:
+  void TearDown() override { iree_io_parameter_transform_release(transform_); }
+
+  void CreateConverter(const char* rule_str,
+                       iree_task_executor_t* executor = NULL) {
+    iree_io_parameter_conversion_rule_t rule;
+    IREE_ASSERT_OK(iree_io_parameter_conversion_rule_parse(
+        iree_make_cstring_view(rule_str), &rule));
+    IREE_ASSERT_OK(iree_io_parameter_converter_create(
+        executor, 1, &rule, iree_allocator_system(), &transform_));
+  }
+
+  template <typename T>
+  std::vector<T> Apply(const TestEntry& test_entry, const void* source) {
+    bool applies = false;
+    uint64_t target_length = 0;
+    IREE_CHECK_OK(iree_io_parameter_transform_query(
+        transform_, &test_entry.entry, &applies, &target_length));
+    EXPECT_TRUE(applies);
+    std::vector<T> target(target_length / sizeof(T));
+    IREE_CHECK_OK(iree_io_parameter_transform_apply(
+        transform_, &test_entry.entry,
+        iree_make_const_byte_span(source, test_entry.entry.length),
+        iree_make_byte_span(target.data(), target.size() * sizeof(T))));
+    return target;
+  }
+
+  iree_io_parameter_transform_t* transform_ = NULL;
+};
+
+TEST_F(ParameterConverterTest, ParseRule) {
+  iree_io_parameter_conversion_rule_t rule;
+  IREE_ASSERT_OK(iree_io_parameter_conversion_rule_parse(
+      IREE_SV("blk.*.weight=f16,pack:16x1,transpose_inner"), &rule));
+  EXPECT_TRUE(iree_string_view_equal(rule.pattern, IREE_SV("blk.*.weight")));
+  EXPECT_EQ(rule.element_type, IREE_HAL_ELEMENT_TYPE_FLOAT_16);
+  EXPECT_EQ(rule.tile_sizes[0], 16u);
+  EXPECT_EQ(rule.tile_sizes[1], 1u);
+  EXPECT_EQ(rule.flags, IREE_IO_PARAMETER_CONVERSION_FLAG_TRANSPOSE_INNER);
+
+  EXPECT_THAT(Status(iree_io_parameter_conversion_rule_parse(IREE_SV("a"),
+                                                             &rule)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_io_parameter_conversion_rule_parse(
+                  IREE_SV("a=pack:0x4"), &rule)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_io_parameter_conversion_rule_parse(IREE_SV("a=i4"),
+                                                             &rule)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_io_parameter_conversion_rule_parse(
+                  IREE_SV("a=f32,transpose_outer"), &rule)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+TEST_F(ParameterConverterTest, UnmatchedKey) {
+  CreateConverter("weight=f32");
+  TestEntry test_entry("bias", IREE_IO_GGUF_TENSOR_TYPE_F16, {4}, 8);
+  bool applies = true;
+  uint64_t target_length = 1;
+  IREE_ASSERT_OK(iree_io_parameter_transform_query(
+      transform_, &test_entry.entry, &applies, &target_length));
+  EXPECT_FALSE(applies);
+  EXPECT_EQ(target_length, 0u);
+}
+
+TEST_F(ParameterConverterTest, MissingMetadata) {
+  CreateConverter("*=f32");
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_F16, {4}, 8);
+  test_entry.entry.metadata = iree_const_byte_span_empty();
+  bool applies = false;
+  uint64_t target_length = 0;
+  EXPECT_THAT(Status(iree_io_parameter_transform_query(
+                  transform_, &test_entry.entry, &applies, &target_length)),
+              StatusIs(StatusCode::kFailedPrecondition));
+}
+
+TEST_F(ParameterConverterTest, DequantizeQ8_0) {
+  CreateConverter("*=f32");
+  struct {
+    uint16_t d;
+    int8_t qs[32];
+  } block;
+  block.d = iree_math_f32_to_f16(0.5f);
+  std::vector<float> expected(32);
+  for (int i = 0; i < 32; ++i) {
+    block.qs[i] = (int8_t)(i - 16);
+    expected[i] = (i - 16) * 0.5f;
+  }
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_Q8_0, {32},
+                       sizeof(block));
+  EXPECT_THAT(Apply<float>(test_entry, &block), ElementsAreArray(expected));
+}
+
+TEST_F(ParameterConverterTest, DequantizeQ4_0) {
+  CreateConverter("*=f32");
+  struct {
+    uint16_t d;
+    uint8_t qs[16];
+  } block;
+  block.d = iree_math_f32_to_f16(2.0f);
+  std::vector<float> expected(32);
+  for (int i = 0; i < 16; ++i) {
+    block.qs[i] = (uint8_t)((15 - i) << 4 | i);
+    expected[i] = (i - 8) * 2.0f;
+    expected[i + 16] = (15 - i - 8) * 2.0f;
+  }
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_Q4_0, {32},
+                       sizeof(block));
+  EXPECT_THAT(Apply<float>(test_entry, &block), ElementsAreArray(expected));
+}
+
+TEST_F(ParameterConverterTest, PackWithPadding) {
+  CreateConverter("*=pack:2x2");
+  // 3x3 matrix packed into 2x2 tiles of 2x2 elements padded with zeros.
+  const float source[9] = {
+      1, 2, 3,  //
+      4, 5, 6,  //
+      7, 8, 9,  //
+  };
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_F32, {3, 3},
+                       sizeof(source));
+  EXPECT_THAT(Apply<float>(test_entry, source),
+              ElementsAre(1, 2, 4, 5,  //
+                          3, 0, 6, 0,  //
+                          7, 8, 0, 0,  //
+                          9, 0, 0, 0));
+}
+
+TEST_F(ParameterConverterTest, PackTransposeInner) {
+  CreateConverter("*=pack:2x2,transpose_inner");
+  const float source[4] = {
+      1, 2,  //
+      3, 4,  //
+  };
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_F32, {2, 2},
+                       sizeof(source));
+  EXPECT_THAT(Apply<float>(test_entry, source), ElementsAre(1, 3, 2, 4));
+}
+
+TEST_F(ParameterConverterTest, ConvertAndPack) {
+  CreateConverter("*=f16,pack:1x2");
+  const float source[4] = {1, 2, 3, 4};
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_F32, {4, 1},
+                       sizeof(source));
+  EXPECT_THAT(Apply<uint16_t>(test_entry, source),
+              ElementsAre(iree_math_f32_to_f16(1), iree_math_f32_to_f16(2),
+                          iree_math_f32_to_f16(3), iree_math_f32_to_f16(4)));
+}
+
+TEST_F(ParameterConverterTest, PackQuantizedFails) {
+  CreateConverter("*=pack:16x1");
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_Q8_0, {32, 2},
+                       2 * 34);
+  bool applies = false;
+  uint64_t target_length = 0;
+  EXPECT_THAT(Status(iree_io_parameter_transform_query(
+                  transform_, &test_entry.entry, &applies, &target_length)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+// Tests that large conversions split across executor workers produce the same
+// results as converting inline.
+TEST_F(ParameterConverterTest, ExecutorTiles) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+  CreateConverter("*=f32,pack:8x4", executor);
+  iree_task_executor_release(executor);  // retained by the converter
+
+  const uint64_t rows = 1027;
+  const uint64_t cols = 300;
+  std::vector<uint16_t> source(rows * cols);
+  for (size_t i = 0; i < source.size(); ++i) {
+    source[i] = iree_math_f32_to_f16((float)(i % 2048));
+  }
+  TestEntry test_entry("weight", IREE_IO_GGUF_TENSOR_TYPE_F16, {cols, rows},
+                       source.size() * sizeof(uint16_t));
+  std::vector<float> target = Apply<float>(test_entry, source.data());
+
+  const uint64_t outer1 = (cols + 3) / 4;
+  ASSERT_EQ(target.size(), ((rows + 7) / 8) * outer1 * 8 * 4);
+  for (uint64_t r = 0; r < rows; ++r) {
+    for (uint64_t c = 0; c < cols; ++c) {
+      uint64_t index =
+          ((r / 8) * outer1 + c / 4) * 8 * 4 + (r % 8) * 4 + (c % 4);
+      ASSERT_EQ(target[index], (float)((r * cols + c) % 2048));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace iree
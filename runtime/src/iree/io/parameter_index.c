@@ -24,8 +24,73 @@ struct iree_io_parameter_index_t {
   iree_host_size_t entry_count;
   // Dense list of entries in the index. Grows as needed.
   iree_io_parameter_index_entry_t** entries;
+
+  // Total capacity of the key table in slots. Always a power of two.
+  iree_host_size_t key_table_capacity;
+  // Open-addressed hash table mapping keys to entries. Each slot holds the
+  // ordinal of an entry plus one or 0 if the slot is empty. Only the first
+  // entry added with a particular key is inserted.
+  iree_host_size_t* key_table;
 };
 
+// Returns the 64-bit FNV-1a hash of |key|.
+static uint64_t iree_io_parameter_index_hash_key(iree_string_view_t key) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < key.size; ++i) {
+    hash ^= (uint8_t)key.data[i];
+    hash *= 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Returns the key table slot for |key|: either the slot holding the entry with
+// a matching key or the empty slot where it would be inserted.
+static iree_host_size_t iree_io_parameter_index_find_slot_unsafe(
+    iree_io_parameter_index_t* index, iree_string_view_t key) {
+  const iree_host_size_t mask = index->key_table_capacity - 1;
+  iree_host_size_t slot =
+      (iree_host_size_t)iree_io_parameter_index_hash_key(key) & mask;
+  while (index->key_table[slot] != 0) {
+    const iree_io_parameter_index_entry_t* entry =
+        index->entries[index->key_table[slot] - 1];
+    if (iree_string_view_equal(key, entry->key)) break;
+    slot = (slot + 1) & mask;
+  }
+  return slot;
+}
+
+// Inserts the entry at ordinal |i| into the key table if no entry with the
+// same key is present. The table must have at least one empty slot.
+static void iree_io_parameter_index_insert_key_unsafe(
+    iree_io_parameter_index_t* index, iree_host_size_t i) {
+  iree_host_size_t slot =
+      iree_io_parameter_index_find_slot_unsafe(index, index->entries[i]->key);
+  if (index->key_table[slot] == 0) index->key_table[slot] = i + 1;
+}
+
+// Grows the key table to keep its load factor under 50% with |entry_count|
+// entries and reinserts all existing entries.
+static iree_status_t iree_io_parameter_index_reserve_keys_unsafe(
+    iree_io_parameter_index_t* index, iree_host_size_t entry_count) {
+  iree_host_size_t new_capacity = iree_max(32, index->key_table_capacity);
+  while (new_capacity < entry_count * 2) new_capacity *= 2;
+  if (new_capacity == index->key_table_capacity) return iree_ok_status();
+
+  iree_host_size_t* new_key_table = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      index->host_allocator, new_capacity * sizeof(index->key_table[0]),
+      (void**)&new_key_table));
+  iree_allocator_free(index->host_allocator, index->key_table);
+  index->key_table_capacity = new_capacity;
+  index->key_table = new_key_table;
+
+  // Reinsert in entry order so the first entry with a key keeps winning.
+  for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
+    iree_io_parameter_index_insert_key_unsafe(index, i);
+  }
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
     iree_allocator_t host_allocator, iree_io_parameter_index_t** out_index) {
   IREE_ASSERT_ARGUMENT(out_index);
@@ -46,6 +111,8 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_create(
   index->entry_capacity = 0;
   index->entry_count = 0;
   index->entries = NULL;
+  index->key_table_capacity = 0;
+  index->key_table = NULL;
 
   *out_index = index;
   IREE_TRACE_ZONE_END(z0);
@@ -65,12 +132,16 @@ static void iree_io_parameter_index_destroy(iree_io_parameter_index_t* index) {
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
         iree_io_file_handle_release(entry->storage.file.handle);
         break;
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED:
+        iree_io_file_handle_release(entry->storage.compressed.handle);
+        break;
     }
     iree_allocator_free(host_allocator, entry);
   }
   if (index->entries) {
     iree_allocator_free(host_allocator, index->entries);
   }
+  iree_allocator_free(host_allocator, index->key_table);
 
   iree_slim_mutex_deinitialize(&index->mutex);
 
@@ -116,6 +187,7 @@ static iree_status_t iree_io_parameter_index_reserve_unsafe(
   if (iree_status_is_ok(status)) {
     index->entry_capacity = new_capacity;
     index->entries = new_entries;
+    status = iree_io_parameter_index_reserve_keys_unsafe(index, new_capacity);
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -147,6 +219,10 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
     status = iree_io_parameter_index_reserve_unsafe(
         index, iree_max(16, index->entry_capacity * 2));
   }
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_index_reserve_keys_unsafe(
+        index, index->entry_count + 1);
+  }
 
   // Clone the entry memory. We allocate it as a single slab and stash the
   // pointers for easier access by callers. Entries themselves are never
@@ -179,6 +255,10 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
         cloned_entry->storage.file = entry->storage.file;
         iree_io_file_handle_retain(cloned_entry->storage.file.handle);
         break;
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED:
+        cloned_entry->storage.compressed = entry->storage.compressed;
+        iree_io_file_handle_retain(cloned_entry->storage.compressed.handle);
+        break;
     }
     memcpy((void*)cloned_entry->key.data, entry->key.data, entry->key.size);
     memcpy((void*)cloned_entry->metadata.data, entry->metadata.data,
@@ -186,6 +266,7 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
 
     // Append the entry to the file index.
     index->entries[index->entry_count++] = cloned_entry;
+    iree_io_parameter_index_insert_key_unsafe(index, index->entry_count - 1);
   }
 
   iree_slim_mutex_unlock(&index->mutex);
@@ -193,6 +274,32 @@ iree_io_parameter_index_add(iree_io_parameter_index_t* index,
   return status;
 }
 
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_merge(iree_io_parameter_index_t* index,
+                              iree_io_parameter_index_t* source_index) {
+  IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(source_index);
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Source entries are immutable once added so it's safe to add them to the
+  // target without holding the source lock.
+  iree_host_size_t source_count = iree_io_parameter_index_count(source_index);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, source_count);
+  iree_status_t status = iree_io_parameter_index_reserve(
+      index, iree_io_parameter_index_count(index) + source_count);
+  for (iree_host_size_t i = 0; i < source_count && iree_status_is_ok(status);
+       ++i) {
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    status = iree_io_parameter_index_get(source_index, i, &entry);
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_index_add(index, entry);
+    }
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
     iree_io_parameter_index_t* index, iree_host_size_t i,
     const iree_io_parameter_index_entry_t** out_entry) {
@@ -226,11 +333,11 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
   iree_slim_mutex_lock(&index->mutex);
 
   iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < index->entry_count; ++i) {
-    const iree_io_parameter_index_entry_t* entry = index->entries[i];
-    if (iree_string_view_equal(key, entry->key)) {
-      *out_entry = entry;
-      break;
+  if (index->key_table_capacity > 0) {
+    iree_host_size_t slot =
+        iree_io_parameter_index_find_slot_unsafe(index, key);
+    if (index->key_table[slot] != 0) {
+      *out_entry = index->entries[index->key_table[slot] - 1];
     }
   }
   if (*out_entry == NULL) {
@@ -295,10 +402,33 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_dump(
       }
       case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
         IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
-            builder, "%16" PRIu64 " | %16" PRIu64 " | %16" PRIu64 " | `%.*s`\n",
+            builder, "%16" PRIu64 " | %16" PRIu64 " | %16" PRIu64 " | `%.*s`",
             entry->storage.file.offset,
             entry->storage.file.offset + entry->length, entry->length,
             (int)entry->key.size, entry->key.data));
+        // Flag entries the parser reported as too unaligned to be aliased.
+        const uint64_t alignment = entry->storage.file.alignment;
+        if (alignment && alignment < IREE_IO_PARAMETER_ALIAS_ALIGNMENT) {
+          IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+              builder, " (unaligned: %" PRIu64 "B)", alignment));
+        }
+        IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, "\n"));
+        break;
+      }
+      case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED: {
+        // Ranges are the physical payload; the length is uncompressed.
+        iree_string_view_t compression_name = iree_io_compression_type_name(
+            entry->storage.compressed.compression_type);
+        IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+            builder,
+            "%16" PRIu64 " | %16" PRIu64 " | %16" PRIu64
+            " | `%.*s` (%.*s: %" PRIu64 "B)\n",
+            entry->storage.compressed.offset,
+            entry->storage.compressed.offset +
+                entry->storage.compressed.storage_length,
+            entry->length, (int)entry->key.size, entry->key.data,
+            (int)compression_name.size, compression_name.data,
+            entry->storage.compressed.storage_length));
         break;
       }
       default: {
@@ -8,6 +8,7 @@
 #define IREE_IO_PARAMETER_INDEX_H_
 
 #include "iree/base/api.h"
+#include "iree/io/compression.h"
 #include "iree/io/file_handle.h"
 
 #ifdef __cplusplus
@@ -23,6 +24,9 @@ typedef enum iree_io_parameter_index_entry_storage_type_e {
   // Parameter is backed by a range of bytes within a file. Access rights are
   // inherited from the file handle.
   IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE,
+  // Parameter is backed by a chunked compressed payload within a file. See
+  // iree/io/compression.h for the payload layout. Parameters are read-only.
+  IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED,
 } iree_io_parameter_index_entry_storage_type_t;
 
 // Power of two; enough bytes to fit complex128 (complex<f64>).
@@ -30,6 +34,11 @@ typedef enum iree_io_parameter_index_entry_storage_type_e {
 // fast paths while 8 and 16 may require emulation.
 #define IREE_IO_PARAMETER_MAX_SPLAT_PATTERN_LENGTH 16
 
+// Alignment in bytes that file-backed parameter storage must have in order to
+// be aliased directly by a device buffer instead of being copied. Matches the
+// binding alignment assumed by compiled dispatches.
+#define IREE_IO_PARAMETER_ALIAS_ALIGNMENT 64
+
 // An entry in an in-memory file index.
 typedef struct iree_io_parameter_index_entry_t {
   // Key used to reference this file.
@@ -63,10 +72,38 @@ typedef struct iree_io_parameter_index_entry_t {
       iree_io_file_handle_t* handle;
       // Offset of the entry in bytes relative to the base file offset.
       uint64_t offset;
+      // Alignment in bytes of |offset| as reported by the format parser or 0
+      // if unknown. Entries aligned to at least
+      // IREE_IO_PARAMETER_ALIAS_ALIGNMENT in mapped files can be aliased
+      // without copies on devices that can import host memory.
+      uint64_t alignment;
     } file;
+    // Describes a parameter stored as a chunked compressed payload.
+    // Valid when type is IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED.
+    struct {
+      // File handle backing this entry, retained.
+      iree_io_file_handle_t* handle;
+      // Offset of the payload (starting with its chunk table) in bytes
+      // relative to the base file offset.
+      uint64_t offset;
+      // Total length of the payload in the file in bytes.
+      uint64_t storage_length;
+      // Uncompressed length of each chunk in bytes.
+      uint64_t chunk_length;
+      // Compression scheme applied to each chunk.
+      iree_io_compression_type_t compression_type;
+    } compressed;
   } storage;
 } iree_io_parameter_index_entry_t;
 
+// Returns the largest power-of-two alignment of |offset| up to
+// |max_alignment| (which must be a power of two).
+static inline uint64_t iree_io_parameter_offset_alignment(
+    uint64_t offset, uint64_t max_alignment) {
+  const uint64_t alignment = offset & (~offset + 1);
+  return alignment && alignment < max_alignment ? alignment : max_alignment;
+}
+
 // An in-memory file index mapping keys to byte ranges in referenced files.
 // A single index may contain entries from multiple files. Each parameter is
 // backed by a contiguous range in a single file.
@@ -108,6 +145,13 @@ IREE_API_EXPORT iree_status_t
 iree_io_parameter_index_add(iree_io_parameter_index_t* index,
                             const iree_io_parameter_index_entry_t* entry);
 
+// Adds all entries in |source_index| to |index| in the order they were added
+// to |source_index|. Keys and metadata are copied and file handles retained
+// such that |source_index| may be released after the call returns.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_merge(iree_io_parameter_index_t* index,
+                              iree_io_parameter_index_t* source_index);
+
 // Returns the entry at index |i| in [0, iree_io_parameter_index_count).
 // The returned |out_entry| is valid for the lifetime of the index.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
@@ -115,6 +159,7 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_get(
     const iree_io_parameter_index_entry_t** out_entry);
 
 // Performs a file entry lookup of |key| in the index and returns it.
+// If multiple entries share the same key the first one added is returned.
 // The returned |out_entry| is valid for the lifetime of the index.
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_lookup(
     iree_io_parameter_index_t* index, iree_string_view_t key,
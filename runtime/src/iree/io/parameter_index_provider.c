@@ -6,20 +6,54 @@
 
 #include "iree/io/parameter_index_provider.h"
 
+#include "iree/base/internal/synchronization.h"
 #include "iree/hal/utils/file_cache.h"
+#include "iree/io/compression.h"
+#include "iree/io/parameter_lazy_buffer.h"
+#include "iree/io/stream.h"
+#include "iree/task/task.h"
 
 // Limit concurrent operations to avoid blowing the stack. This is arbitrary and
 // if we wanted to support more we could switch to using heap allocations or
 // a growable stack scratchpad.
 #define IREE_IO_PARAMETER_OP_BATCH_MAX_CONCURRENCY 8
 
+// A host allocation file handle imported as a device buffer.
+// Parameters within the file are aliased as subspans of the buffer so that the
+// file is only imported (and on some devices registered) once.
+typedef struct iree_io_parameter_alias_entry_t {
+  // Allocator the buffer was imported into, retained.
+  iree_hal_allocator_t* allocator;
+  // File handle that was imported, retained.
+  iree_io_file_handle_t* handle;
+  // Parameters requested by the load the import was performed for.
+  iree_hal_buffer_params_t params;
+  // Imported buffer covering the entire file or NULL if the import failed.
+  iree_hal_buffer_t* buffer;
+} iree_io_parameter_alias_entry_t;
+
 typedef struct iree_io_parameter_index_provider_t {
   iree_io_parameter_provider_t base;
   iree_allocator_t host_allocator;
   iree_host_size_t max_concurrent_operations;
+  iree_io_parameter_index_provider_flags_t flags;
   iree_string_view_t scope;
   iree_io_parameter_index_t* index;
   iree_hal_file_cache_t* file_cache;
+  // Residency cache for lazily loaded parameters; NULL if not lazy.
+  iree_io_parameter_lazy_cache_t* lazy_cache;
+  // Transform applied to parameters as they are loaded; NULL if none.
+  iree_io_parameter_transform_t* transform;
+  // Executor used to decompress chunks in parallel; NULL to run inline.
+  iree_task_executor_t* executor;
+  // Guards the alias entries list.
+  iree_slim_mutex_t alias_mutex;
+  // Total capacity of the alias entries list in elements.
+  iree_host_size_t alias_capacity;
+  // Currently used alias entry count in elements.
+  iree_host_size_t alias_count;
+  // Dense list of imported files. Grows as needed.
+  iree_io_parameter_alias_entry_t* alias_entries;
 } iree_io_parameter_index_provider_t;
 
 static const iree_io_parameter_provider_vtable_t
@@ -31,18 +65,40 @@ iree_io_parameter_index_provider_cast(
   return (iree_io_parameter_index_provider_t*)base_provider;
 }
 
+IREE_API_EXPORT void iree_io_parameter_index_provider_options_initialize(
+    iree_io_parameter_index_provider_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->max_concurrent_operations =
+      IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS;
+}
+
 IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_string_view_t scope, iree_io_parameter_index_t* index,
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
     iree_io_parameter_provider_t** out_provider) {
+  iree_io_parameter_index_provider_options_t options;
+  iree_io_parameter_index_provider_options_initialize(&options);
+  options.max_concurrent_operations = max_concurrent_operations;
+  return iree_io_parameter_index_provider_create_with_options(
+      scope, index, &options, host_allocator, out_provider);
+}
+
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_options(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    const iree_io_parameter_index_provider_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
   IREE_ASSERT_ARGUMENT(index);
+  IREE_ASSERT_ARGUMENT(options);
   IREE_ASSERT_ARGUMENT(out_provider);
   *out_provider = NULL;
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, scope.data, scope.size);
 
-  max_concurrent_operations =
-      iree_max(1, iree_min(max_concurrent_operations,
+  iree_host_size_t max_concurrent_operations =
+      iree_max(1, iree_min(options->max_concurrent_operations,
                            IREE_IO_PARAMETER_OP_BATCH_MAX_CONCURRENCY));
 
   iree_io_parameter_index_provider_t* provider = NULL;
@@ -53,6 +109,7 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   provider->base.vtable = &iree_io_parameter_index_provider_vtable;
   provider->host_allocator = host_allocator;
   provider->max_concurrent_operations = max_concurrent_operations;
+  provider->flags = options->flags;
 
   provider->scope = iree_make_string_view(
       (const char*)provider + sizeof(*provider), scope.size);
@@ -61,9 +118,24 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   provider->index = index;
   iree_io_parameter_index_retain(index);
 
+  provider->transform = options->transform;
+  iree_io_parameter_transform_retain(options->transform);
+
+  provider->executor = options->executor;
+  iree_task_executor_retain(options->executor);
+
+  iree_slim_mutex_initialize(&provider->alias_mutex);
+
   iree_status_t status =
       iree_hal_file_cache_create(host_allocator, &provider->file_cache);
 
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(options->flags,
+                        IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LAZY)) {
+    status = iree_io_parameter_lazy_cache_create(
+        options->lazy_residency_budget, host_allocator, &provider->lazy_cache);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_provider = (iree_io_parameter_provider_t*)provider;
   } else {
@@ -73,6 +145,24 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
   return status;
 }
 
+// Drops all imported file buffers. Buffers handed out to callers keep their
+// imports live until they are released.
+static void iree_io_parameter_index_provider_trim_aliases(
+    iree_io_parameter_index_provider_t* provider) {
+  iree_slim_mutex_lock(&provider->alias_mutex);
+  for (iree_host_size_t i = 0; i < provider->alias_count; ++i) {
+    iree_io_parameter_alias_entry_t* entry = &provider->alias_entries[i];
+    iree_hal_buffer_release(entry->buffer);
+    iree_io_file_handle_release(entry->handle);
+    iree_hal_allocator_release(entry->allocator);
+  }
+  iree_allocator_free(provider->host_allocator, provider->alias_entries);
+  provider->alias_entries = NULL;
+  provider->alias_capacity = 0;
+  provider->alias_count = 0;
+  iree_slim_mutex_unlock(&provider->alias_mutex);
+}
+
 static void iree_io_parameter_index_provider_destroy(
     iree_io_parameter_provider_t* IREE_RESTRICT base_provider) {
   iree_io_parameter_index_provider_t* provider =
@@ -80,6 +170,11 @@ static void iree_io_parameter_index_provider_destroy(
   iree_allocator_t host_allocator = provider->host_allocator;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  iree_io_parameter_index_provider_trim_aliases(provider);
+  iree_slim_mutex_deinitialize(&provider->alias_mutex);
+  iree_io_parameter_lazy_cache_release(provider->lazy_cache);
+  iree_io_parameter_transform_release(provider->transform);
+  iree_task_executor_release(provider->executor);
   iree_hal_file_cache_release(provider->file_cache);
   iree_io_parameter_index_release(provider->index);
 
@@ -99,6 +194,10 @@ static iree_status_t iree_io_parameter_index_provider_notify(
     case IREE_IO_PARAMETER_PROVIDER_SIGNAL_SUSPEND:
     case IREE_IO_PARAMETER_PROVIDER_SIGNAL_LOW_MEMORY:
       iree_hal_file_cache_trim(provider->file_cache);
+      iree_io_parameter_index_provider_trim_aliases(provider);
+      if (provider->lazy_cache) {
+        iree_io_parameter_lazy_cache_trim(provider->lazy_cache);
+      }
       break;
     default:
       break;
@@ -154,11 +253,12 @@ static iree_status_t iree_io_parameter_index_provider_resolve(
   return iree_ok_status();
 }
 
-// Validates that the range specified by [offset, offset+length) is in bounds.
+// Validates that the range specified by [offset, offset+length) is in bounds of
+// the |parameter_length| contents of |entry|.
 static iree_status_t iree_io_validate_parameter_range(
     iree_hal_memory_access_t required_access,
-    const iree_io_parameter_index_entry_t* entry, uint64_t offset,
-    uint64_t length) {
+    const iree_io_parameter_index_entry_t* entry, uint64_t parameter_length,
+    uint64_t offset, uint64_t length) {
   iree_hal_memory_access_t allowed_access = IREE_HAL_MEMORY_ACCESS_NONE;
   switch (entry->type) {
     case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
@@ -179,6 +279,14 @@ static iree_status_t iree_io_validate_parameter_range(
             IREE_HAL_MEMORY_ACCESS_WRITE | IREE_HAL_MEMORY_ACCESS_DISCARD;
       }
       break;
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED:
+      // Compressed entries are read-only as writes would change their size.
+      if (iree_all_bits_set(
+              iree_io_file_handle_access(entry->storage.compressed.handle),
+              IREE_IO_FILE_ACCESS_READ)) {
+        allowed_access |= IREE_HAL_MEMORY_ACCESS_READ;
+      }
+      break;
     default:
       // Unknown entries are inaccessible.
       allowed_access = IREE_HAL_MEMORY_ACCESS_NONE;
@@ -203,12 +311,13 @@ static iree_status_t iree_io_validate_parameter_range(
 #endif  // IREE_STATUS_MODE
   }
 
-  if (offset + length > entry->length) {
+  if (offset + length > parameter_length) {
     return iree_make_status(
         IREE_STATUS_OUT_OF_RANGE,
         "parameter `%.*s` range out of bounds (offset=%" PRIu64
         ", length=%" PRIu64 ", size=%" PRIu64 ")",
-        (int)entry->key.size, entry->key.data, offset, length, entry->length);
+        (int)entry->key.size, entry->key.data, offset, length,
+        parameter_length);
   }
 
   return iree_ok_status();
@@ -319,19 +428,26 @@ static void iree_io_parameter_op_batch_begin(
 // Returns the entry, the span indicating source/target ranges, and optionally
 // a file (NULL if a splat). |out_file| is retained and must be released by the
 // caller if set.
+//
+// If |out_transformed_length| is provided the provider transform (if any) is
+// queried and the length of the transformed contents is returned or 0 if the
+// parameter is not transformed. Spans are validated against the transformed
+// contents.
 static iree_status_t iree_io_parameter_op_batch_resolve_entry(
     const iree_io_parameter_op_batch_t* batch, iree_string_view_t scope,
     iree_io_parameter_enumerator_t enumerator, iree_host_size_t i,
     iree_hal_memory_access_t access,
     const iree_io_parameter_index_entry_t** IREE_RESTRICT out_entry,
     iree_io_parameter_span_t* IREE_RESTRICT out_span,
-    iree_hal_file_t** IREE_RESTRICT out_file) {
+    iree_hal_file_t** IREE_RESTRICT out_file,
+    uint64_t* IREE_RESTRICT out_transformed_length) {
   IREE_ASSERT_ARGUMENT(out_entry);
   IREE_ASSERT_ARGUMENT(out_span);
   IREE_ASSERT_ARGUMENT(out_file);
   *out_entry = NULL;
   memset(out_span, 0, sizeof(*out_span));
   *out_file = NULL;
+  if (out_transformed_length) *out_transformed_length = 0;
 
   // Fetch the next parameter to copy and its buffer range.
   iree_string_view_t key = iree_string_view_empty();
@@ -345,14 +461,28 @@ static iree_status_t iree_io_parameter_op_batch_resolve_entry(
       batch->provider, batch->device, batch->queue_affinity, scope, key, access,
       &entry, &file));
 
+  // Check whether the parameter is transformed as part of the operation.
+  iree_status_t status = iree_ok_status();
+  bool transformed = false;
+  uint64_t parameter_length = entry->length;
+  if (out_transformed_length && batch->provider->transform &&
+      entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE) {
+    status = iree_io_parameter_transform_query(
+        batch->provider->transform, entry, &transformed, &parameter_length);
+    if (!transformed) parameter_length = entry->length;
+  }
+
   // Validate the parameter range is in-bounds.
-  iree_status_t status = iree_io_validate_parameter_range(
-      access, entry, span.parameter_offset, span.length);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_validate_parameter_range(
+        access, entry, parameter_length, span.parameter_offset, span.length);
+  }
 
   if (iree_status_is_ok(status)) {
     *out_entry = entry;
     *out_span = span;
     *out_file = file;
+    if (transformed) *out_transformed_length = parameter_length;
   } else {
     iree_hal_file_release(file);
   }
@@ -673,6 +803,522 @@ static void iree_io_file_handle_buffer_release(void* user_data,
   iree_io_file_handle_release((iree_io_file_handle_t*)user_data);
 }
 
+// Returns a buffer retained in |out_buffer| importing the entire host
+// allocation |handle| into |allocator| or NULL if it cannot be imported.
+// Imports are cached such that every parameter in a file shares one import.
+static iree_status_t iree_io_parameter_index_provider_import_file(
+    iree_io_parameter_index_provider_t* provider,
+    iree_hal_allocator_t* allocator, iree_hal_buffer_params_t params,
+    iree_io_file_handle_t* handle, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  iree_slim_mutex_lock(&provider->alias_mutex);
+
+  // Scan for an existing import (or a failed attempt) with the same params.
+  for (iree_host_size_t i = 0; i < provider->alias_count; ++i) {
+    iree_io_parameter_alias_entry_t* entry = &provider->alias_entries[i];
+    if (entry->allocator == allocator && entry->handle == handle &&
+        entry->params.type == params.type &&
+        entry->params.usage == params.usage &&
+        entry->params.access == params.access) {
+      iree_hal_buffer_retain(entry->buffer);
+      *out_buffer = entry->buffer;
+      iree_slim_mutex_unlock(&provider->alias_mutex);
+      return iree_ok_status();
+    }
+  }
+
+  // Ensure there's space to record the import.
+  iree_status_t status = iree_ok_status();
+  if (provider->alias_count == provider->alias_capacity) {
+    iree_host_size_t new_capacity = iree_max(8u, provider->alias_capacity * 2);
+    status = iree_allocator_realloc(
+        provider->host_allocator,
+        new_capacity * sizeof(provider->alias_entries[0]),
+        (void**)&provider->alias_entries);
+    if (iree_status_is_ok(status)) provider->alias_capacity = new_capacity;
+  }
+  if (!iree_status_is_ok(status)) {
+    iree_slim_mutex_unlock(&provider->alias_mutex);
+    return status;
+  }
+
+  // Import the whole file. If the device is unable to import host memory as
+  // device-local (such as when it needs to register it) we can optionally
+  // retry requesting device-visible host memory.
+  iree_byte_span_t host_allocation =
+      iree_io_file_handle_primitive(handle).value.host_allocation;
+  iree_hal_external_buffer_t external_buffer = {
+      .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+      .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+      .size = host_allocation.data_length,
+      .handle =
+          {
+              .host_allocation =
+                  {
+                      .ptr = host_allocation.data,
+                  },
+          },
+  };
+  iree_hal_buffer_params_t import_params = params;
+  iree_hal_buffer_t* buffer = NULL;
+  for (int attempt = 0; attempt < 2 && !buffer; ++attempt) {
+    if (attempt > 0) {
+      if (!iree_all_bits_set(
+              provider->flags,
+              IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_ALIAS_HOST_MEMORY) ||
+          !iree_all_bits_set(params.type, IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL)) {
+        break;
+      }
+      import_params.type =
+          (params.type & ~IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL) |
+          IREE_HAL_MEMORY_TYPE_HOST_LOCAL | IREE_HAL_MEMORY_TYPE_DEVICE_VISIBLE;
+    }
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_io_file_handle_buffer_release,
+        .user_data = handle,
+    };
+    iree_io_file_handle_retain(handle);
+    iree_status_t import_status = iree_hal_allocator_import_buffer(
+        allocator, import_params, &external_buffer, release_callback, &buffer);
+    if (!iree_status_is_ok(import_status)) {
+      // Failed to import - that's ok as callers will fall back to copies.
+      iree_status_ignore(import_status);
+      iree_io_file_handle_release(handle);
+      buffer = NULL;
+    }
+  }
+
+  // Record the result (including failures so they are not retried).
+  iree_io_parameter_alias_entry_t* entry =
+      &provider->alias_entries[provider->alias_count++];
+  entry->allocator = allocator;
+  iree_hal_allocator_retain(allocator);
+  entry->handle = handle;
+  iree_io_file_handle_retain(handle);
+  entry->params = params;
+  entry->buffer = buffer;
+
+  iree_hal_buffer_retain(buffer);
+  *out_buffer = buffer;
+  iree_slim_mutex_unlock(&provider->alias_mutex);
+  return iree_ok_status();
+}
+
+// Tries to alias the |span| of |source_entry| in its host memory-mapped file as
+// a device buffer without copying. Returns a retained buffer in |out_buffer| or
+// NULL if the parameter cannot be aliased and must be copied.
+static iree_status_t iree_io_parameter_index_provider_try_alias(
+    iree_io_parameter_index_provider_t* provider,
+    iree_hal_allocator_t* allocator, iree_hal_buffer_params_t target_params,
+    const iree_io_parameter_index_entry_t* source_entry,
+    iree_io_parameter_span_t span, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (source_entry->type != IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE ||
+      span.buffer_offset != 0) {
+    return iree_ok_status();
+  }
+  iree_io_file_handle_t* handle = source_entry->storage.file.handle;
+  if (iree_io_file_handle_type(handle) !=
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    return iree_ok_status();
+  }
+
+  // Read-only files cannot back buffers that may be written.
+  if (!iree_all_bits_set(iree_io_file_handle_access(handle),
+                         IREE_IO_FILE_ACCESS_WRITE) &&
+      iree_any_bit_set(target_params.access,
+                       IREE_HAL_MEMORY_ACCESS_WRITE |
+                           IREE_HAL_MEMORY_ACCESS_DISCARD)) {
+    return iree_ok_status();
+  }
+
+  // Dispatches assume their bindings are aligned and the parameter must be
+  // aligned in memory (not just file offset) to be aliased.
+  iree_byte_span_t host_allocation =
+      iree_io_file_handle_primitive(handle).value.host_allocation;
+  uint64_t byte_offset =
+      source_entry->storage.file.offset + span.parameter_offset;
+  if (!iree_host_size_has_alignment(
+          (iree_host_size_t)(host_allocation.data + byte_offset),
+          IREE_IO_PARAMETER_ALIAS_ALIGNMENT)) {
+    return iree_ok_status();
+  }
+
+  iree_hal_buffer_t* file_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_parameter_index_provider_import_file(
+      provider, allocator, target_params, handle, &file_buffer));
+  if (!file_buffer) return iree_ok_status();
+  iree_status_t status = iree_hal_buffer_subspan(file_buffer, byte_offset,
+                                                 span.length, out_buffer);
+  iree_hal_buffer_release(file_buffer);
+  return status;
+}
+
+// Host memory holding the transformed or decompressed contents of a parameter.
+typedef struct iree_io_parameter_transformed_storage_t {
+  iree_allocator_t host_allocator;
+  uint8_t data[];
+} iree_io_parameter_transformed_storage_t;
+
+static void iree_io_parameter_transformed_storage_release(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  iree_io_parameter_transformed_storage_t* storage =
+      (iree_io_parameter_transformed_storage_t*)user_data;
+  iree_allocator_free_aligned(storage->host_allocator, storage);
+}
+
+// Reads |length| bytes at |offset| in |handle| into host memory.
+// If the file is already in host memory the returned span references it
+// directly and |out_storage| is NULL. Otherwise |out_storage| must be freed by
+// the caller with iree_allocator_free.
+static iree_status_t iree_io_parameter_index_provider_read_range(
+    iree_io_parameter_index_provider_t* provider, iree_io_file_handle_t* handle,
+    uint64_t offset, uint64_t length, iree_const_byte_span_t* out_contents,
+    void** out_storage) {
+  *out_contents = iree_const_byte_span_empty();
+  *out_storage = NULL;
+  if (iree_io_file_handle_type(handle) ==
+      IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
+    iree_byte_span_t host_allocation =
+        iree_io_file_handle_value(handle).host_allocation;
+    if (offset + length > host_allocation.data_length) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "file range out of bounds (offset=%" PRIu64
+                              ", length=%" PRIu64 ", size=%" PRIhsz ")",
+                              offset, length, host_allocation.data_length);
+    }
+    *out_contents =
+        iree_make_const_byte_span(host_allocation.data + offset, length);
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+  iree_io_stream_t* stream = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_stream_open(IREE_IO_STREAM_MODE_READABLE, handle, offset,
+                              provider->host_allocator, &stream));
+  void* storage = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      provider->host_allocator, (iree_host_size_t)length, &storage);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_stream_read(stream, (iree_host_size_t)length, storage,
+                                 /*out_buffer_length=*/NULL);
+  }
+  iree_io_stream_release(stream);
+  if (iree_status_is_ok(status)) {
+    *out_contents = iree_make_const_byte_span(storage, length);
+    *out_storage = storage;
+  } else {
+    iree_allocator_free(provider->host_allocator, storage);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Reads the full contents of the file-backed |entry| into host memory.
+// See iree_io_parameter_index_provider_read_range.
+static iree_status_t iree_io_parameter_index_provider_read_entry(
+    iree_io_parameter_index_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry,
+    iree_const_byte_span_t* out_contents, void** out_storage) {
+  return iree_io_parameter_index_provider_read_range(
+      provider, entry->storage.file.handle, entry->storage.file.offset,
+      entry->length, out_contents, out_storage);
+}
+
+// Allocates host storage for |length| bytes of generated parameter contents
+// (transformed or decompressed) aligned such that devices are able to import
+// it directly. Must be freed with iree_allocator_free_aligned unless passed to
+// iree_io_parameter_index_provider_import_storage.
+static iree_status_t iree_io_parameter_index_provider_allocate_storage(
+    iree_io_parameter_index_provider_t* provider, uint64_t length,
+    iree_io_parameter_transformed_storage_t** out_storage) {
+  *out_storage = NULL;
+  iree_io_parameter_transformed_storage_t* storage = NULL;
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc_aligned(
+      provider->host_allocator, sizeof(*storage) + (iree_host_size_t)length,
+      IREE_IO_PARAMETER_ALIAS_ALIGNMENT,
+      offsetof(iree_io_parameter_transformed_storage_t, data),
+      (void**)&storage));
+  storage->host_allocator = provider->host_allocator;
+  *out_storage = storage;
+  return iree_ok_status();
+}
+
+// Wraps |length| bytes of |storage| in a HAL file usable with |device| that
+// takes ownership of the storage. The storage is freed on failure. The
+// returned |out_file| is retained and must be released by the caller.
+static iree_status_t iree_io_parameter_index_provider_import_storage(
+    iree_io_parameter_index_provider_t* provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    iree_io_parameter_transformed_storage_t* storage, uint64_t length,
+    iree_hal_file_t** out_file) {
+  *out_file = NULL;
+  iree_io_file_handle_t* handle = NULL;
+  iree_io_file_handle_release_callback_t release_callback = {
+      .fn = iree_io_parameter_transformed_storage_release,
+      .user_data = storage,
+  };
+  iree_status_t status = iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ, iree_make_byte_span(storage->data, length),
+      release_callback, provider->host_allocator, &handle);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free_aligned(provider->host_allocator, storage);
+    return status;
+  }
+  status = iree_hal_file_import(device, queue_affinity,
+                                IREE_HAL_MEMORY_ACCESS_READ, handle,
+                                IREE_HAL_EXTERNAL_FILE_FLAG_NONE, out_file);
+  iree_io_file_handle_release(handle);
+  return status;
+}
+
+// Applies the provider transform to |entry| and returns a HAL file usable with
+// |device| containing the |transformed_length| bytes of transformed contents.
+// The transform runs synchronously as it only touches host memory; the file can
+// then be read into device buffers like any other parameter file. The returned
+// |out_file| is retained and must be released by the caller.
+static iree_status_t iree_io_parameter_index_provider_transform_entry(
+    iree_io_parameter_index_provider_t* provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_io_parameter_index_entry_t* entry, uint64_t transformed_length,
+    iree_hal_file_t** out_file) {
+  *out_file = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, entry->key.data, entry->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, transformed_length);
+
+  iree_const_byte_span_t source_contents = iree_const_byte_span_empty();
+  void* source_storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_parameter_index_provider_read_entry(
+              provider, entry, &source_contents, &source_storage));
+
+  iree_io_parameter_transformed_storage_t* storage = NULL;
+  iree_status_t status = iree_io_parameter_index_provider_allocate_storage(
+      provider, transformed_length, &storage);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_transform_apply(
+        provider->transform, entry, source_contents,
+        iree_make_byte_span(storage->data, transformed_length));
+  }
+  iree_allocator_free(provider->host_allocator, source_storage);
+
+  // Wrap the storage in a file that owns it.
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_index_provider_import_storage(
+        provider, device, queue_affinity, storage, transformed_length,
+        out_file);
+  } else {
+    iree_allocator_free_aligned(provider->host_allocator, storage);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Chunks of a compressed parameter being decompressed in parallel.
+typedef struct iree_io_parameter_decompression_t {
+  iree_io_compression_type_t compression_type;
+  uint64_t chunk_length;
+  // Chunk table entries for the chunks being decompressed plus one.
+  const uint64_t* chunk_offsets;
+  // Stored chunks starting at chunk_offsets[0].
+  const uint8_t* source;
+  // Decompressed contents of all chunks.
+  iree_byte_span_t target;
+} iree_io_parameter_decompression_t;
+
+static iree_status_t iree_io_parameter_decompression_decompress_chunk(
+    const iree_io_parameter_decompression_t* decompression, uint32_t index) {
+  const uint64_t source_offset =
+      decompression->chunk_offsets[index] - decompression->chunk_offsets[0];
+  const uint64_t source_length = decompression->chunk_offsets[index + 1] -
+                                 decompression->chunk_offsets[index];
+  const uint64_t target_offset = index * decompression->chunk_length;
+  const uint64_t target_length =
+      iree_min(decompression->chunk_length,
+               decompression->target.data_length - target_offset);
+  return iree_io_decompress_chunk(
+      decompression->compression_type,
+      iree_make_const_byte_span(decompression->source + source_offset,
+                                (iree_host_size_t)source_length),
+      iree_make_byte_span(decompression->target.data + target_offset,
+                          (iree_host_size_t)target_length));
+}
+
+static iree_status_t iree_io_parameter_decompression_dispatch_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  return iree_io_parameter_decompression_decompress_chunk(
+      (const iree_io_parameter_decompression_t*)user_context,
+      tile_context->workgroup_xyz[0]);
+}
+
+// Decompresses |chunk_count| chunks described by |decompression| with one
+// tile per chunk distributed across the provider executor when available.
+// Returns after all chunks have been decompressed.
+static iree_status_t iree_io_parameter_index_provider_decompress_chunks(
+    iree_io_parameter_index_provider_t* provider, uint32_t chunk_count,
+    const iree_io_parameter_decompression_t* decompression) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, chunk_count);
+
+  // Single chunks are not worth the round-trip through the executor.
+  if (!provider->executor || chunk_count <= 1) {
+    iree_status_t status = iree_ok_status();
+    for (uint32_t i = 0; i < chunk_count && iree_status_is_ok(status); ++i) {
+      status = iree_io_parameter_decompression_decompress_chunk(decompression,
+                                                                i);
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(IREE_SV("iree_io_parameter_decompression"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {chunk_count, 1, 1};
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(
+          iree_io_parameter_decompression_dispatch_tile, (void*)decompression),
+      workgroup_size, workgroup_count, &dispatch_task);
+
+  // The fence signals the scope when the dispatch completes so that we can
+  // wait for it below.
+  iree_task_fence_t* fence = NULL;
+  iree_status_t status =
+      iree_task_executor_acquire_fence(provider->executor, &scope, &fence);
+  if (iree_status_is_ok(status)) {
+    iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_task.header);
+    iree_task_executor_submit(provider->executor, &submission);
+    iree_task_executor_flush(provider->executor);
+    status = iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_task_scope_consume_status(&scope);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Decompresses the chunks of the compressed |entry| covering |length| bytes at
+// |parameter_offset| and returns a HAL file usable with |device| containing
+// them. Only the chunk table entries and chunks covering the range are read.
+// |out_file_offset| receives the offset of |parameter_offset| in the file. The
+// returned |out_file| is retained and must be released by the caller.
+static iree_status_t iree_io_parameter_index_provider_decompress_entry(
+    iree_io_parameter_index_provider_t* provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_io_parameter_index_entry_t* entry, uint64_t parameter_offset,
+    uint64_t length, iree_hal_file_t** out_file, uint64_t* out_file_offset) {
+  IREE_ASSERT_GT(length, 0);
+  *out_file = NULL;
+  *out_file_offset = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, entry->key.data, entry->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+
+  // Select the chunks covering the requested range.
+  iree_io_file_handle_t* handle = entry->storage.compressed.handle;
+  const uint64_t chunk_length = entry->storage.compressed.chunk_length;
+  const uint64_t total_chunk_count =
+      iree_io_chunked_payload_chunk_count(entry->length, chunk_length);
+  const uint64_t first_chunk = parameter_offset / chunk_length;
+  const uint64_t last_chunk = (parameter_offset + length - 1) / chunk_length;
+  const uint64_t chunk_count = last_chunk - first_chunk + 1;
+  if (chunk_count > UINT32_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "parameter `%.*s` range spans too many chunks",
+                            (int)entry->key.size, entry->key.data);
+  }
+
+  // Read the slice of the chunk table for the selected chunks and verify it.
+  iree_const_byte_span_t table_contents = iree_const_byte_span_empty();
+  void* table_storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_parameter_index_provider_read_range(
+              provider, handle,
+              entry->storage.compressed.offset + first_chunk * sizeof(uint64_t),
+              iree_io_chunked_payload_table_size(chunk_count), &table_contents,
+              &table_storage));
+  const uint64_t* chunk_offsets = (const uint64_t*)table_contents.data;
+  iree_status_t status = iree_ok_status();
+  const uint64_t min_offset =
+      iree_io_chunked_payload_table_size(total_chunk_count);
+  for (uint64_t i = 0; i <= chunk_count; ++i) {
+    const uint64_t offset = chunk_offsets[i];
+    if (offset < min_offset ||
+        offset > entry->storage.compressed.storage_length ||
+        (i > 0 && offset < chunk_offsets[i - 1])) {
+      status = iree_make_status(IREE_STATUS_DATA_LOSS,
+                                "parameter `%.*s` chunk table corrupt at chunk "
+                                "%" PRIu64,
+                                (int)entry->key.size, entry->key.data,
+                                first_chunk + i);
+      break;
+    }
+  }
+
+  // Read the stored chunks.
+  iree_const_byte_span_t chunk_contents = iree_const_byte_span_empty();
+  void* chunk_storage = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_index_provider_read_range(
+        provider, handle,
+        entry->storage.compressed.offset + chunk_offsets[0],
+        chunk_offsets[chunk_count] - chunk_offsets[0], &chunk_contents,
+        &chunk_storage);
+  }
+
+  // Decompress all chunks into storage that becomes the file the parameter is
+  // read from.
+  const uint64_t target_offset = first_chunk * chunk_length;
+  const uint64_t target_length =
+      iree_min(entry->length, (last_chunk + 1) * chunk_length) - target_offset;
+  iree_io_parameter_transformed_storage_t* storage = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_index_provider_allocate_storage(
+        provider, target_length, &storage);
+  }
+  if (iree_status_is_ok(status)) {
+    const iree_io_parameter_decompression_t decompression = {
+        .compression_type = entry->storage.compressed.compression_type,
+        .chunk_length = chunk_length,
+        .chunk_offsets = chunk_offsets,
+        .source = chunk_contents.data,
+        .target = iree_make_byte_span(storage->data, target_length),
+    };
+    status = iree_io_parameter_index_provider_decompress_chunks(
+        provider, (uint32_t)chunk_count, &decompression);
+  }
+  iree_allocator_free(provider->host_allocator, chunk_storage);
+  iree_allocator_free(provider->host_allocator, table_storage);
+
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_index_provider_import_storage(
+        provider, device, queue_affinity, storage, target_length, out_file);
+  } else {
+    iree_allocator_free_aligned(provider->host_allocator, storage);
+  }
+  if (iree_status_is_ok(status)) {
+    *out_file_offset = parameter_offset - target_offset;
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 static iree_status_t iree_io_parameter_index_provider_load(
     iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
     iree_hal_queue_affinity_t queue_affinity,
@@ -703,9 +1349,10 @@ static iree_status_t iree_io_parameter_index_provider_load(
     const iree_io_parameter_index_entry_t* source_entry = NULL;
     iree_io_parameter_span_t span;
     iree_hal_file_t* source_file = NULL;  // retained, NULL if splat
+    uint64_t transformed_length = 0;      // 0 if not transformed
     status = iree_io_parameter_op_batch_resolve_entry(
         &batch, source_scope, enumerator, i, IREE_HAL_MEMORY_ACCESS_READ,
-        &source_entry, &span, &source_file);
+        &source_entry, &span, &source_file, &transformed_length);
     if (iree_status_is_ok(status)) {
       IREE_TRACE_ZONE_APPEND_TEXT(z_entry, source_entry->key.data,
                                   source_entry->key.size);
@@ -729,44 +1376,60 @@ static iree_status_t iree_io_parameter_index_provider_load(
     // allow us to map files that we already have open via other mechanisms
     // (FILE, fd, etc).
     iree_hal_buffer_t* target_buffer = NULL;
-    if (iree_status_is_ok(status) &&
-        source_entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE &&
-        iree_io_file_handle_type(source_entry->storage.file.handle) ==
-            IREE_IO_FILE_HANDLE_TYPE_HOST_ALLOCATION) {
-      iree_byte_span_t host_allocation =
-          iree_io_file_handle_primitive(source_entry->storage.file.handle)
-              .value.host_allocation;
-      iree_hal_external_buffer_t external_buffer = {
-          .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
-          .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
-          .size = host_allocation.data_length,
-          .handle =
-              {
-                  .host_allocation =
-                      {
-                          .ptr = host_allocation.data +
-                                 source_entry->storage.file.offset,
-                      },
-              },
-      };
-      iree_hal_buffer_release_callback_t release_callback = {
-          .fn = iree_io_file_handle_buffer_release,
-          .user_data = source_entry->storage.file.handle,
-      };
-      iree_io_file_handle_retain(source_entry->storage.file.handle);
-      iree_status_t import_status = iree_hal_allocator_import_buffer(
-          iree_hal_device_allocator(device), target_params, &external_buffer,
-          release_callback, &target_buffer);
-      if (iree_status_is_ok(import_status)) {
-        // Import succeeded - issue a barrier to preserve the async timeline.
-        IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import succeeded");
-      } else {
-        // Failed to import - that's ok as we'll just do the full allocate +
-        // read.
-        IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "import failed");
-        import_status = iree_status_ignore(import_status);
-        iree_io_file_handle_release(source_entry->storage.file.handle);
-      }
+    if (iree_status_is_ok(status) && !transformed_length) {
+      status = iree_io_parameter_index_provider_try_alias(
+          provider, iree_hal_device_allocator(device), target_params,
+          source_entry, span, &target_buffer);
+      IREE_TRACE_ZONE_APPEND_TEXT(
+          z_entry, target_buffer ? "import succeeded" : "import failed");
+    }
+
+    // In lazy mode return a placeholder that reads the parameter when it is
+    // first mapped (such as by a dispatch binding it). Spans that place the
+    // parameter at an offset within the buffer and compressed parameters use
+    // the eager path.
+    if (iree_status_is_ok(status) && !target_buffer && !transformed_length &&
+        provider->lazy_cache && span.buffer_offset == 0 &&
+        source_entry->type !=
+            IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "lazy");
+      status = iree_io_parameter_lazy_buffer_create(
+          provider->lazy_cache, iree_hal_device_allocator(device),
+          target_params, source_entry, source_file,
+          source_file
+              ? source_entry->storage.file.offset + span.parameter_offset
+              : span.parameter_offset,
+          span.length, &target_buffer);
+    }
+
+    // Transformed parameters are converted into host memory that then acts as
+    // the file the parameter is read from. Reads are relative to the start of
+    // the transformed contents.
+    uint64_t source_file_offset =
+        source_file ? source_entry->storage.file.offset : 0;
+    if (iree_status_is_ok(status) && transformed_length) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "transform");
+      iree_hal_file_t* transformed_file = NULL;
+      status = iree_io_parameter_index_provider_transform_entry(
+          provider, device, queue_affinity, source_entry, transformed_length,
+          &transformed_file);
+      iree_hal_file_release(source_file);
+      source_file = transformed_file;
+      source_file_offset = 0;
+    }
+
+    // Compressed parameters have the chunks covering the span decompressed
+    // into host memory that then acts as the file the parameter is read from.
+    // The offset returned already includes the parameter offset.
+    if (iree_status_is_ok(status) && !target_buffer &&
+        source_entry->type ==
+            IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED &&
+        span.length > 0) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z_entry, "decompress");
+      status = iree_io_parameter_index_provider_decompress_entry(
+          provider, device, queue_affinity, source_entry,
+          span.parameter_offset, span.length, &source_file,
+          &source_file_offset);
     }
 
     // When the import path above fails we fall back to alloca + fill/read.
@@ -791,11 +1454,18 @@ static iree_status_t iree_io_parameter_index_provider_load(
           case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE: {
             IREE_ASSERT(source_file);
             status = iree_io_parameter_op_batch_enqueue_file_read(
-                &batch, source_file,
-                source_entry->storage.file.offset + span.parameter_offset,
+                &batch, source_file, source_file_offset + span.parameter_offset,
                 target_buffer, span.buffer_offset, span.length, 0);
             break;
           }
+          case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED: {
+            if (span.length == 0) break;
+            IREE_ASSERT(source_file);
+            status = iree_io_parameter_op_batch_enqueue_file_read(
+                &batch, source_file, source_file_offset, target_buffer,
+                span.buffer_offset, span.length, 0);
+            break;
+          }
           default: {
             status = iree_make_status(
                 IREE_STATUS_FAILED_PRECONDITION,
@@ -860,7 +1530,7 @@ static iree_status_t iree_io_parameter_index_provider_gather(
     iree_hal_file_t* source_file = NULL;  // retained, NULL if splat
     status = iree_io_parameter_op_batch_resolve_entry(
         &batch, source_scope, enumerator, i, IREE_HAL_MEMORY_ACCESS_READ,
-        &source_entry, &span, &source_file);
+        &source_entry, &span, &source_file, /*out_transformed_length=*/NULL);
     if (iree_status_is_ok(status)) {
       IREE_TRACE_ZONE_APPEND_TEXT(z_entry, source_entry->key.data,
                                   source_entry->key.size);
@@ -886,6 +1556,22 @@ static iree_status_t iree_io_parameter_index_provider_gather(
               target_buffer, span.buffer_offset, span.length, 0);
           break;
         }
+        case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED: {
+          // Only the chunks covering the span are read and decompressed. The
+          // device retains the decompressed file until the read completes.
+          if (span.length == 0) break;
+          IREE_ASSERT(!source_file);
+          uint64_t source_file_offset = 0;
+          status = iree_io_parameter_index_provider_decompress_entry(
+              provider, device, queue_affinity, source_entry,
+              span.parameter_offset, span.length, &source_file,
+              &source_file_offset);
+          if (!iree_status_is_ok(status)) break;
+          status = iree_io_parameter_op_batch_enqueue_file_read(
+              &batch, source_file, source_file_offset, target_buffer,
+              span.buffer_offset, span.length, 0);
+          break;
+        }
         default: {
           status = iree_make_status(
               IREE_STATUS_FAILED_PRECONDITION,
@@ -940,7 +1626,7 @@ static iree_status_t iree_io_parameter_index_provider_scatter(
     iree_hal_file_t* target_file = NULL;  // retained, NULL if splat
     status = iree_io_parameter_op_batch_resolve_entry(
         &batch, target_scope, enumerator, i, IREE_HAL_MEMORY_ACCESS_WRITE,
-        &target_entry, &span, &target_file);
+        &target_entry, &span, &target_file, /*out_transformed_length=*/NULL);
     if (iree_status_is_ok(status)) {
       IREE_TRACE_ZONE_APPEND_TEXT(z_entry, target_entry->key.data,
                                   target_entry->key.size);
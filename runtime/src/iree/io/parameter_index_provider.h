@@ -13,6 +13,8 @@
 #include "iree/hal/api.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/parameter_provider.h"
+#include "iree/io/parameter_transform.h"
+#include "iree/task/executor.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -21,6 +23,47 @@ extern "C" {
 // Reasonable default for the `max_concurrent_operations` parameter.
 #define IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS 16
 
+// Controls how a parameter index provider services requests.
+enum iree_io_parameter_index_provider_flag_bits_t {
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_NONE = 0u,
+  // Loads return placeholder buffers that read their contents on first map
+  // instead of reading every parameter up front. Resident contents are evicted
+  // when unused and over the lazy residency budget. Only valid when loading
+  // for devices that access host memory directly (local CPU devices) and for
+  // parameters that are not modified. See iree_io_parameter_lazy_buffer_create.
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LAZY = 1u << 0,
+  // Allows parameters requested as device-local to alias host memory-mapped
+  // files when the device is unable to import host memory as device-local,
+  // such as CUDA and HIP devices that can only register host memory. This
+  // avoids copies and device memory usage in exchange for device accesses
+  // going over the host interconnect.
+  IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_ALIAS_HOST_MEMORY = 1u << 1,
+};
+typedef uint32_t iree_io_parameter_index_provider_flags_t;
+
+typedef struct iree_io_parameter_index_provider_options_t {
+  // Limits how many file operations as part of a gather or scatter are allowed
+  // to be in-flight at a time.
+  iree_host_size_t max_concurrent_operations;
+  // Flags controlling provider behavior.
+  iree_io_parameter_index_provider_flags_t flags;
+  // Soft limit on the total bytes of lazily loaded parameters kept resident
+  // when IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LAZY is set. 0 is unlimited.
+  iree_device_size_t lazy_residency_budget;
+  // Optional transform applied to parameter contents as they are loaded.
+  // Transformed parameters are always loaded eagerly into new buffers.
+  // Retained by the provider.
+  iree_io_parameter_transform_t* transform;
+  // Optional executor used to decompress chunks of compressed parameters in
+  // parallel. Decompression runs on the calling thread if NULL.
+  // Retained by the provider.
+  iree_task_executor_t* executor;
+} iree_io_parameter_index_provider_options_t;
+
+// Initializes |out_options| to the default values.
+IREE_API_EXPORT void iree_io_parameter_index_provider_options_initialize(
+    iree_io_parameter_index_provider_options_t* out_options);
+
 // Creates a parameter provider serving from the provided |index|.
 // As parameters are operated on their files will be registered with the devices
 // they are used on and cached for future requests.
@@ -35,6 +78,15 @@ IREE_API_EXPORT iree_status_t iree_io_parameter_index_provider_create(
     iree_host_size_t max_concurrent_operations, iree_allocator_t host_allocator,
     iree_io_parameter_provider_t** out_provider);
 
+// Creates a parameter provider serving from the provided |index| with the
+// given |options|. See iree_io_parameter_index_provider_create.
+IREE_API_EXPORT iree_status_t
+iree_io_parameter_index_provider_create_with_options(
+    iree_string_view_t scope, iree_io_parameter_index_t* index,
+    const iree_io_parameter_index_provider_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -0,0 +1,103 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_index.h"
+
+#include <string>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace io {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+class ParameterIndexTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    IREE_ASSERT_OK(
+        iree_io_parameter_index_create(iree_allocator_system(), &index_));
+  }
+
+  void TearDown() override { iree_io_parameter_index_release(index_); }
+
+  static void AddSplat(iree_io_parameter_index_t* index, const std::string& key,
+                       uint64_t length) {
+    iree_io_parameter_index_entry_t entry = {};
+    entry.key = iree_make_string_view(key.data(), key.size());
+    entry.length = length;
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT;
+    entry.storage.splat.pattern_length = 1;
+    IREE_ASSERT_OK(iree_io_parameter_index_add(index, &entry));
+  }
+
+  uint64_t LookupLength(const std::string& key) {
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    IREE_CHECK_OK(iree_io_parameter_index_lookup(
+        index_, iree_make_string_view(key.data(), key.size()), &entry));
+    return entry->length;
+  }
+
+  iree_io_parameter_index_t* index_ = NULL;
+};
+
+TEST_F(ParameterIndexTest, LookupMissing) {
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  EXPECT_THAT(Status(iree_io_parameter_index_lookup(index_, IREE_SV("missing"),
+                                                    &entry)),
+              StatusIs(StatusCode::kNotFound));
+  AddSplat(index_, "present", 1);
+  EXPECT_THAT(Status(iree_io_parameter_index_lookup(index_, IREE_SV("missing"),
+                                                    &entry)),
+              StatusIs(StatusCode::kNotFound));
+  EXPECT_EQ(entry, nullptr);
+}
+
+// Tests lookups while the index grows through several capacities.
+TEST_F(ParameterIndexTest, LookupMany) {
+  for (int i = 0; i < 5000; ++i) {
+    AddSplat(index_, "param." + std::to_string(i), i);
+  }
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 5000);
+  for (int i = 0; i < 5000; ++i) {
+    EXPECT_EQ(LookupLength("param." + std::to_string(i)), i);
+  }
+}
+
+// Tests that the first entry added with a key wins.
+TEST_F(ParameterIndexTest, DuplicateKeys) {
+  AddSplat(index_, "a", 1);
+  AddSplat(index_, "b", 2);
+  AddSplat(index_, "a", 3);
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 3);
+  EXPECT_EQ(LookupLength("a"), 1);
+  EXPECT_EQ(LookupLength("b"), 2);
+}
+
+TEST_F(ParameterIndexTest, Merge) {
+  AddSplat(index_, "a", 1);
+  iree_io_parameter_index_t* source_index = NULL;
+  IREE_ASSERT_OK(
+      iree_io_parameter_index_create(iree_allocator_system(), &source_index));
+  AddSplat(source_index, "a", 2);
+  AddSplat(source_index, "b", 3);
+  IREE_ASSERT_OK(iree_io_parameter_index_merge(index_, source_index));
+  iree_io_parameter_index_release(source_index);
+
+  EXPECT_EQ(iree_io_parameter_index_count(index_), 3);
+  EXPECT_EQ(LookupLength("a"), 1);
+  EXPECT_EQ(LookupLength("b"), 3);
+  const iree_io_parameter_index_entry_t* entry = NULL;
+  IREE_ASSERT_OK(iree_io_parameter_index_get(index_, 2, &entry));
+  EXPECT_TRUE(iree_string_view_equal(entry->key, IREE_SV("b")));
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace iree
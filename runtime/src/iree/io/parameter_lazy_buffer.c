@@ -0,0 +1,486 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_lazy_buffer.h"
+
+#include <string.h>
+
+#include "iree/base/internal/synchronization.h"
+
+typedef struct iree_io_parameter_lazy_buffer_t iree_io_parameter_lazy_buffer_t;
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_lazy_cache_t
+//===----------------------------------------------------------------------===//
+
+struct iree_io_parameter_lazy_cache_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  // Maximum resident bytes before eviction begins or 0 for unlimited.
+  iree_device_size_t budget;
+
+  // Guards the resident list and the residency of every buffer in it.
+  iree_slim_mutex_t mutex;
+  // Total bytes of storage resident across all buffers.
+  iree_device_size_t resident_size;
+  // Resident buffers ordered from most recently used (head) to least recently
+  // used (tail).
+  iree_io_parameter_lazy_buffer_t* lru_head;
+  iree_io_parameter_lazy_buffer_t* lru_tail;
+};
+
+struct iree_io_parameter_lazy_buffer_t {
+  iree_hal_buffer_t base;
+  iree_io_parameter_lazy_cache_t* cache;  // retained
+
+  // Allocator and parameters used to allocate the storage when materializing.
+  iree_hal_allocator_t* device_allocator;  // retained
+  iree_hal_buffer_params_t storage_params;
+
+  // Source of the parameter contents. If NULL the contents are the splat
+  // pattern.
+  iree_hal_file_t* source_file;  // retained, optional
+  uint64_t source_offset;
+  uint8_t pattern_length;
+  uint8_t pattern[IREE_IO_PARAMETER_MAX_SPLAT_PATTERN_LENGTH];
+
+  // Serializes materialization and mapping of this buffer. Eviction only
+  // try-locks this so that it never blocks on (or deadlocks with) a buffer that
+  // is being materialized.
+  iree_slim_mutex_t mutex;
+  // Number of outstanding scoped mappings pinning the storage.
+  iree_host_size_t mapping_count;
+
+  // Materialized storage or NULL if not resident. Guarded by both |mutex| and
+  // the cache mutex: both must be held to change it.
+  iree_hal_buffer_t* storage;
+  iree_hal_buffer_mapping_t storage_mapping;
+
+  // Links in the cache LRU list, guarded by the cache mutex.
+  iree_io_parameter_lazy_buffer_t* lru_prev;
+  iree_io_parameter_lazy_buffer_t* lru_next;
+};
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_lazy_cache_create(
+    iree_device_size_t budget, iree_allocator_t host_allocator,
+    iree_io_parameter_lazy_cache_t** out_cache) {
+  IREE_ASSERT_ARGUMENT(out_cache);
+  *out_cache = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, budget);
+
+  iree_io_parameter_lazy_cache_t* cache = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*cache), (void**)&cache));
+  memset(cache, 0, sizeof(*cache));
+  iree_atomic_ref_count_init(&cache->ref_count);
+  cache->host_allocator = host_allocator;
+  cache->budget = budget;
+  iree_slim_mutex_initialize(&cache->mutex);
+
+  *out_cache = cache;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_lazy_cache_destroy(
+    iree_io_parameter_lazy_cache_t* cache) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  // Buffers retain the cache so it can only be destroyed once they are gone.
+  IREE_ASSERT(!cache->lru_head);
+  iree_slim_mutex_deinitialize(&cache->mutex);
+  iree_allocator_free(cache->host_allocator, cache);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_io_parameter_lazy_cache_retain(
+    iree_io_parameter_lazy_cache_t* cache) {
+  if (IREE_LIKELY(cache)) {
+    iree_atomic_ref_count_inc(&cache->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_parameter_lazy_cache_release(
+    iree_io_parameter_lazy_cache_t* cache) {
+  if (IREE_LIKELY(cache) &&
+      iree_atomic_ref_count_dec(&cache->ref_count) == 1) {
+    iree_io_parameter_lazy_cache_destroy(cache);
+  }
+}
+
+IREE_API_EXPORT iree_device_size_t iree_io_parameter_lazy_cache_resident_size(
+    iree_io_parameter_lazy_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_device_size_t resident_size = cache->resident_size;
+  iree_slim_mutex_unlock(&cache->mutex);
+  return resident_size;
+}
+
+// Removes |buffer| from the cache LRU list.
+// Requires the cache mutex be held.
+static void iree_io_parameter_lazy_cache_unlink(
+    iree_io_parameter_lazy_cache_t* cache,
+    iree_io_parameter_lazy_buffer_t* buffer) {
+  if (buffer->lru_prev) {
+    buffer->lru_prev->lru_next = buffer->lru_next;
+  } else {
+    cache->lru_head = buffer->lru_next;
+  }
+  if (buffer->lru_next) {
+    buffer->lru_next->lru_prev = buffer->lru_prev;
+  } else {
+    cache->lru_tail = buffer->lru_prev;
+  }
+  buffer->lru_prev = NULL;
+  buffer->lru_next = NULL;
+}
+
+// Inserts |buffer| at the head of the cache LRU list.
+// Requires the cache mutex be held.
+static void iree_io_parameter_lazy_cache_link_head(
+    iree_io_parameter_lazy_cache_t* cache,
+    iree_io_parameter_lazy_buffer_t* buffer) {
+  buffer->lru_prev = NULL;
+  buffer->lru_next = cache->lru_head;
+  if (cache->lru_head) {
+    cache->lru_head->lru_prev = buffer;
+  } else {
+    cache->lru_tail = buffer;
+  }
+  cache->lru_head = buffer;
+}
+
+// Drops the storage of a resident |buffer| and removes it from the LRU list.
+// Requires the cache mutex and the buffer mutex be held (or that the buffer is
+// being destroyed).
+static void iree_io_parameter_lazy_cache_drop_storage(
+    iree_io_parameter_lazy_cache_t* cache,
+    iree_io_parameter_lazy_buffer_t* buffer) {
+  iree_io_parameter_lazy_cache_unlink(cache, buffer);
+  cache->resident_size -= iree_hal_buffer_byte_length(&buffer->base);
+  iree_status_ignore(iree_hal_buffer_unmap_range(&buffer->storage_mapping));
+  iree_hal_buffer_release(buffer->storage);
+  buffer->storage = NULL;
+}
+
+// Evicts the least recently used buffers (ignoring |keep_buffer|) until the
+// resident size is at most |target_size|. Buffers that are mapped, referenced
+// by anything other than their owner, or busy on another thread are skipped.
+// Requires the cache mutex be held.
+static void iree_io_parameter_lazy_cache_evict_to(
+    iree_io_parameter_lazy_cache_t* cache, iree_device_size_t target_size,
+    iree_io_parameter_lazy_buffer_t* keep_buffer) {
+  iree_io_parameter_lazy_buffer_t* buffer = cache->lru_tail;
+  while (buffer && cache->resident_size > target_size) {
+    iree_io_parameter_lazy_buffer_t* prev_buffer = buffer->lru_prev;
+    // A reference count of 1 indicates only the owner of the buffer (such as a
+    // VM global) holds it: command buffers and subspans retain the buffer for
+    // as long as they may access it and scoped mappings are tracked by count.
+    if (buffer != keep_buffer &&
+        iree_atomic_ref_count_load(&buffer->base.resource.ref_count) == 1 &&
+        iree_slim_mutex_try_lock(&buffer->mutex)) {
+      if (buffer->mapping_count == 0) {
+        IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_io_parameter_lazy_cache_evict");
+        IREE_TRACE_ZONE_APPEND_VALUE_I64(
+            z0, iree_hal_buffer_byte_length(&buffer->base));
+        iree_io_parameter_lazy_cache_drop_storage(cache, buffer);
+        IREE_TRACE_ZONE_END(z0);
+      }
+      iree_slim_mutex_unlock(&buffer->mutex);
+    }
+    buffer = prev_buffer;
+  }
+}
+
+IREE_API_EXPORT void iree_io_parameter_lazy_cache_trim(
+    iree_io_parameter_lazy_cache_t* cache) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&cache->mutex);
+  iree_io_parameter_lazy_cache_evict_to(cache, 0, NULL);
+  iree_slim_mutex_unlock(&cache->mutex);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_lazy_buffer_t
+//===----------------------------------------------------------------------===//
+
+static const iree_hal_buffer_vtable_t iree_io_parameter_lazy_buffer_vtable;
+
+static iree_io_parameter_lazy_buffer_t* iree_io_parameter_lazy_buffer_cast(
+    iree_hal_buffer_t* base_value) {
+  IREE_HAL_ASSERT_TYPE(base_value, &iree_io_parameter_lazy_buffer_vtable);
+  return (iree_io_parameter_lazy_buffer_t*)base_value;
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_lazy_buffer_create(
+    iree_io_parameter_lazy_cache_t* cache,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_params_t params,
+    const iree_io_parameter_index_entry_t* entry, iree_hal_file_t* source_file,
+    uint64_t source_offset, iree_device_size_t length,
+    iree_hal_buffer_t** out_buffer) {
+  IREE_ASSERT_ARGUMENT(cache);
+  IREE_ASSERT_ARGUMENT(device_allocator);
+  IREE_ASSERT_ARGUMENT(entry);
+  IREE_ASSERT_ARGUMENT(out_buffer);
+  *out_buffer = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, entry->key.data, entry->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+
+  switch (entry->type) {
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT:
+      if (entry->storage.splat.pattern_length == 0) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "splat parameters must have a pattern");
+      }
+      break;
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
+      if (!source_file) {
+        IREE_TRACE_ZONE_END(z0);
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "file parameters require a source file");
+      }
+      break;
+    default:
+      IREE_TRACE_ZONE_END(z0);
+      return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                              "lazy parameters of type %d not supported",
+                              (int)entry->type);
+  }
+
+  // The storage is host memory we fill and hand out pointers to.
+  iree_hal_buffer_params_t storage_params = params;
+  storage_params.type |= IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+  storage_params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+  storage_params.usage |= IREE_HAL_BUFFER_USAGE_MAPPING |
+                          IREE_HAL_BUFFER_USAGE_MAPPING_PERSISTENT;
+
+  iree_allocator_t host_allocator =
+      iree_hal_allocator_host_allocator(device_allocator);
+  iree_io_parameter_lazy_buffer_t* buffer = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*buffer), (void**)&buffer));
+  memset(buffer, 0, sizeof(*buffer));
+  // NOTE: the buffer has no device allocator so that it is destroyed directly
+  // instead of being returned to an allocator that did not create it.
+  iree_hal_buffer_initialize(
+      host_allocator, /*device_allocator=*/NULL, &buffer->base, length, 0,
+      length, storage_params.type, IREE_HAL_MEMORY_ACCESS_READ,
+      storage_params.usage, &iree_io_parameter_lazy_buffer_vtable,
+      &buffer->base);
+  buffer->cache = cache;
+  iree_io_parameter_lazy_cache_retain(cache);
+  buffer->device_allocator = device_allocator;
+  iree_hal_allocator_retain(device_allocator);
+  buffer->storage_params = storage_params;
+  buffer->source_file = source_file;
+  iree_hal_file_retain(source_file);
+  buffer->source_offset = source_offset;
+  if (entry->type == IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT) {
+    buffer->pattern_length = entry->storage.splat.pattern_length;
+    memcpy(buffer->pattern, entry->storage.splat.pattern,
+           buffer->pattern_length);
+  }
+  iree_slim_mutex_initialize(&buffer->mutex);
+
+  *out_buffer = &buffer->base;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_parameter_lazy_buffer_destroy(
+    iree_hal_buffer_t* base_buffer) {
+  iree_io_parameter_lazy_buffer_t* buffer =
+      iree_io_parameter_lazy_buffer_cast(base_buffer);
+  iree_allocator_t host_allocator = base_buffer->host_allocator;
+  iree_io_parameter_lazy_cache_t* cache = buffer->cache;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Eviction may be inspecting the buffer under the cache lock so it must be
+  // held while the buffer leaves the resident list.
+  iree_slim_mutex_lock(&cache->mutex);
+  if (buffer->storage) {
+    iree_io_parameter_lazy_cache_drop_storage(cache, buffer);
+  }
+  iree_slim_mutex_unlock(&cache->mutex);
+
+  iree_slim_mutex_deinitialize(&buffer->mutex);
+  iree_hal_file_release(buffer->source_file);
+  iree_hal_allocator_release(buffer->device_allocator);
+  iree_allocator_free(host_allocator, buffer);
+  iree_io_parameter_lazy_cache_release(cache);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT bool iree_io_parameter_lazy_buffer_isa(
+    iree_hal_buffer_t* buffer) {
+  return iree_hal_resource_is(buffer, &iree_io_parameter_lazy_buffer_vtable);
+}
+
+IREE_API_EXPORT bool iree_io_parameter_lazy_buffer_is_resident(
+    iree_hal_buffer_t* base_buffer) {
+  iree_io_parameter_lazy_buffer_t* buffer =
+      iree_io_parameter_lazy_buffer_cast(base_buffer);
+  iree_slim_mutex_lock(&buffer->mutex);
+  bool is_resident = buffer->storage != NULL;
+  iree_slim_mutex_unlock(&buffer->mutex);
+  return is_resident;
+}
+
+// Fills |length| bytes of |data| with |pattern| repeated starting |phase|
+// bytes into the pattern.
+static void iree_io_parameter_fill_pattern(uint8_t* data,
+                                           iree_host_size_t length,
+                                           const uint8_t* pattern,
+                                           iree_host_size_t pattern_length,
+                                           uint64_t phase) {
+  if (pattern_length == 1) {
+    memset(data, pattern[0], length);
+    return;
+  }
+  iree_host_size_t filled_length = iree_min(length, pattern_length);
+  for (iree_host_size_t i = 0; i < filled_length; ++i) {
+    data[i] = pattern[(phase + i) % pattern_length];
+  }
+  // Double the filled range each step; it remains a whole number of patterns
+  // until the final partial copy.
+  while (filled_length < length) {
+    iree_host_size_t copy_length =
+        iree_min(filled_length, length - filled_length);
+    memcpy(data + filled_length, data, copy_length);
+    filled_length += copy_length;
+  }
+}
+
+// Allocates and fills the storage of |buffer| from its source.
+// Requires the buffer mutex be held.
+static iree_status_t iree_io_parameter_lazy_buffer_materialize(
+    iree_io_parameter_lazy_buffer_t* buffer) {
+  const iree_device_size_t length = iree_hal_buffer_byte_length(&buffer->base);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, length);
+
+  iree_hal_buffer_t* storage = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_hal_allocator_allocate_buffer(
+              buffer->device_allocator, buffer->storage_params, length,
+              &storage));
+
+  iree_status_t status = iree_ok_status();
+  if (buffer->source_file) {
+    status = iree_hal_file_read(buffer->source_file, buffer->source_offset,
+                                storage, 0, length);
+  }
+
+  iree_hal_buffer_mapping_t storage_mapping;
+  memset(&storage_mapping, 0, sizeof(storage_mapping));
+  if (iree_status_is_ok(status)) {
+    // NOTE: mapping must not discard or the file contents may be scribbled.
+    status = iree_hal_buffer_map_range(
+        storage, IREE_HAL_MAPPING_MODE_PERSISTENT,
+        IREE_HAL_MEMORY_ACCESS_READ | IREE_HAL_MEMORY_ACCESS_WRITE, 0,
+        IREE_WHOLE_BUFFER, &storage_mapping);
+  }
+  if (iree_status_is_ok(status) && !buffer->source_file) {
+    iree_io_parameter_fill_pattern(
+        storage_mapping.contents.data, storage_mapping.contents.data_length,
+        buffer->pattern, buffer->pattern_length, buffer->source_offset);
+  }
+
+  if (iree_status_is_ok(status)) {
+    buffer->storage_mapping = storage_mapping;
+    iree_io_parameter_lazy_cache_t* cache = buffer->cache;
+    iree_slim_mutex_lock(&cache->mutex);
+    buffer->storage = storage;
+    iree_io_parameter_lazy_cache_link_head(cache, buffer);
+    cache->resident_size += length;
+    if (cache->budget && cache->resident_size > cache->budget) {
+      iree_io_parameter_lazy_cache_evict_to(cache, cache->budget, buffer);
+    }
+    iree_slim_mutex_unlock(&cache->mutex);
+  } else {
+    iree_status_ignore(iree_hal_buffer_unmap_range(&storage_mapping));
+    iree_hal_buffer_release(storage);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_parameter_lazy_buffer_map_range(
+    iree_hal_buffer_t* base_buffer, iree_hal_mapping_mode_t mapping_mode,
+    iree_hal_memory_access_t memory_access,
+    iree_device_size_t local_byte_offset, iree_device_size_t local_byte_length,
+    iree_hal_buffer_mapping_t* mapping) {
+  iree_io_parameter_lazy_buffer_t* buffer =
+      iree_io_parameter_lazy_buffer_cast(base_buffer);
+  iree_slim_mutex_lock(&buffer->mutex);
+
+  iree_status_t status = iree_ok_status();
+  if (buffer->storage) {
+    // Already resident: mark as most recently used.
+    iree_io_parameter_lazy_cache_t* cache = buffer->cache;
+    iree_slim_mutex_lock(&cache->mutex);
+    iree_io_parameter_lazy_cache_unlink(cache, buffer);
+    iree_io_parameter_lazy_cache_link_head(cache, buffer);
+    iree_slim_mutex_unlock(&cache->mutex);
+  } else {
+    status = iree_io_parameter_lazy_buffer_materialize(buffer);
+  }
+
+  if (iree_status_is_ok(status)) {
+    mapping->contents = iree_make_byte_span(
+        buffer->storage_mapping.contents.data + local_byte_offset,
+        local_byte_length);
+    if (!mapping->impl.is_persistent) ++buffer->mapping_count;
+  }
+
+  iree_slim_mutex_unlock(&buffer->mutex);
+  return status;
+}
+
+static iree_status_t iree_io_parameter_lazy_buffer_unmap_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length, iree_hal_buffer_mapping_t* mapping) {
+  iree_io_parameter_lazy_buffer_t* buffer =
+      iree_io_parameter_lazy_buffer_cast(base_buffer);
+  if (!mapping->impl.is_persistent) {
+    iree_slim_mutex_lock(&buffer->mutex);
+    IREE_ASSERT_GT(buffer->mapping_count, 0);
+    --buffer->mapping_count;
+    iree_slim_mutex_unlock(&buffer->mutex);
+  }
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_parameter_lazy_buffer_invalidate_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  iree_atomic_thread_fence(iree_memory_order_acquire);
+  return iree_ok_status();
+}
+
+static iree_status_t iree_io_parameter_lazy_buffer_flush_range(
+    iree_hal_buffer_t* base_buffer, iree_device_size_t local_byte_offset,
+    iree_device_size_t local_byte_length) {
+  iree_atomic_thread_fence(iree_memory_order_release);
+  return iree_ok_status();
+}
+
+static const iree_hal_buffer_vtable_t iree_io_parameter_lazy_buffer_vtable = {
+    .recycle = iree_hal_buffer_recycle,
+    .destroy = iree_io_parameter_lazy_buffer_destroy,
+    .map_range = iree_io_parameter_lazy_buffer_map_range,
+    .unmap_range = iree_io_parameter_lazy_buffer_unmap_range,
+    .invalidate_range = iree_io_parameter_lazy_buffer_invalidate_range,
+    .flush_range = iree_io_parameter_lazy_buffer_flush_range,
+};
@@ -0,0 +1,95 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_LAZY_BUFFER_H_
+#define IREE_IO_PARAMETER_LAZY_BUFFER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/io/parameter_index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_lazy_cache_t
+//===----------------------------------------------------------------------===//
+
+// Tracks the resident set of lazily materialized parameter buffers.
+// Buffers are kept in least-recently-mapped order and when the total resident
+// size exceeds the budget the least recently used buffers that are not
+// referenced by anything other than their owner are evicted. Evicted buffers
+// rematerialize their contents from their source the next time they are
+// mapped.
+//
+// The budget is a soft limit: if all resident buffers are in use the cache
+// will exceed the budget rather than fail.
+//
+// Thread-safe.
+typedef struct iree_io_parameter_lazy_cache_t iree_io_parameter_lazy_cache_t;
+
+// Creates a cache that tries to keep at most |budget| bytes resident.
+// A |budget| of 0 disables eviction and buffers stay resident once touched
+// until the cache is trimmed.
+IREE_API_EXPORT iree_status_t iree_io_parameter_lazy_cache_create(
+    iree_device_size_t budget, iree_allocator_t host_allocator,
+    iree_io_parameter_lazy_cache_t** out_cache);
+
+// Retains the given |cache| for the caller.
+IREE_API_EXPORT void iree_io_parameter_lazy_cache_retain(
+    iree_io_parameter_lazy_cache_t* cache);
+
+// Releases the given |cache| from the caller.
+IREE_API_EXPORT void iree_io_parameter_lazy_cache_release(
+    iree_io_parameter_lazy_cache_t* cache);
+
+// Returns the total number of bytes of parameter storage currently resident.
+IREE_API_EXPORT iree_device_size_t iree_io_parameter_lazy_cache_resident_size(
+    iree_io_parameter_lazy_cache_t* cache);
+
+// Evicts all resident buffers that are not currently in use.
+IREE_API_EXPORT void iree_io_parameter_lazy_cache_trim(
+    iree_io_parameter_lazy_cache_t* cache);
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_lazy_buffer_t
+//===----------------------------------------------------------------------===//
+
+// Creates a placeholder buffer for the parameter |entry| that materializes its
+// contents on first map. Storage is allocated from |device_allocator| with
+// |params| and filled from |source_file| at |source_offset| (for file-backed
+// entries) or with the entry splat pattern. |source_file| is retained and must
+// be NULL for splat entries.
+//
+// Lazy buffers are host memory and only usable with devices that access host
+// memory directly (such as the local CPU devices). Their contents are treated
+// as read-only: they may be evicted and re-read from their source whenever they
+// are unreferenced. Persistent mappings are only valid while the mapper holds a
+// reference to the buffer in addition to its owner, as command buffers do for
+// the buffers they bind.
+IREE_API_EXPORT iree_status_t iree_io_parameter_lazy_buffer_create(
+    iree_io_parameter_lazy_cache_t* cache,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_params_t params,
+    const iree_io_parameter_index_entry_t* entry, iree_hal_file_t* source_file,
+    uint64_t source_offset, iree_device_size_t length,
+    iree_hal_buffer_t** out_buffer);
+
+// Returns true if |buffer| is a lazy parameter buffer.
+IREE_API_EXPORT bool iree_io_parameter_lazy_buffer_isa(
+    iree_hal_buffer_t* buffer);
+
+// Returns true if the lazy parameter |buffer| storage is currently resident.
+IREE_API_EXPORT bool iree_io_parameter_lazy_buffer_is_resident(
+    iree_hal_buffer_t* buffer);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_LAZY_BUFFER_H_
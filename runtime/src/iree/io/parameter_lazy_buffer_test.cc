@@ -0,0 +1,210 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_lazy_buffer.h"
+
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/utils/memory_file.h"
+#include "iree/io/file_handle.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace io {
+namespace {
+
+class ParameterLazyBufferTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        IREE_SV("heap"), host_allocator, host_allocator, &device_allocator_));
+    contents_.resize(64 * 1024);
+    for (size_t i = 0; i < contents_.size(); ++i) {
+      contents_[i] = (uint8_t)(i * 7 + (i >> 8));
+    }
+    iree_io_file_handle_t* handle = NULL;
+    IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ,
+        iree_make_byte_span(contents_.data(), contents_.size()),
+        iree_io_file_handle_release_callback_null(), host_allocator, &handle));
+    iree_status_t status = iree_hal_memory_file_wrap(
+        IREE_HAL_QUEUE_AFFINITY_ANY, IREE_HAL_MEMORY_ACCESS_READ, handle,
+        device_allocator_, host_allocator, &file_);
+    iree_io_file_handle_release(handle);
+    IREE_ASSERT_OK(status);
+  }
+
+  void TearDown() override {
+    iree_hal_file_release(file_);
+    iree_io_parameter_lazy_cache_release(cache_);
+    iree_hal_allocator_release(device_allocator_);
+  }
+
+  void CreateCache(iree_device_size_t budget) {
+    IREE_ASSERT_OK(iree_io_parameter_lazy_cache_create(
+        budget, iree_allocator_system(), &cache_));
+  }
+
+  iree_hal_buffer_t* CreateFileBuffer(uint64_t offset,
+                                      iree_device_size_t length) {
+    iree_io_parameter_index_entry_t entry;
+    memset(&entry, 0, sizeof(entry));
+    entry.key = IREE_SV("file");
+    entry.length = contents_.size();
+    entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE;
+    return CreateBuffer(&entry, file_, offset, length);
+  }
+
+  iree_hal_buffer_t* CreateBuffer(const iree_io_parameter_index_entry_t* entry,
+                                  iree_hal_file_t* file, uint64_t offset,
+                                  iree_device_size_t length) {
+    iree_hal_buffer_params_t params = {0};
+    params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+    params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_CHECK_OK(iree_io_parameter_lazy_buffer_create(
+        cache_, device_allocator_, params, entry, file, offset, length,
+        &buffer));
+    return buffer;
+  }
+
+  static std::vector<uint8_t> ReadBuffer(iree_hal_buffer_t* buffer) {
+    std::vector<uint8_t> data(iree_hal_buffer_byte_length(buffer));
+    IREE_CHECK_OK(
+        iree_hal_buffer_map_read(buffer, 0, data.data(), data.size()));
+    return data;
+  }
+
+  std::vector<uint8_t> Contents(uint64_t offset, iree_device_size_t length) {
+    return std::vector<uint8_t>(contents_.begin() + offset,
+                                contents_.begin() + offset + length);
+  }
+
+  iree_hal_allocator_t* device_allocator_ = NULL;
+  std::vector<uint8_t> contents_;
+  iree_hal_file_t* file_ = NULL;
+  iree_io_parameter_lazy_cache_t* cache_ = NULL;
+};
+
+TEST_F(ParameterLazyBufferTest, MaterializesOnFirstMap) {
+  CreateCache(/*budget=*/0);
+  iree_hal_buffer_t* buffer = CreateFileBuffer(/*offset=*/100, 1000);
+  ASSERT_TRUE(iree_io_parameter_lazy_buffer_isa(buffer));
+  EXPECT_FALSE(iree_io_parameter_lazy_buffer_is_resident(buffer));
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 0);
+
+  EXPECT_EQ(ReadBuffer(buffer), Contents(100, 1000));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffer));
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 1000);
+
+  iree_hal_buffer_release(buffer);
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 0);
+}
+
+TEST_F(ParameterLazyBufferTest, SplatPattern) {
+  CreateCache(/*budget=*/0);
+  iree_io_parameter_index_entry_t entry;
+  memset(&entry, 0, sizeof(entry));
+  entry.key = IREE_SV("splat");
+  entry.length = 1024;
+  entry.type = IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_SPLAT;
+  entry.storage.splat.pattern_length = 4;
+  const uint8_t pattern[4] = {0xAA, 0xBB, 0xCC, 0xDD};
+  memcpy(entry.storage.splat.pattern, pattern, sizeof(pattern));
+
+  // Starting 2 bytes into the parameter rotates the pattern.
+  iree_hal_buffer_t* buffer =
+      CreateBuffer(&entry, /*file=*/NULL, /*offset=*/2, 1001);
+  std::vector<uint8_t> expected(1001);
+  for (size_t i = 0; i < expected.size(); ++i) {
+    expected[i] = pattern[(i + 2) % 4];
+  }
+  EXPECT_EQ(ReadBuffer(buffer), expected);
+  iree_hal_buffer_release(buffer);
+}
+
+TEST_F(ParameterLazyBufferTest, EvictsLeastRecentlyUsed) {
+  CreateCache(/*budget=*/2 * 4096);
+  iree_hal_buffer_t* buffers[3] = {
+      CreateFileBuffer(0 * 4096, 4096),
+      CreateFileBuffer(1 * 4096, 4096),
+      CreateFileBuffer(2 * 4096, 4096),
+  };
+  EXPECT_EQ(ReadBuffer(buffers[0]), Contents(0 * 4096, 4096));
+  EXPECT_EQ(ReadBuffer(buffers[1]), Contents(1 * 4096, 4096));
+  // Touch buffer 0 so that buffer 1 becomes the least recently used.
+  EXPECT_EQ(ReadBuffer(buffers[0]), Contents(0 * 4096, 4096));
+  EXPECT_EQ(ReadBuffer(buffers[2]), Contents(2 * 4096, 4096));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffers[0]));
+  EXPECT_FALSE(iree_io_parameter_lazy_buffer_is_resident(buffers[1]));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffers[2]));
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 2 * 4096);
+
+  // Evicted buffers rematerialize on their next use.
+  EXPECT_EQ(ReadBuffer(buffers[1]), Contents(1 * 4096, 4096));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffers[1]));
+  EXPECT_FALSE(iree_io_parameter_lazy_buffer_is_resident(buffers[0]));
+
+  for (iree_hal_buffer_t* buffer : buffers) iree_hal_buffer_release(buffer);
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 0);
+}
+
+TEST_F(ParameterLazyBufferTest, InUseBuffersAreNotEvicted) {
+  CreateCache(/*budget=*/4096);
+  iree_hal_buffer_t* buffer0 = CreateFileBuffer(0, 4096);
+  iree_hal_buffer_t* buffer1 = CreateFileBuffer(4096, 4096);
+
+  // A scoped mapping keeps buffer0 resident while buffer1 materializes.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_ASSERT_OK(iree_hal_buffer_map_range(
+      buffer0, IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+      IREE_WHOLE_BUFFER, &mapping));
+  EXPECT_EQ(ReadBuffer(buffer1), Contents(4096, 4096));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffer0));
+  EXPECT_EQ(std::vector<uint8_t>(
+                mapping.contents.data,
+                mapping.contents.data + mapping.contents.data_length),
+            Contents(0, 4096));
+  IREE_ASSERT_OK(iree_hal_buffer_unmap_range(&mapping));
+
+  // Additional references (such as from command buffers) also pin buffers.
+  iree_hal_buffer_retain(buffer1);
+  EXPECT_EQ(ReadBuffer(buffer0), Contents(0, 4096));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffer1));
+  iree_hal_buffer_release(buffer1);
+
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer0);
+}
+
+TEST_F(ParameterLazyBufferTest, Trim) {
+  CreateCache(/*budget=*/0);
+  iree_hal_buffer_t* buffer0 = CreateFileBuffer(0, 4096);
+  iree_hal_buffer_t* buffer1 = CreateFileBuffer(4096, 4096);
+  ReadBuffer(buffer0);
+  ReadBuffer(buffer1);
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 2 * 4096);
+
+  iree_hal_buffer_retain(buffer1);
+  iree_io_parameter_lazy_cache_trim(cache_);
+  EXPECT_FALSE(iree_io_parameter_lazy_buffer_is_resident(buffer0));
+  EXPECT_TRUE(iree_io_parameter_lazy_buffer_is_resident(buffer1));
+  EXPECT_EQ(iree_io_parameter_lazy_cache_resident_size(cache_), 4096);
+  iree_hal_buffer_release(buffer1);
+
+  iree_hal_buffer_release(buffer1);
+  iree_hal_buffer_release(buffer0);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace iree
@@ -0,0 +1,51 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/parameter_transform.h"
+
+IREE_API_EXPORT void iree_io_parameter_transform_retain(
+    iree_io_parameter_transform_t* transform) {
+  if (IREE_LIKELY(transform)) {
+    iree_atomic_ref_count_inc(&transform->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_io_parameter_transform_release(
+    iree_io_parameter_transform_t* transform) {
+  if (IREE_LIKELY(transform) &&
+      iree_atomic_ref_count_dec(&transform->ref_count) == 1) {
+    transform->vtable->destroy(transform);
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_transform_query(
+    iree_io_parameter_transform_t* transform,
+    const iree_io_parameter_index_entry_t* entry, bool* out_applies,
+    uint64_t* out_target_length) {
+  IREE_ASSERT_ARGUMENT(transform);
+  IREE_ASSERT_ARGUMENT(entry);
+  IREE_ASSERT_ARGUMENT(out_applies);
+  IREE_ASSERT_ARGUMENT(out_target_length);
+  *out_applies = false;
+  *out_target_length = 0;
+  return transform->vtable->query(transform, entry, out_applies,
+                                  out_target_length);
+}
+
+IREE_API_EXPORT iree_status_t iree_io_parameter_transform_apply(
+    iree_io_parameter_transform_t* transform,
+    const iree_io_parameter_index_entry_t* entry, iree_const_byte_span_t source,
+    iree_byte_span_t target) {
+  IREE_ASSERT_ARGUMENT(transform);
+  IREE_ASSERT_ARGUMENT(entry);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, entry->key.data, entry->key.size);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, target.data_length);
+  iree_status_t status =
+      transform->vtable->apply(transform, entry, source, target);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -0,0 +1,90 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_PARAMETER_TRANSFORM_H_
+#define IREE_IO_PARAMETER_TRANSFORM_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/io/parameter_index.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_transform_t
+//===----------------------------------------------------------------------===//
+
+// Converts parameter contents from their stored encoding to the encoding
+// expected by the program consuming them as they are loaded. Examples are
+// dequantizing blocks of quantized values or repacking matrices into the tiled
+// layouts used by data-tiled matmuls.
+//
+// Transforms operate on host memory: the entire source parameter contents are
+// provided and the transform writes the entire transformed contents.
+//
+// Thread-safe: transforms may be applied to many parameters concurrently.
+typedef struct iree_io_parameter_transform_t iree_io_parameter_transform_t;
+
+// Retains the given |transform| for the caller.
+IREE_API_EXPORT void iree_io_parameter_transform_retain(
+    iree_io_parameter_transform_t* transform);
+
+// Releases the given |transform| from the caller.
+IREE_API_EXPORT void iree_io_parameter_transform_release(
+    iree_io_parameter_transform_t* transform);
+
+// Queries whether |entry| is transformed by |transform|.
+// Sets |out_applies| to true and returns the total length in bytes of the
+// transformed contents in |out_target_length| if the transform applies.
+// Parameter ranges requested from loads are relative to the transformed
+// contents. Returns an error if the transform should apply to |entry| but is
+// unable to (such as the parameter having an unsupported type or shape).
+IREE_API_EXPORT iree_status_t iree_io_parameter_transform_query(
+    iree_io_parameter_transform_t* transform,
+    const iree_io_parameter_index_entry_t* entry, bool* out_applies,
+    uint64_t* out_target_length);
+
+// Transforms the full |source| contents of |entry| into |target|.
+// |target| must have the length returned by iree_io_parameter_transform_query.
+// Blocks the caller until the transform has completed though the work may be
+// distributed across other threads.
+IREE_API_EXPORT iree_status_t iree_io_parameter_transform_apply(
+    iree_io_parameter_transform_t* transform,
+    const iree_io_parameter_index_entry_t* entry, iree_const_byte_span_t source,
+    iree_byte_span_t target);
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_transform_t implementation details
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_io_parameter_transform_vtable_t {
+  void(IREE_API_PTR* destroy)(
+      iree_io_parameter_transform_t* IREE_RESTRICT transform);
+
+  iree_status_t(IREE_API_PTR* query)(
+      iree_io_parameter_transform_t* transform,
+      const iree_io_parameter_index_entry_t* entry, bool* out_applies,
+      uint64_t* out_target_length);
+
+  iree_status_t(IREE_API_PTR* apply)(
+      iree_io_parameter_transform_t* transform,
+      const iree_io_parameter_index_entry_t* entry,
+      iree_const_byte_span_t source, iree_byte_span_t target);
+} iree_io_parameter_transform_vtable_t;
+
+struct iree_io_parameter_transform_t {
+  iree_atomic_ref_count_t ref_count;
+  const iree_io_parameter_transform_vtable_t* vtable;
+};
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_PARAMETER_TRANSFORM_H_
@@ -0,0 +1,943 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/remote_parameter_provider.h"
+
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/path.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/io/file_handle.h"
+#include "iree/io/formats/irpa/irpa_parser.h"
+#include "iree/io/parameter_index_provider.h"
+#include "iree/schemas/parameter_archive.h"
+#include "iree/task/task.h"
+
+//===----------------------------------------------------------------------===//
+// iree_io_remote_parameter_provider_t
+//===----------------------------------------------------------------------===//
+
+// State of a block of the remote object in the local cache.
+enum iree_io_remote_block_state_e {
+  // Block has not been fetched (or a prior fetch failed).
+  IREE_IO_REMOTE_BLOCK_STATE_MISSING = 0,
+  // Block is being fetched by some thread. Waiters are notified when it
+  // transitions to either MISSING or RESIDENT.
+  IREE_IO_REMOTE_BLOCK_STATE_FETCHING = 1,
+  // Block contents are in the cache and immutable.
+  IREE_IO_REMOTE_BLOCK_STATE_RESIDENT = 2,
+};
+
+// Maps an index entry to its position in index order.
+typedef struct iree_io_remote_entry_ordinal_t {
+  const iree_io_parameter_index_entry_t* entry;
+  iree_host_size_t ordinal;
+} iree_io_remote_entry_ordinal_t;
+
+typedef struct iree_io_remote_parameter_provider_t {
+  iree_io_parameter_provider_t base;
+  iree_allocator_t host_allocator;
+
+  // Transport used to fetch ranges of the remote object.
+  iree_io_remote_fetcher_t fetcher;
+  // URI of the remote object; stored at the end of the provider allocation.
+  iree_string_view_t uri;
+  // Optional executor used for parallel fetches and prefetching.
+  iree_task_executor_t* executor;
+
+  // Local cache of the entire remote object. Blocks are only valid once their
+  // state is RESIDENT.
+  iree_io_file_handle_t* cache_handle;
+  uint8_t* cache_base;
+  uint64_t object_length;
+
+  // Cache block size and per-block iree_io_remote_block_state_e.
+  iree_host_size_t block_size;
+  uint32_t block_count;
+  iree_atomic_int32_t* block_states;
+  // Posted whenever any block leaves the FETCHING state.
+  iree_notification_t block_notification;
+
+  // Index parsed from the remote archive header. Entries reference the cache.
+  iree_io_parameter_index_t* index;
+  // Provider serving the index from the cache once blocks are resident.
+  iree_io_parameter_provider_t* cache_provider;
+
+  // Number of entries to prefetch after each request in index order.
+  iree_host_size_t prefetch_count;
+  // Scope tracking in-flight prefetches so that they can be joined on destroy.
+  iree_task_scope_t prefetch_scope;
+  // Index entries sorted by address for ordinal lookup.
+  iree_host_size_t entry_count;
+  iree_io_remote_entry_ordinal_t* entry_ordinals;
+} iree_io_remote_parameter_provider_t;
+
+static const iree_io_parameter_provider_vtable_t
+    iree_io_remote_parameter_provider_vtable;
+
+static iree_io_remote_parameter_provider_t*
+iree_io_remote_parameter_provider_cast(
+    iree_io_parameter_provider_t* IREE_RESTRICT base_provider) {
+  return (iree_io_remote_parameter_provider_t*)base_provider;
+}
+
+IREE_API_EXPORT void iree_io_remote_parameter_provider_options_initialize(
+    iree_io_remote_parameter_provider_options_t* out_options) {
+  IREE_ASSERT_ARGUMENT(out_options);
+  memset(out_options, 0, sizeof(*out_options));
+  out_options->block_size =
+      IREE_IO_REMOTE_PARAMETER_PROVIDER_DEFAULT_BLOCK_SIZE;
+  out_options->prefetch_count =
+      IREE_IO_REMOTE_PARAMETER_PROVIDER_DEFAULT_PREFETCH_COUNT;
+  out_options->max_concurrent_operations =
+      IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS;
+}
+
+//===----------------------------------------------------------------------===//
+// Block fetching
+//===----------------------------------------------------------------------===//
+
+// Fetches |block_index| into the cache and publishes the result to waiters.
+// The caller must have moved the block into the FETCHING state.
+static iree_status_t iree_io_remote_parameter_provider_fetch_block(
+    iree_io_remote_parameter_provider_t* provider, uint32_t block_index) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, block_index);
+  const uint64_t offset = (uint64_t)block_index * provider->block_size;
+  const iree_host_size_t length = (iree_host_size_t)iree_min(
+      (uint64_t)provider->block_size, provider->object_length - offset);
+  iree_status_t status = provider->fetcher.fn(
+      provider->fetcher.user_data, provider->uri, offset,
+      iree_make_byte_span(provider->cache_base + offset, length));
+  iree_atomic_store_int32(&provider->block_states[block_index],
+                          iree_status_is_ok(status)
+                              ? IREE_IO_REMOTE_BLOCK_STATE_RESIDENT
+                              : IREE_IO_REMOTE_BLOCK_STATE_MISSING,
+                          iree_memory_order_release);
+  iree_notification_post(&provider->block_notification, IREE_ALL_WAITERS);
+  if (!iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(
+        status, "fetching bytes %" PRIu64 "-%" PRIu64 " of '%.*s'", offset,
+        offset + length - 1, (int)provider->uri.size, provider->uri.data);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Claims |block_index| for fetching by the caller if it is missing.
+// Returns true if the caller must fetch the block.
+static bool iree_io_remote_parameter_provider_claim_block(
+    iree_io_remote_parameter_provider_t* provider, uint32_t block_index) {
+  int32_t expected = IREE_IO_REMOTE_BLOCK_STATE_MISSING;
+  return iree_atomic_compare_exchange_strong_int32(
+      &provider->block_states[block_index], &expected,
+      IREE_IO_REMOTE_BLOCK_STATE_FETCHING, iree_memory_order_acq_rel,
+      iree_memory_order_acquire);
+}
+
+// A set of claimed blocks being fetched with one tile per block.
+typedef struct iree_io_remote_fetch_batch_t {
+  iree_io_remote_parameter_provider_t* provider;
+  // True if fetch failures should be dropped (and retried on demand).
+  bool is_prefetch;
+  uint32_t block_count;
+  const uint32_t* block_indices;
+} iree_io_remote_fetch_batch_t;
+
+static iree_status_t iree_io_remote_fetch_batch_dispatch_tile(
+    void* user_context, const iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  const iree_io_remote_fetch_batch_t* batch =
+      (const iree_io_remote_fetch_batch_t*)user_context;
+  iree_status_t status = iree_io_remote_parameter_provider_fetch_block(
+      batch->provider, batch->block_indices[tile_context->workgroup_xyz[0]]);
+  if (batch->is_prefetch) {
+    // The block was returned to MISSING and whoever needs it next will retry.
+    iree_status_ignore(status);
+    return iree_ok_status();
+  }
+  return status;
+}
+
+// Fetches all blocks in |batch| and returns after they have completed.
+// Blocks are fetched in parallel on the provider executor when available.
+static iree_status_t iree_io_remote_parameter_provider_fetch_blocks(
+    iree_io_remote_parameter_provider_t* provider,
+    const iree_io_remote_fetch_batch_t* batch) {
+  if (batch->block_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, batch->block_count);
+
+  if (!provider->executor || batch->block_count == 1) {
+    // Every claimed block must leave the FETCHING state even if an earlier one
+    // fails so that no waiter blocks forever.
+    iree_status_t status = iree_ok_status();
+    for (uint32_t i = 0; i < batch->block_count; ++i) {
+      iree_status_t block_status =
+          iree_io_remote_parameter_provider_fetch_block(
+              provider, batch->block_indices[i]);
+      if (iree_status_is_ok(status)) {
+        status = block_status;
+      } else {
+        iree_status_ignore(block_status);
+      }
+    }
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(IREE_SV("iree_io_remote_fetch"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {batch->block_count, 1, 1};
+  iree_task_dispatch_t dispatch_task;
+  iree_task_dispatch_initialize(
+      &scope,
+      iree_task_make_dispatch_closure(iree_io_remote_fetch_batch_dispatch_tile,
+                                      (void*)batch),
+      workgroup_size, workgroup_count, &dispatch_task);
+
+  iree_task_fence_t* fence = NULL;
+  iree_status_t status =
+      iree_task_executor_acquire_fence(provider->executor, &scope, &fence);
+  if (iree_status_is_ok(status)) {
+    iree_task_set_completion_task(&dispatch_task.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch_task.header);
+    iree_task_executor_submit(provider->executor, &submission);
+    iree_task_executor_flush(provider->executor);
+    status = iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_task_scope_consume_status(&scope);
+  }
+  iree_task_scope_deinitialize(&scope);
+
+  // A failed dispatch may have skipped tiles; return any blocks it left
+  // claimed so that future requests retry them.
+  if (!iree_status_is_ok(status)) {
+    for (uint32_t i = 0; i < batch->block_count; ++i) {
+      int32_t expected = IREE_IO_REMOTE_BLOCK_STATE_FETCHING;
+      iree_atomic_compare_exchange_strong_int32(
+          &provider->block_states[batch->block_indices[i]], &expected,
+          IREE_IO_REMOTE_BLOCK_STATE_MISSING, iree_memory_order_acq_rel,
+          iree_memory_order_relaxed);
+    }
+    iree_notification_post(&provider->block_notification, IREE_ALL_WAITERS);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// A background prefetch of claimed blocks. Freed when the dispatch retires.
+typedef struct iree_io_remote_prefetch_t {
+  iree_task_dispatch_t dispatch_task;
+  iree_allocator_t host_allocator;
+  iree_io_remote_fetch_batch_t batch;
+  uint32_t block_indices[];
+} iree_io_remote_prefetch_t;
+
+static void iree_io_remote_prefetch_cleanup(iree_task_t* task,
+                                            iree_status_code_t status_code) {
+  iree_io_remote_prefetch_t* prefetch = (iree_io_remote_prefetch_t*)task;
+  if (status_code != IREE_STATUS_OK) {
+    // The dispatch was aborted before all tiles ran; release unfetched claims.
+    iree_io_remote_parameter_provider_t* provider = prefetch->batch.provider;
+    for (uint32_t i = 0; i < prefetch->batch.block_count; ++i) {
+      int32_t expected = IREE_IO_REMOTE_BLOCK_STATE_FETCHING;
+      iree_atomic_compare_exchange_strong_int32(
+          &provider->block_states[prefetch->block_indices[i]], &expected,
+          IREE_IO_REMOTE_BLOCK_STATE_MISSING, iree_memory_order_acq_rel,
+          iree_memory_order_relaxed);
+    }
+    iree_notification_post(&provider->block_notification, IREE_ALL_WAITERS);
+  }
+  iree_allocator_free_aligned(prefetch->host_allocator, prefetch);
+}
+
+// Begins fetching the claimed |block_indices| in the background.
+// Returns without waiting. The provider joins all prefetches on destroy.
+static void iree_io_remote_parameter_provider_prefetch_blocks(
+    iree_io_remote_parameter_provider_t* provider, uint32_t block_count,
+    const uint32_t* block_indices) {
+  if (block_count == 0) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, block_count);
+
+  iree_io_remote_prefetch_t* prefetch = NULL;
+  iree_status_t status = iree_allocator_malloc_aligned(
+      provider->host_allocator,
+      sizeof(*prefetch) + block_count * sizeof(prefetch->block_indices[0]),
+      iree_alignof(iree_io_remote_prefetch_t), 0, (void**)&prefetch);
+  iree_task_fence_t* fence = NULL;
+  if (iree_status_is_ok(status)) {
+    prefetch->host_allocator = provider->host_allocator;
+    prefetch->batch.provider = provider;
+    prefetch->batch.is_prefetch = true;
+    prefetch->batch.block_count = block_count;
+    prefetch->batch.block_indices = prefetch->block_indices;
+    memcpy(prefetch->block_indices, block_indices,
+           block_count * sizeof(prefetch->block_indices[0]));
+    status = iree_task_executor_acquire_fence(
+        provider->executor, &provider->prefetch_scope, &fence);
+  }
+
+  if (iree_status_is_ok(status)) {
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {block_count, 1, 1};
+    iree_task_dispatch_initialize(
+        &provider->prefetch_scope,
+        iree_task_make_dispatch_closure(
+            iree_io_remote_fetch_batch_dispatch_tile, &prefetch->batch),
+        workgroup_size, workgroup_count, &prefetch->dispatch_task);
+    iree_task_set_cleanup_fn(&prefetch->dispatch_task.header,
+                             iree_io_remote_prefetch_cleanup);
+    iree_task_set_completion_task(&prefetch->dispatch_task.header,
+                                  &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &prefetch->dispatch_task.header);
+    iree_task_executor_submit(provider->executor, &submission);
+    iree_task_executor_flush(provider->executor);
+  } else {
+    // Prefetching is best-effort: unclaim the blocks and move on.
+    iree_allocator_free_aligned(provider->host_allocator, prefetch);
+    for (uint32_t i = 0; i < block_count; ++i) {
+      iree_atomic_store_int32(&provider->block_states[block_indices[i]],
+                              IREE_IO_REMOTE_BLOCK_STATE_MISSING,
+                              iree_memory_order_release);
+    }
+    iree_notification_post(&provider->block_notification, IREE_ALL_WAITERS);
+    iree_status_ignore(status);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+typedef struct iree_io_remote_block_wait_t {
+  iree_atomic_int32_t* state;
+} iree_io_remote_block_wait_t;
+
+static bool iree_io_remote_block_is_not_fetching(void* arg) {
+  iree_io_remote_block_wait_t* wait = (iree_io_remote_block_wait_t*)arg;
+  return iree_atomic_load_int32(wait->state, iree_memory_order_acquire) !=
+         IREE_IO_REMOTE_BLOCK_STATE_FETCHING;
+}
+
+// Waits until |block_index| is resident, fetching it on the calling thread if
+// it is missing (such as when a prefetch of it failed).
+static iree_status_t iree_io_remote_parameter_provider_require_block(
+    iree_io_remote_parameter_provider_t* provider, uint32_t block_index) {
+  iree_io_remote_block_wait_t wait = {
+      .state = &provider->block_states[block_index],
+  };
+  for (;;) {
+    switch (iree_atomic_load_int32(wait.state, iree_memory_order_acquire)) {
+      case IREE_IO_REMOTE_BLOCK_STATE_RESIDENT:
+        return iree_ok_status();
+      case IREE_IO_REMOTE_BLOCK_STATE_MISSING:
+        if (iree_io_remote_parameter_provider_claim_block(provider,
+                                                          block_index)) {
+          return iree_io_remote_parameter_provider_fetch_block(provider,
+                                                               block_index);
+        }
+        break;  // raced with another claim; reload
+      default:
+        iree_notification_await(&provider->block_notification,
+                                iree_io_remote_block_is_not_fetching, &wait,
+                                iree_infinite_timeout());
+        break;
+    }
+  }
+}
+
+//===----------------------------------------------------------------------===//
+// Request planning
+//===----------------------------------------------------------------------===//
+
+// Returns the range of bytes in the cache backing |entry| that must be
+// resident to serve |length| bytes at |parameter_offset|.
+static void iree_io_remote_parameter_provider_entry_range(
+    iree_io_remote_parameter_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry, uint64_t parameter_offset,
+    uint64_t length, uint64_t* out_offset, uint64_t* out_length) {
+  *out_offset = 0;
+  *out_length = 0;
+  switch (entry->type) {
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_FILE:
+      if (entry->storage.file.handle != provider->cache_handle) break;
+      *out_offset = entry->storage.file.offset + parameter_offset;
+      *out_length = length;
+      break;
+    case IREE_IO_PARAMETER_INDEX_ENTRY_STORAGE_TYPE_COMPRESSED:
+      // The chunk table and chunks are read as needed by the cache provider;
+      // fetch the whole payload as chunk boundaries are not known here.
+      if (entry->storage.compressed.handle != provider->cache_handle) break;
+      *out_offset = entry->storage.compressed.offset;
+      *out_length = entry->storage.compressed.storage_length;
+      break;
+    default:
+      // Splats and external entries are not backed by the remote object.
+      break;
+  }
+  // Out of range requests are reported by the cache provider.
+  if (*out_offset >= provider->object_length) {
+    *out_length = 0;
+  } else {
+    *out_length = iree_min(*out_length, provider->object_length - *out_offset);
+  }
+}
+
+static int iree_io_remote_entry_ordinal_compare(const void* lhs,
+                                                const void* rhs) {
+  uintptr_t lhs_entry =
+      (uintptr_t)((const iree_io_remote_entry_ordinal_t*)lhs)->entry;
+  uintptr_t rhs_entry =
+      (uintptr_t)((const iree_io_remote_entry_ordinal_t*)rhs)->entry;
+  return lhs_entry < rhs_entry ? -1 : (lhs_entry > rhs_entry ? 1 : 0);
+}
+
+// Returns the position of |entry| in index order.
+static iree_host_size_t iree_io_remote_parameter_provider_entry_ordinal(
+    iree_io_remote_parameter_provider_t* provider,
+    const iree_io_parameter_index_entry_t* entry) {
+  iree_io_remote_entry_ordinal_t key = {.entry = entry};
+  const iree_io_remote_entry_ordinal_t* match =
+      (const iree_io_remote_entry_ordinal_t*)bsearch(
+          &key, provider->entry_ordinals, provider->entry_count,
+          sizeof(key), iree_io_remote_entry_ordinal_compare);
+  return match ? match->ordinal : 0;
+}
+
+// Claims all missing blocks in |offset|/|length| and appends them to
+// |block_indices|.
+static void iree_io_remote_parameter_provider_claim_range(
+    iree_io_remote_parameter_provider_t* provider, uint64_t offset,
+    uint64_t length, uint32_t* block_indices, uint32_t* block_count) {
+  if (length == 0) return;
+  const uint32_t first_block = (uint32_t)(offset / provider->block_size);
+  const uint32_t last_block =
+      (uint32_t)((offset + length - 1) / provider->block_size);
+  for (uint32_t i = first_block; i <= last_block; ++i) {
+    if (iree_io_remote_parameter_provider_claim_block(provider, i)) {
+      block_indices[(*block_count)++] = i;
+    }
+  }
+}
+
+// Makes resident all blocks backing the |count| spans in |enumerator| and then
+// begins prefetching the entries that follow them in index order.
+static iree_status_t iree_io_remote_parameter_provider_fetch_spans(
+    iree_io_remote_parameter_provider_t* provider, iree_host_size_t count,
+    iree_io_parameter_enumerator_t enumerator) {
+  if (count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+
+  // Scratch for the byte range of each span plus the claimed block list.
+  // Each block is claimed at most once so the list never exceeds the total
+  // block count.
+  uint64_t* span_ranges = NULL;
+  uint32_t* block_indices = NULL;
+  iree_status_t status = iree_allocator_malloc(
+      provider->host_allocator, count * 2 * sizeof(span_ranges[0]),
+      (void**)&span_ranges);
+  if (iree_status_is_ok(status)) {
+    status = iree_allocator_malloc(
+        provider->host_allocator,
+        provider->block_count * sizeof(block_indices[0]),
+        (void**)&block_indices);
+  }
+
+  // Claim every missing block covering the requested spans.
+  uint32_t block_count = 0;
+  iree_host_size_t max_ordinal = 0;
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    iree_string_view_t key = iree_string_view_empty();
+    iree_io_parameter_span_t span = {0};
+    status = enumerator.fn(enumerator.user_data, i, &key, &span);
+    const iree_io_parameter_index_entry_t* entry = NULL;
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_index_lookup(provider->index, key, &entry);
+    }
+    if (iree_status_is_ok(status)) {
+      iree_io_remote_parameter_provider_entry_range(
+          provider, entry, span.parameter_offset, span.length,
+          &span_ranges[i * 2 + 0], &span_ranges[i * 2 + 1]);
+      iree_io_remote_parameter_provider_claim_range(
+          provider, span_ranges[i * 2 + 0], span_ranges[i * 2 + 1],
+          block_indices, &block_count);
+      max_ordinal = iree_max(
+          max_ordinal,
+          iree_io_remote_parameter_provider_entry_ordinal(provider, entry));
+    }
+  }
+
+  // Fetch the claimed blocks in parallel. Blocks claimed by others (such as
+  // in-flight prefetches) are waited on below.
+  iree_io_remote_fetch_batch_t batch = {
+      .provider = provider,
+      .is_prefetch = false,
+      .block_count = block_count,
+      .block_indices = block_indices,
+  };
+  if (iree_status_is_ok(status)) {
+    status = iree_io_remote_parameter_provider_fetch_blocks(provider, &batch);
+  } else {
+    // Planning failed after claiming some blocks; release the claims.
+    for (uint32_t i = 0; i < block_count; ++i) {
+      iree_atomic_store_int32(&provider->block_states[block_indices[i]],
+                              IREE_IO_REMOTE_BLOCK_STATE_MISSING,
+                              iree_memory_order_release);
+    }
+    iree_notification_post(&provider->block_notification, IREE_ALL_WAITERS);
+  }
+
+  // Wait for any blocks that were being fetched by others.
+  for (iree_host_size_t i = 0; i < count && iree_status_is_ok(status); ++i) {
+    const uint64_t offset = span_ranges[i * 2 + 0];
+    const uint64_t length = span_ranges[i * 2 + 1];
+    if (length == 0) continue;
+    const uint32_t first_block = (uint32_t)(offset / provider->block_size);
+    const uint32_t last_block =
+        (uint32_t)((offset + length - 1) / provider->block_size);
+    for (uint32_t j = first_block; j <= last_block && iree_status_is_ok(status);
+         ++j) {
+      status = iree_io_remote_parameter_provider_require_block(provider, j);
+    }
+  }
+
+  // Prefetch the entries following the last one requested in index order.
+  if (iree_status_is_ok(status) && provider->executor &&
+      provider->prefetch_count > 0) {
+    block_count = 0;
+    const iree_host_size_t end_ordinal =
+        iree_min(provider->entry_count,
+                 max_ordinal + 1 + provider->prefetch_count);
+    for (iree_host_size_t i = max_ordinal + 1; i < end_ordinal; ++i) {
+      const iree_io_parameter_index_entry_t* entry = NULL;
+      iree_status_t entry_status =
+          iree_io_parameter_index_get(provider->index, i, &entry);
+      if (!iree_status_is_ok(entry_status)) {
+        iree_status_ignore(entry_status);
+        break;
+      }
+      uint64_t offset = 0;
+      uint64_t length = 0;
+      iree_io_remote_parameter_provider_entry_range(provider, entry, 0,
+                                                    entry->length, &offset,
+                                                    &length);
+      iree_io_remote_parameter_provider_claim_range(
+          provider, offset, length, block_indices, &block_count);
+    }
+    iree_io_remote_parameter_provider_prefetch_blocks(provider, block_count,
+                                                      block_indices);
+  }
+
+  iree_allocator_free(provider->host_allocator, block_indices);
+  iree_allocator_free(provider->host_allocator, span_ranges);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// Creation
+//===----------------------------------------------------------------------===//
+
+// Returns the end of |range| relative to the archive header.
+static uint64_t iree_io_remote_archive_range_end(
+    iree_io_parameter_archive_range_t range) {
+  return range.offset + range.length;
+}
+
+// Fetches the archive header and returns the total length of the remote
+// object in |out_object_length| and the length of the prefix containing the
+// header, entry table, and metadata in |out_header_length|.
+static iree_status_t iree_io_remote_parameter_provider_query_archive(
+    iree_io_remote_fetcher_t fetcher, iree_string_view_t uri,
+    uint64_t* out_object_length, uint64_t* out_header_length) {
+  *out_object_length = 0;
+  *out_header_length = 0;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_parameter_archive_header_v0_t header;
+  memset(&header, 0, sizeof(header));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, fetcher.fn(fetcher.user_data, uri, 0,
+                     iree_make_byte_span(&header, sizeof(header.prefix))),
+      "fetching archive header of '%.*s'", (int)uri.size, uri.data);
+  if (header.prefix.magic != IREE_IO_PARAMETER_ARCHIVE_MAGIC) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "remote object '%.*s' is not an IRPA archive; magic %08X, expected "
+        "%08X",
+        (int)uri.size, uri.data, header.prefix.magic,
+        IREE_IO_PARAMETER_ARCHIVE_MAGIC);
+  }
+  if (header.prefix.version_major != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "IRPA major version %u.%u not supported by this runtime",
+        header.prefix.version_major, header.prefix.version_minor);
+  }
+  if (header.prefix.next_header_offset != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "remote IRPA archives with linked headers are not supported");
+  }
+  if (header.prefix.header_size < sizeof(header)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "IRPA header size %" PRIu64 " underflow",
+                            header.prefix.header_size);
+  }
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, fetcher.fn(fetcher.user_data, uri, 0,
+                     iree_make_byte_span(&header, sizeof(header))),
+      "fetching archive header of '%.*s'", (int)uri.size, uri.data);
+
+  const uint64_t header_length = iree_max(
+      header.prefix.header_size,
+      iree_max(iree_io_remote_archive_range_end(header.entry_segment),
+               iree_io_remote_archive_range_end(header.metadata_segment)));
+  const uint64_t object_length = iree_max(
+      header_length, iree_io_remote_archive_range_end(header.storage_segment));
+  if (object_length > IREE_HOST_SIZE_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "remote archive of %" PRIu64
+                            " bytes exceeds the host address space",
+                            object_length);
+  }
+
+  *out_object_length = object_length;
+  *out_header_length = header_length;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_io_remote_cache_release(
+    void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
+  iree_file_contents_free((iree_file_contents_t*)user_data);
+}
+
+// Allocates the local cache for an object of |object_length| bytes and wraps
+// it in a file handle that frees it when released.
+static iree_status_t iree_io_remote_parameter_provider_create_cache(
+    iree_string_view_t uri, iree_string_view_t cache_path,
+    uint64_t object_length, iree_allocator_t host_allocator,
+    iree_io_file_handle_t** out_handle) {
+  *out_handle = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_file_contents_t* contents = NULL;
+  if (iree_string_view_is_empty(cache_path)) {
+    // Host memory cache: contents are stored after the header.
+    const iree_host_size_t data_offset =
+        iree_host_align(sizeof(*contents), iree_max_align_t);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_allocator_malloc(host_allocator,
+                                  data_offset + (iree_host_size_t)object_length,
+                                  (void**)&contents));
+    contents->allocator = host_allocator;
+    contents->buffer = iree_make_byte_span((uint8_t*)contents + data_offset,
+                                           (iree_host_size_t)object_length);
+  } else {
+    // Sparse file cache named by the hash of the URI so that objects sharing a
+    // cache directory do not collide.
+    uint64_t hash = 0xCBF29CE484222325ull;
+    for (iree_host_size_t i = 0; i < uri.size; ++i) {
+      hash ^= (uint8_t)uri.data[i];
+      hash *= 0x100000001B3ull;
+    }
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "%016" PRIx64 ".irpa", hash);
+    char* path = NULL;
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_file_path_join(cache_path, iree_make_cstring_view(file_name),
+                                host_allocator, &path));
+    iree_status_t status =
+        iree_file_create_mapped(path, object_length, 0,
+                                (iree_host_size_t)object_length,
+                                host_allocator, &contents);
+    iree_allocator_free(host_allocator, path);
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(z0, status);
+  }
+
+  iree_io_file_handle_release_callback_t release_callback = {
+      .fn = iree_io_remote_cache_release,
+      .user_data = contents,
+  };
+  iree_status_t status = iree_io_file_handle_wrap_host_allocation(
+      IREE_IO_FILE_ACCESS_READ, contents->buffer, release_callback,
+      host_allocator, out_handle);
+  if (!iree_status_is_ok(status)) iree_file_contents_free(contents);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Builds the index order lookup table for the provider index.
+static iree_status_t iree_io_remote_parameter_provider_sort_entries(
+    iree_io_remote_parameter_provider_t* provider) {
+  provider->entry_count = iree_io_parameter_index_count(provider->index);
+  if (provider->entry_count == 0) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_allocator_malloc(
+      provider->host_allocator,
+      provider->entry_count * sizeof(provider->entry_ordinals[0]),
+      (void**)&provider->entry_ordinals));
+  for (iree_host_size_t i = 0; i < provider->entry_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_io_parameter_index_get(
+        provider->index, i, &provider->entry_ordinals[i].entry));
+    provider->entry_ordinals[i].ordinal = i;
+  }
+  qsort(provider->entry_ordinals, provider->entry_count,
+        sizeof(provider->entry_ordinals[0]),
+        iree_io_remote_entry_ordinal_compare);
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_io_remote_parameter_provider_create(
+    iree_string_view_t scope, iree_string_view_t uri,
+    iree_io_remote_fetcher_t fetcher,
+    const iree_io_remote_parameter_provider_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider) {
+  IREE_ASSERT_ARGUMENT(fetcher.fn);
+  IREE_ASSERT_ARGUMENT(options);
+  IREE_ASSERT_ARGUMENT(out_provider);
+  *out_provider = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, uri.data, uri.size);
+
+  if (options->block_size == 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "remote block size must be non-zero");
+  }
+
+  uint64_t object_length = 0;
+  uint64_t header_length = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_remote_parameter_provider_query_archive(
+              fetcher, uri, &object_length, &header_length));
+  const uint64_t block_count =
+      (object_length + options->block_size - 1) / options->block_size;
+  if (block_count > UINT32_MAX) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "remote archive of %" PRIu64
+                            " bytes requires too many blocks of %" PRIhsz
+                            " bytes",
+                            object_length, options->block_size);
+  }
+
+  iree_io_remote_parameter_provider_t* provider = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*provider) + uri.size,
+                                (void**)&provider));
+  iree_atomic_ref_count_init(&provider->base.ref_count);
+  provider->base.vtable = &iree_io_remote_parameter_provider_vtable;
+  provider->host_allocator = host_allocator;
+  provider->fetcher = fetcher;
+  provider->uri = iree_make_string_view(
+      (const char*)provider + sizeof(*provider), uri.size);
+  memcpy((void*)provider->uri.data, uri.data, uri.size);
+  provider->object_length = object_length;
+  provider->block_size = options->block_size;
+  provider->block_count = (uint32_t)block_count;
+  provider->prefetch_count = options->prefetch_count;
+  iree_notification_initialize(&provider->block_notification);
+  iree_task_scope_initialize(IREE_SV("iree_io_remote_prefetch"),
+                             IREE_TASK_SCOPE_FLAG_NONE,
+                             &provider->prefetch_scope);
+
+  provider->executor = options->executor;
+  iree_task_executor_retain(options->executor);
+
+  iree_status_t status = iree_allocator_malloc(
+      host_allocator, provider->block_count * sizeof(provider->block_states[0]),
+      (void**)&provider->block_states);
+  if (iree_status_is_ok(status)) {
+    status = iree_io_remote_parameter_provider_create_cache(
+        uri, options->cache_path, object_length, host_allocator,
+        &provider->cache_handle);
+  }
+  if (iree_status_is_ok(status)) {
+    provider->cache_base =
+        iree_io_file_handle_primitive(provider->cache_handle)
+            .value.host_allocation.data;
+  }
+
+  // Fetch the header blocks and parse the index from the cache.
+  if (iree_status_is_ok(status)) {
+    uint32_t* block_indices = NULL;
+    status = iree_allocator_malloc(
+        host_allocator, provider->block_count * sizeof(block_indices[0]),
+        (void**)&block_indices);
+    if (iree_status_is_ok(status)) {
+      iree_io_remote_fetch_batch_t batch = {
+          .provider = provider,
+          .is_prefetch = false,
+          .block_count = 0,
+          .block_indices = block_indices,
+      };
+      iree_io_remote_parameter_provider_claim_range(
+          provider, 0, header_length, block_indices, &batch.block_count);
+      status = iree_io_remote_parameter_provider_fetch_blocks(provider, &batch);
+    }
+    iree_allocator_free(host_allocator, block_indices);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parameter_index_create(host_allocator, &provider->index);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_io_parse_irpa_index(provider->cache_handle, provider->index);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_io_remote_parameter_provider_sort_entries(provider);
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_io_parameter_index_provider_options_t cache_options;
+    iree_io_parameter_index_provider_options_initialize(&cache_options);
+    cache_options.max_concurrent_operations =
+        options->max_concurrent_operations;
+    cache_options.executor = options->executor;
+    status = iree_io_parameter_index_provider_create_with_options(
+        scope, provider->index, &cache_options, host_allocator,
+        &provider->cache_provider);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_provider = (iree_io_parameter_provider_t*)provider;
+  } else {
+    iree_io_parameter_provider_release((iree_io_parameter_provider_t*)provider);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+//===----------------------------------------------------------------------===//
+// iree_io_parameter_provider_t implementation
+//===----------------------------------------------------------------------===//
+
+static void iree_io_remote_parameter_provider_destroy(
+    iree_io_parameter_provider_t* IREE_RESTRICT base_provider) {
+  iree_io_remote_parameter_provider_t* provider =
+      iree_io_remote_parameter_provider_cast(base_provider);
+  iree_allocator_t host_allocator = provider->host_allocator;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Join any in-flight prefetches as they write into the cache.
+  iree_status_ignore(iree_task_scope_wait_idle(&provider->prefetch_scope,
+                                               IREE_TIME_INFINITE_FUTURE));
+  iree_status_ignore(iree_task_scope_consume_status(&provider->prefetch_scope));
+  iree_task_scope_deinitialize(&provider->prefetch_scope);
+
+  iree_io_parameter_provider_release(provider->cache_provider);
+  iree_io_parameter_index_release(provider->index);
+  iree_allocator_free(host_allocator, provider->entry_ordinals);
+  // Buffers aliasing the cache retain the handle and keep it alive.
+  iree_io_file_handle_release(provider->cache_handle);
+  iree_allocator_free(host_allocator, provider->block_states);
+  iree_notification_deinitialize(&provider->block_notification);
+  iree_task_executor_release(provider->executor);
+
+  iree_allocator_free(host_allocator, provider);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+static iree_status_t iree_io_remote_parameter_provider_notify(
+    iree_io_parameter_provider_t* base_provider,
+    iree_io_parameter_provider_signal_t signal) {
+  iree_io_remote_parameter_provider_t* provider =
+      iree_io_remote_parameter_provider_cast(base_provider);
+  return iree_io_parameter_provider_notify(provider->cache_provider, signal);
+}
+
+static bool iree_io_remote_parameter_provider_query_support(
+    iree_io_parameter_provider_t* base_provider, iree_string_view_t scope) {
+  iree_io_remote_parameter_provider_t* provider =
+      iree_io_remote_parameter_provider_cast(base_provider);
+  return iree_io_parameter_provider_query_support(provider->cache_provider,
+                                                  scope);
+}
+
+static iree_status_t iree_io_remote_parameter_provider_load(
+    iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_string_view_t source_scope, iree_hal_buffer_params_t target_params,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator,
+    iree_io_parameter_emitter_t emitter) {
+  iree_io_remote_parameter_provider_t* provider =
+      iree_io_remote_parameter_provider_cast(base_provider);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_remote_parameter_provider_fetch_spans(provider, count,
+                                                        enumerator));
+  iree_status_t status = iree_io_parameter_provider_load(
+      provider->cache_provider, device, queue_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_scope, target_params, count, enumerator,
+      emitter);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_remote_parameter_provider_gather(
+    iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_string_view_t source_scope, iree_hal_buffer_t* target_buffer,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator) {
+  iree_io_remote_parameter_provider_t* provider =
+      iree_io_remote_parameter_provider_cast(base_provider);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, count);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_remote_parameter_provider_fetch_spans(provider, count,
+                                                        enumerator));
+  iree_status_t status = iree_io_parameter_provider_gather(
+      provider->cache_provider, device, queue_affinity, wait_semaphore_list,
+      signal_semaphore_list, source_scope, target_buffer, count, enumerator);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_remote_parameter_provider_scatter(
+    iree_io_parameter_provider_t* base_provider, iree_hal_device_t* device,
+    iree_hal_queue_affinity_t queue_affinity,
+    const iree_hal_semaphore_list_t wait_semaphore_list,
+    const iree_hal_semaphore_list_t signal_semaphore_list,
+    iree_hal_buffer_t* source_buffer, iree_string_view_t target_scope,
+    iree_host_size_t count, iree_io_parameter_enumerator_t enumerator) {
+  iree_io_remote_parameter_provider_t* provider =
+      iree_io_remote_parameter_provider_cast(base_provider);
+  return iree_make_status(IREE_STATUS_PERMISSION_DENIED,
+                          "remote parameters from '%.*s' are read-only",
+                          (int)provider->uri.size, provider->uri.data);
+}
+
+static const iree_io_parameter_provider_vtable_t
+    iree_io_remote_parameter_provider_vtable = {
+        .destroy = iree_io_remote_parameter_provider_destroy,
+        .notify = iree_io_remote_parameter_provider_notify,
+        .query_support = iree_io_remote_parameter_provider_query_support,
+        .load = iree_io_remote_parameter_provider_load,
+        .gather = iree_io_remote_parameter_provider_gather,
+        .scatter = iree_io_remote_parameter_provider_scatter,
+};
@@ -0,0 +1,105 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_IO_REMOTE_PARAMETER_PROVIDER_H_
+#define IREE_IO_REMOTE_PARAMETER_PROVIDER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/io/parameter_provider.h"
+#include "iree/task/executor.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_io_remote_fetcher_t
+//===----------------------------------------------------------------------===//
+
+// Fetches |target|.data_length bytes starting at |offset| of the remote object
+// at |uri| into |target|. This is the range request transport used by remote
+// providers and is expected to be implemented by the hosting application with
+// whatever client it uses for its object store (such as an HTTP client issuing
+// `Range: bytes=` requests against S3 or GCS-compatible endpoints).
+//
+// Must be thread-safe: fetches of different ranges of the same object are
+// issued concurrently when the provider has an executor. Returning an error
+// fails the operation that required the range; ranges that were being
+// prefetched are retried on demand.
+typedef iree_status_t(IREE_API_PTR* iree_io_remote_fetch_fn_t)(
+    void* user_data, iree_string_view_t uri, uint64_t offset,
+    iree_byte_span_t target);
+
+typedef struct iree_io_remote_fetcher_t {
+  // Callback function pointer.
+  iree_io_remote_fetch_fn_t fn;
+  // User data passed to the callback function. Unowned.
+  void* user_data;
+} iree_io_remote_fetcher_t;
+
+//===----------------------------------------------------------------------===//
+// iree_io_remote_parameter_provider_t
+//===----------------------------------------------------------------------===//
+
+// Default size of each range request and the granularity of the cache.
+#define IREE_IO_REMOTE_PARAMETER_PROVIDER_DEFAULT_BLOCK_SIZE (8 * 1024 * 1024)
+
+// Default number of parameters following the last one requested in index order
+// to prefetch.
+#define IREE_IO_REMOTE_PARAMETER_PROVIDER_DEFAULT_PREFETCH_COUNT 4
+
+typedef struct iree_io_remote_parameter_provider_options_t {
+  // Size in bytes of each range request. Parameters are fetched and cached in
+  // whole blocks. Larger blocks amortize request latency while smaller blocks
+  // reduce over-fetch for sparse access.
+  iree_host_size_t block_size;
+  // Number of parameters following the last one requested by a load or gather
+  // in index order to fetch in the background. Only used when |executor| is
+  // provided. 0 disables prefetching.
+  iree_host_size_t prefetch_count;
+  // Directory on local storage (ideally an SSD) used to hold the cache of the
+  // remote object. The cache is a sparse file the size of the remote object
+  // that is filled in as ranges are fetched. It is recreated each time a
+  // provider is created for the object. If empty the cache is held in host
+  // memory.
+  iree_string_view_t cache_path;
+  // Limits how many file operations as part of a gather or scatter are allowed
+  // to be in-flight at a time when reading from the cache.
+  iree_host_size_t max_concurrent_operations;
+  // Optional executor used to issue range requests in parallel and to
+  // prefetch in the background. Requests are issued serially on the calling
+  // thread if NULL.
+  // Retained by the provider.
+  iree_task_executor_t* executor;
+} iree_io_remote_parameter_provider_options_t;
+
+// Initializes |out_options| to the default values.
+IREE_API_EXPORT void iree_io_remote_parameter_provider_options_initialize(
+    iree_io_remote_parameter_provider_options_t* out_options);
+
+// Creates a parameter provider serving |scope| from the IREE parameter archive
+// (.irpa) stored remotely at |uri|. Byte ranges of the archive are fetched
+// with |fetcher| as they are needed: creation fetches only the archive header
+// and each load or gather fetches the blocks covering the requested spans in
+// parallel before reading them from the local cache. Each request also
+// prefetches the parameters that follow it in index order such that
+// sequential initialization overlaps compute with network transfer.
+//
+// Remote parameters are read-only and scatters fail.
+IREE_API_EXPORT iree_status_t iree_io_remote_parameter_provider_create(
+    iree_string_view_t scope, iree_string_view_t uri,
+    iree_io_remote_fetcher_t fetcher,
+    const iree_io_remote_parameter_provider_options_t* options,
+    iree_allocator_t host_allocator,
+    iree_io_parameter_provider_t** out_provider);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_IO_REMOTE_PARAMETER_PROVIDER_H_
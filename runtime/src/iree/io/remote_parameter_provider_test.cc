@@ -0,0 +1,408 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/io/remote_parameter_provider.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/io/file_handle.h"
+#include "iree/io/formats/irpa/irpa_builder.h"
+#include "iree/io/parameter_index.h"
+#include "iree/task/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+
+namespace iree {
+namespace io {
+namespace {
+
+static constexpr iree_host_size_t kBlockSize = 4096;
+static constexpr iree_host_size_t kParameterLength = 4 * kBlockSize;
+static const char kUri[] = "test://bucket/parameters.irpa";
+
+// Serves range requests of an in-memory object and records which bytes were
+// requested.
+class TestFetcher {
+ public:
+  explicit TestFetcher(std::vector<uint8_t> object)
+      : object_(std::move(object)), fetch_counts_(object_.size()) {}
+
+  iree_io_remote_fetcher_t fetcher() { return {Fetch, this}; }
+
+  // Fails the next |count| fetches.
+  void FailFetches(int count) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    fail_count_ = count;
+  }
+
+  // Returns true if any byte in the given range was fetched.
+  bool AnyFetched(uint64_t offset, uint64_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint64_t i = offset; i < offset + length; ++i) {
+      if (fetch_counts_[i]) return true;
+    }
+    return false;
+  }
+
+  // Returns true if every byte in the given range was fetched.
+  bool AllFetched(uint64_t offset, uint64_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (uint64_t i = offset; i < offset + length; ++i) {
+      if (!fetch_counts_[i]) return false;
+    }
+    return true;
+  }
+
+  // Returns the largest number of times any byte in the range was fetched.
+  int MaxFetchCount(uint64_t offset, uint64_t length) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    int max_count = 0;
+    for (uint64_t i = offset; i < offset + length; ++i) {
+      max_count = std::max(max_count, fetch_counts_[i]);
+    }
+    return max_count;
+  }
+
+ private:
+  static iree_status_t Fetch(void* user_data, iree_string_view_t uri,
+                             uint64_t offset, iree_byte_span_t target) {
+    TestFetcher* fetcher = (TestFetcher*)user_data;
+    if (!iree_string_view_equal(uri, IREE_SV(kUri))) {
+      return iree_make_status(IREE_STATUS_NOT_FOUND, "unknown object");
+    }
+    std::lock_guard<std::mutex> lock(fetcher->mutex_);
+    if (fetcher->fail_count_ > 0) {
+      --fetcher->fail_count_;
+      return iree_make_status(IREE_STATUS_UNAVAILABLE, "fetch failed");
+    }
+    if (offset + target.data_length > fetcher->object_.size()) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE, "fetch out of range");
+    }
+    memcpy(target.data, fetcher->object_.data() + offset, target.data_length);
+    for (iree_host_size_t i = 0; i < target.data_length; ++i) {
+      ++fetcher->fetch_counts_[offset + i];
+    }
+    return iree_ok_status();
+  }
+
+  std::vector<uint8_t> object_;
+  std::mutex mutex_;
+  std::vector<int> fetch_counts_;
+  int fail_count_ = 0;
+};
+
+// Location of a parameter in the archive.
+struct ParameterRange {
+  uint64_t offset;
+  uint64_t length;
+};
+
+class RemoteParameterProviderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_hal_allocator_t* device_allocator = NULL;
+    IREE_ASSERT_OK(iree_hal_allocator_create_heap(
+        iree_make_cstring_view("local"), host_allocator, host_allocator,
+        &device_allocator));
+    iree_hal_sync_device_params_t params;
+    iree_hal_sync_device_params_initialize(&params);
+    iree_status_t status = iree_hal_sync_device_create(
+        iree_make_cstring_view("local-sync"), &params, /*loader_count=*/0,
+        /*loaders=*/NULL, device_allocator, host_allocator, &device_);
+    iree_hal_allocator_release(device_allocator);
+    IREE_ASSERT_OK(status);
+
+    // Parameter |i| is filled with the byte value i + 1.
+    std::vector<uint8_t> archive;
+    BuildArchive({"a", "b", "c"}, &archive);
+    fetcher_ = std::make_unique<TestFetcher>(std::move(archive));
+  }
+
+  void TearDown() override { iree_hal_device_release(device_); }
+
+  // Builds an archive of block-aligned parameters with |names|.
+  void BuildArchive(std::vector<std::string> names,
+                    std::vector<uint8_t>* out_archive) {
+    iree_allocator_t host_allocator = iree_allocator_system();
+    iree_io_parameter_archive_builder_t builder;
+    IREE_ASSERT_OK(
+        iree_io_parameter_archive_builder_initialize(host_allocator, &builder));
+    for (const auto& name : names) {
+      IREE_ASSERT_OK(iree_io_parameter_archive_builder_add_data_entry(
+          &builder, iree_make_string_view(name.data(), name.size()),
+          iree_const_byte_span_empty(), /*minimum_alignment=*/kBlockSize,
+          kParameterLength));
+    }
+    out_archive->resize(
+        (size_t)iree_io_parameter_archive_builder_total_size(&builder));
+
+    iree_io_file_handle_t* file_handle = NULL;
+    IREE_ASSERT_OK(iree_io_file_handle_wrap_host_allocation(
+        IREE_IO_FILE_ACCESS_READ | IREE_IO_FILE_ACCESS_WRITE,
+        iree_make_byte_span(out_archive->data(), out_archive->size()),
+        iree_io_file_handle_release_callback_null(), host_allocator,
+        &file_handle));
+    iree_io_stream_t* stream = NULL;
+    IREE_ASSERT_OK(iree_io_stream_open(IREE_IO_STREAM_MODE_WRITABLE,
+                                       file_handle, 0, host_allocator,
+                                       &stream));
+    iree_io_parameter_index_t* index = NULL;
+    IREE_ASSERT_OK(iree_io_parameter_index_create(host_allocator, &index));
+    IREE_ASSERT_OK(iree_io_parameter_archive_builder_write(
+        &builder, file_handle, 0, stream, index));
+    for (size_t i = 0; i < names.size(); ++i) {
+      const iree_io_parameter_index_entry_t* entry = NULL;
+      IREE_ASSERT_OK(iree_io_parameter_index_lookup(
+          index, iree_make_string_view(names[i].data(), names[i].size()),
+          &entry));
+      ParameterRange range = {entry->storage.file.offset, entry->length};
+      memset(out_archive->data() + range.offset, (int)(i + 1), range.length);
+      ranges_[names[i]] = range;
+    }
+    iree_io_parameter_index_release(index);
+    iree_io_stream_release(stream);
+    iree_io_file_handle_release(file_handle);
+    iree_io_parameter_archive_builder_deinitialize(&builder);
+  }
+
+  iree_io_remote_parameter_provider_options_t DefaultOptions() {
+    iree_io_remote_parameter_provider_options_t options;
+    iree_io_remote_parameter_provider_options_initialize(&options);
+    options.block_size = kBlockSize;
+    return options;
+  }
+
+  iree_io_parameter_provider_t* CreateProvider(
+      const iree_io_remote_parameter_provider_options_t& options) {
+    iree_io_parameter_provider_t* provider = NULL;
+    IREE_CHECK_OK(iree_io_remote_parameter_provider_create(
+        IREE_SV("scope"), IREE_SV(kUri), fetcher_->fetcher(), &options,
+        iree_allocator_system(), &provider));
+    return provider;
+  }
+
+  bool AnyFetched(const std::string& name) {
+    return fetcher_->AnyFetched(ranges_[name].offset, ranges_[name].length);
+  }
+  bool AllFetched(const std::string& name) {
+    return fetcher_->AllFetched(ranges_[name].offset, ranges_[name].length);
+  }
+  int MaxFetchCount(const std::string& name) {
+    return fetcher_->MaxFetchCount(ranges_[name].offset, ranges_[name].length);
+  }
+
+  // Gathers |length| bytes at |parameter_offset| of |name| and returns them.
+  iree_status_t Gather(iree_io_parameter_provider_t* provider,
+                       const std::string& name, uint64_t parameter_offset,
+                       iree_device_size_t length,
+                       std::vector<uint8_t>* out_contents) {
+    iree_hal_buffer_params_t params = {0};
+    params.type =
+        IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL | IREE_HAL_MEMORY_TYPE_HOST_VISIBLE;
+    params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER |
+                   IREE_HAL_BUFFER_USAGE_MAPPING;
+    iree_hal_buffer_t* buffer = NULL;
+    IREE_RETURN_IF_ERROR(iree_hal_allocator_allocate_buffer(
+        iree_hal_device_allocator(device_), params, length, &buffer));
+    iree_hal_semaphore_t* semaphore = NULL;
+    iree_status_t status = iree_hal_semaphore_create(device_, 0, &semaphore);
+
+    struct Request {
+      iree_string_view_t key;
+      iree_io_parameter_span_t span;
+    } request = {
+        iree_make_string_view(name.data(), name.size()),
+        {parameter_offset, 0, length},
+    };
+    iree_io_parameter_enumerator_t enumerator = {
+        +[](void* user_data, iree_host_size_t i, iree_string_view_t* out_key,
+            iree_io_parameter_span_t* out_span) {
+          Request* request = (Request*)user_data;
+          *out_key = request->key;
+          *out_span = request->span;
+          return iree_ok_status();
+        },
+        &request,
+    };
+    uint64_t signal_value = 1;
+    iree_hal_semaphore_list_t signal_semaphore_list = {1, &semaphore,
+                                                       &signal_value};
+    if (iree_status_is_ok(status)) {
+      status = iree_io_parameter_provider_gather(
+          provider, device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+          iree_hal_semaphore_list_empty(), signal_semaphore_list,
+          IREE_SV("scope"), buffer, 1, enumerator);
+    }
+    if (iree_status_is_ok(status)) {
+      status = iree_hal_semaphore_wait(semaphore, signal_value,
+                                       iree_infinite_timeout());
+    }
+    if (iree_status_is_ok(status)) {
+      out_contents->resize(length);
+      status = iree_hal_buffer_map_read(buffer, 0, out_contents->data(),
+                                        length);
+    }
+    iree_hal_semaphore_release(semaphore);
+    iree_hal_buffer_release(buffer);
+    return status;
+  }
+
+  iree_hal_device_t* device_ = NULL;
+  std::unique_ptr<TestFetcher> fetcher_;
+  std::map<std::string, ParameterRange> ranges_;
+};
+
+// Tests that creation only fetches the archive header.
+TEST_F(RemoteParameterProviderTest, CreateFetchesHeaderOnly) {
+  iree_io_parameter_provider_t* provider = CreateProvider(DefaultOptions());
+  EXPECT_TRUE(fetcher_->AllFetched(0, sizeof(uint32_t)));
+  EXPECT_FALSE(AnyFetched("a"));
+  EXPECT_FALSE(AnyFetched("b"));
+  EXPECT_FALSE(AnyFetched("c"));
+  iree_io_parameter_provider_release(provider);
+}
+
+// Tests that objects that are not archives are rejected.
+TEST_F(RemoteParameterProviderTest, CreateNotAnArchive) {
+  TestFetcher fetcher(std::vector<uint8_t>(kBlockSize, 0xCD));
+  iree_io_remote_parameter_provider_options_t options = DefaultOptions();
+  iree_io_parameter_provider_t* provider = NULL;
+  iree_status_t status = iree_io_remote_parameter_provider_create(
+      IREE_SV("scope"), IREE_SV(kUri), fetcher.fetcher(), &options,
+      iree_allocator_system(), &provider);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_INVALID_ARGUMENT, status);
+  iree_status_free(status);
+  EXPECT_EQ(provider, nullptr);
+}
+
+// Tests that a gather only fetches the blocks covering the requested span.
+TEST_F(RemoteParameterProviderTest, GatherFetchesSpanBlocks) {
+  iree_io_parameter_provider_t* provider = CreateProvider(DefaultOptions());
+  std::vector<uint8_t> contents;
+  IREE_ASSERT_OK(Gather(provider, "b", kBlockSize + 16, 64, &contents));
+  EXPECT_EQ(contents, std::vector<uint8_t>(64, 2));
+  EXPECT_FALSE(fetcher_->AnyFetched(ranges_["b"].offset, kBlockSize));
+  EXPECT_TRUE(
+      fetcher_->AllFetched(ranges_["b"].offset + kBlockSize, kBlockSize));
+  EXPECT_FALSE(fetcher_->AnyFetched(ranges_["b"].offset + 2 * kBlockSize,
+                                    2 * kBlockSize));
+  EXPECT_FALSE(AnyFetched("a"));
+  EXPECT_FALSE(AnyFetched("c"));
+
+  // Resident blocks are served from the cache.
+  IREE_ASSERT_OK(Gather(provider, "b", kBlockSize, kBlockSize, &contents));
+  EXPECT_EQ(contents, std::vector<uint8_t>(kBlockSize, 2));
+  EXPECT_EQ(MaxFetchCount("b"), 1);
+  iree_io_parameter_provider_release(provider);
+}
+
+// Tests that parameters can be cached in a local file.
+TEST_F(RemoteParameterProviderTest, GatherFileCache) {
+  std::string cache_path = ::testing::TempDir();
+  iree_io_remote_parameter_provider_options_t options = DefaultOptions();
+  options.cache_path =
+      iree_make_string_view(cache_path.data(), cache_path.size());
+  iree_io_parameter_provider_t* provider = CreateProvider(options);
+  std::vector<uint8_t> contents;
+  IREE_ASSERT_OK(Gather(provider, "c", 0, kParameterLength, &contents));
+  EXPECT_EQ(contents, std::vector<uint8_t>(kParameterLength, 3));
+  EXPECT_TRUE(AllFetched("c"));
+  EXPECT_FALSE(AnyFetched("b"));
+  iree_io_parameter_provider_release(provider);
+}
+
+// Tests that blocks that failed to fetch are fetched again on the next use.
+TEST_F(RemoteParameterProviderTest, GatherRetriesFailedFetches) {
+  iree_io_parameter_provider_t* provider = CreateProvider(DefaultOptions());
+  std::vector<uint8_t> contents;
+  fetcher_->FailFetches(1);
+  iree_status_t status = Gather(provider, "a", 0, kParameterLength, &contents);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_UNAVAILABLE, status);
+  iree_status_free(status);
+  IREE_ASSERT_OK(Gather(provider, "a", 0, kParameterLength, &contents));
+  EXPECT_EQ(contents, std::vector<uint8_t>(kParameterLength, 1));
+  EXPECT_EQ(MaxFetchCount("a"), 1);
+  iree_io_parameter_provider_release(provider);
+}
+
+// Tests that blocks are fetched in parallel on an executor and that the
+// parameters following a request in index order are prefetched.
+TEST_F(RemoteParameterProviderTest, GatherPrefetchesNextParameters) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_options_t executor_options;
+  iree_task_executor_options_initialize(&executor_options);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(executor_options, &topology,
+                                           iree_allocator_system(),
+                                           &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_io_remote_parameter_provider_options_t options = DefaultOptions();
+  options.executor = executor;
+  options.prefetch_count = 1;
+  iree_io_parameter_provider_t* provider = CreateProvider(options);
+  iree_task_executor_release(executor);
+
+  std::vector<uint8_t> contents;
+  IREE_ASSERT_OK(Gather(provider, "a", 0, kParameterLength, &contents));
+  EXPECT_EQ(contents, std::vector<uint8_t>(kParameterLength, 1));
+
+  // The gather of "b" either waits on the prefetch or reuses its result.
+  IREE_ASSERT_OK(Gather(provider, "b", 0, kParameterLength, &contents));
+  EXPECT_EQ(contents, std::vector<uint8_t>(kParameterLength, 2));
+  EXPECT_EQ(MaxFetchCount("a"), 1);
+  EXPECT_EQ(MaxFetchCount("b"), 1);
+
+  // Releasing the provider joins the prefetch of "c" issued by the gather of
+  // "b" and nothing after it is requested.
+  iree_io_parameter_provider_release(provider);
+  EXPECT_TRUE(AllFetched("c"));
+  EXPECT_EQ(MaxFetchCount("c"), 1);
+}
+
+// Tests that remote parameters are read-only.
+TEST_F(RemoteParameterProviderTest, ScatterIsReadOnly) {
+  iree_io_parameter_provider_t* provider = CreateProvider(DefaultOptions());
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_ASSERT_OK(iree_hal_allocator_allocate_buffer(
+      iree_hal_device_allocator(device_), params, 16, &buffer));
+  iree_io_parameter_enumerator_t enumerator = {
+      +[](void* user_data, iree_host_size_t i, iree_string_view_t* out_key,
+          iree_io_parameter_span_t* out_span) {
+        *out_key = IREE_SV("a");
+        *out_span = {0, 0, 16};
+        return iree_ok_status();
+      },
+      NULL,
+  };
+  iree_status_t status = iree_io_parameter_provider_scatter(
+      provider, device_, IREE_HAL_QUEUE_AFFINITY_ANY,
+      iree_hal_semaphore_list_empty(), iree_hal_semaphore_list_empty(), buffer,
+      IREE_SV("scope"), 1, enumerator);
+  IREE_EXPECT_STATUS_IS(IREE_STATUS_PERMISSION_DENIED, status);
+  iree_status_free(status);
+  EXPECT_FALSE(AnyFetched("a"));
+  iree_hal_buffer_release(buffer);
+  iree_io_parameter_provider_release(provider);
+}
+
+}  // namespace
+}  // namespace io
+}  // namespace iree
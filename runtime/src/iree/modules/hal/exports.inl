@@ -52,6 +52,7 @@ EXPORT_FN("command_buffer.copy_buffer", iree_hal_module_command_buffer_copy_buff
 EXPORT_FN("command_buffer.create", iree_hal_module_command_buffer_create, riii, r)
 EXPORT_FN("command_buffer.dispatch", iree_hal_module_command_buffer_dispatch, rriiii, v)
 EXPORT_FN("command_buffer.dispatch.indirect", iree_hal_module_command_buffer_dispatch_indirect, rrirI, v)
+EXPORT_FN("command_buffer.dispatch.packed", iree_hal_module_command_buffer_dispatch_packed, rrriiiiCiDiCiirIID, v)
 EXPORT_FN("command_buffer.end_debug_group", iree_hal_module_command_buffer_end_debug_group, r, v)
 EXPORT_FN("command_buffer.execute.commands", iree_hal_module_command_buffer_execute_commands, rrCrIID, v)
 EXPORT_FN("command_buffer.execution_barrier", iree_hal_module_command_buffer_execution_barrier, riii, v)
@@ -67,6 +68,7 @@ EXPORT_FN("device.query.i64", iree_hal_module_device_query_i64, rrr, iI)
 EXPORT_FN("device.queue.alloca", iree_hal_module_device_queue_alloca, rIrriiiI, r)
 EXPORT_FN("device.queue.dealloca", iree_hal_module_device_queue_dealloca, rIrrr, v)
 EXPORT_FN("device.queue.execute", iree_hal_module_device_queue_execute, rIrrCrD, v)
+EXPORT_FN("device.queue.execute.indirect", iree_hal_module_device_queue_execute_indirect, rIrrrCrIID, v)
 EXPORT_FN("device.queue.flush", iree_hal_module_device_queue_flush, rI, v)
 EXPORT_FN("device.queue.read", iree_hal_module_device_queue_read, rIrrrIrIIi, v)
 EXPORT_FN("device.queue.write", iree_hal_module_device_queue_write, rIrrrIrIIi, v)
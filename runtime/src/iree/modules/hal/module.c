@@ -33,7 +33,9 @@
 //===----------------------------------------------------------------------===//
 
 #define IREE_HAL_MODULE_VERSION_0_2 0x00000002u
-#define IREE_HAL_MODULE_VERSION_LATEST IREE_HAL_MODULE_VERSION_0_2
+#define IREE_HAL_MODULE_VERSION_0_3 0x00000003u
+#define IREE_HAL_MODULE_VERSION_0_4 0x00000004u
+#define IREE_HAL_MODULE_VERSION_LATEST IREE_HAL_MODULE_VERSION_0_4
 
 typedef struct iree_hal_module_t {
   iree_allocator_t host_allocator;
@@ -52,6 +54,10 @@ static void IREE_API_PTR iree_hal_module_destroy(void* base_module) {
   }
 }
 
+// Number of shape dimensions stored inline in pooled buffer views. Higher rank
+// buffer views are rare and allocated individually.
+#define IREE_HAL_MODULE_BUFFER_VIEW_POOL_SHAPE_CAPACITY 8
+
 typedef struct iree_hal_module_state_t {
   iree_allocator_t host_allocator;
 
@@ -71,6 +77,11 @@ typedef struct iree_hal_module_state_t {
   // instead be taking a loop upon creation and scheduling work against that.
   iree_status_t loop_status;
 
+  // Pool of buffer views created by hal.buffer_view.create. Most buffer views
+  // in a call are short-lived and recycling them avoids a host allocation per
+  // buffer view.
+  iree_hal_buffer_view_pool_t* buffer_view_pool;
+
   // Shared executable cache for each device used to cache all executables
   // created in the context. We could have multiple to allow for modules to
   // create distinct sets of executables like ones for training vs inference in
@@ -98,8 +109,11 @@ iree_hal_module_alloc_state(void* self, iree_allocator_t host_allocator,
   state->devices = module->devices;
   state->loop_status = iree_ok_status();
 
-  iree_status_t status = iree_ok_status();
-  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+  iree_status_t status = iree_hal_buffer_view_pool_create(
+      IREE_HAL_MODULE_BUFFER_VIEW_POOL_SHAPE_CAPACITY, host_allocator,
+      &state->buffer_view_pool);
+  for (iree_host_size_t i = 0;
+       iree_status_is_ok(status) && i < state->device_count; ++i) {
     status = iree_hal_executable_cache_create(
         state->devices[i], iree_string_view_empty(),
         iree_loop_inline(&state->loop_status), &state->executable_caches[i]);
@@ -112,12 +126,48 @@ iree_hal_module_alloc_state(void* self, iree_allocator_t host_allocator,
     for (iree_host_size_t i = 0; i < state->device_count; ++i) {
       iree_hal_executable_cache_release(state->executable_caches[i]);
     }
+    iree_hal_buffer_view_pool_release(state->buffer_view_pool);
     iree_allocator_free(host_allocator, state);
   }
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
 
+static iree_status_t IREE_API_PTR iree_hal_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t host_allocator,
+    iree_vm_module_state_t** out_module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_hal_module_state_t* parent = (iree_hal_module_state_t*)parent_state;
+  iree_hal_module_state_t* state = NULL;
+  iree_host_size_t total_size =
+      sizeof(*state) +
+      parent->device_count * sizeof(state->executable_caches[0]);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&state));
+  memset(state, 0, total_size);
+  state->host_allocator = host_allocator;
+  state->flags = parent->flags;
+  state->device_count = parent->device_count;
+  state->devices = parent->devices;
+  state->loop_status = iree_ok_status();
+
+  // Executable caches are shared with the parent so that executables prepared
+  // by any context forked from the same parent hit the same caches. The buffer
+  // view pool is thread-safe and shared as well.
+  state->buffer_view_pool = parent->buffer_view_pool;
+  iree_hal_buffer_view_pool_retain(state->buffer_view_pool);
+  for (iree_host_size_t i = 0; i < state->device_count; ++i) {
+    state->executable_caches[i] = parent->executable_caches[i];
+    iree_hal_executable_cache_retain(state->executable_caches[i]);
+  }
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static void IREE_API_PTR
 iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state) {
   IREE_TRACE_ZONE_BEGIN(z0);
@@ -126,6 +176,7 @@ iree_hal_module_free_state(void* self, iree_vm_module_state_t* module_state) {
   for (iree_host_size_t i = 0; i < state->device_count; ++i) {
     iree_hal_executable_cache_release(state->executable_caches[i]);
   }
+  iree_hal_buffer_view_pool_release(state->buffer_view_pool);
   iree_status_ignore(state->loop_status);
   iree_allocator_free(state->host_allocator, state);
 
@@ -159,6 +210,7 @@ static iree_status_t IREE_API_PTR iree_hal_module_notify(
   switch (signal) {
     case IREE_VM_SIGNAL_SUSPEND:
     case IREE_VM_SIGNAL_LOW_MEMORY: {
+      iree_hal_buffer_view_pool_trim(state->buffer_view_pool);
       for (iree_host_size_t i = 0; i < state->device_count; ++i) {
         IREE_RETURN_IF_ERROR(iree_hal_device_trim(state->devices[i]));
       }
@@ -513,11 +565,12 @@ IREE_VM_ABI_EXPORT(iree_hal_module_buffer_view_create,  //
   }
 
   iree_hal_buffer_view_t* buffer_view = NULL;
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_view_create(
-      subspan_buffer ? subspan_buffer : source_buffer, shape_rank, shape_dims,
-      element_type, encoding_type, state->host_allocator, &buffer_view));
+  iree_status_t status = iree_hal_buffer_view_pool_acquire(
+      state->buffer_view_pool, subspan_buffer ? subspan_buffer : source_buffer,
+      shape_rank, shape_dims, element_type, encoding_type, &buffer_view);
 
   iree_hal_buffer_release(subspan_buffer);
+  IREE_RETURN_IF_ERROR(status);
 
   rets->r0 = iree_hal_buffer_view_move_ref(buffer_view);
   return iree_ok_status();
@@ -901,6 +954,65 @@ IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch,  //
                                           workgroup_z);
 }
 
+// Fused form of push_constants + push_descriptor_set + dispatch used by the
+// compiler when all three are recorded back-to-back. Amortizes the VM import
+// overhead of the common dispatch sequence into a single call.
+IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch_packed,  //
+                   iree_hal_module_state_t,                         //
+                   rrriiiiCiDiCiirIID, v) {
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_command_buffer_check_deref(args->r0, &command_buffer));
+  iree_hal_pipeline_layout_t* pipeline_layout = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_pipeline_layout_check_deref(args->r1, &pipeline_layout));
+  iree_hal_executable_t* executable = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_executable_check_deref(args->r2, &executable));
+  uint32_t entry_point = (uint32_t)args->i3;
+  uint32_t workgroup_x = (uint32_t)args->i4;
+  uint32_t workgroup_y = (uint32_t)args->i5;
+  uint32_t workgroup_z = (uint32_t)args->i6;
+
+  // Push constants always start at offset 0 when packed.
+  iree_host_size_t constant_count = args->a7_count;
+  if (constant_count > 0) {
+    const uint32_t* constants = (const uint32_t*)&args->a7[0].i0;
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_push_constants(
+        command_buffer, pipeline_layout, 0, constants,
+        constant_count * sizeof(uint32_t)));
+  }
+
+  const iree_vm_abi_iCiirIID_t* set_args =
+      iree_vm_abi_rrriiiiCiDiCiirIID_tail(args);
+  iree_host_size_t binding_count = set_args->a1_count;
+  if (binding_count > 0) {
+    if (IREE_UNLIKELY(binding_count >
+                      IREE_HAL_MODULE_MAX_DESCRIPTOR_BINDING_COUNT)) {
+      return iree_make_status(
+          IREE_STATUS_OUT_OF_RANGE, "binding count %" PRIhsz " > %" PRIhsz,
+          binding_count, IREE_HAL_MODULE_MAX_DESCRIPTOR_BINDING_COUNT);
+    }
+    iree_hal_descriptor_set_binding_t* bindings =
+        (iree_hal_descriptor_set_binding_t*)iree_alloca(
+            binding_count * sizeof(iree_hal_descriptor_set_binding_t));
+    for (iree_host_size_t i = 0; i < binding_count; ++i) {
+      bindings[i].binding = (uint32_t)set_args->a1[i].i0;
+      bindings[i].buffer_slot = (uint32_t)set_args->a1[i].i1;
+      IREE_RETURN_IF_ERROR(iree_hal_buffer_check_deref_or_null(
+          set_args->a1[i].r2, &bindings[i].buffer));
+      bindings[i].offset = iree_hal_cast_device_size(set_args->a1[i].i3);
+      bindings[i].length = iree_hal_cast_device_size(set_args->a1[i].i4);
+    }
+    IREE_RETURN_IF_ERROR(iree_hal_command_buffer_push_descriptor_set(
+        command_buffer, pipeline_layout, (uint32_t)set_args->i0, binding_count,
+        bindings));
+  }
+
+  return iree_hal_command_buffer_dispatch(command_buffer, executable,
+                                          entry_point, workgroup_x, workgroup_y,
+                                          workgroup_z);
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_command_buffer_dispatch_indirect,  //
                    iree_hal_module_state_t,                           //
                    rrirI, v) {
@@ -1131,6 +1243,66 @@ IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_execute,  //
       command_buffers);
 }
 
+IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_execute_indirect,  //
+                   iree_hal_module_state_t,                        //
+                   rIrrrCrIID, v) {
+  iree_hal_device_t* device = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_device_check_deref(args->r0, &device));
+  iree_hal_queue_affinity_t queue_affinity =
+      (iree_hal_queue_affinity_t)args->i1;
+  iree_hal_fence_t* wait_fence = iree_hal_fence_deref(args->r2);
+  iree_hal_fence_t* signal_fence = iree_hal_fence_deref(args->r3);
+  iree_hal_command_buffer_t* commands = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_command_buffer_check_deref(args->r4, &commands));
+
+  iree_host_size_t binding_count = args->a5_count;
+  if (IREE_UNLIKELY(binding_count >
+                    IREE_HAL_MODULE_MAX_COMMAND_BUFFER_BINDING_COUNT)) {
+    return iree_make_status(
+        IREE_STATUS_OUT_OF_RANGE, "binding table count %" PRIhsz " > %" PRIhsz,
+        binding_count, IREE_HAL_MODULE_MAX_COMMAND_BUFFER_BINDING_COUNT);
+  }
+  iree_hal_buffer_binding_t* bindings = (iree_hal_buffer_binding_t*)iree_alloca(
+      binding_count * sizeof(iree_hal_buffer_binding_t));
+  for (iree_host_size_t i = 0; i < binding_count; ++i) {
+    IREE_RETURN_IF_ERROR(iree_hal_buffer_check_deref_or_null(
+        args->a5[i].r0, &bindings[i].buffer));
+    bindings[i].offset = iree_hal_cast_device_size(args->a5[i].i1);
+    bindings[i].length = iree_hal_cast_device_size(args->a5[i].i2);
+  }
+  const iree_hal_buffer_binding_table_t binding_table = {
+      .count = binding_count,
+      .bindings = bindings,
+  };
+
+  // The reusable |commands| were recorded once with binding table slots and
+  // are issued from a small one-shot primary command buffer that supplies the
+  // table for this submission only. Drivers that support nested execution
+  // natively replay the recorded commands without re-recording them from the
+  // VM.
+  iree_hal_command_buffer_t* command_buffer = NULL;
+  IREE_RETURN_IF_ERROR(iree_hal_command_buffer_create(
+      device, IREE_HAL_COMMAND_BUFFER_MODE_ONE_SHOT,
+      iree_hal_command_buffer_allowed_categories(commands), queue_affinity,
+      /*binding_capacity=*/0, &command_buffer));
+  iree_status_t status = iree_hal_command_buffer_begin(command_buffer);
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_execute_commands(command_buffer, commands,
+                                                      binding_table);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_command_buffer_end(command_buffer);
+  }
+  if (iree_status_is_ok(status)) {
+    status = iree_hal_device_queue_execute(
+        device, queue_affinity, iree_hal_fence_semaphore_list(wait_fence),
+        iree_hal_fence_semaphore_list(signal_fence), 1, &command_buffer);
+  }
+  iree_hal_command_buffer_release(command_buffer);
+  return status;
+}
+
 IREE_VM_ABI_EXPORT(iree_hal_module_device_queue_flush,  //
                    iree_hal_module_state_t,             //
                    rI, v) {
@@ -1653,6 +1825,7 @@ IREE_API_EXPORT iree_status_t iree_hal_module_create(
       .destroy = iree_hal_module_destroy,
       .alloc_state = iree_hal_module_alloc_state,
       .free_state = iree_hal_module_free_state,
+      .fork_state = iree_hal_module_fork_state,
       .notify = iree_hal_module_notify,
   };
 
@@ -0,0 +1,166 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <cstring>
+
+#include "iree/base/api.h"
+#include "iree/hal/api.h"
+#include "iree/hal/drivers/local_sync/sync_device.h"
+#include "iree/modules/hal/module.h"
+#include "iree/modules/hal/types.h"
+#include "iree/testing/benchmark.h"
+#include "iree/vm/api.h"
+#include "iree/vm/shims.h"
+
+namespace {
+
+// Small 2D tensor shape typical of high-rate serving inputs/outputs.
+static const iree_hal_dim_t kShape[2] = {4, 16};
+
+// Creates a buffer large enough for the benchmark shape.
+static iree_hal_buffer_t* CreateBuffer(iree_hal_allocator_t* device_allocator) {
+  iree_hal_buffer_params_t params = {0};
+  params.type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL;
+  params.usage = IREE_HAL_BUFFER_USAGE_DEFAULT;
+  iree_hal_buffer_t* buffer = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_allocate_buffer(
+      device_allocator, params, kShape[0] * kShape[1] * sizeof(float),
+      &buffer));
+  return buffer;
+}
+
+// Baseline buffer view creation with a host allocation per buffer view.
+IREE_BENCHMARK_FN(BM_BufferViewCreate) {
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_create_heap(
+      IREE_SV("heap"), iree_allocator_system(), iree_allocator_system(),
+      &device_allocator));
+  iree_hal_buffer_t* buffer = CreateBuffer(device_allocator);
+
+  while (iree_benchmark_keep_running(benchmark_state, 1)) {
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    IREE_CHECK_OK(iree_hal_buffer_view_create(
+        buffer, IREE_ARRAYSIZE(kShape), kShape,
+        IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+        iree_allocator_system(), &buffer_view));
+    iree_optimization_barrier(buffer_view);
+    iree_hal_buffer_view_release(buffer_view);
+  }
+
+  iree_hal_buffer_release(buffer);
+  iree_hal_allocator_release(device_allocator);
+  return iree_ok_status();
+}
+IREE_BENCHMARK_REGISTER(BM_BufferViewCreate);
+
+// Buffer view creation recycling buffer views through a pool.
+IREE_BENCHMARK_FN(BM_BufferViewPoolAcquire) {
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_create_heap(
+      IREE_SV("heap"), iree_allocator_system(), iree_allocator_system(),
+      &device_allocator));
+  iree_hal_buffer_t* buffer = CreateBuffer(device_allocator);
+  iree_hal_buffer_view_pool_t* pool = NULL;
+  IREE_CHECK_OK(iree_hal_buffer_view_pool_create(
+      IREE_ARRAYSIZE(kShape), iree_allocator_system(), &pool));
+
+  while (iree_benchmark_keep_running(benchmark_state, 1)) {
+    iree_hal_buffer_view_t* buffer_view = NULL;
+    IREE_CHECK_OK(iree_hal_buffer_view_pool_acquire(
+        pool, buffer, IREE_ARRAYSIZE(kShape), kShape,
+        IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+        &buffer_view));
+    iree_optimization_barrier(buffer_view);
+    iree_hal_buffer_view_release(buffer_view);
+  }
+
+  iree_hal_buffer_view_pool_release(pool);
+  iree_hal_buffer_release(buffer);
+  iree_hal_allocator_release(device_allocator);
+  return iree_ok_status();
+}
+IREE_BENCHMARK_REGISTER(BM_BufferViewPoolAcquire);
+
+// Calls the hal.buffer_view.create import as compiled programs do for each
+// input and output of a call.
+IREE_BENCHMARK_FN(BM_HALModuleBufferViewCreate) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  iree_vm_instance_t* instance = NULL;
+  IREE_CHECK_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                        host_allocator, &instance));
+  IREE_CHECK_OK(iree_hal_module_register_all_types(instance));
+
+  iree_hal_allocator_t* device_allocator = NULL;
+  IREE_CHECK_OK(iree_hal_allocator_create_heap(
+      IREE_SV("heap"), host_allocator, host_allocator, &device_allocator));
+  iree_hal_sync_device_params_t device_params;
+  iree_hal_sync_device_params_initialize(&device_params);
+  iree_hal_device_t* device = NULL;
+  IREE_CHECK_OK(iree_hal_sync_device_create(
+      IREE_SV("local-sync"), &device_params, /*loader_count=*/0,
+      /*loaders=*/NULL, device_allocator, host_allocator, &device));
+
+  iree_vm_module_t* hal_module = NULL;
+  IREE_CHECK_OK(iree_hal_module_create(instance, /*device_count=*/1, &device,
+                                       IREE_HAL_MODULE_FLAG_NONE,
+                                       host_allocator, &hal_module));
+  iree_vm_context_t* context = NULL;
+  IREE_CHECK_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, 1, &hal_module, host_allocator,
+      &context));
+  iree_vm_function_t function;
+  IREE_CHECK_OK(iree_vm_context_resolve_function(
+      context, IREE_SV("hal.buffer_view.create"), &function));
+
+  iree_hal_buffer_t* buffer = CreateBuffer(device_allocator);
+
+  // Arguments are packed as the bytecode dispatcher would for the import.
+  iree_host_size_t args_size =
+      sizeof(iree_vm_abi_rIIiiCID_t) +
+      IREE_ARRAYSIZE(kShape) * sizeof(iree_vm_abi_I_t);
+  iree_vm_abi_rIIiiCID_t* args =
+      (iree_vm_abi_rIIiiCID_t*)iree_alloca(args_size);
+  memset(args, 0, args_size);
+  iree_vm_ref_t buffer_ref = iree_hal_buffer_retain_ref(buffer);
+  args->r0 = buffer_ref;
+  args->i1 = 0;
+  args->i2 = iree_hal_buffer_byte_length(buffer);
+  args->i3 = IREE_HAL_ELEMENT_TYPE_FLOAT_32;
+  args->i4 = IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR;
+  args->a5_count = IREE_ARRAYSIZE(kShape);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(kShape); ++i) {
+    args->a5[i].i0 = kShape[i];
+  }
+  iree_vm_ref_t result_ref = iree_vm_ref_null();
+
+  iree_vm_function_call_t call;
+  memset(&call, 0, sizeof(call));
+  call.function = function;
+  call.arguments = iree_make_byte_span(args, args_size);
+  call.results = iree_make_byte_span(&result_ref, sizeof(result_ref));
+
+  IREE_VM_INLINE_STACK_INITIALIZE(stack, IREE_VM_INVOCATION_FLAG_NONE,
+                                  iree_vm_context_state_resolver(context),
+                                  host_allocator);
+  while (iree_benchmark_keep_running(benchmark_state, 1)) {
+    IREE_CHECK_OK(function.module->begin_call(function.module->self, stack,
+                                              call));
+    iree_vm_ref_release(&result_ref);
+  }
+  iree_vm_stack_deinitialize(stack);
+
+  iree_vm_ref_release(&buffer_ref);
+  iree_hal_buffer_release(buffer);
+  iree_vm_context_release(context);
+  iree_vm_module_release(hal_module);
+  iree_hal_device_release(device);
+  iree_hal_allocator_release(device_allocator);
+  iree_vm_instance_release(instance);
+  return iree_ok_status();
+}
+IREE_BENCHMARK_REGISTER(BM_HALModuleBufferViewCreate);
+
+}  // namespace
@@ -0,0 +1,219 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/modules/io/outputs/module.h"
+
+#include "iree/modules/hal/types.h"
+
+#define IREE_IO_OUTPUTS_MODULE_VERSION_0_0 0x00000000u
+#define IREE_IO_OUTPUTS_MODULE_VERSION_LATEST IREE_IO_OUTPUTS_MODULE_VERSION_0_0
+
+//===----------------------------------------------------------------------===//
+// Module type definitions
+//===----------------------------------------------------------------------===//
+
+typedef struct iree_io_outputs_module_t {
+  iree_allocator_t host_allocator;
+  iree_host_size_t channel_count;
+  iree_io_output_channel_t* channels[];
+} iree_io_outputs_module_t;
+
+#define IREE_IO_OUTPUTS_MODULE_CAST(module)        \
+  (iree_io_outputs_module_t*)((uint8_t*)(module) + \
+                              iree_vm_native_module_size())
+
+typedef struct iree_io_outputs_module_state_t {
+  iree_allocator_t host_allocator;
+} iree_io_outputs_module_state_t;
+
+static void IREE_API_PTR iree_io_outputs_module_destroy(void* base_module) {
+  iree_io_outputs_module_t* module = IREE_IO_OUTPUTS_MODULE_CAST(base_module);
+  for (iree_host_size_t i = 0; i < module->channel_count; ++i) {
+    iree_io_output_channel_release(module->channels[i]);
+  }
+  module->channel_count = 0;
+}
+
+static iree_status_t IREE_API_PTR iree_io_outputs_module_alloc_state(
+    void* self, iree_allocator_t host_allocator,
+    iree_vm_module_state_t** out_module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_outputs_module_state_t* state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0,
+      iree_allocator_malloc(host_allocator, sizeof(*state), (void**)&state));
+  memset(state, 0, sizeof(*state));
+  state->host_allocator = host_allocator;
+
+  *out_module_state = (iree_vm_module_state_t*)state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void IREE_API_PTR iree_io_outputs_module_free_state(
+    void* self, iree_vm_module_state_t* module_state) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_outputs_module_state_t* state =
+      (iree_io_outputs_module_state_t*)module_state;
+  iree_allocator_free(state->host_allocator, state);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+// Returns the channel with the given |ordinal| in the module channel list.
+static iree_status_t iree_io_outputs_module_resolve_channel(
+    iree_io_outputs_module_t* module, int32_t ordinal,
+    iree_io_output_channel_t** out_channel) {
+  if (ordinal < 0 || (iree_host_size_t)ordinal >= module->channel_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "output channel ordinal %d out of range; %" PRIhsz
+                            " channels registered",
+                            ordinal, module->channel_count);
+  }
+  *out_channel = module->channels[ordinal];
+  return iree_ok_status();
+}
+
+//===----------------------------------------------------------------------===//
+// Exported functions
+//===----------------------------------------------------------------------===//
+
+IREE_VM_ABI_EXPORT(iree_io_outputs_module_close,  //
+                   iree_io_outputs_module_state_t,  //
+                   i, v) {
+  iree_io_output_channel_t* channel = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_outputs_module_resolve_channel(
+      IREE_IO_OUTPUTS_MODULE_CAST(module), args->i0, &channel));
+  iree_io_output_channel_close(channel);
+  return iree_ok_status();
+}
+
+IREE_VM_ABI_EXPORT(iree_io_outputs_module_publish,  //
+                   iree_io_outputs_module_state_t,    //
+                   ri, v) {
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_hal_buffer_view_check_deref(args->r0, &buffer_view));
+  iree_io_output_channel_t* channel = NULL;
+  IREE_RETURN_IF_ERROR(iree_io_outputs_module_resolve_channel(
+      IREE_IO_OUTPUTS_MODULE_CAST(module), args->i1, &channel));
+
+  // The program is responsible for ensuring the contents are available (by
+  // waiting on the fence of the work producing them) and that the buffer is
+  // host-visible, usually by exporting the tensor to a staging buffer.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      iree_hal_buffer_view_buffer(buffer_view), IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ, 0,
+      iree_hal_buffer_view_byte_length(buffer_view), &mapping));
+  iree_status_t status = iree_io_output_channel_publish(
+      channel,
+      iree_make_const_byte_span(mapping.contents.data,
+                                mapping.contents.data_length),
+      iree_infinite_timeout());
+  return iree_status_join(status, iree_hal_buffer_unmap_range(&mapping));
+}
+
+//===----------------------------------------------------------------------===//
+// VM module interface implementation
+//===----------------------------------------------------------------------===//
+
+// NOTE: this must match the ordering of the iree_io_outputs_module_exports_
+// table.
+static const iree_vm_native_function_ptr_t iree_io_outputs_module_funcs_[] = {
+#define EXPORT_FN(name, target_fn, arg_types, ret_types)       \
+  {                                                            \
+      .shim = (iree_vm_native_function_shim_t)                 \
+          iree_vm_shim_##arg_types##_##ret_types,              \
+      .target = (iree_vm_native_function_target_t)(target_fn), \
+  },
+#include "iree/modules/io/outputs/exports.inl"  // IWYU pragma: keep
+#undef EXPORT_FN
+};
+
+// NOTE: 0 length, but can't express that in C.
+static const iree_vm_native_import_descriptor_t
+    iree_io_outputs_module_imports_[1];
+
+static const iree_vm_native_export_descriptor_t
+    iree_io_outputs_module_exports_[] = {
+#define EXPORT_FN(name, target_fn, arg_types, ret_types)           \
+  {                                                                \
+      .local_name = iree_string_view_literal(name),                \
+      .calling_convention =                                        \
+          iree_string_view_literal("0" #arg_types "_" #ret_types), \
+      .attr_count = 0,                                             \
+      .attrs = NULL,                                               \
+  },
+#include "iree/modules/io/outputs/exports.inl"  // IWYU pragma: keep
+#undef EXPORT_FN
+};
+static_assert(IREE_ARRAYSIZE(iree_io_outputs_module_funcs_) ==
+                  IREE_ARRAYSIZE(iree_io_outputs_module_exports_),
+              "function pointer table must be 1:1 with exports");
+
+static const iree_vm_native_module_descriptor_t
+    iree_io_outputs_module_descriptor_ = {
+        .name = iree_string_view_literal("io_outputs"),
+        .version = IREE_IO_OUTPUTS_MODULE_VERSION_LATEST,
+        .attr_count = 0,
+        .attrs = NULL,
+        .dependency_count = 0,
+        .dependencies = NULL,
+        .import_count = 0,  // workaround for 0-length C struct
+        .imports = iree_io_outputs_module_imports_,
+        .export_count = IREE_ARRAYSIZE(iree_io_outputs_module_exports_),
+        .exports = iree_io_outputs_module_exports_,
+        .function_count = IREE_ARRAYSIZE(iree_io_outputs_module_funcs_),
+        .functions = iree_io_outputs_module_funcs_,
+};
+
+IREE_API_EXPORT iree_status_t iree_io_outputs_module_create(
+    iree_vm_instance_t* instance, iree_host_size_t channel_count,
+    iree_io_output_channel_t* const* channels, iree_allocator_t host_allocator,
+    iree_vm_module_t** out_module) {
+  IREE_ASSERT_ARGUMENT(instance);
+  IREE_ASSERT_ARGUMENT(!channel_count || channels);
+  IREE_ASSERT_ARGUMENT(out_module);
+  *out_module = NULL;
+
+  // Setup the interface with the functions we implement ourselves. Any function
+  // we omit will be handled by the base native module.
+  static const iree_vm_module_t interface = {
+      .destroy = iree_io_outputs_module_destroy,
+      .alloc_state = iree_io_outputs_module_alloc_state,
+      .free_state = iree_io_outputs_module_free_state,
+  };
+
+  // Allocate shared module state.
+  iree_host_size_t total_size =
+      iree_vm_native_module_size() + sizeof(iree_io_outputs_module_t) +
+      channel_count * sizeof(iree_io_output_channel_t*);
+  iree_vm_module_t* base_module = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, total_size, (void**)&base_module));
+  memset(base_module, 0, total_size);
+  iree_status_t status = iree_vm_native_module_initialize(
+      &interface, &iree_io_outputs_module_descriptor_, instance,
+      host_allocator, base_module);
+  if (!iree_status_is_ok(status)) {
+    iree_allocator_free(host_allocator, base_module);
+    return status;
+  }
+
+  iree_io_outputs_module_t* module = IREE_IO_OUTPUTS_MODULE_CAST(base_module);
+  module->host_allocator = host_allocator;
+  module->channel_count = channel_count;
+  for (iree_host_size_t i = 0; i < channel_count; ++i) {
+    module->channels[i] = channels[i];
+    iree_io_output_channel_retain(channels[i]);
+  }
+
+  *out_module = base_module;
+  return iree_ok_status();
+}
@@ -0,0 +1,39 @@
+// Copyright 2026 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_MODULES_IO_OUTPUTS_MODULE_H_
+#define IREE_MODULES_IO_OUTPUTS_MODULE_H_
+
+#include "iree/base/api.h"
+#include "iree/io/output_channel.h"
+#include "iree/vm/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+// Creates a module that lets programs stream partial results to the host
+// through a set of output |channels| while an invocation is still running.
+// Programs refer to channels by their ordinal in |channels|:
+//
+//   // Publishes the contents of a host-visible buffer view as the next item.
+//   func.func private @io_outputs.publish(!hal.buffer_view, i32)
+//   // Closes the channel once no more items will be published.
+//   func.func private @io_outputs.close(i32)
+//
+// Publishing blocks when the host has not read enough of the previously
+// published items to free a slot in the channel. The channels are retained for
+// the lifetime of the module.
+IREE_API_EXPORT iree_status_t iree_io_outputs_module_create(
+    iree_vm_instance_t* instance, iree_host_size_t channel_count,
+    iree_io_output_channel_t* const* channels, iree_allocator_t host_allocator,
+    iree_vm_module_t** IREE_RESTRICT out_module);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_MODULES_IO_OUTPUTS_MODULE_H_
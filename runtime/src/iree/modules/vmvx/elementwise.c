@@ -22,7 +22,8 @@
 // Opcodes for generic functions operating on 32-bit operands and result.
 // Since the outer dispatcher only differentiates based on width, all other
 // type specificity is carried by the opcode.
-// Binary opcodes are named "X32B" and unary opcodes "X32U".
+// Binary opcodes are named "X32B", unary opcodes "X32U" and reduction opcodes
+// "X32R".
 // The initial list was sorted, and it is encouraged to sort extensions, but
 // each opcode must be numerically stable, so the list is not expected to
 // be sorted over time.
@@ -55,6 +56,13 @@ typedef enum {
   IREE_UK_X32U_RSQRTF,
 } iree_uk_x32u_opcode_t;
 
+typedef enum {
+  IREE_UK_X32R_ADDF,
+  IREE_UK_X32R_ADDI,
+  IREE_UK_X32R_MAXF,
+  IREE_UK_X32R_MINF,
+} iree_uk_x32r_opcode_t;
+
 // Macros to access various typed, dereferenced pointers.
 #define ASF32(ptr) *((float*)ptr)
 #define ASUI32(ptr) *((iree_uk_uint32_t*)ptr)
@@ -195,6 +203,35 @@ static void iree_uk_generic_x32u_op(iree_uk_x32u_opcode_t opcode,
   }
 }
 
+// Accumulates a single element of an x32r opcode into |out|. On error, should
+// set |*result_code| to a non-zero value (but should not touch it otherwise).
+// Float min/max propagate NaNs to match arith.minimumf/maximumf.
+static void iree_uk_generic_x32r_op(iree_uk_x32r_opcode_t opcode,
+                                    int* result_code,
+                                    const iree_uk_uint32_t* in,
+                                    iree_uk_uint32_t* out) {
+  switch (opcode) {
+    case IREE_UK_X32R_ADDF:
+      ASF32(out) = ASF32(out) + ASF32(in);
+      return;
+    case IREE_UK_X32R_ADDI:
+      ASUI32(out) = ASUI32(out) + ASUI32(in);
+      return;
+    case IREE_UK_X32R_MAXF:
+      if (!(ASF32(out) > ASF32(in) || isnan(ASF32(out)))) {
+        ASF32(out) = ASF32(in);
+      }
+      return;
+    case IREE_UK_X32R_MINF:
+      if (!(ASF32(out) < ASF32(in) || isnan(ASF32(out)))) {
+        ASF32(out) = ASF32(in);
+      }
+      return;
+    default:
+      *result_code = 1;
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // Opcode dispatch entry points.
 //===----------------------------------------------------------------------===//
@@ -249,6 +286,28 @@ IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32u_2d(
   return result_code;
 }
 
+// Generic 32bit reduction kernels.
+IREE_UK_ATTRIBUTE_NOINLINE static int iree_uk_generic_x32r_2d(
+    iree_uk_x32r_opcode_t opcode,
+    // IN.
+    const iree_uk_uint32_t* in, iree_uk_index_t in_offset,
+    iree_uk_index_t in_stride0, iree_uk_index_t in_stride1,
+    // OUT.
+    iree_uk_uint32_t* IREE_UK_RESTRICT out, iree_uk_index_t out_offset,
+    iree_uk_index_t out_stride0, iree_uk_index_t out_stride1,
+    // Sizes.
+    iree_uk_index_t size0, iree_uk_index_t size1) {
+  int result_code = 0;
+  for (iree_uk_index_t i = 0; i < size0; ++i) {
+    for (iree_uk_index_t j = 0; j < size1; ++j) {
+      iree_uk_generic_x32r_op(opcode, &result_code,
+                              &in[i * in_stride0 + j * in_stride1],
+                              &out[i * out_stride0 + j * out_stride1]);
+    }
+  }
+  return result_code;
+}
+
 DISPATCH_UKERNEL_BINARY_2D(addf, IREE_UK_X32B_ADDF, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(addi, IREE_UK_X32B_ADDI, iree_uk_uint32_t, x32b);
 DISPATCH_UKERNEL_BINARY_2D(andi, IREE_UK_X32B_ANDI, iree_uk_uint32_t, x32b);
@@ -274,3 +333,8 @@ DISPATCH_UKERNEL_UNARY_2D(floorf, IREE_UK_X32U_FLOORF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(logf, IREE_UK_X32U_LOGF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(negf, IREE_UK_X32U_NEGF, iree_uk_uint32_t, x32u);
 DISPATCH_UKERNEL_UNARY_2D(rsqrtf, IREE_UK_X32U_RSQRTF, iree_uk_uint32_t, x32u);
+
+DISPATCH_UKERNEL_UNARY_2D(addf, IREE_UK_X32R_ADDF, iree_uk_uint32_t, x32r);
+DISPATCH_UKERNEL_UNARY_2D(addi, IREE_UK_X32R_ADDI, iree_uk_uint32_t, x32r);
+DISPATCH_UKERNEL_UNARY_2D(maxf, IREE_UK_X32R_MAXF, iree_uk_uint32_t, x32r);
+DISPATCH_UKERNEL_UNARY_2D(minf, IREE_UK_X32R_MINF, iree_uk_uint32_t, x32r);
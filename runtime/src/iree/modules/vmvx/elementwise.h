@@ -93,6 +93,21 @@ DECLARE_UKERNEL_UNARY_2D(logf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(negf, iree_uk_uint32_t, x32u);
 DECLARE_UKERNEL_UNARY_2D(rsqrtf, iree_uk_uint32_t, x32u);
 
+//===----------------------------------------------------------------------===//
+// Public API - Reduction kernels.
+//===----------------------------------------------------------------------===//
+
+// Reduction ukernels have the same signature as unary ones but accumulate
+// into the existing contents of out as if:
+//   out[i, j] = op(out[i, j], in[i, j])
+// Dimensions with a zero out stride are reduced.
+typedef iree_uk_x32u_2d_func_t iree_uk_x32r_2d_func_t;
+
+DECLARE_UKERNEL_UNARY_2D(addf, iree_uk_uint32_t, x32r);
+DECLARE_UKERNEL_UNARY_2D(addi, iree_uk_uint32_t, x32r);
+DECLARE_UKERNEL_UNARY_2D(maxf, iree_uk_uint32_t, x32r);
+DECLARE_UKERNEL_UNARY_2D(minf, iree_uk_uint32_t, x32r);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
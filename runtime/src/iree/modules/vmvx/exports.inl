@@ -47,6 +47,10 @@ EXPORT_FN("neg.2d.f32", iree_uk_x32u_negf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
 EXPORT_FN("or.2d.i32", iree_uk_x32b_ori_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
 EXPORT_FN("pack", iree_vmvx_pack, pack, rIIrIIIIIIIIIi, v)
 EXPORT_FN("query_tile_sizes.2d", iree_vmvx_query_tile_sizes_2d, query_tile_sizes_2d, IIi, II)
+EXPORT_FN("reduce.add.2d.f32", iree_uk_x32r_addf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
+EXPORT_FN("reduce.add.2d.i32", iree_uk_x32r_addi_2d, ukernel_x32u_2d, rIIIrIIIII, v)
+EXPORT_FN("reduce.max.2d.f32", iree_uk_x32r_maxf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
+EXPORT_FN("reduce.min.2d.f32", iree_uk_x32r_minf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
 EXPORT_FN("rsqrt.2d.f32", iree_uk_x32u_rsqrtf_2d, ukernel_x32u_2d, rIIIrIIIII, v)
 EXPORT_FN("shl.2d.i32", iree_uk_x32b_shli_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
 EXPORT_FN("shrs.2d.i32", iree_uk_x32b_shrsi_2d, ukernel_x32b_2d, rIIIrIIIrIIIII, v)
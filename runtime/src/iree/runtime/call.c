@@ -98,6 +98,20 @@ IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
                                    call->outputs);
 }
 
+IREE_API_EXPORT iree_status_t iree_runtime_call_invoke_async(
+    iree_runtime_call_t* call, iree_runtime_call_flags_t flags,
+    iree_loop_t loop, iree_vm_async_invoke_state_t* state,
+    iree_vm_async_invoke_callback_fn_t callback, void* user_data) {
+  IREE_ASSERT_ARGUMENT(call);
+  IREE_ASSERT_ARGUMENT(state);
+  IREE_ASSERT_ARGUMENT(callback);
+  return iree_vm_async_invoke(
+      loop, state, iree_runtime_session_context(call->session), call->function,
+      IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/NULL, call->inputs,
+      call->outputs, iree_runtime_session_host_allocator(call->session),
+      callback, user_data);
+}
+
 //===----------------------------------------------------------------------===//
 // Helpers for defining call I/O
 //===----------------------------------------------------------------------===//
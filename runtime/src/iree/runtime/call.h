@@ -92,6 +92,23 @@ IREE_API_EXPORT iree_vm_list_t* iree_runtime_call_outputs(
 IREE_API_EXPORT iree_status_t iree_runtime_call_invoke(
     iree_runtime_call_t* call, iree_runtime_call_flags_t flags);
 
+// Asynchronously invokes the call on |loop| and returns immediately.
+// The invocation suspends whenever the function waits (such as on a HAL fence)
+// and resumes from the loop when the wait resolves such that a single thread
+// driving the loop can multiplex many in-flight invocations.
+//
+// |state| is opaque storage that must remain live until |callback| is issued.
+// The call inputs must not be modified until then. On success the callback
+// receives the call outputs retained and must release them. See
+// iree_vm_async_invoke for details.
+//
+// Only one invocation may be in-flight per session unless the session was
+// created with the IREE_VM_CONTEXT_FLAG_CONCURRENT context flag.
+IREE_API_EXPORT iree_status_t iree_runtime_call_invoke_async(
+    iree_runtime_call_t* call, iree_runtime_call_flags_t flags,
+    iree_loop_t loop, iree_vm_async_invoke_state_t* state,
+    iree_vm_async_invoke_callback_fn_t callback, void* user_data);
+
 //===----------------------------------------------------------------------===//
 // Helpers for defining call I/O
 //===----------------------------------------------------------------------===//
@@ -120,5 +120,7 @@ IREE_CPU_FEATURE_BIT(X86_64, 0, 52, AMXBF16, "amx-bf16")
 //===----------------------------------------------------------------------===//
 
 // General features and high-level switches.
-// RISCV vector extension.
-IREE_CPU_FEATURE_BIT(RISCV_64, 0, 0, RVV, "rvv")
+// RISCV vector extension (RVV 1.0).
+IREE_CPU_FEATURE_BIT(RISCV_64, 0, 0, RVV, "v")
+// RVV half-precision floating-point arithmetic.
+IREE_CPU_FEATURE_BIT(RISCV_64, 0, 1, ZVFH, "zvfh")
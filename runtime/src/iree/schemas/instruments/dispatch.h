@@ -64,6 +64,13 @@ static_assert(sizeof(iree_idbts_chunk_header_t) % 16 == 0,
 // its end.
 #define IREE_INSTRUMENT_DISPATCH_PADDING 4096
 
+// Byte offset from the end of the ringbuffer storage (including padding) of a
+// uint32_t sampling period used when dispatches are compiled with sampled
+// instrumentation. Only workgroups whose linearized workgroup ID is a multiple
+// of the period emit events and a period of 0 pauses recording. The value may
+// be changed by the host at any time to adjust the rate of a running program.
+#define IREE_INSTRUMENT_DISPATCH_SAMPLING_PERIOD_OFFSET 16
+
 typedef enum iree_instrument_dispatch_type_e {
   IREE_INSTRUMENT_DISPATCH_TYPE_WORKGROUP = 0b00000000,
   IREE_INSTRUMENT_DISPATCH_TYPE_PRINT = 0b00000001,
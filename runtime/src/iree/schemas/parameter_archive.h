@@ -160,6 +160,9 @@ enum iree_io_parameter_archive_entry_type_e {
   // Entry represents data stored in an external file.
   // See iree_io_parameter_archive_external_entry_t.
   IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_EXTERNAL = 3,
+  // Entry represents data embedded in the archive as compressed chunks.
+  // See iree_io_parameter_archive_compressed_entry_t.
+  IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED = 4,
 };
 // Defines the type of an entry in the archive entry table.
 typedef uint32_t iree_io_parameter_archive_entry_type_t;
@@ -236,6 +239,41 @@ typedef struct iree_io_parameter_archive_external_entry_t {
   iree_io_parameter_archive_range_t range;
 } iree_io_parameter_archive_external_entry_t;
 
+enum iree_io_parameter_archive_compression_type_e {
+  // Chunks are stored uncompressed.
+  IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_TYPE_NONE = 0,
+  // Chunks are LZ4 blocks without frame headers.
+  IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_TYPE_LZ4 = 1,
+  // Chunks are zstd frames.
+  IREE_IO_PARAMETER_ARCHIVE_COMPRESSION_TYPE_ZSTD = 2,
+};
+// Defines the compression scheme applied to chunks of a compressed entry.
+typedef uint32_t iree_io_parameter_archive_compression_type_t;
+
+// An entry referencing chunked compressed data in the archive data storage
+// segment. The data is split into chunks of |chunk_length| uncompressed bytes
+// (the last chunk may be shorter) that are each compressed independently so
+// that readers can decompress only the chunks covering the range they need and
+// decompress chunks in parallel.
+//
+// The storage begins with a chunk table of (chunk_count + 1) little-endian
+// uint64_t offsets relative to the start of the storage with chunk i stored in
+// [offsets[i], offsets[i + 1]). A chunk whose stored length equals its
+// uncompressed length is stored raw.
+typedef struct iree_io_parameter_archive_compressed_entry_t {
+  // Entry header with type IREE_IO_PARAMETER_ARCHIVE_ENTRY_TYPE_COMPRESSED.
+  iree_io_parameter_archive_entry_header_t header;
+  // Total uncompressed length of the parameter in bytes.
+  iree_io_physical_size_t length;
+  // Uncompressed length of each chunk in bytes.
+  iree_io_physical_size_t chunk_length;
+  // Compression scheme applied to each chunk.
+  iree_io_parameter_archive_compression_type_t compression_type;
+  // Relative offset and total length of the chunk table and chunks in the data
+  // storage segment.
+  iree_io_parameter_archive_storage_ref_t storage;
+} iree_io_parameter_archive_compressed_entry_t;
+
 IREE_IO_PACKED_END
 
 #endif  // IREE_SCHEMAS_PARAMETER_ARCHIVE_H_
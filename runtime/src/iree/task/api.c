@@ -11,6 +11,7 @@
 
 #include "iree/base/internal/flags.h"
 #include "iree/task/topology.h"
+#include "iree/task/tuning.h"
 
 //===----------------------------------------------------------------------===//
 // Executor configuration
@@ -24,6 +25,22 @@ IREE_FLAG(
     "when latency is the #1 priority (vs. thermals, system-wide scheduling,\n"
     "etc).");
 
+IREE_FLAG(
+    int64_t, task_worker_spin_ns, 0,
+    "Maximum duration in nanoseconds each worker should spin waiting for\n"
+    "additional work before parking. Overrides --task_worker_spin_us= when\n"
+    "non-zero. Spinning trades idle CPU time (and power) for lower wake\n"
+    "latency on back-to-back submissions; see --task_worker_spin_us= for\n"
+    "caveats.");
+
+IREE_FLAG(
+    int32_t, task_worker_remote_theft_threshold,
+    IREE_TASK_EXECUTOR_DEFAULT_REMOTE_THEFT_ATTEMPT_THRESHOLD,
+    "Number of consecutive failed attempts each worker makes at stealing\n"
+    "work from workers on its own NUMA node before it will steal from\n"
+    "workers on other nodes. Only used when a topology spans multiple nodes.\n"
+    "0 allows remote thefts as soon as a local theft fails.");
+
 IREE_FLAG(
     int32_t, task_worker_stack_size, 128 * 1024,
     "Minimum size in bytes of each worker thread stack.\n"
@@ -37,23 +54,46 @@ IREE_FLAG(
 IREE_FLAG(
     int32_t, task_worker_local_memory, 0,
     "Overrides the bytes of per-worker local memory allocated for use by\n"
-    "dispatched tiles. Tiles may use less than this but will fail to dispatch\n"
-    "if they require more. Conceptually it is like a stack reservation and\n"
-    "should be treated the same way: the source programs must be built to\n"
-    "only use a specific maximum amount of local memory and the runtime must\n"
-    "be configured to make at least that amount of local memory available.\n"
+    "dispatched tiles. Tiles requiring more than this cause the worker to\n"
+    "grow its local memory up to --task_worker_local_memory_limit.\n"
+    "Conceptually it is like a stack reservation and should be treated the\n"
+    "same way: the source programs must be built to only use a specific\n"
+    "maximum amount of local memory and the runtime must be configured to\n"
+    "make at least that amount of local memory available.\n"
     "By default the CPU L2 cache size is used if such queries are supported.");
 
+IREE_FLAG(
+    int32_t, task_worker_local_memory_limit,
+    IREE_TASK_EXECUTOR_DEFAULT_WORKER_LOCAL_MEMORY_LIMIT,
+    "Maximum bytes of local memory each worker may grow to on demand for\n"
+    "dispatched tiles that require more than --task_worker_local_memory.\n"
+    "Grown memory is cached across dispatches until the device is trimmed.\n"
+    "Tiles requiring more than this will fail to dispatch. 0 disables growth.");
+
+IREE_FLAG(
+    bool, task_high_priority_performance_cores_only, false,
+    "Restricts high priority (latency-critical) work to workers on the\n"
+    "highest capacity cores on heterogeneous systems (big.LITTLE, P+E cores).\n"
+    "Has no effect on systems with homogeneous cores.");
+
 iree_status_t iree_task_executor_options_initialize_from_flags(
     iree_task_executor_options_t* out_options) {
   IREE_ASSERT_ARGUMENT(out_options);
   iree_task_executor_options_initialize(out_options);
   out_options->worker_spin_ns =
-      (iree_duration_t)FLAG_task_worker_spin_us * 1000;
+      FLAG_task_worker_spin_ns > 0
+          ? (iree_duration_t)FLAG_task_worker_spin_ns
+          : (iree_duration_t)FLAG_task_worker_spin_us * 1000;
+  out_options->worker_remote_theft_threshold =
+      (uint32_t)iree_max(0, FLAG_task_worker_remote_theft_threshold);
   out_options->worker_stack_size =
       (iree_host_size_t)FLAG_task_worker_stack_size;
   out_options->worker_local_memory_size =
       (iree_host_size_t)FLAG_task_worker_local_memory;
+  out_options->worker_local_memory_limit =
+      (iree_host_size_t)iree_max(0, FLAG_task_worker_local_memory_limit);
+  out_options->high_priority_performance_workers_only =
+      FLAG_task_high_priority_performance_cores_only;
   return iree_ok_status();
 }
 
@@ -103,6 +143,28 @@ IREE_FLAG(
     "detected and used when --task_topology_group_count=0 and is ignored\n"
     "otherwise.");
 
+IREE_FLAG(
+    bool, task_topology_link_executors, false,
+    "Links the executors created for each topology (usually one per NUMA\n"
+    "node) such that idle workers in one executor may steal work from the\n"
+    "others. This allows a single queue to scale beyond the workers of a\n"
+    "single executor at the cost of cross-node memory traffic.");
+
+IREE_FLAG(
+    string, task_topology_partition, "none",
+    "Splits the topology of each NUMA node into multiple executors:\n"
+    " 'none':\n"
+    "   Creates one executor per NUMA node.\n"
+    " 'cache':\n"
+    "   Creates one executor per set of cores that constructively share\n"
+    "   caches (CCX, cluster, etc). Executors are not linked unless\n"
+    "   --task_topology_link_executors= is set so that requests submitted to\n"
+    "   different queues run on disjoint cache domains.\n"
+    "Each executor services one local-task device queue and queue affinity\n"
+    "bit N selects executor N modulo the executor count. Ignored when\n"
+    "--task_topology_cpu_ids= is specified as each set of CPU IDs already\n"
+    "defines its own executor.");
+
 IREE_FLAG(string, task_topology_performance_level, "any",
           "Selects only cores that match the specified performance level from\n"
           "[`any`, `low` (or `efficiency`), `high` (or `performance`)].");
@@ -207,6 +269,75 @@ iree_status_t iree_task_topology_initialize_from_flags(
   }
 }
 
+// Splits |topology| into the partitions selected by --task_topology_partition=
+// and stores the group mask of each in |out_partition_masks|, which must have
+// capacity for IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT partitions.
+static iree_status_t iree_task_topology_partition_from_flags(
+    const iree_task_topology_t* topology,
+    iree_task_topology_group_mask_t* out_partition_masks,
+    iree_host_size_t* out_partition_count) {
+  *out_partition_count = 0;
+  if (strcmp(FLAG_task_topology_partition, "none") == 0) {
+    out_partition_masks[0] = IREE_TASK_TOPOLOGY_GROUP_MASK_ALL;
+    *out_partition_count = 1;
+    return iree_ok_status();
+  } else if (strcmp(FLAG_task_topology_partition, "cache") == 0) {
+    *out_partition_count = iree_task_topology_partition_by_constructive_sharing(
+        topology, out_partition_masks);
+    return iree_ok_status();
+  }
+  return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                          "--task_topology_partition=%s is not one of "
+                          "[none, cache]",
+                          FLAG_task_topology_partition);
+}
+
+// Initializes |out_topology| with the partition of |topology| selected by
+// |partition_mask| and returns it, or returns |topology| itself if the
+// partition covers all groups.
+static const iree_task_topology_t* iree_task_topology_select_partition(
+    const iree_task_topology_t* topology,
+    iree_task_topology_group_mask_t partition_mask,
+    iree_task_topology_t* out_topology) {
+  if (partition_mask == IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) return topology;
+  iree_task_topology_initialize_from_group_mask(topology, partition_mask,
+                                                out_topology);
+  return out_topology;
+}
+
+// Returns the total number of topologies the NUMA nodes in |node_mask| are
+// split into by --task_topology_partition=.
+static iree_status_t iree_task_topologies_count_from_flags(
+    uint64_t node_mask, iree_host_size_t* out_topology_count) {
+  const iree_host_size_t node_count = iree_math_count_ones_u64(node_mask);
+  if (strcmp(FLAG_task_topology_partition, "none") == 0) {
+    *out_topology_count = node_count;
+    return iree_ok_status();
+  }
+  *out_topology_count = 0;
+  uint64_t node_mask_bits = node_mask;
+  iree_task_topology_node_id_t node_base_id = 0;
+  for (iree_host_size_t i = 0; i < node_count; ++i) {
+    int node_offset =
+        iree_task_affinity_set_count_trailing_zeros(node_mask_bits);
+    iree_task_topology_node_id_t node_id = node_base_id + node_offset;
+    node_base_id += node_offset + 1;
+    node_mask_bits = iree_shr(node_mask_bits, node_offset + 1);
+    iree_task_topology_t topology;
+    IREE_RETURN_IF_ERROR(
+        iree_task_topology_initialize_from_flags(node_id, &topology));
+    iree_task_topology_group_mask_t
+        partition_masks[IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT];
+    iree_host_size_t partition_count = 0;
+    iree_status_t status = iree_task_topology_partition_from_flags(
+        &topology, partition_masks, &partition_count);
+    iree_task_topology_deinitialize(&topology);
+    IREE_RETURN_IF_ERROR(status);
+    *out_topology_count += partition_count;
+  }
+  return iree_ok_status();
+}
+
 //===----------------------------------------------------------------------===//
 // Topology diagnostics
 //===----------------------------------------------------------------------===//
@@ -233,6 +364,7 @@ static void iree_task_flags_dump_task_topology(
     const iree_task_topology_group_t* group = &topology->groups[j];
     fprintf(stdout, "# group[%d]: '%s'\n", group->group_index, group->name);
     fprintf(stdout, "#      processor: %u\n", group->processor_index);
+    fprintf(stdout, "#           node: %u\n", group->node_id);
     fprintf(stdout, "#       affinity: ");
     if (group->ideal_thread_affinity.specified) {
       fprintf(
@@ -285,6 +417,7 @@ static iree_status_t iree_task_flags_dump_task_topologies(
     iree_host_size_t topology_count = iree_math_count_ones_u64(node_mask);
     uint64_t node_mask_bits = node_mask;
     iree_task_topology_node_id_t node_base_id = 0;
+    iree_host_size_t topology_index = 0;
     for (iree_host_size_t i = 0; i < topology_count; ++i) {
       int node_offset =
           iree_task_affinity_set_count_trailing_zeros(node_mask_bits);
@@ -294,7 +427,18 @@ static iree_status_t iree_task_flags_dump_task_topologies(
       iree_task_topology_t topology;
       IREE_RETURN_IF_ERROR(
           iree_task_topology_initialize_from_flags(node_id, &topology));
-      iree_task_flags_dump_task_topology(i, &topology);
+      iree_task_topology_group_mask_t
+          partition_masks[IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT];
+      iree_host_size_t partition_count = 0;
+      IREE_RETURN_IF_ERROR(iree_task_topology_partition_from_flags(
+          &topology, partition_masks, &partition_count));
+      for (iree_host_size_t j = 0; j < partition_count; ++j) {
+        iree_task_topology_t partition_topology;
+        iree_task_flags_dump_task_topology(
+            topology_index++,
+            iree_task_topology_select_partition(&topology, partition_masks[j],
+                                                &partition_topology));
+      }
       iree_task_topology_deinitialize(&topology);
     }
   } else {
@@ -345,13 +489,14 @@ iree_status_t iree_task_executors_create_from_flags(
   if (cpu_ids_list.count == 0) {
     IREE_RETURN_IF_ERROR(
         iree_task_topologies_select_nodes_from_flags(&node_mask));
-    topology_count = iree_math_count_ones_u64(node_mask);
+    IREE_RETURN_IF_ERROR(
+        iree_task_topologies_count_from_flags(node_mask, &topology_count));
   } else {
     topology_count = cpu_ids_list.count;
   }
 
-  // Since this utility function creates one executor per topology returned by
-  // the query we can check the executor capacity immediately.
+  // Since this utility function creates one executor per topology (or
+  // partition of a topology) we can check the executor capacity immediately.
   if (topology_count > executor_capacity || !executors) {
     // Need more capacity.
     *out_executor_count = topology_count;
@@ -369,7 +514,8 @@ iree_status_t iree_task_executors_create_from_flags(
   // NUMA-aware scheduling. We could lighten this restriction in the future if
   // there are use cases for arbitrarily-scheduled worker groups that have just
   // their allocations pinned to NUMA nodes.
-  if (FLAG_task_topology_group_count != 0 && topology_count > 1) {
+  if (FLAG_task_topology_group_count != 0 &&
+      (cpu_ids_list.count > 1 || iree_math_count_ones_u64(node_mask) > 1)) {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
         "multiple nodes specified with --task_topology_group_count=; you "
@@ -382,9 +528,11 @@ iree_status_t iree_task_executors_create_from_flags(
   if (cpu_ids_list.count == 0) {
     // TODO(benvanik): macros to make this iteration easier (ala cpu_set
     // iterators).
+    const iree_host_size_t node_count = iree_math_count_ones_u64(node_mask);
     uint64_t node_mask_bits = node_mask;
     iree_task_topology_node_id_t node_base_id = 0;
-    for (iree_host_size_t i = 0; i < topology_count; ++i) {
+    iree_host_size_t executor_index = 0;
+    for (iree_host_size_t i = 0; i < node_count; ++i) {
       int node_offset =
           iree_task_affinity_set_count_trailing_zeros(node_mask_bits);
       iree_task_topology_node_id_t node_id = node_base_id + node_offset;
@@ -396,19 +544,43 @@ iree_status_t iree_task_executors_create_from_flags(
       status = iree_task_topology_initialize_from_flags(node_id, &topology);
       if (!iree_status_is_ok(status)) break;
 
+      // Split the node into one executor per partition. Without partitioning
+      // this is a single partition covering the entire node.
+      iree_task_topology_group_mask_t
+          partition_masks[IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT];
+      iree_host_size_t partition_count = 0;
+      status = iree_task_topology_partition_from_flags(
+          &topology, partition_masks, &partition_count);
+      if (iree_status_is_ok(status) &&
+          executor_index + partition_count > topology_count) {
+        status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                  "topology changed while creating executors");
+      }
+
       // TODO(benvanik): if group count is 0 then don't create the executor.
       // Today the executor creation will fail with 0 groups so the program
       // won't get in a weird state but it's probably not what a user would
       // expect.
 
-      // Create executor with the given topology.
-      status = iree_task_executor_create(options, &topology, host_allocator,
-                                         &executors[i]);
+      // Create executors with the given topology partitions.
+      for (iree_host_size_t j = 0;
+           iree_status_is_ok(status) && j < partition_count; ++j) {
+        iree_task_topology_t partition_topology;
+        const iree_task_topology_t* executor_topology =
+            iree_task_topology_select_partition(&topology, partition_masks[j],
+                                                &partition_topology);
+        status = iree_task_executor_create(options, executor_topology,
+                                           host_allocator,
+                                           &executors[executor_index++]);
+        options.worker_base_index +=
+            iree_task_topology_group_count(executor_topology);
+      }
 
-      // Executor has consumed the topology and it can be dropped now.
+      // Executors have consumed the topology and it can be dropped now.
       iree_task_topology_deinitialize(&topology);
       if (!iree_status_is_ok(status)) break;
     }
+    topology_count = executor_index;
   } else {
     for (iree_host_size_t i = 0; i < topology_count; ++i) {
       // Query topology for the node this executor is pinned to.
@@ -425,6 +597,7 @@ iree_status_t iree_task_executors_create_from_flags(
       // Create executor with the given topology.
       status = iree_task_executor_create(options, &topology, host_allocator,
                                          &executors[i]);
+      options.worker_base_index += iree_task_topology_group_count(&topology);
 
       // Executor has consumed the topology and it can be dropped now.
       iree_task_topology_deinitialize(&topology);
@@ -432,6 +605,10 @@ iree_status_t iree_task_executors_create_from_flags(
     }
   }
 
+  if (iree_status_is_ok(status) && FLAG_task_topology_link_executors) {
+    status = iree_task_executor_link_peers(topology_count, executors);
+  }
+
   if (iree_status_is_ok(status)) {
     *out_executor_count = topology_count;
   } else {
@@ -24,9 +24,95 @@
 
 static void iree_task_executor_destroy(iree_task_executor_t* executor);
 
+//===----------------------------------------------------------------------===//
+// iree_task_executor_group_t
+//===----------------------------------------------------------------------===//
+
+// Set on a group slot thief count when the executor in the slot is being
+// destroyed and no new thefts from it may begin.
+#define IREE_TASK_EXECUTOR_GROUP_SLOT_CLOSED 0x40000000
+
+typedef struct iree_task_executor_group_slot_t {
+  // Executor occupying the slot. Only valid to access while the slot has been
+  // entered with iree_task_executor_group_enter_slot.
+  iree_task_executor_t* executor;
+  // Number of threads actively stealing from the executor in the slot.
+  // IREE_TASK_EXECUTOR_GROUP_SLOT_CLOSED is set when the executor begins
+  // destruction.
+  iree_atomic_int32_t thief_count;
+} iree_task_executor_group_slot_t;
+
+// A group of peer executors linked with iree_task_executor_link_peers.
+// Each member retains the group and the group is freed when the last member is
+// destroyed. Peers reference each other by slot so that a member being
+// destroyed can wait for in-flight thefts from it to complete without other
+// members having to retain it.
+struct iree_task_executor_group_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t allocator;
+  iree_host_size_t slot_count;
+  iree_task_executor_group_slot_t slots[];
+};
+
+static void iree_task_executor_group_release(
+    iree_task_executor_group_t* group) {
+  if (group && iree_atomic_ref_count_dec(&group->ref_count) == 1) {
+    iree_allocator_free(group->allocator, group);
+  }
+}
+
+// Enters the slot at |slot_index| and returns its executor, or NULL if the
+// executor is being destroyed. Must be balanced with
+// iree_task_executor_group_leave_slot if non-NULL is returned.
+static iree_task_executor_t* iree_task_executor_group_enter_slot(
+    iree_task_executor_group_t* group, iree_host_size_t slot_index) {
+  iree_task_executor_group_slot_t* slot = &group->slots[slot_index];
+  int32_t prior_count = iree_atomic_fetch_add_int32(&slot->thief_count, 1,
+                                                    iree_memory_order_acq_rel);
+  if (prior_count & IREE_TASK_EXECUTOR_GROUP_SLOT_CLOSED) {
+    iree_atomic_fetch_sub_int32(&slot->thief_count, 1,
+                                iree_memory_order_release);
+    return NULL;
+  }
+  return slot->executor;
+}
+
+static void iree_task_executor_group_leave_slot(
+    iree_task_executor_group_t* group, iree_host_size_t slot_index) {
+  iree_atomic_fetch_sub_int32(&group->slots[slot_index].thief_count, 1,
+                              iree_memory_order_release);
+}
+
+// Closes the slot at |slot_index| such that no new thefts may begin and waits
+// for any in-flight thefts to complete.
+static void iree_task_executor_group_close_slot(
+    iree_task_executor_group_t* group, iree_host_size_t slot_index) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_task_executor_group_slot_t* slot = &group->slots[slot_index];
+  iree_atomic_fetch_or_int32(&slot->thief_count,
+                             IREE_TASK_EXECUTOR_GROUP_SLOT_CLOSED,
+                             iree_memory_order_acq_rel);
+  // Thefts are short (a few queue operations) so we just yield until they
+  // have all drained.
+  while (iree_atomic_load_int32(&slot->thief_count,
+                                iree_memory_order_acquire) !=
+         IREE_TASK_EXECUTOR_GROUP_SLOT_CLOSED) {
+    iree_thread_yield();
+  }
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// iree_task_executor_t
+//===----------------------------------------------------------------------===//
+
 void iree_task_executor_options_initialize(
     iree_task_executor_options_t* out_options) {
   memset(out_options, 0, sizeof(*out_options));
+  out_options->worker_remote_theft_threshold =
+      IREE_TASK_EXECUTOR_DEFAULT_REMOTE_THEFT_ATTEMPT_THRESHOLD;
+  out_options->worker_local_memory_limit =
+      IREE_TASK_EXECUTOR_DEFAULT_WORKER_LOCAL_MEMORY_LIMIT;
 }
 
 // Returns the size of the worker local memory required by |group| in bytes.
@@ -47,6 +133,49 @@ static iree_host_size_t iree_task_topology_group_local_memory_size(
                          iree_hardware_destructive_interference_size);
 }
 
+// Returns a bitmask of all groups in |topology| that are on the same NUMA node
+// as |group| (including |group| itself).
+static iree_task_affinity_set_t iree_task_topology_calculate_node_sharing_mask(
+    const iree_task_topology_t* topology,
+    const iree_task_topology_group_t* group) {
+  iree_task_affinity_set_t mask = 0;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    if (topology->groups[i].node_id == group->node_id) {
+      mask |= iree_task_affinity_for_worker(i);
+    }
+  }
+  return mask;
+}
+
+// Returns the highest compute capacity of any group in |topology|. Groups with
+// unknown capacity are treated as full capacity.
+static uint32_t iree_task_topology_calculate_max_compute_capacity(
+    const iree_task_topology_t* topology) {
+  uint32_t max_capacity = 0;
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    const uint32_t capacity = topology->groups[i].compute_capacity;
+    max_capacity = iree_max(
+        max_capacity, capacity ? capacity
+                               : IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE);
+  }
+  return max_capacity;
+}
+
+// Returns the compute capacity of |group| relative to |max_capacity| in the
+// range [1, IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE]. Workers on the most
+// capable processors in an executor always have full capacity even if the
+// processors are slower than others in the system.
+static uint32_t iree_task_topology_group_relative_compute_capacity(
+    const iree_task_topology_group_t* group, uint32_t max_capacity) {
+  if (!group->compute_capacity) {
+    return IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE;
+  }
+  const uint32_t capacity =
+      (uint32_t)((uint64_t)group->compute_capacity *
+                 IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE / max_capacity);
+  return iree_max(1u, capacity);
+}
+
 iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
                                         const iree_task_topology_t* topology,
                                         iree_allocator_t allocator,
@@ -97,6 +226,12 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
   executor->allocator = allocator;
   executor->scheduling_mode = options.scheduling_mode;
   executor->worker_spin_ns = options.worker_spin_ns;
+  executor->worker_remote_theft_threshold =
+      options.worker_remote_theft_threshold;
+  executor->worker_local_memory_limit = options.worker_local_memory_limit;
+  executor->high_priority_performance_workers_only =
+      options.high_priority_performance_workers_only;
+  iree_atomic_store_int32(&executor->trim_epoch, 0, iree_memory_order_relaxed);
   iree_atomic_task_slist_initialize(&executor->incoming_ready_slist);
   iree_slim_mutex_initialize(&executor->coordinator_mutex);
 
@@ -174,14 +309,25 @@ iree_status_t iree_task_executor_create(iree_task_executor_options_t options,
     iree_task_affinity_set_t worker_mask =
         iree_task_affinity_set_ones(worker_count);
 
+    const uint32_t max_compute_capacity =
+        iree_task_topology_calculate_max_compute_capacity(topology);
+    executor->performance_worker_mask = 0;
     for (iree_host_size_t i = 0; i < worker_count; ++i) {
       const iree_task_topology_group_t* group =
           iree_task_topology_get_group(topology, i);
+      const uint32_t compute_capacity =
+          iree_task_topology_group_relative_compute_capacity(
+              group, max_compute_capacity);
+      if (compute_capacity == IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE) {
+        executor->performance_worker_mask |= iree_task_affinity_for_worker(i);
+      }
       iree_host_size_t worker_local_memory_size =
           iree_task_topology_group_local_memory_size(options, group);
       iree_task_worker_t* worker = &executor->workers[i];
       status = iree_task_worker_initialize(
-          executor, i, group, options.worker_stack_size,
+          executor, i, group,
+          iree_task_topology_calculate_node_sharing_mask(topology, group),
+          compute_capacity, options.worker_stack_size,
           iree_make_byte_span(worker_local_memory, worker_local_memory_size),
           &seed_prng, worker);
       worker_local_memory += worker_local_memory_size;
@@ -211,6 +357,15 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
   if (!executor) return;
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Prevent any peers from stealing from us as we tear down. Our own workers
+  // may still steal from peers until they exit below.
+  iree_task_executor_group_t* peer_group =
+      (iree_task_executor_group_t*)iree_atomic_load_intptr(
+          &executor->peer_group, iree_memory_order_acquire);
+  if (peer_group) {
+    iree_task_executor_group_close_slot(peer_group, executor->peer_index);
+  }
+
   // First ask all workers to exit. We do this prior to waiting on them to exit
   // so that we parallelize the shutdown logic (which may flush pending tasks).
   for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
@@ -244,6 +399,7 @@ static void iree_task_executor_destroy(iree_task_executor_t* executor) {
   iree_slim_mutex_deinitialize(&executor->coordinator_mutex);
   iree_atomic_task_slist_deinitialize(&executor->incoming_ready_slist);
   iree_task_pool_deinitialize(&executor->transient_task_pool);
+  iree_task_executor_group_release(peer_group);
   iree_allocator_free(executor->allocator, executor);
 
   IREE_TRACE_ZONE_END(z0);
@@ -261,13 +417,43 @@ void iree_task_executor_release(iree_task_executor_t* executor) {
   }
 }
 
+void iree_task_executor_query_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_statistics_t* out_statistics) {
+  memset(out_statistics, 0, sizeof(*out_statistics));
+  IREE_STATISTICS({
+    for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+      iree_task_worker_t* worker = &executor->workers[i];
+      out_statistics->steal_count += (uint64_t)iree_atomic_load_int64(
+          &worker->steal_count, iree_memory_order_relaxed);
+      out_statistics->park_count += (uint64_t)iree_atomic_load_int64(
+          &worker->park_count, iree_memory_order_relaxed);
+      out_statistics->spin_hit_count += (uint64_t)iree_atomic_load_int64(
+          &worker->spin_hit_count, iree_memory_order_relaxed);
+    }
+  });
+}
+
 void iree_task_executor_trim(iree_task_executor_t* executor) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Workers own their grown local memory and release it themselves the next
+  // time they pass through their pump loop. Idle workers are kicked so that
+  // they don't hold on to memory until more work arrives.
+  iree_atomic_fetch_add_int32(&executor->trim_epoch, 1,
+                              iree_memory_order_release);
+  for (iree_host_size_t i = 0; i < executor->worker_count; ++i) {
+    iree_notification_post(&executor->workers[i].wake_notification, 1);
+  }
+
   // TODO(benvanik): figure out a good way to do this; the pools require that
   // no tasks are in-flight to trim but our caller can't reliably make that
   // guarantee. We'd need some global executor lock that we did here and
   // on submit - or rework pools to not have this limitation.
   // iree_task_pool_trim(&executor->fence_task_pool);
   // iree_task_pool_trim(&executor->transient_task_pool);
+
+  IREE_TRACE_ZONE_END(z0);
 }
 
 iree_host_size_t iree_task_executor_worker_count(
@@ -275,11 +461,73 @@ iree_host_size_t iree_task_executor_worker_count(
   return executor->worker_count;
 }
 
+iree_task_topology_node_id_t iree_task_executor_node_id(
+    iree_task_executor_t* executor) {
+  if (executor->worker_count == 0) return IREE_TASK_TOPOLOGY_NODE_ID_ANY;
+  iree_task_topology_node_id_t node_id = executor->workers[0].node_id;
+  for (iree_host_size_t i = 1; i < executor->worker_count; ++i) {
+    if (executor->workers[i].node_id != node_id) {
+      return IREE_TASK_TOPOLOGY_NODE_ID_ANY;
+    }
+  }
+  return node_id;
+}
+
+iree_task_affinity_set_t iree_task_executor_performance_worker_mask(
+    iree_task_executor_t* executor) {
+  return executor->performance_worker_mask;
+}
+
 iree_event_pool_t* iree_task_executor_event_pool(
     iree_task_executor_t* executor) {
   return executor->event_pool;
 }
 
+iree_status_t iree_task_executor_link_peers(
+    iree_host_size_t executor_count, iree_task_executor_t* const* executors) {
+  if (executor_count < 2) return iree_ok_status();
+  IREE_ASSERT_ARGUMENT(executors);
+  for (iree_host_size_t i = 0; i < executor_count; ++i) {
+    if (iree_task_executor_has_peers(executors[i])) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "executor %" PRIhsz " is already linked", i);
+    }
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)executor_count);
+
+  iree_allocator_t allocator = executors[0]->allocator;
+  iree_task_executor_group_t* group = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              allocator,
+              sizeof(*group) + executor_count * sizeof(group->slots[0]),
+              (void**)&group));
+  iree_atomic_ref_count_init_value(&group->ref_count, executor_count);
+  group->allocator = allocator;
+  group->slot_count = executor_count;
+  iree_host_size_t total_worker_count = 0;
+  for (iree_host_size_t i = 0; i < executor_count; ++i) {
+    group->slots[i].executor = executors[i];
+    iree_atomic_store_int32(&group->slots[i].thief_count, 0,
+                            iree_memory_order_relaxed);
+    total_worker_count += executors[i]->worker_count;
+  }
+
+  // Publish the group to each executor; workers may begin stealing from peers
+  // immediately.
+  for (iree_host_size_t i = 0; i < executor_count; ++i) {
+    iree_task_executor_t* executor = executors[i];
+    executor->peer_index = i;
+    executor->peer_worker_count = total_worker_count - executor->worker_count;
+    iree_atomic_store_intptr(&executor->peer_group, (intptr_t)group,
+                             iree_memory_order_release);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence) {
@@ -299,12 +547,12 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
 // The task will be posted to the worker mailbox and available for the worker to
 // begin processing as soon as the |post_batch| is submitted.
 //
-// Only called during coordination and expects the coordinator lock to be held.
+// Called during coordination or direct submission.
 static void iree_task_executor_relay_to_worker(
     iree_task_executor_t* executor, iree_task_post_batch_t* post_batch,
     iree_task_t* task) {
-  iree_host_size_t worker_index =
-      iree_task_post_batch_select_worker(post_batch, task->affinity_set);
+  iree_host_size_t worker_index = iree_task_post_batch_select_worker(
+      post_batch, iree_task_executor_task_worker_mask(executor, task));
   iree_task_post_batch_enqueue(post_batch, worker_index, task);
 }
 
@@ -318,7 +566,8 @@ static void iree_task_executor_relay_to_worker(
 // least recently added tasks from the submission (nice in-order traversal) we
 // are pushing them as what will become the least recent tasks in the batch.
 //
-// Only called during coordination and expects the coordinator lock to be held.
+// Called during coordination or direct submission from any thread; the
+// |pending_submission| and |post_batch| must be owned by the caller.
 void iree_task_executor_schedule_ready_tasks(
     iree_task_executor_t* executor, iree_task_submission_t* pending_submission,
     iree_task_post_batch_t* post_batch) {
@@ -421,6 +670,43 @@ void iree_task_executor_submit(iree_task_executor_t* executor,
   IREE_TRACE_ZONE_END(z0);
 }
 
+void iree_task_executor_submit_direct(iree_task_executor_t* executor,
+                                      iree_task_submission_t* submission) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Take ownership of the submission lists. The submission ready list is
+  // built in LIFO order and we reverse it so that tasks are scheduled in the
+  // order they were enqueued.
+  iree_task_submission_t pending_submission;
+  iree_task_submission_initialize(&pending_submission);
+  iree_task_list_move(&submission->ready_list, &pending_submission.ready_list);
+  iree_task_list_reverse(&pending_submission.ready_list);
+  iree_task_list_move(&submission->waiting_list,
+                      &pending_submission.waiting_list);
+  iree_task_submission_reset(submission);
+
+  // Schedule the ready tasks into our own post batch. Nothing here touches
+  // state owned by the coordinator: the post batch lives on our stack and the
+  // shard pool is thread-safe.
+  iree_task_post_batch_t* post_batch =
+      iree_alloca(sizeof(iree_task_post_batch_t) +
+                  executor->worker_count * sizeof(iree_task_list_t));
+  iree_task_post_batch_initialize(executor, /*current_worker=*/NULL,
+                                  post_batch);
+  iree_task_executor_schedule_ready_tasks(executor, &pending_submission,
+                                          post_batch);
+
+  // Route waiting tasks to the poller.
+  iree_task_poller_enqueue(&executor->poller,
+                           &pending_submission.waiting_list);
+
+  // Post all new work to workers; they may wake and begin executing
+  // immediately.
+  iree_task_post_batch_submit(post_batch);
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 void iree_task_executor_flush(iree_task_executor_t* executor) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -513,8 +799,9 @@ void iree_task_executor_coordinate(iree_task_executor_t* executor,
 
 static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     iree_task_executor_t* executor, iree_task_affinity_set_t victim_mask,
-    uint32_t max_theft_attempts, int rotation_offset,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_scope_priority_t priority, bool allow_mailbox_theft,
+    uint32_t max_theft_attempts, uint32_t max_theft_task_count,
+    int rotation_offset, iree_task_queue_t* local_task_queues) {
   if (!victim_mask) return NULL;
   max_theft_attempts = iree_min(max_theft_attempts,
                                 iree_task_affinity_set_count_ones(victim_mask));
@@ -553,8 +840,8 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
     // thievery taking ~half of the tasks each time (across all queues) will
     // lead to a relatively even distribution.
     iree_task_t* task = iree_task_worker_try_steal_task(
-        victim_worker, local_task_queue,
-        /*max_tasks=*/IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT);
+        victim_worker, priority, &local_task_queues[priority],
+        /*max_tasks=*/max_theft_task_count, allow_mailbox_theft);
     if (task) return task;
   }
 
@@ -564,12 +851,22 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal multiple tasks and add them to the |local_task_queues|.
+//
+// Each priority class active in the executor is tried in order from highest to
+// lowest so that low priority tasks are never stolen while higher priority ones
+// are available for the taking. Mailboxes hold tasks of all priorities and are
+// only stolen from when searching the lowest active class.
 //
-// We do a scan through ideal victims indicated by the
+// Within each class we do a scan through ideal victims indicated by the
 // |constructive_sharing_mask|; these are the workers most likely to have some
 // cache benefits to taking their work as they share some level of the cache
-// hierarchy and should be better to steal from than any random worker.
+// hierarchy and should be better to steal from than any random worker. After
+// that we try the rest of the workers on the same NUMA node as indicated by
+// |node_sharing_mask| and only if |allow_remote_theft| is set do we go across
+// nodes: stealing from a remote node drags the working set of the task across
+// the interconnect and is almost always worse than waiting a bit for local work
+// to show up.
 //
 // To prevent biasing any particular victim we use a fast prng function to
 // select where in the set of potential victims defined by the topology
@@ -579,8 +876,10 @@ static iree_task_t* iree_task_executor_try_steal_task_from_affinity_set(
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue) {
+    iree_task_affinity_set_t node_sharing_mask, bool allow_remote_theft,
+    uint32_t max_theft_attempts, uint32_t max_theft_task_count,
+    iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_queue_t* local_task_queues) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // The masks are accessed with 'relaxed' order because they are just hints.
@@ -602,21 +901,58 @@ iree_task_t* iree_task_executor_try_steal_task(
   int rotation_offset = iree_prng_minilcg128_next_uint8(theft_prng) &
                         (8 * sizeof(iree_task_affinity_set_t) - 1);
 
-  // Try first with the workers we may have some caches shared with. This
-  // helps to prevent cache invalidations/availability updates as it's likely
-  // that we won't need to go back to main memory (or higher cache tiers) in the
-  // event that the thief and victim are running close to each other in time.
-  iree_task_t* task = iree_task_executor_try_steal_task_from_affinity_set(
-      executor, victim_mask & constructive_sharing_mask, max_theft_attempts,
-      rotation_offset, local_task_queue);
-  if (task) {
-    IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
-  } else {
+  // Only classes that have had tasks posted need to be searched. If no tasks of
+  // any class have been posted we still search so that we behave as if only
+  // the default class is active.
+  int32_t priority_mask = iree_atomic_load_int32(&executor->priority_mask,
+                                                 iree_memory_order_relaxed);
+  if (!priority_mask) priority_mask = 1 << IREE_TASK_SCOPE_PRIORITY_NORMAL;
+  const int lowest_priority = iree_math_count_trailing_zeros_u32(priority_mask);
+
+  iree_task_t* task = NULL;
+  for (int priority = IREE_TASK_SCOPE_PRIORITY_COUNT - 1;
+       priority >= lowest_priority && !task; --priority) {
+    if (!(priority_mask & (1 << priority))) continue;
+    const bool allow_mailbox_theft = priority == lowest_priority;
+
+    // Try first with the workers we may have some caches shared with. This
+    // helps to prevent cache invalidations/availability updates as it's likely
+    // that we won't need to go back to main memory (or higher cache tiers) in
+    // the event that the thief and victim are running close to each other in
+    // time.
     task = iree_task_executor_try_steal_task_from_affinity_set(
-        executor, victim_mask & ~constructive_sharing_mask, max_theft_attempts,
-        rotation_offset, local_task_queue);
+        executor, victim_mask & constructive_sharing_mask,
+        (iree_task_scope_priority_t)priority, allow_mailbox_theft,
+        max_theft_attempts, max_theft_task_count, rotation_offset,
+        local_task_queues);
+    if (task) {
+      IREE_TRACE_ZONE_APPEND_TEXT(z0, "local");
+      break;
+    }
+
+    // Try the rest of the workers on the same node; they may not share any
+    // caches with us but at least share the same memory controllers.
+    task = iree_task_executor_try_steal_task_from_affinity_set(
+        executor, victim_mask & ~constructive_sharing_mask & node_sharing_mask,
+        (iree_task_scope_priority_t)priority, allow_mailbox_theft,
+        max_theft_attempts, max_theft_task_count, rotation_offset,
+        local_task_queues);
     if (task) {
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "non-local");
+      break;
+    }
+
+    if (allow_remote_theft) {
+      task = iree_task_executor_try_steal_task_from_affinity_set(
+          executor,
+          victim_mask & ~constructive_sharing_mask & ~node_sharing_mask,
+          (iree_task_scope_priority_t)priority, allow_mailbox_theft,
+          max_theft_attempts, max_theft_task_count, rotation_offset,
+          local_task_queues);
+      if (task) {
+        IREE_TRACE_ZONE_APPEND_TEXT(z0, "remote");
+        break;
+      }
     }
   }
 
@@ -624,6 +960,74 @@ iree_task_t* iree_task_executor_try_steal_task(
   return task;
 }
 
+iree_task_t* iree_task_executor_try_steal_task_from_peers(
+    iree_task_executor_t* executor, uint32_t max_theft_attempts,
+    uint32_t max_theft_task_count, iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_queue_t* local_task_queues) {
+  iree_task_executor_group_t* group =
+      (iree_task_executor_group_t*)iree_atomic_load_intptr(
+          &executor->peer_group, iree_memory_order_acquire);
+  if (!group) return NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Start at a random peer so that all thieves don't pile onto the first one.
+  iree_host_size_t slot_offset =
+      iree_prng_minilcg128_next_uint8(theft_prng) % group->slot_count;
+  iree_task_t* task = NULL;
+  for (iree_host_size_t i = 0; i < group->slot_count && !task; ++i) {
+    iree_host_size_t slot_index = (slot_offset + i) % group->slot_count;
+    if (slot_index == executor->peer_index) continue;
+    iree_task_executor_t* peer =
+        iree_task_executor_group_enter_slot(group, slot_index);
+    if (!peer) continue;
+    // All of the peer workers are remote to us and no cache sharing or node
+    // information applies across executors.
+    task = iree_task_executor_try_steal_task(
+        peer, /*constructive_sharing_mask=*/0, /*node_sharing_mask=*/0,
+        /*allow_remote_theft=*/true, max_theft_attempts, max_theft_task_count,
+        theft_prng, local_task_queues);
+    iree_task_executor_group_leave_slot(group, slot_index);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return task;
+}
+
+void iree_task_executor_wake_idle_peers(iree_task_executor_t* executor,
+                                        iree_host_size_t wake_count) {
+  iree_task_executor_group_t* group =
+      (iree_task_executor_group_t*)iree_atomic_load_intptr(
+          &executor->peer_group, iree_memory_order_acquire);
+  if (!group || !wake_count) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)wake_count);
+
+  for (iree_host_size_t i = 1; i < group->slot_count && wake_count > 0; ++i) {
+    iree_host_size_t slot_index =
+        (executor->peer_index + i) % group->slot_count;
+    iree_task_executor_t* peer =
+        iree_task_executor_group_enter_slot(group, slot_index);
+    if (!peer) continue;
+    // The masks are accessed with 'relaxed' order because they are just hints.
+    iree_task_affinity_set_t idle_mask = iree_atomic_task_affinity_set_load(
+        &peer->worker_idle_mask, iree_memory_order_relaxed);
+    idle_mask &= iree_atomic_task_affinity_set_load(&peer->worker_live_mask,
+                                                    iree_memory_order_relaxed);
+    int worker_index = 0;
+    while (idle_mask && wake_count > 0) {
+      int offset = iree_task_affinity_set_count_trailing_zeros(idle_mask);
+      worker_index += offset;
+      idle_mask = iree_shr(idle_mask, offset + 1);
+      iree_notification_post(&peer->workers[worker_index].wake_notification, 1);
+      ++worker_index;
+      --wake_count;
+    }
+    iree_task_executor_group_leave_slot(group, slot_index);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
 iree_status_t iree_task_executor_donate_caller(iree_task_executor_t* executor,
                                                iree_wait_source_t wait_source,
                                                iree_timeout_t timeout) {
@@ -220,16 +220,16 @@ extern "C" {
 // Scaling Up
 //==============================================================================
 //
-// The task system has an implicit limit of 64 workers. This intentional
-// limitation simplifies several parts of the code while also preventing misuse:
-// it rarely (if ever) makes sense to have more than 64 compute-dominated
-// threads working on a single problem. Achieving high performance in such
-// situations requires extremely careful control over the OS scheduler, memory
-// bandwidth consumption, and synchronization. It's always possible to make the
-// problem more compute-bound or very carefully try to fit in specific cache
-// sizes to avoid more constrained bandwidth paths but it's a non-portable
-// whack-a-mole style solution that is in conflict with a lot of what IREE seeks
-// to do with respect to low-latency and multi-tenant workloads.
+// The task system has an implicit limit of 64 workers per executor. This
+// intentional limitation simplifies several parts of the code while also
+// preventing misuse: it rarely (if ever) makes sense to have more than 64
+// compute-dominated threads working on a single problem. Achieving high
+// performance in such situations requires extremely careful control over the OS
+// scheduler, memory bandwidth consumption, and synchronization. It's always
+// possible to make the problem more compute-bound or very carefully try to fit
+// in specific cache sizes to avoid more constrained bandwidth paths but it's a
+// non-portable whack-a-mole style solution that is in conflict with a lot of
+// what IREE seeks to do with respect to low-latency and multi-tenant workloads.
 //
 // If more than 64 unique L1/L2 caches (or realistically more than probably ~32)
 // are available *and* all of them are attached to the same memory controllers
@@ -239,6 +239,12 @@ extern "C" {
 // needing 100% perfect work scaling of a single task to needing a naive
 // distributed workload solution at the algorithm level.
 //
+// When a single workload does need to span several executors (such as one per
+// NUMA node on a multi-socket machine) the executors can be linked with
+// iree_task_executor_link_peers. Each executor keeps its own coordinator and
+// 64-bit worker masks but idle workers will steal from peer executors as a last
+// resort.
+//
 // Many useful effects also fall out of solving the work distribution problem.
 // Even for single-tenant workloads being able to split work between two
 // executors allows for natural mappings on NUMA systems or completely
@@ -285,9 +291,16 @@ typedef struct iree_task_executor_options_t {
   // additional work. In almost all cases this should be IREE_DURATION_ZERO as
   // spinning is often extremely harmful to system health. Only set to non-zero
   // values when latency is the #1 priority (over thermals, system-wide
-  // scheduling, and the environment).
+  // scheduling, and the environment). Workers that exhaust the spin budget
+  // without finding work park in the kernel until woken.
   iree_duration_t worker_spin_ns;
 
+  // Number of consecutive failed attempts each worker makes at stealing tasks
+  // from workers on its own NUMA node before it will steal from workers on
+  // other nodes. Only used when the topology spans multiple nodes. Defaults to
+  // IREE_TASK_EXECUTOR_DEFAULT_REMOTE_THEFT_ATTEMPT_THRESHOLD.
+  uint32_t worker_remote_theft_threshold;
+
   // Minimum size in bytes of each worker thread stack.
   // The underlying platform may allocate more stack space but _should_
   // guarantee that the available stack space is near this amount. Note that the
@@ -298,11 +311,28 @@ typedef struct iree_task_executor_options_t {
 
   // Defines the bytes to be allocated and reserved by each worker to use for
   // local memory operations. Will be rounded up to the next power of two.
-  // Dispatches performed will be able to request up to this amount of memory
-  // for their invocations and no more. May be 0 if no worker local memory is
+  // Dispatches requesting up to this amount of memory for their invocations
+  // use the reservation directly. May be 0 if no worker local memory is
   // required.
   // By default the CPU L2 cache size is used if such queries are supported.
   iree_host_size_t worker_local_memory_size;
+
+  // Maximum bytes of local memory each worker may grow to on demand when a
+  // dispatch requires more than worker_local_memory_size. Grown memory is
+  // allocated by the worker the first time it is needed and cached across
+  // dispatches until released by iree_task_executor_trim. Dispatches requiring
+  // more than this fail with IREE_STATUS_RESOURCE_EXHAUSTED. May be 0 to
+  // disable growth. Defaults to
+  // IREE_TASK_EXECUTOR_DEFAULT_WORKER_LOCAL_MEMORY_LIMIT.
+  iree_host_size_t worker_local_memory_limit;
+
+  // Restricts tasks in IREE_TASK_SCOPE_PRIORITY_HIGH scopes to the workers
+  // running on the highest capacity processors (see
+  // iree_task_executor_performance_worker_mask). On heterogeneous systems
+  // (big.LITTLE, P+E cores) this keeps latency-critical work off of
+  // efficiency cores at the cost of using fewer workers for it. No-op on
+  // homogeneous systems.
+  bool high_priority_performance_workers_only;
 } iree_task_executor_options_t;
 
 // Initializes |out_options| to default values.
@@ -329,13 +359,51 @@ void iree_task_executor_retain(iree_task_executor_t* executor);
 void iree_task_executor_release(iree_task_executor_t* executor);
 
 // Trims pools and caches used by the executor and its workers.
+// Workers release grown local memory that no dispatch has required since the
+// previous trim asynchronously the next time they wake.
 void iree_task_executor_trim(iree_task_executor_t* executor);
 
+// Counters aggregated across all workers of an executor since creation.
+typedef struct iree_task_executor_statistics_t {
+#if IREE_STATISTICS_ENABLE
+  // Tasks workers took from the queues of other workers (including those of
+  // linked peer executors) after running out of their own.
+  uint64_t steal_count;
+  // Times workers went to sleep in the kernel waiting for work.
+  uint64_t park_count;
+  // Times workers found new work while spinning before they would have parked.
+  uint64_t spin_hit_count;
+#else
+  int reserved;
+#endif  // IREE_STATISTICS_ENABLE
+} iree_task_executor_statistics_t;
+
+// Queries the statistics of |executor| by summing the counters of its workers.
+// Thread-safe; workers keep updating their counters while they are read.
+//
+// NOTE: statistics may be compiled out in some configurations and this call
+// will become a memset(0).
+void iree_task_executor_query_statistics(
+    iree_task_executor_t* executor,
+    iree_task_executor_statistics_t* out_statistics);
+
 // Returns the number of live workers usable by the executor.
 // The actual number used for any particular operation is dynamic.
 iree_host_size_t iree_task_executor_worker_count(
     iree_task_executor_t* executor);
 
+// Returns the NUMA node all workers of the executor run on or
+// IREE_TASK_TOPOLOGY_NODE_ID_ANY if they span multiple nodes.
+iree_task_topology_node_id_t iree_task_executor_node_id(
+    iree_task_executor_t* executor);
+
+// Returns the set of workers running on the highest compute capacity
+// processors in the executor topology. All workers are included on homogeneous
+// systems. Scopes may be restricted to these workers with
+// iree_task_scope_set_worker_mask.
+iree_task_affinity_set_t iree_task_executor_performance_worker_mask(
+    iree_task_executor_t* executor);
+
 // Returns an iree_event_t pool managed by the executor.
 // Users of the task system should acquire their transient events from this.
 // Long-lived events should be allocated on their own in order to avoid
@@ -348,6 +416,22 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
                                                iree_task_scope_t* scope,
                                                iree_task_fence_t** out_fence);
 
+// Links |executors| as peers that may steal work from each other.
+//
+// This allows a set of executors - usually one per NUMA node as created by
+// iree_task_executors_create_from_flags - to be used by a single device without
+// them all contending on a single coordinator or the worker limit of a single
+// executor. Each executor continues to schedule its own submissions but when
+// its workers run out of work (and have failed to steal any from their own
+// executor remote_theft_threshold times) they will try stealing from workers of
+// peer executors. Dispatches fan out additional shards and wake idle peer
+// workers so that large grids can spread across all linked executors.
+//
+// Must be called before any work is submitted to any of the executors and may
+// only be called once per executor. The executors may be released in any order.
+iree_status_t iree_task_executor_link_peers(
+    iree_host_size_t executor_count, iree_task_executor_t* const* executors);
+
 // TODO(benvanik): scheduling mode mutation, compute quota control, etc.
 
 // Submits a batch of tasks for execution.
@@ -366,6 +450,24 @@ iree_status_t iree_task_executor_acquire_fence(iree_task_executor_t* executor,
 void iree_task_executor_submit(iree_task_executor_t* executor,
                                iree_task_submission_t* submission);
 
+// Submits a batch of tasks for execution and immediately schedules all ready
+// tasks from the calling thread.
+//
+// Unlike iree_task_executor_submit + iree_task_executor_flush the submission
+// does not go through the executor coordinator: tasks with no unresolved
+// dependencies are posted directly to worker mailboxes and waiting tasks are
+// sent to the poller. This avoids contention on the coordinator when many
+// threads are submitting concurrently. Tasks that become ready later on (as
+// their dependencies complete) are scheduled by the workers as usual.
+//
+// Safe to call from any thread. Does not acquire the coordinator lock but may
+// block for a small duration if the task pools need to grow.
+//
+// NOTE: it's possible for all work in the submission to complete prior to this
+// function returning.
+void iree_task_executor_submit_direct(iree_task_executor_t* executor,
+                                      iree_task_submission_t* submission);
+
 // Flushes any pending task batches for execution.
 //
 // Safe to call from any thread. Wait-free but may block for a small duration
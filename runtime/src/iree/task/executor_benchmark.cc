@@ -0,0 +1,333 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
+
+#include "benchmark/benchmark.h"
+#include "iree/base/api.h"
+#include "iree/task/executor.h"
+
+namespace {
+
+//==============================================================================
+// Shared executors
+//==============================================================================
+
+// Returns a process-wide executor with |worker_count| unpinned workers evenly
+// split across |node_count| (synthetic) NUMA nodes. Executors are created on
+// first use and live for the lifetime of the process so that thread creation
+// is not measured. Benchmarks running on multiple threads share the executor to
+// measure contention in the submission paths.
+iree_task_executor_t* GetExecutor(int worker_count, int node_count = 1) {
+  static std::mutex mutex;
+  static std::map<std::pair<int, int>, iree_task_executor_t*> executors;
+  std::lock_guard<std::mutex> lock(mutex);
+  auto& executor = executors[std::make_pair(worker_count, node_count)];
+  if (!executor) {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(worker_count, &topology);
+    for (iree_host_size_t i = 0; i < topology.group_count; ++i) {
+      topology.groups[i].node_id =
+          (iree_task_topology_node_id_t)(i * node_count / worker_count);
+    }
+    iree_task_executor_options_t options;
+    iree_task_executor_options_initialize(&options);
+    options.worker_local_memory_size = 64 * 1024;
+    IREE_CHECK_OK(iree_task_executor_create(options, &topology,
+                                            iree_allocator_system(), &executor));
+    iree_task_topology_deinitialize(&topology);
+  }
+  return executor;
+}
+
+// Returns the executor shared by the submission benchmarks.
+iree_task_executor_t* GetSharedExecutor() { return GetExecutor(4); }
+
+// Enqueues |task| to complete |fence| and submits it to |executor|.
+// The scope is only considered busy while it has pending fences so all
+// benchmarks must route their tasks through one before waiting on the scope.
+void SubmitAndFlush(iree_task_executor_t* executor, iree_task_scope_t* scope,
+                    iree_task_t* task) {
+  iree_task_fence_t* fence = NULL;
+  IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, scope, &fence));
+  iree_task_set_completion_task(task, &fence->header);
+  iree_task_submission_t submission;
+  iree_task_submission_initialize(&submission);
+  iree_task_submission_enqueue(&submission, task);
+  iree_task_executor_submit(executor, &submission);
+  iree_task_executor_flush(executor);
+}
+
+// Registers the worker count and node count arguments used by the scheduling
+// benchmarks on |benchmark|: 1-8 workers on a single node and 4/8 workers
+// split across two nodes.
+void WorkerTopologyArgs(benchmark::internal::Benchmark* benchmark) {
+  benchmark->ArgNames({"workers", "nodes"});
+  for (int worker_count : {1, 2, 4, 8}) benchmark->Args({worker_count, 1});
+  for (int worker_count : {4, 8}) benchmark->Args({worker_count, 2});
+}
+
+static iree_status_t NopTile(void* user_context,
+                             const iree_task_tile_context_t* tile_context,
+                      iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+static iree_status_t NopCall(void* user_context, iree_task_t* task,
+                             iree_task_submission_t* pending_submission) {
+  return iree_ok_status();
+}
+
+//==============================================================================
+// Submission
+//==============================================================================
+
+// Submits a single ready call task per iteration and waits for it to complete.
+// |direct| selects iree_task_executor_submit_direct instead of the default
+// submit + flush path that goes through the coordinator.
+void SubmitCallAndWait(benchmark::State& state, bool direct) {
+  iree_task_executor_t* executor = GetSharedExecutor();
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  for (auto _ : state) {
+    iree_task_call_t call;
+    iree_task_call_initialize(&scope, iree_task_make_call_closure(NopCall, 0),
+                              &call);
+    // The scope is only considered busy while it has pending fences.
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&call.header, &fence->header);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call.header);
+    if (direct) {
+      iree_task_executor_submit_direct(executor, &submission);
+    } else {
+      iree_task_executor_submit(executor, &submission);
+      iree_task_executor_flush(executor);
+    }
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  }
+  iree_task_scope_deinitialize(&scope);
+}
+
+void BM_SubmitCoordinated(benchmark::State& state) {
+  SubmitCallAndWait(state, /*direct=*/false);
+}
+BENCHMARK(BM_SubmitCoordinated)->UseRealTime()->ThreadRange(1, 8);
+
+void BM_SubmitDirect(benchmark::State& state) {
+  SubmitCallAndWait(state, /*direct=*/true);
+}
+BENCHMARK(BM_SubmitDirect)->UseRealTime()->ThreadRange(1, 8);
+
+//==============================================================================
+// Dispatch scheduling
+//==============================================================================
+
+// Measures the latency from submitting a dispatch to its first tile beginning
+// execution. This includes coordination, waking a worker, and the shard
+// reservation of the first tile.
+void BM_SubmitToFirstTile(benchmark::State& state) {
+  iree_task_executor_t* executor =
+      GetExecutor((int)state.range(0), (int)state.range(1));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  struct first_tile_t {
+    std::atomic<bool> started;
+    std::atomic<iree_time_t> start_time;
+  } first_tile;
+  for (auto _ : state) {
+    first_tile.started = false;
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {(uint32_t)state.range(0), 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              auto* first_tile = (first_tile_t*)user_context;
+              if (!first_tile->started.exchange(true)) {
+                first_tile->start_time = iree_time_now();
+              }
+              return iree_ok_status();
+            },
+            &first_tile),
+        workgroup_size, workgroup_count, &dispatch);
+    iree_time_t submit_time = iree_time_now();
+    SubmitAndFlush(executor, &scope, &dispatch.header);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+    state.SetIterationTime((first_tile.start_time - submit_time) / 1e9);
+  }
+  iree_task_scope_deinitialize(&scope);
+}
+BENCHMARK(BM_SubmitToFirstTile)->Apply(WorkerTopologyArgs)->UseManualTime();
+
+// Measures the throughput of tiles that do no work. This is the per-tile
+// overhead of reservation and the fork/join of the shards across workers.
+void BM_EmptyTileThroughput(benchmark::State& state) {
+  iree_task_executor_t* executor =
+      GetExecutor((int)state.range(0), (int)state.range(1));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  const uint32_t tile_count = 16 * 1024;
+  for (auto _ : state) {
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {tile_count, 1, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(&scope,
+                                  iree_task_make_dispatch_closure(NopTile, 0),
+                                  workgroup_size, workgroup_count, &dispatch);
+    SubmitAndFlush(executor, &scope, &dispatch.header);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  }
+  state.SetItemsProcessed(state.iterations() * tile_count);
+  iree_task_scope_deinitialize(&scope);
+}
+BENCHMARK(BM_EmptyTileThroughput)->Apply(WorkerTopologyArgs)->UseRealTime();
+
+//==============================================================================
+// Work stealing
+//==============================================================================
+
+// Per-thread slots used to attribute task execution to workers without
+// needing to plumb worker indices through call tasks.
+static std::atomic<int> next_thread_slot = {0};
+static constexpr int kMaxThreadSlots = 64;
+
+// Returns a stable slot index for the calling thread.
+int GetThreadSlot() {
+  static thread_local int slot = next_thread_slot++ % kMaxThreadSlots;
+  return slot;
+}
+
+// Measures how quickly work posted to a single worker is stolen by the others.
+// All call tasks are pinned to worker 0 and every other worker can only get
+// work by stealing it. Each other worker is woken with an empty call of its own
+// after which it will look for work to steal. The |steal_ratio| counter reports
+// the fraction of tasks that executed on a worker other than the one that ran
+// the most.
+void BM_StealRate(benchmark::State& state) {
+  iree_task_executor_t* executor =
+      GetExecutor((int)state.range(0), (int)state.range(1));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  static constexpr int kTaskCount = 256;
+  const int worker_count = (int)state.range(0);
+  std::atomic<int> slot_counts[kMaxThreadSlots];
+  int64_t total_stolen_count = 0;
+  for (auto _ : state) {
+    for (auto& slot_count : slot_counts) slot_count = 0;
+    iree_task_call_t calls[kTaskCount + kMaxThreadSlots];
+    iree_task_t* call_tasks[kTaskCount + kMaxThreadSlots];
+    for (int i = 0; i < kTaskCount; ++i) {
+      iree_task_call_initialize(
+          &scope,
+          iree_task_make_call_closure(
+              [](void* user_context, iree_task_t* task,
+                 iree_task_submission_t* pending_submission) {
+                auto* slot_counts = (std::atomic<int>*)user_context;
+                ++slot_counts[GetThreadSlot()];
+                // Simulate a small amount of work so there's something to
+                // steal while the owner is busy.
+                iree_time_t end_time = iree_time_now() + 2000;
+                while (iree_time_now() < end_time) {
+                }
+                return iree_ok_status();
+              },
+              slot_counts),
+          &calls[i]);
+      calls[i].header.affinity_set = iree_task_affinity_for_worker(0);
+      call_tasks[i] = &calls[i].header;
+    }
+    const int call_count = kTaskCount + worker_count - 1;
+    for (int i = kTaskCount; i < call_count; ++i) {
+      iree_task_call_initialize(
+          &scope, iree_task_make_call_closure(NopCall, 0), &calls[i]);
+      calls[i].header.affinity_set =
+          iree_task_affinity_for_worker((uint8_t)(i - kTaskCount + 1));
+      call_tasks[i] = &calls[i].header;
+    }
+    // Fork all calls from a barrier so that they are posted together.
+    iree_task_barrier_t barrier;
+    iree_task_barrier_initialize(&scope, call_count, call_tasks, &barrier);
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    for (int i = 0; i < call_count; ++i) {
+      iree_task_set_completion_task(&calls[i].header, &fence->header);
+    }
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &barrier.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+    int owner_count = 0;
+    for (auto& slot_count : slot_counts) {
+      owner_count = std::max(owner_count, slot_count.load());
+    }
+    total_stolen_count += kTaskCount - owner_count;
+  }
+  state.SetItemsProcessed(state.iterations() * kTaskCount);
+  state.counters["steal_ratio"] = benchmark::Counter(
+      (double)total_stolen_count / (state.iterations() * kTaskCount));
+  iree_task_scope_deinitialize(&scope);
+}
+BENCHMARK(BM_StealRate)->Apply(WorkerTopologyArgs)->UseRealTime();
+
+//==============================================================================
+// Fork/join
+//==============================================================================
+
+// Measures the cost of forking |fanout| empty call tasks from a barrier and
+// joining them on a fence. This is the shape of most command buffer
+// execution barriers.
+void BM_ForkJoin(benchmark::State& state) {
+  iree_task_executor_t* executor = GetExecutor((int)state.range(0));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("benchmark"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  const int fanout = (int)state.range(1);
+  std::unique_ptr<iree_task_call_t[]> calls(new iree_task_call_t[fanout]);
+  std::unique_ptr<iree_task_t*[]> call_tasks(new iree_task_t*[fanout]);
+  for (auto _ : state) {
+    iree_task_fence_t* fence = NULL;
+    IREE_CHECK_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    for (int i = 0; i < fanout; ++i) {
+      iree_task_call_initialize(
+          &scope, iree_task_make_call_closure(NopCall, 0), &calls[i]);
+      iree_task_set_completion_task(&calls[i].header, &fence->header);
+      call_tasks[i] = &calls[i].header;
+    }
+    iree_task_barrier_t barrier;
+    iree_task_barrier_initialize(&scope, fanout, call_tasks.get(), &barrier);
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &barrier.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_CHECK_OK(iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+  }
+  state.SetItemsProcessed(state.iterations() * fanout);
+  iree_task_scope_deinitialize(&scope);
+}
+BENCHMARK(BM_ForkJoin)
+    ->ArgNames({"workers", "fanout"})
+    ->ArgsProduct({{1, 2, 4, 8}, {1, 8, 64}})
+    ->UseRealTime();
+
+}  // namespace
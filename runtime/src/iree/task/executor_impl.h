@@ -18,6 +18,7 @@
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
 #include "iree/task/queue.h"
+#include "iree/task/scope.h"
 #include "iree/task/tuning.h"
 #include "iree/task/worker.h"
 
@@ -25,6 +26,8 @@
 extern "C" {
 #endif  // __cplusplus
 
+typedef struct iree_task_executor_group_t iree_task_executor_group_t;
+
 struct iree_task_executor_t {
   iree_atomic_ref_count_t ref_count;
   iree_allocator_t allocator;
@@ -42,6 +45,24 @@ struct iree_task_executor_t {
   // IREE_DURATION_ZERO is used to disable spinning.
   iree_duration_t worker_spin_ns;
 
+  // Number of consecutive failed node-local theft attempts each worker makes
+  // before it is allowed to steal from workers on other NUMA nodes.
+  uint32_t worker_remote_theft_threshold;
+
+  // Maximum bytes of local memory each worker may grow to on demand.
+  iree_host_size_t worker_local_memory_limit;
+
+  // Workers running on the highest compute capacity processors.
+  iree_task_affinity_set_t performance_worker_mask;
+
+  // Restricts high priority scopes to |performance_worker_mask|.
+  bool high_priority_performance_workers_only;
+
+  // Incremented by iree_task_executor_trim to request that workers release
+  // cached resources such as grown local memory. Workers compare against the
+  // epoch they last observed to detect new requests.
+  iree_atomic_int32_t trim_epoch;
+
   // State used by the work-stealing operations performed by donated threads.
   // This is **NOT SYNCHRONIZED** and relies on the fact that we actually don't
   // much care about the precise selection of workers enough to mind any tears
@@ -116,6 +137,14 @@ struct iree_task_executor_t {
   // comment on worker_live_mask.
   iree_atomic_task_affinity_set_t worker_idle_mask;
 
+  // A bitset of iree_task_scope_priority_t classes that have had tasks posted
+  // to workers. Bits are only ever set and allow workers to skip the
+  // per-priority bookkeeping when only a single class is in use (the common
+  // case).
+  //
+  // This mask is just a hint, accessed with memory_order_relaxed.
+  iree_atomic_int32_t priority_mask;
+
   // Base value added to each executor-local worker index.
   // This allows workers to uniquely identify themselves in multi-executor
   // configurations.
@@ -126,6 +155,18 @@ struct iree_task_executor_t {
   // live join/leave behavior we could change this to a registration mechanism.
   iree_host_size_t worker_count;
   iree_task_worker_t* workers;  // [worker_count]
+
+  // Group of peer executors linked with iree_task_executor_link_peers, if any.
+  // Stored as an iree_task_executor_group_t* and published before any work is
+  // submitted; immutable afterward until the executor is destroyed.
+  iree_atomic_intptr_t peer_group;
+
+  // Index of this executor in the peer group slots.
+  iree_host_size_t peer_index;
+
+  // Total number of workers in all peer executors (excluding our own).
+  // Dispatches fan out enough shards to allow idle peers to steal some.
+  iree_host_size_t peer_worker_count;
 };
 
 // Merges a submission into the primary FIFO queues.
@@ -137,7 +178,9 @@ void iree_task_executor_merge_submission(iree_task_executor_t* executor,
                                          iree_task_submission_t* submission);
 
 // Schedules all ready tasks in the |pending_submission| list.
-// Only called during coordination and expects the coordinator lock to be held.
+// Called during coordination with the coordinator lock held or during direct
+// submission; the |pending_submission| and |post_batch| must be owned by the
+// caller.
 void iree_task_executor_schedule_ready_tasks(
     iree_task_executor_t* executor, iree_task_submission_t* pending_submission,
     iree_task_post_batch_t* post_batch);
@@ -154,14 +197,83 @@ void iree_task_executor_schedule_ready_tasks(
 void iree_task_executor_coordinate(iree_task_executor_t* executor,
                                    iree_task_worker_t* current_worker);
 
+// Marks |priority| as having had tasks posted to workers of |executor|.
+static inline void iree_task_executor_mark_priority(
+    iree_task_executor_t* executor, iree_task_scope_priority_t priority) {
+  const int32_t priority_bit = 1 << priority;
+  if (iree_atomic_load_int32(&executor->priority_mask,
+                             iree_memory_order_relaxed) &
+      priority_bit) {
+    return;  // already set; avoid the cache line ping-pong
+  }
+  iree_atomic_fetch_or_int32(&executor->priority_mask, priority_bit,
+                             iree_memory_order_relaxed);
+}
+
+// Returns the workers of |executor| that tasks in |scope| may execute on: those
+// reserved by the scope and, if the executor restricts high priority work to
+// performance workers, the performance workers among them.
+static inline iree_task_affinity_set_t iree_task_executor_scope_worker_mask(
+    const iree_task_executor_t* executor, const iree_task_scope_t* scope) {
+  iree_task_affinity_set_t worker_mask = iree_task_scope_worker_mask(scope);
+  if (executor->high_priority_performance_workers_only &&
+      iree_task_scope_priority(scope) == IREE_TASK_SCOPE_PRIORITY_HIGH) {
+    const iree_task_affinity_set_t performance_worker_mask =
+        worker_mask & executor->performance_worker_mask;
+    if (performance_worker_mask) worker_mask = performance_worker_mask;
+  }
+  return worker_mask;
+}
+
+// Returns the workers that |task| may execute on: those in its affinity set
+// that have been reserved by its scope. Explicitly pinned tasks whose affinity
+// set does not overlap the scope reservation retain their affinity set.
+static inline iree_task_affinity_set_t iree_task_executor_task_worker_mask(
+    const iree_task_executor_t* executor, const iree_task_t* task) {
+  iree_task_affinity_set_t worker_mask =
+      task->affinity_set &
+      iree_task_executor_scope_worker_mask(executor, task->scope);
+  return worker_mask ? worker_mask : task->affinity_set;
+}
+
 // Tries to steal an entire task from a sibling worker (based on topology).
 // Returns a task that is available (has not yet begun processing at all).
-// May steal multiple tasks and add them to the |local_task_queue|.
+// May steal up to |max_theft_task_count| tasks and add them to the matching
+// priority queue in |local_task_queues|.
+//
+// Priority classes are tried from highest to lowest such that lower priority
+// tasks are only stolen if no higher priority tasks are available. Within each
+// class victims are tried in tiers: first those in the
+// |constructive_sharing_mask|, then the remaining ones on the same NUMA node in
+// |node_sharing_mask|, and only if |allow_remote_theft| is set those on other
+// nodes.
 iree_task_t* iree_task_executor_try_steal_task(
     iree_task_executor_t* executor,
     iree_task_affinity_set_t constructive_sharing_mask,
-    uint32_t max_theft_attempts, iree_prng_minilcg128_state_t* theft_prng,
-    iree_task_queue_t* local_task_queue);
+    iree_task_affinity_set_t node_sharing_mask, bool allow_remote_theft,
+    uint32_t max_theft_attempts, uint32_t max_theft_task_count,
+    iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_queue_t* local_task_queues);
+
+// Returns true if the executor has been linked with peer executors.
+static inline bool iree_task_executor_has_peers(
+    iree_task_executor_t* executor) {
+  return iree_atomic_load_intptr(&executor->peer_group,
+                                 iree_memory_order_acquire) != 0;
+}
+
+// Tries to steal an entire task from a worker of a peer executor.
+// Only workers that are actively processing (not idle) are considered victims.
+// May steal multiple tasks and add them to the |local_task_queues|.
+iree_task_t* iree_task_executor_try_steal_task_from_peers(
+    iree_task_executor_t* executor, uint32_t max_theft_attempts,
+    uint32_t max_theft_task_count, iree_prng_minilcg128_state_t* theft_prng,
+    iree_task_queue_t* local_task_queues);
+
+// Wakes up to |wake_count| idle workers across all peer executors so that they
+// may steal work from this executor. No-op if there are no peers.
+void iree_task_executor_wake_idle_peers(iree_task_executor_t* executor,
+                                        iree_host_size_t wake_count);
 
 #ifdef __cplusplus
 }  // extern "C"
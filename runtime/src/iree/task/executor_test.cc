@@ -6,7 +6,10 @@
 
 #include "iree/task/executor.h"
 
+#include <atomic>
 #include <cstddef>
+#include <thread>
+#include <vector>
 
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -135,4 +138,405 @@ TEST(ExecutorTest, SubmissionStress) {
   iree_task_topology_deinitialize(&topology);
 }
 
+// Tests direct submission from several threads at once.
+// Each thread submits a call and a dependent dispatch and waits on its own
+// scope.
+TEST(ExecutorTest, SubmitDirectConcurrent) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  static constexpr int kThreadCount = 4;
+  static constexpr int kIterationCount = 50;
+  std::atomic<int> call_count = {0};
+  std::atomic<int> tile_count = {0};
+  std::vector<std::thread> threads;
+  for (int t = 0; t < kThreadCount; ++t) {
+    threads.emplace_back([&]() {
+      iree_task_scope_t scope;
+      iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                                 IREE_TASK_SCOPE_FLAG_NONE, &scope);
+      for (int i = 0; i < kIterationCount; ++i) {
+        iree_task_call_t call;
+        iree_task_call_initialize(
+            &scope,
+            iree_task_make_call_closure(
+                [](void* user_context, iree_task_t* task,
+                   iree_task_submission_t* pending_submission) {
+                  ++*(std::atomic<int>*)user_context;
+                  return iree_ok_status();
+                },
+                (void*)&call_count),
+            &call);
+        const uint32_t workgroup_size[3] = {1, 1, 1};
+        const uint32_t workgroup_count[3] = {16, 1, 1};
+        iree_task_dispatch_t dispatch;
+        iree_task_dispatch_initialize(
+            &scope,
+            iree_task_make_dispatch_closure(
+                [](void* user_context,
+                   const iree_task_tile_context_t* tile_context,
+                   iree_task_submission_t* pending_submission) {
+                  ++*(std::atomic<int>*)user_context;
+                  return iree_ok_status();
+                },
+                (void*)&tile_count),
+            workgroup_size, workgroup_count, &dispatch);
+        iree_task_set_completion_task(&call.header, &dispatch.header);
+
+        iree_task_fence_t* fence = NULL;
+        IREE_ASSERT_OK(
+            iree_task_executor_acquire_fence(executor, &scope, &fence));
+        iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+        iree_task_submission_t submission;
+        iree_task_submission_initialize(&submission);
+        iree_task_submission_enqueue(&submission, &call.header);
+        iree_task_executor_submit_direct(executor, &submission);
+        IREE_ASSERT_OK(
+            iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+      }
+      iree_task_scope_deinitialize(&scope);
+    });
+  }
+  for (auto& thread : threads) thread.join();
+
+  EXPECT_EQ(call_count, kThreadCount * kIterationCount);
+  EXPECT_EQ(tile_count, kThreadCount * kIterationCount * 16);
+
+  iree_task_executor_release(executor);
+}
+
+// Tests dispatching across workers split over multiple NUMA nodes.
+// This exercises the tiered work stealing that delays remote thefts.
+TEST(ExecutorTest, MultiNodeDispatch) {
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  for (iree_host_size_t i = 0; i < topology.group_count; ++i) {
+    topology.groups[i].node_id = i < topology.group_count / 2 ? 0 : 1;
+  }
+
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  for (int i = 0; i < 100; ++i) {
+    static std::atomic<int> tile_count = {0};
+    tile_count = 0;
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {64, 4, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              ++tile_count;
+              return iree_ok_status();
+            },
+            NULL),
+        workgroup_size, workgroup_count, &dispatch);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    EXPECT_EQ(tile_count, 64 * 4);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+  iree_task_topology_deinitialize(&topology);
+}
+
+// Tests dispatching to one of several linked peer executors.
+// The dispatch is large enough that workers of the peers will be woken to steal
+// shards from the submitting executor.
+TEST(ExecutorTest, LinkedPeerDispatch) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_executor_t* executors[2] = {NULL, NULL};
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(executors); ++i) {
+    iree_task_topology_t topology;
+    iree_task_topology_initialize_from_group_count(/*group_count=*/2,
+                                                   &topology);
+    IREE_ASSERT_OK(iree_task_executor_create(
+        options, &topology, iree_allocator_system(), &executors[i]));
+    iree_task_topology_deinitialize(&topology);
+    options.worker_base_index += 2;
+  }
+  IREE_ASSERT_OK(
+      iree_task_executor_link_peers(IREE_ARRAYSIZE(executors), executors));
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+
+  for (int i = 0; i < 100; ++i) {
+    static std::atomic<int> tile_count = {0};
+    tile_count = 0;
+    const uint32_t workgroup_size[3] = {1, 1, 1};
+    const uint32_t workgroup_count[3] = {64, 4, 1};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope,
+        iree_task_make_dispatch_closure(
+            [](void* user_context, const iree_task_tile_context_t* tile_context,
+               iree_task_submission_t* pending_submission) {
+              ++tile_count;
+              return iree_ok_status();
+            },
+            NULL),
+        workgroup_size, workgroup_count, &dispatch);
+
+    // Alternate which executor the work is submitted to.
+    iree_task_executor_t* executor = executors[i % IREE_ARRAYSIZE(executors)];
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    EXPECT_EQ(tile_count, 64 * 4);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(executors); ++i) {
+    iree_task_executor_release(executors[i]);
+  }
+}
+
+// Tests that scopes of different priorities sharing an executor complete and
+// that their tasks only execute on the workers reserved for them.
+TEST(ExecutorTest, PriorityScopeWorkerMasks) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  // Batch work is confined to worker 0 and interactive work to the others.
+  iree_task_scope_t low_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("low"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &low_scope);
+  iree_task_scope_set_priority(&low_scope, IREE_TASK_SCOPE_PRIORITY_LOW);
+  iree_task_scope_set_worker_mask(&low_scope, 0b0001);
+  iree_task_scope_t high_scope;
+  iree_task_scope_initialize(iree_make_cstring_view("high"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &high_scope);
+  iree_task_scope_set_priority(&high_scope, IREE_TASK_SCOPE_PRIORITY_HIGH);
+  iree_task_scope_set_worker_mask(&high_scope, 0b1110);
+
+  struct tile_state_t {
+    uint32_t allowed_worker_mask;
+    std::atomic<int> tile_count;
+    std::atomic<int> misplaced_count;
+  };
+  auto tile_fn = [](void* user_context,
+                    const iree_task_tile_context_t* tile_context,
+                    iree_task_submission_t* pending_submission) {
+    auto* state = (tile_state_t*)user_context;
+    ++state->tile_count;
+    if (!(state->allowed_worker_mask & (1u << tile_context->worker_id))) {
+      ++state->misplaced_count;
+    }
+    return iree_ok_status();
+  };
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {64, 4, 1};
+  for (int i = 0; i < 50; ++i) {
+    tile_state_t low_state = {0b0001, {0}, {0}};
+    iree_task_dispatch_t low_dispatch;
+    iree_task_dispatch_initialize(
+        &low_scope, iree_task_make_dispatch_closure(tile_fn, &low_state),
+        workgroup_size, workgroup_count, &low_dispatch);
+    iree_task_fence_t* low_fence = NULL;
+    IREE_ASSERT_OK(
+        iree_task_executor_acquire_fence(executor, &low_scope, &low_fence));
+    iree_task_set_completion_task(&low_dispatch.header, &low_fence->header);
+
+    tile_state_t high_state = {0b1110, {0}, {0}};
+    iree_task_dispatch_t high_dispatch;
+    iree_task_dispatch_initialize(
+        &high_scope, iree_task_make_dispatch_closure(tile_fn, &high_state),
+        workgroup_size, workgroup_count, &high_dispatch);
+    iree_task_fence_t* high_fence = NULL;
+    IREE_ASSERT_OK(
+        iree_task_executor_acquire_fence(executor, &high_scope, &high_fence));
+    iree_task_set_completion_task(&high_dispatch.header, &high_fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &low_dispatch.header);
+    iree_task_submission_enqueue(&submission, &high_dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&high_scope, IREE_TIME_INFINITE_FUTURE));
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&low_scope, IREE_TIME_INFINITE_FUTURE));
+
+    EXPECT_EQ(low_state.tile_count, 64 * 4);
+    EXPECT_EQ(low_state.misplaced_count, 0);
+    EXPECT_EQ(high_state.tile_count, 64 * 4);
+    EXPECT_EQ(high_state.misplaced_count, 0);
+  }
+
+  iree_task_scope_deinitialize(&low_scope);
+  iree_task_scope_deinitialize(&high_scope);
+  iree_task_executor_release(executor);
+}
+
+// Tests that tasks pinned to workers outside of their scope's reservation run
+// on the workers they are pinned to instead of being forwarded forever.
+TEST(ExecutorTest, PinnedTaskOutsideScopeWorkerMask) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("scope"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  iree_task_scope_set_worker_mask(&scope, 0b0001);
+
+  for (int i = 0; i < 50; ++i) {
+    std::atomic<int> call_count = {0};
+    iree_task_call_t call;
+    iree_task_call_initialize(
+        &scope,
+        iree_task_make_call_closure(
+            [](void* user_context, iree_task_t* task,
+               iree_task_submission_t* pending_submission) {
+              ++*(std::atomic<int>*)user_context;
+              return iree_ok_status();
+            },
+            &call_count),
+        &call);
+    call.header.affinity_set = iree_task_affinity_for_worker(1 + i % 3);
+
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&call.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &call.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(iree_task_scope_wait_idle(
+        &scope, iree_relative_timeout_to_deadline_ns(10000000000ll)));
+    EXPECT_EQ(call_count, 1);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
+// Tests that high priority work is confined to the workers on the highest
+// capacity processors when requested.
+TEST(ExecutorTest, HighPriorityPerformanceWorkers) {
+  iree_task_executor_options_t options;
+  iree_task_executor_options_initialize(&options);
+  options.worker_local_memory_size = 64 * 1024;
+  options.high_priority_performance_workers_only = true;
+  iree_task_topology_t topology;
+  iree_task_topology_initialize_from_group_count(/*group_count=*/4, &topology);
+  // Workers 2 and 3 are on efficiency cores.
+  topology.groups[2].compute_capacity =
+      IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE / 2;
+  topology.groups[3].compute_capacity =
+      IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE / 2;
+  iree_task_executor_t* executor = NULL;
+  IREE_ASSERT_OK(iree_task_executor_create(options, &topology,
+                                           iree_allocator_system(), &executor));
+  iree_task_topology_deinitialize(&topology);
+  EXPECT_EQ(0b0011, iree_task_executor_performance_worker_mask(executor));
+
+  iree_task_scope_t scope;
+  iree_task_scope_initialize(iree_make_cstring_view("high"),
+                             IREE_TASK_SCOPE_FLAG_NONE, &scope);
+  iree_task_scope_set_priority(&scope, IREE_TASK_SCOPE_PRIORITY_HIGH);
+
+  struct tile_state_t {
+    std::atomic<int> tile_count;
+    std::atomic<int> misplaced_count;
+  };
+  auto tile_fn = [](void* user_context,
+                    const iree_task_tile_context_t* tile_context,
+                    iree_task_submission_t* pending_submission) {
+    auto* state = (tile_state_t*)user_context;
+    ++state->tile_count;
+    if (!(0b0011 & (1u << tile_context->worker_id))) {
+      ++state->misplaced_count;
+    }
+    return iree_ok_status();
+  };
+
+  const uint32_t workgroup_size[3] = {1, 1, 1};
+  const uint32_t workgroup_count[3] = {64, 4, 1};
+  for (int i = 0; i < 50; ++i) {
+    tile_state_t state = {{0}, {0}};
+    iree_task_dispatch_t dispatch;
+    iree_task_dispatch_initialize(
+        &scope, iree_task_make_dispatch_closure(tile_fn, &state),
+        workgroup_size, workgroup_count, &dispatch);
+    if (i % 2) dispatch.header.flags |= IREE_TASK_FLAG_DISPATCH_LOCALITY;
+    iree_task_fence_t* fence = NULL;
+    IREE_ASSERT_OK(iree_task_executor_acquire_fence(executor, &scope, &fence));
+    iree_task_set_completion_task(&dispatch.header, &fence->header);
+
+    iree_task_submission_t submission;
+    iree_task_submission_initialize(&submission);
+    iree_task_submission_enqueue(&submission, &dispatch.header);
+    iree_task_executor_submit(executor, &submission);
+    iree_task_executor_flush(executor);
+    IREE_ASSERT_OK(
+        iree_task_scope_wait_idle(&scope, IREE_TIME_INFINITE_FUTURE));
+
+    EXPECT_EQ(state.tile_count, 64 * 4);
+    EXPECT_EQ(state.misplaced_count, 0);
+  }
+
+  iree_task_scope_deinitialize(&scope);
+  iree_task_executor_release(executor);
+}
+
 }  // namespace
@@ -25,6 +25,7 @@ iree_status_t iree_task_poller_initialize(
   iree_notification_initialize(&out_poller->state_notification);
   iree_atomic_task_slist_initialize(&out_poller->mailbox_slist);
   iree_task_list_initialize(&out_poller->wait_list);
+  out_poller->query_exported_waits = false;
 
   iree_task_poller_state_t initial_state = IREE_TASK_POLLER_STATE_RUNNING;
   // TODO(benvanik): support initially suspended wait threads. This can reduce
@@ -41,13 +42,13 @@ iree_status_t iree_task_poller_initialize(
       &out_poller->wake_event);
 
   // Wait set used to batch syscalls for polling/waiting on wait handles.
-  // This is currently limited to a relatively small max to make bad behavior
-  // clearer with nice RESOURCE_EXHAUSTED errors. If we start to hit that limit
-  // (~63+ simultaneous system waits) we'll need to shard out the wait sets -
-  // possibly with multiple wait threads (one per set).
+  // The set starts small and is grown by the wait thread if it is exhausted.
   if (iree_status_is_ok(status)) {
-    status = iree_wait_set_allocate(IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS,
-                                    executor->allocator, &out_poller->wait_set);
+    status = iree_wait_set_allocate(
+        IREE_TASK_EXECUTOR_INITIAL_OUTSTANDING_WAITS, executor->allocator,
+        &out_poller->wait_set);
+    out_poller->wait_set_capacity =
+        IREE_TASK_EXECUTOR_INITIAL_OUTSTANDING_WAITS;
   }
   if (iree_status_is_ok(status)) {
     status = iree_wait_set_insert(out_poller->wait_set, out_poller->wake_event);
@@ -169,9 +170,49 @@ void iree_task_poller_enqueue(iree_task_poller_t* poller,
   IREE_TRACE_ZONE_END(z0);
 }
 
-// Acquires a wait handle for |task| and inserts it into |wait_set|.
+// Replaces the wait set of |poller| with one of twice the capacity containing
+// the wake event and the wait handles of all exported tasks in the wait list.
+// Wait sets have no way to enumerate their handles so we rebuild it from the
+// tasks; the task currently being exported must already have its handle
+// imported into its wait source.
+static iree_status_t iree_task_poller_grow_wait_set(
+    iree_task_poller_t* poller) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_host_size_t new_capacity = poller->wait_set_capacity * 2;
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)new_capacity);
+
+  iree_wait_set_t* new_wait_set = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_wait_set_allocate(new_capacity, poller->executor->allocator,
+                                 &new_wait_set));
+  iree_status_t status = iree_wait_set_insert(new_wait_set, poller->wake_event);
+  for (iree_task_t* task = iree_task_list_front(&poller->wait_list);
+       task != NULL && iree_status_is_ok(status); task = task->next_task) {
+    if (!iree_all_bits_set(task->flags, IREE_TASK_FLAG_WAIT_EXPORTED)) {
+      continue;
+    }
+    iree_wait_handle_t* wait_handle =
+        iree_wait_handle_from_source(&((iree_task_wait_t*)task)->wait_source);
+    if (wait_handle) {
+      status = iree_wait_set_insert(new_wait_set, *wait_handle);
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    iree_wait_set_free(poller->wait_set);
+    poller->wait_set = new_wait_set;
+    poller->wait_set_capacity = new_capacity;
+  } else {
+    iree_wait_set_free(new_wait_set);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+// Acquires a wait handle for |task| and inserts it into the |poller| wait set,
+// growing the set if required.
 static iree_status_t iree_task_poller_insert_wait_handle(
-    iree_wait_set_t* wait_set, iree_task_wait_t* task) {
+    iree_task_poller_t* poller, iree_task_wait_t* task) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   iree_status_t status = iree_ok_status();
@@ -198,7 +239,12 @@ static iree_status_t iree_task_poller_insert_wait_handle(
   }
 
   if (iree_status_is_ok(status)) {
-    status = iree_wait_set_insert(wait_set, wait_handle);
+    status = iree_wait_set_insert(poller->wait_set, wait_handle);
+    if (iree_status_is_resource_exhausted(status)) {
+      // The grown set is rebuilt from the wait list and includes |task|.
+      iree_status_ignore(status);
+      status = iree_task_poller_grow_wait_set(poller);
+    }
   }
 
   IREE_TRACE_ZONE_END(z0);
@@ -271,6 +317,15 @@ static iree_task_poller_prepare_result_t iree_task_poller_prepare_task(
     IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, now_ns);
     if (task->deadline_ns <= now_ns) {
       wait_status_code = IREE_STATUS_DEADLINE_EXCEEDED;
+    } else if (iree_all_bits_set(task->header.flags,
+                                 IREE_TASK_FLAG_WAIT_EXPORTED) &&
+               !poller->query_exported_waits) {
+      // Already in the wait set; the completed bit will be set when the system
+      // wait reports the handle as signaled so there's no need to make one
+      // query syscall per handle on each pump. Wait handles are level
+      // triggered and signaled handles not reported by a wake will be
+      // reported by the next system wait.
+      wait_status_code = IREE_STATUS_DEFERRED;
     } else {
       // Query the status of the wait source to see if it has already been
       // resolved. Under load we can get lucky and end up with resolved waits
@@ -279,10 +334,6 @@ static iree_task_poller_prepare_result_t iree_task_poller_prepare_task(
       // as when the source is a process-local type.
       wait_status_code = IREE_STATUS_OK;
       status = iree_wait_source_query(task->wait_source, &wait_status_code);
-
-      // TODO(benvanik): avoid this query for wait handles: we don't want to
-      // make one syscall per handle and could rely on the completed bit being
-      // set to retire these.
     }
 
     // If the wait has not been resolved then we need to ensure there's an
@@ -292,7 +343,7 @@ static iree_task_poller_prepare_result_t iree_task_poller_prepare_task(
       if (!iree_all_bits_set(task->header.flags,
                              IREE_TASK_FLAG_WAIT_EXPORTED)) {
         task->header.flags |= IREE_TASK_FLAG_WAIT_EXPORTED;
-        status = iree_task_poller_insert_wait_handle(poller->wait_set, task);
+        status = iree_task_poller_insert_wait_handle(poller, task);
       }
       *earliest_deadline_ns =
           iree_min(*earliest_deadline_ns, task->deadline_ns);
@@ -412,14 +463,25 @@ static void iree_task_poller_wake_task(iree_task_poller_t* poller,
                                        iree_wait_handle_t wake_handle) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // TODO(benvanik): scan the list. We need a way to map wake_handle back to
-  // the zero or more tasks that match it but don't currently store the
-  // handle. Ideally we'd have the wait set tell us precisely which things
-  // woke - possibly by having a bitmap of original insertions that match the
-  // handle - but for now we just eat the extra query syscall.
+  // Multiple tasks may be waiting on the same handle (such as when joining on
+  // a semaphore) and all of them are marked. Tasks are retired on the next
+  // scan.
   int woken_tasks = 0;
+  for (iree_task_t* task = iree_task_list_front(&poller->wait_list);
+       task != NULL; task = task->next_task) {
+    if (!iree_all_bits_set(task->flags, IREE_TASK_FLAG_WAIT_EXPORTED)) {
+      continue;
+    }
+    iree_wait_handle_t* wait_handle =
+        iree_wait_handle_from_source(&((iree_task_wait_t*)task)->wait_source);
+    if (wait_handle && wait_handle->type == wake_handle.type &&
+        memcmp(&wait_handle->value, &wake_handle.value,
+               sizeof(wake_handle.value)) == 0) {
+      task->flags |= IREE_TASK_FLAG_WAIT_COMPLETED;
+      ++woken_tasks;
+    }
+  }
 
-  (void)woken_tasks;
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, woken_tasks);
   IREE_TRACE_ZONE_END(z0);
 }
@@ -447,8 +509,8 @@ static void iree_task_poller_commit_wait(iree_task_poller_t* poller,
     //
     // To avoid extra syscalls we scan the list and mark whatever tasks were
     // using the handle the wait set reported waking as completed. On the next
-    // scan they'll be retired immediately. Ideally we'd have the wait set be
-    // able to tell us this precise list.
+    // scan they'll be retired immediately; exported tasks are not otherwise
+    // queried.
     if (iree_wait_handle_is_immediate(wake_handle)) {
       // No-op wait - ignore.
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "nop");
@@ -456,7 +518,10 @@ static void iree_task_poller_commit_wait(iree_task_poller_t* poller,
                memcmp(&wake_handle.value, &poller->wake_event.value,
                       sizeof(wake_handle.value)) == 0) {
       // Woken on the wake_event used to exit the system wait early.
+      // Other handles may have been signaled but not reported and we query
+      // them all on the next scan so that frequent enqueues can't starve them.
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "wake_event");
+      poller->query_exported_waits = true;
     } else {
       // Route to zero or more tasks using this handle.
       IREE_TRACE_ZONE_APPEND_TEXT(z0, "task(s)");
@@ -475,6 +540,7 @@ static void iree_task_poller_commit_wait(iree_task_poller_t* poller,
     // worse - user code/other processes/drivers/etc may expect them to
     // complete.
     IREE_TRACE_ZONE_APPEND_TEXT(z0, "failure");
+    poller->query_exported_waits = true;
     IREE_ASSERT_TRUE(iree_status_is_ok(status));
     iree_status_ignore(status);
   }
@@ -509,6 +575,7 @@ static void iree_task_poller_pump_until_exit(iree_task_poller_t* poller) {
     iree_time_t earliest_deadline_ns = IREE_TIME_INFINITE_FUTURE;
     iree_task_poller_prepare_wait(poller, &pending_submission,
                                   &earliest_deadline_ns);
+    poller->query_exported_waits = false;
     if (!iree_task_submission_is_empty(&pending_submission)) {
       iree_task_executor_submit(poller->executor, &pending_submission);
       iree_task_executor_flush(poller->executor);
@@ -102,6 +102,12 @@ typedef struct {
   // This may only contain a subset of the wait_list in cases where some of
   // the wait tasks do not have full system handles.
   iree_wait_set_t* wait_set;
+  // Capacity of |wait_set|, doubled each time the set is exhausted.
+  iree_host_size_t wait_set_capacity;
+
+  // True if the next scan must query exported wait handles instead of relying
+  // on the system wait to report them. Managed by the wait thread.
+  bool query_exported_waits;
 } iree_task_poller_t;
 
 // Initializes |out_poller| with a new poller.
@@ -28,6 +28,47 @@
 // bumps us into the next power of two bucket.
 #define IREE_TASK_POOL_MIN_GROWTH_CAPACITY (255)
 
+// Number of tasks held by each magazine of an iree_task_pool_cache_t. Caches
+// hold at most two magazines of tasks and refill/flush one at a time.
+#define IREE_TASK_POOL_CACHE_MAGAZINE_CAPACITY (32)
+
+// Pool caches require thread-local storage to intercept acquire/release calls.
+#if IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+#define IREE_TASK_POOL_HAS_THREAD_CACHE 1
+#define iree_task_pool_thread_local
+#elif defined(__STDC_VERSION__) && (__STDC_VERSION__ >= 201102L) && \
+    !__STDC_NO_THREADS__
+#define IREE_TASK_POOL_HAS_THREAD_CACHE 1
+#define iree_task_pool_thread_local _Thread_local
+#elif defined(IREE_COMPILER_MSVC)
+#define IREE_TASK_POOL_HAS_THREAD_CACHE 1
+#define iree_task_pool_thread_local __declspec(thread)
+#else
+#define IREE_TASK_POOL_HAS_THREAD_CACHE 0
+#endif  // IREE_SYNCHRONIZATION_DISABLE_UNSAFE
+
+#if IREE_TASK_POOL_HAS_THREAD_CACHE
+// Cache bound to the calling thread with iree_task_pool_cache_bind, if any.
+static iree_task_pool_thread_local iree_task_pool_cache_t*
+    iree_task_pool_bound_cache = NULL;
+#endif  // IREE_TASK_POOL_HAS_THREAD_CACHE
+
+// Returns the cache bound to the calling thread if it caches tasks of |pool|.
+static inline iree_task_pool_cache_t* iree_task_pool_lookup_cache(
+    iree_task_pool_t* pool) {
+#if IREE_TASK_POOL_HAS_THREAD_CACHE
+  iree_task_pool_cache_t* cache = iree_task_pool_bound_cache;
+  return cache && cache->pool == pool ? cache : NULL;
+#else
+  return NULL;
+#endif  // IREE_TASK_POOL_HAS_THREAD_CACHE
+}
+
+static iree_status_t iree_task_pool_cache_acquire(iree_task_pool_cache_t* cache,
+                                                  iree_task_t** out_task);
+static void iree_task_pool_cache_release(iree_task_pool_cache_t* cache,
+                                         iree_task_t* task);
+
 // Grows the task pool by at least |minimum_capacity| on top of its current
 // capacity. The actual number of tasks available may be rounded up to make the
 // allocated blocks more allocator-friendly sizes.
@@ -182,6 +223,10 @@ iree_status_t iree_task_pool_acquire(iree_task_pool_t* pool,
                                      iree_task_t** out_task) {
   if (!pool) return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED);
 
+  // Fast path for threads caching tasks from this pool.
+  iree_task_pool_cache_t* cache = iree_task_pool_lookup_cache(pool);
+  if (cache) return iree_task_pool_cache_acquire(cache, out_task);
+
   // Attempt to acquire a task from the available list.
   iree_task_t* task = iree_atomic_task_slist_pop(&pool->available_slist);
   if (task) {
@@ -233,23 +278,25 @@ iree_status_t iree_task_pool_acquire_many(iree_task_pool_t* pool,
       // Instead of having the slist flush walk the list and give us a tail we
       // do that here: we need to walk the list anyway to partition it.
       iree_task_t* p = acquired_tasks.head;
-      while (count > 0) {
-        p = iree_atomic_task_slist_get_next(p);
-        if (!p) break;
+      acquired_tasks.tail = p;
+      --count;
+      iree_task_t* next = NULL;
+      while (count > 0 && (next = iree_atomic_task_slist_get_next(p))) {
+        p = next;
         acquired_tasks.tail = p;
         --count;
       }
 
       // If we got everything we need then we have to put all of the flushed
       // tasks we didn't use into the leftover list.
-      if (count == 0) {
+      iree_task_t* leftover_head =
+          iree_atomic_task_slist_get_next(acquired_tasks.tail);
+      if (leftover_head) {
         iree_task_list_t acquire_leftovers;
         iree_task_list_initialize(&acquire_leftovers);
-        acquire_leftovers.head =
-            iree_atomic_task_slist_get_next(acquired_tasks.tail);
+        acquire_leftovers.head = leftover_head;
         iree_atomic_task_slist_set_next(acquired_tasks.tail, NULL);
-        p = acquire_leftovers.head;
-        iree_task_t* next;
+        p = leftover_head;
         while ((next = iree_atomic_task_slist_get_next(p))) p = next;
         acquire_leftovers.tail = p;
         iree_task_list_append(&leftover_tasks, &acquire_leftovers);
@@ -287,5 +334,96 @@ iree_status_t iree_task_pool_acquire_many(iree_task_pool_t* pool,
 void iree_task_pool_release(iree_task_pool_t* pool, iree_task_t* task) {
   if (!pool) return;
   IREE_ASSERT_EQ(task->pool, pool);
+  iree_task_pool_cache_t* cache = iree_task_pool_lookup_cache(pool);
+  if (cache) {
+    iree_task_pool_cache_release(cache, task);
+    return;
+  }
   iree_atomic_task_slist_push(&pool->available_slist, task);
 }
+
+//===----------------------------------------------------------------------===//
+// iree_task_pool_cache_t
+//===----------------------------------------------------------------------===//
+
+static void iree_task_pool_magazine_initialize(
+    iree_task_pool_magazine_t* out_magazine) {
+  iree_task_list_initialize(&out_magazine->list);
+  out_magazine->count = 0;
+}
+
+static void iree_task_pool_magazine_swap(iree_task_pool_magazine_t* a,
+                                         iree_task_pool_magazine_t* b) {
+  iree_task_pool_magazine_t temp = *a;
+  *a = *b;
+  *b = temp;
+}
+
+// Returns all tasks in |magazine| to the shared pool lists with a single
+// atomic operation and leaves the magazine empty.
+static void iree_task_pool_magazine_flush(iree_task_pool_t* pool,
+                                          iree_task_pool_magazine_t* magazine) {
+  if (!magazine->count) return;
+  iree_atomic_task_slist_concat(&pool->available_slist, magazine->list.head,
+                                magazine->list.tail);
+  iree_task_pool_magazine_initialize(magazine);
+}
+
+void iree_task_pool_cache_initialize(iree_task_pool_t* pool,
+                                     iree_task_pool_cache_t* out_cache) {
+  out_cache->pool = pool;
+  iree_task_pool_magazine_initialize(&out_cache->loaded);
+  iree_task_pool_magazine_initialize(&out_cache->previous);
+}
+
+void iree_task_pool_cache_deinitialize(iree_task_pool_cache_t* cache) {
+#if IREE_TASK_POOL_HAS_THREAD_CACHE
+  IREE_ASSERT_NE(iree_task_pool_bound_cache, cache);
+#endif  // IREE_TASK_POOL_HAS_THREAD_CACHE
+  iree_task_pool_cache_flush(cache);
+}
+
+void iree_task_pool_cache_flush(iree_task_pool_cache_t* cache) {
+  if (!cache->pool) return;
+  iree_task_pool_magazine_flush(cache->pool, &cache->loaded);
+  iree_task_pool_magazine_flush(cache->pool, &cache->previous);
+}
+
+void iree_task_pool_cache_bind(iree_task_pool_cache_t* cache) {
+#if IREE_TASK_POOL_HAS_THREAD_CACHE
+  iree_task_pool_bound_cache = cache;
+#endif  // IREE_TASK_POOL_HAS_THREAD_CACHE
+}
+
+static iree_status_t iree_task_pool_cache_acquire(iree_task_pool_cache_t* cache,
+                                                  iree_task_t** out_task) {
+  if (IREE_UNLIKELY(!cache->loaded.count)) {
+    if (cache->previous.count) {
+      // Tasks released by this thread are reused before going to the pool.
+      iree_task_pool_magazine_swap(&cache->loaded, &cache->previous);
+    } else {
+      // Both magazines are empty; refill one from the pool in a single batch.
+      IREE_RETURN_IF_ERROR(iree_task_pool_acquire_many(
+          cache->pool, IREE_TASK_POOL_CACHE_MAGAZINE_CAPACITY,
+          &cache->loaded.list));
+      cache->loaded.count = IREE_TASK_POOL_CACHE_MAGAZINE_CAPACITY;
+    }
+  }
+  *out_task = iree_task_list_pop_front(&cache->loaded.list);
+  --cache->loaded.count;
+  return iree_ok_status();
+}
+
+static void iree_task_pool_cache_release(iree_task_pool_cache_t* cache,
+                                         iree_task_t* task) {
+  if (IREE_UNLIKELY(cache->loaded.count ==
+                    IREE_TASK_POOL_CACHE_MAGAZINE_CAPACITY)) {
+    // Keep the full magazine around for reuse and flush the other one (if it
+    // has anything in it) so that acquire/release sequences oscillating around
+    // a magazine boundary don't thrash the pool.
+    iree_task_pool_magazine_flush(cache->pool, &cache->previous);
+    iree_task_pool_magazine_swap(&cache->loaded, &cache->previous);
+  }
+  iree_task_list_push_front(&cache->loaded.list, task);
+  ++cache->loaded.count;
+}
@@ -88,7 +88,8 @@ void iree_task_pool_deinitialize(iree_task_pool_t* pool);
 void iree_task_pool_trim(iree_task_pool_t* pool);
 
 // Acquires a task from the task pool. The returned task will have undefined
-// contents and must be initialized by the caller.
+// contents and must be initialized by the caller. Served from the calling
+// thread cache if one is bound to the pool.
 iree_status_t iree_task_pool_acquire(iree_task_pool_t* pool,
                                      iree_task_t** out_task);
 
@@ -105,9 +106,62 @@ iree_status_t iree_task_pool_acquire_many(iree_task_pool_t* pool,
                                           iree_task_list_t* out_list);
 
 // Releases a task to the task pool.
-// Callers must ensure the task is no longer in use.
+// Callers must ensure the task is no longer in use. Released to the calling
+// thread cache if one is bound to the pool.
 void iree_task_pool_release(iree_task_pool_t* pool, iree_task_t* task);
 
+//===----------------------------------------------------------------------===//
+// iree_task_pool_cache_t
+//===----------------------------------------------------------------------===//
+
+// A fixed-size stack of free tasks owned by a pool cache.
+typedef struct iree_task_pool_magazine_t {
+  iree_task_list_t list;
+  iree_host_size_t count;
+} iree_task_pool_magazine_t;
+
+// Per-thread cache of free tasks placed in front of a shared task pool.
+//
+// Tasks acquired from and released to the pool on a thread with a bound cache
+// are served from a pair of thread-local magazines and only touch the pool
+// shared lists when a whole magazine needs to be refilled or flushed. This
+// keeps the pool slist head from bouncing between cores when one thread (such
+// as a worker acting as the coordinator) is acquiring dispatch shards while
+// other threads are retiring them.
+//
+// Caches only hold tasks from the single pool they are initialized with and
+// tasks from other pools pass through to their pool unchanged. Tasks cached by
+// a thread are unavailable to other threads until flushed and threads should
+// flush their cache prior to idling for long periods of time.
+//
+// Thread-compatible: caches must only be used by the thread they are bound to.
+typedef struct iree_task_pool_cache_t {
+  // Pool the cached tasks are acquired from and released to.
+  iree_task_pool_t* pool;
+  // Magazine tasks are popped from and pushed to.
+  iree_task_pool_magazine_t loaded;
+  // Full or empty magazine swapped with |loaded| when it runs out.
+  iree_task_pool_magazine_t previous;
+} iree_task_pool_cache_t;
+
+// Initializes an empty cache in front of |pool|.
+void iree_task_pool_cache_initialize(iree_task_pool_t* pool,
+                                     iree_task_pool_cache_t* out_cache);
+
+// Flushes all cached tasks back to the pool and deinitializes the cache.
+// The cache must not be bound to any thread.
+void iree_task_pool_cache_deinitialize(iree_task_pool_cache_t* cache);
+
+// Returns all cached tasks back to the pool so that other threads can acquire
+// them. Must be called from the thread the cache is bound to, if any.
+void iree_task_pool_cache_flush(iree_task_pool_cache_t* cache);
+
+// Binds |cache| to the calling thread such that iree_task_pool_acquire and
+// iree_task_pool_release with the cache pool are routed through the cache.
+// Passing NULL unbinds any bound cache. Caches must be unbound before they are
+// deinitialized. A no-op on platforms without thread-local storage.
+void iree_task_pool_cache_bind(iree_task_pool_cache_t* cache);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -7,6 +7,7 @@
 #include "iree/task/pool.h"
 
 #include <cstdint>
+#include <set>
 
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
@@ -89,4 +90,70 @@ TEST(PoolTest, Trim) {
   iree_task_pool_deinitialize(&pool);
 }
 
+TEST(PoolTest, AcquireMany) {
+  iree_task_pool_t pool;
+  IREE_ASSERT_OK(iree_task_pool_initialize(iree_allocator_system(),
+                                           sizeof(iree_test_task_t), 2, &pool));
+
+  // Acquire more tasks than are available to force growth.
+  iree_task_list_t list;
+  IREE_ASSERT_OK(iree_task_pool_acquire_many(&pool, 5, &list));
+  iree_host_size_t count = 0;
+  for (iree_task_t* task = list.head; task; task = task->next_task) {
+    EXPECT_EQ(task->pool, &pool);
+    ++count;
+  }
+  EXPECT_EQ(count, 5);
+
+  // Acquire exactly as many as the pool had left over.
+  iree_task_list_t more_list;
+  IREE_ASSERT_OK(iree_task_pool_acquire_many(&pool, 1, &more_list));
+  EXPECT_EQ(more_list.head, more_list.tail);
+  ASSERT_NE(more_list.head, nullptr);
+
+  iree_task_t* task = NULL;
+  while ((task = iree_task_list_pop_front(&list))) {
+    iree_task_pool_release(&pool, task);
+  }
+  iree_task_pool_release(&pool, more_list.head);
+  iree_task_pool_deinitialize(&pool);
+}
+
+TEST(PoolTest, CachedAcquireRelease) {
+  iree_task_pool_t pool;
+  IREE_ASSERT_OK(iree_task_pool_initialize(iree_allocator_system(),
+                                           sizeof(iree_test_task_t), 2, &pool));
+  iree_task_pool_cache_t cache;
+  iree_task_pool_cache_initialize(&pool, &cache);
+  iree_task_pool_cache_bind(&cache);
+
+  // Acquire and release enough tasks to cycle through multiple magazines while
+  // ensuring the same task is never handed out twice.
+  iree_test_task_t* tasks[100] = {NULL};
+  for (int round = 0; round < 2; ++round) {
+    std::set<iree_test_task_t*> unique_tasks;
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+      IREE_ASSERT_OK(iree_task_pool_acquire(&pool, (iree_task_t**)&tasks[i]));
+      EXPECT_TRUE(unique_tasks.insert(tasks[i]).second);
+    }
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+      iree_task_pool_release(&pool, (iree_task_t*)tasks[i]);
+    }
+  }
+
+  // Flush the cache and ensure all tasks made it back to the pool.
+  iree_task_pool_cache_bind(NULL);
+  iree_task_pool_cache_deinitialize(&cache);
+  std::set<iree_test_task_t*> unique_tasks;
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+    IREE_ASSERT_OK(iree_task_pool_acquire(&pool, (iree_task_t**)&tasks[i]));
+    EXPECT_TRUE(unique_tasks.insert(tasks[i]).second);
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(tasks); ++i) {
+    iree_task_pool_release(&pool, (iree_task_t*)tasks[i]);
+  }
+
+  iree_task_pool_deinitialize(&pool);
+}
+
 }  // namespace
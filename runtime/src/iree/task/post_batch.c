@@ -22,6 +22,7 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
   out_post_batch->executor = executor;
   out_post_batch->current_worker = current_worker;
   out_post_batch->worker_pending_mask = 0;
+  out_post_batch->peer_wake_count = 0;
   memset(&out_post_batch->worker_pending_lifos, 0,
          executor->worker_count * sizeof(iree_task_list_t));
 }
@@ -31,6 +32,28 @@ iree_host_size_t iree_task_post_batch_worker_count(
   return post_batch->executor->worker_count;
 }
 
+iree_host_size_t iree_task_post_batch_shard_capacity(
+    const iree_task_post_batch_t* post_batch) {
+  iree_task_executor_t* executor = post_batch->executor;
+  if (!iree_task_executor_has_peers(executor)) return executor->worker_count;
+  return executor->worker_count + executor->peer_worker_count;
+}
+
+iree_task_affinity_set_t iree_task_post_batch_scope_worker_mask(
+    const iree_task_post_batch_t* post_batch, const iree_task_scope_t* scope) {
+  return iree_task_executor_scope_worker_mask(post_batch->executor, scope);
+}
+
+uint32_t iree_task_post_batch_worker_compute_capacity(
+    const iree_task_post_batch_t* post_batch, iree_host_size_t worker_index) {
+  return post_batch->executor->workers[worker_index].compute_capacity;
+}
+
+void iree_task_post_batch_wake_peers(iree_task_post_batch_t* post_batch,
+                                     iree_host_size_t wake_count) {
+  post_batch->peer_wake_count += wake_count;
+}
+
 static iree_host_size_t iree_task_post_batch_select_random_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set) {
   // The masks are accessed with 'relaxed' order because they are just hints.
@@ -87,6 +110,8 @@ iree_host_size_t iree_task_post_batch_select_worker(
 void iree_task_post_batch_enqueue(iree_task_post_batch_t* post_batch,
                                   iree_host_size_t worker_index,
                                   iree_task_t* task) {
+  iree_task_executor_mark_priority(post_batch->executor,
+                                   iree_task_scope_priority(task->scope));
   iree_task_list_push_front(&post_batch->worker_pending_lifos[worker_index],
                             task);
   post_batch->worker_pending_mask |=
@@ -132,6 +157,14 @@ bool iree_task_post_batch_submit(iree_task_post_batch_t* post_batch) {
 
   IREE_TRACE_ZONE_BEGIN(z0);
 
+  // Wake peers first so that they have a head start on the theft; by the time
+  // they are running the tasks will have been posted to our workers.
+  if (post_batch->peer_wake_count > 0) {
+    iree_task_executor_wake_idle_peers(post_batch->executor,
+                                       post_batch->peer_wake_count);
+    post_batch->peer_wake_count = 0;
+  }
+
   // Run through each worker that has a bit set in the pending mask and post
   // the pending tasks.
   iree_task_affinity_set_t worker_mask = post_batch->worker_pending_mask;
@@ -153,8 +186,7 @@ bool iree_task_post_batch_submit(iree_task_post_batch_t* post_batch) {
       // role of coordinator and we want to ensure we aren't doing a fully
       // block-and-flush loop when we could just be popping the next new task
       // off the list.
-      iree_task_queue_append_from_lifo_list_unsafe(&worker->local_task_queue,
-                                                   target_pending_lifo);
+      iree_task_worker_append_local_tasks(worker, target_pending_lifo);
     } else {
       iree_task_worker_post_tasks(worker, target_pending_lifo);
       worker_wake_mask |= iree_task_affinity_for_worker(target_index);
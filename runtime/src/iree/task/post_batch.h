@@ -39,6 +39,10 @@ typedef struct iree_task_post_batch_t {
   // Used to quickly scan the lists and perform the posts only when required.
   iree_task_affinity_set_t worker_pending_mask;
 
+  // Number of idle workers in linked peer executors that should be woken upon
+  // submission to help steal the posted work.
+  iree_host_size_t peer_wake_count;
+
   // A per-worker LIFO task list waiting to be posted.
   iree_task_list_t worker_pending_lifos[0];
 } iree_task_post_batch_t;
@@ -51,6 +55,25 @@ void iree_task_post_batch_initialize(iree_task_executor_t* executor,
 iree_host_size_t iree_task_post_batch_worker_count(
     const iree_task_post_batch_t* post_batch);
 
+// Returns the total number of workers that may execute tasks posted through
+// the batch, including those of linked peer executors that may steal them.
+iree_host_size_t iree_task_post_batch_shard_capacity(
+    const iree_task_post_batch_t* post_batch);
+
+// Returns the workers that tasks in |scope| may be posted to.
+iree_task_affinity_set_t iree_task_post_batch_scope_worker_mask(
+    const iree_task_post_batch_t* post_batch, const iree_task_scope_t* scope);
+
+// Returns the relative compute capacity of the worker at |worker_index| in the
+// range [1, IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE].
+uint32_t iree_task_post_batch_worker_compute_capacity(
+    const iree_task_post_batch_t* post_batch, iree_host_size_t worker_index);
+
+// Requests that up to |wake_count| idle workers in linked peer executors be
+// woken when the batch is submitted. No-op if the executor has no peers.
+void iree_task_post_batch_wake_peers(iree_task_post_batch_t* post_batch,
+                                     iree_host_size_t wake_count);
+
 // Selects a random worker from the given affinity set.
 iree_host_size_t iree_task_post_batch_select_worker(
     iree_task_post_batch_t* post_batch, iree_task_affinity_set_t affinity_set);
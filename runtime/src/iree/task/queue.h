@@ -135,6 +135,12 @@ void iree_task_queue_push_front(iree_task_queue_t* queue, iree_task_t* task);
 void iree_task_queue_append_from_lifo_list_unsafe(iree_task_queue_t* queue,
                                                   iree_task_list_t* list);
 
+// Appends a FIFO |list| of tasks to the queue.
+//
+// Must only be called from the owning worker's thread.
+void iree_task_queue_append_from_fifo_list_unsafe(iree_task_queue_t* queue,
+                                                  iree_task_list_t* list);
+
 // Flushes the |source_slist| LIFO mailbox into the task queue in FIFO order.
 // Returns the first task in the queue upon success; the task may be
 // pre-existing or from the newly flushed tasks.
@@ -28,6 +28,25 @@ enum iree_task_scope_flag_bits_e {
 };
 typedef uint32_t iree_task_scope_flags_t;
 
+// Quality-of-service class of the tasks within a scope.
+// Workers drain tasks of higher priority classes before those of lower ones and
+// thieves will only steal lower priority tasks if they are unable to find any
+// of higher priority. This allows latency-sensitive work to share an executor
+// with long-running batch work without being starved. Note that tasks already
+// executing are not preempted: a large low priority dispatch will only yield
+// its workers as each tile reservation completes.
+typedef enum iree_task_scope_priority_e {
+  // Batch/background work that can tolerate additional latency.
+  IREE_TASK_SCOPE_PRIORITY_LOW = 0,
+  // Default priority for all scopes.
+  IREE_TASK_SCOPE_PRIORITY_NORMAL = 1,
+  // Latency-sensitive/interactive work.
+  IREE_TASK_SCOPE_PRIORITY_HIGH = 2,
+} iree_task_scope_priority_t;
+
+// Total number of iree_task_scope_priority_t classes.
+#define IREE_TASK_SCOPE_PRIORITY_COUNT 3
+
 // iree_task_scope_t is an atomic reference-counting helper posting a
 // notification when the reference count is decremended to 0.
 //
@@ -60,6 +79,15 @@ typedef struct iree_task_scope_t {
   // Flags controlling optional scope behavior.
   iree_task_scope_flags_t flags;
 
+  // Quality-of-service class of all tasks in the scope.
+  iree_task_scope_priority_t priority;
+
+  // Workers within each executor that may execute tasks from the scope.
+  // Tasks will only be posted to workers in the mask and workers not in the
+  // mask that steal the tasks will forward them back. Allows for a set of
+  // workers to be reserved for other scopes.
+  iree_task_affinity_set_t worker_mask;
+
   // Base color used for tasks in this scope.
   // The color will be modulated based on task type.
   IREE_TRACE(uint32_t task_trace_color;)
@@ -101,6 +129,31 @@ void iree_task_scope_deinitialize(iree_task_scope_t* scope);
 // string.
 iree_string_view_t iree_task_scope_name(iree_task_scope_t* scope);
 
+// Sets the quality-of-service class of all tasks in the scope.
+// Must be called before any tasks in the scope are submitted.
+void iree_task_scope_set_priority(iree_task_scope_t* scope,
+                                  iree_task_scope_priority_t priority);
+
+// Returns the quality-of-service class of all tasks in |scope| or
+// IREE_TASK_SCOPE_PRIORITY_NORMAL if no scope is provided.
+static inline iree_task_scope_priority_t iree_task_scope_priority(
+    const iree_task_scope_t* scope) {
+  return scope ? scope->priority : IREE_TASK_SCOPE_PRIORITY_NORMAL;
+}
+
+// Sets the |worker_mask| of workers (within each executor) that may execute
+// tasks in the scope. An empty mask allows any worker. Must be called
+// before any tasks in the scope are submitted.
+void iree_task_scope_set_worker_mask(iree_task_scope_t* scope,
+                                     iree_task_affinity_set_t worker_mask);
+
+// Returns the mask of workers that may execute tasks in |scope| or all workers
+// if no scope is provided.
+static inline iree_task_affinity_set_t iree_task_scope_worker_mask(
+    const iree_task_scope_t* scope) {
+  return scope ? scope->worker_mask : iree_task_affinity_for_any_worker();
+}
+
 // Returns and resets the statistics for the scope.
 // Statistics may experience tearing (non-atomic update across fields) if this
 // is performed while tasks are in-flight.
@@ -9,6 +9,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "iree/base/internal/threading.h"
 #include "iree/task/list.h"
 #include "iree/task/pool.h"
 #include "iree/task/post_batch.h"
@@ -512,10 +513,64 @@ static uint32_t iree_task_tile_to_color(
 
 #endif  // IREE_TASK_TRACING_PER_TILE_COLORS
 
+#if IREE_STATISTICS_ENABLE
+
+// Updates |target| to be the minimum non-zero value of itself and |value|.
+static void iree_task_dispatch_statistics_merge_min(
+    int32_t value, iree_atomic_int32_t* target) {
+  if (!value) return;
+  int32_t current = iree_atomic_load_int32(target, iree_memory_order_relaxed);
+  while (!current || value < current) {
+    if (iree_atomic_compare_exchange_weak_int32(target, &current, value,
+                                                iree_memory_order_relaxed,
+                                                iree_memory_order_relaxed)) {
+      break;
+    }
+  }
+}
+
+// Updates |target| to be the maximum value of itself and |value|.
+static void iree_task_dispatch_statistics_merge_max(
+    int32_t value, iree_atomic_int32_t* target) {
+  int32_t current = iree_atomic_load_int32(target, iree_memory_order_relaxed);
+  while (value > current) {
+    if (iree_atomic_compare_exchange_weak_int32(target, &current, value,
+                                                iree_memory_order_relaxed,
+                                                iree_memory_order_relaxed)) {
+      break;
+    }
+  }
+}
+
+#endif  // IREE_STATISTICS_ENABLE
+
 void iree_task_dispatch_statistics_merge(
     const iree_task_dispatch_statistics_t* source,
     iree_task_dispatch_statistics_t* target) {
-  // TODO(benvanik): statistics.
+#if IREE_STATISTICS_ENABLE
+  // The source is owned by the caller and is not concurrently modified but the
+  // atomic loads require a non-const pointer.
+  iree_task_dispatch_statistics_t* mutable_source =
+      (iree_task_dispatch_statistics_t*)source;
+  const int32_t reservation_count = iree_atomic_load_int32(
+      &mutable_source->reservation_count, iree_memory_order_relaxed);
+  if (!reservation_count) return;
+  iree_atomic_fetch_add_int32(&target->reservation_count, reservation_count,
+                              iree_memory_order_relaxed);
+  iree_atomic_fetch_add_int32(
+      &target->reserved_tile_count,
+      iree_atomic_load_int32(&mutable_source->reserved_tile_count,
+                             iree_memory_order_relaxed),
+      iree_memory_order_relaxed);
+  iree_task_dispatch_statistics_merge_min(
+      iree_atomic_load_int32(&mutable_source->min_tiles_per_reservation,
+                             iree_memory_order_relaxed),
+      &target->min_tiles_per_reservation);
+  iree_task_dispatch_statistics_merge_max(
+      iree_atomic_load_int32(&mutable_source->max_tiles_per_reservation,
+                             iree_memory_order_relaxed),
+      &target->max_tiles_per_reservation);
+#endif  // IREE_STATISTICS_ENABLE
 }
 
 //==============================================================================
@@ -532,6 +587,9 @@ static void iree_task_dispatch_initialize_base(
   out_task->local_memory_size = 0;
   iree_atomic_store_intptr(&out_task->status, 0, iree_memory_order_release);
   memset(&out_task->statistics, 0, sizeof(out_task->statistics));
+  out_task->tile_consumer = NULL;
+  out_task->tile_producer = NULL;
+  out_task->tile_completions = NULL;
 
   IREE_TRACE({
     static iree_atomic_int64_t next_dispatch_id = IREE_ATOMIC_VAR_INIT(0);
@@ -559,6 +617,32 @@ void iree_task_dispatch_initialize_indirect(
   out_task->workgroup_count.ptr = workgroup_count_ptr;
 }
 
+void iree_task_dispatch_set_tile_consumer(iree_task_dispatch_t* producer_task,
+                                          iree_atomic_int32_t* tile_completions,
+                                          iree_task_dispatch_t* consumer_task) {
+  IREE_ASSERT(!iree_any_bit_set(producer_task->header.flags,
+                                IREE_TASK_FLAG_DISPATCH_INDIRECT));
+  IREE_ASSERT(!iree_any_bit_set(consumer_task->header.flags,
+                                IREE_TASK_FLAG_DISPATCH_INDIRECT));
+  IREE_ASSERT(memcmp(producer_task->workgroup_count.value,
+                     consumer_task->workgroup_count.value,
+                     sizeof(producer_task->workgroup_count.value)) == 0);
+  IREE_ASSERT(!producer_task->tile_consumer && !consumer_task->tile_producer);
+  producer_task->tile_consumer = consumer_task;
+  producer_task->tile_completions = tile_completions;
+  consumer_task->tile_producer = producer_task;
+}
+
+// Returns the index of the next worker in |worker_mask| after |worker_index|,
+// wrapping around to the first worker in the mask.
+static iree_host_size_t iree_task_dispatch_next_shard_worker(
+    iree_task_affinity_set_t worker_mask, iree_host_size_t worker_index) {
+  iree_task_affinity_set_t next_worker_mask =
+      worker_mask & ~iree_task_affinity_set_ones(worker_index + 1);
+  return iree_task_affinity_set_count_trailing_zeros(
+      next_worker_mask ? next_worker_mask : worker_mask);
+}
+
 void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
                               iree_task_pool_t* shard_task_pool,
                               iree_task_submission_t* pending_submission,
@@ -602,38 +686,108 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   dispatch_task->tile_count =
       workgroup_count[0] * workgroup_count[1] * workgroup_count[2];
 
-  // Compute shard count - almost always worker_count unless we are a very small
-  // dispatch (1x1x1, etc).
+  // Shards are only issued to the workers reserved by the scope (by default
+  // all of them).
   iree_host_size_t worker_count = iree_task_post_batch_worker_count(post_batch);
+  const iree_task_affinity_set_t all_worker_mask =
+      iree_task_affinity_set_ones(worker_count);
+  iree_task_affinity_set_t shard_worker_mask =
+      iree_task_post_batch_scope_worker_mask(post_batch,
+                                             dispatch_task->header.scope) &
+      all_worker_mask;
+  if (!shard_worker_mask) shard_worker_mask = all_worker_mask;
+
+  // Compute shard count - almost always worker_count unless we are a very small
+  // dispatch (1x1x1, etc) or have been reserved a subset of workers. If the
+  // executor is linked with peers we produce enough shards for their workers
+  // to steal as well.
+  iree_host_size_t shard_capacity =
+      shard_worker_mask == all_worker_mask
+          ? iree_task_post_batch_shard_capacity(post_batch)
+          : iree_task_affinity_set_count_ones(shard_worker_mask);
   iree_host_size_t shard_count =
-      iree_min(dispatch_task->tile_count, worker_count);
+      iree_min(dispatch_task->tile_count, shard_capacity);
+  if (shard_count > worker_count) {
+    iree_task_post_batch_wake_peers(post_batch, shard_count - worker_count);
+  }
 
   // Compute how many tiles we want each shard to reserve at a time from the
   // larger grid. A higher number reduces overhead and improves locality while
   // a lower number reduces maximum worst-case latency (coarser work stealing).
-  if (dispatch_task->tile_count <
-      worker_count * IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION) {
-    // Grid is small - allow it to be eagerly sliced up.
-    dispatch_task->tiles_per_reservation = 1;
-  } else {
-    dispatch_task->tiles_per_reservation =
-        IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+  // Reservations are sized from the remaining tiles such that they start large
+  // and shrink as the grid drains (guided self-scheduling); small grids will
+  // be eagerly sliced up one tile at a time.
+  dispatch_task->tiles_per_reservation =
+      IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION;
+  dispatch_task->reservation_divisor =
+      (uint32_t)iree_max(1, shard_count) *
+      IREE_TASK_DISPATCH_GUIDED_RESERVATION_FACTOR;
+
+  // Issue the pipelined consumer (if any) now that the tiles are ready to be
+  // reserved. The consumer retires into this dispatch so that this dispatch
+  // only retires once both have completed and anything depending on it will
+  // also observe the results of the consumer.
+  iree_task_dispatch_t* consumer_task = dispatch_task->tile_consumer;
+  if (consumer_task) {
+    iree_task_set_completion_task(&consumer_task->header,
+                                  &dispatch_task->header);
+    iree_task_dispatch_issue(consumer_task, shard_task_pool,
+                             pending_submission, post_batch);
   }
 
-  // Randomize starting worker.
-  iree_host_size_t worker_offset = iree_task_post_batch_select_worker(
-      post_batch, dispatch_task->header.affinity_set);
-  iree_host_size_t worker_index = worker_offset;
+  // Pipelined consumers may execute tiles of this dispatch through the shared
+  // tile_index and statically partitioning the tiles would run them twice.
+  if (consumer_task) {
+    dispatch_task->header.flags &= ~IREE_TASK_FLAG_DISPATCH_LOCALITY;
+  }
+  const bool is_locality_preserving = iree_all_bits_set(
+      dispatch_task->header.flags, IREE_TASK_FLAG_DISPATCH_LOCALITY);
+
+  // Randomize starting worker unless preserving locality in which case we
+  // always start from the first worker so that the same workers get the same
+  // tile ranges across dispatches.
+  iree_task_affinity_set_t start_affinity_set =
+      dispatch_task->header.affinity_set & shard_worker_mask;
+  if (!start_affinity_set) start_affinity_set = shard_worker_mask;
+  iree_host_size_t worker_index =
+      is_locality_preserving
+          ? iree_task_affinity_set_count_trailing_zeros(start_affinity_set)
+          : iree_task_post_batch_select_worker(post_batch, start_affinity_set);
+
+  // Statically partitioned shards are sized by the compute capacity of the
+  // worker they are posted to such that on heterogeneous systems shards on
+  // efficiency cores complete around the same time as those on performance
+  // cores. With homogeneous workers the grid is split evenly.
+  uint64_t total_capacity = 0;
+  if (is_locality_preserving) {
+    iree_host_size_t capacity_worker_index = worker_index;
+    for (iree_host_size_t i = 0; i < shard_count; ++i) {
+      total_capacity += iree_task_post_batch_worker_compute_capacity(
+          post_batch, capacity_worker_index);
+      capacity_worker_index = iree_task_dispatch_next_shard_worker(
+          shard_worker_mask, capacity_worker_index);
+    }
+  }
 
+  uint64_t capacity_base = 0;
   for (iree_host_size_t i = 0; i < shard_count; ++i) {
     // Allocate and initialize the shard.
     iree_task_dispatch_shard_t* shard_task =
         iree_task_dispatch_shard_allocate(dispatch_task, shard_task_pool);
+    if (is_locality_preserving) {
+      shard_task->tile_begin = (uint32_t)(
+          (uint64_t)dispatch_task->tile_count * capacity_base / total_capacity);
+      capacity_base += iree_task_post_batch_worker_compute_capacity(
+          post_batch, worker_index);
+      shard_task->tile_end = (uint32_t)(
+          (uint64_t)dispatch_task->tile_count * capacity_base / total_capacity);
+    }
 
     // Enqueue on the worker selected for the task.
-    iree_task_post_batch_enqueue(post_batch, worker_index % worker_count,
+    iree_task_post_batch_enqueue(post_batch, worker_index,
                                  &shard_task->header);
-    ++worker_index;
+    worker_index =
+        iree_task_dispatch_next_shard_worker(shard_worker_mask, worker_index);
   }
 
   // NOTE: the dispatch is not retired until all shards complete. Upon the last
@@ -642,8 +796,9 @@ void iree_task_dispatch_issue(iree_task_dispatch_t* dispatch_task,
   //
   // The gotcha here is that it's possible for there to be zero shards within
   // a dispatch (if, for example, and indirect dispatch had its workgroup counts
-  // set to zero to prevent it from running). We check for that here.
-  if (shard_count == 0) {
+  // set to zero to prevent it from running). We check for that here. If there
+  // is a consumer it will ready this dispatch for retirement when it retires.
+  if (shard_count == 0 && !consumer_task) {
     iree_task_dispatch_retire(dispatch_task, pending_submission);
   }
 
@@ -655,7 +810,12 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, dispatch_task->dispatch_id);
 
-  // TODO(benvanik): attach statistics to the tracy zone.
+  // TODO(benvanik): attach the remaining statistics to the tracy zone.
+#if IREE_STATISTICS_ENABLE
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(
+      z0, iree_atomic_load_int32(&dispatch_task->statistics.reservation_count,
+                                 iree_memory_order_relaxed));
+#endif  // IREE_STATISTICS_ENABLE
 
   // Merge the statistics from the dispatch into the scope so we can track all
   // of the work without tracking all the dispatches at a global level.
@@ -693,6 +853,8 @@ void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
   iree_task_initialize(IREE_TASK_TYPE_DISPATCH_SHARD,
                        dispatch_task->header.scope, &out_task->header);
   iree_task_set_completion_task(&out_task->header, &dispatch_task->header);
+  out_task->tile_begin = 0;
+  out_task->tile_end = 0;
 }
 
 iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
@@ -709,9 +871,270 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
   return shard_task;
 }
 
+// Reserves the next range of tiles from the dispatch grid starting at
+// |out_tile_base|. Returns the number of tiles reserved, which may extend past
+// the end of the grid, or 0 if the grid has been exhausted.
+//
+// Reservations are scaled by the |compute_capacity| of the reserving worker so
+// that workers on efficiency cores take proportionally smaller slices and the
+// dispatch does not end up waiting on them to finish a large one.
+static uint32_t iree_task_dispatch_reserve_tiles(
+    iree_task_dispatch_t* dispatch_task, uint32_t compute_capacity,
+    uint32_t* out_tile_base) {
+  // relaxed order because we only care about atomic increments, not about
+  // ordering of tile_index accesses w.r.t. other memory accesses.
+  const uint32_t tile_count = dispatch_task->tile_count;
+  uint32_t tile_index = (uint32_t)iree_atomic_load_int32(
+      &dispatch_task->tile_index, iree_memory_order_relaxed);
+  if (tile_index >= tile_count) return 0;
+
+  // Size the reservation based on what remains. Another shard may reserve
+  // tiles between our load and the increment below and our reservation may be
+  // slightly larger than ideal but it's still bounded.
+  uint32_t tiles_per_reservation =
+      (tile_count - tile_index) / dispatch_task->reservation_divisor;
+  tiles_per_reservation = iree_min(tiles_per_reservation,
+                                   dispatch_task->tiles_per_reservation);
+  tiles_per_reservation =
+      (uint32_t)((uint64_t)tiles_per_reservation * compute_capacity /
+                 IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE);
+  tiles_per_reservation = iree_max(1u, tiles_per_reservation);
+
+  *out_tile_base = (uint32_t)iree_atomic_fetch_add_int32(
+      &dispatch_task->tile_index, (int32_t)tiles_per_reservation,
+      iree_memory_order_relaxed);
+  return *out_tile_base < tile_count ? tiles_per_reservation : 0;
+}
+
+#if IREE_STATISTICS_ENABLE
+// Records a reservation of |tile_count| tiles in shard-local |statistics|.
+static void iree_task_dispatch_statistics_record_reservation(
+    uint32_t tile_count, iree_task_dispatch_statistics_t* statistics) {
+  // Shard-local and not shared so no need for read-modify-write operations.
+  iree_atomic_store_int32(&statistics->reservation_count,
+                          iree_atomic_load_int32(&statistics->reservation_count,
+                                                 iree_memory_order_relaxed) +
+                              1,
+                          iree_memory_order_relaxed);
+  iree_atomic_store_int32(
+      &statistics->reserved_tile_count,
+      iree_atomic_load_int32(&statistics->reserved_tile_count,
+                             iree_memory_order_relaxed) +
+          (int32_t)tile_count,
+      iree_memory_order_relaxed);
+  iree_task_dispatch_statistics_merge_min(
+      (int32_t)tile_count, &statistics->min_tiles_per_reservation);
+  iree_task_dispatch_statistics_merge_max(
+      (int32_t)tile_count, &statistics->max_tiles_per_reservation);
+}
+#endif  // IREE_STATISTICS_ENABLE
+
+iree_host_size_t iree_task_dispatch_shard_local_memory_size(
+    iree_task_dispatch_shard_t* task) {
+  return iree_task_dispatch_shard_parent(task)->local_memory_size;
+}
+
+// Stores the 3D workgroup ID of the linear |tile_index| in |workgroup_count|.
+static inline void iree_task_dispatch_tile_xyz(
+    uint32_t tile_index, const uint32_t workgroup_count[3],
+    uint32_t out_workgroup_xyz[3]) {
+  // TODO(benvanik): faster math here, especially knowing we pull off N
+  // sequential indices per reservation.
+  uint32_t tile_i = tile_index;
+  out_workgroup_xyz[0] = tile_i % workgroup_count[0];
+  tile_i /= workgroup_count[0];
+  out_workgroup_xyz[1] = tile_i % workgroup_count[1];
+  tile_i /= workgroup_count[1];
+  out_workgroup_xyz[2] = tile_i;
+}
+
+// Executes the tile at |tile_index| of |dispatch_task| with |tile_context|
+// and marks it as completed for any pipelined consumer. |next_tile_index| is
+// the tile the worker expects to execute next and is passed to the tile as a
+// hint.
+static iree_status_t iree_task_dispatch_execute_tile(
+    iree_task_dispatch_t* dispatch_task, uint32_t tile_index,
+    uint32_t next_tile_index, iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  iree_task_dispatch_tile_xyz(tile_index, tile_context->workgroup_count,
+                              tile_context->workgroup_xyz);
+  if (next_tile_index == tile_index) {
+    memcpy(tile_context->next_workgroup_xyz, tile_context->workgroup_xyz,
+           sizeof(tile_context->next_workgroup_xyz));
+  } else {
+    iree_task_dispatch_tile_xyz(next_tile_index, tile_context->workgroup_count,
+                                tile_context->next_workgroup_xyz);
+  }
+
+  IREE_TRACE_ZONE_BEGIN_NAMED(z_tile, "iree_task_dispatch_shard_execute_tile");
+  IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(tile_context));
+
+#ifndef NDEBUG
+  // NOTE: these are useful for debugging but dramatically increase our
+  // cost here; only enable if needed for tracking work distribution:
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context->workgroup_xyz[0]);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context->workgroup_xyz[1]);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context->workgroup_xyz[2]);
+  // IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, (uint64_t)task->closure.fn);
+#endif  // !NDEBUG
+
+  iree_status_t status = dispatch_task->closure.fn(
+      dispatch_task->closure.user_context, tile_context, pending_submission);
+
+  IREE_TRACE_ZONE_END(z_tile);
+
+  // Publish the tile results to the consumer waiting on them (if any).
+  if (dispatch_task->tile_completions && iree_status_is_ok(status)) {
+    iree_atomic_store_int32(&dispatch_task->tile_completions[tile_index], 1,
+                            iree_memory_order_release);
+  }
+  return status;
+}
+
+// Waits until the tile at |tile_index| of |producer_task| has completed.
+// While waiting any tiles of the producer not yet reserved by its shards are
+// executed inline: this guarantees progress even if the consumer shards occupy
+// all workers and keeps the waiting worker busy with useful work. Returns false
+// if the producer failed and the tile will never complete.
+static bool iree_task_dispatch_wait_producer_tile(
+    iree_task_dispatch_t* producer_task, uint32_t tile_index,
+    const iree_task_tile_context_t* consumer_tile_context,
+    iree_task_submission_t* pending_submission) {
+  if (IREE_UNLIKELY(tile_index >= producer_task->tile_count)) return true;
+  iree_atomic_int32_t* tile_completion =
+      &producer_task->tile_completions[tile_index];
+  if (iree_atomic_load_int32(tile_completion, iree_memory_order_acquire)) {
+    return true;
+  }
+
+  // Producer tiles are executed with the same worker state but their own
+  // workgroup size. Both dispatches are required to have the same workgroup
+  // count. If the worker doesn't have enough local memory for the producer its
+  // own shards will fail and we'll notice below.
+  iree_task_tile_context_t tile_context = *consumer_tile_context;
+  memcpy(&tile_context.workgroup_size, producer_task->workgroup_size,
+         sizeof(tile_context.workgroup_size));
+  const bool can_execute = producer_task->local_memory_size <=
+                           tile_context.local_memory.data_length;
+
+  do {
+    if (iree_atomic_load_intptr(&producer_task->status,
+                                iree_memory_order_acquire) != 0) {
+      return false;
+    }
+    uint32_t producer_tile_index = producer_task->tile_count;
+    if (can_execute &&
+        (uint32_t)iree_atomic_load_int32(&producer_task->tile_index,
+                                         iree_memory_order_relaxed) <
+            producer_task->tile_count) {
+      producer_tile_index = (uint32_t)iree_atomic_fetch_add_int32(
+          &producer_task->tile_index, 1, iree_memory_order_relaxed);
+    }
+    if (producer_tile_index < producer_task->tile_count) {
+      iree_status_t status = iree_task_dispatch_execute_tile(
+          producer_task, producer_tile_index, producer_tile_index,
+          &tile_context, pending_submission);
+      if (!iree_status_is_ok(status)) {
+        iree_task_try_set_status(&producer_task->status, status);
+        return false;
+      }
+    } else {
+      // All producer tiles are in-flight on other workers.
+      iree_thread_yield();
+    }
+  } while (!iree_atomic_load_int32(tile_completion, iree_memory_order_acquire));
+  return true;
+}
+
+// Executes the tile at |tile_index| of |dispatch_task| from a shard after
+// waiting on its producer tile, if any. Returns false if the shard should bail
+// as the tile or its producer failed.
+static bool iree_task_dispatch_shard_execute_tile(
+    iree_task_dispatch_t* dispatch_task, uint32_t tile_index,
+    uint32_t next_tile_index, iree_task_tile_context_t* tile_context,
+    iree_task_submission_t* pending_submission) {
+  // Pipelined consumers wait for the producer tile they depend on. If the
+  // producer failed it has already propagated the error and we bail.
+  if (dispatch_task->tile_producer &&
+      !iree_task_dispatch_wait_producer_tile(dispatch_task->tile_producer,
+                                             tile_index, tile_context,
+                                             pending_submission)) {
+    return false;
+  }
+
+  iree_status_t status = iree_task_dispatch_execute_tile(
+      dispatch_task, tile_index, next_tile_index, tile_context,
+      pending_submission);
+
+  // If any tile fails we bail early from the loop. This doesn't match
+  // what an accelerator would do but saves some unneeded work.
+  // Note that other shards may have completed execution, be executing
+  // concurrently with this one, or still be pending - this does not
+  // have any influence on them and they may continue to execute even
+  // after we bail from here.
+  if (!iree_status_is_ok(status)) {
+    // Propagate failures to the dispatch task.
+    iree_task_try_set_status(&dispatch_task->status, status);
+    return false;
+  }
+  return true;
+}
+
+// Returns |value| with every other bit starting from bit 0 packed together.
+static inline uint32_t iree_task_compact_even_bits(uint32_t value) {
+  value &= 0x55555555u;
+  value = (value | (value >> 1)) & 0x33333333u;
+  value = (value | (value >> 2)) & 0x0F0F0F0Fu;
+  value = (value | (value >> 4)) & 0x00FF00FFu;
+  value = (value | (value >> 8)) & 0x0000FFFFu;
+  return value;
+}
+
+// Maps |order_index| in the IREE_TASK_FLAG_DISPATCH_LOCALITY traversal order
+// of a grid of |workgroup_count| to the linear tile index.
+//
+// Each XY slice is split into rows of square blocks with the last row and
+// column of blocks possibly partial. Blocks are visited in row-major order and
+// the tiles within full blocks in Z-order (partial blocks in row-major order)
+// such that any contiguous range of the order covers a compact 2D region.
+static uint32_t iree_task_dispatch_locality_tile_index(
+    uint32_t order_index, const uint32_t workgroup_count[3]) {
+  const uint32_t block_size = IREE_TASK_DISPATCH_LOCALITY_BLOCK_SIZE;
+  const uint32_t count_x = workgroup_count[0];
+  const uint32_t count_y = workgroup_count[1];
+  const uint32_t slice_size = count_x * count_y;
+  const uint32_t z = order_index / slice_size;
+  uint32_t i = order_index - z * slice_size;
+
+  // Row of blocks; all prior rows are full height.
+  const uint32_t block_y = i / (block_size * count_x);
+  const uint32_t block_height =
+      iree_min(block_size, count_y - block_y * block_size);
+  i -= block_y * block_size * count_x;
+
+  // Block within the row; all prior blocks are full width.
+  const uint32_t block_x = i / (block_height * block_size);
+  const uint32_t block_width =
+      iree_min(block_size, count_x - block_x * block_size);
+  i -= block_x * block_height * block_size;
+
+  uint32_t x = block_x * block_size;
+  uint32_t y = block_y * block_size;
+  if (block_width == block_size && block_height == block_size) {
+    x += iree_task_compact_even_bits(i);
+    y += iree_task_compact_even_bits(i >> 1);
+  } else {
+    x += i % block_width;
+    y += i / block_width;
+  }
+  return (z * count_y + y) * count_x + x;
+}
+
 void iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
-    uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    uint32_t worker_id, iree_task_topology_node_id_t node_id,
+    const iree_task_topology_caches_t* caches, uint32_t compute_capacity,
+    iree_byte_span_t worker_local_memory,
     iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -743,8 +1166,6 @@ void iree_task_dispatch_shard_execute(
          sizeof(tile_context.workgroup_size));
   memcpy(&tile_context.workgroup_count, dispatch_task->workgroup_count.value,
          sizeof(tile_context.workgroup_count));
-  uint32_t workgroup_count_x = tile_context.workgroup_count[0];
-  uint32_t workgroup_count_y = tile_context.workgroup_count[1];
   tile_context.worker_id = worker_id;
   tile_context.local_memory = worker_local_memory;
 
@@ -757,65 +1178,66 @@ void iree_task_dispatch_shard_execute(
 
   // Hint as to which processor we are running on.
   tile_context.processor_id = processor_id;
-
-  // Loop over all tiles until they are all processed.
-  const uint32_t tile_count = dispatch_task->tile_count;
-  const uint32_t tiles_per_reservation = dispatch_task->tiles_per_reservation;
-  // relaxed order because we only care about atomic increments, not about
-  // ordering of tile_index accesses w.r.t. other memory accesses.
-  uint32_t tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                                   tiles_per_reservation,
-                                                   iree_memory_order_relaxed);
-  while (tile_base < tile_count) {
-    const uint32_t tile_range =
-        iree_min(tile_base + tiles_per_reservation, tile_count);
-    for (uint32_t tile_index = tile_base; tile_index < tile_range;
-         ++tile_index) {
-      // TODO(benvanik): faster math here, especially knowing we pull off N
-      // sequential indices per reservation.
-      uint32_t tile_i = tile_index;
-      tile_context.workgroup_xyz[0] = tile_i % workgroup_count_x;
-      tile_i /= workgroup_count_x;
-      tile_context.workgroup_xyz[1] = tile_i % workgroup_count_y;
-      tile_i /= workgroup_count_y;
-      tile_context.workgroup_xyz[2] = tile_i;
-
-      IREE_TRACE_ZONE_BEGIN_NAMED(z_tile,
-                                  "iree_task_dispatch_shard_execute_tile");
-      IREE_TRACE_ZONE_SET_COLOR(z_tile, iree_task_tile_to_color(&tile_context));
-
-#ifndef NDEBUG
-      // NOTE: these are useful for debugging but dramatically increase our
-      // cost here; only enable if needed for tracking work distribution:
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[0]);
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[1]);
-      IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, tile_context.workgroup_xyz[2]);
-      // IREE_TRACE_ZONE_APPEND_VALUE_I64(z_tile, (uint64_t)task->closure.fn);
-#endif  // !NDEBUG
-
-      iree_status_t status =
-          dispatch_task->closure.fn(dispatch_task->closure.user_context,
-                                    &tile_context, pending_submission);
-
-      IREE_TRACE_ZONE_END(z_tile);
-
-      // If any tile fails we bail early from the loop. This doesn't match
-      // what an accelerator would do but saves some unneeded work.
-      // Note that other shards may have completed execution, be executing
-      // concurrently with this one, or still be pending - this does not
-      // have any influence on them and they may continue to execute even
-      // after we bail from here.
-      if (!iree_status_is_ok(status)) {
-        // Propagate failures to the dispatch task.
-        iree_task_try_set_status(&dispatch_task->status, status);
-        goto abort_shard;  // out of the while-for nest
+  tile_context.node_id = node_id;
+  tile_context.caches = *caches;
+
+  // Locality-preserving dispatches process only the statically assigned range
+  // of the traversal order.
+  if (iree_all_bits_set(dispatch_task->header.flags,
+                        IREE_TASK_FLAG_DISPATCH_LOCALITY)) {
+#if IREE_STATISTICS_ENABLE
+    if (task->tile_end > task->tile_begin) {
+      iree_task_dispatch_statistics_record_reservation(
+          task->tile_end - task->tile_begin, &shard_statistics);
+    }
+#endif  // IREE_STATISTICS_ENABLE
+    uint32_t next_tile_index =
+        task->tile_end > task->tile_begin
+            ? iree_task_dispatch_locality_tile_index(
+                  task->tile_begin, tile_context.workgroup_count)
+            : 0;
+    for (uint32_t order_index = task->tile_begin; order_index < task->tile_end;
+         ++order_index) {
+      const uint32_t tile_index = next_tile_index;
+      if (order_index + 1 < task->tile_end) {
+        next_tile_index = iree_task_dispatch_locality_tile_index(
+            order_index + 1, tile_context.workgroup_count);
+      }
+      if (!iree_task_dispatch_shard_execute_tile(dispatch_task, tile_index,
+                                                 next_tile_index, &tile_context,
+                                                 pending_submission)) {
+        break;
       }
     }
+  } else {
+    // Loop over all tiles until they are all processed.
+    const uint32_t tile_count = dispatch_task->tile_count;
+    uint32_t tile_base = 0;
+    uint32_t tiles_per_reservation = iree_task_dispatch_reserve_tiles(
+        dispatch_task, compute_capacity, &tile_base);
+    while (tiles_per_reservation > 0) {
+      const uint32_t tile_range =
+          iree_min(tile_base + tiles_per_reservation, tile_count);
+#if IREE_STATISTICS_ENABLE
+      iree_task_dispatch_statistics_record_reservation(tile_range - tile_base,
+                                                       &shard_statistics);
+#endif  // IREE_STATISTICS_ENABLE
+      for (uint32_t tile_index = tile_base; tile_index < tile_range;
+           ++tile_index) {
+        // The next reservation is unknown until it is made.
+        const uint32_t next_tile_index =
+            tile_index + 1 < tile_range ? tile_index + 1 : tile_index;
+        if (!iree_task_dispatch_shard_execute_tile(
+                dispatch_task, tile_index, next_tile_index, &tile_context,
+                pending_submission)) {
+          goto abort_shard;  // out of the while-for nest
+        }
+      }
 
-    // Try to grab the next slice of tiles.
-    tile_base = iree_atomic_fetch_add_int32(&dispatch_task->tile_index,
-                                            tiles_per_reservation,
-                                            iree_memory_order_relaxed);
+      // Try to grab the next slice of tiles.
+      tiles_per_reservation = iree_task_dispatch_reserve_tiles(
+          dispatch_task, compute_capacity, &tile_base);
+    }
   }
 abort_shard:
 
@@ -17,6 +17,7 @@
 #include "iree/base/internal/cpu.h"
 #include "iree/base/internal/synchronization.h"
 #include "iree/task/affinity_set.h"
+#include "iree/task/topology.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -117,6 +118,18 @@ enum iree_task_flag_bits_t {
   // happens and may be available for querying before all tasks have been
   // cleaned up.
   IREE_TASK_FLAG_ABORTED = 1u << 5,
+
+  // Tiles of the dispatch are statically partitioned into contiguous ranges
+  // of a locality-preserving traversal order and assigned to shards in worker
+  // order such that consecutive dispatches with the same workgroup count
+  // process the same tiles on the same workers (barring work stealing) and can
+  // reuse data resident in their caches. The traversal visits each XY slice
+  // of the grid in blocks of IREE_TASK_DISPATCH_LOCALITY_BLOCK_SIZE^2 tiles in
+  // Z-order such that each range covers a compact 2D region.
+  //
+  // This trades the dynamic load balancing of tile reservations for locality
+  // and is ignored on dispatches with a pipelined tile consumer.
+  IREE_TASK_FLAG_DISPATCH_LOCALITY = 1u << 6,
 };
 typedef uint16_t iree_task_flags_t;
 
@@ -492,10 +505,20 @@ void iree_task_wait_set_wait_any(iree_task_wait_t* task,
 // generic ones like 'l2 cache misses' or 'ipc') then we can sprinkle in some
 // #ifdefs.
 typedef struct iree_task_dispatch_statistics_t {
-  // TODO(benvanik): statistics counters.
   // NOTE: each of these increases the command buffer storage requirements; we
   // should always guard these with IREE_STATISTICS_ENABLE.
+#if IREE_STATISTICS_ENABLE
+  // Total number of tile reservations made from the dispatch grid.
+  iree_atomic_int32_t reservation_count;
+  // Total number of tiles reserved from the dispatch grid.
+  iree_atomic_int32_t reserved_tile_count;
+  // Smallest number of tiles taken in a single reservation or 0 if none.
+  iree_atomic_int32_t min_tiles_per_reservation;
+  // Largest number of tiles taken in a single reservation or 0 if none.
+  iree_atomic_int32_t max_tiles_per_reservation;
+#else
   iree_atomic_int32_t reserved;
+#endif  // IREE_STATISTICS_ENABLE
 } iree_task_dispatch_statistics_t;
 
 // Merges statistics from |source| to |target| atomically per-field.
@@ -532,6 +555,11 @@ typedef iree_alignas(iree_max_align_t) struct {
   // TODO(benvanik): workgroup index to amortize calculating linear offsets.
   // (like gl_GlobalInvocationID)
 
+  // Workgroup ID of the tile the worker expects to execute after this one or
+  // |workgroup_xyz| if not known. Only a hint (such as for prefetching): work
+  // stealing and failures may cause the worker to execute some other tile.
+  uint32_t next_workgroup_xyz[3];
+
   // Opaque ID of the processor executing the tile.
   // May be slightly out of date or 0 if the processor could not be queried.
   iree_cpu_processor_id_t processor_id;
@@ -539,6 +567,13 @@ typedef iree_alignas(iree_max_align_t) struct {
   // Worker that is processing the tile, [0, worker_capacity).
   uint32_t worker_id;
 
+  // NUMA node (or package/cluster) of the processor the worker is assigned to.
+  iree_task_topology_node_id_t node_id;
+
+  // Cache sizes of the processor the worker is assigned to. Values of 0
+  // indicate the particular cache is not present (or not queried).
+  iree_task_topology_caches_t caches;
+
   // Tile-local memory that is pinned to each worker ensuring no cache
   // thrashing. Aligned to at least the natural pointer size of the machine.
   // Contents are (today) undefined upon entry.
@@ -646,6 +681,11 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // reasonable number chosen based on the tile and shard counts.
   uint32_t tiles_per_reservation;
 
+  // Divisor applied to the remaining tile count to size each reservation.
+  // Derived from the shard count such that reservations shrink as the grid
+  // drains and shards finish at roughly the same time.
+  uint32_t reservation_divisor;
+
   // The tail tile index; the next reservation will start from here.
   // This is used by shards to slice off the work to perform in their inner
   // loop. Ideally we'd have no destructive interference with other shared data
@@ -653,6 +693,20 @@ typedef iree_alignas(iree_max_align_t) struct iree_task_dispatch_t {
   // per shard instead of once per slice and are less of a concern.
   iree_atomic_int32_t tile_index;
 
+  // Optional pipelined consumer of this dispatch set with
+  // iree_task_dispatch_set_tile_consumer. The consumer is issued along with
+  // this dispatch and each of its tiles begins as soon as the tile with the
+  // same index in this dispatch has completed.
+  struct iree_task_dispatch_t* tile_consumer;
+
+  // Producer this dispatch is the |tile_consumer| of, if any.
+  struct iree_task_dispatch_t* tile_producer;
+
+  // Per-tile completion flags with |tile_count| entries indexed by linearized
+  // workgroup ID. Only used when there is a |tile_consumer|; each successfully
+  // completed tile stores a non-zero value to its flag.
+  iree_atomic_int32_t* tile_completions;
+
   // Incrementing process-lifetime dispatch identifier.
   IREE_TRACE(int64_t dispatch_id;)
 } iree_task_dispatch_t;
@@ -668,6 +722,25 @@ void iree_task_dispatch_initialize_indirect(
     const uint32_t workgroup_size[3], const uint32_t* workgroup_count_ptr,
     iree_task_dispatch_t* out_task);
 
+// Pipelines |consumer_task| with |producer_task| such that each tile of the
+// consumer may begin as soon as the tile with the same workgroup ID in the
+// producer has completed instead of waiting for the entire producer.
+//
+// The consumer is issued by the producer when it is issued and the producer
+// does not retire until the consumer has retired; the consumer must not be
+// enqueued or made a dependent of any other task and the producer acts in its
+// place in the task graph. Both dispatches must be direct (not
+// IREE_TASK_FLAG_DISPATCH_INDIRECT) and have the same non-zero workgroup
+// count. |tile_completions| must have one zero-initialized entry per tile and
+// remain valid until the producer has retired.
+//
+// Consumer tiles waiting on producer tiles that have not yet been started will
+// execute them inline so that progress is guaranteed regardless of how many
+// workers are available.
+void iree_task_dispatch_set_tile_consumer(iree_task_dispatch_t* producer_task,
+                                          iree_atomic_int32_t* tile_completions,
+                                          iree_task_dispatch_t* consumer_task);
+
 //==============================================================================
 // IREE_TASK_TYPE_DISPATCH_SHARD
 //==============================================================================
@@ -678,6 +751,12 @@ typedef iree_alignas(iree_max_align_t) struct {
 
   // NOTE: the parent dispatch task this shard is applied to is in the
   // header.completion_task field.
+
+  // Range [tile_begin, tile_end) of the traversal order of the dispatch
+  // statically assigned to the shard when the dispatch has
+  // IREE_TASK_FLAG_DISPATCH_LOCALITY set.
+  uint32_t tile_begin;
+  uint32_t tile_end;
 } iree_task_dispatch_shard_t;
 
 void iree_task_dispatch_shard_initialize(iree_task_dispatch_t* dispatch_task,
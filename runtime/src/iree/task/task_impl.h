@@ -107,13 +107,22 @@ void iree_task_dispatch_retire(iree_task_dispatch_t* dispatch_task,
 iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
     iree_task_dispatch_t* dispatch_task, iree_task_pool_t* shard_task_pool);
 
+// Returns the minimum number of bytes of worker local memory the dispatch shard
+// |task| requires.
+iree_host_size_t iree_task_dispatch_shard_local_memory_size(
+    iree_task_dispatch_shard_t* task);
+
 // Executes and retires a dispatch shard task.
 // May block the caller for an indeterminate amount of time and should only be
 // called from threads owned by or donated to the executor.
 //
 // |processor_id| is a guess as to which logical processor the shard is
 // executing on. It may be out of date or 0 if the processor could not be
-// queried.
+// queried. |node_id| and |caches| describe the processor the worker is assigned
+// to in the topology and are passed on to tiles as hints. |compute_capacity| is
+// the relative capacity of that processor (up to
+// IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE) and scales the number of tiles
+// reserved at a time such that slower processors hold fewer tiles.
 //
 // |worker_local_memory| is a block of memory exclusively available to the shard
 // during execution. Contents are undefined both before and after execution.
@@ -122,7 +131,9 @@ iree_task_dispatch_shard_t* iree_task_dispatch_shard_allocate(
 // all shards have completed.
 void iree_task_dispatch_shard_execute(
     iree_task_dispatch_shard_t* task, iree_cpu_processor_id_t processor_id,
-    uint32_t worker_id, iree_byte_span_t worker_local_memory,
+    uint32_t worker_id, iree_task_topology_node_id_t node_id,
+    const iree_task_topology_caches_t* caches, uint32_t compute_capacity,
+    iree_byte_span_t worker_local_memory,
     iree_task_submission_t* pending_submission);
 
 #ifdef __cplusplus
@@ -6,12 +6,14 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 #include <memory>
 
 #include "iree/base/api.h"
 #include "iree/task/submission.h"
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
+#include "iree/task/tuning.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 
@@ -113,6 +115,119 @@ TEST_F(TaskDispatchTest, Issue345) {
   DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
 }
 
+TEST_F(TaskDispatchTest, IssueLarge) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {512, 3, 7};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+}
+
+// Tests that the locality-preserving traversal visits every tile exactly once
+// for grids with full blocks, partial edge blocks, and multiple slices.
+TEST_F(TaskDispatchTest, IssueLocality) {
+  IREE_TRACE_SCOPE();
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCounts[][3] = {
+      {1, 1, 1}, {16, 16, 1}, {13, 11, 1}, {100, 1, 1},
+      {1, 100, 1}, {17, 9, 3}, {64, 64, 2},
+  };
+  for (size_t i = 0; i < IREE_ARRAYSIZE(kWorkgroupCounts); ++i) {
+    DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCounts[i],
+                          IREE_TASK_FLAG_DISPATCH_LOCALITY);
+  }
+}
+
+// Tests that tiles are told which tile the worker will execute next and that
+// locality-preserving shards each walk a chain of distinct tiles.
+TEST_F(TaskDispatchTest, NextWorkgroupHint) {
+  IREE_TRACE_SCOPE();
+  static const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  static const uint32_t kWorkgroupCount[3] = {13, 11, 3};
+  static const uint32_t kTileCount =
+      kWorkgroupCount[0] * kWorkgroupCount[1] * kWorkgroupCount[2];
+  struct HintState {
+    iree_atomic_int32_t next_counts[kTileCount];
+    iree_atomic_int32_t invalid_count;
+  } state;
+  for (uint32_t i = 0; i < kTileCount; ++i) {
+    state.next_counts[i] = IREE_ATOMIC_VAR_INIT(0);
+  }
+  state.invalid_count = IREE_ATOMIC_VAR_INIT(0);
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            auto* state = (HintState*)user_context;
+            const uint32_t* xyz = tile_context->workgroup_xyz;
+            const uint32_t* next_xyz = tile_context->next_workgroup_xyz;
+            for (int i = 0; i < 3; ++i) {
+              if (next_xyz[i] >= tile_context->workgroup_count[i]) {
+                iree_atomic_fetch_add_int32(&state->invalid_count, 1,
+                                            iree_memory_order_relaxed);
+                return iree_ok_status();
+              }
+            }
+            if (memcmp(xyz, next_xyz, sizeof(uint32_t) * 3) != 0) {
+              uint32_t next_index =
+                  (next_xyz[2] * kWorkgroupCount[1] + next_xyz[1]) *
+                      kWorkgroupCount[0] +
+                  next_xyz[0];
+              iree_atomic_fetch_add_int32(&state->next_counts[next_index], 1,
+                                          iree_memory_order_relaxed);
+            }
+            return iree_ok_status();
+          },
+          (void*)&state),
+      kWorkgroupSize, kWorkgroupCount, &task);
+  task.header.flags |= IREE_TASK_FLAG_DISPATCH_LOCALITY;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+
+  EXPECT_EQ(0, iree_atomic_load_int32(&state.invalid_count,
+                                      iree_memory_order_seq_cst));
+  uint32_t chained_count = 0;
+  for (uint32_t i = 0; i < kTileCount; ++i) {
+    int32_t next_count = iree_atomic_load_int32(&state.next_counts[i],
+                                                iree_memory_order_seq_cst);
+    EXPECT_LE(next_count, 1);
+    chained_count += next_count;
+  }
+  // Only the first tile of each shard is not hinted by another tile.
+  EXPECT_GT(chained_count, 0u);
+  EXPECT_LT(chained_count, kTileCount);
+}
+
+#if IREE_STATISTICS_ENABLE
+// Tests that the tile reservations made by shards are reported through the
+// scope statistics and that they shrink as the grid drains.
+TEST_F(TaskDispatchTest, ReservationStatistics) {
+  IREE_TRACE_SCOPE();
+  iree_task_scope_consume_statistics(&scope_);
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {1024, 4, 1};
+  DispatchAndVerifyGrid(kWorkgroupSize, kWorkgroupCount, IREE_TASK_FLAG_NONE);
+  iree_task_dispatch_statistics_t statistics =
+      iree_task_scope_consume_statistics(&scope_);
+  const int32_t reservation_count = iree_atomic_load_int32(
+      &statistics.reservation_count, iree_memory_order_relaxed);
+  const int32_t min_tiles_per_reservation = iree_atomic_load_int32(
+      &statistics.min_tiles_per_reservation, iree_memory_order_relaxed);
+  const int32_t max_tiles_per_reservation = iree_atomic_load_int32(
+      &statistics.max_tiles_per_reservation, iree_memory_order_relaxed);
+  EXPECT_EQ(iree_atomic_load_int32(&statistics.reserved_tile_count,
+                                   iree_memory_order_relaxed),
+            1024 * 4);
+  EXPECT_GT(reservation_count, 0);
+  EXPECT_LT(reservation_count, 1024 * 4);
+  EXPECT_EQ(min_tiles_per_reservation, 1);
+  EXPECT_GT(max_tiles_per_reservation, 1);
+  EXPECT_LE(max_tiles_per_reservation,
+            IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION);
+}
+#endif  // IREE_STATISTICS_ENABLE
+
 TEST_F(TaskDispatchTest, IssueIndirect) {
   IREE_TRACE_SCOPE();
 
@@ -149,6 +264,64 @@ TEST_F(TaskDispatchTest, IssueIndirect) {
   EXPECT_TRUE(coverage.Verify());
 }
 
+// Tests that dispatches requiring more local memory than the fixed per-worker
+// reservation cause the workers to grow their local memory on demand and that
+// the grown memory survives trims while it is still in use.
+TEST_F(TaskDispatchTest, LocalMemoryGrowth) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 1, 1};
+  static const uint32_t kLocalMemorySize = 3 * 1024 * 1024;
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    IREE_TRACE_SCOPE();
+    if (tile_context->local_memory.data_length < kLocalMemorySize) {
+      return iree_make_status(IREE_STATUS_INTERNAL, "local memory too small");
+    }
+    memset(tile_context->local_memory.data, 0xCD, kLocalMemorySize);
+    return iree_ok_status();
+  };
+
+  for (int i = 0; i < 3; ++i) {
+    iree_task_dispatch_t task;
+    iree_task_dispatch_initialize(&scope_,
+                                  iree_task_make_dispatch_closure(tile, NULL),
+                                  kWorkgroupSize, kWorkgroupCount, &task);
+    task.local_memory_size = kLocalMemorySize;
+    IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+    IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+    iree_task_executor_trim(executor_);
+  }
+}
+
+// Tests that dispatches requiring more local memory than workers may grow to
+// fail instead of executing with insufficient memory.
+TEST_F(TaskDispatchTest, LocalMemoryExceedsLimit) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {4, 1, 1};
+
+  auto tile = [](void* user_context,
+                 const iree_task_tile_context_t* tile_context,
+                 iree_task_submission_t* pending_submission) -> iree_status_t {
+    return iree_make_status(IREE_STATUS_INTERNAL, "should not execute");
+  };
+
+  iree_task_dispatch_t task;
+  iree_task_dispatch_initialize(&scope_,
+                                iree_task_make_dispatch_closure(tile, NULL),
+                                kWorkgroupSize, kWorkgroupCount, &task);
+  task.local_memory_size =
+      2 * IREE_TASK_EXECUTOR_DEFAULT_WORKER_LOCAL_MEMORY_LIMIT;
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&task.header, &task.header));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kResourceExhausted));
+}
+
 TEST_F(TaskDispatchTest, IssueFailure) {
   IREE_TRACE_SCOPE();
 
@@ -214,4 +387,125 @@ TEST_F(TaskDispatchTest, IssueFailureChained) {
               StatusIs(StatusCode::kDataLoss));
 }
 
+// Returns the linearized index of the tile in |tile_context|.
+static uint32_t LinearTileIndex(const iree_task_tile_context_t* tile_context) {
+  return tile_context->workgroup_xyz[2] * (tile_context->workgroup_count[1] *
+                                           tile_context->workgroup_count[0]) +
+         tile_context->workgroup_xyz[1] * tile_context->workgroup_count[0] +
+         tile_context->workgroup_xyz[0];
+}
+
+// Tests that each tile of a pipelined consumer observes the results of the
+// producer tile with the same workgroup ID and that the producer retires only
+// after the consumer.
+TEST_F(TaskDispatchTest, PipelinedTileConsumer) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {61, 3, 2};
+  const uint32_t kTileCount = 61 * 3 * 2;
+
+  struct Buffers {
+    std::unique_ptr<uint32_t[]> produced;
+    std::unique_ptr<uint32_t[]> consumed;
+  } buffers = {
+      std::unique_ptr<uint32_t[]>(new uint32_t[kTileCount]()),
+      std::unique_ptr<uint32_t[]>(new uint32_t[kTileCount]()),
+  };
+  std::unique_ptr<iree_atomic_int32_t[]> tile_completions(
+      new iree_atomic_int32_t[kTileCount]);
+  for (uint32_t i = 0; i < kTileCount; ++i) {
+    tile_completions[i] = IREE_ATOMIC_VAR_INIT(0);
+  }
+
+  iree_task_dispatch_t producer_task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            Buffers* buffers = (Buffers*)user_context;
+            uint32_t tile_index = LinearTileIndex(tile_context);
+            buffers->produced[tile_index] = tile_index + 1;
+            return iree_ok_status();
+          },
+          &buffers),
+      kWorkgroupSize, kWorkgroupCount, &producer_task);
+
+  iree_task_dispatch_t consumer_task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            Buffers* buffers = (Buffers*)user_context;
+            uint32_t tile_index = LinearTileIndex(tile_context);
+            buffers->consumed[tile_index] = buffers->produced[tile_index] * 2;
+            return iree_ok_status();
+          },
+          &buffers),
+      kWorkgroupSize, kWorkgroupCount, &consumer_task);
+
+  iree_task_dispatch_set_tile_consumer(&producer_task, tile_completions.get(),
+                                       &consumer_task);
+
+  IREE_ASSERT_OK(
+      SubmitTasksAndWaitIdle(&producer_task.header, &producer_task.header));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+  for (uint32_t i = 0; i < kTileCount; ++i) {
+    EXPECT_EQ(buffers.produced[i], i + 1);
+    EXPECT_EQ(buffers.consumed[i], (i + 1) * 2);
+  }
+}
+
+// Tests that a failing producer tile releases any consumer tiles waiting on it
+// and that the failure is propagated.
+TEST_F(TaskDispatchTest, PipelinedTileConsumerProducerFailure) {
+  IREE_TRACE_SCOPE();
+
+  const uint32_t kWorkgroupSize[3] = {1, 1, 1};
+  const uint32_t kWorkgroupCount[3] = {64, 1, 1};
+
+  std::unique_ptr<iree_atomic_int32_t[]> tile_completions(
+      new iree_atomic_int32_t[64]);
+  for (uint32_t i = 0; i < 64; ++i) {
+    tile_completions[i] = IREE_ATOMIC_VAR_INIT(0);
+  }
+
+  iree_task_dispatch_t producer_task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            return tile_context->workgroup_xyz[0] == 32
+                       ? iree_make_status(IREE_STATUS_DATA_LOSS, "whoops!")
+                       : iree_ok_status();
+          },
+          NULL),
+      kWorkgroupSize, kWorkgroupCount, &producer_task);
+
+  iree_task_dispatch_t consumer_task;
+  iree_task_dispatch_initialize(
+      &scope_,
+      iree_task_make_dispatch_closure(
+          [](void* user_context, const iree_task_tile_context_t* tile_context,
+             iree_task_submission_t* pending_submission) {
+            return tile_context->workgroup_xyz[0] == 32
+                       ? iree_make_status(IREE_STATUS_INTERNAL,
+                                          "consumed a failed tile")
+                       : iree_ok_status();
+          },
+          NULL),
+      kWorkgroupSize, kWorkgroupCount, &consumer_task);
+
+  iree_task_dispatch_set_tile_consumer(&producer_task, tile_completions.get(),
+                                       &consumer_task);
+
+  IREE_ASSERT_OK(
+      SubmitTasksAndWaitIdle(&producer_task.header, &producer_task.header));
+  EXPECT_THAT(Status(iree_task_scope_consume_status(&scope_)),
+              StatusIs(StatusCode::kDataLoss));
+}
+
 }  // namespace
@@ -7,6 +7,7 @@
 #include <atomic>
 #include <chrono>
 #include <thread>
+#include <vector>
 
 #include "iree/task/task.h"
 #include "iree/task/testing/task_test.h"
@@ -197,6 +198,52 @@ TEST_F(TaskWaitTest, WaitAllTimeout) {
   iree_event_deinitialize(&event_b);
 }
 
+// Issues more simultaneous waits than the initial poller wait set capacity so
+// that the set must grow while all waits are outstanding.
+TEST_F(TaskWaitTest, WaitAllExceedingInitialCapacity) {
+  IREE_TRACE_SCOPE();
+#if defined(IREE_PLATFORM_WINDOWS)
+  GTEST_SKIP() << "WaitForMultipleObjects is limited to MAXIMUM_WAIT_OBJECTS";
+#endif  // IREE_PLATFORM_WINDOWS
+
+  static constexpr int kWaitCount = 128;
+  std::vector<iree_event_t> events(kWaitCount);
+  std::vector<iree_task_wait_t> tasks(kWaitCount);
+  std::vector<iree_task_t*> wait_tasks(kWaitCount);
+  for (int i = 0; i < kWaitCount; ++i) {
+    iree_event_initialize(/*initial_state=*/false, &events[i]);
+    iree_task_wait_initialize(&scope_, iree_event_await(&events[i]),
+                              IREE_TIME_INFINITE_FUTURE, &tasks[i]);
+    wait_tasks[i] = &tasks[i].header;
+  }
+  iree_task_barrier_t barrier;
+  iree_task_barrier_initialize(&scope_, kWaitCount, wait_tasks.data(),
+                               &barrier);
+
+  iree_task_fence_t fence;
+  iree_task_fence_initialize(&scope_, iree_wait_primitive_immediate(), &fence);
+  for (int i = 0; i < kWaitCount; ++i) {
+    iree_task_set_completion_task(&tasks[i].header, &fence.header);
+  }
+
+  // Signal in reverse order after the waits have been registered.
+  std::thread signal_thread([&]() {
+    IREE_TRACE_SCOPE();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    for (int i = kWaitCount - 1; i >= 0; --i) {
+      iree_event_set(&events[i]);
+    }
+  });
+
+  IREE_ASSERT_OK(SubmitTasksAndWaitIdle(&barrier.header, &fence.header));
+  IREE_EXPECT_OK(iree_task_scope_consume_status(&scope_));
+
+  signal_thread.join();
+  for (int i = 0; i < kWaitCount; ++i) {
+    iree_event_deinitialize(&events[i]);
+  }
+}
+
 // Issues multiple waits that join on a single task in wait-any mode.
 // This means that if one wait finishes all other waits will be cancelled and
 // the completion task will continue.
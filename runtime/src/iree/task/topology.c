@@ -10,6 +10,26 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/math.h"
+
+bool iree_task_topology_cpu_limits_allow(
+    const iree_task_topology_cpu_limits_t* limits, uint32_t cpu_id) {
+  if (limits->allowed_cpu_count == 0) return true;  // unknown
+  if (cpu_id >= IREE_TASK_TOPOLOGY_MAX_CPU_COUNT) return false;
+  return (limits->allowed_cpu_bits[cpu_id / 64] >> (cpu_id % 64)) & 1;
+}
+
+iree_host_size_t iree_task_topology_cpu_limits_max_concurrency(
+    const iree_task_topology_cpu_limits_t* limits) {
+  iree_host_size_t max_concurrency = IREE_HOST_SIZE_MAX;
+  if (limits->allowed_cpu_count > 0) {
+    max_concurrency = limits->allowed_cpu_count;
+  }
+  if (limits->quota_cpu_count > 0) {
+    max_concurrency = iree_min(max_concurrency, limits->quota_cpu_count);
+  }
+  return max_concurrency;
+}
 
 void iree_task_topology_group_initialize(
     uint8_t group_index, iree_task_topology_group_t* out_group) {
@@ -76,6 +96,29 @@ iree_status_t iree_task_topology_push_group(
   return iree_ok_status();
 }
 
+iree_host_size_t iree_task_topology_partition_by_constructive_sharing(
+    const iree_task_topology_t* topology,
+    iree_task_topology_group_mask_t* out_partition_masks) {
+  iree_task_topology_group_mask_t remaining_mask =
+      topology->group_count >= IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT
+          ? IREE_TASK_TOPOLOGY_GROUP_MASK_ALL
+          : (1ull << topology->group_count) - 1;
+  iree_host_size_t partition_count = 0;
+  while (remaining_mask) {
+    // Each partition is seeded by the lowest remaining group and takes all
+    // remaining groups it shares with. Sharing is symmetric in practice so the
+    // partitions match the physical cache domains.
+    int group_index = iree_math_count_trailing_zeros_u64(remaining_mask);
+    iree_task_topology_group_mask_t partition_mask =
+        (topology->groups[group_index].constructive_sharing_mask |
+         (1ull << group_index)) &
+        remaining_mask;
+    out_partition_masks[partition_count++] = partition_mask;
+    remaining_mask &= ~partition_mask;
+  }
+  return partition_count;
+}
+
 // Fixes constructive_sharing_mask values such that they represent other chosen
 // topology groups instead of processor indices. We do this so that code using
 // the topology groups doesn't need to know anything about which physical
@@ -109,6 +152,40 @@ void iree_task_topology_initialize_from_group_count(
   IREE_TRACE_ZONE_END(z0);
 }
 
+// Compacts the bits of |mask| selected by |select_mask| into the low bits.
+static iree_task_topology_group_mask_t iree_task_topology_compact_group_mask(
+    iree_task_topology_group_mask_t mask,
+    iree_task_topology_group_mask_t select_mask) {
+  if (mask == IREE_TASK_TOPOLOGY_GROUP_MASK_ALL) return mask;
+  iree_task_topology_group_mask_t compacted_mask = 0;
+  int compacted_bit = 0;
+  for (int i = 0; i < IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT; ++i) {
+    if (!((select_mask >> i) & 1)) continue;
+    if ((mask >> i) & 1) compacted_mask |= 1ull << compacted_bit;
+    ++compacted_bit;
+  }
+  return compacted_mask;
+}
+
+void iree_task_topology_initialize_from_group_mask(
+    const iree_task_topology_t* base_topology,
+    iree_task_topology_group_mask_t group_mask,
+    iree_task_topology_t* out_topology) {
+  IREE_ASSERT_ARGUMENT(base_topology);
+  IREE_ASSERT_ARGUMENT(out_topology);
+  iree_task_topology_initialize(out_topology);
+  for (iree_host_size_t i = 0; i < base_topology->group_count; ++i) {
+    if (!((group_mask >> i) & 1)) continue;
+    const iree_task_topology_group_t* base_group = &base_topology->groups[i];
+    iree_task_topology_group_t* group =
+        &out_topology->groups[out_topology->group_count];
+    memcpy(group, base_group, sizeof(*group));
+    group->group_index = (uint8_t)out_topology->group_count++;
+    group->constructive_sharing_mask = iree_task_topology_compact_group_mask(
+        base_group->constructive_sharing_mask, group_mask);
+  }
+}
+
 iree_status_t iree_task_topology_initialize_from_thread_affinities(
     iree_host_size_t group_count,
     const iree_thread_affinity_t* group_affinities,
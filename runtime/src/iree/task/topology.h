@@ -37,6 +37,44 @@ iree_host_size_t iree_task_topology_query_node_count(void);
 // is not available on the platform.
 iree_task_topology_node_id_t iree_task_topology_query_current_node(void);
 
+//===----------------------------------------------------------------------===//
+// Process CPU limits
+//===----------------------------------------------------------------------===//
+
+// Maximum number of logical processor IDs tracked by CPU limit queries.
+#define IREE_TASK_TOPOLOGY_MAX_CPU_COUNT 1024
+
+// CPU resources the process is allowed to use as constrained by the affinity
+// mask it was launched with (`taskset`, container runtimes, etc) and on Linux
+// its cgroup v2 `cpuset.cpus.effective` and `cpu.max` limits.
+typedef struct iree_task_topology_cpu_limits_t {
+  // Bitmap of the logical processor IDs the process may run on. The IDs match
+  // those used by iree_task_topology_initialize_from_logical_cpu_set.
+  uint64_t allowed_cpu_bits[IREE_TASK_TOPOLOGY_MAX_CPU_COUNT / 64];
+  // Total number of processors in |allowed_cpu_bits| or 0 if the platform
+  // cannot be queried and all processors are assumed to be allowed.
+  iree_host_size_t allowed_cpu_count;
+  // Number of processors worth of CPU time the process may consume each
+  // scheduling period under a CPU bandwidth quota, rounded up, or 0 if
+  // unlimited. A container with 8 CPUs of quota on a 96 core machine can run
+  // on any core but workers beyond 8 only cause throttling.
+  iree_host_size_t quota_cpu_count;
+} iree_task_topology_cpu_limits_t;
+
+// Queries the CPU limits of the calling thread and the process containing it.
+// Platforms without support report no limits.
+void iree_task_topology_query_cpu_limits(
+    iree_task_topology_cpu_limits_t* out_limits);
+
+// Returns true if logical processor |cpu_id| may be used under |limits|.
+bool iree_task_topology_cpu_limits_allow(
+    const iree_task_topology_cpu_limits_t* limits, uint32_t cpu_id);
+
+// Returns the maximum number of workers that can run concurrently under
+// |limits| or IREE_HOST_SIZE_MAX if unlimited.
+iree_host_size_t iree_task_topology_cpu_limits_max_concurrency(
+    const iree_task_topology_cpu_limits_t* limits);
+
 //===----------------------------------------------------------------------===//
 // Topology group (worker thread(s) assigned to a processor)
 //===----------------------------------------------------------------------===//
@@ -60,6 +98,11 @@ typedef struct iree_task_topology_caches_t {
   uint32_t l3_data;
 } iree_task_topology_caches_t;
 
+// Compute capacity of the most capable processors in the system. Processors
+// with lower capacity (efficiency cores, LITTLE cores, etc) are scaled
+// relative to this. Matches the Linux `cpu_capacity` scale.
+#define IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE 1024
+
 // Information about a particular group within the topology.
 // Groups may be of varying levels of granularity even within the same topology
 // based on how the topology is defined.
@@ -74,9 +117,21 @@ typedef struct iree_task_topology_group_t {
   // Logical processor index.
   uint32_t processor_index;
 
+  // NUMA node (or package/cluster where NUMA info is unavailable) the
+  // processor belongs to. Workers will prefer to steal work from groups on the
+  // same node and only cross nodes after repeatedly failing to find local work.
+  iree_task_topology_node_id_t node_id;
+
   // Total cache sizes (that we care about).
   iree_task_topology_caches_t caches;
 
+  // Relative compute capacity of the processor in the range
+  // (0, IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE] or 0 if unknown (treated as
+  // full capacity). On heterogeneous systems (big.LITTLE, P+E cores) workers
+  // on lower capacity processors are given proportionally less work so that
+  // dispatches do not wait on the slowest cores.
+  uint32_t compute_capacity;
+
   // Ideal thread affinity for threads within this group.
   // All threads within the group share the same affinity and this is what
   // allows us to model Simultaneous Multi-Threading (SMT) (aka hyperthreading).
@@ -153,6 +208,17 @@ const iree_task_topology_group_t* iree_task_topology_get_group(
 iree_status_t iree_task_topology_push_group(
     iree_task_topology_t* topology, const iree_task_topology_group_t* group);
 
+// Splits the groups of |topology| into disjoint partitions of groups that
+// constructively share caches as indicated by their constructive_sharing_mask
+// (such as the cores of a CCX or cluster). Groups with undefined sharing
+// masks are all placed in the same partition. The group mask of each partition
+// is written to |out_partition_masks| which must have capacity for
+// IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT partitions and the partition count is
+// returned.
+iree_host_size_t iree_task_topology_partition_by_constructive_sharing(
+    const iree_task_topology_t* topology,
+    iree_task_topology_group_mask_t* out_partition_masks);
+
 //===----------------------------------------------------------------------===//
 // Topology initialization helpers
 //===----------------------------------------------------------------------===//
@@ -166,6 +232,14 @@ iree_status_t iree_task_topology_push_group(
 void iree_task_topology_initialize_from_group_count(
     iree_host_size_t group_count, iree_task_topology_t* out_topology);
 
+// Initializes a topology with the groups of |base_topology| selected by
+// |group_mask|. Groups are renumbered in order and their constructive sharing
+// masks are remapped to the new group indices.
+void iree_task_topology_initialize_from_group_mask(
+    const iree_task_topology_t* base_topology,
+    iree_task_topology_group_mask_t group_mask,
+    iree_task_topology_t* out_topology);
+
 // Initializes a topology with the given groups each assigned a platform thread
 // affinity. See `iree_thread_affinity_t` for more information about how to
 // properly initialize the thread affinities for each platform.
@@ -213,6 +287,10 @@ typedef enum iree_task_topology_performance_level_e {
 // Initializes a topology with one group for each physical core with the given
 // NUMA |node_id| (usually package or cluster). Up to |max_core_count| physical
 // cores will be selected from the node.
+//
+// Only cores with processors allowed by iree_task_topology_query_cpu_limits
+// are selected and the group count is clamped to the CPU quota, if any, such
+// that workers are not throttled when running in containers.
 iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id,
     iree_task_topology_performance_level_t performance_level,
@@ -4,6 +4,9 @@
 // See https://llvm.org/LICENSE.txt for license information.
 // SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
 
+// sched_getaffinity and CPU_* macros.
+#define _GNU_SOURCE
+
 #include "iree/base/api.h"
 #include "iree/base/internal/math.h"
 #include "iree/task/topology.h"
@@ -28,6 +31,249 @@ static void iree_task_topology_initialize_fallback(
   IREE_TRACE_ZONE_END(z0);
 }
 
+//===----------------------------------------------------------------------===//
+// Process CPU limits
+//===----------------------------------------------------------------------===//
+
+#if defined(IREE_PLATFORM_LINUX) || defined(IREE_PLATFORM_ANDROID)
+
+#include <sched.h>
+#include <stdio.h>
+
+// Reads up to |buffer_capacity| - 1 bytes of the file at |path| into |buffer|
+// and NUL terminates it. Returns false if the file could not be read.
+static bool iree_task_topology_read_small_file(const char* path, char* buffer,
+                                               iree_host_size_t buffer_capacity) {
+  FILE* file = fopen(path, "rb");
+  if (!file) return false;
+  iree_host_size_t length = fread(buffer, 1, buffer_capacity - 1, file);
+  fclose(file);
+  buffer[length] = 0;
+  return length > 0;
+}
+
+// Resolves the cgroup v2 directory of the process into |out_path|.
+// Returns false if the process is not in a unified (v2) hierarchy.
+static bool iree_task_topology_resolve_cgroup_path(
+    char* out_path, iree_host_size_t out_path_capacity) {
+  char contents[1024];
+  if (!iree_task_topology_read_small_file("/proc/self/cgroup", contents,
+                                          sizeof(contents))) {
+    return false;
+  }
+  // The unified hierarchy is the line `0::<path>`; v1 controllers have their
+  // own numbered lines that we ignore.
+  const char* line = contents;
+  while (*line) {
+    const char* line_end = strchr(line, '\n');
+    if (!line_end) line_end = line + strlen(line);
+    if (strncmp(line, "0::", 3) == 0) {
+      const char* cgroup = line + 3;
+      int cgroup_length = (int)(line_end - cgroup);
+      while (cgroup_length > 0 && cgroup[cgroup_length - 1] == '/') {
+        --cgroup_length;
+      }
+      int length = snprintf(out_path, out_path_capacity, "/sys/fs/cgroup%.*s",
+                            cgroup_length, cgroup);
+      return length > 0 && (iree_host_size_t)length < out_path_capacity;
+    }
+    if (!*line_end) break;
+    line = line_end + 1;
+  }
+  return false;
+}
+
+// Parses a cpuset list (`0-3,8,10-11`) into |out_bits|.
+// Returns false if the list is empty or malformed.
+static bool iree_task_topology_parse_cpu_list(
+    const char* list, uint64_t out_bits[IREE_TASK_TOPOLOGY_MAX_CPU_COUNT / 64]) {
+  memset(out_bits, 0,
+         sizeof(uint64_t) * (IREE_TASK_TOPOLOGY_MAX_CPU_COUNT / 64));
+  bool any = false;
+  const char* p = list;
+  while (*p && *p != '\n') {
+    char* end = NULL;
+    unsigned long first = strtoul(p, &end, 10);
+    if (end == p) return false;
+    unsigned long last = first;
+    p = end;
+    if (*p == '-') {
+      ++p;
+      last = strtoul(p, &end, 10);
+      if (end == p || last < first) return false;
+      p = end;
+    }
+    for (unsigned long i = first;
+         i <= last && i < IREE_TASK_TOPOLOGY_MAX_CPU_COUNT; ++i) {
+      out_bits[i / 64] |= 1ull << (i % 64);
+      any = true;
+    }
+    if (*p == ',') ++p;
+  }
+  return any;
+}
+
+// Returns the number of CPUs worth of bandwidth allowed by the `cpu.max` file
+// in |cgroup_path| and all of its ancestors or 0 if unlimited.
+static iree_host_size_t iree_task_topology_query_cgroup_quota(
+    char* cgroup_path) {
+  iree_host_size_t quota_cpu_count = 0;
+  const iree_host_size_t root_length = strlen("/sys/fs/cgroup");
+  while (strlen(cgroup_path) >= root_length) {
+    char file_path[512];
+    char contents[64];
+    snprintf(file_path, sizeof(file_path), "%s/cpu.max", cgroup_path);
+    if (iree_task_topology_read_small_file(file_path, contents,
+                                           sizeof(contents))) {
+      // Format: `$MAX $PERIOD` where $MAX may be `max` for unlimited.
+      unsigned long long quota = 0, period = 0;
+      if (sscanf(contents, "%llu %llu", &quota, &period) == 2 && quota > 0 &&
+          period > 0) {
+        iree_host_size_t count =
+            (iree_host_size_t)((quota + period - 1) / period);
+        quota_cpu_count =
+            quota_cpu_count ? iree_min(quota_cpu_count, count) : count;
+      }
+    }
+    char* last_slash = strrchr(cgroup_path, '/');
+    if (!last_slash || (iree_host_size_t)(last_slash - cgroup_path) <
+                           root_length) {
+      break;
+    }
+    *last_slash = 0;
+  }
+  return quota_cpu_count;
+}
+
+void iree_task_topology_query_cpu_limits(
+    iree_task_topology_cpu_limits_t* out_limits) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_limits, 0, sizeof(*out_limits));
+
+  // Affinity mask of the calling thread. Containers commonly restrict this via
+  // cpusets and users may have used `taskset`/`numactl`.
+  bool has_allowed_bits = false;
+  cpu_set_t* cpu_set = CPU_ALLOC(IREE_TASK_TOPOLOGY_MAX_CPU_COUNT);
+  if (cpu_set) {
+    size_t cpu_set_size = CPU_ALLOC_SIZE(IREE_TASK_TOPOLOGY_MAX_CPU_COUNT);
+    CPU_ZERO_S(cpu_set_size, cpu_set);
+    if (sched_getaffinity(0, cpu_set_size, cpu_set) == 0) {
+      for (uint32_t i = 0; i < IREE_TASK_TOPOLOGY_MAX_CPU_COUNT; ++i) {
+        if (CPU_ISSET_S(i, cpu_set_size, cpu_set)) {
+          out_limits->allowed_cpu_bits[i / 64] |= 1ull << (i % 64);
+          has_allowed_bits = true;
+        }
+      }
+    }
+    CPU_FREE(cpu_set);
+  }
+
+  char cgroup_path[384];
+  if (iree_task_topology_resolve_cgroup_path(cgroup_path,
+                                             sizeof(cgroup_path))) {
+    // The effective cpuset should already be reflected in the affinity mask
+    // but the mask can be stale if the cpuset changed after the process
+    // started; intersect the two and ignore the cpuset if they are disjoint.
+    char file_path[512];
+    char contents[1024];
+    uint64_t cpuset_bits[IREE_TASK_TOPOLOGY_MAX_CPU_COUNT / 64];
+    snprintf(file_path, sizeof(file_path), "%s/cpuset.cpus.effective",
+             cgroup_path);
+    if (iree_task_topology_read_small_file(file_path, contents,
+                                           sizeof(contents)) &&
+        iree_task_topology_parse_cpu_list(contents, cpuset_bits)) {
+      uint64_t intersection[IREE_TASK_TOPOLOGY_MAX_CPU_COUNT / 64];
+      bool any = false;
+      for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(intersection); ++i) {
+        intersection[i] = has_allowed_bits
+                              ? out_limits->allowed_cpu_bits[i] & cpuset_bits[i]
+                              : cpuset_bits[i];
+        any |= intersection[i] != 0;
+      }
+      if (any) {
+        memcpy(out_limits->allowed_cpu_bits, intersection,
+               sizeof(intersection));
+        has_allowed_bits = true;
+      }
+    }
+    out_limits->quota_cpu_count =
+        iree_task_topology_query_cgroup_quota(cgroup_path);
+  }
+
+  if (has_allowed_bits) {
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_limits->allowed_cpu_bits);
+         ++i) {
+      out_limits->allowed_cpu_count +=
+          iree_math_count_ones_u64(out_limits->allowed_cpu_bits[i]);
+    }
+  }
+
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, out_limits->allowed_cpu_count);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, out_limits->quota_cpu_count);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// Processor compute capacity
+//===----------------------------------------------------------------------===//
+
+// Capacity assigned to Intel hybrid efficiency (Atom) cores relative to the
+// performance cores on the same die. Gracemont sustains roughly 60% of the
+// throughput of Golden Cove/Raptor Cove at the frequencies they run together.
+#if !defined(IREE_TASK_TOPOLOGY_HYBRID_EFFICIENCY_CORE_CAPACITY)
+#define IREE_TASK_TOPOLOGY_HYBRID_EFFICIENCY_CORE_CAPACITY \
+  (IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE * 5 / 8)
+#endif  // !IREE_TASK_TOPOLOGY_HYBRID_EFFICIENCY_CORE_CAPACITY
+
+// Assigns the compute capacity of each group in |topology| as reported by the
+// kernel. Arm systems expose a normalized per-processor `cpu_capacity` derived
+// from the devicetree/ACPI capacity-dmips-mhz. Intel hybrid systems instead
+// register a PMU per core type (`cpu_core` and `cpu_atom`) listing the
+// processors of that type. Homogeneous systems report neither and groups are
+// left at unknown (full) capacity.
+static void iree_task_topology_assign_compute_capacities(
+    iree_task_topology_t* topology) {
+  char contents[1024];
+  uint64_t atom_bits[IREE_TASK_TOPOLOGY_MAX_CPU_COUNT / 64];
+  const bool is_hybrid =
+      iree_task_topology_read_small_file("/sys/devices/cpu_atom/cpus",
+                                         contents, sizeof(contents)) &&
+      iree_task_topology_parse_cpu_list(contents, atom_bits);
+  for (iree_host_size_t i = 0; i < topology->group_count; ++i) {
+    iree_task_topology_group_t* group = &topology->groups[i];
+    const uint32_t cpu_id = group->processor_index;
+    char file_path[128];
+    snprintf(file_path, sizeof(file_path),
+             "/sys/devices/system/cpu/cpu%u/cpu_capacity", cpu_id);
+    unsigned long capacity = 0;
+    if (iree_task_topology_read_small_file(file_path, contents,
+                                           sizeof(contents))) {
+      capacity = strtoul(contents, NULL, 10);
+    } else if (is_hybrid && cpu_id < IREE_TASK_TOPOLOGY_MAX_CPU_COUNT) {
+      capacity = (atom_bits[cpu_id / 64] >> (cpu_id % 64)) & 1
+                     ? IREE_TASK_TOPOLOGY_HYBRID_EFFICIENCY_CORE_CAPACITY
+                     : IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE;
+    }
+    group->compute_capacity = (uint32_t)iree_min(
+        capacity, (unsigned long)IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE);
+  }
+}
+
+#else
+
+void iree_task_topology_query_cpu_limits(
+    iree_task_topology_cpu_limits_t* out_limits) {
+  // No limits are queryable; all processors are assumed usable.
+  memset(out_limits, 0, sizeof(*out_limits));
+}
+
+static void iree_task_topology_assign_compute_capacities(
+    iree_task_topology_t* topology) {
+  // No-op; capacities remain unknown.
+}
+
+#endif  // IREE_PLATFORM_LINUX || IREE_PLATFORM_ANDROID
+
 #if defined(IREE_TASK_CPUINFO_DISABLED)
 
 iree_host_size_t iree_task_topology_query_node_count(void) { return 1; }
@@ -77,6 +323,7 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
     affinity->specified = 1;
     affinity->id = cpu_ids[i];
   }
+  iree_task_topology_assign_compute_capacities(out_topology);
 
   iree_status_t status =
       iree_task_topology_fixup_constructive_sharing_masks(out_topology);
@@ -182,6 +429,7 @@ static void iree_task_topology_group_initialize_from_processor(
   out_group->processor_index =
       processor->core->processor_start + processor->smt_id;
 #endif  // __linux__
+  out_group->node_id = processor->cluster->cluster_id;
   out_group->caches.l1_data =
       processor->cache.l1d ? processor->cache.l1d->size : 0;
   out_group->caches.l2_data =
@@ -192,16 +440,41 @@ static void iree_task_topology_group_initialize_from_processor(
       processor, &out_group->ideal_thread_affinity);
 }
 
+// Returns the ID |limits| uses for |processor|.
+static uint32_t iree_task_topology_processor_limit_id(
+    const struct cpuinfo_processor* processor) {
+#if defined(__linux__)
+  return (uint32_t)processor->linux_id;
+#else
+  return processor->core->processor_start + processor->smt_id;
+#endif  // __linux__
+}
+
+// Returns the first processor in |core| allowed by |limits| or NULL if none are.
+static const struct cpuinfo_processor* iree_task_topology_first_allowed_processor(
+    const struct cpuinfo_core* core,
+    const iree_task_topology_cpu_limits_t* limits) {
+  for (uint32_t i = 0; i < core->processor_count; ++i) {
+    const struct cpuinfo_processor* processor =
+        cpuinfo_get_processor(core->processor_start + i);
+    if (iree_task_topology_cpu_limits_allow(
+            limits, iree_task_topology_processor_limit_id(processor))) {
+      return processor;
+    }
+  }
+  return NULL;
+}
+
 // Populates |out_group| with the information from |core|.
 static void iree_task_topology_group_initialize_from_core(
     uint32_t group_index, const struct cpuinfo_core* core,
+    const iree_task_topology_cpu_limits_t* limits,
     iree_task_topology_group_t* out_group) {
-  // Guess: always pick the first processor in a core.
+  // Guess: always pick the first allowed processor in a core.
   // When pinning to threads we'll take into account whether the core is SMT
   // and use all threads anyway so this alignment is just helpful for debugging.
-  uint32_t processor_i = core->processor_start;
   const struct cpuinfo_processor* processor =
-      cpuinfo_get_processor(processor_i);
+      iree_task_topology_first_allowed_processor(core, limits);
   iree_task_topology_group_initialize_from_processor(group_index, processor,
                                                      out_group);
 }
@@ -309,6 +582,7 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
     iree_task_topology_group_initialize_from_processor(
         i, processor, &out_topology->groups[i]);
   }
+  iree_task_topology_assign_compute_capacities(out_topology);
 
   iree_status_t status =
       iree_task_topology_fixup_constructive_sharing_masks(out_topology);
@@ -383,13 +657,23 @@ iree_task_topology_initialize_from_physical_cores_with_filter(
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, max_core_count);
 
+  // Cores are only usable if the process is allowed to run on them and there's
+  // no benefit to running more workers than the CPU quota allows.
+  iree_task_topology_cpu_limits_t limits;
+  iree_task_topology_query_cpu_limits(&limits);
+
   // Count cores that match the filter.
   iree_host_size_t core_count = 0;
   for (uint32_t i = 0; i < cpuinfo_get_cores_count(); i++) {
     const struct cpuinfo_core* core = cpuinfo_get_core(i);
-    if (filter_fn(core, filter_fn_data)) ++core_count;
+    if (filter_fn(core, filter_fn_data) &&
+        iree_task_topology_first_allowed_processor(core, &limits)) {
+      ++core_count;
+    }
   }
   core_count = iree_min(core_count, max_core_count);
+  core_count = iree_min(core_count,
+                        iree_task_topology_cpu_limits_max_concurrency(&limits));
 
   iree_task_topology_initialize(out_topology);
 
@@ -406,12 +690,14 @@ iree_task_topology_initialize_from_physical_cores_with_filter(
     // want to have our workers stealing their time.
     const struct cpuinfo_core* core =
         cpuinfo_get_core(iree_task_topology_rotate_from_base_core(core_i));
-    if (filter_fn(core, filter_fn_data)) {
+    if (filter_fn(core, filter_fn_data) &&
+        iree_task_topology_first_allowed_processor(core, &limits)) {
       iree_task_topology_group_initialize_from_core(
-          group_i, core, &out_topology->groups[group_i]);
+          group_i, core, &limits, &out_topology->groups[group_i]);
       ++group_i;
     }
   }
+  iree_task_topology_assign_compute_capacities(out_topology);
 
   iree_status_t status =
       iree_task_topology_fixup_constructive_sharing_masks(out_topology);
@@ -68,6 +68,12 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
   return (iree_task_topology_node_id_t)0;
 }
 
+void iree_task_topology_query_cpu_limits(
+    iree_task_topology_cpu_limits_t* out_limits) {
+  // No limits are queryable; all processors are assumed usable.
+  memset(out_limits, 0, sizeof(*out_limits));
+}
+
 //===----------------------------------------------------------------------===//
 // Topology initialization helpers
 //===----------------------------------------------------------------------===//
@@ -196,6 +202,8 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   for (iree_host_size_t i = 0; i < out_topology->group_count; ++i) {
     iree_task_topology_group_t* group = &out_topology->groups[i];
     group->processor_index = i;
+    group->node_id =
+        node_id == IREE_TASK_TOPOLOGY_NODE_ID_ANY ? 0 : (uint32_t)node_id;
 
     // Assign attributes based on the perflevel of the group; we can't pin cores
     // on Apple platforms so instead we just treat the first N groups as
@@ -208,6 +216,14 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     group->caches.l2_data = perflevels[perflevel].l2cachesize;
     group->caches.l3_data = perflevels[perflevel].l3cachesize;
 
+    // Efficiency cores sustain roughly half the throughput of the performance
+    // cores. There's no per-core capacity query so we just guess.
+    if (nperflevels > 1) {
+      group->compute_capacity =
+          perflevel == 0 ? IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE
+                         : IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE / 2;
+    }
+
     // We make stuff up as Apple doesn't want us to have nice things.
     // See iree_thread_affinity_t for more information about how we use the
     // affinity info. Note that we pack "use efficiency cores only" into the SMT
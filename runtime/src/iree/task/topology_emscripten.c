@@ -16,6 +16,12 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
   return 0;
 }
 
+void iree_task_topology_query_cpu_limits(
+    iree_task_topology_cpu_limits_t* out_limits) {
+  // No limits are queryable; all processors are assumed usable.
+  memset(out_limits, 0, sizeof(*out_limits));
+}
+
 iree_status_t iree_task_topology_fixup_constructive_sharing_masks(
     iree_task_topology_t* topology) {
   // No-op.
@@ -117,6 +117,54 @@ TEST(TopologyTest, FromGroupCount) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, PartitionByConstructiveSharing) {
+  // Two cache domains of 3 and 2 groups interleaved plus one group that
+  // shares with nothing.
+  static const iree_task_topology_group_mask_t kSharingMasks[] = {
+      0b000101, 0b001010, 0b000101, 0b001010, 0b010000, 0b000000,
+  };
+  iree_task_topology_t topology;
+  iree_task_topology_initialize(&topology);
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(kSharingMasks); ++i) {
+    iree_task_topology_group_t group;
+    iree_task_topology_group_initialize(i, &group);
+    group.constructive_sharing_mask = kSharingMasks[i];
+    IREE_ASSERT_OK(iree_task_topology_push_group(&topology, &group));
+  }
+  // Groups sharing with nothing (or only themselves) are partitioned alone.
+  iree_task_topology_group_mask_t
+      partition_masks[IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT];
+  ASSERT_EQ(4, iree_task_topology_partition_by_constructive_sharing(
+                   &topology, partition_masks));
+  EXPECT_EQ(0b000101, partition_masks[0]);
+  EXPECT_EQ(0b001010, partition_masks[1]);
+  EXPECT_EQ(0b010000, partition_masks[2]);
+  EXPECT_EQ(0b100000, partition_masks[3]);
+
+  // Partition topologies are renumbered with remapped sharing masks.
+  iree_task_topology_t partition_topology;
+  iree_task_topology_initialize_from_group_mask(&topology, partition_masks[1],
+                                                &partition_topology);
+  ASSERT_EQ(2, iree_task_topology_group_count(&partition_topology));
+  for (iree_host_size_t i = 0; i < 2; ++i) {
+    const iree_task_topology_group_t* group =
+        iree_task_topology_get_group(&partition_topology, i);
+    EXPECT_EQ(i, group->group_index);
+    EXPECT_EQ(0b11, group->constructive_sharing_mask);
+  }
+  iree_task_topology_deinitialize(&partition_topology);
+
+  // Undefined sharing masks keep all groups together.
+  iree_task_topology_t default_topology;
+  iree_task_topology_initialize_from_group_count(4, &default_topology);
+  ASSERT_EQ(1, iree_task_topology_partition_by_constructive_sharing(
+                   &default_topology, partition_masks));
+  EXPECT_EQ(0b1111, partition_masks[0]);
+  iree_task_topology_deinitialize(&default_topology);
+
+  iree_task_topology_deinitialize(&topology);
+}
+
 // Verifies only that the |topology| is usable.
 // If we actually checked the contents here then we'd just be validating that
 // cpuinfo was working and the tests would become machine-dependent.
@@ -145,4 +193,34 @@ TEST(TopologyTest, FromPhysicalCores) {
   iree_task_topology_deinitialize(&topology);
 }
 
+TEST(TopologyTest, CpuLimits) {
+  iree_task_topology_cpu_limits_t limits;
+  memset(&limits, 0, sizeof(limits));
+
+  // No limits: everything allowed.
+  EXPECT_TRUE(iree_task_topology_cpu_limits_allow(&limits, 0));
+  EXPECT_TRUE(iree_task_topology_cpu_limits_allow(&limits, 100));
+  EXPECT_EQ(IREE_HOST_SIZE_MAX,
+            iree_task_topology_cpu_limits_max_concurrency(&limits));
+
+  // Affinity/cpuset: only the allowed CPUs.
+  limits.allowed_cpu_bits[0] = 0x0Full;
+  limits.allowed_cpu_bits[1] = 0x01ull;
+  limits.allowed_cpu_count = 5;
+  EXPECT_TRUE(iree_task_topology_cpu_limits_allow(&limits, 3));
+  EXPECT_FALSE(iree_task_topology_cpu_limits_allow(&limits, 4));
+  EXPECT_TRUE(iree_task_topology_cpu_limits_allow(&limits, 64));
+  EXPECT_FALSE(iree_task_topology_cpu_limits_allow(
+      &limits, IREE_TASK_TOPOLOGY_MAX_CPU_COUNT));
+  EXPECT_EQ(5, iree_task_topology_cpu_limits_max_concurrency(&limits));
+
+  // Quota further clamps concurrency.
+  limits.quota_cpu_count = 2;
+  EXPECT_EQ(2, iree_task_topology_cpu_limits_max_concurrency(&limits));
+
+  // The queried limits must always be usable.
+  iree_task_topology_query_cpu_limits(&limits);
+  EXPECT_NE(0, iree_task_topology_cpu_limits_max_concurrency(&limits));
+}
+
 }  // namespace
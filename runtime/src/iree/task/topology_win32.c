@@ -29,7 +29,7 @@ iree_task_topology_node_id_t iree_task_topology_query_current_node(void) {
 }
 
 //===----------------------------------------------------------------------===//
-// Topology initialization helpers
+// Process CPU limits
 //===----------------------------------------------------------------------===//
 
 static inline int iree_task_count_trailing_zeros_kaffinity(
@@ -49,6 +49,104 @@ static inline int iree_task_count_kaffinity_bits(KAFFINITY affinity_mask) {
 #endif  // _WIN64
 }
 
+// Returns the ID |limits| uses for processor |number| in processor |group|.
+// Processors are numbered consecutively across groups in group order, which
+// matches the order cores are reported by GetLogicalProcessorInformationEx.
+static uint32_t iree_task_topology_processor_limit_id(WORD group,
+                                                      BYTE number) {
+  uint32_t base = 0;
+  for (WORD i = 0; i < group; ++i) base += GetActiveProcessorCount(i);
+  return base + number;
+}
+
+// Marks all processors in |mask| of processor |group| as allowed.
+static void iree_task_topology_cpu_limits_allow_group_mask(
+    WORD group, KAFFINITY mask, iree_task_topology_cpu_limits_t* limits) {
+  const uint32_t base = iree_task_topology_processor_limit_id(group, 0);
+  while (mask) {
+    const int bit = iree_task_count_trailing_zeros_kaffinity(mask);
+    mask &= mask - 1;
+    const uint32_t cpu_id = base + (uint32_t)bit;
+    if (cpu_id >= IREE_TASK_TOPOLOGY_MAX_CPU_COUNT) break;
+    limits->allowed_cpu_bits[cpu_id / 64] |= 1ull << (cpu_id % 64);
+  }
+}
+
+// Returns the number of processors worth of CPU time the job object containing
+// the process may consume, rounded up, or 0 if unlimited. Weight-based rate
+// control only affects scheduling relative to other jobs and isn't a cap.
+static iree_host_size_t iree_task_topology_query_job_quota(void) {
+  JOBOBJECT_CPU_RATE_CONTROL_INFORMATION rate_info;
+  memset(&rate_info, 0, sizeof(rate_info));
+  if (!QueryInformationJobObject(NULL, JobObjectCpuRateControlInformation,
+                                 &rate_info, sizeof(rate_info), NULL) ||
+      !(rate_info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_ENABLE)) {
+    return 0;  // not in a job or no rate control
+  }
+  // Rates are in 1/100ths of a percent of the cycles of all processors.
+  uint64_t rate = 0;
+  if (rate_info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_MIN_MAX_RATE) {
+    rate = rate_info.MaxRate;
+  } else if (rate_info.ControlFlags & JOB_OBJECT_CPU_RATE_CONTROL_HARD_CAP) {
+    rate = rate_info.CpuRate;
+  }
+  if (rate == 0 || rate >= 10000) return 0;
+  const uint64_t processor_count =
+      GetActiveProcessorCount(ALL_PROCESSOR_GROUPS);
+  return (iree_host_size_t)iree_max(1, (rate * processor_count + 9999) / 10000);
+}
+
+void iree_task_topology_query_cpu_limits(
+    iree_task_topology_cpu_limits_t* out_limits) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  memset(out_limits, 0, sizeof(*out_limits));
+
+  // Processor groups the process may run in. Processes are confined to a
+  // single group unless they explicitly spread their threads across several,
+  // in which case the process affinity mask cannot be queried and all
+  // processors in the groups are allowed. Job object affinity limits are
+  // already reflected in the process affinity.
+  USHORT group_numbers[64];
+  USHORT group_count = IREE_ARRAYSIZE(group_numbers);
+  if (GetProcessGroupAffinity(GetCurrentProcess(), &group_count,
+                              group_numbers)) {
+    DWORD_PTR process_mask = 0;
+    DWORD_PTR system_mask = 0;
+    if (group_count == 1 &&
+        GetProcessAffinityMask(GetCurrentProcess(), &process_mask,
+                               &system_mask) &&
+        process_mask) {
+      iree_task_topology_cpu_limits_allow_group_mask(
+          group_numbers[0], (KAFFINITY)process_mask, out_limits);
+    } else {
+      for (USHORT i = 0; i < group_count; ++i) {
+        const DWORD processor_count = GetActiveProcessorCount(group_numbers[i]);
+        const KAFFINITY group_mask =
+            processor_count >= sizeof(KAFFINITY) * 8
+                ? ~(KAFFINITY)0
+                : (((KAFFINITY)1 << processor_count) - 1);
+        iree_task_topology_cpu_limits_allow_group_mask(group_numbers[i],
+                                                       group_mask, out_limits);
+      }
+    }
+    for (iree_host_size_t i = 0;
+         i < IREE_ARRAYSIZE(out_limits->allowed_cpu_bits); ++i) {
+      out_limits->allowed_cpu_count +=
+          iree_math_count_ones_u64(out_limits->allowed_cpu_bits[i]);
+    }
+  }
+
+  out_limits->quota_cpu_count = iree_task_topology_query_job_quota();
+
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, out_limits->allowed_cpu_count);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, out_limits->quota_cpu_count);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+//===----------------------------------------------------------------------===//
+// Topology initialization helpers
+//===----------------------------------------------------------------------===//
+
 // Sets |out_affinity| to be pinned to |processor|.
 static void iree_task_topology_set_affinity_from_processor(
     const PROCESSOR_RELATIONSHIP* processor,
@@ -64,6 +162,19 @@ static void iree_task_topology_set_affinity_from_processor(
       iree_task_count_trailing_zeros_kaffinity(processor->GroupMask[0].Mask);
 }
 
+// Returns the NUMA node of the processor |affinity| is pinned to or 0 if the
+// node could not be queried.
+static iree_task_topology_node_id_t iree_task_topology_query_affinity_node(
+    const iree_thread_affinity_t* affinity) {
+  PROCESSOR_NUMBER processor_number;
+  memset(&processor_number, 0, sizeof(processor_number));
+  processor_number.Group = (WORD)affinity->group;
+  processor_number.Number = (BYTE)affinity->id;
+  USHORT node_number = 0;
+  if (!GetNumaProcessorNodeEx(&processor_number, &node_number)) return 0;
+  return (iree_task_topology_node_id_t)node_number;
+}
+
 // Uses |group_mask| to assign |cache| information to select topology groups.
 static void iree_task_topology_assign_cache_info(
     iree_task_topology_t* topology, GROUP_AFFINITY group_mask,
@@ -307,6 +418,7 @@ iree_status_t iree_task_topology_initialize_from_logical_cpu_set(
         affinity->smt = (p->Processor.Flags & LTP_PC_SMT) == LTP_PC_SMT;
         affinity->group = p->Processor.GroupMask[0].Group;
         affinity->id = group_offset + bit_offset;
+        group->node_id = iree_task_topology_query_affinity_node(affinity);
       }
       group_offset += bit_offset + 1;
       if (out_topology->group_count >= cpu_count) break;
@@ -342,6 +454,23 @@ static bool iree_task_topology_core_is_selected(
   }
 }
 
+// Returns true if any processor of |core| may be used under |limits|.
+static bool iree_task_topology_core_is_allowed(
+    const iree_task_topology_cpu_limits_t* limits,
+    const PROCESSOR_RELATIONSHIP* core) {
+  const WORD group = core->GroupMask[0].Group;
+  KAFFINITY mask = core->GroupMask[0].Mask;
+  while (mask) {
+    const int bit = iree_task_count_trailing_zeros_kaffinity(mask);
+    mask &= mask - 1;
+    if (iree_task_topology_cpu_limits_allow(
+            limits, iree_task_topology_processor_limit_id(group, (BYTE)bit))) {
+      return true;
+    }
+  }
+  return false;
+}
+
 iree_status_t iree_task_topology_initialize_from_physical_cores(
     iree_task_topology_node_id_t node_id,
     iree_task_topology_performance_level_t performance_level,
@@ -351,6 +480,11 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
 
   iree_task_topology_initialize(out_topology);
 
+  // Cores are only usable if the process is allowed to run on them and there's
+  // no benefit to running more workers than the job CPU rate allows.
+  iree_task_topology_cpu_limits_t limits;
+  iree_task_topology_query_cpu_limits(&limits);
+
   // Query the total size required for all information and allocate storage for
   // it on the stack - it's generally just a few KB.
   DWORD all_relationships_size = 0;
@@ -434,6 +568,7 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   // Calculate the total number of cores and whether they are homogenous.
   iree_host_size_t total_core_count = 0;
   bool has_heterogeneous_cores = false;
+  BYTE max_efficiency_class = 0;
   for (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX* p = all_relationships;
        p < all_relationships_end;
        p = (SYSTEM_LOGICAL_PROCESSOR_INFORMATION_EX*)((uintptr_t)p + p->Size)) {
@@ -441,6 +576,8 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
       assert(p->Processor.GroupCount == 1);
       ++total_core_count;
       if (p->Processor.EfficiencyClass > 0) has_heterogeneous_cores = true;
+      max_efficiency_class =
+          iree_max(max_efficiency_class, p->Processor.EfficiencyClass);
     }
   }
 
@@ -458,6 +595,10 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
                                                       &p->Processor)) {
         // Core filtered based on performance level setting.
         continue;
+      } else if (!iree_task_topology_core_is_allowed(&limits,
+                                                     &p->Processor)) {
+        // Process affinity excludes all processors of the core.
+        continue;
       }
       group_info_t* group_info = &group_table[p->Processor.GroupMask[0].Group];
       group_info->affinity_mask |= p->Processor.GroupMask[0].Mask;
@@ -488,6 +629,8 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   // This is the number of topology groups we'll create.
   iree_host_size_t used_core_count =
       iree_min(selected_core_count, max_core_count);
+  used_core_count = iree_min(
+      used_core_count, iree_task_topology_cpu_limits_max_concurrency(&limits));
 
   // Check if the current (base) processor is part of the filtered groups.
   // If so we perform rotation to favor cores other than the current one.
@@ -517,23 +660,27 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
   // sense vs being random as it is now.
 
   // Initialize all topology groups from the selected cores.
-  for (iree_host_size_t used_core_index = 0;
-       used_core_index < used_core_count;) {
-    iree_host_size_t adjusted_core_index = used_core_index;
+  for (iree_host_size_t core_index = 0, used_core_index = 0;
+       core_index < total_core_count && used_core_index < used_core_count;
+       ++core_index) {
+    iree_host_size_t adjusted_core_index = core_index;
     if (base_core_index != -1) {
       // Rotate the starting core index by the base core such that we only use
       // the base core if all other available cores are utilized.
       adjusted_core_index =
-          (((base_core_index + 1) % total_core_count) + used_core_index) %
+          (((base_core_index + 1) % total_core_count) + core_index) %
           total_core_count;
     }
 
     PROCESSOR_RELATIONSHIP* core = all_cores[adjusted_core_index];
-    if (!iree_task_topology_core_is_selected(has_heterogeneous_cores,
-                                             performance_level, core)) {
-      // Core filtered out by performance level; skip and try to find another
-      // usable one. Note that cores with different performance levels may be
-      // arbitrarily distributed across the logical core domain.
+    if (!group_table[core->GroupMask[0].Group].selected ||
+        !iree_task_topology_core_is_selected(has_heterogeneous_cores,
+                                             performance_level, core) ||
+        !iree_task_topology_core_is_allowed(&limits, core)) {
+      // Core filtered out by NUMA node, performance level, or process
+      // affinity; skip and try to find another usable one. Note that cores
+      // with different performance levels may be arbitrarily distributed
+      // across the logical core domain.
       continue;
     }
     ++used_core_index;
@@ -545,6 +692,16 @@ iree_status_t iree_task_topology_initialize_from_physical_cores(
     group->constructive_sharing_mask = 0;  // set below
     iree_task_topology_set_affinity_from_processor(
         core, &group->ideal_thread_affinity);
+    group->node_id =
+        iree_task_topology_query_affinity_node(&group->ideal_thread_affinity);
+
+    // Higher efficiency classes are more performant (and less efficient). We
+    // don't know by how much so linearly scale capacity by class.
+    if (has_heterogeneous_cores) {
+      group->compute_capacity = IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE *
+                                (core->EfficiencyClass + 1) /
+                                (max_efficiency_class + 1);
+    }
   }
 
   // Assign constructive sharing masks to each topology group.
@@ -26,25 +26,17 @@ extern "C" {
 // Maximum number of events retained by the executor event pool.
 #define IREE_TASK_EXECUTOR_EVENT_POOL_CAPACITY 64
 
-// Maximum number of simultaneous waits an executor may perform as part of a
-// wait-any operation. A larger value may enable better wake coalescing by the
-// kernel. This is only a count limiting wait tasks that have been scheduled and
-// been promoted to the root executor waiting list. There may be any number of
-// waits deeper in the pipeline so long as they don't all become ready
-// simultaneously.
-//
-// Realistically, though, if we have more than 64 outstanding **root** waits
-// it's hard to reason about if/when the executor queue could make forward
-// progress and indicates a possible error in task assignment.
-//
-// Also, the underlying iree_wait_set_t may not support more than 64 handles on
-// certain platforms without emulation. Trying to keep us on the fast-path
-// with a reasonable number seems fine for now until we have a need for more.
+// Initial number of simultaneous waits the executor poller can perform as part
+// of a wait-any operation. This is only a count of wait tasks that have been
+// scheduled and been promoted to the root executor waiting list. The poller
+// doubles its wait set each time it is exhausted so there is no hard limit
+// other than what the underlying iree_wait_set_t supports on the platform
+// (such as MAXIMUM_WAIT_OBJECTS on Win32).
 //
 // NOTE: we reserve 1 wait handle for our own internal use. This allows us to
 // wake the coordination worker when new work is submitted from external
 // sources.
-#define IREE_TASK_EXECUTOR_MAX_OUTSTANDING_WAITS (64 - 1)
+#define IREE_TASK_EXECUTOR_INITIAL_OUTSTANDING_WAITS (64 - 1)
 
 // Amount of time that can remain in a delay task while still retiring.
 // This prevents additional system sleeps when the remaining time before the
@@ -60,6 +52,20 @@ extern "C" {
 // Setting this to 0 will disable thefts.
 #define IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR (1)
 
+// Default number of consecutive failed attempts a worker makes at stealing
+// tasks from workers on its own NUMA node before it is allowed to steal from
+// workers on other nodes. Remote thefts drag the working set of the stolen
+// tasks across the interconnect and should only happen when the local node has
+// run dry. Setting this to 0 allows remote thefts as soon as a local one fails.
+// Has no effect when all workers of an executor are on the same node.
+#define IREE_TASK_EXECUTOR_DEFAULT_REMOTE_THEFT_ATTEMPT_THRESHOLD (4)
+
+// Default maximum size in bytes each worker will grow its local memory to when
+// dispatches require more than the fixed per-worker reservation. The grown
+// memory is allocated from the heap on first use and cached across dispatches
+// until trimmed. Setting this to 0 disables growth.
+#define IREE_TASK_EXECUTOR_DEFAULT_WORKER_LOCAL_MEMORY_LIMIT (64 * 1024 * 1024)
+
 // Maximum number of tasks that will be stolen in one go from another worker.
 //
 // Too few tasks will cause additional overhead as the worker repeatedly sips
@@ -81,8 +87,9 @@ extern "C" {
   IREE_TASK_EXECUTOR_MAX_WORKER_COUNT
 
 // Number of tiles that will be batched into a single reservation from the grid.
-// This is a maximum; if there are fewer tiles that would otherwise allow for
-// maximum parallelism then this may be ignored.
+// This is a maximum; reservations are sized based on the number of tiles that
+// remain in the grid (see IREE_TASK_DISPATCH_GUIDED_RESERVATION_FACTOR) and
+// will shrink to a single tile as the grid is exhausted.
 //
 // The more tiles reserved at a time the higher the chance for latency to
 // increase as many reserved tiles are held up on one worker while another may
@@ -92,7 +99,29 @@ extern "C" {
 // destroying behavior where multiple workers all stomp on the same cache lines
 // (as say worker 0 and worker 1 both fight over sequential tiles adjacent in
 // memory).
-#define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (8)
+#define IREE_TASK_DISPATCH_MAX_TILES_PER_SHARD_RESERVATION (64)
+
+// Controls how quickly tile reservations shrink as a dispatch grid drains.
+// Each reservation takes 1/(shard_count * factor) of the remaining tiles
+// (guided self-scheduling): early reservations are large and amortize the
+// atomic traffic on the grid while the final reservations are small so that
+// all shards finish at roughly the same time.
+//
+// A factor of 1 is classic guided self-scheduling and may leave the first shard
+// with an outsized amount of work if tiles are non-uniform. Larger factors
+// trade more reservations for better balance.
+#define IREE_TASK_DISPATCH_GUIDED_RESERVATION_FACTOR (2)
+
+// Size in tiles of each side of the square blocks a dispatch grid with
+// IREE_TASK_FLAG_DISPATCH_LOCALITY is traversed in. Tiles within full blocks
+// are visited in Z-order and blocks are visited in row-major order. Must be a
+// power of two.
+//
+// Larger blocks keep more of the traversal compact and improve reuse of the
+// data shared by neighboring tiles (such as matmul operand rows/columns) at
+// the cost of more tiles along the grid edges that don't fill a block falling
+// back to row-major order.
+#define IREE_TASK_DISPATCH_LOCALITY_BLOCK_SIZE (8)
 
 // Whether to enable per-tile colors for each tile tracing zone based on the
 // tile grid xyz. Not cheap and can be disabled to reduce tracing overhead.
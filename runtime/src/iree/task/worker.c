@@ -24,8 +24,10 @@ static int iree_task_worker_main(iree_task_worker_t* worker);
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker) {
+    iree_task_affinity_set_t node_sharing_mask, uint32_t compute_capacity,
+    iree_host_size_t stack_size,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   out_worker->executor = executor;
@@ -34,18 +36,49 @@ iree_status_t iree_task_worker_initialize(
   out_worker->ideal_thread_affinity = topology_group->ideal_thread_affinity;
   out_worker->constructive_sharing_mask =
       topology_group->constructive_sharing_mask;
+  out_worker->node_sharing_mask = node_sharing_mask;
   out_worker->max_theft_attempts =
       executor->worker_count / IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR;
+  out_worker->max_theft_task_count = iree_max(
+      1u, (uint32_t)(IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT * compute_capacity /
+                     IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE));
+  // Only delay remote thefts if there are any remote workers to steal from.
+  const iree_task_affinity_set_t worker_mask =
+      iree_task_affinity_set_ones(executor->worker_count);
+  out_worker->remote_theft_threshold =
+      (node_sharing_mask & worker_mask) == worker_mask
+          ? 0
+          : executor->worker_remote_theft_threshold;
+  out_worker->theft_failure_count = 0;
+  IREE_STATISTICS({
+    iree_atomic_store_int64(&out_worker->steal_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&out_worker->park_count, 0,
+                            iree_memory_order_relaxed);
+    iree_atomic_store_int64(&out_worker->spin_hit_count, 0,
+                            iree_memory_order_relaxed);
+  });
   iree_prng_minilcg128_initialize(iree_prng_splitmix64_next(seed_prng),
                                   &out_worker->theft_prng);
   out_worker->local_memory = local_memory;
+  out_worker->grown_local_memory = iree_byte_span_empty();
+  out_worker->local_memory_high_water = 0;
+  out_worker->trim_epoch =
+      iree_atomic_load_int32(&executor->trim_epoch, iree_memory_order_relaxed);
+  iree_task_pool_cache_initialize(&executor->transient_task_pool,
+                                  &out_worker->task_cache);
   out_worker->processor_id = 0;
   out_worker->processor_tag = 0;
+  out_worker->node_id = topology_group->node_id;
+  out_worker->caches = topology_group->caches;
+  out_worker->compute_capacity = compute_capacity;
 
   iree_notification_initialize(&out_worker->wake_notification);
   iree_notification_initialize(&out_worker->state_notification);
   iree_atomic_task_slist_initialize(&out_worker->mailbox_slist);
-  iree_task_queue_initialize(&out_worker->local_task_queue);
+  for (int i = 0; i < IREE_TASK_SCOPE_PRIORITY_COUNT; ++i) {
+    iree_task_queue_initialize(&out_worker->local_task_queues[i]);
+  }
 
   iree_task_worker_state_t initial_state = IREE_TASK_WORKER_STATE_RUNNING;
   iree_atomic_store_int32(&out_worker->state, initial_state,
@@ -130,12 +163,21 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker) {
   // get anything more posted to it) and then discarding everything we still
   // have a reference to.
   iree_atomic_task_slist_discard(&worker->mailbox_slist);
-  iree_task_list_discard(&worker->local_task_queue.list);
+  for (int i = 0; i < IREE_TASK_SCOPE_PRIORITY_COUNT; ++i) {
+    iree_task_list_discard(&worker->local_task_queues[i].list);
+  }
+  iree_task_pool_cache_deinitialize(&worker->task_cache);
 
   iree_notification_deinitialize(&worker->wake_notification);
   iree_notification_deinitialize(&worker->state_notification);
   iree_atomic_task_slist_deinitialize(&worker->mailbox_slist);
-  iree_task_queue_deinitialize(&worker->local_task_queue);
+  for (int i = 0; i < IREE_TASK_SCOPE_PRIORITY_COUNT; ++i) {
+    iree_task_queue_deinitialize(&worker->local_task_queues[i]);
+  }
+
+  iree_allocator_free_aligned(worker->executor->allocator,
+                              worker->grown_local_memory.data);
+  worker->grown_local_memory = iree_byte_span_empty();
 
   IREE_TRACE_ZONE_END(z0);
 }
@@ -148,22 +190,210 @@ void iree_task_worker_post_tasks(iree_task_worker_t* worker,
   memset(list, 0, sizeof(*list));
 }
 
-iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
-                                             iree_host_size_t max_tasks) {
+// Returns a bitmask of the iree_task_scope_priority_t classes that may have
+// tasks queued on workers.
+static int32_t iree_task_worker_priority_mask(iree_task_worker_t* worker) {
+  int32_t priority_mask = iree_atomic_load_int32(
+      &worker->executor->priority_mask, iree_memory_order_relaxed);
+  return priority_mask ? priority_mask
+                       : (1 << IREE_TASK_SCOPE_PRIORITY_NORMAL);
+}
+
+// Appends a FIFO |list| of tasks to the local queues matching their priority.
+static void iree_task_worker_append_local_fifo_list(iree_task_worker_t* worker,
+                                                    iree_task_list_t* list) {
+  if (iree_task_list_is_empty(list)) return;
+
+  // Fast-path for when only a single priority class is in use: all tasks get
+  // appended to the same queue without needing to walk them.
+  const int32_t priority_mask = iree_task_worker_priority_mask(worker);
+  if (!(priority_mask & (priority_mask - 1))) {
+    iree_task_queue_append_from_fifo_list_unsafe(
+        &worker->local_task_queues[iree_math_count_trailing_zeros_u32(
+            priority_mask)],
+        list);
+    return;
+  }
+
+  // Sort the tasks into per-priority lists (preserving their order) and then
+  // append each list to its queue.
+  iree_task_list_t priority_lists[IREE_TASK_SCOPE_PRIORITY_COUNT];
+  for (int i = 0; i < IREE_TASK_SCOPE_PRIORITY_COUNT; ++i) {
+    iree_task_list_initialize(&priority_lists[i]);
+  }
+  iree_task_t* task = NULL;
+  while ((task = iree_task_list_pop_front(list))) {
+    iree_task_list_push_back(
+        &priority_lists[iree_task_scope_priority(task->scope)], task);
+  }
+  for (int i = 0; i < IREE_TASK_SCOPE_PRIORITY_COUNT; ++i) {
+    iree_task_queue_append_from_fifo_list_unsafe(&worker->local_task_queues[i],
+                                                 &priority_lists[i]);
+  }
+}
+
+void iree_task_worker_append_local_tasks(iree_task_worker_t* worker,
+                                         iree_task_list_t* list) {
+  iree_task_list_reverse(list);
+  iree_task_worker_append_local_fifo_list(worker, list);
+}
+
+// Flushes the worker mailbox into the local queues.
+// Returns true if any tasks were flushed.
+static bool iree_task_worker_flush_mailbox(iree_task_worker_t* worker) {
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  if (!iree_atomic_task_slist_flush(
+          &worker->mailbox_slist,
+          IREE_ATOMIC_SLIST_FLUSH_ORDER_APPROXIMATE_FIFO, &list.head,
+          &list.tail)) {
+    return false;
+  }
+  iree_task_worker_append_local_fifo_list(worker, &list);
+  return true;
+}
+
+// Pops the next task from the highest priority non-empty local queue.
+static iree_task_t* iree_task_worker_pop_local_task(
+    iree_task_worker_t* worker, int32_t priority_mask) {
+  for (int i = IREE_TASK_SCOPE_PRIORITY_COUNT - 1; i >= 0; --i) {
+    if (!(priority_mask & (1 << i))) continue;
+    iree_task_t* task =
+        iree_task_queue_pop_front(&worker->local_task_queues[i]);
+    if (task) return task;
+  }
+  return NULL;
+}
+
+// Returns true if any local queue has tasks.
+// Note that due to races this may return both false-positives and -negatives.
+static bool iree_task_worker_has_local_tasks(iree_task_worker_t* worker) {
+  const int32_t priority_mask = iree_task_worker_priority_mask(worker);
+  for (int i = 0; i < IREE_TASK_SCOPE_PRIORITY_COUNT; ++i) {
+    if ((priority_mask & (1 << i)) &&
+        !iree_task_queue_is_empty(&worker->local_task_queues[i])) {
+      return true;
+    }
+  }
+  return false;
+}
+
+iree_task_t* iree_task_worker_try_steal_task(
+    iree_task_worker_t* worker, iree_task_scope_priority_t priority,
+    iree_task_queue_t* target_queue, iree_host_size_t max_tasks,
+    bool allow_mailbox_theft) {
   // Try to grab tasks from the worker; if more than one task is stolen then the
   // first will be returned and the remaining will be added to the target queue.
-  iree_task_t* task = iree_task_queue_try_steal(&worker->local_task_queue,
-                                                target_queue, max_tasks);
+  iree_task_t* task = iree_task_queue_try_steal(
+      &worker->local_task_queues[priority], target_queue, max_tasks);
   if (task) return task;
 
   // If we still didn't steal any tasks then let's try the slist instead.
-  task = iree_atomic_task_slist_pop(&worker->mailbox_slist);
-  if (task) return task;
+  if (allow_mailbox_theft) {
+    task = iree_atomic_task_slist_pop(&worker->mailbox_slist);
+    if (task) return task;
+  }
 
   return NULL;
 }
 
+// Forwards |task| to one of the workers in |worker_mask| other than |worker|,
+// preferring idle ones. Returns false if none of the workers are live and the
+// task should be executed by the calling worker instead.
+static bool iree_task_worker_forward_task(
+    iree_task_worker_t* worker, iree_task_t* task,
+    iree_task_affinity_set_t worker_mask) {
+  iree_task_executor_t* executor = worker->executor;
+  // Posting back to ourselves would pop the same task again forever.
+  worker_mask &= ~worker->worker_bit;
+  // The masks are accessed with 'relaxed' order because they are just hints.
+  worker_mask &= iree_atomic_task_affinity_set_load(
+      &executor->worker_live_mask, iree_memory_order_relaxed);
+  if (!worker_mask) return false;
+  iree_task_affinity_set_t idle_worker_mask =
+      worker_mask & iree_atomic_task_affinity_set_load(
+                        &executor->worker_idle_mask, iree_memory_order_relaxed);
+  if (idle_worker_mask) worker_mask = idle_worker_mask;
+
+  iree_task_worker_t* target_worker =
+      &executor->workers[iree_task_affinity_set_count_trailing_zeros(
+          worker_mask)];
+  iree_task_list_t list;
+  iree_task_list_initialize(&list);
+  iree_task_list_push_back(&list, task);
+  iree_task_worker_post_tasks(target_worker, &list);
+  iree_notification_post(&target_worker->wake_notification, 1);
+  return true;
+}
+
+// Returns worker local memory of at least |required_size| bytes.
+// The fixed local memory reserved for the worker is used when it is large
+// enough and otherwise the grown local memory is (re)allocated on demand up to
+// the executor limit. If the requirement can't be met the fixed local memory is
+// returned and the dispatch will fail its validation.
+static iree_byte_span_t iree_task_worker_acquire_local_memory(
+    iree_task_worker_t* worker, iree_host_size_t required_size) {
+  worker->local_memory_high_water =
+      iree_max(worker->local_memory_high_water, required_size);
+  if (IREE_LIKELY(required_size <= worker->local_memory.data_length)) {
+    return worker->local_memory;
+  } else if (required_size <= worker->grown_local_memory.data_length) {
+    return worker->grown_local_memory;
+  } else if (required_size > worker->executor->worker_local_memory_limit) {
+    return worker->local_memory;
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)required_size);
+
+  // Grow in powers of two to avoid repeated reallocations when dispatches
+  // slowly ramp up their requirements. The previous contents need not be
+  // preserved.
+  iree_host_size_t new_size = iree_min(
+      (iree_host_size_t)iree_math_round_up_to_pow2_u64(required_size),
+      worker->executor->worker_local_memory_limit);
+  iree_allocator_free_aligned(worker->executor->allocator,
+                              worker->grown_local_memory.data);
+  worker->grown_local_memory = iree_byte_span_empty();
+  void* new_data = NULL;
+  iree_status_t status = iree_allocator_malloc_aligned(
+      worker->executor->allocator, new_size,
+      iree_hardware_destructive_interference_size, 0, &new_data);
+  if (iree_status_is_ok(status)) {
+    worker->grown_local_memory = iree_make_byte_span(new_data, new_size);
+  } else {
+    // The dispatch will fail with RESOURCE_EXHAUSTED.
+    iree_status_ignore(status);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return worker->grown_local_memory.data_length >= required_size
+             ? worker->grown_local_memory
+             : worker->local_memory;
+}
+
+// Handles trim requests made with iree_task_executor_trim since the last time
+// the worker checked. Grown local memory is only retained if a dispatch has
+// required all of it since the previous trim such that steady-state workloads
+// don't reallocate after every trim.
+static void iree_task_worker_trim_if_requested(iree_task_worker_t* worker) {
+  int32_t trim_epoch = iree_atomic_load_int32(&worker->executor->trim_epoch,
+                                              iree_memory_order_acquire);
+  if (IREE_LIKELY(trim_epoch == worker->trim_epoch)) return;
+  worker->trim_epoch = trim_epoch;
+  if (worker->grown_local_memory.data &&
+      iree_math_round_up_to_pow2_u64(worker->local_memory_high_water) <
+          worker->grown_local_memory.data_length) {
+    IREE_TRACE_ZONE_BEGIN(z0);
+    IREE_TRACE_ZONE_APPEND_VALUE_I64(
+        z0, (int64_t)worker->grown_local_memory.data_length);
+    iree_allocator_free_aligned(worker->executor->allocator,
+                                worker->grown_local_memory.data);
+    worker->grown_local_memory = iree_byte_span_empty();
+    IREE_TRACE_ZONE_END(z0);
+  }
+  worker->local_memory_high_water = 0;
+}
+
 // Executes a task on a worker.
 // Only task types that are scheduled to workers are handled; all others must be
 // handled by the coordinator during scheduling.
@@ -184,9 +414,14 @@ static void iree_task_worker_execute(
       break;
     }
     case IREE_TASK_TYPE_DISPATCH_SHARD: {
+      iree_task_dispatch_shard_t* shard_task =
+          (iree_task_dispatch_shard_t*)task;
+      iree_byte_span_t local_memory = iree_task_worker_acquire_local_memory(
+          worker, iree_task_dispatch_shard_local_memory_size(shard_task));
       iree_task_dispatch_shard_execute(
-          (iree_task_dispatch_shard_t*)task, worker->processor_id,
-          worker->worker_index, worker->local_memory, pending_submission);
+          shard_task, worker->processor_id, worker->worker_index,
+          worker->node_id, &worker->caches, worker->compute_capacity,
+          local_memory, pending_submission);
       break;
     }
     default:
@@ -205,23 +440,44 @@ static bool iree_task_worker_pump_once(
     iree_task_worker_t* worker, iree_task_submission_t* pending_submission) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
-  // Check the local work queue for any work we know we should start
-  // processing immediately. Other workers may try to steal some of this work
-  // if we take too long.
-  iree_task_t* task = iree_task_queue_pop_front(&worker->local_task_queue);
-
-  // Check the mailbox to see if we have incoming work that has been posted.
-  // We try to greedily move it to our local work list so that we can work
-  // with the full thread-local pending task list.
-  if (!task) {
-    // NOTE: there's a potential for theft pessimization if the queue runs too
-    // low and there's nothing there when a thief goes to grab some tasks. A
-    // standout there would indicate that we weren't scheduling very well in the
-    // first place (large uneven workloads for various workers, bad distribution
-    // in the face of heterogenous multi-core architectures where some workers
-    // complete tasks faster than others, etc).
-    task = iree_task_queue_flush_from_lifo_slist(&worker->local_task_queue,
-                                                 &worker->mailbox_slist);
+  iree_task_t* task = NULL;
+  const int32_t priority_mask = iree_task_worker_priority_mask(worker);
+  if (!(priority_mask & (priority_mask - 1))) {
+    // Only a single priority class is in use and we can use a single queue.
+    iree_task_queue_t* local_task_queue =
+        &worker->local_task_queues[iree_math_count_trailing_zeros_u32(
+            priority_mask)];
+
+    // Check the local work queue for any work we know we should start
+    // processing immediately. Other workers may try to steal some of this work
+    // if we take too long.
+    task = iree_task_queue_pop_front(local_task_queue);
+
+    // Check the mailbox to see if we have incoming work that has been posted.
+    // We try to greedily move it to our local work list so that we can work
+    // with the full thread-local pending task list.
+    //
+    // NOTE: if the first task of another priority class is posted while we
+    // are flushing it may end up in this queue; this only impacts the order
+    // in which it is executed.
+    if (!task) {
+      // NOTE: there's a potential for theft pessimization if the queue runs too
+      // low and there's nothing there when a thief goes to grab some tasks. A
+      // standout there would indicate that we weren't scheduling very well in
+      // the first place (large uneven workloads for various workers, bad
+      // distribution in the face of heterogenous multi-core architectures
+      // where some workers complete tasks faster than others, etc).
+      task = iree_task_queue_flush_from_lifo_slist(local_task_queue,
+                                                   &worker->mailbox_slist);
+    }
+  } else {
+    // Multiple priority classes are in use and the mailbox may contain higher
+    // priority tasks than what we have queued locally. We always flush the
+    // mailbox first so that newly posted high priority tasks jump ahead of
+    // everything of lower priority.
+    iree_task_worker_flush_mailbox(worker);
+    task = iree_task_worker_pop_local_task(
+        worker, iree_task_worker_priority_mask(worker));
   }
 
 #if IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
@@ -229,12 +485,46 @@ static bool iree_task_worker_pump_once(
   // from other workers that we hopefully share some of the cache hierarchy
   // with. Their tasks will be moved from their local queue into ours and the
   // the first task in the queue is popped off and returned.
+  //
+  // Workers on other NUMA nodes are only stolen from after we've repeatedly
+  // failed to find work on our own node. Until then we report that pumping
+  // should continue so that we retry the local victims (which may have had
+  // more work posted to them in the meantime) instead of going idle.
+  //
+  // Workers of linked peer executors (usually pinned to other NUMA nodes) are
+  // treated the same as remote workers in our own executor and only stolen
+  // from once local thefts have repeatedly failed.
   if (!task) {
+    const bool has_peers = iree_task_executor_has_peers(worker->executor);
+    const uint32_t remote_theft_threshold =
+        has_peers ? worker->executor->worker_remote_theft_threshold
+                  : worker->remote_theft_threshold;
+    const bool allow_remote_theft =
+        worker->theft_failure_count >= remote_theft_threshold;
     task = iree_task_executor_try_steal_task(
         worker->executor, worker->constructive_sharing_mask,
-        worker->max_theft_attempts, &worker->theft_prng,
-        &worker->local_task_queue);
+        worker->node_sharing_mask, allow_remote_theft,
+        worker->max_theft_attempts, worker->max_theft_task_count,
+        &worker->theft_prng, worker->local_task_queues);
+    if (!task && allow_remote_theft && has_peers) {
+      task = iree_task_executor_try_steal_task_from_peers(
+          worker->executor, worker->max_theft_attempts,
+          worker->max_theft_task_count, &worker->theft_prng,
+          worker->local_task_queues);
+    }
+    IREE_STATISTICS({
+      if (task) {
+        iree_atomic_fetch_add_int64(&worker->steal_count, 1,
+                                    iree_memory_order_relaxed);
+      }
+    });
+    if (!task && !allow_remote_theft) {
+      ++worker->theft_failure_count;
+      IREE_TRACE_ZONE_END(z0);
+      return true;  // try again
+    }
   }
+  if (task) worker->theft_failure_count = 0;
 #endif  // IREE_TASK_EXECUTOR_MAX_THEFT_ATTEMPTS_DIVISOR > 0
 
   // No tasks to run; let the caller know we want to wait for more.
@@ -243,6 +533,20 @@ static bool iree_task_worker_pump_once(
     return false;
   }
 
+  // Tasks from scopes that have reserved other workers (which we may have
+  // stolen) are forwarded to one of the reserved workers. Task affinity is
+  // only a placement hint and stealing tasks away from the workers they were
+  // posted to is otherwise allowed. The decision is made on the same mask the
+  // task is forwarded to: pinned tasks that don't overlap the scope reservation
+  // keep their affinity set and must run here if this worker is in it.
+  const iree_task_affinity_set_t task_worker_mask =
+      iree_task_executor_task_worker_mask(worker->executor, task);
+  if (IREE_UNLIKELY(!(task_worker_mask & worker->worker_bit)) &&
+      iree_task_worker_forward_task(worker, task, task_worker_mask)) {
+    IREE_TRACE_ZONE_END(z0);
+    return true;  // try again
+  }
+
   // Execute the task (may call out to arbitrary user code and may submit more
   // tasks for execution).
   iree_task_worker_execute(worker, task, pending_submission);
@@ -256,6 +560,67 @@ static void iree_task_worker_update_processor_id(iree_task_worker_t* worker) {
   iree_cpu_requery_processor_id(&worker->processor_tag, &worker->processor_id);
 }
 
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+// Process-wide counters of how worker waits were resolved. Only used for
+// plotting in traces.
+static iree_atomic_int64_t iree_task_worker_spin_hit_count =
+    IREE_ATOMIC_VAR_INIT(0);
+static iree_atomic_int64_t iree_task_worker_park_count =
+    IREE_ATOMIC_VAR_INIT(0);
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+
+// Waits for the worker to be woken using the |wait_token| acquired from the
+// worker wake notification.
+//
+// Workers first spin for up to the executor worker_spin_ns (yielding the
+// processor to SMT siblings) and then park in the kernel. Spinning avoids the
+// cost of a full wake-up (syscall + reschedule) when work arrives shortly after
+// the worker goes idle, such as with back-to-back small dispatches, at the cost
+// of burning CPU time while idle.
+static void iree_task_worker_wait_for_work(iree_task_worker_t* worker,
+                                           iree_wait_token_t wait_token) {
+  const iree_duration_t spin_ns = worker->executor->worker_spin_ns;
+  if (spin_ns == IREE_DURATION_ZERO) {
+    // Park immediately.
+    IREE_STATISTICS(iree_atomic_fetch_add_int64(&worker->park_count, 1,
+                                                iree_memory_order_relaxed));
+    iree_notification_commit_wait(&worker->wake_notification, wait_token,
+                                  /*spin_ns=*/IREE_DURATION_ZERO,
+                                  /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+    return;
+  }
+
+  // The notification will spin prior to parking. We can't observe which way
+  // the wait was resolved and instead infer it from the time taken: if we woke
+  // before the spin budget was exhausted we never parked. Platforms without
+  // futex support park immediately and any quick wake is counted as a hit.
+  const iree_time_t spin_start_ns = iree_time_now();
+  iree_notification_commit_wait(&worker->wake_notification, wait_token,
+                                spin_ns,
+                                /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+  const bool spin_hit = iree_time_now() - spin_start_ns < spin_ns;
+  (void)spin_hit;
+  IREE_STATISTICS(iree_atomic_fetch_add_int64(
+      spin_hit ? &worker->spin_hit_count : &worker->park_count, 1,
+      iree_memory_order_relaxed));
+
+#if IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+  if (spin_hit) {
+    IREE_TRACE_PLOT_VALUE_I64(
+        "iree-task-worker-spin-hits",
+        iree_atomic_fetch_add_int64(&iree_task_worker_spin_hit_count, 1,
+                                    iree_memory_order_relaxed) +
+            1);
+  } else {
+    IREE_TRACE_PLOT_VALUE_I64(
+        "iree-task-worker-parks",
+        iree_atomic_fetch_add_int64(&iree_task_worker_park_count, 1,
+                                    iree_memory_order_relaxed) +
+            1);
+  }
+#endif  // IREE_TRACING_FEATURES & IREE_TRACING_FEATURE_INSTRUMENTATION
+}
+
 // Alternates between pumping ready tasks in the worker queue and waiting
 // for more tasks to arrive. Only returns when the worker has been asked by
 // the executor to exit.
@@ -298,6 +663,9 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
       break;
     }
 
+    // Release cached resources if the executor has been trimmed.
+    iree_task_worker_trim_if_requested(worker);
+
     // TODO(benvanik): we could try to update the processor ID here before we
     // begin a new batch of work - assuming it's not too expensive.
 
@@ -341,24 +709,26 @@ static void iree_task_worker_pump_until_exit(iree_task_worker_t* worker) {
     // If nothing has been enqueued since we started this loop (so even
     // coordination didn't find anything) we go idle. Otherwise we fall
     // through and try the loop again.
-    if (schedule_dirty ||
-        !iree_task_queue_is_empty(&worker->local_task_queue)) {
+    if (schedule_dirty || iree_task_worker_has_local_tasks(worker)) {
       // Have more work to do; loop around to try another pump.
       iree_notification_cancel_wait(&worker->wake_notification);
     } else {
       // Spin/wait in the kernel. We don't care if the condition fails as we're
-      // just using it as a pulse.
+      // just using it as a pulse. Cached tasks are returned first so that
+      // they are available to other threads while we are idle.
+      iree_task_pool_cache_flush(&worker->task_cache);
       IREE_TRACE_ZONE_BEGIN_NAMED(z_wait,
                                   "iree_task_worker_main_pump_wake_wait");
-      iree_notification_commit_wait(
-          &worker->wake_notification, wait_token,
-          /*spin_ns=*/worker->executor->worker_spin_ns,
-          /*deadline_ns=*/IREE_TIME_INFINITE_FUTURE);
+      iree_task_worker_wait_for_work(worker, wait_token);
       IREE_TRACE_ZONE_END(z_wait);
 
       // Woke from a wait - query the processor ID in case we migrated during
       // the sleep.
       iree_task_worker_update_processor_id(worker);
+
+      // Start over with node-local thefts as whatever we failed to find before
+      // the wait is likely stale now.
+      worker->theft_failure_count = 0;
     }
 
     // Wait completed.
@@ -388,7 +758,10 @@ static int iree_task_worker_main(iree_task_worker_t* worker) {
       IREE_TASK_WORKER_STATE_EXITING;
   if (IREE_LIKELY(should_run)) {
     // << work happens here >>
+    iree_task_pool_cache_bind(&worker->task_cache);
     iree_task_worker_pump_until_exit(worker);
+    iree_task_pool_cache_bind(NULL);
+    iree_task_pool_cache_flush(&worker->task_cache);
   }
 
   IREE_TRACE_ZONE_END(thread_zone);
@@ -17,7 +17,9 @@
 #include "iree/task/affinity_set.h"
 #include "iree/task/executor.h"
 #include "iree/task/list.h"
+#include "iree/task/pool.h"
 #include "iree/task/queue.h"
+#include "iree/task/scope.h"
 #include "iree/task/task.h"
 #include "iree/task/topology.h"
 #include "iree/task/tuning.h"
@@ -98,15 +100,44 @@ typedef struct iree_task_worker_t {
   // all share the same L3 cache.
   iree_task_affinity_set_t constructive_sharing_mask;
 
+  // A bitmask of other group indices that are on the same NUMA node as this
+  // worker. Workers not in this mask are only stolen from after
+  // remote_theft_threshold consecutive failed attempts to steal locally.
+  iree_task_affinity_set_t node_sharing_mask;
+
   // Maximum number of attempts to make when trying to steal tasks from other
   // workers. This could be 64 (try stealing from all workers) or just a handful
   // (try stealing from these 3 other cores that share your L3 cache).
   uint32_t max_theft_attempts;
 
+  // Maximum number of tasks to steal from a victim at a time. Scaled down
+  // from IREE_TASK_EXECUTOR_MAX_THEFT_TASK_COUNT on lower capacity processors
+  // so that they don't hoard work the performance workers could complete
+  // sooner.
+  uint32_t max_theft_task_count;
+
+  // Number of consecutive failed node-local theft attempts required before
+  // stealing from workers on other NUMA nodes. 0 if all workers are on the same
+  // node (or remote thefts are always allowed).
+  uint32_t remote_theft_threshold;
+
+  // Number of consecutive node-local theft attempts that have failed.
+  // Only ever touched by the worker thread as it steals work.
+  uint32_t theft_failure_count;
+
   // Rotation counter for work stealing (ensures we don't favor one victim).
   // Only ever touched by the worker thread as it steals work.
   iree_prng_minilcg128_state_t theft_prng;
 
+#if IREE_STATISTICS_ENABLE
+  // Counters only written by the worker thread and summed on demand by
+  // iree_task_executor_query_statistics. Relaxed atomics keep the reads racy
+  // but well-defined without costing the worker anything measurable.
+  iree_atomic_int64_t steal_count;
+  iree_atomic_int64_t park_count;
+  iree_atomic_int64_t spin_hit_count;
+#endif  // IREE_STATISTICS_ENABLE
+
   // Thread handle of the worker. If the thread has exited the handle will
   // remain valid so that the executor can query its state.
   iree_thread_t* thread;
@@ -120,8 +151,19 @@ typedef struct iree_task_worker_t {
   // An opaque tag used to reduce the cost of processor ID queries.
   iree_cpu_processor_tag_t processor_tag;
 
-  // Destructive interference padding between the mailbox and local task queue
-  // to ensure that the worker - who is pounding on local_task_queue - doesn't
+  // NUMA node and cache sizes of the processor the worker is assigned to in
+  // the topology. Passed to dispatch tiles as hints.
+  iree_task_topology_node_id_t node_id;
+  iree_task_topology_caches_t caches;
+
+  // Compute capacity of the processor the worker is assigned to relative to
+  // the most capable processor used by the executor in the range
+  // [1, IREE_TASK_TOPOLOGY_COMPUTE_CAPACITY_SCALE]. Dispatch shards executing
+  // on the worker size their tile reservations by it.
+  uint32_t compute_capacity;
+
+  // Destructive interference padding between the mailbox and local task queues
+  // to ensure that the worker - who is pounding on local_task_queues - doesn't
   // contend with submissions or coordinators dropping new tasks in the mailbox.
   //
   // Today we don't need this, however on 32-bit systems or if we adjust the
@@ -137,30 +179,54 @@ typedef struct iree_task_worker_t {
   // workers.
   iree_byte_span_t local_memory;
 
-  // Worker-local FIFO queue containing the tasks that will be processed by the
-  // worker. This queue supports work-stealing by other workers if they run out
-  // of work of their own.
+  // Heap-allocated local memory used by dispatches that require more than
+  // |local_memory| provides. Grown on demand up to the executor limit and
+  // cached across dispatches until trimmed. Only accessed by the worker thread.
+  iree_byte_span_t grown_local_memory;
+  // Largest local memory size required by any dispatch executed by the worker
+  // since the last trim. Used to decide whether the grown memory is retained.
+  iree_host_size_t local_memory_high_water;
+  // Last observed value of the executor trim_epoch.
+  int32_t trim_epoch;
+
+  // Cache of executor transient tasks bound to the worker thread. Dispatch
+  // shards retired on the worker (and acquired when it coordinates) cycle
+  // through the cache without touching the shared pool. Flushed prior to
+  // parking. Only accessed by the worker thread.
+  iree_task_pool_cache_t task_cache;
+
+  // Worker-local FIFO queues containing the tasks that will be processed by the
+  // worker, one per iree_task_scope_priority_t class. Higher priority queues
+  // are drained first. These queues support work-stealing by other workers if
+  // they run out of work of their own.
   // LAYOUT: must be 64b away from mailbox_slist.
-  iree_task_queue_t local_task_queue;
+  iree_task_queue_t local_task_queues[IREE_TASK_SCOPE_PRIORITY_COUNT];
 } iree_task_worker_t;
 static_assert(offsetof(iree_task_worker_t, mailbox_slist) +
                       sizeof(iree_atomic_task_slist_t) <
                   iree_hardware_constructive_interference_size,
               "mailbox_slist must be in the first cache line");
-static_assert(offsetof(iree_task_worker_t, local_task_queue) >=
+static_assert(offsetof(iree_task_worker_t, local_task_queues) >=
                   iree_hardware_constructive_interference_size,
-              "local_task_queue must be separated from mailbox_slist by "
+              "local_task_queues must be separated from mailbox_slist by "
               "at least a cache line");
 
 // Initializes a worker by creating its thread and configuring it for receiving
 // tasks. Where supported the worker will be created in a suspended state so
 // that we aren't creating a thundering herd on startup:
 // https://en.wikipedia.org/wiki/Thundering_herd_problem
+//
+// |node_sharing_mask| indicates which other workers are on the same NUMA node
+// as the worker and is used to tier work stealing. |compute_capacity| is the
+// capacity of the worker processor relative to the most capable processor used
+// by the executor.
 iree_status_t iree_task_worker_initialize(
     iree_task_executor_t* executor, iree_host_size_t worker_index,
     const iree_task_topology_group_t* topology_group,
-    iree_host_size_t stack_size, iree_byte_span_t local_memory,
-    iree_prng_splitmix64_state_t* seed_prng, iree_task_worker_t* out_worker);
+    iree_task_affinity_set_t node_sharing_mask, uint32_t compute_capacity,
+    iree_host_size_t stack_size,
+    iree_byte_span_t local_memory, iree_prng_splitmix64_state_t* seed_prng,
+    iree_task_worker_t* out_worker);
 
 // Requests that the worker begin exiting (if it hasn't already).
 // If the worker is actively processing tasks it will wait until it has
@@ -190,14 +256,23 @@ void iree_task_worker_deinitialize(iree_task_worker_t* worker);
 void iree_task_worker_post_tasks(iree_task_worker_t* worker,
                                  iree_task_list_t* list);
 
-// Tries to steal up to |max_tasks| from the back of the queue.
+// Appends a LIFO list of tasks to the worker's local queues.
+// Tasks are sorted into the queue matching the priority of their scope.
+//
+// Must only be called from the worker thread.
+void iree_task_worker_append_local_tasks(iree_task_worker_t* worker,
+                                         iree_task_list_t* list);
+
+// Tries to steal up to |max_tasks| from the back of the |priority| queue.
 // Returns NULL if no tasks are available and otherwise up to |max_tasks| tasks
 // that were at the tail of the worker FIFO will be moved to the |target_queue|
 // and the first of the stolen tasks is returned. While tasks from the FIFO
-// are preferred this may also steal tasks from the mailbox.
-iree_task_t* iree_task_worker_try_steal_task(iree_task_worker_t* worker,
-                                             iree_task_queue_t* target_queue,
-                                             iree_host_size_t max_tasks);
+// are preferred this may also steal tasks of any priority from the mailbox if
+// |allow_mailbox_theft| is set.
+iree_task_t* iree_task_worker_try_steal_task(
+    iree_task_worker_t* worker, iree_task_scope_priority_t priority,
+    iree_task_queue_t* target_queue, iree_host_size_t max_tasks,
+    bool allow_mailbox_theft);
 
 #ifdef __cplusplus
 }  // extern "C"
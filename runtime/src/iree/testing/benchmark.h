@@ -177,6 +177,22 @@ void iree_benchmark_set_bytes_processed(iree_benchmark_state_t* state,
 void iree_benchmark_set_items_processed(iree_benchmark_state_t* state,
                                         int64_t items);
 
+enum iree_benchmark_counter_flag_bits_t {
+  IREE_BENCHMARK_COUNTER_FLAG_NONE = 0u,
+  // The value is divided by the benchmark duration when reported, like the
+  // bytes/s and items/s labels.
+  IREE_BENCHMARK_COUNTER_FLAG_IS_RATE = 1u << 0,
+};
+typedef uint32_t iree_benchmark_counter_flags_t;
+
+// Adds a user counter with the given |name| and |value|, reported alongside
+// the timing and in the machine-readable (e.g. JSON) outputs.
+//
+// REQUIRES: must only be called outside of the benchmark step loop.
+void iree_benchmark_set_counter(iree_benchmark_state_t* state,
+                                const char* name, double value,
+                                iree_benchmark_counter_flags_t flags);
+
 //===----------------------------------------------------------------------===//
 // iree_benchmark_def_t
 //===----------------------------------------------------------------------===//
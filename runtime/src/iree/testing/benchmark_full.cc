@@ -77,6 +77,16 @@ void iree_benchmark_set_items_processed(iree_benchmark_state_t* state,
   s.SetItemsProcessed(items);
 }
 
+void iree_benchmark_set_counter(iree_benchmark_state_t* state,
+                                const char* name, double value,
+                                iree_benchmark_counter_flags_t flags) {
+  auto& s = GetBenchmarkState(state);
+  s.counters[name] = benchmark::Counter(
+      value, (flags & IREE_BENCHMARK_COUNTER_FLAG_IS_RATE)
+                 ? benchmark::Counter::kIsRate
+                 : benchmark::Counter::kDefaults);
+}
+
 //===----------------------------------------------------------------------===//
 // iree_benchmark_def_t
 //===----------------------------------------------------------------------===//
@@ -9,6 +9,7 @@
 #include <math.h>
 
 #include "iree/base/internal/math.h"
+#include "iree/base/internal/threading.h"
 
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_equality_t
@@ -55,145 +56,645 @@ static iree_status_t iree_hal_append_element_mismatch_string(
   return iree_ok_status();
 }
 
-static bool iree_hal_compare_strided_elements_exact(
-    iree_hal_element_type_t element_type, iree_host_size_t element_count,
-    iree_const_byte_span_t expected_elements, iree_host_size_t expected_stride,
-    iree_const_byte_span_t actual_elements, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  const iree_host_size_t element_size =
-      iree_hal_element_dense_byte_count(element_type);
-  const uint8_t* expected_ptr = expected_elements.data;
-  const uint8_t* actual_ptr = actual_elements.data;
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    int cmp = memcmp(expected_ptr, actual_ptr, element_size);
-    if (cmp != 0) {
-      *out_index = i;
-      return false;
-    }
-    expected_ptr += expected_stride * element_size;
-    actual_ptr += actual_stride * element_size;
+// Number of elements compared per block. Blocks are small enough that the
+// broadcast scratch and working sets stay in L1 while amortizing the per-block
+// bookkeeping of the branch-free inner loops.
+#define IREE_HAL_COMPARE_BLOCK_SIZE 1024
+
+// Minimum number of elements assigned to each worker thread. Smaller
+// comparisons run entirely on the calling thread.
+#define IREE_HAL_COMPARE_MIN_ELEMENTS_PER_WORKER (1024 * 1024)
+
+// Element comparison kernel selected once per comparison.
+typedef enum {
+  // Bitwise comparison of 1/2/4/8-byte elements.
+  IREE_HAL_COMPARE_KERNEL_X8 = 0,
+  IREE_HAL_COMPARE_KERNEL_X16,
+  IREE_HAL_COMPARE_KERNEL_X32,
+  IREE_HAL_COMPARE_KERNEL_X64,
+  // Bitwise comparison of elements of any other size.
+  IREE_HAL_COMPARE_KERNEL_BYTES,
+  // Floating-point comparisons with error statistics.
+  IREE_HAL_COMPARE_KERNEL_F16,
+  IREE_HAL_COMPARE_KERNEL_BF16,
+  IREE_HAL_COMPARE_KERNEL_F32,
+  IREE_HAL_COMPARE_KERNEL_F64,
+} iree_hal_compare_kernel_t;
+
+// Loop-invariant parameters of the floating-point kernels. All modes are
+// folded into the same predicate so that the inner loops have no mode switches:
+//   match = bits(a) == bits(b) ||
+//           (approximate &&
+//            (a == b || (isnan(a) && isnan(b)) ||
+//             (!isnan(a) && !isnan(b) &&
+//              (abs(a - b) <= threshold + relative_tolerance * abs(b) ||
+//               ulp_distance(a, b) <= max_ulp_distance))))
+typedef struct {
+  bool approximate;
+  double threshold;
+  double relative_tolerance;
+  uint64_t max_ulp_distance;
+} iree_hal_compare_params_t;
+
+// Read-only state shared by all slices of a comparison.
+typedef struct {
+  iree_hal_compare_kernel_t kernel;
+  iree_hal_compare_params_t params;
+  iree_host_size_t element_size;
+  // When true |expected| is a single element compared against all of |actual|.
+  bool broadcast;
+  const uint8_t* expected;
+  const uint8_t* actual;
+} iree_hal_compare_state_t;
+
+// A contiguous range of elements compared by a single thread.
+typedef struct {
+  const iree_hal_compare_state_t* state;
+  iree_host_size_t begin;
+  iree_host_size_t end;
+  // Stops after the first block containing a mismatch.
+  bool stop_on_mismatch;
+  // Results local to the slice; indices are absolute.
+  iree_hal_buffer_comparison_stats_t stats;
+} iree_hal_compare_slice_t;
+
+static iree_hal_compare_kernel_t iree_hal_compare_select_kernel(
+    iree_hal_element_type_t element_type, iree_host_size_t element_size) {
+  switch (element_type) {
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+      return IREE_HAL_COMPARE_KERNEL_F16;
+    case IREE_HAL_ELEMENT_TYPE_BFLOAT_16:
+      return IREE_HAL_COMPARE_KERNEL_BF16;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+      return IREE_HAL_COMPARE_KERNEL_F32;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
+      return IREE_HAL_COMPARE_KERNEL_F64;
+    default:
+      break;
+  }
+  switch (element_size) {
+    case 1:
+      return IREE_HAL_COMPARE_KERNEL_X8;
+    case 2:
+      return IREE_HAL_COMPARE_KERNEL_X16;
+    case 4:
+      return IREE_HAL_COMPARE_KERNEL_X32;
+    case 8:
+      return IREE_HAL_COMPARE_KERNEL_X64;
+    default:
+      return IREE_HAL_COMPARE_KERNEL_BYTES;
   }
-  return true;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f16(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
-    const uint16_t* expected_ptr, iree_host_size_t expected_stride,
-    const uint16_t* actual_ptr, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabsf(iree_math_f16_to_f32(*expected_ptr) -
-              iree_math_f16_to_f32(*actual_ptr)) > equality.f16_threshold) {
-      *out_index = i;
-      return false;
-    }
-    expected_ptr += expected_stride;
-    actual_ptr += actual_stride;
+static iree_hal_compare_params_t iree_hal_compare_select_params(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type) {
+  iree_hal_compare_params_t params = {
+      .approximate = equality.mode != IREE_HAL_BUFFER_EQUALITY_EXACT,
+      .threshold = 0.0,
+      .relative_tolerance = 0.0,
+      .max_ulp_distance = 0,
+  };
+  if (equality.mode == IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ULP) {
+    // No absolute difference is small enough to match on its own.
+    params.threshold = -1.0;
+    params.max_ulp_distance = equality.max_ulp_distance;
+    return params;
   }
-  return true;
+  switch (element_type) {
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
+      params.threshold = equality.f16_threshold;
+      break;
+    case IREE_HAL_ELEMENT_TYPE_BFLOAT_16:
+      params.threshold = equality.bf16_threshold;
+      break;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
+      params.threshold = equality.f32_threshold;
+      break;
+    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
+      params.threshold = equality.f64_threshold;
+      break;
+    default:
+      break;
+  }
+  if (equality.mode == IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE) {
+    params.relative_tolerance = equality.relative_tolerance;
+  }
+  return params;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f32(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
-    const float* expected_ptr, iree_host_size_t expected_stride,
-    const float* actual_ptr, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabsf(*expected_ptr - *actual_ptr) > equality.f32_threshold) {
-      *out_index = i;
-      return false;
-    }
-    expected_ptr += expected_stride;
-    actual_ptr += actual_stride;
+// Maps a sign-magnitude floating-point bit pattern with the given |sign_bit|
+// onto an unsigned line where adjacent representable values differ by 1 and
+// -0/+0 coincide. The distance between two mapped values is the ULP distance.
+static inline uint32_t iree_hal_compare_ordered_bits_u32(uint32_t bits,
+                                                         uint32_t sign_bit) {
+  return (bits & sign_bit) ? sign_bit - (bits ^ sign_bit) : sign_bit + bits;
+}
+static inline uint64_t iree_hal_compare_ordered_bits_u64(uint64_t bits,
+                                                         uint64_t sign_bit) {
+  return (bits & sign_bit) ? sign_bit - (bits ^ sign_bit) : sign_bit + bits;
+}
+
+static inline float iree_hal_compare_f32_value(uint32_t bits) {
+  float value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+static inline uint32_t iree_hal_compare_f32_bits(float value) {
+  uint32_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+static inline double iree_hal_compare_f64_value(uint64_t bits) {
+  double value;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+static inline uint64_t iree_hal_compare_f64_bits(double value) {
+  uint64_t bits;
+  memcpy(&bits, &value, sizeof(bits));
+  return bits;
+}
+
+// Exact f16 widening (including subnormals) using masks instead of branches so
+// that it can be vectorized. iree_math_f16_to_f32 flushes subnormals and
+// branches per element.
+static inline float iree_hal_compare_f16_value(uint16_t bits) {
+  const uint32_t sign = (uint32_t)(bits & 0x8000u) << 16;
+  const uint32_t magnitude = bits & 0x7FFFu;
+  const uint32_t normal_bits = (magnitude << 13) + ((127u - 15u) << 23);
+  const uint32_t special_bits = (magnitude << 13) | 0x7F800000u;
+  const uint32_t subnormal_bits =
+      iree_hal_compare_f32_bits((float)(int32_t)magnitude * 0x1p-24f);
+  const uint32_t is_special = 0u - (uint32_t)(magnitude >= 0x7C00u);
+  const uint32_t is_subnormal = 0u - (uint32_t)(magnitude < 0x0400u);
+  return iree_hal_compare_f32_value(
+      sign | (special_bits & is_special) | (subnormal_bits & is_subnormal) |
+      (normal_bits & ~(is_special | is_subnormal)));
+}
+
+// bf16 is the upper half of an f32 so widening is exact.
+static inline float iree_hal_compare_bf16_value(uint16_t bits) {
+  return iree_hal_compare_f32_value((uint32_t)bits << 16);
+}
+
+// Defines a per-element predicate and a block kernel for a floating-point type
+// stored as |bits_t| and compared as |value_t|. Error statistics are gathered
+// in all modes. The block kernel returns the number of mismatching elements
+// and folds the error maxima into |stats|.
+//
+// The loop body is kept free of control flow and floating-point selects or
+// reductions so that compilers vectorize it without fast-math: the errors are
+// non-negative and their maxima are tracked on the |uint_t| bit patterns, which
+// order the same way, with NaNs masked to zero.
+#define IREE_HAL_DEFINE_COMPARE_FLOAT_KERNEL(                                 \
+    name, bits_t, value_t, value_name, uint_t, uint_name, sign_bit, abs_fn)   \
+  static inline bool iree_hal_compare_element_##name(                         \
+      bool approximate, value_t threshold, value_t relative_tolerance,        \
+      uint_t max_ulp_distance, bits_t expected_bits, bits_t actual_bits,      \
+      uint_t* out_absolute_error, uint_t* out_relative_error,                 \
+      uint_t* out_ulp_distance) {                                             \
+    const value_t expected = iree_hal_compare_##name##_value(expected_bits);  \
+    const value_t actual = iree_hal_compare_##name##_value(actual_bits);      \
+    const bool expected_nan = expected != expected;                           \
+    const bool actual_nan = actual != actual;                                 \
+    const bool any_nan = expected_nan | actual_nan;                           \
+    const value_t absolute_error = abs_fn(actual - expected);                 \
+    const value_t expected_magnitude = abs_fn(expected);                      \
+    const uint_t expected_ordered =                                           \
+        iree_hal_compare_ordered_bits_##uint_name(expected_bits, (sign_bit)); \
+    const uint_t actual_ordered =                                             \
+        iree_hal_compare_ordered_bits_##uint_name(actual_bits, (sign_bit));   \
+    const uint_t ulp_distance = expected_ordered > actual_ordered             \
+                                    ? expected_ordered - actual_ordered       \
+                                    : actual_ordered - expected_ordered;      \
+    const value_t tolerance =                                                 \
+        threshold + relative_tolerance * expected_magnitude;                  \
+    const bool is_close = (absolute_error <= tolerance) |                     \
+                          (ulp_distance <= max_ulp_distance);                 \
+    const bool is_match =                                                     \
+        (expected_bits == actual_bits) |                                      \
+        (approximate & ((expected == actual) | (!any_nan & is_close) |        \
+                        (expected_nan & actual_nan)));                        \
+    const uint_t valid_mask = (uint_t)0 - (uint_t)!any_nan;                   \
+    const uint_t nonzero_mask =                                               \
+        (uint_t)0 - (uint_t)(expected_magnitude > (value_t)0);                \
+    *out_absolute_error =                                                     \
+        iree_hal_compare_##value_name##_bits(absolute_error) & valid_mask;    \
+    *out_relative_error = iree_hal_compare_##value_name##_bits(               \
+                              absolute_error / expected_magnitude) &          \
+                          valid_mask & nonzero_mask;                          \
+    *out_ulp_distance = ulp_distance & valid_mask;                            \
+    return !is_match;                                                         \
+  }                                                                           \
+  static iree_host_size_t iree_hal_compare_block_##name(                      \
+      const iree_hal_compare_params_t* params, iree_host_size_t count,        \
+      const bits_t* expected, const bits_t* actual,                           \
+      iree_hal_buffer_comparison_stats_t* stats) {                            \
+    const bool approximate = params->approximate;                             \
+    const value_t threshold = (value_t)params->threshold;                     \
+    const value_t relative_tolerance = (value_t)params->relative_tolerance;   \
+    const uint_t max_ulp_distance =                                           \
+        (uint_t)iree_min(params->max_ulp_distance, (uint64_t)(uint_t)~0ull);  \
+    uint_t mismatch_count = 0;                                                \
+    uint_t max_absolute_error = 0;                                            \
+    uint_t max_relative_error = 0;                                            \
+    uint_t max_ulp = 0;                                                       \
+    for (iree_host_size_t i = 0; i < count; ++i) {                            \
+      uint_t absolute_error, relative_error, ulp_distance;                    \
+      mismatch_count += iree_hal_compare_element_##name(                      \
+          approximate, threshold, relative_tolerance, max_ulp_distance,       \
+          expected[i], actual[i], &absolute_error, &relative_error,           \
+          &ulp_distance);                                                     \
+      max_absolute_error = absolute_error > max_absolute_error                \
+                               ? absolute_error                               \
+                               : max_absolute_error;                          \
+      max_relative_error = relative_error > max_relative_error                \
+                               ? relative_error                               \
+                               : max_relative_error;                          \
+      max_ulp = ulp_distance > max_ulp ? ulp_distance : max_ulp;              \
+    }                                                                         \
+    stats->max_absolute_error =                                               \
+        iree_max(stats->max_absolute_error,                                   \
+                 (double)iree_hal_compare_##value_name##_value(               \
+                     max_absolute_error));                                    \
+    stats->max_relative_error =                                               \
+        iree_max(stats->max_relative_error,                                   \
+                 (double)iree_hal_compare_##value_name##_value(               \
+                     max_relative_error));                                    \
+    stats->max_ulp_distance =                                                 \
+        iree_max(stats->max_ulp_distance, (uint64_t)max_ulp);                 \
+    return (iree_host_size_t)mismatch_count;                                  \
   }
-  return true;
+
+IREE_HAL_DEFINE_COMPARE_FLOAT_KERNEL(f16, uint16_t, float, f32, uint32_t, u32,
+                                     0x8000u, fabsf);
+IREE_HAL_DEFINE_COMPARE_FLOAT_KERNEL(bf16, uint16_t, float, f32, uint32_t, u32,
+                                     0x8000u, fabsf);
+IREE_HAL_DEFINE_COMPARE_FLOAT_KERNEL(f32, uint32_t, float, f32, uint32_t, u32,
+                                     0x80000000u, fabsf);
+IREE_HAL_DEFINE_COMPARE_FLOAT_KERNEL(f64, uint64_t, double, f64, uint64_t, u64,
+                                     0x8000000000000000ull, fabs);
+
+// Defines a bitwise block kernel for |bits_t| elements.
+#define IREE_HAL_DEFINE_COMPARE_EXACT_KERNEL(name, bits_t)                    \
+  static iree_host_size_t iree_hal_compare_block_##name(                      \
+      iree_host_size_t count, const bits_t* expected, const bits_t* actual) { \
+    iree_host_size_t mismatch_count = 0;                                      \
+    for (iree_host_size_t i = 0; i < count; ++i) {                            \
+      mismatch_count += expected[i] != actual[i];                             \
+    }                                                                         \
+    return mismatch_count;                                                    \
+  }
+
+IREE_HAL_DEFINE_COMPARE_EXACT_KERNEL(x8, uint8_t);
+IREE_HAL_DEFINE_COMPARE_EXACT_KERNEL(x16, uint16_t);
+IREE_HAL_DEFINE_COMPARE_EXACT_KERNEL(x32, uint32_t);
+IREE_HAL_DEFINE_COMPARE_EXACT_KERNEL(x64, uint64_t);
+
+static iree_host_size_t iree_hal_compare_block_bytes(
+    iree_host_size_t element_size, iree_host_size_t count,
+    const uint8_t* expected, const uint8_t* actual) {
+  iree_host_size_t mismatch_count = 0;
+  for (iree_host_size_t i = 0; i < count; ++i) {
+    mismatch_count += memcmp(expected + i * element_size,
+                             actual + i * element_size, element_size) != 0;
+  }
+  return mismatch_count;
+}
+
+// Compares |count| contiguous elements and returns the number of mismatches.
+static iree_host_size_t iree_hal_compare_block(
+    const iree_hal_compare_state_t* state, iree_host_size_t count,
+    const uint8_t* expected, const uint8_t* actual,
+    iree_hal_buffer_comparison_stats_t* stats) {
+  switch (state->kernel) {
+    case IREE_HAL_COMPARE_KERNEL_X8:
+      return iree_hal_compare_block_x8(count, expected, actual);
+    case IREE_HAL_COMPARE_KERNEL_X16:
+      return iree_hal_compare_block_x16(count, (const uint16_t*)expected,
+                                        (const uint16_t*)actual);
+    case IREE_HAL_COMPARE_KERNEL_X32:
+      return iree_hal_compare_block_x32(count, (const uint32_t*)expected,
+                                        (const uint32_t*)actual);
+    case IREE_HAL_COMPARE_KERNEL_X64:
+      return iree_hal_compare_block_x64(count, (const uint64_t*)expected,
+                                        (const uint64_t*)actual);
+    case IREE_HAL_COMPARE_KERNEL_F16:
+      return iree_hal_compare_block_f16(&state->params, count,
+                                        (const uint16_t*)expected,
+                                        (const uint16_t*)actual, stats);
+    case IREE_HAL_COMPARE_KERNEL_BF16:
+      return iree_hal_compare_block_bf16(&state->params, count,
+                                         (const uint16_t*)expected,
+                                         (const uint16_t*)actual, stats);
+    case IREE_HAL_COMPARE_KERNEL_F32:
+      return iree_hal_compare_block_f32(&state->params, count,
+                                        (const uint32_t*)expected,
+                                        (const uint32_t*)actual, stats);
+    case IREE_HAL_COMPARE_KERNEL_F64:
+      return iree_hal_compare_block_f64(&state->params, count,
+                                        (const uint64_t*)expected,
+                                        (const uint64_t*)actual, stats);
+    default:
+    case IREE_HAL_COMPARE_KERNEL_BYTES:
+      return iree_hal_compare_block_bytes(state->element_size, count, expected,
+                                          actual);
+  }
+}
+
+// Returns true if the single elements at |expected| and |actual| mismatch.
+// Used to locate mismatches within blocks known to contain them.
+static bool iree_hal_compare_element_mismatch(
+    const iree_hal_compare_state_t* state, const uint8_t* expected,
+    const uint8_t* actual) {
+  iree_hal_buffer_comparison_stats_t unused_stats;
+  memset(&unused_stats, 0, sizeof(unused_stats));
+  return iree_hal_compare_block(state, 1, expected, actual, &unused_stats) != 0;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute_f64(
-    iree_hal_buffer_equality_t equality, iree_host_size_t element_count,
-    const double* expected_ptr, iree_host_size_t expected_stride,
-    const double* actual_ptr, iree_host_size_t actual_stride,
-    iree_host_size_t* out_index) {
-  for (iree_host_size_t i = 0; i < element_count; ++i) {
-    if (fabs(*expected_ptr - *actual_ptr) > equality.f64_threshold) {
-      *out_index = i;
-      return false;
+// Compares all elements in the |slice| range block by block. Blocks without
+// mismatches only run the vectorizable kernels; blocks with mismatches are
+// rescanned element by element until the recorded index list is full.
+static void iree_hal_compare_slice(iree_hal_compare_slice_t* slice) {
+  const iree_hal_compare_state_t* state = slice->state;
+  const iree_host_size_t element_size = state->element_size;
+  iree_hal_buffer_comparison_stats_t* stats = &slice->stats;
+  stats->element_count = slice->end - slice->begin;
+
+  // Broadcasts compare each block against a block of the replicated value so
+  // that they can share the elementwise kernels.
+  uint64_t broadcast_storage[IREE_HAL_COMPARE_BLOCK_SIZE];
+  const uint8_t* broadcast_block = NULL;
+  if (state->broadcast) {
+    uint8_t* block = (uint8_t*)broadcast_storage;
+    for (iree_host_size_t i = 0; i < IREE_HAL_COMPARE_BLOCK_SIZE; ++i) {
+      memcpy(block + i * element_size, state->expected, element_size);
     }
-    expected_ptr += expected_stride;
-    actual_ptr += actual_stride;
+    broadcast_block = block;
   }
-  return true;
+
+  for (iree_host_size_t block_begin = slice->begin; block_begin < slice->end;
+       block_begin += IREE_HAL_COMPARE_BLOCK_SIZE) {
+    const iree_host_size_t block_count =
+        iree_min(IREE_HAL_COMPARE_BLOCK_SIZE, slice->end - block_begin);
+    const uint8_t* expected =
+        broadcast_block ? broadcast_block
+                        : state->expected + block_begin * element_size;
+    const uint8_t* actual = state->actual + block_begin * element_size;
+    const iree_host_size_t block_mismatch_count =
+        iree_hal_compare_block(state, block_count, expected, actual, stats);
+    if (!block_mismatch_count) continue;
+    stats->mismatch_count += block_mismatch_count;
+
+    iree_host_size_t remaining_count = block_mismatch_count;
+    for (iree_host_size_t i = 0;
+         i < block_count && remaining_count > 0 &&
+         stats->recorded_mismatch_count <
+             IREE_HAL_BUFFER_COMPARISON_MAX_MISMATCHES;
+         ++i) {
+      if (iree_hal_compare_element_mismatch(state,
+                                            expected + i * element_size,
+                                            actual + i * element_size)) {
+        stats->mismatch_indices[stats->recorded_mismatch_count++] =
+            block_begin + i;
+        --remaining_count;
+      }
+    }
+    if (slice->stop_on_mismatch) break;
+  }
+}
+
+static int iree_hal_compare_slice_thread_main(void* entry_arg) {
+  iree_hal_compare_slice((iree_hal_compare_slice_t*)entry_arg);
+  return 0;
 }
 
-static bool iree_hal_compare_strided_elements_approximate_absolute(
+static iree_hal_compare_state_t iree_hal_compare_state_initialize(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
-    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
-    iree_host_size_t expected_stride, iree_const_byte_span_t actual_elements,
-    iree_host_size_t actual_stride, iree_host_size_t* out_index) {
-  switch (element_type) {
-    case IREE_HAL_ELEMENT_TYPE_FLOAT_16:
-      return iree_hal_compare_strided_elements_approximate_absolute_f16(
-          equality, element_count, (const uint16_t*)expected_elements.data,
-          expected_stride, (const uint16_t*)actual_elements.data, actual_stride,
-          out_index);
-    case IREE_HAL_ELEMENT_TYPE_FLOAT_32:
-      return iree_hal_compare_strided_elements_approximate_absolute_f32(
-          equality, element_count, (const float*)expected_elements.data,
-          expected_stride, (const float*)actual_elements.data, actual_stride,
-          out_index);
-    case IREE_HAL_ELEMENT_TYPE_FLOAT_64:
-      return iree_hal_compare_strided_elements_approximate_absolute_f64(
-          equality, element_count, (const double*)expected_elements.data,
-          expected_stride, (const double*)actual_elements.data, actual_stride,
-          out_index);
-    default:
-      return iree_hal_compare_strided_elements_exact(
-          element_type, element_count, expected_elements, expected_stride,
-          actual_elements, actual_stride, out_index);
-  }
+    bool broadcast, const uint8_t* expected, const uint8_t* actual) {
+  const iree_host_size_t element_size =
+      iree_hal_element_dense_byte_count(element_type);
+  iree_hal_compare_state_t state = {
+      .kernel = iree_hal_compare_select_kernel(element_type, element_size),
+      .params = iree_hal_compare_select_params(equality, element_type),
+      .element_size = element_size,
+      .broadcast = broadcast,
+      .expected = expected,
+      .actual = actual,
+  };
+  return state;
 }
 
-// Compares two buffers element by element.
-// The provided strides (in elements) are applied up to |element_count|.
-static bool iree_hal_compare_strided_elements(
+// Compares elements on the calling thread until the first mismatching block.
+static bool iree_hal_compare_elements_until_mismatch(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
-    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
-    iree_host_size_t expected_stride, iree_const_byte_span_t actual_elements,
-    iree_host_size_t actual_stride, iree_host_size_t* out_index) {
-  switch (equality.mode) {
-    case IREE_HAL_BUFFER_EQUALITY_EXACT:
-      return iree_hal_compare_strided_elements_exact(
-          element_type, element_count, expected_elements, expected_stride,
-          actual_elements, actual_stride, out_index);
-    case IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE:
-      return iree_hal_compare_strided_elements_approximate_absolute(
-          equality, element_type, element_count, expected_elements,
-          expected_stride, actual_elements, actual_stride, out_index);
-    default:
-      IREE_ASSERT(false && "unhandled equality mode");
-      return false;
+    bool broadcast, iree_host_size_t element_count,
+    iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements, iree_host_size_t* out_index) {
+  const iree_hal_compare_state_t state = iree_hal_compare_state_initialize(
+      equality, element_type, broadcast, expected_elements.data,
+      actual_elements.data);
+  iree_hal_compare_slice_t slice = {
+      .state = &state,
+      .begin = 0,
+      .end = element_count,
+      .stop_on_mismatch = true,
+  };
+  iree_hal_compare_slice(&slice);
+  if (slice.stats.mismatch_count > 0) {
+    *out_index = slice.stats.mismatch_indices[0];
+    return false;
   }
+  return true;
 }
 
 bool iree_hal_compare_buffer_elements_broadcast(
     iree_hal_buffer_equality_t equality,
     iree_hal_buffer_element_t expected_element, iree_host_size_t element_count,
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index) {
-  return iree_hal_compare_strided_elements(
-      equality, expected_element.type, element_count,
+  return iree_hal_compare_elements_until_mismatch(
+      equality, expected_element.type, /*broadcast=*/true, element_count,
       iree_make_const_byte_span(
           expected_element.storage,
           iree_hal_element_dense_byte_count(expected_element.type)),
-      /*expected_stride=*/0, actual_elements, /*actual_stride=*/1, out_index);
+      actual_elements, out_index);
 }
 
 bool iree_hal_compare_buffer_elements_elementwise(
     iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index) {
-  return iree_hal_compare_strided_elements(
-      equality, element_type, element_count, expected_elements,
-      /*expected_stride=*/1, actual_elements, /*actual_stride=*/1, out_index);
+  return iree_hal_compare_elements_until_mismatch(
+      equality, element_type, /*broadcast=*/false, element_count,
+      expected_elements, actual_elements, out_index);
+}
+
+// Merges the |slice| results into |stats|. Slices must be merged in order so
+// that recorded indices remain ascending.
+static void iree_hal_compare_merge_slice_stats(
+    const iree_hal_buffer_comparison_stats_t* slice_stats,
+    iree_hal_buffer_comparison_stats_t* stats) {
+  stats->element_count += slice_stats->element_count;
+  stats->mismatch_count += slice_stats->mismatch_count;
+  for (iree_host_size_t i = 0;
+       i < slice_stats->recorded_mismatch_count &&
+       stats->recorded_mismatch_count <
+           IREE_HAL_BUFFER_COMPARISON_MAX_MISMATCHES;
+       ++i) {
+    stats->mismatch_indices[stats->recorded_mismatch_count++] =
+        slice_stats->mismatch_indices[i];
+  }
+  stats->max_absolute_error =
+      iree_max(stats->max_absolute_error, slice_stats->max_absolute_error);
+  stats->max_relative_error =
+      iree_max(stats->max_relative_error, slice_stats->max_relative_error);
+  stats->max_ulp_distance =
+      iree_max(stats->max_ulp_distance, slice_stats->max_ulp_distance);
+}
+
+iree_status_t iree_hal_compare_buffer_elements_with_stats(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements, iree_host_size_t worker_count,
+    iree_allocator_t host_allocator,
+    iree_hal_buffer_comparison_stats_t* out_stats) {
+  IREE_ASSERT_ARGUMENT(out_stats);
+  memset(out_stats, 0, sizeof(*out_stats));
+  const iree_host_size_t element_size =
+      iree_hal_element_dense_byte_count(element_type);
+  if (element_size && element_count > IREE_HOST_SIZE_MAX / element_size) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "element count %" PRIhsz " overflows",
+                            element_count);
+  }
+  const iree_host_size_t byte_length = element_count * element_size;
+  if (expected_elements.data_length < byte_length ||
+      actual_elements.data_length < byte_length) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "element buffers too small for %" PRIhsz
+        " elements (%" PRIhsz "B); expected %" PRIhsz "B, actual %" PRIhsz "B",
+        element_count, byte_length, expected_elements.data_length,
+        actual_elements.data_length);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)element_count);
+
+  const iree_hal_compare_state_t state = iree_hal_compare_state_initialize(
+      equality, element_type, /*broadcast=*/false, expected_elements.data,
+      actual_elements.data);
+
+  // Only split when each worker has enough elements to amortize thread
+  // creation.
+  iree_host_size_t slice_count = iree_min(
+      iree_max(worker_count, 1), IREE_HAL_BUFFER_COMPARISON_MAX_WORKERS);
+  slice_count = iree_min(
+      slice_count,
+      iree_max(element_count / IREE_HAL_COMPARE_MIN_ELEMENTS_PER_WORKER, 1));
+  if (slice_count <= 1) {
+    iree_hal_compare_slice_t slice = {
+        .state = &state,
+        .begin = 0,
+        .end = element_count,
+        .stop_on_mismatch = false,
+    };
+    iree_hal_compare_slice(&slice);
+    *out_stats = slice.stats;
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();
+  }
+
+  iree_hal_compare_slice_t* slices = NULL;
+  iree_thread_t** threads = NULL;
+  iree_host_size_t total_size =
+      slice_count * (sizeof(*slices) + sizeof(*threads));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&slices));
+  threads = (iree_thread_t**)(slices + slice_count);
+
+  // Slices are whole blocks so that the kernels see the same block boundaries
+  // regardless of the worker count.
+  const iree_host_size_t slice_size = iree_host_align(
+      iree_host_size_ceil_div(element_count, slice_count),
+      IREE_HAL_COMPARE_BLOCK_SIZE);
+  for (iree_host_size_t i = 0; i < slice_count; ++i) {
+    slices[i].state = &state;
+    slices[i].begin = iree_min(i * slice_size, element_count);
+    slices[i].end = iree_min(slices[i].begin + slice_size, element_count);
+    slices[i].stop_on_mismatch = false;
+  }
+
+  // Slice 0 runs on the calling thread. Slices whose thread could not be
+  // created also run on the calling thread so that failures only cost time.
+  iree_thread_create_params_t thread_params;
+  memset(&thread_params, 0, sizeof(thread_params));
+  thread_params.name = IREE_SV("iree-compare");
+  for (iree_host_size_t i = 1; i < slice_count; ++i) {
+    iree_status_t status =
+        iree_thread_create(iree_hal_compare_slice_thread_main, &slices[i],
+                           thread_params, host_allocator, &threads[i]);
+    if (!iree_status_is_ok(status)) {
+      iree_status_ignore(status);
+      threads[i] = NULL;
+    }
+  }
+  iree_hal_compare_slice(&slices[0]);
+  for (iree_host_size_t i = 1; i < slice_count; ++i) {
+    if (threads[i]) {
+      iree_thread_release(threads[i]);  // joins
+    } else {
+      iree_hal_compare_slice(&slices[i]);
+    }
+  }
+
+  for (iree_host_size_t i = 0; i < slice_count; ++i) {
+    iree_hal_compare_merge_slice_stats(&slices[i].stats, out_stats);
+  }
+
+  iree_allocator_free(host_allocator, slices);
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+iree_status_t iree_hal_append_buffer_comparison_stats_string(
+    const iree_hal_buffer_comparison_stats_t* stats,
+    iree_hal_element_type_t element_type,
+    iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements,
+    iree_host_size_t max_mismatch_count, iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(stats);
+  IREE_ASSERT_ARGUMENT(builder);
+  const iree_host_size_t formatted_count =
+      iree_min(max_mismatch_count, stats->recorded_mismatch_count);
+  for (iree_host_size_t i = 0; i < formatted_count; ++i) {
+    if (i > 0) {
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_string(builder, IREE_SV("; ")));
+    }
+    const iree_host_size_t index = stats->mismatch_indices[i];
+    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
+        index,
+        iree_hal_buffer_element_at(element_type, expected_elements, index),
+        iree_hal_buffer_element_at(element_type, actual_elements, index),
+        builder));
+  }
+  if (formatted_count > 0) {
+    IREE_RETURN_IF_ERROR(
+        iree_string_builder_append_string(builder, IREE_SV("; ")));
+  }
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+      builder, "%" PRIhsz " of %" PRIhsz " elements mismatch",
+      stats->mismatch_count, stats->element_count));
+  if (iree_hal_element_numerical_type_is_float(element_type)) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder,
+        " (max absolute error %g, max relative error %g, max ULP distance "
+        "%" PRIu64 ")",
+        stats->max_absolute_error, stats->max_relative_error,
+        stats->max_ulp_distance));
+  }
+  return iree_ok_status();
 }
 
 //===----------------------------------------------------------------------===//
@@ -505,25 +1006,22 @@ iree_status_t iree_hal_buffer_view_array_matcher_match(
   iree_const_byte_span_t actual_contents = iree_make_const_byte_span(
       actual_mapping.contents.data, actual_mapping.contents.data_length);
 
-  iree_host_size_t i = 0;
-  const bool all_match = iree_hal_compare_buffer_elements_elementwise(
+  iree_hal_buffer_comparison_stats_t stats;
+  iree_status_t status = iree_hal_compare_buffer_elements_with_stats(
       matcher->equality, iree_hal_buffer_view_element_type(matchee),
       iree_hal_buffer_view_element_count(matchee), matcher->elements,
-      actual_contents, &i);
-  iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), actual_contents, i);
-  iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), matcher->elements, i);
-
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&actual_mapping));
-
-  if (!all_match) {
-    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
-        i, expected_element, actual_element, builder));
+      actual_contents, /*worker_count=*/1, iree_allocator_system(), &stats);
+  if (iree_status_is_ok(status) && stats.mismatch_count > 0) {
+    status = iree_hal_append_buffer_comparison_stats_string(
+        &stats, iree_hal_buffer_view_element_type(matchee), matcher->elements,
+        actual_contents, /*max_mismatch_count=*/1, builder);
   }
 
-  *out_matched = all_match;
-  return iree_ok_status();
+  status =
+      iree_status_join(status, iree_hal_buffer_unmap_range(&actual_mapping));
+
+  *out_matched = iree_status_is_ok(status) && stats.mismatch_count == 0;
+  return status;
 }
 
 iree_status_t iree_hal_buffer_view_match_array(
@@ -620,26 +1118,24 @@ iree_status_t iree_hal_buffer_view_matcher_match(
   iree_const_byte_span_t expected_contents = iree_make_const_byte_span(
       expected_mapping.contents.data, expected_mapping.contents.data_length);
 
-  iree_host_size_t i = 0;
-  const bool all_match = iree_hal_compare_buffer_elements_elementwise(
+  iree_hal_buffer_comparison_stats_t stats;
+  status = iree_hal_compare_buffer_elements_with_stats(
       matcher->equality, iree_hal_buffer_view_element_type(matchee),
       iree_hal_buffer_view_element_count(matchee), expected_contents,
-      actual_contents, &i);
-  iree_hal_buffer_element_t actual_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), actual_contents, i);
-  iree_hal_buffer_element_t expected_element = iree_hal_buffer_element_at(
-      iree_hal_buffer_view_element_type(matchee), expected_contents, i);
-
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&actual_mapping));
-  IREE_RETURN_IF_ERROR(iree_hal_buffer_unmap_range(&expected_mapping));
-
-  if (!all_match) {
-    IREE_RETURN_IF_ERROR(iree_hal_append_element_mismatch_string(
-        i, expected_element, actual_element, builder));
+      actual_contents, /*worker_count=*/1, iree_allocator_system(), &stats);
+  if (iree_status_is_ok(status) && stats.mismatch_count > 0) {
+    status = iree_hal_append_buffer_comparison_stats_string(
+        &stats, iree_hal_buffer_view_element_type(matchee), expected_contents,
+        actual_contents, /*max_mismatch_count=*/1, builder);
   }
 
-  *out_matched = all_match;
-  return iree_ok_status();
+  status =
+      iree_status_join(status, iree_hal_buffer_unmap_range(&actual_mapping));
+  status =
+      iree_status_join(status, iree_hal_buffer_unmap_range(&expected_mapping));
+
+  *out_matched = iree_status_is_ok(status) && stats.mismatch_count == 0;
+  return status;
 }
 
 iree_status_t iree_hal_buffer_view_match_equal(
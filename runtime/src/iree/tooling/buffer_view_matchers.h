@@ -40,17 +40,30 @@ typedef enum {
   IREE_HAL_BUFFER_EQUALITY_EXACT = 0,
   // abs(a - b) <= threshold
   IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE,
+  // abs(a - b) <= threshold + relative_tolerance * abs(b)
+  IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE,
+  // ulp_distance(a, b) <= max_ulp_distance
+  IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ULP,
 } iree_hal_buffer_equality_mode_t;
 
 // TODO(benvanik): initializers/configuration for equality comparisons.
+//
+// In all approximate modes NaN only matches NaN. Non-floating-point types are
+// always compared exactly.
 typedef struct {
   iree_hal_buffer_equality_mode_t mode;
-  // TODO(benvanik): allow override in approximate modes (ULP, abs/rel diff).
+  // Absolute thresholds used by the ABSOLUTE and RELATIVE modes.
   // For now we just have some hardcoded types that are used in place of
   // compile-time constants. Consider these provisional.
   float f16_threshold;
   float f32_threshold;
   double f64_threshold;
+  float bf16_threshold;
+  // Fraction of abs(expected) added to the threshold in the RELATIVE mode.
+  double relative_tolerance;
+  // Maximum distance in units in the last place of the element type allowed in
+  // the ULP mode. 0 requires values to be identical (with -0 == +0).
+  uint32_t max_ulp_distance;
 } iree_hal_buffer_equality_t;
 
 // Variant type storing known HAL buffer elements.
@@ -137,6 +150,63 @@ bool iree_hal_compare_buffer_elements_elementwise(
     iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
     iree_const_byte_span_t actual_elements, iree_host_size_t* out_index);
 
+// Maximum number of mismatching element indices recorded in
+// iree_hal_buffer_comparison_stats_t.
+#define IREE_HAL_BUFFER_COMPARISON_MAX_MISMATCHES 32
+
+// Maximum number of threads a single comparison will be split across.
+#define IREE_HAL_BUFFER_COMPARISON_MAX_WORKERS 64
+
+// Summary of a full comparison of two element buffers.
+typedef struct {
+  // Total number of elements compared.
+  iree_host_size_t element_count;
+  // Total number of elements that did not match.
+  iree_host_size_t mismatch_count;
+  // Indices of the first min(mismatch_count,
+  // IREE_HAL_BUFFER_COMPARISON_MAX_MISMATCHES) mismatching elements in
+  // ascending order.
+  iree_host_size_t recorded_mismatch_count;
+  iree_host_size_t mismatch_indices[IREE_HAL_BUFFER_COMPARISON_MAX_MISMATCHES];
+  // Largest abs(actual - expected) across all non-NaN elements.
+  // Only populated for floating-point element types.
+  double max_absolute_error;
+  // Largest abs(actual - expected) / abs(expected) across all non-NaN elements
+  // with a non-zero expected value.
+  // Only populated for floating-point element types.
+  double max_relative_error;
+  // Largest distance in units in the last place across all non-NaN elements.
+  // Only populated for floating-point element types.
+  uint64_t max_ulp_distance;
+} iree_hal_buffer_comparison_stats_t;
+
+// Compares all |element_count| elements based on |equality| and populates
+// |out_stats| with the mismatch count, the first mismatching indices, and
+// error statistics. Unlike the functions above this does not stop at the first
+// mismatch and no formatting is performed.
+//
+// Elements are processed in fixed-size blocks with branch-free inner loops that
+// compilers can vectorize. Large buffers are split into contiguous slices that
+// are compared on up to |worker_count| threads (including the caller) with
+// results merged in order. A |worker_count| of 0 or 1 compares on the calling
+// thread only.
+iree_status_t iree_hal_compare_buffer_elements_with_stats(
+    iree_hal_buffer_equality_t equality, iree_hal_element_type_t element_type,
+    iree_host_size_t element_count, iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements, iree_host_size_t worker_count,
+    iree_allocator_t host_allocator,
+    iree_hal_buffer_comparison_stats_t* out_stats);
+
+// Appends a human-readable description of the mismatches in |stats| to
+// |builder|, formatting at most |max_mismatch_count| of the recorded
+// mismatching elements from |expected_elements| and |actual_elements|.
+iree_status_t iree_hal_append_buffer_comparison_stats_string(
+    const iree_hal_buffer_comparison_stats_t* stats,
+    iree_hal_element_type_t element_type,
+    iree_const_byte_span_t expected_elements,
+    iree_const_byte_span_t actual_elements,
+    iree_host_size_t max_mismatch_count, iree_string_builder_t* builder);
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_metadata_matcher_t
 //===----------------------------------------------------------------------===//
@@ -6,6 +6,10 @@
 
 #include "iree/tooling/buffer_view_matchers.h"
 
+#include <cmath>
+#include <cstring>
+#include <vector>
+
 #include "iree/base/api.h"
 #include "iree/base/internal/math.h"
 #include "iree/base/internal/span.h"
@@ -155,20 +159,43 @@ struct BufferView final
 };
 
 static const iree_hal_buffer_equality_t kExactEquality = ([]() {
-  iree_hal_buffer_equality_t equality;
+  iree_hal_buffer_equality_t equality = {};
   equality.mode = IREE_HAL_BUFFER_EQUALITY_EXACT;
   return equality;
 })();
 
 static const iree_hal_buffer_equality_t kApproximateEquality = ([]() {
-  iree_hal_buffer_equality_t equality;
+  iree_hal_buffer_equality_t equality = {};
   equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE;
   equality.f16_threshold = 0.001f;
   equality.f32_threshold = 0.0001f;
   equality.f64_threshold = 0.0001;
+  equality.bf16_threshold = 0.01f;
+  return equality;
+})();
+
+static const iree_hal_buffer_equality_t kRelativeEquality = ([]() {
+  iree_hal_buffer_equality_t equality = kApproximateEquality;
+  equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE;
+  equality.relative_tolerance = 0.01;
+  return equality;
+})();
+
+static const iree_hal_buffer_equality_t kUlpEquality = ([]() {
+  iree_hal_buffer_equality_t equality = {};
+  equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ULP;
+  equality.max_ulp_distance = 2;
   return equality;
 })();
 
+static float NextAfterF32(float value, int steps) {
+  uint32_t bits = 0;
+  memcpy(&bits, &value, sizeof(bits));
+  bits += steps;
+  memcpy(&value, &bits, sizeof(value));
+  return value;
+}
+
 class BufferViewMatchersTest : public ::testing::Test {
  protected:
   iree_hal_allocator_t* device_allocator_ = nullptr;
@@ -420,6 +447,146 @@ TEST_F(BufferViewMatchersTest, CompareElementwiseF64NE) {
   EXPECT_EQ(index, 1);
 }
 
+TEST_F(BufferViewMatchersTest, CompareElementwiseF32NaN) {
+  const float lhs[] = {NAN, 1.0f, NAN, INFINITY};
+  const float rhs[] = {NAN, NAN, 1.0f, INFINITY};
+  iree_hal_buffer_comparison_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compare_buffer_elements_with_stats(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), /*worker_count=*/1,
+      iree_allocator_system(), &stats));
+  EXPECT_EQ(stats.mismatch_count, 2);
+  ASSERT_EQ(stats.recorded_mismatch_count, 2);
+  EXPECT_EQ(stats.mismatch_indices[0], 1);
+  EXPECT_EQ(stats.mismatch_indices[1], 2);
+}
+
+TEST_F(BufferViewMatchersTest, CompareElementwiseBF16) {
+  const uint16_t lhs[] = {
+      iree_math_f32_to_bf16(1.0f),
+      iree_math_f32_to_bf16(0.5f),
+      iree_math_f32_to_bf16(3.0f),
+  };
+  const uint16_t rhs[] = {
+      iree_math_f32_to_bf16(1.0f),
+      iree_math_f32_to_bf16(0.50390625f),
+      iree_math_f32_to_bf16(3.5f),
+  };
+  iree_host_size_t index = 0;
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_elementwise(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_BFLOAT_16,
+      IREE_ARRAYSIZE(lhs), iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &index));
+  EXPECT_EQ(index, 2);
+  EXPECT_FALSE(iree_hal_compare_buffer_elements_elementwise(
+      kExactEquality, IREE_HAL_ELEMENT_TYPE_BFLOAT_16, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), &index));
+  EXPECT_EQ(index, 1);
+}
+
+TEST_F(BufferViewMatchersTest, CompareElementwiseF32Relative) {
+  const float lhs[] = {1000.0f, 1000.0f, 0.0f};
+  const float rhs[] = {1009.0f, 1011.0f, 0.00001f};
+  iree_hal_buffer_comparison_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compare_buffer_elements_with_stats(
+      kRelativeEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), /*worker_count=*/1,
+      iree_allocator_system(), &stats));
+  EXPECT_EQ(stats.element_count, 3);
+  EXPECT_EQ(stats.mismatch_count, 1);
+  ASSERT_EQ(stats.recorded_mismatch_count, 1);
+  EXPECT_EQ(stats.mismatch_indices[0], 1);
+  EXPECT_FLOAT_EQ(stats.max_absolute_error, 11.0);
+  EXPECT_FLOAT_EQ(stats.max_relative_error, 0.011);
+}
+
+TEST_F(BufferViewMatchersTest, CompareElementwiseF32Ulp) {
+  const float lhs[] = {1.0f, 1.0f, -0.0f, 1.0f};
+  const float rhs[] = {NextAfterF32(1.0f, 2), NextAfterF32(1.0f, 3), 0.0f,
+                       NextAfterF32(1.0f, -1)};
+  iree_hal_buffer_comparison_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compare_buffer_elements_with_stats(
+      kUlpEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), /*worker_count=*/1,
+      iree_allocator_system(), &stats));
+  EXPECT_EQ(stats.mismatch_count, 1);
+  ASSERT_EQ(stats.recorded_mismatch_count, 1);
+  EXPECT_EQ(stats.mismatch_indices[0], 1);
+  EXPECT_EQ(stats.max_ulp_distance, 3);
+}
+
+TEST_F(BufferViewMatchersTest, CompareElementwiseI32Stats) {
+  const int32_t lhs[] = {1, 2, 3, 4};
+  const int32_t rhs[] = {1, 5, 3, 6};
+  iree_hal_buffer_comparison_stats_t stats;
+  IREE_ASSERT_OK(iree_hal_compare_buffer_elements_with_stats(
+      kApproximateEquality, IREE_HAL_ELEMENT_TYPE_INT_32, IREE_ARRAYSIZE(lhs),
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), /*worker_count=*/1,
+      iree_allocator_system(), &stats));
+  EXPECT_EQ(stats.mismatch_count, 2);
+  ASSERT_EQ(stats.recorded_mismatch_count, 2);
+  EXPECT_EQ(stats.mismatch_indices[0], 1);
+  EXPECT_EQ(stats.mismatch_indices[1], 3);
+
+  auto sb = StringBuilder::MakeSystem();
+  IREE_ASSERT_OK(iree_hal_append_buffer_comparison_stats_string(
+      &stats, IREE_HAL_ELEMENT_TYPE_INT_32,
+      iree_make_const_byte_span(lhs, sizeof(lhs)),
+      iree_make_const_byte_span(rhs, sizeof(rhs)), /*max_mismatch_count=*/8,
+      sb));
+  EXPECT_THAT(sb.ToString(),
+              HasSubstr("element at index 1 (5) does not match the expected "
+                        "(2); element at index 3 (6) does not match the "
+                        "expected (4); 2 of 4 elements mismatch"));
+}
+
+TEST_F(BufferViewMatchersTest, CompareElementwiseTooSmall) {
+  const float lhs[] = {1.0f, 2.0f};
+  const float rhs[] = {1.0f};
+  iree_hal_buffer_comparison_stats_t stats;
+  EXPECT_THAT(Status(iree_hal_compare_buffer_elements_with_stats(
+                  kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+                  IREE_ARRAYSIZE(lhs),
+                  iree_make_const_byte_span(lhs, sizeof(lhs)),
+                  iree_make_const_byte_span(rhs, sizeof(rhs)),
+                  /*worker_count=*/1, iree_allocator_system(), &stats)),
+              StatusIs(StatusCode::kInvalidArgument));
+}
+
+// Large enough to be split across workers; results must match a single-thread
+// comparison with mismatches spread over multiple slices.
+TEST_F(BufferViewMatchersTest, CompareElementwiseMultithreaded) {
+  const iree_host_size_t element_count = 5 * 1024 * 1024 + 17;
+  std::vector<float> lhs(element_count);
+  for (iree_host_size_t i = 0; i < element_count; ++i) {
+    lhs[i] = (float)(i % 1000);
+  }
+  std::vector<float> rhs = lhs;
+  const iree_host_size_t mismatch_indices[] = {
+      3, 1024 * 1024 + 5, 3 * 1024 * 1024 + 1, element_count - 1};
+  for (iree_host_size_t index : mismatch_indices) rhs[index] += 0.5f;
+  for (iree_host_size_t worker_count : {1, 4}) {
+    iree_hal_buffer_comparison_stats_t stats;
+    IREE_ASSERT_OK(iree_hal_compare_buffer_elements_with_stats(
+        kApproximateEquality, IREE_HAL_ELEMENT_TYPE_FLOAT_32, element_count,
+        iree_make_const_byte_span(lhs.data(), lhs.size() * sizeof(float)),
+        iree_make_const_byte_span(rhs.data(), rhs.size() * sizeof(float)),
+        worker_count, iree_allocator_system(), &stats));
+    EXPECT_EQ(stats.element_count, element_count);
+    EXPECT_EQ(stats.mismatch_count, IREE_ARRAYSIZE(mismatch_indices));
+    ASSERT_EQ(stats.recorded_mismatch_count, IREE_ARRAYSIZE(mismatch_indices));
+    for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(mismatch_indices); ++i) {
+      EXPECT_EQ(stats.mismatch_indices[i], mismatch_indices[i]);
+    }
+    EXPECT_FLOAT_EQ(stats.max_absolute_error, 0.5);
+  }
+}
+
 //===----------------------------------------------------------------------===//
 // iree_hal_buffer_view_metadata_matcher_t
 //===----------------------------------------------------------------------===//
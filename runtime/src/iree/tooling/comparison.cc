@@ -8,6 +8,7 @@
 
 #include <cstdint>
 #include <cstdio>
+#include <cstring>
 
 #include "iree/base/api.h"
 #include "iree/base/internal/flags.h"
@@ -24,14 +25,54 @@ IREE_FLAG(float, expected_f32_threshold, 0.0001f,
           "Threshold under which two f32 values are considered equal.");
 IREE_FLAG(double, expected_f64_threshold, 0.0001,
           "Threshold under which two f64 values are considered equal.");
+IREE_FLAG(float, expected_bf16_threshold, 0.01f,
+          "Threshold under which two bf16 values are considered equal.");
+IREE_FLAG(string, expected_tolerance_mode, "absolute",
+          "How floating-point values are compared:\n"
+          "  absolute: abs(a - b) <= threshold\n"
+          "  relative: abs(a - b) <= threshold + relative_tolerance * abs(b)\n"
+          "  ulp: ulp_distance(a, b) <= max_ulp_distance\n"
+          "  exact: bitwise equality");
+IREE_FLAG(double, expected_relative_tolerance, 0.0,
+          "Fraction of the expected magnitude tolerated in `relative` mode.");
+IREE_FLAG(int32_t, expected_max_ulp_distance, 0,
+          "Units in the last place tolerated in `ulp` mode.");
+IREE_FLAG(int32_t, expected_max_reported_mismatches, 8,
+          "Maximum number of mismatching elements reported per result.");
+IREE_FLAG(int32_t, compare_worker_count, 8,
+          "Maximum number of threads used to compare large buffers.");
 
-static iree_hal_buffer_equality_t iree_tooling_equality_from_flags(void) {
+static iree_status_t iree_tooling_equality_from_flags(
+    iree_hal_buffer_equality_t* out_equality) {
   iree_hal_buffer_equality_t equality;
-  equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE;
+  memset(&equality, 0, sizeof(equality));
+  iree_string_view_t mode =
+      iree_make_cstring_view(FLAG_expected_tolerance_mode);
+  if (iree_string_view_equal(mode, IREE_SV("absolute"))) {
+    equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ABSOLUTE;
+  } else if (iree_string_view_equal(mode, IREE_SV("relative"))) {
+    equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_RELATIVE;
+  } else if (iree_string_view_equal(mode, IREE_SV("ulp"))) {
+    equality.mode = IREE_HAL_BUFFER_EQUALITY_APPROXIMATE_ULP;
+  } else if (iree_string_view_equal(mode, IREE_SV("exact"))) {
+    equality.mode = IREE_HAL_BUFFER_EQUALITY_EXACT;
+  } else {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unsupported --expected_tolerance_mode=%.*s",
+                            (int)mode.size, mode.data);
+  }
+  if (FLAG_expected_max_ulp_distance < 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--expected_max_ulp_distance must be >= 0");
+  }
   equality.f16_threshold = FLAG_expected_f16_threshold;
   equality.f32_threshold = FLAG_expected_f32_threshold;
   equality.f64_threshold = FLAG_expected_f64_threshold;
-  return equality;
+  equality.bf16_threshold = FLAG_expected_bf16_threshold;
+  equality.relative_tolerance = FLAG_expected_relative_tolerance;
+  equality.max_ulp_distance = (uint32_t)FLAG_expected_max_ulp_distance;
+  *out_equality = equality;
+  return iree_ok_status();
 }
 
 static iree_status_t iree_vm_append_variant_type_string(
@@ -149,6 +190,59 @@ static bool iree_tooling_compare_values(int result_index,
   }
 }
 
+// Compares the contents of two buffer views with matching metadata.
+// Mismatches are summarized in |builder| without formatting every element.
+static iree_status_t iree_tooling_compare_buffer_view_contents(
+    iree_hal_buffer_equality_t equality, iree_hal_buffer_view_t* expected_view,
+    iree_hal_buffer_view_t* actual_view, iree_allocator_t host_allocator,
+    iree_string_builder_t* builder, bool* out_matched) {
+  *out_matched = false;
+  if (iree_hal_buffer_view_encoding_type(actual_view) !=
+      IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR) {
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "non-dense encodings not supported for matching");
+  }
+
+  iree_hal_buffer_mapping_t expected_mapping;
+  IREE_RETURN_IF_ERROR(iree_hal_buffer_map_range(
+      iree_hal_buffer_view_buffer(expected_view), IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ, 0, IREE_WHOLE_BUFFER, &expected_mapping));
+  iree_hal_buffer_mapping_t actual_mapping;
+  iree_status_t status = iree_hal_buffer_map_range(
+      iree_hal_buffer_view_buffer(actual_view), IREE_HAL_MAPPING_MODE_SCOPED,
+      IREE_HAL_MEMORY_ACCESS_READ, 0, IREE_WHOLE_BUFFER, &actual_mapping);
+  if (!iree_status_is_ok(status)) {
+    iree_hal_buffer_unmap_range(&expected_mapping);
+    return status;
+  }
+  iree_const_byte_span_t expected_contents = iree_make_const_byte_span(
+      expected_mapping.contents.data, expected_mapping.contents.data_length);
+  iree_const_byte_span_t actual_contents = iree_make_const_byte_span(
+      actual_mapping.contents.data, actual_mapping.contents.data_length);
+
+  const iree_hal_element_type_t element_type =
+      iree_hal_buffer_view_element_type(actual_view);
+  iree_hal_buffer_comparison_stats_t stats;
+  status = iree_hal_compare_buffer_elements_with_stats(
+      equality, element_type, iree_hal_buffer_view_element_count(actual_view),
+      expected_contents, actual_contents,
+      (iree_host_size_t)iree_max(FLAG_compare_worker_count, 1), host_allocator,
+      &stats);
+  if (iree_status_is_ok(status) && stats.mismatch_count > 0) {
+    status = iree_hal_append_buffer_comparison_stats_string(
+        &stats, element_type, expected_contents, actual_contents,
+        (iree_host_size_t)iree_max(FLAG_expected_max_reported_mismatches, 1),
+        builder);
+  }
+
+  status =
+      iree_status_join(status, iree_hal_buffer_unmap_range(&actual_mapping));
+  status =
+      iree_status_join(status, iree_hal_buffer_unmap_range(&expected_mapping));
+  *out_matched = iree_status_is_ok(status) && stats.mismatch_count == 0;
+  return status;
+}
+
 static bool iree_tooling_compare_buffer_views(
     int result_index, iree_hal_buffer_view_t* expected_view,
     iree_hal_buffer_view_t* actual_view, iree_allocator_t host_allocator,
@@ -156,10 +250,16 @@ static bool iree_tooling_compare_buffer_views(
   iree_string_builder_t subbuilder;
   iree_string_builder_initialize(host_allocator, &subbuilder);
 
-  iree_hal_buffer_equality_t equality = iree_tooling_equality_from_flags();
+  iree_hal_buffer_equality_t equality;
+  IREE_CHECK_OK(iree_tooling_equality_from_flags(&equality));
   bool did_match = false;
-  IREE_CHECK_OK(iree_hal_buffer_view_match_equal(
-      equality, expected_view, actual_view, &subbuilder, &did_match));
+  IREE_CHECK_OK(iree_hal_buffer_view_match_metadata_like(
+      expected_view, actual_view, &subbuilder, &did_match));
+  if (did_match) {
+    IREE_CHECK_OK(iree_tooling_compare_buffer_view_contents(
+        equality, expected_view, actual_view, host_allocator, &subbuilder,
+        &did_match));
+  }
   if (did_match) {
     iree_string_builder_deinitialize(&subbuilder);
     return true;
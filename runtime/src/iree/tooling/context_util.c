@@ -21,6 +21,7 @@
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/modules/resolver.h"
 #include "iree/tooling/parameter_util.h"
+#include "iree/vm/bytecode/archive.h"
 #include "iree/vm/bytecode/module.h"
 #include "iree/vm/dynamic/module.h"
 
@@ -44,15 +45,47 @@ IREE_FLAG(
     "        warm-up time and variance as mapped pages are swapped\n"
     "        by the OS.");
 
+IREE_FLAG(
+    bool, module_trusted, false,
+    "Treats bytecode modules as coming from a trusted source and skips full\n"
+    "verification when loading them. Function bytecode is verified lazily on\n"
+    "first call instead. Only use with modules produced by a trusted\n"
+    "compiler as malformed modules may crash the process.");
+
+// Advises the platform how the mapped |file_contents| of a bytecode module
+// archive will be accessed. The FlatBuffer containing the module metadata and
+// bytecode is used immediately upon loading while external rodata (often large
+// constants) is sparsely referenced and paged in only as it is used.
+static void iree_tooling_advise_mapped_bytecode_module(
+    iree_file_contents_t* file_contents) {
+  iree_const_byte_span_t flatbuffer_contents = iree_const_byte_span_empty();
+  iree_host_size_t rodata_offset = 0;
+  iree_status_t status = iree_vm_bytecode_archive_parse_header(
+      file_contents->const_buffer, &flatbuffer_contents, &rodata_offset);
+  if (!iree_status_is_ok(status)) {
+    // Module creation will report the error.
+    iree_status_ignore(status);
+    return;
+  }
+  iree_file_contents_advise(file_contents, 0,
+                            file_contents->const_buffer.data_length,
+                            IREE_FILE_ADVICE_RANDOM);
+  iree_file_contents_advise(
+      file_contents,
+      (iree_host_size_t)(flatbuffer_contents.data -
+                         file_contents->const_buffer.data),
+      flatbuffer_contents.data_length, IREE_FILE_ADVICE_WILLNEED);
+}
+
 static iree_status_t iree_tooling_load_bytecode_module(
     iree_vm_instance_t* instance, iree_string_view_t path,
     iree_allocator_t host_allocator, iree_vm_module_t** out_module) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_TRACE_ZONE_APPEND_TEXT(z0, path.data, path.size);
 
-  // Fetch the file contents into memory.
-  // We could map the memory here if we wanted to and were coming from a file
-  // on disk.
+  // Fetch the file contents into memory or map them when requested. Rodata is
+  // referenced in-place by the module and never copied so when mapped only the
+  // pages that are used are read from disk.
   iree_file_contents_t* file_contents = NULL;
   if (iree_string_view_equal(path, IREE_SV("-"))) {
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
@@ -74,14 +107,20 @@ static iree_status_t iree_tooling_load_bytecode_module(
     IREE_RETURN_AND_END_ZONE_IF_ERROR(
         z0, iree_file_read_contents(path_str, read_flags, host_allocator,
                                     &file_contents));
+    if (read_flags & IREE_FILE_READ_FLAG_MMAP) {
+      iree_tooling_advise_mapped_bytecode_module(file_contents);
+    }
   }
 
   // Try to load the module as bytecode (all we have today that we can use).
   // We could sniff the file ID and switch off to other module types.
   // The module takes ownership of the file contents (when successful).
   iree_vm_module_t* module = NULL;
-  iree_status_t status = iree_vm_bytecode_module_create(
-      instance, file_contents->const_buffer,
+  iree_vm_bytecode_module_flags_t module_flags =
+      FLAG_module_trusted ? IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED
+                          : IREE_VM_BYTECODE_MODULE_FLAG_NONE;
+  iree_status_t status = iree_vm_bytecode_module_create_with_flags(
+      instance, module_flags, file_contents->const_buffer,
       iree_file_contents_deallocator(file_contents), host_allocator, &module);
 
   if (iree_status_is_ok(status)) {
@@ -11,6 +11,7 @@
 #include "iree/hal/drivers/init.h"
 #include "iree/hal/utils/allocators.h"
 #include "iree/hal/utils/mpi_channel_provider.h"
+#include "iree/hal/utils/shm_channel_provider.h"
 
 //===----------------------------------------------------------------------===//
 // Shared driver registry
@@ -313,14 +314,26 @@ static iree_status_t iree_hal_configure_allocator_from_flags(
 // as MPI rank/count configuration is global in the environment and not per
 // device. Hosting frameworks/runtimes can set their own providers that have
 // more meaningful representation of multi-device/multi-node.
+//
+// Single-host groups of processes can be configured explicitly with the
+// IREE_HAL_SHM_CHANNEL_* environment variables and take precedence over MPI.
+// Host CPU devices use shared memory channels with either provider.
 iree_status_t iree_hal_device_set_default_channel_provider(
     iree_hal_device_t* device) {
-  if (!iree_hal_mpi_is_configured()) return iree_ok_status();
   iree_hal_channel_provider_t* channel_provider = NULL;
-  IREE_RETURN_IF_ERROR(
-      iree_hal_mpi_channel_provider_create(
-          iree_hal_device_host_allocator(device), &channel_provider),
-      "creating MPI channel provider as detected in environment");
+  if (iree_hal_shm_channel_is_configured()) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_shm_channel_provider_create(
+            iree_hal_device_host_allocator(device), &channel_provider),
+        "creating shared memory channel provider as detected in environment");
+  } else if (iree_hal_mpi_is_configured()) {
+    IREE_RETURN_IF_ERROR(
+        iree_hal_mpi_channel_provider_create(
+            iree_hal_device_host_allocator(device), &channel_provider),
+        "creating MPI channel provider as detected in environment");
+  } else {
+    return iree_ok_status();
+  }
   iree_hal_device_replace_channel_provider(device, channel_provider);
   iree_hal_channel_provider_release(channel_provider);
   return iree_ok_status();
@@ -440,7 +453,9 @@ IREE_FLAG(
     string, device_profiling_file, "",
     "Optional file path/prefix for profiling file output. Some\n"
     "implementations may require a file name in order to capture profiling\n"
-    "information.");
+    "information. The local-sync device writes the per-dispatch costs\n"
+    "measured in 'dispatch' mode as JSON accepted by the compiler\n"
+    "`--iree-stream-cost-profile=` flag.");
 
 iree_status_t iree_hal_begin_profiling_from_flags(iree_hal_device_t* device) {
   if (!device) return iree_ok_status();
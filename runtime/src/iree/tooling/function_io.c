@@ -6,22 +6,73 @@
 
 #include "iree/tooling/function_io.h"
 
+#include "iree/base/internal/file_io.h"
+#include "iree/base/internal/flags.h"
+#include "iree/io/memory_stream.h"
 #include "iree/io/stdio_stream.h"
 #include "iree/io/stream.h"
 #include "iree/modules/hal/module.h"
 #include "iree/tooling/numpy_io.h"
 
+IREE_FLAG(
+    string, input_mode, "read",
+    "Controls how file inputs (`@file.npy`, `2xf32=@file.bin`, etc) are\n"
+    "loaded:\n"
+    "  `read`: contents are read into newly allocated device buffers.\n"
+    "  `mmap`: files are mapped into memory and imported as device buffers\n"
+    "          without copying when the device can access host memory and\n"
+    "          the contents are suitably aligned, otherwise copied.\n"
+    "Mapped inputs are read-only and must not be used as output storage.");
+
 //===----------------------------------------------------------------------===//
 // Utilities
 //===----------------------------------------------------------------------===//
 
+static void iree_io_file_contents_stream_release(void* user_data,
+                                                 iree_io_stream_t* stream) {
+  iree_file_contents_free((iree_file_contents_t*)user_data);
+}
+
+// Maps the file at |path| into host memory for read-only access and returns a
+// mappable stream over its contents. The mapping is released with the stream.
+static iree_status_t iree_io_stream_map_path(iree_string_view_t path,
+                                             iree_allocator_t host_allocator,
+                                             iree_io_stream_t** out_stream) {
+  IREE_ASSERT_ARGUMENT(out_stream);
+  *out_stream = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  char path_str[2048] = {0};
+  iree_string_view_to_cstring(path, path_str, sizeof(path_str));
+  iree_file_contents_t* contents = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_file_map_contents_readonly(path_str, host_allocator, &contents));
+
+  iree_io_memory_stream_release_callback_t release_callback = {
+      .fn = iree_io_file_contents_stream_release,
+      .user_data = contents,
+  };
+  iree_status_t status = iree_io_memory_stream_wrap(
+      IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_SEEKABLE |
+          IREE_IO_STREAM_MODE_MAPPABLE,
+      contents->buffer, release_callback, host_allocator, out_stream);
+  if (!iree_status_is_ok(status)) {
+    iree_file_contents_free(contents);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // NOTE: this will get moved at some point but is staged here while it's figured
 // out. I'm still not sure how best to factor things so that this doesn't get
 // pulled in all the time even if IO is never used. We may end up needing some
 // kind of registry that the main iree_io_stream_open uses or allow
 // iree_io_file_handle_t to carry a factory function for opening the handles of
 // certain types. For now we shim things here at the leaf.
+// If |map_file| is set the file is mapped into memory instead of read through
+// stdio and |mode| must be IREE_IO_STDIO_STREAM_MODE_READ.
 static iree_status_t iree_io_stream_open_path(iree_io_stdio_stream_mode_t mode,
+                                              bool map_file,
                                               iree_string_view_t path,
                                               uint64_t file_offset,
                                               iree_allocator_t host_allocator,
@@ -34,7 +85,11 @@ static iree_status_t iree_io_stream_open_path(iree_io_stdio_stream_mode_t mode,
   iree_status_t status = iree_ok_status();
   iree_io_stream_t* stream = NULL;
 
-  status = iree_io_stdio_stream_open(mode, path, host_allocator, &stream);
+  if (map_file) {
+    status = iree_io_stream_map_path(path, host_allocator, &stream);
+  } else {
+    status = iree_io_stdio_stream_open(mode, path, host_allocator, &stream);
+  }
   if (iree_status_is_ok(status) && file_offset > 0) {
     status = iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, file_offset);
   }
@@ -55,6 +110,10 @@ static iree_status_t iree_io_stream_open_path(iree_io_stdio_stream_mode_t mode,
 typedef struct iree_io_stream_list_entry_t {
   iree_string_view_t path;
   iree_io_stream_t* stream;
+  // Archive index when the stream is used as an .npz, opened on first use.
+  iree_numpy_npz_archive_t* npz_archive;
+  // Index of the next .npz member to load when appending.
+  iree_host_size_t npz_next_member;
   // + path char storage of path.size
 } iree_io_stream_list_entry_t;
 
@@ -68,13 +127,18 @@ typedef struct iree_io_stream_list_entry_t {
 typedef struct iree_io_stream_list_t {
   iree_allocator_t host_allocator;
   iree_io_stdio_stream_mode_t mode;
+  // True if files are mapped into memory instead of read through stdio.
+  bool map_files;
   iree_host_size_t capacity;
   iree_host_size_t count;
   iree_io_stream_list_entry_t** entries;
 } iree_io_stream_list_t;
 
 // Allocates a new stream list where all streams will share the same |mode|.
+// If |map_files| is true files are mapped into memory and |mode| must be
+// IREE_IO_STDIO_STREAM_MODE_READ.
 iree_status_t iree_io_stream_list_allocate(iree_io_stdio_stream_mode_t mode,
+                                           bool map_files,
                                            iree_allocator_t host_allocator,
                                            iree_io_stream_list_t** out_list) {
   IREE_ASSERT_ARGUMENT(out_list);
@@ -86,6 +150,7 @@ iree_status_t iree_io_stream_list_allocate(iree_io_stdio_stream_mode_t mode,
       z0, iree_allocator_malloc(host_allocator, sizeof(*list), (void**)&list));
   list->host_allocator = host_allocator;
   list->mode = mode;
+  list->map_files = map_files;
 
   *out_list = list;
   IREE_TRACE_ZONE_END(z0);
@@ -99,6 +164,7 @@ void iree_io_stream_list_free(iree_io_stream_list_t* list) {
 
   for (iree_host_size_t i = 0; i < list->count; ++i) {
     iree_io_stream_list_entry_t* entry = list->entries[i];
+    iree_numpy_npz_archive_free(entry->npz_archive);
     iree_io_stream_release(entry->stream);
     iree_allocator_free(list->host_allocator, entry);
   }
@@ -227,8 +293,8 @@ iree_status_t iree_io_stream_list_open(iree_io_stream_list_t* list,
   // Open the file at the path specified.
   iree_io_stream_t* stream = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_io_stream_open_path(list->mode, path, 0ull, list->host_allocator,
-                                   &stream));
+      z0, iree_io_stream_open_path(list->mode, list->map_files, path, 0ull,
+                                   list->host_allocator, &stream));
 
   // Append the stream entry to the list so it's retained for future opens.
   iree_status_t status = iree_io_stream_list_append_entry(list, path, stream);
@@ -401,13 +467,83 @@ static iree_status_t iree_tooling_parse_buffer_view_file_callback(
                              /*out_buffer_length=*/NULL);
 }
 
+static void iree_tooling_mapped_buffer_release(void* user_data,
+                                               iree_hal_buffer_t* buffer) {
+  iree_io_stream_release((iree_io_stream_t*)user_data);
+}
+
+// Tries to import |byte_length| bytes at the current offset of a mappable
+// |stream| as a read-only HAL buffer without copying. Returns NULL in
+// |out_buffer| with the stream offset unchanged if the device cannot use the
+// mapped memory in-place so that callers can fall back to reading.
+static iree_status_t iree_tooling_try_map_stream_buffer(
+    iree_io_stream_t* stream, iree_device_size_t byte_length,
+    iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+  if (!iree_all_bits_set(iree_io_stream_mode(stream),
+                         IREE_IO_STREAM_MODE_MAPPABLE) ||
+      byte_length == 0 || byte_length > IREE_HOST_SIZE_MAX) {
+    return iree_ok_status();
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_stream_pos_t start_offset = iree_io_stream_offset(stream);
+  iree_const_byte_span_t contents = iree_const_byte_span_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_stream_map_read(stream, (iree_host_size_t)byte_length,
+                                  &contents));
+
+  // Dispatches assume their bindings are aligned and mapped file contents are
+  // only aligned if the user has laid out their file that way.
+  iree_status_t status = iree_ok_status();
+  if (iree_host_size_has_alignment((iree_host_size_t)contents.data,
+                                   IREE_HAL_HEAP_BUFFER_ALIGNMENT)) {
+    iree_hal_external_buffer_t external_buffer = {
+        .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+        .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+        .size = byte_length,
+        .handle =
+            {
+                .host_allocation =
+                    {
+                        .ptr = (void*)contents.data,
+                    },
+            },
+    };
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_tooling_mapped_buffer_release,
+        .user_data = stream,
+    };
+    buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+    iree_io_stream_retain(stream);
+    status = iree_hal_allocator_import_buffer(device_allocator, buffer_params,
+                                              &external_buffer,
+                                              release_callback, out_buffer);
+    if (!iree_status_is_ok(status)) {
+      // Failed to import - that's ok as we'll fall back to reading.
+      status = iree_status_ignore(status);
+      iree_io_stream_release(stream);
+      *out_buffer = NULL;
+    }
+  }
+
+  if (!*out_buffer) {
+    status = iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, start_offset);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
 // Creates a HAL buffer view with the given |metadata| and reads the contents
 // from the file reference in |string| which has the prefix `@` to indicate
 // the contents starting from 0 and `+` for the next contents in an already
 // opened stream.
-// The file contents are directly read in to memory with no processing.
+// The file contents are directly read in to memory with no processing unless
+// the file has been mapped and |is_storage| is false in which case the mapped
+// contents may be used in-place.
 static iree_status_t iree_tooling_parse_buffer_view_file(
-    iree_string_view_t metadata, iree_string_view_t string,
+    iree_string_view_t metadata, iree_string_view_t string, bool is_storage,
     iree_hal_device_t* device, iree_hal_allocator_t* device_allocator,
     iree_io_stream_list_t* stream_list,
     iree_hal_buffer_view_t** out_buffer_view) {
@@ -437,24 +573,42 @@ static iree_status_t iree_tooling_parse_buffer_view_file(
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_io_stream_list_open(stream_list, path, is_append, &stream));
 
-  // TODO(benvanik): support mapping on allocators that can handle importing
-  // host memory. We only want to do this when it won't hurt performance
-  // (unified memory systems and where the mapped memory meets alignment
-  // requirements). For now we always wire new device memory to read into.
-  // A real application would want to either do the import or use
-  // iree_hal_file_t to stream the file contents into device memory without
-  // going through host memory.
-
-  // Read the stream contents into the buffer.
   iree_hal_buffer_params_t buffer_params = {
       .usage = IREE_HAL_BUFFER_USAGE_DEFAULT,
       .access = IREE_HAL_MEMORY_ACCESS_ALL,
       .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
   };
-  iree_status_t status = iree_hal_buffer_view_generate_buffer(
-      device, device_allocator, shape_rank, shape, element_type, encoding_type,
-      buffer_params, iree_tooling_parse_buffer_view_file_callback, stream,
-      out_buffer_view);
+
+  // If the file is mapped and the device can access host memory we use the
+  // contents in-place. Output storage must be writable and is always copied.
+  // A real application on discrete devices would want to use iree_hal_file_t
+  // to stream the file contents into device memory without going through
+  // host memory.
+  iree_status_t status = iree_ok_status();
+  iree_hal_buffer_t* mapped_buffer = NULL;
+  if (!is_storage) {
+    iree_device_size_t byte_length = 0;
+    status = iree_hal_buffer_compute_view_size(
+        shape_rank, shape, element_type, encoding_type, &byte_length);
+    if (iree_status_is_ok(status)) {
+      status = iree_tooling_try_map_stream_buffer(
+          stream, byte_length, buffer_params, device_allocator, &mapped_buffer);
+    }
+    if (iree_status_is_ok(status) && mapped_buffer) {
+      status = iree_hal_buffer_view_create(
+          mapped_buffer, shape_rank, shape, element_type, encoding_type,
+          iree_hal_allocator_host_allocator(device_allocator), out_buffer_view);
+    }
+    iree_hal_buffer_release(mapped_buffer);
+  }
+
+  // Read the stream contents into the buffer.
+  if (iree_status_is_ok(status) && !mapped_buffer) {
+    status = iree_hal_buffer_view_generate_buffer(
+        device, device_allocator, shape_rank, shape, element_type,
+        encoding_type, buffer_params,
+        iree_tooling_parse_buffer_view_file_callback, stream, out_buffer_view);
+  }
 
   iree_io_stream_release(stream);
   IREE_TRACE_ZONE_END(z0);
@@ -462,8 +616,10 @@ static iree_status_t iree_tooling_parse_buffer_view_file(
 }
 
 // Parses a shaped tensor type into a HAL buffer view.
+// |is_storage| indicates the buffer will be used for output storage and must be
+// writable.
 static iree_status_t iree_tooling_parse_tensor(
-    iree_string_view_t string, iree_hal_device_t* device,
+    iree_string_view_t string, bool is_storage, iree_hal_device_t* device,
     iree_hal_allocator_t* device_allocator, iree_io_stream_list_t* stream_list,
     iree_allocator_t host_allocator, iree_hal_buffer_view_t** out_buffer_view) {
   // If contents are sourced from a file then route to that, and otherwise
@@ -472,9 +628,9 @@ static iree_status_t iree_tooling_parse_tensor(
   if (iree_string_view_split(string, '=', &metadata, &contents) != -1) {
     if (iree_string_view_starts_with(contents, IREE_SV("@")) ||
         iree_string_view_starts_with(contents, IREE_SV("+"))) {
-      return iree_tooling_parse_buffer_view_file(metadata, contents, device,
-                                                 device_allocator, stream_list,
-                                                 out_buffer_view);
+      return iree_tooling_parse_buffer_view_file(
+          metadata, contents, is_storage, device, device_allocator, stream_list,
+          out_buffer_view);
     }
   }
 
@@ -512,8 +668,9 @@ static iree_status_t iree_tooling_parse_tensor_into(
   // Parse the tensor contents.
   iree_hal_buffer_view_t* buffer_view = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_tooling_parse_tensor(string, device, device_allocator,
-                                    stream_list, host_allocator, &buffer_view));
+      z0, iree_tooling_parse_tensor(string, /*is_storage=*/false, device,
+                                    device_allocator, stream_list,
+                                    host_allocator, &buffer_view));
 
   // Add buffer view to list.
   iree_vm_ref_t buffer_view_ref = iree_hal_buffer_view_move_ref(buffer_view);
@@ -538,8 +695,9 @@ static iree_status_t iree_tooling_parse_storage_into(
   // Parse the tensor contents.
   iree_hal_buffer_view_t* buffer_view = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0, iree_tooling_parse_tensor(string, device, device_allocator,
-                                    stream_list, host_allocator, &buffer_view));
+      z0, iree_tooling_parse_tensor(string, /*is_storage=*/true, device,
+                                    device_allocator, stream_list,
+                                    host_allocator, &buffer_view));
 
   // Add just the storage buffer to the list - we don't need the metadata.
   iree_vm_ref_t buffer_ref =
@@ -551,11 +709,21 @@ static iree_status_t iree_tooling_parse_storage_into(
   return status;
 }
 
+// Returns the numpy load options used for files opened from |stream_list|.
+static iree_numpy_npy_load_options_t iree_tooling_numpy_load_options(
+    iree_io_stream_list_t* stream_list) {
+  return stream_list->map_files ? IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE
+                                : IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT;
+}
+
 // Parses a single ndarray from |stream| as a HAL buffer view and appends it to
-// |list|.
+// |list|. If |npz_archive| is provided the ndarray is sourced from the archive
+// member at |npz_member_index| instead.
 static iree_status_t iree_tooling_parse_ndarray_into(
     iree_string_view_t* cconv, iree_vm_list_t* list, iree_io_stream_t* stream,
-    iree_hal_device_t* device, iree_hal_allocator_t* device_allocator) {
+    iree_numpy_npz_archive_t* npz_archive, iree_host_size_t npz_member_index,
+    iree_numpy_npy_load_options_t options, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Expect a ref holding the buffer view.
@@ -567,9 +735,16 @@ static iree_status_t iree_tooling_parse_ndarray_into(
       .type = IREE_HAL_MEMORY_TYPE_DEVICE_LOCAL,
   };
   iree_hal_buffer_view_t* buffer_view = NULL;
-  iree_status_t status = iree_numpy_npy_load_ndarray(
-      stream, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params, device,
-      device_allocator, &buffer_view);
+  iree_status_t status = iree_ok_status();
+  if (npz_archive) {
+    status = iree_numpy_npz_archive_load_ndarray(
+        npz_archive, npz_member_index, options, buffer_params, device,
+        device_allocator, &buffer_view);
+  } else {
+    status = iree_numpy_npy_load_ndarray(stream, options, buffer_params,
+                                         device, device_allocator,
+                                         &buffer_view);
+  }
 
   if (iree_status_is_ok(status)) {
     iree_vm_ref_t buffer_view_ref = iree_hal_buffer_view_move_ref(buffer_view);
@@ -581,9 +756,66 @@ static iree_status_t iree_tooling_parse_ndarray_into(
   return status;
 }
 
+// Parses zero or more variants from the .npz archive at |path| into the |list|.
+// Members are consumed in archive order unless |member_name| is provided in
+// which case that member is loaded (and appending continues after it).
+static iree_status_t iree_tooling_parse_npz_into(
+    iree_string_view_t* cconv, iree_string_view_t path,
+    iree_string_view_t member_name, bool is_append, bool is_splat,
+    iree_vm_list_t* list, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_io_stream_list_t* stream_list) {
+  // Open (or retrieve) the file and its archive index. Only the central
+  // directory is read here and members are loaded on demand.
+  iree_io_stream_t* stream = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_io_stream_list_open(stream_list, path, is_append, &stream));
+  iree_io_stream_list_entry_t* entry =
+      iree_io_stream_list_find_entry(stream_list, path);
+  iree_status_t status = iree_ok_status();
+  if (!entry->npz_archive) {
+    status = iree_numpy_npz_archive_open(stream, stream_list->host_allocator,
+                                         &entry->npz_archive);
+  }
+  iree_io_stream_release(stream);
+  IREE_RETURN_IF_ERROR(status);
+  iree_numpy_npz_archive_t* archive = entry->npz_archive;
+  iree_host_size_t member_count = iree_numpy_npz_archive_member_count(archive);
+
+  // Select the first member to load.
+  if (!is_append) entry->npz_next_member = 0;
+  if (!iree_string_view_is_empty(member_name)) {
+    IREE_RETURN_IF_ERROR(iree_numpy_npz_archive_find_member(
+        archive, member_name, &entry->npz_next_member));
+  }
+
+  iree_numpy_npy_load_options_t options =
+      iree_tooling_numpy_load_options(stream_list);
+  if (!is_splat) {
+    if (entry->npz_next_member >= member_count) {
+      return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                              "no more members in npz archive (%" PRIhsz
+                              " total)",
+                              member_count);
+    }
+    status = iree_tooling_parse_ndarray_into(
+        cconv, list, /*stream=*/NULL, archive, entry->npz_next_member++,
+        options, device, device_allocator);
+  } else {
+    while (iree_status_is_ok(status) &&
+           entry->npz_next_member < member_count) {
+      status = iree_tooling_parse_ndarray_into(
+          cconv, list, /*stream=*/NULL, archive, entry->npz_next_member++,
+          options, device, device_allocator);
+    }
+  }
+  return status;
+}
+
 // Parses zero or more variants from a file into the |list|.
 // The |string| defines the file mode (`@` new, `+` existing, `*` splat) and
-// the path to source from.
+// the path to source from. Members of .npz archives can be selected by name
+// with `@file.npz:name`.
 static iree_status_t iree_tooling_parse_file_into(
     iree_string_view_t* cconv, iree_string_view_t string, iree_vm_list_t* list,
     iree_hal_device_t* device, iree_hal_allocator_t* device_allocator,
@@ -599,12 +831,32 @@ static iree_status_t iree_tooling_parse_file_into(
   iree_string_view_t path =
       iree_string_view_substr(string, 1, IREE_HOST_SIZE_MAX);
 
+  // npz archives may have a member name suffix: `file.npz:name`.
+  iree_string_view_t member_name = iree_string_view_empty();
+  iree_host_size_t colon_pos =
+      iree_string_view_find_last_of(path, IREE_SV(":"), IREE_HOST_SIZE_MAX);
+  if (colon_pos != IREE_STRING_VIEW_NPOS &&
+      iree_string_view_ends_with(iree_string_view_substr(path, 0, colon_pos),
+                                 IREE_SV(".npz"))) {
+    member_name = iree_string_view_substr(path, colon_pos + 1,
+                                          IREE_HOST_SIZE_MAX);
+    path = iree_string_view_substr(path, 0, colon_pos);
+  }
+  if (iree_string_view_ends_with(path, IREE_SV(".npz"))) {
+    iree_status_t status = iree_tooling_parse_npz_into(
+        cconv, path, member_name, is_append, is_splat, list, device,
+        device_allocator, stream_list);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
   // Today we only support numpy files here but could make this pluggable or at
   // least a little smarter (sniff file header/etc) instead of relying on ext.
   if (!iree_string_view_ends_with(path, IREE_SV(".npy"))) {
-    return iree_make_status(
-        IREE_STATUS_UNIMPLEMENTED,
-        "only numpy (.npy) files are supported for metadata-less variant I/O");
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "only numpy (.npy/.npz) files are supported for "
+                            "metadata-less variant I/O");
   }
 
   // Open (or retrieve) the file.
@@ -612,17 +864,21 @@ static iree_status_t iree_tooling_parse_file_into(
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
       z0, iree_io_stream_list_open(stream_list, path, is_append, &stream));
 
+  iree_numpy_npy_load_options_t options =
+      iree_tooling_numpy_load_options(stream_list);
   iree_status_t status = iree_ok_status();
   if (!is_splat) {
     // Read a single ndarray from the stream at the current offset.
-    status = iree_tooling_parse_ndarray_into(cconv, list, stream, device,
-                                             device_allocator);
+    status = iree_tooling_parse_ndarray_into(
+        cconv, list, stream, /*npz_archive=*/NULL, 0, options, device,
+        device_allocator);
   } else {
     // Read zero or more ndarrays from the stream - note that it may already be
     // at EOS.
     while (iree_status_is_ok(status) && !iree_io_stream_is_eos(stream)) {
-      status = iree_tooling_parse_ndarray_into(cconv, list, stream, device,
-                                               device_allocator);
+      status = iree_tooling_parse_ndarray_into(
+          cconv, list, stream, /*npz_archive=*/NULL, 0, options, device,
+          device_allocator);
     }
   }
 
@@ -672,9 +928,20 @@ static iree_status_t iree_tooling_parse_variants_into(
 
   // List of opened streams used for allowing multiple arguments to source from
   // the same file sequentially.
+  bool map_files = false;
+  if (strcmp(FLAG_input_mode, "mmap") == 0) {
+    map_files = true;
+  } else if (strcmp(FLAG_input_mode, "read") != 0) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "unrecognized --input_mode= value '%s'",
+                            FLAG_input_mode);
+  }
   iree_io_stream_list_t* stream_list = NULL;
-  IREE_RETURN_IF_ERROR(iree_io_stream_list_allocate(
-      IREE_IO_STDIO_STREAM_MODE_READ, host_allocator, &stream_list));
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_stream_list_allocate(IREE_IO_STDIO_STREAM_MODE_READ,
+                                       map_files, host_allocator,
+                                       &stream_list));
 
   // Parse each variant string. Note that some strings may expand to zero or
   // more variants and so we need to consume the cconv based on how many were
@@ -38,12 +38,21 @@ extern "C" {
 //    `@file.npy` (first array from the file)
 //    `+file.npy` (next array from the file)
 //    `*file.npy` (all following arrays from the file)
+//  - Numpy archives (uncompressed `numpy.savez`, members loaded on demand):
+//    `@file.npz` (first member of the archive)
+//    `@file.npz:name` (member saved as `name`)
+//    `+file.npz` (next member of the archive)
+//    `*file.npz` (all following members of the archive)
 //  - Binary files:
 //    `2x2xf32=@file.ext` (dense tensor<2x2xf32> at the start of the file)
 //    `4xf32=+file.ext` (dense tensor<4xf32> following the prior input)
 //  - Storage buffers for output arguments (shape/type used for sizing):
 //    `&4xf32` (tensor<4xf32> as a HAL buffer for output operands)
 //    `&4xf32=1,2,3,4` (tensor<4xf32> storage with an initial value)
+//
+// When `--input_mode=mmap` is specified files are mapped into memory and inputs
+// are imported into the device without copying if the device supports
+// accessing host memory and the contents are sufficiently aligned.
 iree_status_t iree_tooling_parse_variants(
     iree_string_view_t cconv, iree_string_view_list_t specs,
     iree_hal_device_t* device, iree_hal_allocator_t* device_allocator,
@@ -12,6 +12,7 @@
 
 #include "iree/base/internal/flags.h"
 #include "iree/modules/hal/types.h"
+#include "iree/schemas/instruments/dispatch.h"
 
 //===----------------------------------------------------------------------===//
 // Instrument data management
@@ -50,24 +51,13 @@ static iree_status_t iree_tooling_write_iovec(iree_vm_ref_t iovec, FILE* file) {
                                      "failed to write iovec to file");
 }
 
-iree_status_t iree_tooling_process_instrument_data(
-    iree_vm_context_t* context, iree_allocator_t host_allocator) {
-  // If no flag was specified we ignore instrument data.
-  if (strlen(FLAG_instrument_file) == 0) return iree_ok_status();
-
+// Queries all instrument iovecs from modules in |context| and returns them in
+// a list that must be released by the caller.
+static iree_status_t iree_tooling_query_instrument_iovecs(
+    iree_vm_context_t* context, iree_allocator_t host_allocator,
+    iree_vm_list_t** out_iovec_list) {
   IREE_TRACE_ZONE_BEGIN(z0);
-  IREE_TRACE_ZONE_APPEND_TEXT(z0, FLAG_instrument_file);
-
-  // Open the file for overwriting. We do this even if there is no instrument
-  // data in the program as we'd rather have the user end up with a 0-byte file
-  // when they explicitly ask for it instead of stale data from previous runs.
-  FILE* file = fopen(FLAG_instrument_file, "wb");
-  if (!file) {
-    IREE_TRACE_ZONE_END(z0);
-    return iree_make_status(iree_status_code_from_errno(errno),
-                            "failed to open instrument file '%s' for writing",
-                            FLAG_instrument_file);
-  }
+  *out_iovec_list = NULL;
 
   // Each query function pushes iovecs on to a list we provide; we create one
   // list and use that across all of them.
@@ -112,6 +102,38 @@ iree_status_t iree_tooling_process_instrument_data(
     }
   }
 
+  iree_vm_list_release(input_list);
+  if (iree_status_is_ok(status)) {
+    *out_iovec_list = iovec_list;
+  } else {
+    iree_vm_list_release(iovec_list);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_tooling_write_instrument_data(
+    iree_vm_context_t* context, const char* path,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(path);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, path);
+
+  // Open the file for overwriting. We do this even if there is no instrument
+  // data in the program as we'd rather have the user end up with a 0-byte file
+  // when they explicitly ask for it instead of stale data from previous runs.
+  FILE* file = fopen(path, "wb");
+  if (!file) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(iree_status_code_from_errno(errno),
+                            "failed to open instrument file '%s' for writing",
+                            path);
+  }
+
+  iree_vm_list_t* iovec_list = NULL;
+  iree_status_t status = iree_tooling_query_instrument_iovecs(
+      context, host_allocator, &iovec_list);
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < iree_vm_list_size(iovec_list); ++i) {
       iree_vm_ref_t iovec = iree_vm_ref_null();
@@ -122,9 +144,57 @@ iree_status_t iree_tooling_process_instrument_data(
     }
   }
 
-  iree_vm_list_release(input_list);
   iree_vm_list_release(iovec_list);
   fclose(file);
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+iree_status_t iree_tooling_process_instrument_data(
+    iree_vm_context_t* context, iree_allocator_t host_allocator) {
+  // If no flag was specified we ignore instrument data.
+  if (strlen(FLAG_instrument_file) == 0) return iree_ok_status();
+  return iree_tooling_write_instrument_data(context, FLAG_instrument_file,
+                                            host_allocator);
+}
+
+iree_status_t iree_tooling_set_instrument_sampling_period(
+    iree_vm_context_t* context, uint32_t period,
+    iree_allocator_t host_allocator) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, period);
+
+  iree_vm_list_t* iovec_list = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_tooling_query_instrument_iovecs(context, host_allocator,
+                                               &iovec_list));
+
+  // Dispatch ringbuffers are the only buffer views in the iovec list; the
+  // period lives in their footer at a fixed offset from the end.
+  iree_status_t status = iree_ok_status();
+  for (iree_host_size_t i = 0; i < iree_vm_list_size(iovec_list); ++i) {
+    iree_vm_ref_t iovec = iree_vm_ref_null();
+    status = iree_vm_list_get_ref_assign(iovec_list, i, &iovec);
+    if (!iree_status_is_ok(status)) break;
+    if (!iree_hal_buffer_view_isa(iovec)) continue;
+    iree_hal_buffer_view_t* buffer_view = iree_hal_buffer_view_deref(iovec);
+    iree_device_size_t byte_length =
+        iree_hal_buffer_view_byte_length(buffer_view);
+    if (byte_length < IREE_INSTRUMENT_DISPATCH_SAMPLING_PERIOD_OFFSET) {
+      status = iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                "instrument buffer too small to contain a "
+                                "sampling period footer");
+      break;
+    }
+    status = iree_hal_buffer_map_write(
+        iree_hal_buffer_view_buffer(buffer_view),
+        byte_length - IREE_INSTRUMENT_DISPATCH_SAMPLING_PERIOD_OFFSET, &period,
+        sizeof(period));
+    if (!iree_status_is_ok(status)) break;
+  }
+
+  iree_vm_list_release(iovec_list);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -23,6 +23,27 @@ extern "C" {
 iree_status_t iree_tooling_process_instrument_data(
     iree_vm_context_t* context, iree_allocator_t host_allocator);
 
+// Writes a snapshot of all instrument data in |context| to the file at |path|.
+// Unlike iree_tooling_process_instrument_data this ignores flags and can be
+// called repeatedly (such as periodically from a long-running service) while
+// the program is executing. Entries recorded concurrently with the snapshot
+// may be torn and should be discarded by tools consuming the file.
+iree_status_t iree_tooling_write_instrument_data(
+    iree_vm_context_t* context, const char* path,
+    iree_allocator_t host_allocator);
+
+// Sets the workgroup sampling period of all dispatch instrumentation in
+// |context|. Programs must have been compiled with a nonzero
+// `--iree-hal-instrument-dispatches-sampling-period=` for this to have any
+// effect. Every |period|-th workgroup of each dispatch records its events and a
+// period of 0 pauses recording entirely. Toggling between 0 and a nonzero
+// period allows hosts to sample time windows instead of (or in addition to)
+// workgroups. The change applies to dispatches that begin executing after it
+// lands and does not require synchronizing with in-flight work.
+iree_status_t iree_tooling_set_instrument_sampling_period(
+    iree_vm_context_t* context, uint32_t period,
+    iree_allocator_t host_allocator);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -281,6 +281,79 @@ static iree_status_t iree_numpy_parse_shape_dims(iree_string_view_t shape,
   return iree_ok_status();
 }
 
+static void iree_numpy_npy_mapped_buffer_release(void* user_data,
+                                                 iree_hal_buffer_t* buffer) {
+  iree_io_stream_release((iree_io_stream_t*)user_data);
+}
+
+// Tries to import |byte_length| bytes at the current offset of a mappable
+// |stream| directly as a HAL buffer without copying. Returns NULL in
+// |out_buffer| with the stream offset unchanged if the contents cannot be used
+// in-place (unsupported allocator, misaligned, or writable buffers requested).
+// The returned buffer retains |stream| as the mapped memory is owned by it.
+static iree_status_t iree_numpy_npy_try_map_buffer(
+    iree_io_stream_t* stream, iree_device_size_t byte_length,
+    iree_hal_buffer_params_t buffer_params,
+    iree_hal_allocator_t* device_allocator, iree_hal_buffer_t** out_buffer) {
+  *out_buffer = NULL;
+
+  // Mapped file contents are read-only and must only be used with buffers the
+  // program won't write to.
+  if (!iree_all_bits_set(
+          iree_io_stream_mode(stream),
+          IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_MAPPABLE) ||
+      iree_any_bit_set(buffer_params.access,
+                       IREE_HAL_MEMORY_ACCESS_WRITE |
+                           IREE_HAL_MEMORY_ACCESS_DISCARD) ||
+      byte_length == 0 || byte_length > IREE_HOST_SIZE_MAX) {
+    return iree_ok_status();
+  }
+
+  iree_io_stream_pos_t start_offset = iree_io_stream_offset(stream);
+  iree_const_byte_span_t contents = iree_const_byte_span_empty();
+  IREE_RETURN_IF_ERROR(iree_io_stream_map_read(
+      stream, (iree_host_size_t)byte_length, &contents));
+
+  // Dispatches assume their bindings are aligned. npy payloads are 64-byte
+  // aligned relative to the start of the file but members of an npz may not be.
+  iree_status_t status = iree_ok_status();
+  if (iree_host_size_has_alignment((iree_host_size_t)contents.data,
+                                   IREE_HAL_HEAP_BUFFER_ALIGNMENT)) {
+    iree_hal_external_buffer_t external_buffer = {
+        .type = IREE_HAL_EXTERNAL_BUFFER_TYPE_HOST_ALLOCATION,
+        .flags = IREE_HAL_EXTERNAL_BUFFER_FLAG_NONE,
+        .size = byte_length,
+        .handle =
+            {
+                .host_allocation =
+                    {
+                        .ptr = (void*)contents.data,
+                    },
+            },
+    };
+    iree_hal_buffer_release_callback_t release_callback = {
+        .fn = iree_numpy_npy_mapped_buffer_release,
+        .user_data = stream,
+    };
+    iree_io_stream_retain(stream);
+    status = iree_hal_allocator_import_buffer(
+        device_allocator, buffer_params, &external_buffer, release_callback,
+        out_buffer);
+    if (!iree_status_is_ok(status)) {
+      // Failed to import - that's ok as we'll fall back to copies.
+      status = iree_status_ignore(status);
+      iree_io_stream_release(stream);
+      *out_buffer = NULL;
+    }
+  }
+
+  // Rewind so that the caller can read the contents itself.
+  if (!*out_buffer) {
+    status = iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, start_offset);
+  }
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     iree_io_stream_t* stream, iree_numpy_npy_load_options_t options,
     iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
@@ -356,10 +429,30 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_load_ndarray(
     if (!iree_status_is_ok(status)) break;
   }
 
+  // If requested try to use the file contents in-place. This is only possible
+  // when the stream is backed by host memory the device can access.
+  iree_hal_buffer_t* mapped_buffer = NULL;
+  if (iree_status_is_ok(status) &&
+      iree_all_bits_set(options, IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE)) {
+    iree_device_size_t byte_length = 0;
+    status = iree_hal_buffer_compute_view_size(
+        shape_rank, shape, element_type, encoding_type, &byte_length);
+    if (iree_status_is_ok(status)) {
+      status = iree_numpy_npy_try_map_buffer(
+          stream, byte_length, buffer_params, device_allocator, &mapped_buffer);
+    }
+    if (iree_status_is_ok(status) && mapped_buffer) {
+      status = iree_hal_buffer_view_create(mapped_buffer, shape_rank, shape,
+                                           element_type, encoding_type,
+                                           host_allocator, out_buffer_view);
+    }
+    iree_hal_buffer_release(mapped_buffer);
+  }
+
   // Allocate the buffer view and directly read into the allocated memory.
   // On targets where we can perform host mapping this will be zero-copy; on
   // others it'll at least be _somewhat_ efficient.
-  if (iree_status_is_ok(status)) {
+  if (iree_status_is_ok(status) && !mapped_buffer) {
     iree_numpy_npy_read_params_t read_params = {
         .stream = stream,
     };
@@ -599,3 +692,435 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_save_ndarray(
   IREE_TRACE_ZONE_END(z0);
   return status;
 }
+
+//===----------------------------------------------------------------------===//
+// .npz (zip archive of .npy files)
+//===----------------------------------------------------------------------===//
+
+// File format spec:
+// https://pkware.cachefly.net/webdocs/casestudies/APPNOTE.TXT
+//
+// We only read the central directory at the end of the file to index members
+// and then seek to the local file header of each member as it is loaded. numpy
+// writes all members with zip64 extensions when using `numpy.savez` so we
+// support those as well.
+
+#define IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIGNATURE 0x04034B50u
+#define IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_SIGNATURE 0x02014B50u
+#define IREE_NUMPY_ZIP_EOCD_SIGNATURE 0x06054B50u
+#define IREE_NUMPY_ZIP64_EOCD_SIGNATURE 0x06064B50u
+#define IREE_NUMPY_ZIP64_EOCD_LOCATOR_SIGNATURE 0x07064B50u
+#define IREE_NUMPY_ZIP64_EXTRA_FIELD_ID 0x0001u
+
+#define IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE 30
+#define IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_HEADER_SIZE 46
+#define IREE_NUMPY_ZIP_EOCD_SIZE 22
+#define IREE_NUMPY_ZIP64_EOCD_SIZE 56
+#define IREE_NUMPY_ZIP64_EOCD_LOCATOR_SIZE 20
+#define IREE_NUMPY_ZIP_MAX_COMMENT_LENGTH 0xFFFF
+
+// Compression method of members stored without compression.
+#define IREE_NUMPY_ZIP_METHOD_STORED 0
+
+typedef struct iree_numpy_npz_member_t {
+  // Member name with the `.npy` suffix removed.
+  iree_string_view_t name;
+  // Compression method; only IREE_NUMPY_ZIP_METHOD_STORED can be loaded.
+  uint16_t method;
+  // Size of the member data in the archive.
+  uint64_t compressed_size;
+  // Offset of the local file header from the start of the archive.
+  uint64_t local_header_offset;
+} iree_numpy_npz_member_t;
+
+struct iree_numpy_npz_archive_t {
+  iree_allocator_t host_allocator;
+  iree_io_stream_t* stream;
+  iree_host_size_t member_count;
+  iree_numpy_npz_member_t* members;
+  // Verbatim central directory that member names reference.
+  uint8_t* central_directory;
+};
+
+// Zip records are packed little-endian with no alignment guarantees.
+static uint16_t iree_numpy_zip_read_u16(const uint8_t* ptr) {
+  return (uint16_t)(ptr[0] | (ptr[1] << 8));
+}
+static uint32_t iree_numpy_zip_read_u32(const uint8_t* ptr) {
+  return (uint32_t)iree_numpy_zip_read_u16(ptr) |
+         ((uint32_t)iree_numpy_zip_read_u16(ptr + 2) << 16);
+}
+static uint64_t iree_numpy_zip_read_u64(const uint8_t* ptr) {
+  return (uint64_t)iree_numpy_zip_read_u32(ptr) |
+         ((uint64_t)iree_numpy_zip_read_u32(ptr + 4) << 32);
+}
+
+// Reads |length| bytes at the absolute |offset| in |stream| into |buffer|.
+static iree_status_t iree_numpy_zip_read_at(iree_io_stream_t* stream,
+                                            uint64_t offset,
+                                            iree_host_size_t length,
+                                            void* buffer) {
+  IREE_RETURN_IF_ERROR(
+      iree_io_stream_seek(stream, IREE_IO_STREAM_SEEK_SET, offset));
+  return iree_io_stream_read(stream, length, buffer, NULL);
+}
+
+// Locates the central directory of the zip archive in |stream|.
+static iree_status_t iree_numpy_zip_find_central_directory(
+    iree_io_stream_t* stream, iree_allocator_t host_allocator,
+    uint64_t* out_entry_count, uint64_t* out_offset, uint64_t* out_size) {
+  *out_entry_count = 0;
+  *out_offset = 0;
+  *out_size = 0;
+
+  // The end of central directory record is at the end of the file but may be
+  // followed by a variable-length comment; we scan backwards through the
+  // maximum possible tail to find its signature.
+  uint64_t stream_length = (uint64_t)iree_io_stream_length(stream);
+  if (stream_length < IREE_NUMPY_ZIP_EOCD_SIZE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npz file too small to be a zip archive");
+  }
+  iree_host_size_t tail_length = (iree_host_size_t)iree_min(
+      stream_length,
+      IREE_NUMPY_ZIP_EOCD_SIZE + IREE_NUMPY_ZIP64_EOCD_LOCATOR_SIZE +
+          IREE_NUMPY_ZIP_MAX_COMMENT_LENGTH);
+  uint64_t tail_offset = stream_length - tail_length;
+  uint8_t* tail = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(host_allocator, tail_length, (void**)&tail));
+  iree_status_t status =
+      iree_numpy_zip_read_at(stream, tail_offset, tail_length, tail);
+
+  iree_host_size_t eocd_position = IREE_HOST_SIZE_MAX;
+  if (iree_status_is_ok(status)) {
+    for (iree_host_size_t i = tail_length - IREE_NUMPY_ZIP_EOCD_SIZE + 1;
+         i-- > 0;) {
+      if (iree_numpy_zip_read_u32(tail + i) == IREE_NUMPY_ZIP_EOCD_SIGNATURE) {
+        eocd_position = i;
+        break;
+      }
+    }
+    if (eocd_position == IREE_HOST_SIZE_MAX) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "npz end of central directory not found; file "
+                                "is not a zip archive");
+    }
+  }
+
+  if (iree_status_is_ok(status)) {
+    const uint8_t* eocd = tail + eocd_position;
+    *out_entry_count = iree_numpy_zip_read_u16(eocd + 10);
+    *out_size = iree_numpy_zip_read_u32(eocd + 12);
+    *out_offset = iree_numpy_zip_read_u32(eocd + 16);
+
+    // Archives with large members/offsets place the real values in the zip64
+    // end of central directory record referenced by a locator immediately
+    // preceding the regular record.
+    if (eocd_position >= IREE_NUMPY_ZIP64_EOCD_LOCATOR_SIZE) {
+      const uint8_t* locator = eocd - IREE_NUMPY_ZIP64_EOCD_LOCATOR_SIZE;
+      if (iree_numpy_zip_read_u32(locator) ==
+          IREE_NUMPY_ZIP64_EOCD_LOCATOR_SIGNATURE) {
+        uint8_t eocd64[IREE_NUMPY_ZIP64_EOCD_SIZE];
+        status = iree_numpy_zip_read_at(stream,
+                                        iree_numpy_zip_read_u64(locator + 8),
+                                        sizeof(eocd64), eocd64);
+        if (iree_status_is_ok(status) && iree_numpy_zip_read_u32(eocd64) !=
+                                             IREE_NUMPY_ZIP64_EOCD_SIGNATURE) {
+          status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                    "npz zip64 end of central directory "
+                                    "signature mismatch");
+        }
+        if (iree_status_is_ok(status)) {
+          *out_entry_count = iree_numpy_zip_read_u64(eocd64 + 32);
+          *out_size = iree_numpy_zip_read_u64(eocd64 + 40);
+          *out_offset = iree_numpy_zip_read_u64(eocd64 + 48);
+        }
+      }
+    }
+  }
+
+  if (iree_status_is_ok(status) &&
+      (*out_offset > stream_length ||
+       *out_size > stream_length - *out_offset)) {
+    status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "npz central directory out of bounds");
+  }
+
+  iree_allocator_free(host_allocator, tail);
+  return status;
+}
+
+// Parses the zip64 extended information |extra| field of a central directory
+// header and replaces any values that overflowed the 32-bit header fields.
+static iree_status_t iree_numpy_zip_parse_zip64_extra(
+    iree_const_byte_span_t extra, uint32_t uncompressed_size_u32,
+    iree_numpy_npz_member_t* member) {
+  while (extra.data_length >= 4) {
+    uint16_t field_id = iree_numpy_zip_read_u16(extra.data + 0);
+    uint16_t field_size = iree_numpy_zip_read_u16(extra.data + 2);
+    if (field_size > extra.data_length - 4) break;
+    if (field_id == IREE_NUMPY_ZIP64_EXTRA_FIELD_ID) {
+      // Fields are present only if the corresponding header field is all 1s
+      // and in the fixed order: uncompressed, compressed, offset.
+      const uint8_t* p = extra.data + 4;
+      const uint8_t* end = p + field_size;
+      if (uncompressed_size_u32 == UINT32_MAX) p += 8;
+      if (member->compressed_size == UINT32_MAX && p + 8 <= end) {
+        member->compressed_size = iree_numpy_zip_read_u64(p);
+        p += 8;
+      }
+      if (member->local_header_offset == UINT32_MAX && p + 8 <= end) {
+        member->local_header_offset = iree_numpy_zip_read_u64(p);
+        p += 8;
+      }
+      if (p > end) {
+        return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "npz zip64 extra field truncated");
+      }
+      return iree_ok_status();
+    }
+    extra.data += 4 + field_size;
+    extra.data_length -= 4 + field_size;
+  }
+  return iree_ok_status();
+}
+
+// Parses all |entry_count| members from the |central_directory| of
+// |central_directory_size| bytes into |members|.
+static iree_status_t iree_numpy_zip_parse_central_directory(
+    const uint8_t* central_directory, iree_host_size_t central_directory_size,
+    iree_host_size_t entry_count, iree_numpy_npz_member_t* members) {
+  const uint8_t* p = central_directory;
+  const uint8_t* end = central_directory + central_directory_size;
+  for (iree_host_size_t i = 0; i < entry_count; ++i) {
+    if (end - p < IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_HEADER_SIZE ||
+        iree_numpy_zip_read_u32(p) !=
+            IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_SIGNATURE) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "npz central directory entry %" PRIhsz
+                              " malformed",
+                              i);
+    }
+    uint16_t name_length = iree_numpy_zip_read_u16(p + 28);
+    uint16_t extra_length = iree_numpy_zip_read_u16(p + 30);
+    uint16_t comment_length = iree_numpy_zip_read_u16(p + 32);
+    iree_host_size_t entry_size = IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_HEADER_SIZE +
+                                  name_length + extra_length + comment_length;
+    if ((iree_host_size_t)(end - p) < entry_size) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "npz central directory entry %" PRIhsz
+                              " truncated",
+                              i);
+    }
+
+    iree_numpy_npz_member_t* member = &members[i];
+    member->method = iree_numpy_zip_read_u16(p + 10);
+    member->compressed_size = iree_numpy_zip_read_u32(p + 20);
+    member->local_header_offset = iree_numpy_zip_read_u32(p + 42);
+    IREE_RETURN_IF_ERROR(iree_numpy_zip_parse_zip64_extra(
+        iree_make_const_byte_span(
+            p + IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_HEADER_SIZE + name_length,
+            extra_length),
+        iree_numpy_zip_read_u32(p + 24), member));
+
+    // numpy.savez stores `name=array` as `name.npy`; we strip the suffix so
+    // that callers can use the same names as in python.
+    member->name = iree_make_string_view(
+        (const char*)p + IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_HEADER_SIZE,
+        name_length);
+    iree_string_view_consume_suffix(&member->name, IREE_SV(".npy"));
+
+    p += entry_size;
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_npz_archive_open(
+    iree_io_stream_t* stream, iree_allocator_t host_allocator,
+    iree_numpy_npz_archive_t** out_archive) {
+  IREE_ASSERT_ARGUMENT(stream);
+  IREE_ASSERT_ARGUMENT(out_archive);
+  *out_archive = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  if (!iree_all_bits_set(iree_io_stream_mode(stream),
+                         IREE_IO_STREAM_MODE_READABLE |
+                             IREE_IO_STREAM_MODE_SEEKABLE)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npz archives require readable and seekable "
+                            "streams");
+  }
+
+  uint64_t entry_count = 0;
+  uint64_t central_directory_offset = 0;
+  uint64_t central_directory_size = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_numpy_zip_find_central_directory(
+              stream, host_allocator, &entry_count, &central_directory_offset,
+              &central_directory_size));
+  IREE_TRACE_ZONE_APPEND_VALUE_I64(z0, (int64_t)entry_count);
+
+  // Each entry has at least a fixed-size header so this bounds the count to
+  // something sensible before we allocate anything. The member table is
+  // smaller than the directory so this also bounds the allocation size.
+  if (entry_count >
+      central_directory_size / IREE_NUMPY_ZIP_CENTRAL_DIRECTORY_HEADER_SIZE) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npz central directory entry count %" PRIu64
+                            " exceeds directory size",
+                            entry_count);
+  }
+
+  if (central_directory_size > IREE_HOST_SIZE_MAX / 4) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_RESOURCE_EXHAUSTED,
+                            "npz central directory of %" PRIu64
+                            " bytes too large",
+                            central_directory_size);
+  }
+
+  // Allocate the archive with the member table and directory storage inline.
+  iree_numpy_npz_archive_t* archive = NULL;
+  iree_host_size_t total_size =
+      sizeof(*archive) +
+      (iree_host_size_t)entry_count * sizeof(iree_numpy_npz_member_t) +
+      (iree_host_size_t)central_directory_size;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, total_size, (void**)&archive));
+  archive->host_allocator = host_allocator;
+  archive->stream = stream;
+  iree_io_stream_retain(stream);
+  archive->member_count = (iree_host_size_t)entry_count;
+  archive->members =
+      (iree_numpy_npz_member_t*)((uint8_t*)archive + sizeof(*archive));
+  archive->central_directory =
+      (uint8_t*)(archive->members + archive->member_count);
+
+  iree_status_t status = iree_numpy_zip_read_at(
+      stream, central_directory_offset,
+      (iree_host_size_t)central_directory_size, archive->central_directory);
+  if (iree_status_is_ok(status)) {
+    status = iree_numpy_zip_parse_central_directory(
+        archive->central_directory, (iree_host_size_t)central_directory_size,
+        archive->member_count, archive->members);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_archive = archive;
+  } else {
+    iree_numpy_npz_archive_free(archive);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT void iree_numpy_npz_archive_free(
+    iree_numpy_npz_archive_t* archive) {
+  if (!archive) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_io_stream_release(archive->stream);
+  iree_allocator_free(archive->host_allocator, archive);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT iree_host_size_t
+iree_numpy_npz_archive_member_count(const iree_numpy_npz_archive_t* archive) {
+  IREE_ASSERT_ARGUMENT(archive);
+  return archive->member_count;
+}
+
+IREE_API_EXPORT iree_string_view_t iree_numpy_npz_archive_member_name(
+    const iree_numpy_npz_archive_t* archive, iree_host_size_t index) {
+  IREE_ASSERT_ARGUMENT(archive);
+  if (index >= archive->member_count) return iree_string_view_empty();
+  return archive->members[index].name;
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_npz_archive_find_member(
+    const iree_numpy_npz_archive_t* archive, iree_string_view_t name,
+    iree_host_size_t* out_index) {
+  IREE_ASSERT_ARGUMENT(archive);
+  IREE_ASSERT_ARGUMENT(out_index);
+  *out_index = IREE_HOST_SIZE_MAX;
+  iree_string_view_consume_suffix(&name, IREE_SV(".npy"));
+  for (iree_host_size_t i = 0; i < archive->member_count; ++i) {
+    if (iree_string_view_equal(archive->members[i].name, name)) {
+      *out_index = i;
+      return iree_ok_status();
+    }
+  }
+  return iree_make_status(IREE_STATUS_NOT_FOUND,
+                          "npz member `%.*s` not found", (int)name.size,
+                          name.data);
+}
+
+IREE_API_EXPORT iree_status_t iree_numpy_npz_archive_load_ndarray(
+    iree_numpy_npz_archive_t* archive, iree_host_size_t index,
+    iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view) {
+  IREE_ASSERT_ARGUMENT(archive);
+  IREE_ASSERT_ARGUMENT(out_buffer_view);
+  *out_buffer_view = NULL;
+  if (index >= archive->member_count) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "npz member index %" PRIhsz
+                            " out of range (%" PRIhsz " members)",
+                            index, archive->member_count);
+  }
+  const iree_numpy_npz_member_t* member = &archive->members[index];
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, member->name.data, member->name.size);
+
+  if (member->method != IREE_NUMPY_ZIP_METHOD_STORED) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(
+        IREE_STATUS_UNIMPLEMENTED,
+        "npz member `%.*s` is compressed (method %u); only uncompressed "
+        "archives (`numpy.savez`) are supported",
+        (int)member->name.size, member->name.data, member->method);
+  }
+
+  // The local header repeats the name but may have a different extra field
+  // than the central directory so we have to read it to find the data.
+  uint8_t local_header[IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE];
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_numpy_zip_read_at(archive->stream, member->local_header_offset,
+                                 sizeof(local_header), local_header));
+  if (iree_numpy_zip_read_u32(local_header) !=
+      IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIGNATURE) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "npz member `%.*s` local header signature mismatch",
+                            (int)member->name.size, member->name.data);
+  }
+  uint64_t data_offset = member->local_header_offset +
+                         IREE_NUMPY_ZIP_LOCAL_FILE_HEADER_SIZE +
+                         iree_numpy_zip_read_u16(local_header + 26) +
+                         iree_numpy_zip_read_u16(local_header + 28);
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_io_stream_seek(archive->stream, IREE_IO_STREAM_SEEK_SET,
+                              data_offset));
+
+  // The member is a complete .npy file.
+  iree_status_t status = iree_numpy_npy_load_ndarray(
+      archive->stream, options, buffer_params, device, device_allocator,
+      out_buffer_view);
+  if (iree_status_is_ok(status) &&
+      (uint64_t)iree_io_stream_offset(archive->stream) - data_offset >
+          member->compressed_size) {
+    iree_hal_buffer_view_release(*out_buffer_view);
+    *out_buffer_view = NULL;
+    status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "npz member `%.*s` ndarray extends past the end "
+                              "of the member",
+                              (int)member->name.size, member->name.data);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
@@ -55,8 +55,10 @@ enum iree_numpy_npy_load_options_bits_t {
   // Tries to map the file into memory and use the contents directly from the
   // file system. Only available if the HAL device supports accessing mapped
   // data.
-  // Like providing `mmap_mode` to `numpy.load`.
-  // May be ignored if the implementation does not support mapping.
+  // Like providing `mmap_mode='r'` to `numpy.load`.
+  // Ignored (falling back to a copy) if the stream is not mappable, the
+  // requested buffer is writable, the contents are not sufficiently aligned,
+  // or the device allocator cannot import host memory.
   IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE = 1u << 0,
 };
 typedef uint32_t iree_numpy_npy_load_options_t;
@@ -71,9 +73,11 @@ typedef uint32_t iree_numpy_npy_save_options_t;
 // On success |out_buffer_view| will have a buffer view matching the parameters
 // in the npy file allocated from the given |device_allocator|.
 //
-// If IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE is set and the
-// |device_allocator| supports mapping then the file will be mapped into the
-// host process. Otherwise the file will be loaded into a new allocation.
+// If IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE is set, |stream| has
+// IREE_IO_STREAM_MODE_MAPPABLE, and the |device_allocator| supports importing
+// host memory then the stream contents will be used in-place and the returned
+// buffer will retain |stream|. Otherwise the contents will be loaded into a
+// new allocation.
 //
 // Upon return the |stream| will be positioned immediately following the
 // ndarray contents, which may be end-of-stream.
@@ -97,6 +101,54 @@ IREE_API_EXPORT iree_status_t iree_numpy_npy_save_ndarray(
     iree_io_stream_t* stream, iree_numpy_npy_save_options_t options,
     iree_hal_buffer_view_t* buffer_view, iree_allocator_t host_allocator);
 
+//===----------------------------------------------------------------------===//
+// .npz (zip archive of .npy files)
+//===----------------------------------------------------------------------===//
+
+// An .npz archive with its member directory indexed.
+// Members are only read when loaded and may be loaded in any order.
+typedef struct iree_numpy_npz_archive_t iree_numpy_npz_archive_t;
+
+// Opens an .npz archive from |stream| by reading its zip central directory.
+// The stream must be readable and seekable and will be retained by the archive
+// until it is freed. Member contents are not read until loaded.
+//
+// See `numpy.savez`:
+// https://numpy.org/doc/stable/reference/generated/numpy.savez.html
+IREE_API_EXPORT iree_status_t iree_numpy_npz_archive_open(
+    iree_io_stream_t* stream, iree_allocator_t host_allocator,
+    iree_numpy_npz_archive_t** out_archive);
+
+// Frees |archive| and releases its stream.
+IREE_API_EXPORT void iree_numpy_npz_archive_free(
+    iree_numpy_npz_archive_t* archive);
+
+// Returns the total number of members in |archive|.
+IREE_API_EXPORT iree_host_size_t
+iree_numpy_npz_archive_member_count(const iree_numpy_npz_archive_t* archive);
+
+// Returns the name of the member at |index| with the `.npy` suffix removed
+// (matching the keyword used with `numpy.savez`). The name is valid for the
+// lifetime of |archive|.
+IREE_API_EXPORT iree_string_view_t iree_numpy_npz_archive_member_name(
+    const iree_numpy_npz_archive_t* archive, iree_host_size_t index);
+
+// Finds the index of the member with the given |name| (with or without the
+// `.npy` suffix). Returns IREE_STATUS_NOT_FOUND if no member matches.
+IREE_API_EXPORT iree_status_t iree_numpy_npz_archive_find_member(
+    const iree_numpy_npz_archive_t* archive, iree_string_view_t name,
+    iree_host_size_t* out_index);
+
+// Loads the member at |index| of |archive| into a buffer view as with
+// iree_numpy_npy_load_ndarray. Compressed members (`numpy.savez_compressed`)
+// are not supported.
+IREE_API_EXPORT iree_status_t iree_numpy_npz_archive_load_ndarray(
+    iree_numpy_npz_archive_t* archive, iree_host_size_t index,
+    iree_numpy_npy_load_options_t options,
+    iree_hal_buffer_params_t buffer_params, iree_hal_device_t* device,
+    iree_hal_allocator_t* device_allocator,
+    iree_hal_buffer_view_t** out_buffer_view);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -40,13 +40,24 @@ class NumpyIOTest : public ::testing::Test {
 
   virtual void TearDown() { iree_hal_device_release(device_); }
 
-  StreamPtr OpenInputFile(const char* name) {
+  static iree_const_byte_span_t GetInputFileContents(const char* name) {
+    const struct iree_file_toc_t* file_toc = iree_numpy_npy_files_create();
+    for (size_t i = 0; i < iree_numpy_npy_files_size(); ++i) {
+      if (strcmp(file_toc[i].name, name) != 0) continue;
+      return iree_make_const_byte_span(file_toc[i].data, file_toc[i].size);
+    }
+    return iree_const_byte_span_empty();
+  }
+
+  StreamPtr OpenInputFile(const char* name,
+                          iree_io_stream_mode_t extra_mode = 0) {
     const struct iree_file_toc_t* file_toc = iree_numpy_npy_files_create();
     for (size_t i = 0; i < iree_numpy_npy_files_size(); ++i) {
       if (strcmp(file_toc[i].name, name) != 0) continue;
       iree_io_stream_t* stream = NULL;
       IREE_CHECK_OK(iree_io_memory_stream_wrap(
-          IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_SEEKABLE,
+          IREE_IO_STREAM_MODE_READABLE | IREE_IO_STREAM_MODE_SEEKABLE |
+              extra_mode,
           iree_make_byte_span((void*)file_toc[i].data, file_toc[i].size),
           iree_io_memory_stream_release_callback_null(),
           iree_allocator_system(), &stream));
@@ -318,6 +329,155 @@ TEST_F(NumpyIOTest, ArrayTypes) {
   ASSERT_TRUE(iree_io_stream_is_eos(stream.get()));
 }
 
+// Tests that mapped arrays alias the stream contents instead of copying.
+TEST_F(NumpyIOTest, LoadMappedArray) {
+  auto stream = OpenInputFile("single.npy", IREE_IO_STREAM_MODE_MAPPABLE);
+  iree_const_byte_span_t file_contents = GetInputFileContents("single.npy");
+
+  iree_hal_buffer_params_t buffer_params = {};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_numpy_npy_load_ndarray(
+      stream.get(), IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params,
+      device_, device_allocator_, &buffer_view));
+
+  // np.array([1.1, 2.2, 3.3], dtype=np.float32)
+  AssertBufferViewContents<float>(buffer_view, {3},
+                                  IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+                                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                  {1.1f, 2.2f, 3.3f});
+
+  // The buffer should reference the payload at the end of the file.
+  iree_hal_buffer_mapping_t mapping;
+  IREE_ASSERT_OK(iree_hal_buffer_map_range(
+      iree_hal_buffer_view_buffer(buffer_view),
+      IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+      IREE_WHOLE_BUFFER, &mapping));
+  EXPECT_EQ(mapping.contents.data, file_contents.data +
+                                       file_contents.data_length -
+                                       3 * sizeof(float));
+  IREE_ASSERT_OK(iree_hal_buffer_unmap_range(&mapping));
+
+  // Should have hit EOF.
+  ASSERT_TRUE(iree_io_stream_is_eos(stream.get()));
+
+  // The buffer retains the stream so it must remain valid after release.
+  stream.reset();
+  AssertBufferViewContents<float>(buffer_view, {3},
+                                  IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+                                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                  {1.1f, 2.2f, 3.3f});
+  iree_hal_buffer_view_release(buffer_view);
+}
+
+// Tests that writable buffers are copied even when mapping is requested.
+TEST_F(NumpyIOTest, LoadMappedArrayWritable) {
+  auto stream = OpenInputFile("single.npy", IREE_IO_STREAM_MODE_MAPPABLE);
+  iree_const_byte_span_t file_contents = GetInputFileContents("single.npy");
+
+  iree_hal_buffer_params_t buffer_params = {};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_ALL;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_numpy_npy_load_ndarray(
+      stream.get(), IREE_NUMPY_NPY_LOAD_OPTION_MAP_FILE, buffer_params,
+      device_, device_allocator_, &buffer_view));
+
+  iree_hal_buffer_mapping_t mapping;
+  IREE_ASSERT_OK(iree_hal_buffer_map_range(
+      iree_hal_buffer_view_buffer(buffer_view),
+      IREE_HAL_MAPPING_MODE_SCOPED, IREE_HAL_MEMORY_ACCESS_READ, 0,
+      IREE_WHOLE_BUFFER, &mapping));
+  EXPECT_NE(mapping.contents.data, file_contents.data +
+                                       file_contents.data_length -
+                                       3 * sizeof(float));
+  IREE_ASSERT_OK(iree_hal_buffer_unmap_range(&mapping));
+  AssertBufferViewContents<float>(buffer_view, {3},
+                                  IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+                                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                  {1.1f, 2.2f, 3.3f});
+  iree_hal_buffer_view_release(buffer_view);
+
+  ASSERT_TRUE(iree_io_stream_is_eos(stream.get()));
+}
+
+// Tests loading members from an npz archive by index and by name.
+TEST_F(NumpyIOTest, LoadArchiveMembers) {
+  auto stream = OpenInputFile("arrays.npz");
+  iree_numpy_npz_archive_t* archive = NULL;
+  IREE_ASSERT_OK(
+      iree_numpy_npz_archive_open(stream.get(), iree_allocator_system(),
+                                  &archive));
+
+  ASSERT_EQ(iree_numpy_npz_archive_member_count(archive), 3);
+  EXPECT_TRUE(iree_string_view_equal(
+      iree_numpy_npz_archive_member_name(archive, 0), IREE_SV("a")));
+  EXPECT_TRUE(iree_string_view_equal(
+      iree_numpy_npz_archive_member_name(archive, 1), IREE_SV("b")));
+  EXPECT_TRUE(iree_string_view_equal(
+      iree_numpy_npz_archive_member_name(archive, 2), IREE_SV("c")));
+
+  iree_host_size_t index = 0;
+  IREE_ASSERT_OK(
+      iree_numpy_npz_archive_find_member(archive, IREE_SV("b.npy"), &index));
+  EXPECT_EQ(index, 1);
+  EXPECT_THAT(Status(iree_numpy_npz_archive_find_member(
+                  archive, IREE_SV("missing"), &index)),
+              StatusIs(StatusCode::kNotFound));
+
+  iree_hal_buffer_params_t buffer_params = {};
+  buffer_params.usage = IREE_HAL_BUFFER_USAGE_TRANSFER;
+  buffer_params.access = IREE_HAL_MEMORY_ACCESS_READ;
+  buffer_params.type = IREE_HAL_MEMORY_TYPE_HOST_LOCAL;
+
+  // Members can be loaded out of order.
+  // np.array([[0, 1], [2, 3]], dtype=np.int32)
+  iree_hal_buffer_view_t* buffer_view = NULL;
+  IREE_ASSERT_OK(iree_numpy_npz_archive_load_ndarray(
+      archive, 1, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params, device_,
+      device_allocator_, &buffer_view));
+  AssertBufferViewContents<int32_t>(buffer_view, {2, 2},
+                                    IREE_HAL_ELEMENT_TYPE_SINT_32,
+                                    IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                    {0, 1, 2, 3});
+  iree_hal_buffer_view_release(buffer_view);
+
+  // np.array([1.1, 2.2, 3.3], dtype=np.float32)
+  IREE_ASSERT_OK(iree_numpy_npz_archive_load_ndarray(
+      archive, 0, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params, device_,
+      device_allocator_, &buffer_view));
+  AssertBufferViewContents<float>(buffer_view, {3},
+                                  IREE_HAL_ELEMENT_TYPE_FLOAT_32,
+                                  IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                  {1.1f, 2.2f, 3.3f});
+  iree_hal_buffer_view_release(buffer_view);
+
+  // np.array(42, dtype=np.int32)
+  IREE_ASSERT_OK(iree_numpy_npz_archive_load_ndarray(
+      archive, 2, IREE_NUMPY_NPY_LOAD_OPTION_DEFAULT, buffer_params, device_,
+      device_allocator_, &buffer_view));
+  AssertBufferViewContents<int32_t>(buffer_view, {},
+                                    IREE_HAL_ELEMENT_TYPE_SINT_32,
+                                    IREE_HAL_ENCODING_TYPE_DENSE_ROW_MAJOR,
+                                    {42});
+  iree_hal_buffer_view_release(buffer_view);
+
+  iree_numpy_npz_archive_free(archive);
+}
+
+// Tests that files that are not zip archives fail to open as npz.
+TEST_F(NumpyIOTest, OpenArchiveInvalid) {
+  auto stream = OpenInputFile("single.npy");
+  iree_numpy_npz_archive_t* archive = NULL;
+  EXPECT_THAT(Status(iree_numpy_npz_archive_open(
+                  stream.get(), iree_allocator_system(), &archive)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(archive, nullptr);
+}
+
 static void RoundTripArrays(iree_io_stream_t* source_stream,
                             iree_io_stream_t* target_stream,
                             iree_hal_device_t* device,
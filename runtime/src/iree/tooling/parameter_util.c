@@ -8,11 +8,14 @@
 
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
+#include "iree/base/internal/path.h"
 #include "iree/io/formats/parser_registry.h"
+#include "iree/io/parameter_converter.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/parameter_index_provider.h"
 #include "iree/io/scope_map.h"
 #include "iree/modules/io/parameters/module.h"
+#include "iree/task/api.h"
 
 //===----------------------------------------------------------------------===//
 // Parameter file I/O
@@ -91,13 +94,132 @@ IREE_FLAG_LIST(
     "Supported formats:\n"
     "- .irpa (IREE parameter archive)\n"
     "- .gguf (https://github.com/ggerganov/ggml/blob/master/docs/gguf.md)\n"
-    "- .safetensors (https://github.com/huggingface/safetensors)");
+    "- .safetensors (https://github.com/huggingface/safetensors)\n"
+    "- .shards (text manifest listing one parameter file per line)");
+
+IREE_FLAG(
+    int32_t, parameter_index_threads, 0,
+    "Maximum number of threads used to index the files listed in .shards\n"
+    "manifests. 0 selects a default.");
+
+IREE_FLAG(
+    bool, parameter_lazy, false,
+    "Loads parameters lazily: parameters that cannot be used in-place are\n"
+    "read when a dispatch first binds them instead of on startup. Only\n"
+    "supported with local CPU devices.");
+
+IREE_FLAG(
+    int64_t, parameter_lazy_budget, 0,
+    "Soft limit in bytes on the lazily loaded parameters kept resident when\n"
+    "--parameter_lazy is set. Least recently used parameters are evicted and\n"
+    "re-read on their next use when over budget. 0 is unlimited.");
+
+IREE_FLAG(
+    bool, parameter_alias_host_memory, false,
+    "Allows parameters in memory-mapped files to be used in-place on devices\n"
+    "that can only access host memory over the host interconnect (such as\n"
+    "CUDA and HIP) instead of copying them into device memory.");
+
+IREE_FLAG_LIST(
+    string, parameter_transform,
+    "Converts parameters as they are loaded. Each rule is specified as\n"
+    "`pattern=op[,op...]` and the first rule matching a parameter key\n"
+    "applies. Operations:\n"
+    "  f32/f16/bf16: converts (dequantizing if needed) element values.\n"
+    "  pack:<rows>x<cols>: packs matrices into tiles of the given size.\n"
+    "  transpose_inner/transpose_outer: transposes the packed layout.\n"
+    "Only parameters from .gguf files carry the type information required.\n"
+    "Example: `--parameter_transform=blk.*.weight=f16,pack:16x1`");
+
+// Creates a parameter transform from the --parameter_transform flags.
+// Returns NULL in |out_transform| if no transform was specified.
+static iree_status_t iree_tooling_create_parameter_transform_from_flags(
+    iree_allocator_t host_allocator,
+    iree_io_parameter_transform_t** out_transform) {
+  *out_transform = NULL;
+  const iree_host_size_t rule_count = FLAG_parameter_transform_list().count;
+  if (rule_count == 0) return iree_ok_status();
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_io_parameter_conversion_rule_t* rules =
+      (iree_io_parameter_conversion_rule_t*)iree_alloca(rule_count *
+                                                        sizeof(*rules));
+  for (iree_host_size_t i = 0; i < rule_count; ++i) {
+    IREE_RETURN_AND_END_ZONE_IF_ERROR(
+        z0, iree_io_parameter_conversion_rule_parse(
+                FLAG_parameter_transform_list().values[i], &rules[i]));
+  }
+
+  // Conversions are distributed across an executor configured by the same
+  // flags as the local-task HAL driver. Only the first executor is used when
+  // the topology spans multiple NUMA nodes.
+  iree_task_executor_t* executors[16] = {NULL};
+  iree_host_size_t executor_count = 0;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_task_executors_create_from_flags(
+              host_allocator, IREE_ARRAYSIZE(executors), executors,
+              &executor_count));
+  iree_status_t status = iree_io_parameter_converter_create(
+      executor_count > 0 ? executors[0] : NULL, rule_count, rules,
+      host_allocator, out_transform);
+  for (iree_host_size_t i = 0; i < executor_count; ++i) {
+    iree_task_executor_release(executors[i]);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static iree_status_t iree_io_open_parameter_file_callback(
+    void* user_data, iree_string_view_t path,
+    iree_io_file_handle_t** out_file_handle) {
+  iree_allocator_t host_allocator = *(iree_allocator_t*)user_data;
+  return iree_io_open_parameter_file(path, host_allocator, out_file_handle);
+}
+
+// Appends the parameter files listed in the shard manifest at |path| to
+// |index|. Shards are indexed in parallel.
+static iree_status_t iree_io_append_parameter_manifest_to_index(
+    iree_string_view_t path, iree_io_parameter_index_t* index,
+    iree_allocator_t host_allocator) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  char path_str[2048] = {0};
+  iree_string_view_to_cstring(path, path_str, sizeof(path_str));
+  iree_file_contents_t* manifest_contents = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_file_read_contents(path_str, IREE_FILE_READ_FLAG_DEFAULT,
+                                  host_allocator, &manifest_contents));
+
+  iree_io_parameter_file_open_callback_t file_open = {
+      .fn = iree_io_open_parameter_file_callback,
+      .user_data = &host_allocator,
+  };
+  iree_status_t status = iree_io_parse_manifest_index(
+      path,
+      iree_make_string_view((const char*)manifest_contents->const_buffer.data,
+                            manifest_contents->const_buffer.data_length),
+      file_open, (iree_host_size_t)iree_max(0, FLAG_parameter_index_threads),
+      index, host_allocator);
+
+  iree_file_contents_free(manifest_contents);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
 
 // Appends the parameter file located at |path| to |index|.
 static iree_status_t iree_io_append_parameter_file_to_index(
     iree_string_view_t path, iree_io_parameter_index_t* index,
     iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(index);
+
+  // Manifests reference other files instead of containing parameters.
+  if (iree_string_view_equal_case(iree_file_path_extension(path),
+                                  IREE_SV("shards"))) {
+    return iree_io_append_parameter_manifest_to_index(path, index,
+                                                      host_allocator);
+  }
+
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Open the file.
@@ -163,12 +285,28 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
   iree_io_parameter_provider_t** providers =
       (iree_io_parameter_provider_t**)iree_alloca(
           scope_map.count * sizeof(iree_io_parameter_provider_t*));
+  iree_io_parameter_index_provider_options_t provider_options;
+  iree_io_parameter_index_provider_options_initialize(&provider_options);
+  if (FLAG_parameter_alias_host_memory) {
+    provider_options.flags |=
+        IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_ALIAS_HOST_MEMORY;
+  }
+  if (FLAG_parameter_lazy) {
+    provider_options.flags |= IREE_IO_PARAMETER_INDEX_PROVIDER_FLAG_LAZY;
+    provider_options.lazy_residency_budget =
+        (iree_device_size_t)iree_max(0, FLAG_parameter_lazy_budget);
+  }
+  iree_io_parameter_transform_t* transform = NULL;
+  if (iree_status_is_ok(status)) {
+    status = iree_tooling_create_parameter_transform_from_flags(host_allocator,
+                                                                &transform);
+    provider_options.transform = transform;
+  }
   if (iree_status_is_ok(status)) {
     for (iree_host_size_t i = 0; i < scope_map.count; ++i) {
-      status = iree_io_parameter_index_provider_create(
+      status = iree_io_parameter_index_provider_create_with_options(
           scope_map.entries[i]->scope, scope_map.entries[i]->index,
-          IREE_IO_PARAMETER_INDEX_PROVIDER_DEFAULT_MAX_CONCURRENT_OPERATIONS,
-          host_allocator, &providers[i]);
+          &provider_options, host_allocator, &providers[i]);
       if (!iree_status_is_ok(status)) break;
       ++provider_count;
     }
@@ -184,6 +322,7 @@ iree_status_t iree_tooling_create_parameters_module_from_flags(
   for (iree_host_size_t i = 0; i < provider_count; ++i) {
     iree_io_parameter_provider_release(providers[i]);
   }
+  iree_io_parameter_transform_release(transform);
   iree_io_scope_map_deinitialize(&scope_map);
 
   IREE_TRACE_ZONE_END(z0);
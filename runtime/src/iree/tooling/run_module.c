@@ -17,6 +17,7 @@
 #include "iree/tooling/function_io.h"
 #include "iree/tooling/function_util.h"
 #include "iree/tooling/instrument_util.h"
+#include "iree/tooling/vm_profiler_util.h"
 #include "iree/vm/api.h"
 #include "iree/vm/bytecode/module.h"
 
@@ -246,6 +247,11 @@ static iree_status_t iree_tooling_run_function(
     status = iree_status_annotate_f(iree_hal_begin_profiling_from_flags(device),
                                     "beginning device profiling");
   }
+  if (iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(
+        iree_tooling_begin_vm_profiling_from_flags(host_allocator),
+        "beginning VM profiling");
+  }
 
   // Invoke the function with the provided inputs.
   if (iree_status_is_ok(status)) {
@@ -266,6 +272,10 @@ static iree_status_t iree_tooling_run_function(
   iree_hal_fence_release(finish_fence);
 
   // End profiling after waiting for the invocation to finish.
+  if (iree_status_is_ok(status)) {
+    status = iree_status_annotate_f(iree_tooling_end_vm_profiling_from_flags(),
+                                    "ending VM profiling");
+  }
   if (iree_status_is_ok(status)) {
     status = iree_status_annotate_f(iree_hal_end_profiling_from_flags(device),
                                     "ending device profiling");
@@ -46,3 +46,12 @@ with open("array_types.npy", "wb") as f:
     np.save(f, np.array([-1.1, 1.1], dtype=np.float64))
     np.save(f, np.array([1 + 5j, 2 + 6j], dtype=np.complex64))
     np.save(f, np.array([1 + 5j, 2 + 6j], dtype=np.complex128))
+
+# uncompressed archive of named arrays
+with open("arrays.npz", "wb") as f:
+    np.savez(
+        f,
+        a=np.array([1.1, 2.2, 3.3], dtype=np.float32),
+        b=np.array([[0, 1], [2, 3]], dtype=np.int32),
+        c=np.array(42, dtype=np.int32),
+    )
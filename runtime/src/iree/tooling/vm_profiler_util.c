@@ -0,0 +1,103 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/tooling/vm_profiler_util.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "iree/base/internal/flags.h"
+#include "iree/vm/api.h"
+
+//===----------------------------------------------------------------------===//
+// VM sampling profiler management
+//===----------------------------------------------------------------------===//
+
+IREE_FLAG(string, vm_profile_file, "",
+          "File to write a folded stack profile of sampled VM execution to.\n"
+          "The output can be viewed with flame graph tools such as\n"
+          "flamegraph.pl or speedscope.");
+IREE_FLAG(int32_t, vm_profile_interval_us, 10000,
+          "Interval in microseconds between VM execution samples.");
+IREE_FLAG(bool, vm_profile_source_locations, false,
+          "Includes source locations in sampled VM stack frames when debug\n"
+          "information is available.");
+
+// Profiler active between begin/end calls.
+static iree_vm_sampling_profiler_t* iree_tooling_vm_profiler = NULL;
+
+iree_status_t iree_tooling_begin_vm_profiling_from_flags(
+    iree_allocator_t host_allocator) {
+  if (strlen(FLAG_vm_profile_file) == 0) return iree_ok_status();
+  if (iree_tooling_vm_profiler) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "VM profiling already begun");
+  }
+  if (FLAG_vm_profile_interval_us <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "--vm_profile_interval_us must be positive");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_sampling_profiler_flags_t flags =
+      FLAG_vm_profile_source_locations
+          ? IREE_VM_SAMPLING_PROFILER_FLAG_SOURCE_LOCATIONS
+          : IREE_VM_SAMPLING_PROFILER_FLAG_NONE;
+  iree_vm_sampling_profiler_t* profiler = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_sampling_profiler_create(
+              (iree_duration_t)FLAG_vm_profile_interval_us * 1000, flags,
+              host_allocator, &profiler));
+  iree_status_t status = iree_vm_sampling_profiler_start(profiler);
+  if (iree_status_is_ok(status)) {
+    iree_tooling_vm_profiler = profiler;
+  } else {
+    iree_vm_sampling_profiler_release(profiler);
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+iree_status_t iree_tooling_end_vm_profiling_from_flags(void) {
+  iree_vm_sampling_profiler_t* profiler = iree_tooling_vm_profiler;
+  if (!profiler) return iree_ok_status();
+  iree_tooling_vm_profiler = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+  IREE_TRACE_ZONE_APPEND_TEXT(z0, FLAG_vm_profile_file);
+
+  iree_vm_sampling_profiler_stop(profiler);
+
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  iree_status_t status =
+      iree_vm_sampling_profiler_format_folded(profiler, &builder);
+  iree_vm_sampling_profiler_release(profiler);
+
+  if (iree_status_is_ok(status)) {
+    FILE* file = fopen(FLAG_vm_profile_file, "wb");
+    if (file) {
+      if (fwrite(iree_string_builder_buffer(&builder), 1,
+                 iree_string_builder_size(&builder),
+                 file) != iree_string_builder_size(&builder)) {
+        status = iree_make_status(iree_status_code_from_errno(errno),
+                                  "failed to write VM profile to '%s'",
+                                  FLAG_vm_profile_file);
+      }
+      fclose(file);
+    } else {
+      status = iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to open VM profile file '%s' for "
+                                "writing",
+                                FLAG_vm_profile_file);
+    }
+  }
+  iree_string_builder_deinitialize(&builder);
+
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
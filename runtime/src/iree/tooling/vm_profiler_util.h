@@ -0,0 +1,35 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#ifndef IREE_TOOLING_VM_PROFILER_UTIL_H_
+#define IREE_TOOLING_VM_PROFILER_UTIL_H_
+
+#include "iree/base/api.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// VM sampling profiler management
+//===----------------------------------------------------------------------===//
+
+// Begins sampling VM execution if the --vm_profile_file flag was specified.
+// No-op if VM profiling is not enabled.
+// Must be matched with a call to iree_tooling_end_vm_profiling_from_flags.
+iree_status_t iree_tooling_begin_vm_profiling_from_flags(
+    iree_allocator_t host_allocator);
+
+// Ends sampling VM execution and writes the folded stack profile to the file
+// specified by the --vm_profile_file flag.
+// No-op if VM profiling is not enabled.
+iree_status_t iree_tooling_end_vm_profiling_from_flags(void);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_TOOLING_VM_PROFILER_UTIL_H_
@@ -1612,6 +1612,65 @@ iree_status_t iree_vm_bytecode_disassemble_op(
       break;
     }
 
+#define DISASM_OP_CORE_CMP_COND_BRANCH_I32(op_name, op_mnemonic)            \
+  DISASM_OP(CORE, op_name) {                                                \
+    uint16_t lhs_reg = VM_ParseOperandRegI32("lhs");                        \
+    uint16_t rhs_reg = VM_ParseOperandRegI32("rhs");                        \
+    int32_t true_block_pc = VM_ParseBranchTarget("true_dest");              \
+    const iree_vm_register_remap_list_t* true_remap_list =                  \
+        VM_ParseBranchOperands("true_operands");                            \
+    int32_t false_block_pc = VM_ParseBranchTarget("false_dest");            \
+    const iree_vm_register_remap_list_t* false_remap_list =                 \
+        VM_ParseBranchOperands("false_operands");                           \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, "%s ", op_mnemonic));          \
+    EMIT_I32_REG_NAME(lhs_reg);                                             \
+    EMIT_OPTIONAL_VALUE_I32(regs->i32[lhs_reg]);                            \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ", "));      \
+    EMIT_I32_REG_NAME(rhs_reg);                                             \
+    EMIT_OPTIONAL_VALUE_I32(regs->i32[rhs_reg]);                            \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, ", ^%08X(", true_block_pc));   \
+    EMIT_REMAP_LIST(true_remap_list);                                       \
+    IREE_RETURN_IF_ERROR(                                                   \
+        iree_string_builder_append_format(b, "), ^%08X(", false_block_pc)); \
+    EMIT_REMAP_LIST(false_remap_list);                                      \
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));       \
+    break;                                                                  \
+  }
+
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpEQI32CondBranch,
+                                       "vm.cmp.eq.i32.cond_br");
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpNEI32CondBranch,
+                                       "vm.cmp.ne.i32.cond_br");
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32SCondBranch,
+                                       "vm.cmp.lt.i32.s.cond_br");
+    DISASM_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32UCondBranch,
+                                       "vm.cmp.lt.i32.u.cond_br");
+
+    DISASM_OP(CORE, CmpNZRefCondBranch) {
+      bool operand_is_move;
+      uint16_t operand_reg = VM_ParseOperandRegRef("operand", &operand_is_move);
+      int32_t true_block_pc = VM_ParseBranchTarget("true_dest");
+      const iree_vm_register_remap_list_t* true_remap_list =
+          VM_ParseBranchOperands("true_operands");
+      int32_t false_block_pc = VM_ParseBranchTarget("false_dest");
+      const iree_vm_register_remap_list_t* false_remap_list =
+          VM_ParseBranchOperands("false_operands");
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_cstring(b, "vm.cmp.nz.ref.cond_br "));
+      EMIT_REF_REG_NAME(operand_reg);
+      EMIT_OPTIONAL_VALUE_REF(&regs->ref[operand_reg]);
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_format(b, ", ^%08X(", true_block_pc));
+      EMIT_REMAP_LIST(true_remap_list);
+      IREE_RETURN_IF_ERROR(
+          iree_string_builder_append_format(b, "), ^%08X(", false_block_pc));
+      EMIT_REMAP_LIST(false_remap_list);
+      IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(b, ")"));
+      break;
+    }
+
     DISASM_OP(CORE, BranchTable) {
       uint16_t index_reg = VM_ParseOperandRegI32("index");
       IREE_RETURN_IF_ERROR(
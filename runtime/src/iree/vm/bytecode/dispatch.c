@@ -14,6 +14,7 @@
 #include "iree/vm/bytecode/disassembler.h"
 #include "iree/vm/bytecode/dispatch_util.h"
 #include "iree/vm/bytecode/module_impl.h"
+#include "iree/vm/bytecode/verifier.h"
 #include "iree/vm/ops.h"
 
 //===----------------------------------------------------------------------===//
@@ -85,11 +86,38 @@ static void iree_vm_bytecode_stack_frame_cleanup(iree_vm_stack_frame_t* frame) {
       (iree_vm_bytecode_frame_storage_t*)iree_vm_stack_frame_storage(frame);
   iree_vm_ref_t* refs = (iree_vm_ref_t*)((uintptr_t)stack_storage +
                                          stack_storage->ref_register_offset);
-  for (uint16_t i = 0; i < stack_storage->ref_register_count; ++i) {
-    iree_vm_ref_t* ref = &refs[i];
-    if (ref->ptr) iree_vm_ref_release(ref);
+  iree_vm_ref_release_range(refs, stack_storage->ref_register_count);
+}
+
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+// Verifies the bytecode of |function_ordinal| if verification was deferred
+// when the module was loaded (IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED). This is a
+// single load of the verified bit after the first call.
+//
+// Multiple threads calling the same function for the first time may each
+// verify it; verification is side-effect free so the race is benign.
+static iree_status_t iree_vm_bytecode_function_ensure_verified(
+    iree_vm_bytecode_module_t* module, uint16_t function_ordinal) {
+  if (IREE_LIKELY(!module->function_verified_bits)) return iree_ok_status();
+  iree_atomic_int32_t* verified_word =
+      &module->function_verified_bits[function_ordinal / 32];
+  const int32_t verified_bit = (int32_t)(1u << (function_ordinal % 32));
+  if (IREE_LIKELY(iree_atomic_load_int32(verified_word,
+                                         iree_memory_order_acquire) &
+                  verified_bit)) {
+    return iree_ok_status();
   }
+  IREE_TRACE_ZONE_BEGIN_NAMED(z0, "iree_vm_bytecode_function_verify");
+  iree_status_t status = iree_vm_bytecode_function_verify(
+      module, function_ordinal, module->allocator);
+  if (iree_status_is_ok(status)) {
+    iree_atomic_fetch_or_int32(verified_word, verified_bit,
+                               iree_memory_order_release);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
 }
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
 
 static iree_status_t iree_vm_bytecode_function_enter(
     iree_vm_stack_t* stack, const iree_vm_function_t function,
@@ -102,6 +130,10 @@ static iree_status_t iree_vm_bytecode_function_enter(
     return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
                             "import ordinal out of range");
   }
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_function_ensure_verified(module, function.ordinal));
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
   const iree_vm_FunctionDescriptor_t* target_descriptor =
       &module->function_descriptor_table[function.ordinal];
 
@@ -440,16 +472,44 @@ static void iree_vm_bytecode_populate_import_cconv_arguments(
   }
 }
 
+// Begins a call to an import provided by a native module by invoking its shim
+// directly. This matches the default native module begin_call behavior but
+// avoids the module routing and function table lookup.
+static iree_status_t iree_vm_bytecode_begin_native_import_call(
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    const iree_vm_function_call_t call) {
+  iree_vm_stack_frame_t* callee_frame = NULL;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_function_enter(
+      stack, &call.function, IREE_VM_STACK_FRAME_NATIVE, /*frame_size=*/0,
+      /*frame_cleanup_fn=*/NULL, &callee_frame));
+  iree_status_t status = import->native_function.shim(
+      stack, IREE_VM_NATIVE_FUNCTION_CALL_BEGIN, call.arguments, call.results,
+      import->native_function.target, import->native_self,
+      callee_frame->module_state);
+  if (iree_status_is_ok(status)) {
+    // Call completed successfully; pop the stack and return to caller.
+    return iree_vm_stack_function_leave(stack);
+  }
+  // Deferred calls preserve the stack and will resume via the module.
+  return status;
+}
+
 // Issues a populated import call and marshals the results into |dst_reg_list|.
 static iree_status_t iree_vm_bytecode_issue_import_call(
-    iree_vm_stack_t* stack, const iree_vm_function_call_t call,
-    iree_string_view_t cconv_results,
+    iree_vm_stack_t* stack, const iree_vm_bytecode_import_t* import,
+    const iree_vm_function_call_t call,
     const iree_vm_register_list_t* IREE_RESTRICT dst_reg_list,
     iree_vm_stack_frame_t* IREE_RESTRICT* out_caller_frame,
     iree_vm_registers_t* out_caller_registers) {
   // Call external function.
-  iree_status_t call_status =
-      call.function.module->begin_call(call.function.module->self, stack, call);
+  iree_status_t call_status = iree_ok_status();
+  if (import->native_function.shim) {
+    call_status =
+        iree_vm_bytecode_begin_native_import_call(stack, import, call);
+  } else {
+    call_status = call.function.module->begin_call(call.function.module->self,
+                                                   stack, call);
+  }
   if (iree_status_is_deferred(call_status)) {
     if (!iree_byte_span_is_empty(call.results)) {
       iree_status_ignore(call_status);
@@ -472,6 +532,7 @@ static iree_status_t iree_vm_bytecode_issue_import_call(
 
   // Marshal outputs from the ABI results buffer to registers.
   iree_vm_registers_t caller_registers = *out_caller_registers;
+  iree_string_view_t cconv_results = import->results;
   uint8_t* IREE_RESTRICT p = call.results.data;
   for (iree_host_size_t i = 0; i < cconv_results.size && i < dst_reg_list->size;
        ++i) {
@@ -565,8 +626,8 @@ static iree_status_t iree_vm_bytecode_call_import(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, import, call, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers);
 }
 
@@ -606,8 +667,8 @@ static iree_status_t iree_vm_bytecode_call_import_variadic(
   call.results.data_length = import->result_buffer_size;
   call.results.data = iree_alloca(call.results.data_length);
   memset(call.results.data, 0, call.results.data_length);
-  return iree_vm_bytecode_issue_import_call(stack, call, import->results,
-                                            dst_reg_list, out_caller_frame,
+  return iree_vm_bytecode_issue_import_call(stack, import, call, dst_reg_list,
+                                            out_caller_frame,
                                             out_caller_registers);
 }
 
@@ -1646,6 +1707,45 @@ static iree_status_t iree_vm_bytecode_dispatch(
       }
     });
 
+    // Fused compare-and-branch superinstructions emitted by the compiler when
+    // a comparison is only used by the immediately following vm.cond_br. The
+    // comparison result is never materialized in a register.
+#define DISPATCH_COND_BRANCH(condition)                                  \
+  int32_t true_block_pc = VM_DecBranchTarget("true_dest");               \
+  const iree_vm_register_remap_list_t* true_remap_list =                 \
+      VM_DecBranchOperands("true_operands");                             \
+  int32_t false_block_pc = VM_DecBranchTarget("false_dest");             \
+  const iree_vm_register_remap_list_t* false_remap_list =                \
+      VM_DecBranchOperands("false_operands");                            \
+  const iree_vm_register_remap_list_t* remap_list =                      \
+      (condition) ? true_remap_list : false_remap_list;                  \
+  pc = ((condition) ? true_block_pc : false_block_pc) +                  \
+       IREE_VM_BLOCK_MARKER_SIZE; /* skip block marker */                \
+  if (IREE_UNLIKELY(remap_list->size > 0)) {                             \
+    iree_vm_bytecode_dispatch_remap_branch_registers(regs_i32, regs_ref, \
+                                                     remap_list);        \
+  }
+
+#define DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(op_name, op_func) \
+  DISPATCH_OP(CORE, op_name, {                                 \
+    int32_t lhs = VM_DecOperandRegI32("lhs");                  \
+    int32_t rhs = VM_DecOperandRegI32("rhs");                  \
+    int32_t condition = op_func(lhs, rhs);                     \
+    DISPATCH_COND_BRANCH(condition);                           \
+  });
+
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpEQI32CondBranch, vm_cmp_eq_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpNEI32CondBranch, vm_cmp_ne_i32);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32SCondBranch, vm_cmp_lt_i32s);
+    DISPATCH_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32UCondBranch, vm_cmp_lt_i32u);
+    DISPATCH_OP(CORE, CmpNZRefCondBranch, {
+      bool operand_is_move;
+      iree_vm_ref_t* operand = VM_DecOperandRegRef("operand", &operand_is_move);
+      int32_t condition = vm_cmp_nz_ref(operand);
+      if (operand_is_move) iree_vm_ref_release(operand);
+      DISPATCH_COND_BRANCH(condition);
+    });
+
     DISPATCH_OP(CORE, BranchTable, {
       int32_t index = VM_DecOperandRegI32("index");
       int32_t default_block_pc = VM_DecBranchTarget("default_dest");
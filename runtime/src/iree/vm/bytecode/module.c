@@ -685,6 +685,38 @@ static void iree_vm_bytecode_module_free_state(
   IREE_TRACE_ZONE_END(z0);
 }
 
+static iree_status_t iree_vm_bytecode_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t allocator, iree_vm_module_state_t** out_module_state) {
+  IREE_ASSERT_ARGUMENT(parent_state);
+  IREE_ASSERT_ARGUMENT(out_module_state);
+  *out_module_state = NULL;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_bytecode_module_state_t* parent =
+      (iree_vm_bytecode_module_state_t*)parent_state;
+  iree_vm_module_state_t* module_state = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_bytecode_module_alloc_state(self, allocator, &module_state));
+  iree_vm_bytecode_module_state_t* state =
+      (iree_vm_bytecode_module_state_t*)module_state;
+
+  // Primitive globals are small and copied so that stores remain local to the
+  // fork. Ref globals are retained such that the referenced objects (large
+  // constant buffers, executables, etc) are shared: storing a new ref into a
+  // global only replaces the reference within the storing context.
+  memcpy(state->rwdata_storage.data, parent->rwdata_storage.data,
+         state->rwdata_storage.data_length);
+  for (iree_host_size_t i = 0; i < state->global_ref_count; ++i) {
+    iree_vm_ref_retain(&parent->global_ref_table[i],
+                       &state->global_ref_table[i]);
+  }
+
+  *out_module_state = module_state;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 static iree_status_t iree_vm_bytecode_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -727,6 +759,12 @@ static iree_status_t iree_vm_bytecode_module_resolve_import(
   import->argument_buffer_size = (uint16_t)argument_buffer_size;
   import->result_buffer_size = (uint16_t)result_buffer_size;
 
+  // Cache the native function pointers when possible so that calls can bypass
+  // the generic module call routing.
+  iree_vm_native_module_query_function_ptr(function->module, function,
+                                           &import->native_function,
+                                           &import->native_self);
+
   return iree_ok_status();
 }
 
@@ -792,6 +830,15 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_vm_instance_t* instance, iree_const_byte_span_t archive_contents,
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module) {
+  return iree_vm_bytecode_module_create_with_flags(
+      instance, IREE_VM_BYTECODE_MODULE_FLAG_NONE, archive_contents,
+      archive_allocator, allocator, out_module);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_vm_instance_t* instance, iree_vm_bytecode_module_flags_t flags,
+    iree_const_byte_span_t archive_contents, iree_allocator_t archive_allocator,
+    iree_allocator_t allocator, iree_vm_module_t** out_module) {
   IREE_TRACE_ZONE_BEGIN(z0);
   IREE_ASSERT_ARGUMENT(out_module);
   *out_module = NULL;
@@ -803,9 +850,19 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
       z0, iree_vm_bytecode_archive_parse_header(
               archive_contents, &flatbuffer_contents, &archive_rodata_offset));
 
+  // Trusted modules skip the full FlatBuffer verification (which walks every
+  // table in the module) and only check what is required to safely index the
+  // tables directly.
+  const bool is_trusted =
+      iree_all_bits_set(flags, IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED);
   IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_vm_bytecode_module_flatbuffer_verify");
-  iree_status_t status = iree_vm_bytecode_module_flatbuffer_verify(
-      archive_contents, flatbuffer_contents, archive_rodata_offset);
+  iree_status_t status =
+      is_trusted ? iree_vm_bytecode_module_flatbuffer_verify_trusted(
+                       archive_contents, flatbuffer_contents,
+                       archive_rodata_offset)
+                 : iree_vm_bytecode_module_flatbuffer_verify(
+                       archive_contents, flatbuffer_contents,
+                       archive_rodata_offset);
   if (!iree_status_is_ok(status)) {
     IREE_TRACE_ZONE_END(z1);
     IREE_TRACE_ZONE_END(z0);
@@ -832,19 +889,39 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   size_t rodata_ref_table_size =
       iree_host_align(rodata_ref_count * sizeof(iree_vm_buffer_t), 16);
 
+  // Trusted modules defer function verification until first call and need to
+  // track which functions have been verified.
+  iree_vm_FunctionDescriptor_vec_t function_descriptors =
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
+  iree_host_size_t function_descriptor_count =
+      iree_vm_FunctionDescriptor_vec_len(function_descriptors);
+  size_t function_verified_bits_size = 0;
+#if IREE_VM_BYTECODE_VERIFICATION_ENABLE
+  if (is_trusted) {
+    function_verified_bits_size = iree_host_align(
+        iree_host_align(function_descriptor_count, 32) / 32 *
+            sizeof(iree_atomic_int32_t),
+        16);
+  }
+#endif  // IREE_VM_BYTECODE_VERIFICATION_ENABLE
+
   iree_vm_bytecode_module_t* module = NULL;
   IREE_RETURN_AND_END_ZONE_IF_ERROR(
-      z0,
-      iree_allocator_malloc(
-          allocator, sizeof(*module) + type_table_size + rodata_ref_table_size,
-          (void**)&module));
+      z0, iree_allocator_malloc(allocator,
+                                sizeof(*module) + type_table_size +
+                                    rodata_ref_table_size +
+                                    function_verified_bits_size,
+                                (void**)&module));
   module->allocator = allocator;
+  module->flags = flags;
 
-  iree_vm_FunctionDescriptor_vec_t function_descriptors =
-      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
-  module->function_descriptor_count =
-      iree_vm_FunctionDescriptor_vec_len(function_descriptors);
+  module->function_descriptor_count = function_descriptor_count;
   module->function_descriptor_table = function_descriptors;
+  module->function_verified_bits =
+      function_verified_bits_size > 0
+          ? (iree_atomic_int32_t*)((uint8_t*)module + sizeof(*module) +
+                                   type_table_size + rodata_ref_table_size)
+          : NULL;
 
   flatbuffers_uint8_vec_t bytecode_data =
       iree_vm_BytecodeModuleDef_bytecode_data(module_def);
@@ -881,6 +958,7 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
 #endif  // IREE_VM_BACKTRACE_ENABLE
   module->interface.alloc_state = iree_vm_bytecode_module_alloc_state;
   module->interface.free_state = iree_vm_bytecode_module_free_state;
+  module->interface.fork_state = iree_vm_bytecode_module_fork_state;
   module->interface.resolve_import = iree_vm_bytecode_module_resolve_import;
   module->interface.notify = iree_vm_bytecode_module_notify;
   module->interface.begin_call = iree_vm_bytecode_module_begin_call;
@@ -916,10 +994,11 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
   }
 
   // Verify functions in the module now that we've verified the metadata that we
-  // need to do so.
+  // need to do so. Trusted modules verify each function on first call instead.
   iree_status_t verify_status = iree_ok_status();
 #if IREE_VM_BYTECODE_VERIFICATION_ENABLE
-  for (uint16_t i = 0; i < module->function_descriptor_count; ++i) {
+  for (uint16_t i = 0; !is_trusted && i < module->function_descriptor_count;
+       ++i) {
     IREE_TRACE_ZONE_BEGIN_NAMED(z1, "iree_vm_bytecode_function_verify");
     verify_status = iree_vm_bytecode_function_verify(module, i, allocator);
     IREE_TRACE_ZONE_END(z1);
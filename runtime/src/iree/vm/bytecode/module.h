@@ -23,6 +23,31 @@ IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create(
     iree_allocator_t archive_allocator, iree_allocator_t allocator,
     iree_vm_module_t** out_module);
 
+// Controls bytecode module loading behavior.
+typedef uint32_t iree_vm_bytecode_module_flags_t;
+enum iree_vm_bytecode_module_flag_bits_t {
+  IREE_VM_BYTECODE_MODULE_FLAG_NONE = 0u,
+
+  // The module archive comes from a trusted source (such as the compiler that
+  // produced the application binary) and does not need full verification.
+  // Only cheap header-level checks (version and feature requirements, function
+  // descriptor and rodata ranges) are performed when creating the module and
+  // the FlatBuffer structure is used as-is. Function bytecode is verified
+  // lazily the first time each function is called instead of upfront.
+  //
+  // WARNING: malformed or malicious archives may crash the process when this
+  // flag is set. Only use it when the archive contents can be trusted.
+  IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED = 1u << 0,
+};
+
+// Creates a VM module from an in-memory ModuleDef FlatBuffer archive as with
+// iree_vm_bytecode_module_create but with the load behavior controlled by
+// |flags|.
+IREE_API_EXPORT iree_status_t iree_vm_bytecode_module_create_with_flags(
+    iree_vm_instance_t* instance, iree_vm_bytecode_module_flags_t flags,
+    iree_const_byte_span_t archive_contents, iree_allocator_t archive_allocator,
+    iree_allocator_t allocator, iree_vm_module_t** out_module);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
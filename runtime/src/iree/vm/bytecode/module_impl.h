@@ -11,7 +11,9 @@
 #include <string.h>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/atomics.h"
 #include "iree/vm/api.h"
+#include "iree/vm/bytecode/module.h"
 #include "iree/vm/bytecode/utils/isa.h"
 
 #ifdef __cplusplus
@@ -34,6 +36,15 @@ typedef struct iree_vm_bytecode_module_t {
   // A pointer to the bytecode data embedded within the module.
   iree_const_byte_span_t bytecode_data;
 
+  // Flags controlling how the module was loaded.
+  iree_vm_bytecode_module_flags_t flags;
+
+  // Bitmap with one bit per internal function indicating whether its bytecode
+  // has been verified. Only allocated when verification is deferred until the
+  // first call (IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED) and otherwise NULL as all
+  // functions are verified during module creation.
+  iree_atomic_int32_t* function_verified_bits;
+
   // Allocator this module was allocated with and must be freed with.
   iree_allocator_t allocator;
 
@@ -73,6 +84,12 @@ typedef struct iree_vm_bytecode_import_t {
   // don't support variadic values (yet).
   uint16_t argument_buffer_size;
   uint16_t result_buffer_size;
+
+  // Direct call shim and target when the import is provided by a native module
+  // using the default call support. Calls made with these skip the module
+  // begin_call and function table lookup. NULL shim if unavailable.
+  iree_vm_native_function_ptr_t native_function;
+  void* native_self;
 } iree_vm_bytecode_import_t;
 
 // Per-instance module state.
@@ -114,8 +114,8 @@ class VMBytecodeModuleTest : public ::testing::Test {
                                           iree_allocator_system(), &instance_));
 
     const auto* module_file_toc = iree_vm_bytecode_module_test_module_create();
-    IREE_CHECK_OK(iree_vm_bytecode_module_create(
-        instance_,
+    IREE_CHECK_OK(iree_vm_bytecode_module_create_with_flags(
+        instance_, module_flags(),
         iree_const_byte_span_t{
             reinterpret_cast<const uint8_t*>(module_file_toc->data),
             static_cast<iree_host_size_t>(module_file_toc->size)},
@@ -127,6 +127,10 @@ class VMBytecodeModuleTest : public ::testing::Test {
         iree_allocator_system(), &context_));
   }
 
+  virtual iree_vm_bytecode_module_flags_t module_flags() const {
+    return IREE_VM_BYTECODE_MODULE_FLAG_NONE;
+  }
+
   virtual void TearDown() {
     iree_vm_module_release(bytecode_module_);
     iree_vm_context_release(context_);
@@ -228,4 +232,25 @@ TEST_F(VMBytecodeModuleTest, FuncIO600) {
               IsOkAndHolds(Eq(MakeNullRefList(600))));
 }
 
+// Loads the module with verification deferred until each function is called.
+class VMBytecodeModuleTrustedTest : public VMBytecodeModuleTest {
+ protected:
+  iree_vm_bytecode_module_flags_t module_flags() const override {
+    return IREE_VM_BYTECODE_MODULE_FLAG_TRUSTED;
+  }
+};
+
+TEST_F(VMBytecodeModuleTrustedTest, FuncIO8) {
+  EXPECT_THAT(RunFunction("FuncIO8", MakeValueRangeList(0, 7)),
+              IsOkAndHolds(Eq(MakeValueRangeList(7, 0))));
+  // Second call takes the already-verified path.
+  EXPECT_THAT(RunFunction("FuncIO8", MakeValueRangeList(0, 7)),
+              IsOkAndHolds(Eq(MakeValueRangeList(7, 0))));
+}
+
+TEST_F(VMBytecodeModuleTrustedTest, FuncIO600) {
+  EXPECT_THAT(RunFunction("FuncIO600", MakeNullRefList(600)),
+              IsOkAndHolds(Eq(MakeNullRefList(600))));
+}
+
 }  // namespace
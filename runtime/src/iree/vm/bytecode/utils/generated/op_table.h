@@ -140,11 +140,11 @@ typedef enum {
   IREE_VM_OP_CORE_CastAnyRef = 0x82,
   IREE_VM_OP_CORE_BranchTable = 0x83,
   IREE_VM_OP_CORE_BufferHash = 0x84,
-  IREE_VM_OP_CORE_RSV_0x85,
-  IREE_VM_OP_CORE_RSV_0x86,
-  IREE_VM_OP_CORE_RSV_0x87,
-  IREE_VM_OP_CORE_RSV_0x88,
-  IREE_VM_OP_CORE_RSV_0x89,
+  IREE_VM_OP_CORE_CmpEQI32CondBranch = 0x85,
+  IREE_VM_OP_CORE_CmpNEI32CondBranch = 0x86,
+  IREE_VM_OP_CORE_CmpLTI32SCondBranch = 0x87,
+  IREE_VM_OP_CORE_CmpLTI32UCondBranch = 0x88,
+  IREE_VM_OP_CORE_CmpNZRefCondBranch = 0x89,
   IREE_VM_OP_CORE_RSV_0x8A,
   IREE_VM_OP_CORE_RSV_0x8B,
   IREE_VM_OP_CORE_RSV_0x8C,
@@ -399,11 +399,11 @@ typedef enum {
     OPC(0x82, CastAnyRef) \
     OPC(0x83, BranchTable) \
     OPC(0x84, BufferHash) \
-    RSV(0x85) \
-    RSV(0x86) \
-    RSV(0x87) \
-    RSV(0x88) \
-    RSV(0x89) \
+    OPC(0x85, CmpEQI32CondBranch) \
+    OPC(0x86, CmpNEI32CondBranch) \
+    OPC(0x87, CmpLTI32SCondBranch) \
+    OPC(0x88, CmpLTI32UCondBranch) \
+    OPC(0x89, CmpNZRefCondBranch) \
     RSV(0x8A) \
     RSV(0x8B) \
     RSV(0x8C) \
@@ -14,6 +14,100 @@
 // Module metadata verification
 //===----------------------------------------------------------------------===//
 
+// Verifies that all rodata segments referencing external data in the archive
+// are in range.
+static iree_status_t iree_vm_bytecode_module_verify_rodata_ranges(
+    iree_const_byte_span_t archive_contents,
+    iree_host_size_t archive_rodata_offset,
+    iree_vm_BytecodeModuleDef_table_t module_def) {
+  iree_vm_RodataSegmentDef_vec_t rodata_segments =
+      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
+  for (size_t i = 0; i < iree_vm_RodataSegmentDef_vec_len(rodata_segments);
+       ++i) {
+    iree_vm_RodataSegmentDef_table_t segment =
+        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
+    if (iree_vm_RodataSegmentDef_embedded_data_is_present(segment)) {
+      continue;  // embedded data is verified by FlatBuffers
+    }
+    uint64_t segment_offset =
+        iree_vm_RodataSegmentDef_external_data_offset(segment);
+    uint64_t segment_length =
+        iree_vm_RodataSegmentDef_external_data_length(segment);
+    uint64_t segment_end =
+        archive_rodata_offset + segment_offset + segment_length;
+    if (segment_end > archive_contents.data_length) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "rodata[%zu] external reference out of range", i);
+    }
+  }
+  return iree_ok_status();
+}
+
+// Verifies that we can properly handle the bytecode embedded in the module.
+// We require that major versions match and allow loading of older minor
+// versions (we keep changes backwards-compatible).
+static iree_status_t iree_vm_bytecode_module_verify_bytecode_version(
+    iree_vm_BytecodeModuleDef_table_t module_def) {
+  const uint32_t bytecode_version =
+      iree_vm_BytecodeModuleDef_bytecode_version(module_def);
+  const uint32_t bytecode_version_major = bytecode_version >> 16;
+  const uint32_t bytecode_version_minor = bytecode_version & 0xFFFF;
+  if ((bytecode_version_major != IREE_VM_BYTECODE_VERSION_MAJOR) ||
+      (bytecode_version_minor > IREE_VM_BYTECODE_VERSION_MINOR)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "bytecode version mismatch; runtime supports %d.%d, module has %d.%d",
+        IREE_VM_BYTECODE_VERSION_MAJOR, IREE_VM_BYTECODE_VERSION_MINOR,
+        bytecode_version_major, bytecode_version_minor);
+  }
+  return iree_ok_status();
+}
+
+// Verifies that all function descriptors reference valid bytecode ranges and
+// declare register counts that are within the supported limits.
+static iree_status_t iree_vm_bytecode_module_verify_function_descriptors(
+    iree_vm_BytecodeModuleDef_table_t module_def) {
+  iree_vm_FunctionDescriptor_vec_t function_descriptors =
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
+  flatbuffers_uint8_vec_t bytecode_data =
+      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
+  for (size_t i = 0;
+       i < iree_vm_FunctionDescriptor_vec_len(function_descriptors); ++i) {
+    iree_vm_FunctionDescriptor_struct_t function_descriptor =
+        iree_vm_FunctionDescriptor_vec_at(function_descriptors, i);
+    if (function_descriptor->block_count == 0) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "functions[%zu] descriptor block count is 0; "
+          "functions must have at least 1 block, expected %d",
+          i, function_descriptor->block_count);
+    }
+    if (function_descriptor->bytecode_length == 0) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "functions[%zu] descriptor bytecode reports 0 "
+                              "length; functions must have at least one block",
+                              i);
+    }
+    if (function_descriptor->bytecode_offset < 0 ||
+        function_descriptor->bytecode_offset +
+                function_descriptor->bytecode_length >
+            flatbuffers_uint8_vec_len(bytecode_data)) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "functions[%zu] descriptor bytecode span out of "
+                              "range (0 < %d < %zu)",
+                              i, function_descriptor->bytecode_offset,
+                              flatbuffers_uint8_vec_len(bytecode_data));
+    }
+    if (function_descriptor->i32_register_count > IREE_I32_REGISTER_COUNT ||
+        function_descriptor->ref_register_count > IREE_REF_REGISTER_COUNT) {
+      return iree_make_status(
+          IREE_STATUS_INVALID_ARGUMENT,
+          "functions[%zu] descriptor register count out of range", i);
+    }
+  }
+  return iree_ok_status();
+}
+
 iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     iree_const_byte_span_t archive_contents,
     iree_const_byte_span_t flatbuffer_contents,
@@ -59,26 +153,8 @@ iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     }
   }
 
-  iree_vm_RodataSegmentDef_vec_t rodata_segments =
-      iree_vm_BytecodeModuleDef_rodata_segments(module_def);
-  for (size_t i = 0; i < iree_vm_RodataSegmentDef_vec_len(rodata_segments);
-       ++i) {
-    iree_vm_RodataSegmentDef_table_t segment =
-        iree_vm_RodataSegmentDef_vec_at(rodata_segments, i);
-    if (iree_vm_RodataSegmentDef_embedded_data_is_present(segment)) {
-      continue;  // embedded data is verified by FlatBuffers
-    }
-    uint64_t segment_offset =
-        iree_vm_RodataSegmentDef_external_data_offset(segment);
-    uint64_t segment_length =
-        iree_vm_RodataSegmentDef_external_data_length(segment);
-    uint64_t segment_end =
-        archive_rodata_offset + segment_offset + segment_length;
-    if (segment_end > archive_contents.data_length) {
-      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                              "rodata[%zu] external reference out of range", i);
-    }
-  }
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_verify_rodata_ranges(
+      archive_contents, archive_rodata_offset, module_def));
 
   iree_vm_ModuleDependencyDef_vec_t dependencies =
       iree_vm_BytecodeModuleDef_dependencies(module_def);
@@ -164,59 +240,62 @@ iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     }
   }
 
-  // Verify that we can properly handle the bytecode embedded in the module.
-  // We require that major versions match and allow loading of older minor
-  // versions (we keep changes backwards-compatible).
-  const uint32_t bytecode_version =
-      iree_vm_BytecodeModuleDef_bytecode_version(module_def);
-  const uint32_t bytecode_version_major = bytecode_version >> 16;
-  const uint32_t bytecode_version_minor = bytecode_version & 0xFFFF;
-  if ((bytecode_version_major != IREE_VM_BYTECODE_VERSION_MAJOR) ||
-      (bytecode_version_minor > IREE_VM_BYTECODE_VERSION_MINOR)) {
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_verify_bytecode_version(module_def));
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_verify_function_descriptors(module_def));
+
+  return iree_ok_status();
+}
+
+iree_status_t iree_vm_bytecode_module_flatbuffer_verify_trusted(
+    iree_const_byte_span_t archive_contents,
+    iree_const_byte_span_t flatbuffer_contents,
+    iree_host_size_t archive_rodata_offset) {
+  // Even trusted modules must have been produced for this runtime. These checks
+  // only touch the root table and the tables we index directly at runtime and
+  // are cheap compared to walking every table in the FlatBuffer.
+  if (flatbuffer_contents.data_length < sizeof(flatbuffers_uoffset_t) * 2 ||
+      !flatbuffers_has_identifier(flatbuffer_contents.data,
+                                  iree_vm_BytecodeModuleDef_file_identifier)) {
     return iree_make_status(
         IREE_STATUS_INVALID_ARGUMENT,
-        "bytecode version mismatch; runtime supports %d.%d, module has %d.%d",
-        IREE_VM_BYTECODE_VERSION_MAJOR, IREE_VM_BYTECODE_VERSION_MINOR,
-        bytecode_version_major, bytecode_version_minor);
+        "FlatBuffer missing expected identifier "
+        "'" iree_vm_BytecodeModuleDef_file_identifier "'");
   }
+  iree_vm_BytecodeModuleDef_table_t module_def =
+      iree_vm_BytecodeModuleDef_as_root(flatbuffer_contents.data);
 
-  flatbuffers_uint8_vec_t bytecode_data =
-      iree_vm_BytecodeModuleDef_bytecode_data(module_def);
-  for (size_t i = 0;
-       i < iree_vm_FunctionDescriptor_vec_len(function_descriptors); ++i) {
-    iree_vm_FunctionDescriptor_struct_t function_descriptor =
-        iree_vm_FunctionDescriptor_vec_at(function_descriptors, i);
-    if (function_descriptor->block_count == 0) {
-      return iree_make_status(
-          IREE_STATUS_INVALID_ARGUMENT,
-          "functions[%zu] descriptor block count is 0; "
-          "functions must have at least 1 block, expected %d",
-          i, function_descriptor->block_count);
-    }
-    if (function_descriptor->bytecode_length == 0) {
-      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                              "functions[%zu] descriptor bytecode reports 0 "
-                              "length; functions must have at least one block",
-                              i);
-    }
-    if (function_descriptor->bytecode_offset < 0 ||
-        function_descriptor->bytecode_offset +
-                function_descriptor->bytecode_length >
-            flatbuffers_uint8_vec_len(bytecode_data)) {
-      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
-                              "functions[%zu] descriptor bytecode span out of "
-                              "range (0 < %d < %zu)",
-                              i, function_descriptor->bytecode_offset,
-                              flatbuffers_uint8_vec_len(bytecode_data));
-    }
-    if (function_descriptor->i32_register_count > IREE_I32_REGISTER_COUNT ||
-        function_descriptor->ref_register_count > IREE_REF_REGISTER_COUNT) {
-      return iree_make_status(
-          IREE_STATUS_INVALID_ARGUMENT,
-          "functions[%zu] descriptor register count out of range", i);
-    }
+  const iree_vm_FeatureBits_enum_t available_features =
+      iree_vm_bytecode_available_features();
+  const iree_vm_FeatureBits_enum_t required_features =
+      iree_vm_BytecodeModuleDef_requirements(module_def);
+  IREE_RETURN_IF_ERROR(iree_vm_check_feature_mismatch(
+      __FILE__, __LINE__, required_features, available_features));
+
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_verify_bytecode_version(module_def));
+
+  iree_vm_FunctionSignatureDef_vec_t function_signatures =
+      iree_vm_BytecodeModuleDef_function_signatures(module_def);
+  iree_vm_FunctionDescriptor_vec_t function_descriptors =
+      iree_vm_BytecodeModuleDef_function_descriptors(module_def);
+  if (iree_vm_FunctionSignatureDef_vec_len(function_signatures) !=
+      iree_vm_FunctionDescriptor_vec_len(function_descriptors)) {
+    return iree_make_status(
+        IREE_STATUS_INVALID_ARGUMENT,
+        "function signature and descriptor table length mismatch (%zu vs %zu)",
+        iree_vm_FunctionSignatureDef_vec_len(function_signatures),
+        iree_vm_FunctionDescriptor_vec_len(function_descriptors));
   }
 
+  // Lazy function verification relies on the descriptors being in range and
+  // rodata references are turned into buffers during module creation.
+  IREE_RETURN_IF_ERROR(
+      iree_vm_bytecode_module_verify_function_descriptors(module_def));
+  IREE_RETURN_IF_ERROR(iree_vm_bytecode_module_verify_rodata_ranges(
+      archive_contents, archive_rodata_offset, module_def));
+
   return iree_ok_status();
 }
 
@@ -1559,6 +1638,32 @@ static iree_status_t iree_vm_bytecode_function_verify_bytecode_op(
       verify_state->in_block = 0;  // terminator
     });
 
+#define VERIFY_OP_CORE_CMP_COND_BRANCH_I32(op_name)            \
+  VERIFY_OP(CORE, op_name, {                                   \
+    IREE_VM_VERIFY_REQUIREMENT(iree_vm_FeatureBits_FUSED_OPS); \
+    VM_VerifyOperandRegI32(lhs);                               \
+    VM_VerifyOperandRegI32(rhs);                               \
+    VM_VerifyBranchTarget(true_dest_pc);                       \
+    VM_VerifyBranchOperands(true_operands);                    \
+    VM_VerifyBranchTarget(false_dest_pc);                      \
+    VM_VerifyBranchOperands(false_operands);                   \
+    verify_state->in_block = 0; /* terminator */               \
+  });
+
+    VERIFY_OP_CORE_CMP_COND_BRANCH_I32(CmpEQI32CondBranch);
+    VERIFY_OP_CORE_CMP_COND_BRANCH_I32(CmpNEI32CondBranch);
+    VERIFY_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32SCondBranch);
+    VERIFY_OP_CORE_CMP_COND_BRANCH_I32(CmpLTI32UCondBranch);
+    VERIFY_OP(CORE, CmpNZRefCondBranch, {
+      IREE_VM_VERIFY_REQUIREMENT(iree_vm_FeatureBits_FUSED_OPS);
+      VM_VerifyOperandRegRef(operand);
+      VM_VerifyBranchTarget(true_dest_pc);
+      VM_VerifyBranchOperands(true_operands);
+      VM_VerifyBranchTarget(false_dest_pc);
+      VM_VerifyBranchOperands(false_operands);
+      verify_state->in_block = 0;  // terminator
+    });
+
     VERIFY_OP(CORE, BranchTable, {
       VM_VerifyOperandRegI32(index);
       VM_VerifyBranchTarget(default_dest_pc);
@@ -20,6 +20,16 @@ iree_status_t iree_vm_bytecode_module_flatbuffer_verify(
     iree_const_byte_span_t flatbuffer_contents,
     iree_host_size_t archive_rodata_offset);
 
+// Performs the minimal verification of the FlatBuffer required to load a module
+// from a trusted source. Only the root table, bytecode version and features,
+// function descriptors, and rodata ranges are checked. The FlatBuffer structure
+// itself is assumed valid and function bytecode must be verified prior to
+// execution with iree_vm_bytecode_function_verify.
+iree_status_t iree_vm_bytecode_module_flatbuffer_verify_trusted(
+    iree_const_byte_span_t archive_contents,
+    iree_const_byte_span_t flatbuffer_contents,
+    iree_host_size_t archive_rodata_offset);
+
 // Verifies the bytecode contained within the given |function_ordinal|.
 // Assumes that all information on |module| has been verified and only function
 // information requires verification.
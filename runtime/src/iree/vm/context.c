@@ -550,6 +550,115 @@ iree_vm_context_freeze(iree_vm_context_t* context) {
   return iree_ok_status();
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_context_fork(
+    iree_vm_context_t* parent_context, iree_vm_context_flags_t flags,
+    iree_allocator_t allocator, iree_vm_context_t** out_context) {
+  IREE_ASSERT_ARGUMENT(parent_context);
+  IREE_ASSERT_ARGUMENT(out_context);
+  *out_context = NULL;
+  if (!parent_context->is_frozen) {
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "only frozen contexts can be forked");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_host_size_t module_count = parent_context->list.count;
+  iree_host_size_t context_size =
+      sizeof(iree_vm_context_t) + sizeof(iree_vm_module_t*) * module_count +
+      sizeof(iree_vm_module_state_t*) * module_count;
+
+  iree_vm_context_t* context = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(allocator, context_size, (void**)&context));
+  iree_atomic_ref_count_init(&context->ref_count);
+  context->instance = parent_context->instance;
+  iree_vm_instance_retain(context->instance);
+  context->allocator = allocator;
+
+  context->context_id = iree_vm_context_allocate_id();
+
+  // Forked contexts are always frozen so that they can be forked themselves.
+  context->is_frozen = 1;
+  context->is_static = 1;
+  context->flags = flags;
+
+  uint8_t* p = (uint8_t*)context + sizeof(iree_vm_context_t);
+  context->list.modules = (iree_vm_module_t**)p;
+  p += sizeof(iree_vm_module_t*) * module_count;
+  context->list.module_states = (iree_vm_module_state_t**)p;
+  p += sizeof(iree_vm_module_state_t*) * module_count;
+  context->list.count = 0;
+  context->list.capacity = module_count;
+
+  // VM stack used to call into module __init methods of modules that could not
+  // be forked.
+  IREE_VM_INLINE_STACK_INITIALIZE(
+      stack,
+      context->flags & IREE_VM_CONTEXT_FLAG_TRACE_EXECUTION
+          ? IREE_VM_INVOCATION_FLAG_TRACE_EXECUTION
+          : IREE_VM_INVOCATION_FLAG_NONE,
+      iree_vm_context_state_resolver(context), context->allocator);
+
+  // Modules are forked in registration order such that imports only ever
+  // resolve against modules that have already been forked.
+  iree_status_t status = iree_ok_status();
+  iree_host_size_t i = 0;
+  for (i = 0; i < module_count; ++i) {
+    iree_vm_module_t* module = parent_context->list.modules[i];
+    context->list.modules[i] = module;
+    context->list.module_states[i] = NULL;
+    iree_vm_module_retain(module);
+
+    iree_vm_module_state_t* module_state = NULL;
+    const bool is_forked = module->fork_state != NULL;
+    if (is_forked) {
+      status = module->fork_state(module->self,
+                                  parent_context->list.module_states[i],
+                                  context->allocator, &module_state);
+    } else {
+      status =
+          module->alloc_state(module->self, context->allocator, &module_state);
+    }
+    if (!iree_status_is_ok(status)) break;
+    context->list.module_states[i] = module_state;
+
+    // Import tables are stored per-state and must be populated again.
+    status =
+        iree_vm_context_resolve_module_imports(context, module, module_state);
+    if (!iree_status_is_ok(status)) {
+      iree_string_view_t module_name = iree_vm_module_name(module);
+      (void)module_name;
+      status = iree_status_annotate_f(status, "resolving module '%.*s' imports",
+                                      (int)module_name.size, module_name.data);
+      break;
+    }
+
+    ++context->list.count;
+
+    // Forked states are copies of initialized states and only freshly
+    // allocated states need initialization.
+    if (!is_forked) {
+      status = iree_vm_context_run_function(context, stack, module,
+                                            iree_make_cstring_view("__init"));
+      if (!iree_status_is_ok(status)) break;
+    }
+  }
+
+  iree_vm_stack_deinitialize(stack);
+
+  if (!iree_status_is_ok(status)) {
+    // Release the module that failed to fork along with all prior modules.
+    context->list.count = i + 1;
+    iree_vm_context_destroy(context);
+    IREE_TRACE_ZONE_END(z0);
+    return status;
+  }
+
+  *out_context = context;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
 IREE_API_EXPORT iree_vm_state_resolver_t
 iree_vm_context_state_resolver(const iree_vm_context_t* context) {
   iree_vm_state_resolver_t state_resolver = {0};
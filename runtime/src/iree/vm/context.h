@@ -109,6 +109,24 @@ IREE_API_EXPORT iree_status_t iree_vm_context_register_modules(
 IREE_API_EXPORT iree_status_t
 iree_vm_context_freeze(iree_vm_context_t* context);
 
+// Creates a new context forked from the frozen |parent_context|.
+// The new context has the same modules registered as the parent and each
+// module state is forked from the fully initialized parent state: read-only
+// data such as constants and device-resident resources referenced by globals
+// are shared and mutable data is copied such that modifications made within
+// one context are not visible to the other. Modules are not re-initialized
+// making forking significantly cheaper than creating a new context with the
+// same modules. Modules that do not support forking have their state allocated
+// and initialized as if registered on a new context.
+//
+// Returns IREE_STATUS_FAILED_PRECONDITION if |parent_context| is not frozen.
+// The parent context must not be used concurrently for execution while being
+// forked and may be released independently of the forked context.
+// |out_context| must be released by the caller.
+IREE_API_EXPORT iree_status_t iree_vm_context_fork(
+    iree_vm_context_t* parent_context, iree_vm_context_flags_t flags,
+    iree_allocator_t allocator, iree_vm_context_t** out_context);
+
 // Returns a state resolver setup to use the |context| for resolving module
 // state.
 IREE_API_EXPORT iree_vm_state_resolver_t
@@ -269,11 +269,20 @@ static void iree_vm_invoke_fiber_leave(iree_vm_invocation_id_t invocation_id,
 // Synchronous invocation
 //===----------------------------------------------------------------------===//
 
-IREE_API_EXPORT iree_status_t iree_vm_invoke(
+static iree_status_t iree_vm_begin_invoke_with_stack_storage(
+    iree_vm_invoke_state_t* state, iree_byte_span_t stack_storage,
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_allocator_t host_allocator);
+
+// Synchronously invokes |function| as with iree_vm_invoke.
+// If |stack_storage| is non-empty it is used for the VM stack instead of the
+// storage inlined in the invocation state.
+static iree_status_t iree_vm_invoke_with_stack_storage(
     iree_vm_context_t* context, iree_vm_function_t function,
     iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
     const iree_vm_list_t* inputs, iree_vm_list_t* outputs,
-    iree_allocator_t host_allocator) {
+    iree_byte_span_t stack_storage, iree_allocator_t host_allocator) {
   IREE_TRACE_ZONE_BEGIN(z0);
 
   // Bound the synchronous invocation to the timeout specified by the user
@@ -299,8 +308,9 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   // complete the invocation before returning. If it yields we'll need to resume
   // it, possibly after taking care of pending waits.
   iree_vm_invoke_state_t state = {0};
-  iree_status_t status = iree_vm_begin_invoke(&state, context, function, flags,
-                                              policy, inputs, host_allocator);
+  iree_status_t status = iree_vm_begin_invoke_with_stack_storage(
+      &state, stack_storage, context, function, flags, policy, inputs,
+      host_allocator);
   while (iree_status_is_deferred(status)) {
     // Grab the wait frame from the stack holding the wait parameters.
     // This is optional: if an invocation yields for cooperative scheduling
@@ -368,6 +378,173 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
   return status;
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_invoke(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_vm_list_t* outputs,
+    iree_allocator_t host_allocator) {
+  return iree_vm_invoke_with_stack_storage(context, function, flags, policy,
+                                           inputs, outputs,
+                                           iree_byte_span_empty(),
+                                           host_allocator);
+}
+
+//===----------------------------------------------------------------------===//
+// Reusable synchronous invocation
+//===----------------------------------------------------------------------===//
+
+struct iree_vm_invoker_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+
+  // Retained context the function is invoked within.
+  iree_vm_context_t* context;
+  iree_vm_function_t function;
+  iree_vm_invocation_flags_t flags;
+
+  // I/O lists reused across invocations.
+  iree_vm_list_t* inputs;
+  iree_vm_list_t* outputs;
+
+  // Stack storage reused across invocations or empty to use the storage inlined
+  // in the invocation state. Points into the trailing allocation storage.
+  iree_byte_span_t stack_storage;
+};
+
+// Returns the number of values in a cconv fragment (excluding the leading
+// marker and void values).
+static iree_host_size_t iree_vm_invoker_cconv_value_count(
+    iree_string_view_t cconv_fragment) {
+  iree_host_size_t count = 0;
+  for (iree_host_size_t i = 0; i < cconv_fragment.size; ++i) {
+    if (cconv_fragment.data[i] != IREE_VM_CCONV_TYPE_VOID) ++count;
+  }
+  return count;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invoker_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, iree_host_size_t stack_size,
+    iree_allocator_t host_allocator, iree_vm_invoker_t** out_invoker) {
+  IREE_ASSERT_ARGUMENT(context);
+  IREE_ASSERT_ARGUMENT(out_invoker);
+  *out_invoker = NULL;
+  if (stack_size > IREE_VM_STACK_MAX_SIZE) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "stack size %" PRIhsz " exceeds maximum of %d",
+                            stack_size, IREE_VM_STACK_MAX_SIZE);
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Split the signature once so that we can size the I/O lists to avoid any
+  // growth during invocation.
+  iree_vm_function_signature_t signature =
+      iree_vm_function_signature(&function);
+  iree_string_view_t cconv_arguments = iree_string_view_empty();
+  iree_string_view_t cconv_results = iree_string_view_empty();
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_vm_function_call_get_cconv_fragments(
+              &signature, &cconv_arguments, &cconv_results));
+  if (iree_vm_function_call_is_variadic_cconv(cconv_arguments)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_UNIMPLEMENTED,
+                            "variadic functions cannot be invoked");
+  }
+
+  // Stacks at or below the default size are inlined in the invocation state.
+  if (stack_size <= IREE_VM_STACK_DEFAULT_SIZE) stack_size = 0;
+  iree_vm_invoker_t* invoker = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(
+              host_allocator,
+              iree_host_align(sizeof(*invoker), iree_max_align_t) + stack_size,
+              (void**)&invoker));
+  iree_atomic_ref_count_init(&invoker->ref_count);
+  invoker->host_allocator = host_allocator;
+  invoker->context = context;
+  iree_vm_context_retain(context);
+  invoker->function = function;
+  invoker->flags = flags;
+  invoker->inputs = NULL;
+  invoker->outputs = NULL;
+  invoker->stack_storage = iree_make_byte_span(
+      stack_size ? (uint8_t*)invoker +
+                       iree_host_align(sizeof(*invoker), iree_max_align_t)
+                 : NULL,
+      stack_size);
+
+  iree_status_t status = iree_vm_list_create(
+      iree_vm_make_undefined_type_def(),
+      iree_vm_invoker_cconv_value_count(cconv_arguments), host_allocator,
+      &invoker->inputs);
+  if (iree_status_is_ok(status)) {
+    status = iree_vm_list_create(
+        iree_vm_make_undefined_type_def(),
+        iree_vm_invoker_cconv_value_count(cconv_results), host_allocator,
+        &invoker->outputs);
+  }
+
+  if (iree_status_is_ok(status)) {
+    *out_invoker = invoker;
+  } else {
+    iree_vm_invoker_release(invoker);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+static void iree_vm_invoker_destroy(iree_vm_invoker_t* invoker) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_allocator_t host_allocator = invoker->host_allocator;
+  iree_vm_list_release(invoker->inputs);
+  iree_vm_list_release(invoker->outputs);
+  iree_vm_context_release(invoker->context);
+  iree_allocator_free(host_allocator, invoker);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_vm_invoker_retain(iree_vm_invoker_t* invoker) {
+  if (IREE_LIKELY(invoker)) {
+    iree_atomic_ref_count_inc(&invoker->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_vm_invoker_release(iree_vm_invoker_t* invoker) {
+  if (IREE_LIKELY(invoker) &&
+      iree_atomic_ref_count_dec(&invoker->ref_count) == 1) {
+    iree_vm_invoker_destroy(invoker);
+  }
+}
+
+IREE_API_EXPORT iree_vm_function_t
+iree_vm_invoker_function(const iree_vm_invoker_t* invoker) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  return invoker->function;
+}
+
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_inputs(
+    iree_vm_invoker_t* invoker) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  return invoker->inputs;
+}
+
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_outputs(
+    iree_vm_invoker_t* invoker) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  return invoker->outputs;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_invoker_invoke(
+    iree_vm_invoker_t* invoker, const iree_vm_invocation_policy_t* policy) {
+  IREE_ASSERT_ARGUMENT(invoker);
+  // Clearing retains the list capacity and releases any prior results.
+  iree_vm_list_clear(invoker->outputs);
+  return iree_vm_invoke_with_stack_storage(
+      invoker->context, invoker->function, invoker->flags, policy,
+      invoker->inputs, invoker->outputs, invoker->stack_storage,
+      invoker->host_allocator);
+}
+
 //===----------------------------------------------------------------------===//
 // Asynchronous invocation
 //===----------------------------------------------------------------------===//
@@ -382,6 +559,20 @@ IREE_API_EXPORT iree_status_t iree_vm_begin_invoke(
     iree_vm_function_t function, iree_vm_invocation_flags_t flags,
     const iree_vm_invocation_policy_t* policy, const iree_vm_list_t* inputs,
     iree_allocator_t host_allocator) {
+  return iree_vm_begin_invoke_with_stack_storage(
+      state, iree_byte_span_empty(), context, function, flags, policy, inputs,
+      host_allocator);
+}
+
+// Begins an invocation as with iree_vm_begin_invoke.
+// If |stack_storage| is non-empty it is used for the VM stack and must remain
+// valid until the invocation has ended. Results are always sliced off of the
+// storage inlined in |state|.
+static iree_status_t iree_vm_begin_invoke_with_stack_storage(
+    iree_vm_invoke_state_t* state, iree_byte_span_t stack_storage,
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, const iree_vm_invocation_policy_t* policy,
+    const iree_vm_list_t* inputs, iree_allocator_t host_allocator) {
   IREE_ASSERT_ARGUMENT(context);
   IREE_TRACE_ZONE_BEGIN(z0);
 
@@ -460,14 +651,18 @@ IREE_API_EXPORT iree_status_t iree_vm_begin_invoke(
     return status;
   }
 
-  // Initialize the stack with the inline storage.
-  // We (probably) sliced off the head of the storage above to use for results
-  // and perform an offset here to account for that.
+  // Initialize the stack with the provided or inline storage.
+  // We (probably) sliced off the head of the inline storage above to use for
+  // results and perform an offset here to account for that.
+  if (iree_byte_span_is_empty(stack_storage)) {
+    stack_storage = iree_make_byte_span(
+        state->stack_storage + reserved_storage_size,
+        sizeof(state->stack_storage) - reserved_storage_size);
+  }
   iree_vm_stack_t* stack = NULL;
-  status = iree_vm_stack_initialize(
-      iree_make_byte_span(state->stack_storage + reserved_storage_size,
-                          sizeof(state->stack_storage) - reserved_storage_size),
-      flags, iree_vm_context_state_resolver(context), host_allocator, &stack);
+  status = iree_vm_stack_initialize(stack_storage, flags,
+                                    iree_vm_context_state_resolver(context),
+                                    host_allocator, &stack);
   if (!iree_status_is_ok(status)) {
     iree_vm_invoke_release_argument_storage(cconv_arguments, arguments,
                                             arguments_on_heap, host_allocator);
@@ -48,6 +48,71 @@ IREE_API_EXPORT iree_status_t iree_vm_invoke(
     const iree_vm_list_t* inputs, iree_vm_list_t* outputs,
     iree_allocator_t host_allocator);
 
+//===----------------------------------------------------------------------===//
+// Reusable synchronous invocation
+//===----------------------------------------------------------------------===//
+
+// A reusable synchronous invoker of a single function.
+// Resources that would otherwise be set up on each iree_vm_invoke are created
+// once and reused across invocations: the resolved function, input and output
+// lists sized to the function signature, and optionally a pre-sized VM stack.
+// Invocations that fit within the stack and marshal no more arguments than fit
+// on the native stack perform no heap allocations in the invocation machinery.
+//
+// Usage:
+//   iree_vm_invoker_t* invoker = NULL;
+//   iree_vm_invoker_create(context, function, flags, 0, allocator, &invoker);
+//   for (...) {
+//     iree_vm_list_t* inputs = iree_vm_invoker_inputs(invoker);
+//     iree_vm_list_resize(inputs, 0);
+//     iree_vm_list_push_*(inputs, ...);
+//     iree_vm_invoker_invoke(invoker, NULL);
+//     iree_vm_list_t* outputs = iree_vm_invoker_outputs(invoker);
+//     ...
+//   }
+//   iree_vm_invoker_release(invoker);
+//
+// Thread-compatible: invocations must not be made concurrently through the
+// same invoker. Create one invoker per thread to invoke in parallel.
+typedef struct iree_vm_invoker_t iree_vm_invoker_t;
+
+// Creates a reusable invoker of |function| in |context|.
+// |stack_size| bytes of VM stack storage are allocated once and reused by all
+// invocations. Sizes at or below IREE_VM_STACK_DEFAULT_SIZE (including 0) use
+// the storage inlined in the invocation state as with iree_vm_invoke. Stacks
+// requiring more storage than provided will grow using |host_allocator|.
+IREE_API_EXPORT iree_status_t iree_vm_invoker_create(
+    iree_vm_context_t* context, iree_vm_function_t function,
+    iree_vm_invocation_flags_t flags, iree_host_size_t stack_size,
+    iree_allocator_t host_allocator, iree_vm_invoker_t** out_invoker);
+
+// Retains the given |invoker| for the caller.
+IREE_API_EXPORT void iree_vm_invoker_retain(iree_vm_invoker_t* invoker);
+
+// Releases the given |invoker| from the caller.
+IREE_API_EXPORT void iree_vm_invoker_release(iree_vm_invoker_t* invoker);
+
+// Returns the function invoked by |invoker|.
+IREE_API_EXPORT iree_vm_function_t
+iree_vm_invoker_function(const iree_vm_invoker_t* invoker);
+
+// Returns the input list passed to each invocation.
+// The contents are left unchanged by invocations and callers may either reuse
+// them or resize and repopulate the list between invocations.
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_inputs(
+    iree_vm_invoker_t* invoker);
+
+// Returns the output list populated by each invocation.
+// The list is cleared at the start of each invocation; callers must retain any
+// values they want to outlive the next invocation.
+IREE_API_EXPORT iree_vm_list_t* iree_vm_invoker_outputs(
+    iree_vm_invoker_t* invoker);
+
+// Synchronously invokes the function with the current inputs and populates the
+// outputs as with iree_vm_invoke.
+IREE_API_EXPORT iree_status_t iree_vm_invoker_invoke(
+    iree_vm_invoker_t* invoker, const iree_vm_invocation_policy_t* policy);
+
 //===----------------------------------------------------------------------===//
 // Asynchronous invocation
 //===----------------------------------------------------------------------===//
@@ -102,9 +102,7 @@ static void iree_vm_list_reset_range(iree_vm_list_t* list,
     }
     case IREE_VM_LIST_STORAGE_MODE_REF: {
       iree_vm_ref_t* ref_storage = (iree_vm_ref_t*)list->storage;
-      for (iree_host_size_t i = offset; i < offset + length; ++i) {
-        iree_vm_ref_release(&ref_storage[i]);
-      }
+      iree_vm_ref_release_range(&ref_storage[offset], length);
       break;
     }
     case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
@@ -784,6 +782,108 @@ iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value) {
   return iree_vm_list_set_value(list, i, value);
 }
 
+// Verifies that the range [i, i + count) is within the bounds of |list|.
+static iree_status_t iree_vm_list_check_range(const iree_vm_list_t* list,
+                                              iree_host_size_t i,
+                                              iree_host_size_t count) {
+  if (IREE_UNLIKELY(i > list->count || count > list->count - i)) {
+    return iree_make_status(IREE_STATUS_OUT_OF_RANGE,
+                            "range [%" PRIhsz ", %" PRIhsz
+                            ") out of bounds (%" PRIhsz ")",
+                            i, i + count, list->count);
+  }
+  return iree_ok_status();
+}
+
+// Verifies |values| can hold |count| elements of |value_type| and returns the
+// size of each element in |out_value_size|.
+static iree_status_t iree_vm_list_check_value_span(
+    iree_vm_value_type_t value_type, iree_host_size_t count,
+    iree_host_size_t data_length, iree_host_size_t* out_value_size) {
+  const iree_host_size_t value_size =
+      iree_vm_value_type_size(iree_vm_make_value_type_def(value_type));
+  if (IREE_UNLIKELY(!value_size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "invalid value type %d", (int)value_type);
+  } else if (IREE_UNLIKELY(count > data_length / value_size)) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "value span of %" PRIhsz
+                            " bytes too small for %" PRIhsz " elements",
+                            data_length, count);
+  }
+  *out_value_size = value_size;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values(
+    const iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_byte_span_t out_values) {
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_range(list, i, count));
+  iree_host_size_t value_size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_value_span(
+      value_type, count, out_values.data_length, &value_size));
+
+  // Fast path for lists storing the requested type directly.
+  if (list->storage_mode == IREE_VM_LIST_STORAGE_MODE_VALUE &&
+      iree_vm_type_def_as_value(list->element_type) == value_type) {
+    memcpy(out_values.data,
+           (const uint8_t*)list->storage + i * list->element_size,
+           count * value_size);
+    return iree_ok_status();
+  }
+
+  // Slow path converting each element.
+  uint8_t* p = out_values.data;
+  for (iree_host_size_t j = 0; j < count; ++j, p += value_size) {
+    iree_vm_value_t value;
+    IREE_RETURN_IF_ERROR(
+        iree_vm_list_get_value_as(list, i + j, value_type, &value));
+    memcpy(p, value.value_storage, value_size);
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_const_byte_span_t values) {
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_range(list, i, count));
+  iree_host_size_t value_size = 0;
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_value_span(
+      value_type, count, values.data_length, &value_size));
+
+  // Fast path for lists storing the provided type directly.
+  if (list->storage_mode == IREE_VM_LIST_STORAGE_MODE_VALUE &&
+      iree_vm_type_def_as_value(list->element_type) == value_type) {
+    memcpy((uint8_t*)list->storage + i * list->element_size, values.data,
+           count * value_size);
+    return iree_ok_status();
+  }
+
+  // Slow path converting each element.
+  const uint8_t* p = values.data;
+  for (iree_host_size_t j = 0; j < count; ++j, p += value_size) {
+    iree_vm_value_t value;
+    value.type = value_type;
+    value.i64 = 0;
+    memcpy(value.value_storage, p, value_size);
+    IREE_RETURN_IF_ERROR(iree_vm_list_set_value(list, i + j, &value));
+  }
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_push_values(
+    iree_vm_list_t* list, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_const_byte_span_t values) {
+  iree_host_size_t i = iree_vm_list_size(list);
+  IREE_RETURN_IF_ERROR(iree_vm_list_resize(list, i + count));
+  iree_status_t status =
+      iree_vm_list_set_values(list, i, count, value_type, values);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(iree_vm_list_resize(list, i));
+  }
+  return status;
+}
+
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(const iree_vm_list_t* list,
                                                  iree_host_size_t i,
                                                  iree_vm_ref_type_t type) {
@@ -906,6 +1006,90 @@ IREE_API_EXPORT iree_status_t iree_vm_list_push_ref_move(iree_vm_list_t* list,
   return iree_vm_list_set_ref_move(list, i, value);
 }
 
+IREE_API_EXPORT iree_status_t iree_vm_list_get_refs_retain(
+    const iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_ref_t* out_values) {
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_range(list, i, count));
+  switch (list->storage_mode) {
+    case IREE_VM_LIST_STORAGE_MODE_REF: {
+      iree_vm_ref_t* ref_storage = (iree_vm_ref_t*)list->storage + i;
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        iree_vm_ref_retain(&ref_storage[j], &out_values[j]);
+      }
+      return iree_ok_status();
+    }
+    case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
+      iree_vm_variant_t* variant_storage =
+          (iree_vm_variant_t*)list->storage + i;
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        if (!iree_vm_variant_is_empty(variant_storage[j]) &&
+            !iree_vm_type_def_is_ref(variant_storage[j].type)) {
+          return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                                  "variant at index %" PRIhsz
+                                  " is not a ref type",
+                                  i + j);
+        }
+      }
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        iree_vm_ref_retain(&variant_storage[j].ref, &out_values[j]);
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "list does not store refs");
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_set_refs_retain(
+    iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    const iree_vm_ref_t* values) {
+  IREE_RETURN_IF_ERROR(iree_vm_list_check_range(list, i, count));
+  switch (list->storage_mode) {
+    case IREE_VM_LIST_STORAGE_MODE_REF: {
+      // Check all types first so that failures leave the list unchanged.
+      const iree_vm_ref_type_t type =
+          iree_vm_type_def_as_ref(list->element_type);
+      if (type != IREE_VM_REF_TYPE_ANY) {
+        for (iree_host_size_t j = 0; j < count; ++j) {
+          if (IREE_UNLIKELY(values[j].type != IREE_VM_REF_TYPE_NULL &&
+                            values[j].type != type)) {
+            return iree_make_status(
+                IREE_STATUS_INVALID_ARGUMENT,
+                "source ref type mismatch at index %" PRIhsz, i + j);
+          }
+        }
+      }
+      iree_vm_ref_t* ref_storage = (iree_vm_ref_t*)list->storage + i;
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        iree_vm_ref_retain((iree_vm_ref_t*)&values[j], &ref_storage[j]);
+      }
+      return iree_ok_status();
+    }
+    case IREE_VM_LIST_STORAGE_MODE_VARIANT: {
+      for (iree_host_size_t j = 0; j < count; ++j) {
+        IREE_RETURN_IF_ERROR(iree_vm_list_set_ref(
+            list, i + j, /*is_move=*/false, (iree_vm_ref_t*)&values[j]));
+      }
+      return iree_ok_status();
+    }
+    default:
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "list cannot store refs");
+  }
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_list_push_refs_retain(
+    iree_vm_list_t* list, iree_host_size_t count, const iree_vm_ref_t* values) {
+  iree_host_size_t i = iree_vm_list_size(list);
+  IREE_RETURN_IF_ERROR(iree_vm_list_resize(list, i + count));
+  iree_status_t status = iree_vm_list_set_refs_retain(list, i, count, values);
+  if (!iree_status_is_ok(status)) {
+    iree_status_ignore(iree_vm_list_resize(list, i));
+  }
+  return status;
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_list_pop_front_ref_move(
     iree_vm_list_t* list, iree_vm_ref_t* out_value) {
   iree_host_size_t list_size = iree_vm_list_size(list);
@@ -157,6 +157,29 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_value(
 IREE_API_EXPORT iree_status_t
 iree_vm_list_push_value(iree_vm_list_t* list, const iree_vm_value_t* value);
 
+// Copies |count| values starting at index |i| into |out_values| as a dense
+// array of |value_type| elements. If |value_type| differs from the list storage
+// type each value will be converted using the value type semantics (such as
+// sign/zero extend, etc). Lists storing |value_type| elements are copied
+// directly without per-element conversion.
+IREE_API_EXPORT iree_status_t iree_vm_list_get_values(
+    const iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_byte_span_t out_values);
+
+// Sets |count| values starting at index |i| from the dense array of
+// |value_type| elements in |values|. The range must be valid in the list.
+// If |value_type| differs from the list storage type each value will be
+// converted using the value type semantics (such as sign/zero extend, etc).
+IREE_API_EXPORT iree_status_t iree_vm_list_set_values(
+    iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_const_byte_span_t values);
+
+// Pushes |count| values from the dense array of |value_type| elements in
+// |values| to the end of the list. Conversion follows iree_vm_list_set_values.
+IREE_API_EXPORT iree_status_t iree_vm_list_push_values(
+    iree_vm_list_t* list, iree_host_size_t count,
+    iree_vm_value_type_t value_type, iree_const_byte_span_t values);
+
 // Returns a dereferenced pointer to the given type if the element at the
 // given index |i| matches the |type|. Returns NULL on error.
 IREE_API_EXPORT void* iree_vm_list_get_ref_deref(const iree_vm_list_t* list,
@@ -195,6 +218,27 @@ IREE_API_EXPORT iree_status_t iree_vm_list_set_ref_move(iree_vm_list_t* list,
 IREE_API_EXPORT iree_status_t iree_vm_list_push_ref_move(iree_vm_list_t* list,
                                                          iree_vm_ref_t* value);
 
+// Returns |count| ref values starting at index |i| in |out_values|.
+// The refs will be retained and must be released by the caller. Any existing
+// refs in |out_values| will be released.
+IREE_API_EXPORT iree_status_t iree_vm_list_get_refs_retain(
+    const iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    iree_vm_ref_t* out_values);
+
+// Sets |count| ref values starting at index |i| from |values|, retaining a
+// reference to each in the list until the element is cleared or the list is
+// disposed. If any value does not match the list element type no elements are
+// changed.
+IREE_API_EXPORT iree_status_t iree_vm_list_set_refs_retain(
+    iree_vm_list_t* list, iree_host_size_t i, iree_host_size_t count,
+    const iree_vm_ref_t* values);
+
+// Pushes |count| ref values from |values| to the end of the list, retaining a
+// reference to each in the list until the element is cleared or the list is
+// disposed.
+IREE_API_EXPORT iree_status_t iree_vm_list_push_refs_retain(
+    iree_vm_list_t* list, iree_host_size_t count, const iree_vm_ref_t* values);
+
 // Pops the front ref value from the list and transfers ownership to the caller.
 IREE_API_EXPORT iree_status_t
 iree_vm_list_pop_front_ref_move(iree_vm_list_t* list, iree_vm_ref_t* out_value);
@@ -1253,6 +1253,105 @@ TEST_F(VMListTest, PushPopRef) {
   iree_vm_list_release(list);
 }
 
+// Tests bulk value get/set on typed lists and with conversion.
+TEST_F(VMListTest, BulkValues) {
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(iree_vm_list_create(
+      iree_vm_make_value_type_def(IREE_VM_VALUE_TYPE_I32), 0,
+      iree_allocator_system(), &list));
+
+  const int32_t values[5] = {0, 1, 2, -3, 4};
+  IREE_ASSERT_OK(iree_vm_list_push_values(
+      list, IREE_ARRAYSIZE(values), IREE_VM_VALUE_TYPE_I32,
+      iree_make_const_byte_span(values, sizeof(values))));
+  EXPECT_EQ(5, iree_vm_list_size(list));
+  EXPECT_THAT(GetValuesList(list),
+              Eq(MakeValuesList({0, 1, 2, -3, 4})));
+
+  // Same type reads bypass conversion.
+  int32_t i32_values[3] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values(
+      list, 2, IREE_ARRAYSIZE(i32_values), IREE_VM_VALUE_TYPE_I32,
+      iree_make_byte_span(i32_values, sizeof(i32_values))));
+  EXPECT_EQ(i32_values[0], 2);
+  EXPECT_EQ(i32_values[1], -3);
+  EXPECT_EQ(i32_values[2], 4);
+
+  // Reads of other types sign extend.
+  int64_t i64_values[2] = {0};
+  IREE_ASSERT_OK(iree_vm_list_get_values(
+      list, 3, IREE_ARRAYSIZE(i64_values), IREE_VM_VALUE_TYPE_I64,
+      iree_make_byte_span(i64_values, sizeof(i64_values))));
+  EXPECT_EQ(i64_values[0], -3);
+  EXPECT_EQ(i64_values[1], 4);
+
+  // Writes of other types are converted to the storage type.
+  const int64_t new_values[2] = {10, 11};
+  IREE_ASSERT_OK(iree_vm_list_set_values(
+      list, 0, IREE_ARRAYSIZE(new_values), IREE_VM_VALUE_TYPE_I64,
+      iree_make_const_byte_span(new_values, sizeof(new_values))));
+  EXPECT_THAT(GetValuesList(list),
+              Eq(MakeValuesList({10, 11, 2, -3, 4})));
+
+  // Ranges and spans are checked.
+  EXPECT_THAT(Status(iree_vm_list_get_values(
+                  list, 4, 2, IREE_VM_VALUE_TYPE_I32,
+                  iree_make_byte_span(i32_values, sizeof(i32_values)))),
+              StatusIs(StatusCode::kOutOfRange));
+  EXPECT_THAT(Status(iree_vm_list_get_values(
+                  list, 0, 4, IREE_VM_VALUE_TYPE_I32,
+                  iree_make_byte_span(i32_values, sizeof(i32_values)))),
+              StatusIs(StatusCode::kInvalidArgument));
+
+  iree_vm_list_release(list);
+}
+
+// Tests bulk ref get/set with type checking.
+TEST_F(VMListTest, BulkRefs) {
+  iree_vm_list_t* list = nullptr;
+  IREE_ASSERT_OK(
+      iree_vm_list_create(iree_vm_make_ref_type_def(test_a_type()), 0,
+                          iree_allocator_system(), &list));
+
+  iree_vm_ref_t refs[3];
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(refs); ++i) {
+    refs[i] = MakeRef<A>((float)i);
+  }
+  IREE_ASSERT_OK(
+      iree_vm_list_push_refs_retain(list, IREE_ARRAYSIZE(refs), refs));
+  EXPECT_EQ(3, iree_vm_list_size(list));
+
+  iree_vm_ref_t out_refs[3] = {{0}};
+  IREE_ASSERT_OK(iree_vm_list_get_refs_retain(list, 0, IREE_ARRAYSIZE(out_refs),
+                                              out_refs));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(out_refs); ++i) {
+    EXPECT_TRUE(test_a_isa(out_refs[i]));
+    EXPECT_EQ(i, test_a_deref(out_refs[i])->data());
+    iree_vm_ref_release(&out_refs[i]);
+  }
+
+  // Mismatched types fail without changing the list.
+  iree_vm_ref_t mixed_refs[2] = {MakeRef<A>(10.0f), MakeRef<B>(11)};
+  EXPECT_THAT(Status(iree_vm_list_set_refs_retain(
+                  list, 0, IREE_ARRAYSIZE(mixed_refs), mixed_refs)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_THAT(Status(iree_vm_list_push_refs_retain(
+                  list, IREE_ARRAYSIZE(mixed_refs), mixed_refs)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(3, iree_vm_list_size(list));
+  IREE_ASSERT_OK(iree_vm_list_get_refs_retain(list, 0, 1, out_refs));
+  EXPECT_TRUE(iree_vm_ref_equal(&out_refs[0], &refs[0]));
+  iree_vm_ref_release(&out_refs[0]);
+
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(mixed_refs); ++i) {
+    iree_vm_ref_release(&mixed_refs[i]);
+  }
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(refs); ++i) {
+    iree_vm_ref_release(&refs[i]);
+  }
+  iree_vm_list_release(list);
+}
+
 // TODO(benvanik): test primitive variant get/set.
 
 // TODO(benvanik): test ref variant get/set.
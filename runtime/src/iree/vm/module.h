@@ -451,6 +451,18 @@ typedef struct iree_vm_module_t {
   // without first completing prior ones.
   iree_status_t(IREE_API_PTR* resume_call)(void* self, iree_vm_stack_t* stack,
                                            iree_byte_span_t call_results);
+
+  // Allocates module state data for a forked context from |parent_state|.
+  // The parent state has been fully initialized and must not be modified.
+  // Read-only data should be shared (by retaining references instead of
+  // copying) and mutable data should be copied such that changes made through
+  // either state are not visible to the other. Imports are resolved on the new
+  // state after it is forked and `__init` is not run.
+  // Optional: modules that do not implement forking will have a new state
+  // allocated and initialized as if registered with a new context.
+  iree_status_t(IREE_API_PTR* fork_state)(
+      void* self, iree_vm_module_state_t* parent_state,
+      iree_allocator_t allocator, iree_vm_module_state_t** out_module_state);
 } iree_vm_module_t;
 
 // Initializes the interface of a module handle.
@@ -304,6 +304,21 @@ static void IREE_API_PTR iree_vm_native_module_free_state(
   IREE_ASSERT_EQ(module_state, NULL);
 }
 
+static iree_status_t IREE_API_PTR iree_vm_native_module_fork_state(
+    void* self, iree_vm_module_state_t* parent_state,
+    iree_allocator_t allocator, iree_vm_module_state_t** out_module_state) {
+  iree_vm_native_module_t* module = (iree_vm_native_module_t*)self;
+  *out_module_state = NULL;
+  if (module->user_interface.fork_state) {
+    return module->user_interface.fork_state(module->self, parent_state,
+                                             allocator, out_module_state);
+  }
+  // Default to no state; modules with state that don't implement forking do
+  // not have this installed.
+  IREE_ASSERT_EQ(parent_state, NULL);
+  return iree_ok_status();
+}
+
 static iree_status_t IREE_API_PTR iree_vm_native_module_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
     const iree_vm_function_t* function,
@@ -519,6 +534,12 @@ IREE_API_EXPORT iree_status_t iree_vm_native_module_initialize(
       iree_vm_native_module_get_function_attr;
   module->base_interface.alloc_state = iree_vm_native_module_alloc_state;
   module->base_interface.free_state = iree_vm_native_module_free_state;
+  // Stateless modules can always be forked while modules with state must opt
+  // in to forking by implementing it.
+  if (module->user_interface.fork_state ||
+      !module->user_interface.alloc_state) {
+    module->base_interface.fork_state = iree_vm_native_module_fork_state;
+  }
   module->base_interface.resolve_import = iree_vm_native_module_resolve_import;
   module->base_interface.notify = iree_vm_native_module_notify;
   module->base_interface.begin_call = iree_vm_native_module_begin_call;
@@ -526,3 +547,26 @@ IREE_API_EXPORT iree_status_t iree_vm_native_module_initialize(
 
   return iree_ok_status();
 }
+
+IREE_API_EXPORT bool iree_vm_native_module_query_function_ptr(
+    const iree_vm_module_t* module, const iree_vm_function_t* function,
+    iree_vm_native_function_ptr_t* out_function_ptr, void** out_self) {
+  IREE_ASSERT_ARGUMENT(module);
+  IREE_ASSERT_ARGUMENT(function);
+  IREE_ASSERT_ARGUMENT(out_function_ptr);
+  IREE_ASSERT_ARGUMENT(out_self);
+  memset(out_function_ptr, 0, sizeof(*out_function_ptr));
+  *out_self = NULL;
+  if (module->begin_call != iree_vm_native_module_begin_call) return false;
+  const iree_vm_native_module_t* native_module =
+      (const iree_vm_native_module_t*)module->self;
+  if (native_module->user_interface.begin_call ||
+      function->module != module ||
+      function->linkage != IREE_VM_FUNCTION_LINKAGE_EXPORT ||
+      function->ordinal >= native_module->descriptor->function_count) {
+    return false;
+  }
+  *out_function_ptr = native_module->descriptor->functions[function->ordinal];
+  *out_self = native_module->self;
+  return true;
+}
@@ -146,6 +146,19 @@ IREE_API_EXPORT iree_status_t iree_vm_native_module_initialize(
     iree_vm_instance_t* instance, iree_allocator_t allocator,
     iree_vm_module_t* module);
 
+// Queries the shim and target function pointers of the exported |function| of
+// |module| that can be called directly instead of routing through begin_call.
+// The shim must be passed |out_self| as its module pointer.
+// Returns false if |module| is not a native module or overrides the default
+// call support, in which case callers must use begin_call.
+//
+// NOTE: callers issuing direct calls must enter a native stack frame for the
+// function prior to calling the shim and leave it when the call completes as
+// the default begin_call implementation would.
+IREE_API_EXPORT bool iree_vm_native_module_query_function_ptr(
+    const iree_vm_module_t* module, const iree_vm_function_t* function,
+    iree_vm_native_function_ptr_t* out_function_ptr, void** out_self);
+
 #ifdef __cplusplus
 }  // extern "C"
 #endif  // __cplusplus
@@ -9,6 +9,8 @@
 #include <vector>
 
 #include "iree/base/api.h"
+#include "iree/base/internal/wait_handle.h"
+#include "iree/base/loop_sync.h"
 #include "iree/testing/gtest.h"
 #include "iree/testing/status_matchers.h"
 #include "iree/vm/context.h"
@@ -21,6 +23,8 @@
 namespace iree {
 namespace {
 
+using ::iree::testing::status::StatusIs;
+
 // Test suite that uses module_a and module_b defined in native_module_test.h.
 // Both modules are put in a context and the module_b.entry function can be
 // executed with RunFunction.
@@ -59,12 +63,18 @@ class VMNativeModuleTest : public ::testing::Test {
 
   StatusOr<int32_t> RunFunction(iree_string_view_t function_name,
                                 int32_t arg0) {
+    return RunFunction(context_, function_name, arg0);
+  }
+
+  StatusOr<int32_t> RunFunction(iree_vm_context_t* context,
+                                iree_string_view_t function_name,
+                                int32_t arg0) {
     // Lookup the entry function. This can be cached in an application if
     // multiple calls will be made.
     iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(
         iree_vm_context_resolve_function(
-            context_, iree_make_cstring_view("module_b.entry"), &function),
+            context, iree_make_cstring_view("module_b.entry"), &function),
         "unable to resolve entry point");
 
     // Setup I/O lists and pass in the argument. The result list will be
@@ -83,7 +93,7 @@ class VMNativeModuleTest : public ::testing::Test {
 
     // Invoke the entry function to do our work. Runs synchronously.
     IREE_RETURN_IF_ERROR(
-        iree_vm_invoke(context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+        iree_vm_invoke(context, function, IREE_VM_INVOCATION_FLAG_NONE,
                        /*policy=*/nullptr, input_list.get(), output_list.get(),
                        iree_allocator_system()));
 
@@ -94,7 +104,7 @@ class VMNativeModuleTest : public ::testing::Test {
     return ret0_value.i32;
   }
 
- private:
+ protected:
   iree_vm_instance_t* instance_ = nullptr;
   iree_vm_context_t* context_ = nullptr;
 };
@@ -111,5 +121,225 @@ TEST_F(VMNativeModuleTest, Example) {
   ASSERT_EQ(v2, 8);
 }
 
+// Tests that forked contexts start from the parent state and that changes made
+// in either context after the fork are not visible to the other.
+TEST_F(VMNativeModuleTest, Fork) {
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v0, RunFunction(iree_make_cstring_view("module_b.entry"), 1));
+  ASSERT_EQ(v0, 1);
+
+  iree_vm_context_t* fork_context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_fork(context_, IREE_VM_CONTEXT_FLAG_NONE,
+                                      iree_allocator_system(), &fork_context));
+  EXPECT_EQ(iree_vm_context_module_count(fork_context),
+            iree_vm_context_module_count(context_));
+  EXPECT_NE(iree_vm_context_id(fork_context), iree_vm_context_id(context_));
+
+  // Imports must have been resolved in the fork and the counter carried over.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v1, RunFunction(fork_context,
+                              iree_make_cstring_view("module_b.entry"), 2));
+  ASSERT_EQ(v1, 4);
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v2, RunFunction(fork_context,
+                              iree_make_cstring_view("module_b.entry"), 3));
+  ASSERT_EQ(v2, 8);
+
+  // The parent continues from its own state.
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v3, RunFunction(iree_make_cstring_view("module_b.entry"), 2));
+  ASSERT_EQ(v3, 4);
+
+  // The fork may outlive the parent it was forked from.
+  iree_vm_context_release(context_);
+  context_ = nullptr;
+  IREE_ASSERT_OK_AND_ASSIGN(
+      int32_t v4, RunFunction(fork_context,
+                              iree_make_cstring_view("module_b.entry"), 1));
+  ASSERT_EQ(v4, 10);
+  iree_vm_context_release(fork_context);
+}
+
+// Tests that only frozen contexts can be forked.
+TEST_F(VMNativeModuleTest, ForkUnfrozen) {
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create(instance_, IREE_VM_CONTEXT_FLAG_NONE,
+                                        iree_allocator_system(), &context));
+  iree_vm_context_t* fork_context = nullptr;
+  EXPECT_THAT(Status(iree_vm_context_fork(context, IREE_VM_CONTEXT_FLAG_NONE,
+                                          iree_allocator_system(),
+                                          &fork_context)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  EXPECT_EQ(fork_context, nullptr);
+  IREE_ASSERT_OK(iree_vm_context_freeze(context));
+  IREE_ASSERT_OK(iree_vm_context_fork(context, IREE_VM_CONTEXT_FLAG_NONE,
+                                      iree_allocator_system(), &fork_context));
+  EXPECT_EQ(iree_vm_context_module_count(fork_context), 0);
+  iree_vm_context_release(fork_context);
+  iree_vm_context_release(context);
+}
+
+// Tests that a reusable invoker with a pre-sized stack matches the results of
+// the Example test above (module_b accumulates state across calls).
+TEST_F(VMNativeModuleTest, Invoker) {
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context_, IREE_SV("module_b.entry"), &function));
+  iree_vm_invoker_t* invoker = nullptr;
+  IREE_ASSERT_OK(iree_vm_invoker_create(
+      context_, function, IREE_VM_INVOCATION_FLAG_NONE,
+      /*stack_size=*/64 * 1024, iree_allocator_system(), &invoker));
+  const int32_t expected_values[3] = {1, 4, 8};
+  for (int32_t i = 0; i < 3; ++i) {
+    iree_vm_list_t* inputs = iree_vm_invoker_inputs(invoker);
+    IREE_ASSERT_OK(iree_vm_list_resize(inputs, 0));
+    auto arg0_value = iree_vm_value_make_i32(i + 1);
+    IREE_ASSERT_OK(iree_vm_list_push_value(inputs, &arg0_value));
+    IREE_ASSERT_OK(iree_vm_invoker_invoke(invoker, /*policy=*/nullptr));
+    iree_vm_list_t* outputs = iree_vm_invoker_outputs(invoker);
+    ASSERT_EQ(iree_vm_list_size(outputs), 1);
+    iree_vm_value_t ret0_value;
+    IREE_ASSERT_OK(iree_vm_list_get_value(outputs, 0, &ret0_value));
+    EXPECT_EQ(ret0_value.i32, expected_values[i]);
+  }
+  iree_vm_invoker_release(invoker);
+}
+
+// Tests that many invocations suspended on a wait can be multiplexed by a
+// single loop and all resume once the wait resolves.
+TEST(VMNativeModuleAsyncTest, MultiplexedWaits) {
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                         iree_allocator_system(), &instance));
+  iree_event_t event;
+  IREE_ASSERT_OK(iree_event_initialize(/*initial_state=*/false, &event));
+  iree_wait_source_t wait_source = iree_event_await(&event);
+  iree_vm_module_t* module_c = nullptr;
+  IREE_ASSERT_OK(module_c_create(instance, &wait_source,
+                                 iree_allocator_system(), &module_c));
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_CONCURRENT, 1, &module_c,
+      iree_allocator_system(), &context));
+  iree_vm_module_release(module_c);
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context, IREE_SV("module_c.wait"), &function));
+
+  iree_loop_sync_options_t options = {/*max_queue_depth=*/64,
+                                      /*max_wait_count=*/64};
+  iree_loop_sync_t* loop_sync = nullptr;
+  IREE_ASSERT_OK(
+      iree_loop_sync_allocate(options, iree_allocator_system(), &loop_sync));
+  iree_loop_sync_scope_t scope;
+  iree_loop_sync_scope_initialize(
+      loop_sync, +[](void* user_data, iree_status_t status) {
+        iree_status_ignore(status);
+      },
+      nullptr, &scope);
+  iree_loop_t loop = iree_loop_sync_scope(&scope);
+
+  // Begin all invocations; each will suspend on the unsignaled event.
+  static constexpr int kInvocationCount = 8;
+  struct Invocation {
+    iree_vm_async_invoke_state_t state;
+    bool completed = false;
+    int32_t result = -1;
+  };
+  std::vector<Invocation> invocations(kInvocationCount);
+  for (int i = 0; i < kInvocationCount; ++i) {
+    vm::ref<iree_vm_list_t> inputs;
+    IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                       iree_allocator_system(), &inputs));
+    auto arg0_value = iree_vm_value_make_i32(i);
+    IREE_ASSERT_OK(iree_vm_list_push_value(inputs.get(), &arg0_value));
+    vm::ref<iree_vm_list_t> outputs;
+    IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                       iree_allocator_system(), &outputs));
+    IREE_ASSERT_OK(iree_vm_async_invoke(
+        loop, &invocations[i].state, context, function,
+        IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr, inputs.get(),
+        outputs.get(), iree_allocator_system(),
+        +[](void* user_data, iree_loop_t loop, iree_status_t status,
+            iree_vm_list_t* outputs) {
+          auto* invocation = reinterpret_cast<Invocation*>(user_data);
+          invocation->completed = true;
+          if (iree_status_is_ok(status)) {
+            iree_vm_value_t ret0_value;
+            status = iree_vm_list_get_value(outputs, 0, &ret0_value);
+            invocation->result = ret0_value.i32;
+          }
+          iree_vm_list_release(outputs);
+          return status;
+        },
+        &invocations[i]));
+  }
+
+  // Signal the event from a loop operation that runs after all invocations
+  // have begun so that they all observe the wait.
+  struct SignalState {
+    iree_event_t* event;
+    std::vector<Invocation>* invocations;
+    bool any_completed = false;
+  } signal_state = {&event, &invocations};
+  IREE_ASSERT_OK(iree_loop_call(
+      loop, IREE_LOOP_PRIORITY_DEFAULT,
+      +[](void* user_data, iree_loop_t loop, iree_status_t status) {
+        auto* signal_state = reinterpret_cast<SignalState*>(user_data);
+        for (auto& invocation : *signal_state->invocations) {
+          signal_state->any_completed |= invocation.completed;
+        }
+        iree_event_set(signal_state->event);
+        return status;
+      },
+      &signal_state));
+  IREE_ASSERT_OK(iree_loop_drain(loop, iree_infinite_timeout()));
+
+  EXPECT_FALSE(signal_state.any_completed);
+  for (int i = 0; i < kInvocationCount; ++i) {
+    EXPECT_TRUE(invocations[i].completed);
+    EXPECT_EQ(invocations[i].result, i);
+  }
+
+  iree_loop_sync_scope_deinitialize(&scope);
+  iree_loop_sync_free(loop_sync);
+  iree_vm_context_release(context);
+  iree_event_deinitialize(&event);
+  iree_vm_instance_release(instance);
+}
+
+TEST(VMNativeModuleQueryTest, QueryFunctionPtr) {
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                         iree_allocator_system(), &instance));
+  iree_vm_module_t* module_a = nullptr;
+  IREE_ASSERT_OK(module_a_create(instance, iree_allocator_system(), &module_a));
+  iree_vm_module_t* module_b = nullptr;
+  IREE_ASSERT_OK(module_b_create(instance, iree_allocator_system(), &module_b));
+
+  // module_a uses the default call support and can be called directly.
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_module_lookup_function_by_name(
+      module_a, IREE_VM_FUNCTION_LINKAGE_EXPORT, IREE_SV("sub_1"), &function));
+  iree_vm_native_function_ptr_t function_ptr;
+  void* self = nullptr;
+  EXPECT_TRUE(iree_vm_native_module_query_function_ptr(
+      module_a, &function, &function_ptr, &self));
+  EXPECT_EQ(function_ptr.shim,
+            (iree_vm_native_function_shim_t)call_shim_i32_i32);
+  EXPECT_EQ(function_ptr.target,
+            (iree_vm_native_function_target_t)module_a_sub_1);
+  EXPECT_NE(self, nullptr);
+
+  // Functions must belong to the queried module.
+  EXPECT_FALSE(iree_vm_native_module_query_function_ptr(
+      module_b, &function, &function_ptr, &self));
+  EXPECT_EQ(function_ptr.shim, nullptr);
+
+  iree_vm_module_release(module_a);
+  iree_vm_module_release(module_b);
+  iree_vm_instance_release(instance);
+}
+
 }  // namespace
 }  // namespace iree
@@ -196,6 +196,23 @@ module_b_free_state(void* self, iree_vm_module_state_t* module_state) {
   iree_allocator_free(state->allocator, state);
 }
 
+// Forks per-context state for a context forked from a parent context. Imports
+// are resolved again on the new state after forking and user data is copied.
+static iree_status_t IREE_API_PTR
+module_b_fork_state(void* self, iree_vm_module_state_t* parent_state,
+                    iree_allocator_t allocator,
+                    iree_vm_module_state_t** out_module_state) {
+  module_b_state_t* parent = (module_b_state_t*)parent_state;
+  module_b_state_t* state = NULL;
+  IREE_RETURN_IF_ERROR(
+      iree_allocator_malloc(allocator, sizeof(*state), (void**)&state));
+  memset(state, 0, sizeof(*state));
+  state->allocator = allocator;
+  state->counter = parent->counter;
+  *out_module_state = (iree_vm_module_state_t*)state;
+  return iree_ok_status();
+}
+
 // Called once per import function so the module can store the function ref.
 static iree_status_t IREE_API_PTR module_b_resolve_import(
     void* self, iree_vm_module_state_t* module_state, iree_host_size_t ordinal,
@@ -310,7 +327,84 @@ static iree_status_t module_b_create(iree_vm_instance_t* instance,
   interface.destroy = module_b_destroy;
   interface.alloc_state = module_b_alloc_state;
   interface.free_state = module_b_free_state;
+  interface.fork_state = module_b_fork_state;
   interface.resolve_import = module_b_resolve_import;
   return iree_vm_native_module_create(&interface, &module_b_descriptor_,
                                       instance, allocator, out_module);
 }
+
+//===----------------------------------------------------------------------===//
+// module_c
+//===----------------------------------------------------------------------===//
+// A stateless module exporting a function that suspends the calling invocation
+// until a host-provided wait source resolves. This is the same coroutine
+// pattern used by HAL fence waits: the first call enters a wait frame and
+// defers to the scheduler and the function is resumed once the wait resolves.
+
+// PC for module_c.wait.
+enum module_c_wait_pc_e {
+  // Initial entry point that enters the wait frame and yields.
+  MODULE_C_WAIT_PC_BEGIN = 0,
+  // Resume entry point after the scheduler wait has resolved.
+  MODULE_C_WAIT_PC_RESUME,
+};
+
+// vm.import private @module_c.wait(%arg0 : i32) -> i32
+// Returns |arg0| after the wait source has resolved. Arguments are only
+// available on entry so the result is stored before yielding.
+static iree_status_t module_c_wait(iree_vm_stack_t* stack,
+                                   iree_vm_native_function_flags_t flags,
+                                   iree_byte_span_t args_storage,
+                                   iree_byte_span_t rets_storage,
+                                   iree_vm_native_function_target_t target_fn,
+                                   void* module, void* module_state) {
+  const iree_wait_source_t* wait_source = (const iree_wait_source_t*)module;
+  iree_vm_stack_frame_t* current_frame = iree_vm_stack_top(stack);
+  if (current_frame->pc == MODULE_C_WAIT_PC_BEGIN) {
+    memcpy(rets_storage.data, args_storage.data, sizeof(int32_t));
+    current_frame->pc = MODULE_C_WAIT_PC_RESUME;
+    iree_vm_wait_frame_t* wait_frame = NULL;
+    IREE_RETURN_IF_ERROR(iree_vm_stack_wait_enter(
+        stack, IREE_VM_WAIT_ALL, 1, iree_infinite_timeout(), 0, &wait_frame));
+    wait_frame->wait_sources[0] = *wait_source;
+    return iree_status_from_code(IREE_STATUS_DEFERRED);
+  }
+  iree_vm_wait_result_t wait_result;
+  IREE_RETURN_IF_ERROR(iree_vm_stack_wait_leave(stack, &wait_result));
+  return wait_result.status;
+}
+
+static const iree_vm_native_export_descriptor_t module_c_exports_[] = {
+    {IREE_SV("wait"), IREE_SV("0i_i"), 0, NULL},
+};
+static const iree_vm_native_function_ptr_t module_c_funcs_[] = {
+    {module_c_wait, NULL},
+};
+static_assert(IREE_ARRAYSIZE(module_c_funcs_) ==
+                  IREE_ARRAYSIZE(module_c_exports_),
+              "function pointer table must be 1:1 with exports");
+static const iree_vm_native_module_descriptor_t module_c_descriptor_ = {
+    /*name=*/IREE_SV("module_c"),
+    /*version=*/0,
+    /*attr_count=*/0,
+    /*attrs=*/NULL,
+    /*dependency_count=*/0,
+    /*dependencies=*/NULL,
+    /*import_count=*/0,
+    /*imports=*/NULL,
+    /*export_count=*/IREE_ARRAYSIZE(module_c_exports_),
+    /*exports=*/module_c_exports_,
+    /*function_count=*/IREE_ARRAYSIZE(module_c_funcs_),
+    /*functions=*/module_c_funcs_,
+};
+
+// Creates module_c waiting on |wait_source|, which must outlive the module.
+static iree_status_t module_c_create(iree_vm_instance_t* instance,
+                                     iree_wait_source_t* wait_source,
+                                     iree_allocator_t allocator,
+                                     iree_vm_module_t** out_module) {
+  iree_vm_module_t interface;
+  IREE_RETURN_IF_ERROR(iree_vm_module_initialize(&interface, wait_source));
+  return iree_vm_native_module_create(&interface, &module_c_descriptor_,
+                                      instance, allocator, out_module);
+}
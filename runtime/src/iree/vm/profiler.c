@@ -0,0 +1,316 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/vm/profiler.h"
+
+#include <inttypes.h>
+#include <string.h>
+
+#include "iree/base/internal/atomics.h"
+#include "iree/base/internal/synchronization.h"
+#include "iree/base/internal/threading.h"
+
+// Current sampling epoch advanced by the active profiler each interval.
+static iree_atomic_int32_t iree_vm_sampling_epoch = IREE_ATOMIC_VAR_INIT(0);
+
+// The active profiler, if any. Samples are only recorded while non-NULL.
+static iree_atomic_intptr_t iree_vm_sampling_active_profiler =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// Total number of threads currently recording a sample. Used by stop to wait
+// for in-flight recordings to finish with the profiler.
+static iree_atomic_int32_t iree_vm_sampling_recorder_count =
+    IREE_ATOMIC_VAR_INIT(0);
+
+// A unique sampled stack and the number of times it was recorded.
+// The stack key is stored in the profiler key storage.
+typedef struct iree_vm_sampling_profiler_entry_t {
+  uint64_t hash;
+  iree_host_size_t key_offset;
+  iree_host_size_t key_length;
+  uint64_t count;
+} iree_vm_sampling_profiler_entry_t;
+
+struct iree_vm_sampling_profiler_t {
+  iree_atomic_ref_count_t ref_count;
+  iree_allocator_t host_allocator;
+  iree_duration_t interval;
+  iree_vm_sampling_profiler_flags_t flags;
+
+  // Sampling thread advancing the epoch while active; NULL when stopped.
+  iree_thread_t* thread;
+  // Set to request the sampling thread exit.
+  iree_atomic_int32_t stop_requested;
+  // Posted when stop is requested to wake the sampling thread.
+  iree_notification_t stop_notification;
+
+  // Guards all sample storage.
+  iree_slim_mutex_t mutex;
+  // Scratch builder used to format stacks while recording.
+  iree_string_builder_t scratch_builder IREE_GUARDED_BY(mutex);
+  // Concatenated keys of all entries.
+  iree_string_builder_t key_storage IREE_GUARDED_BY(mutex);
+  // Unique sampled stacks.
+  iree_host_size_t entry_count IREE_GUARDED_BY(mutex);
+  iree_host_size_t entry_capacity IREE_GUARDED_BY(mutex);
+  iree_vm_sampling_profiler_entry_t* entries IREE_GUARDED_BY(mutex);
+  // Total samples recorded across all entries.
+  uint64_t sample_count IREE_GUARDED_BY(mutex);
+};
+
+IREE_API_EXPORT iree_status_t iree_vm_sampling_profiler_create(
+    iree_duration_t interval, iree_vm_sampling_profiler_flags_t flags,
+    iree_allocator_t host_allocator,
+    iree_vm_sampling_profiler_t** out_profiler) {
+  IREE_ASSERT_ARGUMENT(out_profiler);
+  *out_profiler = NULL;
+  if (interval <= 0) {
+    return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                            "sampling interval must be positive");
+  }
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  iree_vm_sampling_profiler_t* profiler = NULL;
+  IREE_RETURN_AND_END_ZONE_IF_ERROR(
+      z0, iree_allocator_malloc(host_allocator, sizeof(*profiler),
+                                (void**)&profiler));
+  memset(profiler, 0, sizeof(*profiler));
+  iree_atomic_ref_count_init(&profiler->ref_count);
+  profiler->host_allocator = host_allocator;
+  profiler->interval = interval;
+  profiler->flags = flags;
+  iree_notification_initialize(&profiler->stop_notification);
+  iree_slim_mutex_initialize(&profiler->mutex);
+  iree_string_builder_initialize(host_allocator, &profiler->scratch_builder);
+  iree_string_builder_initialize(host_allocator, &profiler->key_storage);
+
+  *out_profiler = profiler;
+  IREE_TRACE_ZONE_END(z0);
+  return iree_ok_status();
+}
+
+static void iree_vm_sampling_profiler_destroy(
+    iree_vm_sampling_profiler_t* profiler) {
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_vm_sampling_profiler_stop(profiler);
+  iree_allocator_t host_allocator = profiler->host_allocator;
+  iree_allocator_free(host_allocator, profiler->entries);
+  iree_string_builder_deinitialize(&profiler->key_storage);
+  iree_string_builder_deinitialize(&profiler->scratch_builder);
+  iree_slim_mutex_deinitialize(&profiler->mutex);
+  iree_notification_deinitialize(&profiler->stop_notification);
+  iree_allocator_free(host_allocator, profiler);
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT void iree_vm_sampling_profiler_retain(
+    iree_vm_sampling_profiler_t* profiler) {
+  if (IREE_LIKELY(profiler)) {
+    iree_atomic_ref_count_inc(&profiler->ref_count);
+  }
+}
+
+IREE_API_EXPORT void iree_vm_sampling_profiler_release(
+    iree_vm_sampling_profiler_t* profiler) {
+  if (IREE_LIKELY(profiler) &&
+      iree_atomic_ref_count_dec(&profiler->ref_count) == 1) {
+    iree_vm_sampling_profiler_destroy(profiler);
+  }
+}
+
+static bool iree_vm_sampling_profiler_is_stop_requested(void* arg) {
+  iree_vm_sampling_profiler_t* profiler = (iree_vm_sampling_profiler_t*)arg;
+  return iree_atomic_load_int32(&profiler->stop_requested,
+                                iree_memory_order_acquire) != 0;
+}
+
+static int iree_vm_sampling_profiler_thread_main(void* entry_arg) {
+  iree_vm_sampling_profiler_t* profiler =
+      (iree_vm_sampling_profiler_t*)entry_arg;
+  while (!iree_notification_await(&profiler->stop_notification,
+                                  iree_vm_sampling_profiler_is_stop_requested,
+                                  profiler,
+                                  iree_make_timeout_ns(profiler->interval))) {
+    iree_atomic_fetch_add_int32(&iree_vm_sampling_epoch, 1,
+                                iree_memory_order_relaxed);
+  }
+  return 0;
+}
+
+IREE_API_EXPORT iree_status_t
+iree_vm_sampling_profiler_start(iree_vm_sampling_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+#if IREE_VM_SAMPLING_PROFILER_ENABLE
+  IREE_TRACE_ZONE_BEGIN(z0);
+  if (profiler->thread) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_ok_status();  // already active
+  }
+
+  intptr_t expected = 0;
+  if (!iree_atomic_compare_exchange_strong_intptr(
+          &iree_vm_sampling_active_profiler, &expected, (intptr_t)profiler,
+          iree_memory_order_seq_cst, iree_memory_order_seq_cst)) {
+    IREE_TRACE_ZONE_END(z0);
+    return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                            "another VM sampling profiler is already active");
+  }
+
+  iree_atomic_store_int32(&profiler->stop_requested, 0,
+                          iree_memory_order_release);
+  iree_thread_create_params_t params;
+  memset(&params, 0, sizeof(params));
+  params.name = IREE_SV("iree-vm-sampler");
+  iree_status_t status =
+      iree_thread_create(iree_vm_sampling_profiler_thread_main, profiler,
+                         params, profiler->host_allocator, &profiler->thread);
+  if (!iree_status_is_ok(status)) {
+    iree_atomic_store_intptr(&iree_vm_sampling_active_profiler, 0,
+                             iree_memory_order_seq_cst);
+  }
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+#else
+  return iree_make_status(IREE_STATUS_UNAVAILABLE,
+                          "VM sampling profiler disabled in this build "
+                          "(IREE_VM_SAMPLING_PROFILER_ENABLE=0)");
+#endif  // IREE_VM_SAMPLING_PROFILER_ENABLE
+}
+
+IREE_API_EXPORT void iree_vm_sampling_profiler_stop(
+    iree_vm_sampling_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  if (!profiler->thread) return;
+  IREE_TRACE_ZONE_BEGIN(z0);
+
+  // Stop the sampling thread; releasing joins it.
+  iree_atomic_store_int32(&profiler->stop_requested, 1,
+                          iree_memory_order_release);
+  iree_notification_post(&profiler->stop_notification, IREE_ALL_WAITERS);
+  iree_thread_release(profiler->thread);
+  profiler->thread = NULL;
+
+  // Detach the profiler and wait for any recordings that may have observed it
+  // before it was detached.
+  iree_atomic_store_intptr(&iree_vm_sampling_active_profiler, 0,
+                           iree_memory_order_seq_cst);
+  while (iree_atomic_load_int32(&iree_vm_sampling_recorder_count,
+                                iree_memory_order_seq_cst) != 0) {
+    iree_thread_yield();
+  }
+
+  IREE_TRACE_ZONE_END(z0);
+}
+
+IREE_API_EXPORT uint64_t
+iree_vm_sampling_profiler_sample_count(iree_vm_sampling_profiler_t* profiler) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  iree_slim_mutex_lock(&profiler->mutex);
+  uint64_t sample_count = profiler->sample_count;
+  iree_slim_mutex_unlock(&profiler->mutex);
+  return sample_count;
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_sampling_profiler_format_folded(
+    iree_vm_sampling_profiler_t* profiler, iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(profiler);
+  IREE_ASSERT_ARGUMENT(builder);
+  IREE_TRACE_ZONE_BEGIN(z0);
+  iree_slim_mutex_lock(&profiler->mutex);
+  iree_status_t status = iree_ok_status();
+  const char* keys = iree_string_builder_buffer(&profiler->key_storage);
+  for (iree_host_size_t i = 0;
+       i < profiler->entry_count && iree_status_is_ok(status); ++i) {
+    const iree_vm_sampling_profiler_entry_t* entry = &profiler->entries[i];
+    status = iree_string_builder_append_format(
+        builder, "%.*s %" PRIu64 "\n", (int)entry->key_length,
+        keys + entry->key_offset, entry->count);
+  }
+  iree_slim_mutex_unlock(&profiler->mutex);
+  IREE_TRACE_ZONE_END(z0);
+  return status;
+}
+
+IREE_API_EXPORT int32_t iree_vm_sampling_profiler_epoch(void) {
+  return iree_atomic_load_int32(&iree_vm_sampling_epoch,
+                                iree_memory_order_relaxed);
+}
+
+// FNV-1a hash of |key|.
+static uint64_t iree_vm_sampling_profiler_hash(iree_string_view_t key) {
+  uint64_t hash = 0xCBF29CE484222325ull;
+  for (iree_host_size_t i = 0; i < key.size; ++i) {
+    hash = (hash ^ (uint8_t)key.data[i]) * 0x100000001B3ull;
+  }
+  return hash;
+}
+
+// Increments the count of the entry matching |key|, adding one if needed.
+// Must be called with the profiler mutex held.
+static iree_status_t iree_vm_sampling_profiler_insert(
+    iree_vm_sampling_profiler_t* profiler, iree_string_view_t key) {
+  // Linear scan: the number of unique stacks is small and samples are rare.
+  const uint64_t hash = iree_vm_sampling_profiler_hash(key);
+  const char* keys = iree_string_builder_buffer(&profiler->key_storage);
+  for (iree_host_size_t i = 0; i < profiler->entry_count; ++i) {
+    iree_vm_sampling_profiler_entry_t* entry = &profiler->entries[i];
+    if (entry->hash == hash && entry->key_length == key.size &&
+        memcmp(keys + entry->key_offset, key.data, key.size) == 0) {
+      ++entry->count;
+      return iree_ok_status();
+    }
+  }
+
+  if (profiler->entry_count == profiler->entry_capacity) {
+    iree_host_size_t new_capacity = iree_max(16, profiler->entry_capacity * 2);
+    IREE_RETURN_IF_ERROR(iree_allocator_realloc(
+        profiler->host_allocator, new_capacity * sizeof(*profiler->entries),
+        (void**)&profiler->entries));
+    profiler->entry_capacity = new_capacity;
+  }
+  iree_host_size_t key_offset =
+      iree_string_builder_size(&profiler->key_storage);
+  IREE_RETURN_IF_ERROR(
+      iree_string_builder_append_string(&profiler->key_storage, key));
+  iree_vm_sampling_profiler_entry_t* entry =
+      &profiler->entries[profiler->entry_count++];
+  entry->hash = hash;
+  entry->key_offset = key_offset;
+  entry->key_length = key.size;
+  entry->count = 1;
+  return iree_ok_status();
+}
+
+IREE_API_EXPORT void iree_vm_sampling_profiler_record(iree_vm_stack_t* stack) {
+  iree_atomic_fetch_add_int32(&iree_vm_sampling_recorder_count, 1,
+                              iree_memory_order_seq_cst);
+  iree_vm_sampling_profiler_t* profiler =
+      (iree_vm_sampling_profiler_t*)iree_atomic_load_intptr(
+          &iree_vm_sampling_active_profiler, iree_memory_order_seq_cst);
+  if (profiler) {
+    iree_slim_mutex_lock(&profiler->mutex);
+    iree_string_builder_reset(&profiler->scratch_builder);
+    iree_status_t status = iree_vm_stack_format_folded(
+        stack,
+        iree_all_bits_set(profiler->flags,
+                          IREE_VM_SAMPLING_PROFILER_FLAG_SOURCE_LOCATIONS),
+        &profiler->scratch_builder);
+    if (iree_status_is_ok(status) &&
+        iree_string_builder_size(&profiler->scratch_builder) > 0) {
+      status = iree_vm_sampling_profiler_insert(
+          profiler, iree_make_string_view(
+                        iree_string_builder_buffer(&profiler->scratch_builder),
+                        iree_string_builder_size(&profiler->scratch_builder)));
+      if (iree_status_is_ok(status)) ++profiler->sample_count;
+    }
+    // Sampling is best-effort and failures (such as allocation failures) drop
+    // the sample instead of failing the invocation.
+    iree_status_ignore(status);
+    iree_slim_mutex_unlock(&profiler->mutex);
+  }
+  iree_atomic_fetch_sub_int32(&iree_vm_sampling_recorder_count, 1,
+                              iree_memory_order_seq_cst);
+}
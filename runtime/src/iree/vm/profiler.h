@@ -0,0 +1,101 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+// See iree/base/api.h for documentation on the API conventions used.
+
+#ifndef IREE_VM_PROFILER_H_
+#define IREE_VM_PROFILER_H_
+
+#include <stdint.h>
+
+#include "iree/base/api.h"
+#include "iree/vm/stack.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif  // __cplusplus
+
+//===----------------------------------------------------------------------===//
+// iree_vm_sampling_profiler_t
+//===----------------------------------------------------------------------===//
+
+enum iree_vm_sampling_profiler_flag_bits_t {
+  IREE_VM_SAMPLING_PROFILER_FLAG_NONE = 0u,
+  // Suffixes each sampled frame with its source location when the module has
+  // debug information available.
+  IREE_VM_SAMPLING_PROFILER_FLAG_SOURCE_LOCATIONS = 1u << 0,
+};
+typedef uint32_t iree_vm_sampling_profiler_flags_t;
+
+// A lightweight sampling profiler for VM execution.
+// Provides visibility into host-side VM time in builds without tracing.
+//
+// While active a background thread advances a global sampling epoch once per
+// interval. Every VM stack checks the epoch when entering a function and if it
+// has changed since the stack last recorded a sample the full stack (including
+// the newly entered function) is recorded. Samples are taken at function entry
+// and are thus biased towards call-heavy code: long-running loops that make no
+// calls are attributed to the next function they call. Stacks that are blocked
+// (such as waiting on a fence) record no samples.
+//
+// Recorded samples are aggregated by unique stack and can be written in the
+// folded stack format (`caller;callee count` per line) consumed by flame graph
+// tools (flamegraph.pl, speedscope, etc) and convertible to pprof.
+//
+// Only one profiler may be active in a process at a time.
+// Thread-safe.
+typedef struct iree_vm_sampling_profiler_t iree_vm_sampling_profiler_t;
+
+// Creates a sampling profiler that samples once per |interval| while active.
+IREE_API_EXPORT iree_status_t iree_vm_sampling_profiler_create(
+    iree_duration_t interval, iree_vm_sampling_profiler_flags_t flags,
+    iree_allocator_t host_allocator,
+    iree_vm_sampling_profiler_t** out_profiler);
+
+// Retains the given |profiler| for the caller.
+IREE_API_EXPORT void iree_vm_sampling_profiler_retain(
+    iree_vm_sampling_profiler_t* profiler);
+
+// Releases the given |profiler| from the caller. Stops the profiler if active.
+IREE_API_EXPORT void iree_vm_sampling_profiler_release(
+    iree_vm_sampling_profiler_t* profiler);
+
+// Starts sampling with |profiler|.
+// Returns IREE_STATUS_FAILED_PRECONDITION if another profiler is active and
+// IREE_STATUS_UNAVAILABLE if the profiler is disabled in the build.
+IREE_API_EXPORT iree_status_t
+iree_vm_sampling_profiler_start(iree_vm_sampling_profiler_t* profiler);
+
+// Stops sampling with |profiler|. Recorded samples are retained and sampling
+// may be started again to accumulate additional samples.
+IREE_API_EXPORT void iree_vm_sampling_profiler_stop(
+    iree_vm_sampling_profiler_t* profiler);
+
+// Returns the total number of samples recorded by |profiler|.
+IREE_API_EXPORT uint64_t
+iree_vm_sampling_profiler_sample_count(iree_vm_sampling_profiler_t* profiler);
+
+// Appends all recorded samples to |builder| in the folded stack format with one
+// `frame;frame;frame count` line per unique stack.
+IREE_API_EXPORT iree_status_t iree_vm_sampling_profiler_format_folded(
+    iree_vm_sampling_profiler_t* profiler, iree_string_builder_t* builder);
+
+//===----------------------------------------------------------------------===//
+// Internal stack hooks
+//===----------------------------------------------------------------------===//
+
+// Returns the current sampling epoch. Stacks compare this against the epoch at
+// which they last recorded a sample to decide whether to record another.
+IREE_API_EXPORT int32_t iree_vm_sampling_profiler_epoch(void);
+
+// Records a sample of |stack| with the active profiler, if any.
+IREE_API_EXPORT void iree_vm_sampling_profiler_record(iree_vm_stack_t* stack);
+
+#ifdef __cplusplus
+}  // extern "C"
+#endif  // __cplusplus
+
+#endif  // IREE_VM_PROFILER_H_
@@ -0,0 +1,134 @@
+// Copyright 2024 The IREE Authors
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+
+#include "iree/vm/profiler.h"
+
+#include <string>
+#include <vector>
+
+#include "iree/base/api.h"
+#include "iree/testing/gtest.h"
+#include "iree/testing/status_matchers.h"
+#include "iree/vm/context.h"
+#include "iree/vm/instance.h"
+#include "iree/vm/invocation.h"
+#include "iree/vm/list.h"
+#include "iree/vm/native_module_test.h"
+#include "iree/vm/value.h"
+
+namespace iree {
+namespace {
+
+using ::iree::testing::status::StatusIs;
+
+// 1ms sampling interval.
+static constexpr iree_duration_t kInterval = 1000000;
+
+TEST(VMSamplingProfilerTest, InvalidInterval) {
+  iree_vm_sampling_profiler_t* profiler = nullptr;
+  EXPECT_THAT(Status(iree_vm_sampling_profiler_create(
+                  0, IREE_VM_SAMPLING_PROFILER_FLAG_NONE,
+                  iree_allocator_system(), &profiler)),
+              StatusIs(StatusCode::kInvalidArgument));
+  EXPECT_EQ(profiler, nullptr);
+}
+
+TEST(VMSamplingProfilerTest, SingleActiveProfiler) {
+  iree_vm_sampling_profiler_t* profiler_a = nullptr;
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_create(
+      kInterval, IREE_VM_SAMPLING_PROFILER_FLAG_NONE,
+      iree_allocator_system(), &profiler_a));
+  iree_vm_sampling_profiler_t* profiler_b = nullptr;
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_create(
+      kInterval, IREE_VM_SAMPLING_PROFILER_FLAG_NONE,
+      iree_allocator_system(), &profiler_b));
+
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_start(profiler_a));
+  EXPECT_THAT(Status(iree_vm_sampling_profiler_start(profiler_b)),
+              StatusIs(StatusCode::kFailedPrecondition));
+  iree_vm_sampling_profiler_stop(profiler_a);
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_start(profiler_b));
+
+  iree_vm_sampling_profiler_release(profiler_a);
+  iree_vm_sampling_profiler_release(profiler_b);  // stops
+}
+
+// Tests that calls made while the profiler is active are sampled with their
+// full stacks.
+TEST(VMSamplingProfilerTest, SampleNativeCalls) {
+  iree_vm_instance_t* instance = nullptr;
+  IREE_ASSERT_OK(iree_vm_instance_create(IREE_VM_TYPE_CAPACITY_DEFAULT,
+                                         iree_allocator_system(), &instance));
+  iree_vm_module_t* module_a = nullptr;
+  IREE_ASSERT_OK(module_a_create(instance, iree_allocator_system(), &module_a));
+  iree_vm_module_t* module_b = nullptr;
+  IREE_ASSERT_OK(module_b_create(instance, iree_allocator_system(), &module_b));
+  std::vector<iree_vm_module_t*> modules = {module_a, module_b};
+  iree_vm_context_t* context = nullptr;
+  IREE_ASSERT_OK(iree_vm_context_create_with_modules(
+      instance, IREE_VM_CONTEXT_FLAG_NONE, modules.size(), modules.data(),
+      iree_allocator_system(), &context));
+  iree_vm_module_release(module_a);
+  iree_vm_module_release(module_b);
+  iree_vm_function_t function;
+  IREE_ASSERT_OK(iree_vm_context_resolve_function(
+      context, IREE_SV("module_b.entry"), &function));
+
+  iree_vm_sampling_profiler_t* profiler = nullptr;
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_create(
+      kInterval, IREE_VM_SAMPLING_PROFILER_FLAG_NONE,
+      iree_allocator_system(), &profiler));
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_start(profiler));
+
+  // Call until a few samples have been recorded (or we give up).
+  vm::ref<iree_vm_list_t> inputs;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &inputs));
+  auto arg0_value = iree_vm_value_make_i32(0);
+  IREE_ASSERT_OK(iree_vm_list_push_value(inputs.get(), &arg0_value));
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_ASSERT_OK(iree_vm_list_create(iree_vm_make_undefined_type_def(), 1,
+                                     iree_allocator_system(), &outputs));
+  iree_time_t deadline_ns = iree_time_now() + 10000 * kInterval;
+  while (iree_vm_sampling_profiler_sample_count(profiler) < 4 &&
+         iree_time_now() < deadline_ns) {
+    IREE_ASSERT_OK(iree_vm_invoke(context, function,
+                                  IREE_VM_INVOCATION_FLAG_NONE,
+                                  /*policy=*/nullptr, inputs.get(),
+                                  outputs.get(), iree_allocator_system()));
+  }
+  iree_vm_sampling_profiler_stop(profiler);
+  EXPECT_GE(iree_vm_sampling_profiler_sample_count(profiler), 4u);
+
+  // Every sample is rooted at the entry function and may be within either of
+  // the imported functions it calls.
+  iree_string_builder_t builder;
+  iree_string_builder_initialize(iree_allocator_system(), &builder);
+  IREE_ASSERT_OK(iree_vm_sampling_profiler_format_folded(profiler, &builder));
+  std::string folded(iree_string_builder_buffer(&builder),
+                     iree_string_builder_size(&builder));
+  iree_string_builder_deinitialize(&builder);
+  ASSERT_FALSE(folded.empty());
+  size_t line_start = 0;
+  while (line_start < folded.size()) {
+    size_t line_end = folded.find('\n', line_start);
+    ASSERT_NE(line_end, std::string::npos);
+    std::string line = folded.substr(line_start, line_end - line_start);
+    std::string stack = line.substr(0, line.rfind(' '));
+    EXPECT_TRUE(stack == "module_b.entry" ||
+                stack == "module_b.entry;module_a.add_1" ||
+                stack == "module_b.entry;module_a.sub_1")
+        << line;
+    line_start = line_end + 1;
+  }
+
+  iree_vm_sampling_profiler_release(profiler);
+  iree_vm_context_release(context);
+  iree_vm_instance_release(instance);
+}
+
+}  // namespace
+}  // namespace iree
@@ -220,6 +220,46 @@ IREE_API_EXPORT void iree_vm_ref_release(iree_vm_ref_t* ref) {
   memset(ref, 0, sizeof(*ref));
 }
 
+IREE_API_EXPORT void iree_vm_ref_release_range(iree_vm_ref_t* refs,
+                                              iree_host_size_t count) {
+  IREE_VM_REF_ASSERT(!count || refs);
+  iree_host_size_t i = 0;
+  while (i < count) {
+    iree_vm_ref_t ref = refs[i];
+    if (ref.type == IREE_VM_REF_TYPE_NULL || ref.ptr == NULL) {
+      ++i;
+      continue;
+    }
+
+    // Coalesce adjacent references to the same object so that they are
+    // dropped with a single atomic operation. Frames and lists commonly hold
+    // several references to hot objects (devices, executables, etc) and this
+    // avoids bouncing the cache line of the counter for each of them.
+    iree_host_size_t run_end = i + 1;
+    while (run_end < count && refs[run_end].ptr == ref.ptr &&
+           refs[run_end].type == ref.type) {
+      ++run_end;
+    }
+    int32_t run_count = (int32_t)(run_end - i);
+    memset(&refs[i], 0, run_count * sizeof(*refs));
+    i = run_end;
+
+    iree_vm_ref_trace("RELEASE RANGE", &ref);
+    volatile iree_atomic_ref_count_t* counter =
+        iree_vm_get_ref_counter_ptr(&ref);
+    if (iree_atomic_fetch_sub_int32(counter, run_count,
+                                    iree_memory_order_acq_rel) == run_count) {
+      const iree_vm_ref_type_descriptor_t* descriptor =
+          iree_vm_ref_type_descriptor(ref.type);
+      if (descriptor->destroy) {
+        // NOTE: this makes us not re-entrant, but I think that's OK.
+        iree_vm_ref_trace("DESTROY", &ref);
+        descriptor->destroy(ref.ptr);
+      }
+    }
+  }
+}
+
 IREE_API_EXPORT void iree_vm_ref_assign(iree_vm_ref_t* ref,
                                         iree_vm_ref_t* out_ref) {
   IREE_VM_REF_ASSERT(ref);
@@ -226,6 +226,12 @@ IREE_API_EXPORT iree_status_t iree_vm_ref_retain_or_move_checked(
 // Releases the reference-counted pointer |ref|, possibly freeing it.
 IREE_API_EXPORT void iree_vm_ref_release(iree_vm_ref_t* ref);
 
+// Releases |count| references starting at |refs| and resets them to null.
+// Equivalent to calling iree_vm_ref_release on each element but adjacent
+// references to the same object are released with a single atomic operation.
+IREE_API_EXPORT void iree_vm_ref_release_range(iree_vm_ref_t* refs,
+                                              iree_host_size_t count);
+
 // Assigns the reference-counted pointer |ref| without incrementing the count.
 // |out_ref| will be released if it already contains a reference.
 IREE_API_EXPORT void iree_vm_ref_assign(iree_vm_ref_t* ref,
@@ -459,6 +459,25 @@ TEST(VMRefTest, MovingReleasesExisting) {
   iree_vm_ref_release(&a_ref_1);
 }
 
+// Tests that releasing a range releases each reference and resets it.
+TEST(VMRefTest, ReleaseRange) {
+  auto instance = MakeInstance();
+  iree_vm_ref_t a_ref = MakeRef<A>(instance, "AType");
+  iree_vm_ref_t b_ref = MakeRef<B>(instance, "BType");
+  iree_vm_ref_t refs[5] = {{0}};
+  iree_vm_ref_retain(&a_ref, &refs[0]);
+  iree_vm_ref_retain(&a_ref, &refs[1]);
+  iree_vm_ref_retain(&a_ref, &refs[3]);
+  iree_vm_ref_move(&b_ref, &refs[4]);
+  EXPECT_EQ(4, ReadCounter(&a_ref));
+  iree_vm_ref_release_range(refs, IREE_ARRAYSIZE(refs));
+  EXPECT_EQ(1, ReadCounter(&a_ref));
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(refs); ++i) {
+    EXPECT_TRUE(iree_vm_ref_is_null(&refs[i]));
+  }
+  iree_vm_ref_release(&a_ref);
+}
+
 // Null references should always be equal.
 TEST(VMRefTest, EqualityNull) {
   iree_vm_ref_t null_ref_0 = {0};
@@ -8,6 +8,7 @@
 
 IREE_VM_ABI_DEFINE_SHIM(irIi, v);
 IREE_VM_ABI_DEFINE_SHIM(i, r);
+IREE_VM_ABI_DEFINE_SHIM(i, v);
 IREE_VM_ABI_DEFINE_SHIM(r, i);
 IREE_VM_ABI_DEFINE_SHIM(r, I);
 IREE_VM_ABI_DEFINE_SHIM(r, ii);
@@ -59,6 +60,7 @@ IREE_VM_ABI_DEFINE_SHIM(rriCiD, v);
 IREE_VM_ABI_DEFINE_SHIM(rriiCID, v);
 IREE_VM_ABI_DEFINE_SHIM(rriCiirIID, v);
 IREE_VM_ABI_DEFINE_SHIM(rriiii, v);
+IREE_VM_ABI_DEFINE_SHIM(rrriiiiCiDiCiirIID, v);
 IREE_VM_ABI_DEFINE_SHIM(rrIIii, v);
 IREE_VM_ABI_DEFINE_SHIM(rrirCID, v);
 IREE_VM_ABI_DEFINE_SHIM(rrirI, v);
@@ -71,6 +73,7 @@ IREE_VM_ABI_DEFINE_SHIM(rIrrrrrrr, v);
 IREE_VM_ABI_DEFINE_SHIM(rIrrrIiirrr, r);
 IREE_VM_ABI_DEFINE_SHIM(rIrrr, v);
 IREE_VM_ABI_DEFINE_SHIM(rIrrCrD, v);
+IREE_VM_ABI_DEFINE_SHIM(rIrrrCrIID, v);
 IREE_VM_ABI_DEFINE_SHIM(CrID, r);
 IREE_VM_ABI_DEFINE_SHIM(CrD, r);
 IREE_VM_ABI_DEFINE_SHIM(iCrD, i);
@@ -480,6 +480,16 @@ IREE_VM_ABI_VLA_STRUCT(rIrrCrD, a4_count, a4, {
   iree_vm_abi_r_t a4[0];
 });
 
+IREE_VM_ABI_VLA_STRUCT(rIrrrCrIID, a5_count, a5, {
+  iree_vm_ref_t r0;
+  int64_t i1;
+  iree_vm_ref_t r2;
+  iree_vm_ref_t r3;
+  iree_vm_ref_t r4;
+  iree_vm_size_t a5_count;
+  iree_vm_abi_rII_t a5[0];
+});
+
 IREE_VM_ABI_VLA_STRUCT(rCiD, a1_count, a1, {
   iree_vm_ref_t r0;
   iree_vm_size_t a1_count;
@@ -589,6 +599,57 @@ IREE_VM_ABI_VLA_STRUCT(rriCiirIID, a3_count, a3, {
   iree_vm_abi_iirII_t a3[0];
 });
 
+IREE_VM_ABI_VLA_STRUCT(iCiirIID, a1_count, a1, {
+  int32_t i0;
+  iree_vm_size_t a1_count;
+  iree_vm_abi_iirII_t a1[0];
+});
+
+// Signatures with multiple variadic segments cannot be represented as a single
+// packed struct. The struct covers the fixed arguments and the first segment
+// and the remaining arguments (`iCiirIID`) are located with the _tail accessor
+// after the total size has been validated.
+typedef struct iree_vm_abi_rrriiiiCiDiCiirIID_t {
+  iree_vm_ref_t r0;
+  iree_vm_ref_t r1;
+  iree_vm_ref_t r2;
+  int32_t i3;
+  int32_t i4;
+  int32_t i5;
+  int32_t i6;
+  iree_vm_size_t a7_count;
+  iree_vm_abi_i_t a7[0];
+  // iree_vm_abi_iCiirIID_t tail;
+} IREE_ATTRIBUTE_PACKED iree_vm_abi_rrriiiiCiDiCiirIID_t;
+static inline iree_host_size_t iree_vm_abi_rrriiiiCiDiCiirIID_head_size(
+    const iree_vm_abi_rrriiiiCiDiCiirIID_t* value) {
+  return sizeof(*value) + (iree_host_size_t)value->a7_count * sizeof(int32_t);
+}
+static inline iree_vm_abi_rrriiiiCiDiCiirIID_t*
+iree_vm_abi_rrriiiiCiDiCiirIID_checked_deref(iree_byte_span_t buffer) {
+  if (IREE_UNLIKELY(buffer.data_length <
+                    sizeof(iree_vm_abi_rrriiiiCiDiCiirIID_t))) {
+    return NULL;
+  }
+  iree_vm_abi_rrriiiiCiDiCiirIID_t* value =
+      (iree_vm_abi_rrriiiiCiDiCiirIID_t*)buffer.data;
+  if (IREE_UNLIKELY(value->a7_count < 0)) return NULL;
+  iree_host_size_t head_size = iree_vm_abi_rrriiiiCiDiCiirIID_head_size(value);
+  if (IREE_UNLIKELY(buffer.data_length < head_size)) return NULL;
+  if (IREE_UNLIKELY(!iree_vm_abi_iCiirIID_checked_deref(iree_make_byte_span(
+          buffer.data + head_size, buffer.data_length - head_size)))) {
+    return NULL;
+  }
+  return value;
+}
+static inline const iree_vm_abi_iCiirIID_t*
+iree_vm_abi_rrriiiiCiDiCiirIID_tail(
+    const iree_vm_abi_rrriiiiCiDiCiirIID_t* value) {
+  const uint8_t* tail_ptr =
+      (const uint8_t*)value + iree_vm_abi_rrriiiiCiDiCiirIID_head_size(value);
+  return (const iree_vm_abi_iCiirIID_t*)tail_ptr;
+}
+
 IREE_VM_ABI_VLA_STRUCT(CrD, a0_count, a0, {
   iree_vm_size_t a0_count;
   iree_vm_abi_r_t a0[0];
@@ -615,6 +676,7 @@ IREE_VM_ABI_VLA_STRUCT(iCrD, a1_count, a1, {
 
 IREE_VM_ABI_DECLARE_SHIM(irIi, v);
 IREE_VM_ABI_DECLARE_SHIM(i, r);
+IREE_VM_ABI_DECLARE_SHIM(i, v);
 IREE_VM_ABI_DECLARE_SHIM(r, i);
 IREE_VM_ABI_DECLARE_SHIM(r, I);
 IREE_VM_ABI_DECLARE_SHIM(r, ii);
@@ -666,6 +728,7 @@ IREE_VM_ABI_DECLARE_SHIM(rriCiD, v);
 IREE_VM_ABI_DECLARE_SHIM(rriiCID, v);
 IREE_VM_ABI_DECLARE_SHIM(rriCiirIID, v);
 IREE_VM_ABI_DECLARE_SHIM(rriiii, v);
+IREE_VM_ABI_DECLARE_SHIM(rrriiiiCiDiCiirIID, v);
 IREE_VM_ABI_DECLARE_SHIM(rrIIii, v);
 IREE_VM_ABI_DECLARE_SHIM(rrirCID, v);
 IREE_VM_ABI_DECLARE_SHIM(rrirI, v);
@@ -678,6 +741,7 @@ IREE_VM_ABI_DECLARE_SHIM(rIrrrrrrr, v);
 IREE_VM_ABI_DECLARE_SHIM(rIrrrIiirrr, r);
 IREE_VM_ABI_DECLARE_SHIM(rIrrr, v);
 IREE_VM_ABI_DECLARE_SHIM(rIrrCrD, v);
+IREE_VM_ABI_DECLARE_SHIM(rIrrrCrIID, v);
 IREE_VM_ABI_DECLARE_SHIM(CrID, r);
 IREE_VM_ABI_DECLARE_SHIM(CrD, r);
 IREE_VM_ABI_DECLARE_SHIM(iCrD, i);
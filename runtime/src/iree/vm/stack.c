@@ -13,6 +13,7 @@
 
 #include "iree/base/api.h"
 #include "iree/vm/module.h"
+#include "iree/vm/profiler.h"
 
 //===----------------------------------------------------------------------===//
 // Stack implementation
@@ -180,6 +181,12 @@ struct iree_vm_stack_t {
   // Allocator used for dynamic stack allocations. May be the null allocator
   // if growth is prohibited.
   iree_allocator_t allocator;
+
+#if IREE_VM_SAMPLING_PROFILER_ENABLE
+  // Sampling profiler epoch at which the stack last recorded a sample.
+  // See iree_vm_sampling_profiler_t.
+  int32_t sample_epoch;
+#endif  // IREE_VM_SAMPLING_PROFILER_ENABLE
 };
 
 //===----------------------------------------------------------------------===//
@@ -216,6 +223,12 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_initialize(
 
   stack->top = NULL;
 
+#if IREE_VM_SAMPLING_PROFILER_ENABLE
+  // Only sample once the profiler ticks after the stack is created so that
+  // short-lived stacks don't all record samples on their first call.
+  stack->sample_epoch = iree_vm_sampling_profiler_epoch();
+#endif  // IREE_VM_SAMPLING_PROFILER_ENABLE
+
   *out_stack = stack;
 
   IREE_TRACE_ZONE_END(z0);
@@ -594,6 +607,16 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_function_enter(
     }
   });
 
+#if IREE_VM_SAMPLING_PROFILER_ENABLE
+  // Record a sample if the active sampling profiler has ticked since the last
+  // sample taken from this stack.
+  int32_t sample_epoch = iree_vm_sampling_profiler_epoch();
+  if (IREE_UNLIKELY(sample_epoch != stack->sample_epoch)) {
+    stack->sample_epoch = sample_epoch;
+    iree_vm_sampling_profiler_record(stack);
+  }
+#endif  // IREE_VM_SAMPLING_PROFILER_ENABLE
+
   if (out_callee_frame) *out_callee_frame = callee_frame;
   return iree_ok_status();
 }
@@ -685,6 +708,91 @@ IREE_API_EXPORT iree_status_t iree_vm_stack_format_backtrace(
   return iree_ok_status();
 }
 
+// Appends the name of the function in |frame| to |builder|, optionally
+// suffixed with its source location. Characters that are significant in the
+// folded format (frame separators and newlines) are replaced with spaces.
+static iree_status_t iree_vm_stack_format_folded_frame(
+    const iree_vm_stack_frame_t* frame, bool include_source_locations,
+    iree_string_builder_t* builder) {
+  iree_vm_module_t* module = frame->function.module;
+  iree_string_view_t module_name = iree_vm_module_name(module);
+  iree_string_view_t function_name = iree_vm_function_name(&frame->function);
+  if (iree_string_view_is_empty(function_name)) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%.*s@%d", (int)module_name.size, module_name.data,
+        (int)frame->function.ordinal));
+  } else {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_format(
+        builder, "%.*s.%.*s", (int)module_name.size, module_name.data,
+        (int)function_name.size, function_name.data));
+  }
+  if (!include_source_locations) return iree_ok_status();
+
+  iree_vm_source_location_t source_location;
+  iree_status_t status = iree_vm_module_resolve_source_location(
+      module, frame->function, frame->pc, &source_location);
+  if (iree_status_is_unavailable(status)) {
+    iree_status_ignore(status);
+    return iree_ok_status();
+  }
+  IREE_RETURN_IF_ERROR(status);
+  IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, " "));
+
+  // Size queries don't need sanitization as the length is unchanged.
+  if (iree_allocator_is_null(builder->allocator)) {
+    return iree_vm_source_location_format(
+        &source_location, IREE_VM_SOURCE_LOCATION_FORMAT_FLAG_SINGLE_LINE,
+        builder);
+  }
+  iree_string_builder_t location_builder;
+  iree_string_builder_initialize(builder->allocator, &location_builder);
+  status = iree_vm_source_location_format(
+      &source_location, IREE_VM_SOURCE_LOCATION_FORMAT_FLAG_SINGLE_LINE,
+      &location_builder);
+  const char* location = iree_string_builder_buffer(&location_builder);
+  for (iree_host_size_t i = 0;
+       i < iree_string_builder_size(&location_builder) &&
+       iree_status_is_ok(status);
+       ++i) {
+    char c = location[i];
+    if (c == ';' || c == '\n' || c == '\r') c = ' ';
+    status = iree_string_builder_append_string(builder,
+                                               iree_make_string_view(&c, 1));
+  }
+  iree_string_builder_deinitialize(&location_builder);
+  return status;
+}
+
+// Formats |frame_header| and all of its parents outermost first. |base_size|
+// is the size of |builder| prior to formatting the first frame.
+static iree_status_t iree_vm_stack_format_folded_frames(
+    const iree_vm_stack_frame_header_t* frame_header,
+    bool include_source_locations, iree_host_size_t base_size,
+    iree_string_builder_t* builder) {
+  if (!frame_header) return iree_ok_status();
+  IREE_RETURN_IF_ERROR(iree_vm_stack_format_folded_frames(
+      frame_header->parent, include_source_locations, base_size, builder));
+  const iree_vm_stack_frame_t* frame = &frame_header->frame;
+  if (frame->type == IREE_VM_STACK_FRAME_WAIT || !frame->function.module) {
+    return iree_ok_status();
+  }
+  if (iree_string_builder_size(builder) > base_size) {
+    IREE_RETURN_IF_ERROR(iree_string_builder_append_cstring(builder, ";"));
+  }
+  return iree_vm_stack_format_folded_frame(frame, include_source_locations,
+                                           builder);
+}
+
+IREE_API_EXPORT iree_status_t iree_vm_stack_format_folded(
+    iree_vm_stack_t* stack, bool include_source_locations,
+    iree_string_builder_t* builder) {
+  IREE_ASSERT_ARGUMENT(stack);
+  IREE_ASSERT_ARGUMENT(builder);
+  return iree_vm_stack_format_folded_frames(
+      stack->top, include_source_locations, iree_string_builder_size(builder),
+      builder);
+}
+
 IREE_API_EXPORT iree_status_t iree_vm_stack_annotate_backtrace(
     iree_vm_stack_t* stack, iree_status_t base_status) {
   if (IREE_LIKELY(iree_status_is_ok(base_status))) return base_status;
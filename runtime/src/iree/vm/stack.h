@@ -313,6 +313,15 @@ iree_vm_stack_function_leave(iree_vm_stack_t* stack);
 IREE_API_EXPORT iree_status_t iree_vm_stack_format_backtrace(
     iree_vm_stack_t* stack, iree_string_builder_t* builder);
 
+// Formats the current stack to the given string |builder| as a single line of
+// semicolon-separated frame names ordered from the outermost frame to the
+// innermost as used by folded stack profile formats (`a;b;c`). If
+// |include_source_locations| is set each frame name is suffixed with its
+// source location when available.
+IREE_API_EXPORT iree_status_t iree_vm_stack_format_folded(
+    iree_vm_stack_t* stack, bool include_source_locations,
+    iree_string_builder_t* builder);
+
 // Annotates |status| with the backtrace of |stack| and returns |base_status|.
 IREE_API_EXPORT IREE_MUST_USE_RESULT iree_status_t
 iree_vm_stack_annotate_backtrace(iree_vm_stack_t* stack,
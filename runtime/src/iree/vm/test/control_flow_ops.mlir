@@ -124,6 +124,58 @@ vm.module @control_flow_ops {
     vm.return
   }
 
+  // Compare-and-branch sequences are encoded as fused superinstructions.
+  vm.export @test_cmp_eq_i32_cond_br
+  vm.func private @test_cmp_eq_i32_cond_br() {
+    %c1 = vm.const.i32 1
+    %c1dno = util.optimization_barrier %c1 : i32
+    %c2 = vm.const.i32 2
+    %c2dno = util.optimization_barrier %c2 : i32
+    %eq = vm.cmp.eq.i32 %c1dno, %c1dno : i32
+    vm.cond_br %eq, ^bb1(%c1dno : i32), ^bb1(%c2dno : i32)
+  ^bb1(%arg0 : i32):
+    vm.check.eq %arg0, %c1dno, "expected true branch" : i32
+    %ne = vm.cmp.ne.i32 %c1dno, %c1dno : i32
+    vm.cond_br %ne, ^bb2(%c1dno : i32), ^bb2(%c2dno : i32)
+  ^bb2(%arg1 : i32):
+    vm.check.eq %arg1, %c2dno, "expected false branch" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_lt_i32_cond_br
+  vm.func private @test_cmp_lt_i32_cond_br() {
+    %cn1 = vm.const.i32 -1
+    %cn1dno = util.optimization_barrier %cn1 : i32
+    %c1 = vm.const.i32 1
+    %c1dno = util.optimization_barrier %c1 : i32
+    %c2 = vm.const.i32 2
+    %c2dno = util.optimization_barrier %c2 : i32
+    %lt_s = vm.cmp.lt.i32.s %cn1dno, %c1dno : i32
+    vm.cond_br %lt_s, ^bb1(%c1dno : i32), ^bb1(%c2dno : i32)
+  ^bb1(%arg0 : i32):
+    vm.check.eq %arg0, %c1dno, "expected signed -1 < 1" : i32
+    %lt_u = vm.cmp.lt.i32.u %cn1dno, %c1dno : i32
+    vm.cond_br %lt_u, ^bb2(%c1dno : i32), ^bb2(%c2dno : i32)
+  ^bb2(%arg1 : i32):
+    vm.check.eq %arg1, %c2dno, "expected unsigned 0xFFFFFFFF >= 1" : i32
+    vm.return
+  }
+
+  vm.export @test_cmp_nz_ref_cond_br
+  vm.func private @test_cmp_nz_ref_cond_br() {
+    %c1 = vm.const.i32 1
+    %c1dno = util.optimization_barrier %c1 : i32
+    %c2 = vm.const.i32 2
+    %c2dno = util.optimization_barrier %c2 : i32
+    %null = vm.const.ref.zero : !vm.ref<?>
+    %nulldno = util.optimization_barrier %null : !vm.ref<?>
+    %nz = vm.cmp.nz.ref %nulldno : !vm.ref<?>
+    vm.cond_br %nz, ^bb1(%c1dno : i32), ^bb1(%c2dno : i32)
+  ^bb1(%arg0 : i32):
+    vm.check.eq %arg0, %c2dno, "expected null ref false branch" : i32
+    vm.return
+  }
+
   vm.export @test_br_table_inbounds
   vm.func private @test_br_table_inbounds() {
     %c0 = vm.const.i32 0
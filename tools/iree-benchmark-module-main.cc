@@ -51,11 +51,22 @@
 // how the full program will run, though, and YMMV. Always verify timings with
 // an appropriate device-specific tool before trusting the more generic and
 // higher-level numbers from this tool.
+//
+// For sizing deployments --load_sessions=N replaces the benchmark suite with a
+// load test of --function=: N sessions invoke the function concurrently either
+// back-to-back (closed-loop) or at an aggregate --load_qps= (open-loop, with
+// --load_poisson for random arrivals) and latency percentiles, throughput, and
+// CPU utilization are written as JSON to --load_output=.
 
+#include <algorithm>
 #include <array>
+#include <cerrno>
+#include <cmath>
 #include <cstdio>
 #include <iterator>
+#include <random>
 #include <string>
+#include <thread>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -68,8 +79,15 @@
 #include "iree/tooling/context_util.h"
 #include "iree/tooling/device_util.h"
 #include "iree/tooling/function_io.h"
+#include "iree/tooling/vm_profiler_util.h"
 #include "iree/vm/api.h"
 
+#if defined(IREE_PLATFORM_WINDOWS)
+#include <windows.h>
+#elif !defined(IREE_PLATFORM_EMSCRIPTEN)
+#include <sys/resource.h>
+#endif  // IREE_PLATFORM_*
+
 constexpr char kNanosecondsUnitString[] = "ns";
 constexpr char kMicrosecondsUnitString[] = "us";
 constexpr char kMillisecondsUnitString[] = "ms";
@@ -91,6 +109,24 @@ IREE_FLAG(string, function, "",
 IREE_FLAG(bool, print_statistics, false,
           "Prints runtime statistics to stderr on exit.");
 
+IREE_FLAG(int32_t, load_sessions, 0,
+          "Runs a load test of --function= with this many concurrent sessions "
+          "instead of the Google Benchmark suite. Each session has its own VM "
+          "context sharing the modules and device.");
+IREE_FLAG(double, load_qps, 0.0,
+          "Target arrival rate in invocations per second across all load "
+          "sessions (open-loop). When 0 each session invokes again as soon "
+          "as its previous invocation completes (closed-loop).");
+IREE_FLAG(bool, load_poisson, false,
+          "Uses exponentially distributed inter-arrival times (a Poisson "
+          "process) instead of fixed ones with --load_qps=.");
+IREE_FLAG(double, load_duration, 10.0,
+          "Seconds to run the load test for after warmup.");
+IREE_FLAG(double, load_warmup, 1.0,
+          "Seconds to run the load test for before recording results.");
+IREE_FLAG(string, load_output, "-",
+          "Path to write the load test JSON results to or '-' for stdout.");
+
 IREE_FLAG_LIST(
     string, input,
     "An input value or buffer of the format:\n"
@@ -423,6 +459,191 @@ void RegisterDispatchBenchmark(const std::string& function_name,
                                   : benchmark::kMicrosecond);
 }
 
+//===----------------------------------------------------------------------===//
+// Load testing (--load_sessions=)
+//===----------------------------------------------------------------------===//
+
+// Returns the user + system CPU time consumed by all threads in the process or
+// a negative value if it can't be queried on the platform.
+static double QueryProcessCpuSeconds() {
+#if defined(IREE_PLATFORM_WINDOWS)
+  FILETIME creation_time, exit_time, kernel_time, user_time;
+  if (!GetProcessTimes(GetCurrentProcess(), &creation_time, &exit_time,
+                       &kernel_time, &user_time)) {
+    return -1.0;
+  }
+  auto to_seconds = [](FILETIME t) {
+    ULARGE_INTEGER value;
+    value.LowPart = t.dwLowDateTime;
+    value.HighPart = t.dwHighDateTime;
+    return value.QuadPart * 1e-7;  // 100ns ticks
+  };
+  return to_seconds(kernel_time) + to_seconds(user_time);
+#elif !defined(IREE_PLATFORM_EMSCRIPTEN)
+  struct rusage usage;
+  if (getrusage(RUSAGE_SELF, &usage) != 0) return -1.0;
+  return usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 +
+         usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+#else
+  return -1.0;
+#endif  // IREE_PLATFORM_*
+}
+
+// Timing parameters shared by all sessions of a load test.
+struct LoadSchedule {
+  // Mean time between arrivals in a single session or 0 for closed-loop.
+  double interval_ns = 0.0;
+  // Draws inter-arrival times from an exponential distribution.
+  bool poisson = false;
+  // Invocations arriving before this are not recorded.
+  iree_time_t record_start_ns = 0;
+  // No invocations are issued at or after this time.
+  iree_time_t end_ns = 0;
+};
+
+// Performs one invocation of |function| and waits for it to complete.
+// Functions using the coarse-fences ABI are passed a fence on the session's
+// |semaphore| and waited on so that latency includes device execution.
+static iree_status_t InvokeAndWait(iree_vm_context_t* context,
+                                   iree_vm_function_t function,
+                                   iree_vm_list_t* common_inputs,
+                                   iree_hal_semaphore_t* semaphore,
+                                   uint64_t* timeline_value,
+                                   iree_vm_list_t* outputs) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  if (!semaphore) {
+    IREE_RETURN_IF_ERROR(iree_vm_invoke(
+        context, function, IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr,
+        common_inputs, outputs, host_allocator));
+    return iree_vm_list_resize(outputs, 0);
+  }
+
+  vm::ref<iree_vm_list_t> inputs;
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_clone(common_inputs, host_allocator, &inputs));
+  vm::ref<iree_hal_fence_t> wait_fence;
+  vm::ref<iree_hal_fence_t> signal_fence;
+  IREE_RETURN_IF_ERROR(iree_hal_fence_create_at(
+      semaphore, ++*timeline_value, host_allocator, &signal_fence));
+  IREE_RETURN_IF_ERROR(iree_vm_list_push_ref_move(inputs.get(), wait_fence));
+  IREE_RETURN_IF_ERROR(
+      iree_vm_list_push_ref_retain(inputs.get(), signal_fence));
+  IREE_RETURN_IF_ERROR(iree_vm_invoke(
+      context, function, IREE_VM_INVOCATION_FLAG_NONE, /*policy=*/nullptr,
+      inputs.get(), outputs, host_allocator));
+  IREE_RETURN_IF_ERROR(
+      iree_hal_fence_wait(signal_fence.get(), iree_infinite_timeout()));
+  return iree_vm_list_resize(outputs, 0);
+}
+
+// Issues invocations of |function| in a single session until the schedule
+// ends and appends the latency of those arriving in the recording window to
+// |out_latencies|.
+//
+// In open-loop mode latency is measured from the scheduled arrival time rather
+// than from when the invocation was issued: an invocation that runs long delays
+// those arriving after it and they are charged for the time spent queued.
+static iree_status_t RunLoadSession(
+    iree_hal_device_t* device, iree_vm_context_t* context,
+    iree_vm_function_t function, bool is_async, iree_vm_list_t* common_inputs,
+    const LoadSchedule& schedule, int32_t session_index, int32_t session_count,
+    std::vector<iree_duration_t>* out_latencies) {
+  iree_allocator_t host_allocator = iree_allocator_system();
+  vm::ref<iree_hal_semaphore_t> semaphore;
+  uint64_t timeline_value = 0;
+  if (is_async) {
+    IREE_RETURN_IF_ERROR(iree_hal_semaphore_create(device, 0ull, &semaphore));
+  }
+  vm::ref<iree_vm_list_t> outputs;
+  IREE_RETURN_IF_ERROR(iree_vm_list_create(iree_vm_make_undefined_type_def(),
+                                           16, host_allocator, &outputs));
+
+  std::mt19937_64 rng(session_index);
+  std::exponential_distribution<double> exponential(
+      schedule.interval_ns > 0.0 ? 1.0 / schedule.interval_ns : 1.0);
+  auto next_interval_ns = [&]() -> double {
+    return schedule.poisson ? exponential(rng) : schedule.interval_ns;
+  };
+
+  // Sessions are staggered so fixed-rate arrivals don't all land at once.
+  double arrival_ns = (double)iree_time_now();
+  if (schedule.poisson) {
+    arrival_ns += next_interval_ns();
+  } else {
+    arrival_ns += schedule.interval_ns * session_index / session_count;
+  }
+  while ((iree_time_t)arrival_ns < schedule.end_ns) {
+    iree_time_t arrival_time_ns = (iree_time_t)arrival_ns;
+    if (schedule.interval_ns > 0.0) {
+      iree_wait_until(arrival_time_ns);
+    } else {
+      arrival_time_ns = iree_time_now();
+    }
+    IREE_RETURN_IF_ERROR(InvokeAndWait(context, function, common_inputs,
+                                       semaphore.get(), &timeline_value,
+                                       outputs.get()));
+    iree_time_t completion_time_ns = iree_time_now();
+    if (arrival_time_ns >= schedule.record_start_ns) {
+      out_latencies->push_back(completion_time_ns - arrival_time_ns);
+    }
+    arrival_ns = schedule.interval_ns > 0.0 ? arrival_ns + next_interval_ns()
+                                            : (double)completion_time_ns;
+  }
+  return iree_ok_status();
+}
+
+// Returns the nearest-rank |percentile| of the ascending |sorted_values|.
+static iree_duration_t Percentile(
+    const std::vector<iree_duration_t>& sorted_values, double percentile) {
+  if (sorted_values.empty()) return 0;
+  size_t rank = (size_t)std::ceil(percentile / 100.0 * sorted_values.size());
+  return sorted_values[std::min(std::max(rank, (size_t)1),
+                                sorted_values.size()) -
+                       1];
+}
+
+// Writes the load test summary as a single JSON object.
+static void PrintLoadResults(FILE* file, const std::string& function_name,
+                             int32_t session_count,
+                             std::vector<iree_duration_t> latencies,
+                             double wall_seconds, double cpu_seconds) {
+  std::sort(latencies.begin(), latencies.end());
+  double total_ns = 0.0;
+  for (iree_duration_t latency : latencies) total_ns += latency;
+  auto ms = [](double ns) { return ns / 1e6; };
+  const char* arrival_model = FLAG_load_qps <= 0.0 ? "closed"
+                              : FLAG_load_poisson  ? "poisson"
+                                                   : "fixed";
+  fprintf(file, "{\n");
+  fprintf(file, "  \"function\": \"%s\",\n", function_name.c_str());
+  fprintf(file, "  \"sessions\": %d,\n", session_count);
+  fprintf(file, "  \"arrival_model\": \"%s\",\n", arrival_model);
+  fprintf(file, "  \"target_qps\": %g,\n", FLAG_load_qps);
+  fprintf(file, "  \"duration_s\": %g,\n", wall_seconds);
+  fprintf(file, "  \"invocations\": %zu,\n", latencies.size());
+  fprintf(file, "  \"throughput_qps\": %g,\n",
+          wall_seconds > 0.0 ? latencies.size() / wall_seconds : 0.0);
+  if (cpu_seconds >= 0.0) {
+    fprintf(file, "  \"cpu_time_s\": %g,\n", cpu_seconds);
+    // In cores: 2.0 means two cores were busy on average.
+    fprintf(file, "  \"cpu_utilization\": %g,\n",
+            wall_seconds > 0.0 ? cpu_seconds / wall_seconds : 0.0);
+  }
+  fprintf(file, "  \"latency_ms\": {\n");
+  fprintf(file, "    \"min\": %g,\n",
+          ms(latencies.empty() ? 0.0 : (double)latencies.front()));
+  fprintf(file, "    \"mean\": %g,\n",
+          ms(latencies.empty() ? 0.0 : total_ns / latencies.size()));
+  fprintf(file, "    \"p50\": %g,\n", ms(Percentile(latencies, 50.0)));
+  fprintf(file, "    \"p90\": %g,\n", ms(Percentile(latencies, 90.0)));
+  fprintf(file, "    \"p99\": %g,\n", ms(Percentile(latencies, 99.0)));
+  fprintf(file, "    \"p999\": %g,\n", ms(Percentile(latencies, 99.9)));
+  fprintf(file, "    \"max\": %g\n",
+          ms(latencies.empty() ? 0.0 : (double)latencies.back()));
+  fprintf(file, "  }\n");
+  fprintf(file, "}\n");
+}
+
 // The lifetime of IREEBenchmark should be as long as
 // ::benchmark::RunSpecifiedBenchmarks() where the resources are used during
 // benchmarking.
@@ -466,6 +687,118 @@ class IREEBenchmark {
     return iree_ok_status();
   }
 
+  // Runs the --function= load test and writes the results to --load_output=.
+  iree_status_t RunLoadTest() {
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RunLoadTest");
+
+    if (!instance_ || !device_allocator_ || !context_ || !module_list_.count) {
+      IREE_RETURN_IF_ERROR(Init());
+    }
+    auto function_name = std::string(FLAG_function);
+    if (function_name.empty()) {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "--load_sessions= requires --function=");
+    }
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(PrepareFunction(function_name, &function));
+    iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
+        &function, IREE_SV("iree.abi.model"));
+    bool is_async =
+        iree_string_view_equal(invocation_model, IREE_SV("coarse-fences"));
+    if (is_async && !device_) {
+      return iree_make_status(IREE_STATUS_FAILED_PRECONDITION,
+                              "async functions require a HAL device");
+    }
+
+    // Contexts can't be invoked concurrently so each session gets its own
+    // with the same modules (and through the HAL module the same device).
+    int32_t session_count = FLAG_load_sessions;
+    std::vector<vm::ref<iree_vm_context_t>> contexts;
+    contexts.push_back(vm::retain_ref(context_));
+    std::vector<iree_vm_module_t*> modules(
+        iree_vm_context_module_count(context_.get()));
+    for (iree_host_size_t i = 0; i < modules.size(); ++i) {
+      modules[i] = iree_vm_context_module_at(context_.get(), i);
+    }
+    for (int32_t i = 1; i < session_count; ++i) {
+      vm::ref<iree_vm_context_t> context;
+      IREE_RETURN_IF_ERROR(iree_vm_context_create_with_modules(
+          instance_.get(), iree_vm_context_flags(context_.get()),
+          modules.size(), modules.data(), iree_allocator_system(), &context));
+      contexts.push_back(std::move(context));
+    }
+
+    LoadSchedule schedule;
+    if (FLAG_load_qps > 0.0) {
+      schedule.interval_ns = session_count * 1e9 / FLAG_load_qps;
+      schedule.poisson = FLAG_load_poisson;
+    }
+    iree_time_t start_ns = iree_time_now();
+    schedule.record_start_ns =
+        start_ns + (iree_duration_t)(FLAG_load_warmup * 1e9);
+    schedule.end_ns =
+        schedule.record_start_ns + (iree_duration_t)(FLAG_load_duration * 1e9);
+
+    // Device profiling (--device_profiling_mode=) captures per-dispatch
+    // timing for the entire run when enabled.
+    IREE_RETURN_IF_ERROR(iree_hal_begin_profiling_from_flags(device_.get()));
+    IREE_RETURN_IF_ERROR(
+        iree_tooling_begin_vm_profiling_from_flags(iree_allocator_system()));
+
+    std::vector<std::vector<iree_duration_t>> session_latencies(session_count);
+    std::vector<iree_status_t> session_statuses(session_count);
+    std::vector<std::thread> threads;
+    for (int32_t i = 0; i < session_count; ++i) {
+      threads.emplace_back([&, i]() {
+        session_statuses[i] = RunLoadSession(
+            device_.get(), contexts[i].get(), function, is_async,
+            inputs_.get(), schedule, i, session_count, &session_latencies[i]);
+      });
+    }
+    // Warmup is excluded from utilization as well as latency.
+    iree_wait_until(schedule.record_start_ns);
+    double cpu_start_seconds = QueryProcessCpuSeconds();
+    for (auto& thread : threads) thread.join();
+    iree_time_t end_ns = std::max(iree_time_now(), schedule.record_start_ns);
+    double cpu_end_seconds = QueryProcessCpuSeconds();
+    IREE_RETURN_IF_ERROR(iree_tooling_end_vm_profiling_from_flags());
+    IREE_RETURN_IF_ERROR(iree_hal_end_profiling_from_flags(device_.get()));
+
+    iree_status_t status = iree_ok_status();
+    for (iree_status_t& session_status : session_statuses) {
+      if (iree_status_is_ok(status)) {
+        status = session_status;
+      } else {
+        iree_status_ignore(session_status);
+      }
+    }
+    IREE_RETURN_IF_ERROR(status);
+
+    std::vector<iree_duration_t> latencies;
+    for (auto& values : session_latencies) {
+      latencies.insert(latencies.end(), values.begin(), values.end());
+    }
+    double wall_seconds = (end_ns - schedule.record_start_ns) / 1e9;
+    double cpu_seconds = cpu_start_seconds >= 0.0 && cpu_end_seconds >= 0.0
+                             ? cpu_end_seconds - cpu_start_seconds
+                             : -1.0;
+
+    FILE* file = stdout;
+    iree_string_view_t output_path = iree_make_cstring_view(FLAG_load_output);
+    if (!iree_string_view_equal(output_path, IREE_SV("-"))) {
+      file = fopen(FLAG_load_output, "wb");
+      if (!file) {
+        return iree_make_status(iree_status_code_from_errno(errno),
+                                "failed to open load output file '%s'",
+                                FLAG_load_output);
+      }
+    }
+    PrintLoadResults(file, function_name, session_count, std::move(latencies),
+                     wall_seconds, cpu_seconds);
+    if (file != stdout) fclose(file);
+    return iree_ok_status();
+  }
+
  private:
   iree_status_t Init() {
     IREE_TRACE_SCOPE_NAMED("IREEBenchmark::Init");
@@ -487,19 +820,18 @@ class IREEBenchmark {
     return iree_ok_status();
   }
 
-  iree_status_t RegisterSpecificFunction(const std::string& function_name) {
-    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RegisterSpecificFunction");
-
+  // Looks up |function_name| in the main module and parses its --input=s.
+  iree_status_t PrepareFunction(const std::string& function_name,
+                                iree_vm_function_t* out_function) {
     iree_vm_module_t* main_module =
         iree_tooling_module_list_back(&module_list_);
-    iree_vm_function_t function;
     IREE_RETURN_IF_ERROR(iree_vm_module_lookup_function_by_name(
         main_module, IREE_VM_FUNCTION_LINKAGE_EXPORT,
         iree_string_view_t{function_name.data(),
                            (iree_host_size_t)function_name.size()},
-        &function));
+        out_function));
     iree_vm_function_signature_t signature =
-        iree_vm_function_signature(&function);
+        iree_vm_function_signature(out_function);
     iree_string_view_t arguments_cconv, results_cconv;
     IREE_RETURN_IF_ERROR(iree_vm_function_call_get_cconv_fragments(
         &signature, &arguments_cconv, &results_cconv));
@@ -508,6 +840,14 @@ class IREEBenchmark {
         arguments_cconv, FLAG_input_list(), device_.get(),
         device_allocator_.get(), iree_vm_instance_allocator(instance_.get()),
         &inputs_));
+    return iree_ok_status();
+  }
+
+  iree_status_t RegisterSpecificFunction(const std::string& function_name) {
+    IREE_TRACE_SCOPE_NAMED("IREEBenchmark::RegisterSpecificFunction");
+
+    iree_vm_function_t function;
+    IREE_RETURN_IF_ERROR(PrepareFunction(function_name, &function));
 
     iree_string_view_t invocation_model = iree_vm_function_lookup_attr_by_name(
         &function, IREE_SV("iree.abi.model"));
@@ -622,7 +962,9 @@ int main(int argc, char** argv) {
   ::benchmark::Initialize(&argc, argv);
 
   iree::IREEBenchmark iree_benchmark;
-  iree_status_t status = iree_benchmark.Register();
+  bool is_load_test = FLAG_load_sessions > 0;
+  iree_status_t status = is_load_test ? iree_benchmark.RunLoadTest()
+                                      : iree_benchmark.Register();
   if (!iree_status_is_ok(status)) {
     int exit_code = static_cast<int>(iree_status_code(status));
     printf("%s\n", iree::Status(std::move(status)).ToString().c_str());
@@ -630,9 +972,15 @@ int main(int argc, char** argv) {
     IREE_TRACE_APP_EXIT(exit_code);
     return exit_code;
   }
-  IREE_CHECK_OK(iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
-  ::benchmark::RunSpecifiedBenchmarks();
-  IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
+  if (!is_load_test) {
+    IREE_CHECK_OK(
+        iree_hal_begin_profiling_from_flags(iree_benchmark.device()));
+    IREE_CHECK_OK(
+        iree_tooling_begin_vm_profiling_from_flags(iree_allocator_system()));
+    ::benchmark::RunSpecifiedBenchmarks();
+    IREE_CHECK_OK(iree_tooling_end_vm_profiling_from_flags());
+    IREE_CHECK_OK(iree_hal_end_profiling_from_flags(iree_benchmark.device()));
+  }
 
   IREE_TRACE_ZONE_END(z0);
   IREE_TRACE_APP_EXIT(EXIT_SUCCESS);
@@ -14,6 +14,7 @@
 #include "iree/base/internal/file_io.h"
 #include "iree/base/internal/flags.h"
 #include "iree/hal/api.h"
+#include "iree/io/compression.h"
 #include "iree/io/formats/irpa/irpa_builder.h"
 #include "iree/io/parameter_index.h"
 #include "iree/io/scope_map.h"
@@ -164,6 +165,15 @@ IREE_FLAG(bool, quiet, false,
 
 IREE_FLAG(string, output, "", "Output .irpa file path.");
 
+IREE_FLAG(string, compression, "none",
+          "Compresses parameter contents in the resulting file in independently\n"
+          "decompressible chunks. One of `none` or `lz4`. Parameters that do\n"
+          "not get smaller when compressed are stored as-is.");
+IREE_FLAG(int32_t, compression_chunk_size,
+          IREE_IO_COMPRESSION_DEFAULT_CHUNK_LENGTH,
+          "Uncompressed size in bytes of each compressed chunk. Smaller chunks\n"
+          "allow finer-grained partial reads at the cost of ratio.");
+
 static void iree_io_file_handle_release_mapping(
     void* user_data, iree_io_file_handle_primitive_t handle_primitive) {
   iree_file_contents_free((iree_file_contents_t*)user_data);
@@ -266,9 +276,21 @@ int main(int argc, char** argv) {
         .fn = iree_tooling_open_output_parameter_file,
         .user_data = &open_params,
     };
-    status = iree_io_build_parameter_archive(
-        new_index, built_index, open_callback,
-        /*target_file_offset=*/0, host_allocator);
+    iree_io_parameter_archive_build_options_t build_options;
+    iree_io_parameter_archive_build_options_initialize(&build_options);
+    status = iree_io_compression_type_parse(
+        iree_make_cstring_view(FLAG_compression),
+        &build_options.compression_type);
+    if (iree_status_is_ok(status) && FLAG_compression_chunk_size <= 0) {
+      status = iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                                "--compression_chunk_size must be positive");
+    }
+    if (iree_status_is_ok(status)) {
+      build_options.chunk_length = (uint64_t)FLAG_compression_chunk_size;
+      status = iree_io_build_parameter_archive_with_options(
+          new_index, built_index, open_callback,
+          /*target_file_offset=*/0, &build_options, host_allocator);
+    }
   }
 
   // Dump the new index ala iree-dump-parameters to show the final file.
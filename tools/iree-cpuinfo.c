@@ -8,6 +8,63 @@
 
 #include "iree/base/api.h"
 #include "iree/base/internal/cpu.h"
+#include "iree/task/topology.h"
+
+// Prints the CPU limits of the process and the topology that would be used by
+// default for executors created in it (such as by the local-task driver).
+static void iree_cpuinfo_print_topology(void) {
+  iree_task_topology_cpu_limits_t limits;
+  iree_task_topology_query_cpu_limits(&limits);
+  printf("%-20s ", "allowed_cpus");
+  if (limits.allowed_cpu_count == 0) {
+    printf("all\n");
+  } else {
+    // Print as a cpuset list (`0-3,8`) for easy comparison with taskset/cgroups.
+    bool first = true;
+    for (uint32_t i = 0; i < IREE_TASK_TOPOLOGY_MAX_CPU_COUNT; ++i) {
+      if (!iree_task_topology_cpu_limits_allow(&limits, i)) continue;
+      uint32_t j = i;
+      while (j + 1 < IREE_TASK_TOPOLOGY_MAX_CPU_COUNT &&
+             iree_task_topology_cpu_limits_allow(&limits, j + 1)) {
+        ++j;
+      }
+      printf(first ? "" : ",");
+      if (j == i) {
+        printf("%u", i);
+      } else {
+        printf("%u-%u", i, j);
+      }
+      first = false;
+      i = j;
+    }
+    printf(" (%" PRIhsz ")\n", limits.allowed_cpu_count);
+  }
+  if (limits.quota_cpu_count == 0) {
+    printf("%-20s %s\n", "cpu_quota", "unlimited");
+  } else {
+    printf("%-20s %" PRIhsz "\n", "cpu_quota", limits.quota_cpu_count);
+  }
+
+  iree_task_topology_t topology;
+  iree_status_t status = iree_task_topology_initialize_from_physical_cores(
+      IREE_TASK_TOPOLOGY_NODE_ID_ANY, IREE_TASK_TOPOLOGY_PERFORMANCE_LEVEL_ANY,
+      IREE_TASK_TOPOLOGY_GROUP_BIT_COUNT, &topology);
+  if (!iree_status_is_ok(status)) {
+    iree_status_fprint(stderr, status);
+    iree_status_free(status);
+    return;
+  }
+  printf("%-20s %" PRIhsz "\n", "topology_groups",
+         iree_task_topology_group_count(&topology));
+  for (iree_host_size_t i = 0; i < iree_task_topology_group_count(&topology);
+       ++i) {
+    const iree_task_topology_group_t* group =
+        iree_task_topology_get_group(&topology, i);
+    printf("  group[%" PRIhsz "] processor=%u node=%u\n", i,
+           group->processor_index, group->node_id);
+  }
+  iree_task_topology_deinitialize(&topology);
+}
 
 int main(int argc, char *argv[]) {
   iree_cpu_initialize(iree_allocator_system());
@@ -21,5 +78,7 @@ int main(int argc, char *argv[]) {
 #include "iree/schemas/cpu_feature_bits.inl"
 #undef IREE_CPU_FEATURE_BIT
 
+  iree_cpuinfo_print_topology();
+
   return 0;
 }
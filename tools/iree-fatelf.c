@@ -29,17 +29,77 @@
 #define IREE_SET_BINARY_MODE(handle) ((void)0)
 #endif  // IREE_PLATFORM_WINDOWS
 
+// Human-readable names of FatELF feature levels.
+// Names match the -march/-mcpu values used by LLVM where possible.
+typedef struct {
+  iree_elf64_half_t machine;
+  iree_fatelf_feature_level_t feature_level;
+  const char* name;
+} fatelf_feature_level_name_t;
+static const fatelf_feature_level_name_t fatelf_feature_levels[] = {
+    // EM_X86_64:
+    {0x3E, IREE_FATELF_FEATURE_LEVEL_X86_64_V2, "x86-64-v2"},
+    {0x3E, IREE_FATELF_FEATURE_LEVEL_X86_64_V3, "x86-64-v3"},
+    {0x3E, IREE_FATELF_FEATURE_LEVEL_X86_64_V4, "x86-64-v4"},
+    // EM_AARCH64:
+    {0xB7, IREE_FATELF_FEATURE_LEVEL_ARM_64_V8_2, "armv8.2-a"},
+    {0xB7, IREE_FATELF_FEATURE_LEVEL_ARM_64_V9, "armv9-a"},
+};
+
+// Returns the name of |feature_level| on |machine| or NULL if unknown.
+static const char* fatelf_feature_level_str(
+    iree_elf64_half_t machine, iree_fatelf_feature_level_t feature_level) {
+  if (feature_level == IREE_FATELF_FEATURE_LEVEL_BASELINE) return "baseline";
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(fatelf_feature_levels);
+       ++i) {
+    if (fatelf_feature_levels[i].machine == machine &&
+        fatelf_feature_levels[i].feature_level == feature_level) {
+      return fatelf_feature_levels[i].name;
+    }
+  }
+  return NULL;
+}
+
+// Parses a feature level |name| into its machine and level.
+static bool fatelf_parse_feature_level(
+    iree_string_view_t name, iree_elf64_half_t* out_machine,
+    iree_fatelf_feature_level_t* out_feature_level) {
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(fatelf_feature_levels);
+       ++i) {
+    if (iree_string_view_equal(
+            name, iree_make_cstring_view(fatelf_feature_levels[i].name))) {
+      *out_machine = fatelf_feature_levels[i].machine;
+      *out_feature_level = fatelf_feature_levels[i].feature_level;
+      return true;
+    }
+  }
+  return false;
+}
+
 static int print_usage() {
   fprintf(stderr, "Syntax: iree-fatelf [join|split|select|dump] files...\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Join multiple ELFs into a FatELF:\n");
   fprintf(stderr, "  iree-fatelf join elf_a.so elf_b.so > fatelf.sos\n");
   fprintf(stderr, "\n");
+  fprintf(stderr, "Join microarchitecture variants of an ELF:\n");
+  fprintf(stderr,
+          "  iree-fatelf join x86_64.so x86_64_v3.so@x86-64-v3 "
+          "x86_64_v4.so@x86-64-v4 > fatelf.sos\n");
+  fprintf(stderr, "  feature levels: ");
+  for (iree_host_size_t i = 0; i < IREE_ARRAYSIZE(fatelf_feature_levels);
+       ++i) {
+    fprintf(stderr, "%s%s", i ? ", " : "", fatelf_feature_levels[i].name);
+  }
+  fprintf(stderr, "\n");
+  fprintf(stderr, "\n");
   fprintf(stderr, "Split a FatELF into multiple ELF files (to dir):\n");
   fprintf(stderr, "  iree-fatelf split fatelf.sos\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Select a FatELF matching the current arch:\n");
   fprintf(stderr, "  iree-fatelf select fatelf.sos > elf.so\n");
+  fprintf(stderr, "Select limiting the feature level (by name or number):\n");
+  fprintf(stderr, "  iree-fatelf select fatelf.sos x86-64-v2 > elf.so\n");
   fprintf(stderr, "\n");
   fprintf(stderr, "Dump header records:\n");
   fprintf(stderr, "  iree-fatelf dump fatelf.sos\n");
@@ -112,7 +172,8 @@ static iree_status_t fatelf_parse(iree_const_byte_span_t file_data,
         .osabi_version = iree_unaligned_load_le_u8(&raw_record->osabi_version),
         .word_size = iree_unaligned_load_le_u8(&raw_record->word_size),
         .byte_order = iree_unaligned_load_le_u8(&raw_record->byte_order),
-        .reserved0 = iree_unaligned_load_le_u8(&raw_record->reserved0),
+        .feature_level =
+            iree_unaligned_load_le_u8(&raw_record->feature_level),
         .reserved1 = iree_unaligned_load_le_u8(&raw_record->reserved1),
         .offset = iree_unaligned_load_le_u64(&raw_record->offset),
         .size = iree_unaligned_load_le_u64(&raw_record->size),
@@ -174,10 +235,31 @@ static iree_status_t fatelf_parse_elf_metadata(
   return iree_ok_status();
 }
 
+static const char* fatelf_machine_id_str(iree_elf64_half_t value) {
+  // TODO(benvanik): include a full table from the spec?
+  // http://formats.kaitai.io/elf/ has a good source of canonical short names.
+  // For now we just support what we have in our ELF loader.
+  switch (value) {
+    case 0x03:  // EM_386 / 3
+      return "x86";
+    case 0x28:  // EM_ARM / 40
+      return "arm";
+    case 0xB7:  // EM_AARCH64 / 183
+      return "aarch64";
+    case 0xF3:  // EM_RISCV / 243
+      return "risvc";
+    case 0x3E:  // EM_X86_64 / 62
+      return "x86_64";
+    default:
+      return "unknown";
+  }
+}
+
 typedef struct {
   uint64_t offset;
   iree_file_contents_t* contents;
   iree_const_byte_span_t elf_data;
+  iree_fatelf_feature_level_t feature_level;
 } fatelf_entry_t;
 
 // Joins one or more ELF files together and writes the output to stdout.
@@ -193,11 +275,57 @@ static iree_status_t fatelf_join(int argc, char** argv) {
   fatelf_entry_t* entries =
       (fatelf_entry_t*)iree_alloca(entry_count * sizeof(fatelf_entry_t));
   memset(entries, 0, entry_count * sizeof(*entries));
+  // Paths may have a feature level suffix as `path@level`.
   for (iree_elf64_byte_t i = 0; i < entry_count; ++i) {
+    iree_string_view_t path = iree_make_cstring_view(argv[i]);
+    iree_string_view_t level_name = iree_string_view_empty();
+    iree_elf64_half_t level_machine = 0;
+    iree_host_size_t at_pos = iree_string_view_find_last_of(
+        path, iree_make_cstring_view("@"), path.size - 1);
+    if (at_pos != IREE_STRING_VIEW_NPOS &&
+        fatelf_parse_feature_level(
+            iree_string_view_substr(path, at_pos + 1, IREE_HOST_SIZE_MAX),
+            &level_machine, &entries[i].feature_level)) {
+      level_name =
+          iree_string_view_substr(path, at_pos + 1, IREE_HOST_SIZE_MAX);
+      path = iree_string_view_substr(path, 0, at_pos);
+    }
+    char* path_str = (char*)iree_alloca(path.size + 1);
+    memcpy(path_str, path.data, path.size);
+    path_str[path.size] = 0;
     IREE_RETURN_IF_ERROR(
-        iree_file_read_contents(argv[i], IREE_FILE_READ_FLAG_DEFAULT,
+        iree_file_read_contents(path_str, IREE_FILE_READ_FLAG_DEFAULT,
                                 iree_allocator_system(), &entries[i].contents));
     entries[i].elf_data = entries[i].contents->const_buffer;
+    if (!iree_string_view_is_empty(level_name)) {
+      iree_elf64_half_t machine = 0;
+      iree_elf64_byte_t osabi = 0;
+      iree_elf64_byte_t osabi_version = 0;
+      iree_elf64_byte_t elf_class = 0;
+      iree_elf64_byte_t elf_data = 0;
+      IREE_RETURN_IF_ERROR(
+          fatelf_parse_elf_metadata(entries[i].elf_data, &machine, &osabi,
+                                    &osabi_version, &elf_class, &elf_data));
+      if (machine != level_machine) {
+        return iree_make_status(
+            IREE_STATUS_INVALID_ARGUMENT,
+            "feature level `%.*s` does not apply to ELF machine %d (%s) of "
+            "`%s`",
+            (int)level_name.size, level_name.data, machine,
+            fatelf_machine_id_str(machine), path_str);
+      }
+    }
+  }
+
+  // Stable sort entries by feature level so that baseline ELFs come first.
+  // Runtimes that predate feature levels pick the first matching record.
+  for (iree_elf64_byte_t i = 1; i < entry_count; ++i) {
+    fatelf_entry_t entry = entries[i];
+    iree_elf64_byte_t j = i;
+    for (; j > 0 && entries[j - 1].feature_level > entry.feature_level; --j) {
+      entries[j] = entries[j - 1];
+    }
+    entries[j] = entry;
   }
 
   // Compute offsets of all files based on their size and padding.
@@ -239,7 +367,7 @@ static iree_status_t fatelf_join(int argc, char** argv) {
         .byte_order = elf_data == IREE_ELF_ELFDATA2LSB
                           ? IREE_FATELF_BYTE_ORDER_LSB
                           : IREE_FATELF_BYTE_ORDER_MSB,
-        .reserved0 = 0,
+        .feature_level = entries[i].feature_level,
         .reserved1 = 0,
         .offset = (iree_elf64_off_t)entries[i].offset,
         .size = (iree_elf64_xword_t)entries[i].elf_data.data_length,
@@ -270,26 +398,6 @@ static iree_status_t fatelf_join(int argc, char** argv) {
   return iree_ok_status();
 }
 
-static const char* fatelf_machine_id_str(iree_elf64_half_t value) {
-  // TODO(benvanik): include a full table from the spec?
-  // http://formats.kaitai.io/elf/ has a good source of canonical short names.
-  // For now we just support what we have in our ELF loader.
-  switch (value) {
-    case 0x03:  // EM_386 / 3
-      return "x86";
-    case 0x28:  // EM_ARM / 40
-      return "arm";
-    case 0xB7:  // EM_AARCH64 / 183
-      return "aarch64";
-    case 0xF3:  // EM_RISCV / 243
-      return "risvc";
-    case 0x3E:  // EM_X86_64 / 62
-      return "x86_64";
-    default:
-      return "unknown";
-  }
-}
-
 static const char* fatelf_osabi_id_str(iree_elf64_byte_t value) {
   switch (value) {
     case IREE_ELF_ELFOSABI_NONE:
@@ -347,12 +455,26 @@ static iree_status_t fatelf_split(int argc, char** argv) {
     const char* word_size_str = fatelf_word_size_id_str(record->word_size);
     const char* byte_order_str = fatelf_byte_order_id_str(record->byte_order);
 
+    // Variants get their feature level appended so they don't collide.
+    char feature_level_str[32] = {0};
+    if (record->feature_level != IREE_FATELF_FEATURE_LEVEL_BASELINE) {
+      const char* name =
+          fatelf_feature_level_str(record->machine, record->feature_level);
+      if (name) {
+        snprintf(feature_level_str, IREE_ARRAYSIZE(feature_level_str), "_%s",
+                 name);
+      } else {
+        snprintf(feature_level_str, IREE_ARRAYSIZE(feature_level_str),
+                 "_level%d", record->feature_level);
+      }
+    }
+
     char record_path[2048];
-    iree_host_size_t record_path_length =
-        snprintf(record_path, IREE_ARRAYSIZE(record_path),
-                 "%.*s%s%.*s.%s_%s_%s%s.so", (int)dirname.size, dirname.data,
-                 dirname.size ? "/" : "", (int)stem.size, stem.data,
-                 machine_str, osabi_str, word_size_str, byte_order_str);
+    iree_host_size_t record_path_length = snprintf(
+        record_path, IREE_ARRAYSIZE(record_path), "%.*s%s%.*s.%s_%s_%s%s%s.so",
+        (int)dirname.size, dirname.data, dirname.size ? "/" : "",
+        (int)stem.size, stem.data, machine_str, osabi_str, word_size_str,
+        byte_order_str, feature_level_str);
     record_path_length =
         iree_file_path_canonicalize(record_path, record_path_length);
 
@@ -372,16 +494,34 @@ static iree_status_t fatelf_split(int argc, char** argv) {
 }
 
 // Selects the ELF matching the current host config from a FatELF and writes
-// it to stdout.
+// it to stdout. An optional feature level name or number limits selection to
+// variants at or below that level instead of the host level.
 static iree_status_t fatelf_select(int argc, char** argv) {
   IREE_SET_BINARY_MODE(stdout);  // ensure binary output mode
+  iree_fatelf_feature_level_t max_feature_level =
+      iree_fatelf_query_host_feature_level();
+  if (argc > 1) {
+    iree_string_view_t level_name = iree_make_cstring_view(argv[1]);
+    iree_elf64_half_t level_machine = 0;
+    uint32_t level_value = 0;
+    if (fatelf_parse_feature_level(level_name, &level_machine,
+                                   &max_feature_level)) {
+      // Named level; the machine is checked by selection.
+    } else if (iree_string_view_atoi_uint32(level_name, &level_value) &&
+               level_value <= UINT8_MAX) {
+      max_feature_level = (iree_fatelf_feature_level_t)level_value;
+    } else {
+      return iree_make_status(IREE_STATUS_INVALID_ARGUMENT,
+                              "unknown feature level `%s`", argv[1]);
+    }
+  }
   iree_file_contents_t* fatelf_contents = NULL;
   IREE_RETURN_IF_ERROR(
       iree_file_read_contents(argv[0], IREE_FILE_READ_FLAG_DEFAULT,
                               iree_allocator_system(), &fatelf_contents));
   iree_const_byte_span_t elf_data = iree_const_byte_span_empty();
-  IREE_RETURN_IF_ERROR(
-      iree_fatelf_select(fatelf_contents->const_buffer, &elf_data));
+  IREE_RETURN_IF_ERROR(iree_fatelf_select_with_feature_level(
+      fatelf_contents->const_buffer, max_feature_level, &elf_data));
   fwrite(elf_data.data, 1, elf_data.data_length, stdout);
   iree_file_contents_free(fatelf_contents);
   return iree_ok_status();
@@ -438,8 +578,11 @@ static iree_status_t fatelf_dump(int argc, char** argv) {
             record->word_size, fatelf_word_size_enum_str(record->word_size));
     fprintf(stdout, " byte_order: %d / %02X = %s\n", record->byte_order,
             record->byte_order, fatelf_byte_order_enum_str(record->byte_order));
-    fprintf(stdout, "  reserved0: %d / %02X\n", record->reserved0,
-            record->reserved0);
+    const char* feature_level_str =
+        fatelf_feature_level_str(record->machine, record->feature_level);
+    fprintf(stdout, "    feature: %d / %02X = %s\n", record->feature_level,
+            record->feature_level,
+            feature_level_str ? feature_level_str : "<unknown>");
     fprintf(stdout, "  reserved1: %d / %02X\n", record->reserved1,
             record->reserved1);
     fprintf(stdout, "     offset: %" PRIu64 " / %016" PRIX64 "\n",
@@ -471,7 +614,7 @@ int main(int argc, char** argv) {
     if (command_argc != 1) return print_usage();
     status = fatelf_split(command_argc, command_argv);
   } else if (strcmp(command, "select") == 0) {
-    if (command_argc != 1) return print_usage();
+    if (command_argc < 1 || command_argc > 2) return print_usage();
     status = fatelf_select(command_argc, command_argv);
   } else if (strcmp(command, "dump") == 0) {
     if (command_argc != 1) return print_usage();
@@ -0,0 +1,38 @@
+// RUN: iree-compile --compile-mode=vm %s -o %t.vmfb \
+// RUN:   --iree-vm-bytecode-module-page-alignment=4096 && \
+// RUN: iree-dump-module %t.vmfb | FileCheck %s --check-prefix=CHECK-ZIP
+// RUN: iree-compile --compile-mode=vm %s -o %t.flat.vmfb \
+// RUN:   --iree-vm-emit-polyglot-zip=false \
+// RUN:   --iree-vm-bytecode-module-page-alignment=4096 && \
+// RUN: iree-dump-module %t.flat.vmfb | FileCheck %s --check-prefix=CHECK-FLAT
+// RUN: not iree-compile --compile-mode=vm %s -o /dev/null \
+// RUN:   --iree-vm-bytecode-module-page-alignment=1000 2>&1 | \
+// RUN: FileCheck %s --check-prefix=CHECK-INVALID
+
+// Rodata used by the initializer is laid out first and each file starts on a
+// page boundary. Ordinals keep their declaration order. ZIP output places a
+// local file header before each file.
+// CHECK-ZIP: .rodata[  0] {{.*}}external {{.+}} (offset 8192 / 2000h
+// CHECK-ZIP: .rodata[  1] {{.*}}external {{.+}} (offset 4096 / 1000h
+// CHECK-FLAT: .rodata[  0] {{.*}}external {{.+}} (offset 4096 / 1000h
+// CHECK-FLAT: .rodata[  1] {{.*}}external {{.+}} (offset 0 / 0h
+
+// CHECK-INVALID: page alignment must be a power of two (got 1000)
+
+vm.module @page_alignment {
+  vm.rodata private @cold_data {mime_type = "application/octet-stream"} dense<1> : vector<100xi8>
+  vm.rodata private @init_data {mime_type = "application/octet-stream"} dense<2> : vector<100xi8>
+
+  vm.global.ref private mutable @init_buffer : !vm.buffer
+  vm.initializer {
+    %buffer = vm.const.ref.rodata @init_data : !vm.buffer
+    vm.global.store.ref %buffer, @init_buffer : !vm.buffer
+    vm.return
+  }
+
+  vm.export @cold
+  vm.func @cold() -> !vm.buffer {
+    %buffer = vm.const.ref.rodata @cold_data : !vm.buffer
+    vm.return %buffer : !vm.buffer
+  }
+}
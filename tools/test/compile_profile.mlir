@@ -0,0 +1,16 @@
+// RUN: iree-compile --compile-to=flow %s -o /dev/null \
+// RUN:   --iree-compile-profile=%t.json \
+// RUN:   --iree-compile-profile-granularity=0 && \
+// RUN: FileCheck %s --input-file=%t.json
+
+// CHECK: "traceEvents"
+// CHECK-DAG: "name":"phase input"
+// CHECK-DAG: "name":"phase abi"
+// CHECK-DAG: "name":"phase flow"
+// CHECK-DAG: "name":"canonicalize"
+// CHECK-DAG: "name":"util.func @abs"
+// CHECK-DAG: "detail":"util.func @abs"
+func.func @abs(%input : tensor<f32>) -> (tensor<f32>) {
+  %result = math.absf %input : tensor<f32>
+  return %result : tensor<f32>
+}